@@ -0,0 +1,24 @@
+# Find the PAPI hardware performance counter library
+
+find_library(PAPI_LIBRARY papi
+             HINTS ENV PAPI_LINK
+             HINTS ENV PAPI_DIR
+             PATH_SUFFIXES lib lib64)
+
+get_filename_component(_papi_lib_dir ${PAPI_LIBRARY} DIRECTORY)
+
+find_path(PAPI_INCLUDE_DIR papi.h
+          HINTS ENV PAPI_INC
+          HINTS ${_papi_lib_dir}/../include)
+
+# handle the QUIETLY and REQUIRED arguments and set PAPI_FOUND to TRUE if
+# all listed variables are TRUE
+include(FindPackageHandleStandardArgs)
+find_package_handle_standard_args(PAPI
+                                  REQUIRED_VARS PAPI_LIBRARY PAPI_INCLUDE_DIR)
+
+if(PAPI_FOUND)
+  set(PAPI_LIBRARIES ${PAPI_LIBRARY})
+endif()
+
+mark_as_advanced(PAPI_LIBRARY PAPI_INCLUDE_DIR)
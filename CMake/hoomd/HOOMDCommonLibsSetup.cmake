@@ -33,6 +33,20 @@ if(ENABLE_TBB)
     endif()
 endif()
 
+option(ENABLE_FFTW "Use FFTW3 (or the FFTW3 interface of MKL) for the host FFTs" off)
+
+if(ENABLE_FFTW)
+    find_package(FFTW REQUIRED)
+    include_directories(${FFTW_INCLUDE_DIR})
+endif()
+
+option(ENABLE_PAPI "Read hardware performance counters with PAPI in profiled runs" off)
+
+if(ENABLE_PAPI)
+    find_package(PAPI REQUIRED)
+    include_directories(${PAPI_INCLUDE_DIR})
+endif()
+
 if (TBB_USE_GLIBCXX_VERSION)
    add_definitions(-DTBB_USE_GLIBCXX_VERSION=${TBB_USE_GLIBCXX_VERSION})
 endif()
@@ -43,6 +57,14 @@ if (ENABLE_TBB)
     list(APPEND HOOMD_COMMON_LIBS ${TBB_LIBRARY})
 endif()
 
+if (ENABLE_FFTW)
+    list(APPEND HOOMD_COMMON_LIBS ${FFTW_LIBRARIES})
+endif()
+
+if (ENABLE_PAPI)
+    list(APPEND HOOMD_COMMON_LIBS ${PAPI_LIBRARIES})
+endif()
+
 if (APPLE)
     list(APPEND HOOMD_COMMON_LIBS "-undefined dynamic_lookup")
 endif()
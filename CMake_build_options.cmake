@@ -16,6 +16,21 @@ if (ENABLE_HPMC_MIXED_PRECISION)
     add_definitions(-DENABLE_HPMC_MIXED_PRECISION)
 endif()
 
+option(ENABLE_HPMC_ADAPTIVE_PRECISION "Re-test near-contact HPMC overlaps of convex polyhedra in double precision (with ENABLE_HPMC_MIXED_PRECISION)" OFF)
+if (ENABLE_HPMC_ADAPTIVE_PRECISION)
+    add_definitions(-DENABLE_HPMC_ADAPTIVE_PRECISION)
+endif()
+
+option(ENABLE_MD_MIXED_PRECISION "Evaluate MD pair and bond forces in single precision, integrate in double precision" OFF)
+if (ENABLE_MD_MIXED_PRECISION)
+    add_definitions(-DENABLE_MD_MIXED_PRECISION)
+endif()
+
+option(ENABLE_MPCD_COMPACT "Store MPCD solvent positions relative to a grid over the local box and velocities in single precision" OFF)
+if (ENABLE_MPCD_COMPACT)
+    add_definitions(-DENABLE_MPCD_COMPACT)
+endif()
+
 #####################3
 ## CUDA related options
 option(ENABLE_CUDA "Enable the compilation of the CUDA GPU code" off)
@@ -25,6 +40,7 @@ MARK_AS_ADVANCED(ALWAYS_USE_MANAGED_MEMORY)
 
 if (ENABLE_CUDA)
     option(ENABLE_NVTOOLS "Enable NVTools profiler integration" off)
+    option(ENABLE_CUDA_LAZY_LOADING "Load the GPU kernels of each module into device memory on first launch (CUDA 11.7 and newer)" on)
 endif (ENABLE_CUDA)
 
 ############################
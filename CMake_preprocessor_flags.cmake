@@ -18,6 +18,10 @@ if (ENABLE_CUDA)
     if(ALWAYS_USE_MANAGED_MEMORY)
         add_definitions(-DALWAYS_USE_MANAGED_MEMORY)
     endif()
+
+    if (ENABLE_CUDA_LAZY_LOADING)
+        add_definitions(-DENABLE_CUDA_LAZY_LOADING)
+    endif()
 endif (ENABLE_CUDA)
 
 ################################
@@ -44,3 +48,16 @@ endif()
 if (ENABLE_TBB)
     add_definitions(-DENABLE_TBB)
 endif()
+
+# export FFTW compile flags
+if (ENABLE_FFTW)
+    add_definitions(-DENABLE_FFTW)
+    if (FFTW_THREADS_LIBRARY)
+        add_definitions(-DENABLE_FFTW_THREADS)
+    endif()
+endif()
+
+# export PAPI compile flag
+if (ENABLE_PAPI)
+    add_definitions(-DENABLE_PAPI)
+endif()
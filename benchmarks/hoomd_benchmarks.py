@@ -0,0 +1,248 @@
+# Copyright (c) 2009-2019 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+# Maintainer: joaander
+
+R""" HOOMD-blue benchmark suite.
+
+Runs a set of canonical workloads and writes the results to a JSON file. Every workload reports its time steps per
+second (macro benchmark) and the time per call of its main subsystems (micro benchmarks), measured with
+:py:mod:`hoomd.benchmark`. All workloads start from deterministic configurations with fixed seeds, so results of
+different builds on the same machine are comparable.
+
+Usage::
+
+    python hoomd_benchmarks.py [--output=benchmarks.json] [--workloads=lj_liquid,...] [--scale=1.0] [hoomd options]
+    mpirun -n 8 python hoomd_benchmarks.py --mode=cpu
+
+Options not listed below are passed on to :py:func:`hoomd.context.initialize()`. The ``benchmark`` CMake target runs
+the suite on the build directory.
+"""
+
+import argparse
+import math
+import os
+import tempfile
+import time
+
+import hoomd
+from hoomd import md
+
+## \internal
+# \brief Number of unit cells per box edge for approximately N particles with n per cell
+def _cells(N, n, scale):
+    return max(2, int(round((N*scale/n)**(1.0/3.0))));
+
+## \internal
+# \brief Time the GSD output of the current system
+def _time_gsd(num_iters):
+    # all ranks need the same file name
+    filename = os.path.join(tempfile.gettempdir(), 'hoomd_benchmark.gsd');
+
+    gsd = hoomd.dump.gsd(filename=filename, period=None, group=hoomd.group.all(), overwrite=True,
+                         dynamic=['attribute', 'property', 'momentum']);
+    gsd.write_restart();
+
+    hoomd.comm.barrier();
+    start = time.time();
+    for i in range(num_iters):
+        gsd.write_restart();
+    hoomd.comm.barrier();
+    elapsed = time.time() - start;
+
+    gsd.disable();
+    if hoomd.comm.get_rank() == 0 and os.path.exists(filename):
+        os.remove(filename);
+
+    return elapsed*1e3/num_iters;
+
+## \internal
+# \brief Run the macro benchmark of the current simulation
+def _macro(args, report, name):
+    tps = hoomd.benchmark.series(warmup=args.warmup, repeat=args.repeat, steps=args.steps);
+    report.add(name, 'tps', tps, N=hoomd.context.current.system_definition.getParticleData().getNGlobal());
+
+def lj_liquid(args, report):
+    R""" Lennard-Jones liquid at rho=0.8442, T=1.2 with 64000 particles."""
+    n = _cells(64000, 4, args.scale);
+    hoomd.init.create_lattice(unitcell=hoomd.lattice.fcc(a=(4/0.8442)**(1.0/3.0)), n=n);
+
+    nl = md.nlist.cell();
+    lj = md.pair.lj(r_cut=3.0, nlist=nl);
+    lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0);
+    md.integrate.mode_standard(dt=0.005);
+    md.integrate.nvt(group=hoomd.group.all(), kT=1.2, tau=0.5);
+
+    _macro(args, report, 'lj_liquid');
+
+    report.add('lj_liquid/cell_list', 'ms', hoomd.benchmark.cell_list(nl, args.iters));
+    report.add('lj_liquid/nlist.cell', 'ms', hoomd.benchmark.compute(nl, args.iters));
+    report.add('lj_liquid/pair.lj', 'ms', hoomd.benchmark.compute(lj, args.iters));
+    report.add('lj_liquid/exchange', 'ms', hoomd.benchmark.communication(args.iters));
+    report.add('lj_liquid/ghost_update', 'ms', hoomd.benchmark.communication(args.iters, ghost_update=True));
+    report.add('lj_liquid/dump.gsd', 'ms', _time_gsd(max(1, args.iters//10)));
+
+    # the same cutoff with the other pair potential drivers and neighbor lists
+    lj.disable();
+    for pair_name, pair_type, coeffs in [('gauss', md.pair.gauss, dict(epsilon=1.0, sigma=1.0)),
+                                         ('yukawa', md.pair.yukawa, dict(epsilon=1.0, kappa=1.0))]:
+        pair = pair_type(r_cut=3.0, nlist=nl);
+        pair.pair_coeff.set('A', 'A', **coeffs);
+        hoomd.run(1);
+        report.add('lj_liquid/pair.' + pair_name, 'ms', hoomd.benchmark.compute(pair, args.iters));
+        pair.disable();
+
+    for nlist_name, nlist_type in [('stencil', md.nlist.stencil), ('tree', md.nlist.tree)]:
+        nl_variant = nlist_type();
+        pair = md.pair.lj(r_cut=3.0, nlist=nl_variant);
+        pair.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0);
+        hoomd.run(1);
+        report.add('lj_liquid/nlist.' + nlist_name, 'ms', hoomd.benchmark.compute(nl_variant, args.iters));
+        pair.disable();
+
+def polymer_melt_pppm(args, report):
+    R""" Melt of charged bead-spring chains of length 10 at rho=0.85 with PPPM electrostatics, 32000 beads."""
+    chain = 10;
+    n_chains = int(32000*args.scale) // chain;
+    L = (n_chains*chain/0.85)**(1.0/3.0);
+
+    snap = hoomd.data.make_snapshot(N=n_chains*chain, box=hoomd.data.boxdim(L=L), particle_types=['A'],
+                                    bond_types=['polymer']);
+    if hoomd.comm.get_rank() == 0:
+        # lay out the chains along x in a simple cubic grid of sites
+        n_x = int(math.floor(L));
+        n_rows = int(math.ceil(n_chains*chain / float(n_x)));
+        n_yz = int(math.ceil(math.sqrt(n_rows)));
+        spacing = L / n_yz;
+        snap.bonds.resize(n_chains*(chain-1));
+
+        for c in range(n_chains):
+            for b in range(chain):
+                i = c*chain + b;
+                row, col = divmod(i, n_x);
+                snap.particles.position[i] = (-L/2 + (col + 0.5)*L/n_x,
+                                              -L/2 + (row % n_yz + 0.5)*spacing,
+                                              -L/2 + (row // n_yz + 0.5)*spacing);
+                snap.particles.charge[i] = 0.5 if b % 2 == 0 else -0.5;
+                if b > 0:
+                    snap.bonds.group[c*(chain-1) + b-1] = (i-1, i);
+
+    hoomd.init.read_snapshot(snap);
+
+    nl = md.nlist.cell();
+    nl.reset_exclusions(exclusions=['bond']);
+    lj = md.pair.lj(r_cut=2.5, nlist=nl);
+    lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0);
+    harmonic = md.bond.harmonic();
+    harmonic.bond_coeff.set('polymer', k=330.0, r0=0.84);
+    pppm = md.charge.pppm(group=hoomd.group.charged(), nlist=nl);
+    pppm.set_params(Nx=32, Ny=32, Nz=32, order=5, rcut=2.5);
+
+    md.integrate.mode_standard(dt=0.002);
+    md.integrate.langevin(group=hoomd.group.all(), kT=1.0, seed=1);
+
+    _macro(args, report, 'polymer_melt_pppm');
+
+    report.add('polymer_melt_pppm/pair.lj', 'ms', hoomd.benchmark.compute(lj, args.iters));
+    report.add('polymer_melt_pppm/bond.harmonic', 'ms', hoomd.benchmark.compute(harmonic, args.iters));
+    report.add('polymer_melt_pppm/charge.pppm', 'ms', hoomd.benchmark.compute(pppm, args.iters));
+
+def hpmc_spheres(args, report):
+    R""" Hard spheres at packing fraction 0.5 with 64000 particles."""
+    from hoomd import hpmc
+
+    n = _cells(64000, 1, args.scale);
+    hoomd.init.create_lattice(unitcell=hoomd.lattice.sc(a=(math.pi/6/0.5)**(1.0/3.0)), n=n);
+
+    mc = hpmc.integrate.sphere(seed=1, d=0.1, nselect=4);
+    mc.shape_param.set('A', diameter=1.0);
+
+    _macro(args, report, 'hpmc_spheres');
+
+def hpmc_polyhedra(args, report):
+    R""" Hard cubes at packing fraction 0.5 with 32000 particles."""
+    from hoomd import hpmc
+
+    n = _cells(32000, 1, args.scale);
+    hoomd.init.create_lattice(unitcell=hoomd.lattice.sc(a=(1/0.5)**(1.0/3.0)), n=n);
+
+    mc = hpmc.integrate.convex_polyhedron(seed=1, d=0.1, a=0.1, nselect=4);
+    mc.shape_param.set('A', vertices=[(x*0.5, y*0.5, z*0.5) for x in (-1,1) for y in (-1,1) for z in (-1,1)]);
+
+    _macro(args, report, 'hpmc_polyhedra');
+
+def mpcd_solvent(args, report):
+    R""" SRD solvent with 10 particles per cell and 1000000 particles."""
+    from hoomd import mpcd
+
+    L = int(round((1e6*args.scale/10)**(1.0/3.0)));
+    hoomd.init.read_snapshot(hoomd.data.make_snapshot(N=1, box=hoomd.data.boxdim(L=L)));
+    mpcd.init.make_random(N=10*L**3, kT=1.0, seed=1);
+
+    mpcd.integrator(dt=0.1);
+    mpcd.stream.bulk(period=1);
+    mpcd.collide.srd(seed=1, period=1, angle=130., kT=1.0);
+
+    _macro(args, report, 'mpcd_solvent');
+
+def rigid_bodies(args, report):
+    R""" Rigid dimers of Lennard-Jones spheres at rho=0.5 with 64000 constituent particles."""
+    n = _cells(32000, 1, args.scale);
+    uc = hoomd.lattice.unitcell(N=1, a1=[2.0,0,0], a2=[0,2.0,0], a3=[0,0,2.0], dimensions=3,
+                                position=[[0,0,0]], type_name=['R'], mass=[2.0],
+                                moment_inertia=[[0.5,0.5,0]], orientation=[[1,0,0,0]]);
+    system = hoomd.init.create_lattice(unitcell=uc, n=n);
+    system.particles.types.add('A');
+
+    rigid = md.constrain.rigid();
+    rigid.set_param('R', types=['A','A'], positions=[(-0.5,0,0),(0.5,0,0)]);
+    rigid.create_bodies();
+
+    nl = md.nlist.cell();
+    lj = md.pair.lj(r_cut=2.5, nlist=nl);
+    lj.pair_coeff.set(['R','A'], ['R','A'], epsilon=1.0, sigma=1.0);
+    lj.pair_coeff.set('R', ['R','A'], epsilon=0.0, sigma=1.0, r_cut=False);
+
+    md.integrate.mode_standard(dt=0.005, aniso=True);
+    md.integrate.nvt(group=hoomd.group.rigid_center(), kT=1.0, tau=0.5);
+
+    _macro(args, report, 'rigid_bodies');
+
+    report.add('rigid_bodies/pair.lj', 'ms', hoomd.benchmark.compute(lj, args.iters));
+    report.add('rigid_bodies/constrain.rigid', 'ms', hoomd.benchmark.compute(rigid, args.iters));
+
+workloads = [lj_liquid, polymer_melt_pppm, hpmc_spheres, hpmc_polyhedra, mpcd_solvent, rigid_bodies];
+
+def main():
+    parser = argparse.ArgumentParser(description='Run the HOOMD-blue benchmark suite.');
+    parser.add_argument('--output', default='benchmarks.json', help='Name of the JSON output file');
+    parser.add_argument('--workloads', default=','.join(w.__name__ for w in workloads),
+                        help='Comma separated list of workloads to run');
+    parser.add_argument('--scale', type=float, default=1.0, help='Factor on the number of particles');
+    parser.add_argument('--warmup', type=int, default=2000, help='Number of warm up steps per workload');
+    parser.add_argument('--repeat', type=int, default=5, help='Number of timed runs per workload');
+    parser.add_argument('--steps', type=int, default=1000, help='Number of steps per timed run');
+    parser.add_argument('--iters', type=int, default=100, help='Number of iterations per micro benchmark');
+    args, hoomd_args = parser.parse_known_args();
+
+    selected = args.workloads.split(',');
+    unknown = [name for name in selected if name not in [w.__name__ for w in workloads]];
+    if len(unknown) > 0:
+        parser.error('unknown workloads: ' + ', '.join(unknown));
+
+    report = None;
+    for workload in workloads:
+        if workload.__name__ not in selected:
+            continue;
+
+        hoomd.context.initialize(' '.join(hoomd_args));
+        if report is None:
+            report = hoomd.benchmark.report(scale=args.scale, warmup=args.warmup, repeat=args.repeat,
+                                            steps=args.steps, iters=args.iters);
+        workload(args, report);
+
+    if report is not None:
+        report.write(args.output);
+
+if __name__ == '__main__':
+    main();
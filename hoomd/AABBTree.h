@@ -8,9 +8,16 @@
 #include "VectorMath.h"
 #include <vector>
 #include <stack>
+#include <cmath>
+#include <limits>
+#include <algorithm>
 
 #include "AABB.h"
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 #ifndef __AABB_TREE_H__
 #define __AABB_TREE_H__
 
@@ -38,6 +45,7 @@ namespace detail
 
 const unsigned int NODE_CAPACITY = 16;           //!< Maximum number of particles in a node
 const unsigned int INVALID_NODE = 0xffffffff;   //!< Invalid node index sentinel
+const unsigned int AABB_TREE_PARALLEL_MIN = 4096; //!< Minimum number of AABBs in a node to build its children in parallel
 
 #ifndef NVCC
 
@@ -65,6 +73,38 @@ struct PYBIND11_EXPORT AABBNode
     unsigned int num_particles;                 //!< Number of particles contained in the node
     } __attribute__((aligned(32)));
 
+//! Compact copy of an AABBNode for traversal
+/*! An AABBNode spans several cache lines, most of which hold the particle lists of leaf nodes. Traversal only needs
+    the bounds, the skip count and whether the node is a leaf. AABBNodeCompact stores these in 32 bytes, so that two
+    nodes fit in one cache line. The bounds are rounded outward to single precision, so an overlap with a compact node
+    is conservative and never misses a hit of the full precision node.
+*/
+struct AABBNodeCompact
+    {
+    float lower[3];      //!< Lower corner of the node, rounded down
+    unsigned int skip;   //!< Number of array indices to skip to get to the next node in an in order traversal
+    float upper[3];      //!< Upper corner of the node, rounded up
+    unsigned int leaf;   //!< Nonzero if the node is a leaf
+    } __attribute__((aligned(32)));
+
+//! Round a value down to the nearest float
+inline float float_round_down(Scalar x)
+    {
+    float f = float(x);
+    if (Scalar(f) > x)
+        f = std::nextafter(f, -std::numeric_limits<float>::infinity());
+    return f;
+    }
+
+//! Round a value up to the nearest float
+inline float float_round_up(Scalar x)
+    {
+    float f = float(x);
+    if (Scalar(f) < x)
+        f = std::nextafter(f, std::numeric_limits<float>::infinity());
+    return f;
+    }
+
 //! AABB Tree
 /*! An AABBTree stores a binary tree of AABBs. A leaf node stores up to NODE_CAPACITY particles by index. The bounding
     box of a leaf node surrounds all the bounding boxes of its contained particles. Internal nodes have AABBs that
@@ -77,10 +117,14 @@ struct PYBIND11_EXPORT AABBNode
                an update will only increase the volume of nodes. The tree should be rebuilt periodically instead of
                continually updated.
     - buildTree : build an efficiently arranged tree given a complete set of AABBs, one for each particle.
+    - Insert / Remove : Add a particle to a leaf node with free capacity, or remove it from its leaf node. Like update,
+               these leave the tree topology unchanged and are meant for occasional changes between rebuilds.
 
     **Implementation details**
 
-    AABBTree stores all nodes in a flat array managed by std::vector. To easily locate particle leaf nodes for update,
+    AABBTree stores all nodes in a flat array. A second array of AABBNodeCompact mirrors the data needed for
+    traversal, and is kept up to date by buildTree(), update() and refit(). Queries should use overlapNode(),
+    isNodeLeaf() and getNodeSkip(), which read only the compact array. To easily locate particle leaf nodes for update,
     a reverse mapping is stored to locate the leaf node containing a particle. m_root tracks the index of the root node
     as the tree is built. The nodes store the indices of their left and right children along with their AABB. Nodes
     are allocated as needed with allocate(). With multiple particles per leaf node, the total number of internal nodes
@@ -95,7 +139,7 @@ class PYBIND11_EXPORT AABBTree
     public:
         //! Construct an AABBTree
         AABBTree()
-            : m_nodes(0), m_num_nodes(0), m_node_capacity(0), m_root(0)
+            : m_nodes(0), m_compact_nodes(0), m_num_nodes(0), m_node_capacity(0), m_root(0)
             {
             }
 
@@ -104,6 +148,8 @@ class PYBIND11_EXPORT AABBTree
             {
             if (m_nodes)
                 free(m_nodes);
+            if (m_compact_nodes)
+                free(m_compact_nodes);
             }
 
         //! Copy constructor
@@ -115,11 +161,17 @@ class PYBIND11_EXPORT AABBTree
             m_mapping = from.m_mapping;
 
             m_nodes = NULL;
+            m_compact_nodes = NULL;
 
             if (from.m_nodes)
                 {
                 // allocate memory
                 int retval = posix_memalign((void**)&m_nodes, 32, m_node_capacity*sizeof(AABBNode));
+                if (retval != 0)
+                    {
+                    throw std::runtime_error("Error allocating AABBTree memory");
+                    }
+                retval = posix_memalign((void**)&m_compact_nodes, 32, m_node_capacity*sizeof(AABBNodeCompact));
                 if (retval != 0)
                     {
                     throw std::runtime_error("Error allocating AABBTree memory");
@@ -127,6 +179,7 @@ class PYBIND11_EXPORT AABBTree
 
                 // copy over data
                 std::copy(from.m_nodes, from.m_nodes + m_num_nodes, m_nodes);
+                std::copy(from.m_compact_nodes, from.m_compact_nodes + m_num_nodes, m_compact_nodes);
                 }
             }
 
@@ -140,13 +193,21 @@ class PYBIND11_EXPORT AABBTree
 
             if (m_nodes)
                 free(m_nodes);
+            if (m_compact_nodes)
+                free(m_compact_nodes);
 
             m_nodes = NULL;
+            m_compact_nodes = NULL;
 
             if (from.m_nodes)
                 {
                 // allocate memory
                 int retval = posix_memalign((void**)&m_nodes, 32, m_node_capacity*sizeof(AABBNode));
+                if (retval != 0)
+                    {
+                    throw std::runtime_error("Error allocating AABBTree memory");
+                    }
+                retval = posix_memalign((void**)&m_compact_nodes, 32, m_node_capacity*sizeof(AABBNodeCompact));
                 if (retval != 0)
                     {
                     throw std::runtime_error("Error allocating AABBTree memory");
@@ -154,6 +215,7 @@ class PYBIND11_EXPORT AABBTree
 
                 // copy over data
                 std::copy(from.m_nodes, from.m_nodes + m_num_nodes, m_nodes);
+                std::copy(from.m_compact_nodes, from.m_compact_nodes + m_num_nodes, m_compact_nodes);
                 }
             return *this;
             }
@@ -167,6 +229,24 @@ class PYBIND11_EXPORT AABBTree
         //! Update the AABB of a particle
         inline void update(unsigned int idx, const AABB& aabb);
 
+        //! Refit all node AABBs to a new list of particle AABBs, keeping the tree topology
+        inline void refit(const AABB *aabbs, unsigned int N);
+
+        //! Insert a new particle at the end of the particle list
+        inline bool insert(unsigned int idx, const AABB& aabb);
+
+        //! Remove a particle, and move the last particle into its index
+        inline void remove(unsigned int idx);
+
+        //! Get the summed surface area of all nodes
+        inline Scalar getSurfaceArea() const;
+
+        //! Get the number of particles in the tree
+        inline unsigned int getNumParticles() const
+            {
+            return m_mapping.size();
+            }
+
         //! Get the height of a given particle's leaf node
         inline unsigned int height(unsigned int idx);
 
@@ -181,7 +261,26 @@ class PYBIND11_EXPORT AABBTree
         */
         inline bool isNodeLeaf(unsigned int node) const
             {
-            return (m_nodes[node].left == INVALID_NODE);
+            return (m_compact_nodes[node].leaf != 0);
+            }
+
+        //! Test if a given node overlaps an AABB
+        /*! \param node Index of the node (not the particle) to query
+            \param aabb AABB to test against
+            \returns true if the single precision bounds of the node overlap \a aabb
+        */
+        inline bool overlapNode(unsigned int node, const AABB& aabb) const
+            {
+            const AABBNodeCompact& n = m_compact_nodes[node];
+            vec3<Scalar> lower = aabb.getLower();
+            vec3<Scalar> upper = aabb.getUpper();
+            return !(   upper.x < n.lower[0]
+                     || lower.x > n.upper[0]
+                     || upper.y < n.lower[1]
+                     || lower.y > n.upper[1]
+                     || upper.z < n.lower[2]
+                     || lower.z > n.upper[2]
+                    );
             }
 
         //! Get the AABBNode
@@ -205,7 +304,7 @@ class PYBIND11_EXPORT AABBTree
         */
         inline unsigned int getNodeSkip(unsigned int node) const
             {
-            return (m_nodes[node].skip);
+            return (m_compact_nodes[node].skip);
             }
 
         //! Get the left child of a given node
@@ -242,6 +341,7 @@ class PYBIND11_EXPORT AABBTree
             }
     private:
         AABBNode *m_nodes;                  //!< The nodes of the tree
+        AABBNodeCompact *m_compact_nodes;   //!< Traversal data of the nodes
         unsigned int m_num_nodes;           //!< Number of nodes
         unsigned int m_node_capacity;       //!< Capacity of the nodes array
         unsigned int m_root;                //!< Index to the root node of the tree
@@ -256,8 +356,17 @@ class PYBIND11_EXPORT AABBTree
         //! Allocate a new node
         inline unsigned int allocateNode();
 
+        //! Grow the node arrays to hold at least a given number of nodes
+        inline void reserveNodes(unsigned int capacity);
+
+        //! Append the nodes of a subtree
+        inline unsigned int appendNodes(const AABBTree& subtree, unsigned int parent);
+
         //! Update the skip value for a node
         inline unsigned int updateSkip(unsigned int idx);
+
+        //! Copy the traversal data of a node into the compact array
+        inline void updateCompactNode(unsigned int idx);
     };
 
 
@@ -289,20 +398,15 @@ inline unsigned int AABBTree::query(std::vector<unsigned int>& hits, const AABB&
     {
     unsigned int box_overlap_counts = 0;
 
-    // avoid pointer indirection overhead of std::vector
-    AABBNode* nodes = &m_nodes[0];
-
     // stackless search
     for (unsigned int current_node_idx = 0; current_node_idx < m_num_nodes; current_node_idx++)
         {
-        // cache current node pointer
-        const AABBNode& current_node = nodes[current_node_idx];
-
         box_overlap_counts++;
-        if (overlap(current_node.aabb, aabb))
+        if (overlapNode(current_node_idx, aabb))
             {
-            if (current_node.left == INVALID_NODE)
+            if (m_compact_nodes[current_node_idx].leaf)
                 {
+                const AABBNode& current_node = m_nodes[current_node_idx];
                 for (unsigned int i = 0; i < current_node.num_particles; i++)
                     hits.push_back(current_node.particles[i]);
                 }
@@ -310,7 +414,7 @@ inline unsigned int AABBTree::query(std::vector<unsigned int>& hits, const AABB&
         else
             {
             // skip ahead
-            current_node_idx += current_node.skip;
+            current_node_idx += m_compact_nodes[current_node_idx].skip;
             }
         }
 
@@ -336,6 +440,7 @@ inline void AABBTree::update(unsigned int idx, const AABB& aabb)
     if (!contains(m_nodes[node_idx].aabb, aabb))
         {
         m_nodes[node_idx].aabb = merge(m_nodes[node_idx].aabb, aabb);
+        updateCompactNode(node_idx);
 
         // update all parent node AABBs
         unsigned int current_node = m_nodes[node_idx].parent;
@@ -345,11 +450,147 @@ inline void AABBTree::update(unsigned int idx, const AABB& aabb)
             unsigned int right_idx = m_nodes[current_node].right;
 
             m_nodes[current_node].aabb = merge(m_nodes[left_idx].aabb, m_nodes[right_idx].aabb);
+            updateCompactNode(current_node);
             current_node = m_nodes[current_node].parent;
             }
         }
     }
 
+/*! \param aabbs List of AABBs for each particle, in the same index order as when the tree was built
+    \param N Number of AABBs in the list
+
+    Recompute the AABBs of all leaf nodes from \a aabbs and then those of the internal nodes. Unlike update(), refit()
+    also shrinks nodes. The topology is not changed, so the tree quality degrades as particles diffuse away from the
+    positions at which it was built. Use getSurfaceArea() to decide when a full rebuild is needed.
+*/
+inline void AABBTree::refit(const AABB *aabbs, unsigned int N)
+    {
+    assert(N == m_mapping.size());
+
+    // buildNode() allocates children after their parents, so a reverse sweep visits children first
+    for (int node_idx = int(m_num_nodes)-1; node_idx >= 0; node_idx--)
+        {
+        AABBNode& node = m_nodes[node_idx];
+        if (node.left == INVALID_NODE && node.num_particles == 0)
+            {
+            // leaves emptied by remove() keep their last bounds
+            }
+        else if (node.left == INVALID_NODE)
+            {
+            node.aabb = aabbs[node.particles[0]];
+            node.particle_tags[0] = aabbs[node.particles[0]].tag;
+            for (unsigned int j = 1; j < node.num_particles; j++)
+                {
+                node.aabb = merge(node.aabb, aabbs[node.particles[j]]);
+                node.particle_tags[j] = aabbs[node.particles[j]].tag;
+                }
+            }
+        else
+            {
+            node.aabb = merge(m_nodes[node.left].aabb, m_nodes[node.right].aabb);
+            }
+        updateCompactNode(node_idx);
+        }
+    }
+
+/*! \param idx Index of the new particle, must be equal to the current number of particles in the tree
+    \param aabb AABB of the new particle
+    \returns false if the particle could not be inserted, the tree then needs to be rebuilt
+
+    The tree is descended from the root into the child whose surface area grows least. The particle is added to the
+    leaf node found this way, if it is not full, and the AABBs of the leaf and its parents are grown.
+*/
+inline bool AABBTree::insert(unsigned int idx, const AABB& aabb)
+    {
+    if (m_num_nodes == 0 || idx != m_mapping.size())
+        return false;
+
+    // find the leaf node
+    unsigned int node_idx = m_root;
+    while (m_nodes[node_idx].left != INVALID_NODE)
+        {
+        const AABB& left = m_nodes[m_nodes[node_idx].left].aabb;
+        const AABB& right = m_nodes[m_nodes[node_idx].right].aabb;
+
+        vec3<Scalar> l = merge(left, aabb).getUpper() - merge(left, aabb).getLower();
+        vec3<Scalar> l0 = left.getUpper() - left.getLower();
+        vec3<Scalar> r = merge(right, aabb).getUpper() - merge(right, aabb).getLower();
+        vec3<Scalar> r0 = right.getUpper() - right.getLower();
+        Scalar grow_left = (l.x*l.y + l.y*l.z + l.z*l.x) - (l0.x*l0.y + l0.y*l0.z + l0.z*l0.x);
+        Scalar grow_right = (r.x*r.y + r.y*r.z + r.z*r.x) - (r0.x*r0.y + r0.y*r0.z + r0.z*r0.x);
+
+        node_idx = (grow_left <= grow_right) ? m_nodes[node_idx].left : m_nodes[node_idx].right;
+        }
+
+    AABBNode& leaf = m_nodes[node_idx];
+    if (leaf.num_particles >= NODE_CAPACITY)
+        return false;
+
+    leaf.particles[leaf.num_particles] = idx;
+    leaf.particle_tags[leaf.num_particles] = aabb.tag;
+    leaf.num_particles++;
+
+    m_mapping.push_back(node_idx);
+
+    // grow the leaf and its parents
+    update(idx, aabb);
+    return true;
+    }
+
+/*! \param idx Index of the particle to remove
+
+    This mirrors ParticleData::removeParticle(), where the last particle takes the index of the removed one. The leaf
+    node AABBs are not shrunk.
+*/
+inline void AABBTree::remove(unsigned int idx)
+    {
+    assert(idx < m_mapping.size());
+    unsigned int last = m_mapping.size()-1;
+
+    // remove the particle from its leaf
+    AABBNode& leaf = m_nodes[m_mapping[idx]];
+    for (unsigned int j = 0; j < leaf.num_particles; j++)
+        {
+        if (leaf.particles[j] == idx)
+            {
+            leaf.particles[j] = leaf.particles[leaf.num_particles-1];
+            leaf.particle_tags[j] = leaf.particle_tags[leaf.num_particles-1];
+            leaf.num_particles--;
+            break;
+            }
+        }
+
+    // relabel the last particle
+    if (idx != last)
+        {
+        AABBNode& leaf_last = m_nodes[m_mapping[last]];
+        for (unsigned int j = 0; j < leaf_last.num_particles; j++)
+            {
+            if (leaf_last.particles[j] == last)
+                {
+                leaf_last.particles[j] = idx;
+                break;
+                }
+            }
+        m_mapping[idx] = m_mapping[last];
+        }
+
+    m_mapping.pop_back();
+    }
+
+/*! \returns The sum of the surface areas of all nodes, a measure of the expected cost of a query
+*/
+inline Scalar AABBTree::getSurfaceArea() const
+    {
+    Scalar area(0.0);
+    for (unsigned int node_idx = 0; node_idx < m_num_nodes; node_idx++)
+        {
+        vec3<Scalar> l = m_nodes[node_idx].aabb.getUpper() - m_nodes[node_idx].aabb.getLower();
+        area += Scalar(2.0)*(l.x*l.y + l.y*l.z + l.z*l.x);
+        }
+    return area;
+    }
+
 /*! \param idx Particle to get height for
     \returns Height of the node
 */
@@ -383,6 +624,9 @@ inline unsigned int AABBTree::height(unsigned int idx)
 
     Builds a balanced tree from a given list of AABBs for each particle. Data in \a aabbs will be modified during
     the construction process.
+
+    In builds with ENABLE_TBB, the children of large nodes are built in parallel (see buildNode()). The nodes are laid
+    out in the same order as in the serial build, so the tree does not depend on the number of threads.
 */
 inline void AABBTree::buildTree(AABB *aabbs, unsigned int N)
     {
@@ -394,6 +638,26 @@ inline void AABBTree::buildTree(AABB *aabbs, unsigned int N)
 
     m_root = buildNode(aabbs, idx, 0, N, INVALID_NODE);
     updateSkip(m_root);
+
+    // fill the compact nodes and the reverse mapping from particle indices to leaf node indices
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, m_num_nodes, [&] (unsigned int node_idx)
+    #else
+    for (unsigned int node_idx = 0; node_idx < m_num_nodes; node_idx++)
+    #endif
+        {
+        updateCompactNode(node_idx);
+
+        const AABBNode& node = m_nodes[node_idx];
+        if (node.left == INVALID_NODE)
+            {
+            for (unsigned int i = 0; i < node.num_particles; i++)
+                m_mapping[node.particles[i]] = node_idx;
+            }
+        }
+    #ifdef ENABLE_TBB
+        );
+    #endif
     }
 
 /*! \param aabbs List of AABBs
@@ -408,6 +672,10 @@ inline void AABBTree::buildTree(AABB *aabbs, unsigned int N)
 
     The aabbs and idx lists are passed in by reference. Each node is given a subrange of the list to own (start to
     start + len). When building the node, it partitions its subrange into two sides (like quick sort).
+
+    The children own disjoint subranges, so in builds with ENABLE_TBB the children of nodes with at least
+    AABB_TREE_PARALLEL_MIN AABBs are built into separate trees in parallel and then appended with appendNodes().
+    The reverse mapping is filled by buildTree() once all nodes are in place.
 */
 inline unsigned int AABBTree::buildNode(AABB *aabbs,
                                         std::vector<unsigned int>& idx,
@@ -436,9 +704,6 @@ inline unsigned int AABBTree::buildNode(AABB *aabbs,
             // assign the particle indices into the leaf node
             m_nodes[new_node].particles[i] = idx[start+i];
             m_nodes[new_node].particle_tags[i] = aabbs[start+i].tag;
-
-            // assign the reverse mapping from particle indices to leaf node indices
-            m_mapping[idx[start+i]] = new_node;
             }
 
         return new_node;
@@ -535,8 +800,27 @@ inline unsigned int AABBTree::buildNode(AABB *aabbs,
 
     // note: calling buildNode has side effects, the m_nodes array may be reallocated. So we need to determine the left
     // and right children, then build our node (can't say m_nodes[my_idx].left = buildNode(...))
-    unsigned int new_left = buildNode(aabbs, idx, start+start_left, start_right-start_left, my_idx);
-    unsigned int new_right = buildNode(aabbs, idx, start+start_right, len-start_right, my_idx);
+    unsigned int new_left, new_right;
+
+    #ifdef ENABLE_TBB
+    if (len >= AABB_TREE_PARALLEL_MIN)
+        {
+        // the children own disjoint subranges, build them into separate trees in parallel
+        AABBTree left_tree, right_tree;
+        tbb::parallel_invoke(
+            [&] { left_tree.buildNode(aabbs, idx, start+start_left, start_right-start_left, INVALID_NODE); },
+            [&] { right_tree.buildNode(aabbs, idx, start+start_right, len-start_right, INVALID_NODE); });
+
+        // append in the same order as the serial build
+        new_left = appendNodes(left_tree, my_idx);
+        new_right = appendNodes(right_tree, my_idx);
+        }
+    else
+    #endif
+        {
+        new_left = buildNode(aabbs, idx, start+start_left, start_right-start_left, my_idx);
+        new_right = buildNode(aabbs, idx, start+start_right, len-start_right, my_idx);
+        }
 
     // now, create the children and connect them up
     m_nodes[my_idx].aabb = my_aabb;
@@ -557,7 +841,7 @@ inline unsigned int AABBTree::buildNode(AABB *aabbs,
 inline unsigned int AABBTree::updateSkip(unsigned int idx)
     {
     // leaf nodes have no nodes under them
-    if (isNodeLeaf(idx))
+    if (m_nodes[idx].left == INVALID_NODE)
         {
         return 1;
         }
@@ -573,6 +857,27 @@ inline unsigned int AABBTree::updateSkip(unsigned int idx)
         }
     }
 
+/*! \param idx Index of the node to copy
+
+    The bounds are rounded outward, so that the compact node contains the full precision one.
+*/
+inline void AABBTree::updateCompactNode(unsigned int idx)
+    {
+    const AABBNode& node = m_nodes[idx];
+    AABBNodeCompact& compact = m_compact_nodes[idx];
+
+    vec3<Scalar> lower = node.aabb.getLower();
+    vec3<Scalar> upper = node.aabb.getUpper();
+    compact.lower[0] = float_round_down(lower.x);
+    compact.lower[1] = float_round_down(lower.y);
+    compact.lower[2] = float_round_down(lower.z);
+    compact.upper[0] = float_round_up(upper.x);
+    compact.upper[1] = float_round_up(upper.y);
+    compact.upper[2] = float_round_up(upper.z);
+    compact.skip = node.skip;
+    compact.leaf = (node.left == INVALID_NODE) ? 1 : 0;
+    }
+
 /*! Allocates a new node in the tree
 */
 inline unsigned int AABBTree::allocateNode()
@@ -581,10 +886,28 @@ inline unsigned int AABBTree::allocateNode()
     if (m_num_nodes >= m_node_capacity)
         {
         // determine new capacity
+        unsigned int new_capacity = m_node_capacity*2;
+        if (new_capacity == 0)
+            new_capacity = 16;
+
+        reserveNodes(new_capacity);
+        }
+
+    m_nodes[m_num_nodes] = AABBNode();
+    m_num_nodes++;
+    return m_num_nodes-1;
+    }
+
+/*! \param capacity Minimum number of nodes to make room for
+
+    Existing nodes are copied into the new arrays.
+*/
+inline void AABBTree::reserveNodes(unsigned int capacity)
+    {
+    if (capacity > m_node_capacity)
+        {
         AABBNode *m_new_nodes = NULL;
-        unsigned int m_new_node_capacity = m_node_capacity*2;
-        if (m_new_node_capacity == 0)
-            m_new_node_capacity = 16;
+        unsigned int m_new_node_capacity = capacity;
 
         // allocate new memory
         int retval = posix_memalign((void**)&m_new_nodes, 32, m_new_node_capacity*sizeof(AABBNode));
@@ -593,19 +916,55 @@ inline unsigned int AABBTree::allocateNode()
             throw std::runtime_error("Error allocating AABBTree memory");
             }
 
+        AABBNodeCompact *m_new_compact_nodes = NULL;
+        retval = posix_memalign((void**)&m_new_compact_nodes, 32, m_new_node_capacity*sizeof(AABBNodeCompact));
+        if (retval != 0)
+            {
+            throw std::runtime_error("Error allocating AABBTree memory");
+            }
+
         // if we have old memory, copy it over
         if (m_nodes != NULL)
             {
             memcpy((void *)m_new_nodes, (void *)m_nodes, sizeof(AABBNode)*m_num_nodes);
             free(m_nodes);
             }
+        if (m_compact_nodes != NULL)
+            {
+            memcpy((void *)m_new_compact_nodes, (void *)m_compact_nodes, sizeof(AABBNodeCompact)*m_num_nodes);
+            free(m_compact_nodes);
+            }
         m_nodes = m_new_nodes;
+        m_compact_nodes = m_new_compact_nodes;
         m_node_capacity = m_new_node_capacity;
         }
+    }
 
-    m_nodes[m_num_nodes] = AABBNode();
-    m_num_nodes++;
-    return m_num_nodes-1;
+/*! \param subtree Tree holding a subtree with its root at index 0, the node indices are relative to the subtree
+    \param parent Index of the parent of the subtree root in this tree
+    \returns The index of the subtree root in this tree
+
+    Only the nodes are copied, the compact nodes are filled by buildTree().
+*/
+inline unsigned int AABBTree::appendNodes(const AABBTree& subtree, unsigned int parent)
+    {
+    unsigned int offset = m_num_nodes;
+    if (m_num_nodes + subtree.m_num_nodes > m_node_capacity)
+        reserveNodes(std::max(m_node_capacity*2, m_num_nodes + subtree.m_num_nodes));
+
+    for (unsigned int i = 0; i < subtree.m_num_nodes; ++i)
+        {
+        AABBNode node = subtree.m_nodes[i];
+        if (node.left != INVALID_NODE)
+            node.left += offset;
+        if (node.right != INVALID_NODE)
+            node.right += offset;
+        node.parent = (node.parent == INVALID_NODE) ? parent : node.parent + offset;
+        m_nodes[offset + i] = node;
+        }
+    m_num_nodes += subtree.m_num_nodes;
+
+    return offset;
     }
 
 // end group overlap
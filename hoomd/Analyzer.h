@@ -92,6 +92,12 @@ class PYBIND11_EXPORT Analyzer
         */
         virtual void resetStats(){}
 
+        //! Complete any pending output
+        /*! Analyzers that write their output asynchronously must finish all outstanding writes in flush(). A System
+            calls flush() on all Analyzers at the end of every run so that files are complete when run() returns.
+        */
+        virtual void flush(){}
+
         //! Get needed pdata flags
         /*! Not all fields in ParticleData are computed by default. When derived classes need one of these optional
             fields, they must return the requested fields in getRequestedPDataFlags().
@@ -12,6 +12,8 @@
 #include <stdexcept>
 #include <algorithm>
 #include <cfloat>
+#include <fstream>
+#include <sstream>
 
 using namespace std;
 namespace py = pybind11;
@@ -21,6 +23,9 @@ namespace py = pybind11;
     \brief Definition of Autotuner
 */
 
+std::map<std::string, unsigned int> Autotuner::s_cache;
+unsigned int Autotuner::s_size_bucket = 0;
+
 /*! \param parameters List of valid parameters
     \param nsamples Number of time samples to take at each parameter
     \param period Number of calls to begin() before sampling is redone
@@ -33,8 +38,10 @@ Autotuner::Autotuner(const std::vector<unsigned int>& parameters,
                      const std::string& name,
                      std::shared_ptr<const ExecutionConfiguration> exec_conf)
     : m_nsamples(nsamples), m_period(period), m_enabled(true), m_name(name), m_parameters(parameters),
-      m_state(STARTUP), m_current_sample(0), m_current_element(0), m_calls(0),
-      m_exec_conf(exec_conf), m_mode(mode_median)
+      m_search(search_exhaustive), m_early_factor(2.0f),
+      m_state(STARTUP), m_current_sample(0), m_current_element(0), m_calls(0), m_visit_pos(0), m_opt_element(0),
+      m_search_dim(0), m_stable_passes(0), m_num_passes(0), m_best_time(FLT_MAX),
+      m_exec_conf(exec_conf), m_mode(mode_median), m_cache_checked(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing Autotuner " << nsamples << " " << period << " " << name << endl;
 
@@ -53,10 +60,12 @@ Autotuner::Autotuner(const std::vector<unsigned int>& parameters,
 
     for (unsigned int i = 0; i < m_parameters.size(); i++)
         {
-        m_samples[i].resize(m_nsamples);
+        m_samples[i].resize(m_nsamples, FLT_MAX);
         }
 
-    m_current_param = m_parameters[m_current_element];
+    m_dims.assign(1, m_parameters.size());
+    m_sampled.resize(m_parameters.size(), false);
+    startScanPass();
 
     // create CUDA events
     #ifdef ENABLE_CUDA
@@ -87,8 +96,10 @@ Autotuner::Autotuner(unsigned int start,
                      const std::string& name,
                      std::shared_ptr<const ExecutionConfiguration> exec_conf)
     : m_nsamples(nsamples), m_period(period), m_enabled(true), m_name(name),
-      m_state(STARTUP), m_current_sample(0), m_current_element(0), m_calls(0), m_current_param(0),
-      m_exec_conf(exec_conf), m_mode(mode_median)
+      m_search(search_exhaustive), m_early_factor(2.0f),
+      m_state(STARTUP), m_current_sample(0), m_current_element(0), m_calls(0), m_current_param(0), m_visit_pos(0),
+      m_opt_element(0), m_search_dim(0), m_stable_passes(0), m_num_passes(0), m_best_time(FLT_MAX),
+      m_exec_conf(exec_conf), m_mode(mode_median), m_cache_checked(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing Autotuner " << " " << start << " " << end << " " << step << " "
                                 << nsamples << " " << period << " " << name << endl;
@@ -117,10 +128,12 @@ Autotuner::Autotuner(unsigned int start,
 
     for (unsigned int i = 0; i < m_parameters.size(); i++)
         {
-        m_samples[i].resize(m_nsamples);
+        m_samples[i].resize(m_nsamples, FLT_MAX);
         }
 
-    m_current_param = m_parameters[m_current_element];
+    m_dims.assign(1, m_parameters.size());
+    m_sampled.resize(m_parameters.size(), false);
+    startScanPass();
 
     // create CUDA events
     #ifdef ENABLE_CUDA
@@ -132,6 +145,37 @@ Autotuner::Autotuner(unsigned int start,
     m_sync = false;
     }
 
+/*! \param dim_values Valid values of each dimension
+    \param dim_weights Weight of each dimension in the encoded parameter
+    \param nsamples Number of time samples to take at each parameter
+    \param period Number of calls to begin() before sampling is redone
+    \param name Descriptive name (used in messenger output)
+    \param exec_conf Execution configuration
+
+    \post The parameters are the points of the grid spanned by \a dim_values, encoded as the sum of the values
+           multiplied by their weights. They are searched by coordinate descent, starting from the center of the grid.
+*/
+Autotuner::Autotuner(const std::vector< std::vector<unsigned int> >& dim_values,
+                     const std::vector<unsigned int>& dim_weights,
+                     unsigned int nsamples,
+                     unsigned int period,
+                     const std::string& name,
+                     std::shared_ptr<const ExecutionConfiguration> exec_conf)
+    : Autotuner(encodeParameters(dim_values, dim_weights), nsamples, period, name, exec_conf)
+    {
+    m_dims.clear();
+    m_opt_element = 0;
+    for (unsigned int d = 0; d < dim_values.size(); ++d)
+        {
+        m_dims.push_back(dim_values[d].size());
+        m_opt_element = m_opt_element*dim_values[d].size() + dim_values[d].size()/2;
+        }
+
+    m_search = search_coordinate;
+    m_num_passes = 0;
+    startScanPass();
+    }
+
 Autotuner::~Autotuner()
     {
     m_exec_conf->msg->notice(5) << "Destroying Autotuner " << m_name << endl;
@@ -144,6 +188,10 @@ Autotuner::~Autotuner()
 
 void Autotuner::begin()
     {
+    // start from the cached parameter, even when disabled
+    if (!m_cache_checked)
+        applyCache();
+
     // skip if disabled
     if (!m_enabled)
         return;
@@ -159,63 +207,104 @@ void Autotuner::begin()
     #endif
     }
 
+/*! \returns The time in milliseconds between the CUDA events recorded by begin() and end()
+
+    Without CUDA, no time can be measured and FLT_MAX is returned.
+*/
+float Autotuner::measureSample()
+    {
+    float t = FLT_MAX;
+    #ifdef ENABLE_CUDA
+    cudaEventRecord(m_stop, 0);
+    cudaEventSynchronize(m_stop);
+    cudaEventElapsedTime(&t, m_start, m_stop);
+
+    if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    #endif
+    return t;
+    }
+
 void Autotuner::end()
     {
     // skip if disabled
     if (!m_enabled)
         return;
 
-    #ifdef ENABLE_CUDA
     // handle timing updates if scanning
     if (m_state == STARTUP || m_state == SCANNING)
         {
-        cudaEventRecord(m_stop, 0);
-        cudaEventSynchronize(m_stop);
-        cudaEventElapsedTime(&m_samples[m_current_element][m_current_sample], m_start, m_stop);
+        m_samples[m_current_element][m_current_sample] = measureSample();
         m_exec_conf->msg->notice(9) << "Autotuner " << m_name << ": t(" << m_current_param << "," << m_current_sample
                                      << ") = " << m_samples[m_current_element][m_current_sample] << endl;
-
-        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
-            CHECK_CUDA_ERROR();
         }
-    #endif
 
     // handle state data updates and transitions
     if (m_state == STARTUP)
         {
         // move on to the next sample
         m_current_sample++;
+        bool worse = isClearlyWorse();
 
         // if we hit the end of the samples, reset and move on to the next element
-        if (m_current_sample >= m_nsamples)
+        if (m_current_sample >= m_nsamples || worse)
             {
+            std::vector<float>& samples = m_samples[m_current_element];
+            if (worse)
+                {
+                // the samples that are not taken are set to the fastest one
+                float t = *std::min_element(samples.begin(), samples.begin() + m_current_sample);
+                std::fill(samples.begin() + m_current_sample, samples.end(), t);
+                m_exec_conf->msg->notice(9) << "Autotuner " << m_name << ": skipping the remaining samples of "
+                                            << m_current_param << endl;
+                }
+
+            m_sampled[m_current_element] = true;
+            m_best_time = std::min(m_best_time, computeSampleTime(samples));
             m_current_sample = 0;
-            m_current_element++;
+            m_visit_pos++;
 
-            // if we hit the end of the elements, transition to the IDLE state and compute the optimal parameter
-            if (m_current_element >= m_parameters.size())
+            if (m_visit_pos < m_visit.size())
                 {
-                m_current_element = 0;
-                m_state = IDLE;
-                m_current_param = computeOptimalParameter();
+                // if moving on to the next element, update the cached parameter to set
+                m_current_element = m_visit[m_visit_pos];
+                m_current_param = m_parameters[m_current_element];
                 }
             else
                 {
-                // if moving on to the next element, update the cached parameter to set
-                m_current_param = m_parameters[m_current_element];
+                // at the end of a pass, the next pass starts from the optimal parameter
+                unsigned int last_opt = m_opt_element;
+                unsigned int opt = computeOptimalParameter();
+                if (m_opt_element == last_opt)
+                    m_stable_passes++;
+                else
+                    m_stable_passes = 1;
+
+                // if this was the last pass, transition to the IDLE state
+                if (!startScanPass())
+                    {
+                    m_current_element = 0;
+                    m_visit_pos = 0;
+                    m_state = IDLE;
+                    m_current_param = opt;
+                    m_exec_conf->msg->notice(4) << "Autotuner " << m_name << " sampled "
+                                                << std::count(m_sampled.begin(), m_sampled.end(), true) << " of "
+                                                << m_parameters.size() << " parameters" << endl;
+                    }
                 }
             }
         }
     else if (m_state == SCANNING)
         {
         // move on to the next element
-        m_current_element++;
+        m_visit_pos++;
 
         // if we hit the end of the elements, transition to the IDLE state and compute the optimal parameter, and move
         // on to the next sample for next time
-        if (m_current_element >= m_parameters.size())
+        if (m_visit_pos >= m_visit.size())
             {
             m_current_element = 0;
+            m_visit_pos = 0;
             m_state = IDLE;
             m_current_param = computeOptimalParameter();
             m_current_sample = (m_current_sample + 1) % m_nsamples;
@@ -223,6 +312,7 @@ void Autotuner::end()
         else
             {
             // if moving on to the next element, update the cached parameter to set
+            m_current_element = m_visit[m_visit_pos];
             m_current_param = m_parameters[m_current_element];
             }
         }
@@ -236,7 +326,22 @@ void Autotuner::end()
             // reset state for the next time
             m_calls = 0;
 
+            // a scan samples all parameters, or the lines through the optimal parameter along all dimensions
+            m_visit.clear();
+            m_visit_pos = 0;
+            for (unsigned int d = 0; d < m_dims.size(); ++d)
+                {
+                if (m_search == search_exhaustive)
+                    {
+                    for (unsigned int i = 0; i < m_parameters.size(); ++i)
+                        m_visit.push_back(i);
+                    break;
+                    }
+                addLine(m_opt_element, d, false);
+                }
+
             // initialize a scan
+            m_current_element = m_visit[0];
             m_current_param = m_parameters[m_current_element];
             m_state = SCANNING;
             m_exec_conf->msg->notice(4) << "Autotuner " << m_name << " - beginning scan" << std::endl;
@@ -244,10 +349,46 @@ void Autotuner::end()
         }
     }
 
+/*! \param v Samples of a parameter
+    \returns The median, average or maximum of the samples, depending on the sampling mode
+*/
+float Autotuner::computeSampleTime(std::vector<float> v) const
+    {
+    if (m_mode == mode_avg)
+        {
+        // compute average
+        float sum = 0.0f;
+        for (std::vector<float>::iterator it = v.begin(); it != v.end(); ++it)
+            sum += *it;
+        return sum/v.size();
+        }
+    else if (m_mode == mode_max)
+        {
+        // compute maximum
+        float max = -FLT_MIN;
+        for (std::vector<float>::iterator it = v.begin(); it != v.end(); ++it)
+            {
+            if (*it > max)
+                {
+                max = *it;
+                }
+            }
+        return max;
+        }
+    else
+        {
+        // compute median
+        size_t n = v.size() / 2;
+        nth_element(v.begin(), v.begin()+n, v.end());
+        return v[n];
+        }
+    }
+
 /*! \returns The optimal parameter given the current data in m_samples
 
     computeOptimalParameter computes the median time among all samples for a given element. It then chooses the
     fastest time (with the lowest index breaking a tie) and returns the parameter that resulted in that time.
+    m_opt_element is set to the element of the optimal parameter.
 */
 unsigned int Autotuner::computeOptimalParameter()
     {
@@ -284,35 +425,7 @@ unsigned int Autotuner::computeOptimalParameter()
             }
         #endif
         if (is_root)
-            {
-            if (m_mode == mode_avg)
-                {
-                // compute average
-                float sum = 0.0f;
-                for (std::vector<float>::iterator it = v.begin(); it != v.end(); ++it)
-                    sum += *it;
-                m_sample_median[i] = sum/v.size();
-                }
-            else if (m_mode == mode_max)
-                {
-                // compute maximum
-                m_sample_median[i] = -FLT_MIN;
-                for (std::vector<float>::iterator it = v.begin(); it != v.end(); ++it)
-                    {
-                    if (*it > m_sample_median[i])
-                        {
-                        m_sample_median[i] = *it;
-                        }
-                    }
-                }
-            else
-                {
-                // compute median
-                size_t n = v.size() / 2;
-                nth_element(v.begin(), v.begin()+n, v.end());
-                m_sample_median[i] = v[n];
-                }
-            }
+            m_sample_median[i] = computeSampleTime(v);
         }
 
     unsigned int opt = 0;
@@ -350,9 +463,235 @@ unsigned int Autotuner::computeOptimalParameter()
     #ifdef ENABLE_MPI
     if (m_sync && nranks) bcast(opt, 0, m_exec_conf->getMPICommunicator());
     #endif
+
+    m_opt_element = std::find(m_parameters.begin(), m_parameters.end(), opt) - m_parameters.begin();
+    s_cache[getCacheKey()] = opt;
     return opt;
     }
 
+/*! \param dim_values Valid values of each dimension
+    \param dim_weights Weight of each dimension in the encoded parameter
+    \returns The points of the grid with the last dimension the fastest, empty if the dimensions are not valid
+*/
+std::vector<unsigned int> Autotuner::encodeParameters(const std::vector< std::vector<unsigned int> >& dim_values,
+                                                      const std::vector<unsigned int>& dim_weights)
+    {
+    if (dim_values.size() == 0 || dim_values.size() != dim_weights.size())
+        return std::vector<unsigned int>();
+
+    std::vector<unsigned int> parameters(1, 0);
+    for (unsigned int d = 0; d < dim_values.size(); ++d)
+        {
+        std::vector<unsigned int> next;
+        for (unsigned int i = 0; i < parameters.size(); ++i)
+            {
+            for (unsigned int j = 0; j < dim_values[d].size(); ++j)
+                next.push_back(parameters[i] + dim_values[d][j]*dim_weights[d]);
+            }
+        parameters.swap(next);
+        }
+    return parameters;
+    }
+
+/*! \param element Element on the line
+    \param dim Dimension of the line
+    \param skip_sampled If true, elements that have been sampled in the initial scan are not added
+
+    Elements that are already in the visit list are not added again.
+*/
+void Autotuner::addLine(unsigned int element, unsigned int dim, bool skip_sampled)
+    {
+    unsigned int stride = 1;
+    for (unsigned int d = dim + 1; d < m_dims.size(); ++d)
+        stride *= m_dims[d];
+
+    unsigned int first = element - ((element / stride) % m_dims[dim]) * stride;
+    for (unsigned int i = 0; i < m_dims[dim]; ++i)
+        {
+        unsigned int e = first + i*stride;
+        if (skip_sampled && m_sampled[e])
+            continue;
+        if (std::find(m_visit.begin(), m_visit.end(), e) == m_visit.end())
+            m_visit.push_back(e);
+        }
+    }
+
+/*! \returns false if the initial scan is complete
+
+    The exhaustive search makes a single pass over all parameters. The coordinate descent samples the line through the
+    optimal parameter along the next dimension, and completes once the optimum has not moved along any dimension.
+*/
+bool Autotuner::startScanPass()
+    {
+    m_visit.clear();
+    m_visit_pos = 0;
+
+    if (m_search == search_exhaustive || m_dims.size() < 2)
+        {
+        if (m_num_passes > 0)
+            return false;
+
+        for (unsigned int i = 0; i < m_parameters.size(); ++i)
+            m_visit.push_back(i);
+        }
+    else
+        {
+        while (m_visit.empty())
+            {
+            if (m_stable_passes >= m_dims.size())
+                return false;
+
+            addLine(m_opt_element, m_search_dim, true);
+
+            // the optimum is already optimal along a line that has been sampled completely
+            if (m_visit.empty())
+                m_stable_passes++;
+
+            m_search_dim = (m_search_dim + 1) % m_dims.size();
+            }
+        }
+
+    m_num_passes++;
+    m_current_element = m_visit[0];
+    m_current_param = m_parameters[m_current_element];
+    return true;
+    }
+
+/*! \returns true if the samples taken of the current element are all slower than the early termination factor times
+             the best time
+*/
+bool Autotuner::isClearlyWorse() const
+    {
+    if (m_early_factor <= 0.0f || m_best_time == FLT_MAX || m_current_sample == 0)
+        return false;
+
+    #ifdef ENABLE_MPI
+    // all synchronized ranks need to take the same number of samples
+    if (m_sync && m_exec_conf->getNRanks() > 1)
+        return false;
+    #endif
+
+    const std::vector<float>& samples = m_samples[m_current_element];
+    float t = *std::min_element(samples.begin(), samples.begin() + m_current_sample);
+    return t > m_early_factor*m_best_time;
+    }
+
+/*! \returns The name, GPU model and problem size bucket separated by tabs
+*/
+std::string Autotuner::getCacheKey() const
+    {
+    std::string gpu = m_exec_conf->getGPUName();
+    if (gpu.empty())
+        gpu = "cpu";
+
+    std::ostringstream s;
+    s << m_name << "\t" << gpu << "\t" << s_size_bucket;
+    return s.str();
+    }
+
+/*! If the cache holds a valid parameter for this Autotuner, skip the initial scan. The samples are primed so that
+    the cached parameter remains optimal until the periodic scans have measured all parameters.
+
+    Synchronized Autotuners use the cached parameter only if it is found on all ranks, so that all ranks continue to
+    scan together.
+*/
+void Autotuner::applyCache()
+    {
+    m_cache_checked = true;
+
+    if (m_state != STARTUP)
+        return;
+
+    std::map<std::string, unsigned int>::iterator it = s_cache.find(getCacheKey());
+    std::vector<unsigned int>::iterator param = m_parameters.end();
+    if (it != s_cache.end())
+        param = std::find(m_parameters.begin(), m_parameters.end(), it->second);
+    int found = (param != m_parameters.end());
+    unsigned int idx = found ? (unsigned int)(param - m_parameters.begin()) : 0;
+
+    #ifdef ENABLE_MPI
+    if (m_sync && m_exec_conf->getNRanks() > 1)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &found, 1, MPI_INT, MPI_LAND, m_exec_conf->getMPICommunicator());
+        bcast(idx, 0, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    if (!found)
+        return;
+
+    for (unsigned int i = 0; i < m_parameters.size(); i++)
+        std::fill(m_samples[i].begin(), m_samples[i].end(), (i == idx) ? 0.0f : FLT_MAX);
+
+    m_current_sample = 0;
+    m_current_element = 0;
+    m_visit_pos = 0;
+    m_opt_element = idx;
+    m_calls = 0;
+    m_state = IDLE;
+    m_current_param = m_parameters[idx];
+    m_exec_conf->msg->notice(4) << "Autotuner " << m_name << " using cached parameter " << m_current_param << endl;
+    }
+
+/*! \param fname Cache file to read
+    \param exec_conf Execution configuration
+
+    Entries in the file are added to the cache, replacing existing entries with the same key. A missing file is not an
+    error. In MPI simulations, the root rank reads the file and broadcasts the entries.
+*/
+void Autotuner::loadCache(const std::string& fname, std::shared_ptr<const ExecutionConfiguration> exec_conf)
+    {
+    std::map<std::string, unsigned int> entries;
+
+    if (exec_conf->isRoot())
+        {
+        std::ifstream f(fname.c_str());
+        std::string line;
+        while (std::getline(f, line))
+            {
+            size_t pos = line.rfind('\t');
+            if (pos == std::string::npos)
+                continue;
+
+            std::istringstream value(line.substr(pos+1));
+            unsigned int param;
+            if (value >> param)
+                entries[line.substr(0, pos)] = param;
+            }
+
+        exec_conf->msg->notice(2) << "Read " << entries.size() << " autotuner cache entries from " << fname << endl;
+        }
+
+    #ifdef ENABLE_MPI
+    if (exec_conf->getNRanks() > 1)
+        bcast(entries, 0, exec_conf->getMPICommunicator());
+    #endif
+
+    for (std::map<std::string, unsigned int>::iterator it = entries.begin(); it != entries.end(); ++it)
+        s_cache[it->first] = it->second;
+    }
+
+/*! \param fname Cache file to write
+    \param exec_conf Execution configuration
+
+    The root rank writes all entries in the cache, one per line.
+*/
+void Autotuner::saveCache(const std::string& fname, std::shared_ptr<const ExecutionConfiguration> exec_conf)
+    {
+    if (!exec_conf->isRoot())
+        return;
+
+    std::ofstream f(fname.c_str());
+    if (!f.good())
+        {
+        exec_conf->msg->error() << "Unable to write autotuner cache " << fname << endl;
+        throw std::runtime_error("Error writing autotuner cache");
+        }
+
+    for (std::map<std::string, unsigned int>::iterator it = s_cache.begin(); it != s_cache.end(); ++it)
+        f << it->first << "\t" << it->second << "\n";
+    }
+
 void export_Autotuner(py::module& m)
     {
     py::class_<Autotuner>(m,"Autotuner")
@@ -361,5 +700,8 @@ void export_Autotuner(py::module& m)
     .def("setEnabled", &Autotuner::setEnabled)
     .def("setMoveRatio", &Autotuner::isComplete)
     .def("setNSelect", &Autotuner::setPeriod)
+    .def_static("loadCache", &Autotuner::loadCache)
+    .def_static("saveCache", &Autotuner::saveCache)
+    .def_static("clearCache", &Autotuner::clearCache)
     ;
     }
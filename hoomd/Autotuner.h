@@ -14,6 +14,7 @@
 
 #include <vector>
 #include <string>
+#include <map>
 
 #ifdef ENABLE_CUDA
 #include <cuda_runtime.h>
@@ -44,6 +45,26 @@
 
     Each Autotuner instance has a string name to help identify it's output on the notice stream.
 
+    **Search** <br>
+    Kernels with several tuning parameters (e.g. block size and threads per particle) can pass one list of values per
+    dimension, together with the weights that encode a point of the grid as a single parameter (e.g. block_size*10000
+    + threads_per_particle). The parameter space is then searched by coordinate descent: each pass of the initial
+    scan samples the line through the current optimum along one dimension, and the scan completes when the optimum
+    has not moved for one pass over every dimension. The periodic scans sample the lines through the optimum along all
+    dimensions. setSearchMode() selects the exhaustive search of all parameters instead.
+
+    During the initial scan, the sampling of a parameter stops early once its fastest sample is slower than a factor
+    (setEarlyTermination()) times the best time measured so far. Early termination is not used by Autotuners that are
+    synchronized over several MPI ranks, since all ranks need to take the same number of samples.
+
+    **Cache** <br>
+    The optimal parameters found by all Autotuner instances are stored in a process wide cache, keyed by name, GPU
+    model and problem size bucket (floor of log2 of the local number of particles set with setProblemSize()).
+    loadCache() and saveCache() read and write the cache to a file so that later jobs can reuse previous results. On
+    its first call to begin(), an Autotuner with a matching cache entry skips the initial scan and starts with the
+    cached parameter. The cached parameter remains optimal until the periodic scans have collected enough samples
+    to re-validate it.
+
     Autotuner is not useful in non-GPU builds. Timing is performed with CUDA events and requires ENABLE_CUDA=on.
     Behavior of Autotuner is undefined when ENABLE_CUDA=off.
 
@@ -52,7 +73,8 @@
     current sample being taken in a circular fashion, and m_current_element is the index of the current parameter being
     sampled. m_samples stores the time of each sampled kernel launch, and m_sample_median stores the current median of
     each set of samples. When idle, the number of calls is counted in m_calls. m_state lists the current state in the
-    state machine.
+    state machine. m_visit lists the elements sampled in the current pass of a scan, m_visit_pos is the position of
+    m_current_element in it. Elements that have not been sampled have a time of FLT_MAX.
 */
 class PYBIND11_EXPORT Autotuner
     {
@@ -73,8 +95,16 @@ class PYBIND11_EXPORT Autotuner
                   const std::string& name,
                   std::shared_ptr<const ExecutionConfiguration> exec_conf);
 
+        //! Constructor with a multi-dimensional parameter space
+        Autotuner(const std::vector< std::vector<unsigned int> >& dim_values,
+                  const std::vector<unsigned int>& dim_weights,
+                  unsigned int nsamples,
+                  unsigned int period,
+                  const std::string& name,
+                  std::shared_ptr<const ExecutionConfiguration> exec_conf);
+
         //! Destructor
-        ~Autotuner();
+        virtual ~Autotuner();
 
         //! Call before kernel launch
         void begin();
@@ -113,6 +143,7 @@ class PYBIND11_EXPORT Autotuner
                     {
                     // ensure that we are in the idle state and have an up to date optimal parameter
                     m_current_element = 0;
+                    m_visit_pos = 0;
                     m_state = IDLE;
                     m_current_param = computeOptimalParameter();
                     }
@@ -134,6 +165,14 @@ class PYBIND11_EXPORT Autotuner
                 return false;
             }
 
+        //! Test if the kernel timings are sampled on the next call
+        /*! \returns true if the autotuner is enabled and in the startup or scanning state
+        */
+        bool isSampling()
+            {
+            return m_enabled && (m_state == STARTUP || m_state == SCANNING);
+            }
+
         //! Change the sampling period
         /*! \param period New period to set
         */
@@ -166,6 +205,62 @@ class PYBIND11_EXPORT Autotuner
             m_mode = mode;
             }
 
+        //!< Enumeration of the search modes
+        enum search_Enum {
+            search_exhaustive = 0,  //!< Sample all parameters
+            search_coordinate       //!< Coordinate descent over the dimensions of the parameter space
+            };
+
+        //! Set the search mode
+        /*! \param search The search mode
+
+            The initial scan is restarted with the new mode if it has not taken any samples yet. Otherwise, the mode
+            takes effect with the next scan.
+        */
+        void setSearchMode(search_Enum search)
+            {
+            m_search = search;
+
+            if (m_state == STARTUP && m_num_passes <= 1 && m_visit_pos == 0 && m_current_sample == 0)
+                {
+                m_stable_passes = 0;
+                m_num_passes = 0;
+                startScanPass();
+                }
+            }
+
+        //! Set the factor for the early termination of the sampling of slow parameters
+        /*! \param factor Stop sampling a parameter when its fastest sample is slower than \a factor times the best
+                time so far, 0 to take all samples
+        */
+        void setEarlyTermination(float factor)
+            {
+            m_early_factor = factor;
+            }
+
+
+        //! Set the problem size used to select cache entries
+        /*! \param N Number of local particles
+        */
+        static void setProblemSize(unsigned int N)
+            {
+            unsigned int bucket = 0;
+            while (N >>= 1)
+                bucket++;
+            s_size_bucket = bucket;
+            }
+
+        //! Load optimal parameters from a cache file
+        static void loadCache(const std::string& fname, std::shared_ptr<const ExecutionConfiguration> exec_conf);
+
+        //! Save the optimal parameters of all Autotuners to a cache file
+        static void saveCache(const std::string& fname, std::shared_ptr<const ExecutionConfiguration> exec_conf);
+
+        //! Remove all entries from the cache
+        static void clearCache()
+            {
+            s_cache.clear();
+            }
 
         //! build list of thread per particle targets
         static std::vector<unsigned int> getTppListPow2(unsigned int warpSize)
@@ -184,6 +279,31 @@ class PYBIND11_EXPORT Autotuner
     protected:
         unsigned int computeOptimalParameter();
 
+        //! Measure the time of the sampled kernel launch
+        virtual float measureSample();
+
+        //! Compute the time of a parameter from its samples with the current sampling mode
+        float computeSampleTime(std::vector<float> v) const;
+
+        //! Encode the grid of a multi-dimensional parameter space as a list of parameters
+        static std::vector<unsigned int> encodeParameters(const std::vector< std::vector<unsigned int> >& dim_values,
+                                                          const std::vector<unsigned int>& dim_weights);
+
+        //! Append the elements on the line through an element along a dimension to the visit list
+        void addLine(unsigned int element, unsigned int dim, bool skip_sampled);
+
+        //! Set up the next pass of the initial scan
+        bool startScanPass();
+
+        //! Test if the sampling of the current element may stop early
+        bool isClearlyWorse() const;
+
+        //! Get the key of this Autotuner in the cache
+        std::string getCacheKey() const;
+
+        //! Start from the cached parameter, if there is one
+        void applyCache();
+
         //! State names
         enum State
            {
@@ -198,6 +318,9 @@ class PYBIND11_EXPORT Autotuner
         bool m_enabled;             //!< True if enabled
         std::string m_name;         //!< Descriptive name
         std::vector<unsigned int> m_parameters;  //!< valid parameters
+        std::vector<unsigned int> m_dims;        //!< Number of values in each dimension, the last is the fastest
+        search_Enum m_search;       //!< The search mode
+        float m_early_factor;       //!< Factor for the early termination of slow parameters, 0 to disable
 
         // state info
         State m_state;                  //!< Current state
@@ -205,6 +328,14 @@ class PYBIND11_EXPORT Autotuner
         unsigned int m_current_element; //!< Index of current parameter sampled
         unsigned int m_calls;           //!< Count of the number of calls since the last sample
         unsigned int m_current_param;   //!< Value of the current parameter
+        std::vector<unsigned int> m_visit;  //!< Elements to sample in the current pass
+        unsigned int m_visit_pos;       //!< Position of the current element in m_visit
+        std::vector<bool> m_sampled;    //!< True for the elements sampled in the initial scan
+        unsigned int m_opt_element;     //!< Element of the optimal parameter of the last pass
+        unsigned int m_search_dim;      //!< Dimension of the current pass of the coordinate descent
+        unsigned int m_stable_passes;   //!< Number of passes in a row that did not move the optimum
+        unsigned int m_num_passes;      //!< Number of passes of the initial scan
+        float m_best_time;              //!< Best time sampled in the initial scan
 
         std::vector< std::vector< float > > m_samples;  //!< Raw sample data for each element
         std::vector< float > m_sample_median;           //!< Current sample median for each element
@@ -218,6 +349,10 @@ class PYBIND11_EXPORT Autotuner
 
         bool m_sync;              //!< If true, synchronize results via MPI
         mode_Enum m_mode;         //!< The sampling mode
+        bool m_cache_checked;     //!< True after the cache has been searched for this Autotuner
+
+        static std::map<std::string, unsigned int> s_cache; //!< Optimal parameters by cache key
+        static unsigned int s_size_bucket;                   //!< Current problem size bucket
     };
 
 //! Export the Autotuner class to python
@@ -15,6 +15,8 @@
 
 #include "hoomd/extern/pybind/include/pybind11/numpy.h"
 
+#include <algorithm>
+
 #ifdef ENABLE_CUDA
 #include "BondedGroupData.cuh"
 #include "CachedAllocator.h"
@@ -44,14 +46,17 @@ template<unsigned int group_size, typename Group, const char *name, bool has_typ
 BondedGroupData<group_size, Group, name, has_type_mapping>::BondedGroupData(
     std::shared_ptr<ParticleData> pdata,
     unsigned int n_group_types)
-    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true)
+    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true),
+      m_group_list_dirty(true), m_particles_reordered(false), m_gpu_table_n_local(0)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "BondedGroupData");
+
     m_exec_conf->msg->notice(5) << "Constructing BondedGroupData (" << name<< "s, n=" << group_size << ") "
         << endl;
 
     // connect to particle sort signal
     m_pdata->getParticleSortSignal().template connect<BondedGroupData<group_size, Group, name, has_type_mapping>,
-        &BondedGroupData<group_size, Group, name, has_type_mapping>::setDirty>(this);
+        &BondedGroupData<group_size, Group, name, has_type_mapping>::slotParticleSort>(this);
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
@@ -76,14 +81,6 @@ BondedGroupData<group_size, Group, name, has_type_mapping>::BondedGroupData(
 
     // initialize data structures
     initialize();
-
-    #ifdef ENABLE_CUDA
-    if (m_exec_conf->isCUDAEnabled())
-        {
-        // create a ModernGPU context
-        m_mgpu_context = mgpu::CreateCudaDeviceAttachStream(0);
-        }
-    #endif
     }
 
 /*! \param exec_conf Execution configuration
@@ -94,21 +91,16 @@ template<unsigned int group_size, typename Group, const char *name, bool has_typ
 BondedGroupData<group_size, Group, name, has_type_mapping>::BondedGroupData(
     std::shared_ptr<ParticleData> pdata,
     const Snapshot& snapshot)
-    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true)
+    : m_exec_conf(pdata->getExecConf()), m_pdata(pdata), m_n_groups(0), m_n_ghost(0), m_nglobal(0), m_groups_dirty(true),
+      m_group_list_dirty(true), m_particles_reordered(false), m_gpu_table_n_local(0)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "BondedGroupData");
+
     m_exec_conf->msg->notice(5) << "Constructing BondedGroupData (" << name << ") " << endl;
 
     // connect to particle sort signal
     m_pdata->getParticleSortSignal().template connect<BondedGroupData<group_size, Group, name, has_type_mapping>,
-        &BondedGroupData<group_size, Group, name, has_type_mapping>::setDirty>(this);
-
-    #ifdef ENABLE_CUDA
-    if (m_exec_conf->isCUDAEnabled())
-        {
-        // create a ModernGPU context
-        m_mgpu_context = mgpu::CreateCudaDeviceAttachStream(0);
-        }
-    #endif
+        &BondedGroupData<group_size, Group, name, has_type_mapping>::slotParticleSort>(this);
 
     // initialize from snapshot
     initializeFromSnapshot(snapshot);
@@ -127,7 +119,7 @@ template<unsigned int group_size, typename Group, const char *name, bool has_typ
 BondedGroupData<group_size, Group, name, has_type_mapping>::~BondedGroupData()
     {
     m_pdata->getParticleSortSignal().template disconnect<BondedGroupData<group_size, Group, name, has_type_mapping>,
-        &BondedGroupData<group_size, Group, name, has_type_mapping>::setDirty>(this);
+        &BondedGroupData<group_size, Group, name, has_type_mapping>::slotParticleSort>(this);
     #ifdef ENABLE_MPI
     m_pdata->getSingleParticleMoveSignal().template disconnect<BondedGroupData<group_size, Group, name, has_type_mapping>,
         &BondedGroupData<group_size, Group, name, has_type_mapping>::moveParticleGroups>(this);
@@ -168,15 +160,34 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::initialize()
     m_group_rtag.swap(group_rtag);
 
     // Lookup by particle index table
-    GPUVector<members_t> gpu_table(m_exec_conf);
+    GlobalVector<members_t> gpu_table(m_exec_conf);
     m_gpu_table.swap(gpu_table);
 
-    GPUVector<unsigned int> gpu_pos_table(m_exec_conf);
+    GlobalVector<unsigned int> gpu_pos_table(m_exec_conf);
     m_gpu_pos_table.swap(gpu_pos_table);
 
-    GPUVector<unsigned int> n_groups(m_exec_conf);
+    GlobalVector<unsigned int> n_groups(m_exec_conf);
     m_gpu_n_groups.swap(n_groups);
 
+    GlobalVector<members_t> gpu_table_alt(m_exec_conf);
+    m_gpu_table_alt.swap(gpu_table_alt);
+
+    GlobalVector<unsigned int> gpu_pos_table_alt(m_exec_conf);
+    m_gpu_pos_table_alt.swap(gpu_pos_table_alt);
+
+    GlobalVector<unsigned int> n_groups_alt(m_exec_conf);
+    m_gpu_n_groups_alt.swap(n_groups_alt);
+
+    GlobalVector<unsigned int> gpu_table_tag(m_exec_conf);
+    m_gpu_table_tag.swap(gpu_table_tag);
+
+    // Group-centric table
+    GPUVector<members_t> group_list(m_exec_conf);
+    m_gpu_group_list.swap(group_list);
+
+    GPUVector<unsigned int> group_list_type(m_exec_conf);
+    m_gpu_group_list_type.swap(group_list_type);
+
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
@@ -208,6 +219,9 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::initialize()
     GPUArray<unsigned int> condition(1, m_exec_conf);
     m_condition.swap(condition);
 
+    GlobalVector<unsigned int> gpu_table_keep(m_exec_conf);
+    m_gpu_table_keep.swap(gpu_table_keep);
+
     ArrayHandle<unsigned int> h_condition(m_condition, access_location::host, access_mode::overwrite);
     *h_condition.data = 0;
     m_next_flag = 1;
@@ -720,66 +734,116 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::maybe_rebuild_t
     m_invalid_cached_tags = false;
     }
 
+/*! \param incremental If true, keep the rows of the particles that were local when the table was last updated
+
+    In an incremental update, the rows of the particles that were local and still are are copied to the current
+    particle index, with the member indices mapped through the particle tags. The groups of a local particle are always
+    local, so only the rows of ghost particles, of particles that arrived since the last update, and of particles with
+    a member that is no longer available are rebuilt from the groups. A full update rebuilds every row and is required
+    whenever groups are added or removed.
+*/
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
-void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable()
+void BondedGroupData<group_size, Group, name, has_type_mapping>::updateGPUTable(bool incremental)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "BondedGroupData");
+
     #ifdef ENABLE_CUDA
     if (m_exec_conf->isCUDAEnabled())
-        rebuildGPUTableGPU();
+        updateGPUTableGPU(incremental);
     else
     #endif
         {
         if (m_prof) m_prof->push("update " + std::string(name) + " table");
 
-        ArrayHandle< unsigned int > h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+        const unsigned int N = m_pdata->getN();
+        const unsigned int nptl = N + m_pdata->getNGhosts();
+        const unsigned int ngroups_tot = m_n_groups+m_n_ghost;
 
-        m_gpu_n_groups.resize(m_pdata->getN()+m_pdata->getNGhosts());
+        // the current table becomes the previous table
+        Index2D old_indexer = m_gpu_table_indexer;
+        m_gpu_table.swap(m_gpu_table_alt);
+        m_gpu_pos_table.swap(m_gpu_pos_table_alt);
+        m_gpu_n_groups.swap(m_gpu_n_groups_alt);
 
-        unsigned int num_groups_max = 0;
+        ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+        ArrayHandle<members_t> h_groups(m_groups, access_location::host, access_mode::read);
+        ArrayHandle<typeval_t> h_group_typeval(m_group_typeval, access_location::host, access_mode::read);
 
-        unsigned int ngroups_tot = m_n_groups+m_n_ghost;
-            {
-            ArrayHandle<unsigned int> h_n_groups(m_gpu_n_groups, access_location::host, access_mode::overwrite);
+        // index of the kept row in the previous table, NOT_LOCAL for rows that are rebuilt
+        std::vector<unsigned int> old_idx(nptl, NOT_LOCAL);
 
-            unsigned int N = m_pdata->getN()+m_pdata->getNGhosts();
+        // number of groups per particle
+        std::vector<unsigned int> n_groups(nptl, 0);
 
-            // count the number of bonded groups per particle
-            // start by initializing the n_groups values to 0
-            memset(h_n_groups.data, 0, sizeof(unsigned int) * N);
+        if (incremental)
+            {
+            ArrayHandle<unsigned int> h_table_tag(m_gpu_table_tag, access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_n_groups_old(m_gpu_n_groups_alt, access_location::host, access_mode::read);
+            ArrayHandle<members_t> h_gpu_table_old(m_gpu_table_alt, access_location::host, access_mode::read);
 
-            // loop through the particles and count the number of groups based on each particle index
-            for (unsigned int cur_group = 0; cur_group < ngroups_tot; cur_group++)
+            for (unsigned int j = 0; j < m_gpu_table_n_local; ++j)
                 {
-                members_t g = m_groups[cur_group];
-                for (unsigned int i = 0; i < group_size; ++i)
-                    {
-                    unsigned int tag = g.tag[i];
-                    unsigned int idx = h_rtag.data[tag];
+                unsigned int i = h_rtag.data[h_table_tag.data[j]];
+                if (i >= N)
+                    continue;
 
-                    if (idx == NOT_LOCAL)
+                // a row can only be kept if all members are still available
+                bool complete = true;
+                for (unsigned int k = 0; k < h_n_groups_old.data[j] && complete; ++k)
+                    {
+                    members_t h = h_gpu_table_old.data[old_indexer(j, k)];
+                    for (unsigned int m = 0; m < group_size-1; ++m)
                         {
-                        // incomplete group
-                        std::ostringstream oss;
-                        oss << name << ".*: " << name << " ";
-                        for (unsigned int k = 0; k < group_size; ++k)
-                            oss << g.tag[k] << ((k != group_size - 1) ? ", " : " ");
-                        oss << "incomplete!" << std::endl;
-                        m_exec_conf->msg->error() << oss.str();
-                        throw std::runtime_error("Error building GPU group table.");
+                        if (h_rtag.data[h_table_tag.data[h.idx[m]]] == NOT_LOCAL)
+                            {
+                            complete = false;
+                            break;
+                            }
                         }
+                    }
 
-                    h_n_groups.data[idx]++;
+                if (complete)
+                    {
+                    old_idx[i] = j;
+                    n_groups[i] = h_n_groups_old.data[j];
                     }
                 }
+            }
+
+        // loop through the groups and count the number of groups of the rebuilt rows
+        for (unsigned int cur_group = 0; cur_group < ngroups_tot; cur_group++)
+            {
+            members_t g = h_groups.data[cur_group];
+            for (unsigned int i = 0; i < group_size; ++i)
+                {
+                unsigned int tag = g.tag[i];
+                unsigned int idx = h_rtag.data[tag];
+
+                if (idx == NOT_LOCAL)
+                    {
+                    // incomplete group
+                    std::ostringstream oss;
+                    oss << name << ".*: " << name << " ";
+                    for (unsigned int k = 0; k < group_size; ++k)
+                        oss << g.tag[k] << ((k != group_size - 1) ? ", " : " ");
+                    oss << "incomplete!" << std::endl;
+                    m_exec_conf->msg->error() << oss.str();
+                    throw std::runtime_error("Error building GPU group table.");
+                    }
 
-            // find the maximum number of groups
-            for (unsigned int i = 0; i < N; i++)
-                if (h_n_groups.data[i] > num_groups_max)
-                    num_groups_max = h_n_groups.data[i];
+                if (old_idx[idx] == NOT_LOCAL)
+                    n_groups[idx]++;
+                }
             }
 
+        // find the maximum number of groups
+        unsigned int num_groups_max = 0;
+        for (unsigned int i = 0; i < nptl; i++)
+            num_groups_max = std::max(num_groups_max, n_groups[i]);
+
         // resize lookup table
-        m_gpu_table_indexer = Index2D(m_pdata->getN()+m_pdata->getNGhosts(), num_groups_max);
+        m_gpu_n_groups.resize(nptl);
+        m_gpu_table_indexer = Index2D(nptl, num_groups_max);
         m_gpu_table.resize(m_gpu_table_indexer.getNumElements());
         m_gpu_pos_table.resize(m_gpu_table_indexer.getNumElements());
 
@@ -788,19 +852,48 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
             ArrayHandle<members_t> h_gpu_table(m_gpu_table, access_location::host, access_mode::overwrite);
             ArrayHandle<unsigned int> h_gpu_pos_table(m_gpu_pos_table, access_location::host, access_mode::overwrite);
 
-            // now, update the actual table
-            // zero the number of bonded groups counter (again)
-            memset(h_n_groups.data, 0, sizeof(unsigned int) * (m_pdata->getN()+m_pdata->getNGhosts()));
+            // copy the kept rows
+            if (incremental)
+                {
+                ArrayHandle<unsigned int> h_table_tag(m_gpu_table_tag, access_location::host, access_mode::read);
+                ArrayHandle<members_t> h_gpu_table_old(m_gpu_table_alt, access_location::host, access_mode::read);
+                ArrayHandle<unsigned int> h_gpu_pos_table_old(m_gpu_pos_table_alt, access_location::host,
+                    access_mode::read);
+
+                for (unsigned int i = 0; i < nptl; ++i)
+                    {
+                    unsigned int j = old_idx[i];
+                    if (j == NOT_LOCAL)
+                        continue;
+
+                    for (unsigned int k = 0; k < n_groups[i]; ++k)
+                        {
+                        members_t h = h_gpu_table_old.data[old_indexer(j, k)];
+                        for (unsigned int m = 0; m < group_size-1; ++m)
+                            h.idx[m] = h_rtag.data[h_table_tag.data[h.idx[m]]];
+
+                        h_gpu_table.data[m_gpu_table_indexer(i, k)] = h;
+                        h_gpu_pos_table.data[m_gpu_table_indexer(i, k)] = h_gpu_pos_table_old.data[old_indexer(j, k)];
+                        }
+                    }
+                }
+
+            // the number of groups of the rebuilt rows is counted again while they are filled
+            for (unsigned int i = 0; i < nptl; ++i)
+                h_n_groups.data[i] = (old_idx[i] == NOT_LOCAL) ? 0 : n_groups[i];
 
             // loop through all group and add them to each column in the list
             for (unsigned int cur_group = 0; cur_group < ngroups_tot; cur_group++)
                 {
-                members_t g = m_groups[cur_group];
+                members_t g = h_groups.data[cur_group];
 
                 for (unsigned int i = 0; i < group_size; ++i)
                     {
                     unsigned int tag1 = g.tag[i];
                     unsigned int idx1 = h_rtag.data[tag1];
+                    if (old_idx[idx1] != NOT_LOCAL)
+                        continue;
+
                     unsigned int num = h_n_groups.data[idx1]++;
 
                     members_t h;
@@ -808,7 +901,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                     if (has_type_mapping)
                         {
                         // last element = type
-                        h.idx[group_size-1] = ((typeval_t) m_group_typeval[cur_group]).type;
+                        h.idx[group_size-1] = ((typeval_t) h_group_typeval.data[cur_group]).type;
                         }
                     else
                         {
@@ -837,21 +930,159 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                 }
             }
 
+        // remember the tags of the rows for the next incremental update
+        m_gpu_table_tag.resize(nptl);
+            {
+            ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_table_tag(m_gpu_table_tag, access_location::host, access_mode::overwrite);
+            std::copy(h_tag.data, h_tag.data + nptl, h_table_tag.data);
+            }
+        m_gpu_table_n_local = N;
+
         if (m_prof) m_prof->pop();
         }
+
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled() && m_exec_conf->allConcurrentManagedAccess())
+        adviseGPUTable();
+    #endif
     }
 
 #ifdef ENABLE_CUDA
+/*! Every GPU evaluates the groups of the particles in its range of the GPU partition, so the lookup table rows of these
+    particles are kept in the memory of that GPU. The range changes whenever the particles are sorted or migrate, which
+    is also when the table is rebuilt.
+*/
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
-void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTableGPU()
+void BondedGroupData<group_size, Group, name, has_type_mapping>::adviseGPUTable()
+    {
+    auto gpu_map = m_exec_conf->getGPUIds();
+    const GPUPartition& gpu_partition = m_pdata->getGPUPartition();
+    unsigned int pitch = m_gpu_table_indexer.getW();
+
+    for (unsigned int idev = 0; idev < m_exec_conf->getNumActiveGPUs(); ++idev)
+        {
+        auto range = gpu_partition.getRange(idev);
+        unsigned int nelem = range.second - range.first;
+
+        if (!nelem)
+            continue;
+
+        cudaMemAdvise(m_gpu_n_groups.get()+range.first, sizeof(unsigned int)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+        cudaMemPrefetchAsync(m_gpu_n_groups.get()+range.first, sizeof(unsigned int)*nelem, gpu_map[idev]);
+
+        for (unsigned int i = 0; i < m_gpu_table_indexer.getH(); ++i)
+            {
+            cudaMemAdvise(m_gpu_table.get()+i*pitch+range.first, sizeof(members_t)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+            cudaMemAdvise(m_gpu_pos_table.get()+i*pitch+range.first, sizeof(unsigned int)*nelem, cudaMemAdviseSetPreferredLocation, gpu_map[idev]);
+
+            cudaMemPrefetchAsync(m_gpu_table.get()+i*pitch+range.first, sizeof(members_t)*nelem, gpu_map[idev]);
+            cudaMemPrefetchAsync(m_gpu_pos_table.get()+i*pitch+range.first, sizeof(unsigned int)*nelem, gpu_map[idev]);
+            }
+        }
+    CHECK_CUDA_ERROR();
+    }
+#endif
+
+/*! The table is rebuilt on the host whenever the groups or the particle order change, which happens at most once per
+    particle sort or ghost exchange. Groups without a local member (ghost groups) are skipped.
+*/
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUGroupList()
+    {
+    if (m_prof) m_prof->push("update " + std::string(name) + " list");
+
+    ArrayHandle< unsigned int > h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<members_t> h_groups(m_groups, access_location::host, access_mode::read);
+    ArrayHandle<typeval_t> h_group_typeval(m_group_typeval, access_location::host, access_mode::read);
+
+    const unsigned int N = m_pdata->getN();
+    unsigned int ngroups_tot = m_n_groups+m_n_ghost;
+
+    // sort the groups with a local member by their smallest member index
+    std::vector< std::pair<unsigned int, unsigned int> > order;
+    order.reserve(ngroups_tot);
+    for (unsigned int cur_group = 0; cur_group < ngroups_tot; cur_group++)
+        {
+        members_t g = h_groups.data[cur_group];
+        unsigned int min_idx = NOT_LOCAL;
+        for (unsigned int i = 0; i < group_size; ++i)
+            {
+            unsigned int idx = h_rtag.data[g.tag[i]];
+            if (idx == NOT_LOCAL)
+                {
+                // incomplete group
+                std::ostringstream oss;
+                oss << name << ".*: " << name << " ";
+                for (unsigned int k = 0; k < group_size; ++k)
+                    oss << g.tag[k] << ((k != group_size - 1) ? ", " : " ");
+                oss << "incomplete!" << std::endl;
+                m_exec_conf->msg->error() << oss.str();
+                throw std::runtime_error("Error building GPU group list.");
+                }
+            min_idx = std::min(min_idx, idx);
+            }
+
+        if (min_idx < N)
+            order.push_back(std::make_pair(min_idx, cur_group));
+        }
+    std::sort(order.begin(), order.end());
+
+    m_gpu_group_list.resize(order.size());
+    m_gpu_group_list_type.resize(order.size());
+
+        {
+        ArrayHandle<members_t> h_group_list(m_gpu_group_list, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_group_list_type(m_gpu_group_list_type, access_location::host, access_mode::overwrite);
+
+        for (unsigned int i = 0; i < order.size(); i++)
+            {
+            unsigned int cur_group = order[i].second;
+            members_t g = h_groups.data[cur_group];
+
+            members_t h;
+            for (unsigned int j = 0; j < group_size; ++j)
+                h.idx[j] = h_rtag.data[g.tag[j]];
+            h_group_list.data[i] = h;
+
+            if (has_type_mapping)
+                h_group_list_type.data[i] = ((typeval_t) h_group_typeval.data[cur_group]).type;
+            else
+                h_group_list_type.data[i] = cur_group;
+            }
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+#ifdef ENABLE_CUDA
+/*! \param incremental If true, keep the rows of the particles that were local when the table was last updated
+
+    \sa updateGPUTable()
+*/
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+void BondedGroupData<group_size, Group, name, has_type_mapping>::updateGPUTableGPU(bool incremental)
     {
     if (m_prof) m_prof->push(m_exec_conf, "update " + std::string(name) + " table");
 
+    const unsigned int N = m_pdata->getN();
+    const unsigned int nptl = N + m_pdata->getNGhosts();
+
+    // the current table becomes the previous table
+    Index2D old_indexer = m_gpu_table_indexer;
+    if (incremental)
+        {
+        m_gpu_table.swap(m_gpu_table_alt);
+        m_gpu_pos_table.swap(m_gpu_pos_table_alt);
+        m_gpu_n_groups.swap(m_gpu_n_groups_alt);
+        }
+
     // resize groups counter
-    m_gpu_n_groups.resize(m_pdata->getN()+m_pdata->getNGhosts());
+    m_gpu_n_groups.resize(nptl);
+    m_gpu_table_keep.resize(nptl);
 
     // resize GPU table to current number of particles
-    m_gpu_table_indexer = Index2D(m_pdata->getN()+m_pdata->getNGhosts(), m_gpu_table_indexer.getH());
+    m_gpu_table_indexer = Index2D(nptl, m_gpu_table_indexer.getH());
     m_gpu_table.resize(m_gpu_table_indexer.getNumElements());
     m_gpu_pos_table.resize(m_gpu_table_indexer.getNumElements());
 
@@ -865,20 +1096,39 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
             ArrayHandle<typeval_t> d_group_typeval(m_group_typeval, access_location::device, access_mode::read);
             ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::read);
             ArrayHandle<unsigned int> d_n_groups(m_gpu_n_groups, access_location::device, access_mode::overwrite);
+            ArrayHandle<unsigned int> d_keep(m_gpu_table_keep, access_location::device, access_mode::overwrite);
             ArrayHandle<members_t> d_gpu_table(m_gpu_table, access_location::device, access_mode::overwrite);
             ArrayHandle<unsigned int> d_gpu_pos_table(m_gpu_pos_table, access_location::device, access_mode::overwrite);
             ArrayHandle<unsigned int> d_condition(m_condition, access_location::device, access_mode::readwrite);
 
-            // allocate scratch buffers
-            CachedAllocator& alloc = m_exec_conf->getCachedAllocator();
-            unsigned int tmp_size = m_groups.size()*group_size;
-            unsigned int nptl = m_pdata->getN()+m_pdata->getNGhosts();
-            ScopedAllocation<unsigned int> d_scratch_g(alloc, tmp_size);
-            ScopedAllocation<unsigned int> d_scratch_idx(alloc, tmp_size);
-            ScopedAllocation<unsigned int> d_offsets(alloc, tmp_size);
-            ScopedAllocation<unsigned int> d_seg_offsets(alloc, nptl);
+            if (incremental)
+                {
+                ArrayHandle<unsigned int> d_table_tag(m_gpu_table_tag, access_location::device, access_mode::read);
+                ArrayHandle<unsigned int> d_n_groups_old(m_gpu_n_groups_alt, access_location::device,
+                    access_mode::read);
+                ArrayHandle<members_t> d_gpu_table_old(m_gpu_table_alt, access_location::device, access_mode::read);
+                ArrayHandle<unsigned int> d_gpu_pos_table_old(m_gpu_pos_table_alt, access_location::device,
+                    access_mode::read);
+
+                // copy the rows of the particles that are still local
+                gpu_remap_group_table<group_size, members_t>(
+                    m_gpu_table_n_local,
+                    nptl,
+                    N,
+                    d_table_tag.data,
+                    d_rtag.data,
+                    d_n_groups_old.data,
+                    d_gpu_table_old.data,
+                    d_gpu_pos_table_old.data,
+                    old_indexer.getW(),
+                    d_n_groups.data,
+                    d_keep.data,
+                    d_gpu_table.data,
+                    d_gpu_pos_table.data,
+                    m_gpu_table_indexer.getW());
+                }
 
-            // fill group table on GPU
+            // fill the remaining rows of the group table on GPU
             gpu_update_group_table<group_size, members_t>(
                 getN() + getNGhosts(),
                 nptl,
@@ -886,6 +1136,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                 d_group_typeval.data,
                 d_rtag.data,
                 d_n_groups.data,
+                incremental ? d_keep.data : NULL,
                 m_gpu_table_indexer.getH(),
                 d_condition.data,
                 m_next_flag,
@@ -893,12 +1144,8 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
                 d_gpu_table.data,
                 d_gpu_pos_table.data,
                 m_gpu_table_indexer.getW(),
-                d_scratch_g.data,
-                d_scratch_idx.data,
-                d_offsets.data,
-                d_seg_offsets.data,
                 has_type_mapping,
-                m_mgpu_context);
+                m_exec_conf->getCachedAllocator());
             }
         if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
 
@@ -920,7 +1167,7 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
         if (flag == m_next_flag)
             {
             // grow array by incrementing groups per particle
-            m_gpu_table_indexer = Index2D(m_pdata->getN()+m_pdata->getNGhosts(), m_gpu_table_indexer.getH()+1);
+            m_gpu_table_indexer = Index2D(nptl, m_gpu_table_indexer.getH()+1);
             m_gpu_table.resize(m_gpu_table_indexer.getNumElements());
             m_gpu_pos_table.resize(m_gpu_table_indexer.getNumElements());
             m_next_flag++;
@@ -929,6 +1176,15 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
             done = true;
         }
 
+    // remember the tags of the rows for the next incremental update
+    m_gpu_table_tag.resize(nptl);
+        {
+        ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_table_tag(m_gpu_table_tag, access_location::device, access_mode::overwrite);
+        cudaMemcpy(d_table_tag.data, d_tag.data, sizeof(unsigned int)*nptl, cudaMemcpyDeviceToDevice);
+        }
+    m_gpu_table_n_local = N;
+
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 #endif
@@ -938,6 +1194,50 @@ void BondedGroupData<group_size, Group, name, has_type_mapping>::rebuildGPUTable
  *
  *  Data in the snapshot is in tag order, where non-existent tags are skipped
  */
+//! Test if a snapshot contains the same bonded groups as the current data
+/*! \param snapshot Snapshot to compare to
+    \returns true if the snapshot has the same type names and groups (with the same members and types or constraint
+              values) in tag order
+
+    SystemDefinition uses this to skip the re-initialization when restoring a snapshot with unchanged topology.
+    Without a domain decomposition only; otherwise, false is returned.
+*/
+template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
+bool BondedGroupData<group_size, Group, name, has_type_mapping>::matchesSnapshot(const Snapshot& snapshot) const
+    {
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        return false;
+    #endif
+
+    if (! snapshot.validate() || snapshot.size != getNGlobal() || snapshot.type_mapping != m_type_mapping)
+        return false;
+
+    if (getNGlobal() == 0)
+        return true;
+
+    // the snapshot index equals the group tag only if the tags are contiguous
+    if (m_tag_set.size() != getNGlobal() || *m_tag_set.rbegin() != getNGlobal()-1)
+        return false;
+
+    for (unsigned int group_tag = 0; group_tag < getNGlobal(); ++group_tag)
+        {
+        unsigned int group_idx = m_group_rtag[group_tag];
+        members_t members = m_groups[group_idx];
+        for (unsigned int j = 0; j < group_size; ++j)
+            if (members.tag[j] != snapshot.groups[group_tag].tag[j])
+                return false;
+
+        typeval_t typeval = m_group_typeval[group_idx];
+        if (has_type_mapping && typeval.type != snapshot.type_id[group_tag])
+            return false;
+        if (!has_type_mapping && typeval.val != snapshot.val[group_tag])
+            return false;
+        }
+
+    return true;
+    }
+
 template<unsigned int group_size, typename Group, const char *name, bool has_type_mapping>
 std::map<unsigned int, unsigned int> BondedGroupData<group_size, Group, name, has_type_mapping>::takeSnapshot(Snapshot& snapshot) const
     {
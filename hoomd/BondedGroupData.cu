@@ -7,9 +7,7 @@
 #include "ParticleData.cuh"
 #include "BondedGroupData.cuh"
 
-#include "hoomd/extern/kernels/scan.cuh"
-#include "hoomd/extern/kernels/mergesort.cuh"
-#include "hoomd/extern/kernels/intervalmove.cuh"
+#include "hoomd/extern/cub/cub/cub.cuh"
 
 /*! \file BondedGroupData.cu
     \brief Implements the helper functions (GPU version) for updating the GPU bonded group tables
@@ -22,7 +20,9 @@ __global__ void gpu_count_groups_kernel(
     const unsigned int *d_rtag,
     unsigned int *d_scratch_idx,
     unsigned int *d_scratch_g,
+    unsigned int *d_scratch_flag,
     unsigned int *d_n_groups,
+    const unsigned int *d_keep,
     unsigned int max_n_groups,
     unsigned int *d_condition,
     unsigned int next_flag
@@ -43,13 +43,17 @@ __global__ void gpu_count_groups_kernel(
         if (pidx_i == NOT_LOCAL)
             atomicMax(d_condition, next_flag+1+group_idx);
 
+        // only rows that are not kept from the previous table receive entries
+        bool add = (pidx_i != NOT_LOCAL) && !(d_keep && d_keep[pidx_i]);
+
         // write out group_idx to temporary array
         d_scratch_g[i*n_groups+group_idx] = group_idx;
         d_scratch_idx[i*n_groups+group_idx] = pidx_i;
+        d_scratch_flag[i*n_groups+group_idx] = add;
 
         // atomically increment number of groups
         unsigned int n = 0;
-        if (pidx_i != NOT_LOCAL)
+        if (add)
            n = atomicInc(&d_n_groups[pidx_i],0xffffffff);
 
         if (n >= max_n_groups)
@@ -58,12 +62,25 @@ __global__ void gpu_count_groups_kernel(
         }
     }
 
+//! Number of new entries per particle, zero for the rows that are kept
+__global__ void gpu_count_new_entries_kernel(
+    const unsigned int N,
+    const unsigned int *d_n_groups,
+    const unsigned int *d_keep,
+    unsigned int *d_n_new)
+    {
+    unsigned int i = blockIdx.x*blockDim.x + threadIdx.x;
+    if (i >= N) return;
+
+    d_n_new[i] = d_keep[i] ? 0 : d_n_groups[i];
+    }
+
 template<unsigned int group_size, typename group_t>
 __global__ void gpu_group_scatter_kernel(
     unsigned int n_scratch,
     const unsigned int *d_scratch_g,
     const unsigned int *d_scratch_idx,
-    const unsigned int *d_offset,
+    const unsigned int *d_seg_offsets,
     const group_t *d_members,
     const typeval_union *d_group_typeval,
     const unsigned int *d_rtag,
@@ -77,8 +94,9 @@ __global__ void gpu_group_scatter_kernel(
 
     if (i >= n_scratch) return;
 
+    // the entries are sorted by particle index, so the column is the rank within the segment of the particle
     unsigned int pidx = d_scratch_idx[i];
-    unsigned int offset = d_offset[i]*pidx_group_table_pitch + pidx;
+    unsigned int offset = (i-d_seg_offsets[pidx])*pidx_group_table_pitch + pidx;
 
     // load group
     unsigned int group_idx = d_scratch_g[i];
@@ -121,6 +139,75 @@ __global__ void gpu_group_scatter_kernel(
     d_pidx_gpos_table[offset] = gpos;
     }
 
+template<unsigned int group_size, typename group_t>
+__global__ void gpu_remap_group_table_kernel(
+    const unsigned int N_old,
+    const unsigned int N,
+    const unsigned int *d_table_tag,
+    const unsigned int *d_rtag,
+    const unsigned int *d_n_groups_old,
+    const group_t *d_table_old,
+    const unsigned int *d_pos_table_old,
+    const unsigned int old_pitch,
+    unsigned int *d_n_groups,
+    unsigned int *d_keep,
+    group_t *d_table,
+    unsigned int *d_pos_table,
+    const unsigned int pitch)
+    {
+    unsigned int j = blockIdx.x*blockDim.x + threadIdx.x;
+    if (j >= N_old) return;
+
+    // new index of the particle, rows of particles that are no longer local are dropped
+    unsigned int i = d_rtag[d_table_tag[j]];
+    if (i >= N) return;
+
+    unsigned int n = d_n_groups_old[j];
+    for (unsigned int k = 0; k < n; ++k)
+        {
+        group_t p = d_table_old[k*old_pitch + j];
+
+        #pragma unroll
+        for (unsigned int m = 0; m < group_size-1; ++m)
+            {
+            unsigned int idx = d_rtag[d_table_tag[p.idx[m]]];
+
+            // a member is no longer available, rebuild the row from the groups
+            if (idx == NOT_LOCAL)
+                return;
+
+            p.idx[m] = idx;
+            }
+
+        d_table[k*pitch + i] = p;
+        d_pos_table[k*pitch + i] = d_pos_table_old[k*old_pitch + j];
+        }
+
+    d_n_groups[i] = n;
+    d_keep[i] = 1;
+    }
+
+/*! \param n_groups Number of local and ghost groups
+    \param N Number of local and ghost particles
+    \param d_group_table Group members
+    \param d_group_typeval Group types or constraint values
+    \param d_rtag Particle reverse-lookup table
+    \param d_n_groups Number of entries per particle
+    \param d_keep Flags of the rows that are kept from the previous table, or NULL to rebuild every row
+    \param max_n_groups Height of the output table
+    \param d_condition Condition variable
+    \param next_flag Value of the condition variable that signals an overflow
+    \param flag Condition variable (output)
+    \param d_pidx_group_table Table of groups by particle index
+    \param d_pidx_gpos_table Position of the particle in the groups of the table
+    \param pidx_group_table_pitch Pitch of the table
+    \param has_type_mapping True if the table stores group types rather than group indices
+    \param alloc Allocator for temporary buffers
+
+    Only the entries of rows that are not kept are written. The entries are sorted by particle index with a stable
+    radix sort, so the order of the groups in every row is the order of the group table and does not depend on the
+    scheduling of the counting kernel.
+*/
 template<unsigned int group_size, typename group_t>
 void gpu_update_group_table(
     const unsigned int n_groups,
@@ -129,6 +216,7 @@ void gpu_update_group_table(
     const typeval_union *d_group_typeval,
     const unsigned int *d_rtag,
     unsigned int *d_n_groups,
+    const unsigned int *d_keep,
     unsigned int max_n_groups,
     unsigned int *d_condition,
     unsigned int next_flag,
@@ -136,20 +224,22 @@ void gpu_update_group_table(
     group_t *d_pidx_group_table,
     unsigned int *d_pidx_gpos_table,
     const unsigned int pidx_group_table_pitch,
-    unsigned int *d_scratch_g,
-    unsigned int *d_scratch_idx,
-    unsigned int *d_offsets,
-    unsigned int *d_seg_offsets,
     bool has_type_mapping,
-    mgpu::ContextPtr mgpu_context
+    CachedAllocator& alloc
     )
     {
+    unsigned int n_scratch = group_size*n_groups;
+    unsigned int *d_scratch_g = alloc.getTemporaryBuffer<unsigned int>(n_scratch);
+    unsigned int *d_scratch_idx = alloc.getTemporaryBuffer<unsigned int>(n_scratch);
+    unsigned int *d_scratch_flag = alloc.getTemporaryBuffer<unsigned int>(n_scratch);
+
     // construct scratch table by expanding the group table by particle index
     unsigned int block_size = 512;
     unsigned n_blocks = n_groups / block_size + 1;
 
-    // reset number of groups
-    cudaMemsetAsync(d_n_groups, 0, sizeof(unsigned int)*N);
+    // reset number of groups of the rows that are rebuilt
+    if (! d_keep)
+        cudaMemsetAsync(d_n_groups, 0, sizeof(unsigned int)*N);
 
     gpu_count_groups_kernel<group_size><<<n_blocks, block_size>>>(
         n_groups,
@@ -157,7 +247,9 @@ void gpu_update_group_table(
         d_rtag,
         d_scratch_idx,
         d_scratch_g,
+        d_scratch_flag,
         d_n_groups,
+        d_keep,
         max_n_groups,
         d_condition,
         next_flag);
@@ -169,29 +261,81 @@ void gpu_update_group_table(
     if (! (flag >= next_flag) && n_groups)
         {
         // we are good, fill group table
+        unsigned int *d_sorted_g = alloc.getTemporaryBuffer<unsigned int>(n_scratch);
+        unsigned int *d_sorted_idx = alloc.getTemporaryBuffer<unsigned int>(n_scratch);
+        unsigned int *d_seg_offsets = alloc.getTemporaryBuffer<unsigned int>(N);
+
+        unsigned int n_entries = n_scratch;
+        const unsigned int *d_n_entries = d_n_groups;
+        unsigned int *d_n_new = NULL;
+        if (d_keep)
+            {
+            // compact the entries of the rows that are rebuilt, preserving their order
+            unsigned int *d_sel_g = alloc.getTemporaryBuffer<unsigned int>(n_scratch);
+            unsigned int *d_sel_idx = alloc.getTemporaryBuffer<unsigned int>(n_scratch);
+            unsigned int *d_num_selected = alloc.getTemporaryBuffer<unsigned int>(1);
+
+            void *d_temp_storage = NULL;
+            size_t temp_storage_bytes = 0;
+            cub::DeviceSelect::Flagged(d_temp_storage, temp_storage_bytes, d_scratch_idx, d_scratch_flag, d_sel_idx,
+                d_num_selected, n_scratch);
+            d_temp_storage = alloc.allocate(temp_storage_bytes);
+            cub::DeviceSelect::Flagged(d_temp_storage, temp_storage_bytes, d_scratch_idx, d_scratch_flag, d_sel_idx,
+                d_num_selected, n_scratch);
+            cub::DeviceSelect::Flagged(d_temp_storage, temp_storage_bytes, d_scratch_g, d_scratch_flag, d_sel_g,
+                d_num_selected, n_scratch);
+            alloc.deallocate((char *) d_temp_storage);
+
+            cudaMemcpy(&n_entries, d_num_selected, sizeof(unsigned int), cudaMemcpyDeviceToHost);
+            alloc.deallocate((char *) d_num_selected);
+
+            // the compacted entries replace the scratch entries
+            cudaMemcpyAsync(d_scratch_g, d_sel_g, sizeof(unsigned int)*n_entries, cudaMemcpyDeviceToDevice);
+            cudaMemcpyAsync(d_scratch_idx, d_sel_idx, sizeof(unsigned int)*n_entries, cudaMemcpyDeviceToDevice);
+            alloc.deallocate((char *) d_sel_idx);
+            alloc.deallocate((char *) d_sel_g);
+
+            // segments of the kept rows are empty
+            d_n_new = alloc.getTemporaryBuffer<unsigned int>(N);
+            gpu_count_new_entries_kernel<<<N/block_size + 1, block_size>>>(N, d_n_groups, d_keep, d_n_new);
+            d_n_entries = d_n_new;
+            }
 
-        // sort groups by particle index
-        mgpu::MergesortPairs(d_scratch_idx, d_scratch_g, group_size*n_groups, *mgpu_context);
-
-        mgpu::Scan<mgpu::MgpuScanTypeExc>(d_n_groups, N, (unsigned int) 0, mgpu::plus<unsigned int>(),
-            (unsigned int *) NULL, (unsigned int *)NULL, d_seg_offsets,*mgpu_context);
+        // the particle indices are smaller than N, so only the low bits need to be sorted
+        int end_bit = 1;
+        while (end_bit < 32 && (N >> end_bit))
+            end_bit++;
 
-        // use IntervalMove to perform a segmented scan of d_scratch_idx,
-        // using segment offsets as input
-        mgpu::constant_iterator<unsigned int> const_it(0);
-        mgpu::counting_iterator<unsigned int> count_it(0);
-        mgpu::IntervalMove(group_size*n_groups, const_it, d_seg_offsets, d_seg_offsets, N,
-            count_it, d_offsets, *mgpu_context);
+        // sort groups by particle index
+        void *d_temp_storage = NULL;
+        size_t temp_storage_bytes = 0;
+        cub::DeviceRadixSort::SortPairs(d_temp_storage, temp_storage_bytes, d_scratch_idx, d_sorted_idx,
+            d_scratch_g, d_sorted_g, n_entries, 0, end_bit);
+        d_temp_storage = alloc.allocate(temp_storage_bytes);
+        cub::DeviceRadixSort::SortPairs(d_temp_storage, temp_storage_bytes, d_scratch_idx, d_sorted_idx,
+            d_scratch_g, d_sorted_g, n_entries, 0, end_bit);
+        alloc.deallocate((char *) d_temp_storage);
+
+        // offsets of the segments of every particle in the sorted entries
+        d_temp_storage = NULL;
+        temp_storage_bytes = 0;
+        cub::DeviceScan::ExclusiveSum(d_temp_storage, temp_storage_bytes, d_n_entries, d_seg_offsets, N);
+        d_temp_storage = alloc.allocate(temp_storage_bytes);
+        cub::DeviceScan::ExclusiveSum(d_temp_storage, temp_storage_bytes, d_n_entries, d_seg_offsets, N);
+        alloc.deallocate((char *) d_temp_storage);
+
+        if (d_n_new)
+            alloc.deallocate((char *) d_n_new);
 
         // scatter groups to destinations
         block_size = 512;
-        n_blocks = group_size*n_groups/block_size + 1;
+        n_blocks = n_entries/block_size + 1;
 
         gpu_group_scatter_kernel<group_size><<<n_blocks, block_size>>>(
-            n_groups*group_size,
-            d_scratch_g,
-            d_scratch_idx,
-            d_offsets,
+            n_entries,
+            d_sorted_g,
+            d_sorted_idx,
+            d_seg_offsets,
             d_group_table,
             d_group_typeval,
             d_rtag,
@@ -199,7 +343,72 @@ void gpu_update_group_table(
             d_pidx_gpos_table,
             pidx_group_table_pitch,
             has_type_mapping);
+
+        alloc.deallocate((char *) d_seg_offsets);
+        alloc.deallocate((char *) d_sorted_idx);
+        alloc.deallocate((char *) d_sorted_g);
         }
+
+    alloc.deallocate((char *) d_scratch_flag);
+    alloc.deallocate((char *) d_scratch_idx);
+    alloc.deallocate((char *) d_scratch_g);
+    }
+
+/*! \param N_old Number of local particles when the previous table was built
+    \param N Number of local and ghost particles
+    \param N_local Number of local particles
+    \param d_table_tag Particle tags of the rows of the previous table
+    \param d_rtag Particle reverse-lookup table
+    \param d_n_groups_old Number of entries per particle in the previous table
+    \param d_table_old Previous table
+    \param d_pos_table_old Previous positions in group
+    \param old_pitch Pitch of the previous table
+    \param d_n_groups Number of entries per particle (output)
+    \param d_keep Flags of the rows that were copied (output)
+    \param d_table Table (output)
+    \param d_pos_table Positions in group (output)
+    \param pitch Pitch of the table
+
+    The rows of particles that were local and still are are copied to the new particle index, with the member indices
+    mapped through the tags. Ghost rows and the rows of particles that arrived are left to gpu_update_group_table().
+*/
+template<unsigned int group_size, typename group_t>
+void gpu_remap_group_table(
+    const unsigned int N_old,
+    const unsigned int N,
+    const unsigned int N_local,
+    const unsigned int *d_table_tag,
+    const unsigned int *d_rtag,
+    const unsigned int *d_n_groups_old,
+    const group_t *d_table_old,
+    const unsigned int *d_pos_table_old,
+    const unsigned int old_pitch,
+    unsigned int *d_n_groups,
+    unsigned int *d_keep,
+    group_t *d_table,
+    unsigned int *d_pos_table,
+    const unsigned int pitch)
+    {
+    cudaMemsetAsync(d_n_groups, 0, sizeof(unsigned int)*N);
+    cudaMemsetAsync(d_keep, 0, sizeof(unsigned int)*N);
+
+    unsigned int block_size = 256;
+    unsigned int n_blocks = N_old/block_size + 1;
+
+    gpu_remap_group_table_kernel<group_size><<<n_blocks, block_size>>>(
+        N_old,
+        N_local,
+        d_table_tag,
+        d_rtag,
+        d_n_groups_old,
+        d_table_old,
+        d_pos_table_old,
+        old_pitch,
+        d_n_groups,
+        d_keep,
+        d_table,
+        d_pos_table,
+        pitch);
     }
 
 /*
@@ -214,6 +423,7 @@ template void gpu_update_group_table<2>(
     const typeval_union *d_group_typeval,
     const unsigned int *d_rtag,
     unsigned int *d_n_groups,
+    const unsigned int *d_keep,
     unsigned int max_n_groups,
     unsigned int *d_condition,
     unsigned int next_flag,
@@ -221,14 +431,26 @@ template void gpu_update_group_table<2>(
     group_storage<2> *d_pidx_group_table,
     unsigned int *d_pidx_gpos_table,
     const unsigned int pidx_group_table_pitch,
-    unsigned int *d_scratch_g,
-    unsigned int *d_scratch_idx,
-    unsigned int *d_offsets,
-    unsigned int *d_seg_offsets,
     bool has_type_mapping,
-    mgpu::ContextPtr mgpu_context
+    CachedAllocator& alloc
     );
 
+template void gpu_remap_group_table<2>(
+    const unsigned int N_old,
+    const unsigned int N,
+    const unsigned int N_local,
+    const unsigned int *d_table_tag,
+    const unsigned int *d_rtag,
+    const unsigned int *d_n_groups_old,
+    const group_storage<2> *d_table_old,
+    const unsigned int *d_pos_table_old,
+    const unsigned int old_pitch,
+    unsigned int *d_n_groups,
+    unsigned int *d_keep,
+    group_storage<2> *d_table,
+    unsigned int *d_pos_table,
+    const unsigned int pitch);
+
 //! AngleData
 template void gpu_update_group_table<3>(
     const unsigned int n_groups,
@@ -237,6 +459,7 @@ template void gpu_update_group_table<3>(
     const typeval_union *d_group_typeval,
     const unsigned int *d_rtag,
     unsigned int *d_n_groups,
+    const unsigned int *d_keep,
     unsigned int max_n_groups,
     unsigned int *d_condition,
     unsigned int next_flag,
@@ -244,14 +467,26 @@ template void gpu_update_group_table<3>(
     group_storage<3> *d_pidx_group_table,
     unsigned int *d_pidx_gpos_table,
     const unsigned int pidx_group_table_pitch,
-    unsigned int *d_scratch_g,
-    unsigned int *d_scratch_idx,
-    unsigned int *d_offsets,
-    unsigned int *d_seg_offsets,
     bool has_type_mapping,
-    mgpu::ContextPtr mgpu_context
+    CachedAllocator& alloc
     );
 
+template void gpu_remap_group_table<3>(
+    const unsigned int N_old,
+    const unsigned int N,
+    const unsigned int N_local,
+    const unsigned int *d_table_tag,
+    const unsigned int *d_rtag,
+    const unsigned int *d_n_groups_old,
+    const group_storage<3> *d_table_old,
+    const unsigned int *d_pos_table_old,
+    const unsigned int old_pitch,
+    unsigned int *d_n_groups,
+    unsigned int *d_keep,
+    group_storage<3> *d_table,
+    unsigned int *d_pos_table,
+    const unsigned int pitch);
+
 //! DihedralData and ImproperData
 template void gpu_update_group_table<4>(
     const unsigned int n_groups,
@@ -260,6 +495,7 @@ template void gpu_update_group_table<4>(
     const typeval_union *d_group_typeval,
     const unsigned int *d_rtag,
     unsigned int *d_n_groups,
+    const unsigned int *d_keep,
     unsigned int max_n_groups,
     unsigned int *d_condition,
     unsigned int next_flag,
@@ -267,10 +503,22 @@ template void gpu_update_group_table<4>(
     group_storage<4> *d_pidx_group_table,
     unsigned int *d_pidx_gpos_table,
     const unsigned int pidx_group_table_pitch,
-    unsigned int *d_scratch_g,
-    unsigned int *d_scratch_idx,
-    unsigned int *d_offsets,
-    unsigned int *d_seg_offsets,
     bool has_type_mapping,
-    mgpu::ContextPtr mgpu_context
+    CachedAllocator& alloc
     );
+
+template void gpu_remap_group_table<4>(
+    const unsigned int N_old,
+    const unsigned int N,
+    const unsigned int N_local,
+    const unsigned int *d_table_tag,
+    const unsigned int *d_rtag,
+    const unsigned int *d_n_groups_old,
+    const group_storage<4> *d_table_old,
+    const unsigned int *d_pos_table_old,
+    const unsigned int old_pitch,
+    unsigned int *d_n_groups,
+    unsigned int *d_keep,
+    group_storage<4> *d_table,
+    unsigned int *d_pos_table,
+    const unsigned int pitch);
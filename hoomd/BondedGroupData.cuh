@@ -8,9 +8,8 @@
     \brief Defines the helper functions (GPU version) for updating the GPU bonded group tables
  */
 
-#include "hoomd/extern/util/mgpucontext.h"
-
 #include "HOOMDMath.h"
+#include "CachedAllocator.h"
 
 #ifndef __BONDED_GROUP_DATA_CUH__
 #define __BONDED_GROUP_DATA_CUH__
@@ -57,6 +56,7 @@ struct packed_storage;
 union typeval_union;
 #endif
 
+//! Build the lookup table of groups by particle index, or the rows of it that are not kept
 template<unsigned int group_size, typename group_t>
 void gpu_update_group_table(
     const unsigned int n_groups,
@@ -65,6 +65,7 @@ void gpu_update_group_table(
     const typeval_union *d_group_typeval,
     const unsigned int *d_rtag,
     unsigned int *d_n_groups,
+    const unsigned int *d_keep,
     unsigned int max_n_groups,
     unsigned int *d_condition,
     unsigned int next_flag,
@@ -72,11 +73,25 @@ void gpu_update_group_table(
     group_t *d_pidx_group_table,
     unsigned int *d_pidx_gpos_table,
     const unsigned int pidx_group_table_pitch,
-    unsigned int *d_scratch_g,
-    unsigned int *d_scratch_idx,
-    unsigned int *d_offsets,
-    unsigned int *d_seg_offsets,
     bool has_type_mapping,
-    mgpu::ContextPtr mgpu_context
+    CachedAllocator& alloc
     );
+
+//! Copy the rows of the previous lookup table to the current particle indices
+template<unsigned int group_size, typename group_t>
+void gpu_remap_group_table(
+    const unsigned int N_old,
+    const unsigned int N,
+    const unsigned int N_local,
+    const unsigned int *d_table_tag,
+    const unsigned int *d_rtag,
+    const unsigned int *d_n_groups_old,
+    const group_t *d_table_old,
+    const unsigned int *d_pos_table_old,
+    const unsigned int old_pitch,
+    unsigned int *d_n_groups,
+    unsigned int *d_keep,
+    group_t *d_table,
+    unsigned int *d_pos_table,
+    const unsigned int pitch);
 #endif // __BONDED_GROUP_DATA_CUH__
@@ -249,6 +249,9 @@ class BondedGroupData
         //! Take a snapshot
         virtual std::map<unsigned int, unsigned int> takeSnapshot(Snapshot& snapshot) const;
 
+        //! Test if a snapshot contains the same bonded groups as the current data
+        bool matchesSnapshot(const Snapshot& snapshot) const;
+
         //! Get local number of bonded groups
         unsigned int getN() const
             {
@@ -503,27 +506,19 @@ class BondedGroupData
          */
 
         //! Return GPU bonded groups list
-        const GPUVector<members_t>& getGPUTable()
+        const GlobalVector<members_t>& getGPUTable()
             {
             // rebuild lookup table if necessary
-            if (m_groups_dirty)
-                {
-                rebuildGPUTable();
-                m_groups_dirty = false;
-                }
+            checkGPUTable();
 
             return m_gpu_table;
             }
 
         //! Return GPU list of particle in group position
-        const GPUArray<unsigned >& getGPUPosTable()
+        const GlobalVector<unsigned int>& getGPUPosTable()
             {
             // rebuild lookup table if necessary
-            if (m_groups_dirty)
-                {
-                rebuildGPUTable();
-                m_groups_dirty = false;
-                }
+            checkGPUTable();
 
             return m_gpu_pos_table;
             }
@@ -532,21 +527,49 @@ class BondedGroupData
         const Index2D& getGPUTableIndexer()
             {
             // rebuild lookup table if necessary
-            if (m_groups_dirty)
-                {
-                rebuildGPUTable();
-                m_groups_dirty = false;
-                }
+            checkGPUTable();
 
             return m_gpu_table_indexer;
             }
 
         //! Return list of number of groups per particle
-        const GPUArray<unsigned int>& getNGroupsArray() const
+        const GlobalVector<unsigned int>& getNGroupsArray() const
             {
             return m_gpu_n_groups;
             }
 
+        //! Return the group-centric table of local member indices
+        /*! Every group with at least one local member appears once, with the local indices of all members in
+            group order. The groups are ordered by their smallest member index, so that consecutive groups reference
+            nearby particles after the particles are sorted along a space-filling curve.
+        */
+        const GPUVector<members_t>& getGPUGroupList()
+            {
+            // rebuild the list if necessary
+            if (m_group_list_dirty)
+                {
+                rebuildGPUGroupList();
+                m_group_list_dirty = false;
+                }
+
+            return m_gpu_group_list;
+            }
+
+        //! Return the types of the groups in the group-centric table
+        /*! For group data without a type mapping, the local group index is stored instead.
+        */
+        const GPUVector<unsigned int>& getGPUGroupListTypes()
+            {
+            // rebuild the list if necessary
+            if (m_group_list_dirty)
+                {
+                rebuildGPUGroupList();
+                m_group_list_dirty = false;
+                }
+
+            return m_gpu_group_list_type;
+            }
+
         /*
          * add/remove groups globally
          */
@@ -587,6 +610,24 @@ class BondedGroupData
             {
             // set flag to trigger rebuild of GPU table
             m_groups_dirty = true;
+            m_group_list_dirty = true;
+
+            // notify subscribers
+            m_group_reorder_signal.emit();
+            }
+
+        //! Notify subscribers that groups have been reordered by a ghost exchange
+        /*! The groups of the local particles are the same before and after a ghost exchange, so the lookup table is
+            updated incrementally if its entries store group types. The entries of groups without a type mapping store
+            the group index, which changes with the order of the groups.
+         */
+        void notifyGroupExchange()
+            {
+            if (has_type_mapping)
+                m_particles_reordered = true;
+            else
+                m_groups_dirty = true;
+            m_group_list_dirty = true;
 
             // notify subscribers
             m_group_reorder_signal.emit();
@@ -596,6 +637,7 @@ class BondedGroupData
         void setDirty()
             {
             m_groups_dirty = true;
+            m_group_list_dirty = true;
             }
 
     protected:
@@ -615,10 +657,16 @@ class BondedGroupData
         GPUVector<typeval_t> m_group_typeval;        //!< List of group types/constraint values
         GPUVector<unsigned int> m_group_tag;         //!< List of group tags
         GPUVector<unsigned int> m_group_rtag;        //!< Global reverse-lookup table for group tags
-        GPUVector<members_t> m_gpu_table;            //!< Storage for groups by particle index for access on the GPU
-        GPUVector<unsigned int> m_gpu_pos_table;     //!< Position of particle idx in group table
+        GlobalVector<members_t> m_gpu_table;         //!< Storage for groups by particle index for access on the GPU
+        GlobalVector<unsigned int> m_gpu_pos_table;  //!< Position of particle idx in group table
         Index2D m_gpu_table_indexer;                 //!< Indexer for GPU table
-        GPUVector<unsigned int> m_gpu_n_groups;      //!< Number of entries in lookup table per particle
+        GlobalVector<unsigned int> m_gpu_n_groups;   //!< Number of entries in lookup table per particle
+        GlobalVector<members_t> m_gpu_table_alt;     //!< Previous lookup table (swap-in)
+        GlobalVector<unsigned int> m_gpu_pos_table_alt; //!< Previous position in group table (swap-in)
+        GlobalVector<unsigned int> m_gpu_n_groups_alt; //!< Previous number of entries per particle (swap-in)
+        GlobalVector<unsigned int> m_gpu_table_tag;  //!< Particle tags of the rows of the lookup table
+        GPUVector<members_t> m_gpu_group_list;       //!< Local member indices of the groups, one entry per group
+        GPUVector<unsigned int> m_gpu_group_list_type; //!< Types of the groups in the group-centric table
         std::vector<std::string> m_type_mapping;     //!< Mapping of types of bonded groups
 
         unsigned int m_n_groups;                     //!< Number of local groups
@@ -645,6 +693,9 @@ class BondedGroupData
 
     private:
         bool m_groups_dirty;                         //!< Is it necessary to rebuild the lookup-by-index table?
+        bool m_group_list_dirty;                     //!< Is it necessary to rebuild the group-centric table?
+        bool m_particles_reordered;                  //!< Is it necessary to remap the lookup table to new particle indices?
+        unsigned int m_gpu_table_n_local;            //!< Number of local particles when the lookup table was updated
 
         Nano::Signal<void ()> m_group_num_change_signal; //!< Signal that is triggered when groups are added or deleted (globally)
         Nano::Signal<void ()> m_group_reorder_signal;    //!< Signal that is triggered when groups are added or deleted locally
@@ -655,8 +706,39 @@ class BondedGroupData
         //! Helper function to rebuild the active tag cache if necessary
         void maybe_rebuild_tag_cache();
 
-        //! Helper function to rebuild lookup by index table
-        void rebuildGPUTable();
+        //! Helper function to update the lookup by index table
+        void updateGPUTable(bool incremental);
+
+        //! Update the lookup by index table if necessary
+        void checkGPUTable()
+            {
+            if (m_groups_dirty)
+                {
+                updateGPUTable(false);
+                m_groups_dirty = false;
+                m_particles_reordered = false;
+                }
+            else if (m_particles_reordered)
+                {
+                updateGPUTable(true);
+                m_particles_reordered = false;
+                }
+            }
+
+        //! Remap the lookup table after the particles have been sorted
+        void slotParticleSort()
+            {
+            m_particles_reordered = true;
+            m_group_list_dirty = true;
+            }
+
+        #ifdef ENABLE_CUDA
+        //! Set the preferred location of the lookup table rows to the GPU that owns the particle
+        void adviseGPUTable();
+        #endif
+
+        //! Helper function to rebuild the group-centric table
+        void rebuildGPUGroupList();
 
         //! Resize internal tables
         /*! \param new_size New size of local group tables, new_size = n_local + n_ghost
@@ -675,12 +757,12 @@ class BondedGroupData
             }
 
         #ifdef ENABLE_CUDA
-        //! Helper function to rebuild lookup by index table on the GPU
-        void rebuildGPUTableGPU();
+        //! Helper function to update lookup by index table on the GPU
+        void updateGPUTableGPU(bool incremental);
 
         GPUArray<unsigned int> m_condition;          //!< Condition variable for rebuilding GPU table on the GPU
         unsigned int m_next_flag;                    //!< Next flag value for GPU table rebuild
-        mgpu::ContextPtr m_mgpu_context;                   //!< moderngpu context
+        GlobalVector<unsigned int> m_gpu_table_keep; //!< Flags of the rows kept by an incremental update
         #endif
     };
 
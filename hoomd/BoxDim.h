@@ -229,6 +229,35 @@ struct __attribute__((visibility("default"))) BoxDim
             return m_yz;
             }
 
+        //! Get the box of the same periodic lattice with the tilt factors closest to the given ones
+        /*! \param xy Target xy tilt factor
+            \param xz Target xz tilt factor
+            \param yz Target yz tilt factor
+
+            Integer multiples of a2 are added to a3 and integer multiples of a1 are added to a2 and a3, along periodic
+            directions only. Both boxes describe the same periodic system. This is the sliding brick (Lees-Edwards)
+            picture of a sheared box: getLatticeEquivalent(0,0,0) returns the reduced box with |xy Ly| <= Lx/2,
+            |xz Lz| <= Lx/2 and |yz Lz| <= Ly/2.
+         */
+        HOSTDEVICE BoxDim getLatticeEquivalent(Scalar xy, Scalar xz, Scalar yz) const
+            {
+            BoxDim box(*this);
+            if (m_periodic.y)
+                {
+                // a3 -> a3 + m a2
+                Scalar m = rint((yz - m_yz)*m_L.z/m_L.y);
+                box.m_yz += m*m_L.y/m_L.z;
+                box.m_xz += m*m_xy*m_L.y/m_L.z;
+                }
+            if (m_periodic.x)
+                {
+                // a3 -> a3 + k a1, a2 -> a2 + j a1
+                box.m_xz += rint((xz - box.m_xz)*m_L.z/m_L.x)*m_L.x/m_L.z;
+                box.m_xy += rint((xy - m_xy)*m_L.y/m_L.x)*m_L.x/m_L.y;
+                }
+            return box;
+            }
+
         //! Compute fractional coordinates, allowing for a ghost layer
         /*! \param v Vector to scale
             \param ghost_width Width of extra ghost padding layer to take into account (along reciprocal lattice directions)
@@ -10,6 +10,10 @@
 
 #include "BoxResizeUpdater.h"
 
+#ifdef ENABLE_MPI
+#include "Communicator.h"
+#endif
+
 #include <math.h>
 #include <iostream>
 #include <stdexcept>
@@ -31,7 +35,8 @@ BoxResizeUpdater::BoxResizeUpdater(std::shared_ptr<SystemDefinition> sysdef,
                                    std::shared_ptr<Variant> xy,
                                    std::shared_ptr<Variant> xz,
                                    std::shared_ptr<Variant> yz)
-    : Updater(sysdef), m_Lx(Lx), m_Ly(Ly), m_Lz(Lz), m_xy(xy), m_xz(xz), m_yz(yz), m_scale_particles(true)
+    : Updater(sysdef), m_Lx(Lx), m_Ly(Ly), m_Lz(Lz), m_xy(xy), m_xz(xz), m_yz(yz), m_scale_particles(true),
+      m_lees_edwards(false)
     {
     assert(m_pdata);
     assert(m_Lx);
@@ -48,10 +53,12 @@ BoxResizeUpdater::~BoxResizeUpdater()
 
 /*! \param scale_particles Set to true to scale particles with the box. Set to false to leave particle positions alone
     when scaling the box.
+    \param lees_edwards Set to true to reduce the tilt factors of the box to the lattice-equivalent ones closest to zero
 */
-void BoxResizeUpdater::setParams(bool scale_particles)
+void BoxResizeUpdater::setParams(bool scale_particles, bool lees_edwards)
     {
     m_scale_particles = scale_particles;
+    m_lees_edwards = lees_edwards;
     }
 
 /*! Perform the needed calculations to scale the box size
@@ -72,6 +79,12 @@ void BoxResizeUpdater::update(unsigned int timestep)
 
     // check if the current box size is the same
     BoxDim curBox = m_pdata->getGlobalBox();
+
+    // with Lees-Edwards boundary conditions the current box is reduced, compare with its equivalent closest to the
+    // target so that the particles follow the small deformation of this step
+    if (m_lees_edwards)
+        curBox = curBox.getLatticeEquivalent(xy, xz, yz);
+
     Scalar3 curL = curBox.getL();
     Scalar curxy = curBox.getTiltFactorXY();
     Scalar curxz = curBox.getTiltFactorXZ();
@@ -92,8 +105,17 @@ void BoxResizeUpdater::update(unsigned int timestep)
     // only change the box if there is a change in the box dimensions
     if (!no_change)
         {
+        BoxDim reducedBox = newBox;
+        bool flip = false;
+        if (m_lees_edwards)
+            {
+            reducedBox = newBox.getLatticeEquivalent(0, 0, 0);
+            flip = reducedBox.getTiltFactorXY() != xy || reducedBox.getTiltFactorXZ() != xz ||
+                   reducedBox.getTiltFactorYZ() != yz;
+            }
+
         // set the new box
-        m_pdata->setGlobalBox(newBox);
+        m_pdata->setGlobalBox(reducedBox);
 
         // scale the particle positions (if we have been asked to)
         if (m_scale_particles)
@@ -115,7 +137,7 @@ void BoxResizeUpdater::update(unsigned int timestep)
                 h_pos.data[i].z = scaled_pos.z;
                 }
             }
-        else
+        else if (!flip)
             {
             // otherwise, we need to ensure that the particles are still in the (local) box
             // move the particles to be inside the new box
@@ -131,6 +153,32 @@ void BoxResizeUpdater::update(unsigned int timestep)
                 }
             }
 
+        if (flip)
+            {
+            // a2 -> a2 + j a1, a3 -> a3 + m a2 + k a1
+            const Scalar3 L = newBox.getL();
+            int j = int(rint((reducedBox.getTiltFactorXY() - xy)*L.y/L.x));
+            int m = int(rint((reducedBox.getTiltFactorYZ() - yz)*L.z/L.y));
+            int k = int(rint((reducedBox.getTiltFactorXZ() - xz - m*xy*L.y/L.z)*L.z/L.x));
+
+            // express the images in the new lattice vectors and wrap the particles into the reduced box
+            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+            ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+
+            for (unsigned int i = 0; i < m_pdata->getN(); i++)
+                {
+                int3 img = h_image.data[i];
+                h_image.data[i].x = img.x - j*img.y + (m*j - k)*img.z;
+                h_image.data[i].y = img.y - m*img.z;
+                reducedBox.wrap(h_pos.data[i], h_image.data[i]);
+                }
+
+            #ifdef ENABLE_MPI
+            // particles may have changed their domain along x
+            if (m_comm)
+                m_comm->forceMigrate();
+            #endif
+            }
         }
 
     if (m_prof) m_prof->pop();
@@ -25,6 +25,11 @@
 /*! This simple updater gets the box lengths from specified variants and sets those box sizes
     over time. As an option, particles can be rescaled with the box lengths or left where they are.
 
+    With Lees-Edwards boundary conditions, the box is always set to the lattice-equivalent box with the smallest tilt
+    factors (BoxDim::getLatticeEquivalent). The tilt factor variants may then grow without bound to apply a steady
+    shear. The box is deformed by the small change of every update, when the reduced tilt flips the particles are
+    wrapped into the new box and their images are transformed so that unwrapped positions are continuous.
+
     \ingroup updaters
 */
 class PYBIND11_EXPORT BoxResizeUpdater : public Updater
@@ -43,7 +48,7 @@ class PYBIND11_EXPORT BoxResizeUpdater : public Updater
         virtual ~BoxResizeUpdater();
 
         //! Sets parameter flags
-        void setParams(bool scale_particles);
+        void setParams(bool scale_particles, bool lees_edwards);
 
         //! Take one timestep forward
         virtual void update(unsigned int timestep);
@@ -56,6 +61,7 @@ class PYBIND11_EXPORT BoxResizeUpdater : public Updater
         std::shared_ptr<Variant> m_xz;    //!< Box xz tilt factor vs time
         std::shared_ptr<Variant> m_yz;    //!< Box yz tilt factor vs time
         bool m_scale_particles;                //!< Set to true if particle positions are to be scaled as well
+        bool m_lees_edwards;                   //!< Set to true to keep the tilt factors reduced (sliding brick)
     };
 
 //! Export the BoxResizeUpdater to python
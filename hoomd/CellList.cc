@@ -13,6 +13,10 @@
 
 #include <algorithm>
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 using namespace std;
 namespace py = pybind11;
 
@@ -24,6 +28,8 @@ CellList::CellList(std::shared_ptr<SystemDefinition> sysdef)
       m_compute_orientation(false), m_compute_idx(false), m_flag_charge(false), m_flag_type(false), m_sort_cell_list(false),
       m_compute_adj_list(true)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "CellList");
+
     m_exec_conf->msg->notice(5) << "Constructing CellList" << endl;
 
     // allocation is deferred until the first compute() call - initialize values to dummy variables
@@ -57,6 +63,36 @@ CellList::~CellList()
     m_pdata->getBoxChangeSignal().disconnect<CellList, &CellList::slotBoxChanged>(this);
     }
 
+/*! \param type_filter Flag for each particle type, nonzero if the particles of the type are binned
+
+    Particles of the types with a zero flag are left out of the cell list. An empty \a type_filter bins all
+    particles. The filter must have one entry per particle type and is not resized when types are added.
+*/
+void CellList::setTypeFilter(const std::vector<unsigned int>& type_filter)
+    {
+    if (type_filter.size() == 0)
+        {
+        GlobalArray<unsigned int> empty;
+        m_type_filter.swap(empty);
+        }
+    else
+        {
+        if (type_filter.size() != m_pdata->getNTypes())
+            {
+            m_exec_conf->msg->error() << "CellList: type filter must have one entry per particle type" << endl;
+            throw runtime_error("Error setting cell list type filter");
+            }
+
+        GlobalArray<unsigned int> filter(type_filter.size(), m_exec_conf);
+        m_type_filter.swap(filter);
+
+        ArrayHandle<unsigned int> h_type_filter(m_type_filter, access_location::host, access_mode::overwrite);
+        std::copy(type_filter.begin(), type_filter.end(), h_type_filter.data);
+        }
+
+    m_params_changed = true;
+    }
+
 //! Round down to the nearest multiple
 /*! \param v Value to round
     \param m Multiple
@@ -137,6 +173,8 @@ uint3 CellList::computeDimensions()
 
 void CellList::compute(unsigned int timestep)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "CellList");
+
     bool force = false;
 
     if (m_prof)
@@ -456,6 +494,14 @@ void CellList::initializeCellAdj()
 
 void CellList::computeCellList()
     {
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1)
+        {
+        computeCellListParallel();
+        return;
+        }
+    #endif
+
     if (m_prof)
         m_prof->push("compute");
 
@@ -473,6 +519,8 @@ void CellList::computeCellList()
     ArrayHandle<Scalar4> h_cell_orientation(m_orientation, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_cell_idx(m_idx, access_location::host, access_mode::overwrite);
     ArrayHandle<Scalar4> h_tdb(m_tdb, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_type_filter(m_type_filter, access_location::host, access_mode::read);
+    const unsigned int *type_filter = h_type_filter.data;
     uint3 conditions = make_uint3(0,0,0);
 
     // shorthand copies of the indexers
@@ -499,6 +547,10 @@ void CellList::computeCellList()
             continue;
             }
 
+        // skip the types that are not binned
+        if (type_filter && !type_filter[__scalar_as_int(h_pos.data[n].w)])
+            continue;
+
 
         // find the bin each particle belongs in
         Scalar3 f = box.makeFraction(p,ghost_width);
@@ -598,6 +650,209 @@ void CellList::computeCellList()
         m_prof->pop();
     }
 
+#ifdef ENABLE_TBB
+void CellList::computeCellListParallel()
+    {
+    if (m_prof)
+        m_prof->push("compute");
+
+    // acquire the particle data
+    ArrayHandle< Scalar4 > h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle< Scalar4 > h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle< Scalar > h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+    ArrayHandle< unsigned int > h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle< Scalar > h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    const BoxDim& box = m_pdata->getBox();
+
+    // access the cell list data arrays
+    ArrayHandle<unsigned int> h_cell_size(m_cell_size, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_xyzf(m_xyzf, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_cell_orientation(m_orientation, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cell_idx(m_idx, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_tdb(m_tdb, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_type_filter(m_type_filter, access_location::host, access_mode::read);
+    const unsigned int *type_filter = h_type_filter.data;
+
+    // shorthand copies of the indexers
+    const Index3D ci = m_cell_indexer;
+    const Index2D cli = m_cell_list_indexer;
+    const unsigned int n_cells = ci.getNumElements();
+    const unsigned int N = m_pdata->getN();
+
+    Scalar3 ghost_width = getGhostWidth();
+
+    // get periodic flags
+    uchar3 periodic = box.getPeriodic();
+
+    unsigned n_tot_particles = m_pdata->getN() + m_pdata->getNGhosts();
+
+    // the particles are split into contiguous chunks so that the serial ordering is preserved within each cell
+    const unsigned int n_chunks = std::max(1u, std::min(m_exec_conf->getNumThreads(), n_tot_particles));
+    const unsigned int chunk_size = (n_tot_particles + n_chunks - 1) / n_chunks;
+
+    // bin of each particle, n_cells marks particles that are not binned
+    std::vector<unsigned int> bin_of(n_tot_particles);
+
+    // number of particles per chunk and cell, converted into starting offsets by the scan
+    std::vector<unsigned int> chunk_offset(n_chunks*n_cells, 0);
+
+    // per-chunk error conditions
+    std::vector<uint3> chunk_conditions(n_chunks, make_uint3(0,0,0));
+
+    // first pass: determine the bin of every particle and count the bin occupancy in each chunk
+    tbb::parallel_for((unsigned int)0, n_chunks, [&] (unsigned int chunk)
+        {
+        uint3& conditions = chunk_conditions[chunk];
+        unsigned int *count = &chunk_offset[chunk*n_cells];
+        const unsigned int n_end = std::min((chunk+1)*chunk_size, n_tot_particles);
+
+        for (unsigned int n = chunk*chunk_size; n < n_end; ++n)
+            {
+            bin_of[n] = n_cells;
+
+            Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
+            if (std::isnan(p.x) || std::isnan(p.y) || std::isnan(p.z))
+                {
+                conditions.y = n+1;
+                continue;
+                }
+
+            // skip the types that are not binned
+            if (type_filter && !type_filter[__scalar_as_int(h_pos.data[n].w)])
+                continue;
+
+            // find the bin each particle belongs in
+            Scalar3 f = box.makeFraction(p,ghost_width);
+            int ib = (int)(f.x * m_dim.x);
+            int jb = (int)(f.y * m_dim.y);
+            int kb = (int)(f.z * m_dim.z);
+
+            // check if the particle is inside the unit cell + ghost layer in all dimensions
+            if ((f.x < Scalar(-0.00001) || f.x >= Scalar(1.00001)) ||
+                (f.y < Scalar(-0.00001) || f.y >= Scalar(1.00001)) ||
+                (f.z < Scalar(-0.00001) || f.z >= Scalar(1.00001)) )
+                {
+                // if a ghost particle is out of bounds, silently ignore it
+                if (n < N)
+                    conditions.z = n+1;
+                continue;
+                }
+
+            // need to handle the case where the particle is exactly at the box hi
+            if (ib == (int)m_dim.x && periodic.x)
+                ib = 0;
+            if (jb == (int)m_dim.y && periodic.y)
+                jb = 0;
+            if (kb == (int)m_dim.z && periodic.z)
+                kb = 0;
+
+            // all particles should be in a valid cell
+            if (ib < 0 || ib >= (int)m_dim.x ||
+                jb < 0 || jb >= (int)m_dim.y ||
+                kb < 0 || kb >= (int)m_dim.z)
+                {
+                // but ghost particles that are out of range should not produce an error
+                if (n < N)
+                    conditions.z = n+1;
+                continue;
+                }
+
+            unsigned int bin = ci(ib, jb, kb);
+            bin_of[n] = bin;
+            count[bin]++;
+            }
+        });
+
+    // second pass: exclusive scan over the chunks in every cell, the total is the cell size
+    tbb::parallel_for((unsigned int)0, n_cells, [&] (unsigned int bin)
+        {
+        unsigned int offset = 0;
+        for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+            {
+            unsigned int count = chunk_offset[chunk*n_cells + bin];
+            chunk_offset[chunk*n_cells + bin] = offset;
+            offset += count;
+            }
+        h_cell_size.data[bin] = offset;
+        });
+
+    // third pass: write out the cell list entries
+    tbb::parallel_for((unsigned int)0, n_chunks, [&] (unsigned int chunk)
+        {
+        uint3& conditions = chunk_conditions[chunk];
+        unsigned int *offset_chunk = &chunk_offset[chunk*n_cells];
+        const unsigned int n_end = std::min((chunk+1)*chunk_size, n_tot_particles);
+
+        for (unsigned int n = chunk*chunk_size; n < n_end; ++n)
+            {
+            unsigned int bin = bin_of[n];
+            if (bin == n_cells)
+                continue;
+
+            // setup the flag value to store
+            Scalar flag;
+            if (m_flag_charge)
+                flag = h_charge.data[n];
+            else if (m_flag_type)
+                flag = h_pos.data[n].w;
+            else
+                flag = __int_as_scalar(n);
+
+            // store the bin entries
+            unsigned int offset = offset_chunk[bin]++;
+
+            if (offset < m_Nmax)
+                {
+                if (m_compute_xyzf)
+                    {
+                    h_xyzf.data[cli(offset, bin)] = make_scalar4(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z, flag);
+                    }
+
+                if (m_compute_tdb)
+                    {
+                    h_tdb.data[cli(offset, bin)] = make_scalar4(h_pos.data[n].w,
+                                                                h_diameter.data[n],
+                                                                __int_as_scalar(h_body.data[n]),
+                                                                Scalar(0.0));
+                    }
+
+                if (m_compute_orientation)
+                    {
+                    h_cell_orientation.data[cli(offset, bin)] = h_orientation.data[n];
+                    }
+
+                if (m_compute_idx)
+                    {
+                    h_cell_idx.data[cli(offset, bin)] = n;
+                    }
+                }
+            else
+                {
+                conditions.x = max(conditions.x, offset+1);
+                }
+            }
+        });
+
+    // combine the conditions, keeping the last offending particle as in the serial build
+    uint3 conditions = make_uint3(0,0,0);
+    for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+        {
+        conditions.x = max(conditions.x, chunk_conditions[chunk].x);
+        conditions.y = max(conditions.y, chunk_conditions[chunk].y);
+        conditions.z = max(conditions.z, chunk_conditions[chunk].z);
+        }
+
+        {
+        // write out conditions
+        ArrayHandle<uint3> h_conditions(m_conditions, access_location::host, access_mode::overwrite);
+        *h_conditions.data = conditions;
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+#endif
+
 bool CellList::checkConditions()
     {
     bool result = false;
@@ -80,6 +80,7 @@
      - \c radius - integer radius of cells to generate in \c cell_adj (1,2,3,4,...)
      - \c multiple - Round down to the nearest multiple number of cells in each direction (only applied to cells
                      inside the domain, not the ghost cells).
+     - \c type_filter - If set, only the particles of the types with a nonzero flag are binned
 
     After a set call is made to adjust a parameter, changes do not take effect until the next call to compute().
 
@@ -94,6 +95,12 @@
     Condition flags are to be set during the computeCellList() call and will be checked by compute() which will then
     take the appropriate action. If possible, flags 1 and 2 should be set to the index of the particle causing the
     flag plus 1.
+
+    <b>Threading:</b>
+    When built with ENABLE_TBB and more than one thread is active, the cell list is filled with a parallel counting
+    sort: the particles are split into contiguous chunks, each chunk histograms its bins, a scan over the chunks gives
+    every chunk its starting offset in each cell, and the chunks then fill in their entries concurrently. Particles
+    are stored in each cell in order of increasing particle index, exactly as in the serial build.
 */
 class PYBIND11_EXPORT CellList : public Compute
     {
@@ -207,6 +214,9 @@ class PYBIND11_EXPORT CellList : public Compute
             m_params_changed = true;
             }
 
+        //! Only bin the particles of some types
+        void setTypeFilter(const std::vector<unsigned int>& type_filter);
+
         //! Request a multi-GPU cell list
         virtual void setPerDevice(bool per_device)
             {
@@ -230,6 +240,12 @@ class PYBIND11_EXPORT CellList : public Compute
             return m_nominal_width;
             }
 
+        //! Get the sort flag
+        bool getSortCellList() const
+            {
+            return m_sort_cell_list;
+            }
+
         //! Get the dimensions of the cell list
         const uint3& getDim() const
             {
@@ -389,6 +405,7 @@ class PYBIND11_EXPORT CellList : public Compute
 
         bool m_sort_cell_list;               //!< If true, sort cell list
         bool m_compute_adj_list;            //!< If true, compute the cell adjacency lists
+        GlobalArray<unsigned int> m_type_filter; //!< Nonzero for the types that are binned, empty if all types are binned
 
         //! Computes what the dimensions should me
         uint3 computeDimensions();
@@ -408,6 +425,11 @@ class PYBIND11_EXPORT CellList : public Compute
         //! Compute the cell list
         virtual void computeCellList();
 
+        #ifdef ENABLE_TBB
+        //! Compute the cell list with a parallel counting sort on the TBB threads
+        void computeCellListParallel();
+        #endif
+
         //! Check the status of the conditions
         bool checkConditions();
 
@@ -42,6 +42,7 @@ void CellListGPU::computeCellList()
     ArrayHandle<Scalar> d_charge(m_pdata->getCharges(), access_location::device, access_mode::read);
     ArrayHandle<Scalar> d_diameter(m_pdata->getDiameters(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_type_filter(m_type_filter, access_location::device, access_mode::read);
 
     BoxDim box = m_pdata->getBox();
 
@@ -93,6 +94,7 @@ void CellListGPU::computeCellList()
                               d_charge.data,
                               d_diameter.data,
                               d_body.data,
+                              d_type_filter.data,
                               m_pdata->getN(),
                               m_pdata->getNGhosts(),
                               m_Nmax,
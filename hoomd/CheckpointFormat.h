@@ -0,0 +1,195 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file CheckpointFormat.h
+    \brief Declares the layout of checkpoint files and helpers to read and write them
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __CHECKPOINT_FORMAT_H__
+#define __CHECKPOINT_FORMAT_H__
+
+#include "HOOMDMath.h"
+
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+//! Layout of checkpoint files
+/*! A checkpoint consists of an index file and one shard per rank. The index file \a name holds, in this order:
+
+    - the file header (magic, version) and the time step
+    - the number of shards, the dimensionality and the box (L, xy, xz, yz)
+    - the domain grid and the cumulative fractions of the domain decomposition of the writing run
+    - the number of particles in the whole system and in every shard
+    - the particle type names
+    - the integrator variables
+    - the bond, angle, dihedral, improper, constraint and pair snapshots
+
+    Every rank reads the index up to and including the integrator variables, only the root rank reads the topology.
+
+    Shard \a i is stored in the file \a name.i. It holds the file header, the time step, the shard index, the number
+    of particles in the shard and then one column for each particle property. Shards are indexed by the linear index
+    of the domain they were written from, so that a restart with the same decomposition reads the shard of every
+    domain on the rank that owns it.
+
+    All values are stored in the byte order of the writing machine. Real values are stored in double precision so
+    that a restart is exact in both single and double precision builds.
+*/
+namespace checkpoint
+{
+
+//! File magic
+const char magic[8] = {'H', 'O', 'O', 'M', 'D', 'C', 'P', '\0'};
+
+//! Version of the file layout
+const uint32_t version = 1;
+
+//! Write a plain value
+template<class T>
+inline void write(std::ostream& out, const T& value)
+    {
+    out.write((const char *)&value, sizeof(T));
+    }
+
+//! Write a vector of plain values, preceded by its length
+template<class T>
+inline void write(std::ostream& out, const std::vector<T>& values)
+    {
+    uint64_t n = values.size();
+    write(out, n);
+    if (n)
+        out.write((const char *)&values.front(), sizeof(T)*n);
+    }
+
+//! Write a string, preceded by its length
+inline void write(std::ostream& out, const std::string& value)
+    {
+    uint64_t n = value.size();
+    write(out, n);
+    out.write(value.c_str(), n);
+    }
+
+//! Write a vector of strings
+inline void write(std::ostream& out, const std::vector<std::string>& values)
+    {
+    uint64_t n = values.size();
+    write(out, n);
+    for (unsigned int i = 0; i < n; i++)
+        write(out, values[i]);
+    }
+
+//! Write a vector of Scalars in double precision
+inline void writeScalars(std::ostream& out, const std::vector<Scalar>& values)
+    {
+    write(out, std::vector<double>(values.begin(), values.end()));
+    }
+
+//! Write the file header
+inline void writeHeader(std::ostream& out)
+    {
+    out.write(magic, sizeof(magic));
+    write(out, version);
+    }
+
+//! Read a plain value
+template<class T>
+inline void read(std::istream& in, T& value)
+    {
+    in.read((char *)&value, sizeof(T));
+    if (!in)
+        throw std::runtime_error("Unexpected end of checkpoint file");
+    }
+
+//! Read a vector of plain values
+template<class T>
+inline void read(std::istream& in, std::vector<T>& values)
+    {
+    uint64_t n;
+    read(in, n);
+    values.resize(n);
+    if (n)
+        {
+        in.read((char *)&values.front(), sizeof(T)*n);
+        if (!in)
+            throw std::runtime_error("Unexpected end of checkpoint file");
+        }
+    }
+
+//! Read a string
+inline void read(std::istream& in, std::string& value)
+    {
+    uint64_t n;
+    read(in, n);
+    std::vector<char> chars(n);
+    if (n)
+        {
+        in.read(&chars.front(), n);
+        if (!in)
+            throw std::runtime_error("Unexpected end of checkpoint file");
+        }
+    value.assign(chars.begin(), chars.end());
+    }
+
+//! Read a vector of strings
+inline void read(std::istream& in, std::vector<std::string>& values)
+    {
+    uint64_t n;
+    read(in, n);
+    values.resize(n);
+    for (unsigned int i = 0; i < n; i++)
+        read(in, values[i]);
+    }
+
+//! Read a vector of Scalars stored in double precision
+inline void readScalars(std::istream& in, std::vector<Scalar>& values)
+    {
+    std::vector<double> v;
+    read(in, v);
+    values.assign(v.begin(), v.end());
+    }
+
+//! Read and check the file header
+/*! \returns false if the magic or the version do not match
+*/
+inline bool readHeader(std::istream& in)
+    {
+    char m[sizeof(magic)];
+    uint32_t v;
+    in.read(m, sizeof(m));
+    if (!in || memcmp(m, magic, sizeof(magic)) != 0)
+        return false;
+    in.read((char *)&v, sizeof(v));
+    return in && v == version;
+    }
+
+//! Write a snapshot of bonded groups
+template<class Snapshot>
+inline void writeGroups(std::ostream& out, const Snapshot& snap)
+    {
+    write(out, snap.type_mapping);
+    write(out, snap.type_id);
+    writeScalars(out, snap.val);
+    write(out, snap.groups);
+    }
+
+//! Read a snapshot of bonded groups
+template<class Snapshot>
+inline void readGroups(std::istream& in, Snapshot& snap)
+    {
+    read(in, snap.type_mapping);
+    read(in, snap.type_id);
+    readScalars(in, snap.val);
+    read(in, snap.groups);
+    snap.size = snap.groups.size();
+    }
+
+} // end namespace checkpoint
+
+#endif
@@ -0,0 +1,284 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "CheckpointReader.h"
+#include "CheckpointFormat.h"
+
+#include <fstream>
+#include <sstream>
+
+namespace py = pybind11;
+
+using namespace std;
+
+/*! \file CheckpointReader.cc
+    \brief Defines the CheckpointReader class
+*/
+
+/*! \param exec_conf The execution configuration
+    \param fname Name of the index file of the checkpoint
+
+    Every rank reads the index up to the integrator variables, the root rank also reads the bonded groups.
+*/
+CheckpointReader::CheckpointReader(std::shared_ptr<const ExecutionConfiguration> exec_conf, const std::string& fname)
+    : m_exec_conf(exec_conf), m_fname(fname), m_timestep(0), m_n_shards(0), m_N(0),
+      m_snapshot(new SnapshotSystemData<double>)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing CheckpointReader: " << fname << endl;
+
+    std::ifstream in(fname.c_str(), std::ios::binary);
+    if (! in.good())
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: Unable to open " << fname << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    if (! checkpoint::readHeader(in))
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << fname << " is not a checkpoint of this version of hoomd"
+                                  << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    try
+        {
+        uint32_t n_shards, dimensions, N;
+        double box_values[6];
+        uint32_t grid[3];
+
+        checkpoint::read(in, m_timestep);
+        checkpoint::read(in, n_shards);
+        checkpoint::read(in, dimensions);
+        checkpoint::read(in, box_values);
+        checkpoint::read(in, grid);
+        for (unsigned int dir = 0; dir < 3; dir++)
+            checkpoint::readScalars(in, m_cum_frac[dir]);
+        checkpoint::read(in, N);
+        checkpoint::read(in, m_shard_n);
+
+        m_n_shards = n_shards;
+        m_grid = make_uint3(grid[0], grid[1], grid[2]);
+        m_N = N;
+
+        m_snapshot->dimensions = dimensions;
+        m_snapshot->global_box = BoxDim(box_values[0], box_values[1], box_values[2]);
+        m_snapshot->global_box.setTiltFactors(box_values[3], box_values[4], box_values[5]);
+        checkpoint::read(in, m_snapshot->particle_data.type_mapping);
+
+        // integrator variables are needed on every rank
+        uint32_t n_integrators;
+        checkpoint::read(in, n_integrators);
+        m_snapshot->integrator_data.resize(n_integrators);
+        for (unsigned int i = 0; i < n_integrators; i++)
+            {
+            checkpoint::read(in, m_snapshot->integrator_data[i].type);
+            checkpoint::readScalars(in, m_snapshot->integrator_data[i].variable);
+            }
+
+        // topology is read on the root rank only
+        if (m_exec_conf->getRank() == 0)
+            {
+            checkpoint::readGroups(in, m_snapshot->bond_data);
+            checkpoint::readGroups(in, m_snapshot->angle_data);
+            checkpoint::readGroups(in, m_snapshot->dihedral_data);
+            checkpoint::readGroups(in, m_snapshot->improper_data);
+            checkpoint::readGroups(in, m_snapshot->constraint_data);
+            checkpoint::readGroups(in, m_snapshot->pair_data);
+            }
+        }
+    catch (const std::runtime_error& e)
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << e.what() << ": " << fname << endl;
+        throw;
+        }
+
+    if (m_shard_n.size() != m_n_shards || m_grid.x*m_grid.y*m_grid.z != m_n_shards)
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: Inconsistent number of shards in " << fname << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+    }
+
+/*! \param dir Direction (0=x, 1=y, 2=z)
+    \returns The widths of the first n-1 domains as fractions of the box length, as used by comm.decomposition
+*/
+std::vector<Scalar> CheckpointReader::getDomainFractions(unsigned int dir) const
+    {
+    if (dir > 2)
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: requested direction does not exist" << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    std::vector<Scalar> fractions;
+    for (unsigned int i = 0; i + 2 < m_cum_frac[dir].size(); i++)
+        fractions.push_back(m_cum_frac[dir][i+1] - m_cum_frac[dir][i]);
+    return fractions;
+    }
+
+/*! All shards are read and the particles are placed in the snapshot in tag order.
+*/
+void CheckpointReader::readParticles()
+    {
+    SnapshotParticleData<double>& snap = m_snapshot->particle_data;
+    snap.resize(m_N);
+    snap.tag.clear();
+
+    for (unsigned int shard = 0; shard < m_n_shards; shard++)
+        readShard(shard, true);
+
+    snap.is_accel_set = true;
+    }
+
+#ifdef ENABLE_MPI
+/*! \param decomposition Domain decomposition of the new run
+*/
+void CheckpointReader::readDistributedParticles(std::shared_ptr<DomainDecomposition> decomposition)
+    {
+    SnapshotParticleData<double>& snap = m_snapshot->particle_data;
+    snap.resize(0);
+    snap.tag.clear();
+    snap.is_distributed = true;
+    snap.tag_offset = 0;
+
+    unsigned int n_ranks = m_exec_conf->getNRanks();
+    uint3 grid = decomposition->getGridSize();
+
+    if (n_ranks == m_n_shards && grid.x == m_grid.x && grid.y == m_grid.y && grid.z == m_grid.z)
+        {
+        // every rank reads the shard of its own domain
+        m_exec_conf->msg->notice(2) << "init.read_checkpoint: reading the shard of every domain on its rank" << endl;
+        uint3 grid_pos = decomposition->getGridPos();
+        readShard(decomposition->getDomainIndexer()(grid_pos.x, grid_pos.y, grid_pos.z), false);
+        }
+    else
+        {
+        m_exec_conf->msg->notice(2) << "init.read_checkpoint: redistributing " << m_n_shards << " shards over "
+                                    << n_ranks << " ranks" << endl;
+        for (unsigned int shard = m_exec_conf->getRank(); shard < m_n_shards; shard += n_ranks)
+            readShard(shard, false);
+        }
+
+    snap.is_accel_set = true;
+    }
+#endif
+
+/*! \param shard Index of the shard to read
+    \param by_tag If true, place the particles at the index of their tag, otherwise append them with explicit tags
+*/
+void CheckpointReader::readShard(unsigned int shard, bool by_tag)
+    {
+    std::ostringstream s;
+    s << m_fname << "." << shard;
+    std::string fname = s.str();
+
+    std::ifstream in(fname.c_str(), std::ios::binary);
+    if (! in.good())
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: Unable to open " << fname << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    if (! checkpoint::readHeader(in))
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << fname << " is not a checkpoint of this version of hoomd"
+                                  << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    uint64_t timestep;
+    uint32_t shard_idx, n;
+    std::vector<unsigned int> tag, type, body;
+    std::vector<int3> image;
+    std::vector<double> pos, vel, accel, mass, charge, diameter, orientation, angmom, inertia;
+
+    try
+        {
+        checkpoint::read(in, timestep);
+        checkpoint::read(in, shard_idx);
+        checkpoint::read(in, n);
+        checkpoint::read(in, tag);
+        checkpoint::read(in, type);
+        checkpoint::read(in, body);
+        checkpoint::read(in, image);
+        checkpoint::read(in, pos);
+        checkpoint::read(in, vel);
+        checkpoint::read(in, accel);
+        checkpoint::read(in, mass);
+        checkpoint::read(in, charge);
+        checkpoint::read(in, diameter);
+        checkpoint::read(in, orientation);
+        checkpoint::read(in, angmom);
+        checkpoint::read(in, inertia);
+        }
+    catch (const std::runtime_error& e)
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << e.what() << ": " << fname << endl;
+        throw;
+        }
+
+    // a shard left over from an interrupted or an older checkpoint does not match the index
+    if (timestep != m_timestep || shard_idx != shard || n != m_shard_n[shard])
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: " << fname << " does not belong to " << m_fname << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    if (tag.size() != n || type.size() != n || body.size() != n || image.size() != n || pos.size() != 3*n ||
+        vel.size() != 3*n || accel.size() != 3*n || mass.size() != n || charge.size() != n || diameter.size() != n ||
+        orientation.size() != 4*n || angmom.size() != 4*n || inertia.size() != 3*n)
+        {
+        m_exec_conf->msg->error() << "init.read_checkpoint: Inconsistent particle data in " << fname << endl;
+        throw runtime_error("Error reading checkpoint");
+        }
+
+    SnapshotParticleData<double>& snap = m_snapshot->particle_data;
+    unsigned int offset = snap.size;
+    if (! by_tag)
+        {
+        snap.resize(offset + n);
+        snap.tag.resize(offset + n);
+        }
+
+    for (unsigned int i = 0; i < n; i++)
+        {
+        if (tag[i] >= m_N)
+            {
+            m_exec_conf->msg->error() << "init.read_checkpoint: Invalid particle tag in " << fname << endl;
+            throw runtime_error("Error reading checkpoint");
+            }
+
+        unsigned int idx = by_tag ? tag[i] : offset + i;
+        if (! by_tag)
+            snap.tag[idx] = tag[i];
+
+        snap.type[idx] = type[i];
+        snap.body[idx] = body[i];
+        snap.image[idx] = image[i];
+        snap.pos[idx] = vec3<double>(pos[3*i], pos[3*i+1], pos[3*i+2]);
+        snap.vel[idx] = vec3<double>(vel[3*i], vel[3*i+1], vel[3*i+2]);
+        snap.accel[idx] = vec3<double>(accel[3*i], accel[3*i+1], accel[3*i+2]);
+        snap.mass[idx] = mass[i];
+        snap.charge[idx] = charge[i];
+        snap.diameter[idx] = diameter[i];
+        snap.orientation[idx] = quat<double>(orientation[4*i],
+            vec3<double>(orientation[4*i+1], orientation[4*i+2], orientation[4*i+3]));
+        snap.angmom[idx] = quat<double>(angmom[4*i], vec3<double>(angmom[4*i+1], angmom[4*i+2], angmom[4*i+3]));
+        snap.inertia[idx] = vec3<double>(inertia[3*i], inertia[3*i+1], inertia[3*i+2]);
+        }
+    }
+
+void export_CheckpointReader(py::module& m)
+    {
+    py::class_< CheckpointReader, std::shared_ptr<CheckpointReader> >(m,"CheckpointReader")
+    .def(py::init< std::shared_ptr<const ExecutionConfiguration>, const std::string& >())
+    .def("readParticles", &CheckpointReader::readParticles)
+    #ifdef ENABLE_MPI
+    .def("readDistributedParticles", &CheckpointReader::readDistributedParticles)
+    #endif
+    .def("getTimeStep", &CheckpointReader::getTimeStep)
+    .def("getNumShards", &CheckpointReader::getNumShards)
+    .def("getDomainFractions", &CheckpointReader::getDomainFractions)
+    .def("getSnapshot", &CheckpointReader::getSnapshot)
+    ;
+    }
@@ -0,0 +1,96 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file CheckpointReader.h
+    \brief Declares the CheckpointReader class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __CHECKPOINT_READER_H__
+#define __CHECKPOINT_READER_H__
+
+#include "ExecutionConfiguration.h"
+#include "SnapshotSystemData.h"
+
+#include <string>
+#include <vector>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+//! Reads a checkpoint written by CheckpointWriter
+/*! The constructor reads the index file on every rank. The box, the particle types, the integrator variables and
+    the domain decomposition of the writing run are then known on all ranks, the bonded groups only on the root rank.
+    The particles are read by readDistributedParticles() once the domain decomposition of the new run is known, or
+    by readParticles() in runs without domain decomposition.
+
+    When the new run has the same domain grid as the writing run, every rank reads only the shard of its own domain,
+    so that no particle is sent to another rank during initialization. Otherwise, rank r of P reads the shards
+    r, r+P, r+2P, ... and ParticleData exchanges the particles between the ranks. In both cases the snapshot is
+    distributed (SnapshotParticleData::is_distributed) with explicit tags. readParticles() reads all shards into
+    a regular snapshot in tag order.
+
+    \ingroup data_structs
+*/
+class PYBIND11_EXPORT CheckpointReader
+    {
+    public:
+        //! Read the index of a checkpoint
+        CheckpointReader(std::shared_ptr<const ExecutionConfiguration> exec_conf, const std::string& fname);
+
+        //! Read all particles into a snapshot in tag order
+        void readParticles();
+
+        #ifdef ENABLE_MPI
+        //! Read the particles of this rank into a distributed snapshot
+        void readDistributedParticles(std::shared_ptr<DomainDecomposition> decomposition);
+        #endif
+
+        //! Get the time step of the checkpoint
+        uint64_t getTimeStep() const
+            {
+            return m_timestep;
+            }
+
+        //! Get the number of shards (the number of ranks of the writing run)
+        unsigned int getNumShards() const
+            {
+            return m_n_shards;
+            }
+
+        //! Get the domain grid of the writing run
+        uint3 getGridSize() const
+            {
+            return m_grid;
+            }
+
+        //! Get the fractional widths of the first n-1 domains along direction \a dir in the writing run
+        std::vector<Scalar> getDomainFractions(unsigned int dir) const;
+
+        //! Get the snapshot
+        std::shared_ptr< SnapshotSystemData<double> > getSnapshot() const
+            {
+            return m_snapshot;
+            }
+
+    private:
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< The execution configuration
+        std::string m_fname;                                        //!< Name of the index file
+        uint64_t m_timestep;                                        //!< Time step of the checkpoint
+        unsigned int m_n_shards;                                    //!< Number of shards
+        uint3 m_grid;                                               //!< Domain grid of the writing run
+        std::vector<Scalar> m_cum_frac[3];                          //!< Cumulative domain fractions of the writing run
+        unsigned int m_N;                                           //!< Global number of particles
+        std::vector<unsigned int> m_shard_n;                        //!< Number of particles in every shard
+        std::shared_ptr< SnapshotSystemData<double> > m_snapshot;   //!< The snapshot to read
+
+        //! Read a shard into the particle snapshot
+        void readShard(unsigned int shard, bool by_tag);
+    };
+
+//! Exports CheckpointReader to python
+void export_CheckpointReader(pybind11::module& m);
+
+#endif
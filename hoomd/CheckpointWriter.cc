@@ -0,0 +1,354 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "CheckpointWriter.h"
+#include "CheckpointFormat.h"
+#include "SnapshotSystemData.h"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace py = pybind11;
+
+using namespace std;
+
+/*! \file CheckpointWriter.cc
+    \brief Defines the CheckpointWriter class
+*/
+
+/*! \param sysdef SystemDefinition containing the system to write
+    \param fname Name of the index file, the shards are written to \a fname.i
+*/
+CheckpointWriter::CheckpointWriter(std::shared_ptr<SystemDefinition> sysdef, const std::string& fname)
+    : Analyzer(sysdef), m_fname(fname)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing CheckpointWriter: " << fname << endl;
+    }
+
+CheckpointWriter::~CheckpointWriter()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying CheckpointWriter" << endl;
+    }
+
+/*! \returns true if the tags have gaps and m_tag_map was filled
+*/
+bool CheckpointWriter::compactTags()
+    {
+    unsigned int nglobal = m_pdata->getNGlobal();
+    m_tag_map.clear();
+
+    if (nglobal == 0 || m_pdata->getMaximumTag() + 1 == nglobal)
+        return false;
+
+    // the set of active tags is known on every rank
+    m_tag_map.resize(m_pdata->getMaximumTag() + 1, NO_BODY);
+    for (unsigned int n = 0; n < nglobal; n++)
+        m_tag_map[m_pdata->getNthTag(n)] = n;
+
+    return true;
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    Collective in MPI simulations.
+*/
+void CheckpointWriter::analyze(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push("Dump checkpoint");
+
+    if (compactTags())
+        m_exec_conf->msg->notice(3) << "dump.checkpoint: compacting particle tags" << endl;
+
+    unsigned int shard = 0;
+    unsigned int n_shards = 1;
+    unsigned int rank = 0;
+    #ifdef ENABLE_MPI
+    std::shared_ptr<DomainDecomposition> decomposition = m_pdata->getDomainDecomposition();
+    if (decomposition)
+        {
+        uint3 grid_pos = decomposition->getGridPos();
+        shard = decomposition->getDomainIndexer()(grid_pos.x, grid_pos.y, grid_pos.z);
+        n_shards = m_exec_conf->getNRanks();
+        rank = m_exec_conf->getRank();
+        }
+    #endif
+
+    std::ostringstream shard_name;
+    shard_name << m_fname << "." << shard;
+    bool ok = writeShard(shard_name.str() + ".tmp", timestep, shard);
+
+    // number of particles in every shard
+    std::vector<unsigned int> shard_n(n_shards, 0);
+    shard_n[shard] = m_pdata->getN();
+    #ifdef ENABLE_MPI
+    if (decomposition)
+        {
+        unsigned int local[2] = {shard, m_pdata->getN()};
+        std::vector<unsigned int> all(2*n_shards);
+        MPI_Gather(local, 2, MPI_UNSIGNED, &all.front(), 2, MPI_UNSIGNED, 0, m_exec_conf->getMPICommunicator());
+        for (unsigned int i = 0; i < n_shards; i++)
+            shard_n[all[2*i]] = all[2*i+1];
+        }
+    #endif
+
+    // the topology snapshot is collective
+    if (! writeIndex(m_fname + ".tmp", timestep, shard_n))
+        ok = false;
+
+    #ifdef ENABLE_MPI
+    if (decomposition)
+        {
+        int local_ok = ok;
+        int global_ok = 0;
+        MPI_Allreduce(&local_ok, &global_ok, 1, MPI_INT, MPI_LAND, m_exec_conf->getMPICommunicator());
+        ok = global_ok;
+        }
+    #endif
+
+    if (! ok)
+        {
+        m_exec_conf->msg->error() << "dump.checkpoint: Error writing " << m_fname << endl;
+        throw runtime_error("Error writing checkpoint");
+        }
+
+    // replace the previous checkpoint, the index last
+    if (std::rename((shard_name.str() + ".tmp").c_str(), shard_name.str().c_str()) != 0)
+        ok = false;
+
+    #ifdef ENABLE_MPI
+    if (decomposition)
+        {
+        int local_ok = ok;
+        int global_ok = 0;
+        MPI_Allreduce(&local_ok, &global_ok, 1, MPI_INT, MPI_LAND, m_exec_conf->getMPICommunicator());
+        ok = global_ok;
+        }
+    #endif
+
+    if (ok && rank == 0 && std::rename((m_fname + ".tmp").c_str(), m_fname.c_str()) != 0)
+        ok = false;
+
+    #ifdef ENABLE_MPI
+    if (decomposition)
+        bcast(ok, 0, m_exec_conf->getMPICommunicator());
+    #endif
+
+    if (! ok)
+        {
+        m_exec_conf->msg->error() << "dump.checkpoint: Error replacing " << m_fname << endl;
+        throw runtime_error("Error writing checkpoint");
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param fname File to write
+    \param timestep Current time step
+    \param shard Index of the shard
+    \returns true on success
+*/
+bool CheckpointWriter::writeShard(const std::string& fname, unsigned int timestep, unsigned int shard)
+    {
+    std::ofstream out(fname.c_str(), std::ios::binary | std::ios::trunc);
+    if (! out.good())
+        {
+        m_exec_conf->msg->error() << "dump.checkpoint: Unable to open " << fname << endl;
+        return false;
+        }
+
+    unsigned int N = m_pdata->getN();
+
+    std::vector<unsigned int> tag(N), type(N), body(N);
+    std::vector<int3> image(N);
+    std::vector<double> pos(3*N), vel(3*N), accel(3*N), mass(N), charge(N), diameter(N);
+    std::vector<double> orientation(4*N), angmom(4*N), inertia(3*N);
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < N; i++)
+            {
+            Scalar4 p = h_pos.data[i];
+            Scalar4 v = h_vel.data[i];
+            Scalar3 a = h_accel.data[i];
+            Scalar4 q = h_orientation.data[i];
+            Scalar4 L = h_angmom.data[i];
+            Scalar3 I = h_inertia.data[i];
+
+            tag[i] = mapTag(h_tag.data[i]);
+            type[i] = __scalar_as_int(p.w);
+            body[i] = h_body.data[i] == NO_BODY ? NO_BODY : mapTag(h_body.data[i]);
+            image[i] = h_image.data[i];
+
+            pos[3*i] = p.x; pos[3*i+1] = p.y; pos[3*i+2] = p.z;
+            vel[3*i] = v.x; vel[3*i+1] = v.y; vel[3*i+2] = v.z;
+            accel[3*i] = a.x; accel[3*i+1] = a.y; accel[3*i+2] = a.z;
+            mass[i] = v.w;
+            charge[i] = h_charge.data[i];
+            diameter[i] = h_diameter.data[i];
+            orientation[4*i] = q.x; orientation[4*i+1] = q.y; orientation[4*i+2] = q.z; orientation[4*i+3] = q.w;
+            angmom[4*i] = L.x; angmom[4*i+1] = L.y; angmom[4*i+2] = L.z; angmom[4*i+3] = L.w;
+            inertia[3*i] = I.x; inertia[3*i+1] = I.y; inertia[3*i+2] = I.z;
+            }
+        }
+
+    checkpoint::writeHeader(out);
+    checkpoint::write(out, (uint64_t)timestep);
+    checkpoint::write(out, (uint32_t)shard);
+    checkpoint::write(out, (uint32_t)N);
+    checkpoint::write(out, tag);
+    checkpoint::write(out, type);
+    checkpoint::write(out, body);
+    checkpoint::write(out, image);
+    checkpoint::write(out, pos);
+    checkpoint::write(out, vel);
+    checkpoint::write(out, accel);
+    checkpoint::write(out, mass);
+    checkpoint::write(out, charge);
+    checkpoint::write(out, diameter);
+    checkpoint::write(out, orientation);
+    checkpoint::write(out, angmom);
+    checkpoint::write(out, inertia);
+
+    out.close();
+    if (! out.good())
+        {
+        m_exec_conf->msg->error() << "dump.checkpoint: Error writing " << fname << endl;
+        return false;
+        }
+    return true;
+    }
+
+//! Map the members of bonded groups to compacted tags
+template<class Snapshot>
+static void remapGroups(Snapshot& snap, const std::vector<unsigned int>& tag_map)
+    {
+    if (tag_map.empty())
+        return;
+
+    for (unsigned int i = 0; i < snap.groups.size(); i++)
+        for (unsigned int j = 0; j < sizeof(snap.groups[i].tag)/sizeof(unsigned int); j++)
+            snap.groups[i].tag[j] = tag_map[snap.groups[i].tag[j]];
+    }
+
+/*! \param fname File to write
+    \param timestep Current time step
+    \param shard_n Number of particles in every shard
+    \returns true on success (always true on ranks other than the root)
+
+    Collective in MPI simulations, because the snapshot of the bonded groups is.
+*/
+bool CheckpointWriter::writeIndex(const std::string& fname,
+                                  unsigned int timestep,
+                                  const std::vector<unsigned int>& shard_n)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap =
+        m_sysdef->takeSnapshot<Scalar>(false, true, true, true, true, true, true, true);
+
+    if (m_exec_conf->getRank() != 0)
+        return true;
+
+    std::ofstream out(fname.c_str(), std::ios::binary | std::ios::trunc);
+    if (! out.good())
+        {
+        m_exec_conf->msg->error() << "dump.checkpoint: Unable to open " << fname << endl;
+        return false;
+        }
+
+    const BoxDim& box = snap->global_box;
+    Scalar3 L = box.getL();
+    double box_values[6] = {L.x, L.y, L.z, box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ()};
+
+    // a run without decomposition has a single domain
+    uint32_t grid[3] = {1, 1, 1};
+    std::vector<Scalar> cum_frac[3];
+    for (unsigned int dir = 0; dir < 3; dir++)
+        {
+        cum_frac[dir].push_back(Scalar(0.0));
+        cum_frac[dir].push_back(Scalar(1.0));
+        }
+
+    #ifdef ENABLE_MPI
+    std::shared_ptr<DomainDecomposition> decomposition = m_pdata->getDomainDecomposition();
+    if (decomposition)
+        {
+        uint3 grid_size = decomposition->getGridSize();
+        grid[0] = grid_size.x;
+        grid[1] = grid_size.y;
+        grid[2] = grid_size.z;
+        for (unsigned int dir = 0; dir < 3; dir++)
+            cum_frac[dir] = decomposition->getCumulativeFractions(dir);
+        }
+    #endif
+
+    checkpoint::writeHeader(out);
+    checkpoint::write(out, (uint64_t)timestep);
+    checkpoint::write(out, (uint32_t)shard_n.size());
+    checkpoint::write(out, (uint32_t)snap->dimensions);
+    out.write((const char *)box_values, sizeof(box_values));
+    out.write((const char *)grid, sizeof(grid));
+    for (unsigned int dir = 0; dir < 3; dir++)
+        checkpoint::writeScalars(out, cum_frac[dir]);
+    checkpoint::write(out, (uint32_t)m_pdata->getNGlobal());
+    checkpoint::write(out, shard_n);
+
+    std::vector<std::string> type_mapping;
+    for (unsigned int t = 0; t < m_pdata->getNTypes(); t++)
+        type_mapping.push_back(m_pdata->getNameByType(t));
+    checkpoint::write(out, type_mapping);
+
+    // integrator variables
+    checkpoint::write(out, (uint32_t)snap->integrator_data.size());
+    for (unsigned int i = 0; i < snap->integrator_data.size(); i++)
+        {
+        checkpoint::write(out, snap->integrator_data[i].type);
+        checkpoint::writeScalars(out, snap->integrator_data[i].variable);
+        }
+
+    // topology
+    remapGroups(snap->bond_data, m_tag_map);
+    remapGroups(snap->angle_data, m_tag_map);
+    remapGroups(snap->dihedral_data, m_tag_map);
+    remapGroups(snap->improper_data, m_tag_map);
+    remapGroups(snap->constraint_data, m_tag_map);
+    remapGroups(snap->pair_data, m_tag_map);
+
+    checkpoint::writeGroups(out, snap->bond_data);
+    checkpoint::writeGroups(out, snap->angle_data);
+    checkpoint::writeGroups(out, snap->dihedral_data);
+    checkpoint::writeGroups(out, snap->improper_data);
+    checkpoint::writeGroups(out, snap->constraint_data);
+    checkpoint::writeGroups(out, snap->pair_data);
+
+    out.close();
+    if (! out.good())
+        {
+        m_exec_conf->msg->error() << "dump.checkpoint: Error writing " << fname << endl;
+        return false;
+        }
+    return true;
+    }
+
+void export_CheckpointWriter(py::module& m)
+    {
+    py::class_<CheckpointWriter, std::shared_ptr<CheckpointWriter> >(m,"CheckpointWriter",py::base<Analyzer>())
+    .def(py::init< std::shared_ptr<SystemDefinition>, std::string >())
+    ;
+    }
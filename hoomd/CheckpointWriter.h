@@ -0,0 +1,75 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file CheckpointWriter.h
+    \brief Declares the CheckpointWriter class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __CHECKPOINT_WRITER_H__
+#define __CHECKPOINT_WRITER_H__
+
+#include "Analyzer.h"
+
+#include <string>
+#include <vector>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+//! Writes checkpoints of the full system state for exact restarts
+/*! Every rank writes the particles of its domain to its own shard in double precision, without gathering them on
+    the root rank. The root rank writes the index file with the box, the domain decomposition, the particle types,
+    the integrator variables and the bonded groups. See CheckpointFormat.h for the layout of the files.
+
+    The random number generators in HOOMD are counter based (seeded by the user seed, the time step and the particle
+    tags), so the time step and the particle tags stored in the checkpoint fully define their state.
+
+    A checkpoint replaces the previous one only after all ranks have written their shards: the files are first
+    written with the suffix .tmp and renamed by every rank once all writes succeeded. The index is renamed last.
+
+    Tags are compacted when particles have been removed from the system, so that a checkpoint always holds the tags
+    0 to N-1. Bond members and body ids are remapped to the compacted tags.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT CheckpointWriter : public Analyzer
+    {
+    public:
+        //! Construct the writer
+        CheckpointWriter(std::shared_ptr<SystemDefinition> sysdef, const std::string& fname);
+
+        //! Destructor
+        ~CheckpointWriter();
+
+        //! Write a checkpoint of the current time step
+        void analyze(unsigned int timestep);
+
+    private:
+        std::string m_fname;                    //!< Name of the index file
+        std::vector<unsigned int> m_tag_map;    //!< Compacted tag of every tag (only when tags have gaps)
+
+        //! Build the map from tags to compacted tags
+        bool compactTags();
+
+        //! Map a tag to its compacted tag
+        unsigned int mapTag(unsigned int tag) const
+            {
+            return m_tag_map.size() ? m_tag_map[tag] : tag;
+            }
+
+        //! Write the shard of this rank
+        bool writeShard(const std::string& fname, unsigned int timestep, unsigned int shard);
+
+        //! Write the index file (on the root rank)
+        bool writeIndex(const std::string& fname,
+                        unsigned int timestep,
+                        const std::vector<unsigned int>& shard_n);
+    };
+
+//! Exports the CheckpointWriter class to python
+void export_CheckpointWriter(pybind11::module& m);
+
+#endif
@@ -12,6 +12,7 @@
 
 #include "Communicator.h"
 #include "System.h"
+#include "ClockSource.h"
 
 #include <algorithm>
 #include <hoomd/extern/pybind/include/pybind11/stl.h>
@@ -250,7 +251,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                 recv_bytes += sizeof(unsigned int);
                 } // end neighbor loop
 
-            MPI_Waitall(nreq, req, stat);
+            m_comm.waitAll(nreq, req, stat);
 
             // sum up receive counts
             for (unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
@@ -317,7 +318,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                 }
 
             std::vector<MPI_Status> stats(reqs.size());
-            MPI_Waitall(reqs.size(), &reqs.front(), &stats.front());
+            m_comm.waitAll(reqs.size(), &reqs.front(), &stats.front());
 
             if (m_comm.m_prof) m_comm.m_prof->pop(0,send_bytes+recv_bytes);
             }
@@ -533,7 +534,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                 recv_bytes += sizeof(unsigned int);
                 } // end neighbor loop
 
-            MPI_Waitall(nreq, req, stat);
+            m_comm.waitAll(nreq, req, stat);
 
             // sum up receive counts
             for (unsigned int ineigh = 0; ineigh < m_comm.m_n_unique_neigh; ineigh++)
@@ -600,7 +601,7 @@ void Communicator::GroupCommunicator<group_data>::migrateGroups(bool incomplete,
                 }
 
             std::vector<MPI_Status> stats(reqs.size());
-            MPI_Waitall(reqs.size(), &reqs.front(), &stats.front());
+            m_comm.waitAll(reqs.size(), &reqs.front(), &stats.front());
 
             if (m_comm.m_prof) m_comm.m_prof->pop(0,send_bytes+recv_bytes);
             }
@@ -930,7 +931,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
                 0,
                 m_comm.m_mpi_comm,
                 &reqs[1]);
-            MPI_Waitall(2, reqs, status);
+            m_comm.waitAll(2, reqs, status);
 
             if (m_comm.m_prof)
                 m_comm.m_prof->pop();
@@ -980,7 +981,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
                     2,
                     m_comm.m_mpi_comm,
                     &reqs[3]);
-                MPI_Waitall(4, reqs, status);
+                m_comm.waitAll(4, reqs, status);
                 }
 
             if (m_comm.m_prof)
@@ -1047,7 +1048,7 @@ void Communicator::GroupCommunicator<group_data>::exchangeGhostGroups(
             m_comm.m_prof->pop();
 
         // notify subscribers that group order has changed
-        m_gdata->notifyGroupReorder();
+        m_gdata->notifyGroupExchange();
 
         } // end if groups exist
     }
@@ -1079,16 +1080,34 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_netvirial_copybuf(m_exec_conf),
             m_netvirial_recvbuf(m_exec_conf),
             m_plan(m_exec_conf),
+            m_half_shell(false),
+            m_ghost_half_shell(m_exec_conf),
             m_plan_reverse(m_exec_conf),
             m_tag_reverse(m_exec_conf),
             m_netforce_reverse_copybuf(m_exec_conf),
             m_netforce_reverse_recvbuf(m_exec_conf),
+            m_body_ghost_plan(m_exec_conf),
             m_r_ghost_max(Scalar(0.0)),
             m_r_extra_ghost_max(Scalar(0.0)),
             m_ghosts_added(0),
             m_has_ghost_particles(false),
+            m_migrate_buffer(Scalar(0.0)),
+            m_migrate_ref_valid(false),
             m_last_flags(0),
             m_comm_pending(false),
+            m_n_pending_reqs(0),
+            m_pending_ghost_start(0),
+            m_pending_ghost_num(0),
+            m_pending_reqs(NULL),
+            m_persistent_mpi(true),
+            m_ghost_pos_fixed_point(false),
+            m_pos_fixed_copybuf(m_exec_conf),
+            m_pos_fixed_recvbuf(m_exec_conf),
+            m_sort_ghosts(false),
+            m_node_comm(MPI_COMM_NULL),
+            m_pos_win(MPI_WIN_NULL),
+            m_pos_win_buf(NULL),
+            m_pos_win_capacity(0),
             m_bond_comm(*this, m_sysdef->getBondData()),
             m_angle_comm(*this, m_sysdef->getAngleData()),
             m_dihedral_comm(*this, m_sysdef->getDihedralData()),
@@ -1096,12 +1115,23 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
             m_constraint_comm(*this, m_sysdef->getConstraintData()),
             m_pair_comm(*this, m_sysdef->getPairData())
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "Communicator");
+
     // initialize array of neighbor processor ids
     assert(m_mpi_comm);
     assert(m_decomposition);
 
     m_exec_conf->msg->notice(5) << "Constructing Communicator" << endl;
 
+    m_wait_time = 0;
+    Metrics *metrics = m_exec_conf->getMetrics();
+    m_metric_wait_time = metrics->registerExchangeWaitTime();
+    m_metric_collective_time = metrics->registerCollectiveTime();
+    m_metric_migrations = metrics->registerMetric("hoomd_comm_migrations", "",
+        "Number of particle migrations and ghost exchanges", Metrics::counter, Metrics::max);
+    m_metric_ghosts = metrics->registerMetric("hoomd_comm_ghosts", "",
+        "Number of ghost particles", Metrics::gauge, Metrics::sum);
+
     for (unsigned int dir = 0; dir < 6; dir ++)
         {
         m_is_at_boundary[dir] = m_decomposition->isAtBoundary(dir) ? 1 : 0;
@@ -1113,6 +1143,10 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
         m_copy_ghosts[dir].swap(copy_ghosts);
         m_num_copy_ghosts[dir] = 0;
         m_num_recv_ghosts[dir] = 0;
+
+        m_node_send_rank[dir] = MPI_UNDEFINED;
+        m_node_recv_rank[dir] = MPI_UNDEFINED;
+        m_node_recv_buf[dir] = NULL;
         }
 
     // All buffers corresponding to sending ghosts in reverse
@@ -1140,6 +1174,10 @@ Communicator::Communicator(std::shared_ptr<SystemDefinition> sysdef,
     // connect to type change signal
     m_pdata->getNumTypesChangeSignal().connect<Communicator, &Communicator::slotNumTypesChanged>(this);
 
+    // sorting the particles or changing the box invalidates the reference of the lazy migration check
+    m_pdata->getParticleSortSignal().connect<Communicator, &Communicator::slotInvalidateMigrationReference>(this);
+    m_pdata->getBoxChangeSignal().connect<Communicator, &Communicator::slotInvalidateMigrationReference>(this);
+
     // allocate per type ghost width
     GlobalArray<Scalar> r_ghost(m_pdata->getNTypes(), m_exec_conf);
     m_r_ghost.swap(r_ghost);
@@ -1195,6 +1233,8 @@ Communicator::~Communicator()
     m_pdata->getParticleSortSignal().disconnect<Communicator, &Communicator::forceMigrate>(this);
     m_pdata->getGhostParticlesRemovedSignal().disconnect<Communicator, &Communicator::slotGhostParticlesRemoved>(this);
     m_pdata->getNumTypesChangeSignal().disconnect<Communicator, &Communicator::slotNumTypesChanged>(this);
+    m_pdata->getParticleSortSignal().disconnect<Communicator, &Communicator::slotInvalidateMigrationReference>(this);
+    m_pdata->getBoxChangeSignal().disconnect<Communicator, &Communicator::slotInvalidateMigrationReference>(this);
 
     m_sysdef->getBondData()->getGroupNumChangeSignal().disconnect<Communicator, &Communicator::setBondsChanged>(this);
     m_sysdef->getAngleData()->getGroupNumChangeSignal().disconnect<Communicator, &Communicator::setAnglesChanged>(this);
@@ -1202,6 +1242,9 @@ Communicator::~Communicator()
     m_sysdef->getImproperData()->getGroupNumChangeSignal().disconnect<Communicator, &Communicator::setImpropersChanged>(this);
     m_sysdef->getConstraintData()->getGroupNumChangeSignal().disconnect<Communicator, &Communicator::setConstraintsChanged>(this);
     m_sysdef->getPairData()->getGroupNumChangeSignal().disconnect<Communicator, &Communicator::setPairsChanged>(this);
+
+    freePersistentGhostRequests();
+    freeNodeSharedMemory();
     }
 
 void Communicator::initializeNeighborArrays()
@@ -1299,6 +1342,8 @@ void Communicator::initializeNeighborArrays()
 //! Interface to the communication methods.
 void Communicator::communicate(unsigned int timestep)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "Communicator");
+
     // Guard to prevent recursive triggering of migration
     m_is_communicating = true;
 
@@ -1310,6 +1355,15 @@ void Communicator::communicate(unsigned int timestep)
                                         }
                                       , timestep);
 
+    if (m_half_shell)
+        {
+        // the forces on the ghosts are sent back to their owners by tag, and the constraints that use the forward
+        // net force communication are not supported
+        m_flags[comm_flag::reverse_net_force] = 1;
+        m_flags[comm_flag::tag] = 1;
+        m_flags[comm_flag::net_force] = 0;
+        }
+
     if (!m_force_migrate && !m_compute_callbacks.empty() && m_has_ghost_particles)
         {
         // do an obligatory update before determining whether to migrate
@@ -1337,11 +1391,18 @@ void Communicator::communicate(unsigned int timestep)
 
     bool migrate = migrate_request || m_force_migrate || !m_has_ghost_particles;
 
+    // without migrate requests, migrate when particles may have left their domain
+    if (!migrate && m_migrate_requests.empty() && m_migrate_buffer > Scalar(0.0))
+        migrate = checkMigration();
+
     // Update ghosts if we are not migrating
     if (!migrate && m_compute_callbacks.empty())
         {
         beginUpdateGhosts(timestep);
 
+        // overlap computation on interior particles with the ghost update
+        m_interior_compute_callbacks.emit(timestep);
+
         finishUpdateGhosts(timestep);
         }
 
@@ -1356,12 +1417,26 @@ void Communicator::communicate(unsigned int timestep)
         // Construct ghost send lists, exchange ghost atom data
         exchangeGhosts();
 
+        m_exec_conf->getMetrics()->add(m_metric_migrations, 1.0);
+        m_exec_conf->getMetrics()->set(m_metric_ghosts, double(m_pdata->getNGhosts()));
+
         // update particle data now that ghosts are available
         m_compute_callbacks.emit(timestep);
 
         m_has_ghost_particles = true;
         }
 
+    if (migrate || !m_compute_callbacks.empty())
+        {
+        // local and ghost positions have been updated
+        m_pdata->invalidatePositionsSoA();
+        }
+    else
+        {
+        // only the ghost positions have changed, the local rows copied by the interior computes are still current
+        m_pdata->invalidateGhostPositionsSoA();
+        }
+
     m_is_communicating = false;
     }
 
@@ -1458,27 +1533,36 @@ void Communicator::migrateParticles()
         if (m_prof)
             m_prof->push("MPI send/recv");
 
-        unsigned int n_recv_ptls;
+        // only the fields with non-default values are sent, announce them with the size of the message
+        unsigned int n_send_ptls = m_sendbuf.size();
+        unsigned int send_header[2] = {n_send_ptls, getPdataElementFields(m_sendbuf.data(), n_send_ptls)};
+        unsigned int recv_header[2];
 
-        // communicate size of the message that will contain the particle data
         m_reqs.resize(2);
         m_stats.resize(2);
 
-        unsigned int n_send_ptls = m_sendbuf.size();
+        MPI_Isend(send_header, 2, MPI_UNSIGNED, send_neighbor, 0, m_mpi_comm, & m_reqs[0]);
+        MPI_Irecv(recv_header, 2, MPI_UNSIGNED, recv_neighbor, 0, m_mpi_comm, & m_reqs[1]);
+        waitAll(2, &m_reqs.front(), &m_stats.front());
 
-        MPI_Isend(&n_send_ptls, 1, MPI_UNSIGNED, send_neighbor, 0, m_mpi_comm, & m_reqs[0]);
-        MPI_Irecv(&n_recv_ptls, 1, MPI_UNSIGNED, recv_neighbor, 0, m_mpi_comm, & m_reqs[1]);
-        MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+        unsigned int n_recv_ptls = recv_header[0];
+        unsigned int send_size = getPackedPdataElementSize(send_header[1]);
+        unsigned int recv_size = getPackedPdataElementSize(recv_header[1]);
 
-        // Resize receive buffer
+        // pack the send buffer and resize the receive buffers
+        m_packed_sendbuf.resize(n_send_ptls*send_size);
+        packPdataElements(m_sendbuf.data(), n_send_ptls, send_header[1], m_packed_sendbuf.data());
+        m_packed_recvbuf.resize(n_recv_ptls*recv_size);
         m_recvbuf.resize(n_recv_ptls);
 
         // exchange particle data
         m_reqs.resize(2);
         m_stats.resize(2);
-        MPI_Isend(&m_sendbuf.front(), n_send_ptls*sizeof(pdata_element), MPI_BYTE, send_neighbor, 1, m_mpi_comm, & m_reqs[0]);
-        MPI_Irecv(&m_recvbuf.front(), n_recv_ptls*sizeof(pdata_element), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, & m_reqs[1]);
-        MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+        MPI_Isend(m_packed_sendbuf.data(), n_send_ptls*send_size, MPI_BYTE, send_neighbor, 1, m_mpi_comm, & m_reqs[0]);
+        MPI_Irecv(m_packed_recvbuf.data(), n_recv_ptls*recv_size, MPI_BYTE, recv_neighbor, 1, m_mpi_comm, & m_reqs[1]);
+        waitAll(2, &m_reqs.front(), &m_stats.front());
+
+        unpackPdataElements(m_packed_recvbuf.data(), n_recv_ptls, recv_header[1], m_recvbuf.data());
 
         if (m_prof)
             m_prof->pop();
@@ -1530,6 +1614,11 @@ void Communicator::updateGhostWidth()
                                                             if (r > r_ghost_i) r_ghost_i = r;
                                                             }
                                                             ,cur_type);
+
+            // the buffer of the lazy migration check keeps the ghost lists valid while the particles move
+            if (r_ghost_i > Scalar(0.0))
+                r_ghost_i += m_migrate_buffer;
+
             h_r_ghost.data[cur_type] = r_ghost_i;
             if (r_ghost_i > r_ghost_max) r_ghost_max = r_ghost_i;
             }
@@ -1557,6 +1646,120 @@ void Communicator::updateGhostWidth()
         }
     }
 
+/*! \returns true if particles may have left their domain or entered the ghost layer of a neighbor since the last
+    ghost exchange, false if the ghost lists are still valid
+
+    The maximum displacement of the local particles since the last ghost exchange is compared with the migration
+    buffer. The displacements are reduced over all ranks in a single collective call, so all ranks must call this
+    method together. Particles are always migrated if the check is disabled, the particles have been sorted, added or
+    removed, the box has changed, the ghost layer widths have changed, or bonded groups have changed.
+*/
+bool Communicator::checkMigration()
+    {
+    if (m_migrate_buffer <= Scalar(0.0))
+        return true;
+
+    if (m_prof)
+        m_prof->push("comm_migrate_check");
+
+    // the ghost layer width may have changed since the last exchange
+    updateGhostWidth();
+
+    double check[2];
+    check[0] = (!m_migrate_ref_valid || m_force_migrate || m_migrate_ref_pos.size() != m_pdata->getN()
+        || m_bonds_changed || m_angles_changed || m_dihedrals_changed || m_impropers_changed
+        || m_constraints_changed || m_pairs_changed) ? 1.0 : 0.0;
+    check[1] = 0.0;
+
+    if (check[0] == 0.0)
+        {
+        ArrayHandle<Scalar> h_r_ghost(m_r_ghost, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_r_ghost_body(m_r_ghost_body, access_location::host, access_mode::read);
+        const unsigned int ntypes = m_pdata->getNTypes();
+        for (unsigned int cur_type = 0; cur_type < ntypes && check[0] == 0.0; ++cur_type)
+            {
+            if (m_migrate_ref_r_ghost.size() != 2*ntypes
+                || m_migrate_ref_r_ghost[2*cur_type] != h_r_ghost.data[cur_type]
+                || m_migrate_ref_r_ghost[2*cur_type+1] != h_r_ghost_body.data[cur_type])
+                check[0] = 1.0;
+            }
+        }
+
+    if (check[0] == 0.0)
+        {
+        // maximum displacement since the last exchange, positions may have been wrapped into the global box
+        const BoxDim& global_box = m_pdata->getGlobalBox();
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+
+        Scalar maxsq = Scalar(0.0);
+        for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+            {
+            Scalar4 postype = h_pos.data[i];
+            Scalar3 dx = make_scalar3(postype.x, postype.y, postype.z) - m_migrate_ref_pos[i];
+            dx = global_box.minImage(dx);
+            maxsq = std::max(maxsq, dot(dx, dx));
+            }
+        check[1] = maxsq;
+        }
+
+        {
+        MetricsTimer timer(m_exec_conf->getMetrics(), m_metric_collective_time);
+        MPI_Allreduce(MPI_IN_PLACE, check, 2, MPI_DOUBLE, MPI_MAX, m_mpi_comm);
+        }
+
+    if (m_prof)
+        m_prof->pop();
+
+    return check[0] != 0.0 || check[1] >= double(m_migrate_buffer)*double(m_migrate_buffer);
+    }
+
+/*! Called at the end of the ghost exchange: the positions of the local particles and the ghost layer widths are
+    the reference of the next checkMigration().
+*/
+void Communicator::setMigrationReference()
+    {
+    if (m_migrate_buffer <= Scalar(0.0))
+        return;
+
+    const unsigned int N = m_pdata->getN();
+    m_migrate_ref_pos.resize(N);
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < N; ++i)
+            m_migrate_ref_pos[i] = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+        }
+
+    const unsigned int ntypes = m_pdata->getNTypes();
+    m_migrate_ref_r_ghost.resize(2*ntypes);
+    ArrayHandle<Scalar> h_r_ghost(m_r_ghost, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_r_ghost_body(m_r_ghost_body, access_location::host, access_mode::read);
+    for (unsigned int cur_type = 0; cur_type < ntypes; ++cur_type)
+        {
+        m_migrate_ref_r_ghost[2*cur_type] = h_r_ghost.data[cur_type];
+        m_migrate_ref_r_ghost[2*cur_type+1] = h_r_ghost_body.data[cur_type];
+        }
+
+    m_migrate_ref_valid = true;
+    }
+
+bool Communicator::updateBodyGhostPlans()
+    {
+    if (m_body_ghost_plan_requests.empty())
+        return false;
+
+    m_body_ghost_plan.resize(m_pdata->getN());
+
+        {
+        ArrayHandle<unsigned int> h_body_ghost_plan(m_body_ghost_plan, access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+            h_body_ghost_plan.data[i] = NO_BODY_GHOST_PLAN;
+        }
+
+    m_body_ghost_plan_requests.emit(m_body_ghost_plan);
+    return true;
+    }
+
 //! Build ghost particle list, exchange ghost particle data
 void Communicator::exchangeGhosts()
     {
@@ -1602,11 +1805,14 @@ void Communicator::exchangeGhosts()
         ghost_fractions_body[cur_type] = h_r_ghost_body.data[cur_type] / box_dist;
         }
 
+    bool body_ghost_plans = updateBodyGhostPlans();
+
         {
         // scan all local atom positions if they are within r_ghost from a neighbor
         ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_plan(m_plan, access_location::host, access_mode::readwrite);
+        ArrayHandle<unsigned int> h_body_ghost_plan(m_body_ghost_plan, access_location::host, access_mode::read);
 
         for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
             {
@@ -1619,27 +1825,39 @@ void Communicator::exchangeGhosts()
 
             if (h_body.data[idx] != NO_BODY)
                 {
-                ghost_fraction += ghost_fractions_body[type];
+                unsigned int body_plan = body_ghost_plans ? h_body_ghost_plan.data[idx] : NO_BODY_GHOST_PLAN;
+                if (body_plan == NO_BODY_GHOST_PLAN)
+                    ghost_fraction += ghost_fractions_body[type];
+                else
+                    h_plan.data[idx] |= body_plan;
                 }
 
             Scalar3 f = box.makeFraction(pos);
+            unsigned int plan = 0;
             if (f.x >= Scalar(1.0) - ghost_fraction.x)
-                h_plan.data[idx] |= send_east;
+                plan |= send_east;
 
             if (f.x < ghost_fraction.x)
-                h_plan.data[idx] |= send_west;
+                plan |= send_west;
 
             if (f.y >= Scalar(1.0) - ghost_fraction.y)
-                h_plan.data[idx] |= send_north;
+                plan |= send_north;
 
             if (f.y < ghost_fraction.y)
-                h_plan.data[idx] |= send_south;
+                plan |= send_south;
 
             if (f.z >= Scalar(1.0) - ghost_fraction.z)
-                h_plan.data[idx] |= send_up;
+                plan |= send_up;
 
             if (f.z < ghost_fraction.z)
-                h_plan.data[idx] |= send_down;
+                plan |= send_down;
+
+            // in the half-shell exchange, the east neighbor evaluates the pairs across the east boundary, the pairs
+            // across the north and up boundaries are dropped by the neighbor list
+            if (m_half_shell)
+                plan &= ~send_east;
+
+            h_plan.data[idx] |= plan;
             }
         }
 
@@ -1674,6 +1892,16 @@ void Communicator::exchangeGhosts()
     // ghost particle flags
     CommFlags flags = getFlags();
 
+    // the cells used to sort the ghosts are as wide as the ghost layer
+    uint3 ghost_cell_dim = make_uint3(1,1,1);
+    const Scalar r_ghost_tot = getGhostLayerMaxWidth();
+    if (m_sort_ghosts && r_ghost_tot > Scalar(0.0))
+        {
+        ghost_cell_dim.x = std::max(1u, (unsigned int)(box_dist.x / r_ghost_tot));
+        ghost_cell_dim.y = std::max(1u, (unsigned int)(box_dist.y / r_ghost_tot));
+        ghost_cell_dim.z = std::max(1u, (unsigned int)(box_dist.z / r_ghost_tot));
+        }
+
     for (unsigned int dir = 0; dir < 6; dir ++)
         {
         if (! isCommunicating(dir) ) continue;
@@ -1732,24 +1960,33 @@ void Communicator::exchangeGhosts()
             ArrayHandle<Scalar4> h_velocity_copybuf(m_velocity_copybuf, access_location::host, access_mode::overwrite);
             ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::overwrite);
 
+            // find the particles to send in this direction
+            m_ghost_send_idx.clear();
             for (unsigned int idx = 0; idx < m_pdata->getN() + m_pdata->getNGhosts(); idx++)
                 {
-
                 if (h_plan.data[idx] & (1 << dir))
-                    {
-                    // send with next message
-                    if (flags[comm_flag::position]) h_pos_copybuf.data[m_num_copy_ghosts[dir]] = h_pos.data[idx];
-                    if (flags[comm_flag::charge]) h_charge_copybuf.data[m_num_copy_ghosts[dir]] = h_charge.data[idx];
-                    if (flags[comm_flag::diameter]) h_diameter_copybuf.data[m_num_copy_ghosts[dir]] = h_diameter.data[idx];
-                    if (flags[comm_flag::body]) h_body_copybuf.data[m_num_copy_ghosts[dir]] = h_body.data[idx];
-                    if (flags[comm_flag::image]) h_image_copybuf.data[m_num_copy_ghosts[dir]] = h_image.data[idx];
-                    if (flags[comm_flag::velocity]) h_velocity_copybuf.data[m_num_copy_ghosts[dir]] = h_vel.data[idx];
-                    if (flags[comm_flag::orientation]) h_orientation_copybuf.data[m_num_copy_ghosts[dir]] = h_orientation.data[idx];
-                    h_plan_copybuf.data[m_num_copy_ghosts[dir]] = h_plan.data[idx];
-
-                    h_copy_ghosts.data[m_num_copy_ghosts[dir]] = h_tag.data[idx];
-                    m_num_copy_ghosts[dir]++;
-                    }
+                    m_ghost_send_idx.push_back(idx);
+                }
+
+            if (m_sort_ghosts)
+                sortGhostsByCell(h_pos.data, box, ghost_cell_dim);
+
+            for (std::vector<unsigned int>::const_iterator it = m_ghost_send_idx.begin(); it != m_ghost_send_idx.end(); ++it)
+                {
+                const unsigned int idx = *it;
+
+                // send with next message
+                if (flags[comm_flag::position]) h_pos_copybuf.data[m_num_copy_ghosts[dir]] = h_pos.data[idx];
+                if (flags[comm_flag::charge]) h_charge_copybuf.data[m_num_copy_ghosts[dir]] = h_charge.data[idx];
+                if (flags[comm_flag::diameter]) h_diameter_copybuf.data[m_num_copy_ghosts[dir]] = h_diameter.data[idx];
+                if (flags[comm_flag::body]) h_body_copybuf.data[m_num_copy_ghosts[dir]] = h_body.data[idx];
+                if (flags[comm_flag::image]) h_image_copybuf.data[m_num_copy_ghosts[dir]] = h_image.data[idx];
+                if (flags[comm_flag::velocity]) h_velocity_copybuf.data[m_num_copy_ghosts[dir]] = h_vel.data[idx];
+                if (flags[comm_flag::orientation]) h_orientation_copybuf.data[m_num_copy_ghosts[dir]] = h_orientation.data[idx];
+                h_plan_copybuf.data[m_num_copy_ghosts[dir]] = h_plan.data[idx];
+
+                h_copy_ghosts.data[m_num_copy_ghosts[dir]] = h_tag.data[idx];
+                m_num_copy_ghosts[dir]++;
                 }
             }
         unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
@@ -1786,7 +2023,7 @@ void Communicator::exchangeGhosts()
         m_reqs.push_back(req);
 
         m_stats.resize(2);
-        MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
+        waitAll(m_reqs.size(), &m_reqs.front(), &m_stats.front());
 
         if (m_prof)
             m_prof->pop();
@@ -2007,7 +2244,7 @@ void Communicator::exchangeGhosts()
                 }
 
             m_stats.resize(m_reqs.size());
-            MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
+            waitAll(m_reqs.size(), &m_reqs.front(), &m_stats.front());
             }
 
         if (m_prof)
@@ -2053,6 +2290,12 @@ void Communicator::exchangeGhosts()
 
     m_last_flags = flags;
 
+    // the ghost lists are valid until the particles have moved by the migration buffer
+    setMigrationReference();
+
+    if (m_half_shell)
+        updateGhostHalfShellFlags();
+
     /***********************************************************************************************************************************************************
      * For multi-body force fields we must allow particles to send information back through their ghosts.
      * For this purpose, we implement a system for ghosts to be sent back to their original domain with forces on them that can then be added back to the original local particle.
@@ -2214,7 +2457,7 @@ void Communicator::exchangeGhosts()
             m_reqs.push_back(req);
 
             m_stats.resize(m_reqs.size());
-            MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
+            waitAll(m_reqs.size(), &m_reqs.front(), &m_stats.front());
 
             if (m_prof)
                 m_prof->pop();
@@ -2281,7 +2524,7 @@ void Communicator::exchangeGhosts()
                 m_reqs.push_back(req);
 
                 m_stats.resize(m_reqs.size());
-                MPI_Waitall(m_reqs.size(), &m_reqs.front(), &m_stats.front());
+                waitAll(m_reqs.size(), &m_reqs.front(), &m_stats.front());
             }
 
             if (m_prof)
@@ -2290,10 +2533,43 @@ void Communicator::exchangeGhosts()
         } // end dir loop
     }
 
+    // the number of ghosts to send may have changed
+    if (m_node_comm != MPI_COMM_NULL)
+        updateNodeSharedWindow();
+
     if (m_prof)
         m_prof->pop();
     }
 
+//! Encode a ghost position as 32 bit fixed-point fractional coordinates in the global box
+/*! The fractional coordinates are wrapped into [0,1). The receiver restores the periodic image when it wraps the
+    decoded ghosts into its shifted box.
+ */
+static inline uint3 encodeGhostPosition(const BoxDim& global_box, const Scalar4& postype)
+    {
+    Scalar3 f = global_box.makeFraction(make_scalar3(postype.x, postype.y, postype.z));
+
+    const double scale = 4294967296.0;
+    double fx = double(f.x) - floor(double(f.x));
+    double fy = double(f.y) - floor(double(f.y));
+    double fz = double(f.z) - floor(double(f.z));
+
+    return make_uint3((unsigned int) std::min(fx*scale, scale - 1.0),
+                      (unsigned int) std::min(fy*scale, scale - 1.0),
+                      (unsigned int) std::min(fz*scale, scale - 1.0));
+    }
+
+//! Decode a ghost position encoded with encodeGhostPosition()
+static inline Scalar3 decodeGhostPosition(const BoxDim& global_box, const uint3& u)
+    {
+    // the center of the fixed-point interval, to halve the maximum error
+    const double inv_scale = 1.0/4294967296.0;
+    Scalar3 f = make_scalar3(Scalar((double(u.x) + 0.5)*inv_scale),
+                             Scalar((double(u.y) + 0.5)*inv_scale),
+                             Scalar((double(u.z) + 0.5)*inv_scale));
+    return global_box.makeCoordinates(f);
+    }
+
 //! update positions of ghost particles
 void Communicator::beginUpdateGhosts(unsigned int timestep)
     {
@@ -2308,13 +2584,84 @@ void Communicator::beginUpdateGhosts(unsigned int timestep)
 
     unsigned int num_tot_recv_ghosts = 0; // total number of ghosts received
 
+    // the receives of the last direction are completed in finishUpdateGhosts(), so that
+    // computation on local particles can overlap with them
+    int last_dir = -1;
+    for (unsigned int dir = 0; dir < 6; dir ++)
+        if (isCommunicating(dir))
+            last_dir = dir;
+
+    if (m_ghost_pos_fixed_point && getFlags()[comm_flag::position])
+        {
+        // buffers for the compressed positions
+        unsigned int max_copy = 0;
+        unsigned int max_recv = 0;
+        for (unsigned int dir = 0; dir < 6; dir ++)
+            {
+            if (! isCommunicating(dir) ) continue;
+            max_copy = std::max(max_copy, m_num_copy_ghosts[dir]);
+            max_recv = std::max(max_recv, m_num_recv_ghosts[dir]);
+            }
+        m_pos_fixed_copybuf.resize(max_copy);
+        m_pos_fixed_recvbuf.resize(max_recv);
+        }
+
+    // the message sizes and buffers only change with the ghost set, reuse the persistent requests until then
+    if (m_persistent_mpi && getPersistentGhostKey() != m_persistent_ghost_key)
+        initPersistentGhostRequests();
+
+    // exchange positions with ranks on the same node through the shared memory window
+    const bool shared_pos = useNodeSharedPositions();
+
+    unsigned int stage = 0;
     for (unsigned int dir = 0; dir < 6; dir ++)
         {
         if (! isCommunicating(dir) ) continue;
 
         CommFlags flags = getFlags();
 
-        if (flags[comm_flag::position])
+        // the shared memory buffers alternate between stages, so that a neighbor may still read the previous one
+        Scalar4 *pos_win_buf = shared_pos ? m_pos_win_buf + (stage % 2)*m_pos_win_capacity : NULL;
+        stage++;
+
+        if (shared_pos)
+            {
+            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+            assert(m_num_copy_ghosts[dir] <= m_pos_win_capacity);
+
+            // copy positions of ghost particles into the shared memory window
+            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
+                {
+                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+
+                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+
+                pos_win_buf[ghost_idx] = h_pos.data[idx];
+                }
+            }
+        else if (flags[comm_flag::position] && m_ghost_pos_fixed_point)
+            {
+            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<uint3> h_pos_fixed_copybuf(m_pos_fixed_copybuf, access_location::host, access_mode::overwrite);
+            ArrayHandle<unsigned int> h_copy_ghosts(m_copy_ghosts[dir], access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+            const BoxDim& global_box = m_pdata->getGlobalBox();
+
+            // encode positions of ghost particles
+            for (unsigned int ghost_idx = 0; ghost_idx < m_num_copy_ghosts[dir]; ghost_idx++)
+                {
+                unsigned int idx = h_rtag.data[h_copy_ghosts.data[ghost_idx]];
+
+                assert(idx < m_pdata->getN() + m_pdata->getNGhosts());
+
+                h_pos_fixed_copybuf.data[ghost_idx] = encodeGhostPosition(global_box, h_pos.data[idx]);
+                }
+            }
+        else if (flags[comm_flag::position])
             {
             ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::overwrite);
@@ -2391,75 +2738,127 @@ void Communicator::beginUpdateGhosts(unsigned int timestep)
 
         num_tot_recv_ghosts += m_num_recv_ghosts[dir];
 
+        // number of bytes per particle
         size_t sz = 0;
+        if (flags[comm_flag::position])
+            sz += m_ghost_pos_fixed_point ? sizeof(uint3) : sizeof(Scalar4);
+        if (flags[comm_flag::velocity])
+            sz += sizeof(Scalar4);
+        if (flags[comm_flag::orientation])
+            sz += sizeof(Scalar4);
+
+        unsigned int n_req = 0;
+        MPI_Request *reqs = NULL;
+        m_reqs.resize(6);
+        m_stats.resize(6);
+
+        if (m_persistent_mpi)
+            {
+            // one send and one receive per field
+            n_req = m_persistent_ghost_reqs[dir].size();
+            if (n_req)
+                {
+                reqs = &m_persistent_ghost_reqs[dir].front();
+                MPI_Startall(n_req, reqs);
+                }
+            }
+        else
+            {
+            reqs = &m_reqs.front();
+            }
+
         // only non-permanent fields (position, velocity, orientation) need to be considered here
         // charge, body, image and diameter are not updated between neighbor list builds
-        if (flags[comm_flag::position])
+        if (! m_persistent_mpi && flags[comm_flag::position] && m_ghost_pos_fixed_point)
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
+            ArrayHandle<uint3> h_pos_fixed_recvbuf(m_pos_fixed_recvbuf, access_location::host, access_mode::overwrite);
+            ArrayHandle<uint3> h_pos_fixed_copybuf(m_pos_fixed_copybuf, access_location::host, access_mode::read);
 
+            // exchange compressed positions, they are decoded into the particle data arrays after the receive
+            MPI_Isend(h_pos_fixed_copybuf.data, m_num_copy_ghosts[dir]*sizeof(uint3), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &m_reqs[n_req++]);
+            MPI_Irecv(h_pos_fixed_recvbuf.data, m_num_recv_ghosts[dir]*sizeof(uint3), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &m_reqs[n_req++]);
+            }
+        else if (! m_persistent_mpi && shared_pos)
+            {
+            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+
+            // only neighbors on other nodes need messages
+            if (m_node_send_rank[dir] == MPI_UNDEFINED)
+                MPI_Isend(pos_win_buf, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &m_reqs[n_req++]);
+            if (m_node_recv_rank[dir] == MPI_UNDEFINED)
+                MPI_Irecv(h_pos.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &m_reqs[n_req++]);
+            }
+        else if (! m_persistent_mpi && flags[comm_flag::position])
+            {
             ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
             ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
 
             // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_pos_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_pos.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
-
-            sz += sizeof(Scalar4);
+            MPI_Isend(h_pos_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &m_reqs[n_req++]);
+            MPI_Irecv(h_pos.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &m_reqs[n_req++]);
             }
 
-        if (flags[comm_flag::velocity])
+        if (! m_persistent_mpi && flags[comm_flag::velocity])
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
-
             ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
             ArrayHandle<Scalar4> h_vel_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
 
             // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_vel_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_vel.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
-
-            sz += sizeof(Scalar4);
+            MPI_Isend(h_vel_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &m_reqs[n_req++]);
+            MPI_Irecv(h_vel.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &m_reqs[n_req++]);
             }
 
-        if (flags[comm_flag::orientation])
+        if (! m_persistent_mpi && flags[comm_flag::orientation])
             {
-            m_reqs.resize(2);
-            m_stats.resize(2);
-
             ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
             ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
 
             // exchange particle data, write directly to the particle data arrays
-            MPI_Isend(h_orientation_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &m_reqs[0]);
-            MPI_Irecv(h_orientation.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+            MPI_Isend(h_orientation_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &m_reqs[n_req++]);
+            MPI_Irecv(h_orientation.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &m_reqs[n_req++]);
+            }
 
-            sz += sizeof(Scalar4);
+        if (shared_pos)
+            {
+            // wait until all ranks on the node have filled their buffers
+            MPI_Win_sync(m_pos_win);
+            MPI_Barrier(m_node_comm);
+            MPI_Win_sync(m_pos_win);
+
+            if (m_node_recv_rank[dir] != MPI_UNDEFINED)
+                {
+                ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+                const Scalar4 *neigh_buf = m_node_recv_buf[dir] + ((stage-1) % 2)*m_pos_win_capacity;
+                std::copy(neigh_buf, neigh_buf + m_num_recv_ghosts[dir], h_pos.data + start_idx);
+                }
+            }
+
+        if ((int) dir == last_dir)
+            {
+            // leave the requests in flight, they are completed in finishUpdateGhosts()
+            m_n_pending_reqs = n_req;
+            m_pending_reqs = reqs;
+            m_pending_ghost_start = start_idx;
+            m_pending_ghost_num = m_num_recv_ghosts[dir];
+            m_comm_pending = true;
+
+            if (m_prof)
+                m_prof->pop(0, (m_num_recv_ghosts[dir]+m_num_copy_ghosts[dir])*sz);
+            break;
             }
 
+        if (n_req)
+            waitAll(n_req, reqs, &m_stats.front());
+
         if (m_prof)
             m_prof->pop(0, (m_num_recv_ghosts[dir]+m_num_copy_ghosts[dir])*sz);
 
-
         // wrap particle positions (only if copying positions)
         if (flags[comm_flag::position])
             {
-            ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
-
-            const BoxDim shifted_box = getShiftedBox();
-            for (unsigned int idx = start_idx; idx < start_idx + m_num_recv_ghosts[dir]; idx++)
-                {
-                Scalar4& pos = h_pos.data[idx];
-
-                // wrap particles received across a global boundary
-                int3 img = make_int3(0,0,0);
-                shifted_box.wrap(pos, img);
-                }
+            if (m_ghost_pos_fixed_point)
+                decodeGhostPositions(start_idx, m_num_recv_ghosts[dir]);
+            wrapGhostPositions(start_idx, m_num_recv_ghosts[dir]);
             }
 
         } // end dir loop
@@ -2468,8 +2867,321 @@ void Communicator::beginUpdateGhosts(unsigned int timestep)
             m_prof->pop();
     }
 
+//! Complete the ghost update started in beginUpdateGhosts()
+void Communicator::finishUpdateGhosts(unsigned int timestep)
+    {
+    if (! m_comm_pending)
+        return;
+
+    if (m_prof)
+        m_prof->push("comm_ghost_update");
+
+    if (m_n_pending_reqs)
+        waitAll(m_n_pending_reqs, m_pending_reqs, &m_stats.front());
+
+    if (getFlags()[comm_flag::position])
+        {
+        if (m_ghost_pos_fixed_point)
+            decodeGhostPositions(m_pending_ghost_start, m_pending_ghost_num);
+        wrapGhostPositions(m_pending_ghost_start, m_pending_ghost_num);
+        }
+
+    m_comm_pending = false;
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param start_idx Index of the first received ghost particle
+    \param n Number of received ghost particles
+ */
+void Communicator::wrapGhostPositions(unsigned int start_idx, unsigned int n)
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+
+    const BoxDim shifted_box = getShiftedBox();
+    for (unsigned int idx = start_idx; idx < start_idx + n; idx++)
+        {
+        Scalar4& pos = h_pos.data[idx];
+
+        // wrap particles received across a global boundary
+        int3 img = make_int3(0,0,0);
+        shifted_box.wrap(pos, img);
+        }
+    }
+
+/*! \param start_idx Index of the first received ghost particle
+    \param n Number of received ghost particles
+
+    The particle types (the w component) of the ghosts are not sent and are left unchanged.
+ */
+void Communicator::decodeGhostPositions(unsigned int start_idx, unsigned int n)
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<uint3> h_pos_fixed_recvbuf(m_pos_fixed_recvbuf, access_location::host, access_mode::read);
+
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    for (unsigned int i = 0; i < n; i++)
+        {
+        Scalar3 pos = decodeGhostPosition(global_box, h_pos_fixed_recvbuf.data[i]);
+        Scalar4& postype = h_pos.data[start_idx + i];
+        postype.x = pos.x;
+        postype.y = pos.y;
+        postype.z = pos.z;
+        }
+    }
+
+/*! \returns The quantities that determine the persistent ghost update requests
+
+    The key consists of the ghost communication flags, the addresses of the send and receive buffers and the number
+    of particles sent and received per direction.
+ */
+std::vector<std::size_t> Communicator::getPersistentGhostKey()
+    {
+    std::vector<std::size_t> key;
+    key.push_back(getFlags().to_ulong());
+    key.push_back(m_ghost_pos_fixed_point);
+    key.push_back(useNodeSharedPositions());
+    key.push_back((std::size_t) m_pos_win_buf);
+    key.push_back(m_pos_win_capacity);
+    key.push_back(m_pdata->getN());
+
+        {
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<uint3> h_pos_fixed_copybuf(m_pos_fixed_copybuf, access_location::host, access_mode::read);
+        ArrayHandle<uint3> h_pos_fixed_recvbuf(m_pos_fixed_recvbuf, access_location::host, access_mode::read);
+
+        key.push_back((std::size_t) h_pos_fixed_copybuf.data);
+        key.push_back((std::size_t) h_pos_fixed_recvbuf.data);
+        key.push_back((std::size_t) h_pos.data);
+        key.push_back((std::size_t) h_vel.data);
+        key.push_back((std::size_t) h_orientation.data);
+        key.push_back((std::size_t) h_pos_copybuf.data);
+        key.push_back((std::size_t) h_vel_copybuf.data);
+        key.push_back((std::size_t) h_orientation_copybuf.data);
+        }
+
+    for (unsigned int dir = 0; dir < 6; dir++)
+        {
+        key.push_back(isCommunicating(dir) ? m_num_copy_ghosts[dir] : 0);
+        key.push_back(isCommunicating(dir) ? m_num_recv_ghosts[dir] : 0);
+        }
+
+    return key;
+    }
+
+//! Create the persistent requests for the ghost update, using the current ghost exchange plan
+void Communicator::initPersistentGhostRequests()
+    {
+    m_exec_conf->msg->notice(7) << "Communicator: create persistent ghost update requests" << std::endl;
+
+    freePersistentGhostRequests();
+
+    CommFlags flags = getFlags();
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_pos_copybuf(m_pos_copybuf, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel_copybuf(m_velocity_copybuf, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation_copybuf(m_orientation_copybuf, access_location::host, access_mode::read);
+    ArrayHandle<uint3> h_pos_fixed_copybuf(m_pos_fixed_copybuf, access_location::host, access_mode::read);
+    ArrayHandle<uint3> h_pos_fixed_recvbuf(m_pos_fixed_recvbuf, access_location::host, access_mode::readwrite);
+
+    const bool shared_pos = useNodeSharedPositions();
+
+    unsigned int num_tot_recv_ghosts = 0;
+    unsigned int stage = 0;
+    for (unsigned int dir = 0; dir < 6; dir++)
+        {
+        if (! isCommunicating(dir) ) continue;
+
+        Scalar4 *pos_win_buf = shared_pos ? m_pos_win_buf + (stage % 2)*m_pos_win_capacity : NULL;
+        stage++;
+
+        unsigned int send_neighbor = m_decomposition->getNeighborRank(dir);
+
+        // we receive from the direction opposite to the one we send to
+        unsigned int recv_neighbor;
+        if (dir % 2 == 0)
+            recv_neighbor = m_decomposition->getNeighborRank(dir+1);
+        else
+            recv_neighbor = m_decomposition->getNeighborRank(dir-1);
+
+        unsigned int start_idx = m_pdata->getN() + num_tot_recv_ghosts;
+        num_tot_recv_ghosts += m_num_recv_ghosts[dir];
+
+        // same tags and buffers as the non-persistent ghost update
+        std::vector<MPI_Request>& reqs = m_persistent_ghost_reqs[dir];
+        reqs.resize(6, MPI_REQUEST_NULL);
+        unsigned int n_req = 0;
+
+        if (shared_pos)
+            {
+            if (m_node_send_rank[dir] == MPI_UNDEFINED)
+                MPI_Send_init(pos_win_buf, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &reqs[n_req++]);
+            if (m_node_recv_rank[dir] == MPI_UNDEFINED)
+                MPI_Recv_init(h_pos.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &reqs[n_req++]);
+            }
+        else if (flags[comm_flag::position] && m_ghost_pos_fixed_point)
+            {
+            MPI_Send_init(h_pos_fixed_copybuf.data, m_num_copy_ghosts[dir]*sizeof(uint3), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &reqs[n_req++]);
+            MPI_Recv_init(h_pos_fixed_recvbuf.data, m_num_recv_ghosts[dir]*sizeof(uint3), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &reqs[n_req++]);
+            }
+        else if (flags[comm_flag::position])
+            {
+            MPI_Send_init(h_pos_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &reqs[n_req++]);
+            MPI_Recv_init(h_pos.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &reqs[n_req++]);
+            }
+
+        if (flags[comm_flag::velocity])
+            {
+            MPI_Send_init(h_vel_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &reqs[n_req++]);
+            MPI_Recv_init(h_vel.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &reqs[n_req++]);
+            }
+
+        if (flags[comm_flag::orientation])
+            {
+            MPI_Send_init(h_orientation_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &reqs[n_req++]);
+            MPI_Recv_init(h_orientation.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &reqs[n_req++]);
+            }
+
+        reqs.resize(n_req);
+        }
+
+    m_persistent_ghost_key = getPersistentGhostKey();
+    }
+
+//! Release the persistent requests of the ghost update
+void Communicator::freePersistentGhostRequests()
+    {
+    for (unsigned int dir = 0; dir < 6; dir++)
+        {
+        for (unsigned int i = 0; i < m_persistent_ghost_reqs[dir].size(); i++)
+            {
+            if (m_persistent_ghost_reqs[dir][i] != MPI_REQUEST_NULL)
+                MPI_Request_free(&m_persistent_ghost_reqs[dir][i]);
+            }
+        m_persistent_ghost_reqs[dir].clear();
+        }
+
+    m_persistent_ghost_key.clear();
+    }
+
+/*! \param enable True if ghost positions are exchanged through shared memory with ranks on the same node
+
+    This method is collective over all ranks.
+ */
+void Communicator::setNodeSharedMemory(bool enable)
+    {
+    freeNodeSharedMemory();
+
+    if (! enable)
+        return;
+
+    // the ranks that can share memory with this one
+    MPI_Comm_split_type(m_mpi_comm, MPI_COMM_TYPE_SHARED, m_exec_conf->getRank(), MPI_INFO_NULL, &m_node_comm);
+
+    MPI_Group group, node_group;
+    MPI_Comm_group(m_mpi_comm, &group);
+    MPI_Comm_group(m_node_comm, &node_group);
+
+    unsigned int n_node_neighbors = 0;
+    for (unsigned int dir = 0; dir < 6; dir ++)
+        {
+        int send_neighbor = m_decomposition->getNeighborRank(dir);
+        int recv_neighbor = m_decomposition->getNeighborRank(dir % 2 == 0 ? dir+1 : dir-1);
+
+        // MPI_UNDEFINED if the neighbor is on a different node
+        MPI_Group_translate_ranks(group, 1, &send_neighbor, node_group, &m_node_send_rank[dir]);
+        MPI_Group_translate_ranks(group, 1, &recv_neighbor, node_group, &m_node_recv_rank[dir]);
+
+        if (isCommunicating(dir) && m_node_send_rank[dir] != MPI_UNDEFINED)
+            n_node_neighbors++;
+        }
+
+    MPI_Group_free(&group);
+    MPI_Group_free(&node_group);
+
+    m_exec_conf->msg->notice(4) << "Communicator: " << n_node_neighbors
+        << " ghost update directions use node shared memory" << std::endl;
+
+    updateNodeSharedWindow();
+    }
+
+//! Make sure the shared memory window can hold the ghosts sent in every direction
+/*! This method is collective over the ranks on the node. All ranks use the same capacity.
+ */
+void Communicator::updateNodeSharedWindow()
+    {
+    unsigned int max_copy = 0;
+    for (unsigned int dir = 0; dir < 6; dir ++)
+        if (isCommunicating(dir))
+            max_copy = std::max(max_copy, m_num_copy_ghosts[dir]);
+
+    MPI_Allreduce(MPI_IN_PLACE, &max_copy, 1, MPI_UNSIGNED, MPI_MAX, m_node_comm);
+
+    if (m_pos_win != MPI_WIN_NULL && max_copy <= m_pos_win_capacity)
+        return;
+
+    if (m_pos_win != MPI_WIN_NULL)
+        {
+        MPI_Win_unlock_all(m_pos_win);
+        MPI_Win_free(&m_pos_win);
+        }
+
+    // leave some room to avoid frequent reallocations
+    m_pos_win_capacity = max_copy + max_copy/4 + 1;
+
+    // two buffers that alternate between the directions
+    MPI_Aint size = 2*m_pos_win_capacity*sizeof(Scalar4);
+    MPI_Win_allocate_shared(size, sizeof(Scalar4), MPI_INFO_NULL, m_node_comm, &m_pos_win_buf, &m_pos_win);
+    MPI_Win_lock_all(MPI_MODE_NOCHECK, m_pos_win);
+
+    // the buffers of our neighbors on the node
+    for (unsigned int dir = 0; dir < 6; dir ++)
+        {
+        m_node_recv_buf[dir] = NULL;
+        if (m_node_recv_rank[dir] != MPI_UNDEFINED)
+            {
+            MPI_Aint neigh_size;
+            int disp_unit;
+            MPI_Win_shared_query(m_pos_win, m_node_recv_rank[dir], &neigh_size, &disp_unit, &m_node_recv_buf[dir]);
+            }
+        }
+    }
+
+//! Release the node shared memory window and communicator
+void Communicator::freeNodeSharedMemory()
+    {
+    if (m_pos_win != MPI_WIN_NULL)
+        {
+        MPI_Win_unlock_all(m_pos_win);
+        MPI_Win_free(&m_pos_win);
+        }
+    m_pos_win_buf = NULL;
+    m_pos_win_capacity = 0;
+
+    if (m_node_comm != MPI_COMM_NULL)
+        MPI_Comm_free(&m_node_comm);
+
+    for (unsigned int dir = 0; dir < 6; dir ++)
+        {
+        m_node_send_rank[dir] = MPI_UNDEFINED;
+        m_node_recv_rank[dir] = MPI_UNDEFINED;
+        m_node_recv_buf[dir] = NULL;
+        }
+    }
+
 void Communicator::updateNetForce(unsigned int timestep)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "Communicator");
+
     CommFlags flags = getFlags();
     if (! flags[comm_flag::net_force] && ! flags[comm_flag::reverse_net_force] && ! flags[comm_flag::net_torque] && ! flags[comm_flag::net_virial])
         return;
@@ -2677,7 +3389,7 @@ void Communicator::updateNetForce(unsigned int timestep)
             // exchange particle data, write directly to the particle data arrays
             MPI_Isend(h_netforce_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 1, m_mpi_comm, &m_reqs[0]);
             MPI_Irecv(h_netforce.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 1, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+            waitAll(2, &m_reqs.front(), &m_stats.front());
 
             sz += sizeof(Scalar4);
             }
@@ -2700,7 +3412,7 @@ void Communicator::updateNetForce(unsigned int timestep)
 
                 MPI_Isend(h_netforce_reverse_copybuf.data, (m_num_copy_local_ghosts_reverse[dir] + m_num_forward_ghosts_reverse[dir])*sizeof(Scalar4), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &m_reqs[0]);
                 MPI_Irecv(h_netforce_reverse_recvbuf.data + start_idx_reverse, (m_num_recv_local_ghosts_reverse[dir] + m_num_recv_forward_ghosts_reverse[dir])*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &m_reqs[1]);
-                MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+                waitAll(2, &m_reqs.front(), &m_stats.front());
 
                 sz += sizeof(Scalar4);
                 }
@@ -2740,7 +3452,7 @@ void Communicator::updateNetForce(unsigned int timestep)
 
             MPI_Isend(h_nettorque_copybuf.data, m_num_copy_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, send_neighbor, 2, m_mpi_comm, &m_reqs[0]);
             MPI_Irecv(h_nettorque.data + start_idx, m_num_recv_ghosts[dir]*sizeof(Scalar4), MPI_BYTE, recv_neighbor, 2, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+            waitAll(2, &m_reqs.front(), &m_stats.front());
 
             sz += sizeof(Scalar4);
             }
@@ -2756,7 +3468,7 @@ void Communicator::updateNetForce(unsigned int timestep)
 
             MPI_Isend(h_netvirial_copybuf.data, 6*m_num_copy_ghosts[dir]*sizeof(Scalar), MPI_BYTE, send_neighbor, 3, m_mpi_comm, &m_reqs[0]);
             MPI_Irecv(h_netvirial_recvbuf.data, 6*m_num_recv_ghosts[dir]*sizeof(Scalar), MPI_BYTE, recv_neighbor, 3, m_mpi_comm, &m_reqs[1]);
-            MPI_Waitall(2, &m_reqs.front(), &m_stats.front());
+            waitAll(2, &m_reqs.front(), &m_stats.front());
 
             sz += 6*sizeof(Scalar);
             }
@@ -2789,6 +3501,88 @@ void Communicator::updateNetForce(unsigned int timestep)
     }
 
 
+/*! The domain offset of a ghost is found from its minimum image relative to the center of the local box. A ghost is
+    flagged if the first non-zero offset in the decomposed directions, in the order x, y, z, is positive. Of the two
+    ranks that hold a pair of particles, exactly one sees the other particle in its forward half-shell.
+*/
+void Communicator::updateGhostHalfShellFlags()
+    {
+    const unsigned int n_local = m_pdata->getN();
+    const unsigned int n_ghosts = m_pdata->getNGhosts();
+    m_ghost_half_shell.resize(n_ghosts);
+
+    const BoxDim& box = m_pdata->getBox();
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    const Scalar3 center = box.makeCoordinates(make_scalar3(0.5, 0.5, 0.5));
+
+    const Index3D& di = m_decomposition->getDomainIndexer();
+    const bool decomposed[3] = {di.getW() > 1, di.getH() > 1, di.getD() > 1};
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_ghost_half_shell(m_ghost_half_shell, access_location::host, access_mode::overwrite);
+
+    for (unsigned int idx = 0; idx < n_ghosts; ++idx)
+        {
+        const Scalar4 postype = h_pos.data[n_local + idx];
+        Scalar3 d = global_box.minImage(make_scalar3(postype.x, postype.y, postype.z) - center);
+        Scalar3 f = box.makeFraction(center + d);
+        const Scalar frac[3] = {f.x, f.y, f.z};
+
+        unsigned int flag = 0;
+        for (unsigned int k = 0; k < 3; ++k)
+            {
+            if (! decomposed[k])
+                continue;
+
+            if (frac[k] >= Scalar(1.0))
+                {
+                flag = 1;
+                break;
+                }
+            if (frac[k] < Scalar(0.0))
+                break;
+            }
+        h_ghost_half_shell.data[idx] = flag;
+        }
+    }
+
+/*! \param h_pos Positions of the local and ghost particles
+    \param box The local box
+    \param cell_dim Number of cells along each direction of the local box
+
+    The indices in m_ghost_send_idx are reordered by the index of their cell, in the same (x fastest) order as
+    the cells of the CellList. Ghosts forwarded from neighboring domains lie outside the local box and are assigned
+    to the nearest cell. Particles within a cell keep their order.
+ */
+void Communicator::sortGhostsByCell(const Scalar4 *h_pos, const BoxDim& box, const uint3& cell_dim)
+    {
+    const unsigned int n = m_ghost_send_idx.size();
+    m_ghost_cells.resize(n);
+
+    Index3D ci(cell_dim.x, cell_dim.y, cell_dim.z);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        const unsigned int idx = m_ghost_send_idx[i];
+        Scalar3 f = box.makeFraction(make_scalar3(h_pos[idx].x, h_pos[idx].y, h_pos[idx].z));
+
+        int ib = (int)(f.x * cell_dim.x);
+        int jb = (int)(f.y * cell_dim.y);
+        int kb = (int)(f.z * cell_dim.z);
+
+        // move ghosts outside the local box into the nearest cell
+        ib = std::min(std::max(ib, 0), (int)cell_dim.x - 1);
+        jb = std::min(std::max(jb, 0), (int)cell_dim.y - 1);
+        kb = std::min(std::max(kb, 0), (int)cell_dim.z - 1);
+
+        m_ghost_cells[i] = std::make_pair(ci(ib, jb, kb), idx);
+        }
+
+    std::sort(m_ghost_cells.begin(), m_ghost_cells.end());
+
+    for (unsigned int i = 0; i < n; ++i)
+        m_ghost_send_idx[i] = m_ghost_cells[i].second;
+    }
+
 void Communicator::removeGhostParticleTags()
     {
     // wipe out reverse-lookup tag -> idx for old ghost atoms
@@ -2887,10 +3681,100 @@ const BoxDim Communicator::getShiftedBox() const
     return shifted_box;
     }
 
+/*! \param num_iters Number of iterations to average for the benchmark
+    \param timestep Current time step
+    \returns Milliseconds of execution time per migration and ghost exchange
+
+    Calls migrateParticles() and exchangeGhosts() repeatedly, as after every neighbor list build.
+*/
+double Communicator::benchmarkExchange(unsigned int num_iters, unsigned int timestep)
+    {
+    ClockSource t;
+
+    // set the ghost communication flags and construct the ghost lists
+    forceMigrate();
+    communicate(timestep);
+
+    m_is_communicating = true;
+
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        cudaDeviceSynchronize();
+    #endif
+    MPI_Barrier(m_mpi_comm);
+
+    uint64_t start_time = t.getTime();
+    for (unsigned int i = 0; i < num_iters; i++)
+        {
+        migrateParticles();
+        exchangeGhosts();
+        }
+
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        cudaDeviceSynchronize();
+    #endif
+    uint64_t total_time_ns = t.getTime() - start_time;
+
+    m_is_communicating = false;
+
+    // convert the run time to milliseconds
+    return double(total_time_ns) / 1e6 / double(num_iters);
+    }
+
+/*! \param num_iters Number of iterations to average for the benchmark
+    \param timestep Current time step
+    \returns Milliseconds of execution time per ghost update
+
+    Calls beginUpdateGhosts() and finishUpdateGhosts() repeatedly, as in every step without a neighbor list build.
+*/
+double Communicator::benchmarkGhostUpdate(unsigned int num_iters, unsigned int timestep)
+    {
+    ClockSource t;
+
+    // set the ghost communication flags and construct the ghost lists
+    forceMigrate();
+    communicate(timestep);
+
+    m_is_communicating = true;
+
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        cudaDeviceSynchronize();
+    #endif
+    MPI_Barrier(m_mpi_comm);
+
+    uint64_t start_time = t.getTime();
+    for (unsigned int i = 0; i < num_iters; i++)
+        {
+        beginUpdateGhosts(timestep);
+        finishUpdateGhosts(timestep);
+        }
+
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        cudaDeviceSynchronize();
+    #endif
+    uint64_t total_time_ns = t.getTime() - start_time;
+
+    m_is_communicating = false;
+
+    // convert the run time to milliseconds
+    return double(total_time_ns) / 1e6 / double(num_iters);
+    }
+
 //! Export Communicator class to python
 void export_Communicator(py::module& m)
     {
     py::class_<Communicator, std::shared_ptr<Communicator> >(m,"Communicator")
-    .def(py::init<std::shared_ptr<SystemDefinition>, std::shared_ptr<DomainDecomposition> >());
+    .def(py::init<std::shared_ptr<SystemDefinition>, std::shared_ptr<DomainDecomposition> >())
+    .def("setPersistentMPI", &Communicator::setPersistentMPI)
+    .def("setGhostPositionCompression", &Communicator::setGhostPositionCompression)
+    .def("setNodeSharedMemory", &Communicator::setNodeSharedMemory)
+    .def("setHalfShell", &Communicator::setHalfShell)
+    .def("setGhostSorting", &Communicator::setGhostSorting)
+    .def("setMigrationBuffer", &Communicator::setMigrationBuffer)
+    .def("benchmarkExchange", &Communicator::benchmarkExchange)
+    .def("benchmarkGhostUpdate", &Communicator::benchmarkGhostUpdate);
     }
 #endif // ENABLE_MPI
@@ -23,6 +23,7 @@
 #include "ParticleData.h"
 #include "BondedGroupData.h"
 #include "DomainDecomposition.h"
+#include "ClockSource.h"
 
 #include <memory>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
@@ -58,6 +59,9 @@ class ParticleData;
 // in 3d, there are 27 neighbors max.
 #define NEIGH_MAX 27
 
+//! Sentinel value in the body ghost plans to signify that the ghost plan of a particle is not set by its body
+const unsigned int NO_BODY_GHOST_PLAN = 0xffffffff;
+
 //! Optional flags to enable communication of certain ParticleData fields for ghost particles
 struct comm_flag
     {
@@ -118,7 +122,8 @@ struct rank_element
  * -# <b> Third stage</b>: Update of ghost positions (updateGhosts())
  * <br> If it is not necessary to renew the list of ghost particles (i.e. when no particle in the global system has moved more than a
  * distance \f$ r_{\mathrm{buff}}/2 \f$), we use the current ghost particle list to update the ghost positions on the neighboring
- * processors.
+ * processors. While the ghost update is in flight, the interior compute callbacks (getInteriorComputeCallbackSignal())
+ * may compute on local particles that do not depend on ghosts.
  *
  * Stages \b one and \b two are performed before every neighbor list build, stage \b three is executed in all other steps (before the calculation
  * of forces).
@@ -202,6 +207,19 @@ class PYBIND11_EXPORT Communicator
             }
 
 
+        //! Subscribe to list of functions that determine the ghost plans of rigid body particles
+        /*! The subscribers are called with an array of one ghost plan per local particle, initialized to
+         * NO_BODY_GHOST_PLAN, before the ghost particles are marked. A subscriber may set the directions in which a
+         * particle must be sent so that its rigid body is complete on every rank that holds one of its members. For
+         * these particles, the extra ghost layer width of rigid bodies (getExtraGhostLayerWidthRequestSignal()) is
+         * not applied, and only the regular ghost layer width is added to the plan.
+         * \return A Nano::Signal object reference to be used for connect and disconnect calls.
+         */
+        Nano::Signal<void (GlobalVector<unsigned int>&)>& getBodyGhostPlanRequestSignal()
+            {
+            return m_body_ghost_plan_requests;
+            }
+
         //! Subscribe to list of functions that determine the communication flags
         /*! This method keeps track of all functions that may request communication flags
          * \return A connection to the present class
@@ -238,6 +256,113 @@ class PYBIND11_EXPORT Communicator
             return m_compute_callbacks;
             }
 
+        //! Subscribe to list of call-backs that compute on local particles while the ghost update is in flight
+        /*!
+         * When no particle migration is necessary, the callbacks are called after beginUpdateGhosts() and before
+         * finishUpdateGhosts(). Positions of local particles are current at that point, ghost particle data is not.
+         * Subscribers may use this to compute the contributions of the interior particles, i.e. those that do not
+         * interact with ghosts, and compute the remaining ones after communicate() has returned.
+         *
+         * The ghosts of all but the last communication direction have already been received when the callbacks are
+         * called, only the receives of the last direction are still pending and write into the ghost part of the
+         * particle data arrays. Subscribers must not read any ghost particle data, not even for particles they
+         * skip.
+         *
+         * \return A Nano::Signal object reference to be used for connect and disconnect calls.
+         */
+        Nano::Signal<void (unsigned int timestep)>& getInteriorComputeCallbackSignal()
+            {
+            return m_interior_compute_callbacks;
+            }
+
+        //! Set whether the ghost update uses persistent MPI requests
+        /*! \param persistent_mpi True if the requests of the ghost update are created once and restarted every step
+
+            The persistent requests are recreated whenever the ghost exchange plan, the communication flags or the
+            buffers change. The default is true.
+         */
+        void setPersistentMPI(bool persistent_mpi)
+            {
+            m_exec_conf->msg->notice(4) << "Communicator: " << (persistent_mpi ? "using" : "not using")
+                << " persistent MPI requests" << std::endl;
+            if (! persistent_mpi)
+                freePersistentGhostRequests();
+            m_persistent_mpi = persistent_mpi;
+            }
+
+        //! Set whether ghost positions are sent in compressed form during the ghost update
+        /*! \param fixed_point True if the positions of ghost particles are sent as 32 bit fixed-point fractional
+                coordinates in the global box (12 bytes instead of a Scalar4)
+
+            The ghost exchange after particle migration always sends full positions and types. The position error
+            of the compressed ghost update is at most 2^-33 box lengths per direction.
+
+            The default is false.
+         */
+        void setGhostPositionCompression(bool fixed_point)
+            {
+            m_exec_conf->msg->notice(4) << "Communicator: " << (fixed_point ? "compressing" : "not compressing")
+                << " ghost positions" << std::endl;
+            m_ghost_pos_fixed_point = fixed_point;
+            }
+
+        //! Set whether ghost positions are exchanged through shared memory with ranks on the same node
+        void setNodeSharedMemory(bool enable);
+
+        //! Set whether the ghosts are sent in the order of their cells
+        /*! \param sort_ghosts True to sort the particles sent as ghosts in each direction by cell
+
+            The ghosts are appended to the particle data in the order in which they arrive. By default this is the
+            order of the sending rank's particle data, in which particles next to one boundary are scattered. With
+            sorting, the sending rank orders the ghosts of every direction by the cells of a grid over its local box
+            with the ghost layer width as cell size, so that ghosts that are close in space are also close in memory
+            on the receiving rank. Because only the send lists are reordered, the ghost updates and the reverse force
+            communication are unchanged.
+
+            The default is false.
+         */
+        void setGhostSorting(bool sort_ghosts)
+            {
+            m_exec_conf->msg->notice(4) << "Communicator: " << (sort_ghosts ? "sorting" : "not sorting")
+                << " ghosts by cell" << std::endl;
+            m_sort_ghosts = sort_ghosts;
+            m_force_migrate = true;
+            }
+
+        //! Set whether only the forward half-shell of ghost particles is used by the pair forces
+        /*! \param half_shell True to import ghosts for half of the neighboring domains only
+
+            Every pair of particles on different ranks is then evaluated on one of them only. No local particle is
+            sent as a ghost to the east neighbor, so that ghosts only arrive from the forward half of the neighbors in
+            x, and the neighbor list drops the ghosts that are not flagged by getGhostHalfShellFlags(). The forces on
+            the remaining ghosts are sent back to their owners with the reverse net force communication in
+            updateNetForce().
+
+            The default is false.
+         */
+        void setHalfShell(bool half_shell)
+            {
+            m_exec_conf->msg->notice(4) << "Communicator: " << (half_shell ? "using" : "not using")
+                << " the half-shell ghost exchange" << std::endl;
+            m_half_shell = half_shell;
+            m_force_migrate = true;
+            }
+
+        //! Returns true if the half-shell ghost exchange is used
+        bool getHalfShell() const
+            {
+            return m_half_shell;
+            }
+
+        //! Get the per-ghost flags of the half-shell ghost exchange
+        /*! The flag of a ghost is 1 if it lies in the forward half-shell of the local domain, i.e. its domain offset
+            is lexicographically positive in (x,y,z). Only valid with the half-shell ghost exchange.
+         */
+        const GlobalVector<unsigned int>& getGhostHalfShellFlags() const
+            {
+            return m_ghost_half_shell;
+            }
+
         //! Get the ghost communication flags
         CommFlags getFlags() { return m_flags; }
 
@@ -283,6 +408,12 @@ class PYBIND11_EXPORT Communicator
 
         //@}
 
+        //! Benchmark the particle migration and ghost exchange
+        double benchmarkExchange(unsigned int num_iters, unsigned int timestep);
+
+        //! Benchmark the update of the ghost particles
+        double benchmarkGhostUpdate(unsigned int num_iters, unsigned int timestep);
+
         //! Force particle migration
         void forceMigrate()
             {
@@ -291,6 +422,30 @@ class PYBIND11_EXPORT Communicator
                 m_force_migrate = true;
             }
 
+        //! Set the displacement buffer of the lazy migration check
+        /*! \param r_buff Particles that have moved less than \a r_buff since the last ghost exchange are not migrated
+                and the ghosts are not exchanged again, 0 to disable the check
+
+            The ghost layer is widened by \a r_buff, so that the ghost lists remain valid as long as no particle has
+            moved farther than \a r_buff. Particles may leave their domain by less than \a r_buff between migrations.
+            communicate() uses the check when no migrate requests are subscribed (e.g. in simulations without a
+            neighbor list), and methods that call migrateParticles() directly (e.g. HPMC) can call checkMigration().
+        */
+        void setMigrationBuffer(Scalar r_buff)
+            {
+            m_migrate_buffer = r_buff;
+            m_migrate_ref_valid = false;
+            }
+
+        //! Get the displacement buffer of the lazy migration check
+        Scalar getMigrationBuffer() const
+            {
+            return m_migrate_buffer;
+            }
+
+        //! Test if particles need to be migrated and the ghosts exchanged
+        bool checkMigration();
+
         /*! Exchange positions of ghost particles
          * Using the previously constructed ghost exchange lists, ghost positions are updated on the
          * neighboring processors.
@@ -310,11 +465,7 @@ class PYBIND11_EXPORT Communicator
          *
          * \param timestep The time step
          */
-        virtual void finishUpdateGhosts(unsigned int timestep)
-            {
-            // the base class implementation is currently empty
-            m_comm_pending = false;
-            }
+        virtual void finishUpdateGhosts(unsigned int timestep);
 
         /*! Communicate the net particle force
          * \parm timestep The time step
@@ -496,6 +647,9 @@ class PYBIND11_EXPORT Communicator
 
         GlobalVector<unsigned int> m_plan;          //!< Array of per-direction flags that determine the sending route
 
+        bool m_half_shell;                          //!< True if the half-shell ghost exchange is used
+        GlobalVector<unsigned int> m_ghost_half_shell; //!< Per-ghost flags, 1 if in the forward half-shell
+
         // Variables needed for sending ghost particles backwards
         GlobalVector<unsigned int> m_plan_reverse;          //!< Array of flags that determine the reverse sending route for ghosts
         GlobalVector<unsigned int> m_tag_reverse;          //!< Array of flags that determine which ghost particles are being sent back. This has no analog normally because particles actually store their tags, but in this case we don't want to so we have to make a vector. This vector corresponds to the m_copy_ghosts_reverse copybuf (m_copy_ghosts writes directly to m_pdata->getTags())
@@ -516,6 +670,7 @@ class PYBIND11_EXPORT Communicator
         BoxDim m_global_box;                     //!< Global simulation box
         GlobalArray<Scalar> m_r_ghost;              //!< Width of ghost layer
         GlobalArray<Scalar> m_r_ghost_body;         //!< Extra ghost width for rigid bodies
+        GlobalVector<unsigned int> m_body_ghost_plan; //!< Ghost plans of local particles set by their rigid bodies
         Scalar m_r_ghost_max;                    //!< Maximum ghost layer width
         Scalar m_r_extra_ghost_max;              //!< Maximum extra ghost layer width
 
@@ -525,12 +680,34 @@ class PYBIND11_EXPORT Communicator
         //! Update the ghost width array
         void updateGhostWidth();
 
+        Scalar m_migrate_buffer;                 //!< Displacement buffer of the lazy migration check
+        bool m_migrate_ref_valid;                //!< True if the reference positions are valid
+        std::vector<Scalar3> m_migrate_ref_pos;  //!< Positions of the local particles at the last ghost exchange
+        std::vector<Scalar> m_migrate_ref_r_ghost; //!< Ghost layer widths per type at the last ghost exchange
+
+        //! Store the reference of the lazy migration check after a ghost exchange
+        void setMigrationReference();
+
+        //! Invalidate the reference of the lazy migration check
+        void slotInvalidateMigrationReference()
+            {
+            m_migrate_ref_valid = false;
+            }
+
+        //! Let the subscribers set the ghost plans of the local rigid body particles
+        /*! \returns true if any body ghost plans have been requested
+         */
+        virtual bool updateBodyGhostPlans();
+
         Nano::Signal<bool(unsigned int timestep)>
             m_migrate_requests; //!< List of functions that may request particle migration
 
         Nano::Signal<CommFlags(unsigned int timestep) >
             m_requested_flags;  //!< List of functions that may request ghost communication flags
 
+        Nano::Signal<void (GlobalVector<unsigned int>&)>
+            m_body_ghost_plan_requests;  //!< List of functions that set the ghost plans of rigid body particles
+
         Nano::Signal<Scalar(unsigned int type) >
             m_ghost_layer_width_requests;  //!< List of functions that request a minimum ghost layer width
 
@@ -540,6 +717,9 @@ class PYBIND11_EXPORT Communicator
         Nano::Signal<void (unsigned int timestep)>
             m_compute_callbacks;   //!< List of functions that are called after ghost communication
 
+        Nano::Signal<void (unsigned int timestep)>
+            m_interior_compute_callbacks;   //!< List of functions that are called during ghost communication
+
         Nano::Signal<void (const GlobalArray<unsigned int>& )>
             m_comm_callbacks;   //!< List of functions that are called after the compute callbacks
 
@@ -549,6 +729,30 @@ class PYBIND11_EXPORT Communicator
         bool m_comm_pending;                     //!< If true, a communication is in process
         std::vector<MPI_Request> m_reqs; //!< Container for all MPI communication requests
         std::vector<MPI_Status> m_stats; //!< Container for all MPI communication statuses
+        unsigned int m_n_pending_reqs;           //!< Number of requests of the pending ghost update
+        unsigned int m_pending_ghost_start;      //!< First ghost index received by the pending ghost update
+        unsigned int m_pending_ghost_num;        //!< Number of ghosts received by the pending ghost update
+        MPI_Request *m_pending_reqs;             //!< Requests of the pending ghost update
+
+        bool m_persistent_mpi;                   //!< True if the ghost update uses persistent requests
+        std::vector<MPI_Request> m_persistent_ghost_reqs[6]; //!< Persistent ghost update requests per direction
+        std::vector<std::size_t> m_persistent_ghost_key;     //!< Plan that the persistent requests were created for
+
+        bool m_ghost_pos_fixed_point;            //!< True if ghost positions are updated in compressed form
+        GlobalVector<uint3> m_pos_fixed_copybuf; //!< Send buffer for compressed ghost positions
+        GlobalVector<uint3> m_pos_fixed_recvbuf; //!< Receive buffer for compressed ghost positions
+
+        bool m_sort_ghosts;                      //!< True if the ghosts are sent in the order of their cells
+        std::vector<unsigned int> m_ghost_send_idx;  //!< Indices of the particles sent as ghosts in one direction
+        std::vector< std::pair<unsigned int, unsigned int> > m_ghost_cells; //!< Cell and index of the ghosts to sort
+
+        MPI_Comm m_node_comm;                    //!< Ranks on the same node, MPI_COMM_NULL if not sharing memory
+        MPI_Win m_pos_win;                       //!< Shared memory window for the ghost positions to send
+        Scalar4 *m_pos_win_buf;                  //!< Local part of the shared memory window (two buffers)
+        unsigned int m_pos_win_capacity;         //!< Number of positions per buffer in the window
+        int m_node_send_rank[6];                 //!< Rank in m_node_comm of the send neighbor, or MPI_UNDEFINED
+        int m_node_recv_rank[6];                 //!< Rank in m_node_comm of the receive neighbor, or MPI_UNDEFINED
+        Scalar4 *m_node_recv_buf[6];             //!< Window of the receive neighbor on the same node
 
         /* Bonds communication */
         bool m_bonds_changed;                          //!< True if bond information needs to be refreshed
@@ -592,6 +796,39 @@ class PYBIND11_EXPORT Communicator
             m_pairs_changed = true;
             }
 
+        //! Wrap received ghost particle positions back into the (shifted) box
+        void wrapGhostPositions(unsigned int start_idx, unsigned int n);
+
+        //! Flag the ghosts in the forward half-shell of the local domain
+        void updateGhostHalfShellFlags();
+
+        //! Order the particles to send as ghosts by their cells in the local box
+        void sortGhostsByCell(const Scalar4 *h_pos, const BoxDim& box, const uint3& cell_dim);
+
+        //! Returns true if the ghost update exchanges positions through node shared memory
+        bool useNodeSharedPositions()
+            {
+            return m_node_comm != MPI_COMM_NULL && ! m_ghost_pos_fixed_point && getFlags()[comm_flag::position];
+            }
+
+        //! Resize the shared memory window to the current ghost send counts
+        void updateNodeSharedWindow();
+
+        //! Release the node shared memory window and communicator
+        void freeNodeSharedMemory();
+
+        //! Decode compressed ghost positions from the receive buffer into the particle data
+        void decodeGhostPositions(unsigned int start_idx, unsigned int n);
+
+        //! Get the quantities that determine the persistent ghost update requests
+        std::vector<std::size_t> getPersistentGhostKey();
+
+        //! Create the persistent requests for the ghost update
+        void initPersistentGhostRequests();
+
+        //! Release the persistent requests of the ghost update
+        void freePersistentGhostRequests();
+
         //! Remove tags of ghost particles
         virtual void removeGhostParticleTags();
 
@@ -611,9 +848,28 @@ class PYBIND11_EXPORT Communicator
                 }
             }
 
+        //! Wait for MPI requests and account for the time spent waiting
+        void waitAll(int count, MPI_Request *reqs, MPI_Status *stats)
+            {
+            int64_t start_time = m_wait_clk.getTime();
+            MPI_Waitall(count, reqs, stats);
+            int64_t wait_time = m_wait_clk.getTime() - start_time;
+            m_wait_time += wait_time;
+            m_exec_conf->getMetrics()->add(m_metric_wait_time, double(wait_time)*1e-9);
+            }
+
+        ClockSource m_wait_clk;                  //!< Clock to time the waits for MPI requests
+        int64_t m_wait_time;                     //!< Total time spent waiting for MPI requests (ns)
+        unsigned int m_metric_wait_time;         //!< ID of the metric of the time spent waiting for MPI requests
+        unsigned int m_metric_migrations;        //!< ID of the metric of the number of particle migrations
+        unsigned int m_metric_ghosts;            //!< ID of the metric of the number of ghost particles
+        unsigned int m_metric_collective_time;   //!< ID of the metric of the time spent in MPI collectives
+
     private:
         std::vector<pdata_element> m_sendbuf;  //!< Buffer for particles that are sent
         std::vector<pdata_element> m_recvbuf;  //!< Buffer for particles that are received
+        std::vector<char> m_packed_sendbuf;    //!< Migrating particles packed with their non-default fields
+        std::vector<char> m_packed_recvbuf;    //!< Received packed particles
 
         /* Communication of bonded groups */
         GroupCommunicator<BondData> m_bond_comm;    //!< Communication helper for bonds
@@ -659,6 +915,7 @@ class PYBIND11_EXPORT Communicator
             {
             removeGhostParticleTags();
             m_has_ghost_particles = false;
+            m_migrate_ref_valid = false;
             }
 
     };
@@ -32,6 +32,13 @@ CommunicatorGPU::CommunicatorGPU(std::shared_ptr<SystemDefinition> sysdef,
       m_constraint_comm(*this, m_sysdef->getConstraintData()),
       m_pair_comm(*this, m_sysdef->getPairData())
     {
+    // pass device buffers to MPI if the MPI library is CUDA-aware
+    #ifdef ENABLE_MPI_CUDA
+    m_cuda_aware_mpi = true;
+    #else
+    m_cuda_aware_mpi = false;
+    #endif
+
     if (m_exec_conf->allConcurrentManagedAccess())
         {
         // inform the user to use a cuda-aware MPI
@@ -489,8 +496,6 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::migrateGroups(bool incom
             if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
             }
 
-        #if defined(ENABLE_MPI_CUDA) && 0
-        #else
         // fill host send buffers on host
         unsigned int my_rank = m_exec_conf->getRank();
 
@@ -553,7 +558,6 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::migrateGroups(bool incom
                 h_end.data[i] = std::distance(send_map.begin(),upper);
                 }
             }
-        #endif
 
         /*
          * communicate rank information (phase 1)
@@ -593,7 +597,7 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::migrateGroups(bool incom
                 recv_bytes += sizeof(unsigned int);
                 } // end neighbor loop
 
-            MPI_Waitall(nreq, req, stat);
+            m_gpu_comm.waitAll(nreq, req, stat);
 
             // sum up receive counts
             for (unsigned int ineigh = 0; ineigh < m_gpu_comm.m_n_unique_neigh; ineigh++)
@@ -619,16 +623,14 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::migrateGroups(bool incom
 
             if (m_gpu_comm.m_prof) m_gpu_comm.m_prof->push(m_exec_conf,"MPI send/recv");
 
-            #ifdef ENABLE_MPI_CUDA
-            ArrayHandle<rank_element_t> ranks_sendbuf_handle(m_ranks_sendbuf, access_location::device, access_mode::read);
-            ArrayHandle<rank_element_t> ranks_recvbuf_handle(m_ranks_recvbuf, access_location::device, access_mode::overwrite);
+            // the received ranks are processed on the device
+            const access_location::Enum mpi_loc = m_gpu_comm.getMPILocation();
+            ArrayHandle<rank_element_t> ranks_sendbuf_handle(m_ranks_sendbuf, mpi_loc, access_mode::read);
+            ArrayHandle<rank_element_t> ranks_recvbuf_handle(m_ranks_recvbuf, mpi_loc, access_mode::overwrite);
 
             // MPI library may use non-zero stream
-            cudaDeviceSynchronize();
-            #else
-            ArrayHandle<rank_element_t> ranks_sendbuf_handle(m_ranks_sendbuf, access_location::host, access_mode::read);
-            ArrayHandle<rank_element_t> ranks_recvbuf_handle(m_ranks_recvbuf, access_location::host, access_mode::overwrite);
-            #endif
+            if (m_gpu_comm.m_cuda_aware_mpi)
+                cudaDeviceSynchronize();
 
             std::vector<MPI_Request> reqs;
             MPI_Request req;
@@ -671,9 +673,13 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::migrateGroups(bool incom
                 }
 
             std::vector<MPI_Status> stats(reqs.size());
-            MPI_Waitall(reqs.size(), &reqs.front(), &stats.front());
+            m_gpu_comm.waitAll(reqs.size(), &reqs.front(), &stats.front());
 
             if (m_gpu_comm.m_prof) m_gpu_comm.m_prof->pop(m_exec_conf,0,send_bytes+recv_bytes);
+
+            // MPI library may use non-zero stream
+            if (m_gpu_comm.m_cuda_aware_mpi)
+                cudaDeviceSynchronize();
             }
 
             {
@@ -777,8 +783,6 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::migrateGroups(bool incom
         m_gdata->removeGroups(m_gdata->getN() - new_ngroups);
         assert(m_gdata->getN() == new_ngroups);
 
-        #if defined(ENABLE_MPI_CUDA) && 0
-        #else
         // fill host send buffers on host
         typedef std::multimap<unsigned int, group_element_t> group_map_t;
         group_map_t group_send_map;
@@ -831,7 +835,6 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::migrateGroups(bool incom
                 h_end.data[i] = std::distance(group_send_map.begin(),upper);
                 }
             }
-        #endif
 
         /*
          * communicate groups (phase 2)
@@ -868,7 +871,7 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::migrateGroups(bool incom
                 recv_bytes += sizeof(unsigned int);
                 } // end neighbor loop
 
-            MPI_Waitall(nreq, req, stat);
+            m_gpu_comm.waitAll(nreq, req, stat);
 
             // sum up receive counts
             for (unsigned int ineigh = 0; ineigh < m_gpu_comm.m_n_unique_neigh; ineigh++)
@@ -894,11 +897,9 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::migrateGroups(bool incom
 
             if (m_gpu_comm.m_prof) m_gpu_comm.m_prof->push(m_exec_conf,"MPI send/recv");
 
-            #if defined(ENABLE_MPI_CUDA) && 0
-            #else
+            // the groups are sorted and filtered for duplicates on the host, so always stage through host memory
             ArrayHandle<group_element_t> groups_sendbuf_handle(m_groups_sendbuf, access_location::host, access_mode::read);
             ArrayHandle<group_element_t> groups_recvbuf_handle(m_groups_recvbuf, access_location::host, access_mode::overwrite);
-            #endif
 
             std::vector<MPI_Request> reqs;
             MPI_Request req;
@@ -941,14 +942,12 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::migrateGroups(bool incom
                 }
 
             std::vector<MPI_Status> stats(reqs.size());
-            MPI_Waitall(reqs.size(), &reqs.front(), &stats.front());
+            m_gpu_comm.waitAll(reqs.size(), &reqs.front(), &stats.front());
 
             if (m_gpu_comm.m_prof) m_gpu_comm.m_prof->pop(m_exec_conf,0,send_bytes+recv_bytes);
             }
 
         unsigned int n_recv_unique = 0;
-        #if defined(ENABLE_MPI_CUDA) && 0
-        #else
             {
             ArrayHandle<group_element_t> h_groups_recvbuf(m_groups_recvbuf, access_location::host, access_mode::read);
 
@@ -972,7 +971,6 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::migrateGroups(bool incom
                 h_groups_in.data[n_recv_unique++] = it->second;
             assert(n_recv_unique == recv_map.size());
             }
-        #endif
 
         unsigned int old_ngroups = m_gdata->getN();
 
@@ -1220,7 +1218,7 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::exchangeGhostGroups(
                     recv_bytes += sizeof(unsigned int);
                     }
 
-                MPI_Waitall(nreq, req, stat);
+                m_gpu_comm.waitAll(nreq, req, stat);
 
                 // total up receive counts
                 for (unsigned int ineigh = 0; ineigh < m_gpu_comm.m_n_unique_neigh; ineigh++)
@@ -1247,17 +1245,23 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::exchangeGhostGroups(
             unsigned int first_idx = m_gdata->getN()+m_gdata->getNGhosts();
 
                 {
-                unsigned int offs = 0;
+                // ghost groups are packed and unpacked on the device
+                const access_location::Enum mpi_loc = m_gpu_comm.getMPILocation();
+
                 // recv buffer
-                ArrayHandle<group_element_t> h_groups_recvbuf(m_groups_recvbuf, access_location::host, access_mode::overwrite);
+                ArrayHandle<group_element_t> groups_recvbuf_handle(m_groups_recvbuf, mpi_loc, access_mode::overwrite);
 
                 // send buffers
-                ArrayHandle<group_element_t> h_groups_sendbuf(m_groups_sendbuf, access_location::host, access_mode::read);
+                ArrayHandle<group_element_t> groups_sendbuf_handle(m_groups_sendbuf, mpi_loc, access_mode::read);
 
                 ArrayHandle<unsigned int> h_unique_neighbors(m_gpu_comm.m_unique_neighbors, access_location::host, access_mode::read);
                 ArrayHandle<unsigned int> h_ghost_group_begin(m_ghost_group_begin, access_location::host, access_mode::read);
                 ArrayHandle<unsigned int> h_ghost_group_end(m_ghost_group_end, access_location::host, access_mode::read);
 
+                // MPI library may use non-zero stream
+                if (m_gpu_comm.m_cuda_aware_mpi)
+                    cudaDeviceSynchronize();
+
                 if (m_gpu_comm.m_prof) m_gpu_comm.m_prof->push(m_exec_conf, "MPI send/recv");
 
                 std::vector<MPI_Request> reqs;
@@ -1272,7 +1276,7 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::exchangeGhostGroups(
                     // when sending/receiving 0 groups, the send/recv buffer may be uninitialized
                     if (n_send_ghost_groups[stage][ineigh])
                         {
-                        MPI_Isend(h_groups_sendbuf.data+h_ghost_group_begin.data[ineigh+stage*m_gpu_comm.m_n_unique_neigh],
+                        MPI_Isend(groups_sendbuf_handle.data+h_ghost_group_begin.data[ineigh+stage*m_gpu_comm.m_n_unique_neigh],
                             n_send_ghost_groups[stage][ineigh]*sizeof(group_element_t),
                             MPI_BYTE,
                             neighbor,
@@ -1284,7 +1288,7 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::exchangeGhostGroups(
                     send_bytes += n_send_ghost_groups[stage][ineigh]*sizeof(group_element_t);
                     if (n_recv_ghost_groups[stage][ineigh])
                         {
-                        MPI_Irecv(h_groups_recvbuf.data + ghost_group_offs[stage][ineigh] + offs,
+                        MPI_Irecv(groups_recvbuf_handle.data + ghost_group_offs[stage][ineigh],
                             n_recv_ghost_groups[stage][ineigh]*sizeof(group_element_t),
                             MPI_BYTE,
                             neighbor,
@@ -1297,9 +1301,13 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::exchangeGhostGroups(
                     }
 
                 std::vector<MPI_Status> stats(reqs.size());
-                MPI_Waitall(reqs.size(), &reqs.front(), &stats.front());
+                m_gpu_comm.waitAll(reqs.size(), &reqs.front(), &stats.front());
 
                 if (m_gpu_comm.m_prof) m_gpu_comm.m_prof->pop(m_exec_conf,0,send_bytes+recv_bytes);
+
+                // MPI library may use non-zero stream
+                if (m_gpu_comm.m_cuda_aware_mpi)
+                    cudaDeviceSynchronize();
                 } // end ArrayHandle scope
 
             unsigned int old_n_ghost = m_gdata->getNGhosts();
@@ -1362,7 +1370,7 @@ void CommunicatorGPU::GroupCommunicatorGPU<group_data>::exchangeGhostGroups(
             } // end main communication loop
 
         // notify subscribers that group order has changed
-        m_gdata->notifyGroupReorder();
+        m_gdata->notifyGroupExchange();
         }
     }
 
@@ -1475,8 +1483,8 @@ void CommunicatorGPU::migrateParticles()
         // determine local particles that are to be sent to neighboring processors and fill send buffer
         uint3 mypos = m_decomposition->getGridPos();
 
-        /* We need some better heuristics to decide whether to take the GPU or CPU code path */
-        #if defined(ENABLE_MPI_CUDA) && 0
+        // with a CUDA-aware MPI, sort the send buffer on the device so that it never leaves GPU memory
+        if (m_cuda_aware_mpi)
             {
             // resize keys
             m_send_keys.resize(m_gpu_sendbuf.size());
@@ -1516,7 +1524,7 @@ void CommunicatorGPU::migrateParticles()
             if (m_exec_conf->isCUDAErrorCheckingEnabled())
                 CHECK_CUDA_ERROR();
             }
-        #else
+        else
             {
             ArrayHandle<pdata_element> h_gpu_sendbuf(m_gpu_sendbuf, access_location::host, access_mode::readwrite);
             ArrayHandle<unsigned int> h_begin(m_begin, access_location::host, access_mode::overwrite);
@@ -1548,13 +1556,20 @@ void CommunicatorGPU::migrateParticles()
             for (key_t::iterator it = keys.begin(); it != keys.end(); ++it)
                 h_gpu_sendbuf.data[i++] = it->second;
             }
-        #endif
 
         unsigned int n_send_ptls[m_n_unique_neigh];
         unsigned int n_recv_ptls[m_n_unique_neigh];
         unsigned int offs[m_n_unique_neigh];
         unsigned int n_recv_tot = 0;
 
+        // without a CUDA-aware MPI, the particles are staged on the host and only the fields with non-default values
+        // are sent, the fields are announced together with the particle counts
+        bool pack_fields = !m_cuda_aware_mpi;
+        unsigned int send_header[m_n_unique_neigh][2];
+        unsigned int recv_header[m_n_unique_neigh][2];
+        unsigned int packed_send_offs[m_n_unique_neigh];
+        unsigned int packed_recv_offs[m_n_unique_neigh];
+
             {
             ArrayHandle<unsigned int> h_begin(m_begin, access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_end(m_end, access_location::host, access_mode::read);
@@ -1568,6 +1583,14 @@ void CommunicatorGPU::migrateParticles()
             for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
                 n_send_ptls[ineigh] = h_end.data[ineigh] - h_begin.data[ineigh];
 
+            if (pack_fields)
+                {
+                ArrayHandle<pdata_element> h_gpu_sendbuf(m_gpu_sendbuf, access_location::host, access_mode::read);
+                for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+                    send_header[ineigh][1] = getPdataElementFields(h_gpu_sendbuf.data + h_begin.data[ineigh],
+                        n_send_ptls[ineigh]);
+                }
+
             MPI_Request req[2*m_n_unique_neigh];
             MPI_Status stat[2*m_n_unique_neigh];
 
@@ -1587,13 +1610,37 @@ void CommunicatorGPU::migrateParticles()
                 // rank of neighbor processor
                 unsigned int neighbor = h_unique_neighbors.data[ineigh];
 
-                MPI_Isend(&n_send_ptls[ineigh], 1, MPI_UNSIGNED, neighbor, 0, m_mpi_comm, & req[nreq++]);
-                MPI_Irecv(&n_recv_ptls[ineigh], 1, MPI_UNSIGNED, neighbor, 0, m_mpi_comm, & req[nreq++]);
-                send_bytes += sizeof(unsigned int);
-                recv_bytes += sizeof(unsigned int);
+                if (pack_fields)
+                    {
+                    send_header[ineigh][0] = n_send_ptls[ineigh];
+                    MPI_Isend(send_header[ineigh], 2, MPI_UNSIGNED, neighbor, 0, m_mpi_comm, & req[nreq++]);
+                    MPI_Irecv(recv_header[ineigh], 2, MPI_UNSIGNED, neighbor, 0, m_mpi_comm, & req[nreq++]);
+                    send_bytes += 2*sizeof(unsigned int);
+                    recv_bytes += 2*sizeof(unsigned int);
+                    }
+                else
+                    {
+                    MPI_Isend(&n_send_ptls[ineigh], 1, MPI_UNSIGNED, neighbor, 0, m_mpi_comm, & req[nreq++]);
+                    MPI_Irecv(&n_recv_ptls[ineigh], 1, MPI_UNSIGNED, neighbor, 0, m_mpi_comm, & req[nreq++]);
+                    send_bytes += sizeof(unsigned int);
+                    recv_bytes += sizeof(unsigned int);
+                    }
                 } // end neighbor loop
 
-            MPI_Waitall(nreq, req, stat);
+            waitAll(nreq, req, stat);
+
+            if (pack_fields)
+                {
+                for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+                    {
+                    if (m_stages[ineigh] != (int) stage)
+                        {
+                        send_header[ineigh][1] = recv_header[ineigh][1] = 0;
+                        continue;
+                        }
+                    n_recv_ptls[ineigh] = recv_header[ineigh][0];
+                    }
+                }
 
             // sum up receive counts
             for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
@@ -1619,13 +1666,33 @@ void CommunicatorGPU::migrateParticles()
 
             if (m_prof) m_prof->push(m_exec_conf,"MPI send/recv");
 
-            #if defined(ENABLE_MPI_CUDA) && 0
-            ArrayHandle<pdata_element> gpu_sendbuf_handle(m_gpu_sendbuf, access_location::device, access_mode::read);
-            ArrayHandle<pdata_element> gpu_recvbuf_handle(m_gpu_recvbuf, access_location::device, access_mode::overwrite);
-            #else
-            ArrayHandle<pdata_element> gpu_sendbuf_handle(m_gpu_sendbuf, access_location::host, access_mode::read);
-            ArrayHandle<pdata_element> gpu_recvbuf_handle(m_gpu_recvbuf, access_location::host, access_mode::overwrite);
-            #endif
+            const access_location::Enum mpi_loc = getMPILocation();
+            ArrayHandle<pdata_element> gpu_sendbuf_handle(m_gpu_sendbuf, mpi_loc, access_mode::read);
+            ArrayHandle<pdata_element> gpu_recvbuf_handle(m_gpu_recvbuf, mpi_loc, access_mode::overwrite);
+
+            if (pack_fields)
+                {
+                // pack the particles of every neighbor with the fields announced to it
+                unsigned int send_size = 0;
+                unsigned int recv_size = 0;
+                for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+                    {
+                    packed_send_offs[ineigh] = send_size;
+                    packed_recv_offs[ineigh] = recv_size;
+                    send_size += n_send_ptls[ineigh]*getPackedPdataElementSize(send_header[ineigh][1]);
+                    recv_size += n_recv_ptls[ineigh]*getPackedPdataElementSize(recv_header[ineigh][1]);
+                    }
+                m_packed_sendbuf.resize(send_size);
+                m_packed_recvbuf.resize(recv_size);
+
+                for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+                    packPdataElements(gpu_sendbuf_handle.data + h_begin.data[ineigh], n_send_ptls[ineigh],
+                        send_header[ineigh][1], m_packed_sendbuf.data() + packed_send_offs[ineigh]);
+                }
+
+            // MPI library may use non-zero stream
+            if (m_cuda_aware_mpi)
+                cudaDeviceSynchronize();
 
             std::vector<MPI_Request> reqs;
             MPI_Request req;
@@ -1640,10 +1707,22 @@ void CommunicatorGPU::migrateParticles()
                 unsigned int neighbor = h_unique_neighbors.data[ineigh];
 
                 // exchange particle data
+                char *send_ptr = (char *)(gpu_sendbuf_handle.data+h_begin.data[ineigh]);
+                unsigned int send_size = n_send_ptls[ineigh]*sizeof(pdata_element);
+                char *recv_ptr = (char *)(gpu_recvbuf_handle.data+offs[ineigh]);
+                unsigned int recv_size = n_recv_ptls[ineigh]*sizeof(pdata_element);
+                if (pack_fields)
+                    {
+                    send_ptr = m_packed_sendbuf.data() + packed_send_offs[ineigh];
+                    send_size = n_send_ptls[ineigh]*getPackedPdataElementSize(send_header[ineigh][1]);
+                    recv_ptr = m_packed_recvbuf.data() + packed_recv_offs[ineigh];
+                    recv_size = n_recv_ptls[ineigh]*getPackedPdataElementSize(recv_header[ineigh][1]);
+                    }
+
                 if (n_send_ptls[ineigh])
                     {
-                    MPI_Isend(gpu_sendbuf_handle.data+h_begin.data[ineigh],
-                        n_send_ptls[ineigh]*sizeof(pdata_element),
+                    MPI_Isend(send_ptr,
+                        send_size,
                         MPI_BYTE,
                         neighbor,
                         1,
@@ -1651,12 +1730,12 @@ void CommunicatorGPU::migrateParticles()
                         &req);
                     reqs.push_back(req);
                     }
-                send_bytes+= n_send_ptls[ineigh]*sizeof(pdata_element);
+                send_bytes+= send_size;
 
                 if (n_recv_ptls[ineigh])
                     {
-                    MPI_Irecv(gpu_recvbuf_handle.data+offs[ineigh],
-                        n_recv_ptls[ineigh]*sizeof(pdata_element),
+                    MPI_Irecv(recv_ptr,
+                        recv_size,
                         MPI_BYTE,
                         neighbor,
                         1,
@@ -1664,13 +1743,24 @@ void CommunicatorGPU::migrateParticles()
                         &req);
                     reqs.push_back(req);
                     }
-                recv_bytes += n_recv_ptls[ineigh]*sizeof(pdata_element);
+                recv_bytes += recv_size;
                 }
 
             std::vector<MPI_Status> stats(reqs.size());
-            MPI_Waitall(reqs.size(), &reqs.front(), &stats.front());
+            waitAll(reqs.size(), &reqs.front(), &stats.front());
+
+            if (pack_fields)
+                {
+                for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
+                    unpackPdataElements(m_packed_recvbuf.data() + packed_recv_offs[ineigh], n_recv_ptls[ineigh],
+                        recv_header[ineigh][1], gpu_recvbuf_handle.data + offs[ineigh]);
+                }
 
             if (m_prof) m_prof->pop(m_exec_conf,0,send_bytes+recv_bytes);
+
+            // MPI library may use non-zero stream
+            if (m_cuda_aware_mpi)
+                cudaDeviceSynchronize();
             }
 
             {
@@ -1693,6 +1783,26 @@ void CommunicatorGPU::migrateParticles()
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+bool CommunicatorGPU::updateBodyGhostPlans()
+    {
+    if (m_body_ghost_plan_requests.empty())
+        return false;
+
+    m_body_ghost_plan.resize(m_pdata->getN());
+
+        {
+        // every byte 0xff sets all plans to NO_BODY_GHOST_PLAN
+        ArrayHandle<unsigned int> d_body_ghost_plan(m_body_ghost_plan, access_location::device, access_mode::overwrite);
+        cudaMemset(d_body_ghost_plan.data, 0xff, sizeof(unsigned int)*m_pdata->getN());
+
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    m_body_ghost_plan_requests.emit(m_body_ghost_plan);
+    return true;
+    }
+
 void CommunicatorGPU::removeGhostParticleTags()
     {
     if (m_last_flags[comm_flag::tag])
@@ -1724,6 +1834,12 @@ void CommunicatorGPU::exchangeGhosts()
         throw std::runtime_error("Error during communication");
         }
 
+    if (m_half_shell)
+        {
+        this->m_exec_conf->msg->error() << "The half-shell ghost exchange is not enabled on the GPU." << std::endl;
+        throw std::runtime_error("Error during communication");
+        }
+
     // check if simulation box is sufficiently large for domain decomposition
     checkBoxSize();
 
@@ -1758,6 +1874,9 @@ void CommunicatorGPU::exchangeGhosts()
     // get requested ghost fields
     CommFlags flags = getFlags();
 
+    // the ghost plans of local rigid body particles, ghosts received in earlier stages are forwarded as usual
+    unsigned int n_body_ghost_plan = updateBodyGhostPlans() ? m_pdata->getN() : 0;
+
     // main communication loop
     for (unsigned int stage = 0; stage < m_num_stages; stage++)
         {
@@ -1772,6 +1891,7 @@ void CommunicatorGPU::exchangeGhosts()
 
             ArrayHandle<Scalar> d_r_ghost(m_r_ghost, access_location::device, access_mode::read);
             ArrayHandle<Scalar> d_r_ghost_body(m_r_ghost_body, access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_body_ghost_plan(m_body_ghost_plan, access_location::device, access_mode::read);
 
             gpu_make_ghost_exchange_plan(d_ghost_plan.data,
                                          m_pdata->getN()+m_pdata->getNGhosts(),
@@ -1780,6 +1900,8 @@ void CommunicatorGPU::exchangeGhosts()
                                          m_pdata->getBox(),
                                          d_r_ghost.data,
                                          d_r_ghost_body.data,
+                                         d_body_ghost_plan.data,
+                                         n_body_ghost_plan,
                                          m_r_ghost_max,
                                          m_pdata->getNTypes(),
                                          m_comm_mask[stage]);
@@ -1996,7 +2118,7 @@ void CommunicatorGPU::exchangeGhosts()
                 recv_bytes += sizeof(unsigned int);
                 }
 
-            MPI_Waitall(nreq, req, stat);
+            waitAll(nreq, req, stat);
 
             // total up receive counts
             for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ineigh++)
@@ -2033,54 +2155,30 @@ void CommunicatorGPU::exchangeGhosts()
         m_pdata->addGhostParticles(m_n_recv_ghosts_tot[stage]);
 
             {
-            unsigned int offs = 0;
-            #ifdef ENABLE_MPI_CUDA
-            // recv buffers, write directly into particle data arrays
-            offs = first_idx;
-            ArrayHandle<unsigned int> tag_ghost_recvbuf_handle(m_pdata->getTags(), access_location::device, access_mode::readwrite);
-            ArrayHandle<Scalar4> pos_ghost_recvbuf_handle(m_pdata->getPositions(), access_location::device, access_mode::readwrite);
-            ArrayHandle<Scalar4> vel_ghost_recvbuf_handle(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
-            ArrayHandle<Scalar> charge_ghost_recvbuf_handle(m_pdata->getCharges(), access_location::device, access_mode::readwrite);
-            ArrayHandle<Scalar> diameter_ghost_recvbuf_handle(m_pdata->getDiameters(), access_location::device, access_mode::readwrite);
-            ArrayHandle<unsigned int> body_ghost_recvbuf_handle(m_pdata->getBodies(), access_location::device, access_mode::readwrite);
-            ArrayHandle<int3> image_ghost_recvbuf_handle(m_pdata->getImages(), access_location::device, access_mode::readwrite);
-            ArrayHandle<Scalar4> orientation_ghost_recvbuf_handle(m_pdata->getOrientationArray(), access_location::device, access_mode::readwrite);
-
-            // send buffers
-            ArrayHandle<unsigned int> tag_ghost_sendbuf_handle(m_tag_ghost_sendbuf, access_location::device, access_mode::read);
-            ArrayHandle<Scalar4> pos_ghost_sendbuf_handle(m_pos_ghost_sendbuf, access_location::device, access_mode::read);
-            ArrayHandle<Scalar4> vel_ghost_sendbuf_handle(m_vel_ghost_sendbuf, access_location::device, access_mode::read);
-            ArrayHandle<Scalar> charge_ghost_sendbuf_handle(m_charge_ghost_sendbuf, access_location::device, access_mode::read);
-            ArrayHandle<unsigned int> body_ghost_sendbuf_handle(m_body_ghost_sendbuf, access_location::device, access_mode::read);
-            ArrayHandle<int3> image_ghost_sendbuf_handle(m_image_ghost_sendbuf, access_location::device, access_mode::read);
-            ArrayHandle<Scalar> diameter_ghost_sendbuf_handle(m_diameter_ghost_sendbuf, access_location::device, access_mode::read);
-            ArrayHandle<Scalar4> orientation_ghost_sendbuf_handle(m_orientation_ghost_sendbuf, access_location::device, access_mode::read);
+            // with a CUDA-aware MPI, send and receive directly from and to device memory
+            const access_location::Enum mpi_loc = getMPILocation();
 
-            // MPI library may use non-zero stream
-            cudaDeviceSynchronize();
-            #else
             // recv buffers
-            ArrayHandleAsync<unsigned int> tag_ghost_recvbuf_handle(m_tag_ghost_recvbuf, access_location::host, access_mode::overwrite);
-            ArrayHandleAsync<Scalar4> pos_ghost_recvbuf_handle(m_pos_ghost_recvbuf, access_location::host, access_mode::overwrite);
-            ArrayHandleAsync<Scalar4> vel_ghost_recvbuf_handle(m_vel_ghost_recvbuf, access_location::host, access_mode::overwrite);
-            ArrayHandleAsync<Scalar> charge_ghost_recvbuf_handle(m_charge_ghost_recvbuf, access_location::host, access_mode::overwrite);
-            ArrayHandleAsync<unsigned int> body_ghost_recvbuf_handle(m_body_ghost_recvbuf, access_location::host, access_mode::overwrite);
-            ArrayHandleAsync<int3> image_ghost_recvbuf_handle(m_image_ghost_recvbuf, access_location::host, access_mode::overwrite);
-            ArrayHandleAsync<Scalar> diameter_ghost_recvbuf_handle(m_diameter_ghost_recvbuf, access_location::host, access_mode::overwrite);
-            ArrayHandleAsync<Scalar4> orientation_ghost_recvbuf_handle(m_orientation_ghost_recvbuf, access_location::host, access_mode::overwrite);
+            ArrayHandleAsync<unsigned int> tag_ghost_recvbuf_handle(m_tag_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+            ArrayHandleAsync<Scalar4> pos_ghost_recvbuf_handle(m_pos_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+            ArrayHandleAsync<Scalar4> vel_ghost_recvbuf_handle(m_vel_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+            ArrayHandleAsync<Scalar> charge_ghost_recvbuf_handle(m_charge_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+            ArrayHandleAsync<unsigned int> body_ghost_recvbuf_handle(m_body_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+            ArrayHandleAsync<int3> image_ghost_recvbuf_handle(m_image_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+            ArrayHandleAsync<Scalar> diameter_ghost_recvbuf_handle(m_diameter_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+            ArrayHandleAsync<Scalar4> orientation_ghost_recvbuf_handle(m_orientation_ghost_recvbuf, mpi_loc, access_mode::overwrite);
             // send buffers
-            ArrayHandleAsync<unsigned int> tag_ghost_sendbuf_handle(m_tag_ghost_sendbuf, access_location::host, access_mode::read);
-            ArrayHandleAsync<Scalar4> pos_ghost_sendbuf_handle(m_pos_ghost_sendbuf, access_location::host, access_mode::read);
-            ArrayHandleAsync<Scalar4> vel_ghost_sendbuf_handle(m_vel_ghost_sendbuf, access_location::host, access_mode::read);
-            ArrayHandleAsync<Scalar> charge_ghost_sendbuf_handle(m_charge_ghost_sendbuf, access_location::host, access_mode::read);
-            ArrayHandleAsync<unsigned int> body_ghost_sendbuf_handle(m_body_ghost_sendbuf, access_location::host, access_mode::read);
-            ArrayHandleAsync<int3> image_ghost_sendbuf_handle(m_image_ghost_sendbuf, access_location::host, access_mode::read);
-            ArrayHandleAsync<Scalar> diameter_ghost_sendbuf_handle(m_diameter_ghost_sendbuf, access_location::host, access_mode::read);
-            ArrayHandleAsync<Scalar4> orientation_ghost_sendbuf_handle(m_orientation_ghost_sendbuf, access_location::host, access_mode::read);
-
-            // lump together into one synchronization call
+            ArrayHandleAsync<unsigned int> tag_ghost_sendbuf_handle(m_tag_ghost_sendbuf, mpi_loc, access_mode::read);
+            ArrayHandleAsync<Scalar4> pos_ghost_sendbuf_handle(m_pos_ghost_sendbuf, mpi_loc, access_mode::read);
+            ArrayHandleAsync<Scalar4> vel_ghost_sendbuf_handle(m_vel_ghost_sendbuf, mpi_loc, access_mode::read);
+            ArrayHandleAsync<Scalar> charge_ghost_sendbuf_handle(m_charge_ghost_sendbuf, mpi_loc, access_mode::read);
+            ArrayHandleAsync<unsigned int> body_ghost_sendbuf_handle(m_body_ghost_sendbuf, mpi_loc, access_mode::read);
+            ArrayHandleAsync<int3> image_ghost_sendbuf_handle(m_image_ghost_sendbuf, mpi_loc, access_mode::read);
+            ArrayHandleAsync<Scalar> diameter_ghost_sendbuf_handle(m_diameter_ghost_sendbuf, mpi_loc, access_mode::read);
+            ArrayHandleAsync<Scalar4> orientation_ghost_sendbuf_handle(m_orientation_ghost_sendbuf, mpi_loc, access_mode::read);
+
+            // lump together into one synchronization call (the MPI library may also use a non-zero stream)
             cudaDeviceSynchronize();
-            #endif
 
             ArrayHandle<unsigned int> h_unique_neighbors(m_unique_neighbors, access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_ghost_begin(m_ghost_begin, access_location::host, access_mode::read);
@@ -2114,7 +2212,7 @@ void CommunicatorGPU::exchangeGhosts()
                     send_bytes += m_n_send_ghosts[stage][ineigh]*sizeof(unsigned int);
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(tag_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(tag_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(unsigned int),
                             MPI_BYTE,
                             neighbor,
@@ -2143,7 +2241,7 @@ void CommunicatorGPU::exchangeGhosts()
                     send_bytes += m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4);
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(pos_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(pos_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4),
                             MPI_BYTE,
                             neighbor,
@@ -2171,7 +2269,7 @@ void CommunicatorGPU::exchangeGhosts()
                     send_bytes += m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4);
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(vel_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(vel_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4),
                             MPI_BYTE,
                             neighbor,
@@ -2199,7 +2297,7 @@ void CommunicatorGPU::exchangeGhosts()
                     send_bytes += m_n_send_ghosts[stage][ineigh]*sizeof(Scalar);
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(charge_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(charge_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar),
                             MPI_BYTE,
                             neighbor,
@@ -2227,7 +2325,7 @@ void CommunicatorGPU::exchangeGhosts()
                     send_bytes += m_n_send_ghosts[stage][ineigh]*sizeof(Scalar);
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(diameter_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(diameter_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar),
                             MPI_BYTE,
                             neighbor,
@@ -2255,7 +2353,7 @@ void CommunicatorGPU::exchangeGhosts()
                     send_bytes += m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4);
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(orientation_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(orientation_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4),
                             MPI_BYTE,
                             neighbor,
@@ -2283,7 +2381,7 @@ void CommunicatorGPU::exchangeGhosts()
                     send_bytes += m_n_send_ghosts[stage][ineigh]*sizeof(unsigned int);
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(body_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(body_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(unsigned int),
                             MPI_BYTE,
                             neighbor,
@@ -2311,7 +2409,7 @@ void CommunicatorGPU::exchangeGhosts()
                     send_bytes += m_n_send_ghosts[stage][ineigh]*sizeof(int3);
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(image_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(image_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(int3),
                             MPI_BYTE,
                             neighbor,
@@ -2325,16 +2423,15 @@ void CommunicatorGPU::exchangeGhosts()
                 } // end neighbor loop
 
             std::vector<MPI_Status> stats(reqs.size());
-            MPI_Waitall(reqs.size(), &reqs.front(), &stats.front());
+            waitAll(reqs.size(), &reqs.front(), &stats.front());
 
             if (m_prof) m_prof->pop(m_exec_conf,0,send_bytes+recv_bytes);
+
+            // MPI library may use non-zero stream
+            if (m_cuda_aware_mpi)
+                cudaDeviceSynchronize();
             } // end ArrayHandle scope
 
-        #ifdef ENABLE_MPI_CUDA
-        // MPI library may use non-zero stream
-        cudaDeviceSynchronize();
-        #else
-        // only unpack in non-CUDA MPI builds
             {
             // access receive buffers
             ArrayHandle<unsigned int> d_tag_ghost_recvbuf(m_tag_ghost_recvbuf, access_location::device, access_mode::read);
@@ -2385,7 +2482,6 @@ void CommunicatorGPU::exchangeGhosts()
 
             if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
             }
-        #endif
 
         if (flags[comm_flag::tag])
             {
@@ -2408,6 +2504,9 @@ void CommunicatorGPU::exchangeGhosts()
 
     m_last_flags = flags;
 
+    // the ghost lists are valid until the particles have moved by the migration buffer
+    setMigrationReference();
+
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
@@ -2493,43 +2592,37 @@ void CommunicatorGPU::beginUpdateGhosts(unsigned int timestep)
             }
 
             {
-            unsigned int offs = 0;
-            // access particle data
-            #ifdef ENABLE_MPI_CUDA
-            offs = first_idx;
-            // recv buffers, directly write into particle data arrays
-            ArrayHandle<Scalar4> pos_ghost_recvbuf_handle(m_pdata->getPositions(), access_location::device, access_mode::readwrite);
-            ArrayHandle<Scalar4> vel_ghost_recvbuf_handle(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
-            ArrayHandle<Scalar4> orientation_ghost_recvbuf_handle(m_pdata->getOrientationArray(), access_location::device, access_mode::readwrite);
+            // with a CUDA-aware MPI, send and receive directly from and to device memory
+            const access_location::Enum mpi_loc = getMPILocation();
 
-            // send buffers
-            ArrayHandle<Scalar4> pos_ghost_sendbuf_handle(m_pos_ghost_sendbuf, access_location::device, access_mode::read);
-            ArrayHandle<Scalar4> vel_ghost_sendbuf_handle(m_vel_ghost_sendbuf, access_location::device, access_mode::read);
-            ArrayHandle<Scalar4> orientation_ghost_sendbuf_handle(m_orientation_ghost_sendbuf, access_location::device, access_mode::read);
-
-            ArrayHandle<unsigned int> h_unique_neighbors(m_unique_neighbors, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_ghost_begin(m_ghost_begin, access_location::host, access_mode::read);
-
-            // MPI library may use non-zero stream
-            cudaDeviceSynchronize();
-            #else
             // recv buffers
-            ArrayHandle<Scalar4> pos_ghost_recvbuf_handle(m_pos_ghost_recvbuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<Scalar4> vel_ghost_recvbuf_handle(m_vel_ghost_recvbuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<Scalar4> orientation_ghost_recvbuf_handle(m_orientation_ghost_recvbuf, access_location::host, access_mode::overwrite);
-
-            // send buffers
-            ArrayHandleAsync<Scalar4> pos_ghost_sendbuf_handle(m_pos_ghost_sendbuf, access_location::host, access_mode::read);
-            ArrayHandleAsync<Scalar4> vel_ghost_sendbuf_handle(m_vel_ghost_sendbuf, access_location::host, access_mode::read);
-            ArrayHandleAsync<Scalar4> orientation_ghost_sendbuf_handle(m_orientation_ghost_sendbuf, access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> pos_ghost_recvbuf_handle(m_pos_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+            ArrayHandle<Scalar4> vel_ghost_recvbuf_handle(m_vel_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+            ArrayHandle<Scalar4> orientation_ghost_recvbuf_handle(m_orientation_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+
+            // send buffers, without a CUDA-aware MPI only the filled part of the buffers of the communicated fields
+            // is copied to the host
+            ArrayHandleRange<Scalar4> pos_ghost_sendbuf_handle(m_pos_ghost_sendbuf, mpi_loc, access_mode::read, 0,
+                flags[comm_flag::position] ? m_pos_ghost_sendbuf.size() : 0);
+            ArrayHandleRange<Scalar4> vel_ghost_sendbuf_handle(m_vel_ghost_sendbuf, mpi_loc, access_mode::read, 0,
+                flags[comm_flag::velocity] ? m_vel_ghost_sendbuf.size() : 0);
+            ArrayHandleRange<Scalar4> orientation_ghost_sendbuf_handle(m_orientation_ghost_sendbuf, mpi_loc,
+                access_mode::read, 0, flags[comm_flag::orientation] ? m_orientation_ghost_sendbuf.size() : 0);
 
             ArrayHandleAsync<unsigned int> h_unique_neighbors(m_unique_neighbors, access_location::host, access_mode::read);
             ArrayHandleAsync<unsigned int> h_ghost_begin(m_ghost_begin, access_location::host, access_mode::read);
 
-            // lump together into one synchronization call
-            cudaEventRecord(m_event);
-            cudaEventSynchronize(m_event);
-            #endif
+            if (m_cuda_aware_mpi)
+                {
+                // MPI library may use non-zero stream
+                cudaDeviceSynchronize();
+                }
+            else
+                {
+                // lump together into one synchronization call
+                cudaEventRecord(m_event);
+                cudaEventSynchronize(m_event);
+                }
 
             // access send buffers
             if (m_prof) m_prof->push(m_exec_conf, "MPI send/recv");
@@ -2563,7 +2656,7 @@ void CommunicatorGPU::beginUpdateGhosts(unsigned int timestep)
 
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(pos_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(pos_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4),
                             MPI_BYTE,
                             neighbor,
@@ -2592,7 +2685,7 @@ void CommunicatorGPU::beginUpdateGhosts(unsigned int timestep)
 
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(vel_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(vel_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4),
                             MPI_BYTE,
                             neighbor,
@@ -2621,7 +2714,7 @@ void CommunicatorGPU::beginUpdateGhosts(unsigned int timestep)
 
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(orientation_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(orientation_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4),
                             MPI_BYTE,
                             neighbor,
@@ -2643,7 +2736,11 @@ void CommunicatorGPU::beginUpdateGhosts(unsigned int timestep)
                 {
                 // complete communication
                 std::vector<MPI_Status> stats(m_reqs.size());
-                MPI_Waitall(m_reqs.size(), &m_reqs.front(), &stats.front());
+                waitAll(m_reqs.size(), &m_reqs.front(), &stats.front());
+
+                // MPI library may use non-zero stream
+                if (m_cuda_aware_mpi)
+                    cudaDeviceSynchronize();
                 }
 
             if (m_prof) m_prof->pop(m_exec_conf,0,send_bytes+recv_bytes);
@@ -2652,8 +2749,6 @@ void CommunicatorGPU::beginUpdateGhosts(unsigned int timestep)
 
         if (!m_comm_pending)
             {
-            #ifndef ENABLE_MPI_CUDA
-            //only unpack in non-CUDA MPI builds
             if (m_prof) m_prof->push(m_exec_conf,"unpack");
                 {
                 // access receive buffers
@@ -2696,7 +2791,6 @@ void CommunicatorGPU::beginUpdateGhosts(unsigned int timestep)
                 if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
                 }
             if (m_prof) m_prof->pop(m_exec_conf);
-            #endif
             }
         } // end main communication loop
 
@@ -2718,14 +2812,13 @@ void CommunicatorGPU::finishUpdateGhosts(unsigned int timestep)
         // complete communication
         if (m_prof) m_prof->push(m_exec_conf, "MPI send/recv");
         std::vector<MPI_Status> stats(m_reqs.size());
-        MPI_Waitall(m_reqs.size(), &m_reqs.front(), &stats.front());
+        waitAll(m_reqs.size(), &m_reqs.front(), &stats.front());
         if (m_prof) m_prof->pop(m_exec_conf);
 
-        #ifdef ENABLE_MPI_CUDA
         // MPI library may use non-zero stream
-        cudaDeviceSynchronize();
-        #else
-        // only unpack in non-CUDA-MPI builds
+        if (m_cuda_aware_mpi)
+            cudaDeviceSynchronize();
+
         assert(m_num_stages == 1);
         unsigned int stage = 0;
         unsigned int first_idx = m_pdata->getN();
@@ -2772,7 +2865,6 @@ void CommunicatorGPU::finishUpdateGhosts(unsigned int timestep)
             if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
             }
         if (m_prof) m_prof->pop(m_exec_conf);
-        #endif
 
         if (m_prof) m_prof->pop(m_exec_conf);
         }
@@ -2923,16 +3015,22 @@ void CommunicatorGPU::updateNetForce(unsigned int timestep)
             }
 
             {
-            unsigned int offs = 0;
+            // with a CUDA-aware MPI, send and receive directly from and to device memory
+            const access_location::Enum mpi_loc = getMPILocation();
+
             // recv buffer
-            ArrayHandle<Scalar4> h_netforce_ghost_recvbuf(m_netforce_ghost_recvbuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<Scalar4> h_nettorque_ghost_recvbuf(m_nettorque_ghost_recvbuf, access_location::host, access_mode::overwrite);
-            ArrayHandle<Scalar> h_netvirial_ghost_recvbuf(m_netvirial_ghost_recvbuf, access_location::host, access_mode::overwrite);
+            ArrayHandle<Scalar4> netforce_ghost_recvbuf_handle(m_netforce_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+            ArrayHandle<Scalar4> nettorque_ghost_recvbuf_handle(m_nettorque_ghost_recvbuf, mpi_loc, access_mode::overwrite);
+            ArrayHandle<Scalar> netvirial_ghost_recvbuf_handle(m_netvirial_ghost_recvbuf, mpi_loc, access_mode::overwrite);
 
             // send buffer
-            ArrayHandle<Scalar4> h_netforce_ghost_sendbuf(m_netforce_ghost_sendbuf, access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_nettorque_ghost_sendbuf(m_nettorque_ghost_sendbuf, access_location::host, access_mode::read);
-            ArrayHandle<Scalar> h_netvirial_ghost_sendbuf(m_netvirial_ghost_sendbuf, access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> netforce_ghost_sendbuf_handle(m_netforce_ghost_sendbuf, mpi_loc, access_mode::read);
+            ArrayHandle<Scalar4> nettorque_ghost_sendbuf_handle(m_nettorque_ghost_sendbuf, mpi_loc, access_mode::read);
+            ArrayHandle<Scalar> netvirial_ghost_sendbuf_handle(m_netvirial_ghost_sendbuf, mpi_loc, access_mode::read);
+
+            // MPI library may use non-zero stream
+            if (m_cuda_aware_mpi)
+                cudaDeviceSynchronize();
 
             ArrayHandleAsync<unsigned int> h_unique_neighbors(m_unique_neighbors, access_location::host, access_mode::read);
             ArrayHandleAsync<unsigned int> h_ghost_begin(m_ghost_begin, access_location::host, access_mode::read);
@@ -2954,7 +3052,7 @@ void CommunicatorGPU::updateNetForce(unsigned int timestep)
 
                 if (m_n_send_ghosts[stage][ineigh])
                     {
-                    MPI_Isend(h_netforce_ghost_sendbuf.data+h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
+                    MPI_Isend(netforce_ghost_sendbuf_handle.data+h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
                         m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4),
                         MPI_BYTE,
                         neighbor,
@@ -2967,7 +3065,7 @@ void CommunicatorGPU::updateNetForce(unsigned int timestep)
 
                 if (m_n_recv_ghosts[stage][ineigh])
                     {
-                    MPI_Irecv(h_netforce_ghost_recvbuf.data + m_ghost_offs[stage][ineigh] + offs,
+                    MPI_Irecv(netforce_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                         m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4),
                         MPI_BYTE,
                         neighbor,
@@ -2982,7 +3080,7 @@ void CommunicatorGPU::updateNetForce(unsigned int timestep)
                     {
                     if (m_n_send_ghosts[stage][ineigh])
                         {
-                        MPI_Isend(h_nettorque_ghost_sendbuf.data+h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
+                        MPI_Isend(nettorque_ghost_sendbuf_handle.data+h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
                             m_n_send_ghosts[stage][ineigh]*sizeof(Scalar4),
                             MPI_BYTE,
                             neighbor,
@@ -2995,7 +3093,7 @@ void CommunicatorGPU::updateNetForce(unsigned int timestep)
 
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(h_nettorque_ghost_recvbuf.data + m_ghost_offs[stage][ineigh] + offs,
+                        MPI_Irecv(nettorque_ghost_recvbuf_handle.data + m_ghost_offs[stage][ineigh],
                             m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar4),
                             MPI_BYTE,
                             neighbor,
@@ -3011,7 +3109,7 @@ void CommunicatorGPU::updateNetForce(unsigned int timestep)
                     {
                     if (m_n_send_ghosts[stage][ineigh])
                         {
-                        MPI_Isend(h_netvirial_ghost_sendbuf.data+6*h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
+                        MPI_Isend(netvirial_ghost_sendbuf_handle.data+6*h_ghost_begin.data[ineigh + stage*m_n_unique_neigh],
                             6*m_n_send_ghosts[stage][ineigh]*sizeof(Scalar),
                             MPI_BYTE,
                             neighbor,
@@ -3024,7 +3122,7 @@ void CommunicatorGPU::updateNetForce(unsigned int timestep)
 
                     if (m_n_recv_ghosts[stage][ineigh])
                         {
-                        MPI_Irecv(h_netvirial_ghost_recvbuf.data + 6*(m_ghost_offs[stage][ineigh] + offs),
+                        MPI_Irecv(netvirial_ghost_recvbuf_handle.data + 6*m_ghost_offs[stage][ineigh],
                             6*m_n_recv_ghosts[stage][ineigh]*sizeof(Scalar),
                             MPI_BYTE,
                             neighbor,
@@ -3040,9 +3138,13 @@ void CommunicatorGPU::updateNetForce(unsigned int timestep)
 
             // complete communication
             std::vector<MPI_Status> stats(m_reqs.size());
-            MPI_Waitall(m_reqs.size(), &m_reqs.front(), &stats.front());
+            waitAll(m_reqs.size(), &m_reqs.front(), &stats.front());
 
             if (m_prof) m_prof->pop(m_exec_conf,0,send_bytes+recv_bytes);
+
+            // MPI library may use non-zero stream
+            if (m_cuda_aware_mpi)
+                cudaDeviceSynchronize();
             } // end ArrayHandle scope
 
         if (m_prof) m_prof->push(m_exec_conf,"unpack");
@@ -3111,6 +3213,7 @@ void export_CommunicatorGPU(py::module& m)
     py::class_<CommunicatorGPU, std::shared_ptr<CommunicatorGPU> >(m,"CommunicatorGPU",py::base<Communicator>())
         .def(py::init<std::shared_ptr<SystemDefinition>, std::shared_ptr<DomainDecomposition> >())
         .def("setMaxStages",&CommunicatorGPU::setMaxStages)
+        .def("setCudaAwareMPI",&CommunicatorGPU::setCudaAwareMPI)
     ;
     }
 
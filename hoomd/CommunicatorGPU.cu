@@ -345,6 +345,8 @@ __global__ void gpu_make_ghost_exchange_plan_kernel(
     const BoxDim box,
     const Scalar *d_r_ghost,
     const Scalar *d_r_ghost_body,
+    const unsigned int *d_body_ghost_plan,
+    unsigned int n_body_ghost_plan,
     Scalar r_ghost_max,
     unsigned int ntypes,
     unsigned int mask
@@ -376,15 +378,20 @@ __global__ void gpu_make_ghost_exchange_plan_kernel(
     const unsigned int type = __scalar_as_int(postype.w);
     Scalar3 ghost_fraction = s_ghost_fractions[type];
 
+    unsigned int plan = 0;
+
     if (d_body[idx] != NO_BODY)
         {
-        ghost_fraction += s_body_ghost_fractions[type];
+        // the plans of local body particles may be set by the rigid bodies
+        unsigned int body_plan = (idx < n_body_ghost_plan) ? d_body_ghost_plan[idx] : NO_BODY_GHOST_PLAN;
+        if (body_plan == NO_BODY_GHOST_PLAN)
+            ghost_fraction += s_body_ghost_fractions[type];
+        else
+            plan = body_plan;
         }
 
     Scalar3 f = box.makeFraction(pos);
 
-    unsigned int plan = 0;
-
     // is particle inside ghost layer? set plan accordingly.
     if (f.x >= Scalar(1.0) - ghost_fraction.x)
         plan |= send_east;
@@ -411,6 +418,8 @@ __global__ void gpu_make_ghost_exchange_plan_kernel(
  * \param d_pos Array of particle positions
  * \param box Dimensions of local simulation box
  * \param r_ghost Width of boundary layer
+ * \param d_body_ghost_plan Ghost plans of the first n_body_ghost_plan particles set by their rigid bodies
+ * \param n_body_ghost_plan Number of body ghost plans (0 if not used)
  */
 void gpu_make_ghost_exchange_plan(unsigned int *d_plan,
                                   unsigned int N,
@@ -419,6 +428,8 @@ void gpu_make_ghost_exchange_plan(unsigned int *d_plan,
                                   const BoxDim &box,
                                   const Scalar *d_r_ghost,
                                   const Scalar *d_r_ghost_body,
+                                  const unsigned int *d_body_ghost_plan,
+                                  unsigned int n_body_ghost_plan,
                                   Scalar r_ghost_max,
                                   unsigned int ntypes,
                                   unsigned int mask)
@@ -435,6 +446,8 @@ void gpu_make_ghost_exchange_plan(unsigned int *d_plan,
         box,
         d_r_ghost,
         d_r_ghost_body,
+        d_body_ghost_plan,
+        n_body_ghost_plan,
         r_ghost_max,
         ntypes,
         mask);
@@ -18,6 +18,9 @@
 #include "hoomd/CachedAllocator.h"
 
 #ifdef NVCC
+//! Sentinel value in the body ghost plans to signify that the ghost plan of a particle is not set by its body
+const unsigned int NO_BODY_GHOST_PLAN = 0xffffffff;
+
 //! The flags used for indicating the itinerary of a particle
 enum gpu_send_flags
     {
@@ -93,6 +96,8 @@ void gpu_make_ghost_exchange_plan(unsigned int *d_plan,
                                   const BoxDim& box,
                                   const Scalar *d_r_ghost,
                                   const Scalar *d_r_ghost_body,
+                                  const unsigned int *d_body_ghost_plan,
+                                  unsigned int n_body_ghost_plan,
                                   Scalar r_ghost_max,
                                   unsigned int ntypes,
                                   unsigned int mask);
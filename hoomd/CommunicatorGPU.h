@@ -81,6 +81,19 @@ class PYBIND11_EXPORT CommunicatorGPU : public Communicator
             forceMigrate();
             }
 
+        //! Select whether device buffers are passed directly to MPI
+        /*! \param cuda_aware_mpi If true, the MPI library must be CUDA-aware. Otherwise, buffers are staged through
+                (pinned) host memory
+
+            The default is the build setting ENABLE_MPI_CUDA.
+         */
+        void setCudaAwareMPI(bool cuda_aware_mpi)
+            {
+            m_exec_conf->msg->notice(4) << "CommunicatorGPU: " << (cuda_aware_mpi ? "using" : "not using")
+                << " CUDA-aware MPI" << std::endl;
+            m_cuda_aware_mpi = cuda_aware_mpi;
+            }
+
     protected:
         //! Helper class to perform the communication tasks related to bonded groups
         template<class group_data>
@@ -150,16 +163,28 @@ class PYBIND11_EXPORT CommunicatorGPU : public Communicator
         //! Remove tags of ghost particles
         virtual void removeGhostParticleTags();
 
+        //! Let the subscribers set the ghost plans of the local rigid body particles on the GPU
+        virtual bool updateBodyGhostPlans();
+
     private:
         /* General communication */
         unsigned int m_max_stages;                     //!< Maximum number of (dependent) communication stages
         unsigned int m_num_stages;                     //!< Number of stages
         std::vector<unsigned int> m_comm_mask;         //!< Communication mask per stage
         std::vector<int> m_stages;                     //!< Communication stage per unique neighbor
+        bool m_cuda_aware_mpi;                         //!< True if device buffers are passed directly to MPI
+
+        //! Get the location of the buffers passed to MPI
+        access_location::Enum getMPILocation() const
+            {
+            return m_cuda_aware_mpi ? access_location::device : access_location::host;
+            }
 
         /* Particle migration */
         GlobalVector<pdata_element> m_gpu_sendbuf;        //!< Send buffer for particle data
         GlobalVector<pdata_element> m_gpu_recvbuf;        //!< Receive buffer for particle data
+        std::vector<char> m_packed_sendbuf;               //!< Migrating particles packed with their non-default fields
+        std::vector<char> m_packed_recvbuf;               //!< Received packed particles
         GlobalVector<unsigned int> m_comm_flags;          //!< Output buffer for communication flags
 
         GlobalVector<unsigned int> m_send_keys;           //!< Destination rank for particles
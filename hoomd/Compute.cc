@@ -8,6 +8,8 @@
 
 #include "Compute.h"
 
+#include "hoomd/extern/pybind/include/pybind11/stl.h"
+
 namespace py = pybind11;
 
 
@@ -23,7 +25,8 @@ using namespace std;
     \post The Compute is constructed with the given particle data and a NULL profiler.
 */
 Compute::Compute(std::shared_ptr<SystemDefinition> sysdef) : m_sysdef(sysdef), m_pdata(m_sysdef->getParticleData()),
-        m_exec_conf(m_pdata->getExecConf()), m_force_compute(false), m_last_computed(0), m_first_compute(true)
+        m_exec_conf(m_pdata->getExecConf()), m_force_compute(false), m_last_computed(0), m_first_compute(true),
+        m_metric_time(-1)
     {
     // sanity check
     assert(m_sysdef);
@@ -55,6 +58,20 @@ void Compute::setProfiler(std::shared_ptr<Profiler> prof)
     m_prof = prof;
     }
 
+/*! \param name Name of the compute in the System
+
+    Derived classes that support the metric add the wall clock time of their computations to the counter
+    hoomd_compute_seconds_total{compute="name"}. In GPU runs, this is the time to launch the kernels.
+*/
+void Compute::setMetricsName(const std::string& name)
+    {
+    m_metric_time = m_exec_conf->getMetrics()->registerMetric("hoomd_compute_seconds",
+                                                              "compute=\"" + name + "\"",
+                                                              "Wall clock time spent in the compute",
+                                                              Metrics::counter,
+                                                              Metrics::sum);
+    }
+
 /*! \param timestep Current time step
     \returns true if computations should be performed, false if they have already been done
         at this \a timestep.
@@ -128,5 +145,6 @@ void export_Compute(py::module& m)
     .def("benchmark", &Compute::benchmark)
     .def("printStats", &Compute::printStats)
     .def("setProfiler", &Compute::setProfiler)
+    .def("getProvidedLogQuantities", &Compute::getProvidedLogQuantities)
     ;
     }
@@ -91,6 +91,9 @@ class PYBIND11_EXPORT Compute
         //! Sets the profiler for the compute to use
         virtual void setProfiler(std::shared_ptr<Profiler> prof);
 
+        //! Publish the time spent in this compute as a metric
+        void setMetricsName(const std::string& name);
+
         //! Set autotuner parameters
         /*! \param enable Enable/disable autotuning
             \param period period (approximate) in time steps when returning occurs
@@ -163,6 +166,15 @@ class PYBIND11_EXPORT Compute
          */
         void forceCompute(unsigned int timestep);
 
+        //! Add the computational cost of each local particle
+        /*! \param cost Cost per local particle, to be incremented
+
+            The base class adds nothing. Derived classes whose work is distributed unevenly over the particles (for
+            example, in proportion to the number of neighbors) may add a relative cost per particle. LoadBalancer
+            uses the summed cost per rank as the load to balance.
+        */
+        virtual void addParticleCost(std::vector<Scalar>& cost) {}
+
 #ifdef ENABLE_MPI
         //! Set communicator this Compute is to use
         /*! \param comm The communicator
@@ -204,6 +216,8 @@ class PYBIND11_EXPORT Compute
         bool m_force_compute;           //!< true if calculation is enforced
         unsigned int m_last_computed;   //!< Stores the last timestep compute was called
         bool m_first_compute;           //!< true if compute has not yet been called
+        int m_metric_time;              //!< ID of the metric of the time spent in this compute, -1 if not published
+        ClockSource m_metric_clk;       //!< Clock to time the compute for the metric
 
         //! Simple method for testing if the computation should be run or not
         virtual bool shouldCompute(unsigned int timestep);
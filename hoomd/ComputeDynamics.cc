@@ -0,0 +1,324 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+/*! \file ComputeDynamics.cc
+    \brief Contains code for the ComputeDynamics class
+*/
+
+#include "ComputeDynamics.h"
+
+#ifdef ENABLE_MPI
+#include "Communicator.h"
+#include "HOOMDMPI.h"
+#endif
+
+#include <algorithm>
+#include <iostream>
+#include <sstream>
+using namespace std;
+
+namespace py = pybind11;
+
+/*! \param sysdef System to compute the dynamics of
+    \param group Group of particles to average over
+    \param n_origins Number of time origins
+    \param origin_period Number of time steps between consecutive origins
+    \param k Wave number of the self intermediate scattering function
+    \param suffix Suffix to append to the log quantity names
+*/
+ComputeDynamics::ComputeDynamics(std::shared_ptr<SystemDefinition> sysdef,
+                                 std::shared_ptr<ParticleGroup> group,
+                                 unsigned int n_origins,
+                                 unsigned int origin_period,
+                                 Scalar k,
+                                 const std::string& suffix)
+    : Compute(sysdef), m_group(group), m_n_origins(n_origins), m_origin_period(origin_period), m_k(k),
+      m_started(false), m_first_timestep(0), m_n_set(0), m_ref_pitch(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing ComputeDynamics" << endl;
+
+    if (n_origins == 0)
+        {
+        m_exec_conf->msg->error() << "compute.dynamics: at least one time origin is required" << endl;
+        throw runtime_error("Error initializing ComputeDynamics");
+        }
+    if (origin_period == 0)
+        {
+        m_exec_conf->msg->error() << "compute.dynamics: the origin period must be at least 1" << endl;
+        throw runtime_error("Error initializing ComputeDynamics");
+        }
+
+    m_origin_set.resize(n_origins, false);
+    m_origin_timestep.resize(n_origins, 0);
+    m_values.resize(2*n_origins, Scalar(0.0));
+
+    for (unsigned int i = 0; i < n_origins; ++i)
+        {
+        ostringstream o;
+        o << "_" << i << suffix;
+        m_logname_list.push_back("msd" + o.str());
+        m_logname_list.push_back("isf" + o.str());
+        m_logname_list.push_back("msd_origin" + o.str());
+        }
+    for (unsigned int q = 0; q < m_logname_list.size(); ++q)
+        m_logname_idx[m_logname_list[q]] = q;
+
+    checkRefSize();
+    }
+
+ComputeDynamics::~ComputeDynamics()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying ComputeDynamics" << endl;
+    }
+
+/*! The reference arrays store one slot for every tag up to the maximum tag. When particles with larger tags are
+    added, the arrays are enlarged and the existing references are kept.
+*/
+void ComputeDynamics::checkRefSize()
+    {
+    unsigned int pitch = m_pdata->getMaximumTag() + 1;
+    if (pitch <= m_ref_pitch && !m_ref_pos.isNull())
+        return;
+
+    pitch = std::max(pitch, m_ref_pitch);
+    GlobalArray<Scalar3> ref_pos(std::max(1u, m_n_origins*pitch), m_exec_conf);
+    GlobalArray<int3> ref_image(std::max(1u, m_n_origins*pitch), m_exec_conf);
+
+    if (m_ref_pitch > 0)
+        {
+        ArrayHandle<Scalar3> h_old_pos(m_ref_pos, access_location::host, access_mode::read);
+        ArrayHandle<int3> h_old_image(m_ref_image, access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_ref_pos(ref_pos, access_location::host, access_mode::overwrite);
+        ArrayHandle<int3> h_ref_image(ref_image, access_location::host, access_mode::overwrite);
+        std::fill(h_ref_pos.data, h_ref_pos.data + m_n_origins*pitch, make_scalar3(0,0,0));
+        std::fill(h_ref_image.data, h_ref_image.data + m_n_origins*pitch, make_int3(0,0,0));
+        for (unsigned int o = 0; o < m_n_origins; ++o)
+            {
+            std::copy(h_old_pos.data + o*m_ref_pitch, h_old_pos.data + (o+1)*m_ref_pitch, h_ref_pos.data + o*pitch);
+            std::copy(h_old_image.data + o*m_ref_pitch, h_old_image.data + (o+1)*m_ref_pitch,
+                      h_ref_image.data + o*pitch);
+            }
+        }
+
+    m_ref_pos.swap(ref_pos);
+    TAG_ALLOCATION(m_ref_pos);
+    m_ref_image.swap(ref_image);
+    TAG_ALLOCATION(m_ref_image);
+    m_ref_pitch = pitch;
+    }
+
+/*! Sets the origins that are due and computes the quantities of all origins.
+    \param timestep Current time step of the simulation
+*/
+void ComputeDynamics::compute(unsigned int timestep)
+    {
+    if (!shouldCompute(timestep))
+        return;
+
+    if (m_prof) m_prof->push("Dynamics");
+
+    checkRefSize();
+
+    // start over if the time step was reset
+    if (!m_started || timestep < m_first_timestep)
+        {
+        m_started = true;
+        m_first_timestep = timestep;
+        m_n_set = 0;
+        std::fill(m_origin_set.begin(), m_origin_set.end(), false);
+        }
+
+    // number of origins that are due by now, only the last m_n_origins of them are kept
+    unsigned int n_due = (timestep - m_first_timestep) / m_origin_period + 1;
+    if (n_due > m_n_set + m_n_origins)
+        m_n_set = n_due - m_n_origins;
+
+    for (; m_n_set < n_due; ++m_n_set)
+        {
+        unsigned int origin = m_n_set % m_n_origins;
+        setOrigin(origin);
+        m_origin_set[origin] = true;
+        m_origin_timestep[origin] = timestep;
+        }
+
+    std::vector<double> sums(2*m_n_origins, 0.0);
+    computeSums(sums);
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &sums[0], 2*m_n_origins, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    const unsigned int N = m_group->getNumMembersGlobal();
+    for (unsigned int o = 0; o < m_n_origins; ++o)
+        {
+        if (m_origin_set[o] && N > 0)
+            {
+            m_values[2*o] = Scalar(sums[2*o] / double(N));
+            m_values[2*o+1] = Scalar(sums[2*o+1] / double(N));
+            }
+        else
+            {
+            m_values[2*o] = Scalar(0.0);
+            m_values[2*o+1] = Scalar(1.0);
+            }
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param origin Index of the origin to set
+
+    The positions and images of the local members are written to the slots of their tags. In MPI simulations, the
+    slots of the particles on other ranks are filled with a sum over all ranks.
+*/
+void ComputeDynamics::setOrigin(unsigned int origin)
+    {
+    const unsigned int pitch = m_ref_pitch;
+    const unsigned int n_members = m_group->getNumMembers();
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_ref_pos(m_ref_pos, access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_ref_image(m_ref_image, access_location::host, access_mode::readwrite);
+
+    Scalar3 *ref_pos = h_ref_pos.data + origin*pitch;
+    int3 *ref_image = h_ref_image.data + origin*pitch;
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        std::fill(ref_pos, ref_pos + pitch, make_scalar3(0,0,0));
+        std::fill(ref_image, ref_image + pitch, make_int3(0,0,0));
+        }
+    #endif
+
+    for (unsigned int j = 0; j < n_members; ++j)
+        {
+        unsigned int idx = h_index.data[j];
+        unsigned int tag = h_tag.data[idx];
+        ref_pos[tag] = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
+        ref_image[tag] = h_image.data[idx];
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, ref_pos, 3*pitch, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
+        MPI_Allreduce(MPI_IN_PLACE, ref_image, 3*pitch, MPI_INT, MPI_SUM, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+    }
+
+/*! \param sums Sum of the squared displacements and of the scattering terms of every origin (output)
+*/
+void ComputeDynamics::computeSums(std::vector<double>& sums)
+    {
+    const unsigned int pitch = m_ref_pitch;
+    const unsigned int n_members = m_group->getNumMembers();
+    ArrayHandle<unsigned int> h_index(m_group->getIndexArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_ref_pos(m_ref_pos, access_location::host, access_mode::read);
+    ArrayHandle<int3> h_ref_image(m_ref_image, access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getGlobalBox();
+    const bool two_d = m_sysdef->getNDimensions() == 2;
+
+    for (unsigned int j = 0; j < n_members; ++j)
+        {
+        unsigned int idx = h_index.data[j];
+        unsigned int tag = h_tag.data[idx];
+        Scalar3 pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
+        int3 image = h_image.data[idx];
+
+        for (unsigned int o = 0; o < m_n_origins; ++o)
+            {
+            if (!m_origin_set[o])
+                continue;
+
+            int3 ref_image = h_ref_image.data[o*pitch + tag];
+            int3 dimage = make_int3(image.x - ref_image.x, image.y - ref_image.y, image.z - ref_image.z);
+            Scalar3 dr = box.shift(pos - h_ref_pos.data[o*pitch + tag], dimage);
+
+            sums[2*o] += double(dot(dr, dr));
+            if (two_d)
+                sums[2*o+1] += 0.5*(cos(double(m_k*dr.x)) + cos(double(m_k*dr.y)));
+            else
+                sums[2*o+1] += (1./3.)*(cos(double(m_k*dr.x)) + cos(double(m_k*dr.y)) + cos(double(m_k*dr.z)));
+            }
+        }
+    }
+
+/*! \param origin Index of the origin
+    \param quantity 0 for the msd, 1 for the isf and 2 for the time step of the origin
+*/
+Scalar ComputeDynamics::getQuantity(unsigned int origin, unsigned int quantity)
+    {
+    if (origin >= m_n_origins)
+        {
+        m_exec_conf->msg->error() << "compute.dynamics: invalid origin index " << origin << endl;
+        throw runtime_error("Error getting dynamic property");
+        }
+
+    if (quantity == 2)
+        return Scalar(m_origin_timestep[origin]);
+    return m_values[2*origin + quantity];
+    }
+
+/*! \param origin Index of the origin
+*/
+Scalar ComputeDynamics::getMSD(unsigned int origin)
+    {
+    return getQuantity(origin, 0);
+    }
+
+/*! \param origin Index of the origin
+*/
+Scalar ComputeDynamics::getISF(unsigned int origin)
+    {
+    return getQuantity(origin, 1);
+    }
+
+/*! \param origin Index of the origin
+*/
+unsigned int ComputeDynamics::getOriginTimestep(unsigned int origin)
+    {
+    return (unsigned int)getQuantity(origin, 2);
+    }
+
+std::vector< std::string > ComputeDynamics::getProvidedLogQuantities()
+    {
+    return m_logname_list;
+    }
+
+Scalar ComputeDynamics::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    std::map<std::string, unsigned int>::const_iterator it = m_logname_idx.find(quantity);
+    if (it == m_logname_idx.end())
+        {
+        m_exec_conf->msg->error() << "compute.dynamics: " << quantity << " is not a valid log quantity" << endl;
+        throw runtime_error("Error getting log value");
+        }
+
+    compute(timestep);
+    return getQuantity(it->second / 3, it->second % 3);
+    }
+
+void export_ComputeDynamics(py::module& m)
+    {
+    py::class_<ComputeDynamics, std::shared_ptr<ComputeDynamics> >(m,"ComputeDynamics",py::base<Compute>())
+    .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<ParticleGroup>, unsigned int, unsigned int,
+                   Scalar, const std::string& >())
+    .def("getMSD", &ComputeDynamics::getMSD)
+    .def("getISF", &ComputeDynamics::getISF)
+    .def("getOriginTimestep", &ComputeDynamics::getOriginTimestep)
+    ;
+    }
@@ -0,0 +1,120 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "Compute.h"
+#include "GlobalArray.h"
+#include "ParticleGroup.h"
+
+#include <memory>
+#include <map>
+#include <string>
+#include <vector>
+
+/*! \file ComputeDynamics.h
+    \brief Declares a class for computing the mean squared displacement and self intermediate scattering function
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#ifndef __COMPUTE_DYNAMICS_H__
+#define __COMPUTE_DYNAMICS_H__
+
+//! Computes the mean squared displacement and the self intermediate scattering function of a group
+/*! ComputeDynamics measures the displacements of the members of a group from the positions they had at a number of
+    time origins. The reference positions and images of every origin are stored in per-tag arrays that stay resident
+    in the compute (on the device for ComputeDynamicsGPU), so that logging the quantities never gathers a snapshot.
+    Displacements are computed from the differences of the wrapped positions and the images, which keeps their
+    precision independent of how far the particles moved. The sums of all origins are combined with a single
+    MPI_Allreduce.
+
+    For every origin \a i, the compute provides the log quantities
+     - msd_i: the mean squared displacement \f$ \langle |\Delta \vec{r}|^2 \rangle \f$
+     - isf_i: the self intermediate scattering function \f$ \langle \cos(k \Delta x) \rangle \f$ at wave number
+       \f$ k \f$, averaged over the x, y (and z) directions
+     - msd_origin_i: the time step at which origin \a i was set
+
+    each followed by the suffix given to the constructor. Origin \a i is set on the first compute() at or after the
+    time steps \f$ t_0 + (j n + i) T \f$ for \f$ j = 0, 1, \ldots \f$, where \f$ t_0 \f$ is the time step of the
+    first compute(), \a n the number of origins and \a T the origin period. The n origins are therefore staggered by T
+    and each one is reset after \a n T steps.
+
+    Every rank keeps the reference positions of all particles indexed by tag, so that particles can migrate between
+    domains. Setting an origin in MPI simulations sums the reference positions of all ranks with an MPI_Allreduce.
+
+    \ingroup computes
+*/
+class PYBIND11_EXPORT ComputeDynamics : public Compute
+    {
+    public:
+        //! Constructs the compute
+        ComputeDynamics(std::shared_ptr<SystemDefinition> sysdef,
+                        std::shared_ptr<ParticleGroup> group,
+                        unsigned int n_origins,
+                        unsigned int origin_period,
+                        Scalar k,
+                        const std::string& suffix);
+
+        //! Destructor
+        virtual ~ComputeDynamics();
+
+        //! Compute the quantities
+        virtual void compute(unsigned int timestep);
+
+        //! Get the mean squared displacement from an origin last computed by compute()
+        Scalar getMSD(unsigned int origin);
+
+        //! Get the self intermediate scattering function of an origin last computed by compute()
+        Scalar getISF(unsigned int origin);
+
+        //! Get the time step at which an origin was set
+        unsigned int getOriginTimestep(unsigned int origin);
+
+        //! Returns a list of log quantities this compute calculates
+        virtual std::vector< std::string > getProvidedLogQuantities();
+
+        //! Calculates the requested log value and returns it
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+    protected:
+        std::shared_ptr<ParticleGroup> m_group; //!< Group to compute the quantities for
+        unsigned int m_n_origins;               //!< Number of time origins
+        unsigned int m_origin_period;           //!< Number of time steps between consecutive origins
+        Scalar m_k;                             //!< Wave number of the intermediate scattering function
+
+        GlobalArray<Scalar3> m_ref_pos;         //!< Reference positions, (max tag + 1) per origin
+        GlobalArray<int3> m_ref_image;          //!< Reference images, (max tag + 1) per origin
+        std::vector<bool> m_origin_set;         //!< True for the origins that have been set
+        std::vector<unsigned int> m_origin_timestep; //!< Time step at which every origin was set
+        bool m_started;                         //!< True after the first compute()
+        unsigned int m_first_timestep;          //!< Time step of the first compute()
+        unsigned int m_n_set;                   //!< Number of origins set so far
+        unsigned int m_ref_pitch;               //!< Number of slots per origin in the reference arrays
+
+        std::vector<Scalar> m_values;           //!< msd and isf of every origin
+        std::vector<std::string> m_logname_list;    //!< Log quantity names
+        std::map<std::string, unsigned int> m_logname_idx; //!< Index of every log quantity in m_logname_list
+
+        //! Store the positions and images of the local members as the reference of an origin
+        virtual void setOrigin(unsigned int origin);
+
+        //! Sum the squared displacements and the scattering terms of the local members for every origin
+        virtual void computeSums(std::vector<double>& sums);
+
+        //! Resize the reference arrays if the maximum tag has grown
+        void checkRefSize();
+
+        //! Get a quantity of an origin
+        Scalar getQuantity(unsigned int origin, unsigned int quantity);
+    };
+
+//! Exports the ComputeDynamics class to python
+void export_ComputeDynamics(pybind11::module& m);
+
+#endif
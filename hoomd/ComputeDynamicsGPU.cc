@@ -0,0 +1,204 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+/*! \file ComputeDynamicsGPU.cc
+    \brief Contains code for the ComputeDynamicsGPU class
+*/
+
+#include "ComputeDynamicsGPU.h"
+#include "ComputeDynamicsGPU.cuh"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+namespace py = pybind11;
+
+#include <iostream>
+using namespace std;
+
+/*! \param sysdef System to compute the dynamics of
+    \param group Group of particles to average over
+    \param n_origins Number of time origins
+    \param origin_period Number of time steps between consecutive origins
+    \param k Wave number of the self intermediate scattering function
+    \param suffix Suffix to append to the log quantity names
+*/
+ComputeDynamicsGPU::ComputeDynamicsGPU(std::shared_ptr<SystemDefinition> sysdef,
+                                       std::shared_ptr<ParticleGroup> group,
+                                       unsigned int n_origins,
+                                       unsigned int origin_period,
+                                       Scalar k,
+                                       const std::string& suffix)
+    : ComputeDynamics(sysdef, group, n_origins, origin_period, k, suffix)
+    {
+    if (!m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "Creating a ComputeDynamicsGPU with no GPU in the execution configuration" << endl;
+        throw std::runtime_error("Error initializing ComputeDynamicsGPU");
+        }
+
+    m_block_size = 256;
+
+    GlobalArray<Scalar> sums(2*n_origins, m_exec_conf);
+    m_sums.swap(sums);
+    TAG_ALLOCATION(m_sums);
+
+    GlobalArray<Scalar> scratch(2*n_origins, m_exec_conf);
+    m_scratch.swap(scratch);
+    TAG_ALLOCATION(m_scratch);
+
+    GlobalArray<unsigned int> active(n_origins, m_exec_conf);
+    m_active.swap(active);
+    TAG_ALLOCATION(m_active);
+    }
+
+//! Destructor
+ComputeDynamicsGPU::~ComputeDynamicsGPU()
+    {
+    }
+
+/*! \param origin Index of the origin to set
+
+    The reference arrays stay on the device, except in MPI simulations where the slots of the particles on other
+    ranks are filled with a sum over all ranks on the host.
+*/
+void ComputeDynamicsGPU::setOrigin(unsigned int origin)
+    {
+    const unsigned int pitch = m_ref_pitch;
+    const unsigned int n_members = m_group->getNumMembers();
+
+        {
+        ArrayHandle<unsigned int> d_index(m_group->getIndexArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<int3> d_image(m_pdata->getImages(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar3> d_ref_pos(m_ref_pos, access_location::device, access_mode::readwrite);
+        ArrayHandle<int3> d_ref_image(m_ref_image, access_location::device, access_mode::readwrite);
+
+        #ifdef ENABLE_MPI
+        if (m_pdata->getDomainDecomposition())
+            {
+            cudaMemset(d_ref_pos.data + origin*pitch, 0, sizeof(Scalar3)*pitch);
+            cudaMemset(d_ref_image.data + origin*pitch, 0, sizeof(int3)*pitch);
+            }
+        #endif
+
+        if (n_members > 0)
+            {
+            gpu_compute_dynamics_set_origin(d_ref_pos.data + origin*pitch,
+                                            d_ref_image.data + origin*pitch,
+                                            d_index.data,
+                                            n_members,
+                                            d_pos.data,
+                                            d_image.data,
+                                            d_tag.data,
+                                            m_block_size);
+            }
+
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        ArrayHandle<Scalar3> h_ref_pos(m_ref_pos, access_location::host, access_mode::readwrite);
+        ArrayHandle<int3> h_ref_image(m_ref_image, access_location::host, access_mode::readwrite);
+        MPI_Allreduce(MPI_IN_PLACE, h_ref_pos.data + origin*pitch, 3*pitch, MPI_HOOMD_SCALAR, MPI_SUM,
+                      m_exec_conf->getMPICommunicator());
+        MPI_Allreduce(MPI_IN_PLACE, h_ref_image.data + origin*pitch, 3*pitch, MPI_INT, MPI_SUM,
+                      m_exec_conf->getMPICommunicator());
+        }
+    #endif
+    }
+
+/*! \param sums Sum of the squared displacements and of the scattering terms of every origin (output)
+*/
+void ComputeDynamicsGPU::computeSums(std::vector<double>& sums)
+    {
+    const unsigned int n_members = m_group->getNumMembers();
+
+    // list the origins that have been set
+    unsigned int n_active = 0;
+        {
+        ArrayHandle<unsigned int> h_active(m_active, access_location::host, access_mode::overwrite);
+        for (unsigned int o = 0; o < m_n_origins; ++o)
+            if (m_origin_set[o])
+                h_active.data[n_active++] = o;
+        }
+
+    if (n_members == 0 || n_active == 0)
+        return;
+
+    // number of blocks in the reduction
+    unsigned int num_blocks = n_members / m_block_size + 1;
+    if (m_scratch.getNumElements() < 2*m_n_origins*num_blocks)
+        {
+        GlobalArray<Scalar> scratch(2*m_n_origins*num_blocks, m_exec_conf);
+        m_scratch.swap(scratch);
+        TAG_ALLOCATION(m_scratch);
+        }
+
+        {
+        ArrayHandle<unsigned int> d_index(m_group->getIndexArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<int3> d_image(m_pdata->getImages(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar3> d_ref_pos(m_ref_pos, access_location::device, access_mode::read);
+        ArrayHandle<int3> d_ref_image(m_ref_image, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_active(m_active, access_location::device, access_mode::read);
+        ArrayHandle<Scalar> d_scratch(m_scratch, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar> d_sums(m_sums, access_location::device, access_mode::overwrite);
+
+        compute_dynamics_args args;
+        args.d_members = d_index.data;
+        args.n_members = n_members;
+        args.d_pos = d_pos.data;
+        args.d_image = d_image.data;
+        args.d_tag = d_tag.data;
+        args.d_ref_pos = d_ref_pos.data;
+        args.d_ref_image = d_ref_image.data;
+        args.ref_pitch = m_ref_pitch;
+        args.d_active = d_active.data;
+        args.n_active = n_active;
+        args.box = m_pdata->getGlobalBox();
+        args.k = m_k;
+        args.two_d = m_sysdef->getNDimensions() == 2;
+        args.d_scratch = d_scratch.data;
+        args.d_sums = d_sums.data;
+        args.block_size = m_block_size;
+        args.n_blocks = num_blocks;
+
+        gpu_compute_dynamics_partial(args);
+
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+
+        gpu_compute_dynamics_final(args);
+
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    // only the final sums are transferred to the host
+    ArrayHandle<unsigned int> h_active(m_active, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_sums(m_sums, access_location::host, access_mode::read);
+    for (unsigned int a = 0; a < n_active; ++a)
+        {
+        unsigned int o = h_active.data[a];
+        sums[2*o] = h_sums.data[2*a];
+        sums[2*o+1] = h_sums.data[2*a+1];
+        }
+    }
+
+void export_ComputeDynamicsGPU(py::module& m)
+    {
+    py::class_<ComputeDynamicsGPU, std::shared_ptr<ComputeDynamicsGPU> >(m,"ComputeDynamicsGPU",py::base<ComputeDynamics>())
+    .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<ParticleGroup>, unsigned int, unsigned int,
+                   Scalar, const std::string& >())
+    ;
+    }
@@ -0,0 +1,211 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "ComputeDynamicsGPU.cuh"
+
+#include <assert.h>
+
+//! Shared memory used in reducing the sums
+extern __shared__ Scalar compute_dynamics_sdata[];
+
+/*! \file ComputeDynamicsGPU.cu
+    \brief Defines GPU kernel code for computing the mean squared displacement. Used by ComputeDynamicsGPU.
+*/
+
+//! Write the positions and images of the group members into the reference arrays of an origin
+/*! \param d_ref_pos Reference positions of the origin, indexed by tag
+    \param d_ref_image Reference images of the origin, indexed by tag
+    \param d_members Local indices of the group members
+    \param n_members Number of local members
+    \param d_pos Particle positions
+    \param d_image Particle images
+    \param d_tag Particle tags
+*/
+__global__ void gpu_compute_dynamics_set_origin_kernel(Scalar3 *d_ref_pos,
+                                                       int3 *d_ref_image,
+                                                       const unsigned int *d_members,
+                                                       unsigned int n_members,
+                                                       const Scalar4 *d_pos,
+                                                       const int3 *d_image,
+                                                       const unsigned int *d_tag)
+    {
+    unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (group_idx >= n_members)
+        return;
+
+    unsigned int idx = d_members[group_idx];
+    unsigned int tag = d_tag[idx];
+    Scalar4 pos = d_pos[idx];
+    d_ref_pos[tag] = make_scalar3(pos.x, pos.y, pos.z);
+    d_ref_image[tag] = d_image[idx];
+    }
+
+//! Reduce the values of a block in shared memory
+/*! \param val Value of this thread
+    \returns The sum of the block in thread 0
+*/
+__device__ inline Scalar dynamics_block_reduce(Scalar val)
+    {
+    compute_dynamics_sdata[threadIdx.x] = val;
+    __syncthreads();
+
+    int offs = blockDim.x >> 1;
+    while (offs > 0)
+        {
+        if (threadIdx.x < offs)
+            compute_dynamics_sdata[threadIdx.x] += compute_dynamics_sdata[threadIdx.x + offs];
+        offs >>= 1;
+        __syncthreads();
+        }
+
+    Scalar res = compute_dynamics_sdata[0];
+    // the shared memory is reused by the next reduction
+    __syncthreads();
+    return res;
+    }
+
+//! Perform partial sums of the squared displacements and scattering terms of all origins
+/*! \param args Kernel arguments
+
+    One thread is executed per local member. The thread reads its position once and computes its displacement from
+    every active origin. The partial sums of active origin a are written to d_scratch[(2*a + q)*n_blocks + blockIdx.x]
+    with q = 0 for the squared displacements and q = 1 for the scattering terms.
+    sizeof(Scalar)*block_size of dynamic shared memory are needed for this kernel to run.
+*/
+__global__ void gpu_compute_dynamics_partial_sums(const compute_dynamics_args args)
+    {
+    unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    bool active = group_idx < args.n_members;
+    unsigned int tag = 0;
+    Scalar3 pos = make_scalar3(0,0,0);
+    int3 image = make_int3(0,0,0);
+    if (active)
+        {
+        unsigned int idx = args.d_members[group_idx];
+        tag = args.d_tag[idx];
+        Scalar4 postype = args.d_pos[idx];
+        pos = make_scalar3(postype.x, postype.y, postype.z);
+        image = args.d_image[idx];
+        }
+
+    for (unsigned int a = 0; a < args.n_active; ++a)
+        {
+        Scalar msd(0.0);
+        Scalar isf(0.0);
+        if (active)
+            {
+            unsigned int slot = args.d_active[a]*args.ref_pitch + tag;
+            int3 ref_image = args.d_ref_image[slot];
+            int3 dimage = make_int3(image.x - ref_image.x, image.y - ref_image.y, image.z - ref_image.z);
+            Scalar3 dr = args.box.shift(pos - args.d_ref_pos[slot], dimage);
+
+            msd = dot(dr, dr);
+            if (args.two_d)
+                isf = Scalar(1.0/2.0)*(fast::cos(args.k*dr.x) + fast::cos(args.k*dr.y));
+            else
+                isf = Scalar(1.0/3.0)*(fast::cos(args.k*dr.x) + fast::cos(args.k*dr.y) + fast::cos(args.k*dr.z));
+            }
+
+        Scalar res = dynamics_block_reduce(msd);
+        if (threadIdx.x == 0)
+            args.d_scratch[(2*a)*args.n_blocks + blockIdx.x] = res;
+
+        res = dynamics_block_reduce(isf);
+        if (threadIdx.x == 0)
+            args.d_scratch[(2*a+1)*args.n_blocks + blockIdx.x] = res;
+        }
+    }
+
+//! Sum the partial sums of all origins
+/*! \param args Kernel arguments
+
+    One block is executed per sum. The block sums the n_blocks partial sums into d_sums[blockIdx.x].
+    sizeof(Scalar)*block_size of dynamic shared memory are needed for this kernel to run.
+*/
+__global__ void gpu_compute_dynamics_final_sums(const compute_dynamics_args args)
+    {
+    const Scalar *scratch = args.d_scratch + blockIdx.x*args.n_blocks;
+
+    Scalar sum(0.0);
+    for (unsigned int i = threadIdx.x; i < args.n_blocks; i += blockDim.x)
+        sum += scratch[i];
+
+    Scalar res = dynamics_block_reduce(sum);
+    if (threadIdx.x == 0)
+        args.d_sums[blockIdx.x] = res;
+    }
+
+/*! \param d_ref_pos Reference positions of the origin, indexed by tag
+    \param d_ref_image Reference images of the origin, indexed by tag
+    \param d_members Local indices of the group members
+    \param n_members Number of local members
+    \param d_pos Particle positions
+    \param d_image Particle images
+    \param d_tag Particle tags
+    \param block_size Block size to execute
+*/
+cudaError_t gpu_compute_dynamics_set_origin(Scalar3 *d_ref_pos,
+                                            int3 *d_ref_image,
+                                            const unsigned int *d_members,
+                                            unsigned int n_members,
+                                            const Scalar4 *d_pos,
+                                            const int3 *d_image,
+                                            const unsigned int *d_tag,
+                                            unsigned int block_size)
+    {
+    assert(d_ref_pos);
+    assert(d_ref_image);
+
+    dim3 grid(n_members/block_size+1, 1, 1);
+    dim3 threads(block_size, 1, 1);
+
+    gpu_compute_dynamics_set_origin_kernel<<<grid, threads>>>(d_ref_pos,
+                                                              d_ref_image,
+                                                              d_members,
+                                                              n_members,
+                                                              d_pos,
+                                                              d_image,
+                                                              d_tag);
+
+    return cudaSuccess;
+    }
+
+/*! \param args Kernel arguments
+
+    This function drives gpu_compute_dynamics_partial_sums, see it for details.
+*/
+cudaError_t gpu_compute_dynamics_partial(const compute_dynamics_args& args)
+    {
+    assert(args.d_members);
+    assert(args.d_scratch);
+
+    dim3 grid(args.n_blocks, 1, 1);
+    dim3 threads(args.block_size, 1, 1);
+    unsigned int shared_bytes = sizeof(Scalar)*args.block_size;
+
+    gpu_compute_dynamics_partial_sums<<<grid, threads, shared_bytes>>>(args);
+
+    return cudaSuccess;
+    }
+
+/*! \param args Kernel arguments
+
+    This function drives gpu_compute_dynamics_final_sums, see it for details.
+*/
+cudaError_t gpu_compute_dynamics_final(const compute_dynamics_args& args)
+    {
+    assert(args.d_scratch);
+    assert(args.d_sums);
+
+    dim3 grid(2*args.n_active, 1, 1);
+    dim3 threads(args.block_size, 1, 1);
+    unsigned int shared_bytes = sizeof(Scalar)*args.block_size;
+
+    gpu_compute_dynamics_final_sums<<<grid, threads, shared_bytes>>>(args);
+
+    return cudaSuccess;
+    }
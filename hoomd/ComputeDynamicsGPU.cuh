@@ -0,0 +1,57 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#ifndef _COMPUTE_DYNAMICS_GPU_CUH_
+#define _COMPUTE_DYNAMICS_GPU_CUH_
+
+#include <cuda_runtime.h>
+
+#include "ParticleData.cuh"
+#include "HOOMDMath.h"
+
+/*! \file ComputeDynamicsGPU.cuh
+    \brief Kernel driver function declarations for ComputeDynamicsGPU
+    */
+
+//! Holder for arguments to gpu_compute_dynamics_partial
+struct compute_dynamics_args
+    {
+    const unsigned int *d_members;      //!< Local indices of the group members
+    unsigned int n_members;             //!< Number of local members
+    const Scalar4 *d_pos;               //!< Particle positions
+    const int3 *d_image;                //!< Particle images
+    const unsigned int *d_tag;          //!< Particle tags
+    const Scalar3 *d_ref_pos;           //!< Reference positions of all origins
+    const int3 *d_ref_image;            //!< Reference images of all origins
+    unsigned int ref_pitch;             //!< Number of slots per origin in the reference arrays
+    const unsigned int *d_active;       //!< Indices of the origins that have been set
+    unsigned int n_active;              //!< Number of origins that have been set
+    BoxDim box;                         //!< Global box
+    Scalar k;                           //!< Wave number of the scattering function
+    bool two_d;                         //!< True in 2D simulations
+    Scalar *d_scratch;                  //!< 2*n_active*n_blocks partial sums
+    Scalar *d_sums;                     //!< 2*n_active final sums (output)
+    unsigned int block_size;            //!< Block size to execute on the GPU
+    unsigned int n_blocks;              //!< Number of blocks / n_blocks * block_size >= n_members
+    };
+
+//! Writes the positions and images of the group members into the reference arrays of an origin
+cudaError_t gpu_compute_dynamics_set_origin(Scalar3 *d_ref_pos,
+                                            int3 *d_ref_image,
+                                            const unsigned int *d_members,
+                                            unsigned int n_members,
+                                            const Scalar4 *d_pos,
+                                            const int3 *d_image,
+                                            const unsigned int *d_tag,
+                                            unsigned int block_size);
+
+//! Computes the partial sums of all origins for ComputeDynamics
+cudaError_t gpu_compute_dynamics_partial(const compute_dynamics_args& args);
+
+//! Computes the final sums of all origins for ComputeDynamics
+cudaError_t gpu_compute_dynamics_final(const compute_dynamics_args& args);
+
+#endif
@@ -0,0 +1,60 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "ComputeDynamics.h"
+#include "GlobalArray.h"
+
+/*! \file ComputeDynamicsGPU.h
+    \brief Declares a class for computing the mean squared displacement on the GPU
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#ifndef __COMPUTE_DYNAMICS_GPU_H__
+#define __COMPUTE_DYNAMICS_GPU_H__
+
+//! Computes the mean squared displacement and the self intermediate scattering function on the GPU
+/*! ComputeDynamicsGPU is a GPU accelerated implementation of ComputeDynamics. The reference positions stay on the
+    device. One thread is executed per local member, every block reduces the terms of all origins and a second
+    kernel sums the partial sums. Only the 2 sums per origin are copied to the host.
+
+    \ingroup computes
+*/
+class PYBIND11_EXPORT ComputeDynamicsGPU : public ComputeDynamics
+    {
+    public:
+        //! Constructs the compute
+        ComputeDynamicsGPU(std::shared_ptr<SystemDefinition> sysdef,
+                           std::shared_ptr<ParticleGroup> group,
+                           unsigned int n_origins,
+                           unsigned int origin_period,
+                           Scalar k,
+                           const std::string& suffix);
+
+        //! Destructor
+        virtual ~ComputeDynamicsGPU();
+
+    protected:
+        GlobalArray<Scalar> m_scratch;          //!< Scratch space for partial sums
+        GlobalArray<Scalar> m_sums;             //!< Final sums of all origins
+        GlobalArray<unsigned int> m_active;     //!< Indices of the origins that have been set
+        unsigned int m_block_size;              //!< Block size executed
+
+        //! Store the positions and images of the local members as the reference of an origin
+        virtual void setOrigin(unsigned int origin);
+
+        //! Sum the squared displacements and the scattering terms of the local members for every origin
+        virtual void computeSums(std::vector<double>& sums);
+    };
+
+//! Exports the ComputeDynamicsGPU class to python
+void export_ComputeDynamicsGPU(pybind11::module& m);
+
+#endif
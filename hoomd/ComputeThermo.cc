@@ -16,8 +16,18 @@
 #include "HOOMDMPI.h"
 #endif
 
+#include <algorithm>
+
 namespace py = pybind11;
 
+#ifdef ENABLE_MPI
+namespace
+{
+//! Thermo computes whose local properties have not been reduced yet, in the order they were computed
+std::vector<ComputeThermo*> pending_reductions;
+}
+#endif
+
 #include <iostream>
 using namespace std;
 
@@ -67,12 +77,18 @@ ComputeThermo::ComputeThermo(std::shared_ptr<SystemDefinition> sysdef,
 
     #ifdef ENABLE_MPI
     m_properties_reduced = true;
+    m_metric_collective_time = m_exec_conf->getMetrics()->registerCollectiveTime();
     #endif
     }
 
 ComputeThermo::~ComputeThermo()
     {
     m_exec_conf->msg->notice(5) << "Destroying ComputeThermo" << endl;
+
+    #ifdef ENABLE_MPI
+    pending_reductions.erase(std::remove(pending_reductions.begin(), pending_reductions.end(), this),
+                             pending_reductions.end());
+    #endif
     }
 
 /*! \param ndof Number of degrees of freedom to set
@@ -398,23 +414,70 @@ void ComputeThermo::computeProperties()
 
     #ifdef ENABLE_MPI
     // in MPI, reduce extensive quantities only when they're needed
-    m_properties_reduced = !m_pdata->getDomainDecomposition();
+    deferReduction();
     #endif // ENABLE_MPI
 
     if (m_prof) m_prof->pop();
     }
 
 #ifdef ENABLE_MPI
+/*! The reduction is postponed until a property is requested. In the meantime, other thermo computes may compute
+    their properties too (e.g. for the different groups logged by analyze.log), so that all of them are reduced
+    together by reduceProperties().
+*/
+void ComputeThermo::deferReduction()
+    {
+    m_properties_reduced = !m_pdata->getDomainDecomposition();
+
+    if (!m_properties_reduced &&
+        std::find(pending_reductions.begin(), pending_reductions.end(), this) == pending_reductions.end())
+        {
+        pending_reductions.push_back(this);
+        }
+    }
+
+/*! The properties of every thermo compute that is waiting for a reduction on the same communicator are packed
+    into one buffer and summed with a single MPI_Allreduce, so that logging many groups costs only one collective.
+    The pending computes are tracked in the order they were computed, which is the same on all ranks.
+*/
 void ComputeThermo::reduceProperties()
     {
     if (m_properties_reduced) return;
 
+    const MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    std::vector<ComputeThermo*> batch;
+    for (auto thermo : pending_reductions)
+        {
+        if (thermo->m_exec_conf->getMPICommunicator() == mpi_comm)
+            batch.push_back(thermo);
+        }
+
+    // pack the local properties
+    const unsigned int n = thermo_index::num_quantities;
+    std::vector<Scalar> properties(batch.size()*n);
+    for (unsigned int i = 0; i < batch.size(); ++i)
+        {
+        ArrayHandle<Scalar> h_properties(batch[i]->m_properties, access_location::host, access_mode::read);
+        std::copy(h_properties.data, h_properties.data + n, properties.begin() + i*n);
+        }
+
     // reduce properties
-    ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::readwrite);
-    MPI_Allreduce(MPI_IN_PLACE, h_properties.data, thermo_index::num_quantities, MPI_HOOMD_SCALAR,
-            MPI_SUM, m_exec_conf->getMPICommunicator());
+        {
+        MetricsTimer timer(m_exec_conf->getMetrics(), m_metric_collective_time);
+        MPI_Allreduce(MPI_IN_PLACE, properties.data(), batch.size()*n, MPI_HOOMD_SCALAR, MPI_SUM, mpi_comm);
+        }
 
-    m_properties_reduced = true;
+    // unpack the reduced properties
+    for (unsigned int i = 0; i < batch.size(); ++i)
+        {
+        ArrayHandle<Scalar> h_properties(batch[i]->m_properties, access_location::host, access_mode::overwrite);
+        std::copy(properties.begin() + i*n, properties.begin() + (i+1)*n, h_properties.data);
+        batch[i]->m_properties_reduced = true;
+        }
+
+    pending_reductions.erase(std::remove_if(pending_reductions.begin(), pending_reductions.end(),
+                                            [](ComputeThermo* thermo) { return thermo->m_properties_reduced; }),
+                             pending_reductions.end());
     }
 #endif
 
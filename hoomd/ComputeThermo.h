@@ -315,9 +315,13 @@ class PYBIND11_EXPORT ComputeThermo : public Compute
 
         #ifdef ENABLE_MPI
         bool m_properties_reduced;      //!< True if properties have been reduced across MPI
+        unsigned int m_metric_collective_time;  //!< ID of the metric of the time spent in MPI collectives
 
         //! Reduce properties over MPI
         virtual void reduceProperties();
+
+        //! Mark the computed properties as needing a reduction over MPI
+        void deferReduction();
         #endif
     };
 
@@ -0,0 +1,422 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+/*! \file ComputeThermoMulti.cc
+    \brief Contains code for the ComputeThermoMulti class
+*/
+
+#include "ComputeThermoMulti.h"
+#include "VectorMath.h"
+
+#ifdef ENABLE_MPI
+#include "Communicator.h"
+#include "HOOMDMPI.h"
+#endif
+
+#include <algorithm>
+#include <iostream>
+using namespace std;
+
+namespace py = pybind11;
+
+/*! \param sysdef System for which to compute thermodynamic properties
+*/
+ComputeThermoMulti::ComputeThermoMulti(std::shared_ptr<SystemDefinition> sysdef)
+    : Compute(sysdef)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing ComputeThermoMulti" << endl;
+
+    GlobalArray<unsigned int> group_mask(m_pdata->getMaxN(), m_exec_conf);
+    m_group_mask.swap(group_mask);
+    TAG_ALLOCATION(m_group_mask);
+
+    GlobalArray<Scalar> properties(32*thermo_index::num_quantities, m_exec_conf);
+    m_properties.swap(properties);
+    TAG_ALLOCATION(m_properties);
+
+    #ifdef ENABLE_MPI
+    m_properties_reduced = true;
+    #endif
+    }
+
+ComputeThermoMulti::~ComputeThermoMulti()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying ComputeThermoMulti" << endl;
+    }
+
+/*! \param group Group over which properties are calculated
+    \param suffix Suffix to append to the logged quantity names of the group
+*/
+void ComputeThermoMulti::addGroup(std::shared_ptr<ParticleGroup> group, const std::string& suffix)
+    {
+    if (m_groups.size() == 32)
+        {
+        m_exec_conf->msg->error() << "compute.thermo_multi: at most 32 groups are supported" << endl;
+        throw runtime_error("Error adding group to ComputeThermoMulti");
+        }
+
+    const char *names[] = {"temperature", "translational_temperature", "rotational_temperature", "kinetic_energy",
+                           "translational_kinetic_energy", "rotational_kinetic_energy", "potential_energy", "ndof",
+                           "translational_ndof", "rotational_ndof", "num_particles", "pressure", "pressure_xx",
+                           "pressure_xy", "pressure_xz", "pressure_yy", "pressure_yz", "pressure_zz"};
+    for (unsigned int q = 0; q < 18; ++q)
+        {
+        if (m_logname_idx.count(string(names[q]) + suffix))
+            {
+            m_exec_conf->msg->error() << "compute.thermo_multi: duplicate suffix " << suffix << endl;
+            throw runtime_error("Error adding group to ComputeThermoMulti");
+            }
+        }
+
+    for (unsigned int q = 0; q < 18; ++q)
+        {
+        m_logname_idx[string(names[q]) + suffix] = (unsigned int)m_logname_list.size();
+        m_logname_list.push_back(string(names[q]) + suffix);
+        }
+
+    m_groups.push_back(group);
+    m_ndof.push_back(1);
+    m_ndof_rot.push_back(0);
+    }
+
+/*! \param group Index of the group
+    \param ndof Number of degrees of freedom to set
+*/
+void ComputeThermoMulti::setNDOF(unsigned int group, unsigned int ndof)
+    {
+    if (group >= m_groups.size())
+        {
+        m_exec_conf->msg->error() << "compute.thermo_multi: invalid group index " << group << endl;
+        throw runtime_error("Error setting ndof");
+        }
+    if (ndof == 0)
+        {
+        m_exec_conf->msg->warning() << "compute.thermo_multi: given a group with 0 degrees of freedom." << endl
+             << "            overriding ndof=1 to avoid divide by 0 errors" << endl;
+        ndof = 1;
+        }
+
+    m_ndof[group] = ndof;
+    }
+
+/*! \param group Index of the group
+    \param ndof Number of rotational degrees of freedom to set
+*/
+void ComputeThermoMulti::setRotationalNDOF(unsigned int group, unsigned int ndof)
+    {
+    if (group >= m_groups.size())
+        {
+        m_exec_conf->msg->error() << "compute.thermo_multi: invalid group index " << group << endl;
+        throw runtime_error("Error setting ndof");
+        }
+
+    m_ndof_rot[group] = ndof;
+    }
+
+/*! Calls computeProperties if the properties need updating
+    \param timestep Current time step of the simulation
+*/
+void ComputeThermoMulti::compute(unsigned int timestep)
+    {
+    if (!shouldCompute(timestep))
+        return;
+
+    computeProperties();
+    }
+
+std::vector< std::string > ComputeThermoMulti::getProvidedLogQuantities()
+    {
+    return m_logname_list;
+    }
+
+Scalar ComputeThermoMulti::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    std::map<std::string, unsigned int>::const_iterator it = m_logname_idx.find(quantity);
+    if (it == m_logname_idx.end())
+        {
+        m_exec_conf->msg->error() << "compute.thermo_multi: " << quantity << " is not a valid log quantity" << endl;
+        throw runtime_error("Error getting log value");
+        }
+
+    compute(timestep);
+    return getQuantity(it->second / 18, it->second % 18);
+    }
+
+/*! \param group Index of the group
+    \param quantity Index of the quantity in the log quantities of ComputeThermo (0 for temperature, ...)
+
+    \returns The value, or NaN if the particle data flags needed for the quantity are not set
+*/
+Scalar ComputeThermoMulti::getQuantity(unsigned int group, unsigned int quantity)
+    {
+    if (group >= m_groups.size())
+        {
+        m_exec_conf->msg->error() << "compute.thermo_multi: invalid group index " << group << endl;
+        throw runtime_error("Error getting thermodynamic property");
+        }
+
+    // quantities that do not need the computed properties
+    if (quantity == 7)
+        return Scalar(m_ndof[group] + m_ndof_rot[group]);
+    else if (quantity == 8)
+        return Scalar(m_ndof[group]);
+    else if (quantity == 9)
+        return Scalar(m_ndof_rot[group]);
+    else if (quantity == 10)
+        return Scalar(m_groups[group]->getNumMembersGlobal());
+
+    #ifdef ENABLE_MPI
+    if (!m_properties_reduced) reduceProperties();
+    #endif
+
+    PDataFlags flags = m_pdata->getFlags();
+    const Scalar nan = std::numeric_limits<Scalar>::quiet_NaN();
+    ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::read);
+    const Scalar *p = h_properties.data + group*thermo_index::num_quantities;
+    const Scalar ke_trans = p[thermo_index::translational_kinetic_energy];
+    const Scalar ke_rot = p[thermo_index::rotational_kinetic_energy];
+
+    switch (quantity)
+        {
+        case 0:
+            return Scalar(2.0)/(m_ndof[group] + m_ndof_rot[group])*(ke_trans + ke_rot);
+        case 1:
+            return Scalar(2.0)/m_ndof[group]*ke_trans;
+        case 2:
+            if (flags[pdata_flag::rotational_kinetic_energy] && m_ndof_rot[group])
+                return Scalar(2.0)/m_ndof_rot[group]*ke_rot;
+            return nan;
+        case 3:
+            if (flags[pdata_flag::rotational_kinetic_energy])
+                return ke_trans + ke_rot;
+            return ke_trans;
+        case 4:
+            return ke_trans;
+        case 5:
+            return flags[pdata_flag::rotational_kinetic_energy] ? ke_rot : nan;
+        case 6:
+            return flags[pdata_flag::potential_energy] ? p[thermo_index::potential_energy] : nan;
+        case 11:
+            return flags[pdata_flag::isotropic_virial] ? p[thermo_index::pressure] : nan;
+        case 12:
+        case 13:
+        case 14:
+        case 15:
+        case 16:
+        case 17:
+            return flags[pdata_flag::pressure_tensor] ? p[thermo_index::pressure_xx + quantity - 12] : nan;
+        default:
+            m_exec_conf->msg->error() << "compute.thermo_multi: unknown quantity " << quantity << endl;
+            throw runtime_error("Error getting thermodynamic property");
+        }
+    }
+
+/*! Bit g of m_group_mask is set for the members of group g.
+*/
+void ComputeThermoMulti::computeGroupMask()
+    {
+    if (m_group_mask.getNumElements() < m_pdata->getN())
+        {
+        m_group_mask.resize(m_pdata->getMaxN());
+        }
+
+    ArrayHandle<unsigned int> h_group_mask(m_group_mask, access_location::host, access_mode::overwrite);
+    std::fill(h_group_mask.data, h_group_mask.data + m_pdata->getN(), 0);
+
+    for (unsigned int g = 0; g < m_groups.size(); ++g)
+        {
+        const unsigned int bit = 1u << g;
+        ArrayHandle<unsigned int> h_index(m_groups[g]->getIndexArray(), access_location::host, access_mode::read);
+        const unsigned int n_members = m_groups[g]->getNumMembers();
+        for (unsigned int j = 0; j < n_members; ++j)
+            {
+            h_group_mask.data[h_index.data[j]] |= bit;
+            }
+        }
+    }
+
+/*! \param sums thermo_multi_sum::num_sums sums of every group, initialized to zero (output)
+
+    Like ComputeThermo, only the contributions enabled by the particle data flags are summed.
+*/
+void ComputeThermoMulti::computeSums(std::vector<double>& sums)
+    {
+    PDataFlags flags = m_pdata->getFlags();
+    const bool pressure_tensor = flags[pdata_flag::pressure_tensor];
+    const bool isotropic_virial = flags[pdata_flag::isotropic_virial] || pressure_tensor;
+    const bool rotational = flags[pdata_flag::rotational_kinetic_energy];
+    const bool potential_energy = flags[pdata_flag::potential_energy];
+
+    ArrayHandle<unsigned int> h_group_mask(m_group_mask, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+    const unsigned int virial_pitch = m_pdata->getNetVirial().getPitch();
+
+    const unsigned int n_groups = m_groups.size();
+    for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+        {
+        const unsigned int mask = h_group_mask.data[i];
+        if (mask == 0)
+            continue;
+
+        // contributions of the particle
+        double c[thermo_multi_sum::num_sums] = {0.0};
+        const double vx = h_vel.data[i].x, vy = h_vel.data[i].y, vz = h_vel.data[i].z;
+        const double mass = h_vel.data[i].w;
+        c[thermo_multi_sum::translational_kinetic_energy] = 0.5*mass*(vx*vx + vy*vy + vz*vz);
+
+        if (rotational)
+            {
+            Scalar3 I = h_inertia.data[i];
+            quat<Scalar> q(h_orientation.data[i]);
+            quat<Scalar> p(h_angmom.data[i]);
+            quat<Scalar> s(Scalar(0.5)*conj(q)*p);
+
+            double ke_rot = 0.0;
+            if (I.x >= EPSILON)
+                ke_rot += s.v.x*s.v.x/I.x;
+            if (I.y >= EPSILON)
+                ke_rot += s.v.y*s.v.y/I.y;
+            if (I.z >= EPSILON)
+                ke_rot += s.v.z*s.v.z/I.z;
+            c[thermo_multi_sum::rotational_kinetic_energy] = 0.5*ke_rot;
+            }
+
+        if (potential_energy)
+            c[thermo_multi_sum::potential_energy] = h_net_force.data[i].w;
+
+        if (isotropic_virial)
+            {
+            c[thermo_multi_sum::isotropic_virial] = (1./3.)*((double)h_net_virial.data[i+0*virial_pitch] +
+                                                             (double)h_net_virial.data[i+3*virial_pitch] +
+                                                             (double)h_net_virial.data[i+5*virial_pitch]);
+            }
+
+        if (pressure_tensor)
+            {
+            c[thermo_multi_sum::pressure_xx] = mass*vx*vx + (double)h_net_virial.data[i+0*virial_pitch];
+            c[thermo_multi_sum::pressure_xy] = mass*vx*vy + (double)h_net_virial.data[i+1*virial_pitch];
+            c[thermo_multi_sum::pressure_xz] = mass*vx*vz + (double)h_net_virial.data[i+2*virial_pitch];
+            c[thermo_multi_sum::pressure_yy] = mass*vy*vy + (double)h_net_virial.data[i+3*virial_pitch];
+            c[thermo_multi_sum::pressure_yz] = mass*vy*vz + (double)h_net_virial.data[i+4*virial_pitch];
+            c[thermo_multi_sum::pressure_zz] = mass*vz*vz + (double)h_net_virial.data[i+5*virial_pitch];
+            }
+
+        // add them to all groups of the particle
+        for (unsigned int g = 0; g < n_groups; ++g)
+            {
+            if (!(mask & (1u << g)))
+                continue;
+
+            double *group_sums = &sums[g*thermo_multi_sum::num_sums];
+            for (unsigned int k = 0; k < thermo_multi_sum::num_sums; ++k)
+                group_sums[k] += c[k];
+            }
+        }
+    }
+
+/*! Computes the properties of all groups from the sums, in the same way as ComputeThermo::computeProperties().
+*/
+void ComputeThermoMulti::computeProperties()
+    {
+    if (m_prof) m_prof->push("Thermo");
+
+    computeGroupMask();
+
+    std::vector<double> sums(m_groups.size()*thermo_multi_sum::num_sums, 0.0);
+    computeSums(sums);
+
+    PDataFlags flags = m_pdata->getFlags();
+
+    // volume/area & other 2D stuff needed
+    Scalar3 L = m_pdata->getGlobalBox().getL();
+    unsigned int D = m_sysdef->getNDimensions();
+    Scalar volume = (D == 2) ? L.x * L.y : L.x * L.y * L.z;
+
+    double external_virial[6];
+    for (unsigned int k = 0; k < 6; ++k)
+        external_virial[k] = m_pdata->getExternalVirial(k);
+
+    ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::overwrite);
+    for (unsigned int g = 0; g < m_groups.size(); ++g)
+        {
+        Scalar *p = h_properties.data + g*thermo_index::num_quantities;
+        std::fill(p, p + thermo_index::num_quantities, Scalar(0.0));
+
+        if (m_groups[g]->getNumMembersGlobal() == 0)
+            continue;
+
+        const double *s = &sums[g*thermo_multi_sum::num_sums];
+        double ke_trans = s[thermo_multi_sum::translational_kinetic_energy];
+
+        double pe = s[thermo_multi_sum::potential_energy];
+        if (flags[pdata_flag::potential_energy])
+            pe += m_pdata->getExternalEnergy();
+
+        // as in ComputeThermo, the external virial only enters W together with the pressure tensor
+        double W = 0.0;
+        if (flags[pdata_flag::isotropic_virial])
+            {
+            W = s[thermo_multi_sum::isotropic_virial];
+            if (flags[pdata_flag::pressure_tensor])
+                W += (1./3.)*(external_virial[0] + external_virial[3] + external_virial[5]);
+            }
+
+        // W needs to be corrected since the 1/3 factor is built in
+        if (D == 2)
+            W *= 3.0/2.0;
+
+        p[thermo_index::translational_kinetic_energy] = Scalar(ke_trans);
+        p[thermo_index::rotational_kinetic_energy] = Scalar(s[thermo_multi_sum::rotational_kinetic_energy]);
+        p[thermo_index::potential_energy] = Scalar(pe);
+        p[thermo_index::pressure] = Scalar((2.0 * ke_trans / double(D) + W) / volume);
+        for (unsigned int k = 0; k < 6; ++k)
+            {
+            p[thermo_index::pressure_xx + k] = Scalar((s[thermo_multi_sum::pressure_xx + k] + external_virial[k]) / volume);
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    // reduce the properties of all groups together when they are needed
+    m_properties_reduced = !m_pdata->getDomainDecomposition();
+    #endif
+
+    if (m_prof) m_prof->pop();
+    }
+
+#ifdef ENABLE_MPI
+/*! The properties of all groups are summed with a single MPI_Allreduce.
+*/
+void ComputeThermoMulti::reduceProperties()
+    {
+    if (m_properties_reduced) return;
+
+    ArrayHandle<Scalar> h_properties(m_properties, access_location::host, access_mode::readwrite);
+    MPI_Allreduce(MPI_IN_PLACE, h_properties.data, m_groups.size()*thermo_index::num_quantities,
+                  MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
+
+    m_properties_reduced = true;
+    }
+#endif
+
+void export_ComputeThermoMulti(py::module& m)
+    {
+    py::class_<ComputeThermoMulti, std::shared_ptr<ComputeThermoMulti> >(m,"ComputeThermoMulti",py::base<Compute>())
+    .def(py::init< std::shared_ptr<SystemDefinition> >())
+    .def("addGroup", &ComputeThermoMulti::addGroup)
+    .def("getNumGroups", &ComputeThermoMulti::getNumGroups)
+    .def("setNDOF", &ComputeThermoMulti::setNDOF)
+    .def("setRotationalNDOF", &ComputeThermoMulti::setRotationalNDOF)
+    .def("getTemperature", &ComputeThermoMulti::getTemperature)
+    .def("getPressure", &ComputeThermoMulti::getPressure)
+    .def("getKineticEnergy", &ComputeThermoMulti::getKineticEnergy)
+    .def("getPotentialEnergy", &ComputeThermoMulti::getPotentialEnergy)
+    ;
+    }
@@ -0,0 +1,131 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "Compute.h"
+#include "GlobalArray.h"
+#include "ComputeThermoTypes.h"
+#include "ParticleGroup.h"
+
+#include <memory>
+#include <limits>
+#include <map>
+#include <string>
+#include <vector>
+
+/*! \file ComputeThermoMulti.h
+    \brief Declares a class for computing thermodynamic quantities of many groups at once
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#ifndef __COMPUTE_THERMO_MULTI_H__
+#define __COMPUTE_THERMO_MULTI_H__
+
+//! Computes thermodynamic properties of many groups of particles in a single pass
+/*! ComputeThermoMulti calculates the same properties as ComputeThermo for up to 32 groups. Instead of looping over
+    the members of every group, it marks the groups of each local particle in a bit mask, and then reads the data
+    of every particle once and adds its contributions to the sums of all groups it belongs to. In MPI simulations,
+    the properties of all groups are summed with a single MPI_Allreduce.
+
+    Each group provides the log quantities of ComputeThermo with its own suffix. The number of degrees of freedom
+    of every group is set with setNDOF() and setRotationalNDOF(). Groups are added with addGroup().
+
+    \ingroup computes
+*/
+class PYBIND11_EXPORT ComputeThermoMulti : public Compute
+    {
+    public:
+        //! Constructs the compute
+        ComputeThermoMulti(std::shared_ptr<SystemDefinition> sysdef);
+
+        //! Destructor
+        virtual ~ComputeThermoMulti();
+
+        //! Compute the properties
+        virtual void compute(unsigned int timestep);
+
+        //! Get the number of groups
+        unsigned int getNumGroups() const
+            {
+            return (unsigned int)m_groups.size();
+            }
+
+        //! Add a group
+        void addGroup(std::shared_ptr<ParticleGroup> group, const std::string& suffix);
+
+        //! Change the number of translational degrees of freedom of a group
+        void setNDOF(unsigned int group, unsigned int ndof);
+
+        //! Change the number of rotational degrees of freedom of a group
+        void setRotationalNDOF(unsigned int group, unsigned int ndof);
+
+        //! Returns the temperature of a group last computed by compute()
+        Scalar getTemperature(unsigned int group)
+            {
+            return getQuantity(group, 0);
+            }
+
+        //! Returns the pressure of a group last computed by compute()
+        Scalar getPressure(unsigned int group)
+            {
+            return getQuantity(group, 11);
+            }
+
+        //! Returns the total kinetic energy of a group last computed by compute()
+        Scalar getKineticEnergy(unsigned int group)
+            {
+            return getQuantity(group, 3);
+            }
+
+        //! Returns the potential energy of a group last computed by compute()
+        Scalar getPotentialEnergy(unsigned int group)
+            {
+            return getQuantity(group, 6);
+            }
+
+        //! Returns a list of log quantities this compute calculates
+        virtual std::vector< std::string > getProvidedLogQuantities();
+
+        //! Calculates the requested log value and returns it
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+    protected:
+        std::vector< std::shared_ptr<ParticleGroup> > m_groups; //!< Groups to compute properties for
+        std::vector<unsigned int> m_ndof;       //!< Number of translational degrees of freedom of each group
+        std::vector<unsigned int> m_ndof_rot;   //!< Number of rotational degrees of freedom of each group
+        GlobalArray<unsigned int> m_group_mask; //!< Bit g is set if the local particle is a member of group g
+        GlobalArray<Scalar> m_properties;       //!< thermo_index::num_quantities properties per group
+        std::vector<std::string> m_logname_list;    //!< Log quantity names, ComputeThermo order for every group
+        std::map<std::string, unsigned int> m_logname_idx; //!< Index of every log quantity in m_logname_list
+
+        //! Mark the groups of every local particle in m_group_mask
+        virtual void computeGroupMask();
+
+        //! Sum the contributions of the particles to every group
+        virtual void computeSums(std::vector<double>& sums);
+
+        //! Does the actual computation
+        void computeProperties();
+
+        //! Get a property of a group, by the index of its log quantity in ComputeThermo
+        Scalar getQuantity(unsigned int group, unsigned int quantity);
+
+        #ifdef ENABLE_MPI
+        bool m_properties_reduced;      //!< True if properties have been reduced across MPI
+
+        //! Reduce properties of all groups over MPI
+        void reduceProperties();
+        #endif
+    };
+
+//! Exports the ComputeThermoMulti class to python
+void export_ComputeThermoMulti(pybind11::module& m);
+
+#endif
@@ -0,0 +1,145 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+/*! \file ComputeThermoMultiGPU.cc
+    \brief Contains code for the ComputeThermoMultiGPU class
+*/
+
+#include "ComputeThermoMultiGPU.h"
+#include "ComputeThermoMultiGPU.cuh"
+
+namespace py = pybind11;
+
+#include <iostream>
+using namespace std;
+
+/*! \param sysdef System for which to compute thermodynamic properties
+*/
+ComputeThermoMultiGPU::ComputeThermoMultiGPU(std::shared_ptr<SystemDefinition> sysdef)
+    : ComputeThermoMulti(sysdef)
+    {
+    if (!m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "Creating a ComputeThermoMultiGPU with no GPU in the execution configuration" << endl;
+        throw std::runtime_error("Error initializing ComputeThermoMultiGPU");
+        }
+
+    m_block_size = 256;
+
+    GlobalArray<Scalar> sums(32*thermo_multi_sum::num_sums, m_exec_conf);
+    m_sums.swap(sums);
+    TAG_ALLOCATION(m_sums);
+
+    GlobalArray<Scalar> scratch(32*thermo_multi_sum::num_sums, m_exec_conf);
+    m_scratch.swap(scratch);
+    TAG_ALLOCATION(m_scratch);
+    }
+
+//! Destructor
+ComputeThermoMultiGPU::~ComputeThermoMultiGPU()
+    {
+    }
+
+/*! Bit g of m_group_mask is set for the members of group g.
+*/
+void ComputeThermoMultiGPU::computeGroupMask()
+    {
+    if (m_group_mask.getNumElements() < m_pdata->getN())
+        {
+        m_group_mask.resize(m_pdata->getMaxN());
+        }
+
+    ArrayHandle<unsigned int> d_group_mask(m_group_mask, access_location::device, access_mode::overwrite);
+    cudaMemset(d_group_mask.data, 0, sizeof(unsigned int)*m_pdata->getN());
+
+    for (unsigned int g = 0; g < m_groups.size(); ++g)
+        {
+        const unsigned int n_members = m_groups[g]->getNumMembers();
+        if (n_members == 0)
+            continue;
+
+        ArrayHandle<unsigned int> d_index(m_groups[g]->getIndexArray(), access_location::device, access_mode::read);
+        gpu_compute_thermo_multi_mask(d_group_mask.data, d_index.data, n_members, g, m_block_size);
+        }
+
+    if(m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    }
+
+/*! \param sums thermo_multi_sum::num_sums sums of every group, initialized to zero (output)
+*/
+void ComputeThermoMultiGPU::computeSums(std::vector<double>& sums)
+    {
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_groups = m_groups.size();
+    if (N == 0 || n_groups == 0)
+        return;
+
+    // number of blocks in the reduction
+    unsigned int num_blocks = N / m_block_size + 1;
+    if (m_scratch.getNumElements() < n_groups*thermo_multi_sum::num_sums*num_blocks)
+        {
+        GlobalArray<Scalar> scratch(n_groups*thermo_multi_sum::num_sums*num_blocks, m_exec_conf);
+        m_scratch.swap(scratch);
+        TAG_ALLOCATION(m_scratch);
+        }
+
+    PDataFlags flags = m_pdata->getFlags();
+
+        {
+        ArrayHandle<unsigned int> d_group_mask(m_group_mask, access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_net_force(m_pdata->getNetForce(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar> d_net_virial(m_pdata->getNetVirial(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_angmom(m_pdata->getAngularMomentumArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar3> d_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar> d_scratch(m_scratch, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar> d_sums(m_sums, access_location::device, access_mode::overwrite);
+
+        compute_thermo_multi_args args;
+        args.d_group_mask = d_group_mask.data;
+        args.d_vel = d_vel.data;
+        args.d_net_force = d_net_force.data;
+        args.d_net_virial = d_net_virial.data;
+        args.d_orientation = d_orientation.data;
+        args.d_angmom = d_angmom.data;
+        args.d_inertia = d_inertia.data;
+        args.virial_pitch = m_pdata->getNetVirial().getPitch();
+        args.N = N;
+        args.n_groups = n_groups;
+        args.d_scratch = d_scratch.data;
+        args.d_sums = d_sums.data;
+        args.block_size = m_block_size;
+        args.n_blocks = num_blocks;
+        args.compute_pressure_tensor = flags[pdata_flag::pressure_tensor];
+        args.compute_isotropic_virial = flags[pdata_flag::isotropic_virial] || args.compute_pressure_tensor;
+        args.compute_rotational_energy = flags[pdata_flag::rotational_kinetic_energy];
+        args.compute_potential_energy = flags[pdata_flag::potential_energy];
+
+        gpu_compute_thermo_multi_partial(args);
+
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+
+        gpu_compute_thermo_multi_final(args);
+
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    // only the final sums are transferred to the host
+    ArrayHandle<Scalar> h_sums(m_sums, access_location::host, access_mode::read);
+    for (unsigned int k = 0; k < n_groups*thermo_multi_sum::num_sums; ++k)
+        sums[k] = h_sums.data[k];
+    }
+
+void export_ComputeThermoMultiGPU(py::module& m)
+    {
+    py::class_<ComputeThermoMultiGPU, std::shared_ptr<ComputeThermoMultiGPU> >(m,"ComputeThermoMultiGPU",py::base<ComputeThermoMulti>())
+    .def(py::init< std::shared_ptr<SystemDefinition> >())
+    ;
+    }
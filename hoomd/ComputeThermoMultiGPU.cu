@@ -0,0 +1,230 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "ComputeThermoMultiGPU.cuh"
+#include "VectorMath.h"
+
+#include <assert.h>
+
+//! Shared memory used in reducing the sums
+extern __shared__ Scalar compute_thermo_multi_sdata[];
+
+/*! \file ComputeThermoMultiGPU.cu
+    \brief Defines GPU kernel code for computing thermodynamic properties of many groups. Used by ComputeThermoMultiGPU.
+*/
+
+//! Set the bit of a group in the mask of its members
+/*! \param d_group_mask Group membership bits of every particle
+    \param d_group_members Members of the group
+    \param group_size Number of members
+    \param bit Bit of the group
+*/
+__global__ void gpu_compute_thermo_multi_mask_kernel(unsigned int *d_group_mask,
+                                                     const unsigned int *d_group_members,
+                                                     unsigned int group_size,
+                                                     unsigned int bit)
+    {
+    unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (group_idx >= group_size)
+        return;
+
+    atomicOr(&d_group_mask[d_group_members[group_idx]], bit);
+    }
+
+//! Reduce the values of a block in shared memory
+/*! \param val Value of this thread
+    \returns The sum of the block in thread 0
+*/
+__device__ inline Scalar thermo_multi_block_reduce(Scalar val)
+    {
+    compute_thermo_multi_sdata[threadIdx.x] = val;
+    __syncthreads();
+
+    int offs = blockDim.x >> 1;
+    while (offs > 0)
+        {
+        if (threadIdx.x < offs)
+            compute_thermo_multi_sdata[threadIdx.x] += compute_thermo_multi_sdata[threadIdx.x + offs];
+        offs >>= 1;
+        __syncthreads();
+        }
+
+    Scalar res = compute_thermo_multi_sdata[0];
+    // the shared memory is reused by the next reduction
+    __syncthreads();
+    return res;
+    }
+
+//! Perform partial sums of the thermo properties of all groups
+/*! \param args Kernel arguments
+
+    One thread is executed per local particle. The thread computes all contributions of its particle once, and the
+    block reduces them for every group the particle is a member of. Groups without members in the block are skipped.
+    The partial sum of sum q of group g is written to d_scratch[(g*num_sums + q)*n_blocks + blockIdx.x].
+    sizeof(Scalar)*block_size of dynamic shared memory are needed for this kernel to run.
+*/
+__global__ void gpu_compute_thermo_multi_partial_sums(const compute_thermo_multi_args args)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    Scalar c[thermo_multi_sum::num_sums];
+    for (unsigned int k = 0; k < thermo_multi_sum::num_sums; ++k)
+        c[k] = Scalar(0.0);
+
+    unsigned int mask = 0;
+    if (idx < args.N)
+        {
+        mask = args.d_group_mask[idx];
+        }
+
+    if (mask)
+        {
+        Scalar4 vel = args.d_vel[idx];
+        Scalar mass = vel.w;
+        c[thermo_multi_sum::translational_kinetic_energy] =
+            Scalar(0.5) * mass * (vel.x*vel.x + vel.y*vel.y + vel.z*vel.z);
+
+        if (args.compute_rotational_energy)
+            {
+            Scalar3 I = args.d_inertia[idx];
+            quat<Scalar> q(args.d_orientation[idx]);
+            quat<Scalar> p(args.d_angmom[idx]);
+            quat<Scalar> s(Scalar(0.5)*conj(q)*p);
+
+            Scalar ke_rot(0.0);
+            if (I.x >= EPSILON)
+                ke_rot += s.v.x*s.v.x/I.x;
+            if (I.y >= EPSILON)
+                ke_rot += s.v.y*s.v.y/I.y;
+            if (I.z >= EPSILON)
+                ke_rot += s.v.z*s.v.z/I.z;
+            c[thermo_multi_sum::rotational_kinetic_energy] = Scalar(0.5)*ke_rot;
+            }
+
+        if (args.compute_potential_energy)
+            c[thermo_multi_sum::potential_energy] = args.d_net_force[idx].w;
+
+        const unsigned int pitch = args.virial_pitch;
+        if (args.compute_isotropic_virial)
+            {
+            c[thermo_multi_sum::isotropic_virial] = Scalar(1.0/3.0)*(args.d_net_virial[0*pitch+idx]
+                                                                    +args.d_net_virial[3*pitch+idx]
+                                                                    +args.d_net_virial[5*pitch+idx]);
+            }
+
+        if (args.compute_pressure_tensor)
+            {
+            c[thermo_multi_sum::pressure_xx] = mass*vel.x*vel.x + args.d_net_virial[0*pitch+idx];
+            c[thermo_multi_sum::pressure_xy] = mass*vel.x*vel.y + args.d_net_virial[1*pitch+idx];
+            c[thermo_multi_sum::pressure_xz] = mass*vel.x*vel.z + args.d_net_virial[2*pitch+idx];
+            c[thermo_multi_sum::pressure_yy] = mass*vel.y*vel.y + args.d_net_virial[3*pitch+idx];
+            c[thermo_multi_sum::pressure_yz] = mass*vel.y*vel.z + args.d_net_virial[4*pitch+idx];
+            c[thermo_multi_sum::pressure_zz] = mass*vel.z*vel.z + args.d_net_virial[5*pitch+idx];
+            }
+        }
+
+    for (unsigned int g = 0; g < args.n_groups; ++g)
+        {
+        const bool member = (mask >> g) & 1;
+        Scalar *scratch = args.d_scratch + g*thermo_multi_sum::num_sums*args.n_blocks + blockIdx.x;
+
+        // the condition is uniform across the block
+        if (!__syncthreads_or(member))
+            {
+            if (threadIdx.x == 0)
+                {
+                for (unsigned int k = 0; k < thermo_multi_sum::num_sums; ++k)
+                    scratch[k*args.n_blocks] = Scalar(0.0);
+                }
+            continue;
+            }
+
+        for (unsigned int k = 0; k < thermo_multi_sum::num_sums; ++k)
+            {
+            Scalar res = thermo_multi_block_reduce(member ? c[k] : Scalar(0.0));
+            if (threadIdx.x == 0)
+                scratch[k*args.n_blocks] = res;
+            }
+        }
+    }
+
+//! Sum the partial sums of all groups
+/*! \param args Kernel arguments
+
+    One block is executed per sum of every group. The block sums the n_blocks partial sums into d_sums[blockIdx.x].
+    sizeof(Scalar)*block_size of dynamic shared memory are needed for this kernel to run.
+*/
+__global__ void gpu_compute_thermo_multi_final_sums(const compute_thermo_multi_args args)
+    {
+    const Scalar *scratch = args.d_scratch + blockIdx.x*args.n_blocks;
+
+    Scalar sum(0.0);
+    for (unsigned int i = threadIdx.x; i < args.n_blocks; i += blockDim.x)
+        sum += scratch[i];
+
+    Scalar res = thermo_multi_block_reduce(sum);
+    if (threadIdx.x == 0)
+        args.d_sums[blockIdx.x] = res;
+    }
+
+/*! \param d_group_mask Group membership bits of every particle
+    \param d_group_members Members of the group
+    \param group_size Number of members
+    \param group Index of the group
+    \param block_size Block size to execute
+*/
+cudaError_t gpu_compute_thermo_multi_mask(unsigned int *d_group_mask,
+                                          const unsigned int *d_group_members,
+                                          unsigned int group_size,
+                                          unsigned int group,
+                                          unsigned int block_size)
+    {
+    assert(d_group_mask);
+    assert(d_group_members);
+
+    dim3 grid(group_size/block_size+1, 1, 1);
+    dim3 threads(block_size, 1, 1);
+
+    gpu_compute_thermo_multi_mask_kernel<<<grid, threads>>>(d_group_mask, d_group_members, group_size, 1u << group);
+
+    return cudaSuccess;
+    }
+
+/*! \param args Kernel arguments
+
+    This function drives gpu_compute_thermo_multi_partial_sums, see it for details.
+*/
+cudaError_t gpu_compute_thermo_multi_partial(const compute_thermo_multi_args& args)
+    {
+    assert(args.d_group_mask);
+    assert(args.d_scratch);
+
+    dim3 grid(args.n_blocks, 1, 1);
+    dim3 threads(args.block_size, 1, 1);
+    unsigned int shared_bytes = sizeof(Scalar)*args.block_size;
+
+    gpu_compute_thermo_multi_partial_sums<<<grid, threads, shared_bytes>>>(args);
+
+    return cudaSuccess;
+    }
+
+/*! \param args Kernel arguments
+
+    This function drives gpu_compute_thermo_multi_final_sums, see it for details.
+*/
+cudaError_t gpu_compute_thermo_multi_final(const compute_thermo_multi_args& args)
+    {
+    assert(args.d_scratch);
+    assert(args.d_sums);
+
+    dim3 grid(args.n_groups*thermo_multi_sum::num_sums, 1, 1);
+    dim3 threads(args.block_size, 1, 1);
+    unsigned int shared_bytes = sizeof(Scalar)*args.block_size;
+
+    gpu_compute_thermo_multi_final_sums<<<grid, threads, shared_bytes>>>(args);
+
+    return cudaSuccess;
+    }
@@ -0,0 +1,56 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#ifndef _COMPUTE_THERMO_MULTI_GPU_CUH_
+#define _COMPUTE_THERMO_MULTI_GPU_CUH_
+
+#include <cuda_runtime.h>
+
+#include "ParticleData.cuh"
+#include "ComputeThermoTypes.h"
+#include "HOOMDMath.h"
+
+/*! \file ComputeThermoMultiGPU.cuh
+    \brief Kernel driver function declarations for ComputeThermoMultiGPU
+    */
+
+//! Holder for arguments to gpu_compute_thermo_multi_partial
+struct compute_thermo_multi_args
+    {
+    const unsigned int *d_group_mask;   //!< Group membership bits of every particle
+    const Scalar4 *d_vel;               //!< Particle velocities and masses
+    const Scalar4 *d_net_force;         //!< Net force / pe array to sum
+    const Scalar *d_net_virial;         //!< Net virial array to sum
+    const Scalar4 *d_orientation;       //!< Particle data orientations
+    const Scalar4 *d_angmom;            //!< Particle data conjugate quaternions
+    const Scalar3 *d_inertia;           //!< Particle data moments of inertia
+    unsigned int virial_pitch;          //!< Pitch of 2D net_virial array
+    unsigned int N;                     //!< Number of local particles
+    unsigned int n_groups;              //!< Number of groups
+    Scalar *d_scratch;                  //!< n_groups*thermo_multi_sum::num_sums*n_blocks partial sums
+    Scalar *d_sums;                     //!< n_groups*thermo_multi_sum::num_sums final sums (output)
+    unsigned int block_size;            //!< Block size to execute on the GPU
+    unsigned int n_blocks;              //!< Number of blocks / n_blocks * block_size >= N
+    bool compute_isotropic_virial;      //!< True if the isotropic virial is summed
+    bool compute_pressure_tensor;       //!< True if the pressure tensor is summed
+    bool compute_rotational_energy;     //!< True if the rotational kinetic energy is summed
+    bool compute_potential_energy;      //!< True if the potential energy is summed
+    };
+
+//! Sets the bit of a group in the group mask of its members
+cudaError_t gpu_compute_thermo_multi_mask(unsigned int *d_group_mask,
+                                          const unsigned int *d_group_members,
+                                          unsigned int group_size,
+                                          unsigned int group,
+                                          unsigned int block_size);
+
+//! Computes the partial sums of all groups for ComputeThermoMulti
+cudaError_t gpu_compute_thermo_multi_partial(const compute_thermo_multi_args& args);
+
+//! Computes the final sums of all groups for ComputeThermoMulti
+cudaError_t gpu_compute_thermo_multi_final(const compute_thermo_multi_args& args);
+
+#endif
@@ -0,0 +1,55 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "ComputeThermoMulti.h"
+#include "GlobalArray.h"
+
+/*! \file ComputeThermoMultiGPU.h
+    \brief Declares a class for computing thermodynamic quantities of many groups on the GPU
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#ifndef __COMPUTE_THERMO_MULTI_GPU_H__
+#define __COMPUTE_THERMO_MULTI_GPU_H__
+
+//! Computes thermodynamic properties of many groups of particles on the GPU
+/*! ComputeThermoMultiGPU is a GPU accelerated implementation of ComputeThermoMulti. Every block reduces the
+    contributions of its particles to all groups, skipping groups without members in the block, and a second
+    kernel sums the partial sums of all groups. Only the G*thermo_multi_sum::num_sums final sums are copied to
+    the host.
+
+    \ingroup computes
+*/
+class PYBIND11_EXPORT ComputeThermoMultiGPU : public ComputeThermoMulti
+    {
+    public:
+        //! Constructs the compute
+        ComputeThermoMultiGPU(std::shared_ptr<SystemDefinition> sysdef);
+
+        //! Destructor
+        virtual ~ComputeThermoMultiGPU();
+
+    protected:
+        GlobalArray<Scalar> m_scratch;  //!< Scratch space for partial sums
+        GlobalArray<Scalar> m_sums;     //!< Final sums of all groups
+        unsigned int m_block_size;      //!< Block size executed
+
+        //! Mark the groups of every local particle in m_group_mask
+        virtual void computeGroupMask();
+
+        //! Sum the contributions of the particles to every group
+        virtual void computeSums(std::vector<double>& sums);
+    };
+
+//! Exports the ComputeThermoMultiGPU class to python
+void export_ComputeThermoMultiGPU(pybind11::module& m);
+
+#endif
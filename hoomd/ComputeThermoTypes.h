@@ -32,6 +32,26 @@ struct thermo_index
         };
     };
 
+//! Enum for indexing the per-group sums of ComputeThermoMulti
+struct thermo_multi_sum
+    {
+    //! The enum
+    enum Enum
+        {
+        translational_kinetic_energy=0,  //!< Sum of m v^2 / 2
+        rotational_kinetic_energy,       //!< Rotational kinetic energy
+        potential_energy,                //!< Sum of the potential energy
+        isotropic_virial,                //!< Sum of 1/3 trace of the virial tensor
+        pressure_xx,                     //!< Sum of m v_x v_x + virial_xx
+        pressure_xy,                     //!< Sum of m v_x v_y + virial_xy
+        pressure_xz,                     //!< Sum of m v_x v_z + virial_xz
+        pressure_yy,                     //!< Sum of m v_y v_y + virial_yy
+        pressure_yz,                     //!< Sum of m v_y v_z + virial_yz
+        pressure_zz,                     //!< Sum of m v_z v_z + virial_zz
+        num_sums                         // final element to count number of sums
+        };
+    };
+
 //! structure for storing the components of the pressure tensor
 struct PressureTensor
     {
@@ -70,7 +70,7 @@ DCDDumpWriter::DCDDumpWriter(std::shared_ptr<SystemDefinition> sysdef,
     : Analyzer(sysdef), m_fname(fname), m_start_timestep(0), m_period(period), m_group(group),
       m_num_frames_written(0), m_last_written_step(0), m_appending(false),
       m_unwrap_full(false), m_unwrap_rigid(false), m_angle(false),
-      m_overwrite(overwrite), m_is_initialized(false)
+      m_overwrite(overwrite), m_is_initialized(false), m_frame(sysdef->getParticleData())
     {
     m_exec_conf->msg->notice(5) << "Constructing DCDDumpWriter: " << fname << " " << period << " " << overwrite << endl;
     }
@@ -147,10 +147,16 @@ void DCDDumpWriter::analyze(unsigned int timestep)
     if (m_prof)
         m_prof->push("Dump DCD");
 
-    // take particle data snapshot
-    SnapshotParticleData<Scalar> snapshot;
+    // gather only the single precision positions (and what is needed to unwrap them) in tag order
+    unsigned int flags = 0;
+    if (m_unwrap_full || m_unwrap_rigid)
+        flags |= ParticleFrameGather::frame_image;
+    if (m_unwrap_rigid)
+        flags |= ParticleFrameGather::frame_body;
+    if (m_angle)
+        flags |= ParticleFrameGather::frame_orientation;
 
-    m_pdata->takeSnapshot(snapshot);
+    m_frame.gather(flags);
 
 #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
@@ -187,7 +193,7 @@ void DCDDumpWriter::analyze(unsigned int timestep)
     // write the data for the current time step
     m_file.seekp(0, std::ios_base::end);
     write_frame_header(m_file);
-    write_frame_data(m_file, snapshot);
+    write_frame_data(m_file);
 
     // update the header with the number of frames written
     m_num_frames_written++;
@@ -306,10 +312,9 @@ void DCDDumpWriter::write_frame_header(std::fstream &file)
     }
 
 /*! \param file File to write to
-    \param snapshot Snapshot to write
-    Writes the actual particle positions for all particles at the current time step
+    Writes the actual particle positions gathered in m_frame for all particles at the current time step
 */
-void DCDDumpWriter::write_frame_data(std::fstream &file, const SnapshotParticleData<Scalar>& snapshot)
+void DCDDumpWriter::write_frame_data(std::fstream &file)
     {
     // we need to unsort the positions and write in tag order
     assert(m_staging_buffer);
@@ -318,28 +323,35 @@ void DCDDumpWriter::write_frame_data(std::fstream &file, const SnapshotParticleD
 
     unsigned int nparticles = m_group->getNumMembersGlobal();
 
+    const std::vector<float3>& pos = m_frame.getPositions();
+    const std::vector<int3>& image = m_frame.getImages();
+    const std::vector<unsigned int>& body = m_frame.getBodies();
+    const std::vector<float4>& orientation = m_frame.getOrientations();
+
     // Create a tmp copy of the particle data and unwrap particles
-    std::vector< vec3<Scalar> > tmp_pos(snapshot.pos);
+    std::vector<float3> tmp_pos(pos);
     for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
         {
         unsigned int i = m_group->getMemberTag(group_idx);
 
         if (m_unwrap_full)
             {
-            tmp_pos[i] = box.shift(tmp_pos[i], snapshot.image[i]);
+            Scalar3 p = box.shift(make_scalar3(pos[i].x, pos[i].y, pos[i].z), image[i]);
+            tmp_pos[i] = make_float3(p.x, p.y, p.z);
             }
-        else if (m_unwrap_rigid && snapshot.body[i] != NO_BODY)
+        else if (m_unwrap_rigid && body[i] != NO_BODY)
             {
-            unsigned int central_ptl_tag = snapshot.body[i];
-            int body_ix = snapshot.image[central_ptl_tag].x;
-            int body_iy = snapshot.image[central_ptl_tag].y;
-            int body_iz = snapshot.image[central_ptl_tag].z;
-            int3 particle_img = snapshot.image[i];
+            unsigned int central_ptl_tag = body[i];
+            int body_ix = image[central_ptl_tag].x;
+            int body_iy = image[central_ptl_tag].y;
+            int body_iz = image[central_ptl_tag].z;
+            int3 particle_img = image[i];
             int3 img_diff = make_int3(particle_img.x - body_ix,
                                       particle_img.y - body_iy,
                                       particle_img.z - body_iz);
 
-            tmp_pos[i] = box.shift(tmp_pos[i], img_diff);
+            Scalar3 p = box.shift(make_scalar3(pos[i].x, pos[i].y, pos[i].z), img_diff);
+            tmp_pos[i] = make_float3(p.x, p.y, p.z);
             }
         }
 
@@ -347,7 +359,7 @@ void DCDDumpWriter::write_frame_data(std::fstream &file, const SnapshotParticleD
     for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
         {
         unsigned int i = m_group->getMemberTag(group_idx);
-        m_staging_buffer[group_idx] = float(tmp_pos[i].x);
+        m_staging_buffer[group_idx] = tmp_pos[i].x;
         }
 
     // write x coords
@@ -359,7 +371,7 @@ void DCDDumpWriter::write_frame_data(std::fstream &file, const SnapshotParticleD
     for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
         {
         unsigned int i = m_group->getMemberTag(group_idx);
-        m_staging_buffer[group_idx] = float(tmp_pos[i].y);
+        m_staging_buffer[group_idx] = tmp_pos[i].y;
         }
 
     // write y coords
@@ -371,13 +383,13 @@ void DCDDumpWriter::write_frame_data(std::fstream &file, const SnapshotParticleD
     for (unsigned int group_idx = 0; group_idx < nparticles; group_idx++)
         {
         unsigned int i = m_group->getMemberTag(group_idx);
-        m_staging_buffer[group_idx] = float(tmp_pos[i].z);
+        m_staging_buffer[group_idx] = tmp_pos[i].z;
 
         // m_angle set to True turns on a hack where the particle orientation angle is written out to the z component
         // this only works in 2D simulations, obviously
         if (m_angle)
             {
-            m_staging_buffer[group_idx] = float(atan2(snapshot.orientation[i].v.z, snapshot.orientation[i].s) * 2);
+            m_staging_buffer[group_idx] = float(atan2(orientation[i].w, orientation[i].x) * 2);
             }
         }
 
@@ -9,6 +9,7 @@
 
 #include "Analyzer.h"
 #include "ParticleGroup.h"
+#include "ParticleFrameGather.h"
 
 #include <string>
 #include <memory>
@@ -99,6 +100,7 @@ class PYBIND11_EXPORT DCDDumpWriter : public Analyzer
         unsigned int m_nglobal;             //!< Initial number of particles
 
         float *m_staging_buffer;            //!< Buffer for staging particle positions in tag order
+        ParticleFrameGather m_frame;        //!< Gathers the single precision positions in tag order
         std::fstream m_file;                //!< The file object
 
         // helper functions
@@ -108,7 +110,7 @@ class PYBIND11_EXPORT DCDDumpWriter : public Analyzer
         //! Writes the frame header
         void write_frame_header(std::fstream &file);
         //! Writes the particle positions for a frame
-        void write_frame_data(std::fstream &file, const SnapshotParticleData<Scalar>& snapshot);
+        void write_frame_data(std::fstream &file);
         //! Updates the file header
         void write_updated_header(std::fstream &file, unsigned int timestep);
         //! Initializes the output file for writing
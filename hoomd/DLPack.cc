@@ -0,0 +1,91 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+/*! \file DLPack.cc
+    \brief Defines the helpers of the DLPack tensor exchange format
+*/
+
+#include "DLPack.h"
+
+#include <stdexcept>
+
+namespace py = pybind11;
+
+namespace hoomd
+{
+namespace dlpack
+{
+
+namespace
+{
+
+//! Owns the tensor and its shape and strides until the consumer releases it
+struct ManagerContext
+    {
+    DLManagedTensor tensor;         //!< The tensor handed out
+    std::vector<int64_t> shape;     //!< Storage of the shape
+    std::vector<int64_t> strides;   //!< Storage of the strides
+    };
+
+//! Deleter called by the consumer
+void delete_context(DLManagedTensor *self)
+    {
+    delete static_cast<ManagerContext *>(self->manager_ctx);
+    }
+
+//! Destructor of the capsule
+/*! A consumer renames the capsule to "used_dltensor" and takes over the tensor, only unconsumed tensors are
+    released here.
+*/
+void destroy_capsule(PyObject *capsule)
+    {
+    if (PyCapsule_IsValid(capsule, "dltensor"))
+        {
+        DLManagedTensor *tensor = static_cast<DLManagedTensor *>(PyCapsule_GetPointer(capsule, "dltensor"));
+        tensor->deleter(tensor);
+        }
+    }
+
+} // end anonymous namespace
+
+/*! \param array Array to export
+    \returns A capsule named "dltensor" that holds a DLManagedTensor
+
+    The capsule only references the data of \a array, which must stay valid while the consumer uses the tensor.
+    Each capsule may be consumed once, so a new one is made for every consumer.
+*/
+py::object make_capsule(const DLPackArray& array)
+    {
+    if (array.shape.size() != array.strides.size())
+        throw std::runtime_error("DLPack: shape and strides of an array must have the same length");
+
+    ManagerContext *ctx = new ManagerContext;
+    ctx->shape = array.shape;
+    ctx->strides = array.strides;
+
+    DLTensor& t = ctx->tensor.dl_tensor;
+    t.data = array.data;
+    t.device = array.device;
+    t.ndim = (int32_t)ctx->shape.size();
+    t.dtype = array.dtype;
+    t.shape = ctx->shape.empty() ? NULL : &ctx->shape.front();
+    t.strides = ctx->strides.empty() ? NULL : &ctx->strides.front();
+    t.byte_offset = array.byte_offset;
+
+    ctx->tensor.manager_ctx = ctx;
+    ctx->tensor.deleter = delete_context;
+
+    PyObject *capsule = PyCapsule_New(&ctx->tensor, "dltensor", destroy_capsule);
+    if (!capsule)
+        {
+        delete ctx;
+        throw py::error_already_set();
+        }
+
+    return py::reinterpret_steal<py::object>(capsule);
+    }
+
+} // end namespace dlpack
+} // end namespace hoomd
@@ -0,0 +1,124 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+/*! \file DLPack.h
+    \brief Declares the data structures of the DLPack tensor exchange format
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <stdint.h>
+#include <vector>
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#ifndef __HOOMD_DLPACK_H__
+#define __HOOMD_DLPACK_H__
+
+namespace hoomd
+{
+namespace dlpack
+{
+
+/*! \addtogroup data_structs
+    @{
+*/
+
+/*! The structures below are the subset of dlpack.h (https://github.com/dmlc/dlpack) needed to export arrays. They
+    must keep the layout of the C header, since the consumers (numpy, PyTorch, JAX, CuPy) read them directly.
+*/
+
+//! Type of the device an array lives on
+enum DLDeviceType
+    {
+    kDLCPU = 1,         //!< Host memory
+    kDLCUDA = 2,        //!< CUDA device memory
+    };
+
+//! Device an array lives on
+struct DLDevice
+    {
+    DLDeviceType device_type;   //!< Type of the device
+    int32_t device_id;          //!< Index of the device, 0 for the host
+    };
+
+//! Type codes of the elements
+enum DLDataTypeCode
+    {
+    kDLInt = 0,         //!< Signed integer
+    kDLUInt = 1,        //!< Unsigned integer
+    kDLFloat = 2,       //!< IEEE floating point
+    };
+
+//! Type of the elements of an array
+struct DLDataType
+    {
+    uint8_t code;       //!< Type code (DLDataTypeCode)
+    uint8_t bits;       //!< Number of bits of one element
+    uint16_t lanes;     //!< Number of lanes of vector types, 1 for scalars
+    };
+
+//! Strided view of an array
+struct DLTensor
+    {
+    void *data;             //!< Pointer to the allocation
+    DLDevice device;        //!< Device the data lives on
+    int32_t ndim;           //!< Number of dimensions
+    DLDataType dtype;       //!< Type of the elements
+    int64_t *shape;         //!< Extent of each dimension
+    int64_t *strides;       //!< Stride of each dimension in elements
+    uint64_t byte_offset;   //!< Offset of the first element from data in bytes
+    };
+
+//! Tensor handed to a consumer, who calls deleter when it no longer needs it
+struct DLManagedTensor
+    {
+    DLTensor dl_tensor;                         //!< The tensor
+    void *manager_ctx;                          //!< Context of the producer
+    void (*deleter)(DLManagedTensor *self);     //!< Releases the tensor
+    };
+
+//! Description of an array to export as a DLPack tensor
+struct DLPackArray
+    {
+    //! Default constructor
+    DLPackArray()
+        : data(NULL), byte_offset(0)
+        {
+        device.device_type = kDLCPU;
+        device.device_id = 0;
+        dtype.code = kDLFloat;
+        dtype.bits = 32;
+        dtype.lanes = 1;
+        }
+
+    void *data;                     //!< Pointer to the allocation
+    DLDevice device;                //!< Device the data lives on
+    DLDataType dtype;               //!< Type of the elements
+    std::vector<int64_t> shape;     //!< Extent of each dimension
+    std::vector<int64_t> strides;   //!< Stride of each dimension in elements
+    uint64_t byte_offset;           //!< Offset of the first element from data in bytes
+    };
+
+//! Make the type of scalar elements
+inline DLDataType make_dtype(DLDataTypeCode code, unsigned int bits)
+    {
+    DLDataType dtype;
+    dtype.code = code;
+    dtype.bits = bits;
+    dtype.lanes = 1;
+    return dtype;
+    }
+
+//! Wrap an array in a "dltensor" capsule
+PYBIND11_EXPORT pybind11::object make_capsule(const DLPackArray& array);
+
+/*! @}*/
+
+} // end namespace dlpack
+} // end namespace hoomd
+
+#endif // __HOOMD_DLPACK_H__
@@ -663,6 +663,102 @@ void DomainDecomposition::initializeTwoLevel()
     }
 
 //! Export DomainDecomposition class to python
+/*!
+ * \param snap Snapshot of the initial configuration (may hold all particles on the root rank or be distributed)
+ * \param min_frac Minimum width of a domain as a fraction of its uniform width
+ *
+ * The particles in the snapshot are recursively bisected along each dimension: the slab of the grid is split into
+ * two halves with a number of domains n_left = n/2 and n - n_left, and the cut plane is placed where a fraction
+ * n_left/n of the particles lies below it. Each half is bisected again until every slab contains one domain. The cuts
+ * along one dimension are independent of the others, because the domains form a Cartesian grid.
+ *
+ * The fractional coordinates are binned on every rank and the histograms are summed over all ranks, so that the
+ * snapshot may be distributed. This method is collective.
+ */
+template<class Real>
+void DomainDecomposition::bisectParticles(std::shared_ptr< SnapshotSystemData<Real> > snap, Scalar min_frac)
+    {
+    const BoxDim& global_box = snap->global_box;
+    const SnapshotParticleData<Real>& pdata = snap->particle_data;
+
+    const unsigned int n_dom[3] = {m_nx, m_ny, m_nz};
+    for (unsigned int dir = 0; dir < 3; ++dir)
+        {
+        const unsigned int n = n_dom[dir];
+        if (n == 1)
+            continue;
+
+        // bin the fractional coordinates finely enough to resolve the cuts
+        const unsigned int n_bins = 1024*n;
+        std::vector<unsigned int> hist(n_bins, 0);
+        for (unsigned int i = 0; i < pdata.size; ++i)
+            {
+            const vec3<Real>& p = pdata.pos[i];
+            Scalar3 f = global_box.makeFraction(make_scalar3(p.x, p.y, p.z));
+            Scalar fd = (dir == 0) ? f.x : ((dir == 1) ? f.y : f.z);
+            int bin = int(fd*Scalar(n_bins));
+            if (bin < 0) bin = 0;
+            if (bin >= (int)n_bins) bin = n_bins-1;
+            hist[bin]++;
+            }
+        MPI_Allreduce(MPI_IN_PLACE, &hist[0], n_bins, MPI_UNSIGNED, MPI_SUM, m_mpi_comm);
+
+        std::vector<double> cum_hist(n_bins+1, 0.0);
+        for (unsigned int bin = 0; bin < n_bins; ++bin)
+            cum_hist[bin+1] = cum_hist[bin] + double(hist[bin]);
+
+        std::vector<Scalar> cum_frac(n+1);
+        cum_frac[0] = Scalar(0.0);
+        cum_frac[n] = Scalar(1.0);
+
+        if (cum_hist[n_bins] > 0.0)
+            {
+            // bisect slabs of domains [lo, hi) until every slab holds a single domain
+            std::vector<uint2> stack(1, make_uint2(0, n));
+            while (!stack.empty())
+                {
+                uint2 slab = stack.back();
+                stack.pop_back();
+                if (slab.y - slab.x < 2)
+                    continue;
+
+                const unsigned int mid = slab.x + (slab.y - slab.x)/2;
+                const double target = cum_hist[n_bins] * double(mid) / double(n);
+
+                // find the cut, interpolating linearly within the bin
+                unsigned int bin = std::upper_bound(cum_hist.begin(), cum_hist.end(), target) - cum_hist.begin() - 1;
+                if (bin >= n_bins) bin = n_bins-1;
+                double w = (hist[bin] > 0) ? (target - cum_hist[bin]) / double(hist[bin]) : 0.0;
+                cum_frac[mid] = Scalar((double(bin) + w) / double(n_bins));
+
+                stack.push_back(make_uint2(slab.x, mid));
+                stack.push_back(make_uint2(mid, slab.y));
+                }
+
+            // enforce the minimum domain width, first from below, then from above
+            const Scalar min_width = min_frac / Scalar(n);
+            for (unsigned int i = 1; i < n; ++i)
+                cum_frac[i] = std::max(cum_frac[i], cum_frac[i-1] + min_width);
+            for (unsigned int i = n-1; i > 0; --i)
+                cum_frac[i] = std::min(cum_frac[i], cum_frac[i+1] - min_width);
+            }
+        else
+            {
+            // no particles, keep uniform cuts
+            for (unsigned int i = 1; i < n; ++i)
+                cum_frac[i] = Scalar(i)/Scalar(n);
+            }
+
+        setCumulativeFractions(dir, cum_frac, 0);
+        }
+    }
+
+//! Explicit instantiation of bisectParticles()
+template void DomainDecomposition::bisectParticles<float>(std::shared_ptr< SnapshotSystemData<float> > snap,
+    Scalar min_frac);
+template void DomainDecomposition::bisectParticles<double>(std::shared_ptr< SnapshotSystemData<double> > snap,
+    Scalar min_frac);
+
 void export_DomainDecomposition(py::module& m)
     {
     py::class_<DomainDecomposition, std::shared_ptr<DomainDecomposition> >(m,"DomainDecomposition")
@@ -678,6 +774,8 @@ void export_DomainDecomposition(py::module& m)
               const std::vector<Scalar>&,
               const std::vector<Scalar>&>())
     .def("getCumulativeFractions", &DomainDecomposition::getCumulativeFractions)
+    .def("bisectParticles", &DomainDecomposition::bisectParticles<float>)
+    .def("bisectParticles", &DomainDecomposition::bisectParticles<double>)
     ;
     }
 #endif // ENABLE_MPI
@@ -28,6 +28,8 @@
 /*! \ingroup communication
 */
 
+template<class Real> struct SnapshotSystemData;
+
 //! Class that initializes every processor using spatial domain-decomposition
 /*! This class is used to divide the global simulation box into sub-domains and to assign a box to every processor.
  *
@@ -44,7 +46,8 @@
  *  ranks does not match the number that is available, behavior is reverted to the normal default with
  *  uniform cuts along each dimension.
  *
- *  The initialization of the domain decomposition scheme is performed in the constructor.
+ *  The initialization of the domain decomposition scheme is performed in the constructor. The cut planes of the
+ *  grid can then be placed by recursive bisection of the initial particle distribution with bisectParticles().
  */
 class PYBIND11_EXPORT DomainDecomposition
     {
@@ -152,6 +155,10 @@ class PYBIND11_EXPORT DomainDecomposition
         //! Collectively set the cumulative fractions along a dimension from a given rank
         void setCumulativeFractions(unsigned int dir, const std::vector<Scalar>& cum_frac, unsigned int root);
 
+        //! Place the cut planes so that every slab of the grid holds an equal share of the particles
+        template<class Real>
+        void bisectParticles(std::shared_ptr< SnapshotSystemData<Real> > snap, Scalar min_frac);
+
         //! Get the dimensions of the local simulation box
         const BoxDim calculateLocalBox(const BoxDim& global_box);
 
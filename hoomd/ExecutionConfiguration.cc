@@ -20,6 +20,16 @@ namespace py = pybind11;
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string.h>
+
+#ifdef __linux__
+#include <sched.h>
+#include <pthread.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#endif
 
 using namespace std;
 
@@ -31,6 +41,116 @@ using namespace std;
     \brief Defines ExecutionConfiguration and related classes
 */
 
+#ifdef ENABLE_TBB
+//! Pins every TBB thread to one core when it enters the scheduler
+/*! The thread in arena slot i runs on the i-th core of the list. The same slot always runs on the same core, so
+    loops with a static partitioner work on the same part of a range on the same NUMA node every time.
+*/
+class ThreadAffinityObserver : public tbb::task_scheduler_observer
+    {
+    public:
+        //! Constructor
+        /*! \param cpus Cores to pin the threads to, in the order of the arena slots
+        */
+        ThreadAffinityObserver(const std::vector<int>& cpus)
+            : m_cpus(cpus)
+            {
+            observe(true);
+            }
+
+        //! Destructor
+        virtual ~ThreadAffinityObserver()
+            {
+            observe(false);
+            }
+
+        //! Pin a thread
+        virtual void on_scheduler_entry(bool is_worker)
+            {
+            #ifdef __linux__
+            int slot = tbb::this_task_arena::current_thread_index();
+            if (slot < 0 || m_cpus.empty())
+                return;
+
+            cpu_set_t cpu_set;
+            CPU_ZERO(&cpu_set);
+            CPU_SET(m_cpus[slot % m_cpus.size()], &cpu_set);
+            pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t), &cpu_set);
+            #endif
+            }
+
+    private:
+        std::vector<int> m_cpus;    //!< Cores in the order of the arena slots
+    };
+#endif
+
+#ifdef __linux__
+//! Parse a list of cores in the sysfs format (e.g. 0-3,8-11)
+static std::vector<int> parseCPUList(const std::string& list)
+    {
+    std::vector<int> cpus;
+    std::istringstream s(list);
+    std::string range;
+    while (std::getline(s, range, ','))
+        {
+        if (range.empty() || range[0] == '\n')
+            continue;
+
+        size_t dash = range.find('-');
+        int first = atoi(range.substr(0, dash).c_str());
+        int last = (dash == std::string::npos) ? first : atoi(range.substr(dash+1).c_str());
+        for (int cpu = first; cpu <= last; cpu++)
+            cpus.push_back(cpu);
+        }
+    return cpus;
+    }
+
+//! Get the cores of every NUMA node that this process may run on
+/*! \param allowed Affinity mask of the process
+    \returns The allowed cores, grouped by NUMA node. One node with all allowed cores if sysfs has no NUMA information.
+*/
+static std::vector< std::vector<int> > getNUMANodes(const cpu_set_t& allowed)
+    {
+    std::vector< std::vector<int> > nodes;
+
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string node_list;
+    if (online.good() && std::getline(online, node_list))
+        {
+        std::vector<int> node_ids = parseCPUList(node_list);
+        for (unsigned int i = 0; i < node_ids.size(); i++)
+            {
+            std::ostringstream fname;
+            fname << "/sys/devices/system/node/node" << node_ids[i] << "/cpulist";
+            std::ifstream f(fname.str().c_str());
+            std::string cpu_list;
+            if (!f.good() || !std::getline(f, cpu_list))
+                continue;
+
+            std::vector<int> cpus = parseCPUList(cpu_list);
+            std::vector<int> node;
+            for (unsigned int j = 0; j < cpus.size(); j++)
+                if (cpus[j] < CPU_SETSIZE && CPU_ISSET(cpus[j], &allowed))
+                    node.push_back(cpus[j]);
+
+            if (node.size())
+                nodes.push_back(node);
+            }
+        }
+
+    if (nodes.empty())
+        {
+        std::vector<int> node;
+        for (int cpu = 0; cpu < CPU_SETSIZE; cpu++)
+            if (CPU_ISSET(cpu, &allowed))
+                node.push_back(cpu);
+        nodes.push_back(node);
+        }
+
+    return nodes;
+    }
+#endif
+
 /*! \param mode Execution mode to set (cpu or gpu)
     \param gpu_id List of GPU IDs on which to run, or empty for automatic selection
     \param min_cpu If set to true, cudaDeviceBlockingSync is set to keep the CPU usage of HOOMD to a minimum
@@ -51,11 +171,14 @@ ExecutionConfiguration::ExecutionConfiguration(executionMode mode,
                                                , MPI_Comm hoomd_world
                                                #endif
                                                )
-    : m_cuda_error_checking(false), msg(_msg)
+    : m_cuda_error_checking(false), msg(_msg), m_parallel_first_touch(false), m_huge_pages(false)
     {
     if (!msg)
         msg = std::shared_ptr<Messenger>(new Messenger());
 
+    m_memory_usage = std::unique_ptr<MemoryUsage>(new MemoryUsage());
+    m_metrics = std::unique_ptr<Metrics>(new Metrics());
+
     ostringstream s;
     for (auto it = gpu_id.begin(); it != gpu_id.end(); ++it)
         {
@@ -68,6 +191,13 @@ ExecutionConfiguration::ExecutionConfiguration(executionMode mode,
     m_rank = 0;
 
 #ifdef ENABLE_CUDA
+    #ifdef ENABLE_CUDA_LAZY_LOADING
+    // Each component library embeds the kernels for all of its template instantiations. Ask the driver to load
+    // them into device memory only when they are first launched, so that unused kernels do not take up context
+    // memory. This must be set before the driver is initialized, and a value set by the user takes precedence.
+    setenv("CUDA_MODULE_LOADING", "LAZY", 0);
+    #endif
+
     // scan the available GPUs
     scanGPUs(ignore_display);
     int dev_count = getNumCapableGPUs();
@@ -172,6 +302,12 @@ ExecutionConfiguration::ExecutionConfiguration(executionMode mode,
         // initialize cached allocator, max allocation 0.5*global mem
         m_cached_alloc.reset(new CachedAllocator(false, (unsigned int)(0.5f*(float)dev_prop.totalGlobalMem)));
         m_cached_alloc_managed.reset(new CachedAllocator(true, (unsigned int)(0.5f*(float)dev_prop.totalGlobalMem)));
+
+        // serve small arrays from slabs, device memory of GPUArray lives on a single GPU
+        m_slab_alloc_host.reset(new SlabAllocator(SlabAllocator::host_pinned));
+        if (m_gpu_id.size() == 1)
+            m_slab_alloc_device.reset(new SlabAllocator(SlabAllocator::device));
+        m_slab_alloc_managed.reset(new SlabAllocator(SlabAllocator::managed));
         }
     #endif
 
@@ -262,6 +398,9 @@ ExecutionConfiguration::~ExecutionConfiguration()
     // the destructors of these objects can issue cuda calls, so free them before the device reset
     m_cached_alloc.reset();
     m_cached_alloc_managed.reset();
+    m_slab_alloc_host.reset();
+    m_slab_alloc_device.reset();
+    m_slab_alloc_managed.reset();
     #endif
 
     #if defined(ENABLE_CUDA)
@@ -903,6 +1042,141 @@ void ExecutionConfiguration::endMultiGPU() const
     #endif
     }
 
+#ifdef ENABLE_TBB
+/*! \param mode One of "none", "compact" or "scatter"
+
+    With "compact", the threads fill the cores of one NUMA node before they use the next node. With "scatter", they
+    alternate between the NUMA nodes, which spreads the memory bandwidth over all nodes when there are fewer threads
+    than cores. Only the cores in the affinity mask of the process are used. When several ranks on the same node may
+    run on all of its cores, every rank takes its own contiguous share of them.
+
+    \note All ranks must call this method, it is collective in MPI runs.
+*/
+void ExecutionConfiguration::setThreadAffinity(const std::string& mode)
+    {
+    if (mode == "none")
+        {
+        m_affinity_observer.reset();
+        return;
+        }
+
+    if (mode != "compact" && mode != "scatter")
+        {
+        msg->error() << "Unknown thread affinity " << mode << ", expected none, compact or scatter" << endl;
+        throw runtime_error("Error setting thread affinity");
+        }
+
+    #ifdef __linux__
+    cpu_set_t allowed;
+    CPU_ZERO(&allowed);
+    sched_getaffinity(0, sizeof(cpu_set_t), &allowed);
+    std::vector< std::vector<int> > nodes = getNUMANodes(allowed);
+
+    #ifdef ENABLE_MPI
+    // ranks that the MPI launcher did not bind would all pin their threads to the same cores otherwise
+    MPI_Comm node_comm;
+    MPI_Comm_split_type(m_hoomd_world, MPI_COMM_TYPE_SHARED, getRankGlobal(), MPI_INFO_NULL, &node_comm);
+    int local_rank, local_size;
+    MPI_Comm_rank(node_comm, &local_rank);
+    MPI_Comm_size(node_comm, &local_size);
+    MPI_Comm_free(&node_comm);
+
+    if (local_size > 1 && CPU_COUNT(&allowed) == sysconf(_SC_NPROCESSORS_ONLN))
+        {
+        std::vector<int> cpus;
+        for (unsigned int i = 0; i < nodes.size(); i++)
+            cpus.insert(cpus.end(), nodes[i].begin(), nodes[i].end());
+
+        unsigned int first = local_rank*cpus.size()/local_size;
+        unsigned int last = (local_rank+1)*cpus.size()/local_size;
+        if (last == first)
+            last = first + 1;
+
+        CPU_ZERO(&allowed);
+        for (unsigned int i = first; i < last && i < cpus.size(); i++)
+            CPU_SET(cpus[i], &allowed);
+        nodes = getNUMANodes(allowed);
+        }
+    #endif
+
+    std::vector<int> cpus;
+    if (mode == "compact")
+        {
+        for (unsigned int i = 0; i < nodes.size(); i++)
+            cpus.insert(cpus.end(), nodes[i].begin(), nodes[i].end());
+        }
+    else
+        {
+        unsigned int max_node_size = 0;
+        for (unsigned int i = 0; i < nodes.size(); i++)
+            max_node_size = std::max(max_node_size, (unsigned int)nodes[i].size());
+
+        for (unsigned int j = 0; j < max_node_size; j++)
+            for (unsigned int i = 0; i < nodes.size(); i++)
+                if (j < nodes[i].size())
+                    cpus.push_back(nodes[i][j]);
+        }
+
+    msg->notice(2) << "Pinning TBB threads to " << cpus.size() << " cores on " << nodes.size() << " NUMA node(s) ("
+                   << mode << ")" << endl;
+    m_affinity_observer.reset(new ThreadAffinityObserver(cpus));
+    #else
+    msg->warning() << "Thread affinity is not supported on this platform, ignoring" << endl;
+    #endif
+    }
+#endif
+
+/*! \param ptr Pointer to the allocation (output)
+    \param num_bytes Number of bytes to allocate
+    \returns The return value of posix_memalign
+
+    When huge pages are enabled, arrays of at least 2 MB are aligned to 2 MB and the kernel is advised to back them
+    with transparent huge pages, which reduces the TLB misses of loops over large per-particle arrays. The memory is
+    released with free() in all cases.
+*/
+int ExecutionConfiguration::allocateHostArray(void **ptr, size_t num_bytes) const
+    {
+    #if defined(__linux__) && defined(MADV_HUGEPAGE)
+    const size_t huge_page_bytes = 2*1024*1024;
+    if (m_huge_pages && num_bytes >= huge_page_bytes)
+        {
+        int retval = posix_memalign(ptr, huge_page_bytes, num_bytes);
+        if (retval == 0 && madvise(*ptr, num_bytes - num_bytes % huge_page_bytes, MADV_HUGEPAGE) != 0)
+            msg->notice(10) << "madvise(MADV_HUGEPAGE) failed, using normal pages" << endl;
+        return retval;
+        }
+    #endif
+
+    // at minimum, alignment needs to be 32 bytes for AVX
+    return posix_memalign(ptr, 32, num_bytes);
+    }
+
+/*! \param ptr Host memory of the array
+    \param num_bytes Number of bytes to clear
+
+    The pages of an array are placed on the NUMA node of the thread that touches them first. With parallel first
+    touch, large arrays are cleared by the TBB threads with a static partitioner, so that every thread touches the
+    part of the array that it works on in loops over the particles.
+*/
+void ExecutionConfiguration::clearHostArray(void *ptr, size_t num_bytes) const
+    {
+    #ifdef ENABLE_TBB
+    const size_t page_bytes = 4096;
+    if (m_parallel_first_touch && num_bytes >= 64*page_bytes)
+        {
+        char *data = (char *)ptr;
+        tbb::parallel_for(tbb::blocked_range<size_t>(0, num_bytes, page_bytes),
+            [data] (const tbb::blocked_range<size_t>& r)
+            {
+            memset(data + r.begin(), 0, r.size());
+            }, tbb::static_partitioner());
+        return;
+        }
+    #endif
+
+    memset(ptr, 0, num_bytes);
+    }
+
 void export_ExecutionConfiguration(py::module& m)
     {
     py::class_<ExecutionConfiguration, std::shared_ptr<ExecutionConfiguration> > executionconfiguration(m,"ExecutionConfiguration");
@@ -941,7 +1215,10 @@ void export_ExecutionConfiguration(py::module& m)
 #endif
 #ifdef ENABLE_TBB
         .def("setNumThreads", &ExecutionConfiguration::setNumThreads)
+        .def("setThreadAffinity", &ExecutionConfiguration::setThreadAffinity)
 #endif
+        .def("setParallelFirstTouch", &ExecutionConfiguration::setParallelFirstTouch)
+        .def("setHugePages", &ExecutionConfiguration::setHugePages)
         .def("getNumThreads", &ExecutionConfiguration::getNumThreads)
         .def("setMemoryTracing", &ExecutionConfiguration::setMemoryTracing)
         .def("getMemoryTracer", &ExecutionConfiguration::getMemoryTracer);
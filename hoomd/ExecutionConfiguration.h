@@ -29,11 +29,19 @@
 
 #include "Messenger.h"
 #include "MemoryTraceback.h"
+#include "MemoryUsage.h"
+#include "Metrics.h"
+#include "SlabAllocator.h"
 
 /*! \file ExecutionConfiguration.h
     \brief Declares ExecutionConfiguration and related classes
 */
 
+#ifdef ENABLE_TBB
+//! Forward declaration of the observer that pins TBB threads
+class ThreadAffinityObserver;
+#endif
+
 #ifdef NVCC
 #error This header cannot be compiled by nvcc
 #endif
@@ -303,6 +311,32 @@ struct PYBIND11_EXPORT ExecutionConfiguration
         #endif
         }
 
+    #ifdef ENABLE_TBB
+    //! Pin the TBB threads to the cores of this process
+    void setThreadAffinity(const std::string& mode);
+    #endif
+
+    //! Set whether the pages of new host arrays are first touched by the TBB threads
+    /*! \param enable True to clear new host arrays in parallel, so that their pages are placed on the NUMA nodes of
+            the threads that work on the same part of the arrays
+    */
+    void setParallelFirstTouch(bool enable)
+        {
+        m_parallel_first_touch = enable;
+        }
+
+    //! Set whether large host arrays are backed by transparent huge pages
+    void setHugePages(bool enable)
+        {
+        m_huge_pages = enable;
+        }
+
+    //! Allocate aligned host memory for an array
+    int allocateHostArray(void **ptr, size_t num_bytes) const;
+
+    //! Set the host memory of an array to zero
+    void clearHostArray(void *ptr, size_t num_bytes) const;
+
 
     #ifdef ENABLE_CUDA
     //! Returns the cached allocator for temporary allocations
@@ -316,6 +350,20 @@ struct PYBIND11_EXPORT ExecutionConfiguration
         {
         return *m_cached_alloc_managed;
         }
+
+    //! Returns the sub-allocator for small arrays
+    /*! \param type Kind of memory
+        \returns The allocator, or nullptr if small arrays of this kind are allocated individually
+     */
+    SlabAllocator *getSlabAllocator(SlabAllocator::memory_type type) const
+        {
+        if (type == SlabAllocator::host_pinned)
+            return m_slab_alloc_host.get();
+        else if (type == SlabAllocator::device)
+            return m_slab_alloc_device.get();
+        else
+            return m_slab_alloc_managed.get();
+        }
     #endif
 
     //! Set up memory tracing
@@ -333,6 +381,18 @@ struct PYBIND11_EXPORT ExecutionConfiguration
         return m_memory_traceback.get();
         }
 
+    //! Returns the accounting of the memory usage per subsystem
+    MemoryUsage *getMemoryUsage() const
+        {
+        return m_memory_usage.get();
+        }
+
+    //! Returns the registry of live performance metrics
+    Metrics *getMetrics() const
+        {
+        return m_metrics.get();
+        }
+
     //! Returns true if we are in a multi-GPU block
     bool inMultiGPUBlock() const
         {
@@ -384,17 +444,26 @@ private:
     #ifdef ENABLE_CUDA
     std::unique_ptr<CachedAllocator> m_cached_alloc;       //!< Cached allocator for temporary allocations
     std::unique_ptr<CachedAllocator> m_cached_alloc_managed; //!< Cached allocator for temporary allocations in managed memory
+    std::unique_ptr<SlabAllocator> m_slab_alloc_host;        //!< Sub-allocator for small pinned host arrays
+    std::unique_ptr<SlabAllocator> m_slab_alloc_device;      //!< Sub-allocator for small device arrays
+    std::unique_ptr<SlabAllocator> m_slab_alloc_managed;     //!< Sub-allocator for small managed arrays
     #endif
 
     #ifdef ENABLE_TBB
     std::unique_ptr<tbb::task_scheduler_init> m_task_scheduler; //!< The TBB task scheduler
     unsigned int m_num_threads;            //!<  The number of TBB threads used
+    std::unique_ptr<ThreadAffinityObserver> m_affinity_observer; //!< Pins the TBB threads to cores
     #endif
 
+    bool m_parallel_first_touch;           //!< True if new host arrays are cleared by the TBB threads
+    bool m_huge_pages;                     //!< True if large host arrays use transparent huge pages
+
     //! Setup and print out stats on the chosen CPUs/GPUs
     void setupStats();
 
     std::unique_ptr<MemoryTraceback> m_memory_traceback;    //!< Keeps track of allocations
+    std::unique_ptr<MemoryUsage> m_memory_usage;            //!< Current and peak memory usage per subsystem
+    std::unique_ptr<Metrics> m_metrics;                     //!< Live performance metrics
     };
 
 // Macro for easy checking of CUDA errors - enabled all the time
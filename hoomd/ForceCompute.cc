@@ -29,8 +29,14 @@ namespace py = pybind11;
     \post All forces are initialized to 0
 */
 ForceCompute::ForceCompute(std::shared_ptr<SystemDefinition> sysdef)
-     : Compute(sysdef), m_particles_sorted(false)
+     : Compute(sysdef), m_particles_sorted(false), m_accumulate_net_force(false), m_energies_valid(true),
+       m_energies_requested(false)
+    #ifdef ENABLE_CUDA
+     , m_stream(0), m_stream_event(0), m_stream_event_pending(false)
+    #endif
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "ForceCompute");
+
     assert(m_pdata);
     assert(m_pdata->getMaxN() > 0);
 
@@ -162,12 +168,68 @@ ForceCompute::~ForceCompute()
     {
     m_pdata->getParticleSortSignal().disconnect<ForceCompute, &ForceCompute::setParticlesSorted>(this);
     m_pdata->getMaxParticleNumberChangeSignal().disconnect<ForceCompute, &ForceCompute::reallocate>(this);
+
+    #ifdef ENABLE_CUDA
+    setUseStream(false);
+    #endif
+    }
+
+#ifdef ENABLE_CUDA
+/*! \param use_stream True to launch the kernels of this compute in a stream of their own
+
+    The kernels of computes with their own stream can overlap with those of other computes, e.g. a bond compute with
+    a pair compute on a polymer system. The stream is a blocking stream, so it is ordered with the work in the default
+    stream: the neighbor and cell list builds, which run in the default stream, complete before the force kernels
+    start. The Integrator waits for the stream with waitStream() before it sums the net force.
+
+    Streams are only used on a single GPU, other configurations keep the default stream.
+*/
+void ForceCompute::setUseStream(bool use_stream)
+    {
+    if (use_stream && !m_stream)
+        {
+        if (!m_exec_conf->isCUDAEnabled() || m_exec_conf->getNumActiveGPUs() > 1)
+            {
+            m_exec_conf->msg->notice(2) << "Force computes own a stream only on a single GPU, "
+                                        << "using the default stream" << std::endl;
+            return;
+            }
+
+        cudaStreamCreate(&m_stream);
+        cudaEventCreateWithFlags(&m_stream_event, cudaEventDisableTiming);
+        CHECK_CUDA_ERROR();
+        }
+    else if (!use_stream && m_stream)
+        {
+        // finish the outstanding work before the stream is released
+        cudaStreamSynchronize(m_stream);
+        cudaEventDestroy(m_stream_event);
+        cudaStreamDestroy(m_stream);
+        m_stream = 0;
+        m_stream_event = 0;
+        m_stream_event_pending = false;
+        }
     }
 
+/*! Work issued to the default stream after this call starts after the last forces computed in the stream of this
+    compute. This is a no-op for computes that use the default stream.
+*/
+void ForceCompute::waitStream()
+    {
+    if (!m_stream_event_pending)
+        return;
+
+    cudaStreamWaitEvent(0, m_stream_event, 0);
+    m_stream_event_pending = false;
+    }
+#endif
+
 /*! Sums the total potential energy calculated by the last call to compute() and returns it.
 */
 Scalar ForceCompute::calcEnergySum()
     {
+    validateEnergies();
+
     ArrayHandle<Scalar4> h_force(m_force,access_location::host,access_mode::read);
     // always perform the sum in double precision for better accuracy
     // this is cheating and is really just a temporary hack to get logging up and running
@@ -192,6 +254,8 @@ Scalar ForceCompute::calcEnergySum()
 */
 Scalar ForceCompute::calcEnergyGroup(std::shared_ptr<ParticleGroup> group)
     {
+    validateEnergies();
+
     unsigned int group_size = group->getNumMembers();
     ArrayHandle<Scalar4> h_force(m_force,access_location::host,access_mode::read);
 
@@ -249,12 +313,42 @@ vec3<double> ForceCompute::calcForceGroup(std::shared_ptr<ParticleGroup> group)
 
 void ForceCompute::compute(unsigned int timestep)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "ForceCompute");
+
     // skip if we shouldn't compute this step
     if (!m_particles_sorted && !shouldCompute(timestep))
         return;
 
+    int64_t start_time = (m_metric_time >= 0) ? m_metric_clk.getTime() : 0;
+
     computeForces(timestep);
     m_particles_sorted = false;
+
+    if (m_metric_time >= 0)
+        m_exec_conf->getMetrics()->add(m_metric_time, double(m_metric_clk.getTime() - start_time)*1e-9);
+
+    #ifdef ENABLE_CUDA
+    if (getStream())
+        {
+        cudaEventRecord(m_stream_event, m_stream);
+        m_stream_event_pending = true;
+        }
+    #endif
+    }
+
+/*! \param timestep Current time step
+
+    The Integrator zeroes the net force before it calls this method for the computes that accumulate into the net
+    force, so the computation is repeated if the forces have already been computed at this \a timestep.
+*/
+void ForceCompute::accumulateNetForce(unsigned int timestep)
+    {
+    assert(m_accumulate_net_force);
+
+    if (peekCompute(timestep))
+        compute(timestep);
+    else
+        forceCompute(timestep);
     }
 
 /*! \param num_iters Number of iterations to average for the benchmark
@@ -367,6 +461,8 @@ Scalar ForceCompute::getVirial(unsigned int tag, unsigned int component)
  */
 Scalar ForceCompute::getEnergy(unsigned int tag)
     {
+    validateEnergies();
+
     unsigned int i = m_pdata->getRTag(tag);
     bool found = (i < m_pdata->getN());
     Scalar result = Scalar(0.0);
@@ -395,5 +491,10 @@ void export_ForceCompute(py::module& m)
     .def("getEnergy", &ForceCompute::getEnergy)
     .def("calcEnergyGroup", &ForceCompute::calcEnergyGroup)
     .def("calcForceGroup", &ForceCompute::calcForceGroup)
+    .def("setAccumulateNetForce", &ForceCompute::setAccumulateNetForce)
+    .def("accumulatesNetForce", &ForceCompute::accumulatesNetForce)
+    #ifdef ENABLE_CUDA
+    .def("setUseStream", &ForceCompute::setUseStream)
+    #endif
     ;
     }
@@ -74,6 +74,9 @@ class PYBIND11_EXPORT ForceCompute : public Compute
         //! Computes the forces
         virtual void compute(unsigned int timestep);
 
+        //! Computes the forces and adds them to the net force
+        void accumulateNetForce(unsigned int timestep);
+
         //! Benchmark the force compute
         virtual double benchmark(unsigned int num_iters);
 
@@ -139,6 +142,16 @@ class PYBIND11_EXPORT ForceCompute : public Compute
             flags[comm_flag::net_force] = 1; // only used if constraints are present
             return flags;
             }
+
+        //! Returns true if the forces are correct with the half-shell ghost exchange
+        /*! With Communicator::setHalfShell(), the neighbor list only keeps the ghosts in the forward half-shell, and
+            the forces on the ghosts are sent back to their owners. Sub-classes that evaluate the pairs of the neighbor
+            list without adding the force to the ghost return false.
+        */
+        virtual bool supportsHalfShell()
+            {
+            return true;
+            }
         #endif
 
         //! Returns true if this ForceCompute requires anisotropic integration
@@ -148,6 +161,66 @@ class PYBIND11_EXPORT ForceCompute : public Compute
             return false;
             }
 
+        //! Returns true if this ForceCompute can add its forces directly to the net force
+        /*! Sub-classes that return true write to getForceTarget() and getVirialTarget(), and add to these arrays
+            instead of overwriting them when accumulatesNetForce() is true. They must not write torques.
+        */
+        virtual bool supportsNetForceAccumulation()
+            {
+            return false;
+            }
+
+        //! Set whether the forces are added directly to the net force of the particle data
+        void setAccumulateNetForce(bool accumulate)
+            {
+            m_accumulate_net_force = accumulate && supportsNetForceAccumulation();
+            }
+
+        //! Returns true if the forces are added directly to the net force of the particle data
+        /*! When true, the Integrator zeroes the net force before it calls compute(), and the per-compute force,
+            energy and virial arrays are not updated.
+        */
+        bool accumulatesNetForce() const
+            {
+            return m_accumulate_net_force;
+            }
+
+        //! Returns false if the energies were skipped in the last computation
+        bool energiesValid() const
+            {
+            return m_energies_valid;
+            }
+
+        //! Make sure the energies of the last computed step are available
+        /*! When the energies were skipped, the last step is recomputed with energies. This is called before the
+            per-compute energies are read, and by the Integrator before the energies in the net force are read.
+        */
+        virtual void validateEnergies()
+            {
+            if (m_energies_valid)
+                return;
+
+            m_energies_requested = true;
+            forceCompute(m_last_computed);
+            m_energies_requested = false;
+            }
+
+        #ifdef ENABLE_CUDA
+        //! Set whether the kernels of this compute are launched in a stream of their own
+        void setUseStream(bool use_stream);
+
+        //! Get the stream the kernels of this compute are launched in
+        /*! Computes that add to the net force share the default stream, since they update the same arrays.
+        */
+        cudaStream_t getStream() const
+            {
+            return m_accumulate_net_force ? 0 : m_stream;
+            }
+
+        //! Make the default stream wait for the forces computed in the stream of this compute
+        void waitStream();
+        #endif
+
     protected:
         bool m_particles_sorted;    //!< Flag set to true when particles are resorted in memory
 
@@ -185,6 +258,45 @@ class PYBIND11_EXPORT ForceCompute : public Compute
 
         Scalar m_external_virial[6]; //!< Stores external contribution to virial
         Scalar m_external_energy;    //!< Stores external contribution to potential energy
+        bool m_accumulate_net_force; //!< True if the forces are added directly to the net force
+        bool m_energies_valid;       //!< False if the energies were skipped in the last computation
+        bool m_energies_requested;   //!< True to compute the energies regardless of the flags
+
+        #ifdef ENABLE_CUDA
+        cudaStream_t m_stream;          //!< Stream of the kernels, 0 for the default stream
+        cudaEvent_t m_stream_event;     //!< Recorded in m_stream after the forces are computed
+        bool m_stream_event_pending;    //!< True if m_stream_event was recorded and not yet waited on
+        #endif
+
+        //! Returns true if the potential energy must be computed on this step
+        /*! Sub-classes that can skip the potential energy (see PotentialPair and PotentialBond) call this at the
+            start of their computation and store the result in m_energies_valid. The energies are skipped when nothing
+            reads them on this step. Energies that are added to the net force cannot be recomputed separately, so
+            they are always computed. The same holds with the half-shell ghost exchange, where the energies of the
+            ghosts are sent back to their owners with the net force.
+        */
+        bool needsEnergies()
+            {
+            #ifdef ENABLE_MPI
+            if (m_comm && m_comm->getHalfShell())
+                return true;
+            #endif
+
+            return m_pdata->getFlags()[pdata_flag::potential_energy] || m_energies_requested
+                || m_accumulate_net_force;
+            }
+
+        //! Get the array the computed forces are written to
+        const GlobalArray<Scalar4>& getForceTarget()
+            {
+            return m_accumulate_net_force ? m_pdata->getNetForce() : m_force;
+            }
+
+        //! Get the array the computed virials are written to
+        const GlobalArray<Scalar>& getVirialTarget()
+            {
+            return m_accumulate_net_force ? m_pdata->getNetVirial() : m_virial;
+            }
 
         //! Actually perform the computation of the forces
         /*! This is pure virtual here. Sub-classes must implement this function. It will be called by
@@ -18,7 +18,7 @@ using namespace std;
 /*! \param sysdef SystemDefinition containing the ParticleData to compute forces on
 */
 ForceConstraint::ForceConstraint(std::shared_ptr<SystemDefinition> sysdef)
-        : ForceCompute(sysdef)
+        : ForceCompute(sysdef), m_fused(false)
     {
     }
 
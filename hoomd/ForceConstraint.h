@@ -39,7 +39,23 @@ class PYBIND11_EXPORT ForceConstraint : public ForceCompute
             return 0;
             }
 
+        //! Set whether the constraint force is applied by an integration method
+        /*! A fused constraint computes no forces of its own and is skipped in the net force sum, the integration
+            method evaluates it in its second step instead.
+        */
+        void setFused(bool fused)
+            {
+            m_fused = fused;
+            }
+
+        //! Get whether the constraint force is applied by an integration method
+        bool isFused() const
+            {
+            return m_fused;
+            }
+
     protected:
+        bool m_fused;   //!< True if the constraint force is applied by an integration method
 
         //! Compute the forces
         virtual void computeForces(unsigned int timestep);
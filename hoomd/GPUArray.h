@@ -30,6 +30,7 @@
 #include <algorithm>
 #include <stdlib.h>
 #include <memory>
+#include <functional>
 
 //! Specifies where to acquire the data
 struct access_location
@@ -77,13 +78,19 @@ namespace hoomd
 namespace detail
 {
 
+//! Owner ID of allocations that are not accounted in the memory usage
+const unsigned int NOT_ACCOUNTED = 0xffffffff;
+
 template<class T>
 class cuda_deleter
     {
     public:
         //! Default constructor
         cuda_deleter()
-            : m_use_device(false), m_N(0), m_mapped(false)
+            : m_use_device(false), m_N(0), m_mapped(false), m_owner(NOT_ACCOUNTED)
+            #ifdef ENABLE_CUDA
+            , m_slab(nullptr)
+            #endif
             {}
 
         //! Ctor
@@ -92,9 +99,33 @@ class cuda_deleter
          */
         cuda_deleter(std::shared_ptr<const ExecutionConfiguration> exec_conf, bool use_device, const unsigned int N,
             bool mapped)
-            : m_exec_conf(exec_conf), m_use_device(use_device), m_N(N), m_mapped(mapped)
+            : m_exec_conf(exec_conf), m_use_device(use_device), m_N(N), m_mapped(mapped), m_owner(NOT_ACCOUNTED)
+            #ifdef ENABLE_CUDA
+            , m_slab(nullptr)
+            #endif
             { }
 
+        #ifdef ENABLE_CUDA
+        //! Ctor for a chunk of a slab
+        /*! \param exec_conf Execution configuration
+            \param N Number of elements
+            \param slab The allocator that owns the chunk
+         */
+        cuda_deleter(std::shared_ptr<const ExecutionConfiguration> exec_conf, const unsigned int N, SlabAllocator *slab)
+            : m_exec_conf(exec_conf), m_use_device(true), m_N(N), m_mapped(false), m_owner(NOT_ACCOUNTED),
+              m_slab(slab)
+            { }
+        #endif
+
+        //! Account for the allocation in the memory usage of its owner
+        /*! \param owner ID of the owner (see MemoryUsage)
+         */
+        void account(unsigned int owner)
+            {
+            m_owner = owner;
+            m_exec_conf->getMemoryUsage()->registerAllocation(m_owner, MemoryUsage::device, m_N*sizeof(T));
+            }
+
         //! Delete the host array
         /*! \param ptr Start of aligned memory allocation
          */
@@ -103,7 +134,18 @@ class cuda_deleter
             if (ptr == nullptr)
                 return;
 
+            if (m_owner != NOT_ACCOUNTED)
+                m_exec_conf->getMemoryUsage()->unregisterAllocation(m_owner, MemoryUsage::device, m_N*sizeof(T));
+
             #ifdef ENABLE_CUDA
+            if (m_slab)
+                {
+                // the chunk may still be in use by a kernel
+                cudaDeviceSynchronize();
+                m_slab->deallocate(ptr, m_N*sizeof(T));
+                return;
+                }
+
             if (m_use_device && ! m_mapped)
                 {
                 assert(m_exec_conf);
@@ -120,6 +162,10 @@ class cuda_deleter
         bool m_use_device;     //!< Whether to use cudaMallocManaged
         unsigned int m_N;      //!< Number of elements in array
         bool m_mapped;         //!< True if this is host-mapped memory
+        unsigned int m_owner;  //!< Owner in the memory usage accounting
+        #ifdef ENABLE_CUDA
+        SlabAllocator *m_slab; //!< The allocator owning the memory, or nullptr
+        #endif
     };
 
 template<class T>
@@ -128,7 +174,10 @@ class host_deleter
     public:
         //! Default constructor
         host_deleter()
-            : m_use_device(false), m_N(0)
+            : m_use_device(false), m_N(0), m_owner(NOT_ACCOUNTED)
+            #ifdef ENABLE_CUDA
+            , m_slab(nullptr)
+            #endif
             {}
 
         //! Ctor
@@ -136,8 +185,31 @@ class host_deleter
             \param use_device whether the array is managed or on the host
          */
         host_deleter(std::shared_ptr<const ExecutionConfiguration> exec_conf, bool use_device, const unsigned int N)
-            : m_exec_conf(exec_conf), m_use_device(use_device), m_N(N)
+            : m_exec_conf(exec_conf), m_use_device(use_device), m_N(N), m_owner(NOT_ACCOUNTED)
+            #ifdef ENABLE_CUDA
+            , m_slab(nullptr)
+            #endif
+            { }
+
+        #ifdef ENABLE_CUDA
+        //! Ctor for a chunk of a slab
+        /*! \param exec_conf Execution configuration
+            \param N Number of elements
+            \param slab The allocator that owns the chunk
+         */
+        host_deleter(std::shared_ptr<const ExecutionConfiguration> exec_conf, const unsigned int N, SlabAllocator *slab)
+            : m_exec_conf(exec_conf), m_use_device(true), m_N(N), m_owner(NOT_ACCOUNTED), m_slab(slab)
             { }
+        #endif
+
+        //! Account for the allocation in the memory usage of its owner
+        /*! \param owner ID of the owner (see MemoryUsage)
+         */
+        void account(unsigned int owner)
+            {
+            m_owner = owner;
+            m_exec_conf->getMemoryUsage()->registerAllocation(m_owner, MemoryUsage::host, m_N*sizeof(T));
+            }
 
         //! Delete the CUDA array
         /*! \param ptr Start of aligned memory allocation
@@ -147,6 +219,19 @@ class host_deleter
             if (ptr == nullptr)
                 return;
 
+            if (m_owner != NOT_ACCOUNTED)
+                m_exec_conf->getMemoryUsage()->unregisterAllocation(m_owner, MemoryUsage::host, m_N*sizeof(T));
+
+            #ifdef ENABLE_CUDA
+            if (m_slab)
+                {
+                // the chunk may still be the target of an asynchronous copy
+                cudaDeviceSynchronize();
+                m_slab->deallocate(ptr, m_N*sizeof(T));
+                return;
+                }
+            #endif
+
             if (m_exec_conf)
                 m_exec_conf->msg->notice(7) << "Freeing " << m_N*sizeof(T) << " bytes of host memory." << std::endl;
 
@@ -169,7 +254,43 @@ class host_deleter
         std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< The execution configuration
         bool m_use_device;     //!< Whether to use hostMallocManaged
         unsigned int m_N;      //!< Number of elements in array
+        unsigned int m_owner;  //!< Owner in the memory usage accounting
+        #ifdef ENABLE_CUDA
+        SlabAllocator *m_slab; //!< The allocator owning the memory, or nullptr
+        #endif
+    };
+
+#ifdef ENABLE_CUDA
+//! Deleter for CUDA events
+class event_deleter
+    {
+    public:
+        //! Default constructor
+        event_deleter()
+            {}
+
+        //! Constructor with execution configuration
+        /*! \param exec_conf The execution configuration (needed for CHECK_CUDA_ERROR)
+         */
+        event_deleter(std::shared_ptr<const ExecutionConfiguration> exec_conf)
+            : m_exec_conf(exec_conf)
+            { }
+
+        //! Destroy the event and free the memory location
+        /*! \param ptr Start of memory area
+         */
+        void operator()(cudaEvent_t *ptr)
+            {
+            cudaEventDestroy(*ptr);
+            CHECK_CUDA_ERROR();
+
+            delete ptr;
+            }
+    private:
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< The execution configuration
     };
+#endif
+
 } // end namespace detail
 
 } // end namespace hoomd
@@ -187,6 +308,9 @@ class ArrayHandle;
 template<class T>
 class ArrayHandleAsync;
 
+template<class T>
+class ArrayHandleRange;
+
 template <class T>
 class GlobalArray;
 
@@ -243,6 +367,20 @@ class GPUArrayBase
             static_cast<Derived&>(*this).resize(width,height);
             }
 
+        //! Get the location of the valid copy of the data
+        data_location::Enum getDataLocation() const
+            {
+            return static_cast<Derived const&>(*this).getDataLocation();
+            }
+
+        #ifdef ENABLE_CUDA
+        //! Start copying the data to a location ahead of its use
+        void prefetch(const access_location::Enum location, cudaStream_t stream = 0) const
+            {
+            static_cast<Derived const&>(*this).prefetch(location, stream);
+            }
+        #endif
+
     protected:
         //! Acquires the data pointer for use
         inline ArrayHandleDispatch<T> acquire(const access_location::Enum location, const access_mode::Enum mode
@@ -258,6 +396,19 @@ class GPUArrayBase
                 );
             }
 
+        //! Acquires the data pointer with a valid range of elements
+        inline ArrayHandleDispatch<T> acquireRange(const access_location::Enum location, const access_mode::Enum mode,
+            unsigned int first, unsigned int count, bool& partial) const
+            {
+            return static_cast<Derived const&>(*this).acquireRange(location, mode, first, count, partial);
+            }
+
+        //! Write back a range of elements that was acquired with a partial copy
+        inline void releaseRange(const access_location::Enum location, unsigned int first, unsigned int count) const
+            {
+            static_cast<Derived const&>(*this).releaseRange(location, first, count);
+            }
+
         //! Release the data pointer
         inline void release() const
             {
@@ -273,6 +424,7 @@ class GPUArrayBase
         // need to be friend of the ArrayHandle class
         friend class ArrayHandle<T>;
         friend class ArrayHandleAsync<T>;
+        friend class ArrayHandleRange<T>;
 
     private:
         // Make constructor private to prevent mistakes
@@ -394,6 +546,56 @@ class ArrayHandleAsync
     };
 #endif
 
+//! Handle to access a contiguous range of elements of a GPUArray
+/*! ArrayHandleRange guarantees that only the elements \a first to \a first + \a count - 1 are valid at the requested
+    location, e.g. the ghost particles after the local ones, or the first N elements of an array that is allocated
+    with spare capacity. When the valid copy of the data is in the other memory, only this range is copied. The
+    location of the valid copy of the remaining elements does not change, and a range that is acquired with
+    access_mode::readwrite or access_mode::overwrite is copied back when the handle is released.
+
+    \a data points to the beginning of the array, so that the range is accessed with the same indices as with an
+    ArrayHandle. Elements outside of the range must not be accessed.
+
+    Example usage:
+    \code
+    {
+    // only copy the ghost particles to the host
+    ArrayHandleRange<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read, N, n_ghost);
+    for (unsigned int i = N; i < N + n_ghost; ++i)
+        ... use h_pos.data[i] ...
+    }
+    \endcode
+
+    Arrays in mapped or managed memory, and arrays whose data is valid at the requested location, are acquired as a
+    whole, like with ArrayHandle.
+*/
+template<class T>
+class ArrayHandleRange
+    {
+    public:
+        //! Acquires the range and sets \a data
+        /*! \tparam Derived the type of GPUArray implementation
+         */
+        template<class Derived>
+        inline ArrayHandleRange(const GPUArrayBase<T, Derived>& gpu_array, const access_location::Enum location,
+                                const access_mode::Enum mode, unsigned int first, unsigned int count);
+
+        //! Copies back a modified range and notifies the containing GPUArray that the handle has been released
+        virtual inline ~ArrayHandleRange()
+            {
+            if (m_write_back)
+                m_write_back();
+            }
+
+    private:
+        bool m_partial;                     //!< True if only the range was copied
+        ArrayHandleDispatch<T> dispatch;    //!< Dispatch object that manages the acquire/release
+        std::function<void()> m_write_back; //!< Copies the range back on release, if needed
+
+    public:
+        T* const data;          //!< Pointer to the beginning of the array
+    };
+
 //*******
 //! Class for managing an array of elements on the GPU mirrored to the CPU
 /*!
@@ -454,7 +656,13 @@ class GPUArray : public GPUArrayBase<T, GPUArray<T> >
         //! Constructs a 2-D GPUArray
         GPUArray(unsigned int width, unsigned int height, std::shared_ptr<const ExecutionConfiguration> exec_conf);
         //! Frees memory
-        virtual ~GPUArray() {}
+        virtual ~GPUArray()
+            {
+#ifdef ENABLE_CUDA
+            // a prefetch may still access the memory
+            waitPrefetch(access_location::host);
+#endif
+            }
 
 #ifdef ENABLE_CUDA
         //! Constructs a 1-D GPUArray
@@ -523,6 +731,20 @@ class GPUArray : public GPUArrayBase<T, GPUArray<T> >
         //! Resize a 2D GPUArray
         void resize(unsigned int width, unsigned int height);
 
+        //! Get the location of the valid copy of the data
+        /*! \returns data_location::hostdevice if the data is valid in both memories, also while a prefetch() to
+                     the other memory is in progress
+        */
+        data_location::Enum getDataLocation() const
+            {
+            return m_data_location;
+            }
+
+#ifdef ENABLE_CUDA
+        //! Start copying the data to a location ahead of its use
+        inline void prefetch(const access_location::Enum location, cudaStream_t stream = 0) const;
+#endif
+
     protected:
         //! Clear memory starting from a given element
         /*! \param first The first element to clear
@@ -536,6 +758,13 @@ class GPUArray : public GPUArrayBase<T, GPUArray<T> >
         #endif
                         ) const;
 
+        //! Acquires the data pointer with a valid range of elements
+        inline ArrayHandleDispatch<T> acquireRange(const access_location::Enum location, const access_mode::Enum mode,
+            unsigned int first, unsigned int count, bool& partial) const;
+
+        //! Write back a range of elements that was acquired with a partial copy
+        inline void releaseRange(const access_location::Enum location, unsigned int first, unsigned int count) const;
+
         //! Release the data pointer
         inline void release() const
             {
@@ -566,6 +795,10 @@ class GPUArray : public GPUArrayBase<T, GPUArray<T> >
         mutable data_location::Enum m_data_location;    //!< Tracks the current location of the data
 #ifdef ENABLE_CUDA
         bool m_mapped;                          //!< True if we are using mapped memory
+
+        mutable bool m_prefetch_pending;        //!< True if a prefetch() may still be in progress
+        //! Event recorded after the copy of the last prefetch()
+        mutable std::unique_ptr<cudaEvent_t, hoomd::detail::event_deleter> m_prefetch_event;
 #endif
 
     // ok, this looks weird, but I want m_exec_conf to be protected and not have to go reorder all of the initializers
@@ -587,8 +820,22 @@ class GPUArray : public GPUArrayBase<T, GPUArray<T> >
         inline void memcpyDeviceToHost(bool async) const;
         //! Helper function to copy memory from the host to device
         inline void memcpyHostToDevice(bool async) const;
+
+        //! Helper function to wait for a pending prefetch before the data is accessed at a location
+        inline void waitPrefetch(const access_location::Enum location) const;
 #endif
 
+        //! Helper function to allocate host memory
+        inline T* allocateHostMemory(unsigned int num_elements, hoomd::detail::host_deleter<T>& deleter) const;
+
+        //! Helper function to set host memory to zero
+        inline void clearHostMemory(T *ptr, unsigned int num_elements) const;
+
+        #ifdef ENABLE_CUDA
+        //! Helper function to allocate device memory
+        inline T* allocateDeviceMemory(unsigned int num_elements, hoomd::detail::cuda_deleter<T>& deleter) const;
+        #endif
+
         //! Helper function to resize host array
         inline T* resizeHostArray(unsigned int num_elements);
 
@@ -628,6 +875,25 @@ ArrayHandleAsync<T>::ArrayHandleAsync(const GPUArrayBase<T, Derived>& array, con
     }
 #endif
 
+/*! \param array GPUArray host to the pointer data
+    \param location Desired location to access the data
+    \param mode Mode to access the data with
+    \param first First element of the range
+    \param count Number of elements in the range
+*/
+template<class T>
+template<class Derived>
+ArrayHandleRange<T>::ArrayHandleRange(const GPUArrayBase<T, Derived>& array, const access_location::Enum location,
+                                      const access_mode::Enum mode, unsigned int first, unsigned int count) :
+        m_partial(false), dispatch(array.acquireRange(location, mode, first, count, m_partial)), data(dispatch.get())
+    {
+    if (m_partial && mode != access_mode::read)
+        {
+        const GPUArrayBase<T, Derived> *a = &array;
+        m_write_back = [a, location, first, count]() { a->releaseRange(location, first, count); };
+        }
+    }
+
 //************************************************
 // ArrayHandleDispatch specialization for GPUArray
 // ***********************************************
@@ -657,7 +923,7 @@ class GPUArrayDispatch : public ArrayHandleDispatch<T>
 template<class T> GPUArray<T>::GPUArray() :
         m_num_elements(0), m_pitch(0), m_height(0), m_acquired(false), m_data_location(data_location::host)
 #ifdef ENABLE_CUDA
-        , m_mapped(false)
+        , m_mapped(false), m_prefetch_pending(false)
 #endif
     {
     }
@@ -665,7 +931,7 @@ template<class T> GPUArray<T>::GPUArray() :
 template<class T> GPUArray<T>::GPUArray(std::shared_ptr<const ExecutionConfiguration> exec_conf) :
         m_num_elements(0), m_pitch(0), m_height(0), m_acquired(false), m_data_location(data_location::host),
 #ifdef ENABLE_CUDA
-        m_mapped(false),
+        m_mapped(false), m_prefetch_pending(false),
 #endif
         m_exec_conf(exec_conf)
     {
@@ -678,7 +944,7 @@ template<class T> GPUArray<T>::GPUArray(std::shared_ptr<const ExecutionConfigura
 template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, std::shared_ptr<const ExecutionConfiguration> exec_conf) :
         m_num_elements(num_elements), m_pitch(num_elements), m_height(1), m_acquired(false), m_data_location(data_location::host),
 #ifdef ENABLE_CUDA
-        m_mapped(false),
+        m_mapped(false), m_prefetch_pending(false),
 #endif
         m_exec_conf(exec_conf)
     {
@@ -694,7 +960,7 @@ template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, std::shared_p
 template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height, std::shared_ptr<const ExecutionConfiguration> exec_conf) :
         m_height(height), m_acquired(false), m_data_location(data_location::host),
 #ifdef ENABLE_CUDA
-        m_mapped(false),
+        m_mapped(false), m_prefetch_pending(false),
 #endif
         m_exec_conf(exec_conf)
     {
@@ -716,7 +982,7 @@ template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height,
 */
 template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, std::shared_ptr<const ExecutionConfiguration> exec_conf, bool mapped) :
         m_num_elements(num_elements), m_pitch(num_elements), m_height(1), m_acquired(false), m_data_location(data_location::host),
-        m_mapped(mapped),
+        m_mapped(mapped), m_prefetch_pending(false),
         m_exec_conf(exec_conf)
     {
     // allocate and clear memory
@@ -731,7 +997,7 @@ template<class T> GPUArray<T>::GPUArray(unsigned int num_elements, std::shared_p
 */
 template<class T> GPUArray<T>::GPUArray(unsigned int width, unsigned int height, std::shared_ptr<const ExecutionConfiguration> exec_conf, bool mapped) :
         m_height(height), m_acquired(false), m_data_location(data_location::host),
-        m_mapped(mapped),
+        m_mapped(mapped), m_prefetch_pending(false),
         m_exec_conf(exec_conf)
     {
     // make m_pitch the next multiple of 16 larger or equal to the given width
@@ -750,7 +1016,7 @@ template<class T> GPUArray<T>::GPUArray(const GPUArray& from) noexcept
     : m_num_elements(from.m_num_elements), m_pitch(from.m_pitch),
       m_height(from.m_height), m_acquired(false), m_data_location(data_location::host),
 #ifdef ENABLE_CUDA
-        m_mapped(from.m_mapped),
+        m_mapped(from.m_mapped), m_prefetch_pending(false),
 #endif
         m_exec_conf(from.m_exec_conf)
     {
@@ -773,6 +1039,11 @@ template<class T> GPUArray<T>& GPUArray<T>::operator=(const GPUArray& rhs) noexc
         // sanity check
         assert(!m_acquired && !rhs.m_acquired);
 
+#ifdef ENABLE_CUDA
+        // a prefetch may still access the old memory
+        waitPrefetch(access_location::host);
+#endif
+
         // copy over basic elements
         m_num_elements = rhs.m_num_elements;
         m_pitch = rhs.m_pitch;
@@ -816,11 +1087,17 @@ template<class T> GPUArray<T>::GPUArray(GPUArray&& from) noexcept
     m_data_location(std::move(from.m_data_location)),
 #ifdef ENABLE_CUDA
     m_mapped(std::move(from.m_mapped)),
+    m_prefetch_pending(std::move(from.m_prefetch_pending)),
+    m_prefetch_event(std::move(from.m_prefetch_event)),
     d_data(std::move(from.d_data)),
 #endif
     h_data(std::move(from.h_data)),
     m_exec_conf(std::move(from.m_exec_conf))
-    { }
+    {
+#ifdef ENABLE_CUDA
+    from.m_prefetch_pending = false;
+#endif
+    }
 
 //! Move assignment operator
 template<class T> GPUArray<T>& GPUArray<T>::operator=(GPUArray&& rhs) noexcept
@@ -833,6 +1110,12 @@ template<class T> GPUArray<T>& GPUArray<T>::operator=(GPUArray&& rhs) noexcept
         m_exec_conf = std::move(rhs.m_exec_conf);
     #ifdef ENABLE_CUDA
         m_mapped = std::move(rhs.m_mapped);
+        // a prefetch may still access the old memory
+        waitPrefetch(access_location::host);
+
+        m_prefetch_pending = std::move(rhs.m_prefetch_pending);
+        m_prefetch_event = std::move(rhs.m_prefetch_event);
+        rhs.m_prefetch_pending = false;
         d_data = std::move(rhs.d_data);
     #endif
         h_data = std::move(rhs.h_data);
@@ -870,6 +1153,8 @@ template<class T> void GPUArray<T>::swap(GPUArray& from)
 #ifdef ENABLE_CUDA
     std::swap(d_data, from.d_data);
     std::swap(m_mapped, from.m_mapped);
+    std::swap(m_prefetch_pending, from.m_prefetch_pending);
+    std::swap(m_prefetch_event, from.m_prefetch_event);
 #endif
     std::swap(h_data, from.h_data);
     }
@@ -903,11 +1188,65 @@ template<class T> void GPUArray<T>::allocate()
     if (m_exec_conf)
         m_exec_conf->msg->notice(7) << "GPUArray: Allocating " << float(m_num_elements*sizeof(T))/1024.0f/1024.0f << " MB" << std::endl;
 
+    // allocate host memory and store in smart ptr with custom deleter
+    hoomd::detail::host_deleter<T> host_deleter;
+    T *host_ptr = allocateHostMemory(m_num_elements, host_deleter);
+    h_data = std::unique_ptr<T, hoomd::detail::host_deleter<T> >(host_ptr, host_deleter);
+
+#ifdef ENABLE_CUDA
+    assert(!d_data);
+    if (m_exec_conf && m_exec_conf->isCUDAEnabled())
+        {
+        // allocate and/or map host memory
+        if (m_mapped)
+            {
+            void *device_ptr = nullptr;
+            cudaHostGetDevicePointer(&device_ptr, h_data.get(), 0);
+            CHECK_CUDA_ERROR();
+
+            // store in smart pointer with custom deleter
+            hoomd::detail::cuda_deleter<T> cuda_deleter(m_exec_conf, true, m_num_elements, m_mapped);
+            d_data = std::unique_ptr<T, hoomd::detail::cuda_deleter<T> >(reinterpret_cast<T *>(device_ptr), cuda_deleter);
+            }
+        else
+            {
+            hoomd::detail::cuda_deleter<T> cuda_deleter;
+            T *device_ptr = allocateDeviceMemory(m_num_elements, cuda_deleter);
+            d_data = std::unique_ptr<T, hoomd::detail::cuda_deleter<T> >(device_ptr, cuda_deleter);
+            }
+        }
+#endif
+    }
+
+/*! \param num_elements Number of elements to allocate
+    \param deleter Deleter for the allocation (output)
+    \returns Pointer to the allocation
+
+    Small arrays are sub-allocated from pinned slabs of the SlabAllocator, other arrays are registered individually
+    with the CUDA driver for DMA.
+*/
+template<class T> T* GPUArray<T>::allocateHostMemory(unsigned int num_elements,
+    hoomd::detail::host_deleter<T>& deleter) const
+    {
+    bool use_device = m_exec_conf && m_exec_conf->isCUDAEnabled();
+
+#ifdef ENABLE_CUDA
+    // mapped memory is registered individually
+    SlabAllocator *slab = (use_device && !m_mapped) ? m_exec_conf->getSlabAllocator(SlabAllocator::host_pinned) : nullptr;
+    if (slab && SlabAllocator::isSmall(num_elements*sizeof(T)))
+        {
+        void *host_ptr = slab->allocate(num_elements*sizeof(T), 0, m_exec_conf->getMemoryTracer());
+        deleter = hoomd::detail::host_deleter<T>(m_exec_conf, num_elements, slab);
+        deleter.account(m_exec_conf->getMemoryUsage()->getCurrentOwner());
+        return reinterpret_cast<T *>(host_ptr);
+        }
+#endif
+
     void *host_ptr = nullptr;
 
-    // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
-    int retval = posix_memalign(&host_ptr, 32, m_num_elements*sizeof(T));
+    // at minimum, alignment needs to be 32 bytes for AVX, large arrays may be aligned to huge pages
+    int retval = m_exec_conf ? m_exec_conf->allocateHostArray(&host_ptr, num_elements*sizeof(T))
+        : posix_memalign(&host_ptr, 32, num_elements*sizeof(T));
     if (retval != 0)
         {
         if (m_exec_conf)
@@ -915,44 +1254,63 @@ template<class T> void GPUArray<T>::allocate()
         throw std::runtime_error("Error allocating GPUArray.");
         }
 
-    bool use_device = m_exec_conf && m_exec_conf->isCUDAEnabled();
-
 #ifdef ENABLE_CUDA
-    void *device_ptr = nullptr;
     if (use_device)
         {
         // register pointer for DMA
-        cudaHostRegister(host_ptr,m_num_elements*sizeof(T), m_mapped ? cudaHostRegisterMapped : cudaHostRegisterDefault);
+        cudaHostRegister(host_ptr, num_elements*sizeof(T), m_mapped ? cudaHostRegisterMapped : cudaHostRegisterDefault);
         CHECK_CUDA_ERROR();
         }
 #endif
 
-    // store in smart ptr with custom deleter
-    hoomd::detail::host_deleter<T> host_deleter(m_exec_conf, use_device, m_num_elements);
-    h_data = std::unique_ptr<T, hoomd::detail::host_deleter<T> >(reinterpret_cast<T *>(host_ptr), host_deleter);
+    deleter = hoomd::detail::host_deleter<T>(m_exec_conf, use_device, num_elements);
+    if (m_exec_conf)
+        deleter.account(m_exec_conf->getMemoryUsage()->getCurrentOwner());
+    return reinterpret_cast<T *>(host_ptr);
+    }
+
+/*! \param ptr Host memory to clear
+    \param num_elements Number of elements to clear
+
+    The execution configuration may clear large arrays in parallel, so that their pages are first touched on the NUMA
+    nodes of the threads that use them.
+*/
+template<class T> void GPUArray<T>::clearHostMemory(T *ptr, unsigned int num_elements) const
+    {
+    if (m_exec_conf)
+        m_exec_conf->clearHostArray((void *)ptr, sizeof(T)*num_elements);
+    else
+        memset((void *)ptr, 0, sizeof(T)*num_elements);
+    }
 
 #ifdef ENABLE_CUDA
-    assert(!d_data);
-    if (m_exec_conf && m_exec_conf->isCUDAEnabled())
-        {
-        // allocate and/or map host memory
-        if (m_mapped)
-            {
-            cudaHostGetDevicePointer(&device_ptr, h_data.get(), 0);
-            CHECK_CUDA_ERROR();
-            }
-        else
-            {
-            cudaMalloc(&device_ptr, m_num_elements*sizeof(T));
-            CHECK_CUDA_ERROR();
-            }
+/*! \param num_elements Number of elements to allocate
+    \param deleter Deleter for the allocation (output)
+    \returns Pointer to the allocation
 
-        // store in smart pointer with custom deleter
-        hoomd::detail::cuda_deleter<T> cuda_deleter(m_exec_conf, use_device, m_num_elements, m_mapped);
-        d_data = std::unique_ptr<T, hoomd::detail::cuda_deleter<T> >(reinterpret_cast<T *>(device_ptr), cuda_deleter);
+    Small arrays are sub-allocated from device slabs of the SlabAllocator.
+*/
+template<class T> T* GPUArray<T>::allocateDeviceMemory(unsigned int num_elements,
+    hoomd::detail::cuda_deleter<T>& deleter) const
+    {
+    SlabAllocator *slab = m_exec_conf->getSlabAllocator(SlabAllocator::device);
+    if (slab && SlabAllocator::isSmall(num_elements*sizeof(T)))
+        {
+        void *device_ptr = slab->allocate(num_elements*sizeof(T), 0, m_exec_conf->getMemoryTracer());
+        deleter = hoomd::detail::cuda_deleter<T>(m_exec_conf, num_elements, slab);
+        deleter.account(m_exec_conf->getMemoryUsage()->getCurrentOwner());
+        return reinterpret_cast<T *>(device_ptr);
         }
-#endif
+
+    T *device_ptr = nullptr;
+    cudaMalloc(&device_ptr, num_elements*sizeof(T));
+    CHECK_CUDA_ERROR();
+
+    deleter = hoomd::detail::cuda_deleter<T>(m_exec_conf, true, num_elements, false);
+    deleter.account(m_exec_conf->getMemoryUsage()->getCurrentOwner());
+    return device_ptr;
     }
+#endif
 
 /*! \pre allocate() has been called
     \post All allocated memory is set to 0
@@ -967,7 +1325,7 @@ template<class T> void GPUArray<T>::memclear(unsigned int first)
     assert(first < m_num_elements);
 
     // clear memory
-    memset((void *)(h_data.get()+first), 0, sizeof(T)*(m_num_elements-first));
+    clearHostMemory(h_data.get()+first, m_num_elements-first);
 
 #ifdef ENABLE_CUDA
     if (m_exec_conf && m_exec_conf->isCUDAEnabled())
@@ -1033,6 +1391,75 @@ template<class T> void GPUArray<T>::memcpyHostToDevice(bool async) const
     if (m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
     }
+
+/*! \param location Location where the data will be accessed next
+    \param stream CUDA stream to copy the data in
+
+    When the valid copy of the data is in the other memory, prefetch() copies it asynchronously in \a stream, so that
+    the copy can overlap with kernels and host work. Afterwards, the data is valid in both memories
+    (data_location::hostdevice). The next handle to the data waits for the copy: on the host, it synchronizes with
+    the copy, on the device, the default stream waits for it.
+
+    prefetch() does nothing when the data is already valid at \a location, in mapped memory, and without a GPU.
+*/
+template<class T> void GPUArray<T>::prefetch(const access_location::Enum location, cudaStream_t stream) const
+    {
+    assert(!m_acquired);
+    if (isNull() || m_mapped || !m_exec_conf || !m_exec_conf->isCUDAEnabled())
+        return;
+
+    if (location == access_location::host && m_data_location == data_location::device)
+        {
+        m_exec_conf->msg->notice(8) << "GPUArray: Prefetching " << float(m_num_elements*sizeof(T))/1024.0f/1024.0f
+                                    << " MB device->host" << std::endl;
+        cudaMemcpyAsync(h_data.get(), d_data.get(), sizeof(T)*m_num_elements, cudaMemcpyDeviceToHost, stream);
+        }
+    else if (location == access_location::device && m_data_location == data_location::host)
+        {
+        m_exec_conf->msg->notice(8) << "GPUArray: Prefetching " << float(m_num_elements*sizeof(T))/1024.0f/1024.0f
+                                    << " MB host->device" << std::endl;
+        cudaMemcpyAsync(d_data.get(), h_data.get(), sizeof(T)*m_num_elements, cudaMemcpyHostToDevice, stream);
+        }
+    else
+        return;
+
+    if (!m_prefetch_event)
+        {
+        m_prefetch_event = std::unique_ptr<cudaEvent_t, hoomd::detail::event_deleter>(
+            new cudaEvent_t, hoomd::detail::event_deleter(m_exec_conf));
+        cudaEventCreate(m_prefetch_event.get(), cudaEventDisableTiming);
+        }
+    cudaEventRecord(*m_prefetch_event, stream);
+    m_prefetch_pending = true;
+    m_data_location = data_location::hostdevice;
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    }
+
+/*! \param location Location where the data is accessed
+
+    Host accesses synchronize with the copy, which then is complete. Device accesses make the default stream wait
+    for the copy, which may still be in progress from the point of view of the host.
+*/
+template<class T> void GPUArray<T>::waitPrefetch(const access_location::Enum location) const
+    {
+    if (!m_prefetch_pending || !m_prefetch_event)
+        return;
+
+    if (location == access_location::host)
+        {
+        cudaEventSynchronize(*m_prefetch_event);
+        m_prefetch_pending = false;
+        }
+    else
+        {
+        cudaStreamWaitEvent(0, *m_prefetch_event, 0);
+        }
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    }
 #endif
 
 /*! \param location Desired location to access the data
@@ -1060,6 +1487,10 @@ ArrayHandleDispatch<T> GPUArray<T>::acquire(const access_location::Enum location
     if (isNull())
         return GPUArrayDispatch<T>(nullptr, *this);
 
+#ifdef ENABLE_CUDA
+    waitPrefetch(location);
+#endif
+
     // first, break down based on where the data is to be acquired
     if (location == access_location::host)
         {
@@ -1213,6 +1644,84 @@ ArrayHandleDispatch<T> GPUArray<T>::acquire(const access_location::Enum location
         }
     }
 
+/*! \param location Desired location to access the data
+    \param mode Mode to access the data with
+    \param first First element of the range
+    \param count Number of elements in the range
+    \param partial Output: true if only the range was copied, and has to be written back with releaseRange()
+
+    When the valid copy of the data is in the other memory, only the range is copied (except with
+    access_mode::overwrite) and the state of the data location does not change. Otherwise, the whole array is
+    acquired with acquire().
+*/
+template<class T>
+ArrayHandleDispatch<T> GPUArray<T>::acquireRange(const access_location::Enum location, const access_mode::Enum mode,
+    unsigned int first, unsigned int count, bool& partial) const
+    {
+    partial = false;
+
+#ifdef ENABLE_CUDA
+    bool use_device = m_exec_conf && m_exec_conf->isCUDAEnabled();
+    data_location::Enum other = (location == access_location::host) ? data_location::device : data_location::host;
+    if (!isNull() && use_device && !m_mapped && m_data_location == other)
+        {
+        assert(!m_acquired);
+        assert(first + count <= m_num_elements);
+        m_acquired = true;
+        partial = true;
+
+        waitPrefetch(location);
+
+        if (m_exec_conf)
+            m_exec_conf->msg->notice(8) << "GPUArray: Copying " << float(count*sizeof(T))/1024.0f/1024.0f << " MB "
+                                        << ((location == access_location::host) ? "device->host" : "host->device")
+                                        << " (range)" << std::endl;
+
+        if (location == access_location::host)
+            {
+            if (mode != access_mode::overwrite && count > 0)
+                cudaMemcpy(h_data.get()+first, d_data.get()+first, sizeof(T)*count, cudaMemcpyDeviceToHost);
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            return GPUArrayDispatch<T>(h_data.get(), *this);
+            }
+        else
+            {
+            if (mode != access_mode::overwrite && count > 0)
+                cudaMemcpy(d_data.get()+first, h_data.get()+first, sizeof(T)*count, cudaMemcpyHostToDevice);
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            return GPUArrayDispatch<T>(d_data.get(), *this);
+            }
+        }
+#endif
+
+    return acquire(location, mode);
+    }
+
+/*! \param location Location at which the range was acquired
+    \param first First element of the range
+    \param count Number of elements in the range
+
+    The modified range is copied back to the memory with the valid copy of the data.
+*/
+template<class T>
+void GPUArray<T>::releaseRange(const access_location::Enum location, unsigned int first, unsigned int count) const
+    {
+#ifdef ENABLE_CUDA
+    if (count == 0)
+        return;
+
+    if (location == access_location::host)
+        cudaMemcpy(d_data.get()+first, h_data.get()+first, sizeof(T)*count, cudaMemcpyHostToDevice);
+    else
+        cudaMemcpy(h_data.get()+first, d_data.get()+first, sizeof(T)*count, cudaMemcpyDeviceToHost);
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+#endif
+    }
+
 /*! \post Memory on the host is resized, the newly allocated part of the array
  *        is reset to zero
  *! \returns a pointer to the newly allocated memory area
@@ -1223,27 +1732,11 @@ template<class T> T* GPUArray<T>::resizeHostArray(unsigned int num_elements)
     if (isNull()) return NULL;
 
     // allocate resized array
-    T *h_tmp = NULL;
-
-    // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
-    int retval = posix_memalign((void**)&h_tmp, 32, num_elements*sizeof(T));
-    if (retval != 0)
-        {
-        if (m_exec_conf)
-            m_exec_conf->msg->error() << "Error allocating aligned memory" << std::endl;
-        throw std::runtime_error("Error allocating GPUArray.");
-        }
+    hoomd::detail::host_deleter<T> host_deleter;
+    T *h_tmp = allocateHostMemory(num_elements, host_deleter);
 
-#ifdef ENABLE_CUDA
-    if (m_exec_conf && m_exec_conf->isCUDAEnabled())
-        {
-        cudaHostRegister(h_tmp, num_elements*sizeof(T), m_mapped ? cudaHostRegisterMapped : cudaHostRegisterDefault);
-        CHECK_CUDA_ERROR();
-        }
-#endif
     // clear memory
-    memset((void *)h_tmp, 0, sizeof(T)*num_elements);
+    clearHostMemory(h_tmp, num_elements);
 
     // copy over data
     unsigned int num_copy_elements = m_num_elements > num_elements ? num_elements : m_num_elements;
@@ -1251,7 +1744,6 @@ template<class T> T* GPUArray<T>::resizeHostArray(unsigned int num_elements)
 
     // update smart pointer
     bool use_device = m_exec_conf && m_exec_conf->isCUDAEnabled();
-    hoomd::detail::host_deleter<T> host_deleter(m_exec_conf, use_device, num_elements);
     h_data = std::unique_ptr<T, hoomd::detail::host_deleter<T> >(h_tmp, host_deleter);
 
 #ifdef ENABLE_CUDA
@@ -1277,29 +1769,11 @@ template<class T> T* GPUArray<T>::resizeHostArray(unsigned int num_elements)
 template<class T> T* GPUArray<T>::resize2DHostArray(unsigned int pitch, unsigned int new_pitch, unsigned int height, unsigned int new_height )
     {
     // allocate resized array
-    T *h_tmp = NULL;
-
-    // allocate host memory
-    // at minimum, alignment needs to be 32 bytes for AVX
-    unsigned int size = new_pitch*new_height*sizeof(T);
-    int retval = posix_memalign((void**)&h_tmp, 32, size);
-    if (retval != 0)
-        {
-        if (m_exec_conf)
-            m_exec_conf->msg->error() << "Error allocating aligned memory" << std::endl;
-        throw std::runtime_error("Error allocating GPUArray.");
-        }
-
-#ifdef ENABLE_CUDA
-    if (m_exec_conf && m_exec_conf->isCUDAEnabled())
-        {
-        cudaHostRegister(h_tmp, size, m_mapped ? cudaHostRegisterMapped : cudaHostRegisterDefault);
-        CHECK_CUDA_ERROR();
-        }
-#endif
+    hoomd::detail::host_deleter<T> host_deleter;
+    T *h_tmp = allocateHostMemory(new_pitch*new_height, host_deleter);
 
     // clear memory
-    memset((void *)h_tmp, 0, sizeof(T)*new_pitch*new_height);
+    clearHostMemory(h_tmp, new_pitch*new_height);
 
     // copy over data
     // every column is copied separately such as to align with the new pitch
@@ -1310,7 +1784,6 @@ template<class T> T* GPUArray<T>::resize2DHostArray(unsigned int pitch, unsigned
 
     // update smart pointer
     bool use_device = m_exec_conf && m_exec_conf->isCUDAEnabled();
-    hoomd::detail::host_deleter<T> host_deleter(m_exec_conf, use_device, new_pitch*new_height);
     h_data = std::unique_ptr<T, hoomd::detail::host_deleter<T> >(h_tmp, host_deleter);
 
 #ifdef ENABLE_CUDA
@@ -1340,9 +1813,8 @@ template<class T> T* GPUArray<T>::resizeDeviceArray(unsigned int num_elements)
     if (m_mapped) return NULL;
 
     // allocate resized array
-    T *d_tmp;
-    cudaMalloc(&d_tmp, num_elements*sizeof(T));
-    CHECK_CUDA_ERROR();
+    hoomd::detail::cuda_deleter<T> cuda_deleter;
+    T *d_tmp = allocateDeviceMemory(num_elements, cuda_deleter);
 
     assert(d_tmp);
 
@@ -1356,7 +1828,6 @@ template<class T> T* GPUArray<T>::resizeDeviceArray(unsigned int num_elements)
     CHECK_CUDA_ERROR();
 
     // update smart ptr
-    hoomd::detail::cuda_deleter<T> cuda_deleter(m_exec_conf, m_exec_conf->isCUDAEnabled(), num_elements, m_mapped);
     d_data = std::unique_ptr<T, hoomd::detail::cuda_deleter<T> >(d_tmp, cuda_deleter);
 
     return d_data.get();
@@ -1375,9 +1846,8 @@ template<class T> T* GPUArray<T>::resize2DDeviceArray(unsigned int pitch, unsign
     if (m_mapped) return NULL;
 
     // allocate resized array
-    T *d_tmp;
-    cudaMalloc(&d_tmp, new_pitch*new_height*sizeof(T));
-    CHECK_CUDA_ERROR();
+    hoomd::detail::cuda_deleter<T> cuda_deleter;
+    T *d_tmp = allocateDeviceMemory(new_pitch*new_height, cuda_deleter);
 
     assert(d_tmp);
 
@@ -1397,7 +1867,6 @@ template<class T> T* GPUArray<T>::resize2DDeviceArray(unsigned int pitch, unsign
         }
 
     // update smart ptr
-    hoomd::detail::cuda_deleter<T> cuda_deleter(m_exec_conf, m_exec_conf->isCUDAEnabled(), new_pitch*new_height, m_mapped);
     d_data = std::unique_ptr<T, hoomd::detail::cuda_deleter<T> >(d_tmp, cuda_deleter);
 
     return d_data.get();
@@ -1417,6 +1886,11 @@ template<class T> void GPUArray<T>::resize(unsigned int num_elements)
     assert(! m_acquired);
     assert(num_elements > 0);
 
+#ifdef ENABLE_CUDA
+    // a prefetch may still access the old memory
+    waitPrefetch(access_location::host);
+#endif
+
     // if not allocated, simply allocate
     if (isNull())
         {
@@ -1454,6 +1928,11 @@ template<class T> void GPUArray<T>::resize(unsigned int width, unsigned int heig
     {
     assert(! m_acquired);
 
+#ifdef ENABLE_CUDA
+    // a prefetch may still access the old memory
+    waitPrefetch(access_location::host);
+#endif
+
     // make m_pitch the next multiple of 16 larger or equal to the given width
     unsigned int new_pitch = (width + (16 - (width & 15)));
 
@@ -19,9 +19,37 @@
 #include <string.h>
 #include <stdexcept>
 #include <list>
+#include <algorithm>
+
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 using namespace std;
 namespace py = pybind11;
 
+//! Resolution of the orientation deltas
+static const float orientation_delta_resolution = 1.0f/16384.0f;
+
+//! Call a function for every chunk of the particles, in parallel when running with multiple threads
+/*! \param n_chunks Number of chunks
+    \param f Function to call with the index of the chunk
+*/
+template<class F>
+static void for_each_chunk(unsigned int n_chunks, const F& f)
+    {
+    #ifdef ENABLE_TBB
+    if (n_chunks > 1)
+        {
+        tbb::parallel_for((unsigned int)0, n_chunks, f);
+        return;
+        }
+    #endif
+
+    for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+        f(chunk);
+    }
+
 /*! Constructs the GSDDumpWriter. After construction, settings are set. No file operations are
     attempted until analyze() is called.
 
@@ -41,9 +69,294 @@ GSDDumpWriter::GSDDumpWriter(std::shared_ptr<SystemDefinition> sysdef,
     : Analyzer(sysdef), m_fname(fname), m_overwrite(overwrite),
                         m_truncate(truncate),
                         m_is_initialized(false),
-                        m_group(group)
+                        m_group(group),
+                        m_quantize_bits(0),
+                        m_keyframe_period(0),
+                        m_delta_resolution(Scalar(0.0)),
+                        m_has_keyframe(false),
+                        m_keyframe(0),
+                        m_delta_frame(false),
+                        m_async(false),
+                        m_pending_frame(false),
+                        m_writer_exit(false),
+                        m_writer_retval(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing GSDDumpWriter: " << m_fname << " " << overwrite << " " << truncate << endl;
+
+    #ifdef ENABLE_MPI
+    m_parallel = false;
+    m_mpi_file_open = false;
+    #endif
+    }
+
+/*! \param async True to write frames on a background thread
+
+    Disabling asynchronous mode waits for the pending frame and stops the writer thread.
+*/
+void GSDDumpWriter::setAsync(bool async)
+    {
+    if (m_async && !async)
+        stopWriter();
+
+    m_async = async;
+    }
+
+/*! \param bits Number of bits per coordinate, from 1 to 16, or 0 to write full precision float positions
+*/
+void GSDDumpWriter::setQuantizePositions(unsigned int bits)
+    {
+    if (bits > 16)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Cannot quantize positions to more than 16 bits" << endl;
+        throw runtime_error("Error setting GSD position quantization");
+        }
+
+    m_quantize_bits = bits;
+    }
+
+/*! \param keyframe_period Number of frames from one keyframe to the next, 0 or 1 to write every frame in full
+    \param resolution Resolution of the position deltas (in distance units)
+
+    With 16 bit deltas, a particle may move up to 32767 times the resolution from its keyframe position before a
+    new keyframe is forced.
+*/
+void GSDDumpWriter::setDeltaEncoding(unsigned int keyframe_period, Scalar resolution)
+    {
+    if (keyframe_period > 1 && !(resolution > Scalar(0.0)))
+        {
+        m_exec_conf->msg->error() << "dump.gsd: The delta resolution must be positive" << endl;
+        throw runtime_error("Error setting GSD delta encoding");
+        }
+    if (keyframe_period > 1 && m_quantize_bits > 0)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Cannot combine delta encoding with quantized positions" << endl;
+        throw runtime_error("Error setting GSD delta encoding");
+        }
+
+    m_keyframe_period = keyframe_period > 1 ? keyframe_period : 0;
+    m_delta_resolution = resolution;
+
+    // start with a keyframe
+    m_has_keyframe = false;
+    }
+
+/*! \param nframes Index of the frame to be written
+    \returns true if the frame is not due to be a keyframe and the group is unchanged since the last keyframe
+*/
+bool GSDDumpWriter::isDeltaFrame(uint64_t nframes) const
+    {
+    if (m_keyframe_period == 0 || !m_has_keyframe || nframes == 0 || m_keyframe >= nframes)
+        return false;
+
+    if (nframes - m_keyframe >= m_keyframe_period)
+        return false;
+
+    const unsigned int N = m_group->getNumMembersGlobal();
+    if (m_key_tags.size() != N)
+        return false;
+
+    for (unsigned int group_idx = 0; group_idx < N; group_idx++)
+        {
+        if (m_group->getMemberTag(group_idx) != m_key_tags[group_idx])
+            return false;
+        }
+
+    return true;
+    }
+
+/*! \param pos Positions of the group members
+    \param delta Output, displacements from the keyframe positions in units of the resolution
+    \returns false if a displacement does not fit into 16 bits
+
+    The displacements are taken with the minimum image convention, so that particles that cross a periodic boundary
+    can still be encoded.
+*/
+bool GSDDumpWriter::encodePositionDeltas(const std::vector<float>& pos, std::vector<int16_t>& delta) const
+    {
+    const unsigned int N = m_key_tags.size();
+    const BoxDim& box = m_pdata->getGlobalBox();
+    const Scalar inv_resolution = Scalar(1.0) / m_delta_resolution;
+    const Scalar max_delta = Scalar(32767.0);
+
+    delta.resize(N*3);
+
+    const unsigned int n_chunks = std::max(1u, std::min(m_exec_conf->getNumThreads(), N));
+    const unsigned int chunk_size = (N + n_chunks - 1) / n_chunks;
+    std::vector<char> overflow(n_chunks, 0);
+
+    for_each_chunk(n_chunks, [&] (unsigned int chunk)
+        {
+        const unsigned int i_end = std::min((chunk+1)*chunk_size, N);
+        for (unsigned int i = chunk*chunk_size; i < i_end; i++)
+            {
+            Scalar3 d = make_scalar3(Scalar(pos[i*3+0]) - Scalar(m_key_pos[i*3+0]),
+                                     Scalar(pos[i*3+1]) - Scalar(m_key_pos[i*3+1]),
+                                     Scalar(pos[i*3+2]) - Scalar(m_key_pos[i*3+2]));
+            d = box.minImage(d) * inv_resolution;
+
+            if (fabs(d.x) > max_delta || fabs(d.y) > max_delta || fabs(d.z) > max_delta)
+                {
+                overflow[chunk] = 1;
+                break;
+                }
+
+            delta[i*3+0] = int16_t(lround(d.x));
+            delta[i*3+1] = int16_t(lround(d.y));
+            delta[i*3+2] = int16_t(lround(d.z));
+            }
+        });
+
+    return std::find(overflow.begin(), overflow.end(), 1) == overflow.end();
+    }
+
+/*! \param orientation Orientations of the group members
+    \param delta Output, differences to the keyframe orientations in units of orientation_delta_resolution
+
+    The sign of a quaternion is chosen to be closest to its keyframe orientation, so that every difference is smaller
+    than 2 in magnitude.
+*/
+void GSDDumpWriter::encodeOrientationDeltas(const std::vector<float>& orientation, std::vector<int16_t>& delta) const
+    {
+    const unsigned int N = m_key_tags.size();
+    delta.resize(N*4);
+
+    const unsigned int n_chunks = std::max(1u, std::min(m_exec_conf->getNumThreads(), N));
+    const unsigned int chunk_size = (N + n_chunks - 1) / n_chunks;
+
+    for_each_chunk(n_chunks, [&] (unsigned int chunk)
+        {
+        const unsigned int i_end = std::min((chunk+1)*chunk_size, N);
+        for (unsigned int i = chunk*chunk_size; i < i_end; i++)
+            {
+            float dot = 0.0f;
+            for (unsigned int k = 0; k < 4; k++)
+                dot += orientation[i*4+k] * m_key_orientation[i*4+k];
+            const float sign = (dot < 0.0f) ? -1.0f : 1.0f;
+
+            for (unsigned int k = 0; k < 4; k++)
+                {
+                long q = lround((sign*orientation[i*4+k] - m_key_orientation[i*4+k]) / orientation_delta_resolution);
+                delta[i*4+k] = int16_t(std::max(-32767l, std::min(32767l, q)));
+                }
+            }
+        });
+    }
+
+/*! In synchronous mode, the chunk is written immediately. In asynchronous mode, the data is copied into the staging
+    frame and written by the writer thread after submitFrame().
+
+    \returns The gsd_write_chunk() return value (always 0 when staging)
+*/
+int GSDDumpWriter::writeChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, uint8_t flags, const void *data)
+    {
+    if (!m_async)
+        return gsd_write_chunk(&m_handle, name, type, N, M, flags, data);
+
+    StagedChunk chunk;
+    chunk.name = name;
+    chunk.type = type;
+    chunk.N = N;
+    chunk.M = M;
+    chunk.flags = flags;
+    size_t size = gsd_sizeof_type(type) * N * M;
+    chunk.data.resize(size);
+    if (size > 0)
+        memcpy(&chunk.data[0], data, size);
+    m_staged.push_back(std::move(chunk));
+    return 0;
+    }
+
+void GSDDumpWriter::submitFrame()
+    {
+    // the writer thread is started on the first frame
+    if (!m_writer_thread.joinable())
+        {
+        m_writer_exit = false;
+        m_writer_thread = std::thread(&GSDDumpWriter::writerThread, this);
+        }
+
+        {
+        std::lock_guard<std::mutex> lock(m_writer_mutex);
+        m_pending.swap(m_staged);
+        m_pending_frame = true;
+        }
+    m_writer_cv.notify_all();
+
+    // reuse the staging buffer for the next frame
+    m_staged.clear();
+    }
+
+void GSDDumpWriter::waitForWriter()
+    {
+    int retval = 0;
+        {
+        std::unique_lock<std::mutex> lock(m_writer_mutex);
+        m_writer_cv.wait(lock, [this] { return !m_pending_frame; });
+        retval = m_writer_retval;
+        m_writer_retval = 0;
+        }
+    checkError(retval);
+    }
+
+void GSDDumpWriter::stopWriter()
+    {
+    if (!m_writer_thread.joinable())
+        return;
+
+        {
+        std::lock_guard<std::mutex> lock(m_writer_mutex);
+        m_writer_exit = true;
+        }
+    m_writer_cv.notify_all();
+    m_writer_thread.join();
+    }
+
+/*! The writer thread waits for frames handed over by submitFrame() and writes them out. The loop exits when
+    m_writer_exit is set and no frame is pending.
+*/
+void GSDDumpWriter::writerThread()
+    {
+    std::unique_lock<std::mutex> lock(m_writer_mutex);
+    while (true)
+        {
+        m_writer_cv.wait(lock, [this] { return m_pending_frame || m_writer_exit; });
+
+        if (!m_pending_frame)
+            break;
+
+        // perform the file I/O without holding the lock
+        lock.unlock();
+        int retval = 0;
+        for (auto const& chunk : m_pending)
+            {
+            retval = gsd_write_chunk(&m_handle,
+                                     chunk.name.c_str(),
+                                     chunk.type,
+                                     chunk.N,
+                                     chunk.M,
+                                     chunk.flags,
+                                     chunk.data.size() > 0 ? (const void *)&chunk.data[0] : NULL);
+            if (retval != 0)
+                break;
+            }
+
+        if (retval == 0)
+            retval = gsd_end_frame(&m_handle);
+        m_pending.clear();
+        lock.lock();
+
+        m_writer_retval = retval;
+        m_pending_frame = false;
+        m_writer_cv.notify_all();
+        }
+    }
+
+/*! Blocks until the frame that is currently being written by the writer thread is in the file.
+*/
+void GSDDumpWriter::flush()
+    {
+    if (m_async && m_is_initialized)
+        waitForWriter();
     }
 
 void GSDDumpWriter::checkError(int retval)
@@ -145,6 +458,14 @@ GSDDumpWriter::~GSDDumpWriter()
     root = m_exec_conf->isRoot();
     #endif
 
+    // finish the pending frame
+    stopWriter();
+
+    #ifdef ENABLE_MPI
+    if (m_mpi_file_open)
+        MPI_File_close(&m_mpi_file);
+    #endif
+
     if (root && m_is_initialized)
         {
         m_exec_conf->msg->notice(5) << "dump.gsd: close gsd file " << m_fname << endl;
@@ -152,6 +473,159 @@ GSDDumpWriter::~GSDDumpWriter()
         }
     }
 
+/*! \param snapshot Snapshot to fill on the root rank
+    \returns A map from the tag of each member to its index in the snapshot
+
+    takeSnapshot() gathers every particle in the system onto the root rank, which costs as much for a small group
+    as for the whole system. This method walks the local member index list of the group on each rank, packs only the
+    members into two buffers (one for the real valued and one for the integer valued quantities) and gathers them
+    onto the root rank. There, the members are placed in the snapshot in the order of the sorted member tags, so that
+    the snapshot index of a member equals its row in the output chunks.
+
+    Positions are stored relative to the origin and wrapped into the global box as in takeSnapshot(). Accelerations
+    are not written by dump.gsd and are left at 0.
+*/
+std::map<unsigned int, unsigned int> GSDDumpWriter::takeGroupSnapshot(SnapshotParticleData<float>& snapshot)
+    {
+    // number of values per member in the packed buffers
+    const unsigned int n_real = 20;
+    const unsigned int n_int = 6;
+
+    std::vector<float> real_buf;
+    std::vector<unsigned int> int_buf;
+
+        {
+        unsigned int n_local = m_group->getNumMembers();
+        ArrayHandle<unsigned int> h_member_idx(m_group->getIndexArray(), access_location::host, access_mode::read);
+
+        ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        const BoxDim& global_box = m_pdata->getGlobalBox();
+        Scalar3 origin = m_pdata->getOrigin();
+        int3 o_image = m_pdata->getOriginImage();
+
+        real_buf.resize(n_local*n_real);
+        int_buf.resize(n_local*n_int);
+        for (unsigned int j = 0; j < n_local; j++)
+            {
+            unsigned int idx = h_member_idx.data[j];
+
+            Scalar3 pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z) - origin;
+            int3 img = h_image.data[idx];
+            img.x -= o_image.x;
+            img.y -= o_image.y;
+            img.z -= o_image.z;
+            global_box.wrap(pos, img);
+
+            float *r = &real_buf[j*n_real];
+            r[0] = float(pos.x);
+            r[1] = float(pos.y);
+            r[2] = float(pos.z);
+            r[3] = float(h_vel.data[idx].x);
+            r[4] = float(h_vel.data[idx].y);
+            r[5] = float(h_vel.data[idx].z);
+            r[6] = float(h_vel.data[idx].w);
+            r[7] = float(h_charge.data[idx]);
+            r[8] = float(h_diameter.data[idx]);
+            r[9] = float(h_orientation.data[idx].x);
+            r[10] = float(h_orientation.data[idx].y);
+            r[11] = float(h_orientation.data[idx].z);
+            r[12] = float(h_orientation.data[idx].w);
+            r[13] = float(h_angmom.data[idx].x);
+            r[14] = float(h_angmom.data[idx].y);
+            r[15] = float(h_angmom.data[idx].z);
+            r[16] = float(h_angmom.data[idx].w);
+            r[17] = float(h_inertia.data[idx].x);
+            r[18] = float(h_inertia.data[idx].y);
+            r[19] = float(h_inertia.data[idx].z);
+
+            unsigned int *i = &int_buf[j*n_int];
+            i[0] = h_tag.data[idx];
+            i[1] = __scalar_as_int(h_pos.data[idx].w);
+            i[2] = h_body.data[idx];
+            i[3] = (unsigned int)img.x;
+            i[4] = (unsigned int)img.y;
+            i[5] = (unsigned int)img.z;
+            }
+        }
+
+    std::vector< std::vector<float> > real_proc(1);
+    std::vector< std::vector<unsigned int> > int_proc(1);
+
+#ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        const MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+        real_proc.resize(m_exec_conf->getNRanks());
+        int_proc.resize(m_exec_conf->getNRanks());
+        gather_v(real_buf, real_proc, 0, mpi_comm);
+        gather_v(int_buf, int_proc, 0, mpi_comm);
+        }
+    else
+#endif
+        {
+        real_proc[0].swap(real_buf);
+        int_proc[0].swap(int_buf);
+        }
+
+    std::map<unsigned int, unsigned int> map;
+    if (!m_exec_conf->isRoot())
+        return map;
+
+    unsigned int N = m_group->getNumMembersGlobal();
+    snapshot.resize(N);
+    for (unsigned int i = 0; i < m_pdata->getNTypes(); i++)
+        snapshot.type_mapping.push_back(m_pdata->getNameByType(i));
+
+    ArrayHandle<unsigned int> h_member_tags(m_group->getMemberTagArray(), access_location::host, access_mode::read);
+
+    unsigned int n_found = 0;
+    for (unsigned int rank = 0; rank < real_proc.size(); rank++)
+        {
+        unsigned int n = int_proc[rank].size() / n_int;
+        for (unsigned int j = 0; j < n; j++)
+            {
+            const float *r = &real_proc[rank][j*n_real];
+            const unsigned int *i = &int_proc[rank][j*n_int];
+
+            unsigned int tag = i[0];
+            unsigned int snap_id = std::lower_bound(h_member_tags.data, h_member_tags.data + N, tag) - h_member_tags.data;
+            assert(snap_id < N && h_member_tags.data[snap_id] == tag);
+            map.insert(std::make_pair(tag, snap_id));
+
+            snapshot.pos[snap_id] = vec3<float>(r[0], r[1], r[2]);
+            snapshot.vel[snap_id] = vec3<float>(r[3], r[4], r[5]);
+            snapshot.mass[snap_id] = r[6];
+            snapshot.charge[snap_id] = r[7];
+            snapshot.diameter[snap_id] = r[8];
+            snapshot.orientation[snap_id] = quat<float>(r[9], vec3<float>(r[10], r[11], r[12]));
+            snapshot.angmom[snap_id] = quat<float>(r[13], vec3<float>(r[14], r[15], r[16]));
+            snapshot.inertia[snap_id] = vec3<float>(r[17], r[18], r[19]);
+            snapshot.type[snap_id] = i[1];
+            snapshot.body[snap_id] = i[2];
+            snapshot.image[snap_id] = make_int3(int(i[3]), int(i[4]), int(i[5]));
+            n_found++;
+            }
+        }
+
+    if (n_found != N)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: gathered " << n_found << " of " << N << " group members" << endl;
+        throw runtime_error("Error gathering group members");
+        }
+
+    return map;
+    }
+
 /*! \param timestep Current time step of the simulation
 
     The first call to analyze() will create or overwrite the file and write out the current system configuration
@@ -165,10 +639,28 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     if (m_prof)
         m_prof->push("Dump GSD");
 
-    // take particle data snapshot
-    m_exec_conf->msg->notice(10) << "dump.gsd: taking particle data snapshot" << endl;
+    // collective writes replace the snapshot in domain decomposition simulations
+    bool parallel = false;
+#ifdef ENABLE_MPI
+    parallel = m_parallel && m_pdata->getDomainDecomposition();
+#endif
+
+    // take particle data snapshot, only gather the members of a group that does not include all particles
     SnapshotParticleData<float> snapshot;
-    const std::map<unsigned int, unsigned int>& map = m_pdata->takeSnapshot<float>(snapshot);
+    std::map<unsigned int, unsigned int> map;
+    if (!parallel)
+        {
+        if (m_group->getNumMembersGlobal() == m_pdata->getNGlobal())
+            {
+            m_exec_conf->msg->notice(10) << "dump.gsd: taking particle data snapshot" << endl;
+            map = m_pdata->takeSnapshot<float>(snapshot);
+            }
+        else
+            {
+            m_exec_conf->msg->notice(10) << "dump.gsd: taking group snapshot" << endl;
+            map = takeGroupSnapshot(snapshot);
+            }
+        }
 
 #ifdef ENABLE_MPI
     // if we are not the root processor, do not perform file I/O
@@ -179,6 +671,10 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     if (! m_is_initialized && root)
         initFileIO();
 
+    // wait for the previous frame before accessing the file handle
+    if (m_async && root)
+        waitForWriter();
+
     // truncate the file if requested
     if (m_truncate && root)
         {
@@ -233,14 +729,19 @@ void GSDDumpWriter::analyze(unsigned int timestep)
         writeFrameHeader(timestep);
 
         // only write out data chunk categories if requested, or if on frame 0
-        if (m_write_attribute || nframes == 0)
+        if (!parallel && (m_write_attribute || nframes == 0))
             writeAttributes(snapshot, map);
-        if (m_write_property || nframes == 0)
+        if (!parallel && (m_write_property || nframes == 0))
             writeProperties(snapshot, map);
-        if (m_write_momentum || nframes == 0)
+        if (!parallel && (m_write_momentum || nframes == 0))
             writeMomenta(snapshot, map);
         }
 
+#ifdef ENABLE_MPI
+    if (parallel)
+        writeParticlesParallel(nframes);
+#endif
+
     // topology is only meaningful if this is the all group
     if (m_group->getNumMembersGlobal() == m_pdata->getNGlobal() && (m_write_topology || nframes == 0))
         {
@@ -272,8 +773,15 @@ void GSDDumpWriter::analyze(unsigned int timestep)
     if (root)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: ending frame" << endl;
-        retval = gsd_end_frame(&m_handle);
-        checkError(retval);
+        if (m_async)
+            {
+            submitFrame();
+            }
+        else
+            {
+            retval = gsd_end_frame(&m_handle);
+            checkError(retval);
+            }
         }
 
     if (m_prof)
@@ -295,7 +803,7 @@ void GSDDumpWriter::writeTypeMapping(std::string chunk, std::vector< std::string
         std::vector<char> types(max_len * type_mapping.size());
         for (unsigned int i = 0; i < type_mapping.size(); i++)
             strncpy(&types[max_len*i], type_mapping[i].c_str(), max_len);
-        int retval = gsd_write_chunk(&m_handle, chunk.c_str(), GSD_TYPE_UINT8, type_mapping.size(), max_len, 0, (void *)&types[0]);
+        int retval = writeChunk(chunk.c_str(), GSD_TYPE_UINT8, type_mapping.size(), max_len, 0, (void *)&types[0]);
         checkError(retval);
         }
 
@@ -314,14 +822,14 @@ void GSDDumpWriter::writeFrameHeader(unsigned int timestep)
     int retval;
     m_exec_conf->msg->notice(10) << "dump.gsd: writing configuration/step" << endl;
     uint64_t step = timestep;
-    retval = gsd_write_chunk(&m_handle, "configuration/step", GSD_TYPE_UINT64, 1, 1, 0, (void *)&step);
+    retval = writeChunk("configuration/step", GSD_TYPE_UINT64, 1, 1, 0, (void *)&step);
     checkError(retval);
 
     if (gsd_get_nframes(&m_handle) == 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing configuration/dimensions" << endl;
         uint8_t dimensions = m_sysdef->getNDimensions();
-        retval = gsd_write_chunk(&m_handle, "configuration/dimensions", GSD_TYPE_UINT8, 1, 1, 0, (void *)&dimensions);
+        retval = writeChunk("configuration/dimensions", GSD_TYPE_UINT8, 1, 1, 0, (void *)&dimensions);
         checkError(retval);
         }
 
@@ -334,12 +842,12 @@ void GSDDumpWriter::writeFrameHeader(unsigned int timestep)
     box_a[3] = box.getTiltFactorXY();
     box_a[4] = box.getTiltFactorXZ();
     box_a[5] = box.getTiltFactorYZ();
-    retval = gsd_write_chunk(&m_handle, "configuration/box", GSD_TYPE_FLOAT, 6, 1, 0, (void *)box_a);
+    retval = writeChunk("configuration/box", GSD_TYPE_FLOAT, 6, 1, 0, (void *)box_a);
     checkError(retval);
 
     m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/N" << endl;
     uint32_t N = m_group->getNumMembersGlobal();
-    retval = gsd_write_chunk(&m_handle, "particles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+    retval = writeChunk("particles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
     checkError(retval);
     }
 
@@ -377,7 +885,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/typeid"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/typeid" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&type[0]);
+            retval = writeChunk("particles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&type[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/typeid"] = true;
@@ -406,7 +914,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/mass"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/mass" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/mass", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("particles/mass", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/mass"] = true;
@@ -430,7 +938,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/charge"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/charge" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/charge", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("particles/charge", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/charge"] = true;
@@ -455,7 +963,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/diameter"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/diameter" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/diameter", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("particles/diameter", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/diameter"] = true;
@@ -484,7 +992,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/body"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/body" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/body", GSD_TYPE_INT32, N, 1, 0, (void *)&body[0]);
+            retval = writeChunk("particles/body", GSD_TYPE_INT32, N, 1, 0, (void *)&body[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/body"] = true;
@@ -519,7 +1027,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
         if (!all_default || (nframes > 0 && m_nondefault["particles/moment_inertia"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/moment_inertia" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/moment_inertia", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
+            retval = writeChunk("particles/moment_inertia", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/moment_inertia"] = true;
@@ -529,7 +1037,7 @@ void GSDDumpWriter::writeAttributes(const SnapshotParticleData<float>& snapshot,
 
 /*! \param snapshot particle data snapshot to write out to the file
 
-    Writes the data chunks position and orientation in particles/.
+    Writes the data chunks position and orientation in particles/, or their deltas from the last keyframe.
 */
 void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot, const std::map<unsigned int, unsigned int> &map)
     {
@@ -554,9 +1062,61 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
             data[group_idx*3+2] = float(snapshot.pos[it->second].z);
             }
 
-        m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/position" << endl;
-        retval = gsd_write_chunk(&m_handle, "particles/position", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
-        checkError(retval);
+        // frames between keyframes store the displacements from the keyframe positions
+        std::vector<int16_t> ddata;
+        m_delta_frame = isDeltaFrame(nframes) && encodePositionDeltas(data, ddata);
+
+        if (m_delta_frame)
+            {
+            m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/position_delta" << endl;
+            uint64_t keyframe = m_keyframe;
+            retval = writeChunk("particles/position_keyframe", GSD_TYPE_UINT64, 1, 1, 0, (void *)&keyframe);
+            checkError(retval);
+            float resolution = float(m_delta_resolution);
+            retval = writeChunk("particles/position_delta_resolution", GSD_TYPE_FLOAT, 1, 1, 0, (void *)&resolution);
+            checkError(retval);
+            retval = writeChunk("particles/position_delta", GSD_TYPE_INT16, N, 3, 0, (void *)&ddata[0]);
+            checkError(retval);
+            }
+        else if (m_quantize_bits > 0)
+            {
+            // store fractional coordinates with the requested number of bits
+            const BoxDim& box = m_pdata->getGlobalBox();
+            std::vector<uint16_t> qdata(N*3);
+            qdata.reserve(1); //! make sure we allocate
+            for (unsigned int i = 0; i < N; i++)
+                {
+                Scalar3 f = box.makeFraction(make_scalar3(data[i*3+0], data[i*3+1], data[i*3+2]));
+                qdata[i*3+0] = quantizeFraction(f.x);
+                qdata[i*3+1] = quantizeFraction(f.y);
+                qdata[i*3+2] = quantizeFraction(f.z);
+                }
+
+            m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/position_quantized" << endl;
+            uint8_t bits = m_quantize_bits;
+            retval = writeChunk("particles/position_quantized_bits", GSD_TYPE_UINT8, 1, 1, 0, (void *)&bits);
+            checkError(retval);
+            retval = writeChunk("particles/position_quantized", GSD_TYPE_UINT16, N, 3, 0, (void *)&qdata[0]);
+            checkError(retval);
+            }
+        else
+            {
+            m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/position" << endl;
+            retval = writeChunk("particles/position", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
+            checkError(retval);
+
+            if (m_keyframe_period > 0)
+                {
+                // this frame is the new keyframe
+                m_has_keyframe = true;
+                m_keyframe = nframes;
+                m_key_tags.resize(N);
+                for (unsigned int group_idx = 0; group_idx < N; group_idx++)
+                    m_key_tags[group_idx] = m_group->getMemberTag(group_idx);
+                m_key_pos.swap(data);
+                m_key_orientation.clear();
+                }
+            }
         }
 
         {
@@ -586,13 +1146,26 @@ void GSDDumpWriter::writeProperties(const SnapshotParticleData<float>& snapshot,
             data[group_idx*4+3] = float(snapshot.orientation[it->second].v.z);
             }
 
-        if (!all_default || (nframes > 0 && m_nondefault["particles/orientation"]))
+        if (m_delta_frame && m_key_orientation.size() == data.size())
+            {
+            // the keyframe stored the orientations, store the differences to them
+            std::vector<int16_t> ddata;
+            encodeOrientationDeltas(data, ddata);
+
+            m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/orientation_delta" << endl;
+            retval = writeChunk("particles/orientation_delta", GSD_TYPE_INT16, N, 4, 0, (void *)&ddata[0]);
+            checkError(retval);
+            }
+        else if (!all_default || (nframes > 0 && m_nondefault["particles/orientation"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/orientation" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/orientation", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
+            retval = writeChunk("particles/orientation", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/orientation"] = true;
+
+            if (m_keyframe_period > 0 && !m_delta_frame)
+                m_key_orientation.swap(data);
             }
         }
     }
@@ -635,7 +1208,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         if (!all_default || (nframes > 0 && m_nondefault["particles/velocity"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/velocity" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/velocity", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
+            retval = writeChunk("particles/velocity", GSD_TYPE_FLOAT, N, 3, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/velocity"] = true;
@@ -672,7 +1245,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         if (!all_default || (nframes > 0 && m_nondefault["particles/angmom"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/angmom" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/angmom", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
+            retval = writeChunk("particles/angmom", GSD_TYPE_FLOAT, N, 4, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/angmom"] = true;
@@ -707,7 +1280,7 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         if (!all_default || (nframes > 0 && m_nondefault["particles/image"]))
             {
             m_exec_conf->msg->notice(10) << "dump.gsd: writing particles/image" << endl;
-            retval = gsd_write_chunk(&m_handle, "particles/image", GSD_TYPE_INT32, N, 3, 0, (void *)&data[0]);
+            retval = writeChunk("particles/image", GSD_TYPE_INT32, N, 3, 0, (void *)&data[0]);
             checkError(retval);
             if (nframes == 0)
                 m_nondefault["particles/image"] = true;
@@ -715,6 +1288,398 @@ void GSDDumpWriter::writeMomenta(const SnapshotParticleData<float>& snapshot, co
         }
     }
 
+#ifdef ENABLE_MPI
+/*! \param nframes Number of frames in the file before this one
+
+    Writes the same chunks as writeAttributes(), writeProperties() and writeMomenta(), but every rank contributes the
+    rows of its local group members. Row i of each chunk is the group member with the i-th smallest tag, as in the
+    serial writer. Must be called on all ranks.
+*/
+void GSDDumpWriter::writeParticlesParallel(uint64_t nframes)
+    {
+    bool root = m_exec_conf->isRoot();
+
+    // open the file created by the root rank for collective writes
+    if (!m_mpi_file_open)
+        {
+        // all ranks must open the file by the name the root rank uses
+        std::string fname = m_fname;
+        bcast(fname, 0, m_exec_conf->getMPICommunicator());
+
+        int retval = MPI_File_open(m_exec_conf->getMPICommunicator(),
+                                   fname.c_str(),
+                                   MPI_MODE_WRONLY,
+                                   MPI_INFO_NULL,
+                                   &m_mpi_file);
+        if (retval != MPI_SUCCESS)
+            {
+            m_exec_conf->msg->error() << "dump.gsd: Unable to open " << m_fname << " for parallel writes" << endl;
+            throw runtime_error("Error opening GSD file");
+            }
+        m_mpi_file_open = true;
+        }
+
+    // the file view of each chunk lists the local members in increasing row order
+    std::vector< std::pair<unsigned int, unsigned int> > rows;
+        {
+        unsigned int N = m_group->getNumMembersGlobal();
+        unsigned int n_local = m_group->getNumMembers();
+        ArrayHandle<unsigned int> h_member_tags(m_group->getMemberTagArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_member_idx(m_group->getIndexArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        rows.resize(n_local);
+        for (unsigned int j = 0; j < n_local; j++)
+            {
+            unsigned int idx = h_member_idx.data[j];
+            unsigned int tag = h_tag.data[idx];
+            unsigned int row = std::lower_bound(h_member_tags.data, h_member_tags.data + N, tag) - h_member_tags.data;
+            rows[j] = std::make_pair(row, idx);
+            }
+        }
+    std::sort(rows.begin(), rows.end());
+
+    unsigned int n = rows.size();
+    m_local_rows.resize(n);
+    for (unsigned int j = 0; j < n; j++)
+        m_local_rows[j] = rows[j].first;
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::read);
+
+    if (m_write_attribute || nframes == 0)
+        {
+        if (root)
+            {
+            std::vector<std::string> type_mapping;
+            for (unsigned int i = 0; i < m_pdata->getNTypes(); i++)
+                type_mapping.push_back(m_pdata->getNameByType(i));
+            writeTypeMapping("particles/types", type_mapping);
+            }
+
+            {
+            std::vector<uint32_t> type(n);
+            type.reserve(1); //! make sure we allocate
+            bool all_default = true;
+            for (unsigned int j = 0; j < n; j++)
+                {
+                type[j] = __scalar_as_int(h_pos.data[rows[j].second].w);
+                if (type[j] != 0)
+                    all_default = false;
+                }
+            writeChunkParallel("particles/typeid", GSD_TYPE_UINT32, 1, &type[0], all_default, nframes);
+            }
+
+            {
+            std::vector<float> data(n);
+            data.reserve(1); //! make sure we allocate
+            bool all_default = true;
+            for (unsigned int j = 0; j < n; j++)
+                {
+                data[j] = float(h_vel.data[rows[j].second].w);
+                if (data[j] != float(1.0))
+                    all_default = false;
+                }
+            writeChunkParallel("particles/mass", GSD_TYPE_FLOAT, 1, &data[0], all_default, nframes);
+
+            all_default = true;
+            for (unsigned int j = 0; j < n; j++)
+                {
+                data[j] = float(h_charge.data[rows[j].second]);
+                if (data[j] != float(0.0))
+                    all_default = false;
+                }
+            writeChunkParallel("particles/charge", GSD_TYPE_FLOAT, 1, &data[0], all_default, nframes);
+
+            all_default = true;
+            for (unsigned int j = 0; j < n; j++)
+                {
+                data[j] = float(h_diameter.data[rows[j].second]);
+                if (data[j] != float(1.0))
+                    all_default = false;
+                }
+            writeChunkParallel("particles/diameter", GSD_TYPE_FLOAT, 1, &data[0], all_default, nframes);
+            }
+
+            {
+            std::vector<int32_t> body(n);
+            body.reserve(1); //! make sure we allocate
+            bool all_default = true;
+            for (unsigned int j = 0; j < n; j++)
+                {
+                unsigned int b = h_body.data[rows[j].second];
+                if (b != NO_BODY)
+                    all_default = false;
+                body[j] = int32_t(b);
+                }
+            writeChunkParallel("particles/body", GSD_TYPE_INT32, 1, &body[0], all_default, nframes);
+            }
+
+            {
+            std::vector<float> data(n*3);
+            data.reserve(1); //! make sure we allocate
+            bool all_default = true;
+            for (unsigned int j = 0; j < n; j++)
+                {
+                Scalar3 I = h_inertia.data[rows[j].second];
+                if (I.x != Scalar(0.0) || I.y != Scalar(0.0) || I.z != Scalar(0.0))
+                    all_default = false;
+                data[j*3+0] = float(I.x);
+                data[j*3+1] = float(I.y);
+                data[j*3+2] = float(I.z);
+                }
+            writeChunkParallel("particles/moment_inertia", GSD_TYPE_FLOAT, 3, &data[0], all_default, nframes);
+            }
+        }
+
+    // positions and images are stored relative to the origin and wrapped into the global box, as in takeSnapshot()
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    Scalar3 origin = m_pdata->getOrigin();
+    int3 o_image = m_pdata->getOriginImage();
+
+    if (m_write_property || nframes == 0)
+        {
+            {
+            std::vector<float> data(n*3);
+            data.reserve(1); //! make sure we allocate
+            for (unsigned int j = 0; j < n; j++)
+                {
+                unsigned int idx = rows[j].second;
+                Scalar3 pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z) - origin;
+                int3 img = make_int3(0,0,0);
+                global_box.wrap(pos, img);
+                data[j*3+0] = float(pos.x);
+                data[j*3+1] = float(pos.y);
+                data[j*3+2] = float(pos.z);
+                }
+
+            // positions are always written
+            if (m_quantize_bits > 0)
+                {
+                std::vector<uint16_t> qdata(n*3);
+                qdata.reserve(1); //! make sure we allocate
+                for (unsigned int j = 0; j < n; j++)
+                    {
+                    Scalar3 f = global_box.makeFraction(make_scalar3(data[j*3+0], data[j*3+1], data[j*3+2]));
+                    qdata[j*3+0] = quantizeFraction(f.x);
+                    qdata[j*3+1] = quantizeFraction(f.y);
+                    qdata[j*3+2] = quantizeFraction(f.z);
+                    }
+
+                if (root)
+                    {
+                    uint8_t bits = m_quantize_bits;
+                    int retval = writeChunk("particles/position_quantized_bits", GSD_TYPE_UINT8, 1, 1, 0, (void *)&bits);
+                    checkError(retval);
+                    }
+                writeChunkParallel("particles/position_quantized", GSD_TYPE_UINT16, 3, &qdata[0], false, nframes);
+                }
+            else
+                {
+                writeChunkParallel("particles/position", GSD_TYPE_FLOAT, 3, &data[0], false, nframes);
+                }
+            }
+
+            {
+            std::vector<float> data(n*4);
+            data.reserve(1); //! make sure we allocate
+            bool all_default = true;
+            for (unsigned int j = 0; j < n; j++)
+                {
+                Scalar4 q = h_orientation.data[rows[j].second];
+                if (q.x != Scalar(1.0) || q.y != Scalar(0.0) || q.z != Scalar(0.0) || q.w != Scalar(0.0))
+                    all_default = false;
+                data[j*4+0] = float(q.x);
+                data[j*4+1] = float(q.y);
+                data[j*4+2] = float(q.z);
+                data[j*4+3] = float(q.w);
+                }
+            writeChunkParallel("particles/orientation", GSD_TYPE_FLOAT, 4, &data[0], all_default, nframes);
+            }
+        }
+
+    if (m_write_momentum || nframes == 0)
+        {
+            {
+            std::vector<float> data(n*3);
+            data.reserve(1); //! make sure we allocate
+            bool all_default = true;
+            for (unsigned int j = 0; j < n; j++)
+                {
+                Scalar4 v = h_vel.data[rows[j].second];
+                if (v.x != Scalar(0.0) || v.y != Scalar(0.0) || v.z != Scalar(0.0))
+                    all_default = false;
+                data[j*3+0] = float(v.x);
+                data[j*3+1] = float(v.y);
+                data[j*3+2] = float(v.z);
+                }
+            writeChunkParallel("particles/velocity", GSD_TYPE_FLOAT, 3, &data[0], all_default, nframes);
+            }
+
+            {
+            std::vector<float> data(n*4);
+            data.reserve(1); //! make sure we allocate
+            bool all_default = true;
+            for (unsigned int j = 0; j < n; j++)
+                {
+                Scalar4 a = h_angmom.data[rows[j].second];
+                if (a.x != Scalar(0.0) || a.y != Scalar(0.0) || a.z != Scalar(0.0) || a.w != Scalar(0.0))
+                    all_default = false;
+                data[j*4+0] = float(a.x);
+                data[j*4+1] = float(a.y);
+                data[j*4+2] = float(a.z);
+                data[j*4+3] = float(a.w);
+                }
+            writeChunkParallel("particles/angmom", GSD_TYPE_FLOAT, 4, &data[0], all_default, nframes);
+            }
+
+            {
+            std::vector<int32_t> data(n*3);
+            data.reserve(1); //! make sure we allocate
+            bool all_default = true;
+            for (unsigned int j = 0; j < n; j++)
+                {
+                unsigned int idx = rows[j].second;
+                Scalar3 pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z) - origin;
+                int3 img = h_image.data[idx];
+                img.x -= o_image.x;
+                img.y -= o_image.y;
+                img.z -= o_image.z;
+                global_box.wrap(pos, img);
+                if (img.x != 0 || img.y != 0 || img.z != 0)
+                    all_default = false;
+                data[j*3+0] = img.x;
+                data[j*3+1] = img.y;
+                data[j*3+2] = img.z;
+                }
+            writeChunkParallel("particles/image", GSD_TYPE_INT32, 3, &data[0], all_default, nframes);
+            }
+        }
+
+    // make the data of all ranks visible before the root rank writes the frame index
+    MPI_File_sync(m_mpi_file);
+    MPI_Barrier(m_exec_conf->getMPICommunicator());
+    MPI_File_sync(m_mpi_file);
+    }
+
+/*! \param name Name of the chunk
+    \param type Data type of the chunk
+    \param M Number of columns
+    \param data Local rows of the chunk, in the order of m_local_rows
+    \param all_default True if all local rows have the default value
+    \param nframes Number of frames in the file before this one
+
+    The chunk is skipped when all rows on all ranks have the default value and the quantity was default in frame 0,
+    like in the serial writer.
+*/
+void GSDDumpWriter::writeChunkParallel(const char *name,
+                                       gsd_type type,
+                                       uint32_t M,
+                                       const void *data,
+                                       bool all_default,
+                                       uint64_t nframes)
+    {
+    MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    bool root = m_exec_conf->isRoot();
+
+    // the default check must agree on all ranks, m_nondefault is only known on the root rank
+    int local_default = all_default ? 1 : 0;
+    int global_default = 1;
+    MPI_Allreduce(&local_default, &global_default, 1, MPI_INT, MPI_LAND, mpi_comm);
+    int write = !global_default;
+    if (root && nframes > 0 && m_nondefault[name])
+        write = 1;
+    MPI_Bcast(&write, 1, MPI_INT, 0, mpi_comm);
+    if (!write)
+        return;
+
+    // allocate the chunk in the file
+    uint64_t location = 0;
+    int retval = 0;
+    if (root)
+        {
+        m_exec_conf->msg->notice(10) << "dump.gsd: writing " << name << endl;
+        retval = reserveChunk(name, type, m_group->getNumMembersGlobal(), M, &location);
+        if (nframes == 0)
+            m_nondefault[name] = true;
+        }
+    bcast(retval, 0, mpi_comm);
+    bcast(location, 0, mpi_comm);
+    checkError(retval);
+
+    // extend the file to the end of the reserved extent, which has no data yet
+    int row_size = int(gsd_sizeof_type(type) * M);
+    MPI_Offset end = MPI_Offset(location) + MPI_Offset(row_size) * MPI_Offset(m_group->getNumMembersGlobal());
+    retval = MPI_File_set_size(m_mpi_file, end);
+    if (retval != MPI_SUCCESS)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Error extending " << m_fname << endl;
+        throw runtime_error("Error writing GSD file");
+        }
+
+    // select the local rows of the chunk with the file view
+    MPI_Datatype row_type, file_type;
+    MPI_Type_contiguous(row_size, MPI_BYTE, &row_type);
+    MPI_Type_commit(&row_type);
+
+    int n = (int)m_local_rows.size();
+    int dummy = 0;
+    MPI_Type_create_indexed_block(n, 1, n > 0 ? &m_local_rows[0] : &dummy, row_type, &file_type);
+    MPI_Type_commit(&file_type);
+
+    MPI_File_set_view(m_mpi_file, MPI_Offset(location), MPI_BYTE, file_type, (char *)"native", MPI_INFO_NULL);
+    MPI_Status status;
+    retval = MPI_File_write_all(m_mpi_file, (void *)data, n, row_type, &status);
+
+    MPI_Type_free(&file_type);
+    MPI_Type_free(&row_type);
+
+    if (retval != MPI_SUCCESS)
+        {
+        m_exec_conf->msg->error() << "dump.gsd: Error writing " << name << " to " << m_fname << endl;
+        throw runtime_error("Error writing GSD file");
+        }
+    }
+
+/*! \param name Name of the chunk
+    \param type Data type of the chunk
+    \param N Number of rows
+    \param M Number of columns
+    \param location Set to the file offset of the chunk data
+    \returns The gsd_write_chunk() return value
+
+    No data is written on the root rank. gsd_write_chunk() appends an empty chunk to get an index entry at the end of
+    the file, then the entry is given its N rows and the end of the file in the handle is moved past the extent, so the
+    next chunk and the frame index are placed after it. The ranks fill in the rows through MPI-IO.
+
+    \note This updates the index entry and file size that gsd_write_chunk() keeps in the handle. The file is opened in
+    append mode, where only the unwritten entries of the index are held in memory.
+*/
+int GSDDumpWriter::reserveChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, uint64_t *location)
+    {
+    *location = m_handle.file_size;
+
+    char empty = 0;
+    int retval = gsd_write_chunk(&m_handle, name, type, 0, M, 0, &empty);
+    if (retval != 0)
+        return retval;
+
+    size_t slot = m_handle.index_num_entries - 1;
+    if (m_handle.open_flags == GSD_OPEN_APPEND)
+        slot -= m_handle.index_written_entries;
+    m_handle.index[slot].N = N;
+    m_handle.file_size += gsd_sizeof_type(type) * N * M;
+    return 0;
+    }
+#endif
+
 /*! \param bond Bond data snapshot
     \param angle Angle data snapshot
     \param dihedral Dihedral data snapshot
@@ -735,68 +1700,68 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing bonds/N" << endl;
         uint32_t N = bond.size;
-        int retval = gsd_write_chunk(&m_handle, "bonds/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("bonds/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("bonds/types", bond.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing bonds/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "bonds/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&bond.type_id[0]);
+        retval = writeChunk("bonds/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&bond.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing bonds/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "bonds/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&bond.groups[0]);
+        retval = writeChunk("bonds/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&bond.groups[0]);
         checkError(retval);
         }
     if (angle.size > 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing angles/N" << endl;
         uint32_t N = angle.size;
-        int retval = gsd_write_chunk(&m_handle, "angles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("angles/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("angles/types", angle.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing angles/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "angles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&angle.type_id[0]);
+        retval = writeChunk("angles/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&angle.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing angles/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "angles/group", GSD_TYPE_UINT32, N, 3, 0, (void *)&angle.groups[0]);
+        retval = writeChunk("angles/group", GSD_TYPE_UINT32, N, 3, 0, (void *)&angle.groups[0]);
         checkError(retval);
         }
     if (dihedral.size > 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing dihedrals/N" << endl;
         uint32_t N = dihedral.size;
-        int retval = gsd_write_chunk(&m_handle, "dihedrals/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("dihedrals/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("dihedrals/types", dihedral.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing dihedrals/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "dihedrals/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&dihedral.type_id[0]);
+        retval = writeChunk("dihedrals/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&dihedral.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing dihedrals/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "dihedrals/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&dihedral.groups[0]);
+        retval = writeChunk("dihedrals/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&dihedral.groups[0]);
         checkError(retval);
         }
     if (improper.size > 0)
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing impropers/N" << endl;
         uint32_t N = improper.size;
-        int retval = gsd_write_chunk(&m_handle, "impropers/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("impropers/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("impropers/types", improper.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing impropers/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "impropers/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&improper.type_id[0]);
+        retval = writeChunk("impropers/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&improper.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing impropers/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "impropers/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&improper.groups[0]);
+        retval = writeChunk("impropers/group", GSD_TYPE_UINT32, N, 4, 0, (void *)&improper.groups[0]);
         checkError(retval);
         }
 
@@ -804,7 +1769,7 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing constraints/N" << endl;
         uint32_t N = constraint.size;
-        int retval = gsd_write_chunk(&m_handle, "constraints/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("constraints/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing constraints/value" << endl;
@@ -814,12 +1779,12 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
             for (unsigned int i = 0; i < N; i++)
                 data[i] = float(constraint.val[i]);
 
-            retval = gsd_write_chunk(&m_handle, "constraints/value", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
+            retval = writeChunk("constraints/value", GSD_TYPE_FLOAT, N, 1, 0, (void *)&data[0]);
             checkError(retval);
             }
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing constraints/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "constraints/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&constraint.groups[0]);
+        retval = writeChunk("constraints/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&constraint.groups[0]);
         checkError(retval);
         }
 
@@ -827,17 +1792,17 @@ void GSDDumpWriter::writeTopology(BondData::Snapshot& bond,
         {
         m_exec_conf->msg->notice(10) << "dump.gsd: writing pairs/N" << endl;
         uint32_t N = pair.size;
-        int retval = gsd_write_chunk(&m_handle, "pairs/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
+        int retval = writeChunk("pairs/N", GSD_TYPE_UINT32, 1, 1, 0, (void *)&N);
         checkError(retval);
 
         writeTypeMapping("pairs/types", pair.type_mapping);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing pairs/typeid" << endl;
-        retval = gsd_write_chunk(&m_handle, "pairs/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&pair.type_id[0]);
+        retval = writeChunk("pairs/typeid", GSD_TYPE_UINT32, N, 1, 0, (void *)&pair.type_id[0]);
         checkError(retval);
 
         m_exec_conf->msg->notice(10) << "dump.gsd: writing pairs/group" << endl;
-        retval = gsd_write_chunk(&m_handle, "pairs/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&pair.groups[0]);
+        retval = writeChunk("pairs/group", GSD_TYPE_UINT32, N, 2, 0, (void *)&pair.groups[0]);
         checkError(retval);
         }
     }
@@ -924,5 +1889,11 @@ void export_GSDDumpWriter(py::module& m)
         .def("setWriteProperty", &GSDDumpWriter::setWriteProperty)
         .def("setWriteMomentum", &GSDDumpWriter::setWriteMomentum)
         .def("setWriteTopology", &GSDDumpWriter::setWriteTopology)
+        .def("setAsync", &GSDDumpWriter::setAsync)
+        .def("setQuantizePositions", &GSDDumpWriter::setQuantizePositions)
+    .def("setDeltaEncoding", &GSDDumpWriter::setDeltaEncoding)
+        #ifdef ENABLE_MPI
+        .def("setParallelWrite", &GSDDumpWriter::setParallelWrite)
+        #endif
     ;
     }
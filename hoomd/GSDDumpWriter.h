@@ -11,8 +11,16 @@
 
 #include <string>
 #include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 #include "hoomd/extern/gsd.h"
 
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
 /*! \file GSDDumpWriter.h
     \brief Declares the GSDDumpWriter class
 */
@@ -31,6 +39,34 @@
     On the first call to analyze() \a fname is created with a dcd header. If it already
     exists, append to the file (unless the user specifies overwrite=True).
 
+    In asynchronous mode (setAsync()), the chunks of a frame are copied into a staging frame instead of being written
+    directly. The staging frame is handed to a writer thread on the root rank, which performs the gsd_write_chunk()
+    and gsd_end_frame() calls while the simulation continues. The simulation and the writer thread alternate between
+    two buffers: at most one frame is in flight, and analyze() blocks until the writer thread has finished the previous
+    frame before it touches the file handle again. Slots connected to the write signal are always called with an idle
+    writer, so they may write to the handle directly.
+
+    With setQuantizePositions(), positions are stored as fractional box coordinates quantized to the given number of
+    bits in the uint16 chunk particles/position_quantized (with the number of bits in
+    particles/position_quantized_bits) instead of particles/position. This lossy encoding halves the size of the
+    position data and is intended for analysis-only trajectories; the maximum error in each direction is
+    L/2^(bits+1). GSDReader decodes quantized positions, other GSD readers only see the new chunks.
+
+    With setDeltaEncoding(), only every keyframe_period-th frame (a keyframe) stores the full particles/position and
+    particles/orientation. The frames in between store the displacements from the positions of the last keyframe,
+    quantized to the given resolution in the int16 chunk particles/position_delta. The resolution is stored in
+    particles/position_delta_resolution and the frame index of the keyframe in particles/position_keyframe, so that
+    any frame can be decoded from itself and its keyframe. Orientations are stored as the difference to the
+    keyframe orientation in units of 2^-14 in particles/orientation_delta. A frame in which any particle has moved
+    too far to be encoded becomes a keyframe. The deltas are encoded in parallel chunks when running with multiple
+    TBB threads.
+
+    In MPI simulations, setParallelWrite() enables collective output of the per-particle chunks. Instead of gathering
+    a snapshot on the root rank, the root rank reserves space for each chunk in the file with reserveChunk() and
+    every rank writes the rows of its local group members directly at their offsets with MPI-IO. The memory needed on
+    the root rank is then independent of the system size (apart from the group's tag list), and each row is written
+    once, by the rank that owns it. Topology is still gathered on the root rank.
+
     \ingroup analyzers
 */
 class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
@@ -67,12 +103,32 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
             m_write_topology = b;
             }
 
+        //! Enable or disable asynchronous writes
+        void setAsync(bool async);
+
+        //! Store positions quantized to the given number of bits (0 to store full precision)
+        void setQuantizePositions(unsigned int bits);
+
+        //! Store positions and orientations as deltas from periodic keyframes (0 to store every frame in full)
+        void setDeltaEncoding(unsigned int keyframe_period, Scalar resolution);
+
+        #ifdef ENABLE_MPI
+        //! Enable or disable collective MPI-IO writes of the particle data
+        void setParallelWrite(bool parallel)
+            {
+            m_parallel = parallel;
+            }
+        #endif
+
         //! Destructor
         ~GSDDumpWriter();
 
         //! Write out the data for the current timestep
         void analyze(unsigned int timestep);
 
+        //! Wait until all frames have been written to the file
+        virtual void flush();
+
         hoomd::detail::SharedSignal<int (gsd_handle&)>& getWriteSignal() { return m_write_signal; }
 
     private:
@@ -91,6 +147,98 @@ class PYBIND11_EXPORT GSDDumpWriter : public Analyzer
 
         hoomd::detail::SharedSignal<int (gsd_handle&)> m_write_signal;
 
+        //! A data chunk staged for the writer thread
+        struct StagedChunk
+            {
+            std::string name;           //!< Chunk name
+            gsd_type type;              //!< Data type
+            uint64_t N;                 //!< Number of rows
+            uint32_t M;                 //!< Number of columns
+            uint8_t flags;              //!< Chunk flags
+            std::vector<char> data;     //!< Copy of the chunk data
+            };
+
+        unsigned int m_quantize_bits;             //!< Number of bits for quantized positions (0 for float)
+
+        //! Quantize a fractional coordinate to m_quantize_bits
+        uint16_t quantizeFraction(Scalar f) const
+            {
+            Scalar n_levels = Scalar(1 << m_quantize_bits);
+            int q = int(floor(f * n_levels));
+            if (q < 0)
+                q = 0;
+            if (q > int(n_levels) - 1)
+                q = int(n_levels) - 1;
+            return uint16_t(q);
+            }
+
+        unsigned int m_keyframe_period;           //!< Number of frames from one keyframe to the next (0 for no deltas)
+        Scalar m_delta_resolution;                //!< Resolution of the position deltas
+        bool m_has_keyframe;                      //!< True if a keyframe has been written
+        uint64_t m_keyframe;                      //!< Frame index of the last keyframe
+        std::vector<unsigned int> m_key_tags;     //!< Tags of the group members in the last keyframe
+        std::vector<float> m_key_pos;             //!< Positions written in the last keyframe
+        std::vector<float> m_key_orientation;     //!< Orientations written in the last keyframe (empty if not written)
+        bool m_delta_frame;                       //!< True if the current frame stores deltas
+
+        //! Check if the frame to be written can store deltas from the last keyframe
+        bool isDeltaFrame(uint64_t nframes) const;
+
+        //! Encode the positions as deltas from the keyframe, returns false if a displacement is too large
+        bool encodePositionDeltas(const std::vector<float>& pos, std::vector<int16_t>& delta) const;
+
+        //! Encode the orientations as differences to the keyframe
+        void encodeOrientationDeltas(const std::vector<float>& orientation, std::vector<int16_t>& delta) const;
+
+        bool m_async;                             //!< True if frames are written by the writer thread
+        std::vector<StagedChunk> m_staged;        //!< Chunks of the frame being assembled
+        std::vector<StagedChunk> m_pending;       //!< Chunks of the frame owned by the writer thread
+        bool m_pending_frame;                     //!< True while the writer thread has a frame to write
+        bool m_writer_exit;                       //!< Set to true to stop the writer thread
+        int m_writer_retval;                      //!< Error code of the last frame written by the writer thread
+        std::thread m_writer_thread;              //!< The writer thread
+        std::mutex m_writer_mutex;                //!< Protects the pending frame and the writer state
+        std::condition_variable m_writer_cv;      //!< Signals changes of the writer state
+
+        //! Write a data chunk, or stage it in asynchronous mode
+        int writeChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, uint8_t flags, const void *data);
+
+        //! Hand the staged frame to the writer thread
+        void submitFrame();
+
+        //! Block until the writer thread is idle and check for write errors
+        void waitForWriter();
+
+        //! Stop and join the writer thread
+        void stopWriter();
+
+        //! Main loop of the writer thread
+        void writerThread();
+
+        #ifdef ENABLE_MPI
+        bool m_parallel;                          //!< True if particle data is written collectively
+        bool m_mpi_file_open;                     //!< True if m_mpi_file is open
+        MPI_File m_mpi_file;                      //!< MPI-IO handle for collective writes
+        std::vector<int> m_local_rows;            //!< Chunk rows of the local group members, in increasing order
+
+        //! Write the per-particle chunks collectively from all ranks
+        void writeParticlesParallel(uint64_t nframes);
+
+        //! Reserve a per-particle chunk on the root rank and write the local rows collectively
+        void writeChunkParallel(const char *name,
+                                gsd_type type,
+                                uint32_t M,
+                                const void *data,
+                                bool all_default,
+                                uint64_t nframes);
+
+        //! Add the index entry of a chunk at the end of the file without writing its data
+        int reserveChunk(const char *name, gsd_type type, uint64_t N, uint32_t M, uint64_t *location);
+        #endif
+
+        //! Gather the group members into a snapshot on the root rank
+        std::map<unsigned int, unsigned int> takeGroupSnapshot(SnapshotParticleData<float>& snapshot);
+
         //! Write a type mapping out to the file
         void writeTypeMapping(std::string chunk, std::vector< std::string > type_mapping);
 
@@ -13,6 +13,7 @@
 #include "ExecutionConfiguration.h"
 #include "hoomd/extern/gsd.h"
 #include <string.h>
+#include <unistd.h>
 
 #include <stdexcept>
 using namespace std;
@@ -23,21 +24,27 @@ namespace py = pybind11;
     \param name File name to read
     \param frame Frame index to read from the file
     \param from_end Count frames back from the end of the file
+    \param distributed Read a part of the particles on every rank
 
-    The GSDReader constructor opens the GSD file, initializes an empty snapshot, and reads the file into
-    memory (on the root rank).
+    The GSDReader constructor opens the GSD file, indexes its chunks, and reads the given frame into a snapshot
+    (on the root rank, or on all ranks when \a distributed is set).
 */
 GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                      const std::string &name,
                      const uint64_t frame,
-                     bool from_end)
-    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame)
+                     bool from_end,
+                     bool distributed)
+    : m_exec_conf(exec_conf), m_timestep(0), m_name(name), m_frame(frame), m_distributed(false), m_is_open(false),
+      m_N(0), m_first_row(0)
     {
     m_snapshot = std::shared_ptr< SnapshotSystemData<float> >(new SnapshotSystemData<float>);
 
     #ifdef ENABLE_MPI
+    // distributed reads are only meaningful with more than one rank
+    m_distributed = distributed && m_exec_conf->getNRanks() > 1;
+
     // if we are not the root processor, do not perform file I/O
-    if (!m_exec_conf->isRoot())
+    if (!m_exec_conf->isRoot() && !m_distributed)
         {
         return;
         }
@@ -76,6 +83,7 @@ GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
         m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Unknown error opening: " << name << endl;
         throw runtime_error("Error opening GSD file");
         }
+    m_is_open = true;
 
     // validate schema
     if (string(m_handle.header.schema) != string("hoomd"))
@@ -89,34 +97,164 @@ GSDReader::GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
         throw runtime_error("Error opening GSD file");
         }
 
+    buildIndex();
+
     // set frame from the end of the file if requested
     uint64_t nframes = gsd_get_nframes(&m_handle);
     if (from_end && frame <= nframes)
         m_frame = nframes - frame;
 
+    readFrame(m_frame);
+    }
+
+GSDReader::~GSDReader()
+    {
+    if (m_is_open)
+        gsd_close(&m_handle);
+    }
+
+/*! \param frame Frame index to read from the file
+
+    The snapshot of the previously read frame is replaced by a new one, so that snapshots returned by getSnapshot()
+    before remain valid. Ranks that do not read the file get an empty snapshot.
+*/
+void GSDReader::readFrame(uint64_t frame)
+    {
+    m_frame = frame;
+    m_snapshot = std::shared_ptr< SnapshotSystemData<float> >(new SnapshotSystemData<float>);
+    m_timestep = 0;
+    m_N = 0;
+    m_first_row = 0;
+
+    if (!m_is_open)
+        return;
+
     // validate number of frames
-    if (m_frame >= nframes)
+    if (m_frame >= gsd_get_nframes(&m_handle))
         {
-        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Cannot read frame " << m_frame << " " << name << " only has " << gsd_get_nframes(&m_handle) << " frames" << endl;
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Cannot read frame " << m_frame << " " << m_name << " only has " << gsd_get_nframes(&m_handle) << " frames" << endl;
         throw runtime_error("Error opening GSD file");
         }
 
     readHeader();
     readParticles();
+
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->isRoot())
+        readTopology();
+    #else
     readTopology();
+    #endif
     }
 
-GSDReader::~GSDReader()
+/*! The index maps the name of every chunk to its id, and the frame and id of every chunk to its entry in the file
+    index. When a chunk is written more than once in a frame, the last entry is kept, as in gsd_find_chunk().
+*/
+void GSDReader::buildIndex()
     {
-    #ifdef ENABLE_MPI
-    // if we are not the root processor, do not perform file I/O
-    if (!m_exec_conf->isRoot())
+    m_name_ids.clear();
+    for (uint64_t i = 0; i < m_handle.namelist_num_entries; i++)
         {
-        return;
+        const char *name = m_handle.namelist[i].name;
+        size_t l = strnlen(name, sizeof(m_handle.namelist[i].name));
+        if (l == 0)
+            break;
+        m_name_ids[std::string(name, l)] = (uint16_t)i;
         }
-    #endif
 
-    gsd_close(&m_handle);
+    m_chunk_index.clear();
+    m_chunk_index.reserve(m_handle.index_num_entries);
+    for (uint64_t i = 0; i < m_handle.index_num_entries; i++)
+        {
+        const gsd_index_entry *entry = &m_handle.index[i];
+        if (entry->location == 0)
+            continue;
+        m_chunk_index[(entry->frame << 16) | entry->id] = entry;
+        }
+
+    m_exec_conf->msg->notice(7) << "data.gsd_snapshot: indexed " << m_chunk_index.size() << " chunks with "
+                                << m_name_ids.size() << " names" << endl;
+    }
+
+/*! \param frame Frame index
+    \param name Name of the data chunk
+
+    \returns The index entry of the chunk, or NULL if it is not present at the given frame
+*/
+const gsd_index_entry *GSDReader::findChunk(uint64_t frame, const char *name) const
+    {
+    std::unordered_map<std::string, uint16_t>::const_iterator id = m_name_ids.find(std::string(name));
+    if (id == m_name_ids.end())
+        return NULL;
+
+    std::unordered_map<uint64_t, const gsd_index_entry *>::const_iterator entry
+        = m_chunk_index.find((frame << 16) | id->second);
+    if (entry == m_chunk_index.end())
+        return NULL;
+    return entry->second;
+    }
+
+/*! \param data Pointer to data to read into
+    \param entry Index entry of the chunk
+    \param first_row First row to read
+    \param n_rows Number of rows to read
+
+    \returns 0 on success, -1 on a file IO failure, -2 on invalid input and -3 on an invalid index entry, like
+              gsd_read_chunk()
+
+    Copies the rows from the memory mapping of the file when it is mapped, and reads only these rows from the file
+    otherwise, so that many ranks can each read a part of a large chunk.
+*/
+int GSDReader::readEntry(void *data, const gsd_index_entry *entry, uint64_t first_row, uint64_t n_rows)
+    {
+    if (first_row + n_rows > entry->N)
+        return -2;
+    if (n_rows == 0)
+        return 0;
+
+    size_t row_size = entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+    if (row_size == 0 || entry->location == 0)
+        return -3;
+
+    // validate that we don't read past the end of the file
+    if (entry->location + int64_t(entry->N * row_size) > m_handle.file_size)
+        return -3;
+
+    size_t size = n_rows * row_size;
+    int64_t offset = entry->location + first_row * row_size;
+    if (m_handle.mapped_data != NULL)
+        {
+        memcpy(data, (const char *)m_handle.mapped_data + offset, size);
+        return 0;
+        }
+
+    ssize_t bytes_read = pread(m_handle.fd, data, size, offset);
+    if (bytes_read != ssize_t(size))
+        return -1;
+    return 0;
+    }
+
+/*! \param frame Frame index to read from
+    \param name Name of the data chunk
+    \param data C-contiguous writable array of exactly the size of the chunk
+
+    Reads the chunk with the fallback to frame 0 of readChunk(). The type of \a data is not checked, only its
+    size in bytes.
+
+    \returns true if the chunk was read, false if it is not in the file or this rank does not read the file
+*/
+bool GSDReader::readChunkArray(uint64_t frame, const std::string& name, pybind11::array data)
+    {
+    if (!m_is_open)
+        return false;
+
+    if (!(data.flags() & pybind11::array::c_style))
+        {
+        m_exec_conf->msg->error() << "data.gsd_reader: " << "The array to read " << name << " into must be C-contiguous" << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    return readChunk(data.mutable_data(), frame, name.c_str(), data.nbytes());
     }
 
 /*! \param data Pointer to data to read into
@@ -135,9 +273,9 @@ GSDReader::~GSDReader()
 */
 bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n)
     {
-    const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, frame, name);
+    const struct gsd_index_entry* entry = findChunk(frame, name);
     if (entry == NULL && frame != 0)
-        entry = gsd_find_chunk(&m_handle, 0, name);
+        entry = findChunk(0, name);
 
     if (entry == NULL || (cur_n != 0 && entry->N != cur_n))
         {
@@ -153,7 +291,7 @@ bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t e
             m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << expected_size << " bytes in " << name << " but found " << actual_size << endl;
             throw runtime_error("Error reading GSD file");
             }
-        int retval = gsd_read_chunk(&m_handle, data, entry);
+        int retval = readEntry(data, entry, 0, entry->N);
 
         if (retval == -1)
             {
@@ -180,6 +318,66 @@ bool GSDReader::readChunk(void *data, uint64_t frame, const char *name, size_t e
         }
     }
 
+/*! \param data Pointer to data to read into
+    \param frame Frame index to read from
+    \param name Name of the data chunk
+    \param row_size Expected size of one row of the data chunk in bytes.
+    \param cur_n N in the current frame.
+    \param first_row First row to read
+    \param n_rows Number of rows to read
+
+    Same as readChunk(), but reads only the given range of rows.
+
+    Return true if data is actually read from the file.
+*/
+bool GSDReader::readChunkRows(void *data,
+                              uint64_t frame,
+                              const char *name,
+                              size_t row_size,
+                              unsigned int cur_n,
+                              uint64_t first_row,
+                              uint64_t n_rows)
+    {
+    const struct gsd_index_entry* entry = findChunk(frame, name);
+    if (entry == NULL && frame != 0)
+        entry = findChunk(0, name);
+
+    if (entry == NULL || entry->N != cur_n)
+        {
+        m_exec_conf->msg->notice(10) << "data.gsd_snapshot: chunk not found " << name << endl;
+        return false;
+        }
+    else
+        {
+        m_exec_conf->msg->notice(7) << "data.gsd_snapshot: reading chunk " << name << endl;
+        size_t actual_size = entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
+        if (actual_size != row_size)
+            {
+            m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Expecting " << row_size << " bytes per row in " << name << " but found " << actual_size << endl;
+            throw runtime_error("Error reading GSD file");
+            }
+        int retval = readEntry(data, entry, first_row, n_rows);
+
+        if (retval == -1)
+            {
+            m_exec_conf->msg->error() << "data.gsd_snapshot: " << strerror(errno) << " - " << m_name << endl;
+            throw runtime_error("Error reading GSD file");
+            }
+        else if (retval == -3)
+            {
+            m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Invalid GSD file " << m_name << endl;
+            throw runtime_error("Error reading GSD file");
+            }
+        else if (retval != 0)
+            {
+            m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Unknown error reading: " << m_name << endl;
+            throw runtime_error("Error reading GSD file");
+            }
+
+        return true;
+        }
+    }
+
 /*! \param frame Frame index to read from
     \param name Name of the data chunk
 
@@ -198,9 +396,9 @@ std::vector<std::string> GSDReader::readTypes(uint64_t frame, const char *name)
     if (std::string(name) == "particles/types")
         type_mapping.push_back("A");
 
-    const struct gsd_index_entry* entry = gsd_find_chunk(&m_handle, frame, name);
+    const struct gsd_index_entry* entry = findChunk(frame, name);
     if (entry == NULL && frame != 0)
-        entry = gsd_find_chunk(&m_handle, 0, name);
+        entry = findChunk(0, name);
 
     if (entry == NULL)
         return type_mapping;
@@ -208,7 +406,7 @@ std::vector<std::string> GSDReader::readTypes(uint64_t frame, const char *name)
         {
         size_t actual_size = entry->N * entry->M * gsd_sizeof_type((enum gsd_type)entry->type);
         std::vector<char> data(actual_size);
-        int retval = gsd_read_chunk(&m_handle, &data[0], entry);
+        int retval = readEntry(&data[0], entry, 0, entry->N);
 
         if (retval == -1)
             {
@@ -264,29 +462,167 @@ void GSDReader::readHeader()
         m_exec_conf->msg->error() << "data.gsd_snapshot: " << "cannot read a file with 0 particles" << endl;
         throw runtime_error("Error reading GSD file");
         }
-    m_snapshot->particle_data.resize(N);
+    m_N = N;
+
+    // in distributed mode, every rank reads a contiguous range of particles
+    unsigned int n_read = N;
+    #ifdef ENABLE_MPI
+    if (m_distributed)
+        {
+        uint64_t rank = m_exec_conf->getRank();
+        uint64_t n_ranks = m_exec_conf->getNRanks();
+        m_first_row = rank * N / n_ranks;
+        n_read = (unsigned int)((rank + 1) * N / n_ranks - m_first_row);
+        m_snapshot->particle_data.is_distributed = true;
+        m_snapshot->particle_data.tag_offset = (unsigned int)m_first_row;
+        }
+    #endif
+    m_snapshot->particle_data.resize(n_read);
     }
 
 /*! Read the same data chunks for particles
 */
 void GSDReader::readParticles()
     {
-    unsigned int N = m_snapshot->particle_data.size;
+    unsigned int n = m_snapshot->particle_data.size;
     m_snapshot->particle_data.type_mapping = readTypes(m_frame, "particles/types");
 
     // the snapshot already has default values, if a chunk is not found, the value
     // is already at the default, and the failed read is not a problem
-    readChunk(&m_snapshot->particle_data.type[0], m_frame, "particles/typeid", N*4, N);
-    readChunk(&m_snapshot->particle_data.mass[0], m_frame, "particles/mass", N*4, N);
-    readChunk(&m_snapshot->particle_data.charge[0], m_frame, "particles/charge", N*4, N);
-    readChunk(&m_snapshot->particle_data.diameter[0], m_frame, "particles/diameter", N*4, N);
-    readChunk(&m_snapshot->particle_data.body[0], m_frame, "particles/body", N*4, N);
-    readChunk(&m_snapshot->particle_data.inertia[0], m_frame, "particles/moment_inertia", N*12, N);
-    readChunk(&m_snapshot->particle_data.pos[0], m_frame, "particles/position", N*12, N);
-    readChunk(&m_snapshot->particle_data.orientation[0], m_frame, "particles/orientation", N*16, N);
-    readChunk(&m_snapshot->particle_data.vel[0], m_frame, "particles/velocity", N*12, N);
-    readChunk(&m_snapshot->particle_data.angmom[0], m_frame, "particles/angmom", N*16, N);
-    readChunk(&m_snapshot->particle_data.image[0], m_frame, "particles/image", N*12, N);
+    SnapshotParticleData<float>& p = m_snapshot->particle_data;
+    readChunkRows(p.type.data(), m_frame, "particles/typeid", 4, m_N, m_first_row, n);
+    readChunkRows(p.mass.data(), m_frame, "particles/mass", 4, m_N, m_first_row, n);
+    readChunkRows(p.charge.data(), m_frame, "particles/charge", 4, m_N, m_first_row, n);
+    readChunkRows(p.diameter.data(), m_frame, "particles/diameter", 4, m_N, m_first_row, n);
+    readChunkRows(p.body.data(), m_frame, "particles/body", 4, m_N, m_first_row, n);
+    readChunkRows(p.inertia.data(), m_frame, "particles/moment_inertia", 12, m_N, m_first_row, n);
+    if (!readPositionDeltas() && !readChunkRows(p.pos.data(), m_frame, "particles/position", 12, m_N, m_first_row, n))
+        readQuantizedPositions();
+    if (!readOrientationDeltas())
+        readChunkRows(p.orientation.data(), m_frame, "particles/orientation", 16, m_N, m_first_row, n);
+    readChunkRows(p.vel.data(), m_frame, "particles/velocity", 12, m_N, m_first_row, n);
+    readChunkRows(p.angmom.data(), m_frame, "particles/angmom", 16, m_N, m_first_row, n);
+    readChunkRows(p.image.data(), m_frame, "particles/image", 12, m_N, m_first_row, n);
+    }
+
+/*! Decode the positions written by GSDDumpWriter::setQuantizePositions() from fractional box coordinates
+*/
+void GSDReader::readQuantizedPositions()
+    {
+    uint8_t bits = 0;
+    if (!readChunk(&bits, m_frame, "particles/position_quantized_bits", 1) || bits == 0 || bits > 16)
+        return;
+
+    unsigned int n = m_snapshot->particle_data.size;
+    std::vector<uint16_t> qdata(n*3);
+    if (!readChunkRows(qdata.data(), m_frame, "particles/position_quantized", 6, m_N, m_first_row, n))
+        return;
+
+    // decode to the center of each quantization bin
+    const BoxDim& box = m_snapshot->global_box;
+    Scalar n_levels = Scalar(1 << bits);
+    for (unsigned int i = 0; i < n; i++)
+        {
+        Scalar3 f = make_scalar3((Scalar(qdata[i*3+0]) + Scalar(0.5)) / n_levels,
+                                 (Scalar(qdata[i*3+1]) + Scalar(0.5)) / n_levels,
+                                 (Scalar(qdata[i*3+2]) + Scalar(0.5)) / n_levels);
+        Scalar3 pos = box.makeCoordinates(f);
+        if (m_snapshot->dimensions == 2)
+            pos.z = Scalar(0.0);
+        m_snapshot->particle_data.pos[i] = vec3<float>(pos);
+        }
+    }
+
+/*! Decode the positions written by GSDDumpWriter::setDeltaEncoding() from the keyframe positions and the deltas
+    \returns false if the frame does not store position deltas
+*/
+bool GSDReader::readPositionDeltas()
+    {
+    if (findChunk(m_frame, "particles/position_delta") == NULL)
+        return false;
+
+    uint64_t keyframe = 0;
+    float resolution = 0.0f;
+    if (!readChunk(&keyframe, m_frame, "particles/position_keyframe", 8) ||
+        !readChunk(&resolution, m_frame, "particles/position_delta_resolution", 4) ||
+        keyframe >= m_frame)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Invalid keyframe for the position deltas in frame "
+            << m_frame << " of " << m_name << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    unsigned int n = m_snapshot->particle_data.size;
+    SnapshotParticleData<float>& p = m_snapshot->particle_data;
+    std::vector<int16_t> ddata(n*3);
+    if (!readChunkRows(p.pos.data(), keyframe, "particles/position", 12, m_N, m_first_row, n) ||
+        !readChunkRows(ddata.data(), m_frame, "particles/position_delta", 6, m_N, m_first_row, n))
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Missing keyframe positions for frame "
+            << m_frame << " of " << m_name << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    // add the displacements and wrap the particles that have crossed a boundary back into the box
+    const BoxDim& box = m_snapshot->global_box;
+    for (unsigned int i = 0; i < n; i++)
+        {
+        Scalar3 pos = make_scalar3(Scalar(p.pos[i].x) + Scalar(resolution)*Scalar(ddata[i*3+0]),
+                                   Scalar(p.pos[i].y) + Scalar(resolution)*Scalar(ddata[i*3+1]),
+                                   Scalar(p.pos[i].z) + Scalar(resolution)*Scalar(ddata[i*3+2]));
+        int3 img = make_int3(0,0,0);
+        box.wrap(pos, img);
+        if (m_snapshot->dimensions == 2)
+            pos.z = Scalar(0.0);
+        p.pos[i] = vec3<float>(pos);
+        }
+
+    return true;
+    }
+
+/*! Decode the orientations written by GSDDumpWriter::setDeltaEncoding() from the keyframe orientations and the
+    differences
+    \returns false if the frame does not store orientation deltas
+*/
+bool GSDReader::readOrientationDeltas()
+    {
+    if (findChunk(m_frame, "particles/orientation_delta") == NULL)
+        return false;
+
+    uint64_t keyframe = 0;
+    if (!readChunk(&keyframe, m_frame, "particles/position_keyframe", 8) || keyframe >= m_frame)
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Invalid keyframe for the orientation deltas in frame "
+            << m_frame << " of " << m_name << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    unsigned int n = m_snapshot->particle_data.size;
+    SnapshotParticleData<float>& p = m_snapshot->particle_data;
+    std::vector<int16_t> ddata(n*4);
+    if (!readChunkRows(p.orientation.data(), keyframe, "particles/orientation", 16, m_N, m_first_row, n) ||
+        !readChunkRows(ddata.data(), m_frame, "particles/orientation_delta", 8, m_N, m_first_row, n))
+        {
+        m_exec_conf->msg->error() << "data.gsd_snapshot: " << "Missing keyframe orientations for frame "
+            << m_frame << " of " << m_name << endl;
+        throw runtime_error("Error reading GSD file");
+        }
+
+    // the differences are stored in units of 2^-14, renormalize the sum
+    const float resolution = 1.0f/16384.0f;
+    for (unsigned int i = 0; i < n; i++)
+        {
+        quat<float> q(p.orientation[i].s + resolution*ddata[i*4+0],
+                      vec3<float>(p.orientation[i].v.x + resolution*ddata[i*4+1],
+                                  p.orientation[i].v.y + resolution*ddata[i*4+2],
+                                  p.orientation[i].v.z + resolution*ddata[i*4+3]));
+        float norm = sqrtf(norm2(q));
+        if (norm > 0.0f)
+            q = q * (1.0f/norm);
+        p.orientation[i] = q;
+        }
+
+    return true;
     }
 
 /*! Read the same data chunks for topology
@@ -364,8 +700,14 @@ void export_GSDReader(py::module& m)
     {
     py::class_< GSDReader, std::shared_ptr<GSDReader> >(m,"GSDReader")
     .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool>())
+    .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, const uint64_t, bool, bool>())
     .def("getTimeStep", &GSDReader::getTimeStep)
     .def("getSnapshot", &GSDReader::getSnapshot)
     .def("clearSnapshot", &GSDReader::clearSnapshot)
+    .def("getFrame", &GSDReader::getFrame)
+    .def("getNFrames", &GSDReader::getNFrames)
+    .def("readFrame", &GSDReader::readFrame)
+    .def("hasChunk", &GSDReader::hasChunk)
+    .def("readChunkArray", &GSDReader::readChunkArray)
     ;
     }
@@ -14,7 +14,9 @@
 
 #include "ParticleData.h"
 #include <string>
+#include <unordered_map>
 #include "hoomd/extern/gsd.h"
+#include <hoomd/extern/pybind/include/pybind11/numpy.h>
 
 #ifdef NVCC
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
@@ -30,6 +32,18 @@ template <class Real> struct SnapshotSystemData;
 /*! Read an input GSD file and generate a system snapshot. GSDReader can read any frame from a GSD
     file into the snapshot. For information on the GSD specification, see http://gsd.readthedocs.io/
 
+    By default, only the root rank reads the file and the snapshot is distributed to the domains when the system is
+    initialized. When \a distributed is true in an MPI simulation, every rank opens the file and reads a contiguous
+    range of particles (rank r of P reads tags r*N/P to (r+1)*N/P-1) into a distributed snapshot
+    (SnapshotParticleData::is_distributed). ParticleData then exchanges the particles between the ranks directly,
+    so that no rank needs to hold the whole system. Topology is still read on the root rank.
+
+    The reader keeps the file open and builds a hash index of the chunks by frame and name when it is opened, so that
+    every chunk lookup takes constant time instead of a binary search and a linear scan of the frame. readFrame()
+    reads another frame into a new snapshot and readChunkArray() reads a single chunk into a preallocated array,
+    without reopening the file. When the file is memory mapped (read-only mode on POSIX systems), the chunks are
+    copied directly from the mapping.
+
     \ingroup data_structs
 */
 class PYBIND11_EXPORT GSDReader
@@ -39,7 +53,8 @@ class PYBIND11_EXPORT GSDReader
         GSDReader(std::shared_ptr<const ExecutionConfiguration> exec_conf,
                   const std::string &name,
                   const uint64_t frame,
-                  bool from_end);
+                  bool from_end,
+                  bool distributed=false);
 
         //! Destructor
         ~GSDReader();
@@ -70,9 +85,36 @@ class PYBIND11_EXPORT GSDReader
             return m_frame;
             }
 
+        //! Get the number of frames in the file
+        uint64_t getNFrames() const
+            {
+            return m_is_open ? gsd_get_nframes(const_cast<gsd_handle *>(&m_handle)) : 0;
+            }
+
+        //! Read a frame into a new snapshot
+        void readFrame(uint64_t frame);
+
+        //! Test if a chunk is present in the file at the given frame
+        bool hasChunk(uint64_t frame, const std::string& name) const
+            {
+            return findChunk(frame, name.c_str()) != NULL;
+            }
+
+        //! Read a chunk into a preallocated array
+        bool readChunkArray(uint64_t frame, const std::string& name, pybind11::array data);
+
         //! Helper function to read a quantity from the file
         bool readChunk(void *data, uint64_t frame, const char *name, size_t expected_size, unsigned int cur_n=0);
 
+        //! Helper function to read a range of rows of a per-particle quantity from the file
+        bool readChunkRows(void *data,
+                           uint64_t frame,
+                           const char *name,
+                           size_t row_size,
+                           unsigned int cur_n,
+                           uint64_t first_row,
+                           uint64_t n_rows);
+
         //! clears the snapshot object
         void clearSnapshot()
             {
@@ -86,6 +128,22 @@ class PYBIND11_EXPORT GSDReader
         uint64_t m_frame;                                            //!< Cached frame
         std::shared_ptr< SnapshotSystemData<float> > m_snapshot;   //!< The snapshot to read
         gsd_handle m_handle;                                         //!< Handle to the file
+        bool m_distributed;                                          //!< True if all ranks read a part of the file
+        bool m_is_open;                                              //!< True if this rank opened the file
+        unsigned int m_N;                                            //!< Global number of particles in the frame
+        uint64_t m_first_row;                                        //!< First particle read by this rank
+
+        std::unordered_map<std::string, uint16_t> m_name_ids;       //!< Chunk id of each name in the file
+        std::unordered_map<uint64_t, const gsd_index_entry *> m_chunk_index; //!< Index entry of each (frame, id)
+
+        //! Build the hash index of the chunks in the file
+        void buildIndex();
+
+        //! Find the index entry of a chunk
+        const gsd_index_entry *findChunk(uint64_t frame, const char *name) const;
+
+        //! Read a range of rows of an index entry
+        int readEntry(void *data, const gsd_index_entry *entry, uint64_t first_row, uint64_t n_rows);
 
         //! Helper function to read a type list from the file
         std::vector<std::string> readTypes(uint64_t frame, const char *name);
@@ -93,6 +151,9 @@ class PYBIND11_EXPORT GSDReader
         // helper functions to read sections of the file
         void readHeader();
         void readParticles();
+        void readQuantizedPositions();
+        bool readPositionDeltas();
+        bool readOrientationDeltas();
         void readTopology();
     };
 
@@ -4,8 +4,11 @@
 #include "ParticleData.h"
 #include "GetarDumpWriter.h"
 #include "GetarDumpIterators.h"
+#include "ParticleFrameGather.h"
 
+#include <cerrno>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 
 namespace py = pybind11;
@@ -51,6 +54,28 @@ namespace getardump{
         return x*y/gcd<T>(x, y);
         }
 
+// marks a period that needs frame data, on top of the ParticleFrameGather flags
+    const unsigned int frameNeeded(1u << 31);
+
+// return true if a description is written from the gathered
+// single precision frame data instead of a particle data snapshot
+    bool usesFrame(const GetarDumpDescription &desc)
+        {
+        return desc.m_behavior == Discrete && desc.m_res == Individual &&
+            ((desc.m_prop == Position && !desc.m_highPrecision) || desc.m_prop == Image);
+        }
+
+// frame data needed by a description
+    unsigned int frameFlags(const GetarDumpDescription &desc)
+        {
+        if(!usesFrame(desc))
+            return 0;
+        else if(desc.m_prop == Image)
+            return frameNeeded | ParticleFrameGather::frame_image;
+        else
+            return frameNeeded;
+        }
+
 // return true if a prop needs particle data snapshots
     bool needSnapshot(NeedSnapshotIdx idx, Property prop)
         {
@@ -301,7 +326,10 @@ namespace getardump{
         const std::string &filename, GetarDumpMode operationMode, unsigned int offset):
         Analyzer(sysdef), m_archive(), m_periods(), m_offset(offset),
         m_staticRecords(), m_operationMode(operationMode), m_filename(filename),
-        m_tempName(), m_systemSnap(), m_neededSnapshots()
+        m_tempName(), m_systemSnap(), m_neededSnapshots(), m_neededFrames(),
+        m_frame(sysdef->getParticleData()), m_frameGathered(false),
+        m_async(false), m_queueDepth(1), m_queue(), m_writing(false),
+        m_writerExit(false), m_writerError()
         {
         if(m_operationMode == getardump::OneShot)
             {
@@ -331,14 +359,163 @@ namespace getardump{
         }
 
     GetarDumpWriter::~GetarDumpWriter()
-        {}
+        {
+        stopWriter();
+        }
 
     void GetarDumpWriter::close()
         {
+        waitForWriter();
+        stopWriter();
         if(m_archive)
             m_archive->close();
         }
 
+    void GetarDumpWriter::setAsync(bool async, unsigned int queueDepth)
+        {
+        if(m_async && !async)
+            {
+            waitForWriter();
+            stopWriter();
+            }
+
+        m_async = async;
+        m_queueDepth = max(queueDepth, (unsigned int) 1);
+        }
+
+    void GetarDumpWriter::submitFrame(vector<StagedRecord> &records)
+        {
+        // the writer thread is started on the first frame
+        if(!m_writerThread.joinable())
+            {
+            m_writerExit = false;
+            m_writerThread = std::thread(&GetarDumpWriter::writerThread, this);
+            }
+
+            {
+            std::unique_lock<std::mutex> lock(m_writerMutex);
+            m_writerCv.wait(lock, [this] { return m_queue.size() < m_queueDepth || !m_writerError.empty(); });
+            if(m_writerError.empty())
+                {
+                m_queue.push_back(vector<StagedRecord>());
+                m_queue.back().swap(records);
+                }
+            }
+        m_writerCv.notify_all();
+
+        checkWriterError();
+        }
+
+    void GetarDumpWriter::waitForWriter()
+        {
+            {
+            std::unique_lock<std::mutex> lock(m_writerMutex);
+            m_writerCv.wait(lock, [this] { return (m_queue.empty() && !m_writing) || !m_writerError.empty(); });
+            }
+        checkWriterError();
+        }
+
+    void GetarDumpWriter::checkWriterError()
+        {
+        string error;
+            {
+            std::lock_guard<std::mutex> lock(m_writerMutex);
+            error.swap(m_writerError);
+            }
+
+        if(!error.empty())
+            {
+            m_exec_conf->msg->error() << "dump.getar: " << error << endl;
+            throw runtime_error("Error writing getar file");
+            }
+        }
+
+    void GetarDumpWriter::stopWriter()
+        {
+        if(!m_writerThread.joinable())
+            return;
+
+            {
+            std::lock_guard<std::mutex> lock(m_writerMutex);
+            m_writerExit = true;
+            }
+        m_writerCv.notify_all();
+        m_writerThread.join();
+        }
+
+    /// The writer thread writes the queued frames in order. The loop
+    /// exits when m_writerExit is set and the queue is empty. After an
+    /// error, the queued frames are discarded.
+    void GetarDumpWriter::writerThread()
+        {
+        std::unique_lock<std::mutex> lock(m_writerMutex);
+        while(true)
+            {
+            m_writerCv.wait(lock, [this] { return !m_queue.empty() || m_writerExit; });
+
+            if(m_queue.empty())
+                break;
+
+            vector<StagedRecord> records;
+            records.swap(m_queue.front());
+            m_queue.pop_front();
+            m_writing = true;
+            m_writerCv.notify_all();
+
+            // compress and write without holding the lock
+            lock.unlock();
+            string error;
+            try
+                {
+                writeStaged(records);
+                }
+            catch(std::exception &e)
+                {
+                error = e.what();
+                }
+            records.clear();
+            lock.lock();
+
+            m_writing = false;
+            if(!error.empty())
+                {
+                m_writerError = error;
+                m_queue.clear();
+                }
+            m_writerCv.notify_all();
+            }
+        }
+
+    void GetarDumpWriter::writeStaged(const vector<StagedRecord> &records)
+        {
+        if(m_operationMode == OneShot)
+            {
+                {
+                GTAR archive(m_tempName, gtar::Write);
+                GTAR::BulkWriter writer(archive);
+                for(vector<StagedRecord>::const_iterator iter(records.begin());
+                    iter != records.end(); ++iter)
+                    writer.writePtr(iter->path, iter->data.data(), iter->data.size(), iter->compression);
+                }
+
+            int result(rename(m_tempName.c_str(), m_filename.c_str()));
+
+            if(result)
+                {
+                stringstream msg;
+                msg << "Error " << result << " in one-shot file: " << strerror(errno);
+                throw runtime_error(msg.str());
+                }
+            }
+        else if(m_archive)
+            {
+            GTAR::BulkWriter writer(*m_archive);
+            for(vector<StagedRecord>::const_iterator iter(records.begin());
+                iter != records.end(); ++iter)
+                writer.writePtr(iter->path, iter->data.data(), iter->data.size(), iter->compression);
+            }
+        }
+
     void GetarDumpWriter::analyze(unsigned int timestep)
         {
         const unsigned int shiftedTimestep(timestep - m_offset);
@@ -356,6 +533,20 @@ namespace getardump{
                 }
             }
 
+        unsigned int neededFrame(0);
+        for(NeedFrameMap::iterator pIter(m_neededFrames.begin());
+            pIter != m_neededFrames.end(); ++pIter)
+            {
+            if(!(shiftedTimestep%pIter->first))
+                neededFrame |= pIter->second;
+            }
+
+        // positions and images are taken from the particle data
+        // snapshot when one is needed for other properties anyway
+        m_frameGathered = neededFrame && !neededSnapshots[NeedPData];
+        if(m_frameGathered)
+            m_frame.gather(neededFrame & ~frameNeeded);
+
         if(neededSnapshots[NeedSystem])
             m_systemSnap = takeSystemSnapshot(m_sysdef,
                 neededSnapshots[NeedPData], neededSnapshots[NeedBond],
@@ -369,7 +560,41 @@ namespace getardump{
             return;
 #endif
 
-        if(m_operationMode == OneShot)
+        if(m_async)
+            {
+            for(PeriodMap::iterator pIter(m_periods.begin());
+                pIter != m_periods.end(); ++pIter)
+                if(!(shiftedTimestep%pIter->first))
+                    ranThisStep = true;
+
+            if(!ranThisStep)
+                return;
+
+            // serialize the frame here, the writer thread only compresses and writes it
+            vector<StagedRecord> records;
+            StagedWriter writer(records);
+
+            for(PeriodMap::iterator pIter(m_periods.begin());
+                pIter != m_periods.end(); ++pIter)
+                {
+                if(!(shiftedTimestep%pIter->first))
+                    {
+                    for(vector<GetarDumpDescription>::iterator dIter(pIter->second.begin());
+                        dIter != pIter->second.end(); ++dIter)
+                        write(writer, *dIter, timestep);
+                    }
+                }
+
+            if(m_operationMode == OneShot)
+                {
+                for(vector<GetarDumpDescription>::const_iterator iter(m_staticRecords.begin());
+                    iter != m_staticRecords.end(); ++iter)
+                    write(writer, *iter, 0);
+                }
+
+            submitFrame(records);
+            }
+        else if(m_operationMode == OneShot)
             {
             for(PeriodMap::iterator pIter(m_periods.begin());
                 pIter != m_periods.end(); ++pIter)
@@ -442,11 +667,9 @@ namespace getardump{
             }
         }
 
-    void GetarDumpWriter::write(GTAR::BulkWriter &writer, const GetarDumpDescription &desc, unsigned int timestep)
+    template<typename Writer>
+    void GetarDumpWriter::write(Writer &writer, const GetarDumpDescription &desc, unsigned int timestep)
         {
-        if(!m_archive)
-            return;
-
         if(desc.m_res == Individual)
             writeIndividual(writer, desc, timestep);
         else if(desc.m_res == Text)
@@ -455,7 +678,8 @@ namespace getardump{
             writeUniform(writer, desc, timestep);
         }
 
-    void GetarDumpWriter::writeIndividual(GTAR::BulkWriter &writer, const GetarDumpDescription &desc, unsigned int timestep)
+    template<typename Writer>
+    void GetarDumpWriter::writeIndividual(Writer &writer, const GetarDumpDescription &desc, unsigned int timestep)
         {
         if(desc.m_prop == AngularMomentum)
             {
@@ -543,6 +767,14 @@ namespace getardump{
             writer.writeIndividual<vector<unsigned int>::iterator, uint32_t>(
                 desc.getFormattedPath(timestep), begin, end, desc.m_compression);
             }
+        else if(desc.m_prop == Image && m_frameGathered && usesFrame(desc))
+            {
+            typedef Int3xyzIterator<vector<int3>::const_iterator> iter_t;
+            iter_t begin(m_frame.getImages().begin());
+            iter_t end(m_frame.getImages().end());
+            writer.writeIndividual<iter_t, int32_t>(
+                desc.getFormattedPath(timestep), begin, end, desc.m_compression);
+            }
         else if(desc.m_prop == Image)
             {
             typedef Int3xyzIterator<vector<int3>::iterator> iter_t;
@@ -623,6 +855,14 @@ namespace getardump{
                     desc.getFormattedPath(timestep), begin, end, desc.m_compression);
                 }
             }
+        else if(desc.m_prop == Position && m_frameGathered && usesFrame(desc))
+            {
+            typedef Scalar3xyzIterator<float, vector<float3>::const_iterator> iter_t;
+            iter_t begin(m_frame.getPositions().begin());
+            iter_t end(m_frame.getPositions().end());
+            writer.writeIndividual<iter_t, float>(
+                desc.getFormattedPath(timestep), begin, end, desc.m_compression);
+            }
         else if(desc.m_prop == Position)
             {
             if(desc.m_highPrecision == false)
@@ -726,7 +966,8 @@ namespace getardump{
             }
         }
 
-    void GetarDumpWriter::writeUniform(GTAR::BulkWriter &writer, const GetarDumpDescription &desc, unsigned int timestep)
+    template<typename Writer>
+    void GetarDumpWriter::writeUniform(Writer &writer, const GetarDumpDescription &desc, unsigned int timestep)
         {
         if(desc.m_prop == Box)
             {
@@ -763,7 +1004,8 @@ namespace getardump{
             }
         }
 
-    void GetarDumpWriter::writeText(GTAR::BulkWriter &writer, const GetarDumpDescription &desc, unsigned int timestep)
+    template<typename Writer>
+    void GetarDumpWriter::writeText(Writer &writer, const GetarDumpDescription &desc, unsigned int timestep)
         {
         if(desc.m_prop == TypeNames)
             {
@@ -832,6 +1074,8 @@ namespace getardump{
             m_staticRecords.push_back(desc);
             if(m_archive)
                 {
+                // the archive may only be touched while the writer thread is idle
+                waitForWriter();
                 GTAR::BulkWriter writer(*m_archive);
                 write(writer, desc, 0);
                 }
@@ -842,7 +1086,8 @@ namespace getardump{
             if(m_periods.find(period) != m_periods.end())
                 {
                 m_periods[period].push_back(desc);
-                for(unsigned int i(1); i < 9; ++i)
+                m_neededFrames[period] |= frameFlags(desc);
+                for(unsigned int i(1); i < 9 && !usesFrame(desc); ++i)
                     {
                     m_neededSnapshots[period][i] |= needSnapshot((NeedSnapshotIdx) i, prop);
                     m_neededSnapshots[period][0] |= m_neededSnapshots[period][i];
@@ -852,7 +1097,8 @@ namespace getardump{
                 {
                 m_periods[period] = vector<GetarDumpDescription>(1, desc);
                 m_neededSnapshots[period] = NeedSnapshots();
-                for(unsigned int i(1); i < 9; ++i)
+                m_neededFrames[period] = frameFlags(desc);
+                for(unsigned int i(1); i < 9 && !usesFrame(desc); ++i)
                     {
                     m_neededSnapshots[period][i] = needSnapshot((NeedSnapshotIdx) i, prop);
                     m_neededSnapshots[period][0] |= m_neededSnapshots[period][i];
@@ -896,7 +1142,10 @@ namespace getardump{
         // only write on root rank
         if (m_exec_conf->isRoot())
 #endif
-        m_archive->writeString(rec.getPath(), contents, gtar::FastCompress);
+            {
+            waitForWriter();
+            m_archive->writeString(rec.getPath(), contents, gtar::FastCompress);
+            }
         }
 
     void export_GetarDumpWriter(py::module& m)
@@ -904,6 +1153,7 @@ namespace getardump{
         py::class_<GetarDumpWriter, std::shared_ptr<GetarDumpWriter> >(m,"GetarDumpWriter", py::base<Analyzer>())
             .def(py::init< std::shared_ptr<SystemDefinition>, std::string, getardump::GetarDumpMode, unsigned int>())
             .def("close", &GetarDumpWriter::close)
+            .def("setAsync", &GetarDumpWriter::setAsync)
             .def("getPeriod", &GetarDumpWriter::getPeriod)
             .def("setPeriod", &GetarDumpWriter::setPeriod)
             .def("removeDump", &GetarDumpWriter::removeDump)
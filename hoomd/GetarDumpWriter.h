@@ -6,13 +6,19 @@
 
 #include "hoomd/Analyzer.h"
 #include "hoomd/SnapshotSystemData.h"
+#include "hoomd/ParticleFrameGather.h"
 #include "hoomd/extern/libgetar/src/GTAR.hpp"
 #include "hoomd/extern/libgetar/src/Record.hpp"
 #include "hoomd/GetarDumpIterators.h"
 #include <memory>
 
+#include <condition_variable>
+#include <cstring>
+#include <deque>
 #include <map>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <vector>
 
 #ifndef NVCC
@@ -210,12 +216,90 @@ namespace getardump{
             std::string m_suffix;
         };
 
+    /// A record serialized for the writer thread
+    struct StagedRecord
+        {
+        /// Path within the archive
+        std::string path;
+        /// Serialized contents of the record
+        std::vector<char> data;
+        /// Compression which should be used when writing
+        gtar::CompressMode compression;
+        };
+
+    /// Stand-in for gtar::GTAR::BulkWriter which serializes records
+    /// into a list instead of compressing and writing them. The bytes
+    /// of each record are the same as libgetar would write, so the
+    /// records can be replayed with BulkWriter::writePtr later.
+    class StagedWriter
+        {
+        public:
+            /// Constructor
+            ///
+            /// :param records: List to append the serialized records to
+            StagedWriter(std::vector<StagedRecord> &records):
+                m_records(records)
+                {}
+
+            /// Stage a string record
+            void writeString(const std::string &path, const std::string &contents,
+                gtar::CompressMode compression)
+                {
+                stage(path, contents.data(), contents.size(), compression);
+                }
+
+            /// Stage an array record, converting each element to T
+            template<typename iter, typename T>
+            void writeIndividual(const std::string &path, const iter &begin, const iter &end,
+                gtar::CompressMode compression)
+                {
+                std::vector<T> values;
+                for(iter i(begin); i != end; ++i)
+                    values.push_back(T(*i));
+                stage(path, values.data(), values.size()*sizeof(T), compression);
+                }
+
+            /// Stage a uniform record
+            template<typename T>
+            void writeUniform(const std::string &path, const T &val)
+                {
+                stage(path, &val, sizeof(T), gtar::NoCompress);
+                }
+
+        private:
+            /// Copy a serialized record into the list
+            void stage(const std::string &path, const void *contents, size_t size,
+                gtar::CompressMode compression)
+                {
+                StagedRecord rec;
+                rec.path = path;
+                rec.data.resize(size);
+                if(size)
+                    memcpy(&rec.data[0], contents, size);
+                rec.compression = compression;
+                m_records.push_back(std::move(rec));
+                }
+
+            /// List of staged records
+            std::vector<StagedRecord> &m_records;
+        };
+
     /// HOOMD analyzer which periodically dumps a set of properties
+    ///
+    /// In asynchronous mode (setAsync()), the properties of a frame
+    /// are serialized into staged records on the simulation thread and
+    /// handed to a writer thread on the root rank, which compresses
+    /// and writes them (and renames the temporary file in one-shot
+    /// mode) while the simulation continues. analyze() only blocks
+    /// when queueDepth frames are already waiting for the writer
+    /// thread. Errors of the writer thread are reported by the next
+    /// call to analyze(), writeStr(), or close().
     class PYBIND11_EXPORT GetarDumpWriter: public Analyzer
         {
         public:
             typedef std::map<unsigned int, std::vector<GetarDumpDescription> > PeriodMap;
             typedef std::map<unsigned int, NeedSnapshots> NeedSnapshotMap;
+            typedef std::map<unsigned int, unsigned int> NeedFrameMap;
 
             /// Constructor
             ///
@@ -232,6 +316,12 @@ namespace getardump{
             /// Close the getar file manually after finalizing any IO
             void close();
 
+            /// Write frames on a background thread
+            ///
+            /// :param async: If true, compress and write frames on the writer thread
+            /// :param queueDepth: Maximum number of frames waiting for the writer thread
+            void setAsync(bool async, unsigned int queueDepth);
+
             /// Get needed pdata flags
             virtual PDataFlags getRequestedPDataFlags()
                 {
@@ -273,13 +363,31 @@ namespace getardump{
 
         private:
             /// Write any GetarDumpDescription for the given timestep
-            void write(gtar::GTAR::BulkWriter &writer, const GetarDumpDescription &desc, unsigned int timestep);
+            /// (Writer is gtar::GTAR::BulkWriter or StagedWriter)
+            template<typename Writer>
+            void write(Writer &writer, const GetarDumpDescription &desc, unsigned int timestep);
             /// Write an individual GetarDumpDescription for the given timestep
-            void writeIndividual(gtar::GTAR::BulkWriter &writer, const GetarDumpDescription &desc, unsigned int timestep);
+            template<typename Writer>
+            void writeIndividual(Writer &writer, const GetarDumpDescription &desc, unsigned int timestep);
             /// Write a uniform GetarDumpDescription for the given timestep
-            void writeUniform(gtar::GTAR::BulkWriter &writer, const GetarDumpDescription &desc, unsigned int timestep);
+            template<typename Writer>
+            void writeUniform(Writer &writer, const GetarDumpDescription &desc, unsigned int timestep);
             /// Write a text GetarDumpDescription for the given timestep
-            void writeText(gtar::GTAR::BulkWriter &writer, const GetarDumpDescription &desc, unsigned int timestep);
+            template<typename Writer>
+            void writeText(Writer &writer, const GetarDumpDescription &desc, unsigned int timestep);
+
+            /// Hand a staged frame to the writer thread, blocking while the queue is full
+            void submitFrame(std::vector<StagedRecord> &records);
+            /// Block until the writer thread is idle and report its errors
+            void waitForWriter();
+            /// Report an error of the writer thread, if any
+            void checkWriterError();
+            /// Stop and join the writer thread after it wrote all queued frames
+            void stopWriter();
+            /// Main loop of the writer thread
+            void writerThread();
+            /// Write a staged frame into the archive (called by the writer thread)
+            void writeStaged(const std::vector<StagedRecord> &records);
 
             /// File archive interface
             std::shared_ptr<gtar::GTAR> m_archive;
@@ -300,6 +408,31 @@ namespace getardump{
             std::shared_ptr<SystemSnapshot> m_systemSnap;
             /// Map detailing when we need which snapshots
             NeedSnapshotMap m_neededSnapshots;
+            /// Map detailing when we need which single precision frame data
+            NeedFrameMap m_neededFrames;
+            /// Gathers single precision positions and images without a snapshot
+            ParticleFrameGather m_frame;
+            /// true if the frame data has been gathered for the current step
+            bool m_frameGathered;
+
+            /// true if frames are written by the writer thread
+            bool m_async;
+            /// Maximum number of frames waiting for the writer thread
+            unsigned int m_queueDepth;
+            /// Frames waiting for the writer thread
+            std::deque<std::vector<StagedRecord> > m_queue;
+            /// true while the writer thread writes a frame
+            bool m_writing;
+            /// Set to true to stop the writer thread
+            bool m_writerExit;
+            /// First error message of the writer thread
+            std::string m_writerError;
+            /// The writer thread
+            std::thread m_writerThread;
+            /// Protects the queue and the writer state
+            std::mutex m_writerMutex;
+            /// Signals changes of the queue and the writer state
+            std::condition_variable m_writerCv;
         };
 
 void export_GetarDumpWriter(pybind11::module& m);
@@ -90,7 +90,11 @@ class managed_deleter
     public:
         //! Default constructor
         managed_deleter()
-            : m_use_device(false), m_N(0), m_allocation_ptr(nullptr), m_allocation_bytes(0)
+            : m_use_device(false), m_N(0), m_allocation_ptr(nullptr), m_allocation_bytes(0),
+              m_owner(NOT_ACCOUNTED)
+            #ifdef ENABLE_CUDA
+            , m_slab(nullptr)
+            #endif
             {}
 
         //! Ctor
@@ -103,9 +107,30 @@ class managed_deleter
         managed_deleter(std::shared_ptr<const ExecutionConfiguration> exec_conf,
             bool use_device, std::size_t N, void *allocation_ptr, size_t allocation_bytes)
             : m_exec_conf(exec_conf), m_use_device(use_device), m_N(N),
-            m_allocation_ptr(allocation_ptr), m_allocation_bytes(allocation_bytes)
+            m_allocation_ptr(allocation_ptr), m_allocation_bytes(allocation_bytes), m_owner(NOT_ACCOUNTED)
+            #ifdef ENABLE_CUDA
+            , m_slab(nullptr)
+            #endif
             { }
 
+        #ifdef ENABLE_CUDA
+        //! Set the slab allocator that owns the memory
+        void setSlabAllocator(SlabAllocator *slab)
+            {
+            m_slab = slab;
+            }
+        #endif
+
+        //! Account for the allocation in the memory usage of its owner
+        /*! \param owner ID of the owner (see MemoryUsage)
+         */
+        void account(unsigned int owner)
+            {
+            m_owner = owner;
+            m_exec_conf->getMemoryUsage()->registerAllocation(m_owner,
+                m_use_device ? MemoryUsage::device : MemoryUsage::host, sizeof(T)*m_N);
+            }
+
         //! Set the tag
         void setTag(const std::string& tag)
             {
@@ -142,8 +167,15 @@ class managed_deleter
                 oss << std::endl;
                 this->m_exec_conf->msg->notice(10) << oss.str();
 
-                cudaFree(m_allocation_ptr);
-                CHECK_CUDA_ERROR();
+                if (m_slab)
+                    {
+                    m_slab->deallocate(m_allocation_ptr, m_allocation_bytes);
+                    }
+                else
+                    {
+                    cudaFree(m_allocation_ptr);
+                    CHECK_CUDA_ERROR();
+                    }
                 }
             else
             #endif
@@ -151,6 +183,10 @@ class managed_deleter
                 free(m_allocation_ptr);
                 }
 
+            if (m_owner != NOT_ACCOUNTED)
+                m_exec_conf->getMemoryUsage()->unregisterAllocation(m_owner,
+                    m_use_device ? MemoryUsage::device : MemoryUsage::host, sizeof(T)*m_N);
+
             // update memory allocation table
             if (m_exec_conf->getMemoryTracer())
                 this->m_exec_conf->getMemoryTracer()->unregisterAllocation(reinterpret_cast<const void *>(ptr),
@@ -164,38 +200,12 @@ class managed_deleter
         void *m_allocation_ptr;  //!< Start of unaligned allocation
         size_t m_allocation_bytes; //!< Size of actual allocation
         std::string m_tag;     //!< Name of the array
+        unsigned int m_owner;  //!< Owner in the memory usage accounting
+        #ifdef ENABLE_CUDA
+        SlabAllocator *m_slab; //!< The allocator owning the memory, or nullptr
+        #endif
     };
 
-#ifdef ENABLE_CUDA
-class event_deleter
-    {
-    public:
-        //! Default constructor
-        event_deleter()
-            {}
-
-        //! Constructor with execution configuration
-        /*! \param exec_conf The execution configuration (needed for CHECK_CUDA_ERROR)
-         */
-        event_deleter(std::shared_ptr<const ExecutionConfiguration> exec_conf)
-            : m_exec_conf(exec_conf)
-            { }
-
-        //! Destroy the event and free the memory location
-        /*! \param ptr Start of memory area
-         */
-        void operator()(cudaEvent_t *ptr)
-            {
-            cudaEventDestroy(*ptr);
-            CHECK_CUDA_ERROR();
-
-            delete ptr;
-            }
-    private:
-        std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< The execution configuration
-    };
-#endif
-
 } // end namespace detail
 
 } // end namespace hoomd
@@ -602,6 +612,51 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
             m_pitch  = pitch;
             }
 
+        //! Get the location of the valid copy of the data
+        /*! Managed memory is valid on the host and on the devices.
+         */
+        inline data_location::Enum getDataLocation() const
+            {
+            #ifndef ALWAYS_USE_MANAGED_MEMORY
+            if (!this->m_exec_conf || ! this->m_exec_conf->allConcurrentManagedAccess())
+                return m_fallback.getDataLocation();
+            #endif
+
+            #ifdef ENABLE_CUDA
+            if (this->m_exec_conf->isCUDAEnabled())
+                return data_location::hostdevice;
+            #endif
+            return data_location::host;
+            }
+
+        #ifdef ENABLE_CUDA
+        //! Start migrating the data to a location ahead of its use
+        /*! \param location Location where the data will be accessed next
+            \param stream CUDA stream to migrate the data in
+
+            The pages of managed memory are migrated to the host, or to the first active GPU, with
+            cudaMemPrefetchAsync().
+         */
+        inline void prefetch(const access_location::Enum location, cudaStream_t stream = 0) const
+            {
+            #ifndef ALWAYS_USE_MANAGED_MEMORY
+            if (!this->m_exec_conf || ! this->m_exec_conf->allConcurrentManagedAccess())
+                {
+                m_fallback.prefetch(location, stream);
+                return;
+                }
+            #endif
+
+            if (isNull() || !this->m_exec_conf->isCUDAEnabled())
+                return;
+
+            int device = (location == access_location::host) ? cudaCpuDeviceId : this->m_exec_conf->getGPUIds()[0];
+            cudaMemPrefetchAsync(m_data.get(), sizeof(T)*m_num_elements, device, stream);
+            if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            }
+        #endif
+
         //! Set an optional tag for memory profiling
         /*! tag The name of this allocation
          */
@@ -625,6 +680,29 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
         #endif
                         ) const;
 
+        //! Acquires the data pointer with a valid range of elements
+        /*! Managed memory is always acquired as a whole.
+         */
+        inline ArrayHandleDispatch<T> acquireRange(const access_location::Enum location, const access_mode::Enum mode,
+            unsigned int first, unsigned int count, bool& partial) const
+            {
+            #ifndef ALWAYS_USE_MANAGED_MEMORY
+            if (!this->m_exec_conf || ! this->m_exec_conf->allConcurrentManagedAccess())
+                return m_fallback.acquireRange(location, mode, first, count, partial);
+            #endif
+
+            partial = false;
+            return acquire(location, mode);
+            }
+
+        //! Write back a range of elements that was acquired with a partial copy
+        inline void releaseRange(const access_location::Enum location, unsigned int first, unsigned int count) const
+            {
+            #ifndef ALWAYS_USE_MANAGED_MEMORY
+            m_fallback.releaseRange(location, first, count);
+            #endif
+            }
+
         //! Release the data pointer
         inline void release() const
             {
@@ -681,7 +759,18 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
             size_t allocation_bytes;
 
             #ifdef ENABLE_CUDA
-            if (use_device)
+            SlabAllocator *slab = nullptr;
+            if (use_device && SlabAllocator::isSmall(m_num_elements*sizeof(T)))
+                slab = this->m_exec_conf->getSlabAllocator(SlabAllocator::managed);
+
+            if (slab)
+                {
+                // small arrays share the pages of a slab, memory hints on them are only approximate
+                allocation_bytes = m_num_elements*sizeof(T);
+                ptr = slab->allocate(allocation_bytes, 0, this->m_exec_conf->getMemoryTracer());
+                allocation_ptr = ptr;
+                }
+            else if (use_device)
                 {
                 allocation_bytes = m_num_elements*sizeof(T);
 
@@ -743,6 +832,11 @@ class GlobalArray : public GPUArrayBase<T, GlobalArray<T> >
             hoomd::detail::managed_deleter<T> deleter(this->m_exec_conf,use_device,
                 m_num_elements, allocation_ptr, allocation_bytes);
             deleter.setTag(m_tag);
+            #ifdef ENABLE_CUDA
+            deleter.setSlabAllocator(slab);
+            #endif
+            if (this->m_exec_conf)
+                deleter.account(this->m_exec_conf->getMemoryUsage()->getCurrentOwner());
             m_data = std::unique_ptr<T, decltype(deleter)>(reinterpret_cast<T *>(ptr), deleter);
 
             // register new allocation
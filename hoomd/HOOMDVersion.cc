@@ -38,6 +38,12 @@ std::string hoomd_compile_flags()
     o << "DOUBLE ";
     #ifdef ENABLE_HPMC_MIXED_PRECISION
     o << "HPMC_MIXED ";
+    #ifdef ENABLE_HPMC_ADAPTIVE_PRECISION
+    o << "HPMC_ADAPTIVE ";
+    #endif
+    #endif
+    #ifdef ENABLE_MD_MIXED_PRECISION
+    o << "MD_MIXED ";
     #endif
     #endif
 
@@ -53,6 +59,10 @@ std::string hoomd_compile_flags()
     o << "TBB ";
     #endif
 
+    #ifdef ENABLE_FFTW
+    o << "FFTW ";
+    #endif
+
     #ifdef __SSE__
     o << "SSE ";
     #endif
@@ -42,7 +42,8 @@ IMDInterface::IMDInterface(std::shared_ptr<SystemDefinition> sysdef,
                            unsigned int rate,
                            std::shared_ptr<ConstForceCompute> force,
                            float force_scale)
-    : Analyzer(sysdef)
+    : Analyzer(sysdef), m_stride(1), m_frame(sysdef->getParticleData()), m_pending_timestep(0),
+      m_pending_frame(false), m_sending(false), m_send_failed(false), m_sender_exit(false), m_n_dropped(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing IMDInterface: " << port << " " << pause << " " << rate << " " << force_scale << endl;
 
@@ -71,9 +72,6 @@ void IMDInterface::initConnection()
     {
     int err = 0;
 
-    // start by initializing memory
-    m_tmp_coords = new float[m_pdata->getNGlobal() * 3];
-
     // initialize the listening socket
     vmdsock_init();
     m_listen_sock = vmdsock_create();
@@ -113,19 +111,38 @@ IMDInterface::~IMDInterface()
     {
     m_exec_conf->msg->notice(5) << "Destroying IMDInterface" << endl;
 
+    // the sender thread must not use the socket any more
+    stopSender();
+
     if (m_is_initialized)
         {
         // free all used memory
-        delete[] m_tmp_coords;
         vmdsock_destroy(m_connected_sock);
         vmdsock_destroy(m_listen_sock);
 
-        m_tmp_coords = NULL;
         m_connected_sock = NULL;
         m_listen_sock = NULL;
         }
     }
 
+/*! \param group Particles to transmit, or NULL to transmit all particles
+    \param stride Transmit only every \a stride th particle in tag order
+
+    IMD clients expect the same number of particles in every frame, so the selection is made once from the (static)
+    group membership and not from the current positions.
+*/
+void IMDInterface::setFilter(std::shared_ptr<ParticleGroup> group, unsigned int stride)
+    {
+    if (stride == 0)
+        {
+        m_exec_conf->msg->error() << "analyze.imd: stride must be positive" << endl;
+        throw runtime_error("Error setting IMD filter");
+        }
+
+    m_group = group;
+    m_stride = stride;
+    }
+
 /*! If there is no active connection, analyze() will check to see if a connection attempt
     has been made since the last call. If so, it will attempt to handshake with VMD and
     on success will start transmitting data every time analyze() is called
@@ -161,6 +178,18 @@ void IMDInterface::analyze(unsigned int timestep)
         {
         m_count++;
 
+        // drop the connection if the sender thread could not write to it
+        bool send_failed = false;
+            {
+            std::lock_guard<std::mutex> lock(m_sender_mutex);
+            send_failed = m_send_failed;
+            }
+        if (m_connected_sock && send_failed)
+            {
+            m_exec_conf->msg->error() << "analyze.imd: I/O error while sending coordinates, disconnecting" << endl;
+            processDeadConnection();
+            }
+
         do
             {
             // establish a connection if one has not been made
@@ -380,6 +409,9 @@ void IMDInterface::processIMD_IOERROR()
 
 void IMDInterface::processDeadConnection()
     {
+    // the sender thread must be done with the socket before it is destroyed
+    waitForSender();
+
     vmdsock_destroy(m_connected_sock);
     m_connected_sock = NULL;
     m_active = false;
@@ -418,6 +450,9 @@ void IMDInterface::establishConnectionAttempt()
         else
             {
             m_exec_conf->msg->notice(2) << "analyze.imd: accepted connection" << endl;
+
+            std::lock_guard<std::mutex> lock(m_sender_mutex);
+            m_send_failed = false;
             }
         }
     }
@@ -425,13 +460,13 @@ void IMDInterface::establishConnectionAttempt()
 /*! \param timestep Current time step of the simulation
     \pre A connection has been established
 
-    Sends the current coordinates to VMD for display.
+    Gathers the current coordinates of the transmitted particles and hands them to the sender thread, which sends
+    them to VMD for display. sendCoords() does not wait for the socket.
 */
 void IMDInterface::sendCoords(unsigned int timestep)
     {
-    // take a snapshot of the particle data
-    SnapshotParticleData<Scalar> snapshot;
-    m_pdata->takeSnapshot(snapshot);
+    // gather the single precision positions in tag order
+    m_frame.gather(0);
 
 #ifdef ENABLE_MPI
     // return now if not root rank
@@ -441,41 +476,117 @@ void IMDInterface::sendCoords(unsigned int timestep)
 
     assert(m_connected_sock != NULL);
 
-    // setup and send the energies structure
-    IMDEnergies energies;
-    energies.tstep = timestep;
-    energies.T = 0.0f;
-    energies.Etot = 0.0f;
-    energies.Epot = 0.0f;
-    energies.Evdw = 0.0f;
-    energies.Eelec = 0.0f;
-    energies.Ebond = 0.0f;
-    energies.Eangle = 0.0f;
-    energies.Edihe = 0.0f;
-    energies.Eimpr = 0.0f;
-
-    int err = imd_send_energies(m_connected_sock, &energies);
-    if (err)
+    const std::vector<float3>& pos = m_frame.getPositions();
+
+    // copy the transmitted particles to the staging frame
+    unsigned int n = m_group ? m_group->getNumMembersGlobal() : m_pdata->getNGlobal();
+    m_staged_coords.resize(3*((n + m_stride - 1) / m_stride));
+    unsigned int k = 0;
+    for (unsigned int i = 0; i < n; i += m_stride)
         {
-        m_exec_conf->msg->error() << "analyze.imd: I/O error while sending energies, disconnecting" << endl;
-        processDeadConnection();
-        return;
+        unsigned int tag = m_group ? m_group->getMemberTag(i) : i;
+        m_staged_coords[k++] = pos[tag].x;
+        m_staged_coords[k++] = pos[tag].y;
+        m_staged_coords[k++] = pos[tag].z;
         }
 
-    // copy the particle data to the holding array and send it
-    for (unsigned int tag = 0; tag < m_pdata->getNGlobal(); tag++)
+    submitFrame(timestep);
+    }
+
+void IMDInterface::submitFrame(unsigned int timestep)
+    {
+    // the sender thread is started on the first frame
+    if (!m_sender_thread.joinable())
         {
-        m_tmp_coords[tag*3] = float(snapshot.pos[tag].x);
-        m_tmp_coords[tag*3 + 1] = float(snapshot.pos[tag].y);
-        m_tmp_coords[tag*3 + 2] = float(snapshot.pos[tag].z);
+        m_sender_exit = false;
+        m_sender_thread = std::thread(&IMDInterface::senderThread, this);
         }
-    err = imd_send_fcoords(m_connected_sock, m_pdata->getNGlobal(), m_tmp_coords);
 
-    if (err)
         {
-        m_exec_conf->msg->error() << "analyze.imd: I/O error while sending coordinates, disconnecting" << endl;
-        processDeadConnection();
+        std::lock_guard<std::mutex> lock(m_sender_mutex);
+
+        // latest frame wins: a frame the client has not started to receive is replaced
+        if (m_pending_frame)
+            m_n_dropped++;
+
+        m_pending_coords.swap(m_staged_coords);
+        m_pending_timestep = timestep;
+        m_pending_frame = true;
+        }
+    m_sender_cv.notify_all();
+    }
+
+void IMDInterface::waitForSender()
+    {
+    std::unique_lock<std::mutex> lock(m_sender_mutex);
+    m_pending_frame = false;
+    m_sender_cv.wait(lock, [this] { return !m_sending; });
+    }
+
+void IMDInterface::stopSender()
+    {
+    if (!m_sender_thread.joinable())
         return;
+
+        {
+        std::lock_guard<std::mutex> lock(m_sender_mutex);
+        m_sender_exit = true;
+        m_pending_frame = false;
+        }
+    m_sender_cv.notify_all();
+    m_sender_thread.join();
+    }
+
+/*! The sender thread waits for frames handed over by submitFrame() and writes them to the connected socket. The loop
+    exits when m_sender_exit is set. After an I/O error, m_send_failed is set and analyze() drops the connection.
+*/
+void IMDInterface::senderThread()
+    {
+    std::unique_lock<std::mutex> lock(m_sender_mutex);
+    while (true)
+        {
+        m_sender_cv.wait(lock, [this] { return m_pending_frame || m_sender_exit; });
+
+        if (m_sender_exit)
+            break;
+
+        // take ownership of the frame and the socket
+        m_send_coords.swap(m_pending_coords);
+        unsigned int timestep = m_pending_timestep;
+        m_pending_frame = false;
+        m_sending = true;
+        void *sock = m_connected_sock;
+        bool failed = m_send_failed;
+
+        // perform the socket I/O without holding the lock
+        lock.unlock();
+        int err = 0;
+        if (sock && !failed)
+            {
+            // setup and send the energies structure
+            IMDEnergies energies;
+            energies.tstep = timestep;
+            energies.T = 0.0f;
+            energies.Etot = 0.0f;
+            energies.Epot = 0.0f;
+            energies.Evdw = 0.0f;
+            energies.Eelec = 0.0f;
+            energies.Ebond = 0.0f;
+            energies.Eangle = 0.0f;
+            energies.Edihe = 0.0f;
+            energies.Eimpr = 0.0f;
+
+            err = imd_send_energies(sock, &energies);
+
+            if (!err)
+                err = imd_send_fcoords(sock, m_send_coords.size()/3, m_send_coords.size() ? &m_send_coords[0] : NULL);
+            }
+        lock.lock();
+
+        if (err)
+            m_send_failed = true;
+        m_sending = false;
+        m_sender_cv.notify_all();
         }
     }
 
@@ -483,5 +594,7 @@ void export_IMDInterface(py::module& m)
     {
     py::class_<IMDInterface, std::shared_ptr<IMDInterface> >(m,"IMDInterface",py::base<Analyzer>())
     .def(py::init< std::shared_ptr<SystemDefinition>, int, bool, unsigned int, std::shared_ptr<ConstForceCompute> >())
+    .def("setFilter", &IMDInterface::setFilter)
+    .def("getNumDroppedFrames", &IMDInterface::getNumDroppedFrames)
         ;
     }
@@ -16,8 +16,14 @@
 
 #include "Analyzer.h"
 #include "ConstForceCompute.h"
+#include "ParticleFrameGather.h"
+#include "ParticleGroup.h"
 
 #include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #ifndef __IMD_INTERFACE_H__
 #define __IMD_INTERFACE_H__
@@ -31,6 +37,12 @@
     In its current implementation, only a barebones set of commands are
     supported. The sending of any command that is not understood will
     result in the socket closing the connection.
+
+    The coordinates are gathered in single precision with ParticleFrameGather and handed to a sender thread on the
+    root rank, which writes them to the socket while the simulation continues. Only the latest frame is kept: when the
+    client has not received the previous frame by the time the next one is ready, the previous frame is dropped. The
+    transmitted particles can be restricted to a group (e.g. a region) and decimated by taking every \a stride th
+    member, see setFilter().
     \ingroup analyzers
 */
 class PYBIND11_EXPORT IMDInterface : public Analyzer
@@ -49,10 +61,19 @@ class PYBIND11_EXPORT IMDInterface : public Analyzer
 
         //! Handle connection requests and send current positions if connected
         void analyze(unsigned int timestep);
+
+        //! Transmit only every \a stride th member of \a group (all particles when \a group is NULL)
+        void setFilter(std::shared_ptr<ParticleGroup> group, unsigned int stride);
+
+        //! Get the number of frames that were dropped because the client was still receiving the previous one
+        unsigned int getNumDroppedFrames()
+            {
+            std::lock_guard<std::mutex> lock(m_sender_mutex);
+            return m_n_dropped;
+            }
     private:
         void *m_listen_sock;    //!< Socket we are listening on
         void *m_connected_sock; //!< Socket to transmit/receive data
-        float *m_tmp_coords;    //!< Temporary holding location for coordinate data
 
         bool m_active;          //!< True if we have received a go command
         bool m_paused;          //!< True if we are paused
@@ -66,6 +87,23 @@ class PYBIND11_EXPORT IMDInterface : public Analyzer
         std::shared_ptr<ConstForceCompute> m_force;   //!< Force for applying IMD forces
         float m_force_scale;                            //!< Factor by which to scale all IMD forces
 
+        std::shared_ptr<ParticleGroup> m_group;       //!< Particles to transmit (NULL for all)
+        unsigned int m_stride;                          //!< Transmit every m_stride th particle
+        ParticleFrameGather m_frame;                    //!< Gathers the single precision positions in tag order
+
+        std::vector<float> m_staged_coords;             //!< Coordinates of the frame being prepared
+        std::vector<float> m_pending_coords;            //!< Latest frame waiting for the sender thread
+        std::vector<float> m_send_coords;               //!< Frame owned by the sender thread while it is sent
+        unsigned int m_pending_timestep;                //!< Time step of the pending frame
+        bool m_pending_frame;                           //!< True while a frame waits for the sender thread
+        bool m_sending;                                 //!< True while the sender thread writes to the socket
+        bool m_send_failed;                             //!< Set by the sender thread on an I/O error
+        bool m_sender_exit;                             //!< Set to true to stop the sender thread
+        unsigned int m_n_dropped;                       //!< Number of frames replaced before they were sent
+        std::thread m_sender_thread;                    //!< The sender thread
+        std::mutex m_sender_mutex;                      //!< Protects the pending frame and the sender state
+        std::condition_variable m_sender_cv;            //!< Signals changes of the sender state
+
         //! Helper function that reads message headers and dispatches them to the relevant process functions
         void dispatch();
         //! Helper function to determine of messages are still available
@@ -92,6 +130,15 @@ class PYBIND11_EXPORT IMDInterface : public Analyzer
         //! Helper function to send current data to VMD
         void sendCoords(unsigned int timestep);
 
+        //! Hand the staged frame to the sender thread, replacing a frame that has not been sent yet
+        void submitFrame(unsigned int timestep);
+        //! Drop the pending frame and block until the sender thread no longer uses the socket
+        void waitForSender();
+        //! Stop and join the sender thread
+        void stopSender();
+        //! Main loop of the sender thread
+        void senderThread();
+
         //! Initialize socket and internal state variables for communication
         void initConnection();
     };
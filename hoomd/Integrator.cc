@@ -25,14 +25,19 @@ using namespace std;
 /*! \param sysdef System to update
     \param deltaT Time step to use
 */
-Integrator::Integrator(std::shared_ptr<SystemDefinition> sysdef, Scalar deltaT) : Updater(sysdef), m_deltaT(deltaT)
+Integrator::Integrator(std::shared_ptr<SystemDefinition> sysdef, Scalar deltaT)
+    : Updater(sysdef), m_deltaT(deltaT), m_slow_period(1)
     {
     if (m_deltaT <= 0.0)
         m_exec_conf->msg->warning() << "integrate.*: A timestep of less than 0.0 was specified" << endl;
+
+    m_pdata->getNetEnergySignal().connect<Integrator, &Integrator::validateNetEnergy>(this);
     }
 
 Integrator::~Integrator()
     {
+    m_pdata->getNetEnergySignal().disconnect<Integrator, &Integrator::validateNetEnergy>(this);
+
     #ifdef ENABLE_MPI
     // disconnect
     if (m_request_flags_connected && m_comm)
@@ -77,6 +82,42 @@ void Integrator::removeForceComputes()
     m_constraint_forces.clear();
     }
 
+/*! \param fc ForceCompute to mark as slow
+
+    The force must also be added with addForceCompute() to be applied. Slow forces remain marked when
+    removeForceComputes() is called.
+*/
+void Integrator::addSlowForceCompute(std::shared_ptr<ForceCompute> fc)
+    {
+    assert(fc);
+    if (!isSlowForce(fc))
+        m_slow_forces.push_back(fc);
+
+    // slow forces are scaled when they are summed, they cannot accumulate into the net force
+    fc->setAccumulateNetForce(false);
+    }
+
+/*! Call removeSlowForceComputes() to evaluate all forces on every step again
+*/
+void Integrator::removeSlowForceComputes()
+    {
+    m_slow_forces.clear();
+    }
+
+/*! \param period Number of inner steps per evaluation of the slow forces
+
+    The slow forces are evaluated on the steps that are a multiple of \a period.
+*/
+void Integrator::setSlowForcePeriod(unsigned int period)
+    {
+    if (period == 0)
+        {
+        m_exec_conf->msg->error() << "integrate.*: The slow force period must be at least 1" << endl;
+        throw runtime_error("Error setting slow force period");
+        }
+    m_slow_period = period;
+    }
+
 /*! Call removeHalfStepHook() to unset the integrator's HalfStep hook
 */
 void Integrator::removeHalfStepHook()
@@ -302,6 +343,62 @@ Scalar Integrator::computeTotalMomentum(unsigned int timestep)
     return Scalar(p_tot);
     }
 
+/*! \param timestep Current time step of the simulation
+    \returns true if any force has been added to the net force
+
+    Forces that accumulate into the net force directly (see ForceCompute::accumulatesNetForce()) need a zeroed net
+    force before they are evaluated. When there are any on this time step, the net force, torque and virial are zeroed
+    and these forces are evaluated. The remaining forces are then added to the net force as usual.
+*/
+bool Integrator::computeAccumulatedForces(unsigned int timestep)
+    {
+    std::vector< std::shared_ptr<ForceCompute> > accumulated;
+    for (auto force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+        {
+        if ((*force_compute)->accumulatesNetForce() && isForceComputed(*force_compute, timestep))
+            accumulated.push_back(*force_compute);
+        }
+
+    if (accumulated.size() == 0)
+        return false;
+
+        {
+        const GlobalArray<Scalar4>& net_force  = m_pdata->getNetForce();
+        const GlobalArray<Scalar>&  net_virial = m_pdata->getNetVirial();
+        const GlobalArray<Scalar4>& net_torque = m_pdata->getNetTorqueArray();
+
+        #ifdef ENABLE_CUDA
+        if (m_exec_conf->isCUDAEnabled())
+            {
+            ArrayHandle<Scalar4> d_net_force(net_force, access_location::device, access_mode::overwrite);
+            ArrayHandle<Scalar> d_net_virial(net_virial, access_location::device, access_mode::overwrite);
+            ArrayHandle<Scalar4> d_net_torque(net_torque, access_location::device, access_mode::overwrite);
+
+            cudaMemset(d_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
+            cudaMemset(d_net_torque.data, 0, sizeof(Scalar4)*net_torque.getNumElements());
+            cudaMemset(d_net_virial.data, 0, sizeof(Scalar)*net_virial.getNumElements());
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            }
+        else
+        #endif
+            {
+            ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::overwrite);
+            ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::overwrite);
+            ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, access_mode::overwrite);
+
+            memset((void *)h_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
+            memset((void *)h_net_virial.data, 0, sizeof(Scalar)*net_virial.getNumElements());
+            memset((void *)h_net_torque.data, 0, sizeof(Scalar4)*net_torque.getNumElements());
+            }
+        }
+
+    for (auto force_compute = accumulated.begin(); force_compute != accumulated.end(); ++force_compute)
+        (*force_compute)->accumulateNetForce(timestep);
+
+    return true;
+    }
+
 /*! \param timestep Current time step of the simulation
     \post All added force computes in \a m_forces are computed and totaled up in \a m_net_force and \a m_net_virial
     \note The summation step is performed <b>on the CPU</b> and will result in a lot of data traffic back and forth
@@ -309,9 +406,17 @@ Scalar Integrator::computeTotalMomentum(unsigned int timestep)
 */
 void Integrator::computeNetForce(unsigned int timestep)
     {
+    resetSkippedEnergies();
+
+    // the forces that add to the net force directly are evaluated first
+    bool accumulated = computeAccumulatedForces(timestep);
+
     std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
     for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->compute(timestep);
+        {
+        if (isForceComputed(*force_compute, timestep) && !(*force_compute)->accumulatesNetForce())
+            (*force_compute)->compute(timestep);
+        }
 
     if (m_prof)
         {
@@ -326,14 +431,18 @@ void Integrator::computeNetForce(unsigned int timestep)
         const GlobalArray<Scalar4>& net_force  = m_pdata->getNetForce();
         const GlobalArray<Scalar>&  net_virial = m_pdata->getNetVirial();
         const GlobalArray<Scalar4>& net_torque = m_pdata->getNetTorqueArray();
-        ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, access_mode::overwrite);
+        const access_mode::Enum net_mode = accumulated ? access_mode::readwrite : access_mode::overwrite;
+        ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, net_mode);
+        ArrayHandle<Scalar> h_net_virial(net_virial, access_location::host, net_mode);
+        ArrayHandle<Scalar4> h_net_torque(net_torque, access_location::host, net_mode);
 
-        // start by zeroing the net force and virial arrays
-        memset((void *)h_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
-        memset((void *)h_net_virial.data, 0, sizeof(Scalar)*net_virial.getNumElements());
-        memset((void *)h_net_torque.data, 0, sizeof(Scalar4)*net_torque.getNumElements());
+        // start by zeroing the net force and virial arrays, unless forces have already been added to them
+        if (!accumulated)
+            {
+            memset((void *)h_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
+            memset((void *)h_net_virial.data, 0, sizeof(Scalar)*net_virial.getNumElements());
+            memset((void *)h_net_torque.data, 0, sizeof(Scalar4)*net_torque.getNumElements());
+            }
 
         for (unsigned int i = 0; i < 6; ++i)
            external_virial[i] = Scalar(0.0);
@@ -351,6 +460,24 @@ void Integrator::computeNetForce(unsigned int timestep)
 
         for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
             {
+            if (!isForceComputed(*force_compute, timestep))
+                continue;
+
+            for (unsigned int k = 0; k < 6; k++)
+                external_virial[k] += (*force_compute)->getExternalVirial(k);
+
+            external_energy += (*force_compute)->getExternalEnergy();
+
+            // already added to the net force
+            if ((*force_compute)->accumulatesNetForce())
+                continue;
+
+            if (!(*force_compute)->energiesValid())
+                m_skipped_energies.push_back(*force_compute);
+
+            // slow forces are applied as an impulse over their whole period
+            const Scalar force_scale = isSlowForce(*force_compute) ? Scalar(m_slow_period) : Scalar(1.0);
+
             GlobalArray<Scalar4>& h_force_array = (*force_compute)->getForceArray();
             GlobalArray<Scalar>& h_virial_array = (*force_compute)->getVirialArray();
             GlobalArray<Scalar4>& h_torque_array = (*force_compute)->getTorqueArray();
@@ -366,14 +493,14 @@ void Integrator::computeNetForce(unsigned int timestep)
             unsigned int virial_pitch = h_virial_array.getPitch();
             for (unsigned int j = 0; j < nparticles; j++)
                 {
-                h_net_force.data[j].x += h_force.data[j].x;
-                h_net_force.data[j].y += h_force.data[j].y;
-                h_net_force.data[j].z += h_force.data[j].z;
+                h_net_force.data[j].x += force_scale*h_force.data[j].x;
+                h_net_force.data[j].y += force_scale*h_force.data[j].y;
+                h_net_force.data[j].z += force_scale*h_force.data[j].z;
                 h_net_force.data[j].w += h_force.data[j].w;
 
-                h_net_torque.data[j].x += h_torque.data[j].x;
-                h_net_torque.data[j].y += h_torque.data[j].y;
-                h_net_torque.data[j].z += h_torque.data[j].z;
+                h_net_torque.data[j].x += force_scale*h_torque.data[j].x;
+                h_net_torque.data[j].y += force_scale*h_torque.data[j].y;
+                h_net_torque.data[j].z += force_scale*h_torque.data[j].z;
                 h_net_torque.data[j].w += h_torque.data[j].w;
 
                 for (unsigned int k = 0; k < 6; k++)
@@ -381,11 +508,6 @@ void Integrator::computeNetForce(unsigned int timestep)
                     h_net_virial.data[k*net_virial_pitch+j] += h_virial.data[k*virial_pitch+j];
                     }
                 }
-
-            for (unsigned int k = 0; k < 6; k++)
-                external_virial[k] += (*force_compute)->getExternalVirial(k);
-
-            external_energy += (*force_compute)->getExternalEnergy();
             }
         }
 
@@ -400,6 +522,13 @@ void Integrator::computeNetForce(unsigned int timestep)
         m_prof->pop();
         }
 
+    #ifdef ENABLE_MPI
+    // with the half-shell ghost exchange, the forces on the ghosts are sent back to their owners
+    // (there are no constraint forces in this mode)
+    if (m_comm && m_comm->getHalfShell())
+        m_comm->updateNetForce(timestep);
+    #endif
+
     // return early if there are no constraint forces or no HalfStepHook set
     if (m_constraint_forces.size() == 0)
         return;
@@ -499,12 +628,38 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         throw runtime_error("Error computing accelerations");
         }
 
+    resetSkippedEnergies();
+
     // compute all the normal forces first
 
     std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
 
+    // the forces that are summed unscaled on this step, slow forces are added separately
+    std::vector< std::shared_ptr<ForceCompute> > fast_forces;
+    std::vector< std::shared_ptr<ForceCompute> > slow_forces;
+    // the forces that add to the net force directly are evaluated first
+    bool accumulated = computeAccumulatedForces(timestep);
+
     for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+        {
+        if (!isForceComputed(*force_compute, timestep) || (*force_compute)->accumulatesNetForce())
+            continue;
+
         (*force_compute)->compute(timestep);
+        if (isSlowForce(*force_compute) && m_slow_period > 1)
+            slow_forces.push_back(*force_compute);
+        else
+            fast_forces.push_back(*force_compute);
+
+        if (!(*force_compute)->energiesValid())
+            m_skipped_energies.push_back(*force_compute);
+        }
+
+    // the computes with a stream of their own run concurrently, the summation waits for all of them
+    for (force_compute = fast_forces.begin(); force_compute != fast_forces.end(); ++force_compute)
+        (*force_compute)->waitStream();
+    for (force_compute = slow_forces.begin(); force_compute != slow_forces.end(); ++force_compute)
+        (*force_compute)->waitStream();
 
     if (m_prof)
         {
@@ -522,9 +677,10 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         const GlobalArray< Scalar >&  net_virial = m_pdata->getNetVirial();
         unsigned int net_virial_pitch = net_virial.getPitch();
 
-        ArrayHandle<Scalar4> d_net_force(net_force, access_location::device, access_mode::overwrite);
-        ArrayHandle<Scalar>  d_net_virial(net_virial, access_location::device, access_mode::overwrite);
-        ArrayHandle<Scalar4> d_net_torque(net_torque, access_location::device, access_mode::overwrite);
+        const access_mode::Enum net_mode = accumulated ? access_mode::readwrite : access_mode::overwrite;
+        ArrayHandle<Scalar4> d_net_force(net_force, access_location::device, net_mode);
+        ArrayHandle<Scalar>  d_net_virial(net_virial, access_location::device, net_mode);
+        ArrayHandle<Scalar4> d_net_torque(net_torque, access_location::device, net_mode);
 
         // also sum up forces for ghosts, in case they are needed by the communicator
         unsigned int nparticles = m_pdata->getN() + m_pdata->getNGhosts();
@@ -541,7 +697,7 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         // there is no need to zero out the initial net force and virial here, the first call to the addition kernel
         // will do that
         // ahh!, but we do need to zer out the net force and virial if there are 0 forces!
-        if (m_forces.size() == 0)
+        if (fast_forces.size() == 0 && !accumulated)
             {
             // start by zeroing the net force and virial arrays
             cudaMemset(d_net_force.data, 0, sizeof(Scalar4)*net_force.getNumElements());
@@ -554,81 +710,81 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         // now, add up the accelerations
         // sum all the forces into the net force
         // perform the sum in groups of 6 to avoid kernel launch and memory access overheads
-        for (unsigned int cur_force = 0; cur_force < m_forces.size(); cur_force += 6)
+        for (unsigned int cur_force = 0; cur_force < fast_forces.size(); cur_force += 6)
             {
             // grab the device pointers for the current set
             gpu_force_list force_list;
 
-            const GlobalArray<Scalar4>& d_force_array0 = m_forces[cur_force]->getForceArray();
+            const GlobalArray<Scalar4>& d_force_array0 = fast_forces[cur_force]->getForceArray();
             ArrayHandle<Scalar4> d_force0(d_force_array0,access_location::device,access_mode::read);
-            const GlobalArray<Scalar>& d_virial_array0 = m_forces[cur_force]->getVirialArray();
+            const GlobalArray<Scalar>& d_virial_array0 = fast_forces[cur_force]->getVirialArray();
             ArrayHandle<Scalar> d_virial0(d_virial_array0,access_location::device,access_mode::read);
-            const GlobalArray<Scalar4>& d_torque_array0 = m_forces[cur_force]->getTorqueArray();
+            const GlobalArray<Scalar4>& d_torque_array0 = fast_forces[cur_force]->getTorqueArray();
             ArrayHandle<Scalar4> d_torque0(d_torque_array0,access_location::device,access_mode::read);
             force_list.f0 = d_force0.data;
             force_list.v0 = d_virial0.data;
             force_list.vpitch0 = d_virial_array0.getPitch();
             force_list.t0 = d_torque0.data;
 
-            if (cur_force+1 < m_forces.size())
+            if (cur_force+1 < fast_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array1 = m_forces[cur_force+1]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array1 = fast_forces[cur_force+1]->getForceArray();
                 ArrayHandle<Scalar4> d_force1(d_force_array1,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array1 = m_forces[cur_force+1]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array1 = fast_forces[cur_force+1]->getVirialArray();
                 ArrayHandle<Scalar> d_virial1(d_virial_array1,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array1 = m_forces[cur_force+1]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array1 = fast_forces[cur_force+1]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque1(d_torque_array1,access_location::device,access_mode::read);
                 force_list.f1 = d_force1.data;
                 force_list.v1 = d_virial1.data;
                 force_list.vpitch1 = d_virial_array1.getPitch();
                 force_list.t1 = d_torque1.data;
                 }
-            if (cur_force+2 < m_forces.size())
+            if (cur_force+2 < fast_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array2 = m_forces[cur_force+2]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array2 = fast_forces[cur_force+2]->getForceArray();
                 ArrayHandle<Scalar4> d_force2(d_force_array2,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array2 = m_forces[cur_force+2]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array2 = fast_forces[cur_force+2]->getVirialArray();
                 ArrayHandle<Scalar> d_virial2(d_virial_array2,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array2 = m_forces[cur_force+2]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array2 = fast_forces[cur_force+2]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque2(d_torque_array2,access_location::device,access_mode::read);
                 force_list.f2 = d_force2.data;
                 force_list.v2 = d_virial2.data;
                 force_list.vpitch2 = d_virial_array2.getPitch();
                 force_list.t2 = d_torque2.data;
                 }
-            if (cur_force+3 < m_forces.size())
+            if (cur_force+3 < fast_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array3 = m_forces[cur_force+3]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array3 = fast_forces[cur_force+3]->getForceArray();
                 ArrayHandle<Scalar4> d_force3(d_force_array3,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array3 = m_forces[cur_force+3]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array3 = fast_forces[cur_force+3]->getVirialArray();
                 ArrayHandle<Scalar> d_virial3(d_virial_array3,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array3 = m_forces[cur_force+3]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array3 = fast_forces[cur_force+3]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque3(d_torque_array3,access_location::device,access_mode::read);
                 force_list.f3 = d_force3.data;
                 force_list.v3 = d_virial3.data;
                 force_list.vpitch3 = d_virial_array3.getPitch();
                 force_list.t3 = d_torque3.data;
                 }
-            if (cur_force+4 < m_forces.size())
+            if (cur_force+4 < fast_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array4 = m_forces[cur_force+4]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array4 = fast_forces[cur_force+4]->getForceArray();
                 ArrayHandle<Scalar4> d_force4(d_force_array4,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array4 = m_forces[cur_force+4]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array4 = fast_forces[cur_force+4]->getVirialArray();
                 ArrayHandle<Scalar> d_virial4(d_virial_array4,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array4 = m_forces[cur_force+4]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array4 = fast_forces[cur_force+4]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque4(d_torque_array4,access_location::device,access_mode::read);
                 force_list.f4 = d_force4.data;
                 force_list.v4 = d_virial4.data;
                 force_list.vpitch4 = d_virial_array4.getPitch();
                 force_list.t4 = d_torque4.data;
                 }
-            if (cur_force+5 < m_forces.size())
+            if (cur_force+5 < fast_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array5 = m_forces[cur_force+5]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array5 = fast_forces[cur_force+5]->getForceArray();
                 ArrayHandle<Scalar4> d_force5(d_force_array5,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array5 = m_forces[cur_force+5]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array5 = fast_forces[cur_force+5]->getVirialArray();
                 ArrayHandle<Scalar> d_virial5(d_virial_array5,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array5 = m_forces[cur_force+5]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array5 = fast_forces[cur_force+5]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque5(d_torque_array5,access_location::device,access_mode::read);
                 force_list.f5 = d_force5.data;
                 force_list.v5 = d_virial5.data;
@@ -636,8 +792,8 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
                 force_list.t5 = d_torque5.data;
                 }
 
-            // clear on the first iteration only
-            bool clear = (cur_force == 0);
+            // clear on the first iteration only, and only if no forces have been added yet
+            bool clear = (cur_force == 0) && !accumulated;
 
             // access flags
             PDataFlags flags = this->m_pdata->getFlags();
@@ -659,11 +815,47 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
 
             m_exec_conf->endMultiGPU();
             }
+
+        // slow forces are applied as an impulse over their whole period
+        for (unsigned int cur_force = 0; cur_force < slow_forces.size(); ++cur_force)
+            {
+            const GlobalArray<Scalar4>& d_force_array = slow_forces[cur_force]->getForceArray();
+            ArrayHandle<Scalar4> d_force(d_force_array,access_location::device,access_mode::read);
+            const GlobalArray<Scalar>& d_virial_array = slow_forces[cur_force]->getVirialArray();
+            ArrayHandle<Scalar> d_virial(d_virial_array,access_location::device,access_mode::read);
+            const GlobalArray<Scalar4>& d_torque_array = slow_forces[cur_force]->getTorqueArray();
+            ArrayHandle<Scalar4> d_torque(d_torque_array,access_location::device,access_mode::read);
+
+            PDataFlags flags = this->m_pdata->getFlags();
+
+            m_exec_conf->beginMultiGPU();
+
+            gpu_integrator_add_scaled_force(d_net_force.data,
+                                            d_net_virial.data,
+                                            net_virial_pitch,
+                                            d_net_torque.data,
+                                            d_force.data,
+                                            d_virial.data,
+                                            d_virial_array.getPitch(),
+                                            d_torque.data,
+                                            nparticles,
+                                            Scalar(m_slow_period),
+                                            flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial],
+                                            m_pdata->getGPUPartition());
+
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+
+            m_exec_conf->endMultiGPU();
+            }
         }
 
     // add up external virials and energies
     for (unsigned int cur_force = 0; cur_force < m_forces.size(); cur_force ++)
         {
+        if (!isForceComputed(m_forces[cur_force], timestep))
+            continue;
+
         for (unsigned int k = 0; k < 6; k++)
             external_virial[k] += m_forces[cur_force]->getExternalVirial(k);
         external_energy += m_forces[cur_force]->getExternalEnergy();
@@ -680,8 +872,16 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         m_prof->pop(m_exec_conf);
         }
 
+    // constraints that are fused into an integration method are applied in its second step
+    std::vector< std::shared_ptr<ForceConstraint> > constraint_forces;
+    for (unsigned int i = 0; i < m_constraint_forces.size(); i++)
+        {
+        if (!m_constraint_forces[i]->isFused())
+            constraint_forces.push_back(m_constraint_forces[i]);
+        }
+
     // return early if there are no constraint forces or no HalfStepHook set
-    if (m_constraint_forces.size() == 0)
+    if (constraint_forces.size() == 0)
         return;
 
     #ifdef ENABLE_MPI
@@ -694,7 +894,7 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
 
     // compute all the constraint forces next
     std::vector< std::shared_ptr<ForceConstraint> >::iterator force_constraint;
-    for (force_constraint = m_constraint_forces.begin(); force_constraint != m_constraint_forces.end(); ++force_constraint)
+    for (force_constraint = constraint_forces.begin(); force_constraint != constraint_forces.end(); ++force_constraint)
         (*force_constraint)->compute(timestep);
 
     if (m_prof)
@@ -720,80 +920,80 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         // now, add up the accelerations
         // sum all the forces into the net force
         // perform the sum in groups of 6 to avoid kernel launch and memory access overheads
-        for (unsigned int cur_force = 0; cur_force < m_constraint_forces.size(); cur_force += 6)
+        for (unsigned int cur_force = 0; cur_force < constraint_forces.size(); cur_force += 6)
             {
             // grab the device pointers for the current set
             gpu_force_list force_list;
-            const GlobalArray<Scalar4>& d_force_array0 = m_constraint_forces[cur_force]->getForceArray();
+            const GlobalArray<Scalar4>& d_force_array0 = constraint_forces[cur_force]->getForceArray();
             ArrayHandle<Scalar4> d_force0(d_force_array0,access_location::device,access_mode::read);
-            const GlobalArray<Scalar>& d_virial_array0 = m_constraint_forces[cur_force]->getVirialArray();
+            const GlobalArray<Scalar>& d_virial_array0 = constraint_forces[cur_force]->getVirialArray();
             ArrayHandle<Scalar> d_virial0(d_virial_array0,access_location::device,access_mode::read);
-            const GlobalArray<Scalar4>& d_torque_array0 = m_constraint_forces[cur_force]->getTorqueArray();
+            const GlobalArray<Scalar4>& d_torque_array0 = constraint_forces[cur_force]->getTorqueArray();
             ArrayHandle<Scalar4> d_torque0(d_torque_array0,access_location::device,access_mode::read);
             force_list.f0 = d_force0.data;
             force_list.t0=d_torque0.data;
             force_list.v0 = d_virial0.data;
             force_list.vpitch0 = d_virial_array0.getPitch();
 
-            if (cur_force+1 < m_constraint_forces.size())
+            if (cur_force+1 < constraint_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array1 = m_constraint_forces[cur_force+1]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array1 = constraint_forces[cur_force+1]->getForceArray();
                 ArrayHandle<Scalar4> d_force1(d_force_array1,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array1 = m_constraint_forces[cur_force+1]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array1 = constraint_forces[cur_force+1]->getVirialArray();
                 ArrayHandle<Scalar> d_virial1(d_virial_array1,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array1 = m_constraint_forces[cur_force + 1]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array1 = constraint_forces[cur_force + 1]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque1(d_torque_array1,access_location::device,access_mode::read);
                 force_list.f1 = d_force1.data;
                 force_list.t1=d_torque1.data;
                 force_list.v1 = d_virial1.data;
                 force_list.vpitch1 = d_virial_array1.getPitch();
                 }
-            if (cur_force+2 < m_constraint_forces.size())
+            if (cur_force+2 < constraint_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array2 = m_constraint_forces[cur_force+2]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array2 = constraint_forces[cur_force+2]->getForceArray();
                 ArrayHandle<Scalar4> d_force2(d_force_array2,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array2 = m_constraint_forces[cur_force+2]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array2 = constraint_forces[cur_force+2]->getVirialArray();
                 ArrayHandle<Scalar> d_virial2(d_virial_array2,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array2 = m_constraint_forces[cur_force + 2]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array2 = constraint_forces[cur_force + 2]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque2(d_torque_array2,access_location::device,access_mode::read);
                 force_list.f2 = d_force2.data;
                 force_list.t2=d_torque2.data;
                 force_list.v2 = d_virial2.data;
                 force_list.vpitch2 = d_virial_array2.getPitch();
                 }
-            if (cur_force+3 < m_constraint_forces.size())
+            if (cur_force+3 < constraint_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array3 = m_constraint_forces[cur_force+3]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array3 = constraint_forces[cur_force+3]->getForceArray();
                 ArrayHandle<Scalar4> d_force3(d_force_array3,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array3 = m_constraint_forces[cur_force+3]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array3 = constraint_forces[cur_force+3]->getVirialArray();
                 ArrayHandle<Scalar> d_virial3(d_virial_array3,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array3 = m_constraint_forces[cur_force + 3]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array3 = constraint_forces[cur_force + 3]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque3(d_torque_array3,access_location::device,access_mode::read);
                 force_list.f3 = d_force3.data;
                 force_list.t3=d_torque3.data;
                 force_list.v3 = d_virial3.data;
                 force_list.vpitch3 = d_virial_array3.getPitch();
                 }
-            if (cur_force+4 < m_constraint_forces.size())
+            if (cur_force+4 < constraint_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array4 = m_constraint_forces[cur_force+4]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array4 = constraint_forces[cur_force+4]->getForceArray();
                 ArrayHandle<Scalar4> d_force4(d_force_array4,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array4 = m_constraint_forces[cur_force+4]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array4 = constraint_forces[cur_force+4]->getVirialArray();
                 ArrayHandle<Scalar> d_virial4(d_virial_array4,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array4 = m_constraint_forces[cur_force + 4]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array4 = constraint_forces[cur_force + 4]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque4(d_torque_array4,access_location::device,access_mode::read);
                 force_list.f4 = d_force4.data;
                 force_list.t4=d_torque4.data;
                 force_list.v4 = d_virial4.data;
                 force_list.vpitch4 = d_virial_array4.getPitch();
                 }
-            if (cur_force+5 < m_constraint_forces.size())
+            if (cur_force+5 < constraint_forces.size())
                 {
-                const GlobalArray<Scalar4>& d_force_array5 = m_constraint_forces[cur_force+5]->getForceArray();
+                const GlobalArray<Scalar4>& d_force_array5 = constraint_forces[cur_force+5]->getForceArray();
                 ArrayHandle<Scalar4> d_force5(d_force_array5,access_location::device,access_mode::read);
-                const GlobalArray<Scalar>& d_virial_array5 = m_constraint_forces[cur_force+5]->getVirialArray();
+                const GlobalArray<Scalar>& d_virial_array5 = constraint_forces[cur_force+5]->getVirialArray();
                 ArrayHandle<Scalar> d_virial5(d_virial_array5,access_location::device,access_mode::read);
-                const GlobalArray<Scalar4>& d_torque_array5 = m_constraint_forces[cur_force + 5]->getTorqueArray();
+                const GlobalArray<Scalar4>& d_torque_array5 = constraint_forces[cur_force + 5]->getTorqueArray();
                 ArrayHandle<Scalar4> d_torque5(d_torque_array5,access_location::device,access_mode::read);
                 force_list.f5 = d_force5.data;
                 force_list.t5=d_torque5.data;
@@ -827,11 +1027,11 @@ void Integrator::computeNetForceGPU(unsigned int timestep)
         }
 
     // add up external virials
-    for (unsigned int cur_force = 0; cur_force < m_constraint_forces.size(); cur_force ++)
+    for (unsigned int cur_force = 0; cur_force < constraint_forces.size(); cur_force ++)
         {
         for (unsigned int k = 0; k < 6; k++)
-            external_virial[k] += m_constraint_forces[cur_force]->getExternalVirial(k);
-        external_energy += m_constraint_forces[cur_force]->getExternalEnergy();
+            external_virial[k] += constraint_forces[cur_force]->getExternalVirial(k);
+        external_energy += constraint_forces[cur_force]->getExternalEnergy();
         }
 
     for (unsigned int k = 0; k < 6; k++)
@@ -855,6 +1055,42 @@ void Integrator::update(unsigned int timestep)
     {
     }
 
+/*! Forces that skip their energies on a time step add zero to the energy in the net force. The skipped energies are
+    recomputed and added to the net force when the net energy is read through ParticleData::validateNetEnergy().
+*/
+void Integrator::validateNetEnergy()
+    {
+    if (m_skipped_energies.size() == 0)
+        return;
+
+    std::vector< std::shared_ptr<ForceCompute> > skipped;
+    skipped.swap(m_skipped_energies);
+
+    // recompute the energies before the net force is accessed
+    std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
+    for (force_compute = skipped.begin(); force_compute != skipped.end(); ++force_compute)
+        (*force_compute)->validateEnergies();
+
+    ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
+    unsigned int N = m_pdata->getN();
+
+    for (force_compute = skipped.begin(); force_compute != skipped.end(); ++force_compute)
+        {
+        ArrayHandle<Scalar4> h_force((*force_compute)->getForceArray(), access_location::host, access_mode::read);
+        for (unsigned int j = 0; j < N; j++)
+            h_net_force.data[j].w += h_force.data[j].w;
+        }
+    }
+
+/*! The energies skipped in an earlier summation are no longer needed once the net force is summed again. This also
+    holds for the summation of another integrator, which is notified before the net force is overwritten.
+*/
+void Integrator::resetSkippedEnergies()
+    {
+    m_skipped_energies.clear();
+    m_pdata->validateNetEnergy();
+    }
+
 /*! prepRun() is to be called at the very beginning of each run, before any analyzers are called, but after the full
     simulation is defined. It allows the integrator to perform any one-off setup tasks and update net_force and
     net_virial, if needed.
@@ -881,7 +1117,10 @@ CommFlags Integrator::determineFlags(unsigned int timestep)
     // query all forces
     std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
     for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        flags |= (*force_compute)->getRequestedCommFlags(timestep);
+        {
+        if (isForceComputed(*force_compute, timestep))
+            flags |= (*force_compute)->getRequestedCommFlags(timestep);
+        }
 
     // query all constraints
     std::vector< std::shared_ptr<ForceConstraint> >::iterator force_constraint;
@@ -891,6 +1130,32 @@ CommFlags Integrator::determineFlags(unsigned int timestep)
     return flags;
     }
 
+/*! The pairs with ghosts are only evaluated on one rank in the half-shell ghost exchange, every force must then add
+    its force to the ghosts. The constraint forces are not supported, since they need the complete net force of the
+    ghosts.
+*/
+void Integrator::checkHalfShell()
+    {
+    if (!m_comm || !m_comm->getHalfShell())
+        return;
+
+    if (m_constraint_forces.size() > 0)
+        {
+        m_exec_conf->msg->error() << "Constraint forces are not supported with the half-shell ghost exchange" << endl;
+        throw runtime_error("Error initializing integrator");
+        }
+
+    std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
+    for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
+        {
+        if (!(*force_compute)->supportsHalfShell())
+            {
+            m_exec_conf->msg->error() << "A force in the system does not support the half-shell ghost exchange"
+                                      << endl;
+            throw runtime_error("Error initializing integrator");
+            }
+        }
+    }
 
 void Integrator::setCommunicator(std::shared_ptr<Communicator> comm)
     {
@@ -915,7 +1180,10 @@ void Integrator::computeCallback(unsigned int timestep)
     std::vector< std::shared_ptr<ForceCompute> >::iterator force_compute;
 
     for (force_compute = m_forces.begin(); force_compute != m_forces.end(); ++force_compute)
-        (*force_compute)->preCompute(timestep);
+        {
+        if (isForceComputed(*force_compute, timestep))
+            (*force_compute)->preCompute(timestep);
+        }
     }
 #endif
 
@@ -945,6 +1213,9 @@ void export_Integrator(py::module& m)
     .def("setHalfStepHook", &Integrator::setHalfStepHook)
     .def("removeForceComputes", &Integrator::removeForceComputes)
     .def("removeHalfStepHook", &Integrator::removeHalfStepHook)
+    .def("addSlowForceCompute", &Integrator::addSlowForceCompute)
+    .def("removeSlowForceComputes", &Integrator::removeSlowForceComputes)
+    .def("setSlowForcePeriod", &Integrator::setSlowForcePeriod)
     .def("setDeltaT", &Integrator::setDeltaT)
     .def("getNDOF", &Integrator::getNDOF)
     .def("getRotationalNDOF", &Integrator::getRotationalNDOF)
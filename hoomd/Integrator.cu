@@ -166,3 +166,130 @@ cudaError_t gpu_integrator_sum_net_force(Scalar4 *d_net_force,
 
     return cudaSuccess;
     }
+
+//! Kernel for adding a scaled force to the net force on the GPU
+/*! The force and torque of a single force compute are multiplied by \a scale and added to \a d_net_force and
+    \a d_net_torque. The energy and virial are added unscaled.
+
+    \param d_net_force Device array holding the net force
+    \param d_net_virial Device array holding the net virial
+    \param net_virial_pitch The pitch of the 2D net_virial array
+    \param d_net_torque Device array holding the net torque
+    \param d_force Force to add
+    \param d_virial Virial to add
+    \param virial_pitch The pitch of the 2D virial array
+    \param d_torque Torque to add
+    \param nwork Number of particles this GPU processes
+    \param scale Factor to multiply the force and torque with
+    \param offset of this GPU in ptls array
+
+    \tparam compute_virial When set to 0, the virial sum is not computed
+*/
+template< unsigned int compute_virial >
+__global__ void gpu_integrator_add_scaled_force_kernel(Scalar4 *d_net_force,
+                                                       Scalar *d_net_virial,
+                                                       const unsigned int net_virial_pitch,
+                                                       Scalar4 *d_net_torque,
+                                                       const Scalar4 *d_force,
+                                                       const Scalar *d_virial,
+                                                       const unsigned int virial_pitch,
+                                                       const Scalar4 *d_torque,
+                                                       unsigned int nwork,
+                                                       Scalar scale,
+                                                       unsigned int offset)
+    {
+    // calculate the index we will be handling
+    int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx < nwork)
+        {
+        idx += offset;
+
+        Scalar4 net_force = d_net_force[idx];
+        Scalar4 net_torque = d_net_torque[idx];
+        Scalar4 f = d_force[idx];
+        Scalar4 t = d_torque[idx];
+
+        net_force.x += scale*f.x;
+        net_force.y += scale*f.y;
+        net_force.z += scale*f.z;
+        net_force.w += f.w;
+
+        net_torque.x += scale*t.x;
+        net_torque.y += scale*t.y;
+        net_torque.z += scale*t.z;
+        net_torque.w += t.w;
+
+        d_net_force[idx] = net_force;
+        d_net_torque[idx] = net_torque;
+
+        if (compute_virial)
+            {
+            for (int i=0; i < 6; i++)
+                d_net_virial[i*net_virial_pitch+idx] += d_virial[i*virial_pitch+idx];
+            }
+        }
+    }
+
+cudaError_t gpu_integrator_add_scaled_force(Scalar4 *d_net_force,
+                                            Scalar *d_net_virial,
+                                            const unsigned int net_virial_pitch,
+                                            Scalar4 *d_net_torque,
+                                            const Scalar4 *d_force,
+                                            const Scalar *d_virial,
+                                            const unsigned int virial_pitch,
+                                            const Scalar4 *d_torque,
+                                            unsigned int nparticles,
+                                            Scalar scale,
+                                            bool compute_virial,
+                                            const GPUPartition& gpu_partition)
+    {
+    // sanity check
+    assert(d_net_force);
+    assert(d_net_virial);
+    assert(d_net_torque);
+    assert(d_force);
+    assert(d_virial);
+    assert(d_torque);
+
+    const int block_size = 256;
+
+    // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
+    for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        auto range = gpu_partition.getRangeAndSetGPU(idev);
+
+        unsigned int nwork = range.second - range.first;
+
+        if (compute_virial)
+            {
+            gpu_integrator_add_scaled_force_kernel<1><<< nwork/block_size+1, block_size >>>(d_net_force,
+                                                                                                 d_net_virial,
+                                                                                                 net_virial_pitch,
+                                                                                                 d_net_torque,
+                                                                                                 d_force,
+                                                                                                 d_virial,
+                                                                                                 virial_pitch,
+                                                                                                 d_torque,
+                                                                                                 nwork,
+                                                                                                 scale,
+                                                                                                 range.first);
+            }
+        else
+            {
+            gpu_integrator_add_scaled_force_kernel<0><<< nwork/block_size+1, block_size >>>(d_net_force,
+                                                                                                 d_net_virial,
+                                                                                                 net_virial_pitch,
+                                                                                                 d_net_torque,
+                                                                                                 d_force,
+                                                                                                 d_virial,
+                                                                                                 virial_pitch,
+                                                                                                 d_torque,
+                                                                                                 nwork,
+                                                                                                 scale,
+                                                                                                 range.first);
+            }
+        }
+
+    return cudaSuccess;
+    }
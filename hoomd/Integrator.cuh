@@ -70,4 +70,18 @@ cudaError_t gpu_integrator_sum_net_force(Scalar4 *d_net_force,
                                          bool compute_virial,
                                          const GPUPartition& gpu_partition);
 
+//! Driver for gpu_integrator_add_scaled_force_kernel()
+cudaError_t gpu_integrator_add_scaled_force(Scalar4 *d_net_force,
+                                            Scalar *d_net_virial,
+                                            const unsigned int net_virial_pitch,
+                                            Scalar4 *d_net_torque,
+                                            const Scalar4 *d_force,
+                                            const Scalar *d_virial,
+                                            const unsigned int virial_pitch,
+                                            const Scalar4 *d_torque,
+                                            unsigned int nparticles,
+                                            Scalar scale,
+                                            bool compute_virial,
+                                            const GPUPartition& gpu_partition);
+
 #endif
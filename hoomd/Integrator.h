@@ -20,6 +20,7 @@
 #include "ForceConstraint.h"
 #include "HalfStepHook.h"
 #include "ParticleGroup.h"
+#include <algorithm>
 #include <string>
 #include <vector>
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
@@ -50,6 +51,13 @@
     via the constraint forces can be totaled up with a call to getNDOFRemoved for convenience in derived classes
     implementing correct counting in getNDOF().
 
+    A subset of the forces can be marked as slow with addSlowForceCompute(). Slow forces are only evaluated on every
+    m_slow_period-th step, when they are added to the net force multiplied by m_slow_period (and not at all on the
+    steps in between). With velocity Verlet integration methods this is the impulse form of r-RESPA multiple time
+    stepping: the slow forces kick the velocities by half an outer step (m_slow_period*deltaT) at both ends of the
+    outer step, while the remaining forces are integrated with the inner step deltaT. The energies and virials of the
+    slow forces are added unscaled, and only on outer steps.
+
     Integrators take "ownership" of the particle's accelerations. Any other updater
     that modifies the particles accelerations will produce undefined results. If
     accelerations are to be modified, they must be done through forces, and added to
@@ -90,6 +98,15 @@ class PYBIND11_EXPORT Integrator : public Updater
         //! Removes HalfStepHook
         virtual void removeHalfStepHook();
 
+        //! Mark a ForceCompute as slow, to be evaluated only every m_slow_period steps
+        void addSlowForceCompute(std::shared_ptr<ForceCompute> fc);
+
+        //! Mark all ForceComputes as fast again
+        void removeSlowForceComputes();
+
+        //! Set the number of inner steps per evaluation of the slow forces
+        void setSlowForcePeriod(unsigned int period);
+
         //! Change the timestep
         virtual void setDeltaT(Scalar deltaT);
 
@@ -147,10 +164,28 @@ class PYBIND11_EXPORT Integrator : public Updater
 
         std::shared_ptr<HalfStepHook> m_half_step_hook;    //!< The HalfStepHook, if active
 
+        std::vector< std::shared_ptr<ForceCompute> > m_slow_forces; //!< Forces only evaluated every m_slow_period steps
+        unsigned int m_slow_period;                                 //!< Number of inner steps per slow force evaluation
+
+        //! Test if a ForceCompute is marked as slow
+        bool isSlowForce(const std::shared_ptr<ForceCompute>& fc) const
+            {
+            return std::find(m_slow_forces.begin(), m_slow_forces.end(), fc) != m_slow_forces.end();
+            }
+
+        //! Test if a force is evaluated on a given time step
+        bool isForceComputed(const std::shared_ptr<ForceCompute>& fc, unsigned int timestep) const
+            {
+            return (timestep % m_slow_period) == 0 || !isSlowForce(fc);
+            }
+
 
         //! helper function to compute initial accelerations
         void computeAccelerations(unsigned int timestep);
 
+        //! Zero the net force and evaluate the forces that accumulate into it directly
+        bool computeAccumulatedForces(unsigned int timestep);
+
         //! helper function to compute net force/virial
         void computeNetForce(unsigned int timestep);
 
@@ -162,12 +197,23 @@ class PYBIND11_EXPORT Integrator : public Updater
 #ifdef ENABLE_MPI
         //! helper function to determine the ghost communication flags
         CommFlags determineFlags(unsigned int timestep);
+
+        //! Check that all forces support the half-shell ghost exchange when it is used
+        void checkHalfShell();
 #endif
 
         //! Helper function to determine (an-)isotropic integration mode
         bool getAnisotropic();
 
     private:
+        std::vector< std::shared_ptr<ForceCompute> > m_skipped_energies; //!< Forces summed without their energies
+
+        //! Complete the potential energy in the net force
+        void validateNetEnergy();
+
+        //! Prepare the list of forces that skip their energies in the net force summation
+        void resetSkippedEnergies();
+
         #ifdef ENABLE_MPI
         bool m_request_flags_connected = false;     //!< Connection to Communicator to request communication flags
         bool m_signals_connected = false;                           //!< Track if we have already connected signals
@@ -32,7 +32,7 @@ LoadBalancer::LoadBalancer(std::shared_ptr<SystemDefinition> sysdef,
                            std::shared_ptr<DomainDecomposition> decomposition)
         : Updater(sysdef), m_decomposition(decomposition), m_mpi_comm(m_exec_conf->getMPICommunicator()),
           m_max_imbalance(Scalar(1.0)), m_recompute_max_imbalance(true), m_needs_migrate(false),
-          m_needs_recount(false), m_tolerance(Scalar(1.05)), m_maxiter(1), m_max_scale(Scalar(0.05)),
+          m_needs_recount(false), m_total_load(m_pdata->getNGlobal()), m_tolerance(Scalar(1.05)), m_maxiter(1), m_nbins(0), m_max_scale(Scalar(0.05)),
           m_N_own(m_pdata->getN()), m_max_max_imbalance(1.0), m_total_max_imbalance(0.0), m_n_calls(0),
           m_n_iterations(0), m_n_rebalances(0)
     {
@@ -54,17 +54,37 @@ LoadBalancer::~LoadBalancer()
  * \param timestep Current time step of the simulation
  *
  * Computes the load imbalance along each slice and adjusts the domain boundaries. This process is repeated iteratively
- * in each dimension taking into account the adjusted boundaries each time.
+ * in each dimension taking into account the adjusted boundaries each time. With histogram bins, all dimensions are
+ * adjusted at once in each iteration instead (see adjustHistograms()).
  */
 void LoadBalancer::update(unsigned int timestep)
     {
     // we need a communicator, but don't want to check for it in release builds
     assert(m_comm);
 
+    // skip the balancing if the ranks spend about the same time computing
+    if (m_timing)
+        {
+        m_timing->compute(timestep);
+        if (m_timing->getImbalance() <= m_tolerance)
+            return;
+        }
+
     if (m_prof) m_prof->push(m_exec_conf, "balance");
 
-    // no adjustment has been made yet, so set m_N_own to the number of particles on the rank
-    resetNOwn(m_pdata->getN());
+    // no adjustment has been made yet, so set m_N_own to the load of the particles on the rank
+    const bool weighted = !m_cost_computes.empty();
+    if (weighted)
+        {
+        double load = computeParticleCost();
+        MPI_Allreduce(&load, &m_total_load, 1, MPI_DOUBLE, MPI_SUM, m_mpi_comm);
+        resetNOwn(load);
+        }
+    else
+        {
+        m_total_load = m_pdata->getNGlobal();
+        resetNOwn(m_pdata->getN());
+        }
 
     // figure out which rank is the reduction root for broadcasting
     const Index3D& di = m_decomposition->getDomainIndexer();
@@ -89,7 +109,12 @@ void LoadBalancer::update(unsigned int timestep)
         // increment the number of attempted balances
         ++m_n_iterations;
 
-        for (unsigned int dim=0; dim < m_sysdef->getNDimensions() && getMaxImbalance() > m_tolerance; ++dim)
+        if (m_nbins > 0)
+            {
+            adjustHistograms(min_domain_frac, reduce_root);
+            }
+
+        for (unsigned int dim=0; dim < m_sysdef->getNDimensions() && m_nbins == 0 && getMaxImbalance() > m_tolerance; ++dim)
             {
             Scalar L_i(0.0);
             Scalar min_frac_i(0.0);
@@ -112,10 +137,10 @@ void LoadBalancer::update(unsigned int timestep)
                 min_frac_i = min_domain_frac.z;
                 }
 
-            vector<unsigned int> N_i;
+            vector<Scalar> N_i;
             bool adjusted = false;
 
-            // reduce the number of particles in the slice along dim
+            // reduce the load in the slice along dim
             bool active = reduce(N_i, dim, reduce_root);
 
             // attempt an adjustment
@@ -147,6 +172,10 @@ void LoadBalancer::update(unsigned int timestep)
 
             // increment the number of rebalances actually performed
             ++m_n_rebalances;
+
+            // the costs of the particles received in the migration are not known
+            if (weighted)
+                break;
             }
         }
 
@@ -154,13 +183,14 @@ void LoadBalancer::update(unsigned int timestep)
     }
 
 /*!
- * Computes the imbalance factor I = N / <N> for each rank, and computes the maximum among all ranks.
+ * Computes the imbalance factor I = N / <N> for each rank, and computes the maximum among all ranks. With cost
+ * computes, N is the summed cost of the particles on the rank.
  */
 Scalar LoadBalancer::getMaxImbalance()
     {
     if (m_recompute_max_imbalance)
         {
-        Scalar cur_imb = Scalar(getNOwn()) / (Scalar(m_pdata->getNGlobal()) / Scalar(m_exec_conf->getNRanks()));
+        Scalar cur_imb = Scalar(getNOwn() / (m_total_load / double(m_exec_conf->getNRanks())));
         Scalar max_imb(0.0);
         MPI_Allreduce(&cur_imb, &max_imb, 1, MPI_HOOMD_SCALAR, MPI_MAX, m_mpi_comm);
 
@@ -175,12 +205,12 @@ Scalar LoadBalancer::getMaxImbalance()
     }
 
 /*!
- * \param N_i Vector holding the total number of particles in each slice (will be allocated on call)
+ * \param N_i Vector holding the total load in each slice (will be allocated on call)
  * \param dim The dimension of the slices (x=0, y=1, z=2)
  * \param reduce_root The rank to perform the reduction on
  * \returns true if the current rank holds the active \a N_i
  *
- * \post \a N_i holds the number of particles in each slice along \a dim
+ * \post \a N_i holds the load (number or cost of particles) in each slice along \a dim
  *
  * \note reduce() relies on collective MPI calls, and so all ranks must call it. However, for efficiency the data will
  *       be active only on Cartesian rank \a reduce_root, as indicated by the return value. As a result, only \a reduce_root
@@ -191,18 +221,18 @@ Scalar LoadBalancer::getMaxImbalance()
  * down dimensions. Generally, load balancing should not be performed too frequently, and so we do not pursue this
  * optimization right now.
  */
-bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsigned int reduce_root)
+bool LoadBalancer::reduce(std::vector<Scalar>& N_i, unsigned int dim, unsigned int reduce_root)
     {
     // do nothing if there is only one rank
     if (N_i.size() == 1) return false;
 
     const Index3D& di = m_decomposition->getDomainIndexer();
-    std::vector<unsigned int> N_per_rank(di.getNumElements());
+    std::vector<double> N_per_rank(di.getNumElements());
 
-    // get the number of particles the current rank owns (the quantity to be reduced)
-    unsigned int N_own = getNOwn();
+    // get the load the current rank owns (the quantity to be reduced)
+    double N_own = getNOwn();
 
-    MPI_Gather(&N_own, 1, MPI_UNSIGNED, &N_per_rank[0], 1, MPI_UNSIGNED, reduce_root, m_mpi_comm);
+    MPI_Gather(&N_own, 1, MPI_DOUBLE, &N_per_rank[0], 1, MPI_DOUBLE, reduce_root, m_mpi_comm);
 
     // only the root rank performs the reduction
     if (m_exec_conf->getRank() != reduce_root)
@@ -210,7 +240,7 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
 
     // rearrange the data from ranks to cartesian order in case it is jumbled around
     ArrayHandle<unsigned int> h_cart_ranks_inv(m_decomposition->getInverseCartRanks(), access_location::host, access_mode::read);
-    std::vector<unsigned int> N_per_cart_rank(di.getNumElements());
+    std::vector<double> N_per_cart_rank(di.getNumElements());
     for (unsigned int cur_rank=0; cur_rank < di.getNumElements(); ++cur_rank)
         {
         N_per_cart_rank[h_cart_ranks_inv.data[cur_rank]] = N_per_rank[cur_rank];
@@ -273,7 +303,7 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
 
 /*!
  * \param cum_frac_i The cumulative fraction array to write output into
- * \param N_i The reduced number of particles along the dimension
+ * \param N_i The reduced load along the dimension
  * \param L_i The global box length along the dimension
  * \param min_frac_i The minimum fractional width of a domain
  *
@@ -291,15 +321,15 @@ bool LoadBalancer::reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsi
  *     successful, apply the adjustment to \a cum_frac_i.
  */
 bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
-                          const vector<unsigned int>& N_i,
+                          const vector<Scalar>& N_i,
                           Scalar L_i,
                           Scalar min_frac_i)
     {
     if (N_i.size() == 1)
         return false;
 
-    // target particles per rank is uniform distribution
-    const Scalar target = Scalar(m_pdata->getNGlobal()) / Scalar(N_i.size());
+    // target load per rank is uniform distribution
+    const Scalar target = Scalar(m_total_load / double(N_i.size()));
 
     // make the minimum domain slightly bigger so that the optimization won't fail at equality
     const Scalar min_domain_size = Scalar(1.00001) * min_frac_i * L_i;
@@ -417,82 +447,302 @@ bool LoadBalancer::adjust(vector<Scalar>& cum_frac_i,
     }
 
 /*!
- * \param cnts Map holding result of number of particles on each rank that neighbors the local rank
+ * \param min_domain_frac The minimum fractional width of a domain along each dimension
+ * \param reduce_root The rank that broadcasts the new cumulative fractions
+ *
+ * The histograms of all dimensions are reduced with a single MPI_Allreduce, so that every rank holds the global load
+ * distribution. The adjustment is computed by all ranks, but is taken from \a reduce_root so that the domain
+ * boundaries agree bit for bit.
  */
-void LoadBalancer::countParticlesOffRank(std::map<unsigned int, unsigned int>& cnts)
+void LoadBalancer::adjustHistograms(const Scalar3& min_domain_frac, unsigned int reduce_root)
     {
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_cart_ranks(m_decomposition->getCartRanks(), access_location::host, access_mode::read);
-
-    const BoxDim& box = m_pdata->getBox();
     const Index3D& di = m_decomposition->getDomainIndexer();
-    const uint3 rank_pos = m_decomposition->getGridPos();
+    const unsigned int n_domains[3] = {di.getW(), di.getH(), di.getD()};
+    const bool enable[3] = {m_enable_x, m_enable_y, m_enable_z};
+    const Scalar min_frac[3] = {min_domain_frac.x, min_domain_frac.y, min_domain_frac.z};
 
-    for (unsigned int cur_p=0; cur_p < m_pdata->getN(); ++cur_p)
+    vector<double> hist(3*m_nbins, 0.0);
+    computeHistograms(hist);
+    MPI_Allreduce(MPI_IN_PLACE, &hist[0], 3*m_nbins, MPI_DOUBLE, MPI_SUM, m_mpi_comm);
+
+    bool adjusted = false;
+    for (unsigned int dim=0; dim < m_sysdef->getNDimensions(); ++dim)
         {
-        const Scalar4 cur_postype = h_pos.data[cur_p];
-        const Scalar3 cur_pos = make_scalar3(cur_postype.x, cur_postype.y, cur_postype.z);
-        const Scalar3 f = box.makeFraction(cur_pos);
+        // skip this dimension if balancing is turned off
+        if (!enable[dim] || n_domains[dim] == 1) continue;
 
-        int3 grid_pos = make_int3(rank_pos.x, rank_pos.y, rank_pos.z);
+        vector<Scalar> cum_frac = m_decomposition->getCumulativeFractions(dim);
+        bool adjusted_dim = adjustHistogram(cum_frac, &hist[dim*m_nbins], min_frac[dim]);
 
-        bool moved(false);
-        if (f.x >= Scalar(1.0))
-            {
-            ++grid_pos.x;
-            moved = true;
-            }
-        if (f.x < Scalar(0.0))
+        // all ranks must agree on the adjustment for the collective update of the fractions
+        bcast(adjusted_dim, reduce_root, m_mpi_comm);
+        if (adjusted_dim)
             {
-            --grid_pos.x;
-            moved = true;
+            m_decomposition->setCumulativeFractions(dim, cum_frac, reduce_root);
+            adjusted = true;
             }
+        }
+
+    if (adjusted)
+        {
+        m_pdata->setGlobalBox(m_pdata->getGlobalBox()); // force a domain resizing to trigger
+        signalResize();
+        }
+    }
+
+/*!
+ * \param cum_frac_i The cumulative fraction array to write output into
+ * \param hist_i The global load histogram along the dimension (m_nbins bins)
+ * \param min_frac_i The minimum fractional width of a domain
+ *
+ * \returns true if an adjustment occurred
+ *
+ * Each boundary is placed where the cumulative load reaches its share of the total load, interpolating linearly within
+ * a bin. The boundary is then limited to move at most half of the width of its neighboring domains, and the domains are
+ * widened to the minimum width, first sweeping up and then down the dimension. The adjustment is rejected if the
+ * constraints cannot be satisfied together.
+ */
+bool LoadBalancer::adjustHistogram(vector<Scalar>& cum_frac_i,
+                                   const double *hist_i,
+                                   Scalar min_frac_i)
+    {
+    const unsigned int n = cum_frac_i.size() - 1;
+    if (n == 1)
+        return false;
+
+    const double total = std::accumulate(hist_i, hist_i + m_nbins, 0.0);
+    if (total <= 0.0)
+        return false;
+
+    // make the minimum domain slightly bigger so that the constraints are not violated by round-off
+    const Scalar min_width = Scalar(1.00001) * min_frac_i;
+    // if system is overconstrained (exactly decomposed) don't do any adjusting
+    if (min_width * Scalar(n) >= Scalar(1.0))
+        return false;
 
-        if (f.y >= Scalar(1.0))
+    // place the boundaries at the quantiles of the load
+    vector<Scalar> new_frac(cum_frac_i);
+    unsigned int cur_bin = 0;
+    double cum_load = 0.0;
+    for (unsigned int j=1; j < n; ++j)
+        {
+        const double target = total * double(j) / double(n);
+        while (cur_bin < m_nbins && cum_load + hist_i[cur_bin] < target)
             {
-            ++grid_pos.y;
-            moved = true;
+            cum_load += hist_i[cur_bin++];
             }
-        if (f.y < Scalar(0.0))
+
+        double x = 1.0;
+        if (cur_bin < m_nbins)
             {
-            --grid_pos.y;
-            moved = true;
+            const double in_bin = (hist_i[cur_bin] > 0.0) ? (target - cum_load) / hist_i[cur_bin] : 0.0;
+            x = (double(cur_bin) + in_bin) / double(m_nbins);
             }
 
-        if (f.z >= Scalar(1.0))
+        // the boundary can move at most half the width of its neighbors
+        const Scalar lo = Scalar(0.5) * (cum_frac_i[j-1] + cum_frac_i[j]);
+        const Scalar hi = Scalar(0.5) * (cum_frac_i[j] + cum_frac_i[j+1]);
+        new_frac[j] = std::min(std::max(Scalar(x), lo), hi);
+        }
+
+    // enforce the minimum domain width
+    for (unsigned int j=1; j < n; ++j)
+        {
+        new_frac[j] = std::max(new_frac[j], new_frac[j-1] + min_width);
+        }
+    for (unsigned int j=n-1; j > 0; --j)
+        {
+        new_frac[j] = std::min(new_frac[j], new_frac[j+1] - min_width);
+        }
+
+    // validate the adjustment and check if anything moved
+    bool changed = false;
+    for (unsigned int j=1; j < n; ++j)
+        {
+        const Scalar lo = Scalar(0.5) * (cum_frac_i[j-1] + cum_frac_i[j]);
+        const Scalar hi = Scalar(0.5) * (cum_frac_i[j] + cum_frac_i[j+1]);
+        if (new_frac[j] < lo || new_frac[j] > hi)
             {
-            ++grid_pos.z;
-            moved = true;
+            m_exec_conf->msg->warning() << "comm.balance: no convergence, domains too small" << endl;
+            return false;
             }
-        if (f.z < Scalar(0.0))
+        if (new_frac[j] - new_frac[j-1] < min_frac_i || new_frac[j+1] - new_frac[j] < min_frac_i)
             {
-            --grid_pos.z;
-            moved = true;
+            m_exec_conf->msg->warning() << "comm.balance: no convergence, domains too small" << endl;
+            return false;
             }
+        if (new_frac[j] != cum_frac_i[j])
+            changed = true;
+        }
 
-        if (moved)
-            {
-            if (grid_pos.x == (int)di.getW())
-                grid_pos.x = 0;
-            else if (grid_pos.x < 0)
-                grid_pos.x += di.getW();
-
-            if (grid_pos.y == (int)di.getH())
-                grid_pos.y = 0;
-            else if (grid_pos.y < 0)
-                grid_pos.y += di.getH();
-
-            if (grid_pos.z == (int)di.getD())
-                grid_pos.z = 0;
-            else if (grid_pos.z < 0)
-                grid_pos.z += di.getD();
-
-            unsigned int cur_rank = h_cart_ranks.data[di(grid_pos.x,grid_pos.y,grid_pos.z)];
+    if (changed)
+        cum_frac_i = new_frac;
+    return changed;
+    }
+
+/*!
+ * \param hist Histograms of the load along x, y, and z, m_nbins bins each and initialized to zero (output)
+ *
+ * The bins divide the fractional coordinates of the global box. Each particle contributes its cost, or 1 without cost
+ * computes.
+ */
+void LoadBalancer::computeHistograms(std::vector<double>& hist)
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    const bool weighted = !m_cost_computes.empty();
+    assert(!weighted || m_particle_cost.size() == m_pdata->getN());
+
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    const int max_bin = m_nbins - 1;
+    for (unsigned int cur_p=0; cur_p < m_pdata->getN(); ++cur_p)
+        {
+        const Scalar4 postype = h_pos.data[cur_p];
+        const Scalar3 f = global_box.makeFraction(make_scalar3(postype.x, postype.y, postype.z));
+        const double load = weighted ? double(m_particle_cost[cur_p]) : 1.0;
+
+        const int bin_x = std::min(std::max(int(f.x * Scalar(m_nbins)), 0), max_bin);
+        const int bin_y = std::min(std::max(int(f.y * Scalar(m_nbins)), 0), max_bin);
+        const int bin_z = std::min(std::max(int(f.z * Scalar(m_nbins)), 0), max_bin);
+        hist[bin_x] += load;
+        hist[m_nbins + bin_y] += load;
+        hist[2*m_nbins + bin_z] += load;
+        }
+    }
+
+/*!
+ * \param postype Position of the particle
+ * \param box The local box
+ * \param cart_ranks Map from cartesian grid index to rank
+ * \param rank The rank the particle would be sent to (output)
+ * \returns true if the particle has gone off the rank
+ */
+bool LoadBalancer::getOffRank(const Scalar4& postype,
+                              const BoxDim& box,
+                              const unsigned int *cart_ranks,
+                              unsigned int& rank)
+    {
+    const Index3D& di = m_decomposition->getDomainIndexer();
+    const uint3 rank_pos = m_decomposition->getGridPos();
+
+    const Scalar3 cur_pos = make_scalar3(postype.x, postype.y, postype.z);
+    const Scalar3 f = box.makeFraction(cur_pos);
+
+    int3 grid_pos = make_int3(rank_pos.x, rank_pos.y, rank_pos.z);
+
+    bool moved(false);
+    if (f.x >= Scalar(1.0))
+        {
+        ++grid_pos.x;
+        moved = true;
+        }
+    if (f.x < Scalar(0.0))
+        {
+        --grid_pos.x;
+        moved = true;
+        }
+
+    if (f.y >= Scalar(1.0))
+        {
+        ++grid_pos.y;
+        moved = true;
+        }
+    if (f.y < Scalar(0.0))
+        {
+        --grid_pos.y;
+        moved = true;
+        }
+
+    if (f.z >= Scalar(1.0))
+        {
+        ++grid_pos.z;
+        moved = true;
+        }
+    if (f.z < Scalar(0.0))
+        {
+        --grid_pos.z;
+        moved = true;
+        }
+
+    if (!moved)
+        return false;
+
+    if (grid_pos.x == (int)di.getW())
+        grid_pos.x = 0;
+    else if (grid_pos.x < 0)
+        grid_pos.x += di.getW();
+
+    if (grid_pos.y == (int)di.getH())
+        grid_pos.y = 0;
+    else if (grid_pos.y < 0)
+        grid_pos.y += di.getH();
+
+    if (grid_pos.z == (int)di.getD())
+        grid_pos.z = 0;
+    else if (grid_pos.z < 0)
+        grid_pos.z += di.getD();
+
+    rank = cart_ranks[di(grid_pos.x,grid_pos.y,grid_pos.z)];
+    return true;
+    }
+
+/*!
+ * \param cnts Map holding result of number of particles on each rank that neighbors the local rank
+ */
+void LoadBalancer::countParticlesOffRank(std::map<unsigned int, unsigned int>& cnts)
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cart_ranks(m_decomposition->getCartRanks(), access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+    for (unsigned int cur_p=0; cur_p < m_pdata->getN(); ++cur_p)
+        {
+        unsigned int cur_rank;
+        if (getOffRank(h_pos.data[cur_p], box, h_cart_ranks.data, cur_rank))
             cnts[cur_rank]++;
-            }
         }
     }
 
+/*!
+ * \param loads Map holding result of the summed cost of particles on each rank that neighbors the local rank
+ *
+ * \pre computeParticleCost() has been called since the last particle migration
+ */
+void LoadBalancer::weighParticlesOffRank(std::map<unsigned int, double>& loads)
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cart_ranks(m_decomposition->getCartRanks(), access_location::host, access_mode::read);
+    assert(m_particle_cost.size() == m_pdata->getN());
+
+    const BoxDim& box = m_pdata->getBox();
+    for (unsigned int cur_p=0; cur_p < m_pdata->getN(); ++cur_p)
+        {
+        unsigned int cur_rank;
+        if (getOffRank(h_pos.data[cur_p], box, h_cart_ranks.data, cur_rank))
+            loads[cur_rank] += m_particle_cost[cur_p];
+        }
+    }
+
+/*!
+ * \returns The summed cost of the local particles
+ *
+ * Every particle costs 1, plus the contributions of all cost computes.
+ */
+double LoadBalancer::computeParticleCost()
+    {
+    m_particle_cost.assign(m_pdata->getN(), Scalar(1.0));
+    for (unsigned int i=0; i < m_cost_computes.size(); ++i)
+        {
+        m_cost_computes[i]->addParticleCost(m_particle_cost);
+        }
+
+    double load = 0.0;
+    for (unsigned int cur_p=0; cur_p < m_particle_cost.size(); ++cur_p)
+        {
+        load += m_particle_cost[cur_p];
+        }
+    return load;
+    }
+
 /*!
  * Each rank calls countParticlesOffRank() to count the number of particles to send to other ranks. Neighboring ranks
  * then perform send/receive calls, and count the new number of particles they own as the number they owned locally
@@ -509,31 +759,51 @@ void LoadBalancer::computeOwnedParticles()
     ArrayHandle<unsigned int> h_unique_neigh(m_comm->getUniqueNeighbors(), access_location::host, access_mode::read);
 
     // fill the map initially to zeros (not necessary since should be auto-initialized to zero, but just playing it safe)
-    std::map<unsigned int, unsigned int> cnts;
+    std::map<unsigned int, double> loads;
     for (unsigned int i=0; i < m_comm->getNUniqueNeighbors(); ++i)
         {
-        cnts[h_unique_neigh.data[i]] = 0;
+        loads[h_unique_neigh.data[i]] = 0.0;
+        }
+
+    // the load of the rank before the adjustment
+    double N_own = 0.0;
+    if (!m_cost_computes.empty())
+        {
+        weighParticlesOffRank(loads);
+        for (unsigned int cur_p=0; cur_p < m_particle_cost.size(); ++cur_p)
+            N_own += m_particle_cost[cur_p];
+        }
+    else
+        {
+        std::map<unsigned int, unsigned int> cnts;
+        for (unsigned int i=0; i < m_comm->getNUniqueNeighbors(); ++i)
+            {
+            cnts[h_unique_neigh.data[i]] = 0;
+            }
+        countParticlesOffRank(cnts);
+
+        for (std::map<unsigned int, unsigned int>::const_iterator it = cnts.begin(); it != cnts.end(); ++it)
+            loads[it->first] = it->second;
+        N_own = m_pdata->getN();
         }
-    countParticlesOffRank(cnts);
 
     MPI_Request req[2*m_comm->getNUniqueNeighbors()];
     MPI_Status stat[2*m_comm->getNUniqueNeighbors()];
     unsigned int nreq = 0;
 
-    unsigned int n_send_ptls[m_comm->getNUniqueNeighbors()];
-    unsigned int n_recv_ptls[m_comm->getNUniqueNeighbors()];
+    double n_send_ptls[m_comm->getNUniqueNeighbors()];
+    double n_recv_ptls[m_comm->getNUniqueNeighbors()];
     for (unsigned int cur_neigh=0; cur_neigh < m_comm->getNUniqueNeighbors(); ++cur_neigh)
         {
         unsigned int neigh_rank = h_unique_neigh.data[cur_neigh];
-        n_send_ptls[cur_neigh] = cnts[neigh_rank];
+        n_send_ptls[cur_neigh] = loads[neigh_rank];
 
-        MPI_Isend(&n_send_ptls[cur_neigh], 1, MPI_UNSIGNED, neigh_rank, 0, m_mpi_comm, & req[nreq++]);
-        MPI_Irecv(&n_recv_ptls[cur_neigh], 1, MPI_UNSIGNED, neigh_rank, 0, m_mpi_comm, & req[nreq++]);
+        MPI_Isend(&n_send_ptls[cur_neigh], 1, MPI_DOUBLE, neigh_rank, 0, m_mpi_comm, & req[nreq++]);
+        MPI_Irecv(&n_recv_ptls[cur_neigh], 1, MPI_DOUBLE, neigh_rank, 0, m_mpi_comm, & req[nreq++]);
         }
     MPI_Waitall(nreq, req, stat);
 
-    // reduce the particles sent to me
-    int N_own = m_pdata->getN();
+    // reduce the load sent to me
     for (unsigned int cur_neigh = 0; cur_neigh < m_comm->getNUniqueNeighbors(); ++cur_neigh)
         {
         N_own += n_recv_ptls[cur_neigh];
@@ -578,6 +848,11 @@ void export_LoadBalancer(py::module& m)
     .def("setTolerance", &LoadBalancer::setTolerance)
     .def("getMaxIterations", &LoadBalancer::getMaxIterations)
     .def("setMaxIterations", &LoadBalancer::setMaxIterations)
+    .def("getHistogramBins", &LoadBalancer::getHistogramBins)
+    .def("setHistogramBins", &LoadBalancer::setHistogramBins)
+    .def("addCostCompute", &LoadBalancer::addCostCompute)
+    .def("clearCostComputes", &LoadBalancer::clearCostComputes)
+    .def("setTimingCompute", &LoadBalancer::setTimingCompute)
     ;
     }
 #endif // ENABLE_MPI
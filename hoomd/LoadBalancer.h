@@ -18,6 +18,8 @@
 #define __LOADBALANCER_H__
 
 #include "Updater.h"
+#include "Compute.h"
+#include "LoadImbalanceCompute.h"
 
 #include <memory>
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
@@ -38,9 +40,25 @@
  *  2. No domain may be smaller than the minimum size set by the ghost layer.
  *  3. A domain should change size by at most approximately 5% in a single rescaling.
  *
+ * Optionally, the load is weighted by a cost per particle instead of counting particles. The cost of a particle is
+ * 1 plus the contributions of the cost computes (see addCostCompute() and Compute::addParticleCost()), for example
+ * the number of neighbors of the particle in a NeighborList. Loads are summed in double precision. With cost weights,
+ * at most one particle migration is performed per update(), because the costs are only known for the particles
+ * that were local before the migration.
+ *
  * Constraints are satisfied by solving a least-squares problem with box constraints, where the cost function is the
  * deviation of the domain sizes from the proposed rescaled width.
  *
+ * Alternatively, when a number of histogram bins is set (setHistogramBins()), each rank bins the load of its particles
+ * along every axis of the global box, and the histograms of all axes are summed in a single MPI_Allreduce. The new
+ * domain boundaries are then placed directly at the quantiles of the global load, subject to constraints 1. and 2.
+ * Constraint 3. is not needed, because the target is the measured load distribution rather than an extrapolation from
+ * the imbalance factor. A single pass usually balances the load up to the bin width, so that no iterations are needed.
+ *
+ * When a timing compute is set (setTimingCompute()), it is evaluated at every update() and balancing is only attempted
+ * if the measured imbalance of the busy times of the ranks exceeds the tolerance. The domains are still adjusted from
+ * the particle loads, the timings only decide whether an adjustment is worthwhile.
+ *
  * \ingroup updaters
  */
 class PYBIND11_EXPORT LoadBalancer : public Updater
@@ -83,6 +101,21 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
             m_maxiter = maxiter;
             }
 
+        //! Get the number of histogram bins per dimension
+        unsigned int getHistogramBins() const
+            {
+            return m_nbins;
+            }
+
+        //! Set the number of histogram bins per dimension
+        /*!
+         * \param nbins Number of bins along each dimension of the global box, or 0 to balance iteratively
+         */
+        void setHistogramBins(unsigned int nbins)
+            {
+            m_nbins = nbins;
+            }
+
         //! Enable / disable load balancing along a dimension
         /*!
          * \param dim Dimension along which to balance
@@ -100,6 +133,30 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
                 }
             }
 
+        //! Add a compute that estimates the cost of each particle
+        /*!
+         * \param compute Compute whose Compute::addParticleCost() contributes to the cost per particle
+         */
+        void addCostCompute(std::shared_ptr<Compute> compute)
+            {
+            m_cost_computes.push_back(compute);
+            }
+
+        //! Remove all cost computes, so that the load is the number of particles again
+        void clearCostComputes()
+            {
+            m_cost_computes.clear();
+            }
+
+        //! Set the compute that measures the load imbalance from timings
+        /*!
+         * \param timing Compute that decides if balancing is needed, or a null pointer to always balance on the loads
+         */
+        void setTimingCompute(std::shared_ptr<LoadImbalanceCompute> timing)
+            {
+            m_timing = timing;
+            }
+
         //! Take one timestep forward
         virtual void update(unsigned int timestep);
 
@@ -119,8 +176,8 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
         Scalar m_max_imbalance;             //!< Maximum imbalance
         bool m_recompute_max_imbalance;     //!< Flag if maximum imbalance needs to be computed
 
-        //! Reduce the particle numbers per rank down to one dimension
-        bool reduce(std::vector<unsigned int>& N_i, unsigned int dim, unsigned int reduce_root);
+        //! Reduce the loads per rank down to one dimension
+        bool reduce(std::vector<Scalar>& N_i, unsigned int dim, unsigned int reduce_root);
 
         //! Set flags within the class that a resize has been performed
         void signalResize()
@@ -132,29 +189,52 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
 
         //! Adjust the partitioning along a single dimension
         bool adjust(std::vector<Scalar>& cum_frac_i,
-                    const std::vector<unsigned int>& N_i,
+                    const std::vector<Scalar>& N_i,
                     Scalar L_i,
                     Scalar min_domain_frac);
         bool m_needs_migrate;   //!< Flag to signal that migration is necessary
 
-        //! Compute the number of particles on each rank after an adjustment
+        //! Adjust the partitioning along all dimensions from the global load histograms
+        void adjustHistograms(const Scalar3& min_domain_frac, unsigned int reduce_root);
+
+        //! Place the domain boundaries along a single dimension at the quantiles of the load histogram
+        bool adjustHistogram(std::vector<Scalar>& cum_frac_i,
+                             const double *hist_i,
+                             Scalar min_frac_i);
+
+        //! Bin the load of the local particles along each dimension of the global box
+        virtual void computeHistograms(std::vector<double>& hist);
+
+        //! Compute the load on each rank after an adjustment
         void computeOwnedParticles();
 
         //! Count the number of particles that have gone off the rank
         virtual void countParticlesOffRank(std::map<unsigned int, unsigned int>& cnts);
 
-        //! Gets the number of owned particles, updating if necessary
-        unsigned int getNOwn()
+        //! Sum the costs of the particles that have gone off the rank
+        void weighParticlesOffRank(std::map<unsigned int, double>& loads);
+
+        //! Get the rank that a particle belongs to after an adjustment
+        bool getOffRank(const Scalar4& postype,
+                        const BoxDim& box,
+                        const unsigned int *cart_ranks,
+                        unsigned int& rank);
+
+        //! Compute the cost of every local particle, and return the total load of the rank
+        double computeParticleCost();
+
+        //! Gets the load owned by this rank, updating if necessary
+        double getNOwn()
             {
             computeOwnedParticles();
             return m_N_own;
             }
 
-        //! Force a reset of the number of owned particles without counting
+        //! Force a reset of the owned load without counting
         /*!
-         * \param N number of particles owned by the rank
+         * \param N load owned by the rank (the number of particles, or the sum of their costs)
          */
-        void resetNOwn(unsigned int N)
+        void resetNOwn(double N)
             {
             m_N_own = N;
             m_recompute_max_imbalance = true;
@@ -162,16 +242,22 @@ class PYBIND11_EXPORT LoadBalancer : public Updater
             }
         bool m_needs_recount;   //!< Flag if a particle change needs to be computed
 
+        std::vector< std::shared_ptr<Compute> > m_cost_computes; //!< Computes that contribute to the particle cost
+        std::vector<Scalar> m_particle_cost;    //!< Cost per local particle (only used with cost computes)
+        std::shared_ptr<LoadImbalanceCompute> m_timing; //!< Timing compute that decides if balancing is needed
+        double m_total_load;                    //!< Load summed over all ranks
+
         Scalar m_tolerance;     //!< Load imbalance to tolerate
         unsigned int m_maxiter; //!< Maximum number of iterations to attempt
         bool m_enable_x;        //!< Flag to enable balancing in x
         bool m_enable_y;        //!< Flag to enable balancing in y
         bool m_enable_z;        //!< Flag to enable balancing z
+        unsigned int m_nbins;   //!< Number of histogram bins per dimension (0 to balance iteratively)
 
         const Scalar m_max_scale;   //!< Maximum fraction to rescale either direction (5%)
 
     private:
-        unsigned int m_N_own;               //!< Number of particles owned by this rank
+        double m_N_own;                     //!< Load (number of particles or their cost) owned by this rank
 
         Scalar m_max_max_imbalance;     //!< The maximum imbalance of any check
         double m_total_max_imbalance;   //!< The average imbalance over checks
@@ -38,6 +38,7 @@ LoadBalancerGPU::LoadBalancerGPU(std::shared_ptr<SystemDefinition> sysdef,
     m_n_off_rank.swap(n_off_rank);
 
     m_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "load_balance", this->m_exec_conf));
+    m_tuner_hist.reset(new Autotuner(32, 1024, 32, 5, 100000, "load_balance_histogram", this->m_exec_conf));
     }
 
 LoadBalancerGPU::~LoadBalancerGPU()
@@ -117,6 +118,55 @@ void LoadBalancerGPU::countParticlesOffRank(std::map<unsigned int, unsigned int>
         }
     }
 
+/*!
+ * \param hist Histograms of the load along x, y, and z, m_nbins bins each and initialized to zero (output)
+ *
+ * The particles are counted on the GPU. The cost of the particles is only known on the host, so histograms of
+ * the cost are computed by LoadBalancer::computeHistograms().
+ */
+void LoadBalancerGPU::computeHistograms(std::vector<double>& hist)
+    {
+    if (!m_cost_computes.empty())
+        {
+        LoadBalancer::computeHistograms(hist);
+        return;
+        }
+
+    // do nothing if rank doesn't own any particles
+    if (m_pdata->getN() == 0) return;
+
+    if (m_hist.getNumElements() != 3*m_nbins)
+        {
+        GPUArray<unsigned int> hist_counts(3*m_nbins, m_exec_conf);
+        m_hist.swap(hist_counts);
+        }
+
+        {
+        ArrayHandle<unsigned int> d_hist(m_hist, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+
+        // privatize the histogram in shared memory if it fits
+        const bool use_smem = (3*m_nbins*sizeof(unsigned int) <= m_exec_conf->dev_prop.sharedMemPerBlock);
+
+        m_tuner_hist->begin();
+        gpu_load_balance_histogram(d_hist.data,
+                                   d_pos.data,
+                                   m_pdata->getGlobalBox(),
+                                   m_pdata->getN(),
+                                   m_nbins,
+                                   use_smem,
+                                   m_tuner_hist->getParam());
+        if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+        m_tuner_hist->end();
+        }
+
+    ArrayHandle<unsigned int> h_hist(m_hist, access_location::host, access_mode::read);
+    for (unsigned int i=0; i < 3*m_nbins; ++i)
+        {
+        hist[i] = h_hist.data[i];
+        }
+    }
+
 void export_LoadBalancerGPU(py::module& m)
     {
     py::class_<LoadBalancerGPU, std::shared_ptr<LoadBalancerGPU> >(m,"LoadBalancerGPU",py::base<LoadBalancer>())
@@ -109,6 +109,116 @@ void gpu_load_balance_mark_rank(unsigned int *d_ranks,
     gpu_load_balance_mark_rank_kernel<<<n_blocks, run_block_size>>>(d_ranks, d_pos, d_cart_ranks, rank_pos, box, di, N);
     }
 
+//! Count the particles in bins along each dimension of the global box
+/*!
+ * \param d_hist Particle counts per bin along x, y, and z (nbins each)
+ * \param d_pos Particle positions
+ * \param global_box Global box
+ * \param N Number of local particles
+ * \param nbins Number of bins per dimension
+ *
+ * Using a thread per particle, the bin of the particle along each dimension is computed from its fractional coordinate
+ * in the global box. With \a use_smem, each block first accumulates its counts in shared memory, so that only one
+ * global atomic per nonzero bin and block remains.
+ */
+template<bool use_smem>
+__global__ void gpu_load_balance_histogram_kernel(unsigned int *d_hist,
+                                                  const Scalar4 *d_pos,
+                                                  const BoxDim global_box,
+                                                  const unsigned int N,
+                                                  const unsigned int nbins)
+    {
+    extern __shared__ unsigned int s_hist[];
+    if (use_smem)
+        {
+        for (unsigned int i=threadIdx.x; i < 3*nbins; i += blockDim.x)
+            s_hist[i] = 0;
+        __syncthreads();
+        }
+
+    // particle index
+    const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx < N)
+        {
+        const Scalar4 postype = d_pos[idx];
+        const Scalar3 f = global_box.makeFraction(make_scalar3(postype.x, postype.y, postype.z));
+
+        const int max_bin = nbins - 1;
+        const int bin_x = min(max(int(f.x * Scalar(nbins)), 0), max_bin);
+        const int bin_y = min(max(int(f.y * Scalar(nbins)), 0), max_bin);
+        const int bin_z = min(max(int(f.z * Scalar(nbins)), 0), max_bin);
+
+        unsigned int *hist = use_smem ? s_hist : d_hist;
+        atomicAdd(&hist[bin_x], 1);
+        atomicAdd(&hist[nbins + bin_y], 1);
+        atomicAdd(&hist[2*nbins + bin_z], 1);
+        }
+
+    if (use_smem)
+        {
+        __syncthreads();
+        for (unsigned int i=threadIdx.x; i < 3*nbins; i += blockDim.x)
+            {
+            const unsigned int count = s_hist[i];
+            if (count > 0)
+                atomicAdd(&d_hist[i], count);
+            }
+        }
+    }
+
+/*!
+ * \param d_hist Particle counts per bin along x, y, and z (nbins each)
+ * \param d_pos Particle positions
+ * \param global_box Global box
+ * \param N Number of local particles
+ * \param nbins Number of bins per dimension
+ * \param use_smem If true, accumulate the counts of a block in shared memory (requires 3*nbins unsigned ints)
+ * \param block_size Kernel launch block size
+ *
+ * The counts are zeroed before the kernel is launched, see gpu_load_balance_histogram_kernel for details.
+ */
+void gpu_load_balance_histogram(unsigned int *d_hist,
+                                const Scalar4 *d_pos,
+                                const BoxDim& global_box,
+                                const unsigned int N,
+                                const unsigned int nbins,
+                                const bool use_smem,
+                                const unsigned int block_size)
+    {
+    cudaMemset(d_hist, 0, sizeof(unsigned int)*3*nbins);
+
+    if (use_smem)
+        {
+        static unsigned int max_block_size = UINT_MAX;
+        if (max_block_size == UINT_MAX)
+            {
+            cudaFuncAttributes attr;
+            cudaFuncGetAttributes(&attr, (const void *)gpu_load_balance_histogram_kernel<true>);
+            max_block_size = attr.maxThreadsPerBlock;
+            }
+        unsigned int run_block_size = min(block_size, max_block_size);
+        unsigned int n_blocks = N/run_block_size + 1;
+        unsigned int shared_bytes = 3*nbins*sizeof(unsigned int);
+
+        gpu_load_balance_histogram_kernel<true><<<n_blocks, run_block_size, shared_bytes>>>(d_hist, d_pos, global_box, N, nbins);
+        }
+    else
+        {
+        static unsigned int max_block_size = UINT_MAX;
+        if (max_block_size == UINT_MAX)
+            {
+            cudaFuncAttributes attr;
+            cudaFuncGetAttributes(&attr, (const void *)gpu_load_balance_histogram_kernel<false>);
+            max_block_size = attr.maxThreadsPerBlock;
+            }
+        unsigned int run_block_size = min(block_size, max_block_size);
+        unsigned int n_blocks = N/run_block_size + 1;
+
+        gpu_load_balance_histogram_kernel<false><<<n_blocks, run_block_size>>>(d_hist, d_pos, global_box, N, nbins);
+        }
+    }
+
 //! Functor for selecting ranks not equal to the current rank
 struct NotEqual
     {
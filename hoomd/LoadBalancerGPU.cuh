@@ -30,4 +30,13 @@ void gpu_load_balance_select_off_rank(unsigned int *d_off_rank,
                                       size_t &tmp_storage_bytes,
                                       const unsigned int N,
                                       const unsigned int cur_rank);
+
+//! Kernel driver to count the particles in bins along each dimension of the global box
+void gpu_load_balance_histogram(unsigned int *d_hist,
+                                const Scalar4 *d_pos,
+                                const BoxDim& global_box,
+                                const unsigned int N,
+                                const unsigned int nbins,
+                                const bool use_smem,
+                                const unsigned int block_size);
 #endif // ENABLE_MPI
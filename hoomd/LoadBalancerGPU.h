@@ -46,6 +46,8 @@ class PYBIND11_EXPORT LoadBalancerGPU : public LoadBalancer
             LoadBalancer::setAutotunerParams(enable, period);
             m_tuner->setPeriod(period);
             m_tuner->setEnabled(enable);
+            m_tuner_hist->setPeriod(period);
+            m_tuner_hist->setEnabled(enable);
             }
 
         //! Resize the per particle data when there is a max number of particle change
@@ -58,10 +60,16 @@ class PYBIND11_EXPORT LoadBalancerGPU : public LoadBalancer
         //! Count the number of particles that have gone off either edge of the rank along a dimension on the GPU
         virtual void countParticlesOffRank(std::map<unsigned int, unsigned int>& cnts);
 
+        //! Bin the number of local particles along each dimension of the global box on the GPU
+        virtual void computeHistograms(std::vector<double>& hist);
+
     private:
         std::unique_ptr<Autotuner> m_tuner;   //!< Autotuner for block size counting particles
         GPUArray<unsigned int> m_off_ranks;     //!< Array to hold the ranks of particles that have moved
         GPUFlags<unsigned int> m_n_off_rank;    //!< Device flag to count the total number of particles off rank
+
+        std::unique_ptr<Autotuner> m_tuner_hist;    //!< Autotuner for block size of the histograms
+        GPUArray<unsigned int> m_hist;              //!< Particle counts per bin along x, y, and z
     };
 
 //! Export the LoadBalancerGPU to python
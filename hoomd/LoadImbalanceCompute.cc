@@ -0,0 +1,258 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: mphoward
+
+/*! \file LoadImbalanceCompute.cc
+    \brief Defines the LoadImbalanceCompute class
+*/
+
+#ifdef ENABLE_MPI
+#include "LoadImbalanceCompute.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+namespace py = pybind11;
+
+//! Names of the timing categories in the log quantities
+static const char *category_names[] = {"busy", "wait_exchange", "wait_collective"};
+
+/*!
+ * \param sysdef System definition
+ */
+LoadImbalanceCompute::LoadImbalanceCompute(std::shared_ptr<SystemDefinition> sysdef)
+    : Compute(sysdef), m_mpi_comm(m_exec_conf->getMPICommunicator()), m_started(false), m_last_time(0),
+      m_last_timestep(0), m_imbalance(Scalar(1.0)), m_run_busy(0.0), m_run_time(0.0), m_run_windows(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing LoadImbalanceCompute" << endl;
+
+    Metrics *metrics = m_exec_conf->getMetrics();
+    m_metric_exchange = metrics->registerExchangeWaitTime();
+    m_metric_collective = metrics->registerCollectiveTime();
+
+    for (unsigned int i = 0; i < num_categories; ++i)
+        {
+        m_last_wait[i] = 0.0;
+        m_min[i] = m_avg[i] = m_max[i] = 0.0;
+        }
+    }
+
+LoadImbalanceCompute::~LoadImbalanceCompute()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying LoadImbalanceCompute" << endl;
+    }
+
+/*!
+ * \param timestep Current time step of the simulation
+ *
+ * The first call only starts the window. Later calls reduce the times of the window since the previous call and
+ * start a new window. All ranks must evaluate the compute on the same time steps.
+ */
+void LoadImbalanceCompute::compute(unsigned int timestep)
+    {
+    if (!shouldCompute(timestep))
+        return;
+
+    Metrics *metrics = m_exec_conf->getMetrics();
+    const int64_t time = m_clk.getTime();
+    double wait[num_categories];
+    wait[busy] = 0.0;
+    wait[exchange] = metrics->get(m_metric_exchange);
+    wait[collective] = metrics->get(m_metric_collective);
+
+    if (m_started && timestep > m_last_timestep)
+        {
+        if (m_prof) m_prof->push("Load imbalance");
+
+        // per step times of this rank, followed by their negatives to reduce the minima with MPI_MAX
+        const double n_steps = double(timestep - m_last_timestep);
+        const double elapsed = double(time - m_last_time)*1e-9;
+        double local[2*num_categories];
+        local[exchange] = wait[exchange] - m_last_wait[exchange];
+        local[collective] = wait[collective] - m_last_wait[collective];
+        local[busy] = std::max(elapsed - local[exchange] - local[collective], 0.0);
+        m_run_busy += local[busy];
+        m_run_time += elapsed;
+        ++m_run_windows;
+
+        for (unsigned int i = 0; i < num_categories; ++i)
+            {
+            local[i] /= n_steps;
+            local[num_categories + i] = -local[i];
+            }
+
+        double max[2*num_categories];
+        double sum[num_categories];
+            {
+            MetricsTimer timer(metrics, m_metric_collective);
+            MPI_Allreduce(local, max, 2*num_categories, MPI_DOUBLE, MPI_MAX, m_mpi_comm);
+            MPI_Allreduce(local, sum, num_categories, MPI_DOUBLE, MPI_SUM, m_mpi_comm);
+
+            if (m_exec_conf->isRoot())
+                m_rank_times.resize(m_exec_conf->getNRanks()*num_categories);
+            MPI_Gather(local, num_categories, MPI_DOUBLE,
+                       m_exec_conf->isRoot() ? &m_rank_times[0] : NULL, num_categories, MPI_DOUBLE,
+                       0, m_mpi_comm);
+            }
+
+        for (unsigned int i = 0; i < num_categories; ++i)
+            {
+            m_max[i] = max[i];
+            m_min[i] = -max[num_categories + i];
+            m_avg[i] = sum[i]/double(m_exec_conf->getNRanks());
+            }
+        m_imbalance = (m_avg[busy] > 0.0) ? Scalar(m_max[busy]/m_avg[busy]) : Scalar(1.0);
+
+        if (m_prof) m_prof->pop();
+        }
+
+    // start the next window after the reductions, so that they are not measured as busy time
+    m_started = true;
+    m_last_time = m_clk.getTime();
+    m_last_timestep = timestep;
+    m_last_wait[exchange] = metrics->get(m_metric_exchange);
+    m_last_wait[collective] = metrics->get(m_metric_collective);
+    }
+
+/*!
+ * \returns The imbalance and the minimum, average, and maximum over the ranks of each timing category
+ */
+std::vector< std::string > LoadImbalanceCompute::getProvidedLogQuantities()
+    {
+    std::vector< std::string > list;
+    list.push_back("load_imbalance");
+    for (unsigned int i = 0; i < num_categories; ++i)
+        {
+        list.push_back(string("load_") + category_names[i] + "_min");
+        list.push_back(string("load_") + category_names[i] + "_avg");
+        list.push_back(string("load_") + category_names[i] + "_max");
+        }
+    return list;
+    }
+
+/*!
+ * \param quantity Name of the log quantity to get
+ * \param timestep Current time step of the simulation
+ * \returns The requested quantity, times are in seconds per time step
+ */
+Scalar LoadImbalanceCompute::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    compute(timestep);
+
+    if (quantity == "load_imbalance")
+        return m_imbalance;
+
+    for (unsigned int i = 0; i < num_categories; ++i)
+        {
+        const string prefix = string("load_") + category_names[i];
+        if (quantity == prefix + "_min")
+            return Scalar(m_min[i]);
+        else if (quantity == prefix + "_avg")
+            return Scalar(m_avg[i]);
+        else if (quantity == prefix + "_max")
+            return Scalar(m_max[i]);
+        }
+
+    m_exec_conf->msg->error() << "compute.load_imbalance: " << quantity << " is not a valid log quantity"
+                              << endl;
+    throw runtime_error("Error getting log value");
+    }
+
+/*!
+ * \returns The matrix of the per rank times
+ */
+std::vector< std::string > LoadImbalanceCompute::getProvidedLogMatrixQuantities()
+    {
+    std::vector< std::string > list;
+    list.push_back("load_rank_times");
+    return list;
+    }
+
+/*!
+ * \param quantity Name of the log matrix to get
+ * \param timestep Current time step of the simulation
+ * \returns On the root rank, an array with one row per rank and the busy, exchange wait, and collective wait times
+ *          per time step in the columns. An empty array on the other ranks and before the first window.
+ */
+pybind11::array LoadImbalanceCompute::getLogMatrix(const std::string& quantity, unsigned int timestep)
+    {
+    if (quantity != "load_rank_times")
+        {
+        m_exec_conf->msg->error() << "compute.load_imbalance: " << quantity << " is not a valid log matrix"
+                                  << endl;
+        throw runtime_error("Error getting log matrix");
+        }
+
+    compute(timestep);
+
+    if (m_rank_times.empty())
+        {
+        unsigned char tmp[] = {0};
+        return pybind11::array(0, tmp);
+        }
+
+    std::vector<size_t> dims(2);
+    dims[0] = m_rank_times.size()/num_categories;
+    dims[1] = num_categories;
+    return pybind11::array(dims, &m_rank_times[0]);
+    }
+
+/*!
+ * The fraction of the measured time that each rank was busy is binned between the least and the most busy rank.
+ * This is a collective call.
+ */
+void LoadImbalanceCompute::printStats()
+    {
+    double fraction = (m_run_time > 0.0) ? m_run_busy/m_run_time : 0.0;
+    std::vector<double> fractions(m_exec_conf->isRoot() ? m_exec_conf->getNRanks() : 0);
+    MPI_Gather(&fraction, 1, MPI_DOUBLE, m_exec_conf->isRoot() ? &fractions[0] : NULL, 1, MPI_DOUBLE, 0, m_mpi_comm);
+
+    if (!m_exec_conf->isRoot() || m_run_windows == 0 || m_exec_conf->msg->getNoticeLevel() < 1)
+        return;
+
+    const double lo = *std::min_element(fractions.begin(), fractions.end());
+    const double hi = *std::max_element(fractions.begin(), fractions.end());
+    const double width = (hi > lo) ? (hi - lo)/double(num_bins) : 1.0;
+    std::vector<unsigned int> hist(num_bins, 0);
+    for (unsigned int i = 0; i < fractions.size(); ++i)
+        {
+        unsigned int bin = std::min((unsigned int)((fractions[i] - lo)/width), num_bins - 1);
+        ++hist[bin];
+        }
+
+    ostream& o = m_exec_conf->msg->notice(1);
+    const ios_base::fmtflags flags = o.flags();
+    const streamsize precision = o.precision();
+    o << "-- Load imbalance (busy fraction of " << m_run_time << " s per rank):" << endl;
+    for (unsigned int bin = 0; bin < num_bins; ++bin)
+        {
+        if (hi == lo && bin > 0)
+            break;
+        o << setw(6) << fixed << setprecision(1) << (lo + bin*width)*100.0 << "% - "
+          << setw(5) << (hi > lo ? lo + (bin+1)*width : lo)*100.0 << "%: " << setw(6) << hist[bin] << " ranks ";
+        o << string((hist[bin]*40 + fractions.size() - 1)/fractions.size(), '#') << endl;
+        }
+    o.flags(flags);
+    o.precision(precision);
+    }
+
+void LoadImbalanceCompute::resetStats()
+    {
+    m_run_busy = 0.0;
+    m_run_time = 0.0;
+    m_run_windows = 0;
+    }
+
+void export_LoadImbalanceCompute(py::module& m)
+    {
+    py::class_<LoadImbalanceCompute, std::shared_ptr<LoadImbalanceCompute> >(m,"LoadImbalanceCompute",py::base<Compute>())
+    .def(py::init< std::shared_ptr<SystemDefinition> >())
+    .def("getImbalance", &LoadImbalanceCompute::getImbalance)
+    ;
+    }
+#endif // ENABLE_MPI
@@ -0,0 +1,122 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: mphoward
+
+/*! \file LoadImbalanceCompute.h
+    \brief Declares a compute that measures the load imbalance between MPI ranks from timings
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifdef ENABLE_MPI
+
+#ifndef __LOAD_IMBALANCE_COMPUTE_H__
+#define __LOAD_IMBALANCE_COMPUTE_H__
+
+#include "Compute.h"
+#include "ClockSource.h"
+
+#include <memory>
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+#include <string>
+#include <vector>
+
+//! Measures the load imbalance between the MPI ranks from the time spent computing and waiting
+/*!
+ * The time of each rank in a window is split into the time spent waiting and the remaining busy time. The waits are
+ * read from the metrics of the Communicator point to point exchanges (Metrics::registerExchangeWaitTime()) and of the
+ * collectives of the time step loop (Metrics::registerCollectiveTime()). The window extends from the previous
+ * evaluation of the compute to the current one, and all times are reported per time step of the window.
+ *
+ * The minimum, average, and maximum of the busy, exchange wait, and collective wait times over the ranks are reduced
+ * to all ranks. The load imbalance is the maximum busy time divided by the average busy time, it is 1 for a perfectly
+ * balanced run. Unlike the particle-based imbalance of LoadBalancer, it includes every source of load, e.g. the
+ * neighbor density or the host-device transfers of a rank.
+ *
+ * The times of every rank in the window are gathered to the root rank, where they are logged as a matrix and binned
+ * into a histogram of the busy times over the whole run, which is printed by printStats().
+ *
+ * \ingroup computes
+ */
+class PYBIND11_EXPORT LoadImbalanceCompute : public Compute
+    {
+    public:
+        //! Constructor
+        LoadImbalanceCompute(std::shared_ptr<SystemDefinition> sysdef);
+
+        //! Destructor
+        virtual ~LoadImbalanceCompute();
+
+        //! Measure the times of the window that ends at this time step
+        virtual void compute(unsigned int timestep);
+
+        //! Get the load imbalance of the last window
+        /*! \returns Maximum busy time over average busy time, or 1 if no window has been measured yet
+         */
+        Scalar getImbalance() const
+            {
+            return m_imbalance;
+            }
+
+        //! Returns a list of log quantities this compute calculates
+        virtual std::vector< std::string > getProvidedLogQuantities();
+
+        //! Calculates the requested log value and returns it
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+        //! Returns a list of log matrix quantities this compute calculates
+        virtual std::vector< std::string > getProvidedLogMatrixQuantities();
+
+        //! Returns the times of every rank
+        virtual pybind11::array getLogMatrix(const std::string& quantity, unsigned int timestep);
+
+        //! Print the histogram of the busy times of the ranks
+        virtual void printStats();
+
+        //! Reset the histogram
+        virtual void resetStats();
+
+        //! Number of bins of the histogram of busy times
+        static const unsigned int num_bins = 10;
+
+    protected:
+        //! Timing categories
+        enum category
+            {
+            busy = 0,       //!< Time not spent waiting
+            exchange,       //!< Time spent waiting for the point to point messages of the Communicator
+            collective,     //!< Time spent in the collectives of the time step loop
+            num_categories
+            };
+
+        const MPI_Comm m_mpi_comm;          //!< MPI communicator for all ranks
+        unsigned int m_metric_exchange;     //!< ID of the metric of the exchange waits
+        unsigned int m_metric_collective;   //!< ID of the metric of the collective waits
+
+        ClockSource m_clk;                  //!< Clock of the window
+        bool m_started;                     //!< True if the window has been started
+        int64_t m_last_time;                //!< Clock time at the start of the window (ns)
+        unsigned int m_last_timestep;       //!< Time step at the start of the window
+        double m_last_wait[num_categories]; //!< Metric values at the start of the window (s)
+
+        double m_min[num_categories];       //!< Minimum per step time over the ranks (s)
+        double m_avg[num_categories];       //!< Average per step time over the ranks (s)
+        double m_max[num_categories];       //!< Maximum per step time over the ranks (s)
+        Scalar m_imbalance;                 //!< Maximum over average busy time
+
+        std::vector<double> m_rank_times;   //!< Per step times of every rank (root only)
+
+        double m_run_busy;                  //!< Busy time of this rank in the run (s)
+        double m_run_time;                  //!< Measured time of the run (s)
+        unsigned int m_run_windows;         //!< Number of measured windows in the run
+    };
+
+//! Exports the LoadImbalanceCompute class to python
+void export_LoadImbalanceCompute(pybind11::module& m);
+
+#endif // __LOAD_IMBALANCE_COMPUTE_H__
+#endif // ENABLE_MPI
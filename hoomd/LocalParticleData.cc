@@ -0,0 +1,222 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+/*! \file LocalParticleData.cc
+    \brief Defines the LocalParticleData class
+*/
+
+#include "LocalParticleData.h"
+
+#include "hoomd/extern/pybind/include/pybind11/numpy.h"
+
+#include <stdexcept>
+
+namespace py = pybind11;
+using namespace std;
+
+/*! \param pdata Particle data to access
+    \param device True to access the arrays on the device
+    \param readonly True to access the arrays read only
+    \param ghosts True to include the ghost particles in the views
+*/
+LocalParticleData::LocalParticleData(std::shared_ptr<ParticleData> pdata, bool device, bool readonly, bool ghosts)
+    : m_pdata(pdata), m_device(device), m_readonly(readonly), m_ghosts(ghosts), m_entered(false)
+    {
+    #ifdef ENABLE_CUDA
+    if (m_device && !m_pdata->getExecConf()->isCUDAEnabled())
+    #else
+    if (m_device)
+    #endif
+        {
+        m_pdata->getExecConf()->msg->error() << "Device access to the particle data requires a GPU" << endl;
+        throw runtime_error("Error accessing particle data");
+        }
+    }
+
+LocalParticleData::~LocalParticleData()
+    {
+    exit();
+    }
+
+void LocalParticleData::enter()
+    {
+    m_entered = true;
+    }
+
+/*! The handles are released in the reverse order of the arrays in ParticleData. Views obtained before remain valid
+    python objects, but they must not be used anymore.
+
+    Writes through the position view do not pass through ParticleData, so the structure-of-arrays position copy is
+    invalidated when a writable position view was handed out.
+*/
+void LocalParticleData::exit()
+    {
+    if (m_pos && !m_readonly)
+        m_pdata->invalidatePositionsSoA();
+
+    m_rtag.reset();
+    m_tag.reset();
+    m_net_force.reset();
+    m_vel.reset();
+    m_pos.reset();
+    m_entered = false;
+    }
+
+access_location::Enum LocalParticleData::getLocation() const
+    {
+    #ifdef ENABLE_CUDA
+    if (m_device)
+        return access_location::device;
+    #endif
+    return access_location::host;
+    }
+
+access_mode::Enum LocalParticleData::getMode() const
+    {
+    return m_readonly ? access_mode::read : access_mode::readwrite;
+    }
+
+unsigned int LocalParticleData::getNumParticles() const
+    {
+    return m_ghosts ? m_pdata->getN() + m_pdata->getNGhosts() : m_pdata->getN();
+    }
+
+void LocalParticleData::checkEntered() const
+    {
+    if (!m_entered)
+        {
+        m_pdata->getExecConf()->msg->error() << "Local particle data can only be accessed inside of its context"
+                                             << endl;
+        throw runtime_error("Error accessing particle data");
+        }
+    }
+
+/*! \param self Python object of this class, kept alive by the returned array
+    \param data Pointer to the Scalar4 array
+    \param n Number of elements in the view
+    \returns A numpy array (host) or a CUDA array interface dictionary (device)
+*/
+py::object LocalParticleData::wrapScalar3(py::object self, Scalar4 *data, unsigned int n) const
+    {
+    std::vector<size_t> dims(2);
+    dims[0] = n;
+    dims[1] = 3;
+    std::vector<size_t> strides(2);
+    strides[0] = sizeof(Scalar4);
+    strides[1] = sizeof(Scalar);
+
+    if (!m_device)
+        return py::array(dims, strides, (Scalar *)data, self);
+
+    py::dict interface;
+    interface["shape"] = py::make_tuple(n, 3);
+    interface["strides"] = py::make_tuple(sizeof(Scalar4), sizeof(Scalar));
+    interface["typestr"] = (sizeof(Scalar) == 4) ? "<f4" : "<f8";
+    interface["data"] = py::make_tuple((size_t)data, m_readonly);
+    interface["version"] = 2;
+    return interface;
+    }
+
+/*! \param self Python object of this class, kept alive by the returned array
+    \param data Pointer to the array
+    \param n Number of elements in the view
+    \returns A numpy array (host) or a CUDA array interface dictionary (device)
+*/
+py::object LocalParticleData::wrapUInt(py::object self, unsigned int *data, unsigned int n) const
+    {
+    std::vector<size_t> dims(1);
+    dims[0] = n;
+
+    if (!m_device)
+        return py::array(dims, data, self);
+
+    py::dict interface;
+    interface["shape"] = py::make_tuple(n);
+    interface["strides"] = py::none();
+    interface["typestr"] = "<u4";
+    interface["data"] = py::make_tuple((size_t)data, m_readonly);
+    interface["version"] = 2;
+    return interface;
+    }
+
+/*! \param self Python object of this class
+    \returns The positions of the particles as an N x 3 view
+*/
+py::object LocalParticleData::getPosition(py::object self)
+    {
+    auto self_cpp = self.cast<LocalParticleData *>();
+    self_cpp->checkEntered();
+    if (!self_cpp->m_pos)
+        self_cpp->m_pos.reset(new ArrayHandle<Scalar4>(self_cpp->m_pdata->getPositions(),
+                                                       self_cpp->getLocation(), self_cpp->getMode()));
+    return self_cpp->wrapScalar3(self, self_cpp->m_pos->data, self_cpp->getNumParticles());
+    }
+
+/*! \param self Python object of this class
+    \returns The velocities of the particles as an N x 3 view
+*/
+py::object LocalParticleData::getVelocity(py::object self)
+    {
+    auto self_cpp = self.cast<LocalParticleData *>();
+    self_cpp->checkEntered();
+    if (!self_cpp->m_vel)
+        self_cpp->m_vel.reset(new ArrayHandle<Scalar4>(self_cpp->m_pdata->getVelocities(),
+                                                       self_cpp->getLocation(), self_cpp->getMode()));
+    return self_cpp->wrapScalar3(self, self_cpp->m_vel->data, self_cpp->getNumParticles());
+    }
+
+/*! \param self Python object of this class
+    \returns The net forces on the particles as an N x 3 view
+*/
+py::object LocalParticleData::getNetForce(py::object self)
+    {
+    auto self_cpp = self.cast<LocalParticleData *>();
+    self_cpp->checkEntered();
+    if (!self_cpp->m_net_force)
+        self_cpp->m_net_force.reset(new ArrayHandle<Scalar4>(self_cpp->m_pdata->getNetForce(),
+                                                             self_cpp->getLocation(), self_cpp->getMode()));
+    return self_cpp->wrapScalar3(self, self_cpp->m_net_force->data, self_cpp->getNumParticles());
+    }
+
+/*! \param self Python object of this class
+    \returns The tags of the particles
+*/
+py::object LocalParticleData::getTag(py::object self)
+    {
+    auto self_cpp = self.cast<LocalParticleData *>();
+    self_cpp->checkEntered();
+    if (!self_cpp->m_tag)
+        self_cpp->m_tag.reset(new ArrayHandle<unsigned int>(self_cpp->m_pdata->getTags(),
+                                                            self_cpp->getLocation(), self_cpp->getMode()));
+    return self_cpp->wrapUInt(self, self_cpp->m_tag->data, self_cpp->getNumParticles());
+    }
+
+/*! \param self Python object of this class
+    \returns The index of each tag, NOT_LOCAL for particles that are neither local nor ghosts
+*/
+py::object LocalParticleData::getRTag(py::object self)
+    {
+    auto self_cpp = self.cast<LocalParticleData *>();
+    self_cpp->checkEntered();
+    if (!self_cpp->m_rtag)
+        self_cpp->m_rtag.reset(new ArrayHandle<unsigned int>(self_cpp->m_pdata->getRTags(),
+                                                             self_cpp->getLocation(), self_cpp->getMode()));
+    return self_cpp->wrapUInt(self, self_cpp->m_rtag->data, self_cpp->m_pdata->getRTags().size());
+    }
+
+void export_LocalParticleData(py::module& m)
+    {
+    py::class_<LocalParticleData, std::shared_ptr<LocalParticleData> >(m, "LocalParticleData")
+    .def(py::init< std::shared_ptr<ParticleData>, bool, bool, bool >())
+    .def("enter", &LocalParticleData::enter)
+    .def("exit", &LocalParticleData::exit)
+    .def_property_readonly("position", &LocalParticleData::getPosition)
+    .def_property_readonly("velocity", &LocalParticleData::getVelocity)
+    .def_property_readonly("net_force", &LocalParticleData::getNetForce)
+    .def_property_readonly("tag", &LocalParticleData::getTag)
+    .def_property_readonly("rtag", &LocalParticleData::getRTag)
+    ;
+    }
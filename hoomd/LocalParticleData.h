@@ -0,0 +1,105 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+/*! \file LocalParticleData.h
+    \brief Declares the LocalParticleData class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __LOCAL_PARTICLE_DATA_H__
+#define __LOCAL_PARTICLE_DATA_H__
+
+#include "ParticleData.h"
+
+#include <memory>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+//! Zero-copy access to the rank-local particle data arrays from python
+/*! LocalParticleData acquires the arrays of a ParticleData with ArrayHandles and exposes the raw memory to python,
+    without gathering or copying the data. On the host, the arrays are returned as numpy arrays that reference the
+    particle data. On the device, a dictionary following the CUDA array interface (version 2) is returned, which python
+    wraps in an object with a __cuda_array_interface__ attribute for consumption by cupy, numba and similar libraries.
+
+    Each array is acquired on first access and stays acquired until exit() is called. While an array is acquired, any
+    other access to it (e.g. by running the simulation) fails with the scoping error of GPUArray, so the python
+    context manager must be exited before hoomd.run(). The views must not be used after exit().
+
+    Positions, velocities and net forces are returned as N x 3 views into the Scalar4 arrays, so the w component
+    (type, mass and energy) is not part of the view. Depending on \a ghosts, the views cover the local particles or
+    the local and the ghost particles. The reverse lookup table is always returned for all tags.
+
+    \ingroup data_structs
+*/
+class PYBIND11_EXPORT LocalParticleData
+    {
+    public:
+        //! Constructor
+        LocalParticleData(std::shared_ptr<ParticleData> pdata, bool device, bool readonly, bool ghosts);
+
+        //! Destructor
+        ~LocalParticleData();
+
+        //! Allow the arrays to be acquired
+        void enter();
+
+        //! Release all acquired arrays
+        void exit();
+
+        //! Get the particle positions
+        static pybind11::object getPosition(pybind11::object self);
+
+        //! Get the particle velocities
+        static pybind11::object getVelocity(pybind11::object self);
+
+        //! Get the net forces
+        static pybind11::object getNetForce(pybind11::object self);
+
+        //! Get the particle tags
+        static pybind11::object getTag(pybind11::object self);
+
+        //! Get the reverse lookup table from tags to indices
+        static pybind11::object getRTag(pybind11::object self);
+
+    private:
+        std::shared_ptr<ParticleData> m_pdata;  //!< Particle data to access
+        const bool m_device;                    //!< True to access the arrays on the device
+        const bool m_readonly;                  //!< True to access the arrays read only
+        const bool m_ghosts;                    //!< True to include the ghost particles in the views
+        bool m_entered;                         //!< True between enter() and exit()
+
+        std::unique_ptr< ArrayHandle<Scalar4> > m_pos;          //!< Handle to the positions
+        std::unique_ptr< ArrayHandle<Scalar4> > m_vel;          //!< Handle to the velocities
+        std::unique_ptr< ArrayHandle<Scalar4> > m_net_force;    //!< Handle to the net forces
+        std::unique_ptr< ArrayHandle<unsigned int> > m_tag;     //!< Handle to the tags
+        std::unique_ptr< ArrayHandle<unsigned int> > m_rtag;    //!< Handle to the reverse lookup table
+
+        //! Get the location to acquire the arrays at
+        access_location::Enum getLocation() const;
+
+        //! Get the access mode of the arrays
+        access_mode::Enum getMode() const;
+
+        //! Get the number of particles in the views
+        unsigned int getNumParticles() const;
+
+        //! Throw an error if the arrays are accessed outside of enter() and exit()
+        void checkEntered() const;
+
+        //! Wrap an N x 3 view into a Scalar4 array
+        pybind11::object wrapScalar3(pybind11::object self, Scalar4 *data, unsigned int n) const;
+
+        //! Wrap a one dimensional unsigned int array
+        pybind11::object wrapUInt(pybind11::object self, unsigned int *data, unsigned int n) const;
+    };
+
+//! Exports LocalParticleData to python
+void export_LocalParticleData(pybind11::module& m);
+
+#endif
@@ -33,7 +33,8 @@ LogPlainTXT::LogPlainTXT(std::shared_ptr<SystemDefinition> sysdef,
                          const std::string& header_prefix,
                          bool overwrite)
     : Logger(sysdef), m_delimiter("\t"), m_filename(fname), m_header_prefix(header_prefix), m_appending(!overwrite),
-                        m_is_initialized(false), m_file_output(true)
+                        m_is_initialized(false), m_file_output(true), m_buffer_rows(1), m_buffered_rows(0),
+                        m_async(false), m_pending_block(false), m_writer_exit(false), m_writer_error(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing LogPlainTXT: " << fname << " " << header_prefix << " " << overwrite << endl;
 
@@ -76,6 +77,152 @@ void LogPlainTXT::openOutputFiles()
 LogPlainTXT::~LogPlainTXT()
     {
     m_exec_conf->msg->notice(5) << "Destroying LogPlainTXT" << endl;
+
+    // write out the remaining rows, errors cannot be reported from the destructor
+    try
+        {
+        flush();
+        }
+    catch (...)
+        {
+        }
+    stopWriter();
+    }
+
+/*! \param buffer_rows Number of rows to buffer before writing them to the file
+
+    With the default of 1, every row is written and flushed to the file as soon as it is logged.
+*/
+void LogPlainTXT::setBufferRows(unsigned int buffer_rows)
+    {
+    if (buffer_rows == 0)
+        {
+        m_exec_conf->msg->error() << "analyze.log: buffer_rows must be at least 1" << endl;
+        throw runtime_error("Error setting log parameters");
+        }
+
+    m_buffer_rows = buffer_rows;
+    if (m_buffered_rows >= m_buffer_rows)
+        writeBuffer();
+    }
+
+/*! \param async True to write blocks of rows on a background thread
+
+    At most one block is in flight; the next block waits for the previous one to complete.
+*/
+void LogPlainTXT::setAsync(bool async)
+    {
+    if (!async)
+        {
+        flush();
+        stopWriter();
+        }
+    m_async = async;
+    }
+
+/*! Writes out all buffered rows and blocks until the writer thread has written them to the file.
+*/
+void LogPlainTXT::flush()
+    {
+    if (m_buffered_rows > 0)
+        writeBuffer();
+    if (m_async)
+        waitForWriter();
+    }
+
+void LogPlainTXT::writeBuffer()
+    {
+    m_buffered_rows = 0;
+
+    if (m_async)
+        {
+        // the writer thread is started on the first block
+        if (!m_writer_thread.joinable())
+            {
+            m_writer_exit = false;
+            m_writer_thread = std::thread(&LogPlainTXT::writerThread, this);
+            }
+
+        // wait for the previous block and report its errors
+        waitForWriter();
+
+            {
+            std::lock_guard<std::mutex> lock(m_writer_mutex);
+            m_pending.swap(m_buffer);
+            m_pending_block = true;
+            }
+        m_writer_cv.notify_all();
+        m_buffer.clear();
+        }
+    else
+        {
+        m_file.write(m_buffer.data(), m_buffer.size());
+        m_file.flush();
+        m_buffer.clear();
+
+        if (!m_file.good())
+            {
+            m_exec_conf->msg->error() << "analyze.log: I/O error while writing log file" << endl;
+            throw runtime_error("Error writing log file");
+            }
+        }
+    }
+
+void LogPlainTXT::waitForWriter()
+    {
+    bool error = false;
+        {
+        std::unique_lock<std::mutex> lock(m_writer_mutex);
+        m_writer_cv.wait(lock, [this] { return !m_pending_block; });
+        error = m_writer_error;
+        m_writer_error = false;
+        }
+
+    if (error)
+        {
+        m_exec_conf->msg->error() << "analyze.log: I/O error while writing log file" << endl;
+        throw runtime_error("Error writing log file");
+        }
+    }
+
+void LogPlainTXT::stopWriter()
+    {
+    if (!m_writer_thread.joinable())
+        return;
+
+        {
+        std::lock_guard<std::mutex> lock(m_writer_mutex);
+        m_writer_exit = true;
+        }
+    m_writer_cv.notify_all();
+    m_writer_thread.join();
+    }
+
+/*! The writer thread waits for blocks handed over by writeBuffer() and writes them out. The loop exits when
+    m_writer_exit is set and no block is pending.
+*/
+void LogPlainTXT::writerThread()
+    {
+    std::unique_lock<std::mutex> lock(m_writer_mutex);
+    while (true)
+        {
+        m_writer_cv.wait(lock, [this] { return m_pending_block || m_writer_exit; });
+
+        if (!m_pending_block)
+            break;
+
+        // perform the file I/O without holding the lock
+        lock.unlock();
+        m_file.write(m_pending.data(), m_pending.size());
+        m_file.flush();
+        bool error = !m_file.good();
+        m_pending.clear();
+        lock.lock();
+
+        m_writer_error = m_writer_error || error;
+        m_pending_block = false;
+        m_writer_cv.notify_all();
+        }
     }
 
 /*! \param delimiter Delimiter to place between columns in the output file
@@ -111,30 +258,20 @@ void LogPlainTXT::analyze(unsigned int timestep)
             }
 #endif
 
-    // The timestep is always output
-    m_file << setprecision(10) << timestep;
+    // format the row in memory
+    m_row.str("");
+    m_row << setprecision(10) << timestep;
 
-    // quit now if there is nothing to log
-    if (m_logged_quantities.size() == 0)
-        {
-        return;
-        }
+    // write all quantities preceded by the delimiter
+    for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+        m_row << m_delimiter << setprecision(10) << m_cached_quantities[i];
+    m_row << '\n';
 
-    // only print the delimiter after the timestep if there are more quantities logged
-    m_file << m_delimiter;
+    m_buffer += m_row.str();
+    m_buffered_rows++;
 
-    // write all but the last of the quantities separated by the delimiter
-    for (unsigned int i = 0; i < m_logged_quantities.size()-1; i++)
-        m_file << setprecision(10) << m_cached_quantities[i] << m_delimiter;
-    // write the last one with no delimiter after it
-    m_file << setprecision(10) << m_cached_quantities[m_logged_quantities.size()-1] << endl;
-    m_file.flush();
-
-    if (!m_file.good())
-        {
-        m_exec_conf->msg->error() << "analyze.log: I/O error while writing log file" << endl;
-        throw runtime_error("Error writing log file");
-        }
+    if (m_buffered_rows >= m_buffer_rows)
+        writeBuffer();
 
     if (m_prof) m_prof->pop();
     }
@@ -164,6 +301,9 @@ void LogPlainTXT::setLoggedQuantities(const std::vector< std::string >& quantiti
 
     m_is_initialized = true;
 
+    // keep the header behind the rows logged so far
+    flush();
+
     // only write the header if this is a new file
     if (!m_appending && m_file_output)
         {
@@ -200,5 +340,7 @@ void export_LogPlainTXT(py::module& m)
     py::class_<LogPlainTXT, std::shared_ptr<LogPlainTXT> >(m,"LogPlainTXT", py::base<Logger>())
     .def(py::init< std::shared_ptr<SystemDefinition>, const std::string&, const std::string&, bool >())
     .def("setDelimiter", &LogPlainTXT::setDelimiter)
+    .def("setBufferRows", &LogPlainTXT::setBufferRows)
+    .def("setAsync", &LogPlainTXT::setAsync)
     ;
     }
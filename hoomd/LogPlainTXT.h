@@ -11,6 +11,11 @@
 
 #include "Logger.h"
 
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
 #ifndef __LOGPLAINTXT_H__
 #define __LOGPLAINTXT_H__
 
@@ -33,6 +38,10 @@
     As an option, Logger can be initialized with no file. Such a logger will skip doing anything during
     analyze() but is still available for getQuantity() operations.
 
+    Rows are formatted into a memory buffer and written to the file in blocks of setBufferRows() rows. With
+    setAsync(), a block is written by a background thread while the simulation continues. flush() writes out all
+    buffered rows, and System calls it at the end of every run.
+
     \ingroup analyzers
 */
 class LogPlainTXT : public Logger
@@ -56,6 +65,15 @@ class LogPlainTXT : public Logger
         //! Write out the data for the current timestep
         void analyze(unsigned int timestep);
 
+        //! Set the number of rows to buffer before writing them to the file
+        void setBufferRows(unsigned int buffer_rows);
+
+        //! Set whether blocks of rows are written by a background thread
+        void setAsync(bool async);
+
+        //! Write all buffered rows to the file
+        virtual void flush();
+
     private:
         //! The delimiter to put between columns in the file
         std::string m_delimiter;
@@ -72,8 +90,38 @@ class LogPlainTXT : public Logger
         //! true if we are writing to the output file
         bool m_file_output;
 
+        //! Number of rows to buffer before writing a block
+        unsigned int m_buffer_rows;
+        //! Number of rows in m_buffer
+        unsigned int m_buffered_rows;
+        //! Formatted rows that have not been handed to the file yet
+        std::string m_buffer;
+        //! Stream used to format a single row
+        std::ostringstream m_row;
+
+        bool m_async;                             //!< True if blocks are written by the writer thread
+        std::string m_pending;                    //!< Block owned by the writer thread
+        bool m_pending_block;                     //!< True while the writer thread has a block to write
+        bool m_writer_exit;                       //!< Set to true to stop the writer thread
+        bool m_writer_error;                      //!< Set by the writer thread when a write fails
+        std::thread m_writer_thread;              //!< The writer thread
+        std::mutex m_writer_mutex;                //!< Protects the pending block and the writer state
+        std::condition_variable m_writer_cv;      //!< Signals changes of the writer state
+
         //! Helper function to open output files
         void openOutputFiles();
+
+        //! Write the buffered rows to the file, or hand them to the writer thread
+        void writeBuffer();
+
+        //! Block until the writer thread is idle and check for write errors
+        void waitForWriter();
+
+        //! Stop and join the writer thread
+        void stopWriter();
+
+        //! Main loop of the writer thread
+        void writerThread();
     };
 
 //! exports the Logger class to python
@@ -24,7 +24,7 @@ using namespace std;
 /*! \param sysdef Specified for Analyzer, but not used directly by Logger
 */
 Logger::Logger(std::shared_ptr<SystemDefinition> sysdef)
-    : Analyzer(sysdef)
+    : Analyzer(sysdef), m_cached_timestep(-1), m_providers_valid(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing Logger: " << endl;
     }
@@ -54,6 +54,7 @@ void Logger::registerCompute(std::shared_ptr<Compute> compute)
             m_exec_conf->msg->warning() << "analyze.log: The log quantity " << provided_quantities[i] <<
                  " has been registered more than once. Only the most recent registration takes effect" << endl;
         m_compute_quantities[provided_quantities[i]] = compute;
+        m_providers_valid = false;
         m_exec_conf->msg->notice(6) << "analyze.log: Registering log quantity " << provided_quantities[i] << endl;
         }
     }
@@ -78,6 +79,7 @@ void Logger::registerUpdater(std::shared_ptr<Updater> updater)
             m_exec_conf->msg->warning() << "analyze.log: The log quantity " << provided_quantities[i] <<
                  " has been registered more than once. Only the most recent registration takes effect" << endl;
         m_updater_quantities[provided_quantities[i]] = updater;
+        m_providers_valid = false;
         m_exec_conf->msg->notice(6) << "analyze.log: Registering log quantity " << provided_quantities[i] << endl;
         }
     }
@@ -98,6 +100,7 @@ void Logger::registerCallback(std::string name, py::object callback)
     m_exec_conf->msg->warning() << "analyze.log: The log quantity " << name <<
                          " has been registered more than once. Only the most recent registration takes effect" << endl;
     m_callback_quantities[name] = callback;
+    m_providers_valid = false;
     }
 
 /*! After calling removeAll(), no quantities are registered for logging
@@ -106,6 +109,7 @@ void Logger::removeAll()
     {
     m_compute_quantities.clear();
     m_updater_quantities.clear();
+    m_providers_valid = false;
     //The callbacks are intentionally not cleared, because before each
     //run all compute and updaters should be cleared, but the python
     //callbacks should not be cleared for this.
@@ -123,6 +127,7 @@ void Logger::setLoggedQuantities(const std::vector< std::string >& quantities)
     // prepare or adjust storage for caching the logger properties.
     m_cached_timestep = -1;
     m_cached_quantities.resize(quantities.size());
+    m_providers_valid = false;
     }
 
 /*! \param timestep Time step to write out data for
@@ -135,8 +140,7 @@ void Logger::analyze(unsigned int timestep)
     if (m_prof) m_prof->push("Log");
 
     // update info in cache for later use and for immediate output.
-    for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
-        m_cached_quantities[i] = getValue(m_logged_quantities[i], timestep);
+    cacheQuantities(timestep);
 
     m_cached_timestep = timestep;
 
@@ -150,8 +154,7 @@ Scalar Logger::getQuantity(const std::string &quantity, unsigned int timestep, b
     // update info in cache for later use
     if (!use_cache && timestep != m_cached_timestep)
         {
-        for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
-            m_cached_quantities[i] = getValue(m_logged_quantities[i], timestep);
+        cacheQuantities(timestep);
         m_cached_timestep = timestep;
         }
 
@@ -211,11 +214,71 @@ Scalar Logger::getValue(const std::string &quantity, int timestep)
         }
     else
         {
+        // memory usage is accounted by the execution configuration
+        Scalar value(0.0);
+        if (m_exec_conf->getMemoryUsage()->getLogValue(quantity, value))
+            return value;
+
         m_exec_conf->msg->warning() << "analyze.log: Log quantity " << quantity << " is not registered, logging a value of 0" << endl;
         return Scalar(0.0);
         }
     }
 
+/*! The provider of every logged quantity is resolved once and reused by cacheQuantities() until a compute, updater,
+    or callback is registered or the list of logged quantities changes. This avoids string lookups in the
+    provider maps on every logged time step.
+*/
+void Logger::updateProviders()
+    {
+    m_logged_computes.assign(m_logged_quantities.size(), NULL);
+    m_logged_updaters.assign(m_logged_quantities.size(), NULL);
+
+    for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+        {
+        const std::string& quantity = m_logged_quantities[i];
+
+        // callbacks and built-in quantities are handled by getValue()
+        if (quantity == "time")
+            continue;
+
+        auto compute = m_compute_quantities.find(quantity);
+        if (compute != m_compute_quantities.end())
+            {
+            m_logged_computes[i] = compute->second.get();
+            continue;
+            }
+
+        auto updater = m_updater_quantities.find(quantity);
+        if (updater != m_updater_quantities.end())
+            m_logged_updaters[i] = updater->second.get();
+        }
+
+    m_providers_valid = true;
+    }
+
+/*! \param timestep Time step to evaluate the quantities at
+*/
+void Logger::cacheQuantities(unsigned int timestep)
+    {
+    if (!m_providers_valid)
+        updateProviders();
+
+    // update all computes before any value is read, so that computes can batch their MPI reductions
+    for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+        if (m_logged_computes[i])
+            m_logged_computes[i]->compute(timestep);
+
+    for (unsigned int i = 0; i < m_logged_quantities.size(); i++)
+        {
+        if (m_logged_computes[i])
+            m_cached_quantities[i] = m_logged_computes[i]->getLogValue(m_logged_quantities[i], timestep);
+        else if (m_logged_updaters[i])
+            m_cached_quantities[i] = m_logged_updaters[i]->getLogValue(m_logged_quantities[i], timestep);
+        else
+            m_cached_quantities[i] = getValue(m_logged_quantities[i], timestep);
+        }
+    }
+
 void export_Logger(py::module& m)
     {
     py::class_<Logger, std::shared_ptr<Logger> >(m,"Logger", py::base<Analyzer>())
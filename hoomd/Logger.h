@@ -79,15 +79,22 @@ class __attribute__ ((visibility ("hidden"))) Logger : public Analyzer
         virtual void analyze(unsigned int timestep);
 
         //! Get needed pdata flags
-        /*! Logger may potentially log any of the optional quantities, enable all of the bits.
+        /*! Logger may potentially log any of the optional quantities, enable all of the bits. The pressure tensor
+            is only requested when a component of it is logged (or no list of quantities is set), so that logging
+            the scalar pressure allows the force computes to skip the off-diagonal virial components.
         */
         virtual PDataFlags getRequestedPDataFlags()
             {
             PDataFlags flags;
             flags[pdata_flag::isotropic_virial] = 1;
             flags[pdata_flag::potential_energy] = 1;
-            flags[pdata_flag::pressure_tensor] = 1;
             flags[pdata_flag::rotational_kinetic_energy] = 1;
+
+            bool tensor = m_logged_quantities.empty();
+            for (auto q = m_logged_quantities.begin(); q != m_logged_quantities.end(); ++q)
+                if (q->compare(0, 9, "pressure_") == 0)
+                    tensor = true;
+            flags[pdata_flag::pressure_tensor] = tensor;
             return flags;
             }
 
@@ -106,10 +113,22 @@ class __attribute__ ((visibility ("hidden"))) Logger : public Analyzer
         unsigned int m_cached_timestep;
         //! The values of the logged quantities at the last logger update.
         std::vector< Scalar > m_cached_quantities;
+        //! Compute providing each logged quantity, NULL if it is not provided by a compute
+        std::vector< Compute* > m_logged_computes;
+        //! Updater providing each logged quantity, NULL if it is not provided by an updater
+        std::vector< Updater* > m_logged_updaters;
+        //! True when m_logged_computes and m_logged_updaters match the registered providers
+        bool m_providers_valid;
 
     private:
         //! Helper function to get a value for a given quantity
         Scalar getValue(const std::string &quantity, int timestep);
+
+        //! Look up the provider of every logged quantity
+        void updateProviders();
+
+        //! Evaluate all logged quantities and store them in the cache
+        void cacheQuantities(unsigned int timestep);
     };
 
 //! exports the Logger class to python
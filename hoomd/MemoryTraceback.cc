@@ -52,6 +52,13 @@ void MemoryTraceback::updateTag(const void *ptr, unsigned int nbytes, const std:
         m_tags[idx] = tag;
     }
 
+void MemoryTraceback::registerSlab(const void *ptr, unsigned int nbytes, const std::string& name) const
+    {
+    std::pair<unsigned int, unsigned long int>& slabs = m_slabs[name];
+    slabs.first++;
+    slabs.second += nbytes;
+    }
+
 //! Pretty print number of bytes
 inline std::string pretty_bytes(double size_bytes)
     {
@@ -88,6 +95,12 @@ void MemoryTraceback::outputTraces(std::shared_ptr<Messenger> msg) const
 
     msg->notice(2) << "Total amount of managed memory allocated through Global[Array,Vector]: " << pretty_bytes(nbytes_tot) << std::endl;
     msg->notice(2) << "Actual allocation sizes may be larger by up to the OS page size due to alignment." << std::endl;
+
+    for (auto it_slab = m_slabs.begin(); it_slab != m_slabs.end(); ++it_slab)
+        {
+        msg->notice(2) << "Small allocations are served from " << it_slab->second.first << " "
+            << it_slab->first << " of " << pretty_bytes(it_slab->second.second) << " total" << std::endl;
+        }
     msg->notice(2) << "List of memory allocations and last " << MAX_TRACEBACK-1 << " functions called at time of (re-)allocation" << std::endl;
 
     for (auto it_trace = m_traces.begin(); it_trace != m_traces.end(); ++it_trace)
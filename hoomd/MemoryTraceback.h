@@ -33,6 +33,13 @@ class PYBIND11_EXPORT MemoryTraceback
          */
         void unregisterAllocation(const void *ptr, unsigned int nbytes ) const;
 
+        //! Register a slab of the SlabAllocator
+        /*! \param ptr Start of the slab
+            \param nbytes The size of the slab in bytes
+            \param name Kind of memory of the slab
+         */
+        void registerSlab(const void *ptr, unsigned int nbytes, const std::string& name) const;
+
         //! Output the list of pointers along with their stack traces
         void outputTraces(std::shared_ptr<Messenger> msg) const;
 
@@ -45,4 +52,5 @@ class PYBIND11_EXPORT MemoryTraceback
         mutable std::map<std::pair<const void *,unsigned int>, std::vector<void *> > m_traces;  //!< A stacktrace per memory allocation
         mutable std::map<std::pair<const void *,unsigned int>, std::string > m_type_hints;      //!< Types of memory allocations
         mutable std::map<std::pair<const void *,unsigned int>, std::string > m_tags;            //!< Tags of memory allocations
+        mutable std::map<std::string, std::pair<unsigned int, unsigned long int> > m_slabs;    //!< Number and bytes of slabs per kind
     };
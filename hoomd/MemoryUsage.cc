@@ -0,0 +1,163 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: jglaser
+
+/*! \file MemoryUsage.cc
+    \brief Implements a class for accounting of memory usage per subsystem
+*/
+
+#include "MemoryUsage.h"
+
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+
+MemoryUsage::MemoryUsage()
+    {
+    for (unsigned int loc = 0; loc < num_locations; ++loc)
+        {
+        m_total[loc] = 0;
+        m_total_peak[loc] = 0;
+        }
+
+    // ID 0 collects all allocations outside of a scope
+    getOwnerID("other");
+    }
+
+unsigned int MemoryUsage::getOwnerID(const std::string& owner)
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_ids.find(owner);
+    if (it != m_ids.end())
+        return it->second;
+
+    unsigned int id = m_names.size();
+    m_names.push_back(owner);
+    m_ids[owner] = id;
+    for (unsigned int loc = 0; loc < num_locations; ++loc)
+        {
+        m_current[loc].push_back(0);
+        m_peak[loc].push_back(0);
+        }
+    return id;
+    }
+
+void MemoryUsage::registerAllocation(unsigned int owner, memory_location location, size_t nbytes)
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_current[location][owner] += nbytes;
+    m_peak[location][owner] = std::max(m_peak[location][owner], m_current[location][owner]);
+
+    m_total[location] += nbytes;
+    m_total_peak[location] = std::max(m_total_peak[location], m_total[location]);
+    }
+
+void MemoryUsage::unregisterAllocation(unsigned int owner, memory_location location, size_t nbytes)
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_current[location][owner] -= nbytes;
+    m_total[location] -= nbytes;
+    }
+
+std::vector<std::string> MemoryUsage::getOwners() const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_names;
+    }
+
+size_t MemoryUsage::getCurrentBytes(const std::string& owner, memory_location location) const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (owner == "total")
+        return m_total[location];
+
+    auto it = m_ids.find(owner);
+    return (it != m_ids.end()) ? m_current[location][it->second] : 0;
+    }
+
+size_t MemoryUsage::getPeakBytes(const std::string& owner, memory_location location) const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    if (owner == "total")
+        return m_total_peak[location];
+
+    auto it = m_ids.find(owner);
+    return (it != m_ids.end()) ? m_peak[location][it->second] : 0;
+    }
+
+/*! Memory log quantities are of the form memory_<owner>_<host|device>[_peak]. Quantities of owners that have not
+    allocated any memory yet evaluate to zero.
+*/
+bool MemoryUsage::getLogValue(const std::string& quantity, Scalar& value) const
+    {
+    const std::string prefix("memory_");
+    if (quantity.compare(0, prefix.size(), prefix) != 0)
+        return false;
+
+    std::string name = quantity.substr(prefix.size());
+
+    bool peak = false;
+    const std::string peak_suffix("_peak");
+    if (name.size() > peak_suffix.size() &&
+        name.compare(name.size()-peak_suffix.size(), peak_suffix.size(), peak_suffix) == 0)
+        {
+        peak = true;
+        name = name.substr(0, name.size()-peak_suffix.size());
+        }
+
+    memory_location location;
+    const std::string host_suffix("_host");
+    const std::string device_suffix("_device");
+    if (name.size() > host_suffix.size() &&
+        name.compare(name.size()-host_suffix.size(), host_suffix.size(), host_suffix) == 0)
+        {
+        location = host;
+        name = name.substr(0, name.size()-host_suffix.size());
+        }
+    else if (name.size() > device_suffix.size() &&
+        name.compare(name.size()-device_suffix.size(), device_suffix.size(), device_suffix) == 0)
+        {
+        location = device;
+        name = name.substr(0, name.size()-device_suffix.size());
+        }
+    else
+        return false;
+
+    value = Scalar(peak ? getPeakBytes(name, location) : getCurrentBytes(name, location));
+    return true;
+    }
+
+//! Print a number of bytes in MB
+inline std::string megabytes(size_t nbytes)
+    {
+    std::ostringstream oss;
+    oss << std::fixed << std::setprecision(1) << double(nbytes)/(1024.0*1024.0) << " MB";
+    return oss.str();
+    }
+
+void MemoryUsage::outputSummary(std::shared_ptr<Messenger> msg) const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    msg->notice(3) << "Memory usage per subsystem (current / peak):" << std::endl;
+    for (unsigned int id = 0; id < m_names.size(); ++id)
+        {
+        if (m_peak[host][id] == 0 && m_peak[device][id] == 0)
+            continue;
+
+        msg->notice(3) << "** " << std::left << std::setw(20) << m_names[id]
+            << " host " << megabytes(m_current[host][id]) << " / " << megabytes(m_peak[host][id])
+            << ", device " << megabytes(m_current[device][id]) << " / " << megabytes(m_peak[device][id])
+            << std::endl;
+        }
+    msg->notice(3) << "** " << std::left << std::setw(20) << "total"
+        << " host " << megabytes(m_total[host]) << " / " << megabytes(m_total_peak[host])
+        << ", device " << megabytes(m_total[device]) << " / " << megabytes(m_total_peak[device])
+        << std::endl;
+    }
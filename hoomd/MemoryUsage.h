@@ -0,0 +1,157 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: jglaser
+
+#pragma once
+
+/*! \file MemoryUsage.h
+    \brief Declares a class for accounting of memory usage per subsystem
+*/
+
+#include "HOOMDMath.h"
+#include "Messenger.h"
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+//! Keeps track of the current and peak memory usage of every subsystem
+/*! Unlike MemoryTraceback, which records a stack trace of every allocation for debugging, MemoryUsage is always on
+    and only maintains a few counters per owner. Every GPUArray and GlobalArray allocation is attributed to the
+    current owner, which is set with a MemoryUsageScope by the subsystem allocating the memory (ParticleData,
+    NeighborList, CellList, Communicator, ...). Allocations outside of any scope are attributed to the owner
+    \c other.
+
+    Host memory includes pinned memory, device memory includes managed memory. The counters are local to the MPI rank.
+
+    The current and peak bytes per owner are available as log quantities \c memory_<owner>_host,
+    \c memory_<owner>_host_peak, \c memory_<owner>_device and \c memory_<owner>_device_peak, and summed over all
+    owners as \c memory_total_host etc.
+*/
+class PYBIND11_EXPORT MemoryUsage
+    {
+    public:
+        //! Location of the memory
+        enum memory_location
+            {
+            host = 0,
+            device,
+            num_locations
+            };
+
+        //! Constructor
+        MemoryUsage();
+
+        //! Get the ID of an owner, adding it if necessary
+        /*! \param owner Name of the owner
+         */
+        unsigned int getOwnerID(const std::string& owner);
+
+        //! Get the ID of the current owner
+        unsigned int getCurrentOwner() const
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            return m_owner_stack.empty() ? 0 : m_owner_stack.back();
+            }
+
+        //! Make an owner the current owner
+        /*! \param id ID of the owner
+         */
+        void pushOwner(unsigned int id)
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_owner_stack.push_back(id);
+            }
+
+        //! Restore the previous owner
+        void popOwner()
+            {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_owner_stack.pop_back();
+            }
+
+        //! Account for an allocation
+        /*! \param owner ID of the owner
+            \param location Location of the memory
+            \param nbytes Size of the allocation
+         */
+        void registerAllocation(unsigned int owner, memory_location location, size_t nbytes);
+
+        //! Account for the release of an allocation
+        /*! \param owner ID of the owner
+            \param location Location of the memory
+            \param nbytes Size of the allocation
+         */
+        void unregisterAllocation(unsigned int owner, memory_location location, size_t nbytes);
+
+        //! Get the names of all owners
+        std::vector<std::string> getOwners() const;
+
+        //! Get the number of bytes currently allocated by an owner
+        /*! \param owner Name of the owner, or "total"
+            \param location Location of the memory
+         */
+        size_t getCurrentBytes(const std::string& owner, memory_location location) const;
+
+        //! Get the maximum number of bytes allocated by an owner at any time
+        /*! \param owner Name of the owner, or "total"
+            \param location Location of the memory
+         */
+        size_t getPeakBytes(const std::string& owner, memory_location location) const;
+
+        //! Get the value of a memory log quantity
+        /*! \param quantity Name of the quantity
+            \param value The current or peak bytes (output)
+            \returns true if \a quantity is a memory log quantity
+         */
+        bool getLogValue(const std::string& quantity, Scalar& value) const;
+
+        //! Print a table of the current and peak memory usage per owner
+        void outputSummary(std::shared_ptr<Messenger> msg) const;
+
+    private:
+        mutable std::mutex m_mutex;                        //!< Protects the counters
+        std::vector<std::string> m_names;                  //!< Name per owner ID
+        std::map<std::string, unsigned int> m_ids;         //!< ID per owner name
+        std::vector<size_t> m_current[num_locations];      //!< Current bytes per owner
+        std::vector<size_t> m_peak[num_locations];         //!< Peak bytes per owner
+        size_t m_total[num_locations];                     //!< Current bytes of all owners
+        size_t m_total_peak[num_locations];                //!< Peak bytes of all owners
+        std::vector<unsigned int> m_owner_stack;           //!< Stack of the current owners
+    };
+
+//! Attributes all allocations during its lifetime to a given owner
+/*! Usage:
+    \code
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "NeighborList");
+    \endcode
+*/
+class PYBIND11_EXPORT MemoryUsageScope
+    {
+    public:
+        //! Constructor
+        /*! \param usage The memory usage accounting (may be null)
+            \param owner Name of the owner
+         */
+        MemoryUsageScope(MemoryUsage *usage, const std::string& owner)
+            : m_usage(usage)
+            {
+            if (m_usage)
+                m_usage->pushOwner(m_usage->getOwnerID(owner));
+            }
+
+        //! Destructor
+        ~MemoryUsageScope()
+            {
+            if (m_usage)
+                m_usage->popOwner();
+            }
+
+        MemoryUsageScope(const MemoryUsageScope&) = delete;
+        MemoryUsageScope& operator=(const MemoryUsageScope&) = delete;
+
+    private:
+        MemoryUsage *m_usage;      //!< The memory usage accounting
+    };
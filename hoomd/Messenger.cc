@@ -17,6 +17,13 @@
 
 #include <hoomd/extern/pybind/include/pybind11/iostream.h>
 #include <sstream>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 #include <assert.h>
 using namespace std;
 
@@ -46,13 +53,189 @@ class mpi_io : public std::streambuf
         //! Write a character
         virtual int overflow( int ch );
 
+        //! Write the buffered characters to the file
+        virtual int sync();
+
     private:
         MPI_Comm m_mpi_comm;        //!< The MPI communicator
         MPI_File m_file;            //!< The file handle
         bool m_file_open;           //!< Whether the file is open
+        std::vector<char> m_buffer; //!< Characters not yet written
     };
 #endif
 
+//! Streambuf that writes to another streambuf on a background thread
+/*! Characters are copied into a ring buffer under a mutex. The writer thread drains the ring buffer into the target
+    when sync() is called (i.e. by std::endl or std::flush), when the ring buffer is half full, and otherwise at least
+    every 100 ms. A caller only waits for the writer thread when the ring buffer is full or in drain().
+*/
+class async_logbuf : public std::streambuf
+    {
+    public:
+        //! Constructor
+        async_logbuf(std::streambuf *target, std::shared_ptr<std::ostream> owner, unsigned int buffer_size);
+
+        //! Destructor
+        virtual ~async_logbuf();
+
+        //! Block until all buffered characters are written to the target
+        void drain();
+
+    protected:
+        //! Write a sequence of characters
+        virtual std::streamsize xsputn(const char *s, std::streamsize n);
+
+        //! Write a character
+        virtual int overflow(int ch);
+
+        //! Request that the buffered characters are written out
+        virtual int sync();
+
+    private:
+        std::streambuf *m_target;               //!< Streambuf the characters are written to
+        std::shared_ptr<std::ostream> m_owner;  //!< Keeps the stream that owns the target alive (may be NULL)
+        std::vector<char> m_ring;               //!< Ring buffer
+        size_t m_head;                          //!< Index of the first buffered character
+        size_t m_size;                          //!< Number of buffered characters
+        std::string m_out;                      //!< Characters being written by the writer thread
+        bool m_flush_requested;                 //!< True when the buffered characters should be written out
+        bool m_writing;                         //!< True while the writer thread writes to the target
+        bool m_exit;                            //!< Set to true to stop the writer thread
+        std::mutex m_mutex;                     //!< Protects the ring buffer and the writer state
+        std::condition_variable m_cv;           //!< Signals changes of the ring buffer and the writer state
+        std::thread m_thread;                   //!< The writer thread
+
+        //! Main loop of the writer thread
+        void writerThread();
+    };
+
+/*! \param target Streambuf to write to
+    \param owner Stream that owns \a target, kept alive as long as the buffer (may be NULL)
+    \param buffer_size Size of the ring buffer in bytes
+*/
+async_logbuf::async_logbuf(std::streambuf *target, std::shared_ptr<std::ostream> owner, unsigned int buffer_size)
+    : m_target(target), m_owner(owner), m_ring(std::max(buffer_size, 1u)), m_head(0), m_size(0),
+      m_flush_requested(false), m_writing(false), m_exit(false)
+    {
+    m_thread = std::thread(&async_logbuf::writerThread, this);
+    }
+
+async_logbuf::~async_logbuf()
+    {
+        {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_exit = true;
+        }
+    m_cv.notify_all();
+    m_thread.join();
+    }
+
+void async_logbuf::drain()
+    {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_flush_requested = true;
+    m_cv.notify_all();
+    m_cv.wait(lock, [this] { return m_size == 0 && !m_writing; });
+    }
+
+/*! \param s Characters to write
+    \param n Number of characters
+    \returns \a n
+*/
+std::streamsize async_logbuf::xsputn(const char *s, std::streamsize n)
+    {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const size_t capacity = m_ring.size();
+    std::streamsize written = 0;
+    while (written < n)
+        {
+        if (m_size == capacity)
+            {
+            // wait for the writer thread to make space
+            m_flush_requested = true;
+            m_cv.notify_all();
+            m_cv.wait(lock, [this, capacity] { return m_size < capacity; });
+            }
+
+        // copy up to the end of the free space or the end of the ring
+        const size_t tail = (m_head + m_size) % capacity;
+        const size_t count = std::min(size_t(n - written), std::min(capacity - m_size, capacity - tail));
+        std::copy(s + written, s + written + count, m_ring.begin() + tail);
+        m_size += count;
+        written += count;
+        }
+
+    if (m_size >= capacity/2)
+        m_cv.notify_all();
+    return n;
+    }
+
+/*! \param ch Character to write
+    \returns \a ch
+*/
+int async_logbuf::overflow(int ch)
+    {
+    if (ch == traits_type::eof())
+        return traits_type::not_eof(ch);
+
+    char c = traits_type::to_char_type(ch);
+    xsputn(&c, 1);
+    return ch;
+    }
+
+/*! \returns 0
+
+    The characters are written out by the writer thread, sync() does not wait for them.
+*/
+int async_logbuf::sync()
+    {
+        {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_flush_requested = true;
+        }
+    m_cv.notify_all();
+    return 0;
+    }
+
+/*! The writer thread moves the buffered characters out of the ring buffer and writes them to the target without
+    holding the lock. The loop exits when m_exit is set and the ring buffer is empty.
+*/
+void async_logbuf::writerThread()
+    {
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+        {
+        m_cv.wait_for(lock, std::chrono::milliseconds(100),
+            [this] { return m_exit || m_flush_requested || m_size >= m_ring.size()/2; });
+        m_flush_requested = false;
+
+        if (m_size == 0)
+            {
+            if (m_exit)
+                break;
+            continue;
+            }
+
+        // move the characters out of the ring buffer
+        const size_t first = std::min(m_size, m_ring.size() - m_head);
+        m_out.assign(m_ring.data() + m_head, first);
+        m_out.append(m_ring.data(), m_size - first);
+        m_head = (m_head + m_size) % m_ring.size();
+        m_size = 0;
+        m_writing = true;
+        m_cv.notify_all();
+
+        // perform the I/O without holding the lock
+        lock.unlock();
+        m_target->sputn(m_out.data(), m_out.size());
+        m_target->pubsync();
+        lock.lock();
+
+        m_writing = false;
+        m_cv.notify_all();
+        }
+    }
+
 /*! \post Warning and error streams are set to cerr
     \post The notice stream is set to cout
     \post The notice level is set to 2
@@ -65,6 +248,8 @@ Messenger::Messenger()
     m_notice_stream = &cout;
 
     m_nullstream = std::shared_ptr<nullstream>(new nullstream());
+    m_async = false;
+    m_async_buffer_size = 1 << 20;
     m_notice_level = 2;
     m_err_prefix     = "**ERROR**";
     m_warning_prefix = "*Warning*";
@@ -97,6 +282,12 @@ Messenger::Messenger(const Messenger& msg)
     m_nullstream = msg.m_nullstream;
     m_file_out = msg.m_file_out;
     m_file_err = msg.m_file_err;
+    m_async = msg.m_async;
+    m_async_buffer_size = msg.m_async_buffer_size;
+    m_async_buf_warning = msg.m_async_buf_warning;
+    m_async_buf_notice = msg.m_async_buf_notice;
+    m_async_warning = msg.m_async_warning;
+    m_async_notice = msg.m_async_notice;
     m_err_prefix = msg.m_err_prefix;
     m_warning_prefix = msg.m_warning_prefix;
     m_notice_prefix = msg.m_notice_prefix;
@@ -129,6 +320,12 @@ Messenger& Messenger::operator=(Messenger& msg)
     m_nullstream = msg.m_nullstream;
     m_file_out = msg.m_file_out;
     m_file_err = msg.m_file_err;
+    m_async = msg.m_async;
+    m_async_buffer_size = msg.m_async_buffer_size;
+    m_async_buf_warning = msg.m_async_buf_warning;
+    m_async_buf_notice = msg.m_async_buf_notice;
+    m_async_warning = msg.m_async_warning;
+    m_async_notice = msg.m_async_notice;
     m_err_prefix = msg.m_err_prefix;
     m_warning_prefix = msg.m_warning_prefix;
     m_notice_prefix = msg.m_notice_prefix;
@@ -187,6 +384,10 @@ std::ostream& Messenger::error() const
         if (! m_has_lock) return *m_nullstream;
         }
     #endif
+
+    // errors are written synchronously, after any buffered output
+    flush();
+
     if (m_err_prefix != string(""))
         *m_err_stream << m_err_prefix << ": ";
     if (m_nranks > 1)
@@ -211,9 +412,10 @@ std::ostream& Messenger::warning() const
     if (m_rank != 0) return *m_nullstream;
 
     assert(m_warning_stream);
+    std::ostream& stream = getWarningStream();
     if (m_warning_prefix != string(""))
-        *m_warning_stream << m_warning_prefix << ": ";
-    return *m_warning_stream;
+        stream << m_warning_prefix << ": ";
+    return stream;
     }
 
 /*! \param msg Message to print
@@ -235,9 +437,10 @@ std::ostream& Messenger::notice(unsigned int level) const
     assert(m_notice_stream);
     if (level <= m_notice_level)
         {
+        std::ostream& stream = getNoticeStream();
         if (m_notice_prefix != string("") && level > 1)
-            *m_notice_stream << m_notice_prefix << "(" << level << "): ";
-        return *m_notice_stream;
+            stream << m_notice_prefix << "(" << level << "): ";
+        return stream;
         }
     else
         {
@@ -308,17 +511,103 @@ void Messenger::noticeStr(unsigned int level, const std::string& msg) const
     notice(level) << msg << std::flush;
     }
 
+/*! \param async True to write warnings and notices on a background thread
+    \param buffer_size Size of the ring buffer of each stream in bytes
+
+    Streams that write to python's sys.stdout and sys.stderr (openPython()) or to the shared MPI-IO log file
+    (setSharedFile()) are not buffered, because their writes must be performed by the thread that holds the GIL or
+    calls MPI.
+*/
+void Messenger::setAsync(bool async, unsigned int buffer_size)
+    {
+    if (buffer_size == 0)
+        {
+        error() << "The message buffer size must be greater than zero" << endl;
+        throw runtime_error("Error setting message options");
+        }
+
+    releaseAsync();
+    m_async = async;
+    m_async_buffer_size = buffer_size;
+    applyAsync();
+    }
+
+/*! Blocks until all buffered warnings and notices are written to their streams.
+*/
+void Messenger::flush() const
+    {
+    if (m_async_buf_warning)
+        m_async_buf_warning->drain();
+    if (m_async_buf_notice && m_async_buf_notice != m_async_buf_warning)
+        m_async_buf_notice->drain();
+    }
+
+/*! The warning and notice streams share one buffer if they write to the same streambuf, so that their messages
+    stay in order.
+*/
+void Messenger::applyAsync()
+    {
+    if (!m_async)
+        return;
+
+    std::streambuf *warning_buf = m_warning_stream->rdbuf();
+    std::streambuf *notice_buf = m_notice_stream->rdbuf();
+
+    // the python and MPI-IO streambufs are managed by the Messenger and may not be written by another thread
+    if (warning_buf && warning_buf != m_streambuf_out.get() && warning_buf != m_streambuf_err.get())
+        {
+        std::shared_ptr<std::ostream> owner;
+        if (m_warning_stream == m_file_out.get())
+            owner = m_file_out;
+        else if (m_warning_stream == m_file_err.get())
+            owner = m_file_err;
+        m_async_buf_warning = std::shared_ptr<async_logbuf>(new async_logbuf(warning_buf, owner, m_async_buffer_size));
+        m_async_warning = std::shared_ptr<std::ostream>(new std::ostream(m_async_buf_warning.get()));
+        }
+
+    if (notice_buf && notice_buf == warning_buf)
+        {
+        m_async_buf_notice = m_async_buf_warning;
+        m_async_notice = m_async_warning;
+        }
+    else if (notice_buf && notice_buf != m_streambuf_out.get() && notice_buf != m_streambuf_err.get())
+        {
+        std::shared_ptr<std::ostream> owner;
+        if (m_notice_stream == m_file_out.get())
+            owner = m_file_out;
+        else if (m_notice_stream == m_file_err.get())
+            owner = m_file_err;
+        m_async_buf_notice = std::shared_ptr<async_logbuf>(new async_logbuf(notice_buf, owner, m_async_buffer_size));
+        m_async_notice = std::shared_ptr<std::ostream>(new std::ostream(m_async_buf_notice.get()));
+        }
+    }
+
+/*! Copies of this Messenger that share the buffered streams keep using them.
+*/
+void Messenger::releaseAsync()
+    {
+    flush();
+    m_async_warning.reset();
+    m_async_notice.reset();
+    m_async_buf_warning.reset();
+    m_async_buf_notice.reset();
+    }
+
 /*! \param fname File name
     The file is overwritten if it exists. If there is an error opening the file, all level's streams are left
     as is and an error() is issued.
 */
 void Messenger::openFile(const std::string& fname)
     {
+    releaseAsync();
+
     m_file_out = std::shared_ptr<std::ostream>(new ofstream(fname.c_str()));
     m_file_err = std::shared_ptr<std::ostream>();
     m_err_stream = m_file_out.get();
     m_warning_stream = m_file_out.get();
     m_notice_stream = m_file_out.get();
+
+    applyAsync();
     }
 
 /*! Sets all messenger output streams to ones that use PySys_WriteStd* functions so that messenger output
@@ -329,6 +618,8 @@ void Messenger::openFile(const std::string& fname)
 */
 void Messenger::openPython()
     {
+    releaseAsync();
+
     pybind11::object pystdout = pybind11::module::import("sys").attr("stdout");
     m_streambuf_out = std::shared_ptr<std::streambuf>(new pybind11::detail::pythonbuf(pystdout));
     pybind11::object pystderr = pybind11::module::import("sys").attr("stderr");
@@ -341,6 +632,8 @@ void Messenger::openPython()
     m_err_stream = m_file_err.get();
     m_warning_stream = m_file_err.get();
     m_notice_stream = m_file_out.get();
+
+    applyAsync();
     }
 
 #ifdef ENABLE_MPI
@@ -351,6 +644,8 @@ void Messenger::openPython()
 */
 void Messenger::openSharedFile()
     {
+    releaseAsync();
+
     std::ostringstream oss;
     oss << m_shared_filename << "." << m_partition;
     m_streambuf_out = std::shared_ptr< std::streambuf >(new mpi_io((const MPI_Comm&) m_mpi_comm, oss.str()));
@@ -361,6 +656,8 @@ void Messenger::openSharedFile()
     m_err_stream = m_file_out.get();
     m_warning_stream = m_file_out.get();
     m_notice_stream = m_file_out.get();
+
+    applyAsync();
     }
 #endif
 
@@ -368,11 +665,15 @@ void Messenger::openSharedFile()
 */
 void Messenger::openStd()
     {
+    releaseAsync();
+
     m_file_out = std::shared_ptr<std::ostream>();
     m_file_err = std::shared_ptr<std::ostream>();
     m_err_stream = &cerr;
     m_warning_stream = &cerr;
     m_notice_stream = &cout;
+
+    applyAsync();
     }
 
 #ifdef ENABLE_MPI
@@ -380,8 +681,11 @@ void Messenger::openStd()
     \param mpi_comm The MPI communicator to use for MPI file IO
  */
 mpi_io::mpi_io(const MPI_Comm& mpi_comm, const std::string& filename)
-    : m_mpi_comm(mpi_comm),  m_file_open(false)
+    : m_mpi_comm(mpi_comm),  m_file_open(false), m_buffer(4096)
     {
+    // buffer the characters so that a message is written with a single call, instead of one call per character
+    setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
+
     assert(m_mpi_comm);
 
     // overwrite old file
@@ -398,16 +702,31 @@ int mpi_io::overflow( int ch )
     {
     assert(m_file_open);
 
-    char out_data = char(ch);
+    sync();
+    if (ch != traits_type::eof())
+        {
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        }
+    return traits_type::not_eof(ch);
+    }
 
-    // write value to log file using MPI-IO
-    MPI_Status status;
-    MPI_File_write_shared(m_file, &out_data, 1, MPI_CHAR, &status);
+int mpi_io::sync()
+    {
+    const int n = pptr() - pbase();
+    if (n > 0 && m_file_open)
+        {
+        // write the buffered characters to the log file using MPI-IO
+        MPI_Status status;
+        MPI_File_write_shared(m_file, pbase(), n, MPI_CHAR, &status);
+        }
+    setp(m_buffer.data(), m_buffer.data() + m_buffer.size());
     return 0;
     }
 
 void mpi_io::close()
     {
+    sync();
     if (m_file_open)
         MPI_File_close(&m_file);
 
@@ -455,5 +774,8 @@ void export_Messenger(py::module& m)
         .def("setSharedFile", &Messenger::setSharedFile)
 #endif
         .def("openStd", &Messenger::openStd)
+        .def("setAsync", &Messenger::setAsync)
+        .def("getAsync", &Messenger::getAsync)
+        .def("flush", &Messenger::flush)
          ;
     }
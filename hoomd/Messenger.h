@@ -35,6 +35,9 @@ struct PYBIND11_EXPORT nullstream: std::ostream
     nullstream(): std::ios(0), std::ostream(0) {}
     };
 
+//! Streambuf that hands its output to a background thread (defined in Messenger.cc)
+class async_logbuf;
+
 //! Utility class for controlling message printing
 /*! Large code projects need something more intelligent than just cout's for warning and
     notices and cerr for errors. To aid in user debugging, multiple levels of notice messages are required. Not all
@@ -74,6 +77,10 @@ struct PYBIND11_EXPORT nullstream: std::ostream
      - Arbitrary streams may be set - however, since they are stored by pointer the caller is responsible for
        deleting them when set in this manner.
      - An alternate interface openFile opens a file for overwrite for all output levels, owned by the Messenger.
+     - With setAsync(), warnings and notices are copied into a ring buffer and written to their streams by a
+       background thread, so that verbose notice levels do not stall the simulation on I/O. Errors are always
+       written synchronously after the buffered output is flushed, so they appear in order before an exception or
+       MPI_Abort. The shared MPI-IO log file is not buffered, since only the main thread may call MPI.
 
     \b HOOMD specific
 
@@ -137,6 +144,18 @@ class PYBIND11_EXPORT Messenger
         //! Alternate method to print notice strings
         void noticeStr(unsigned int level, const std::string& msg) const;
 
+        //! Set whether warnings and notices are written by a background thread
+        void setAsync(bool async, unsigned int buffer_size);
+
+        //! Get whether warnings and notices are written by a background thread
+        bool getAsync() const
+            {
+            return m_async;
+            }
+
+        //! Write out all buffered messages
+        void flush() const;
+
         //! Set processor rank
         /*! Error and warning messages are prefixed with rank information.
 
@@ -218,7 +237,9 @@ class PYBIND11_EXPORT Messenger
         */
         void setErrorStream(std::ostream& stream)
             {
+            releaseAsync();
             m_err_stream = &stream;
+            applyAsync();
             }
 
         //! Set the warning stream
@@ -226,7 +247,9 @@ class PYBIND11_EXPORT Messenger
         */
         void setWarningStream(std::ostream& stream)
             {
+            releaseAsync();
             m_warning_stream = &stream;
+            applyAsync();
             }
 
         //! Set the notice stream
@@ -234,7 +257,9 @@ class PYBIND11_EXPORT Messenger
         */
         void setNoticeStream(std::ostream& stream)
             {
+            releaseAsync();
             m_notice_stream = &stream;
+            applyAsync();
             }
 
         //! Get the null stream
@@ -345,6 +370,13 @@ class PYBIND11_EXPORT Messenger
         std::shared_ptr<std::ostream>  m_file_out;     //!< File stream (stdout)
         std::shared_ptr<std::ostream>  m_file_err;     //!< File stream (stderr)
 
+        bool m_async;                                   //!< True if warnings and notices are buffered
+        unsigned int m_async_buffer_size;               //!< Size of the ring buffers in bytes
+        std::shared_ptr<async_logbuf> m_async_buf_warning;  //!< Buffer of the warning stream
+        std::shared_ptr<async_logbuf> m_async_buf_notice;   //!< Buffer of the notice stream
+        std::shared_ptr<std::ostream> m_async_warning;  //!< Buffered warning stream
+        std::shared_ptr<std::ostream> m_async_notice;   //!< Buffered notice stream
+
         std::string m_err_prefix;       //!< Prefix for error messages
         std::string m_warning_prefix;   //!< Prefix for warning messages
         std::string m_notice_prefix;    //!< Prefix for notice messages
@@ -355,6 +387,24 @@ class PYBIND11_EXPORT Messenger
         unsigned int m_partition;       //!< The MPI partition
         unsigned int m_nranks;          //!< Number of ranks in communicator
 
+        //! Get the stream that warnings are written to
+        std::ostream& getWarningStream() const
+            {
+            return m_async_warning ? *m_async_warning : *m_warning_stream;
+            }
+
+        //! Get the stream that notices are written to
+        std::ostream& getNoticeStream() const
+            {
+            return m_async_notice ? *m_async_notice : *m_notice_stream;
+            }
+
+        //! Create the buffered streams for the current warning and notice streams
+        void applyAsync();
+
+        //! Flush and release the buffered streams
+        void releaseAsync();
+
 #ifdef ENABLE_MPI
         std::string m_shared_filename;  //!< Filename of shared log file
         MPI_Comm m_mpi_comm;            //!< The MPI communicator
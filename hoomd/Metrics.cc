@@ -0,0 +1,103 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+/*! \file Metrics.cc
+    \brief Implements a registry of live performance metrics
+*/
+
+#include "Metrics.h"
+
+#include <iomanip>
+#include <limits>
+
+unsigned int Metrics::registerMetric(const std::string& family,
+                                     const std::string& labels,
+                                     const std::string& help,
+                                     metric_type type,
+                                     reduction_type reduction)
+    {
+    std::string name = family;
+    if (type == counter)
+        name += "_total";
+    if (!labels.empty())
+        name += "{" + labels + "}";
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_ids.find(name);
+    if (it != m_ids.end())
+        return it->second;
+
+    unsigned int id = m_metrics.size();
+    m_metrics.emplace_back(family, name, type, reduction);
+    m_ids[name] = id;
+    m_help[family] = help;
+    return id;
+    }
+
+std::vector<std::string> Metrics::getNames() const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<std::string> names;
+    for (auto it = m_ids.begin(); it != m_ids.end(); ++it)
+        names.push_back(it->first);
+    return names;
+    }
+
+bool Metrics::getValue(const std::string& name, double& value) const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_ids.find(name);
+    if (it == m_ids.end())
+        return false;
+
+    value = m_metrics[it->second].value.load(std::memory_order_relaxed);
+    return true;
+    }
+
+Metrics::reduction_type Metrics::getReduction(const std::string& name) const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    auto it = m_ids.find(name);
+    return (it != m_ids.end()) ? m_metrics[it->second].reduction : sum;
+    }
+
+/*! The samples of a family are written together after its TYPE and HELP lines. Metrics that are not registered on
+    this rank (but were on the rank that determined \a names) are written as untyped gauges.
+*/
+void Metrics::writeOpenMetrics(std::ostream& o,
+                               const std::vector<std::string>& names,
+                               const std::vector<double>& values) const
+    {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    // group the samples by family
+    std::map<std::string, std::vector<unsigned int> > families;
+    for (unsigned int i = 0; i < names.size(); ++i)
+        {
+        auto it = m_ids.find(names[i]);
+        std::string family = (it != m_ids.end()) ? m_metrics[it->second].family : names[i].substr(0, names[i].find('{'));
+        families[family].push_back(i);
+        }
+
+    o << std::setprecision(std::numeric_limits<double>::digits10 + 1);
+    for (auto f = families.begin(); f != families.end(); ++f)
+        {
+        auto it = m_ids.find(names[f->second[0]]);
+        metric_type type = (it != m_ids.end()) ? m_metrics[it->second].type : gauge;
+
+        o << "# TYPE " << f->first << " " << (type == counter ? "counter" : "gauge") << "\n";
+        auto h = m_help.find(f->first);
+        if (h != m_help.end())
+            o << "# HELP " << f->first << " " << h->second << "\n";
+
+        for (unsigned int j = 0; j < f->second.size(); ++j)
+            o << names[f->second[j]] << " " << values[f->second[j]] << "\n";
+        }
+    o << "# EOF\n";
+    }
@@ -0,0 +1,190 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+#pragma once
+
+/*! \file Metrics.h
+    \brief Declares a registry of live performance metrics
+*/
+
+#include "HOOMDMath.h"
+#include "ClockSource.h"
+
+#include <atomic>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <vector>
+
+//! Registry of live performance metrics published by the subsystems
+/*! Subsystems register each metric once, typically in their constructor, and then update it through its ID with
+    add() (counters) or set() (gauges). Updates are relaxed atomic operations without locks, so they are cheap enough
+    to be made every time step and from TBB threads. MetricsExporter periodically reduces the metrics over the MPI
+    ranks and exports them in the OpenMetrics text format.
+
+    A metric is identified by its family name and an optional label set, e.g. the family \c hoomd_compute_seconds
+    with the labels \c compute="pair_lj". Counter samples get the suffix \c _total. Values are local to the MPI rank,
+    each metric declares whether the exporter sums or maximizes it over the ranks.
+*/
+class PYBIND11_EXPORT Metrics
+    {
+    public:
+        //! Kind of metric
+        enum metric_type
+            {
+            counter = 0,    //!< Monotonically increasing total
+            gauge           //!< Current value
+            };
+
+        //! Reduction of a metric over the MPI ranks
+        enum reduction_type
+            {
+            sum = 0,
+            max
+            };
+
+        //! Register a metric, or get the ID of a metric that is already registered
+        /*! \param family Family name of the metric
+            \param labels Label set of the metric, e.g. \c compute="pair_lj" (may be empty)
+            \param help Description of the metric family
+            \param type Kind of metric
+            \param reduction Reduction over the MPI ranks
+            \returns The ID of the metric
+         */
+        unsigned int registerMetric(const std::string& family,
+                                    const std::string& labels,
+                                    const std::string& help,
+                                    metric_type type,
+                                    reduction_type reduction);
+
+        //! Increment a counter
+        /*! \param id ID of the metric
+            \param value Increment
+         */
+        void add(unsigned int id, double value)
+            {
+            std::atomic<double>& v = m_metrics[id].value;
+            double old = v.load(std::memory_order_relaxed);
+            while (!v.compare_exchange_weak(old, old + value, std::memory_order_relaxed))
+                ;
+            }
+
+        //! Set the value of a gauge
+        /*! \param id ID of the metric
+            \param value New value
+         */
+        void set(unsigned int id, double value)
+            {
+            m_metrics[id].value.store(value, std::memory_order_relaxed);
+            }
+
+        //! Get the current value of a metric
+        /*! \param id ID of the metric
+         */
+        double get(unsigned int id) const
+            {
+            return m_metrics[id].value.load(std::memory_order_relaxed);
+            }
+
+        //! Register the metric of the time spent waiting for the point to point messages of the Communicator
+        unsigned int registerExchangeWaitTime()
+            {
+            return registerMetric("hoomd_comm_wait_seconds", "",
+                "Time spent waiting for point to point MPI messages", counter, sum);
+            }
+
+        //! Register the metric of the time spent in the MPI collectives of the time step loop
+        unsigned int registerCollectiveTime()
+            {
+            return registerMetric("hoomd_mpi_collective_seconds", "",
+                "Time spent in MPI collectives of the time step loop", counter, sum);
+            }
+
+        //! Get the sample names of all metrics
+        std::vector<std::string> getNames() const;
+
+        //! Get the current value of a metric by its sample name
+        /*! \param name Sample name of the metric
+            \param value The value (output)
+            \returns true if the metric is registered
+         */
+        bool getValue(const std::string& name, double& value) const;
+
+        //! Get the reduction of a metric by its sample name
+        /*! \param name Sample name of the metric
+            \returns The reduction, sum for unknown metrics
+         */
+        reduction_type getReduction(const std::string& name) const;
+
+        //! Write metrics in the OpenMetrics text format
+        /*! \param o Stream to write to
+            \param names Sample names of the metrics to write
+            \param values Values of the metrics, in the order of \a names
+         */
+        void writeOpenMetrics(std::ostream& o,
+                              const std::vector<std::string>& names,
+                              const std::vector<double>& values) const;
+
+    private:
+        //! A registered metric
+        struct metric
+            {
+            //! Constructor
+            metric(const std::string& _family, const std::string& _name, metric_type _type, reduction_type _reduction)
+                : family(_family), name(_name), type(_type), reduction(_reduction), value(0.0)
+                {
+                }
+
+            std::string family;         //!< Family name
+            std::string name;           //!< Sample name with suffix and labels
+            metric_type type;           //!< Kind of metric
+            reduction_type reduction;   //!< Reduction over the ranks
+            std::atomic<double> value;  //!< Current value
+            };
+
+        mutable std::mutex m_mutex;                         //!< Protects the registration
+        std::deque<metric> m_metrics;                       //!< Metrics by ID (a deque keeps them in place)
+        std::map<std::string, unsigned int> m_ids;          //!< ID per sample name
+        std::map<std::string, std::string> m_help;          //!< Description per family name
+    };
+
+//! Adds the wall clock time of its lifetime to a counter
+/*! Usage:
+    \code
+        {
+        MetricsTimer timer(m_exec_conf->getMetrics(), m_metric_collective_time);
+        MPI_Allreduce(...);
+        }
+    \endcode
+*/
+class PYBIND11_EXPORT MetricsTimer
+    {
+    public:
+        //! Constructor
+        /*! \param metrics The metrics registry
+            \param id ID of the counter
+         */
+        MetricsTimer(Metrics *metrics, unsigned int id)
+            : m_metrics(metrics), m_id(id), m_start_time(m_clk.getTime())
+            {
+            }
+
+        //! Destructor
+        ~MetricsTimer()
+            {
+            m_metrics->add(m_id, double(m_clk.getTime() - m_start_time)*1e-9);
+            }
+
+        MetricsTimer(const MetricsTimer&) = delete;
+        MetricsTimer& operator=(const MetricsTimer&) = delete;
+
+    private:
+        Metrics *m_metrics;     //!< The metrics registry
+        unsigned int m_id;      //!< ID of the counter
+        ClockSource m_clk;      //!< Clock
+        int64_t m_start_time;   //!< Time at construction
+    };
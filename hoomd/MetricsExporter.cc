@@ -0,0 +1,253 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+/*! \file MetricsExporter.cc
+    \brief Defines the MetricsExporter class
+*/
+
+#include "MetricsExporter.h"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace std;
+namespace py = pybind11;
+
+/*! \param sysdef System definition
+    \param fname File to write the metrics to, empty to disable
+    \param port TCP port to serve the metrics on, negative to disable
+*/
+MetricsExporter::MetricsExporter(std::shared_ptr<SystemDefinition> sysdef, const std::string& fname, int port)
+    : Analyzer(sysdef), m_fname(fname), m_port(port), m_has_last(false), m_last_time(0), m_last_timestep(0),
+      m_snapshot("# EOF\n"), m_listen_fd(-1), m_server_exit(false)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing MetricsExporter" << endl;
+
+    Metrics *metrics = m_exec_conf->getMetrics();
+    m_metric_timestep = metrics->registerMetric("hoomd_timestep", "",
+        "Current time step", Metrics::gauge, Metrics::max);
+    m_metric_tps = metrics->registerMetric("hoomd_tps", "",
+        "Time steps per second since the previous export", Metrics::gauge, Metrics::max);
+    m_metric_host_bytes = metrics->registerMetric("hoomd_memory_host_bytes", "",
+        "Host memory allocated by HOOMD", Metrics::gauge, Metrics::sum);
+    m_metric_device_bytes = metrics->registerMetric("hoomd_memory_device_bytes", "",
+        "Device and managed memory allocated by HOOMD", Metrics::gauge, Metrics::sum);
+    m_metric_gpu_used_bytes = metrics->registerMetric("hoomd_gpu_memory_used_bytes", "",
+        "Memory in use on the GPUs, including other processes", Metrics::gauge, Metrics::sum);
+
+    if (m_port >= 0 && m_exec_conf->getRank() == 0)
+        {
+        m_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (m_listen_fd < 0)
+            {
+            m_exec_conf->msg->error() << "analyze.metrics: cannot create socket: " << strerror(errno) << endl;
+            throw runtime_error("Error initializing MetricsExporter");
+            }
+
+        int reuse = 1;
+        setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_ANY);
+        addr.sin_port = htons(m_port);
+        if (bind(m_listen_fd, (struct sockaddr *) &addr, sizeof(addr)) < 0 || listen(m_listen_fd, 8) < 0)
+            {
+            m_exec_conf->msg->error() << "analyze.metrics: cannot listen on port " << m_port << ": "
+                                      << strerror(errno) << endl;
+            close(m_listen_fd);
+            m_listen_fd = -1;
+            throw runtime_error("Error initializing MetricsExporter");
+            }
+
+        m_exec_conf->msg->notice(2) << "analyze.metrics: serving metrics on port " << m_port << endl;
+        m_server_thread = std::thread(&MetricsExporter::serverThread, this);
+        }
+    }
+
+MetricsExporter::~MetricsExporter()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying MetricsExporter" << endl;
+
+    if (m_server_thread.joinable())
+        {
+        m_server_exit = true;
+        m_server_thread.join();
+        }
+    if (m_listen_fd >= 0)
+        close(m_listen_fd);
+    }
+
+/*! \param timestep Current time step of the simulation
+*/
+void MetricsExporter::analyze(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push("Metrics");
+
+    Metrics *metrics = m_exec_conf->getMetrics();
+
+    // sample the gauges of the exporter
+    int64_t cur_time = m_clk.getTime();
+    if (m_has_last && cur_time > m_last_time && timestep >= m_last_timestep)
+        metrics->set(m_metric_tps, double(timestep - m_last_timestep)/(double(cur_time - m_last_time)*1e-9));
+    m_has_last = true;
+    m_last_time = cur_time;
+    m_last_timestep = timestep;
+
+    metrics->set(m_metric_timestep, double(timestep));
+
+    MemoryUsage *usage = m_exec_conf->getMemoryUsage();
+    metrics->set(m_metric_host_bytes, double(usage->getCurrentBytes("total", MemoryUsage::host)));
+    metrics->set(m_metric_device_bytes, double(usage->getCurrentBytes("total", MemoryUsage::device)));
+
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        size_t free_bytes = 0, total_bytes = 0;
+        if (cudaMemGetInfo(&free_bytes, &total_bytes) == cudaSuccess)
+            metrics->set(m_metric_gpu_used_bytes, double(total_bytes - free_bytes));
+        }
+    #endif
+
+    // the names of rank 0 determine the exported metrics
+    std::vector<std::string> names = metrics->getNames();
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->getNRanks() > 1)
+        bcast(names, 0, m_exec_conf->getMPICommunicator());
+    #endif
+
+    std::vector<double> values(names.size(), 0.0);
+    for (unsigned int i = 0; i < names.size(); ++i)
+        metrics->getValue(names[i], values[i]);
+
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->getNRanks() > 1 && !names.empty())
+        {
+        std::vector<double> sum_values(names.size());
+        std::vector<double> max_values(names.size());
+        MPI_Reduce(values.data(), sum_values.data(), names.size(), MPI_DOUBLE, MPI_SUM, 0,
+                   m_exec_conf->getMPICommunicator());
+        MPI_Reduce(values.data(), max_values.data(), names.size(), MPI_DOUBLE, MPI_MAX, 0,
+                   m_exec_conf->getMPICommunicator());
+        for (unsigned int i = 0; i < names.size(); ++i)
+            values[i] = (metrics->getReduction(names[i]) == Metrics::max) ? max_values[i] : sum_values[i];
+        }
+    #endif
+
+    if (m_exec_conf->getRank() == 0)
+        {
+        std::ostringstream o;
+        metrics->writeOpenMetrics(o, names, values);
+        std::string text = o.str();
+
+        if (!m_fname.empty())
+            writeFile(text);
+
+        std::lock_guard<std::mutex> lock(m_snapshot_mutex);
+        m_snapshot = text;
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param text Text to write
+
+    The text is written to a temporary file that replaces the output file, so that readers see complete snapshots.
+*/
+void MetricsExporter::writeFile(const std::string& text)
+    {
+    std::string tmp_fname = m_fname + ".tmp";
+        {
+        std::ofstream f(tmp_fname.c_str());
+        f << text;
+        if (!f.good())
+            {
+            m_exec_conf->msg->error() << "analyze.metrics: error writing " << tmp_fname << endl;
+            throw runtime_error("Error writing metrics");
+            }
+        }
+
+    if (std::rename(tmp_fname.c_str(), m_fname.c_str()) != 0)
+        {
+        m_exec_conf->msg->error() << "analyze.metrics: cannot rename " << tmp_fname << " to " << m_fname << ": "
+                                  << strerror(errno) << endl;
+        throw runtime_error("Error writing metrics");
+        }
+    }
+
+/*! Every connection receives the current snapshot, regardless of the requested path. The thread polls the listening
+    socket with a timeout to notice m_server_exit.
+*/
+void MetricsExporter::serverThread()
+    {
+    while (!m_server_exit)
+        {
+        struct pollfd pfd;
+        pfd.fd = m_listen_fd;
+        pfd.events = POLLIN;
+        pfd.revents = 0;
+        if (poll(&pfd, 1, 100) <= 0)
+            continue;
+
+        int fd = accept(m_listen_fd, NULL, NULL);
+        if (fd < 0)
+            continue;
+
+        // read the request so that the client does not see a reset connection, its content is not needed
+        struct pollfd cfd;
+        cfd.fd = fd;
+        cfd.events = POLLIN;
+        cfd.revents = 0;
+        if (poll(&cfd, 1, 1000) > 0)
+            {
+            char request[4096];
+            recv(fd, request, sizeof(request), 0);
+            }
+
+        std::string body = getSnapshot();
+        std::ostringstream response;
+        response << "HTTP/1.0 200 OK\r\n"
+                 << "Content-Type: application/openmetrics-text; version=1.0.0; charset=utf-8\r\n"
+                 << "Content-Length: " << body.size() << "\r\n"
+                 << "Connection: close\r\n\r\n"
+                 << body;
+        std::string text = response.str();
+
+        size_t sent = 0;
+        while (sent < text.size())
+            {
+            ssize_t n = send(fd, text.data() + sent, text.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0)
+                break;
+            sent += n;
+            }
+        close(fd);
+        }
+    }
+
+void export_MetricsExporter(py::module& m)
+    {
+    py::class_<MetricsExporter, std::shared_ptr<MetricsExporter> >(m, "MetricsExporter", py::base<Analyzer>())
+    .def(py::init< std::shared_ptr<SystemDefinition>, const std::string&, int>())
+    .def("getSnapshot", &MetricsExporter::getSnapshot)
+    ;
+    }
@@ -0,0 +1,93 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+/*! \file MetricsExporter.h
+    \brief Declares the MetricsExporter class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __METRICS_EXPORTER_H__
+#define __METRICS_EXPORTER_H__
+
+#include "Analyzer.h"
+#include "ClockSource.h"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+//! Exports the live performance metrics in the OpenMetrics text format
+/*! Every analyze() sets the gauges that are sampled by the exporter (time step, TPS over the last period, host and
+    device memory), reduces all metrics of the Metrics registry over the MPI ranks to rank 0 and formats them in
+    the OpenMetrics text format. Rank 0 then writes the text to a file and/or serves it over HTTP.
+
+    The file is written to a temporary file and renamed, so that a reader (e.g. the textfile collector of the
+    Prometheus node exporter) never sees a partial file. The HTTP endpoint is served by a background thread that
+    answers every request with the snapshot of the most recent analyze(), so scraping does not interrupt the
+    simulation.
+
+    The metric names are taken from rank 0, metrics that only exist on other ranks are not exported.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT MetricsExporter : public Analyzer
+    {
+    public:
+        //! Construct the exporter
+        MetricsExporter(std::shared_ptr<SystemDefinition> sysdef, const std::string& fname, int port);
+
+        //! Destructor
+        ~MetricsExporter();
+
+        //! Reduce and export the current metrics
+        void analyze(unsigned int timestep);
+
+        //! Get the most recent OpenMetrics text (on rank 0)
+        std::string getSnapshot() const
+            {
+            std::lock_guard<std::mutex> lock(m_snapshot_mutex);
+            return m_snapshot;
+            }
+
+    private:
+        std::string m_fname;                    //!< File to write to, empty to disable
+        int m_port;                             //!< TCP port of the HTTP endpoint, negative to disable
+
+        ClockSource m_clk;                      //!< Clock to determine the TPS
+        bool m_has_last;                        //!< True after the first analyze()
+        int64_t m_last_time;                    //!< Time of the previous analyze()
+        unsigned int m_last_timestep;           //!< Time step of the previous analyze()
+
+        unsigned int m_metric_timestep;         //!< ID of the time step gauge
+        unsigned int m_metric_tps;              //!< ID of the TPS gauge
+        unsigned int m_metric_host_bytes;       //!< ID of the host memory gauge
+        unsigned int m_metric_device_bytes;     //!< ID of the device memory gauge
+        unsigned int m_metric_gpu_used_bytes;   //!< ID of the gauge of the memory in use on the GPU
+
+        std::string m_snapshot;                 //!< Most recent OpenMetrics text
+        mutable std::mutex m_snapshot_mutex;    //!< Protects m_snapshot
+
+        int m_listen_fd;                        //!< Listening socket of the HTTP endpoint, -1 if none
+        std::atomic<bool> m_server_exit;        //!< Set to true to stop the server thread
+        std::thread m_server_thread;            //!< Thread serving the HTTP endpoint
+
+        //! Write the text to the file
+        void writeFile(const std::string& text);
+
+        //! Main loop of the server thread
+        void serverThread();
+    };
+
+//! Exports the MetricsExporter class to python
+void export_MetricsExporter(pybind11::module& m);
+
+#endif
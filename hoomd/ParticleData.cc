@@ -25,8 +25,10 @@
 #include <cassert>
 #include <stdlib.h>
 #include <stdexcept>
+#include <algorithm>
 #include <sstream>
 #include <iomanip>
+#include <cstring>
 
 using namespace std;
 
@@ -59,9 +61,13 @@ ParticleData::ParticleData(unsigned int N, const BoxDim &global_box, unsigned in
           m_nparticles(0),
           m_nghosts(0),
           m_max_nparticles(0),
+          m_max_nghosts(0),
           m_nglobal(0),
           m_accel_set(false),
+          m_pos_soa_n_valid(0),
+          m_pos_soa_timestep(0),
           m_resize_factor(9./8.),
+          m_min_growth(64),
           m_arrays_allocated(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing ParticleData" << endl;
@@ -88,6 +94,9 @@ ParticleData::ParticleData(unsigned int N, const BoxDim &global_box, unsigned in
         }
 
     #ifdef ENABLE_MPI
+    m_use_tag_directory = false;
+    m_tag_directory_valid = false;
+
     // Set up domain decomposition information
     if (decomposition) setDomainDecomposition(decomposition);
     #endif
@@ -148,14 +157,21 @@ ParticleData::ParticleData(const SnapshotParticleData<Real>& snapshot,
       m_nparticles(0),
       m_nghosts(0),
       m_max_nparticles(0),
+      m_max_nghosts(0),
       m_nglobal(0),
       m_accel_set(false),
+      m_pos_soa_n_valid(0),
+      m_pos_soa_timestep(0),
       m_resize_factor(9./8.),
+      m_min_growth(64),
       m_arrays_allocated(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing ParticleData" << endl;
 
     #ifdef ENABLE_MPI
+    m_use_tag_directory = false;
+    m_tag_directory_valid = false;
+
     // Set up domain decomposition information
     if (decomposition) setDomainDecomposition(decomposition);
     #endif
@@ -271,6 +287,8 @@ void ParticleData::notifyParticleSort()
         }
     #endif
 
+    m_pos_soa_n_valid = 0;
+
     m_sort_signal.emit();
     }
 
@@ -283,9 +301,53 @@ void ParticleData::notifyParticleSort()
  */
 void ParticleData::notifyGhostParticlesRemoved()
     {
+    m_pos_soa_n_valid = 0;
+
     m_ghost_particles_removed_signal.emit();
     }
 
+/*! \param timestep Current time step
+    \param ghosts If false, only the rows of the local particles are guaranteed to be current
+    \returns The positions and types of the local and ghost particles, in separate arrays
+
+    The copy is filled lazily. It is refreshed on the first call in every time step and after it has been
+    invalidated by a particle sort, ghost particle removal, or invalidatePositionsSoA(). The arrays are only
+    allocated once a caller requests them.
+
+    With \a ghosts set to false, the ghost part of the position array is not read at all, so the local rows may be
+    requested while a ghost update is still writing into it. A later call with \a ghosts set to true then only
+    copies the ghost rows.
+*/
+const PositionsSoA& ParticleData::getPositionsSoA(unsigned int timestep, bool ghosts)
+    {
+    const unsigned int n_all = getN() + getNGhosts();
+    if (m_pos_soa_timestep != timestep || m_pos_soa.x.size() != n_all)
+        m_pos_soa_n_valid = 0;
+
+    const unsigned int n = ghosts ? n_all : getN();
+    if (m_pos_soa_n_valid >= n)
+        return m_pos_soa;
+
+    m_pos_soa.x.resize(n_all);
+    m_pos_soa.y.resize(n_all);
+    m_pos_soa.z.resize(n_all);
+    m_pos_soa.type.resize(n_all);
+
+    ArrayHandle<Scalar4> h_pos(getPositions(), access_location::host, access_mode::read);
+    for (unsigned int i = m_pos_soa_n_valid; i < n; ++i)
+        {
+        const Scalar4 postype = h_pos.data[i];
+        m_pos_soa.x[i] = postype.x;
+        m_pos_soa.y[i] = postype.y;
+        m_pos_soa.z[i] = postype.z;
+        m_pos_soa.type[i] = __scalar_as_int(postype.w);
+        }
+
+    m_pos_soa_n_valid = n;
+    m_pos_soa_timestep = timestep;
+    return m_pos_soa;
+    }
+
 
 /*! \param name Type name to get the index of
     \return Type index of the corresponding type name
@@ -347,6 +409,8 @@ void ParticleData::setTypeName(unsigned int type, const std::string& name)
 */
 void ParticleData::allocate(unsigned int N)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "ParticleData");
+
     // maximum number is the current particle number
     m_max_nparticles = N;
 
@@ -462,6 +526,8 @@ void ParticleData::allocate(unsigned int N)
 */
 void ParticleData::allocateAlternateArrays(unsigned int N)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "ParticleData");
+
     // positions
     GlobalArray< Scalar4 > pos_alt(N, m_exec_conf);
     m_pos_alt.swap(pos_alt);
@@ -619,18 +685,35 @@ void ParticleData::resize(unsigned int new_nparticles)
         allocate(new_nparticles);
 
     // resize pdata arrays as necessary
+    if (new_nparticles > m_max_nparticles)
+        {
+        // reallocate particle data arrays, leaving room for the ghost particles
+        reallocate(getGrowthCapacity(new_nparticles, m_nghosts));
+        }
+
+    m_nparticles = new_nparticles;
+    }
+
+/*! \param nparticles Number of local particles
+    \param nghosts Number of ghost particles
+    \returns The new maximum number of particles
+
+    The particle number is increased by m_resize_factor, and at least by m_min_growth particles, until it can hold the
+    local particles and the largest of \a nghosts and the ghost particle number seen so far.
+*/
+unsigned int ParticleData::getGrowthCapacity(unsigned int nparticles, unsigned int nghosts) const
+    {
+    unsigned int n = nparticles + std::max(nghosts, m_max_nghosts);
+
     unsigned int max_nparticles = m_max_nparticles;
-    if (new_nparticles > max_nparticles)
+    while (n > max_nparticles)
         {
         // use amortized array resizing
-        while (new_nparticles > max_nparticles)
-            max_nparticles = ((unsigned int) (((float) max_nparticles) * m_resize_factor)) + 1 ;
-
-        // reallocate particle data arrays
-        reallocate(max_nparticles);
+        max_nparticles = std::max(((unsigned int) (((float) max_nparticles) * m_resize_factor)) + 1,
+            max_nparticles + m_min_growth);
         }
 
-    m_nparticles = new_nparticles;
+    return max_nparticles;
     }
 
 /*! \param max_n new maximum size of particle data arrays (can be greater or smaller than the current maximum size)
@@ -642,6 +725,8 @@ void ParticleData::resize(unsigned int new_nparticles)
  */
 void ParticleData::reallocate(unsigned int max_n)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "ParticleData");
+
     if (! m_arrays_allocated)
         {
         // allocate instead
@@ -785,7 +870,7 @@ template <class Real>
 bool ParticleData::inBox(const SnapshotParticleData<Real> &snap)
     {
     bool in_box = true;
-    if (m_exec_conf->getRank() == 0)
+    if (m_exec_conf->getRank() == 0 || snap.is_distributed)
         {
         Scalar3 lo = m_global_box.getLo();
         Scalar3 hi = m_global_box.getHi();
@@ -809,7 +894,14 @@ bool ParticleData::inBox(const SnapshotParticleData<Real> &snap)
             }
         }
     #ifdef ENABLE_MPI
-    if (m_decomposition)
+    if (m_decomposition && snap.is_distributed)
+        {
+        int local_in_box = in_box;
+        int global_in_box = 1;
+        MPI_Allreduce(&local_in_box, &global_in_box, 1, MPI_INT, MPI_LAND, m_exec_conf->getMPICommunicator());
+        in_box = global_in_box;
+        }
+    else if (m_decomposition)
         {
         bcast(in_box, 0, m_exec_conf->getMPICommunicator());
         }
@@ -817,6 +909,24 @@ bool ParticleData::inBox(const SnapshotParticleData<Real> &snap)
     return in_box;
     }
 
+#ifdef ENABLE_MPI
+//! Exchange per-rank particle lists between all ranks
+/*! \param in_values Particles to send, in_values[i] is sent to rank i
+    \param out_values Concatenation of the particles received from all ranks, in rank order
+    \param mpi_comm The communicator
+*/
+template<typename T>
+static void exchange_v(const std::vector< std::vector<T> >& in_values, std::vector<T>& out_values, const MPI_Comm mpi_comm)
+    {
+    std::vector< std::vector<T> > recv;
+    all_to_all_v(in_values, recv, mpi_comm);
+
+    out_values.clear();
+    for (unsigned int i = 0; i < recv.size(); i++)
+        out_values.insert(out_values.end(), recv[i].begin(), recv[i].end());
+    }
+#endif
+
 //! Initialize from a snapshot
 /*! \param snapshot the initial particle data
     \param ignore_bodies If True, ignore particles that have a body flag set
@@ -833,8 +943,12 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
     // remove all ghost particles
     removeAllGhostParticles();
 
+    #ifdef ENABLE_MPI
+    m_tag_directory_valid = false;
+    #endif
+
     // check that all fields in the snapshot have correct length
-    if (m_exec_conf->getRank() == 0 && ! snapshot.validate())
+    if ((m_exec_conf->getRank() == 0 || snapshot.is_distributed) && ! snapshot.validate())
         {
         m_exec_conf->msg->error() << "init.*: invalid particle data snapshot."
                                 << std::endl << std::endl;
@@ -894,7 +1008,15 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         tag_proc.resize(size);
         N_proc.resize(size,0);
 
-        if (my_rank == 0)
+        // in a distributed snapshot, every rank places its own particles
+        bool distributed = snapshot.is_distributed;
+        if (distributed && ignore_bodies)
+            {
+            m_exec_conf->msg->error() << "Cannot ignore rigid body constituents in a distributed snapshot." << endl;
+            throw std::runtime_error("Error initializing ParticleData");
+            }
+
+        if (my_rank == 0 || distributed)
             {
             ArrayHandle<unsigned int> h_cart_ranks(m_decomposition->getCartRanks(), access_location::host, access_mode::read);
 
@@ -988,7 +1110,12 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
                 orientation_proc[rank].push_back(quat_to_scalar4(snapshot.orientation[snap_idx]));
                 angmom_proc[rank].push_back(quat_to_scalar4(snapshot.angmom[snap_idx]));
                 inertia_proc[rank].push_back(vec_to_scalar3(snapshot.inertia[snap_idx]));
-                tag_proc[rank].push_back(nglobal++);
+                if (! distributed)
+                    tag_proc[rank].push_back(nglobal++);
+                else if (snapshot.tag.size())
+                    tag_proc[rank].push_back(snapshot.tag[snap_idx]);
+                else
+                    tag_proc[rank].push_back(snapshot.tag_offset + snap_idx);
                 N_proc[rank]++;
                 }
 
@@ -1005,8 +1132,16 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         // broadcast type mapping
         bcast(m_type_mapping, root, mpi_comm);
 
-        // broadcast global number of particles
-        bcast(nglobal, root, mpi_comm);
+        // sum or broadcast global number of particles
+        if (distributed)
+            {
+            unsigned int nlocal = snapshot.size;
+            MPI_Allreduce(&nlocal, &nglobal, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+            }
+        else
+            {
+            bcast(nglobal, root, mpi_comm);
+            }
 
         // resize array for reverse-lookup tags
         m_rtag.resize(nglobal);
@@ -1026,23 +1161,45 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
         std::vector<Scalar3> inertia;
         std::vector<unsigned int> tag;
 
-        // distribute particle data
-        scatter_v(pos_proc,pos,root, mpi_comm);
-        scatter_v(vel_proc,vel,root, mpi_comm);
-        scatter_v(accel_proc, accel, root, mpi_comm);
-        scatter_v(type_proc, type, root, mpi_comm);
-        scatter_v(mass_proc, mass, root, mpi_comm);
-        scatter_v(charge_proc, charge, root, mpi_comm);
-        scatter_v(diameter_proc, diameter, root, mpi_comm);
-        scatter_v(image_proc, image, root, mpi_comm);
-        scatter_v(body_proc, body, root, mpi_comm);
-        scatter_v(orientation_proc, orientation, root, mpi_comm);
-        scatter_v(angmom_proc, angmom, root, mpi_comm);
-        scatter_v(inertia_proc, inertia, root, mpi_comm);
-        scatter_v(tag_proc, tag, root, mpi_comm);
-
-        // distribute number of particles
-        scatter_v(N_proc, m_nparticles, root, mpi_comm);
+        if (distributed)
+            {
+            // exchange particle data between all ranks
+            exchange_v(pos_proc, pos, mpi_comm);
+            exchange_v(vel_proc, vel, mpi_comm);
+            exchange_v(accel_proc, accel, mpi_comm);
+            exchange_v(type_proc, type, mpi_comm);
+            exchange_v(mass_proc, mass, mpi_comm);
+            exchange_v(charge_proc, charge, mpi_comm);
+            exchange_v(diameter_proc, diameter, mpi_comm);
+            exchange_v(image_proc, image, mpi_comm);
+            exchange_v(body_proc, body, mpi_comm);
+            exchange_v(orientation_proc, orientation, mpi_comm);
+            exchange_v(angmom_proc, angmom, mpi_comm);
+            exchange_v(inertia_proc, inertia, mpi_comm);
+            exchange_v(tag_proc, tag, mpi_comm);
+
+            m_nparticles = tag.size();
+            }
+        else
+            {
+            // distribute particle data
+            scatter_v(pos_proc,pos,root, mpi_comm);
+            scatter_v(vel_proc,vel,root, mpi_comm);
+            scatter_v(accel_proc, accel, root, mpi_comm);
+            scatter_v(type_proc, type, root, mpi_comm);
+            scatter_v(mass_proc, mass, root, mpi_comm);
+            scatter_v(charge_proc, charge, root, mpi_comm);
+            scatter_v(diameter_proc, diameter, root, mpi_comm);
+            scatter_v(image_proc, image, root, mpi_comm);
+            scatter_v(body_proc, body, root, mpi_comm);
+            scatter_v(orientation_proc, orientation, root, mpi_comm);
+            scatter_v(angmom_proc, angmom, root, mpi_comm);
+            scatter_v(inertia_proc, inertia, root, mpi_comm);
+            scatter_v(tag_proc, tag, root, mpi_comm);
+
+            // distribute number of particles
+            scatter_v(N_proc, m_nparticles, root, mpi_comm);
+            }
 
 
             {
@@ -1193,6 +1350,104 @@ void ParticleData::initializeFromSnapshot(const SnapshotParticleData<Real>& snap
     m_num_types_signal.emit();
     }
 
+//! Overwrite the particle properties in place from a snapshot
+/*! \param snapshot The snapshot to read the particle properties from
+    \returns true if the particle data was updated, false if the snapshot is not compatible with the current state
+
+    This is a fast path of initializeFromSnapshot() for restoring a snapshot of the same system. It applies when
+    the simulation is not domain decomposed, the snapshot has the same number of particles and type names, every
+    particle keeps its type and body, and the active tags are contiguous (so that the snapshot index equals the tag).
+    The properties are then written through the reverse-lookup table, keeping the current memory order. No arrays
+    are reallocated and only the particle sort signal is emitted, which invalidates neighbor and cell lists without
+    the reinitialization that a change of the number of particles or types causes.
+
+    If the snapshot is not compatible, nothing is modified and the caller should call initializeFromSnapshot().
+*/
+template <class Real>
+bool ParticleData::updateFromSnapshot(const SnapshotParticleData<Real>& snapshot)
+    {
+    #ifdef ENABLE_MPI
+    if (m_decomposition)
+        return false;
+    #endif
+
+    const unsigned int N = getN();
+    if (snapshot.size != N || N != getNGlobal() || snapshot.type_mapping != m_type_mapping || snapshot.is_distributed)
+        return false;
+
+    if (N == 0 || m_tag_set.size() != N || *m_tag_set.rbegin() != N-1)
+        return false;
+
+    if (! snapshot.validate())
+        return false;
+
+    m_exec_conf->msg->notice(4) << "ParticleData: updating from snapshot" << std::endl;
+
+        {
+        ArrayHandle< unsigned int > h_rtag(m_rtag, access_location::host, access_mode::read);
+
+        // the types and bodies are not part of the in-place update, check that they are unchanged
+        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::read);
+        ArrayHandle< unsigned int > h_body(m_body, access_location::host, access_mode::read);
+
+        for (unsigned int tag = 0; tag < N; tag++)
+            {
+            unsigned int idx = h_rtag.data[tag];
+            assert(idx < N);
+
+            if (__scalar_as_int(h_pos.data[idx].w) != (int)snapshot.type[tag] || h_body.data[idx] != snapshot.body[tag])
+                return false;
+            }
+        }
+
+        {
+        // every local particle is written below, no need to copy the current data to the host
+        ArrayHandle< unsigned int > h_rtag(m_rtag, access_location::host, access_mode::read);
+        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar3 > h_accel(m_accel, access_location::host, access_mode::overwrite);
+        ArrayHandle< int3 > h_image(m_image, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar > h_charge(m_charge, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar > h_diameter(m_diameter, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_orientation(m_orientation, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar4 > h_angmom(m_angmom, access_location::host, access_mode::overwrite);
+        ArrayHandle< Scalar3 > h_inertia(m_inertia, access_location::host, access_mode::overwrite);
+
+        for (unsigned int tag = 0; tag < N; tag++)
+            {
+            unsigned int idx = h_rtag.data[tag];
+
+            h_pos.data[idx] = make_scalar4(snapshot.pos[tag].x,
+                                           snapshot.pos[tag].y,
+                                           snapshot.pos[tag].z,
+                                           __int_as_scalar(snapshot.type[tag]));
+            h_vel.data[idx] = make_scalar4(snapshot.vel[tag].x,
+                                           snapshot.vel[tag].y,
+                                           snapshot.vel[tag].z,
+                                           snapshot.mass[tag]);
+            h_accel.data[idx] = vec_to_scalar3(snapshot.accel[tag]);
+            h_charge.data[idx] = snapshot.charge[tag];
+            h_diameter.data[idx] = snapshot.diameter[tag];
+            h_image.data[idx] = snapshot.image[tag];
+            h_orientation.data[idx] = quat_to_scalar4(snapshot.orientation[tag]);
+            h_angmom.data[idx] = quat_to_scalar4(snapshot.angmom[tag]);
+            h_inertia.data[idx] = vec_to_scalar3(snapshot.inertia[tag]);
+            }
+        }
+
+    // copy over accel_set flag from snapshot
+    m_accel_set = snapshot.is_accel_set;
+
+    // zero the origin
+    m_origin = make_scalar3(0,0,0);
+    m_o_image = make_int3(0,0,0);
+
+    // notify listeners that the particle data has changed, without changing the number of particles or types
+    notifyParticleSort();
+
+    return true;
+    }
+
 //! take a particle data snapshot
 /* \param snapshot The snapshot to write to
    \returns a map to lookup the snapshot index from a particle tag
@@ -1444,19 +1699,16 @@ void ParticleData::addGhostParticles(const unsigned int nghosts)
     {
     assert(nghosts >= 0);
 
-    unsigned int max_nparticles = m_max_nparticles;
-
     m_nghosts += nghosts;
 
-    if (m_nparticles + m_nghosts > max_nparticles)
+    if (m_nparticles + m_nghosts > m_max_nparticles)
         {
-        while (m_nparticles + m_nghosts > max_nparticles)
-            max_nparticles = ((unsigned int) (((float) max_nparticles) * m_resize_factor)) + 1 ;
-
         // reallocate particle data arrays
-        reallocate(max_nparticles);
+        reallocate(getGrowthCapacity(m_nparticles, m_nghosts));
         }
 
+    // remember the size of the ghost layer for the next growth of the arrays
+    m_max_nghosts = std::max(m_max_nghosts, m_nghosts);
     }
 
 #ifdef ENABLE_MPI
@@ -1466,6 +1718,25 @@ void ParticleData::addGhostParticles(const unsigned int nghosts)
 unsigned int ParticleData::getOwnerRank(unsigned int tag) const
     {
     assert(m_decomposition);
+
+    if (m_use_tag_directory)
+        {
+        if (!m_tag_directory_valid)
+            {
+            ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::read);
+            m_tag_directory->rebuild(h_tag.data, getN(), getMaximumTag());
+            m_tag_directory_valid = true;
+            }
+
+        int owner = m_tag_directory->getOwner(tag);
+        if (owner < 0)
+            {
+            m_exec_conf->msg->error() << "Could not find particle " << tag << " on any processor." << endl << endl;
+            throw std::runtime_error("Error accessing particle data.");
+            }
+        return (unsigned int) owner;
+        }
+
     int is_local = (getRTag(tag) < getN()) ? 1 : 0;
     int n_found;
 
@@ -1800,9 +2071,243 @@ Scalar3 ParticleData::getMomentsOfInertia(unsigned int tag) const
     return result;
     }
 
+/*! \param tags Global tags of the particles
+    \param rtags Output: local index of each particle, NOT_LOCAL for particles that are not on this rank
+
+    The reverse-lookup table is accessed once for the whole list.
+*/
+void ParticleData::getRTagList(const std::vector<unsigned int>& tags, std::vector<unsigned int>& rtags) const
+    {
+    rtags.resize(tags.size());
+
+    ArrayHandle< unsigned int> h_rtag(m_rtag, access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < tags.size(); ++i)
+        {
+        assert(tags[i] < m_rtag.size());
+        rtags[i] = h_rtag.data[tags[i]];
+        }
+    }
+
+/*! \param tags Global tags of the particles
+    \param fields Bitwise or of the tag_field flags to gather
+    \param data Output: the requested properties of each particle
+
+    This is the bulk version of getPosition(), getVelocity(), getMass(), getType(), getCharge(), getDiameter(),
+    getBody() and getOrientation(). The particle data arrays are accessed once for the whole list, and in MPI
+    simulations every requested property is reduced with a single collective call instead of one owner lookup and
+    broadcast per particle and property. Like the single-particle getters, this method must be called on all ranks.
+*/
+void ParticleData::getByTag(const std::vector<unsigned int>& tags, unsigned int fields, TagData& data) const
+    {
+    const unsigned int n = tags.size();
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        if (tags[i] >= m_rtag.size() || !isTagActive(tags[i]))
+            {
+            m_exec_conf->msg->error() << "Trying to access particle " << tags[i] << ", which does not exist." << endl << endl;
+            throw std::runtime_error("Error accessing particle data.");
+            }
+        }
+
+    std::vector<unsigned int> rtags;
+    getRTagList(tags, rtags);
+
+    // properties of particles that are not local are zero, so that a sum over all ranks yields those of the owner
+    std::vector<unsigned int> n_found(n, 0);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        if (rtags[i] < getN())
+            n_found[i] = 1;
+        }
+
+    data = TagData();
+    if (fields & tag_field::position)
+        {
+        data.pos.assign(n, make_scalar3(0.0,0.0,0.0));
+        data.image.assign(n, make_int3(0,0,0));
+        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::read);
+        ArrayHandle< int3 > h_img(m_image, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < n; ++i)
+            {
+            if (!n_found[i]) continue;
+            unsigned int idx = rtags[i];
+            data.pos[i] = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z) - m_origin;
+            data.image[i] = make_int3(h_img.data[idx].x - m_o_image.x,
+                                      h_img.data[idx].y - m_o_image.y,
+                                      h_img.data[idx].z - m_o_image.z);
+            }
+        }
+    if (fields & tag_field::velocity)
+        {
+        data.vel.assign(n, make_scalar3(0.0,0.0,0.0));
+        data.mass.assign(n, Scalar(0.0));
+        ArrayHandle< Scalar4 > h_vel(m_vel, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < n; ++i)
+            {
+            if (!n_found[i]) continue;
+            Scalar4 v = h_vel.data[rtags[i]];
+            data.vel[i] = make_scalar3(v.x, v.y, v.z);
+            data.mass[i] = v.w;
+            }
+        }
+    if (fields & tag_field::type)
+        {
+        data.type.assign(n, 0);
+        ArrayHandle< Scalar4 > h_pos(m_pos, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < n; ++i)
+            {
+            if (n_found[i])
+                data.type[i] = __scalar_as_int(h_pos.data[rtags[i]].w);
+            }
+        }
+    if (fields & tag_field::charge)
+        {
+        data.charge.assign(n, Scalar(0.0));
+        ArrayHandle< Scalar > h_charge(m_charge, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < n; ++i)
+            {
+            if (n_found[i])
+                data.charge[i] = h_charge.data[rtags[i]];
+            }
+        }
+    if (fields & tag_field::diameter)
+        {
+        data.diameter.assign(n, Scalar(0.0));
+        ArrayHandle< Scalar > h_diameter(m_diameter, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < n; ++i)
+            {
+            if (n_found[i])
+                data.diameter[i] = h_diameter.data[rtags[i]];
+            }
+        }
+    if (fields & tag_field::body)
+        {
+        data.body.assign(n, 0);
+        ArrayHandle< unsigned int > h_body(m_body, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < n; ++i)
+            {
+            if (n_found[i])
+                data.body[i] = h_body.data[rtags[i]];
+            }
+        }
+    if (fields & tag_field::orientation)
+        {
+        data.orientation.assign(n, make_scalar4(0.0,0.0,0.0,0.0));
+        ArrayHandle< Scalar4 > h_orientation(m_orientation, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < n; ++i)
+            {
+            if (n_found[i])
+                data.orientation[i] = h_orientation.data[rtags[i]];
+            }
+        }
+
+#ifdef ENABLE_MPI
+    if (m_decomposition && n > 0)
+        {
+        const MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+        MPI_Allreduce(MPI_IN_PLACE, &n_found[0], n, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+
+        // exactly one rank contributes a non-zero value, so the sums are exact (unsigned wrap-around also
+        // preserves negative image flags and NO_BODY)
+        if (fields & tag_field::position)
+            {
+            MPI_Allreduce(MPI_IN_PLACE, &data.pos[0], 3*n, MPI_HOOMD_SCALAR, MPI_SUM, mpi_comm);
+            MPI_Allreduce(MPI_IN_PLACE, &data.image[0], 3*n, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+            }
+        if (fields & tag_field::velocity)
+            {
+            MPI_Allreduce(MPI_IN_PLACE, &data.vel[0], 3*n, MPI_HOOMD_SCALAR, MPI_SUM, mpi_comm);
+            MPI_Allreduce(MPI_IN_PLACE, &data.mass[0], n, MPI_HOOMD_SCALAR, MPI_SUM, mpi_comm);
+            }
+        if (fields & tag_field::type)
+            MPI_Allreduce(MPI_IN_PLACE, &data.type[0], n, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+        if (fields & tag_field::charge)
+            MPI_Allreduce(MPI_IN_PLACE, &data.charge[0], n, MPI_HOOMD_SCALAR, MPI_SUM, mpi_comm);
+        if (fields & tag_field::diameter)
+            MPI_Allreduce(MPI_IN_PLACE, &data.diameter[0], n, MPI_HOOMD_SCALAR, MPI_SUM, mpi_comm);
+        if (fields & tag_field::body)
+            MPI_Allreduce(MPI_IN_PLACE, &data.body[0], n, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+        if (fields & tag_field::orientation)
+            MPI_Allreduce(MPI_IN_PLACE, &data.orientation[0], 4*n, MPI_HOOMD_SCALAR, MPI_SUM, mpi_comm);
+        }
+#endif
+
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        if (n_found[i] == 0)
+            {
+            m_exec_conf->msg->error() << "Could not find particle " << tags[i] << " on any processor." << endl << endl;
+            throw std::runtime_error("Error accessing particle data.");
+            }
+        else if (n_found[i] > 1)
+            {
+            m_exec_conf->msg->error() << "Found particle " << tags[i] << " on multiple processors." << endl << endl;
+            throw std::runtime_error("Error accessing particle data.");
+            }
+        }
+
+    if (fields & tag_field::position)
+        {
+        for (unsigned int i = 0; i < n; ++i)
+            m_global_box.wrap(data.pos[i], data.image[i]);
+        }
+    }
+
+/*! \param self Python reference to the ParticleData
+    \param tags Global tags of the particles
+    \param fields Bitwise or of the tag_field flags to gather
+    \returns A dict that maps the property names to numpy arrays with one row per tag
+
+    The returned arrays are copies of the particle data.
+*/
+pybind11::dict ParticleData::getByTagNP(pybind11::object self,
+                                        pybind11::array_t<unsigned int, pybind11::array::c_style | pybind11::array::forcecast> tags,
+                                        unsigned int fields)
+    {
+    auto self_cpp = self.cast<ParticleData *>();
+
+    std::vector<unsigned int> tag_list(tags.data(), tags.data() + tags.size());
+    TagData data;
+    self_cpp->getByTag(tag_list, fields, data);
+
+    const size_t n = tag_list.size();
+    std::vector<size_t> dims(2);
+    dims[0] = n;
+
+    pybind11::dict result;
+    if (fields & tag_field::position)
+        {
+        dims[1] = 3;
+        result["position"] = pybind11::array(dims, (Scalar *) (n ? &data.pos[0] : NULL));
+        result["image"] = pybind11::array(dims, (int *) (n ? &data.image[0] : NULL));
+        }
+    if (fields & tag_field::velocity)
+        {
+        dims[1] = 3;
+        result["velocity"] = pybind11::array(dims, (Scalar *) (n ? &data.vel[0] : NULL));
+        result["mass"] = pybind11::array(n, n ? &data.mass[0] : (Scalar *) NULL);
+        }
+    if (fields & tag_field::type)
+        result["typeid"] = pybind11::array(n, n ? &data.type[0] : (unsigned int *) NULL);
+    if (fields & tag_field::charge)
+        result["charge"] = pybind11::array(n, n ? &data.charge[0] : (Scalar *) NULL);
+    if (fields & tag_field::diameter)
+        result["diameter"] = pybind11::array(n, n ? &data.diameter[0] : (Scalar *) NULL);
+    if (fields & tag_field::body)
+        result["body"] = pybind11::array(n, n ? &data.body[0] : (unsigned int *) NULL);
+    if (fields & tag_field::orientation)
+        {
+        dims[1] = 4;
+        result["orientation"] = pybind11::array(dims, (Scalar *) (n ? &data.orientation[0] : NULL));
+        }
+    return result;
+    }
+
 //! Get the net force / energy on a given particle
 Scalar4 ParticleData::getPNetForce(unsigned int tag) const
     {
+    validateNetEnergy();
+
     unsigned int idx = getRTag(tag);
     bool found = (idx < getN());
     Scalar4 result = make_scalar4(0.0,0.0,0.0,0.0);
@@ -1878,6 +2383,9 @@ Scalar ParticleData::getPNetVirial(unsigned int tag, unsigned int component) con
  */
 void ParticleData::setPosition(unsigned int tag, const Scalar3& pos, bool move)
     {
+    // the structure-of-arrays copy needs to be refreshed
+    m_pos_soa_n_valid = 0;
+
     //shift using gridtshift origin
     Scalar3 tmp_pos = pos + m_origin;
 
@@ -2210,6 +2718,10 @@ unsigned int ParticleData::addParticle(unsigned int type)
     // we are changing the local number of particles, so remove ghosts
     removeAllGhostParticles();
 
+    #ifdef ENABLE_MPI
+    m_tag_directory_valid = false;
+    #endif
+
     // the global tag of the newly created particle
     unsigned int tag;
 
@@ -2301,6 +2813,10 @@ unsigned int ParticleData::addParticle(unsigned int type)
  */
 void ParticleData::removeParticle(unsigned int tag)
     {
+    #ifdef ENABLE_MPI
+    m_tag_directory_valid = false;
+    #endif
+
     if (getNGlobal()==0)
         {
         m_exec_conf->msg->error() << "Trying to remove particle when there are zero particles!" << endl;
@@ -2477,6 +2993,7 @@ template ParticleData::ParticleData(const SnapshotParticleData<double>& snapshot
                                            std::shared_ptr<DomainDecomposition> decomposition
                                           );
 template void ParticleData::initializeFromSnapshot<double>(const SnapshotParticleData<double> & snapshot, bool ignore_bodies);
+template bool ParticleData::updateFromSnapshot<double>(const SnapshotParticleData<double> & snapshot);
 template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<double>(SnapshotParticleData<double> &snapshot);
 
 
@@ -2486,6 +3003,7 @@ template ParticleData::ParticleData(const SnapshotParticleData<float>& snapshot,
                                            std::shared_ptr<DomainDecomposition> decomposition
                                           );
 template void ParticleData::initializeFromSnapshot<float>(const SnapshotParticleData<float> & snapshot, bool ignore_bodies);
+template bool ParticleData::updateFromSnapshot<float>(const SnapshotParticleData<float> & snapshot);
 template std::map<unsigned int, unsigned int> ParticleData::takeSnapshot<float>(SnapshotParticleData<float> &snapshot);
 
 
@@ -2538,18 +3056,31 @@ void export_ParticleData(py::module& m)
     .def("addParticle", &ParticleData::addParticle)
     .def("removeParticle", &ParticleData::removeParticle)
     .def("getNthTag", &ParticleData::getNthTag)
+    .def("getByTag", &ParticleData::getByTagNP)
 #ifdef ENABLE_MPI
     .def("setDomainDecomposition", &ParticleData::setDomainDecomposition)
     .def("getDomainDecomposition", &ParticleData::getDomainDecomposition)
+    .def("setTagDirectory", &ParticleData::setTagDirectory)
 #endif
     .def("addType", &ParticleData::addType)
     ;
+
+    py::enum_<tag_field::Enum>(m,"TagField")
+        .value("position", tag_field::position)
+        .value("velocity", tag_field::velocity)
+        .value("type", tag_field::type)
+        .value("charge", tag_field::charge)
+        .value("diameter", tag_field::diameter)
+        .value("body", tag_field::body)
+        .value("orientation", tag_field::orientation)
+        .value("all", tag_field::all)
+    ;
     }
 
 //! Constructor for SnapshotParticleData
 template <class Real>
 SnapshotParticleData<Real>::SnapshotParticleData(unsigned int N)
-       : size(N), is_accel_set(false)
+       : size(N), is_accel_set(false), is_distributed(false), tag_offset(0)
     {
     resize(N);
     }
@@ -2606,6 +3137,10 @@ bool SnapshotParticleData<Real>::validate() const
         inertia.size() != size)
         return false;
 
+    // explicit tags are optional
+    if (tag.size() && tag.size() != size)
+        return false;
+
     return true;
     }
 
@@ -2627,6 +3162,8 @@ void ParticleData::removeParticles(std::vector<pdata_element>& out, std::vector<
     {
     if (m_prof) m_prof->push("pack");
 
+    m_tag_directory_valid = false;
+
     unsigned int num_remove_ptls = 0;
 
         {
@@ -2792,6 +3329,8 @@ void ParticleData::addParticles(const std::vector<pdata_element>& in)
     {
     if (m_prof) m_prof->push("unpack");
 
+    m_tag_directory_valid = false;
+
     unsigned int num_add_ptls = in.size();
 
     unsigned int old_nparticles = getN();
@@ -2872,6 +3411,8 @@ void ParticleData::removeParticlesGPU(GlobalVector<pdata_element>& out, GlobalVe
     {
     if (m_prof) m_prof->push(m_exec_conf, "pack");
 
+    m_tag_directory_valid = false;
+
     // this is the maximum number of elements we can possibly write to out
     unsigned int max_n_out = out.getNumElements();
     if (comm_flags.getNumElements() < max_n_out)
@@ -3027,6 +3568,8 @@ void ParticleData::addParticlesGPU(const GlobalVector<pdata_element>& in)
     {
     if (m_prof) m_prof->push(m_exec_conf, "unpack");
 
+    m_tag_directory_valid = false;
+
     unsigned int old_nparticles = getN();
     unsigned int num_add_ptls = in.size();
     unsigned int new_nparticles = old_nparticles + num_add_ptls;
@@ -3090,6 +3633,132 @@ void ParticleData::addParticlesGPU(const GlobalVector<pdata_element>& in)
     }
 
 #endif // ENABLE_CUDA
+
+//! Helper to pack or unpack one field of a pdata_element
+/*! \param ptr Current position in the byte buffer, advanced past the field
+    \param value The field
+    \tparam pack True to copy the field into the buffer, false to copy it from the buffer
+ */
+template<bool pack, class T>
+static inline void pack_pdata_field(char *&ptr, T& value)
+    {
+    if (pack)
+        memcpy(ptr, &value, sizeof(T));
+    else
+        memcpy(&value, ptr, sizeof(T));
+    ptr += sizeof(T);
+    }
+
+//! Pack or unpack the fields of a pdata_element
+template<bool pack>
+static inline void pack_pdata_element(char *&ptr, pdata_element& p, unsigned int fields)
+    {
+    pack_pdata_field<pack>(ptr, p.pos);
+    pack_pdata_field<pack>(ptr, p.vel);
+    pack_pdata_field<pack>(ptr, p.tag);
+    if (fields & (1 << pdata_field::accel)) pack_pdata_field<pack>(ptr, p.accel);
+    if (fields & (1 << pdata_field::charge)) pack_pdata_field<pack>(ptr, p.charge);
+    if (fields & (1 << pdata_field::diameter)) pack_pdata_field<pack>(ptr, p.diameter);
+    if (fields & (1 << pdata_field::image)) pack_pdata_field<pack>(ptr, p.image);
+    if (fields & (1 << pdata_field::body)) pack_pdata_field<pack>(ptr, p.body);
+    if (fields & (1 << pdata_field::orientation)) pack_pdata_field<pack>(ptr, p.orientation);
+    if (fields & (1 << pdata_field::angmom)) pack_pdata_field<pack>(ptr, p.angmom);
+    if (fields & (1 << pdata_field::inertia)) pack_pdata_field<pack>(ptr, p.inertia);
+    if (fields & (1 << pdata_field::net_force)) pack_pdata_field<pack>(ptr, p.net_force);
+    if (fields & (1 << pdata_field::net_torque)) pack_pdata_field<pack>(ptr, p.net_torque);
+    if (fields & (1 << pdata_field::net_virial)) pack_pdata_field<pack>(ptr, p.net_virial);
+    }
+
+//! Get a pdata_element with the default values of all fields
+static pdata_element get_default_pdata_element()
+    {
+    pdata_element p;
+    memset(&p, 0, sizeof(pdata_element));
+    p.diameter = Scalar(1.0);
+    p.body = NO_BODY;
+    p.orientation = make_scalar4(1, 0, 0, 0);
+    return p;
+    }
+
+/*! \param in Particles to check
+    \param n Number of particles
+    \returns A bit mask with bit pdata_field::Enum set for every field that has a value different from the default in
+             at least one particle. For point particles without charges, rigid bodies or rotational degrees of freedom,
+             half of the migration message is saved.
+ */
+unsigned int getPdataElementFields(const pdata_element *in, unsigned int n)
+    {
+    const pdata_element d = get_default_pdata_element();
+    const unsigned int all_fields = (1 << pdata_field::num_fields) - 1;
+
+    unsigned int fields = 0;
+    for (unsigned int i = 0; i < n && fields != all_fields; ++i)
+        {
+        const pdata_element& p = in[i];
+        if (memcmp(&p.accel, &d.accel, sizeof(p.accel))) fields |= 1 << pdata_field::accel;
+        if (p.charge != d.charge) fields |= 1 << pdata_field::charge;
+        if (p.diameter != d.diameter) fields |= 1 << pdata_field::diameter;
+        if (memcmp(&p.image, &d.image, sizeof(p.image))) fields |= 1 << pdata_field::image;
+        if (p.body != d.body) fields |= 1 << pdata_field::body;
+        if (memcmp(&p.orientation, &d.orientation, sizeof(p.orientation))) fields |= 1 << pdata_field::orientation;
+        if (memcmp(&p.angmom, &d.angmom, sizeof(p.angmom))) fields |= 1 << pdata_field::angmom;
+        if (memcmp(&p.inertia, &d.inertia, sizeof(p.inertia))) fields |= 1 << pdata_field::inertia;
+        if (memcmp(&p.net_force, &d.net_force, sizeof(p.net_force))) fields |= 1 << pdata_field::net_force;
+        if (memcmp(&p.net_torque, &d.net_torque, sizeof(p.net_torque))) fields |= 1 << pdata_field::net_torque;
+        if (memcmp(&p.net_virial, &d.net_virial, sizeof(p.net_virial))) fields |= 1 << pdata_field::net_virial;
+        }
+    return fields;
+    }
+
+/*! \param fields Bit mask of the packed optional fields
+ */
+unsigned int getPackedPdataElementSize(unsigned int fields)
+    {
+    pdata_element p;
+    unsigned int size = sizeof(p.pos) + sizeof(p.vel) + sizeof(p.tag);
+    if (fields & (1 << pdata_field::accel)) size += sizeof(p.accel);
+    if (fields & (1 << pdata_field::charge)) size += sizeof(p.charge);
+    if (fields & (1 << pdata_field::diameter)) size += sizeof(p.diameter);
+    if (fields & (1 << pdata_field::image)) size += sizeof(p.image);
+    if (fields & (1 << pdata_field::body)) size += sizeof(p.body);
+    if (fields & (1 << pdata_field::orientation)) size += sizeof(p.orientation);
+    if (fields & (1 << pdata_field::angmom)) size += sizeof(p.angmom);
+    if (fields & (1 << pdata_field::inertia)) size += sizeof(p.inertia);
+    if (fields & (1 << pdata_field::net_force)) size += sizeof(p.net_force);
+    if (fields & (1 << pdata_field::net_torque)) size += sizeof(p.net_torque);
+    if (fields & (1 << pdata_field::net_virial)) size += sizeof(p.net_virial);
+    return size;
+    }
+
+/*! \param in Particles to pack
+    \param n Number of particles
+    \param fields Bit mask of the optional fields to pack, usually from getPdataElementFields()
+    \param out Output buffer of n*getPackedPdataElementSize(fields) bytes
+ */
+void packPdataElements(const pdata_element *in, unsigned int n, unsigned int fields, char *out)
+    {
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        pdata_element p = in[i];
+        pack_pdata_element<true>(out, p, fields);
+        }
+    }
+
+/*! \param in Buffer written by packPdataElements()
+    \param n Number of particles
+    \param fields Bit mask of the optional fields that were packed
+    \param out Output particles
+ */
+void unpackPdataElements(const char *in, unsigned int n, unsigned int fields, pdata_element *out)
+    {
+    const pdata_element d = get_default_pdata_element();
+    char *ptr = const_cast<char *>(in);
+    for (unsigned int i = 0; i < n; ++i)
+        {
+        out[i] = d;
+        pack_pdata_element<false>(ptr, out[i], fields);
+        }
+    }
 #endif // ENABLE_MPI
 
 void ParticleData::setGPUAdvice()
@@ -3271,6 +3940,119 @@ void SnapshotParticleData<Real>::replicate(unsigned int nx, unsigned int ny, uns
         }
     }
 
+#ifdef ENABLE_MPI
+//! Find the replica indices along one direction that may fall into a domain
+/*! \param f Fractional coordinate of the unwrapped particle in the old box
+    \param n Number of replicas along this direction
+    \param lo Lower fractional boundary of the domain in the new box
+    \param hi Upper fractional boundary of the domain in the new box
+    \param replicas Replica indices (output)
+
+    The range is widened by one replica on each side, the exact placement is left to
+    DomainDecomposition::placeParticle().
+*/
+static void findReplicas(Scalar f, unsigned int n, Scalar lo, Scalar hi, std::vector<unsigned int>& replicas)
+    {
+    replicas.clear();
+    int first = int(floor(lo*Scalar(n) - f)) - 1;
+    int last = int(ceil(hi*Scalar(n) - f)) + 1;
+
+    if (last - first + 1 >= int(n))
+        {
+        for (unsigned int l = 0; l < n; ++l)
+            replicas.push_back(l);
+        }
+    else
+        {
+        for (int l = first; l <= last; ++l)
+            replicas.push_back(((l % int(n)) + int(n)) % int(n));
+        }
+    }
+
+/*! Only the replicas inside the local domain are generated, so that every rank holds roughly N/P particles
+    and no particle has to be sent during initialization. A replica is kept if
+    DomainDecomposition::placeParticle() assigns it to \a rank. Since all ranks evaluate the same positions,
+    every replica is kept on exactly one rank.
+*/
+template <class Real>
+void SnapshotParticleData<Real>::replicateDistributed(unsigned int nx, unsigned int ny, unsigned int nz,
+        const BoxDim& old_box, const BoxDim& new_box,
+        std::shared_ptr<DomainDecomposition> decomposition, unsigned int rank)
+    {
+    // keep the particles to replicate
+    SnapshotParticleData<Real> cell(*this);
+    unsigned int old_size = cell.size;
+
+    resize(0);
+    tag.clear();
+    is_distributed = true;
+    tag_offset = 0;
+
+    // fractional boundaries of the local domain
+    uint3 grid_pos = decomposition->getGridPos();
+    std::vector<Scalar> cum_frac_x = decomposition->getCumulativeFractions(0);
+    std::vector<Scalar> cum_frac_y = decomposition->getCumulativeFractions(1);
+    std::vector<Scalar> cum_frac_z = decomposition->getCumulativeFractions(2);
+
+    ArrayHandle<unsigned int> h_cart_ranks(decomposition->getCartRanks(), access_location::host, access_mode::read);
+
+    std::vector<unsigned int> replicas_x, replicas_y, replicas_z;
+    for (unsigned int i = 0; i < old_size; ++i)
+        {
+        // unwrap position of particle i in old box using image flags
+        vec3<Real> p = cell.pos[i];
+        int3 img = cell.image[i];
+
+        p = vec3<Real>(old_box.shift(vec3<Scalar>(p), img));
+        vec3<Real> f = old_box.makeFraction(p);
+
+        findReplicas(f.x, nx, cum_frac_x[grid_pos.x], cum_frac_x[grid_pos.x+1], replicas_x);
+        findReplicas(f.y, ny, cum_frac_y[grid_pos.y], cum_frac_y[grid_pos.y+1], replicas_y);
+        findReplicas(f.z, nz, cum_frac_z[grid_pos.z], cum_frac_z[grid_pos.z+1], replicas_z);
+
+        for (unsigned int l : replicas_x)
+            for (unsigned int m : replicas_y)
+                for (unsigned int n : replicas_z)
+                    {
+                    // same position as in replicate()
+                    Scalar3 f_new;
+                    f_new.x = f.x/(Real)nx + (Real)l/(Real)nx;
+                    f_new.y = f.y/(Real)ny + (Real)m/(Real)ny;
+                    f_new.z = f.z/(Real)nz + (Real)n/(Real)nz;
+
+                    Scalar3 q = new_box.makeCoordinates(f_new);
+                    int3 new_img = new_box.getImage(q);
+                    int3 negimg = make_int3(-new_img.x, -new_img.y, -new_img.z);
+                    q = new_box.shift(q, negimg);
+                    new_box.wrap(q, new_img);
+
+                    if (decomposition->placeParticle(new_box, q, h_cart_ranks.data) != rank)
+                        continue;
+
+                    unsigned int j = (l*ny + m)*nz + n;
+                    unsigned int k = size;
+                    resize(k+1);
+                    tag.push_back(j*old_size + i);
+
+                    pos[k] = vec3<Real>(q);
+                    image[k] = new_img;
+                    vel[k] = cell.vel[i];
+                    accel[k] = cell.accel[i];
+                    type[k] = cell.type[i];
+                    mass[k] = cell.mass[i];
+                    charge[k] = cell.charge[i];
+                    diameter[k] = cell.diameter[i];
+                    body[k] = (cell.body[i] != NO_BODY ? j*old_size + cell.body[i] : NO_BODY);
+                    orientation[k] = cell.orientation[i];
+                    angmom[k] = cell.angmom[i];
+                    inertia[k] = cell.inertia[i];
+                    }
+        }
+
+    is_accel_set = cell.is_accel_set;
+    }
+#endif
+
 /*! \returns a numpy array that wraps the pos data element.
     The raw data is referenced by the numpy array, modifications to the numpy array will modify the snapshot
 */
@@ -35,6 +35,7 @@
 
 #ifndef NVCC
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+#include <hoomd/extern/pybind/include/pybind11/numpy.h>
 #endif
 
 #ifdef ENABLE_MPI
@@ -42,6 +43,9 @@
 #endif
 
 #include "DomainDecomposition.h"
+#ifdef ENABLE_MPI
+#include "TagDirectory.h"
+#endif
 
 #include <stdlib.h>
 #include <vector>
@@ -49,6 +53,7 @@
 #include <string>
 #include <bitset>
 #include <stack>
+#include <algorithm>
 
 /*! \ingroup hoomd_lib
     @{
@@ -148,7 +153,7 @@ template <class Real>
 struct PYBIND11_EXPORT SnapshotParticleData {
     //! Empty snapshot
     SnapshotParticleData()
-        : size(0), is_accel_set(false)
+        : size(0), is_accel_set(false), is_distributed(false), tag_offset(0)
         {
         }
 
@@ -188,6 +193,24 @@ struct PYBIND11_EXPORT SnapshotParticleData {
     void replicate(unsigned int nx, unsigned int ny, unsigned int nz,
         const BoxDim& old_box, const BoxDim& new_box);
 
+    #ifdef ENABLE_MPI
+    //! Replicate this snapshot, keeping only the replicas in the local domain
+    /*! \param nx Number of times to replicate the system along the x direction
+     *  \param ny Number of times to replicate the system along the y direction
+     *  \param nz Number of times to replicate the system along the z direction
+     *  \param old_box Old box dimensions
+     *  \param new_box Dimensions of replicated box
+     *  \param decomposition Domain decomposition of the replicated box
+     *  \param rank Rank of this processor
+     *
+     *  The snapshot must hold the full system to replicate on every rank. Afterwards, it is a distributed snapshot
+     *  with the replicas placed in the domain of \a rank, with the same tags as replicate() would assign.
+     */
+    void replicateDistributed(unsigned int nx, unsigned int ny, unsigned int nz,
+        const BoxDim& old_box, const BoxDim& new_box,
+        std::shared_ptr<DomainDecomposition> decomposition, unsigned int rank);
+    #endif
+
     //! Get pos as a Python object
     static pybind11::object getPosNP(pybind11::object self);
     //! Get vel as a Python object
@@ -235,6 +258,17 @@ struct PYBIND11_EXPORT SnapshotParticleData {
     std::vector<std::string> type_mapping;     //!< Mapping between particle type ids and names
 
     bool is_accel_set;                         //!< Flag indicating if accel is set
+
+    //! Flag indicating that every rank holds a part of the system
+    /*! A distributed snapshot stores the consecutive particles with tags tag_offset to tag_offset+size-1 on each
+        rank, instead of all particles on the root rank. When \a tag is not empty, it lists the tag of every particle
+        instead. ParticleData::initializeFromSnapshot() places the particles
+        of every rank into their domains without gathering them. Only MPI initialization supports distributed
+        snapshots.
+    */
+    bool is_distributed;
+    unsigned int tag_offset;                   //!< Tag of the first particle in a distributed snapshot
+    std::vector<unsigned int> tag;             //!< Explicit tags of the particles in a distributed snapshot (optional)
     };
 
 //! Structure to store packed particle data
@@ -258,6 +292,88 @@ struct pdata_element
     Scalar net_virial[6];      //!< net virial
     };
 
+#ifdef ENABLE_MPI
+//! Optional fields of a pdata_element in a packed migration message
+/*! Position, velocity and tag are always packed. The other fields are only packed when at least one particle in the
+    message has a value different from the default (see getPdataElementFields()).
+ */
+namespace pdata_field
+    {
+    enum Enum
+        {
+        accel = 0,
+        charge,
+        diameter,
+        image,
+        body,
+        orientation,
+        angmom,
+        inertia,
+        net_force,
+        net_torque,
+        net_virial,
+        num_fields
+        };
+    }
+
+//! Determine the fields with non-default values in a range of pdata_elements
+unsigned int getPdataElementFields(const pdata_element *in, unsigned int n);
+
+//! Number of bytes of a packed pdata_element with the given fields
+unsigned int getPackedPdataElementSize(unsigned int fields);
+
+//! Pack the given fields of a range of pdata_elements into a byte buffer
+void packPdataElements(const pdata_element *in, unsigned int n, unsigned int fields, char *out);
+
+//! Unpack a byte buffer into pdata_elements, setting the default values of the fields that were not packed
+void unpackPdataElements(const char *in, unsigned int n, unsigned int fields, pdata_element *out);
+#endif
+
+//! Structure-of-arrays copy of the positions and types of the local and ghost particles
+/*! The x, y, z coordinates and type ids are stored in separate contiguous arrays so that CPU loops over neighbors
+    can stream through them without loading the packed Scalar4. See ParticleData::getPositionsSoA().
+ */
+struct PositionsSoA
+    {
+    std::vector<Scalar> x;            //!< x coordinates
+    std::vector<Scalar> y;            //!< y coordinates
+    std::vector<Scalar> z;            //!< z coordinates
+    std::vector<unsigned int> type;   //!< type ids
+    };
+
+//! Flags selecting the properties that ParticleData::getByTag() gathers
+namespace tag_field
+    {
+    enum Enum
+        {
+        position = 1,         //!< Position and image, relative to the origin like getPosition()
+        velocity = 2,         //!< Velocity and mass
+        type = 4,             //!< Type id
+        charge = 8,           //!< Charge
+        diameter = 16,        //!< Diameter
+        body = 32,            //!< Body id
+        orientation = 64,     //!< Orientation
+        all = 127             //!< All of the above
+        };
+    }
+
+//! Properties of a list of particles, gathered by tag
+/*! Element i of each array holds the property of the i-th requested tag. Arrays of properties that were not
+    requested are left empty. See ParticleData::getByTag().
+ */
+struct TagData
+    {
+    std::vector<Scalar3> pos;           //!< Positions
+    std::vector<int3> image;            //!< Images
+    std::vector<Scalar3> vel;           //!< Velocities
+    std::vector<Scalar> mass;           //!< Masses
+    std::vector<unsigned int> type;     //!< Type ids
+    std::vector<Scalar> charge;         //!< Charges
+    std::vector<Scalar> diameter;       //!< Diameters
+    std::vector<unsigned int> body;     //!< Body ids
+    std::vector<Scalar4> orientation;   //!< Orientations
+    };
+
 //! Manages all of the data arrays for the particles
 /*! <h1> General </h1>
     ParticleData stores and manages particle coordinates, velocities, accelerations, type,
@@ -337,6 +453,12 @@ struct pdata_element
     (by amortized array resizing). Note that getMaxN() can return a higher number
     than the actual number of particles.
 
+    Since every reallocation resizes all per-particle arrays here and in the subscribers, the arrays grow by at least
+    m_min_growth particles at once, and the new size leaves room for the largest ghost layer held so far. This way,
+    adding single particles (e.g. in grand-canonical simulations) does not reallocate the arrays for every few
+    insertions, and the ghost exchange following a growth of the local particle number does not trigger a second
+    reallocation.
+
     Particle data also stores temporary particles ('ghost atoms'). These are added after the local particle data (i.e. with indices
     starting at getN()). It keeps track of those particles using the addGhostParticles() and removeAllGhostParticles() methods.
     The caller is responsible for updating the particle data arrays with the ghost particle information.
@@ -577,6 +699,27 @@ class PYBIND11_EXPORT ParticleData
         //! Return positions and types
         const GlobalArray< Scalar4 >& getPositions() const { return m_pos; }
 
+        //! Return a structure-of-arrays copy of the positions and types of local and ghost particles
+        const PositionsSoA& getPositionsSoA(unsigned int timestep, bool ghosts=true);
+
+        //! Mark the structure-of-arrays position copy as out of date
+        /*! Must be called after positions are modified in the middle of a time step (i.e. after ghosts have been
+            communicated), it is called automatically on particle sorts and ghost removal.
+         */
+        void invalidatePositionsSoA()
+            {
+            m_pos_soa_n_valid = 0;
+            }
+
+        //! Mark only the ghost rows of the structure-of-arrays position copy as out of date
+        /*! Called after a ghost update that left the local positions untouched, so that the local rows filled
+            during the update are not copied again.
+         */
+        void invalidateGhostPositionsSoA()
+            {
+            m_pos_soa_n_valid = std::min(m_pos_soa_n_valid, getN());
+            }
+
         //! Return velocities and masses
         const GlobalArray< Scalar4 >& getVelocities() const { return m_vel; }
 
@@ -772,6 +915,20 @@ class PYBIND11_EXPORT ParticleData
             return m_composite_particles_signal;
             }
 
+        //! Connects a function to be called before the potential energy in the net force is read
+        /*! The Integrator completes the energies in the net force when some of the forces skipped them.
+         */
+        Nano::Signal<void ()>& getNetEnergySignal()
+            {
+            return m_net_energy_signal;
+            }
+
+        //! Make sure the potential energy in the net force is complete
+        void validateNetEnergy() const
+            {
+            m_net_energy_signal.emit();
+            }
+
         //! Gets the particle type index given a name
         unsigned int getTypeByName(const std::string &name) const;
 
@@ -882,6 +1039,17 @@ class PYBIND11_EXPORT ParticleData
         //! Get the moment of inertia of a particle with a given tag
         Scalar3 getMomentsOfInertia(unsigned int tag) const;
 
+        //! Get the local indices of a list of particles
+        void getRTagList(const std::vector<unsigned int>& tags, std::vector<unsigned int>& rtags) const;
+
+        //! Get properties of a list of particles
+        void getByTag(const std::vector<unsigned int>& tags, unsigned int fields, TagData& data) const;
+
+        //! Get properties of a list of particles as numpy arrays (for python)
+        static pybind11::dict getByTagNP(pybind11::object self,
+                                         pybind11::array_t<unsigned int, pybind11::array::c_style | pybind11::array::forcecast> tags,
+                                         unsigned int fields);
+
         //! Get the net force / energy on a given particle
         Scalar4 getPNetForce(unsigned int tag) const;
 
@@ -969,6 +1137,10 @@ class PYBIND11_EXPORT ParticleData
         template <class Real>
         void initializeFromSnapshot(const SnapshotParticleData<Real> & snapshot, bool ignore_bodies=false);
 
+        //! Overwrite the particle properties in place from a snapshot of the same system
+        template <class Real>
+        bool updateFromSnapshot(const SnapshotParticleData<Real> & snapshot);
+
         //! Take a snapshot
         template <class Real>
         std::map<unsigned int, unsigned int> takeSnapshot(SnapshotParticleData<Real> &snapshot);
@@ -1001,6 +1173,22 @@ class PYBIND11_EXPORT ParticleData
             return m_decomposition;
             }
 
+        //! Set whether the owners of particles are found with a distributed tag directory
+        /*! \param enable True to look up the owners of particles with a TagDirectory
+
+            Without the directory, every lookup of the owner of a particle (getOwnerRank(), used by the accessors of
+            single particles) searches all ranks with two reductions. With the directory, the directory is rebuilt
+            with one exchange after the particles have migrated, and each lookup is then answered by one broadcast
+            from the home rank of the tag.
+        */
+        void setTagDirectory(bool enable)
+            {
+            m_use_tag_directory = enable;
+            m_tag_directory_valid = false;
+            if (enable && !m_tag_directory)
+                m_tag_directory = std::unique_ptr<TagDirectory>(new TagDirectory(m_exec_conf));
+            }
+
         //! Pack particle data into a buffer
         /*! \param out Buffer into which particle data is packed
          *  \param comm_flags Buffer into which communication flags is packed
@@ -1102,6 +1290,9 @@ class PYBIND11_EXPORT ParticleData
         std::shared_ptr<ExecutionConfiguration> m_exec_conf; //!< The execution configuration
 #ifdef ENABLE_MPI
         std::shared_ptr<DomainDecomposition> m_decomposition;       //!< Domain decomposition data
+        bool m_use_tag_directory;                                   //!< True if owners are found with the directory
+        mutable std::unique_ptr<TagDirectory> m_tag_directory;      //!< Distributed directory of the particle owners
+        mutable bool m_tag_directory_valid;                         //!< True if the directory is up to date
 #endif
 
         std::vector<std::string> m_type_mapping;    //!< Mapping between particle type indices and names
@@ -1113,6 +1304,7 @@ class PYBIND11_EXPORT ParticleData
         Nano::Signal<void ()> m_global_particle_num_signal; //!< Signal that is triggered when the global number of particles changes
         Nano::Signal<void ()> m_num_types_signal;  //!< Signal that is triggered when the number of types changes
         Nano::Signal<Scalar ()> m_composite_particles_signal;  //!< Signal that is triggered when the maximum diameter of a composite particle is needed
+        mutable Nano::Signal<void ()> m_net_energy_signal; //!< Signal that is triggered before the energy in the net force is read
 
         #ifdef ENABLE_MPI
         Nano::Signal<void (unsigned int, unsigned int, unsigned int)> m_ptl_move_signal; //!< Signal when particle moves between domains
@@ -1121,6 +1313,7 @@ class PYBIND11_EXPORT ParticleData
         unsigned int m_nparticles;                  //!< number of particles
         unsigned int m_nghosts;                     //!< number of ghost particles
         unsigned int m_max_nparticles;              //!< maximum number of particles
+        unsigned int m_max_nghosts;                 //!< largest number of ghost particles held so far
         unsigned int m_nglobal;                     //!< global number of particles
         bool m_accel_set;                           //!< Flag to tell if acceleration data has been set
 
@@ -1144,6 +1337,10 @@ class PYBIND11_EXPORT ParticleData
         std::vector<unsigned int> m_cached_tag_set;   //!< Cached constant-time lookup table for tags by active index
         bool m_invalid_cached_tags;                  //!< true if m_cached_tag_set needs to be rebuilt
 
+        PositionsSoA m_pos_soa;                      //!< Structure-of-arrays copy of positions and types
+        unsigned int m_pos_soa_n_valid;              //!< Number of leading rows of m_pos_soa that are up to date
+        unsigned int m_pos_soa_timestep;             //!< Time step at which m_pos_soa was last filled
+
         /* Alternate particle data arrays are provided for fast swapping in and out of particle data
            The size of these arrays is updated in sync with the main particle data arrays.
 
@@ -1177,6 +1374,7 @@ class PYBIND11_EXPORT ParticleData
         Scalar m_external_virial[6];                 //!< External potential contribution to the virial
         Scalar m_external_energy;                    //!< External potential energy
         const float m_resize_factor;                 //!< The numerical factor with which the particle data arrays are resized
+        const unsigned int m_min_growth;             //!< Minimum number of particles by which the arrays are grown
         PDataFlags m_flags;                          //!< Flags identifying which optional fields are valid
 
         Scalar3 m_origin;                            //!< Tracks the position of the origin of the coordinate system
@@ -1200,6 +1398,9 @@ class PYBIND11_EXPORT ParticleData
         //! Helper function for amortized array resizing
         void resize(unsigned int new_nparticles);
 
+        //! Helper function to compute the amortized array size for a number of local and ghost particles
+        unsigned int getGrowthCapacity(unsigned int nparticles, unsigned int nghosts) const;
+
         //! Helper function to reallocate particle data
         void reallocate(unsigned int max_n);
 
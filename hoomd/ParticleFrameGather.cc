@@ -0,0 +1,304 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file ParticleFrameGather.cc
+    \brief Defines the ParticleFrameGather class
+*/
+
+#include "ParticleFrameGather.h"
+
+#ifdef ENABLE_CUDA
+#include "ParticleFrameGather.cuh"
+#endif
+
+#include <algorithm>
+#include <numeric>
+
+#ifdef ENABLE_MPI
+//! Gather the packed values of all ranks on the root rank
+/*! \param send Packed values of the local particles
+    \param n Number of local particles
+    \param recv Received values on the root rank (output)
+    \param counts Number of particles per rank
+    \param displs Offset of the particles of each rank
+    \param mpi_comm MPI communicator
+
+    The values are transferred with a contiguous MPI datatype of sizeof(T) bytes, so that the counts are in particles
+    and do not overflow for large systems.
+*/
+template<class T>
+static void gatherFrameArray(const T *send,
+                             unsigned int n,
+                             std::vector<T>& recv,
+                             const std::vector<int>& counts,
+                             const std::vector<int>& displs,
+                             const MPI_Comm mpi_comm)
+    {
+    MPI_Datatype mpi_type;
+    MPI_Type_contiguous(sizeof(T), MPI_BYTE, &mpi_type);
+    MPI_Type_commit(&mpi_type);
+
+    MPI_Gatherv((void *)send,
+                n,
+                mpi_type,
+                recv.size() ? &recv.front() : NULL,
+                counts.size() ? (int *)&counts.front() : NULL,
+                displs.size() ? (int *)&displs.front() : NULL,
+                mpi_type,
+                0,
+                mpi_comm);
+
+    MPI_Type_free(&mpi_type);
+    }
+#endif
+
+//! Scatter the gathered values to their output index
+template<class T>
+static void placeFrameArray(const T *in, std::vector<T>& out, const std::vector<unsigned int>& dest)
+    {
+    for (unsigned int i = 0; i < dest.size(); i++)
+        out[dest[i]] = in[i];
+    }
+
+/*! \param pdata Particle data to gather
+*/
+ParticleFrameGather::ParticleFrameGather(std::shared_ptr<ParticleData> pdata)
+    : m_pdata(pdata), m_exec_conf(pdata->getExecConf())
+    {
+    GlobalArray<float3> pack_pos(m_pdata->getMaxN(), m_exec_conf);
+    m_pack_pos.swap(pack_pos);
+
+    GlobalArray<unsigned int> pack_tag(m_pdata->getMaxN(), m_exec_conf);
+    m_pack_tag.swap(pack_tag);
+    }
+
+/*! \param flags Optional properties to pack (frame_flags)
+    Packs the properties of the local particles in single precision into the m_pack arrays.
+*/
+void ParticleFrameGather::pack(unsigned int flags)
+    {
+    unsigned int N = m_pdata->getN();
+
+    // size the packed arrays, the optional ones are only allocated once they are requested
+    if (m_pack_pos.getNumElements() < N)
+        {
+        m_pack_pos.resize(N);
+        m_pack_tag.resize(N);
+        }
+    if ((flags & frame_image) && m_pack_image.getNumElements() < std::max(N, 1u))
+        {
+        GlobalArray<int3> pack_image(std::max(N, 1u), m_exec_conf);
+        m_pack_image.swap(pack_image);
+        }
+    if ((flags & frame_body) && m_pack_body.getNumElements() < std::max(N, 1u))
+        {
+        GlobalArray<unsigned int> pack_body(std::max(N, 1u), m_exec_conf);
+        m_pack_body.swap(pack_body);
+        }
+    if ((flags & frame_orientation) && m_pack_orientation.getNumElements() < std::max(N, 1u))
+        {
+        GlobalArray<float4> pack_orientation(std::max(N, 1u), m_exec_conf);
+        m_pack_orientation.swap(pack_orientation);
+        }
+
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        // convert on the device, so that only the single precision values are copied to the host
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<int3> d_image(m_pdata->getImages(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+
+        ArrayHandle<float3> d_pack_pos(m_pack_pos, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_pack_tag(m_pack_tag, access_location::device, access_mode::overwrite);
+
+        // the optional outputs are only acquired when they are requested
+        std::unique_ptr< ArrayHandle<int3> > d_pack_image;
+        std::unique_ptr< ArrayHandle<unsigned int> > d_pack_body;
+        std::unique_ptr< ArrayHandle<float4> > d_pack_orientation;
+        if (flags & frame_image)
+            d_pack_image.reset(new ArrayHandle<int3>(m_pack_image, access_location::device, access_mode::overwrite));
+        if (flags & frame_body)
+            d_pack_body.reset(new ArrayHandle<unsigned int>(m_pack_body, access_location::device, access_mode::overwrite));
+        if (flags & frame_orientation)
+            d_pack_orientation.reset(new ArrayHandle<float4>(m_pack_orientation,
+                access_location::device, access_mode::overwrite));
+
+        gpu_pack_frame(N,
+                       d_pos.data,
+                       d_image.data,
+                       d_body.data,
+                       d_orientation.data,
+                       d_tag.data,
+                       d_pack_pos.data,
+                       d_pack_image ? d_pack_image->data : NULL,
+                       d_pack_body ? d_pack_body->data : NULL,
+                       d_pack_orientation ? d_pack_orientation->data : NULL,
+                       d_pack_tag.data);
+
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        return;
+        }
+    #endif
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<float3> h_pack_pos(m_pack_pos, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_pack_tag(m_pack_tag, access_location::host, access_mode::overwrite);
+
+    for (unsigned int idx = 0; idx < N; idx++)
+        {
+        Scalar4 postype = h_pos.data[idx];
+        h_pack_pos.data[idx] = make_float3(postype.x, postype.y, postype.z);
+        h_pack_tag.data[idx] = h_tag.data[idx];
+        }
+
+    if (flags & frame_image)
+        {
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_pack_image(m_pack_image, access_location::host, access_mode::overwrite);
+        std::copy(h_image.data, h_image.data + N, h_pack_image.data);
+        }
+
+    if (flags & frame_body)
+        {
+        ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_pack_body(m_pack_body, access_location::host, access_mode::overwrite);
+        std::copy(h_body.data, h_body.data + N, h_pack_body.data);
+        }
+
+    if (flags & frame_orientation)
+        {
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<float4> h_pack_orientation(m_pack_orientation, access_location::host, access_mode::overwrite);
+        for (unsigned int idx = 0; idx < N; idx++)
+            {
+            Scalar4 q = h_orientation.data[idx];
+            h_pack_orientation.data[idx] = make_float4(q.x, q.y, q.z, q.w);
+            }
+        }
+    }
+
+/*! \param tag Tags of the gathered particles
+    \param n Number of gathered particles
+
+    Without gaps in the tags, a particle is placed at the index of its tag. Otherwise, the particles are ordered by
+    ascending tag like in SnapshotParticleData.
+*/
+void ParticleFrameGather::computeDestinations(const unsigned int *tag, unsigned int n)
+    {
+    m_dest.resize(n);
+
+    if (n == 0 || m_pdata->getMaximumTag() + 1 == n)
+        {
+        std::copy(tag, tag + n, m_dest.begin());
+        }
+    else
+        {
+        std::vector<unsigned int> order(n);
+        std::iota(order.begin(), order.end(), 0);
+        std::sort(order.begin(), order.end(),
+            [tag](unsigned int a, unsigned int b) { return tag[a] < tag[b]; });
+
+        for (unsigned int i = 0; i < n; i++)
+            m_dest[order[i]] = i;
+        }
+    }
+
+/*! \param flags Optional properties to gather (frame_flags)
+    \note gather() is collective and must be called on all ranks.
+*/
+void ParticleFrameGather::gather(unsigned int flags)
+    {
+    pack(flags);
+
+    unsigned int N = m_pdata->getN();
+
+    ArrayHandle<float3> h_pack_pos(m_pack_pos, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_pack_tag(m_pack_tag, access_location::host, access_mode::read);
+
+    std::unique_ptr< ArrayHandle<int3> > h_pack_image;
+    std::unique_ptr< ArrayHandle<unsigned int> > h_pack_body;
+    std::unique_ptr< ArrayHandle<float4> > h_pack_orientation;
+    if (flags & frame_image)
+        h_pack_image.reset(new ArrayHandle<int3>(m_pack_image, access_location::host, access_mode::read));
+    if (flags & frame_body)
+        h_pack_body.reset(new ArrayHandle<unsigned int>(m_pack_body, access_location::host, access_mode::read));
+    if (flags & frame_orientation)
+        h_pack_orientation.reset(new ArrayHandle<float4>(m_pack_orientation, access_location::host, access_mode::read));
+
+    // gathered values, the packed values of this rank in serial runs
+    const float3 *pos = h_pack_pos.data;
+    const unsigned int *tag = h_pack_tag.data;
+    const int3 *image = h_pack_image ? h_pack_image->data : NULL;
+    const unsigned int *body = h_pack_body ? h_pack_body->data : NULL;
+    const float4 *orientation = h_pack_orientation ? h_pack_orientation->data : NULL;
+    unsigned int n = N;
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        const MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+        bool root = m_exec_conf->isRoot();
+
+        int n_local = N;
+        m_counts.resize(root ? m_exec_conf->getNRanks() : 0);
+        MPI_Gather(&n_local, 1, MPI_INT, root ? &m_counts.front() : NULL, 1, MPI_INT, 0, mpi_comm);
+
+        n = 0;
+        m_displs.resize(m_counts.size());
+        for (unsigned int i = 0; i < m_counts.size(); i++)
+            {
+            m_displs[i] = n;
+            n += m_counts[i];
+            }
+
+        m_recv_tag.resize(n);
+        m_recv_pos.resize(n);
+        gatherFrameArray(h_pack_tag.data, N, m_recv_tag, m_counts, m_displs, mpi_comm);
+        gatherFrameArray(h_pack_pos.data, N, m_recv_pos, m_counts, m_displs, mpi_comm);
+        tag = n ? &m_recv_tag.front() : NULL;
+        pos = n ? &m_recv_pos.front() : NULL;
+
+        if (flags & frame_image)
+            {
+            m_recv_image.resize(n);
+            gatherFrameArray(h_pack_image->data, N, m_recv_image, m_counts, m_displs, mpi_comm);
+            image = n ? &m_recv_image.front() : NULL;
+            }
+        if (flags & frame_body)
+            {
+            m_recv_body.resize(n);
+            gatherFrameArray(h_pack_body->data, N, m_recv_body, m_counts, m_displs, mpi_comm);
+            body = n ? &m_recv_body.front() : NULL;
+            }
+        if (flags & frame_orientation)
+            {
+            m_recv_orientation.resize(n);
+            gatherFrameArray(h_pack_orientation->data, N, m_recv_orientation, m_counts, m_displs, mpi_comm);
+            orientation = n ? &m_recv_orientation.front() : NULL;
+            }
+        }
+    #endif
+
+    // place the particles in tag order, n is zero on all but the root rank
+    computeDestinations(tag, n);
+
+    m_pos.resize(n);
+    placeFrameArray(pos, m_pos, m_dest);
+
+    m_image.resize((flags & frame_image) ? n : 0);
+    if (flags & frame_image)
+        placeFrameArray(image, m_image, m_dest);
+
+    m_body.resize((flags & frame_body) ? n : 0);
+    if (flags & frame_body)
+        placeFrameArray(body, m_body, m_dest);
+
+    m_orientation.resize((flags & frame_orientation) ? n : 0);
+    if (flags & frame_orientation)
+        placeFrameArray(orientation, m_orientation, m_dest);
+    }
@@ -0,0 +1,89 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "ParticleFrameGather.cuh"
+
+/*! \file ParticleFrameGather.cu
+    \brief Implements GPU kernel code used by ParticleFrameGather
+*/
+
+//! Kernel to pack the particle properties of a frame in single precision
+/*! One thread per particle. The optional outputs are skipped when their pointer is NULL.
+*/
+__global__ void gpu_pack_frame_kernel(const unsigned int N,
+                                      const Scalar4 *d_pos,
+                                      const int3 *d_image,
+                                      const unsigned int *d_body,
+                                      const Scalar4 *d_orientation,
+                                      const unsigned int *d_tag,
+                                      float3 *d_frame_pos,
+                                      int3 *d_frame_image,
+                                      unsigned int *d_frame_body,
+                                      float4 *d_frame_orientation,
+                                      unsigned int *d_frame_tag)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (idx >= N)
+        return;
+
+    Scalar4 postype = d_pos[idx];
+    d_frame_pos[idx] = make_float3(postype.x, postype.y, postype.z);
+    d_frame_tag[idx] = d_tag[idx];
+
+    if (d_frame_image)
+        d_frame_image[idx] = d_image[idx];
+
+    if (d_frame_body)
+        d_frame_body[idx] = d_body[idx];
+
+    if (d_frame_orientation)
+        {
+        Scalar4 q = d_orientation[idx];
+        d_frame_orientation[idx] = make_float4(q.x, q.y, q.z, q.w);
+        }
+    }
+
+/*! \param N Number of local particles
+    \param d_pos Particle positions
+    \param d_image Particle images
+    \param d_body Particle body ids
+    \param d_orientation Particle orientations
+    \param d_tag Particle tags
+    \param d_frame_pos Packed positions (output)
+    \param d_frame_image Packed images (output, may be NULL)
+    \param d_frame_body Packed body ids (output, may be NULL)
+    \param d_frame_orientation Packed orientations (output, may be NULL)
+    \param d_frame_tag Packed tags (output)
+*/
+cudaError_t gpu_pack_frame(const unsigned int N,
+                           const Scalar4 *d_pos,
+                           const int3 *d_image,
+                           const unsigned int *d_body,
+                           const Scalar4 *d_orientation,
+                           const unsigned int *d_tag,
+                           float3 *d_frame_pos,
+                           int3 *d_frame_image,
+                           unsigned int *d_frame_body,
+                           float4 *d_frame_orientation,
+                           unsigned int *d_frame_tag)
+    {
+    if (N == 0)
+        return cudaSuccess;
+
+    unsigned int block_size = 256;
+
+    gpu_pack_frame_kernel<<<N/block_size + 1, block_size>>>(N,
+                                                              d_pos,
+                                                              d_image,
+                                                              d_body,
+                                                              d_orientation,
+                                                              d_tag,
+                                                              d_frame_pos,
+                                                              d_frame_image,
+                                                              d_frame_body,
+                                                              d_frame_orientation,
+                                                              d_frame_tag);
+
+    return cudaSuccess;
+    }
@@ -0,0 +1,27 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _PARTICLE_FRAME_GATHER_CUH_
+#define _PARTICLE_FRAME_GATHER_CUH_
+
+#include <cuda_runtime.h>
+#include "HOOMDMath.h"
+
+/*! \file ParticleFrameGather.cuh
+    \brief Declares GPU kernel code used by ParticleFrameGather
+*/
+
+//! Pack the particle properties of a frame in single precision
+cudaError_t gpu_pack_frame(const unsigned int N,
+                           const Scalar4 *d_pos,
+                           const int3 *d_image,
+                           const unsigned int *d_body,
+                           const Scalar4 *d_orientation,
+                           const unsigned int *d_tag,
+                           float3 *d_frame_pos,
+                           int3 *d_frame_image,
+                           unsigned int *d_frame_body,
+                           float4 *d_frame_orientation,
+                           unsigned int *d_frame_tag);
+
+#endif
@@ -0,0 +1,107 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file ParticleFrameGather.h
+    \brief Declares the ParticleFrameGather class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __PARTICLE_FRAME_GATHER_H__
+#define __PARTICLE_FRAME_GATHER_H__
+
+#include "ParticleData.h"
+
+#include <memory>
+#include <vector>
+
+//! Gathers the particle positions of a trajectory frame in single precision on the root rank
+/*! Trajectory writers only need the positions, and sometimes the images, body ids or orientations, in single
+    precision. ParticleData::takeSnapshot() copies every particle property to the root rank in Scalar precision and
+    allocates new vectors on each call. ParticleFrameGather packs only the requested properties of the local
+    particles in single precision (on the GPU when it is enabled), gathers them with MPI_Gatherv and places them in
+    tag order on the root rank. All buffers are kept between frames.
+
+    After gather(), the arrays are ordered by ascending tag like the arrays of SnapshotParticleData and hold
+    getNGlobal() entries on the root rank. They are empty on the other ranks.
+
+    \ingroup data_structs
+*/
+class PYBIND11_EXPORT ParticleFrameGather
+    {
+    public:
+        //! Optional properties to gather in addition to the positions
+        enum frame_flags
+            {
+            frame_image = 1,
+            frame_body = 2,
+            frame_orientation = 4
+            };
+
+        //! Constructor
+        ParticleFrameGather(std::shared_ptr<ParticleData> pdata);
+
+        //! Gather the positions and the properties in \a flags on the root rank
+        void gather(unsigned int flags);
+
+        //! Get the positions in tag order
+        const std::vector<float3>& getPositions() const
+            {
+            return m_pos;
+            }
+
+        //! Get the images in tag order (with frame_image)
+        const std::vector<int3>& getImages() const
+            {
+            return m_image;
+            }
+
+        //! Get the body ids in tag order (with frame_body)
+        const std::vector<unsigned int>& getBodies() const
+            {
+            return m_body;
+            }
+
+        //! Get the orientations in tag order as (s, x, y, z) (with frame_orientation)
+        const std::vector<float4>& getOrientations() const
+            {
+            return m_orientation;
+            }
+
+    private:
+        std::shared_ptr<ParticleData> m_pdata;                  //!< Particle data to gather
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Execution configuration
+
+        GlobalArray<float3> m_pack_pos;             //!< Packed positions of the local particles
+        GlobalArray<int3> m_pack_image;             //!< Packed images of the local particles
+        GlobalArray<unsigned int> m_pack_body;      //!< Packed body ids of the local particles
+        GlobalArray<float4> m_pack_orientation;     //!< Packed orientations of the local particles
+        GlobalArray<unsigned int> m_pack_tag;       //!< Tags of the local particles
+
+        std::vector<float3> m_pos;                  //!< Gathered positions in tag order
+        std::vector<int3> m_image;                  //!< Gathered images in tag order
+        std::vector<unsigned int> m_body;           //!< Gathered body ids in tag order
+        std::vector<float4> m_orientation;          //!< Gathered orientations in tag order
+
+        std::vector<unsigned int> m_dest;           //!< Output index of each packed particle
+
+        #ifdef ENABLE_MPI
+        std::vector<int> m_counts;                  //!< Number of particles received from each rank
+        std::vector<int> m_displs;                  //!< Offset of the particles of each rank
+        std::vector<unsigned int> m_recv_tag;       //!< Tags received on the root rank
+        std::vector<float3> m_recv_pos;             //!< Positions received on the root rank
+        std::vector<int3> m_recv_image;             //!< Images received on the root rank
+        std::vector<unsigned int> m_recv_body;      //!< Body ids received on the root rank
+        std::vector<float4> m_recv_orientation;     //!< Orientations received on the root rank
+        #endif
+
+        //! Pack the local particle data
+        void pack(unsigned int flags);
+
+        //! Compute the output index of every gathered particle from its tag
+        void computeDestinations(const unsigned int *tag, unsigned int n);
+    };
+
+#endif
@@ -12,6 +12,12 @@
 #include <cuda_runtime.h>
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
+#include "hoomd/extern/pybind/include/pybind11/numpy.h"
+
 #include <algorithm>
 #include <iostream>
 using namespace std;
@@ -290,6 +296,7 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef,
       m_particles_sorted(true),
       m_reallocated(false),
       m_global_ptl_num_change(false),
+      m_index_list_valid(false),
       m_selector(selector),
       m_update_tags(update_tags),
       m_warning_printed(false)
@@ -328,6 +335,7 @@ ParticleGroup::ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, const std
       m_particles_sorted(true),
       m_reallocated(false),
       m_global_ptl_num_change(false),
+      m_index_list_valid(false),
       m_update_tags(false),
       m_warning_printed(false)
     {
@@ -493,6 +501,9 @@ void ParticleGroup::updateMemberTags(bool force_update) const
     // build the reverse lookup table for tags
     buildTagHash();
 
+    // the new arrays do not hold an index list yet
+    m_index_list_valid = false;
+
     // now that the tag list is completely set up and all memory is allocated, rebuild the index list
     rebuildIndexList();
     }
@@ -500,6 +511,7 @@ void ParticleGroup::updateMemberTags(bool force_update) const
 void ParticleGroup::reallocate() const
     {
     m_is_member.resize(m_pdata->getMaxN());
+    m_index_list_valid = false;
 
     if (m_is_member_tag.getNumElements() != m_pdata->getRTags().size())
         {
@@ -725,6 +737,9 @@ void ParticleGroup::buildTagHash() const
     \pre memory has been allocated for m_is_member and m_member_idx
     \post m_is_member is updated so that it reflects the current indices of the particles in the group
     \post m_member_idx is updated listing all particle indices belonging to the group, in index order
+
+    On the CPU, groups with few members compared to the number of local particles look up the current index of every
+    member tag, and only reset the flags of the previous members. Larger groups scan all local particles.
 */
 void ParticleGroup::rebuildIndexList() const
     {
@@ -739,27 +754,12 @@ void ParticleGroup::rebuildIndexList() const
     else
     #endif
         {
+        if (m_index_list_valid && size_t(m_member_tags.getNumElements())*8 < m_pdata->getN())
+            rebuildIndexListSparse();
+        else
+            rebuildIndexListDense();
 
-        // rebuild the membership flags for the  indices in the group and construct member list
-        ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
-        ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
-        unsigned int nparticles = m_pdata->getN();
-        unsigned int cur_member = 0;
-        for (unsigned int idx = 0; idx < nparticles; idx ++)
-            {
-            assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
-            unsigned int is_member = h_is_member_tag.data[h_tag.data[idx]];
-            h_is_member.data[idx] =  is_member;
-            if (is_member)
-                {
-                h_member_idx.data[cur_member] = idx;
-                cur_member++;
-                }
-            }
-
-        m_num_local_members = cur_member;
+        m_index_list_valid = true;
         assert(m_num_local_members <= m_member_tags.getNumElements());
         }
 
@@ -775,6 +775,114 @@ void ParticleGroup::rebuildIndexList() const
     #endif
     }
 
+/*! The membership flags are set for all local particles, and the member indices are compacted in parallel chunks
+    when running with multiple threads.
+*/
+void ParticleGroup::rebuildIndexListDense() const
+    {
+    // rebuild the membership flags for the  indices in the group and construct member list
+    ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_is_member_tag(m_is_member_tag, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
+    unsigned int nparticles = m_pdata->getN();
+
+    #ifdef ENABLE_TBB
+    if (m_exec_conf->getNumThreads() > 1 && nparticles > 0)
+        {
+        const unsigned int n_chunks = std::min(m_exec_conf->getNumThreads(), nparticles);
+        const unsigned int chunk_size = (nparticles + n_chunks - 1) / n_chunks;
+        std::vector<unsigned int> chunk_offset(n_chunks+1, 0);
+
+        // set the flags and count the members in every chunk
+        tbb::parallel_for((unsigned int)0, n_chunks, [&](unsigned int chunk)
+            {
+            const unsigned int idx_end = std::min((chunk+1)*chunk_size, nparticles);
+            unsigned int n_members = 0;
+            for (unsigned int idx = chunk*chunk_size; idx < idx_end; idx++)
+                {
+                assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
+                unsigned int is_member = h_is_member_tag.data[h_tag.data[idx]];
+                h_is_member.data[idx] = is_member;
+                n_members += is_member ? 1 : 0;
+                }
+            chunk_offset[chunk+1] = n_members;
+            });
+
+        for (unsigned int chunk = 0; chunk < n_chunks; chunk++)
+            chunk_offset[chunk+1] += chunk_offset[chunk];
+
+        // write the member indices
+        tbb::parallel_for((unsigned int)0, n_chunks, [&](unsigned int chunk)
+            {
+            const unsigned int idx_end = std::min((chunk+1)*chunk_size, nparticles);
+            unsigned int cur_member = chunk_offset[chunk];
+            for (unsigned int idx = chunk*chunk_size; idx < idx_end; idx++)
+                {
+                if (h_is_member.data[idx])
+                    h_member_idx.data[cur_member++] = idx;
+                }
+            });
+
+        m_num_local_members = chunk_offset[n_chunks];
+        return;
+        }
+    #endif
+
+    unsigned int cur_member = 0;
+    for (unsigned int idx = 0; idx < nparticles; idx ++)
+        {
+        assert(h_tag.data[idx] <= m_pdata->getMaximumTag());
+        unsigned int is_member = h_is_member_tag.data[h_tag.data[idx]];
+        h_is_member.data[idx] =  is_member;
+        if (is_member)
+            {
+            h_member_idx.data[cur_member] = idx;
+            cur_member++;
+            }
+        }
+
+    m_num_local_members = cur_member;
+    }
+
+/*! \pre m_is_member and m_member_idx hold the previous index list, i.e. m_index_list_valid is true
+
+    The work is proportional to the number of members in the group instead of the number of local particles.
+*/
+void ParticleGroup::rebuildIndexListSparse() const
+    {
+    ArrayHandle<unsigned int> h_is_member(m_is_member, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_member_tags(m_member_tags, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_member_idx(m_member_idx, access_location::host, access_mode::readwrite);
+    unsigned int nparticles = m_pdata->getN();
+
+    // reset the flags of the previous members, m_is_member is indexed by particle index and not affected by the sort
+    for (unsigned int i = 0; i < m_num_local_members; ++i)
+        h_is_member.data[h_member_idx.data[i]] = 0;
+
+    // look up the local members
+    unsigned int cur_member = 0;
+    unsigned int n_members_global = m_member_tags.getNumElements();
+    for (unsigned int member = 0; member < n_members_global; ++member)
+        {
+        unsigned int idx = h_rtag.data[h_member_tags.data[member]];
+
+        // skip ghosts and particles on other ranks
+        if (idx < nparticles)
+            {
+            h_is_member.data[idx] = 1;
+            h_member_idx.data[cur_member] = idx;
+            cur_member++;
+            }
+        }
+
+    // keep the member list in index order
+    std::sort(h_member_idx.data, h_member_idx.data + cur_member);
+
+    m_num_local_members = cur_member;
+    }
+
 void ParticleGroup::updateGPUAdvice() const
     {
     #ifdef ENABLE_CUDA
@@ -838,6 +946,19 @@ void ParticleGroup::rebuildIndexListGPU() const
     }
 #endif
 
+/*! \param self Python reference to the group
+    \returns A numpy array with a copy of the sorted member tags, so that python can iterate over the members without
+             accessing the tag list once per member
+*/
+py::object ParticleGroup::getMemberTagsNP(py::object self)
+    {
+    auto self_cpp = self.cast<ParticleGroup *>();
+    const GlobalArray<unsigned int>& member_tags = self_cpp->getMemberTagArray();
+
+    ArrayHandle<unsigned int> h_member_tags(member_tags, access_location::host, access_mode::read);
+    return py::array(self_cpp->getNumMembersGlobal(), h_member_tags.data);
+    }
+
 void export_ParticleGroup(py::module& m)
     {
     py::class_<ParticleGroup, std::shared_ptr<ParticleGroup> >(m,"ParticleGroup")
@@ -847,6 +968,7 @@ void export_ParticleGroup(py::module& m)
             .def(py::init<>())
             .def("getNumMembersGlobal", &ParticleGroup::getNumMembersGlobal)
             .def("getMemberTag", &ParticleGroup::getMemberTag)
+            .def("getMemberTags", &ParticleGroup::getMemberTagsNP)
             .def("getTotalMass", &ParticleGroup::getTotalMass)
             .def("getCenterOfMass", &ParticleGroup::getCenterOfMass)
             .def("groupUnion", &ParticleGroup::groupUnion)
@@ -193,7 +193,7 @@ class PYBIND11_EXPORT ParticleGroup
         // @{
 
         //! Constructs an empty particle group
-        ParticleGroup() : m_num_local_members(0) {};
+        ParticleGroup() : m_num_local_members(0), m_index_list_valid(false) {};
 
         //! Constructs a particle group of all particles that meet the given selection
         ParticleGroup(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleSelector> selector,
@@ -278,6 +278,20 @@ class PYBIND11_EXPORT ParticleGroup
             return h_handle.data[idx] == 1;
             }
 
+        //! Direct access to the sorted list of member tags
+        /*! \returns A GlobalArray with the tags of all members of the group, sorted in increasing order
+            \note The caller \b must \b not write to or change the array.
+        */
+        const GlobalArray<unsigned int>& getMemberTagArray() const
+            {
+            checkRebuild();
+
+            return m_member_tags;
+            }
+
+        //! Get the tags of all members of the group as a numpy array (for python)
+        static pybind11::object getMemberTagsNP(pybind11::object self);
+
         //! Direct access to the index list
         /*! \returns A GPUArray for directly accessing the index list, intended for use in using groups on the GPU
             \note The caller \b must \b not write to or change the array.
@@ -341,6 +355,7 @@ class PYBIND11_EXPORT ParticleGroup
         mutable bool m_particles_sorted;                //!< True if particle have been sorted since last rebuild
         mutable bool m_reallocated;                     //!< True if particle data arrays have been reallocated
         mutable bool m_global_ptl_num_change;           //!< True if the global particle number changed
+        mutable bool m_index_list_valid;                //!< True if m_is_member and m_member_idx hold the last index list
 
         mutable GlobalArray<unsigned int> m_is_member_tag;  //!< One byte per particle, == 1 if tag is a member of the group
         std::shared_ptr<ParticleSelector> m_selector; //!< The associated particle selector
@@ -358,6 +373,12 @@ class PYBIND11_EXPORT ParticleGroup
         //! Helper function to rebuild the index lists after the particles have been sorted
         void rebuildIndexList() const;
 
+        //! Helper function to rebuild the index lists by scanning all local particles
+        void rebuildIndexListDense() const;
+
+        //! Helper function to rebuild the index lists by looking up the member tags
+        void rebuildIndexListSparse() const;
+
         //! Helper function to rebuild internal arrays
         void checkRebuild() const
             {
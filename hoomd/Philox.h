@@ -0,0 +1,264 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+/*!
+ * \file hoomd/Philox.h
+ * \brief Implementation of the Philox4x32-10 counter-based random number generator.
+ */
+
+#ifndef HOOMD_PHILOX_H_
+#define HOOMD_PHILOX_H_
+
+// pull in uint2 and uint4 types
+#include "HOOMDMath.h"
+
+#include <stdint.h>
+
+#ifdef NVCC
+#define HOSTDEVICE __host__ __device__
+#else
+#define HOSTDEVICE
+#endif // NVCC
+
+namespace hoomd
+{
+namespace detail
+{
+
+//! Multiply two 32-bit words and return the high and low words of the product
+HOSTDEVICE inline void philox_mulhilo(unsigned int a, unsigned int b, unsigned int& hi, unsigned int& lo)
+    {
+    #ifdef __CUDA_ARCH__
+    hi = __umulhi(a, b);
+    lo = a*b;
+    #else
+    uint64_t p = uint64_t(a) * uint64_t(b);
+    hi = (unsigned int)(p >> 32);
+    lo = (unsigned int)p;
+    #endif
+    }
+
+//! Compute one block of the Philox4x32-10 bijection
+/*!
+ * \param ctr Counter
+ * \param key Key
+ * \returns Four random 32-bit words
+ *
+ * The function has no state and no branches, so loops that generate one block per particle are free of dependencies
+ * between iterations.
+ */
+HOSTDEVICE inline uint4 philox4x32_10(uint4 ctr, uint2 key)
+    {
+    const unsigned int M0 = 0xD2511F53;
+    const unsigned int M1 = 0xCD9E8D57;
+    const unsigned int W0 = 0x9E3779B9;
+    const unsigned int W1 = 0xBB67AE85;
+
+    #ifdef __CUDA_ARCH__
+    #pragma unroll
+    #endif
+    for (unsigned int round = 0; round < 10; ++round)
+        {
+        if (round > 0)
+            {
+            key.x += W0;
+            key.y += W1;
+            }
+
+        unsigned int hi0, lo0, hi1, lo1;
+        philox_mulhilo(M0, ctr.x, hi0, lo0);
+        philox_mulhilo(M1, ctr.z, hi1, lo1);
+
+        ctr = make_uint4(hi1 ^ ctr.y ^ key.x, lo1, hi0 ^ ctr.w ^ key.y, lo0);
+        }
+
+    return ctr;
+    }
+
+//! Philox4x32-10 random number generator
+/*!
+ * Philox is a counter-based generator (J.K. Salmon, M.A. Moraes, R.O. Dror, and D.E. Shaw. "Parallel random numbers:
+ * as easy as 1, 2, 3", SC '11). Every call of the bijection philox4x32_10() maps a 128-bit counter and a 64-bit key
+ * to four independent 32-bit words, and passes TestU01's BigCrush. The generator state is only the counter, so there
+ * is nothing to hash at construction and a stream can be positioned anywhere at no cost.
+ *
+ * HOOMD seeds the generator in the same way as Saru, from a particle tag, the timestep and the user seed. The tag and
+ * timestep form the first two counter words, the third counter word counts the blocks drawn, and the fourth counter
+ * word selects an independent stream for the same particle and timestep (e.g. translational and rotational noise).
+ * The user seed is the key.
+ *
+ * The block methods uniform4() and normal4() return four numbers from a single call. The scalar methods u32(), f(),
+ * d() and s() have the same signatures as in Saru, so the generator can be passed to the templated distributions
+ * (gaussian_rng() etc.).
+ */
+class Philox4x32
+    {
+    public:
+        //! Constructor
+        /*!
+         * \param seed1 First seed (usually the particle tag)
+         * \param seed2 Second seed (usually the timestep)
+         * \param seed3 Third seed (usually the user seed)
+         * \param stream Index of the stream
+         */
+        HOSTDEVICE inline Philox4x32(unsigned int seed1, unsigned int seed2, unsigned int seed3, unsigned int stream=0)
+            : m_n_buffer(0)
+            {
+            m_ctr = make_uint4(seed1, seed2, 0, stream);
+            m_key = make_uint2(seed3, 0x8a5cd789);
+            }
+
+        //! Generate the next block of four random words
+        HOSTDEVICE inline uint4 operator()()
+            {
+            uint4 r = philox4x32_10(m_ctr, m_key);
+            m_ctr.z++;
+            return r;
+            }
+
+        //! Draw four uniform random numbers in [a,b)
+        /*!
+         * \param a Lower bound
+         * \param b Upper bound
+         * \param r The random numbers (output)
+         *
+         * Every number has 24 random bits, which are exactly representable also in single precision.
+         */
+        template<class Real>
+        HOSTDEVICE inline void uniform4(Real a, Real b, Real r[4])
+            {
+            uint4 u = (*this)();
+            const Real scale = (b - a) * Real(5.9604644775390625e-08);
+            r[0] = a + Real(u.x >> 8) * scale;
+            r[1] = a + Real(u.y >> 8) * scale;
+            r[2] = a + Real(u.z >> 8) * scale;
+            r[3] = a + Real(u.w >> 8) * scale;
+            }
+
+        //! Draw four normally distributed random numbers
+        /*!
+         * \param sigma Standard deviation
+         * \param r The random numbers (output)
+         *
+         * Applies the Box-Muller transformation to the two pairs of words of one block, without rejection.
+         */
+        template<class Real>
+        HOSTDEVICE inline void normal4(Real sigma, Real r[4])
+            {
+            uint4 u = (*this)();
+            const Real two_pi = Real(6.283185307179586);
+
+            // map to (0,1] to keep the logarithm finite
+            Real u0 = Real((u.x >> 8) + 1) * Real(5.9604644775390625e-08);
+            Real u1 = Real(u.y >> 8) * Real(5.9604644775390625e-08);
+            Real u2 = Real((u.z >> 8) + 1) * Real(5.9604644775390625e-08);
+            Real u3 = Real(u.w >> 8) * Real(5.9604644775390625e-08);
+
+            Real ra = sigma * fast::sqrt(Real(-2.0) * fast::log(u0));
+            Real rb = sigma * fast::sqrt(Real(-2.0) * fast::log(u2));
+            r[0] = ra * fast::cos(two_pi * u1);
+            r[1] = ra * fast::sin(two_pi * u1);
+            r[2] = rb * fast::cos(two_pi * u3);
+            r[3] = rb * fast::sin(two_pi * u3);
+            }
+
+        //! Draw a random 32-bit unsigned integer
+        HOSTDEVICE inline unsigned int u32()
+            {
+            if (m_n_buffer == 0)
+                {
+                m_buffer = (*this)();
+                m_n_buffer = 4;
+                }
+
+            unsigned int r;
+            switch (m_n_buffer)
+                {
+                case 4: r = m_buffer.x; break;
+                case 3: r = m_buffer.y; break;
+                case 2: r = m_buffer.z; break;
+                default: r = m_buffer.w; break;
+                }
+            m_n_buffer--;
+            return r;
+            }
+
+        //! Draw a random float in [0,1)
+        HOSTDEVICE inline float f()
+            {
+            // use the upper 24 bits, which are exactly representable
+            return float(u32() >> 8) * 5.9604644775390625e-08f;
+            }
+
+        //! Draw a random double in [0,1)
+        HOSTDEVICE inline double d()
+            {
+            // use 53 bits from two words
+            unsigned int hi = u32() >> 5;
+            unsigned int lo = u32() >> 6;
+            return (double(hi) * 67108864.0 + double(lo)) * 1.1102230246251565e-16;
+            }
+
+        //! Draw a random float in [a,b)
+        HOSTDEVICE inline float f(float a, float b)
+            {
+            return a + (b-a) * f();
+            }
+
+        //! Draw a random double in [a,b)
+        HOSTDEVICE inline double d(double a, double b)
+            {
+            return a + (b-a) * d();
+            }
+
+        //! Draw a random number of type Real in [0,1)
+        template<class Real>
+        HOSTDEVICE inline Real s();
+
+        //! Draw a random number of type Real in [a,b)
+        template<class Real>
+        HOSTDEVICE inline Real s(Real a, Real b);
+
+    private:
+        uint4 m_ctr;                //!< Counter
+        uint2 m_key;                //!< Key
+        uint4 m_buffer;             //!< Words of the last block for the scalar methods
+        unsigned int m_n_buffer;    //!< Number of words left in m_buffer
+    };
+
+//! Draw a random float in [0,1)
+template<>
+HOSTDEVICE inline float Philox4x32::s()
+    {
+    return f();
+    }
+
+//! Draw a random double in [0,1)
+template<>
+HOSTDEVICE inline double Philox4x32::s()
+    {
+    return d();
+    }
+
+//! Draw a random float in [a,b)
+template<>
+HOSTDEVICE inline float Philox4x32::s(float a, float b)
+    {
+    return f(a, b);
+    }
+
+//! Draw a random double in [a,b)
+template<>
+HOSTDEVICE inline double Philox4x32::s(double a, double b)
+    {
+    return d(a, b);
+    }
+
+} // end namespace detail
+} // end namespace hoomd
+
+#undef HOSTDEVICE
+
+#endif // HOOMD_PHILOX_H_
@@ -12,6 +12,8 @@
 
 #include <iomanip>
 #include <sstream>
+#include <fstream>
+#include <stdexcept>
 
 
 using namespace std;
@@ -68,6 +70,22 @@ int64_t ProfileDataElem::getTotalMemByteCount() const
     // return the total
     return total;
     }
+int64_t ProfileDataElem::getChildHWFlopCount() const
+    {
+    int64_t total = 0;
+    map<string, ProfileDataElem>::const_iterator i;
+    for (i = m_children.begin(); i != m_children.end(); ++i)
+        total += (*i).second.m_hw_flop_count;
+    return total;
+    }
+int64_t ProfileDataElem::getChildHWByteCount() const
+    {
+    int64_t total = 0;
+    map<string, ProfileDataElem>::const_iterator i;
+    for (i = m_children.begin(); i != m_children.end(); ++i)
+        total += (*i).second.m_hw_byte_count;
+    return total;
+    }
 
 /*! Recursive output routine to write results from this profile node and all sub nodes printed in
     a tree.
@@ -76,8 +94,16 @@ int64_t ProfileDataElem::getTotalMemByteCount() const
     \param tab_level Current number of tabs in the tree
     \param total_time Total number of nanoseconds taken by this node
     \param name_width Maximum name width for all siblings of this node (used to align output columns)
+    \param peak_flops Peak FLOP rate of the hardware (0 if unknown)
+    \param peak_bandwidth Peak memory bandwidth of the hardware (0 if unknown)
  */
-void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_level, int64_t total_time, int name_width) const
+void ProfileDataElem::output(std::ostream &o,
+                             const std::string& name,
+                             int tab_level,
+                             int64_t total_time,
+                             int name_width,
+                             double peak_flops,
+                             double peak_bandwidth) const
     {
     // create a tab string to output for the current tab level
     string tabs = "";
@@ -92,13 +118,17 @@ void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_l
     double perc = double(m_elapsed_time)/double(total_time) * 100.0;
     double flops = 0.0;
     double bytes = 0.0;
+    double hw_flops = 0.0;
+    double hw_bytes = 0.0;
     if (m_children.size() == 0)
         {
         flops = double(getTotalFlopCount())/sec;
         bytes = double(getTotalMemByteCount())/sec;
+        hw_flops = double(m_hw_flop_count)/sec;
+        hw_bytes = double(m_hw_byte_count)/sec;
         }
 
-    output_line(o, name, sec, perc, flops, bytes, name_width);
+    output_line(o, name, sec, perc, flops, bytes, hw_flops, hw_bytes, peak_flops, peak_bandwidth, name_width);
 
     // start by determining the name width
     map<string, ProfileDataElem>::const_iterator i;
@@ -115,7 +145,7 @@ void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_l
     // output each of the children
     for (i = m_children.begin(); i != m_children.end(); ++i)
         {
-        (*i).second.output(o, (*i).first, tab_level+1, total_time, child_max_width);
+        (*i).second.output(o, (*i).first, tab_level+1, total_time, child_max_width, peak_flops, peak_bandwidth);
         }
 
     // output an "Self" item to account for time actually spent in this data elem
@@ -125,12 +155,24 @@ void ProfileDataElem::output(std::ostream &o, const std::string& name, int tab_l
         double perc = double(m_elapsed_time - getChildElapsedTime())/double(total_time) * 100.0;
         double flops = double(m_flop_count)/sec;
         double bytes = double(m_mem_byte_count)/sec;
+        double hw_flops = double(m_hw_flop_count - getChildHWFlopCount())/sec;
+        double hw_bytes = double(m_hw_byte_count - getChildHWByteCount())/sec;
 
         // don't print Self unless perc is significant
         if (perc >= 0.1)
             {
             o << tabs << "        ";
-            output_line(o, "Self", sec, perc, flops, bytes, child_max_width);
+            output_line(o,
+                        "Self",
+                        sec,
+                        perc,
+                        flops,
+                        bytes,
+                        hw_flops,
+                        hw_bytes,
+                        peak_flops,
+                        peak_bandwidth,
+                        child_max_width);
             }
         }
     }
@@ -141,6 +183,10 @@ void ProfileDataElem::output_line(std::ostream &o,
                                   double perc,
                                   double flops,
                                   double bytes,
+                                  double hw_flops,
+                                  double hw_bytes,
+                                  double peak_flops,
+                                  double peak_bandwidth,
                                   unsigned int name_width) const
     {
     o << setiosflags(ios::fixed);
@@ -160,6 +206,30 @@ void ProfileDataElem::output_line(std::ostream &o,
         return;
         }
 
+    output_rates(o, flops, bytes, peak_flops, peak_bandwidth);
+
+    // output the rates measured by the hardware counters
+    if (hw_flops > 0 || hw_bytes > 0)
+        {
+        o << "| hw: ";
+        output_rates(o, hw_flops, hw_bytes, peak_flops, peak_bandwidth);
+        }
+
+    o << endl;
+    }
+
+/*! \param o stream to write output to
+    \param flops FLOP rate, not written if 0
+    \param bytes Memory bandwidth, not written if 0
+    \param peak_flops Peak FLOP rate of the hardware (0 if unknown)
+    \param peak_bandwidth Peak memory bandwidth of the hardware (0 if unknown)
+*/
+void ProfileDataElem::output_rates(std::ostream &o,
+                                   double flops,
+                                   double bytes,
+                                   double peak_flops,
+                                   double peak_bandwidth) const
+    {
     o << setprecision(5);
     // output flops with intelligent units
     if (flops > 0)
@@ -171,6 +241,9 @@ void ProfileDataElem::output_line(std::ostream &o,
             o << flops/1e6 << " MFLOP/s ";
         else
             o << flops/1e9 << " GFLOP/s ";
+
+        if (peak_flops > 0)
+            o << "(" << setprecision(1) << flops/peak_flops*100.0 << "% peak) " << setprecision(5);
         }
 
     //output bytes/s with intelligent units
@@ -183,16 +256,29 @@ void ProfileDataElem::output_line(std::ostream &o,
             o << bytes/1e6 << " MiB/s ";
         else
             o << bytes/1e9 << " GiB/s ";
-        }
 
-    o << endl;
+        if (peak_bandwidth > 0)
+            o << "(" << setprecision(1) << bytes/peak_bandwidth*100.0 << "% peak) " << setprecision(5);
+        }
     }
 
 ////////////////////////////////////////////////////////////////////
 // Profiler
 
-Profiler::Profiler(const std::string& name) : m_name(name)
+Profiler::Profiler(const std::string& name)
+    : m_name(name), m_trace(false), m_timestep(0), m_counters(false), m_peak_flops(0.0), m_peak_bandwidth(0.0)
     {
+    #ifdef ENABLE_PAPI
+    m_papi_eventset = PAPI_NULL;
+    m_papi_flop_idx = -1;
+    m_papi_miss_idx = -1;
+    #endif
+
+    #ifdef ENABLE_CUDA
+    m_trace_gpu = false;
+    m_cuda_ref_time = 0;
+    #endif
+
     // push the root onto the top of the stack so that it is the default
     m_stack.push(&m_root);
 
@@ -219,8 +305,17 @@ void Profiler::output(std::ostream &o)
     // outputting a profile implicitly calls for a time sample
     m_root.m_elapsed_time = m_clk.getTime() - m_root.m_start_time;
 
+    // and a sample of the hardware counters since enableCounters()
+    if (m_counters)
+        {
+        int64_t hw_flops, hw_misses;
+        readCounters(hw_flops, hw_misses);
+        m_root.m_hw_flop_count = hw_flops - m_root.m_hw_flop_start;
+        m_root.m_hw_byte_count = (hw_misses - m_root.m_hw_miss_start)*int64_t(PROFILER_CACHE_LINE_SIZE);
+        }
+
     // startup the recursive output process
-    m_root.output(o, m_name, 0, m_root.m_elapsed_time, (int)m_name.size());
+    m_root.output(o, m_name, 0, m_root.m_elapsed_time, (int)m_name.size(), m_peak_flops, m_peak_bandwidth);
     }
 
 /*! \param o Stream to output to
@@ -245,6 +340,187 @@ string print_profiler(Profiler *prof)
     return s.str();
     }
 
+Profiler::~Profiler()
+    {
+    #ifdef ENABLE_CUDA
+    for (unsigned int i = 0; i < m_cuda_events.size(); i++)
+        cudaEventDestroy(m_cuda_events[i]);
+    if (m_trace_gpu)
+        cudaEventDestroy(m_cuda_ref_event);
+    #endif
+
+    #ifdef ENABLE_PAPI
+    if (m_papi_eventset != PAPI_NULL)
+        {
+        long long values[2];
+        PAPI_stop(m_papi_eventset, values);
+        PAPI_cleanup_eventset(m_papi_eventset);
+        PAPI_destroy_eventset(&m_papi_eventset);
+        }
+    #endif
+    }
+
+/*! \param exec_conf Execution configuration, used to report errors
+
+    Starts the PAPI counters of the floating point operations (PAPI_DP_OPS, or PAPI_SP_OPS in single precision builds,
+    falling back to PAPI_FP_OPS) and of the last level cache misses (PAPI_L3_TCM, falling back to PAPI_L2_TCM) of the
+    calling thread. Events that the hardware does not provide are left out. Work done by TBB worker threads and by the
+    GPU is not included in the counts.
+*/
+void Profiler::enableCounters(std::shared_ptr<const ExecutionConfiguration> exec_conf)
+    {
+    if (m_counters)
+        return;
+
+    #ifdef ENABLE_PAPI
+    if (!PAPI_is_initialized())
+        {
+        int retval = PAPI_library_init(PAPI_VER_CURRENT);
+        if (retval != PAPI_VER_CURRENT)
+            {
+            exec_conf->msg->warning() << "Could not initialize PAPI, hardware counters are disabled" << endl;
+            return;
+            }
+        }
+
+    if (PAPI_create_eventset(&m_papi_eventset) != PAPI_OK)
+        {
+        exec_conf->msg->warning() << "Could not create a PAPI event set, hardware counters are disabled" << endl;
+        m_papi_eventset = PAPI_NULL;
+        return;
+        }
+
+    int n_events = 0;
+    #ifdef SINGLE_PRECISION
+    int flop_events[] = {PAPI_SP_OPS, PAPI_FP_OPS};
+    #else
+    int flop_events[] = {PAPI_DP_OPS, PAPI_FP_OPS};
+    #endif
+    for (unsigned int i = 0; i < 2 && m_papi_flop_idx < 0; i++)
+        {
+        if (PAPI_add_event(m_papi_eventset, flop_events[i]) == PAPI_OK)
+            m_papi_flop_idx = n_events++;
+        }
+
+    int miss_events[] = {PAPI_L3_TCM, PAPI_L2_TCM};
+    for (unsigned int i = 0; i < 2 && m_papi_miss_idx < 0; i++)
+        {
+        if (PAPI_add_event(m_papi_eventset, miss_events[i]) == PAPI_OK)
+            m_papi_miss_idx = n_events++;
+        }
+
+    if (n_events == 0 || PAPI_start(m_papi_eventset) != PAPI_OK)
+        {
+        exec_conf->msg->warning() << "The PAPI floating point and cache miss counters are not available, "
+                                  << "hardware counters are disabled" << endl;
+        PAPI_cleanup_eventset(m_papi_eventset);
+        PAPI_destroy_eventset(&m_papi_eventset);
+        m_papi_eventset = PAPI_NULL;
+        m_papi_flop_idx = -1;
+        m_papi_miss_idx = -1;
+        return;
+        }
+
+    if (m_papi_flop_idx < 0)
+        exec_conf->msg->notice(2) << "PAPI: no floating point operation counter, measuring bandwidth only" << endl;
+    if (m_papi_miss_idx < 0)
+        exec_conf->msg->notice(2) << "PAPI: no cache miss counter, measuring FLOP rate only" << endl;
+
+    m_counters = true;
+    readCounters(m_root.m_hw_flop_start, m_root.m_hw_miss_start);
+    #else
+    exec_conf->msg->warning() << "HOOMD was compiled without PAPI support (ENABLE_PAPI), "
+                              << "hardware counters are disabled" << endl;
+    #endif
+    }
+
+/*! \param exec_conf Execution configuration, used to determine if GPU regions are timed with CUDA events
+
+    Trace events are recorded for all regions pushed after this call.
+*/
+void Profiler::enableTrace(std::shared_ptr<const ExecutionConfiguration> exec_conf)
+    {
+    m_trace = true;
+
+    #ifdef ENABLE_CUDA
+    if (exec_conf->isCUDAEnabled() && !m_trace_gpu)
+        {
+        // all CUDA events are timed relative to this one
+        cudaDeviceSynchronize();
+        cudaEventCreate(&m_cuda_ref_event);
+        cudaEventRecord(m_cuda_ref_event, 0);
+        cudaEventSynchronize(m_cuda_ref_event);
+        m_cuda_ref_time = m_clk.getTime();
+        m_trace_gpu = true;
+        }
+    #endif
+    }
+
+//! Escape a string for output in JSON
+static std::string json_escape(const std::string& s)
+    {
+    std::string out;
+    for (unsigned int i = 0; i < s.size(); i++)
+        {
+        if (s[i] == '"' || s[i] == '\\')
+            out += '\\';
+        out += s[i];
+        }
+    return out;
+    }
+
+/*! \param fname File name to write
+    \param rank Process id to write for the events (the MPI rank)
+
+    Writes all completed trace events in the Chrome trace event format. Times are given in microseconds since the
+    construction of the profiler.
+*/
+void Profiler::writeTrace(const std::string& fname, unsigned int rank)
+    {
+    #ifdef ENABLE_CUDA
+    // wait for all recorded events
+    if (m_trace_gpu)
+        cudaDeviceSynchronize();
+    #endif
+
+    std::ofstream f(fname.c_str());
+    if (!f.good())
+        throw runtime_error("Error writing trace file " + fname);
+
+    f << "{\"traceEvents\":[" << endl;
+    f << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << rank
+      << ",\"args\":{\"name\":\"rank " << rank << "\"}}";
+
+    f << setprecision(3) << fixed;
+    for (unsigned int i = 0; i < m_trace_events.size(); i++)
+        {
+        const ProfileTraceEvent& event = m_trace_events[i];
+        std::string name = json_escape(event.m_name);
+
+        f << "," << endl;
+        f << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":0"
+          << ",\"ts\":" << double(event.m_begin)/1e3 << ",\"dur\":" << double(event.m_end - event.m_begin)/1e3
+          << ",\"args\":{\"step\":" << event.m_timestep << ",\"depth\":" << event.m_depth << "}}";
+
+        #ifdef ENABLE_CUDA
+        if (event.m_gpu_begin >= 0 && event.m_gpu_end >= 0)
+            {
+            float t_begin = 0.0f, t_end = 0.0f;
+            cudaEventElapsedTime(&t_begin, m_cuda_ref_event, m_cuda_events[event.m_gpu_begin]);
+            cudaEventElapsedTime(&t_end, m_cuda_ref_event, m_cuda_events[event.m_gpu_end]);
+            double ts = double(m_cuda_ref_time)/1e3 + double(t_begin)*1e3;
+            double dur = double(t_end - t_begin)*1e3;
+
+            f << "," << endl;
+            f << "{\"name\":\"" << name << "\",\"ph\":\"X\",\"pid\":" << rank << ",\"tid\":1"
+              << ",\"ts\":" << ts << ",\"dur\":" << dur
+              << ",\"args\":{\"step\":" << event.m_timestep << ",\"depth\":" << event.m_depth << "}}";
+            }
+        #endif
+        }
+    f << endl << "]}" << endl;
+    }
+
 void export_Profiler(py::module& m)
     {
     py::class_<Profiler>(m,"Profiler")
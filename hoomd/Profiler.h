@@ -23,9 +23,14 @@
 #include <nvToolsExt.h>
 #endif
 
+#ifdef ENABLE_PAPI
+#include <papi.h>
+#endif
+
 #include <string>
 #include <stack>
 #include <map>
+#include <vector>
 #include <iostream>
 #include <cassert>
 
@@ -54,6 +59,9 @@ class Profiler;
 /*! @}
 */
 
+//! Number of bytes transferred from memory per last level cache miss
+const unsigned int PROFILER_CACHE_LINE_SIZE = 64;
+
 //! Internal class for storing profile data
 /*! This is a simple utility class, so it is fully public. It is really only designed to be used in
     concert with the Profiler class.
@@ -63,7 +71,8 @@ class PYBIND11_EXPORT ProfileDataElem
     {
     public:
         //! Constructs an element with zeroed counters
-        ProfileDataElem() : m_start_time(0), m_elapsed_time(0), m_flop_count(0), m_mem_byte_count(0)
+        ProfileDataElem() : m_start_time(0), m_elapsed_time(0), m_flop_count(0), m_mem_byte_count(0),
+            m_hw_flop_start(0), m_hw_miss_start(0), m_hw_flop_count(0), m_hw_byte_count(0)
             #ifdef SCOREP_USER_ENABLE
             , m_scorep_region(SCOREP_USER_INVALID_REGION)
             #endif
@@ -75,9 +84,19 @@ class PYBIND11_EXPORT ProfileDataElem
         int64_t getTotalFlopCount() const;
         //! Returns the total memory byte count of this node + children
         int64_t getTotalMemByteCount() const;
+        //! Returns the hardware flop count of this nodes children
+        int64_t getChildHWFlopCount() const;
+        //! Returns the hardware memory byte count of this nodes children
+        int64_t getChildHWByteCount() const;
 
         //! Output helper function
-        void output(std::ostream &o, const std::string &name, int tab_level, int64_t total_time, int name_width) const;
+        void output(std::ostream &o,
+                    const std::string &name,
+                    int tab_level,
+                    int64_t total_time,
+                    int name_width,
+                    double peak_flops,
+                    double peak_bandwidth) const;
         //! Another output helper function
         void output_line(std::ostream &o,
                          const std::string &name,
@@ -85,7 +104,13 @@ class PYBIND11_EXPORT ProfileDataElem
                          double perc,
                          double flops,
                          double bytes,
+                         double hw_flops,
+                         double hw_bytes,
+                         double peak_flops,
+                         double peak_bandwidth,
                          unsigned int name_width) const;
+        //! Output the FLOP rate and bandwidth of a line
+        void output_rates(std::ostream &o, double flops, double bytes, double peak_flops, double peak_bandwidth) const;
 
         std::map<std::string, ProfileDataElem> m_children; //!< Child nodes of this profile
 
@@ -93,6 +118,10 @@ class PYBIND11_EXPORT ProfileDataElem
         int64_t m_elapsed_time; //!< A running total of elapsed running time
         int64_t m_flop_count;   //!< A running total of floating point operations
         int64_t m_mem_byte_count;   //!< A running total of memory bytes transferred
+        int64_t m_hw_flop_start;    //!< Hardware flop counter at the most recent push
+        int64_t m_hw_miss_start;    //!< Hardware cache miss counter at the most recent push
+        int64_t m_hw_flop_count;    //!< A running total of floating point operations measured by the hardware
+        int64_t m_hw_byte_count;    //!< A running total of memory bytes transferred measured by the hardware
 
         #ifdef SCOREP_USER_ENABLE
         SCOREP_User_RegionHandle m_scorep_region;   //!< ScoreP region identifier
@@ -101,6 +130,20 @@ class PYBIND11_EXPORT ProfileDataElem
 
 
 
+//! A single timed region recorded in trace mode
+/*! \ingroup utils
+*/
+struct PYBIND11_EXPORT ProfileTraceEvent
+    {
+    std::string m_name;     //!< Name of the region
+    int64_t m_begin;        //!< CPU time at push() (ns)
+    int64_t m_end;          //!< CPU time at pop() (ns)
+    unsigned int m_depth;   //!< Nesting depth of the region
+    uint64_t m_timestep;    //!< Time step during which the region was recorded
+    int m_gpu_begin;        //!< Index of the CUDA event recorded at push(), or -1
+    int m_gpu_end;          //!< Index of the CUDA event recorded at pop(), or -1
+    };
+
 //! A class for doing coarse-level profiling of code
 /*! Stores and organizes a tree of profiles that can be created with a simple push/pop
     type interface. Any number of root profiles can be created via the default constructor
@@ -118,6 +161,18 @@ class PYBIND11_EXPORT ProfileDataElem
     to provide accurate timing information.
 
     These profiles can of course be output via normal ostream operators.
+
+    In trace mode (enableTrace()), every push()/pop() pair is additionally recorded as a ProfileTraceEvent with its
+    begin and end time and the current time step. The GPU versions of push() and pop() then record CUDA events in the
+    execution stream instead of synchronizing the device, so that tracing does not distort the timings. writeTrace()
+    writes the events of this rank as a Chrome trace (JSON) that can be opened in chrome://tracing or Perfetto. CPU
+    regions are shown in thread 0 and GPU regions in thread 1 of process \a rank.
+
+    With hardware counters (enableCounters()), every push() and pop() reads the PAPI counters of floating point
+    operations and last level cache misses of the calling thread. The output then lists the measured FLOP rate and
+    memory bandwidth (one cache line per miss) of each region next to the hand counted values of pop(). When the peak
+    FLOP rate and bandwidth of the hardware are set with setPeak(), both are also given as a fraction of the peak,
+    which shows whether a region is limited by the memory bandwidth, by the arithmetic or by neither (latency).
     \ingroup utils
     */
 class PYBIND11_EXPORT Profiler
@@ -135,12 +190,87 @@ class PYBIND11_EXPORT Profiler
         //! Pops back up to the next super-category & syncs the GPUs
         void pop(std::shared_ptr<const ExecutionConfiguration> exec_conf, uint64_t flop_count = 0, uint64_t byte_count = 0);
 
+        //! Destructor
+        ~Profiler();
+
+        //! Record a timeline of all regions
+        void enableTrace(std::shared_ptr<const ExecutionConfiguration> exec_conf);
+
+        //! Set the time step that is attached to trace events
+        void setTimestep(uint64_t timestep)
+            {
+            m_timestep = timestep;
+            }
+
+        //! Write the recorded trace events to a Chrome trace file
+        void writeTrace(const std::string& fname, unsigned int rank);
+
+        //! Read hardware performance counters in every region
+        void enableCounters(std::shared_ptr<const ExecutionConfiguration> exec_conf);
+
+        //! Set the peak performance of the hardware
+        /*! \param flops Peak FLOP rate (FLOP/s), 0 if unknown
+            \param bandwidth Peak memory bandwidth (B/s), 0 if unknown
+        */
+        void setPeak(double flops, double bandwidth)
+            {
+            m_peak_flops = flops;
+            m_peak_bandwidth = bandwidth;
+            }
+
     private:
         ClockSource m_clk;  //!< Clock to provide timing information
         std::string m_name; //!< The name of this profile
         ProfileDataElem m_root; //!< The root profile element
         std::stack<ProfileDataElem *> m_stack;  //!< A stack of data elements for the push/pop structure
 
+        bool m_trace;                                     //!< True if trace events are recorded
+        uint64_t m_timestep;                              //!< Current time step
+        std::vector<ProfileTraceEvent> m_trace_events;    //!< Recorded trace events
+        std::stack<unsigned int> m_open_events;           //!< Indices of the trace events that are not popped yet
+
+        bool m_counters;                                  //!< True if hardware counters are read
+        double m_peak_flops;                              //!< Peak FLOP rate of the hardware (FLOP/s)
+        double m_peak_bandwidth;                          //!< Peak memory bandwidth of the hardware (B/s)
+
+        #ifdef ENABLE_PAPI
+        int m_papi_eventset;                              //!< PAPI event set of the counters
+        int m_papi_flop_idx;                              //!< Index of the flop counter in the event set, or -1
+        int m_papi_miss_idx;                              //!< Index of the cache miss counter in the event set, or -1
+        #endif
+
+        //! Read the current values of the hardware counters
+        void readCounters(int64_t& flops, int64_t& misses)
+            {
+            flops = 0;
+            misses = 0;
+            #ifdef ENABLE_PAPI
+            long long values[2] = {0, 0};
+            PAPI_read(m_papi_eventset, values);
+            if (m_papi_flop_idx >= 0)
+                flops = values[m_papi_flop_idx];
+            if (m_papi_miss_idx >= 0)
+                misses = values[m_papi_miss_idx];
+            #endif
+            }
+
+        #ifdef ENABLE_CUDA
+        bool m_trace_gpu;                                 //!< True if CUDA events are recorded
+        std::vector<cudaEvent_t> m_cuda_events;           //!< CUDA events recorded in trace mode
+        cudaEvent_t m_cuda_ref_event;                     //!< CUDA event recorded when tracing was enabled
+        int64_t m_cuda_ref_time;                          //!< CPU time of m_cuda_ref_event
+
+        //! Record a CUDA event in the default stream and return its index
+        int recordCUDAEvent()
+            {
+            cudaEvent_t ev;
+            cudaEventCreate(&ev);
+            cudaEventRecord(ev, 0);
+            m_cuda_events.push_back(ev);
+            return int(m_cuda_events.size()) - 1;
+            }
+        #endif
+
         //! Output helper function
         void output(std::ostream &o);
 
@@ -162,6 +292,16 @@ PYBIND11_EXPORT std::ostream& operator<<(std::ostream &o, Profiler& prof);
 
 inline void Profiler::push(std::shared_ptr<const ExecutionConfiguration> exec_conf, const std::string& name)
     {
+#ifdef ENABLE_CUDA
+    // in trace mode, time the GPU work with events instead of synchronizing
+    if (m_trace_gpu && exec_conf->isCUDAEnabled())
+        {
+        int ev = recordCUDAEvent();
+        push(name);
+        m_trace_events[m_open_events.top()].m_gpu_begin = ev;
+        return;
+        }
+#endif
 #if defined(ENABLE_CUDA) && !defined(ENABLE_NVTOOLS)
     // nvtools profiling disables synchronization so that async CPU/GPU overlap can be seen
     if(exec_conf->isCUDAEnabled())
@@ -175,6 +315,14 @@ inline void Profiler::push(std::shared_ptr<const ExecutionConfiguration> exec_co
 
 inline void Profiler::pop(std::shared_ptr<const ExecutionConfiguration> exec_conf, uint64_t flop_count, uint64_t byte_count)
     {
+#ifdef ENABLE_CUDA
+    if (m_trace_gpu && exec_conf->isCUDAEnabled())
+        {
+        m_trace_events[m_open_events.top()].m_gpu_end = recordCUDAEvent();
+        pop(flop_count, byte_count);
+        return;
+        }
+#endif
 #if defined(ENABLE_CUDA) && !defined(ENABLE_NVTOOLS)
     // nvtools profiling disables synchronization so that async CPU/GPU overlap can be seen
     if(exec_conf->isCUDAEnabled())
@@ -206,10 +354,32 @@ inline void Profiler::push(const std::string& name)
     // and updating the stack
     m_stack.push(&cur->m_children[name]);
 
+    // record a trace event
+    if (m_trace)
+        {
+        ProfileTraceEvent event;
+        event.m_name = name;
+        event.m_begin = t;
+        event.m_end = t;
+        event.m_depth = m_open_events.size();
+        event.m_timestep = m_timestep;
+        event.m_gpu_begin = -1;
+        event.m_gpu_end = -1;
+        m_open_events.push(m_trace_events.size());
+        m_trace_events.push_back(event);
+        }
+
     #ifdef SCOREP_USER_ENABLE
     // log Score-P region
     SCOREP_USER_REGION_BEGIN( cur->m_children[name].m_scorep_region, name.c_str(),SCOREP_USER_REGION_TYPE_COMMON )
     #endif
+
+    // read the hardware counters last to exclude the profiler bookkeeping
+    if (m_counters)
+        {
+        ProfileDataElem *elem = m_stack.top();
+        readCounters(elem->m_hw_flop_start, elem->m_hw_miss_start);
+        }
     }
 
 inline void Profiler::pop(uint64_t flop_count, uint64_t byte_count)
@@ -218,6 +388,16 @@ inline void Profiler::pop(uint64_t flop_count, uint64_t byte_count)
     assert(!m_stack.empty());
     assert(!(m_stack.top() == &m_root));
 
+    // read the hardware counters first to exclude the profiler bookkeeping
+    if (m_counters)
+        {
+        ProfileDataElem *elem = m_stack.top();
+        int64_t hw_flops, hw_misses;
+        readCounters(hw_flops, hw_misses);
+        elem->m_hw_flop_count += hw_flops - elem->m_hw_flop_start;
+        elem->m_hw_byte_count += (hw_misses - elem->m_hw_miss_start)*int64_t(PROFILER_CACHE_LINE_SIZE);
+        }
+
     #ifdef ENABLE_NVTOOLS
     nvtxRangePop();
     #endif
@@ -238,6 +418,13 @@ inline void Profiler::pop(uint64_t flop_count, uint64_t byte_count)
 
     // and finally popping the stack so that the next pop will access the correct element
     m_stack.pop();
+
+    // complete the trace event
+    if (m_trace && !m_open_events.empty())
+        {
+        m_trace_events[m_open_events.top()].m_end = t;
+        m_open_events.pop();
+        }
     }
 
 #endif
@@ -0,0 +1,328 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+/*! \file RandomSequentialAddition.cc
+    \brief Defines the RandomSequentialAddition class
+*/
+
+#include "RandomSequentialAddition.h"
+
+#ifdef ENABLE_MPI
+#include "HOOMDMPI.h"
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include <string.h>
+
+namespace py = pybind11;
+
+using namespace std;
+
+/*! \param exec_conf Execution configuration
+    \param box Global simulation box
+    \param dimensions Number of dimensions
+    \param diameter Minimum distance between two particles
+    \param seed Seed of the random number generator
+*/
+RandomSequentialAddition::RandomSequentialAddition(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                                   const BoxDim& box,
+                                                   unsigned int dimensions,
+                                                   Scalar diameter,
+                                                   unsigned int seed)
+    : m_exec_conf(exec_conf),
+      m_box(box),
+      m_dimensions(dimensions),
+      m_diameter(diameter),
+      m_seed(seed),
+      m_n_placed(0),
+      m_distributed(false),
+      m_tag_offset(0)
+    {
+    if (m_dimensions != 2 && m_dimensions != 3)
+        {
+        m_exec_conf->msg->error() << "init.create_random: dimensions must be 2 or 3" << endl;
+        throw runtime_error("Error initializing RandomSequentialAddition");
+        }
+
+    if (m_diameter <= Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "init.create_random: diameter must be positive" << endl;
+        throw runtime_error("Error initializing RandomSequentialAddition");
+        }
+    }
+
+/*! \param N Number of particles to place
+    \param max_sweeps Maximum number of sweeps over all cells
+
+    Only rank 0 places particles, the snapshot is distributed to the other ranks when the system is initialized.
+*/
+void RandomSequentialAddition::generate(unsigned int N, unsigned int max_sweeps)
+    {
+    m_distributed = false;
+    m_tag_offset = 0;
+
+    // only execute on rank 0
+    if (m_exec_conf->getRank()) return;
+
+    if (! fill(m_box, N, max_sweeps))
+        {
+        m_exec_conf->msg->error() << "init.create_random: Placed only " << m_n_placed << " of " << N
+                                  << " particles in " << max_sweeps << " sweeps" << endl;
+        throw runtime_error("Error generating particles");
+        }
+    }
+
+#ifdef ENABLE_MPI
+/*! \param N Number of particles to place in the global box
+    \param max_sweeps Maximum number of sweeps over all cells
+    \param decomposition Domain decomposition of the global box
+
+    Every rank places a share of \a N proportional to the volume of its domain. The tags of the particles of a rank
+    continue after the tags of the lower ranks.
+*/
+void RandomSequentialAddition::generateDistributed(unsigned int N,
+                                                   unsigned int max_sweeps,
+                                                   std::shared_ptr<DomainDecomposition> decomposition)
+    {
+    // volume of the domains before and including the local domain, as fractions of the box volume
+    const Index3D& di = decomposition->getDomainIndexer();
+    std::vector<Scalar> cum_frac_x = decomposition->getCumulativeFractions(0);
+    std::vector<Scalar> cum_frac_y = decomposition->getCumulativeFractions(1);
+    std::vector<Scalar> cum_frac_z = decomposition->getCumulativeFractions(2);
+    uint3 grid_pos = decomposition->getGridPos();
+    unsigned int my_domain = di(grid_pos.x, grid_pos.y, grid_pos.z);
+
+    double vol_lo = 0.0;
+    double vol_hi = 0.0;
+    for (unsigned int d = 0; d <= my_domain; d++)
+        {
+        uint3 t = di.getTriple(d);
+        vol_lo = vol_hi;
+        vol_hi += double(cum_frac_x[t.x+1] - cum_frac_x[t.x])
+            * double(cum_frac_y[t.y+1] - cum_frac_y[t.y])
+            * double(cum_frac_z[t.z+1] - cum_frac_z[t.z]);
+        }
+    if (my_domain == di.getNumElements() - 1)
+        vol_hi = 1.0;
+
+    // every rank rounds the same cumulative volumes, so the counts add up to N
+    unsigned int first = (unsigned int)(vol_lo * double(N) + 0.5);
+    unsigned int last = (unsigned int)(vol_hi * double(N) + 0.5);
+    unsigned int n_local = last - first;
+
+    // fill the local box, which is not periodic along directions with more than one domain
+    bool success = fill(decomposition->calculateLocalBox(m_box), n_local, max_sweeps);
+
+    // fail on all ranks together
+    MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    unsigned int n_failed = success ? 0 : 1;
+    MPI_Allreduce(MPI_IN_PLACE, &n_failed, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+    if (n_failed)
+        {
+        if (! success)
+            {
+            m_exec_conf->msg->error() << "init.create_random: Placed only " << m_n_placed << " of " << n_local
+                                      << " particles in the local domain in " << max_sweeps << " sweeps" << endl;
+            }
+        throw runtime_error("Error generating particles");
+        }
+
+    // tags continue after the particles of the lower ranks
+    m_tag_offset = 0;
+    MPI_Exscan(&m_n_placed, &m_tag_offset, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+    if (m_exec_conf->getRank() == 0)
+        m_tag_offset = 0;
+
+    m_distributed = true;
+    }
+#endif
+
+/*! \param type_name Name of the particle type of all particles
+    \returns A snapshot of the placed particles, distributed when every rank filled its own domain
+*/
+std::shared_ptr< SnapshotSystemData<Scalar> > RandomSequentialAddition::getSnapshot(const std::string& type_name) const
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snapshot(new SnapshotSystemData<Scalar>());
+
+    // only execute on rank 0, unless every rank generated its own domain
+    if (m_exec_conf->getRank() && !m_distributed) return snapshot;
+
+    snapshot->global_box = m_box;
+    snapshot->dimensions = m_dimensions;
+
+    SnapshotParticleData<Scalar>& pdata_snap = snapshot->particle_data;
+    pdata_snap.resize(m_n_placed);
+
+    if (m_n_placed)
+        {
+        ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < m_n_placed; i++)
+            {
+            const Scalar4 postype = h_pos.data[i];
+            pdata_snap.pos[i] = vec3<Scalar>(postype.x, postype.y, postype.z);
+            pdata_snap.diameter[i] = m_diameter;
+            }
+        }
+
+    pdata_snap.type_mapping.push_back(type_name);
+    pdata_snap.is_distributed = m_distributed;
+    pdata_snap.tag_offset = m_tag_offset;
+
+    return snapshot;
+    }
+
+/*! \param box Box to fill
+
+    The cells are no wider than diameter/sqrt(dimensions), so no configuration is lost by storing at most one
+    particle per cell. Along periodic directions, the number of cells is a multiple of the stride, so that active
+    cells of the same phase are also far enough apart across the boundary.
+*/
+void RandomSequentialAddition::setupGrid(const BoxDim& box)
+    {
+    const Scalar3 L = box.getNearestPlaneDistance();
+    const uchar3 periodic = box.getPeriodic();
+    const Scalar w_max = m_diameter / sqrt(Scalar(m_dimensions));
+
+    const Scalar L_dir[3] = {L.x, L.y, L.z};
+    const bool periodic_dir[3] = {bool(periodic.x), bool(periodic.y), bool(periodic.z)};
+    unsigned int n[3], stride[3];
+    int reach[3];
+    Scalar margin[3];
+
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        if (d >= m_dimensions)
+            {
+            n[d] = 1;
+            stride[d] = 1;
+            reach[d] = 0;
+            margin[d] = Scalar(0.0);
+            continue;
+            }
+
+        n[d] = std::max(1u, (unsigned int)ceil(L_dir[d] / w_max));
+        while (true)
+            {
+            reach[d] = int(ceil(m_diameter * Scalar(n[d]) / L_dir[d]));
+            stride[d] = reach[d] + 1;
+            if (stride[d] >= n[d])
+                {
+                stride[d] = n[d];
+                break;
+                }
+            if (! periodic_dir[d] || n[d] % stride[d] == 0)
+                break;
+
+            // more and narrower cells, the stride only grows slowly with the number of cells
+            n[d]++;
+            }
+
+        margin[d] = periodic_dir[d] ? Scalar(0.0) : Scalar(0.5) * m_diameter / L_dir[d];
+        }
+
+    m_grid.box = box;
+    m_grid.n = make_uint3(n[0], n[1], n[2]);
+    m_grid.stride = make_uint3(stride[0], stride[1], stride[2]);
+    m_grid.reach = make_int3(reach[0], reach[1], reach[2]);
+    m_grid.margin = make_scalar3(margin[0], margin[1], margin[2]);
+    m_grid.diameter = m_diameter;
+    m_grid.ndim = m_dimensions;
+    }
+
+/*! \param box Box to fill
+    \param N Number of particles to place
+    \param max_sweeps Maximum number of sweeps over all cells
+    \returns true if all \a N particles have been placed
+
+    Empty cells draw candidates with a probability that spreads the remaining particles over all empty cells during one
+    sweep, corrected by the acceptance of the previous sweep. This keeps dilute systems uniform, otherwise the first
+    phases would receive all particles.
+*/
+bool RandomSequentialAddition::fill(const BoxDim& box, unsigned int N, unsigned int max_sweeps)
+    {
+    setupGrid(box);
+
+    Index3D ci(m_grid.n.x, m_grid.n.y, m_grid.n.z);
+    const unsigned int n_cells = ci.getNumElements();
+
+    m_exec_conf->msg->notice(5) << "RandomSequentialAddition: " << m_grid.n.x << "x" << m_grid.n.y << "x" << m_grid.n.z
+                                << " cells, " << m_grid.stride.x*m_grid.stride.y*m_grid.stride.z << " phases" << endl;
+
+    m_n_placed = 0;
+    if (N > n_cells)
+        return false;
+
+    GPUArray<Scalar4> cell_pos(n_cells, m_exec_conf);
+    m_cell_pos.swap(cell_pos);
+        {
+        ArrayHandle<Scalar4> h_cell_pos(m_cell_pos, access_location::host, access_mode::overwrite);
+        memset(h_cell_pos.data, 0, sizeof(Scalar4)*n_cells);
+        }
+
+    GPUArray<Scalar4> pos(N, m_exec_conf);
+    m_pos.swap(pos);
+
+    Index3D phase_idx(m_grid.stride.x, m_grid.stride.y, m_grid.stride.z);
+    const unsigned int n_phases = phase_idx.getNumElements();
+
+    // fraction of the drawn candidates that were accepted in the last sweep
+    Scalar acceptance = Scalar(1.0);
+
+    for (unsigned int sweep = 0; sweep < max_sweeps && m_n_placed < N; sweep++)
+        {
+        const unsigned int n_empty = n_cells - m_n_placed;
+        const unsigned int n_placed_before = m_n_placed;
+        Scalar p_propose = std::min(Scalar(1.0), Scalar(N - m_n_placed) / (Scalar(n_empty) * acceptance));
+
+        for (unsigned int phase = 0; phase < n_phases && m_n_placed < N; phase++)
+            {
+            placePhase(phase_idx.getTriple(phase), sweep*n_phases + phase, p_propose, N);
+            }
+
+        acceptance = std::max(Scalar(1e-3), Scalar(m_n_placed - n_placed_before) / (p_propose * Scalar(n_empty)));
+        acceptance = std::min(Scalar(1.0), acceptance);
+        }
+
+    return m_n_placed == N;
+    }
+
+/*! Cells of the same phase do not interact, so filling them one after the other gives the same result as filling all
+    of them at once.
+*/
+void RandomSequentialAddition::placePhase(const uint3& phase, unsigned int key, Scalar p_propose, unsigned int n_target)
+    {
+    ArrayHandle<Scalar4> h_cell_pos(m_cell_pos, access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::readwrite);
+
+    Index3D ci(m_grid.n.x, m_grid.n.y, m_grid.n.z);
+    const uint3 na = hoomd::detail::rsa_num_active(phase, m_grid);
+    const unsigned int n_active = na.x*na.y*na.z;
+
+    for (unsigned int idx = 0; idx < n_active && m_n_placed < n_target; idx++)
+        {
+        const uint3 cell = hoomd::detail::rsa_active_cell(idx, phase, m_grid);
+
+        Scalar3 cand;
+        if (! hoomd::detail::rsa_draw_candidate(cand, cell, key, m_seed, p_propose, h_cell_pos.data, m_grid))
+            continue;
+
+        h_cell_pos.data[ci(cell.x, cell.y, cell.z)] = make_scalar4(cand.x, cand.y, cand.z, Scalar(1.0));
+        h_pos.data[m_n_placed++] = make_scalar4(cand.x, cand.y, cand.z, __int_as_scalar(0));
+        }
+    }
+
+void export_RandomSequentialAddition(py::module& m)
+    {
+    py::class_<RandomSequentialAddition, std::shared_ptr<RandomSequentialAddition> >(m,"RandomSequentialAddition")
+    .def(py::init< std::shared_ptr<const ExecutionConfiguration>, const BoxDim&, unsigned int, Scalar, unsigned int >())
+    .def("generate", &RandomSequentialAddition::generate)
+    #ifdef ENABLE_MPI
+    .def("generateDistributed", &RandomSequentialAddition::generateDistributed)
+    #endif
+    .def("getSnapshot", &RandomSequentialAddition::getSnapshot)
+    ;
+    }
@@ -0,0 +1,106 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+/*! \file RandomSequentialAddition.h
+    \brief Declares the RandomSequentialAddition class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ExecutionConfiguration.h"
+#include "GPUArray.h"
+#include "RandomSequentialAdditionUtilities.h"
+#include "SnapshotSystemData.h"
+
+#ifdef ENABLE_MPI
+#include "DomainDecomposition.h"
+#endif
+
+#include <memory>
+#include <string>
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#ifndef __RANDOM_SEQUENTIAL_ADDITION_H__
+#define __RANDOM_SEQUENTIAL_ADDITION_H__
+
+//! Places particles of one diameter at random without overlaps
+/*! Particles are placed by random sequential addition on a grid of cells that hold at most one particle each. All
+    cells of one phase are at least the particle diameter apart, so all of them draw and test a candidate at the same
+    time and the candidates accepted in one phase never overlap each other. A sweep visits every phase once. The
+    accepted candidates of a phase are numbered in cell order, so the result only depends on the seed and not on the
+    order in which the cells are processed.
+
+    With a domain decomposition, every rank fills its own domain with its share of the particles. Candidates closer
+    than half a diameter to a face shared with another domain are rejected, so no two ranks ever place overlapping
+    particles. The generated snapshot is distributed and is read by every rank without communication.
+
+    Random sequential addition jams at a packing fraction of about 0.38 in 3D and 0.55 in 2D. Denser systems must be
+    compressed after the initialization.
+
+    \ingroup data_structs
+*/
+class PYBIND11_EXPORT RandomSequentialAddition
+    {
+    public:
+        //! Constructor
+        RandomSequentialAddition(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                 const BoxDim& box,
+                                 unsigned int dimensions,
+                                 Scalar diameter,
+                                 unsigned int seed);
+
+        //! Destructor
+        virtual ~RandomSequentialAddition() { }
+
+        //! Place all particles in the global box on rank 0
+        void generate(unsigned int N, unsigned int max_sweeps);
+
+        #ifdef ENABLE_MPI
+        //! Place the particles of every rank in its own domain
+        void generateDistributed(unsigned int N,
+                                 unsigned int max_sweeps,
+                                 std::shared_ptr<DomainDecomposition> decomposition);
+        #endif
+
+        //! Get a snapshot of the placed particles
+        std::shared_ptr< SnapshotSystemData<Scalar> > getSnapshot(const std::string& type_name) const;
+
+    protected:
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< Execution configuration
+        BoxDim m_box;                   //!< Global box
+        unsigned int m_dimensions;      //!< Number of dimensions
+        Scalar m_diameter;              //!< Minimum distance between two particles
+        unsigned int m_seed;            //!< Seed of the random number generator
+
+        hoomd::detail::rsa_grid m_grid; //!< Cell grid of the domain being filled
+        GPUArray<Scalar4> m_cell_pos;   //!< Particle in every cell, w is nonzero when the cell is occupied
+        GPUArray<Scalar4> m_pos;        //!< Positions of the placed particles
+        unsigned int m_n_placed;        //!< Number of particles placed so far
+
+        bool m_distributed;             //!< True when every rank filled its own domain
+        unsigned int m_tag_offset;      //!< Tag of the first particle of this rank
+
+        //! Fill a box with particles
+        bool fill(const BoxDim& box, unsigned int N, unsigned int max_sweeps);
+
+        //! Fill all active cells of one phase
+        /*! \param phase First cell of the phase
+            \param key Key of the random number generator of this phase
+            \param p_propose Probability that an empty cell draws a candidate
+            \param n_target Number of particles to place in total
+        */
+        virtual void placePhase(const uint3& phase, unsigned int key, Scalar p_propose, unsigned int n_target);
+
+    private:
+        //! Set up the cell grid of a box
+        void setupGrid(const BoxDim& box);
+    };
+
+//! Export RandomSequentialAddition to python
+void export_RandomSequentialAddition(pybind11::module& m);
+
+#endif
@@ -0,0 +1,92 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+/*! \file RandomSequentialAdditionGPU.cc
+    \brief Defines the RandomSequentialAdditionGPU class
+*/
+
+#include "RandomSequentialAdditionGPU.h"
+
+namespace py = pybind11;
+
+/*! \param exec_conf Execution configuration
+    \param box Global simulation box
+    \param dimensions Number of dimensions
+    \param diameter Minimum distance between two particles
+    \param seed Seed of the random number generator
+*/
+RandomSequentialAdditionGPU::RandomSequentialAdditionGPU(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                                         const BoxDim& box,
+                                                         unsigned int dimensions,
+                                                         Scalar diameter,
+                                                         unsigned int seed)
+    : RandomSequentialAddition(exec_conf, box, dimensions, diameter, seed),
+      m_n_accepted(exec_conf),
+      m_block_size(256)
+    {
+    }
+
+/*! \param phase First cell of the phase
+    \param key Key of the random number generator of this phase
+    \param p_propose Probability that an empty cell draws a candidate
+    \param n_target Number of particles to place in total
+*/
+void RandomSequentialAdditionGPU::placePhase(const uint3& phase, unsigned int key, Scalar p_propose, unsigned int n_target)
+    {
+    const uint3 na = hoomd::detail::rsa_num_active(phase, m_grid);
+    const unsigned int n_active = na.x*na.y*na.z;
+    if (n_active == 0)
+        return;
+
+    // the first phase has the most active cells
+    if (m_flag.getNumElements() < n_active)
+        {
+        GPUArray<unsigned int> flag(n_active, m_exec_conf);
+        m_flag.swap(flag);
+        GPUArray<unsigned int> slot(n_active, m_exec_conf);
+        m_slot.swap(slot);
+        GPUArray<Scalar4> cand(n_active, m_exec_conf);
+        m_cand.swap(cand);
+        }
+
+    m_n_accepted.resetFlags(0);
+
+        {
+        ArrayHandle<Scalar4> d_cell_pos(m_cell_pos, access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar4> d_pos(m_pos, access_location::device, access_mode::readwrite);
+        ArrayHandle<unsigned int> d_flag(m_flag, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_slot(m_slot, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar4> d_cand(m_cand, access_location::device, access_mode::overwrite);
+
+        gpu_rsa_place_phase(d_cell_pos.data,
+                            d_pos.data,
+                            m_n_accepted.getDeviceFlags(),
+                            d_flag.data,
+                            d_slot.data,
+                            d_cand.data,
+                            phase,
+                            n_active,
+                            key,
+                            m_seed,
+                            p_propose,
+                            m_n_placed,
+                            n_target,
+                            m_grid,
+                            m_block_size,
+                            m_exec_conf->getCachedAllocator());
+
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    m_n_placed += m_n_accepted.readFlags();
+    }
+
+void export_RandomSequentialAdditionGPU(py::module& m)
+    {
+    py::class_<RandomSequentialAdditionGPU, std::shared_ptr<RandomSequentialAdditionGPU> >(m,"RandomSequentialAdditionGPU",py::base<RandomSequentialAddition>())
+    .def(py::init< std::shared_ptr<const ExecutionConfiguration>, const BoxDim&, unsigned int, Scalar, unsigned int >())
+    ;
+    }
@@ -0,0 +1,163 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+/*! \file RandomSequentialAdditionGPU.cu
+    \brief Defines GPU kernel drivers for RandomSequentialAdditionGPU
+*/
+
+#include "RandomSequentialAdditionGPU.cuh"
+
+#include "hoomd/extern/cub/cub/cub.cuh"
+
+//! Draw and test one candidate in every active cell of a phase
+/*! \param d_flag Set to 1 for the active cells with a valid candidate (output)
+    \param d_cand Candidate of every active cell (output)
+    \param d_cell_pos Particle in every cell
+    \param phase First cell of the phase
+    \param n_active Number of active cells
+    \param key Key of the random number generator of this phase
+    \param seed Seed of the random number generator
+    \param p_propose Probability that an empty cell draws a candidate
+    \param grid Cell grid
+
+    One thread per active cell.
+*/
+__global__ void gpu_rsa_draw_kernel(unsigned int *d_flag,
+                                    Scalar4 *d_cand,
+                                    const Scalar4 *d_cell_pos,
+                                    const uint3 phase,
+                                    const unsigned int n_active,
+                                    const unsigned int key,
+                                    const unsigned int seed,
+                                    const Scalar p_propose,
+                                    const hoomd::detail::rsa_grid grid)
+    {
+    const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= n_active)
+        return;
+
+    const uint3 cell = hoomd::detail::rsa_active_cell(idx, phase, grid);
+    Scalar3 cand = make_scalar3(0.0, 0.0, 0.0);
+    const bool valid = hoomd::detail::rsa_draw_candidate(cand, cell, key, seed, p_propose, d_cell_pos, grid);
+
+    d_flag[idx] = valid ? 1 : 0;
+    d_cand[idx] = make_scalar4(cand.x, cand.y, cand.z, Scalar(1.0));
+    }
+
+//! Place the valid candidates of a phase in the slots given by the scan of the flags
+/*! \param d_cell_pos Particle in every cell
+    \param d_pos Positions of the placed particles
+    \param d_n_accepted Number of candidates placed in this phase (output)
+    \param d_flag Flags of the valid candidates
+    \param d_slot Exclusive scan of \a d_flag
+    \param d_cand Candidate of every active cell
+    \param phase First cell of the phase
+    \param n_active Number of active cells
+    \param n_placed Number of particles placed before this phase
+    \param n_target Number of particles to place in total
+    \param grid Cell grid
+
+    Candidates are placed in the order of the active cells until \a n_target is reached, exactly like the CPU code.
+*/
+__global__ void gpu_rsa_accept_kernel(Scalar4 *d_cell_pos,
+                                      Scalar4 *d_pos,
+                                      unsigned int *d_n_accepted,
+                                      const unsigned int *d_flag,
+                                      const unsigned int *d_slot,
+                                      const Scalar4 *d_cand,
+                                      const uint3 phase,
+                                      const unsigned int n_active,
+                                      const unsigned int n_placed,
+                                      const unsigned int n_target,
+                                      const hoomd::detail::rsa_grid grid)
+    {
+    const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= n_active)
+        return;
+
+    const unsigned int slot = d_slot[idx];
+    const unsigned int flag = d_flag[idx];
+    if (idx == n_active - 1)
+        *d_n_accepted = min(slot + flag, n_target - n_placed);
+
+    if (!flag || n_placed + slot >= n_target)
+        return;
+
+    const uint3 cell = hoomd::detail::rsa_active_cell(idx, phase, grid);
+    const Scalar4 cand = d_cand[idx];
+    d_cell_pos[Index3D(grid.n.x, grid.n.y, grid.n.z)(cell.x, cell.y, cell.z)] = cand;
+    d_pos[n_placed + slot] = make_scalar4(cand.x, cand.y, cand.z, __int_as_scalar(0));
+    }
+
+/*! \param d_cell_pos Particle in every cell
+    \param d_pos Positions of the placed particles
+    \param d_n_accepted Number of candidates placed in this phase (output)
+    \param d_flag Temporary flags of the valid candidates, one per active cell
+    \param d_slot Temporary slots of the valid candidates, one per active cell
+    \param d_cand Temporary candidates, one per active cell
+    \param phase First cell of the phase
+    \param n_active Number of active cells
+    \param key Key of the random number generator of this phase
+    \param seed Seed of the random number generator
+    \param p_propose Probability that an empty cell draws a candidate
+    \param n_placed Number of particles placed before this phase
+    \param n_target Number of particles to place in total
+    \param grid Cell grid
+    \param block_size Number of threads per block
+    \param alloc Caching allocator for the temporary storage of the scan
+*/
+cudaError_t gpu_rsa_place_phase(Scalar4 *d_cell_pos,
+                                Scalar4 *d_pos,
+                                unsigned int *d_n_accepted,
+                                unsigned int *d_flag,
+                                unsigned int *d_slot,
+                                Scalar4 *d_cand,
+                                const uint3 phase,
+                                const unsigned int n_active,
+                                const unsigned int key,
+                                const unsigned int seed,
+                                const Scalar p_propose,
+                                const unsigned int n_placed,
+                                const unsigned int n_target,
+                                const hoomd::detail::rsa_grid& grid,
+                                const unsigned int block_size,
+                                CachedAllocator& alloc)
+    {
+    if (n_active == 0)
+        return cudaSuccess;
+
+    const unsigned int n_blocks = n_active / block_size + 1;
+    gpu_rsa_draw_kernel<<<n_blocks, block_size>>>(d_flag,
+                                                  d_cand,
+                                                  d_cell_pos,
+                                                  phase,
+                                                  n_active,
+                                                  key,
+                                                  seed,
+                                                  p_propose,
+                                                  grid);
+
+    // number the valid candidates in the order of the active cells
+    void *d_temp_storage = NULL;
+    size_t temp_storage_bytes = 0;
+    cub::DeviceScan::ExclusiveSum(d_temp_storage, temp_storage_bytes, d_flag, d_slot, n_active);
+    d_temp_storage = alloc.allocate(temp_storage_bytes);
+    cub::DeviceScan::ExclusiveSum(d_temp_storage, temp_storage_bytes, d_flag, d_slot, n_active);
+    alloc.deallocate((char *) d_temp_storage);
+
+    gpu_rsa_accept_kernel<<<n_blocks, block_size>>>(d_cell_pos,
+                                                    d_pos,
+                                                    d_n_accepted,
+                                                    d_flag,
+                                                    d_slot,
+                                                    d_cand,
+                                                    phase,
+                                                    n_active,
+                                                    n_placed,
+                                                    n_target,
+                                                    grid);
+
+    return cudaSuccess;
+    }
@@ -0,0 +1,37 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+#ifndef __RANDOM_SEQUENTIAL_ADDITION_GPU_CUH__
+#define __RANDOM_SEQUENTIAL_ADDITION_GPU_CUH__
+
+/*! \file RandomSequentialAdditionGPU.cuh
+    \brief Declares GPU kernel drivers for RandomSequentialAdditionGPU
+*/
+
+#include "HOOMDMath.h"
+#include "CachedAllocator.h"
+#include "RandomSequentialAdditionUtilities.h"
+
+#include <cuda_runtime.h>
+
+//! Fill all active cells of one phase on the GPU
+cudaError_t gpu_rsa_place_phase(Scalar4 *d_cell_pos,
+                                Scalar4 *d_pos,
+                                unsigned int *d_n_accepted,
+                                unsigned int *d_flag,
+                                unsigned int *d_slot,
+                                Scalar4 *d_cand,
+                                const uint3 phase,
+                                const unsigned int n_active,
+                                const unsigned int key,
+                                const unsigned int seed,
+                                const Scalar p_propose,
+                                const unsigned int n_placed,
+                                const unsigned int n_target,
+                                const hoomd::detail::rsa_grid& grid,
+                                const unsigned int block_size,
+                                CachedAllocator& alloc);
+
+#endif // __RANDOM_SEQUENTIAL_ADDITION_GPU_CUH__
@@ -0,0 +1,59 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+/*! \file RandomSequentialAdditionGPU.h
+    \brief Declares the RandomSequentialAdditionGPU class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifdef ENABLE_CUDA
+
+#include "RandomSequentialAddition.h"
+#include "RandomSequentialAdditionGPU.cuh"
+#include "GPUFlags.h"
+
+#ifndef __RANDOM_SEQUENTIAL_ADDITION_GPU_H__
+#define __RANDOM_SEQUENTIAL_ADDITION_GPU_H__
+
+//! Places particles of one diameter at random without overlaps on the GPU
+/*! All active cells of a phase draw and test their candidates in one thread each. The valid candidates are numbered
+    by a scan over the active cells, so the GPU places the same particles as the CPU.
+
+    \ingroup data_structs
+*/
+class PYBIND11_EXPORT RandomSequentialAdditionGPU : public RandomSequentialAddition
+    {
+    public:
+        //! Constructor
+        RandomSequentialAdditionGPU(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                    const BoxDim& box,
+                                    unsigned int dimensions,
+                                    Scalar diameter,
+                                    unsigned int seed);
+
+        //! Destructor
+        virtual ~RandomSequentialAdditionGPU() { }
+
+    protected:
+        //! Fill all active cells of one phase
+        virtual void placePhase(const uint3& phase, unsigned int key, Scalar p_propose, unsigned int n_target);
+
+    private:
+        GPUArray<unsigned int> m_flag;          //!< Flags of the valid candidates
+        GPUArray<unsigned int> m_slot;          //!< Slots of the valid candidates
+        GPUArray<Scalar4> m_cand;               //!< Candidate of every active cell
+        GPUFlags<unsigned int> m_n_accepted;    //!< Number of candidates placed in a phase
+        unsigned int m_block_size;              //!< Block size of the kernels
+    };
+
+//! Export RandomSequentialAdditionGPU to python
+void export_RandomSequentialAdditionGPU(pybind11::module& m);
+
+#endif // __RANDOM_SEQUENTIAL_ADDITION_GPU_H__
+
+#endif // ENABLE_CUDA
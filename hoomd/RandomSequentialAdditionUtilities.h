@@ -0,0 +1,155 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+#ifndef __RANDOM_SEQUENTIAL_ADDITION_UTILITIES_H__
+#define __RANDOM_SEQUENTIAL_ADDITION_UTILITIES_H__
+
+/*! \file RandomSequentialAdditionUtilities.h
+    \brief Utilities for RandomSequentialAddition on the CPU and GPU
+
+    The CPU and the GPU must draw and test exactly the same candidates so that both place the same particles for
+    the same seed. This code is split out here to guarantee that.
+*/
+
+#include "HOOMDMath.h"
+#include "BoxDim.h"
+#include "Index1D.h"
+#include "Saru.h"
+
+#ifdef NVCC
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+namespace hoomd
+{
+namespace detail
+{
+
+//! Cell grid of the random sequential addition
+/*! Every cell holds at most one particle. Cells that are at least \a stride cells apart along one direction never
+    interact, so all active cells of one phase can be filled at the same time.
+*/
+struct rsa_grid
+    {
+    BoxDim box;         //!< Box (or local domain) to fill
+    uint3 n;            //!< Number of cells along each direction
+    uint3 stride;       //!< Distance between two active cells of the same phase
+    int3 reach;         //!< Number of neighbor cells to check along each direction
+    Scalar3 margin;     //!< Fractional distance kept to the faces of a domain that is not periodic
+    Scalar diameter;    //!< Minimum distance between two particles
+    unsigned int ndim;  //!< Number of dimensions
+    };
+
+//! Get the number of active cells of a phase
+/*! \param phase Cell of the phase in the first block of stride^ndim cells
+    \param g Cell grid
+*/
+DEVICE inline uint3 rsa_num_active(const uint3& phase, const rsa_grid& g)
+    {
+    return make_uint3((g.n.x - phase.x + g.stride.x - 1)/g.stride.x,
+                      (g.n.y - phase.y + g.stride.y - 1)/g.stride.y,
+                      (g.n.z - phase.z + g.stride.z - 1)/g.stride.z);
+    }
+
+//! Get the cell of an active cell of a phase
+/*! \param idx Index of the active cell
+    \param phase Cell of the phase in the first block of stride^ndim cells
+    \param g Cell grid
+*/
+DEVICE inline uint3 rsa_active_cell(const unsigned int idx, const uint3& phase, const rsa_grid& g)
+    {
+    const uint3 na = rsa_num_active(phase, g);
+    const uint3 t = Index3D(na.x, na.y, na.z).getTriple(idx);
+    return make_uint3(phase.x + t.x*g.stride.x, phase.y + t.y*g.stride.y, phase.z + t.z*g.stride.z);
+    }
+
+//! Draw a candidate in an empty cell and test it against the particles placed so far
+/*! \param cand Candidate position (output)
+    \param cell Cell to draw the candidate in
+    \param key Key of the current phase (sweep*n_phases + phase)
+    \param seed Seed of the generator
+    \param p_propose Probability that an empty cell draws a candidate
+    \param d_cell_pos Particle in every cell, w is nonzero when the cell is occupied
+    \param g Cell grid
+
+    \returns true when the candidate does not overlap any particle and may be placed
+
+    The random number generator is keyed by the cell and the phase only, so the result does not depend on the order
+    in which the active cells are processed.
+*/
+DEVICE inline bool rsa_draw_candidate(Scalar3& cand,
+                                      const uint3& cell,
+                                      const unsigned int key,
+                                      const unsigned int seed,
+                                      const Scalar p_propose,
+                                      const Scalar4 *d_cell_pos,
+                                      const rsa_grid& g)
+    {
+    Index3D ci(g.n.x, g.n.y, g.n.z);
+    const unsigned int my_cell = ci(cell.x, cell.y, cell.z);
+    if (d_cell_pos[my_cell].w != Scalar(0.0))
+        return false;
+
+    hoomd::detail::Saru rng(my_cell, seed, key);
+    if (rng.s<Scalar>() >= p_propose)
+        return false;
+
+    Scalar3 f;
+    f.x = (Scalar(cell.x) + rng.s<Scalar>())/Scalar(g.n.x);
+    f.y = (Scalar(cell.y) + rng.s<Scalar>())/Scalar(g.n.y);
+    f.z = (Scalar(cell.z) + rng.s<Scalar>())/Scalar(g.n.z);
+
+    // keep away from faces shared with other domains, they place their particles independently
+    if (f.x < g.margin.x || f.x > Scalar(1.0) - g.margin.x ||
+        f.y < g.margin.y || f.y > Scalar(1.0) - g.margin.y ||
+        f.z < g.margin.z || f.z > Scalar(1.0) - g.margin.z)
+        return false;
+
+    cand = g.box.makeCoordinates(f);
+    if (g.ndim == 2)
+        cand.z = Scalar(0.0);
+
+    const uchar3 periodic = g.box.getPeriodic();
+    const Scalar dsq = g.diameter*g.diameter;
+    for (int dz = -g.reach.z; dz <= g.reach.z; ++dz)
+        {
+        int k = int(cell.z) + dz;
+        if (periodic.z) k = ((k % int(g.n.z)) + int(g.n.z)) % int(g.n.z);
+        else if (k < 0 || k >= int(g.n.z)) continue;
+
+        for (int dy = -g.reach.y; dy <= g.reach.y; ++dy)
+            {
+            int j = int(cell.y) + dy;
+            if (periodic.y) j = ((j % int(g.n.y)) + int(g.n.y)) % int(g.n.y);
+            else if (j < 0 || j >= int(g.n.y)) continue;
+
+            for (int dx = -g.reach.x; dx <= g.reach.x; ++dx)
+                {
+                int i = int(cell.x) + dx;
+                if (periodic.x) i = ((i % int(g.n.x)) + int(g.n.x)) % int(g.n.x);
+                else if (i < 0 || i >= int(g.n.x)) continue;
+
+                const Scalar4 other = d_cell_pos[ci(i,j,k)];
+                if (other.w == Scalar(0.0))
+                    continue;
+
+                const Scalar3 dr = g.box.minImage(cand - make_scalar3(other.x, other.y, other.z));
+                if (dot(dr,dr) < dsq)
+                    return false;
+                }
+            }
+        }
+
+    return true;
+    }
+
+} // end namespace detail
+} // end namespace hoomd
+
+#undef DEVICE
+
+#endif // __RANDOM_SEQUENTIAL_ADDITION_UTILITIES_H__
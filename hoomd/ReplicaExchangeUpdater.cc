@@ -0,0 +1,273 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file ReplicaExchangeUpdater.cc
+    \brief Defines the ReplicaExchangeUpdater class
+*/
+
+#ifdef ENABLE_MPI
+#include "ReplicaExchangeUpdater.h"
+#include "Saru.h"
+
+#include <hoomd/extern/pybind/include/pybind11/stl.h>
+
+#include <cmath>
+#include <iostream>
+#include <stdexcept>
+
+using namespace std;
+namespace py = pybind11;
+
+//! Message tags of the negotiation between the partitions
+enum replica_exchange_tag
+    {
+    tag_energy = 2301,      //!< Potential energy sent to the partner
+    tag_boundary,           //!< New holder of the boundary rung, sent to the neighboring pair
+    tag_forward             //!< Holder of the rung beyond the boundary, forwarded to the partner after a swap
+    };
+
+//! Results of a swap attempt
+enum replica_exchange_result
+    {
+    no_partner = 0,         //!< The rung has no partner in this pairing
+    rejected,               //!< The swap was rejected
+    accepted                //!< The swap was accepted
+    };
+
+/*!
+ * \param sysdef System definition
+ * \param thermo Compute of the potential energy of the replica
+ * \param temperatures Temperature of each rung of the ladder, in increasing order. One per partition.
+ * \param seed Random number seed, must be the same in all partitions
+ *
+ * Partition p starts at rung p.
+ */
+ReplicaExchangeUpdater::ReplicaExchangeUpdater(std::shared_ptr<SystemDefinition> sysdef,
+                                               std::shared_ptr<ComputeThermo> thermo,
+                                               const std::vector<Scalar>& temperatures,
+                                               unsigned int seed)
+    : Updater(sysdef), m_thermo(thermo), m_temperatures(temperatures), m_seed(seed), m_rescale_velocities(true),
+      m_world(m_exec_conf->getHOOMDWorldMPICommunicator()), m_n_attempts_total(0), m_n_attempts(0), m_n_accepted(0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing ReplicaExchangeUpdater" << endl;
+
+    if (m_temperatures.size() != m_exec_conf->getNPartitions())
+        {
+        m_exec_conf->msg->error() << "update.replica_exchange: " << m_temperatures.size() << " temperatures given for "
+                                  << m_exec_conf->getNPartitions() << " partitions" << endl;
+        throw runtime_error("Error initializing ReplicaExchangeUpdater");
+        }
+
+    for (unsigned int k = 0; k < m_temperatures.size(); ++k)
+        {
+        if (m_temperatures[k] <= Scalar(0.0) || (k > 0 && m_temperatures[k] <= m_temperatures[k-1]))
+            {
+            m_exec_conf->msg->error() << "update.replica_exchange: temperatures must be positive and increasing"
+                                      << endl;
+            throw runtime_error("Error initializing ReplicaExchangeUpdater");
+            }
+        }
+
+    int world_rank;
+    MPI_Comm_rank(m_world, &world_rank);
+    m_rung = world_rank/m_exec_conf->getNRanks();
+    m_lower = int(m_rung) - 1;
+    m_upper = (m_rung + 1 < m_temperatures.size()) ? int(m_rung) + 1 : -1;
+
+    m_variant = std::shared_ptr<VariantReplicaExchange>(new VariantReplicaExchange(m_temperatures[m_rung]));
+    }
+
+ReplicaExchangeUpdater::~ReplicaExchangeUpdater()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying ReplicaExchangeUpdater" << endl;
+    }
+
+/*!
+ * \param timestep Current time step of the simulation
+ *
+ * All partitions must run the updater on the same time steps.
+ */
+void ReplicaExchangeUpdater::update(unsigned int timestep)
+    {
+    if (m_prof) m_prof->push("Replica exchange");
+
+    m_thermo->compute(timestep);
+    const double energy = m_thermo->getPotentialEnergy();
+    if (std::isnan(energy))
+        {
+        m_exec_conf->msg->error() << "update.replica_exchange: the potential energy is not available" << endl;
+        throw runtime_error("Error updating ReplicaExchangeUpdater");
+        }
+
+    const unsigned int old_rung = m_rung;
+    unsigned int result[2];
+    if (m_exec_conf->isRoot())
+        {
+        result[0] = negotiate(energy);
+        result[1] = m_rung;
+        }
+    MPI_Bcast(result, 2, MPI_UNSIGNED, 0, m_exec_conf->getMPICommunicator());
+    m_rung = result[1];
+    m_n_attempts_total++;
+
+    if (result[0] != no_partner)
+        m_n_attempts++;
+    if (result[0] == accepted)
+        m_n_accepted++;
+
+    if (m_rung != old_rung)
+        {
+        m_variant->setValue(m_temperatures[m_rung]);
+
+        if (m_rescale_velocities)
+            {
+            const Scalar scale = sqrt(m_temperatures[m_rung]/m_temperatures[old_rung]);
+            ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+            for (unsigned int i = 0; i < m_pdata->getN(); ++i)
+                {
+                h_vel.data[i].x *= scale;
+                h_vel.data[i].y *= scale;
+                h_vel.data[i].z *= scale;
+                }
+            }
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*!
+ * \param energy Potential energy of the replica
+ * \returns The result of the attempt, a replica_exchange_result
+ *
+ * In even attempts the pairs are (0,1), (2,3), ..., in odd attempts (1,2), (3,4), ... Each partition is the lower or
+ * the upper member of its pair, its partner is on one side of the ladder and the neighboring pair on the other side.
+ * The same neighbor relation holds on the other side, so every message has a matching receive.
+ */
+int ReplicaExchangeUpdater::negotiate(double energy)
+    {
+    const int ranks = m_exec_conf->getNRanks();
+    const bool lower_member = (m_rung % 2 == m_n_attempts_total % 2);
+    const int partner = lower_member ? m_upper : m_lower;
+    const int outer = lower_member ? m_lower : m_upper;
+
+    int world_rank;
+    MPI_Comm_rank(m_world, &world_rank);
+    const int me = world_rank/ranks;
+
+    MPI_Request req[2];
+    int result = no_partner;
+    if (partner >= 0)
+        {
+        double partner_energy;
+        MPI_Isend(&energy, 1, MPI_DOUBLE, partner*ranks, tag_energy, m_world, &req[0]);
+        MPI_Irecv(&partner_energy, 1, MPI_DOUBLE, partner*ranks, tag_energy, m_world, &req[1]);
+        MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+
+        // both partners evaluate the same expression with the same random number
+        const unsigned int k = lower_member ? m_rung : m_rung - 1;
+        const double energy_lo = lower_member ? energy : partner_energy;
+        const double energy_hi = lower_member ? partner_energy : energy;
+        const double delta = (1.0/m_temperatures[k] - 1.0/m_temperatures[k+1])*(energy_lo - energy_hi);
+        hoomd::detail::Saru rng(m_seed, m_n_attempts_total, k);
+        result = (delta >= 0.0 || rng.d() < exp(delta)) ? accepted : rejected;
+        }
+
+    // tell the neighboring pair which partition now holds the rung next to it
+    const bool swapped = (result == accepted);
+    int holder = swapped ? partner : me;
+    int outer_holder = -1;
+    if (outer >= 0)
+        {
+        MPI_Isend(&holder, 1, MPI_INT, outer*ranks, tag_boundary, m_world, &req[0]);
+        MPI_Irecv(&outer_holder, 1, MPI_INT, outer*ranks, tag_boundary, m_world, &req[1]);
+        MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+        }
+
+    if (!swapped)
+        {
+        if (lower_member)
+            m_lower = outer_holder;
+        else
+            m_upper = outer_holder;
+        return result;
+        }
+
+    // the partner now holds the rung next to the neighboring pair, forward the neighbor to it
+    int partner_outer_holder;
+    MPI_Isend(&outer_holder, 1, MPI_INT, partner*ranks, tag_forward, m_world, &req[0]);
+    MPI_Irecv(&partner_outer_holder, 1, MPI_INT, partner*ranks, tag_forward, m_world, &req[1]);
+    MPI_Waitall(2, req, MPI_STATUSES_IGNORE);
+
+    if (lower_member)
+        {
+        m_rung++;
+        m_lower = partner;
+        m_upper = partner_outer_holder;
+        }
+    else
+        {
+        m_rung--;
+        m_upper = partner;
+        m_lower = partner_outer_holder;
+        }
+    return result;
+    }
+
+/*!
+ * \returns The rung and temperature of this partition and its acceptance ratio of the swaps
+ */
+std::vector< std::string > ReplicaExchangeUpdater::getProvidedLogQuantities()
+    {
+    std::vector< std::string > list;
+    list.push_back("replica_exchange_rung");
+    list.push_back("replica_exchange_temperature");
+    list.push_back("replica_exchange_acceptance");
+    return list;
+    }
+
+/*!
+ * \param quantity Name of the log quantity to get
+ * \param timestep Current time step of the simulation
+ * \returns The requested quantity
+ */
+Scalar ReplicaExchangeUpdater::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    if (quantity == "replica_exchange_rung")
+        return Scalar(m_rung);
+    else if (quantity == "replica_exchange_temperature")
+        return m_temperatures[m_rung];
+    else if (quantity == "replica_exchange_acceptance")
+        return m_n_attempts ? Scalar(m_n_accepted)/Scalar(m_n_attempts) : Scalar(0.0);
+
+    m_exec_conf->msg->error() << "update.replica_exchange: " << quantity << " is not a valid log quantity" << endl;
+    throw runtime_error("Error getting log value");
+    }
+
+void ReplicaExchangeUpdater::printStats()
+    {
+    m_exec_conf->msg->notice(1) << "-- Replica exchange stats:" << endl;
+    m_exec_conf->msg->notice(1) << "Accepted swaps: " << m_n_accepted << " / " << m_n_attempts
+                                << ", now at temperature " << m_temperatures[m_rung] << endl;
+    }
+
+void ReplicaExchangeUpdater::resetStats()
+    {
+    m_n_attempts = 0;
+    m_n_accepted = 0;
+    }
+
+void export_ReplicaExchangeUpdater(py::module& m)
+    {
+    py::class_<VariantReplicaExchange, std::shared_ptr<VariantReplicaExchange> >(m,"VariantReplicaExchange",py::base<Variant>())
+    .def(py::init< double >())
+    ;
+
+    py::class_<ReplicaExchangeUpdater, std::shared_ptr<ReplicaExchangeUpdater> >(m,"ReplicaExchangeUpdater",py::base<Updater>())
+    .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<ComputeThermo>, const std::vector<Scalar>&, unsigned int >())
+    .def("setRescaleVelocities", &ReplicaExchangeUpdater::setRescaleVelocities)
+    .def("getVariant", &ReplicaExchangeUpdater::getVariant)
+    .def("getRung", &ReplicaExchangeUpdater::getRung)
+    ;
+    }
+#endif // ENABLE_MPI
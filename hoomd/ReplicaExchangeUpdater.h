@@ -0,0 +1,146 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file ReplicaExchangeUpdater.h
+    \brief Declares an updater that exchanges temperatures between MPI partitions
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifdef ENABLE_MPI
+
+#ifndef __REPLICA_EXCHANGE_UPDATER_H__
+#define __REPLICA_EXCHANGE_UPDATER_H__
+
+#include "Updater.h"
+#include "Variant.h"
+#include "ComputeThermo.h"
+
+#include <memory>
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+#include <vector>
+
+//! Variant that holds the temperature assigned to a partition by the ReplicaExchangeUpdater
+class PYBIND11_EXPORT VariantReplicaExchange : public Variant
+    {
+    public:
+        //! Constructor
+        VariantReplicaExchange(double val) : m_val(val)
+            {
+            }
+
+        //! Gets the value at a given time step
+        virtual double getValue(unsigned int timestep)
+            {
+            return m_val;
+            }
+
+        //! Sets the value
+        void setValue(double val)
+            {
+            m_val = val;
+            }
+
+    private:
+        double m_val;       //!< The value
+    };
+
+//! Exchanges temperatures between replicas that run in separate MPI partitions
+/*! Each partition simulates one replica, and the replicas hold the temperatures of a ladder (one per partition, in
+    increasing order). Every time the updater runs, neighboring rungs of the ladder attempt to swap their temperatures,
+    alternating between the even and the odd pairs of rungs. A swap between the replicas at rungs k and k+1 is accepted
+    with the Metropolis probability min(1, exp((1/T_k - 1/T_{k+1})(U_k - U_{k+1}))) of their potential energies.
+    The configurations stay in their partitions, only the temperatures move.
+
+    Swaps are negotiated between the root ranks of the partitions with point to point messages. Each root keeps the
+    partitions that hold the rungs directly above and below its own. After each attempt, the pair partners exchange
+    their energies, then the boundary partitions of neighboring pairs tell each other which partition now holds their
+    rung, and partners that swapped forward this to each other. A partition therefore only ever waits for its partner
+    and its two neighbors on the ladder, never for all partitions. The result is broadcast within each partition.
+
+    The temperature of the partition is provided as a Variant for the thermostats. When a swap is accepted the
+    velocities are optionally rescaled by sqrt(T_new/T_old), so that the kinetic energy matches the new temperature.
+
+    \ingroup updaters
+*/
+class PYBIND11_EXPORT ReplicaExchangeUpdater : public Updater
+    {
+    public:
+        //! Constructor
+        ReplicaExchangeUpdater(std::shared_ptr<SystemDefinition> sysdef,
+                               std::shared_ptr<ComputeThermo> thermo,
+                               const std::vector<Scalar>& temperatures,
+                               unsigned int seed);
+
+        //! Destructor
+        virtual ~ReplicaExchangeUpdater();
+
+        //! Attempt a swap with the neighboring rung of the current pairing
+        virtual void update(unsigned int timestep);
+
+        //! Set whether the velocities are rescaled on accepted swaps
+        void setRescaleVelocities(bool rescale)
+            {
+            m_rescale_velocities = rescale;
+            }
+
+        //! Get the variant that holds the current temperature of this partition
+        std::shared_ptr<Variant> getVariant() const
+            {
+            return m_variant;
+            }
+
+        //! Get the rung of the temperature ladder that this partition holds
+        unsigned int getRung() const
+            {
+            return m_rung;
+            }
+
+        //! Returns a list of log quantities this updater calculates
+        virtual std::vector< std::string > getProvidedLogQuantities();
+
+        //! Calculates the requested log value and returns it
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+        //! The acceptance is computed from the potential energy
+        virtual PDataFlags getRequestedPDataFlags()
+            {
+            PDataFlags flags(0);
+            flags[pdata_flag::potential_energy] = 1;
+            return flags;
+            }
+
+        //! Print the acceptance of the swaps
+        virtual void printStats();
+
+        //! Reset the swap counters
+        virtual void resetStats();
+
+    protected:
+        //! Negotiate a swap on the root rank of the partition
+        int negotiate(double energy);
+
+        std::shared_ptr<ComputeThermo> m_thermo;            //!< Computes the potential energy of the replica
+        std::vector<Scalar> m_temperatures;                 //!< Temperature of each rung
+        unsigned int m_seed;                                //!< Seed shared by all partitions
+        bool m_rescale_velocities;                          //!< True if the velocities are rescaled on swaps
+        std::shared_ptr<VariantReplicaExchange> m_variant;  //!< Temperature of this partition
+
+        const MPI_Comm m_world;                             //!< Communicator of all partitions
+        unsigned int m_rung;                                //!< Rung held by this partition
+        int m_lower;                                        //!< Partition that holds the rung below (-1 if none)
+        int m_upper;                                        //!< Partition that holds the rung above (-1 if none)
+        unsigned int m_n_attempts_total;                    //!< Number of attempts since the start, sets the pairing
+
+        unsigned int m_n_attempts;                          //!< Attempts with a partner in this run
+        unsigned int m_n_accepted;                          //!< Accepted swaps in this run
+    };
+
+//! Exports the ReplicaExchangeUpdater class to python
+void export_ReplicaExchangeUpdater(pybind11::module& m);
+
+#endif // __REPLICA_EXCHANGE_UPDATER_H__
+#endif // ENABLE_MPI
@@ -18,13 +18,64 @@
 #include <fstream>
 #include <iostream>
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 using namespace std;
 namespace py = pybind11;
 
+//! Call a function for every chunk of the particles, in parallel when running with multiple threads
+/*! \param n_chunks Number of chunks
+    \param f Function to call with the index of the chunk
+*/
+template<class F>
+static void for_each_chunk(unsigned int n_chunks, const F& f)
+    {
+    #ifdef ENABLE_TBB
+    if (n_chunks > 1)
+        {
+        tbb::parallel_for((unsigned int)0, n_chunks, f);
+        return;
+        }
+    #endif
+
+    for (unsigned int chunk = 0; chunk < n_chunks; ++chunk)
+        f(chunk);
+    }
+
+//! Reorder an array of particle data
+/*! \param data Array to reorder
+    \param scratch Temporary storage for at least \a N elements
+    \param order New order of the elements
+    \param N Number of elements
+    \param n_chunks Number of chunks to process in parallel
+*/
+template<class T>
+static void apply_permutation(T *data, void *scratch, const unsigned int *order, unsigned int N, unsigned int n_chunks)
+    {
+    T *tmp = reinterpret_cast<T *>(scratch);
+    const unsigned int chunk_size = (N + n_chunks - 1) / n_chunks;
+
+    for_each_chunk(n_chunks, [&] (unsigned int chunk)
+        {
+        const unsigned int n_end = std::min((chunk+1)*chunk_size, N);
+        for (unsigned int i = chunk*chunk_size; i < n_end; i++)
+            tmp[i] = data[order[i]];
+        });
+
+    for_each_chunk(n_chunks, [&] (unsigned int chunk)
+        {
+        const unsigned int n_end = std::min((chunk+1)*chunk_size, N);
+        const unsigned int n_start = std::min(chunk*chunk_size, N);
+        std::copy(tmp + n_start, tmp + std::max(n_end, n_start), data + n_start);
+        });
+    }
+
 /*! \param sysdef System to perform sorts on
  */
 SFCPackUpdater::SFCPackUpdater(std::shared_ptr<SystemDefinition> sysdef)
-        : Updater(sysdef), m_last_grid(0), m_last_dim(0)
+        : Updater(sysdef), m_last_grid(0), m_last_dim(0), m_locality_threshold(0.0), m_sorted_locality(0.0)
     {
     m_exec_conf->msg->notice(5) << "Constructing SFCPackUpdater" << endl;
 
@@ -33,6 +84,7 @@ SFCPackUpdater::SFCPackUpdater(std::shared_ptr<SystemDefinition> sysdef)
 
     m_sort_order.resize(m_pdata->getMaxN());
     m_particle_bins.resize(m_pdata->getMaxN());
+    m_particle_bins_alt.resize(m_pdata->getMaxN());
 
     // set the default grid
     // Grid dimension must always be a power of 2 and determines the memory usage for m_traversal_order
@@ -52,6 +104,87 @@ void SFCPackUpdater::reallocate()
     {
     m_sort_order.resize(m_pdata->getMaxN());
     m_particle_bins.resize(m_pdata->getMaxN());
+    m_particle_bins_alt.resize(m_pdata->getMaxN());
+    }
+
+/*! \param N Number of particles
+    \returns The number of chunks of particles to process in parallel
+*/
+unsigned int SFCPackUpdater::getNumChunks(unsigned int N) const
+    {
+    return std::max(1u, std::min(m_exec_conf->getNumThreads(), N));
+    }
+
+/*! \param N Number of particles
+    \param n_bins Number of bins, the bin of every particle is smaller
+
+    The bins are sorted with a least significant digit radix sort of 8 bits per pass. Every pass counts the digits in
+    contiguous chunks of the particles, and scatters them to the offsets from the scan over digits and chunks. The radix
+    sort is stable, so the particles in a bin keep their order and the result is the same as a sort of the (bin,
+    index) pairs. The sorted order is written to m_sort_order.
+*/
+void SFCPackUpdater::sortParticleBins(unsigned int N, unsigned int n_bins)
+    {
+    assert(m_particle_bins.size() >= N && m_particle_bins_alt.size() >= N);
+
+    const unsigned int n_chunks = getNumChunks(N);
+    const unsigned int chunk_size = (N + n_chunks - 1) / n_chunks;
+    const unsigned int n_digits = 256;
+
+    unsigned int n_bits = 0;
+    while (n_bits < 32 && (1u << n_bits) < n_bins)
+        n_bits++;
+
+    std::vector<unsigned int> offsets(n_chunks*n_digits);
+
+    for (unsigned int shift = 0; shift < n_bits; shift += 8)
+        {
+        const std::pair<unsigned int, unsigned int> *in = &m_particle_bins[0];
+        std::pair<unsigned int, unsigned int> *out = &m_particle_bins_alt[0];
+
+        // count the digits in every chunk
+        for_each_chunk(n_chunks, [&] (unsigned int chunk)
+            {
+            unsigned int *count = &offsets[chunk*n_digits];
+            std::fill(count, count + n_digits, 0);
+
+            const unsigned int n_end = std::min((chunk+1)*chunk_size, N);
+            for (unsigned int n = chunk*chunk_size; n < n_end; n++)
+                count[(in[n].first >> shift) & (n_digits-1)]++;
+            });
+
+        // exclusive scan over the digits, and the chunks for every digit
+        unsigned int offset = 0;
+        for (unsigned int digit = 0; digit < n_digits; digit++)
+            {
+            for (unsigned int chunk = 0; chunk < n_chunks; chunk++)
+                {
+                unsigned int count = offsets[chunk*n_digits + digit];
+                offsets[chunk*n_digits + digit] = offset;
+                offset += count;
+                }
+            }
+
+        // scatter the particles
+        for_each_chunk(n_chunks, [&] (unsigned int chunk)
+            {
+            unsigned int *offset_chunk = &offsets[chunk*n_digits];
+
+            const unsigned int n_end = std::min((chunk+1)*chunk_size, N);
+            for (unsigned int n = chunk*chunk_size; n < n_end; n++)
+                out[offset_chunk[(in[n].first >> shift) & (n_digits-1)]++] = in[n];
+            });
+
+        m_particle_bins.swap(m_particle_bins_alt);
+        }
+
+    // translate the sorted order
+    for_each_chunk(n_chunks, [&] (unsigned int chunk)
+        {
+        const unsigned int n_end = std::min((chunk+1)*chunk_size, N);
+        for (unsigned int j = chunk*chunk_size; j < n_end; j++)
+            m_sort_order[j] = m_particle_bins[j].second;
+        });
     }
 
 /*! Destructor
@@ -62,14 +195,83 @@ SFCPackUpdater::~SFCPackUpdater()
     m_pdata->getMaxParticleNumberChangeSignal().disconnect<SFCPackUpdater, &SFCPackUpdater::reallocate>(this);
     }
 
+/*! \returns The mean distance between particles that are consecutive in memory, in units of the mean particle spacing
+
+    The distance between neighboring particles in memory is the minimum image distance, and the mean particle spacing
+    is (V/N)^(1/d) of the global box. A sorted system has a locality of order one, a system in random order one of
+    the order of the box length. In MPI simulations, the distances are averaged over all ranks and the method must be
+    called on all ranks.
+*/
+Scalar SFCPackUpdater::getLocality()
+    {
+    const BoxDim& box = m_pdata->getBox();
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_pairs = N > 0 ? N-1 : 0;
+    const unsigned int n_chunks = getNumChunks(n_pairs);
+    const unsigned int chunk_size = (n_pairs + n_chunks - 1) / n_chunks;
+
+    std::vector<double> sum(n_chunks, 0.0);
+    {
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+
+    for_each_chunk(n_chunks, [&] (unsigned int chunk)
+        {
+        const unsigned int n_end = std::min((chunk+1)*chunk_size, n_pairs);
+        for (unsigned int n = chunk*chunk_size; n < n_end; n++)
+            {
+            Scalar3 dx = make_scalar3(h_pos.data[n+1].x - h_pos.data[n].x,
+                                      h_pos.data[n+1].y - h_pos.data[n].y,
+                                      h_pos.data[n+1].z - h_pos.data[n].z);
+            dx = box.minImage(dx);
+            sum[chunk] += sqrt(dot(dx, dx));
+            }
+        });
+    }
+
+    double totals[2];
+    totals[0] = 0.0;
+    for (unsigned int chunk = 0; chunk < n_chunks; chunk++)
+        totals[0] += sum[chunk];
+    totals[1] = double(n_pairs);
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        MPI_Allreduce(MPI_IN_PLACE, totals, 2, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+    #endif
+
+    if (totals[1] == 0.0)
+        return Scalar(0.0);
+
+    const unsigned int dim = m_sysdef->getNDimensions();
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    const double spacing = pow(double(global_box.getVolume(dim == 2))/double(m_pdata->getNGlobal()), 1.0/double(dim));
+
+    return Scalar(totals[0]/totals[1]/spacing);
+    }
+
 /*! Performs the sort.
     \note In an updater list, this sort should be done first, before anyone else
     gets ahold of the particle data
 
     \param timestep Current timestep of the simulation
+
+    With a locality threshold, the sort is skipped when the locality has not grown enough since the last sort.
  */
 void SFCPackUpdater::update(unsigned int timestep)
     {
+    if (m_locality_threshold > Scalar(0.0) && m_sorted_locality > Scalar(0.0))
+        {
+        if (m_prof) m_prof->push(m_exec_conf, "SFCPack locality");
+        Scalar locality = getLocality();
+        if (m_prof) m_prof->pop(m_exec_conf);
+
+        if (locality < m_locality_threshold*m_sorted_locality)
+            {
+            m_exec_conf->msg->notice(6) << "SFCPackUpdater: locality " << locality << ", skipping the sort" << std::endl;
+            return;
+            }
+        }
+
     m_exec_conf->msg->notice(6) << "SFCPackUpdater: particle sort" << std::endl;
 
     #ifdef ENABLE_MPI
@@ -107,6 +309,10 @@ void SFCPackUpdater::update(unsigned int timestep)
     #endif
 
     if (m_prof) m_prof->pop(m_exec_conf);
+
+    // the reference for the next checks
+    if (m_locality_threshold > Scalar(0.0))
+        m_sorted_locality = getLocality();
     }
 
 void SFCPackUpdater::applySortOrder()
@@ -124,128 +330,51 @@ void SFCPackUpdater::applySortOrder()
     ArrayHandle<Scalar3> h_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::readwrite);
-
-    // construct a temporary holding array for the sorted data
-    Scalar4 *scal4_tmp = new Scalar4[m_pdata->getN()];
-
-    // sort positions and types
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_pos.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_pos.data[i] = scal4_tmp[i];
-
-    // sort velocities and mass
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_vel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_vel.data[i] = scal4_tmp[i];
-
-    Scalar3 *scal3_tmp = new Scalar3[m_pdata->getN()];
-    // sort accelerations
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal3_tmp[i] = h_accel.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_accel.data[i] = scal3_tmp[i];
-
-    Scalar *scal_tmp  = new Scalar[m_pdata->getN()];
-    // sort charge
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_charge.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_charge.data[i] = scal_tmp[i];
-
-    // sort diameter
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal_tmp[i] = h_diameter.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_diameter.data[i] = scal_tmp[i];
-
-    // sort angular momentum
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal4_tmp[i] = h_angmom.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_angmom.data[i] = scal4_tmp[i];
-
-    // sort moment of inertia
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        scal3_tmp[i] = h_inertia.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_inertia.data[i] = scal3_tmp[i];
+    ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_chunks = getNumChunks(N);
+    const unsigned int *order = &m_sort_order[0];
+
+    // temporary storage for the sorted data, large enough for every array
+    std::vector<Scalar4> scratch(N);
+    void *tmp = &scratch[0];
+
+    apply_permutation(h_pos.data, tmp, order, N, n_chunks);
+    apply_permutation(h_vel.data, tmp, order, N, n_chunks);
+    apply_permutation(h_accel.data, tmp, order, N, n_chunks);
+    apply_permutation(h_charge.data, tmp, order, N, n_chunks);
+    apply_permutation(h_diameter.data, tmp, order, N, n_chunks);
+    apply_permutation(h_angmom.data, tmp, order, N, n_chunks);
+    apply_permutation(h_inertia.data, tmp, order, N, n_chunks);
 
     // in case anyone access it from frame to frame, sort the net virial
-        {
-        ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::readwrite);
-        unsigned int virial_pitch = m_pdata->getNetVirial().getPitch();
-
-        for (unsigned int j = 0; j < 6; j++)
-            {
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                scal_tmp[i] = h_net_virial.data[j*virial_pitch+m_sort_order[i]];
-            for (unsigned int i = 0; i < m_pdata->getN(); i++)
-                h_net_virial.data[j*virial_pitch+i] = scal_tmp[i];
-            }
-        }
+    unsigned int virial_pitch = m_pdata->getNetVirial().getPitch();
+    for (unsigned int j = 0; j < 6; j++)
+        apply_permutation(h_net_virial.data + j*virial_pitch, tmp, order, N, n_chunks);
 
     // sort net force, net torque, and orientation
-        {
-        ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::readwrite);
-
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_force.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_force.data[i] = scal4_tmp[i];
-        }
+    apply_permutation(h_net_force.data, tmp, order, N, n_chunks);
+    apply_permutation(h_net_torque.data, tmp, order, N, n_chunks);
+    apply_permutation(h_orientation.data, tmp, order, N, n_chunks);
 
-        {
-        ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::readwrite);
-
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_net_torque.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_net_torque.data[i] = scal4_tmp[i];
-        }
-
-        {
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
-
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            scal4_tmp[i] = h_orientation.data[m_sort_order[i]];
-        for (unsigned int i = 0; i < m_pdata->getN(); i++)
-            h_orientation.data[i] = scal4_tmp[i];
-        }
-
-    // sort image
-    int3 *int3_tmp = new int3[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        int3_tmp[i] = h_image.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_image.data[i] = int3_tmp[i];
-
-    // sort body
-    unsigned int *uint_tmp = new unsigned int[m_pdata->getN()];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_body.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_body.data[i] = uint_tmp[i];
+    apply_permutation(h_image.data, tmp, order, N, n_chunks);
+    apply_permutation(h_body.data, tmp, order, N, n_chunks);
 
     // sort global tag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        uint_tmp[i] = h_tag.data[m_sort_order[i]];
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
-        h_tag.data[i] = uint_tmp[i];
+    apply_permutation(h_tag.data, tmp, order, N, n_chunks);
 
     // rebuild global rtag
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    const unsigned int chunk_size = (N + n_chunks - 1) / n_chunks;
+    for_each_chunk(n_chunks, [&] (unsigned int chunk)
         {
-        h_rtag.data[h_tag.data[i]] = i;
-        }
-
-    delete[] scal_tmp;
-    delete[] scal4_tmp;
-    delete[] scal3_tmp;
-    delete[] uint_tmp;
-    delete[] int3_tmp;
-
+        const unsigned int n_end = std::min((chunk+1)*chunk_size, N);
+        for (unsigned int i = chunk*chunk_size; i < n_end; i++)
+            h_rtag.data[h_tag.data[i]] = i;
+        });
     }
 
 //! x walking table for the hilbert curve
@@ -450,41 +579,43 @@ void SFCPackUpdater::getSortedOrder2D()
     // make even bin dimensions
     const BoxDim& box = m_pdata->getBox();
 
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_chunks = getNumChunks(N);
+    const unsigned int chunk_size = (N + n_chunks - 1) / n_chunks;
+
     // put the particles in the bins
     {
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
 
     // for each particle
-    for (unsigned int n = 0; n < m_pdata->getN(); n++)
+    for_each_chunk(n_chunks, [&] (unsigned int chunk)
         {
-        // find the bin each particle belongs in
-        Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
-        Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
-        int ib = (unsigned int)(f.x * m_grid) % m_grid;
-        int jb = (unsigned int)(f.y * m_grid) % m_grid;
+        const unsigned int n_end = std::min((chunk+1)*chunk_size, N);
+        for (unsigned int n = chunk*chunk_size; n < n_end; n++)
+            {
+            // find the bin each particle belongs in
+            Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
+            Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
+            int ib = (unsigned int)(f.x * m_grid) % m_grid;
+            int jb = (unsigned int)(f.y * m_grid) % m_grid;
 
-        // if the particle is slightly outside, move back into grid
-        if (ib < 0) ib = 0;
-        if (ib >= (int)m_grid) ib = m_grid - 1;
+            // if the particle is slightly outside, move back into grid
+            if (ib < 0) ib = 0;
+            if (ib >= (int)m_grid) ib = m_grid - 1;
 
-        if (jb < 0) jb = 0;
-        if (jb >= (int)m_grid) jb = m_grid - 1;
+            if (jb < 0) jb = 0;
+            if (jb >= (int)m_grid) jb = m_grid - 1;
 
-        // record its bin
-        unsigned int bin = ib*m_grid + jb;
+            // record its bin
+            unsigned int bin = ib*m_grid + jb;
 
-        m_particle_bins[n] = std::pair<unsigned int, unsigned int>(bin, n);
-        }
+            m_particle_bins[n] = std::pair<unsigned int, unsigned int>(bin, n);
+            }
+        });
     }
 
-    // sort the tuples
-    sort(m_particle_bins.begin(), m_particle_bins.begin() + m_pdata->getN());
-
-    // translate the sorted order
-    for (unsigned int j = 0; j < m_pdata->getN(); j++)
-        {
-        m_sort_order[j] = m_particle_bins[j].second;
-        }
+    // sort the tuples and translate the sorted order
+    sortParticleBins(N, m_grid*m_grid);
     }
 
 void SFCPackUpdater::getSortedOrder3D()
@@ -547,39 +678,41 @@ void SFCPackUpdater::getSortedOrder3D()
     // access traversal order
     ArrayHandle<unsigned int> h_traversal_order(m_traversal_order, access_location::host, access_mode::read);
 
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_chunks = getNumChunks(N);
+    const unsigned int chunk_size = (N + n_chunks - 1) / n_chunks;
+
     // for each particle
-    for (unsigned int n = 0; n < m_pdata->getN(); n++)
+    for_each_chunk(n_chunks, [&] (unsigned int chunk)
         {
-        Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
-        Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
-        int ib = (unsigned int)(f.x * m_grid) % m_grid;
-        int jb = (unsigned int)(f.y * m_grid) % m_grid;
-        int kb = (unsigned int)(f.z * m_grid) % m_grid;
-
-        // if the particle is slightly outside, move back into grid
-        if (ib < 0) ib = 0;
-        if (ib >= (int)m_grid) ib = m_grid - 1;
+        const unsigned int n_end = std::min((chunk+1)*chunk_size, N);
+        for (unsigned int n = chunk*chunk_size; n < n_end; n++)
+            {
+            Scalar3 p = make_scalar3(h_pos.data[n].x, h_pos.data[n].y, h_pos.data[n].z);
+            Scalar3 f = box.makeFraction(p,make_scalar3(0.0,0.0,0.0));
+            int ib = (unsigned int)(f.x * m_grid) % m_grid;
+            int jb = (unsigned int)(f.y * m_grid) % m_grid;
+            int kb = (unsigned int)(f.z * m_grid) % m_grid;
 
-        if (jb < 0) jb = 0;
-        if (jb >= (int)m_grid) jb = m_grid - 1;
+            // if the particle is slightly outside, move back into grid
+            if (ib < 0) ib = 0;
+            if (ib >= (int)m_grid) ib = m_grid - 1;
 
-        if (kb < 0) kb = 0;
-        if (kb >= (int)m_grid) kb = m_grid - 1;
+            if (jb < 0) jb = 0;
+            if (jb >= (int)m_grid) jb = m_grid - 1;
 
-        // record its bin
-        unsigned int bin = ib*(m_grid*m_grid) + jb * m_grid + kb;
+            if (kb < 0) kb = 0;
+            if (kb >= (int)m_grid) kb = m_grid - 1;
 
-        m_particle_bins[n] = std::pair<unsigned int, unsigned int>(h_traversal_order.data[bin], n);
-        }
+            // record its bin
+            unsigned int bin = ib*(m_grid*m_grid) + jb * m_grid + kb;
 
-    // sort the tuples
-    sort(m_particle_bins.begin(), m_particle_bins.begin() + m_pdata->getN());
+            m_particle_bins[n] = std::pair<unsigned int, unsigned int>(h_traversal_order.data[bin], n);
+            }
+        });
 
-    // translate the sorted order
-    for (unsigned int j = 0; j < m_pdata->getN(); j++)
-        {
-        m_sort_order[j] = m_particle_bins[j].second;
-        }
+    // sort the tuples and translate the sorted order
+    sortParticleBins(N, m_grid*m_grid*m_grid);
     }
 
 void SFCPackUpdater::writeTraversalOrder(const std::string& fname, const vector< unsigned int >& reverse_order)
@@ -617,5 +750,7 @@ void export_SFCPackUpdater(py::module& m)
     py::class_<SFCPackUpdater, std::shared_ptr<SFCPackUpdater> >(m,"SFCPackUpdater",py::base<Updater>())
     .def(py::init< std::shared_ptr<SystemDefinition> >())
     .def("setGrid", &SFCPackUpdater::setGrid)
+    .def("setLocalityThreshold", &SFCPackUpdater::setLocalityThreshold)
+    .def("getLocality", &SFCPackUpdater::getLocality)
     ;
     }
@@ -44,6 +44,17 @@
     which those bins appear along a hilbert curve. It is very efficient, even when the box size changes often as the
     grid dimension is kept constant.
 
+    The bins of the particles are computed, radix sorted and applied to the particle data in parallel chunks when
+    running with multiple TBB threads.
+
+    Adaptive sorting:<br>
+    With setLocalityThreshold(), the period of the updater becomes the period at which the locality of the particle
+    order is checked. The locality is the mean distance between particles that are consecutive in memory, in units of
+    the mean particle spacing (see getLocality()). It is measured in one pass over the positions, and the particles
+    are only sorted when it has grown by more than the threshold factor over its value right after the previous sort.
+    In MPI simulations the locality is averaged over all ranks, so that all ranks take the same decision and a
+    skipped sort also skips its particle migration.
+
     \ingroup updaters
 */
 class PYBIND11_EXPORT SFCPackUpdater : public Updater
@@ -67,10 +78,25 @@ class PYBIND11_EXPORT SFCPackUpdater : public Updater
             m_grid = (unsigned int)pow(2.0, ceil(log(double(grid)) / log(2.0)));;
             }
 
+        //! Set the growth of the locality that triggers a sort
+        /*! \param threshold Sort when the locality exceeds  threshold times its value after the last sort, 0 sorts
+                             on every call
+        */
+        void setLocalityThreshold(Scalar threshold)
+            {
+            m_locality_threshold = threshold;
+            m_sorted_locality = Scalar(0.0);
+            }
+
+        //! Measure the locality of the particle order
+        Scalar getLocality();
+
     protected:
         unsigned int m_grid;        //!< Grid dimension to use
         unsigned int m_last_grid;   //!< The last value of MMax
         unsigned int m_last_dim;    //!< Check the last dimension we ran at
+        Scalar m_locality_threshold;    //!< Growth of the locality that triggers a sort (0 to always sort)
+        Scalar m_sorted_locality;       //!< Locality measured after the last sort (0 if not measured)
         GPUArray< unsigned int > m_traversal_order;      //!< Generated traversal order of bins
 
         //! Helper function that actually performs the sort
@@ -90,9 +116,16 @@ class PYBIND11_EXPORT SFCPackUpdater : public Updater
         //! Reallocate internal arrays
         virtual void reallocate();
 
+        //! Get the number of chunks to process in parallel
+        unsigned int getNumChunks(unsigned int N) const;
+
+        //! Sort the binned particles and generate the sort order
+        void sortParticleBins(unsigned int N, unsigned int n_bins);
+
     private:
         std::vector<unsigned int> m_sort_order;             //!< Generated sort order of the particles
         std::vector< std::pair<unsigned int, unsigned int> > m_particle_bins;    //!< Binned particles
+        std::vector< std::pair<unsigned int, unsigned int> > m_particle_bins_alt;    //!< Binned particles (radix sort buffer)
 
    };
 
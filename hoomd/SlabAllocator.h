@@ -0,0 +1,205 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: jglaser
+
+/*! \file SlabAllocator.h
+    \brief Declares an allocator that serves small arrays from large slabs
+*/
+
+#ifndef __SLAB_ALLOCATOR_H__
+#define __SLAB_ALLOCATOR_H__
+
+#ifdef ENABLE_CUDA
+#include <cuda_runtime.h>
+
+#include "MemoryTraceback.h"
+
+#include <vector>
+#include <string>
+#include <stdexcept>
+#include <cstddef>
+#include <cassert>
+
+//! Sub-allocator for small GPUArray and GlobalArray allocations
+/*! Every cudaMalloc, cudaMallocManaged or cudaHostRegister call has a latency of its own, and the driver rounds every
+    allocation up to its page size. Many arrays are tiny (per-type parameter tables, flags), so SlabAllocator serves all
+    requests of up to max_bytes from slabs of slab_bytes each, one allocator per kind of memory.
+
+    Requests are rounded up to a power-of-two size class of at least min_bytes. Every slab is split into chunks of a
+    single size class, and a chunk is aligned to its size. Freed chunks are kept in a free list per size class and reused,
+    the slabs are released only when the allocator is destroyed.
+
+    The number of slabs and bytes in use can be queried, and new slabs are registered with the MemoryTraceback.
+*/
+class __attribute__((visibility("default"))) SlabAllocator
+    {
+    public:
+        //! The kind of memory managed by the allocator
+        enum memory_type
+            {
+            host_pinned,    //!< Page-locked host memory (cudaHostAlloc)
+            device,         //!< Device memory (cudaMalloc)
+            managed         //!< Managed memory (cudaMallocManaged)
+            };
+
+        //! Largest allocation size served from a slab
+        enum { max_bytes = 4096 };
+
+        //! Smallest size class, and minimum alignment of a chunk
+        enum { min_bytes = 32 };
+
+        //! Size of a slab
+        enum { slab_bytes = 1 << 18 };
+
+        //! Constructor
+        /*! \param type Kind of memory to allocate
+         */
+        SlabAllocator(memory_type type)
+            : m_type(type), m_bytes_used(0), m_free(getSizeClass(max_bytes)+1)
+            { }
+
+        SlabAllocator(const SlabAllocator&) = delete;
+        SlabAllocator& operator=(const SlabAllocator&) = delete;
+
+        //! Destructor
+        ~SlabAllocator()
+            {
+            for (auto slab : m_slabs)
+                {
+                if (m_type == host_pinned)
+                    cudaFreeHost(slab);
+                else
+                    cudaFree(slab);
+                }
+            }
+
+        //! Test whether an allocation can be served by the allocator
+        /*! \param nbytes Size of the allocation
+            \param align Required alignment (or 0)
+         */
+        static bool isSmall(size_t nbytes, size_t align=0)
+            {
+            return nbytes > 0 && nbytes <= max_bytes && align <= max_bytes;
+            }
+
+        //! Allocate a chunk
+        /*! \param nbytes Size of the allocation
+            \param align Required alignment (or 0)
+            \param tracer If not null, new slabs are registered with the memory tracer
+            \returns Pointer to a chunk of at least \a nbytes bytes, aligned to max(\a align, min_bytes)
+         */
+        void *allocate(size_t nbytes, size_t align=0, const MemoryTraceback *tracer=nullptr)
+            {
+            assert(isSmall(nbytes, align));
+
+            unsigned int size_class = getSizeClass(nbytes > align ? nbytes : align);
+            size_t chunk_bytes = getChunkBytes(size_class);
+
+            std::vector<void *>& free_list = m_free[size_class];
+            if (free_list.empty())
+                {
+                char *slab = reinterpret_cast<char *>(allocateSlab(tracer));
+
+                // split the slab into chunks, in reverse order so the first chunk is handed out first
+                for (size_t offset = slab_bytes; offset >= chunk_bytes; offset -= chunk_bytes)
+                    free_list.push_back(slab + offset - chunk_bytes);
+                }
+
+            void *ptr = free_list.back();
+            free_list.pop_back();
+
+            m_bytes_used += chunk_bytes;
+            return ptr;
+            }
+
+        //! Return a chunk to the allocator
+        /*! \param ptr Pointer returned by allocate()
+            \param nbytes Size of the allocation
+            \param align Alignment of the allocation
+         */
+        void deallocate(void *ptr, size_t nbytes, size_t align=0)
+            {
+            unsigned int size_class = getSizeClass(nbytes > align ? nbytes : align);
+            m_free[size_class].push_back(ptr);
+            m_bytes_used -= getChunkBytes(size_class);
+            }
+
+        //! Get the number of bytes handed out in chunks
+        size_t getBytesUsed() const
+            {
+            return m_bytes_used;
+            }
+
+        //! Get the number of bytes allocated in slabs
+        size_t getBytesReserved() const
+            {
+            return m_slabs.size()*size_t(slab_bytes);
+            }
+
+        //! Get the number of slabs
+        unsigned int getNumSlabs() const
+            {
+            return m_slabs.size();
+            }
+
+    private:
+        memory_type m_type;                            //!< Kind of memory
+        size_t m_bytes_used;                           //!< Bytes in chunks handed out
+        std::vector< std::vector<void *> > m_free;     //!< Free chunks per size class
+        std::vector<void *> m_slabs;                   //!< All slabs
+
+        //! Get the smallest size class holding a number of bytes
+        static unsigned int getSizeClass(size_t nbytes)
+            {
+            unsigned int size_class = 0;
+            while (getChunkBytes(size_class) < nbytes)
+                size_class++;
+            return size_class;
+            }
+
+        //! Get the chunk size of a size class
+        static size_t getChunkBytes(unsigned int size_class)
+            {
+            return size_t(min_bytes) << size_class;
+            }
+
+        //! Allocate a new slab
+        void *allocateSlab(const MemoryTraceback *tracer)
+            {
+            void *slab = nullptr;
+            cudaError_t err;
+            std::string name;
+            if (m_type == host_pinned)
+                {
+                err = cudaHostAlloc(&slab, slab_bytes, cudaHostAllocDefault);
+                name = "pinned host slabs";
+                }
+            else if (m_type == device)
+                {
+                err = cudaMalloc(&slab, slab_bytes);
+                name = "device slabs";
+                }
+            else
+                {
+                err = cudaMallocManaged(&slab, slab_bytes, cudaMemAttachGlobal);
+                name = "managed slabs";
+                }
+
+            if (err != cudaSuccess)
+                {
+                throw std::runtime_error("CUDA Error in SlabAllocator "+std::string(cudaGetErrorString(err)));
+                }
+
+            m_slabs.push_back(slab);
+
+            if (tracer)
+                tracer->registerSlab(slab, slab_bytes, name);
+
+            return slab;
+            }
+    };
+
+#endif // ENABLE_CUDA
+#endif // __SLAB_ALLOCATOR_H__
@@ -47,6 +47,56 @@ void SnapshotSystemData<Real>::replicate(unsigned int nx, unsigned int ny, unsig
         pair_data.replicate(n,old_n);
     }
 
+#ifdef ENABLE_MPI
+template <class Real>
+void SnapshotSystemData<Real>::replicateDistributed(unsigned int nx, unsigned int ny, unsigned int nz,
+    std::shared_ptr<DomainDecomposition> decomposition,
+    std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    assert(nx > 0);
+    assert(ny > 0);
+    assert(nz > 0);
+
+    // the (small) system to replicate is needed on every rank
+    MPI_Comm mpi_comm = exec_conf->getMPICommunicator();
+    bcast(global_box, 0, mpi_comm);
+    bcast(dimensions, 0, mpi_comm);
+    bcast(has_particle_data, 0, mpi_comm);
+    particle_data.bcast(0, mpi_comm);
+
+    // Update global box
+    BoxDim old_box = global_box;
+    Scalar3 L = global_box.getL();
+    L.x *= (Scalar) nx;
+    L.y *= (Scalar) ny;
+    L.z *= (Scalar) nz;
+    global_box.setL(L);
+
+    unsigned int old_n = particle_data.size;
+    unsigned int n = nx * ny *nz;
+
+    if (has_particle_data)
+        particle_data.replicateDistributed(nx, ny, nz, old_box, global_box, decomposition, exec_conf->getRank());
+
+    // topology is only read on the root rank
+    if (exec_conf->getRank() == 0)
+        {
+        if (has_bond_data)
+            bond_data.replicate(n,old_n);
+        if (has_angle_data)
+            angle_data.replicate(n,old_n);
+        if (has_dihedral_data)
+            dihedral_data.replicate(n,old_n);
+        if (has_improper_data)
+            improper_data.replicate(n,old_n);
+        if (has_constraint_data)
+            constraint_data.replicate(n,old_n);
+        if (has_pair_data)
+            pair_data.replicate(n,old_n);
+        }
+    }
+#endif
+
 template <class Real>
 void SnapshotSystemData<Real>::broadcast_box(std::shared_ptr<ExecutionConfiguration> exec_conf)
     {
@@ -145,6 +195,9 @@ void export_SnapshotSystemData(py::module& m)
     .def_readonly("constraints", &SnapshotSystemData<float>::constraint_data)
     .def_readonly("pairs", &SnapshotSystemData<float>::pair_data)
     .def("replicate", &SnapshotSystemData<float>::replicate)
+    #ifdef ENABLE_MPI
+    .def("_replicate_distributed", &SnapshotSystemData<float>::replicateDistributed)
+    #endif
     .def("_broadcast_box", &SnapshotSystemData<float>::broadcast_box)
     .def("_broadcast", &SnapshotSystemData<float>::broadcast)
     .def("_broadcast_all", &SnapshotSystemData<float>::broadcast_all)
@@ -162,6 +215,9 @@ void export_SnapshotSystemData(py::module& m)
     .def_readonly("constraints", &SnapshotSystemData<double>::constraint_data)
     .def_readonly("pairs", &SnapshotSystemData<double>::pair_data)
     .def("replicate", &SnapshotSystemData<double>::replicate)
+    #ifdef ENABLE_MPI
+    .def("_replicate_distributed", &SnapshotSystemData<double>::replicateDistributed)
+    #endif
     .def("_broadcast_box", &SnapshotSystemData<double>::broadcast_box)
     .def("_broadcast", &SnapshotSystemData<double>::broadcast)
     .def("_broadcast_all", &SnapshotSystemData<double>::broadcast_all)
@@ -87,6 +87,22 @@ struct SnapshotSystemData {
      */
     void replicate(unsigned int nx, unsigned int ny, unsigned int nz);
 
+    #ifdef ENABLE_MPI
+    // Replicate the system along three spatial dimensions into a distributed snapshot
+    /*! \param nx Number of times to replicate the system along the x direction
+     *  \param ny Number of times to replicate the system along the y direction
+     *  \param nz Number of times to replicate the system along the z direction
+     *  \param decomposition Domain decomposition of the replicated box
+     *  \param exec_conf The execution configuration
+     *
+     *  The system to replicate is read on rank 0. Every rank generates only the replicas of the particles in its
+     *  own domain, the bonded groups are replicated on rank 0.
+     */
+    void replicateDistributed(unsigned int nx, unsigned int ny, unsigned int nz,
+        std::shared_ptr<DomainDecomposition> decomposition,
+        std::shared_ptr<ExecutionConfiguration> exec_conf);
+    #endif
+
     // Broadcast information from rank 0 to all ranks
     /*! \param exec_conf The execution configuration
         Broadcasts the box and other metadata. Large particle data arrays are left on rank 0.
@@ -0,0 +1,343 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+/*! \file StreamAnalyzer.cc
+    \brief Defines the StreamAnalyzer class
+*/
+
+#include "StreamAnalyzer.h"
+
+#include "hoomd/extern/pybind/include/pybind11/stl.h"
+
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#include <stdexcept>
+#include <sstream>
+
+namespace py = pybind11;
+using namespace std;
+
+//! Size of the frame header in bytes
+static const size_t stream_header_size = 4 + 4 + 8 + 4 + 4 + 6*8;
+
+//! Size of the chunk header in bytes
+static const size_t stream_chunk_header_size = 16 + 4 + 4;
+
+//! Append \a size bytes at \a data to \a buf at \a offset and advance the offset
+static inline void pack_bytes(std::vector<char>& buf, size_t& offset, const void *data, size_t size)
+    {
+    memcpy(buf.data() + offset, data, size);
+    offset += size;
+    }
+
+//! Append a zero padded string of \a size bytes to \a buf at \a offset and advance the offset
+static inline void pack_string(std::vector<char>& buf, size_t& offset, const std::string& s, size_t size)
+    {
+    memset(buf.data() + offset, 0, size);
+    memcpy(buf.data() + offset, s.c_str(), std::min(s.size(), size));
+    offset += size;
+    }
+
+/*! \param sysdef SystemDefinition containing the particle data to stream
+    \param fname File name of the stream
+    \param quantities Names of the quantities written in every frame
+    \param buffer_frames Number of frame buffers in the ring
+    \param drop True to drop frames when all buffers are in flight, false to block
+*/
+StreamAnalyzer::StreamAnalyzer(std::shared_ptr<SystemDefinition> sysdef,
+                               const std::string& fname,
+                               const std::vector<std::string>& quantities,
+                               unsigned int buffer_frames,
+                               bool drop)
+    : Analyzer(sysdef), m_fname(fname), m_drop(drop), m_dropped(0), m_file(NULL), m_writing(false),
+      m_writer_exit(false)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing StreamAnalyzer: " << fname << endl;
+
+    if (buffer_frames == 0)
+        {
+        m_exec_conf->msg->error() << "analyze.stream: buffer_frames must be positive" << endl;
+        throw runtime_error("Error initializing StreamAnalyzer");
+        }
+
+    for (auto const& q : quantities)
+        {
+        if (q == "position")
+            m_quantities.push_back(position);
+        else if (q == "velocity")
+            m_quantities.push_back(velocity);
+        else if (q == "net_force")
+            m_quantities.push_back(net_force);
+        else if (q == "image")
+            m_quantities.push_back(image);
+        else if (q == "tag")
+            m_quantities.push_back(tag);
+        else
+            {
+            m_exec_conf->msg->error() << "analyze.stream: unknown quantity " << q << endl;
+            throw runtime_error("Error initializing StreamAnalyzer");
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->getNRanks() > 1)
+        {
+        ostringstream s;
+        s << m_fname << "." << m_exec_conf->getRank();
+        m_fname = s.str();
+        }
+    #endif
+
+    m_free.resize(buffer_frames);
+    }
+
+StreamAnalyzer::~StreamAnalyzer()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying StreamAnalyzer" << endl;
+
+    // write out the queued frames
+    stopWriter();
+
+    if (m_file)
+        fclose(m_file);
+    }
+
+/*! \param timestep Current time step of the simulation
+    \param buf Output buffer, resized to the frame size
+*/
+void StreamAnalyzer::packFrame(unsigned int timestep, std::vector<char>& buf)
+    {
+    const unsigned int N = m_pdata->getN();
+
+    // determine the frame size first, the buffers keep their capacity between frames
+    size_t size = stream_header_size;
+    for (auto q : m_quantities)
+        {
+        size += stream_chunk_header_size;
+        if (q == tag)
+            size += sizeof(unsigned int)*N;
+        else if (q == image)
+            size += 3*sizeof(int)*N;
+        else
+            size += 3*sizeof(Scalar)*N;
+        }
+    buf.resize(size);
+
+    size_t offset = 0;
+    pack_string(buf, offset, "HFRM", 4);
+    uint32_t n_chunks = m_quantities.size();
+    pack_bytes(buf, offset, &n_chunks, sizeof(uint32_t));
+    uint64_t step = timestep;
+    pack_bytes(buf, offset, &step, sizeof(uint64_t));
+    uint32_t n = N;
+    pack_bytes(buf, offset, &n, sizeof(uint32_t));
+    uint32_t rank = m_exec_conf->getRank();
+    pack_bytes(buf, offset, &rank, sizeof(uint32_t));
+
+    const BoxDim& box = m_pdata->getGlobalBox();
+    Scalar3 L = box.getL();
+    double box_data[6] = {L.x, L.y, L.z, box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ()};
+    pack_bytes(buf, offset, box_data, sizeof(box_data));
+
+    const std::string scalar_type = (sizeof(Scalar) == 4) ? "f4" : "f8";
+    uint32_t three = 3;
+    uint32_t one = 1;
+
+    for (auto q : m_quantities)
+        {
+        if (q == position || q == velocity || q == net_force)
+            {
+            const GlobalArray<Scalar4>& array = (q == position) ? m_pdata->getPositions() :
+                                                (q == velocity) ? m_pdata->getVelocities() : m_pdata->getNetForce();
+            const char *name = (q == position) ? "position" : (q == velocity) ? "velocity" : "net_force";
+
+            pack_string(buf, offset, name, 16);
+            pack_string(buf, offset, scalar_type, 4);
+            pack_bytes(buf, offset, &three, sizeof(uint32_t));
+
+            // strip the w component
+            ArrayHandle<Scalar4> h_array(array, access_location::host, access_mode::read);
+            Scalar *dst = (Scalar *)(buf.data() + offset);
+            for (unsigned int i = 0; i < N; i++)
+                {
+                dst[3*i] = h_array.data[i].x;
+                dst[3*i+1] = h_array.data[i].y;
+                dst[3*i+2] = h_array.data[i].z;
+                }
+            offset += 3*sizeof(Scalar)*N;
+            }
+        else if (q == image)
+            {
+            pack_string(buf, offset, "image", 16);
+            pack_string(buf, offset, "i4", 4);
+            pack_bytes(buf, offset, &three, sizeof(uint32_t));
+
+            ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+            int *dst = (int *)(buf.data() + offset);
+            for (unsigned int i = 0; i < N; i++)
+                {
+                dst[3*i] = h_image.data[i].x;
+                dst[3*i+1] = h_image.data[i].y;
+                dst[3*i+2] = h_image.data[i].z;
+                }
+            offset += 3*sizeof(int)*N;
+            }
+        else
+            {
+            pack_string(buf, offset, "tag", 16);
+            pack_string(buf, offset, "u4", 4);
+            pack_bytes(buf, offset, &one, sizeof(uint32_t));
+
+            ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+            pack_bytes(buf, offset, h_tag.data, sizeof(unsigned int)*N);
+            }
+        }
+    }
+
+/*! \param timestep Current time step of the simulation
+
+    analyze() takes a free frame buffer from the ring, copies the frame into it and queues it for the writer thread.
+    When no buffer is free, the frame is dropped or analyze() waits for the writer thread.
+*/
+void StreamAnalyzer::analyze(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push("Stream");
+
+    std::vector<char> buf;
+        {
+        std::unique_lock<std::mutex> lock(m_writer_mutex);
+        checkError();
+
+        if (m_free.empty())
+            {
+            if (m_drop)
+                {
+                m_dropped++;
+                m_exec_conf->msg->notice(6) << "analyze.stream: dropping frame at step " << timestep << endl;
+                if (m_prof)
+                    m_prof->pop();
+                return;
+                }
+
+            m_writer_cv.wait(lock, [this] { return !m_free.empty() || !m_writer_error.empty(); });
+            checkError();
+            }
+
+        buf.swap(m_free.back());
+        m_free.pop_back();
+        }
+
+    // copy the arrays without holding the lock
+    packFrame(timestep, buf);
+
+    // the writer thread is started on the first frame
+    if (!m_writer_thread.joinable())
+        {
+        m_writer_exit = false;
+        m_writer_thread = std::thread(&StreamAnalyzer::writerThread, this);
+        }
+
+        {
+        std::lock_guard<std::mutex> lock(m_writer_mutex);
+        m_queue.push_back(std::move(buf));
+        }
+    m_writer_cv.notify_all();
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! Blocks until the writer thread has written all queued frames to the sink.
+*/
+void StreamAnalyzer::flush()
+    {
+    std::unique_lock<std::mutex> lock(m_writer_mutex);
+    if (!m_writer_thread.joinable())
+        return;
+
+    m_writer_cv.wait(lock, [this] { return (m_queue.empty() && !m_writing) || !m_writer_error.empty(); });
+    checkError();
+    }
+
+void StreamAnalyzer::checkError()
+    {
+    if (!m_writer_error.empty())
+        {
+        m_exec_conf->msg->error() << "analyze.stream: " << m_writer_error << endl;
+        throw runtime_error("Error writing stream");
+        }
+    }
+
+void StreamAnalyzer::stopWriter()
+    {
+    if (!m_writer_thread.joinable())
+        return;
+
+        {
+        std::lock_guard<std::mutex> lock(m_writer_mutex);
+        m_writer_exit = true;
+        }
+    m_writer_cv.notify_all();
+    m_writer_thread.join();
+    }
+
+/*! The writer thread opens the sink on the first frame, then writes the queued frames in order and returns their
+    buffers to the ring. The loop exits when m_writer_exit is set and the queue is empty, or on the first error.
+*/
+void StreamAnalyzer::writerThread()
+    {
+    std::unique_lock<std::mutex> lock(m_writer_mutex);
+    while (true)
+        {
+        m_writer_cv.wait(lock, [this] { return !m_queue.empty() || m_writer_exit; });
+
+        if (m_queue.empty())
+            break;
+
+        std::vector<char> buf = std::move(m_queue.front());
+        m_queue.pop_front();
+        m_writing = true;
+
+        // perform the I/O without holding the lock
+        lock.unlock();
+        std::string error;
+        if (!m_file)
+            {
+            // opening a FIFO blocks until the consumer connects
+            m_file = fopen(m_fname.c_str(), "wb");
+            if (!m_file)
+                error = "cannot open " + m_fname + ": " + strerror(errno);
+            }
+
+        if (m_file)
+            {
+            if (fwrite(&buf[0], 1, buf.size(), m_file) != buf.size() || fflush(m_file) != 0)
+                error = "cannot write to " + m_fname + ": " + strerror(errno);
+            }
+        lock.lock();
+
+        m_free.push_back(std::move(buf));
+        m_writing = false;
+        if (!error.empty())
+            m_writer_error = error;
+        m_writer_cv.notify_all();
+
+        if (!error.empty())
+            break;
+        }
+    }
+
+void export_StreamAnalyzer(py::module& m)
+    {
+    py::class_<StreamAnalyzer, std::shared_ptr<StreamAnalyzer> >(m, "StreamAnalyzer", py::base<Analyzer>())
+    .def(py::init< std::shared_ptr<SystemDefinition>, const std::string&, const std::vector<std::string>&,
+                   unsigned int, bool>())
+    .def("flush", &StreamAnalyzer::flush)
+    .def("getDroppedFrames", &StreamAnalyzer::getDroppedFrames)
+    ;
+    }
@@ -0,0 +1,130 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+/*! \file StreamAnalyzer.h
+    \brief Declares the StreamAnalyzer class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __STREAM_ANALYZER_H__
+#define __STREAM_ANALYZER_H__
+
+#include "Analyzer.h"
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <cstdio>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+//! Streams frames of the local particle data to an external analysis process
+/*! StreamAnalyzer copies the selected per-particle arrays of the rank-local particles into a frame buffer and hands it
+    to a writer thread, which writes the frame to a file or named pipe (e.g. a FIFO in /dev/shm) read by a separate
+    analysis process. analyze() returns as soon as the arrays are copied, so the simulation does not wait for the
+    consumer.
+
+    The frame buffers form a ring of \a buffer_frames slots that are reused. When all slots are in flight because the
+    consumer is slower than the simulation, analyze() either drops the frame (and counts it) or blocks until the
+    writer thread returns a slot, depending on \a drop.
+
+    Each rank writes its own stream. In MPI simulations with more than one rank, the rank is appended to the file
+    name as a suffix (\c filename.rank). The sink is opened by the writer thread on the first frame, so opening a FIFO
+    without a reader does not block the simulation.
+
+    Every frame starts with a header:
+     - char[4] magic "HFRM"
+     - uint32 number of chunks
+     - uint64 time step
+     - uint32 number of particles N
+     - uint32 rank
+     - float64[6] box Lx, Ly, Lz, xy, xz, yz
+
+    followed by the chunks in the order of \a quantities:
+     - char[16] name (zero padded)
+     - char[4] type code, "f4", "f8", "i4" or "u4" (zero padded)
+     - uint32 number of components per particle
+     - the N x components array in native byte order
+
+    Supported quantities are \c position, \c velocity, \c net_force (all three components in Scalar precision),
+    \c image and \c tag.
+
+    \ingroup analyzers
+*/
+class PYBIND11_EXPORT StreamAnalyzer : public Analyzer
+    {
+    public:
+        //! Construct the stream analyzer
+        StreamAnalyzer(std::shared_ptr<SystemDefinition> sysdef,
+                       const std::string& fname,
+                       const std::vector<std::string>& quantities,
+                       unsigned int buffer_frames,
+                       bool drop);
+
+        //! Destructor
+        ~StreamAnalyzer();
+
+        //! Copy the current frame and queue it for the writer thread
+        void analyze(unsigned int timestep);
+
+        //! Block until all queued frames are written
+        void flush();
+
+        //! Get the number of frames dropped because all buffer slots were in flight
+        unsigned int getDroppedFrames() const
+            {
+            return m_dropped;
+            }
+
+    private:
+        //! A quantity to stream
+        enum quantity
+            {
+            position = 0,
+            velocity,
+            net_force,
+            image,
+            tag
+            };
+
+        std::string m_fname;                        //!< File name of this rank's stream
+        std::vector<quantity> m_quantities;         //!< Quantities written in every frame
+        const bool m_drop;                          //!< True to drop frames when the ring is full
+        unsigned int m_dropped;                     //!< Number of dropped frames
+        FILE *m_file;                               //!< Output stream, owned by the writer thread
+
+        std::vector< std::vector<char> > m_free;    //!< Frame buffers available to analyze()
+        std::deque< std::vector<char> > m_queue;    //!< Frame buffers waiting for the writer thread
+        bool m_writing;                             //!< True while the writer thread writes a frame
+        bool m_writer_exit;                         //!< Set to true to stop the writer thread
+        std::string m_writer_error;                 //!< Error message of the writer thread, empty if none
+        std::thread m_writer_thread;                //!< The writer thread
+        std::mutex m_writer_mutex;                  //!< Protects the buffers and the writer state
+        std::condition_variable m_writer_cv;        //!< Signals changes of the writer state
+
+        //! Pack the current frame into \a buf
+        void packFrame(unsigned int timestep, std::vector<char>& buf);
+
+        //! Throw the error reported by the writer thread, if any. The lock must be held.
+        void checkError();
+
+        //! Stop and join the writer thread
+        void stopWriter();
+
+        //! Main loop of the writer thread
+        void writerThread();
+    };
+
+//! Exports the StreamAnalyzer class to python
+void export_StreamAnalyzer(pybind11::module& m);
+
+#endif
@@ -11,13 +11,16 @@
 
 #include "System.h"
 #include "SignalHandler.h"
+#include "Autotuner.h"
 
 #ifdef ENABLE_MPI
 #include "Communicator.h"
 #endif
 
 // #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+#include <algorithm>
 #include <stdexcept>
+#include <sstream>
 #include <time.h>
 
 using namespace std;
@@ -33,9 +36,10 @@ PyObject* walltimeLimitExceptionTypeObj = 0;
     statistics are printed every 10 seconds.
 */
 System::System(std::shared_ptr<SystemDefinition> sysdef, unsigned int initial_tstep)
-        : m_sysdef(sysdef), m_start_tstep(initial_tstep), m_end_tstep(0), m_cur_tstep(initial_tstep), m_cur_tps(0),
+        : m_sysdef(sysdef), m_start_tstep(initial_tstep), m_end_tstep(0), m_cur_tstep(initial_tstep), m_sim_time(0.0),
+        m_cur_tps(0),
         m_med_tps(0), m_last_status_time(0), m_last_status_tstep(initial_tstep), m_quiet_run(false),
-        m_profile(false), m_stats_period(10)
+        m_profile(false), m_profile_counters(false), m_peak_flops(0.0), m_peak_bandwidth(0.0), m_stats_period(10)
     {
     // sanity check
     assert(m_sysdef);
@@ -93,6 +97,11 @@ void System::addAnalyzer(std::shared_ptr<Analyzer> analyzer, const std::string&
 
     // if we get here, we can add it
     m_analyzers.push_back(analyzer_item(analyzer, name, period, m_cur_tstep, start_step));
+    m_analyzers.back().m_metric_time = m_exec_conf->getMetrics()->registerMetric("hoomd_analyzer_seconds",
+                                                                                 "analyzer=\"" + name + "\"",
+                                                                                 "Wall clock time spent in the analyzer",
+                                                                                 Metrics::counter,
+                                                                                 Metrics::sum);
     }
 
 /*! \param name Name of the Analyzer to find in m_analyzers
@@ -163,6 +172,24 @@ void System::setAnalyzerPeriodVariable(const std::string& name, py::object updat
     i->setVariablePeriod(update_func, m_cur_tstep);
     }
 
+/*! \param name Name of the Analyzer to modify
+    \param time_period Simulation time between two calls to Analyzer::analyze()
+
+    The analyzer executes on the current step, then on the first step that reaches every further multiple of
+    \a time_period. This keeps the output spaced evenly in time when the time step changes during a run.
+*/
+void System::setAnalyzerPeriodTime(const std::string& name, Scalar time_period)
+    {
+    if (time_period <= Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "The period in simulation time must be positive" << endl;
+        throw runtime_error("Error setting analyzer period");
+        }
+
+    vector<System::analyzer_item>::iterator i = findAnalyzerItem(name);
+    i->setTimePeriod(time_period, m_cur_tstep, m_sim_time);
+    }
+
 
 /*! \param name Name of the Analyzer to get the period of
     \returns Period of the Analyzer
@@ -241,6 +268,11 @@ void System::addUpdater(std::shared_ptr<Updater> updater, const std::string& nam
 
     // if we get here, we can add it
     m_updaters.push_back(updater_item(updater, name, period, m_cur_tstep, start_step));
+    m_updaters.back().m_metric_time = m_exec_conf->getMetrics()->registerMetric("hoomd_updater_seconds",
+                                                                                "updater=\"" + name + "\"",
+                                                                                "Wall clock time spent in the updater",
+                                                                                Metrics::counter,
+                                                                                Metrics::sum);
     }
 
 /*! \param name Name of the Updater to be removed
@@ -291,6 +323,23 @@ void System::setUpdaterPeriodVariable(const std::string& name, py::object update
     i->setVariablePeriod(update_func, m_cur_tstep);
     }
 
+/*! \param name Name of the Updater to modify
+    \param time_period Simulation time between two calls to Updater::update()
+
+    See setAnalyzerPeriodTime().
+*/
+void System::setUpdaterPeriodTime(const std::string& name, Scalar time_period)
+    {
+    if (time_period <= Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "The period in simulation time must be positive" << endl;
+        throw runtime_error("Error setting updater period");
+        }
+
+    vector<System::updater_item>::iterator i = findUpdaterItem(name);
+    i->setTimePeriod(time_period, m_cur_tstep, m_sim_time);
+    }
+
 /*! \param name Name of the Updater to get the period of
     \returns Period of the Updater
 */
@@ -318,7 +367,10 @@ void System::addCompute(std::shared_ptr<Compute> compute, const std::string& nam
     // check if the name is unique
     map< string, std::shared_ptr<Compute> >::iterator i = m_computes.find(name);
     if (i == m_computes.end())
+        {
         m_computes[name] = compute;
+        compute->setMetricsName(name);
+        }
     else
         {
         m_exec_conf->msg->error() << "Compute " << name << " already exists" << endl;
@@ -432,6 +484,9 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
     m_last_status_time = initial_time;
     setupProfiling();
 
+    // select the autotuner cache entries for the current system size
+    Autotuner::setProblemSize(m_sysdef->getParticleData()->getN());
+
     // preset the flags before the run loop so that any analyzers/updaters run on step 0 have the info they need
     // but set the flags before prepRun, as prepRun may remove some flags that it cannot generate on the first step
     m_sysdef->getParticleData()->setFlags(determineFlags(m_cur_tstep));
@@ -483,14 +538,32 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
         m_integrator->prepRun(m_cur_tstep);
         }
 
+    // steps between events only execute the integrator, events are the steps on which an analyzer, updater, the
+    // python callback or a time limit check is scheduled
+    bool has_callback = callback != py::none() && cb_frequency > 0;
+    bool check_limits = limit_hours != 0.0f || walltime_stop != NULL;
+    unsigned int next_event_tstep = m_cur_tstep;
+
+    // live metrics of the run
+    Metrics *metrics = m_exec_conf->getMetrics();
+    const unsigned int metric_timesteps = metrics->registerMetric("hoomd_timesteps", "",
+        "Number of time steps run", Metrics::counter, Metrics::max);
+    const unsigned int metric_integrator_time = metrics->registerMetric("hoomd_integrator_seconds", "",
+        "Wall clock time spent in the integrator", Metrics::counter, Metrics::sum);
+
     // handle time steps
     for ( ; m_cur_tstep < m_end_tstep; m_cur_tstep++)
         {
         // check the clock and output a status line if needed
         uint64_t cur_time = m_clk.getTime();
 
+        if (m_profiler)
+            m_profiler->setTimestep(m_cur_tstep);
+
+        bool event = m_cur_tstep == next_event_tstep;
+
         // check if the time limit has exceeded
-        if (limit_hours != 0.0f)
+        if (event && limit_hours != 0.0f)
             {
             if (m_cur_tstep % limit_multiple == 0)
                 {
@@ -517,7 +590,7 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
             }
 
         // check if wall clock time limit has passed
-        if (walltime_stop != NULL)
+        if (event && walltime_stop != NULL)
             {
             if (m_cur_tstep % limit_multiple == 0)
                 {
@@ -551,7 +624,7 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
 
         // execute python callback, if present and needed
         // a negative return value indicates immediate end of run.
-        if (callback != py::none() && (cb_frequency > 0) && (m_cur_tstep % cb_frequency == 0))
+        if (event && has_callback && (m_cur_tstep % cb_frequency == 0))
             {
             py::object rv = callback(m_cur_tstep);
             if (rv != py::none())
@@ -581,29 +654,61 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
             #endif
             }
 
-        // execute analyzers
-        vector<analyzer_item>::iterator analyzer;
-        for (analyzer =  m_analyzers.begin(); analyzer != m_analyzers.end(); ++analyzer)
+        if (event)
             {
-            if (analyzer->shouldExecute(m_cur_tstep))
-                analyzer->m_analyzer->analyze(m_cur_tstep);
-            }
+            // execute analyzers
+            vector<analyzer_item>::iterator analyzer;
+            for (analyzer =  m_analyzers.begin(); analyzer != m_analyzers.end(); ++analyzer)
+                {
+                if (analyzer->shouldExecute(m_cur_tstep))
+                    {
+                    uint64_t start_time = m_clk.getTime();
+                    analyzer->m_analyzer->analyze(m_cur_tstep);
+                    metrics->add(analyzer->m_metric_time, double(m_clk.getTime() - start_time)*1e-9);
+                    }
+                }
 
-        // execute updaters
-        vector<updater_item>::iterator updater;
-        for (updater =  m_updaters.begin(); updater != m_updaters.end(); ++updater)
-            {
-            if (updater->shouldExecute(m_cur_tstep))
-                updater->m_updater->update(m_cur_tstep);
+            // execute updaters
+            vector<updater_item>::iterator updater;
+            for (updater =  m_updaters.begin(); updater != m_updaters.end(); ++updater)
+                {
+                if (updater->shouldExecute(m_cur_tstep))
+                    {
+                    uint64_t start_time = m_clk.getTime();
+                    updater->m_updater->update(m_cur_tstep);
+                    metrics->add(updater->m_metric_time, double(m_clk.getTime() - start_time)*1e-9);
+                    }
+                }
+
+            // schedule the next event after the analyzers and updaters have advanced their periods
+            next_event_tstep = determineNextEvent(m_cur_tstep+1, has_callback ? cb_frequency : 0,
+                check_limits ? limit_multiple : 0);
             }
 
+        // the time step is known before the integrator runs, so the items with periods in simulation time that
+        // are due at the end of this step can be scheduled on the next one
+        if (m_integrator && scheduleTimePeriods(m_cur_tstep+1, m_sim_time + m_integrator->getDeltaT()))
+            next_event_tstep = std::min(next_event_tstep, m_cur_tstep+1);
+
         // look ahead to the next time step and see which analyzers and updaters will be executed
         // or together all of their requested PDataFlags to determine the flags to set for this time step
-        m_sysdef->getParticleData()->setFlags(determineFlags(m_cur_tstep+1));
+        // the flags only change after an event step or before the next one
+        if (event || next_event_tstep == m_cur_tstep+1)
+            m_sysdef->getParticleData()->setFlags(determineFlags(m_cur_tstep+1));
 
         // execute the integrator
         if (m_integrator)
+            {
+            // an adaptive integrator changes its time step at the end of update()
+            Scalar deltaT = m_integrator->getDeltaT();
+
+            uint64_t start_time = m_clk.getTime();
             m_integrator->update(m_cur_tstep);
+            metrics->add(metric_integrator_time, double(m_clk.getTime() - start_time)*1e-9);
+
+            m_sim_time += deltaT;
+            }
+        metrics->add(metric_timesteps, 1.0);
 
         // quit if Ctrl-C was pressed
         if (g_sigint_recvd)
@@ -613,6 +718,11 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
             }
         }
 
+    // complete any pending output
+    vector<analyzer_item>::iterator analyzer;
+    for (analyzer = m_analyzers.begin(); analyzer != m_analyzers.end(); ++analyzer)
+        analyzer->m_analyzer->flush();
+
     // generate a final status line
     generateStatusLine();
     m_last_status_tstep = m_cur_tstep;
@@ -638,12 +748,32 @@ void System::run(unsigned int nsteps, unsigned int cb_frequency,
         m_exec_conf->msg->notice(1) << "Average TPS: " << m_last_TPS << endl;
 
     // write out the profile data
-    if (m_profiler)
+    if (m_profiler && m_profile)
         m_exec_conf->msg->notice(1) << *m_profiler;
 
+    // write out the timeline of this rank
+    if (m_profiler && !m_trace_file.empty())
+        {
+        std::string fname = m_trace_file;
+        #ifdef ENABLE_MPI
+        if (m_exec_conf->getNRanks() > 1)
+            {
+            std::ostringstream o;
+            o << m_trace_file << "." << m_exec_conf->getRank();
+            fname = o.str();
+            }
+        #endif
+        m_exec_conf->msg->notice(2) << "Writing trace to " << fname << endl;
+        m_profiler->writeTrace(fname, m_exec_conf->getRank());
+        }
+
     if (!m_quiet_run)
         printStats();
 
+    // save the tuned parameters for later jobs
+    if (!m_autotuner_cache.empty())
+        Autotuner::saveCache(m_autotuner_cache, m_exec_conf);
+
     // throw a WalltimeLimitReached exception if we timed out, but only if the user is using the HOOMD_WALLTIME_STOP feature
     if (timeout_end_run && walltime_stop != NULL)
         {
@@ -659,6 +789,39 @@ void System::enableProfiler(bool enable)
     m_profile = enable;
     }
 
+/*! \param fname File to write a Chrome trace of every run to, or an empty string to disable tracing
+
+    In MPI simulations, each rank writes to \a fname followed by a period and the rank.
+*/
+void System::setTraceFile(const std::string& fname)
+    {
+    m_trace_file = fname;
+    }
+
+/*! \param counters Set to true to read the hardware performance counters in profiled runs
+    \param peak_flops Peak FLOP rate of the hardware (FLOP/s), 0 if unknown
+    \param peak_bandwidth Peak memory bandwidth of the hardware (B/s), 0 to use the bandwidth of the GPUs in GPU runs
+
+    The profile lists the achieved FLOP rate and bandwidth of each region as a fraction of the peak values.
+*/
+void System::setProfilerParams(bool counters, double peak_flops, double peak_bandwidth)
+    {
+    m_profile_counters = counters;
+    m_peak_flops = peak_flops;
+    m_peak_bandwidth = peak_bandwidth;
+    }
+
+/*! \param fname Autotuner cache file, or an empty string to disable the cache
+
+    The cache is read when the file name changes and written at the end of every run.
+*/
+void System::setAutotunerCache(const std::string& fname)
+    {
+    if (!fname.empty() && fname != m_autotuner_cache)
+        Autotuner::loadCache(fname, m_exec_conf);
+    m_autotuner_cache = fname;
+    }
+
 /*! \param logger Logger to register computes and updaters with
     All computes and updaters registered with the system are also registered with the logger.
 */
@@ -720,11 +883,34 @@ void System::setAutotunerParams(bool enabled, unsigned int period)
 
 void System::setupProfiling()
     {
-    if (m_profile)
+    if (m_profile || !m_trace_file.empty())
         m_profiler = std::shared_ptr<Profiler>(new Profiler("Simulation"));
     else
         m_profiler = std::shared_ptr<Profiler>();
 
+    if (m_profiler && !m_trace_file.empty())
+        m_profiler->enableTrace(m_exec_conf);
+
+    if (m_profiler && m_profile)
+        {
+        double peak_bandwidth = m_peak_bandwidth;
+        #ifdef ENABLE_CUDA
+        // memory clock in kHz, double data rate, bus width in bits
+        if (peak_bandwidth <= 0.0 && m_exec_conf->isCUDAEnabled())
+            {
+            for (unsigned int idev = 0; idev < m_exec_conf->getNumActiveGPUs(); ++idev)
+                {
+                cudaDeviceProp dev_prop = m_exec_conf->getDeviceProperties(idev);
+                peak_bandwidth += 2.0*double(dev_prop.memoryClockRate)*1e3*double(dev_prop.memoryBusWidth)/8.0;
+                }
+            }
+        #endif
+        m_profiler->setPeak(m_peak_flops, peak_bandwidth);
+
+        if (m_profile_counters)
+            m_profiler->enableCounters(m_exec_conf);
+        }
+
     // set the profiler on everything
     if (m_integrator)
         m_integrator->setProfiler(m_profiler);
@@ -780,6 +966,9 @@ void System::printStats()
     for (compute = m_computes.begin(); compute != m_computes.end(); ++compute)
         compute->second->printStats();
 
+    // output memory usage per subsystem
+    m_exec_conf->getMemoryUsage()->outputSummary(m_exec_conf->msg);
+
     // output memory trace information
     if (m_exec_conf->getMemoryTracer())
         m_exec_conf->getMemoryTracer()->outputTraces(m_exec_conf->msg);
@@ -879,6 +1068,81 @@ PDataFlags System::determineFlags(unsigned int tstep)
     return flags;
     }
 
+/*! \param tstep First time step to consider
+    \param cb_frequency Period of the python callback (0 if there is none)
+    \param limit_multiple Period of the time limit checks (0 if there are none)
+    \returns The first step at or after \a tstep on which an analyzer, updater, the callback or a time limit check is
+              scheduled, or the end of the run if there is none.
+
+    Items whose next execution step has already passed never execute, as in shouldExecute(). Variable period items
+    only know their next step, which is all that is needed because the schedule is recomputed on every event.
+*/
+unsigned int System::determineNextEvent(unsigned int tstep, unsigned int cb_frequency, unsigned int limit_multiple)
+    {
+    unsigned int next = m_end_tstep;
+
+    vector<analyzer_item>::iterator analyzer;
+    for (analyzer = m_analyzers.begin(); analyzer != m_analyzers.end(); ++analyzer)
+        {
+        if (analyzer->m_next_execute_tstep >= tstep)
+            next = std::min(next, analyzer->m_next_execute_tstep);
+        }
+
+    vector<updater_item>::iterator updater;
+    for (updater = m_updaters.begin(); updater != m_updaters.end(); ++updater)
+        {
+        if (updater->m_next_execute_tstep >= tstep)
+            next = std::min(next, updater->m_next_execute_tstep);
+        }
+
+    // round up to the next multiple of the periods, without overflowing at the end of the time step range
+    if (cb_frequency > 0)
+        next = (unsigned int)std::min(uint64_t(next), (uint64_t(tstep) + cb_frequency - 1) / cb_frequency * cb_frequency);
+    if (limit_multiple > 0)
+        next = (unsigned int)std::min(uint64_t(next), (uint64_t(tstep) + limit_multiple - 1) / limit_multiple * limit_multiple);
+
+    return next;
+    }
+
+/*! \param tstep Step to schedule the items on
+    \param time Simulation time reached at \a tstep
+    \returns true if any item was scheduled on \a tstep
+
+    An item is due when \a time reaches its next execution time, up to a relative tolerance of its period to absorb
+    the rounding of the summed time steps. Execution times that \a time passed are all skipped, so an item executes
+    at most once per step.
+*/
+bool System::scheduleTimePeriods(unsigned int tstep, double time)
+    {
+    bool scheduled = false;
+
+    vector<analyzer_item>::iterator analyzer;
+    for (analyzer = m_analyzers.begin(); analyzer != m_analyzers.end(); ++analyzer)
+        {
+        if (analyzer->m_time_period > Scalar(0.0) && time >= analyzer->m_next_time - 1e-6*analyzer->m_time_period)
+            {
+            while (analyzer->m_next_time <= time + 1e-6*analyzer->m_time_period)
+                analyzer->m_next_time += analyzer->m_time_period;
+            analyzer->m_next_execute_tstep = tstep;
+            scheduled = true;
+            }
+        }
+
+    vector<updater_item>::iterator updater;
+    for (updater = m_updaters.begin(); updater != m_updaters.end(); ++updater)
+        {
+        if (updater->m_time_period > Scalar(0.0) && time >= updater->m_next_time - 1e-6*updater->m_time_period)
+            {
+            while (updater->m_next_time <= time + 1e-6*updater->m_time_period)
+                updater->m_next_time += updater->m_time_period;
+            updater->m_next_execute_tstep = tstep;
+            scheduled = true;
+            }
+        }
+
+    return scheduled;
+    }
+
 //! Create a custom exception
 PyObject* createExceptionClass(py::module& m, const char* name, PyObject* baseTypeObj = PyExc_Exception)
     {
@@ -907,6 +1171,7 @@ void export_System(py::module& m)
     .def("getAnalyzer", &System::getAnalyzer)
     .def("setAnalyzerPeriod", &System::setAnalyzerPeriod)
     .def("setAnalyzerPeriodVariable", &System::setAnalyzerPeriodVariable)
+    .def("setAnalyzerPeriodTime", &System::setAnalyzerPeriodTime)
     .def("getAnalyzerPeriod", &System::getAnalyzerPeriod)
 
     .def("addUpdater", &System::addUpdater)
@@ -914,6 +1179,7 @@ void export_System(py::module& m)
     .def("getUpdater", &System::getUpdater)
     .def("setUpdaterPeriod", &System::setUpdaterPeriod)
     .def("setUpdaterPeriodVariable", &System::setUpdaterPeriodVariable)
+    .def("setUpdaterPeriodTime", &System::setUpdaterPeriodTime)
     .def("getUpdaterPeriod", &System::getUpdaterPeriod)
 
     .def("addCompute", &System::addCompute)
@@ -927,12 +1193,17 @@ void export_System(py::module& m)
     .def("registerLogger", &System::registerLogger)
     .def("setStatsPeriod", &System::setStatsPeriod)
     .def("setAutotunerParams", &System::setAutotunerParams)
+    .def("setAutotunerCache", &System::setAutotunerCache)
     .def("enableProfiler", &System::enableProfiler)
+    .def("setTraceFile", &System::setTraceFile)
+    .def("setProfilerParams", &System::setProfilerParams)
     .def("enableQuietRun", &System::enableQuietRun)
     .def("run", &System::run)
 
     .def("getLastTPS", &System::getLastTPS)
     .def("getCurrentTimeStep", &System::getCurrentTimeStep)
+    .def("getSimulationTime", &System::getSimulationTime)
+    .def("setSimulationTime", &System::setSimulationTime)
 #ifdef ENABLE_MPI
     .def("setCommunicator", &System::setCommunicator)
     .def("getCommunicator", &System::getCommunicator)
@@ -13,6 +13,7 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <climits>
 
 #ifndef __SYSTEM_H__
 #define __SYSTEM_H__
@@ -82,6 +83,9 @@ class PYBIND11_EXPORT System
         //! Change the period of an Analyzer to be variable
         void setAnalyzerPeriodVariable(const std::string& name, pybind11::object update_func);
 
+        //! Change the period of an Analyzer to an interval of simulation time
+        void setAnalyzerPeriodTime(const std::string& name, Scalar time_period);
+
         //! Get the period of an Analyzer
         unsigned int getAnalyzerPeriod(const std::string& name);
 
@@ -102,6 +106,9 @@ class PYBIND11_EXPORT System
         //! Change the period of an Updater to be variable
         void setUpdaterPeriodVariable(const std::string& name, pybind11::object update_func);
 
+        //! Change the period of an Updater to an interval of simulation time
+        void setUpdaterPeriodTime(const std::string& name, Scalar time_period);
+
         //! Get the period of on Updater
         unsigned int getUpdaterPeriod(const std::string& name);
 
@@ -150,6 +157,15 @@ class PYBIND11_EXPORT System
         //! Configures profiling of runs
         void enableProfiler(bool enable);
 
+        //! Configures the timeline trace of runs
+        void setTraceFile(const std::string& fname);
+
+        //! Configures the hardware counters and peak performance of profiled runs
+        void setProfilerParams(bool counters, double peak_flops, double peak_bandwidth);
+
+        //! Set the file to load and save tuned autotuner parameters
+        void setAutotunerCache(const std::string& fname);
+
         //! Toggle whether or not to print the status line and TPS for each run
         void enableQuietRun(bool enable)
             {
@@ -174,6 +190,20 @@ class PYBIND11_EXPORT System
             return m_cur_tstep;
             }
 
+        //! Get the simulation time
+        /*! \returns The sum of the time steps (Integrator::getDeltaT()) of all steps run so far
+        */
+        double getSimulationTime()
+            {
+            return m_sim_time;
+            }
+
+        //! Set the simulation time
+        void setSimulationTime(double time)
+            {
+            m_sim_time = time;
+            }
+
         // -------------- Misc methods
 
         //! Get the system definition
@@ -198,7 +228,7 @@ class PYBIND11_EXPORT System
             */
             analyzer_item(std::shared_ptr<Analyzer> analyzer, const std::string& name, unsigned int period,
                           unsigned int created_tstep, unsigned int next_execute_tstep)
-                    : m_analyzer(analyzer), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(next_execute_tstep), m_is_variable_period(false), m_n(1)
+                    : m_analyzer(analyzer), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(next_execute_tstep), m_is_variable_period(false), m_time_period(0), m_next_time(0), m_n(1)
                 {
                 }
 
@@ -231,6 +261,11 @@ class PYBIND11_EXPORT System
                         m_next_execute_tstep = next;
                         m_n++;
                         }
+                    else if (m_time_period > Scalar(0.0))
+                        {
+                        // System::scheduleTimePeriods() sets the step that reaches m_next_time
+                        m_next_execute_tstep = UINT_MAX;
+                        }
                     else
                         {
                         m_next_execute_tstep += m_period;
@@ -264,6 +299,7 @@ class PYBIND11_EXPORT System
                 m_period = period;
                 m_next_execute_tstep = tstep;
                 m_is_variable_period = false;
+                m_time_period = 0;
                 }
 
             //! Changes to a variable period
@@ -278,6 +314,23 @@ class PYBIND11_EXPORT System
                 m_update_func = update_func;
                 m_next_execute_tstep = tstep;
                 m_is_variable_period = true;
+                m_time_period = 0;
+                }
+
+            //! Changes to a period in simulation time
+            /*! \param time_period Simulation time between two executions
+                \param tstep current time step
+                \param time current simulation time
+
+                The item executes on \a tstep and then on the first step at or after every multiple of
+                \a time_period later than \a time.
+            */
+            void setTimePeriod(Scalar time_period, unsigned int tstep, double time)
+                {
+                m_time_period = time_period;
+                m_next_time = time + time_period;
+                m_next_execute_tstep = tstep;
+                m_is_variable_period = false;
                 }
 
             std::shared_ptr<Analyzer> m_analyzer; //!< The analyzer
@@ -286,6 +339,9 @@ class PYBIND11_EXPORT System
             unsigned int m_created_tstep;           //!< The timestep when the analyzer was added
             unsigned int m_next_execute_tstep;      //!< The next time step we will execute on
             bool m_is_variable_period;              //!< True if the variable period should be used
+            Scalar m_time_period;                   //!< Period in simulation time (0 if the period is in steps)
+            double m_next_time;                     //!< Next simulation time to execute at with m_time_period
+            unsigned int m_metric_time;             //!< ID of the metric of the time spent in the analyzer
 
             unsigned int m_n;                       //!< Current value of n for the variable period func
             pybind11::object m_update_func;    //!< Python lambda function to evaluate time steps to update at
@@ -305,7 +361,7 @@ class PYBIND11_EXPORT System
             */
             updater_item(std::shared_ptr<Updater> updater, const std::string& name, unsigned int period,
                          unsigned int created_tstep, unsigned int next_execute_tstep)
-                    : m_updater(updater), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(next_execute_tstep), m_is_variable_period(false), m_n(1)
+                    : m_updater(updater), m_name(name), m_period(period), m_created_tstep(created_tstep), m_next_execute_tstep(next_execute_tstep), m_is_variable_period(false), m_time_period(0), m_next_time(0), m_n(1)
                 {
                 }
 
@@ -338,6 +394,11 @@ class PYBIND11_EXPORT System
                         m_next_execute_tstep = next;
                         m_n++;
                         }
+                    else if (m_time_period > Scalar(0.0))
+                        {
+                        // System::scheduleTimePeriods() sets the step that reaches m_next_time
+                        m_next_execute_tstep = UINT_MAX;
+                        }
                     else
                         {
                         m_next_execute_tstep += m_period;
@@ -370,6 +431,7 @@ class PYBIND11_EXPORT System
                 m_period = period;
                 m_next_execute_tstep = tstep;
                 m_is_variable_period = false;
+                m_time_period = 0;
                 }
 
             //! Changes to a variable period
@@ -384,6 +446,23 @@ class PYBIND11_EXPORT System
                 m_update_func = update_func;
                 m_next_execute_tstep = tstep;
                 m_is_variable_period = true;
+                m_time_period = 0;
+                }
+
+            //! Changes to a period in simulation time
+            /*! \param time_period Simulation time between two executions
+                \param tstep current time step
+                \param time current simulation time
+
+                The item executes on \a tstep and then on the first step at or after every multiple of
+                \a time_period later than \a time.
+            */
+            void setTimePeriod(Scalar time_period, unsigned int tstep, double time)
+                {
+                m_time_period = time_period;
+                m_next_time = time + time_period;
+                m_next_execute_tstep = tstep;
+                m_is_variable_period = false;
                 }
 
             std::shared_ptr<Updater> m_updater;   //!< The analyzer
@@ -392,6 +471,9 @@ class PYBIND11_EXPORT System
             unsigned int m_created_tstep;           //!< The timestep when the analyzer was added
             unsigned int m_next_execute_tstep;      //!< The next time step we will execute on
             bool m_is_variable_period;              //!< True if the variable period should be used
+            Scalar m_time_period;                   //!< Period in simulation time (0 if the period is in steps)
+            double m_next_time;                     //!< Next simulation time to execute at with m_time_period
+            unsigned int m_metric_time;             //!< ID of the metric of the time spent in the updater
 
             unsigned int m_n;                       //!< Current value of n for the variable period func
             pybind11::object m_update_func;    //!< Python lambda function to evaluate time steps to update at
@@ -411,6 +493,7 @@ class PYBIND11_EXPORT System
         unsigned int m_start_tstep;     //!< Initial time step of the current run
         unsigned int m_end_tstep;       //!< Final time step of the current run
         unsigned int m_cur_tstep;       //!< Current time step
+        double m_sim_time;              //!< Simulation time, summed over the time steps of all steps run
         Scalar m_cur_tps;               //!< Current average TPS
         Scalar m_med_tps;               //!< Current median TPS
         std::vector<Scalar> m_tps_list; //!< vector containing the last 10 tps
@@ -421,6 +504,11 @@ class PYBIND11_EXPORT System
 
         bool m_quiet_run;       //!< True to suppress the status line and TPS from being printed to stdout for each run
         bool m_profile;         //!< True if runs should be profiled
+        std::string m_trace_file;   //!< File to write the timeline trace to (empty to disable tracing)
+        bool m_profile_counters;    //!< True if profiled runs read the hardware counters
+        double m_peak_flops;        //!< Peak FLOP rate of the hardware (FLOP/s), 0 if unknown
+        double m_peak_bandwidth;    //!< Peak memory bandwidth of the hardware (B/s), 0 to determine it for GPUs
+        std::string m_autotuner_cache;  //!< File to load and save the autotuner cache (empty to disable)
         unsigned int m_stats_period; //!< Number of seconds between statistics output lines
 
         // --------- Steps in the simulation run implemented in helper functions
@@ -439,6 +527,12 @@ class PYBIND11_EXPORT System
         //! Get the flags needed for a particular step
         PDataFlags determineFlags(unsigned int tstep);
 
+        //! Get the next step on which the run loop needs to do more than execute the integrator
+        unsigned int determineNextEvent(unsigned int tstep, unsigned int cb_frequency, unsigned int limit_multiple);
+
+        //! Schedule the analyzers and updaters with periods in simulation time that are due on a step
+        bool scheduleTimePeriods(unsigned int tstep, double time);
+
         // --------- Helper function for handling lists
         //! Search for an Analyzer by name
         std::vector<analyzer_item>::iterator findAnalyzerItem(const std::string &name);
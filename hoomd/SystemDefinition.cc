@@ -220,28 +220,34 @@ void SystemDefinition::initializeFromSnapshot(std::shared_ptr< SnapshotSystemDat
         bcast(m_n_dimensions, 0,exec_conf->getMPICommunicator());
     #endif
 
+    // when restoring a snapshot of the same system (same particles, types, and topology), overwrite the particle
+    // properties in place instead of re-initializing all data structures
+    bool in_place = true;
+
     if (snapshot->has_particle_data)
         {
         m_particle_data->setGlobalBox(snapshot->global_box);
-        m_particle_data->initializeFromSnapshot(snapshot->particle_data);
+        in_place = m_particle_data->updateFromSnapshot(snapshot->particle_data);
+        if (! in_place)
+            m_particle_data->initializeFromSnapshot(snapshot->particle_data);
         }
 
-    if (snapshot->has_bond_data)
+    if (snapshot->has_bond_data && !(in_place && m_bond_data->matchesSnapshot(snapshot->bond_data)))
         m_bond_data->initializeFromSnapshot(snapshot->bond_data);
 
-    if (snapshot->has_angle_data)
+    if (snapshot->has_angle_data && !(in_place && m_angle_data->matchesSnapshot(snapshot->angle_data)))
         m_angle_data->initializeFromSnapshot(snapshot->angle_data);
 
-    if (snapshot->has_dihedral_data)
+    if (snapshot->has_dihedral_data && !(in_place && m_dihedral_data->matchesSnapshot(snapshot->dihedral_data)))
         m_dihedral_data->initializeFromSnapshot(snapshot->dihedral_data);
 
-    if (snapshot->has_improper_data)
+    if (snapshot->has_improper_data && !(in_place && m_improper_data->matchesSnapshot(snapshot->improper_data)))
         m_improper_data->initializeFromSnapshot(snapshot->improper_data);
 
-    if (snapshot->has_constraint_data)
+    if (snapshot->has_constraint_data && !(in_place && m_constraint_data->matchesSnapshot(snapshot->constraint_data)))
         m_constraint_data->initializeFromSnapshot(snapshot->constraint_data);
 
-    if (snapshot->has_pair_data)
+    if (snapshot->has_pair_data && !(in_place && m_pair_data->matchesSnapshot(snapshot->pair_data)))
         m_pair_data->initializeFromSnapshot(snapshot->pair_data);
 
     // it is an error to load variables for more integrators than are
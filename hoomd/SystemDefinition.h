@@ -155,6 +155,9 @@ class PYBIND11_EXPORT SystemDefinition
                                                            bool pairs = false);
 
         //! Re-initialize the system from a snapshot
+        /*! If the snapshot has the same particles, types, and bonded groups as the current system, the particle
+            properties are overwritten in place (see ParticleData::updateFromSnapshot()).
+        */
         template <class Real>
         void initializeFromSnapshot(std::shared_ptr< SnapshotSystemData<Real> > snapshot);
 
@@ -0,0 +1,98 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file TagDirectory.cc
+    \brief Defines the TagDirectory class
+*/
+
+#ifdef ENABLE_MPI
+#include "TagDirectory.h"
+
+#include <stdexcept>
+
+using namespace std;
+
+/*! \param exec_conf The execution configuration
+*/
+TagDirectory::TagDirectory(std::shared_ptr<const ExecutionConfiguration> exec_conf)
+    : m_exec_conf(exec_conf), m_block_size(1)
+    {
+    }
+
+/*! \param tags Tags of the local particles
+    \param n Number of local particles
+    \param max_tag Largest tag in use on any rank
+*/
+void TagDirectory::rebuild(const unsigned int *tags, unsigned int n, unsigned int max_tag)
+    {
+    const MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    const unsigned int nranks = m_exec_conf->getNRanks();
+    const unsigned int my_rank = m_exec_conf->getRank();
+
+    m_block_size = max_tag/nranks + 1;
+    m_owner.assign(m_block_size, -1);
+
+    // sort the local tags by their home rank
+    std::vector<int> send_count(nranks, 0);
+    for (unsigned int i = 0; i < n; ++i)
+        send_count[getHomeRank(tags[i])]++;
+
+    std::vector<int> send_displs(nranks, 0);
+    for (unsigned int r = 1; r < nranks; ++r)
+        send_displs[r] = send_displs[r-1] + send_count[r-1];
+
+    std::vector<unsigned int> send_tags(n);
+    std::vector<int> offset(send_displs);
+    for (unsigned int i = 0; i < n; ++i)
+        send_tags[offset[getHomeRank(tags[i])]++] = tags[i];
+
+    // send every tag to its home rank
+    std::vector<int> recv_count(nranks);
+    MPI_Alltoall(&send_count.front(), 1, MPI_INT, &recv_count.front(), 1, MPI_INT, mpi_comm);
+
+    std::vector<int> recv_displs(nranks, 0);
+    for (unsigned int r = 1; r < nranks; ++r)
+        recv_displs[r] = recv_displs[r-1] + recv_count[r-1];
+
+    std::vector<unsigned int> recv_tags(recv_displs[nranks-1] + recv_count[nranks-1] + 1);
+    MPI_Alltoallv(send_tags.empty() ? NULL : &send_tags.front(), &send_count.front(), &send_displs.front(),
+        MPI_UNSIGNED, &recv_tags.front(), &recv_count.front(), &recv_displs.front(), MPI_UNSIGNED, mpi_comm);
+
+    // the sender of a tag owns it
+    unsigned int n_duplicate = 0;
+    for (unsigned int r = 0; r < nranks; ++r)
+        {
+        for (int k = 0; k < recv_count[r]; ++k)
+            {
+            unsigned int idx = recv_tags[recv_displs[r] + k] - my_rank*m_block_size;
+            if (m_owner[idx] != -1)
+                n_duplicate++;
+            m_owner[idx] = r;
+            }
+        }
+
+    MPI_Allreduce(MPI_IN_PLACE, &n_duplicate, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+    if (n_duplicate)
+        {
+        m_exec_conf->msg->error() << "Found " << n_duplicate << " particles on multiple processors." << endl << endl;
+        throw std::runtime_error("Error accessing particle data.");
+        }
+    }
+
+/*! \param tag Tag to look up
+    \returns The rank that owns the tag, -1 if no rank owns it
+*/
+int TagDirectory::getOwner(unsigned int tag) const
+    {
+    unsigned int home = getHomeRank(tag);
+    if (home >= m_exec_conf->getNRanks())
+        return -1;
+
+    int owner = -1;
+    if (home == m_exec_conf->getRank())
+        owner = m_owner[tag - home*m_block_size];
+    MPI_Bcast(&owner, 1, MPI_INT, home, m_exec_conf->getMPICommunicator());
+    return owner;
+    }
+#endif // ENABLE_MPI
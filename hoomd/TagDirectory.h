@@ -0,0 +1,58 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+/*! \file TagDirectory.h
+    \brief Declares the TagDirectory class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifdef ENABLE_MPI
+
+#ifndef __TAG_DIRECTORY_H__
+#define __TAG_DIRECTORY_H__
+
+#include "ExecutionConfiguration.h"
+
+#include <memory>
+#include <vector>
+
+//! Distributed directory of the ranks that own the particle tags
+/*! The tags are split into contiguous blocks, one per rank, and the home rank of a block stores the owner of each of
+    its tags. The directory is rebuilt with a single rendezvous exchange, in which every rank sends each of its local
+    tags to the home rank of the tag. A lookup of a single tag is then answered by its home rank with one broadcast,
+    instead of a search of all ranks. Each rank stores the owners of about N_global/N_ranks tags.
+
+    All methods are collective over the MPI communicator of the partition.
+
+    \ingroup communication
+*/
+class PYBIND11_EXPORT TagDirectory
+    {
+    public:
+        //! Constructor
+        TagDirectory(std::shared_ptr<const ExecutionConfiguration> exec_conf);
+
+        //! Rebuild the directory from the local tags of every rank
+        void rebuild(const unsigned int *tags, unsigned int n, unsigned int max_tag);
+
+        //! Find the rank that owns a tag
+        int getOwner(unsigned int tag) const;
+
+    private:
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< The execution configuration
+        unsigned int m_block_size;      //!< Number of tags that are homed on each rank
+        std::vector<int> m_owner;       //!< Owners of the tags homed on this rank (-1 if the tag is unused)
+
+        //! Get the home rank of a tag
+        unsigned int getHomeRank(unsigned int tag) const
+            {
+            return tag / m_block_size;
+            }
+    };
+
+#endif // __TAG_DIRECTORY_H__
+#endif // ENABLE_MPI
@@ -9,7 +9,9 @@
 
 
 #include "Variant.h"
+#include "System.h"
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
 namespace py = pybind11;
@@ -90,6 +92,55 @@ double VariantLinear::getValue(unsigned int timestep)
     return (1.0 - f) * va + f * vb;
     }
 
+/*! \param system System to get the simulation time from
+*/
+VariantLinearTime::VariantLinearTime(std::shared_ptr<System> system)
+    : m_system(system), m_time_offset(0.0)
+    {
+    }
+
+/*! \param time Simulation time to set the value at (relative to the time offset)
+    \param val Value to set at \a time
+
+    If a point at \a time has already been set, this overwrites it.
+*/
+void VariantLinearTime::setPoint(double time, double val)
+    {
+    m_values[time] = val;
+    }
+
+/*! \param timestep Ignored, the variant is evaluated at the current simulation time
+    \return Interpolated value
+*/
+double VariantLinearTime::getValue(unsigned int timestep)
+    {
+    // handle the degenerate case that the variant is empty
+    if (m_values.empty())
+        {
+        throw runtime_error("Error: No points specified to VariantLinearTime");
+        }
+
+    std::shared_ptr<System> system = m_system.lock();
+    double time = system ? std::max(system->getSimulationTime() - m_time_offset, 0.0) : 0.0;
+
+    // handle the beginning and end cases
+    if (time <= m_values.begin()->first)
+        return m_values.begin()->second;
+
+    map<double, double>::iterator last = m_values.end();
+    --last;
+    if (time >= last->first)
+        return last->second;
+
+    // interpolate between the two points around time
+    map<double, double>::iterator b = m_values.upper_bound(time);
+    map<double, double>::iterator a = b;
+    --a;
+
+    double f = (time - a->first) / (b->first - a->first);
+    return (1.0 - f) * a->second + f * b->second;
+    }
+
 void export_Variant(py::module& m)
     {
     py::class_<Variant, std::shared_ptr<Variant> >(m,"Variant")
@@ -103,4 +154,9 @@ void export_Variant(py::module& m)
     py::class_<VariantLinear, std::shared_ptr<VariantLinear> >(m,"VariantLinear",py::base<Variant>())
     .def(py::init< >())
     .def("setPoint", &VariantLinear::setPoint);
+
+    py::class_<VariantLinearTime, std::shared_ptr<VariantLinearTime> >(m,"VariantLinearTime",py::base<Variant>())
+    .def(py::init< std::shared_ptr<System> >())
+    .def("setPoint", &VariantLinearTime::setPoint)
+    .def("setTimeOffset", &VariantLinearTime::setTimeOffset);
     }
@@ -18,6 +18,7 @@
 #include "HOOMDMath.h"
 
 #include <map>
+#include <memory>
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 
 //! Base type for time varying quantities
@@ -92,6 +93,37 @@ class PYBIND11_EXPORT VariantLinear : public Variant
         m_b;    //!< Second point in the pair to interpolate
     };
 
+class System;
+
+//! Linearly interpolated variant in simulation time
+/*! This variant is given a series of (simulation time, value) pairs and interpolates linearly between them like
+    VariantLinear. It is evaluated at the current simulation time of the System (System::getSimulationTime()), minus
+    the time offset, so that set points stay at the same physical time when the time step changes during a run.
+    The \a timestep argument of getValue() is ignored.
+
+    The System is held by a weak pointer, since the System (indirectly) owns the variant.
+*/
+class PYBIND11_EXPORT VariantLinearTime : public Variant
+    {
+    public:
+        //! Constructs an empty variant
+        VariantLinearTime(std::shared_ptr<System> system);
+        //! Gets the value at the current simulation time
+        virtual double getValue(unsigned int timestep);
+        //! Sets a point in the interpolation
+        void setPoint(double time, double val);
+        //! Sets the simulation time that corresponds to time 0 of the points
+        void setTimeOffset(double time_offset)
+            {
+            m_time_offset = time_offset;
+            }
+
+    private:
+        std::weak_ptr<System> m_system;     //!< System to get the simulation time from
+        double m_time_offset;               //!< Simulation time at time 0 of the points
+        std::map<double, double> m_values;  //!< Values to interpolate
+    };
+
 //! Exports Variant* classes to python
 void export_Variant(pybind11::module& m);
 
@@ -61,6 +61,7 @@ from hoomd import comm
 from hoomd import compute
 from hoomd import data
 from hoomd import dump
+from hoomd import ensemble
 from hoomd import group
 from hoomd import init
 from hoomd import integrate
@@ -86,7 +87,7 @@ sys.excepthook = _hoomd_sys_excepthook
 
 __version__ = "{0}.{1}.{2}".format(*_hoomd.__version__)
 
-def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_period=0, callback=None, quiet=False):
+def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_period=0, callback=None, quiet=False, trace=None):
     """ Runs the simulation for a given number of time steps.
 
     Args:
@@ -99,12 +100,14 @@ def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_peri
         callback (`callable`): Sets a Python function to be called regularly during a run.
         callback_period (int): Sets the period, in time steps, between calls made to ``callback``.
         quiet (bool): Set to True to disable the status information printed to the screen by the run.
+        trace (str): If not None, write a timeline of the run to this file (added in version 2.5).
 
     Example::
 
             hoomd.run(10)
             hoomd.run(10e6, limit_hours=1.0/3600.0, limit_multiple=10)
             hoomd.run(10, profile=True)
+            hoomd.run(10, trace='timeline.json')
             hoomd.run(10, quiet=True)
             hoomd.run(10, callback_period=2, callback=lambda step: print(step))
 
@@ -123,7 +126,15 @@ def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_peri
 
     When `profile` is **True**, a detailed breakdown of how much time was spent in each
     portion of the calculation is printed at the end of the run. Collecting this timing information
-    slows the simulation.
+    slows the simulation. Use :py:func:`hoomd.option.set_profiler_params()` to add hardware performance
+    counters and the peak performance of the hardware to the profile.
+
+    When `trace` is set, the begin and end time of every compute, updater, analyzer and communication phase in every
+    time step is recorded and written to the file *trace* in the Chrome trace format at the end of the run. Open the
+    file in ``chrome://tracing`` or https://ui.perfetto.dev. GPU work is timed with CUDA events without synchronizing
+    the device and is shown in a separate thread. In MPI simulations, each rank writes the file ``trace.<rank>``; the
+    files can be concatenated to compare the ranks on one timeline. The trace keeps all events in memory, so only
+    trace short runs.
 
     **Wallclock limited runs:**
 
@@ -178,10 +189,15 @@ def run(tsteps, profile=False, limit_hours=None, limit_multiple=1, callback_peri
 
     # update autotuner parameters
     context.current.system.setAutotunerParams(context.options.autotuner_enable, int(context.options.autotuner_period));
+    context.current.system.setAutotunerCache(context.options.autotuner_cache if context.options.autotuner_cache is not None else '');
 
     for logger in context.current.loggers:
         logger.update_quantities();
     context.current.system.enableProfiler(profile);
+    context.current.system.setTraceFile(trace if trace is not None else '');
+    context.current.system.setProfilerParams(context.options.profiler_counters,
+                                             float(context.options.profiler_peak_flops or 0)*1e9,
+                                             float(context.options.profiler_peak_bandwidth or 0)*1e9);
     context.current.system.enableQuietRun(quiet);
 
     # update all user-defined neighbor lists
@@ -259,3 +275,26 @@ def get_step():
         raise RuntimeError('Error getting step');
 
     return context.current.system.getCurrentTimeStep();
+
+def get_time():
+    """ Get the current simulation time.
+
+    Returns:
+        The sum of the time steps of all steps run since initialization (in time units).
+
+    With a fixed time step, this is the number of steps run times the time step. With the adaptive time step
+    of :py:meth:`hoomd.md.integrate.mode_standard.set_adaptive`, use it to follow the physical time.
+
+    Example::
+
+            print(hoomd.get_time())
+
+    .. versionadded:: 2.5
+    """
+
+    # check if initialization has occurred
+    if not init.is_initialized():
+        context.msg.error("Cannot get time before initialization\n");
+        raise RuntimeError('Error getting time');
+
+    return context.current.system.getSimulationTime();
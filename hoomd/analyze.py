@@ -142,6 +142,8 @@ class _analyzer(hoomd.meta._metadata):
             return;
 
         hoomd.context.current.system.addAnalyzer(self.cpp_analyzer, self.analyzer_name, self.prev_period, self.phase);
+        if getattr(self, 'time_period', None) is not None:
+            hoomd.context.current.system.setAnalyzerPeriodTime(self.analyzer_name, self.time_period);
         hoomd.context.current.analyzers.append(self)
         self.enabled = True;
 
@@ -165,6 +167,7 @@ class _analyzer(hoomd.meta._metadata):
         self.period = period;
 
         if type(period) == type(1):
+            self.time_period = None;
             if self.enabled:
                 hoomd.context.current.system.setAnalyzerPeriod(self.analyzer_name, period, self.phase);
             else:
@@ -174,6 +177,33 @@ class _analyzer(hoomd.meta._metadata):
         else:
             hoomd.context.msg.warning("I don't know what to do with a period of type " + str(type(period)) + " expecting an int or a function");
 
+    def set_time_period(self, time_period):
+        R""" Changes the period between analyzer executions to an interval of simulation time.
+
+        Args:
+            time_period (float): Simulation time between two executions (in time units)
+
+        Examples::
+
+            analyzer.set_time_period(0.5)
+
+        The analyzer executes on the first step of the next :py:func:`hoomd.run()` and then on the first step that
+        reaches every further multiple of *time_period*. Use this with an adaptive time step
+        (:py:meth:`hoomd.md.integrate.mode_standard.set_adaptive`) to keep the executions spaced evenly in simulation time.
+        Call :py:meth:`set_period()` to return to a period in time steps.
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+
+        if time_period <= 0:
+            hoomd.context.msg.error("The time period must be positive\n");
+            raise RuntimeError('Error setting the time period');
+
+        self.time_period = float(time_period);
+        if self.enabled:
+            hoomd.context.current.system.setAnalyzerPeriodTime(self.analyzer_name, self.time_period);
+
     ## \internal
     # \brief Get metadata
     def get_metadata(self):
@@ -219,11 +249,18 @@ class imd(_analyzer):
         force (:py:class:`hoomd.md.force.constant`): A force that apply forces received from VMD.
         force_scale (float): Factor by which to scale all forces received from VMD.
         phase (int): When -1, start on the current time step. When >= 0, execute on steps where `(step + phase) % period == 0`.
+        group (:py:mod:`hoomd.group`): Transmit only the particles in this group (all particles when *None*).
+        stride (int): Transmit only every *stride* th particle (of the group) in tag order.
 
     :py:class:`hoomd.analyze.imd` listens on a specified TCP/IP port for connections from VMD.
     Once that connection is established, it begins transmitting simulation snapshots
     to VMD every *rate* time steps.
 
+    The coordinates are sent by a background thread, so that a slow client does not slow down the simulation.
+    When the client is still receiving the previous frame, the previous frame is dropped in favor of the
+    latest one. Use *group* (e.g. :py:func:`hoomd.group.cuboid` for a region) and *stride* to reduce the
+    amount of data sent to the client. VMD needs a structure with the same number of particles.
+
     To connect to a simulation running on the local host, issue the command::
 
         imd connect localhost 54321
@@ -239,8 +276,9 @@ class imd(_analyzer):
         analyze.imd(port=54321, rate=100)
         analyze.imd(port=54321, rate=100, pause=True)
         imd = analyze.imd(port=12345, rate=1000)
+        analyze.imd(port=54321, rate=100, group=group.cuboid(name='slab', zmin=-5, zmax=5), stride=10)
     """
-    def __init__(self, port, period=1, rate=1, pause=False, force=None, force_scale=0.1, phase=0):
+    def __init__(self, port, period=1, rate=1, pause=False, force=None, force_scale=0.1, phase=0, group=None, stride=1):
         hoomd.util.print_status_line();
 
         # initialize base class
@@ -254,6 +292,15 @@ class imd(_analyzer):
 
         # create the c++ mirror class
         self.cpp_analyzer = _hoomd.IMDInterface(hoomd.context.current.system_definition, port, pause, rate, cpp_force);
+
+        if int(stride) < 1:
+            hoomd.context.msg.error("analyze.imd: stride must be positive\n");
+            raise ValueError("stride must be positive");
+
+        if group is not None or stride != 1:
+            cpp_group = group.cpp_group if group is not None else None;
+            self.cpp_analyzer.setFilter(cpp_group, int(stride));
+
         self.setupAnalyzer(period, phase);
 
 
@@ -286,6 +333,12 @@ class log(_analyzer):
     - **yz** - Box tilt factor in yz plane (dimensionless)
     - **momentum** - Magnitude of the average momentum of all particles (in momentum units)
     - **time** - Wall-clock running time from the start of the log (in seconds)
+    - **memory_total_host**, **memory_total_device** - Bytes of host and device memory currently allocated in
+      GPU arrays on the logging rank, device memory includes managed memory
+    - **memory_total_host_peak**, **memory_total_device_peak** - Largest number of bytes allocated at any time
+    - **memory_<owner>_host**, **memory_<owner>_device**, and the same with a *_peak* suffix - Memory allocated by the
+      subsystem *owner*, one of *ParticleData*, *NeighborList*, *CellList*, *Communicator*, *ForceCompute*,
+      *BondedGroupData* or *other*
 
     Thermodynamic properties:
     - The following quantities are always available and computed over all particles in the system (see :py:class:`hoomd.compute.thermo` for detailed definitions):
@@ -323,6 +376,7 @@ class log(_analyzer):
       - **pair_yukawa_energy** (:py:class:`hoomd.md.pair.yukawa`) - Total Yukawa potential energy (in energy units)
       - **pair_force_shifted_lj_energy** (:py:class:`hoomd.md.pair.force_shifted_lj`) - Total Force-shifted Lennard-Jones potential energy (in energy units)
       - **pppm_energy** (:py:class:`hoomd.md.charge.pppm`) -  Long ranged part of the electrostatic energy (in energy units)
+      - **pppm_rms_error** (:py:class:`hoomd.md.charge.pppm`) -  Estimated RMS error of the electrostatic force (in force units)
 
     - Bond potentials
 
@@ -454,18 +508,25 @@ class log(_analyzer):
         self.filename = filename
         self.period = period
 
-    def set_params(self, quantities=None, delimiter=None):
+    def set_params(self, quantities=None, delimiter=None, buffer_rows=None, async_write=None):
         R""" Change the parameters of the log.
 
         Args:
             quantities (list): New list of quantities to log (if specified)
             delimiter (str): New delimiter between columns in the output file (if specified)
+            buffer_rows (int): Number of rows to buffer in memory before writing them to the file (if specified). (added in version 2.5)
+            async_write (bool): When True, write buffered rows on a background thread while the simulation continues (if specified). (added in version 2.5)
+
+        By default, every row is written to the file as soon as it is logged. With *buffer_rows* > 1, rows are
+        collected in memory and written in blocks, which reduces the file system overhead of logging with a short
+        period. All buffered rows are written to the file at the end of every :py:func:`hoomd.run()`.
 
         Examples::
 
             logger.set_params(quantities=['bond_harmonic_energy'])
             logger.set_params(delimiter=',');
             logger.set_params(quantities=['bond_harmonic_energy'], delimiter=',');
+            logger.set_params(buffer_rows=1000, async_write=True);
         """
 
         hoomd.util.print_status_line();
@@ -480,6 +541,12 @@ class log(_analyzer):
         if delimiter:
             self.cpp_analyzer.setDelimiter(delimiter);
 
+        if buffer_rows is not None:
+            self.cpp_analyzer.setBufferRows(int(buffer_rows));
+
+        if async_write is not None:
+            self.cpp_analyzer.setAsync(bool(async_write));
+
     def query(self, quantity):
         R""" Get the current value of a logged quantity.
 
@@ -599,3 +666,173 @@ class callback(_analyzer):
         # create the c++ mirror class
         self.cpp_analyzer = _hoomd.CallbackAnalyzer(hoomd.context.current.system_definition, callback)
         self.setupAnalyzer(period, phase);
+
+class stream(_analyzer):
+    R""" Stream frames of the local particle data to an external analysis process.
+
+    Args:
+        filename (str): File or named pipe to write the frames to
+        period (int): Frames are written every *period* time steps
+        quantities (list): Per-particle arrays to include in every frame
+        buffer_frames (int): Number of frames that may be in flight at once
+        drop (bool): When True, drop frames while all buffers are in flight. When False, wait for a free buffer.
+        phase (int): When -1, start on the current time step. When >= 0, execute on steps where (step + phase) % period == 0.
+
+    :py:class:`stream` copies the selected arrays of the particles local to this rank into a frame buffer and
+    returns to the simulation right away. A background thread writes the frames to *filename*, which is typically a
+    FIFO (``mkfifo``) or a file in ``/dev/shm`` read concurrently by a separate analysis process. Unlike
+    :py:class:`callback`, the analysis does not run inside the time step loop and does not hold the python GIL.
+
+    Valid quantities are ``position``, ``velocity``, ``net_force``, ``image`` and ``tag``. Positions, velocities
+    and net forces are written in the precision hoomd was built with.
+
+    When the consumer is slower than the simulation, at most *buffer_frames* frames are queued. Further frames are
+    dropped when *drop* is True (see :py:meth:`dropped`), or the simulation waits for the consumer when *drop* is
+    False.
+
+    The stream is a sequence of binary frames in native byte order. Each frame consists of a header:
+
+    * ``char[4]`` magic ``HFRM``
+    * ``uint32`` number of chunks
+    * ``uint64`` time step
+    * ``uint32`` number of particles *N* in this frame
+    * ``uint32`` MPI rank
+    * ``float64[6]`` box ``Lx, Ly, Lz, xy, xz, yz``
+
+    followed by one chunk per quantity, in the order given in *quantities*:
+
+    * ``char[16]`` name, zero padded
+    * ``char[4]`` numpy type code (``f4``, ``f8``, ``i4`` or ``u4``), zero padded
+    * ``uint32`` number of components per particle
+    * *N* x components array
+
+    In MPI simulations with more than one rank, every rank writes its own stream of its local particles to
+    ``filename.rank``. Use the ``tag`` quantity to identify the particles.
+
+    Examples::
+
+        analyze.stream(filename='/dev/shm/frames', period=100, quantities=['position', 'tag'])
+        analyze.stream(filename='pipe', period=10, quantities=['position', 'velocity', 'tag'], buffer_frames=8)
+
+    .. versionadded:: 2.5
+    """
+    def __init__(self, filename, period, quantities=['position', 'tag'], buffer_frames=4, drop=True, phase=0):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        _analyzer.__init__(self);
+
+        if buffer_frames < 1:
+            hoomd.context.msg.error("analyze.stream: buffer_frames must be at least 1\n");
+            raise RuntimeError('Error creating analyze.stream');
+
+        # create the c++ mirror class
+        self.cpp_analyzer = _hoomd.StreamAnalyzer(hoomd.context.current.system_definition, filename,
+                                                  list(quantities), int(buffer_frames), bool(drop));
+        self.setupAnalyzer(period, phase);
+
+        # store metadata
+        self.filename = filename
+        self.period = period
+        self.quantities = list(quantities)
+        self.buffer_frames = buffer_frames
+        self.drop = drop
+        self.metadata_fields = ['filename', 'period', 'quantities', 'buffer_frames', 'drop']
+
+    def flush(self):
+        R""" Wait until all queued frames are written.
+
+        Examples::
+
+            s.flush()
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+        self.cpp_analyzer.flush();
+
+    def dropped(self):
+        R""" Get the number of frames dropped on this rank because all buffers were in flight.
+
+        Returns:
+            The number of dropped frames.
+
+        Examples::
+
+            print(s.dropped())
+
+        .. versionadded:: 2.5
+        """
+        return self.cpp_analyzer.getDroppedFrames();
+
+class metrics(_analyzer):
+    R""" Export live performance metrics in the OpenMetrics (Prometheus) text format.
+
+    Args:
+        period (int): Metrics are exported every *period* time steps
+        filename (str): File to write the metrics to, or None
+        port (int): TCP port on which rank 0 serves the metrics over HTTP, or None
+        phase (int): When -1, start on the current time step. When >= 0, execute on steps where (step + phase) % period == 0.
+
+    The subsystems of HOOMD publish counters and gauges into a registry as the simulation runs, at the cost of an
+    atomic update. :py:class:`metrics` reduces them over the MPI ranks and writes them to *filename* (replacing the
+    file atomically, suitable for the textfile collector of the Prometheus node exporter) and/or serves them at
+    ``http://<host of rank 0>:<port>/``, so that monitoring can alert on jobs whose performance degrades.
+
+    The exported metrics include:
+
+    * ``hoomd_timestep``, ``hoomd_timesteps_total`` and ``hoomd_tps`` (over the last *period*)
+    * ``hoomd_compute_seconds_total{compute="..."}``, ``hoomd_analyzer_seconds_total{analyzer="..."}``,
+      ``hoomd_updater_seconds_total{updater="..."}`` and ``hoomd_integrator_seconds_total``, the wall clock time
+      spent in each force compute, neighbor list, analyzer, updater and the integrator
+    * ``hoomd_nlist_builds_total`` and ``hoomd_nlist_dangerous_builds_total``
+    * ``hoomd_comm_migrations_total``, ``hoomd_comm_ghosts`` and ``hoomd_comm_wait_seconds_total`` (time spent
+      waiting for MPI messages) in MPI simulations
+    * ``hoomd_memory_host_bytes``, ``hoomd_memory_device_bytes`` (allocated by HOOMD) and
+      ``hoomd_gpu_memory_used_bytes``
+
+    Times are summed over the ranks. In GPU runs, they measure the host time that includes the kernel launches
+    but not necessarily the kernel execution.
+
+    Examples::
+
+        analyze.metrics(period=1000, filename='/var/lib/node_exporter/hoomd.prom')
+        analyze.metrics(period=1000, port=9100)
+
+    .. versionadded:: 2.5
+    """
+    def __init__(self, period, filename=None, port=None, phase=0):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        _analyzer.__init__(self);
+
+        if filename is None and port is None:
+            hoomd.context.msg.error("analyze.metrics: set filename and/or port\n");
+            raise RuntimeError('Error creating analyze.metrics');
+
+        # create the c++ mirror class
+        self.cpp_analyzer = _hoomd.MetricsExporter(hoomd.context.current.system_definition,
+                                                   filename if filename is not None else '',
+                                                   int(port) if port is not None else -1);
+        self.setupAnalyzer(period, phase);
+
+        # store metadata
+        self.filename = filename
+        self.period = period
+        self.port = port
+        self.metadata_fields = ['filename', 'period', 'port']
+
+    def snapshot(self):
+        R""" Get the metrics of the most recent export.
+
+        Returns:
+            The metrics in the OpenMetrics text format on rank 0, an empty document on other ranks.
+
+        Examples::
+
+            print(m.snapshot())
+
+        .. versionadded:: 2.5
+        """
+        return self.cpp_analyzer.getSnapshot();
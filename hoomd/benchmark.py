@@ -6,9 +6,16 @@
 R""" Benchmark utilities
 
 Commands that help in benchmarking HOOMD-blue performance.
+
+:py:func:`series()` measures the time steps per second of the whole simulation, and :py:func:`compute()`,
+:py:func:`cell_list()` and :py:func:`communication()` time individual subsystems. :py:class:`report` collects the
+results with the run configuration and writes them to a JSON file, e.g. for the comparison of releases. The benchmark
+suite in ``benchmarks/hoomd_benchmarks.py`` is built on these commands.
 """
 
 import hoomd
+import json
+import time
 
 def series(warmup=100000, repeat=20, steps=10000, limit_hours=None):
     R""" Perform a series of benchmark runs.
@@ -36,3 +43,160 @@ def series(warmup=100000, repeat=20, steps=10000, limit_hours=None):
         tps_list.append(hoomd.context.current.system.getLastTPS());
 
     return tps_list;
+
+## \internal
+# \brief Get the C++ compute of a python object
+def _get_cpp_compute(obj):
+    for attr in ['cpp_force', 'cpp_nlist', 'cpp_compute', 'cpp_analyzer', 'cpp_updater']:
+        cpp_obj = getattr(obj, attr, None);
+        if cpp_obj is not None and hasattr(cpp_obj, 'benchmark'):
+            return cpp_obj;
+
+    hoomd.context.msg.error("benchmark: " + str(obj) + " cannot be benchmarked\n");
+    raise RuntimeError('Error benchmarking');
+
+def compute(obj, num_iters=100):
+    R""" Time the computation of a force or neighbor list.
+
+    Args:
+        obj: A force (e.g. :py:class:`hoomd.md.pair.lj`), neighbor list or compute.
+        num_iters (int): Number of computations to average over.
+
+    Returns:
+        The time per computation in milliseconds.
+
+    :py:func:`compute()` recomputes *obj* *num_iters* times at the current time step, without any other
+    subsystem. For a neighbor list, it times the build of the list.
+
+    Example::
+
+        nl = md.nlist.cell()
+        lj = md.pair.lj(r_cut=2.5, nlist=nl)
+        ...
+        hoomd.run(100)
+        t_nlist = hoomd.benchmark.compute(nl)
+        t_lj = hoomd.benchmark.compute(lj)
+    """
+    # check if initialization has occurred
+    if not hoomd.init.is_initialized():
+        hoomd.context.msg.error("Cannot benchmark before initialization\n");
+        raise RuntimeError('Error benchmarking');
+
+    return _get_cpp_compute(obj).benchmark(int(num_iters));
+
+def cell_list(nlist, num_iters=100):
+    R""" Time the computation of the cell list of a neighbor list.
+
+    Args:
+        nlist (:py:class:`hoomd.md.nlist.cell` or :py:class:`hoomd.md.nlist.stencil`): The neighbor list.
+        num_iters (int): Number of computations to average over.
+
+    Returns:
+        The time per cell list computation in milliseconds.
+    """
+    # check if initialization has occurred
+    if not hoomd.init.is_initialized():
+        hoomd.context.msg.error("Cannot benchmark before initialization\n");
+        raise RuntimeError('Error benchmarking');
+
+    if getattr(nlist, 'cpp_cl', None) is None:
+        hoomd.context.msg.error("benchmark: The neighbor list does not use a cell list\n");
+        raise RuntimeError('Error benchmarking');
+
+    return nlist.cpp_cl.benchmark(int(num_iters));
+
+def communication(num_iters=100, ghost_update=False):
+    R""" Time the MPI communication of the particle data.
+
+    Args:
+        num_iters (int): Number of communication steps to average over.
+        ghost_update (bool): When True, time the update of the ghost particles, which happens in every step without a
+          neighbor list build. Otherwise, time the migration of particles and the exchange of the ghosts.
+
+    Returns:
+        The time per communication step in milliseconds, or None in simulations without domain decomposition.
+    """
+    # check if initialization has occurred
+    if not hoomd.init.is_initialized():
+        hoomd.context.msg.error("Cannot benchmark before initialization\n");
+        raise RuntimeError('Error benchmarking');
+
+    cpp_communicator = None;
+    if hoomd._hoomd.is_MPI_available():
+        cpp_communicator = hoomd.context.current.system.getCommunicator();
+
+    if cpp_communicator is None:
+        return None;
+
+    if ghost_update:
+        return cpp_communicator.benchmarkGhostUpdate(int(num_iters), hoomd.get_step());
+    else:
+        return cpp_communicator.benchmarkExchange(int(num_iters), hoomd.get_step());
+
+class report(object):
+    R""" Collect benchmark results and write them to a JSON file.
+
+    Args:
+        metadata: Additional keyword arguments are stored in the ``configuration`` section of the report.
+
+    The report stores the HOOMD-blue version, the execution mode, the GPUs, the number of MPI ranks and the
+    *metadata* with every result, so that results from different builds and machines can be compared.
+
+    Example::
+
+        r = hoomd.benchmark.report(workload='lj_liquid', N=64000)
+        r.add('lj_liquid', 'tps', hoomd.benchmark.series(warmup=1000, repeat=5, steps=1000))
+        r.add('lj_liquid/pair.lj', 'ms', hoomd.benchmark.compute(lj))
+        r.write('benchmarks.json')
+    """
+    def __init__(self, **metadata):
+        self.configuration = dict(metadata);
+        self.results = [];
+
+    def add(self, name, unit, value, **extra):
+        R""" Add a result to the report.
+
+        Args:
+            name (str): Name of the benchmark.
+            unit (str): Unit of the result (e.g. *tps* or *ms*).
+            value: A single value or a list of values of repeated measurements.
+            extra: Additional keyword arguments are stored with the result.
+
+        Results with a value of None (e.g. from :py:func:`communication()` without domain decomposition) are
+        skipped.
+        """
+        if value is None:
+            return;
+
+        result = dict(name=name, unit=unit);
+        if isinstance(value, (list, tuple)):
+            result['values'] = [float(v) for v in value];
+            result['value'] = sum(result['values'])/len(result['values']);
+        else:
+            result['value'] = float(value);
+
+        result.update(extra);
+        self.results.append(result);
+
+    def write(self, filename):
+        R""" Write the report to a file.
+
+        Args:
+            filename (str): Name of the JSON file.
+
+        Only the root rank writes the file.
+        """
+        if hoomd.comm.get_rank() != 0:
+            return;
+
+        configuration = dict(hoomd_version=hoomd.__version__,
+                             git_sha1=hoomd._hoomd.__git_sha1__,
+                             date=time.strftime('%Y-%m-%dT%H:%M:%S'));
+        if hoomd.context.exec_conf is not None:
+            execution = hoomd.context.ExecutionContext();
+            configuration.update(hostname=execution.hostname, mode=execution.mode, gpu=execution.gpu,
+                                 num_ranks=execution.num_ranks);
+        configuration.update(self.configuration);
+
+        with open(filename, 'w') as f:
+            json.dump(dict(configuration=configuration, results=self.results), f, indent=2, sort_keys=True);
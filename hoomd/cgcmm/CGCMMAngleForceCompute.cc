@@ -7,6 +7,7 @@
 
 
 #include "CGCMMAngleForceCompute.h"
+#include "EvaluatorAngleCGCMM.h"
 
 namespace py = pybind11;
 
@@ -17,9 +18,6 @@ namespace py = pybind11;
 
 using namespace std;
 
-// \param SMALL a relatively small number
-#define SMALL Scalar(0.001)
-
 /*! \file CGCMMAngleForceCompute.cc
     \brief Contains code for the CGCMMAngleForceCompute class
 */
@@ -197,12 +195,6 @@ void CGCMMAngleForceCompute::computeForces(unsigned int timestep)
     // get a local copy of the simulation box too
     const BoxDim& box = m_pdata->getGlobalBox();
 
-    // allocate forces
-    Scalar fab[3], fcb[3];
-    Scalar fac;
-
-    Scalar eac;
-    Scalar vac[6];
     // for each of the angles
     const unsigned int size = (unsigned int)m_CGCMMAngle_data->getN();
     for (unsigned int i = 0; i < size; i++)
@@ -253,98 +245,31 @@ void CGCMMAngleForceCompute::computeForces(unsigned int timestep)
         dcb = box.minImage(dcb);
         dac = box.minImage(dac);
 
-        // on paper, the formula turns out to be: F = K*\vec{r} * (r_0/r - 1)
-        // FLOPS: 14 / MEM TRANSFER: 2 Scalars
-
-        // FLOPS: 42 / MEM TRANSFER: 6 Scalars
-        Scalar rsqab = dab.x*dab.x+dab.y*dab.y+dab.z*dab.z;
-        Scalar rab = sqrt(rsqab);
-        Scalar rsqcb = dcb.x*dcb.x+dcb.y*dcb.y+dcb.z*dcb.z;
-        Scalar rcb = sqrt(rsqcb);
-        Scalar rsqac = dac.x*dac.x+dac.y*dac.y+dac.z*dac.z;
-        Scalar rac = sqrt(rsqac);
-
-        Scalar c_abbc = dab.x*dcb.x+dab.y*dcb.y+dab.z*dcb.z;
-        c_abbc /= rab*rcb;
-
-        if (c_abbc > 1.0) c_abbc = 1.0;
-        if (c_abbc < -1.0) c_abbc = -1.0;
-
-        Scalar s_abbc = sqrt(1.0 - c_abbc*c_abbc);
-        if (s_abbc < SMALL) s_abbc = SMALL;
-        s_abbc = 1.0/s_abbc;
-
-        //////////////////////////////////////////
-        // THIS CODE DOES THE 1-3 LJ repulsions //
-        //////////////////////////////////////////////////////////////////////////////
-        fac = Scalar(0.0);
-        eac = Scalar(0.0);
-        for (int k = 0; k < 6; k++)
-            vac[k] = Scalar(0.0);
-
+        // evaluate the angle with the same evaluator as the GPU kernel
         unsigned int angle_type = m_CGCMMAngle_data->getTypeByIndex(i);
-        if (rac < m_rcut[angle_type])
-            {
-            const unsigned int cg_type = m_cg_type[angle_type];
-            const Scalar cg_pow1 = cgPow1[cg_type];
-            const Scalar cg_pow2 = cgPow2[cg_type];
-            const Scalar cg_pref = prefact[cg_type];
-
-            const Scalar cg_ratio = m_sigma[angle_type]/rac;
-            const Scalar cg_eps   = m_eps[angle_type];
-
-            fac = cg_pref*cg_eps / rsqac * (cg_pow1*pow(cg_ratio,cg_pow1) - cg_pow2*pow(cg_ratio,cg_pow2));
-            eac = cg_eps + cg_pref*cg_eps * (pow(cg_ratio,cg_pow1) - pow(cg_ratio,cg_pow2));
-
-            vac[0] = fac * dac.x*dac.x;
-            vac[1] = fac * dac.x*dac.y;
-            vac[2] = fac * dac.x*dac.z;
-            vac[3] = fac * dac.y*dac.y;
-            vac[4] = fac * dac.y*dac.z;
-            vac[5] = fac * dac.z*dac.z;
-            }
-        //////////////////////////////////////////////////////////////////////////////
-
-        // actually calculate the force
-        Scalar dth = acos(c_abbc) - m_t_0[angle_type];
-        Scalar tk = m_K[angle_type]*dth;
-
-        Scalar a = -1.0 * tk * s_abbc;
-        Scalar a11 = a*c_abbc/rsqab;
-        Scalar a12 = -a / (rab*rcb);
-        Scalar a22 = a*c_abbc / rsqcb;
-
-        fab[0] = a11*dab.x + a12*dcb.x;
-        fab[1] = a11*dab.y + a12*dcb.y;
-        fab[2] = a11*dab.z + a12*dcb.z;
-
-        fcb[0] = a22*dcb.x + a12*dab.x;
-        fcb[1] = a22*dcb.y + a12*dab.y;
-        fcb[2] = a22*dcb.z + a12*dab.z;
-
-        // compute 1/3 of the energy, 1/3 for each atom in the angle
-        Scalar angle_eng = (0.5*tk*dth + eac)*Scalar(1.0/3.0);
-
-        // compute 1/3 of the virial, 1/3 for each atom in the angle
-        // upper triangular version of virial tensor
-        Scalar angle_virial[6];
-        angle_virial[0] = Scalar(1./3.) * ( dab.x*fab[0] + dcb.x*fcb[0] );
-        angle_virial[1] = Scalar(1./3.) * ( dab.y*fab[0] + dcb.y*fcb[0] );
-        angle_virial[2] = Scalar(1./3.) * ( dab.z*fab[0] + dcb.z*fcb[0] );
-        angle_virial[3] = Scalar(1./3.) * ( dab.y*fab[1] + dcb.y*fcb[1] );
-        angle_virial[4] = Scalar(1./3.) * ( dab.z*fab[1] + dcb.z*fcb[1] );
-        angle_virial[5] = Scalar(1./3.) * ( dab.z*fab[2] + dcb.z*fcb[2] );
+        const unsigned int cg_type = m_cg_type[angle_type];
+        EvaluatorAngleCGCMM eval(dab, dcb, dac,
+                                 make_scalar2(m_K[angle_type], m_t_0[angle_type]),
+                                 make_scalar2(m_sigma[angle_type], m_rcut[angle_type]),
+                                 make_scalar4(m_eps[angle_type], cgPow1[cg_type], cgPow2[cg_type], prefact[cg_type]));
+
+        Scalar3 f_a, f_c;
+        Scalar eng;
         Scalar virial[6];
+        eval.evaluate(f_a, f_c, eng, virial);
+
+        // 1/3 of the energy and virial for each atom in the angle
+        Scalar angle_eng = eng*Scalar(1.0/3.0);
         for (unsigned int k=0; k < 6; k++)
-            virial[k] = angle_virial[k] + Scalar(1./3.)*vac[k];
+            virial[k] *= Scalar(1./3.);
 
         // Now, apply the force to each individual atom a,b,c, and accumulate the energy/virial
         // only apply force to local particles
         if (idx_a < m_pdata->getN())
             {
-            h_force.data[idx_a].x += fab[0] + fac*dac.x;
-            h_force.data[idx_a].y += fab[1] + fac*dac.y;
-            h_force.data[idx_a].z += fab[2] + fac*dac.z;
+            h_force.data[idx_a].x += f_a.x;
+            h_force.data[idx_a].y += f_a.y;
+            h_force.data[idx_a].z += f_a.z;
             h_force.data[idx_a].w += angle_eng;
             for (int k = 0; k < 6; k++)
                 h_virial.data[k*virial_pitch+idx_a] += virial[k];
@@ -352,9 +277,9 @@ void CGCMMAngleForceCompute::computeForces(unsigned int timestep)
 
         if (idx_b < m_pdata->getN())
             {
-            h_force.data[idx_b].x -= fab[0] + fcb[0];
-            h_force.data[idx_b].y -= fab[1] + fcb[1];
-            h_force.data[idx_b].z -= fab[2] + fcb[2];
+            h_force.data[idx_b].x -= f_a.x + f_c.x;
+            h_force.data[idx_b].y -= f_a.y + f_c.y;
+            h_force.data[idx_b].z -= f_a.z + f_c.z;
             h_force.data[idx_b].w += angle_eng;
             for (int k = 0; k < 6; k++)
                 h_virial.data[k*virial_pitch+idx_b] += virial[k];
@@ -362,9 +287,9 @@ void CGCMMAngleForceCompute::computeForces(unsigned int timestep)
 
         if (idx_c < m_pdata->getN())
             {
-            h_force.data[idx_c].x += fcb[0] - fac*dac.x;
-            h_force.data[idx_c].y += fcb[1] - fac*dac.y;
-            h_force.data[idx_c].z += fcb[2] - fac*dac.z;
+            h_force.data[idx_c].x += f_c.x;
+            h_force.data[idx_c].y += f_c.y;
+            h_force.data[idx_c].z += f_c.z;
             h_force.data[idx_c].w += angle_eng;
             for (int k = 0; k < 6; k++)
                 h_virial.data[k*virial_pitch+idx_c] += virial[k];
@@ -5,13 +5,11 @@
 // Maintainer: dnlebard
 
 #include "CGCMMAngleForceGPU.cuh"
+#include "EvaluatorAngleCGCMM.h"
 #include "hoomd/TextureTools.h"
 
 #include <assert.h>
 
-// small number. cutoff for ignoring the angle as being ill defined.
-#define SMALL Scalar(0.001)
-
 /*! \file CGCMMAngleForceGPU.cu
     \brief Defines GPU kernel code for calculating the CGCMM angle forces. Used by CGCMMAngleForceComputeGPU.
 */
@@ -67,9 +65,6 @@ extern "C" __global__ void gpu_compute_CGCMM_angle_forces_kernel(Scalar4* d_forc
     // initialize the force to 0
     Scalar4 force_idx = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
 
-    Scalar fab[3], fcb[3];
-    Scalar fac, eac, vac[6];
-
     // initialize the virial to 0
     Scalar virial_idx[6];
     for (int i = 0; i < 6; i++)
@@ -123,117 +118,32 @@ extern "C" __global__ void gpu_compute_CGCMM_angle_forces_kernel(Scalar4* d_forc
         dcb = box.minImage(dcb);
         dac = box.minImage(dac);
 
-        // get the angle parameters (MEM TRANSFER: 8 bytes)
+        // get the angle parameters (MEM TRANSFER: 32 bytes)
         Scalar2 params = texFetchScalar2(d_params, angle_params_tex, cur_angle_type);
-        Scalar K = params.x;
-        Scalar t_0 = params.y;
-
-        Scalar rsqab = dot(dab, dab);
-        Scalar rab = sqrtf(rsqab);
-        Scalar rsqcb = dot(dcb, dcb);;
-        Scalar rcb = sqrtf(rsqcb);
-        Scalar rsqac = dot(dac, dac);
-        Scalar rac = sqrtf(rsqac);
-
-        Scalar c_abbc = dot(dab, dcb);
-        c_abbc /= rab*rcb;
-
-        if (c_abbc > Scalar(1.0)) c_abbc = Scalar(1.0);
-        if (c_abbc < -Scalar(1.0)) c_abbc = -Scalar(1.0);
-
-        Scalar s_abbc = sqrtf(Scalar(1.0) - c_abbc*c_abbc);
-        if (s_abbc < SMALL) s_abbc = SMALL;
-        s_abbc = Scalar(1.0)/s_abbc;
-
-        //////////////////////////////////////////
-        // THIS CODE DOES THE 1-3 LJ repulsions //
-        //////////////////////////////////////////////////////////////////////////////
-        fac = Scalar(0.0);
-        eac = Scalar(0.0);
-        for (int i=0; i < 6; i++)
-            vac[i] = Scalar(0.0);
-
-        // get the angle E-S-R parameters (MEM TRANSFER: 12 bytes)
-        const Scalar2 cgSR = texFetchScalar2(d_CGCMMsr, angle_CGCMMsr_tex, cur_angle_type);
-
-        Scalar cgsigma = cgSR.x;
-        Scalar cgrcut = cgSR.y;
-
-        if (rac < cgrcut)
-            {
-            const Scalar4 cgEPOW = texFetchScalar4(d_CGCMMepow, angle_CGCMMepow_tex, cur_angle_type);
-
-            // get the angle pow/pref parameters (MEM TRANSFER: 12 bytes)
-            Scalar cgeps = cgEPOW.x;
-            Scalar cgpow1 = cgEPOW.y;
-            Scalar cgpow2 = cgEPOW.z;
-            Scalar cgpref = cgEPOW.w;
-
-            Scalar cgratio = cgsigma/rac;
-            // INTERESTING NOTE: POW has weird behavior depending
-            // on the inputted parameters.  Try sigma=2.05, versus sigma=0.05
-            // in cgcmm_angle_force_test.cc 4 particle test
-            fac = cgpref*cgeps / rsqac * (cgpow1*fast::pow(cgratio,cgpow1) - cgpow2*fast::pow(cgratio,cgpow2));
-            eac = cgeps + cgpref*cgeps * (fast::pow(cgratio,cgpow1) - fast::pow(cgratio,cgpow2));
-
-            vac[0] = fac * dac.x*dac.x;
-            vac[1] = fac * dac.x*dac.y;
-            vac[2] = fac * dac.x*dac.z;
-            vac[3] = fac * dac.y*dac.y;
-            vac[4] = fac * dac.y*dac.z;
-            vac[5] = fac * dac.z*dac.z;
-            }
-        //////////////////////////////////////////////////////////////////////////////
+        Scalar2 cgSR = texFetchScalar2(d_CGCMMsr, angle_CGCMMsr_tex, cur_angle_type);
+        Scalar4 cgEPOW = texFetchScalar4(d_CGCMMepow, angle_CGCMMepow_tex, cur_angle_type);
 
-        // actually calculate the force
-        Scalar dth = fast::acos(c_abbc) - t_0;
-        Scalar tk = K*dth;
-
-        Scalar a = -Scalar(1.0) * tk * s_abbc;
-        Scalar a11 = a*c_abbc/rsqab;
-        Scalar a12 = -a / (rab*rcb);
-        Scalar a22 = a*c_abbc / rsqcb;
-
-        fab[0] = a11*dab.x + a12*dcb.x;
-        fab[1] = a11*dab.y + a12*dcb.y;
-        fab[2] = a11*dab.z + a12*dcb.z;
-
-        fcb[0] = a22*dcb.x + a12*dab.x;
-        fcb[1] = a22*dcb.y + a12*dab.y;
-        fcb[2] = a22*dcb.z + a12*dab.z;
-
-        // compute 1/3 of the energy, 1/3 for each atom in the angle
-        Scalar angle_eng = (Scalar(0.5)*tk*dth + eac)*Scalar(Scalar(1.0)/Scalar(3.0));
+        EvaluatorAngleCGCMM eval(dab, dcb, dac, params, cgSR, cgEPOW);
 
+        Scalar3 f_a, f_c;
+        Scalar eng;
         Scalar angle_virial[6];
-        angle_virial[0] = (1.f/3.f) * ( dab.x*fab[0] + dcb.x*fcb[0] );
-        angle_virial[1] = (1.f/3.f) * ( dab.y*fab[0] + dcb.y*fcb[0] );
-        angle_virial[2] = (1.f/3.f) * ( dab.z*fab[0] + dcb.z*fcb[0] );
-        angle_virial[3] = (1.f/3.f) * ( dab.y*fab[1] + dcb.y*fcb[1] );
-        angle_virial[4] = (1.f/3.f) * ( dab.z*fab[1] + dcb.z*fcb[1] );
-        angle_virial[5] = (1.f/3.f) * ( dab.z*fab[2] + dcb.z*fcb[2] );
+        eval.evaluate(f_a, f_c, eng, angle_virial);
 
+        // compute 1/3 of the energy and virial, 1/3 for each atom in the angle
+        Scalar angle_eng = eng*Scalar(Scalar(1.0)/Scalar(3.0));
         for (int i = 0; i < 6; i++)
-            angle_virial[i] += (1.f/3.f)*vac[i];
+            angle_virial[i] *= Scalar(Scalar(1.0)/Scalar(3.0));
 
-        if (cur_angle_abc == 0)
-            {
-            force_idx.x += fab[0] + fac*dac.x;
-            force_idx.y += fab[1] + fac*dac.y;
-            force_idx.z += fab[2] + fac*dac.z;
-            }
+        Scalar3 f_idx = f_a;
         if (cur_angle_abc == 1)
-            {
-            force_idx.x -= fab[0] + fcb[0];
-            force_idx.y -= fab[1] + fcb[1];
-            force_idx.z -= fab[2] + fcb[2];
-            }
+            f_idx = -(f_a + f_c);
         if (cur_angle_abc == 2)
-            {
-            force_idx.x += fcb[0] - fac*dac.x;
-            force_idx.y += fcb[1] - fac*dac.y;
-            force_idx.z += fcb[2] - fac*dac.z;
-            }
+            f_idx = f_c;
+
+        force_idx.x += f_idx.x;
+        force_idx.y += f_idx.y;
+        force_idx.z += f_idx.z;
 
         force_idx.w += angle_eng;
         for (int i = 0; i < 6; i++)
@@ -0,0 +1,16 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file CGCMMDriverPotentialPairGPU.cu
+    \brief Defines the driver function for computing CGCMM pair forces on the GPU
+*/
+
+#include "EvaluatorPairCGCMM.h"
+#include "CGCMMDriverPotentialPairGPU.cuh"
+
+cudaError_t gpu_compute_cgcmm_forces(const pair_args_t & args,
+                                     const Scalar4 *d_params)
+    {
+    return gpu_compute_pair_forces<EvaluatorPairCGCMM>(args,
+                                                       d_params);
+    }
@@ -0,0 +1,17 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file CGCMMDriverPotentialPairGPU.cuh
+    \brief Declares the driver function for computing CGCMM pair forces on the GPU
+*/
+
+#ifndef __CGCMM_DRIVER_POTENTIAL_PAIR_GPU_CUH__
+#define __CGCMM_DRIVER_POTENTIAL_PAIR_GPU_CUH__
+
+#include "hoomd/md/PotentialPairGPU.cuh"
+
+//! Compute cgcmm pair forces on the GPU with EvaluatorPairCGCMM
+cudaError_t gpu_compute_cgcmm_forces(const pair_args_t& pair_args,
+                                     const Scalar4 *d_params);
+
+#endif // __CGCMM_DRIVER_POTENTIAL_PAIR_GPU_CUH__
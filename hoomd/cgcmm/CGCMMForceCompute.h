@@ -56,6 +56,14 @@ class PYBIND11_EXPORT CGCMMForceCompute : public ForceCompute
         //! Calculates the requested log value and returns it
         virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
 
+        #ifdef ENABLE_MPI
+        //! The half-shell ghost exchange is not supported
+        virtual bool supportsHalfShell()
+            {
+            return false;
+            }
+        #endif
+
     protected:
         std::shared_ptr<NeighborList> m_nlist;    //!< The neighborlist to use for the computation
         Scalar m_r_cut;         //!< Cutoff radius beyond which the force is set to 0
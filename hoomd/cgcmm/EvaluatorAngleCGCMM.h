@@ -0,0 +1,126 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __ANGLE_EVALUATOR_CGCMM_H__
+#define __ANGLE_EVALUATOR_CGCMM_H__
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file EvaluatorAngleCGCMM.h
+    \brief Defines the evaluator class for the CGCMM angle potential
+*/
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+// DEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef NVCC
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+//! Class for evaluating the CGCMM angle potential
+/*! EvaluatorAngleCGCMM evaluates a harmonic angle potential in the angle theta between the three particles a-b-c
+    plus the repulsive part of a CGCMM pair potential between the outer particles a and c:
+    \f[ V = \frac{1}{2} K (\theta - \theta_0)^2 + \varepsilon + p \varepsilon \left[ \left( \frac{\sigma}{r_{ac}}
+        \right)^{n} - \left( \frac{\sigma}{r_{ac}} \right)^{m} \right] \f]
+    for \f$ r_{ac} < r_{cut} \f$, where \f$ r_{cut} \f$ is the minimum of the pair potential.
+
+    It is shared by CGCMMAngleForceCompute and the CGCMMAngleForceComputeGPU kernel, so that both evaluate the same
+    expressions. The parameters are packed as in the GPU implementation: \a K and \a t_0 in a Scalar2,
+    \a sigma and \a rcut in a Scalar2, and \a epsilon, \a n, \a m and the prefactor \a p in a Scalar4.
+*/
+class EvaluatorAngleCGCMM
+    {
+    public:
+        //! Constructs the angle evaluator
+        /*! \param _dab Minimum image vector from b to a
+            \param _dcb Minimum image vector from b to c
+            \param _dac Minimum image vector from c to a
+            \param params K (x) and t_0 (y)
+            \param sr sigma (x) and rcut (y) of the 1-3 repulsion
+            \param epow epsilon (x), n (y), m (z) and prefactor (w) of the 1-3 repulsion
+        */
+        DEVICE EvaluatorAngleCGCMM(const Scalar3& _dab, const Scalar3& _dcb, const Scalar3& _dac,
+                                   const Scalar2& params, const Scalar2& sr, const Scalar4& epow)
+            : dab(_dab), dcb(_dcb), dac(_dac), K(params.x), t_0(params.y), sigma(sr.x), rcut(sr.y),
+              eps(epow.x), pow1(epow.y), pow2(epow.z), pref(epow.w)
+            {
+            }
+
+        //! Evaluate the forces, energy and virial
+        /*! \param f_a Output, force on particle a
+            \param f_c Output, force on particle c, the force on particle b is -(f_a + f_c)
+            \param eng Output, total energy of the angle
+            \param virial Output, total virial of the angle (upper triangle xx, xy, xz, yy, yz, zz)
+        */
+        DEVICE void evaluate(Scalar3& f_a, Scalar3& f_c, Scalar& eng, Scalar* virial)
+            {
+            Scalar rsqab = dot(dab, dab);
+            Scalar rab = fast::sqrt(rsqab);
+            Scalar rsqcb = dot(dcb, dcb);
+            Scalar rcb = fast::sqrt(rsqcb);
+            Scalar rsqac = dot(dac, dac);
+            Scalar rac = fast::sqrt(rsqac);
+
+            Scalar c_abbc = dot(dab, dcb);
+            c_abbc /= rab*rcb;
+
+            if (c_abbc > Scalar(1.0)) c_abbc = Scalar(1.0);
+            if (c_abbc < -Scalar(1.0)) c_abbc = -Scalar(1.0);
+
+            // small number, cutoff for ignoring the angle as being ill defined
+            Scalar s_abbc = fast::sqrt(Scalar(1.0) - c_abbc*c_abbc);
+            if (s_abbc < Scalar(0.001)) s_abbc = Scalar(0.001);
+            s_abbc = Scalar(1.0)/s_abbc;
+
+            // the 1-3 repulsion
+            Scalar fac = Scalar(0.0);
+            Scalar eac = Scalar(0.0);
+            if (rac < rcut)
+                {
+                Scalar ratio = sigma/rac;
+                Scalar ratio_pow1 = fast::pow(ratio, pow1);
+                Scalar ratio_pow2 = fast::pow(ratio, pow2);
+                fac = pref*eps / rsqac * (pow1*ratio_pow1 - pow2*ratio_pow2);
+                eac = eps + pref*eps * (ratio_pow1 - ratio_pow2);
+                }
+
+            // the harmonic angle
+            Scalar dth = fast::acos(c_abbc) - t_0;
+            Scalar tk = K*dth;
+
+            Scalar a = -tk * s_abbc;
+            Scalar a11 = a*c_abbc/rsqab;
+            Scalar a12 = -a / (rab*rcb);
+            Scalar a22 = a*c_abbc / rsqcb;
+
+            Scalar3 fab = a11*dab + a12*dcb;
+            Scalar3 fcb = a22*dcb + a12*dab;
+
+            f_a = fab + fac*dac;
+            f_c = fcb - fac*dac;
+            eng = Scalar(0.5)*tk*dth + eac;
+
+            virial[0] = dab.x*fab.x + dcb.x*fcb.x + fac*dac.x*dac.x;
+            virial[1] = dab.y*fab.x + dcb.y*fcb.x + fac*dac.x*dac.y;
+            virial[2] = dab.z*fab.x + dcb.z*fcb.x + fac*dac.x*dac.z;
+            virial[3] = dab.y*fab.y + dcb.y*fcb.y + fac*dac.y*dac.y;
+            virial[4] = dab.z*fab.y + dcb.z*fcb.y + fac*dac.y*dac.z;
+            virial[5] = dab.z*fab.z + dcb.z*fcb.z + fac*dac.z*dac.z;
+            }
+
+    protected:
+        Scalar3 dab;    //!< Vector from b to a
+        Scalar3 dcb;    //!< Vector from b to c
+        Scalar3 dac;    //!< Vector from c to a
+        Scalar K;       //!< Stiffness of the harmonic angle
+        Scalar t_0;     //!< Rest angle
+        Scalar sigma;   //!< sigma of the 1-3 repulsion
+        Scalar rcut;    //!< Cutoff of the 1-3 repulsion
+        Scalar eps;     //!< epsilon of the 1-3 repulsion
+        Scalar pow1;    //!< Repulsive exponent
+        Scalar pow2;    //!< Attractive exponent
+        Scalar pref;    //!< Prefactor of the 1-3 repulsion
+    };
+
+#endif // __ANGLE_EVALUATOR_CGCMM_H__
@@ -0,0 +1,124 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __PAIR_EVALUATOR_CGCMM_H__
+#define __PAIR_EVALUATOR_CGCMM_H__
+
+#ifndef NVCC
+#include <string>
+#endif
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file EvaluatorPairCGCMM.h
+    \brief Defines the pair evaluator class for the CGCMM coarse grained potential
+*/
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+// DEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef NVCC
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+//! Class for evaluating the CGCMM pair potential
+/*! EvaluatorPairCGCMM evaluates the Lennard-Jones variants of the CMM coarse grained model with the same low level
+    parameters as CGCMMForceCompute:
+    \f[ V(r) = \frac{lj12}{r^{12}} + \frac{lj9}{r^9} + \frac{lj6}{r^6} + \frac{lj4}{r^4} \f]
+    \f[ -\frac{1}{r} \frac{\partial V}{\partial r} = r^{-2} \left( \frac{12 \cdot lj12}{r^{12}} + \frac{9 \cdot lj9}{r^9}
+        + \frac{6 \cdot lj6}{r^6} + \frac{4 \cdot lj4}{r^4} \right) \f]
+    Each type pair uses one of the exponent pairs 12-4, 9-6 or 12-6 and leaves the other two coefficients at 0, see
+    CGCMMForceCompute::setParams() for their relation to epsilon, sigma and alpha.
+
+    The CGCMM potential does not need diameter or charge. The four parameters are specified and stored in a Scalar4:
+    \a lj12 is placed in \a params.x, \a lj9 in \a params.y, \a lj6 in \a params.z and \a lj4 in \a params.w.
+*/
+class EvaluatorPairCGCMM
+    {
+    public:
+        //! Define the parameter type used by this pair potential evaluator
+        typedef Scalar4 param_type;
+
+        //! Constructs the pair potential evaluator
+        /*! \param _rsq Squared distance between the particles
+            \param _rcutsq Squared distance at which the potential goes to 0
+            \param _params Per type pair parameters of this potential
+        */
+        DEVICE EvaluatorPairCGCMM(Scalar _rsq, Scalar _rcutsq, const param_type& _params)
+            : rsq(_rsq), rcutsq(_rcutsq), lj12(_params.x), lj9(_params.y), lj6(_params.z), lj4(_params.w)
+            {
+            }
+
+        //! CGCMM doesn't use diameter
+        DEVICE static bool needsDiameter() { return false; }
+        //! Accept the optional diameter values
+        /*! \param di Diameter of particle i
+            \param dj Diameter of particle j
+        */
+        DEVICE void setDiameter(Scalar di, Scalar dj) { }
+
+        //! CGCMM doesn't use charge
+        DEVICE static bool needsCharge() { return false; }
+        //! Accept the optional diameter values
+        /*! \param qi Charge of particle i
+            \param qj Charge of particle j
+        */
+        DEVICE void setCharge(Scalar qi, Scalar qj) { }
+
+        //! Evaluate the force and energy
+        /*! \param force_divr Output parameter to write the computed force divided by r.
+            \param pair_eng Output parameter to write the computed pair energy
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+            \note There is no need to check if rsq < rcutsq in this method. Cutoff tests are performed
+                  in PotentialPair.
+
+            \return True if they are evaluated or false if they are not because we are beyond the cutoff
+        */
+        DEVICE bool evalForceAndEnergy(Scalar& force_divr, Scalar& pair_eng, bool energy_shift)
+            {
+            if (rsq < rcutsq && (lj12 != 0 || lj9 != 0))
+                {
+                Scalar r2inv = Scalar(1.0)/rsq;
+                Scalar r3inv = r2inv * fast::rsqrt(rsq);
+                Scalar r4inv = r2inv * r2inv;
+                Scalar r6inv = r3inv * r3inv;
+                force_divr = r2inv * (r6inv * (Scalar(12.0)*lj12*r6inv + Scalar(9.0)*lj9*r3inv + Scalar(6.0)*lj6)
+                                      + Scalar(4.0)*lj4*r4inv);
+
+                pair_eng = r6inv * (lj12*r6inv + lj9*r3inv + lj6) + lj4*r4inv;
+
+                if (energy_shift)
+                    {
+                    Scalar rcut2inv = Scalar(1.0)/rcutsq;
+                    Scalar rcut3inv = rcut2inv * fast::rsqrt(rcutsq);
+                    Scalar rcut6inv = rcut3inv * rcut3inv;
+                    pair_eng -= rcut6inv * (lj12*rcut6inv + lj9*rcut3inv + lj6) + lj4*rcut2inv*rcut2inv;
+                    }
+                return true;
+                }
+            else
+                return false;
+            }
+
+        #ifndef NVCC
+        //! Get the name of this potential
+        /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
+            via analyze.log.
+        */
+        static std::string getName()
+            {
+            return std::string("cgcmm");
+            }
+        #endif
+
+    protected:
+        Scalar rsq;     //!< Stored rsq from the constructor
+        Scalar rcutsq;  //!< Stored rcutsq from the constructor
+        Scalar lj12;    //!< 1/r^12 coefficient extracted from the params passed to the constructor
+        Scalar lj9;     //!< 1/r^9 coefficient extracted from the params passed to the constructor
+        Scalar lj6;     //!< 1/r^6 coefficient extracted from the params passed to the constructor
+        Scalar lj4;     //!< 1/r^4 coefficient extracted from the params passed to the constructor
+    };
+
+#endif // __PAIR_EVALUATOR_CGCMM_H__
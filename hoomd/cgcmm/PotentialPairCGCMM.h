@@ -0,0 +1,31 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __POTENTIAL_PAIR_CGCMM_H__
+#define __POTENTIAL_PAIR_CGCMM_H__
+
+#include "hoomd/md/PotentialPair.h"
+#include "EvaluatorPairCGCMM.h"
+
+#ifdef ENABLE_CUDA
+#include "hoomd/md/PotentialPairGPU.h"
+#include "CGCMMDriverPotentialPairGPU.cuh"
+#endif
+
+/*! \file PotentialPairCGCMM.h
+    \brief Typedefs for the CGCMM pair potential on the PotentialPair template
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+//! Pair potential force compute for CGCMM forces
+typedef PotentialPair<EvaluatorPairCGCMM> PotentialPairCGCMM;
+
+#ifdef ENABLE_CUDA
+//! Pair potential force compute for CGCMM forces on the GPU
+typedef PotentialPairGPU<EvaluatorPairCGCMM, gpu_compute_cgcmm_forces> PotentialPairCGCMMGPU;
+#endif
+
+#endif // __POTENTIAL_PAIR_CGCMM_H__
@@ -3,6 +3,7 @@
 
 #include "CGCMMAngleForceCompute.h"
 #include "CGCMMForceCompute.h"
+#include "PotentialPairCGCMM.h"
 
 // include GPU classes
 #ifdef ENABLE_CUDA
@@ -20,9 +21,11 @@ PYBIND11_MODULE(_cgcmm, m)
     {
     export_CGCMMAngleForceCompute(m);
     export_CGCMMForceCompute(m);
+    export_PotentialPair<PotentialPairCGCMM>(m, "PotentialPairCGCMM");
 
 #ifdef ENABLE_CUDA
     export_CGCMMForceComputeGPU(m);
     export_CGCMMAngleForceComputeGPU(m);
+    export_PotentialPairGPU<PotentialPairCGCMMGPU, PotentialPairCGCMM>(m, "PotentialPairCGCMMGPU");
 #endif
     }
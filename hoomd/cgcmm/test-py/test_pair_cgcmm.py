@@ -49,6 +49,31 @@ class pair_cgcmm_tests (unittest.TestCase):
         cg.pair_coeff.set('B', 'B', epsilon=1.0, sigma=1.0, alpha=1.0, exponents='lj12_4');
         cg.update_coeffs();
 
+    # test the energy of a single pair against the analytic expression
+    def test_energy(self):
+        context.initialize();
+        snap = data.make_snapshot(N=2, box=data.boxdim(L=20));
+        if comm.get_rank() == 0:
+            snap.particles.position[0] = (0,0,0);
+            snap.particles.position[1] = (1.1,0,0);
+        self.s = init.read_snapshot(snap);
+        self.nl = md.nlist.cell();
+
+        cg = cgcmm.pair.cgcmm(r_cut=3.0, nlist = self.nl);
+        cg.pair_coeff.set('A', 'A', epsilon=1.5, sigma=1.0, alpha=0.5, exponents='LJ9-6');
+        cg.set_params(mode='shift');
+        md.integrate.mode_standard(dt=0.0);
+        md.integrate.nve(group=group.all());
+        run(1);
+
+        def V(r):
+            return 6.75*1.5*((1.0/r)**9 - 0.5*(1.0/r)**6);
+        f = 6.75*1.5*(9.0/1.1**10 - 0.5*6.0/1.1**7);
+
+        self.assertAlmostEqual(self.s.particles[0].net_energy, 0.5*(V(1.1)-V(3.0)), 5);
+        self.assertAlmostEqual(self.s.particles[0].net_force[0], -f, 4);
+        self.assertAlmostEqual(self.s.particles[1].net_force[0], f, 4);
+
     def tearDown(self):
         del self.s, self.nl
         context.initialize();
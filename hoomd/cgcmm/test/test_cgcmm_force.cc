@@ -11,6 +11,7 @@
 #include <memory>
 
 #include "hoomd/cgcmm/CGCMMForceCompute.h"
+#include "hoomd/cgcmm/PotentialPairCGCMM.h"
 #ifdef ENABLE_CUDA
 #include "hoomd/cgcmm/CGCMMForceComputeGPU.h"
 #endif
@@ -504,6 +505,71 @@ void cgcmm_force_comparison_test(cgcmmforce_creator cgcmm_creator1, cgcmmforce_c
     }
     }
 
+//! Compare PotentialPairCGCMM against CGCMMForceCompute for all three exponent pairs
+template<class PP>
+void cgcmm_potential_pair_comparison_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 1000;
+    Scalar r_cut(2.5);
+
+    // create a random particle system to sum forces on
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap;
+    snap = rand_init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, r_cut, Scalar(0.8)));
+    nlist->setStorageMode(NeighborList::full);
+
+    std::shared_ptr<CGCMMForceCompute> fc_ref(new CGCMMForceCompute(sysdef, nlist, r_cut));
+    std::shared_ptr<PP> fc_pair(new PP(sysdef, nlist));
+    fc_pair->setRcut(0, 0, r_cut);
+
+    Scalar epsilon = Scalar(1.1);
+    Scalar sigma = Scalar(0.9);
+    Scalar alpha = Scalar(0.8);
+    Scalar params[3][4] = {
+        {Scalar(2.59807621135332)*epsilon*pow(sigma,Scalar(12.0)), 0, 0,
+         -alpha*Scalar(2.59807621135332)*epsilon*pow(sigma,Scalar(4.0))},
+        {0, Scalar(6.75)*epsilon*pow(sigma,Scalar(9.0)), -alpha*Scalar(6.75)*epsilon*pow(sigma,Scalar(6.0)), 0},
+        {Scalar(4.0)*epsilon*pow(sigma,Scalar(12.0)), 0, -alpha*Scalar(4.0)*epsilon*pow(sigma,Scalar(6.0)), 0}};
+
+    for (unsigned int variant = 0; variant < 3; variant++)
+        {
+        const Scalar* p = params[variant];
+        fc_ref->setParams(0,0,p[0],p[1],p[2],p[3]);
+        fc_pair->setParams(0,0,make_scalar4(p[0],p[1],p[2],p[3]));
+
+        fc_ref->compute(variant);
+        fc_pair->compute(variant);
+
+        ArrayHandle<Scalar4> h_force_ref(fc_ref->getForceArray(),access_location::host,access_mode::read);
+        ArrayHandle<Scalar> h_virial_ref(fc_ref->getVirialArray(),access_location::host,access_mode::read);
+        ArrayHandle<Scalar4> h_force(fc_pair->getForceArray(),access_location::host,access_mode::read);
+        ArrayHandle<Scalar> h_virial(fc_pair->getVirialArray(),access_location::host,access_mode::read);
+        unsigned int pitch_ref = fc_ref->getVirialArray().getPitch();
+        unsigned int pitch = fc_pair->getVirialArray().getPitch();
+
+        // compare average deviation between the two computes
+        double deltaf2 = 0.0;
+        double deltape2 = 0.0;
+        double deltav2 = 0.0;
+        for (unsigned int i = 0; i < N; i++)
+            {
+            Scalar3 df = make_scalar3(h_force.data[i].x - h_force_ref.data[i].x,
+                                      h_force.data[i].y - h_force_ref.data[i].y,
+                                      h_force.data[i].z - h_force_ref.data[i].z);
+            deltaf2 += double(dot(df, df));
+            deltape2 += double(h_force.data[i].w - h_force_ref.data[i].w) * double(h_force.data[i].w - h_force_ref.data[i].w);
+            for (unsigned int j = 0; j < 6; j++)
+                deltav2 += double(h_virial.data[j*pitch+i] - h_virial_ref.data[j*pitch_ref+i])
+                           * double(h_virial.data[j*pitch+i] - h_virial_ref.data[j*pitch_ref+i]);
+            }
+        CHECK_SMALL(deltaf2 / double(N), double(tol_small));
+        CHECK_SMALL(deltape2 / double(N), double(tol_small));
+        CHECK_SMALL(deltav2 / double(N), double(tol_small));
+        }
+    }
+
 //! CGCMMForceCompute creator for unit tests
 std::shared_ptr<CGCMMForceCompute> base_class_cgcmm_creator(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<NeighborList> nlist, Scalar r_cut)
     {
@@ -543,6 +609,12 @@ UP_TEST( CGCMMForce_periodic )
     cgcmm_force_periodic_test(cgcmm_creator_base, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! test case for comparing PotentialPairCGCMM to CGCMMForceCompute on the CPU
+UP_TEST( PotentialPairCGCMM_compare )
+    {
+    cgcmm_potential_pair_comparison_test<PotentialPairCGCMM>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 # ifdef ENABLE_CUDA
 //! test case for particle test on GPU - threaded
 UP_TEST( CGCMMForceGPU_particle124 )
@@ -573,4 +645,10 @@ UP_TEST( CGCMMForceGPU_compare )
     cgcmm_force_comparison_test(cgcmm_creator_base, cgcmm_creator_gpu, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 
+//! test case for comparing PotentialPairCGCMMGPU to CGCMMForceCompute
+UP_TEST( PotentialPairCGCMMGPU_compare )
+    {
+    cgcmm_potential_pair_comparison_test<PotentialPairCGCMMGPU>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
 #endif
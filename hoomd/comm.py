@@ -92,6 +92,9 @@ class decomposition(object):
         nx (int): Number of processors to uniformly space in x dimension (if *x* is None)
         ny (int): Number of processors to uniformly space in y dimension (if *y* is None)
         nz (int): Number of processors to uniformly space in z dimension (if *z* is None)
+        bisect (bool): If True, place the cut planes by recursive bisection of the initial particle distribution.
+        tag_directory (bool): If True, find the ranks that own particles with a distributed directory.
+        half_shell (bool): If True, import ghost particles from half of the neighboring domains only (CPU only).
 
     A single domain decomposition is defined for the simulation.
     A standard domain decomposition divides the simulation box into equal volumes along the Cartesian axes while minimizing
@@ -115,16 +118,46 @@ class decomposition(object):
     decomposition can only be called *before* the system is initialized, at which point the particles are decomposed.
     An error is raised if the system is already initialized.
 
+    With *bisect*, the cut planes are placed when the system is initialized so that every slab of domains holds an
+    equal share of the particles. Along each dimension, the slab of :math:`n` domains is split into two halves of
+    :math:`\lfloor n/2 \rfloor` and :math:`n - \lfloor n/2 \rfloor` domains at the plane below which this share of the
+    particles lies, and the halves are bisected again until each slab contains one domain. The number of domains
+    along each dimension is kept, and fractional widths given in *x*, *y* or *z* are replaced. No domain is made
+    narrower than a quarter of its uniform width. Because the domains still form a Cartesian grid, the cuts along one
+    dimension are the same for all domains, so a single dense region (such as a droplet) is balanced only as well as its
+    projections onto the axes allow.
+
     The decomposition can be adjusted dynamically if the best static decomposition is not known, or the system
     composition is changing dynamically. For this associated command, see update.balance().
 
     Priority is always given to specified arguments over the command line arguments. If one of these is not set but
     a command line option is, then the command line option is used. Otherwise, a default decomposition is chosen.
 
+    Accessing a single particle from python (e.g. ``system.particles[i].position``) must first find the rank that
+    owns it. By default, all ranks are searched with two reductions for every access. With *tag_directory*, the owners
+    are kept in a directory that is distributed over the ranks, each rank holding a contiguous block of the tags. The
+    directory is rebuilt with a single exchange on the first access after the particles have migrated, and each access
+    is then answered by the rank that holds the tag with one broadcast. This speeds up loops over particles between
+    runs at the cost of one exchange after every run.
+
+    With *half_shell*, every pair of particles on different ranks is evaluated by only one of the two ranks. The
+    ghosts are only imported from the neighbors in the forward half-shell (lexicographically positive domain offsets)
+    and the forces on the ghosts are sent back to the ranks that own them, which halves the pair evaluations across
+    domain boundaries and the number of ghosts received from the neighbors in x. It requires a half neighbor list and
+    is supported by the isotropic pair potentials of the md package only (no anisotropic, table, DPD or many-body
+    potentials, and no constraints or rigid bodies). It is not available on the GPU. The per-particle virials and
+    energies of particles next to a domain boundary differ from the default, their sums do not.
+
+    .. versionadded:: 2.5
+       The *tag_directory* and *half_shell* options.
+
     Examples::
 
         comm.decomposition(x=0.4, ny=2, nz=2)
         comm.decomposition(nx=2, y=0.8, z=[0.2,0.3])
+        comm.decomposition(nx=2, ny=2, nz=2, bisect=True)
+        comm.decomposition(nx=2, ny=2, nz=2, tag_directory=True)
+        comm.decomposition(nx=2, ny=2, nz=2, half_shell=True)
 
     Warning:
         The decomposition command will override specified command line options.
@@ -142,7 +175,7 @@ class decomposition(object):
         raised if both are set.
     """
 
-    def __init__(self, x=None, y=None, z=None, nx=None, ny=None, nz=None):
+    def __init__(self, x=None, y=None, z=None, nx=None, ny=None, nz=None, bisect=False, tag_directory=False, half_shell=False):
         hoomd.util.print_status_line()
 
         # check that system is not initialized
@@ -155,6 +188,10 @@ class decomposition(object):
             hoomd.context.msg.error("comm.decomposition: call context.initialize() before decomposition can be set\n")
             raise RuntimeError("Cannot initialize decomposition without context.initialize() first")
 
+        if half_shell and hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.msg.error("comm.decomposition: the half-shell ghost exchange is not available on the GPU\n")
+            raise RuntimeError("Error setting up the domain decomposition")
+
         # check that there are ranks available for decomposition
         if get_num_ranks() == 1:
             hoomd.context.msg.warning("Only 1 rank in system, ignoring decomposition to use optimized code pathways.\n")
@@ -169,6 +206,9 @@ class decomposition(object):
             self.uniform_x = True
             self.uniform_y = True
             self.uniform_z = True
+            self.bisect = bisect
+            self.tag_directory = tag_directory
+            self.half_shell = half_shell
 
             hoomd.util.quiet_status()
             self.set_params(x,y,z,nx,ny,nz)
@@ -309,6 +349,13 @@ class decomposition(object):
             self.cpp_dd = _hoomd.DomainDecomposition(hoomd.context.exec_conf, box.getL(), fxs, fys, fzs)
             return self.cpp_dd
 
+    ## \internal
+    # \brief Place the cut planes by recursive bisection of the particles in a snapshot
+    # \param snapshot Snapshot of the initial configuration
+    def _bisect_particles(self, snapshot):
+        # no domain may be narrower than a quarter of its uniform width
+        self.cpp_dd.bisectParticles(snapshot, 0.25)
+
         except TypeError as te:
             hoomd.context.msg.error("Fractional cuts must be iterable (list, tuple, etc.)\n")
             raise te
@@ -266,6 +266,251 @@ class thermo(_compute):
 
         hoomd.context.current.thermo.append(self)
 
+class thermo_multi(_compute):
+    R""" Compute thermodynamic properties of many groups of particles at once.
+
+    Args:
+        groups (list): Groups (:py:mod:`hoomd.group`) to compute thermodynamic properties for, at most 32.
+
+    :py:class:`thermo_multi` provides the same log quantities as :py:class:`thermo` for every group in *groups*,
+    suffixed with *_groupname* (no suffix for the group of all particles). Instead of looping over the members of
+    each group, it reads the data of every particle once and adds its contributions to all groups the particle is a
+    member of. In MPI simulations, the properties of all groups are summed in a single reduction. Use it in place of
+    many :py:class:`thermo` computes when properties of many groups are logged.
+
+    Do not create a :py:class:`thermo` for any of the groups in *groups*, the log quantity names would collide.
+
+    Examples::
+
+        groups = [group.type(name='type' + t, type=t) for t in ['A', 'B', 'C']]
+        compute.thermo_multi(groups=groups)
+        analyze.log(filename='log.dat', quantities=['temperature_typeA', 'pressure_typeB'], period=100)
+
+    .. versionadded:: 2.5
+    """
+
+    def __init__(self, groups):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        _compute.__init__(self);
+
+        groups = list(groups);
+        if len(groups) > 32:
+            hoomd.context.msg.error("compute.thermo_multi: At most 32 groups are supported\n");
+            raise ValueError('Too many groups');
+
+        suffixes = [];
+        for g in groups:
+            if g.name == 'all':
+                suffixes.append('');
+            else:
+                suffixes.append('_' + g.name);
+
+            # warn user if an existing compute thermo already uses this group name
+            for t in hoomd.context.current.thermos:
+                if t.group.name == g.name:
+                    hoomd.context.msg.warning("compute.thermo already specified for a group with name " + str(g.name) + "\n");
+
+        # create the c++ mirror class
+        if not hoomd.context.exec_conf.isCUDAEnabled():
+            self.cpp_compute = _hoomd.ComputeThermoMulti(hoomd.context.current.system_definition);
+        else:
+            self.cpp_compute = _hoomd.ComputeThermoMultiGPU(hoomd.context.current.system_definition);
+
+        for g,suffix in zip(groups, suffixes):
+            self.cpp_compute.addGroup(g.cpp_group, suffix);
+
+        hoomd.context.current.system.addCompute(self.cpp_compute, self.compute_name);
+
+        # save the groups for later referencing
+        self.groups = groups;
+        # add ourselves to the list of compute thermo_multis specified so far
+        hoomd.context.current.thermo_multis.append(self);
+
+    def disable(self):
+        R""" Disables the thermo_multi compute.
+
+        Examples::
+
+            my_thermo.disable()
+
+        A disabled thermo_multi compute can be re-enabled with :py:meth:`enable()`.
+        """
+        hoomd.util.print_status_line()
+
+        hoomd.util.quiet_status()
+        _compute.disable(self)
+        hoomd.util.unquiet_status()
+
+        hoomd.context.current.thermo_multis.remove(self)
+
+    def enable(self):
+        R""" Enables the thermo_multi compute.
+
+        Examples::
+
+            my_thermo.enable()
+
+        See :py:meth:`disable()`.
+        """
+        hoomd.util.print_status_line()
+
+        hoomd.util.quiet_status()
+        _compute.enable(self)
+        hoomd.util.unquiet_status()
+
+        hoomd.context.current.thermo_multis.append(self)
+
+class dynamics(_compute):
+    R""" Compute the mean squared displacement and the self intermediate scattering function of a group.
+
+    Args:
+        group (:py:mod:`hoomd.group`): Group to average over.
+        origins (int): Number of time origins.
+        origin_period (int): Number of time steps between consecutive time origins.
+        k (float): Wave number of the self intermediate scattering function (in inverse distance units).
+
+    :py:class:`dynamics` measures how far the particles in *group* moved since each of *origins* time origins.
+    The displacements :math:`\Delta \vec{r}` include the periodic images, so particles that cross the boundaries of
+    the box are tracked correctly. For every origin *i*, it provides the log quantities:
+
+    * **msd_i_groupname** - the mean squared displacement :math:`\langle |\Delta \vec{r}|^2 \rangle`
+    * **isf_i_groupname** - the self intermediate scattering function :math:`\langle \cos(k \Delta x) \rangle`,
+      averaged over the x, y, and z directions (x and y in 2D)
+    * **msd_origin_i_groupname** - the time step at which origin *i* was set
+
+    There is no *_groupname* suffix for the group of all particles. The origins are staggered by *origin_period*
+    time steps: origin *i* is set when the compute is first evaluated at or after the time steps
+    :math:`t_0 + (j \cdot origins + i) \cdot origin\_period`, where :math:`t_0` is the time step of the first
+    evaluation. Each origin is reset after *origins* * *origin_period* steps. The lag time of origin *i* is the
+    current time step minus **msd_origin_i**. Log the quantities with a period that divides *origin_period* so
+    that the origins are set on time.
+
+    Unlike :py:class:`hoomd.deprecated.analyze.msd`, the reference positions of all origins stay in the memory of
+    every rank (on the GPU in GPU simulations), indexed by particle tag. Logging the quantities does not gather a
+    snapshot, and the sums of all origins are reduced with a single MPI collective. Setting an origin in MPI
+    simulations sums the reference positions over all ranks.
+
+    Note:
+        The reference positions need memory for *origins* positions and images per particle in the system on
+        every rank.
+
+    Examples::
+
+        dyn = compute.dynamics(group=group.all(), origins=4, origin_period=1000, k=7.2)
+        analyze.log(filename='dynamics.log', quantities=['msd_0', 'msd_origin_0', 'isf_0'], period=100)
+
+    .. versionadded:: 2.5
+    """
+
+    def __init__(self, group, origins=1, origin_period=1000000000, k=2*3.141592653589793):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        _compute.__init__(self);
+
+        if origins < 1:
+            hoomd.context.msg.error("compute.dynamics: At least one time origin is required\n");
+            raise ValueError('Invalid number of origins');
+
+        if origin_period < 1:
+            hoomd.context.msg.error("compute.dynamics: origin_period must be at least 1\n");
+            raise ValueError('Invalid origin period');
+
+        if group.name == 'all':
+            suffix = '';
+        else:
+            suffix = '_' + group.name;
+
+        # create the c++ mirror class
+        if not hoomd.context.exec_conf.isCUDAEnabled():
+            self.cpp_compute = _hoomd.ComputeDynamics(hoomd.context.current.system_definition, group.cpp_group,
+                                                      int(origins), int(origin_period), float(k), suffix);
+        else:
+            self.cpp_compute = _hoomd.ComputeDynamicsGPU(hoomd.context.current.system_definition, group.cpp_group,
+                                                         int(origins), int(origin_period), float(k), suffix);
+
+        hoomd.context.current.system.addCompute(self.cpp_compute, self.compute_name);
+
+        # save the group for later referencing
+        self.group = group;
+        self.origins = origins;
+
+class load_imbalance(_compute):
+    R""" Measure the load imbalance between MPI ranks from timings.
+
+    :py:class:`load_imbalance` splits the wall clock time of each rank into the time spent waiting for the ghost
+    and migration messages of the domain decomposition (*exchange*), the time spent in the collectives of the time
+    step loop such as the neighbor list distance check and the reduction of thermodynamic properties
+    (*collective*), and the remaining *busy* time. Each evaluation measures the window since the previous
+    evaluation, and reports the times per time step reduced over all ranks. A rank that finishes its work early
+    waits for the slowest rank, so that the busy times of the ranks differ while their total times do not.
+
+    The quantities provided are:
+
+    * **load_imbalance** - maximum busy time of any rank divided by the average busy time of the ranks (1 is balanced)
+    * **load_busy_min**, **load_busy_avg**, **load_busy_max** - minimum, average, and maximum busy time
+      per time step over the ranks (in seconds)
+    * **load_wait_exchange_min**, **load_wait_exchange_avg**, **load_wait_exchange_max** - time waiting for
+      point to point messages per time step (in seconds)
+    * **load_wait_collective_min**, **load_wait_collective_avg**, **load_wait_collective_max** - time in
+      collectives per time step (in seconds)
+
+    The matrix quantity **load_rank_times** holds one row per rank with its busy, exchange, and collective times per
+    time step, see :py:class:`hoomd.analyze.log_matrix`. At the end of each run, a histogram of the fraction of the
+    time each rank was busy is printed.
+
+    Pass the compute to :py:class:`hoomd.update.balance` to adjust the domains only when the measured imbalance
+    exceeds the tolerance.
+
+    The windows are delimited by the evaluations, so log the quantities with a fixed period. All ranks must evaluate
+    the compute on the same time steps, which is the case for :py:class:`hoomd.analyze.log`.
+
+    :py:class:`load_imbalance` is ignored if there is no domain decomposition available (MPI is not built or is
+    running on a single rank).
+
+    Examples::
+
+        imb = compute.load_imbalance()
+        analyze.log(filename='load.log', quantities=['load_imbalance', 'load_busy_max', 'load_wait_exchange_max'], period=1000)
+        update.balance(timing=imb)
+
+    .. versionadded:: 2.5
+    """
+
+    def __init__(self):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        _compute.__init__(self);
+
+        # the timings cannot be reduced without mpi
+        if not _hoomd.is_MPI_available() or hoomd.context.current.decomposition is None:
+            hoomd.context.msg.warning("Ignoring load_imbalance command, not supported in current configuration.\n")
+            self.enabled = False;
+            return
+
+        # create the c++ mirror class
+        self.cpp_compute = _hoomd.LoadImbalanceCompute(hoomd.context.current.system_definition);
+        hoomd.context.current.system.addCompute(self.cpp_compute, self.compute_name);
+
+    def get_imbalance(self):
+        R""" Get the load imbalance of the last measured window.
+
+        Returns:
+            The maximum busy time over the average busy time, 1.0 if no window was measured or if the compute
+            is ignored.
+
+        Examples::
+
+            imb.get_imbalance()
+        """
+        if self.cpp_compute is None:
+            return 1.0
+
+        return self.cpp_compute.getImbalance();
+
 ## \internal
 # \brief Returns the previously created compute.thermo with the same group, if created. Otherwise, creates a new
 # compute.thermo
@@ -148,6 +148,9 @@ class SimulationContext(object):
         ## Global variable tracking all the compute thermos that have been created
         self.thermos = [];
 
+        ## Global variable tracking all the compute thermo_multis that have been created
+        self.thermo_multis = [];
+
         ## Cached all group
         self.group_all = None;
 
@@ -327,6 +330,16 @@ def _create_exec_conf(mpi_comm):
         if options.nthreads != None:
             exec_conf.setNumThreads(options.nthreads)
 
+        # pin the threads before any arrays are first touched
+        if options.thread_affinity is not None:
+            exec_conf.setThreadAffinity(options.thread_affinity)
+
+        if options.first_touch is not None:
+            exec_conf.setParallelFirstTouch(options.first_touch == 'on')
+
+    if options.huge_pages is not None:
+        exec_conf.setHugePages(options.huge_pages == 'on')
+
     exec_conf = exec_conf;
 
     return exec_conf;
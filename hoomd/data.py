@@ -9,13 +9,15 @@ Code in the data package provides high-level access to all of the particle, bond
 current state of the system. You can use python code to directly read and modify this data, allowing you to analyze
 simulation results while the simulation runs, or to create custom initial configurations with python code.
 
-There are two ways to access the data.
+There are three ways to access the data.
 
 1. Snapshots record the system configuration at one instant in time. You can store this state to analyze the data,
    restore it at a future point in time, or to modify it and reload it. Use snapshots for initializing simulations,
    or when you need to access or modify the entire simulation state.
 2. Data proxies directly access the current simulation state. Use data proxies if you need to only touch a few
    particles or bonds at a a time.
+3. Local access (:py:meth:`hoomd.data.particle_data.local_access()`) exposes the particle arrays of each rank
+   without copying them. Use it for frequent in-situ analysis in python.
 
 .. rubric:: Snapshots
 
@@ -892,6 +894,11 @@ class system_data(hoomd.meta._metadata):
                 if the snapshot is of a previous state of the currently running system. Otherwise, you need to use
                 restore_snapshot() between run() commands to ensure that all per type coefficients are updated properly.
 
+        When the snapshot has the same number of particles, the same particle types, bodies, and bonded groups as the
+        current system, and the simulation is not domain decomposed, restore_snapshot() overwrites the particle
+        properties in place. It then only invalidates the neighbor lists, which makes restoring a snapshot many times
+        cheap (added in version 2.5). Otherwise, the system is fully re-initialized from the snapshot.
+
         """
         hoomd.util.print_status_line();
 
@@ -1142,6 +1149,155 @@ class particle_data(hoomd.meta._metadata):
         data['types'] = list(self.types);
         return data
 
+    def local_access(self, device=False, readonly=False, ghosts=False):
+        R""" Access the particle data of this rank without copying.
+
+        Args:
+            device (bool): Set to True to access the arrays in GPU memory.
+            readonly (bool): Set to True to prevent modifications.
+            ghosts (bool): Set to True to include the ghost particles after the local particles.
+
+        Returns:
+            A context manager that exposes the arrays ``position``, ``velocity`` and ``net_force`` (N x 3),
+            ``tag`` (N) and ``rtag`` (one entry per tag).
+
+        Unlike :py:meth:`hoomd.data.system_data.take_snapshot()`, :py:meth:`local_access()` does not gather the
+        particles to the root rank and does not copy them. The arrays reference the internal memory of the local
+        particles, in the order in which they are stored, which changes when particles are sorted or migrate
+        between ranks. On the host, the arrays are numpy arrays. On the device, they are objects that implement
+        ``__cuda_array_interface__`` and can be passed to e.g. ``cupy.asarray`` or numba.
+
+        The arrays are only valid inside of the ``with`` block. They must not be stored and used after the
+        block ends, and :py:func:`hoomd.run()` cannot be called inside of it.
+
+        Writes to the arrays (when *readonly* is False) change the state of the simulation.
+
+        .. versionadded:: 2.5
+
+        Examples::
+
+            with system.particles.local_access(readonly=True) as data:
+                com = numpy.mean(data.position, axis=0)
+
+            with system.particles.local_access(device=True) as data:
+                vel = cupy.asarray(data.velocity)
+                vel *= 0.5
+        """
+        return local_particle_access(self.pdata, device, readonly, ghosts)
+
+    def get_properties(self, tags, fields=None):
+        R""" Get properties of many particles at once.
+
+        Args:
+            tags (list): Tags of the particles.
+            fields (list): Names of the properties to get, from ``position``, ``image``, ``velocity``, ``mass``,
+                ``typeid``, ``charge``, ``diameter``, ``body`` and ``orientation``. Set to None to get all of them.
+
+        Returns:
+            A dict that maps the property names to numpy arrays with one row per tag, in the order of *tags*.
+
+        :py:meth:`get_properties()` returns the same values as the particle proxies, but gathers all particles
+        with one access to the particle data instead of one access per particle and property. In MPI
+        simulations, it must be called on all ranks with the same *tags*, and every rank receives the values.
+        The arrays are copies, modifying them does not change the state of the simulation.
+
+        .. versionadded:: 2.5
+
+        Examples::
+
+            props = system.particles.get_properties(range(100), ['position', 'typeid'])
+            avg = numpy.mean(props['position'], axis=0)
+        """
+        return _get_properties(self.pdata, tags, fields)
+
+## \internal
+# \brief Flags of the properties gathered by _get_properties()
+_tag_fields = {'position': _hoomd.TagField.position,
+               'image': _hoomd.TagField.position,
+               'velocity': _hoomd.TagField.velocity,
+               'mass': _hoomd.TagField.velocity,
+               'typeid': _hoomd.TagField.type,
+               'charge': _hoomd.TagField.charge,
+               'diameter': _hoomd.TagField.diameter,
+               'body': _hoomd.TagField.body,
+               'orientation': _hoomd.TagField.orientation}
+
+## \internal
+# \brief Get properties of a list of particles with a single call to ParticleData
+#
+# See particle_data.get_properties()
+def _get_properties(pdata, tags, fields):
+    if fields is None:
+        fields = list(_tag_fields.keys());
+
+    flags = 0;
+    for f in fields:
+        if f not in _tag_fields:
+            hoomd.context.msg.error("Unknown particle property " + str(f) + "\n");
+            raise ValueError("Error getting particle properties");
+        flags |= int(_tag_fields[f]);
+
+    result = pdata.getByTag(tags, flags);
+    return dict((f, result[f]) for f in fields);
+
+## \internal
+# \brief Wraps a CUDA array interface dictionary
+class _cuda_array(object):
+    def __init__(self, interface, owner):
+        self.__cuda_array_interface__ = interface;
+        # keep the particle data access alive as long as this array exists
+        self._owner = owner;
+
+    @property
+    def shape(self):
+        return self.__cuda_array_interface__['shape'];
+
+## \internal
+# \brief Context manager for the zero-copy access to the local particle data
+#
+# See particle_data.local_access()
+class local_particle_access(object):
+    def __init__(self, pdata, device, readonly, ghosts):
+        self._device = device;
+        self._readonly = readonly;
+        self._cpp = _hoomd.LocalParticleData(pdata, device, readonly, ghosts);
+
+    def __enter__(self):
+        self._cpp.enter();
+        return self;
+
+    def __exit__(self, exc_type, exc_value, traceback):
+        self._cpp.exit();
+        return False;
+
+    def _wrap(self, array):
+        if self._device:
+            return _cuda_array(array, self._cpp);
+
+        if self._readonly:
+            array.flags.writeable = False;
+        return array;
+
+    @property
+    def position(self):
+        return self._wrap(self._cpp.position);
+
+    @property
+    def velocity(self):
+        return self._wrap(self._cpp.velocity);
+
+    @property
+    def net_force(self):
+        return self._wrap(self._cpp.net_force);
+
+    @property
+    def tag(self):
+        return self._wrap(self._cpp.tag);
+
+    @property
+    def rtag(self):
+        return self._wrap(self._cpp.rtag);
+
 class particle_data_proxy(object):
     R""" Access a single particle via a proxy.
 
@@ -2307,6 +2463,85 @@ def gsd_snapshot(filename, frame=0):
     reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, abs(frame), frame < 0);
     return reader.getSnapshot();
 
+class gsd_reader(object):
+    R""" Read many frames of a GSD file.
+
+    Args:
+        filename (str): GSD file to read.
+
+    :py:class:`gsd_reader` keeps the file open and indexes its chunks by frame and name once, so that reading a
+    frame or a single chunk does not scan the file again. Use it instead of repeated calls to
+    :py:func:`hoomd.data.gsd_snapshot()` to replay long trajectories.
+
+    Only the root rank reads the file. On the other ranks, :py:meth:`snapshot()` returns empty snapshots and
+    :py:meth:`read_chunk()` reads nothing.
+
+    Examples::
+
+        reader = data.gsd_reader('trajectory.gsd')
+        for i in range(reader.nframes):
+            snap = reader.snapshot(i)
+
+        pos = numpy.empty((N, 3), dtype=numpy.float32)
+        reader.read_chunk(10, 'particles/position', pos)
+
+    .. versionadded:: 2.5
+    """
+    def __init__(self, filename):
+        hoomd.context._verify_init();
+
+        self.filename = filename;
+        self.cpp_reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, 0, False);
+
+    @property
+    def nframes(self):
+        R""" Number of frames in the file (0 on ranks that do not read the file). """
+        return self.cpp_reader.getNFrames();
+
+    def snapshot(self, frame):
+        R""" Read a snapshot.
+
+        Args:
+            frame (int): Frame to read. Negative values index from the end of the file.
+
+        Returns:
+            The snapshot of the frame.
+        """
+        if frame < 0:
+            frame += self.nframes;
+            if frame < 0:
+                if self.nframes > 0:
+                    hoomd.context.msg.error("data.gsd_reader: Cannot read frame " + str(frame - self.nframes) + "\n");
+                    raise RuntimeError("Error reading GSD file");
+                # ranks that do not read the file have no frames
+                frame = 0;
+        self.cpp_reader.readFrame(frame);
+        return self.cpp_reader.getSnapshot();
+
+    def has_chunk(self, frame, name):
+        R""" Test if a chunk is stored at a frame.
+
+        Args:
+            frame (int): Frame index.
+            name (str): Name of the chunk, such as ``particles/position``.
+        """
+        return self.cpp_reader.hasChunk(frame, name);
+
+    def read_chunk(self, frame, name, out):
+        R""" Read a single chunk into a preallocated array.
+
+        Args:
+            frame (int): Frame index.
+            name (str): Name of the chunk, such as ``particles/position``.
+            out (numpy.ndarray): C-contiguous array with exactly the size of the chunk in bytes.
+
+        As in the GSD specification, the chunk is read from frame 0 when it is not stored at *frame*.
+
+        Returns:
+            True if the chunk was read into *out*.
+        """
+        return self.cpp_reader.readChunkArray(frame, name, out);
+
 
 # Note: SnapshotParticleData should never be instantiated, it is a placeholder to generate sphinx documentation,
 # as the real SnapshotParticleData lives in c++.
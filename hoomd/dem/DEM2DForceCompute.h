@@ -73,6 +73,12 @@ class DEM2DForceCompute : public ForceCompute
             flags |= ForceCompute::getRequestedCommFlags(timestep);
             return flags;
             }
+
+        //! The half-shell ghost exchange is not supported
+        virtual bool supportsHalfShell()
+            {
+            return false;
+            }
     #endif
 
         //! Returns true because we compute the torque
@@ -45,7 +45,8 @@ DEM3DForceCompute<Real, Real4, Potential>::DEM3DForceCompute(
       m_numTypeVerts(0, this->m_exec_conf), m_firstTypeEdge(0, this->m_exec_conf),
       m_numTypeEdges(0, this->m_exec_conf), m_numTypeFaces(0, this->m_exec_conf),
       m_vertexConnectivity(0, this->m_exec_conf), m_edges(0, this->m_exec_conf),
-      m_faceRcutSq(0, this->m_exec_conf), m_edgeRcutSq(0, this->m_exec_conf),
+      m_faceBounds(0, this->m_exec_conf), m_edgeBounds(0, this->m_exec_conf),
+      m_typeBounds(0, this->m_exec_conf),
       m_verts(0, this->m_exec_conf), m_vertsVec(), m_facesVec()
     {
     m_exec_conf->msg->notice(5) << "Constructing DEM3DForceCompute" << endl;
@@ -163,8 +164,8 @@ void DEM3DForceCompute<Real, Real4, Potential>::createGeometry()
     if(m_firstFaceVert.getNumElements() != nFaces)
         m_firstFaceVert.resize(nFaces);
 
-    if(m_faceRcutSq.getNumElements() != nFaces)
-        m_faceRcutSq.resize(nFaces);
+    if(m_faceBounds.getNumElements() != nFaces)
+        m_faceBounds.resize(nFaces);
 
     if(m_firstTypeVert.getNumElements() != nTypes)
         m_firstTypeVert.resize(nTypes);
@@ -181,20 +182,25 @@ void DEM3DForceCompute<Real, Real4, Potential>::createGeometry()
     if(m_numTypeFaces.getNumElements() != nTypes)
         m_numTypeFaces.resize(nTypes);
 
+    if(m_typeBounds.getNumElements() != nTypes)
+        m_typeBounds.resize(nTypes);
+
     if(m_vertexConnectivity.getNumElements() != nVerts)
         m_vertexConnectivity.resize(nVerts);
 
-    if(m_edgeRcutSq.getNumElements() != nEdges)
-        m_edgeRcutSq.resize(nEdges);
+    if(m_edgeBounds.getNumElements() != nEdges)
+        m_edgeBounds.resize(nEdges);
 
     if(m_edges.getNumElements() != 2*nEdges)
         m_edges.resize(2*nEdges);
 
     ArrayHandle<Real4> h_verts(m_verts, access_location::host,
         access_mode::overwrite);
-    ArrayHandle<Real> h_faceRcutSq(m_faceRcutSq, access_location::host,
+    ArrayHandle<Real4> h_faceBounds(m_faceBounds, access_location::host,
+        access_mode::overwrite);
+    ArrayHandle<Real4> h_edgeBounds(m_edgeBounds, access_location::host,
         access_mode::overwrite);
-    ArrayHandle<Real> h_edgeRcutSq(m_edgeRcutSq, access_location::host,
+    ArrayHandle<Real4> h_typeBounds(m_typeBounds, access_location::host,
         access_mode::overwrite);
     ArrayHandle<unsigned int> h_nextFaceVert(m_nextFaceVert, access_location::host,
         access_mode::overwrite);
@@ -354,6 +360,62 @@ void DEM3DForceCompute<Real, Real4, Potential>::createGeometry()
         const unsigned int faceSize(m_facesVec[shapeIdx].size());
         h_numTypeFaces.data[shapeIdx] = faceSize;
         }
+
+    // build m_faceBounds and m_typeBounds
+    for(size_t shapeIdx(0); shapeIdx < m_facesVec.size(); ++shapeIdx)
+        {
+        // shapes without faces still own the face at their type index
+        h_faceBounds.data[shapeIdx] = boundingSphere(std::vector<vec3<Real> >());
+
+        for(size_t faceIdx(shapeIdx), vecIdx(0);
+            vecIdx < m_facesVec[shapeIdx].size();
+            faceIdx = h_nextFace.data[faceIdx], ++vecIdx)
+            {
+            std::vector<vec3<Real> > points;
+            for(size_t vertIdx(0); vertIdx < m_facesVec[shapeIdx][vecIdx].size(); ++vertIdx)
+                points.push_back(m_vertsVec[shapeIdx][m_facesVec[shapeIdx][vecIdx][vertIdx]]);
+            h_faceBounds.data[faceIdx] = boundingSphere(points);
+            }
+
+        h_typeBounds.data[shapeIdx] = boundingSphere(m_vertsVec[shapeIdx]);
+        }
+
+    // build m_edgeBounds
+    for(size_t edgeIdx(0); edgeIdx < nEdges; ++edgeIdx)
+        {
+        std::vector<vec3<Real> > points;
+        points.push_back(vec3<Real>(h_verts.data[h_edges.data[2*edgeIdx]]));
+        points.push_back(vec3<Real>(h_verts.data[h_edges.data[2*edgeIdx + 1]]));
+        h_edgeBounds.data[edgeIdx] = boundingSphere(points);
+        }
+    }
+
+/*! \param points Points to enclose
+  \returns The sphere centered on the centroid of the points that
+  encloses all of them, as (center.x, center.y, center.z, radius)
+
+  Vertex/face, vertex/edge, and edge/edge interactions are only
+  evaluated if the bounding spheres of the two features are within the
+  contact range of the potential.
+*/
+template<typename Real, typename Real4, typename Potential>
+Real4 DEM3DForceCompute<Real, Real4, Potential>::boundingSphere(
+    const std::vector<vec3<Real> > &points)
+    {
+    vec3<Real> center;
+    for(size_t i(0); i < points.size(); ++i)
+        center += points[i];
+    if(points.size())
+        center /= Real(points.size());
+
+    Real radiussq(0);
+    for(size_t i(0); i < points.size(); ++i)
+        {
+        const vec3<Real> delta(points[i] - center);
+        radiussq = max(radiussq, dot(delta, delta));
+        }
+
+    return vec_to_scalar4(center, sqrt(radiussq));
     }
 
 /*!
@@ -541,9 +603,11 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
     // GPU array handles
     ArrayHandle<Real4> h_verts(m_verts, access_location::host,
         access_mode::read);
-    ArrayHandle<Real> h_faceRcutSq(m_faceRcutSq, access_location::host,
+    ArrayHandle<Real4> h_faceBounds(m_faceBounds, access_location::host,
         access_mode::read);
-    ArrayHandle<Real> h_edgeRcutSq(m_edgeRcutSq, access_location::host,
+    ArrayHandle<Real4> h_edgeBounds(m_edgeBounds, access_location::host,
+        access_mode::read);
+    ArrayHandle<Real4> h_typeBounds(m_typeBounds, access_location::host,
         access_mode::read);
     ArrayHandle<unsigned int> h_nextFaceVert(m_nextFaceVert, access_location::host,
         access_mode::read);
@@ -660,11 +724,22 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                 vec3<Real> torqueij, torqueji;
                 Real potentialij(0);
 
+                // features farther apart than this don't interact
+                const Real contact(m_evaluator.getContactRange());
+                const quat<Scalar> quatiConj(conj(quati));
+                const quat<Scalar> quatjConj(conj(quatj));
+
                 // iterate over each vertex in particle i
                 for(size_t vertIndex(0); vertIndex < h_numTypeVerts.data[typei]; ++vertIndex)
                     {
                     const vec3<Real> vertex0(
                         rotate(quati, vec3<Real>(h_verts.data[h_firstTypeVert.data[typei] + vertIndex])));
+                    // the vertex in the body frame of particle j
+                    const vec3<Real> vertex0j(rotate(quatjConj, vertex0 - dx));
+
+                    // skip vertices out of reach of all of particle j
+                    if(!m_evaluator.withinBounds(vertex0j, h_typeBounds.data[typej], contact))
+                        continue;
 
                     // iterate over each face in particle j
                     size_t faceIndex(typej);
@@ -672,14 +747,15 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                         {
                         do
                             {
-                            m_evaluator.vertexFace(dx, vertex0, quatj,
-                                h_verts.data,
-                                h_realVertIndex.data,
-                                h_nextFaceVert.data,
-                                h_firstFaceVert.data[faceIndex],
-                                potentialij,
-                                forceij, torqueij,
-                                forceji, torqueji);
+                            if(m_evaluator.withinBounds(vertex0j, h_faceBounds.data[faceIndex], contact))
+                                m_evaluator.vertexFace(dx, vertex0, quatj,
+                                    h_verts.data,
+                                    h_realVertIndex.data,
+                                    h_nextFaceVert.data,
+                                    h_firstFaceVert.data[faceIndex],
+                                    potentialij,
+                                    forceij, torqueij,
+                                    forceji, torqueji);
                             faceIndex = h_nextFace.data[faceIndex];
                             }
                         while(faceIndex != typej);
@@ -690,6 +766,10 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                         // iterate over all edges of j
                         for(size_t edgej(0); edgej < h_numTypeEdges.data[typej]; ++edgej)
                             {
+                            if(!m_evaluator.withinBounds(vertex0j,
+                                    h_edgeBounds.data[edgej + h_firstTypeEdge.data[typej]], contact))
+                                continue;
+
                             vec3<Real> p10(h_verts.data[h_edges.data[2*(edgej + h_firstTypeEdge.data[typej])]]);
                             vec3<Real> p11(h_verts.data[h_edges.data[2*(edgej + h_firstTypeEdge.data[typej]) + 1]]);
                             p10 = rotate(quatj, p10);
@@ -721,6 +801,12 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                     {
                     const vec3<Real> vertex0(
                         rotate(quatj, vec3<Real>(h_verts.data[h_firstTypeVert.data[typej] + vertIndex])));
+                    // the vertex in the body frame of particle i
+                    const vec3<Real> vertex0i(rotate(quatiConj, vertex0 + dx));
+
+                    // skip vertices out of reach of all of particle i
+                    if(!m_evaluator.withinBounds(vertex0i, h_typeBounds.data[typei], contact))
+                        continue;
 
                     // iterate over each face in particle i
                     size_t faceIndex(typei);
@@ -728,14 +814,15 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                         {
                         do
                             {
-                            m_evaluator.vertexFace(-dx, vertex0, quati,
-                                h_verts.data,
-                                h_realVertIndex.data,
-                                h_nextFaceVert.data,
-                                h_firstFaceVert.data[faceIndex],
-                                potentialij,
-                                forceji, torqueji,
-                                forceij, torqueij);
+                            if(m_evaluator.withinBounds(vertex0i, h_faceBounds.data[faceIndex], contact))
+                                m_evaluator.vertexFace(-dx, vertex0, quati,
+                                    h_verts.data,
+                                    h_realVertIndex.data,
+                                    h_nextFaceVert.data,
+                                    h_firstFaceVert.data[faceIndex],
+                                    potentialij,
+                                    forceji, torqueji,
+                                    forceij, torqueij);
                             faceIndex = h_nextFace.data[faceIndex];
                             }
                         while(faceIndex != typei);
@@ -746,6 +833,10 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                         // iterate over all edges of i
                         for(size_t edgei(0); edgei < h_numTypeEdges.data[typei]; ++edgei)
                             {
+                            if(!m_evaluator.withinBounds(vertex0i,
+                                    h_edgeBounds.data[edgei + h_firstTypeEdge.data[typei]], contact))
+                                continue;
+
                             vec3<Real> p10(h_verts.data[h_edges.data[2*(edgei + h_firstTypeEdge.data[typei])]]);
                             vec3<Real> p11(h_verts.data[h_edges.data[2*(edgei + h_firstTypeEdge.data[typei]) + 1]]);
                             p10 = rotate(quati, p10);
@@ -769,9 +860,22 @@ void DEM3DForceCompute<Real, Real4, Potential>::computeForces(unsigned int times
                     p00 = rotate(quati, p00);
                     p01 = rotate(quati, p01);
 
+                    // the midpoint of the edge in the body frame of
+                    // particle j and the half length of the edge
+                    const vec3<Real> midpointj(rotate(quatjConj, Real(0.5)*(p00 + p01) - dx));
+                    const Real halfLength(h_edgeBounds.data[edgei + h_firstTypeEdge.data[typei]].w);
+
+                    // skip edges out of reach of all of particle j
+                    if(!m_evaluator.withinBounds(midpointj, h_typeBounds.data[typej], halfLength + contact))
+                        continue;
+
                     // iterate over all edges of j
                     for(size_t edgej(0); edgej < h_numTypeEdges.data[typej]; ++edgej)
                         {
+                        if(!m_evaluator.withinBounds(midpointj,
+                                h_edgeBounds.data[edgej + h_firstTypeEdge.data[typej]], halfLength + contact))
+                            continue;
+
                         vec3<Real> p10(h_verts.data[h_edges.data[2*(edgej + h_firstTypeEdge.data[typej])]]);
                         vec3<Real> p11(h_verts.data[h_edges.data[2*(edgej + h_firstTypeEdge.data[typej]) + 1]]);
                         p10 = rotate(quatj, p10);
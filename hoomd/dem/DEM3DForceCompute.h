@@ -49,12 +49,15 @@
   - type index->number of edges in type
   - (2*edge index)->first real vertex index in edge, (2*edge index + 1)->second real vertex in edge
   - real vertex index->vertex (3D point)
+  - face index, edge index, and type index->bounding sphere (center in the body frame and radius)
 
   Implementation details:
   - The first face of the type with type index i is stored at index i within the face->next face array
   - Faces in a shape and vertices in a face use a circularly linked index structure
   - Vertices (3D points) are stored consecutively for a shape
   - Edges (pairs of vertex indices) are stored consecutively for a shape
+  - Features whose bounding spheres are farther apart than the contact range of the potential
+    are skipped before their interaction is evaluated
 
   \ingroup computes
 */
@@ -110,6 +113,12 @@ class DEM3DForceCompute : public ForceCompute
             flags |= ForceCompute::getRequestedCommFlags(timestep);
             return flags;
             }
+
+        //! The half-shell ghost exchange is not supported
+        virtual bool supportsHalfShell()
+            {
+            return false;
+            }
     #endif
 
         //! Returns true because we compute the torque
@@ -133,8 +142,9 @@ class DEM3DForceCompute : public ForceCompute
         GPUArray<unsigned int> m_numTypeFaces; //!< type->number of faces
         GPUArray<unsigned int> m_vertexConnectivity; //!< real vertex index->number of times it appears in an edge
         GPUArray<unsigned int> m_edges; //!< 2*edge->first real vert, 2*edge+1->second real vert in edge
-        GPUArray<Real> m_faceRcutSq; //!< face index->rcut*rcut
-        GPUArray<Real> m_edgeRcutSq; //!< edge index->rcut*rcut
+        GPUArray<Real4> m_faceBounds; //!< face index->bounding sphere of the face
+        GPUArray<Real4> m_edgeBounds; //!< edge index->bounding sphere of the edge
+        GPUArray<Real4> m_typeBounds; //!< type->bounding sphere of the shape
         GPUArray<Real4> m_verts; //! Vertices for each real index
         std::vector<std::vector<vec3<Real> > > m_vertsVec; //!< Vertices for each type
         std::vector<std::vector<std::vector<unsigned int> > > m_facesVec; //!< Faces for each type
@@ -142,6 +152,9 @@ class DEM3DForceCompute : public ForceCompute
         //! Re-send the list of vertices and links to the GPU
         void createGeometry();
 
+        //! Find a sphere enclosing a set of points
+        static Real4 boundingSphere(const std::vector<vec3<Real> > &points);
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
     };
@@ -174,9 +174,11 @@ void DEM3DForceComputeGPU<Real, Real4, Potential>::computeForces(unsigned int ti
     ArrayHandle<unsigned int> d_edges(this->m_edges, access_location::device,
         access_mode::read);
     ArrayHandle<Real4> d_verts(this->m_verts, access_location::device, access_mode::read);
-    ArrayHandle<Real> d_faceRcutSq(this->m_faceRcutSq, access_location::device,
+    ArrayHandle<Real4> d_faceBounds(this->m_faceBounds, access_location::device,
         access_mode::read);
-    ArrayHandle<Real> d_edgeRcutSq(this->m_edgeRcutSq, access_location::device,
+    ArrayHandle<Real4> d_edgeBounds(this->m_edgeBounds, access_location::device,
+        access_mode::read);
+    ArrayHandle<Real4> d_typeBounds(this->m_typeBounds, access_location::device,
         access_mode::read);
     BoxDim box = this->m_pdata->getBox();
 
@@ -201,7 +203,8 @@ void DEM3DForceComputeGPU<Real, Real4, Potential>::computeForces(unsigned int ti
         d_head_list.data, this->m_evaluator, this->m_r_cut * this->m_r_cut,
         particlesPerBlock, d_firstTypeVert.data, d_numTypeVerts.data,
         d_firstTypeEdge.data, d_numTypeEdges.data, d_numTypeFaces.data,
-        d_vertexConnectivity.data, d_edges.data);
+        d_vertexConnectivity.data, d_edges.data, d_faceBounds.data,
+        d_edgeBounds.data, d_typeBounds.data);
 
     if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
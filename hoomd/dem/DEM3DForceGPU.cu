@@ -77,7 +77,8 @@ __global__ void gpu_compute_dem3d_forces_kernel(
     const Real r_cutsq, const unsigned int *d_firstTypeVert,
     const unsigned int *d_numTypeVerts, const unsigned int *d_firstTypeEdge,
     const unsigned int *d_numTypeEdges, const unsigned int *d_numTypeFaces,
-    const unsigned int *d_vertexConnectivity, const unsigned int *d_edges)
+    const unsigned int *d_vertexConnectivity, const unsigned int *d_edges,
+    const Real4 *d_faceBounds, const Real4 *d_edgeBounds, const Real4 *d_typeBounds)
     {
     extern __shared__ int sh[];
 
@@ -94,6 +95,14 @@ __global__ void gpu_compute_dem3d_forces_kernel(
     Real4 *vertices((Real4*)&sh[shOffset]);
     shOffset += sizeof(Real4)/sizeof(int)*numVerts;
 
+    // face->bounding sphere, edge->bounding sphere, type->bounding sphere
+    Real4 *faceBounds((Real4*)&sh[shOffset]);
+    shOffset += sizeof(Real4)/sizeof(int)*numFaces;
+    Real4 *edgeBounds((Real4*)&sh[shOffset]);
+    shOffset += sizeof(Real4)/sizeof(int)*numEdges;
+    Real4 *typeBounds((Real4*)&sh[shOffset]);
+    shOffset += sizeof(Real4)/sizeof(int)*numTypes;
+
     // particle virials
     Real *partVirials((Real*)&sh[shOffset]);
     shOffset += sizeof(Real)/sizeof(int)*6*blockDim.x;
@@ -146,6 +155,7 @@ __global__ void gpu_compute_dem3d_forces_kernel(
             {
             nextFaces[localThreadIdx + offset] = d_nextFaces[localThreadIdx + offset];
             firstFaceVertex[localThreadIdx + offset] = d_firstFaceVertices[localThreadIdx + offset];
+            faceBounds[localThreadIdx + offset] = d_faceBounds[localThreadIdx + offset];
             }
         offset += blockDim.x*blockDim.y*blockDim.z;
         }
@@ -182,6 +192,7 @@ __global__ void gpu_compute_dem3d_forces_kernel(
             {
             edges[2*(localThreadIdx + offset)] = d_edges[2*(localThreadIdx + offset)];
             edges[2*(localThreadIdx + offset) + 1] = d_edges[2*(localThreadIdx + offset) + 1];
+            edgeBounds[localThreadIdx + offset] = d_edgeBounds[localThreadIdx + offset];
             }
         offset += blockDim.x*blockDim.y*blockDim.z;
         }
@@ -197,6 +208,7 @@ __global__ void gpu_compute_dem3d_forces_kernel(
             firstEdgeInType[localThreadIdx + offset] = d_firstTypeEdge[localThreadIdx + offset];
             numTypeEdges[localThreadIdx + offset] = d_numTypeEdges[localThreadIdx + offset];
             numTypeFaces[localThreadIdx + offset] = d_numTypeFaces[localThreadIdx + offset];
+            typeBounds[localThreadIdx + offset] = d_typeBounds[localThreadIdx + offset];
             }
         offset += blockDim.x*blockDim.y*blockDim.z;
         }
@@ -239,6 +251,7 @@ __global__ void gpu_compute_dem3d_forces_kernel(
         const unsigned int type_i(__scalar_as_int(postype.w));
         const Scalar4 quati(texFetchScalar4(d_quat, pdata_quat_tex, partIdx));
         const quat<Real> quat_i(quati.x, vec3<Real>(quati.y, quati.z, quati.w));
+        const quat<Real> quat_iConj(conj(quat_i));
 
         Scalar di = 0.0f;
         if (Evaluator::needsDiameter())
@@ -263,12 +276,15 @@ __global__ void gpu_compute_dem3d_forces_kernel(
 
             // reference points for vertex/face or edge/edge interactions
             vec3<Real> r0, r1;
+            // half length of the edge for edge/edge interactions
+            Real halfLength(0);
             if(featureType == 0 && featureIdx < numTypeVerts[type_i])
                 r0 = rotate(quat_i, vec3<Real>(vertices[firstTypeVert[type_i] + featureIdx]));
             else if(featureType == 2 && featureIdx < numTypeEdges[type_i])
                 {
                 r0 = rotate(quat_i, vec3<Real>(vertices[edges[2*(firstEdgeInType[type_i] + featureIdx)]]));
                 r1 = rotate(quat_i, vec3<Real>(vertices[edges[2*(firstEdgeInType[type_i] + featureIdx) + 1]]));
+                halfLength = edgeBounds[firstEdgeInType[type_i] + featureIdx].w;
                 }
 
             // prefetch neighbor index
@@ -311,6 +327,10 @@ __global__ void gpu_compute_dem3d_forces_kernel(
                     const Scalar4 neighQuatF(texFetchScalar4(d_quat, pdata_quat_tex, cur_neigh));
                     const quat<Real> neighQuat(
                         neighQuatF.x, vec3<Real>(neighQuatF.y, neighQuatF.z, neighQuatF.w));
+                    const quat<Real> neighQuatConj(conj(neighQuat));
+
+                    // features farther apart than this don't interact
+                    const Real contact(evaluator.getContactRange());
 
                     if (Evaluator::needsVelocity())
                         {
@@ -324,7 +344,22 @@ __global__ void gpu_compute_dem3d_forces_kernel(
                     vec3<Real> torqueij;
                     vec3<Real> torqueji;
 
-                    if(featureType == 0 && featureIdx < numTypeVerts[type_i]) // vertices of i and faces/edges of j
+                    // vertex r0 of i in the body frame of j, vertex of
+                    // j in the body frame of i, or midpoint of the edge
+                    // of i in the body frame of j
+                    vec3<Real> rBody;
+                    if(featureType == 0)
+                        rBody = rotate(neighQuatConj, r0 - rij);
+                    else if(featureType == 1 && featureIdx < numTypeVerts[type_j])
+                        {
+                        r0 = rotate(neighQuat, vec3<Real>(vertices[firstTypeVert[type_j] + featureIdx]));
+                        rBody = rotate(quat_iConj, r0 + rij);
+                        }
+                    else
+                        rBody = rotate(neighQuatConj, Real(0.5)*(r0 + r1) - rij);
+
+                    if(featureType == 0 && featureIdx < numTypeVerts[type_i] &&
+                        evaluator.withinBounds(rBody, typeBounds[type_j], contact)) // vertices of i and faces/edges of j
                         {
                         // faces of j
                         unsigned int faceIndexj(type_j);
@@ -333,13 +368,14 @@ __global__ void gpu_compute_dem3d_forces_kernel(
                             {
                             do
                                 {
-                                evaluator.vertexFace(rij, r0, neighQuat,
-                                    vertices, realVertex,
-                                    nextVertex,
-                                    firstFaceVertex[faceIndexj],
-                                    potentialE, forceij,
-                                    torqueij, forceji,
-                                    torqueji);
+                                if(evaluator.withinBounds(rBody, faceBounds[faceIndexj], contact))
+                                    evaluator.vertexFace(rij, r0, neighQuat,
+                                        vertices, realVertex,
+                                        nextVertex,
+                                        firstFaceVertex[faceIndexj],
+                                        potentialE, forceij,
+                                        torqueij, forceji,
+                                        torqueji);
                                 faceIndexj = nextFaces[faceIndexj];
                                 }
                             while(faceIndexj != type_j);
@@ -366,10 +402,10 @@ __global__ void gpu_compute_dem3d_forces_kernel(
 
                             }
                         }
-                    else if(featureType == 1 && featureIdx < numTypeVerts[type_j]) // vertices of j and faces/edges of i
+                    else if(featureType == 1 && featureIdx < numTypeVerts[type_j] &&
+                        evaluator.withinBounds(rBody, typeBounds[type_i], contact)) // vertices of j and faces/edges of i
                         {
                         evaluator.swapij();
-                        r0 = rotate(neighQuat, vec3<Real>(vertices[firstTypeVert[type_j] + featureIdx]));
 
                         // faces of i
                         unsigned int faceIndexi(type_i);
@@ -377,10 +413,11 @@ __global__ void gpu_compute_dem3d_forces_kernel(
                             {
                             do
                                 {
-                                evaluator.vertexFace(-rij, r0, quat_i,
-                                    vertices, realVertex, nextVertex,
-                                    firstFaceVertex[faceIndexi], potentialE,
-                                    forceji, torqueji, forceij, torqueij);
+                                if(evaluator.withinBounds(rBody, faceBounds[faceIndexi], contact))
+                                    evaluator.vertexFace(-rij, r0, quat_i,
+                                        vertices, realVertex, nextVertex,
+                                        firstFaceVertex[faceIndexi], potentialE,
+                                        forceji, torqueji, forceij, torqueij);
                                 faceIndexi = nextFaces[faceIndexi];
                                 }
                             while(faceIndexi != type_i);
@@ -398,11 +435,15 @@ __global__ void gpu_compute_dem3d_forces_kernel(
                         // shape j wasn't a spherocylinder either, must be
                         // a sphere; this is accounted for above, though.
                         }
-                    else if(featureType == 2 && featureIdx < numTypeEdges[type_i]) // edge/edge
+                    else if(featureType == 2 && featureIdx < numTypeEdges[type_i] &&
+                        evaluator.withinBounds(rBody, typeBounds[type_j], halfLength + contact)) // edge/edge
                         {
                         for(unsigned int edgeIdx(firstEdgeInType[type_j]);
                             edgeIdx < firstEdgeInType[type_j] + numTypeEdges[type_j]; ++edgeIdx)
                             {
+                            if(!evaluator.withinBounds(rBody, edgeBounds[edgeIdx], halfLength + contact))
+                                continue;
+
                             const vec3<Real> r2(rotate(neighQuat, vec3<Real>(vertices[edges[2*edgeIdx]])));
                             const vec3<Real> r3(rotate(neighQuat, vec3<Real>(vertices[edges[2*edgeIdx + 1]])));
                             evaluator.edgeEdge(rij, r0, r1, rij + r2, rij + r3,
@@ -480,6 +521,9 @@ __global__ void gpu_compute_dem3d_forces_kernel(
   force is set to 0
   \param particlesPerBlock Block size to execute
   \param maxVerts Maximum number of vertices in any shape
+  \param d_faceBounds Bounding sphere of each face in the body frame
+  \param d_edgeBounds Bounding sphere of each edge in the body frame
+  \param d_typeBounds Bounding sphere of each shape in the body frame
 
   \returns Any error code resulting from the kernel launch
 
@@ -502,7 +546,8 @@ cudaError_t gpu_compute_dem3d_forces(
     const unsigned int *d_firstTypeVert, const unsigned int *d_numTypeVerts,
     const unsigned int *d_firstTypeEdge, const unsigned int *d_numTypeEdges,
     const unsigned int *d_numTypeFaces, const unsigned int *d_vertexConnectivity,
-    const unsigned int *d_edges)
+    const unsigned int *d_edges, const Real4 *d_faceBounds,
+    const Real4 *d_edgeBounds, const Real4 *d_typeBounds)
     {
 
     // setup the grid to run the kernel
@@ -542,6 +587,7 @@ cudaError_t gpu_compute_dem3d_forces(
         2*numFaces*sizeof(unsigned int) + // face->next face, face->first vertex in face
         2*numDegenerateVerts*sizeof(unsigned int) + // vertex->next vertex, vertex->real vertex
         numVerts*sizeof(Real4) + 2*numEdges*sizeof(unsigned int) + // real vertex->point, edge->real index
+        (numFaces + numEdges + numTypes)*sizeof(Real4) + // face, edge, and type->bounding sphere
         5*numTypes*sizeof(unsigned int) + numVerts*sizeof(unsigned int)); // per-type counts and per-vertex connectivity
 
     // run the kernel
@@ -553,7 +599,7 @@ cudaError_t gpu_compute_dem3d_forces(
         numEdges, numTypes, box, d_n_neigh, d_nlist, d_head_list, evaluator,
         r_cutsq, d_firstTypeVert, d_numTypeVerts, d_firstTypeEdge,
         d_numTypeEdges, d_numTypeFaces, d_vertexConnectivity,
-        d_edges);
+        d_edges, d_faceBounds, d_edgeBounds, d_typeBounds);
 
     return cudaSuccess;
     }
@@ -55,7 +55,10 @@ cudaError_t gpu_compute_dem3d_forces(
     const unsigned int *d_numTypeEdges,
     const unsigned int *d_numTypeFaces,
     const unsigned int *d_vertexConnectivity,
-    const unsigned int *d_edges);
+    const unsigned int *d_edges,
+    const Real4 *d_faceBounds,
+    const Real4 *d_edgeBounds,
+    const Real4 *d_typeBounds);
 
 #endif
 
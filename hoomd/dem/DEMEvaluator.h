@@ -106,6 +106,24 @@ class DEMEvaluator
         DEVICE inline bool withinCutoff(const Real rsq, const Real r_cut_sq)
             {return m_potential.withinCutoff(rsq,r_cut_sq);}
 
+        /*! Largest distance between two contact points at which the
+          potential is nonzero
+         */
+        DEVICE inline Real getContactRange() const
+            {return m_potential.getContactRange();}
+
+        /*! Test if the point r0 is within a distance range of the
+          sphere with center (bounds.x, bounds.y, bounds.z) and radius
+          bounds.w, i.e. if r0 can interact with a feature enclosed by
+          that sphere
+         */
+        DEVICE static bool withinBounds(const vec3<Real> &r0, const Real4 &bounds, const Real range)
+            {
+            const vec3<Real> delta(r0.x - bounds.x, r0.y - bounds.y, r0.z - bounds.z);
+            const Real reach(bounds.w + range);
+            return dot(delta, delta) <= reach*reach;
+            }
+
         DEVICE static bool needsDiameter() {return Potential::needsDiameter();}
 
         DEVICE inline void setDiameter(const Real di,const Real dj)
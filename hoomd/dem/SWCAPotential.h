@@ -65,6 +65,9 @@ class SWCAPotential
             return rmd*rmd < r_cut_sq;
             }
 
+        //! Get the largest distance between two contact points that interact
+        DEVICE inline Real getContactRange() const {return sqrt(m_rcutsq) + m_delta;}
+
         //! Test if potential needs the diameter
         DEVICE static bool needsDiameter() {return true;}
         DEVICE void setDiameter(Real di, Real dj) {m_delta = 0.5*(di+dj) - 1;}
@@ -54,6 +54,9 @@ class WCAPotential
         // Get this potential's cutoff radius
         Real getRcutSq() const {return m_rcutsq;}
 
+        // Get the largest distance between two contact points that interact
+        DEVICE inline Real getContactRange() const {return sqrt(m_rcutsq);}
+
         // Mutate this object by adjusting its lengthscale
         void scale(Real factor)
             {
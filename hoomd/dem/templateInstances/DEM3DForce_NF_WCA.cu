@@ -28,4 +28,6 @@ template cudaError_t gpu_compute_dem3d_forces<Scalar, Scalar4, WCADEM>(
         const unsigned int particlesPerBlock, const unsigned int *d_firstTypeVert,
         const unsigned int *d_numTypeVerts, const unsigned int *d_firstTypeEdge,
         const unsigned int *d_numTypeEdges, const unsigned int *d_numTypeFaces,
-        const unsigned int *d_vertexConnectivity, const unsigned int *d_edges);
+        const unsigned int *d_vertexConnectivity, const unsigned int *d_edges,
+        const Scalar4 *d_faceBounds, const Scalar4 *d_edgeBounds,
+        const Scalar4 *d_typeBounds);
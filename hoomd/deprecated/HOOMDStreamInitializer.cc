@@ -0,0 +1,937 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file HOOMDStreamInitializer.cc
+    \brief Defines the HOOMDStreamInitializer class
+*/
+
+#include "HOOMDStreamInitializer.h"
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <stdexcept>
+#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <cstdlib>
+
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
+using namespace std;
+namespace py = pybind11;
+
+unsigned int HOOMDStreamInitializer::s_block_size = 1 << 24;
+
+namespace
+{
+//! Test for XML whitespace
+inline bool is_space(char c)
+    {
+    return c == ' ' || c == '\n' || c == '\t' || c == '\r';
+    }
+
+//! Convert whitespace separated numbers
+/*! \param begin Start of the text
+    \param end End of the text, must be whitespace, markup or the end of the data
+    \param values Numbers are appended to this vector
+    \returns false if the text contains a token that is not a number
+*/
+bool parse_numbers(const char *begin, const char *end, std::vector<Scalar>& values)
+    {
+    const char *p = begin;
+    while (p < end)
+        {
+        while (p < end && is_space(*p))
+            ++p;
+        if (p >= end)
+            break;
+
+        char *next;
+        double v = strtod(p, &next);
+        if (next == p || next > end)
+            return false;
+        values.push_back(Scalar(v));
+        p = next;
+        }
+    return true;
+    }
+}
+
+/*! \param exec_conf Execution configuration
+    \param fname File name with the data to load
+    \param wrap_coordinates If true, wrap the positions into the box
+    The file will be read and parsed fully during the constructor call.
+*/
+HOOMDStreamInitializer::HOOMDStreamInitializer(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+    const std::string &fname,
+    bool wrap_coordinates)
+    : m_exec_conf(exec_conf),
+      m_fname(fname),
+      m_wrap(wrap_coordinates),
+      m_timestep(0),
+      m_box_read(false),
+      m_snapshot(new SnapshotSystemData<Scalar>()),
+      m_pos(0),
+      m_end(0),
+      m_eof(false)
+    {
+    // we only execute on rank 0
+    if (m_exec_conf->getRank()) return;
+
+    m_snapshot->dimensions = 3;
+
+    m_exec_conf->msg->notice(2) << "Reading " << fname << "..." << endl;
+    m_file.open(fname.c_str(), ios::in | ios::binary);
+    if (!m_file.good())
+        {
+        m_exec_conf->msg->error() << endl << "Unable to open " << fname << endl << endl;
+        throw runtime_error("Error reading xml file");
+        }
+
+    m_buf.resize(s_block_size+1);
+    m_buf[0] = 0;
+
+    readFile();
+    m_file.close();
+    m_buf = std::vector<char>();
+
+    finalize();
+    }
+
+/*! \returns false if no more data could be read
+
+    The unread part of the block is moved to the front. If it fills the whole block (a single token that is longer
+    than the block), the block is enlarged.
+*/
+bool HOOMDStreamInitializer::fill()
+    {
+    if (m_eof)
+        return false;
+
+    size_t n_left = m_end - m_pos;
+    if (n_left == m_buf.size()-1)
+        m_buf.resize(2*n_left+1);
+
+    memmove(&m_buf[0], &m_buf[m_pos], n_left);
+    m_pos = 0;
+    m_end = n_left;
+
+    m_file.read(&m_buf[m_end], m_buf.size()-1-m_end);
+    size_t n_read = m_file.gcount();
+    m_end += n_read;
+    m_buf[m_end] = 0;
+
+    if (!m_file.good())
+        m_eof = true;
+
+    return n_read > 0;
+    }
+
+int HOOMDStreamInitializer::peek()
+    {
+    if (m_pos == m_end && !fill())
+        return -1;
+    return (unsigned char)m_buf[m_pos];
+    }
+
+/*! \param where Description of the position in the file
+*/
+void HOOMDStreamInitializer::unexpectedEOF(const std::string& where)
+    {
+    m_exec_conf->msg->error() << endl << "Unexpected end of file " << m_fname << " in " << where << endl << endl;
+    throw runtime_error("Error reading xml file");
+    }
+
+/*! \returns true if a '<' was found, the read position is after it
+*/
+bool HOOMDStreamInitializer::nextMarkup()
+    {
+    while (true)
+        {
+        const char *start = &m_buf[m_pos];
+        const char *lt = (const char *)memchr(start, '<', m_end - m_pos);
+        if (lt)
+            {
+            m_pos += lt - start + 1;
+            return true;
+            }
+        m_pos = m_end;
+        if (!fill())
+            return false;
+        }
+    }
+
+/*! \param terminator String that ends the skipped markup
+*/
+void HOOMDStreamInitializer::skipPast(const char *terminator)
+    {
+    size_t len = strlen(terminator);
+    while (true)
+        {
+        char *start = &m_buf[m_pos];
+        char *stop = &m_buf[m_end];
+        char *found = std::search(start, stop, terminator, terminator+len);
+        if (found != stop)
+            {
+            m_pos += found - start + len;
+            return;
+            }
+
+        // keep a partial terminator at the end of the block
+        if (m_end - m_pos >= len)
+            m_pos = m_end - (len-1);
+        if (!fill())
+            unexpectedEOF(string("markup ending in ") + terminator);
+        }
+    }
+
+/*! \param tag Output tag
+
+    Comments, processing instructions and declarations are skipped and returned with an empty name.
+*/
+void HOOMDStreamInitializer::readTag(Tag& tag)
+    {
+    tag.name.clear();
+    tag.attributes.clear();
+    tag.end = false;
+    tag.empty = false;
+
+    int c = peek();
+    if (c == '?')
+        {
+        skipPast("?>");
+        return;
+        }
+    if (c == '!')
+        {
+        while (m_end - m_pos < 3 && fill()) { }
+        if (m_end - m_pos >= 3 && strncmp(&m_buf[m_pos], "!--", 3) == 0)
+            skipPast("-->");
+        else
+            skipPast(">");
+        return;
+        }
+    if (c == '/')
+        {
+        tag.end = true;
+        m_pos++;
+        }
+
+    while ((c = peek()) >= 0 && !is_space(c) && c != '>' && c != '/')
+        {
+        tag.name += char(tolower(c));
+        m_pos++;
+        }
+
+    while (true)
+        {
+        while ((c = peek()) >= 0 && is_space(c))
+            m_pos++;
+
+        if (c < 0)
+            unexpectedEOF("<" + tag.name + ">");
+        if (c == '>')
+            {
+            m_pos++;
+            return;
+            }
+        if (c == '/')
+            {
+            m_pos++;
+            if (peek() != '>')
+                {
+                m_exec_conf->msg->error() << endl << "Malformed tag <" << tag.name << "> in " << m_fname
+                    << endl << endl;
+                throw runtime_error("Error reading xml file");
+                }
+            m_pos++;
+            tag.empty = true;
+            return;
+            }
+
+        // read an attribute
+        string attr_name;
+        while ((c = peek()) >= 0 && !is_space(c) && c != '=' && c != '>' && c != '/')
+            {
+            attr_name += char(c);
+            m_pos++;
+            }
+        while ((c = peek()) >= 0 && is_space(c))
+            m_pos++;
+        if (c != '=')
+            {
+            m_exec_conf->msg->error() << endl << "Attribute " << attr_name << " of <" << tag.name
+                << "> has no value in " << m_fname << endl << endl;
+            throw runtime_error("Error reading xml file");
+            }
+        m_pos++;
+        while ((c = peek()) >= 0 && is_space(c))
+            m_pos++;
+        if (c != '"' && c != '\'')
+            {
+            m_exec_conf->msg->error() << endl << "Value of attribute " << attr_name << " of <" << tag.name
+                << "> is not quoted in " << m_fname << endl << endl;
+            throw runtime_error("Error reading xml file");
+            }
+        char quote = char(c);
+        m_pos++;
+
+        string value;
+        while ((c = peek()) >= 0 && c != quote)
+            {
+            value += char(c);
+            m_pos++;
+            }
+        if (c < 0)
+            unexpectedEOF("<" + tag.name + ">");
+        m_pos++;
+
+        tag.attributes[attr_name] = value;
+        }
+    }
+
+/*! \param tag Start tag of the element to skip
+*/
+void HOOMDStreamInitializer::skipElement(const Tag& tag)
+    {
+    if (tag.empty || tag.end)
+        return;
+
+    unsigned int depth = 1;
+    Tag child;
+    while (depth > 0)
+        {
+        if (!nextMarkup())
+            unexpectedEOF("<" + tag.name + ">");
+        readTag(child);
+        if (child.name.empty() || child.empty)
+            continue;
+        if (child.end)
+            depth--;
+        else
+            depth++;
+        }
+    }
+
+/*! \param tag Start tag of the data node
+    \returns true if the markup was the end tag of the node, false if it was a comment
+
+    Any other element inside a data node is an error.
+*/
+bool HOOMDStreamInitializer::readEndOfData(const Tag& tag)
+    {
+    Tag end_tag;
+    readTag(end_tag);
+    if (end_tag.name.empty())
+        return false;
+
+    if (!end_tag.end || end_tag.name != tag.name)
+        {
+        m_exec_conf->msg->error() << endl << "Unexpected <" << (end_tag.end ? "/" : "") << end_tag.name
+            << "> in <" << tag.name << "> in " << m_fname << endl << endl;
+        throw runtime_error("Error reading xml file");
+        }
+    return true;
+    }
+
+/*! \param begin Start of the text
+    \param end End of the text, at whitespace or markup
+    \param values Numbers are appended to this vector
+    \param tag Node the numbers are read for
+
+    In builds with ENABLE_TBB, large pieces of text are split at whitespace and converted in parallel.
+*/
+void HOOMDStreamInitializer::parseNumbers(const char *begin, const char *end, std::vector<Scalar>& values,
+    const Tag& tag)
+    {
+    bool valid = true;
+
+    #ifdef ENABLE_TBB
+    const unsigned int n_pieces = m_exec_conf->getNumThreads();
+    const size_t len = end - begin;
+    if (n_pieces > 1 && len > (1 << 20))
+        {
+        // place the split points on whitespace
+        std::vector<const char *> split(n_pieces+1);
+        split[0] = begin;
+        split[n_pieces] = end;
+        for (unsigned int k = 1; k < n_pieces; k++)
+            {
+            const char *s = std::max(begin + len*k/n_pieces, split[k-1]);
+            while (s < end && !is_space(*s))
+                ++s;
+            split[k] = s;
+            }
+
+        std::vector< std::vector<Scalar> > piece_values(n_pieces);
+        std::vector<char> piece_valid(n_pieces, 1);
+        tbb::parallel_for((unsigned int)0, n_pieces, [&](unsigned int k)
+            {
+            piece_values[k].reserve((split[k+1]-split[k])/4);
+            piece_valid[k] = parse_numbers(split[k], split[k+1], piece_values[k]);
+            });
+
+        for (unsigned int k = 0; k < n_pieces; k++)
+            {
+            valid = valid && piece_valid[k];
+            values.insert(values.end(), piece_values[k].begin(), piece_values[k].end());
+            }
+        }
+    else
+    #endif
+        {
+        valid = parse_numbers(begin, end, values);
+        }
+
+    if (!valid)
+        {
+        m_exec_conf->msg->error() << endl << "Invalid number in <" << tag.name << "> in " << m_fname << endl << endl;
+        throw runtime_error("Error extracting data from hoomd_xml file");
+        }
+    }
+
+/*! \param token Text to convert
+    \param tag Node the token is read for
+*/
+unsigned int HOOMDStreamInitializer::toUInt(const std::string& token, const Tag& tag)
+    {
+    char *next;
+    unsigned long v = strtoul(token.c_str(), &next, 10);
+    if (next == token.c_str() || *next != 0)
+        {
+        m_exec_conf->msg->error() << endl << "Invalid index " << token << " in <" << tag.name << "> in "
+            << m_fname << endl << endl;
+        throw runtime_error("Error extracting data from hoomd_xml file");
+        }
+    return (unsigned int)v;
+    }
+
+/*! \param tag Start tag of the node
+    \param width Number of tokens in a record
+    \param handle_record Called with a vector of \a width tokens for every complete record
+
+    Tokens are read one at a time. An incomplete record at the end of the node is ignored, like in HOOMDInitializer.
+*/
+template<class F>
+void HOOMDStreamInitializer::readTokens(const Tag& tag, unsigned int width, F handle_record)
+    {
+    if (tag.empty)
+        return;
+
+    std::vector<std::string> record(width);
+    unsigned int n_tokens = 0;
+    while (true)
+        {
+        int c = peek();
+        if (c < 0)
+            unexpectedEOF("<" + tag.name + ">");
+
+        if (is_space(c))
+            {
+            m_pos++;
+            continue;
+            }
+
+        if (c == '<')
+            {
+            m_pos++;
+            if (readEndOfData(tag))
+                return;
+            continue;
+            }
+
+        std::string& token = record[n_tokens];
+        token.clear();
+        while ((c = peek()) >= 0 && !is_space(c) && c != '<')
+            {
+            token += char(c);
+            m_pos++;
+            }
+
+        if (++n_tokens == width)
+            {
+            handle_record(record);
+            n_tokens = 0;
+            }
+        }
+    }
+
+/*! \param tag Start tag of the node
+    \param width Number of values in a record
+    \param handle_record Called with a pointer to \a width values for every complete record
+
+    The text in the current block is converted in one piece. An incomplete record at the end of the node is ignored,
+    like in HOOMDInitializer.
+*/
+template<class F>
+void HOOMDStreamInitializer::readRecords(const Tag& tag, unsigned int width, F handle_record)
+    {
+    if (tag.empty)
+        return;
+
+    // values of the current block, with the values of an incomplete record carried over to the next block
+    std::vector<Scalar> values;
+    while (true)
+        {
+        const char *start = &m_buf[m_pos];
+        const char *lt = (const char *)memchr(start, '<', m_end - m_pos);
+        const char *stop = lt;
+        if (!lt)
+            {
+            // the text continues in the next block, convert up to a token boundary
+            stop = &m_buf[m_end];
+            while (stop > start && !is_space(*(stop-1)))
+                --stop;
+            }
+
+        parseNumbers(start, stop, values, tag);
+        m_pos += stop - start;
+
+        size_t n_records = values.size() / width;
+        for (size_t r = 0; r < n_records; r++)
+            handle_record(&values[r*width]);
+        values.erase(values.begin(), values.begin() + n_records*width);
+
+        if (lt)
+            {
+            m_pos++;
+            if (readEndOfData(tag))
+                return;
+            }
+        else if (!fill())
+            {
+            unexpectedEOF("<" + tag.name + ">");
+            }
+        }
+    }
+
+/*! \param tag The box tag
+*/
+void HOOMDStreamInitializer::parseBox(const Tag& tag)
+    {
+    Scalar L[3];
+    Scalar tilt[3] = {Scalar(0.0), Scalar(0.0), Scalar(0.0)};
+    const char *L_names[3] = {"lx", "ly", "lz"};
+    const char *tilt_names[3] = {"xy", "xz", "yz"};
+
+    for (unsigned int d = 0; d < 3; d++)
+        {
+        std::map<std::string, std::string>::const_iterator it = tag.attributes.find(L_names[d]);
+        if (it == tag.attributes.end())
+            {
+            m_exec_conf->msg->error() << endl << L_names[d] << " not set in <box> node" << endl << endl;
+            throw runtime_error("Error extracting data from hoomd_xml file");
+            }
+        istringstream temp(it->second);
+        temp >> L[d];
+
+        // If no tilt factors are provided, they default to zero
+        it = tag.attributes.find(tilt_names[d]);
+        if (it != tag.attributes.end())
+            {
+            istringstream temp_tilt(it->second);
+            temp_tilt >> tilt[d];
+            }
+        }
+
+    m_snapshot->global_box = BoxDim(L[0], L[1], L[2]);
+    m_snapshot->global_box.setTiltFactors(tilt[0], tilt[1], tilt[2]);
+    m_box_read = true;
+    }
+
+/*! The root node and its children are read. The configuration node is passed on to readConfiguration().
+*/
+void HOOMDStreamInitializer::readFile()
+    {
+    // skip the prolog and find the root node
+    Tag root;
+    while (true)
+        {
+        if (!nextMarkup())
+            {
+            m_exec_conf->msg->error() << endl << "Root node of " << m_fname << " is not <hoomd_xml>" << endl << endl;
+            throw runtime_error("Error reading xml file");
+            }
+        readTag(root);
+        if (!root.name.empty())
+            break;
+        }
+
+    if (root.end || root.name != "hoomd_xml")
+        {
+        m_exec_conf->msg->error() << endl << "Root node of " << m_fname << " is not <hoomd_xml>" << endl << endl;
+        throw runtime_error("Error reading xml file");
+        }
+
+    if (root.attributes.count("version"))
+        {
+        m_xml_version = root.attributes["version"];
+        }
+    else
+        {
+        m_exec_conf->msg->notice(2) << "No version specified in hoomd_xml root node: assuming 1.0" << endl;
+        m_xml_version = string("1.0");
+        }
+
+    // right now, the version tag doesn't do anything: just warn if it is not a valid version
+    const char *valid_versions[] = {"1.0", "1.1", "1.2", "1.3", "1.4", "1.5", "1.6", "1.7", "1.8"};
+    bool valid = false;
+    for (unsigned int i = 0; i < sizeof(valid_versions)/sizeof(const char *); i++)
+        {
+        if (m_xml_version == valid_versions[i])
+            valid = true;
+        }
+    if (!valid)
+        m_exec_conf->msg->warning() << endl
+             << "hoomd_xml file with version not in the range 1.0-1.7  specified,"
+             << " I don't know how to read this. Continuing anyways." << endl << endl;
+
+    unsigned int num_configurations = 0;
+    Tag child;
+    while (!root.empty)
+        {
+        if (!nextMarkup())
+            unexpectedEOF("<hoomd_xml>");
+        readTag(child);
+        if (child.name.empty())
+            continue;
+        if (child.end)
+            break;
+
+        if (child.name != "configuration")
+            {
+            skipElement(child);
+            continue;
+            }
+
+        if (++num_configurations > 1)
+            {
+            m_exec_conf->msg->error() << endl << "Sorry, the input XML file must have only one configuration"
+                << endl << endl;
+            throw runtime_error("Error reading xml file");
+            }
+
+        // extract the time step
+        if (child.attributes.count("time_step"))
+            m_timestep = atoi(child.attributes["time_step"].c_str());
+
+        // extract the number of dimensions, or default to 3
+        if (child.attributes.count("dimensions"))
+            m_snapshot->dimensions = atoi(child.attributes["dimensions"].c_str());
+
+        if (!child.empty)
+            readConfiguration();
+        }
+
+    if (num_configurations == 0)
+        {
+        m_exec_conf->msg->error() << endl << "No <configuration> specified in the XML file" << endl << endl;
+        throw runtime_error("Error reading xml file");
+        }
+    }
+
+/*! Every child node of the configuration is converted directly into the snapshot arrays.
+*/
+void HOOMDStreamInitializer::readConfiguration()
+    {
+    SnapshotParticleData<Scalar>& pdata = m_snapshot->particle_data;
+    BondData::Snapshot& bdata = m_snapshot->bond_data;
+    AngleData::Snapshot& adata = m_snapshot->angle_data;
+    DihedralData::Snapshot& ddata = m_snapshot->dihedral_data;
+    ImproperData::Snapshot& idata = m_snapshot->improper_data;
+    ConstraintData::Snapshot& cdata = m_snapshot->constraint_data;
+    PairData::Snapshot& pair_data = m_snapshot->pair_data;
+
+    Tag tag;
+    while (true)
+        {
+        if (!nextMarkup())
+            unexpectedEOF("<configuration>");
+        readTag(tag);
+        if (tag.name.empty())
+            continue;
+        if (tag.end)
+            return;
+
+        // the writer stores the number of elements, which avoids regrowing the arrays
+        unsigned int num = 0;
+        if (tag.attributes.count("num"))
+            num = atoi(tag.attributes["num"].c_str());
+
+        const string& name = tag.name;
+        if (name == "box")
+            {
+            parseBox(tag);
+            skipElement(tag);
+            }
+        else if (name == "position")
+            {
+            pdata.pos.reserve(pdata.pos.size() + num);
+            readRecords(tag, 3, [&](const Scalar *v)
+                { pdata.pos.push_back(vec3<Scalar>(v[0], v[1], v[2])); });
+            }
+        else if (name == "image")
+            {
+            pdata.image.reserve(pdata.image.size() + num);
+            readRecords(tag, 3, [&](const Scalar *v)
+                { pdata.image.push_back(make_int3(int(v[0]), int(v[1]), int(v[2]))); });
+            }
+        else if (name == "velocity")
+            {
+            pdata.vel.reserve(pdata.vel.size() + num);
+            readRecords(tag, 3, [&](const Scalar *v)
+                { pdata.vel.push_back(vec3<Scalar>(v[0], v[1], v[2])); });
+            }
+        else if (name == "mass")
+            {
+            pdata.mass.reserve(pdata.mass.size() + num);
+            readRecords(tag, 1, [&](const Scalar *v) { pdata.mass.push_back(v[0]); });
+            }
+        else if (name == "diameter")
+            {
+            pdata.diameter.reserve(pdata.diameter.size() + num);
+            readRecords(tag, 1, [&](const Scalar *v) { pdata.diameter.push_back(v[0]); });
+            }
+        else if (name == "charge")
+            {
+            pdata.charge.reserve(pdata.charge.size() + num);
+            readRecords(tag, 1, [&](const Scalar *v) { pdata.charge.push_back(v[0]); });
+            }
+        else if (name == "body")
+            {
+            // handle -1 as NO_BODY
+            pdata.body.reserve(pdata.body.size() + num);
+            readRecords(tag, 1, [&](const Scalar *v)
+                {
+                int body = int(v[0]);
+                pdata.body.push_back(body == -1 ? NO_BODY : (unsigned int)body);
+                });
+            }
+        else if (name == "orientation")
+            {
+            pdata.orientation.reserve(pdata.orientation.size() + num);
+            readRecords(tag, 4, [&](const Scalar *v)
+                { pdata.orientation.push_back(quat<Scalar>(make_scalar4(v[0], v[1], v[2], v[3]))); });
+            }
+        else if (name == "angmom")
+            {
+            pdata.angmom.reserve(pdata.angmom.size() + num);
+            readRecords(tag, 4, [&](const Scalar *v)
+                { pdata.angmom.push_back(quat<Scalar>(make_scalar4(v[0], v[1], v[2], v[3]))); });
+            }
+        else if (name == "moment_inertia")
+            {
+            pdata.inertia.reserve(pdata.inertia.size() + num);
+            if (m_xml_version == "1.4" || m_xml_version == "1.5")
+                {
+                m_exec_conf->msg->warning() << "Ignoring off-diagonal moments of inertia in this XML file version < 1.6"
+                    << std::endl;
+                readRecords(tag, 6, [&](const Scalar *v)
+                    { pdata.inertia.push_back(vec3<Scalar>(v[0], v[3], v[5])); });
+                }
+            else
+                {
+                readRecords(tag, 3, [&](const Scalar *v)
+                    { pdata.inertia.push_back(vec3<Scalar>(v[0], v[1], v[2])); });
+                }
+            }
+        else if (name == "type")
+            {
+            // dynamically determine the particle types
+            pdata.type.reserve(pdata.type.size() + num);
+            readTokens(tag, 1, [&](const std::vector<std::string>& t)
+                { pdata.type.push_back(getTypeId(pdata.type_mapping, t[0])); });
+            }
+        else if (name == "bond")
+            {
+            readTokens(tag, 3, [&](const std::vector<std::string>& t)
+                {
+                BondData::members_t bond;
+                bond.tag[0] = toUInt(t[1], tag); bond.tag[1] = toUInt(t[2], tag);
+                bdata.groups.push_back(bond);
+                bdata.type_id.push_back(getTypeId(bdata.type_mapping, t[0]));
+                });
+            }
+        else if (name == "angle")
+            {
+            readTokens(tag, 4, [&](const std::vector<std::string>& t)
+                {
+                AngleData::members_t angle;
+                for (unsigned int k = 0; k < 3; k++)
+                    angle.tag[k] = toUInt(t[k+1], tag);
+                adata.groups.push_back(angle);
+                adata.type_id.push_back(getTypeId(adata.type_mapping, t[0]));
+                });
+            }
+        else if (name == "dihedral")
+            {
+            readTokens(tag, 5, [&](const std::vector<std::string>& t)
+                {
+                DihedralData::members_t dihedral;
+                for (unsigned int k = 0; k < 4; k++)
+                    dihedral.tag[k] = toUInt(t[k+1], tag);
+                ddata.groups.push_back(dihedral);
+                ddata.type_id.push_back(getTypeId(ddata.type_mapping, t[0]));
+                });
+            }
+        else if (name == "improper")
+            {
+            readTokens(tag, 5, [&](const std::vector<std::string>& t)
+                {
+                ImproperData::members_t improper;
+                for (unsigned int k = 0; k < 4; k++)
+                    improper.tag[k] = toUInt(t[k+1], tag);
+                idata.groups.push_back(improper);
+                idata.type_id.push_back(getTypeId(idata.type_mapping, t[0]));
+                });
+            }
+        else if (name == "pair")
+            {
+            readTokens(tag, 3, [&](const std::vector<std::string>& t)
+                {
+                PairData::members_t pair;
+                pair.tag[0] = toUInt(t[1], tag); pair.tag[1] = toUInt(t[2], tag);
+                pair_data.groups.push_back(pair);
+                pair_data.type_id.push_back(getTypeId(pair_data.type_mapping, t[0]));
+                });
+            }
+        else if (name == "constraint")
+            {
+            readRecords(tag, 3, [&](const Scalar *v)
+                {
+                ConstraintData::members_t constraint;
+                constraint.tag[0] = (unsigned int)v[0]; constraint.tag[1] = (unsigned int)v[1];
+                cdata.groups.push_back(constraint);
+                cdata.val.push_back(v[2]);
+                });
+            }
+        else
+            {
+            m_exec_conf->msg->notice(2) << "Parser for node <" << name << "> not defined, ignoring" << endl;
+            skipElement(tag);
+            }
+        }
+    }
+
+/*! The same checks as in HOOMDInitializer are performed, then the arrays that were not in the file are filled with
+    the default values.
+*/
+void HOOMDStreamInitializer::finalize()
+    {
+    SnapshotParticleData<Scalar>& pdata = m_snapshot->particle_data;
+    const size_t N = pdata.pos.size();
+
+    // check for required items in the file
+    if (!m_box_read)
+        {
+        m_exec_conf->msg->error() << endl
+             << "A <box> node is required to define the dimensions of the simulation box"
+             << endl << endl;
+        throw runtime_error("Error extracting data from hoomd_xml file");
+        }
+    if (N == 0)
+        {
+        m_exec_conf->msg->error() << endl << "No particles defined in <position> node" << endl << endl;
+        throw runtime_error("Error extracting data from hoomd_xml file");
+        }
+    if (pdata.type.size() == 0)
+        {
+        m_exec_conf->msg->error() << endl << "No particles defined in <type> node" << endl << endl;
+        throw runtime_error("Error extracting data from hoomd_xml file");
+        }
+    if (pdata.type.size() != N)
+        {
+        m_exec_conf->msg->error() << endl << pdata.type.size() << " type values != " << N
+             << " positions" << endl << endl;
+        throw runtime_error("Error extracting data from hoomd_xml file");
+        }
+
+    // check for potential user errors
+    const std::pair<size_t, const char *> sizes[] = {
+        std::make_pair(pdata.vel.size(), "velocities"),
+        std::make_pair(pdata.mass.size(), "masses"),
+        std::make_pair(pdata.diameter.size(), "diameters"),
+        std::make_pair(pdata.image.size(), "images"),
+        std::make_pair(pdata.charge.size(), "charge values"),
+        std::make_pair(pdata.body.size(), "body values"),
+        std::make_pair(pdata.orientation.size(), "orientation values"),
+        std::make_pair(pdata.inertia.size(), "moment_inertia values"),
+        std::make_pair(pdata.angmom.size(), "angmom values")};
+    for (unsigned int i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+        {
+        if (sizes[i].first != 0 && sizes[i].first != N)
+            {
+            m_exec_conf->msg->error() << endl << sizes[i].first << " " << sizes[i].second << " != " << N
+                 << " positions" << endl << endl;
+            throw runtime_error("Error extracting data from hoomd_xml file");
+            }
+        }
+
+    // notify the user of what we have accomplished
+    m_exec_conf->msg->notice(2) << "--- hoomd_xml file read summary" << endl;
+    m_exec_conf->msg->notice(2) << N << " positions at timestep " << m_timestep << endl;
+    for (unsigned int i = 0; i < sizeof(sizes)/sizeof(sizes[0]); i++)
+        {
+        if (sizes[i].first > 0)
+            m_exec_conf->msg->notice(2) << sizes[i].first << " " << sizes[i].second << endl;
+        }
+    m_exec_conf->msg->notice(2) << pdata.type_mapping.size() <<  " particle types" << endl;
+    if (m_snapshot->bond_data.groups.size() > 0)
+        m_exec_conf->msg->notice(2) << m_snapshot->bond_data.groups.size() << " bonds" << endl;
+    if (m_snapshot->angle_data.groups.size() > 0)
+        m_exec_conf->msg->notice(2) << m_snapshot->angle_data.groups.size() << " angles" << endl;
+    if (m_snapshot->dihedral_data.groups.size() > 0)
+        m_exec_conf->msg->notice(2) << m_snapshot->dihedral_data.groups.size() << " dihedrals" << endl;
+    if (m_snapshot->improper_data.groups.size() > 0)
+        m_exec_conf->msg->notice(2) << m_snapshot->improper_data.groups.size() << " impropers" << endl;
+    if (m_snapshot->constraint_data.groups.size() > 0)
+        m_exec_conf->msg->notice(2) << m_snapshot->constraint_data.groups.size() << " constraints" << endl;
+    if (m_snapshot->pair_data.groups.size() > 0)
+        m_exec_conf->msg->notice(2) << m_snapshot->pair_data.groups.size() << " special pairs" << endl;
+
+    // fill in the defaults of the quantities that were not read
+    pdata.resize((unsigned int)N);
+
+    if (m_wrap)
+        {
+        // wrap coordinates into box
+        for (unsigned int i = 0; i < N; i++)
+            m_snapshot->global_box.wrap(pdata.pos[i], pdata.image[i]);
+        }
+
+    m_snapshot->bond_data.resize((unsigned int)m_snapshot->bond_data.groups.size());
+    m_snapshot->angle_data.resize((unsigned int)m_snapshot->angle_data.groups.size());
+    m_snapshot->dihedral_data.resize((unsigned int)m_snapshot->dihedral_data.groups.size());
+    m_snapshot->improper_data.resize((unsigned int)m_snapshot->improper_data.groups.size());
+    m_snapshot->constraint_data.resize((unsigned int)m_snapshot->constraint_data.groups.size());
+    m_snapshot->pair_data.resize((unsigned int)m_snapshot->pair_data.groups.size());
+    }
+
+/*! \param mapping Type names read so far
+    \param name Name to get type id of
+    If \a name has already been added, this returns the type index of that name.
+    If \a name has not yet been added, it is added to the list and the new id is returned.
+*/
+unsigned int HOOMDStreamInitializer::getTypeId(std::vector<std::string>& mapping, const std::string& name)
+    {
+    for (unsigned int i = 0; i < mapping.size(); i++)
+        {
+        if (mapping[i] == name)
+            return i;
+        }
+    mapping.push_back(name);
+    return (unsigned int)mapping.size()-1;
+    }
+
+void export_HOOMDStreamInitializer(py::module& m)
+    {
+    py::class_< HOOMDStreamInitializer >(m,"HOOMDStreamInitializer")
+    .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&>())
+    .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const string&, bool>())
+    .def("getTimeStep", &HOOMDStreamInitializer::getTimeStep)
+    .def("setTimeStep", &HOOMDStreamInitializer::setTimeStep)
+    .def("getSnapshot", &HOOMDStreamInitializer::getSnapshot)
+    ;
+    }
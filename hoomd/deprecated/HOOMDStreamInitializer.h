@@ -0,0 +1,148 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+/*! \file HOOMDStreamInitializer.h
+    \brief Declares the HOOMDStreamInitializer class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "hoomd/SnapshotSystemData.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <fstream>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#ifndef __HOOMD_STREAM_INITIALIZER_H__
+#define __HOOMD_STREAM_INITIALIZER_H__
+
+//! Forward declarations
+class ExecutionConfiguation;
+
+//! Initializes a snapshot from a hoomd_xml file without building a document tree
+/*! HOOMDStreamInitializer reads the same file format as HOOMDInitializer, but instead of parsing the whole file
+    into an XMLNode tree and copying the text of every node into string streams, it scans the file in blocks of a
+    fixed size and converts the text of each node directly into the arrays of a SnapshotSystemData as it goes. The
+    memory needed beyond the snapshot is one block, independent of the file size.
+
+    Nodes that only contain numbers (position, velocity, image, ...) are converted a block at a time. In builds with
+    ENABLE_TBB, the text of a block is split into pieces at whitespace and the pieces are converted in parallel.
+    Nodes with type names (type, bond, angle, ...) are converted token by token.
+
+    The reader understands the subset of XML that hoomd_xml files use: elements with attributes, text, comments,
+    processing instructions and the document type declaration. The checks on the file are the same as in
+    HOOMDInitializer.
+
+    \ingroup data_structs
+*/
+class PYBIND11_EXPORT HOOMDStreamInitializer
+    {
+    public:
+        //! Loads in the file and parses the data
+        HOOMDStreamInitializer(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                               const std::string &fname,
+                               bool wrap_coordinates = false);
+
+        virtual ~HOOMDStreamInitializer() { }
+
+        //! Returns the timestep of the simulation
+        virtual unsigned int getTimeStep() const
+            {
+            return m_timestep;
+            }
+
+        //! Sets the timestep of the simulation
+        virtual void setTimeStep(unsigned int ts)
+            {
+            m_timestep = ts;
+            }
+
+        //! Returns the snapshot read from the file
+        virtual std::shared_ptr< SnapshotSystemData<Scalar> > getSnapshot() const
+            {
+            return m_snapshot;
+            }
+
+        //! Set the size of the blocks the file is read in (for testing)
+        static void setBlockSize(unsigned int block_size)
+            {
+            s_block_size = block_size;
+            }
+
+    private:
+        //! A start or end tag
+        struct Tag
+            {
+            std::string name;                               //!< Element name, lower case
+            std::map<std::string, std::string> attributes;  //!< Attributes of a start tag
+            bool end;                                       //!< True for an end tag
+            bool empty;                                     //!< True for an empty element tag (<name/>)
+            };
+
+        //! Read the file
+        void readFile();
+        //! Read the children of the configuration node
+        void readConfiguration();
+        //! Check the sizes of the arrays and fill in the defaults
+        void finalize();
+
+        //! Move the unread data to the front of the buffer and read the next block
+        bool fill();
+        //! Look at the next character without consuming it, returns -1 at the end of the file
+        int peek();
+        //! Skip to the next markup, returns false at the end of the file
+        bool nextMarkup();
+        //! Read a tag, after the opening '<'
+        void readTag(Tag& tag);
+        //! Skip past the given terminator
+        void skipPast(const char *terminator);
+        //! Skip an element and all of its children
+        void skipElement(const Tag& tag);
+        //! Read the markup that ends the text of a data node, after the opening '<'
+        bool readEndOfData(const Tag& tag);
+        //! Throw an error about an unexpected end of the file
+        void unexpectedEOF(const std::string& where);
+
+        //! Read the text of a node as records of \a width whitespace separated tokens
+        template<class F> void readTokens(const Tag& tag, unsigned int width, F handle_record);
+        //! Read the text of a node as records of \a width numbers
+        template<class F> void readRecords(const Tag& tag, unsigned int width, F handle_record);
+
+        //! Convert a piece of text into numbers
+        void parseNumbers(const char *begin, const char *end, std::vector<Scalar>& values, const Tag& tag);
+        //! Convert a token into a tag or index
+        unsigned int toUInt(const std::string& token, const Tag& tag);
+
+        //! Parse the box node
+        void parseBox(const Tag& tag);
+
+        //! Identify a type by name, adding it to the mapping if needed
+        static unsigned int getTypeId(std::vector<std::string>& mapping, const std::string& name);
+
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< The execution configuration
+        std::string m_fname;                        //!< Name of the file
+        bool m_wrap;                                //!< If true, wrap input coordinates into box
+        unsigned int m_timestep;                    //!< The time stamp
+        std::string m_xml_version;                  //!< Version of XML file
+        bool m_box_read;                            //!< True if the box was read
+
+        std::shared_ptr< SnapshotSystemData<Scalar> > m_snapshot;  //!< The snapshot that is read into
+
+        std::ifstream m_file;           //!< The file being read
+        std::vector<char> m_buf;        //!< Current block of the file, terminated by a 0
+        size_t m_pos;                   //!< Read position in the block
+        size_t m_end;                   //!< End of the valid data in the block
+        bool m_eof;                     //!< True when the file has been read to the end
+
+        static unsigned int s_block_size;   //!< Size of the blocks the file is read in
+    };
+
+//! Exports HOOMDStreamInitializer to python
+void export_HOOMDStreamInitializer(pybind11::module& m);
+
+#endif
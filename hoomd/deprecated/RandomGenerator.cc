@@ -5,6 +5,7 @@
 // Maintainer: joaander
 #include "RandomGenerator.h"
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
@@ -79,6 +80,9 @@ GeneratedParticles::GeneratedParticles(std::shared_ptr<const ExecutionConfigurat
     The position of \a p is checked against all nearby particles that have already been placed with place().
     If all distances are greater than the radius of p plus the radius of the compared particle, true is
     returned. If there is any overlap, false is returned.
+
+    Along non-periodic directions of the box (the boundaries of a local domain box), \a p must also be at
+    least its radius away from the box faces.
 */
 bool GeneratedParticles::canPlace(const particle& p)
     {
@@ -97,6 +101,17 @@ bool GeneratedParticles::canPlace(const particle& p)
 
     // determine the bin the particle is in
     Scalar3 f = m_box.makeFraction(pos);
+
+    // in the local box of a domain, keep the separation radius to the boundaries with other domains, so that
+    // particles generated on different ranks cannot overlap
+    uchar3 periodic = m_box.getPeriodic();
+    Scalar3 L = m_box.getNearestPlaneDistance();
+    Scalar r = m_radii[p.type];
+    if ((!periodic.x && (f.x*L.x < r || (Scalar(1.0)-f.x)*L.x < r)) ||
+        (!periodic.y && (f.y*L.y < r || (Scalar(1.0)-f.y)*L.y < r)) ||
+        (!periodic.z && (f.z*L.z < r || (Scalar(1.0)-f.z)*L.z < r)))
+        return false;
+
     int ib = (int)(f.x*m_Mx);
     int jb = (int)(f.y*m_My);
     int kb = (int)(f.z*m_Mz);
@@ -305,7 +320,9 @@ RandomGenerator::RandomGenerator(std::shared_ptr<const ExecutionConfiguration> e
     : m_exec_conf(exec_conf),
       m_box(box),
       m_seed(seed),
-      m_dimensions(dimensions)
+      m_dimensions(dimensions),
+      m_distributed(false),
+      m_tag_offset(0)
     {
     }
 
@@ -315,8 +332,8 @@ std::shared_ptr< SnapshotSystemData<Scalar> > RandomGenerator::getSnapshot() con
     // create a snapshot
     std::shared_ptr< SnapshotSystemData<Scalar> > snapshot(new SnapshotSystemData<Scalar>());
 
-    // only execute on rank 0
-    if (m_exec_conf->getRank()) return snapshot;
+    // only execute on rank 0, unless every rank generated its own domain
+    if (m_exec_conf->getRank() && !m_distributed) return snapshot;
 
     // initialize box dimensions
     snapshot->global_box = m_box;
@@ -335,6 +352,8 @@ std::shared_ptr< SnapshotSystemData<Scalar> > RandomGenerator::getSnapshot() con
         }
 
     pdata_snap.type_mapping = m_type_mapping;
+    pdata_snap.is_distributed = m_distributed;
+    pdata_snap.tag_offset = m_tag_offset;
 
     // initialize bonds
     BondData::Snapshot& bdata_snap = snapshot->bond_data;
@@ -379,6 +398,9 @@ void RandomGenerator::generate()
     // only execute on rank 0
     if (m_exec_conf->getRank()) return;
 
+    m_distributed = false;
+    m_tag_offset = 0;
+
     // sanity check
     assert(m_radii.size() > 0);
     assert(m_generators.size() > 0);
@@ -418,6 +440,123 @@ void RandomGenerator::generate()
         m_data.m_bonds[i].type_id = getBondTypeId(m_data.m_bonds[i].type);
     }
 
+#ifdef ENABLE_MPI
+/*! \param decomposition Domain decomposition of the box
+
+    Every rank generates the particles inside its own domain, so that no rank needs to hold the whole system. The
+    number of copies of every generator is split between the domains by their volume, and the random number
+    generator on every rank is seeded by the seed and the rank.
+
+    Particles keep a distance of their separation radius to the boundaries between domains (see
+    GeneratedParticles::canPlace()), which leaves a thin depleted layer at the domain boundaries. Only generators of
+    single particles are supported, since polymers would cross domain boundaries.
+
+    The particles generated on each rank get consecutive tags, starting after the particles of the lower ranks.
+
+    \pre setSeparationRadius has been called for all particle types that will be generated
+    \pre addGenerator has been called for all desired generators
+*/
+void RandomGenerator::generateDistributed(std::shared_ptr<DomainDecomposition> decomposition)
+    {
+    // sanity check
+    assert(m_radii.size() > 0);
+    assert(m_generators.size() > 0);
+    assert(m_generators.size() == m_generator_repeat.size());
+
+    for (unsigned int i = 0; i < m_generators.size(); i++)
+        {
+        if (m_generators[i]->getNumToGenerate() != 1)
+            {
+            m_exec_conf->msg->error() << endl << "Polymers cannot be generated in parallel" << endl << endl;
+            throw runtime_error("Error generating particles");
+            }
+        }
+
+    // volume of the domains before and including the local domain, as fractions of the box volume
+    const Index3D& di = decomposition->getDomainIndexer();
+    std::vector<Scalar> cum_frac_x = decomposition->getCumulativeFractions(0);
+    std::vector<Scalar> cum_frac_y = decomposition->getCumulativeFractions(1);
+    std::vector<Scalar> cum_frac_z = decomposition->getCumulativeFractions(2);
+    uint3 grid_pos = decomposition->getGridPos();
+    unsigned int my_domain = di(grid_pos.x, grid_pos.y, grid_pos.z);
+
+    double vol_lo = 0.0;
+    double vol_hi = 0.0;
+    for (unsigned int d = 0; d <= my_domain; d++)
+        {
+        uint3 t = di.getTriple(d);
+        vol_lo = vol_hi;
+        vol_hi += double(cum_frac_x[t.x+1] - cum_frac_x[t.x])
+            * double(cum_frac_y[t.y+1] - cum_frac_y[t.y])
+            * double(cum_frac_z[t.z+1] - cum_frac_z[t.z]);
+        }
+    if (my_domain == di.getNumElements() - 1)
+        vol_hi = 1.0;
+
+    // every rank rounds the same cumulative volumes, so the counts add up to the requested totals
+    std::vector<unsigned int> repeat(m_generators.size());
+    unsigned int n_particles = 0;
+    for (unsigned int i = 0; i < m_generators.size(); i++)
+        {
+        unsigned int first = (unsigned int)(vol_lo * double(m_generator_repeat[i]) + 0.5);
+        unsigned int last = (unsigned int)(vol_hi * double(m_generator_repeat[i]) + 0.5);
+        repeat[i] = last - first;
+        n_particles += repeat[i] * m_generators[i]->getNumToGenerate();
+        }
+
+    // setup data structures in the local box, which is not periodic along directions with more than one domain
+    m_data = GeneratedParticles(m_exec_conf, n_particles, decomposition->calculateLocalBox(m_box), m_radii);
+
+    // start the random number generator
+    unsigned int rank = m_exec_conf->getRank();
+    std::seed_seq seq{m_seed, rank};
+    std::mt19937 rnd(seq);
+
+    // perform the generation
+    unsigned int start_idx = 0;
+    for (unsigned int i = 0; i < m_generators.size(); i++)
+        {
+        for (unsigned int j = 0; j < repeat[i]; j++)
+            {
+            m_generators[i]->generateParticles(m_data, rnd, start_idx);
+            start_idx += m_generators[i]->getNumToGenerate();
+            }
+        }
+
+    // a rank may not have generated all types, merge the type names of all ranks in rank order
+    MPI_Comm mpi_comm = m_exec_conf->getMPICommunicator();
+    std::vector< std::vector<std::string> > type_mappings;
+    std::vector<std::string> local_types;
+    for (unsigned int i = 0; i < m_data.m_particles.size(); i++)
+        {
+        const std::string& name = m_data.m_particles[i].type;
+        if (std::find(local_types.begin(), local_types.end(), name) == local_types.end())
+            local_types.push_back(name);
+        }
+    all_gather_v(local_types, type_mappings, mpi_comm);
+
+    m_type_mapping.clear();
+    for (unsigned int r = 0; r < type_mappings.size(); r++)
+        for (unsigned int i = 0; i < type_mappings[r].size(); i++)
+            getTypeId(type_mappings[r][i]);
+
+    // get the type id of all particles
+    for (unsigned int i = 0; i < m_data.m_particles.size(); i++)
+        {
+        m_data.m_particles[i].type_id = getTypeId(m_data.m_particles[i].type);
+        }
+
+    // tags continue after the particles of the lower ranks
+    unsigned int n_local = m_data.m_particles.size();
+    m_tag_offset = 0;
+    MPI_Exscan(&n_local, &m_tag_offset, 1, MPI_UNSIGNED, MPI_SUM, mpi_comm);
+    if (rank == 0)
+        m_tag_offset = 0;
+
+    m_distributed = true;
+    }
+#endif
+
 /*! \param name Name to get type id of
     If \a name has already been added, this returns the type index of that name.
     If \a name has not yet been added, it is added to the list and the new id is returned.
@@ -618,6 +757,9 @@ void export_RandomGenerator(py::module& m)
     .def("setSeparationRadius", &RandomGenerator::setSeparationRadius)
     .def("addGenerator", &RandomGenerator::addGenerator)
     .def("generate", &RandomGenerator::generate)
+    #ifdef ENABLE_MPI
+    .def("generateDistributed", &RandomGenerator::generateDistributed)
+    #endif
     .def("getSnapshot", &RandomGenerator::getSnapshot)
     ;
 
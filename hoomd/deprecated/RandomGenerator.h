@@ -218,6 +218,9 @@ class PYBIND11_EXPORT PolymerParticleGenerator : public ParticleGenerator
      -# Set radii for all particle types to be generated
      -# Construct and add any number of ParticleGenerator instances to the RandomGenerator
      -# Call generate() to actually place the particles
+
+    In MPI simulations, generate() places all particles on the root rank. generateDistributed() instead places the
+    particles of every domain on its own rank, see its documentation for the restrictions.
 */
 class PYBIND11_EXPORT RandomGenerator
     {
@@ -243,6 +246,11 @@ class PYBIND11_EXPORT RandomGenerator
         //! Place the particles
         void generate();
 
+        #ifdef ENABLE_MPI
+        //! Place the particles of the local domain
+        void generateDistributed(std::shared_ptr<DomainDecomposition> decomposition);
+        #endif
+
     private:
         std::shared_ptr<const ExecutionConfiguration> m_exec_conf; //!< The execution configuration
         BoxDim m_box;                                       //!< Precalculated box
@@ -254,6 +262,8 @@ class PYBIND11_EXPORT RandomGenerator
         std::vector<std::string> m_type_mapping;            //!< The created mapping between particle types and ids
         std::vector<std::string> m_bond_type_mapping;       //!< The created mapping between bond types and ids
         unsigned int m_dimensions;                          //!< Number of dimensions
+        bool m_distributed;                                 //!< True if every rank generated its own domain
+        unsigned int m_tag_offset;                          //!< Tag of the first particle generated on this rank
 
         //! Helper function for identifying the particle type id
         unsigned int getTypeId(const std::string& name);
@@ -10,7 +10,7 @@ import math
 import os
 from hoomd import _hoomd
 
-def read_xml(filename, restart = None, time_step = None, wrap_coordinates = False):
+def read_xml(filename, restart = None, time_step = None, wrap_coordinates = False, streaming = False):
     R""" ## Reads initial system state from an XML file
 
     Args:
@@ -18,6 +18,7 @@ def read_xml(filename, restart = None, time_step = None, wrap_coordinates = Fals
         restart (str): If it exists, read *restart* instead of *filename*.
         time_step (int): (if specified) Time step number to use instead of the one stored in the XML file
         wrap_coordinates (bool): Wrap input coordinates back into the box
+        streaming (bool): Read the file with the streaming reader
 
     .. deprecated:: 2.0
        GSD is the new default file format for HOOMD-blue. It can store everything that an XML file can in
@@ -49,6 +50,13 @@ def read_xml(filename, restart = None, time_step = None, wrap_coordinates = Fals
     into the box specified inside the XML file. If it is set to False, out-of-box
     coordinates will result in an error.
 
+    If *streaming* is set to True, the file is read in blocks and converted directly into the
+    system snapshot, without building the document tree in memory first. This is much faster and needs
+    far less memory for large files. The streaming reader accepts the same files and performs the same checks.
+
+    .. versionadded:: 2.5
+       The *streaming* option.
+
     """
     hoomd.util.print_status_line();
 
@@ -65,7 +73,10 @@ def read_xml(filename, restart = None, time_step = None, wrap_coordinates = Fals
             filename_to_read = restart;
 
     # read in the data
-    initializer = _deprecated.HOOMDInitializer(hoomd.context.exec_conf,filename_to_read,wrap_coordinates);
+    if streaming:
+        initializer = _deprecated.HOOMDStreamInitializer(hoomd.context.exec_conf,filename_to_read,wrap_coordinates);
+    else:
+        initializer = _deprecated.HOOMDInitializer(hoomd.context.exec_conf,filename_to_read,wrap_coordinates);
     snapshot = initializer.getSnapshot()
 
     my_domain_decomposition = hoomd.init._create_domain_decomposition(snapshot._global_box);
@@ -115,6 +126,9 @@ def create_random(N, phi_p=None, name="A", min_dist=0.7, box=None, seed=1, dimen
     The result of :py:func:`hoomd.deprecated.init.create_random` can be saved in a variable and later used to read
     and/or change particle properties later in the script. See :py:mod:`hoomd.data` for more information.
 
+    In MPI simulations, every rank generates the particles in its own domain. The particle positions then depend on
+    the number of ranks, and no particle is placed closer than *min_dist*/2 to a boundary between domains.
+
     """
     hoomd.util.print_status_line();
 
@@ -160,13 +174,16 @@ def create_random(N, phi_p=None, name="A", min_dist=0.7, box=None, seed=1, dimen
     # set the separation radius
     generator.setSeparationRadius(name, min_dist/2.0);
 
-    # generate the particles
-    generator.generate();
+    # generate the particles, on every rank in its own domain when there is more than one
+    my_domain_decomposition = hoomd.init._create_domain_decomposition(box._getBoxDim());
+    if my_domain_decomposition is not None:
+        generator.generateDistributed(my_domain_decomposition);
+    else:
+        generator.generate();
 
     # initialize snapshot
     snapshot = generator.getSnapshot()
 
-    my_domain_decomposition = hoomd.init._create_domain_decomposition(snapshot._global_box);
     if my_domain_decomposition is not None:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition);
     else:
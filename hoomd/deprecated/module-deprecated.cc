@@ -5,6 +5,7 @@
 #include "HOOMDDumpWriter.h"
 #include "POSDumpWriter.h"
 #include "HOOMDInitializer.h"
+#include "HOOMDStreamInitializer.h"
 #include "RandomGenerator.h"
 
 // include GPU classes
@@ -23,6 +24,7 @@ PYBIND11_MODULE(_deprecated, m)
     export_HOOMDDumpWriter(m);
     export_POSDumpWriter(m);
     export_HOOMDInitializer(m);
+    export_HOOMDStreamInitializer(m);
     export_RandomGenerator(m);
 
 #ifdef ENABLE_CUDA
@@ -7,6 +7,7 @@ import hoomd;
 context.initialize()
 import unittest
 import os
+import numpy
 
 # unit tests for init.create_random
 class init_create_random_tests (unittest.TestCase):
@@ -45,6 +46,29 @@ class init_create_random_tests (unittest.TestCase):
         self.assertEqual(len(snap.angles.types), 0);
         self.assertEqual(len(snap.dihedrals.types), 0);
 
+    # test that every tag is generated once and no two particles are closer than min_dist, also
+    # across the domain boundaries of MPI runs
+    def test_distributed(self):
+        s = deprecated.init.create_random(N=1000, phi_p=0.1, min_dist=0.8, seed=12);
+        self.assertEqual(len(s.particles), 1000);
+        snap = s.take_snapshot();
+        if comm.get_rank() == 0:
+            self.assertEqual(snap.particles.N, 1000);
+            L = snap.box.Lx;
+            pos = numpy.array(snap.particles.position, dtype=numpy.float64);
+            self.assertTrue(numpy.all(numpy.abs(pos) <= L/2));
+            dr = pos[:,numpy.newaxis,:] - pos[numpy.newaxis,:,:];
+            dr -= L*numpy.round(dr/L);
+            rsq = numpy.sum(dr**2, axis=2);
+            numpy.fill_diagonal(rsq, L*L);
+            self.assertGreaterEqual(numpy.min(rsq), 0.8**2 * (1 - 1e-4));
+
+        # tags are contiguous and each one is owned by exactly one rank
+        for tag in [0, 499, 999]:
+            p = s.particles[tag].position;
+            if comm.get_rank() == 0:
+                numpy.testing.assert_allclose(p, snap.particles.position[tag], atol=1e-5);
+
     def tearDown(self):
         context.initialize();
 
@@ -8,6 +8,7 @@
 #include <math.h>
 #include "hoomd/deprecated/HOOMDDumpWriter.h"
 #include "hoomd/deprecated/HOOMDInitializer.h"
+#include "hoomd/deprecated/HOOMDStreamInitializer.h"
 #include "hoomd/ParticleGroup.h"
 #include "hoomd/BondedGroupData.h"
 #include "hoomd/Filesystem.h"
@@ -1610,3 +1611,102 @@ im_b 5 4 3 2\n\
     // clean up after ourselves
     unlink((tmp_path+"/test_input.xml").c_str());
     }
+
+//! Checks that HOOMDStreamInitializer reads the same snapshot as HOOMDInitializer
+UP_TEST( HOOMDStreamInitializer_compare_test )
+    {
+    // temporary directory for files
+    std::string tmp_path = ".";
+    const unsigned int N = 1000;
+
+    // create a test input file with comments and some odd formatting
+    ofstream f((tmp_path+"/test_stream_input.xml").c_str());
+    f << "<?xml version =\"1.0\" encoding =\"UTF-8\" ?>\n";
+    f << "<!-- a comment before the root node -->\n";
+    f << "<hoomd_xml version=\"1.7\">\n";
+    f << "<configuration time_step=\"1234\" dimensions=\"3\">\n";
+    f << "<box lx=\"20.05\" ly= \"32.12345\" lz='45.098' xy=\".12\"/>\n";
+    f << "<position num=\"" << N << "\">\n";
+    for (unsigned int i = 0; i < N; i++)
+        {
+        f << Scalar(i)*Scalar(0.01) - Scalar(5.0) << " " << Scalar(i%17)*Scalar(0.5) << "\t" << -Scalar(i)*Scalar(1e-3);
+        if (i == N/2)
+            f << " <!-- a comment inside the data -->";
+        f << "\n";
+        }
+    f << "</position>\n";
+    f << "<velocity>\n";
+    for (unsigned int i = 0; i < N; i++)
+        f << Scalar(i%7) << " " << Scalar(i%11) << " " << Scalar(i%13) << "\n";
+    f << "</velocity>\n";
+    f << "<unknown_node><child a=\"1\">text</child></unknown_node>\n";
+    f << "<type>\n";
+    for (unsigned int i = 0; i < N; i++)
+        f << ((i % 3 == 0) ? "A" : "Bx") << (i % 8 == 7 ? "\n" : " ");
+    f << "</type>\n";
+    f << "<mass>\n";
+    for (unsigned int i = 0; i < N; i++)
+        f << Scalar(1.0) + Scalar(i%5) << "\n";
+    f << "</mass>\n";
+    f << "<bond>\n";
+    for (unsigned int i = 0; i < N-1; i++)
+        f << ((i % 2) ? "polymer" : "backbone") << " " << i << " " << i+1 << "\n";
+    f << "</bond>\n";
+    f << "</configuration>\n";
+    f << "</hoomd_xml>" << endl;
+    f.close();
+
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    HOOMDInitializer init(exec_conf,tmp_path+"/test_stream_input.xml");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap_ref = init.getSnapshot();
+
+    // use small blocks so that nodes, tokens and markup are split across block boundaries
+    unsigned int block_sizes[] = {7, 64, 1000, 1 << 24};
+    for (unsigned int b = 0; b < sizeof(block_sizes)/sizeof(unsigned int); b++)
+        {
+        HOOMDStreamInitializer::setBlockSize(block_sizes[b]);
+        HOOMDStreamInitializer stream_init(exec_conf,tmp_path+"/test_stream_input.xml");
+        std::shared_ptr< SnapshotSystemData<Scalar> > snap = stream_init.getSnapshot();
+
+        UP_ASSERT_EQUAL(stream_init.getTimeStep(), init.getTimeStep());
+        UP_ASSERT_EQUAL(snap->dimensions, snap_ref->dimensions);
+        MY_CHECK_CLOSE(snap->global_box.getL().x, snap_ref->global_box.getL().x, tol);
+        MY_CHECK_CLOSE(snap->global_box.getL().y, snap_ref->global_box.getL().y, tol);
+        MY_CHECK_CLOSE(snap->global_box.getL().z, snap_ref->global_box.getL().z, tol);
+        MY_CHECK_CLOSE(snap->global_box.getTiltFactorXY(), snap_ref->global_box.getTiltFactorXY(), tol);
+
+        const SnapshotParticleData<Scalar>& pdata = snap->particle_data;
+        const SnapshotParticleData<Scalar>& pdata_ref = snap_ref->particle_data;
+        UP_ASSERT_EQUAL(pdata.size, N);
+        UP_ASSERT_EQUAL(pdata.size, pdata_ref.size);
+        UP_ASSERT(pdata.type_mapping == pdata_ref.type_mapping);
+        for (unsigned int i = 0; i < N; i++)
+            {
+            MY_CHECK_CLOSE(pdata.pos[i].x, pdata_ref.pos[i].x, tol);
+            MY_CHECK_CLOSE(pdata.pos[i].y, pdata_ref.pos[i].y, tol);
+            MY_CHECK_CLOSE(pdata.pos[i].z, pdata_ref.pos[i].z, tol);
+            MY_CHECK_CLOSE(pdata.vel[i].x, pdata_ref.vel[i].x, tol);
+            MY_CHECK_CLOSE(pdata.vel[i].y, pdata_ref.vel[i].y, tol);
+            MY_CHECK_CLOSE(pdata.vel[i].z, pdata_ref.vel[i].z, tol);
+            MY_CHECK_CLOSE(pdata.mass[i], pdata_ref.mass[i], tol);
+            MY_CHECK_CLOSE(pdata.diameter[i], pdata_ref.diameter[i], tol);
+            UP_ASSERT_EQUAL(pdata.type[i], pdata_ref.type[i]);
+            UP_ASSERT_EQUAL(pdata.body[i], pdata_ref.body[i]);
+            }
+
+        const BondData::Snapshot& bdata = snap->bond_data;
+        const BondData::Snapshot& bdata_ref = snap_ref->bond_data;
+        UP_ASSERT_EQUAL(bdata.size, N-1);
+        UP_ASSERT(bdata.type_mapping == bdata_ref.type_mapping);
+        for (unsigned int i = 0; i < N-1; i++)
+            {
+            UP_ASSERT_EQUAL(bdata.groups[i].tag[0], bdata_ref.groups[i].tag[0]);
+            UP_ASSERT_EQUAL(bdata.groups[i].tag[1], bdata_ref.groups[i].tag[1]);
+            UP_ASSERT_EQUAL(bdata.type_id[i], bdata_ref.type_id[i]);
+            }
+        }
+    HOOMDStreamInitializer::setBlockSize(1 << 24);
+
+    // clean up after ourselves
+    unlink((tmp_path+"/test_stream_input.xml").c_str());
+    }
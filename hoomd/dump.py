@@ -300,7 +300,7 @@ class getar(hoomd.analyze._analyzer):
 
         return result;
 
-    def __init__(self, filename, mode='w', static=[], dynamic={}, _register=True):
+    def __init__(self, filename, mode='w', static=[], dynamic={}, async_write=False, queue_depth=2, _register=True):
         """Initialize a getar dumper. Creates or appends an archive at the given file
         location according to the mode and prepares to dump the given
         sets of properties.
@@ -310,6 +310,8 @@ class getar(hoomd.analyze._analyzer):
             mode (str): Run mode; see mode list below.
             static (list): List of static properties to dump immediately
             dynamic (dict): Dictionary of {prop: period} periodic dumps
+            async_write (bool): When True, compress and write frames on a background thread while the simulation continues. (added in version 2.5)
+            queue_depth (int): Number of frames that may wait for the background thread before the simulation blocks. (added in version 2.5)
             _register (bool): If True, register as a hoomd analyzer (internal)
 
         Note that zip32-format archives can not be appended to at the
@@ -370,6 +372,7 @@ class getar(hoomd.analyze._analyzer):
         self.cpp_analyzer = _hoomd.GetarDumpWriter(hoomd.context.current.system_definition,
                                                 filename, dumpMode,
                                                 hoomd.context.current.system.getCurrentTimeStep());
+        self.cpp_analyzer.setAsync(async_write, int(queue_depth));
 
         for val in set(self._static):
             prop = self._getStatic(val);
@@ -504,6 +507,11 @@ class gsd(hoomd.analyze._analyzer):
         time_step (int): Time step to write to the file (only used when period is None)
         dynamic (list): A list of quantity categories to save every frame. (added in version 2.2)
         static (list): A list of quantity categories save only in frame 0 (may not be set in conjunction with *dynamic*, deprecated in version 2.2).
+        async_write (bool): When True, write frames on a background thread while the simulation continues. (added in version 2.5)
+        parallel_io (bool): When True, write the particle data collectively from all MPI ranks with MPI-IO. (added in version 2.5)
+        position_bits (int): When set (1 to 16), store positions quantized to this many bits per coordinate. (added in version 2.5)
+        keyframe_period (int): When set, store full positions and orientations only every *keyframe_period* frames and deltas in between. (added in version 2.5)
+        delta_resolution (float): Resolution of the position deltas (in distance units). (added in version 2.5)
 
     Write a simulation snapshot to the specified GSD file at regular intervals.
     GSD is capable of storing all particle and bond data fields in hoomd,
@@ -577,6 +585,32 @@ class gsd(hoomd.analyze._analyzer):
         dump.gsd(filename="configuration.gsd", overwrite=True, period=None, group=group.all(), time_step=0)
         dump.gsd(filename="momentum_too.gsd", period=1000, group=group.all(), phase=0, dynamic=['momentum'])
         dump.gsd(filename="saveall.gsd", overwrite=True, period=1000, group=group.all(), dynamic=['attribute', 'momentum', 'topology'])
+        dump.gsd(filename="trajectory.gsd", period=1000, group=group.all(), async_write=True)
+
+    With *async_write*, the file I/O of a frame overlaps with the following time steps. At most one frame is in flight
+    at a time: when the next frame is due before the previous one is on disk, the simulation waits for the writer.
+    All frames are complete in the file when :py:func:`hoomd.run` returns.
+
+    *position_bits* enables a lossy encoding of the positions for analysis-only trajectories. Positions are stored as
+    fractional box coordinates with *position_bits* bits each in the chunk ``particles/position_quantized`` instead of
+    ``particles/position``, which halves the size of the position data. The maximum error in each direction is
+    :math:`L/2^{b+1}`. :py:func:`hoomd.data.gsd_snapshot` and :py:func:`hoomd.init.read_gsd` decode quantized positions,
+    other GSD readers see only the quantized chunk. Do not use *position_bits* for restart files.
+
+    *keyframe_period* enables a lossy delta encoding for short dump periods, where particles move little between frames.
+    Every *keyframe_period*-th frame is a keyframe with the full ``particles/position`` and ``particles/orientation``.
+    The frames in between store the displacement of each particle from its keyframe position as 16 bit integers in
+    units of *delta_resolution* in ``particles/position_delta``, and the difference to the keyframe orientation in
+    units of :math:`2^{-14}` in ``particles/orientation_delta``. The index of the keyframe is stored in
+    ``particles/position_keyframe``, so any frame can be read from itself and its keyframe. The maximum position error
+    is *delta_resolution*/2. A frame in which a particle has moved more than 32767 times *delta_resolution* from its
+    keyframe position is written as a new keyframe. :py:func:`hoomd.data.gsd_snapshot` and :py:func:`hoomd.init.read_gsd`
+    decode the deltas, other GSD readers see only the delta chunks in the frames between keyframes. *keyframe_period* cannot
+    be combined with *position_bits* or *parallel_io*. Do not use it for restart files.
+
+    With *parallel_io*, every MPI rank writes the particles in its domain directly to the file instead of gathering
+    the whole system on rank 0. This reduces the memory needed on rank 0 and scales the output bandwidth with the
+    number of ranks. The file system must support MPI-IO. Topology is still written by rank 0.
 
     """
     def __init__(self,
@@ -588,12 +622,21 @@ class gsd(hoomd.analyze._analyzer):
                  phase=0,
                  time_step=None,
                  static=None,
-                 dynamic=None):
+                 dynamic=None,
+                 async_write=False,
+                 parallel_io=False,
+                 position_bits=None,
+                 keyframe_period=None,
+                 delta_resolution=1e-3):
         hoomd.util.print_status_line();
 
         if static is not None and dynamic is not None:
             raise ValueError("Cannot specify both static and dynamic arguments");
 
+        if keyframe_period is not None and (position_bits is not None or parallel_io):
+            hoomd.context.msg.error("dump.gsd: keyframe_period cannot be combined with position_bits or parallel_io\n");
+            raise ValueError("Cannot combine keyframe_period with position_bits or parallel_io");
+
         categories = ['attribute', 'property', 'momentum', 'topology'];
         dynamic_quantities = ['property']
 
@@ -628,6 +671,13 @@ class gsd(hoomd.analyze._analyzer):
         self.cpp_analyzer.setWriteProperty('property' in dynamic_quantities);
         self.cpp_analyzer.setWriteMomentum('momentum' in dynamic_quantities);
         self.cpp_analyzer.setWriteTopology('topology' in dynamic_quantities);
+        self.cpp_analyzer.setAsync(async_write);
+        if position_bits is not None:
+            self.cpp_analyzer.setQuantizePositions(int(position_bits));
+        if keyframe_period is not None:
+            self.cpp_analyzer.setDeltaEncoding(int(keyframe_period), float(delta_resolution));
+        if parallel_io and _hoomd.is_MPI_available():
+            self.cpp_analyzer.setParallelWrite(True);
 
         if period is not None:
             self.setupAnalyzer(period, phase);
@@ -635,6 +685,7 @@ class gsd(hoomd.analyze._analyzer):
             if time_step is None:
                 time_step = hoomd.context.current.system.getCurrentTimeStep()
             self.cpp_analyzer.analyze(time_step);
+            self.cpp_analyzer.flush();
 
         # store metadata
         self.filename = filename
@@ -653,6 +704,7 @@ class gsd(hoomd.analyze._analyzer):
 
         time_step = hoomd.context.current.system.getCurrentTimeStep()
         self.cpp_analyzer.analyze(time_step);
+        self.cpp_analyzer.flush();
 
     def dump_state(self, obj):
         """Write state information for a hoomd object.
@@ -666,3 +718,62 @@ class gsd(hoomd.analyze._analyzer):
             obj._connect_gsd(self);
         else:
             hoomd.context.msg.warning("GSD is not currently support for {name}".format(obj.__name__));
+
+class checkpoint(hoomd.analyze._analyzer):
+    R""" Writes checkpoints for exact restarts.
+
+    Args:
+        filename (str): Name of the index file of the checkpoint.
+        period (int): Number of time steps between checkpoints. When None, write a single checkpoint now.
+        phase (int): When -1, start on the current time step. When >= 0, execute on steps where *(step + phase) % period == 0*.
+
+    A checkpoint stores the complete system state in a binary format: all particle properties in double precision,
+    the bonds, angles, dihedrals, impropers, constraints and pairs, the box, and the integrator variables, including
+    the thermostat and barostat variables of MD integration methods and the move sizes of HPMC integrators. Read it
+    with :py:func:`hoomd.init.read_checkpoint`.
+
+    Every MPI rank writes the particles of its domain to its own shard *filename.i* without gathering them
+    on rank 0, rank 0 writes the index file *filename*. A new checkpoint replaces the previous one only after all
+    ranks have written their shards, so a job that is killed while it writes a checkpoint keeps the previous one.
+
+    The random number generators in HOOMD are seeded by the user seed, the time step and the particle tags, so the
+    time step and the tags in the checkpoint also restart the random number streams. Autotuner and neighbor list
+    state are not stored, they are rebuilt in the first steps after a restart.
+
+    Examples::
+
+        dump.checkpoint(filename="restart.chk", period=100000)
+        chk = dump.checkpoint(filename="restart.chk", period=None)
+
+    See Also:
+        :py:func:`hoomd.init.read_checkpoint`
+    """
+    def __init__(self, filename, period, phase=0):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        hoomd.analyze._analyzer.__init__(self);
+
+        # every rank writes its shard next to the index file
+        filename = _hoomd.mpi_bcast_str(filename, hoomd.context.exec_conf);
+        self.cpp_analyzer = _hoomd.CheckpointWriter(hoomd.context.current.system_definition, filename);
+
+        if period is not None:
+            self.setupAnalyzer(period, phase);
+        else:
+            self.cpp_analyzer.analyze(hoomd.context.current.system.getCurrentTimeStep());
+
+        # store metadata
+        self.filename = filename
+        self.period = period
+        self.phase = phase
+        self.metadata_fields = ['filename','period','phase']
+
+    def write_restart(self):
+        """ Write a checkpoint at the current time step.
+
+        Call :py:meth:`write_restart` at the end of a job to store the final state.
+        """
+
+        time_step = hoomd.context.current.system.getCurrentTimeStep()
+        self.cpp_analyzer.analyze(time_step);
@@ -0,0 +1,206 @@
+# Copyright (c) 2009-2019 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+# Maintainer: joaander / All Developers are free to add commands for new features
+
+R""" Run many independent replicas of a small system in one simulation.
+
+A system of a few thousand particles leaves most of a GPU idle, as every kernel launch covers only a few thousand
+threads. :py:class:`replicas` combines many copies of such a system into one simulation, so that every kernel
+(neighbor list, pair and bonded forces, integration) processes all replicas in a single launch.
+
+All replicas share the simulation box and overlap in space. Every particle type is duplicated per replica, and the
+interactions between the types of different replicas are turned off, so the replicas evolve independently.
+Bonds, angles, dihedrals, impropers, special pairs and constraints connect only particles of the same replica and
+keep their types, so the bonded force fields are identical in all replicas.
+"""
+
+import hoomd;
+import numpy;
+
+class replicas(hoomd.meta._metadata):
+    R""" Initialize a simulation of independent replicas.
+
+    Args:
+        snapshot (:py:mod:`hoomd.data` snapshot): The system to replicate.
+        n (int): Number of replicas.
+
+    :py:class:`replicas` initializes the system with *n* copies of *snapshot*. The particles of replica *i* have the
+    tags *i*\*N to (*i* + 1)\*N - 1, where N is the number of particles in *snapshot*, and the type *t* of
+    *snapshot* is named *t*.\ *i* in the replicated system. Use :py:meth:`group()` to apply an integration
+    method or compute to one replica, and :py:meth:`pair_coeff()` to set the pair coefficients of all replicas and
+    turn off the interactions between them. Different parameters per replica (e.g. for a parameter sweep) can be set
+    with the pair coefficients of the types :py:meth:`types()` of that replica.
+
+    Use :py:class:`hoomd.md.nlist.tree`, which builds a separate tree per particle type and never visits the particles
+    of other replicas. The cell list based neighbor lists examine the particles of all replicas that overlap in space.
+
+    Note:
+        The pair potentials keep their parameters for all type pairs in shared memory on the GPU, so the number of
+        type pairs ((*n* times the number of types) squared) limits the number of replicas. For a single type, up to
+        about 40 replicas fit.
+
+    Note:
+        All replicas share the box. Box changes, e.g. by :py:class:`hoomd.update.box_resize` or an NPT integrator,
+        apply to all replicas.
+
+    Examples::
+
+        snap = hoomd.data.make_snapshot(N=4000, box=hoomd.data.boxdim(L=16.8))
+        ...
+        ensemble = hoomd.ensemble.replicas(snap, n=32)
+        nl = hoomd.md.nlist.tree()
+        lj = hoomd.md.pair.lj(r_cut=2.5, nlist=nl)
+        ensemble.pair_coeff(lj, 'A', 'A', epsilon=1.0, sigma=1.0)
+        hoomd.md.integrate.mode_standard(dt=0.005)
+        for i in range(32):
+            hoomd.md.integrate.nvt(group=ensemble.group(i), kT=0.8 + 0.05*i, tau=0.5)
+    """
+    def __init__(self, snapshot, n):
+        hoomd.util.print_status_line();
+
+        if n < 1:
+            hoomd.context.msg.error("ensemble.replicas: n must be positive\n");
+            raise RuntimeError("Error initializing replicas");
+
+        self.n = int(n);
+
+        if hoomd.comm.get_rank() == 0:
+            self.base_types = list(snapshot.particles.types);
+            self._replicate(snapshot);
+
+        hoomd.util.quiet_status();
+        self.system = hoomd.init.read_snapshot(snapshot);
+        hoomd.util.unquiet_status();
+
+        # the type names and particle counts are only known on rank 0
+        pdata = hoomd.context.current.system_definition.getParticleData();
+        ntypes = pdata.getNTypes() // self.n;
+        self.base_types = [pdata.getNameByType(t)[:-len('.0')] for t in range(ntypes)];
+        self.N = pdata.getNGlobal() // self.n;
+
+        self._groups = {};
+
+        # base class constructor
+        hoomd.meta._metadata.__init__(self)
+        self.metadata_fields = ['n'];
+
+    ## \internal
+    # \brief Replace the contents of the snapshot with n copies
+    def _replicate(self, snapshot):
+        N = snapshot.particles.N;
+        ntypes = len(self.base_types);
+
+        fields = ['position', 'velocity', 'acceleration', 'typeid', 'mass', 'charge', 'diameter', 'image', 'body',
+                  'orientation', 'moment_inertia', 'angmom'];
+        data = {};
+        for f in fields:
+            data[f] = numpy.array(getattr(snapshot.particles, f), copy=True);
+
+        snapshot.particles.resize(N*self.n);
+        snapshot.particles.types = ['%s.%d' % (t, i) for i in range(self.n) for t in self.base_types];
+
+        for i in range(self.n):
+            for f in fields:
+                getattr(snapshot.particles, f)[i*N:(i+1)*N] = data[f];
+
+            snapshot.particles.typeid[i*N:(i+1)*N] = data['typeid'] + i*ntypes;
+
+            # rigid bodies are referenced by the tag of their central particle
+            body = numpy.array(data['body'], copy=True);
+            in_body = body != numpy.iinfo(body.dtype).max;
+            body[in_body] += i*N;
+            snapshot.particles.body[i*N:(i+1)*N] = body;
+
+        for bonded in [snapshot.bonds, snapshot.angles, snapshot.dihedrals, snapshot.impropers, snapshot.pairs,
+                       snapshot.constraints]:
+            M = bonded.N;
+            if M == 0:
+                continue;
+
+            group = numpy.array(bonded.group, copy=True);
+            if hasattr(bonded, 'typeid'):
+                typeid = numpy.array(bonded.typeid, copy=True);
+            else:
+                value = numpy.array(bonded.value, copy=True);
+
+            bonded.resize(M*self.n);
+            for i in range(self.n):
+                bonded.group[i*M:(i+1)*M] = group + i*N;
+                if hasattr(bonded, 'typeid'):
+                    bonded.typeid[i*M:(i+1)*M] = typeid;
+                else:
+                    bonded.value[i*M:(i+1)*M] = value;
+
+    def types(self, replica):
+        R""" Get the particle type names of a replica.
+
+        Args:
+            replica (int): Index of the replica.
+
+        Returns:
+            A list of the type names of *replica*, in the order of the types of the original snapshot.
+        """
+        self._check_replica(replica);
+        return ['%s.%d' % (t, replica) for t in self.base_types];
+
+    def group(self, replica):
+        R""" Get the group of all particles of a replica.
+
+        Args:
+            replica (int): Index of the replica.
+
+        Returns:
+            A :py:mod:`hoomd.group` named *replica_<i>*, created on the first call.
+        """
+        self._check_replica(replica);
+
+        if replica not in self._groups:
+            hoomd.util.quiet_status();
+            self._groups[replica] = hoomd.group.tags(replica*self.N, (replica+1)*self.N - 1,
+                                                     name='replica_%d' % replica);
+            hoomd.util.unquiet_status();
+
+        return self._groups[replica];
+
+    def pair_coeff(self, pair, a, b, **coeffs):
+        R""" Set the pair coefficients of a type pair in all replicas.
+
+        Args:
+            pair: The pair potential (e.g. :py:class:`hoomd.md.pair.lj`).
+            a (str): First type of the original snapshot.
+            b (str): Second type of the original snapshot.
+            coeffs: Keyword arguments passed to ``pair.pair_coeff.set()``.
+
+        The type pair (*a*, *b*) of every replica is set to *coeffs*. The interactions between *a* and *b* in
+        different replicas are turned off with *r_cut=False*.
+
+        Example::
+
+            ensemble.pair_coeff(lj, 'A', 'B', epsilon=1.0, sigma=1.0)
+        """
+        hoomd.util.print_status_line();
+
+        if a not in self.base_types or b not in self.base_types:
+            hoomd.context.msg.error("ensemble.replicas: Invalid type pair " + str((a,b)) + "\n");
+            raise RuntimeError("Error setting pair coefficients");
+
+        off_coeffs = dict(coeffs);
+        off_coeffs['r_cut'] = False;
+
+        hoomd.util.quiet_status();
+        for i in range(self.n):
+            pair.pair_coeff.set('%s.%d' % (a, i), '%s.%d' % (b, i), **coeffs);
+
+            # the type pairs are symmetric, so a-b between i and j covers b-a between j and i
+            others = ['%s.%d' % (b, j) for j in range(self.n) if j != i];
+            if len(others) > 0:
+                pair.pair_coeff.set('%s.%d' % (a, i), others, **off_coeffs);
+        hoomd.util.unquiet_status();
+
+    ## \internal
+    # \brief Check the index of a replica
+    def _check_replica(self, replica):
+        if replica < 0 or replica >= self.n:
+            hoomd.context.msg.error("ensemble.replicas: Invalid replica " + str(replica) + "\n");
+            raise RuntimeError("Error accessing replica");
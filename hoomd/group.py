@@ -122,6 +122,32 @@ class group(hoomd.meta._metadata):
         """
         self.cpp_group.updateMemberTags(True);
 
+    def get_properties(self, fields=None):
+        R""" Get properties of all particles in the group at once.
+
+        Args:
+            fields (list): Names of the properties to get, see :py:meth:`hoomd.data.particle_data.get_properties()`.
+                Set to None to get all of them.
+
+        Returns:
+            A dict that maps the property names to numpy arrays with one row per group member, and the key ``tag``
+            to the tags of the members in increasing order.
+
+        Unlike iterating over the group, :py:meth:`get_properties()` accesses the member list and the particle
+        data once for all members. In MPI simulations, it must be called on all ranks.
+
+        .. versionadded:: 2.5
+
+        Examples::
+
+            props = group_A.get_properties(['velocity', 'mass'])
+            ke = 0.5*numpy.sum(props['mass']*numpy.sum(props['velocity']**2, axis=1))
+        """
+        tags = self.cpp_group.getMemberTags();
+        result = hoomd.data._get_properties(hoomd.context.current.system_definition.getParticleData(), tags, fields);
+        result['tag'] = tags;
+        return result;
+
     ## \internal
     # \brief Get a particle_proxy reference to the i'th particle in the group
     # \param i Index of the particle in the group to get
@@ -22,6 +22,10 @@
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 namespace hpmc
 {
 
@@ -154,14 +158,14 @@ class AnalyzerSDF : public Analyzer
         void zeroHistogram();
 
         //! Add to histogram counts
-        void countHistogram(unsigned int timestep);
+        virtual void countHistogram(unsigned int timestep);
 
         //! Determine the s bin of a given particle pair
         int computeBin(const vec3<Scalar>& r_ij,
                        const quat<Scalar>& orientation_i,
                        const quat<Scalar>& orientation_j,
                        const typename Shape::param_type& params_i,
-                       const typename Shape::param_type& params_j);
+                       const typename Shape::param_type& params_j) const;
     };
 
 
@@ -326,6 +330,8 @@ void AnalyzerSDF<Shape>::zeroHistogram()
     for averaging, and it operates without any communication
       - The integrator performs the ghost exchange (with the ghost width extra that we add)
       - Only on writeOutput() do we need to sum the per-rank histograms into a global histogram
+
+    The particles are processed in parallel with TBB, every thread counting into its own histogram.
 */
 template < class Shape >
 void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
@@ -343,10 +349,12 @@ void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
 
     const std::vector<param_type, managed_allocator<param_type> > & params = m_mc->getParams();
 
-    // loop through N particles
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    const unsigned int n_bins = m_hist.size();
+
+    // find the minimum bin of particle i
+    auto min_bin_particle = [&](unsigned int i)->int
         {
-        int min_bin = m_hist.size();
+        int min_bin = n_bins;
 
         // read in the current position and orientation
         Scalar4 postype_i = h_postype.data[i];
@@ -368,7 +376,7 @@ void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
             // stackless search
             for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
                 {
-                if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                if (aabb_tree.overlapNode(cur_node_idx, aabb))
                     {
                     if (aabb_tree.isNodeLeaf(cur_node_idx))
                         {
@@ -407,11 +415,41 @@ void AnalyzerSDF<Shape>::countHistogram(unsigned int timestep)
                 } // end loop over AABB nodes
             } // end loop over images
 
+        return min_bin;
+        };
+
+    #ifdef ENABLE_TBB
+    // every thread counts into its own histogram, the histograms are summed at the end
+    tbb::enumerable_thread_specific< std::vector<unsigned int> > hist_thread(std::vector<unsigned int>(n_bins, 0));
+
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        std::vector<unsigned int>& hist = hist_thread.local();
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+            {
+            // record the minimum bin
+            int min_bin = min_bin_particle(i);
+            if ((unsigned int)min_bin < n_bins)
+                hist[min_bin]++;
+            }
+        });
+
+    for (auto it = hist_thread.begin(); it != hist_thread.end(); ++it)
+        {
+        for (unsigned int k = 0; k < n_bins; k++)
+            m_hist[k] += (*it)[k];
+        }
+    #else
+    // loop through N particles
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        {
         // record the minimum bin
-        if ((unsigned int)min_bin < m_hist.size())
+        int min_bin = min_bin_particle(i);
+        if ((unsigned int)min_bin < n_bins)
             m_hist[min_bin]++;
-
-        } // end loop over all particles
+        }
+    #endif
     }
 
 /*! \param r_ij Vector pointing from particle i to j (already wrapped into the box)
@@ -434,7 +472,7 @@ int AnalyzerSDF<Shape>:: computeBin(const vec3<Scalar>& r_ij,
                              const quat<Scalar>& orientation_i,
                              const quat<Scalar>& orientation_j,
                              const typename Shape::param_type& params_i,
-                             const typename Shape::param_type& params_j)
+                             const typename Shape::param_type& params_j) const
     {
     unsigned int L=0;
     unsigned int R=m_hist.size();
@@ -0,0 +1,411 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _ANALYZER_SDF_GPU_CUH_
+#define _ANALYZER_SDF_GPU_CUH_
+
+#include "HPMCPrecisionSetup.h"
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/ParticleData.cuh"
+#include "hoomd/Index1D.h"
+
+#ifdef NVCC
+#include "ComputeFreeVolumeGPU.cuh"
+#include "hoomd/TextureTools.h"
+#endif
+
+/*! \file AnalyzerSDFGPU.cuh
+    \brief Declaration of the CUDA kernel driver of the SDF histogram
+*/
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Wraps arguments to gpu_hpmc_sdf
+/*! \ingroup hpmc_data_structs */
+struct hpmc_sdf_args_t
+    {
+    //! Construct a hpmc_sdf_args_t
+    hpmc_sdf_args_t(const Scalar4 *_d_postype,
+                    const Scalar4 *_d_orientation,
+                    const unsigned int *_d_excell_idx,
+                    const unsigned int *_d_excell_size,
+                    const Index2D& _excli,
+                    const Index3D& _ci,
+                    const uint3& _cell_dim,
+                    const Scalar3& _ghost_width,
+                    const unsigned int _N,
+                    const unsigned int _num_types,
+                    const BoxDim& _box,
+                    const unsigned int _n_bins,
+                    const Scalar _dl,
+                    unsigned int *_d_hist,
+                    const unsigned int _block_size,
+                    const unsigned int _group_size,
+                    const unsigned int _max_n,
+                    cudaStream_t _stream,
+                    const cudaDeviceProp& _devprop)
+                : d_postype(_d_postype),
+                  d_orientation(_d_orientation),
+                  d_excell_idx(_d_excell_idx),
+                  d_excell_size(_d_excell_size),
+                  excli(_excli),
+                  ci(_ci),
+                  cell_dim(_cell_dim),
+                  ghost_width(_ghost_width),
+                  N(_N),
+                  num_types(_num_types),
+                  box(_box),
+                  n_bins(_n_bins),
+                  dl(_dl),
+                  d_hist(_d_hist),
+                  block_size(_block_size),
+                  group_size(_group_size),
+                  max_n(_max_n),
+                  stream(_stream),
+                  devprop(_devprop)
+        {
+        };
+
+    const Scalar4 *d_postype;           //!< postype array
+    const Scalar4 *d_orientation;       //!< orientation array
+    const unsigned int *d_excell_idx;   //!< Expanded cell neighbors
+    const unsigned int *d_excell_size;  //!< Size of expanded cell list per cell
+    const Index2D excli;                //!< Expanded cell indexer
+    const Index3D ci;                   //!< Cell indexer
+    const uint3 cell_dim;               //!< Cell dimensions
+    const Scalar3 ghost_width;          //!< Width of ghost layer
+    const unsigned int N;               //!< Number of local particles
+    const unsigned int num_types;       //!< Number of particle types
+    const BoxDim& box;                  //!< Current simulation box
+    const unsigned int n_bins;          //!< Number of histogram bins
+    const Scalar dl;                    //!< Histogram bin width
+    unsigned int *d_hist;               //!< Histogram counts (output value)
+    unsigned int block_size;            //!< Block size to execute
+    unsigned int group_size;            //!< Number of threads per particle
+    const unsigned int max_n;           //!< Maximum size of pdata arrays
+    cudaStream_t stream;                //!< Stream for kernel execution
+    const cudaDeviceProp& devprop;      //!< CUDA device properties
+    };
+
+template< class Shape >
+cudaError_t gpu_hpmc_sdf(const hpmc_sdf_args_t &args, const typename Shape::param_type *d_params);
+
+#ifdef NVCC
+//! Test the overlap of two shapes with their distance scaled by 1-lambda
+template< class Shape >
+__device__ inline bool sdf_test_scaled_overlap(const vec3<Scalar>& r_ij,
+                                               const Shape& shape_i,
+                                               const Shape& shape_j,
+                                               Scalar lambda)
+    {
+    unsigned int err = 0;
+    vec3<Scalar> r_ij_scaled = r_ij * (Scalar(1.0) - lambda);
+    return check_circumsphere_overlap(r_ij_scaled, shape_i, shape_j) && test_overlap(r_ij_scaled, shape_i, shape_j, err);
+    }
+
+//! Determine the s bin of a particle pair
+/*! \returns -1 when the shapes already overlap, \a n_bins when they do not overlap at the largest scale
+
+    This is the same binary search as AnalyzerSDF::computeBin().
+*/
+template< class Shape >
+__device__ inline int sdf_compute_bin(const vec3<Scalar>& r_ij,
+                                      const Shape& shape_i,
+                                      const Shape& shape_j,
+                                      unsigned int n_bins,
+                                      Scalar dl)
+    {
+    unsigned int L = 0;
+    unsigned int R = n_bins;
+
+    if (sdf_test_scaled_overlap(r_ij, shape_i, shape_j, L*dl))
+        return -1;
+
+    if (!sdf_test_scaled_overlap(r_ij, shape_i, shape_j, R*dl))
+        return n_bins;
+
+    do
+        {
+        unsigned int m = (L+R)/2;
+
+        if (sdf_test_scaled_overlap(r_ij, shape_i, shape_j, m*dl))
+            R = m;
+        else
+            L = m;
+        } while ((R-L) > 1);
+
+    return L;
+    }
+
+//! Kernel to count the SDF histogram
+/*! \param d_postype Particle positions and types by index
+    \param d_orientation Particle orientation
+    \param d_excell_idx Particle indices in expanded cells
+    \param d_excell_size Number of particles in each expanded cell
+    \param excli Indexer for the expanded cells
+    \param ci Cell indexer
+    \param cell_dim Dimensions of the cell list
+    \param ghost_width Width of ghost layer
+    \param N Number of local particles
+    \param num_types Number of particle types
+    \param box Simulation box
+    \param n_bins Number of histogram bins
+    \param dl Histogram bin width
+    \param d_hist Histogram counts, added to
+    \param shared_hist True if the histogram is counted in shared memory
+    \param d_params Per-type shape parameters
+    \param max_extra_bytes Shared memory available for the shape parameters
+
+    Every group of blockDim.x threads processes one particle i. The threads of the group split the neighbors in the
+    expanded cell of i, and the smallest bin of the group is counted. When \a shared_hist is set, the block counts into
+    a histogram in shared memory that is added to \a d_hist at the end.
+*/
+template< class Shape >
+__global__ void gpu_hpmc_sdf_kernel(const Scalar4 *d_postype,
+                                    const Scalar4 *d_orientation,
+                                    const unsigned int *d_excell_idx,
+                                    const unsigned int *d_excell_size,
+                                    const Index2D excli,
+                                    const Index3D ci,
+                                    const uint3 cell_dim,
+                                    const Scalar3 ghost_width,
+                                    const unsigned int N,
+                                    const unsigned int num_types,
+                                    const BoxDim box,
+                                    const unsigned int n_bins,
+                                    const Scalar dl,
+                                    unsigned int *d_hist,
+                                    const bool shared_hist,
+                                    const typename Shape::param_type *d_params,
+                                    unsigned int max_extra_bytes)
+    {
+    unsigned int offset = threadIdx.x;
+    unsigned int group_size = blockDim.x;
+    unsigned int group = threadIdx.y;
+    unsigned int n_groups = blockDim.y;
+    bool master = (offset == 0);
+    unsigned int tidx = threadIdx.x + blockDim.x*threadIdx.y;
+    unsigned int block_size = blockDim.x*blockDim.y;
+
+    // shared memory layout: parameters, minimum bin per group, histogram, extra shape data
+    extern __shared__ char s_data[];
+    typename Shape::param_type *s_params = (typename Shape::param_type *)(&s_data[0]);
+    int *s_min_bin = (int *)(s_params + num_types);
+    unsigned int *s_hist = (unsigned int *)(s_min_bin + n_groups);
+    unsigned int *hist = shared_hist ? s_hist : d_hist;
+
+    // copy over parameters one int per thread for fast loads
+        {
+        unsigned int param_size = num_types*sizeof(typename Shape::param_type) / sizeof(int);
+
+        for (unsigned int cur_offset = 0; cur_offset < param_size; cur_offset += block_size)
+            {
+            if (cur_offset + tidx < param_size)
+                ((int *)s_params)[cur_offset + tidx] = ((int *)d_params)[cur_offset + tidx];
+            }
+
+        if (shared_hist)
+            {
+            for (unsigned int cur_offset = 0; cur_offset < n_bins; cur_offset += block_size)
+                {
+                if (cur_offset + tidx < n_bins)
+                    s_hist[cur_offset + tidx] = 0;
+                }
+            }
+        }
+
+    __syncthreads();
+
+    // initialize extra shared mem
+    char *s_extra = (char *)(s_hist + (shared_hist ? n_bins : 0));
+
+    unsigned int available_bytes = max_extra_bytes;
+    for (unsigned int cur_type = 0; cur_type < num_types; ++cur_type)
+        s_params[cur_type].load_shared(s_extra, available_bytes);
+
+    if (master)
+        s_min_bin[group] = n_bins;
+
+    __syncthreads();
+
+    unsigned int i = blockIdx.x * n_groups + group;
+    if (i < N)
+        {
+        Scalar4 postype_i = texFetchScalar4(d_postype, free_volume_postype_tex, i);
+        Shape shape_i(quat<Scalar>(), s_params[__scalar_as_int(postype_i.w)]);
+        if (shape_i.hasOrientation())
+            shape_i.orientation = quat<Scalar>(texFetchScalar4(d_orientation, free_volume_orientation_tex, i));
+        vec3<Scalar> pos_i(postype_i);
+
+        // find the cell of the particle
+        unsigned int my_cell = compute_cell_idx(vec_to_scalar3(pos_i), box, ghost_width, cell_dim, ci);
+
+        int min_bin = n_bins;
+        unsigned int excell_size = d_excell_size[my_cell];
+        for (unsigned int k = offset; k < excell_size; k += group_size)
+            {
+            #if ( __CUDA_ARCH__ > 300)
+            unsigned int j = __ldg(&d_excell_idx[excli(k, my_cell)]);
+            #else
+            unsigned int j = d_excell_idx[excli(k, my_cell)];
+            #endif
+
+            if (j == i)
+                continue;
+
+            Scalar4 postype_j = texFetchScalar4(d_postype, free_volume_postype_tex, j);
+            Shape shape_j(quat<Scalar>(), s_params[__scalar_as_int(postype_j.w)]);
+            if (shape_j.hasOrientation())
+                shape_j.orientation = quat<Scalar>(texFetchScalar4(d_orientation, free_volume_orientation_tex, j));
+
+            // put particle j into the coordinate system of particle i
+            vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i;
+            r_ij = vec3<Scalar>(box.minImage(vec_to_scalar3(r_ij)));
+
+            int bin = sdf_compute_bin(r_ij, shape_i, shape_j, n_bins, dl);
+            if (bin >= 0)
+                min_bin = min(min_bin, bin);
+            }
+
+        if (min_bin < (int)n_bins)
+            atomicMin(&s_min_bin[group], min_bin);
+        }
+
+    __syncthreads();
+
+    // record the minimum bin of the particle
+    if (master && i < N && s_min_bin[group] < (int)n_bins)
+        atomicAdd(&hist[s_min_bin[group]], 1);
+
+    if (shared_hist)
+        {
+        __syncthreads();
+
+        // final tally into global mem
+        for (unsigned int cur_offset = 0; cur_offset < n_bins; cur_offset += block_size)
+            {
+            if (cur_offset + tidx < n_bins && s_hist[cur_offset + tidx])
+                atomicAdd(&d_hist[cur_offset + tidx], s_hist[cur_offset + tidx]);
+            }
+        }
+    }
+
+//! Kernel driver for gpu_hpmc_sdf_kernel()
+/*! \param args Bundled arguments
+    \param d_params Per-type shape parameters
+    \returns Error codes generated by any CUDA calls, or cudaSuccess when there is no error
+
+    The histogram is counted in shared memory per block when it fits next to the shape parameters, and directly in
+    global memory otherwise. \a args.d_hist is reset before the kernel.
+
+    \ingroup hpmc_kernels
+*/
+template< class Shape >
+cudaError_t gpu_hpmc_sdf(const hpmc_sdf_args_t& args, const typename Shape::param_type *d_params)
+    {
+    assert(args.d_postype);
+    assert(args.d_orientation);
+    assert(args.group_size >= 1);
+    assert(args.group_size <= 32);
+
+    // bind the textures
+    free_volume_postype_tex.normalized = false;
+    free_volume_postype_tex.filterMode = cudaFilterModePoint;
+    cudaError_t error = cudaBindTexture(0, free_volume_postype_tex, args.d_postype, sizeof(Scalar4)*args.max_n);
+    if (error != cudaSuccess)
+        return error;
+
+    free_volume_orientation_tex.normalized = false;
+    free_volume_orientation_tex.filterMode = cudaFilterModePoint;
+    error = cudaBindTexture(0, free_volume_orientation_tex, args.d_orientation, sizeof(Scalar4)*args.max_n);
+    if (error != cudaSuccess)
+        return error;
+
+    // reset the histogram
+    cudaMemsetAsync(args.d_hist, 0, sizeof(unsigned int)*args.n_bins, args.stream);
+
+    if (args.N == 0)
+        return cudaSuccess;
+
+    // determine the maximum block size and clamp the input block size down
+    static int max_block_size = -1;
+    static cudaFuncAttributes attr;
+    if (max_block_size == -1)
+        {
+        cudaFuncGetAttributes(&attr, gpu_hpmc_sdf_kernel<Shape>);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int n_groups = min(args.block_size, (unsigned int)max_block_size) / args.group_size;
+    dim3 threads(args.group_size, n_groups, 1);
+    dim3 grid(args.N / n_groups + 1, 1, 1);
+
+    unsigned int shared_bytes = args.num_types * sizeof(typename Shape::param_type) + n_groups*sizeof(int);
+
+    // count in shared memory if the histogram leaves at least half of the shared memory for the parameters
+    bool shared_hist = (shared_bytes + args.n_bins*sizeof(unsigned int) + attr.sharedSizeBytes)
+                       <= args.devprop.sharedMemPerBlock/2;
+    if (shared_hist)
+        shared_bytes += args.n_bins*sizeof(unsigned int);
+
+    // required for memory coherency
+    cudaDeviceSynchronize();
+
+    unsigned int max_extra_bytes = args.devprop.sharedMemPerBlock - attr.sharedSizeBytes - shared_bytes;
+
+    // attach the parameters to the kernel stream so that they are visible
+    // when other kernels are called
+    cudaStreamAttachMemAsync(args.stream, d_params, 0, cudaMemAttachSingle);
+    for (unsigned int i = 0; i < args.num_types; ++i)
+        {
+        // attach nested memory regions
+        d_params[i].attach_to_stream(args.stream);
+        }
+
+    // determine dynamically requested shared memory
+    char *ptr = (char *)nullptr;
+    unsigned int available_bytes = max_extra_bytes;
+    for (unsigned int i = 0; i < args.num_types; ++i)
+        {
+        d_params[i].load_shared(ptr, available_bytes);
+        }
+    unsigned int extra_bytes = max_extra_bytes - available_bytes;
+
+    shared_bytes += extra_bytes;
+
+    gpu_hpmc_sdf_kernel<Shape><<<grid, threads, shared_bytes, args.stream>>>(args.d_postype,
+                                                                            args.d_orientation,
+                                                                            args.d_excell_idx,
+                                                                            args.d_excell_size,
+                                                                            args.excli,
+                                                                            args.ci,
+                                                                            args.cell_dim,
+                                                                            args.ghost_width,
+                                                                            args.N,
+                                                                            args.num_types,
+                                                                            args.box,
+                                                                            args.n_bins,
+                                                                            args.dl,
+                                                                            args.d_hist,
+                                                                            shared_hist,
+                                                                            d_params,
+                                                                            max_extra_bytes);
+
+    // return control of managed memory
+    cudaDeviceSynchronize();
+
+    return cudaSuccess;
+    }
+
+#endif // NVCC
+
+}; // end namespace detail
+
+} // end namespace hpmc
+
+#endif // _ANALYZER_SDF_GPU_CUH_
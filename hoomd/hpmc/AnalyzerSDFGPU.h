@@ -0,0 +1,287 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _ANALYZER_SDF_GPU_H_
+#define _ANALYZER_SDF_GPU_H_
+
+#ifdef ENABLE_CUDA
+
+#include "hoomd/CellList.h"
+#include "hoomd/Autotuner.h"
+
+#include "AnalyzerSDF.h"
+#include "AnalyzerSDFGPU.cuh"
+#include "IntegratorHPMCMonoGPU.cuh"
+
+/*! \file AnalyzerSDFGPU.h
+    \brief Declaration of AnalyzerSDFGPU
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+namespace hpmc
+{
+
+//! SDF analysis on the GPU
+/*! The particles are found with a cell list and the same expanded cells as the GPU integrators. Every particle is
+    processed by a group of threads that split its neighbors, and each block counts the histogram in shared memory and
+    adds it to the histogram in global memory at the end. The minimum image convention is used instead of the image
+    list, so the box must be at least twice the search radius wide.
+
+    \ingroup hpmc_analyzers
+*/
+template < class Shape >
+class AnalyzerSDFGPU : public AnalyzerSDF<Shape>
+    {
+    public:
+        //! Constructor
+        AnalyzerSDFGPU(std::shared_ptr<SystemDefinition> sysdef,
+                       std::shared_ptr< IntegratorHPMCMono<Shape> > mc,
+                       std::shared_ptr<CellList> cl,
+                       double lmax,
+                       double dl,
+                       unsigned int navg,
+                       const std::string& fname,
+                       bool overwrite);
+
+        //! Destructor
+        virtual ~AnalyzerSDFGPU();
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            m_tuner_sdf->setPeriod(period);
+            m_tuner_sdf->setEnabled(enable);
+
+            m_tuner_excell_block_size->setPeriod(period);
+            m_tuner_excell_block_size->setEnabled(enable);
+            }
+
+    protected:
+        std::shared_ptr<CellList> m_cl;       //!< Cell list
+        uint3 m_last_dim;                     //!< Dimensions of the cell list on the last call
+        unsigned int m_last_nmax;             //!< Last cell list NMax value allocated in excell
+
+        GPUArray<unsigned int> m_excell_idx;  //!< Particle indices in expanded cells
+        GPUArray<unsigned int> m_excell_size; //!< Number of particles in each expanded cell
+        Index2D m_excell_list_indexer;        //!< Indexer to access elements of the excell_idx list
+
+        GPUArray<unsigned int> m_gpu_hist;    //!< Histogram counts of one configuration
+
+        cudaStream_t m_stream;                //!< CUDA stream for kernel execution
+
+        std::unique_ptr<Autotuner> m_tuner_sdf;                //!< Autotuner for the histogram kernel
+        std::unique_ptr<Autotuner> m_tuner_excell_block_size;  //!< Autotuner for excell block_size
+
+        //! Add to histogram counts
+        virtual void countHistogram(unsigned int timestep);
+
+        //! Reallocate the expanded cells
+        void initializeExcellMem();
+    };
+
+/*! \param sysdef System definition
+    \param mc The MC integrator
+    \param cl Cell list
+    \param lmax Right hand side of the last histogram bin
+    \param dl Bin size
+    \param navg Number of samples to average before writing to the file
+    \param fname File name to write to
+    \param overwrite Set to true to overwrite instead of append to the file
+*/
+template < class Shape >
+AnalyzerSDFGPU<Shape>::AnalyzerSDFGPU(std::shared_ptr<SystemDefinition> sysdef,
+                                      std::shared_ptr< IntegratorHPMCMono<Shape> > mc,
+                                      std::shared_ptr<CellList> cl,
+                                      double lmax,
+                                      double dl,
+                                      unsigned int navg,
+                                      const std::string& fname,
+                                      bool overwrite)
+    : AnalyzerSDF<Shape>(sysdef, mc, lmax, dl, navg, fname, overwrite), m_cl(cl)
+    {
+    // the block size and group size are tuned together, encoded as block_size*100 + group_size
+    std::vector<unsigned int> valid_params;
+    for (unsigned int block_size = 32; block_size <= 1024; block_size += 32)
+        {
+        for (auto s : Autotuner::getTppListPow2(this->m_exec_conf->dev_prop.warpSize))
+            valid_params.push_back(block_size*100 + s);
+        }
+    m_tuner_sdf.reset(new Autotuner(valid_params, 5, 100000, "hpmc_sdf", this->m_exec_conf));
+    m_tuner_excell_block_size.reset(new Autotuner(32,1024,32, 5, 100000, "hpmc_sdf_excell_block_size", this->m_exec_conf));
+
+    GPUArray<unsigned int> excell_size(0, this->m_exec_conf);
+    m_excell_size.swap(excell_size);
+
+    GPUArray<unsigned int> excell_idx(0, this->m_exec_conf);
+    m_excell_idx.swap(excell_idx);
+
+    GPUArray<unsigned int> gpu_hist(this->m_hist.size(), this->m_exec_conf);
+    m_gpu_hist.swap(gpu_hist);
+
+    // set last dim to a bogus value so that it will re-init on the first call
+    m_last_dim = make_uint3(0xffffffff, 0xffffffff, 0xffffffff);
+    m_last_nmax = 0xffffffff;
+
+    // create a cuda stream to ensure managed memory coherency
+    cudaStreamCreate(&m_stream);
+    CHECK_CUDA_ERROR();
+    }
+
+template < class Shape >
+AnalyzerSDFGPU<Shape>::~AnalyzerSDFGPU()
+    {
+    cudaStreamDestroy(m_stream);
+    CHECK_CUDA_ERROR();
+    }
+
+/*! \param timestep current timestep
+
+    Counts the histogram of the current configuration on the GPU and adds it to the host histogram.
+*/
+template < class Shape >
+void AnalyzerSDFGPU<Shape>::countHistogram(unsigned int timestep)
+    {
+    // pairs can touch within the scaled diameter
+    Scalar nominal_width = this->m_mc->getMaxCoreDiameter() / (Scalar(1.0) - Scalar(this->m_lmax));
+    if (m_cl->getNominalWidth() != nominal_width)
+        m_cl->setNominalWidth(nominal_width);
+
+    const BoxDim& box = this->m_pdata->getBox();
+    Scalar3 npd = box.getNearestPlaneDistance();
+
+    if ((box.getPeriodic().x && npd.x <= nominal_width*2) ||
+        (box.getPeriodic().y && npd.y <= nominal_width*2) ||
+        (this->m_sysdef->getNDimensions() == 3 && box.getPeriodic().z && npd.z <= nominal_width*2))
+        {
+        this->m_exec_conf->msg->error() << "analyze.sdf: Simulation box too small for the GPU - increase it so the minimum image convention works" << std::endl;
+        throw std::runtime_error("Error computing SDF");
+        }
+
+    // compute cell list
+    m_cl->compute(timestep);
+
+    // if the cell list is a different size than last time, reinitialize expanded cell list
+    uint3 cur_dim = m_cl->getDim();
+    if (m_last_dim.x != cur_dim.x || m_last_dim.y != cur_dim.y || m_last_dim.z != cur_dim.z ||
+        m_last_nmax != m_cl->getNmax())
+        {
+        initializeExcellMem();
+        m_last_dim = cur_dim;
+        m_last_nmax = m_cl->getNmax();
+        }
+
+        {
+        // access the cell list data
+        ArrayHandle<unsigned int> d_cell_size(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_idx(m_cl->getIndexArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_adj(m_cl->getCellAdjArray(), access_location::device, access_mode::read);
+
+        ArrayHandle< unsigned int > d_excell_idx(m_excell_idx, access_location::device, access_mode::overwrite);
+        ArrayHandle< unsigned int > d_excell_size(m_excell_size, access_location::device, access_mode::overwrite);
+
+        // update the expanded cells
+        m_tuner_excell_block_size->begin();
+        detail::gpu_hpmc_excell(d_excell_idx.data,
+                                d_excell_size.data,
+                                m_excell_list_indexer,
+                                d_cell_idx.data,
+                                d_cell_size.data,
+                                d_cell_adj.data,
+                                m_cl->getCellIndexer(),
+                                m_cl->getCellListIndexer(),
+                                m_cl->getCellAdjIndexer(),
+                                m_tuner_excell_block_size->getParam());
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_tuner_excell_block_size->end();
+        }
+
+        {
+        ArrayHandle<Scalar4> d_postype(this->m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_orientation(this->m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+        ArrayHandle< unsigned int > d_excell_idx(m_excell_idx, access_location::device, access_mode::read);
+        ArrayHandle< unsigned int > d_excell_size(m_excell_size, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_hist(m_gpu_hist, access_location::device, access_mode::overwrite);
+
+        const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> > & params = this->m_mc->getParams();
+
+        m_tuner_sdf->begin();
+        unsigned int param = m_tuner_sdf->getParam();
+        unsigned int block_size = param / 100;
+        unsigned int group_size = param % 100;
+
+        detail::hpmc_sdf_args_t sdf_args(d_postype.data,
+                                         d_orientation.data,
+                                         d_excell_idx.data,
+                                         d_excell_size.data,
+                                         m_excell_list_indexer,
+                                         m_cl->getCellIndexer(),
+                                         m_cl->getDim(),
+                                         m_cl->getGhostWidth(),
+                                         this->m_pdata->getN(),
+                                         this->m_pdata->getNTypes(),
+                                         box,
+                                         this->m_hist.size(),
+                                         this->m_dl,
+                                         d_hist.data,
+                                         block_size,
+                                         group_size,
+                                         this->m_pdata->getMaxN(),
+                                         m_stream,
+                                         this->m_exec_conf->dev_prop);
+
+        detail::gpu_hpmc_sdf<Shape>(sdf_args, params.data());
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_tuner_sdf->end();
+        }
+
+    // add the counts of this configuration to the average
+    ArrayHandle<unsigned int> h_hist(m_gpu_hist, access_location::host, access_mode::read);
+    for (unsigned int k = 0; k < this->m_hist.size(); k++)
+        this->m_hist[k] += h_hist.data[k];
+    }
+
+template < class Shape >
+void AnalyzerSDFGPU<Shape>::initializeExcellMem()
+    {
+    this->m_exec_conf->msg->notice(4) << "analyze.sdf: resizing expanded cells" << std::endl;
+
+    // get the current cell dimensions
+    unsigned int num_cells = m_cl->getCellIndexer().getNumElements();
+    unsigned int num_adj = m_cl->getCellAdjIndexer().getW();
+    unsigned int num_max = m_cl->getNmax();
+
+    // make the excell dimensions the same, but with room for Nmax*Nadj in each cell
+    m_excell_list_indexer = Index2D(num_max * num_adj, num_cells);
+
+    // reallocate memory
+    m_excell_idx.resize(m_excell_list_indexer.getNumElements());
+    m_excell_size.resize(num_cells);
+    }
+
+//! Export the AnalyzerSDFGPU class to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of AnalyzerSDFGPU<Shape> will be exported
+*/
+template < class Shape > void export_AnalyzerSDFGPU(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_< AnalyzerSDFGPU<Shape>, std::shared_ptr< AnalyzerSDFGPU<Shape> > >(m, name.c_str(), pybind11::base< AnalyzerSDF<Shape> >())
+          .def(pybind11::init< std::shared_ptr<SystemDefinition>, std::shared_ptr< IntegratorHPMCMono<Shape> >, std::shared_ptr<CellList>, double, double, unsigned int, const std::string&, bool>())
+          ;
+    }
+
+} // end namespace hpmc
+
+#endif // ENABLE_CUDA
+
+#endif // _ANALYZER_SDF_GPU_H_
@@ -69,6 +69,17 @@ class ExternalFieldMono : public ExternalField
         //! method to calculate the energy difference for the proposed move.
         virtual double energydiff(const unsigned int& index, const vec3<Scalar>& position_old, const Shape& shape_old, const vec3<Scalar>& position_new, const Shape& shape_new){return 0;}
 
+        //! Prepare for the energydiff() calls of the trial moves in one update
+        /*! Fields may acquire the arrays they read once here instead of in every energydiff() call. The particle data
+            arrays other than the positions and orientations must not be accessed by the integrator until endMoves().
+
+            \returns true if energydiff() may be called concurrently from multiple threads until endMoves()
+        */
+        virtual bool beginMoves() { return false; }
+
+        //! Release the resources acquired in beginMoves()
+        virtual void endMoves() {}
+
         virtual void reset(unsigned int timestep) {}
     };
 
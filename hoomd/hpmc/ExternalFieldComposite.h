@@ -51,8 +51,32 @@ class ExternalFieldMonoComposite : public ExternalFieldMono<Shape>
             return Energy;
             }
 
+        //! Prepare all fields for the trial moves
+        /*! \returns true if energydiff() of every field may be called concurrently
+        */
+        bool beginMoves()
+            {
+            bool concurrent = true;
+            for(size_t i = 0; i < m_externals.size(); i++)
+                {
+                concurrent = m_externals[i]->beginMoves() && concurrent;
+                }
+            return concurrent;
+            }
+
+        void endMoves()
+            {
+            for(size_t i = 0; i < m_externals.size(); i++)
+                {
+                m_externals[i]->endMoves();
+                }
+            }
+
         void addExternal(std::shared_ptr< ExternalFieldMono<Shape> > ext) { m_externals.push_back(ext); }
 
+        //! Get the fields in the composite
+        const std::vector< std::shared_ptr< ExternalFieldMono<Shape> > >& getExternals() const { return m_externals; }
+
         void reset(unsigned int timestep)
         {
             for(size_t i = 0; i < m_externals.size(); i++)
@@ -152,8 +152,13 @@ class LatticeReferenceList
 #define LATTICE_ROTAT_SPRING_CONSTANT_LOG_NAME  "lattice_rotational_spring_constant"
 #define LATTICE_NUM_SAMPLES_LOG_NAME            "lattice_num_samples"
 
+//! Harmonic restraint of the particles to reference positions and orientations
+/*! The class is final, so that IntegratorHPMCMono calls energydiff() without virtual dispatch. During the trial moves
+    of an update, the tags and reference arrays are acquired once in beginMoves(), and the same arrays are read by the
+    GPU integrator.
+*/
 template< class Shape>
-class ExternalFieldLattice : public ExternalFieldMono<Shape>
+class ExternalFieldLattice final : public ExternalFieldMono<Shape>
     {
     using ExternalFieldMono<Shape>::m_pdata;
     using ExternalFieldMono<Shape>::m_exec_conf;
@@ -193,6 +198,16 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
                 {
                 m_symmetry.push_back(identity);
                 }
+
+            // copy of the symmetry rotations for the GPU
+            GPUArray<Scalar4> symmetry_array(m_symmetry.size(), m_exec_conf);
+            m_symmetry_array.swap(symmetry_array);
+                {
+                ArrayHandle<Scalar4> h_symmetry(m_symmetry_array, access_location::host, access_mode::overwrite);
+                for (size_t i = 0; i < m_symmetry.size(); i++)
+                    h_symmetry.data[i] = quat_to_scalar4(m_symmetry[i]);
+                }
+
             reset(0); // initializes all of the energy logging parameters.
             }
 
@@ -291,6 +306,27 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
             return new_U - old_U;
             }
 
+        //! Acquire the tags and the reference arrays for the trial moves of an update
+        bool beginMoves()
+            {
+            m_h_tags.reset(new ArrayHandle<unsigned int>(m_pdata->getTags(), access_location::host, access_mode::read));
+            if (m_latticePositions.isValid())
+                m_h_r0.reset(new ArrayHandle<Scalar3>(m_latticePositions.getReferenceArray(), access_location::host, access_mode::read));
+            if (m_latticeOrientations.isValid())
+                m_h_q0.reset(new ArrayHandle<Scalar4>(m_latticeOrientations.getReferenceArray(), access_location::host, access_mode::read));
+
+            // energydiff() only reads from the arrays
+            return true;
+            }
+
+        //! Release the arrays acquired in beginMoves()
+        void endMoves()
+            {
+            m_h_tags.reset();
+            m_h_r0.reset();
+            m_h_q0.reset();
+            }
+
         void setReferences(const pybind11::list& r0, const pybind11::list& q0)
             {
             unsigned int ndim = m_sysdef->getNDimensions();
@@ -462,6 +498,36 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
             return m_latticeOrientations.getReferenceArray();
             }
 
+        //! Test whether reference positions are set
+        bool hasReferencePositions()
+            {
+            return m_latticePositions.isValid();
+            }
+
+        //! Test whether reference orientations are set
+        bool hasReferenceOrientations()
+            {
+            return m_latticeOrientations.isValid();
+            }
+
+        //! Get the translational spring constant
+        Scalar getK() const
+            {
+            return m_k;
+            }
+
+        //! Get the rotational spring constant
+        Scalar getQ() const
+            {
+            return m_q;
+            }
+
+        //! Get the rotations in the symmetry group of the shape
+        const GPUArray< Scalar4 >& getSymmetryArray() const
+            {
+            return m_symmetry_array;
+            }
+
         void reset( unsigned int ) // TODO: remove the timestep
             {
             m_EnergySum = m_EnergySum_y = m_EnergySum_t = m_EnergySum_c = Scalar(0.0);
@@ -497,15 +563,19 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
         // These could be a little redundant. think about this more later.
         Scalar calcE_trans(const unsigned int& index, const vec3<Scalar>& position, const Scalar& scale = 1.0)
             {
-            ArrayHandle<unsigned int> h_tags(m_pdata->getTags(), access_location::host, access_mode::read);
-            int3 dummy = make_int3(0,0,0);
             vec3<Scalar> origin(m_pdata->getOrigin());
             const BoxDim& box = this->m_pdata->getGlobalBox();
-            vec3<Scalar> r0(m_latticePositions.getReference(h_tags.data[index]));
+            vec3<Scalar> r0;
+            if (m_h_r0)
+                {
+                r0 = vec3<Scalar>(m_h_r0->data[m_h_tags->data[index]]);
+                }
+            else
+                {
+                ArrayHandle<unsigned int> h_tags(m_pdata->getTags(), access_location::host, access_mode::read);
+                r0 = vec3<Scalar>(m_latticePositions.getReference(h_tags.data[index]));
+                }
             r0 *= scale;
-            Scalar3 t = vec_to_scalar3(position - origin);
-            box.wrap(t, dummy);
-            vec3<Scalar> shifted_pos(t);
             vec3<Scalar> dr = vec3<Scalar>(box.minImage(vec_to_scalar3(r0 - position + origin)));
             return m_k*dot(dr,dr);
             }
@@ -513,8 +583,16 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
         Scalar calcE_rot(const unsigned int& index, const quat<Scalar>& orientation)
             {
             assert(m_symmetry.size());
-            ArrayHandle<unsigned int> h_tags(m_pdata->getTags(), access_location::host, access_mode::read);
-            quat<Scalar> q0(m_latticeOrientations.getReference(h_tags.data[index]));
+            quat<Scalar> q0;
+            if (m_h_q0)
+                {
+                q0 = quat<Scalar>(m_h_q0->data[m_h_tags->data[index]]);
+                }
+            else
+                {
+                ArrayHandle<unsigned int> h_tags(m_pdata->getTags(), access_location::host, access_mode::read);
+                q0 = quat<Scalar>(m_latticeOrientations.getReference(h_tags.data[index]));
+                }
             Scalar dqmin = 0.0;
             for(size_t i = 0; i < m_symmetry.size(); i++)
                 {
@@ -556,6 +634,11 @@ class ExternalFieldLattice : public ExternalFieldMono<Shape>
         Scalar                          m_q;                        // spring constant
 
         std::vector< quat<Scalar> >     m_symmetry;       // quaternions in the symmetry group of the shape.
+        GPUArray< Scalar4 >             m_symmetry_array; // copy of m_symmetry for the GPU
+
+        std::unique_ptr< ArrayHandle<unsigned int> > m_h_tags;  // tags, acquired between beginMoves() and endMoves()
+        std::unique_ptr< ArrayHandle<Scalar3> > m_h_r0;         // reference positions, acquired in beginMoves()
+        std::unique_ptr< ArrayHandle<Scalar4> > m_h_q0;         // reference orientations, acquired in beginMoves()
 
         Scalar                          m_Energy;                   // Store the total energy of the last computed timestep
 
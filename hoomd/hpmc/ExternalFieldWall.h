@@ -465,6 +465,15 @@ class ExternalFieldWall : public ExternalFieldMono<Shape>
             return double(0.0);
             }
 
+        //! Test whether energydiff() may be called concurrently
+        /*! The vertices of the cylinder walls are set for every particle shape tested, so only walls without cylinders
+            can be tested from multiple threads.
+        */
+        bool beginMoves()
+            {
+            return m_Cylinders.empty();
+            }
+
         Scalar calculateBoltzmannWeight(unsigned int timestep)
             {
             unsigned int numOverlaps = countOverlaps(timestep, false);
@@ -27,7 +27,13 @@ namespace hpmc
 namespace detail
 {
 
+//! Bit of the packed ancestor count that flags spherical nodes
+const unsigned int GPU_TREE_SPHERE_FLAG = 0x80000000;
+
 //! Adapter class to AABTree for query on the GPU
+/*! The nodes are stored as structure of arrays, so that the arrays can be staged in shared memory one by one. To
+    keep the nodes small, the sphere flag of each OBB is packed into the high bit of its ancestor count.
+*/
 class GPUTree
     {
     public:
@@ -50,7 +56,6 @@ class GPUTree
             m_lengths = ManagedArray<vec3<OverlapReal> >(m_num_nodes,managed);
             m_rotation = ManagedArray<quat<OverlapReal> >(m_num_nodes,managed);
             m_mask = ManagedArray<unsigned int>(m_num_nodes,managed);
-            m_is_sphere = ManagedArray<unsigned int>(m_num_nodes,managed);
             m_left = ManagedArray<unsigned int>(m_num_nodes, managed);
             m_escape = ManagedArray<unsigned int>(m_num_nodes, managed);
             m_ancestors = ManagedArray<unsigned int>(m_num_nodes, managed);
@@ -69,7 +74,7 @@ class GPUTree
                 m_rotation[i] = tree.getNodeOBB(i).rotation;
                 m_lengths[i] = tree.getNodeOBB(i).lengths;
                 m_mask[i] = tree.getNodeOBB(i).mask;
-                m_is_sphere[i] = tree.getNodeOBB(i).isSphere();
+                m_ancestors[i] = tree.getNodeOBB(i).isSphere() ? GPU_TREE_SPHERE_FLAG : 0;
 
                 m_leaf_ptr[i] = n;
                 n += tree.getNodeNumParticles(i);
@@ -106,6 +111,73 @@ class GPUTree
             // recursively initialize ancestor indices
             initializeAncestorCounts(0, tree, 0);
             }
+
+        //! Constructor from the node data of a tree
+        /*! \param obbs OBB of every node
+         *  \param left Left child of every node
+         *  \param escape Escape index of every node
+         *  \param ancestors Number of right-most ancestors of every node
+         *  \param leaf_ptr Offset of the particles of every node in \a particles, with the total count appended
+         *  \param particles Particle indices of the leaf nodes
+         *  \param leaf_capacity Capacity of OBB leaf nodes
+         *  \param managed True if we use CUDA managed memory
+         *
+         *  This restores a tree from the data returned by the accessor methods, without building it again.
+         */
+        GPUTree(const std::vector<OBB>& obbs,
+                const std::vector<unsigned int>& left,
+                const std::vector<unsigned int>& escape,
+                const std::vector<unsigned int>& ancestors,
+                const std::vector<unsigned int>& leaf_ptr,
+                const std::vector<unsigned int>& particles,
+                unsigned int leaf_capacity,
+                bool managed=false)
+            {
+            m_num_nodes = obbs.size();
+
+            m_center = ManagedArray<vec3<OverlapReal> >(m_num_nodes, managed);
+            m_lengths = ManagedArray<vec3<OverlapReal> >(m_num_nodes,managed);
+            m_rotation = ManagedArray<quat<OverlapReal> >(m_num_nodes,managed);
+            m_mask = ManagedArray<unsigned int>(m_num_nodes,managed);
+            m_left = ManagedArray<unsigned int>(m_num_nodes, managed);
+            m_escape = ManagedArray<unsigned int>(m_num_nodes, managed);
+            m_ancestors = ManagedArray<unsigned int>(m_num_nodes, managed);
+            m_leaf_ptr = ManagedArray<unsigned int>(m_num_nodes+1, managed);
+
+            m_num_leaves = 0;
+            for (unsigned int i = 0; i < m_num_nodes; ++i)
+                {
+                m_center[i] = obbs[i].getPosition();
+                m_rotation[i] = obbs[i].rotation;
+                m_lengths[i] = obbs[i].lengths;
+                m_mask[i] = obbs[i].mask;
+                m_left[i] = left[i];
+                m_escape[i] = escape[i];
+                m_ancestors[i] = ancestors[i] | (obbs[i].isSphere() ? GPU_TREE_SPHERE_FLAG : 0);
+                m_leaf_ptr[i] = leaf_ptr[i];
+
+                if (m_left[i] == OBB_INVALID_NODE)
+                    {
+                    m_num_leaves++;
+                    }
+                }
+            m_leaf_ptr[m_num_nodes] = leaf_ptr[m_num_nodes];
+
+            m_leaf_obb_ptr = ManagedArray<unsigned int>(m_num_leaves, managed);
+            m_num_leaves = 0;
+            for (unsigned int i = 0; i < m_num_nodes; ++i)
+                {
+                if (m_left[i] == OBB_INVALID_NODE)
+                    {
+                    m_leaf_obb_ptr[m_num_leaves++] = i;
+                    }
+                }
+
+            m_particles = ManagedArray<unsigned int>(particles.size(), managed);
+            std::copy(particles.begin(), particles.end(), m_particles.get());
+
+            m_leaf_capacity = leaf_capacity;
+            }
         #endif
 
         //! Returns number of nodes in tree
@@ -127,7 +199,8 @@ class GPUTree
                 initializeAncestorCounts(right_idx, tree, ancestors+1);
                 }
 
-            m_ancestors[idx] = ancestors;
+            // keep the sphere flag
+            m_ancestors[idx] = (m_ancestors[idx] & GPU_TREE_SPHERE_FLAG) | ancestors;
             }
         #endif
 
@@ -244,7 +317,7 @@ class GPUTree
 
         DEVICE inline unsigned int getNumAncestors(unsigned int node) const
             {
-            return m_ancestors[node];
+            return m_ancestors[node] & ~GPU_TREE_SPHERE_FLAG;
             }
 
         DEVICE inline OBB getOBB(unsigned int idx) const
@@ -254,7 +327,7 @@ class GPUTree
             obb.lengths = m_lengths[idx];
             obb.rotation = m_rotation[idx];
             obb.mask = m_mask[idx];
-            obb.is_sphere = m_is_sphere[idx];
+            obb.is_sphere = (m_ancestors[idx] & GPU_TREE_SPHERE_FLAG) ? 1 : 0;
             return obb;
             }
 
@@ -267,7 +340,6 @@ class GPUTree
             m_lengths.attach_to_stream(stream);
             m_rotation.attach_to_stream(stream);
             m_mask.attach_to_stream(stream);
-            m_is_sphere.attach_to_stream(stream);
 
             m_left.attach_to_stream(stream);
             m_escape.attach_to_stream(stream);
@@ -289,7 +361,6 @@ class GPUTree
             m_lengths.load_shared(ptr, available_bytes);
             m_rotation.load_shared(ptr, available_bytes);
             m_mask.load_shared(ptr, available_bytes);
-            m_is_sphere.load_shared(ptr, available_bytes);
 
             m_left.load_shared(ptr, available_bytes);
             m_escape.load_shared(ptr, available_bytes);
@@ -311,7 +382,6 @@ class GPUTree
         ManagedArray<vec3<OverlapReal> > m_lengths;
         ManagedArray<quat<OverlapReal> > m_rotation;
         ManagedArray<unsigned int> m_mask;
-        ManagedArray<unsigned int> m_is_sphere;
 
         ManagedArray<unsigned int> m_leaf_ptr; //!< Pointer to leaf node contents
         ManagedArray<unsigned int> m_leaf_obb_ptr; //!< Pointer to leaf node OBBs
@@ -319,7 +389,7 @@ class GPUTree
 
         ManagedArray<unsigned int> m_left;    //!< Left nodes
         ManagedArray<unsigned int> m_escape;  //!< Escape indices
-        ManagedArray<unsigned int> m_ancestors;  //!< Number of right-most ancestors
+        ManagedArray<unsigned int> m_ancestors;  //!< Number of right-most ancestors, and the sphere flag
 
         unsigned int m_num_nodes;             //!< Number of nodes in the tree
         unsigned int m_num_leaves;            //!< Number of leaf nodes
@@ -394,4 +394,278 @@ struct gsd_shape_schema< hpmc::detail::poly2d_verts >: public gsd_schema_hpmc_ba
         }
     };
 
+template<>
+struct gsd_shape_schema< hpmc::detail::poly3d_data >: public gsd_schema_hpmc_base
+    {
+    gsd_shape_schema(const std::shared_ptr<const ExecutionConfiguration> exec_conf, bool mpi) : gsd_schema_hpmc_base(exec_conf, mpi) {}
+
+    //! Write the polyhedra together with their convex hulls and OBB trees
+    /*! The geometry is stored in double precision so that a restored tree bounds the restored faces exactly, and
+        restoring the state does not need to build the tree again.
+    */
+    int write(gsd_handle& handle, const std::string& name, unsigned int Ntypes, const param_array<hpmc::detail::poly3d_data>& shape)
+        {
+        if(!m_exec_conf->isRoot())
+            return 0;
+
+        std::vector<uint32_t> N(Ntypes), face_N(Ntypes), hull_N(Ntypes), tree_N(Ntypes), leaf_capacity(Ntypes), hull_only(Ntypes);
+        std::vector<double> sweep_radius(Ntypes), origin(3*Ntypes);
+        std::vector<double> vertices, hull_vertices, tree_center, tree_lengths, tree_rotation;
+        std::vector<uint32_t> face_offs, face_verts, face_overlap, tree_node, tree_particles;
+
+        for (unsigned int i = 0; i < Ntypes; i++)
+            {
+            const hpmc::detail::poly3d_data& s = shape[i];
+            N[i] = s.n_verts;
+            face_N[i] = s.n_faces;
+            hull_N[i] = s.convex_hull_verts.N;
+            tree_N[i] = s.tree.getNumNodes();
+            leaf_capacity[i] = s.tree.getLeafNodeCapacity();
+            hull_only[i] = s.hull_only;
+            sweep_radius[i] = s.sweep_radius;
+            origin[3*i+0] = s.origin.x;
+            origin[3*i+1] = s.origin.y;
+            origin[3*i+2] = s.origin.z;
+
+            for (unsigned int v = 0; v < s.n_verts; v++)
+                {
+                vertices.push_back(s.verts[v].x);
+                vertices.push_back(s.verts[v].y);
+                vertices.push_back(s.verts[v].z);
+                }
+            for (unsigned int f = 0; f <= s.n_faces; f++)
+                face_offs.push_back(s.face_offs[f]);
+            for (unsigned int j = 0; j < s.face_offs[s.n_faces]; j++)
+                face_verts.push_back(s.face_verts[j]);
+            for (unsigned int f = 0; f < s.n_faces; f++)
+                face_overlap.push_back(s.face_overlap[f]);
+            for (unsigned int v = 0; v < s.convex_hull_verts.N; v++)
+                {
+                hull_vertices.push_back(s.convex_hull_verts.x[v]);
+                hull_vertices.push_back(s.convex_hull_verts.y[v]);
+                hull_vertices.push_back(s.convex_hull_verts.z[v]);
+                }
+
+            // per node: center, lengths, rotation and mask, left child, escape index, ancestors, sphere flag and
+            // number of particles
+            for (unsigned int n = 0; n < s.tree.getNumNodes(); n++)
+                {
+                hpmc::detail::OBB obb = s.tree.getOBB(n);
+                vec3<OverlapReal> c = obb.getPosition();
+                tree_center.push_back(c.x);
+                tree_center.push_back(c.y);
+                tree_center.push_back(c.z);
+                tree_lengths.push_back(obb.lengths.x);
+                tree_lengths.push_back(obb.lengths.y);
+                tree_lengths.push_back(obb.lengths.z);
+                tree_rotation.push_back(obb.rotation.s);
+                tree_rotation.push_back(obb.rotation.v.x);
+                tree_rotation.push_back(obb.rotation.v.y);
+                tree_rotation.push_back(obb.rotation.v.z);
+
+                tree_node.push_back(obb.mask);
+                tree_node.push_back(s.tree.getLeftChild(n));
+                tree_node.push_back(s.tree.getEscapeIndex(n));
+                tree_node.push_back(s.tree.getNumAncestors(n));
+                tree_node.push_back(obb.isSphere() ? 1 : 0);
+                tree_node.push_back(s.tree.getNumParticles(n));
+                for (int j = 0; j < s.tree.getNumParticles(n); j++)
+                    tree_particles.push_back(s.tree.getParticle(n, j));
+                }
+            }
+
+        int retval = 0;
+        retval |= writeArray(handle, name + "N", GSD_TYPE_UINT32, N, 1);
+        retval |= writeArray(handle, name + "vertices", GSD_TYPE_DOUBLE, vertices, 3);
+        retval |= writeArray(handle, name + "sweep_radius", GSD_TYPE_DOUBLE, sweep_radius, 1);
+        retval |= writeArray(handle, name + "origin", GSD_TYPE_DOUBLE, origin, 3);
+        retval |= writeArray(handle, name + "hull_only", GSD_TYPE_UINT32, hull_only, 1);
+        retval |= writeArray(handle, name + "face_N", GSD_TYPE_UINT32, face_N, 1);
+        retval |= writeArray(handle, name + "face_offs", GSD_TYPE_UINT32, face_offs, 1);
+        retval |= writeArray(handle, name + "face_verts", GSD_TYPE_UINT32, face_verts, 1);
+        retval |= writeArray(handle, name + "face_overlap", GSD_TYPE_UINT32, face_overlap, 1);
+        retval |= writeArray(handle, name + "hull_N", GSD_TYPE_UINT32, hull_N, 1);
+        retval |= writeArray(handle, name + "hull_vertices", GSD_TYPE_DOUBLE, hull_vertices, 3);
+        retval |= writeArray(handle, name + "tree_N", GSD_TYPE_UINT32, tree_N, 1);
+        retval |= writeArray(handle, name + "tree_leaf_capacity", GSD_TYPE_UINT32, leaf_capacity, 1);
+        retval |= writeArray(handle, name + "tree_center", GSD_TYPE_DOUBLE, tree_center, 3);
+        retval |= writeArray(handle, name + "tree_lengths", GSD_TYPE_DOUBLE, tree_lengths, 3);
+        retval |= writeArray(handle, name + "tree_rotation", GSD_TYPE_DOUBLE, tree_rotation, 4);
+        retval |= writeArray(handle, name + "tree_node", GSD_TYPE_UINT32, tree_node, 6);
+        retval |= writeArray(handle, name + "tree_particles", GSD_TYPE_UINT32, tree_particles, 1);
+        return retval;
+        }
+
+    bool read(  std::shared_ptr<GSDReader> reader,
+                uint64_t frame,
+                const std::string& name,
+                unsigned int Ntypes,
+                param_array<hpmc::detail::poly3d_data>& shape
+            )
+        {
+        bool success = true;
+        std::vector<uint32_t> N, face_N, hull_N, tree_N, leaf_capacity, hull_only;
+        std::vector<double> sweep_radius, origin;
+        std::vector<double> vertices, hull_vertices, tree_center, tree_lengths, tree_rotation;
+        std::vector<uint32_t> face_offs, face_verts, face_overlap, tree_node, tree_particles;
+        assert(shape.size() == Ntypes);
+        if(m_exec_conf->isRoot())
+            {
+            success = readArray(reader, frame, name + "N", N, Ntypes, 1) && success;
+            success = readArray(reader, frame, name + "sweep_radius", sweep_radius, Ntypes, 1) && success;
+            success = readArray(reader, frame, name + "origin", origin, Ntypes, 3) && success;
+            success = readArray(reader, frame, name + "hull_only", hull_only, Ntypes, 1) && success;
+            success = readArray(reader, frame, name + "face_N", face_N, Ntypes, 1) && success;
+            success = readArray(reader, frame, name + "hull_N", hull_N, Ntypes, 1) && success;
+            success = readArray(reader, frame, name + "tree_N", tree_N, Ntypes, 1) && success;
+            success = readArray(reader, frame, name + "tree_leaf_capacity", leaf_capacity, Ntypes, 1) && success;
+
+            if (success)
+                {
+                uint32_t n_verts = std::accumulate(N.begin(), N.end(), 0);
+                uint32_t n_faces = std::accumulate(face_N.begin(), face_N.end(), 0);
+                uint32_t n_hull_verts = std::accumulate(hull_N.begin(), hull_N.end(), 0);
+                uint32_t n_nodes = std::accumulate(tree_N.begin(), tree_N.end(), 0);
+                success = readArray(reader, frame, name + "vertices", vertices, n_verts, 3) && success;
+                success = readArray(reader, frame, name + "face_offs", face_offs, n_faces + Ntypes, 1) && success;
+                success = readArray(reader, frame, name + "face_overlap", face_overlap, n_faces, 1) && success;
+                success = readArray(reader, frame, name + "hull_vertices", hull_vertices, n_hull_verts, 3) && success;
+                success = readArray(reader, frame, name + "tree_center", tree_center, n_nodes, 3) && success;
+                success = readArray(reader, frame, name + "tree_lengths", tree_lengths, n_nodes, 3) && success;
+                success = readArray(reader, frame, name + "tree_rotation", tree_rotation, n_nodes, 4) && success;
+                success = readArray(reader, frame, name + "tree_node", tree_node, n_nodes, 6) && success;
+                }
+
+            if (success)
+                {
+                // the number of face vertices and leaf particles follows from the offsets and node data
+                uint32_t n_face_verts = 0, n_particles = 0;
+                unsigned int offs = 0;
+                for (unsigned int i = 0; i < Ntypes; i++)
+                    {
+                    n_face_verts += face_offs[offs + face_N[i]];
+                    offs += face_N[i] + 1;
+                    }
+                for (unsigned int n = 0; n < tree_node.size()/6; n++)
+                    n_particles += tree_node[6*n+5];
+                success = readArray(reader, frame, name + "face_verts", face_verts, n_face_verts, 1) && success;
+                success = readArray(reader, frame, name + "tree_particles", tree_particles, n_particles, 1) && success;
+                }
+            }
+    #ifdef ENABLE_MPI
+        if(m_mpi)
+            {
+            bcast(success, 0, m_exec_conf->getMPICommunicator()); // broadcast the data
+            bcast(N, 0, m_exec_conf->getMPICommunicator());
+            bcast(face_N, 0, m_exec_conf->getMPICommunicator());
+            bcast(hull_N, 0, m_exec_conf->getMPICommunicator());
+            bcast(tree_N, 0, m_exec_conf->getMPICommunicator());
+            bcast(leaf_capacity, 0, m_exec_conf->getMPICommunicator());
+            bcast(hull_only, 0, m_exec_conf->getMPICommunicator());
+            bcast(sweep_radius, 0, m_exec_conf->getMPICommunicator());
+            bcast(origin, 0, m_exec_conf->getMPICommunicator());
+            bcast(vertices, 0, m_exec_conf->getMPICommunicator());
+            bcast(hull_vertices, 0, m_exec_conf->getMPICommunicator());
+            bcast(tree_center, 0, m_exec_conf->getMPICommunicator());
+            bcast(tree_lengths, 0, m_exec_conf->getMPICommunicator());
+            bcast(tree_rotation, 0, m_exec_conf->getMPICommunicator());
+            bcast(face_offs, 0, m_exec_conf->getMPICommunicator());
+            bcast(face_verts, 0, m_exec_conf->getMPICommunicator());
+            bcast(face_overlap, 0, m_exec_conf->getMPICommunicator());
+            bcast(tree_node, 0, m_exec_conf->getMPICommunicator());
+            bcast(tree_particles, 0, m_exec_conf->getMPICommunicator());
+            }
+    #endif
+        if(!success || !N.size() || !vertices.size() || !tree_node.size())
+            throw std::runtime_error("Error occurred while attempting to restore from gsd file.");
+
+        const bool managed = m_exec_conf->isCUDAEnabled();
+        unsigned int vert_offs = 0, face_offs_offs = 0, face_verts_offs = 0, face_offs_count = 0, hull_offs = 0;
+        unsigned int node_offs = 0, particle_offs = 0;
+        for (unsigned int i = 0; i < Ntypes; i++)
+            {
+            const unsigned int n_face_verts = face_offs[face_offs_offs + face_N[i]];
+            hpmc::detail::poly3d_data result(N[i], face_N[i], n_face_verts, hull_N[i], managed);
+            result.sweep_radius = result.convex_hull_verts.sweep_radius = sweep_radius[i];
+            result.origin = vec3<OverlapReal>(origin[3*i+0], origin[3*i+1], origin[3*i+2]);
+            result.hull_only = hull_only[i];
+
+            OverlapReal radius_sq = OverlapReal(0.0);
+            for (unsigned int v = 0; v < N[i]; v++)
+                {
+                vec3<OverlapReal> vert(vertices[3*(vert_offs+v)+0], vertices[3*(vert_offs+v)+1], vertices[3*(vert_offs+v)+2]);
+                result.verts[v] = vert;
+                radius_sq = std::max(radius_sq, dot(vert, vert));
+                }
+            vert_offs += N[i];
+
+            for (unsigned int f = 0; f <= face_N[i]; f++)
+                result.face_offs[f] = face_offs[face_offs_offs + f];
+            for (unsigned int f = 0; f < face_N[i]; f++)
+                result.face_overlap[f] = face_overlap[face_offs_count + f];
+            for (unsigned int j = 0; j < n_face_verts; j++)
+                result.face_verts[j] = face_verts[face_verts_offs + j];
+            face_offs_offs += face_N[i] + 1;
+            face_offs_count += face_N[i];
+            face_verts_offs += n_face_verts;
+
+            for (unsigned int v = 0; v < hull_N[i]; v++)
+                {
+                result.convex_hull_verts.x[v] = hull_vertices[3*(hull_offs+v)+0];
+                result.convex_hull_verts.y[v] = hull_vertices[3*(hull_offs+v)+1];
+                result.convex_hull_verts.z[v] = hull_vertices[3*(hull_offs+v)+2];
+                }
+            hull_offs += hull_N[i];
+            result.convex_hull_verts.diameter = 2*(sqrt(radius_sq)+result.sweep_radius);
+
+            std::vector<hpmc::detail::OBB> obbs(tree_N[i]);
+            std::vector<unsigned int> left(tree_N[i]), escape(tree_N[i]), ancestors(tree_N[i]), leaf_ptr(tree_N[i]+1);
+            leaf_ptr[0] = 0;
+            for (unsigned int n = 0; n < tree_N[i]; n++)
+                {
+                const unsigned int k = node_offs + n;
+                obbs[n].center = vec3<OverlapReal>(tree_center[3*k+0], tree_center[3*k+1], tree_center[3*k+2]);
+                obbs[n].lengths = vec3<OverlapReal>(tree_lengths[3*k+0], tree_lengths[3*k+1], tree_lengths[3*k+2]);
+                obbs[n].rotation = quat<OverlapReal>(tree_rotation[4*k+0],
+                    vec3<OverlapReal>(tree_rotation[4*k+1], tree_rotation[4*k+2], tree_rotation[4*k+3]));
+                obbs[n].mask = tree_node[6*k+0];
+                obbs[n].is_sphere = tree_node[6*k+4];
+                left[n] = tree_node[6*k+1];
+                escape[n] = tree_node[6*k+2];
+                ancestors[n] = tree_node[6*k+3];
+                leaf_ptr[n+1] = leaf_ptr[n] + tree_node[6*k+5];
+                }
+            std::vector<unsigned int> particles(tree_particles.begin() + particle_offs,
+                                                tree_particles.begin() + particle_offs + leaf_ptr[tree_N[i]]);
+            node_offs += tree_N[i];
+            particle_offs += leaf_ptr[tree_N[i]];
+
+            result.tree = hpmc::detail::GPUTree(obbs, left, escape, ancestors, leaf_ptr, particles, leaf_capacity[i], managed);
+            shape[i] = result;
+            shape[i].ignore = 0;
+            }
+        return success;
+        }
+
+    private:
+        //! Write a chunk with M columns from a flat array
+        template<class T>
+        int writeArray(gsd_handle& handle, const std::string& path, gsd_type type, const std::vector<T>& data, unsigned int M)
+            {
+            if (!data.size())
+                return 0;
+            return gsd_write_chunk(&handle, path.c_str(), type, data.size()/M, M, 0, (void *)&data[0]);
+            }
+
+        //! Read a chunk with N rows and M columns into a flat array on the root rank
+        template<class T>
+        bool readArray(std::shared_ptr<GSDReader> reader, uint64_t frame, const std::string& path, std::vector<T>& data, unsigned int N, unsigned int M)
+            {
+            data.resize(N*M);
+            if (!N)
+                return true;
+            return reader->readChunk((void *)&data[0], frame, path.c_str(), N*M*sizeof(T), N);
+            }
+    };
+
 #endif
@@ -88,6 +88,19 @@ DEVICE inline hpmc_counters_t operator-(const hpmc_counters_t& a, const hpmc_cou
     return result;
     }
 
+//! Take the sum of two sets of counters
+DEVICE inline hpmc_counters_t operator+(const hpmc_counters_t& a, const hpmc_counters_t& b)
+    {
+    hpmc_counters_t result;
+    result.translate_accept_count = a.translate_accept_count + b.translate_accept_count;
+    result.rotate_accept_count = a.rotate_accept_count + b.rotate_accept_count;
+    result.translate_reject_count = a.translate_reject_count + b.translate_reject_count;
+    result.rotate_reject_count = a.rotate_reject_count + b.rotate_reject_count;
+    result.overlap_checks = a.overlap_checks + b.overlap_checks;
+    result.overlap_err_count = a.overlap_err_count + b.overlap_err_count;
+    return result;
+    }
+
 
 //! Storage for NPT acceptance counters
 /*! \ingroup hpmc_data_structs */
@@ -447,6 +460,22 @@ DEVICE inline hpmc_clusters_counters_t operator-(const hpmc_clusters_counters_t&
     return result;
     }
 
+//! Take the sum of two sets of counters
+DEVICE inline hpmc_clusters_counters_t operator+(const hpmc_clusters_counters_t& a, const hpmc_clusters_counters_t& b)
+    {
+    hpmc_clusters_counters_t result;
+    result.pivot_accept_count = a.pivot_accept_count + b.pivot_accept_count;
+    result.reflection_accept_count = a.reflection_accept_count + b.reflection_accept_count;
+    result.swap_accept_count = a.swap_accept_count + b.swap_accept_count;
+    result.pivot_reject_count = a.pivot_reject_count + b.pivot_reject_count;
+    result.reflection_reject_count = a.reflection_reject_count + b.reflection_reject_count;
+    result.swap_reject_count = a.swap_reject_count + b.swap_reject_count;
+    result.n_clusters = a.n_clusters + b.n_clusters;
+    result.n_particles_in_clusters = a.n_particles_in_clusters + b.n_particles_in_clusters;
+
+    return result;
+    }
+
 } // end namespace hpmc
 
 #endif // _HPMC_COUNTERS_H_
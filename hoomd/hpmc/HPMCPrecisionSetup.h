@@ -38,6 +38,15 @@ typedef float OverlapReal;
 typedef float3 OverlapReal3;
 typedef float4 OverlapReal4;
 
+// adaptive mode runs the overlap checks of convex (sphero)polyhedra in single precision and re-tests a pair in double
+// precision when the single precision result is decided within a margin of contact
+#ifdef ENABLE_HPMC_ADAPTIVE_PRECISION
+#define HPMC_ADAPTIVE_PRECISION
+
+//! Margin, relative to the circumsphere radius, within which single precision overlap results are re-tested
+#define HPMC_ADAPTIVE_PRECISION_MARGIN 1e-5
+#endif
+
 #else
 typedef double OverlapReal;
 typedef double3 OverlapReal3;
@@ -6,7 +6,9 @@
 namespace py = pybind11;
 
 #include "hoomd/VectorMath.h"
+#include <algorithm>
 #include <sstream>
+#include <vector>
 
 using namespace std;
 
@@ -20,6 +22,8 @@ namespace hpmc
 IntegratorHPMC::IntegratorHPMC(std::shared_ptr<SystemDefinition> sysdef,
                                unsigned int seed)
     : Integrator(sysdef, 0.005), m_seed(seed),  m_move_ratio(32768), m_nselect(4),
+      m_tune_moves(false), m_tune_target(0.2), m_tune_gamma(2.0), m_tune_max_scale(2.0), m_tune_max_d(1.0),
+      m_tune_max_a(0.5), m_tune_period(10), m_tune_steps(0),
       m_nominal_width(1.0), m_extra_ghost_width(0), m_external_base(NULL), m_patch_log(false),
       m_past_first_run(false)
       #ifdef ENABLE_MPI
@@ -38,24 +42,35 @@ IntegratorHPMC::IntegratorHPMC(std::shared_ptr<SystemDefinition> sysdef,
     GPUArray<hpmc_counters_t> counters(1, this->m_exec_conf);
     m_count_total.swap(counters);
 
+    GPUVector<hpmc_counters_t> count_type(this->m_pdata->getNTypes(), this->m_exec_conf);
+    m_count_type.swap(count_type);
+
     GPUVector<Scalar> d(this->m_pdata->getNTypes(), this->m_exec_conf);
     m_d.swap(d);
 
     GPUVector<Scalar> a(this->m_pdata->getNTypes(), this->m_exec_conf);
     m_a.swap(a);
 
-    ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::overwrite);
-    //set default values
-    for(unsigned int typ=0; typ < this->m_pdata->getNTypes(); typ++)
-      {
-      h_d.data[typ]=0.1;
-      h_a.data[typ]=0.1;
-      }
+        {
+        ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::overwrite);
+        //set default values
+        for(unsigned int typ=0; typ < this->m_pdata->getNTypes(); typ++)
+          {
+          h_d.data[typ]=0.1;
+          h_a.data[typ]=0.1;
+          }
+        }
 
     // Connect to number of types change signal
     m_pdata->getNumTypesChangeSignal().connect<IntegratorHPMC, &IntegratorHPMC::slotNumTypesChange>(this);
 
+    // keep the move sizes of a restart until the first run, the script sets the initial ones before that
+    m_integrator_id = m_sysdef->getIntegratorData()->registerIntegrator();
+    const IntegratorVariables& v = m_sysdef->getIntegratorData()->getIntegratorVariables(m_integrator_id);
+    m_restore_move_sizes = (v.type == "hpmc" && v.variable.size() == 2*m_pdata->getNTypes());
+    storeMoveSizes();
+
     resetStats();
     }
 
@@ -84,14 +99,27 @@ void IntegratorHPMC::slotNumTypesChange()
     m_a.resize(ntypes);
     m_d.resize(ntypes);
 
+    // restart the per type statistics of the move size adaptation
+    m_count_type.resize(ntypes);
+        {
+        ArrayHandle<hpmc_counters_t> h_count_type(m_count_type, access_location::host, access_mode::overwrite);
+        for (unsigned int typ = 0; typ < ntypes; typ++)
+            h_count_type.data[typ] = hpmc_counters_t();
+        }
+    m_tune_steps = 0;
+
     //set default values for newly added types
-    ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::readwrite);
-    for(unsigned int typ=old_ntypes; typ < ntypes; typ++)
         {
-        h_d.data[typ]=0.1;
-        h_a.data[typ]=0.1;
+        ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::readwrite);
+        for(unsigned int typ=old_ntypes; typ < ntypes; typ++)
+            {
+            h_d.data[typ]=0.1;
+            h_a.data[typ]=0.1;
+            }
         }
+
+    storeMoveSizes();
     }
 
 /*! IntegratorHPMC provides:
@@ -310,6 +338,153 @@ hpmc_counters_t IntegratorHPMC::getCounters(unsigned int mode)
     return result;
     }
 
+/*! \param enable Set to true to adapt the move sizes online
+    \param target Target acceptance ratio of the translation and rotation moves
+    \param gamma Damping of the updates, larger values converge faster
+    \param max_scale Maximum factor by which a move size grows in one update
+    \param max_d Upper bound of the adapted displacements
+    \param max_a Upper bound of the adapted rotations
+    \param period Number of steps between updates
+
+    The counters are accumulated by type during the trial moves and reduced once per update. The update rule is the
+    same as in hpmc.util.tune, so that a tuner run and the online adaptation converge to the same move sizes.
+*/
+void IntegratorHPMC::setMoveSizeTuning(bool enable, Scalar target, Scalar gamma, Scalar max_scale, Scalar max_d,
+    Scalar max_a, unsigned int period)
+    {
+    if (target <= Scalar(0.0) || target >= Scalar(1.0))
+        {
+        m_exec_conf->msg->error() << "hpmc: The target acceptance ratio must be between 0 and 1" << endl;
+        throw std::runtime_error("Error setting move size adaptation");
+        }
+    if (period == 0 || gamma < Scalar(0.0) || max_scale <= Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "hpmc: Invalid move size adaptation parameters" << endl;
+        throw std::runtime_error("Error setting move size adaptation");
+        }
+
+    m_tune_moves = enable;
+    m_tune_target = target;
+    m_tune_gamma = gamma;
+    m_tune_max_scale = max_scale;
+    m_tune_max_d = max_d;
+    m_tune_max_a = max_a;
+    m_tune_period = period;
+
+    // discard the statistics of moves made with earlier parameters
+    m_tune_steps = 0;
+    ArrayHandle<hpmc_counters_t> h_count_type(m_count_type, access_location::host, access_mode::overwrite);
+    for (unsigned int typ = 0; typ < m_count_type.size(); typ++)
+        h_count_type.data[typ] = hpmc_counters_t();
+    }
+
+/*! Every m_tune_period steps, the accept and reject counts by type are summed over all ranks and every move size x
+    with acceptance ratio p is scaled by min(max_scale, (1+gamma) p / (target + gamma p)), or by 0.1 if no move was
+    accepted. Move sizes of zero disable the moves and are left alone, as are those of types without trial moves.
+*/
+void IntegratorHPMC::adaptMoveSizes()
+    {
+    if (!m_tune_moves || ++m_tune_steps < m_tune_period)
+        return;
+    m_tune_steps = 0;
+
+    unsigned int ntypes = m_pdata->getNTypes();
+    std::vector<unsigned long long int> counts(4*ntypes);
+
+        {
+        ArrayHandle<hpmc_counters_t> h_count_type(m_count_type, access_location::host, access_mode::readwrite);
+        for (unsigned int typ = 0; typ < ntypes; typ++)
+            {
+            counts[4*typ] = h_count_type.data[typ].translate_accept_count;
+            counts[4*typ+1] = h_count_type.data[typ].translate_reject_count;
+            counts[4*typ+2] = h_count_type.data[typ].rotate_accept_count;
+            counts[4*typ+3] = h_count_type.data[typ].rotate_reject_count;
+            h_count_type.data[typ] = hpmc_counters_t();
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &counts.front(), 4*ntypes, MPI_LONG_LONG_INT, MPI_SUM,
+            m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    auto scale = [&](Scalar x, unsigned long long int n_accept, unsigned long long int n_reject, Scalar max_x)
+        {
+        if (x == Scalar(0.0) || n_accept + n_reject == 0)
+            return x;
+
+        Scalar acceptance = Scalar(n_accept) / Scalar(n_accept + n_reject);
+        Scalar factor = Scalar(0.1);
+        if (acceptance > Scalar(0.0))
+            factor = ((Scalar(1.0) + m_tune_gamma) * acceptance) / (m_tune_target + m_tune_gamma * acceptance);
+        factor = std::min(factor, m_tune_max_scale);
+
+        return std::min(x * factor, max_x);
+        };
+
+        {
+        ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::readwrite);
+        ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::readwrite);
+        for (unsigned int typ = 0; typ < ntypes; typ++)
+            {
+            h_d.data[typ] = scale(h_d.data[typ], counts[4*typ], counts[4*typ+1], m_tune_max_d);
+            h_a.data[typ] = scale(h_a.data[typ], counts[4*typ+2], counts[4*typ+3], m_tune_max_a);
+            }
+        }
+
+    storeMoveSizes();
+    }
+
+/*! The move sizes are stored as the variables d_0, a_0, d_1, a_1, ... of the integrator type "hpmc", so that
+    checkpoints save them with the other integrator variables. While the move sizes of a restart are pending, the
+    move sizes set by the script are not stored.
+*/
+void IntegratorHPMC::storeMoveSizes()
+    {
+    if (m_restore_move_sizes)
+        return;
+
+    IntegratorVariables v;
+    v.type = "hpmc";
+
+    ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::read);
+    for (unsigned int typ = 0; typ < m_d.size(); typ++)
+        {
+        v.variable.push_back(h_d.data[typ]);
+        v.variable.push_back(h_a.data[typ]);
+        }
+
+    m_sysdef->getIntegratorData()->setIntegratorVariables(m_integrator_id, v);
+    }
+
+/*! Restored move sizes replace the ones set before the first run.
+*/
+void IntegratorHPMC::restoreMoveSizes()
+    {
+    const IntegratorVariables& v = m_sysdef->getIntegratorData()->getIntegratorVariables(m_integrator_id);
+
+    if (v.variable.size() == 2*m_d.size())
+        {
+        m_exec_conf->msg->notice(2) << "hpmc: restoring the move sizes from the restart" << endl;
+
+        ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::overwrite);
+        for (unsigned int typ = 0; typ < m_d.size(); typ++)
+            {
+            h_d.data[typ] = v.variable[2*typ];
+            h_a.data[typ] = v.variable[2*typ+1];
+            }
+        }
+
+    m_restore_move_sizes = false;
+    updateCellWidth();
+    storeMoveSizes();
+    }
+
 void export_IntegratorHPMC(py::module& m)
     {
    py::class_<IntegratorHPMC, std::shared_ptr< IntegratorHPMC > >(m, "IntegratorHPMC", py::base<Integrator>())
@@ -330,6 +505,11 @@ void export_IntegratorHPMC(py::module& m)
     .def("communicate", &IntegratorHPMC::communicate)
     .def("slotNumTypesChange", &IntegratorHPMC::slotNumTypesChange)
     .def("setDeterministic", &IntegratorHPMC::setDeterministic)
+    .def("setCheckerboard", &IntegratorHPMC::setCheckerboard)
+    .def("setGhostAABB", &IntegratorHPMC::setGhostAABB)
+    .def("setCUDAGraph", &IntegratorHPMC::setCUDAGraph)
+    .def("setMoveSizeTuning", &IntegratorHPMC::setMoveSizeTuning)
+    .def("getMoveSizeTuning", &IntegratorHPMC::getMoveSizeTuning)
     .def("disablePatchEnergyLogOnly", &IntegratorHPMC::disablePatchEnergyLogOnly)
     ;
 
@@ -77,6 +77,38 @@ class PatchEnergy
         return 0;
         }
 
+    //! evaluate the energies of a packet of patch interactions with particle i
+    /*! \param n Number of neighbors j in the packet
+        \param r_ij Vectors pointing from particle i to each j
+        \param type_i Integer type index of particle i
+        \param q_i Orientation quaternion of particle i
+        \param d_i Diameter of particle i
+        \param charge_i Charge of particle i
+        \param type_j Integer type indices of the particles j
+        \param q_j Orientation quaternions of the particles j
+        \param d_j Diameters of the particles j
+        \param charge_j Charges of the particles j
+        \param u Output energies of the patch interactions (length n)
+
+        The default implementation calls energy() once per pair. Subclasses override it to evaluate the whole packet
+        without a virtual function call per pair.
+    */
+    virtual void energyBatch(unsigned int n,
+        const vec3<float> *r_ij,
+        unsigned int type_i,
+        const quat<float>& q_i,
+        float d_i,
+        float charge_i,
+        const unsigned int *type_j,
+        const quat<float> *q_j,
+        const float *d_j,
+        const float *charge_j,
+        float *u)
+        {
+        for (unsigned int k = 0; k < n; ++k)
+            u[k] = energy(r_ij[k], type_i, q_i, d_i, charge_i, type_j[k], q_j[k], d_j[k], charge_j[k]);
+        }
+
     };
 
 class IntegratorHPMC : public Integrator
@@ -106,6 +138,7 @@ class IntegratorHPMC : public Integrator
                 h_d.data[typ] = d;
                 }
             updateCellWidth();
+            storeMoveSizes();
             }
 
         //! Get maximum displacement (by type)
@@ -143,8 +176,11 @@ class IntegratorHPMC : public Integrator
         */
         void setA(Scalar a,unsigned int typ)
             {
-            ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::readwrite);
-            h_a.data[typ] = a;
+                {
+                ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::readwrite);
+                h_a.data[typ] = a;
+                }
+            storeMoveSizes();
             }
 
         //! Get maximum rotation
@@ -322,9 +358,30 @@ class IntegratorHPMC : public Integrator
         //! Enable deterministic simulations
         virtual void setDeterministic(bool deterministic) {};
 
+        //! Enable parallel checkerboard sweeps on the CPU
+        virtual void setCheckerboard(bool checkerboard) {};
+
+        //! Size the ghost layer by the AABB extents of the particles instead of their circumspheres
+        virtual void setGhostAABB(bool ghost_aabb) {};
+
+        //! Enable replaying the trial move sweep from a CUDA graph
+        virtual void setCUDAGraph(bool cuda_graph) {};
+
+        //! Enable the online adaptation of the move sizes
+        void setMoveSizeTuning(bool enable, Scalar target, Scalar gamma, Scalar max_scale, Scalar max_d, Scalar max_a,
+            unsigned int period);
+
+        //! Get whether the move sizes are adapted online
+        bool getMoveSizeTuning()
+            {
+            return m_tune_moves;
+            }
+
         //! Prepare for the run
         virtual void prepRun(unsigned int timestep)
             {
+            if (!m_past_first_run && m_restore_move_sizes)
+                restoreMoveSizes();
             m_past_first_run = true;
             }
 
@@ -351,6 +408,16 @@ class IntegratorHPMC : public Integrator
         GPUVector<Scalar> m_a;                      //!< Maximum angular displacement by type
 
         GPUArray< hpmc_counters_t > m_count_total;  //!< Accept/reject total count
+        GPUVector< hpmc_counters_t > m_count_type;  //!< Accept/reject count by type since the last move size update
+
+        bool m_tune_moves;                          //!< True if the move sizes are adapted online
+        Scalar m_tune_target;                       //!< Target acceptance ratio of the adapted moves
+        Scalar m_tune_gamma;                        //!< Damping of the move size updates (larger is faster)
+        Scalar m_tune_max_scale;                    //!< Maximum factor by which a move size grows in one update
+        Scalar m_tune_max_d;                        //!< Upper bound of the adapted displacements
+        Scalar m_tune_max_a;                        //!< Upper bound of the adapted rotations
+        unsigned int m_tune_period;                 //!< Number of steps between move size updates
+        unsigned int m_tune_steps;                  //!< Number of steps since the last move size update
 
         Scalar m_nominal_width;                      //!< nominal cell width
         Scalar m_extra_ghost_width;                  //!< extra ghost width to add
@@ -362,6 +429,19 @@ class IntegratorHPMC : public Integrator
         bool m_patch_log;                           //!< If true, only use patch energy for logging
 
         bool m_past_first_run;                      //!< Flag to test if the first run() has started
+
+        unsigned int m_integrator_id;               //!< Handle of the move sizes in IntegratorData
+        bool m_restore_move_sizes;                  //!< True until the move sizes of a restart have been applied
+
+        //! Adapt the move sizes to the acceptance by type, called at the end of every step
+        void adaptMoveSizes();
+
+        //! Store the move sizes in IntegratorData
+        void storeMoveSizes();
+
+        //! Apply the move sizes read from a restart
+        void restoreMoveSizes();
+
         //! Update the nominal width of the cells
         /*! This method is virtual so that derived classes can set appropriate widths
             (for example, some may want max diameter while others may want a buffer distance).
@@ -9,6 +9,8 @@
     \brief Declaration of IntegratorHPMC
 */
 
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <iomanip>
 #include <sstream>
@@ -17,8 +19,12 @@
 #include "HPMCPrecisionSetup.h"
 #include "IntegratorHPMC.h"
 #include "Moves.h"
+#include "OverlapBatch.h"
+#include "SeparatingAxisCache.h"
 #include "hoomd/AABBTree.h"
 #include "GSDHPMCSchema.h"
+#include "ExternalFieldLattice.h"
+#include "ExternalFieldComposite.h"
 #include "hoomd/Index1D.h"
 
 #include "hoomd/managed_allocator.h"
@@ -104,6 +110,80 @@ class UpdateOrder
         std::vector<unsigned int> m_update_order; //!< Update order
     };
 
+//! Neighbors of particle i gathered for a single PatchEnergy::energyBatch call
+/*! Trial moves push the pairs within the patch cut-off into the packet and flush it when it is full, so the patch
+    energy is evaluated one packet at a time instead of through one virtual call per pair.
+
+    \ingroup hpmc_data_structs
+*/
+struct PatchEnergyPacket
+    {
+    //! Maximum number of neighbors in a packet
+    static const unsigned int capacity = 32;
+
+    //! Constructor
+    PatchEnergyPacket() : n(0) { }
+
+    //! Test if the packet is full
+    bool full() const
+        {
+        return n == capacity;
+        }
+
+    //! Add the neighbor j
+    void push(unsigned int j,
+        const vec3<float>& r_ij,
+        unsigned int type_j,
+        const quat<float>& q_j,
+        float d_j,
+        float charge_j)
+        {
+        idx[n] = j;
+        r[n] = r_ij;
+        type[n] = type_j;
+        q[n] = q_j;
+        d[n] = d_j;
+        charge[n] = charge_j;
+        n++;
+        }
+
+    //! Evaluate the packet and empty it
+    /*! \param patch Patch energy to evaluate
+        \param type_i Type of particle i
+        \param q_i Orientation of particle i
+        \param d_i Diameter of particle i
+        \param charge_i Charge of particle i
+        \param f Called as f(j, u) with the energy u of each pair
+        \returns The sum of the pair energies in the packet
+    */
+    template<class Callback>
+    double flush(PatchEnergy *patch, unsigned int type_i, const quat<float>& q_i, float d_i, float charge_i,
+        const Callback& f)
+        {
+        double sum = 0.0;
+        if (n > 0)
+            {
+            patch->energyBatch(n, r, type_i, q_i, d_i, charge_i, type, q, d, charge, u);
+            for (unsigned int k = 0; k < n; ++k)
+                {
+                sum += u[k];
+                f(idx[k], u[k]);
+                }
+            }
+        n = 0;
+        return sum;
+        }
+
+    unsigned int n;                     //!< Number of neighbors in the packet
+    unsigned int idx[capacity];         //!< Particle indices j
+    vec3<float> r[capacity];            //!< Vectors from i to j
+    unsigned int type[capacity];        //!< Types of j
+    quat<float> q[capacity];            //!< Orientations of j
+    float d[capacity];                  //!< Diameters of j
+    float charge[capacity];             //!< Charges of j
+    float u[capacity];                  //!< Pair energies
+    };
+
 }; // end namespace detail
 
 //! HPMC on systems of mono-disperse shapes
@@ -209,9 +289,11 @@ class IntegratorHPMCMono : public IntegratorHPMC
             bool use_images, bool exclude_self);
 
         //! Return the requested ghost layer width
-        virtual Scalar getGhostLayerWidth(unsigned int)
+        virtual Scalar getGhostLayerWidth(unsigned int type)
             {
             Scalar ghost_width = m_nominal_width + m_extra_ghost_width;
+            if (m_ghost_aabb && type < m_ghost_radius.size())
+                ghost_width = m_ghost_radius[type] + m_ghost_radius_max + m_extra_ghost_width;
             m_exec_conf->msg->notice(9) << "IntegratorHPMCMono: ghost layer width of " << ghost_width << std::endl;
             return ghost_width;
             }
@@ -276,11 +358,29 @@ class IntegratorHPMCMono : public IntegratorHPMC
                 // this is kludgy but necessary since we are calling the communications methods directly
                 m_comm->setFlags(getCommFlags(0));
 
+                if (migrate && m_comm->getMigrationBuffer() > Scalar(0.0))
+                    {
+                    if (m_ghost_aabb)
+                        updateGhostRadii();
+
+                    // when no particle can have left its domain or entered a ghost layer, only update the ghosts
+                    if (!m_comm->checkMigration())
+                        {
+                        m_comm->beginUpdateGhosts(0);
+                        m_comm->finishUpdateGhosts(0);
+                        m_aabb_tree_invalid = true;
+                        return;
+                        }
+                    }
+
                 if (migrate)
                     m_comm->migrateParticles();
                 else
                     m_pdata->removeAllGhostParticles();
 
+                if (m_ghost_aabb)
+                    updateGhostRadii();
+
                 m_comm->exchangeGhosts();
 
                 m_aabb_tree_invalid = true;
@@ -291,13 +391,25 @@ class IntegratorHPMCMono : public IntegratorHPMC
         //! Return true if anisotropic particles are present
         virtual bool hasOrientation() { return m_hasOrientation; }
 
+        //! Enable parallel checkerboard sweeps on the CPU
+        virtual void setCheckerboard(bool checkerboard)
+            {
+            m_checkerboard = checkerboard;
+            }
+
+        //! Size the ghost layer by the AABB extents of the particles instead of their circumspheres
+        virtual void setGhostAABB(bool ghost_aabb)
+            {
+            m_ghost_aabb = ghost_aabb;
+            }
+
         //! Compute the energy due to patch interactions
         /*! \param timestep the current time step
          * \returns the total patch energy
          */
         virtual float computePatchEnergy(unsigned int timestep);
 
-        //! Build the AABB tree (if needed)
+        //! Build or refit the AABB tree (if needed)
         const detail::AABBTree& buildAABBTree();
 
         //! Make list of image indices for boxes to check in small-box mode
@@ -315,6 +427,63 @@ class IntegratorHPMCMono : public IntegratorHPMC
 
         void invalidateAABBTree(){ m_aabb_tree_invalid = true; }
 
+        //! Test if the AABB tree can follow the insertion or removal of a particle
+        /*! \returns true if the tree is up to date and there are no ghost particles, so that particle indices
+                     only change by ParticleData::addParticle() and removeParticle()
+        */
+        bool canUpdateAABBTree() const
+            {
+            #ifdef ENABLE_MPI
+            if (m_comm)
+                return false;
+            #endif
+            return !m_aabb_tree_invalid && !m_aabb_tree_stale && m_pdata->getNGhosts() == 0
+                && m_aabb_tree.getNumParticles() == m_pdata->getN();
+            }
+
+        //! Add a particle that was appended to the particle data to the AABB tree
+        void insertAABBTreeParticle(unsigned int idx);
+
+        //! Remove a particle from the AABB tree, the last particle takes its index
+        void removeAABBTreeParticle(unsigned int idx);
+
+        //! Set the relative growth of the tree surface area that triggers a full rebuild
+        /*! \param threshold Rebuild when the refit tree exceeds this multiple of the surface area at its last build,
+                             refit is disabled for values of 1 and below
+        */
+        void setAABBRefitThreshold(Scalar threshold)
+            {
+            m_aabb_refit_threshold = threshold;
+            }
+
+        //! Set the maximum number of pairs whose separating axes are cached between serial sweeps
+        /*! \param max_pairs Size of the cache, 0 disables it
+        */
+        void setAxisCacheSize(unsigned int max_pairs)
+            {
+            if (max_pairs > 0 && !SeparatingAxis<Shape>::enabled)
+                {
+                m_exec_conf->msg->warning() << "integrate.mode_hpmc: This shape does not support the separating axis "
+                                            << "cache. Ignoring." << std::endl;
+                }
+            m_axis_cache.setMaxPairs(max_pairs);
+            }
+
+        //! Set the skin of the per-particle candidate lists
+        /*! \param skin Distance added to the circumsphere contact of the pairs in the lists, 0 disables them
+        */
+        void setCandidateSkin(Scalar skin)
+            {
+            m_cand_skin = skin;
+            m_cand_valid = false;
+            }
+
+        //! Get the number of times the candidate lists have been built
+        unsigned int getCandidateListBuilds() const
+            {
+            return m_cand_builds;
+            }
+
         //! Method that is called whenever the GSD file is written if connected to a GSD file.
         int slotWriteGSD(gsd_handle&, std::string name) const;
 
@@ -338,15 +507,46 @@ class IntegratorHPMCMono : public IntegratorHPMC
         bool m_hasOrientation;                               //!< true if there are any orientable particles in the system
 
         std::shared_ptr< ExternalFieldMono<Shape> > m_external;//!< External Field
+        std::vector< ExternalFieldLattice<Shape>* > m_external_lattice; //!< Lattice fields in m_external, during update()
+        std::vector< ExternalFieldMono<Shape>* > m_external_other;      //!< Other fields in m_external, during update()
+        bool m_external_concurrent;                 //!< True if the external fields may be evaluated concurrently
         detail::AABBTree m_aabb_tree;               //!< Bounding volume hierarchy for overlap checks
         detail::AABB* m_aabbs;                      //!< list of AABBs, one per particle
         unsigned int m_aabbs_capacity;              //!< Capacity of m_aabbs list
         bool m_aabb_tree_invalid;                   //!< Flag if the aabb tree has been invalidated
+        bool m_aabb_tree_stale;                     //!< Flag if particles moved, but the tree topology is still valid
+        Scalar m_aabb_refit_threshold;              //!< Relative surface area growth that triggers a rebuild
+        Scalar m_aabb_tree_build_area;              //!< Summed node surface area after the last full build
 
         Scalar m_extra_image_width;                 //! Extra width to extend the image list
 
         Index2D m_overlap_idx;                      //!!< Indexer for interaction matrix
 
+        bool m_checkerboard;                        //!< True if independent cells are swept in parallel
+        Index3D m_cb_indexer;                       //!< Indexer for the checkerboard cells
+        Scalar3 m_cb_shift;                         //!< Random shift of the checkerboard in fractional coordinates
+        std::vector<unsigned int> m_cb_cell_start;  //!< Offset of each cell into m_cb_cell_particles
+        std::vector<unsigned int> m_cb_cell_particles; //!< Local particles grouped by cell, in update order
+        std::vector< std::vector<unsigned int> > m_cb_color_cells; //!< Non-empty cells of each color
+
+        bool m_ghost_aabb;                          //!< True if the ghost layer is sized by the AABB extents
+        std::vector<Scalar> m_ghost_radius;         //!< Interaction radius of each type across domain boundaries
+        Scalar m_ghost_radius_max;                  //!< Largest entry of m_ghost_radius
+
+        std::vector<double> m_patch_energy_cache;   //!< Patch energy of each particle, maintained during serial sweeps
+        std::vector< std::pair<unsigned int, float> > m_patch_new_pairs; //!< Pair energies of the current trial move
+
+        detail::SeparatingAxisCache m_axis_cache;   //!< Separating axes of the pairs tested in serial sweeps
+
+        Scalar m_cand_skin;                         //!< Skin of the candidate lists, 0 disables them
+        bool m_cand_valid;                          //!< False if the candidate lists must be rebuilt
+        unsigned int m_cand_builds;                 //!< Number of candidate list builds
+        std::vector<unsigned int> m_cand_head;      //!< Offset of the candidates of each particle into m_cand_list
+        std::vector<unsigned int> m_cand_list;      //!< Overlap candidates of all particles
+        std::vector< vec3<Scalar> > m_cand_pos;     //!< Particle positions at the last build
+        std::vector<unsigned int> m_cand_tag;       //!< Particle tags at the last build
+        std::vector<unsigned int> m_cand_type;      //!< Particle types at the last build
+
         //! Set the nominal width appropriate for looped moves
         virtual void updateCellWidth();
 
@@ -356,20 +556,94 @@ class IntegratorHPMCMono : public IntegratorHPMC
         //! Limit the maximum move distances
         virtual void limitMoveDistances();
 
+        //! Compute the AABBs of all particles
+        unsigned int computeAABBs();
+
+        //! Compute the AABB of one particle
+        detail::AABB computeAABB(const Scalar4& postype, const Scalar4& orientation);
+
+        //! Sum the patch energy of particle i in the stored configuration
+        template<class Callback>
+        double computeParticlePatchEnergy(unsigned int i,
+                                          const Scalar4 *h_postype,
+                                          const Scalar4 *h_orientation,
+                                          const Scalar *h_diameter,
+                                          const Scalar *h_charge,
+                                          const Callback& f);
+
+        //! Test a trial move against all particles in a leaf node in one batch
+        bool testOverlapBatch(unsigned int node,
+                              unsigned int i,
+                              const vec3<Scalar>& pos_i,
+                              const vec3<Scalar>& pos_i_image,
+                              const Shape& shape_i,
+                              bool primary_image,
+                              const Scalar4 *h_postype,
+                              const Scalar4 *h_orientation,
+                              const unsigned int *h_overlaps,
+                              const unsigned int *h_tag,
+                              hpmc_counters_t& counters);
+
+        //! Validate the candidate lists for the next sweep and rebuild them if needed
+        bool updateCandidateLists();
+
+        //! Test a trial move against the candidate list of the particle
+        bool testOverlapCandidates(unsigned int i,
+                                   const vec3<Scalar>& pos_i,
+                                   const Shape& shape_i,
+                                   const BoxDim& box,
+                                   const Scalar4 *h_postype,
+                                   const Scalar4 *h_orientation,
+                                   const unsigned int *h_overlaps,
+                                   const unsigned int *h_tag,
+                                   hpmc_counters_t& counters);
+
+        //! Assign the local particles to checkerboard cells
+        bool setupCheckerboard(unsigned int timestep);
+
+        #ifdef ENABLE_MPI
+        //! Update the interaction radius of each type across domain boundaries
+        bool updateGhostRadii();
+        #endif
+
+        //! Get the checkerboard cell of a position
+        unsigned int getCheckerboardCell(const vec3<Scalar>& pos, const BoxDim& box) const;
+
+        //! Build an AABB tree that bounds one trial move of every particle
+        void buildCheckerboardAABBTree();
+
+        //! Collect the external fields and prepare them for the trial moves
+        bool beginExternalMoves();
+
+        //! Collect the fields in an external field
+        void addExternalFields(ExternalFieldMono<Shape> *external);
+
+        //! Release the external fields after the trial moves
+        void endExternalMoves();
+
+        //! Compute the energy difference of a trial move in the external fields
+        inline double externalEnergyDiff(unsigned int i,
+                                         const vec3<Scalar>& pos_old,
+                                         const Shape& shape_old,
+                                         const vec3<Scalar>& pos_new,
+                                         const Shape& shape_new);
+
         //! callback so that the box change signal can invalidate the image list
         virtual void slotBoxChanged()
             {
             m_image_list_valid = false;
-            // changing the box does not necessarily invalidate the AABB tree - however, practically
+            // changing the box does not invalidate the AABB tree - however, practically
             // anything that changes the box (i.e. NPT, box_resize) is also moving the particles,
-            // so use it as a sign to rebuild the AABB tree
-            m_aabb_tree_invalid = true;
+            // so use it as a sign to refit the AABB tree
+            m_aabb_tree_stale = true;
+            m_cand_valid = false;
             }
 
         //! callback so that the particle sort signal can invalidate the AABB tree
         virtual void slotSorted()
             {
             m_aabb_tree_invalid = true;
+            m_cand_valid = false;
             }
     };
 
@@ -381,7 +655,12 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
               m_image_list_is_initialized(false),
               m_image_list_valid(false),
               m_hasOrientation(true),
-              m_extra_image_width(0.0)
+              m_external_concurrent(true),
+              m_extra_image_width(0.0),
+              m_checkerboard(false),
+              m_cb_shift(make_scalar3(0,0,0)),
+              m_ghost_aabb(false),
+              m_ghost_radius_max(0.0)
     {
     // allocate the parameter storage
     m_params = std::vector<param_type, managed_allocator<param_type> >(m_pdata->getNTypes(), param_type(), managed_allocator<param_type>(m_exec_conf->isCUDAEnabled()));
@@ -401,6 +680,13 @@ IntegratorHPMCMono<Shape>::IntegratorHPMCMono(std::shared_ptr<SystemDefinition>
     m_aabbs = NULL;
     m_aabbs_capacity = 0;
     m_aabb_tree_invalid = true;
+    m_aabb_tree_stale = false;
+    m_aabb_refit_threshold = Scalar(1.5);
+    m_aabb_tree_build_area = Scalar(0.0);
+
+    m_cand_skin = Scalar(0.0);
+    m_cand_valid = false;
+    m_cand_builds = 0;
     }
 
 
@@ -458,6 +744,9 @@ void IntegratorHPMCMono<Shape>::printStats()
     {
     IntegratorHPMC::printStats();
 
+    if (m_cand_skin > Scalar(0.0))
+        m_exec_conf->msg->notice(2) << "HPMC candidate list builds: " << m_cand_builds << std::endl;
+
     /*unsigned int max_height = 0;
     unsigned int total_height = 0;
 
@@ -509,16 +798,23 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     m_exec_conf->msg->notice(10) << "HPMCMono update: " << timestep << std::endl;
     IntegratorHPMC::update(timestep);
 
+    #ifdef ENABLE_MPI
+    // another updater may have rotated particles since the last ghost exchange
+    if (m_comm && m_ghost_aabb && updateGhostRadii())
+        communicate(false);
+    #endif
+
     // get needed vars
     ArrayHandle<hpmc_counters_t> h_counters(m_count_total, access_location::host, access_mode::readwrite);
-    hpmc_counters_t& counters = h_counters.data[0];
+    hpmc_counters_t& counters_total = h_counters.data[0];
     const BoxDim& box = m_pdata->getBox();
     unsigned int ndim = this->m_sysdef->getNDimensions();
 
     #ifdef ENABLE_MPI
     // compute the width of the active region
     Scalar3 npd = box.getNearestPlaneDistance();
-    Scalar3 ghost_fraction = m_nominal_width / npd;
+    Scalar frozen_width = m_ghost_aabb ? Scalar(2.0)*m_ghost_radius_max : m_nominal_width;
+    Scalar3 ghost_fraction = frozen_width / npd;
     #endif
 
     // Shuffle the order of particles for this step
@@ -539,27 +835,75 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
         m_external->compute(timestep);
         }
 
+    // acquire the arrays read by the external fields during the trial moves
+    m_external_concurrent = beginExternalMoves();
+
+    // assign particles to checkerboard cells, fall back to serial sweeps if the box is too small
+    bool checkerboard = m_checkerboard && setupCheckerboard(timestep);
+
+    // with several serial sweeps per step, compute the patch energy of each particle once and maintain it on accepted
+    // moves, so that trial moves only evaluate the energy of the new configuration
+    const bool patch = m_patch && !m_patch_log;
+    const bool patch_cache = patch && !checkerboard && m_nselect > 1;
+
+    // serial sweeps start the overlap tests of shapes that support it from the separating axis of the last test
+    const bool axis_cache = SeparatingAxis<Shape>::enabled && m_axis_cache.enabled() && !checkerboard;
+    if (patch_cache)
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+
+        // ghost particles do not move, their entries are only written to
+        m_patch_energy_cache.assign(m_pdata->getN() + m_pdata->getNGhosts(), 0.0);
+        for (unsigned int i = 0; i < m_pdata->getN(); i++)
+            {
+            m_patch_energy_cache[i] = computeParticlePatchEnergy(i, h_postype.data, h_orientation.data,
+                h_diameter.data, h_charge.data, [](unsigned int, float) { });
+            }
+        }
+
+    #ifdef ENABLE_TBB
+    tbb::enumerable_thread_specific<hpmc_counters_t> counters_thread;
+    tbb::enumerable_thread_specific< std::vector<hpmc_counters_t> > counters_type_thread(
+        std::vector<hpmc_counters_t>(m_pdata->getNTypes()));
+    #endif
+
     // access interaction matrix
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
     // loop over local particles nselect times
     for (unsigned int i_nselect = 0; i_nselect < m_nselect; i_nselect++)
         {
+        // the tree is only read during checkerboard sweeps, rebuild it to bound this sweep's trial moves
+        if (checkerboard)
+            buildCheckerboardAABBTree();
+
+        // scan the candidate lists of the particles instead of traversing the tree, when they are usable
+        const bool candidates = updateCandidateLists();
+
         // access particle data and system box
         ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
         ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
         ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        const unsigned int *tags = axis_cache ? h_tag.data : NULL;
 
         //access move sizes
         ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
         ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::read);
 
-        // loop through N particles in a shuffled order
-        for (unsigned int cur_particle = 0; cur_particle < m_pdata->getN(); cur_particle++)
-            {
-            unsigned int i = m_update_order[cur_particle];
+        // the counters by type are only tallied when the move sizes are adapted
+        ArrayHandle<hpmc_counters_t> h_count_type(m_count_type, access_location::host, access_mode::readwrite);
+        hpmc_counters_t *counters_type_total = m_tune_moves ? h_count_type.data : NULL;
 
+        // make a trial move for particle i, cell is its checkerboard cell (UINT_MAX in serial sweeps)
+        // counters_type holds the counters by type of this thread (NULL if not tallied)
+        auto trial_move = [&](unsigned int i, unsigned int cell, hpmc_counters_t& counters,
+            hpmc_counters_t *counters_type)
+            {
             // read in the current position and orientation
             Scalar4 postype_i = h_postype.data[i];
             Scalar4 orientation_i = h_orientation.data[i];
@@ -570,7 +914,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                 {
                 // only move particle if active
                 if (!isActive(make_scalar3(postype_i.x, postype_i.y, postype_i.z), box, ghost_fraction))
-                    continue;
+                    return;
                 }
             #endif
 
@@ -591,17 +935,21 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     {
                     if (!shape_i.ignoreStatistics())
                         counters.translate_accept_count++;
-                    continue;
+                    return;
                     }
 
                 move_translate(pos_i, rng_i, h_d.data[typ_i], ndim);
 
+                // in checkerboard sweeps, particles may not leave their cell
+                if (cell != UINT_MAX && getCheckerboardCell(pos_i, box) != cell)
+                    return;
+
                 #ifdef ENABLE_MPI
                 if (m_comm)
                     {
                     // check if particle has moved into the ghost layer, and skip if it is
                     if (!isActive(vec_to_scalar3(pos_i), box, ghost_fraction))
-                        continue;
+                        return;
                     }
                 #endif
                 }
@@ -611,7 +959,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                     {
                     if (!shape_i.ignoreStatistics())
                         counters.rotate_accept_count++;
-                    continue;
+                    return;
                     }
 
                 move_rotate(shape_i.orientation, rng_i, h_a.data[typ_i], ndim);
@@ -621,7 +969,7 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
             bool overlap=false;
             OverlapReal r_cut_patch = 0;
 
-            if (m_patch && !m_patch_log)
+            if (patch)
                 {
                 r_cut_patch = m_patch->getRCut() + 0.5*m_patch->getAdditiveCutoff(typ_i);
                 }
@@ -634,9 +982,34 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
             // patch + field interaction deltaU
             double patch_field_energy_diff = 0;
 
+            // patch energy of the new configuration, evaluated one packet of neighbors at a time
+            double patch_energy_new = 0.0;
+            detail::PatchEnergyPacket packet;
+            if (patch_cache)
+                m_patch_new_pairs.clear();
+
+            auto flush_packet = [&]()
+                {
+                patch_energy_new += packet.flush(m_patch.get(), typ_i, quat<float>(shape_i.orientation),
+                    h_diameter.data[i], h_charge.data[i],
+                    [&](unsigned int j, float u)
+                        {
+                        // remember the pair energies to update the neighbors if the move is accepted
+                        if (patch_cache && j != i)
+                            m_patch_new_pairs.push_back(std::make_pair(j, u));
+                        });
+                };
+
+            // without patch energies, the candidates in a leaf can be prefiltered together
+            const bool batch = OverlapBatch<Shape>::enabled && !patch;
+
+            if (candidates)
+                overlap = testOverlapCandidates(i, pos_i, shape_i, box, h_postype.data, h_orientation.data,
+                    h_overlaps.data, tags, counters);
+
             // check for overlaps with neighboring particle's positions (also calculate the new energy)
-            // All image boxes (including the primary)
-            const unsigned int n_images = m_image_list.size();
+            // All image boxes (including the primary), none are searched when the candidate lists are used
+            const unsigned int n_images = candidates ? 0 : m_image_list.size();
             for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
                 {
                 vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
@@ -646,9 +1019,14 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                 // stackless search
                 for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
                     {
-                    if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    if (m_aabb_tree.overlapNode(cur_node_idx, aabb))
                         {
-                        if (m_aabb_tree.isNodeLeaf(cur_node_idx))
+                        if (m_aabb_tree.isNodeLeaf(cur_node_idx) && batch)
+                            {
+                            overlap = testOverlapBatch(cur_node_idx, i, pos_i, pos_i_image, shape_i, cur_image == 0,
+                                h_postype.data, h_orientation.data, h_overlaps.data, tags, counters);
+                            }
+                        else if (m_aabb_tree.isNodeLeaf(cur_node_idx))
                             {
                             for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
                                 {
@@ -693,23 +1071,18 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                                 counters.overlap_checks++;
                                 if (h_overlaps.data[m_overlap_idx(typ_i, typ_j)]
                                     && check_circumsphere_overlap(r_ij, shape_i, shape_j)
-                                    && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
+                                    && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count,
+                                        tags != NULL ? &m_axis_cache.get(tags[i], tags[j]) : NULL))
                                     {
                                     overlap = true;
                                     break;
                                     }
-                                else if (m_patch && !m_patch_log && dot(r_ij,r_ij) <= rcut*rcut) // If there is no overlap and m_patch is not NULL, calculate energy
+                                else if (patch && dot(r_ij,r_ij) <= rcut*rcut) // If there is no overlap and m_patch is not NULL, calculate energy
                                     {
-                                    // deltaU = U_old - U_new: subtract energy of new configuration
-                                    patch_field_energy_diff -= m_patch->energy(r_ij, typ_i,
-                                                               quat<float>(shape_i.orientation),
-                                                               h_diameter.data[i],
-                                                               h_charge.data[i],
-                                                               typ_j,
-                                                               quat<float>(orientation_j),
-                                                               h_diameter.data[j],
-                                                               h_charge.data[j]
-                                                               );
+                                    packet.push(j, vec3<float>(r_ij), typ_j, quat<float>(orientation_j),
+                                        h_diameter.data[j], h_charge.data[j]);
+                                    if (packet.full())
+                                        flush_packet();
                                     }
                                 }
                             }
@@ -729,85 +1102,23 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                 } // end loop over images
 
             // calculate old patch energy only if m_patch not NULL and no overlaps
-            if (m_patch && !m_patch_log && !overlap)
+            if (patch && !overlap)
                 {
-                for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
-                    {
-                    vec3<Scalar> pos_i_image = pos_old + m_image_list[cur_image];
-                    detail::AABB aabb = aabb_i_local;
-                    aabb.translate(pos_i_image);
-
-                    // stackless search
-                    for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
-                        {
-                        if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
-                            {
-                            if (m_aabb_tree.isNodeLeaf(cur_node_idx))
-                                {
-                                for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                                    {
-                                    // read in its position and orientation
-                                    unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                                    Scalar4 postype_j;
-                                    Scalar4 orientation_j;
-
-                                    // handle j==i situations
-                                    if ( j != i )
-                                        {
-                                        // load the position and orientation of the j particle
-                                        postype_j = h_postype.data[j];
-                                        orientation_j = h_orientation.data[j];
-                                        }
-                                    else
-                                        {
-                                        if (cur_image == 0)
-                                            {
-                                            // in the first image, skip i == j
-                                            continue;
-                                            }
-                                        else
-                                            {
-                                            // If this is particle i and we are in an outside image, use the translated position and orientation
-                                            postype_j = make_scalar4(pos_old.x, pos_old.y, pos_old.z, postype_i.w);
-                                            orientation_j = quat_to_scalar4(shape_old.orientation);
-                                            }
-                                        }
+                flush_packet();
 
-                                    // put particles in coordinate system of particle i
-                                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
-                                    unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                    Shape shape_j(quat<Scalar>(orientation_j), m_params[typ_j]);
-
-                                    Scalar rcut = r_cut_patch + 0.5 * m_patch->getAdditiveCutoff(typ_j);
-
-                                    // deltaU = U_old - U_new: add energy of old configuration
-                                    if (dot(r_ij,r_ij) <= rcut*rcut)
-                                        patch_field_energy_diff += m_patch->energy(r_ij,
-                                                                   typ_i,
-                                                                   quat<float>(orientation_i),
-                                                                   h_diameter.data[i],
-                                                                   h_charge.data[i],
-                                                                   typ_j,
-                                                                   quat<float>(orientation_j),
-                                                                   h_diameter.data[j],
-                                                                   h_charge.data[j]);
-                                    }
-                                }
-                            }
-                        else
-                            {
-                            // skip ahead
-                            cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
-                            }
-                        }  // end loop over AABB nodes
-                    } // end loop over images
+                // deltaU = U_old - U_new
+                patch_field_energy_diff -= patch_energy_new;
+                if (patch_cache)
+                    patch_field_energy_diff += m_patch_energy_cache[i];
+                else
+                    patch_field_energy_diff += computeParticlePatchEnergy(i, h_postype.data, h_orientation.data,
+                        h_diameter.data, h_charge.data, [](unsigned int, float) { });
                 } // end if (m_patch)
 
             // Add external energetic contribution
             if (m_external)
                 {
-                patch_field_energy_diff -= m_external->energydiff(i, pos_old, shape_old, pos_i, shape_i);
+                patch_field_energy_diff -= externalEnergyDiff(i, pos_old, shape_old, pos_i, shape_i);
                 }
 
             // If no overlaps and Metropolis criterion is met, accept
@@ -821,12 +1132,35 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                         counters.translate_accept_count++;
                     else
                         counters.rotate_accept_count++;
+
+                    if (counters_type && move_type_translate)
+                        counters_type[typ_i].translate_accept_count++;
+                    else if (counters_type)
+                        counters_type[typ_i].rotate_accept_count++;
                     }
 
-                // update the position of the particle in the tree for future updates
-                detail::AABB aabb = aabb_i_local;
-                aabb.translate(pos_i);
-                m_aabb_tree.update(i, aabb);
+                if (patch_cache)
+                    {
+                    // replace the old pair energies of the neighbors with the new ones
+                    computeParticlePatchEnergy(i, h_postype.data, h_orientation.data, h_diameter.data, h_charge.data,
+                        [&](unsigned int j, float u)
+                            {
+                            if (j != i)
+                                m_patch_energy_cache[j] -= u;
+                            });
+                    for (auto& pair : m_patch_new_pairs)
+                        m_patch_energy_cache[pair.first] += pair.second;
+                    m_patch_energy_cache[i] = patch_energy_new;
+                    }
+
+                // update the position of the particle in the tree for future updates, the tree is shared
+                // between threads and bounds all trial moves in checkerboard sweeps
+                if (cell == UINT_MAX)
+                    {
+                    detail::AABB aabb = aabb_i_local;
+                    aabb.translate(pos_i);
+                    m_aabb_tree.update(i, aabb);
+                    }
 
                 // update position of particle
                 h_postype.data[i] = make_scalar4(pos_i.x,pos_i.y,pos_i.z,postype_i.w);
@@ -845,11 +1179,82 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
                         counters.translate_reject_count++;
                     else
                         counters.rotate_reject_count++;
+
+                    if (counters_type && move_type_translate)
+                        counters_type[typ_i].translate_reject_count++;
+                    else if (counters_type)
+                        counters_type[typ_i].rotate_reject_count++;
+                    }
+                }
+            };
+
+        if (!checkerboard)
+            {
+            // loop through N particles in a shuffled order
+            for (unsigned int cur_particle = 0; cur_particle < m_pdata->getN(); cur_particle++)
+                {
+                trial_move(m_update_order[cur_particle], UINT_MAX, counters_total, counters_type_total);
+                }
+            }
+        else
+            {
+            // sweep the colors in random order, the cells of one color are independent of each other
+            unsigned int n_colors = m_cb_color_cells.size();
+            std::vector<unsigned int> color_order(n_colors);
+            hoomd::detail::Saru rng_color(timestep, m_seed + i_nselect, 0x7c3b29e1);
+            for (unsigned int c = 0; c < n_colors; c++)
+                {
+                unsigned int k = rng_color.u32() % (c+1);
+                color_order[c] = color_order[k];
+                color_order[k] = c;
+                }
+
+            for (unsigned int cur_color = 0; cur_color < n_colors; cur_color++)
+                {
+                const std::vector<unsigned int>& cells = m_cb_color_cells[color_order[cur_color]];
+
+                #ifdef ENABLE_TBB
+                tbb::parallel_for((unsigned int)0, (unsigned int)cells.size(), [&](unsigned int k)
+                #else
+                for (unsigned int k = 0; k < cells.size(); k++)
+                #endif
+                    {
+                    unsigned int cell = cells[k];
+                    #ifdef ENABLE_TBB
+                    hpmc_counters_t& counters = counters_thread.local();
+                    hpmc_counters_t *counters_type = m_tune_moves ? &counters_type_thread.local().front() : NULL;
+                    #else
+                    hpmc_counters_t& counters = counters_total;
+                    hpmc_counters_t *counters_type = counters_type_total;
+                    #endif
+
+                    for (unsigned int cur_p = m_cb_cell_start[cell]; cur_p < m_cb_cell_start[cell+1]; cur_p++)
+                        {
+                        trial_move(m_cb_cell_particles[cur_p], cell, counters, counters_type);
+                        }
                     }
+                #ifdef ENABLE_TBB
+                );
+                #endif
                 }
-            } // end loop over all particles
+            }
         } // end loop over nselect
 
+    #ifdef ENABLE_TBB
+    for (auto it = counters_thread.begin(); it != counters_thread.end(); ++it)
+        counters_total = counters_total + *it;
+
+    if (m_tune_moves && !counters_type_thread.empty())
+        {
+        ArrayHandle<hpmc_counters_t> h_count_type(m_count_type, access_location::host, access_mode::readwrite);
+        for (auto it = counters_type_thread.begin(); it != counters_type_thread.end(); ++it)
+            for (unsigned int typ = 0; typ < m_pdata->getNTypes(); typ++)
+                h_count_type.data[typ] = h_count_type.data[typ] + (*it)[typ];
+        }
+    #endif
+
+    endExternalMoves();
+
         {
         ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
         ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
@@ -894,19 +1299,23 @@ void IntegratorHPMCMono<Shape>::update(unsigned int timestep)
     // migrate and exchange particles
     communicate(true);
 
-    // all particle have been moved, the aabb tree is now invalid
-    m_aabb_tree_invalid = true;
+    // all particle have been moved, the aabb tree needs to be refit
+    m_aabb_tree_stale = true;
+
+    adaptMoveSizes();
     }
 
 /*! \param timestep current step
     \param early_exit exit at first overlap found if true
     \returns number of overlaps if early_exit=false, 1 if early_exit=true
+
+    The particles are checked in parallel by TBB threads. With early_exit, all threads stop as soon as one of them
+    finds an overlap.
 */
 template <class Shape>
 unsigned int IntegratorHPMCMono<Shape>::countOverlaps(unsigned int timestep, bool early_exit)
     {
     unsigned int overlap_count = 0;
-    unsigned int err_count = 0;
 
     m_exec_conf->msg->notice(10) << "HPMCMono count overlaps: " << timestep << std::endl;
 
@@ -931,9 +1340,12 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(unsigned int timestep, boo
     // access parameters and interaction matrix
     ArrayHandle<unsigned int> h_overlaps(m_overlaps, access_location::host, access_mode::read);
 
-    // Loop over all particles
-    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+    // count the overlaps of particle i with particles of equal or larger tag
+    auto count_particle_overlaps = [&](unsigned int i)->unsigned int
         {
+        unsigned int particle_overlap_count = 0;
+        unsigned int err_count = 0;
+
         // read in the current position and orientation
         Scalar4 postype_i = h_postype.data[i];
         Scalar4 orientation_i = h_orientation.data[i];
@@ -954,7 +1366,7 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(unsigned int timestep, boo
             // stackless search
             for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
                 {
-                if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                if (m_aabb_tree.overlapNode(cur_node_idx, aabb))
                     {
                     if (m_aabb_tree.isNodeLeaf(cur_node_idx))
                         {
@@ -982,12 +1394,9 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(unsigned int timestep, boo
                                 && test_overlap(r_ij, shape_i, shape_j, err_count)
                                 && test_overlap(-r_ij, shape_j, shape_i, err_count))
                                 {
-                                overlap_count++;
+                                particle_overlap_count++;
                                 if (early_exit)
-                                    {
-                                    // exit early from loop over neighbor particles
-                                    break;
-                                    }
+                                    return particle_overlap_count;
                                 }
                             }
                         }
@@ -997,24 +1406,49 @@ unsigned int IntegratorHPMCMono<Shape>::countOverlaps(unsigned int timestep, boo
                     // skip ahead
                     cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
                     }
-
-                if (overlap_count && early_exit)
-                    {
-                    break;
-                    }
                 } // end loop over AABB nodes
+            } // end loop over images
 
-            if (overlap_count && early_exit)
+        return particle_overlap_count;
+        };
+
+    // Loop over all particles
+    #ifdef ENABLE_TBB
+    // with early_exit, the first thread to find an overlap stops all others
+    std::atomic<bool> found(false);
+    overlap_count = tbb::parallel_reduce(tbb::blocked_range<unsigned int>(0, m_pdata->getN()),
+        0u,
+        [&](const tbb::blocked_range<unsigned int>& r, unsigned int count)->unsigned int {
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+            {
+            if (early_exit && found.load(std::memory_order_relaxed))
+                break;
+
+            count += count_particle_overlaps(i);
+
+            if (early_exit && count)
                 {
+                found.store(true, std::memory_order_relaxed);
                 break;
                 }
-            } // end loop over images
+            }
+        return count;
+        },
+        [](unsigned int x, unsigned int y)->unsigned int { return x+y; } );
+
+    if (early_exit && overlap_count > 1)
+        overlap_count = 1;
+    #else
+    for (unsigned int i = 0; i < m_pdata->getN(); i++)
+        {
+        overlap_count += count_particle_overlaps(i);
 
         if (overlap_count && early_exit)
             {
             break;
             }
         } // end loop over particles
+    #endif
 
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
 
@@ -1102,7 +1536,7 @@ float IntegratorHPMCMono<Shape>::computePatchEnergy(unsigned int timestep)
             // stackless search
             for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
                 {
-                if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                if (m_aabb_tree.overlapNode(cur_node_idx, aabb))
                     {
                     if (m_aabb_tree.isNodeLeaf(cur_node_idx))
                         {
@@ -1417,6 +1851,95 @@ inline const std::vector<vec3<Scalar> >& IntegratorHPMCMono<Shape>::updateImageL
     return m_image_list;
     }
 
+#ifdef ENABLE_MPI
+/*! \returns true if the radius of any type changed
+
+    Particles near a domain boundary are frozen for a whole update(), so two particles on different ranks can only
+    overlap if their distance along the normal of the boundary is less than the sum of their extents along that
+    normal. In ghost_aabb mode, the radius of a type is the largest extent of the AABBs of its local particles along
+    the normals of the boundaries between ranks, reduced over all ranks. Types that may rotate during the update
+    (non-zero rotation move size and move_ratio below 1) keep their circumsphere radius. The ghost layer of a type is
+    its radius plus the largest radius, and the frozen boundary layer of the active region is twice the largest radius.
+
+    Patch interactions extend beyond the shapes, so all types use half the nominal width when a patch is set.
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::updateGhostRadii()
+    {
+    const unsigned int ntypes = m_pdata->getNTypes();
+    std::vector<Scalar> radius(ntypes, Scalar(0.0));
+
+    if (m_patch)
+        {
+        radius.assign(ntypes, m_nominal_width/Scalar(2.0));
+        }
+    else
+        {
+        // unit normals of the lattice planes, the ghost layer is only needed across the non-periodic directions
+        const BoxDim& box = m_pdata->getBox();
+        vec3<Scalar> a1(box.getLatticeVector(0));
+        vec3<Scalar> a2(box.getLatticeVector(1));
+        vec3<Scalar> a3(box.getLatticeVector(2));
+        vec3<Scalar> normal[3] = {cross(a2,a3), cross(a3,a1), cross(a1,a2)};
+        uchar3 periodic = box.getPeriodic();
+        bool split[3] = {!periodic.x, !periodic.y, !periodic.z && m_sysdef->getNDimensions() == 3};
+        for (unsigned int dir = 0; dir < 3; ++dir)
+            normal[dir] = normal[dir] / Scalar(sqrt(dot(normal[dir], normal[dir])));
+
+        ArrayHandle<Scalar> h_a(m_a, access_location::host, access_mode::read);
+        std::vector<unsigned int> rotates(ntypes, 0);
+        for (unsigned int typ = 0; typ < ntypes; ++typ)
+            {
+            Shape shape(quat<Scalar>(), m_params[typ]);
+            if (shape.hasOrientation() && h_a.data[typ] > Scalar(0.0) && m_move_ratio < 65536)
+                {
+                rotates[typ] = 1;
+                radius[typ] = shape.getCircumsphereDiameter()/Scalar(2.0);
+                }
+            }
+
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        for (unsigned int i = 0; i < m_pdata->getN(); i++)
+            {
+            unsigned int typ = __scalar_as_int(h_postype.data[i].w);
+            if (rotates[typ])
+                continue;
+
+            // half extents of the AABB about the particle position
+            Shape shape(quat<Scalar>(h_orientation.data[i]), m_params[typ]);
+            detail::AABB aabb = shape.getAABB(vec3<Scalar>(0,0,0));
+            vec3<Scalar> lower = aabb.getLower();
+            vec3<Scalar> upper = aabb.getUpper();
+            vec3<Scalar> e(std::max(fabs(lower.x), fabs(upper.x)),
+                           std::max(fabs(lower.y), fabs(upper.y)),
+                           std::max(fabs(lower.z), fabs(upper.z)));
+
+            Scalar r = Scalar(0.0);
+            for (unsigned int dir = 0; dir < 3; ++dir)
+                {
+                if (split[dir])
+                    r = std::max(r, fabs(normal[dir].x)*e.x + fabs(normal[dir].y)*e.y + fabs(normal[dir].z)*e.z);
+                }
+
+            // the AABB may be looser than the circumsphere along oblique normals
+            r = std::min(r, Scalar(shape.getCircumsphereDiameter())/Scalar(2.0));
+            radius[typ] = std::max(radius[typ], r);
+            }
+        }
+
+    MPI_Allreduce(MPI_IN_PLACE, &radius.front(), ntypes, MPI_HOOMD_SCALAR, MPI_MAX, m_exec_conf->getMPICommunicator());
+
+    bool changed = (radius != m_ghost_radius);
+    m_ghost_radius.swap(radius);
+    m_ghost_radius_max = *std::max_element(m_ghost_radius.begin(), m_ghost_radius.end());
+
+    m_exec_conf->msg->notice(9) << "IntegratorHPMCMono: frozen boundary layer width " << Scalar(2.0)*m_ghost_radius_max
+                                << std::endl;
+    return changed;
+    }
+#endif
+
 template <class Shape>
 void IntegratorHPMCMono<Shape>::updateCellWidth()
     {
@@ -1437,6 +1960,7 @@ void IntegratorHPMCMono<Shape>::updateCellWidth()
     // image list and aabb tree
     m_image_list_valid = false;
     m_aabb_tree_invalid = true;
+    m_cand_valid = false;
     }
 
 template <class Shape>
@@ -1458,16 +1982,85 @@ void IntegratorHPMCMono<Shape>::growAABBList(unsigned int N)
     }
 
 
-/*! Call any time an up to date AABB tree is needed. IntegratorHPMCMono internally tracks whether
-    the tree needs to be rebuilt or if the current tree can be used.
+/*! Compute the AABBs of all local and ghost particles into m_aabbs
+    \returns The number of AABBs
+*/
+template <class Shape>
+unsigned int IntegratorHPMCMono<Shape>::computeAABBs()
+    {
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
 
-    buildAABBTree() relies on the member variable m_aabb_tree_invalid to work correctly. Any time particles
-    are moved (and not updated with m_aabb_tree->update()) or the particle list changes order, m_aabb_tree_invalid
-    needs to be set to true. Then buildAABBTree() will know to rebuild the tree from scratch on the next call. Typically
-    this is on the next timestep. But in some cases (i.e. NPT), the tree may need to be rebuilt several times in a
-    single step because of box volume moves.
+    // grow the AABB list to the needed size
+    unsigned int n_aabb = m_pdata->getN()+m_pdata->getNGhosts();
+    if (n_aabb > 0)
+        {
+        growAABBList(n_aabb);
+        for (unsigned int i = 0; i < n_aabb; i++)
+            m_aabbs[i] = computeAABB(h_postype.data[i], h_orientation.data[i]);
+        }
+    return n_aabb;
+    }
+
+/*! \param postype Position and type of the particle
+    \param orientation Orientation of the particle
+    \returns The AABB of the particle, enlarged to the patch interaction range if needed
+*/
+template <class Shape>
+detail::AABB IntegratorHPMCMono<Shape>::computeAABB(const Scalar4& postype, const Scalar4& orientation)
+    {
+    unsigned int typ_i = __scalar_as_int(postype.w);
+    Shape shape(quat<Scalar>(orientation), m_params[typ_i]);
+
+    if (!this->m_patch)
+        return shape.getAABB(vec3<Scalar>(postype));
+
+    Scalar radius = std::max(0.5*shape.getCircumsphereDiameter(),
+        0.5*this->m_patch->getAdditiveCutoff(typ_i));
+    return detail::AABB(vec3<Scalar>(postype), radius);
+    }
 
-    Subclasses that override update() or other methods must be user to set m_aabb_tree_invalid appropriately, or
+/*! \param idx Index of the new particle, the last in the particle data
+
+    Call only if canUpdateAABBTree() was true before the particle was added. The particle is inserted into a leaf node
+    if one has room, and the tree is marked valid again. Otherwise, it is rebuilt on the next call to buildAABBTree().
+*/
+template <class Shape>
+void IntegratorHPMCMono<Shape>::insertAABBTreeParticle(unsigned int idx)
+    {
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+
+    if (m_aabb_tree.insert(idx, computeAABB(h_postype.data[idx], h_orientation.data[idx])))
+        m_aabb_tree_invalid = false;
+    }
+
+/*! \param idx Index the removed particle had
+
+    Call only if canUpdateAABBTree() was true before the particle was removed.
+*/
+template <class Shape>
+void IntegratorHPMCMono<Shape>::removeAABBTreeParticle(unsigned int idx)
+    {
+    m_aabb_tree.remove(idx);
+    m_aabb_tree_invalid = false;
+    }
+
+/*! \param Does nothing if the AABB tree is up to date.
+
+    buildAABBTree() relies on the member variables m_aabb_tree_invalid and m_aabb_tree_stale to work correctly.
+
+    Any time particles are moved (and not updated with m_aabb_tree->update()), m_aabb_tree_stale needs to be set to
+    true. buildAABBTree() then refits the node AABBs to the new particle AABBs without changing the tree topology.
+    The tree is rebuilt instead when its summed node surface area has grown by more than m_aabb_refit_threshold since
+    the last full build, because the sloppier nodes make every query more expensive.
+
+    Any time the particle list changes order, particles are added or removed, or the ghost particles are exchanged,
+    m_aabb_tree_invalid needs to be set to true. Then buildAABBTree() will rebuild the tree from scratch on the next
+    call. Typically this is on the next timestep. But in some cases (i.e. NPT), the tree may need to be updated several
+    times in a single step because of box volume moves.
+
+    Subclasses that override update() or other methods must be sure to set these flags appropriately, or
     erroneous simulations will result.
 
     \returns A reference to the tree.
@@ -1475,44 +2068,642 @@ void IntegratorHPMCMono<Shape>::growAABBList(unsigned int N)
 template <class Shape>
 const detail::AABBTree& IntegratorHPMCMono<Shape>::buildAABBTree()
     {
+    if (!m_aabb_tree_invalid && m_aabb_tree_stale)
+        {
+        if (m_aabb_refit_threshold <= Scalar(1.0) ||
+            m_aabb_tree.getNumParticles() != m_pdata->getN()+m_pdata->getNGhosts())
+            {
+            m_aabb_tree_invalid = true;
+            }
+        else
+            {
+            if (this->m_prof) this->m_prof->push(this->m_exec_conf, "AABB tree refit");
+
+            unsigned int n_aabb = computeAABBs();
+            m_aabb_tree.refit(m_aabbs, n_aabb);
+
+            // rebuild if the tree quality has degraded too much
+            if (m_aabb_tree.getSurfaceArea() > m_aabb_refit_threshold*m_aabb_tree_build_area)
+                m_aabb_tree_invalid = true;
+
+            if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+            }
+        }
+
     if (m_aabb_tree_invalid)
         {
         m_exec_conf->msg->notice(8) << "Building AABB tree: " << m_pdata->getN() << " ptls " << m_pdata->getNGhosts() << " ghosts" << std::endl;
         if (this->m_prof) this->m_prof->push(this->m_exec_conf, "AABB tree build");
+
         // build the AABB tree
+        unsigned int n_aabb = computeAABBs();
+        if (n_aabb > 0)
             {
-            ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
-            ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+            m_aabb_tree.buildTree(m_aabbs, n_aabb);
+            m_aabb_tree_build_area = m_aabb_tree.getSurfaceArea();
+            }
+
+        if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+        }
+
+    m_aabb_tree_invalid = false;
+    m_aabb_tree_stale = false;
+    return m_aabb_tree;
+    }
+
+/*! \param i Index of the particle
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
+    \param h_diameter Particle diameters
+    \param h_charge Particle charges
+    \param f Called as f(j, u) with the energy u of each pair, pairs of i with its own images are reported with j == i
+    \returns The patch energy of particle i with all of its neighbors in the configuration stored in the arrays
+*/
+template <class Shape>
+template <class Callback>
+double IntegratorHPMCMono<Shape>::computeParticlePatchEnergy(unsigned int i,
+                                                             const Scalar4 *h_postype,
+                                                             const Scalar4 *h_orientation,
+                                                             const Scalar *h_diameter,
+                                                             const Scalar *h_charge,
+                                                             const Callback& f)
+    {
+    Scalar4 postype_i = h_postype[i];
+    Scalar4 orientation_i = h_orientation[i];
+    unsigned int typ_i = __scalar_as_int(postype_i.w);
+    Shape shape_i(quat<Scalar>(orientation_i), m_params[typ_i]);
+    vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+
+    OverlapReal r_cut_patch = m_patch->getRCut() + 0.5*m_patch->getAdditiveCutoff(typ_i);
 
-            // grow the AABB list to the needed size
-            unsigned int n_aabb = m_pdata->getN()+m_pdata->getNGhosts();
-            if (n_aabb > 0)
+    // subtract minimum AABB extent from search radius
+    OverlapReal R_query = std::max(shape_i.getCircumsphereDiameter()/OverlapReal(2.0),
+        r_cut_patch-getMinCoreDiameter()/(OverlapReal)2.0);
+    detail::AABB aabb_i_local = detail::AABB(vec3<Scalar>(0,0,0),R_query);
+
+    double energy = 0.0;
+    detail::PatchEnergyPacket packet;
+
+    const unsigned int n_images = m_image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + m_image_list[cur_image];
+        detail::AABB aabb = aabb_i_local;
+        aabb.translate(pos_i_image);
+
+        // stackless search
+        for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+            {
+            if (m_aabb_tree.overlapNode(cur_node_idx, aabb))
                 {
-                growAABBList(n_aabb);
-                for (unsigned int cur_particle = 0; cur_particle < n_aabb; cur_particle++)
+                if (m_aabb_tree.isNodeLeaf(cur_node_idx))
                     {
-                    unsigned int i = cur_particle;
-                    unsigned int typ_i = __scalar_as_int(h_postype.data[i].w);
-                    Shape shape(quat<Scalar>(h_orientation.data[i]), m_params[typ_i]);
+                    for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        {
+                        unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
 
-                    if (!this->m_patch)
-                        m_aabbs[i] = shape.getAABB(vec3<Scalar>(h_postype.data[i]));
-                    else
+                        // in the first image, skip i == j
+                        if (cur_image == 0 && j == i)
+                            continue;
+
+                        // put particles in coordinate system of particle i
+                        Scalar4 postype_j = h_postype[j];
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+
+                        Scalar rcut = r_cut_patch + 0.5 * m_patch->getAdditiveCutoff(typ_j);
+                        if (dot(r_ij,r_ij) <= rcut*rcut)
+                            {
+                            packet.push(j, vec3<float>(r_ij), typ_j, quat<float>(h_orientation[j]), h_diameter[j],
+                                h_charge[j]);
+                            if (packet.full())
+                                energy += packet.flush(m_patch.get(), typ_i, quat<float>(orientation_i),
+                                    h_diameter[i], h_charge[i], f);
+                            }
+                        }
+                    }
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            }  // end loop over AABB nodes
+        } // end loop over images
+
+    energy += packet.flush(m_patch.get(), typ_i, quat<float>(orientation_i), h_diameter[i], h_charge[i], f);
+    return energy;
+    }
+
+/*! \param node Index of the leaf node
+    \param i Index of the particle that is moved
+    \param pos_i Trial position of particle i
+    \param pos_i_image Trial position of particle i in the current image
+    \param shape_i Trial shape of particle i
+    \param primary_image True if this is the primary image, where particle i is not tested against itself
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
+    \param h_overlaps Interaction matrix
+    \param h_tag Particle tags to look up the cached separating axes, NULL if the cache is not used
+    \param counters Counters to increment
+    \returns true if the trial move overlaps any particle in the node
+
+    The separations and circumsphere radii of all candidates in the node are gathered into arrays first and tested in
+    one vectorizable loop (see OverlapBatch). Only the candidates that pass are tested with test_overlap().
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::testOverlapBatch(unsigned int node,
+                                                 unsigned int i,
+                                                 const vec3<Scalar>& pos_i,
+                                                 const vec3<Scalar>& pos_i_image,
+                                                 const Shape& shape_i,
+                                                 bool primary_image,
+                                                 const Scalar4 *h_postype,
+                                                 const Scalar4 *h_orientation,
+                                                 const unsigned int *h_overlaps,
+                                                 const unsigned int *h_tag,
+                                                 hpmc_counters_t& counters)
+    {
+    OverlapReal dx[detail::NODE_CAPACITY];
+    OverlapReal dy[detail::NODE_CAPACITY];
+    OverlapReal dz[detail::NODE_CAPACITY];
+    OverlapReal R[detail::NODE_CAPACITY];
+    unsigned int hit[detail::NODE_CAPACITY];
+    unsigned int idx[detail::NODE_CAPACITY];
+
+    unsigned int typ_i = __scalar_as_int(h_postype[i].w);
+    OverlapReal R_i = shape_i.getCircumsphereDiameter()/OverlapReal(2.0);
+
+    // gather the candidates
+    unsigned int n = 0;
+    for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(node); cur_p++)
+        {
+        unsigned int j = m_aabb_tree.getNodeParticle(node, cur_p);
+
+        // in the first image, skip i == j, otherwise test against the trial position
+        if (j == i && primary_image)
+            continue;
+
+        vec3<Scalar> pos_j = (j == i) ? pos_i : vec3<Scalar>(h_postype[j]);
+        unsigned int typ_j = __scalar_as_int(h_postype[j].w);
+
+        counters.overlap_checks++;
+        if (!h_overlaps[m_overlap_idx(typ_i, typ_j)])
+            continue;
+
+        vec3<Scalar> r_ij = pos_j - pos_i_image;
+        Shape shape_j(quat<Scalar>(), m_params[typ_j]);
+        dx[n] = r_ij.x;
+        dy[n] = r_ij.y;
+        dz[n] = r_ij.z;
+        R[n] = R_i + shape_j.getCircumsphereDiameter()/OverlapReal(2.0);
+        idx[n] = j;
+        n++;
+        }
+
+    detail::test_circumsphere_batch<OverlapBatch<Shape>::exact>(n, dx, dy, dz, R, hit);
+
+    // run the full overlap test on the remaining candidates
+    for (unsigned int k = 0; k < n; k++)
+        {
+        if (!hit[k])
+            continue;
+
+        if (OverlapBatch<Shape>::exact)
+            return true;
+
+        unsigned int j = idx[k];
+        vec3<Scalar> pos_j = (j == i) ? pos_i : vec3<Scalar>(h_postype[j]);
+        quat<Scalar> orientation_j = (j == i) ? shape_i.orientation : quat<Scalar>(h_orientation[j]);
+        Shape shape_j(orientation_j, m_params[__scalar_as_int(h_postype[j].w)]);
+
+        if (test_overlap(pos_j - pos_i_image, shape_i, shape_j, counters.overlap_err_count,
+                h_tag != NULL ? &m_axis_cache.get(h_tag[i], h_tag[j]) : NULL))
+            return true;
+        }
+
+    return false;
+    }
+
+/*! The candidate list of a particle holds all particles whose circumspheres were closer than the skin at the last
+    build. In one sweep, each particle makes at most one trial move and is displaced by at most the largest move size.
+    The lists therefore remain complete for the next sweep while twice the sum of the largest displacement since the
+    build and the largest move size does not exceed the skin. Otherwise, or when the particle tags and types have
+    changed, the lists are rebuilt from the AABB tree.
+
+    The candidates are stored without their periodic image, the separations are computed as minimum images. The lists
+    are not used when the box is too small for the minimum image to be unique within the list range, with MPI domain
+    decomposition or with patch energies, or when the skin is smaller than twice the largest move size.
+
+    \returns true if the candidate lists are valid for the next sweep
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::updateCandidateLists()
+    {
+    if (m_cand_skin <= Scalar(0.0) || (m_patch && !m_patch_log))
+        return false;
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        return false;
+    #endif
+
+    const BoxDim& box = m_pdata->getBox();
+    const unsigned int ndim = this->m_sysdef->getNDimensions();
+    const unsigned int N = m_pdata->getN();
+    const Scalar R_max = getMaxCoreDiameter()/Scalar(2.0);
+
+    Scalar d_max = 0.0;
+        {
+        ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
+        for (unsigned int typ = 0; typ < m_pdata->getNTypes(); typ++)
+            d_max = std::max(d_max, h_d.data[typ]);
+        }
+
+    if (Scalar(2.0)*d_max > m_cand_skin)
+        return false;
+
+    // the minimum image must be unique within the range of the lists
+    const Scalar r_list = Scalar(2.0)*R_max + m_cand_skin;
+    Scalar3 npd = box.getNearestPlaneDistance();
+    if (npd.x < Scalar(2.0)*r_list || npd.y < Scalar(2.0)*r_list || (ndim == 3 && npd.z < Scalar(2.0)*r_list))
+        return false;
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+    if (m_cand_valid && m_cand_tag.size() == N)
+        {
+        Scalar disp_max_sq = 0.0;
+        for (unsigned int i = 0; i < N; i++)
+            {
+            if (h_tag.data[i] != m_cand_tag[i] || (unsigned int)__scalar_as_int(h_postype.data[i].w) != m_cand_type[i])
+                {
+                m_cand_valid = false;
+                break;
+                }
+            vec3<Scalar> dr = vec3<Scalar>(box.minImage(vec_to_scalar3(vec3<Scalar>(h_postype.data[i]) - m_cand_pos[i])));
+            disp_max_sq = std::max(disp_max_sq, dot(dr, dr));
+            }
+
+        if (m_cand_valid && Scalar(2.0)*(sqrt(disp_max_sq) + d_max) <= m_cand_skin)
+            return true;
+        }
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC candidate lists");
+
+    // the particles may have left the box during the sweeps, search the neighboring images
+    std::vector< vec3<Scalar> > images;
+    const vec3<Scalar> a1(box.getLatticeVector(0));
+    const vec3<Scalar> a2(box.getLatticeVector(1));
+    const vec3<Scalar> a3(box.getLatticeVector(2));
+    const int l_max = (ndim == 3) ? 1 : 0;
+    for (int h = -1; h <= 1; h++)
+        for (int k = -1; k <= 1; k++)
+            for (int l = -l_max; l <= l_max; l++)
+                images.push_back(Scalar(h)*a1 + Scalar(k)*a2 + Scalar(l)*a3);
+
+    m_cand_head.resize(N+1);
+    m_cand_pos.resize(N);
+    m_cand_tag.resize(N);
+    m_cand_type.resize(N);
+    m_cand_list.clear();
+
+    bool usable = true;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        vec3<Scalar> pos_i(h_postype.data[i]);
+        unsigned int typ_i = __scalar_as_int(h_postype.data[i].w);
+        Shape shape_i(quat<Scalar>(), m_params[typ_i]);
+        Scalar R_i = shape_i.getCircumsphereDiameter()/Scalar(2.0);
+
+        // the neighboring images only cover particles that are less than a quarter box outside of it
+        vec3<Scalar> f = box.makeFraction(pos_i);
+        if (f.x < Scalar(-0.25) || f.x > Scalar(1.25) || f.y < Scalar(-0.25) || f.y > Scalar(1.25)
+            || (ndim == 3 && (f.z < Scalar(-0.25) || f.z > Scalar(1.25))))
+            {
+            usable = false;
+            break;
+            }
+
+        m_cand_head[i] = m_cand_list.size();
+        m_cand_pos[i] = pos_i;
+        m_cand_tag[i] = h_tag.data[i];
+        m_cand_type[i] = typ_i;
+
+        // the AABB of a candidate lies within its circumsphere, but need not contain its center
+        detail::AABB aabb_i_local(vec3<Scalar>(0,0,0), R_i + Scalar(2.0)*R_max + m_cand_skin);
+        for (unsigned int cur_image = 0; cur_image < images.size(); cur_image++)
+            {
+            vec3<Scalar> pos_i_image = pos_i + images[cur_image];
+            detail::AABB aabb = aabb_i_local;
+            aabb.translate(pos_i_image);
+
+            for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
+                {
+                if (m_aabb_tree.overlapNode(cur_node_idx, aabb))
+                    {
+                    if (m_aabb_tree.isNodeLeaf(cur_node_idx))
                         {
-                        Scalar radius = std::max(0.5*shape.getCircumsphereDiameter(),
-                            0.5*this->m_patch->getAdditiveCutoff(typ_i));
-                        m_aabbs[i] = detail::AABB(vec3<Scalar>(h_postype.data[i]), radius);
+                        for (unsigned int cur_p = 0; cur_p < m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                            {
+                            unsigned int j = m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                            if (j == i)
+                                continue;
+
+                            vec3<Scalar> r_ij = vec3<Scalar>(h_postype.data[j]) - pos_i_image;
+                            Shape shape_j(quat<Scalar>(), m_params[__scalar_as_int(h_postype.data[j].w)]);
+                            Scalar r_cut = R_i + shape_j.getCircumsphereDiameter()/Scalar(2.0) + m_cand_skin;
+                            if (dot(r_ij, r_ij) <= r_cut*r_cut)
+                                m_cand_list.push_back(j);
+                            }
                         }
                     }
-                m_aabb_tree.buildTree(m_aabbs, n_aabb);
+                else
+                    {
+                    // skip ahead
+                    cur_node_idx += m_aabb_tree.getNodeSkip(cur_node_idx);
+                    }
                 }
             }
+        }
+    m_cand_head[N] = m_cand_list.size();
 
-        if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+    m_cand_valid = usable;
+    if (usable)
+        m_cand_builds++;
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    return usable;
+    }
+
+/*! \param i Index of the particle that is moved
+    \param pos_i Trial position of particle i
+    \param shape_i Trial shape of particle i
+    \param box Local simulation box
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
+    \param h_overlaps Interaction matrix
+    \param h_tag Particle tags to look up the cached separating axes, NULL if the cache is not used
+    \param counters Counters to increment
+    \returns true if the trial move overlaps any candidate of particle i
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::testOverlapCandidates(unsigned int i,
+                                                      const vec3<Scalar>& pos_i,
+                                                      const Shape& shape_i,
+                                                      const BoxDim& box,
+                                                      const Scalar4 *h_postype,
+                                                      const Scalar4 *h_orientation,
+                                                      const unsigned int *h_overlaps,
+                                                      const unsigned int *h_tag,
+                                                      hpmc_counters_t& counters)
+    {
+    unsigned int typ_i = __scalar_as_int(h_postype[i].w);
+    for (unsigned int k = m_cand_head[i]; k < m_cand_head[i+1]; k++)
+        {
+        unsigned int j = m_cand_list[k];
+        Scalar4 postype_j = h_postype[j];
+        unsigned int typ_j = __scalar_as_int(postype_j.w);
+
+        counters.overlap_checks++;
+        if (!h_overlaps[m_overlap_idx(typ_i, typ_j)])
+            continue;
+
+        vec3<Scalar> r_ij = vec3<Scalar>(box.minImage(vec_to_scalar3(vec3<Scalar>(postype_j) - pos_i)));
+        Shape shape_j(quat<Scalar>(h_orientation[j]), m_params[typ_j]);
+        if (check_circumsphere_overlap(r_ij, shape_i, shape_j)
+            && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count,
+                h_tag != NULL ? &m_axis_cache.get(h_tag[i], h_tag[j]) : NULL))
+            return true;
         }
 
-    m_aabb_tree_invalid = false;
-    return m_aabb_tree;
+    return false;
+    }
+
+/*! Composite fields are flattened into the lattice fields, which are evaluated without virtual dispatch, and all other
+    fields. Every field acquires the arrays it reads for the duration of the sweeps.
+
+    \returns true if the external fields may be evaluated concurrently in checkerboard sweeps
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::beginExternalMoves()
+    {
+    m_external_lattice.clear();
+    m_external_other.clear();
+    if (!m_external)
+        return true;
+
+    addExternalFields(m_external.get());
+
+    bool concurrent = true;
+    for (auto external : m_external_lattice)
+        concurrent = external->beginMoves() && concurrent;
+    for (auto external : m_external_other)
+        concurrent = external->beginMoves() && concurrent;
+    return concurrent;
+    }
+
+/*! \param external External field, composite fields are added recursively
+*/
+template <class Shape>
+void IntegratorHPMCMono<Shape>::addExternalFields(ExternalFieldMono<Shape> *external)
+    {
+    if (auto composite = dynamic_cast< ExternalFieldMonoComposite<Shape>* >(external))
+        {
+        for (auto& field : composite->getExternals())
+            addExternalFields(field.get());
+        }
+    else if (auto lattice = dynamic_cast< ExternalFieldLattice<Shape>* >(external))
+        {
+        m_external_lattice.push_back(lattice);
+        }
+    else
+        {
+        m_external_other.push_back(external);
+        }
+    }
+
+template <class Shape>
+void IntegratorHPMCMono<Shape>::endExternalMoves()
+    {
+    for (auto external : m_external_lattice)
+        external->endMoves();
+    for (auto external : m_external_other)
+        external->endMoves();
+    m_external_lattice.clear();
+    m_external_other.clear();
+    }
+
+/*! \param i Index of the particle
+    \param pos_old Old position
+    \param shape_old Old shape
+    \param pos_new Trial position
+    \param shape_new Trial shape
+    \returns The energy difference U_new - U_old of all fields collected in beginExternalMoves()
+*/
+template <class Shape>
+inline double IntegratorHPMCMono<Shape>::externalEnergyDiff(unsigned int i,
+                                                            const vec3<Scalar>& pos_old,
+                                                            const Shape& shape_old,
+                                                            const vec3<Scalar>& pos_new,
+                                                            const Shape& shape_new)
+    {
+    double energy = 0.0;
+    for (auto external : m_external_lattice)
+        energy += external->energydiff(i, pos_old, shape_old, pos_new, shape_new);
+    for (auto external : m_external_other)
+        energy += external->energydiff(i, pos_old, shape_old, pos_new, shape_new);
+    return energy;
+    }
+
+/*! In checkerboard mode, the local box is divided into cells that are wider than the interaction range plus the
+    largest trial move. Cells are colored in a 2x2x2 (2x2 in 2D) pattern, so that no two cells of the same color
+    interact as long as particles stay within their own cell. The cells of one color are then swept by TBB threads
+    concurrently, and trial moves that leave the cell are skipped. A random shift of the cell grid each step keeps the
+    combined moves ergodic, and each cell sweep individually satisfies detailed balance.
+
+    \param timestep Current time step
+    \returns false if the box is too small for an even number of at least two cells in each direction, or the
+             external field cannot be evaluated concurrently
+*/
+template <class Shape>
+bool IntegratorHPMCMono<Shape>::setupCheckerboard(unsigned int timestep)
+    {
+    // external fields may access particle data arrays or call into python
+    if (m_external && !m_external_concurrent)
+        {
+        m_exec_conf->msg->notice(10) << "HPMCMono update: checkerboard sweeps disabled with this external field" << std::endl;
+        return false;
+        }
+
+    const BoxDim& box = m_pdata->getBox();
+    unsigned int ndim = this->m_sysdef->getNDimensions();
+
+    Scalar max_d(0.0);
+        {
+        ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
+        for (unsigned int typ = 0; typ < m_pdata->getNTypes(); typ++)
+            max_d = std::max(max_d, h_d.data[typ]);
+        }
+
+    // an even number of cells keeps the coloring consistent across periodic boundaries
+    Scalar width = m_nominal_width + max_d;
+    Scalar3 npd = box.getNearestPlaneDistance();
+    uint3 dim = make_uint3(npd.x/width, npd.y/width, npd.z/width);
+    dim.x -= dim.x % 2;
+    dim.y -= dim.y % 2;
+    dim.z = (ndim == 2) ? 1 : dim.z - dim.z % 2;
+
+    if (dim.x < 2 || dim.y < 2 || dim.z < 1 || (ndim == 3 && dim.z < 2))
+        {
+        m_exec_conf->msg->notice(10) << "HPMCMono update: box too small for checkerboard sweeps" << std::endl;
+        return false;
+        }
+
+    m_cb_indexer = Index3D(dim.x, dim.y, dim.z);
+
+    hoomd::detail::Saru rng(timestep, m_seed, 0x5d2a9c40);
+    m_cb_shift.x = rng.s(Scalar(0.0), Scalar(1.0));
+    m_cb_shift.y = rng.s(Scalar(0.0), Scalar(1.0));
+    m_cb_shift.z = (ndim == 3) ? rng.s(Scalar(0.0), Scalar(1.0)) : Scalar(0.0);
+
+    // group the particles by cell, keeping the update order within each cell
+    unsigned int n_cells = m_cb_indexer.getNumElements();
+    unsigned int N = m_pdata->getN();
+    std::vector<unsigned int> cell_of(N);
+    m_cb_cell_start.assign(n_cells+1, 0);
+    m_cb_cell_particles.resize(N);
+
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+        for (unsigned int cur_particle = 0; cur_particle < N; cur_particle++)
+            {
+            unsigned int i = m_update_order[cur_particle];
+            cell_of[cur_particle] = getCheckerboardCell(vec3<Scalar>(h_postype.data[i]), box);
+            m_cb_cell_start[cell_of[cur_particle]+1]++;
+            }
+        }
+
+    for (unsigned int cell = 0; cell < n_cells; cell++)
+        m_cb_cell_start[cell+1] += m_cb_cell_start[cell];
+
+    std::vector<unsigned int> fill(m_cb_cell_start.begin(), m_cb_cell_start.end()-1);
+    for (unsigned int cur_particle = 0; cur_particle < N; cur_particle++)
+        m_cb_cell_particles[fill[cell_of[cur_particle]]++] = m_update_order[cur_particle];
+
+    // sort the non-empty cells by color
+    m_cb_color_cells.assign((ndim == 2) ? 4 : 8, std::vector<unsigned int>());
+    for (unsigned int k = 0; k < dim.z; k++)
+        for (unsigned int j = 0; j < dim.y; j++)
+            for (unsigned int i = 0; i < dim.x; i++)
+                {
+                unsigned int cell = m_cb_indexer(i,j,k);
+                if (m_cb_cell_start[cell+1] > m_cb_cell_start[cell])
+                    m_cb_color_cells[(i % 2) + 2*(j % 2) + 4*(k % 2)].push_back(cell);
+                }
+
+    return true;
+    }
+
+/*! \param pos Position of the particle
+    \param box Local simulation box
+    \returns Index of the checkerboard cell, particles outside the box are wrapped into it
+*/
+template <class Shape>
+unsigned int IntegratorHPMCMono<Shape>::getCheckerboardCell(const vec3<Scalar>& pos, const BoxDim& box) const
+    {
+    Scalar3 f = box.makeFraction(vec_to_scalar3(pos)) + m_cb_shift;
+    f.x -= floor(f.x);
+    f.y -= floor(f.y);
+    f.z -= floor(f.z);
+
+    unsigned int i = std::min((unsigned int)(f.x*m_cb_indexer.getW()), m_cb_indexer.getW()-1);
+    unsigned int j = std::min((unsigned int)(f.y*m_cb_indexer.getH()), m_cb_indexer.getH()-1);
+    unsigned int k = std::min((unsigned int)(f.z*m_cb_indexer.getD()), m_cb_indexer.getD()-1);
+    return m_cb_indexer(i,j,k);
+    }
+
+/*! Checkerboard sweeps share one AABB tree between threads and cannot update it after accepted moves. Instead, the
+    AABB of every local particle is extended by its maximum trial move so that the tree remains valid for one sweep.
+    The tree is marked invalid, so that other users rebuild the tight tree.
+*/
+template <class Shape>
+void IntegratorHPMCMono<Shape>::buildCheckerboardAABBTree()
+    {
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "AABB tree build");
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_d(m_d, access_location::host, access_mode::read);
+
+    unsigned int n_aabb = m_pdata->getN()+m_pdata->getNGhosts();
+    if (n_aabb > 0)
+        {
+        growAABBList(n_aabb);
+        for (unsigned int i = 0; i < n_aabb; i++)
+            {
+            unsigned int typ_i = __scalar_as_int(h_postype.data[i].w);
+            Shape shape(quat<Scalar>(h_orientation.data[i]), m_params[typ_i]);
+
+            // the circumsphere bounds all rotation moves
+            Scalar radius = 0.5*shape.getCircumsphereDiameter();
+            if (this->m_patch)
+                radius = std::max(radius, 0.5*this->m_patch->getAdditiveCutoff(typ_i));
+
+            // ghost particles are not moved
+            if (i < m_pdata->getN())
+                radius += h_d.data[typ_i];
+
+            m_aabbs[i] = detail::AABB(vec3<Scalar>(h_postype.data[i]), radius);
+            }
+        m_aabb_tree.buildTree(m_aabbs, n_aabb);
+        }
+
+    m_aabb_tree_invalid = true;
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
     }
 
 /*! Call to reduce the m_d values down to safe levels for the bvh tree + small box limitations. That code path
@@ -1604,7 +2795,7 @@ std::vector<bool> IntegratorHPMCMono<Shape>::mapOverlaps()
             // stackless search
             for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree.getNumNodes(); cur_node_idx++)
                 {
-                if (detail::overlap(m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                if (m_aabb_tree.overlapNode(cur_node_idx, aabb))
                     {
                     if (m_aabb_tree.isNodeLeaf(cur_node_idx))
                         {
@@ -1803,6 +2994,10 @@ template < class Shape > void export_IntegratorHPMCMono(pybind11::module& m, con
           .def("connectGSDSignal", &IntegratorHPMCMono<Shape>::connectGSDSignal)
           .def("restoreStateGSD", &IntegratorHPMCMono<Shape>::restoreStateGSD)
           .def("py_test_overlap", &IntegratorHPMCMono<Shape>::py_test_overlap)
+          .def("setAABBRefitThreshold", &IntegratorHPMCMono<Shape>::setAABBRefitThreshold)
+          .def("setAxisCacheSize", &IntegratorHPMCMono<Shape>::setAxisCacheSize)
+          .def("setCandidateSkin", &IntegratorHPMCMono<Shape>::setCandidateSkin)
+          .def("getCandidateListBuilds", &IntegratorHPMCMono<Shape>::getCandidateListBuilds)
           ;
     }
 
@@ -0,0 +1,582 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __HPMC_MONO_EC__H__
+#define __HPMC_MONO_EC__H__
+
+#include "IntegratorHPMCMono.h"
+#include "SweepDistance.h"
+
+#include <algorithm>
+
+/*! \file IntegratorHPMCMonoEC.h
+    \brief Defines the template class for event-chain Monte Carlo of hard shapes
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+namespace hpmc
+{
+
+//! Template class for event-chain Monte Carlo of hard shapes
+/*! Translations are made by event chains instead of local trial moves. A chain starts at a randomly chosen
+    particle, which moves along the chain direction until it collides with another particle. The collided particle
+    then continues the chain for the remaining chain length, and so on until the total displacement of the chain
+    equals the chain length. No move is ever rejected.
+
+    In straight chains, the direction is drawn isotropically at the start of the chain and passed on unchanged at
+    every collision. In newtonian chains, the active particle moves along its velocity, and the velocities of the two
+    particles are exchanged along the collision normal as in an elastic collision of equal masses. Particles without
+    a velocity are given a random unit velocity when they start a chain.
+
+    The collisions are found with the AABB tree and sweep_distance(), which is analytic for spheres and searches the
+    overlap tests of the shape for all other shapes. Rotations of anisotropic shapes remain local Metropolis trial
+    moves, selected with the move ratio.
+
+    Each time step performs nselect sweeps, and a sweep starts one chain or rotation trial per particle in a shuffled
+    order. Chains are split into segments of at most half the nearest plane distance of the box, so that the images
+    of the neighbors of every segment are in the image list. Event chains are only supported on a single rank and
+    without patch energies or external fields. Every displacement is counted as an accepted translation.
+
+    \ingroup hpmc_integrators
+*/
+template< class Shape >
+class IntegratorHPMCMonoEC : public IntegratorHPMCMono<Shape>
+    {
+    public:
+        //! Construct the integrator
+        IntegratorHPMCMonoEC(std::shared_ptr<SystemDefinition> sysdef,
+                             unsigned int seed);
+
+        //! Destructor
+        virtual ~IntegratorHPMCMonoEC()
+            {
+            this->m_exec_conf->msg->notice(5) << "Destroying IntegratorHPMCMonoEC" << std::endl;
+            }
+
+        //! Take one timestep forward
+        virtual void update(unsigned int timestep);
+
+        //! Set the total displacement of a chain
+        void setChainLength(Scalar chain_length)
+            {
+            if (chain_length <= Scalar(0.0))
+                {
+                this->m_exec_conf->msg->error() << "hpmc: chain_length must be positive" << std::endl;
+                throw std::runtime_error("Error setting event chain parameters");
+                }
+            m_chain_length = chain_length;
+            }
+
+        //! Get the total displacement of a chain
+        Scalar getChainLength() const
+            {
+            return m_chain_length;
+            }
+
+        //! Select newtonian (true) or straight (false) chains
+        void setNewtonian(bool newtonian)
+            {
+            m_newtonian = newtonian;
+            }
+
+        //! Get whether the chains are newtonian
+        bool getNewtonian() const
+            {
+            return m_newtonian;
+            }
+
+        //! Set the step of the collision search of shapes without an analytic sweep, relative to their diameter
+        void setSweepResolution(Scalar resolution)
+            {
+            if (resolution <= Scalar(0.0))
+                {
+                this->m_exec_conf->msg->error() << "hpmc: sweep_resolution must be positive" << std::endl;
+                throw std::runtime_error("Error setting event chain parameters");
+                }
+            m_sweep_resolution = resolution;
+            }
+
+        //! Get the step of the collision search
+        Scalar getSweepResolution() const
+            {
+            return m_sweep_resolution;
+            }
+
+        //! Get the average number of collisions per chain in the last time step
+        Scalar getChainEvents() const
+            {
+            return m_last_chains > 0 ? Scalar(m_last_events)/Scalar(m_last_chains) : Scalar(0.0);
+            }
+
+        //! Print statistics about the hpmc steps taken
+        virtual void printStats();
+
+        //! Reset statistics counters
+        virtual void resetStats()
+            {
+            IntegratorHPMCMono<Shape>::resetStats();
+            m_chain_count = 0;
+            m_event_count = 0;
+            }
+
+        //! Returns a list of provided quantities
+        virtual std::vector< std::string > getProvidedLogQuantities()
+            {
+            std::vector< std::string > result = IntegratorHPMCMono<Shape>::getProvidedLogQuantities();
+            result.push_back("hpmc_ec_chain_events");
+            return result;
+            }
+
+        //! Get the value of a logged quantity
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep)
+            {
+            if (quantity == "hpmc_ec_chain_events")
+                return getChainEvents();
+            return IntegratorHPMCMono<Shape>::getLogValue(quantity, timestep);
+            }
+
+    protected:
+        Scalar m_chain_length;                      //!< Total displacement of a chain
+        bool m_newtonian;                           //!< True for newtonian chains
+        Scalar m_sweep_resolution;                  //!< Step of the generic collision search (relative)
+
+        unsigned int m_last_chains;                 //!< Number of chains in the last time step
+        unsigned int m_last_events;                 //!< Number of collisions in the last time step
+        uint64_t m_chain_count;                     //!< Number of chains since the last resetStats()
+        uint64_t m_event_count;                     //!< Number of collisions since the last resetStats()
+
+        //! Find the first collision of particle i moving along a direction
+        Scalar sweepParticle(unsigned int i,
+                             const vec3<Scalar>& direction,
+                             Scalar max_distance,
+                             const Scalar4 *h_postype,
+                             const Scalar4 *h_orientation,
+                             const unsigned int *h_overlaps,
+                             hpmc_counters_t& counters,
+                             unsigned int& j_hit,
+                             vec3<Scalar>& normal);
+
+        //! Test whether particle i overlaps any other particle
+        bool checkOverlap(unsigned int i,
+                          const vec3<Scalar>& pos_i,
+                          const Shape& shape_i,
+                          const Scalar4 *h_postype,
+                          const Scalar4 *h_orientation,
+                          const unsigned int *h_overlaps,
+                          hpmc_counters_t& counters);
+
+        //! Draw a random unit vector
+        template<class RNG>
+        vec3<Scalar> randomDirection(RNG& rng, unsigned int ndim)
+            {
+            Scalar phi = rng.s(Scalar(0.0), Scalar(2.0*M_PI));
+            Scalar cos_theta = (ndim == 3) ? rng.s(Scalar(-1.0), Scalar(1.0)) : Scalar(0.0);
+            Scalar sin_theta = fast::sqrt(Scalar(1.0) - cos_theta*cos_theta);
+            return vec3<Scalar>(sin_theta*fast::cos(phi), sin_theta*fast::sin(phi), cos_theta);
+            }
+    };
+
+/*! \param sysdef System definition
+    \param seed Random number seed
+
+    The maximum displacements of the local trial moves are set to zero, translations are only made by chains.
+*/
+template< class Shape >
+IntegratorHPMCMonoEC< Shape >::IntegratorHPMCMonoEC(std::shared_ptr<SystemDefinition> sysdef,
+                                                     unsigned int seed)
+    : IntegratorHPMCMono<Shape>(sysdef, seed), m_chain_length(1.0), m_newtonian(false),
+      m_sweep_resolution(0.01), m_last_chains(0), m_last_events(0), m_chain_count(0), m_event_count(0)
+    {
+    this->m_exec_conf->msg->notice(5) << "Constructing IntegratorHPMCMonoEC" << std::endl;
+
+    ArrayHandle<Scalar> h_d(this->m_d, access_location::host, access_mode::overwrite);
+    for (unsigned int typ = 0; typ < this->m_pdata->getNTypes(); typ++)
+        h_d.data[typ] = Scalar(0.0);
+    }
+
+template< class Shape >
+void IntegratorHPMCMonoEC< Shape >::printStats()
+    {
+    IntegratorHPMCMono<Shape>::printStats();
+
+    if (m_chain_count == 0)
+        return;
+
+    this->m_exec_conf->msg->notice(2) << "-- Event chain stats:" << "\n";
+    this->m_exec_conf->msg->notice(2) << "Chains:                    " << m_chain_count << "\n";
+    this->m_exec_conf->msg->notice(2) << "Average collisions/chain:  "
+        << double(m_event_count)/double(m_chain_count) << "\n";
+    }
+
+template< class Shape >
+void IntegratorHPMCMonoEC< Shape >::update(unsigned int timestep)
+    {
+    this->m_exec_conf->msg->notice(10) << "HPMCMonoEC update: " << timestep << std::endl;
+    IntegratorHPMC::update(timestep);
+
+    #ifdef ENABLE_MPI
+    if (this->m_comm)
+        {
+        this->m_exec_conf->msg->error() << "hpmc: event chains are not supported with domain decomposition"
+                                        << std::endl;
+        throw std::runtime_error("Error performing HPMC update");
+        }
+    #endif
+
+    if (this->m_patch || this->m_external)
+        {
+        this->m_exec_conf->msg->error() << "hpmc: event chains are only supported for hard shapes without patch "
+                                        << "energies or external fields" << std::endl;
+        throw std::runtime_error("Error performing HPMC update");
+        }
+
+    ArrayHandle<hpmc_counters_t> h_counters(this->m_count_total, access_location::host, access_mode::readwrite);
+    hpmc_counters_t& counters = h_counters.data[0];
+    const BoxDim& box = this->m_pdata->getBox();
+    unsigned int ndim = this->m_sysdef->getNDimensions();
+
+    // keep the segments of the chains within the image list
+    Scalar3 npd = box.getNearestPlaneDistance();
+    Scalar min_npd = std::min(npd.x, npd.y);
+    if (ndim == 3)
+        min_npd = std::min(min_npd, npd.z);
+    Scalar max_segment = std::min(m_chain_length, Scalar(0.5)*min_npd);
+    if (this->m_extra_image_width != max_segment)
+        {
+        this->m_extra_image_width = max_segment;
+        this->m_image_list_valid = false;
+        }
+
+    // Shuffle the order of particles for this step
+    this->m_update_order.resize(this->m_pdata->getN());
+    this->m_update_order.shuffle(timestep);
+
+    this->buildAABBTree();
+    this->updateImageList();
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC EC update");
+
+    ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_vel(this->m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(this->m_pdata->getImages(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_a(this->m_a, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_overlaps(this->m_overlaps, access_location::host, access_mode::read);
+
+    const unsigned int N = this->m_pdata->getN();
+    m_last_chains = 0;
+    m_last_events = 0;
+
+    for (unsigned int i_nselect = 0; i_nselect < this->m_nselect; i_nselect++)
+        {
+        for (unsigned int cur_particle = 0; cur_particle < N; cur_particle++)
+            {
+            unsigned int i = this->m_update_order[cur_particle];
+            hoomd::detail::Saru rng_i(i, this->m_seed + i_nselect, timestep);
+
+            Scalar4 postype_i = h_postype.data[i];
+            unsigned int typ_i = __scalar_as_int(postype_i.w);
+            Shape shape_i(quat<Scalar>(h_orientation.data[i]), this->m_params[typ_i]);
+            unsigned int move_type_select = rng_i.u32() & 0xffff;
+            bool move_type_translate = !shape_i.hasOrientation() || (move_type_select < this->m_move_ratio);
+
+            if (!move_type_translate)
+                {
+                // local Metropolis rotation
+                if (h_a.data[typ_i] == 0.0)
+                    {
+                    if (!shape_i.ignoreStatistics())
+                        counters.rotate_accept_count++;
+                    continue;
+                    }
+
+                move_rotate(shape_i.orientation, rng_i, h_a.data[typ_i], ndim);
+                bool overlap = checkOverlap(i, vec3<Scalar>(postype_i), shape_i, h_postype.data, h_orientation.data,
+                    h_overlaps.data, counters);
+
+                if (!overlap)
+                    h_orientation.data[i] = quat_to_scalar4(shape_i.orientation);
+
+                if (!shape_i.ignoreStatistics())
+                    {
+                    if (overlap)
+                        counters.rotate_reject_count++;
+                    else
+                        counters.rotate_accept_count++;
+                    }
+                continue;
+                }
+
+            // direction of the chain
+            vec3<Scalar> direction;
+            if (m_newtonian)
+                {
+                vec3<Scalar> v(h_vel.data[i]);
+                if (dot(v, v) == Scalar(0.0))
+                    {
+                    v = randomDirection(rng_i, ndim);
+                    h_vel.data[i] = make_scalar4(v.x, v.y, v.z, h_vel.data[i].w);
+                    }
+                direction = v/sqrt(dot(v, v));
+                }
+            else
+                {
+                direction = randomDirection(rng_i, ndim);
+                }
+
+            m_last_chains++;
+            unsigned int k = i;
+            Scalar remaining = m_chain_length;
+
+            // a chain without progress over more collisions than particles is jammed
+            unsigned int stalled_events = 0;
+            while (remaining > Scalar(0.0) && stalled_events <= N)
+                {
+                Scalar segment = std::min(remaining, max_segment);
+                unsigned int j_hit = k;
+                vec3<Scalar> normal;
+                Scalar s = sweepParticle(k, direction, segment, h_postype.data, h_orientation.data, h_overlaps.data,
+                    counters, j_hit, normal);
+
+                // move the active particle and keep it in the box
+                Scalar4 postype_k = h_postype.data[k];
+                vec3<Scalar> pos_k = vec3<Scalar>(postype_k) + s*direction;
+                h_postype.data[k] = make_scalar4(pos_k.x, pos_k.y, pos_k.z, postype_k.w);
+                box.wrap(h_postype.data[k], h_image.data[k]);
+
+                unsigned int typ_k = __scalar_as_int(postype_k.w);
+                Shape shape_k(quat<Scalar>(h_orientation.data[k]), this->m_params[typ_k]);
+                detail::AABB aabb = detail::AABB(vec3<Scalar>(h_postype.data[k]),
+                    shape_k.getCircumsphereDiameter()/OverlapReal(2.0));
+                this->m_aabb_tree.update(k, aabb);
+
+                if (!shape_k.ignoreStatistics())
+                    counters.translate_accept_count++;
+
+                remaining -= s;
+                if (s == segment)
+                    continue;
+
+                // lift the chain to the collided particle
+                m_last_events++;
+                stalled_events = (s > Scalar(0.0)) ? 0 : stalled_events + 1;
+
+                if (m_newtonian)
+                    {
+                    vec3<Scalar> v_k(h_vel.data[k]);
+                    vec3<Scalar> v_j(h_vel.data[j_hit]);
+                    vec3<Scalar> dv = dot(v_k - v_j, normal)*normal;
+                    v_k -= dv;
+                    v_j += dv;
+                    h_vel.data[k] = make_scalar4(v_k.x, v_k.y, v_k.z, h_vel.data[k].w);
+                    h_vel.data[j_hit] = make_scalar4(v_j.x, v_j.y, v_j.z, h_vel.data[j_hit].w);
+
+                    if (dot(v_j, v_j) == Scalar(0.0))
+                        break;
+                    direction = v_j/sqrt(dot(v_j, v_j));
+                    }
+
+                k = j_hit;
+                }
+            }
+        }
+
+    m_chain_count += m_last_chains;
+    m_event_count += m_last_events;
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    // all particle have been moved, the aabb tree needs to be refit
+    this->m_aabb_tree_stale = true;
+    }
+
+/*! \param i Index of the moving particle
+    \param direction Unit vector of the motion
+    \param max_distance Largest displacement of interest
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
+    \param h_overlaps Interaction matrix
+    \param counters Counters to tally the overlap checks in
+    \param j_hit Set to the index of the collided particle
+    \param normal Set to the collision normal, pointing from i to j_hit
+    \returns The distance to the first collision, or max_distance if there is none
+*/
+template< class Shape >
+Scalar IntegratorHPMCMonoEC< Shape >::sweepParticle(unsigned int i,
+                                                    const vec3<Scalar>& direction,
+                                                    Scalar max_distance,
+                                                    const Scalar4 *h_postype,
+                                                    const Scalar4 *h_orientation,
+                                                    const unsigned int *h_overlaps,
+                                                    hpmc_counters_t& counters,
+                                                    unsigned int& j_hit,
+                                                    vec3<Scalar>& normal)
+    {
+    Scalar4 postype_i = h_postype[i];
+    vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
+    unsigned int typ_i = __scalar_as_int(postype_i.w);
+    Shape shape_i(quat<Scalar>(h_orientation[i]), this->m_params[typ_i]);
+
+    // the AABB swept by the circumsphere of i
+    Scalar R = shape_i.getCircumsphereDiameter()/OverlapReal(2.0);
+    vec3<Scalar> end = max_distance*direction;
+    vec3<Scalar> lower(std::min(Scalar(0.0), end.x) - R, std::min(Scalar(0.0), end.y) - R,
+                       std::min(Scalar(0.0), end.z) - R);
+    vec3<Scalar> upper(std::max(Scalar(0.0), end.x) + R, std::max(Scalar(0.0), end.y) + R,
+                       std::max(Scalar(0.0), end.z) + R);
+    detail::AABB aabb_i_local(lower, upper);
+
+    Scalar s_min = max_distance;
+    const unsigned int n_images = this->m_image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + this->m_image_list[cur_image];
+        detail::AABB aabb = aabb_i_local;
+        aabb.translate(pos_i_image);
+
+        // stackless search
+        for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
+            {
+            if (this->m_aabb_tree.overlapNode(cur_node_idx, aabb))
+                {
+                if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
+                    {
+                    for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        {
+                        // the images of i move together with it
+                        unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+                        if (j == i)
+                            continue;
+
+                        Scalar4 postype_j = h_postype[j];
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        if (!h_overlaps[this->m_overlap_idx(typ_i, typ_j)])
+                            continue;
+
+                        Shape shape_j(quat<Scalar>(h_orientation[j]), this->m_params[typ_j]);
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+
+                        counters.overlap_checks++;
+                        vec3<Scalar> normal_j;
+                        Scalar s = sweep_distance(r_ij, shape_i, shape_j, direction, s_min, m_sweep_resolution,
+                            counters.overlap_err_count, normal_j);
+                        if (s < s_min)
+                            {
+                            s_min = s;
+                            j_hit = j;
+                            normal = normal_j;
+                            }
+                        }
+                    }
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            }
+        }
+
+    return s_min;
+    }
+
+/*! \param i Index of the particle
+    \param pos_i Position of the particle
+    \param shape_i Shape of the particle
+    \param h_postype Particle positions and types
+    \param h_orientation Particle orientations
+    \param h_overlaps Interaction matrix
+    \param counters Counters to tally the overlap checks in
+    \returns true if i overlaps any particle other than itself
+*/
+template< class Shape >
+bool IntegratorHPMCMonoEC< Shape >::checkOverlap(unsigned int i,
+                                                 const vec3<Scalar>& pos_i,
+                                                 const Shape& shape_i,
+                                                 const Scalar4 *h_postype,
+                                                 const Scalar4 *h_orientation,
+                                                 const unsigned int *h_overlaps,
+                                                 hpmc_counters_t& counters)
+    {
+    unsigned int typ_i = __scalar_as_int(h_postype[i].w);
+    detail::AABB aabb_i_local = detail::AABB(vec3<Scalar>(0,0,0), shape_i.getCircumsphereDiameter()/OverlapReal(2.0));
+
+    const unsigned int n_images = this->m_image_list.size();
+    for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
+        {
+        vec3<Scalar> pos_i_image = pos_i + this->m_image_list[cur_image];
+        detail::AABB aabb = aabb_i_local;
+        aabb.translate(pos_i_image);
+
+        for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
+            {
+            if (this->m_aabb_tree.overlapNode(cur_node_idx, aabb))
+                {
+                if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
+                    {
+                    for (unsigned int cur_p = 0; cur_p < this->m_aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
+                        {
+                        unsigned int j = this->m_aabb_tree.getNodeParticle(cur_node_idx, cur_p);
+
+                        // in outside images, i is tested against its own rotated image
+                        Scalar4 postype_j = h_postype[j];
+                        quat<Scalar> orientation_j(h_orientation[j]);
+                        if (j == i)
+                            {
+                            if (cur_image == 0)
+                                continue;
+                            orientation_j = shape_i.orientation;
+                            }
+
+                        unsigned int typ_j = __scalar_as_int(postype_j.w);
+                        Shape shape_j(orientation_j, this->m_params[typ_j]);
+                        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i_image;
+
+                        counters.overlap_checks++;
+                        if (h_overlaps[this->m_overlap_idx(typ_i, typ_j)]
+                            && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+                            && test_overlap(r_ij, shape_i, shape_j, counters.overlap_err_count))
+                            {
+                            return true;
+                            }
+                        }
+                    }
+                }
+            else
+                {
+                // skip ahead
+                cur_node_idx += this->m_aabb_tree.getNodeSkip(cur_node_idx);
+                }
+            }
+        }
+
+    return false;
+    }
+
+//! Export the IntegratorHPMCMonoEC class to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of IntegratorHPMCMonoEC<Shape> will be exported
+*/
+template < class Shape > void export_IntegratorHPMCMonoEC(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_<IntegratorHPMCMonoEC<Shape>, std::shared_ptr< IntegratorHPMCMonoEC<Shape> > >(m, name.c_str(), pybind11::base< IntegratorHPMCMono<Shape> >())
+        .def(pybind11::init< std::shared_ptr<SystemDefinition>, unsigned int >())
+        .def("setChainLength", &IntegratorHPMCMonoEC<Shape>::setChainLength)
+        .def("getChainLength", &IntegratorHPMCMonoEC<Shape>::getChainLength)
+        .def("setNewtonian", &IntegratorHPMCMonoEC<Shape>::setNewtonian)
+        .def("getNewtonian", &IntegratorHPMCMonoEC<Shape>::getNewtonian)
+        .def("setSweepResolution", &IntegratorHPMCMonoEC<Shape>::setSweepResolution)
+        .def("getSweepResolution", &IntegratorHPMCMonoEC<Shape>::getSweepResolution)
+        .def("getChainEvents", &IntegratorHPMCMonoEC<Shape>::getChainEvents)
+        ;
+    }
+
+} // end namespace hpmc
+
+#endif // __HPMC_MONO_EC__H__
@@ -30,6 +30,28 @@ namespace detail
     \brief Declaration of CUDA kernels drivers
 */
 
+//! Parameters of a lattice field (ExternalFieldLattice) evaluated in the trial move kernel
+/*! \ingroup hpmc_data_structs */
+struct hpmc_lattice_args_t
+    {
+    //! Construct without a lattice field
+    hpmc_lattice_args_t()
+        : d_tag(NULL), d_r0(NULL), d_q0(NULL), d_symmetry(NULL), n_symmetry(0), k(0), q(0),
+          origin(make_scalar3(0,0,0))
+        {
+        }
+
+    const unsigned int *d_tag;        //!< Particle tags
+    const Scalar3 *d_r0;              //!< Reference positions by tag (ignore if NULL)
+    const Scalar4 *d_q0;              //!< Reference orientations by tag (ignore if NULL)
+    const Scalar4 *d_symmetry;        //!< Rotations in the symmetry group of the shape
+    unsigned int n_symmetry;          //!< Number of symmetry rotations
+    Scalar k;                         //!< Translational spring constant
+    Scalar q;                         //!< Rotational spring constant
+    Scalar3 origin;                   //!< Origin of the particle coordinates
+    BoxDim global_box;                //!< Global simulation box
+    };
+
 //! Wraps arguments to gpu_hpmc_up
 /*! \ingroup hpmc_data_structs */
 struct hpmc_args_t
@@ -73,7 +95,12 @@ struct hpmc_args_t
                 cudaStream_t _stream,
                 unsigned int *_d_active_cell_ptl_idx = NULL,
                 unsigned int *_d_active_cell_accept = NULL,
-                unsigned int *_d_active_cell_move_type_translate = NULL)
+                unsigned int *_d_active_cell_move_type_translate = NULL,
+                const unsigned int *_d_sweep_state = NULL,
+                const unsigned int _sweep_set = 0,
+                const unsigned int _cell_set_pitch = 0,
+                const hpmc_lattice_args_t *_lattice = NULL,
+                hpmc_counters_t *_d_type_counters = NULL)
                 : d_postype(_d_postype),
                   d_orientation(_d_orientation),
                   d_counters(_d_counters),
@@ -112,7 +139,12 @@ struct hpmc_args_t
                   stream(_stream),
                   d_active_cell_ptl_idx(_d_active_cell_ptl_idx),
                   d_active_cell_accept(_d_active_cell_accept),
-                  d_active_cell_move_type_translate(_d_active_cell_move_type_translate)
+                  d_active_cell_move_type_translate(_d_active_cell_move_type_translate),
+                  d_sweep_state(_d_sweep_state),
+                  sweep_set(_sweep_set),
+                  cell_set_pitch(_cell_set_pitch),
+                  lattice(_lattice),
+                  d_type_counters(_d_type_counters)
         {
         };
 
@@ -155,6 +187,11 @@ struct hpmc_args_t
     unsigned int *d_active_cell_ptl_idx; //!< Updated particle index per active cell (ignore if NULL)
     unsigned int *d_active_cell_accept;//!< =1 if active cell move has been accepted, =0 otherwise (ignore if NULL)
     unsigned int *d_active_cell_move_type_translate;//!< =1 if active cell move was a translation, =0 if rotation
+    const unsigned int *d_sweep_state; //!< Time step and cell set order on the device (ignore if NULL)
+    const unsigned int sweep_set;     //!< Slot of the cell set order in d_sweep_state
+    const unsigned int cell_set_pitch;//!< Pitch of the cell sets in d_cell_set if d_sweep_state is set
+    const hpmc_lattice_args_t *lattice; //!< Lattice field applied to the trial moves (ignore if NULL)
+    hpmc_counters_t *d_type_counters; //!< Move accept/reject counters by particle type (ignore if NULL)
     };
 
 cudaError_t gpu_hpmc_excell(unsigned int *d_excell_idx,
@@ -178,6 +215,26 @@ cudaError_t gpu_hpmc_shift(Scalar4 *d_postype,
                            const Scalar3 shift,
                            const unsigned int block_size);
 
+template< class Shape >
+cudaError_t gpu_hpmc_count_overlaps(unsigned int *d_overlap_count,
+                                    const Scalar4 *d_postype,
+                                    const Scalar4 *d_orientation,
+                                    const unsigned int *d_tag,
+                                    const unsigned int *d_excell_idx,
+                                    const unsigned int *d_excell_size,
+                                    const Index2D& excli,
+                                    const Index3D& ci,
+                                    const uint3& cell_dim,
+                                    const Scalar3& ghost_width,
+                                    const unsigned int N,
+                                    const unsigned int *d_check_overlaps,
+                                    const Index2D& overlap_idx,
+                                    const BoxDim& box,
+                                    const bool early_exit,
+                                    const unsigned int block_size,
+                                    const cudaStream_t stream,
+                                    const typename Shape::param_type *d_params);
+
 #ifdef NVCC
 /*!
  * Definition of function templates and templated GPU kernels
@@ -219,6 +276,40 @@ __device__ inline unsigned int computeParticleCell(const Scalar3& p,
         return 0xffffffff;
     }
 
+//! Compute the energy of a particle in a lattice field
+/*! \param lattice Parameters of the lattice field
+    \param tag Tag of the particle
+    \param pos Position of the particle
+    \param orientation Orientation of the particle
+
+    This is the device version of ExternalFieldLattice::calcE().
+*/
+__device__ inline Scalar lattice_energy(const hpmc_lattice_args_t& lattice,
+                                        unsigned int tag,
+                                        const vec3<Scalar>& pos,
+                                        const quat<Scalar>& orientation)
+    {
+    Scalar energy(0.0);
+    if (lattice.d_r0)
+        {
+        vec3<Scalar> r0(lattice.d_r0[tag]);
+        vec3<Scalar> dr(lattice.global_box.minImage(vec_to_scalar3(r0 - pos + vec3<Scalar>(lattice.origin))));
+        energy += lattice.k*dot(dr,dr);
+        }
+    if (lattice.d_q0)
+        {
+        quat<Scalar> q0(lattice.d_q0[tag]);
+        Scalar dqmin(0.0);
+        for (unsigned int k = 0; k < lattice.n_symmetry; k++)
+            {
+            quat<Scalar> dq = q0 - orientation*quat<Scalar>(lattice.d_symmetry[k]);
+            dqmin = (k == 0) ? norm2(dq) : fmin(dqmin, norm2(dq));
+            }
+        energy += lattice.q*dqmin;
+        }
+    return energy;
+    }
+
 //! HPMC  update kernel
 /*! \param d_postype Particle positions and types by index
     \param d_orientation Particle orientation
@@ -248,6 +339,10 @@ __device__ inline unsigned int computeParticleCell(const Scalar3& p,
     \param select Current index within the loop over nselect selections (for RNG generation)
     \param ghost_fraction Width of the inactive layer in MPI domain decomposition simulations
     \param domain_decomposition True if executing with domain decomposition
+    \param d_sweep_state If not NULL, the time step and the order of the cell sets are read from this array
+    \param sweep_set Slot of the cell set in d_sweep_state
+    \param cell_set_pitch Pitch of the cell sets in d_cell_set
+    \param lattice Lattice field, applied to the trial moves if lattice.d_tag is set
     \param d_params Per-type shape parameters
 
     MPMC in its published form has a severe limit on the number of parallel threads in 3D. This implementation launches
@@ -315,6 +410,11 @@ __global__ void gpu_hpmc_mpmc_kernel(Scalar4 *d_postype,
                                      unsigned int *d_active_cell_ptl_idx,
                                      unsigned int *d_active_cell_accept,
                                      unsigned int *d_active_cell_move_type_translate,
+                                     const unsigned int *d_sweep_state,
+                                     const unsigned int sweep_set,
+                                     const unsigned int cell_set_pitch,
+                                     const hpmc_lattice_args_t lattice,
+                                     hpmc_counters_t *d_type_counters,
                                      const typename Shape::param_type *d_params,
                                      unsigned int max_queue_size,
                                      unsigned int max_extra_bytes)
@@ -371,6 +471,7 @@ __global__ void gpu_hpmc_mpmc_kernel(Scalar4 *d_postype,
     unsigned int *s_overlap =   (unsigned int*)(s_queue_j + max_queue_size);
     unsigned int *s_queue_gid = (unsigned int*)(s_overlap + n_groups);
     unsigned int *s_type_group = (unsigned int*)(s_queue_gid + max_queue_size);
+    unsigned int *s_type_counters = (unsigned int*)(s_type_group + n_groups);
 
     // copy over parameters one int per thread for fast loads
         {
@@ -395,6 +496,14 @@ __global__ void gpu_hpmc_mpmc_kernel(Scalar4 *d_postype,
                 }
             }
 
+        for (unsigned int cur_offset = 0; cur_offset < 4*num_types; cur_offset += block_size)
+            {
+            if (cur_offset + tidx < 4*num_types)
+                {
+                s_type_counters[cur_offset + tidx] = 0;
+                }
+            }
+
         unsigned int ntyppairs = overlap_idx.getNumElements();
 
         for (unsigned int cur_offset = 0; cur_offset < ntyppairs; cur_offset += block_size)
@@ -409,7 +518,7 @@ __global__ void gpu_hpmc_mpmc_kernel(Scalar4 *d_postype,
     __syncthreads();
 
     // initialize extra shared mem
-    char *s_extra = (char *)(s_type_group + n_groups);
+    char *s_extra = (char *)(s_type_counters + 4*num_types);
 
     unsigned int available_bytes = max_extra_bytes;
     for (unsigned int cur_type = 0; cur_type < num_types; ++cur_type)
@@ -440,6 +549,14 @@ __global__ void gpu_hpmc_mpmc_kernel(Scalar4 *d_postype,
     if (active_cell_idx >= n_active_cells)
         active = false;
 
+    // a sweep replayed from a CUDA graph reads the values that change every step from device memory
+    unsigned int cur_timestep = timestep;
+    if (d_sweep_state)
+        {
+        cur_timestep = d_sweep_state[0];
+        d_cell_set += d_sweep_state[1 + sweep_set] * cell_set_pitch;
+        }
+
     // pull in the index of our cell
     unsigned int my_cell = 0;
     unsigned int my_cell_size = 0;
@@ -466,7 +583,7 @@ __global__ void gpu_hpmc_mpmc_kernel(Scalar4 *d_postype,
     if (active)
         {
         // one RNG per cell
-        hoomd::detail::Saru rng(my_cell, seed+select, timestep);
+        hoomd::detail::Saru rng(my_cell, seed+select, cur_timestep);
 
         // select one of the particles randomly from the cell
         unsigned int my_cell_offset = rand_select(rng, my_cell_size-1);
@@ -686,6 +803,24 @@ __global__ void gpu_hpmc_mpmc_kernel(Scalar4 *d_postype,
             if (new_cell != my_cell)
                 accepted=false;
 
+            // Metropolis criterion in the lattice field, particle i has not been written to by this kernel yet
+            if (accepted && lattice.d_tag)
+                {
+                unsigned int tag_i = lattice.d_tag[i];
+                Scalar4 postype_old = d_postype[i];
+                Shape shape_old(quat<Scalar>(d_orientation[i]), s_params[s_type_group[group]]);
+
+                // shapes without orientation keep their stored orientation, as on the CPU
+                quat<Scalar> orientation_new = shape_old.hasOrientation() ?
+                    quat<Scalar>(s_orientation_group[group]) : shape_old.orientation;
+                Scalar dE = lattice_energy(lattice, tag_i, vec3<Scalar>(xnew_i), orientation_new)
+                    - lattice_energy(lattice, tag_i, vec3<Scalar>(postype_old), shape_old.orientation);
+
+                hoomd::detail::Saru rng_lattice(my_cell, seed+select, cur_timestep ^ 0x3b6e1c27);
+                if (!(rng_lattice.d() < slow::exp(-dE)))
+                    accepted=false;
+                }
+
             if (accepted)
                 {
                 // write out the updated position and orientation
@@ -725,6 +860,10 @@ __global__ void gpu_hpmc_mpmc_kernel(Scalar4 *d_postype,
                 atomicAdd(&s_translate_reject_count, 1);
             if (!ignore_stats && !accepted && !move_type_translate)
                 atomicAdd(&s_rotate_reject_count, 1);
+
+            // tally by type in the order translate accept, translate reject, rotate accept, rotate reject
+            if (!ignore_stats && d_type_counters)
+                atomicAdd(&s_type_counters[4*s_type_group[group] + (move_type_translate ? 0 : 2) + (accepted ? 0 : 1)], 1);
             }
         else // active && move_active
             {
@@ -754,6 +893,24 @@ __global__ void gpu_hpmc_mpmc_kernel(Scalar4 *d_postype,
         atomicAdd(&d_counters->overlap_checks, s_overlap_checks);
         atomicAdd(&d_counters->overlap_err_count, s_overlap_err_count);
         }
+
+    // and by type, one global update per block
+    if (d_type_counters)
+        {
+        unsigned int tidx = threadIdx.x+blockDim.x*threadIdx.y + blockDim.x*blockDim.y*threadIdx.z;
+        unsigned int block_size = blockDim.x*blockDim.y*blockDim.z;
+        for (unsigned int cur_type = tidx; cur_type < num_types; cur_type += block_size)
+            {
+            if (s_type_counters[4*cur_type])
+                atomicAdd(&d_type_counters[cur_type].translate_accept_count, s_type_counters[4*cur_type]);
+            if (s_type_counters[4*cur_type+1])
+                atomicAdd(&d_type_counters[cur_type].translate_reject_count, s_type_counters[4*cur_type+1]);
+            if (s_type_counters[4*cur_type+2])
+                atomicAdd(&d_type_counters[cur_type].rotate_accept_count, s_type_counters[4*cur_type+2]);
+            if (s_type_counters[4*cur_type+3])
+                atomicAdd(&d_type_counters[cur_type].rotate_reject_count, s_type_counters[4*cur_type+3]);
+            }
+        }
     }
 
 //! Kernel driver for gpu_update_hpmc_kernel()
@@ -811,10 +968,10 @@ cudaError_t gpu_hpmc_update(const hpmc_args_t& args, const typename Shape::param
     unsigned int max_queue_size = n_groups*group_size;
     unsigned int shared_bytes = n_groups * (sizeof(unsigned int)*2 + sizeof(Scalar4) + sizeof(Scalar3)) +
                                 max_queue_size*(sizeof(unsigned int) + sizeof(unsigned int)) +
-                                args.num_types * (sizeof(typename Shape::param_type) + 2*sizeof(Scalar)) +
+                                args.num_types * (sizeof(typename Shape::param_type) + 2*sizeof(Scalar) + 4*sizeof(unsigned int)) +
                                 args.overlap_idx.getNumElements() * sizeof(unsigned int);
 
-    unsigned int min_shared_bytes = args.num_types * (sizeof(typename Shape::param_type) + 2*sizeof(Scalar)) +
+    unsigned int min_shared_bytes = args.num_types * (sizeof(typename Shape::param_type) + 2*sizeof(Scalar) + 4*sizeof(unsigned int)) +
                args.overlap_idx.getNumElements() * sizeof(unsigned int);
 
     if (min_shared_bytes >= args.devprop.sharedMemPerBlock)
@@ -933,6 +1090,11 @@ cudaError_t gpu_hpmc_update(const hpmc_args_t& args, const typename Shape::param
                                                                  args.d_active_cell_ptl_idx,
                                                                  args.d_active_cell_accept,
                                                                  args.d_active_cell_move_type_translate,
+                                                                 args.d_sweep_state,
+                                                                 args.sweep_set,
+                                                                 args.cell_set_pitch,
+                                                                 args.lattice ? *args.lattice : hpmc_lattice_args_t(),
+                                                                 args.d_type_counters,
                                                                  params,
                                                                  max_queue_size,
                                                                  max_extra_bytes);
@@ -940,6 +1102,169 @@ cudaError_t gpu_hpmc_update(const hpmc_args_t& args, const typename Shape::param
     return cudaSuccess;
     }
 
+//! Kernel to count the overlaps between particles
+/*! \param d_overlap_count Number of overlaps (output, accumulated)
+    \param d_postype Particle positions and types by index
+    \param d_orientation Particle orientation
+    \param d_tag Particle tags
+    \param d_excell_idx Indices of particles in expanded cells
+    \param d_excell_size Number of particles in each expanded cell
+    \param excli Indexer for the expanded cells
+    \param ci Cell indexer
+    \param cell_dim Cell dimensions
+    \param ghost_width Width of the ghost layer
+    \param N Number of local particles
+    \param d_check_overlaps Interaction matrix
+    \param overlap_idx Indexer into the interaction matrix
+    \param box Local simulation box
+    \param early_exit If true, stop at the first overlap found by any thread
+    \param d_params Per-type shape parameters
+
+    One thread per particle tests its overlaps with the particles of equal or larger tag in its expanded cell, which
+    counts every overlapping pair once. With \a early_exit, threads that start after an overlap has been found return
+    immediately.
+
+    \ingroup hpmc_kernels
+*/
+template< class Shape >
+__global__ void gpu_hpmc_count_overlaps_kernel(unsigned int *d_overlap_count,
+                                               const Scalar4 *d_postype,
+                                               const Scalar4 *d_orientation,
+                                               const unsigned int *d_tag,
+                                               const unsigned int *d_excell_idx,
+                                               const unsigned int *d_excell_size,
+                                               const Index2D excli,
+                                               const Index3D ci,
+                                               const uint3 cell_dim,
+                                               const Scalar3 ghost_width,
+                                               const unsigned int N,
+                                               const unsigned int *d_check_overlaps,
+                                               const Index2D overlap_idx,
+                                               const BoxDim box,
+                                               const bool early_exit,
+                                               const typename Shape::param_type *d_params)
+    {
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (i >= N)
+        return;
+
+    // another thread has already found an overlap
+    if (early_exit && *((volatile unsigned int *)d_overlap_count))
+        return;
+
+    Scalar4 postype_i = d_postype[i];
+    unsigned int typ_i = __scalar_as_int(postype_i.w);
+    Shape shape_i(quat<Scalar>(d_orientation[i]), d_params[typ_i]);
+    vec3<Scalar> pos_i(postype_i);
+    unsigned int tag_i = d_tag[i];
+
+    unsigned int my_cell = computeParticleCell(vec_to_scalar3(pos_i), box, ghost_width, cell_dim, ci);
+    unsigned int excell_size = d_excell_size[my_cell];
+
+    unsigned int overlap_count = 0;
+    unsigned int err_count = 0;
+
+    for (unsigned int k = 0; k < excell_size; ++k)
+        {
+        unsigned int j = d_excell_idx[excli(k, my_cell)];
+        if (j == i)
+            continue;
+
+        Scalar4 postype_j = d_postype[j];
+        unsigned int typ_j = __scalar_as_int(postype_j.w);
+        Shape shape_j(quat<Scalar>(d_orientation[j]), d_params[typ_j]);
+
+        // put particle j into the coordinate system of particle i
+        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i;
+        r_ij = vec3<Scalar>(box.minImage(vec_to_scalar3(r_ij)));
+
+        if (tag_i <= d_tag[j]
+            && d_check_overlaps[overlap_idx(typ_i, typ_j)]
+            && check_circumsphere_overlap(r_ij, shape_i, shape_j)
+            && test_overlap(r_ij, shape_i, shape_j, err_count)
+            && test_overlap(-r_ij, shape_j, shape_i, err_count))
+            {
+            overlap_count++;
+            if (early_exit)
+                break;
+            }
+        }
+
+    if (overlap_count)
+        atomicAdd(d_overlap_count, overlap_count);
+    }
+
+//! Kernel driver for gpu_hpmc_count_overlaps_kernel()
+/*! \param block_size Block size to execute
+    \param stream CUDA stream for the kernel
+    \returns Error codes generated by any CUDA calls, or cudaSuccess when there is no error
+
+    See gpu_hpmc_count_overlaps_kernel() for the other parameters. \a d_overlap_count is reset before the launch.
+
+    \ingroup hpmc_kernels
+*/
+template< class Shape >
+cudaError_t gpu_hpmc_count_overlaps(unsigned int *d_overlap_count,
+                                    const Scalar4 *d_postype,
+                                    const Scalar4 *d_orientation,
+                                    const unsigned int *d_tag,
+                                    const unsigned int *d_excell_idx,
+                                    const unsigned int *d_excell_size,
+                                    const Index2D& excli,
+                                    const Index3D& ci,
+                                    const uint3& cell_dim,
+                                    const Scalar3& ghost_width,
+                                    const unsigned int N,
+                                    const unsigned int *d_check_overlaps,
+                                    const Index2D& overlap_idx,
+                                    const BoxDim& box,
+                                    const bool early_exit,
+                                    const unsigned int block_size,
+                                    const cudaStream_t stream,
+                                    const typename Shape::param_type *d_params)
+    {
+    assert(d_overlap_count);
+    assert(d_postype);
+    assert(d_orientation);
+    assert(d_tag);
+
+    // determine the maximum block size and clamp the input block size down
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, gpu_hpmc_count_overlaps_kernel<Shape>);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+
+    cudaMemsetAsync(d_overlap_count, 0, sizeof(unsigned int), stream);
+
+    if (N == 0)
+        return cudaSuccess;
+
+    gpu_hpmc_count_overlaps_kernel<Shape><<<N/run_block_size + 1, run_block_size, 0, stream>>>(d_overlap_count,
+        d_postype,
+        d_orientation,
+        d_tag,
+        d_excell_idx,
+        d_excell_size,
+        excli,
+        ci,
+        cell_dim,
+        ghost_width,
+        N,
+        d_check_overlaps,
+        overlap_idx,
+        box,
+        early_exit,
+        d_params);
+
+    return cudaSuccess;
+    }
+
 #endif //NVCC
 
 }; // end namespace detail
@@ -6,8 +6,11 @@
 #include "IntegratorHPMCMono.h"
 #include "IntegratorHPMCMonoGPU.cuh"
 #include "hoomd/Autotuner.h"
+#include "hoomd/GlobalArray.h"
+#include "hoomd/GPUPartition.cuh"
 
 #include <cuda_runtime.h>
+#include <algorithm>
 
 /*! \file IntegratorHPMCMonoGPU.h
     \brief Defines the template class for HPMC on the GPU
@@ -24,7 +27,21 @@ namespace hpmc
 {
 
 //! Template class for HPMC update on the GPU
-/*!
+/*! At small N, a sweep of nselect * particles_per_cell * n_sets short kernel launches is limited by the launch
+    overhead. With setCUDAGraph(true), the sweep is captured in a CUDA graph once and replayed on every step with the
+    same structure. The values that change every step, the time step and the shuffled order of the cell sets, are
+    copied to the device by the first node of the graph, all other kernel arguments are part of a key that is compared
+    before every replay. The sweep is captured again one step after the key changes (a new particle number, box,
+    reallocated array, shape parameters or tuned launch parameters), and it is not replayed while the autotuner is
+    sampling.
+
+    With more than one active GPU, the active cells of every cell set are split into contiguous ranges, one per GPU,
+    and each GPU performs the trial moves in its range. All GPUs finish a cell set before any GPU starts the next
+    one, so that the checkerboard keeps the concurrently updated cells independent. The cell sets, expanded cells
+    and move sizes are kept in managed memory that is read by all GPUs, and every GPU tallies the acceptance counters
+    in its own slot. The slots are added to the counters at the end of the sweep. CUDA graphs are not used on
+    multiple GPUs, and sweeps with a lattice field run on the first GPU only.
+
     \ingroup hpmc_integrators
 */
 template< class Shape >
@@ -53,6 +70,20 @@ class IntegratorHPMCMonoGPU : public IntegratorHPMCMono<Shape>
 
             m_tuner_excell_block_size->setPeriod(period);
             m_tuner_excell_block_size->setEnabled(enable);
+
+            m_tuner_overlaps->setPeriod(period);
+            m_tuner_overlaps->setEnabled(enable);
+            }
+
+        //! Count overlaps with the option to exit early at the first detected overlap
+        virtual unsigned int countOverlaps(unsigned int timestep, bool early_exit);
+
+        //! Get the stream that the shape parameters are attached to
+        /*! Kernels of other classes that read the shape parameters must be launched in this stream.
+        */
+        cudaStream_t getStream() const
+            {
+            return m_stream;
             }
 
         //! Enable deterministic simulations
@@ -62,22 +93,66 @@ class IntegratorHPMCMonoGPU : public IntegratorHPMCMono<Shape>
             m_cl->setSortCellList(deterministic);
             }
 
+        //! The GPU sweeps always use the circumsphere ghost layer
+        virtual void setGhostAABB(bool ghost_aabb)
+            {
+            if (ghost_aabb)
+                this->m_exec_conf->msg->warning() << "hpmc: ghost_aabb is not supported on the GPU, ignoring" << std::endl;
+            }
+
+        //! Enable replaying the trial move sweep from a CUDA graph
+        virtual void setCUDAGraph(bool cuda_graph)
+            {
+            #if (CUDART_VERSION >= 10010)
+            if (cuda_graph && this->m_exec_conf->getNumActiveGPUs() > 1)
+                {
+                this->m_exec_conf->msg->warning() << "hpmc: CUDA graphs are not supported on multiple GPUs, ignoring" << std::endl;
+                cuda_graph = false;
+                }
+            m_cuda_graph = cuda_graph;
+            #else
+            if (cuda_graph)
+                this->m_exec_conf->msg->warning() << "hpmc: CUDA graphs require CUDA 10.1 or newer, ignoring" << std::endl;
+            #endif
+            }
+
     protected:
         std::shared_ptr<CellList> m_cl;           //!< Cell list
-        GPUArray<unsigned int> m_cell_sets;   //!< List of cells active during each subsweep
+        GlobalArray<unsigned int> m_cell_sets; //!< List of cells active during each subsweep
         Index2D m_cell_set_indexer;           //!< Indexer into the cell set array
         uint3 m_last_dim;                     //!< Dimensions of the cell list on the last call to update
         unsigned int m_last_nmax;             //!< Last cell list NMax value allocated in excell
         detail::UpdateOrder m_cell_set_order; //!< Update order for cell sets
+        GPUPartition m_cell_set_partition;    //!< Range of the active cells of every cell set handled by each GPU
 
-        GPUArray<unsigned int> m_excell_idx;  //!< Particle indices in expanded cells
-        GPUArray<unsigned int> m_excell_size; //!< Number of particles in each expanded cell
+        GlobalArray<unsigned int> m_excell_idx;  //!< Particle indices in expanded cells
+        GlobalArray<unsigned int> m_excell_size; //!< Number of particles in each expanded cell
         Index2D m_excell_list_indexer;        //!< Indexer to access elements of the excell_idx list
 
         std::unique_ptr<Autotuner> m_tuner_update;             //!< Autotuner for the update step group and block sizes
         std::unique_ptr<Autotuner> m_tuner_excell_block_size;  //!< Autotuner for excell block_size
+        std::unique_ptr<Autotuner> m_tuner_overlaps;           //!< Autotuner for the overlap count block_size
+        GPUArray<unsigned int> m_overlap_count;              //!< Number of overlaps found by countOverlaps()
 
         cudaStream_t m_stream;                //!< CUDA stream for update kernel
+        bool m_lattice_warning_issued;        //!< True if the notice about lattice fields on one GPU has been issued
+
+        GlobalArray<hpmc_counters_t> m_counters_per_device;      //!< Acceptance counters, one slot per GPU
+        GlobalArray<hpmc_counters_t> m_type_counters_per_device; //!< Acceptance counters by type, ntypes per GPU
+        GlobalArray<Scalar> m_d_managed;                         //!< Copy of the move sizes, read by all GPUs
+        GlobalArray<Scalar> m_a_managed;                         //!< Copy of the rotation move sizes, read by all GPUs
+        GlobalArray<unsigned int> m_overlaps_managed;            //!< Copy of the interaction matrix, read by all GPUs
+
+        bool m_cuda_graph;                    //!< True if the sweep is replayed from a CUDA graph
+        GPUArray<unsigned int> m_sweep_state_host; //!< Time step and cell set order, in mapped host memory
+        GPUArray<unsigned int> m_sweep_state; //!< Copy of the time step and cell set order on the device
+        cudaEvent_t m_sweep_state_copied;     //!< Recorded after the replay that reads m_sweep_state_host
+        std::vector<char> m_graph_key;        //!< Arguments of the captured sweep
+        std::vector<char> m_last_key;         //!< Arguments of the sweep on the previous step
+        #if (CUDART_VERSION >= 10010)
+        cudaGraphExec_t m_graph_exec;         //!< The captured sweep
+        bool m_graph_valid;                   //!< True if m_graph_exec holds a captured sweep
+        #endif
 
         //! Take one timestep forward
         virtual void update(unsigned int timestep);
@@ -88,15 +163,36 @@ class IntegratorHPMCMonoGPU : public IntegratorHPMCMono<Shape>
         //! Set up excell_list
         virtual void initializeExcellMem();
 
+        //! Reallocate the cell sets and expanded cells if the dimensions of the cell list changed
+        void checkCellListDims();
+
+        //! Test if the global box is large enough for the minimum image convention of the cell list
+        bool checkBoxSize();
+
         //! Set the nominal width appropriate for looped moves
         virtual void updateCellWidth();
+
+        //! Copy the move sizes and the interaction matrix into managed memory and clear the per-GPU counters
+        void prepareMultiGPUSweep();
+
+        //! Add the counters of every GPU to the total and per type counters
+        void reduceMultiGPUCounters();
+
+        //! Append a value to a key of the sweep arguments
+        template<class T>
+        static void appendKey(std::vector<char>& key, const T& value)
+            {
+            const char *bytes = reinterpret_cast<const char *>(&value);
+            key.insert(key.end(), bytes, bytes + sizeof(T));
+            }
     };
 
 template< class Shape >
 IntegratorHPMCMonoGPU< Shape >::IntegratorHPMCMonoGPU(std::shared_ptr<SystemDefinition> sysdef,
                                                                    std::shared_ptr<CellList> cl,
                                                                    unsigned int seed)
-    : IntegratorHPMCMono<Shape>(sysdef, seed), m_cl(cl), m_cell_set_order(seed+this->m_exec_conf->getRank())
+    : IntegratorHPMCMono<Shape>(sysdef, seed), m_cl(cl), m_cell_set_order(seed+this->m_exec_conf->getRank()),
+      m_cell_set_partition(this->m_exec_conf->getGPUIds())
     {
     this->m_cl->setRadius(1);
     this->m_cl->setComputeTDB(false);
@@ -109,13 +205,42 @@ IntegratorHPMCMonoGPU< Shape >::IntegratorHPMCMonoGPU(std::shared_ptr<SystemDefi
     // set last dim to a bogus value so that it will re-init on the first call
     m_last_dim = make_uint3(0xffffffff, 0xffffffff, 0xffffffff);
     m_last_nmax = 0xffffffff;
+    m_lattice_warning_issued = false;
+    m_cuda_graph = false;
+    #if (CUDART_VERSION >= 10010)
+    m_graph_valid = false;
+    #endif
 
-    GPUArray<unsigned int> excell_size(0, this->m_exec_conf);
+    GlobalArray<unsigned int> excell_size(0, this->m_exec_conf);
     m_excell_size.swap(excell_size);
 
-    GPUArray<unsigned int> excell_idx(0, this->m_exec_conf);
+    GlobalArray<unsigned int> excell_idx(0, this->m_exec_conf);
     m_excell_idx.swap(excell_idx);
 
+    unsigned int ngpu = this->m_exec_conf->getNumActiveGPUs();
+    if (ngpu > 1)
+        {
+        GlobalArray<hpmc_counters_t> counters_per_device(ngpu, this->m_exec_conf);
+        m_counters_per_device.swap(counters_per_device);
+
+        GlobalArray<hpmc_counters_t> type_counters_per_device(ngpu*this->m_pdata->getNTypes(), this->m_exec_conf);
+        m_type_counters_per_device.swap(type_counters_per_device);
+
+        // the counters are updated with atomics from all GPUs, map them into the memory of every GPU
+        auto& gpu_map = this->m_exec_conf->getGPUIds();
+        for (unsigned int idev = 0; idev < ngpu; ++idev)
+            {
+            cudaMemAdvise(m_counters_per_device.get(), sizeof(hpmc_counters_t)*m_counters_per_device.getNumElements(),
+                cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            cudaMemAdvise(m_type_counters_per_device.get(), sizeof(hpmc_counters_t)*m_type_counters_per_device.getNumElements(),
+                cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            }
+        CHECK_CUDA_ERROR();
+        }
+
+    GPUArray<unsigned int> overlap_count(1, this->m_exec_conf);
+    m_overlap_count.swap(overlap_count);
+
     // initialize the autotuners
     // the full block size, stride and group size matrix is searched,
     // encoded as block_size*1000000 + stride*100 + group_size.
@@ -160,17 +285,27 @@ IntegratorHPMCMonoGPU< Shape >::IntegratorHPMCMonoGPU(std::shared_ptr<SystemDefi
 
     m_tuner_update.reset(new Autotuner(valid_params, 5, 1000000, "hpmc_update", this->m_exec_conf));
     m_tuner_excell_block_size.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 1000000, "hpmc_excell_block_size", this->m_exec_conf));
+    m_tuner_overlaps.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 100, "hpmc_count_overlaps", this->m_exec_conf));
 
     // create a CUDA stream
     // streams are used to ensure memory coherency until concurrent host-gpu access is fully supported (such as for compute 6.x devices
     // with appropriate kernel drivers)
     cudaStreamCreate(&m_stream);
     CHECK_CUDA_ERROR();
+
+    cudaEventCreateWithFlags(&m_sweep_state_copied, cudaEventDisableTiming);
+    CHECK_CUDA_ERROR();
     }
 
 template< class Shape >
 IntegratorHPMCMonoGPU< Shape>::~IntegratorHPMCMonoGPU()
     {
+    #if (CUDART_VERSION >= 10010)
+    if (m_graph_valid)
+        cudaGraphExecDestroy(m_graph_exec);
+    #endif
+
+    cudaEventDestroy(m_sweep_state_copied);
     cudaStreamDestroy(m_stream);
     CHECK_CUDA_ERROR();
     }
@@ -184,19 +319,30 @@ void IntegratorHPMCMonoGPU< Shape >::update(unsigned int timestep)
         throw std::runtime_error("Error during HPMC integration\n");
         }
 
+    // only lattice fields are evaluated in the trial move kernel
+    ExternalFieldLattice<Shape> *lattice = nullptr;
+    if (this->m_external)
+        {
+        lattice = dynamic_cast< ExternalFieldLattice<Shape>* >(this->m_external.get());
+        if (!lattice)
+            {
+            this->m_exec_conf->msg->error() << "GPU simulations with this external field are unsupported." << std::endl;
+            throw std::runtime_error("Error during HPMC integration\n");
+            }
+        }
+
     IntegratorHPMC::update(timestep);
+
+    // update the energy of the lattice field for logging
+    if (lattice)
+        lattice->compute(timestep);
+
     // compute the width of the active region
     Scalar3 npd = this->m_pdata->getBox().getNearestPlaneDistance();
     Scalar3 ghost_fraction = this->m_nominal_width / npd;
 
     // check if we are below a minimum image convention box size
-    // the minimum image convention comes from the global box, not the local one
-    BoxDim box = this->m_pdata->getGlobalBox();
-    Scalar3 nearest_plane_distance = box.getNearestPlaneDistance();
-
-    if ((box.getPeriodic().x && nearest_plane_distance.x <= this->m_nominal_width*2) ||
-        (box.getPeriodic().y && nearest_plane_distance.y <= this->m_nominal_width*2) ||
-        (this->m_sysdef->getNDimensions() == 3 && box.getPeriodic().z && nearest_plane_distance.z <= this->m_nominal_width*2))
+    if (!checkBoxSize())
         {
         this->m_exec_conf->msg->error() << "Simulation box too small for GPU accelerated HPMC execution - increase it so the minimum image convention works" << std::endl;
         throw std::runtime_error("Error performing HPMC update");
@@ -212,25 +358,8 @@ void IntegratorHPMCMonoGPU< Shape >::update(unsigned int timestep)
     hoomd::detail::Saru rng(this->m_seed, timestep, 0xf4a3210e);
 
     // if the cell list is a different size than last time, reinitialize the cell sets list
+    checkCellListDims();
     uint3 cur_dim = this->m_cl->getDim();
-    if (m_last_dim.x != cur_dim.x || m_last_dim.y != cur_dim.y || m_last_dim.z != cur_dim.z)
-        {
-        initializeCellSets();
-        initializeExcellMem();
-
-        m_last_dim = cur_dim;
-        m_last_nmax = this->m_cl->getNmax();
-
-        // initialize the cell set update order
-        this->m_cell_set_order.resize(m_cell_set_indexer.getH());
-        }
-
-    // if only NMax changed, only need to reallocate excell memory
-    if (m_last_nmax != this->m_cl->getNmax())
-        {
-        initializeExcellMem();
-        m_last_nmax = this->m_cl->getNmax();
-        }
 
     // test if we are in domain decomposition mode
     bool domain_decomposition = false;
@@ -239,6 +368,23 @@ void IntegratorHPMCMonoGPU< Shape >::update(unsigned int timestep)
         domain_decomposition = true;
 #endif
 
+    // split the sweep across all active GPUs, the arrays of a lattice field are only resident on the first GPU
+    unsigned int ngpu = this->m_exec_conf->getNumActiveGPUs();
+    bool multi_gpu = ngpu > 1;
+    if (multi_gpu && lattice)
+        {
+        if (!m_lattice_warning_issued)
+            {
+            this->m_exec_conf->msg->notice(2) << "hpmc: Trial moves with a lattice field are performed on the first GPU"
+                << std::endl;
+            m_lattice_warning_issued = true;
+            }
+        multi_gpu = false;
+        }
+
+    if (multi_gpu)
+        prepareMultiGPUSweep();
+
     {
     // access the particle data
     ArrayHandle<Scalar4> d_postype(this->m_pdata->getPositions(), access_location::device, access_mode::readwrite);
@@ -258,6 +404,10 @@ void IntegratorHPMCMonoGPU< Shape >::update(unsigned int timestep)
 
     ArrayHandle<hpmc_counters_t> d_counters(this->m_count_total, access_location::device, access_mode::readwrite);
 
+    // the counters by type are tallied per block and only when the move sizes are adapted
+    ArrayHandle<hpmc_counters_t> d_type_counters(this->m_count_type, access_location::device, access_mode::readwrite);
+    hpmc_counters_t *type_counters = this->m_tune_moves ? d_type_counters.data : NULL;
+
     // access the parameters and interaction matrix
     const std::vector<typename Shape::param_type, managed_allocator<typename Shape::param_type> > & params = this->getParams();
 
@@ -267,6 +417,50 @@ void IntegratorHPMCMonoGPU< Shape >::update(unsigned int timestep)
     ArrayHandle<Scalar> d_d(this->m_d, access_location::device, access_mode::read);
     ArrayHandle<Scalar> d_a(this->m_a, access_location::device, access_mode::read);
 
+    // on multiple GPUs, every GPU tallies its own counters and reads the copies in managed memory
+    std::unique_ptr< ArrayHandle<hpmc_counters_t> > d_counters_per_device;
+    std::unique_ptr< ArrayHandle<hpmc_counters_t> > d_type_counters_per_device;
+    std::unique_ptr< ArrayHandle<Scalar> > d_d_managed;
+    std::unique_ptr< ArrayHandle<Scalar> > d_a_managed;
+    std::unique_ptr< ArrayHandle<unsigned int> > d_overlaps_managed;
+    if (multi_gpu)
+        {
+        d_counters_per_device.reset(new ArrayHandle<hpmc_counters_t>(m_counters_per_device, access_location::device, access_mode::readwrite));
+        d_type_counters_per_device.reset(new ArrayHandle<hpmc_counters_t>(m_type_counters_per_device, access_location::device, access_mode::readwrite));
+        d_d_managed.reset(new ArrayHandle<Scalar>(m_d_managed, access_location::device, access_mode::read));
+        d_a_managed.reset(new ArrayHandle<Scalar>(m_a_managed, access_location::device, access_mode::read));
+        d_overlaps_managed.reset(new ArrayHandle<unsigned int>(m_overlaps_managed, access_location::device, access_mode::read));
+        }
+
+    // access the tags and reference arrays of the lattice field
+    detail::hpmc_lattice_args_t lattice_args;
+    std::unique_ptr< ArrayHandle<unsigned int> > d_tag;
+    std::unique_ptr< ArrayHandle<Scalar3> > d_r0;
+    std::unique_ptr< ArrayHandle<Scalar4> > d_q0;
+    std::unique_ptr< ArrayHandle<Scalar4> > d_symmetry;
+    if (lattice)
+        {
+        d_tag.reset(new ArrayHandle<unsigned int>(this->m_pdata->getTags(), access_location::device, access_mode::read));
+        lattice_args.d_tag = d_tag->data;
+        if (lattice->hasReferencePositions())
+            {
+            d_r0.reset(new ArrayHandle<Scalar3>(lattice->getReferenceLatticePositions(), access_location::device, access_mode::read));
+            lattice_args.d_r0 = d_r0->data;
+            }
+        if (lattice->hasReferenceOrientations())
+            {
+            d_q0.reset(new ArrayHandle<Scalar4>(lattice->getReferenceLatticeOrientations(), access_location::device, access_mode::read));
+            lattice_args.d_q0 = d_q0->data;
+            }
+        d_symmetry.reset(new ArrayHandle<Scalar4>(lattice->getSymmetryArray(), access_location::device, access_mode::read));
+        lattice_args.d_symmetry = d_symmetry->data;
+        lattice_args.n_symmetry = lattice->getSymmetryArray().getNumElements();
+        lattice_args.k = lattice->getK();
+        lattice_args.q = lattice->getQ();
+        lattice_args.origin = this->m_pdata->getOrigin();
+        lattice_args.global_box = this->m_pdata->getGlobalBox();
+        }
+
     BoxDim box = this->m_pdata->getBox();
 
     Scalar3 ghost_width = this->m_cl->getGhostWidth();
@@ -292,69 +486,261 @@ void IntegratorHPMCMonoGPU< Shape >::update(unsigned int timestep)
 
     this->m_tuner_excell_block_size->end();
 
-    // on the first iteration, shape parameters are updated
-    bool first = true;
+    // the launch parameters are fixed during a sweep
+    unsigned int param = m_tuner_update->getParam();
+    unsigned int block_size = param / 1000000;
+    unsigned int stride = (param % 1000000 ) / 100;
+    unsigned int group_size = param % 100;
+
+    unsigned int n_sets = m_cell_set_indexer.getH();
+    unsigned int n_launches = this->m_nselect * particles_per_cell * n_sets;
+    unsigned int seed = this->m_seed + this->m_exec_conf->getRank()*this->m_nselect*particles_per_cell;
+
+    // launch the kernels of one sweep, reading the time step and cell set order from d_sweep_state if set
+    auto launch_sweep = [&](const unsigned int *d_sweep_state, bool tune)
+        {
+        // on the first iteration, shape parameters are updated
+        bool first = !d_sweep_state;
+
+        unsigned int n_devices = multi_gpu ? ngpu : 1;
+
+        for (unsigned int i = 0; i < this->m_nselect * particles_per_cell; i++)
+            {
+            for (unsigned int j = 0; j < n_sets; j++)
+                {
+                unsigned cur_set = d_sweep_state ? 0 : this->m_cell_set_order[j];
+                if (tune)
+                    {
+                    this->m_tuner_update->begin();
+
+                    param = m_tuner_update->getParam();
+                    block_size = param / 1000000;
+                    stride = (param % 1000000 ) / 100;
+                    group_size = param % 100;
+                    }
+
+                // the GPUs update disjoint ranges of the active cells of this set
+                for (int idev = n_devices - 1; idev >= 0; --idev)
+                    {
+                    unsigned int first_active = 0;
+                    unsigned int n_active = m_cell_set_indexer.getW();
+                    hpmc_counters_t *counters = d_counters.data;
+                    hpmc_counters_t *cur_type_counters = type_counters;
+                    const Scalar *d_d_cur = d_d.data;
+                    const Scalar *d_a_cur = d_a.data;
+                    const unsigned int *d_overlaps_cur = d_overlaps.data;
+                    cudaStream_t stream = m_stream;
+                    if (multi_gpu)
+                        {
+                        auto range = m_cell_set_partition.getRangeAndSetGPU(idev);
+                        first_active = range.first;
+                        n_active = range.second - range.first;
+                        counters = d_counters_per_device->data + idev;
+                        cur_type_counters = type_counters ?
+                            d_type_counters_per_device->data + idev*this->m_pdata->getNTypes() : NULL;
+                        d_d_cur = d_d_managed->data;
+                        d_a_cur = d_a_managed->data;
+                        d_overlaps_cur = d_overlaps_managed->data;
+                        stream = 0;
+
+                        if (n_active == 0)
+                            continue;
+                        }
+
+                    detail::gpu_hpmc_update<Shape> (detail::hpmc_args_t(d_postype.data,
+                                                                        d_orientation.data,
+                                                                        counters,
+                                                                        d_cell_idx.data,
+                                                                        d_cell_size.data,
+                                                                        d_excell_idx.data,
+                                                                        d_excell_size.data,
+                                                                        this->m_cl->getCellIndexer(),
+                                                                        this->m_cl->getCellListIndexer(),
+                                                                        m_excell_list_indexer,
+                                                                        this->m_cl->getDim(),
+                                                                        ghost_width,
+                                                                        &d_cell_sets.data[m_cell_set_indexer(first_active,cur_set)],
+                                                                        n_active,
+                                                                        this->m_pdata->getN(),
+                                                                        this->m_pdata->getNTypes(),
+                                                                        seed + i,
+                                                                        d_d_cur,
+                                                                        d_a_cur,
+                                                                        d_overlaps_cur,
+                                                                        this->m_overlap_idx,
+                                                                        this->m_move_ratio,
+                                                                        timestep,
+                                                                        this->m_sysdef->getNDimensions(),
+                                                                        box,
+                                                                        i,
+                                                                        ghost_fraction,
+                                                                        domain_decomposition,
+                                                                        block_size,
+                                                                        stride,
+                                                                        group_size,
+                                                                        this->m_hasOrientation,
+                                                                        this->m_pdata->getMaxN(),
+                                                                        this->m_exec_conf->dev_prop,
+                                                                        first,
+                                                                        stream,
+                                                                        NULL,
+                                                                        NULL,
+                                                                        NULL,
+                                                                        d_sweep_state,
+                                                                        j,
+                                                                        m_cell_set_indexer.getW(),
+                                                                        lattice ? &lattice_args : NULL,
+                                                                        cur_type_counters),
+                                                    params.data());
+                    }
+
+                if (multi_gpu)
+                    this->m_exec_conf->multiGPUBarrier();
+
+                if (tune)
+                    {
+                    if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+                        CHECK_CUDA_ERROR();
+
+                    this->m_tuner_update->end();
+                    }
+
+                first = false;
+                }
+            }
+        };
 
     // loop over cell sets in a shuffled order
     this->m_cell_set_order.shuffle(timestep);
-    for (unsigned int i = 0; i < this->m_nselect * particles_per_cell; i++)
+
+    // collect all arguments of the kernel launches that do not change every step
+    std::vector<char> key;
+    appendKey(key, d_postype.data);
+    appendKey(key, d_orientation.data);
+    appendKey(key, d_counters.data);
+    appendKey(key, type_counters);
+    appendKey(key, d_cell_idx.data);
+    appendKey(key, d_cell_size.data);
+    appendKey(key, d_excell_idx.data);
+    appendKey(key, d_excell_size.data);
+    appendKey(key, d_cell_sets.data);
+    appendKey(key, d_d.data);
+    appendKey(key, d_a.data);
+    appendKey(key, d_overlaps.data);
+    appendKey(key, params.data());
+    appendKey(key, this->m_cl->getCellListIndexer().getNumElements());
+    appendKey(key, m_excell_list_indexer.getNumElements());
+    appendKey(key, cur_dim);
+    appendKey(key, ghost_width);
+    appendKey(key, m_cell_set_indexer.getW());
+    appendKey(key, n_sets);
+    appendKey(key, this->m_pdata->getN());
+    appendKey(key, this->m_pdata->getNTypes());
+    appendKey(key, this->m_pdata->getMaxN());
+    appendKey(key, seed);
+    appendKey(key, this->m_overlap_idx.getNumElements());
+    appendKey(key, this->m_move_ratio);
+    appendKey(key, box.getLo());
+    appendKey(key, box.getL());
+    appendKey(key, box.getTiltFactorXY());
+    appendKey(key, box.getTiltFactorXZ());
+    appendKey(key, box.getTiltFactorYZ());
+    appendKey(key, box.getPeriodic());
+    appendKey(key, ghost_fraction);
+    appendKey(key, particles_per_cell);
+    appendKey(key, this->m_nselect);
+    appendKey(key, param);
+    appendKey(key, lattice_args.d_tag);
+    appendKey(key, lattice_args.d_r0);
+    appendKey(key, lattice_args.d_q0);
+    appendKey(key, lattice_args.d_symmetry);
+    appendKey(key, lattice_args.n_symmetry);
+    appendKey(key, lattice_args.k);
+    appendKey(key, lattice_args.q);
+    appendKey(key, lattice_args.origin);
+    appendKey(key, lattice_args.global_box.getLo());
+    appendKey(key, lattice_args.global_box.getL());
+    appendKey(key, lattice_args.global_box.getTiltFactorXY());
+    appendKey(key, lattice_args.global_box.getTiltFactorXZ());
+    appendKey(key, lattice_args.global_box.getTiltFactorYZ());
+
+    bool use_graph = false;
+    #if (CUDART_VERSION >= 10010)
+    // replay only sweeps that have the same structure as on the previous step, so that the shape parameters
+    // have been loaded by a regular sweep before the capture
+    use_graph = m_cuda_graph && !multi_gpu && !m_tuner_update->isSampling() && key == m_last_key;
+    #endif
+    m_last_key = key;
+
+    if (!use_graph)
+        {
+        if (multi_gpu)
+            this->m_exec_conf->beginMultiGPU();
+
+        launch_sweep(NULL, true);
+
+        if (multi_gpu)
+            this->m_exec_conf->endMultiGPU();
+        }
+    #if (CUDART_VERSION >= 10010)
+    else
         {
-        for (unsigned int j = 0; j < m_cell_set_indexer.getH(); j++)
+        if (m_sweep_state.getNumElements() != n_sets + 1)
             {
-            unsigned cur_set = this->m_cell_set_order[j];
-            this->m_tuner_update->begin();
+            GPUArray<unsigned int> sweep_state_host(n_sets + 1, this->m_exec_conf, true);
+            m_sweep_state_host.swap(sweep_state_host);
+            GPUArray<unsigned int> sweep_state(n_sets + 1, this->m_exec_conf);
+            m_sweep_state.swap(sweep_state);
+            m_graph_key.clear();
+            }
 
-            unsigned int param = m_tuner_update->getParam();
-            unsigned int block_size = param / 1000000;
-            unsigned int stride = (param % 1000000 ) / 100;
-            unsigned int group_size = param % 100;
-
-            detail::gpu_hpmc_update<Shape> (detail::hpmc_args_t(d_postype.data,
-                                                                d_orientation.data,
-                                                                d_counters.data,
-                                                                d_cell_idx.data,
-                                                                d_cell_size.data,
-                                                                d_excell_idx.data,
-                                                                d_excell_size.data,
-                                                                this->m_cl->getCellIndexer(),
-                                                                this->m_cl->getCellListIndexer(),
-                                                                m_excell_list_indexer,
-                                                                this->m_cl->getDim(),
-                                                                ghost_width,
-                                                                &d_cell_sets.data[m_cell_set_indexer(0,cur_set)],
-                                                                m_cell_set_indexer.getW(),
-                                                                this->m_pdata->getN(),
-                                                                this->m_pdata->getNTypes(),
-                                                                this->m_seed + this->m_exec_conf->getRank()*this->m_nselect*particles_per_cell + i,
-                                                                d_d.data,
-                                                                d_a.data,
-                                                                d_overlaps.data,
-                                                                this->m_overlap_idx,
-                                                                this->m_move_ratio,
-                                                                timestep,
-                                                                this->m_sysdef->getNDimensions(),
-                                                                box,
-                                                                i,
-                                                                ghost_fraction,
-                                                                domain_decomposition,
-                                                                block_size,
-                                                                stride,
-                                                                group_size,
-                                                                this->m_hasOrientation,
-                                                                this->m_pdata->getMaxN(),
-                                                                this->m_exec_conf->dev_prop,
-                                                                first,
-                                                                m_stream),
-                                            params.data());
-
-            if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
-                CHECK_CUDA_ERROR();
+        // the previous replay must have read the host buffer before it is overwritten
+        cudaEventSynchronize(m_sweep_state_copied);
 
-            this->m_tuner_update->end();
+        ArrayHandle<unsigned int> h_sweep_state(m_sweep_state_host, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_sweep_state(m_sweep_state, access_location::device, access_mode::overwrite);
+
+        h_sweep_state.data[0] = timestep;
+        for (unsigned int j = 0; j < n_sets; j++)
+            h_sweep_state.data[1 + j] = this->m_cell_set_order[j];
 
-            first = false;
+        if (!m_graph_valid || key != m_graph_key)
+            {
+            this->m_exec_conf->msg->notice(6) << "hpmc: Capturing the trial move sweep in a CUDA graph" << std::endl;
+
+            if (m_graph_valid)
+                cudaGraphExecDestroy(m_graph_exec);
+            m_graph_valid = false;
+
+            cudaGraph_t graph;
+            cudaStreamBeginCapture(m_stream, cudaStreamCaptureModeRelaxed);
+            cudaMemcpyAsync(d_sweep_state.data, h_sweep_state.data, sizeof(unsigned int)*(n_sets + 1),
+                cudaMemcpyHostToDevice, m_stream);
+            launch_sweep(d_sweep_state.data, false);
+            cudaStreamEndCapture(m_stream, &graph);
+            CHECK_CUDA_ERROR();
+
+            cudaGraphInstantiate(&m_graph_exec, graph, NULL, NULL, 0);
+            cudaGraphDestroy(graph);
+            CHECK_CUDA_ERROR();
+
+            m_graph_key = key;
+            m_graph_valid = true;
+            }
+
+        cudaGraphLaunch(m_graph_exec, m_stream);
+        cudaEventRecord(m_sweep_state_copied, m_stream);
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+
+        // count the replayed launches towards the next scan of the autotuner
+        for (unsigned int k = 0; k < n_launches && !m_tuner_update->isSampling(); k++)
+            {
+            this->m_tuner_update->begin();
+            this->m_tuner_update->end();
             }
         }
+    #endif
 
     // shift particles
     Scalar3 shift = make_scalar3(0,0,0);
@@ -381,10 +767,15 @@ void IntegratorHPMCMonoGPU< Shape >::update(unsigned int timestep)
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
     }
 
+    if (multi_gpu)
+        reduceMultiGPUCounters();
+
     this->communicate(true);
 
-    // all particle have been moved, the aabb tree is now invalid
-    this->m_aabb_tree_invalid = true;
+    // all particle have been moved, the aabb tree needs to be refit
+    this->m_aabb_tree_stale = true;
+
+    this->adaptMoveSizes();
     }
 
 template< class Shape >
@@ -408,10 +799,14 @@ void IntegratorHPMCMonoGPU< Shape >::initializeCellSets()
         n_sets = 8;
         }
 
-    GPUArray< unsigned int > cell_sets(n_active, n_sets, this->m_exec_conf);
+    GlobalArray< unsigned int > cell_sets(n_active, n_sets, this->m_exec_conf);
     m_cell_sets.swap(cell_sets);
     m_cell_set_indexer = Index2D(n_active, n_sets);
 
+    // every GPU handles a contiguous range of the active cells in each set
+    m_cell_set_partition.setN(n_active);
+
+    {
     // build a list of active cells
     ArrayHandle< unsigned int > h_cell_sets(m_cell_sets, access_location::host, access_mode::overwrite);
 
@@ -435,6 +830,162 @@ void IntegratorHPMCMonoGPU< Shape >::initializeCellSets()
         }
     }
 
+    if (this->m_exec_conf->getNumActiveGPUs() > 1)
+        {
+        // the cell sets are only read during the sweeps, keep a copy on every GPU
+        auto& gpu_map = this->m_exec_conf->getGPUIds();
+        cudaMemAdvise(m_cell_sets.get(), sizeof(unsigned int)*m_cell_sets.getNumElements(), cudaMemAdviseSetReadMostly, 0);
+        for (unsigned int idev = 0; idev < this->m_exec_conf->getNumActiveGPUs(); ++idev)
+            cudaMemPrefetchAsync(m_cell_sets.get(), sizeof(unsigned int)*m_cell_sets.getNumElements(), gpu_map[idev]);
+        CHECK_CUDA_ERROR();
+        }
+    }
+
+template< class Shape >
+void IntegratorHPMCMonoGPU< Shape >::checkCellListDims()
+    {
+    uint3 cur_dim = this->m_cl->getDim();
+    if (m_last_dim.x != cur_dim.x || m_last_dim.y != cur_dim.y || m_last_dim.z != cur_dim.z)
+        {
+        initializeCellSets();
+        initializeExcellMem();
+
+        m_last_dim = cur_dim;
+        m_last_nmax = this->m_cl->getNmax();
+
+        // initialize the cell set update order
+        this->m_cell_set_order.resize(m_cell_set_indexer.getH());
+        }
+
+    // if only NMax changed, only need to reallocate excell memory
+    if (m_last_nmax != this->m_cl->getNmax())
+        {
+        initializeExcellMem();
+        m_last_nmax = this->m_cl->getNmax();
+        }
+    }
+
+/*! The minimum image convention comes from the global box, not the local one
+*/
+template< class Shape >
+bool IntegratorHPMCMonoGPU< Shape >::checkBoxSize()
+    {
+    BoxDim box = this->m_pdata->getGlobalBox();
+    Scalar3 nearest_plane_distance = box.getNearestPlaneDistance();
+
+    return !((box.getPeriodic().x && nearest_plane_distance.x <= this->m_nominal_width*2) ||
+        (box.getPeriodic().y && nearest_plane_distance.y <= this->m_nominal_width*2) ||
+        (this->m_sysdef->getNDimensions() == 3 && box.getPeriodic().z && nearest_plane_distance.z <= this->m_nominal_width*2));
+    }
+
+/*! \param timestep current step
+    \param early_exit exit at first overlap found if true
+    \returns number of overlaps if early_exit=false, 1 if early_exit=true
+
+    Every thread tests one particle against the particles in its expanded cell. Boxes too small for the cell list are
+    handled by the host implementation.
+*/
+template< class Shape >
+unsigned int IntegratorHPMCMonoGPU< Shape >::countOverlaps(unsigned int timestep, bool early_exit)
+    {
+    if (!this->m_past_first_run)
+        {
+        this->m_exec_conf->msg->error() << "count_overlaps only works after a run() command" << std::endl;
+        throw std::runtime_error("Error communicating in count_overlaps");
+        }
+
+    if (!checkBoxSize())
+        return IntegratorHPMCMono<Shape>::countOverlaps(timestep, early_exit);
+
+    this->m_exec_conf->msg->notice(10) << "HPMCMonoGPU count overlaps: " << timestep << std::endl;
+
+    // particles may have moved since the last cell list build in this time step
+    this->m_cl->forceCompute(timestep);
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC count overlaps");
+
+    checkCellListDims();
+
+        {
+        // access the particle data
+        ArrayHandle<Scalar4> d_postype(this->m_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_orientation(this->m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_tag(this->m_pdata->getTags(), access_location::device, access_mode::read);
+
+        // access the cell list data
+        ArrayHandle<unsigned int> d_cell_size(this->m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_idx(this->m_cl->getIndexArray(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cell_adj(this->m_cl->getCellAdjArray(), access_location::device, access_mode::read);
+
+        ArrayHandle< unsigned int > d_excell_idx(m_excell_idx, access_location::device, access_mode::overwrite);
+        ArrayHandle< unsigned int > d_excell_size(m_excell_size, access_location::device, access_mode::overwrite);
+
+        ArrayHandle<unsigned int> d_overlaps(this->m_overlaps, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_overlap_count(m_overlap_count, access_location::device, access_mode::overwrite);
+
+        // update the expanded cells
+        this->m_tuner_excell_block_size->begin();
+        detail::gpu_hpmc_excell(d_excell_idx.data,
+                                d_excell_size.data,
+                                m_excell_list_indexer,
+                                d_cell_idx.data,
+                                d_cell_size.data,
+                                d_cell_adj.data,
+                                this->m_cl->getCellIndexer(),
+                                this->m_cl->getCellListIndexer(),
+                                this->m_cl->getCellAdjIndexer(),
+                                this->m_tuner_excell_block_size->getParam());
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        this->m_tuner_excell_block_size->end();
+
+        this->m_tuner_overlaps->begin();
+        detail::gpu_hpmc_count_overlaps<Shape>(d_overlap_count.data,
+                                               d_postype.data,
+                                               d_orientation.data,
+                                               d_tag.data,
+                                               d_excell_idx.data,
+                                               d_excell_size.data,
+                                               m_excell_list_indexer,
+                                               this->m_cl->getCellIndexer(),
+                                               this->m_cl->getDim(),
+                                               this->m_cl->getGhostWidth(),
+                                               this->m_pdata->getN(),
+                                               d_overlaps.data,
+                                               this->m_overlap_idx,
+                                               this->m_pdata->getBox(),
+                                               early_exit,
+                                               this->m_tuner_overlaps->getParam(),
+                                               m_stream,
+                                               this->m_params.data());
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        this->m_tuner_overlaps->end();
+        }
+
+    unsigned int overlap_count;
+        {
+        ArrayHandle<unsigned int> h_overlap_count(m_overlap_count, access_location::host, access_mode::read);
+        overlap_count = *h_overlap_count.data;
+        }
+
+    if (early_exit && overlap_count > 1)
+        overlap_count = 1;
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    #ifdef ENABLE_MPI
+    if (this->m_pdata->getDomainDecomposition())
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &overlap_count, 1, MPI_UNSIGNED, MPI_SUM, this->m_exec_conf->getMPICommunicator());
+        if (early_exit && overlap_count > 1)
+            overlap_count = 1;
+        }
+    #endif
+
+    return overlap_count;
+    }
+
 template< class Shape >
 void IntegratorHPMCMonoGPU< Shape >::initializeExcellMem()
     {
@@ -451,6 +1002,99 @@ void IntegratorHPMCMonoGPU< Shape >::initializeExcellMem()
     // reallocate memory
     m_excell_idx.resize(m_excell_list_indexer.getNumElements());
     m_excell_size.resize(num_cells);
+
+    if (this->m_exec_conf->getNumActiveGPUs() > 1)
+        {
+        // the expanded cells are built on the first GPU and read by all GPUs
+        auto& gpu_map = this->m_exec_conf->getGPUIds();
+        for (unsigned int idev = 0; idev < this->m_exec_conf->getNumActiveGPUs(); ++idev)
+            {
+            cudaMemAdvise(m_excell_idx.get(), sizeof(unsigned int)*m_excell_idx.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            cudaMemAdvise(m_excell_size.get(), sizeof(unsigned int)*m_excell_size.getNumElements(), cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+            }
+        CHECK_CUDA_ERROR();
+        }
+    }
+
+/*! The move sizes and the interaction matrix are stored in the memory of the first GPU. They are copied into managed
+    memory before every sweep on multiple GPUs, which is cheap compared to the sweep, and prefetched to all GPUs.
+*/
+template< class Shape >
+void IntegratorHPMCMonoGPU< Shape >::prepareMultiGPUSweep()
+    {
+    unsigned int ngpu = this->m_exec_conf->getNumActiveGPUs();
+    unsigned int ntypes = this->m_pdata->getNTypes();
+    auto& gpu_map = this->m_exec_conf->getGPUIds();
+
+    if (m_d_managed.getNumElements() != this->m_d.size())
+        {
+        GlobalArray<Scalar> d_managed(this->m_d.size(), this->m_exec_conf);
+        m_d_managed.swap(d_managed);
+        GlobalArray<Scalar> a_managed(this->m_a.size(), this->m_exec_conf);
+        m_a_managed.swap(a_managed);
+        }
+
+    if (m_overlaps_managed.getNumElements() != this->m_overlaps.getNumElements())
+        {
+        GlobalArray<unsigned int> overlaps_managed(this->m_overlaps.getNumElements(), this->m_exec_conf);
+        m_overlaps_managed.swap(overlaps_managed);
+        }
+
+    if (m_type_counters_per_device.getNumElements() != ngpu*ntypes)
+        {
+        m_type_counters_per_device.resize(ngpu*ntypes);
+        for (unsigned int idev = 0; idev < ngpu; ++idev)
+            cudaMemAdvise(m_type_counters_per_device.get(), sizeof(hpmc_counters_t)*ngpu*ntypes,
+                cudaMemAdviseSetAccessedBy, gpu_map[idev]);
+        }
+
+        {
+        ArrayHandle<Scalar> h_d(this->m_d, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_a(this->m_a, access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_overlaps(this->m_overlaps, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_d_managed(m_d_managed, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar> h_a_managed(m_a_managed, access_location::host, access_mode::overwrite);
+        ArrayHandle<unsigned int> h_overlaps_managed(m_overlaps_managed, access_location::host, access_mode::overwrite);
+
+        std::copy(h_d.data, h_d.data + this->m_d.size(), h_d_managed.data);
+        std::copy(h_a.data, h_a.data + this->m_a.size(), h_a_managed.data);
+        std::copy(h_overlaps.data, h_overlaps.data + this->m_overlaps.getNumElements(), h_overlaps_managed.data);
+
+        ArrayHandle<hpmc_counters_t> h_counters_per_device(m_counters_per_device, access_location::host, access_mode::overwrite);
+        ArrayHandle<hpmc_counters_t> h_type_counters_per_device(m_type_counters_per_device, access_location::host, access_mode::overwrite);
+        std::fill(h_counters_per_device.data, h_counters_per_device.data + ngpu, hpmc_counters_t());
+        std::fill(h_type_counters_per_device.data, h_type_counters_per_device.data + ngpu*ntypes, hpmc_counters_t());
+        }
+
+    for (unsigned int idev = 0; idev < ngpu; ++idev)
+        {
+        cudaMemPrefetchAsync(m_d_managed.get(), sizeof(Scalar)*m_d_managed.getNumElements(), gpu_map[idev]);
+        cudaMemPrefetchAsync(m_a_managed.get(), sizeof(Scalar)*m_a_managed.getNumElements(), gpu_map[idev]);
+        cudaMemPrefetchAsync(m_overlaps_managed.get(), sizeof(unsigned int)*m_overlaps_managed.getNumElements(), gpu_map[idev]);
+        }
+    if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    }
+
+template< class Shape >
+void IntegratorHPMCMonoGPU< Shape >::reduceMultiGPUCounters()
+    {
+    unsigned int ngpu = this->m_exec_conf->getNumActiveGPUs();
+    unsigned int ntypes = this->m_pdata->getNTypes();
+
+    ArrayHandle<hpmc_counters_t> h_counters_per_device(m_counters_per_device, access_location::host, access_mode::read);
+    ArrayHandle<hpmc_counters_t> h_counters(this->m_count_total, access_location::host, access_mode::readwrite);
+    for (unsigned int idev = 0; idev < ngpu; ++idev)
+        h_counters.data[0] = h_counters.data[0] + h_counters_per_device.data[idev];
+
+    if (this->m_tune_moves)
+        {
+        ArrayHandle<hpmc_counters_t> h_type_counters_per_device(m_type_counters_per_device, access_location::host, access_mode::read);
+        ArrayHandle<hpmc_counters_t> h_count_type(this->m_count_type, access_location::host, access_mode::readwrite);
+        for (unsigned int idev = 0; idev < ngpu; ++idev)
+            for (unsigned int typ = 0; typ < ntypes; ++typ)
+                h_count_type.data[typ] = h_count_type.data[typ] + h_type_counters_per_device.data[idev*ntypes + typ];
+        }
     }
 
 template< class Shape >
@@ -461,18 +1105,27 @@ void IntegratorHPMCMonoGPU< Shape >::updateCellWidth()
     this->m_image_list_valid = false;
     this->m_aabb_tree_invalid = true;
 
+    // the next sweep loads the new shape parameters, a captured sweep has to be captured again
+    m_last_key.clear();
+    m_graph_key.clear();
+
     this->m_nominal_width = this->getMaxCoreDiameter();
     this->m_cl->setNominalWidth(this->m_nominal_width);
 
-    // attach the parameters to the kernel stream so that they are visible
-    // when other kernels are called
-    cudaStreamAttachMemAsync(m_stream, this->m_params.data(), 0, cudaMemAttachSingle);
-    CHECK_CUDA_ERROR();
     #if (CUDART_VERSION >= 8000)
     cudaMemAdvise(this->m_params.data(), this->m_params.size()*sizeof(typename Shape::param_type), cudaMemAdviseSetReadMostly, 0);
     CHECK_CUDA_ERROR();
     #endif
 
+    // on multiple GPUs, the parameters are read by the kernels on the default stream of every GPU
+    if (this->m_exec_conf->getNumActiveGPUs() > 1)
+        return;
+
+    // attach the parameters to the kernel stream so that they are visible
+    // when other kernels are called
+    cudaStreamAttachMemAsync(m_stream, this->m_params.data(), 0, cudaMemAttachSingle);
+    CHECK_CUDA_ERROR();
+
     for (unsigned int i = 0; i < this->m_pdata->getNTypes(); ++i)
         {
         // attach nested memory regions
@@ -93,6 +93,13 @@ class IntegratorHPMCMonoImplicit : public IntegratorHPMCMono<Shape>
             return m_n_trial;
             }
 
+        //! Depletants extend the interaction range beyond the AABBs, always use the circumsphere ghost layer
+        virtual void setGhostAABB(bool ghost_aabb)
+            {
+            if (ghost_aabb)
+                this->m_exec_conf->msg->warning() << "hpmc: ghost_aabb is not supported with implicit depletants, ignoring" << std::endl;
+            }
+
         //! Reset statistics counters
         virtual void resetStats()
             {
@@ -445,6 +452,10 @@ void IntegratorHPMCMonoImplicit< Shape >::update(unsigned int timestep)
         ArrayHandle<Scalar> h_d(this->m_d, access_location::host, access_mode::read);
         ArrayHandle<Scalar> h_a(this->m_a, access_location::host, access_mode::read);
 
+        // the counters by type are only tallied when the move sizes are adapted
+        ArrayHandle<hpmc_counters_t> h_count_type(this->m_count_type, access_location::host, access_mode::readwrite);
+        hpmc_counters_t *counters_type = this->m_tune_moves ? h_count_type.data : NULL;
+
         // loop through N particles in a shuffled order
         for (unsigned int cur_particle = 0; cur_particle < this->m_pdata->getN(); cur_particle++)
             {
@@ -532,7 +543,7 @@ void IntegratorHPMCMonoImplicit< Shape >::update(unsigned int timestep)
                 // stackless search
                 for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
                     {
-                    if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    if (this->m_aabb_tree.overlapNode(cur_node_idx, aabb))
                         {
                         if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
                             {
@@ -639,7 +650,7 @@ void IntegratorHPMCMonoImplicit< Shape >::update(unsigned int timestep)
                     // stackless search
                     for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
                         {
-                        if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                        if (this->m_aabb_tree.overlapNode(cur_node_idx, aabb))
                             {
                             if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
                                 {
@@ -741,6 +752,11 @@ void IntegratorHPMCMonoImplicit< Shape >::update(unsigned int timestep)
                       counters.translate_accept_count++;
                   else
                       counters.rotate_accept_count++;
+
+                  if (counters_type && move_type_translate)
+                      counters_type[typ_i].translate_accept_count++;
+                  else if (counters_type)
+                      counters_type[typ_i].rotate_accept_count++;
                   }
                 // update the position of the particle in the tree for future updates
                 detail::AABB aabb = aabb_i_local;
@@ -764,6 +780,11 @@ void IntegratorHPMCMonoImplicit< Shape >::update(unsigned int timestep)
                         counters.translate_reject_count++;
                     else
                         counters.rotate_reject_count++;
+
+                    if (counters_type && move_type_translate)
+                        counters_type[typ_i].translate_reject_count++;
+                    else if (counters_type)
+                        counters_type[typ_i].rotate_reject_count++;
                     }
                 }
             } // end loop over all particles
@@ -814,8 +835,10 @@ void IntegratorHPMCMonoImplicit< Shape >::update(unsigned int timestep)
     // migrate and exchange particles
     this->communicate(true);
 
-    // all particle have been moved, the aabb tree is now invalid
-    this->m_aabb_tree_invalid = true;
+    // all particle have been moved, the aabb tree needs to be refit
+    this->m_aabb_tree_stale = true;
+
+    this->adaptMoveSizes();
     }
 
 
@@ -1001,7 +1024,7 @@ inline bool IntegratorHPMCMonoImplicit<Shape>::checkDepletantCircumsphere(unsign
                     // stackless search
                     for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
                         {
-                        if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                        if (this->m_aabb_tree.overlapNode(cur_node_idx, aabb))
                             {
                             if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
                                 {
@@ -1267,7 +1290,7 @@ inline bool IntegratorHPMCMonoImplicit<Shape>::checkDepletantOverlap(unsigned in
         // stackless search
         for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
             {
-            if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+            if (this->m_aabb_tree.overlapNode(cur_node_idx, aabb))
                 {
                 if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
                     {
@@ -1804,7 +1827,7 @@ inline bool IntegratorHPMCMonoImplicit<Shape>::insertDepletant(vec3<Scalar>& pos
             // stackless search
             for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree.getNumNodes(); cur_node_idx++)
                 {
-                if (detail::overlap(this->m_aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                if (this->m_aabb_tree.overlapNode(cur_node_idx, aabb))
                     {
                     if (this->m_aabb_tree.isNodeLeaf(cur_node_idx))
                         {
@@ -330,6 +330,12 @@ void IntegratorHPMCMonoImplicitGPU< Shape >::update(unsigned int timestep)
         throw std::runtime_error("Error during implicit depletant integration\n");
         }
 
+    if (this->m_external)
+        {
+        this->m_exec_conf->msg->error() << "GPU simulations with depletants and external fields are unsupported." << std::endl;
+        throw std::runtime_error("Error during implicit depletant integration\n");
+        }
+
     IntegratorHPMC::update(timestep);
 
     // update poisson distributions
@@ -835,8 +841,8 @@ void IntegratorHPMCMonoImplicitGPU< Shape >::update(unsigned int timestep)
 
     this->communicate(true);
 
-    // all particle have been moved, the aabb tree is now invalid
-    this->m_aabb_tree_invalid = true;
+    // all particle have been moved, the aabb tree needs to be refit
+    this->m_aabb_tree_stale = true;
     }
 
 template<class Shape>
@@ -0,0 +1,151 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "IntegratorHPMCMonoImplicitNewGPU.cuh"
+
+#include "hoomd/extern/cub/cub/cub.cuh"
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+/*! \file IntegratorHPMCMonoImplicitNewGPU.cu
+    \brief Definition of the shape independent CUDA kernels and drivers for IntegratorHPMCMonoImplicitNew
+*/
+
+//! Number of threads of gpu_hpmc_depletant_tasks_kernel()
+const unsigned int depletant_tasks_block_size = 256;
+
+//! Draw the number of depletants of every active cell and enumerate the insertion tasks
+/*! \param d_cell_set List of active cells
+    \param n_active_cells Number of active cells
+    \param d_cell_size Number of particles in each cell
+    \param d_postype Particle positions and types by index
+    \param d_active_cell_ptl_idx Updated particle index per active cell
+    \param d_active_cell_accept =1 if the move of the active cell has not been rejected yet
+    \param d_poisson Poisson distribution of the number of depletants (per type)
+    \param d_state_cell RNG state per active cell
+    \param seed RNG seed
+    \param timestep Current time step
+    \param select Current selection
+    \param reinitialize_curand If true, seed the RNG states
+    \param n_groups Number of depletants inserted in one task
+    \param d_n_depletants Number of depletants per active cell (output)
+    \param d_task_start Index of the first task of every active cell, and the total number of tasks at
+                        n_active_cells (output)
+
+    A single block loops over the active cells, the exclusive scan of the task counts is carried over from one
+    iteration to the next.
+*/
+__global__ void gpu_hpmc_depletant_tasks_kernel(const unsigned int *d_cell_set,
+                                                const unsigned int n_active_cells,
+                                                const unsigned int *d_cell_size,
+                                                const Scalar4 *d_postype,
+                                                const unsigned int *d_active_cell_ptl_idx,
+                                                const unsigned int *d_active_cell_accept,
+                                                const curandDiscreteDistribution_t *d_poisson,
+                                                curandState_t *d_state_cell,
+                                                const unsigned int seed,
+                                                const unsigned int timestep,
+                                                const unsigned int select,
+                                                const bool reinitialize_curand,
+                                                const unsigned int n_groups,
+                                                unsigned int *d_n_depletants,
+                                                unsigned int *d_task_start)
+    {
+    typedef cub::BlockScan<unsigned int, depletant_tasks_block_size> BlockScan;
+    __shared__ typename BlockScan::TempStorage temp_storage;
+    __shared__ unsigned int s_carry;
+
+    if (threadIdx.x == 0)
+        s_carry = 0;
+    __syncthreads();
+
+    for (unsigned int cur_offset = 0; cur_offset < n_active_cells; cur_offset += depletant_tasks_block_size)
+        {
+        unsigned int active_cell_idx = cur_offset + threadIdx.x;
+        unsigned int n_depletants = 0;
+
+        if (active_cell_idx < n_active_cells)
+            {
+            curandState_t local_state;
+            if (reinitialize_curand)
+                {
+                curand_init((unsigned long long)(seed+active_cell_idx), (unsigned long long)timestep, select, &local_state);
+                }
+            else
+                {
+                local_state = d_state_cell[active_cell_idx];
+                }
+
+            // draw a poisson random number for every active cell with a move that has not been rejected
+            unsigned int my_cell = d_cell_set[active_cell_idx];
+            unsigned int i = d_active_cell_ptl_idx[active_cell_idx];
+            if (d_cell_size[my_cell] && i != UINT_MAX && d_active_cell_accept[active_cell_idx])
+                {
+                unsigned int type_i = __scalar_as_int(d_postype[i].w);
+                n_depletants = curand_discrete(&local_state, d_poisson[type_i]);
+                }
+
+            d_state_cell[active_cell_idx] = local_state;
+            d_n_depletants[active_cell_idx] = n_depletants;
+            }
+
+        unsigned int n_tasks = (n_depletants + n_groups - 1)/n_groups;
+        unsigned int task_start, n_tasks_total;
+        BlockScan(temp_storage).ExclusiveSum(n_tasks, task_start, n_tasks_total);
+
+        if (active_cell_idx < n_active_cells)
+            d_task_start[active_cell_idx] = s_carry + task_start;
+
+        // temp_storage and s_carry are reused in the next iteration
+        __syncthreads();
+        if (threadIdx.x == 0)
+            s_carry += n_tasks_total;
+        __syncthreads();
+        }
+
+    if (threadIdx.x == 0)
+        d_task_start[n_active_cells] = s_carry;
+    }
+
+//! Kernel driver for gpu_hpmc_depletant_tasks_kernel()
+/*! \param args Bundled arguments
+    \param n_groups Number of depletants inserted in one task
+    \param reinitialize_curand If true, seed the RNG states
+    \returns Error codes generated by any CUDA calls, or cudaSuccess when there is no error
+
+    \ingroup hpmc_kernels
+*/
+cudaError_t gpu_hpmc_depletant_tasks(const hpmc_implicit_args_new_t& args,
+                                     unsigned int n_groups,
+                                     bool reinitialize_curand)
+    {
+    assert(args.d_n_depletants);
+    assert(args.d_task_start);
+    assert(n_groups >= 1);
+
+    gpu_hpmc_depletant_tasks_kernel<<<1, depletant_tasks_block_size, 0, args.stream>>>(args.d_cell_set,
+        args.n_active_cells,
+        args.d_cell_size,
+        args.d_postype,
+        args.d_active_cell_ptl_idx,
+        args.d_active_cell_accept,
+        args.d_poisson,
+        args.d_state_cell,
+        args.seed,
+        args.timestep,
+        args.select,
+        reinitialize_curand,
+        n_groups,
+        args.d_n_depletants,
+        args.d_task_start);
+
+    return cudaSuccess;
+    }
+
+}; // end namespace detail
+
+} // end namespace hpmc
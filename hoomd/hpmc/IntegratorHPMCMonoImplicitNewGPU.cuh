@@ -18,6 +18,7 @@
 #include "HPMCPrecisionSetup.h"
 #include "Moves.h"
 #include "hoomd/Saru.h"
+#include "hoomd/Philox.h"
 #include "hoomd/TextureTools.h"
 #endif
 
@@ -80,7 +81,10 @@ struct hpmc_implicit_args_new_t
                 const Scalar *_d_d_min,
                 const Scalar *_d_d_max,
                 bool _update_shape_param,
-                cudaStream_t _stream
+                cudaStream_t _stream,
+                unsigned int *_d_n_depletants = NULL,
+                unsigned int *_d_task_start = NULL,
+                unsigned int *_d_task_counter = NULL
                 )
                 : d_postype(_d_postype),
                   d_orientation(_d_orientation),
@@ -126,7 +130,10 @@ struct hpmc_implicit_args_new_t
                   d_d_min(_d_d_min),
                   d_d_max(_d_d_max),
                   update_shape_param(_update_shape_param),
-                  stream(_stream)
+                  stream(_stream),
+                  d_n_depletants(_d_n_depletants),
+                  d_task_start(_d_task_start),
+                  d_task_counter(_d_task_counter)
         {
         };
 
@@ -175,8 +182,16 @@ struct hpmc_implicit_args_new_t
     const Scalar *d_d_max;             //!< Maximum insertion diameter for depletants (per type)
     bool update_shape_param;           //!< True if this is the first iteration
     cudaStream_t stream;               //!< CUDA stream for kernel execution
+    unsigned int *d_n_depletants;      //!< Number of depletants per active cell
+    unsigned int *d_task_start;        //!< First insertion task per active cell (n_active_cells+1 entries)
+    unsigned int *d_task_counter;      //!< Work queue counter of the insertion tasks
     };
 
+//! Draw the number of depletants per active cell and enumerate the insertion tasks
+cudaError_t gpu_hpmc_depletant_tasks(const hpmc_implicit_args_new_t& args,
+                                     unsigned int n_groups,
+                                     bool reinitialize_curand);
+
 template< class Shape >
 cudaError_t gpu_hpmc_insert_depletants_queue(const hpmc_implicit_args_new_t &args, const typename Shape::param_type *d_params);
 
@@ -197,46 +212,57 @@ scalar4_tex_t depletants_postype_old_tex;
 //! Texture for reading orientation
 scalar4_tex_t depletants_orientation_old_tex;
 
+//! Kernel to insert depletants into the excluded volume of the moved particles
+/*! \param d_n_depletants Number of depletants per active cell
+    \param d_task_start Index of the first task of every active cell, and the total number of tasks at n_active_cells
+    \param d_task_counter Counter of the tasks handed out to the blocks
+    \param max_cache_size Maximum number of neighbor particles cached in shared memory
+
+    The depletants of all active cells are pooled in tasks of n_groups depletants each, which are enumerated by
+    gpu_hpmc_depletant_tasks_kernel(). Every block of this kernel takes the next task from the work queue
+    \a d_task_counter, until all tasks are done. The groups in the block each insert one depletant of the task, so
+    that the work of a block does not depend on the Poisson distributed number of depletants of its cell, and the
+    depletants of a cell with many insertions are spread over many blocks.
+
+    All depletants of a task belong to the same cell, so the block caches the positions and orientations of the
+    particles in the expanded cell in shared memory once per task. The overlap checks are then distributed over
+    the threads of the block through a shared queue, as in gpu_hpmc_mpmc_kernel().
+
+    Tasks of cells with a depletant overlap found by another block are skipped.
+
+    \ingroup hpmc_kernels
+*/
 template< class Shape >
-__global__ void gpu_hpmc_insert_depletants_queue_kernel(Scalar4 *d_postype,
-                                     Scalar4 *d_orientation,
+__global__ void gpu_hpmc_insert_depletants_queue_kernel(const Scalar4 *d_postype,
+                                     const Scalar4 *d_orientation,
                                      hpmc_counters_t *d_counters,
-                                     const unsigned int *d_cell_idx,
-                                     const unsigned int *d_cell_size,
                                      const unsigned int *d_excell_idx,
                                      const unsigned int *d_excell_size,
-                                     const Index3D ci,
-                                     const Index2D cli,
                                      const Index2D excli,
-                                     const uint3 cell_dim,
-                                     const Scalar3 ghost_width,
                                      const unsigned int *d_cell_set,
                                      const unsigned int n_active_cells,
-                                     const unsigned int N,
                                      const unsigned int num_types,
                                      const unsigned int seed,
                                      const unsigned int *d_check_overlaps,
                                      const Index2D overlap_idx,
                                      const unsigned int timestep,
-                                     const unsigned int dim,
                                      const BoxDim box,
                                      const unsigned int select,
                                      const unsigned int *d_active_cell_ptl_idx,
-                                     const unsigned int *d_active_cell_accept,
                                      const typename Shape::param_type *d_params,
                                      unsigned int max_queue_size,
+                                     unsigned int max_cache_size,
                                      unsigned int max_extra_bytes,
                                      unsigned int depletant_type,
                                      const Scalar4 *d_postype_old,
                                      const Scalar4 *d_orientation_old,
                                      unsigned int *d_overlap_cell,
                                      hpmc_implicit_counters_t *d_implicit_counters,
-                                     curandState_t *d_state_cell,
-                                     curandState_t *d_state_cell_new,
-                                     const curandDiscreteDistribution_t *d_poisson,
                                      const Scalar *d_d_min,
                                      const Scalar *d_d_max,
-                                     bool reinitialize_curand)
+                                     const unsigned int *d_n_depletants,
+                                     const unsigned int *d_task_start,
+                                     unsigned int *d_task_counter)
     {
     // flags to tell what type of thread we are
     unsigned int group;
@@ -263,6 +289,9 @@ __global__ void gpu_hpmc_insert_depletants_queue_kernel(Scalar4 *d_postype,
         n_groups = blockDim.y;
         }
 
+    unsigned int tidx = threadIdx.x+blockDim.x*threadIdx.y + blockDim.x*blockDim.y*threadIdx.z;
+    unsigned int block_size = blockDim.x*blockDim.y*blockDim.z;
+
     unsigned int err_count = 0;
 
     // shared arrays for per type pair parameters
@@ -274,20 +303,24 @@ __global__ void gpu_hpmc_insert_depletants_queue_kernel(Scalar4 *d_postype,
     __shared__ unsigned int s_still_searching;
 
     __shared__ unsigned int s_reject;
+    __shared__ unsigned int s_task;
+    __shared__ unsigned int s_active_cell_idx;
+    __shared__ unsigned int s_skip;
 
     // load the per type pair parameters into shared memory
     extern __shared__ char s_data[];
     typename Shape::param_type *s_params = (typename Shape::param_type *)(&s_data[0]);
     Scalar4 *s_orientation_group = (Scalar4*)(s_params + num_types);
     Scalar3 *s_pos_group = (Scalar3*)(s_orientation_group + n_groups);
-    unsigned int *s_check_overlaps = (unsigned int *) (s_pos_group + n_groups);
-    unsigned int *s_queue_j = (unsigned int*)(s_check_overlaps + overlap_idx.getNumElements());
-    unsigned int *s_queue_gid = (unsigned int*)(s_queue_j + max_queue_size);
+    Scalar4 *s_cache_postype = (Scalar4*)(s_pos_group + n_groups);
+    Scalar4 *s_cache_orientation = (Scalar4*)(s_cache_postype + max_cache_size);
+    unsigned int *s_cache_idx = (unsigned int *)(s_cache_orientation + max_cache_size);
+    unsigned int *s_check_overlaps = (unsigned int *) (s_cache_idx + max_cache_size);
+    unsigned int *s_queue_k = (unsigned int*)(s_check_overlaps + overlap_idx.getNumElements());
+    unsigned int *s_queue_gid = (unsigned int*)(s_queue_k + max_queue_size);
 
     // copy over parameters one int per thread for fast loads
         {
-        unsigned int tidx = threadIdx.x+blockDim.x*threadIdx.y + blockDim.x*blockDim.y*threadIdx.z;
-        unsigned int block_size = blockDim.x*blockDim.y*blockDim.z;
         unsigned int param_size = num_types*sizeof(typename Shape::param_type) / sizeof(int);
 
         for (unsigned int cur_offset = 0; cur_offset < param_size; cur_offset += block_size)
@@ -324,73 +357,87 @@ __global__ void gpu_hpmc_insert_depletants_queue_kernel(Scalar4 *d_postype,
         s_overlap_checks = 0;
         s_overlap_err_count = 0;
         s_n_inserted = 0;
-        s_reject = 0;
         }
 
-    __syncthreads();
-
-    // identify the active cell that this thread handles
-    unsigned int active_cell_idx = blockIdx.x;
+    unsigned int overlap_checks = 0;
+    unsigned int n_inserted = 0;
 
-    // pull in the index of our cell
-    unsigned int my_cell = d_cell_set[active_cell_idx];
-    unsigned int my_cell_size = d_cell_size[my_cell];
+    const unsigned int n_tasks = d_task_start[n_active_cells];
 
-    // need to handle if there are no particles in this cell
-    if (my_cell_size == 0)
-        return;
-
-    // load updated particle index
-    unsigned int i = d_active_cell_ptl_idx[active_cell_idx];
+    // process tasks from the work queue
+    while (true)
+        {
+        if (master && group == 0)
+            {
+            s_task = atomicAdd(d_task_counter, 1);
+            s_reject = 0;
 
-    // if the move was not performed or has been rejected before, nothing to do here
-    if (i == UINT_MAX || !d_active_cell_accept[active_cell_idx]) return;
+            if (s_task < n_tasks)
+                {
+                // find the active cell of the task by bisection
+                unsigned int lo = 0, hi = n_active_cells;
+                while (hi - lo > 1)
+                    {
+                    unsigned int mid = (lo + hi)/2;
+                    if (d_task_start[mid] <= s_task)
+                        lo = mid;
+                    else
+                        hi = mid;
+                    }
+                s_active_cell_idx = lo;
 
-    // load updated particle position
-    Scalar4 postype_i = texFetchScalar4(d_postype, depletants_postype_tex, i);
-    unsigned int type_i = __scalar_as_int(postype_i.w);
+                // skip the task if a depletant of this cell has already caused a rejection
+                s_skip = *((volatile unsigned int *)&d_overlap_cell[lo]);
+                }
+            }
 
-    curandState_t local_state;
-    if (reinitialize_curand)
-        {
-        curand_init((unsigned long long)(seed+active_cell_idx), (unsigned long long)timestep, select, &local_state);
-        }
-    else
-        {
-        // load RNG state per cell
-        local_state = d_state_cell[active_cell_idx];
-        }
+        __syncthreads();
 
-    // for every active cell, draw a poisson random number
-    unsigned int n_depletants = curand_discrete(&local_state, d_poisson[type_i]);
+        unsigned int task = s_task;
+        if (task >= n_tasks)
+            break;
 
-    // save RNG state per cell
-    if (master && (group == 0))
-        {
-        d_state_cell_new[active_cell_idx] = local_state;
-        }
+        if (s_skip)
+            {
+            // s_task is overwritten in the next iteration
+            __syncthreads();
+            continue;
+            }
 
-    unsigned int overlap_checks = 0;
-    unsigned int n_inserted = 0;
+        unsigned int active_cell_idx = s_active_cell_idx;
+        unsigned int my_cell = d_cell_set[active_cell_idx];
+        unsigned int i = d_active_cell_ptl_idx[active_cell_idx];
+        unsigned int excell_size = d_excell_size[my_cell];
+        unsigned int n_cache = min(excell_size, max_cache_size);
 
-    Shape shape_test(quat<Scalar>(), s_params[depletant_type]);
+        // cache the particles in the expanded cell
+        for (unsigned int k = tidx; k < n_cache; k += block_size)
+            {
+            unsigned int j = d_excell_idx[excli(k, my_cell)];
+            s_cache_idx[k] = j;
+            s_cache_postype[k] = texFetchScalar4(d_postype, depletants_postype_tex, j);
+            s_cache_orientation[k] = d_orientation[j];
+            }
 
-    Scalar d_min = d_d_min[type_i];
-    Scalar d_max = d_d_max[type_i];
+        // load updated particle position
+        Scalar4 postype_i = texFetchScalar4(d_postype, depletants_postype_tex, i);
+        unsigned int type_i = __scalar_as_int(postype_i.w);
 
-    // one RNG per group
-    hoomd::detail::Saru rng(active_cell_idx*n_groups+group, seed+select, timestep);
+        unsigned int i_dep = (task - d_task_start[active_cell_idx])*n_groups + group;
+        bool active = i_dep < d_n_depletants[active_cell_idx];
 
-    // iterate over depletants
-    for (unsigned int i_dep = 0; i_dep < n_depletants; i_dep += n_groups)
-        {
-        unsigned int i_dep_local = i_dep + group;
-
-        bool active = i_dep_local < n_depletants;
+        Shape shape_test(quat<Scalar>(), s_params[depletant_type]);
 
         if (active)
             {
             n_inserted++;
+
+            // one RNG stream per depletant
+            hoomd::detail::Philox4x32 rng(active_cell_idx, timestep, seed+select, i_dep);
+
+            Scalar d_min = d_d_min[type_i];
+            Scalar d_max = d_d_max[type_i];
+
             // draw a random vector in the excluded volume sphere of the large particle
             Scalar theta = Scalar(2.0*M_PI)*rng.template s<Scalar>();
             Scalar z = Scalar(2.0)*rng.template s<Scalar>()-Scalar(1.0);
@@ -447,7 +494,7 @@ __global__ void gpu_hpmc_insert_depletants_queue_kernel(Scalar4 *d_postype,
                 // check depletant overlap with shape at old position
                 vec3<Scalar> r_ij = vec3<Scalar>(postype_i_old) - pos_test;
                 Scalar4 orientation_i_old = make_scalar4(1,0,0,0);
-                Shape shape_i_old(quat<Scalar>(quat<Scalar>(orientation_i_old)), d_params[type_i]);
+                Shape shape_i_old(quat<Scalar>(orientation_i_old), s_params[type_i]);
                 if (shape_i_old.hasOrientation())
                     {
                     orientation_i_old = texFetchScalar4(d_orientation_old, depletants_orientation_old_tex, i);
@@ -469,7 +516,7 @@ __global__ void gpu_hpmc_insert_depletants_queue_kernel(Scalar4 *d_postype,
 
             if (! overlap_old) active = false;
 
-            // stash the trial move in shared memory so that other threads in this block can process overlap checks
+            // stash the depletant in shared memory so that other threads in this block can process overlap checks
             if (master)
                 {
                 s_pos_group[group] = make_scalar3(pos_test.x, pos_test.y, pos_test.z);
@@ -483,15 +530,13 @@ __global__ void gpu_hpmc_insert_depletants_queue_kernel(Scalar4 *d_postype,
             s_still_searching = 1;
             }
 
-        // sync so that s_postype_group and s_orientation are available before other threads might process overlap checks
+        // sync so that the depletants and the cache are available before other threads process overlap checks
         __syncthreads();
 
         // counters to track progress through the loop over potential neighbors
-        unsigned int excell_size;
         unsigned int k = offset;
         if (active)
             {
-            excell_size = d_excell_size[my_cell];
             overlap_checks += excell_size;
             }
 
@@ -504,76 +549,60 @@ __global__ void gpu_hpmc_insert_depletants_queue_kernel(Scalar4 *d_postype,
             // active threads add to the queue
             if (active)
                 {
-                // prefetch j
-                unsigned int j, next_j = 0;
-                if (k < excell_size)
-                    {
-                    #if (__CUDA_ARCH__ > 300)
-                    next_j = __ldg(&d_excell_idx[excli(k, my_cell)]);
-                    #else
-                    next_j = d_excell_idx[excli(k, my_cell)];
-                    #endif
-                    }
-
                 // add to the queue as long as the queue is not full, and we have not yet reached the end of our own list
                 // and as long as no overlaps have been found
                 while (!s_reject && s_queue_size < max_queue_size && k < excell_size)
                     {
-                    if (k < excell_size)
+                    // read in the position of the neighboring particle, from the cache if possible
+                    unsigned int j;
+                    Scalar4 postype_j;
+                    if (k < n_cache)
+                        {
+                        j = s_cache_idx[k];
+                        postype_j = s_cache_postype[k];
+                        }
+                    else
                         {
-                        Scalar4 postype_j;
-                        Scalar4 orientation_j;
-                        vec3<Scalar> r_ij;
+                        #if (__CUDA_ARCH__ > 300)
+                        j = __ldg(&d_excell_idx[excli(k, my_cell)]);
+                        #else
+                        j = d_excell_idx[excli(k, my_cell)];
+                        #endif
+                        postype_j = texFetchScalar4(d_postype, depletants_postype_tex, j);
+                        }
 
-                        // build some shapes, but we only need them to get diameters, so don't load orientations
-                        // build shape i from shared memory
-                        Scalar3 pos_test = s_pos_group[group];
-                        Shape shape_test(quat<Scalar>(), s_params[depletant_type]);
+                    // build some shapes, but we only need them to get diameters, so don't load orientations
+                    Scalar3 pos_test = s_pos_group[group];
+                    unsigned int type_j = __scalar_as_int(postype_j.w);
+                    Shape shape_j(quat<Scalar>(), s_params[type_j]);
 
-                        // prefetch next j
-                        k += group_size;
-                        j = next_j;
+                    // put particle j into the coordinate system of the depletant
+                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - vec3<Scalar>(pos_test);
+                    r_ij = vec3<Scalar>(box.minImage(vec_to_scalar3(r_ij)));
 
-                        if (k < excell_size)
-                            {
-                            #if (__CUDA_ARCH__ > 300)
-                            next_j = __ldg(&d_excell_idx[excli(k, my_cell)]);
-                            #else
-                            next_j = d_excell_idx[excli(k, my_cell)];
-                            #endif
-                            }
-
-                        // read in position, and orientation of neighboring particle
-                        postype_j = texFetchScalar4(d_postype, depletants_postype_tex, j);
-                        unsigned int type_j = __scalar_as_int(postype_j.w);
-                        Shape shape_j(quat<Scalar>(orientation_j), s_params[type_j]);
+                    // test circumsphere overlap
+                    OverlapReal rsq = dot(r_ij,r_ij);
+                    OverlapReal DaDb = shape_test.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
 
-                        // put particle j into the coordinate system of particle i
-                        r_ij = vec3<Scalar>(postype_j) - vec3<Scalar>(pos_test);
-                        r_ij = vec3<Scalar>(box.minImage(vec_to_scalar3(r_ij)));
-                        // test circumsphere overlap
-                        OverlapReal rsq = dot(r_ij,r_ij);
-                        OverlapReal DaDb = shape_test.getCircumsphereDiameter() + shape_j.getCircumsphereDiameter();
+                    if (s_check_overlaps[overlap_idx(depletant_type, type_j)] && i != j && rsq*OverlapReal(4.0) <= DaDb * DaDb)
+                        {
+                        // add this particle to the queue
+                        unsigned int insert_point = atomicAdd(&s_queue_size, 1);
 
-                        if (s_check_overlaps[overlap_idx(depletant_type, type_j)] && i != j && rsq*OverlapReal(4.0) <= DaDb * DaDb)
+                        if (insert_point < max_queue_size)
                             {
-                            // add this particle to the queue
-                            unsigned int insert_point = atomicAdd(&s_queue_size, 1);
-
-                            if (insert_point < max_queue_size)
-                                {
-                                s_queue_gid[insert_point] = group;
-                                s_queue_j[insert_point] = j;
-                                }
-                            else
-                                {
-                                // or back up if the queue is already full
-                                // we will recheck and insert this on the next time through
-                                k -= group_size;
-                                }
+                            s_queue_gid[insert_point] = group;
+                            s_queue_k[insert_point] = k;
                             }
+                        else
+                            {
+                            // or back up if the queue is already full
+                            // we will recheck and insert this on the next time through
+                            break;
+                            }
+                        }
 
-                        } // end if k < excell_size
+                    k += group_size;
                     } // end while (s_queue_size < max_queue_size && k < excell_size)
                 } // end if active
 
@@ -593,25 +622,32 @@ __global__ void gpu_hpmc_insert_depletants_queue_kernel(Scalar4 *d_postype,
                 {
                 // need to extract the overlap check to perform out of the shared mem queue
                 unsigned int check_group = s_queue_gid[tidx_1d];
-                unsigned int check_j = s_queue_j[tidx_1d];
-                Scalar4 postype_j;
-                Scalar4 orientation_j;
-                vec3<Scalar> r_ij;
+                unsigned int check_k = s_queue_k[tidx_1d];
 
-                // build shape i from shared memory
+                // build the depletant from shared memory
                 Scalar3 pos_test = s_pos_group[check_group];
                 Shape shape_test(quat<Scalar>(s_orientation_group[check_group]), s_params[depletant_type]);
 
-                // build shape j from global memory
-                postype_j = texFetchScalar4(d_postype, depletants_postype_tex, check_j);
-                orientation_j = make_scalar4(1,0,0,0);
+                // build shape j from the cache or global memory
+                Scalar4 postype_j, orientation_j;
+                if (check_k < n_cache)
+                    {
+                    postype_j = s_cache_postype[check_k];
+                    orientation_j = s_cache_orientation[check_k];
+                    }
+                else
+                    {
+                    unsigned int check_j = d_excell_idx[excli(check_k, my_cell)];
+                    postype_j = texFetchScalar4(d_postype, depletants_postype_tex, check_j);
+                    orientation_j = d_orientation[check_j];
+                    }
                 unsigned int type_j = __scalar_as_int(postype_j.w);
-                Shape shape_j(quat<Scalar>(orientation_j), s_params[type_j]);
+                Shape shape_j(quat<Scalar>(), s_params[type_j]);
                 if (shape_j.hasOrientation())
-                    shape_j.orientation = quat<Scalar>(texFetchScalar4(d_orientation, depletants_orientation_tex, check_j));
+                    shape_j.orientation = quat<Scalar>(orientation_j);
 
-                // put particle j into the coordinate system of particle i
-                r_ij = vec3<Scalar>(postype_j) - vec3<Scalar>(pos_test);
+                // put particle j into the coordinate system of the depletant
+                vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - vec3<Scalar>(pos_test);
                 r_ij = vec3<Scalar>(box.minImage(vec_to_scalar3(r_ij)));
 
                 if (test_overlap(r_ij, shape_test, shape_j, err_count))
@@ -630,16 +666,15 @@ __global__ void gpu_hpmc_insert_depletants_queue_kernel(Scalar4 *d_postype,
 
             } // end while (s_still_searching)
 
-        // exit early if any depletant leads to rejection
-        if (s_reject) break;
-        } // end loop over depletants
+        // a depletant overlaps with the new configuration only, reject the move of this cell
+        if (master && group == 0 && s_reject)
+            {
+            d_overlap_cell[active_cell_idx] = 1;
+            }
 
-    // update the data if accepted
-    if (master && group == 0 && s_reject)
-        {
-        // count the overlap checks
-        d_overlap_cell[active_cell_idx] = 1;
-        }
+        // s_task, s_reject and the cache are overwritten in the next iteration
+        __syncthreads();
+        } // end loop over tasks
 
     if (err_count > 0)
         atomicAdd(&s_overlap_err_count, err_count);
@@ -662,11 +697,10 @@ __global__ void gpu_hpmc_insert_depletants_queue_kernel(Scalar4 *d_postype,
         atomicAdd(&d_counters->overlap_err_count, s_overlap_err_count);
 
         // increment number of inserted depletants
-        atomicAdd(&d_implicit_counters->insert_count, n_inserted);
+        atomicAdd(&d_implicit_counters->insert_count, s_n_inserted);
         }
     }
 
-
 //! Definition of kernel to set up cuRAND for the maximum kernel parameters
 __global__ void gpu_curand_implicit_setup(unsigned int n_rng,
                                           unsigned int seed,
@@ -676,13 +710,16 @@ __global__ void gpu_curand_implicit_setup(unsigned int n_rng,
  * Definition of templated GPU kernel drivers
  */
 
-//! Kernel driver for gpu_update_hpmc_kernel()
+//! Kernel driver for gpu_hpmc_insert_depletants_queue_kernel()
 /*! \param args Bundled arguments
     \param d_params Per-type shape parameters
     \returns Error codes generated by any CUDA calls, or cudaSuccess when there is no error
 
-    This templatized method is the kernel driver for HPMC update of any shape. It is instantiated for every shape at the
-    bottom of this file.
+    This templatized method is the kernel driver for the depletant insertion of any shape. It is instantiated for every
+    shape at the bottom of this file.
+
+    The number of depletants per active cell and the task list are generated first by gpu_hpmc_depletant_tasks(), then
+    a grid of as many blocks as fit on the device at once processes the tasks.
 
     \ingroup hpmc_kernels
 */
@@ -692,12 +729,13 @@ cudaError_t gpu_hpmc_insert_depletants_queue(const hpmc_implicit_args_new_t& arg
     assert(args.d_postype);
     assert(args.d_orientation);
     assert(args.d_counters);
-    assert(args.d_cell_idx);
-    assert(args.d_cell_size);
     assert(args.d_excell_idx);
     assert(args.d_excell_size);
     assert(args.d_cell_set);
     assert(args.d_check_overlaps);
+    assert(args.d_n_depletants);
+    assert(args.d_task_start);
+    assert(args.d_task_counter);
     assert(args.group_size >= 1);
     assert(args.stride >= 1);
 
@@ -765,6 +803,14 @@ cudaError_t gpu_hpmc_insert_depletants_queue(const hpmc_implicit_args_new_t& arg
                        min_shared_bytes;
         }
 
+    // cache as many particles of the expanded cell as fit into half of the remaining shared memory, leaving the rest
+    // to the shape parameters
+    const unsigned int cache_entry_bytes = 2*sizeof(Scalar4) + sizeof(unsigned int);
+    unsigned int max_cache_size = (args.devprop.sharedMemPerBlock - shared_bytes - attr.sharedSizeBytes)
+        / (2*cache_entry_bytes);
+    max_cache_size = min(max_cache_size, args.excli.getW());
+    shared_bytes += max_cache_size*cache_entry_bytes;
+
     static unsigned int base_shared_bytes = UINT_MAX;
     bool shared_bytes_changed = base_shared_bytes != shared_bytes + attr.sharedSizeBytes;
     base_shared_bytes = shared_bytes + attr.sharedSizeBytes;
@@ -800,23 +846,27 @@ cudaError_t gpu_hpmc_insert_depletants_queue(const hpmc_implicit_args_new_t& arg
         threads = dim3(group_size, n_groups,1);
         }
 
-    static dim3 last_threads = dim3(0,0,0);
+    // the RNG states are per active cell
+    static unsigned int last_n_active_cells = UINT_MAX;
+    bool reinitialize_curand = last_n_active_cells != args.n_active_cells;
+    last_n_active_cells = args.n_active_cells;
 
-    bool reinitialize_curand = false;
-    if (threads.x != last_threads.x || threads.y != last_threads.y || threads.z != last_threads.z)
-        {
-        // thread configuration changed
-        last_threads = threads;
-        reinitialize_curand = true;
-        }
+    // draw the number of depletants and enumerate the tasks
+    cudaError_t error = gpu_hpmc_depletant_tasks(args, n_groups, reinitialize_curand);
+    if (error != cudaSuccess)
+        return error;
 
-    // 1 block per active cell
-    dim3 grid( args.n_active_cells, 1, 1);
+    // launch only as many blocks as are resident at the same time, they pull the tasks from the work queue
+    int num_blocks_per_sm = 0;
+    cudaOccupancyMaxActiveBlocksPerMultiprocessor(&num_blocks_per_sm, gpu_hpmc_insert_depletants_queue_kernel<Shape>,
+        block_size, shared_bytes);
+    unsigned int n_blocks = max(num_blocks_per_sm, 1)*args.devprop.multiProcessorCount;
+    dim3 grid(n_blocks, 1, 1);
 
     // bind the textures
     depletants_postype_tex.normalized = false;
     depletants_postype_tex.filterMode = cudaFilterModePoint;
-    cudaError_t error = cudaBindTexture(0, depletants_postype_tex, args.d_postype, sizeof(Scalar4)*args.max_n);
+    error = cudaBindTexture(0, depletants_postype_tex, args.d_postype, sizeof(Scalar4)*args.max_n);
     if (error != cudaSuccess)
         return error;
 
@@ -843,48 +893,38 @@ cudaError_t gpu_hpmc_insert_depletants_queue(const hpmc_implicit_args_new_t& arg
 
     // reset counters
     cudaMemsetAsync(args.d_overlap_cell,0, sizeof(unsigned int)*args.n_active_cells, args.stream);
+    cudaMemsetAsync(args.d_task_counter,0, sizeof(unsigned int), args.stream);
 
     gpu_hpmc_insert_depletants_queue_kernel<Shape><<<grid, threads, shared_bytes, args.stream>>>(args.d_postype,
                                                                  args.d_orientation,
                                                                  args.d_counters,
-                                                                 args.d_cell_idx,
-                                                                 args.d_cell_size,
                                                                  args.d_excell_idx,
                                                                  args.d_excell_size,
-                                                                 args.ci,
-                                                                 args.cli,
                                                                  args.excli,
-                                                                 args.cell_dim,
-                                                                 args.ghost_width,
                                                                  args.d_cell_set,
                                                                  args.n_active_cells,
-                                                                 args.N,
                                                                  args.num_types,
                                                                  args.seed,
                                                                  args.d_check_overlaps,
                                                                  args.overlap_idx,
                                                                  args.timestep,
-                                                                 args.dim,
                                                                  args.box,
                                                                  args.select,
                                                                  args.d_active_cell_ptl_idx,
-                                                                 args.d_active_cell_accept,
                                                                  params,
                                                                  max_queue_size,
+                                                                 max_cache_size,
                                                                  max_extra_bytes,
                                                                  args.depletant_type,
                                                                  args.d_postype_old,
                                                                  args.d_orientation_old,
                                                                  args.d_overlap_cell,
                                                                  args.d_implicit_count,
-                                                                 args.d_state_cell,
-                                                                 args.d_state_cell_new,
-                                                                 args.d_poisson,
                                                                  args.d_d_min,
                                                                  args.d_d_max,
-                                                                 reinitialize_curand);
-    // advance per-cell RNG states
-    cudaMemcpyAsync(args.d_state_cell, args.d_state_cell_new, sizeof(curandState_t)*args.n_active_cells, cudaMemcpyDeviceToDevice, args.stream);
+                                                                 args.d_n_depletants,
+                                                                 args.d_task_start,
+                                                                 args.d_task_counter);
 
     return cudaSuccess;
     }
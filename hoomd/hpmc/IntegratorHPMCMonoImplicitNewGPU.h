@@ -97,6 +97,9 @@ class IntegratorHPMCMonoImplicitNewGPU : public IntegratorHPMCMonoImplicit<Shape
         GPUArray<curandState_t> m_curand_state_cell;               //!< Array of cuRAND states per active cell
         GPUArray<curandState_t> m_curand_state_cell_new;           //!< Array of cuRAND states per active cell after update
         GPUArray<unsigned int> m_overlap_cell;                   //!< Flag per cell to indicate overlap
+        GPUArray<unsigned int> m_depletant_count;                //!< Number of depletants per active cell
+        GPUArray<unsigned int> m_depletant_task_start;           //!< First depletant insertion task per active cell
+        GPUArray<unsigned int> m_depletant_task_counter;         //!< Work queue counter of the insertion tasks
         GPUArray<curandDiscreteDistribution_t> m_poisson_dist; //!< Handles for the poisson distribution histogram
         std::vector<bool> m_poisson_dist_created;               //!< Flag to indicate if Poisson distribution has been initialized
 
@@ -249,6 +252,12 @@ void IntegratorHPMCMonoImplicitNewGPU< Shape >::update(unsigned int timestep)
         throw std::runtime_error("Error during implicit depletant integration\n");
         }
 
+    if (this->m_external)
+        {
+        this->m_exec_conf->msg->error() << "GPU simulations with depletants and external fields are unsupported." << std::endl;
+        throw std::runtime_error("Error during implicit depletant integration\n");
+        }
+
     IntegratorHPMC::update(timestep);
 
     // update poisson distributions
@@ -313,6 +322,15 @@ void IntegratorHPMCMonoImplicitNewGPU< Shape >::update(unsigned int timestep)
         GPUArray<unsigned int> overlap_cell(this->m_cell_set_indexer.getW(), this->m_exec_conf);
         m_overlap_cell.swap(overlap_cell);
 
+        GPUArray<unsigned int> depletant_count(this->m_cell_set_indexer.getW(), this->m_exec_conf);
+        m_depletant_count.swap(depletant_count);
+
+        GPUArray<unsigned int> depletant_task_start(this->m_cell_set_indexer.getW()+1, this->m_exec_conf);
+        m_depletant_task_start.swap(depletant_task_start);
+
+        GPUArray<unsigned int> depletant_task_counter(1, this->m_exec_conf);
+        m_depletant_task_counter.swap(depletant_task_counter);
+
         GPUArray<unsigned int> active_cell_ptl_idx(this->m_cell_set_indexer.getW(), this->m_exec_conf);
         m_active_cell_ptl_idx.swap(active_cell_ptl_idx);
 
@@ -501,6 +519,11 @@ void IntegratorHPMCMonoImplicitNewGPU< Shape >::update(unsigned int timestep)
                     // overlap flags
                     ArrayHandle<unsigned int> d_overlap_cell(this->m_overlap_cell, access_location::device, access_mode::readwrite);
 
+                    // depletant insertion tasks
+                    ArrayHandle<unsigned int> d_depletant_count(m_depletant_count, access_location::device, access_mode::overwrite);
+                    ArrayHandle<unsigned int> d_depletant_task_start(m_depletant_task_start, access_location::device, access_mode::overwrite);
+                    ArrayHandle<unsigned int> d_depletant_task_counter(m_depletant_task_counter, access_location::device, access_mode::overwrite);
+
                     // min/max diameter of insertion sphere
                     ArrayHandle<Scalar> d_d_min(this->m_d_min, access_location::device, access_mode::read);
                     ArrayHandle<Scalar> d_d_max(this->m_d_max, access_location::device, access_mode::read);
@@ -567,7 +590,10 @@ void IntegratorHPMCMonoImplicitNewGPU< Shape >::update(unsigned int timestep)
                                 d_d_min.data,
                                 d_d_max.data,
                                 first,
-                                m_stream),
+                                m_stream,
+                                d_depletant_count.data,
+                                d_depletant_task_start.data,
+                                d_depletant_task_counter.data),
                             params.data());
 
                         if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
@@ -666,8 +692,8 @@ void IntegratorHPMCMonoImplicitNewGPU< Shape >::update(unsigned int timestep)
 
     this->communicate(true);
 
-    // all particle have been moved, the aabb tree is now invalid
-    this->m_aabb_tree_invalid = true;
+    // all particle have been moved, the aabb tree needs to be refit
+    this->m_aabb_tree_stale = true;
     }
 
 template<class Shape>
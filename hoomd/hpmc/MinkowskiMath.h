@@ -29,6 +29,7 @@ namespace detail
 //! Composite support functor
 /*! \tparam SupportFuncA Support function class type for shape A
     \tparam SupportFuncB Support function class type for shape B
+    \tparam Real Precision of the computation
 
     Helper functor that computes the support function of the Minkowski difference B-A from the given two support
     functions. The given support functions are kept in local coords and translations/rotations are performed going in
@@ -39,7 +40,7 @@ namespace detail
 
     \ingroup minkowski
 */
-template<class SupportFuncA, class SupportFuncB>
+template<class SupportFuncA, class SupportFuncB, class Real = OverlapReal>
 class CompositeSupportFunc3D
     {
     public:
@@ -51,12 +52,12 @@ class CompositeSupportFunc3D
         */
         DEVICE CompositeSupportFunc3D(const SupportFuncA& _sa,
                                     const SupportFuncB& _sb,
-                                    const vec3<OverlapReal>& _ab_t,
-                                    const quat<OverlapReal>& _q)
+                                    const vec3<Real>& _ab_t,
+                                    const quat<Real>& _q)
 #ifdef NVCC
             : sa(_sa), sb(_sb), ab_t(_ab_t), q(_q)
 #else
-            : sa(_sa), sb(_sb), ab_t(_ab_t), R(rotmat3<OverlapReal>(_q))
+            : sa(_sa), sb(_sb), ab_t(_ab_t), R(rotmat3<Real>(_q))
 #endif
             {}
 
@@ -64,15 +65,15 @@ class CompositeSupportFunc3D
         /*! \param n Normal vector input (in the A frame)
             \returns S_B(n) - S_A(n) in world space coords (transformations put n into local coords for S_A and S_b)
         */
-        DEVICE vec3<OverlapReal> operator() (const vec3<OverlapReal>& n) const
+        DEVICE vec3<Real> operator() (const vec3<Real>& n) const
             {
             // translation/rotation formula comes from pg 168 of "Games Programming Gems 7"
 #ifdef NVCC
-            vec3<OverlapReal> SB_n = rotate(q, sb(rotate(conj(q),n))) + ab_t;
-            vec3<OverlapReal> SA_n = sa(-n);
+            vec3<Real> SB_n = rotate(q, sb(rotate(conj(q),n))) + ab_t;
+            vec3<Real> SA_n = sa(-n);
 #else
-            vec3<OverlapReal> SB_n = R * sb(transpose(R)*n) + ab_t;
-            vec3<OverlapReal> SA_n = sa(-n);
+            vec3<Real> SB_n = R * sb(transpose(R)*n) + ab_t;
+            vec3<Real> SA_n = sa(-n);
 #endif
             return SB_n - SA_n;
             }
@@ -80,12 +81,12 @@ class CompositeSupportFunc3D
     private:
         const SupportFuncA& sa;    //!< Support function for shape A
         const SupportFuncB& sb;    //!< Support function for shape B
-        const vec3<OverlapReal>& ab_t;  //!< Vector pointing from a's center to b's center, in the space frame
+        const vec3<Real>& ab_t;  //!< Vector pointing from a's center to b's center, in the space frame
 #ifdef NVCC
-        const quat<OverlapReal>& q; //!< Orientation of shape B in frame A
+        const quat<Real>& q; //!< Orientation of shape B in frame A
 
 #else
-        const rotmat3<OverlapReal> R; //!< Orientation of shape B in A frame
+        const rotmat3<Real> R; //!< Orientation of shape B in A frame
 
 #endif
     };
@@ -250,7 +250,7 @@ inline vec3<Scalar> generatePositionInSphericalCap(RNG& rng, const vec3<Scalar>&
 /*! Reflect a point in R3 around a line (pi rotation), given by a point p through which it passes
     and a rotation quaternion
  */
-inline vec3<Scalar> lineReflection(vec3<Scalar> pos, vec3<Scalar> p, quat<Scalar> q)
+DEVICE inline vec3<Scalar> lineReflection(vec3<Scalar> pos, vec3<Scalar> p, quat<Scalar> q)
     {
     // find closest point on line
     vec3<Scalar> n = q.v;
@@ -8,6 +8,11 @@
 #include "hoomd/VectorMath.h"
 #include <vector>
 #include <stack>
+#include <algorithm>
+
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
 
 #include "HPMCPrecisionSetup.h"
 
@@ -40,6 +45,9 @@ namespace detail
 
 const unsigned int OBB_INVALID_NODE = 0xffffffff;   //!< Invalid node index sentinel
 
+const unsigned int OBB_TREE_SAH_BINS = 16;          //!< Number of bins per axis for the surface area heuristic
+const unsigned int OBB_TREE_PARALLEL_MIN = 256;     //!< Minimum number of OBBs in a node to build its children in parallel
+
 #ifndef NVCC
 
 //! Node in an OBBTree
@@ -76,9 +84,15 @@ struct OBBNode
 
     OBBTree stores all nodes in a flat array manged by std::vector. The tree is in *post-order*.
     The nodes store the indices of their left and right children along with their OBB. Nodes
-    are allocated as needed with allocate(). With multiple particles per leaf node, the total number of internal nodes
+    are appended as they are built. With multiple particles per leaf node, the total number of internal nodes
     needed is not known (but can be estimated) until build time.
 
+    Internal nodes are split with the binned surface area heuristic (SAH): the centroids of the contained OBBs are
+    binned along the three axes of the node OBB, and the split plane between two bins that minimizes the sum of the
+    surface areas of the two child boxes, weighted by their number of OBBs, is chosen. With TBB, the two children of
+    large nodes are built in parallel into separate node lists that are appended to the parent's list afterwards, so
+    the node order is the same as in a serial build.
+
     For performance, no recursive calls are used. Instead, each function is either turned into a loop if it uses
     tail recursion, or it uses a local stack to traverse the tree. The stack is cached between calls to limit
     the amount of dynamic memory allocation.
@@ -88,15 +102,8 @@ class OBBTree
     public:
         //! Construct an OBBTree
         OBBTree()
-            : m_nodes(0), m_num_nodes(0), m_node_capacity(0), m_leaf_capacity(0), m_root(0)
-            {
-            }
-
-        // Destructor
-        ~OBBTree()
+            : m_leaf_capacity(0), m_root(0), m_parallel_min(OBB_TREE_PARALLEL_MIN)
             {
-            if (m_nodes)
-                delete [] m_nodes;
             }
 
         //! Build a tree smartly from a list of OBBs and internal coordinates
@@ -112,7 +119,7 @@ class OBBTree
         //! Get the number of nodes
         inline unsigned int getNumNodes() const
             {
-            return m_num_nodes;
+            return (unsigned int)m_nodes.size();
             }
 
         //! Test if a given index is a leaf node
@@ -178,24 +185,38 @@ class OBBTree
             return m_leaf_capacity;
             }
 
+        //! Set the minimum number of OBBs in a node to build its children in parallel
+        /*! The tree is identical for any value, only the build time changes. Has no effect without TBB.
+        */
+        void setParallelMinimum(unsigned int parallel_min)
+            {
+            m_parallel_min = parallel_min;
+            }
+
     private:
-        OBBNode *m_nodes;                  //!< The nodes of the tree
-        unsigned int m_num_nodes;           //!< Number of nodes
-        unsigned int m_node_capacity;       //!< Capacity of the nodes array
+        std::vector<OBBNode> m_nodes;       //!< The nodes of the tree
         unsigned int m_leaf_capacity;       //!< Number of particles in leaf nodes
         unsigned int m_root;                //!< Index to the root node of the tree
+        unsigned int m_parallel_min;        //!< Minimum number of OBBs in a node to build its children in parallel
 
         //! Initialize the tree to hold N particles
         inline void init(unsigned int N);
 
         //! Build a node of the tree recursively
-        inline unsigned int buildNode(OBB *obbs, std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
+        inline unsigned int buildNode(std::vector<OBBNode>& nodes,
+            OBB *obbs, std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
             std::vector< std::vector<OverlapReal> >& vertex_radii, std::vector<unsigned int>& idx,
             unsigned int start, unsigned int len, unsigned int parent,
             bool sphere_tree);
 
-        //! Allocate a new node
-        inline unsigned int allocateNode();
+        //! Partition the OBBs of a node into its two children
+        inline unsigned int splitNode(const OBB& node_obb,
+            OBB *obbs, std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
+            std::vector< std::vector<OverlapReal> >& vertex_radii, std::vector<unsigned int>& idx,
+            unsigned int start, unsigned int len);
+
+        //! Append the nodes of a subtree to a list of nodes
+        inline unsigned int appendNodes(std::vector<OBBNode>& nodes, std::vector<OBBNode>& subtree, unsigned int parent);
 
         //! Update the escape index for a node
         inline void updateEscapeIndex(unsigned int idx, unsigned int parent_idx);
@@ -209,7 +230,7 @@ class OBBTree
 inline void OBBTree::init(unsigned int N)
     {
     // clear the nodes
-    m_num_nodes = 0;
+    m_nodes.clear();
 
     // init the root node to invalid state
     m_root = OBB_INVALID_NODE;
@@ -237,7 +258,7 @@ inline void OBBTree::buildTree(OBB *obbs, std::vector<std::vector<vec3<OverlapRe
     for (unsigned int i = 0; i < N; ++i)
         vertex_radii[i] = std::vector<OverlapReal>(internal_coordinates[i].size(), vertex_radius);
 
-    m_root = buildNode(obbs, internal_coordinates, vertex_radii, idx, 0, N, OBB_INVALID_NODE, false);
+    m_root = buildNode(m_nodes, obbs, internal_coordinates, vertex_radii, idx, 0, N, OBB_INVALID_NODE, false);
     updateEscapeIndex(m_root,getNumNodes());
     }
 
@@ -275,7 +296,7 @@ inline void OBBTree::buildTree(OBB *obbs, unsigned int N, unsigned int leaf_capa
             }
         }
 
-    m_root = buildNode(obbs, internal_coordinates, vertex_radii, idx, 0, N, OBB_INVALID_NODE, sphere_tree);
+    m_root = buildNode(m_nodes, obbs, internal_coordinates, vertex_radii, idx, 0, N, OBB_INVALID_NODE, sphere_tree);
     updateEscapeIndex(m_root, getNumNodes());
     }
 
@@ -286,20 +307,25 @@ inline bool compare_proj(const std::pair<OverlapReal,unsigned int> &lhs, const s
     return lhs.first < rhs.first;
     }
 
-/*! \param obbs List of OBBs
+/*! \param nodes List of nodes to append the new nodes to
+    \param obbs List of OBBs
+    \param internal_coordinates List of lists of vertex contents of OBBs
+    \param vertex_radii List of lists of vertex radii of OBBs
     \param idx List of indices
     \param start Start point in obbs and idx to examine
     \param len Number of obbs to examine
     \param parent Index of the parent node
+    \param sphere_tree True if the node bounding volumes are spheres
 
     buildNode is the main driver of the smart OBB tree build algorithm. Each call produces a node, given a set of
     OBBs. If there are fewer OBBs than fit in a leaf, a leaf is generated. If there are too many, the total OBB
-    is computed and split on the largest length axis. The total tree is built by recursive splitting.
+    is computed and split with splitNode(). The total tree is built by recursive splitting.
 
     The obbs and idx lists are passed in by reference. Each node is given a subrange of the list to own (start to
     start + len). When building the node, it partitions it's subrange into two sides (like quick sort).
 */
-inline unsigned int OBBTree::buildNode(OBB *obbs,
+inline unsigned int OBBTree::buildNode(std::vector<OBBNode>& nodes,
+                                       OBB *obbs,
                                        std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
                                        std::vector<std::vector<OverlapReal> >& vertex_radii,
                                        std::vector<unsigned int>& idx,
@@ -313,6 +339,12 @@ inline unsigned int OBBTree::buildNode(OBB *obbs,
     std::vector<vec3<OverlapReal> > merge_internal_coordinates;
     std::vector<OverlapReal > merge_vertex_radii;
 
+    size_t n_merge = 0;
+    for (unsigned int i = start; i < start+len; ++i)
+        n_merge += internal_coordinates[i].size();
+    merge_internal_coordinates.reserve(n_merge);
+    merge_vertex_radii.reserve(n_merge);
+
     for (unsigned int i = start; i < start+len; ++i)
         {
         for (unsigned int j = 0; j < internal_coordinates[i].size(); ++j)
@@ -337,87 +369,277 @@ inline unsigned int OBBTree::buildNode(OBB *obbs,
     // handle the case of a leaf node creation
     if (len <= m_leaf_capacity)
         {
-        unsigned int new_node = allocateNode();
-        m_nodes[new_node].obb = my_obb;
-        m_nodes[new_node].parent = parent;
+        unsigned int new_node = (unsigned int)nodes.size();
+        nodes.push_back(OBBNode());
+        nodes[new_node].obb = my_obb;
+        nodes[new_node].parent = parent;
 
         for (unsigned int i = 0; i < len; i++)
             {
             // assign the particle indices into the leaf node
-            m_nodes[new_node].particles.push_back(idx[start+i]);
+            nodes[new_node].particles.push_back(idx[start+i]);
             }
 
         return new_node;
         }
 
     // otherwise, we are creating an internal node - allocate an index
-    unsigned int my_idx = allocateNode();
+    unsigned int my_idx = (unsigned int)nodes.size();
+    nodes.push_back(OBBNode());
 
     // need to split the list of obbs into two sets for left and right
     unsigned int start_left = 0;
     unsigned int start_right = len;
 
-    rotmat3<OverlapReal> my_axes(conj(my_obb.rotation));
-
     // if there are only 2 obbs, put one on each side
     if (len == 2)
         {
         // nothing to do, already partitioned
+        start_right = 1;
+        }
+    else
+        {
+        start_right = splitNode(my_obb, obbs, internal_coordinates, vertex_radii, idx, start, len);
+        }
+
+    // sanity check. The left or right tree may have ended up empty. If so, just borrow one particle from it
+    if (start_right == len)
+        start_right = len-1;
+    if (start_right == 0)
+        start_right = 1;
+
+    // note: calling buildNode has side effects, the nodes array may be reallocated. So we need to determine the left
+    // and right children, then build our node (can't say nodes[my_idx].left = buildNode(...))
+    unsigned int new_right, new_left;
+
+    #ifdef ENABLE_TBB
+    if (len >= m_parallel_min)
+        {
+        // the children own disjoint subranges, build them into separate node lists in parallel
+        std::vector<OBBNode> right_nodes, left_nodes;
+        tbb::parallel_invoke(
+            [&] { buildNode(right_nodes, obbs, internal_coordinates, vertex_radii, idx, start+start_right, len-start_right, OBB_INVALID_NODE, sphere_tree); },
+            [&] { buildNode(left_nodes, obbs, internal_coordinates, vertex_radii, idx, start+start_left, start_right-start_left, OBB_INVALID_NODE, sphere_tree); });
+
+        // append in the same order as the serial build
+        new_right = appendNodes(nodes, right_nodes, my_idx);
+        new_left = appendNodes(nodes, left_nodes, my_idx);
         }
     else
+    #endif
+        {
+        // create nodes in post-order
+        new_right = buildNode(nodes, obbs, internal_coordinates, vertex_radii, idx, start+start_right, len-start_right, my_idx, sphere_tree);
+        new_left = buildNode(nodes, obbs, internal_coordinates, vertex_radii, idx, start+start_left, start_right-start_left, my_idx, sphere_tree);
+        }
+
+    // now, create the children and connect them up
+    nodes[my_idx].obb = my_obb;
+    nodes[my_idx].parent = parent;
+    nodes[my_idx].left = new_left;
+    nodes[my_idx].right = new_right;
+
+    return my_idx;
+    }
+
+/*! \param node_obb OBB enclosing all OBBs of the node
+    \param obbs List of OBBs
+    \param internal_coordinates List of lists of vertex contents of OBBs
+    \param vertex_radii List of lists of vertex radii of OBBs
+    \param idx List of indices
+    \param start Start point in obbs and idx to examine
+    \param len Number of obbs to examine
+    \returns The number of OBBs in the left child, the OBBs of the left child are moved to the front of the range
+
+    The centroids of the OBBs are binned along each of the three axes of \a node_obb, and the bounding box of every bin
+    is accumulated in the frame of \a node_obb from the internal coordinates. For every split plane between two bins,
+    the cost is the surface area of the box of each side times its number of OBBs. The cheapest split over all axes
+    is chosen. If all centroids coincide, the range is split in half.
+*/
+inline unsigned int OBBTree::splitNode(const OBB& node_obb,
+                                       OBB *obbs,
+                                       std::vector<std::vector<vec3<OverlapReal> > >& internal_coordinates,
+                                       std::vector<std::vector<OverlapReal> >& vertex_radii,
+                                       std::vector<unsigned int>& idx,
+                                       unsigned int start,
+                                       unsigned int len)
+    {
+    const unsigned int n_bins = OBB_TREE_SAH_BINS;
+    rotmat3<OverlapReal> my_axes(conj(node_obb.rotation));
+    const vec3<OverlapReal> axes[3] = {my_axes.row0, my_axes.row1, my_axes.row2};
+
+    // extents and centroid projections of every OBB in the frame of the node
+    std::vector<OverlapReal> lo(3*len, FLT_MAX), hi(3*len, -FLT_MAX), proj(3*len);
+    for (unsigned int i = 0; i < len; ++i)
         {
-        // the x-axis has largest covariance by construction, so split along that axis
+        const std::vector<vec3<OverlapReal> >& pts = internal_coordinates[start+i];
+        for (unsigned int j = 0; j < pts.size(); ++j)
+            {
+            vec3<OverlapReal> dr = pts[j] - node_obb.center;
+            OverlapReal r = vertex_radii[start+i][j];
+            for (unsigned int d = 0; d < 3; ++d)
+                {
+                OverlapReal p = dot(dr, axes[d]);
+                lo[3*i+d] = std::min(lo[3*i+d], p - r);
+                hi[3*i+d] = std::max(hi[3*i+d], p + r);
+                }
+            }
+
+        vec3<OverlapReal> dc = obbs[start+i].center - node_obb.center;
+        for (unsigned int d = 0; d < 3; ++d)
+            proj[3*i+d] = dot(dc, axes[d]);
+        }
+
+    auto box_area = [](const OverlapReal *box_lo, const OverlapReal *box_hi) -> OverlapReal
+        {
+        OverlapReal ex = box_hi[0] - box_lo[0];
+        OverlapReal ey = box_hi[1] - box_lo[1];
+        OverlapReal ez = box_hi[2] - box_lo[2];
+        return OverlapReal(2.0)*(ex*ey + ey*ez + ez*ex);
+        };
+
+    OverlapReal best_cost = FLT_MAX;
+    int best_axis = -1;
+    unsigned int best_bin = 0;
+    OverlapReal best_min = 0.0;
+    OverlapReal best_scale = 0.0;
+
+    for (unsigned int d = 0; d < 3; ++d)
+        {
+        OverlapReal cmin = FLT_MAX;
+        OverlapReal cmax = -FLT_MAX;
+        for (unsigned int i = 0; i < len; ++i)
+            {
+            cmin = std::min(cmin, proj[3*i+d]);
+            cmax = std::max(cmax, proj[3*i+d]);
+            }
+        if (!(cmax > cmin))
+            continue;
+        OverlapReal scale = OverlapReal(n_bins)/(cmax - cmin);
+
+        // accumulate the bins
+        unsigned int bin_count[n_bins];
+        OverlapReal bin_lo[n_bins][3], bin_hi[n_bins][3];
+        for (unsigned int b = 0; b < n_bins; ++b)
+            {
+            bin_count[b] = 0;
+            for (unsigned int k = 0; k < 3; ++k)
+                {
+                bin_lo[b][k] = FLT_MAX;
+                bin_hi[b][k] = -FLT_MAX;
+                }
+            }
 
-        // Object mean
-        OverlapReal split_proj(0.0);
         for (unsigned int i = 0; i < len; ++i)
             {
-            split_proj += dot(obbs[start+i].center-my_obb.center,my_axes.row0)/len;
+            unsigned int b = std::min((unsigned int)((proj[3*i+d] - cmin)*scale), n_bins-1);
+            bin_count[b]++;
+            for (unsigned int k = 0; k < 3; ++k)
+                {
+                bin_lo[b][k] = std::min(bin_lo[b][k], lo[3*i+k]);
+                bin_hi[b][k] = std::max(bin_hi[b][k], hi[3*i+k]);
+                }
+            }
+
+        // sweep from the right, entry b holds the side right of the split after bin b
+        unsigned int right_count[n_bins];
+        OverlapReal right_area[n_bins];
+        OverlapReal acc_lo[3] = {FLT_MAX, FLT_MAX, FLT_MAX};
+        OverlapReal acc_hi[3] = {-FLT_MAX, -FLT_MAX, -FLT_MAX};
+        unsigned int acc_count = 0;
+        for (unsigned int b = n_bins-1; b > 0; --b)
+            {
+            acc_count += bin_count[b];
+            for (unsigned int k = 0; k < 3; ++k)
+                {
+                acc_lo[k] = std::min(acc_lo[k], bin_lo[b][k]);
+                acc_hi[k] = std::max(acc_hi[k], bin_hi[b][k]);
+                }
+            right_count[b-1] = acc_count;
+            right_area[b-1] = acc_count ? box_area(acc_lo, acc_hi) : OverlapReal(0.0);
             }
 
-        // split on x direction according to object mean
-        for (unsigned int i = 0; i < start_right; i++)
+        // sweep from the left and evaluate the cost of every split
+        acc_lo[0] = acc_lo[1] = acc_lo[2] = FLT_MAX;
+        acc_hi[0] = acc_hi[1] = acc_hi[2] = -FLT_MAX;
+        acc_count = 0;
+        for (unsigned int b = 0; b < n_bins-1; ++b)
             {
-            OverlapReal proj = dot(obbs[start+i].center-my_obb.center,my_axes.row0);
-            if (proj < split_proj)
+            acc_count += bin_count[b];
+            for (unsigned int k = 0; k < 3; ++k)
                 {
-                // if on the left side, everything is happy, just continue on
+                acc_lo[k] = std::min(acc_lo[k], bin_lo[b][k]);
+                acc_hi[k] = std::max(acc_hi[k], bin_hi[b][k]);
                 }
-            else
+
+            if (acc_count == 0 || right_count[b] == 0)
+                continue;
+
+            OverlapReal cost = box_area(acc_lo, acc_hi)*OverlapReal(acc_count) + right_area[b]*OverlapReal(right_count[b]);
+            if (cost < best_cost)
                 {
-                // if on the right side, need to swap the current obb with the one at start_right-1, subtract
-                // one off of start_right to indicate the addition of one to the right side and subtract 1
-                // from i to look at the current index (new obb). This is quick and easy to write, but will
-                // randomize indices - might need to look into a stable partitioning algorithm!
-                std::swap(obbs[start+i], obbs[start+start_right-1]);
-                std::swap(idx[start+i], idx[start+start_right-1]);
-                std::swap(internal_coordinates[start+i], internal_coordinates[start+start_right-1]);
-                std::swap(vertex_radii[start+i], vertex_radii[start+start_right-1]);
-                start_right--;
-                i--;
+                best_cost = cost;
+                best_axis = d;
+                best_bin = b;
+                best_min = cmin;
+                best_scale = scale;
                 }
             }
         }
-    // sanity check. The left or right tree may have ended up empty. If so, just borrow one particle from it
-    if (start_right == len)
-        start_right = len-1;
-    if (start_right == 0)
-        start_right = 1;
 
-    // note: calling buildNode has side effects, the m_nodes array may be reallocated. So we need to determine the left
-    // and right children, then build our node (can't say m_nodes[my_idx].left = buildNode(...))
+    if (best_axis < 0)
+        {
+        // all centroids coincide, any split is as good as another
+        return len/2;
+        }
 
-    // create nodes in post-order
-    unsigned int new_right = buildNode(obbs, internal_coordinates,  vertex_radii, idx, start+start_right, len-start_right, my_idx, sphere_tree);
-    unsigned int new_left = buildNode(obbs, internal_coordinates, vertex_radii, idx, start+start_left, start_right-start_left, my_idx, sphere_tree);
+    unsigned int start_right = len;
+    for (unsigned int i = 0; i < start_right; i++)
+        {
+        OverlapReal p = dot(obbs[start+i].center - node_obb.center, axes[best_axis]);
+        unsigned int b = std::min((unsigned int)((p - best_min)*best_scale), n_bins-1);
+        if (b <= best_bin)
+            {
+            // if on the left side, everything is happy, just continue on
+            }
+        else
+            {
+            // if on the right side, need to swap the current obb with the one at start_right-1, subtract
+            // one off of start_right to indicate the addition of one to the right side and subtract 1
+            // from i to look at the current index (new obb).
+            std::swap(obbs[start+i], obbs[start+start_right-1]);
+            std::swap(idx[start+i], idx[start+start_right-1]);
+            std::swap(internal_coordinates[start+i], internal_coordinates[start+start_right-1]);
+            std::swap(vertex_radii[start+i], vertex_radii[start+start_right-1]);
+            start_right--;
+            i--;
+            }
+        }
 
-    // now, create the children and connect them up
-    m_nodes[my_idx].obb = my_obb;
-    m_nodes[my_idx].parent = parent;
-    m_nodes[my_idx].left = new_left;
-    m_nodes[my_idx].right = new_right;
+    return start_right;
+    }
 
-    return my_idx;
+/*! \param nodes List of nodes to append to
+    \param subtree Nodes of a subtree with its root at index 0, the node indices are relative to the subtree
+    \param parent Index of the parent of the subtree root in \a nodes
+    \returns The index of the subtree root in \a nodes
+*/
+inline unsigned int OBBTree::appendNodes(std::vector<OBBNode>& nodes, std::vector<OBBNode>& subtree, unsigned int parent)
+    {
+    unsigned int offset = (unsigned int)nodes.size();
+    nodes.reserve(nodes.size() + subtree.size());
+
+    for (auto it = subtree.begin(); it != subtree.end(); ++it)
+        {
+        if (it->left != OBB_INVALID_NODE)
+            it->left += offset;
+        if (it->right != OBB_INVALID_NODE)
+            it->right += offset;
+        it->parent = (it->parent == OBB_INVALID_NODE) ? parent : it->parent + offset;
+        nodes.push_back(std::move(*it));
+        }
+
+    return offset;
     }
 
 /*! \param idx Index of the node to update
@@ -438,37 +660,6 @@ inline void OBBTree::updateEscapeIndex(unsigned int idx, unsigned int escape)
     updateEscapeIndex(left_idx, right_idx);
     }
 
-/*! Allocates a new node in the tree
-*/
-inline unsigned int OBBTree::allocateNode()
-    {
-    // grow the memory if needed
-    if (m_num_nodes >= m_node_capacity)
-        {
-        // determine new capacity
-        OBBNode *m_new_nodes = NULL;
-        unsigned int m_new_node_capacity = m_node_capacity*2;
-        if (m_new_node_capacity == 0)
-            m_new_node_capacity = 16;
-
-        // allocate new memory
-        m_new_nodes = new OBBNode[m_new_node_capacity];
-
-        // if we have old memory, copy it over
-        if (m_nodes != NULL)
-            {
-            std::copy(m_nodes, m_nodes + m_num_nodes, m_new_nodes);
-            delete[] m_nodes;
-            }
-        m_nodes = m_new_nodes;
-        m_node_capacity = m_new_node_capacity;
-        }
-
-    m_nodes[m_num_nodes] = OBBNode();
-    m_num_nodes++;
-    return m_num_nodes-1;
-    }
-
 // end group overlap
 /*! @}*/
 
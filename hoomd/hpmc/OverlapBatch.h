@@ -0,0 +1,70 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "HPMCPrecisionSetup.h"
+
+#ifndef __OVERLAP_BATCH_H__
+#define __OVERLAP_BATCH_H__
+
+/*! \file OverlapBatch.h
+    \brief Defines the batched circumsphere test of overlap candidates on the CPU
+    \details IntegratorHPMCMono gathers the candidates of a trial move in one leaf node of the AABB tree into a
+    batch. Shapes that opt in through a specialization of OverlapBatch test the circumspheres of the whole batch in
+    one branch-free loop that the compiler vectorizes. Only the candidates that pass are handed to test_overlap().
+*/
+
+namespace hpmc
+{
+
+//! Traits for the batched overlap test of a shape on the CPU
+/*! The generic template is disabled, and IntegratorHPMCMono tests every candidate with check_circumsphere_overlap()
+    and test_overlap().
+
+    A shape opts in by specializing OverlapBatch and setting \a enabled to true. If the circumsphere test is already
+    the complete overlap test (as for spheres), set \a exact to true and test_overlap() is never called.
+*/
+template<class Shape>
+struct OverlapBatch
+    {
+    //! True if candidates are prefiltered in batches by their circumspheres
+    static const bool enabled = false;
+
+    //! True if circumsphere overlap is equivalent to shape overlap
+    static const bool exact = false;
+    };
+
+namespace detail
+{
+
+//! Test a batch of candidates against the circumsphere of a trial shape
+/*! \param n Number of candidates in the batch
+    \param dx x-component of the separation vectors r_j - r_i
+    \param dy y-component of the separation vectors r_j - r_i
+    \param dz z-component of the separation vectors r_j - r_i
+    \param R Sum of the circumsphere radii of the trial shape and each candidate
+    \param hit Output, nonzero for the candidates whose circumspheres overlap the trial shape
+
+    \tparam exact If true, touching circumspheres do not overlap, matching the sphere overlap test. Otherwise, touching
+                  circumspheres overlap, matching check_circumsphere_overlap().
+*/
+template<bool exact>
+inline void test_circumsphere_batch(unsigned int n,
+                                    const OverlapReal *dx,
+                                    const OverlapReal *dy,
+                                    const OverlapReal *dz,
+                                    const OverlapReal *R,
+                                    unsigned int *hit)
+    {
+    for (unsigned int k = 0; k < n; ++k)
+        {
+        OverlapReal rsq = dx[k]*dx[k] + dy[k]*dy[k] + dz[k]*dz[k];
+        OverlapReal Rsq = R[k]*R[k];
+        hit[k] = exact ? (rsq < Rsq) : (rsq <= Rsq);
+        }
+    }
+
+}; // end namespace detail
+
+}; // end namespace hpmc
+
+#endif // __OVERLAP_BATCH_H__
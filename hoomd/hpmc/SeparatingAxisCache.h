@@ -0,0 +1,117 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "HPMCPrecisionSetup.h"
+#include "hoomd/VectorMath.h"
+
+#ifndef NVCC
+#include <stdint.h>
+#include <unordered_map>
+#endif
+
+#ifndef __SEPARATING_AXIS_CACHE_H__
+#define __SEPARATING_AXIS_CACHE_H__
+
+/*! \file SeparatingAxisCache.h
+    \brief Defines the cache of separating axes of particle pairs on the CPU
+    \details Shapes whose overlap test is XenoCollide can start the test from the separating axis that decided the
+    previous test of the same pair. In serial sweeps, IntegratorHPMCMono keeps these axes in a SeparatingAxisCache.
+*/
+
+namespace hpmc
+{
+
+//! Traits for the separating axis cache of a shape
+/*! The generic template is disabled and IntegratorHPMCMono does not cache any axes for the shape.
+
+    A shape opts in by specializing SeparatingAxis and setting \a enabled to true. It then provides an overload of
+    test_overlap() that takes a pointer to a vec3<OverlapReal> as fifth argument, the separating axis in the space
+    frame. The overload starts from the given axis when it is non-zero, and stores the axis of the deciding plane when
+    the shapes are disjoint.
+*/
+template<class Shape>
+struct SeparatingAxis
+    {
+    //! True if test_overlap() accepts a cached separating axis
+    static const bool enabled = false;
+    };
+
+#ifndef NVCC
+namespace detail
+{
+
+//! Bounded map from ordered pairs of particle tags to their last separating axis
+/*! Entries are keyed by the tags, which are kept by particle sorts and domain migration. An axis of a pair that has
+    moved apart or changed rank does no harm: it costs one support function evaluation when it no longer separates the
+    pair and is replaced by the new axis. Instead of evicting entries one by one, the whole cache is cleared once it
+    holds the maximum number of pairs.
+*/
+class SeparatingAxisCache
+    {
+    public:
+        //! Constructs a disabled cache
+        SeparatingAxisCache()
+            : m_max_pairs(0)
+            {
+            }
+
+        //! Set the maximum number of pairs, 0 disables the cache
+        void setMaxPairs(unsigned int max_pairs)
+            {
+            m_max_pairs = max_pairs;
+            m_axes.clear();
+            }
+
+        //! Get the maximum number of pairs
+        unsigned int getMaxPairs() const
+            {
+            return m_max_pairs;
+            }
+
+        //! True if axes are cached
+        bool enabled() const
+            {
+            return m_max_pairs > 0;
+            }
+
+        //! Get the number of cached pairs
+        unsigned int size() const
+            {
+            return m_axes.size();
+            }
+
+        //! Get the axis of a pair
+        /*! \param tag_i Tag of the first particle of the overlap test
+            \param tag_j Tag of the second particle of the overlap test
+            \returns Reference to the axis of the pair, a zero vector is inserted for a new pair. The reference is
+                     valid until the next call.
+        */
+        vec3<OverlapReal>& get(unsigned int tag_i, unsigned int tag_j)
+            {
+            uint64_t key = (uint64_t(tag_i) << 32) | uint64_t(tag_j);
+            std::unordered_map<uint64_t, vec3<OverlapReal> >::iterator it = m_axes.find(key);
+            if (it != m_axes.end())
+                return it->second;
+
+            if (m_axes.size() >= m_max_pairs)
+                m_axes.clear();
+            return m_axes[key];
+            }
+
+        //! Remove all cached axes
+        void clear()
+            {
+            m_axes.clear();
+            }
+
+    private:
+        unsigned int m_max_pairs;                                //!< Maximum number of cached pairs
+        std::unordered_map<uint64_t, vec3<OverlapReal> > m_axes; //!< Separating axes by ordered tag pair
+    };
+
+}; // end namespace detail
+#endif // NVCC
+
+}; // end namespace hpmc
+
+#endif // __SEPARATING_AXIS_CACHE_H__
@@ -170,6 +170,45 @@ class SupportFuncConvexPolyhedron
 
                     int id = __builtin_ffs(_mm256_movemask_ps(_mm256_cmp_ps(max_dot_v, d_v, 0)));
 
+                    if (id)
+                        {
+                        max_idx = i + id - 1;
+                        break;
+                        }
+                    }
+                #elif !defined(NVCC) && defined(__AVX__) && !defined(SINGLE_PRECISION) && !defined(ENABLE_HPMC_MIXED_PRECISION)
+                // process dot products with AVX 4 at a time on the CPU in double precision
+                __m256d nx_v = _mm256_broadcast_sd(&n.x);
+                __m256d ny_v = _mm256_broadcast_sd(&n.y);
+                __m256d nz_v = _mm256_broadcast_sd(&n.z);
+                __m256d max_dot_v = _mm256_broadcast_sd(&max_dot);
+                double d_s[verts.x.size()] __attribute__((aligned(32)));
+
+                for (unsigned int i = 0; i < verts.N; i+=4)
+                    {
+                    __m256d x_v = _mm256_load_pd(verts.x.get() + i);
+                    __m256d y_v = _mm256_load_pd(verts.y.get() + i);
+                    __m256d z_v = _mm256_load_pd(verts.z.get() + i);
+
+                    __m256d d_v = _mm256_add_pd(_mm256_mul_pd(nx_v, x_v), _mm256_add_pd(_mm256_mul_pd(ny_v, y_v), _mm256_mul_pd(nz_v, z_v)));
+
+                    // determine a maximum in each of the 4 channels as we go
+                    max_dot_v = _mm256_max_pd(max_dot_v, d_v);
+
+                    _mm256_store_pd(d_s + i, d_v);
+                    }
+
+                // find the maximum of the 4 channels, swap the two 128b segments and then the neighbors within them
+                max_dot_v = _mm256_max_pd(max_dot_v, _mm256_permute2f128_pd(max_dot_v, max_dot_v, 1));
+                max_dot_v = _mm256_max_pd(max_dot_v, _mm256_shuffle_pd(max_dot_v, max_dot_v, 0x5));
+
+                // loop again and find the first index of the max element
+                for (unsigned int i = 0; i < verts.N; i+=4)
+                    {
+                    __m256d d_v = _mm256_load_pd(d_s + i);
+
+                    int id = __builtin_ffs(_mm256_movemask_pd(_mm256_cmp_pd(max_dot_v, d_v, _CMP_EQ_OQ)));
+
                     if (id)
                         {
                         max_idx = i + id - 1;
@@ -297,6 +336,50 @@ class SupportFuncConvexPolyhedron
         const poly3d_verts& verts;      //!< Vertices of the polyhedron
     };
 
+//! Support function for ShapeConvexPolyhedron evaluated in double precision
+/*! Used to re-test near-contact configurations with HPMC_ADAPTIVE_PRECISION. The vertices are converted exactly
+    from OverlapReal, so the result differs from SupportFuncConvexPolyhedron only in the round-off of the dot products.
+
+    \ingroup minkowski
+*/
+class SupportFuncConvexPolyhedronDouble
+    {
+    public:
+        //! Construct a support function for a convex polyhedron
+        /*! \param _verts Polyhedron vertices
+        */
+        DEVICE SupportFuncConvexPolyhedronDouble(const poly3d_verts& _verts)
+            : verts(_verts)
+            {
+            }
+
+        //! Compute the support function
+        /*! \param n Normal vector input (in the local frame)
+            \returns Local coords of the point furthest in the direction of n
+        */
+        DEVICE vec3<double> operator() (const vec3<double>& n) const
+            {
+            if (verts.N == 0)
+                return vec3<double>(0.0, 0.0, 0.0); // No verts!
+
+            double max_dot = dot(n, vec3<double>(verts.x[0], verts.y[0], verts.z[0]));
+            unsigned int max_idx = 0;
+            for (unsigned int i = 1; i < verts.N; ++i)
+                {
+                double d = dot(n, vec3<double>(verts.x[i], verts.y[i], verts.z[i]));
+                if (d > max_dot)
+                    {
+                    max_dot = d;
+                    max_idx = i;
+                    }
+                }
+            return vec3<double>(verts.x[max_idx], verts.y[max_idx], verts.z[max_idx]);
+            }
+
+    private:
+        const poly3d_verts& verts;      //!< Vertices of the polyhedron
+    };
+
 
 }; // end namespace detail
 
@@ -375,6 +458,21 @@ struct ShapeConvexPolyhedron
     const detail::poly3d_verts& verts;     //!< Vertices
     };
 
+//! Convex polyhedra are prefiltered by their circumspheres in batches
+template<>
+struct OverlapBatch<ShapeConvexPolyhedron>
+    {
+    static const bool enabled = true;
+    static const bool exact = false;
+    };
+
+//! Convex polyhedra warm start XenoCollide from a cached separating axis
+template<>
+struct SeparatingAxis<ShapeConvexPolyhedron>
+    {
+    static const bool enabled = true;
+    };
+
 //! Check if circumspheres overlap
 /*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
     \param a first shape
@@ -398,24 +496,68 @@ DEVICE inline bool check_circumsphere_overlap(const vec3<Scalar>& r_ab, const Sh
     \param a first shape
     \param b second shape
     \param err in/out variable incremented when error conditions occur in the overlap test
+    \param axis (if not NULL) in/out separating axis in the space frame that warm starts XenoCollide
     \returns true when *a* and *b* overlap, and false when they are disjoint
 
+    With HPMC_ADAPTIVE_PRECISION, pairs whose single precision result is decided within a margin of contact are
+    re-tested in double precision.
+
     \ingroup shape
 */
 DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
                                  const ShapeConvexPolyhedron& a,
                                  const ShapeConvexPolyhedron& b,
-                                 unsigned int& err)
+                                 unsigned int& err,
+                                 vec3<OverlapReal> *axis = NULL)
     {
     vec3<OverlapReal> dr(r_ab);
     OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
 
-    return detail::xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts),
+    // the cached axis is kept in the space frame, so that it stays valid when a rotates
+    quat<OverlapReal> qa(a.orientation);
+    vec3<OverlapReal> axis_a;
+    if (axis != NULL)
+        axis_a = rotate(conj(qa), *axis);
+
+    #ifdef HPMC_ADAPTIVE_PRECISION
+    bool near_contact;
+    bool overlap = detail::xenocollide_3d_margin<OverlapReal>(detail::SupportFuncConvexPolyhedron(a.verts),
+                                  detail::SupportFuncConvexPolyhedron(b.verts),
+                                  rotate(conj(qa), dr),
+                                  conj(qa)* quat<OverlapReal>(b.orientation),
+                                  DaDb/OverlapReal(2.0),
+                                  err,
+                                  OverlapReal(HPMC_ADAPTIVE_PRECISION_MARGIN),
+                                  near_contact,
+                                  axis != NULL ? &axis_a : NULL);
+    if (axis != NULL)
+        *axis = rotate(qa, axis_a);
+    if (!near_contact)
+        return overlap;
+
+    // re-test in double precision
+    quat<double> qa_d(a.orientation);
+    quat<double> qb_d(b.orientation);
+    return detail::xenocollide_3d_margin<double>(detail::SupportFuncConvexPolyhedronDouble(a.verts),
+                                  detail::SupportFuncConvexPolyhedronDouble(b.verts),
+                                  rotate(conj(qa_d), vec3<double>(r_ab)),
+                                  conj(qa_d) * qb_d,
+                                  double(DaDb)/2.0,
+                                  err,
+                                  0.0,
+                                  near_contact);
+    #else
+    bool overlap = detail::xenocollide_3d(detail::SupportFuncConvexPolyhedron(a.verts),
                                   detail::SupportFuncConvexPolyhedron(b.verts),
-                                  rotate(conj(quat<OverlapReal>(a.orientation)), dr),
-                                  conj(quat<OverlapReal>(a.orientation))* quat<OverlapReal>(b.orientation),
+                                  rotate(conj(qa), dr),
+                                  conj(qa)* quat<OverlapReal>(b.orientation),
                                   DaDb/2.0,
-                                  err);
+                                  err,
+                                  axis != NULL ? &axis_a : NULL);
+    if (axis != NULL)
+        *axis = rotate(qa, axis_a);
+    return overlap;
+    #endif
     /*
     return detail::gjke_3d(detail::SupportFuncConvexPolyhedron(a.verts),
                            detail::SupportFuncConvexPolyhedron(b.verts),
@@ -446,6 +446,7 @@ typename ShapeUnion<Shape>::param_type make_union_params(pybind11::list _members
         Shape dummy(quat<Scalar>(), param);
         Scalar d = sqrt(dot(pos,pos));
         diameter = max(diameter, OverlapReal(2*d + dummy.getCircumsphereDiameter()));
+        result.mradius[i] = OverlapReal(0.5)*dummy.getCircumsphereDiameter();
 
         obbs[i] = detail::OBB(pos,dummy.getCircumsphereDiameter()/2.0);
         obbs[i].mask = result.moverlap[i];
@@ -6,6 +6,8 @@
 #include "HPMCPrecisionSetup.h"
 #include "hoomd/VectorMath.h"
 #include "Moves.h"
+#include "OverlapBatch.h"
+#include "SeparatingAxisCache.h"
 #include "hoomd/AABB.h"
 
 #include <stdexcept>
@@ -192,6 +194,14 @@ struct ShapeSphere
     const sph_params &params;        //!< Sphere and ignore flags
     };
 
+//! Spheres overlap when their circumspheres do
+template<>
+struct OverlapBatch<ShapeSphere>
+    {
+    static const bool enabled = true;
+    static const bool exact = true;
+    };
+
 //! Check if circumspheres overlap
 /*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
     \param a first shape
@@ -222,6 +232,21 @@ DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab, const ShapeA &a, const
     return true;
     }
 
+//! Overlap test with a cached separating axis
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param err Incremented if there is an error condition. Left unchanged otherwise.
+    \param axis Separating axis in the space frame, ignored by shapes that do not specialize SeparatingAxis
+    \returns true when *a* and *b* overlap, and false when they are disjoint
+*/
+template <class ShapeA, class ShapeB>
+DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab, const ShapeA &a, const ShapeB& b, unsigned int& err,
+    vec3<OverlapReal> *axis)
+    {
+    return test_overlap(r_ab, a, b, err);
+    }
+
 //! Sphere-Sphere overlap
 /*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
     \param a first shape
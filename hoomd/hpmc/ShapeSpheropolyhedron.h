@@ -69,6 +69,40 @@ class SupportFuncSpheropolyhedron
         const poly3d_verts& verts;        //!< Vertices of the polyhedron
     };
 
+//! Support function for ShapeSpheropolyhedron evaluated in double precision
+/*! Used to re-test near-contact configurations with HPMC_ADAPTIVE_PRECISION.
+
+    \ingroup minkowski
+*/
+class SupportFuncSpheropolyhedronDouble
+    {
+    public:
+        //! Construct a support function for a convex spheropolyhedron
+        /*! \param _verts Polyhedron vertices and additional parameters
+        */
+        DEVICE SupportFuncSpheropolyhedronDouble(const poly3d_verts& _verts)
+            : verts(_verts)
+            {
+            }
+
+        //! Compute the support function
+        /*! \param n Normal vector input (in the local frame)
+            \returns Local coords of the point furthest in the direction of n
+        */
+        DEVICE vec3<double> operator() (const vec3<double>& n) const
+            {
+            // get the support function of the underlying convex polyhedron
+            vec3<double> max_poly3d = SupportFuncConvexPolyhedronDouble(verts)(n);
+            // add to that the support mapping of the sphere
+            vec3<double> max_sphere = (double(verts.sweep_radius) * fast::rsqrt(dot(n,n))) * n;
+
+            return max_poly3d + max_sphere;
+            }
+
+    private:
+        const poly3d_verts& verts;        //!< Vertices of the polyhedron
+    };
+
 }; // end namespace detail
 
 //! Convex (Sphero)Polyhedron shape template
@@ -164,6 +198,13 @@ struct ShapeSpheropolyhedron
     const detail::poly3d_verts& verts;     //!< Vertices
     };
 
+//! Spheropolyhedra warm start XenoCollide from a cached separating axis
+template<>
+struct SeparatingAxis<ShapeSpheropolyhedron>
+    {
+    static const bool enabled = true;
+    };
+
 //! Check if circumspheres overlap
 /*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
     \param a first shape
@@ -187,25 +228,69 @@ DEVICE inline bool check_circumsphere_overlap(const vec3<Scalar>& r_ab, const Sh
     \param a first shape
     \param b second shape
     \param err in/out variable incremented when error conditions occur in the overlap test
+    \param axis (if not NULL) in/out separating axis in the space frame that warm starts XenoCollide
     \returns true when *a* and *b* overlap, and false when they are disjoint
 
+    With HPMC_ADAPTIVE_PRECISION, pairs whose single precision result is decided within a margin of contact are
+    re-tested in double precision.
+
     \ingroup shape
 */
 DEVICE inline bool test_overlap(const vec3<Scalar>& r_ab,
                                  const ShapeSpheropolyhedron& a,
                                  const ShapeSpheropolyhedron& b,
-                                 unsigned int& err)
+                                 unsigned int& err,
+                                 vec3<OverlapReal> *axis = NULL)
     {
     vec3<OverlapReal> dr = r_ab;
 
     OverlapReal DaDb = a.getCircumsphereDiameter() + b.getCircumsphereDiameter();
 
-    return xenocollide_3d(detail::SupportFuncSpheropolyhedron(a.verts),
+    // the cached axis is kept in the space frame, so that it stays valid when a rotates
+    quat<OverlapReal> qa(a.orientation);
+    vec3<OverlapReal> axis_a;
+    if (axis != NULL)
+        axis_a = rotate(conj(qa), *axis);
+
+    #ifdef HPMC_ADAPTIVE_PRECISION
+    bool near_contact;
+    bool overlap = detail::xenocollide_3d_margin<OverlapReal>(detail::SupportFuncSpheropolyhedron(a.verts),
                           detail::SupportFuncSpheropolyhedron(b.verts),
-                          rotate(conj(quat<OverlapReal>(a.orientation)),dr),
-                          conj(quat<OverlapReal>(a.orientation)) * quat<OverlapReal>(b.orientation),
+                          rotate(conj(qa),dr),
+                          conj(qa) * quat<OverlapReal>(b.orientation),
+                          DaDb/OverlapReal(2.0),
+                          err,
+                          OverlapReal(HPMC_ADAPTIVE_PRECISION_MARGIN),
+                          near_contact,
+                          axis != NULL ? &axis_a : NULL);
+    if (axis != NULL)
+        *axis = rotate(qa, axis_a);
+    if (!near_contact)
+        return overlap;
+
+    // re-test in double precision
+    quat<double> qa_d(a.orientation);
+    quat<double> qb_d(b.orientation);
+    return detail::xenocollide_3d_margin<double>(detail::SupportFuncSpheropolyhedronDouble(a.verts),
+                          detail::SupportFuncSpheropolyhedronDouble(b.verts),
+                          rotate(conj(qa_d), vec3<double>(r_ab)),
+                          conj(qa_d) * qb_d,
+                          double(DaDb)/2.0,
+                          err,
+                          0.0,
+                          near_contact);
+    #else
+    bool overlap = xenocollide_3d(detail::SupportFuncSpheropolyhedron(a.verts),
+                          detail::SupportFuncSpheropolyhedron(b.verts),
+                          rotate(conj(qa),dr),
+                          conj(qa) * quat<OverlapReal>(b.orientation),
                           DaDb/2.0,
-                          err);
+                          err,
+                          axis != NULL ? &axis_a : NULL);
+    if (axis != NULL)
+        *axis = rotate(qa, axis_a);
+    return overlap;
+    #endif
     /*
     return gjke_3d(detail::SupportFuncSpheropolyhedron(a.verts),
                    detail::SupportFuncSpheropolyhedron(b.verts),
@@ -82,7 +82,6 @@ struct ShapeSphinx
     DEVICE inline ShapeSphinx(const quat<Scalar>& _orientation, const param_type& _params)
         : orientation(_orientation), convex(true), spheres(_params)
         {
-        volume = 0.0;
         radius = spheres.circumsphereDiameter/(2.0);
         n = spheres.N;
         for(unsigned int i = 0; i<n;i++)
@@ -97,7 +96,6 @@ struct ShapeSphinx
             for(unsigned int j=0; j<i; j++)
                 {
                 D[(i-1)*i/2+j] = dot(u[i]-u[j],u[i]-u[j]);
-                d[(i-1)*i/2+j] = s[i]*s[j]*sqrt(D[(i-1)*i/2+j]);
                 }
             }
         disjoint = ((n > 0) && (s[0] > 0));
@@ -109,7 +107,23 @@ struct ShapeSphinx
                  for(unsigned int j = 1; j < i; j++)
                     if(!detail::seq2(1,1,R[i],R[j],D[(i-1)*i/2+j])) disjoint = false;
                 }
-        volume = detail::initVolume(disjoint,r,n,d);
+        }
+
+    //! Get the volume of the shape
+    /*! The volume is not needed by the overlap checks, so it is only computed on demand and not every time a shape is
+        constructed in the trial moves.
+    */
+    DEVICE OverlapReal getVolume() const
+        {
+        OverlapReal d[detail::MAX_SPHERE_CENTERS*(detail::MAX_SPHERE_CENTERS-1)/2];
+        OverlapReal r_copy[detail::MAX_SPHERE_CENTERS];
+        for(unsigned int i=0; i<n;i++)
+            {
+            r_copy[i] = r[i];
+            for(unsigned int j=0; j<i; j++)
+                d[(i-1)*i/2+j] = s[i]*s[j]*sqrt(D[(i-1)*i/2+j]);
+            }
+        return detail::initVolume(disjoint,r_copy,n,d);
         }
 
     //! Does this shape have an orientation
@@ -152,9 +166,7 @@ struct ShapeSphinx
     vec3<OverlapReal> u[detail::MAX_SPHERE_CENTERS];           //!< original center of each sphere
     //vec3<OverlapReal> v[MAX_SPHERE_CENTERS];           //!< rotated center - having this in the overlap check
     OverlapReal D[detail::MAX_SPHERE_CENTERS*(detail::MAX_SPHERE_CENTERS-1)/2];   //!< distance^2 between every pair of spheres
-    OverlapReal d[detail::MAX_SPHERE_CENTERS*(detail::MAX_SPHERE_CENTERS-1)/2];   //!< distance with sign bet. every pair of spheres
     OverlapReal radius;
-    OverlapReal volume;
 
     const detail::sphinx3d_params& spheres;     //!< Vertices
     };
@@ -203,61 +215,85 @@ DEVICE inline bool test_overlap<ShapeSphinx,ShapeSphinx>(const vec3<Scalar>& r_a
     vec3<OverlapReal> x(0.0,0.0,0.0);
     vec3<OverlapReal> y(r_ab);
 
+    // signs, squared radii and centers of the spheres of q in the frame of p, as arrays for the batched tests
+    OverlapReal qs[detail::MAX_SPHERE_CENTERS];
+    OverlapReal qx[detail::MAX_SPHERE_CENTERS];
+    OverlapReal qy[detail::MAX_SPHERE_CENTERS];
+    OverlapReal qz[detail::MAX_SPHERE_CENTERS];
+    for(unsigned int j=0; j < q.n; j++)
+        {
+        vec3<OverlapReal> c = y+qv[j];
+        qs[j] = q.s[j];
+        qx[j] = c.x;
+        qy[j] = c.y;
+        qz[j] = c.z;
+        }
+
+    // every sep test below starts with seq2() of all sphere pairs, and the shapes are separated if any pair of a
+    // sphere of p and a sphere of q is, test these pairs first in one branch free pass per sphere of p
+    bool handled = (p.disjoint && q.disjoint) || (p.n <= 5 && q.n <= 5 && p.n + q.n <= 8);
+    if (handled)
+        {
+        for(unsigned int i = 0; i < p.n; i++)
+            {
+            vec3<OverlapReal> a = x+pv[i];
+            if(detail::seq2_any(p.s[i],p.R[i],a.x,a.y,a.z,q.n,qs,q.R,qx,qy,qz)) return false;
+            }
+        }
+
     if(p.disjoint && q.disjoint)
             {
-            if((p.n == 1) && (q.n == 1))
+            // the remaining tests of sep3() and sep4() with the positive sphere a of p, c of q, and the negative
+            // spheres b of p and d of q, the tests of a single negative sphere are shared by all pairs
+            vec3<OverlapReal> a = x+pv[0],c = y+qv[0];
+            OverlapReal ac = detail::norm2(a-c);
+
+            for(unsigned int i = 1; i < p.n; i++)
                 {
-                vec3<OverlapReal> a = x + pv[0],b = y+qv[0];
-                if(detail::sep2(false,
-                        p.s[0],q.s[0],
-                        p.R[0],q.R[0],
-                        detail::norm2(a-b))) return false;
+                int k = (i-1)*i/2;
+                vec3<OverlapReal> b = x+pv[i];
+                if(detail::seq2(p.s[0],p.s[i],p.R[0],p.R[i],p.D[k])) return false;
+                if(detail::seq3(p.s[0],p.s[i],q.s[0],
+                        p.R[0],p.R[i],q.R[0],
+                        p.D[k],ac,
+                        detail::norm2(b-c))) return false;
                 }
-            if((p.n > 1) && (q.n == 1))
+
+            for(unsigned int j = 1; j < q.n; j++)
                 {
-                vec3<OverlapReal> a = x+pv[0],c = y+qv[0];
-                for(unsigned int i = 1; i < p.n; i++)
-                    {
-                    int k = (i-1)*i/2;
-                    vec3<OverlapReal> b = x+pv[i];
-                    if(detail::sep3(false,
-                            p.s[0],p.s[i],q.s[0],
-                            p.R[0],p.R[i],q.R[0],
-                            p.D[k],detail::norm2(a-c),
-                            detail::norm2(b-c))) return false;
-                    }
+                int l = (j-1)*j/2;
+                vec3<OverlapReal> d = y+qv[j];
+                if(detail::seq2(q.s[0],q.s[j],q.R[0],q.R[j],q.D[l])) return false;
+                if(detail::seq3(p.s[0],q.s[0],q.s[j],
+                        p.R[0],q.R[0],q.R[j],
+                        ac,detail::norm2(a-d),
+                        q.D[l])) return false;
                 }
-            if((p.n == 1) && (q.n > 1))
+
+            for(unsigned int i = 1; i < p.n; i++)
                 {
-                vec3<OverlapReal> a = x+pv[0],b = y+qv[0];
+                int k = (i-1)*i/2;
+                vec3<OverlapReal> b = x+pv[i];
+                OverlapReal bc = detail::norm2(b-c);
                 for(unsigned int j = 1; j < q.n; j++)
                     {
                     int l = (j-1)*j/2;
-                    vec3<OverlapReal> c = y+qv[j];
-                    if(detail::sep3(false,
-                            p.s[0],q.s[0],q.s[j],
-                            p.R[0],q.R[0],q.R[j],
-                            detail::norm2(a-b),detail::norm2(a-c),
+                    vec3<OverlapReal> d = y+qv[j];
+                    OverlapReal ad = detail::norm2(a-d);
+                    OverlapReal bd = detail::norm2(b-d);
+                    if(detail::seq3(p.s[0],p.s[i],q.s[j],
+                            p.R[0],p.R[i],q.R[j],
+                            p.D[k],ad,
+                            bd)) return false;
+                    if(detail::seq3(p.s[i],q.s[0],q.s[j],
+                            p.R[i],q.R[0],q.R[j],
+                            bc,bd,
+                            q.D[l])) return false;
+                    if(detail::seq4(p.s[0],p.s[i],q.s[0],q.s[j],
+                            p.R[0],p.R[i],q.R[0],q.R[j],
+                            p.D[k],ac,ad,
+                            bc,bd,
                             q.D[l])) return false;
-                    }
-                }
-            if((p.n > 1) && (q.n > 1))
-                {
-                vec3<OverlapReal> a = x+pv[0],c = y+qv[0];
-                for(unsigned int i = 1; i < p.n; i++)
-                    {
-                    int k = (i-1)*i/2;
-                    for(unsigned int j = 1; j < q.n; j++)
-                        {
-                        int l = (j-1)*j/2;
-                        vec3<OverlapReal> b = x+pv[i],d = y+qv[j];
-                        if(detail::sep4(false,
-                                p.s[0],p.s[i],q.s[0],q.s[j],
-                                p.R[0],p.R[i],q.R[0],q.R[j],
-                                p.D[k],detail::norm2(a-c),detail::norm2(a-d),
-                                detail::norm2(b-c),detail::norm2(b-d),
-                                q.D[l])) return false;
-                        }
                     }
                 }
             return true;
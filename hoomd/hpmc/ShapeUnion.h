@@ -55,6 +55,7 @@ struct union_params : param_base
         {
         tree.load_shared(ptr, available_bytes);
         mpos.load_shared(ptr, available_bytes);
+        mradius.load_shared(ptr, available_bytes);
         mparams.load_shared(ptr, available_bytes);
         moverlap.load_shared(ptr, available_bytes);
         morientation.load_shared(ptr, available_bytes);
@@ -68,6 +69,7 @@ struct union_params : param_base
         tree.attach_to_stream(stream);
 
         mpos.attach_to_stream(stream);
+        mradius.attach_to_stream(stream);
         morientation.attach_to_stream(stream);
         mparams.attach_to_stream(stream);
         moverlap.attach_to_stream(stream);
@@ -80,6 +82,7 @@ struct union_params : param_base
         : N(_N)
         {
         mpos = ManagedArray<vec3<OverlapReal> >(N,_managed);
+        mradius = ManagedArray<OverlapReal>(N,_managed);
         morientation = ManagedArray<quat<OverlapReal> >(N,_managed);
         mparams = ManagedArray<mparam_type>(N,_managed);
         moverlap = ManagedArray<unsigned int>(N,_managed);
@@ -88,6 +91,7 @@ struct union_params : param_base
 
     gpu_tree_type tree;                      //!< OBB tree for constituent shapes
     ManagedArray<vec3<OverlapReal> > mpos;         //!< Position vectors of member shapes
+    ManagedArray<OverlapReal> mradius;             //!< Circumsphere radii of member shapes
     ManagedArray<quat<OverlapReal> > morientation; //!< Orientation of member shapes
     ManagedArray<mparam_type> mparams;        //!< Parameters of member shapes
     ManagedArray<unsigned int> moverlap;      //!< only check overlaps for which moverlap[i] & moverlap[j]
@@ -193,6 +197,18 @@ DEVICE inline bool check_circumsphere_overlap(const vec3<Scalar>& r_ab, const Sh
     return (rsq*OverlapReal(4.0) <= DaDb * DaDb);
     }
 
+//! Test for overlap between the member shapes in two leaf nodes
+/*! \param dr Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape
+    \param b second shape
+    \param cur_node_a leaf node of the tree of \a a
+    \param cur_node_b leaf node of the tree of \a b
+    \returns true if any pair of member shapes overlaps
+
+    The members of \a a are transformed into the body frame of \a b. The cached circumsphere radii
+    of the members are compared first, so that the full overlap check is only done for member pairs
+    with overlapping circumspheres.
+*/
 template<class Shape>
 DEVICE inline bool test_narrow_phase_overlap(vec3<OverlapReal> dr,
                                              const ShapeUnion<Shape>& a,
@@ -201,6 +217,7 @@ DEVICE inline bool test_narrow_phase_overlap(vec3<OverlapReal> dr,
                                              unsigned int cur_node_b)
     {
     vec3<OverlapReal> r_ab = rotate(conj(quat<OverlapReal>(b.orientation)),vec3<OverlapReal>(dr));
+    quat<OverlapReal> q_ab = conj(quat<OverlapReal>(b.orientation))*quat<OverlapReal>(a.orientation);
 
     //! Param type of the member shapes
     typedef typename Shape::param_type mparam_type;
@@ -213,34 +230,46 @@ DEVICE inline bool test_narrow_phase_overlap(vec3<OverlapReal> dr,
         {
         unsigned int ishape = a.members.tree.getParticle(cur_node_a, i);
 
+        vec3<OverlapReal> pos_i(rotate(q_ab,a.members.mpos[ishape])-r_ab);
+        OverlapReal radius_i = a.members.mradius[ishape];
+        unsigned int overlap_i = a.members.moverlap[ishape];
+
+        // the member shape is only constructed once its circumsphere overlaps a member of b
+        bool init_i = false;
         const mparam_type& params_i = a.members.mparams[ishape];
         Shape shape_i(quat<Scalar>(), params_i);
-        if (shape_i.hasOrientation())
-            shape_i.orientation = conj(quat<OverlapReal>(b.orientation))*quat<OverlapReal>(a.orientation) * a.members.morientation[ishape];
-
-        vec3<OverlapReal> pos_i(rotate(conj(quat<OverlapReal>(b.orientation))*quat<OverlapReal>(a.orientation),a.members.mpos[ishape])-r_ab);
-        unsigned int overlap_i = a.members.moverlap[ishape];
 
         // loop through shapes of cur_node_b
         for (unsigned int j= 0; j < nb; j++)
             {
             unsigned int jshape = b.members.tree.getParticle(cur_node_b, j);
 
+            unsigned int overlap_j = b.members.moverlap[jshape];
+            if (!(overlap_i & overlap_j))
+                continue;
+
+            // reject pairs with disjoint circumspheres
+            vec3<OverlapReal> r_ij = b.members.mpos[jshape] - pos_i;
+            OverlapReal RaRb = radius_i + b.members.mradius[jshape];
+            if (dot(r_ij,r_ij) > RaRb*RaRb)
+                continue;
+
+            if (!init_i)
+                {
+                if (shape_i.hasOrientation())
+                    shape_i.orientation = q_ab * a.members.morientation[ishape];
+                init_i = true;
+                }
+
             const mparam_type& params_j = b.members.mparams[jshape];
             Shape shape_j(quat<Scalar>(), params_j);
             if (shape_j.hasOrientation())
                 shape_j.orientation = b.members.morientation[jshape];
 
-            unsigned int overlap_j = b.members.moverlap[jshape];
-
             unsigned int err =0;
-            if (overlap_i & overlap_j)
+            if (test_overlap(r_ij, shape_i, shape_j, err))
                 {
-                vec3<OverlapReal> r_ij = b.members.mpos[jshape] - pos_i;
-                if (test_overlap(r_ij, shape_i, shape_j, err))
-                    {
-                    return true;
-                    }
+                return true;
                 }
             }
         }
@@ -587,6 +587,45 @@ DEVICE inline bool seq2(OverlapReal as,OverlapReal bs,
         return(ab*(ar+br-ab)+ar*(ab+br-ar)+br*(ab+ar-br) <= 0);
     }
 
+//! Test one sphere against a set of spheres with seq2()
+/*! \param as Sign of sphere a
+    \param ar Squared radius of sphere a
+    \param ax x coordinate of the center of sphere a
+    \param ay y coordinate of the center of sphere a
+    \param az z coordinate of the center of sphere a
+    \param n Number of spheres in the set
+    \param bs Signs of the spheres in the set
+    \param br Squared radii of the spheres in the set
+    \param bx x coordinates of the centers of the spheres in the set
+    \param by y coordinates of the centers of the spheres in the set
+    \param bz z coordinates of the centers of the spheres in the set
+    \returns true if seq2() of sphere a and any sphere of the set is true
+
+    The conditions of seq2() are evaluated for all spheres of the set and combined without branches, so that the loop
+    vectorizes on the CPU.
+*/
+DEVICE inline bool seq2_any(OverlapReal as, OverlapReal ar,
+              OverlapReal ax, OverlapReal ay, OverlapReal az,
+              unsigned int n,
+              const OverlapReal *bs, const OverlapReal *br,
+              const OverlapReal *bx, const OverlapReal *by, const OverlapReal *bz)
+    {
+        unsigned int hit = 0;
+        for (unsigned int k = 0; k < n; ++k)
+            {
+            OverlapReal dx = ax - bx[k];
+            OverlapReal dy = ay - by[k];
+            OverlapReal dz = az - bz[k];
+            OverlapReal ab = dx*dx + dy*dy + dz*dz;
+
+            unsigned int a_in = as*(ab+br[k]-ar) >= OverlapReal(-EPS);
+            unsigned int b_in = bs[k]*(ab+ar-br[k]) >= OverlapReal(-EPS);
+            unsigned int empty = ab*(ar+br[k]-ab)+ar*(ab+br[k]-ar)+br[k]*(ab+ar-br[k]) <= OverlapReal(0);
+            hit |= a_in & b_in & empty;
+            }
+        return hit;
+    }
+
 DEVICE inline bool seq3(OverlapReal as,OverlapReal bs,OverlapReal cs,
               OverlapReal ar,OverlapReal br,OverlapReal cr,
               OverlapReal ab,OverlapReal ac,
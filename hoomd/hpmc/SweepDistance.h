@@ -0,0 +1,181 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/VectorMath.h"
+#include "HPMCPrecisionSetup.h"
+#include "ShapeSphere.h"
+
+#include <algorithm>
+#include <limits>
+
+#ifndef __SWEEP_DISTANCE_H__
+#define __SWEEP_DISTANCE_H__
+
+/*! \file SweepDistance.h
+    \brief Collision distances of shapes moving along a direction, for event-chain Monte Carlo
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+//! Gap that is left between colliding shapes of combined circumsphere diameter \a D
+/*! The shapes stop short of the exact contact, so that the overlap tests, which may run in single precision, do not
+    report an overlap of touching shapes.
+*/
+inline Scalar sweep_contact_gap(Scalar D)
+    {
+    return Scalar(8.0)*std::numeric_limits<OverlapReal>::epsilon()*D;
+    }
+
+}; // end namespace detail
+
+//! Distance that shape a can move along a direction before it collides with shape b
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape, the one that moves
+    \param b second shape
+    \param direction Unit vector of the motion of a
+    \param max_distance Largest distance of interest
+    \param resolution Step of the collision search, relative to the smaller circumsphere diameter
+    \param err in/out variable incremented when error conditions occur in the overlap test
+    \param normal Set to the unit vector from a to b at the collision
+    \returns The largest distance in [0, max_distance) that a moves without overlapping b, or max_distance if the
+             shapes do not collide before
+
+    The generic implementation brackets the collision between the entry of the circumspheres into each other and,
+    when the shapes define an insphere, the entry of the inspheres. The bracket is searched with steps of
+    \a resolution times the smaller circumsphere diameter and the first overlapping step is refined by bisection
+    with test_overlap(). The returned position is always one that test_overlap() found to be free of overlaps, a
+    grazing collision shorter than the step may be missed. The normal is approximated by the direction between the
+    centers at the collision.
+
+    \ingroup shape
+*/
+template <class ShapeA, class ShapeB>
+inline Scalar sweep_distance(const vec3<Scalar>& r_ab,
+                             const ShapeA& a,
+                             const ShapeB& b,
+                             const vec3<Scalar>& direction,
+                             Scalar max_distance,
+                             Scalar resolution,
+                             unsigned int& err,
+                             vec3<Scalar>& normal)
+    {
+    // range of distances where the circumspheres overlap
+    Scalar R = Scalar(0.5)*(a.getCircumsphereDiameter() + b.getCircumsphereDiameter());
+    Scalar b_dot = dot(r_ab, direction);
+    Scalar rsq = dot(r_ab, r_ab);
+    Scalar disc = b_dot*b_dot - (rsq - R*R);
+    if (disc < Scalar(0.0))
+        return max_distance;
+
+    Scalar s_lo = std::max(b_dot - sqrt(disc), Scalar(0.0));
+    Scalar s_hi = std::min(b_dot + sqrt(disc), max_distance);
+    if (s_lo >= s_hi)
+        return max_distance;
+
+    // the shapes overlap at the latest once their inspheres do
+    Scalar R_in = Scalar(a.getInsphereRadius() + b.getInsphereRadius());
+    Scalar disc_in = b_dot*b_dot - (rsq - R_in*R_in);
+    bool insphere_hit = false;
+    if (R_in > Scalar(0.0) && disc_in >= Scalar(0.0) && b_dot - sqrt(disc_in) < s_hi)
+        {
+        s_hi = std::max(b_dot - sqrt(disc_in), s_lo);
+        insphere_hit = true;
+        }
+
+    const Scalar h = resolution*Scalar(std::min(a.getCircumsphereDiameter(), b.getCircumsphereDiameter()));
+    const Scalar tol = std::max(h*Scalar(1e-3), detail::sweep_contact_gap(Scalar(2.0)*R));
+
+    if (test_overlap(r_ab - s_lo*direction, a, b, err))
+        {
+        normal = r_ab - s_lo*direction;
+        normal = normal/sqrt(dot(normal, normal));
+        return s_lo;
+        }
+
+    // step through the bracket until the shapes overlap
+    Scalar s_free = s_lo;
+    Scalar s_hit = insphere_hit ? s_hi : max_distance;
+    while (s_free < s_hi)
+        {
+        Scalar s = std::min(s_free + h, s_hi);
+        if (s == s_hi && insphere_hit)
+            break;
+        if (test_overlap(r_ab - s*direction, a, b, err))
+            {
+            s_hit = s;
+            break;
+            }
+        s_free = s;
+        }
+
+    if (s_hit == max_distance)
+        return max_distance;
+
+    // refine the collision between the last free and the first overlapping distance
+    while (s_hit - s_free > tol)
+        {
+        Scalar s = Scalar(0.5)*(s_free + s_hit);
+        if (test_overlap(r_ab - s*direction, a, b, err))
+            s_hit = s;
+        else
+            s_free = s;
+        }
+
+    normal = r_ab - s_free*direction;
+    normal = normal/sqrt(dot(normal, normal));
+    return s_free;
+    }
+
+//! Distance that sphere a can move along a direction before it collides with sphere b
+/*! \param r_ab Vector defining the position of shape b relative to shape a (r_b - r_a)
+    \param a first shape, the one that moves
+    \param b second shape
+    \param direction Unit vector of the motion of a
+    \param max_distance Largest distance of interest
+    \param resolution Unused, the collision is computed analytically
+    \param err Unused
+    \param normal Set to the unit vector from a to b at the collision
+    \returns The distance to the contact, less a small gap, or max_distance if the spheres do not collide before
+
+    \ingroup shape
+*/
+inline Scalar sweep_distance(const vec3<Scalar>& r_ab,
+                             const ShapeSphere& a,
+                             const ShapeSphere& b,
+                             const vec3<Scalar>& direction,
+                             Scalar max_distance,
+                             Scalar resolution,
+                             unsigned int& err,
+                             vec3<Scalar>& normal)
+    {
+    // solve |r_ab - s*direction| = sigma for the first root
+    Scalar sigma = Scalar(a.params.radius + b.params.radius);
+    Scalar b_dot = dot(r_ab, direction);
+    if (b_dot <= Scalar(0.0))
+        return max_distance;
+
+    Scalar disc = b_dot*b_dot - (dot(r_ab, r_ab) - sigma*sigma);
+    if (disc < Scalar(0.0))
+        return max_distance;
+
+    Scalar s = std::max(b_dot - sqrt(disc) - detail::sweep_contact_gap(Scalar(2.0)*sigma), Scalar(0.0));
+    if (s >= max_distance)
+        return max_distance;
+
+    normal = r_ab - s*direction;
+    normal = normal/sqrt(dot(normal, normal));
+    return s;
+    }
+
+}; // end namespace hpmc
+
+#endif // __SWEEP_DISTANCE_H__
@@ -12,6 +12,8 @@
 
 #include <set>
 #include <list>
+#include <atomic>
+#include <memory>
 
 #include "Moves.h"
 #include "HPMCCounters.h"
@@ -19,7 +21,6 @@
 
 #ifdef ENABLE_TBB
 #include <tbb/tbb.h>
-#include <atomic>
 #endif
 
 namespace hpmc
@@ -28,53 +29,20 @@ namespace hpmc
 namespace detail
 {
 
-#ifdef ENABLE_TBB
-//! Wrapper around std::atomic_flag to allow use in a std::vector
-class my_atomic_flag
-    {
-    public:
-        //! Default constructor
-        my_atomic_flag()
-            {
-            f.clear();
-            }
-
-        //! Copy constructor
-        /*! \note this constructor doesn't really copy the value of its argument,
-            it just reset's the flag to zero
-         */
-        my_atomic_flag(const my_atomic_flag& other)
-            {
-            f.clear();
-            }
-
-        //! Assignment operator (non-atomic)
-        /*! \note this assignment operator doesn't really copy the value of its argument,
-            it just reset's the flag to zero
-         */
-        my_atomic_flag& operator =( const my_atomic_flag& other)
-            {
-            f.clear();
-            return *this;
-            }
-
-        //! Sets flag and returns old value
-        bool test_and_set()
-            {
-            return f.test_and_set();
-            }
+// Graph class represents an undirected graph
+// by the connected components of the edges added so far
+/*! Edges are merged into a disjoint set forest as they are added. Every vertex points to a parent, and the roots of
+    the forest label the connected components. addEdge() links the roots of both vertices with an atomic compare and
+    swap, and find() shortens the paths it traverses (path halving), so that edges can be added concurrently from
+    several TBB threads without locks.
 
-    private:
-        std::atomic_flag f;
-    };
-#endif
-
-// Graph class represents a undirected graph
-// using adjacency list representation
+    Roots are always linked to the root with the smaller index, so the final labeling does not depend on the order in
+    which edges were added.
+*/
 class Graph
     {
     public:
-        Graph() {}      //!< Default constructor
+        Graph() : m_V(0), m_capacity(0) {}      //!< Default constructor
 
         inline Graph(unsigned int V);   // Constructor
 
@@ -89,156 +57,97 @@ class Graph
         #endif
 
     private:
-        #ifndef ENABLE_TBB
-        std::multimap<unsigned int,unsigned int> adj;
-        #else
-        tbb::concurrent_unordered_multimap<unsigned int, unsigned int> adj;
-        #endif
+        unsigned int m_V;           //!< Number of vertices
+        unsigned int m_capacity;    //!< Allocated number of vertices
+        std::unique_ptr<std::atomic<unsigned int>[]> m_parent;  //!< Parent of every vertex in the forest
 
-        #ifndef ENABLE_TBB
-        std::vector<unsigned int> visited;
-        #else
-        std::vector<my_atomic_flag> visited;
-        #endif
-
-        #ifndef ENABLE_TBB
-        // A function used by DFS
-        inline void DFSUtil(unsigned int v, std::vector<unsigned int>& visited, std::vector<unsigned int>& cur_cc);
-        #endif
-
-        #ifdef ENABLE_TBB
-        class DFSTask : public tbb::task
-            {
-            public:
-                DFSTask(unsigned int _root, std::vector<my_atomic_flag>& _visited,
-                    tbb::concurrent_vector<unsigned int>& _cc,
-                    const tbb::concurrent_unordered_multimap<unsigned int, unsigned int>& _adj)
-                    : root(_root), visited(_visited), cc(_cc), adj(_adj)
-                    { }
-
-                tbb::task* execute()
-                    {
-                    cc.push_back(root);
+        //! Find the root of a vertex
+        inline unsigned int find(unsigned int v);
+    };
 
-                    unsigned int count = 0;
-                    tbb::task_list list;
+Graph::Graph(unsigned int V)
+    : m_V(0), m_capacity(0)
+    {
+    resize(V);
+    }
 
-                    auto begin = adj.equal_range(root).first;
-                    auto end = adj.equal_range(root).second;
+void Graph::resize(unsigned int V)
+    {
+    if (V > m_capacity)
+        {
+        m_parent.reset(new std::atomic<unsigned int>[V]);
+        m_capacity = V;
+        }
+    m_V = V;
 
-                    for (auto it = begin; it != end; ++it)
-                        {
-                        unsigned int neighbor = it->second;
-                        if (!visited[neighbor].test_and_set())
-                            {
-                            if (count++ == 0)
-                                {
-                                root = neighbor; // for task recycling
-                                continue;
-                                }
-                            list.push_back(*new(allocate_child()) DFSTask(neighbor, visited, cc, adj));
-                            }
-                        }
+    // every vertex starts in its own component
+    for (unsigned int v = 0; v < m_V; ++v)
+        m_parent[v].store(v, std::memory_order_relaxed);
+    }
 
-                    if (count)
-                        {
-                        set_ref_count(count);
-                        spawn(list);
+unsigned int Graph::find(unsigned int v)
+    {
+    unsigned int parent = m_parent[v].load(std::memory_order_relaxed);
+    while (parent != v)
+        {
+        // point v to its grandparent, a failed exchange only means another thread got there first
+        unsigned int grandparent = m_parent[parent].load(std::memory_order_relaxed);
+        m_parent[v].compare_exchange_weak(parent, grandparent, std::memory_order_relaxed);
+        v = grandparent;
+        parent = m_parent[v].load(std::memory_order_relaxed);
+        }
+    return v;
+    }
 
-                        recycle_as_safe_continuation();
-                        }
+// method to add an undirected edge
+void Graph::addEdge(unsigned int v, unsigned int w)
+    {
+    while (true)
+        {
+        v = find(v);
+        w = find(w);
+        if (v == w)
+            return;
 
-                    return NULL;
-                    }
+        // link the larger root below the smaller one
+        if (v < w)
+            std::swap(v, w);
 
-            private:
-                unsigned int root;
-                std::vector<my_atomic_flag> & visited;
-                tbb::concurrent_vector<unsigned int>& cc;
-                const tbb::concurrent_unordered_multimap<unsigned int, unsigned int>& adj;
-            };
-        #endif // ENABLE_TBB
+        unsigned int expected = v;
+        if (m_parent[v].compare_exchange_strong(expected, w, std::memory_order_relaxed))
+            return;
 
-    };
+        // v is no longer a root, retry from its new root
+        }
+    }
 
 // Gather connected components in an undirected graph
+/*! Components are ordered by their smallest vertex, and the vertices of each component are sorted.
+*/
 #ifdef ENABLE_TBB
 void Graph::connectedComponents(std::vector<tbb::concurrent_vector<unsigned int> >& cc)
 #else
 void Graph::connectedComponents(std::vector<std::vector<unsigned int> >& cc)
 #endif
     {
-    #ifdef ENABLE_TBB
-    for (unsigned int v = 0; v < visited.size(); ++v)
+    // roots are the smallest vertex of their component, so components are numbered in order of first appearance
+    std::vector<unsigned int> component(m_V);
+    for (unsigned int v = 0; v < m_V; ++v)
         {
-        if (! visited[v].test_and_set())
+        unsigned int root = find(v);
+        if (root == v)
             {
-            tbb::concurrent_vector<unsigned int> component;
-            DFSTask& a = *new(tbb::task::allocate_root()) DFSTask(v, visited, component, adj);
-            tbb::task::spawn_root_and_wait(a);
-            cc.push_back(component);
+            component[v] = cc.size();
+            cc.resize(cc.size()+1);
             }
-        }
-    #else
-    std::fill(visited.begin(), visited.end(), 0);
-
-    // Depth first search
-    for (unsigned int v=0; v<visited.size(); v++)
-        {
-        if (visited[v] == false)
+        else
             {
-            std::vector<unsigned int> cur_cc;
-            DFSUtil(v, visited, cur_cc);
-            cc.push_back(cur_cc);
+            component[v] = component[root];
             }
+        cc[component[v]].push_back(v);
         }
-    #endif
     }
 
-#ifndef ENABLE_TBB
-void Graph::DFSUtil(unsigned int v, std::vector<unsigned int>& visited, std::vector<unsigned int>& cur_cc)
-    {
-    visited[v] = 1;
-    cur_cc.push_back(v);
-
-    // Recur for all the vertices
-    // adjacent to this vertex
-    auto begin = adj.equal_range(v).first;
-    auto end = adj.equal_range(v).second;
-    for(auto i = begin; i != end; ++i)
-        {
-        if(!visited[i->second])
-            DFSUtil(i->second, visited, cur_cc);
-        }
-    }
-#endif
-Graph::Graph(unsigned int V)
-    {
-    #ifndef ENABLE_TBB
-    visited.resize(V, 0);
-    #else
-    visited.resize(V);
-    #endif
-    }
-
-void Graph::resize(unsigned int V)
-    {
-    #ifndef ENABLE_TBB
-    visited.resize(V, 0);
-    #else
-    visited.clear();
-    visited.resize(V);
-    #endif
-
-    adj.clear();
-    }
-
-// method to add an undirected edge
-void Graph::addEdge(unsigned int v, unsigned int w)
-    {
-    adj.insert(std::make_pair(v,w));
-    adj.insert(std::make_pair(w,v));
-    }
 } // end namespace detail
 
 /*! A generic cluster move for attractive interactions.
@@ -491,6 +400,9 @@ class UpdaterClusters : public Updater
         virtual void findInteractions(unsigned int timestep, vec3<Scalar> pivot, quat<Scalar> q, bool swap,
             bool line, const std::map<unsigned int, unsigned int>& map);
 
+        //! Select the type of move and its pivot point or reflection axis
+        void chooseMove(hoomd::detail::Saru& rng, vec3<Scalar>& pivot, quat<Scalar>& q, bool& swap, bool& line);
+
         //! Helper function to get interaction range
         virtual Scalar getNominalWidth()
             {
@@ -613,7 +525,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                 // stackless search
                 for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree_old.getNumNodes(); cur_node_idx++)
                     {
-                    if (detail::overlap(m_aabb_tree_old.getNodeAABB(cur_node_idx), aabb_i_image))
+                    if (m_aabb_tree_old.overlapNode(cur_node_idx, aabb_i_image))
                         {
                         if (m_aabb_tree_old.isNodeLeaf(cur_node_idx))
                             {
@@ -735,7 +647,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
             // stackless search
             for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree_old.getNumNodes(); cur_node_idx++)
                 {
-                if (detail::overlap(m_aabb_tree_old.getNodeAABB(cur_node_idx), aabb_i_image))
+                if (m_aabb_tree_old.overlapNode(cur_node_idx, aabb_i_image))
                     {
                     if (m_aabb_tree_old.isNodeLeaf(cur_node_idx))
                         {
@@ -825,7 +737,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                 // stackless search
                 for (unsigned int cur_node_idx = 0; cur_node_idx < m_aabb_tree_old.getNumNodes(); cur_node_idx++)
                     {
-                    if (detail::overlap(m_aabb_tree_old.getNodeAABB(cur_node_idx), aabb_i_image))
+                    if (m_aabb_tree_old.overlapNode(cur_node_idx, aabb_i_image))
                         {
                         if (m_aabb_tree_old.isNodeLeaf(cur_node_idx))
                             {
@@ -946,7 +858,7 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
                 // stackless search
                 for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
                     {
-                    if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb_i_image))
+                    if (aabb_tree.overlapNode(cur_node_idx, aabb_i_image))
                         {
                         if (aabb_tree.isNodeLeaf(cur_node_idx))
                             {
@@ -1016,60 +928,19 @@ void UpdaterClusters<Shape>::findInteractions(unsigned int timestep, vec3<Scalar
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
-/*! Perform a cluster move
-    \param timestep Current time step of the simulation
+/*! \param rng Random number generator of this step
+    \param pivot Pivot point of the move (output)
+    \param q Line reflection axis, as a pure quaternion (output)
+    \param swap True if this is a type swap move (output)
+    \param line True if this is a line reflection (output)
 */
 template< class Shape >
-void UpdaterClusters<Shape>::update(unsigned int timestep)
+void UpdaterClusters<Shape>::chooseMove(hoomd::detail::Saru& rng, vec3<Scalar>& pivot, quat<Scalar>& q, bool& swap,
+    bool& line)
     {
-    m_exec_conf->msg->notice(10) << timestep << " UpdaterClusters" << std::endl;
-
-    m_count_step_start = m_count_total;
-
-    // if no particles, exit early
-    if (! m_pdata->getNGlobal()) return;
-
-    if (m_prof) m_prof->push(m_exec_conf,"HPMC Clusters");
-
-    // save a copy of the old configuration
-    m_n_particles_old = m_pdata->getN();
-
-    unsigned int nptl = m_pdata->getN()+m_pdata->getNGhosts();
-    m_postype_backup.resize(nptl);
-    m_orientation_backup.resize(nptl);
-    m_diameter_backup.resize(nptl);
-    m_charge_backup.resize(nptl);
-    m_tag_backup.resize(nptl);
-    m_image_backup.resize(nptl);
-
-        {
-        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
-        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
-
-        for (unsigned int i = 0; i < nptl; ++i)
-            {
-            m_postype_backup[i] = h_postype.data[i];
-            m_orientation_backup[i] = h_orientation.data[i];
-            m_diameter_backup[i] = h_diameter.data[i];
-            m_charge_backup[i] = h_charge.data[i];
-            m_tag_backup[i] = h_tag.data[i];
-            // reset image
-            m_image_backup[i] = make_int3(0,0,0);
-            }
-        }
-
-    if (m_prof) m_prof->push(m_exec_conf,"Transform");
-
-    // generate the move, select a pivot
-    hoomd::detail::Saru rng(timestep, this->m_seed, 0x09365bf5);
     BoxDim box = m_pdata->getGlobalBox();
-    vec3<Scalar> pivot(0,0,0);
 
-    bool swap = m_ab_types.size() && (rng.template s<Scalar>() < m_swap_move_ratio);
+    swap = m_ab_types.size() && (rng.template s<Scalar>() < m_swap_move_ratio);
 
     if (swap)
         {
@@ -1084,9 +955,7 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
         }
 
     // is this a line reflection?
-    bool line = !swap && (m_mc->hasOrientation() || (rng.template s<Scalar>() > m_move_ratio));
-
-    quat<Scalar> q;
+    line = !swap && (m_mc->hasOrientation() || (rng.template s<Scalar>() > m_move_ratio));
 
     if (line)
         {
@@ -1129,6 +998,63 @@ void UpdaterClusters<Shape>::update(unsigned int timestep)
             pivot.z = 0.0;
             }
         }
+    }
+
+/*! Perform a cluster move
+    \param timestep Current time step of the simulation
+*/
+template< class Shape >
+void UpdaterClusters<Shape>::update(unsigned int timestep)
+    {
+    m_exec_conf->msg->notice(10) << timestep << " UpdaterClusters" << std::endl;
+
+    m_count_step_start = m_count_total;
+
+    // if no particles, exit early
+    if (! m_pdata->getNGlobal()) return;
+
+    if (m_prof) m_prof->push(m_exec_conf,"HPMC Clusters");
+
+    // save a copy of the old configuration
+    m_n_particles_old = m_pdata->getN();
+
+    unsigned int nptl = m_pdata->getN()+m_pdata->getNGhosts();
+    m_postype_backup.resize(nptl);
+    m_orientation_backup.resize(nptl);
+    m_diameter_backup.resize(nptl);
+    m_charge_backup.resize(nptl);
+    m_tag_backup.resize(nptl);
+    m_image_backup.resize(nptl);
+
+        {
+        ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::read);
+
+        for (unsigned int i = 0; i < nptl; ++i)
+            {
+            m_postype_backup[i] = h_postype.data[i];
+            m_orientation_backup[i] = h_orientation.data[i];
+            m_diameter_backup[i] = h_diameter.data[i];
+            m_charge_backup[i] = h_charge.data[i];
+            m_tag_backup[i] = h_tag.data[i];
+            // reset image
+            m_image_backup[i] = make_int3(0,0,0);
+            }
+        }
+
+    if (m_prof) m_prof->push(m_exec_conf,"Transform");
+
+    // generate the move, select a pivot
+    hoomd::detail::Saru rng(timestep, this->m_seed, 0x09365bf5);
+    BoxDim box = m_pdata->getGlobalBox();
+    vec3<Scalar> pivot(0,0,0);
+    quat<Scalar> q;
+    bool swap, line;
+    chooseMove(rng, pivot, q, swap, line);
 
     SnapshotParticleData<Scalar> snap(m_pdata->getNGlobal());
 
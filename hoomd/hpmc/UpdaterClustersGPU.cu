@@ -0,0 +1,349 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "UpdaterClustersGPU.cuh"
+
+#include "hoomd/Saru.h"
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+/*! \file UpdaterClustersGPU.cu
+    \brief Definition of CUDA kernels and drivers for UpdaterClustersGPU
+*/
+
+//! Find the root of a vertex in the disjoint set forest
+/*! \param d_parent Parent of every vertex
+    \param v Vertex
+
+    The parents are read through a volatile pointer, since they are modified by concurrent threads.
+*/
+__device__ inline unsigned int find_root(volatile unsigned int *d_parent, unsigned int v)
+    {
+    unsigned int parent = d_parent[v];
+    while (parent != v)
+        {
+        v = parent;
+        parent = d_parent[v];
+        }
+    return v;
+    }
+
+//! Kernel to put every vertex into its own component
+__global__ void gpu_hpmc_components_init_kernel(unsigned int *d_parent, const unsigned int N)
+    {
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (i >= N)
+        return;
+
+    d_parent[i] = i;
+    }
+
+//! Kernel to merge the components connected by the edges
+/*! \param d_edges Edges of the graph
+    \param n_edges Number of edges
+    \param d_parent Parent of every vertex (in/out)
+
+    One thread per edge links the root with the larger index below the root with the smaller index, like
+    detail::Graph::addEdge(). The compare and swap fails when another thread has linked the root in the meantime,
+    and the thread retries from the new roots.
+*/
+__global__ void gpu_hpmc_components_hook_kernel(const uint2 *d_edges,
+                                                const unsigned int n_edges,
+                                                unsigned int *d_parent)
+    {
+    unsigned int e = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (e >= n_edges)
+        return;
+
+    uint2 edge = d_edges[e];
+    unsigned int v = edge.x;
+    unsigned int w = edge.y;
+
+    while (true)
+        {
+        v = find_root(d_parent, v);
+        w = find_root(d_parent, w);
+        if (v == w)
+            return;
+
+        // link the larger root below the smaller one
+        if (v < w)
+            {
+            unsigned int tmp = v;
+            v = w;
+            w = tmp;
+            }
+
+        if (atomicCAS(d_parent + v, v, w) == v)
+            return;
+        }
+    }
+
+//! Kernel to label every vertex with the root of its component
+__global__ void gpu_hpmc_components_compress_kernel(unsigned int *d_parent, const unsigned int N)
+    {
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (i >= N)
+        return;
+
+    d_parent[i] = find_root(d_parent, i);
+    }
+
+//! Kernel to collect the rejections and the change in composition of every cluster
+__global__ void gpu_hpmc_clusters_collect_kernel(const Scalar4 *d_postype,
+                                                 const Scalar4 *d_postype_old,
+                                                 const unsigned int *d_label,
+                                                 const unsigned int *d_reject,
+                                                 unsigned int *d_cluster_reject,
+                                                 int *d_cluster_dn,
+                                                 const unsigned int N,
+                                                 const hpmc_clusters_move_t move)
+    {
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (i >= N)
+        return;
+
+    unsigned int root = d_label[i];
+
+    // if any particle in the cluster is rejected, the cluster is not transformed
+    if (d_reject[i])
+        d_cluster_reject[root] = 1;
+
+    if (move.swap)
+        {
+        // count number of A and B particles in old and new config
+        unsigned int typ_new = __scalar_as_int(d_postype[i].w);
+        unsigned int typ_old = __scalar_as_int(d_postype_old[i].w);
+
+        int dn = (typ_new == move.ab_types.y) - (typ_new == move.ab_types.x)
+            - (typ_old == move.ab_types.y) + (typ_old == move.ab_types.x);
+        if (dn)
+            atomicAdd(d_cluster_dn + root, dn);
+        }
+    }
+
+//! Kernel to accept or revert the move of every cluster
+/*! Every cluster is flipped with probability flip_probability. The random numbers are drawn from a RNG seeded with
+    the root of the cluster, so that all particles in a cluster make the same decision without communication.
+
+    The acceptance counters are summed in shared memory and added to d_counters once per block.
+*/
+__global__ void gpu_hpmc_clusters_accept_kernel(Scalar4 *d_postype,
+                                                Scalar4 *d_orientation,
+                                                int3 *d_image,
+                                                const Scalar4 *d_postype_old,
+                                                const Scalar4 *d_orientation_old,
+                                                const int3 *d_image_old,
+                                                const unsigned int *d_label,
+                                                const unsigned int *d_cluster_reject,
+                                                const int *d_cluster_dn,
+                                                hpmc_clusters_counters_t *d_counters,
+                                                const unsigned int N,
+                                                const hpmc_clusters_move_t move,
+                                                const Scalar flip_probability,
+                                                const Scalar delta_mu,
+                                                const unsigned int seed,
+                                                const unsigned int timestep)
+    {
+    __shared__ unsigned int s_accept;
+    __shared__ unsigned int s_reject;
+    __shared__ unsigned int s_clusters;
+
+    if (threadIdx.x == 0)
+        {
+        s_accept = 0;
+        s_reject = 0;
+        s_clusters = 0;
+        }
+    __syncthreads();
+
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (i < N)
+        {
+        unsigned int root = d_label[i];
+        bool reject = d_cluster_reject[root];
+
+        hoomd::detail::Saru rng(root, seed, timestep);
+        bool flip = rng.f() < flip_probability;
+
+        if (move.swap)
+            {
+            Scalar NdelMu = Scalar(0.5)*(Scalar)d_cluster_dn[root]*delta_mu;
+            if (rng.f() > exp(NdelMu))
+                reject = true;
+            }
+
+        if (reject || !flip)
+            {
+            // revert cluster
+            d_postype[i] = d_postype_old[i];
+            d_orientation[i] = d_orientation_old[i];
+            d_image[i] = d_image_old[i];
+            }
+
+        // count flipped particles, swap moves only count the particles of the two types
+        bool count = flip;
+        if (move.swap)
+            {
+            unsigned int typ_i = __scalar_as_int(d_postype[i].w);
+            count = count && (typ_i == move.ab_types.x || typ_i == move.ab_types.y);
+            }
+
+        if (count)
+            {
+            if (reject)
+                atomicAdd(&s_reject, 1);
+            else
+                atomicAdd(&s_accept, 1);
+            }
+
+        if (root == i)
+            atomicAdd(&s_clusters, 1);
+        }
+    __syncthreads();
+
+    if (threadIdx.x == 0)
+        {
+        unsigned long long int *accept_count;
+        unsigned long long int *reject_count;
+        if (move.swap)
+            {
+            accept_count = &d_counters->swap_accept_count;
+            reject_count = &d_counters->swap_reject_count;
+            }
+        else if (move.line)
+            {
+            accept_count = &d_counters->reflection_accept_count;
+            reject_count = &d_counters->reflection_reject_count;
+            }
+        else
+            {
+            accept_count = &d_counters->pivot_accept_count;
+            reject_count = &d_counters->pivot_reject_count;
+            }
+
+        unsigned int n_block = min(blockDim.x, N - blockIdx.x * blockDim.x);
+
+        atomicAdd(accept_count, (unsigned long long int)s_accept);
+        atomicAdd(reject_count, (unsigned long long int)s_reject);
+        atomicAdd(&d_counters->n_clusters, (unsigned long long int)s_clusters);
+        atomicAdd(&d_counters->n_particles_in_clusters, (unsigned long long int)n_block);
+        }
+    }
+
+//! Label the connected components of a graph
+/*! \param d_edges Edges of the graph
+    \param n_edges Number of edges
+    \param d_label Set to the smallest vertex of the component of every vertex (output)
+    \param N Number of vertices
+    \param block_size Block size to execute
+    \param stream CUDA stream for the kernels
+    \returns Error codes generated by any CUDA calls, or cudaSuccess when there is no error
+
+    The components are found with a disjoint set forest, like in detail::Graph. Since roots are always linked below
+    the smaller root, the labels do not depend on the order of the edges.
+*/
+cudaError_t gpu_hpmc_connected_components(const uint2 *d_edges,
+                                          const unsigned int n_edges,
+                                          unsigned int *d_label,
+                                          const unsigned int N,
+                                          const unsigned int block_size,
+                                          cudaStream_t stream)
+    {
+    assert(d_label);
+
+    // determine the maximum block size and clamp the input block size down
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, gpu_hpmc_components_hook_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+
+    if (N == 0)
+        return cudaSuccess;
+
+    gpu_hpmc_components_init_kernel<<<N/run_block_size + 1, run_block_size, 0, stream>>>(d_label, N);
+
+    if (n_edges)
+        gpu_hpmc_components_hook_kernel<<<n_edges/run_block_size + 1, run_block_size, 0, stream>>>(d_edges,
+            n_edges,
+            d_label);
+
+    gpu_hpmc_components_compress_kernel<<<N/run_block_size + 1, run_block_size, 0, stream>>>(d_label, N);
+
+    return cudaSuccess;
+    }
+
+//! Accept or revert the cluster moves
+/*! \param args Bundled arguments
+    \returns Error codes generated by any CUDA calls, or cudaSuccess when there is no error
+*/
+cudaError_t gpu_hpmc_clusters_accept(const hpmc_clusters_accept_args_t& args)
+    {
+    assert(args.d_postype);
+    assert(args.d_postype_old);
+    assert(args.d_label);
+    assert(args.d_counters);
+
+    // determine the maximum block size and clamp the input block size down
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, gpu_hpmc_clusters_accept_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(args.block_size, max_block_size);
+
+    if (args.N == 0)
+        return cudaSuccess;
+
+    cudaMemsetAsync(args.d_cluster_reject, 0, sizeof(unsigned int)*args.N, args.stream);
+    cudaMemsetAsync(args.d_cluster_dn, 0, sizeof(int)*args.N, args.stream);
+
+    gpu_hpmc_clusters_collect_kernel<<<args.N/run_block_size + 1, run_block_size, 0, args.stream>>>(args.d_postype,
+        args.d_postype_old,
+        args.d_label,
+        args.d_reject,
+        args.d_cluster_reject,
+        args.d_cluster_dn,
+        args.N,
+        args.move);
+
+    gpu_hpmc_clusters_accept_kernel<<<args.N/run_block_size + 1, run_block_size, 0, args.stream>>>(args.d_postype,
+        args.d_orientation,
+        args.d_image,
+        args.d_postype_old,
+        args.d_orientation_old,
+        args.d_image_old,
+        args.d_label,
+        args.d_cluster_reject,
+        args.d_cluster_dn,
+        args.d_counters,
+        args.N,
+        args.move,
+        args.flip_probability,
+        args.delta_mu,
+        args.seed,
+        args.timestep);
+
+    return cudaSuccess;
+    }
+
+}; // end namespace detail
+
+} // end namespace hpmc
@@ -0,0 +1,535 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _UPDATER_HPMC_CLUSTERS_GPU_CUH_
+#define _UPDATER_HPMC_CLUSTERS_GPU_CUH_
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/Index1D.h"
+#include "hoomd/VectorMath.h"
+
+#include <cassert>
+
+#include "HPMCCounters.h"
+#include "IntegratorHPMCMonoGPU.cuh"
+
+namespace hpmc
+{
+
+namespace detail
+{
+
+/*! \file UpdaterClustersGPU.cuh
+    \brief Declaration of CUDA kernels drivers for UpdaterClustersGPU
+*/
+
+//! Parameters of the cluster move of one step
+/*! \ingroup hpmc_data_structs */
+struct hpmc_clusters_move_t
+    {
+    vec3<Scalar> pivot;     //!< Pivot point
+    quat<Scalar> q;         //!< Line reflection axis, as a pure quaternion
+    bool line;              //!< True if this is a line reflection
+    bool swap;              //!< True if this is a type swap move
+    uint2 ab_types;         //!< The two types exchanged by a swap move
+    };
+
+//! Wraps arguments to gpu_hpmc_clusters_overlaps
+/*! \ingroup hpmc_data_structs */
+struct hpmc_clusters_args_t
+    {
+    //! Construct a hpmc_clusters_args_t
+    hpmc_clusters_args_t(const Scalar4 *_d_postype,
+                         const Scalar4 *_d_orientation,
+                         const int3 *_d_image,
+                         const Scalar4 *_d_postype_old,
+                         const Scalar4 *_d_orientation_old,
+                         const int3 *_d_image_old,
+                         const unsigned int *_d_excell_idx,
+                         const unsigned int *_d_excell_size,
+                         const Index2D& _excli,
+                         const Index3D& _ci,
+                         const uint3& _cell_dim,
+                         const Scalar3& _ghost_width,
+                         const unsigned int _N,
+                         const unsigned int *_d_check_overlaps,
+                         const Index2D& _overlap_idx,
+                         const BoxDim& _box,
+                         const hpmc_clusters_move_t& _move,
+                         const bool _new_new,
+                         uint2 *_d_edges,
+                         unsigned int *_d_n_edges,
+                         const unsigned int _max_n_edges,
+                         unsigned int *_d_reject,
+                         const unsigned int _block_size,
+                         cudaStream_t _stream)
+                : d_postype(_d_postype),
+                  d_orientation(_d_orientation),
+                  d_image(_d_image),
+                  d_postype_old(_d_postype_old),
+                  d_orientation_old(_d_orientation_old),
+                  d_image_old(_d_image_old),
+                  d_excell_idx(_d_excell_idx),
+                  d_excell_size(_d_excell_size),
+                  excli(_excli),
+                  ci(_ci),
+                  cell_dim(_cell_dim),
+                  ghost_width(_ghost_width),
+                  N(_N),
+                  d_check_overlaps(_d_check_overlaps),
+                  overlap_idx(_overlap_idx),
+                  box(_box),
+                  move(_move),
+                  new_new(_new_new),
+                  d_edges(_d_edges),
+                  d_n_edges(_d_n_edges),
+                  max_n_edges(_max_n_edges),
+                  d_reject(_d_reject),
+                  block_size(_block_size),
+                  stream(_stream)
+        {
+        };
+
+    const Scalar4 *d_postype;           //!< Positions and types in the new configuration
+    const Scalar4 *d_orientation;       //!< Orientations in the new configuration
+    const int3 *d_image;                //!< Images in the new configuration
+    const Scalar4 *d_postype_old;       //!< Positions and types in the old configuration
+    const Scalar4 *d_orientation_old;   //!< Orientations in the old configuration
+    const int3 *d_image_old;            //!< Images in the old configuration
+    const unsigned int *d_excell_idx;   //!< Expanded cell list of the configuration that is searched
+    const unsigned int *d_excell_size;  //!< Number of particles in each expanded cell
+    const Index2D& excli;               //!< Expanded cell list indexer
+    const Index3D& ci;                  //!< Cell indexer
+    const uint3& cell_dim;              //!< Dimensions of the cell list
+    const Scalar3& ghost_width;         //!< Width of the ghost layer of the cell list
+    const unsigned int N;               //!< Number of particles
+    const unsigned int *d_check_overlaps; //!< Interaction matrix
+    const Index2D& overlap_idx;         //!< Indexer into the interaction matrix
+    const BoxDim& box;                  //!< Simulation box
+    const hpmc_clusters_move_t& move;   //!< The cluster move of this step
+    const bool new_new;                 //!< True to search the new configuration, false to search the old one
+    uint2 *d_edges;                     //!< Edges of the cluster graph (output)
+    unsigned int *d_n_edges;            //!< Number of edges, may exceed max_n_edges (in/out)
+    const unsigned int max_n_edges;     //!< Capacity of d_edges
+    unsigned int *d_reject;             //!< Set to 1 for particles whose cluster cannot be moved (output)
+    const unsigned int block_size;      //!< Block size to execute
+    cudaStream_t stream;                //!< Stream for the kernels
+    };
+
+//! Wraps arguments to gpu_hpmc_clusters_accept
+/*! \ingroup hpmc_data_structs */
+struct hpmc_clusters_accept_args_t
+    {
+    //! Construct a hpmc_clusters_accept_args_t
+    hpmc_clusters_accept_args_t(Scalar4 *_d_postype,
+                                Scalar4 *_d_orientation,
+                                int3 *_d_image,
+                                const Scalar4 *_d_postype_old,
+                                const Scalar4 *_d_orientation_old,
+                                const int3 *_d_image_old,
+                                const unsigned int *_d_label,
+                                const unsigned int *_d_reject,
+                                unsigned int *_d_cluster_reject,
+                                int *_d_cluster_dn,
+                                hpmc_clusters_counters_t *_d_counters,
+                                const unsigned int _N,
+                                const hpmc_clusters_move_t& _move,
+                                const Scalar _flip_probability,
+                                const Scalar _delta_mu,
+                                const unsigned int _seed,
+                                const unsigned int _timestep,
+                                const unsigned int _block_size,
+                                cudaStream_t _stream)
+                : d_postype(_d_postype),
+                  d_orientation(_d_orientation),
+                  d_image(_d_image),
+                  d_postype_old(_d_postype_old),
+                  d_orientation_old(_d_orientation_old),
+                  d_image_old(_d_image_old),
+                  d_label(_d_label),
+                  d_reject(_d_reject),
+                  d_cluster_reject(_d_cluster_reject),
+                  d_cluster_dn(_d_cluster_dn),
+                  d_counters(_d_counters),
+                  N(_N),
+                  move(_move),
+                  flip_probability(_flip_probability),
+                  delta_mu(_delta_mu),
+                  seed(_seed),
+                  timestep(_timestep),
+                  block_size(_block_size),
+                  stream(_stream)
+        {
+        };
+
+    Scalar4 *d_postype;                 //!< Positions and types, reverted for rejected clusters
+    Scalar4 *d_orientation;             //!< Orientations, reverted for rejected clusters
+    int3 *d_image;                      //!< Images, reverted for rejected clusters
+    const Scalar4 *d_postype_old;       //!< Positions and types in the old configuration
+    const Scalar4 *d_orientation_old;   //!< Orientations in the old configuration
+    const int3 *d_image_old;            //!< Images in the old configuration
+    const unsigned int *d_label;        //!< Cluster label (root vertex) of every particle
+    const unsigned int *d_reject;       //!< Particles whose cluster cannot be moved
+    unsigned int *d_cluster_reject;     //!< Scratch space, one flag per vertex
+    int *d_cluster_dn;                  //!< Scratch space, change of the number of B particles per vertex
+    hpmc_clusters_counters_t *d_counters; //!< Acceptance counters to increment
+    const unsigned int N;               //!< Number of particles
+    const hpmc_clusters_move_t& move;   //!< The cluster move of this step
+    const Scalar flip_probability;      //!< Probability to flip a cluster
+    const Scalar delta_mu;              //!< Difference in chemical potential mu_B - mu_A
+    const unsigned int seed;            //!< RNG seed
+    const unsigned int timestep;        //!< Current time step
+    const unsigned int block_size;      //!< Block size to execute
+    cudaStream_t stream;                //!< Stream for the kernels
+    };
+
+template< class Shape >
+cudaError_t gpu_hpmc_clusters_transform(Scalar4 *d_postype,
+                                        Scalar4 *d_orientation,
+                                        int3 *d_image,
+                                        unsigned int *d_reject,
+                                        const unsigned int N,
+                                        const BoxDim& box,
+                                        const Scalar3& range,
+                                        const hpmc_clusters_move_t& move,
+                                        const unsigned int block_size,
+                                        cudaStream_t stream,
+                                        const typename Shape::param_type *d_params);
+
+template< class Shape >
+cudaError_t gpu_hpmc_clusters_overlaps(const hpmc_clusters_args_t& args, const typename Shape::param_type *d_params);
+
+cudaError_t gpu_hpmc_connected_components(const uint2 *d_edges,
+                                          const unsigned int n_edges,
+                                          unsigned int *d_label,
+                                          const unsigned int N,
+                                          const unsigned int block_size,
+                                          cudaStream_t stream);
+
+cudaError_t gpu_hpmc_clusters_accept(const hpmc_clusters_accept_args_t& args);
+
+#ifdef NVCC
+/*!
+ * Definition of function templates and templated GPU kernels
+ */
+
+//! Kernel to apply the cluster move to every particle
+/*! \param d_postype Positions and types of the particles (in/out)
+    \param d_orientation Orientations of the particles (in/out)
+    \param d_image Images of the particles (in/out)
+    \param d_reject Set to 1 for particles that leave the active region of a non-periodic box, 0 otherwise (output)
+    \param N Number of particles
+    \param box Simulation box
+    \param range Width of the inactive region along non-periodic directions, as a fraction of the box
+    \param move The cluster move of this step
+    \param d_params Per-type shape parameters
+
+    This is the device version of the transformation of the snapshot in UpdaterClusters::update().
+
+    \ingroup hpmc_kernels
+*/
+template< class Shape >
+__global__ void gpu_hpmc_clusters_transform_kernel(Scalar4 *d_postype,
+                                                   Scalar4 *d_orientation,
+                                                   int3 *d_image,
+                                                   unsigned int *d_reject,
+                                                   const unsigned int N,
+                                                   const BoxDim box,
+                                                   const Scalar3 range,
+                                                   const hpmc_clusters_move_t move,
+                                                   const typename Shape::param_type *d_params)
+    {
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (i >= N)
+        return;
+
+    Scalar4 postype_i = d_postype[i];
+    vec3<Scalar> pos_i(postype_i);
+    unsigned int typ_i = __scalar_as_int(postype_i.w);
+    quat<Scalar> orientation_i(d_orientation[i]);
+    int3 image_i = d_image[i];
+    unsigned int reject = 0;
+
+    if (move.swap)
+        {
+        if (typ_i == move.ab_types.x)
+            typ_i = move.ab_types.y;
+        else if (typ_i == move.ab_types.y)
+            typ_i = move.ab_types.x;
+        }
+    else
+        {
+        // if the particle falls outside the active volume of a non-periodic box, reject
+        if (!isActive(vec_to_scalar3(pos_i), box, range))
+            reject = 1;
+
+        if (!move.line)
+            {
+            // point reflection
+            pos_i = move.pivot - (pos_i - move.pivot);
+            }
+        else
+            {
+            // line reflection
+            pos_i = lineReflection(pos_i, move.pivot, move.q);
+            Shape shape_i(orientation_i, d_params[typ_i]);
+            if (shape_i.hasOrientation())
+                orientation_i = move.q*orientation_i;
+            }
+
+        // reject if outside active volume of box at new position
+        if (!isActive(vec_to_scalar3(pos_i), box, range))
+            reject = 1;
+        }
+
+    postype_i = make_scalar4(pos_i.x, pos_i.y, pos_i.z, __int_as_scalar(typ_i));
+
+    // wrap particle back into box
+    box.wrap(postype_i, image_i);
+
+    d_postype[i] = postype_i;
+    d_orientation[i] = quat_to_scalar4(orientation_i);
+    d_image[i] = image_i;
+    d_reject[i] = reject;
+    }
+
+//! Kernel to find the overlaps that connect the particles into clusters
+/*! One thread per particle tests the particle in the new configuration against the particles of its expanded cell.
+    The cell list is built from the old configuration, or from the new configuration when args.new_new is set. In the
+    second case, every pair is tested once and only pairs that interact through a periodic boundary are recorded,
+    since only these prevent a line reflection (see UpdaterClusters::findInteractions()).
+
+    Every overlap adds an edge to args.d_edges. The edge counter is incremented even when the list is full, so
+    that the caller can grow the list and launch the kernel again.
+
+    \ingroup hpmc_kernels
+*/
+template< class Shape >
+__global__ void gpu_hpmc_clusters_overlaps_kernel(const Scalar4 *d_postype,
+                                                  const Scalar4 *d_orientation,
+                                                  const int3 *d_image,
+                                                  const Scalar4 *d_postype_old,
+                                                  const Scalar4 *d_orientation_old,
+                                                  const int3 *d_image_old,
+                                                  const unsigned int *d_excell_idx,
+                                                  const unsigned int *d_excell_size,
+                                                  const Index2D excli,
+                                                  const Index3D ci,
+                                                  const uint3 cell_dim,
+                                                  const Scalar3 ghost_width,
+                                                  const unsigned int N,
+                                                  const unsigned int *d_check_overlaps,
+                                                  const Index2D overlap_idx,
+                                                  const BoxDim box,
+                                                  const hpmc_clusters_move_t move,
+                                                  const bool new_new,
+                                                  uint2 *d_edges,
+                                                  unsigned int *d_n_edges,
+                                                  const unsigned int max_n_edges,
+                                                  unsigned int *d_reject,
+                                                  const typename Shape::param_type *d_params)
+    {
+    unsigned int i = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (i >= N)
+        return;
+
+    Scalar4 postype_i = d_postype[i];
+    unsigned int typ_i = __scalar_as_int(postype_i.w);
+    Shape shape_i(quat<Scalar>(d_orientation[i]), d_params[typ_i]);
+    vec3<Scalar> pos_i(postype_i);
+
+    // particles that crossed a boundary in the transformation
+    int3 image_i = d_image[i];
+    int3 image_old_i = d_image_old[i];
+    int3 wrap_i = make_int3(image_i.x - image_old_i.x, image_i.y - image_old_i.y, image_i.z - image_old_i.z);
+
+    // the configuration that is searched
+    const Scalar4 *d_postype_j = new_new ? d_postype : d_postype_old;
+    const Scalar4 *d_orientation_j = new_new ? d_orientation : d_orientation_old;
+
+    unsigned int my_cell = computeParticleCell(vec_to_scalar3(pos_i), box, ghost_width, cell_dim, ci);
+    unsigned int excell_size = d_excell_size[my_cell];
+
+    unsigned int err_count = 0;
+
+    for (unsigned int k = 0; k < excell_size; ++k)
+        {
+        unsigned int j = d_excell_idx[excli(k, my_cell)];
+
+        // no trivial bonds, and every pair once in the new configuration
+        if (j == i || (new_new && j < i))
+            continue;
+
+        Scalar4 postype_j = d_postype_j[j];
+        unsigned int typ_j = __scalar_as_int(postype_j.w);
+        Shape shape_j(quat<Scalar>(d_orientation_j[j]), d_params[typ_j]);
+
+        // put particle j into the coordinate system of particle i
+        vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_i;
+        vec3<Scalar> r_ij_min = vec3<Scalar>(box.minImage(vec_to_scalar3(r_ij)));
+
+        if (!(d_check_overlaps[overlap_idx(typ_i, typ_j)]
+            && check_circumsphere_overlap(r_ij_min, shape_i, shape_j)
+            && test_overlap(r_ij_min, shape_i, shape_j, err_count)))
+            continue;
+
+        bool shifted = r_ij_min.x != r_ij.x || r_ij_min.y != r_ij.y || r_ij_min.z != r_ij.z;
+
+        bool interacts_via_pbc;
+        if (new_new)
+            {
+            int3 image_j = d_image[j];
+            int3 image_old_j = d_image_old[j];
+            int3 wrap_j = make_int3(image_j.x - image_old_j.x, image_j.y - image_old_j.y, image_j.z - image_old_j.z);
+            interacts_via_pbc = shifted || wrap_i.x != wrap_j.x || wrap_i.y != wrap_j.y || wrap_i.z != wrap_j.z;
+
+            // only the interactions across the boundaries matter in the new configuration
+            if (!interacts_via_pbc)
+                continue;
+            }
+        else
+            {
+            interacts_via_pbc = shifted || wrap_i.x || wrap_i.y || wrap_i.z;
+            }
+
+        bool reject = move.line && !move.swap && interacts_via_pbc;
+
+        if (move.swap && ((typ_i != move.ab_types.x && typ_i != move.ab_types.y)
+            || (typ_j != move.ab_types.x && typ_j != move.ab_types.y)))
+            reject = true;
+
+        // add connection
+        unsigned int edge = atomicAdd(d_n_edges, 1);
+        if (edge < max_n_edges)
+            d_edges[edge] = make_uint2(i, j);
+
+        if (reject)
+            {
+            d_reject[i] = 1;
+            d_reject[j] = 1;
+            }
+        }
+    }
+
+//! Kernel driver for gpu_hpmc_clusters_transform_kernel()
+/*! \param block_size Block size to execute
+    \param stream CUDA stream for the kernel
+    \returns Error codes generated by any CUDA calls, or cudaSuccess when there is no error
+
+    See gpu_hpmc_clusters_transform_kernel() for the other parameters.
+
+    \ingroup hpmc_kernels
+*/
+template< class Shape >
+cudaError_t gpu_hpmc_clusters_transform(Scalar4 *d_postype,
+                                        Scalar4 *d_orientation,
+                                        int3 *d_image,
+                                        unsigned int *d_reject,
+                                        const unsigned int N,
+                                        const BoxDim& box,
+                                        const Scalar3& range,
+                                        const hpmc_clusters_move_t& move,
+                                        const unsigned int block_size,
+                                        cudaStream_t stream,
+                                        const typename Shape::param_type *d_params)
+    {
+    assert(d_postype);
+    assert(d_orientation);
+    assert(d_image);
+    assert(d_reject);
+
+    // determine the maximum block size and clamp the input block size down
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, gpu_hpmc_clusters_transform_kernel<Shape>);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+
+    if (N == 0)
+        return cudaSuccess;
+
+    gpu_hpmc_clusters_transform_kernel<Shape><<<N/run_block_size + 1, run_block_size, 0, stream>>>(d_postype,
+        d_orientation,
+        d_image,
+        d_reject,
+        N,
+        box,
+        range,
+        move,
+        d_params);
+
+    return cudaSuccess;
+    }
+
+//! Kernel driver for gpu_hpmc_clusters_overlaps_kernel()
+/*! \param args Bundled arguments
+    \param d_params Per-type shape parameters
+    \returns Error codes generated by any CUDA calls, or cudaSuccess when there is no error
+
+    \ingroup hpmc_kernels
+*/
+template< class Shape >
+cudaError_t gpu_hpmc_clusters_overlaps(const hpmc_clusters_args_t& args, const typename Shape::param_type *d_params)
+    {
+    assert(args.d_postype);
+    assert(args.d_postype_old);
+    assert(args.d_edges);
+    assert(args.d_n_edges);
+    assert(args.d_reject);
+
+    // determine the maximum block size and clamp the input block size down
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, gpu_hpmc_clusters_overlaps_kernel<Shape>);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(args.block_size, max_block_size);
+
+    if (args.N == 0)
+        return cudaSuccess;
+
+    gpu_hpmc_clusters_overlaps_kernel<Shape><<<args.N/run_block_size + 1, run_block_size, 0, args.stream>>>(
+        args.d_postype,
+        args.d_orientation,
+        args.d_image,
+        args.d_postype_old,
+        args.d_orientation_old,
+        args.d_image_old,
+        args.d_excell_idx,
+        args.d_excell_size,
+        args.excli,
+        args.ci,
+        args.cell_dim,
+        args.ghost_width,
+        args.N,
+        args.d_check_overlaps,
+        args.overlap_idx,
+        args.box,
+        args.move,
+        args.new_new,
+        args.d_edges,
+        args.d_n_edges,
+        args.max_n_edges,
+        args.d_reject,
+        d_params);
+
+    return cudaSuccess;
+    }
+
+#endif //NVCC
+
+}; // end namespace detail
+
+} // end namespace hpmc
+
+#endif // _UPDATER_HPMC_CLUSTERS_GPU_CUH_
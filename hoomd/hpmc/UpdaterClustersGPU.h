@@ -0,0 +1,586 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _UPDATER_HPMC_CLUSTERS_GPU_
+#define _UPDATER_HPMC_CLUSTERS_GPU_
+
+/*! \file UpdaterClustersGPU.h
+    \brief Declaration of UpdaterClustersGPU
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef ENABLE_CUDA
+
+#include "hoomd/CellList.h"
+#include "hoomd/Autotuner.h"
+
+#include "UpdaterClusters.h"
+#include "UpdaterClustersGPU.cuh"
+#include "IntegratorHPMCMonoGPU.h"
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+namespace hpmc
+{
+
+//! Cluster moves on the GPU
+/*! The particle data stays on the device during the move. The transformation is applied to every particle in
+    place, after the old configuration has been copied. The overlaps between the new and the old configuration, and
+    for line reflections the overlaps across periodic boundaries in the new configuration, are found with the expanded
+    cell list of UpdaterClustersGPU's own cell list and appended to a device edge list. The clusters are labeled with a
+    concurrent disjoint set forest, and the particles of rejected or not flipped clusters are restored from the copy.
+
+    The flip decision of a cluster is made with a RNG seeded by the smallest particle index in the cluster, so the
+    sequence of accepted moves differs from UpdaterClusters for the same seed.
+
+    Patch energies, MPI simulations and boxes that are too small for the cell list are handled by
+    UpdaterClusters::update().
+
+    \ingroup hpmc_integrators
+*/
+template< class Shape >
+class UpdaterClustersGPU : public UpdaterClusters<Shape>
+    {
+    public:
+        //! Constructor
+        /*! \param sysdef System definition
+            \param mc HPMC integrator
+            \param cl Cell list
+            \param seed PRNG seed
+        */
+        UpdaterClustersGPU(std::shared_ptr<SystemDefinition> sysdef,
+                           std::shared_ptr<IntegratorHPMCMonoGPU<Shape> > mc,
+                           std::shared_ptr<CellList> cl,
+                           unsigned int seed);
+
+        //! Destructor
+        virtual ~UpdaterClustersGPU();
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            m_tuner_excell_block_size->setPeriod(period);
+            m_tuner_excell_block_size->setEnabled(enable);
+
+            m_tuner_transform->setPeriod(period);
+            m_tuner_transform->setEnabled(enable);
+
+            m_tuner_overlaps->setPeriod(period);
+            m_tuner_overlaps->setEnabled(enable);
+
+            m_tuner_components->setPeriod(period);
+            m_tuner_components->setEnabled(enable);
+
+            m_tuner_accept->setPeriod(period);
+            m_tuner_accept->setEnabled(enable);
+            }
+
+        //! Take one timestep forward
+        /*! \param timestep timestep at which update is being evaluated
+        */
+        virtual void update(unsigned int timestep);
+
+    protected:
+        std::shared_ptr<IntegratorHPMCMonoGPU<Shape> > m_mc_gpu; //!< HPMC integrator, for the kernel stream
+        std::shared_ptr<CellList> m_cl;           //!< Cell list
+
+        uint3 m_last_dim;                     //!< Dimensions of the cell list on the last call to update
+        unsigned int m_last_nmax;             //!< Last cell list NMax value allocated in excell
+
+        GPUArray<unsigned int> m_excell_idx;  //!< Particle indices in expanded cells
+        GPUArray<unsigned int> m_excell_size; //!< Number of particles in each expanded cell
+        Index2D m_excell_list_indexer;        //!< Indexer to access elements of the excell_idx list
+
+        GPUArray<Scalar4> m_postype_old;      //!< Positions and types before the move
+        GPUArray<Scalar4> m_orientation_old;  //!< Orientations before the move
+        GPUArray<int3> m_image_old;           //!< Images before the move
+
+        GPUArray<uint2> m_edges;              //!< Edges of the cluster graph
+        GPUArray<unsigned int> m_n_edges;     //!< Number of edges
+        GPUArray<unsigned int> m_reject;      //!< Particles whose cluster cannot be moved
+        GPUArray<unsigned int> m_label;       //!< Cluster label of every particle
+        GPUArray<unsigned int> m_cluster_reject; //!< Rejection flag of every cluster, indexed by its label
+        GPUArray<int> m_cluster_dn;           //!< Change of the number of B particles in every cluster
+        GPUArray<hpmc_clusters_counters_t> m_counters; //!< Counters of the current step
+
+        std::unique_ptr<Autotuner> m_tuner_excell_block_size;  //!< Autotuner for excell block_size
+        std::unique_ptr<Autotuner> m_tuner_transform;          //!< Autotuner for the transformation
+        std::unique_ptr<Autotuner> m_tuner_overlaps;           //!< Autotuner for the overlap checks
+        std::unique_ptr<Autotuner> m_tuner_components;         //!< Autotuner for the connected components
+        std::unique_ptr<Autotuner> m_tuner_accept;             //!< Autotuner for the acceptance kernel
+
+        //! Compute the cell list and the expanded cell list of the current configuration
+        void computeExcell(unsigned int timestep);
+
+        //! Append the overlaps of one configuration to the edge list
+        void findOverlaps(const detail::hpmc_clusters_move_t& move, bool new_new);
+
+        //! Test if the global box is large enough for the minimum image convention of the cell list
+        bool checkBoxSize(Scalar nominal_width);
+    };
+
+template< class Shape >
+UpdaterClustersGPU<Shape>::UpdaterClustersGPU(std::shared_ptr<SystemDefinition> sysdef,
+                                              std::shared_ptr<IntegratorHPMCMonoGPU<Shape> > mc,
+                                              std::shared_ptr<CellList> cl,
+                                              unsigned int seed)
+    : UpdaterClusters<Shape>(sysdef, mc, seed), m_mc_gpu(mc), m_cl(cl)
+    {
+    this->m_exec_conf->msg->notice(5) << "Constructing UpdaterClustersGPU" << std::endl;
+
+    this->m_cl->setRadius(1);
+    this->m_cl->setComputeTDB(false);
+    this->m_cl->setFlagType();
+    this->m_cl->setComputeIdx(true);
+
+    // set last dim to a bogus value so that it will re-init on the first call
+    m_last_dim = make_uint3(0xffffffff, 0xffffffff, 0xffffffff);
+    m_last_nmax = 0xffffffff;
+
+    GPUArray<unsigned int> excell_size(0, this->m_exec_conf);
+    m_excell_size.swap(excell_size);
+
+    GPUArray<unsigned int> excell_idx(0, this->m_exec_conf);
+    m_excell_idx.swap(excell_idx);
+
+    GPUArray<Scalar4> postype_old(0, this->m_exec_conf);
+    m_postype_old.swap(postype_old);
+
+    GPUArray<Scalar4> orientation_old(0, this->m_exec_conf);
+    m_orientation_old.swap(orientation_old);
+
+    GPUArray<int3> image_old(0, this->m_exec_conf);
+    m_image_old.swap(image_old);
+
+    GPUArray<uint2> edges(0, this->m_exec_conf);
+    m_edges.swap(edges);
+
+    GPUArray<unsigned int> n_edges(1, this->m_exec_conf);
+    m_n_edges.swap(n_edges);
+
+    GPUArray<unsigned int> reject(0, this->m_exec_conf);
+    m_reject.swap(reject);
+
+    GPUArray<unsigned int> label(0, this->m_exec_conf);
+    m_label.swap(label);
+
+    GPUArray<unsigned int> cluster_reject(0, this->m_exec_conf);
+    m_cluster_reject.swap(cluster_reject);
+
+    GPUArray<int> cluster_dn(0, this->m_exec_conf);
+    m_cluster_dn.swap(cluster_dn);
+
+    GPUArray<hpmc_clusters_counters_t> counters(1, this->m_exec_conf);
+    m_counters.swap(counters);
+
+    cudaDeviceProp dev_prop = this->m_exec_conf->dev_prop;
+    m_tuner_excell_block_size.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 1000000, "hpmc_clusters_excell_block_size", this->m_exec_conf));
+    m_tuner_transform.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 100000, "hpmc_clusters_transform", this->m_exec_conf));
+    m_tuner_overlaps.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 100000, "hpmc_clusters_overlaps", this->m_exec_conf));
+    m_tuner_components.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 100000, "hpmc_clusters_components", this->m_exec_conf));
+    m_tuner_accept.reset(new Autotuner(dev_prop.warpSize, dev_prop.maxThreadsPerBlock, dev_prop.warpSize, 5, 100000, "hpmc_clusters_accept", this->m_exec_conf));
+    }
+
+template< class Shape >
+UpdaterClustersGPU<Shape>::~UpdaterClustersGPU()
+    {
+    this->m_exec_conf->msg->notice(5) << "Destroying UpdaterClustersGPU" << std::endl;
+    }
+
+template< class Shape >
+bool UpdaterClustersGPU<Shape>::checkBoxSize(Scalar nominal_width)
+    {
+    BoxDim box = this->m_pdata->getGlobalBox();
+    Scalar3 npd = box.getNearestPlaneDistance();
+
+    return !((box.getPeriodic().x && npd.x <= nominal_width*2) ||
+        (box.getPeriodic().y && npd.y <= nominal_width*2) ||
+        (this->m_sysdef->getNDimensions() == 3 && box.getPeriodic().z && npd.z <= nominal_width*2));
+    }
+
+/*! \param timestep Current time step
+
+    The cell list is rebuilt even if it was computed earlier in this step, since the particles have moved.
+*/
+template< class Shape >
+void UpdaterClustersGPU<Shape>::computeExcell(unsigned int timestep)
+    {
+    this->m_cl->forceCompute(timestep);
+
+    // if the cell list is a different size than last time, reinitialize expanded cell list
+    uint3 cur_dim = this->m_cl->getDim();
+    if (m_last_dim.x != cur_dim.x || m_last_dim.y != cur_dim.y || m_last_dim.z != cur_dim.z ||
+        m_last_nmax != this->m_cl->getNmax())
+        {
+        this->m_exec_conf->msg->notice(4) << "hpmc clusters resizing expanded cells" << std::endl;
+
+        unsigned int num_cells = this->m_cl->getCellIndexer().getNumElements();
+        unsigned int num_adj = this->m_cl->getCellAdjIndexer().getW();
+        unsigned int num_max = this->m_cl->getNmax();
+
+        // make the excell dimensions the same, but with room for Nmax*Nadj in each cell
+        m_excell_list_indexer = Index2D(num_max * num_adj, num_cells);
+
+        m_excell_idx.resize(m_excell_list_indexer.getNumElements());
+        m_excell_size.resize(num_cells);
+
+        m_last_dim = cur_dim;
+        m_last_nmax = num_max;
+        }
+
+    ArrayHandle<unsigned int> d_cell_size(this->m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_cell_idx(this->m_cl->getIndexArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_cell_adj(this->m_cl->getCellAdjArray(), access_location::device, access_mode::read);
+
+    ArrayHandle<unsigned int> d_excell_idx(m_excell_idx, access_location::device, access_mode::overwrite);
+    ArrayHandle<unsigned int> d_excell_size(m_excell_size, access_location::device, access_mode::overwrite);
+
+    m_tuner_excell_block_size->begin();
+    detail::gpu_hpmc_excell(d_excell_idx.data,
+                            d_excell_size.data,
+                            m_excell_list_indexer,
+                            d_cell_idx.data,
+                            d_cell_size.data,
+                            d_cell_adj.data,
+                            this->m_cl->getCellIndexer(),
+                            this->m_cl->getCellListIndexer(),
+                            this->m_cl->getCellAdjIndexer(),
+                            m_tuner_excell_block_size->getParam());
+    if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    m_tuner_excell_block_size->end();
+    }
+
+/*! \param move The cluster move of this step
+    \param new_new True to search the new configuration, false to search the old one
+
+    The edges are appended to the edges found so far. If the edge list overflows, it is grown and the search is
+    repeated.
+*/
+template< class Shape >
+void UpdaterClustersGPU<Shape>::findOverlaps(const detail::hpmc_clusters_move_t& move, bool new_new)
+    {
+    unsigned int n_edges_start;
+        {
+        ArrayHandle<unsigned int> h_n_edges(m_n_edges, access_location::host, access_mode::read);
+        n_edges_start = *h_n_edges.data;
+        }
+
+    bool reallocate = true;
+    while (reallocate)
+        {
+            {
+            ArrayHandle<unsigned int> h_n_edges(m_n_edges, access_location::host, access_mode::overwrite);
+            *h_n_edges.data = n_edges_start;
+            }
+
+            {
+            ArrayHandle<Scalar4> d_postype(this->m_pdata->getPositions(), access_location::device, access_mode::read);
+            ArrayHandle<Scalar4> d_orientation(this->m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+            ArrayHandle<int3> d_image(this->m_pdata->getImages(), access_location::device, access_mode::read);
+
+            ArrayHandle<Scalar4> d_postype_old(m_postype_old, access_location::device, access_mode::read);
+            ArrayHandle<Scalar4> d_orientation_old(m_orientation_old, access_location::device, access_mode::read);
+            ArrayHandle<int3> d_image_old(m_image_old, access_location::device, access_mode::read);
+
+            ArrayHandle<unsigned int> d_excell_idx(m_excell_idx, access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_excell_size(m_excell_size, access_location::device, access_mode::read);
+
+            ArrayHandle<unsigned int> d_overlaps(this->m_mc->getInteractionMatrix(), access_location::device, access_mode::read);
+
+            ArrayHandle<uint2> d_edges(m_edges, access_location::device, access_mode::readwrite);
+            ArrayHandle<unsigned int> d_n_edges(m_n_edges, access_location::device, access_mode::readwrite);
+            ArrayHandle<unsigned int> d_reject(m_reject, access_location::device, access_mode::readwrite);
+
+            // the arguments are held by reference
+            Scalar3 ghost_width = this->m_cl->getGhostWidth();
+            BoxDim box = this->m_pdata->getGlobalBox();
+
+            detail::hpmc_clusters_args_t args(d_postype.data,
+                                              d_orientation.data,
+                                              d_image.data,
+                                              d_postype_old.data,
+                                              d_orientation_old.data,
+                                              d_image_old.data,
+                                              d_excell_idx.data,
+                                              d_excell_size.data,
+                                              m_excell_list_indexer,
+                                              this->m_cl->getCellIndexer(),
+                                              this->m_cl->getDim(),
+                                              ghost_width,
+                                              this->m_pdata->getN(),
+                                              d_overlaps.data,
+                                              this->m_mc->getOverlapIndexer(),
+                                              box,
+                                              move,
+                                              new_new,
+                                              d_edges.data,
+                                              d_n_edges.data,
+                                              m_edges.getNumElements(),
+                                              d_reject.data,
+                                              m_tuner_overlaps->getParam(),
+                                              m_mc_gpu->getStream());
+
+            m_tuner_overlaps->begin();
+            detail::gpu_hpmc_clusters_overlaps<Shape>(args, this->m_mc->getParams().data());
+            if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            m_tuner_overlaps->end();
+            }
+
+        ArrayHandle<unsigned int> h_n_edges(m_n_edges, access_location::host, access_mode::read);
+        reallocate = *h_n_edges.data > m_edges.getNumElements();
+        if (reallocate)
+            {
+            // keep the edges that were found before this search
+            unsigned int new_size = std::max(*h_n_edges.data, 2*(unsigned int)m_edges.getNumElements());
+            this->m_exec_conf->msg->notice(9) << "UpdaterClustersGPU resizing edge list to " << new_size << std::endl;
+            m_edges.resize(new_size);
+            }
+        }
+    }
+
+/*! Perform a cluster move
+    \param timestep Current time step of the simulation
+*/
+template< class Shape >
+void UpdaterClustersGPU<Shape>::update(unsigned int timestep)
+    {
+    Scalar nominal_width = this->getNominalWidth();
+
+    // patch energies are only evaluated on the host
+    bool host = bool(this->m_mc->getPatchInteraction()) || !checkBoxSize(nominal_width);
+
+    #ifdef ENABLE_MPI
+    if (this->m_comm)
+        host = true;
+    #endif
+
+    if (host)
+        {
+        UpdaterClusters<Shape>::update(timestep);
+        return;
+        }
+
+    this->m_exec_conf->msg->notice(10) << timestep << " UpdaterClustersGPU" << std::endl;
+
+    this->m_count_step_start = this->m_count_total;
+
+    unsigned int N = this->m_pdata->getN();
+
+    // if no particles, exit early
+    if (!N) return;
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "HPMC Clusters");
+
+    // generate the move, select a pivot
+    hoomd::detail::Saru rng(timestep, this->m_seed, 0x09365bf5);
+    detail::hpmc_clusters_move_t move;
+    this->chooseMove(rng, move.pivot, move.q, move.swap, move.line);
+    move.ab_types = make_uint2(0, 0);
+    if (move.swap)
+        move.ab_types = make_uint2(this->m_ab_types[0], this->m_ab_types[1]);
+
+    BoxDim box = this->m_pdata->getGlobalBox();
+
+    // compute the width of the active region
+    Scalar3 npd = box.getNearestPlaneDistance();
+    Scalar3 range = nominal_width / npd;
+
+    if (this->m_sysdef->getNDimensions() == 2)
+        {
+        // no interaction along z
+        range.z = 0;
+        }
+
+    if (this->m_cl->getNominalWidth() != nominal_width)
+        this->m_cl->setNominalWidth(nominal_width);
+
+    // reallocate the per particle arrays
+    if (m_postype_old.getNumElements() < N)
+        {
+        m_postype_old.resize(N);
+        m_orientation_old.resize(N);
+        m_image_old.resize(N);
+        m_reject.resize(N);
+        m_label.resize(N);
+        m_cluster_reject.resize(N);
+        m_cluster_dn.resize(N);
+        }
+
+    if (m_edges.getNumElements() < N)
+        m_edges.resize(N);
+
+    // locality data of the old configuration
+    computeExcell(timestep);
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "Transform");
+
+        {
+        ArrayHandle<Scalar4> d_postype(this->m_pdata->getPositions(), access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar4> d_orientation(this->m_pdata->getOrientationArray(), access_location::device, access_mode::readwrite);
+        ArrayHandle<int3> d_image(this->m_pdata->getImages(), access_location::device, access_mode::readwrite);
+
+        ArrayHandle<Scalar4> d_postype_old(m_postype_old, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar4> d_orientation_old(m_orientation_old, access_location::device, access_mode::overwrite);
+        ArrayHandle<int3> d_image_old(m_image_old, access_location::device, access_mode::overwrite);
+
+        ArrayHandle<unsigned int> d_reject(m_reject, access_location::device, access_mode::overwrite);
+
+        cudaStream_t stream = m_mc_gpu->getStream();
+
+        // save a copy of the old configuration
+        cudaMemcpyAsync(d_postype_old.data, d_postype.data, sizeof(Scalar4)*N, cudaMemcpyDeviceToDevice, stream);
+        cudaMemcpyAsync(d_orientation_old.data, d_orientation.data, sizeof(Scalar4)*N, cudaMemcpyDeviceToDevice, stream);
+        cudaMemcpyAsync(d_image_old.data, d_image.data, sizeof(int3)*N, cudaMemcpyDeviceToDevice, stream);
+
+        m_tuner_transform->begin();
+        detail::gpu_hpmc_clusters_transform<Shape>(d_postype.data,
+                                                   d_orientation.data,
+                                                   d_image.data,
+                                                   d_reject.data,
+                                                   N,
+                                                   box,
+                                                   range,
+                                                   move,
+                                                   m_tuner_transform->getParam(),
+                                                   stream,
+                                                   this->m_mc->getParams().data());
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_tuner_transform->end();
+        }
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "Overlaps");
+
+        {
+        // start with an empty edge list
+        ArrayHandle<unsigned int> h_n_edges(m_n_edges, access_location::host, access_mode::overwrite);
+        *h_n_edges.data = 0;
+        }
+
+    // determine which particles interact, new particles against the old configuration
+    findOverlaps(move, false);
+
+    if (move.line && !move.swap)
+        {
+        // check if particles are interacting across the boundaries in the new configuration
+        computeExcell(timestep);
+        findOverlaps(move, true);
+        }
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "Move");
+
+    unsigned int n_edges;
+        {
+        ArrayHandle<unsigned int> h_n_edges(m_n_edges, access_location::host, access_mode::read);
+        n_edges = *h_n_edges.data;
+        }
+
+        {
+        ArrayHandle<uint2> d_edges(m_edges, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_label(m_label, access_location::device, access_mode::overwrite);
+
+        m_tuner_components->begin();
+        detail::gpu_hpmc_connected_components(d_edges.data,
+                                              n_edges,
+                                              d_label.data,
+                                              N,
+                                              m_tuner_components->getParam(),
+                                              m_mc_gpu->getStream());
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_tuner_components->end();
+        }
+
+        {
+        ArrayHandle<hpmc_clusters_counters_t> h_counters(m_counters, access_location::host, access_mode::overwrite);
+        *h_counters.data = hpmc_clusters_counters_t();
+        }
+
+        {
+        ArrayHandle<Scalar4> d_postype(this->m_pdata->getPositions(), access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar4> d_orientation(this->m_pdata->getOrientationArray(), access_location::device, access_mode::readwrite);
+        ArrayHandle<int3> d_image(this->m_pdata->getImages(), access_location::device, access_mode::readwrite);
+
+        ArrayHandle<Scalar4> d_postype_old(m_postype_old, access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_orientation_old(m_orientation_old, access_location::device, access_mode::read);
+        ArrayHandle<int3> d_image_old(m_image_old, access_location::device, access_mode::read);
+
+        ArrayHandle<unsigned int> d_label(m_label, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_reject(m_reject, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_cluster_reject(m_cluster_reject, access_location::device, access_mode::overwrite);
+        ArrayHandle<int> d_cluster_dn(m_cluster_dn, access_location::device, access_mode::overwrite);
+        ArrayHandle<hpmc_clusters_counters_t> d_counters(m_counters, access_location::device, access_mode::readwrite);
+
+        detail::hpmc_clusters_accept_args_t args(d_postype.data,
+                                                 d_orientation.data,
+                                                 d_image.data,
+                                                 d_postype_old.data,
+                                                 d_orientation_old.data,
+                                                 d_image_old.data,
+                                                 d_label.data,
+                                                 d_reject.data,
+                                                 d_cluster_reject.data,
+                                                 d_cluster_dn.data,
+                                                 d_counters.data,
+                                                 N,
+                                                 move,
+                                                 this->m_flip_probability,
+                                                 this->m_delta_mu,
+                                                 this->m_seed,
+                                                 timestep,
+                                                 m_tuner_accept->getParam(),
+                                                 m_mc_gpu->getStream());
+
+        m_tuner_accept->begin();
+        detail::gpu_hpmc_clusters_accept(args);
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_tuner_accept->end();
+        }
+
+        {
+        ArrayHandle<hpmc_clusters_counters_t> h_counters(m_counters, access_location::host, access_mode::read);
+        this->m_count_total = this->m_count_total + *h_counters.data;
+        }
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+
+    // the particles have moved, signal that AABB tree is invalid
+    this->m_mc->invalidateAABBTree();
+    this->m_mc->communicate(true);
+
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+    }
+
+//! Export the UpdaterClustersGPU class to python
+/*! \param name Name of the class in the exported python module
+    \tparam Shape An instantiation of UpdaterClustersGPU<Shape> will be exported
+*/
+template < class Shape > void export_UpdaterClustersGPU(pybind11::module& m, const std::string& name)
+    {
+    pybind11::class_< UpdaterClustersGPU<Shape>, std::shared_ptr< UpdaterClustersGPU<Shape> > >(m, name.c_str(), pybind11::base< UpdaterClusters<Shape> >())
+          .def( pybind11::init< std::shared_ptr<SystemDefinition>,
+                         std::shared_ptr< IntegratorHPMCMonoGPU<Shape> >,
+                         std::shared_ptr<CellList>,
+                         unsigned int >())
+    ;
+    }
+
+} // end namespace hpmc
+
+#endif // ENABLE_CUDA
+
+#endif // _UPDATER_HPMC_CLUSTERS_GPU_
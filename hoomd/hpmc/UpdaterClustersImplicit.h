@@ -152,7 +152,7 @@ void UpdaterClustersImplicit<Shape,Integrator>::findInteractions(unsigned int ti
             // stackless search
             for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree_old.getNumNodes(); cur_node_idx++)
                 {
-                if (detail::overlap(this->m_aabb_tree_old.getNodeAABB(cur_node_idx), aabb_i_image))
+                if (this->m_aabb_tree_old.overlapNode(cur_node_idx, aabb_i_image))
                     {
                     if (this->m_aabb_tree_old.isNodeLeaf(cur_node_idx))
                         {
@@ -257,7 +257,7 @@ void UpdaterClustersImplicit<Shape,Integrator>::findInteractions(unsigned int ti
             // stackless search
             for (unsigned int cur_node_idx = 0; cur_node_idx < this->m_aabb_tree_old.getNumNodes(); cur_node_idx++)
                 {
-                if (detail::overlap(this->m_aabb_tree_old.getNodeAABB(cur_node_idx), aabb_i_image))
+                if (this->m_aabb_tree_old.overlapNode(cur_node_idx, aabb_i_image))
                     {
                     if (this->m_aabb_tree_old.isNodeLeaf(cur_node_idx))
                         {
@@ -359,7 +359,7 @@ void UpdaterClustersImplicit<Shape,Integrator>::findInteractions(unsigned int ti
                 // stackless search
                 for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
                     {
-                    if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb_i_image))
+                    if (aabb_tree.overlapNode(cur_node_idx, aabb_i_image))
                         {
                         if (aabb_tree.isNodeLeaf(cur_node_idx))
                             {
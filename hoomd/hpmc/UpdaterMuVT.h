@@ -734,6 +734,9 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
                         // create a new particle with given type
                         unsigned int tag;
 
+                        // the AABB tree can follow the insertion if it is up to date now
+                        bool update_tree = m_mc->canUpdateAABBTree();
+
                         tag = m_pdata->addParticle(type);
 
                         // set the position of the particle
@@ -747,6 +750,10 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
                             {
                             m_pdata->setOrientation(tag, quat_to_scalar4(shape_test.orientation));
                             }
+
+                        if (update_tree)
+                            m_mc->insertAABBTreeParticle(m_pdata->getRTag(tag));
+
                         m_count_total.insert_accept_count++;
                         }
                     else
@@ -876,7 +883,14 @@ void UpdaterMuVT<Shape>::update(unsigned int timestep)
                 if (accept)
                     {
                     // remove particle
+                    bool update_tree = m_mc->canUpdateAABBTree();
+                    unsigned int idx = m_pdata->getRTag(tag);
+
                     m_pdata->removeParticle(tag);
+
+                    if (update_tree)
+                        m_mc->removeAABBTreeParticle(idx);
+
                     m_count_total.remove_accept_count++;
                     }
                 else
@@ -1322,18 +1336,24 @@ bool UpdaterMuVT<Shape>::tryRemoveParticle(unsigned int timestep, unsigned int t
     // if not, no overlaps generated, return happily
     if (!patch) return true;
 
+    // look up all properties of the particle at once, instead of one collective call per property
+    TagData tag_data;
+    m_pdata->getByTag(std::vector<unsigned int>(1, tag),
+        tag_field::type | tag_field::orientation | tag_field::diameter | tag_field::charge | tag_field::position,
+        tag_data);
+
     // type
-    unsigned int type = this->m_pdata->getType(tag);
+    unsigned int type = tag_data.type[0];
 
     // read in the current position and orientation
-    quat<Scalar> orientation(m_pdata->getOrientation(tag));
+    quat<Scalar> orientation(tag_data.orientation[0]);
 
     // charge and diameter
-    Scalar diameter = m_pdata->getDiameter(tag);
-    Scalar charge = m_pdata->getCharge(tag);
+    Scalar diameter = tag_data.diameter[0];
+    Scalar charge = tag_data.charge[0];
 
-    // getPosition() takes into account grid shift, correct for that
-    Scalar3 p = m_pdata->getPosition(tag)+m_pdata->getOrigin();
+    // getByTag() takes into account grid shift, correct for that
+    Scalar3 p = tag_data.pos[0]+m_pdata->getOrigin();
     int3 tmp = make_int3(0,0,0);
     m_pdata->getGlobalBox().wrap(p,tmp);
     vec3<Scalar> pos(p);
@@ -1390,7 +1410,7 @@ bool UpdaterMuVT<Shape>::tryRemoveParticle(unsigned int timestep, unsigned int t
             // stackless search
             for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
                 {
-                if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                if (aabb_tree.overlapNode(cur_node_idx, aabb))
                     {
                     if (aabb_tree.isNodeLeaf(cur_node_idx))
                         {
@@ -1564,7 +1584,7 @@ bool UpdaterMuVT<Shape>::tryInsertParticle(unsigned int timestep, unsigned int t
                 // stackless search
                 for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
                     {
-                    if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    if (aabb_tree.overlapNode(cur_node_idx, aabb))
                         {
                         if (aabb_tree.isNodeLeaf(cur_node_idx))
                             {
@@ -1654,10 +1674,13 @@ bool UpdaterMuVT<Shape>::trySwitchType(unsigned int timestep, unsigned int tag,
     // update the image list
     const std::vector<vec3<Scalar> >&image_list = m_mc->updateImageList();
 
-    quat<Scalar> orientation(m_pdata->getOrientation(tag));
+    TagData tag_data;
+    m_pdata->getByTag(std::vector<unsigned int>(1, tag), tag_field::orientation | tag_field::position, tag_data);
+
+    quat<Scalar> orientation(tag_data.orientation[0]);
 
-    // getPosition() takes into account grid shift, correct for that
-    Scalar3 p = m_pdata->getPosition(tag)+m_pdata->getOrigin();
+    // getByTag() takes into account grid shift, correct for that
+    Scalar3 p = tag_data.pos[0]+m_pdata->getOrigin();
     int3 tmp = make_int3(0,0,0);
     m_pdata->getGlobalBox().wrap(p,tmp);
     vec3<Scalar> pos(p);
@@ -1704,7 +1727,7 @@ bool UpdaterMuVT<Shape>::trySwitchType(unsigned int timestep, unsigned int tag,
         // stackless search
         for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
             {
-            if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+            if (aabb_tree.overlapNode(cur_node_idx, aabb))
                 {
                 if (aabb_tree.isNodeLeaf(cur_node_idx))
                     {
@@ -294,10 +294,15 @@ bool UpdaterMuVTImplicit<Shape,Integrator>::trySwitchType(unsigned int timestep,
         }
 
     #ifdef ENABLE_MPI
-    quat<Scalar> orientation(this->m_pdata->getOrientation(tag));
+    // look up all properties of the particle at once, instead of one collective call per property
+    TagData tag_data;
+    this->m_pdata->getByTag(std::vector<unsigned int>(1, tag),
+        tag_field::orientation | tag_field::position | tag_field::type, tag_data);
 
-    // getPosition() takes into account grid shift, correct for that
-    Scalar3 p = this->m_pdata->getPosition(tag)+this->m_pdata->getOrigin();
+    quat<Scalar> orientation(tag_data.orientation[0]);
+
+    // getByTag() takes into account grid shift, correct for that
+    Scalar3 p = tag_data.pos[0]+this->m_pdata->getOrigin();
     int3 tmp = make_int3(0,0,0);
     this->m_pdata->getGlobalBox().wrap(p,tmp);
     vec3<Scalar> pos(p);
@@ -306,7 +311,7 @@ bool UpdaterMuVTImplicit<Shape,Integrator>::trySwitchType(unsigned int timestep,
     unsigned int type_d = m_mc_implicit->getDepletantType();
 
     // old type
-    unsigned int type = this->m_pdata->getType(tag);
+    unsigned int type = tag_data.type[0];
 
     // Depletant and colloid diameter
     Scalar d_dep, d_colloid, d_colloid_old;
@@ -562,7 +567,7 @@ bool UpdaterMuVTImplicit<Shape,Integrator>::moveDepletantsInUpdatedRegion(unsign
                     // stackless search
                     for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
                         {
-                        if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                        if (aabb_tree.overlapNode(cur_node_idx, aabb))
                             {
                             if (aabb_tree.isNodeLeaf(cur_node_idx))
                                 {
@@ -771,7 +776,7 @@ bool UpdaterMuVTImplicit<Shape,Integrator>::moveDepletantsIntoNewPosition(unsign
                     // stackless search
                     for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
                         {
-                        if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                        if (aabb_tree.overlapNode(cur_node_idx, aabb))
                             {
                             if (aabb_tree.isNodeLeaf(cur_node_idx))
                                 {
@@ -945,7 +950,7 @@ bool UpdaterMuVTImplicit<Shape,Integrator>::moveDepletantsIntoOldPosition(unsign
                     // stackless search
                     for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
                         {
-                        if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                        if (aabb_tree.overlapNode(cur_node_idx, aabb))
                             {
                             if (aabb_tree.isNodeLeaf(cur_node_idx))
                                 {
@@ -1134,7 +1139,7 @@ unsigned int UpdaterMuVTImplicit<Shape,Integrator>::countDepletantOverlapsInNewP
                 // stackless search
                 for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
                     {
-                    if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    if (aabb_tree.overlapNode(cur_node_idx, aabb))
                         {
                         if (aabb_tree.isNodeLeaf(cur_node_idx))
                             {
@@ -1294,7 +1299,7 @@ unsigned int UpdaterMuVTImplicit<Shape,Integrator>::countDepletantOverlaps(unsig
                 // stackless search
                 for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
                     {
-                    if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    if (aabb_tree.overlapNode(cur_node_idx, aabb))
                         {
                         if (aabb_tree.isNodeLeaf(cur_node_idx))
                             {
@@ -1503,7 +1508,7 @@ bool UpdaterMuVTImplicit<Shape,Integrator>::boxResizeAndScale(unsigned int times
                 // stackless search
                 for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
                     {
-                    if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
+                    if (aabb_tree.overlapNode(cur_node_idx, aabb))
                         {
                         if (aabb_tree.isNodeLeaf(cur_node_idx))
                             {
@@ -1566,58 +1571,8 @@ bool UpdaterMuVTImplicit<Shape,Integrator>::boxResizeAndScale(unsigned int times
                 // new depletant coordinates
                 vec3<Scalar> pos_test(new_box.makeCoordinates(f_test));
 
-                for (unsigned int cur_image = 0; cur_image < n_images; cur_image++)
-                    {
-                    vec3<Scalar> pos_test_image = pos_test + image_list[cur_image];
-                    detail::AABB aabb = aabb_test_local;
-                    aabb.translate(pos_test_image);
-
-                    // stackless search
-                    for (unsigned int cur_node_idx = 0; cur_node_idx < aabb_tree.getNumNodes(); cur_node_idx++)
-                       {
-                       if (detail::overlap(aabb_tree.getNodeAABB(cur_node_idx), aabb))
-                            {
-                            if (aabb_tree.isNodeLeaf(cur_node_idx))
-                                {
-                                for (unsigned int cur_p = 0; cur_p < aabb_tree.getNodeNumParticles(cur_node_idx); cur_p++)
-                                    {
-                                    // read in its position and orientation
-                                    unsigned int j = aabb_tree.getNodeParticle(cur_node_idx, cur_p);
-
-                                    Scalar4 postype_j;
-                                    Scalar4 orientation_j;
-
-                                    // load the new position and orientation of the j particle
-                                    postype_j = h_postype.data[j];
-                                    orientation_j = h_orientation.data[j];
-
-                                    // put particles in coordinate system of particle i
-                                    vec3<Scalar> r_ij = vec3<Scalar>(postype_j) - pos_test_image;
-
-                                    unsigned int typ_j = __scalar_as_int(postype_j.w);
-                                    Shape shape_j(quat<Scalar>(orientation_j), params[typ_j]);
-
-                                    if (h_overlaps.data[overlap_idx(typ_j, type_d)]
-                                         && check_circumsphere_overlap(r_ij, shape_test, shape_j)
-                                         && test_overlap(r_ij, shape_test, shape_j, err_count))
-                                         {
-                                         overlap = true;
-                                         break;
-                                         }
-                                     }
-                                 }
-                             }
-                         else
-                             {
-                             // skip ahead
-                             cur_node_idx += aabb_tree.getNodeSkip(cur_node_idx);
-                             }
-
-                         }  // end loop over AABB nodes
-
-                    if (overlap)
-                        break;
-                    } // end loop over images
+                overlap = detail::checkDepletantOverlap(shape_test, pos_test, type_d, aabb_tree, image_list,
+                    h_postype.data, h_orientation.data, params, h_overlaps.data, overlap_idx, err_count);
                } // end overlap check in new configuration
 
             if (overlap_old)
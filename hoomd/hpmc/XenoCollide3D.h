@@ -30,8 +30,9 @@ namespace detail
 
 const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
 
-//! XenoCollide overlap check in 3D
-/*! \tparam SupportFuncA Support function class type for shape A
+//! XenoCollide overlap check in 3D, in a given precision
+/*! \tparam Real Precision of the computation
+    \tparam SupportFuncA Support function class type for shape A
     \tparam SupportFuncB Support function class type for shape B
     \param sa Support function for shape A
     \param sb Support function for shape B
@@ -39,6 +40,9 @@ const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
     \param q Orientation of shape B in frame A
     \param R Approximate radius of Minkowski difference for scaling tolerance value
     \param err_count Error counter to increment whenever an infinite loop is encountered
+    \param margin Margin relative to \a R, results decided closer than margin*R to contact set \a near_contact
+    \param near_contact Set to true when the result is decided within the margin, or could not be resolved
+    \param axis (if not NULL) in/out separating axis in frame A, see below
     \returns true when the two shapes overlap and false when they are disjoint.
 
     XenoCollide is a generic algorithm for detecting overlaps between two shapes. It operates with the support function
@@ -60,6 +64,18 @@ const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
     The recommended way of using this code is to specify the support functor in the same file as the shape data
     (e.g. ShapeConvexPolyhedron.h). Then include XenoCollide3D.h and call xenocollide_3d where needed.
 
+    **Near contact**
+    Every exit is decided by the side of a plane that the origin lies on. When \a margin is positive and the origin
+    is closer than margin*R to that plane, the round-off of a single precision computation may have decided the
+    result, and \a near_contact is set so the caller can re-test the pair in double precision.
+
+    **Warm start**
+    When \a axis is given and non-zero, the support plane with that normal is tested first. If the origin lies
+    outside of it, the shapes are disjoint and the test returns after a single support evaluation. Pairs that moved
+    only a little since they were last found disjoint are usually still separated by the same plane. When the shapes
+    are found disjoint by a support plane, its normal is stored in \a axis for the next test. When they overlap,
+    \a axis is left unchanged, since the trial move is rejected and the previous configuration is kept.
+
     **Normalization**
     In _Games Programming Gems_, the book normalizes all vectors passed into S. This is unnecessary in some circumstances
     and we avoid it for performance reasons. Support functions that require the use of normal n vectors should normalize
@@ -67,22 +83,29 @@ const unsigned int XENOCOLLIDE_3D_MAX_ITERATIONS = 1024;
 
     \ingroup minkowski
 */
-template<class SupportFuncA, class SupportFuncB>
-DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
-                                  const SupportFuncB& sb,
-                                  const vec3<OverlapReal>& ab_t,
-                                  const quat<OverlapReal>& q,
-                                  const OverlapReal R,
-                                  unsigned int& err_count)
+template<class Real, class SupportFuncA, class SupportFuncB>
+DEVICE inline bool xenocollide_3d_margin(const SupportFuncA& sa,
+                                         const SupportFuncB& sb,
+                                         const vec3<Real>& ab_t,
+                                         const quat<Real>& q,
+                                         const Real R,
+                                         unsigned int& err_count,
+                                         const Real margin,
+                                         bool& near_contact,
+                                         vec3<Real> *axis = NULL)
     {
     // This implementation of XenoCollide is hand-written from the description of the algorithm on page 171 of _Games
     // Programming Gems 7_
 
-    vec3<OverlapReal> v0, v1, v2, v3, v4, n;
-    CompositeSupportFunc3D<SupportFuncA, SupportFuncB> S(sa, sb, ab_t, q);
-    OverlapReal d;
-    const OverlapReal precision_tol = 1e-7;        // precision tolerance for single-precision floats near 1.0
-    const OverlapReal root_tol = 3e-4;   // square root of precision tolerance
+    vec3<Real> v0, v1, v2, v3, v4, n;
+    CompositeSupportFunc3D<SupportFuncA, SupportFuncB, Real> S(sa, sb, ab_t, q);
+    Real d;
+    const Real precision_tol = 1e-7;        // precision tolerance for single-precision floats near 1.0
+    const Real root_tol = 3e-4;   // square root of precision tolerance
+
+    // distance of the origin from a deciding plane below which the result is flagged as near contact
+    const Real margin_dist = margin * R;
+    near_contact = false;
 
     if (fabs(ab_t.x) < root_tol && fabs(ab_t.y) < root_tol && fabs(ab_t.z) < root_tol)
         {
@@ -90,6 +113,18 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         return true;
         }
 
+    if (axis != NULL && (axis->x != Real(0.0) || axis->y != Real(0.0) || axis->z != Real(0.0)))
+        {
+        // particles do not overlap if origin outside the cached support plane
+        v1 = S(*axis);
+        if (dot(v1, *axis) < Real(0.0))
+            {
+            if (-dot(v1, *axis) < margin_dist * fast::sqrt(dot(*axis, *axis)))
+                near_contact = true;
+            return false;
+            }
+        }
+
     // Phase 1: Portal Discovery
     // ------
     // Find the origin ray v0 from the origin to an interior point of the Minkowski difference.
@@ -103,8 +138,15 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
     v1 = S(-v0); // should be guaranteed ||v1|| > 0
 
     /* if (dot(v1, v1 - v0) <= 0) // by convexity */
-    if (dot(v1, v0) > OverlapReal(0.0))
-        return false;   // origin is outside v1 support plane
+    if (dot(v1, v0) > Real(0.0))
+        {
+        // origin is outside v1 support plane
+        if (dot(v1, v0) < margin_dist * fast::sqrt(dot(v0, v0)))
+            near_contact = true;
+        if (axis != NULL)
+            *axis = -v0;
+        return false;
+        }
 
     // find support v2 perpendicular to v0, v1 plane
     n = cross(v1, v0);
@@ -112,17 +154,26 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
     // plane. If origin is on a line between v1 and v0, particles overlap.
     //if (dot(n, n) < tol)
     if (fabs(n.x) < precision_tol && fabs(n.y) < precision_tol && fabs(n.z) < precision_tol)
+        {
+        near_contact = (margin > Real(0.0));
         return true;
+        }
 
     v2 = S(n); // Convexity should guarantee ||v2|| > 0, but v2 == v1 may be possible in edge cases of {B}-{A}
     // particles do not overlap if origin outside v2 support plane
-    if (dot(v2, n) < OverlapReal(0.0))
+    if (dot(v2, n) < Real(0.0))
+        {
+        if (-dot(v2, n) < margin_dist * fast::sqrt(dot(n, n)))
+            near_contact = true;
+        if (axis != NULL)
+            *axis = n;
         return false;
+        }
 
     // Find next support direction perpendicular to plane (v1,v0,v2)
     n = cross(v1 - v0, v2 - v0);
     // Maintain known handedness of the portal: make sure plane normal points towards origin
-    if (dot(n, v0) > OverlapReal(0.0))
+    if (dot(n, v0) > Real(0.0))
         {
         v1.swap(v2);
         n = -n;
@@ -139,13 +190,21 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         if (count >= XENOCOLLIDE_3D_MAX_ITERATIONS)
             {
             err_count++;
+            near_contact = (margin > Real(0.0));
             return true;
             }
 
         // Get the next support point
         v3 = S(n);
         if (dot(v3, n) <= 0)
-            return false; // check if origin outside v3 support plane
+            {
+            // check if origin outside v3 support plane
+            if (-dot(v3, n) < margin_dist * fast::sqrt(dot(n, n)))
+                near_contact = true;
+            if (axis != NULL)
+                *axis = n;
+            return false;
+            }
 
         // If origin lies on opposite side of a plane from the third support point, use outer-facing plane normal
         // to find a new support point.
@@ -153,7 +212,7 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         // if (dot(cross(v3 - v0, v1 - v0), -v0) < 0)
         // -> if (dot(cross(v1 - v0, v3 - v0), v0) < 0)
         // A little bit of algebra shows that dot(cross(a - c, b - c), c) == dot(cross(a, b), c)
-        if (dot(cross(v1, v3), v0) < OverlapReal(0.0))
+        if (dot(cross(v1, v3), v0) < Real(0.0))
             {
             // replace v2 and find new support direction
             v2 = v3; // preserve handedness
@@ -161,7 +220,7 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
             continue; // continue iterating to find valid portal
             }
         // Check (v2, v0, v3)
-        if (dot(cross(v3, v2), v0) < OverlapReal(0.0))
+        if (dot(cross(v3, v2), v0) < Real(0.0))
             {
             // replace v1 and find new support direction
             v1 = v3;
@@ -186,8 +245,10 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         // check if origin is inside (or overlapping)
         // the = is important, because in an MC simulation you are guaranteed to find cases where edges and or vertices
         // touch exactly
-        if (dot(v1, n) >= OverlapReal(0.0))
+        if (dot(v1, n) >= Real(0.0))
             {
+            if (dot(v1, n) < margin_dist * fast::sqrt(dot(n, n)))
+                near_contact = true;
             return true;
             }
 
@@ -197,30 +258,44 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
         // ----
         // if (origin outside support plane) return false
-        if (dot(v4, n) < OverlapReal(0.0))
+        if (dot(v4, n) < Real(0.0))
             {
+            if (-dot(v4, n) < margin_dist * fast::sqrt(dot(n, n)))
+                near_contact = true;
+            if (axis != NULL)
+                *axis = n;
             return false;
             }
 
         // Perform tolerance checks
         // are we within an epsilon of the surface of the shape? If yes, done, one way or another
-        const OverlapReal tol_multiplier = 10000;
+        const Real tol_multiplier = 10000;
         n = cross(v2 - v1, v3 - v1);
         d = dot((v4 - v1) * tol_multiplier, n);
-        OverlapReal tol = precision_tol * tol_multiplier * R * fast::sqrt(dot(n,n));
+        Real tol = precision_tol * tol_multiplier * R * fast::sqrt(dot(n,n));
 
         // First, check if v4 is on plane (v2,v1,v3)
         if (fabs(d) < tol)
-            return false; // no more refinement possible, but not intersection detected
+            {
+            // no more refinement possible, but not intersection detected
+            // the support plane does not separate the shapes, so there is no axis to store
+            if (-dot(v1, n) < margin_dist * fast::sqrt(dot(n, n)))
+                near_contact = true;
+            return false;
+            }
 
         // Second, check if origin is on plane (v2,v1,v3) and has been missed by other checks
         d = dot(v1 * tol_multiplier, n);
         if (fabs(d) < tol)
+            {
+            near_contact = (margin > Real(0.0));
             return true;
+            }
 
         if (count >= XENOCOLLIDE_3D_MAX_ITERATIONS)
             {
             err_count++;
+            near_contact = (margin > Real(0.0));
             /*
             // Output useful info if we are in an infinite loop
             printf(
@@ -260,17 +335,17 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
         //        (v1 % v4) * v0 == v1 * (v4 % v0)    > 0 if origin inside (v1, v4, v0)
         //        (v2 % v4) * v0 == v2 * (v4 % v0)    > 0 if origin inside (v2, v4, v0)
         //        (v3 % v4) * v0 == v3 * (v4 % v0)    > 0 if origin inside (v3, v4, v0)
-        vec3<OverlapReal> x = cross(v4, v0);
-        if (dot(v1, x) > OverlapReal(0.0))
+        vec3<Real> x = cross(v4, v0);
+        if (dot(v1, x) > Real(0.0))
             {
-            if (dot(v2, x) > OverlapReal(0.0))
+            if (dot(v2, x) > Real(0.0))
                 v1 = v4;    // Inside v1 & inside v2 ==> eliminate v1
             else
                 v3 = v4;                   // Inside v1 & outside v2 ==> eliminate v3
             }
         else
             {
-            if (dot(v3, x) > OverlapReal(0.0))
+            if (dot(v3, x) > Real(0.0))
                 v2 = v4;    // Outside v1 & inside v3 ==> eliminate v2
             else
                 v1 = v4;                   // Outside v1 & outside v3 ==> eliminate v1
@@ -278,6 +353,28 @@ DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
 
         }
     }
+//! XenoCollide overlap check in 3D
+/*! \tparam SupportFuncA Support function class type for shape A
+    \tparam SupportFuncB Support function class type for shape B
+
+    Runs xenocollide_3d_margin() in OverlapReal precision without flagging near-contact results. The optional
+    \a axis is the separating axis of the warm start.
+
+    \ingroup minkowski
+*/
+template<class SupportFuncA, class SupportFuncB>
+DEVICE inline bool xenocollide_3d(const SupportFuncA& sa,
+                                  const SupportFuncB& sb,
+                                  const vec3<OverlapReal>& ab_t,
+                                  const quat<OverlapReal>& q,
+                                  const OverlapReal R,
+                                  unsigned int& err_count,
+                                  vec3<OverlapReal> *axis = NULL)
+    {
+    bool near_contact;
+    return xenocollide_3d_margin<OverlapReal>(sa, sb, ab_t, q, R, err_count, OverlapReal(0.0), near_contact, axis);
+    }
+
 } // end namespace hpmc::detail
 
 }; // end namespace hpmc
@@ -0,0 +1,66 @@
+# Copyright (c) 2009-2019 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+# Maintainer: joaander
+
+R""" Access to the HPMC C++ extensions.
+
+The shape independent classes are exported by the ``_hpmc`` extension. The integrators, updaters, computes and
+external fields templated on each shape, together with their GPU kernels, are built into one extension per shape
+(``_hpmc_sphere``, ``_hpmc_convex_polyhedron``, ...) so that ``import hoomd.hpmc`` does not load the code for every
+shape. :py:data:`_hpmc` looks up names in ``_hpmc`` first and imports the extension of a shape the first time one of
+its classes is used, based on the shape suffix of the class name.
+"""
+
+from hoomd.hpmc import _hpmc as _hpmc_base
+
+import importlib
+
+# suffix of the C++ class names and the extension that exports them, longest suffixes first so that
+# e.g. SphereUnion is not matched as Sphere
+_shape_extensions = sorted([('Sphere', 'sphere'),
+                            ('ConvexPolygon', 'convex_polygon'),
+                            ('SimplePolygon', 'simple_polygon'),
+                            ('Spheropolygon', 'spheropolygon'),
+                            ('Polyhedron', 'polyhedron'),
+                            ('Ellipsoid', 'ellipsoid'),
+                            ('FacetedSphere', 'faceted_sphere'),
+                            ('Sphinx', 'sphinx'),
+                            ('ConvexPolyhedronUnion', 'union_convex_polyhedron'),
+                            ('SphereUnion', 'union_sphere'),
+                            ('ConvexPolyhedron', 'convex_polyhedron'),
+                            ('Spheropolyhedron', 'convex_spheropolyhedron')],
+                           key=lambda s: len(s[0]), reverse=True)
+
+def load_shape(shape):
+    R""" Import the extension for a shape.
+
+    Args:
+        shape (str): Name of the shape extension, e.g. ``'sphere'``
+
+    Returns:
+        The extension module ``hoomd.hpmc._hpmc_<shape>``.
+    """
+    return importlib.import_module('hoomd.hpmc._hpmc_' + shape)
+
+class _lazy_extension(object):
+    R""" Module-like view over ``_hpmc`` and the per-shape extensions, which are loaded on first use.
+    """
+    def __getattr__(self, name):
+        try:
+            value = getattr(_hpmc_base, name)
+        except AttributeError:
+            value = None
+            for suffix, shape in _shape_extensions:
+                if name.endswith(suffix):
+                    value = getattr(load_shape(shape), name)
+                    break
+
+            if value is None:
+                raise AttributeError("HPMC has no C++ export named " + name)
+
+        # cache the lookup, __getattr__ is only called for names that are not set yet
+        setattr(self, name, value)
+        return value
+
+_hpmc = _lazy_extension()
@@ -5,6 +5,7 @@
 #include "IntegratorHPMCMonoGPU.cuh"
 #include "IntegratorHPMCMonoImplicitGPU.cuh"
 #include "IntegratorHPMCMonoImplicitNewGPU.cuh"
+#include "UpdaterClustersGPU.cuh"
 
 #include "ShapeFacetedSphere.h"
 
@@ -19,6 +20,37 @@ template cudaError_t gpu_hpmc_free_volume<ShapeFacetedSphere>(const hpmc_free_vo
                                                        const typename ShapeFacetedSphere::param_type *d_params);
 template cudaError_t gpu_hpmc_update<ShapeFacetedSphere>(const hpmc_args_t& args,
                                                   const typename ShapeFacetedSphere::param_type *d_params);
+template cudaError_t gpu_hpmc_clusters_transform<ShapeFacetedSphere>(Scalar4 *d_postype,
+                                                                     Scalar4 *d_orientation,
+                                                                     int3 *d_image,
+                                                                     unsigned int *d_reject,
+                                                                     const unsigned int N,
+                                                                     const BoxDim& box,
+                                                                     const Scalar3& range,
+                                                                     const hpmc_clusters_move_t& move,
+                                                                     const unsigned int block_size,
+                                                                     cudaStream_t stream,
+                                                                     const typename ShapeFacetedSphere::param_type *d_params);
+template cudaError_t gpu_hpmc_clusters_overlaps<ShapeFacetedSphere>(const hpmc_clusters_args_t& args,
+                                                                    const typename ShapeFacetedSphere::param_type *d_params);
+template cudaError_t gpu_hpmc_count_overlaps<ShapeFacetedSphere>(unsigned int *d_overlap_count,
+                                                                 const Scalar4 *d_postype,
+                                                                 const Scalar4 *d_orientation,
+                                                                 const unsigned int *d_tag,
+                                                                 const unsigned int *d_excell_idx,
+                                                                 const unsigned int *d_excell_size,
+                                                                 const Index2D& excli,
+                                                                 const Index3D& ci,
+                                                                 const uint3& cell_dim,
+                                                                 const Scalar3& ghost_width,
+                                                                 const unsigned int N,
+                                                                 const unsigned int *d_check_overlaps,
+                                                                 const Index2D& overlap_idx,
+                                                                 const BoxDim& box,
+                                                                 const bool early_exit,
+                                                                 const unsigned int block_size,
+                                                                 const cudaStream_t stream,
+                                                                 const typename ShapeFacetedSphere::param_type *d_params);
 template cudaError_t gpu_hpmc_implicit_count_overlaps<ShapeFacetedSphere>(const hpmc_implicit_args_t& args,
                                                   const typename ShapeFacetedSphere::param_type *d_params);
 template cudaError_t gpu_hpmc_implicit_accept_reject<ShapeFacetedSphere>(const hpmc_implicit_args_t& args,
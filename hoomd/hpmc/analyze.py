@@ -4,10 +4,11 @@
 """ Compute properties of hard particle configurations.
 """
 
-from . import _hpmc
+from ._extension import _hpmc
 from . import integrate
 
 from hoomd.analyze import _analyzer
+from hoomd import _hoomd
 import hoomd
 
 class sdf(_analyzer):
@@ -54,6 +55,13 @@ class sdf(_analyzer):
     Warning:
         :py:class:`sdf` does not compute correct pressures for simulations with concave particles.
 
+    On the CPU, the particles are processed in parallel with TBB threads. On the GPU, the histogram is counted from a
+    cell list with the overlap checks of the GPU integrators, and the box must be wider than twice the largest
+    particle diameter divided by *1-xmax*.
+
+    .. versionchanged:: 2.5
+        :py:class:`sdf` runs on the GPU.
+
     Numpy extrapolation code::
 
         def extrapolate(s, dx, xmax, degree=5):
@@ -80,32 +88,47 @@ class sdf(_analyzer):
         _analyzer.__init__(self);
 
         # create the c++ mirror class
-        cls = None;
         if isinstance(mc, integrate.sphere):
-            cls = _hpmc.AnalyzerSDFSphere;
+            suffix = 'Sphere';
         elif isinstance(mc, integrate.convex_polygon):
-            cls = _hpmc.AnalyzerSDFConvexPolygon;
+            suffix = 'ConvexPolygon';
         elif isinstance(mc, integrate.simple_polygon):
-            cls = _hpmc.AnalyzerSDFSimplePolygon;
+            suffix = 'SimplePolygon';
         elif isinstance(mc, integrate.convex_polyhedron):
-            cls = _hpmc.AnalyzerSDFConvexPolyhedron;
+            suffix = 'ConvexPolyhedron';
         elif isinstance(mc, integrate.convex_spheropolyhedron):
-            cls = _hpmc.AnalyzerSDFSpheropolyhedron;
+            suffix = 'Spheropolyhedron';
         elif isinstance(mc, integrate.ellipsoid):
-            cls = _hpmc.AnalyzerSDFEllipsoid;
+            suffix = 'Ellipsoid';
         elif isinstance(mc, integrate.convex_spheropolygon):
-            cls =_hpmc.AnalyzerSDFSpheropolygon;
+            suffix = 'Spheropolygon';
         else:
             hoomd.context.msg.error("analyze.sdf: Unsupported integrator.\n");
-            raise runtime_error("Error initializing analyze.sdf");
-
-        self.cpp_analyzer = cls(hoomd.context.current.system_definition,
-                                mc.cpp_integrator,
-                                xmax,
-                                dx,
-                                navg,
-                                filename,
-                                overwrite);
+            raise RuntimeError("Error initializing analyze.sdf");
+
+        if not hoomd.context.exec_conf.isCUDAEnabled():
+            cls = getattr(_hpmc, 'AnalyzerSDF' + suffix);
+            self.cpp_analyzer = cls(hoomd.context.current.system_definition,
+                                    mc.cpp_integrator,
+                                    xmax,
+                                    dx,
+                                    navg,
+                                    filename,
+                                    overwrite);
+        else:
+            # the cell list is only read on the device, every analyzer gets its own
+            cl = _hoomd.CellListGPU(hoomd.context.current.system_definition);
+            hoomd.context.current.system.addCompute(cl, "auto_cl_sdf_" + self.analyzer_name)
+
+            cls = getattr(_hpmc, 'AnalyzerSDFGPU' + suffix);
+            self.cpp_analyzer = cls(hoomd.context.current.system_definition,
+                                    mc.cpp_integrator,
+                                    cl,
+                                    xmax,
+                                    dx,
+                                    navg,
+                                    filename,
+                                    overwrite);
 
         self.setupAnalyzer(period, phase);
 
@@ -7,7 +7,7 @@
 from __future__ import print_function
 
 from hoomd import _hoomd
-from hoomd.hpmc import _hpmc
+from hoomd.hpmc._extension import _hpmc
 from hoomd.hpmc import integrate
 from hoomd.compute import _compute
 import hoomd
@@ -21,12 +21,18 @@ class free_volume(_compute):
         type (str): Type of particle to use for integration
         nsample (int): Number of samples to use in MC integration
         suffix (str): Suffix to use for log quantity
+        stratified (bool): Spread the samples evenly over a grid of sub-boxes
 
     :py:class`free_volume` computes the free volume of a particle assembly using stochastic integration with a test particle type.
     It works together with an HPMC integrator, which defines the particle types used in the simulation.
     As parameters it requires the number of MC integration samples (*nsample*), and the type of particle (*test_type*)
     to use for the integration.
 
+    With *stratified* set, the box is divided into as many sub-boxes as there are samples (rounded down to a square
+    or cube number), and every sub-box receives the same number of samples. This reduces the variance of the free
+    volume estimate for the same *nsample*. Stratified sampling is performed on the CPU only, the GPU ignores
+    *stratified*.
+
     Once initialized, the compute provides a log quantity
     called **hpmc_free_volume**, that can be logged via :py:class:`hoomd.analyze.log`.
     If a suffix is specified, the log quantities name will be
@@ -39,7 +45,7 @@ class free_volume(_compute):
         log = analyze.log(quantities=['hpmc_free_volume'], period=100, filename='log.dat', overwrite=True)
 
     """
-    def __init__(self, mc, seed, suffix='', test_type=None, nsample=None):
+    def __init__(self, mc, seed, suffix='', test_type=None, nsample=None, stratified=False):
         hoomd.util.print_status_line();
 
         # initialize base class
@@ -121,6 +127,7 @@ class free_volume(_compute):
             self.cpp_compute.setTestParticleType(itype)
         if nsample is not None:
             self.cpp_compute.setNumSamples(int(nsample))
+        self.cpp_compute.setStratified(bool(stratified))
 
         hoomd.context.current.system.addCompute(self.cpp_compute, self.compute_name)
         self.enabled = True
@@ -6,7 +6,7 @@
 
 import hoomd
 import hoomd.hpmc
-from hoomd.hpmc import _hpmc
+from hoomd.hpmc._extension import _hpmc
 import numpy
 
 class param_dict(dict):
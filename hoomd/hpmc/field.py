@@ -5,7 +5,7 @@
 """
 
 from hoomd import _hoomd
-from hoomd.hpmc import _hpmc
+from hoomd.hpmc._extension import _hpmc
 from hoomd.hpmc import integrate
 from hoomd.compute import _compute
 import hoomd
@@ -78,36 +78,32 @@ class lattice_field(_external):
         hoomd.util.print_status_line();
         _external.__init__(self);
         cls = None;
-        if not hoomd.context.exec_conf.isCUDAEnabled():
-            if isinstance(mc, integrate.sphere):
-                cls = _hpmc.ExternalFieldLatticeSphere;
-            elif isinstance(mc, integrate.convex_polygon):
-                cls = _hpmc.ExternalFieldLatticeConvexPolygon;
-            elif isinstance(mc, integrate.simple_polygon):
-                cls = _hpmc.ExternalFieldLatticeSimplePolygon;
-            elif isinstance(mc, integrate.convex_polyhedron):
-                cls = _hpmc.ExternalFieldLatticeConvexPolyhedron;
-            elif isinstance(mc, integrate.convex_spheropolyhedron):
-                cls = _hpmc.ExternalFieldLatticeSpheropolyhedron;
-            elif isinstance(mc, integrate.ellipsoid):
-                cls = _hpmc.ExternalFieldLatticeEllipsoid;
-            elif isinstance(mc, integrate.convex_spheropolygon):
-                cls =_hpmc.ExternalFieldLatticeSpheropolygon;
-            elif isinstance(mc, integrate.faceted_sphere):
-                cls =_hpmc.ExternalFieldLatticeFacetedSphere;
-            elif isinstance(mc, integrate.polyhedron):
-                cls =_hpmc.ExternalFieldLatticePolyhedron;
-            elif isinstance(mc, integrate.sphinx):
-                cls =_hpmc.ExternalFieldLatticeSphinx;
-            elif isinstance(mc, integrate.sphere_union):
-                cls = _hpmc.ExternalFieldLatticeSphereUnion;
-            elif isinstance(mc, integrate.convex_polyhedron_union):
-                cls = _hpmc.ExternalFieldLatticeConvexPolyhedronUnion;
-            else:
-                hoomd.context.msg.error("compute.position_lattice_field: Unsupported integrator.\n");
-                raise RuntimeError("Error initializing compute.position_lattice_field");
+        if isinstance(mc, integrate.sphere):
+            cls = _hpmc.ExternalFieldLatticeSphere;
+        elif isinstance(mc, integrate.convex_polygon):
+            cls = _hpmc.ExternalFieldLatticeConvexPolygon;
+        elif isinstance(mc, integrate.simple_polygon):
+            cls = _hpmc.ExternalFieldLatticeSimplePolygon;
+        elif isinstance(mc, integrate.convex_polyhedron):
+            cls = _hpmc.ExternalFieldLatticeConvexPolyhedron;
+        elif isinstance(mc, integrate.convex_spheropolyhedron):
+            cls = _hpmc.ExternalFieldLatticeSpheropolyhedron;
+        elif isinstance(mc, integrate.ellipsoid):
+            cls = _hpmc.ExternalFieldLatticeEllipsoid;
+        elif isinstance(mc, integrate.convex_spheropolygon):
+            cls =_hpmc.ExternalFieldLatticeSpheropolygon;
+        elif isinstance(mc, integrate.faceted_sphere):
+            cls =_hpmc.ExternalFieldLatticeFacetedSphere;
+        elif isinstance(mc, integrate.polyhedron):
+            cls =_hpmc.ExternalFieldLatticePolyhedron;
+        elif isinstance(mc, integrate.sphinx):
+            cls =_hpmc.ExternalFieldLatticeSphinx;
+        elif isinstance(mc, integrate.sphere_union):
+            cls = _hpmc.ExternalFieldLatticeSphereUnion;
+        elif isinstance(mc, integrate.convex_polyhedron_union):
+            cls = _hpmc.ExternalFieldLatticeConvexPolyhedronUnion;
         else:
-            hoomd.context.msg.error("GPU not supported yet")
+            hoomd.context.msg.error("compute.position_lattice_field: Unsupported integrator.\n");
             raise RuntimeError("Error initializing compute.position_lattice_field");
 
         self.compute_name = "lattice_field"
@@ -245,36 +241,35 @@ class external_field_composite(_external):
     def __init__(self, mc, fields = None):
         _external.__init__(self);
         cls = None;
-        if not hoomd.context.exec_conf.isCUDAEnabled():
-            if isinstance(mc, integrate.sphere):
-                cls = _hpmc.ExternalFieldCompositeSphere;
-            elif isinstance(mc, integrate.convex_polygon):
-                cls = _hpmc.ExternalFieldCompositeConvexPolygon;
-            elif isinstance(mc, integrate.simple_polygon):
-                cls = _hpmc.ExternalFieldCompositeSimplePolygon;
-            elif isinstance(mc, integrate.convex_polyhedron):
-                cls = _hpmc.ExternalFieldCompositeConvexPolyhedron;
-            elif isinstance(mc, integrate.convex_spheropolyhedron):
-                cls = _hpmc.ExternalFieldCompositeSpheropolyhedron;
-            elif isinstance(mc, integrate.ellipsoid):
-                cls = _hpmc.ExternalFieldCompositeEllipsoid;
-            elif isinstance(mc, integrate.convex_spheropolygon):
-                cls =_hpmc.ExternalFieldCompositeSpheropolygon;
-            elif isinstance(mc, integrate.faceted_sphere):
-                cls =_hpmc.ExternalFieldCompositeFacetedSphere;
-            elif isinstance(mc, integrate.polyhedron):
-                cls =_hpmc.ExternalFieldCompositePolyhedron;
-            elif isinstance(mc, integrate.sphinx):
-                cls =_hpmc.ExternalFieldCompositeSphinx;
-            elif isinstance(mc, integrate.sphere_union):
-                cls = _hpmc.ExternalFieldCompositeSphereUnion;
-            elif isinstance(mc, integrate.convex_polyhedron_union):
-                cls = _hpmc.ExternalFieldCompositeConvexPolyhedronUnion;
-            else:
-                hoomd.context.msg.error("compute.position_lattice_field: Unsupported integrator.\n");
-                raise RuntimeError("Error initializing compute.position_lattice_field");
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.msg.error("field.external_field_composite: GPU not supported\n")
+            raise RuntimeError("Error initializing compute.position_lattice_field");
+        if isinstance(mc, integrate.sphere):
+            cls = _hpmc.ExternalFieldCompositeSphere;
+        elif isinstance(mc, integrate.convex_polygon):
+            cls = _hpmc.ExternalFieldCompositeConvexPolygon;
+        elif isinstance(mc, integrate.simple_polygon):
+            cls = _hpmc.ExternalFieldCompositeSimplePolygon;
+        elif isinstance(mc, integrate.convex_polyhedron):
+            cls = _hpmc.ExternalFieldCompositeConvexPolyhedron;
+        elif isinstance(mc, integrate.convex_spheropolyhedron):
+            cls = _hpmc.ExternalFieldCompositeSpheropolyhedron;
+        elif isinstance(mc, integrate.ellipsoid):
+            cls = _hpmc.ExternalFieldCompositeEllipsoid;
+        elif isinstance(mc, integrate.convex_spheropolygon):
+            cls =_hpmc.ExternalFieldCompositeSpheropolygon;
+        elif isinstance(mc, integrate.faceted_sphere):
+            cls =_hpmc.ExternalFieldCompositeFacetedSphere;
+        elif isinstance(mc, integrate.polyhedron):
+            cls =_hpmc.ExternalFieldCompositePolyhedron;
+        elif isinstance(mc, integrate.sphinx):
+            cls =_hpmc.ExternalFieldCompositeSphinx;
+        elif isinstance(mc, integrate.sphere_union):
+            cls = _hpmc.ExternalFieldCompositeSphereUnion;
+        elif isinstance(mc, integrate.convex_polyhedron_union):
+            cls = _hpmc.ExternalFieldCompositeConvexPolyhedronUnion;
         else:
-            hoomd.context.msg.error("GPU not supported yet")
+            hoomd.context.msg.error("compute.position_lattice_field: Unsupported integrator.\n");
             raise RuntimeError("Error initializing compute.position_lattice_field");
 
         self.compute_name = "composite_field"
@@ -355,18 +350,17 @@ class wall(_external):
         cls = None;
         self.compute_name = "wall-"+str(wall.index)
         wall.index+=1
-        if not hoomd.context.exec_conf.isCUDAEnabled():
-            if isinstance(mc, integrate.sphere):
-                cls = _hpmc.WallSphere;
-            elif isinstance(mc, integrate.convex_polyhedron):
-                cls = _hpmc.WallConvexPolyhedron;
-            elif isinstance(mc, integrate.convex_spheropolyhedron):
-                cls = _hpmc.WallSpheropolyhedron;
-            else:
-                hoomd.context.msg.error("compute.wall: Unsupported integrator.\n");
-                raise RuntimeError("Error initializing compute.wall");
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.msg.error("compute.wall: GPU not supported\n")
+            raise RuntimeError("Error initializing compute.wall");
+        if isinstance(mc, integrate.sphere):
+            cls = _hpmc.WallSphere;
+        elif isinstance(mc, integrate.convex_polyhedron):
+            cls = _hpmc.WallConvexPolyhedron;
+        elif isinstance(mc, integrate.convex_spheropolyhedron):
+            cls = _hpmc.WallSpheropolyhedron;
         else:
-            hoomd.context.msg.error("GPU not supported yet")
+            hoomd.context.msg.error("compute.wall: Unsupported integrator.\n");
             raise RuntimeError("Error initializing compute.wall");
 
         self.cpp_compute = cls(hoomd.context.current.system_definition, mc.cpp_integrator);
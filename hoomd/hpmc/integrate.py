@@ -2,7 +2,7 @@
 # This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
 
 from hoomd import _hoomd
-from hoomd.hpmc import _hpmc
+from hoomd.hpmc._extension import _hpmc
 from hoomd.hpmc import data
 from hoomd.integrate import _integrator
 import hoomd
@@ -412,7 +412,13 @@ class mode_hpmc(_integrator):
                    nR=None,
                    depletant_type=None,
                    ntrial=None,
-                   deterministic=None):
+                   deterministic=None,
+                   checkerboard=None,
+                   aabb_refit_threshold=None,
+                   cuda_graph=None,
+                   ghost_aabb=None,
+                   axis_cache=None,
+                   candidate_skin=None):
         R""" Changes parameters of an existing integration mode.
 
         Args:
@@ -425,6 +431,30 @@ class mode_hpmc(_integrator):
             ntrial (int): (if set) **Implicit depletants only**: Number of re-insertion attempts per overlapping depletant.
                 (Only supported with **depletant_mode='circumsphere'**)
             deterministic (bool): (if set) Make HPMC integration deterministic on the GPU by sorting the cell list.
+            checkerboard (bool): (if set) **CPU only**: Sweep the independent cells of a checkerboard in parallel TBB
+                threads. Trial moves that leave their cell are skipped. Falls back to serial sweeps when the box is
+                too small or an external field is set.
+            aabb_refit_threshold (float): (if set) After particles move, refit the AABB tree in place and rebuild it only
+                when its summed node surface area exceeds this multiple of the area at the last build (default 1.5).
+                Values of 1 and below rebuild the tree every time.
+            cuda_graph (bool): (if set) **GPU only**: Capture the kernel launches of the trial move sweep in a CUDA graph
+                and replay it on the following steps, capturing it again when the particle number, box, shape parameters
+                or launch parameters change. Reduces the launch overhead for small systems. Requires CUDA 10.1.
+            ghost_aabb (bool): (if set) **CPU only, MPI only**: Size the ghost layer and the frozen boundary layer of each
+                domain by the extents of the particle AABBs along the domain boundary normals instead of the largest
+                circumsphere diameter. Types that rotate (non-zero *a* and *move_ratio* below 1) still use their
+                circumsphere. Reduces the number of ghost particles for elongated shapes with fixed orientations or
+                mixtures of large and small particles. Not supported with implicit depletants.
+            axis_cache (int): (if set) **CPU only**: Maximum number of particle pairs whose separating axis is cached
+                between the serial sweeps (0 disables the cache, the default). An overlap test starts from the axis
+                that separated the pair in its last test, which decides most disjoint pairs of a dense system with a
+                single support function evaluation. The cache is cleared when it is full. Supported by
+                :py:class:`convex_polyhedron` and :py:class:`convex_spheropolyhedron`, not used in checkerboard sweeps.
+            candidate_skin (float): (if set) **CPU only**: Keep a list of overlap candidates for each particle, the
+                particles whose circumspheres are closer than this skin, and scan it in the trial moves instead of
+                searching the AABB tree (0 disables the lists, the default). The lists are rebuilt when the particles
+                have moved too far. The skin must be at least twice the largest move size *d*. Not used with MPI
+                domain decomposition, patch energies or boxes smaller than about twice the list range.
 
         .. note:: Simulations are only deterministic with respect to the same execution configuration (CPU or GPU) and
                   number of MPI ranks. Simulation output will not be identical if either of these is changed.
@@ -479,6 +509,62 @@ class mode_hpmc(_integrator):
         if deterministic is not None:
             self.cpp_integrator.setDeterministic(deterministic);
 
+        if checkerboard is not None:
+            self.cpp_integrator.setCheckerboard(checkerboard);
+
+        if aabb_refit_threshold is not None:
+            self.cpp_integrator.setAABBRefitThreshold(aabb_refit_threshold);
+
+        if cuda_graph is not None:
+            self.cpp_integrator.setCUDAGraph(cuda_graph);
+
+        if ghost_aabb is not None:
+            self.cpp_integrator.setGhostAABB(ghost_aabb);
+
+        if axis_cache is not None:
+            self.cpp_integrator.setAxisCacheSize(axis_cache);
+
+        if candidate_skin is not None:
+            self.cpp_integrator.setCandidateSkin(candidate_skin);
+
+    def adapt_move_sizes(self, enable=True, target=0.2, period=10, gamma=2.0, max_scale=2.0, max_d=1.0, max_a=0.5):
+        R""" Adapt the maximum move sizes during the run.
+
+        Args:
+            enable (bool): Set to False to stop adapting the move sizes.
+            target (float): Target acceptance ratio of the translation and rotation moves.
+            period (int): Number of time steps between updates of the move sizes.
+            gamma (float): Damping of the updates, larger values converge faster.
+            max_scale (float): Maximum factor by which a move size grows in one update.
+            max_d (float): Upper bound of the maximum move displacement.
+            max_a (float): Upper bound of the maximum rotation move.
+
+        The integrator counts accepted and rejected moves by particle type and every *period* steps scales each
+        type's *d* and *a* with the same rule as :py:class:`hpmc.util.tune`, so that a single ``run()`` equilibrates
+        and tunes the move sizes. Move sizes that are set to 0 stay 0.
+
+        Move sizes keep changing as long as the adaptation is enabled, which breaks detailed balance. Disable it
+        before sampling production data.
+
+        Note:
+            Not supported with implicit depletants on the GPU.
+
+        Example::
+
+            mc = hpmc.integrate.sphere(seed=415236);
+            mc.adapt_move_sizes(target=0.3, period=5);
+            run(10000);
+            mc.adapt_move_sizes(enable=False);
+            run(100000);
+        """
+        hoomd.util.print_status_line();
+
+        if enable and self.implicit and hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.msg.warning("Move size adaptation is not supported with implicit depletants on the GPU. Ignoring.\n");
+            return;
+
+        self.cpp_integrator.setMoveSizeTuning(enable, target, gamma, max_scale, max_d, max_a, int(period));
+
     def map_overlaps(self):
         R""" Build an overlap map of the system
 
@@ -750,6 +836,24 @@ def setA(cpp_integrator,a):
         for i in range(hoomd.context.current.system_definition.getParticleData().getNTypes()):
             cpp_integrator.setA(a,i);
 
+## Helper methods for the event chain integrators
+def setEventChain(cpp_integrator, chain_length, variant):
+    if chain_length is not None:
+        cpp_integrator.setChainLength(float(chain_length))
+    if variant is not None:
+        if variant not in ('straight', 'newtonian'):
+            hoomd.context.msg.error("hpmc: variant must be 'straight' or 'newtonian'\n");
+            raise ValueError("Unknown event chain variant " + str(variant));
+        cpp_integrator.setNewtonian(variant == 'newtonian')
+
+def check_event_chain_config():
+    if hoomd.context.exec_conf.isCUDAEnabled():
+        hoomd.context.msg.error("hpmc: event chain integrators are not available on the GPU\n");
+        raise RuntimeError("Error initializing HPMC integrator");
+    if hoomd.comm.get_num_ranks() > 1:
+        hoomd.context.msg.error("hpmc: event chain integrators do not support MPI domain decomposition\n");
+        raise RuntimeError("Error initializing HPMC integrator");
+
 # Helper method to parse depletant mode
 def depletant_mode_circumsphere(depletant_mode):
     if depletant_mode == 'circumsphere':
@@ -887,6 +991,83 @@ class sphere(mode_hpmc):
         return result
 
 
+class sphere_ec(sphere):
+    R""" HPMC integration for spheres (2D/3D) with event chains.
+
+    Args:
+        seed (int): Random number seed
+        chain_length (float): Total displacement of each event chain (distance units)
+        variant (str): ``'straight'`` or ``'newtonian'`` chains
+        a (float, only with **orientable=True**): Maximum rotation move, Scalar to set for all types, or a dict containing {type:size} to set by type.
+        move_ratio (float, only used with **orientable=True**): Ratio of event chains to rotation moves.
+        nselect (int): The number of event chains or rotation moves started from each particle in one time step.
+        restore_state(bool): Restore internal state from initialization file when True. See :py:class:`mode_hpmc`
+                             for a description of what state data restored.
+
+    Event-chain Monte Carlo translates the particles in chains of collisions instead of local trial moves: the first
+    particle moves along the chain direction until it touches another sphere, which then moves on in the same
+    direction for the rest of the chain, and so on until the displacements of the chain add up to *chain_length*.
+    No move is rejected, so the chains decorrelate dense fluids much faster than local moves near freezing.
+
+    In *straight* chains, every chain has a random isotropic direction. In *newtonian* chains, each particle moves
+    along its velocity and the velocities of the colliding particles are exchanged along the contact normal; particles
+    without a velocity get a random unit velocity. Collisions are computed analytically.
+
+    Rotations of orientable spheres remain local trial moves. Each displacement of a chain counts as an accepted
+    translation in :py:meth:`mode_hpmc.get_counters()`. Event chains run on the CPU on a single rank and do not support
+    patch energies, external fields or implicit depletants.
+
+    The log quantity ``hpmc_ec_chain_events`` gives the average number of collisions per chain in the last time step.
+
+    .. versionadded:: 2.5
+
+    Example::
+
+        mc = hpmc.integrate.sphere_ec(seed=415236, chain_length=2.0)
+        mc.shape_param.set('A', diameter=1.0)
+    """
+
+    def __init__(self, seed, chain_length=1.0, variant='straight', a=0.1, move_ratio=0.5, nselect=1, restore_state=False):
+        hoomd.util.print_status_line();
+        check_event_chain_config();
+
+        # initialize base class
+        mode_hpmc.__init__(self, False);
+
+        self.cpp_integrator = _hpmc.IntegratorHPMCMonoECSphere(hoomd.context.current.system_definition, seed);
+        setEventChain(self.cpp_integrator, chain_length, variant);
+        setA(self.cpp_integrator,a);
+        self.cpp_integrator.setMoveRatio(move_ratio)
+        self.cpp_integrator.setNSelect(nselect);
+
+        hoomd.context.current.system.setIntegrator(self.cpp_integrator);
+        self.initialize_shape_params();
+
+        if restore_state:
+            self.restore_state()
+
+    def set_chain_params(self, chain_length=None, variant=None):
+        R""" Change the event chain parameters.
+
+        Args:
+            chain_length (float): (if set) Total displacement of each event chain (distance units)
+            variant (str): (if set) ``'straight'`` or ``'newtonian'`` chains
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+        setEventChain(self.cpp_integrator, chain_length, variant);
+
+    def get_chain_events(self):
+        R""" Get the average number of collisions per event chain.
+
+        Returns:
+            The average number of collisions per chain in the last time step.
+
+        .. versionadded:: 2.5
+        """
+        return self.cpp_integrator.getChainEvents();
+
 class convex_polygon(mode_hpmc):
     R""" HPMC integration for convex polygons (2D).
 
@@ -1264,6 +1445,10 @@ class polyhedron(mode_hpmc):
 
         * .. versionadded:: 2.2
 
+    The OBB tree of every type is built when its shape parameters are set. The state written by
+    :py:meth:`hoomd.dump.gsd.dump_state` includes the trees, so ``restore_state=True`` restores the shapes without
+    building the trees again (added in version 2.5).
+
     Warning:
         HPMC does not check that all requirements are met. Undefined behavior will result if they are
         violated.
@@ -1485,6 +1670,84 @@ class convex_polyhedron(mode_hpmc):
 
         return result
 
+class convex_polyhedron_ec(convex_polyhedron):
+    R""" HPMC integration for convex polyhedra (3D) with event chains.
+
+    Args:
+        seed (int): Random number seed
+        chain_length (float): Total displacement of each event chain (distance units)
+        variant (str): ``'straight'`` or ``'newtonian'`` chains
+        a (float): Maximum rotation move, Scalar to set for all types, or a dict containing {type:size} to set by type.
+        move_ratio (float): Ratio of event chains to rotation moves.
+        nselect (int): The number of event chains or rotation moves started from each particle in one time step.
+        sweep_resolution (float): Step of the collision search, relative to the smaller circumsphere diameter of the
+            pair.
+        restore_state(bool): Restore internal state from initialization file when True. See :py:class:`mode_hpmc`
+                             for a description of what state data restored.
+
+    Translates the polyhedra in event chains, see :py:class:`sphere_ec` for the chain variants and restrictions.
+    Rotations are local trial moves with the maximum rotation *a*, selected with *move_ratio*.
+
+    The collision of two polyhedra along the chain is bracketed by their circumspheres and searched with the overlap
+    test in steps of *sweep_resolution* times the smaller circumsphere diameter of the pair, then refined by
+    bisection. The particles always stop at positions that the overlap test finds free of overlaps, but a grazing
+    collision shorter than one step may be passed over. Smaller values are more accurate and slower.
+
+    .. versionadded:: 2.5
+
+    Example::
+
+        mc = hpmc.integrate.convex_polyhedron_ec(seed=415236, chain_length=1.0, a=0.1)
+        mc.shape_param.set('A', vertices=[(-0.5, -0.5, -0.5), (-0.5, -0.5, 0.5), (-0.5, 0.5, -0.5), (-0.5, 0.5, 0.5),
+                                          (0.5, -0.5, -0.5), (0.5, -0.5, 0.5), (0.5, 0.5, -0.5), (0.5, 0.5, 0.5)]);
+    """
+
+    def __init__(self, seed, chain_length=1.0, variant='straight', a=0.1, move_ratio=0.5, nselect=1, sweep_resolution=0.01, restore_state=False):
+        hoomd.util.print_status_line();
+        check_event_chain_config();
+
+        # initialize base class
+        mode_hpmc.__init__(self, False);
+
+        self.cpp_integrator = _hpmc.IntegratorHPMCMonoECConvexPolyhedron(hoomd.context.current.system_definition, seed);
+        setEventChain(self.cpp_integrator, chain_length, variant);
+        self.cpp_integrator.setSweepResolution(float(sweep_resolution));
+        setA(self.cpp_integrator,a);
+        self.cpp_integrator.setMoveRatio(move_ratio)
+        self.cpp_integrator.setNSelect(nselect);
+
+        hoomd.context.current.system.setIntegrator(self.cpp_integrator);
+        self.initialize_shape_params();
+
+        if restore_state:
+            self.restore_state()
+
+    def set_chain_params(self, chain_length=None, variant=None, sweep_resolution=None):
+        R""" Change the event chain parameters.
+
+        Args:
+            chain_length (float): (if set) Total displacement of each event chain (distance units)
+            variant (str): (if set) ``'straight'`` or ``'newtonian'`` chains
+            sweep_resolution (float): (if set) Step of the collision search, relative to the smaller circumsphere
+                diameter of the pair.
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+        setEventChain(self.cpp_integrator, chain_length, variant);
+        if sweep_resolution is not None:
+            self.cpp_integrator.setSweepResolution(float(sweep_resolution));
+
+    def get_chain_events(self):
+        R""" Get the average number of collisions per event chain.
+
+        Returns:
+            The average number of collisions per chain in the last time step.
+
+        .. versionadded:: 2.5
+        """
+        return self.cpp_integrator.getChainEvents();
+
 class faceted_sphere(mode_hpmc):
     R""" HPMC integration for faceted spheres (3D).
 
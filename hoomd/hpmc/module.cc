@@ -65,18 +65,7 @@ PYBIND11_MODULE(_hpmc, m)
     export_external_fields(m);
     export_shape_params(m);
 
-    export_sphere(m);
-    export_convex_polygon(m);
-    export_simple_polygon(m);
-    export_spheropolygon(m);
-    export_polyhedron(m);
-    export_ellipsoid(m);
-    export_faceted_sphere(m);
-    export_sphinx(m);
-    export_union_convex_polyhedron(m);
-    export_union_sphere(m);
-    export_convex_polyhedron(m);
-    export_convex_spheropolyhedron(m);
+    // the classes templated on the shape are exported by the _hpmc_<shape> modules in module_<shape>.cc
 
     py::class_<sph_params, std::shared_ptr<sph_params> >(m, "sph_params");
     py::class_<ell_params, std::shared_ptr<ell_params> >(m, "ell_params");
@@ -26,9 +26,11 @@
 
 #ifdef ENABLE_CUDA
 #include "IntegratorHPMCMonoGPU.h"
+#include "UpdaterClustersGPU.h"
 #include "IntegratorHPMCMonoImplicitGPU.h"
 #include "IntegratorHPMCMonoImplicitNewGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
 #endif
 
 
@@ -64,10 +66,21 @@ void export_convex_polygon(py::module& m)
 
     #ifdef ENABLE_CUDA
     export_IntegratorHPMCMonoGPU< ShapeConvexPolygon >(m, "IntegratorHPMCMonoGPUConvexPolygon");
+    export_UpdaterClustersGPU< ShapeConvexPolygon >(m, "UpdaterClustersGPUConvexPolygon");
     export_IntegratorHPMCMonoImplicitGPU< ShapeConvexPolygon >(m, "IntegratorHPMCMonoImplicitGPUConvexPolygon");
     export_IntegratorHPMCMonoImplicitNewGPU< ShapeConvexPolygon >(m, "IntegratorHPMCMonoImplicitNewGPUConvexPolygon");
     export_ComputeFreeVolumeGPU< ShapeConvexPolygon >(m, "ComputeFreeVolumeGPUConvexPolygon");
+    export_AnalyzerSDFGPU< ShapeConvexPolygon >(m, "AnalyzerSDFGPUConvexPolygon");
     #endif
     }
 
 }
+
+//! Define the _hpmc_convex_polygon python module exports
+PYBIND11_MODULE(_hpmc_convex_polygon, m)
+    {
+    // the shape independent base classes are exported by _hpmc
+    py::module::import("hoomd.hpmc._hpmc");
+
+    export_convex_polygon(m);
+    }
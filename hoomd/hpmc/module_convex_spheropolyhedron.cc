@@ -26,9 +26,11 @@
 
 #ifdef ENABLE_CUDA
 #include "IntegratorHPMCMonoGPU.h"
+#include "UpdaterClustersGPU.h"
 #include "IntegratorHPMCMonoImplicitGPU.h"
 #include "IntegratorHPMCMonoImplicitNewGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
 #endif
 
 
@@ -65,11 +67,22 @@ void export_convex_spheropolyhedron(py::module& m)
     #ifdef ENABLE_CUDA
 
     export_IntegratorHPMCMonoGPU< ShapeSpheropolyhedron >(m, "IntegratorHPMCMonoGPUSpheropolyhedron");
+    export_UpdaterClustersGPU< ShapeSpheropolyhedron >(m, "UpdaterClustersGPUSpheropolyhedron");
     export_IntegratorHPMCMonoImplicitGPU< ShapeSpheropolyhedron >(m, "IntegratorHPMCMonoImplicitGPUSpheropolyhedron");
     export_IntegratorHPMCMonoImplicitNewGPU< ShapeSpheropolyhedron >(m, "IntegratorHPMCMonoImplicitNewGPUSpheropolyhedron");
     export_ComputeFreeVolumeGPU< ShapeSpheropolyhedron >(m, "ComputeFreeVolumeGPUSpheropolyhedron");
+    export_AnalyzerSDFGPU< ShapeSpheropolyhedron >(m, "AnalyzerSDFGPUSpheropolyhedron");
 
     #endif
     }
 
 }
+
+//! Define the _hpmc_convex_spheropolyhedron python module exports
+PYBIND11_MODULE(_hpmc_convex_spheropolyhedron, m)
+    {
+    // the shape independent base classes are exported by _hpmc
+    py::module::import("hoomd.hpmc._hpmc");
+
+    export_convex_spheropolyhedron(m);
+    }
@@ -26,9 +26,11 @@
 
 #ifdef ENABLE_CUDA
 #include "IntegratorHPMCMonoGPU.h"
+#include "UpdaterClustersGPU.h"
 #include "IntegratorHPMCMonoImplicitGPU.h"
 #include "IntegratorHPMCMonoImplicitNewGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
 #endif
 
 namespace py = pybind11;
@@ -61,10 +63,21 @@ void export_ellipsoid(py::module& m)
 
     #ifdef ENABLE_CUDA
     export_IntegratorHPMCMonoGPU< ShapeEllipsoid >(m, "IntegratorHPMCMonoGPUEllipsoid");
+    export_UpdaterClustersGPU< ShapeEllipsoid >(m, "UpdaterClustersGPUEllipsoid");
     export_IntegratorHPMCMonoImplicitGPU< ShapeEllipsoid >(m, "IntegratorHPMCMonoImplicitGPUEllipsoid");
     export_IntegratorHPMCMonoImplicitNewGPU< ShapeEllipsoid >(m, "IntegratorHPMCMonoImplicitNewGPUEllipsoid");
     export_ComputeFreeVolumeGPU< ShapeEllipsoid >(m, "ComputeFreeVolumeGPUEllipsoid");
+    export_AnalyzerSDFGPU< ShapeEllipsoid >(m, "AnalyzerSDFGPUEllipsoid");
     #endif
     }
 
 }
+
+//! Define the _hpmc_ellipsoid python module exports
+PYBIND11_MODULE(_hpmc_ellipsoid, m)
+    {
+    // the shape independent base classes are exported by _hpmc
+    py::module::import("hoomd.hpmc._hpmc");
+
+    export_ellipsoid(m);
+    }
@@ -26,6 +26,7 @@
 
 #ifdef ENABLE_CUDA
 #include "IntegratorHPMCMonoGPU.h"
+#include "UpdaterClustersGPU.h"
 #include "IntegratorHPMCMonoImplicitGPU.h"
 #include "IntegratorHPMCMonoImplicitNewGPU.h"
 #include "ComputeFreeVolumeGPU.h"
@@ -64,6 +65,7 @@ void export_faceted_sphere(py::module& m)
 
     #ifdef ENABLE_CUDA
     export_IntegratorHPMCMonoGPU< ShapeFacetedSphere >(m, "IntegratorHPMCMonoGPUFacetedSphere");
+    export_UpdaterClustersGPU< ShapeFacetedSphere >(m, "UpdaterClustersGPUFacetedSphere");
     export_IntegratorHPMCMonoImplicitGPU< ShapeFacetedSphere >(m, "IntegratorHPMCMonoImplicitGPUFacetedSphere");
     export_IntegratorHPMCMonoImplicitNewGPU< ShapeFacetedSphere >(m, "IntegratorHPMCMonoImplicitNewGPUFacetedSphere");
     export_ComputeFreeVolumeGPU< ShapeFacetedSphere >(m, "ComputeFreeVolumeGPUFacetedSphere");
@@ -71,3 +73,12 @@ void export_faceted_sphere(py::module& m)
     }
 
 }
+
+//! Define the _hpmc_faceted_sphere python module exports
+PYBIND11_MODULE(_hpmc_faceted_sphere, m)
+    {
+    // the shape independent base classes are exported by _hpmc
+    py::module::import("hoomd.hpmc._hpmc");
+
+    export_faceted_sphere(m);
+    }
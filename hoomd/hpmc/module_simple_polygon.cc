@@ -26,9 +26,11 @@
 
 #ifdef ENABLE_CUDA
 #include "IntegratorHPMCMonoGPU.h"
+#include "UpdaterClustersGPU.h"
 #include "IntegratorHPMCMonoImplicitGPU.h"
 #include "IntegratorHPMCMonoImplicitNewGPU.h"
 #include "ComputeFreeVolumeGPU.h"
+#include "AnalyzerSDFGPU.h"
 #endif
 
 
@@ -64,10 +66,21 @@ void export_simple_polygon(py::module& m)
 
     #ifdef ENABLE_CUDA
     export_IntegratorHPMCMonoGPU< ShapeSimplePolygon >(m, "IntegratorHPMCMonoGPUSimplePolygon");
+    export_UpdaterClustersGPU< ShapeSimplePolygon >(m, "UpdaterClustersGPUSimplePolygon");
     export_IntegratorHPMCMonoImplicitGPU< ShapeSimplePolygon >(m, "IntegratorHPMCMonoImplicitGPUSimplePolygon");
     export_IntegratorHPMCMonoImplicitNewGPU< ShapeSimplePolygon >(m, "IntegratorHPMCMonoImplicitNewGPUSimplePolygon");
     export_ComputeFreeVolumeGPU< ShapeSimplePolygon >(m, "ComputeFreeVolumeGPUSimplePolygon");
+    export_AnalyzerSDFGPU< ShapeSimplePolygon >(m, "AnalyzerSDFGPUSimplePolygon");
     #endif
     }
 
 }
+
+//! Define the _hpmc_simple_polygon python module exports
+PYBIND11_MODULE(_hpmc_simple_polygon, m)
+    {
+    // the shape independent base classes are exported by _hpmc
+    py::module::import("hoomd.hpmc._hpmc");
+
+    export_simple_polygon(m);
+    }
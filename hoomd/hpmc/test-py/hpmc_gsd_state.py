@@ -60,6 +60,8 @@ class hpmc_gsd_state(unittest.TestCase):
             filename = "{}.gsd".format(name)
             if hoomd.comm.get_rank() == 0 and os.path.exists(filename):
                 os.remove(filename);
+        if hoomd.comm.get_rank() == 0 and os.path.exists("polyhedron.gsd"):
+            os.remove("polyhedron.gsd");
 
     def run_test_1(self, name, dim):
         filename = "{}.gsd".format(name)
@@ -99,6 +101,68 @@ class hpmc_gsd_state(unittest.TestCase):
         self.gsd = None;
         # os.remove(filename);
 
+    # a unit cube with every side split into n x n squares of two triangles, enough faces for a multi level tree
+    def make_tessellated_cube(self, n):
+        verts = [];
+        faces = [];
+        for side in range(6):
+            k = side % 3;
+            u = (k+1) % 3;
+            v = (k+2) % 3;
+            sign = 1 if side < 3 else -1;
+            offs = len(verts);
+            for i in range(n+1):
+                for j in range(n+1):
+                    p = [0,0,0];
+                    p[k] = 0.5*sign;
+                    p[u] = -0.5 + i/n;
+                    p[v] = -0.5 + j/n;
+                    verts.append(tuple(p));
+            for i in range(n):
+                for j in range(n):
+                    a = offs + i*(n+1) + j;
+                    b = a + n + 1;
+                    c = b + 1;
+                    d = a + 1;
+                    if sign > 0:
+                        faces += [(a, b, c), (a, c, d)];
+                    else:
+                        faces += [(a, c, b), (a, d, c)];
+        return verts, faces;
+
+    # the OBB trees of polyhedra are restored from the state and give the same overlaps
+    def test_gsd_polyhedron(self):
+        filename = "polyhedron.gsd";
+        verts, faces = self.make_tessellated_cube(7);
+
+        # three pairs of cubes: overlapping, separated, and overlapping after rotating one by 45 degrees about z
+        snap = data.make_snapshot(N=6, box=data.boxdim(L=10), particle_types=['A']);
+        if hoomd.comm.get_rank() == 0:
+            snap.particles.position[:] = [(-0.475,-3,0), (0.475,-3,0),
+                                          (-0.525,0,0), (0.525,0,0),
+                                          (-0.525,3,0), (0.525,3,0)];
+            snap.particles.orientation[5] = (np.cos(np.pi/8), 0, 0, np.sin(np.pi/8));
+        self.system = init.read_snapshot(snap);
+        self.mc = hpmc.integrate.polyhedron(seed=2398, d=0.0, a=0.0);
+        self.mc.shape_param.set('A', vertices=verts, faces=faces);
+        self.assertEqual(self.mc.count_overlaps(), 2);
+
+        self.gsd = hoomd.dump.gsd(filename, group=hoomd.group.all(), period=1, overwrite=True);
+        self.gsd.dump_state(self.mc);
+        hoomd.run(1);
+        self.gsd.disable();
+        self.tear_down();
+
+        self.system = init.read_gsd(filename=filename, frame=0);
+        self.mc = hpmc.integrate.polyhedron(seed=2398, d=0.0, a=0.0, restore_state=True);
+        self.gsd = None;
+        np.testing.assert_allclose(self.mc.shape_param['A'].vertices, verts, atol=1e-6);
+        self.assertEqual(len(self.mc.shape_param['A'].faces), len(faces));
+        self.assertEqual(self.mc.count_overlaps(), 2);
+        hoomd.run(1);
+        self.assertEqual(self.mc.count_overlaps(), 2);
+        self.tear_down();
+
     def test_gsd(self):
 
         # sphere
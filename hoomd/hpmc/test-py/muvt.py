@@ -32,6 +32,9 @@ class muvt_updater_test(unittest.TestCase):
 
         run(100)
 
+        # insertions and removals update the AABB tree in place
+        self.assertEqual(self.mc.count_overlaps(), 0)
+
     def test_convex_polyhedron(self):
         self.mc = hpmc.integrate.convex_polyhedron(seed=10);
         self.mc.set_params(deterministic=True)
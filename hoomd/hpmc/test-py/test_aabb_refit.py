@@ -0,0 +1,38 @@
+from __future__ import division, print_function
+from hoomd import *
+from hoomd import hpmc
+import hoomd
+import unittest
+import numpy
+
+context.initialize()
+
+# This test compares trajectories with a refit and with a rebuilt AABB tree.
+#
+# Success condition: the tree is only an acceleration structure, both runs produce identical positions
+#
+# Failure mode: stale node bounds in the refit tree miss overlaps
+#
+class aabb_refit(unittest.TestCase):
+    def run_system(self, threshold):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.1), n=6)
+        mc = hpmc.integrate.convex_polyhedron(seed=42, d=0.1, a=0.1)
+        verts = [(-0.5,-0.5,-0.5), (-0.5,-0.5,0.5), (-0.5,0.5,-0.5), (-0.5,0.5,0.5),
+                 (0.5,-0.5,-0.5), (0.5,-0.5,0.5), (0.5,0.5,-0.5), (0.5,0.5,0.5)]
+        mc.shape_param.set('A', vertices=verts)
+        mc.set_params(aabb_refit_threshold=threshold)
+        run(100)
+        self.assertEqual(mc.count_overlaps(), 0)
+        pos = numpy.array([p.position for p in system.particles])
+        del mc
+        del system
+        context.initialize()
+        return pos
+
+    def test_refit(self):
+        pos_rebuild = self.run_system(1.0)
+        pos_refit = self.run_system(100.0)
+        numpy.testing.assert_allclose(pos_refit, pos_rebuild)
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
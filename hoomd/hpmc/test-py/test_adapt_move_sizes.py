@@ -0,0 +1,55 @@
+from __future__ import print_function
+from __future__ import division
+from hoomd import *
+from hoomd import hpmc
+import unittest
+
+context.initialize()
+
+# the move sizes adapted during the run bring the acceptance ratio close to the target
+class adapt_move_sizes(unittest.TestCase):
+    def setUp(self):
+        self.system = init.create_lattice(unitcell=lattice.sc(a=1.1, type_name='A'), n=8)
+        self.system.particles.types.add('B')
+
+        self.mc = hpmc.integrate.convex_polyhedron(seed=10, d=0.5, a=0.5)
+        verts = [(-0.5,-0.5,-0.5), (-0.5,-0.5,0.5), (-0.5,0.5,-0.5), (-0.5,0.5,0.5),
+                 (0.5,-0.5,-0.5), (0.5,-0.5,0.5), (0.5,0.5,-0.5), (0.5,0.5,0.5)]
+        self.mc.shape_param.set('A', vertices=verts)
+        self.mc.shape_param.set('B', vertices=verts)
+
+    def test_target(self):
+        self.mc.set_params(d={'B': 0.3})
+        self.mc.adapt_move_sizes(target=0.3, period=5)
+        run(1000)
+
+        # types without particles keep their move sizes
+        self.assertAlmostEqual(self.mc.get_d('B'), 0.3)
+        self.assertNotAlmostEqual(self.mc.get_d('A'), 0.5)
+        self.assertLessEqual(self.mc.get_d('A'), 1.0)
+        self.assertLessEqual(self.mc.get_a('A'), 0.5)
+
+        self.mc.adapt_move_sizes(enable=False)
+        d = self.mc.get_d('A')
+        run(200)
+        self.assertEqual(self.mc.get_d('A'), d)
+        self.assertAlmostEqual(self.mc.get_translate_acceptance(), 0.3, delta=0.1)
+        self.assertAlmostEqual(self.mc.get_rotate_acceptance(), 0.3, delta=0.1)
+
+    def test_zero(self):
+        self.mc.set_params(a=0)
+        self.mc.adapt_move_sizes(target=0.3, period=1)
+        run(10)
+        self.assertEqual(self.mc.get_a('A'), 0)
+
+    def test_invalid(self):
+        self.assertRaises(RuntimeError, self.mc.adapt_move_sizes, target=1.5)
+        self.assertRaises(RuntimeError, self.mc.adapt_move_sizes, period=0)
+
+    def tearDown(self):
+        del self.mc
+        del self.system
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
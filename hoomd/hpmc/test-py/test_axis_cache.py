@@ -0,0 +1,44 @@
+from __future__ import division, print_function
+from hoomd import *
+from hoomd import hpmc
+import hoomd
+import unittest
+import numpy
+
+context.initialize()
+
+# This test compares trajectories with and without the cache of separating axes.
+#
+# Success condition: the cached axes only speed up the overlap tests, both runs produce identical positions
+#
+# Failure mode: a stale axis reports a disjoint pair that overlaps
+#
+class axis_cache(unittest.TestCase):
+    def run_system(self, integrator, cache_size, **params):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.1), n=6)
+        mc = integrator(seed=42, d=0.1, a=0.1)
+        verts = [(-0.5,-0.5,-0.5), (-0.5,-0.5,0.5), (-0.5,0.5,-0.5), (-0.5,0.5,0.5),
+                 (0.5,-0.5,-0.5), (0.5,-0.5,0.5), (0.5,0.5,-0.5), (0.5,0.5,0.5)]
+        mc.shape_param.set('A', vertices=verts, **params)
+        mc.set_params(axis_cache=cache_size)
+        run(100)
+        self.assertEqual(mc.count_overlaps(), 0)
+        pos = numpy.array([p.position for p in system.particles])
+        del mc
+        del system
+        context.initialize()
+        return pos
+
+    def test_convex_polyhedron(self):
+        pos_plain = self.run_system(hpmc.integrate.convex_polyhedron, 0)
+        pos_cache = self.run_system(hpmc.integrate.convex_polyhedron, 100000)
+        numpy.testing.assert_allclose(pos_cache, pos_plain)
+
+    def test_convex_spheropolyhedron(self):
+        pos_plain = self.run_system(hpmc.integrate.convex_spheropolyhedron, 0, sweep_radius=0.02)
+        # a small cache is cleared many times per sweep
+        pos_cache = self.run_system(hpmc.integrate.convex_spheropolyhedron, 64, sweep_radius=0.02)
+        numpy.testing.assert_allclose(pos_cache, pos_plain)
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -0,0 +1,50 @@
+from __future__ import division, print_function
+from hoomd import *
+from hoomd import hpmc
+import hoomd
+import unittest
+import numpy
+
+context.initialize()
+
+# This test compares trajectories with and without the per-particle candidate lists.
+#
+# Success condition: the lists only replace the tree search, both runs produce identical positions, and the lists are
+# rebuilt less often than the particles are swept
+#
+# Failure mode: a list misses a candidate that moved into contact since the last build
+#
+class candidate_list(unittest.TestCase):
+    def run_system(self, integrator, skin, **params):
+        system = init.create_lattice(unitcell=lattice.sc(a=1.1), n=6)
+        mc = integrator(seed=42, d=0.05, a=0.1)
+        mc.shape_param.set('A', **params)
+        mc.set_params(candidate_skin=skin)
+        run(100)
+        self.assertEqual(mc.count_overlaps(), 0)
+        pos = numpy.array([p.position for p in system.particles])
+        builds = mc.cpp_integrator.getCandidateListBuilds()
+        del mc
+        del system
+        context.initialize()
+        return pos, builds
+
+    def test_sphere(self):
+        pos_tree, builds = self.run_system(hpmc.integrate.sphere, 0.0, diameter=1.0)
+        self.assertEqual(builds, 0)
+        pos_list, builds = self.run_system(hpmc.integrate.sphere, 0.5, diameter=1.0)
+        numpy.testing.assert_allclose(pos_list, pos_tree)
+        self.assertGreater(builds, 0)
+        # 100 steps of 4 sweeps each
+        self.assertLess(builds, 100)
+
+    def test_convex_polyhedron(self):
+        verts = [(-0.5,-0.5,-0.5), (-0.5,-0.5,0.5), (-0.5,0.5,-0.5), (-0.5,0.5,0.5),
+                 (0.5,-0.5,-0.5), (0.5,-0.5,0.5), (0.5,0.5,-0.5), (0.5,0.5,0.5)]
+        pos_tree, builds = self.run_system(hpmc.integrate.convex_polyhedron, 0.0, vertices=verts)
+        pos_list, builds = self.run_system(hpmc.integrate.convex_polyhedron, 0.5, vertices=verts)
+        numpy.testing.assert_allclose(pos_list, pos_tree)
+        self.assertGreater(builds, 0)
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -0,0 +1,84 @@
+from __future__ import division, print_function
+from hoomd import *
+from hoomd import hpmc
+import hoomd
+import unittest
+
+context.initialize()
+
+# This test runs checkerboard sweeps on a system that is large enough for several cells in each direction.
+#
+# Success condition: no overlaps are created and trial moves are accepted
+#
+# Failure mode: concurrently moved particles in neighboring cells overlap
+#
+class checkerboard_sphere(unittest.TestCase):
+    def setUp(self):
+        self.system = init.create_lattice(unitcell=lattice.sc(a=1.2), n=12)
+        self.mc = hpmc.integrate.sphere(seed=123, d=0.1)
+        self.mc.shape_param.set('A', diameter=1.0)
+        self.mc.set_params(checkerboard=True)
+
+    def test_run(self):
+        run(200)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+        self.assertGreater(self.mc.get_translate_acceptance(), 0)
+
+    def test_small_box(self):
+        # too few cells, falls back to serial sweeps
+        self.mc.shape_param.set('A', diameter=1.1)
+        self.mc.set_params(d=0.05)
+        self.system.box = data.boxdim(L=14.4)
+        run(20)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+
+    def tearDown(self):
+        del self.mc
+        del self.system
+        context.initialize()
+
+class checkerboard_sphere_2d(unittest.TestCase):
+    def setUp(self):
+        self.system = init.create_lattice(unitcell=lattice.sq(a=1.2), n=20)
+        self.mc = hpmc.integrate.sphere(seed=123, d=0.1)
+        self.mc.shape_param.set('A', diameter=1.0)
+        self.mc.set_params(checkerboard=True)
+
+    def test_run(self):
+        run(200)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+        self.assertGreater(self.mc.get_translate_acceptance(), 0)
+
+    def tearDown(self):
+        del self.mc
+        del self.system
+        context.initialize()
+
+# Checkerboard sweeps with a lattice field, which can be evaluated concurrently
+class checkerboard_lattice_field(unittest.TestCase):
+    def setUp(self):
+        self.system = init.create_lattice(unitcell=lattice.sc(a=1.2), n=12)
+        self.mc = hpmc.integrate.sphere(seed=123, d=0.1)
+        self.mc.shape_param.set('A', diameter=1.0)
+        self.mc.set_params(checkerboard=True)
+
+        snap = self.system.take_snapshot()
+        self.field = hpmc.field.lattice_field(self.mc, position=snap.particles.position.tolist(), k=100.0)
+
+    def test_run(self):
+        run(200)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+        self.assertGreater(self.mc.get_translate_acceptance(), 0)
+
+        # equipartition gives 3/2 kT per particle in the harmonic wells
+        N = len(self.system.particles)
+        self.assertLess(self.field.get_energy()/N, 3.0)
+
+    def tearDown(self):
+        del self.field
+        del self.mc
+        del self.system
+        context.initialize()
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -22,6 +22,7 @@ class test_clusters_spheres (unittest.TestCase):
 
     def test_integrate(self):
         run(100)
+        self.assertEqual(self.mc.count_overlaps(), 0)
 
         if comm.get_num_ranks() == 1:
             self.assertAlmostEqual(self.clusters.get_pivot_acceptance(),1.0)
@@ -48,6 +49,29 @@ class test_clusters_spheres (unittest.TestCase):
         self.clusters.set_params(delta_mu=0.1)
         run(100)
         self.assertTrue(self.clusters.get_swap_acceptance()<1.0)
+        self.assertEqual(self.mc.count_overlaps(), 0)
+
+    def tearDown(self):
+        del self.clusters
+        del self.mc
+        del self.system
+        context.initialize();
+
+class test_clusters_cubes (unittest.TestCase):
+    def setUp(self):
+        # anisotropic shapes only perform line reflections
+        self.system = init.create_lattice(lattice.sc(a=1.5),n=[5,5,5])
+        self.mc = hpmc.integrate.convex_polyhedron(seed=123)
+
+        self.mc.shape_param.set('A', vertices=[(-0.5,-0.5,-0.5), (-0.5,-0.5,0.5), (-0.5,0.5,-0.5), (-0.5,0.5,0.5),
+                                               (0.5,-0.5,-0.5), (0.5,-0.5,0.5), (0.5,0.5,-0.5), (0.5,0.5,0.5)])
+        self.clusters = hpmc.update.clusters(self.mc, seed=54321, period=1)
+
+    def test_integrate(self):
+        run(100)
+
+        self.assertTrue(self.clusters.get_reflection_acceptance() > 0)
+        self.assertEqual(self.mc.count_overlaps(), 0)
 
     def tearDown(self):
         del self.clusters
@@ -0,0 +1,44 @@
+from __future__ import division, print_function
+from hoomd import *
+from hoomd import hpmc
+import hoomd
+import unittest
+import numpy
+
+context.initialize()
+
+# This test compares trajectories with the trial move sweep launched directly and replayed from a CUDA graph.
+#
+# Success condition: the graph replays the same kernels with the same random numbers, both runs produce identical
+# positions
+#
+# Failure mode: the replayed sweep reads stale time steps or cell set orders
+#
+class cuda_graph(unittest.TestCase):
+    def run_system(self, cuda_graph):
+        # keep the launch parameters fixed, the sweep is not replayed while the autotuner samples
+        option.set_autotuner_params(enable=False)
+
+        system = init.create_lattice(unitcell=lattice.sc(a=1.2), n=8)
+        mc = hpmc.integrate.sphere(seed=42, d=0.1)
+        mc.shape_param.set('A', diameter=1.0)
+        mc.set_params(deterministic=True, cuda_graph=cuda_graph)
+        run(50)
+
+        # change the structure of the sweep
+        mc.shape_param.set('A', diameter=1.05)
+        run(50)
+        self.assertEqual(mc.count_overlaps(), 0)
+        pos = numpy.array([p.position for p in system.particles])
+        del mc
+        del system
+        context.initialize()
+        return pos
+
+    def test_replay(self):
+        pos_direct = self.run_system(False)
+        pos_graph = self.run_system(True)
+        numpy.testing.assert_allclose(pos_graph, pos_direct)
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -0,0 +1,87 @@
+from __future__ import division, print_function
+from hoomd import *
+from hoomd import hpmc
+import hoomd
+import unittest
+import numpy
+
+context.initialize()
+
+# This test runs event chains in dense systems of spheres and cubes.
+#
+# Success condition: no overlaps are created, the particles move and the chains collide
+#
+# Failure mode: a collision is missed or computed too late, and the moved particle overlaps its neighbor
+#
+class event_chain_sphere(unittest.TestCase):
+    def setUp(self):
+        self.system = init.create_lattice(unitcell=lattice.sc(a=1.05), n=8)
+
+    def run_chains(self, mc):
+        mc.shape_param.set('A', diameter=1.0)
+        pos_before = numpy.array(self.system.take_snapshot().particles.position)
+        run(20)
+        self.assertEqual(mc.count_overlaps(), 0)
+        self.assertGreater(mc.get_chain_events(), 1)
+        pos_after = numpy.array(self.system.take_snapshot().particles.position)
+        self.assertFalse(numpy.allclose(pos_before, pos_after))
+
+    def test_straight(self):
+        mc = hpmc.integrate.sphere_ec(seed=123, chain_length=2.0)
+        self.run_chains(mc)
+
+    def test_newtonian(self):
+        mc = hpmc.integrate.sphere_ec(seed=123, chain_length=2.0, variant='newtonian')
+        self.run_chains(mc)
+
+        # particles without a velocity are given one when they start a chain
+        vel = numpy.array(self.system.take_snapshot().particles.velocity)
+        self.assertGreater(numpy.sum(vel*vel), 0)
+
+    def test_set_params(self):
+        mc = hpmc.integrate.sphere_ec(seed=123)
+        mc.shape_param.set('A', diameter=1.0)
+        mc.set_chain_params(chain_length=0.5, variant='newtonian')
+        with self.assertRaises(ValueError):
+            mc.set_chain_params(variant='curved')
+        run(5)
+        self.assertEqual(mc.count_overlaps(), 0)
+
+    def tearDown(self):
+        del self.system
+        context.initialize()
+
+class event_chain_disk(unittest.TestCase):
+    def setUp(self):
+        self.system = init.create_lattice(unitcell=lattice.sq(a=1.05), n=16)
+
+    def test_straight(self):
+        mc = hpmc.integrate.sphere_ec(seed=123, chain_length=2.0)
+        mc.shape_param.set('A', diameter=1.0)
+        run(20)
+        self.assertEqual(mc.count_overlaps(), 0)
+        self.assertGreater(mc.get_chain_events(), 1)
+
+    def tearDown(self):
+        del self.system
+        context.initialize()
+
+class event_chain_cube(unittest.TestCase):
+    def setUp(self):
+        self.system = init.create_lattice(unitcell=lattice.sc(a=1.1), n=5)
+
+    def test_straight(self):
+        mc = hpmc.integrate.convex_polyhedron_ec(seed=123, chain_length=1.0, a=0.05, move_ratio=0.8)
+        mc.shape_param.set('A', vertices=[(-0.5, -0.5, -0.5), (-0.5, -0.5, 0.5), (-0.5, 0.5, -0.5), (-0.5, 0.5, 0.5),
+                                          (0.5, -0.5, -0.5), (0.5, -0.5, 0.5), (0.5, 0.5, -0.5), (0.5, 0.5, 0.5)])
+        run(10)
+        self.assertEqual(mc.count_overlaps(), 0)
+        self.assertGreater(mc.get_chain_events(), 0)
+        self.assertGreater(mc.get_rotate_acceptance(), 0)
+
+    def tearDown(self):
+        del self.system
+        context.initialize()
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
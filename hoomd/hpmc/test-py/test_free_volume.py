@@ -0,0 +1,41 @@
+from __future__ import print_function
+from __future__ import division
+from hoomd import *
+from hoomd import hpmc
+import math
+import unittest
+
+context.initialize()
+
+# a single sphere excludes a sphere of twice its radius from the center of the test particle
+class free_volume_sphere(unittest.TestCase):
+    def setUp(self):
+        snap = data.make_snapshot(N=1, box=data.boxdim(L=4), particle_types=['A','B'])
+        self.system = init.read_snapshot(snap)
+
+        self.mc = hpmc.integrate.sphere(seed=123)
+        self.mc.shape_param.set('A', diameter=1.0)
+        self.mc.shape_param.set('B', diameter=1.0)
+
+        self.V_free = 4**3 - 4.0/3.0*math.pi
+
+    def test_uniform(self):
+        self.free_volume = hpmc.compute.free_volume(mc=self.mc, seed=987, nsample=100000, test_type='B')
+        log = analyze.log(filename=None, quantities=['hpmc_free_volume'], period=1)
+        run(1)
+        self.assertAlmostEqual(log.query('hpmc_free_volume'), self.V_free, delta=0.5)
+
+    def test_stratified(self):
+        self.free_volume = hpmc.compute.free_volume(mc=self.mc, seed=987, nsample=100000, test_type='B', stratified=True)
+        log = analyze.log(filename=None, quantities=['hpmc_free_volume'], period=1)
+        run(1)
+        self.assertAlmostEqual(log.query('hpmc_free_volume'), self.V_free, delta=0.5)
+
+    def tearDown(self):
+        del self.free_volume
+        del self.mc
+        del self.system
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
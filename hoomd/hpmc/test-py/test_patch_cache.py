@@ -0,0 +1,105 @@
+from __future__ import division
+from __future__ import print_function
+
+import hoomd
+from hoomd import context, data, init, analyze
+from hoomd import hpmc, jit
+
+import unittest
+import numpy as np
+
+context.initialize();
+
+# tests the patch energies evaluated in neighbor packets and the per-particle energies cached during serial sweeps
+class patch_energy_cache(unittest.TestCase):
+        def setUp(self):
+            self.r_cut = 1.5;
+            self.square_well = """float rsq = dot(r_ij, r_ij);
+                                  if (rsq < {0}f)
+                                      return -1.0f;
+                                  else
+                                      return 0.0f;
+                               """.format(self.r_cut**2);
+
+        # count the pairs closer than r_cut in a cubic box with the minimum image convention
+        def count_pairs(self, snapshot, r_cut):
+            L = snapshot.box.Lx;
+            pos = snapshot.particles.position;
+            dr = pos[:,np.newaxis,:] - pos[np.newaxis,:,:];
+            dr -= L*np.round(dr/L);
+            rsq = np.sum(dr**2, axis=2);
+            return int(np.count_nonzero(np.triu(rsq < r_cut**2, k=1)));
+
+        # random positions of ideal particles in a cubic box
+        def init_random(self, N, L):
+            snapshot = data.make_snapshot(N=N, box=data.boxdim(L=L, dimensions=3), particle_types=['A']);
+            if hoomd.comm.get_rank() == 0:
+                np.random.seed(21);
+                snapshot.particles.position[:] = np.random.uniform(-L/2, L/2, size=(N,3));
+            self.system = init.read_snapshot(snapshot);
+
+        def make_mc(self, nselect):
+            self.mc = hpmc.integrate.sphere(seed=10, d=0.2, a=0, nselect=nselect);
+            self.mc.shape_param.set('A', diameter=1.0);
+            self.mc.overlap_checks.set('A', 'A', False);
+
+        # the energies of the batched and the per pair evaluation match the pairs of the configuration
+        def test_square_well_energy(self):
+            self.init_random(200, 8.0);
+            self.make_mc(nselect=4);
+            self.patch = jit.patch.user(mc=self.mc, r_cut=self.r_cut, code=self.square_well);
+            self.log = analyze.log(filename=None, quantities=['hpmc_patch_energy'], period=None, overwrite=True);
+
+            for i in range(3):
+                hoomd.run(20, quiet=True);
+                snapshot = self.system.take_snapshot();
+                energy = self.log.query('hpmc_patch_energy');
+                if hoomd.comm.get_rank() == 0:
+                    self.assertAlmostEqual(energy, -self.count_pairs(snapshot, self.r_cut), places=3);
+
+            # the isotropic part of patch.user_union evaluates pair by pair
+            self.patch.disable();
+            self.patch_union = jit.patch.user_union(mc=self.mc, r_cut_iso=self.r_cut, code_iso=self.square_well,
+                r_cut=0.0, code='return 0.0f;');
+            hoomd.run(20, quiet=True);
+            snapshot = self.system.take_snapshot();
+            energy = self.log.query('hpmc_patch_energy');
+            if hoomd.comm.get_rank() == 0:
+                self.assertAlmostEqual(energy, -self.count_pairs(snapshot, self.r_cut), places=3);
+            del self.patch_union;
+
+        # moves into a shoulder of very large energy are never accepted, with and without the cached energies
+        def test_repulsive_shoulder(self):
+            shoulder = """float rsq = dot(r_ij, r_ij);
+                          if (rsq < 1.0f)
+                              return 1e6f;
+                          else
+                              return 0.0f;
+                       """;
+            for nselect in [1, 4]:
+                self.system = init.create_lattice(unitcell=hoomd.lattice.sc(a=1.2), n=6);
+                self.make_mc(nselect=nselect);
+                self.patch = jit.patch.user(mc=self.mc, r_cut=1.0, code=shoulder);
+                self.log = analyze.log(filename=None, quantities=['hpmc_patch_energy'], period=None, overwrite=True);
+
+                hoomd.run(50, quiet=True);
+                self.assertEqual(self.log.query('hpmc_patch_energy'), 0);
+                snapshot = self.system.take_snapshot();
+                if hoomd.comm.get_rank() == 0:
+                    self.assertEqual(self.count_pairs(snapshot, 1.0), 0);
+
+                # particles moved
+                translate_acceptance = self.mc.get_translate_acceptance();
+                self.assertGreater(translate_acceptance, 0);
+
+                del self.log;
+                del self.patch;
+                del self.mc;
+                del self.system;
+                context.initialize();
+
+        def tearDown(self):
+            context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
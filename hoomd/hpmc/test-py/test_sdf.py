@@ -178,5 +178,76 @@ class sdf_test1 (unittest.TestCase):
         if comm.get_rank() == 0:
             os.remove(self.tmp_file);
 
+# this test places isolated pairs of particles at separations that put their contact scale factor in the middle of a
+# known bin. The histogram is exact, so the CPU and GPU implementations must both reproduce it.
+class sdf_pairs_test (unittest.TestCase):
+    def setUp(self):
+        self.xmax = 0.02;
+        self.dx = 1e-3;
+        self.n_bins = int(round(self.xmax / self.dx));
+
+        # 4**3 pairs on a lattice that is wide enough that particles of different pairs do not contribute
+        self.n = 4;
+        self.a = 3.0;
+        snap = data.make_snapshot(N=2*self.n**3, box=data.boxdim(L=self.n*self.a), particle_types=['A']);
+        self.expected = numpy.zeros(self.n_bins);
+        if comm.get_rank() == 0:
+            for k in range(self.n**3):
+                (i, j, l) = (k % self.n, k // self.n % self.n, k // self.n**2);
+                center = numpy.array([i, j, l]) * self.a - self.n*self.a/2 + self.a/2;
+
+                # the pair overlaps when its separation r is scaled by (1 - lambda) below the diameter
+                b = k % self.n_bins;
+                lam = (b + 0.5) * self.dx;
+                r = 1.0 / (1.0 - lam);
+                snap.particles.position[2*k] = center - (r/2, 0, 0);
+                snap.particles.position[2*k+1] = center + (r/2, 0, 0);
+                self.expected[b] += 2;
+            self.expected /= snap.particles.N * self.dx;
+        self.system = init.read_snapshot(snap);
+
+        if comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.hpmc-test-sdf');
+            self.tmp_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+
+    def check_sdf(self, mc):
+        # the particles stay in place
+        mc.set_params(d=0, a=0);
+        hpmc.analyze.sdf(mc=mc, filename=self.tmp_file, xmax=self.xmax, dx=self.dx, navg=1, period=1,
+                         overwrite=True);
+
+        # a second analyzer needs its own cell list on the GPU
+        hpmc.analyze.sdf(mc=mc, filename=self.tmp_file + '.2', xmax=self.xmax, dx=self.dx, navg=1, period=1,
+                         overwrite=True);
+        run(1);
+
+        if comm.get_rank() == 0:
+            for f in [self.tmp_file, self.tmp_file + '.2']:
+                r = numpy.loadtxt(f, ndmin=2);
+                self.assertEqual(r.shape[1]-1, self.n_bins);
+                numpy.testing.assert_allclose(r[0, 1:], self.expected, rtol=1e-6);
+
+    def test_sphere(self):
+        mc = hpmc.integrate.sphere(seed=10);
+        mc.shape_param.set('A', diameter=1.0);
+        self.check_sdf(mc);
+
+    def test_convex_polyhedron(self):
+        # cubes with the same orientation, separated along a face normal, touch at the same scale factor as spheres
+        mc = hpmc.integrate.convex_polyhedron(seed=10);
+        mc.shape_param.set('A', vertices=[(x, y, z) for x in (-0.5, 0.5) for y in (-0.5, 0.5) for z in (-0.5, 0.5)]);
+        self.check_sdf(mc);
+
+    def tearDown(self):
+        del self.system
+        context.initialize();
+
+        if comm.get_rank() == 0:
+            os.remove(self.tmp_file);
+            if os.path.exists(self.tmp_file + '.2'):
+                os.remove(self.tmp_file + '.2');
+
 if __name__ == '__main__':
     unittest.main(argv = ['test.py', '-v'])
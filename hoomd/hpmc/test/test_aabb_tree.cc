@@ -101,3 +101,127 @@ UP_TEST( bigger )
         UP_ASSERT(in(i, hits));
         }
     }
+
+UP_TEST( large )
+    {
+    // big enough that the children of the top nodes are built in parallel in builds with ENABLE_TBB
+    const unsigned int N = 4*AABB_TREE_PARALLEL_MIN;
+    hoomd::detail::Saru rng(2);
+
+    std::vector< vec3<Scalar> > points(N);
+    std::vector<AABB> aabbs(N);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        points[i] = vec3<Scalar>(rng.f(), rng.f(), rng.f()) * Scalar(1000);
+        aabbs[i] = AABB(points[i], Scalar(1.0));
+        }
+
+    AABBTree tree;
+    tree.buildTree(&aabbs[0], N);
+
+    // the nodes must be laid out in pre-order for the stackless traversal
+    for (unsigned int node = 0; node < tree.getNumNodes(); node++)
+        {
+        if (!tree.isNodeLeaf(node))
+            {
+            UP_ASSERT_EQUAL(tree.getNodeLeft(node), node+1);
+            UP_ASSERT_EQUAL(tree.getNode(node).right, node+1+tree.getNodeSkip(node+1)+1);
+            UP_ASSERT_EQUAL(tree.getNodeSkip(node),
+                            tree.getNodeSkip(node+1)+1 + tree.getNodeSkip(tree.getNode(node).right)+1);
+            }
+        else
+            {
+            UP_ASSERT_EQUAL(tree.getNodeSkip(node), 0);
+            }
+        }
+
+    // query each particle to ensure it can be found, and that its leaf node is known
+    std::vector<unsigned int> hits;
+    for (unsigned int i = 0; i < N; i++)
+        {
+        hits.clear();
+        tree.query(hits, AABB(points[i], Scalar(0.01)));
+        UP_ASSERT(in(i, hits));
+        UP_ASSERT(tree.height(i) > 0);
+        }
+    }
+
+//! Find the particles whose AABBs overlap with a query box, using the tree to find the candidates
+std::vector<unsigned int> query_overlaps(const AABBTree& tree, const std::vector<AABB>& aabbs, const AABB& box)
+    {
+    std::vector<unsigned int> hits;
+    tree.query(hits, box);
+
+    std::vector<unsigned int> overlaps;
+    for (unsigned int j = 0; j < hits.size(); j++)
+        {
+        if (overlap(aabbs[hits[j]], box))
+            overlaps.push_back(hits[j]);
+        }
+    std::sort(overlaps.begin(), overlaps.end());
+    return overlaps;
+    }
+
+UP_TEST( insert_remove )
+    {
+    const unsigned int N = 1000;
+    hoomd::detail::Saru rng(3);
+
+    std::vector<AABB> aabbs(N);
+    for (unsigned int i = 0; i < N; i++)
+        aabbs[i] = AABB(vec3<Scalar>(rng.f(), rng.f(), rng.f()) * Scalar(100), Scalar(1.0));
+
+    // buildTree() reorders the AABBs it is given, so build from copies
+    std::vector<AABB> aabbs_build(aabbs);
+    AABBTree tree;
+    tree.buildTree(&aabbs_build[0], N);
+
+    unsigned int n_inserted = 0;
+    for (unsigned int step = 0; step < 10; step++)
+        {
+        // remove random particles the way ParticleData::removeParticle() does, the last particle takes the index
+        for (unsigned int k = 0; k < 50; k++)
+            {
+            unsigned int idx = rng.u32() % aabbs.size();
+            tree.remove(idx);
+            aabbs[idx] = aabbs.back();
+            aabbs.pop_back();
+            }
+        UP_ASSERT_EQUAL(tree.getNumParticles(), aabbs.size());
+
+        // append new particles, rebuilding when no leaf has room like IntegratorHPMCMono does
+        for (unsigned int k = 0; k < 50; k++)
+            {
+            aabbs.push_back(AABB(vec3<Scalar>(rng.f(), rng.f(), rng.f()) * Scalar(100), Scalar(1.0)));
+            if (tree.insert(aabbs.size()-1, aabbs.back()))
+                n_inserted++;
+            else
+                {
+                aabbs_build = aabbs;
+                tree.buildTree(&aabbs_build[0], aabbs.size());
+                }
+            }
+        UP_ASSERT_EQUAL(tree.getNumParticles(), aabbs.size());
+
+        // every particle is found in a leaf
+        for (unsigned int i = 0; i < aabbs.size(); i++)
+            {
+            std::vector<unsigned int> hits;
+            tree.query(hits, aabbs[i]);
+            UP_ASSERT(in(i, hits));
+            }
+
+        // queries give the same overlaps as in a tree rebuilt from scratch
+        aabbs_build = aabbs;
+        AABBTree rebuilt;
+        rebuilt.buildTree(&aabbs_build[0], aabbs.size());
+        for (unsigned int k = 0; k < 100; k++)
+            {
+            AABB box(vec3<Scalar>(rng.f(), rng.f(), rng.f()) * Scalar(100), Scalar(5.0));
+            UP_ASSERT_EQUAL(query_overlaps(tree, aabbs, box), query_overlaps(rebuilt, aabbs, box));
+            }
+        }
+
+    // the insertions did not all fall back to a rebuild
+    UP_ASSERT(n_inserted > 0);
+    }
@@ -0,0 +1,167 @@
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+#include "hoomd/Saru.h"
+
+#include "hoomd/hpmc/UpdaterClusters.h"
+
+#include <algorithm>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+#include <memory>
+
+using namespace std;
+using namespace hpmc;
+using namespace hpmc::detail;
+
+#ifdef ENABLE_TBB
+typedef std::vector< tbb::concurrent_vector<unsigned int> > component_list;
+#else
+typedef std::vector< std::vector<unsigned int> > component_list;
+#endif
+
+//! Generate random edges between V vertices
+std::vector< std::pair<unsigned int, unsigned int> > random_edges(unsigned int V, unsigned int n_edges)
+    {
+    hoomd::detail::Saru rng(4, 5, 6);
+    std::vector< std::pair<unsigned int, unsigned int> > edges;
+    for (unsigned int i = 0; i < n_edges; i++)
+        {
+        unsigned int v = rng.u32() % V;
+        unsigned int w = rng.u32() % V;
+        edges.push_back(std::make_pair(v, w));
+        }
+    return edges;
+    }
+
+//! Find the connected components with a breadth first search, ordered by their smallest vertex
+std::vector< std::vector<unsigned int> > components_bfs(unsigned int V,
+                                                        const std::vector< std::pair<unsigned int, unsigned int> >& edges)
+    {
+    std::vector< std::vector<unsigned int> > adj(V);
+    for (unsigned int i = 0; i < edges.size(); i++)
+        {
+        adj[edges[i].first].push_back(edges[i].second);
+        adj[edges[i].second].push_back(edges[i].first);
+        }
+
+    std::vector< std::vector<unsigned int> > cc;
+    std::vector<bool> visited(V, false);
+    for (unsigned int v = 0; v < V; v++)
+        {
+        if (visited[v])
+            continue;
+
+        std::vector<unsigned int> component(1, v);
+        visited[v] = true;
+        for (unsigned int k = 0; k < component.size(); k++)
+            {
+            unsigned int u = component[k];
+            for (unsigned int j = 0; j < adj[u].size(); j++)
+                {
+                if (!visited[adj[u][j]])
+                    {
+                    visited[adj[u][j]] = true;
+                    component.push_back(adj[u][j]);
+                    }
+                }
+            }
+        std::sort(component.begin(), component.end());
+        cc.push_back(component);
+        }
+    return cc;
+    }
+
+//! Check that the components of the graph match the reference in order and content
+void check_components(const component_list& cc, const std::vector< std::vector<unsigned int> >& ref)
+    {
+    UP_ASSERT_EQUAL(cc.size(), ref.size());
+    for (unsigned int i = 0; i < ref.size(); i++)
+        {
+        UP_ASSERT_EQUAL(cc[i].size(), ref[i].size());
+        for (unsigned int j = 0; j < ref[i].size(); j++)
+            UP_ASSERT_EQUAL(cc[i][j], ref[i][j]);
+        }
+    }
+
+//! Test that the components match a breadth first search, independent of the order of the edges
+UP_TEST( cluster_graph_components_test )
+    {
+    const unsigned int V = 2000;
+    std::vector< std::pair<unsigned int, unsigned int> > edges = random_edges(V, 1500);
+    std::vector< std::vector<unsigned int> > ref = components_bfs(V, edges);
+
+    // there are both isolated vertices and large clusters
+    UP_ASSERT(ref.size() > 1);
+    UP_ASSERT(ref.size() < V);
+
+    Graph G(V);
+    for (unsigned int i = 0; i < edges.size(); i++)
+        G.addEdge(edges[i].first, edges[i].second);
+    component_list cc;
+    G.connectedComponents(cc);
+    check_components(cc, ref);
+
+    // add the edges in reverse order and with swapped vertices
+    G.resize(V);
+    for (unsigned int i = edges.size(); i > 0; i--)
+        G.addEdge(edges[i-1].second, edges[i-1].first);
+    component_list cc_reverse;
+    G.connectedComponents(cc_reverse);
+    check_components(cc_reverse, ref);
+    }
+
+//! Test that resize() removes all edges and that self edges have no effect
+UP_TEST( cluster_graph_resize_test )
+    {
+    Graph G(100);
+    for (unsigned int v = 1; v < 100; v++)
+        G.addEdge(v-1, v);
+    component_list cc;
+    G.connectedComponents(cc);
+    UP_ASSERT_EQUAL(cc.size(), 1);
+    UP_ASSERT_EQUAL(cc[0].size(), 100);
+
+    // a smaller graph reuses the storage but starts without edges
+    G.resize(10);
+    G.addEdge(3, 3);
+    component_list cc_small;
+    G.connectedComponents(cc_small);
+    UP_ASSERT_EQUAL(cc_small.size(), 10);
+    for (unsigned int i = 0; i < 10; i++)
+        {
+        UP_ASSERT_EQUAL(cc_small[i].size(), 1);
+        UP_ASSERT_EQUAL(cc_small[i][0], i);
+        }
+    }
+
+#ifdef ENABLE_TBB
+//! Test that edges added concurrently on several TBB threads give the same components as a single thread
+UP_TEST( cluster_graph_threads_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    exec_conf->setNumThreads(4);
+
+    const unsigned int V = 100000;
+    std::vector< std::pair<unsigned int, unsigned int> > edges = random_edges(V, 80000);
+    std::vector< std::vector<unsigned int> > ref = components_bfs(V, edges);
+
+    Graph G(V);
+    tbb::parallel_for(tbb::blocked_range<unsigned int>(0, edges.size(), 100),
+        [&](const tbb::blocked_range<unsigned int>& r)
+        {
+        for (unsigned int i = r.begin(); i != r.end(); ++i)
+            G.addEdge(edges[i].first, edges[i].second);
+        });
+
+    component_list cc;
+    G.connectedComponents(cc);
+    check_components(cc, ref);
+    }
+#endif
@@ -3,6 +3,7 @@
 #include "hoomd/hpmc/IntegratorHPMC.h"
 #include "hoomd/hpmc/Moves.h"
 #include "hoomd/hpmc/ShapeConvexPolyhedron.h"
+#include "hoomd/hpmc/SweepDistance.h"
 
 #include "hoomd/test/upp11_config.h"
 
@@ -620,3 +621,162 @@ UP_TEST( overlap_cube_rot3 )
     UP_ASSERT(test_overlap(-r_ij,b,a,err_count));
 
     }
+
+UP_TEST( overlap_cube_near_contact )
+    {
+    quat<Scalar> o;
+
+    // build a cube
+    vector< vec3<OverlapReal> > vlist;
+    vlist.push_back(vec3<OverlapReal>(-0.5,-0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,-0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,-0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,-0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,0.5,0.5));
+    poly3d_verts verts = setup_verts(vlist);
+
+    ShapeConvexPolyhedron a(o, verts);
+    ShapeConvexPolyhedron b(o, verts);
+    OverlapReal R = a.getCircumsphereDiameter();
+    OverlapReal margin = 1e-2;
+    bool near_contact;
+
+    // results decided far from contact are not flagged
+    UP_ASSERT(!xenocollide_3d_margin<OverlapReal>(SupportFuncConvexPolyhedron(verts), SupportFuncConvexPolyhedron(verts),
+        vec3<OverlapReal>(1.5,0.2,0.1), quat<OverlapReal>(), R, err_count, margin, near_contact));
+    UP_ASSERT(!near_contact);
+    UP_ASSERT(xenocollide_3d_margin<OverlapReal>(SupportFuncConvexPolyhedron(verts), SupportFuncConvexPolyhedron(verts),
+        vec3<OverlapReal>(0.5,0.2,0.1), quat<OverlapReal>(), R, err_count, margin, near_contact));
+    UP_ASSERT(!near_contact);
+
+    // results decided within the margin are flagged, on both sides of contact
+    UP_ASSERT(!xenocollide_3d_margin<OverlapReal>(SupportFuncConvexPolyhedron(verts), SupportFuncConvexPolyhedron(verts),
+        vec3<OverlapReal>(1.001,0.2,0.1), quat<OverlapReal>(), R, err_count, margin, near_contact));
+    UP_ASSERT(near_contact);
+    UP_ASSERT(xenocollide_3d_margin<OverlapReal>(SupportFuncConvexPolyhedron(verts), SupportFuncConvexPolyhedron(verts),
+        vec3<OverlapReal>(0.999,0.2,0.1), quat<OverlapReal>(), R, err_count, margin, near_contact));
+    UP_ASSERT(near_contact);
+
+    // the double precision re-test resolves separations below single precision round-off
+    UP_ASSERT(!xenocollide_3d_margin<double>(SupportFuncConvexPolyhedronDouble(verts), SupportFuncConvexPolyhedronDouble(verts),
+        vec3<double>(1.0+1e-9,0.2,0.1), quat<double>(), double(R), err_count, 0.0, near_contact));
+    UP_ASSERT(xenocollide_3d_margin<double>(SupportFuncConvexPolyhedronDouble(verts), SupportFuncConvexPolyhedronDouble(verts),
+        vec3<double>(1.0-1e-9,0.2,0.1), quat<double>(), double(R), err_count, 0.0, near_contact));
+
+    // the full test agrees on either side of contact
+    UP_ASSERT(!test_overlap(vec3<Scalar>(1.001,0.2,0.1),a,b,err_count));
+    UP_ASSERT(test_overlap(vec3<Scalar>(0.999,0.2,0.1),a,b,err_count));
+    }
+
+UP_TEST( sweep_cube )
+    {
+    quat<Scalar> o;
+
+    // build a cube
+    vector< vec3<OverlapReal> > vlist;
+    vlist.push_back(vec3<OverlapReal>(-0.5,-0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,-0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,-0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,-0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,0.5,0.5));
+    poly3d_verts verts = setup_verts(vlist);
+
+    ShapeConvexPolyhedron a(o, verts);
+    ShapeConvexPolyhedron b(o, verts);
+
+    vec3<Scalar> x(1,0,0);
+    vec3<Scalar> n;
+
+    // face to face collisions stop just before the contact
+    Scalar s = sweep_distance(vec3<Scalar>(3,0,0), a, b, x, Scalar(10.0), Scalar(0.01), err_count, n);
+    UP_ASSERT(fabs(s - 2.0) < 1e-4);
+    UP_ASSERT(!test_overlap(vec3<Scalar>(3,0,0) - s*x, a, b, err_count));
+
+    s = sweep_distance(vec3<Scalar>(3,0.5,0.5), a, b, x, Scalar(10.0), Scalar(0.01), err_count, n);
+    UP_ASSERT(fabs(s - 2.0) < 1e-4);
+
+    // the cubes pass each other
+    s = sweep_distance(vec3<Scalar>(3,1.2,0), a, b, x, Scalar(10.0), Scalar(0.01), err_count, n);
+    UP_ASSERT_EQUAL(s, Scalar(10.0));
+
+    // a rotated cube collides with its corner
+    quat<Scalar> q = quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), M_PI/4.0);
+    ShapeConvexPolyhedron c(q, verts);
+    s = sweep_distance(vec3<Scalar>(3,0,0), a, c, x, Scalar(10.0), Scalar(0.01), err_count, n);
+    UP_ASSERT(fabs(s - (2.5 - sqrt(0.5))) < 1e-4);
+    }
+
+UP_TEST( separating_axis_warm_start )
+    {
+    quat<Scalar> o;
+
+    // build a cube
+    vector< vec3<OverlapReal> > vlist;
+    vlist.push_back(vec3<OverlapReal>(-0.5,-0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,-0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,0.5,-0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,-0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,-0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(0.5,0.5,0.5));
+    vlist.push_back(vec3<OverlapReal>(-0.5,0.5,0.5));
+    poly3d_verts verts = setup_verts(vlist);
+
+    ShapeConvexPolyhedron a(o, verts);
+    ShapeConvexPolyhedron b(o, verts);
+
+    // a disjoint pair stores a separating axis
+    vec3<OverlapReal> axis;
+    UP_ASSERT(!test_overlap(vec3<Scalar>(1.1,0.2,0.1),a,b,err_count,&axis));
+    UP_ASSERT(dot(axis,axis) > OverlapReal(0.0));
+    vec3<OverlapReal> first = axis;
+
+    // a small move keeps the pair separated by the same axis
+    UP_ASSERT(!test_overlap(vec3<Scalar>(1.05,0.25,0.05),a,b,err_count,&axis));
+    UP_ASSERT_EQUAL(axis.x, first.x);
+    UP_ASSERT_EQUAL(axis.y, first.y);
+    UP_ASSERT_EQUAL(axis.z, first.z);
+
+    // a stale axis does not hide overlaps, and the overlap leaves it unchanged
+    UP_ASSERT(test_overlap(vec3<Scalar>(0.9,0.25,0.05),a,b,err_count,&axis));
+    UP_ASSERT_EQUAL(axis.x, first.x);
+
+    // the axis is kept in the space frame, so it survives a rotation of a
+    quat<Scalar> q = quat<Scalar>::fromAxisAngle(vec3<Scalar>(0,0,1), 0.1);
+    ShapeConvexPolyhedron c(q, verts);
+    UP_ASSERT(!test_overlap(vec3<Scalar>(1.8,0.0,0.0),c,b,err_count,&axis));
+    UP_ASSERT(test_overlap(vec3<Scalar>(1.0,0.0,0.0),c,b,err_count,&axis));
+
+    // the warm start agrees with the plain test on a range of separations
+    for (unsigned int i = 0; i < 40; i++)
+        {
+        vec3<Scalar> r(0.8 + 0.01*i, 0.3, 0.2);
+        UP_ASSERT_EQUAL(test_overlap(r,c,b,err_count,&axis), test_overlap(r,c,b,err_count));
+        }
+    }
+
+UP_TEST( separating_axis_cache )
+    {
+    SeparatingAxisCache cache;
+    UP_ASSERT(!cache.enabled());
+
+    cache.setMaxPairs(2);
+    UP_ASSERT(cache.enabled());
+
+    // new pairs start from a zero axis, pairs are ordered
+    cache.get(1,2) = vec3<OverlapReal>(1,0,0);
+    UP_ASSERT_EQUAL(cache.get(1,2).x, OverlapReal(1.0));
+    UP_ASSERT_EQUAL(cache.get(2,1).x, OverlapReal(0.0));
+    UP_ASSERT_EQUAL(cache.size(), (unsigned int)2);
+
+    // a new pair clears the full cache
+    cache.get(3,1);
+    UP_ASSERT_EQUAL(cache.size(), (unsigned int)1);
+    UP_ASSERT_EQUAL(cache.get(1,2).x, OverlapReal(0.0));
+    }
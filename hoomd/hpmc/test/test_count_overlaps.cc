@@ -0,0 +1,138 @@
+#include "hoomd/ExecutionConfiguration.h"
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+
+
+
+#include "hoomd/Saru.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/VectorMath.h"
+#include "hoomd/SnapshotSystemData.h"
+
+#include "hoomd/hpmc/IntegratorHPMCMono.h"
+#include "hoomd/hpmc/ShapeSphere.h"
+
+#include <iostream>
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+#include <memory>
+
+using namespace std;
+using namespace hpmc;
+using namespace hpmc::detail;
+
+//! Generate N spheres at random positions in a cubic box of side L
+std::shared_ptr< SnapshotSystemData<Scalar> > random_spheres(unsigned int N, Scalar L)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap(new SnapshotSystemData<Scalar>());
+    snap->global_box = BoxDim(L);
+    snap->particle_data.type_mapping.push_back("A");
+    snap->particle_data.resize(N);
+
+    hoomd::detail::Saru rng(1, 2, 3);
+    for (unsigned int i = 0; i < N; i++)
+        snap->particle_data.pos[i] = vec3<Scalar>(rng.s<Scalar>(-L/Scalar(2.0), L/Scalar(2.0)),
+                                                  rng.s<Scalar>(-L/Scalar(2.0), L/Scalar(2.0)),
+                                                  rng.s<Scalar>(-L/Scalar(2.0), L/Scalar(2.0)));
+    return snap;
+    }
+
+//! Count the overlapping pairs of spheres of unit diameter by checking all pairs
+unsigned int count_overlaps_all_pairs(std::shared_ptr< SnapshotSystemData<Scalar> > snap)
+    {
+    const BoxDim& box = snap->global_box;
+    const std::vector< vec3<Scalar> >& pos = snap->particle_data.pos;
+
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < pos.size(); i++)
+        for (unsigned int j = i+1; j < pos.size(); j++)
+            {
+            Scalar3 dr = box.minImage(vec_to_scalar3(pos[j] - pos[i]));
+            if (dot(dr, dr) < Scalar(1.0))
+                count++;
+            }
+    return count;
+    }
+
+//! Create an integrator for spheres of unit diameter that has run a step without moving the particles
+std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > make_sphere_integrator(std::shared_ptr<SystemDefinition> sysdef)
+    {
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc(new IntegratorHPMCMono<ShapeSphere>(sysdef, 10));
+
+    sph_params params;
+    params.radius = OverlapReal(0.5);
+    params.ignore = 0;
+    params.isOriented = false;
+    mc->setParam(0, params);
+    mc->setOverlapChecks(0, 0, true);
+    mc->setD(Scalar(0.0), 0);
+    mc->setA(Scalar(0.0), 0);
+
+    // count_overlaps requires a run
+    mc->update(0);
+    return mc;
+    }
+
+//! Test that countOverlaps matches a check of all pairs
+UP_TEST( count_overlaps_all_pairs_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = random_spheres(2000, Scalar(20.0));
+    unsigned int ref_count = count_overlaps_all_pairs(snap);
+    UP_ASSERT(ref_count > 1);
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc = make_sphere_integrator(sysdef);
+
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, false), ref_count);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 1);
+    }
+
+//! Test that countOverlaps finds no overlaps in a lattice with spacing larger than the diameter
+UP_TEST( count_overlaps_lattice_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    const unsigned int n = 10;
+    const Scalar a = Scalar(1.05);
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap(new SnapshotSystemData<Scalar>());
+    snap->global_box = BoxDim(a*n);
+    snap->particle_data.type_mapping.push_back("A");
+    snap->particle_data.resize(n*n*n);
+    for (unsigned int i = 0; i < n; i++)
+        for (unsigned int j = 0; j < n; j++)
+            for (unsigned int k = 0; k < n; k++)
+                snap->particle_data.pos[(i*n + j)*n + k] = vec3<Scalar>(a*i, a*j, a*k) - vec3<Scalar>(1,1,1)*(a*n/Scalar(2.0));
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc = make_sphere_integrator(sysdef);
+
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, false), 0);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 0);
+    }
+
+#ifdef ENABLE_TBB
+//! Test that countOverlaps on several TBB threads agrees with a single thread
+UP_TEST( count_overlaps_threads_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = random_spheres(5000, Scalar(30.0));
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr< IntegratorHPMCMono<ShapeSphere> > mc = make_sphere_integrator(sysdef);
+
+    exec_conf->setNumThreads(1);
+    unsigned int count_serial = mc->countOverlaps(0, false);
+    UP_ASSERT(count_serial > 1);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 1);
+
+    exec_conf->setNumThreads(4);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, false), count_serial);
+    UP_ASSERT_EQUAL(mc->countOverlaps(0, true), 1);
+    }
+#endif
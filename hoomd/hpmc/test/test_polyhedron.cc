@@ -2,6 +2,7 @@
 #include "hoomd/hpmc/Moves.h"
 #include "hoomd/hpmc/ShapePolyhedron.h"
 #include "hoomd/AABBTree.h"
+#include "hoomd/Saru.h"
 #include "hoomd/extern/quickhull/QuickHull.hpp"
 
 #include "hoomd/test/upp11_config.h"
@@ -36,9 +37,9 @@ void set_radius(poly3d_data& data)
     data.convex_hull_verts.diameter = 2*(sqrt(radius_sq)+data.sweep_radius);
     }
 
-GPUTree build_tree(poly3d_data &data)
+// helper function to build the OBB tree of the faces
+void build_obb_tree(poly3d_data &data, OBBTree& tree, unsigned int capacity)
     {
-    OBBTree tree;
     hpmc::detail::OBB *obbs;
     int retval = posix_memalign((void**)&obbs, 32, sizeof(hpmc::detail::OBB)*data.n_faces);
     if (retval != 0)
@@ -64,11 +65,15 @@ GPUTree build_tree(poly3d_data &data)
         obbs[i] = hpmc::detail::compute_obb(face_vec, vertex_radii, false);
         internal_coordinates.push_back(face_vec);
         }
-    unsigned int capacity = 4;
     tree.buildTree(obbs, internal_coordinates, data.sweep_radius, data.n_faces, capacity);
-    GPUTree gpu_tree(tree);
     free(obbs);
-    return gpu_tree;
+    }
+
+GPUTree build_tree(poly3d_data &data)
+    {
+    OBBTree tree;
+    build_obb_tree(data, tree, 4);
+    return GPUTree(tree);
     }
 
 void initialize_convex_hull(poly3d_data &data)
@@ -82,6 +87,60 @@ void initialize_convex_hull(poly3d_data &data)
         }
     }
 
+// helper function to build a unit cube with every face split into n x n squares of two triangles
+poly3d_data make_tessellated_cube(unsigned int n)
+    {
+    unsigned int n_grid = (n+1)*(n+1);
+    poly3d_data data(6*n_grid, 12*n*n, 36*n*n, 6*n_grid, false);
+    data.sweep_radius=data.convex_hull_verts.sweep_radius=0.0f;
+
+    unsigned int face = 0;
+    for (unsigned int side = 0; side < 6; ++side)
+        {
+        // the face normal is along axis k, the grid spans the two other axes in right-handed order
+        unsigned int k = side % 3;
+        unsigned int u = (k+1) % 3;
+        unsigned int v = (k+2) % 3;
+        OverlapReal sign = side < 3 ? 1 : -1;
+
+        unsigned int offs = side*n_grid;
+        for (unsigned int i = 0; i <= n; ++i)
+            for (unsigned int j = 0; j <= n; ++j)
+                {
+                OverlapReal p[3];
+                p[k] = OverlapReal(0.5)*sign;
+                p[u] = OverlapReal(-0.5) + OverlapReal(i)/OverlapReal(n);
+                p[v] = OverlapReal(-0.5) + OverlapReal(j)/OverlapReal(n);
+                data.verts[offs + i*(n+1) + j] = vec3<OverlapReal>(p[0], p[1], p[2]);
+                }
+
+        for (unsigned int i = 0; i < n; ++i)
+            for (unsigned int j = 0; j < n; ++j)
+                {
+                unsigned int a = offs + i*(n+1) + j;
+                unsigned int b = a + (n+1);
+                unsigned int c = b + 1;
+                unsigned int d = a + 1;
+
+                // wind the triangles counterclockwise seen from the outside
+                unsigned int tri[2][3] = {{a, b, c}, {a, c, d}};
+                for (unsigned int t = 0; t < 2; ++t)
+                    {
+                    data.face_offs[face] = 3*face;
+                    data.face_verts[3*face] = tri[t][0];
+                    data.face_verts[3*face+1] = sign > 0 ? tri[t][1] : tri[t][2];
+                    data.face_verts[3*face+2] = sign > 0 ? tri[t][2] : tri[t][1];
+                    face++;
+                    }
+                }
+        }
+    data.face_offs[data.n_faces] = 3*data.n_faces;
+    data.ignore = 0;
+    set_radius(data);
+    initialize_convex_hull(data);
+    return data;
+    }
+
 UP_TEST( construction )
     {
     quat<Scalar> o(1.0, vec3<Scalar>(-3.0, 9.0, 6.0));
@@ -464,3 +523,94 @@ UP_TEST( overlap_octahedron_sphere )
     UP_ASSERT(test_overlap(r_ij,a,b,err_count));
     UP_ASSERT(test_overlap(-r_ij,b,a,err_count));
     }
+
+UP_TEST( obb_tree_parallel_build )
+    {
+    // enough faces that the top levels of the tree are built in parallel with TBB
+    poly3d_data data = make_tessellated_cube(7);
+    UP_ASSERT(data.n_faces > OBB_TREE_PARALLEL_MIN);
+
+    OBBTree tree_serial;
+    tree_serial.setParallelMinimum(0xffffffff);
+    build_obb_tree(data, tree_serial, 4);
+
+    OBBTree tree_parallel;
+    tree_parallel.setParallelMinimum(2);
+    build_obb_tree(data, tree_parallel, 4);
+
+    // the trees must be identical node by node
+    UP_ASSERT_EQUAL(tree_parallel.getNumNodes(), tree_serial.getNumNodes());
+    for (unsigned int i = 0; i < tree_serial.getNumNodes(); ++i)
+        {
+        const OBBNode& a = tree_serial.getNode(i);
+        const OBBNode& b = tree_parallel.getNode(i);
+
+        UP_ASSERT_EQUAL(b.left, a.left);
+        UP_ASSERT_EQUAL(b.right, a.right);
+        UP_ASSERT_EQUAL(b.parent, a.parent);
+        UP_ASSERT_EQUAL(b.escape, a.escape);
+        UP_ASSERT(b.particles == a.particles);
+
+        UP_ASSERT_EQUAL(b.obb.center.x, a.obb.center.x);
+        UP_ASSERT_EQUAL(b.obb.center.y, a.obb.center.y);
+        UP_ASSERT_EQUAL(b.obb.center.z, a.obb.center.z);
+        UP_ASSERT_EQUAL(b.obb.lengths.x, a.obb.lengths.x);
+        UP_ASSERT_EQUAL(b.obb.lengths.y, a.obb.lengths.y);
+        UP_ASSERT_EQUAL(b.obb.lengths.z, a.obb.lengths.z);
+        UP_ASSERT_EQUAL(b.obb.rotation.s, a.obb.rotation.s);
+        UP_ASSERT_EQUAL(b.obb.rotation.v.x, a.obb.rotation.v.x);
+        UP_ASSERT_EQUAL(b.obb.rotation.v.y, a.obb.rotation.v.y);
+        UP_ASSERT_EQUAL(b.obb.rotation.v.z, a.obb.rotation.v.z);
+        UP_ASSERT_EQUAL(b.obb.mask, a.obb.mask);
+        UP_ASSERT_EQUAL(b.obb.is_sphere, a.obb.is_sphere);
+        }
+    }
+
+UP_TEST( overlap_tessellated_cube_tree )
+    {
+    BoxDim box(100);
+    poly3d_data data = make_tessellated_cube(7);
+
+    // the shape with a multi level tree
+    ShapePolyhedron::param_type p = data;
+    p.tree = build_tree(data);
+
+    // the same shape with all faces in a single leaf, which tests every pair of faces
+    ShapePolyhedron::param_type p_leaf = data;
+    OBBTree tree_leaf;
+    build_obb_tree(data, tree_leaf, data.n_faces);
+    UP_ASSERT_EQUAL(tree_leaf.getNumNodes(), 1);
+    p_leaf.tree = GPUTree(tree_leaf);
+
+    hoomd::detail::Saru rng(11);
+    unsigned int n_overlap = 0;
+    for (unsigned int k = 0; k < 500; ++k)
+        {
+        quat<Scalar> o_a = generateRandomOrientation(rng);
+        quat<Scalar> o_b = generateRandomOrientation(rng);
+
+        // random directions and separations between the inscribed and the circumscribed sphere diameters
+        vec3<Scalar> dir(rng.s(-1.0,1.0), rng.s(-1.0,1.0), rng.s(-1.0,1.0));
+        dir = dir / sqrt(dot(dir, dir));
+        vec3<Scalar> r_ij = dir * rng.s(0.9, 1.8);
+
+        ShapePolyhedron a(o_a, p);
+        ShapePolyhedron b(o_b, p);
+        ShapePolyhedron a_leaf(o_a, p_leaf);
+        ShapePolyhedron b_leaf(o_b, p_leaf);
+
+        bool overlap = test_overlap(r_ij,a,b,err_count);
+        UP_ASSERT_EQUAL(overlap, test_overlap(r_ij,a_leaf,b_leaf,err_count));
+        UP_ASSERT_EQUAL(overlap, test_overlap(-r_ij,b,a,err_count));
+        if (overlap)
+            n_overlap++;
+
+        // cubes always overlap inside the inscribed sphere diameter and never outside the circumscribed one
+        UP_ASSERT(test_overlap(dir*Scalar(0.95),a,b,err_count));
+        UP_ASSERT(!test_overlap(dir*Scalar(1.75),a,b,err_count));
+        }
+
+    // both outcomes are sampled
+    UP_ASSERT(n_overlap > 0);
+    UP_ASSERT(n_overlap < 500);
+    }
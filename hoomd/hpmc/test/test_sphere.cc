@@ -8,6 +8,7 @@
 HOOMD_UP_MAIN();
 
 #include "hoomd/hpmc/ShapeSphere.h"
+#include "hoomd/hpmc/SweepDistance.h"
 
 #include <iostream>
 
@@ -109,3 +110,43 @@ UP_TEST( overlap_boundaries )
     UP_ASSERT(test_overlap(rij,a,c,err_count));
     UP_ASSERT(test_overlap(-rij,c,a,err_count));
     }
+
+UP_TEST( sweep_sphere )
+    {
+    quat<Scalar> o;
+    sph_params par;
+    par.radius = 0.5;
+    par.ignore = 0;
+    par.isOriented = false;
+    ShapeSphere a(o, par);
+    ShapeSphere b(o, par);
+
+    vec3<Scalar> x(1,0,0);
+    vec3<Scalar> n;
+
+    // head on collision
+    Scalar s = sweep_distance(vec3<Scalar>(3,0,0), a, b, x, Scalar(10.0), Scalar(0.01), err_count, n);
+    MY_CHECK_CLOSE(s, 2.0, tol);
+    MY_CHECK_CLOSE(n.x, 1.0, tol);
+
+    // off center collision, the touching spheres do not overlap
+    s = sweep_distance(vec3<Scalar>(3,0.6,0), a, b, x, Scalar(10.0), Scalar(0.01), err_count, n);
+    MY_CHECK_CLOSE(s, 2.2, tol);
+    MY_CHECK_CLOSE(n.x, 0.8, tol);
+    MY_CHECK_CLOSE(n.y, 0.6, tol);
+    UP_ASSERT(!test_overlap(vec3<Scalar>(3,0.6,0) - s*x, a, b, err_count));
+
+    // the spheres miss, move apart, or collide beyond the maximum distance
+    s = sweep_distance(vec3<Scalar>(3,1.5,0), a, b, x, Scalar(10.0), Scalar(0.01), err_count, n);
+    UP_ASSERT_EQUAL(s, Scalar(10.0));
+    s = sweep_distance(vec3<Scalar>(-3,0,0), a, b, x, Scalar(10.0), Scalar(0.01), err_count, n);
+    UP_ASSERT_EQUAL(s, Scalar(10.0));
+    s = sweep_distance(vec3<Scalar>(3,0,0), a, b, x, Scalar(1.5), Scalar(0.01), err_count, n);
+    UP_ASSERT_EQUAL(s, Scalar(1.5));
+
+    // the generic search agrees with the analytic collision
+    s = sweep_distance<ShapeSphere, ShapeSphere>(vec3<Scalar>(3,0.6,0), a, b, x, Scalar(10.0), Scalar(0.01),
+        err_count, n);
+    UP_ASSERT(fabs(s - 2.2) < 1e-4);
+    UP_ASSERT(!test_overlap(vec3<Scalar>(3,0.6,0) - s*x, a, b, err_count));
+    }
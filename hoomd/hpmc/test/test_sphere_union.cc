@@ -37,6 +37,7 @@ void build_tree(typename ShapeUnion<Shape>::param_type& data)
         {
         Shape dummy(quat<Scalar>(data.morientation[i]), data.mparams[i]);
         obbs[i] = OBB(dummy.getAABB(data.mpos[i]));
+        data.mradius[i] = OverlapReal(0.5)*dummy.getCircumsphereDiameter();
         }
 
     tree.buildTree(obbs, data.N, 4, true);
@@ -242,3 +243,91 @@ UP_TEST( overlapping_dumbbells )
     UP_ASSERT(test_overlap(r_b - r_a, a, b, err_count));
     UP_ASSERT(test_overlap(r_a - r_b, b, a, err_count));
     }
+
+//! Count the right-most ancestors of every node, like GPUTree::initializeAncestorCounts()
+void count_ancestors(const OBBTree& tree, unsigned int idx, unsigned int ancestors, std::vector<unsigned int>& count)
+    {
+    if (tree.getNodeLeft(idx) != OBB_INVALID_NODE)
+        {
+        count_ancestors(tree, tree.getNodeLeft(idx), 0, count);
+        count_ancestors(tree, tree.getNode(idx).right, ancestors+1, count);
+        }
+    count[idx] = ancestors;
+    }
+
+//! Check that the GPUTree node data decodes to that of the OBBTree
+void check_gpu_tree(const OBBTree& tree, const GPUTree& gpu_tree)
+    {
+    std::vector<unsigned int> ancestors(tree.getNumNodes());
+    count_ancestors(tree, 0, 0, ancestors);
+
+    UP_ASSERT_EQUAL(gpu_tree.getNumNodes(), tree.getNumNodes());
+    for (unsigned int i = 0; i < tree.getNumNodes(); ++i)
+        {
+        OBB obb = gpu_tree.getOBB(i);
+        UP_ASSERT_EQUAL(obb.isSphere(), tree.getNodeOBB(i).isSphere());
+        UP_ASSERT_EQUAL(obb.mask, tree.getNodeOBB(i).mask);
+        MY_CHECK_CLOSE(obb.lengths.x, tree.getNodeOBB(i).lengths.x, tol);
+        UP_ASSERT_EQUAL(gpu_tree.getNumAncestors(i), ancestors[i]);
+        UP_ASSERT_EQUAL(gpu_tree.getLeftChild(i), tree.getNodeLeft(i));
+        }
+    }
+
+UP_TEST( gpu_tree_packed_sphere_flag )
+    {
+    // a chain of spheres gives a tree with long runs of right-most ancestors
+    const unsigned int N = 64;
+    std::vector<OBB> leaves(N);
+    for (unsigned int i = 0; i < N; ++i)
+        leaves[i] = OBB(vec3<OverlapReal>(OverlapReal(i), OverlapReal(0.1)*i, 0), OverlapReal(0.5) + OverlapReal(0.01)*i);
+
+    // all nodes of a sphere tree have the sphere flag set in the packed ancestor count
+        {
+        std::vector<OBB> obbs(leaves);
+        OBBTree tree;
+        tree.buildTree(&obbs[0], N, 1, true);
+        GPUTree gpu_tree(tree);
+        check_gpu_tree(tree, gpu_tree);
+
+        unsigned int n_spheres = 0;
+        for (unsigned int i = 0; i < gpu_tree.getNumNodes(); ++i)
+            n_spheres += gpu_tree.getOBB(i).isSphere();
+        UP_ASSERT_EQUAL(n_spheres, gpu_tree.getNumNodes());
+        }
+
+    // nodes of a box tree do not
+        {
+        std::vector<OBB> obbs(N);
+        for (unsigned int i = 0; i < N; ++i)
+            obbs[i] = OBB(AABB(leaves[i].getPosition(), Scalar(0.5)));
+        OBBTree tree;
+        tree.buildTree(&obbs[0], N, 1, false);
+        GPUTree gpu_tree(tree);
+        check_gpu_tree(tree, gpu_tree);
+        }
+
+    // restoring a tree from its node data keeps the flag and the counts apart
+        {
+        std::vector<OBB> obbs(leaves);
+        OBBTree tree;
+        tree.buildTree(&obbs[0], N, 1, true);
+        GPUTree gpu_tree(tree);
+
+        std::vector<OBB> node_obbs;
+        std::vector<unsigned int> left, escape, ancestors, leaf_ptr, particles;
+        for (unsigned int i = 0; i < gpu_tree.getNumNodes(); ++i)
+            {
+            node_obbs.push_back(gpu_tree.getOBB(i));
+            left.push_back(gpu_tree.getLeftChild(i));
+            escape.push_back(gpu_tree.getEscapeIndex(i));
+            ancestors.push_back(gpu_tree.getNumAncestors(i));
+            leaf_ptr.push_back(particles.size());
+            for (int j = 0; j < gpu_tree.getNumParticles(i); ++j)
+                particles.push_back(gpu_tree.getParticle(i, j));
+            }
+        leaf_ptr.push_back(particles.size());
+
+        GPUTree restored(node_obbs, left, escape, ancestors, leaf_ptr, particles, 1);
+        check_gpu_tree(tree, restored);
+        }
+    }
@@ -432,3 +432,40 @@ UP_TEST( overlap_P4Nth_P2N )
     UP_ASSERT(test_overlap(-r_ij,b,a,err_count));
 
     }
+
+UP_TEST( volume_sphere )
+    {
+    quat<Scalar> o(1.0, vec3<Scalar>(0.0, 0.0, 0.0));
+
+    sphinx3d_params data;
+    data.N = 1;
+    data.diameter[0] = 2.0;
+    data.center[0] = vec3<Scalar>(0.0,0.0,0.0);
+    data.circumsphereDiameter = 2.0;
+    data.ignore = 0;
+
+    ShapeSphinx a(o, data);
+    MY_CHECK_CLOSE(a.getVolume(), 4.0/3.0*M_PI, tol);
+    }
+
+UP_TEST( seq2_any_matches_seq2 )
+    {
+    // one positive sphere of radius 1 at the origin against a set of positive and negative spheres on the z axis
+    OverlapReal bs[4] = {1, -1, 1, -1};
+    OverlapReal br[4] = {1, 1.21, 0.25, 4};
+    OverlapReal bx[4] = {0, 0, 0, 0};
+    OverlapReal by[4] = {0, 0, 0, 0};
+    OverlapReal bz[4];
+
+    for (unsigned int step = 0; step < 50; step++)
+        {
+        bool expected = false;
+        for (unsigned int k = 0; k < 4; k++)
+            {
+            bz[k] = OverlapReal(0.1)*step - OverlapReal(0.5)*k;
+            expected = expected || seq2(1, bs[k], 1, br[k], bz[k]*bz[k]);
+            }
+
+        UP_ASSERT_EQUAL(seq2_any(1, 1, 0, 0, 0, 4, bs, br, bx, by, bz), expected);
+        }
+    }
@@ -4,7 +4,7 @@
 """ HPMC updaters.
 """
 
-from . import _hpmc
+from ._extension import _hpmc
 from . import integrate
 from . import compute
 from hoomd import _hoomd
@@ -850,6 +850,16 @@ class clusters(_updater):
     The :py:class:`clusters` updater support TBB execution on multiple CPU cores. See :doc:`compiling` for more information on how
     to compile HOOMD with TBB support.
 
+    .. note::
+        In GPU simulations without depletants, the cluster moves are performed on the GPU. The sequence of moves differs from
+        the CPU implementation for the same seed. In MPI simulations, in boxes that are too small for the cell list, and
+        with depletants, :py:class:`clusters` runs on the CPU and the particle data is copied to the host and back on
+        every step that the updater runs. Choose a *period* large enough that this transfer does not dominate the run
+        time.
+
+    .. versionchanged:: 2.5
+        Cluster moves of hard shapes are performed on the GPU.
+
     Args:
         mc (:py:mod:`hoomd.hpmc.integrate`): MC integrator.
         seed (int): The seed of the pseudo-random number generator (Needs to be the same across partitions of the same Gibbs ensemble)
@@ -868,6 +878,9 @@ class clusters(_updater):
             hoomd.context.msg.warning("update.clusters: Must have a handle to an HPMC integrator.\n");
             return
 
+        if hoomd.context.exec_conf.isCUDAEnabled() and mc.implicit:
+            hoomd.context.msg.warning("update.clusters: Cluster moves with depletants are performed on the CPU, particle data is copied between host and device every {} steps.\n".format(period));
+
         # initialize base class
         _updater.__init__(self);
 
@@ -954,7 +967,17 @@ class clusters(_updater):
                 else:
                     raise RuntimeError("Unsupported integrator.\n");
 
-        self.cpp_updater = cls(hoomd.context.current.system_definition, mc.cpp_integrator, int(seed))
+        gpu_cls = None;
+        if not mc.implicit and hoomd.context.exec_conf.isCUDAEnabled():
+            gpu_cls = getattr(_hpmc, cls.__name__.replace('UpdaterClusters', 'UpdaterClustersGPU'), None);
+
+        if gpu_cls is not None:
+            # the GPU updater keeps its own cell list of the old and new configurations
+            cl_c = _hoomd.CellListGPU(hoomd.context.current.system_definition);
+            hoomd.context.current.system.overwriteCompute(cl_c, "auto_cl_clusters")
+            self.cpp_updater = gpu_cls(hoomd.context.current.system_definition, mc.cpp_integrator, cl_c, int(seed))
+        else:
+            self.cpp_updater = cls(hoomd.context.current.system_definition, mc.cpp_integrator, int(seed))
 
         # register the clusters updater
         self.setupUpdater(period)
@@ -59,6 +59,9 @@ def create_lattice(unitcell, n):
 
         hoomd.init.create_lattice(unitcell=hoomd.lattice.hex(a=1.0),
                                   n=[100,58]);
+
+    In MPI simulations, every rank generates only the lattice sites inside its own domain. The tags of the particles
+    are the same as in a single rank simulation.
     """
     hoomd.util.print_status_line();
 
@@ -82,16 +85,95 @@ def create_lattice(unitcell, n):
         hoomd.context.msg.error("n must have length equal to the number of dimensions in the unit cell\n");
         raise RuntimeError("Error initializing");
 
-    if snap.box.dimensions == 3:
-        snap.replicate(n[0],n[1],n[2])
     if snap.box.dimensions == 2:
-        snap.replicate(n[0],n[1],1)
-
-    read_snapshot(snapshot=snap);
+        n = [n[0], n[1], 1];
+
+    if _hoomd.is_MPI_available() and hoomd.context.exec_conf.getNRanks() > 1:
+        # every rank replicates the unit cell into its own domain
+        snap._broadcast_box(hoomd.context.exec_conf);
+        b = snap.box;
+        box = hoomd.data.boxdim(Lx=b.Lx*n[0], Ly=b.Ly*n[1], Lz=b.Lz*n[2], xy=b.xy, xz=b.xz, yz=b.yz, dimensions=b.dimensions);
+        my_domain_decomposition = _create_domain_decomposition(box._getBoxDim());
+        snap._replicate_distributed(n[0], n[1], n[2], my_domain_decomposition, hoomd.context.exec_conf);
+
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snap, hoomd.context.exec_conf, my_domain_decomposition);
+        hoomd.context.current.system = _hoomd.System(hoomd.context.current.system_definition, 0);
+        _perform_common_init_tasks();
+    else:
+        snap.replicate(n[0],n[1],n[2])
+        read_snapshot(snapshot=snap);
 
     hoomd.util.unquiet_status();
     return hoomd.data.system_data(hoomd.context.current.system_definition);
 
+def create_random(N, box, diameter=1.0, name='A', seed=1, max_sweeps=1000):
+    R""" Place particles at random without overlaps.
+
+    Args:
+        N (int): Number of particles to place.
+        box (:py:class:`hoomd.data.boxdim`): Simulation box.
+        diameter (float): Minimum distance between the centers of two particles (in distance units).
+        name (str): Name of the particle type.
+        seed (int): Random seed.
+        max_sweeps (int): Maximum number of sweeps over the box.
+
+    :py:func:`create_random` places *N* particles of type *name* in *box* by random sequential addition. A candidate
+    position is rejected when it is closer than *diameter* to a particle placed before. The box is divided into cells
+    that hold at most one particle, and all cells far enough apart from each other draw and test their candidates at
+    the same time, on the GPU in one thread per cell. The placement only depends on *seed*, not on the device.
+
+    In MPI simulations, every rank places its share of the particles in its own domain and writes them straight into
+    its local particle data. No rank ever holds the whole system, so very large systems can be initialized.
+
+    Random sequential addition jams well below close packing, at a packing fraction of about 0.38 in 3D and 0.55 in 2D.
+    Initialize denser systems at a lower density and compress them, for example with
+    :py:class:`hoomd.hpmc.util.compress` or :py:class:`hoomd.update.box_resize` and a soft potential.
+    :py:func:`create_random` raises an error when it could not place all particles in *max_sweeps* sweeps.
+
+    Example::
+
+        hoomd.init.create_random(N=100000, box=hoomd.data.boxdim(L=80), diameter=1.0, seed=42)
+
+    .. versionadded:: 2.5
+    """
+    hoomd.util.print_status_line();
+
+    hoomd.context._verify_init();
+
+    # check if initialization has already occurred
+    if is_initialized():
+        hoomd.context.msg.error("Cannot initialize more than once\n");
+        raise RuntimeError("Error initializing");
+
+    if not isinstance(box, hoomd.data.boxdim):
+        hoomd.context.msg.error('box must be a data.boxdim object');
+        raise TypeError('box must be a data.boxdim object');
+
+    if hoomd.context.exec_conf.isCUDAEnabled():
+        generator = _hoomd.RandomSequentialAdditionGPU(hoomd.context.exec_conf, box._getBoxDim(), box.dimensions, float(diameter), int(seed));
+    else:
+        generator = _hoomd.RandomSequentialAddition(hoomd.context.exec_conf, box._getBoxDim(), box.dimensions, float(diameter), int(seed));
+
+    # generate the particles, on every rank in its own domain when there is more than one
+    my_domain_decomposition = _create_domain_decomposition(box._getBoxDim());
+    if my_domain_decomposition is not None:
+        generator.generateDistributed(int(N), int(max_sweeps), my_domain_decomposition);
+    else:
+        generator.generate(int(N), int(max_sweeps));
+
+    snapshot = generator.getSnapshot(name);
+
+    if my_domain_decomposition is not None:
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition);
+    else:
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf);
+
+    # initialize the system
+    hoomd.context.current.system = _hoomd.System(hoomd.context.current.system_definition, 0);
+
+    _perform_common_init_tasks();
+    return hoomd.data.system_data(hoomd.context.current.system_definition);
+
 def read_getar(filename, modes={'any': 'any'}):
     """Initialize a system from a trajectory archive (.tar, .getar,
     .sqlite) file. Returns a HOOMD `system_data` object.
@@ -189,7 +271,7 @@ def read_getar(filename, modes={'any': 'any'}):
     except AttributeError:
         box = snapshot.box;
 
-    my_domain_decomposition = _create_domain_decomposition(box);
+    my_domain_decomposition = _create_domain_decomposition(box, snapshot);
     if my_domain_decomposition is not None:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(
             snapshot, hoomd.context.exec_conf, my_domain_decomposition);
@@ -240,7 +322,7 @@ def read_snapshot(snapshot):
 
     # broadcast snapshot metadata so that all ranks have _global_box (the user may have set box only on rank 0)
     snapshot._broadcast_box(hoomd.context.exec_conf);
-    my_domain_decomposition = _create_domain_decomposition(snapshot._global_box);
+    my_domain_decomposition = _create_domain_decomposition(snapshot._global_box, snapshot);
 
     if my_domain_decomposition is not None:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition);
@@ -253,7 +335,7 @@ def read_snapshot(snapshot):
     _perform_common_init_tasks();
     return hoomd.data.system_data(hoomd.context.current.system_definition);
 
-def read_gsd(filename, restart = None, frame = 0, time_step = None):
+def read_gsd(filename, restart = None, frame = 0, time_step = None, parallel_io = False):
     R""" Read initial system state from an GSD file.
 
     Args:
@@ -261,6 +343,7 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
         restart (str): If it exists, read the file *restart* instead of *filename*.
         frame (int): Index of the frame to read from the GSD file. Negative values index from the end of the file.
         time_step (int): (if specified) Time step number to initialize instead of the one stored in the GSD file.
+        parallel_io (bool): When True, every MPI rank reads a part of the particles from the file. (added in version 2.5)
 
     All particles, bonds, angles, dihedrals, impropers, constraints, and box information
     are read from the given GSD file at the given frame index. To read and write GSD files
@@ -276,6 +359,10 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     The result of :py:func:`hoomd.init.read_gsd` can be saved in a variable and later used to read and/or
     change particle properties later in the script. See :py:mod:`hoomd.data` for more information.
 
+    In MPI simulations, rank 0 reads the whole system and distributes it to the other ranks by default. With
+    *parallel_io*, every rank reads an equal share of the particles and the particles are sent directly to the ranks
+    that own their domains, so no rank needs memory for the entire system. Topology is still read by rank 0.
+
     See Also:
         :py:class:`hoomd.dump.gsd`
     """
@@ -292,10 +379,10 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     restart = _hoomd.mpi_bcast_str(restart, hoomd.context.exec_conf);
 
     if restart is not None and os.path.exists(restart):
-        reader = _hoomd.GSDReader(hoomd.context.exec_conf, restart, abs(frame), frame < 0);
+        reader = _hoomd.GSDReader(hoomd.context.exec_conf, restart, abs(frame), frame < 0, parallel_io);
         time_step = reader.getTimeStep();
     else:
-        reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, abs(frame), frame < 0);
+        reader = _hoomd.GSDReader(hoomd.context.exec_conf, filename, abs(frame), frame < 0, parallel_io);
         if time_step is None:
             time_step = reader.getTimeStep();
 
@@ -303,7 +390,7 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
 
     # broadcast snapshot metadata so that all ranks have _global_box (the user may have set box only on rank 0)
     snapshot._broadcast_box(hoomd.context.exec_conf);
-    my_domain_decomposition = _create_domain_decomposition(snapshot._global_box);
+    my_domain_decomposition = _create_domain_decomposition(snapshot._global_box, snapshot);
 
     if my_domain_decomposition is not None:
         hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition);
@@ -318,6 +405,79 @@ def read_gsd(filename, restart = None, frame = 0, time_step = None):
     hoomd.context.current.state_reader.clearSnapshot();
     return hoomd.data.system_data(hoomd.context.current.system_definition);
 
+def read_checkpoint(filename, time_step = None):
+    R""" Read the system state from a checkpoint.
+
+    Args:
+        filename (str): Index file of the checkpoint.
+        time_step (int): (if specified) Time step number to initialize instead of the one stored in the checkpoint.
+
+    :py:func:`hoomd.init.read_checkpoint` reads a checkpoint written by :py:class:`hoomd.dump.checkpoint` with all
+    particle properties, the topology, the box and the integrator variables. Integration methods and HPMC integrators
+    that are created in the same order as in the job that wrote the checkpoint continue with its thermostat,
+    barostat and move size state. The move sizes of the checkpoint replace those set in the script before the first
+    :py:func:`hoomd.run`.
+
+    In MPI simulations, every rank reads the particles directly from the shards. When the job runs on the same number
+    of ranks as the one that wrote the checkpoint and no :py:class:`hoomd.comm.decomposition` is set, the domain
+    decomposition of the writing job is restored and every rank reads the shard of its own domain. Otherwise, the
+    ranks read an equal share of the shards and the particles are sent to the ranks that own their domains.
+    Topology is read by rank 0.
+
+    The result of :py:func:`hoomd.init.read_checkpoint` can be saved in a variable and later used to read and/or
+    change particle properties later in the script. See :py:mod:`hoomd.data` for more information.
+
+    Example::
+
+        if os.path.exists("restart.chk"):
+            system = init.read_checkpoint("restart.chk");
+        else:
+            system = init.read_gsd("init.gsd");
+
+    See Also:
+        :py:class:`hoomd.dump.checkpoint`
+    """
+    hoomd.util.print_status_line();
+
+    hoomd.context._verify_init();
+
+    # check if initialization has already occurred
+    if is_initialized():
+        hoomd.context.msg.error("Cannot initialize more than once\n");
+        raise RuntimeError("Error initializing");
+
+    filename = _hoomd.mpi_bcast_str(filename, hoomd.context.exec_conf);
+
+    reader = _hoomd.CheckpointReader(hoomd.context.exec_conf, filename);
+    if time_step is None:
+        time_step = reader.getTimeStep();
+
+    snapshot = reader.getSnapshot();
+
+    # restore the decomposition of the writing job, so that every rank reads the shard of its own domain
+    n_ranks = hoomd.context.exec_conf.getNRanks();
+    if _hoomd.is_MPI_available() and n_ranks > 1 and hoomd.context.current.decomposition is None and reader.getNumShards() == n_ranks:
+        hoomd.util.quiet_status();
+        hoomd.comm.decomposition(x=list(reader.getDomainFractions(0)),
+                                 y=list(reader.getDomainFractions(1)),
+                                 z=list(reader.getDomainFractions(2)));
+        hoomd.util.unquiet_status();
+
+    my_domain_decomposition = _create_domain_decomposition(snapshot._global_box);
+
+    if my_domain_decomposition is not None:
+        reader.readDistributedParticles(my_domain_decomposition);
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf, my_domain_decomposition);
+    else:
+        reader.readParticles();
+        hoomd.context.current.system_definition = _hoomd.SystemDefinition(snapshot, hoomd.context.exec_conf);
+
+    # initialize the system
+    hoomd.context.current.system = _hoomd.System(hoomd.context.current.system_definition, time_step);
+
+    _perform_common_init_tasks();
+    return hoomd.data.system_data(hoomd.context.current.system_definition);
+
 def restore_getar(filename, modes={'any': 'any'}):
     """Restore a subset of the current system's parameters from a
     trajectory archive (.tar, .zip, .sqlite) file. For a detailed
@@ -358,18 +518,37 @@ def _perform_common_init_tasks():
     if _hoomd.is_MPI_available():
         cpp_decomposition = hoomd.context.current.system_definition.getParticleData().getDomainDecomposition();
         if cpp_decomposition is not None:
+            # find the owners of particles with the distributed tag directory
+            if hoomd.context.current.decomposition is not None and hoomd.context.current.decomposition.tag_directory:
+                hoomd.context.current.system_definition.getParticleData().setTagDirectory(True)
+
             # create the c++ Communicator
             if not hoomd.context.exec_conf.isCUDAEnabled():
                 cpp_communicator = _hoomd.Communicator(hoomd.context.current.system_definition, cpp_decomposition)
+                if hoomd.context.options.persistent_mpi is not None:
+                    cpp_communicator.setPersistentMPI(hoomd.context.options.persistent_mpi == 'on')
+                if hoomd.context.options.compress_ghosts is not None:
+                    cpp_communicator.setGhostPositionCompression(hoomd.context.options.compress_ghosts == 'on')
+                if hoomd.context.options.shared_mem_ghosts == 'on':
+                    cpp_communicator.setNodeSharedMemory(True)
+                if hoomd.context.options.sort_ghosts == 'on':
+                    cpp_communicator.setGhostSorting(True)
+                if hoomd.context.current.decomposition is not None and hoomd.context.current.decomposition.half_shell:
+                    cpp_communicator.setHalfShell(True)
             else:
                 cpp_communicator = _hoomd.CommunicatorGPU(hoomd.context.current.system_definition, cpp_decomposition)
+                if hoomd.context.options.cuda_aware_mpi is not None:
+                    cpp_communicator.setCudaAwareMPI(hoomd.context.options.cuda_aware_mpi == 'on')
+
+            if hoomd.context.options.migrate_buffer is not None:
+                cpp_communicator.setMigrationBuffer(hoomd.context.options.migrate_buffer)
 
             # set Communicator in C++ System
             hoomd.context.current.system.setCommunicator(cpp_communicator)
 
 ## Create a DomainDecomposition object
 # \internal
-def _create_domain_decomposition(box):
+def _create_domain_decomposition(box, snapshot=None):
     if not _hoomd.is_MPI_available():
         return None
 
@@ -385,7 +564,13 @@ def _create_domain_decomposition(box):
         hoomd.context.current.decomposition = hoomd.comm.decomposition()
         hoomd.util.unquiet_status()
 
-    return hoomd.context.current.decomposition._make_cpp_decomposition(box)
+    cpp_decomposition = hoomd.context.current.decomposition._make_cpp_decomposition(box)
+
+    # place the cut planes by bisection of the initial particle distribution
+    if hoomd.context.current.decomposition.bisect and snapshot is not None:
+        hoomd.context.current.decomposition._bisect_particles(snapshot)
+
+    return cpp_decomposition
 
 def _parse_getar_modes(modes):
     newModes = {}
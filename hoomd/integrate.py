@@ -74,6 +74,10 @@ class _integrator(hoomd.meta._metadata):
         self.cpp_integrator = None;
         self.supports_methods = False;
 
+        # forces are summed into the net force after they are computed, unless they may add to it directly
+        self.accumulate_net_force = False;
+        self.slow_forces = [];
+
         # save ourselves in the global variable
         hoomd.context.current.integrator = self;
 
@@ -103,6 +107,12 @@ class _integrator(hoomd.meta._metadata):
     def update_forces(self):
         self.check_initialization();
 
+        # the quantities that are logged, forces providing any of them keep their own force arrays
+        logged = set();
+        for a in hoomd.context.current.analyzers:
+            if isinstance(a, hoomd.analyze.log):
+                logged.update(a.quantities);
+
         # set the forces
         self.cpp_integrator.removeForceComputes();
         for f in hoomd.context.current.forces:
@@ -113,6 +123,10 @@ class _integrator(hoomd.meta._metadata):
             if f.log or f.enabled:
                 f.update_coeffs();
 
+            accumulate = (self.accumulate_net_force and f.enabled and not f in self.slow_forces
+                          and logged.isdisjoint(f.cpp_force.getProvidedLogQuantities()));
+            f.cpp_force.setAccumulateNetForce(accumulate);
+
             if f.enabled:
                 self.cpp_integrator.addForceCompute(f.cpp_force);
 
@@ -166,6 +180,11 @@ class _integrator(hoomd.meta._metadata):
             ndof_rot = self.cpp_integrator.getRotationalNDOF(t.group.cpp_group);
             t.cpp_compute.setRotationalNDOF(ndof_rot);
 
+        for t in hoomd.context.current.thermo_multis:
+            for i,g in enumerate(t.groups):
+                t.cpp_compute.setNDOF(i, self.cpp_integrator.getNDOF(g.cpp_group));
+                t.cpp_compute.setRotationalNDOF(i, self.cpp_integrator.getRotationalNDOF(g.cpp_group));
+
     @classmethod
     def _gsd_state_name(cls):
         raise NotImplementedError("GSD Schema is not implemented for {}".format(cls.__name__));
@@ -0,0 +1,168 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _EVALUATOR_PAIR_JIT_H_
+#define _EVALUATOR_PAIR_JIT_H_
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/md/PairEvaluatorBatch.h"
+
+#include "PairEvalFactory.h"
+
+#include <cassert>
+
+/*! \file EvaluatorPairJIT.h
+    \brief Defines the pair evaluator of pair potentials that are compiled at run time
+*/
+
+//! Maximum number of parameters per type pair of a JIT pair potential
+#define PAIR_JIT_MAX_PARAMS 8
+
+//! Per type pair parameters of a JIT pair potential
+/*! The parameter array directly follows the function pointer, so that the parameters of consecutive type pairs in
+    an array of pair_jit_params are PAIR_JIT_PARAM_STRIDE doubles apart.
+*/
+struct pair_jit_params
+    {
+    PairEvalFactory::EvalBatchFnPtr eval_batch; //!< Batched evaluator compiled from the user code
+    double p[PAIR_JIT_MAX_PARAMS];              //!< Parameters of the type pair
+    };
+
+//! Distance between the parameters of consecutive pair_jit_params, in doubles
+#define PAIR_JIT_PARAM_STRIDE (sizeof(pair_jit_params)/sizeof(double))
+
+static_assert(sizeof(pair_jit_params) % sizeof(double) == 0, "pair_jit_params must be padded to whole doubles");
+
+//! Evaluate a batch of pairs with the compiled code
+/*! \param n Number of pairs
+    \param rsq Squared distances
+    \param rcutsq Squared cutoff radii
+    \param params Per type pair parameters of each pair, all with the same evaluator
+    \param energy_shift If true, the potential is shifted so that V(r) is continuous at the cutoff
+    \param force_divr Output force divided by r
+    \param pair_eng Output pair energy
+
+    The compiled code works in double precision, in single precision builds the batch is converted.
+*/
+inline void evalPairJIT(unsigned int n,
+                        const Scalar *rsq,
+                        const Scalar *rcutsq,
+                        const pair_jit_params *params,
+                        bool energy_shift,
+                        Scalar *force_divr,
+                        Scalar *pair_eng)
+    {
+    #ifdef SINGLE_PRECISION
+    assert(n <= HOOMD_PAIR_BATCH_SIZE);
+    double rsq_d[HOOMD_PAIR_BATCH_SIZE];
+    double rcutsq_d[HOOMD_PAIR_BATCH_SIZE];
+    double force_divr_d[HOOMD_PAIR_BATCH_SIZE];
+    double pair_eng_d[HOOMD_PAIR_BATCH_SIZE];
+    for (unsigned int k = 0; k < n; ++k)
+        {
+        rsq_d[k] = rsq[k];
+        rcutsq_d[k] = rcutsq[k];
+        }
+
+    params[0].eval_batch(n, rsq_d, rcutsq_d, params[0].p, PAIR_JIT_PARAM_STRIDE, energy_shift, force_divr_d, pair_eng_d);
+
+    for (unsigned int k = 0; k < n; ++k)
+        {
+        force_divr[k] = Scalar(force_divr_d[k]);
+        pair_eng[k] = Scalar(pair_eng_d[k]);
+        }
+    #else
+    params[0].eval_batch(n, rsq, rcutsq, params[0].p, PAIR_JIT_PARAM_STRIDE, energy_shift, force_divr, pair_eng);
+    #endif
+    }
+
+//! Class for evaluating pair potentials compiled at run time
+/*! The force and energy are computed by the eval_batch function of an LLVM module (see PairEvalFactory), which is
+    stored in the parameters of every type pair together with up to PAIR_JIT_MAX_PARAMS coefficients. PotentialPair
+    calls it once per batch of neighbors through the PairEvaluatorBatch specialization below, so that the user code is
+    inlined into a loop over the whole batch.
+*/
+class EvaluatorPairJIT
+    {
+    public:
+        //! Define the parameter type used by this pair potential evaluator
+        typedef pair_jit_params param_type;
+
+        //! Constructs the pair potential evaluator
+        /*! \param _rsq Squared distance between the particles
+            \param _rcutsq Squared distance at which the potential goes to 0
+            \param _params Per type pair parameters of this potential
+        */
+        EvaluatorPairJIT(Scalar _rsq, Scalar _rcutsq, const param_type& _params)
+            : rsq(_rsq), rcutsq(_rcutsq), params(_params)
+            {
+            }
+
+        //! JIT pair potentials don't use diameter
+        static bool needsDiameter() { return false; }
+        //! Accept the optional diameter values
+        /*! \param di Diameter of particle i
+            \param dj Diameter of particle j
+        */
+        void setDiameter(Scalar di, Scalar dj) { }
+
+        //! JIT pair potentials don't use charge
+        static bool needsCharge() { return false; }
+        //! Accept the optional charge values
+        /*! \param qi Charge of particle i
+            \param qj Charge of particle j
+        */
+        void setCharge(Scalar qi, Scalar qj) { }
+
+        //! Evaluate the force and energy
+        /*! \param force_divr Output parameter to write the computed force divided by r.
+            \param pair_eng Output parameter to write the computed pair energy
+            \param energy_shift If true, the potential must be shifted so that V(r) is continuous at the cutoff
+
+            \return True if they are evaluated or false if they are not because we are beyond the cutoff
+        */
+        bool evalForceAndEnergy(Scalar& force_divr, Scalar& pair_eng, bool energy_shift)
+            {
+            if (rsq < rcutsq)
+                {
+                evalPairJIT(1, &rsq, &rcutsq, &params, energy_shift, &force_divr, &pair_eng);
+                return true;
+                }
+            else
+                return false;
+            }
+
+        //! Get the name of this potential
+        /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
+            via analyze.log.
+        */
+        static std::string getName()
+            {
+            return std::string("jit");
+            }
+
+    protected:
+        Scalar rsq;                 //!< Stored rsq from the constructor
+        Scalar rcutsq;              //!< Stored rcutsq from the constructor
+        param_type params;          //!< Parameters and evaluator of the type pair
+    };
+
+//! Batched evaluation of the JIT pair potentials
+template<>
+struct PairEvaluatorBatch<EvaluatorPairJIT>
+    {
+    static const bool enabled = true;
+
+    static void evalForceAndEnergy(unsigned int n,
+                                   const Scalar *rsq,
+                                   const Scalar *rcutsq,
+                                   const pair_jit_params *params,
+                                   bool energy_shift,
+                                   Scalar *force_divr,
+                                   Scalar *pair_eng)
+        {
+        evalPairJIT(n, rsq, rcutsq, params, energy_shift, force_divr, pair_eng);
+        }
+    };
+
+#endif // _EVALUATOR_PAIR_JIT_H_
@@ -22,6 +22,7 @@ ExternalFieldEvalFactory::ExternalFieldEvalFactory(const std::string& llvm_ir)
     {
     // set to null pointer
     m_eval = NULL;
+    m_eval_batch = NULL;
 
     // initialize LLVM
     std::ostringstream sstream;
@@ -78,5 +79,17 @@ ExternalFieldEvalFactory::ExternalFieldEvalFactory(const std::string& llvm_ir)
     m_eval = (ExternalFieldEvalFnPtr) eval.getAddress();
     #endif
 
+    // the batched evaluator is optional, user provided IR files may only define eval
+    auto eval_batch = m_jit->findSymbol("eval_batch");
+
+    if (eval_batch)
+        {
+        #if defined LLVM_VERSION_MAJOR && LLVM_VERSION_MAJOR >= 5
+        m_eval_batch = (ExternalFieldEvalBatchFnPtr)(long unsigned int)(cantFail(eval_batch.getAddress()));
+        #else
+        m_eval_batch = (ExternalFieldEvalBatchFnPtr) eval_batch.getAddress();
+        #endif
+        }
+
     llvm_err.flush();
     }
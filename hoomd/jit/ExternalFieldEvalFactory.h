@@ -21,6 +21,14 @@ class ExternalFieldEvalFactory
             Scalar charge
             );
 
+        typedef void (*ExternalFieldEvalBatchFnPtr)(unsigned int n,
+            const BoxDim& box,
+            const Scalar4 *postype,
+            const Scalar4 *orientation,
+            const Scalar *diameter,
+            const Scalar *charge,
+            float *u);
+
         //! Constructor
         ExternalFieldEvalFactory(const std::string& llvm_ir);
 
@@ -30,6 +38,12 @@ class ExternalFieldEvalFactory
             return m_eval;
             }
 
+        //! Return the batched evaluator, NULL if the module does not provide one
+        ExternalFieldEvalBatchFnPtr getEvalBatch()
+            {
+            return m_eval_batch;
+            }
+
         //! Get the error message from initialization
         const std::string& getError()
             {
@@ -39,6 +53,7 @@ class ExternalFieldEvalFactory
     private:
         std::unique_ptr<llvm::orc::KaleidoscopeJIT> m_jit; //!< The persistent JIT engine
         ExternalFieldEvalFnPtr m_eval;         //!< Function pointer to evaluator
+        ExternalFieldEvalBatchFnPtr m_eval_batch; //!< Function pointer to the batched evaluator (optional)
 
         std::string m_error_msg; //!< The error message if initialization fails
     };
@@ -7,10 +7,15 @@
 #include "hoomd/hpmc/ExternalField.h"
 #include "hoomd/BoxDim.h"
 
+#include <algorithm>
+
 #include "ExternalFieldEvalFactory.h"
 
 #define EXTERNAL_FIELD_JIT_LOG_NAME           "jit_energy"
 
+//! Number of particles evaluated per call to the batched evaluator
+#define EXTERNAL_FIELD_JIT_BATCH_SIZE         128
+
 //! Evaluate external field forces via runtime generated code
 /*! This class enables the widest possible use-cases of external fields in HPMC with low energy barriers for users to add
     custom forces that execute with high performance. It provides a generic interface for returning the energy of
@@ -27,6 +32,10 @@
 
     LLVM JIT is capable of calling any function in the hosts address space. ExternalFieldJIT does not take advantage of
     that, limiting the user to a very specific API for computing the energy between a pair of particles.
+
+    When the module also defines 'eval_batch', the energies of the whole system (used for box moves, the Boltzmann
+    weight, and logging) are evaluated in packets of EXTERNAL_FIELD_JIT_BATCH_SIZE particles read directly from the
+    particle data arrays, so that LLVM can inline and vectorize eval over the packet.
 */
 template< class Shape>
 class ExternalFieldJIT : public hpmc::ExternalFieldMono<Shape>
@@ -40,6 +49,7 @@ class ExternalFieldJIT : public hpmc::ExternalFieldMono<Shape>
 
             // get the evaluator
             m_eval = m_factory->getEval();
+            m_eval_batch = m_factory->getEvalBatch();
 
             if (!m_eval)
                 {
@@ -97,17 +107,9 @@ class ExternalFieldJIT : public hpmc::ExternalFieldMono<Shape>
                 box_old = &box_new;
                 }
 
-            double dE = 0.0;
-            for(size_t i = 0; i < this->m_pdata->getN(); i++)
-                {
-                // read in the current position and orientation
-                Scalar4 postype_i = h_postype.data[i];
-                unsigned int typ_i = __scalar_as_int(postype_i.w);
-                vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
-                
-                dE += energy(box_new, typ_i, pos_i, quat<Scalar>(h_orientation.data[i]), h_diameter.data[i], h_charge.data[i]);
-                dE -= energy(*box_old, typ_i, vec3<Scalar>(*(position_old+i)), quat<Scalar>(*(orientation_old+i)), h_diameter.data[i], h_charge.data[i]);
-                }
+            const unsigned int N = this->m_pdata->getN();
+            double dE = computeTotalEnergy(box_new, h_postype.data, h_orientation.data, h_diameter.data, h_charge.data, N);
+            dE -= computeTotalEnergy(*box_old, position_old, orientation_old, h_diameter.data, h_charge.data, N);
 
             #ifdef ENABLE_MPI
             if (this->m_pdata->getDomainDecomposition())
@@ -119,6 +121,31 @@ class ExternalFieldJIT : public hpmc::ExternalFieldMono<Shape>
             return dE;
             }
 
+        //! Compute the Boltzmann weight exp(-U) of the current configuration
+        Scalar calculateBoltzmannWeight(unsigned int timestep)
+            {
+            ArrayHandle<Scalar4> h_postype(this->m_pdata->getPositions(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar4> h_orientation(this->m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_diameter(this->m_pdata->getDiameters(), access_location::host, access_mode::read);
+            ArrayHandle<Scalar> h_charge(this->m_pdata->getCharges(), access_location::host, access_mode::read);
+
+            double E = computeTotalEnergy(this->m_pdata->getGlobalBox(),
+                                          h_postype.data,
+                                          h_orientation.data,
+                                          h_diameter.data,
+                                          h_charge.data,
+                                          this->m_pdata->getN());
+
+            #ifdef ENABLE_MPI
+            if (this->m_pdata->getDomainDecomposition())
+                {
+                MPI_Allreduce(MPI_IN_PLACE, &E, 1, MPI_DOUBLE, MPI_SUM, this->m_exec_conf->getMPICommunicator());
+                }
+            #endif
+
+            return exp(-E);
+            }
+
         //! method to calculate the energy difference for the proposed move.
         double energydiff(const unsigned int& index, const vec3<Scalar>& position_old, const Shape& shape_old, const vec3<Scalar>& position_new, const Shape& shape_new)
             {
@@ -155,18 +182,12 @@ class ExternalFieldJIT : public hpmc::ExternalFieldMono<Shape>
 
                 const BoxDim& box = this->m_pdata->getGlobalBox();
 
-                double dE = 0.0;
-                for(size_t i = 0; i < this->m_pdata->getN(); i++)
-                    {
-                    // read in the current position and orientation
-                    Scalar4 postype_i = h_postype.data[i];
-                    unsigned int typ_i = __scalar_as_int(postype_i.w);
-                    vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
-
-                    dE += energy(box, typ_i, pos_i, quat<Scalar>(h_orientation.data[i]), h_diameter.data[i], h_charge.data[i]);
-                    }
-
-                return dE;
+                return computeTotalEnergy(box,
+                                          h_postype.data,
+                                          h_orientation.data,
+                                          h_diameter.data,
+                                          h_charge.data,
+                                          this->m_pdata->getN());
                 }
             else
                 {
@@ -176,10 +197,55 @@ class ExternalFieldJIT : public hpmc::ExternalFieldMono<Shape>
             }
 
     protected:
+        //! Evaluate the total energy of a set of particles
+        /*! \param box The system box.
+            \param postype Particle positions and types.
+            \param orientation Particle orientations.
+            \param diameter Particle diameters.
+            \param charge Particle charges.
+            \param N Number of particles.
+            \returns Total energy of the particles in the field
+
+            Calls the eval_batch loop compiled into the JIT module on packets of particles, and falls back to calling
+            eval once per particle when the module does not define eval_batch. The energies are summed in double
+            precision.
+        */
+        double computeTotalEnergy(const BoxDim& box,
+            const Scalar4 *postype,
+            const Scalar4 *orientation,
+            const Scalar *diameter,
+            const Scalar *charge,
+            unsigned int N)
+            {
+            double E = 0.0;
+            if (m_eval_batch)
+                {
+                float u[EXTERNAL_FIELD_JIT_BATCH_SIZE];
+                for (unsigned int start = 0; start < N; start += EXTERNAL_FIELD_JIT_BATCH_SIZE)
+                    {
+                    unsigned int n = std::min(N - start, (unsigned int)EXTERNAL_FIELD_JIT_BATCH_SIZE);
+                    m_eval_batch(n, box, postype + start, orientation + start, diameter + start, charge + start, u);
+                    for (unsigned int k = 0; k < n; ++k)
+                        E += u[k];
+                    }
+                }
+            else
+                {
+                for (unsigned int i = 0; i < N; ++i)
+                    {
+                    Scalar4 postype_i = postype[i];
+                    unsigned int typ_i = __scalar_as_int(postype_i.w);
+                    E += m_eval(box, typ_i, vec3<Scalar>(postype_i), quat<Scalar>(orientation[i]), diameter[i], charge[i]);
+                    }
+                }
+            return E;
+            }
+
         //! function pointer signature
         typedef float (*ExternalFieldEvalFnPtr)(const BoxDim& box, unsigned int type, const vec3<Scalar>& r_i, const quat<Scalar>& q_i, Scalar diameter, Scalar charge);
         std::shared_ptr<ExternalFieldEvalFactory> m_factory;       //!< The factory for the evaluator function
         ExternalFieldEvalFactory::ExternalFieldEvalFnPtr m_eval;                //!< Pointer to evaluator function inside the JIT module
+        ExternalFieldEvalFactory::ExternalFieldEvalBatchFnPtr m_eval_batch;     //!< Pointer to the batched evaluator, NULL if not provided
 
     };
 
@@ -0,0 +1,45 @@
+#pragma once
+
+// do not include python headers
+#define HOOMD_LLVMJIT_BUILD
+#include "hoomd/HOOMDMath.h"
+
+#include "KaleidoscopeJIT.h"
+
+//! Compiles the LLVM IR of a pair potential and provides its batched evaluator
+class PairEvalFactory
+    {
+    public:
+        //! Batched evaluator of the force divided by r and the energy of \a n pairs
+        /*! The parameters of pair k start at params[k*param_stride], lanes beyond the cutoff return zero.
+        */
+        typedef void (*EvalBatchFnPtr)(unsigned int n,
+            const double *rsq,
+            const double *rcutsq,
+            const double *params,
+            unsigned int param_stride,
+            int energy_shift,
+            double *force_divr,
+            double *pair_eng);
+
+        //! Constructor
+        PairEvalFactory(const std::string& llvm_ir);
+
+        //! Return the batched evaluator
+        EvalBatchFnPtr getEvalBatch()
+            {
+            return m_eval_batch;
+            }
+
+        //! Get the error message from initialization
+        const std::string& getError()
+            {
+            return m_error_msg;
+            }
+
+    private:
+        std::unique_ptr<llvm::orc::KaleidoscopeJIT> m_jit; //!< The persistent JIT engine
+        EvalBatchFnPtr m_eval_batch; //!< Function pointer to the batched evaluator
+
+        std::string m_error_msg; //!< The error message if initialization fails
+    };
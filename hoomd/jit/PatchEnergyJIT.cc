@@ -18,6 +18,7 @@ PatchEnergyJIT::PatchEnergyJIT(std::shared_ptr<ExecutionConfiguration> exec_conf
 
     // get the evaluator
     m_eval = m_factory->getEval();
+    m_eval_batch = m_factory->getEvalBatch();
 
     if (!m_eval)
         {
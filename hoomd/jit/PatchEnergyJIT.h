@@ -77,12 +77,40 @@ class PatchEnergyJIT : public hpmc::PatchEnergy
             return m_eval(r_ij, type_i, q_i, d_i, charge_i, type_j, q_j, d_j, charge_j);
             }
 
+        //! evaluate the energies of a packet of patch interactions with particle i
+        /*! Calls the eval_batch loop compiled into the JIT module, where eval is inlined into the loop over the
+            packet. Falls back to calling eval once per pair when the module does not define eval_batch.
+        */
+        virtual void energyBatch(unsigned int n,
+            const vec3<float> *r_ij,
+            unsigned int type_i,
+            const quat<float>& q_i,
+            float d_i,
+            float charge_i,
+            const unsigned int *type_j,
+            const quat<float> *q_j,
+            const float *d_j,
+            const float *charge_j,
+            float *u)
+            {
+            if (m_eval_batch)
+                {
+                m_eval_batch(n, r_ij, type_i, q_i, d_i, charge_i, type_j, q_j, d_j, charge_j, u);
+                }
+            else
+                {
+                for (unsigned int k = 0; k < n; ++k)
+                    u[k] = m_eval(r_ij[k], type_i, q_i, d_i, charge_i, type_j[k], q_j[k], d_j[k], charge_j[k]);
+                }
+            }
+
     protected:
         //! function pointer signature
         typedef float (*EvalFnPtr)(const vec3<float>& r_ij, unsigned int type_i, const quat<float>& q_i, float, float, unsigned int type_j, const quat<float>& q_j, float, float);
         Scalar m_r_cut;                             //!< Cutoff radius
         std::shared_ptr<EvalFactory> m_factory;       //!< The factory for the evaluator function
         EvalFactory::EvalFnPtr m_eval;                //!< Pointer to evaluator function inside the JIT module
+        EvalFactory::EvalBatchFnPtr m_eval_batch;     //!< Pointer to the batched evaluator, NULL if not provided
     };
 
 //! Exports the PatchEnergyJIT class to python
@@ -106,6 +106,24 @@ class PatchEnergyJITUnion : public PatchEnergyJIT
             float d_j,
             float charge_j);
 
+        //! evaluate the energies of a packet of patch interactions with particle i
+        /*! The isotropic batched evaluator does not include the union contributions, evaluate pair by pair
+        */
+        virtual void energyBatch(unsigned int n,
+            const vec3<float> *r_ij,
+            unsigned int type_i,
+            const quat<float>& q_i,
+            float d_i,
+            float charge_i,
+            const unsigned int *type_j,
+            const quat<float> *q_j,
+            const float *d_j,
+            const float *charge_j,
+            float *u)
+            {
+            hpmc::PatchEnergy::energyBatch(n, r_ij, type_i, q_i, d_i, charge_i, type_j, q_j, d_j, charge_j, u);
+            }
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange()
             {
@@ -0,0 +1,101 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "PotentialPairJIT.h"
+
+/*! \file PotentialPairJIT.cc
+    \brief Defines the pair potential that is compiled at run time
+*/
+
+/*! \param sysdef System to compute forces on
+    \param nlist Neighborlist to use for computing the forces
+    \param llvm_ir Contents of the LLVM IR to load
+    \param n_params Number of parameters per type pair
+    \param log_suffix Name given to this instance of the force
+
+    After construction, the LLVM IR is loaded and compiled.
+*/
+PotentialPairJIT::PotentialPairJIT(std::shared_ptr<SystemDefinition> sysdef,
+                                   std::shared_ptr<NeighborList> nlist,
+                                   const std::string& llvm_ir,
+                                   unsigned int n_params,
+                                   const std::string& log_suffix)
+    : PotentialPair<EvaluatorPairJIT>(sysdef, nlist, log_suffix), m_eval_batch(NULL), m_n_params(n_params)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing PotentialPairJIT" << std::endl;
+
+    if (m_n_params > PAIR_JIT_MAX_PARAMS)
+        {
+        m_exec_conf->msg->error() << "pair.jit: at most " << PAIR_JIT_MAX_PARAMS << " parameters are supported, "
+                                  << m_n_params << " given" << std::endl;
+        throw std::runtime_error("Error initializing PotentialPairJIT");
+        }
+
+    // build the JIT.
+    m_factory = std::shared_ptr<PairEvalFactory>(new PairEvalFactory(llvm_ir));
+
+    // get the evaluator
+    m_eval_batch = m_factory->getEvalBatch();
+
+    if (!m_eval_batch)
+        {
+        m_exec_conf->msg->error() << m_factory->getError() << std::endl;
+        throw std::runtime_error("Error compiling JIT code.");
+        }
+    }
+
+PotentialPairJIT::~PotentialPairJIT()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying PotentialPairJIT" << std::endl;
+    }
+
+/*! \param typ1 Specifies one type of the pair
+    \param typ2 Specifies the second type of the pair
+    \param param Parameter to set
+
+    The evaluator of the parameters is always replaced by the one compiled by this potential.
+*/
+void PotentialPairJIT::setParams(unsigned int typ1, unsigned int typ2, const param_type& param)
+    {
+    param_type jit_param = param;
+    jit_param.eval_batch = m_eval_batch;
+    PotentialPair<EvaluatorPairJIT>::setParams(typ1, typ2, jit_param);
+    }
+
+/*! \param typ1 Specifies one type of the pair
+    \param typ2 Specifies the second type of the pair
+    \param params List of the parameters, in the order given to the code generator
+*/
+void PotentialPairJIT::setParamsPython(unsigned int typ1, unsigned int typ2, pybind11::list params)
+    {
+    if (pybind11::len(params) != m_n_params)
+        {
+        m_exec_conf->msg->error() << "pair.jit: expected " << m_n_params << " parameters, got "
+                                  << pybind11::len(params) << std::endl;
+        throw std::runtime_error("Error setting parameters in PotentialPairJIT");
+        }
+
+    param_type param;
+    param.eval_batch = m_eval_batch;
+    for (unsigned int k = 0; k < PAIR_JIT_MAX_PARAMS; ++k)
+        param.p[k] = (k < m_n_params) ? pybind11::cast<double>(params[k]) : 0.0;
+
+    setParams(typ1, typ2, param);
+    }
+
+void export_PotentialPairJIT(pybind11::module &m)
+    {
+    export_PotentialPair< PotentialPair<EvaluatorPairJIT> >(m, "PotentialPairJITBase");
+
+    pybind11::class_<PotentialPairJIT, std::shared_ptr<PotentialPairJIT> >(m, "PotentialPairJIT",
+                                                                       pybind11::base< PotentialPair<EvaluatorPairJIT> >())
+        .def(pybind11::init< std::shared_ptr<SystemDefinition>,
+                             std::shared_ptr<NeighborList>,
+                             const std::string&,
+                             unsigned int,
+                             const std::string& >())
+        .def("setParams", &PotentialPairJIT::setParamsPython)
+    ;
+
+    m.attr("PAIR_JIT_MAX_PARAMS") = PAIR_JIT_MAX_PARAMS;
+    }
@@ -0,0 +1,57 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef _POTENTIAL_PAIR_JIT_H_
+#define _POTENTIAL_PAIR_JIT_H_
+
+#include "hoomd/md/PotentialPair.h"
+
+#include "EvaluatorPairJIT.h"
+#include "PairEvalFactory.h"
+
+/*! \file PotentialPairJIT.h
+    \brief Declares the pair potential that is compiled at run time
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+//! Pair potential with a force and energy that are compiled at run time
+/*! The user provides LLVM IR code containing a function 'eval_batch' with the signature of
+    PairEvalFactory::EvalBatchFnPtr. On construction, this class uses the LLVM library to compile that IR down to
+    machine code. The function pointer is stored in the parameters of every type pair, and PotentialPair evaluates it
+    for every batch of neighbors (see EvaluatorPairJIT). Everything else (neighbor list, energy shifting, XPLOR
+    smoothing, logging, MPI) is inherited from PotentialPair.
+*/
+class PotentialPairJIT : public PotentialPair<EvaluatorPairJIT>
+    {
+    public:
+        //! Constructor
+        PotentialPairJIT(std::shared_ptr<SystemDefinition> sysdef,
+                         std::shared_ptr<NeighborList> nlist,
+                         const std::string& llvm_ir,
+                         unsigned int n_params,
+                         const std::string& log_suffix="");
+
+        //! Destructor
+        virtual ~PotentialPairJIT();
+
+        //! Set the pair parameters for a single type pair
+        virtual void setParams(unsigned int typ1, unsigned int typ2, const param_type& param);
+
+        //! Set the pair parameters for a single type pair from a python list
+        void setParamsPython(unsigned int typ1, unsigned int typ2, pybind11::list params);
+
+    private:
+        std::shared_ptr<PairEvalFactory> m_factory;     //!< The factory for the evaluator function
+        PairEvalFactory::EvalBatchFnPtr m_eval_batch;   //!< Pointer to the batched evaluator inside the JIT module
+        unsigned int m_n_params;                        //!< Number of parameters per type pair
+    };
+
+//! Exports the PotentialPairJIT class to python
+void export_PotentialPairJIT(pybind11::module &m);
+
+#endif // _POTENTIAL_PAIR_JIT_H_
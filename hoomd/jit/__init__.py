@@ -14,5 +14,11 @@ existing job scripts may need to be updated. **Maintainer:** Joshua A. Anderson,
 .. versionadded:: 2.3
 """
 
+from hoomd.jit import _jit
 from hoomd.jit import patch
 from hoomd.jit import external
+from hoomd.jit import cache
+
+# the JIT pair potentials are only built with the md package
+if hasattr(_jit, 'PotentialPairJIT'):
+    from hoomd.jit import pair
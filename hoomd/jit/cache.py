@@ -0,0 +1,154 @@
+# Copyright (c) 2009-2019 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+R""" Cache of compiled JIT code.
+
+:py:mod:`hoomd.jit.patch` and :py:mod:`hoomd.jit.external` compile the C++ code given in *code* to LLVM IR with
+``clang`` when they are constructed. HOOMD stores the LLVM IR in an on-disk cache, keyed by a hash of the C++ source,
+the compiler flags, the ``clang`` version, the HOOMD version and the host architecture. Job scripts that run the same
+code again load the IR from the cache and skip ``clang``.
+
+Only MPI rank 0 of each partition calls ``clang`` or reads the cache and it broadcasts the LLVM IR to the other ranks.
+
+The cache is stored in ``$XDG_CACHE_HOME/hoomd/jit`` (``~/.cache/hoomd/jit`` if ``XDG_CACHE_HOME`` is not set). Set
+the environment variable ``HOOMD_JIT_CACHE_DIR`` to choose a different directory, or set it to an empty string to
+disable the cache. The cache can be cleared by deleting the directory.
+
+.. versionadded:: 2.5
+"""
+
+from hoomd import _hoomd
+import hoomd
+
+import hashlib
+import os
+import platform
+import subprocess
+import tempfile
+
+# clang version strings, looked up once per executable
+_clang_versions = {}
+
+def _get_cache_dir():
+    R""" Get the cache directory, or None if caching is disabled.
+    """
+    cache_dir = os.environ.get('HOOMD_JIT_CACHE_DIR')
+    if cache_dir is None:
+        cache_home = os.environ.get('XDG_CACHE_HOME', os.path.join(os.path.expanduser('~'), '.cache'))
+        cache_dir = os.path.join(cache_home, 'hoomd', 'jit')
+    elif cache_dir == '':
+        return None
+
+    return cache_dir
+
+def _get_clang_version(clang):
+    R""" Get the version string of a clang executable, or None if it cannot be run.
+    """
+    if clang not in _clang_versions:
+        try:
+            p = subprocess.Popen([clang, '--version'], stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+            output = p.communicate()
+            _clang_versions[clang] = output[0].decode() if p.returncode == 0 else None
+        except OSError:
+            _clang_versions[clang] = None
+
+    return _clang_versions[clang]
+
+def _get_key(cpp_function, cmd, clang_version):
+    R""" Hash everything that determines the generated LLVM IR.
+    """
+    h = hashlib.sha256()
+    for item in [cpp_function, ' '.join(cmd), clang_version, hoomd.__version__, _hoomd.__git_sha1__,
+                 platform.machine(), platform.system()]:
+        h.update(item.encode('utf-8'))
+        h.update(b'\0')
+    return h.hexdigest()
+
+def _compile(cpp_function, cmd):
+    R""" Run clang and return the LLVM IR, or raise an error.
+    """
+    p = subprocess.Popen(cmd,stdin=subprocess.PIPE,stdout=subprocess.PIPE,stderr=subprocess.PIPE)
+
+    # pass C++ function to stdin
+    output = p.communicate(cpp_function.encode('utf-8'))
+    llvm_ir = output[0].decode()
+
+    if p.returncode != 0:
+        hoomd.context.msg.error("Error compiling provided code\n");
+        hoomd.context.msg.error("Command "+' '.join(cmd)+"\n");
+        hoomd.context.msg.error(output[1].decode()+"\n");
+        raise RuntimeError("Error compiling JIT code");
+
+    return llvm_ir
+
+def _compile_cached(cpp_function, cmd, clang):
+    R""" Load the LLVM IR from the cache, or compile it and add it to the cache.
+    """
+    cache_dir = _get_cache_dir()
+    clang_version = _get_clang_version(clang)
+    if cache_dir is None or clang_version is None:
+        return _compile(cpp_function, cmd)
+
+    fname = os.path.join(cache_dir, _get_key(cpp_function, cmd, clang_version) + '.ll')
+    try:
+        with open(fname, 'r') as f:
+            llvm_ir = f.read()
+        if len(llvm_ir) > 0:
+            hoomd.context.msg.notice(2, "jit: loaded compiled code from " + fname + "\n");
+            return llvm_ir
+    except (IOError, OSError):
+        pass
+
+    llvm_ir = _compile(cpp_function, cmd)
+
+    # write to a temporary file first so concurrent jobs never read a partial entry
+    try:
+        if not os.path.isdir(cache_dir):
+            os.makedirs(cache_dir)
+        fd, tmp_name = tempfile.mkstemp(dir=cache_dir, suffix='.tmp')
+        with os.fdopen(fd, 'w') as f:
+            f.write(llvm_ir)
+        os.rename(tmp_name, fname)
+    except (IOError, OSError) as e:
+        hoomd.context.msg.warning("jit: cannot write to the cache in " + cache_dir + ": " + str(e) + "\n");
+
+    return llvm_ir
+
+def compile_cpp(cpp_function, clang, fn=None):
+    R""" Compile C++ code to LLVM IR, using the cache.
+
+    Args:
+        cpp_function (str): C++ code to compile
+        clang (str): The Clang executable to use
+        fn (str): If provided, the LLVM IR will also be written to this file.
+
+    Returns:
+        The LLVM IR (str) on all ranks.
+
+    Rank 0 compiles the code (or loads it from the cache) and broadcasts the LLVM IR to all other ranks.
+    """
+    include_path = os.path.dirname(hoomd.__file__) + '/include';
+    include_path_source = hoomd._hoomd.__hoomd_source_dir__;
+
+    cmd = [clang, '-O3', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm','-x','c++', '-o','-','-']
+
+    llvm_ir = ''
+    error = None
+    if hoomd.comm.get_rank() == 0:
+        try:
+            llvm_ir = _compile_cached(cpp_function, cmd, clang)
+        except (RuntimeError, OSError) as e:
+            error = e
+
+    # an empty result tells the other ranks that compilation failed
+    llvm_ir = _hoomd.mpi_bcast_str(llvm_ir, hoomd.context.exec_conf)
+    if error is not None:
+        raise RuntimeError("Error compiling JIT code: " + str(error))
+    elif len(llvm_ir) == 0:
+        raise RuntimeError("Error compiling JIT code on rank 0")
+
+    if fn is not None and hoomd.comm.get_rank() == 0:
+        with open(fn, 'w') as f:
+            f.write(llvm_ir)
+
+    return llvm_ir
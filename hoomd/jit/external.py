@@ -3,6 +3,7 @@
 
 from hoomd import _hoomd
 from hoomd.jit import _jit
+from hoomd.jit import cache
 from hoomd.hpmc import field
 from hoomd.hpmc import integrate
 import hoomd
@@ -81,6 +82,22 @@ class user(field._external):
 
     ``vec3`` and ``quat`` is defined in HOOMDMath.h.
 
+    The file may also define an extern "C" ``eval_batch`` function that evaluates the field for ``n`` consecutive
+    particles at once, storing the energies in ``u``::
+
+        void eval_batch(unsigned int n,
+                        const BoxDim& box,
+                        const Scalar4 *postype,
+                        const Scalar4 *orientation,
+                        const Scalar *diameter,
+                        const Scalar *charge,
+                        float *u)
+
+    The type of particle ``k`` is stored in ``postype[k].w`` (use ``__scalar_as_int``). HPMC uses ``eval_batch``
+    when it evaluates the field for all particles, such as in box moves, and calls ``eval`` once per particle when
+    ``eval_batch`` is not present. Code passed in *code* is always compiled with an ``eval_batch`` loop that
+    inlines ``eval``.
+
     Compile the file with clang: ``clang -O3 --std=c++11 -DHOOMD_LLVMJIT_BUILD -I /path/to/hoomd/include -S -emit-llvm code.cc`` to produce
     the LLVM IR in ``code.ll``.
 
@@ -178,31 +195,28 @@ Scalar charge
         cpp_function += code
         cpp_function += """
     }
+
+// evaluate a packet of particles, clang inlines eval into this loop
+void eval_batch(unsigned int n,
+const BoxDim& box,
+const Scalar4 *postype,
+const Scalar4 *orientation,
+const Scalar *diameter,
+const Scalar *charge,
+float *u)
+    {
+    for (unsigned int k = 0; k < n; ++k)
+        {
+        const Scalar4 postype_k = postype[k];
+        u[k] = eval(box, __scalar_as_int(postype_k.w), vec3<Scalar>(postype_k), quat<Scalar>(orientation[k]), diameter[k], charge[k]);
+        }
+    }
 }
 """
 
-        include_path = os.path.dirname(hoomd.__file__) + '/include';
-        include_patsource = hoomd._hoomd.__hoomd_source_dir__;
-
         if clang_exec is not None:
             clang = clang_exec;
         else:
             clang = 'clang';
 
-        if fn is not None:
-            cmd = [clang, '-O3', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_patsource, '-S', '-emit-llvm','-x','c++', '-o',fn,'-']
-        else:
-            cmd = [clang, '-O3', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_patsource, '-S', '-emit-llvm','-x','c++', '-o','-','-']
-        p = subprocess.Popen(cmd,stdin=subprocess.PIPE,stdout=subprocess.PIPE,stderr=subprocess.PIPE)
-
-        # pass C++ function to stdin
-        output = p.communicate(cpp_function.encode('utf-8'))
-        llvm_ir = output[0].decode()
-
-        if p.returncode != 0:
-            hoomd.context.msg.error("Error compiling provided code\n");
-            hoomd.context.msg.error("Command "+' '.join(cmd)+"\n");
-            hoomd.context.msg.error(output[1].decode()+"\n");
-            raise RuntimeError("Error initializing force.");
-
-        return llvm_ir
+        return cache.compile_cpp(cpp_function, clang, fn)
@@ -21,6 +21,10 @@
 #include "hoomd/hpmc/ShapeFacetedSphere.h"
 #include "hoomd/hpmc/ShapeSphinx.h"
 
+#ifdef BUILD_MD
+#include "PotentialPairJIT.h"
+#endif
+
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 
 using namespace hpmc;
@@ -33,6 +37,13 @@ using namespace hpmc::detail;
 
 PYBIND11_MODULE(_jit, m)
     {
+    // the external field base classes are exported by the per-shape hpmc modules
+    const char *hpmc_shapes[] = {"sphere", "convex_polygon", "polyhedron", "convex_polyhedron",
+                                 "convex_spheropolyhedron", "spheropolygon", "simple_polygon", "ellipsoid",
+                                 "faceted_sphere", "sphinx"};
+    for (const char *shape : hpmc_shapes)
+        pybind11::module::import((std::string("hoomd.hpmc._hpmc_") + shape).c_str());
+
     export_PatchEnergyJIT(m);
     export_PatchEnergyJITUnion(m);
 
@@ -46,4 +57,10 @@ PYBIND11_MODULE(_jit, m)
     export_ExternalFieldJIT<ShapeEllipsoid>(m, "ExternalFieldJITEllipsoid");
     export_ExternalFieldJIT<ShapeFacetedSphere>(m, "ExternalFieldJITFacetedSphere");
     export_ExternalFieldJIT<ShapeSphinx>(m, "ExternalFieldJITSphinx");
+
+    #ifdef BUILD_MD
+    // the neighbor list is exported by the md module
+    pybind11::module::import("hoomd.md._md");
+    export_PotentialPairJIT(m);
+    #endif
     }
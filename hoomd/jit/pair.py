@@ -0,0 +1,255 @@
+# Copyright (c) 2009-2019 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+R""" JIT compiled pair potentials.
+
+.. versionadded:: 2.5
+"""
+
+from hoomd.jit import _jit
+from hoomd.jit import cache
+from hoomd.md import pair as md_pair
+import hoomd
+
+import ast
+import keyword
+
+# functions that may be called in the expressions, and their C++ names
+_functions = {'exp': 'std::exp', 'log': 'std::log', 'sqrt': 'std::sqrt', 'sin': 'std::sin', 'cos': 'std::cos',
+              'tan': 'std::tan', 'asin': 'std::asin', 'acos': 'std::acos', 'atan': 'std::atan', 'sinh': 'std::sinh',
+              'cosh': 'std::cosh', 'tanh': 'std::tanh', 'erf': 'std::erf', 'erfc': 'std::erfc', 'abs': 'std::fabs',
+              'pow': 'std::pow'}
+
+# constants that may be used in the expressions
+_constants = {'pi': 'M_PI'}
+
+class _cpp_writer(ast.NodeVisitor):
+    R""" Translate a python expression into a C++ expression in double precision.
+    """
+    def __init__(self, names):
+        self.names = names
+
+    def generic_visit(self, node):
+        raise SyntaxError("unsupported element " + type(node).__name__)
+
+    def visit_Expression(self, node):
+        return self.visit(node.body)
+
+    def visit_BinOp(self, node):
+        left = self.visit(node.left)
+        right = self.visit(node.right)
+        if isinstance(node.op, ast.Add):
+            return '(' + left + ' + ' + right + ')'
+        elif isinstance(node.op, ast.Sub):
+            return '(' + left + ' - ' + right + ')'
+        elif isinstance(node.op, ast.Mult):
+            return '(' + left + ' * ' + right + ')'
+        elif isinstance(node.op, ast.Div):
+            return '(' + left + ' / ' + right + ')'
+        elif isinstance(node.op, ast.Pow):
+            # integer powers are expanded into multiplications by the compiler
+            exponent = self._get_number(node.right)
+            if exponent is not None and float(exponent).is_integer() and abs(exponent) <= 64:
+                return '__builtin_powi(' + left + ', ' + str(int(exponent)) + ')'
+            return 'std::pow(' + left + ', ' + right + ')'
+        raise SyntaxError("unsupported operator " + type(node.op).__name__)
+
+    def visit_UnaryOp(self, node):
+        operand = self.visit(node.operand)
+        if isinstance(node.op, ast.USub):
+            return '(-' + operand + ')'
+        elif isinstance(node.op, ast.UAdd):
+            return operand
+        raise SyntaxError("unsupported operator " + type(node.op).__name__)
+
+    def visit_Call(self, node):
+        if not isinstance(node.func, ast.Name) or node.func.id not in _functions:
+            raise SyntaxError("unsupported function call")
+        if len(getattr(node, 'keywords', [])) > 0:
+            raise SyntaxError("keyword arguments are not supported")
+        return _functions[node.func.id] + '(' + ', '.join(self.visit(a) for a in node.args) + ')'
+
+    def visit_Name(self, node):
+        if node.id in self.names:
+            return node.id
+        elif node.id in _constants:
+            return _constants[node.id]
+        raise SyntaxError("unknown name " + node.id)
+
+    def visit_Num(self, node):
+        return repr(float(node.n))
+
+    def visit_Constant(self, node):
+        if isinstance(node.value, bool) or not isinstance(node.value, (int, float)):
+            raise SyntaxError("unsupported constant " + repr(node.value))
+        return repr(float(node.value))
+
+    def _get_number(self, node):
+        if isinstance(node, ast.UnaryOp) and isinstance(node.op, ast.USub):
+            value = self._get_number(node.operand)
+            return -value if value is not None else None
+        if hasattr(ast, 'Constant') and isinstance(node, ast.Constant) and isinstance(node.value, (int, float)):
+            return node.value
+        if hasattr(ast, 'Num') and isinstance(node, ast.Num):
+            return node.n
+        return None
+
+def _to_cpp(expression, names):
+    R""" Translate the python expression into C++, or raise an error.
+    """
+    try:
+        tree = ast.parse(expression.strip(), mode='eval')
+        return _cpp_writer(names).visit(tree)
+    except SyntaxError as e:
+        hoomd.context.msg.error("jit.pair: cannot translate '" + expression + "': " + str(e) + "\n");
+        raise RuntimeError("Error initializing pair.user");
+
+class user(md_pair.pair):
+    R""" Pair potential compiled from python expressions.
+
+    Args:
+        r_cut (float): Default cutoff radius (in distance units).
+        nlist (:py:mod:`hoomd.md.nlist`): Neighbor list
+        V (str): Python expression of the pair energy :math:`V(r)`
+        F (str): Python expression of the pair force :math:`F(r) = -\frac{\partial V}{\partial r}`
+        params (list): Names of the per type pair coefficients used in *V* and *F*
+        name (str): Name of the force instance.
+        clang_exec (str): The Clang executable to use
+
+    :py:class:`user` translates the expressions *V* and *F* into C++, compiles them to LLVM IR with ``clang`` (using
+    the cache in :py:mod:`hoomd.jit.cache`) and JIT compiles the IR when it is constructed. The compiled code is
+    evaluated in the batched neighbor loop of the pair potentials at the speed of the built-in potentials, so custom
+    potentials no longer need to fall back to :py:class:`hoomd.md.pair.table`.
+
+    The expressions may use the pair distance ``r``, its square ``rsq``, the coefficients named in *params*, the
+    constant ``pi``, numbers, the operators ``+ - * / **`` and the functions ``exp``, ``log``, ``sqrt``, ``sin``,
+    ``cos``, ``tan``, ``asin``, ``acos``, ``atan``, ``sinh``, ``cosh``, ``tanh``, ``erf``, ``erfc``, ``abs`` and
+    ``pow``. Integer powers are expanded into multiplications. At most 8 coefficients are supported.
+
+    All modes of :py:meth:`set_params() <hoomd.md.pair.pair.set_params>` are supported, the energy shift evaluates
+    *V* at :math:`r_{\mathrm{cut}}`. See :py:class:`hoomd.md.pair.pair` for details.
+
+    Use :py:meth:`pair_coeff.set <hoomd.md.pair.coeff.set>` to set the coefficients named in *params* per unique pair
+    of particle types.
+
+    Note:
+        The code is compiled for the CPU only, :py:class:`user` is not available in GPU simulations.
+
+    Example::
+
+        nl = md.nlist.cell()
+        lj = jit.pair.user(r_cut=3.0, nlist=nl,
+                           V='4*epsilon*((sigma/r)**12 - (sigma/r)**6)',
+                           F='24*epsilon/r*(2*(sigma/r)**12 - (sigma/r)**6)',
+                           params=['epsilon', 'sigma'])
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+
+    .. versionadded:: 2.5
+    """
+    def __init__(self, r_cut, nlist, V, F, params=[], name=None, clang_exec=None):
+        hoomd.util.print_status_line();
+
+        # the JIT code only runs on the host
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.msg.error("jit.pair.user is not supported on the GPU\n");
+            raise RuntimeError("Error initializing pair.user");
+
+        params = list(params)
+        if len(params) > _jit.PAIR_JIT_MAX_PARAMS:
+            hoomd.context.msg.error("jit.pair.user supports at most " + str(_jit.PAIR_JIT_MAX_PARAMS)
+                                    + " parameters\n");
+            raise RuntimeError("Error initializing pair.user");
+
+        for p in params:
+            if (not isinstance(p, str) or not p.isidentifier() or keyword.iskeyword(p) or p in ('r', 'rsq', 'p')
+                or p in _functions or p in _constants or p.startswith('_')):
+                hoomd.context.msg.error("jit.pair.user: invalid parameter name " + str(p) + "\n");
+                raise RuntimeError("Error initializing pair.user");
+
+        if clang_exec is not None:
+            clang = clang_exec;
+        else:
+            clang = 'clang'
+
+        llvm_ir = self.compile_user(V, F, params, clang)
+
+        # initialize the base class
+        md_pair.pair.__init__(self, r_cut, nlist, name);
+
+        # create the c++ mirror class
+        self.cpp_force = _jit.PotentialPairJIT(hoomd.context.current.system_definition, self.nlist.cpp_nlist,
+                                               llvm_ir, len(params), self.name);
+        self.cpp_class = _jit.PotentialPairJIT;
+
+        hoomd.context.current.system.addCompute(self.cpp_force, self.force_name);
+
+        # setup the coefficient options
+        self.required_coeffs = params;
+
+    def compile_user(self, V, F, params, clang_exec, fn=None):
+        R""" Helper function to compile the provided expressions into an executable
+
+        Args:
+            V (str): Python expression of the pair energy
+            F (str): Python expression of the pair force
+            params (list): Names of the coefficients
+            clang_exec (str): The Clang executable to use
+            fn (str): If provided, the code will be written to a file.
+
+        .. versionadded:: 2.5
+        """
+        names = ['r', 'rsq'] + params
+        V_cpp = _to_cpp(V, names)
+        F_cpp = _to_cpp(F, names)
+
+        unpack = ''.join('    const double {} = p[{}];\n'.format(name, k) for k, name in enumerate(params))
+
+        cpp_function = """
+#define _USE_MATH_DEFINES
+#include <cmath>
+
+// energy and force of one pair, the unused arguments are optimized away
+static inline double pair_V(double r, double rsq, const double *p)
+    {
+""" + unpack + """
+    return """ + V_cpp + """;
+    }
+
+static inline double pair_F(double r, double rsq, const double *p)
+    {
+""" + unpack + """
+    return """ + F_cpp + """;
+    }
+
+extern "C"
+{
+// evaluate a batch of pairs, clang inlines the energy and force into this loop
+void eval_batch(unsigned int n,
+    const double *rsq,
+    const double *rcutsq,
+    const double *params,
+    unsigned int param_stride,
+    int energy_shift,
+    double *force_divr,
+    double *pair_eng)
+    {
+    for (unsigned int k = 0; k < n; ++k)
+        {
+        const double *p = params + k*param_stride;
+        const bool in_range = rsq[k] < rcutsq[k];
+        const double r = std::sqrt(rsq[k]);
+
+        double e = pair_V(r, rsq[k], p);
+        if (energy_shift)
+            e -= pair_V(std::sqrt(rcutsq[k]), rcutsq[k], p);
+
+        force_divr[k] = in_range ? pair_F(r, rsq[k], p) / r : 0.0;
+        pair_eng[k] = in_range ? e : 0.0;
+        }
+    }
+}
+"""
+        return cache.compile_cpp(cpp_function, clang_exec, fn)
+
+    def process_coeff(self, coeff):
+        return [float(coeff[name]) for name in self.required_coeffs];
@@ -3,6 +3,7 @@
 
 from hoomd import _hoomd
 from hoomd.jit import _jit
+from hoomd.jit import cache
 import hoomd
 
 import tempfile
@@ -29,6 +30,11 @@ class user(object):
     in the MC loop at with full performance. It enables researchers to quickly and easily implement custom energetic
     interactions without the need to modify and recompile HOOMD.
 
+    .. note::
+        Patch energies are only compiled for the CPU. In GPU execution configurations, :py:class:`user` raises an
+        error when it is created and :py:class:`user_union` when the run starts; run patchy particle simulations
+        with ``--mode=cpu``.
+
     .. rubric:: C++ code
 
     Supply C++ code to the *code* argument and :py:class:`user` will compile the code and call it to evaluate
@@ -97,6 +103,24 @@ class user(object):
 
     ``vec3`` and ``quat`` are defined in HOOMDMath.h.
 
+    The file may also define an extern "C" ``eval_batch`` function that evaluates a packet of ``n`` neighbors of
+    particle i at once, storing the energies in ``u``::
+
+        void eval_batch(unsigned int n,
+                        const vec3<float> *r_ij,
+                        unsigned int type_i,
+                        const quat<float>& q_i,
+                        float d_i,
+                        float charge_i,
+                        const unsigned int *type_j,
+                        const quat<float> *q_j,
+                        const float *d_j,
+                        const float *charge_j,
+                        float *u)
+
+    HPMC calls ``eval`` once per pair when ``eval_batch`` is not present. Code passed in *code* is always compiled
+    with an ``eval_batch`` loop that inlines ``eval``.
+
     Compile the file with clang: ``clang -O3 --std=c++11 -DHOOMD_LLVMJIT_BUILD -I /path/to/hoomd/include -S -emit-llvm code.cc`` to produce
     the LLVM IR in ``code.ll``.
 
@@ -167,34 +191,32 @@ float eval(const vec3<float>& r_ij,
         cpp_function += code
         cpp_function += """
     }
+
+// evaluate a packet of neighbors, clang inlines eval into this loop
+void eval_batch(unsigned int n,
+    const vec3<float> *r_ij,
+    unsigned int type_i,
+    const quat<float>& q_i,
+    float d_i,
+    float charge_i,
+    const unsigned int *type_j,
+    const quat<float> *q_j,
+    const float *d_j,
+    const float *charge_j,
+    float *u)
+    {
+    for (unsigned int k = 0; k < n; ++k)
+        u[k] = eval(r_ij[k], type_i, q_i, d_i, charge_i, type_j[k], q_j[k], d_j[k], charge_j[k]);
+    }
 }
 """
 
-        include_path = os.path.dirname(hoomd.__file__) + '/include';
-        include_path_source = hoomd._hoomd.__hoomd_source_dir__;
-
         if clang_exec is not None:
             clang = clang_exec;
         else:
             clang = 'clang';
 
-        if fn is not None:
-            cmd = [clang, '-O3', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm','-x','c++', '-o',fn,'-']
-        else:
-            cmd = [clang, '-O3', '--std=c++11', '-DHOOMD_LLVMJIT_BUILD', '-I', include_path, '-I', include_path_source, '-S', '-emit-llvm','-x','c++', '-o','-','-']
-        p = subprocess.Popen(cmd,stdin=subprocess.PIPE,stdout=subprocess.PIPE,stderr=subprocess.PIPE)
-
-        # pass C++ function to stdin
-        output = p.communicate(cpp_function.encode('utf-8'))
-        llvm_ir = output[0].decode()
-
-        if p.returncode != 0:
-            hoomd.context.msg.error("Error compiling provided code\n");
-            hoomd.context.msg.error("Command "+' '.join(cmd)+"\n");
-            hoomd.context.msg.error(output[1].decode()+"\n");
-            raise RuntimeError("Error initializing patch energy");
-
-        return llvm_ir
+        return cache.compile_cpp(cpp_function, clang, fn)
 
     R''' Disable the patch energy and optionally enable it only for logging
 
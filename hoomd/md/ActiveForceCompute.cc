@@ -10,6 +10,10 @@
 
 #include <vector>
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 using namespace std;
 using namespace hoomd;
 namespace py = pybind11;
@@ -142,232 +146,156 @@ ActiveForceCompute::~ActiveForceCompute()
     m_exec_conf->msg->notice(5) << "Destroying ActiveForceCompute" << endl;
     }
 
-/*! This function sets appropriate active forces on all active particles.
+/*! This function applies the surface constraint and rotational diffusion to the active force vectors and sets
+    the active forces and torques on all active particles. All steps are applied to one particle after the other, so
+    that the active vectors, the orientation and the random number generator of a particle are only set up once.
+    In builds with ENABLE_TBB, the loop over the group members is distributed over the TBB threads. The random
+    numbers only depend on the tag, the time step and the seed, the result does not depend on the number of threads.
+    \param timestep Current timestep
 */
-void ActiveForceCompute::setForces()
+void ActiveForceCompute::updateActiveForces(unsigned int timestep)
     {
-
     //  array handles
-    ArrayHandle<Scalar3> h_f_actVec(m_f_activeVec, access_location::host, access_mode::read);
-    ArrayHandle<Scalar3> h_t_actVec(m_t_activeVec, access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_f_actVec(m_f_activeVec, access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar3> h_t_actVec(m_t_activeVec, access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar> h_f_actMag(m_f_activeMag, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_t_actMag(m_t_activeMag, access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_force(m_force,access_location::host,access_mode::overwrite);
     ArrayHandle<Scalar4> h_torque(m_torque,access_location::host,access_mode::overwrite);
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_member_tags(m_group->getMemberTagArray(), access_location::host, access_mode::read);
 
     // sanity check
     assert(h_f_actVec.data != NULL);
     assert(h_t_actVec.data != NULL);
     assert(h_f_actMag.data != NULL);
     assert(h_t_actMag.data != NULL);
+    assert(h_pos.data != NULL);
     assert(h_orientation.data != NULL);
 
     // zero forces so we don't leave any forces set for indices that are no longer part of our group
     memset(h_force.data, 0, sizeof(Scalar4) * m_force.getNumElements());
     memset(h_torque.data, 0, sizeof(Scalar4) * m_force.getNumElements());
 
-    for (unsigned int i = 0; i < m_group->getNumMembers(); i++)
-        {
-        unsigned int tag = m_group->getMemberTag(i);
-        unsigned int idx = h_rtag.data[tag];
-
-        Scalar3 f;
-        Scalar3 t;
-        // rotate force according to particle orientation only if orientation is linked to active force vector
-        if (m_orientationLink == true)
-            {
-            vec3<Scalar> fi;
-            f = make_scalar3(h_f_actMag.data[i]*h_f_actVec.data[i].x, h_f_actMag.data[i]*h_f_actVec.data[i].y, h_f_actMag.data[i]*h_f_actVec.data[i].z);
-            quat<Scalar> quati(h_orientation.data[idx]);
-            fi = rotate(quati, vec3<Scalar>(f));
-            h_force.data[idx].x = fi.x;
-            h_force.data[idx].y = fi.y;
-            h_force.data[idx].z = fi.z;
-
-            vec3<Scalar> ti;
-            t = make_scalar3(h_t_actMag.data[i]*h_t_actVec.data[i].x, h_t_actMag.data[i]*h_t_actVec.data[i].y, h_t_actMag.data[i]*h_t_actVec.data[i].z);
-            ti = rotate(quati, vec3<Scalar>(t));
-            h_torque.data[idx].x = ti.x;
-            h_torque.data[idx].y = ti.y;
-            h_torque.data[idx].z = ti.z;
-            }
-        else // no orientation link
-            {
-            f = make_scalar3(h_f_actMag.data[i]*h_f_actVec.data[i].x, h_f_actMag.data[i]*h_f_actVec.data[i].y, h_f_actMag.data[i]*h_f_actVec.data[i].z);
-            h_force.data[idx].x = f.x;
-            h_force.data[idx].y = f.y;
-            h_force.data[idx].z = f.z;
-
-            t = make_scalar3(h_t_actMag.data[i]*h_t_actVec.data[i].x, h_t_actMag.data[i]*h_t_actVec.data[i].y, h_t_actMag.data[i]*h_t_actVec.data[i].z);
-            h_torque.data[idx].x = t.x;
-            h_torque.data[idx].y = t.y;
-            h_torque.data[idx].z = t.z;
-            }
-        // rotate particle orientation only if orientation is reverse linked to active force vector. Does not operate on torque vector
-        if (m_orientationReverseLink == true)
-            {
-            vec3<Scalar> f(h_f_actMag.data[i]*h_f_actVec.data[i].x, h_f_actMag.data[i]*h_f_actVec.data[i].y, h_f_actMag.data[i]*h_f_actVec.data[i].z);
-            vec3<Scalar> vecZ(0.0, 0.0, 1.0);
-            vec3<Scalar> quatVec = cross(vecZ, f);
-            Scalar quatScal = slow::sqrt(h_f_actMag.data[i]*h_f_actMag.data[i]) + dot(f, vecZ);
-            quat<Scalar> quati(quatScal, quatVec);
-            quati = quati * (Scalar(1.0) / slow::sqrt(norm2(quati)));
-            h_orientation.data[idx] = quat_to_scalar4(quati);
-            }
-        }
-    }
+    const bool constraint = (m_rx != 0);
+    const bool diffusion = (m_rotationDiff != 0);
+    const bool is2D = (m_sysdef->getNDimensions() == 2);
+    EvaluatorConstraintEllipsoid Ellipsoid(m_P, m_rx, m_ry, m_rz);
 
-/*! This function applies rotational diffusion to all active particles. The orientation of any torque vector
- * relative to the force vector is preserved
-    \param timestep Current timestep
-*/
-void ActiveForceCompute::rotationalDiffusion(unsigned int timestep)
-    {
-    //  array handles
-    ArrayHandle<Scalar3> h_f_actVec(m_f_activeVec, access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar3> h_t_actVec(m_t_activeVec, access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_pos(m_pdata -> getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
-    assert(h_pos.data != NULL);
+    unsigned int group_size = m_group->getNumMembers();
 
-    for (unsigned int i = 0; i < m_group->getNumMembers(); i++)
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, group_size, [&] (unsigned int i)
+    #else
+    for (unsigned int i = 0; i < group_size; i++)
+    #endif
         {
-        unsigned int tag = m_group->getMemberTag(i);
+        unsigned int tag = h_member_tags.data[i];
         unsigned int idx = h_rtag.data[tag];
 
-        if (m_sysdef->getNDimensions() == 2) // 2D
-            {
-            hoomd::detail::Saru saru(tag, timestep, m_seed);
-            Scalar delta_theta; // rotational diffusion angle
-            delta_theta = m_rotationConst * gaussian_rng(saru, 1.0);
-            Scalar theta; // angle on plane defining orientation of active force vector
-            theta = atan2(h_f_actVec.data[i].y, h_f_actVec.data[i].x);
-            theta += delta_theta;
-            h_f_actVec.data[i].x = slow::cos(theta);
-            h_f_actVec.data[i].y = slow::sin(theta);
-            // In 2D, the only meaningful torque vector is out of plane and should not change
-            }
-        else // 3D: Following Stenhammar, Soft Matter, 2014
-            {
-            if (m_rx == 0) // if no constraint
-                {
-                hoomd::detail::Saru saru(tag, timestep, m_seed);
-                Scalar u = saru.s(Scalar(0), Scalar(1.0)); // generates an even distribution of random unit vectors in 3D
-                Scalar v = saru.s(Scalar(0), Scalar(1.0));
-                Scalar theta = 2.0 * M_PI * u;
-                Scalar phi = slow::acos(2.0 * v - 1.0);
-
-                vec3<Scalar> rand_vec;
-                rand_vec.x = slow::sin(phi) * slow::cos(theta);
-                rand_vec.y = slow::sin(phi) * slow::sin(theta);
-                rand_vec.z = slow::cos(phi);
+        vec3<Scalar> f_vec(h_f_actVec.data[i]);
+        vec3<Scalar> t_vec(h_t_actVec.data[i]);
 
-                vec3<Scalar> aux_vec;
-                aux_vec.x = h_f_actVec.data[i].y * rand_vec.z - h_f_actVec.data[i].z * rand_vec.y;
-                aux_vec.y = h_f_actVec.data[i].z * rand_vec.x - h_f_actVec.data[i].x * rand_vec.z;
-                aux_vec.z = h_f_actVec.data[i].x * rand_vec.y - h_f_actVec.data[i].y * rand_vec.x;
-                Scalar aux_vec_mag = slow::sqrt(aux_vec.x*aux_vec.x + aux_vec.y*aux_vec.y + aux_vec.z*aux_vec.z);
-                aux_vec.x /= aux_vec_mag;
-                aux_vec.y /= aux_vec_mag;
-                aux_vec.z /= aux_vec_mag;
-
-                vec3<Scalar> current_f_vec;
-                current_f_vec.x = h_f_actVec.data[i].x;
-                current_f_vec.y = h_f_actVec.data[i].y;
-                current_f_vec.z = h_f_actVec.data[i].z;
-
-                vec3<Scalar> current_t_vec;
-                current_t_vec.x = h_t_actVec.data[i].x;
-                current_t_vec.y = h_t_actVec.data[i].y;
-                current_t_vec.z = h_t_actVec.data[i].z;
+        // the normal vector to which the particles are confined. Torque is not constrained
+        vec3<Scalar> norm;
+        if (constraint)
+            {
+            Scalar3 current_pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
+            norm = vec3<Scalar>(Ellipsoid.evalNormal(current_pos));
 
-                Scalar delta_theta = m_rotationConst * gaussian_rng(saru, 1.0);
-                h_f_actVec.data[i].x = slow::cos(delta_theta)*current_f_vec.x + slow::sin(delta_theta)*aux_vec.x;
-                h_f_actVec.data[i].y = slow::cos(delta_theta)*current_f_vec.y + slow::sin(delta_theta)*aux_vec.y;
-                h_f_actVec.data[i].z = slow::cos(delta_theta)*current_f_vec.z + slow::sin(delta_theta)*aux_vec.z;
+            f_vec -= norm * dot(f_vec, norm);
+            f_vec = f_vec * (Scalar(1.0) / slow::sqrt(dot(f_vec, f_vec)));
+            }
 
-                h_t_actVec.data[i].x = slow::cos(delta_theta)*current_t_vec.x + slow::sin(delta_theta)*aux_vec.x;
-                h_t_actVec.data[i].y = slow::cos(delta_theta)*current_t_vec.y + slow::sin(delta_theta)*aux_vec.y;
-                h_t_actVec.data[i].z = slow::cos(delta_theta)*current_t_vec.z + slow::sin(delta_theta)*aux_vec.z;
+        // apply rotational diffusion, the orientation of the torque vector relative to the force vector is preserved
+        if (diffusion)
+            {
+            hoomd::detail::Saru saru(tag, timestep, m_seed);
 
-                }
-            else // if constraint exists
+            if (is2D) // 2D
                 {
-                EvaluatorConstraintEllipsoid Ellipsoid(m_P, m_rx, m_ry, m_rz);
-                hoomd::detail::Saru saru(tag, timestep, m_seed);
-
-                Scalar3 current_pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
-                Scalar3 norm_scalar3 = Ellipsoid.evalNormal(current_pos); // the normal vector to which the particles are confined.
-
-                vec3<Scalar> norm;
-                norm = vec3<Scalar> (norm_scalar3);
-
-                vec3<Scalar> current_f_vec;
-                current_f_vec.x = h_f_actVec.data[i].x;
-                current_f_vec.y = h_f_actVec.data[i].y;
-                current_f_vec.z = h_f_actVec.data[i].z;
-
-                vec3<Scalar> current_t_vec;
-                current_t_vec.x = h_t_actVec.data[i].x;
-                current_t_vec.y = h_t_actVec.data[i].y;
-                current_t_vec.z = h_t_actVec.data[i].z;
-
-                vec3<Scalar> aux_vec = cross(current_f_vec, norm); // aux vec for defining direction that active force vector rotates towards. Torque ignored
-
                 Scalar delta_theta; // rotational diffusion angle
                 delta_theta = m_rotationConst * gaussian_rng(saru, 1.0);
+                Scalar theta; // angle on plane defining orientation of active force vector
+                theta = atan2(f_vec.y, f_vec.x);
+                theta += delta_theta;
+                f_vec.x = slow::cos(theta);
+                f_vec.y = slow::sin(theta);
+                // In 2D, the only meaningful torque vector is out of plane and should not change
+                }
+            else // 3D: Following Stenhammar, Soft Matter, 2014
+                {
+                vec3<Scalar> aux_vec;
+                if (!constraint)
+                    {
+                    Scalar u = saru.s(Scalar(0), Scalar(1.0)); // generates an even distribution of random unit vectors in 3D
+                    Scalar v = saru.s(Scalar(0), Scalar(1.0));
+                    Scalar theta = 2.0 * M_PI * u;
+                    Scalar phi = slow::acos(2.0 * v - 1.0);
+
+                    vec3<Scalar> rand_vec;
+                    rand_vec.x = slow::sin(phi) * slow::cos(theta);
+                    rand_vec.y = slow::sin(phi) * slow::sin(theta);
+                    rand_vec.z = slow::cos(phi);
+
+                    aux_vec = cross(f_vec, rand_vec);
+                    aux_vec = aux_vec * (Scalar(1.0) / slow::sqrt(dot(aux_vec, aux_vec)));
+                    }
+                else
+                    {
+                    // aux vec for defining direction that active force vector rotates towards. Torque ignored
+                    aux_vec = cross(f_vec, norm);
+                    }
 
-                h_f_actVec.data[i].x = slow::cos(delta_theta)*current_f_vec.x + slow::sin(delta_theta)*aux_vec.x;
-                h_f_actVec.data[i].y = slow::cos(delta_theta)*current_f_vec.y + slow::sin(delta_theta)*aux_vec.y;
-                h_f_actVec.data[i].z = slow::cos(delta_theta)*current_f_vec.z + slow::sin(delta_theta)*aux_vec.z;
-
-                h_t_actVec.data[i].x = slow::cos(delta_theta)*current_t_vec.x + slow::sin(delta_theta)*aux_vec.x;
-                h_t_actVec.data[i].y = slow::cos(delta_theta)*current_t_vec.y + slow::sin(delta_theta)*aux_vec.y;
-                h_t_actVec.data[i].z = slow::cos(delta_theta)*current_t_vec.z + slow::sin(delta_theta)*aux_vec.z;
-
+                Scalar delta_theta = m_rotationConst * gaussian_rng(saru, 1.0);
+                Scalar cos_theta = slow::cos(delta_theta);
+                Scalar sin_theta = slow::sin(delta_theta);
+                f_vec = cos_theta*f_vec + sin_theta*aux_vec;
+                t_vec = cos_theta*t_vec + sin_theta*aux_vec;
                 }
             }
-        }
-    }
-
-/*! This function sets an ellipsoid surface constraint for all active particles. Torque is not considered here
-*/
-void ActiveForceCompute::setConstraint()
-    {
-    EvaluatorConstraintEllipsoid Ellipsoid(m_P, m_rx, m_ry, m_rz);
-
-    //  array handles
-    ArrayHandle<Scalar3> h_f_actVec(m_f_activeVec, access_location::host, access_mode::readwrite);
-    ArrayHandle <Scalar4> h_pos(m_pdata -> getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
-    assert(h_pos.data != NULL);
 
-    for (unsigned int i = 0; i < m_group->getNumMembers(); i++)
-        {
-        unsigned int tag = m_group->getMemberTag(i);
-        unsigned int idx = h_rtag.data[tag];
-
-        Scalar3 current_pos = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
+        if (constraint || diffusion)
+            {
+            h_f_actVec.data[i] = vec_to_scalar3(f_vec);
+            h_t_actVec.data[i] = vec_to_scalar3(t_vec);
+            }
 
-        Scalar3 norm_scalar3 = Ellipsoid.evalNormal(current_pos); // the normal vector to which the particles are confined.
-        vec3<Scalar> norm;
-        norm = vec3<Scalar>(norm_scalar3);
-        Scalar dot_prod = h_f_actVec.data[i].x * norm.x + h_f_actVec.data[i].y * norm.y + h_f_actVec.data[i].z * norm.z;
+        vec3<Scalar> f = h_f_actMag.data[i]*f_vec;
+        vec3<Scalar> t = h_t_actMag.data[i]*t_vec;
 
-        h_f_actVec.data[i].x -= norm.x * dot_prod;
-        h_f_actVec.data[i].y -= norm.y * dot_prod;
-        h_f_actVec.data[i].z -= norm.z * dot_prod;
+        // rotate force according to particle orientation only if orientation is linked to active force vector
+        if (m_orientationLink == true)
+            {
+            quat<Scalar> quati(h_orientation.data[idx]);
+            f = rotate(quati, f);
+            t = rotate(quati, t);
+            }
+        h_force.data[idx].x = f.x;
+        h_force.data[idx].y = f.y;
+        h_force.data[idx].z = f.z;
 
-        Scalar new_norm = slow::sqrt(h_f_actVec.data[i].x*h_f_actVec.data[i].x
-                                     + h_f_actVec.data[i].y*h_f_actVec.data[i].y
-                                     + h_f_actVec.data[i].z*h_f_actVec.data[i].z);
+        h_torque.data[idx].x = t.x;
+        h_torque.data[idx].y = t.y;
+        h_torque.data[idx].z = t.z;
 
-        h_f_actVec.data[i].x /= new_norm;
-        h_f_actVec.data[i].y /= new_norm;
-        h_f_actVec.data[i].z /= new_norm;
+        // rotate particle orientation only if orientation is reverse linked to active force vector. Does not operate on torque vector
+        if (m_orientationReverseLink == true)
+            {
+            vec3<Scalar> f_act(h_f_actMag.data[i]*f_vec);
+            vec3<Scalar> vecZ(0.0, 0.0, 1.0);
+            vec3<Scalar> quatVec = cross(vecZ, f_act);
+            Scalar quatScal = slow::sqrt(h_f_actMag.data[i]*h_f_actMag.data[i]) + dot(f_act, vecZ);
+            quat<Scalar> quati(quatScal, quatVec);
+            quati = quati * (Scalar(1.0) / slow::sqrt(norm2(quati)));
+            h_orientation.data[idx] = quat_to_scalar4(quati);
+            }
         }
+    #ifdef ENABLE_TBB
+        );
+    #endif
     }
 
 /*! This function applies constraints, rotational diffusion, and sets forces for all active particles
@@ -383,15 +311,8 @@ void ActiveForceCompute::computeForces(unsigned int timestep)
 
         last_computed = timestep;
 
-        if (m_rx != 0)
-            {
-            setConstraint(); // apply surface constraints to active particles active force vectors
-            }
-        if (m_rotationDiff != 0)
-            {
-            rotationalDiffusion(timestep); // apply rotational diffusion to active particles
-            }
-        setForces(); // set forces for particles
+        // apply surface constraints and rotational diffusion to active particles and set their forces
+        updateActiveForces(timestep);
         }
 
     #ifdef ENABLE_CUDA
@@ -50,14 +50,8 @@ class PYBIND11_EXPORT ActiveForceCompute : public ForceCompute
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
 
-        //! Set forces for particles
-        virtual void setForces();
-
-        //! Orientational diffusion for spherical particles
-        virtual void rotationalDiffusion(unsigned int timestep);
-
-        //! Set constraints if particles confined to a surface
-        virtual void setConstraint();
+        //! Apply the surface constraint and orientational diffusion and set the forces in one pass over the particles
+        virtual void updateActiveForces(unsigned int timestep);
 
         std::shared_ptr<ParticleGroup> m_group;   //!< Group of particles on which this force is applied
         bool m_orientationLink;
@@ -87,19 +87,23 @@ ActiveForceComputeGPU::ActiveForceComputeGPU(std::shared_ptr<SystemDefinition> s
     m_groupTags.swap(tmp_groupTags);
     }
 
-/*! This function sets appropriate active forces and torques on all active particles.
+/*! This function applies the surface constraint and rotational diffusion to the active force vectors and sets
+    the active forces and torques on all active particles in a single kernel launch. The angle between the torque
+    vector and force vector does not change.
+    \param timestep Current timestep
 */
-void ActiveForceComputeGPU::setForces()
+void ActiveForceComputeGPU::updateActiveForces(unsigned int timestep)
     {
     //  array handles
-    ArrayHandle<Scalar3> d_f_actVec(m_f_activeVec, access_location::device, access_mode::read);
+    ArrayHandle<Scalar3> d_f_actVec(m_f_activeVec, access_location::device, access_mode::readwrite);
     ArrayHandle<Scalar> d_f_actMag(m_f_activeMag, access_location::device, access_mode::read);
     ArrayHandle<Scalar4> d_force(m_force, access_location::device, access_mode::overwrite);
 
-    ArrayHandle<Scalar3> d_t_actVec(m_t_activeVec, access_location::device, access_mode::read);
+    ArrayHandle<Scalar3> d_t_actVec(m_t_activeVec, access_location::device, access_mode::readwrite);
     ArrayHandle<Scalar> d_t_actMag(m_t_activeMag, access_location::device, access_mode::read);
     ArrayHandle<Scalar4> d_torque(m_torque, access_location::device, access_mode::overwrite);
 
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
     ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device, access_mode::readwrite);
     ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_groupTags(m_groupTags, access_location::device, access_mode::read);
@@ -110,105 +114,43 @@ void ActiveForceComputeGPU::setForces()
     assert(d_f_actMag.data != NULL);
     assert(d_t_actVec.data != NULL);
     assert(d_t_actMag.data != NULL);
+    assert(d_pos.data != NULL);
     assert(d_orientation.data != NULL);
     assert(d_rtag.data != NULL);
     assert(d_groupTags.data != NULL);
     bool orientationLink = (m_orientationLink == true);
     bool orientationReverseLink = (m_orientationReverseLink == true);
-    unsigned int group_size = m_group->getNumMembers();
-    unsigned int N = m_pdata->getN();
-
-    gpu_compute_active_force_set_forces(group_size,
-                                     d_rtag.data,
-                                     d_groupTags.data,
-                                     d_force.data,
-                                     d_torque.data,
-                                     d_orientation.data,
-                                     d_f_actVec.data,
-                                     d_f_actMag.data,
-                                     d_t_actVec.data,
-                                     d_t_actMag.data,
-                                     m_P,
-                                     m_rx,
-                                     m_ry,
-                                     m_rz,
-                                     orientationLink,
-                                     orientationReverseLink,
-                                     N,
-                                     m_block_size);
-    }
-
-/*! This function applies rotational diffusion to all active particles. The angle between the torque vector and
- * force vector does not change
-    \param timestep Current timestep
-*/
-void ActiveForceComputeGPU::rotationalDiffusion(unsigned int timestep)
-    {
-    //  array handles
-    ArrayHandle<Scalar3> d_f_actVec(m_f_activeVec, access_location::device, access_mode::readwrite);
-    ArrayHandle<Scalar3> d_t_actVec(m_t_activeVec, access_location::device, access_mode::readwrite);
-    ArrayHandle<Scalar4> d_pos(m_pdata -> getPositions(), access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_force(m_force, access_location::device, access_mode::overwrite);
-    ArrayHandle<Scalar4> d_torque(m_torque, access_location::device, access_mode::overwrite);
-    ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_groupTags(m_groupTags, access_location::device, access_mode::read);
-
-    assert(d_pos.data != NULL);
-
+    bool constraint = (m_rx != 0);
+    bool diffusion = (m_rotationDiff != 0);
     bool is2D = (m_sysdef->getNDimensions() == 2);
     unsigned int group_size = m_group->getNumMembers();
+    unsigned int N = m_pdata->getN();
 
-    gpu_compute_active_force_rotational_diffusion(group_size,
-                                                d_rtag.data,
-                                                d_groupTags.data,
-                                                d_pos.data,
-                                                d_force.data,
-                                                d_torque.data,
-                                                d_f_actVec.data,
-                                                d_t_actVec.data,
-                                                m_P,
-                                                m_rx,
-                                                m_ry,
-                                                m_rz,
-                                                is2D,
-                                                m_rotationConst,
-                                                timestep,
-                                                m_seed,
-                                                m_block_size);
-    }
-
-/*! This function sets an ellipsoid surface constraint for all active particles
-*/
-void ActiveForceComputeGPU::setConstraint()
-    {
-    EvaluatorConstraintEllipsoid Ellipsoid(m_P, m_rx, m_ry, m_rz);
-
-    //  array handles
-    ArrayHandle<Scalar3> d_f_actVec(m_f_activeVec, access_location::device, access_mode::readwrite);
-    ArrayHandle<Scalar3> d_t_actVec(m_t_activeVec, access_location::device, access_mode::readwrite);
-    ArrayHandle<Scalar4> d_pos(m_pdata -> getPositions(), access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_force(m_force, access_location::device, access_mode::overwrite);
-    ArrayHandle<Scalar4> d_torque(m_torque, access_location::device, access_mode::overwrite);
-    ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_groupTags(m_groupTags, access_location::device, access_mode::read);
-
-    assert(d_pos.data != NULL);
-
-    unsigned int group_size = m_group->getNumMembers();
-
-    gpu_compute_active_force_set_constraints(group_size,
-                                             d_rtag.data,
-                                             d_groupTags.data,
-                                             d_pos.data,
-                                             d_force.data,
-                                             d_torque.data,
-                                             d_f_actVec.data,
-                                             d_t_actVec.data,
-                                             m_P,
-                                             m_rx,
-                                             m_ry,
-                                             m_rz,
-                                             m_block_size);
+    gpu_compute_active_force_update(group_size,
+                                    d_rtag.data,
+                                    d_groupTags.data,
+                                    d_pos.data,
+                                    d_force.data,
+                                    d_torque.data,
+                                    d_orientation.data,
+                                    d_f_actVec.data,
+                                    d_f_actMag.data,
+                                    d_t_actVec.data,
+                                    d_t_actMag.data,
+                                    m_P,
+                                    m_rx,
+                                    m_ry,
+                                    m_rz,
+                                    orientationLink,
+                                    orientationReverseLink,
+                                    constraint,
+                                    diffusion,
+                                    is2D,
+                                    m_rotationConst,
+                                    timestep,
+                                    m_seed,
+                                    N,
+                                    m_block_size);
     }
 
 void export_ActiveForceComputeGPU(py::module& m)
@@ -15,10 +15,11 @@ using namespace hoomd;
     \brief Declares GPU kernel code for calculating active forces forces on the GPU. Used by ActiveForceComputeGPU.
 */
 
-//! Kernel for setting active force vectors on the GPU
+//! Kernel for constraining, diffusing and setting the active force vectors on the GPU
 /*! \param group_size number of particles
     \param d_rtag convert global tag to global index
     \param d_groupTags stores list to convert group index to global tag
+    \param d_pos particle positions on device
     \param d_force particle force on device
     \param d_torque particle torque on device
     \param d_orientation particle orientation on device
@@ -31,24 +32,40 @@ using namespace hoomd;
     \param ry radius of the ellipsoid in y direction
     \param rz radius of the ellipsoid in z direction
     \param orientationLink check if particle orientation is linked to active force vector
+    \param orientationReverseLink check if the active force vector is linked to particle orientation
+    \param constraint apply the ellipsoid surface constraint
+    \param diffusion apply rotational diffusion
+    \param is2D check if simulation is 2D or 3D
+    \param rotationDiff particle rotational diffusion constant
+    \param timestep current timestep
+    \param seed seed for random number generator
+
+    Every thread loads the active vectors of its particle once, projects them onto the tangent plane of the
+    constraint, rotates them by the random diffusion angle and sets the force and torque.
 */
-__global__ void gpu_compute_active_force_set_forces_kernel(const unsigned int group_size,
-                                                    unsigned int *d_rtag,
-                                                    unsigned int *d_groupTags,
+__global__ void gpu_compute_active_force_update_kernel(const unsigned int group_size,
+                                                    const unsigned int *d_rtag,
+                                                    const unsigned int *d_groupTags,
+                                                    const Scalar4 *d_pos,
                                                     Scalar4 *d_force,
                                                     Scalar4 *d_torque,
                                                     Scalar4 *d_orientation,
                                                     Scalar3 *d_f_actVec,
-                                                    Scalar *d_f_actMag,
+                                                    const Scalar *d_f_actMag,
                                                     Scalar3 *d_t_actVec,
-                                                    Scalar *d_t_actMag,
-                                                    const Scalar3& P,
+                                                    const Scalar *d_t_actMag,
+                                                    const Scalar3 P,
                                                     Scalar rx,
                                                     Scalar ry,
                                                     Scalar rz,
                                                     bool orientationLink,
                                                     bool orientationReverseLink,
-                                                    const unsigned int N)
+                                                    bool constraint,
+                                                    bool diffusion,
+                                                    bool is2D,
+                                                    const Scalar rotationDiff,
+                                                    const unsigned int timestep,
+                                                    const int seed)
     {
     unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
     if (group_idx >= group_size)
@@ -57,262 +74,132 @@ __global__ void gpu_compute_active_force_set_forces_kernel(const unsigned int gr
     unsigned int tag = d_groupTags[group_idx];
     unsigned int idx = d_rtag[tag];
 
-    Scalar3 f;
-    Scalar3 t;
-    // rotate force according to particle orientation only if orientation is linked to active force vector
-    if (orientationLink == true)
-        {
-        vec3<Scalar> fi;
-        f = make_scalar3(d_f_actMag[tag] * d_f_actVec[tag].x,
-                        d_f_actMag[tag] * d_f_actVec[tag].y, d_f_actMag[tag] * d_f_actVec[tag].z);
-        quat<Scalar> quati(d_orientation[idx]);
-        fi = rotate(quati, vec3<Scalar>(f));
-        d_force[idx].x = fi.x;
-        d_force[idx].y = fi.y;
-        d_force[idx].z = fi.z;
-
-        vec3<Scalar> ti;
-        t = make_scalar3(d_t_actMag[tag] * d_t_actVec[tag].x,
-                        d_t_actMag[tag] * d_t_actVec[tag].y, d_t_actMag[tag] * d_t_actVec[tag].z);
-        ti = rotate(quati, vec3<Scalar>(t));
-        d_torque[idx].x = ti.x;
-        d_torque[idx].y = ti.y;
-        d_torque[idx].z = ti.z;
+    vec3<Scalar> f_vec(d_f_actVec[tag]);
+    vec3<Scalar> t_vec(d_t_actVec[tag]);
 
-        }
-    else // no orientation link
+    // the normal vector to which the particles are confined.
+    vec3<Scalar> norm;
+    if (constraint)
         {
-        f = make_scalar3(d_f_actMag[tag] * d_f_actVec[tag].x,
-                        d_f_actMag[tag] * d_f_actVec[tag].y, d_f_actMag[tag] * d_f_actVec[tag].z);
-        d_force[idx].x = f.x;
-        d_force[idx].y = f.y;
-        d_force[idx].z = f.z;
+        EvaluatorConstraintEllipsoid Ellipsoid(P, rx, ry, rz);
+        Scalar3 current_pos = make_scalar3(d_pos[idx].x, d_pos[idx].y, d_pos[idx].z);
+        norm = vec3<Scalar>(Ellipsoid.evalNormal(current_pos));
 
-        t = make_scalar3(d_t_actMag[tag] * d_t_actVec[tag].x,
-                        d_t_actMag[tag] * d_t_actVec[tag].y, d_t_actMag[tag] * d_t_actVec[tag].z);
-        d_torque[idx].x = t.x;
-        d_torque[idx].y = t.y;
-        d_torque[idx].z = t.z;
+        f_vec -= norm * dot(f_vec, norm);
+        t_vec -= norm * dot(t_vec, norm);
 
+        f_vec = f_vec * (Scalar(1.0) / sqrt(dot(f_vec, f_vec)));
+        t_vec = t_vec * (Scalar(1.0) / sqrt(dot(t_vec, t_vec)));
         }
-    // rotate particle orientation only if orientation is reverse linked to active force vector. Ignore torque here
-    if (orientationReverseLink == true)
-        {
-        vec3<Scalar> f(d_f_actMag[tag] * d_f_actVec[tag].x,
-                        d_f_actMag[tag] * d_f_actVec[tag].y, d_f_actMag[tag] * d_f_actVec[tag].z);
-        vec3<Scalar> vecZ(0.0, 0.0, 1.0);
-        vec3<Scalar> quatVec = cross(vecZ, f);
-        Scalar quatScal = slow::sqrt(d_f_actMag[tag]*d_f_actMag[tag]) + dot(f, vecZ);
-        quat<Scalar> quati(quatScal, quatVec);
-        quati = quati * (Scalar(1.0) / slow::sqrt(norm2(quati)));
-        d_orientation[idx] = quat_to_scalar4(quati);
-        }
-    }
-
-//! Kernel for adjusting active force vectors to align parallel to an ellipsoid surface constraint on the GPU
-/*! \param group_size number of particles
-    \param d_rtag convert global tag to global index
-    \param d_groupTags stores list to convert group index to global tag
-    \param d_pos particle positions on device
-    \param d_f_actVec particle active force unit vector
-    \param d_t_actVec particle active force unit vector
-    \param P position of the ellipsoid constraint
-    \param rx radius of the ellipsoid in x direction
-    \param ry radius of the ellipsoid in y direction
-    \param rz radius of the ellipsoid in z direction
-*/
-__global__ void gpu_compute_active_force_set_constraints_kernel(const unsigned int group_size,
-                                                   unsigned int *d_rtag,
-                                                   unsigned int *d_groupTags,
-                                                   const Scalar4 *d_pos,
-                                                   Scalar3 *d_f_actVec,
-                                                   Scalar3 *d_t_actVec,
-                                                   const Scalar3& P,
-                                                   Scalar rx,
-                                                   Scalar ry,
-                                                   Scalar rz)
-    {
-    unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
-    if (group_idx >= group_size)
-        return;
-
-    unsigned int tag = d_groupTags[group_idx];
-    unsigned int idx = d_rtag[tag];
-
-    EvaluatorConstraintEllipsoid Ellipsoid(P, rx, ry, rz);
-    Scalar3 current_pos = make_scalar3(d_pos[idx].x, d_pos[idx].y, d_pos[idx].z);
-
-    Scalar3 norm_scalar3 = Ellipsoid.evalNormal(current_pos); // the normal vector to which the particles are confined.
-    vec3<Scalar> norm;
-    norm = vec3<Scalar>(norm_scalar3);
-    Scalar f_dot_prod = d_f_actVec[tag].x * norm.x + d_f_actVec[tag].y * norm.y + d_f_actVec[tag].z * norm.z;
-    Scalar t_dot_prod = d_t_actVec[tag].x * norm.x + d_t_actVec[tag].y * norm.y + d_t_actVec[tag].z * norm.z;
-
-    d_f_actVec[tag].x -= norm.x * f_dot_prod;
-    d_f_actVec[tag].y -= norm.y * f_dot_prod;
-    d_f_actVec[tag].z -= norm.z * f_dot_prod;
-
-    d_t_actVec[tag].x -= norm.x * t_dot_prod;
-    d_t_actVec[tag].y -= norm.y * t_dot_prod;
-    d_t_actVec[tag].z -= norm.z * t_dot_prod;
-
-
-    Scalar new_f_norm = slow::sqrt(d_f_actVec[tag].x * d_f_actVec[tag].x
-                                 + d_f_actVec[tag].y * d_f_actVec[tag].y
-                                 + d_f_actVec[tag].z * d_f_actVec[tag].z);
-    Scalar new_t_norm = slow::sqrt(d_t_actVec[tag].x * d_t_actVec[tag].x
-                                 + d_t_actVec[tag].y * d_t_actVec[tag].y
-                                 + d_t_actVec[tag].z * d_t_actVec[tag].z);
-
-
-    d_f_actVec[tag].x /= new_f_norm;
-    d_f_actVec[tag].y /= new_f_norm;
-    d_f_actVec[tag].z /= new_f_norm;
-
-    d_t_actVec[tag].x /= new_t_norm;
-    d_t_actVec[tag].y /= new_t_norm;
-    d_t_actVec[tag].z /= new_t_norm;
-
-    }
-
-//! Kernel for applying rotational diffusion to active force vectors on the GPU
-/*! \param group_size number of particles
-    \param d_rtag convert global tag to global index
-    \param d_groupTags stores list to convert group index to global tag
-    \param d_pos particle positions on device
-    \param d_f_actVec particle active force unit vector
-    \param d_t_actVec particle active torque unit vector
-    \param P position of the ellipsoid constraint
-    \param rx radius of the ellipsoid in x direction
-    \param ry radius of the ellipsoid in y direction
-    \param rz radius of the ellipsoid in z direction
-    \param is2D check if simulation is 2D or 3D
-    \param rotationDiff particle rotational diffusion constant
-    \param seed seed for random number generator
-*/
-__global__ void gpu_compute_active_force_rotational_diffusion_kernel(const unsigned int group_size,
-                                                   unsigned int *d_rtag,
-                                                   unsigned int *d_groupTags,
-                                                   const Scalar4 *d_pos,
-                                                   Scalar3 *d_f_actVec,
-                                                   Scalar3 *d_t_actVec,
-                                                   const Scalar3& P,
-                                                   Scalar rx,
-                                                   Scalar ry,
-                                                   Scalar rz,
-                                                   bool is2D,
-                                                   const Scalar rotationDiff,
-                                                   const unsigned int timestep,
-                                                   const int seed)
-    {
-    unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
-    if (group_idx >= group_size)
-        return;
-
-    unsigned int tag = d_groupTags[group_idx];
-    unsigned int idx = d_rtag[tag];
 
-    if (is2D) // 2D
+    if (diffusion)
         {
         detail::Saru saru(tag, timestep, seed);
-        Scalar delta_theta; // rotational diffusion angle
-        delta_theta = rotationDiff * gaussian_rng(saru, 1.0);
-        Scalar theta; // angle on plane defining orientation of active force vector
-        theta = atan2(d_f_actVec[tag].y, d_f_actVec[tag].x);
-        theta += delta_theta;
-        d_f_actVec[tag].x = cos(theta);
-        d_f_actVec[tag].y = sin(theta);
-        // in 2D there is only one meaningful direction for torque
-        }
-    else // 3D: Following Stenhammar, Soft Matter, 2014
-        {
-        if (rx == 0) // if no constraint
-            {
-            detail::Saru saru(tag, timestep, seed);
-            Scalar u = saru.d(0, 1.0); // generates an even distribution of random unit vectors in 3D
-            Scalar v = saru.d(0, 1.0);
-            Scalar theta = 2.0 * M_PI * u;
-            Scalar phi = acos(2.0 * v - 1.0);
-
-            vec3<Scalar> rand_vec;
-            rand_vec.x = sin(phi) * cos(theta);
-            rand_vec.y = sin(phi) * sin(theta);
-            rand_vec.z = cos(phi);
 
+        if (is2D) // 2D
+            {
+            Scalar delta_theta; // rotational diffusion angle
+            delta_theta = rotationDiff * gaussian_rng(saru, 1.0);
+            Scalar theta; // angle on plane defining orientation of active force vector
+            theta = atan2(f_vec.y, f_vec.x);
+            theta += delta_theta;
+            f_vec.x = cos(theta);
+            f_vec.y = sin(theta);
+            // in 2D there is only one meaningful direction for torque
+            }
+        else // 3D: Following Stenhammar, Soft Matter, 2014
+            {
             vec3<Scalar> aux_vec;
-            aux_vec.x = d_f_actVec[tag].y * rand_vec.z - d_f_actVec[tag].z * rand_vec.y;
-            aux_vec.y = d_f_actVec[tag].z * rand_vec.x - d_f_actVec[tag].x * rand_vec.z;
-            aux_vec.z = d_f_actVec[tag].x * rand_vec.y - d_f_actVec[tag].y * rand_vec.x;
-            Scalar aux_vec_mag = sqrt(aux_vec.x*aux_vec.x + aux_vec.y*aux_vec.y + aux_vec.z*aux_vec.z);
-            aux_vec.x /= aux_vec_mag;
-            aux_vec.y /= aux_vec_mag;
-            aux_vec.z /= aux_vec_mag;
-
-            vec3<Scalar> current_vec;
-            current_vec.x = d_f_actVec[tag].x;
-            current_vec.y = d_f_actVec[tag].y;
-            current_vec.z = d_f_actVec[tag].z;
+            if (!constraint)
+                {
+                Scalar u = saru.d(0, 1.0); // generates an even distribution of random unit vectors in 3D
+                Scalar v = saru.d(0, 1.0);
+                Scalar theta = 2.0 * M_PI * u;
+                Scalar phi = acos(2.0 * v - 1.0);
+
+                vec3<Scalar> rand_vec;
+                rand_vec.x = sin(phi) * cos(theta);
+                rand_vec.y = sin(phi) * sin(theta);
+                rand_vec.z = cos(phi);
+
+                aux_vec = cross(f_vec, rand_vec);
+                aux_vec = aux_vec * (Scalar(1.0) / sqrt(dot(aux_vec, aux_vec)));
+                }
+            else
+                {
+                // aux vec for defining direction that active force vector rotates towards.
+                aux_vec = cross(f_vec, norm);
+                }
 
             Scalar delta_theta = rotationDiff * gaussian_rng(saru, 1.0);
-            d_f_actVec[tag].x = cos(delta_theta)*current_vec.x + sin(delta_theta)*aux_vec.x;
-            d_f_actVec[tag].y = cos(delta_theta)*current_vec.y + sin(delta_theta)*aux_vec.y;
-            d_f_actVec[tag].z = cos(delta_theta)*current_vec.z + sin(delta_theta)*aux_vec.z;
+            f_vec = cos(delta_theta) * f_vec + sin(delta_theta) * aux_vec;
 
             // torque vector rotates rigidly along with force vector
-            d_t_actVec[tag].x = cos(delta_theta)*current_vec.x + sin(delta_theta)*aux_vec.x;
-            d_t_actVec[tag].y = cos(delta_theta)*current_vec.y + sin(delta_theta)*aux_vec.y;
-            d_t_actVec[tag].z = cos(delta_theta)*current_vec.z + sin(delta_theta)*aux_vec.z;
-
+            t_vec = f_vec;
             }
-        else // if constraint
-            {
-            EvaluatorConstraintEllipsoid Ellipsoid(P, rx, ry, rz);
-            detail::Saru saru(tag, timestep, seed);
-            Scalar3 current_pos = make_scalar3(d_pos[idx].x, d_pos[idx].y, d_pos[idx].z);
-
-            Scalar3 norm_scalar3 = Ellipsoid.evalNormal(current_pos); // the normal vector to which the particles are confined.
-            vec3<Scalar> norm;
-            norm = vec3<Scalar> (norm_scalar3);
+        }
 
-            vec3<Scalar> current_vec;
-            current_vec.x = d_f_actVec[tag].x;
-            current_vec.y = d_f_actVec[tag].y;
-            current_vec.z = d_f_actVec[tag].z;
-            vec3<Scalar> aux_vec = cross(current_vec, norm); // aux vec for defining direction that active force vector rotates towards.
+    if (constraint || diffusion)
+        {
+        d_f_actVec[tag] = vec_to_scalar3(f_vec);
+        d_t_actVec[tag] = vec_to_scalar3(t_vec);
+        }
 
-            Scalar delta_theta; // rotational diffusion angle
-            delta_theta = rotationDiff * gaussian_rng(saru, 1.0);
+    Scalar f_mag = d_f_actMag[tag];
+    vec3<Scalar> f = f_mag * f_vec;
+    vec3<Scalar> t = d_t_actMag[tag] * t_vec;
 
-            d_f_actVec[tag].x = cos(delta_theta) * current_vec.x + sin(delta_theta) * aux_vec.x;
-            d_f_actVec[tag].y = cos(delta_theta) * current_vec.y + sin(delta_theta) * aux_vec.y;
-            d_f_actVec[tag].z = cos(delta_theta) * current_vec.z + sin(delta_theta) * aux_vec.z;
+    // rotate force according to particle orientation only if orientation is linked to active force vector
+    if (orientationLink == true)
+        {
+        quat<Scalar> quati(d_orientation[idx]);
+        f = rotate(quati, f);
+        t = rotate(quati, t);
+        }
+    d_force[idx].x = f.x;
+    d_force[idx].y = f.y;
+    d_force[idx].z = f.z;
 
-            // torque vector rotates rigidly along with force vector
-            d_t_actVec[tag].x = cos(delta_theta) * current_vec.x + sin(delta_theta) * aux_vec.x;
-            d_t_actVec[tag].y = cos(delta_theta) * current_vec.y + sin(delta_theta) * aux_vec.y;
-            d_t_actVec[tag].z = cos(delta_theta) * current_vec.z + sin(delta_theta) * aux_vec.z;
+    d_torque[idx].x = t.x;
+    d_torque[idx].y = t.y;
+    d_torque[idx].z = t.z;
 
-            }
+    // rotate particle orientation only if orientation is reverse linked to active force vector. Ignore torque here
+    if (orientationReverseLink == true)
+        {
+        vec3<Scalar> f_act = f_mag * f_vec;
+        vec3<Scalar> vecZ(0.0, 0.0, 1.0);
+        vec3<Scalar> quatVec = cross(vecZ, f_act);
+        Scalar quatScal = slow::sqrt(f_mag*f_mag) + dot(f_act, vecZ);
+        quat<Scalar> quati(quatScal, quatVec);
+        quati = quati * (Scalar(1.0) / slow::sqrt(norm2(quati)));
+        d_orientation[idx] = quat_to_scalar4(quati);
         }
     }
 
-
-cudaError_t gpu_compute_active_force_set_forces(const unsigned int group_size,
-                                           unsigned int *d_rtag,
-                                           unsigned int *d_groupTags,
+cudaError_t gpu_compute_active_force_update(const unsigned int group_size,
+                                           const unsigned int *d_rtag,
+                                           const unsigned int *d_groupTags,
+                                           const Scalar4 *d_pos,
                                            Scalar4 *d_force,
                                            Scalar4 *d_torque,
                                            Scalar4 *d_orientation,
                                            Scalar3 *d_f_actVec,
-                                           Scalar *d_f_actMag,
+                                           const Scalar *d_f_actMag,
                                            Scalar3 *d_t_actVec,
-                                           Scalar *d_t_actMag,
+                                           const Scalar *d_t_actMag,
                                            const Scalar3& P,
                                            Scalar rx,
                                            Scalar ry,
                                            Scalar rz,
                                            bool orientationLink,
                                            bool orientationReverseLink,
+                                           bool constraint,
+                                           bool diffusion,
+                                           bool is2D,
+                                           const Scalar rotationDiff,
+                                           const unsigned int timestep,
+                                           const int seed,
                                            const unsigned int N,
                                            unsigned int block_size)
     {
@@ -320,99 +207,33 @@ cudaError_t gpu_compute_active_force_set_forces(const unsigned int group_size,
     dim3 grid( group_size / block_size + 1, 1, 1);
     dim3 threads(block_size, 1, 1);
 
-    // run the kernel
+    // zero forces so we don't leave any forces set for indices that are no longer part of our group
     cudaMemset(d_force, 0, sizeof(Scalar4)*N);
-    gpu_compute_active_force_set_forces_kernel<<< grid, threads>>>( group_size,
-                                                                    d_rtag,
-                                                                    d_groupTags,
-                                                                    d_force,
-                                                                    d_torque,
-                                                                    d_orientation,
-                                                                    d_f_actVec,
-                                                                    d_f_actMag,
-                                                                    d_t_actVec,
-                                                                    d_t_actMag,
-                                                                    P,
-                                                                    rx,
-                                                                    ry,
-                                                                    rz,
-                                                                    orientationLink,
-                                                                    orientationReverseLink,
-                                                                    N);
-    return cudaSuccess;
-    }
-
-cudaError_t gpu_compute_active_force_set_constraints(const unsigned int group_size,
-                                                   unsigned int *d_rtag,
-                                                   unsigned int *d_groupTags,
-                                                   const Scalar4 *d_pos,
-                                                   Scalar4 *d_force,
-                                                   Scalar4 *d_torque,
-                                                   Scalar3 *d_f_actVec,
-                                                   Scalar3 *d_t_actVec,
-                                                   const Scalar3& P,
-                                                   Scalar rx,
-                                                   Scalar ry,
-                                                   Scalar rz,
-                                                   unsigned int block_size)
-    {
-    // setup the grid to run the kernel
-    dim3 grid( group_size / block_size + 1, 1, 1);
-    dim3 threads(block_size, 1, 1);
+    cudaMemset(d_torque, 0, sizeof(Scalar4)*N);
 
     // run the kernel
-    gpu_compute_active_force_set_constraints_kernel<<< grid, threads>>>(group_size,
-                                                                    d_rtag,
-                                                                    d_groupTags,
-                                                                    d_pos,
-                                                                    d_f_actVec,
-                                                                    d_t_actVec,
-                                                                    P,
-                                                                    rx,
-                                                                    ry,
-                                                                    rz);
+    gpu_compute_active_force_update_kernel<<< grid, threads>>>(group_size,
+                                                                d_rtag,
+                                                                d_groupTags,
+                                                                d_pos,
+                                                                d_force,
+                                                                d_torque,
+                                                                d_orientation,
+                                                                d_f_actVec,
+                                                                d_f_actMag,
+                                                                d_t_actVec,
+                                                                d_t_actMag,
+                                                                P,
+                                                                rx,
+                                                                ry,
+                                                                rz,
+                                                                orientationLink,
+                                                                orientationReverseLink,
+                                                                constraint,
+                                                                diffusion,
+                                                                is2D,
+                                                                rotationDiff,
+                                                                timestep,
+                                                                seed);
     return cudaSuccess;
     }
-
-cudaError_t gpu_compute_active_force_rotational_diffusion(const unsigned int group_size,
-                                                       unsigned int *d_rtag,
-                                                       unsigned int *d_groupTags,
-                                                       const Scalar4 *d_pos,
-                                                       Scalar4 *d_force,
-                                                       Scalar4 *d_torque,
-                                                       Scalar3 *d_f_actVec,
-                                                       Scalar3 *d_t_actVec,
-                                                       const Scalar3& P,
-                                                       Scalar rx,
-                                                       Scalar ry,
-                                                       Scalar rz,
-                                                       bool is2D,
-                                                       const Scalar rotationDiff,
-                                                       const unsigned int timestep,
-                                                       const int seed,
-                                                       unsigned int block_size)
-    {
-    // setup the grid to run the kernel
-    dim3 grid( group_size / block_size + 1, 1, 1);
-    dim3 threads(block_size, 1, 1);
-
-    // run the kernel
-    gpu_compute_active_force_rotational_diffusion_kernel<<< grid, threads>>>(group_size,
-                                                                    d_rtag,
-                                                                    d_groupTags,
-                                                                    d_pos,
-                                                                    d_f_actVec,
-                                                                    d_t_actVec,
-                                                                    P,
-                                                                    rx,
-                                                                    ry,
-                                                                    rz,
-                                                                    is2D,
-                                                                    rotationDiff,
-                                                                    timestep,
-                                                                    seed);
-    return cudaSuccess;
-    }
-
-
-
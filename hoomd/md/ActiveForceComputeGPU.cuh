@@ -14,57 +14,31 @@
 #ifndef __ACTIVE_FORCE_COMPUTE_GPU_CUH__
 #define __ACTIVE_FORCE_COMPUTE_GPU_CUH__
 
-cudaError_t gpu_compute_active_force_set_forces(const unsigned int group_size,
-                                           unsigned int *d_rtag,
-                                           unsigned int *d_groupTags,
+//! Constrain and diffuse the active force vectors and set the active forces and torques in one kernel
+cudaError_t gpu_compute_active_force_update(const unsigned int group_size,
+                                           const unsigned int *d_rtag,
+                                           const unsigned int *d_groupTags,
+                                           const Scalar4 *d_pos,
                                            Scalar4 *d_force,
                                            Scalar4 *d_torque,
                                            Scalar4 *d_orientation,
                                            Scalar3 *d_f_actVec,
-                                           Scalar *d_f_actMag,
+                                           const Scalar *d_f_actMag,
                                            Scalar3 *d_t_actVec,
-                                           Scalar *d_t_actMag,
+                                           const Scalar *d_t_actMag,
                                            const Scalar3& P,
                                            Scalar rx,
                                            Scalar ry,
                                            Scalar rz,
                                            bool orientationLink,
                                            bool orientationReverseLink,
+                                           bool constraint,
+                                           bool diffusion,
+                                           bool is2D,
+                                           const Scalar rotationDiff,
+                                           const unsigned int timestep,
+                                           const int seed,
                                            const unsigned int N,
                                            unsigned int block_size);
 
-cudaError_t gpu_compute_active_force_set_constraints(const unsigned int group_size,
-                                                   unsigned int *d_rtag,
-                                                   unsigned int *d_groupTags,
-                                                   const Scalar4 *d_pos,
-                                                   Scalar4 *d_force,
-                                                   Scalar4 *d_torque,
-                                                   Scalar3 *d_f_actVec,
-                                                   Scalar3 *d_t_actVec,
-                                                   const Scalar3& P,
-                                                   Scalar rx,
-                                                   Scalar ry,
-                                                   Scalar rz,
-                                                   unsigned int block_size);
-
-cudaError_t gpu_compute_active_force_rotational_diffusion(const unsigned int group_size,
-                                                       unsigned int *d_rtag,
-                                                       unsigned int *d_groupTags,
-                                                       const Scalar4 *d_pos,
-                                                       Scalar4 *d_force,
-                                                       Scalar4 *d_torque,
-                                                       Scalar3 *d_f_actVec,
-                                                       Scalar3 *d_t_actVec,
-                                                       const Scalar3& P,
-                                                       Scalar rx,
-                                                       Scalar ry,
-                                                       Scalar rz,
-                                                       bool is2D,
-                                                       const Scalar rotationDiff,
-                                                       const unsigned int timestep,
-                                                       const int seed,
-                                                       unsigned int block_size);
-
-
-
 #endif
@@ -38,14 +38,8 @@ class PYBIND11_EXPORT ActiveForceComputeGPU : public ActiveForceCompute
     protected:
         unsigned int m_block_size;  //!< block size to execute on the GPU
 
-        //! Set forces for particles
-        virtual void setForces();
-
-        //! Orientational diffusion for spherical particles
-        virtual void rotationalDiffusion(unsigned int timestep);
-
-        //! Set constraints if particles confined to a surface
-        virtual void setConstraint();
+        //! Apply the surface constraint and orientational diffusion and set the forces in one kernel
+        virtual void updateActiveForces(unsigned int timestep);
 
         GPUArray<unsigned int>  m_groupTags; //! Stores list converting group index to global tag
     };
@@ -11,6 +11,7 @@
 
 #include "EvaluatorPairGB.h"
 #include "EvaluatorPairDipole.h"
+#include "EvaluatorPairDipoleEwald.h"
 
 #ifdef ENABLE_CUDA
 #include "AnisoPotentialPairGPU.h"
@@ -26,12 +27,16 @@
 typedef AnisoPotentialPair<EvaluatorPairGB> AnisoPotentialPairGB;
 //! Pair potential force compute for dipole forces and torques
 typedef AnisoPotentialPair<EvaluatorPairDipole> AnisoPotentialPairDipole;
+//! Pair potential force compute for the real space part of the dipolar Ewald sum
+typedef AnisoPotentialPair<EvaluatorPairDipoleEwald> AnisoPotentialPairDipoleEwald;
 
 #ifdef ENABLE_CUDA
 //! Pair potential force compute for Gay-Berne forces and torques on the GPU
 typedef AnisoPotentialPairGPU<EvaluatorPairGB,gpu_compute_pair_aniso_forces_gb> AnisoPotentialPairGBGPU;
 //! Pair potential force compute for dipole forces and torques on the GPU
 typedef AnisoPotentialPairGPU<EvaluatorPairDipole,gpu_compute_pair_aniso_forces_dipole> AnisoPotentialPairDipoleGPU;
+//! Pair potential force compute for the real space part of the dipolar Ewald sum on the GPU
+typedef AnisoPotentialPairGPU<EvaluatorPairDipoleEwald,gpu_compute_pair_aniso_forces_dipole_ewald> AnisoPotentialPairDipoleEwaldGPU;
 #endif
 
 //
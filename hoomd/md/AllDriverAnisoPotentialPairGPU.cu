@@ -21,3 +21,9 @@ cudaError_t gpu_compute_pair_aniso_forces_dipole(const a_pair_args_t& pair_args,
     {
     return gpu_compute_pair_aniso_forces<EvaluatorPairDipole>(pair_args, d_param);
     }
+
+cudaError_t gpu_compute_pair_aniso_forces_dipole_ewald(const a_pair_args_t& pair_args,
+            const EvaluatorPairDipoleEwald::param_type* d_param)
+    {
+    return gpu_compute_pair_aniso_forces<EvaluatorPairDipoleEwald>(pair_args, d_param);
+    }
@@ -14,6 +14,7 @@
 #include "AnisoPotentialPairGPU.cuh"
 #include "EvaluatorPairGB.h"
 #include "EvaluatorPairDipole.h"
+#include "EvaluatorPairDipoleEwald.h"
 
 //! Compute dipole forces and torques on the GPU with EvaluatorPairDipole
 
@@ -23,4 +24,8 @@ cudaError_t gpu_compute_pair_aniso_forces_gb(const a_pair_args_t&,
 cudaError_t gpu_compute_pair_aniso_forces_dipole(const a_pair_args_t&,
             const EvaluatorPairDipole::param_type*);
 
+//! Compute the real space dipolar Ewald forces and torques on the GPU with EvaluatorPairDipoleEwald
+cudaError_t gpu_compute_pair_aniso_forces_dipole_ewald(const a_pair_args_t&,
+            const EvaluatorPairDipoleEwald::param_type*);
+
 #endif
@@ -104,6 +104,12 @@ class AnisoPotentialPair : public ForceCompute
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
+
+        //! The half-shell ghost exchange is not supported
+        virtual bool supportsHalfShell()
+            {
+            return false;
+            }
         #endif
 
         //! Returns true because we compute the torque
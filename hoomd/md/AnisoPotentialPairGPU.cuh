@@ -5,6 +5,7 @@
 // Maintainer:  jglaser
 
 #include "hoomd/HOOMDMath.h"
+#include "hoomd/VectorMath.h"
 #include "hoomd/ParticleData.cuh"
 #include "hoomd/Index1D.h"
 #include "hoomd/TextureTools.h"
@@ -45,6 +46,21 @@ __device__ static T aniso_warp_reduce(unsigned int NT, int tid, T x, volatile T*
     }
 
 
+//! Detects uniaxial evaluators
+/*! An evaluator is uniaxial if the orientation of a particle enters only through one axis, returned in the body
+    frame by a static getBodyAxis() method. It then also provides a constructor taking the axes of both particles
+    in the space frame in place of the quaternions. For uniaxial evaluators, the GPU driver rotates the axis of every
+    particle once per force computation, instead of converting both quaternions in every pair.
+*/
+template<class evaluator>
+struct aniso_is_uniaxial
+    {
+    template<class T> static char test(decltype(&T::getBodyAxis));
+    template<class T> static long test(...);
+
+    static const bool value = sizeof(test<evaluator>(0)) == sizeof(char);
+    };
+
 //! Wraps arguments to gpu_cgpf
 struct a_pair_args_t
     {
@@ -59,6 +75,8 @@ struct a_pair_args_t
               const Scalar *_d_diameter,
               const Scalar *_d_charge,
               const Scalar4 *_d_orientation,
+              Scalar4 *_d_axis,
+              const unsigned int _n_ghost,
               const BoxDim& _box,
               const unsigned int *_d_n_neigh,
               const unsigned int *_d_nlist,
@@ -80,6 +98,8 @@ struct a_pair_args_t
                   d_diameter(_d_diameter),
                   d_charge(_d_charge),
                   d_orientation(_d_orientation),
+                  d_axis(_d_axis),
+                  n_ghost(_n_ghost),
                   box(_box),
                   d_n_neigh(_d_n_neigh),
                   d_nlist(_d_nlist),
@@ -104,6 +124,8 @@ struct a_pair_args_t
     const Scalar *d_diameter;       //!< particle diameters
     const Scalar *d_charge;         //!< particle charges
     const Scalar4 *d_orientation;    //!< particle orientation to compute forces over
+    Scalar4 *d_axis;                //!< scratch array for the body axes of uniaxial evaluators (n_max elements)
+    const unsigned int n_ghost;     //!< number of ghost particles
     const BoxDim& box;              //!< Simulation box in GPU format
     const unsigned int *d_n_neigh;  //!< Device array listing the number of neighbors on each particle
     const unsigned int *d_nlist;    //!< Device array listing the neighbors of each particle
@@ -130,6 +152,44 @@ scalar_tex_t aniso_pdata_diam_tex;
 //! Texture for reading particle charges
 scalar_tex_t aniso_pdata_charge_tex;
 
+//! Constructs the evaluator from the quaternions of both particles
+template<class evaluator, bool uniaxial>
+struct aniso_evaluator_factory
+    {
+    __device__ static evaluator make(Scalar3 dr, Scalar4 oi, Scalar4 oj, Scalar rcutsq,
+        typename evaluator::param_type param)
+        {
+        return evaluator(dr, oi, oj, rcutsq, param);
+        }
+    };
+
+//! Constructs a uniaxial evaluator from the body axes of both particles in the space frame
+template<class evaluator>
+struct aniso_evaluator_factory<evaluator, true>
+    {
+    __device__ static evaluator make(Scalar3 dr, Scalar4 oi, Scalar4 oj, Scalar rcutsq,
+        typename evaluator::param_type param)
+        {
+        return evaluator(dr, vec3<Scalar>(oi), vec3<Scalar>(oj), rcutsq, param);
+        }
+    };
+
+//! Kernel for rotating the body axis of every particle into the space frame
+/*! \param d_axis Output body axes (w is unused)
+    \param d_orientation Particle orientations
+    \param n Number of particles, including ghosts
+*/
+template< class evaluator >
+__global__ void gpu_compute_aniso_axes_kernel(Scalar4 *d_axis, const Scalar4 *d_orientation, const unsigned int n)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= n)
+        return;
+
+    vec3<Scalar> a = rotate(quat<Scalar>(d_orientation[idx]), evaluator::getBodyAxis());
+    d_axis[idx] = make_scalar4(a.x, a.y, a.z, Scalar(0.0));
+    }
+
 //! Kernel for calculating pair forces
 /*! This kernel is called to calculate the pair forces on all N particles. Actual evaluation of the potentials and
     forces for each pair is handled via the template class \a evaluator.
@@ -142,7 +202,7 @@ scalar_tex_t aniso_pdata_charge_tex;
     \param d_pos particle positions
     \param d_diameter particle diameters
     \param d_charge particle charges
-    \param d_orientation Quaternion data on the GPU to calculate forces on
+    \param d_orientation Quaternion data on the GPU to calculate forces on, or the body axes for uniaxial evaluators
     \param box Box dimensions used to implement periodic boundary conditions
     \param d_n_neigh Device memory array listing the number of neighbors for each particle
     \param d_nlist Device memory array containing the neighbor list contents
@@ -309,7 +369,8 @@ __global__ void gpu_compute_pair_aniso_forces_kernel(Scalar4 *d_force,
             Scalar pair_eng = 0.0f;
 
             // constructor call
-            evaluator eval(dx, quati, quatj, rcutsq, param);
+            evaluator eval = aniso_evaluator_factory<evaluator, aniso_is_uniaxial<evaluator>::value>::make(
+                dx, quati, quatj, rcutsq, param);
             if (evaluator::needsDiameter())
                 eval.setDiameter(di, dj);
             if (evaluator::needsCharge())
@@ -413,7 +474,7 @@ int aniso_get_compute_capability(T func)
     return attr.binaryVersion;
     }
 
-void gpu_pair_aniso_force_bind_textures(const a_pair_args_t pair_args)
+void gpu_pair_aniso_force_bind_textures(const a_pair_args_t pair_args, const Scalar4 *d_orientation)
     {
     // bind the position texture
     aniso_pdata_pos_tex.normalized = false;
@@ -423,7 +484,7 @@ void gpu_pair_aniso_force_bind_textures(const a_pair_args_t pair_args)
     // bind the position texture
     aniso_pdata_quat_tex.normalized = false;
     aniso_pdata_quat_tex.filterMode = cudaFilterModePoint;
-    cudaBindTexture(0, aniso_pdata_quat_tex, pair_args.d_orientation, sizeof(Scalar4)*pair_args.n_max);
+    cudaBindTexture(0, aniso_pdata_quat_tex, d_orientation, sizeof(Scalar4)*pair_args.n_max);
 
     // bind the diameter texture
     aniso_pdata_diam_tex.normalized = false;
@@ -440,6 +501,9 @@ void gpu_pair_aniso_force_bind_textures(const a_pair_args_t pair_args)
     \param d_params Parameters for the potential, stored per type pair
 
     This is just a driver function for gpu_compute_pair_aniso_forces_kernel(), see it for details.
+
+    For uniaxial evaluators (see aniso_is_uniaxial), the body axes of all particles are first computed into
+    pair_args.d_axis, and the kernel reads them in place of the quaternions.
 */
 template< class evaluator >
 cudaError_t gpu_compute_pair_aniso_forces(const a_pair_args_t& pair_args,
@@ -456,6 +520,26 @@ cudaError_t gpu_compute_pair_aniso_forces(const a_pair_args_t& pair_args,
     unsigned int block_size = pair_args.block_size;
     unsigned int tpp = pair_args.threads_per_particle;
 
+    const Scalar4 *d_orientation = pair_args.d_orientation;
+    if (aniso_is_uniaxial<evaluator>::value)
+        {
+        assert(pair_args.d_axis);
+
+        // neighbors may be on any GPU, so compute all axes on the first GPU and wait for it
+        pair_args.gpu_partition.getRangeAndSetGPU(0);
+
+        unsigned int n = pair_args.N + pair_args.n_ghost;
+        unsigned int axis_block_size = 256;
+        dim3 axis_grid(n / axis_block_size + 1, 1, 1);
+        gpu_compute_aniso_axes_kernel<evaluator><<<axis_grid, axis_block_size>>>(pair_args.d_axis,
+                                                                             pair_args.d_orientation,
+                                                                             n);
+        if (pair_args.gpu_partition.getNumActiveGPUs() > 1)
+            cudaDeviceSynchronize();
+
+        d_orientation = pair_args.d_axis;
+        }
+
     // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
     for (int idev = pair_args.gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
         {
@@ -476,7 +560,7 @@ cudaError_t gpu_compute_pair_aniso_forces(const a_pair_args_t& pair_args,
                     if (sm == UINT_MAX)
                         sm = aniso_get_compute_capability(gpu_compute_pair_aniso_forces_kernel<evaluator, 0, 1>);
 
-                    if (sm < 35) gpu_pair_aniso_force_bind_textures(pair_args);
+                    if (sm < 35) gpu_pair_aniso_force_bind_textures(pair_args, d_orientation);
 
                     block_size = block_size < max_block_size ? block_size : max_block_size;
                     dim3 grid(nwork / (block_size/tpp) + 1, 1, 1);
@@ -492,7 +576,7 @@ cudaError_t gpu_compute_pair_aniso_forces(const a_pair_args_t& pair_args,
                                                       pair_args.d_pos,
                                                       pair_args.d_diameter,
                                                       pair_args.d_charge,
-                                                      pair_args.d_orientation,
+                                                      d_orientation,
                                                       pair_args.box,
                                                       pair_args.d_n_neigh,
                                                       pair_args.d_nlist,
@@ -513,7 +597,7 @@ cudaError_t gpu_compute_pair_aniso_forces(const a_pair_args_t& pair_args,
                     if (sm == UINT_MAX)
                         sm = aniso_get_compute_capability(gpu_compute_pair_aniso_forces_kernel<evaluator, 1, 1>);
 
-                    if (sm < 35) gpu_pair_aniso_force_bind_textures(pair_args);
+                    if (sm < 35) gpu_pair_aniso_force_bind_textures(pair_args, d_orientation);
 
                     block_size = block_size < max_block_size ? block_size : max_block_size;
                     dim3 grid(nwork / (block_size/tpp) + 1, 1, 1);
@@ -529,7 +613,7 @@ cudaError_t gpu_compute_pair_aniso_forces(const a_pair_args_t& pair_args,
                                                       pair_args.d_pos,
                                                       pair_args.d_diameter,
                                                       pair_args.d_charge,
-                                                      pair_args.d_orientation,
+                                                      d_orientation,
                                                       pair_args.box,
                                                       pair_args.d_n_neigh,
                                                       pair_args.d_nlist,
@@ -558,7 +642,7 @@ cudaError_t gpu_compute_pair_aniso_forces(const a_pair_args_t& pair_args,
                     if (sm == UINT_MAX)
                         sm = aniso_get_compute_capability(gpu_compute_pair_aniso_forces_kernel<evaluator, 0, 0>);
 
-                    if (sm < 35) gpu_pair_aniso_force_bind_textures(pair_args);
+                    if (sm < 35) gpu_pair_aniso_force_bind_textures(pair_args, d_orientation);
 
                     block_size = block_size < max_block_size ? block_size : max_block_size;
                     dim3 grid(nwork / (block_size/tpp) + 1, 1, 1);
@@ -574,7 +658,7 @@ cudaError_t gpu_compute_pair_aniso_forces(const a_pair_args_t& pair_args,
                                                       pair_args.d_pos,
                                                       pair_args.d_diameter,
                                                       pair_args.d_charge,
-                                                      pair_args.d_orientation,
+                                                      d_orientation,
                                                       pair_args.box,
                                                       pair_args.d_n_neigh,
                                                       pair_args.d_nlist,
@@ -595,7 +679,7 @@ cudaError_t gpu_compute_pair_aniso_forces(const a_pair_args_t& pair_args,
                     if (sm == UINT_MAX)
                         sm = aniso_get_compute_capability(gpu_compute_pair_aniso_forces_kernel<evaluator, 1, 0>);
 
-                    if (sm < 35) gpu_pair_aniso_force_bind_textures(pair_args);
+                    if (sm < 35) gpu_pair_aniso_force_bind_textures(pair_args, d_orientation);
 
                     block_size = block_size < max_block_size ? block_size : max_block_size;
                     dim3 grid(nwork / (block_size/tpp) + 1, 1, 1);
@@ -616,7 +700,7 @@ cudaError_t gpu_compute_pair_aniso_forces(const a_pair_args_t& pair_args,
                                                       pair_args.d_pos,
                                                       pair_args.d_diameter,
                                                       pair_args.d_charge,
-                                                      pair_args.d_orientation,
+                                                      d_orientation,
                                                       pair_args.box,
                                                       pair_args.d_n_neigh,
                                                       pair_args.d_nlist,
@@ -71,6 +71,7 @@ class AnisoPotentialPairGPU : public AnisoPotentialPair<evaluator>
     protected:
         std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for block size and threads per particle
         unsigned int m_param;                 //!< Kernel tuning parameter
+        GlobalArray<Scalar4> m_axis;          //!< Body axes in the space frame, for uniaxial evaluators
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
@@ -92,22 +93,26 @@ AnisoPotentialPairGPU< evaluator, gpu_cgpf >::AnisoPotentialPairGPU(std::shared_
         }
 
     // initialize autotuner
-    // the full block size and threads_per_particle matrix is searched,
+    // the block size and threads_per_particle are searched by coordinate descent,
     // encoded as block_size*10000 + threads_per_particle
-    std::vector<unsigned int> valid_params;
+    std::vector< std::vector<unsigned int> > dim_values(2);
     for (unsigned int block_size = 32; block_size <= 1024; block_size += 32)
-        {
-        for (auto s : Autotuner::getTppListPow2(this->m_exec_conf->dev_prop.warpSize))
-            {
-            valid_params.push_back(block_size*10000 + s);
-            }
-        }
+        dim_values[0].push_back(block_size);
+    dim_values[1] = Autotuner::getTppListPow2(this->m_exec_conf->dev_prop.warpSize);
+    std::vector<unsigned int> dim_weights = {10000, 1};
 
-    m_tuner.reset(new Autotuner(valid_params, 5, 100000, "aniso_pair_" + evaluator::getName(), this->m_exec_conf));
+    m_tuner.reset(new Autotuner(dim_values, dim_weights, 5, 100000, "aniso_pair_" + evaluator::getName(), this->m_exec_conf));
     #ifdef ENABLE_MPI
     // synchronize autotuner results across ranks
     m_tuner->setSync(bool(this->m_pdata->getDomainDecomposition()));
     #endif
+
+    // the body axes are recomputed in every force computation
+    if (aniso_is_uniaxial<evaluator>::value)
+        {
+        GlobalArray<Scalar4> axis(this->m_pdata->getMaxN(), this->m_exec_conf);
+        m_axis.swap(axis);
+        }
     }
 
 template< class evaluator, cudaError_t gpu_cgpf(const a_pair_args_t& pair_args,
@@ -150,6 +155,11 @@ void AnisoPotentialPairGPU< evaluator, gpu_cgpf >::computeForces(unsigned int ti
     ArrayHandle<Scalar4> d_torque(this->m_torque, access_location::device, access_mode::overwrite);
     ArrayHandle<Scalar> d_virial(this->m_virial, access_location::device, access_mode::overwrite);
 
+    // scratch space for the body axes, including ghost particles
+    if (aniso_is_uniaxial<evaluator>::value && m_axis.getNumElements() < this->m_pdata->getMaxN())
+        m_axis.resize(this->m_pdata->getMaxN());
+    ArrayHandle<Scalar4> d_axis(m_axis, access_location::device, access_mode::overwrite);
+
     // access flags
     PDataFlags flags = this->m_pdata->getFlags();
 
@@ -170,6 +180,8 @@ void AnisoPotentialPairGPU< evaluator, gpu_cgpf >::computeForces(unsigned int ti
                            d_diameter.data,
                            d_charge.data,
                            d_orientation.data,
+                           d_axis.data,
+                           this->m_pdata->getNGhosts(),
                            box,
                            d_n_neigh.data,
                            d_nlist.data,
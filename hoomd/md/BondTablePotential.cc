@@ -5,6 +5,7 @@
 // Maintainer: phillicl
 
 #include "BondTablePotential.h"
+#include "TableInterpolation.h"
 #include "hoomd/BondedGroupData.h"
 
 namespace py = pybind11;
@@ -24,7 +25,7 @@ using namespace std;
 BondTablePotential::BondTablePotential(std::shared_ptr<SystemDefinition> sysdef,
                                unsigned int table_width,
                                const std::string& log_suffix)
-        : ForceCompute(sysdef), m_table_width(table_width)
+        : ForceCompute(sysdef), m_table_width(table_width), m_cubic(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing BondTablePotential" << endl;
 
@@ -47,6 +48,8 @@ BondTablePotential::BondTablePotential(std::shared_ptr<SystemDefinition> sysdef,
     m_tables.swap(tables);
     GPUArray<Scalar4> params(m_bond_data->getNTypes(), m_exec_conf);
     m_params.swap(params);
+    GPUArray<Scalar4> coeffs(m_table_width, m_bond_data->getNTypes(), m_exec_conf);
+    m_coeffs.swap(coeffs);
     assert(!m_tables.isNull());
 
     // helper to compute indices
@@ -91,6 +94,7 @@ void BondTablePotential::setTable(unsigned int type,
     // access the arrays
     ArrayHandle<Scalar2> h_tables(m_tables, access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_params(m_params, access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_coeffs(m_coeffs, access_location::host, access_mode::readwrite);
 
     // range check on the parameters
     if (rmin < 0 || rmax < 0 || rmax <= rmin)
@@ -117,6 +121,13 @@ void BondTablePotential::setTable(unsigned int type,
         h_tables.data[m_table_value(i, type)].x = V[i];
         h_tables.data[m_table_value(i, type)].y = F[i];
         }
+
+    // precompute the cubic Hermite polynomial of every interval, the last point continues linearly
+    Scalar delta_r = h_params.data[type].z;
+    for (unsigned int i = 0; i < m_table_width - 1; i++)
+        h_coeffs.data[m_table_value(i, type)] = table_hermite_coeffs(V[i], F[i], V[i+1], F[i+1], delta_r);
+    h_coeffs.data[m_table_value(m_table_width - 1, type)] =
+        make_scalar4(V[m_table_width - 1], -F[m_table_width - 1] * delta_r, Scalar(0.0), Scalar(0.0));
     }
 
 /*! BondTablePotential provides
@@ -175,6 +186,7 @@ void BondTablePotential::computeForces(unsigned int timestep)
     // access the table data
     ArrayHandle<Scalar2> h_tables(m_tables, access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_params(m_params, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_coeffs(m_coeffs, access_location::host, access_mode::read);
 
     // for each of the bonds
     const unsigned int size = (unsigned int)m_bond_data->getN();
@@ -228,24 +240,34 @@ void BondTablePotential::computeForces(unsigned int timestep)
             // precomputed term
             Scalar value_f = (r - rmin) / delta_r;
 
-            // compute index into the table and read in values
+            // compute index into the table
 
             /// Here we use the table!!
             unsigned int value_i = (unsigned int)floor(value_f);
-            Scalar2 VF0 = h_tables.data[m_table_value(value_i, type)];
-            Scalar2 VF1 = h_tables.data[m_table_value(value_i+1, type)];
-            // unpack the data
-            Scalar V0 = VF0.x;
-            Scalar V1 = VF1.x;
-            Scalar F0 = VF0.y;
-            Scalar F1 = VF1.y;
-
-            // compute the linear interpolation coefficient
+
+            // compute the interpolation coefficient
             Scalar f = value_f - Scalar(value_i);
 
-            // interpolate to get V and F;
-            Scalar V = V0 + f * (V1 - V0);
-            Scalar F = F0 + f * (F1 - F0);
+            Scalar V, F;
+            if (m_cubic)
+                {
+                table_hermite_eval(h_coeffs.data[m_table_value(value_i, type)], f, delta_r, V, F);
+                }
+            else
+                {
+                // read in values
+                Scalar2 VF0 = h_tables.data[m_table_value(value_i, type)];
+                Scalar2 VF1 = h_tables.data[m_table_value(value_i+1, type)];
+                // unpack the data
+                Scalar V0 = VF0.x;
+                Scalar V1 = VF1.x;
+                Scalar F0 = VF0.y;
+                Scalar F1 = VF1.y;
+
+                // interpolate to get V and F;
+                V = V0 + f * (V1 - V0);
+                F = F0 + f * (F1 - F0);
+                }
 
             // convert to standard variables used by the other pair computes in HOOMD-blue
             Scalar force_divr = Scalar(0.0);
@@ -296,5 +318,6 @@ void export_BondTablePotential(py::module& m)
     py::class_<BondTablePotential, std::shared_ptr<BondTablePotential> >(m, "BondTablePotential", py::base<ForceCompute>())
     .def(py::init< std::shared_ptr<SystemDefinition>, unsigned int, const std::string& >())
     .def("setTable", &BondTablePotential::setTable)
+    .def("setCubicInterpolation", &BondTablePotential::setCubicInterpolation)
     ;
     }
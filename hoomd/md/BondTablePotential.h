@@ -48,6 +48,9 @@
     Values are interpolated linearly between two points straddling the given r. For a given r, the first point needed, i
     can be calculated via i = floorf((r - rmin) / dr). The fraction between ri and ri+1 can be calculated via
     f = (r - rmin) / dr - float(i). And the linear interpolation can then be performed via V(r) ~= Vi + f * (Vi+1 - Vi)
+
+    With setCubicInterpolation(), the intervals are evaluated with cubic Hermite polynomials instead, as in
+    TablePotential.
     \ingroup computes
 */
 class PYBIND11_EXPORT BondTablePotential : public ForceCompute
@@ -68,6 +71,12 @@ class PYBIND11_EXPORT BondTablePotential : public ForceCompute
                               Scalar rmin,
                               Scalar rmax);
 
+        //! Set whether the tables are interpolated with cubic Hermite polynomials instead of linearly
+        void setCubicInterpolation(bool cubic)
+            {
+            m_cubic = cubic;
+            }
+
         //! Returns a list of log quantities this compute calculates
         virtual std::vector< std::string > getProvidedLogQuantities();
 
@@ -92,6 +101,8 @@ class PYBIND11_EXPORT BondTablePotential : public ForceCompute
         unsigned int m_table_width;                 //!< Width of the tables in memory
         GPUArray<Scalar2> m_tables;                  //!< Stored V and F tables
         GPUArray<Scalar4> m_params;                 //!< Parameters stored for each table
+        GPUArray<Scalar4> m_coeffs;                 //!< Cubic Hermite coefficients of every table interval
+        bool m_cubic;                               //!< True if the tables are interpolated with cubic polynomials
         Index2D m_table_value;                      //!< Index table helper
         std::string m_log_name;                     //!< Cached log name
 
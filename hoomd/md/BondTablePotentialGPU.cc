@@ -63,6 +63,7 @@ void BondTablePotentialGPU::computeForces(unsigned int timestep)
 
     // access the table data
     ArrayHandle<Scalar2> d_tables(m_tables, access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_coeffs(m_coeffs, access_location::device, access_mode::read);
     ArrayHandle<Scalar4> d_params(m_params, access_location::device, access_mode::read);
 
     ArrayHandle<Scalar4> d_force(m_force,access_location::device,access_mode::overwrite);
@@ -89,12 +90,14 @@ void BondTablePotentialGPU::computeForces(unsigned int timestep)
                              d_gpu_n_bonds.data,
                              m_bond_data->getNTypes(),
                              d_tables.data,
+                             d_coeffs.data,
                              d_params.data,
                              m_table_width,
                              m_table_value,
                              d_flags.data,
                              m_tuner->getParam(),
-                             m_exec_conf->getComputeCapability());
+                             m_exec_conf->getComputeCapability(),
+                             m_cubic);
         }
 
 
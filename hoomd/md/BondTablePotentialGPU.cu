@@ -5,6 +5,7 @@
 // Maintainer: joaander
 
 #include "BondTablePotentialGPU.cuh"
+#include "TableInterpolation.h"
 #include "hoomd/TextureTools.h"
 
 
@@ -18,6 +19,9 @@
 //! Texture for reading table values
 scalar2_tex_t tables_tex;
 
+//! Texture for reading the cubic table coefficients
+scalar4_tex_t coeffs_tex;
+
 /*!  This kernel is called to calculate the table pair forces on all N particles
 
     \param d_force Device memory to write computed forces
@@ -30,16 +34,21 @@ scalar2_tex_t tables_tex;
     \param pitch Pitch of 2D bond list
     \param n_bonds_list List of numbers of bonds stored on the GPU
     \param n_bond_type number of bond types
+    \param d_tables Tables of the potential and force
+    \param d_coeffs Cubic Hermite coefficients of the table intervals
     \param d_params Parameters for each table associated with a type pair
     \param table_value index helper function
     \param d_flags Flag allocated on the device for use in checking for bonds that cannot be evaluated
 
     See BondTablePotential for information on the memory layout.
 
+    \tparam cubic When non-zero, the cubic Hermite coefficients are evaluated instead of interpolating linearly
+
     \b Details:
     * Table entries are read from tables_tex. Note that currently this is bound to a 1D memory region. Performance tests
       at a later date may result in this changing.
 */
+template<unsigned char cubic>
 __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
                                      Scalar* d_virial,
                                      const unsigned int virial_pitch,
@@ -51,6 +60,7 @@ __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
                                      const unsigned int *n_bonds_list,
                                      const unsigned int n_bond_type,
                                      const Scalar2 *d_tables,
+                                     const Scalar4 *d_coeffs,
                                      const Scalar4 *d_params,
                                      const Index2D table_value,
                                      unsigned int *d_flags)
@@ -121,23 +131,33 @@ __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
             // precomputed term
             Scalar value_f = (r - rmin) / delta_r;
 
-            // compute index into the table and read in values
+            // compute index into the table
             unsigned int value_i = floor(value_f);
 
-            Scalar2 VF0 = texFetchScalar2(d_tables, tables_tex, table_value(value_i, cur_bond_type));
-            Scalar2 VF1 = texFetchScalar2(d_tables, tables_tex, table_value(value_i+1, cur_bond_type));
-            // unpack the data
-            Scalar V0 = VF0.x;
-            Scalar V1 = VF1.x;
-            Scalar F0 = VF0.y;
-            Scalar F1 = VF1.y;
-
-            // compute the linear interpolation coefficient
+            // compute the interpolation coefficient
             Scalar f = value_f - Scalar(value_i);
 
-            // interpolate to get V and F;
-            Scalar V = V0 + f * (V1 - V0);
-            Scalar F = F0 + f * (F1 - F0);
+            Scalar V, F;
+            if (cubic)
+                {
+                Scalar4 c = texFetchScalar4(d_coeffs, coeffs_tex, table_value(value_i, cur_bond_type));
+                table_hermite_eval(c, f, delta_r, V, F);
+                }
+            else
+                {
+                // read in values
+                Scalar2 VF0 = texFetchScalar2(d_tables, tables_tex, table_value(value_i, cur_bond_type));
+                Scalar2 VF1 = texFetchScalar2(d_tables, tables_tex, table_value(value_i+1, cur_bond_type));
+                // unpack the data
+                Scalar V0 = VF0.x;
+                Scalar V1 = VF1.x;
+                Scalar F0 = VF0.y;
+                Scalar F1 = VF1.y;
+
+                // interpolate to get V and F;
+                V = V0 + f * (V1 - V0);
+                F = F0 + f * (F1 - F0);
+                }
 
             // convert to standard variables used by the other pair computes in HOOMD-blue
             Scalar forcemag_divr = 0.0f;
@@ -184,6 +204,7 @@ __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
     \param n_bonds_list List of numbers of bonds stored on the GPU
     \param n_bond_type number of bond types
     \param d_tables Tables of the potential and force
+    \param d_coeffs Cubic Hermite coefficients of the table intervals
     \param d_params Parameters for each table associated with a type pair
     \param table_width Number of entries in the table
     \param table_value indexer helper
@@ -191,6 +212,7 @@ __global__ void gpu_compute_bondtable_forces_kernel(Scalar4* d_force,
                    of forces failed for any bond
     \param block_size Block size at which to run the kernel
     \param compute_capability Compute capability of the execution device (200, 3000, 350, ...)
+    \param cubic True to evaluate the cubic Hermite coefficients instead of interpolating linearly
 
     \note This is just a kernel driver. See gpu_compute_bondtable_forces_kernel for full documentation.
 */
@@ -205,15 +227,18 @@ cudaError_t gpu_compute_bondtable_forces(Scalar4* d_force,
                                      const unsigned int *n_bonds_list,
                                      const unsigned int n_bond_type,
                                      const Scalar2 *d_tables,
+                                     const Scalar4 *d_coeffs,
                                      const Scalar4 *d_params,
                                      const unsigned int table_width,
                                      const Index2D &table_value,
                                      unsigned int *d_flags,
                                      const unsigned int block_size,
-                                     const unsigned int compute_capability)
+                                     const unsigned int compute_capability,
+                                     const bool cubic)
     {
     assert(d_params);
     assert(d_tables);
+    assert(d_coeffs);
     assert(n_bond_type > 0);
     assert(table_width > 1);
 
@@ -221,8 +246,11 @@ cudaError_t gpu_compute_bondtable_forces(Scalar4* d_force,
     if (max_block_size == UINT_MAX)
         {
         cudaFuncAttributes attr;
-        cudaFuncGetAttributes(&attr, (const void *)gpu_compute_bondtable_forces_kernel);
+        cudaFuncGetAttributes(&attr, (const void *)gpu_compute_bondtable_forces_kernel<0>);
         max_block_size = attr.maxThreadsPerBlock;
+
+        cudaFuncGetAttributes(&attr, (const void *)gpu_compute_bondtable_forces_kernel<1>);
+        max_block_size = min(max_block_size, (unsigned int)attr.maxThreadsPerBlock);
         }
 
     unsigned int run_block_size = min(block_size, max_block_size);
@@ -237,25 +265,54 @@ cudaError_t gpu_compute_bondtable_forces(Scalar4* d_force,
         tables_tex.normalized = false;
         tables_tex.filterMode = cudaFilterModePoint;
         cudaError_t error = cudaBindTexture(0, tables_tex, d_tables, sizeof(Scalar2) * table_value.getNumElements());
+        if (error != cudaSuccess)
+            return error;
+
+        coeffs_tex.normalized = false;
+        coeffs_tex.filterMode = cudaFilterModePoint;
+        error = cudaBindTexture(0, coeffs_tex, d_coeffs, sizeof(Scalar4) * table_value.getNumElements());
         if (error != cudaSuccess)
             return error;
         }
 
-    gpu_compute_bondtable_forces_kernel<<< grid, threads, sizeof(Scalar4)*n_bond_type >>>
-            (d_force,
-             d_virial,
-             virial_pitch,
-             N,
-             d_pos,
-             box,
-             blist,
-             pitch,
-             n_bonds_list,
-             n_bond_type,
-             d_tables,
-             d_params,
-             table_value,
-             d_flags);
+    if (cubic)
+        {
+        gpu_compute_bondtable_forces_kernel<1><<< grid, threads, sizeof(Scalar4)*n_bond_type >>>
+                (d_force,
+                 d_virial,
+                 virial_pitch,
+                 N,
+                 d_pos,
+                 box,
+                 blist,
+                 pitch,
+                 n_bonds_list,
+                 n_bond_type,
+                 d_tables,
+                 d_coeffs,
+                 d_params,
+                 table_value,
+                 d_flags);
+        }
+    else
+        {
+        gpu_compute_bondtable_forces_kernel<0><<< grid, threads, sizeof(Scalar4)*n_bond_type >>>
+                (d_force,
+                 d_virial,
+                 virial_pitch,
+                 N,
+                 d_pos,
+                 box,
+                 blist,
+                 pitch,
+                 n_bonds_list,
+                 n_bond_type,
+                 d_tables,
+                 d_coeffs,
+                 d_params,
+                 table_value,
+                 d_flags);
+        }
 
     return cudaSuccess;
     }
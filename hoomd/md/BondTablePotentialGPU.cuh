@@ -28,11 +28,13 @@ cudaError_t gpu_compute_bondtable_forces(Scalar4* d_force,
                                      const unsigned int *n_bonds_list,
                                      const unsigned int n_bond_type,
                                      const Scalar2 *d_tables,
+                                     const Scalar4 *d_coeffs,
                                      const Scalar4 *d_params,
                                      const unsigned int table_width,
                                      const Index2D &table_value,
                                      unsigned int *d_flags,
                                      const unsigned int block_size,
-                                     const unsigned int compute_capability);
+                                     const unsigned int compute_capability,
+                                     const bool cubic);
 
 #endif
@@ -0,0 +1,218 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#ifndef __CELL_PAIR_CANDIDATES_H__
+#define __CELL_PAIR_CANDIDATES_H__
+
+#include <vector>
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/Index1D.h"
+#include "hoomd/CellList.h"
+#include "hoomd/ParticleData.h"
+#include "NeighborList.h"
+
+#ifdef ENABLE_CUDA
+#include "CellPairCandidatesGPU.cuh"
+#endif
+
+/*! \file CellPairCandidates.h
+    \brief Defines CellPairCandidates
+    \details In the cell-pair mode, the pair potentials evaluate the interactions directly from a cell list instead of
+    a neighbor list. CellPairCandidates collects the candidate interaction partners of a particle from its
+    neighboring cells.
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+//! Gathers the interaction candidates of a particle from the cell list
+/*! The cell list must be computed with XYZF data, flag index and a cell radius of 1. All particles in the adjacent
+    cells are candidates, except for the particle itself, type pairs with a non-positive cutoff, particles in the
+    same body (if the neighbor list filters bodies) and excluded particles. Exclusions are checked by tag, which is
+    valid without building the neighbor list. No distance check is performed, the evaluators reject pairs outside of
+    the cutoff.
+
+    The array handles are held for the lifetime of the object, construct it once before the particle loop. gather()
+    is const and may be called concurrently from several threads.
+*/
+class CellPairCandidates
+    {
+    public:
+        //! Acquire the cell list and exclusion data
+        /*! \param cl Cell list (computed)
+            \param nlist Neighbor list holding the exclusions
+            \param pdata Particle data
+            \param typpair_idx Indexer for the per type pair arrays
+            \param rcutsq Squared cutoff per type pair
+        */
+        CellPairCandidates(CellList& cl, NeighborList& nlist, ParticleData& pdata, const Index2D& typpair_idx,
+                           const Scalar *rcutsq)
+            : m_cell_size(cl.getCellSizeArray(), access_location::host, access_mode::read),
+              m_cell_xyzf(cl.getXYZFArray(), access_location::host, access_mode::read),
+              m_cell_adj(cl.getCellAdjArray(), access_location::host, access_mode::read),
+              m_pos(pdata.getPositions(), access_location::host, access_mode::read),
+              m_tag(pdata.getTags(), access_location::host, access_mode::read),
+              m_body(pdata.getBodies(), access_location::host, access_mode::read),
+              m_n_ex_tag(nlist.getNExTagArray(), access_location::host, access_mode::read),
+              m_ex_list_tag(nlist.getExListTagArray(), access_location::host, access_mode::read),
+              m_ex_list_indexer_tag(nlist.getExListTagIndexer()),
+              m_ci(cl.getCellIndexer()), m_cli(cl.getCellListIndexer()), m_cadji(cl.getCellAdjIndexer()),
+              m_dim(cl.getDim()), m_ghost_width(cl.getGhostWidth()), m_box(pdata.getBox()),
+              m_filter_body(nlist.getFilterBody()), m_exclusions(nlist.getExclusionsSet()),
+              m_typpair_idx(typpair_idx), m_rcutsq(rcutsq)
+            {
+            }
+
+        //! Collect the candidates of particle \a i
+        /*! \param i Index of the local particle
+            \param candidates Output list of particle indices (cleared first)
+        */
+        void gather(unsigned int i, std::vector<unsigned int>& candidates) const
+            {
+            candidates.clear();
+
+            const Scalar4 postype_i = m_pos.data[i];
+            const Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
+            const unsigned int type_i = __scalar_as_int(postype_i.w);
+            const unsigned int body_i = m_body.data[i];
+            const unsigned int tag_i = m_tag.data[i];
+            const unsigned int n_ex_i = m_exclusions ? m_n_ex_tag.data[tag_i] : 0;
+
+            // find the cell this particle belongs in
+            uchar3 periodic = m_box.getPeriodic();
+            Scalar3 f = m_box.makeFraction(pos_i, m_ghost_width);
+            int ib = (unsigned int)(f.x * m_dim.x);
+            int jb = (unsigned int)(f.y * m_dim.y);
+            int kb = (unsigned int)(f.z * m_dim.z);
+
+            // need to handle the case where the particle is exactly at the box hi
+            if (ib == (int)m_dim.x && periodic.x)
+                ib = 0;
+            if (jb == (int)m_dim.y && periodic.y)
+                jb = 0;
+            if (kb == (int)m_dim.z && periodic.z)
+                kb = 0;
+
+            unsigned int my_cell = m_ci(ib, jb, kb);
+
+            for (unsigned int cur_adj = 0; cur_adj < m_cadji.getW(); cur_adj++)
+                {
+                unsigned int neigh_cell = m_cell_adj.data[m_cadji(cur_adj, my_cell)];
+
+                unsigned int size = m_cell_size.data[neigh_cell];
+                for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
+                    {
+                    unsigned int j = __scalar_as_int(m_cell_xyzf.data[m_cli(cur_offset, neigh_cell)].w);
+                    if (j == i)
+                        continue;
+
+                    unsigned int type_j = __scalar_as_int(m_pos.data[j].w);
+                    if (m_rcutsq[m_typpair_idx(type_i, type_j)] <= Scalar(0.0))
+                        continue;
+
+                    if (m_filter_body && body_i != NO_BODY && body_i == m_body.data[j])
+                        continue;
+
+                    if (n_ex_i > 0 && isExcluded(tag_i, n_ex_i, m_tag.data[j]))
+                        continue;
+
+                    candidates.push_back(j);
+                    }
+                }
+            }
+
+    private:
+        ArrayHandle<unsigned int> m_cell_size;      //!< Number of particles per cell
+        ArrayHandle<Scalar4> m_cell_xyzf;           //!< Cell list with the particle indices in w
+        ArrayHandle<unsigned int> m_cell_adj;       //!< Cell adjacency list
+        ArrayHandle<Scalar4> m_pos;                 //!< Particle positions and types
+        ArrayHandle<unsigned int> m_tag;            //!< Particle tags
+        ArrayHandle<unsigned int> m_body;           //!< Particle bodies
+        ArrayHandle<unsigned int> m_n_ex_tag;       //!< Number of exclusions per tag
+        ArrayHandle<unsigned int> m_ex_list_tag;    //!< Exclusion list by tag
+        const Index2D m_ex_list_indexer_tag;        //!< Indexer for the exclusion list
+        const Index3D m_ci;                         //!< Cell indexer
+        const Index2D m_cli;                        //!< Cell list indexer
+        const Index2D m_cadji;                      //!< Cell adjacency indexer
+        const uint3 m_dim;                          //!< Cell list dimensions
+        const Scalar3 m_ghost_width;                //!< Ghost layer width of the cell list
+        const BoxDim m_box;                         //!< Local box
+        const bool m_filter_body;                   //!< True if particles in the same body do not interact
+        const bool m_exclusions;                    //!< True if any exclusions are set
+        const Index2D m_typpair_idx;                //!< Indexer for the per type pair arrays
+        const Scalar *m_rcutsq;                     //!< Squared cutoff per type pair
+
+        //! Test if the particle with tag \a tag_j is excluded from \a tag_i
+        bool isExcluded(unsigned int tag_i, unsigned int n_ex_i, unsigned int tag_j) const
+            {
+            for (unsigned int k = 0; k < n_ex_i; k++)
+                {
+                if (m_ex_list_tag.data[m_ex_list_indexer_tag(tag_i, k)] == tag_j)
+                    return true;
+                }
+            return false;
+            }
+    };
+
+#ifdef ENABLE_CUDA
+//! Acquires the device data of the cell-pair kernels
+/*! The array handles are held for the lifetime of the object, which must enclose the kernel launch.
+*/
+class CellPairCandidatesGPU
+    {
+    public:
+        //! Acquire the cell list and exclusion data on the device
+        /*! \param cl Cell list (computed)
+            \param nlist Neighbor list holding the exclusions
+            \param pdata Particle data
+        */
+        CellPairCandidatesGPU(CellList& cl, NeighborList& nlist, ParticleData& pdata)
+            : m_cell_size(cl.getCellSizeArray(), access_location::device, access_mode::read),
+              m_cell_xyzf(cl.getXYZFArray(), access_location::device, access_mode::read),
+              m_cell_adj(cl.getCellAdjArray(), access_location::device, access_mode::read),
+              m_tag(pdata.getTags(), access_location::device, access_mode::read),
+              m_body(pdata.getBodies(), access_location::device, access_mode::read),
+              m_n_ex_tag(nlist.getNExTagArray(), access_location::device, access_mode::read),
+              m_ex_list_tag(nlist.getExListTagArray(), access_location::device, access_mode::read)
+            {
+            m_args.d_cell_size = m_cell_size.data;
+            m_args.d_cell_xyzf = m_cell_xyzf.data;
+            m_args.d_cell_adj = m_cell_adj.data;
+            m_args.ci = cl.getCellIndexer();
+            m_args.cli = cl.getCellListIndexer();
+            m_args.cadji = cl.getCellAdjIndexer();
+            m_args.dim = cl.getDim();
+            m_args.ghost_width = cl.getGhostWidth();
+            m_args.d_tag = m_tag.data;
+            m_args.d_body = m_body.data;
+            m_args.filter_body = nlist.getFilterBody();
+            m_args.d_n_ex_tag = nlist.getExclusionsSet() ? m_n_ex_tag.data : NULL;
+            m_args.d_ex_list_tag = m_ex_list_tag.data;
+            m_args.ex_list_indexer_tag = nlist.getExListTagIndexer();
+            }
+
+        //! Get the kernel arguments
+        const cell_pair_args_t& getArgs() const
+            {
+            return m_args;
+            }
+
+    private:
+        ArrayHandle<unsigned int> m_cell_size;      //!< Number of particles per cell
+        ArrayHandle<Scalar4> m_cell_xyzf;           //!< Cell list with the particle indices in w
+        ArrayHandle<unsigned int> m_cell_adj;       //!< Cell adjacency list
+        ArrayHandle<unsigned int> m_tag;            //!< Particle tags
+        ArrayHandle<unsigned int> m_body;           //!< Particle bodies
+        ArrayHandle<unsigned int> m_n_ex_tag;       //!< Number of exclusions per tag
+        ArrayHandle<unsigned int> m_ex_list_tag;    //!< Exclusion list by tag
+        cell_pair_args_t m_args;                    //!< Kernel arguments
+    };
+#endif
+
+#endif // __CELL_PAIR_CANDIDATES_H__
@@ -0,0 +1,104 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#ifndef __CELL_PAIR_CANDIDATES_GPU_CUH__
+#define __CELL_PAIR_CANDIDATES_GPU_CUH__
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/Index1D.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/ParticleData.cuh"
+
+/*! \file CellPairCandidatesGPU.cuh
+    \brief Declares the device side of the cell-pair mode of the pair potentials
+    \details The pair force kernels of the cell-pair mode loop over the particles in the adjacent cells of a cell list
+    instead of a neighbor list. The helpers in this file locate the cell of a particle and reject the candidates that
+    do not interact, with the same rules as CellPairCandidates on the CPU.
+*/
+
+//! Device arrays of the cell list and the exclusions for the cell-pair kernels
+struct cell_pair_args_t
+    {
+    const unsigned int *d_cell_size;    //!< Number of particles per cell
+    const Scalar4 *d_cell_xyzf;         //!< Cell list with the particle indices in w
+    const unsigned int *d_cell_adj;     //!< Cell adjacency list
+    Index3D ci;                         //!< Cell indexer
+    Index2D cli;                        //!< Cell list indexer
+    Index2D cadji;                      //!< Cell adjacency indexer
+    uint3 dim;                          //!< Cell list dimensions
+    Scalar3 ghost_width;                //!< Ghost layer width of the cell list
+    const unsigned int *d_tag;          //!< Particle tags
+    const unsigned int *d_body;         //!< Particle bodies
+    unsigned int filter_body;           //!< Nonzero if particles in the same body do not interact
+    const unsigned int *d_n_ex_tag;     //!< Number of exclusions per tag, NULL if there are no exclusions
+    const unsigned int *d_ex_list_tag;  //!< Exclusion list by tag
+    Index2D ex_list_indexer_tag;        //!< Indexer for the exclusion list
+    };
+
+#ifdef NVCC
+//! Find the cell a particle belongs in
+/*! \param pos Particle position
+    \param box Local box
+    \param cell_args Cell list data
+    \returns Index of the cell
+*/
+__device__ inline unsigned int cell_pair_get_cell(const Scalar3& pos,
+                                                  const BoxDim& box,
+                                                  const cell_pair_args_t& cell_args)
+    {
+    uchar3 periodic = box.getPeriodic();
+    Scalar3 f = box.makeFraction(pos, cell_args.ghost_width);
+    int ib = (unsigned int)(f.x * cell_args.dim.x);
+    int jb = (unsigned int)(f.y * cell_args.dim.y);
+    int kb = (unsigned int)(f.z * cell_args.dim.z);
+
+    // need to handle the case where the particle is exactly at the box hi
+    if (ib == (int)cell_args.dim.x && periodic.x)
+        ib = 0;
+    if (jb == (int)cell_args.dim.y && periodic.y)
+        jb = 0;
+    if (kb == (int)cell_args.dim.z && periodic.z)
+        kb = 0;
+
+    return cell_args.ci(ib, jb, kb);
+    }
+
+//! Test if a candidate from the cell list is rejected without a distance check
+/*! \param i Index of the particle
+    \param j Index of the candidate
+    \param body_i Body of particle \a i
+    \param tag_i Tag of particle \a i
+    \param n_ex_i Number of exclusions of particle \a i
+    \param cell_args Cell list data
+*/
+__device__ inline bool cell_pair_rejected(const unsigned int i,
+                                          const unsigned int j,
+                                          const unsigned int body_i,
+                                          const unsigned int tag_i,
+                                          const unsigned int n_ex_i,
+                                          const cell_pair_args_t& cell_args)
+    {
+    if (i == j)
+        return true;
+
+    if (cell_args.filter_body && body_i != NO_BODY && body_i == cell_args.d_body[j])
+        return true;
+
+    if (n_ex_i > 0)
+        {
+        const unsigned int tag_j = cell_args.d_tag[j];
+        for (unsigned int k = 0; k < n_ex_i; k++)
+            {
+            if (cell_args.d_ex_list_tag[cell_args.ex_list_indexer_tag(tag_i, k)] == tag_j)
+                return true;
+            }
+        }
+
+    return false;
+    }
+#endif // NVCC
+
+#endif // __CELL_PAIR_CANDIDATES_GPU_CUH__
@@ -43,6 +43,24 @@ class PYBIND11_EXPORT ConstraintSphere : public ForceConstraint
         //! Return the number of DOF removed by this constraint
         virtual unsigned int getNDOFRemoved();
 
+        //! Get the group of particles on which the constraint is applied
+        std::shared_ptr<ParticleGroup> getGroup() const
+            {
+            return m_group;
+            }
+
+        //! Get the position of the sphere
+        Scalar3 getPosition() const
+            {
+            return m_P;
+            }
+
+        //! Get the radius of the sphere
+        Scalar getRadius() const
+            {
+            return m_r;
+            }
+
     protected:
         std::shared_ptr<ParticleGroup> m_group;   //!< Group of particles on which this constraint is applied
         Scalar3 m_P;         //!< Position of the sphere
@@ -40,7 +40,7 @@ ConstraintSphereGPU::ConstraintSphereGPU(std::shared_ptr<SystemDefinition> sysde
 void ConstraintSphereGPU::computeForces(unsigned int timestep)
     {
     unsigned int group_size = m_group->getNumMembers();
-    if (group_size == 0)
+    if (group_size == 0 || m_fused)
         return;
 
     if (m_prof) m_prof->push(m_exec_conf, "ConstraintSphere");
@@ -0,0 +1,277 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+/*! \file DLPackForceCompute.cc
+    \brief Defines the DLPackForceCompute class
+*/
+
+#include "DLPackForceCompute.h"
+
+#include <string.h>
+
+namespace py = pybind11;
+
+using namespace std;
+using namespace hoomd::dlpack;
+
+/*! \param sysdef System to compute forces on
+    \param nlist Neighbor list to share with the callback, NULL if the callback does not need one
+*/
+DLPackForceCompute::DLPackForceCompute(std::shared_ptr<SystemDefinition> sysdef,
+                                       std::shared_ptr<NeighborList> nlist)
+    : ForceCompute(sysdef), m_nlist(nlist)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing DLPackForceCompute" << endl;
+
+    #ifdef ENABLE_CUDA
+    m_data_event = 0;
+
+    // the arrays are spread over the GPUs in managed memory, which has no single DLPack device
+    if (m_exec_conf->isCUDAEnabled() && m_exec_conf->getNumActiveGPUs() > 1)
+        {
+        m_exec_conf->msg->error() << "force.dlpack is not supported on multiple GPUs" << endl;
+        throw runtime_error("Error initializing DLPackForceCompute");
+        }
+    #endif
+    }
+
+DLPackForceCompute::~DLPackForceCompute()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying DLPackForceCompute" << endl;
+
+    #ifdef ENABLE_CUDA
+    if (m_data_event)
+        cudaEventDestroy(m_data_event);
+    #endif
+    }
+
+/*! \param location Location the arrays are acquired at
+*/
+DLDevice DLPackForceCompute::getDevice(access_location::Enum location) const
+    {
+    DLDevice device;
+    device.device_type = kDLCPU;
+    device.device_id = 0;
+
+    #ifdef ENABLE_CUDA
+    if (location == access_location::device)
+        {
+        device.device_type = kDLCUDA;
+        device.device_id = m_exec_conf->getGPUIds()[0];
+        }
+    #endif
+
+    return device;
+    }
+
+/*! \returns The names of the arrays that getDLPack() exports, empty outside of the callback
+*/
+py::list DLPackForceCompute::getDLPackNames() const
+    {
+    py::list names;
+    for (auto it = m_arrays.begin(); it != m_arrays.end(); ++it)
+        names.append(py::str(it->first));
+    return names;
+    }
+
+/*! \param name Name of the array
+    \returns A new "dltensor" capsule that references the array
+*/
+py::object DLPackForceCompute::getDLPack(const std::string& name) const
+    {
+    auto it = m_arrays.find(name);
+    if (it == m_arrays.end())
+        {
+        m_exec_conf->msg->error() << "force.dlpack: " << name << " is not available, "
+                                  << "the arrays are only shared during the callback" << endl;
+        throw runtime_error("Error exporting DLPack tensor");
+        }
+
+    return make_capsule(it->second);
+    }
+
+/*! \returns The DLPack device type and id of the shared arrays, as returned by __dlpack_device__
+*/
+py::tuple DLPackForceCompute::getDLPackDevice() const
+    {
+    access_location::Enum location = access_location::host;
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        location = access_location::device;
+    #endif
+
+    DLDevice device = getDevice(location);
+    return py::make_tuple(int(device.device_type), int(device.device_id));
+    }
+
+/*! \param stream Stream handle passed by the consumer to __dlpack__
+
+    The shared arrays are written in the compute stream. Following the DLPack protocol, 1 is the legacy default
+    stream, which is ordered with all blocking streams and need not wait. This is a no-op on the CPU.
+*/
+void DLPackForceCompute::waitForData(uintptr_t stream)
+    {
+    #ifdef ENABLE_CUDA
+    if (!m_exec_conf->isCUDAEnabled() || stream <= 1)
+        return;
+
+    if (!m_data_event)
+        cudaEventCreateWithFlags(&m_data_event, cudaEventDisableTiming);
+
+    cudaEventRecord(m_data_event, getStream());
+    cudaStreamWaitEvent((cudaStream_t)stream, m_data_event, 0);
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    #endif
+    }
+
+/*! \returns The handle of the compute stream, 0 for the default stream and on the CPU
+*/
+uintptr_t DLPackForceCompute::getStreamHandle() const
+    {
+    #ifdef ENABLE_CUDA
+    return (uintptr_t)getStream();
+    #else
+    return 0;
+    #endif
+    }
+
+/*! \param timestep Current time step
+
+    The arrays are acquired where they live for the duration of the callback. The force and virial are acquired for
+    overwriting, so the values written by the callback on the device are never copied to the host unless read there.
+*/
+void DLPackForceCompute::computeForces(unsigned int timestep)
+    {
+    if (m_prof) m_prof->push("DLPack force");
+
+    if (m_nlist)
+        m_nlist->compute(timestep);
+
+    access_location::Enum location = access_location::host;
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        location = access_location::device;
+    #endif
+    const DLDevice device = getDevice(location);
+
+    const unsigned int N = m_pdata->getN();
+    const int64_t n_all = N + m_pdata->getNGhosts();
+    const DLDataType scalar_type = make_dtype(kDLFloat, sizeof(Scalar)*8);
+    const DLDataType index_type = make_dtype(kDLInt, 32);
+
+    ArrayHandle<Scalar4> d_postype(m_pdata->getPositions(), location, access_mode::read);
+    ArrayHandle<Scalar4> d_force(m_force, location, access_mode::overwrite);
+    ArrayHandle<Scalar> d_virial(m_virial, location, access_mode::overwrite);
+
+    // zero the outputs, the callback need not write all rows
+    #ifdef ENABLE_CUDA
+    if (location == access_location::device)
+        {
+        cudaMemsetAsync(d_force.data, 0, sizeof(Scalar4)*m_force.getNumElements(), getStream());
+        cudaMemsetAsync(d_virial.data, 0, sizeof(Scalar)*m_virial.getNumElements(), getStream());
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+    else
+    #endif
+        {
+        memset(d_force.data, 0, sizeof(Scalar4)*m_force.getNumElements());
+        memset(d_virial.data, 0, sizeof(Scalar)*m_virial.getNumElements());
+        }
+
+    DLPackArray position;
+    position.data = d_postype.data;
+    position.device = device;
+    position.dtype = scalar_type;
+    position.shape = {n_all, 3};
+    position.strides = {4, 1};
+    m_arrays["position"] = position;
+
+    // the type id is stored in the first four bytes of the w component by __int_as_scalar()
+    DLPackArray type;
+    type.data = d_postype.data;
+    type.device = device;
+    type.dtype = index_type;
+    type.shape = {n_all};
+    type.strides = {int64_t(sizeof(Scalar4)/sizeof(int))};
+    type.byte_offset = 3*sizeof(Scalar);
+    m_arrays["type"] = type;
+
+    DLPackArray force;
+    force.data = d_force.data;
+    force.device = device;
+    force.dtype = scalar_type;
+    force.shape = {n_all, 4};
+    force.strides = {4, 1};
+    m_arrays["force"] = force;
+
+    DLPackArray virial;
+    virial.data = d_virial.data;
+    virial.device = device;
+    virial.dtype = scalar_type;
+    virial.shape = {6, n_all};
+    virial.strides = {int64_t(m_virial_pitch), 1};
+    m_arrays["virial"] = virial;
+
+    // the neighbor list is only acquired when there is one
+    std::unique_ptr< ArrayHandle<unsigned int> > d_nlist, d_n_neigh, d_head_list;
+    if (m_nlist)
+        {
+        d_nlist.reset(new ArrayHandle<unsigned int>(m_nlist->getNListArray(), location, access_mode::read));
+        d_n_neigh.reset(new ArrayHandle<unsigned int>(m_nlist->getNNeighArray(), location, access_mode::read));
+        d_head_list.reset(new ArrayHandle<unsigned int>(m_nlist->getHeadList(), location, access_mode::read));
+
+        DLPackArray nlist;
+        nlist.data = d_nlist->data;
+        nlist.device = device;
+        nlist.dtype = index_type;
+        nlist.shape = {int64_t(m_nlist->getNListArray().getNumElements())};
+        nlist.strides = {1};
+        m_arrays["nlist"] = nlist;
+
+        DLPackArray n_neigh = nlist;
+        n_neigh.data = d_n_neigh->data;
+        n_neigh.shape = {int64_t(N)};
+        m_arrays["n_neigh"] = n_neigh;
+
+        DLPackArray head_list = nlist;
+        head_list.data = d_head_list->data;
+        head_list.shape = {int64_t(N)};
+        m_arrays["head_list"] = head_list;
+        }
+
+    // the arrays are only valid while the handles are held
+    try
+        {
+        if (m_callback && m_callback != py::none())
+            m_callback(timestep, N);
+        }
+    catch (...)
+        {
+        m_arrays.clear();
+        m_pdata->invalidatePositionsSoA();
+        throw;
+        }
+    m_arrays.clear();
+
+    // DLPack has no read only flag, the callback may have modified the positions in place
+    m_pdata->invalidatePositionsSoA();
+
+    if (m_prof) m_prof->pop();
+    }
+
+void export_DLPackForceCompute(py::module& m)
+    {
+    py::class_< DLPackForceCompute, std::shared_ptr<DLPackForceCompute> >(m, "DLPackForceCompute", py::base<ForceCompute>())
+    .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<NeighborList> >())
+    .def("setCallback", &DLPackForceCompute::setCallback)
+    .def("getDLPackNames", &DLPackForceCompute::getDLPackNames)
+    .def("getDLPack", &DLPackForceCompute::getDLPack)
+    .def("getDLPackDevice", &DLPackForceCompute::getDLPackDevice)
+    .def("waitForData", &DLPackForceCompute::waitForData)
+    .def("getStreamHandle", &DLPackForceCompute::getStreamHandle)
+    ;
+    }
@@ -0,0 +1,112 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: joaander
+
+#include "hoomd/ForceCompute.h"
+#include "hoomd/DLPack.h"
+#include "NeighborList.h"
+
+#include <map>
+#include <memory>
+#include <string>
+
+/*! \file DLPackForceCompute.h
+    \brief Declares the DLPackForceCompute class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#ifndef __DLPACKFORCECOMPUTE_H__
+#define __DLPACKFORCECOMPUTE_H__
+
+//! Computes forces in python on arrays shared with DLPack
+/*! DLPackForceCompute hands the particle data, the neighbor list and its own force and virial arrays to a python
+    callback as DLPack tensors. The tensors reference the arrays where they currently live, in device memory on the
+    GPU and in host memory on the CPU, so a machine learning framework (PyTorch, JAX, CuPy) can evaluate a model on
+    them and write the forces back without any copy between the host and the device.
+
+    The callback is called as callback(timestep, N) in computeForces(), where N is the number of local particles.
+    During the callback, getDLPack() exports the following arrays:
+
+    - position: (N+N_ghost, 3) positions of the local and ghost particles, Scalar
+    - type: (N+N_ghost) type ids, int32 (a strided view of the w component of the positions)
+    - nlist, n_neigh, head_list: (N_nlist), (N) and (N) neighbor list, int32 (only with a neighbor list)
+    - force: (N+N_ghost, 4) force and potential energy, Scalar, writable
+    - virial: (6, N+N_ghost) virial in the order xx, xy, xz, yy, yz, zz, Scalar, writable
+
+    The force and virial are zeroed before the callback. Only the rows of the local particles are used. The
+    tensors are only valid during the callback, exporting them later raises an error. The arrays are acquired while
+    the callback runs, so it must not access the particle data by other means.
+
+    On the GPU, all arrays are ready in the default stream, and the compute stream (see ForceCompute::setUseStream())
+    is a blocking stream ordered with it. The callback should launch its work in the stream returned by
+    getStreamHandle(). Consumers that pass another stream to __dlpack__ are made to wait for the compute stream with
+    waitForData(). The forces are summed after the work in the compute stream completes, the callback does not need
+    to synchronize.
+
+    \ingroup computes
+*/
+class PYBIND11_EXPORT DLPackForceCompute : public ForceCompute
+    {
+    public:
+        //! Constructs the compute
+        DLPackForceCompute(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<NeighborList> nlist);
+
+        //! Destructor
+        virtual ~DLPackForceCompute();
+
+        //! Set the python callback
+        void setCallback(pybind11::object callback)
+            {
+            m_callback = callback;
+            }
+
+        //! Get the names of the arrays shared with the callback
+        pybind11::list getDLPackNames() const;
+
+        //! Export an array shared with the callback as a DLPack capsule
+        pybind11::object getDLPack(const std::string& name) const;
+
+        //! Get the DLPack device of the shared arrays
+        pybind11::tuple getDLPackDevice() const;
+
+        //! Make a stream of a consumer wait for the shared arrays
+        void waitForData(uintptr_t stream);
+
+        //! Get the stream the callback should launch its work in, as an integer handle (0 is the default stream)
+        uintptr_t getStreamHandle() const;
+
+        #ifdef ENABLE_MPI
+        //! The callback only computes the forces of the local particles
+        virtual bool supportsHalfShell()
+            {
+            return false;
+            }
+        #endif
+
+    protected:
+        std::shared_ptr<NeighborList> m_nlist;      //!< Neighbor list shared with the callback (may be NULL)
+        pybind11::object m_callback;                //!< Python callback that computes the forces
+        std::map<std::string, hoomd::dlpack::DLPackArray> m_arrays; //!< Arrays shared during the callback
+
+        #ifdef ENABLE_CUDA
+        cudaEvent_t m_data_event;   //!< Recorded when the shared arrays are ready, for consumers in other streams
+        #endif
+
+        //! Actually compute the forces
+        virtual void computeForces(unsigned int timestep);
+
+    private:
+        //! Get the DLPack device of the arrays at a location
+        hoomd::dlpack::DLDevice getDevice(access_location::Enum location) const;
+    };
+
+//! Exports the DLPackForceCompute class to python
+void export_DLPackForceCompute(pybind11::module& m);
+
+#endif
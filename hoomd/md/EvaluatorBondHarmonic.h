@@ -12,6 +12,7 @@
 #endif
 
 #include "hoomd/HOOMDMath.h"
+#include "MDPrecisionSetup.h"
 
 /*! \file EvaluatorBondHarmonic.h
     \brief Defines the bond evaluator class for harmonic potentials
@@ -73,8 +74,8 @@ class EvaluatorBondHarmonic
         */
         DEVICE bool evalForceAndEnergy(Scalar& force_divr, Scalar& bond_eng)
             {
-            Scalar r = sqrt(rsq);
-            force_divr = K * (r_0 / r - Scalar(1.0));
+            ForceReal r = sqrt(rsq);
+            force_divr = K * (r_0 / r - ForceReal(1.0));
 
             // if the result is not finite, it is likely because of a division by 0, setting force_divr to 0 will
             // correctly result in a 0 force in this case
@@ -86,7 +87,7 @@ class EvaluatorBondHarmonic
                 {
                 force_divr = Scalar(0);
                 }
-            bond_eng = Scalar(0.5) * K * (r_0 - r) * (r_0 - r);
+            bond_eng = ForceReal(0.5) * K * (r_0 - r) * (r_0 - r);
 
             return true;
             }
@@ -103,9 +104,9 @@ class EvaluatorBondHarmonic
         #endif
 
     protected:
-        Scalar rsq;        //!< Stored rsq from the constructor
-        Scalar K;          //!< K parameter
-        Scalar r_0;        //!< r_0 parameter
+        ForceReal rsq;        //!< Stored rsq from the constructor
+        ForceReal K;          //!< K parameter
+        ForceReal r_0;        //!< r_0 parameter
     };
 
 
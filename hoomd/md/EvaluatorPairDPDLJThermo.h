@@ -12,7 +12,7 @@
 #endif
 
 #include "hoomd/HOOMDMath.h"
-#include "hoomd/Saru.h"
+#include "hoomd/Philox.h"
 
 
 /*! \file EvaluatorPairDPDLJThermo.h
@@ -201,7 +201,7 @@ class EvaluatorPairDPDLJThermo
                    m_oj = m_j;
                    }
 
-                hoomd::detail::Saru rng(m_oi, m_oj, m_seed + m_timestep);
+                hoomd::detail::Philox4x32 rng(m_oi, m_oj, m_seed, m_timestep);
 
 
                 // Generate a single random number
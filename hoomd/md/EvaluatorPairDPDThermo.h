@@ -13,7 +13,7 @@
 
 #include "hoomd/HOOMDMath.h"
 
-#include "hoomd/Saru.h"
+#include "hoomd/Philox.h"
 
 
 /*! \file EvaluatorPairDPDThermo.h
@@ -195,7 +195,7 @@ class EvaluatorPairDPDThermo
                    m_oj = m_j;
                    }
 
-                hoomd::detail::Saru rng(m_oi, m_oj, m_seed + m_timestep);
+                hoomd::detail::Philox4x32 rng(m_oi, m_oj, m_seed, m_timestep);
 
                 // Generate a single random number
                 Scalar alpha = rng.s<Scalar>(-1,1);
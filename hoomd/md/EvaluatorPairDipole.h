@@ -69,11 +69,32 @@ class EvaluatorPairDipole
             \param _params Per type pair parameters of this potential
         */
         DEVICE EvaluatorPairDipole(Scalar3& _dr, Scalar4& _quat_i, Scalar4& _quat_j, Scalar _rcutsq, param_type& params)
-            :dr(_dr), rcutsq(_rcutsq), quat_i(_quat_i), quat_j(_quat_j),
+            :dr(_dr), rcutsq(_rcutsq),
+             e_i(rotate(quat<Scalar>(_quat_i), getBodyAxis())), e_j(rotate(quat<Scalar>(_quat_j), getBodyAxis())),
              mu(params.x), A(params.y), kappa(params.z)
             {
             }
 
+        //! Constructs the pair potential evaluator from the dipole directions of the particles
+        /*! \param _dr Displacement vector between particle centers of mass
+            \param _e_i Dipole direction of the i^{th} particle in the space frame
+            \param _e_j Dipole direction of the j^{th} particle in the space frame
+            \param _rcutsq Squared distance at which the potential goes to 0
+            \param params Per type pair parameters of this potential
+        */
+        DEVICE EvaluatorPairDipole(Scalar3& _dr, const vec3<Scalar>& _e_i, const vec3<Scalar>& _e_j, Scalar _rcutsq,
+                                   param_type& params)
+            :dr(_dr), rcutsq(_rcutsq), e_i(_e_i), e_j(_e_j),
+             mu(params.x), A(params.y), kappa(params.z)
+            {
+            }
+
+        //! The dipole direction in the body frame
+        DEVICE static vec3<Scalar> getBodyAxis()
+            {
+            return vec3<Scalar>(1,0,0);
+            }
+
         //! uses diameter
         DEVICE static bool needsDiameter()
             {
@@ -125,9 +146,9 @@ class EvaluatorPairDipole
             Scalar r3inv = r2inv*rinv;
             Scalar r5inv = r3inv*r2inv;
 
-            // convert dipole vector in the body frame of each particle to space frame
-            vec3<Scalar> p_i = rotate(quat<Scalar>(quat_i), vec3<Scalar>(mu, 0, 0));
-            vec3<Scalar> p_j = rotate(quat<Scalar>(quat_j), vec3<Scalar>(mu, 0, 0));
+            // dipole moments in the space frame
+            vec3<Scalar> p_i = mu*e_i;
+            vec3<Scalar> p_j = mu*e_j;
 
             vec3<Scalar> f;
             vec3<Scalar> t_i;
@@ -222,7 +243,7 @@ class EvaluatorPairDipole
         Scalar3 dr;                 //!< Stored vector pointing between particle centers of mass
         Scalar rcutsq;              //!< Stored rcutsq from the constructor
         Scalar q_i, q_j;            //!< Stored particle charges
-        Scalar4 quat_i,quat_j;      //!< Stored quaternion of ith and jth particle from constructor
+        vec3<Scalar> e_i,e_j;       //!< Dipole directions of the ith and jth particle in the space frame
         Scalar mu, A, kappa;        //!< Stored dipole magnitude, electrostatic magnitude and inverse screening length
     };
 
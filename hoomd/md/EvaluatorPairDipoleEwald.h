@@ -0,0 +1,198 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __PAIR_EVALUATOR_DIPOLE_EWALD_H__
+#define __PAIR_EVALUATOR_DIPOLE_EWALD_H__
+
+#ifndef NVCC
+#include <string>
+#endif
+
+#include "hoomd/VectorMath.h"
+
+/*! \file EvaluatorPairDipoleEwald.h
+    \brief Defines the real space part of the Ewald sum for point dipoles
+*/
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+//! DEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef NVCC
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+//! Class for evaluating the real space part of the dipolar Ewald sum
+/*! EvaluatorPairDipoleEwald evaluates the short ranged part of the Ewald split dipole-dipole interaction
+    \f[
+    U = \mu_i \mu_j \left[ (\hat{e}_i \cdot \hat{e}_j) B(r) - (\hat{e}_i \cdot \vec{r})(\hat{e}_j \cdot \vec{r}) C(r) \right]
+    \f]
+    with
+    \f{eqnarray*}
+    B(r) &=& \left[\mathrm{erfc}(\kappa r) + \frac{2\kappa r}{\sqrt{\pi}} e^{-\kappa^2 r^2}\right] / r^3 \\
+    C(r) &=& \left[3 \mathrm{erfc}(\kappa r) + \frac{2\kappa r}{\sqrt{\pi}} (3 + 2\kappa^2 r^2) e^{-\kappa^2 r^2}\right] / r^5
+    \f}
+    The long ranged remainder is computed on the mesh by PPPMDipoleForceCompute.
+
+    The dipole direction is the x axis of the particle's body frame, as for EvaluatorPairDipole. The energy, force and
+    torques are bilinear in the two moments, so the product of the dipole magnitudes of the two types is stored per
+    type pair, which keeps the parameters symmetric under the exchange of the particles.
+
+    \a mu_i mu_j is placed in \a params.x
+    \a kappa (the Ewald splitting parameter) is placed in \a params.y
+*/
+class EvaluatorPairDipoleEwald
+    {
+    public:
+        typedef Scalar2 param_type;
+
+        //! Constructs the pair potential evaluator
+        /*! \param _dr Displacement vector between particle centers of mass
+            \param _quat_i Quaternion of i^{th} particle
+            \param _quat_j Quaternion of j^{th} particle
+            \param _rcutsq Squared distance at which the potential goes to 0
+            \param params Per type pair parameters of this potential
+        */
+        DEVICE EvaluatorPairDipoleEwald(Scalar3& _dr, Scalar4& _quat_i, Scalar4& _quat_j, Scalar _rcutsq,
+                                        param_type& params)
+            :dr(_dr), rcutsq(_rcutsq),
+             e_i(rotate(quat<Scalar>(_quat_i), getBodyAxis())), e_j(rotate(quat<Scalar>(_quat_j), getBodyAxis())),
+             mumu(params.x), kappa(params.y)
+            {
+            }
+
+        //! Constructs the pair potential evaluator from the dipole directions of the particles
+        /*! \param _dr Displacement vector between particle centers of mass
+            \param _e_i Dipole direction of the i^{th} particle in the space frame
+            \param _e_j Dipole direction of the j^{th} particle in the space frame
+            \param _rcutsq Squared distance at which the potential goes to 0
+            \param params Per type pair parameters of this potential
+        */
+        DEVICE EvaluatorPairDipoleEwald(Scalar3& _dr, const vec3<Scalar>& _e_i, const vec3<Scalar>& _e_j,
+                                        Scalar _rcutsq, param_type& params)
+            :dr(_dr), rcutsq(_rcutsq), e_i(_e_i), e_j(_e_j),
+             mumu(params.x), kappa(params.y)
+            {
+            }
+
+        //! The dipole direction in the body frame
+        DEVICE static vec3<Scalar> getBodyAxis()
+            {
+            return vec3<Scalar>(1,0,0);
+            }
+
+        //! uses diameter
+        DEVICE static bool needsDiameter()
+            {
+            return false;
+            }
+
+        //! Accept the optional diameter values
+        /*! \param di Diameter of particle i
+            \param dj Diameter of particle j
+        */
+        DEVICE void setDiameter(Scalar di, Scalar dj){}
+
+        //! whether pair potential requires charges
+        DEVICE static bool needsCharge()
+            {
+            return false;
+            }
+
+        //! Accept the optional charge values
+        /*! \param qi Charge of particle i
+            \param qj Charge of particle j
+        */
+        DEVICE void setCharge(Scalar qi, Scalar qj){}
+
+        //! Compute the radial functions of the split dipole interaction
+        /*! \param kappa Ewald splitting parameter
+            \param rsq Squared distance
+            \param reciprocal If true, compute the long ranged (erf) part instead of the short ranged (erfc) part
+            \param B Output, the coefficient of (e_i . e_j)
+            \param C Output, the coefficient of -(e_i . r)(e_j . r), C = -(1/r) dB/dr
+            \param D Output, -(1/r) dC/dr, needed for the force
+
+            The long ranged part is the bare interaction (B = 1/r^3, C = 3/r^5, D = 15/r^7) minus the short ranged one.
+        */
+        DEVICE static void computeRadialFunctions(Scalar kappa, Scalar rsq, bool reciprocal,
+                                                  Scalar& B, Scalar& C, Scalar& D)
+            {
+            Scalar r2inv = Scalar(1.0)/rsq;
+            Scalar rinv = fast::rsqrt(rsq);
+            Scalar r = rsq*rinv;
+            Scalar kr = kappa*r;
+            Scalar ksq_rsq = kr*kr;
+            Scalar a = Scalar(2.0)*kr/fast::sqrt(Scalar(M_PI))*fast::exp(-ksq_rsq);
+            Scalar g = fast::erfc(kr);
+            if (reciprocal)
+                {
+                g = Scalar(1.0) - g;
+                a = -a;
+                }
+
+            Scalar r3inv = r2inv*rinv;
+            B = (g + a)*r3inv;
+            C = (Scalar(3.0)*g + a*(Scalar(3.0) + Scalar(2.0)*ksq_rsq))*r3inv*r2inv;
+            D = (Scalar(15.0)*g + a*(Scalar(15.0) + Scalar(10.0)*ksq_rsq + Scalar(4.0)*ksq_rsq*ksq_rsq))
+                *r3inv*r2inv*r2inv;
+            }
+
+        //! Evaluate the force and energy
+        /*! \param force Output parameter to write the computed force.
+            \param pair_eng Output parameter to write the computed pair energy.
+            \param energy_shift Ignored, the potential is not shifted
+            \param torque_i The torque exerted on the i^th particle.
+            \param torque_j The torque exerted on the j^th particle.
+            \return True if they are evaluated or false if they are not because we are beyond the cutoff.
+        */
+        DEVICE bool evaluate(Scalar3& force, Scalar& pair_eng, bool energy_shift, Scalar3& torque_i,
+                             Scalar3& torque_j)
+            {
+            vec3<Scalar> rvec(dr);
+            Scalar rsq = dot(rvec, rvec);
+
+            if (rsq > rcutsq || mumu == Scalar(0.0))
+                return false;
+
+            Scalar B, C, D;
+            computeRadialFunctions(kappa, rsq, false, B, C, D);
+
+            Scalar eidotej = dot(e_i, e_j);
+            Scalar eidotr = dot(e_i, rvec);
+            Scalar ejdotr = dot(e_j, rvec);
+
+            vec3<Scalar> f = mumu*((eidotej*C - eidotr*ejdotr*D)*rvec + ejdotr*C*e_i + eidotr*C*e_j);
+
+            // torques from the fields of the partners, tau_i = mu_i x E_j(r_i)
+            vec3<Scalar> eicrossej = cross(e_i, e_j);
+            vec3<Scalar> t_i = mumu*(-B*eicrossej + ejdotr*C*cross(e_i, rvec));
+            vec3<Scalar> t_j = mumu*(B*eicrossej + eidotr*C*cross(e_j, rvec));
+
+            force = vec_to_scalar3(f);
+            torque_i = vec_to_scalar3(t_i);
+            torque_j = vec_to_scalar3(t_j);
+            pair_eng = mumu*(eidotej*B - eidotr*ejdotr*C);
+            return true;
+            }
+
+        #ifndef NVCC
+        //! Get the name of the potential
+        /*! \returns The potential name. Must be short and all lowercase, as this is the name energies will be logged as
+            via analyze.log.
+        */
+        static std::string getName()
+            {
+            return "dipole_ewald";
+            }
+        #endif
+
+    protected:
+        Scalar3 dr;                 //!< Stored vector pointing between particle centers of mass
+        Scalar rcutsq;              //!< Stored rcutsq from the constructor
+        vec3<Scalar> e_i,e_j;       //!< Dipole directions of the ith and jth particle in the space frame
+        Scalar mumu;                //!< Product of the dipole magnitudes
+        Scalar kappa;               //!< Ewald splitting parameter
+    };
+
+#endif // __PAIR_EVALUATOR_DIPOLE_EWALD_H__
@@ -39,15 +39,33 @@
                                            \mathrm{erfc}\left(\kappa r - \frac{\alpha}{2 \kappa}\right) \exp(-\alpha r)\right]
     \f]
 
-    The Ewald potential does not need diameter. Two parameters is specified and stored in a Scalar2.
+    The Ewald potential does not need diameter. Three parameters are specified and stored in a Scalar3.
     \a kappa is placed in \a params.x
     \a alpha is placed in \a params.y
+    \a erfc_mode is placed in \a params.z (as an integer, see below)
+
+    <b>Approximated erfc</b>
+
+    With \a erfc_mode = ERFC_EXACT, erfc and exp are evaluated with the math library for every pair. The other
+    modes replace erfc(x) by the rational approximations of Abramowitz and Stegun, eq. 7.1.26 (ERFC_RATIONAL5, maximum
+    absolute error 1.5e-7) and eq. 7.1.25 (ERFC_RATIONAL3, maximum absolute error 2.5e-5), of the form
+    \f$ \mathrm{erfc}(x) \approx P(t) \exp(-x^2) \f$ with \f$ t = 1/(1+px) \f$. Since
+    \f$ \exp(-\mathrm{arg}_1^2) = \exp(-\mathrm{arg}_2^2) \exp(-2\alpha r) \f$, the energy and force then need only
+    the two exponentials \f$ \exp(-\mathrm{arg}_2^2) \f$ and \f$ \exp(-\alpha r) \f$, or one when \f$ \alpha = 0 \f$.
 */
 class EvaluatorPairEwald
     {
     public:
         //! Define the parameter type used by this pair potential evaluator
-        typedef Scalar2 param_type;
+        typedef Scalar3 param_type;
+
+        //! Methods to evaluate erfc
+        enum erfc_mode
+            {
+            ERFC_EXACT = 0,     //!< Math library erfc
+            ERFC_RATIONAL5,     //!< Five term rational approximation (A&S 7.1.26)
+            ERFC_RATIONAL3      //!< Three term rational approximation (A&S 7.1.25)
+            };
 
         //! Constructs the pair potential evaluator
         /*! \param _rsq Squared distance between the particles
@@ -55,7 +73,7 @@ class EvaluatorPairEwald
             \param _params Per type pair parameters of this potential
         */
         DEVICE EvaluatorPairEwald(Scalar _rsq, Scalar _rcutsq, const param_type& _params)
-          : rsq(_rsq), rcutsq(_rcutsq), kappa(_params.x), alpha(_params.y)
+          : rsq(_rsq), rcutsq(_rcutsq), kappa(_params.x), alpha(_params.y), mode(__scalar_as_int(_params.z))
             {
             }
 
@@ -89,7 +107,33 @@ class EvaluatorPairEwald
         */
         DEVICE bool evalForceAndEnergy(Scalar& force_divr, Scalar& pair_eng, bool energy_shift)
             {
-            if (rsq < rcutsq && qiqj != 0)
+            if (rsq < rcutsq && qiqj != 0 && mode != ERFC_EXACT)
+                {
+                Scalar rinv = fast::rsqrt(rsq);
+                Scalar r = Scalar(1.0) / rinv;
+                Scalar r2inv = Scalar(1.0) / rsq;
+
+                Scalar arg1 = kappa*r+alpha/(Scalar(2.0)*kappa);
+                Scalar arg2 = kappa*r-alpha/(Scalar(2.0)*kappa);
+                Scalar expfac2 = (alpha != Scalar(0.0)) ? fast::exp(-alpha*r) : Scalar(1.0);
+                Scalar gauss2 = fast::exp(-arg2*arg2);
+
+                // erfc(arg1)*exp(alpha r) = P(t1) exp(-arg2^2) exp(-alpha r), as arg1^2 = arg2^2 + 2 alpha r
+                Scalar erfc1_exp1 = erfcPoly(arg1)*gauss2*expfac2;
+                Scalar erfc2 = erfcPoly(arg2)*gauss2;
+                if (arg2 < Scalar(0.0))
+                    erfc2 = Scalar(2.0) - erfc2;
+                Scalar erfc2_exp2 = erfc2*expfac2;
+
+                Scalar val = Scalar(0.5)*(erfc1_exp1 + erfc2_exp2)*rinv;
+
+                force_divr = qiqj * r2inv * (val + expfac2*Scalar(2.0)*kappa*gauss2/fast::sqrt(Scalar(M_PI))
+                    + alpha*Scalar(0.5)*erfc2_exp2 - alpha*Scalar(0.5)*erfc1_exp1);
+                pair_eng = qiqj * val;
+
+                return true;
+                }
+            else if (rsq < rcutsq && qiqj != 0)
                 {
                 Scalar rinv = fast::rsqrt(rsq);
                 Scalar r = Scalar(1.0) / rinv;
@@ -127,7 +171,28 @@ class EvaluatorPairEwald
         Scalar rcutsq;  //!< Stored rcutsq from the constructor
         Scalar kappa;   //!< Splitting parameter
         Scalar alpha;   //!< Debye screening parameter
+        int mode;       //!< Method to evaluate erfc
         Scalar qiqj;    //!< product of qi and qj
+
+        //! Rational factor of the erfc approximation
+        /*! \param x Argument of erfc
+            \returns P(t), so that erfc(|x|) is approximately P(t) exp(-x^2)
+        */
+        DEVICE inline Scalar erfcPoly(Scalar x) const
+            {
+            x = fabs(x);
+            if (mode == ERFC_RATIONAL3)
+                {
+                Scalar t = Scalar(1.0) / (Scalar(1.0) + Scalar(0.47047)*x);
+                return t*(Scalar(0.3480242) + t*(Scalar(-0.0958798) + t*Scalar(0.7478556)));
+                }
+            else
+                {
+                Scalar t = Scalar(1.0) / (Scalar(1.0) + Scalar(0.3275911)*x);
+                return t*(Scalar(0.254829592) + t*(Scalar(-0.284496736) + t*(Scalar(1.421413741)
+                    + t*(Scalar(-1.453152027) + t*Scalar(1.061405429)))));
+                }
+            }
     };
 
 
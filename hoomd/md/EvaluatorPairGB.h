@@ -31,6 +31,8 @@
 /*!
  * Gay-Berne potential as formulated by Allen and Germano,
  * with shape-independent energy parameter, for identical uniaxial particles.
+ *
+ * The orientation of a particle enters only through its long axis (the body z axis), see getBodyAxis().
  */
 
 class EvaluatorPairGB
@@ -50,11 +52,35 @@ class EvaluatorPairGB
                                const Scalar4& _qj,
                                const Scalar _rcutsq,
                                const param_type& _params)
-            : dr(_dr),rcutsq(_rcutsq),qi(_qi),qj(_qj),
+            : dr(_dr),rcutsq(_rcutsq),
+              a3(rotate(quat<Scalar>(_qi), getBodyAxis())), b3(rotate(quat<Scalar>(_qj), getBodyAxis())),
               epsilon(_params.x), lperp(_params.y), lpar(_params.z)
             {
             }
 
+        //! Constructs the pair potential evaluator from the long axes of the particles
+        /*! \param _dr Displacement vector between particle centers of mass
+            \param _a3 Long axis of the i^th particle in the space frame
+            \param _b3 Long axis of the j^th particle in the space frame
+            \param _rcutsq Squared distance at which the potential goes to 0
+            \param _params Per type pair parameters of this potential
+        */
+        DEVICE EvaluatorPairGB(const Scalar3& _dr,
+                               const vec3<Scalar>& _a3,
+                               const vec3<Scalar>& _b3,
+                               const Scalar _rcutsq,
+                               const param_type& _params)
+            : dr(_dr),rcutsq(_rcutsq),a3(_a3),b3(_b3),
+              epsilon(_params.x), lperp(_params.y), lpar(_params.z)
+            {
+            }
+
+        //! The long axis of the particles in the body frame
+        DEVICE static vec3<Scalar> getBodyAxis()
+            {
+            return vec3<Scalar>(0,0,1);
+            }
+
         //! uses diameter
         DEVICE static bool needsDiameter()
             {
@@ -95,14 +121,6 @@ class EvaluatorPairGB
             Scalar r = fast::sqrt(rsq);
             vec3<Scalar> unitr = fast::rsqrt(dot(dr,dr))*dr;
 
-            // obtain rotation matrices (space->body)
-            rotmat3<Scalar> rotA(conj(qi));
-            rotmat3<Scalar> rotB(conj(qj));
-
-            // last row of rotation matrix
-            vec3<Scalar> a3 = rotA.row2;
-            vec3<Scalar> b3 = rotB.row2;
-
             Scalar ca = dot(a3,unitr);
             Scalar cb = dot(b3,unitr);
             Scalar cab = dot(a3,b3);
@@ -180,8 +198,8 @@ class EvaluatorPairGB
     protected:
         vec3<Scalar> dr;   //!< Stored dr from the constructor
         Scalar rcutsq;     //!< Stored rcutsq from the constructor
-        quat<Scalar> qi;   //!< Orientation quaternion for particle i
-        quat<Scalar> qj;   //!< Orientation quaternion for particle j
+        vec3<Scalar> a3;   //!< Long axis of particle i in the space frame
+        vec3<Scalar> b3;   //!< Long axis of particle j in the space frame
         Scalar epsilon;    //!< Energy parameter
         Scalar lperp;      //!< Short axis length
         Scalar lpar;       //!< Longt axis length
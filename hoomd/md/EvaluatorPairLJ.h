@@ -12,6 +12,7 @@
 #endif
 
 #include "hoomd/HOOMDMath.h"
+#include "MDPrecisionSetup.h"
 
 /*! \file EvaluatorPairLJ.h
     \brief Defines the pair evaluator class for LJ potentials
@@ -73,6 +74,10 @@
     needs to diverge between the host and device (i.e., to use a special math function like __powf on the device), it
     can similarly be put inside an ifdef NVCC block.
 
+    The evaluator receives a squared distance that PotentialPair computed from the displacement wrapped into the box,
+    so it can do its own arithmetic in ForceReal (see MDPrecisionSetup.h), which is float in mixed precision builds.
+    The results are written to the Scalar out parameters and summed in Scalar.
+
     <b>LJ specifics</b>
 
     EvaluatorPairLJ evaluates the function:
@@ -139,18 +144,19 @@ class EvaluatorPairLJ
             // compute the force divided by r in force_divr
             if (rsq < rcutsq && lj1 != 0)
                 {
-                Scalar r2inv = Scalar(1.0)/rsq;
-                Scalar r6inv = r2inv * r2inv * r2inv;
-                force_divr= r2inv * r6inv * (Scalar(12.0)*lj1*r6inv - Scalar(6.0)*lj2);
+                ForceReal r2inv = ForceReal(1.0)/rsq;
+                ForceReal r6inv = r2inv * r2inv * r2inv;
+                force_divr= r2inv * r6inv * (ForceReal(12.0)*lj1*r6inv - ForceReal(6.0)*lj2);
 
-                pair_eng = r6inv * (lj1*r6inv - lj2);
+                ForceReal eng = r6inv * (lj1*r6inv - lj2);
 
                 if (energy_shift)
                     {
-                    Scalar rcut2inv = Scalar(1.0)/rcutsq;
-                    Scalar rcut6inv = rcut2inv * rcut2inv * rcut2inv;
-                    pair_eng -= rcut6inv * (lj1*rcut6inv - lj2);
+                    ForceReal rcut2inv = ForceReal(1.0)/rcutsq;
+                    ForceReal rcut6inv = rcut2inv * rcut2inv * rcut2inv;
+                    eng -= rcut6inv * (lj1*rcut6inv - lj2);
                     }
+                pair_eng = eng;
                 return true;
                 }
             else
@@ -169,10 +175,10 @@ class EvaluatorPairLJ
         #endif
 
     protected:
-        Scalar rsq;     //!< Stored rsq from the constructor
-        Scalar rcutsq;  //!< Stored rcutsq from the constructor
-        Scalar lj1;     //!< lj1 parameter extracted from the params passed to the constructor
-        Scalar lj2;     //!< lj2 parameter extracted from the params passed to the constructor
+        ForceReal rsq;     //!< Stored rsq from the constructor
+        ForceReal rcutsq;  //!< Stored rcutsq from the constructor
+        ForceReal lj1;     //!< lj1 parameter extracted from the params passed to the constructor
+        ForceReal lj2;     //!< lj2 parameter extracted from the params passed to the constructor
     };
 
 
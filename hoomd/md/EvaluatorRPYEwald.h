@@ -0,0 +1,111 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#ifndef __EVALUATOR_RPY_EWALD_H__
+#define __EVALUATOR_RPY_EWALD_H__
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file EvaluatorRPYEwald.h
+    \brief Defines the evaluator of the Ewald split Rotne-Prager-Yamakawa mobility
+*/
+
+// need to declare these class methods with __device__ qualifiers when building in nvcc
+// DEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef NVCC
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif
+
+//! Evaluates the Ewald sum of the Rotne-Prager-Yamakawa mobility in a periodic box
+/*! The mobility of equal spheres of radius \f$ a \f$ in a fluid of viscosity \f$ \eta \f$ is split with the Ewald
+    parameter \f$ \xi \f$ into a short ranged real space part, a self part and a smooth wave space part (C. W. J.
+    Beenakker, J. Chem. Phys. 85, 1581 (1986)). All parts are in units of the single particle mobility
+    \f$ \mu_0 = 1/(6 \pi \eta a) \f$.
+
+    The real space part of a pair at distance \f$ r \f$ is
+    \f[ M(\vec{r}) = F(r) \mathbf{I} + G(r) \hat{r} \hat{r} \f]
+    evaluated by evalRealSpace(). For overlapping spheres (\f$ r < 2a \f$), the difference between the overlap form
+    of the RPY tensor and its far field form is included, so that the mobility stays positive definite.
+
+    The wave space part for a wave vector \f$ \vec{k} \f$ in a box of volume \f$ V \f$ is
+    \f[ M(\vec{k}) = \frac{6 \pi a}{V} \left(1 - \frac{a^2 k^2}{3}\right)
+        \left(1 + \frac{k^2}{4\xi^2} + \frac{k^4}{8\xi^4}\right) \frac{e^{-k^2/4\xi^2}}{k^2}
+        (\mathbf{I} - \hat{k} \hat{k}) \f]
+    where evalWaveSpace() returns the scalar prefactor.
+*/
+class EvaluatorRPYEwald
+    {
+    public:
+        //! Constructs the evaluator
+        /*! \param _a Particle radius
+            \param _xi Ewald splitting parameter
+        */
+        DEVICE EvaluatorRPYEwald(Scalar _a, Scalar _xi)
+            : a(_a), xi(_xi)
+            {
+            }
+
+        //! Evaluate the real space part of a pair
+        /*! \param r Distance between the particles
+            \param F (output) Coefficient of the unit tensor
+            \param G (output) Coefficient of the dyadic product of the unit distance vector
+        */
+        DEVICE void evalRealSpace(Scalar r, Scalar& F, Scalar& G) const
+            {
+            Scalar rsq = r*r;
+            Scalar a3 = a*a*a;
+            Scalar xi2 = xi*xi;
+            Scalar xi3 = xi2*xi;
+            Scalar xi5 = xi3*xi2;
+            Scalar xi7 = xi5*xi2;
+
+            Scalar erfc_xir = erfc(xi*r);
+            Scalar gauss = fast::exp(-xi2*rsq)/sqrt(Scalar(M_PI));
+
+            F = erfc_xir*(Scalar(0.75)*a/r + Scalar(0.5)*a3/(r*rsq))
+                + gauss*(Scalar(4.0)*xi7*a3*rsq*rsq + Scalar(3.0)*xi3*a*rsq - Scalar(20.0)*xi5*a3*rsq
+                         - Scalar(4.5)*xi*a + Scalar(14.0)*xi3*a3 + xi*a3/rsq);
+            G = erfc_xir*(Scalar(0.75)*a/r - Scalar(1.5)*a3/(r*rsq))
+                + gauss*(-Scalar(4.0)*xi7*a3*rsq*rsq - Scalar(3.0)*xi3*a*rsq + Scalar(16.0)*xi5*a3*rsq
+                         + Scalar(1.5)*xi*a - Scalar(2.0)*xi3*a3 - Scalar(3.0)*xi*a3/rsq);
+
+            if (r < Scalar(2.0)*a)
+                {
+                // replace the far field form by the overlap form of the RPY tensor
+                F += Scalar(1.0) - Scalar(9.0/32.0)*r/a - Scalar(0.75)*a/r - Scalar(0.5)*a3/(r*rsq);
+                G += Scalar(3.0/32.0)*r/a - Scalar(0.75)*a/r + Scalar(1.5)*a3/(r*rsq);
+                }
+            }
+
+        //! Evaluate the self part
+        /*! \returns Coefficient of the unit tensor of the self mobility
+        */
+        DEVICE Scalar evalSelf() const
+            {
+            return Scalar(1.0) - Scalar(6.0)*xi*a/sqrt(Scalar(M_PI))
+                + Scalar(40.0/3.0)*xi*xi*xi*a*a*a/sqrt(Scalar(M_PI));
+            }
+
+        //! Evaluate the wave space part
+        /*! \param ksq Squared wave vector, must be non-zero
+            \param V Volume of the box
+            \returns Prefactor of the transverse projection
+        */
+        DEVICE Scalar evalWaveSpace(Scalar ksq, Scalar V) const
+            {
+            Scalar k2_xi2 = ksq/(Scalar(4.0)*xi*xi);
+            return Scalar(6.0*M_PI)*a/V*(Scalar(1.0) - a*a*ksq/Scalar(3.0))
+                *(Scalar(1.0) + k2_xi2 + Scalar(2.0)*k2_xi2*k2_xi2)*fast::exp(-k2_xi2)/ksq;
+            }
+
+    protected:
+        Scalar a;   //!< Particle radius
+        Scalar xi;  //!< Ewald splitting parameter
+    };
+
+#endif // __EVALUATOR_RPY_EWALD_H__
@@ -13,6 +13,7 @@
 
 #ifndef NVCC
 #include <string>
+#include <algorithm>
 #endif
 
 #include "hoomd/BoxDim.h"
@@ -32,15 +33,138 @@ const unsigned int MAX_N_SWALLS=20;
 const unsigned int MAX_N_CWALLS=20;
 const unsigned int MAX_N_PWALLS=60;
 
+// sets the max number of cells of the wall culling grid
+const unsigned int MAX_N_WALL_CELLS=256;
+
+//! Walls that can interact with the particles in one cell of the culling grid
+/*! Bit k of each mask is set when wall k of that geometry type can act on a particle in the cell. The masks have
+    room for the MAX_N_SWALLS spheres, MAX_N_CWALLS cylinders and MAX_N_PWALLS planes.
+*/
+struct wall_cell
+    {
+    unsigned int     spheres;
+    unsigned int     cylinders;
+    unsigned int     planes[2];
+    };
+
 struct wall_type{
+    wall_type() : numSpheres(0), numCylinders(0), numPlanes(0), numCells(make_uint3(0,0,0)) {}
     unsigned int     numSpheres; // these data types come first, since the structs are aligned already
     unsigned int     numCylinders;
     unsigned int     numPlanes;
     SphereWall       Spheres[MAX_N_SWALLS];
     CylinderWall     Cylinders[MAX_N_CWALLS];
     PlaneWall        Planes[MAX_N_PWALLS];
+    Scalar3          cellLo;            // lower corner of the culling grid
+    Scalar3          cellInvWidth;      // inverse cell widths of the culling grid
+    uint3            numCells;          // dimensions of the culling grid, 0 if all walls are evaluated
+    wall_cell        Cells[MAX_N_WALL_CELLS];
 };
 
+//! Get the cell of the culling grid that contains a position
+/*! \param field Walls with their culling grid
+    \param pos Position of the particle
+    \returns The cell, or NULL if the position is outside of the grid and all walls have to be evaluated
+*/
+DEVICE inline const wall_cell* getWallCell(const wall_type& field, const vec3<Scalar>& pos)
+    {
+    Scalar fx = (pos.x - field.cellLo.x) * field.cellInvWidth.x;
+    Scalar fy = (pos.y - field.cellLo.y) * field.cellInvWidth.y;
+    Scalar fz = (pos.z - field.cellLo.z) * field.cellInvWidth.z;
+
+    // also true for an empty grid
+    if (!(fx >= Scalar(0.0) && fx < Scalar(field.numCells.x) && fy >= Scalar(0.0) && fy < Scalar(field.numCells.y)
+        && fz >= Scalar(0.0) && fz < Scalar(field.numCells.z)))
+        return NULL;
+
+    unsigned int i = (unsigned int)fx;
+    unsigned int j = (unsigned int)fy;
+    unsigned int k = (unsigned int)fz;
+    return &field.Cells[(k*field.numCells.y + j)*field.numCells.x + i];
+    }
+
+#ifndef NVCC
+//! Build the culling grid of the walls
+/*! \param field Walls to build the grid for
+    \param box The grid covers the axis-aligned bounding box of this box
+    \param r_max Largest cutoff radius or extrapolation distance of all particle types
+    \param extrapolated True if any particle type uses the extrapolated mode
+
+    distWall() changes by at most the displacement of the position. A particle in a cell of half diagonal h with
+    center c thus only finds a wall with distWall() in [0, r_max) (or below r_max in the extrapolated mode, which
+    also acts on particles outside of the half-space) when distWall(c) lies within h of that interval. The grid is
+    fixed in space, particles that leave it after the box changes evaluate all walls.
+*/
+inline void buildWallCells(wall_type& field, const BoxDim& box, Scalar r_max, bool extrapolated)
+    {
+    // axis-aligned bounding box of the (possibly triclinic) box
+    vec3<Scalar> lo(box.getLo());
+    vec3<Scalar> hi(lo);
+    for (unsigned int corner = 1; corner < 8; ++corner)
+        {
+        vec3<Scalar> x(box.getLo());
+        for (unsigned int dir = 0; dir < 3; ++dir)
+            if (corner & (1 << dir))
+                x += vec3<Scalar>(box.getLatticeVector(dir));
+        lo = vec3<Scalar>(std::min(lo.x, x.x), std::min(lo.y, x.y), std::min(lo.z, x.z));
+        hi = vec3<Scalar>(std::max(hi.x, x.x), std::max(hi.y, x.y), std::max(hi.z, x.z));
+        }
+    vec3<Scalar> L = hi - lo;
+
+    // choose cubic cells and grow them until the grid fits, thin directions (2D) get a single layer
+    Scalar width = pow(L.x*L.y*L.z/Scalar(MAX_N_WALL_CELLS), Scalar(1.0/3.0));
+    uint3 n;
+    do
+        {
+        n.x = std::max((unsigned int)(L.x/width), 1u);
+        n.y = std::max((unsigned int)(L.y/width), 1u);
+        n.z = std::max((unsigned int)(L.z/width), 1u);
+        width *= Scalar(1.05);
+        } while (n.x*n.y*n.z > MAX_N_WALL_CELLS);
+
+    vec3<Scalar> cell_width(L.x/Scalar(n.x), L.y/Scalar(n.y), L.z/Scalar(n.z));
+
+    // pad the half diagonal to cover round-off in the distances
+    Scalar h = Scalar(0.5)*sqrt(dot(cell_width, cell_width))*Scalar(1.001);
+
+    field.cellLo = vec_to_scalar3(lo);
+    field.cellInvWidth = make_scalar3(Scalar(1.0)/cell_width.x, Scalar(1.0)/cell_width.y, Scalar(1.0)/cell_width.z);
+    field.numCells = n;
+
+    for (unsigned int k = 0; k < n.z; ++k)
+        for (unsigned int j = 0; j < n.y; ++j)
+            for (unsigned int i = 0; i < n.x; ++i)
+                {
+                vec3<Scalar> c = lo + vec3<Scalar>((Scalar(i)+Scalar(0.5))*cell_width.x,
+                    (Scalar(j)+Scalar(0.5))*cell_width.y, (Scalar(k)+Scalar(0.5))*cell_width.z);
+                wall_cell& cell = field.Cells[(k*n.y + j)*n.x + i];
+                cell.spheres = 0;
+                cell.cylinders = 0;
+                cell.planes[0] = 0;
+                cell.planes[1] = 0;
+
+                for (unsigned int w = 0; w < field.numSpheres; ++w)
+                    {
+                    Scalar d = distWall(field.Spheres[w], c);
+                    if (d <= r_max + h && (extrapolated || d >= -h))
+                        cell.spheres |= 1u << w;
+                    }
+                for (unsigned int w = 0; w < field.numCylinders; ++w)
+                    {
+                    Scalar d = distWall(field.Cylinders[w], c);
+                    if (d <= r_max + h && (extrapolated || d >= -h))
+                        cell.cylinders |= 1u << w;
+                    }
+                for (unsigned int w = 0; w < field.numPlanes; ++w)
+                    {
+                    Scalar d = distWall(field.Planes[w], c);
+                    if (d <= r_max + h && (extrapolated || d >= -h))
+                        cell.planes[w >> 5] |= 1u << (w & 31);
+                    }
+                }
+    }
+#endif
+
 //! Applys a wall force from all walls in the field parameter
 /*! \ingroup computes
 */
@@ -182,12 +306,22 @@ class EvaluatorWalls
             vec3<Scalar> position = vec3<Scalar>(m_pos);
             vec3<Scalar> drv;
             bool inside = false; //keeps compiler from complaining
+
+            // skip the walls that cannot interact with particles in this cell of the culling grid
+            const wall_cell *cell = getWallCell(m_field, position);
+            unsigned int sphere_mask = cell ? cell->spheres : ~0u;
+            unsigned int cylinder_mask = cell ? cell->cylinders : ~0u;
+            unsigned int plane_mask[2];
+            plane_mask[0] = cell ? cell->planes[0] : ~0u;
+            plane_mask[1] = cell ? cell->planes[1] : ~0u;
             if (m_params.rextrap>0.0) //extrapolated mode
                 {
                 Scalar rextrapsq=m_params.rextrap * m_params.rextrap;
                 Scalar rsq;
                 for (unsigned int k = 0; k < m_field.numSpheres; k++)
                     {
+                    if (!(sphere_mask & (1u << k)))
+                        continue;
                     drv = vecPtToWall(m_field.Spheres[k], position, inside);
                     rsq = dot(drv, drv);
                     if (inside && rsq>=rextrapsq)
@@ -213,6 +347,8 @@ class EvaluatorWalls
                     }
                 for (unsigned int k = 0; k < m_field.numCylinders; k++)
                     {
+                    if (!(cylinder_mask & (1u << k)))
+                        continue;
                     drv = vecPtToWall(m_field.Cylinders[k], position, inside);
                     rsq = dot(drv, drv);
                     if (inside && rsq>=rextrapsq)
@@ -240,6 +376,8 @@ class EvaluatorWalls
                     }
                 for (unsigned int k = 0; k < m_field.numPlanes; k++)
                     {
+                    if (!(plane_mask[k >> 5] & (1u << (k & 31))))
+                        continue;
                     drv = vecPtToWall(m_field.Planes[k], position, inside);
                     rsq = dot(drv, drv);
                     if (inside && rsq>=rextrapsq)
@@ -268,6 +406,8 @@ class EvaluatorWalls
                 {
                 for (unsigned int k = 0; k < m_field.numSpheres; k++)
                     {
+                    if (!(sphere_mask & (1u << k)))
+                        continue;
                     drv = vecPtToWall(m_field.Spheres[k], position, inside);
                     if (inside)
                         {
@@ -276,6 +416,8 @@ class EvaluatorWalls
                     }
                 for (unsigned int k = 0; k < m_field.numCylinders; k++)
                     {
+                    if (!(cylinder_mask & (1u << k)))
+                        continue;
                     drv = vecPtToWall(m_field.Cylinders[k], position, inside);
                     if (inside)
                         {
@@ -284,6 +426,8 @@ class EvaluatorWalls
                     }
                 for (unsigned int k = 0; k < m_field.numPlanes; k++)
                     {
+                    if (!(plane_mask[k >> 5] & (1u << (k & 31))))
+                        continue;
                     drv = vecPtToWall(m_field.Planes[k], position, inside);
                     if (inside)
                         {
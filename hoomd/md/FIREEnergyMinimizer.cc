@@ -148,7 +148,7 @@ void FIREEnergyMinimizer::update(unsigned int timestep)
     Scalar wnorm(0.0);
 
     // Calculate the per-particle potential energy over particles in the group
-    Scalar energy(0.0);
+    double pe_total = 0.0;
 
     unsigned int total_group_size = 0;
 
@@ -156,9 +156,6 @@ void FIREEnergyMinimizer::update(unsigned int timestep)
     const GlobalArray< Scalar4 >& net_force = m_pdata->getNetForce();
     ArrayHandle<Scalar4> h_net_force(net_force, access_location::host, access_mode::read);
 
-    // total potential energy
-    double pe_total = 0.0;
-
     for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
         {
         std::shared_ptr<ParticleGroup> current_group = (*method)->getGroup();
@@ -173,32 +170,11 @@ void FIREEnergyMinimizer::update(unsigned int timestep)
         }
 
     m_energy_total = pe_total;
-
-    #ifdef ENABLE_MPI
-    if (m_pdata->getDomainDecomposition())
-        {
-        MPI_Allreduce(MPI_IN_PLACE, &pe_total, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-        MPI_Allreduce(MPI_IN_PLACE, &total_group_size, 1, MPI_INT, MPI_SUM, m_exec_conf->getMPICommunicator());
-        }
-    #endif
-
-    energy = pe_total/Scalar(total_group_size);
     }
 
-
-    if (m_was_reset)
-        {
-        m_was_reset = false;
-        m_old_energy = energy + Scalar(100000)*m_etol;
-        }
-
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
 
-    #ifdef ENABLE_MPI
-    bool aniso = false;
-    #endif
-
     for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
         {
         std::shared_ptr<ParticleGroup> current_group = (*method)->getGroup();
@@ -213,10 +189,6 @@ void FIREEnergyMinimizer::update(unsigned int timestep)
 
         if ((*method)->getAnisotropic())
             {
-            #ifdef ENABLE_MPI
-            aniso = true;
-            #endif
-
             ArrayHandle<Scalar4> h_net_torque(m_pdata->getNetTorqueArray(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
             ArrayHandle<Scalar4> h_angmom(m_pdata->getAngularMomentumArray(), access_location::host, access_mode::read);
@@ -257,19 +229,23 @@ void FIREEnergyMinimizer::update(unsigned int timestep)
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
-        MPI_Allreduce(MPI_IN_PLACE, &fnorm, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-        MPI_Allreduce(MPI_IN_PLACE, &vnorm, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-        MPI_Allreduce(MPI_IN_PLACE, &Pt, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-
-        if (aniso)
-            {
-            MPI_Allreduce(MPI_IN_PLACE, &tnorm, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-            MPI_Allreduce(MPI_IN_PLACE, &wnorm, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-            MPI_Allreduce(MPI_IN_PLACE, &Pr, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-            }
+        // reduce all sums and the group size in a single collective
+        double sums[8] = {pe_total, Pt, vnorm, fnorm, Pr, wnorm, tnorm, double(total_group_size)};
+        MPI_Allreduce(MPI_IN_PLACE, sums, 8, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+        pe_total = sums[0]; Pt = sums[1]; vnorm = sums[2]; fnorm = sums[3];
+        Pr = sums[4]; wnorm = sums[5]; tnorm = sums[6];
+        total_group_size = (unsigned int)sums[7];
         }
     #endif
 
+    Scalar energy = pe_total/Scalar(total_group_size);
+
+    if (m_was_reset)
+        {
+        m_was_reset = false;
+        m_old_energy = energy + Scalar(100000)*m_etol;
+        }
+
     fnorm = sqrt(fnorm);
     vnorm = sqrt(vnorm);
 
@@ -32,30 +32,13 @@ FIREEnergyMinimizerGPU::FIREEnergyMinimizerGPU(std::shared_ptr<SystemDefinition>
         }
 
     // allocate the sum arrays
-    GPUArray<Scalar> sum(1, m_exec_conf);
+    GPUArray<Scalar> sum(FIRE_NUM_SUMS, m_exec_conf);
     m_sum.swap(sum);
-    GPUArray<Scalar> sum3(3, m_exec_conf);
-    m_sum3.swap(sum3);
 
-    // initialize the partial sum arrays
-    m_block_size = 256; //128;
-
-    unsigned int num_blocks = 0;
-    for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
-        {
-        std::shared_ptr<ParticleGroup> current_group = (*method)->getGroup();
-
-        unsigned int group_size = current_group->getIndexArray().getNumElements();
-        num_blocks = std::max(num_blocks, group_size);
-        }
-
-    num_blocks = num_blocks/m_block_size + 1;
-    GPUArray<Scalar> partial_sum1(num_blocks, m_exec_conf);
-    m_partial_sum1.swap(partial_sum1);
-    GPUArray<Scalar> partial_sum2(num_blocks, m_exec_conf);
-    m_partial_sum2.swap(partial_sum2);
-    GPUArray<Scalar> partial_sum3(num_blocks, m_exec_conf);
-    m_partial_sum3.swap(partial_sum3);
+    // the partial sums are resized to the group sizes in update()
+    m_block_size = 256;
+    GPUArray<Scalar> partial_sum(FIRE_NUM_SUMS, m_exec_conf);
+    m_partial_sum.swap(partial_sum);
 
     reset();
     }
@@ -70,67 +53,95 @@ void FIREEnergyMinimizerGPU::update(unsigned int timestep)
 
     IntegratorTwoStep::update(timestep);
 
-    Scalar Pt(0.0);  //translational power
-    Scalar Pr(0.0); //rotational power
-    Scalar vnorm(0.0);
-    Scalar fnorm(0.0);
-    Scalar energy(0.0);
-    Scalar tnorm(0.0);
-    Scalar wnorm(0.0);
-
-    // compute the total energy on the GPU
-    // CPU version is Scalar energy = computePotentialEnergy(timesteps)/Scalar(group_size);
-
+    // all sums are reduced in one pass over the groups, one download and one collective
     if (m_prof)
-        m_prof->push(m_exec_conf, "FIRE compute total energy");
+        m_prof->push(m_exec_conf, "FIRE reduce");
 
     unsigned int total_group_size = 0;
-
+    unsigned int num_blocks = 0;
     for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
         {
-        std::shared_ptr<ParticleGroup> current_group = (*method)->getGroup();
-
-        unsigned int group_size = current_group->getIndexArray().getNumElements();
+        unsigned int group_size = (*method)->getGroup()->getNumMembers();
         total_group_size += group_size;
+        num_blocks += group_size/m_block_size + 1;
+        }
 
-        ArrayHandle< unsigned int > d_index_array(current_group->getIndexArray(), access_location::device, access_mode::read);
+    if (m_partial_sum.getNumElements() < num_blocks*FIRE_NUM_SUMS)
+        m_partial_sum.resize(num_blocks*FIRE_NUM_SUMS);
 
+        {
+        ArrayHandle<Scalar4> d_net_force(m_pdata->getNetForce(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar3> d_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_angmom(m_pdata->getAngularMomentumArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_net_torque(m_pdata->getNetTorqueArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar> d_partial_sum(m_partial_sum, access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar> d_sum(m_sum, access_location::device, access_mode::overwrite);
+
+        unsigned int block_offset = 0;
+        for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
             {
-            ArrayHandle<Scalar4> d_net_force(m_pdata->getNetForce(), access_location::device, access_mode::read);
-            ArrayHandle<Scalar> d_partial_sumE(m_partial_sum1, access_location::device, access_mode::overwrite);
-            ArrayHandle<Scalar> d_sumE(m_sum, access_location::device, access_mode::overwrite);
-
-            unsigned int num_blocks = group_size/m_block_size + 1;
-            gpu_fire_compute_sum_pe(d_index_array.data,
-                                    group_size,
-                                    d_net_force.data,
-                                    d_sumE.data,
-                                    d_partial_sumE.data,
-                                    m_block_size,
-                                    num_blocks);
+            std::shared_ptr<ParticleGroup> current_group = (*method)->getGroup();
+            unsigned int group_size = current_group->getNumMembers();
+            ArrayHandle< unsigned int > d_index_array(current_group->getIndexArray(), access_location::device, access_mode::read);
+
+            gpu_fire_compute_partial_sums(d_index_array.data,
+                                          group_size,
+                                          d_net_force.data,
+                                          d_vel.data,
+                                          d_accel.data,
+                                          d_orientation.data,
+                                          d_inertia.data,
+                                          d_angmom.data,
+                                          d_net_torque.data,
+                                          (*method)->getAnisotropic(),
+                                          d_partial_sum.data,
+                                          block_offset,
+                                          m_block_size);
 
             if(m_exec_conf->isCUDAErrorCheckingEnabled())
                 CHECK_CUDA_ERROR();
+
+            block_offset += group_size/m_block_size + 1;
             }
 
-        ArrayHandle<Scalar> h_sumE(m_sum, access_location::host, access_mode::read);
-        energy += h_sumE.data[0];
+        gpu_fire_reduce_sums(d_sum.data, d_partial_sum.data, num_blocks);
+
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    // the group size is reduced along with the sums
+    double sums[FIRE_NUM_SUMS+1];
+        {
+        ArrayHandle<Scalar> h_sum(m_sum, access_location::host, access_mode::read);
+        for (unsigned int k = 0; k < FIRE_NUM_SUMS; k++)
+            sums[k] = h_sum.data[k];
+        sums[FIRE_NUM_SUMS] = total_group_size;
         }
 
+    m_energy_total = sums[FIRE_SUM_PE];
+
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
-        MPI_Allreduce(MPI_IN_PLACE, &energy, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-        MPI_Allreduce(MPI_IN_PLACE, &total_group_size, 1, MPI_INT, MPI_SUM, m_exec_conf->getMPICommunicator());
+        MPI_Allreduce(MPI_IN_PLACE, sums, FIRE_NUM_SUMS+1, MPI_DOUBLE, MPI_SUM, m_exec_conf->getMPICommunicator());
+        total_group_size = (unsigned int)sums[FIRE_NUM_SUMS];
         }
     #endif
 
-    m_energy_total = energy;
-    energy /= (Scalar) total_group_size;
-
     if (m_prof)
         m_prof->pop(m_exec_conf);
 
+    Scalar energy = sums[FIRE_SUM_PE]/Scalar(total_group_size);
+    Scalar Pt = sums[FIRE_SUM_P];  //translational power
+    Scalar Pr = sums[FIRE_SUM_PR]; //rotational power
+    Scalar vnorm = sqrt(sums[FIRE_SUM_VSQ]);
+    Scalar fnorm = sqrt(sums[FIRE_SUM_ASQ]);
+    Scalar wnorm = sqrt(sums[FIRE_SUM_WSQ]);
+    Scalar tnorm = sqrt(sums[FIRE_SUM_TSQ]);
 
     if (m_was_reset)
         {
@@ -138,116 +149,6 @@ void FIREEnergyMinimizerGPU::update(unsigned int timestep)
         m_old_energy = energy + Scalar(100000)*m_etol;
         }
 
-    //sum P, vnorm, fnorm
-
-    if (m_prof)
-        m_prof->push(m_exec_conf, "FIRE P, vnorm, fnorm");
-
-    bool aniso = false;
-
-    for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
-        {
-        std::shared_ptr<ParticleGroup> current_group = (*method)->getGroup();
-
-        unsigned int group_size = current_group->getIndexArray().getNumElements();
-        ArrayHandle< unsigned int > d_index_array(current_group->getIndexArray(), access_location::device, access_mode::read);
-
-            {
-            ArrayHandle<Scalar> d_partial_sum_P(m_partial_sum1, access_location::device, access_mode::overwrite);
-            ArrayHandle<Scalar> d_partial_sum_vsq(m_partial_sum2, access_location::device, access_mode::overwrite);
-            ArrayHandle<Scalar> d_partial_sum_fsq(m_partial_sum3, access_location::device, access_mode::overwrite);
-            ArrayHandle<Scalar> d_sum(m_sum3, access_location::device, access_mode::overwrite);
-            ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::read);
-            ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::read);
-
-            unsigned int num_blocks = group_size/m_block_size + 1;
-
-            gpu_fire_compute_sum_all(m_pdata->getN(),
-                                     d_vel.data,
-                                     d_accel.data,
-                                     d_index_array.data,
-                                     group_size,
-                                     d_sum.data,
-                                     d_partial_sum_P.data,
-                                     d_partial_sum_vsq.data,
-                                     d_partial_sum_fsq.data,
-                                     m_block_size,
-                                     num_blocks);
-
-            if(m_exec_conf->isCUDAErrorCheckingEnabled())
-                CHECK_CUDA_ERROR();
-            }
-
-        ArrayHandle<Scalar> h_sum(m_sum3, access_location::host, access_mode::read);
-        Pt += h_sum.data[0];
-        vnorm += h_sum.data[1];
-        fnorm += h_sum.data[2];
-
-        if ((*method)->getAnisotropic())
-            {
-            aniso = true;
-
-                {
-                ArrayHandle<Scalar> d_partial_sum_Pr(m_partial_sum1, access_location::device, access_mode::overwrite);
-                ArrayHandle<Scalar> d_partial_sum_wnorm(m_partial_sum2, access_location::device, access_mode::overwrite);
-                ArrayHandle<Scalar> d_partial_sum_tsq(m_partial_sum3, access_location::device, access_mode::overwrite);
-                ArrayHandle<Scalar> d_sum(m_sum3, access_location::device, access_mode::overwrite);
-                ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device, access_mode::read);
-                ArrayHandle<Scalar4> d_angmom(m_pdata->getAngularMomentumArray(), access_location::device, access_mode::read);
-                ArrayHandle<Scalar4> d_net_torque(m_pdata->getNetTorqueArray(), access_location::device, access_mode::read);
-                ArrayHandle<Scalar3> d_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::device, access_mode::read);
-
-                unsigned int num_blocks = group_size/m_block_size + 1;
-
-                gpu_fire_compute_sum_all_angular(m_pdata->getN(),
-                                         d_orientation.data,
-                                         d_inertia.data,
-                                         d_angmom.data,
-                                         d_net_torque.data,
-                                         d_index_array.data,
-                                         group_size,
-                                         d_sum.data,
-                                         d_partial_sum_Pr.data,
-                                         d_partial_sum_wnorm.data,
-                                         d_partial_sum_tsq.data,
-                                         m_block_size,
-                                         num_blocks);
-
-                if(m_exec_conf->isCUDAErrorCheckingEnabled())
-                    CHECK_CUDA_ERROR();
-                }
-            ArrayHandle<Scalar> h_sum(m_sum3, access_location::host, access_mode::read);
-            Pr += h_sum.data[0];
-            wnorm += h_sum.data[1];
-            tnorm += h_sum.data[2];
-            }
-
-        }
-
-    #ifdef ENABLE_MPI
-    if (m_pdata->getDomainDecomposition())
-        {
-        MPI_Allreduce(MPI_IN_PLACE, &fnorm, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-        MPI_Allreduce(MPI_IN_PLACE, &vnorm, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-        MPI_Allreduce(MPI_IN_PLACE, &Pt, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-
-        if (aniso)
-            {
-            MPI_Allreduce(MPI_IN_PLACE, &tnorm, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-            MPI_Allreduce(MPI_IN_PLACE, &wnorm, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-            MPI_Allreduce(MPI_IN_PLACE, &Pr, 1, MPI_HOOMD_SCALAR, MPI_SUM, m_exec_conf->getMPICommunicator());
-            }
-        }
-    #endif
-
-    vnorm = sqrt(vnorm);
-    fnorm = sqrt(fnorm);
-    wnorm = sqrt(wnorm);
-    tnorm = sqrt(tnorm);
-
-    if (m_prof)
-        m_prof->pop(m_exec_conf);
-
     unsigned int ndof = m_sysdef->getNDimensions()*total_group_size;
     m_exec_conf->msg->notice(10) << "FIRE fnorm " << fnorm << " tnorm " << tnorm << " delta_E " << energy-m_old_energy << std::endl;
     m_exec_conf->msg->notice(10) << "FIRE vnorm " << vnorm << " tnorm " << wnorm << std::endl;
@@ -260,7 +161,9 @@ void FIREEnergyMinimizerGPU::update(unsigned int timestep)
         return;
         }
 
-    //update velocities
+    // update the velocities, or zero them if the power is negative
+    Scalar P = Pt + Pr;
+    bool zero = !(P > Scalar(0.0));
 
     if (m_prof)
         m_prof->push(m_exec_conf, "FIRE update velocities");
@@ -278,6 +181,9 @@ void FIREEnergyMinimizerGPU::update(unsigned int timestep)
     else
         factor_r = 1.0;
 
+    if (zero)
+        m_exec_conf->msg->notice(6) << "FIRE zero velocities" << std::endl;
+
     for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
         {
         std::shared_ptr<ParticleGroup> current_group = (*method)->getGroup();
@@ -293,7 +199,8 @@ void FIREEnergyMinimizerGPU::update(unsigned int timestep)
                           d_index_array.data,
                           group_size,
                           m_alpha,
-                          factor_t);
+                          factor_t,
+                          zero);
 
         if(m_exec_conf->isCUDAErrorCheckingEnabled())
             CHECK_CUDA_ERROR();
@@ -312,7 +219,8 @@ void FIREEnergyMinimizerGPU::update(unsigned int timestep)
                           d_index_array.data,
                           group_size,
                           m_alpha,
-                          factor_r);
+                          factor_r,
+                          zero);
 
             if(m_exec_conf->isCUDAErrorCheckingEnabled())
                 CHECK_CUDA_ERROR();
@@ -322,9 +230,7 @@ void FIREEnergyMinimizerGPU::update(unsigned int timestep)
     if (m_prof)
         m_prof->pop(m_exec_conf);
 
-    Scalar P = Pt + Pr;
-
-    if (P > Scalar(0.0))
+    if (!zero)
         {
         m_n_since_negative++;
         if (m_n_since_negative > m_nmin)
@@ -333,44 +239,11 @@ void FIREEnergyMinimizerGPU::update(unsigned int timestep)
             m_alpha *= m_falpha;
             }
         }
-    else if (P <= Scalar(0.0))
+    else
         {
         IntegratorTwoStep::setDeltaT(m_deltaT*m_fdec);
         m_alpha = m_alpha_start;
         m_n_since_negative = 0;
-        if (m_prof)
-            m_prof->push(m_exec_conf, "FIRE zero velocities");
-
-        m_exec_conf->msg->notice(6) << "FIRE zero velocities" << std::endl;
-
-        for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
-            {
-            std::shared_ptr<ParticleGroup> current_group = (*method)->getGroup();
-            unsigned int group_size = current_group->getIndexArray().getNumElements();
-            ArrayHandle< unsigned int > d_index_array(current_group->getIndexArray(), access_location::device, access_mode::read);
-
-            ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
-
-            gpu_fire_zero_v(d_vel.data,
-                            d_index_array.data,
-                            group_size);
-            if(m_exec_conf->isCUDAErrorCheckingEnabled())
-                CHECK_CUDA_ERROR();
-
-            if ((*method)->getAnisotropic())
-                {
-                ArrayHandle<Scalar4> d_angmom(m_pdata->getAngularMomentumArray(), access_location::device, access_mode::readwrite);
-                gpu_fire_zero_angmom(d_angmom.data,
-                                d_index_array.data,
-                                group_size);
-                if(m_exec_conf->isCUDAErrorCheckingEnabled())
-                    CHECK_CUDA_ERROR();
-
-                }
-            }
-
-        if (m_prof)
-            m_prof->pop(m_exec_conf);
         }
 
     m_n_since_start++;
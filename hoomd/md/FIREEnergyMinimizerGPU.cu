@@ -20,245 +20,42 @@
 //! Shared memory used in reducing sums
 extern __shared__ Scalar fire_sdata[];
 
-//! The kernel function to zeros velocities, called by gpu_fire_zero_v()
-/*! \param d_vel device array of particle velocities
-    \param d_group_members Device array listing the indices of the members of the group to zero
+//! Kernel function for reducing all sums of a FIRE iteration to per-block partial sums
+/*! \param d_group_members Device array listing the indices of the members of the group
     \param group_size Number of members in the group
+    \param d_net_force Net forces, the potential energy is in the w component
+    \param d_vel Particle velocities
+    \param d_accel Particle accelerations
+    \param d_orientation Particle orientations
+    \param d_inertia Particle moments of inertia
+    \param d_angmom Particle angular momenta
+    \param d_net_torque Net torques
+    \param aniso True if the angular terms are summed for this group
+    \param d_partial_sum Partial sums, FIRE_NUM_SUMS values per block
+    \param block_offset Index of the first partial sum written by this launch
+
+    Every thread evaluates all terms for one group member. The FIRE_NUM_SUMS sums are reduced together in shared memory
+    (FIRE_NUM_SUMS*blockDim.x Scalars), so the group is read once per iteration.
 */
-extern "C" __global__
-void gpu_fire_zero_v_kernel(Scalar4 *d_vel,
-                            unsigned int *d_group_members,
-                            unsigned int group_size)
-    {
-    // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
-    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
-
-    if (group_idx < group_size)
-        {
-        unsigned int idx = d_group_members[group_idx];
-
-        // read the particle's velocity (MEM TRANSFER: 32 bytes)
-        Scalar4 vel = d_vel[idx];
-
-        // zero the velocity(FLOPS: ?)
-        vel.x = Scalar(0.0);
-        vel.y = Scalar(0.0);
-        vel.z = Scalar(0.0);
-
-        // write out the results (MEM_TRANSFER: 32 bytes)
-        d_vel[idx] = vel;
-        }
-    }
-
-
-//! The kernel function to zero angular momenta, called by gpu_fire_zero_angmom()
-extern "C" __global__
-void gpu_fire_zero_angmom_kernel(Scalar4 *d_angmom,
-                            unsigned int *d_group_members,
-                            unsigned int group_size)
-    {
-    // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
-    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
-
-    if (group_idx < group_size)
-        {
-        unsigned int idx = d_group_members[group_idx];
-
-        // write out the results (MEM_TRANSFER: 32 bytes)
-        d_angmom[idx] = make_scalar4(0,0,0,0);
-        }
-    }
-
-
-/*! \param d_vel device array of particle velocities
-    \param d_group_members Device array listing the indices of the members of the group to integrate
-    \param group_size Number of members in the group
-
-This function is just the driver for gpu_fire_zero_v_kernel(), see that function
-for details.
-*/
-cudaError_t gpu_fire_zero_v(Scalar4 *d_vel,
-                            unsigned int *d_group_members,
-                            unsigned int group_size)
-    {
-    // setup the grid to run the kernel
-    int block_size = 256;
-    dim3 grid( (group_size/block_size) + 1, 1, 1);
-    dim3 threads(block_size, 1, 1);
-
-    // run the kernel
-    gpu_fire_zero_v_kernel<<< grid, threads >>>(d_vel,
-                                                d_group_members,
-                                                group_size);
-
-    return cudaSuccess;
-    }
-
-cudaError_t gpu_fire_zero_angmom(Scalar4 *d_angmom,
-                            unsigned int *d_group_members,
-                            unsigned int group_size)
-    {
-    // setup the grid to run the kernel
-    int block_size = 256;
-    dim3 grid( (group_size/block_size) + 1, 1, 1);
-    dim3 threads(block_size, 1, 1);
-
-    // run the kernel
-    gpu_fire_zero_angmom_kernel<<< grid, threads >>>(d_angmom,
-                                                d_group_members,
-                                                group_size);
-
-    return cudaSuccess;
-    }
-
-
-//! Kernel function for reducing the potential energy to a partial sum
-/*! \param d_group_members Device array listing the indices of the members of the group to sum
-    \param group_size Number of members in the group
-    \param d_net_force Pointer to the force array for all particles
-    \param d_partial_sum_pe Placeholder for the partial sum
-*/
-extern "C" __global__
-    void gpu_fire_reduce_pe_partial_kernel(unsigned int *d_group_members,
-                                           unsigned int group_size,
-                                           Scalar4* d_net_force,
-                                           Scalar* d_partial_sum_pe)
-    {
-    // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
-    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
-
-    Scalar pe = 0;
-
-    if (group_idx < group_size)
-        {
-        unsigned int idx = d_group_members[group_idx];
-        // read the particle's force and extract the pe from w component (MEM TRANSFER: 32 bytes)
-
-        Scalar4 force = d_net_force[idx];
-        pe = force.w;
-
-        // Uncoalesced Memory Read replace by Texture Read above.  Scalars4* d_net_force still being passed to support this
-        // defunct structure.
-        //pe = d_net_force[idx].w;
-        }
-
-        fire_sdata[threadIdx.x] = pe;
-        __syncthreads();
-
-    // reduce the sum in parallel
-    int offs = blockDim.x >> 1;
-    while (offs > 0)
-        {
-        if (threadIdx.x < offs)
-            fire_sdata[threadIdx.x] += fire_sdata[threadIdx.x + offs];
-        offs >>= 1;
-        __syncthreads();
-        }
-
-    // write out our partial sum
-    if (threadIdx.x == 0)
-        {
-        d_partial_sum_pe[blockIdx.x] = fire_sdata[0];
-        }
-
-    }
-
-//! Kernel function for reducing a partial sum to a full sum (one value)
-/*! \param d_sum Placeholder for the sum
-    \param d_partial_sum Array containing the partial sum
-    \param num_blocks Number of blocks to execute
-*/
-extern "C" __global__
-    void gpu_fire_reduce_partial_sum_kernel(Scalar *d_sum,
-                                            Scalar* d_partial_sum,
-                                            unsigned int num_blocks)
-    {
-    Scalar sum = Scalar(0.0);
-
-    // sum up the values in the partial sum via a sliding window
-    for (int start = 0; start < num_blocks; start += blockDim.x)
-        {
-        __syncthreads();
-        if (start + threadIdx.x < num_blocks)
-            fire_sdata[threadIdx.x] = d_partial_sum[start + threadIdx.x];
-        else
-            fire_sdata[threadIdx.x] = Scalar(0.0);
-        __syncthreads();
-
-        // reduce the sum in parallel
-        int offs = blockDim.x >> 1;
-        while (offs > 0)
-            {
-            if (threadIdx.x < offs)
-                fire_sdata[threadIdx.x] += fire_sdata[threadIdx.x + offs];
-            offs >>= 1;
-            __syncthreads();
-            }
-
-        // everybody sums up sum2K
-        sum += fire_sdata[0];
-        }
-
-    if (threadIdx.x == 0)
-        *d_sum = sum;
-    }
-
-/*!  \param d_group_members Device array listing the indices of the members of the group to integrate
-    \param group_size Number of members in the group
-    \param d_net_force Array containing the net forces
-    \param d_sum_pe Placeholder for the sum of the PE
-    \param d_partial_sum_pe Array containing the partial sum of the PE
-    \param block_size The size of one block
-    \param num_blocks Number of blocks to execute
-
-    This is a driver for gpu_fire_reduce_pe_partial_kernel() and
-    gpu_fire_reduce_partial_sum_kernel(), see them for details
-*/
-cudaError_t gpu_fire_compute_sum_pe(unsigned int *d_group_members,
-                                    unsigned int group_size,
-                                    Scalar4* d_net_force,
-                                    Scalar* d_sum_pe,
-                                    Scalar* d_partial_sum_pe,
-                                    unsigned int block_size,
-                                    unsigned int num_blocks)
-    {
-
-
-    // setup the grid to run the kernel
-    dim3 grid(num_blocks, 1, 1);
-    dim3 threads(block_size, 1, 1);
-
-    // run the kernel
-    gpu_fire_reduce_pe_partial_kernel<<< grid, threads, block_size*sizeof(Scalar) >>>(d_group_members,
-                                                                                     group_size,
-                                                                                     d_net_force,
-                                                                                     d_partial_sum_pe);
-
-    gpu_fire_reduce_partial_sum_kernel<<< grid, threads, block_size*sizeof(Scalar) >>>(d_sum_pe,
-                                                                                      d_partial_sum_pe,
-                                                                                      num_blocks);
-
-    return cudaSuccess;
-    }
-
-//! Kernel function to compute the partial sum over the P term in the FIRE algorithm
-/*! \param d_vel particle velocities and masses on the device
-    \param d_accel particle accelerations on the device
-    \param d_group_members Device array listing the indices of the members of the group to integrate
-    \param group_size Number of members in the group
-    \param d_partial_sum_P Array to hold the partial sum
-*/
-extern "C" __global__
-    void gpu_fire_reduce_P_partial_kernel(const Scalar4 *d_vel,
-                                          const Scalar3 *d_accel,
-                                          unsigned int *d_group_members,
-                                          unsigned int group_size,
-                                          Scalar* d_partial_sum_P)
+__global__ void gpu_fire_reduce_partial_kernel(const unsigned int *d_group_members,
+                                               unsigned int group_size,
+                                               const Scalar4 *d_net_force,
+                                               const Scalar4 *d_vel,
+                                               const Scalar3 *d_accel,
+                                               const Scalar4 *d_orientation,
+                                               const Scalar3 *d_inertia,
+                                               const Scalar4 *d_angmom,
+                                               const Scalar4 *d_net_torque,
+                                               bool aniso,
+                                               Scalar *d_partial_sum,
+                                               unsigned int block_offset)
     {
     // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
-    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+    unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
 
-    Scalar P = 0;
+    Scalar sum[FIRE_NUM_SUMS];
+    for (unsigned int k = 0; k < FIRE_NUM_SUMS; k++)
+        sum[k] = Scalar(0.0);
 
     if (group_idx < group_size)
         {
@@ -266,402 +63,167 @@ extern "C" __global__
 
         Scalar3 a = d_accel[idx];
         Scalar4 v = d_vel[idx];
-        P = a.x*v.x + a.y*v.y + a.z*v.z;
-        }
-
-    fire_sdata[threadIdx.x] = P;
-    __syncthreads();
-
-    // reduce the sum in parallel
-    int offs = blockDim.x >> 1;
-    while (offs > 0)
-        {
-        if (threadIdx.x < offs)
-            fire_sdata[threadIdx.x] += fire_sdata[threadIdx.x + offs];
-        offs >>= 1;
-        __syncthreads();
-        }
-
-    // write out our partial sum
-    if (threadIdx.x == 0)
-        d_partial_sum_P[blockIdx.x] = fire_sdata[0];
+        sum[FIRE_SUM_PE] = d_net_force[idx].w;
+        sum[FIRE_SUM_P] = a.x*v.x + a.y*v.y + a.z*v.z;
+        sum[FIRE_SUM_VSQ] = v.x*v.x + v.y*v.y + v.z*v.z;
+        sum[FIRE_SUM_ASQ] = a.x*a.x + a.y*a.y + a.z*a.z;
 
-    }
-
-// Angular terms
-__global__ void gpu_fire_reduce_Pr_partial_kernel(const Scalar4 *d_angmom,
-                                          const Scalar4 *d_orientation,
-                                          const Scalar3 *d_inertia,
-                                          const Scalar4 *d_net_torque,
-                                          unsigned int *d_group_members,
-                                          unsigned int group_size,
-                                          Scalar* d_partial_sum_Pr)
-    {
-    // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
-    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
-
-    Scalar Pr = 0;
-
-    if (group_idx < group_size)
-        {
-        unsigned int idx = d_group_members[group_idx];
-
-        vec3<Scalar> t(d_net_torque[idx]);
-        quat<Scalar> p(d_angmom[idx]);
-        quat<Scalar> q(d_orientation[idx]);
-        vec3<Scalar> I(d_inertia[idx]);
-
-        // rotate torque into principal frame
-        t = rotate(conj(q),t);
-
-        // check for zero moment of inertia
-        bool x_zero, y_zero, z_zero;
-        x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
-
-        // ignore torque component along an axis for which the moment of inertia zero
-        if (x_zero) t.x = 0;
-        if (y_zero) t.y = 0;
-        if (z_zero) t.z = 0;
-
-        // s is the pure imaginary quaternion with im. part equal to true angular velocity
-        vec3<Scalar> s = (Scalar(1./2.) * conj(q) * p).v;
-
-        // rotational power = torque * angvel
-        Pr = dot(t,s);
+        if (aniso)
+            {
+            vec3<Scalar> t(d_net_torque[idx]);
+            quat<Scalar> p(d_angmom[idx]);
+            quat<Scalar> q(d_orientation[idx]);
+            vec3<Scalar> I(d_inertia[idx]);
+
+            // rotate torque into principal frame
+            t = rotate(conj(q),t);
+
+            // ignore torque component along an axis for which the moment of inertia zero
+            if (I.x < EPSILON) t.x = 0;
+            if (I.y < EPSILON) t.y = 0;
+            if (I.z < EPSILON) t.z = 0;
+
+            // s is the pure imaginary quaternion with im. part equal to true angular velocity
+            vec3<Scalar> s = (Scalar(1./2.) * conj(q) * p).v;
+
+            // rotational power = torque * angvel
+            sum[FIRE_SUM_PR] = dot(t,s);
+            sum[FIRE_SUM_WSQ] = dot(s,s);
+            sum[FIRE_SUM_TSQ] = dot(t,t);
+            }
         }
 
-    fire_sdata[threadIdx.x] = Pr;
+    for (unsigned int k = 0; k < FIRE_NUM_SUMS; k++)
+        fire_sdata[k*blockDim.x + threadIdx.x] = sum[k];
     __syncthreads();
 
-    // reduce the sum in parallel
+    // reduce the sums in parallel
     int offs = blockDim.x >> 1;
     while (offs > 0)
         {
         if (threadIdx.x < offs)
-            fire_sdata[threadIdx.x] += fire_sdata[threadIdx.x + offs];
+            {
+            for (unsigned int k = 0; k < FIRE_NUM_SUMS; k++)
+                fire_sdata[k*blockDim.x + threadIdx.x] += fire_sdata[k*blockDim.x + threadIdx.x + offs];
+            }
         offs >>= 1;
         __syncthreads();
         }
 
-    // write out our partial sum
-    if (threadIdx.x == 0)
-        d_partial_sum_Pr[blockIdx.x] = fire_sdata[0];
-
+    // write out our partial sums
+    if (threadIdx.x < FIRE_NUM_SUMS)
+        d_partial_sum[(block_offset + blockIdx.x)*FIRE_NUM_SUMS + threadIdx.x] = fire_sdata[threadIdx.x*blockDim.x];
     }
 
-// Norm of angular velocity vector
-__global__ void gpu_fire_reduce_wnorm_partial_kernel(const Scalar4 *d_angmom,
-                                          const Scalar4 *d_orientation,
-                                          unsigned int *d_group_members,
-                                          unsigned int group_size,
-                                          Scalar* d_partial_sum_w)
-    {
-    // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
-    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
-
-    Scalar w = 0;
-
-    if (group_idx < group_size)
-        {
-        unsigned int idx = d_group_members[group_idx];
-
-        quat<Scalar> p(d_angmom[idx]);
-        quat<Scalar> q(d_orientation[idx]);
-        vec3<Scalar> s = (Scalar(1./2.) * conj(q) * p).v;
-
-        w = dot(s,s);
-        }
-
-    fire_sdata[threadIdx.x] = w;
-    __syncthreads();
+//! Kernel function for reducing the partial sums to the FIRE_NUM_SUMS total sums
+/*! \param d_sum Total sums (output)
+    \param d_partial_sum Partial sums, FIRE_NUM_SUMS values per block
+    \param num_blocks Number of partial sums
 
-    // reduce the sum in parallel
-    int offs = blockDim.x >> 1;
-    while (offs > 0)
-        {
-        if (threadIdx.x < offs)
-            fire_sdata[threadIdx.x] += fire_sdata[threadIdx.x + offs];
-        offs >>= 1;
-        __syncthreads();
-        }
-
-    // write out our partial sum
-    if (threadIdx.x == 0)
-        d_partial_sum_w[blockIdx.x] = fire_sdata[0];
-
-    }
-
-//! Kernel function to compute the partial sum over the vsq term in the FIRE algorithm
-/*! \param d_vel device array of particle velocities
-    \param d_group_members Array listing members of the group
-    \param group_size Number of members in the group
-    \param d_partial_sum_vsq Array to hold the partial sum
+    This kernel is executed on a single block.
 */
-extern "C" __global__
-    void gpu_fire_reduce_vsq_partial_kernel(const Scalar4 *d_vel,
-                                            unsigned int *d_group_members,
-                                            unsigned int group_size,
-                                            Scalar* d_partial_sum_vsq)
+__global__ void gpu_fire_reduce_final_kernel(Scalar *d_sum,
+                                             const Scalar *d_partial_sum,
+                                             unsigned int num_blocks)
     {
-    // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
-    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
-
-    Scalar vsq = 0;
-
-    if (group_idx < group_size)
-        {
-        unsigned int idx = d_group_members[group_idx];
+    Scalar sum[FIRE_NUM_SUMS];
+    for (unsigned int k = 0; k < FIRE_NUM_SUMS; k++)
+        sum[k] = Scalar(0.0);
 
-        Scalar4 v = d_vel[idx];
-        vsq = v.x*v.x + v.y*v.y + v.z*v.z;
-        }
+    for (unsigned int i = threadIdx.x; i < num_blocks; i += blockDim.x)
+        for (unsigned int k = 0; k < FIRE_NUM_SUMS; k++)
+            sum[k] += d_partial_sum[i*FIRE_NUM_SUMS + k];
 
-    fire_sdata[threadIdx.x] = vsq;
+    for (unsigned int k = 0; k < FIRE_NUM_SUMS; k++)
+        fire_sdata[k*blockDim.x + threadIdx.x] = sum[k];
     __syncthreads();
 
-    // reduce the sum in parallel
+    // reduce the sums in parallel
     int offs = blockDim.x >> 1;
     while (offs > 0)
         {
         if (threadIdx.x < offs)
-            fire_sdata[threadIdx.x] += fire_sdata[threadIdx.x + offs];
-        offs >>= 1;
-        __syncthreads();
-        }
-
-    // write out our partial sum
-    if (threadIdx.x == 0)
-        d_partial_sum_vsq[blockIdx.x] = fire_sdata[0];
-
-    }
-
-//! Kernel function to compute the partial sum over the asq term in the FIRE algorithm
-/*! \param d_accel device array of particle accelerations
-    \param d_group_members Array listing members of the group
-    \param group_size Number of members in the group
-    \param d_partial_sum_asq Array to hold the partial sum
-*/
-extern "C" __global__
-    void gpu_fire_reduce_asq_partial_kernel(const Scalar3 *d_accel,
-                                            unsigned int *d_group_members,
-                                            unsigned int group_size,
-                                            Scalar* d_partial_sum_asq)
-    {
-    // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
-    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
-
-    Scalar asq = 0;
-
-    if (group_idx < group_size)
-        {
-        unsigned int idx = d_group_members[group_idx];
-
-        Scalar3 a = d_accel[idx];
-        asq = a.x*a.x + a.y*a.y + a.z*a.z;
-        }
-
-    fire_sdata[threadIdx.x] = asq;
-    __syncthreads();
-
-    // reduce the sum in parallel
-    int offs = blockDim.x >> 1;
-    while (offs > 0)
-        {
-        if (threadIdx.x < offs)
-            fire_sdata[threadIdx.x] += fire_sdata[threadIdx.x + offs];
-        offs >>= 1;
-        __syncthreads();
-        }
-
-    // write out our partial sum
-    if (threadIdx.x == 0)
-        d_partial_sum_asq[blockIdx.x] = fire_sdata[0];
-
-    }
-
-__global__ void gpu_fire_reduce_tsq_partial_kernel(const Scalar4 *d_net_torque,
-                                            const Scalar4 *d_orientation,
-                                            const Scalar3 *d_inertia,
-                                            unsigned int *d_group_members,
-                                            unsigned int group_size,
-                                            Scalar* d_partial_sum_tsq)
-    {
-    // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
-    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
-
-    Scalar tsq = 0;
-
-    if (group_idx < group_size)
-        {
-        unsigned int idx = d_group_members[group_idx];
-
-        vec3<Scalar> t(d_net_torque[idx]);
-        quat<Scalar> q(d_orientation[idx]);
-        vec3<Scalar> I(d_inertia[idx]);
-
-        // rotate torque into principal frame
-        t = rotate(conj(q),t);
-
-        // check for zero moment of inertia
-        bool x_zero, y_zero, z_zero;
-        x_zero = (I.x < EPSILON); y_zero = (I.y < EPSILON); z_zero = (I.z < EPSILON);
-
-        // ignore torque component along an axis for which the moment of inertia zero
-        if (x_zero) t.x = 0;
-        if (y_zero) t.y = 0;
-        if (z_zero) t.z = 0;
-
-        tsq = dot(t,t);
-        }
-
-    fire_sdata[threadIdx.x] = tsq;
-    __syncthreads();
-
-    // reduce the sum in parallel
-    int offs = blockDim.x >> 1;
-    while (offs > 0)
-        {
-        if (threadIdx.x < offs)
-            fire_sdata[threadIdx.x] += fire_sdata[threadIdx.x + offs];
+            {
+            for (unsigned int k = 0; k < FIRE_NUM_SUMS; k++)
+                fire_sdata[k*blockDim.x + threadIdx.x] += fire_sdata[k*blockDim.x + threadIdx.x + offs];
+            }
         offs >>= 1;
         __syncthreads();
         }
 
-    // write out our partial sum
-    if (threadIdx.x == 0)
-        d_partial_sum_tsq[blockIdx.x] = fire_sdata[0];
-
+    if (threadIdx.x < FIRE_NUM_SUMS)
+        d_sum[threadIdx.x] = fire_sdata[threadIdx.x*blockDim.x];
     }
 
-
-
-/*! \param N number of particles in system
-    \param d_vel array of particle velocities
-    \param d_accel array of particle accelerations
-    \param d_group_members Device array listing the indices of the members of the group to integrate
+/*! \param d_group_members Device array listing the indices of the members of the group
     \param group_size Number of members in the group
-    \param d_sum_all Array to hold the sum over P, vsq, and asq
-    \param d_partial_sum_P Array to hold the partial sum over P (a*v)
-    \param d_partial_sum_vsq Array to hold the partial sum over vsq (v*v)
-    \param d_partial_sum_asq Array to hold the partial sum over asq (a*a)
-    \param block_size is the size of one block
-    \param num_blocks is the number of blocks to execute
-    \note Currently the sums are performed consecutively. The efficiency of this
-        function could be improved by computing all three sums simultaneously
-    This is a driver for gpu_fire_reduce_{X}_partial_kernel() (where X = P, vsq, asq)
-    and gpu_fire_reduce_partial_sum_kernel(), see them for details
+    \param d_net_force Net forces, the potential energy is in the w component
+    \param d_vel Particle velocities
+    \param d_accel Particle accelerations
+    \param d_orientation Particle orientations
+    \param d_inertia Particle moments of inertia
+    \param d_angmom Particle angular momenta
+    \param d_net_torque Net torques
+    \param aniso True if the angular terms are summed for this group
+    \param d_partial_sum Partial sums, FIRE_NUM_SUMS values per block
+    \param block_offset Index of the first partial sum written by this launch
+    \param block_size Block size, must be a power of two
+
+    This is a driver for gpu_fire_reduce_partial_kernel(), which writes group_size/block_size + 1 partial sums.
 */
-cudaError_t gpu_fire_compute_sum_all(
-                                    const unsigned int N,
-                                    const Scalar4 *d_vel,
-                                    const Scalar3 *d_accel,
-                                    unsigned int *d_group_members,
-                                    unsigned int group_size,
-                                    Scalar* d_sum_all,
-                                    Scalar* d_partial_sum_P,
-                                    Scalar* d_partial_sum_vsq,
-                                    Scalar* d_partial_sum_asq,
-                                    unsigned int block_size,
-                                    unsigned int num_blocks)
+cudaError_t gpu_fire_compute_partial_sums(const unsigned int *d_group_members,
+                                          unsigned int group_size,
+                                          const Scalar4 *d_net_force,
+                                          const Scalar4 *d_vel,
+                                          const Scalar3 *d_accel,
+                                          const Scalar4 *d_orientation,
+                                          const Scalar3 *d_inertia,
+                                          const Scalar4 *d_angmom,
+                                          const Scalar4 *d_net_torque,
+                                          bool aniso,
+                                          Scalar *d_partial_sum,
+                                          unsigned int block_offset,
+                                          unsigned int block_size)
     {
     // setup the grid to run the kernel
-    dim3 grid(num_blocks, 1, 1);
-    dim3 grid1(1, 1, 1);
+    dim3 grid(group_size/block_size + 1, 1, 1);
     dim3 threads(block_size, 1, 1);
-    dim3 threads1(256, 1, 1);
-
-    // run the kernels
-    gpu_fire_reduce_P_partial_kernel<<< grid, threads, block_size*sizeof(Scalar) >>>(  d_vel,
-
-      d_accel,
-                                                                                      d_group_members,
-                                                                                      group_size,
-                                                                                      d_partial_sum_P);
-
-    gpu_fire_reduce_partial_sum_kernel<<< grid1, threads1, block_size*sizeof(Scalar) >>>(&d_sum_all[0],
-                                                                                      d_partial_sum_P,
-                                                                                      num_blocks);
 
-    gpu_fire_reduce_vsq_partial_kernel<<< grid, threads, block_size*sizeof(Scalar) >>>(d_vel,
-                                                                                      d_group_members,
-                                                                                      group_size,
-                                                                                      d_partial_sum_vsq);
-
-    gpu_fire_reduce_partial_sum_kernel<<< grid1, threads1, block_size*sizeof(Scalar) >>>(&d_sum_all[1],
-                                                                                      d_partial_sum_vsq,
-                                                                                      num_blocks);
-
-    gpu_fire_reduce_asq_partial_kernel<<< grid, threads, block_size*sizeof(Scalar) >>>(d_accel,
-                                                                                      d_group_members,
-                                                                                      group_size,
-                                                                                      d_partial_sum_asq);
-
-    gpu_fire_reduce_partial_sum_kernel<<< grid1, threads1, block_size*sizeof(Scalar) >>>(&d_sum_all[2],
-                                                                                      d_partial_sum_asq,
-                                                                                      num_blocks);
+    gpu_fire_reduce_partial_kernel<<< grid, threads, FIRE_NUM_SUMS*block_size*sizeof(Scalar) >>>(d_group_members,
+                                                                                                group_size,
+                                                                                                d_net_force,
+                                                                                                d_vel,
+                                                                                                d_accel,
+                                                                                                d_orientation,
+                                                                                                d_inertia,
+                                                                                                d_angmom,
+                                                                                                d_net_torque,
+                                                                                                aniso,
+                                                                                                d_partial_sum,
+                                                                                                block_offset);
 
     return cudaSuccess;
     }
 
-cudaError_t gpu_fire_compute_sum_all_angular(const unsigned int N,
-                                    const Scalar4 *d_orientation,
-                                    const Scalar3 *d_inertia,
-                                    const Scalar4 *d_angmom,
-                                    const Scalar4 *d_net_torque,
-                                    unsigned int *d_group_members,
-                                    unsigned int group_size,
-                                    Scalar* d_sum_all,
-                                    Scalar* d_partial_sum_Pr,
-                                    Scalar* d_partial_sum_wnorm,
-                                    Scalar* d_partial_sum_tsq,
-                                    unsigned int block_size,
-                                    unsigned int num_blocks)
+/*! \param d_sum Total sums (output)
+    \param d_partial_sum Partial sums, FIRE_NUM_SUMS values per block
+    \param num_blocks Number of partial sums
+
+    This is a driver for gpu_fire_reduce_final_kernel(), see it for details.
+*/
+cudaError_t gpu_fire_reduce_sums(Scalar *d_sum,
+                                 const Scalar *d_partial_sum,
+                                 unsigned int num_blocks)
     {
-    // setup the grid to run the kernel
-    dim3 grid(num_blocks, 1, 1);
-    dim3 grid1(1, 1, 1);
-    dim3 threads(block_size, 1, 1);
-    dim3 threads1(256, 1, 1);
-
-    // run the kernels
-    gpu_fire_reduce_Pr_partial_kernel<<< grid, threads, block_size*sizeof(Scalar) >>>(  d_angmom,
-                                                                                        d_orientation,
-                                                                                        d_inertia,
-                                                                                        d_net_torque,
-                                                                                      d_group_members,
-                                                                                      group_size,
-                                                                                      d_partial_sum_Pr);
-
-    gpu_fire_reduce_partial_sum_kernel<<< grid1, threads1, block_size*sizeof(Scalar) >>>(&d_sum_all[0],
-                                                                                      d_partial_sum_Pr,
-                                                                                      num_blocks);
-
-    gpu_fire_reduce_wnorm_partial_kernel<<< grid, threads, block_size*sizeof(Scalar) >>>(d_angmom,
-                                                                                       d_orientation,
-                                                                                      d_group_members,
-                                                                                      group_size,
-                                                                                      d_partial_sum_wnorm);
-
-    gpu_fire_reduce_partial_sum_kernel<<< grid1, threads1, block_size*sizeof(Scalar) >>>(&d_sum_all[1],
-                                                                                      d_partial_sum_wnorm,
-                                                                                      num_blocks);
-
-    gpu_fire_reduce_tsq_partial_kernel<<< grid, threads, block_size*sizeof(Scalar) >>>(d_net_torque,
-                                                                                      d_orientation,
-                                                                                      d_inertia,
-                                                                                      d_group_members,
-                                                                                      group_size,
-                                                                                      d_partial_sum_tsq);
-
-    gpu_fire_reduce_partial_sum_kernel<<< grid1, threads1, block_size*sizeof(Scalar) >>>(&d_sum_all[2],
-                                                                                      d_partial_sum_tsq,
-                                                                                      num_blocks);
+    const unsigned int block_size = 256;
+
+    gpu_fire_reduce_final_kernel<<< 1, block_size, FIRE_NUM_SUMS*block_size*sizeof(Scalar) >>>(d_sum,
+                                                                                               d_partial_sum,
+                                                                                               num_blocks);
 
     return cudaSuccess;
     }
 
-
-
 //! Kernel function to update the velocities used by the FIRE algorithm
 /*! \param d_vel Array of velocities to update
     \param d_accel Array of accelerations
@@ -669,6 +231,7 @@ cudaError_t gpu_fire_compute_sum_all_angular(const unsigned int N,
     \param group_size Number of members in the grou
     \param alpha Alpha coupling parameter used by the FIRE algorithm
     \param factor_t Combined factor vnorm/fnorm*alpha, or 1 if fnorm==0
+    \param zero If true, set the velocities to zero instead (the power was negative)
 */
 extern "C" __global__
     void gpu_fire_update_v_kernel(Scalar4 *d_vel,
@@ -676,7 +239,8 @@ extern "C" __global__
                                   unsigned int *d_group_members,
                                   unsigned int group_size,
                                   Scalar alpha,
-                                  Scalar factor_t)
+                                  Scalar factor_t,
+                                  bool zero)
     {
     // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
     int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
@@ -688,9 +252,16 @@ extern "C" __global__
         Scalar4 v = d_vel[idx];
         Scalar3 a = d_accel[idx];
 
-        v.x = v.x*(Scalar(1.0)-alpha) + a.x*factor_t;
-        v.y = v.y*(Scalar(1.0)-alpha) + a.y*factor_t;
-        v.z = v.z*(Scalar(1.0)-alpha) + a.z*factor_t;
+        if (zero)
+            {
+            v.x = v.y = v.z = Scalar(0.0);
+            }
+        else
+            {
+            v.x = v.x*(Scalar(1.0)-alpha) + a.x*factor_t;
+            v.y = v.y*(Scalar(1.0)-alpha) + a.y*factor_t;
+            v.z = v.z*(Scalar(1.0)-alpha) + a.z*factor_t;
+            }
 
         // write out the results (MEM_TRANSFER: 32 bytes)
         d_vel[idx] = v;
@@ -703,8 +274,8 @@ extern "C" __global__
     \param d_group_members Device array listing the indices of the members of the group to integrate
     \param group_size Number of members in the group
     \param alpha Alpha coupling parameter used by the FIRE algorithm
-    \param vnorm Magnitude of the (3*N) dimensional velocity vector
-    \param invfnorm 1 over the magnitude of the (3*N) dimensional force vector
+    \param factor_t Combined factor vnorm/fnorm*alpha, or 1 if fnorm==0
+    \param zero If true, set the velocities to zero instead
 
     This function is a driver for gpu_fire_update_v_kernel(), see it for details.
 */
@@ -713,7 +284,8 @@ cudaError_t gpu_fire_update_v(Scalar4 *d_vel,
                               unsigned int *d_group_members,
                               unsigned int group_size,
                               Scalar alpha,
-                              Scalar factor_t)
+                              Scalar factor_t,
+                              bool zero)
     {
     // setup the grid to run the kernel
     int block_size = 256;
@@ -726,7 +298,8 @@ cudaError_t gpu_fire_update_v(Scalar4 *d_vel,
                                                   d_group_members,
                                                   group_size,
                                                   alpha,
-                                                  factor_t);
+                                                  factor_t,
+                                                  zero);
 
     return cudaSuccess;
     }
@@ -738,7 +311,8 @@ cudaError_t gpu_fire_update_v(Scalar4 *d_vel,
                                   unsigned int *d_group_members,
                                   unsigned int group_size,
                                   Scalar alpha,
-                                  Scalar factor_r)
+                                  Scalar factor_r,
+                                  bool zero)
     {
     // determine which particle this thread works on (MEM TRANSFER: 4 bytes)
     int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
@@ -746,6 +320,12 @@ cudaError_t gpu_fire_update_v(Scalar4 *d_vel,
     if (group_idx < group_size)
         {
         unsigned int idx = d_group_members[group_idx];
+        if (zero)
+            {
+            d_angmom[idx] = make_scalar4(0,0,0,0);
+            return;
+            }
+
         quat<Scalar> q(d_orientation[idx]);
         vec3<Scalar> t(d_net_torque[idx]);
         quat<Scalar> p(d_angmom[idx]);
@@ -776,7 +356,8 @@ cudaError_t gpu_fire_update_angmom(const Scalar4 *d_net_torque,
                               unsigned int *d_group_members,
                               unsigned int group_size,
                               Scalar alpha,
-                              Scalar factor_r)
+                              Scalar factor_r,
+                              bool zero)
     {
     // setup the grid to run the kernel
     int block_size = 256;
@@ -791,7 +372,8 @@ cudaError_t gpu_fire_update_angmom(const Scalar4 *d_net_torque,
                                                   d_group_members,
                                                   group_size,
                                                   alpha,
-                                                  factor_r);
+                                                  factor_r,
+                                                  zero);
 
     return cudaSuccess;
     }
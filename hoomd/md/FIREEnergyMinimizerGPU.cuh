@@ -14,50 +14,38 @@
     \brief Defines the interface to GPU kernel drivers used by FIREEnergyMinimizerGPU.
 */
 
-//! Kernel driver for zeroing velocities called by FIREEnergyMinimizerGPU
-cudaError_t gpu_fire_zero_v(Scalar4 *d_vel,
-                            unsigned int *d_group_members,
-                            unsigned int group_size);
-
-cudaError_t gpu_fire_zero_angmom(Scalar4 *d_angmom,
-                            unsigned int *d_group_members,
-                            unsigned int group_size);
-
-//! Kernel driver for summing the potential energy called by FIREEnergyMinimizerGPU
-cudaError_t gpu_fire_compute_sum_pe(unsigned int *d_group_members,
-                            unsigned int group_size,
-                            Scalar4* d_net_force,
-                            Scalar* d_sum_pe,
-                            Scalar* d_partial_sum_pe,
-                            unsigned int block_size,
-                            unsigned int num_blocks);
+//! Indices of the sums reduced in every FIRE iteration
+enum fire_sum_index
+    {
+    FIRE_SUM_PE = 0,    //!< Potential energy
+    FIRE_SUM_P,         //!< Translational power a.v
+    FIRE_SUM_VSQ,       //!< v.v
+    FIRE_SUM_ASQ,       //!< a.a
+    FIRE_SUM_PR,        //!< Rotational power t.omega
+    FIRE_SUM_WSQ,       //!< omega.omega
+    FIRE_SUM_TSQ,       //!< t.t
+    FIRE_NUM_SUMS
+    };
 
-//! Kernel driver for summing over P, vsq, and asq called by FIREEnergyMinimizerGPU
-cudaError_t gpu_fire_compute_sum_all(const unsigned int N,
-                            const Scalar4 *d_vel,
-                            const Scalar3 *d_accel,
-                            unsigned int *d_group_members,
-                            unsigned int group_size,
-                            Scalar* d_sum_all,
-                            Scalar* d_partial_sum_P,
-                            Scalar* d_partial_sum_vsq,
-                            Scalar* d_partial_sum_asq,
-                            unsigned int block_size,
-                            unsigned int num_blocks);
+//! Kernel driver for the partial sums of all FIRE reductions of one group called by FIREEnergyMinimizerGPU
+cudaError_t gpu_fire_compute_partial_sums(const unsigned int *d_group_members,
+                                          unsigned int group_size,
+                                          const Scalar4 *d_net_force,
+                                          const Scalar4 *d_vel,
+                                          const Scalar3 *d_accel,
+                                          const Scalar4 *d_orientation,
+                                          const Scalar3 *d_inertia,
+                                          const Scalar4 *d_angmom,
+                                          const Scalar4 *d_net_torque,
+                                          bool aniso,
+                                          Scalar *d_partial_sum,
+                                          unsigned int block_offset,
+                                          unsigned int block_size);
 
-cudaError_t gpu_fire_compute_sum_all_angular(const unsigned int N,
-                                    const Scalar4 *d_orientation,
-                                    const Scalar3 *d_inertia,
-                                    const Scalar4 *d_angmom,
-                                    const Scalar4 *d_net_torque,
-                                    unsigned int *d_group_members,
-                                    unsigned int group_size,
-                                    Scalar* d_sum_all,
-                                    Scalar* d_partial_sum_Pr,
-                                    Scalar* d_partial_sum_wnorm,
-                                    Scalar* d_partial_sum_tsq,
-                                    unsigned int block_size,
-                                    unsigned int num_blocks);
+//! Kernel driver for reducing the partial sums of all groups called by FIREEnergyMinimizerGPU
+cudaError_t gpu_fire_reduce_sums(Scalar *d_sum,
+                                 const Scalar *d_partial_sum,
+                                 unsigned int num_blocks);
 
 //! Kernel driver for updating the velocities called by FIREEnergyMinimizerGPU
 cudaError_t gpu_fire_update_v(Scalar4 *d_vel,
@@ -65,8 +53,10 @@ cudaError_t gpu_fire_update_v(Scalar4 *d_vel,
                             unsigned int *d_group_members,
                             unsigned int group_size,
                             Scalar alpha,
-                            Scalar factor_t);
+                            Scalar factor_t,
+                            bool zero);
 
+//! Kernel driver for updating the angular momenta called by FIREEnergyMinimizerGPU
 cudaError_t gpu_fire_update_angmom(const Scalar4 *d_net_torque,
                               const Scalar4 *d_orientation,
                               const Scalar3 *d_inertia,
@@ -74,6 +64,7 @@ cudaError_t gpu_fire_update_angmom(const Scalar4 *d_net_torque,
                               unsigned int *d_group_members,
                               unsigned int group_size,
                               Scalar alpha,
-                              Scalar factor_r);
+                              Scalar factor_r,
+                              bool zero);
 
 #endif //__FIRE_ENERGY_MINIMIZER_GPU_CUH__
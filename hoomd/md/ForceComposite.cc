@@ -44,7 +44,10 @@ ForceComposite::~ForceComposite()
     m_pdata->getCompositeParticlesSignal().disconnect<ForceComposite, &ForceComposite::getMaxBodyDiameter>(this);
     #ifdef ENABLE_MPI
     if (m_comm_ghost_layer_connected)
+        {
         m_comm->getExtraGhostLayerWidthRequestSignal().disconnect<ForceComposite, &ForceComposite::requestExtraGhostLayerWidth>(this);
+        m_comm->getBodyGhostPlanRequestSignal().disconnect<ForceComposite, &ForceComposite::setBodyGhostPlans>(this);
+        }
     #endif
     }
 
@@ -372,6 +375,95 @@ Scalar ForceComposite::requestExtraGhostLayerWidth(unsigned int type)
     return m_d_max[type];
     }
 
+#ifdef ENABLE_MPI
+/*! \param body_ghost_plan Ghost plans of the local particles (NO_BODY_GHOST_PLAN if not set)
+
+    The extra ghost layer width of requestExtraGhostLayerWidth() makes sure that every rank holding a member of a
+    body also receives all other members, but it has to assume the largest extent of the body in any direction. For
+    bodies whose central particle is local, the positions of all members follow from the position and orientation
+    of the central particle. The central particle and the local members of such a body are only sent in the
+    directions in which a member of the body lies within the regular ghost layer width of its type from the domain
+    boundary, or beyond it. The margin also accounts for the members that have not yet been moved to the current
+    orientation of the body. The particles of bodies with a non-local central particle keep the wide ghost layer.
+*/
+void ForceComposite::setBodyGhostPlans(GlobalVector<unsigned int>& body_ghost_plan)
+    {
+    lazyInitMem();
+
+    if (m_prof) m_prof->push("body ghost plans");
+
+    const BoxDim& box = m_pdata->getBox();
+    const Scalar3 npd = box.getNearestPlaneDistance();
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+    ArrayHandle<unsigned int> h_body_len(m_body_len, access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_body_pos(m_body_pos, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_body_type(m_body_types, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_r_ghost(m_comm->getGhostLayerWidth(), access_location::host, access_mode::read);
+
+    ArrayHandle<unsigned int> h_body_ghost_plan(body_ghost_plan, access_location::host, access_mode::readwrite);
+
+    unsigned int N = m_pdata->getN();
+
+    // plans of the central particles from the positions of their members
+    for (unsigned int idx = 0; idx < N; ++idx)
+        {
+        if (h_body.data[idx] != h_tag.data[idx])
+            continue;
+
+        unsigned int body_type = __scalar_as_int(h_postype.data[idx].w);
+        unsigned int body_len = h_body_len.data[body_type];
+        if (body_len == 0)
+            continue;
+
+        vec3<Scalar> pos(h_postype.data[idx]);
+        quat<Scalar> orientation(h_orientation.data[idx]);
+
+        unsigned int plan = 0;
+        for (unsigned int i = 0; i < body_len; ++i)
+            {
+            vec3<Scalar> r = pos + rotate(orientation, vec3<Scalar>(h_body_pos.data[m_body_idx(body_type, i)]));
+            Scalar3 f = box.makeFraction(vec_to_scalar3(r));
+            Scalar3 margin = h_r_ghost.data[h_body_type.data[m_body_idx(body_type, i)]] / npd;
+
+            if (f.x >= Scalar(1.0) - margin.x)
+                plan |= Communicator::send_east;
+            if (f.x < margin.x)
+                plan |= Communicator::send_west;
+            if (f.y >= Scalar(1.0) - margin.y)
+                plan |= Communicator::send_north;
+            if (f.y < margin.y)
+                plan |= Communicator::send_south;
+            if (f.z >= Scalar(1.0) - margin.z)
+                plan |= Communicator::send_up;
+            if (f.z < margin.z)
+                plan |= Communicator::send_down;
+            }
+
+        h_body_ghost_plan.data[idx] = plan;
+        }
+
+    // the constituent particles follow their central particle
+    for (unsigned int idx = 0; idx < N; ++idx)
+        {
+        unsigned int body = h_body.data[idx];
+        if (body == NO_BODY || body == h_tag.data[idx])
+            continue;
+
+        unsigned int central_idx = h_rtag.data[body];
+        if (central_idx < N)
+            h_body_ghost_plan.data[idx] = h_body_ghost_plan.data[central_idx];
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+#endif
+
 void ForceComposite::validateRigidBodies(bool create)
     {
     lazyInitMem();
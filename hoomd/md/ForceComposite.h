@@ -133,6 +133,11 @@ class PYBIND11_EXPORT ForceComposite : public MolecularForceCompute
         //! Return the requested minimum ghost layer width
         virtual Scalar requestExtraGhostLayerWidth(unsigned int type);
 
+        #ifdef ENABLE_MPI
+        //! Set the ghost plans of the particles of bodies with a local central particle
+        virtual void setBodyGhostPlans(GlobalVector<unsigned int>& body_ghost_plan);
+        #endif
+
         #ifdef ENABLE_MPI
         //! Set the communicator object
         virtual void setCommunicator(std::shared_ptr<Communicator> comm)
@@ -144,6 +149,7 @@ class PYBIND11_EXPORT ForceComposite : public MolecularForceCompute
                 {
                 // register this class with the communicator
                 m_comm->getExtraGhostLayerWidthRequestSignal().connect<ForceComposite, &ForceComposite::requestExtraGhostLayerWidth>(this);
+                m_comm->getBodyGhostPlanRequestSignal().connect<ForceComposite, &ForceComposite::setBodyGhostPlans>(this);
                 m_comm_ghost_layer_connected = true;
                 }
            }
@@ -49,6 +49,14 @@ ForceCompositeGPU::ForceCompositeGPU(std::shared_ptr<SystemDefinition> sysdef)
 
     m_tuner_update.reset(new Autotuner(valid_params_update, 5, 100000, "update_composite", this->m_exec_conf));
 
+    // power of two block sizes for the per-body update
+    std::vector<unsigned int> valid_params_update_bodies;
+    for (unsigned int block_size = 32; block_size <= (unsigned int) dev_prop.maxThreadsPerBlock; block_size *= 2)
+        valid_params_update_bodies.push_back(block_size);
+
+    m_tuner_update_bodies.reset(new Autotuner(valid_params_update_bodies, 5, 100000, "update_composite_bodies",
+        this->m_exec_conf));
+
     GlobalArray<uint2> flag(1, m_exec_conf);
     std::swap(m_flag, flag);
 
@@ -232,10 +240,15 @@ void ForceCompositeGPU::updateCompositeParticles(unsigned int timestep)
 
     // access molecule order
     const GlobalArray<unsigned int>& molecule_length = getMoleculeLengths();
+    const Index2D& molecule_indexer = getMoleculeIndexer();
+
+    // update large bodies with a warp or more of threads per body, and small bodies with one thread per particle
+    bool per_body = molecule_indexer.getW() >= (unsigned int) m_exec_conf->dev_prop.warpSize;
 
     ArrayHandle<unsigned int> d_molecule_order(getMoleculeOrder(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_molecule_len(molecule_length, access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_molecule_idx(getMoleculeIndex(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_molecule_list(getMoleculeList(), access_location::device, access_mode::read);
 
     // access the particle data arrays
     ArrayHandle<Scalar4> d_postype(m_pdata->getPositions(), access_location::device, access_mode::readwrite);
@@ -253,36 +266,76 @@ void ForceCompositeGPU::updateCompositeParticles(unsigned int timestep)
         {
         ArrayHandle<uint2> d_flag(m_flag, access_location::device, access_mode::overwrite);
 
-        m_exec_conf->beginMultiGPU();
-
-        m_tuner_update->begin();
-        unsigned int block_size = m_tuner_update->getParam();
-
-        gpu_update_composite(m_pdata->getN(),
-            m_pdata->getNGhosts(),
-            d_postype.data,
-            d_orientation.data,
-            m_body_idx,
-            d_lookup_center.data,
-            d_body_pos.data,
-            d_body_orientation.data,
-            d_body_len.data,
-            d_molecule_order.data,
-            d_molecule_len.data,
-            d_molecule_idx.data,
-            d_image.data,
-            m_pdata->getBox(),
-            m_pdata->getGlobalBox(),
-            block_size,
-            d_flag.data,
-            m_pdata->getGPUPartition());
-
-        if (m_exec_conf->isCUDAErrorCheckingEnabled())
-            CHECK_CUDA_ERROR();
+        // released before the error check below accesses them on the host
+        ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
 
-        m_tuner_update->end();
+        m_exec_conf->beginMultiGPU();
 
-        m_exec_conf->endMultiGPU();
+        if (per_body)
+            {
+            // distribute the local molecules over the GPUs
+            GPUPartition mol_partition(m_exec_conf->getGPUIds());
+            mol_partition.setN(molecule_indexer.getH());
+
+            m_tuner_update_bodies->begin();
+            gpu_update_composite_bodies(m_pdata->getN(),
+                d_postype.data,
+                d_orientation.data,
+                m_body_idx,
+                d_body_pos.data,
+                d_body_orientation.data,
+                d_body_len.data,
+                d_molecule_list.data,
+                d_molecule_len.data,
+                molecule_indexer,
+                d_body.data,
+                d_tag.data,
+                d_image.data,
+                m_pdata->getBox(),
+                m_pdata->getGlobalBox(),
+                m_tuner_update_bodies->getParam(),
+                d_flag.data,
+                mol_partition);
+
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+
+            m_tuner_update_bodies->end();
+
+            m_exec_conf->endMultiGPU();
+            }
+        else
+            {
+            m_tuner_update->begin();
+            unsigned int block_size = m_tuner_update->getParam();
+
+            gpu_update_composite(m_pdata->getN(),
+                m_pdata->getNGhosts(),
+                d_postype.data,
+                d_orientation.data,
+                m_body_idx,
+                d_lookup_center.data,
+                d_body_pos.data,
+                d_body_orientation.data,
+                d_body_len.data,
+                d_molecule_order.data,
+                d_molecule_len.data,
+                d_molecule_idx.data,
+                d_image.data,
+                m_pdata->getBox(),
+                m_pdata->getGlobalBox(),
+                block_size,
+                d_flag.data,
+                m_pdata->getGPUPartition());
+
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+
+            m_tuner_update->end();
+
+            m_exec_conf->endMultiGPU();
+            }
         }
 
     uint2 flag;
@@ -324,6 +377,51 @@ void ForceCompositeGPU::updateCompositeParticles(unsigned int timestep)
         m_prof->pop(m_exec_conf);
     }
 
+#ifdef ENABLE_MPI
+/*! \param body_ghost_plan Ghost plans of the local particles (NO_BODY_GHOST_PLAN if not set)
+
+    See ForceComposite::setBodyGhostPlans()
+*/
+void ForceCompositeGPU::setBodyGhostPlans(GlobalVector<unsigned int>& body_ghost_plan)
+    {
+    lazyInitMem();
+
+    if (m_prof) m_prof->push(m_exec_conf, "body ghost plans");
+
+    ArrayHandle<Scalar4> d_postype(m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::read);
+
+    ArrayHandle<unsigned int> d_body_len(m_body_len, access_location::device, access_mode::read);
+    ArrayHandle<Scalar3> d_body_pos(m_body_pos, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_body_type(m_body_types, access_location::device, access_mode::read);
+    ArrayHandle<Scalar> d_r_ghost(m_comm->getGhostLayerWidth(), access_location::device, access_mode::read);
+
+    ArrayHandle<unsigned int> d_body_ghost_plan(body_ghost_plan, access_location::device, access_mode::readwrite);
+
+    gpu_set_body_ghost_plans(m_pdata->getN(),
+        d_postype.data,
+        d_orientation.data,
+        d_body.data,
+        d_tag.data,
+        d_rtag.data,
+        m_body_idx,
+        d_body_len.data,
+        d_body_pos.data,
+        d_body_type.data,
+        d_r_ghost.data,
+        m_pdata->getBox(),
+        d_body_ghost_plan.data);
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+#endif
+
 void ForceCompositeGPU::findRigidCenters()
     {
     ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
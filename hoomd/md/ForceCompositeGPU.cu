@@ -7,6 +7,10 @@
 #include "hoomd/ParticleData.cuh"
 
 #include "ForceCompositeGPU.cuh"
+
+#ifdef ENABLE_MPI
+#include "hoomd/CommunicatorGPU.cuh"
+#endif
 #include <thrust/copy.h>
 #include <thrust/transform.h>
 #include <thrust/device_ptr.h>
@@ -420,6 +424,29 @@ __global__ void gpu_rigid_virial_sliding_kernel(Scalar* d_virial,
     }
 
 
+//! Choose the number of bodies handled by one block from the size of the largest body
+/*! The threads of a block are split into n_bodies_per_block windows, and every window loops over the members of one
+    body. A window smaller than the body has to slide over it several times, which leaves the other windows of the
+    block idle when the bodies are large. The number of bodies per block is therefore reduced until the window covers
+    the largest body or spans the whole block, i.e. large bodies are reduced by a warp or a block each.
+
+    \param max_len Maximum number of particles in a body (including the central particle)
+    \param block_size Block size (power of two)
+    \param n_bodies_per_block Tuned number of bodies per block (power of two)
+    \returns The number of bodies per block to launch with
+*/
+static unsigned int gpu_rigid_bodies_per_block(unsigned int max_len, unsigned int block_size,
+    unsigned int n_bodies_per_block)
+    {
+    unsigned int min_window = 1;
+    while (min_window < max_len) { min_window *= 2; }
+
+    while (n_bodies_per_block > 1 && (block_size / n_bodies_per_block < min_window || n_bodies_per_block > block_size))
+        n_bodies_per_block /= 2;
+
+    return n_bodies_per_block;
+    }
+
 /*!
 */
 cudaError_t gpu_rigid_force(Scalar4* d_force,
@@ -454,8 +481,6 @@ cudaError_t gpu_rigid_force(Scalar4* d_force,
 
         unsigned int nwork = range.second - range.first;
 
-        dim3 force_grid(nwork / n_bodies_per_block + 1, 1, 1);
-
         static unsigned int max_block_size = UINT_MAX;
         static cudaFuncAttributes attr;
         if (max_block_size == UINT_MAX)
@@ -471,9 +496,6 @@ cudaError_t gpu_rigid_force(Scalar4* d_force,
         while (b * 2 <= run_block_size) { b *= 2; }
         run_block_size = b;
 
-        unsigned int window_size = run_block_size / n_bodies_per_block;
-        unsigned int thread_mask = window_size - 1;
-
         unsigned int shared_bytes = run_block_size * (sizeof(Scalar4) + sizeof(Scalar3));
 
         while (shared_bytes + attr.sharedSizeBytes >= dev_prop.sharedMemPerBlock)
@@ -482,11 +504,15 @@ cudaError_t gpu_rigid_force(Scalar4* d_force,
             run_block_size /= 2;
 
             shared_bytes = run_block_size * (sizeof(Scalar4) + sizeof(Scalar3));
-
-            window_size = run_block_size / n_bodies_per_block;
-            thread_mask = window_size - 1;
             }
 
+        unsigned int run_bodies_per_block = gpu_rigid_bodies_per_block(molecule_indexer.getW(), run_block_size,
+            n_bodies_per_block);
+        unsigned int window_size = run_block_size / run_bodies_per_block;
+        unsigned int thread_mask = window_size - 1;
+
+        dim3 force_grid(nwork / run_bodies_per_block + 1, 1, 1);
+
         gpu_rigid_force_sliding_kernel<<< force_grid, run_block_size, shared_bytes >>>(
             d_force,
             d_torque,
@@ -510,7 +536,7 @@ cudaError_t gpu_rigid_force(Scalar4* d_force,
             N,
             window_size,
             thread_mask,
-            n_bodies_per_block,
+            run_bodies_per_block,
             zero_force,
             range.first,
             nwork);
@@ -542,8 +568,6 @@ cudaError_t gpu_rigid_virial(Scalar* d_virial,
     // reset virial
     cudaMemset(d_virial,0, sizeof(Scalar)*virial_pitch*6);
 
-    dim3 force_grid(n_mol / n_bodies_per_block + 1, 1, 1);
-
     static unsigned int max_block_size = UINT_MAX;
     static cudaFuncAttributes attr;
     if (max_block_size == UINT_MAX)
@@ -559,9 +583,6 @@ cudaError_t gpu_rigid_virial(Scalar* d_virial,
     while (b * 2 <= run_block_size) { b *= 2; }
     run_block_size = b;
 
-    unsigned int window_size = run_block_size / n_bodies_per_block;
-    unsigned int thread_mask = window_size - 1;
-
     unsigned int shared_bytes = 6 * run_block_size * sizeof(Scalar);
 
     while (shared_bytes + attr.sharedSizeBytes >= dev_prop.sharedMemPerBlock)
@@ -570,11 +591,15 @@ cudaError_t gpu_rigid_virial(Scalar* d_virial,
         run_block_size /= 2;
 
         shared_bytes = 6 * run_block_size * sizeof(Scalar);
-
-        window_size = run_block_size / n_bodies_per_block;
-        thread_mask = window_size - 1;
         }
 
+    unsigned int run_bodies_per_block = gpu_rigid_bodies_per_block(molecule_indexer.getW(), run_block_size,
+        n_bodies_per_block);
+    unsigned int window_size = run_block_size / run_bodies_per_block;
+    unsigned int thread_mask = window_size - 1;
+
+    dim3 force_grid(n_mol / run_bodies_per_block + 1, 1, 1);
+
     gpu_rigid_virial_sliding_kernel<<< force_grid, run_block_size, shared_bytes >>>(
         d_virial,
         d_molecule_len,
@@ -595,7 +620,7 @@ cudaError_t gpu_rigid_virial(Scalar* d_virial,
         virial_pitch,
         window_size,
         thread_mask,
-        n_bodies_per_block);
+        run_bodies_per_block);
 
     return cudaSuccess;
     }
@@ -761,6 +786,344 @@ void gpu_update_composite(unsigned int N,
         }
     }
 
+//! Updates the constituent particles with one window of threads per body
+/*! The members of a body are stored contiguously in the molecule list, so every window reads the state of the central
+    particle once into shared memory and then updates window_size members at a time with coalesced accesses. This
+    kernel is used instead of gpu_update_composite_kernel for large bodies, where the one-thread-per-particle kernel
+    repeatedly reads the same central particle and its lookup tables for every member.
+
+    All local molecules are processed, including those with a ghost central particle. n_bodies_per_block and
+    window_size are powers of two, and at most 32 bodies are handled by one block.
+*/
+__global__ void gpu_update_composite_bodies_kernel(unsigned int N,
+    unsigned int nwork,
+    unsigned int first_mol,
+    Scalar4 *d_postype,
+    Scalar4 *d_orientation,
+    Index2D body_indexer,
+    const Scalar3 *d_body_pos,
+    const Scalar4 *d_body_orientation,
+    const unsigned int *d_body_len,
+    const unsigned int *d_molecule_list,
+    const unsigned int *d_molecule_len,
+    Index2D molecule_indexer,
+    const unsigned int *d_body,
+    const unsigned int *d_tag,
+    int3 *d_image,
+    const BoxDim box,
+    const BoxDim global_box,
+    unsigned int window_size,
+    unsigned int thread_mask,
+    unsigned int n_bodies_per_block,
+    uint2 *d_flag)
+    {
+    // the body this thread is working on
+    unsigned int m = threadIdx.x / window_size;
+
+    __shared__ Scalar4 central_postype[32];
+    __shared__ Scalar4 central_orientation[32];
+    __shared__ int3 central_image[32];
+    __shared__ unsigned int mol_idx[32];
+    __shared__ unsigned int body_status[32];
+
+    // body_status values
+    const unsigned int complete = 0;
+    const unsigned int missing_center = 1;
+    const unsigned int incomplete = 2;
+
+    if ((threadIdx.x & thread_mask) == 0)
+        {
+        unsigned int group_idx = blockIdx.x*n_bodies_per_block + m;
+        if (group_idx < nwork)
+            {
+            unsigned int imol = group_idx + first_mol;
+            mol_idx[m] = imol;
+
+            // the molecule is sorted by tag, the first ptl is the central ptl if present
+            unsigned int central_idx = d_molecule_list[molecule_indexer(0, imol)];
+            if (d_tag[central_idx] != d_body[central_idx])
+                {
+                body_status[m] = missing_center;
+                }
+            else
+                {
+                Scalar4 postype = d_postype[central_idx];
+                central_postype[m] = postype;
+                central_orientation[m] = d_orientation[central_idx];
+                central_image[m] = d_image[central_idx];
+
+                unsigned int body_type = __scalar_as_int(postype.w);
+                body_status[m] = (d_body_len[body_type] != d_molecule_len[imol] - 1) ? incomplete : complete;
+                }
+            }
+        else
+            {
+            mol_idx[m] = NO_BODY;
+            }
+        }
+
+    __syncthreads();
+
+    if (mol_idx[m] == NO_BODY)
+        return;
+
+    unsigned int mol_len = d_molecule_len[mol_idx[m]];
+    unsigned int status = body_status[m];
+
+    for (unsigned int k = threadIdx.x & thread_mask; k < mol_len; k += window_size)
+        {
+        unsigned int idx = d_molecule_list[molecule_indexer(k, mol_idx[m])];
+
+        if (status == missing_center)
+            {
+            // if a molecule with a local member has no central particle, error out, otherwise ignore
+            if (idx < N)
+                atomicMax(&(d_flag->x), idx+1);
+            continue;
+            }
+
+        // do not overwrite central ptl
+        if (k == 0)
+            continue;
+
+        if (status == incomplete)
+            {
+            // if a molecule with a local member is incomplete, this is an error
+            if (idx < N)
+                atomicMax(&(d_flag->y), idx+1);
+            continue;
+            }
+
+        vec3<Scalar> pos(central_postype[m]);
+        quat<Scalar> orientation(central_orientation[m]);
+        unsigned int body_type = __scalar_as_int(central_postype[m].w);
+
+        vec3<Scalar> local_pos(d_body_pos[body_indexer(body_type, k-1)]);
+        vec3<Scalar> dr_space = rotate(orientation, local_pos);
+
+        vec3<Scalar> updated_pos(pos);
+        updated_pos += dr_space;
+
+        quat<Scalar> local_orientation(d_body_orientation[body_indexer(body_type, k-1)]);
+        quat<Scalar> updated_orientation = orientation*local_orientation;
+
+        // wrap into box, allowing rigid bodies to span multiple images
+        int3 imgi = box.getImage(vec_to_scalar3(updated_pos));
+        int3 negimgi = make_int3(-imgi.x,-imgi.y,-imgi.z);
+        updated_pos = global_box.shift(updated_pos, negimgi);
+
+        unsigned int type = __scalar_as_int(d_postype[idx].w);
+
+        d_postype[idx] = make_scalar4(updated_pos.x, updated_pos.y, updated_pos.z, __int_as_scalar(type));
+        d_orientation[idx] = quat_to_scalar4(updated_orientation);
+        d_image[idx] = central_image[m]+imgi;
+        }
+    }
+
+/*! \param N Number of local particles
+    \param block_size Block size (rounded down to a power of two)
+    \param gpu_partition Partition of the local molecules (including those with ghost central particles) over the GPUs
+
+    The window of threads per body is the smallest power of two that covers the largest body, limited by the block
+    size: a warp per body for bodies of up to 32 particles, and up to a whole block per body for large bodies.
+*/
+void gpu_update_composite_bodies(unsigned int N,
+    Scalar4 *d_postype,
+    Scalar4 *d_orientation,
+    Index2D body_indexer,
+    const Scalar3 *d_body_pos,
+    const Scalar4 *d_body_orientation,
+    const unsigned int *d_body_len,
+    const unsigned int *d_molecule_list,
+    const unsigned int *d_molecule_len,
+    Index2D molecule_indexer,
+    const unsigned int *d_body,
+    const unsigned int *d_tag,
+    int3 *d_image,
+    const BoxDim box,
+    const BoxDim global_box,
+    unsigned int block_size,
+    uint2 *d_flag,
+    const GPUPartition &gpu_partition)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    static cudaFuncAttributes attr;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncGetAttributes(&attr, (const void *) gpu_update_composite_bodies_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = max_block_size < block_size ? max_block_size : block_size;
+
+    // round down to nearest power of two
+    unsigned int b = 1;
+    while (b * 2 <= run_block_size) { b *= 2; }
+    run_block_size = b;
+
+    // use a warp or more per body
+    unsigned int window_size = 32;
+    while (window_size < molecule_indexer.getW() && window_size < run_block_size) { window_size *= 2; }
+    if (window_size > run_block_size)
+        window_size = run_block_size;
+
+    unsigned int n_bodies_per_block = run_block_size / window_size;
+    unsigned int thread_mask = window_size - 1;
+
+    for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        auto range = gpu_partition.getRangeAndSetGPU(idev);
+
+        unsigned int nwork = range.second - range.first;
+
+        unsigned int n_blocks = nwork/n_bodies_per_block + 1;
+        gpu_update_composite_bodies_kernel<<<n_blocks, run_block_size>>>(N,
+            nwork,
+            range.first,
+            d_postype,
+            d_orientation,
+            body_indexer,
+            d_body_pos,
+            d_body_orientation,
+            d_body_len,
+            d_molecule_list,
+            d_molecule_len,
+            molecule_indexer,
+            d_body,
+            d_tag,
+            d_image,
+            box,
+            global_box,
+            window_size,
+            thread_mask,
+            n_bodies_per_block,
+            d_flag);
+        }
+    }
+
+#ifdef ENABLE_MPI
+//! Sets the ghost plans of the central particles from the positions of their members
+/*! See ForceComposite::setBodyGhostPlans()
+*/
+__global__ void gpu_center_ghost_plans_kernel(unsigned int N,
+    const Scalar4 *d_postype,
+    const Scalar4 *d_orientation,
+    const unsigned int *d_body,
+    const unsigned int *d_tag,
+    Index2D body_indexer,
+    const unsigned int *d_body_len,
+    const Scalar3 *d_body_pos,
+    const unsigned int *d_body_type,
+    const Scalar *d_r_ghost,
+    const BoxDim box,
+    unsigned int *d_body_ghost_plan)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (idx >= N || d_body[idx] != d_tag[idx])
+        return;
+
+    Scalar4 postype = d_postype[idx];
+    unsigned int body_type = __scalar_as_int(postype.w);
+    unsigned int body_len = d_body_len[body_type];
+    if (body_len == 0)
+        return;
+
+    vec3<Scalar> pos(postype);
+    quat<Scalar> orientation(d_orientation[idx]);
+    Scalar3 npd = box.getNearestPlaneDistance();
+
+    unsigned int plan = 0;
+    for (unsigned int i = 0; i < body_len; ++i)
+        {
+        vec3<Scalar> r = pos + rotate(orientation, vec3<Scalar>(d_body_pos[body_indexer(body_type, i)]));
+        Scalar3 f = box.makeFraction(vec_to_scalar3(r));
+        Scalar3 margin = d_r_ghost[d_body_type[body_indexer(body_type, i)]] / npd;
+
+        if (f.x >= Scalar(1.0) - margin.x)
+            plan |= send_east;
+        if (f.x < margin.x)
+            plan |= send_west;
+        if (f.y >= Scalar(1.0) - margin.y)
+            plan |= send_north;
+        if (f.y < margin.y)
+            plan |= send_south;
+        if (f.z >= Scalar(1.0) - margin.z)
+            plan |= send_up;
+        if (f.z < margin.z)
+            plan |= send_down;
+        }
+
+    d_body_ghost_plan[idx] = plan;
+    }
+
+//! Copies the ghost plans of local central particles to their constituent particles
+__global__ void gpu_constituent_ghost_plans_kernel(unsigned int N,
+    const unsigned int *d_body,
+    const unsigned int *d_tag,
+    const unsigned int *d_rtag,
+    unsigned int *d_body_ghost_plan)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (idx >= N)
+        return;
+
+    unsigned int body = d_body[idx];
+    if (body == NO_BODY || body == d_tag[idx])
+        return;
+
+    // only the plans of central particles are read, and only those of constituent particles are written
+    unsigned int central_idx = d_rtag[body];
+    if (central_idx < N)
+        d_body_ghost_plan[idx] = d_body_ghost_plan[central_idx];
+    }
+
+/*! \param N Number of local particles
+    \param d_body_ghost_plan Ghost plans of the local particles, initialized to NO_BODY_GHOST_PLAN
+
+    The plans of the central particles are computed first, and then copied to the constituent particles.
+*/
+cudaError_t gpu_set_body_ghost_plans(unsigned int N,
+                                     const Scalar4 *d_postype,
+                                     const Scalar4 *d_orientation,
+                                     const unsigned int *d_body,
+                                     const unsigned int *d_tag,
+                                     const unsigned int *d_rtag,
+                                     Index2D body_indexer,
+                                     const unsigned int *d_body_len,
+                                     const Scalar3 *d_body_pos,
+                                     const unsigned int *d_body_type,
+                                     const Scalar *d_r_ghost,
+                                     const BoxDim box,
+                                     unsigned int *d_body_ghost_plan)
+    {
+    unsigned int block_size = 256;
+    unsigned int n_blocks = N/block_size + 1;
+
+    gpu_center_ghost_plans_kernel<<<n_blocks, block_size>>>(N,
+        d_postype,
+        d_orientation,
+        d_body,
+        d_tag,
+        body_indexer,
+        d_body_len,
+        d_body_pos,
+        d_body_type,
+        d_r_ghost,
+        box,
+        d_body_ghost_plan);
+
+    gpu_constituent_ghost_plans_kernel<<<n_blocks, block_size>>>(N,
+        d_body,
+        d_tag,
+        d_rtag,
+        d_body_ghost_plan);
+
+    return cudaSuccess;
+    }
+#endif
+
 struct is_center
     {
     __host__ __device__
@@ -78,6 +78,26 @@ void gpu_update_composite(unsigned int N,
     uint2 *d_flag,
     const GPUPartition &gpu_partition);
 
+//! Update the constituent particles with a warp or a block of threads per body
+void gpu_update_composite_bodies(unsigned int N,
+    Scalar4 *d_postype,
+    Scalar4 *d_orientation,
+    Index2D body_indexer,
+    const Scalar3 *d_body_pos,
+    const Scalar4 *d_body_orientation,
+    const unsigned int *d_body_len,
+    const unsigned int *d_molecule_list,
+    const unsigned int *d_molecule_len,
+    Index2D molecule_indexer,
+    const unsigned int *d_body,
+    const unsigned int *d_tag,
+    int3 *d_image,
+    const BoxDim box,
+    const BoxDim global_box,
+    unsigned int block_size,
+    uint2 *d_flag,
+    const GPUPartition &gpu_partition);
+
 
 cudaError_t gpu_find_rigid_centers(const unsigned int *d_body,
                                 const unsigned int *d_tag,
@@ -87,3 +107,20 @@ cudaError_t gpu_find_rigid_centers(const unsigned int *d_body,
                                 unsigned int *d_rigid_center,
                                 unsigned int *d_lookup_center,
                                 unsigned int &n_rigid);
+
+#ifdef ENABLE_MPI
+//! Set the ghost plans of the particles of bodies with a local central particle
+cudaError_t gpu_set_body_ghost_plans(unsigned int N,
+                                     const Scalar4 *d_postype,
+                                     const Scalar4 *d_orientation,
+                                     const unsigned int *d_body,
+                                     const unsigned int *d_tag,
+                                     const unsigned int *d_rtag,
+                                     Index2D body_indexer,
+                                     const unsigned int *d_body_len,
+                                     const Scalar3 *d_body_pos,
+                                     const unsigned int *d_body_type,
+                                     const Scalar *d_r_ghost,
+                                     const BoxDim box,
+                                     unsigned int *d_body_ghost_plan);
+#endif
@@ -55,6 +55,9 @@ class PYBIND11_EXPORT ForceCompositeGPU : public ForceComposite
 
             m_tuner_update->setPeriod(period);
             m_tuner_update->setEnabled(enable);
+
+            m_tuner_update_bodies->setPeriod(period);
+            m_tuner_update_bodies->setEnabled(enable);
             }
 
 
@@ -62,6 +65,11 @@ class PYBIND11_EXPORT ForceCompositeGPU : public ForceComposite
         //! Compute the forces and torques on the central particle
         virtual void computeForces(unsigned int timestep);
 
+        #ifdef ENABLE_MPI
+        //! Set the ghost plans of the particles of bodies with a local central particle on the GPU
+        virtual void setBodyGhostPlans(GlobalVector<unsigned int>& body_ghost_plan);
+        #endif
+
         //! Helper kernel to sort rigid bodies by their center particles
         virtual void findRigidCenters();
 
@@ -83,6 +91,7 @@ class PYBIND11_EXPORT ForceCompositeGPU : public ForceComposite
         std::unique_ptr<Autotuner> m_tuner_force;  //!< Autotuner for block size and threads per particle
         std::unique_ptr<Autotuner> m_tuner_virial; //!< Autotuner for block size and threads per particle
         std::unique_ptr<Autotuner> m_tuner_update; //!< Autotuner for block size of update kernel
+        std::unique_ptr<Autotuner> m_tuner_update_bodies; //!< Autotuner for block size of per-body update kernel
 
         GlobalArray<uint2> m_flag;                 //!< Flag to read out error condition
 
@@ -20,8 +20,9 @@ ForceDistanceConstraint::ForceDistanceConstraint(std::shared_ptr<SystemDefinitio
         : MolecularForceCompute(sysdef), m_cdata(m_sysdef->getConstraintData()),
           m_cmatrix(m_exec_conf), m_cvec(m_exec_conf), m_lagrange(m_exec_conf),
           m_rel_tol(1e-3), m_constraint_violated(m_exec_conf), m_condition(m_exec_conf),
-          m_sparse_idxlookup(m_exec_conf), m_constraint_reorder(true), m_constraints_added_removed(true),
-          m_d_max(0.0)
+          m_sparse_idxlookup(m_exec_conf), m_iterative(false), m_n_iter(20), m_iter_q(m_exec_conf),
+          m_iter_r(m_exec_conf), m_iter_diag(m_exec_conf), m_iter_lambda_r(m_exec_conf), m_lagrange_tag(m_exec_conf),
+          m_constraint_reorder(true), m_constraints_added_removed(true), m_d_max(0.0)
     {
     m_constraint_violated.resetFlags(0);
 
@@ -47,6 +48,21 @@ ForceDistanceConstraint::~ForceDistanceConstraint()
     #endif
     }
 
+/*! \param iterative True if the constraint equation is solved with Jacobi iterations instead of the LU decomposition
+    \param n_iter Number of iterations per step
+*/
+void ForceDistanceConstraint::setIterative(bool iterative, unsigned int n_iter)
+    {
+    if (n_iter == 0)
+        {
+        m_exec_conf->msg->error() << "constrain.distance(): The number of iterations must be positive" << std::endl;
+        throw std::runtime_error("Error setting constraint solver parameters");
+        }
+
+    m_iterative = iterative;
+    m_n_iter = n_iter;
+    }
+
 /*! Does nothing in the base class
     \param timestep Current timestep
 */
@@ -63,17 +79,32 @@ void ForceDistanceConstraint::computeForces(unsigned int timestep)
 
     // reallocate through amortized resizin
     unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
-    m_cmatrix.resize(n_constraint*n_constraint);
     m_cvec.resize(n_constraint);
 
-    // populate the terms in the matrix vector equation
-    fillMatrixVector(timestep);
+    if (m_iterative)
+        {
+        // the constraint matrix is never formed
+        fillVectorIterative(timestep);
+
+        // check violations
+        checkConstraints(timestep);
+
+        // iterate on the lagrange multipliers
+        solveConstraintsIterative(timestep);
+        }
+    else
+        {
+        m_cmatrix.resize(n_constraint*n_constraint);
+
+        // populate the terms in the matrix vector equation
+        fillMatrixVector(timestep);
 
-    // check violations
-    checkConstraints(timestep);
+        // check violations
+        checkConstraints(timestep);
 
-    // solve the matrix vector equation
-    solveConstraints(timestep);
+        // solve the matrix vector equation
+        solveConstraints(timestep);
+        }
 
     // compute forces
     computeConstraintForces(timestep);
@@ -236,6 +267,82 @@ void ForceDistanceConstraint::fillMatrixVector(unsigned int timestep)
         }
     }
 
+void ForceDistanceConstraint::fillVectorIterative(unsigned int timestep)
+    {
+    unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
+
+    m_iter_q.resize(n_constraint);
+    m_iter_r.resize(n_constraint);
+    m_iter_diag.resize(n_constraint);
+
+    // access particle data
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_netforce(m_pdata->getNetForce(), access_location::host, access_mode::read);
+
+    // access per-constraint quantities
+    ArrayHandle<double> h_cvec(m_cvec, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_iter_q(m_iter_q, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_iter_r(m_iter_r, access_location::host, access_mode::overwrite);
+    ArrayHandle<double> h_iter_diag(m_iter_diag, access_location::host, access_mode::overwrite);
+
+    const BoxDim& box = m_pdata->getBox();
+
+    unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        const ConstraintData::members_t constraint = m_cdata->getMembersByIndex(n);
+        assert(constraint.tag[0] <= m_pdata->getMaximumTag());
+        assert(constraint.tag[1] <= m_pdata->getMaximumTag());
+
+        unsigned int idx_a = h_rtag.data[constraint.tag[0]];
+        unsigned int idx_b = h_rtag.data[constraint.tag[1]];
+
+        if (idx_a >= max_local || idx_b >= max_local)
+            {
+            this->m_exec_conf->msg->error() << "constrain.distance(): constraint " <<
+                constraint.tag[0] << " " << constraint.tag[1] << " incomplete." << std::endl << std::endl;
+            throw std::runtime_error("Error in constraint calculation");
+            }
+
+        vec3<Scalar> ra(h_pos.data[idx_a]);
+        vec3<Scalar> rb(h_pos.data[idx_b]);
+        vec3<Scalar> rn(ra-rb);
+
+        // apply minimum image
+        rn = box.minImage(rn);
+
+        vec3<Scalar> va(h_vel.data[idx_a]);
+        Scalar ma(h_vel.data[idx_a].w);
+        vec3<Scalar> vb(h_vel.data[idx_b]);
+        Scalar mb(h_vel.data[idx_b].w);
+
+        vec3<Scalar> rndot(va-vb);
+        vec3<Scalar> qn(rn+rndot*m_deltaT);
+
+        // get constraint distance
+        Scalar d = m_cdata->getValueByIndex(n);
+
+        // check distance violation
+        if (fast::sqrt(dot(rn,rn))-d >= m_rel_tol*d || std::isnan(dot(rn,rn)))
+            {
+            m_constraint_violated.resetFlags(n+1);
+            }
+
+        h_iter_q.data[n] = make_scalar4(qn.x, qn.y, qn.z, Scalar(0.0));
+        h_iter_r.data[n] = make_scalar4(rn.x, rn.y, rn.z, Scalar(0.0));
+
+        // diagonal matrix element
+        h_iter_diag.data[n] = double(4.0)*dot(qn,rn)*(double(1.0)/ma + double(1.0)/mb);
+
+        // fill vector component
+        h_cvec.data[n] = (dot(qn,qn)-d*d)/m_deltaT/m_deltaT;
+        h_cvec.data[n] += double(2.0)*dot(qn,vec3<Scalar>(h_netforce.data[idx_a])/ma
+              -vec3<Scalar>(h_netforce.data[idx_b])/mb);
+        }
+    }
+
 void ForceDistanceConstraint::checkConstraints(unsigned int timestep)
     {
     unsigned int n = m_constraint_violated.readFlags();
@@ -372,6 +479,97 @@ void ForceDistanceConstraint::solveConstraints(unsigned int timestep)
         m_prof->pop();
     }
 
+/*! The off-diagonal elements of the constraint matrix couple constraints sharing a particle. The product with the
+    vector of multipliers is evaluated by first summing lambda_m*r_m over the constraints of every particle (with the
+    sign of its position in the constraint) and then projecting the sums of both members onto q_n.
+*/
+void ForceDistanceConstraint::solveConstraintsIterative(unsigned int timestep)
+    {
+    unsigned int n_constraint = m_cdata->getN()+m_cdata->getNGhosts();
+
+    // skip if zero constraints
+    if (n_constraint == 0) return;
+
+    if (m_prof)
+        m_prof->push("iterate");
+
+    m_lagrange.resize(n_constraint);
+
+    unsigned int max_local = m_pdata->getN() + m_pdata->getNGhosts();
+    m_iter_lambda_r.resize(max_local);
+
+    // the multipliers of new constraints start from zero
+    unsigned int n_tags = m_cdata->getRTags().size();
+    if (m_lagrange_tag.size() != n_tags)
+        {
+        m_lagrange_tag.resize(n_tags);
+
+        ArrayHandle<double> h_lagrange_tag(m_lagrange_tag, access_location::host, access_mode::overwrite);
+        memset(h_lagrange_tag.data, 0, sizeof(double)*n_tags);
+        }
+
+    ArrayHandle<double> h_lagrange(m_lagrange, access_location::host, access_mode::overwrite);
+    ArrayHandle<double> h_lagrange_tag(m_lagrange_tag, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_group_tag(m_cdata->getTags(), access_location::host, access_mode::read);
+
+    ArrayHandle<double> h_cvec(m_cvec, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_iter_q(m_iter_q, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_iter_r(m_iter_r, access_location::host, access_mode::read);
+    ArrayHandle<double> h_iter_diag(m_iter_diag, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_iter_lambda_r(m_iter_lambda_r, access_location::host, access_mode::overwrite);
+
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+
+    // start from the solution of the previous step
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        h_lagrange.data[n] = h_lagrange_tag.data[h_group_tag.data[n]];
+        }
+
+    for (unsigned int iter = 0; iter < m_n_iter; ++iter)
+        {
+        memset(h_iter_lambda_r.data, 0, sizeof(Scalar4)*max_local);
+
+        for (unsigned int n = 0; n < n_constraint; ++n)
+            {
+            const ConstraintData::members_t constraint = m_cdata->getMembersByIndex(n);
+            unsigned int idx_a = h_rtag.data[constraint.tag[0]];
+            unsigned int idx_b = h_rtag.data[constraint.tag[1]];
+
+            vec3<Scalar> lambda_rn = Scalar(h_lagrange.data[n])*vec3<Scalar>(h_iter_r.data[n]);
+
+            h_iter_lambda_r.data[idx_a] = vec_to_scalar4(vec3<Scalar>(h_iter_lambda_r.data[idx_a])+lambda_rn, 0);
+            h_iter_lambda_r.data[idx_b] = vec_to_scalar4(vec3<Scalar>(h_iter_lambda_r.data[idx_b])-lambda_rn, 0);
+            }
+
+        // Jacobi update, every constraint reads only its own multiplier
+        for (unsigned int n = 0; n < n_constraint; ++n)
+            {
+            const ConstraintData::members_t constraint = m_cdata->getMembersByIndex(n);
+            unsigned int idx_a = h_rtag.data[constraint.tag[0]];
+            unsigned int idx_b = h_rtag.data[constraint.tag[1]];
+
+            Scalar ma(h_vel.data[idx_a].w);
+            Scalar mb(h_vel.data[idx_b].w);
+
+            double a_lambda = double(4.0)*dot(vec3<Scalar>(h_iter_q.data[n]),
+                vec3<Scalar>(h_iter_lambda_r.data[idx_a])/ma - vec3<Scalar>(h_iter_lambda_r.data[idx_b])/mb);
+
+            h_lagrange.data[n] += (h_cvec.data[n] - a_lambda)/h_iter_diag.data[n];
+            }
+        }
+
+    // store the solution for the next step
+    for (unsigned int n = 0; n < n_constraint; ++n)
+        {
+        h_lagrange_tag.data[h_group_tag.data[n]] = h_lagrange.data[n];
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
 void ForceDistanceConstraint::computeConstraintForces(unsigned int timestep)
     {
     ArrayHandle<double> h_lagrange(m_lagrange, access_location::host, access_mode::read);
@@ -596,5 +794,6 @@ void export_ForceDistanceConstraint(py::module& m)
     py::class_< ForceDistanceConstraint, std::shared_ptr<ForceDistanceConstraint> >(m, "ForceDistanceConstraint", py::base<MolecularForceCompute>())
         .def(py::init< std::shared_ptr<SystemDefinition> >())
         .def("setRelativeTolerance", &ForceDistanceConstraint::setRelativeTolerance)
+        .def("setIterative", &ForceDistanceConstraint::setIterative)
     ;
     }
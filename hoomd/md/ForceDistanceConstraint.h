@@ -30,6 +30,15 @@
     [1] M. Yoneya, H. J. C. Berendsen, and K. Hirasawa, “A Non-Iterative Matrix Method for Constraint Molecular Dynamics Simulations,” Mol. Simul., vol. 13, no. 6, pp. 395–405, 1994.
     [2] M. Yoneya, “A Generalized Non-iterative Matrix Method for Constraint Molecular Dynamics Simulations,” J. Comput. Phys., vol. 172, no. 1, pp. 188–197, Sep. 2001.
 
+    The linear system of equations for the Lagrange multipliers is solved directly with a sparse LU decomposition,
+    which requires the dense constraint matrix to be populated every step. Alternatively, with setIterative(), the
+    system is solved matrix-free with a fixed number of Jacobi iterations. Every iteration applies the constraint
+    matrix by accumulating the multiplier-weighted bond vectors on the particles and projecting them back onto the
+    constraints, so that the cost is linear in the number of constraints. The iteration starts from the multipliers
+    of the previous step (stored by constraint tag), which are already close to the solution.
+    The Jacobi iteration converges if the constraint matrix (weighted by the inverse masses) is diagonally dominant
+    enough, this holds for chains and small rigid clusters but may fail for highly coupled constraint networks.
+
     See Integrator for detailed documentation on constraint force implementation.
     \ingroup computes
 */
@@ -54,6 +63,9 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
             m_rel_tol = rel_tol;
             }
 
+        //! Select the solver for the constraint equation
+        void setIterative(bool iterative, unsigned int n_iter);
+
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
@@ -78,6 +90,14 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
             //!< The persistent state of the sparse matrix solver
         GPUVector<int> m_sparse_idxlookup;          //!< Reverse lookup from column-major to sparse matrix element
 
+        bool m_iterative;                           //!< True if the constraint equation is solved iteratively
+        unsigned int m_n_iter;                      //!< Number of Jacobi iterations per step
+        GPUVector<Scalar4> m_iter_q;                //!< Constraint separation at t+2*deltaT (per constraint)
+        GPUVector<Scalar4> m_iter_r;                //!< Constraint separation at t (per constraint)
+        GPUVector<double> m_iter_diag;              //!< Diagonal of the constraint matrix
+        GPUVector<Scalar4> m_iter_lambda_r;         //!< Sum of the multiplier-weighted separations per particle
+        GPUVector<double> m_lagrange_tag;           //!< Lagrange multipliers of the previous step, by constraint tag
+
         bool m_constraint_reorder;         //!< True if groups have changed
         bool m_constraints_added_removed;  //!< True if global constraint topology has changed
 
@@ -89,6 +109,12 @@ class PYBIND11_EXPORT ForceDistanceConstraint : public MolecularForceCompute
         //! Populate the quantities in the constraint-force equation
         virtual void fillMatrixVector(unsigned int timestep);
 
+        //! Populate the per-constraint quantities for the iterative solver
+        virtual void fillVectorIterative(unsigned int timestep);
+
+        //! Solve the constraint equation iteratively
+        virtual void solveConstraintsIterative(unsigned int timestep);
+
         //! Check violation of constraints
         virtual void checkConstraints(unsigned int timestep);
 
@@ -31,6 +31,7 @@ ForceDistanceConstraintGPU::ForceDistanceConstraintGPU(std::shared_ptr<SystemDef
     {
     m_tuner_fill.reset(new Autotuner(32, 1024, 32, 5, 100000, "dist_constraint_fill_matrix_vec", this->m_exec_conf));
     m_tuner_force.reset(new Autotuner(32, 1024, 32, 5, 100000, "dist_constraint_force", this->m_exec_conf));
+    m_tuner_iterate.reset(new Autotuner(32, 1024, 32, 5, 100000, "dist_constraint_iterate", this->m_exec_conf));
 
     #ifdef CUSOLVER_AVAILABLE
     // initialize cuSPARSE
@@ -126,7 +127,7 @@ void ForceDistanceConstraintGPU::fillMatrixVector(unsigned int timestep)
         ArrayHandle<double> d_cvec(m_cvec, access_location::device, access_mode::overwrite);
 
         // access GPU constraint table on device
-        const GPUArray<ConstraintData::members_t>& gpu_constraint_list = this->m_cdata->getGPUTable();
+        const GlobalVector<ConstraintData::members_t>& gpu_constraint_list = this->m_cdata->getGPUTable();
         const Index2D& gpu_table_indexer = this->m_cdata->getGPUTableIndexer();
 
         ArrayHandle<ConstraintData::members_t> d_gpu_clist(gpu_constraint_list, access_location::device, access_mode::read);
@@ -557,6 +558,133 @@ void ForceDistanceConstraintGPU::solveConstraints(unsigned int timestep)
     #endif
     }
 
+void ForceDistanceConstraintGPU::fillVectorIterative(unsigned int timestep)
+    {
+    if (m_prof)
+        m_prof->push(m_exec_conf, "fill vector");
+
+    unsigned int n_constraint = m_cdata->getN() + m_cdata->getNGhosts();
+
+    m_iter_q.resize(n_constraint);
+    m_iter_r.resize(n_constraint);
+    m_iter_diag.resize(n_constraint);
+
+    // access per-constraint quantities
+    ArrayHandle<double> d_cvec(m_cvec, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar4> d_iter_q(m_iter_q, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar4> d_iter_r(m_iter_r, access_location::device, access_mode::overwrite);
+    ArrayHandle<double> d_iter_diag(m_iter_diag, access_location::device, access_mode::overwrite);
+
+    // access GPU constraint table on device
+    ArrayHandle<ConstraintData::members_t> d_gpu_clist(m_cdata->getGPUTable(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int > d_gpu_n_constraints(m_cdata->getNGroupsArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_gpu_cpos(m_cdata->getGPUPosTable(), access_location::device, access_mode::read);
+    ArrayHandle<typeval_t> d_group_typeval(m_cdata->getTypeValArray(), access_location::device, access_mode::read);
+
+    // access particle data
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_netforce(m_pdata->getNetForce(), access_location::device, access_mode::read);
+
+    m_tuner_fill->begin();
+    gpu_fill_vector_iterative(
+        m_pdata->getN()+m_pdata->getNGhosts(),
+        d_cvec.data,
+        d_iter_q.data,
+        d_iter_r.data,
+        d_iter_diag.data,
+        m_rel_tol,
+        m_constraint_violated.getDeviceFlags(),
+        d_pos.data,
+        d_vel.data,
+        d_netforce.data,
+        d_gpu_clist.data,
+        m_cdata->getGPUTableIndexer(),
+        d_gpu_n_constraints.data,
+        d_gpu_cpos.data,
+        d_group_typeval.data,
+        m_deltaT,
+        m_pdata->getBox(),
+        m_tuner_fill->getParam());
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+
+    m_tuner_fill->end();
+
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+    }
+
+void ForceDistanceConstraintGPU::solveConstraintsIterative(unsigned int timestep)
+    {
+    unsigned int n_constraint = m_cdata->getN() + m_cdata->getNGhosts();
+
+    // skip if zero constraints
+    if (n_constraint == 0) return;
+
+    if (m_prof)
+        m_prof->push(m_exec_conf, "iterate");
+
+    m_lagrange.resize(n_constraint);
+
+    unsigned int nptl = m_pdata->getN() + m_pdata->getNGhosts();
+    m_iter_lambda_r.resize(nptl);
+
+    // the multipliers of new constraints start from zero
+    unsigned int n_tags = m_cdata->getRTags().size();
+    if (m_lagrange_tag.size() != n_tags)
+        {
+        m_lagrange_tag.resize(n_tags);
+
+        ArrayHandle<double> d_lagrange_tag(m_lagrange_tag, access_location::device, access_mode::overwrite);
+        cudaMemset(d_lagrange_tag.data, 0, sizeof(double)*n_tags);
+        }
+
+    ArrayHandle<double> d_lagrange(m_lagrange, access_location::device, access_mode::overwrite);
+    ArrayHandle<double> d_lagrange_tag(m_lagrange_tag, access_location::device, access_mode::readwrite);
+    ArrayHandle<unsigned int> d_group_tag(m_cdata->getTags(), access_location::device, access_mode::read);
+
+    ArrayHandle<double> d_cvec(m_cvec, access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_iter_q(m_iter_q, access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_iter_r(m_iter_r, access_location::device, access_mode::read);
+    ArrayHandle<double> d_iter_diag(m_iter_diag, access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_iter_lambda_r(m_iter_lambda_r, access_location::device, access_mode::overwrite);
+
+    ArrayHandle<ConstraintData::members_t> d_gpu_clist(m_cdata->getGPUTable(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int > d_gpu_n_constraints(m_cdata->getNGroupsArray(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_gpu_cpos(m_cdata->getGPUPosTable(), access_location::device, access_mode::read);
+
+    ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::read);
+
+    m_tuner_iterate->begin();
+    gpu_solve_constraints_iterative(n_constraint,
+        nptl,
+        d_lagrange.data,
+        d_lagrange_tag.data,
+        d_group_tag.data,
+        d_cvec.data,
+        d_iter_q.data,
+        d_iter_r.data,
+        d_iter_diag.data,
+        d_iter_lambda_r.data,
+        d_vel.data,
+        d_gpu_clist.data,
+        m_cdata->getGPUTableIndexer(),
+        d_gpu_n_constraints.data,
+        d_gpu_cpos.data,
+        m_n_iter,
+        m_tuner_iterate->getParam());
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+
+    m_tuner_iterate->end();
+
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+    }
+
 void ForceDistanceConstraintGPU::computeConstraintForces(unsigned int timestep)
     {
     if (m_prof)
@@ -573,7 +701,7 @@ void ForceDistanceConstraintGPU::computeConstraintForces(unsigned int timestep)
     ArrayHandle<Scalar> d_virial(m_virial, access_location::device, access_mode::overwrite);
 
     // access GPU constraint table on device
-    const GPUArray<ConstraintData::members_t>& gpu_constraint_list = this->m_cdata->getGPUTable();
+    const GlobalVector<ConstraintData::members_t>& gpu_constraint_list = this->m_cdata->getGPUTable();
     const Index2D& gpu_table_indexer = this->m_cdata->getGPUTableIndexer();
 
     ArrayHandle<ConstraintData::members_t> d_gpu_clist(gpu_constraint_list, access_location::device, access_mode::read);
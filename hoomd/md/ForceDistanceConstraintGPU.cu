@@ -224,6 +224,297 @@ cudaError_t gpu_fill_matrix_vector(unsigned int n_constraint,
     return cudaSuccess;
     }
 
+//! Kernel to fill the per-constraint quantities of the iterative solver
+/*! One thread per particle, every constraint is filled by the thread of its first member
+*/
+__global__ void gpu_fill_vector_iterative_kernel(unsigned int nptl_local,
+                                                 double *d_vec,
+                                                 Scalar4 *d_iter_q,
+                                                 Scalar4 *d_iter_r,
+                                                 double *d_iter_diag,
+                                                 Scalar rel_tol,
+                                                 unsigned int *d_constraint_violated,
+                                                 const Scalar4 *d_pos,
+                                                 const Scalar4 *d_vel,
+                                                 const Scalar4 *d_netforce,
+                                                 const group_storage<2> *d_gpu_clist,
+                                                 const Index2D gpu_clist_indexer,
+                                                 const unsigned int *d_gpu_n_constraints,
+                                                 const unsigned int *d_gpu_cpos,
+                                                 const typeval_union *d_group_typeval,
+                                                 Scalar deltaT,
+                                                 const BoxDim box)
+    {
+    unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx >= nptl_local)
+        return;
+
+    unsigned int n_constraint_ptl = d_gpu_n_constraints[idx];
+
+    for (unsigned int cidx = 0; cidx < n_constraint_ptl; cidx++)
+        {
+        if (d_gpu_cpos[gpu_clist_indexer(idx, cidx)] != 0)
+            continue;
+
+        group_storage<2> cur_constraint = d_gpu_clist[gpu_clist_indexer(idx, cidx)];
+
+        unsigned int idx_na = idx;
+        unsigned int idx_nb = cur_constraint.idx[0];
+
+        // constraint index
+        unsigned int n = cur_constraint.idx[1];
+
+        // the constraint distance
+        Scalar d = d_group_typeval[n].val;
+
+        // constraint separation
+        vec3<Scalar> rn(vec3<Scalar>(d_pos[idx_na])-vec3<Scalar>(d_pos[idx_nb]));
+
+        // apply minimum image
+        rn = box.minImage(rn);
+
+        // get masses
+        Scalar ma = d_vel[idx_na].w;
+        Scalar mb = d_vel[idx_nb].w;
+
+        // constraint separation at t+2*deltaT
+        vec3<Scalar> rndot(vec3<Scalar>(d_vel[idx_na]) - vec3<Scalar>(d_vel[idx_nb]));
+        vec3<Scalar> qn(rn + deltaT*rndot);
+
+        if (fast::sqrt(dot(rn,rn))-d >= rel_tol*d || isnan(dot(rn,rn)))
+            {
+            *d_constraint_violated = n+1;
+            }
+
+        d_iter_q[n] = make_scalar4(qn.x, qn.y, qn.z, Scalar(0.0));
+        d_iter_r[n] = make_scalar4(rn.x, rn.y, rn.z, Scalar(0.0));
+        d_iter_diag[n] = double(4.0)*dot(qn,rn)*(double(1.0)/ma + double(1.0)/mb);
+
+        d_vec[n] = (dot(qn,qn)-d*d)/deltaT/deltaT
+            + double(2.0)*dot(qn, vec3<Scalar>(d_netforce[idx_na])/ma-vec3<Scalar>(d_netforce[idx_nb])/mb);
+        }
+    }
+
+cudaError_t gpu_fill_vector_iterative(unsigned int nptl_local,
+                          double *d_vec,
+                          Scalar4 *d_iter_q,
+                          Scalar4 *d_iter_r,
+                          double *d_iter_diag,
+                          Scalar rel_tol,
+                          unsigned int *d_constraint_violated,
+                          const Scalar4 *d_pos,
+                          const Scalar4 *d_vel,
+                          const Scalar4 *d_netforce,
+                          const group_storage<2> *d_gpu_clist,
+                          const Index2D & gpu_clist_indexer,
+                          const unsigned int *d_gpu_n_constraints,
+                          const unsigned int *d_gpu_cpos,
+                          const typeval_union *d_group_typeval,
+                          Scalar deltaT,
+                          const BoxDim box,
+                          unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)gpu_fill_vector_iterative_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    // run configuration
+    unsigned int run_block_size = min(block_size, max_block_size);
+    unsigned int n_blocks = nptl_local/run_block_size + 1;
+
+    gpu_fill_vector_iterative_kernel<<<n_blocks, run_block_size>>>(
+        nptl_local,
+        d_vec,
+        d_iter_q,
+        d_iter_r,
+        d_iter_diag,
+        rel_tol,
+        d_constraint_violated,
+        d_pos,
+        d_vel,
+        d_netforce,
+        d_gpu_clist,
+        gpu_clist_indexer,
+        d_gpu_n_constraints,
+        d_gpu_cpos,
+        d_group_typeval,
+        deltaT,
+        box);
+
+    return cudaSuccess;
+    }
+
+//! Kernel to copy the lagrange multipliers from or to their storage by constraint tag
+__global__ void gpu_lagrange_by_tag_kernel(unsigned int n_constraint,
+                                           const unsigned int *d_group_tag,
+                                           double *d_lagrange,
+                                           double *d_lagrange_tag,
+                                           bool store)
+    {
+    unsigned int n = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (n >= n_constraint)
+        return;
+
+    if (store)
+        d_lagrange_tag[d_group_tag[n]] = d_lagrange[n];
+    else
+        d_lagrange[n] = d_lagrange_tag[d_group_tag[n]];
+    }
+
+//! Kernel to sum the multiplier-weighted constraint separations per particle
+__global__ void gpu_sum_lambda_r_kernel(unsigned int nptl_local,
+                                        Scalar4 *d_iter_lambda_r,
+                                        const Scalar4 *d_iter_r,
+                                        const double *d_lagrange,
+                                        const group_storage<2> *d_gpu_clist,
+                                        const Index2D gpu_clist_indexer,
+                                        const unsigned int *d_gpu_n_constraints,
+                                        const unsigned int *d_gpu_cpos)
+    {
+    unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx >= nptl_local)
+        return;
+
+    unsigned int n_constraint_ptl = d_gpu_n_constraints[idx];
+
+    vec3<Scalar> lambda_r(0.0,0.0,0.0);
+    for (unsigned int cidx = 0; cidx < n_constraint_ptl; cidx++)
+        {
+        unsigned int n = d_gpu_clist[gpu_clist_indexer(idx, cidx)].idx[1];
+        vec3<Scalar> lambda_rn = Scalar(d_lagrange[n])*vec3<Scalar>(d_iter_r[n]);
+
+        if (d_gpu_cpos[gpu_clist_indexer(idx, cidx)] == 0)
+            lambda_r += lambda_rn;
+        else
+            lambda_r -= lambda_rn;
+        }
+
+    d_iter_lambda_r[idx] = vec_to_scalar4(lambda_r, Scalar(0.0));
+    }
+
+//! Kernel to perform one Jacobi update of the lagrange multipliers
+__global__ void gpu_jacobi_update_kernel(unsigned int nptl_local,
+                                         double *d_lagrange,
+                                         const double *d_vec,
+                                         const Scalar4 *d_iter_q,
+                                         const double *d_iter_diag,
+                                         const Scalar4 *d_iter_lambda_r,
+                                         const Scalar4 *d_vel,
+                                         const group_storage<2> *d_gpu_clist,
+                                         const Index2D gpu_clist_indexer,
+                                         const unsigned int *d_gpu_n_constraints,
+                                         const unsigned int *d_gpu_cpos)
+    {
+    unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx >= nptl_local)
+        return;
+
+    unsigned int n_constraint_ptl = d_gpu_n_constraints[idx];
+
+    for (unsigned int cidx = 0; cidx < n_constraint_ptl; cidx++)
+        {
+        if (d_gpu_cpos[gpu_clist_indexer(idx, cidx)] != 0)
+            continue;
+
+        group_storage<2> cur_constraint = d_gpu_clist[gpu_clist_indexer(idx, cidx)];
+        unsigned int idx_nb = cur_constraint.idx[0];
+        unsigned int n = cur_constraint.idx[1];
+
+        Scalar ma = d_vel[idx].w;
+        Scalar mb = d_vel[idx_nb].w;
+
+        double a_lambda = double(4.0)*dot(vec3<Scalar>(d_iter_q[n]),
+            vec3<Scalar>(d_iter_lambda_r[idx])/ma - vec3<Scalar>(d_iter_lambda_r[idx_nb])/mb);
+
+        d_lagrange[n] += (d_vec[n] - a_lambda)/d_iter_diag[n];
+        }
+    }
+
+/*! The iteration starts from the multipliers in d_lagrange_tag and stores the solution there, too
+*/
+cudaError_t gpu_solve_constraints_iterative(unsigned int n_constraint,
+                          unsigned int nptl_local,
+                          double *d_lagrange,
+                          double *d_lagrange_tag,
+                          const unsigned int *d_group_tag,
+                          const double *d_vec,
+                          const Scalar4 *d_iter_q,
+                          const Scalar4 *d_iter_r,
+                          const double *d_iter_diag,
+                          Scalar4 *d_iter_lambda_r,
+                          const Scalar4 *d_vel,
+                          const group_storage<2> *d_gpu_clist,
+                          const Index2D & gpu_clist_indexer,
+                          const unsigned int *d_gpu_n_constraints,
+                          const unsigned int *d_gpu_cpos,
+                          unsigned int n_iter,
+                          unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)gpu_jacobi_update_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+
+        cudaFuncGetAttributes(&attr, (const void*)gpu_sum_lambda_r_kernel);
+        max_block_size = min(max_block_size, (unsigned int) attr.maxThreadsPerBlock);
+        }
+
+    // run configuration
+    unsigned int run_block_size = min(block_size, max_block_size);
+    unsigned int n_blocks = nptl_local/run_block_size + 1;
+    unsigned int n_blocks_constraint = n_constraint/run_block_size + 1;
+
+    // warm start
+    gpu_lagrange_by_tag_kernel<<<n_blocks_constraint, run_block_size>>>(n_constraint,
+        d_group_tag,
+        d_lagrange,
+        d_lagrange_tag,
+        false);
+
+    for (unsigned int iter = 0; iter < n_iter; ++iter)
+        {
+        gpu_sum_lambda_r_kernel<<<n_blocks, run_block_size>>>(nptl_local,
+            d_iter_lambda_r,
+            d_iter_r,
+            d_lagrange,
+            d_gpu_clist,
+            gpu_clist_indexer,
+            d_gpu_n_constraints,
+            d_gpu_cpos);
+
+        gpu_jacobi_update_kernel<<<n_blocks, run_block_size>>>(nptl_local,
+            d_lagrange,
+            d_vec,
+            d_iter_q,
+            d_iter_diag,
+            d_iter_lambda_r,
+            d_vel,
+            d_gpu_clist,
+            gpu_clist_indexer,
+            d_gpu_n_constraints,
+            d_gpu_cpos);
+        }
+
+    // store the solution for the next step
+    gpu_lagrange_by_tag_kernel<<<n_blocks_constraint, run_block_size>>>(n_constraint,
+        d_group_tag,
+        d_lagrange,
+        d_lagrange_tag,
+        true);
+
+    return cudaSuccess;
+    }
+
 __global__ void gpu_fill_constraint_forces_kernel(unsigned int nptl_local,
                                         const Scalar4 *d_pos,
                                         const group_storage<2> *d_gpu_clist,
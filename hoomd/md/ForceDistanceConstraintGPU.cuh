@@ -35,6 +35,43 @@ cudaError_t gpu_fill_matrix_vector(unsigned int n_constraint,
                           const BoxDim box,
                           unsigned int block_size);
 
+cudaError_t gpu_fill_vector_iterative(unsigned int nptl_local,
+                          double *d_vec,
+                          Scalar4 *d_iter_q,
+                          Scalar4 *d_iter_r,
+                          double *d_iter_diag,
+                          Scalar rel_tol,
+                          unsigned int *d_constraint_violated,
+                          const Scalar4 *d_pos,
+                          const Scalar4 *d_vel,
+                          const Scalar4 *d_netforce,
+                          const group_storage<2> *d_gpu_clist,
+                          const Index2D & gpu_clist_indexer,
+                          const unsigned int *d_gpu_n_constraints,
+                          const unsigned int *d_gpu_cpos,
+                          const typeval_union *d_group_typeval,
+                          Scalar deltaT,
+                          const BoxDim box,
+                          unsigned int block_size);
+
+cudaError_t gpu_solve_constraints_iterative(unsigned int n_constraint,
+                          unsigned int nptl_local,
+                          double *d_lagrange,
+                          double *d_lagrange_tag,
+                          const unsigned int *d_group_tag,
+                          const double *d_vec,
+                          const Scalar4 *d_iter_q,
+                          const Scalar4 *d_iter_r,
+                          const double *d_iter_diag,
+                          Scalar4 *d_iter_lambda_r,
+                          const Scalar4 *d_vel,
+                          const group_storage<2> *d_gpu_clist,
+                          const Index2D & gpu_clist_indexer,
+                          const unsigned int *d_gpu_n_constraints,
+                          const unsigned int *d_gpu_cpos,
+                          unsigned int n_iter,
+                          unsigned int block_size);
+
 cudaError_t gpu_count_nnz(unsigned int n_constraint,
                            double *d_matrix,
                            int *d_nnz,
@@ -59,14 +59,17 @@ class ForceDistanceConstraintGPU : public ForceDistanceConstraint
 
             m_tuner_fill->setPeriod(period);
             m_tuner_force->setPeriod(period);
+            m_tuner_iterate->setPeriod(period);
 
             m_tuner_fill->setEnabled(enable);
             m_tuner_force->setEnabled(enable);
+            m_tuner_iterate->setEnabled(enable);
             }
 
     protected:
         std::unique_ptr<Autotuner> m_tuner_fill;  //!< Autotuner for filling the constraint matrix
         std::unique_ptr<Autotuner> m_tuner_force; //!< Autotuner for populating the force array
+        std::unique_ptr<Autotuner> m_tuner_iterate; //!< Autotuner for the iterative solver
 
         #ifdef CUSOLVER_AVAILABLE
         cusparseHandle_t m_cusparse_handle;                //!< cuSPARSE handle
@@ -119,6 +122,12 @@ class ForceDistanceConstraintGPU : public ForceDistanceConstraint
         //! Solve the matrix equation
         virtual void solveConstraints(unsigned int timestep);
 
+        //! Populate the per-constraint quantities for the iterative solver
+        virtual void fillVectorIterative(unsigned int timestep);
+
+        //! Solve the constraint equation iteratively
+        virtual void solveConstraintsIterative(unsigned int timestep);
+
         //! Compute the constraint forces using the Lagrange multipliers
         virtual void computeConstraintForces(unsigned int timestep);
     };
@@ -0,0 +1,271 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+/*! \file FusedBondedForceComputeGPU.cc
+    \brief Defines FusedBondedForceComputeGPU
+*/
+
+#include "FusedBondedForceComputeGPU.h"
+
+#include <stdexcept>
+#include <cstring>
+
+namespace py = pybind11;
+
+using namespace std;
+
+/*! \param sysdef System to compute the bonded forces on
+*/
+FusedBondedForceComputeGPU::FusedBondedForceComputeGPU(std::shared_ptr<SystemDefinition> sysdef)
+    : ForceCompute(sysdef), m_bonds_enabled(false), m_angles_enabled(false), m_dihedrals_enabled(false)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing FusedBondedForceComputeGPU" << endl;
+
+    // can't run on the GPU if there aren't any GPUs in the execution configuration
+    if (!m_exec_conf->isCUDAEnabled())
+        {
+        m_exec_conf->msg->error() << "Creating a FusedBondedForceComputeGPU with no GPU in execution configuration" << endl;
+        throw std::runtime_error("Error initializing FusedBondedForceComputeGPU");
+        }
+
+    m_bond_data = m_sysdef->getBondData();
+    m_angle_data = m_sysdef->getAngleData();
+    m_dihedral_data = m_sysdef->getDihedralData();
+
+    // allocate the parameters
+    GPUArray<Scalar2> bond_params(m_bond_data->getNTypes(), m_exec_conf);
+    m_bond_params.swap(bond_params);
+    GPUArray<Scalar2> angle_params(m_angle_data->getNTypes(), m_exec_conf);
+    m_angle_params.swap(angle_params);
+    GPUArray<Scalar4> dihedral_params(m_dihedral_data->getNTypes(), m_exec_conf);
+    m_dihedral_params.swap(dihedral_params);
+
+    // allocate flags storage on the GPU
+    GPUArray<unsigned int> flags(1, m_exec_conf);
+    m_flags.swap(flags);
+
+    ArrayHandle<unsigned int> h_flags(m_flags, access_location::host, access_mode::overwrite);
+    h_flags.data[0] = 0;
+
+    m_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "fused_bonded", m_exec_conf));
+    }
+
+FusedBondedForceComputeGPU::~FusedBondedForceComputeGPU()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying FusedBondedForceComputeGPU" << endl;
+    }
+
+/*! \param type Type of the bond to set parameters for
+    \param k Stiffness parameter for the force computation
+    \param r_0 Equilibrium length for the force computation
+*/
+void FusedBondedForceComputeGPU::setBondParams(unsigned int type, Scalar k, Scalar r_0)
+    {
+    // make sure the type is valid
+    if (type >= m_bond_data->getNTypes())
+        {
+        m_exec_conf->msg->error() << "force.fused_bonded: Invalid bond type specified" << endl;
+        throw runtime_error("Error setting parameters in FusedBondedForceComputeGPU");
+        }
+
+    ArrayHandle<Scalar2> h_params(m_bond_params, access_location::host, access_mode::readwrite);
+    h_params.data[type] = make_scalar2(k, r_0);
+    m_bonds_enabled = true;
+    }
+
+/*! \param type Type of the angle to set parameters for
+    \param k Stiffness parameter for the force computation
+    \param t_0 Equilibrium angle (in radians) for the force computation
+*/
+void FusedBondedForceComputeGPU::setAngleParams(unsigned int type, Scalar k, Scalar t_0)
+    {
+    // make sure the type is valid
+    if (type >= m_angle_data->getNTypes())
+        {
+        m_exec_conf->msg->error() << "force.fused_bonded: Invalid angle type specified" << endl;
+        throw runtime_error("Error setting parameters in FusedBondedForceComputeGPU");
+        }
+
+    ArrayHandle<Scalar2> h_params(m_angle_params, access_location::host, access_mode::readwrite);
+    h_params.data[type] = make_scalar2(k, t_0);
+    m_angles_enabled = true;
+    }
+
+/*! \param type Type of the dihedral to set parameters for
+    \param k1 Force parameter in OPLS-style dihedral
+    \param k2 Force parameter in OPLS-style dihedral
+    \param k3 Force parameter in OPLS-style dihedral
+    \param k4 Force parameter in OPLS-style dihedral
+
+    The parameters are stored with the 1/2 prefactor, as in OPLSDihedralForceCompute.
+*/
+void FusedBondedForceComputeGPU::setDihedralParams(unsigned int type, Scalar k1, Scalar k2, Scalar k3, Scalar k4)
+    {
+    // make sure the type is valid
+    if (type >= m_dihedral_data->getNTypes())
+        {
+        m_exec_conf->msg->error() << "force.fused_bonded: Invalid dihedral type specified" << endl;
+        throw runtime_error("Error setting parameters in FusedBondedForceComputeGPU");
+        }
+
+    ArrayHandle<Scalar4> h_params(m_dihedral_params, access_location::host, access_mode::readwrite);
+    h_params.data[type] = make_scalar4(k1/2.0, k2/2.0, k3/2.0, k4/2.0);
+    m_dihedrals_enabled = true;
+    }
+
+/*! FusedBondedForceComputeGPU provides
+    - \c fused_bonded_energy
+*/
+std::vector< std::string > FusedBondedForceComputeGPU::getProvidedLogQuantities()
+    {
+    vector<string> list;
+    list.push_back("fused_bonded_energy");
+    return list;
+    }
+
+/*! \param quantity Name of the quantity to get the log value of
+    \param timestep Current time step of the simulation
+*/
+Scalar FusedBondedForceComputeGPU::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    if (quantity == string("fused_bonded_energy"))
+        {
+        compute(timestep);
+        return calcEnergySum();
+        }
+    else
+        {
+        m_exec_conf->msg->error() << "force.fused_bonded: " << quantity << " is not a valid log quantity" << endl;
+        throw runtime_error("Error getting log value");
+        }
+    }
+
+/*! Internal method for computing the forces on the GPU.
+    \post The force data on the GPU is written with the calculated forces
+
+    \param timestep Current time step of the simulation
+
+    Calls gpu_compute_fused_bonded_forces to do the dirty work.
+*/
+void FusedBondedForceComputeGPU::computeForces(unsigned int timestep)
+    {
+    // start the profile
+    if (m_prof) m_prof->push(m_exec_conf, "Fused bonded");
+
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+
+    // we are using the minimum image of the global box here
+    // to ensure that ghosts are always correctly wrapped (even if a bond exceeds half the domain length)
+    BoxDim box = m_pdata->getGlobalBox();
+
+    ArrayHandle<Scalar4> d_force(m_force, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar> d_virial(m_virial, access_location::device, access_mode::overwrite);
+
+        {
+        fused_bonded_args_t args;
+        memset(&args, 0, sizeof(args));
+
+        // only the tables of the enabled terms are built and accessed
+        std::unique_ptr< ArrayHandle<BondData::members_t> > d_bonds;
+        std::unique_ptr< ArrayHandle<unsigned int> > d_bond_type;
+        std::unique_ptr< ArrayHandle<Scalar2> > d_bond_params;
+        if (m_bonds_enabled)
+            {
+            d_bonds.reset(new ArrayHandle<BondData::members_t>(m_bond_data->getGPUGroupList(),
+                access_location::device, access_mode::read));
+            d_bond_type.reset(new ArrayHandle<unsigned int>(m_bond_data->getGPUGroupListTypes(),
+                access_location::device, access_mode::read));
+            d_bond_params.reset(new ArrayHandle<Scalar2>(m_bond_params, access_location::device, access_mode::read));
+
+            args.d_bonds = d_bonds->data;
+            args.d_bond_type = d_bond_type->data;
+            args.n_bonds = m_bond_data->getGPUGroupList().size();
+            args.d_bond_params = d_bond_params->data;
+            args.n_bond_types = m_bond_data->getNTypes();
+            }
+
+        std::unique_ptr< ArrayHandle<AngleData::members_t> > d_angles;
+        std::unique_ptr< ArrayHandle<unsigned int> > d_angle_type;
+        std::unique_ptr< ArrayHandle<Scalar2> > d_angle_params;
+        if (m_angles_enabled)
+            {
+            d_angles.reset(new ArrayHandle<AngleData::members_t>(m_angle_data->getGPUGroupList(),
+                access_location::device, access_mode::read));
+            d_angle_type.reset(new ArrayHandle<unsigned int>(m_angle_data->getGPUGroupListTypes(),
+                access_location::device, access_mode::read));
+            d_angle_params.reset(new ArrayHandle<Scalar2>(m_angle_params, access_location::device,
+                access_mode::read));
+
+            args.d_angles = d_angles->data;
+            args.d_angle_type = d_angle_type->data;
+            args.n_angles = m_angle_data->getGPUGroupList().size();
+            args.d_angle_params = d_angle_params->data;
+            args.n_angle_types = m_angle_data->getNTypes();
+            }
+
+        std::unique_ptr< ArrayHandle<DihedralData::members_t> > d_dihedrals;
+        std::unique_ptr< ArrayHandle<unsigned int> > d_dihedral_type;
+        std::unique_ptr< ArrayHandle<Scalar4> > d_dihedral_params;
+        if (m_dihedrals_enabled)
+            {
+            d_dihedrals.reset(new ArrayHandle<DihedralData::members_t>(m_dihedral_data->getGPUGroupList(),
+                access_location::device, access_mode::read));
+            d_dihedral_type.reset(new ArrayHandle<unsigned int>(m_dihedral_data->getGPUGroupListTypes(),
+                access_location::device, access_mode::read));
+            d_dihedral_params.reset(new ArrayHandle<Scalar4>(m_dihedral_params, access_location::device,
+                access_mode::read));
+
+            args.d_dihedrals = d_dihedrals->data;
+            args.d_dihedral_type = d_dihedral_type->data;
+            args.n_dihedrals = m_dihedral_data->getGPUGroupList().size();
+            args.d_dihedral_params = d_dihedral_params->data;
+            args.n_dihedral_types = m_dihedral_data->getNTypes();
+            }
+
+        ArrayHandle<unsigned int> d_flags(m_flags, access_location::device, access_mode::readwrite);
+
+        m_tuner->begin();
+        gpu_compute_fused_bonded_forces(d_force.data,
+                                        d_virial.data,
+                                        m_virial.getPitch(),
+                                        m_pdata->getN(),
+                                        d_pos.data,
+                                        box,
+                                        args,
+                                        d_flags.data,
+                                        m_tuner->getParam());
+        }
+
+    if (m_exec_conf->isCUDAErrorCheckingEnabled())
+        {
+        CHECK_CUDA_ERROR();
+
+        // check the flags for any errors
+        ArrayHandle<unsigned int> h_flags(m_flags, access_location::host, access_mode::read);
+
+        if (h_flags.data[0] & 1)
+            {
+            m_exec_conf->msg->error() << "force.fused_bonded: bond out of bounds (" << h_flags.data[0] << ")"
+                                      << std::endl << std::endl;
+            throw std::runtime_error("Error in bond calculation");
+            }
+        }
+    m_tuner->end();
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+void export_FusedBondedForceComputeGPU(py::module& m)
+    {
+    py::class_<FusedBondedForceComputeGPU, std::shared_ptr<FusedBondedForceComputeGPU> >(m,
+        "FusedBondedForceComputeGPU", py::base<ForceCompute>())
+    .def(py::init< std::shared_ptr<SystemDefinition> >())
+    .def("setBondParams", &FusedBondedForceComputeGPU::setBondParams)
+    .def("setAngleParams", &FusedBondedForceComputeGPU::setAngleParams)
+    .def("setDihedralParams", &FusedBondedForceComputeGPU::setDihedralParams)
+    .def("setEnabled", &FusedBondedForceComputeGPU::setEnabled)
+    ;
+    }
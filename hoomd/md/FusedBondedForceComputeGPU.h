@@ -0,0 +1,123 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "hoomd/ForceCompute.h"
+#include "hoomd/BondedGroupData.h"
+#include "hoomd/Autotuner.h"
+#include "FusedBondedForceGPU.cuh"
+
+#include <memory>
+#include <vector>
+
+/*! \file FusedBondedForceComputeGPU.h
+    \brief Declares the FusedBondedForceComputeGPU class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+#ifndef __FUSEDBONDEDFORCECOMPUTEGPU_H__
+#define __FUSEDBONDEDFORCECOMPUTEGPU_H__
+
+//! Computes harmonic bond, harmonic angle and OPLS dihedral forces in a single GPU kernel
+/*! Separate bond, angle and dihedral computes each launch their own kernel, read the particle positions again and
+    write their own force and virial arrays, which the integrator then sums. FusedBondedForceComputeGPU evaluates all
+    three kinds of terms in one kernel launch and accumulates them into a single force and virial array.
+
+    The kernel uses the group-centric tables of BondData, AngleData and DihedralData (see
+    BondedGroupData::getGPUGroupList()). Every thread evaluates one group, and the contributions are added to the
+    members with gpu_group_force_scatter(). The bonds, angles and dihedrals occupy consecutive thread ranges padded to
+    the warp size, so that every warp evaluates a single kind of term.
+
+    Each kind of term is enabled by setting its parameters, the parameters of all types of an enabled kind must be
+    set. The parameters follow the conventions of the potentials they replace: bond.harmonic (k, r0), angle.harmonic
+    (k, t0) and dihedral.opls (k1 .. k4).
+
+    \ingroup computes
+*/
+class PYBIND11_EXPORT FusedBondedForceComputeGPU : public ForceCompute
+    {
+    public:
+        //! Constructs the compute
+        FusedBondedForceComputeGPU(std::shared_ptr<SystemDefinition> sysdef);
+
+        //! Destructor
+        virtual ~FusedBondedForceComputeGPU();
+
+        //! Set the parameters of a harmonic bond type and enable the bonds
+        virtual void setBondParams(unsigned int type, Scalar k, Scalar r_0);
+
+        //! Set the parameters of a harmonic angle type and enable the angles
+        virtual void setAngleParams(unsigned int type, Scalar k, Scalar t_0);
+
+        //! Set the parameters of an OPLS dihedral type and enable the dihedrals
+        virtual void setDihedralParams(unsigned int type, Scalar k1, Scalar k2, Scalar k3, Scalar k4);
+
+        //! Enable or disable the evaluation of the bonds, angles and dihedrals
+        void setEnabled(bool bonds, bool angles, bool dihedrals)
+            {
+            m_bonds_enabled = bonds;
+            m_angles_enabled = angles;
+            m_dihedrals_enabled = dihedrals;
+            }
+
+        //! Returns a list of log quantities this compute calculates
+        virtual std::vector< std::string > getProvidedLogQuantities();
+
+        //! Calculates the requested log value and returns it
+        virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+        //! Set autotuner parameters
+        /*! \param enable Enable/disable autotuning
+            \param period period (approximate) in time steps when returning occurs
+        */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            ForceCompute::setAutotunerParams(enable, period);
+            m_tuner->setPeriod(period);
+            m_tuner->setEnabled(enable);
+            }
+
+        #ifdef ENABLE_MPI
+        //! Get ghost particle fields requested by this compute
+        /*! \param timestep Current time step
+        */
+        virtual CommFlags getRequestedCommFlags(unsigned int timestep)
+            {
+            CommFlags flags = CommFlags(0);
+            flags[comm_flag::tag] = 1;
+            flags |= ForceCompute::getRequestedCommFlags(timestep);
+            return flags;
+            }
+        #endif
+
+    protected:
+        std::shared_ptr<BondData> m_bond_data;          //!< Bond data
+        std::shared_ptr<AngleData> m_angle_data;        //!< Angle data
+        std::shared_ptr<DihedralData> m_dihedral_data;  //!< Dihedral data
+
+        GPUArray<Scalar2> m_bond_params;                //!< k, r_0 per bond type
+        GPUArray<Scalar2> m_angle_params;               //!< k, t_0 per angle type
+        GPUArray<Scalar4> m_dihedral_params;            //!< k1/2 .. k4/2 per dihedral type
+
+        bool m_bonds_enabled;                           //!< True if the bonds are evaluated
+        bool m_angles_enabled;                          //!< True if the angles are evaluated
+        bool m_dihedrals_enabled;                       //!< True if the dihedrals are evaluated
+
+        GPUArray<unsigned int> m_flags;                 //!< Flags set during the kernel execution
+        std::unique_ptr<Autotuner> m_tuner;             //!< Autotuner for block size
+
+        //! Actually compute the forces
+        virtual void computeForces(unsigned int timestep);
+    };
+
+//! Exports the FusedBondedForceComputeGPU class to python
+void export_FusedBondedForceComputeGPU(pybind11::module& m);
+
+#endif
@@ -0,0 +1,429 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "FusedBondedForceGPU.cuh"
+#include "EvaluatorBondHarmonic.h"
+#include "GroupForceScatter.cuh"
+
+#include <assert.h>
+
+// SMALL a relatively small number
+#define SMALL Scalar(0.001)
+
+/*! \file FusedBondedForceGPU.cu
+    \brief Defines GPU kernel code for the fused bonded force computation. Used by FusedBondedForceComputeGPU.
+*/
+
+//! Round \a n up to a multiple of the warp size
+__host__ __device__ inline unsigned int fused_bonded_warp_round(unsigned int n)
+    {
+    return (n + 31) & ~31u;
+    }
+
+//! Evaluate a harmonic bond
+/*! \param bond Local member indices of the bond
+    \param params k and r0
+    \param d_pos Particle positions
+    \param box Box for the minimum image convention
+    \param force Per-member force and energy (output)
+    \param virial Per-member virial (output)
+    \returns false if the bond cannot be evaluated
+*/
+__device__ inline bool fused_eval_bond(const group_storage<2>& bond,
+                                       const Scalar2 params,
+                                       const Scalar4 *d_pos,
+                                       const BoxDim& box,
+                                       Scalar4 *force,
+                                       Scalar (*virial)[6])
+    {
+    Scalar4 postype_a = d_pos[bond.idx[0]];
+    Scalar4 postype_b = d_pos[bond.idx[1]];
+
+    Scalar3 dx = make_scalar3(postype_a.x, postype_a.y, postype_a.z)
+                 - make_scalar3(postype_b.x, postype_b.y, postype_b.z);
+    dx = box.minImage(dx);
+
+    Scalar force_divr = Scalar(0.0);
+    Scalar bond_eng = Scalar(0.0);
+    EvaluatorBondHarmonic eval(dot(dx, dx), params);
+    if (!eval.evalForceAndEnergy(force_divr, bond_eng))
+        return false;
+
+    // the energy and virial are split evenly between the members
+    Scalar force_div2r = force_divr/Scalar(2.0);
+    Scalar bond_virial[6];
+    bond_virial[0] = dx.x * dx.x * force_div2r; // xx
+    bond_virial[1] = dx.x * dx.y * force_div2r; // xy
+    bond_virial[2] = dx.x * dx.z * force_div2r; // xz
+    bond_virial[3] = dx.y * dx.y * force_div2r; // yy
+    bond_virial[4] = dx.y * dx.z * force_div2r; // yz
+    bond_virial[5] = dx.z * dx.z * force_div2r; // zz
+
+    force[0] = make_scalar4(dx.x * force_divr, dx.y * force_divr, dx.z * force_divr, bond_eng * Scalar(0.5));
+    force[1] = make_scalar4(-force[0].x, -force[0].y, -force[0].z, force[0].w);
+    for (unsigned int i = 0; i < 6; ++i)
+        {
+        virial[0][i] = bond_virial[i];
+        virial[1][i] = bond_virial[i];
+        }
+    return true;
+    }
+
+//! Evaluate a harmonic angle
+/*! \param angle Local indices of the a, b and c particles
+    \param params K and t_0
+    \param d_pos Particle positions
+    \param box Box for the minimum image convention
+    \param force Per-member force and energy (output)
+    \param virial Per-member virial (output)
+*/
+__device__ inline void fused_eval_angle(const group_storage<3>& angle,
+                                        const Scalar2 params,
+                                        const Scalar4 *d_pos,
+                                        const BoxDim& box,
+                                        Scalar4 *force,
+                                        Scalar (*virial)[6])
+    {
+    Scalar4 a_postype = d_pos[angle.idx[0]];
+    Scalar4 b_postype = d_pos[angle.idx[1]];
+    Scalar4 c_postype = d_pos[angle.idx[2]];
+    Scalar3 b_pos = make_scalar3(b_postype.x, b_postype.y, b_postype.z);
+
+    // calculate dr for a-b and c-b and apply periodic boundary conditions
+    Scalar3 dab = box.minImage(make_scalar3(a_postype.x, a_postype.y, a_postype.z) - b_pos);
+    Scalar3 dcb = box.minImage(make_scalar3(c_postype.x, c_postype.y, c_postype.z) - b_pos);
+
+    Scalar K = params.x;
+    Scalar t_0 = params.y;
+
+    Scalar rsqab = dot(dab, dab);
+    Scalar rab = sqrtf(rsqab);
+    Scalar rsqcb = dot(dcb, dcb);
+    Scalar rcb = sqrtf(rsqcb);
+
+    Scalar c_abbc = dot(dab, dcb);
+    c_abbc /= rab*rcb;
+
+    if (c_abbc > Scalar(1.0)) c_abbc = Scalar(1.0);
+    if (c_abbc < -Scalar(1.0)) c_abbc = -Scalar(1.0);
+
+    Scalar s_abbc = sqrtf(Scalar(1.0) - c_abbc*c_abbc);
+    if (s_abbc < SMALL) s_abbc = SMALL;
+    s_abbc = Scalar(1.0)/s_abbc;
+
+    // actually calculate the force
+    Scalar dth = fast::acos(c_abbc) - t_0;
+    Scalar tk = K*dth;
+
+    Scalar a = -Scalar(1.0) * tk * s_abbc;
+    Scalar a11 = a*c_abbc/rsqab;
+    Scalar a12 = -a / (rab*rcb);
+    Scalar a22 = a*c_abbc / rsqcb;
+
+    Scalar3 fab = a11*dab + a12*dcb;
+    Scalar3 fcb = a22*dcb + a12*dab;
+
+    // compute 1/3 of the energy, 1/3 for each atom in the angle
+    Scalar angle_eng = tk*dth*Scalar(Scalar(1.0)/Scalar(6.0));
+
+    // upper triangular version of virial tensor, 1/3 for each atom in the angle
+    Scalar angle_virial[6];
+    angle_virial[0] = Scalar(1./3.)*(dab.x*fab.x + dcb.x*fcb.x);
+    angle_virial[1] = Scalar(1./3.)*(dab.y*fab.x + dcb.y*fcb.x);
+    angle_virial[2] = Scalar(1./3.)*(dab.z*fab.x + dcb.z*fcb.x);
+    angle_virial[3] = Scalar(1./3.)*(dab.y*fab.y + dcb.y*fcb.y);
+    angle_virial[4] = Scalar(1./3.)*(dab.z*fab.y + dcb.z*fcb.y);
+    angle_virial[5] = Scalar(1./3.)*(dab.z*fab.z + dcb.z*fcb.z);
+
+    force[0] = make_scalar4(fab.x, fab.y, fab.z, angle_eng);
+    force[1] = make_scalar4(-fab.x - fcb.x, -fab.y - fcb.y, -fab.z - fcb.z, angle_eng);
+    force[2] = make_scalar4(fcb.x, fcb.y, fcb.z, angle_eng);
+    for (unsigned int m = 0; m < 3; ++m)
+        for (unsigned int i = 0; i < 6; ++i)
+            virial[m][i] = angle_virial[i];
+    }
+
+//! Evaluate an OPLS dihedral
+/*! \param dihedral Local indices of the a, b, c and d particles
+    \param params k1/2, k2/2, k3/2 and k4/2
+    \param d_pos Particle positions
+    \param box Box for the minimum image convention
+    \param force Per-member force and energy (output)
+    \param virial Per-member virial (output)
+*/
+__device__ inline void fused_eval_dihedral(const group_storage<4>& dihedral,
+                                           const Scalar4 params,
+                                           const Scalar4 *d_pos,
+                                           const BoxDim& box,
+                                           Scalar4 *force,
+                                           Scalar (*virial)[6])
+    {
+    Scalar4 a_postype = d_pos[dihedral.idx[0]];
+    Scalar4 b_postype = d_pos[dihedral.idx[1]];
+    Scalar4 c_postype = d_pos[dihedral.idx[2]];
+    Scalar4 d_postype = d_pos[dihedral.idx[3]];
+    Scalar3 pos_a = make_scalar3(a_postype.x, a_postype.y, a_postype.z);
+    Scalar3 pos_b = make_scalar3(b_postype.x, b_postype.y, b_postype.z);
+    Scalar3 pos_c = make_scalar3(c_postype.x, c_postype.y, c_postype.z);
+    Scalar3 pos_d = make_scalar3(d_postype.x, d_postype.y, d_postype.z);
+
+    // the three bonds, with periodic boundary conditions
+    Scalar3 vb1 = box.minImage(pos_a - pos_b);
+    Scalar3 vb2 = box.minImage(pos_c - pos_b);
+    Scalar3 vb3 = box.minImage(pos_d - pos_c);
+
+    Scalar3 vb2m = -vb2;
+    vb2m = box.minImage(vb2m);
+
+    // c,s calculation
+    Scalar ax, ay, az, bx, by, bz;
+    ax = vb1.y*vb2m.z - vb1.z*vb2m.y;
+    ay = vb1.z*vb2m.x - vb1.x*vb2m.z;
+    az = vb1.x*vb2m.y - vb1.y*vb2m.x;
+    bx = vb3.y*vb2m.z - vb3.z*vb2m.y;
+    by = vb3.z*vb2m.x - vb3.x*vb2m.z;
+    bz = vb3.x*vb2m.y - vb3.y*vb2m.x;
+
+    Scalar rasq = ax*ax + ay*ay + az*az;
+    Scalar rbsq = bx*bx + by*by + bz*bz;
+    Scalar rgsq = vb2m.x*vb2m.x + vb2m.y*vb2m.y + vb2m.z*vb2m.z;
+    Scalar rg = fast::sqrt(rgsq);
+
+    Scalar rginv, ra2inv, rb2inv;
+    rginv = ra2inv = rb2inv = 0.0;
+    if (rg > 0) rginv = 1.0/rg;
+    if (rasq > 0) ra2inv = 1.0/rasq;
+    if (rbsq > 0) rb2inv = 1.0/rbsq;
+    Scalar rabinv = fast::sqrt(ra2inv*rb2inv);
+
+    Scalar c = (ax*bx + ay*by + az*bz)*rabinv;
+    Scalar s = rg*rabinv*(ax*vb3.x + ay*vb3.y + az*vb3.z);
+
+    if (c > 1.0) c = 1.0;
+    if (c < -1.0) c = -1.0;
+
+    // the 1/2 factor is already stored in the parameters
+    Scalar k1 = params.x;
+    Scalar k2 = params.y;
+    Scalar k3 = params.z;
+    Scalar k4 = params.w;
+
+    // calculate the potential p = sum (i=1,4) k_i * (1 + (-1)**(i+1)*cos(i*phi) )
+    // and df = dp/dc
+
+    // cos(phi) term
+    Scalar ddf1 = c;
+    Scalar df1 = s;
+    Scalar cos_term = ddf1;
+
+    Scalar p = k1 * (1.0 + cos_term);
+    Scalar df = k1*df1;
+
+    // cos(2*phi) term
+    ddf1 = cos_term*c - df1*s;
+    df1 = cos_term*s + df1*c;
+    cos_term = ddf1;
+
+    p += k2 * (1.0 - cos_term);
+    df += -2.0*k2*df1;
+
+    // cos(3*phi) term
+    ddf1 = cos_term*c - df1*s;
+    df1 = cos_term*s + df1*c;
+    cos_term = ddf1;
+
+    p += k3 * (1.0 + cos_term);
+    df += 3.0*k3*df1;
+
+    // cos(4*phi) term
+    ddf1 = cos_term*c - df1*s;
+    df1 = cos_term*s + df1*c;
+    cos_term = ddf1;
+
+    p += k4 * (1.0 - cos_term);
+    df += -4.0*k4*df1;
+
+    // Compute 1/4 of energy to assign to each of 4 atoms in the dihedral
+    Scalar e_dihedral = 0.25*p;
+
+    Scalar fg = vb1.x*vb2m.x + vb1.y*vb2m.y + vb1.z*vb2m.z;
+    Scalar hg = vb3.x*vb2m.x + vb3.y*vb2m.y + vb3.z*vb2m.z;
+    Scalar fga = fg*ra2inv*rginv;
+    Scalar hgb = hg*rb2inv*rginv;
+    Scalar gaa = -ra2inv*rg;
+    Scalar gbb = rb2inv*rg;
+
+    Scalar sx2 = df*(fga*ax - hgb*bx);
+    Scalar sy2 = df*(fga*ay - hgb*by);
+    Scalar sz2 = df*(fga*az - hgb*bz);
+
+    Scalar3 f1 = make_scalar3(df*gaa*ax, df*gaa*ay, df*gaa*az);
+    Scalar3 f4 = make_scalar3(df*gbb*bx, df*gbb*by, df*gbb*bz);
+    Scalar3 f2 = make_scalar3(sx2 - f1.x, sy2 - f1.y, sz2 - f1.z);
+    Scalar3 f3 = make_scalar3(-sx2 - f4.x, -sy2 - f4.y, -sz2 - f4.z);
+
+    // Compute 1/4 of the virial, 1/4 for each atom in the dihedral
+    // upper triangular version of virial tensor
+    Scalar dihedral_virial[6];
+    dihedral_virial[0] = 0.25*(vb1.x*f1.x + vb2.x*f3.x + (vb3.x+vb2.x)*f4.x);
+    dihedral_virial[1] = 0.25*(vb1.y*f1.x + vb2.y*f3.x + (vb3.y+vb2.y)*f4.x);
+    dihedral_virial[2] = 0.25*(vb1.z*f1.x + vb2.z*f3.x + (vb3.z+vb2.z)*f4.x);
+    dihedral_virial[3] = 0.25*(vb1.y*f1.y + vb2.y*f3.y + (vb3.y+vb2.y)*f4.y);
+    dihedral_virial[4] = 0.25*(vb1.z*f1.y + vb2.z*f3.y + (vb3.z+vb2.z)*f4.y);
+    dihedral_virial[5] = 0.25*(vb1.z*f1.z + vb2.z*f3.z + (vb3.z+vb2.z)*f4.z);
+
+    force[0] = make_scalar4(f1.x, f1.y, f1.z, e_dihedral);
+    force[1] = make_scalar4(f2.x, f2.y, f2.z, e_dihedral);
+    force[2] = make_scalar4(f3.x, f3.y, f3.z, e_dihedral);
+    force[3] = make_scalar4(f4.x, f4.y, f4.z, e_dihedral);
+    for (unsigned int m = 0; m < 4; ++m)
+        for (unsigned int i = 0; i < 6; ++i)
+            virial[m][i] = dihedral_virial[i];
+    }
+
+//! Kernel for calculating all bonded forces in one pass
+/*! \param d_force Device memory to add the computed forces to
+    \param d_virial Device memory to add the computed virials to
+    \param virial_pitch Pitch of 2D virial array
+    \param N number of local particles
+    \param d_pos device array of particle positions
+    \param box Box dimensions for periodic boundary condition handling
+    \param args Group-centric tables and parameters of the bonded terms
+    \param d_flags Set to 1 if a bond cannot be evaluated
+
+    The threads are assigned to the bonds, then the angles, then the dihedrals, with every range padded to a
+    multiple of the warp size. Each warp thus handles a single kind of term and calls gpu_group_force_scatter()
+    with a uniform group size.
+*/
+__global__ void gpu_compute_fused_bonded_forces_kernel(Scalar4* d_force,
+                                                       Scalar* d_virial,
+                                                       const unsigned int virial_pitch,
+                                                       const unsigned int N,
+                                                       const Scalar4 *d_pos,
+                                                       BoxDim box,
+                                                       const fused_bonded_args_t args,
+                                                       unsigned int *d_flags)
+    {
+    unsigned int t = blockIdx.x * blockDim.x + threadIdx.x;
+
+    const unsigned int bond_end = fused_bonded_warp_round(args.n_bonds);
+    const unsigned int angle_end = bond_end + fused_bonded_warp_round(args.n_angles);
+
+    if (t < bond_end)
+        {
+        unsigned int idx[2] = {NOT_LOCAL, NOT_LOCAL};
+        Scalar4 force[2];
+        Scalar virial[2][6];
+
+        if (t < args.n_bonds)
+            {
+            group_storage<2> bond = args.d_bonds[t];
+            if (fused_eval_bond(bond, args.d_bond_params[args.d_bond_type[t]], d_pos, box, force, virial))
+                {
+                for (unsigned int m = 0; m < 2; ++m)
+                    idx[m] = bond.idx[m];
+                }
+            else
+                {
+                *d_flags = 1;
+                }
+            }
+
+        gpu_group_force_scatter<2>(idx, force, virial, N, d_force, d_virial, virial_pitch);
+        }
+    else if (t < angle_end)
+        {
+        t -= bond_end;
+
+        unsigned int idx[3] = {NOT_LOCAL, NOT_LOCAL, NOT_LOCAL};
+        Scalar4 force[3];
+        Scalar virial[3][6];
+
+        if (t < args.n_angles)
+            {
+            group_storage<3> angle = args.d_angles[t];
+            fused_eval_angle(angle, args.d_angle_params[args.d_angle_type[t]], d_pos, box, force, virial);
+            for (unsigned int m = 0; m < 3; ++m)
+                idx[m] = angle.idx[m];
+            }
+
+        gpu_group_force_scatter<3>(idx, force, virial, N, d_force, d_virial, virial_pitch);
+        }
+    else
+        {
+        t -= angle_end;
+
+        unsigned int idx[4] = {NOT_LOCAL, NOT_LOCAL, NOT_LOCAL, NOT_LOCAL};
+        Scalar4 force[4];
+        Scalar virial[4][6];
+
+        if (t < args.n_dihedrals)
+            {
+            group_storage<4> dihedral = args.d_dihedrals[t];
+            fused_eval_dihedral(dihedral, args.d_dihedral_params[args.d_dihedral_type[t]], d_pos, box, force,
+                                virial);
+            for (unsigned int m = 0; m < 4; ++m)
+                idx[m] = dihedral.idx[m];
+            }
+
+        gpu_group_force_scatter<4>(idx, force, virial, N, d_force, d_virial, virial_pitch);
+        }
+    }
+
+/*! \param d_force Device memory to write computed forces
+    \param d_virial Device memory to write computed virials
+    \param virial_pitch pitch of 2D virial array
+    \param N number of local particles
+    \param d_pos particle positions on the GPU
+    \param box Box dimensions (in GPU format) to use for periodic boundary conditions
+    \param args Group-centric tables and parameters of the bonded terms
+    \param d_flags Set to 1 if a bond cannot be evaluated
+    \param block_size Block size to use when performing calculations
+
+    \returns Any error code resulting from the kernel launch
+    \note Always returns cudaSuccess in release builds to avoid the cudaThreadSynchronize()
+
+    The force and virial arrays are zeroed before the kernel adds the contributions of all terms.
+*/
+cudaError_t gpu_compute_fused_bonded_forces(Scalar4* d_force,
+                                            Scalar* d_virial,
+                                            const unsigned int virial_pitch,
+                                            const unsigned int N,
+                                            const Scalar4 *d_pos,
+                                            const BoxDim& box,
+                                            const fused_bonded_args_t& args,
+                                            unsigned int *d_flags,
+                                            const unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void *)gpu_compute_fused_bonded_forces_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    // the warp-level scatter needs complete warps
+    unsigned int run_block_size = min(block_size, max_block_size) & ~31u;
+
+    unsigned int n_threads = fused_bonded_warp_round(args.n_bonds) + fused_bonded_warp_round(args.n_angles)
+                             + fused_bonded_warp_round(args.n_dihedrals);
+
+    cudaMemset(d_force, 0, sizeof(Scalar4)*N);
+    cudaMemset(d_virial, 0, sizeof(Scalar)*6*virial_pitch);
+
+    if (n_threads == 0)
+        return cudaSuccess;
+
+    // setup the grid to run the kernel
+    dim3 grid( n_threads / run_block_size + 1, 1, 1);
+    dim3 threads(run_block_size, 1, 1);
+
+    gpu_compute_fused_bonded_forces_kernel<<< grid, threads>>>(d_force, d_virial, virial_pitch, N, d_pos, box, args,
+                                                               d_flags);
+
+    return cudaSuccess;
+    }
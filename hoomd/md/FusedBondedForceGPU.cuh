@@ -0,0 +1,51 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "hoomd/ParticleData.cuh"
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/BondedGroupData.cuh"
+
+/*! \file FusedBondedForceGPU.cuh
+    \brief Declares GPU kernel code for the fused bonded force computation. Used by FusedBondedForceComputeGPU.
+*/
+
+#ifndef __FUSEDBONDEDFORCEGPU_CUH__
+#define __FUSEDBONDEDFORCEGPU_CUH__
+
+//! Group-centric tables of the bonded terms evaluated by the fused kernel
+struct fused_bonded_args_t
+    {
+    const group_storage<2> *d_bonds;        //!< Local member indices of the bonds
+    const unsigned int *d_bond_type;        //!< Types of the bonds
+    unsigned int n_bonds;                   //!< Number of bonds (0 to skip bonds)
+    const Scalar2 *d_bond_params;           //!< Harmonic bond parameters k, r0 per type
+    unsigned int n_bond_types;              //!< Number of bond types
+
+    const group_storage<3> *d_angles;       //!< Local member indices of the angles
+    const unsigned int *d_angle_type;       //!< Types of the angles
+    unsigned int n_angles;                  //!< Number of angles (0 to skip angles)
+    const Scalar2 *d_angle_params;          //!< Harmonic angle parameters k, t0 per type
+    unsigned int n_angle_types;             //!< Number of angle types
+
+    const group_storage<4> *d_dihedrals;    //!< Local member indices of the dihedrals
+    const unsigned int *d_dihedral_type;    //!< Types of the dihedrals
+    unsigned int n_dihedrals;               //!< Number of dihedrals (0 to skip dihedrals)
+    const Scalar4 *d_dihedral_params;       //!< OPLS dihedral parameters k1/2 .. k4/2 per type
+    unsigned int n_dihedral_types;          //!< Number of dihedral types
+    };
+
+//! Kernel driver that computes all bonded forces of FusedBondedForceComputeGPU in one kernel
+cudaError_t gpu_compute_fused_bonded_forces(Scalar4* d_force,
+                                            Scalar* d_virial,
+                                            const unsigned int virial_pitch,
+                                            const unsigned int N,
+                                            const Scalar4 *d_pos,
+                                            const BoxDim& box,
+                                            const fused_bonded_args_t& args,
+                                            unsigned int *d_flags,
+                                            const unsigned int block_size);
+
+#endif
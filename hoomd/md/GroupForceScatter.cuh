@@ -0,0 +1,150 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/ParticleData.cuh"
+#include "hoomd/WarpTools.cuh"
+
+/*! \file GroupForceScatter.cuh
+    \brief Device functions for the group-centric evaluation of bonded forces
+    \details In the group-centric mode, every bonded group is evaluated once by one thread, which adds the forces,
+    energies and virials of all members to the per-particle arrays. The arrays must be zeroed before the kernel.
+*/
+
+#ifndef __GROUP_FORCE_SCATTER_CUH__
+#define __GROUP_FORCE_SCATTER_CUH__
+
+#ifdef NVCC
+//! Atomically add to a Scalar in global memory
+/*! \param address Address to add to
+    \param val Value to add
+*/
+__device__ inline void group_force_atomic_add(float *address, float val)
+    {
+    atomicAdd(address, val);
+    }
+
+//! Atomically add to a Scalar in global memory
+/*! \param address Address to add to
+    \param val Value to add
+*/
+__device__ inline void group_force_atomic_add(double *address, double val)
+    {
+    #if (__CUDA_ARCH__ >= 600)
+    atomicAdd(address, val);
+    #else
+    unsigned long long int* address_as_ull = (unsigned long long int*)address;
+    unsigned long long int old = *address_as_ull, assumed;
+
+    do {
+        assumed = old;
+        old = atomicCAS(address_as_ull, assumed, __double_as_longlong(val + __longlong_as_double(assumed)));
+    } while (assumed != old);
+    #endif
+    }
+
+//! Scatter the forces, energies and virials of a group to its members with warp-aggregated atomics
+/*! \param idx Local indices of the group members, NOT_LOCAL for threads without a group
+    \param force Per-member force (xyz) and energy (w), modified
+    \param virial Per-member virial, modified
+    \param N Number of local particles, only local members are written
+    \param d_force Per-particle forces to add to
+    \param d_virial Per-particle virials to add to
+    \param virial_pitch Pitch of the virial array
+
+    Before the atomic adds, contributions to the same particle are combined across the lanes of the warp in a tree:
+    in the round with stride s, every lane with (lane % 2s) == s hands the contributions of its members that are
+    also members of the group on lane - s to that lane. Lanes that received contributions keep them for the next
+    round, so a particle shared by several groups in the warp is written with a single atomic add per component.
+    Groups are sorted by their smallest member index, so groups sharing a particle are often close in the warp.
+
+    All threads of the warp must call this function, the block size must be a multiple of 32.
+
+    \tparam group_size Number of members per group
+*/
+template<unsigned int group_size>
+__device__ inline void gpu_group_force_scatter(const unsigned int *idx,
+                                               Scalar4 *force,
+                                               Scalar (*virial)[6],
+                                               const unsigned int N,
+                                               Scalar4 *d_force,
+                                               Scalar *d_virial,
+                                               const unsigned int virial_pitch)
+    {
+    typedef hoomd::detail::WarpScan<unsigned int> WarpScanUInt;
+    typedef hoomd::detail::WarpScan<Scalar> WarpScanScalar;
+
+    const unsigned int lane = threadIdx.x % 32;
+
+    // the member slots handed to another lane are not written
+    bool written[group_size];
+    for (unsigned int m = 0; m < group_size; ++m)
+        written[m] = (idx[m] < N);
+
+    for (unsigned int s = 1; s < 32; s *= 2)
+        {
+        const bool giver = (lane % (2*s)) == s;
+        const bool receiver = (lane % (2*s)) == 0;
+
+        // exchange the members between the lanes of this round, every lane reads from its own partner lane
+        const unsigned int partner = giver ? lane - s : (lane + s) % 32;
+
+        for (unsigned int k = 0; k < group_size; ++k)
+            {
+            // member k of the partner's group
+            unsigned int partner_idx = WarpScanUInt().Broadcast(written[k] ? idx[k] : NOT_LOCAL, partner);
+
+            // find the matching member of this group
+            int match = -1;
+            for (unsigned int m = 0; m < group_size; ++m)
+                if (partner_idx != NOT_LOCAL && written[m] && idx[m] == partner_idx)
+                    match = m;
+
+            // the giver drops its member k if the receiver has it
+            unsigned int receiver_match = WarpScanUInt().Broadcast((unsigned int)(match + 1), partner);
+
+            // move the contribution of member k of the giver to the matching member of the receiver
+            Scalar v[10];
+            v[0] = force[k].x; v[1] = force[k].y; v[2] = force[k].z; v[3] = force[k].w;
+            for (unsigned int i = 0; i < 6; ++i)
+                v[4+i] = virial[k][i];
+
+            for (unsigned int i = 0; i < 10; ++i)
+                v[i] = WarpScanScalar().Broadcast(v[i], partner);
+
+            if (receiver && match >= 0)
+                {
+                force[match].x += v[0];
+                force[match].y += v[1];
+                force[match].z += v[2];
+                force[match].w += v[3];
+                for (unsigned int i = 0; i < 6; ++i)
+                    virial[match][i] += v[4+i];
+                }
+
+            if (giver && written[k] && receiver_match > 0)
+                written[k] = false;
+            }
+        }
+
+    // write out the remaining contributions
+    for (unsigned int m = 0; m < group_size; ++m)
+        {
+        if (!written[m])
+            continue;
+
+        unsigned int j = idx[m];
+        group_force_atomic_add(&d_force[j].x, force[m].x);
+        group_force_atomic_add(&d_force[j].y, force[m].y);
+        group_force_atomic_add(&d_force[j].z, force[m].z);
+        group_force_atomic_add(&d_force[j].w, force[m].w);
+        for (unsigned int i = 0; i < 6; ++i)
+            group_force_atomic_add(&d_virial[i*virial_pitch + j], virial[m][i]);
+        }
+    }
+#endif // NVCC
+
+#endif // __GROUP_FORCE_SCATTER_CUH__
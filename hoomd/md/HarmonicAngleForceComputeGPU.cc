@@ -19,7 +19,7 @@ using namespace std;
 /*! \param sysdef System to compute angle forces on
 */
 HarmonicAngleForceComputeGPU::HarmonicAngleForceComputeGPU(std::shared_ptr<SystemDefinition> sysdef)
-        : HarmonicAngleForceCompute(sysdef)
+        : HarmonicAngleForceCompute(sysdef), m_group_centric(false)
     {
     // can't run on the GPU if there aren't any GPUs in the execution configuration
     if (!m_exec_conf->isCUDAEnabled())
@@ -29,9 +29,20 @@ HarmonicAngleForceComputeGPU::HarmonicAngleForceComputeGPU(std::shared_ptr<Syste
         }
 
     // allocate and zero device memory
-    GPUArray<Scalar2> params(m_angle_data->getNTypes(), m_exec_conf);
+    GlobalArray<Scalar2> params(m_angle_data->getNTypes(), m_exec_conf);
     m_params.swap(params);
 
+    if (m_exec_conf->allConcurrentManagedAccess())
+        {
+        // the parameters are read by every GPU
+        auto& gpu_map = m_exec_conf->getGPUIds();
+
+        cudaMemAdvise(m_params.get(), m_params.getNumElements()*sizeof(Scalar2), cudaMemAdviseSetReadMostly, 0);
+        for (unsigned int idev = 0; idev < m_exec_conf->getNumActiveGPUs(); ++idev)
+            cudaMemPrefetchAsync(m_params.get(), m_params.getNumElements()*sizeof(Scalar2), gpu_map[idev]);
+        CHECK_CUDA_ERROR();
+        }
+
     m_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "harmonic_angle", this->m_exec_conf));
     }
 
@@ -67,6 +78,13 @@ void HarmonicAngleForceComputeGPU::computeForces(unsigned int timestep)
     // start the profile
     if (m_prof) m_prof->push(m_exec_conf, "Harmonic Angle");
 
+    if (m_group_centric)
+        {
+        computeForcesGroupCentric();
+        if (m_prof) m_prof->pop(m_exec_conf);
+        return;
+        }
+
     // the angle table is up to date: we are good to go. Call the kernel
     ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
 
@@ -81,6 +99,7 @@ void HarmonicAngleForceComputeGPU::computeForces(unsigned int timestep)
     ArrayHandle<unsigned int> d_gpu_n_angles(m_angle_data->getNGroupsArray(), access_location::device, access_mode::read);
 
     // run the kernel on the GPU
+    m_exec_conf->beginMultiGPU();
     m_tuner->begin();
     gpu_compute_harmonic_angle_forces(d_force.data,
                                       d_virial.data,
@@ -95,18 +114,60 @@ void HarmonicAngleForceComputeGPU::computeForces(unsigned int timestep)
                                       d_params.data,
                                       m_angle_data->getNTypes(),
                                       m_tuner->getParam(),
-                                      m_exec_conf->getComputeCapability());
+                                      m_exec_conf->getComputeCapability(),
+                                      m_pdata->getGPUPartition());
 
     if(m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
     m_tuner->end();
+    m_exec_conf->endMultiGPU();
 
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+/*! Evaluates every angle of the group-centric table once, see gpu_compute_harmonic_angle_forces_group().
+*/
+void HarmonicAngleForceComputeGPU::computeForcesGroupCentric()
+    {
+    // build the table before the particle data is acquired
+    const GPUVector<AngleData::members_t>& group_list = m_angle_data->getGPUGroupList();
+    const GPUVector<unsigned int>& group_list_type = m_angle_data->getGPUGroupListTypes();
+
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+
+    BoxDim box = m_pdata->getGlobalBox();
+
+    ArrayHandle<Scalar4> d_force(m_force,access_location::device,access_mode::overwrite);
+    ArrayHandle<Scalar> d_virial(m_virial,access_location::device,access_mode::overwrite);
+    ArrayHandle<Scalar2> d_params(m_params, access_location::device, access_mode::read);
+
+    ArrayHandle<AngleData::members_t> d_group_list(group_list, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_group_list_type(group_list_type, access_location::device, access_mode::read);
+
+    m_tuner->begin();
+    gpu_compute_harmonic_angle_forces_group(d_force.data,
+                                            d_virial.data,
+                                            m_virial.getPitch(),
+                                            m_pdata->getN(),
+                                            d_pos.data,
+                                            box,
+                                            d_group_list.data,
+                                            d_group_list_type.data,
+                                            group_list.size(),
+                                            d_params.data,
+                                            m_angle_data->getNTypes(),
+                                            m_tuner->getParam(),
+                                            m_exec_conf->getComputeCapability());
+
+    if(m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+    m_tuner->end();
+    }
+
 void export_HarmonicAngleForceComputeGPU(py::module& m)
     {
     py::class_<HarmonicAngleForceComputeGPU, std::shared_ptr<HarmonicAngleForceComputeGPU> >(m, "HarmonicAngleForceComputeGPU", py::base<HarmonicAngleForceCompute>())
     .def(py::init< std::shared_ptr<SystemDefinition> >())
+    .def("setGroupCentric", &HarmonicAngleForceComputeGPU::setGroupCentric)
     ;
     }
@@ -31,6 +31,9 @@
 
     The GPU kernel can be found in angleforce_kernel.cu.
 
+    In the group-centric mode (setGroupCentric()), every angle is evaluated once by one thread from the
+    group-centric table of AngleData, instead of once per member.
+
     \ingroup computes
 */
 class PYBIND11_EXPORT HarmonicAngleForceComputeGPU : public HarmonicAngleForceCompute
@@ -55,12 +58,24 @@ class PYBIND11_EXPORT HarmonicAngleForceComputeGPU : public HarmonicAngleForceCo
         //! Set the parameters
         virtual void setParams(unsigned int type, Scalar K, Scalar t_0);
 
+        //! Evaluate every angle once
+        /*! \param group_centric True to evaluate the angles with one thread per angle
+        */
+        void setGroupCentric(bool group_centric)
+            {
+            m_group_centric = group_centric;
+            }
+
     protected:
         std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for block size
-        GPUArray<Scalar2>  m_params;          //!< Parameters stored on the GPU
+        GlobalArray<Scalar2> m_params;        //!< Parameters stored on the GPU
+        bool m_group_centric;                 //!< True to evaluate the angles with one thread per angle
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
+
+        //! Compute the forces with one thread per angle
+        void computeForcesGroupCentric();
     };
 
 //! Export the AngleForceComputeGPU class to python
@@ -6,6 +6,7 @@
 
 #include "HarmonicAngleForceGPU.cuh"
 #include "hoomd/TextureTools.h"
+#include "GroupForceScatter.cuh"
 
 #include <assert.h>
 
@@ -30,6 +31,7 @@ scalar2_tex_t angle_params_tex;
     \param alist Angle data to use in calculating the forces
     \param pitch Pitch of 2D angles list
     \param n_angles_list List of numbers of angles stored on the GPU
+    \param offset Index of the first particle handled by this GPU
 */
 extern "C" __global__ void gpu_compute_harmonic_angle_forces_kernel(Scalar4* d_force,
                                                                     Scalar* d_virial,
@@ -41,7 +43,8 @@ extern "C" __global__ void gpu_compute_harmonic_angle_forces_kernel(Scalar4* d_f
                                                                     const group_storage<3> *alist,
                                                                     const unsigned int *apos_list,
                                                                     const unsigned int pitch,
-                                                                    const unsigned int *n_angles_list)
+                                                                    const unsigned int *n_angles_list,
+                                                                    const unsigned int offset)
     {
     // start by identifying which particle we are to handle
     int idx = blockIdx.x * blockDim.x + threadIdx.x;
@@ -49,6 +52,9 @@ extern "C" __global__ void gpu_compute_harmonic_angle_forces_kernel(Scalar4* d_f
     if (idx >= N)
         return;
 
+    // add offset to get actual particle index
+    idx += offset;
+
     // load in the length of the list for this thread (MEM TRANSFER: 4 bytes)
     int n_angles = n_angles_list[idx];
 
@@ -208,6 +214,7 @@ extern "C" __global__ void gpu_compute_harmonic_angle_forces_kernel(Scalar4* d_f
     \param n_angle_types Number of angle types in d_params
     \param block_size Block size to use when performing calculations
     \param compute_capability Device compute capability (200, 300, 350, ...)
+    \param gpu_partition Load balancing partition of the particles between the GPUs
 
     \returns Any error code resulting from the kernel launch
     \note Always returns cudaSuccess in release builds to avoid the cudaThreadSynchronize()
@@ -228,7 +235,8 @@ cudaError_t gpu_compute_harmonic_angle_forces(Scalar4* d_force,
                                               Scalar2 *d_params,
                                               unsigned int n_angle_types,
                                               int block_size,
-                                              const unsigned int compute_capability)
+                                              const unsigned int compute_capability,
+                                              const GPUPartition& gpu_partition)
     {
     assert(d_params);
 
@@ -242,8 +250,197 @@ cudaError_t gpu_compute_harmonic_angle_forces(Scalar4* d_force,
 
     unsigned int run_block_size = min(block_size, max_block_size);
 
+    dim3 threads(run_block_size, 1, 1);
+
+    // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
+    for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        auto range = gpu_partition.getRangeAndSetGPU(idev);
+        unsigned int nwork = range.second - range.first;
+
+        // setup the grid to run the kernel
+        dim3 grid( nwork / run_block_size + 1, 1, 1);
+
+        // textures are bound per device on pre sm35 devices
+        if (compute_capability < 350)
+            {
+            cudaError_t error = cudaBindTexture(0, angle_params_tex, d_params, sizeof(Scalar2) * n_angle_types);
+            if (error != cudaSuccess)
+                return error;
+            }
+
+        // run the kernel
+        gpu_compute_harmonic_angle_forces_kernel<<< grid, threads>>>(d_force, d_virial, virial_pitch, nwork, d_pos, d_params, box,
+            atable, apos_list, pitch, n_angles_list, range.first);
+        }
+
+    return cudaSuccess;
+    }
+
+//! Kernel for calculating harmonic angle forces with one thread per angle
+/*! \param d_force Device memory to add the computed forces to
+    \param d_virial Device memory to add the computed virials to
+    \param virial_pitch Pitch of 2D virial array
+    \param N number of local particles
+    \param d_pos device array of particle positions
+    \param d_params Parameters for the angle force
+    \param box Box dimensions for periodic boundary condition handling
+    \param d_group_list Local indices of the a, b and c particles of the angles
+    \param d_group_type Types of the angles
+    \param n_groups Number of angles
+
+    Every angle is evaluated once and the forces on all three members are added with gpu_group_force_scatter().
+*/
+extern "C" __global__ void gpu_compute_harmonic_angle_forces_group_kernel(Scalar4* d_force,
+                                                                          Scalar* d_virial,
+                                                                          const unsigned int virial_pitch,
+                                                                          const unsigned int N,
+                                                                          const Scalar4 *d_pos,
+                                                                          const Scalar2 *d_params,
+                                                                          BoxDim box,
+                                                                          const group_storage<3> *d_group_list,
+                                                                          const unsigned int *d_group_type,
+                                                                          const unsigned int n_groups)
+    {
+    // identify the angle this thread handles
+    unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    unsigned int idx[3] = {NOT_LOCAL, NOT_LOCAL, NOT_LOCAL};
+    Scalar4 force[3];
+    Scalar virial[3][6];
+    for (unsigned int m = 0; m < 3; ++m)
+        {
+        force[m] = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
+        for (unsigned int i = 0; i < 6; ++i)
+            virial[m][i] = Scalar(0.0);
+        }
+
+    // threads without an angle still take part in the warp-level scatter
+    if (group_idx < n_groups)
+        {
+        group_storage<3> cur_angle = d_group_list[group_idx];
+        for (unsigned int m = 0; m < 3; ++m)
+            idx[m] = cur_angle.idx[m];
+
+        // get the positions of the a, b and c particles (MEM TRANSFER: 48 bytes)
+        Scalar4 a_postype = d_pos[idx[0]];
+        Scalar4 b_postype = d_pos[idx[1]];
+        Scalar4 c_postype = d_pos[idx[2]];
+        Scalar3 a_pos = make_scalar3(a_postype.x, a_postype.y, a_postype.z);
+        Scalar3 b_pos = make_scalar3(b_postype.x, b_postype.y, b_postype.z);
+        Scalar3 c_pos = make_scalar3(c_postype.x, c_postype.y, c_postype.z);
+
+        // calculate dr for a-b and c-b
+        Scalar3 dab = a_pos - b_pos;
+        Scalar3 dcb = c_pos - b_pos;
+
+        // apply periodic boundary conditions
+        dab = box.minImage(dab);
+        dcb = box.minImage(dcb);
+
+        // get the angle parameters (MEM TRANSFER: 8 bytes)
+        Scalar2 params = texFetchScalar2(d_params, angle_params_tex, d_group_type[group_idx]);
+        Scalar K = params.x;
+        Scalar t_0 = params.y;
+
+        Scalar rsqab = dot(dab, dab);
+        Scalar rab = sqrtf(rsqab);
+        Scalar rsqcb = dot(dcb, dcb);
+        Scalar rcb = sqrtf(rsqcb);
+
+        Scalar c_abbc = dot(dab, dcb);
+        c_abbc /= rab*rcb;
+
+        if (c_abbc > Scalar(1.0)) c_abbc = Scalar(1.0);
+        if (c_abbc < -Scalar(1.0)) c_abbc = -Scalar(1.0);
+
+        Scalar s_abbc = sqrtf(Scalar(1.0) - c_abbc*c_abbc);
+        if (s_abbc < SMALL) s_abbc = SMALL;
+        s_abbc = Scalar(1.0)/s_abbc;
+
+        // actually calculate the force
+        Scalar dth = fast::acos(c_abbc) - t_0;
+        Scalar tk = K*dth;
+
+        Scalar a = -Scalar(1.0) * tk * s_abbc;
+        Scalar a11 = a*c_abbc/rsqab;
+        Scalar a12 = -a / (rab*rcb);
+        Scalar a22 = a*c_abbc / rsqcb;
+
+        Scalar3 fab = a11*dab + a12*dcb;
+        Scalar3 fcb = a22*dcb + a12*dab;
+
+        // compute 1/3 of the energy, 1/3 for each atom in the angle
+        Scalar angle_eng = tk*dth*Scalar(Scalar(1.0)/Scalar(6.0));
+
+        // upper triangular version of virial tensor, 1/3 for each atom in the angle
+        Scalar angle_virial[6];
+        angle_virial[0] = Scalar(1./3.)*(dab.x*fab.x + dcb.x*fcb.x);
+        angle_virial[1] = Scalar(1./3.)*(dab.y*fab.x + dcb.y*fcb.x);
+        angle_virial[2] = Scalar(1./3.)*(dab.z*fab.x + dcb.z*fcb.x);
+        angle_virial[3] = Scalar(1./3.)*(dab.y*fab.y + dcb.y*fcb.y);
+        angle_virial[4] = Scalar(1./3.)*(dab.z*fab.y + dcb.z*fcb.y);
+        angle_virial[5] = Scalar(1./3.)*(dab.z*fab.z + dcb.z*fcb.z);
+
+        force[0] = make_scalar4(fab.x, fab.y, fab.z, angle_eng);
+        force[1] = make_scalar4(-fab.x - fcb.x, -fab.y - fcb.y, -fab.z - fcb.z, angle_eng);
+        force[2] = make_scalar4(fcb.x, fcb.y, fcb.z, angle_eng);
+        for (unsigned int m = 0; m < 3; ++m)
+            for (unsigned int i = 0; i < 6; ++i)
+                virial[m][i] = angle_virial[i];
+        }
+
+    gpu_group_force_scatter<3>(idx, force, virial, N, d_force, d_virial, virial_pitch);
+    }
+
+/*! \param d_force Device memory to write computed forces
+    \param d_virial Device memory to write computed virials
+    \param virial_pitch pitch of 2D virial array
+    \param N number of local particles
+    \param d_pos device array of particle positions
+    \param box Box dimensions (in GPU format) to use for periodic boundary conditions
+    \param d_group_list Local indices of the a, b and c particles of the angles
+    \param d_group_type Types of the angles
+    \param n_groups Number of angles
+    \param d_params K and t_0 params packed as Scalar2 variables
+    \param n_angle_types Number of angle types in d_params
+    \param block_size Block size to use when performing calculations
+    \param compute_capability Device compute capability (200, 300, 350, ...)
+
+    \returns Any error code resulting from the kernel launch
+    \note Always returns cudaSuccess in release builds to avoid the cudaThreadSynchronize()
+
+    The force and virial arrays are zeroed before the kernel adds the contributions of the angles.
+*/
+cudaError_t gpu_compute_harmonic_angle_forces_group(Scalar4* d_force,
+                                                    Scalar* d_virial,
+                                                    const unsigned int virial_pitch,
+                                                    const unsigned int N,
+                                                    const Scalar4 *d_pos,
+                                                    const BoxDim& box,
+                                                    const group_storage<3> *d_group_list,
+                                                    const unsigned int *d_group_type,
+                                                    const unsigned int n_groups,
+                                                    Scalar2 *d_params,
+                                                    unsigned int n_angle_types,
+                                                    int block_size,
+                                                    const unsigned int compute_capability)
+    {
+    assert(d_params);
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void *)gpu_compute_harmonic_angle_forces_group_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    // the warp-level scatter needs complete warps
+    unsigned int run_block_size = min(block_size, max_block_size) & ~31u;
+
     // setup the grid to run the kernel
-    dim3 grid( N / run_block_size + 1, 1, 1);
+    dim3 grid( n_groups / run_block_size + 1, 1, 1);
     dim3 threads(run_block_size, 1, 1);
 
     // bind the texture on pre sm 35 arches
@@ -254,9 +451,12 @@ cudaError_t gpu_compute_harmonic_angle_forces(Scalar4* d_force,
             return error;
         }
 
+    cudaMemset(d_force, 0, sizeof(Scalar4)*N);
+    cudaMemset(d_virial, 0, sizeof(Scalar)*6*virial_pitch);
+
     // run the kernel
-    gpu_compute_harmonic_angle_forces_kernel<<< grid, threads>>>(d_force, d_virial, virial_pitch, N, d_pos, d_params, box,
-        atable, apos_list, pitch, n_angles_list);
+    gpu_compute_harmonic_angle_forces_group_kernel<<< grid, threads>>>(d_force, d_virial, virial_pitch, N, d_pos,
+        d_params, box, d_group_list, d_group_type, n_groups);
 
     return cudaSuccess;
     }
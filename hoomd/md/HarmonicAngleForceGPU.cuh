@@ -7,6 +7,7 @@
 #include "hoomd/BondedGroupData.cuh"
 #include "hoomd/ParticleData.cuh"
 #include "hoomd/HOOMDMath.h"
+#include "hoomd/GPUPartition.cuh"
 
 /*! \file HarmonicAngleForceGPU.cuh
     \brief Declares GPU kernel code for calculating the harmonic angle forces. Used by HarmonicAngleForceComputeGPU.
@@ -29,6 +30,22 @@ cudaError_t gpu_compute_harmonic_angle_forces(Scalar4* d_force,
                                               Scalar2 *d_params,
                                               unsigned int n_angle_types,
                                               int block_size,
-                                              const unsigned int compute_capability);
+                                              const unsigned int compute_capability,
+                                              const GPUPartition& gpu_partition);
+
+//! Kernel driver that computes harmonic angle forces with one thread per angle
+cudaError_t gpu_compute_harmonic_angle_forces_group(Scalar4* d_force,
+                                                    Scalar* d_virial,
+                                                    const unsigned int virial_pitch,
+                                                    const unsigned int N,
+                                                    const Scalar4 *d_pos,
+                                                    const BoxDim& box,
+                                                    const group_storage<3> *d_group_list,
+                                                    const unsigned int *d_group_type,
+                                                    const unsigned int n_groups,
+                                                    Scalar2 *d_params,
+                                                    unsigned int n_angle_types,
+                                                    int block_size,
+                                                    const unsigned int compute_capability);
 
 #endif
@@ -28,9 +28,20 @@ HarmonicDihedralForceComputeGPU::HarmonicDihedralForceComputeGPU(std::shared_ptr
         }
 
     // allocate and zero device memory
-    GPUArray<Scalar4> params(m_dihedral_data->getNTypes(),m_exec_conf);
+    GlobalArray<Scalar4> params(m_dihedral_data->getNTypes(),m_exec_conf);
     m_params.swap(params);
 
+    if (m_exec_conf->allConcurrentManagedAccess())
+        {
+        // the parameters are read by every GPU
+        auto& gpu_map = m_exec_conf->getGPUIds();
+
+        cudaMemAdvise(m_params.get(), m_params.getNumElements()*sizeof(Scalar4), cudaMemAdviseSetReadMostly, 0);
+        for (unsigned int idev = 0; idev < m_exec_conf->getNumActiveGPUs(); ++idev)
+            cudaMemPrefetchAsync(m_params.get(), m_params.getNumElements()*sizeof(Scalar4), gpu_map[idev]);
+        CHECK_CUDA_ERROR();
+        }
+
     m_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "harmonic_dihedral", this->m_exec_conf));
     }
 
@@ -80,6 +91,7 @@ void HarmonicDihedralForceComputeGPU::computeForces(unsigned int timestep)
     ArrayHandle<Scalar4> d_params(m_params, access_location::device, access_mode::read);
 
     // run the kernel in parallel on all GPUs
+    m_exec_conf->beginMultiGPU();
     this->m_tuner->begin();
     gpu_compute_harmonic_dihedral_forces(d_force.data,
                                          d_virial.data,
@@ -94,10 +106,12 @@ void HarmonicDihedralForceComputeGPU::computeForces(unsigned int timestep)
                                          d_params.data,
                                          m_dihedral_data->getNTypes(),
                                          this->m_tuner->getParam(),
-                                         m_exec_conf->getComputeCapability());
+                                         m_exec_conf->getComputeCapability(),
+                                         m_pdata->getGPUPartition());
     if(m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
     this->m_tuner->end();
+    m_exec_conf->endMultiGPU();
 
     if (m_prof) m_prof->pop(m_exec_conf);
     }
@@ -53,7 +53,7 @@ class PYBIND11_EXPORT HarmonicDihedralForceComputeGPU : public HarmonicDihedralF
 
     protected:
         std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for block size
-        GPUArray<Scalar4> m_params;           //!< Parameters stored on the GPU (k,sign,m)
+        GlobalArray<Scalar4> m_params;        //!< Parameters stored on the GPU (k,sign,m)
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
@@ -37,6 +37,7 @@ scalar4_tex_t dihedral_params_tex;
     \param dihedral_ABCD List of relative atom positions in the dihedrals
     \param pitch Pitch of 2D dihedral list
     \param n_dihedrals_list List of numbers of dihedrals per atom
+    \param offset Index of the first particle handled by this GPU
 */
 extern "C" __global__
 void gpu_compute_harmonic_dihedral_forces_kernel(Scalar4* d_force,
@@ -49,7 +50,8 @@ void gpu_compute_harmonic_dihedral_forces_kernel(Scalar4* d_force,
                                                  const group_storage<4> *tlist,
                                                  const unsigned int *dihedral_ABCD,
                                                  const unsigned int pitch,
-                                                 const unsigned int *n_dihedrals_list)
+                                                 const unsigned int *n_dihedrals_list,
+                                                 const unsigned int offset)
     {
     // start by identifying which particle we are to handle
     int idx = blockIdx.x * blockDim.x + threadIdx.x;
@@ -57,6 +59,9 @@ void gpu_compute_harmonic_dihedral_forces_kernel(Scalar4* d_force,
     if (idx >= N)
         return;
 
+    // add offset to get actual particle index
+    idx += offset;
+
     // load in the length of the list for this thread (MEM TRANSFER: 4 bytes)
     int n_dihedrals = n_dihedrals_list[idx];
 
@@ -300,6 +305,7 @@ void gpu_compute_harmonic_dihedral_forces_kernel(Scalar4* d_force,
     \param n_dihedral_types Number of dihedral types in d_params
     \param block_size Block size to use when performing calculations
     \param compute_capability Compute capability of the device (200, 300, 350, ...)
+    \param gpu_partition Load balancing partition of the particles between the GPUs
 
     \returns Any error code resulting from the kernel launch
     \note Always returns cudaSuccess in release builds to avoid the cudaThreadSynchronize()
@@ -320,7 +326,8 @@ cudaError_t gpu_compute_harmonic_dihedral_forces(Scalar4* d_force,
                                                  Scalar4 *d_params,
                                                  unsigned int n_dihedral_types,
                                                  int block_size,
-                                                 const unsigned int compute_capability)
+                                                 const unsigned int compute_capability,
+                                                 const GPUPartition& gpu_partition)
     {
     assert(d_params);
 
@@ -334,20 +341,28 @@ cudaError_t gpu_compute_harmonic_dihedral_forces(Scalar4* d_force,
 
     unsigned int run_block_size = min(block_size, max_block_size);
 
-    // setup the grid to run the kernel
-    dim3 grid( N / run_block_size + 1, 1, 1);
     dim3 threads(run_block_size, 1, 1);
 
-    // bind the texture on pre sm35 devices
-    if (compute_capability < 350)
+    // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
+    for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
         {
-        cudaError_t error = cudaBindTexture(0, dihedral_params_tex, d_params, sizeof(Scalar4) * n_dihedral_types);
-        if (error != cudaSuccess)
-            return error;
-        }
+        auto range = gpu_partition.getRangeAndSetGPU(idev);
+        unsigned int nwork = range.second - range.first;
+
+        // setup the grid to run the kernel
+        dim3 grid( nwork / run_block_size + 1, 1, 1);
 
-    // run the kernel
-    gpu_compute_harmonic_dihedral_forces_kernel<<< grid, threads>>>(d_force, d_virial, virial_pitch, N, d_pos, d_params, box, tlist, dihedral_ABCD, pitch, n_dihedrals_list);
+        // textures are bound per device on pre sm35 devices
+        if (compute_capability < 350)
+            {
+            cudaError_t error = cudaBindTexture(0, dihedral_params_tex, d_params, sizeof(Scalar4) * n_dihedral_types);
+            if (error != cudaSuccess)
+                return error;
+            }
+
+        // run the kernel
+        gpu_compute_harmonic_dihedral_forces_kernel<<< grid, threads>>>(d_force, d_virial, virial_pitch, nwork, d_pos, d_params, box, tlist, dihedral_ABCD, pitch, n_dihedrals_list, range.first);
+        }
 
     return cudaSuccess;
     }
@@ -28,8 +28,19 @@ HarmonicImproperForceComputeGPU::HarmonicImproperForceComputeGPU(std::shared_ptr
         }
 
     // allocate and zero device memory
-    GPUArray<Scalar2> params(m_improper_data->getNTypes(), m_exec_conf);
+    GlobalArray<Scalar2> params(m_improper_data->getNTypes(), m_exec_conf);
     m_params.swap(params);
+
+    if (m_exec_conf->allConcurrentManagedAccess())
+        {
+        // the parameters are read by every GPU
+        auto& gpu_map = m_exec_conf->getGPUIds();
+
+        cudaMemAdvise(m_params.get(), m_params.getNumElements()*sizeof(Scalar2), cudaMemAdviseSetReadMostly, 0);
+        for (unsigned int idev = 0; idev < m_exec_conf->getNumActiveGPUs(); ++idev)
+            cudaMemPrefetchAsync(m_params.get(), m_params.getNumElements()*sizeof(Scalar2), gpu_map[idev]);
+        CHECK_CUDA_ERROR();
+        }
     m_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "harmonic_improper", this->m_exec_conf));
     }
 
@@ -78,6 +89,7 @@ void HarmonicImproperForceComputeGPU::computeForces(unsigned int timestep)
     ArrayHandle<Scalar2> d_params(m_params, access_location::device, access_mode::read);
 
     // run the kernel in parallel on all GPUs
+    m_exec_conf->beginMultiGPU();
     m_tuner->begin();
     gpu_compute_harmonic_improper_forces(d_force.data,
                                          d_virial.data,
@@ -92,10 +104,12 @@ void HarmonicImproperForceComputeGPU::computeForces(unsigned int timestep)
                                          d_params.data,
                                          m_improper_data->getNTypes(),
                                          m_tuner->getParam(),
-                                         m_exec_conf->getComputeCapability());
+                                         m_exec_conf->getComputeCapability(),
+                                         m_pdata->getGPUPartition());
     if(m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
     m_tuner->end();
+    m_exec_conf->endMultiGPU();
 
     if (m_prof) m_prof->pop(m_exec_conf);
     }
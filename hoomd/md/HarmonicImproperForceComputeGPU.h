@@ -57,7 +57,7 @@ class PYBIND11_EXPORT HarmonicImproperForceComputeGPU : public HarmonicImproperF
 
     protected:
         std::unique_ptr<Autotuner> m_tuner;   //!< Autotuner for block size
-        GPUArray<Scalar2>  m_params;          //!< Parameters stored on the GPU (k,chi)
+        GlobalArray<Scalar2> m_params;        //!< Parameters stored on the GPU (k,chi)
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
@@ -6,6 +6,7 @@
 
 #include "hoomd/ParticleData.cuh"
 #include "hoomd/HOOMDMath.h"
+#include "hoomd/GPUPartition.cuh"
 #include "hoomd/BondedGroupData.cuh"
 
 /*! \file HarmonicImproperForceGPU.cuh
@@ -29,6 +30,7 @@ cudaError_t gpu_compute_harmonic_improper_forces(Scalar4* d_force,
                                                  Scalar2 *d_params,
                                                  unsigned int n_improper_types,
                                                  int block_size,
-                                                 const unsigned int compute_capability);
+                                                 const unsigned int compute_capability,
+                                                 const GPUPartition& gpu_partition);
 
 #endif
@@ -10,6 +10,10 @@
 
 #include <memory>
 
+#ifdef ENABLE_CUDA
+#include "TwoStepNVEGPU.cuh"
+#endif
+
 #ifndef __INTEGRATION_METHOD_TWO_STEP_H__
 #define __INTEGRATION_METHOD_TWO_STEP_H__
 
@@ -120,6 +124,20 @@ class PYBIND11_EXPORT IntegrationMethodTwoStep
             {
             }
 
+#ifdef ENABLE_CUDA
+        //! Get the parameters of a first step that IntegratorTwoStep can fuse with other methods
+        /*! \param params Set to the parameters of the velocity Verlet first step of this method
+            \returns true if integrateStepOne() performs only the update described by \a params on the GPU
+
+            Methods that return true may have their integrateStepOne() replaced by a single kernel that updates the
+            groups of several methods. The base class returns false.
+        */
+        virtual bool getFusedStepOneParams(nve_step_one_params& params)
+            {
+            return false;
+            }
+#endif
+
         //! Sets the profiler for the integration method to use
         void setProfiler(std::shared_ptr<Profiler> prof);
 
@@ -11,6 +11,11 @@
 
 #include "IntegratorTwoStep.h"
 
+#ifdef ENABLE_CUDA
+#include "TwoStepNVEGPU.cuh"
+#include <string.h>
+#endif
+
 namespace py = pybind11;
 
 #ifdef ENABLE_MPI
@@ -21,9 +26,21 @@ using namespace std;
 
 IntegratorTwoStep::IntegratorTwoStep(std::shared_ptr<SystemDefinition> sysdef, Scalar deltaT)
     : Integrator(sysdef, deltaT), m_prepared(false), m_gave_warning(false),
-    m_aniso_mode(Automatic)
+    m_aniso_mode(Automatic), m_fuse_step_one(false), m_adaptive_dt(false), m_max_displacement(0),
+    m_max_velocity_change(0), m_dt_min(0), m_dt_max(0), m_dt_growth(1)
     {
     m_exec_conf->msg->notice(5) << "Constructing IntegratorTwoStep" << endl;
+
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        {
+        std::vector<unsigned int> valid_params;
+        for (unsigned int block_size = 32; block_size <= 1024; block_size += 32)
+            valid_params.push_back(block_size);
+
+        m_tuner_fused.reset(new Autotuner(valid_params, 5, 100000, "nve_fused_step_one", this->m_exec_conf));
+        }
+    #endif
     }
 
 IntegratorTwoStep::~IntegratorTwoStep()
@@ -60,6 +77,7 @@ std::vector< std::string > IntegratorTwoStep::getProvidedLogQuantities()
     // Get base class provided log quantities
     result = Integrator::getProvidedLogQuantities();
     combined_result.insert(combined_result.end(), result.begin(), result.end());
+    combined_result.push_back("dt");
 
     // add integrationmethod quantities
     std::vector< std::shared_ptr<IntegrationMethodTwoStep> >::iterator method;
@@ -85,6 +103,10 @@ Scalar IntegratorTwoStep::getLogValue(const std::string& quantity, unsigned int
         log_value = (*method)->getLogValue(quantity,timestep,quantity_flag);
         if (quantity_flag) return log_value;
         }
+
+    if (quantity == "dt")
+        return m_deltaT;
+
     return Integrator::getLogValue(quantity, timestep);
     }
 
@@ -110,8 +132,15 @@ void IntegratorTwoStep::update(unsigned int timestep)
 
     // perform the first step of the integration on all groups
     std::vector< std::shared_ptr<IntegrationMethodTwoStep> >::iterator method;
-    for (method = m_methods.begin(); method != m_methods.end(); ++method)
-        (*method)->integrateStepOne(timestep);
+    #ifdef ENABLE_CUDA
+    if (m_fuse_step_one && m_exec_conf->exec_mode == ExecutionConfiguration::GPU)
+        integrateFusedStepOne(timestep);
+    else
+    #endif
+        {
+        for (method = m_methods.begin(); method != m_methods.end(); ++method)
+            (*method)->integrateStepOne(timestep);
+        }
 
     if (m_prof)
         m_prof->pop();
@@ -164,6 +193,243 @@ void IntegratorTwoStep::update(unsigned int timestep)
 
     if (m_prof)
         m_prof->pop();
+
+    // choose the time step of the next step
+    if (m_adaptive_dt)
+        adaptTimestep();
+    }
+
+#ifdef ENABLE_CUDA
+/*! \param timestep Current time step of the simulation
+
+    Methods that cannot be fused run their own integrateStepOne() first, then the members of all other methods are
+    updated in a single kernel. The groups of the methods are disjoint, so the order does not matter.
+*/
+void IntegratorTwoStep::integrateFusedStepOne(unsigned int timestep)
+    {
+    std::vector< std::shared_ptr<IntegrationMethodTwoStep> > fused;
+    std::vector< nve_step_one_params > fused_params;
+
+    for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
+        {
+        nve_step_one_params params;
+        if (fused.size() < NVE_FUSED_MAX_METHODS && (*method)->getFusedStepOneParams(params))
+            {
+            fused.push_back(*method);
+            fused_params.push_back(params);
+            }
+        else
+            (*method)->integrateStepOne(timestep);
+        }
+
+    if (fused.size() == 0)
+        return;
+
+    if (m_prof)
+        m_prof->push(m_exec_conf, "Fused step 1");
+
+    nve_fused_args_t args;
+    memset(&args, 0, sizeof(args));
+
+    // keep the group member handles alive until the kernel is launched
+    std::vector< std::unique_ptr< ArrayHandle<unsigned int> > > d_group_members;
+    for (unsigned int i = 0; i < fused.size(); ++i)
+        {
+        std::shared_ptr<ParticleGroup> group = fused[i]->getGroup();
+        d_group_members.push_back(std::unique_ptr< ArrayHandle<unsigned int> >(
+            new ArrayHandle<unsigned int>(group->getIndexArray(), access_location::device, access_mode::read)));
+
+        args.d_group_members[i] = d_group_members.back()->data;
+        args.offset[i+1] = args.offset[i] + group->getNumMembers();
+        args.params[i] = fused_params[i];
+        }
+    args.n_methods = fused.size();
+
+        {
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::readwrite);
+        ArrayHandle<int3> d_image(m_pdata->getImages(), access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar4> d_orientation(m_pdata->getOrientationArray(), access_location::device,
+            access_mode::readwrite);
+        ArrayHandle<Scalar4> d_angmom(m_pdata->getAngularMomentumArray(), access_location::device,
+            access_mode::readwrite);
+        ArrayHandle<Scalar3> d_inertia(m_pdata->getMomentsOfInertiaArray(), access_location::device,
+            access_mode::read);
+        ArrayHandle<Scalar4> d_net_torque(m_pdata->getNetTorqueArray(), access_location::device, access_mode::read);
+
+        m_tuner_fused->begin();
+        gpu_nve_fused_step_one(d_pos.data,
+                               d_vel.data,
+                               d_accel.data,
+                               d_image.data,
+                               d_orientation.data,
+                               d_angmom.data,
+                               d_inertia.data,
+                               d_net_torque.data,
+                               args,
+                               m_pdata->getBox(),
+                               m_deltaT,
+                               m_sysdef->getNDimensions() == 2,
+                               m_tuner_fused->getParam());
+        m_tuner_fused->end();
+
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+    }
+#endif
+
+/*! \param max_displacement Largest distance a particle may move in one step (0 for no bound)
+    \param max_velocity_change Largest change of the velocity of a particle in one step (0 for no bound)
+    \param dt_min Smallest time step
+    \param dt_max Largest time step
+    \param growth Largest factor by which the time step may grow from one step to the next
+
+    The time step is adapted from the next call to prepRun() or update() on.
+*/
+void IntegratorTwoStep::setAdaptiveTimestep(Scalar max_displacement,
+                                            Scalar max_velocity_change,
+                                            Scalar dt_min,
+                                            Scalar dt_max,
+                                            Scalar growth)
+    {
+    if (max_displacement < Scalar(0.0) || max_velocity_change < Scalar(0.0)
+        || (max_displacement == Scalar(0.0) && max_velocity_change == Scalar(0.0)))
+        {
+        m_exec_conf->msg->error() << "integrate.mode_standard: The adaptive time step needs a positive "
+                                  << "max_displacement or max_velocity_change" << endl;
+        throw std::runtime_error("Error setting the adaptive time step");
+        }
+
+    if (dt_min <= Scalar(0.0) || dt_max < dt_min)
+        {
+        m_exec_conf->msg->error() << "integrate.mode_standard: The adaptive time step needs 0 < dt_min <= dt_max"
+                                  << endl;
+        throw std::runtime_error("Error setting the adaptive time step");
+        }
+
+    if (growth < Scalar(1.0))
+        {
+        m_exec_conf->msg->error() << "integrate.mode_standard: The growth factor of the adaptive time step must be "
+                                  << "at least 1" << endl;
+        throw std::runtime_error("Error setting the adaptive time step");
+        }
+
+    m_adaptive_dt = true;
+    m_max_displacement = max_displacement;
+    m_max_velocity_change = max_velocity_change;
+    m_dt_min = dt_min;
+    m_dt_max = dt_max;
+    m_dt_growth = growth;
+
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled() && m_max_vel_accel.isNull())
+        {
+        GPUArray<unsigned int> max_vel_accel(2, m_exec_conf);
+        m_max_vel_accel.swap(max_vel_accel);
+        }
+    #endif
+    }
+
+/*! The largest speed and acceleration are taken over the members of all integration methods. Particles that are
+    not integrated keep stale accelerations and do not move, so they are left out.
+*/
+void IntegratorTwoStep::adaptTimestep()
+    {
+    if (m_prof)
+        m_prof->push(m_exec_conf, "Adaptive dt");
+
+    // largest squared speed and acceleration
+    double max_vel_accel[2] = {0.0, 0.0};
+
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        {
+            {
+            ArrayHandle<unsigned int> d_max_vel_accel(m_max_vel_accel, access_location::device, access_mode::overwrite);
+            ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::read);
+            ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::read);
+
+            cudaMemset(d_max_vel_accel.data, 0, 2*sizeof(unsigned int));
+
+            for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
+                {
+                std::shared_ptr<ParticleGroup> group = (*method)->getGroup();
+                if (group->getNumMembers() == 0)
+                    continue;
+
+                ArrayHandle<unsigned int> d_index(group->getIndexArray(), access_location::device, access_mode::read);
+                gpu_nve_max_vel_accel(d_max_vel_accel.data,
+                                      d_vel.data,
+                                      d_accel.data,
+                                      d_index.data,
+                                      group->getNumMembers(),
+                                      256);
+                }
+
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            }
+
+        ArrayHandle<unsigned int> h_max_vel_accel(m_max_vel_accel, access_location::host, access_mode::read);
+        float v2, a2;
+        memcpy(&v2, &h_max_vel_accel.data[0], sizeof(float));
+        memcpy(&a2, &h_max_vel_accel.data[1], sizeof(float));
+        max_vel_accel[0] = v2;
+        max_vel_accel[1] = a2;
+        }
+    else
+    #endif
+        {
+        ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::read);
+
+        for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
+            {
+            std::shared_ptr<ParticleGroup> group = (*method)->getGroup();
+            for (unsigned int group_idx = 0; group_idx < group->getNumMembers(); group_idx++)
+                {
+                unsigned int j = group->getMemberIndex(group_idx);
+                Scalar4 v = h_vel.data[j];
+                Scalar3 a = h_accel.data[j];
+                max_vel_accel[0] = std::max(max_vel_accel[0], double(v.x*v.x + v.y*v.y + v.z*v.z));
+                max_vel_accel[1] = std::max(max_vel_accel[1], double(a.x*a.x + a.y*a.y + a.z*a.z));
+                }
+            }
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, max_vel_accel, 2, MPI_DOUBLE, MPI_MAX, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    double v = sqrt(max_vel_accel[0]);
+    double a = sqrt(max_vel_accel[1]);
+    double dt = std::min(double(m_dt_max), double(m_dt_growth) * double(m_deltaT));
+
+    // largest time step with v dt + a dt^2 / 2 <= max_displacement, written to be stable for a -> 0
+    if (m_max_displacement > Scalar(0.0) && v + a > 0.0)
+        {
+        double dx = m_max_displacement;
+        dt = std::min(dt, 2.0 * dx / (v + sqrt(v*v + 2.0 * a * dx)));
+        }
+
+    if (m_max_velocity_change > Scalar(0.0) && a > 0.0)
+        dt = std::min(dt, double(m_max_velocity_change) / a);
+
+    dt = std::max(dt, double(m_dt_min));
+
+    if (Scalar(dt) != m_deltaT)
+        setDeltaT(Scalar(dt));
+
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
     }
 
 /*! \param deltaT new deltaT to set
@@ -341,6 +607,19 @@ void IntegratorTwoStep::setAnisotropicMode(AnisotropicMode mode)
 */
 void IntegratorTwoStep::prepRun(unsigned int timestep)
     {
+    // the slow forces only add to the virial on outer steps, methods that couple the box to the pressure would see
+    // a pressure that jumps every m_slow_period steps
+    if (m_slow_period > 1)
+        {
+        PDataFlags flags = getRequestedPDataFlags();
+        if (flags[pdata_flag::isotropic_virial] || flags[pdata_flag::pressure_tensor])
+            {
+            m_exec_conf->msg->error() << "integrate.mode_standard: slow_period > 1 is not supported with integration "
+                                         "methods that couple to the pressure (npt, nph)" << endl;
+            throw runtime_error("Error initializing the integrator");
+            }
+        }
+
     bool aniso = false;
 
     // set (an-)isotropic integration mode
@@ -370,6 +649,8 @@ void IntegratorTwoStep::prepRun(unsigned int timestep)
 #ifdef ENABLE_MPI
     if (m_comm)
         {
+        checkHalfShell();
+
         // force particle migration and ghost exchange
         m_comm->forceMigrate();
 
@@ -400,6 +681,10 @@ void IntegratorTwoStep::prepRun(unsigned int timestep)
     for (auto method = m_methods.begin(); method != m_methods.end(); ++method)
         (*method)->randomizeVelocities(timestep);
 
+    // choose the time step of the first step
+    if (m_adaptive_dt)
+        adaptTimestep();
+
     m_prepared = true;
     }
 
@@ -453,6 +738,15 @@ void IntegratorTwoStep::updateRigidBodies(unsigned int timestep)
 void IntegratorTwoStep::setAutotunerParams(bool enable, unsigned int period)
     {
     Integrator::setAutotunerParams(enable, period);
+
+    #ifdef ENABLE_CUDA
+    if (m_tuner_fused)
+        {
+        m_tuner_fused->setPeriod(period);
+        m_tuner_fused->setEnabled(enable);
+        }
+    #endif
+
     // set params in all methods
     std::vector< std::shared_ptr<IntegrationMethodTwoStep> >::iterator method;
     for (method = m_methods.begin(); method != m_methods.end(); ++method)
@@ -469,6 +763,9 @@ void export_IntegratorTwoStep(py::module& m)
         .def("addForceComposite", &IntegratorTwoStep::addForceComposite)
         .def("removeForceComputes", &IntegratorTwoStep::removeForceComputes)
         .def("initializeIntegrationMethods", &IntegratorTwoStep::initializeIntegrationMethods)
+        .def("setFuseStepOne", &IntegratorTwoStep::setFuseStepOne)
+        .def("setAdaptiveTimestep", &IntegratorTwoStep::setAdaptiveTimestep)
+        .def("disableAdaptiveTimestep", &IntegratorTwoStep::disableAdaptiveTimestep)
         ;
 
     py::enum_<IntegratorTwoStep::AnisotropicMode>(m,"IntegratorAnisotropicMode")
@@ -20,6 +20,10 @@
 #error This header cannot be compiled by nvcc
 #endif
 
+#ifdef ENABLE_CUDA
+#include "hoomd/Autotuner.h"
+#endif
+
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 
 //! Integrates the system forward one step with possibly multiple methods
@@ -39,6 +43,19 @@
     one and two, and which can use the updated particle positions and velocities to update any slaved degrees
     of freedom (rigid bodies).
 
+    With setAdaptiveTimestep(), the time step is adjusted after every step (and in prepRun()) so that the particles
+    integrated by the methods move at most a given distance and change their velocity by at most a given amount
+    in the next step, estimated from the largest speed \f$ v \f$ and the largest acceleration \f$ a \f$ of all
+    integrated particles (combined with a single MPI_Allreduce):
+    \f[ \Delta t = \min\left( \frac{2 \Delta x}{v + \sqrt{v^2 + 2 a \Delta x}}, \frac{\Delta v}{a},
+                   g \Delta t_{\mathrm{old}}, \Delta t_{\max} \right) \f]
+    clamped to be at least \f$ \Delta t_{\min} \f$. The growth factor \a g lets the time step recover smoothly after
+    a collision. Only the translational degrees of freedom enter the estimate.
+
+    With setFuseStepOne(), the first step of all methods that provide getFusedStepOneParams() is performed by a single
+    kernel on the GPU instead of one or two kernels per method. In 2D systems, the fused kernel also zeroes the z
+    components of the velocities and accelerations of the integrated particles, as Enforce2DUpdater does.
+
     \ingroup updaters
 */
 class PYBIND11_EXPORT IntegratorTwoStep : public Integrator
@@ -115,6 +132,27 @@ class PYBIND11_EXPORT IntegratorTwoStep : public Integrator
         //! (Re-)initialize the integration method
         void initializeIntegrationMethods();
 
+        //! Enable the adaptive time step
+        void setAdaptiveTimestep(Scalar max_displacement,
+                                 Scalar max_velocity_change,
+                                 Scalar dt_min,
+                                 Scalar dt_max,
+                                 Scalar growth);
+
+        //! Disable the adaptive time step
+        void disableAdaptiveTimestep()
+            {
+            m_adaptive_dt = false;
+            }
+
+        //! Set whether the first step of the methods is fused into a single kernel on the GPU
+        /*! \param fuse True to fuse the first step
+        */
+        void setFuseStepOne(bool fuse)
+            {
+            m_fuse_step_one = fuse;
+            }
+
     protected:
         //! Helper method to test if all added methods have valid restart information
         bool isValidRestart();
@@ -124,6 +162,25 @@ class PYBIND11_EXPORT IntegratorTwoStep : public Integrator
         bool m_prepared;              //!< True if preprun has been called
         bool m_gave_warning;          //!< True if a warning has been given about no methods added
         AnisotropicMode m_aniso_mode; //!< Anisotropic mode for this integrator
+        bool m_fuse_step_one;         //!< True if the first step of the methods is fused on the GPU
+
+        bool m_adaptive_dt;           //!< True if the time step is adapted between steps
+        Scalar m_max_displacement;    //!< Largest displacement in one step with the adaptive time step (0 if unbounded)
+        Scalar m_max_velocity_change; //!< Largest velocity change in one step with the adaptive time step (0 if unbounded)
+        Scalar m_dt_min;              //!< Smallest adaptive time step
+        Scalar m_dt_max;              //!< Largest adaptive time step
+        Scalar m_dt_growth;           //!< Largest factor by which the adaptive time step grows in one step
+
+        //! Adapt the time step to the current velocities and accelerations of the integrated particles
+        void adaptTimestep();
+
+        #ifdef ENABLE_CUDA
+        std::unique_ptr<Autotuner> m_tuner_fused; //!< Autotuner for the block size of the fused first step
+        GPUArray<unsigned int> m_max_vel_accel;   //!< Largest squared speed and acceleration (bits of floats)
+
+        //! Perform the first step of all methods, fusing those that allow it
+        void integrateFusedStepOne(unsigned int timestep);
+        #endif
 
         std::vector< std::shared_ptr<ForceComposite> > m_composite_forces; //!< A list of active composite forces
     };
@@ -0,0 +1,182 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: jglaser
+
+/*! \file LocalFFT.cc
+    \brief Defines the host FFT backends of the mesh computes
+*/
+
+#include "LocalFFT.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+/*!
+ * \param dim Mesh dimensions
+ */
+LocalFFTKiss::LocalFFTKiss(uint3 dim)
+    {
+    int dims[3];
+    dims[0] = dim.z;
+    dims[1] = dim.y;
+    dims[2] = dim.x;
+
+    m_kiss_fft = kiss_fftnd_alloc(dims, 3, 0, NULL, NULL);
+    m_kiss_ifft = kiss_fftnd_alloc(dims, 3, 1, NULL, NULL);
+    }
+
+LocalFFTKiss::~LocalFFTKiss()
+    {
+    free(m_kiss_fft);
+    free(m_kiss_ifft);
+    kiss_fft_cleanup();
+    }
+
+void LocalFFTKiss::forward(const kiss_fft_cpx *in, kiss_fft_cpx *out)
+    {
+    kiss_fftnd(m_kiss_fft, in, out);
+    }
+
+void LocalFFTKiss::inverse(const kiss_fft_cpx *in, kiss_fft_cpx *out)
+    {
+    kiss_fftnd(m_kiss_ifft, in, out);
+    }
+
+#ifdef ENABLE_FFTW
+/*!
+ * \param exec_conf Execution configuration
+ * \param dim Mesh dimensions
+ *
+ * The plans use as many threads as TBB, or a single thread in builds without TBB.
+ */
+LocalFFTW::LocalFFTW(std::shared_ptr<const ExecutionConfiguration> exec_conf, uint3 dim)
+    : m_dim(dim), m_num_threads(std::max(exec_conf->getNumThreads(), 1u)),
+      m_plan_forward(NULL), m_plan_inverse(NULL), m_plan_forward_unaligned(NULL), m_plan_inverse_unaligned(NULL)
+    {
+    #ifdef ENABLE_FFTW_THREADS
+    // the thread setup is global to FFTW and must precede the first plan
+    static bool threads_initialized = false;
+    if (!threads_initialized)
+        {
+        fftwf_init_threads();
+        threads_initialized = true;
+        }
+    #endif
+
+    m_plan_forward = createPlan(FFTW_FORWARD, FFTW_MEASURE);
+    m_plan_inverse = createPlan(FFTW_BACKWARD, FFTW_MEASURE);
+
+    if (!m_plan_forward || !m_plan_inverse)
+        {
+        exec_conf->msg->error() << "Could not create FFTW plans for a " << dim.x << "x" << dim.y << "x" << dim.z
+                                << " mesh" << std::endl;
+        throw std::runtime_error("Error initializing FFT");
+        }
+
+    exec_conf->msg->notice(5) << "FFTW: planned " << dim.x << "x" << dim.y << "x" << dim.z << " mesh with "
+                              << m_num_threads << " threads" << std::endl;
+    }
+
+LocalFFTW::~LocalFFTW()
+    {
+    if (m_plan_forward)
+        fftwf_destroy_plan(m_plan_forward);
+    if (m_plan_inverse)
+        fftwf_destroy_plan(m_plan_inverse);
+    if (m_plan_forward_unaligned)
+        fftwf_destroy_plan(m_plan_forward_unaligned);
+    if (m_plan_inverse_unaligned)
+        fftwf_destroy_plan(m_plan_inverse_unaligned);
+    }
+
+/*!
+ * \param sign FFTW_FORWARD or FFTW_BACKWARD
+ * \param flags Planner flags
+ * \returns The plan, NULL if FFTW could not create it
+ *
+ * The plan is created on scratch buffers, since FFTW_MEASURE overwrites the arrays it plans on.
+ */
+fftwf_plan LocalFFTW::createPlan(int sign, unsigned int flags)
+    {
+    size_t n = size_t(m_dim.x)*size_t(m_dim.y)*size_t(m_dim.z);
+    fftwf_complex *in = (fftwf_complex *) fftwf_malloc(sizeof(fftwf_complex)*n);
+    fftwf_complex *out = (fftwf_complex *) fftwf_malloc(sizeof(fftwf_complex)*n);
+
+    #ifdef ENABLE_FFTW_THREADS
+    fftwf_plan_with_nthreads(m_num_threads);
+    #endif
+    fftwf_plan plan = fftwf_plan_dft_3d(m_dim.z, m_dim.y, m_dim.x, in, out, sign, flags);
+
+    fftwf_free(in);
+    fftwf_free(out);
+    return plan;
+    }
+
+/*!
+ * \param in Input mesh
+ * \param out Output mesh
+ * \param sign FFTW_FORWARD or FFTW_BACKWARD
+ */
+void LocalFFTW::execute(const kiss_fft_cpx *in, kiss_fft_cpx *out, int sign)
+    {
+    // kiss_fft_cpx and fftwf_complex are both a pair of floats
+    fftwf_complex *fin = (fftwf_complex *) const_cast<kiss_fft_cpx *>(in);
+    fftwf_complex *fout = (fftwf_complex *) out;
+
+    // the measured plans may use SIMD kernels that need the alignment of fftwf_malloc
+    fftwf_plan plan = (sign == FFTW_FORWARD) ? m_plan_forward : m_plan_inverse;
+    if (fftwf_alignment_of((float *) fin) != 0 || fftwf_alignment_of((float *) fout) != 0)
+        {
+        fftwf_plan& unaligned = (sign == FFTW_FORWARD) ? m_plan_forward_unaligned : m_plan_inverse_unaligned;
+        if (!unaligned)
+            unaligned = createPlan(sign, FFTW_ESTIMATE | FFTW_UNALIGNED);
+        plan = unaligned;
+        }
+
+    // the input of an out-of-place complex transform is preserved
+    fftwf_execute_dft(plan, fin, fout);
+    }
+
+void LocalFFTW::forward(const kiss_fft_cpx *in, kiss_fft_cpx *out)
+    {
+    execute(in, out, FFTW_FORWARD);
+    }
+
+void LocalFFTW::inverse(const kiss_fft_cpx *in, kiss_fft_cpx *out)
+    {
+    execute(in, out, FFTW_BACKWARD);
+    }
+#endif
+
+/*!
+ * \param exec_conf Execution configuration
+ * \param backend Name of the backend: "kiss", "fftw", or "auto" for FFTW when it is available
+ * \param dim Mesh dimensions
+ * \returns The FFT
+ */
+std::unique_ptr<LocalFFT> createLocalFFT(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                         const std::string& backend,
+                                         uint3 dim)
+    {
+    if (backend == "kiss")
+        {
+        return std::unique_ptr<LocalFFT>(new LocalFFTKiss(dim));
+        }
+    else if (backend == "fftw" || backend == "auto")
+        {
+        #ifdef ENABLE_FFTW
+        return std::unique_ptr<LocalFFT>(new LocalFFTW(exec_conf, dim));
+        #else
+        if (backend == "auto")
+            return std::unique_ptr<LocalFFT>(new LocalFFTKiss(dim));
+
+        exec_conf->msg->error() << "HOOMD was compiled without FFTW support (ENABLE_FFTW)" << std::endl;
+        throw std::runtime_error("Error initializing FFT");
+        #endif
+        }
+
+    exec_conf->msg->error() << "Unknown FFT backend " << backend << std::endl;
+    throw std::runtime_error("Error initializing FFT");
+    }
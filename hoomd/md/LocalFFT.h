@@ -0,0 +1,126 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: jglaser
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/extern/kiss_fftnd.h"
+
+#ifdef ENABLE_FFTW
+#include <fftw3.h>
+#endif
+
+#include <memory>
+#include <string>
+
+/*! \file LocalFFT.h
+    \brief Declares the host FFT backends of the mesh computes
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __LOCAL_FFT_H__
+#define __LOCAL_FFT_H__
+
+//! Complex-to-complex 3D FFT of a mesh that is stored on a single rank
+/*! The mesh is stored in row major order with x as the fastest and z as the slowest index, i.e. the element
+    (x,y,z) is at index (z*dim.y + y)*dim.x + x. The forward transform uses the kernel exp(-i k.r), the inverse
+    transform uses exp(i k.r) and is not normalized. The transforms are out-of-place and do not modify their input.
+
+    \sa createLocalFFT
+*/
+class PYBIND11_EXPORT LocalFFT
+    {
+    public:
+        //! Destructor
+        virtual ~LocalFFT() {}
+
+        //! Forward transform
+        virtual void forward(const kiss_fft_cpx *in, kiss_fft_cpx *out) = 0;
+
+        //! Inverse transform
+        virtual void inverse(const kiss_fft_cpx *in, kiss_fft_cpx *out) = 0;
+
+        //! Get the name of the backend
+        virtual std::string getName() const = 0;
+    };
+
+//! FFT with the bundled kiss_fft library
+class PYBIND11_EXPORT LocalFFTKiss : public LocalFFT
+    {
+    public:
+        //! Constructor
+        LocalFFTKiss(uint3 dim);
+
+        //! Destructor
+        virtual ~LocalFFTKiss();
+
+        //! Forward transform
+        virtual void forward(const kiss_fft_cpx *in, kiss_fft_cpx *out);
+
+        //! Inverse transform
+        virtual void inverse(const kiss_fft_cpx *in, kiss_fft_cpx *out);
+
+        //! Get the name of the backend
+        virtual std::string getName() const
+            {
+            return "kiss";
+            }
+
+    private:
+        kiss_fftnd_cfg m_kiss_fft;      //!< Forward transform configuration
+        kiss_fftnd_cfg m_kiss_ifft;     //!< Inverse transform configuration
+    };
+
+#ifdef ENABLE_FFTW
+//! FFT with FFTW3 (or the FFTW3 interface of MKL), multi-threaded with the number of TBB threads
+/*! The plans are measured on aligned scratch buffers. Arrays that do not have the alignment of the scratch buffers
+    are transformed with a second set of plans that is created on first use.
+*/
+class PYBIND11_EXPORT LocalFFTW : public LocalFFT
+    {
+    public:
+        //! Constructor
+        LocalFFTW(std::shared_ptr<const ExecutionConfiguration> exec_conf, uint3 dim);
+
+        //! Destructor
+        virtual ~LocalFFTW();
+
+        //! Forward transform
+        virtual void forward(const kiss_fft_cpx *in, kiss_fft_cpx *out);
+
+        //! Inverse transform
+        virtual void inverse(const kiss_fft_cpx *in, kiss_fft_cpx *out);
+
+        //! Get the name of the backend
+        virtual std::string getName() const
+            {
+            return "fftw";
+            }
+
+    private:
+        uint3 m_dim;                    //!< Mesh dimensions
+        unsigned int m_num_threads;     //!< Number of threads of the plans
+        fftwf_plan m_plan_forward;      //!< Forward plan for aligned arrays
+        fftwf_plan m_plan_inverse;      //!< Inverse plan for aligned arrays
+        fftwf_plan m_plan_forward_unaligned;    //!< Forward plan for arrays with a different alignment
+        fftwf_plan m_plan_inverse_unaligned;    //!< Inverse plan for arrays with a different alignment
+
+        //! Create a plan
+        fftwf_plan createPlan(int sign, unsigned int flags);
+
+        //! Execute a transform with the plan that matches the alignment of the arrays
+        void execute(const kiss_fft_cpx *in, kiss_fft_cpx *out, int sign);
+    };
+#endif
+
+//! Create the host FFT of a mesh
+std::unique_ptr<LocalFFT> createLocalFFT(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                         const std::string& backend,
+                                         uint3 dim);
+
+#endif // __LOCAL_FFT_H__
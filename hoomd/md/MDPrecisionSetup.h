@@ -0,0 +1,47 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file MDPrecisionSetup.h
+    \brief Setup for md mixed precision
+    \details In mixed precision, the positions and velocities are stored and integrated in Scalar (double), the
+    displacement of a pair is computed and wrapped into the box in Scalar, and the force of the pair is then evaluated
+    in ForceReal (float) from this short relative vector. The forces, energies and virials are summed in Scalar.
+*/
+
+#ifndef __MD_PRECISION_SETUP_H__
+#define __MD_PRECISION_SETUP_H__
+
+// the helpers are __host__ __device__ when included in nvcc
+#ifdef NVCC
+#define FORCEREAL_HOSTDEVICE __host__ __device__
+#else
+#define FORCEREAL_HOSTDEVICE
+#endif
+
+#if defined(ENABLE_MD_MIXED_PRECISION) && !defined(SINGLE_PRECISION)
+//! Typedef'd real for the evaluation of pair and bond forces
+typedef float ForceReal;
+//! Typedef'd real3 for the evaluation of pair and bond forces
+typedef float3 ForceReal3;
+#else
+typedef Scalar ForceReal;
+typedef Scalar3 ForceReal3;
+#endif
+
+//! Convert a pair displacement to ForceReal3
+/*! \param dx Displacement, already wrapped into the box
+*/
+FORCEREAL_HOSTDEVICE inline ForceReal3 make_forcereal3(const Scalar3& dx)
+    {
+    ForceReal3 v;
+    v.x = ForceReal(dx.x);
+    v.y = ForceReal(dx.y);
+    v.z = ForceReal(dx.z);
+    return v;
+    }
+
+#undef FORCEREAL_HOSTDEVICE
+
+#endif // __MD_PRECISION_SETUP_H__
@@ -14,6 +14,17 @@ const Scalar INVALID_VEL = FLT_MAX; //should be ok, even for double.
 
 //! \file MuellerPlatheFlow.cc Implementation of CPU version of MuellerPlatheFlow.
 
+#ifdef ENABLE_MPI
+//! MPI reduction operator for mp_swap_candidates
+static void mp_reduce_candidates(void *in, void *inout, int *len, MPI_Datatype *datatype)
+    {
+    const mp_swap_candidates *a = (const mp_swap_candidates*)in;
+    mp_swap_candidates *b = (mp_swap_candidates*)inout;
+    for (int i = 0; i < *len; i++)
+        b[i] = mp_select_candidates(a[i], b[i]);
+    }
+#endif//ENABLE_MPI
+
 MuellerPlatheFlow::MuellerPlatheFlow(std::shared_ptr<SystemDefinition> sysdef,
                                      std::shared_ptr<ParticleGroup> group,
                                      std::shared_ptr<Variant> flow_target,
@@ -46,8 +57,14 @@ MuellerPlatheFlow::MuellerPlatheFlow(std::shared_ptr<SystemDefinition> sysdef,
     m_last_min_vel.z = __int_as_scalar(INVALID_TAG);
 
     m_exec_conf->msg->notice(5) << "Constructing MuellerPlatheFlow " << endl;
+
+#ifdef ENABLE_MPI
+    MPI_Type_contiguous(sizeof(mp_swap_candidates), MPI_BYTE, &m_mpi_candidates_type);
+    MPI_Type_commit(&m_mpi_candidates_type);
+    MPI_Op_create(mp_reduce_candidates, 1, &m_mpi_candidates_op);
+#endif//ENABLE_MPI
+
     this->update_domain_decomposition();
-    //m_exec_conf->msg->notice(0)<<m_exec_conf->getRank()<<": "<< m_max_swap.gbl_rank<<" "<<m_min_swap.gbl_rank<<endl;
 
     //Check min max slab.
     this->set_min_slab(m_min_slab);
@@ -59,6 +76,11 @@ MuellerPlatheFlow::~MuellerPlatheFlow(void)
     m_exec_conf->msg->notice(5) << "Destroying MuellerPlatheFlow " << endl;
     m_pdata->getBoxChangeSignal()
         .disconnect<MuellerPlatheFlow, &MuellerPlatheFlow::force_orthorhombic_box_check>(this);
+
+#ifdef ENABLE_MPI
+    MPI_Op_free(&m_mpi_candidates_op);
+    MPI_Type_free(&m_mpi_candidates_type);
+#endif//ENABLE_MPI
     }
 
 void MuellerPlatheFlow::update(unsigned int timestep)
@@ -170,9 +192,6 @@ void MuellerPlatheFlow::swap_min_max_slab(void)
 
     std::swap( m_has_max_slab, m_has_min_slab);
 
-#ifdef ENABLE_MPI
-    std::swap( m_max_swap, m_min_swap);
-#endif//ENABLE_MPI
     m_exec_conf->msg->notice(4)<<"MuellerPlatheUpdater swapped min/max slab: "<<this->get_min_slab()<<" "<<this->get_max_slab()<<endl;
     }
 
@@ -229,14 +248,6 @@ void MuellerPlatheFlow::update_domain_decomposition(void)
         m_has_max_slab = false;
         if( my_pos == this->get_max_slab() / (m_N_slabs/my_grid) )
             m_has_max_slab = true;
-
-
-        //Create the communicator.
-        const int min_color =  this->has_min_slab() ? 0 : MPI_UNDEFINED;
-        init_mpi_swap(&m_min_swap,min_color);
-
-        const int max_color =  this->has_max_slab() ? 0 : MPI_UNDEFINED;
-        init_mpi_swap(&m_max_swap,max_color);
         }
 #endif//ENABLE_MPI
     }
@@ -282,19 +293,12 @@ void MuellerPlatheFlow::search_min_max_velocity(void)
                     }
                 const Scalar mass = h_vel.data[j].w;
                 vel *= mass; //Use momentum instead of velocity
-                if( index == this->get_max_slab() && m_last_max_vel.x < vel &&  this->has_max_slab())
-                    {
-                    m_last_max_vel.x = vel;
-                    m_last_max_vel.y = mass;
-                    m_last_max_vel.z = __int_as_scalar(h_tag.data[j]);
-
-                    }
-                if( index == this->get_min_slab() && m_last_min_vel.x > vel && this->has_min_slab())
-                    {
-                    m_last_min_vel.x = vel;
-                    m_last_max_vel.y = mass;
-                    m_last_min_vel.z = __int_as_scalar(h_tag.data[j]);
-                    }
+                const Scalar3 candidate = make_scalar3(vel, mass, __int_as_scalar(h_tag.data[j]));
+                //Same selection as the GPU and MPI reductions.
+                if( index == this->get_max_slab() && this->has_max_slab())
+                    m_last_max_vel = mp_select_max_vel(m_last_max_vel, candidate);
+                if( index == this->get_min_slab() && this->has_min_slab())
+                    m_last_min_vel = mp_select_min_vel(m_last_min_vel, candidate);
                 }
             }
         }
@@ -359,84 +363,21 @@ void MuellerPlatheFlow::verify_orthorhombic_box(void)
     }
 #ifdef ENABLE_MPI
 
-//Not performance optimized: could be slow. It is meant for init.
-void MuellerPlatheFlow::init_mpi_swap(struct MPI_SWAP*ms,const int color)
-    {
-    if( ms->initialized && ms->rank != MPI_UNDEFINED)
-        MPI_Comm_free( &(ms->comm) );
-
-    MPI_Comm_split( m_exec_conf->getMPICommunicator(),
-                    color, m_exec_conf->getRank(),
-                    &(ms->comm));
-    if( color != MPI_UNDEFINED)
-        {
-        MPI_Comm_rank(ms->comm,&(ms->rank) );
-        MPI_Comm_size(ms->comm,&(ms->size) );
-        }
-    else
-        {
-        ms->rank = MPI_UNDEFINED;
-        ms->size = MPI_UNDEFINED;
-        }
-    int send =0;
-    if( ms->rank == 0)
-        {
-        send = 1;
-        }
-    vector<int> recv;
-    all_gather_v(send,recv,m_exec_conf->getMPICommunicator());
-
-    //ARG_MAX;
-    ms->gbl_rank = -1;
-    for(unsigned int i=0; i < recv.size(); i++)
-        {
-        if( recv[i] == 1)
-            {
-            assert( ms->gbl_rank == -1);
-            ms->gbl_rank = i;
-            }
-        }
-    assert( ms->gbl_rank > -1);
-    ms->initialized = true;
-    }
-
-void MuellerPlatheFlow::bcast_vel_to_all(struct MPI_SWAP*ms,Scalar3*vel,const MPI_Op op)
-    {
-    if( ms->rank != MPI_UNDEFINED)
-        {
-        Scalar_Int tmp;
-        tmp.s = vel->x;
-        tmp.i = ms->rank;
-        MPI_Allreduce(MPI_IN_PLACE,&tmp,1,MPI_HOOMD_SCALAR_INT,op, ms->comm);
-        //Send to subset local rank
-        if( tmp.i != 0)
-            {
-            if( ms->rank == 0)
-                {
-                  recv(*vel,tmp.i,ms->comm);
-                }
-            if( ms->rank == tmp.i)
-                {
-                  send(*vel, 0 , ms->comm);
-                }
-            }
-        //ms->rank == 0 has the definite answer
-        }
-    //Broadcast the result to every rank.
-    //This way, each rank can check, whether
-    //it needs to update and can determine the exchanged momentum.
-    bcast( *vel, ms->gbl_rank, m_exec_conf->getMPICommunicator() );
-    }
-
+/*! Ranks without the min or max slab contribute the invalid candidates. After the reduction every rank knows both
+    particles, so that it can update them if they are local or ghosts, and compute the exchanged momentum.
+*/
 void MuellerPlatheFlow::mpi_exchange_velocity(void)
     {
-#ifdef ENABLE_MPI
     if( m_pdata->getDomainDecomposition() )
         {
-        bcast_vel_to_all(&m_min_swap,&m_last_min_vel,MPI_MINLOC);
-        bcast_vel_to_all(&m_max_swap,&m_last_max_vel,MPI_MAXLOC);
+        mp_swap_candidates candidates;
+        candidates.max_vel = m_last_max_vel;
+        candidates.min_vel = m_last_min_vel;
+        MPI_Allreduce(MPI_IN_PLACE, &candidates, 1, m_mpi_candidates_type, m_mpi_candidates_op,
+                      m_exec_conf->getMPICommunicator());
+        m_last_max_vel = candidates.max_vel;
+        m_last_min_vel = candidates.min_vel;
         }
-#endif//ENABLE_MPI
     }
 
 #endif//ENABLE_MPI
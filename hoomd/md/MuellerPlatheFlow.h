@@ -30,6 +30,52 @@ struct flow_enum
             };
     };
 
+#ifdef NVCC
+#define HOSTDEVICE __host__ __device__
+#else
+#define HOSTDEVICE
+#endif
+
+//! Candidates for a velocity exchange
+/*! Both members follow the layout of MuellerPlatheFlow::m_last_max_vel: x: momentum y: mass z: tag as scalar.
+*/
+struct mp_swap_candidates
+    {
+    Scalar3 max_vel;    //!< Particle with the largest momentum in the max slab
+    Scalar3 min_vel;    //!< Particle with the smallest momentum in the min slab
+    };
+
+//! Select the particle with the larger momentum
+/*! Ties are broken by the smaller tag, so that the result does not depend on the order of the reduction.
+*/
+HOSTDEVICE inline Scalar3 mp_select_max_vel(const Scalar3& a, const Scalar3& b)
+    {
+    if (a.x != b.x)
+        return a.x > b.x ? a : b;
+    return (unsigned int)__scalar_as_int(a.z) < (unsigned int)__scalar_as_int(b.z) ? a : b;
+    }
+
+//! Select the particle with the smaller momentum
+/*! Ties are broken by the smaller tag, so that the result does not depend on the order of the reduction.
+*/
+HOSTDEVICE inline Scalar3 mp_select_min_vel(const Scalar3& a, const Scalar3& b)
+    {
+    if (a.x != b.x)
+        return a.x < b.x ? a : b;
+    return (unsigned int)__scalar_as_int(a.z) < (unsigned int)__scalar_as_int(b.z) ? a : b;
+    }
+
+//! Combine two sets of candidates
+HOSTDEVICE inline mp_swap_candidates mp_select_candidates(const mp_swap_candidates& a, const mp_swap_candidates& b)
+    {
+    mp_swap_candidates result;
+    result.max_vel = mp_select_max_vel(a.max_vel, b.max_vel);
+    result.min_vel = mp_select_min_vel(a.min_vel, b.min_vel);
+    return result;
+    }
+
+#undef HOSTDEVICE
+
 //Above this line shared constructs can be declared.
 #ifndef NVCC
 #include "hoomd/ParticleGroup.h"
@@ -150,25 +196,9 @@ class PYBIND11_EXPORT MuellerPlatheFlow : public Updater
         //! Returns if box is orthorhombic, but throws a runtime_error, if the box is not orthorhombic.
         void verify_orthorhombic_box(void);
 #ifdef ENABLE_MPI
-        struct MPI_SWAP{
-            MPI_Comm comm;
-            int rank;
-            int size;
-            int gbl_rank; //!< global rank of zero in the comm.
-            bool initialized; //!< initialized struct, manually set.
-            MPI_SWAP()
-                :
-                comm(MPI_COMM_NULL),
-                rank(MPI_UNDEFINED),
-                size(MPI_UNDEFINED),
-                gbl_rank(MPI_UNDEFINED),
-                initialized(false)
-                {}
-            };
-        struct MPI_SWAP m_min_swap;
-        struct MPI_SWAP m_max_swap;
-        void init_mpi_swap(struct MPI_SWAP* ms,const int color);
-        void bcast_vel_to_all(struct MPI_SWAP*ms,Scalar3*vel,const MPI_Op op);
+        MPI_Datatype m_mpi_candidates_type; //!< MPI type of mp_swap_candidates
+        MPI_Op m_mpi_candidates_op;         //!< MPI reduction with mp_select_candidates()
+        //! Reduce the candidates of all ranks in a single collective.
         void mpi_exchange_velocity(void);
 #endif//ENABLE_MPI
     };
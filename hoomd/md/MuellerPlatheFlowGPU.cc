@@ -30,7 +30,16 @@ MuellerPlatheFlowGPU::MuellerPlatheFlowGPU(std::shared_ptr<SystemDefinition> sys
         throw std::runtime_error("Error initializing MuellerPlatheFlowGPU");
         }
 
-    m_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "muellerplatheflow", this->m_exec_conf));
+    // the block reduction of the search needs a power of two block size
+    std::vector<unsigned int> valid_params;
+    for (unsigned int block_size = 32; block_size <= 512; block_size *= 2)
+        valid_params.push_back(block_size);
+    m_tuner.reset(new Autotuner(valid_params, 5, 100000, "muellerplatheflow", this->m_exec_conf));
+
+    GPUArray<mp_swap_candidates> partial(MP_SEARCH_MAX_BLOCKS, m_exec_conf);
+    m_partial.swap(partial);
+    GPUArray<mp_swap_candidates> result(1, m_exec_conf);
+    m_result.swap(result);
     }
 
 MuellerPlatheFlowGPU::~MuellerPlatheFlowGPU(void)
@@ -48,26 +57,37 @@ void MuellerPlatheFlowGPU::search_min_max_velocity(void)
     if( !this->has_max_slab() and !this->has_min_slab())
         return;
     if(m_prof) m_prof->push("MuellerPlatheFlowGPU::search");
-    const ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(),access_location::device, access_mode::read);
-    const ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(),access_location::device, access_mode::read);
-    const ArrayHandle<unsigned int> d_tag(m_pdata->getTags(),access_location::device, access_mode::read);
-    const ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(),access_location::device, access_mode::read);
-    const GlobalArray< unsigned int >& group_members = m_group->getIndexArray();
-    const ArrayHandle<unsigned int> d_group_members(group_members, access_location::device, access_mode::read);
-
-    const BoxDim& gl_box = m_pdata->getGlobalBox();
-
+    mp_swap_candidates init;
+    init.max_vel = m_last_max_vel;
+    init.min_vel = m_last_min_vel;
 
+        {
+        const ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(),access_location::device, access_mode::read);
+        const ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(),access_location::device, access_mode::read);
+        const ArrayHandle<unsigned int> d_tag(m_pdata->getTags(),access_location::device, access_mode::read);
+        const GlobalArray< unsigned int >& group_members = m_group->getIndexArray();
+        const ArrayHandle<unsigned int> d_group_members(group_members, access_location::device, access_mode::read);
+        ArrayHandle<mp_swap_candidates> d_partial(m_partial, access_location::device, access_mode::overwrite);
+        ArrayHandle<mp_swap_candidates> d_result(m_result, access_location::device, access_mode::overwrite);
+
+        const BoxDim& gl_box = m_pdata->getGlobalBox();
+
+        m_tuner->begin();
+        gpu_search_min_max_velocity(group_size,d_vel.data,d_pos.data,d_tag.data,
+                                    d_group_members.data,gl_box,this->get_N_slabs(),
+                                    this->get_max_slab(),this->get_min_slab(),init,
+                                    d_partial.data,MP_SEARCH_MAX_BLOCKS,d_result.data,
+                                    this->has_max_slab(),this->has_min_slab(),
+                                    m_tuner->getParam(),m_flow_direction,m_slab_direction);
+        m_tuner->end();
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
 
-    m_tuner->begin();
-    gpu_search_min_max_velocity(group_size,d_vel.data,d_pos.data,d_tag.data,d_rtag.data,
-                                d_group_members.data,gl_box,this->get_N_slabs(),
-                                this->get_max_slab(),this->get_min_slab(),&m_last_max_vel,
-                                &m_last_min_vel,this->has_max_slab(),this->has_min_slab(),
-                                m_tuner->getParam(),m_flow_direction,m_slab_direction);
-    m_tuner->end();
-    if(m_exec_conf->isCUDAErrorCheckingEnabled())
-        CHECK_CUDA_ERROR();
+    //Download both candidates at once.
+    ArrayHandle<mp_swap_candidates> h_result(m_result, access_location::host, access_mode::read);
+    m_last_max_vel = h_result.data[0].max_vel;
+    m_last_min_vel = h_result.data[0].min_vel;
 
     if(m_prof) m_prof->pop();
     }
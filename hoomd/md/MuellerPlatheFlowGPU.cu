@@ -6,159 +6,160 @@
 #include "MuellerPlatheFlowGPU.h"
 #include "MuellerPlatheFlowGPU.cuh"
 #include <assert.h>
-#include <thrust/transform_reduce.h>
-#include <thrust/functional.h>
-#include <thrust/device_ptr.h>
 
-struct vel_search_un_opt : public thrust::unary_function< const unsigned int,Scalar3>
+//! Determine the slab of a position
+__device__ inline unsigned int mp_slab_index(const Scalar4& pos,
+                                             const BoxDim& gl_box,
+                                             const unsigned int Nslabs,
+                                             const flow_enum::Direction slab_direction)
     {
-        vel_search_un_opt(const Scalar4*const d_vel,const unsigned int *const d_tag,flow_enum::Direction flow_direction)
-            :
-            m_vel(d_vel),
-            m_tag(d_tag),
-            m_flow_direction(flow_direction)
-            {}
-        const Scalar4*const m_vel;
-        const unsigned int*const m_tag;
-        const flow_enum::Direction m_flow_direction;
-        __host__ __device__ Scalar3 operator()(const unsigned int idx)const
-            {
-            const unsigned int tag = m_tag[idx];
-            Scalar vel;
-            switch( m_flow_direction )
-                {
-                case flow_enum::X: vel = m_vel[idx].x; break;
-                case flow_enum::Y: vel = m_vel[idx].y; break;
-                case flow_enum::Z: vel = m_vel[idx].z; break;
-                }
-            const Scalar mass = m_vel[idx].w;
-            vel *= mass;
-            Scalar3 result;
-            result.x = vel;
-            result.y = mass;
-            result.z = __int_as_scalar(tag);
-            return result;
-            }
-    };
-template <typename CMP>
-struct vel_search_binary_opt : public thrust::binary_function< Scalar3, Scalar3, Scalar3 >
+    unsigned int index = 0;
+    switch( slab_direction )
+        {
+        case flow_enum::X: index = (pos.x/gl_box.getL().x +.5) * Nslabs; break;
+        case flow_enum::Y: index = (pos.y/gl_box.getL().y +.5) * Nslabs; break;
+        case flow_enum::Z: index = (pos.z/gl_box.getL().z +.5) * Nslabs; break;
+        }
+    //border cases. wrap periodic box
+    return index % Nslabs;
+    }
+
+//! Reduce the candidates of a block in shared memory
+/*! \param s_candidates Candidates of every thread in the block
+    \note The block size must be a power of two.
+*/
+__device__ inline void mp_reduce_block(mp_swap_candidates *s_candidates)
+    {
+    for (unsigned int offset = blockDim.x/2; offset > 0; offset /= 2)
+        {
+        __syncthreads();
+        if (threadIdx.x < offset)
+            s_candidates[threadIdx.x] = mp_select_candidates(s_candidates[threadIdx.x],
+                                                             s_candidates[threadIdx.x + offset]);
+        }
+    }
+
+//! Find the candidates in the min and max slab within the members handled by a block
+/*! \param d_partial Candidates of every block (output)
+
+    Every thread checks a strided subset of the group members, determines the slab of each particle once and keeps
+    the best candidates of both slabs. The candidates are then reduced within the block.
+*/
+__global__ void gpu_search_min_max_velocity_partial_kernel(const unsigned int group_size,
+                                                           const Scalar4*const d_vel,
+                                                           const Scalar4*const d_pos,
+                                                           const unsigned int *const d_tag,
+                                                           const unsigned int *const d_group_members,
+                                                           const BoxDim gl_box,
+                                                           const unsigned int Nslabs,
+                                                           const unsigned int max_slab,
+                                                           const unsigned int min_slab,
+                                                           const mp_swap_candidates init,
+                                                           const bool has_max_slab,
+                                                           const bool has_min_slab,
+                                                           const flow_enum::Direction flow_direction,
+                                                           const flow_enum::Direction slab_direction,
+                                                           mp_swap_candidates *const d_partial)
     {
-        vel_search_binary_opt(const unsigned int*const d_rtag,
-                              const Scalar4*const d_pos,
-                              const BoxDim gl_box,
-                              const unsigned int Nslabs,
-                              const unsigned int slab_index,
-                              const Scalar3 invalid,
-                              const flow_enum::Direction slab_direction)
-            : m_rtag(d_rtag),
-              m_pos(d_pos),
-              m_gl_box(gl_box),
-              m_Nslabs(Nslabs),
-              m_slab_index(slab_index),
-              m_invalid(invalid),
-              m_slab_direction(slab_direction)
-            {}
-        const unsigned int*const m_rtag;
-        const Scalar4*const m_pos;
-        const BoxDim m_gl_box;
-        const unsigned int m_Nslabs;
-        const unsigned int m_slab_index;
-        const Scalar3 m_invalid;
-        const flow_enum::Direction m_slab_direction;
-
-        __host__ __device__ Scalar3 operator()(const Scalar3& a,const Scalar3& b)const
+    extern __shared__ mp_swap_candidates s_candidates[];
+
+    mp_swap_candidates candidates = init;
+    for (unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x; group_idx < group_size;
+         group_idx += blockDim.x * gridDim.x)
+        {
+        const unsigned int idx = d_group_members[group_idx];
+        const unsigned int index = mp_slab_index(d_pos[idx], gl_box, Nslabs, slab_direction);
+        const bool in_max = has_max_slab && index == max_slab;
+        const bool in_min = has_min_slab && index == min_slab;
+        if( !in_max && !in_min )
+            continue;
+
+        const Scalar4 vel = d_vel[idx];
+        Scalar v = vel.x;
+        switch( flow_direction )
             {
-            Scalar3 result = m_invalid;
-            //Early exit, if invalid args involved.
-            if( a.z == m_invalid.z )
-                return b;
-            if( b.z == m_invalid.z )
-                return a;
-
-            const unsigned int idx_a = m_rtag[__scalar_as_int(a.z)];
-            const unsigned int idx_b = m_rtag[__scalar_as_int(b.z)];
-
-            unsigned int index_a,index_b;
-            switch( m_slab_direction )
-                {
-                case flow_enum::X:
-                    index_a = (m_pos[idx_a].x/m_gl_box.getL().x +.5) * m_Nslabs;
-                    index_b = (m_pos[idx_b].x/m_gl_box.getL().x +.5) * m_Nslabs;
-                    break;
-                case flow_enum::Y:
-                    index_a = (m_pos[idx_a].y/m_gl_box.getL().y +.5) * m_Nslabs;
-                    index_b = (m_pos[idx_b].y/m_gl_box.getL().y +.5) * m_Nslabs;
-                    break;
-                case flow_enum::Z:
-                    index_a = (m_pos[idx_a].z/m_gl_box.getL().z +.5) * m_Nslabs;
-                    index_b = (m_pos[idx_b].z/m_gl_box.getL().z +.5) * m_Nslabs;
-                    break;
-                }
-            index_a %= m_Nslabs;
-            index_b %= m_Nslabs;
-
-            if( index_a == index_b)
-                {
-                if( index_a == m_slab_index )
-                    {
-                    CMP cmp;
-                    if( cmp(a.x,b.x) )
-                        result = a;
-                    else
-                        result = b;
-                    }
-                }
-            else
-                {
-                if( index_a == m_slab_index )
-                    result = a;
-                if( index_b == m_slab_index )
-                    result = b;
-                }
-            return result;
+            case flow_enum::X: v = vel.x; break;
+            case flow_enum::Y: v = vel.y; break;
+            case flow_enum::Z: v = vel.z; break;
             }
-    };
+        //Use momentum instead of velocity
+        const Scalar3 candidate = make_scalar3(v*vel.w, vel.w, __int_as_scalar(d_tag[idx]));
+        if( in_max )
+            candidates.max_vel = mp_select_max_vel(candidates.max_vel, candidate);
+        if( in_min )
+            candidates.min_vel = mp_select_min_vel(candidates.min_vel, candidate);
+        }
+
+    s_candidates[threadIdx.x] = candidates;
+    mp_reduce_block(s_candidates);
 
+    if (threadIdx.x == 0)
+        d_partial[blockIdx.x] = s_candidates[0];
+    }
+
+//! Reduce the candidates of all blocks
+/*! \param d_partial Candidates of every block
+    \param n_partial Number of blocks of the first pass
+    \param init Invalid candidates
+    \param d_result The candidates of the group (output)
+
+    Must be launched with a single block.
+*/
+__global__ void gpu_search_min_max_velocity_final_kernel(const mp_swap_candidates *const d_partial,
+                                                         const unsigned int n_partial,
+                                                         const mp_swap_candidates init,
+                                                         mp_swap_candidates *const d_result)
+    {
+    extern __shared__ mp_swap_candidates s_candidates[];
+
+    mp_swap_candidates candidates = init;
+    for (unsigned int i = threadIdx.x; i < n_partial; i += blockDim.x)
+        candidates = mp_select_candidates(candidates, d_partial[i]);
+
+    s_candidates[threadIdx.x] = candidates;
+    mp_reduce_block(s_candidates);
+
+    if (threadIdx.x == 0)
+        *d_result = s_candidates[0];
+    }
+
+/*! \param d_partial Scratch space for the candidates of at least \a max_blocks blocks
+    \param max_blocks Largest number of blocks of the first pass
+    \param d_result The candidates of the group (output)
+    \param init Invalid candidates, the initial value of the reduction
+
+    Both slabs are searched at once in two kernel launches. The block size must be a power of two.
+*/
 cudaError_t gpu_search_min_max_velocity(const unsigned int group_size,
                                         const Scalar4*const d_vel,
                                         const Scalar4*const d_pos,
                                         const unsigned int *const d_tag,
-                                        const unsigned int *const d_rtag,
                                         const unsigned int *const d_group_members,
                                         const BoxDim gl_box,
                                         const unsigned int Nslabs,
                                         const unsigned int max_slab,
                                         const unsigned int min_slab,
-                                        Scalar3*const last_max_vel,
-                                        Scalar3*const last_min_vel,
+                                        const mp_swap_candidates init,
+                                        mp_swap_candidates *const d_partial,
+                                        const unsigned int max_blocks,
+                                        mp_swap_candidates *const d_result,
                                         const bool has_max_slab,
                                         const bool has_min_slab,
                                         const unsigned int blocksize,
                                         const flow_enum::Direction flow_direction,
                                         const flow_enum::Direction slab_direction)
     {
-    thrust::device_ptr<const unsigned int> member_ptr(d_group_members);
-
-    vel_search_un_opt un_opt(d_vel, d_tag,flow_direction);
+    unsigned int n_blocks = group_size/blocksize + 1;
+    if (n_blocks > max_blocks)
+        n_blocks = max_blocks;
 
-    if( has_max_slab )
-        {
-        vel_search_binary_opt<thrust::greater<const Scalar> > max_bin_opt(
-            d_rtag,d_pos,gl_box,Nslabs,max_slab,*last_max_vel,slab_direction);
-        Scalar3 init = *last_max_vel;
-        *last_max_vel = thrust::transform_reduce(member_ptr,member_ptr+group_size,
-                                                 un_opt,init,max_bin_opt);
-        }
-
-    if( has_min_slab )
-        {
-        vel_search_binary_opt<thrust::less<const Scalar> > min_bin_opt(
-            d_rtag,d_pos,gl_box,Nslabs,min_slab,*last_min_vel,slab_direction);
-        Scalar3 init = *last_min_vel;
-        *last_min_vel = thrust::transform_reduce(member_ptr,member_ptr+group_size,
-                                                 un_opt,init,min_bin_opt);
-        }
+    gpu_search_min_max_velocity_partial_kernel<<<n_blocks, blocksize, blocksize*sizeof(mp_swap_candidates)>>>(
+        group_size, d_vel, d_pos, d_tag, d_group_members, gl_box, Nslabs, max_slab, min_slab, init,
+        has_max_slab, has_min_slab, flow_direction, slab_direction, d_partial);
 
+    const unsigned int final_block_size = 256;
+    gpu_search_min_max_velocity_final_kernel<<<1, final_block_size,
+        final_block_size*sizeof(mp_swap_candidates)>>>(d_partial, n_blocks, init, d_result);
 
     return cudaPeekAtLastError();
     }
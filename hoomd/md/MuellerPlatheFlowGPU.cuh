@@ -3,6 +3,7 @@
 
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/ParticleData.cuh"
+#include "MuellerPlatheFlow.h"
 
 /*! \file MuellerPlatheFlowGPU.cuh
     \brief Declares GPU kernel code for calculating MinMax velocities and updates for the flow.
@@ -11,18 +12,23 @@
 #ifndef __MUELLER_PLATHE_FLOW_GPU_CUH__
 #define __MUELLER_PLATHE_FLOW_GPU_CUH__
 
+//! Largest number of blocks in the first pass of the search
+const unsigned int MP_SEARCH_MAX_BLOCKS = 256;
+
+//! Find the candidates for a velocity exchange in the min and max slab
 cudaError_t gpu_search_min_max_velocity(const unsigned int group_size,
                                         const Scalar4*const d_vel,
                                         const Scalar4*const d_pos,
                                         const unsigned int *const d_tag,
-                                        const unsigned int *const d_rtag,
                                         const unsigned int *const d_group_members,
                                         const BoxDim gl_box,
                                         const unsigned int Nslabs,
                                         const unsigned int max_slab,
                                         const unsigned int min_slab,
-                                        Scalar3*const last_max_vel,
-                                        Scalar3*const last_min_vel,
+                                        const mp_swap_candidates init,
+                                        mp_swap_candidates *const d_partial,
+                                        const unsigned int max_blocks,
+                                        mp_swap_candidates *const d_result,
                                         const bool has_max_slab,
                                         const bool has_min_slab,
                                         const unsigned int blocksize,
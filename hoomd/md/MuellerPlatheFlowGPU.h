@@ -65,6 +65,8 @@ class MuellerPlatheFlowGPU : public MuellerPlatheFlow
 
     protected:
         std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for block size
+        GPUArray<mp_swap_candidates> m_partial; //!< Candidates of every block of the search
+        GPUArray<mp_swap_candidates> m_result;  //!< Candidates of the group
 
         virtual void search_min_max_velocity(void);
         virtual void update_min_max_velocity(void);
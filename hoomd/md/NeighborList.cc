@@ -13,6 +13,9 @@
 
 namespace py = pybind11;
 
+#include <algorithm>
+#include <climits>
+#include <cmath>
 #include <iostream>
 #include <stdexcept>
 
@@ -33,9 +36,12 @@ using namespace std;
 NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_cut, Scalar r_buff)
     : Compute(sysdef), m_typpair_idx(m_pdata->getNTypes()), m_rcut_max_max(_r_cut), m_rcut_min(_r_cut),
       m_r_buff(r_buff), m_d_max(1.0), m_filter_body(false), m_diameter_shift(false), m_storage_mode(half),
-      m_rcut_changed(true), m_updates(0), m_forced_updates(0), m_dangerous_updates(0), m_force_update(true),
-      m_dist_check(true), m_has_been_updated_once(false)
+      m_exact_storage(false), m_storage_slack(4), m_build_N(0),
+      m_rcut_changed(true), m_updates(0), m_forced_updates(0), m_dangerous_updates(0), m_overflow_builds(0),
+      m_force_update(true), m_dist_check(true), m_has_been_updated_once(false)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "NeighborList");
+
     m_exec_conf->msg->notice(5) << "Constructing Neighborlist" << endl;
 
     // r_buff must be non-negative or it is not physical
@@ -51,11 +57,37 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     m_last_check_result = false;
     m_every = 0;
     m_exclusions_set = false;
+    m_special_pairs_set = false;
+
+    m_metric_builds = m_exec_conf->getMetrics()->registerMetric("hoomd_nlist_builds", "",
+        "Number of neighbor list builds", Metrics::counter, Metrics::max);
+    m_metric_dangerous_builds = m_exec_conf->getMetrics()->registerMetric("hoomd_nlist_dangerous_builds", "",
+        "Number of dangerous neighbor list builds", Metrics::counter, Metrics::max);
+    m_metric_collective_time = m_exec_conf->getMetrics()->registerCollectiveTime();
+
+    // the buffer tuner is disabled by default
+    m_rbuff_tuner = false;
+    m_rbuff_tuner_min = Scalar(0.0);
+    m_rbuff_tuner_max = Scalar(0.0);
+    m_rbuff_tuner_period = 0;
+    m_rbuff_tuner_state = rbuff_tuner_measure;
+    m_rbuff_tuner_dr = Scalar(0.0);
+    m_rbuff_tuner_best = m_r_buff;
+    m_rbuff_tuner_best_cost = 0.0;
+    m_rbuff_tuner_pending = Scalar(-1.0);
+    m_rbuff_tuner_window_open = false;
+    m_rbuff_tuner_last_step = 0;
+    m_rbuff_tuner_start_step = 0;
+    m_rbuff_tuner_start_time = 0;
+    m_rbuff_tuner_dangerous = 0;
+    m_rbuff_tuner_min_period = UINT_MAX;
 
     m_need_reallocate_exlist = false;
+    m_n_ex_outside_window = 0;
+    m_ex_list_idx_stale = false;
 
     // initialize box length at last update
-    m_last_L = m_pdata->getGlobalBox().getNearestPlaneDistance();
+    m_last_box = m_pdata->getGlobalBox();
     m_last_L_local = m_pdata->getBox().getNearestPlaneDistance();
 
     // allocate r_cut pairwise storage
@@ -111,8 +143,8 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     m_nlist.swap(nlist);
     TAG_ALLOCATION(m_nlist);
 
-    // allocate head list indexer
-    GlobalArray<unsigned int> head_list(m_pdata->getMaxN(), m_exec_conf);
+    // allocate head list indexer, with an extra element for the end of the last particle
+    GlobalArray<unsigned int> head_list(m_pdata->getMaxN()+1, m_exec_conf);
     m_head_list.swap(head_list);
     TAG_ALLOCATION(m_head_list);
 
@@ -182,6 +214,23 @@ NeighborList::NeighborList(std::shared_ptr<SystemDefinition> sysdef, Scalar _r_c
     m_ex_list_idx.swap(ex_list_idx);
     TAG_ALLOCATION(m_ex_list_idx);
 
+    GlobalVector<unsigned int> ex_mask_tag(m_pdata->getRTags().size(), m_exec_conf);
+    m_ex_mask_tag.swap(ex_mask_tag);
+    TAG_ALLOCATION(m_ex_mask_tag);
+
+    GlobalArray<unsigned int> ex_mask_idx(m_pdata->getMaxN(), m_exec_conf);
+    m_ex_mask_idx.swap(ex_mask_idx);
+    TAG_ALLOCATION(m_ex_mask_idx);
+
+    // the special pair masks by tag are allocated when they are first set
+    GlobalVector<unsigned int> sp_mask_tag(m_exec_conf);
+    m_sp_mask_tag.swap(sp_mask_tag);
+    TAG_ALLOCATION(m_sp_mask_tag);
+
+    GlobalArray<unsigned int> sp_mask_idx(m_pdata->getMaxN(), m_exec_conf);
+    m_sp_mask_idx.swap(sp_mask_idx);
+    TAG_ALLOCATION(m_sp_mask_idx);
+
     // reset exclusions
     clearExclusions();
 
@@ -229,8 +278,12 @@ void NeighborList::reallocate()
     m_ex_list_idx.resize(m_pdata->getMaxN(), ex_list_height );
     m_ex_list_indexer = Index2D(m_ex_list_idx.getPitch(), ex_list_height);
 
+    // the exclusion and special pair masks by index are gathered again on the forced update
+    m_ex_mask_idx.resize(m_pdata->getMaxN());
+    m_sp_mask_idx.resize(m_pdata->getMaxN());
+
     // resize the head list and number of neighbors per particle
-    m_head_list.resize(m_pdata->getMaxN());
+    m_head_list.resize(m_pdata->getMaxN()+1);
     m_n_neigh.resize(m_pdata->getMaxN());
 
     // force a rebuild
@@ -317,6 +370,12 @@ NeighborList::~NeighborList()
 */
 void NeighborList::compute(unsigned int timestep)
     {
+    MemoryUsageScope memory_scope(m_exec_conf->getMemoryUsage(), "NeighborList");
+
+    // sample the time per step, this may change r_buff
+    if (m_rbuff_tuner)
+        updateRBuffTuner(timestep);
+
     // check if the rcut array has changed and update it
     if (m_rcut_changed)
         {
@@ -327,6 +386,8 @@ void NeighborList::compute(unsigned int timestep)
     if (!shouldCompute(timestep) && !m_force_update)
         return;
 
+    int64_t start_time = (m_metric_time >= 0) ? m_metric_clk.getTime() : 0;
+
     if (m_prof) m_prof->push("Neighbor");
 
     // take care of some updates if things have changed since construction
@@ -336,7 +397,25 @@ void NeighborList::compute(unsigned int timestep)
         buildHeadList();
 
         if (m_exclusions_set)
-            updateExListIdx();
+            {
+            if (useExclusionMask())
+                {
+                // the build checks the masks, translate the idx exclusion list only when it is requested
+                updateExMaskIdx();
+                m_ex_list_idx_stale = true;
+                }
+            else
+                {
+                updateExListIdx();
+                m_ex_list_idx_stale = false;
+                }
+            }
+
+        if (m_special_pairs_set)
+            {
+            resizeSpecialPairMasks();
+            updateSpecialPairMaskIdx();
+            }
         }
 
     // check if the list needs to be updated and update it
@@ -347,11 +426,15 @@ void NeighborList::compute(unsigned int timestep)
         do
             {
             buildNlist(timestep);
+            if (m_exact_storage)
+                recordBuildCounts();
 
             overflowed = checkConditions();
             // if we overflowed, need to reallocate memory and reset the conditions
             if (overflowed)
                 {
+                ++m_overflow_builds;
+
                 // always rebuild the head list after an overflow
                 buildHeadList();
 
@@ -360,13 +443,22 @@ void NeighborList::compute(unsigned int timestep)
                 }
             } while (overflowed);
 
-        if (m_exclusions_set)
+        if (m_exclusions_set && !useExclusionMask())
             filterNlist();
 
+        #ifdef ENABLE_MPI
+        if (m_comm && m_comm->getHalfShell())
+            filterHalfShell();
+        #endif
+
         setLastUpdatedPos();
         m_has_been_updated_once = true;
+        m_exec_conf->getMetrics()->add(m_metric_builds, 1.0);
         }
     if (m_prof) m_prof->pop();
+
+    if (m_metric_time >= 0)
+        m_exec_conf->getMetrics()->add(m_metric_time, double(m_metric_clk.getTime() - start_time)*1e-9);
     }
 
 /*! \param num_iters Number of iterations to average for the benchmark
@@ -452,6 +544,239 @@ void NeighborList::setRCutPair(unsigned int typ1, unsigned int typ2, Scalar r_cu
     forceUpdate();
     }
 
+/*! \param enable Set to true to enable the tuner
+    \param r_buff_min Smallest buffer radius to set
+    \param r_buff_max Largest buffer radius to set
+    \param period Number of time steps over which the time per step is averaged
+
+    The tuner starts from the current buffer radius (clamped to the given range), with a step size of 1/8 of the
+    range. It converges when the step size drops below 1/64 of the range, and restarts when the time per step at the
+    optimum grows by more than 20%. Measurement windows are restarted at the beginning of every run.
+*/
+void NeighborList::setRBuffTuner(bool enable, Scalar r_buff_min, Scalar r_buff_max, unsigned int period)
+    {
+    if (enable)
+        {
+        if (r_buff_min < Scalar(0.0) || r_buff_max <= r_buff_min)
+            {
+            m_exec_conf->msg->error() << "nlist: Invalid buffer radius range for the tuner ["
+                                      << r_buff_min << ", " << r_buff_max << "]" << endl;
+            throw runtime_error("Error changing NeighborList parameters");
+            }
+        if (period == 0)
+            {
+            m_exec_conf->msg->error() << "nlist: The tuner period must be positive" << endl;
+            throw runtime_error("Error changing NeighborList parameters");
+            }
+        }
+
+    m_rbuff_tuner = enable;
+    m_rbuff_tuner_min = r_buff_min;
+    m_rbuff_tuner_max = r_buff_max;
+    m_rbuff_tuner_period = period;
+    m_rbuff_tuner_state = rbuff_tuner_measure;
+    m_rbuff_tuner_dr = (r_buff_max - r_buff_min) / Scalar(8.0);
+    m_rbuff_tuner_pending = Scalar(-1.0);
+    m_rbuff_tuner_window_open = false;
+
+    if (enable && (m_r_buff < r_buff_min || m_r_buff > r_buff_max))
+        setRBuff(std::min(std::max(m_r_buff, r_buff_min), r_buff_max));
+    }
+
+/*! \param timestep Current time step
+
+    Called at the beginning of compute(). Closes the current measurement window after m_rbuff_tuner_period steps and
+    decides on the next buffer radius and check period. A new buffer radius is only requested here, it takes effect
+    in the next time step.
+*/
+void NeighborList::updateRBuffTuner(unsigned int timestep)
+    {
+    // sample only once per time step
+    if (m_rbuff_tuner_window_open && timestep == m_rbuff_tuner_last_step)
+        return;
+    m_rbuff_tuner_last_step = timestep;
+
+    applyRBuffTuner(timestep);
+
+    if (!m_rbuff_tuner_window_open || timestep < m_rbuff_tuner_start_step)
+        {
+        m_rbuff_tuner_window_open = true;
+        m_rbuff_tuner_start_step = timestep;
+        m_rbuff_tuner_start_time = m_rbuff_tuner_clock.getTime();
+        m_rbuff_tuner_dangerous = m_dangerous_updates;
+        m_rbuff_tuner_min_period = UINT_MAX;
+        return;
+        }
+
+    if (timestep < m_rbuff_tuner_start_step + m_rbuff_tuner_period)
+        return;
+
+    // seconds per step in this window
+    int64_t now = m_rbuff_tuner_clock.getTime();
+    double cost = double(now - m_rbuff_tuner_start_time) * 1e-9 / double(timestep - m_rbuff_tuner_start_step);
+    Scalar r_buff_limit = getRBuffTunerMax();
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        // all ranks need to take the same decision
+        MPI_Allreduce(MPI_IN_PLACE, &cost, 1, MPI_DOUBLE, MPI_MAX, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    // the check period follows the rebuild period at the current r_buff
+    if (m_dist_check)
+        {
+        unsigned int every = m_every;
+        if (m_dangerous_updates > m_rbuff_tuner_dangerous)
+            every = std::max(m_every/2, 1u);
+        else if (m_rbuff_tuner_min_period != UINT_MAX)
+            every = std::max(m_rbuff_tuner_min_period/2, 1u);
+
+        if (every != m_every)
+            {
+            m_exec_conf->msg->notice(3) << "nlist: Tuner setting check_period = " << every << endl;
+            m_every = every;
+            }
+        }
+
+    // start the next window
+    m_rbuff_tuner_start_step = timestep;
+    m_rbuff_tuner_start_time = now;
+    m_rbuff_tuner_dangerous = m_dangerous_updates;
+    m_rbuff_tuner_min_period = UINT_MAX;
+
+    // direction of the next trial: 1 larger r_buff, -1 smaller r_buff, 0 reduce the step size
+    int direction = 0;
+    switch (m_rbuff_tuner_state)
+        {
+        case rbuff_tuner_measure:
+            m_rbuff_tuner_best = m_r_buff;
+            m_rbuff_tuner_best_cost = cost;
+            direction = 1;
+            break;
+        case rbuff_tuner_up:
+        case rbuff_tuner_down:
+            {
+            int last_direction = (m_rbuff_tuner_state == rbuff_tuner_up) ? 1 : -1;
+            if (cost < m_rbuff_tuner_best_cost)
+                {
+                // keep going
+                m_rbuff_tuner_best = m_r_buff;
+                m_rbuff_tuner_best_cost = cost;
+                direction = last_direction;
+                }
+            else
+                {
+                direction = last_direction - 1;
+                }
+            break;
+            }
+        case rbuff_tuner_converged:
+            if (cost > Scalar(1.2)*m_rbuff_tuner_best_cost)
+                {
+                m_exec_conf->msg->notice(3) << "nlist: Time per step has increased, restarting the r_buff tuner"
+                                            << endl;
+                m_rbuff_tuner_state = rbuff_tuner_measure;
+                m_rbuff_tuner_dr = (m_rbuff_tuner_max - m_rbuff_tuner_min) / Scalar(8.0);
+                }
+            return;
+        }
+
+    while (true)
+        {
+        if (direction == 0)
+            {
+            m_rbuff_tuner_dr *= Scalar(0.5);
+            if (m_rbuff_tuner_dr < (m_rbuff_tuner_max - m_rbuff_tuner_min) / Scalar(64.0))
+                {
+                m_exec_conf->msg->notice(3) << "nlist: Tuner converged to r_buff = " << m_rbuff_tuner_best << endl;
+                m_rbuff_tuner_state = rbuff_tuner_converged;
+                requestRBuff(m_rbuff_tuner_best, r_buff_limit);
+                break;
+                }
+            direction = 1;
+            }
+
+        if (requestRBuff(m_rbuff_tuner_best + Scalar(direction)*m_rbuff_tuner_dr, r_buff_limit))
+            {
+            m_rbuff_tuner_state = (direction > 0) ? rbuff_tuner_up : rbuff_tuner_down;
+            break;
+            }
+
+        // the trial is out of range, try the other direction
+        direction = (direction > 0) ? -1 : 0;
+        }
+    }
+
+/*! \param r_buff Requested buffer radius
+    \param r_buff_limit Largest allowed buffer radius from getRBuffTunerMax()
+    \returns true if the clamped request differs from the current buffer radius
+*/
+bool NeighborList::requestRBuff(Scalar r_buff, Scalar r_buff_limit)
+    {
+    r_buff = std::min(r_buff, std::min(m_rbuff_tuner_max, r_buff_limit));
+    r_buff = std::max(r_buff, m_rbuff_tuner_min);
+
+    if (std::abs(r_buff - m_r_buff) < Scalar(1e-6))
+        {
+        m_rbuff_tuner_pending = Scalar(-1.0);
+        return false;
+        }
+
+    m_rbuff_tuner_pending = r_buff;
+    return true;
+    }
+
+/*! \param timestep Current time step
+
+    Called from compute() and, in MPI simulations, from peekUpdate(), which runs before the particle migration and
+    the ghost exchange of a time step. The forced update then exchanges the ghosts with the new ghost layer width
+    before the neighbor list is rebuilt.
+*/
+void NeighborList::applyRBuffTuner(unsigned int timestep)
+    {
+    if (m_rbuff_tuner_pending < Scalar(0.0))
+        return;
+
+    m_exec_conf->msg->notice(3) << "nlist: Tuner setting r_buff = " << m_rbuff_tuner_pending << " at step "
+                                << timestep << endl;
+    setRBuff(m_rbuff_tuner_pending);
+    m_rbuff_tuner_pending = Scalar(-1.0);
+
+    // measure the new r_buff from the next step on
+    m_rbuff_tuner_window_open = false;
+    }
+
+/*! \returns The largest buffer radius for which the ghost layer fits in half of the local domain, along the
+    directions that are decomposed. Other contributions to the ghost layer width are assumed unchanged.
+    The limit is reduced over all ranks.
+*/
+Scalar NeighborList::getRBuffTunerMax()
+    {
+    Scalar r_buff_limit = m_rbuff_tuner_max;
+
+    #ifdef ENABLE_MPI
+    if (m_comm && m_pdata->getDomainDecomposition())
+        {
+        const Scalar3 L = m_pdata->getBox().getNearestPlaneDistance();
+        const Index3D& di = m_pdata->getDomainDecomposition()->getDomainIndexer();
+        const Scalar r_other = m_comm->getGhostLayerMaxWidth() - m_r_buff;
+
+        if (di.getW() > 1)
+            r_buff_limit = std::min(r_buff_limit, Scalar(0.99)*L.x/Scalar(2.0) - r_other);
+        if (di.getH() > 1)
+            r_buff_limit = std::min(r_buff_limit, Scalar(0.99)*L.y/Scalar(2.0) - r_other);
+        if (di.getD() > 1)
+            r_buff_limit = std::min(r_buff_limit, Scalar(0.99)*L.z/Scalar(2.0) - r_other);
+
+        MPI_Allreduce(MPI_IN_PLACE, &r_buff_limit, 1, MPI_HOOMD_SCALAR, MPI_MIN, m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    return r_buff_limit;
+    }
+
 /*! \param r_buff New buffer radius to set
     \note Changing the buffer radius does NOT immediately update the neighborlist.
             The new buffer will take effect when compute is called for the next timestep.
@@ -599,6 +924,19 @@ void NeighborList::addExclusion(unsigned int tag1, unsigned int tag2)
         h_n_ex_tag.data[tag2]++;
         }
 
+    // encode exclusions close in tag order in the exclusion masks
+    int dtag = int(tag2) - int(tag1);
+    if (dtag != 0 && dtag <= NLIST_EXCLUSION_WINDOW && dtag >= -NLIST_EXCLUSION_WINDOW)
+        {
+        ArrayHandle<unsigned int> h_ex_mask_tag(m_ex_mask_tag, access_location::host, access_mode::readwrite);
+        h_ex_mask_tag.data[tag1] |= getExclusionMaskBit(dtag);
+        h_ex_mask_tag.data[tag2] |= getExclusionMaskBit(-dtag);
+        }
+    else if (dtag != 0)
+        {
+        m_n_ex_outside_window++;
+        }
+
     forceUpdate();
     }
 
@@ -610,6 +948,7 @@ void NeighborList::clearExclusions()
     if (m_need_reallocate_exlist)
         {
         m_n_ex_tag.resize(m_pdata->getRTags().size());
+        m_ex_mask_tag.resize(m_pdata->getRTags().size());
 
         // slave the width of the exclusion list to the capacity of the number of exclusions array
         // in order to amortize reallocation costs
@@ -628,7 +967,15 @@ void NeighborList::clearExclusions()
 
     memset(h_n_ex_tag.data, 0, sizeof(unsigned int)*m_n_ex_tag.getNumElements());
     memset(h_n_ex_idx.data, 0, sizeof(unsigned int)*m_n_ex_idx.getNumElements());
+
+    ArrayHandle<unsigned int> h_ex_mask_tag(m_ex_mask_tag, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_ex_mask_idx(m_ex_mask_idx, access_location::host, access_mode::overwrite);
+
+    memset(h_ex_mask_tag.data, 0, sizeof(unsigned int)*m_ex_mask_tag.getNumElements());
+    memset(h_ex_mask_idx.data, 0, sizeof(unsigned int)*m_ex_mask_idx.getNumElements());
     m_exclusions_set = false;
+    m_n_ex_outside_window = 0;
+    m_ex_list_idx_stale = false;
 
     forceUpdate();
     }
@@ -882,6 +1229,79 @@ void NeighborList::addExclusionsFromPairs()
         addExclusion(pairs[i].tag[0], pairs[i].tag[1]);
     }
 
+/*! The special pairs stay in the neighbor list and are flagged in the special pair masks, so that the pair potentials
+    can scale their contribution. Special pairs that are also excluded are not evaluated at all.
+*/
+void NeighborList::addSpecialPairsFromPairs()
+    {
+    std::shared_ptr<PairData> pair_data = m_sysdef->getPairData();
+
+    // access pair data by snapshot
+    PairData::Snapshot snapshot;
+    pair_data->takeSnapshot(snapshot);
+
+    // broadcast global pair list
+    std::vector<PairData::members_t> pairs;
+
+#ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        if (m_exec_conf->getRank() == 0)
+            pairs = snapshot.groups;
+
+        bcast(pairs, 0, m_exec_conf->getMPICommunicator());
+        }
+    else
+#endif
+        {
+        pairs = snapshot.groups;
+        }
+
+    if (!m_special_pairs_set)
+        m_sp_mask_tag.clear();
+    resizeSpecialPairMasks();
+
+    ArrayHandle<unsigned int> h_sp_mask_tag(m_sp_mask_tag, access_location::host, access_mode::readwrite);
+
+    unsigned int n_excluded = 0;
+    for (unsigned int i = 0; i < pairs.size(); i++)
+        {
+        unsigned int tag1 = pairs[i].tag[0];
+        unsigned int tag2 = pairs[i].tag[1];
+
+        int dtag = int(tag2) - int(tag1);
+        if (dtag == 0 || dtag > NLIST_EXCLUSION_WINDOW || dtag < -NLIST_EXCLUSION_WINDOW)
+            {
+            m_exec_conf->msg->error() << "nlist: Special pair " << tag1 << " " << tag2 << " is more than "
+                                      << NLIST_EXCLUSION_WINDOW << " apart in tag order" << endl;
+            m_exec_conf->msg->error() << "Evaluate the special pairs with special_pair instead" << endl;
+            throw runtime_error("Error setting special pairs");
+            }
+
+        if (m_exclusions_set && !m_need_reallocate_exlist && isExcluded(tag1, tag2))
+            n_excluded++;
+
+        h_sp_mask_tag.data[tag1] |= getExclusionMaskBit(dtag);
+        h_sp_mask_tag.data[tag2] |= getExclusionMaskBit(-dtag);
+        }
+
+    if (n_excluded)
+        m_exec_conf->msg->warning() << "nlist: " << n_excluded << " special pairs are also excluded and will "
+                                    << "not be evaluated" << endl;
+
+    m_special_pairs_set = true;
+    forceUpdate();
+    }
+
+/*! \post No pairs are flagged as special pairs
+*/
+void NeighborList::clearSpecialPairs()
+    {
+    m_special_pairs_set = false;
+    ArrayHandle<unsigned int> h_sp_mask_idx(m_sp_mask_idx, access_location::host, access_mode::overwrite);
+    memset(h_sp_mask_idx.data, 0, sizeof(unsigned int)*m_sp_mask_idx.getNumElements());
+    }
+
 /*! \param tag1 First particle tag in the pair
     \param tag2 Second particle tag in the pair
     \return true if the particles \a tag1 and \a tag2 have been excluded from the neighbor list
@@ -1093,14 +1513,11 @@ bool NeighborList::distanceCheck(unsigned int timestep)
 
     // get a local copy of the simulation box too
     const BoxDim& box = m_pdata->getBox();
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    const BoxDim last_box = getLastBox();
 
-    // get current nearest plane distances
-    Scalar3 L_g = m_pdata->getGlobalBox().getNearestPlaneDistance();
-
-    // Find direction of maximum box length contraction (smallest eigenvalue of deformation tensor)
-    Scalar3 lambda = L_g / m_last_L;
-    Scalar lambda_min = (lambda.x < lambda.y) ? lambda.x : lambda.y;
-    lambda_min = (lambda_min < lambda.z) ? lambda_min : lambda.z;
+    // maximum contraction of any pair separation under the box deformation
+    Scalar lambda_min = getMinDeformation(last_box);
 
     ArrayHandle<Scalar4> h_last_pos(m_last_pos, access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_rcut_max(m_rcut_max, access_location::host, access_mode::read);
@@ -1119,9 +1536,10 @@ bool NeighborList::distanceCheck(unsigned int timestep)
         const Scalar delta_max = (rmax*lambda_min - old_rmin)/Scalar(2.0);
         Scalar maxsq = (delta_max > 0) ? delta_max*delta_max : 0;
 
-        Scalar3 dx = make_scalar3(h_pos.data[i].x - lambda.x*h_last_pos.data[i].x,
-                                  h_pos.data[i].y - lambda.y*h_last_pos.data[i].y,
-                                  h_pos.data[i].z - lambda.z*h_last_pos.data[i].z);
+        // carry the last position along with the box deformation in fractional coordinates
+        Scalar3 last_pos = make_scalar3(h_last_pos.data[i].x, h_last_pos.data[i].y, h_last_pos.data[i].z);
+        Scalar3 affine_pos = global_box.makeCoordinates(last_box.makeFraction(last_pos));
+        Scalar3 dx = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z) - affine_pos;
 
         dx = box.minImage(dx);
 
@@ -1139,12 +1557,15 @@ bool NeighborList::distanceCheck(unsigned int timestep)
         // check if migrate criterion is fulfilled on any rank
         int local_result = result ? 1 : 0;
         int global_result = 0;
-        MPI_Allreduce(&local_result,
-            &global_result,
-            1,
-            MPI_INT,
-            MPI_MAX,
-            m_exec_conf->getMPICommunicator());
+            {
+            MetricsTimer timer(m_exec_conf->getMetrics(), m_metric_collective_time);
+            MPI_Allreduce(&local_result,
+                &global_result,
+                1,
+                MPI_INT,
+                MPI_MAX,
+                m_exec_conf->getMPICommunicator());
+            }
         result = (global_result > 0);
         if (m_prof) m_prof->pop();
         }
@@ -1156,6 +1577,93 @@ bool NeighborList::distanceCheck(unsigned int timestep)
     return result;
     }
 
+/*! \returns The global box at the last update, with the lattice-equivalent tilt factors closest to the current box
+
+    A sheared box whose tilt factors are reduced (Lees-Edwards flip) describes the same periodic system, so the
+    deformation since the last update is measured against the equivalent last box.
+*/
+BoxDim NeighborList::getLastBox() const
+    {
+    const BoxDim& box = m_pdata->getGlobalBox();
+    return m_last_box.getLatticeEquivalent(box.getTiltFactorXY(), box.getTiltFactorXZ(), box.getTiltFactorYZ());
+    }
+
+/*! \param last_box Global box at the last update
+    \returns The smallest singular value of the deformation tensor F = H H_last^-1, where H and H_last are the matrices
+        of lattice vectors of the current global box and of \a last_box
+
+    Every pair separation r, including those of periodic images, is mapped to F r by an affine box change and is
+    contracted by at most this factor. The distance check carries the last positions along with the box, so that
+    shear and compression protocols only rebuild the neighbor list once the accumulated strain uses up the buffer.
+*/
+Scalar NeighborList::getMinDeformation(const BoxDim& last_box) const
+    {
+    const BoxDim& box = m_pdata->getGlobalBox();
+
+    // H and H_last are upper triangular, so is F
+    Scalar H_last[3][3], H_last_inv[3][3], H[3][3], F[3][3];
+    for (unsigned int j = 0; j < 3; j++)
+        {
+        Scalar3 a_last = last_box.getLatticeVector(j);
+        Scalar3 a = box.getLatticeVector(j);
+        H_last[0][j] = a_last.x; H_last[1][j] = a_last.y; H_last[2][j] = a_last.z;
+        H[0][j] = a.x; H[1][j] = a.y; H[2][j] = a.z;
+        }
+
+    H_last_inv[0][0] = Scalar(1.0)/H_last[0][0];
+    H_last_inv[1][1] = Scalar(1.0)/H_last[1][1];
+    H_last_inv[2][2] = Scalar(1.0)/H_last[2][2];
+    H_last_inv[0][1] = -H_last[0][1]*H_last_inv[0][0]*H_last_inv[1][1];
+    H_last_inv[1][2] = -H_last[1][2]*H_last_inv[1][1]*H_last_inv[2][2];
+    H_last_inv[0][2] = -(H_last[0][1]*H_last_inv[1][2] + H_last[0][2]*H_last_inv[2][2])*H_last_inv[0][0];
+    H_last_inv[1][0] = H_last_inv[2][0] = H_last_inv[2][1] = Scalar(0.0);
+
+    for (unsigned int i = 0; i < 3; i++)
+        for (unsigned int j = 0; j < 3; j++)
+            {
+            F[i][j] = Scalar(0.0);
+            for (unsigned int k = 0; k < 3; k++)
+                F[i][j] += H[i][k]*H_last_inv[k][j];
+            }
+
+    // C = F^T F
+    Scalar C[3][3];
+    for (unsigned int i = 0; i < 3; i++)
+        for (unsigned int j = 0; j < 3; j++)
+            {
+            C[i][j] = Scalar(0.0);
+            for (unsigned int k = 0; k < 3; k++)
+                C[i][j] += F[k][i]*F[k][j];
+            }
+
+    // smallest eigenvalue of the symmetric matrix C (Smith, Commun. ACM 4, 168 (1961))
+    Scalar eig_min;
+    Scalar p1 = C[0][1]*C[0][1] + C[0][2]*C[0][2] + C[1][2]*C[1][2];
+    Scalar q = (C[0][0] + C[1][1] + C[2][2])/Scalar(3.0);
+    Scalar p2 = (C[0][0]-q)*(C[0][0]-q) + (C[1][1]-q)*(C[1][1]-q) + (C[2][2]-q)*(C[2][2]-q) + Scalar(2.0)*p1;
+    if (p1 == Scalar(0.0) || p2 == Scalar(0.0))
+        {
+        eig_min = std::min(C[0][0], std::min(C[1][1], C[2][2]));
+        }
+    else
+        {
+        Scalar p = sqrt(p2/Scalar(6.0));
+        Scalar B[3][3];
+        for (unsigned int i = 0; i < 3; i++)
+            for (unsigned int j = 0; j < 3; j++)
+                B[i][j] = (C[i][j] - ((i == j) ? q : Scalar(0.0)))/p;
+
+        Scalar r = Scalar(0.5)*(B[0][0]*(B[1][1]*B[2][2] - B[1][2]*B[2][1])
+                                - B[0][1]*(B[1][0]*B[2][2] - B[1][2]*B[2][0])
+                                + B[0][2]*(B[1][0]*B[2][1] - B[1][1]*B[2][0]));
+        r = std::max(Scalar(-1.0), std::min(Scalar(1.0), r));
+        Scalar phi = acos(r)/Scalar(3.0);
+        eig_min = q + Scalar(2.0)*p*cos(phi + Scalar(2.0*M_PI/3.0));
+        }
+
+    return (eig_min > Scalar(0.0)) ? sqrt(eig_min) : Scalar(0.0);
+    }
+
 /*! Copies the current positions of all particles over to m_last_x etc...
 */
 void NeighborList::setLastUpdatedPos()
@@ -1176,7 +1684,7 @@ void NeighborList::setLastUpdatedPos()
         }
 
     // update last box nearest plane distance
-    m_last_L = m_pdata->getGlobalBox().getNearestPlaneDistance();
+    m_last_box = m_pdata->getGlobalBox();
     m_last_L_local = m_pdata->getBox().getNearestPlaneDistance();
 
     if (m_prof) m_prof->pop();
@@ -1261,6 +1769,9 @@ bool NeighborList::needsUpdating(unsigned int timestep)
                 if (period >= m_update_periods.size())
                     period = m_update_periods.size()-1;
                 m_update_periods[period]++;
+
+                if (period < m_rbuff_tuner_min_period)
+                    m_rbuff_tuner_min_period = period;
                 }
 
             m_last_updated_tstep = timestep;
@@ -1273,6 +1784,7 @@ bool NeighborList::needsUpdating(unsigned int timestep)
         {
         m_exec_conf->msg->notice(2) << "nlist: Dangerous neighborlist build occurred. Continuing this simulation may produce incorrect results and/or program crashes. Decrease the neighborlist check_period and rerun." << endl;
         m_dangerous_updates += 1;
+        m_exec_conf->getMetrics()->add(m_metric_dangerous_builds, 1.0);
         }
 
     m_last_check_result = result;
@@ -1318,11 +1830,20 @@ void NeighborList::printStats()
     m_exec_conf->msg->notice(1) << "n_neigh_min: " << n_neigh_min << " / n_neigh_max: " << n_neigh_max << " / n_neigh_avg: " << n_neigh_avg << endl;
 
     m_exec_conf->msg->notice(1) << "shortest rebuild period: " << getSmallestRebuild() << endl;
+
+    if (m_exact_storage)
+        {
+        m_exec_conf->msg->notice(1) << "exact storage: " << m_nlist.getNumElements() << " neighbors allocated / "
+                                    << m_overflow_builds << " overflow rebuilds" << endl;
+        }
     }
 
 void NeighborList::resetStats()
     {
-    m_updates = m_forced_updates = m_dangerous_updates = 0;
+    m_updates = m_forced_updates = m_dangerous_updates = m_overflow_builds = 0;
+
+    // do not count the time between runs
+    m_rbuff_tuner_window_open = false;
 
     for (unsigned int i = 0; i < m_update_periods.size(); i++)
         m_update_periods[i] = 0;
@@ -1338,6 +1859,19 @@ unsigned int NeighborList::getSmallestRebuild()
     return m_update_periods.size();
     }
 
+/*! \param cost Cost per local particle, to be incremented
+
+    The pair force work of a particle is proportional to its number of neighbors. The neighbor counts of the last
+    build are used, particles added since then (which have no count yet) are left unchanged.
+*/
+void NeighborList::addParticleCost(std::vector<Scalar>& cost)
+    {
+    ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::read);
+    const unsigned int n = std::min((unsigned int)cost.size(), std::min(m_pdata->getN(), (unsigned int)m_n_neigh.getNumElements()));
+    for (unsigned int i = 0; i < n; i++)
+        cost[i] += Scalar(h_n_neigh.data[i]);
+    }
+
 /*! This method is now deprecated, and deriving classes must supply it.
 */
 void NeighborList::buildNlist(unsigned int timestep)
@@ -1389,6 +1923,50 @@ void NeighborList::updateExListIdx()
         m_prof->pop();
     }
 
+/*! Gathers the exclusion masks set in \c m_ex_mask_tag by particle index into \c m_ex_mask_idx
+*/
+void NeighborList::updateExMaskIdx()
+    {
+    if (m_prof)
+        m_prof->push("update-ex-mask");
+
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_ex_mask_tag(m_ex_mask_tag, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_ex_mask_idx(m_ex_mask_idx, access_location::host, access_mode::overwrite);
+
+    for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
+        h_ex_mask_idx.data[idx] = h_ex_mask_tag.data[h_tag.data[idx]];
+
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! Particles added after the special pairs have been set have no special pairs
+*/
+void NeighborList::resizeSpecialPairMasks()
+    {
+    unsigned int old_size = m_sp_mask_tag.size();
+    unsigned int new_size = m_pdata->getRTags().size();
+    if (new_size <= old_size)
+        return;
+
+    m_sp_mask_tag.resize(new_size);
+    ArrayHandle<unsigned int> h_sp_mask_tag(m_sp_mask_tag, access_location::host, access_mode::readwrite);
+    memset(h_sp_mask_tag.data + old_size, 0, sizeof(unsigned int)*(new_size - old_size));
+    }
+
+/*! Gathers the special pair masks set in \c m_sp_mask_tag by particle index into \c m_sp_mask_idx
+*/
+void NeighborList::updateSpecialPairMaskIdx()
+    {
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_sp_mask_tag(m_sp_mask_tag, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_sp_mask_idx(m_sp_mask_idx, access_location::host, access_mode::overwrite);
+
+    for (unsigned int idx = 0; idx < m_pdata->getN(); idx++)
+        h_sp_mask_idx.data[idx] = h_sp_mask_tag.data[h_tag.data[idx]];
+    }
+
 /*! Loops through the neighbor list and filters out any excluded pairs
 */
 void NeighborList::filterNlist()
@@ -1444,9 +2022,59 @@ void NeighborList::filterNlist()
         m_prof->pop();
     }
 
+#ifdef ENABLE_MPI
+/*! With the half-shell ghost exchange, the pairs with a ghost that is not in the forward half-shell of this rank are
+    evaluated by the owner of the ghost, and are removed from the list.
+*/
+void NeighborList::filterHalfShell()
+    {
+    if (m_storage_mode != half)
+        {
+        m_exec_conf->msg->error() << "nlist: The half-shell ghost exchange requires a half neighbor list" << std::endl;
+        throw std::runtime_error("Error filtering neighbor list");
+        }
+
+    if (m_prof)
+        m_prof->push("filter half-shell");
+
+    const unsigned int N = m_pdata->getN();
+    ArrayHandle<unsigned int> h_ghost_half_shell(m_comm->getGhostHalfShellFlags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::readwrite);
+
+    for (unsigned int idx = 0; idx < N; idx++)
+        {
+        unsigned int myHead = h_head_list.data[idx];
+        unsigned int n_neigh = h_n_neigh.data[idx];
+        unsigned int new_n_neigh = 0;
+
+        for (unsigned int cur_neigh_idx = 0; cur_neigh_idx < n_neigh; cur_neigh_idx++)
+            {
+            unsigned int cur_neigh = h_nlist.data[myHead + cur_neigh_idx];
+
+            // keep the local neighbors, and the ghosts in the forward half-shell
+            if (cur_neigh < N || h_ghost_half_shell.data[cur_neigh - N])
+                {
+                h_nlist.data[myHead + new_n_neigh] = cur_neigh;
+                new_n_neigh++;
+                }
+            }
+
+        h_n_neigh.data[idx] = new_n_neigh;
+        }
+
+    if (m_prof)
+        m_prof->pop();
+    }
+#endif
+
 /*!
  * Iterates through each particle, and calculates a running sum of the starting index for that particle
- * in the flat array of neighbors.
+ * in the flat array of neighbors. The element after the last particle holds the total size.
+ *
+ * With exact storage, the particles of the last build reserve their recorded number of neighbors plus the slack,
+ * and are found by their tag because the particles may have been reordered since.
  *
  * \note The neighbor list is also resized when it requires more memory than is currently allocated.
  */
@@ -1454,20 +2082,46 @@ void NeighborList::buildHeadList()
     {
     if (m_prof) m_prof->push("head-list");
 
+    const unsigned int N = m_pdata->getN();
     unsigned int headAddress = 0;
         {
         ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::overwrite);
         ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
 
-        for (unsigned int i=0; i < m_pdata->getN(); ++i)
+        // number of neighbors to reserve for each particle
+        for (unsigned int i=0; i < N; ++i)
             {
+            unsigned int myType = __scalar_as_int(h_pos.data[i].w);
+            h_head_list.data[i] = h_Nmax.data[myType];
+            }
+
+        if (m_exact_storage && m_build_N > 0)
+            {
+            ArrayHandle<unsigned int> h_build_count(m_build_count, access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_build_tag(m_build_tag, access_location::host, access_mode::read);
+            ArrayHandle<unsigned int> h_rtag(m_pdata->getRTags(), access_location::host, access_mode::read);
+            const unsigned int ntags = m_pdata->getRTags().size();
+
+            for (unsigned int i=0; i < m_build_N; ++i)
+                {
+                const unsigned int tag = h_build_tag.data[i];
+                const unsigned int idx = (tag < ntags) ? h_rtag.data[tag] : NOT_LOCAL;
+                if (idx < N)
+                    h_head_list.data[idx] = h_build_count.data[i] + m_storage_slack;
+                }
+            }
+
+        // exclusive prefix sum
+        for (unsigned int i=0; i < N; ++i)
+            {
+            unsigned int n = h_head_list.data[i];
             h_head_list.data[i] = headAddress;
 
             // move the head address along
-            unsigned int myType = __scalar_as_int(h_pos.data[i].w);
-            headAddress += h_Nmax.data[myType];
+            headAddress += n;
             }
+        h_head_list.data[N] = headAddress;
         }
 
     resizeNlist(headAddress);
@@ -1475,6 +2129,34 @@ void NeighborList::buildHeadList()
     if (m_prof) m_prof->pop();
     }
 
+/*!
+ * The counts include neighbors that did not fit into the storage of a particle, and particles with exclusions
+ * keep the count from before filterNlist().
+ */
+void NeighborList::recordBuildCounts()
+    {
+    if (m_build_count.getNumElements() < m_pdata->getMaxN())
+        {
+        GlobalArray<unsigned int> build_count(m_pdata->getMaxN(), m_exec_conf);
+        m_build_count.swap(build_count);
+        TAG_ALLOCATION(m_build_count);
+
+        GlobalArray<unsigned int> build_tag(m_pdata->getMaxN(), m_exec_conf);
+        m_build_tag.swap(build_tag);
+        TAG_ALLOCATION(m_build_tag);
+        }
+
+    const unsigned int N = m_pdata->getN();
+    ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_build_count(m_build_count, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_build_tag(m_build_tag, access_location::host, access_mode::overwrite);
+
+    std::copy(h_n_neigh.data, h_n_neigh.data + N, h_build_count.data);
+    std::copy(h_tag.data, h_tag.data + N, h_build_tag.data);
+    m_build_N = N;
+    }
+
 /*!
  * \param size the requested number of elements in the neighbor list
  *
@@ -1503,7 +2185,8 @@ void NeighborList::resizeNlist(unsigned int size)
  * \returns false if all particle types have enough memory for their neighbors
  *
  * The maximum number of neighbors per particle (rounded up to the nearest 8, min of 8) is recomputed when
- * an overflow happens.
+ * an overflow happens. With exact storage, a particle can also overflow a storage smaller than Nmax of its type,
+ * which the builds flag with a nonzero condition.
  */
 bool NeighborList::checkConditions()
     {
@@ -1518,6 +2201,10 @@ bool NeighborList::checkConditions()
             h_Nmax.data[i] = (h_conditions.data[i] > 8) ? (h_conditions.data[i] + 7) & ~7 : 8;
             result = true;
             }
+        else if (m_exact_storage && h_conditions.data[i] > 0)
+            {
+            result = true;
+            }
         }
 
     return result;
@@ -1568,6 +2255,10 @@ bool NeighborList::peekUpdate(unsigned int timestep)
     {
     if (m_prof) m_prof->push("Neighbor");
 
+    // a new r_buff must be known before the ghost layer is exchanged
+    if (m_rbuff_tuner)
+        applyRBuffTuner(timestep);
+
     bool result = needsUpdating(timestep);
 
     if (m_prof) m_prof->pop();
@@ -1636,7 +2327,12 @@ void export_NeighborList(py::module& m)
         .def("setRCutPair", &NeighborList::setRCutPair)
         .def("setRBuff", &NeighborList::setRBuff)
         .def("setEvery", &NeighborList::setEvery)
+        .def("setRBuffTuner", &NeighborList::setRBuffTuner)
+        .def("getRBuff", &NeighborList::getRBuff)
         .def("setStorageMode", &NeighborList::setStorageMode)
+        .def("setExactStorage", &NeighborList::setExactStorage)
+        .def("getExactStorage", &NeighborList::getExactStorage)
+        .def("getNlistSize", &NeighborList::getNlistSize)
         .def("addExclusion", &NeighborList::addExclusion)
         .def("clearExclusions", &NeighborList::clearExclusions)
         .def("countExclusions", &NeighborList::countExclusions)
@@ -1645,6 +2341,9 @@ void export_NeighborList(py::module& m)
         .def("addExclusionsFromDihedrals", &NeighborList::addExclusionsFromDihedrals)
         .def("addExclusionsFromConstraints", &NeighborList::addExclusionsFromConstraints)
         .def("addExclusionsFromPairs", &NeighborList::addExclusionsFromPairs)
+        .def("addSpecialPairsFromPairs", &NeighborList::addSpecialPairsFromPairs)
+        .def("clearSpecialPairs", &NeighborList::clearSpecialPairs)
+        .def("getSpecialPairsSet", &NeighborList::getSpecialPairsSet)
         .def("addOneThreeExclusionsFromTopology", &NeighborList::addOneThreeExclusionsFromTopology)
         .def("addOneFourExclusionsFromTopology", &NeighborList::addOneFourExclusionsFromTopology)
         .def("setFilterBody", &NeighborList::setFilterBody)
@@ -9,6 +9,8 @@
 #include "hoomd/GPUVector.h"
 #include "hoomd/GPUFlags.h"
 #include "hoomd/Index1D.h"
+#include "hoomd/ClockSource.h"
+#include "NeighborListExclusionMask.h"
 
 #include <memory>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
@@ -54,7 +56,15 @@
     flat list is supplied for each particle which specifies where to start reading neighbors from the list
     (a "head" list). Each element in the list stores the index of the neighbor with the highest bits reserved for flags.
     The head list for accessing elements can be gotten with getHeadList()
-    and the array itself can be accessed with getNlistArray().
+    and the array itself can be accessed with getNlistArray(). The head list has N+1 entries, the storage of particle
+    \a i ends at <code>head_list[i+1]</code>, and the builds bound the neighbors they write by this difference.
+
+    By default, every particle of a type reserves the largest number of neighbors of any particle of that type
+    (Nmax). With exact storage (setExactStorage()), each particle instead reserves the number of neighbors it had in
+    the last build plus a small slack. The counts of the last build are stored with the particle tags, so that they
+    carry over particle sorts and migrations. A particle without a previous count (e.g. one that just arrived on
+    the rank) reserves Nmax of its type. A build with an overflowing particle counts the neighbors of every particle,
+    the head list is then laid out from these counts with an exclusive prefix sum and the list is built again.
 
     The number of neighbors for each particle is stored in an auxiliary array accessed with getNNeighArray().
 
@@ -91,6 +101,17 @@
     setEvery takes a dist_check parameter. When dist_check=True, the above described behavior is followed. When
     dist_check is false, the nlist is built exactly m_every steps. This is intended for use in profiling only.
 
+    \b Buffer tuning:
+
+    When enabled with setRBuffTuner(), the neighbor list tunes r_buff and the check period while the simulation runs.
+    The wall clock time per step is averaged over windows of a given number of steps. Between windows, r_buff is moved
+    by a step size in the direction that lowers the time per step, and the step size is halved when neither direction
+    improves. This balances the cost of the rebuilds against the cost of the larger pair list. The check period is set
+    to half the smallest rebuild period observed in the last window, and halved after a dangerous build. In MPI
+    simulations, the measured times are reduced over all ranks so that they take the same decisions, the new r_buff is
+    applied before the next particle migration (see peekUpdate()), and r_buff is limited so that the ghost layer fits
+    in the local domain.
+
     \b Exclusions:
 
     Exclusions are stored in \a ex_list, a data structure similar in structure to \a nlist, except this time exclusions
@@ -99,6 +120,20 @@
     through the neighbor list and removes any particles that are excluded. This allows an arbitrary number of exclusions
     to be processed without slowing the performance of the buildNlist() step itself.
 
+    Exclusions between particles at most NLIST_EXCLUSION_WINDOW apart in tag order, such as the 1-2, 1-3 and 1-4
+    exclusions of polymers numbered along the chain, are also encoded in one bit mask per particle (\a ex_mask). When
+    all exclusions fit in the masks and the derived class supportsExclusionMask(), the build checks the masks inline
+    and neither filterNlist() nor updateExListIdx() are called. The index based list is then only translated when it
+    is requested with getNExArray() or getExListArray().
+
+    \b Special pairs:
+
+    Instead of excluding the 1-4 special pairs (PairData) and evaluating them in a separate PotentialSpecialPair,
+    addSpecialPairsFromPairs() keeps them in the neighbor list and flags them in special pair masks, which have the
+    same encoding as the exclusion masks. Pair potentials then scale their contribution (see
+    PotentialPair::setSpecialPairScale()). All special pairs must be at most NLIST_EXCLUSION_WINDOW apart in tag order.
+    Like the exclusions, the masks are set once from the current special pairs.
+
     <b>Overflow handling:</b>
     For easy support of derived GPU classes to implement overflow detection the overflow condition is stored in the
     GlobalArray \a d_conditions.
@@ -140,6 +175,9 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Change the global buffer radius
         virtual void setRBuff(Scalar r_buff);
 
+        //! Enable or disable the online tuning of the buffer radius and the check period
+        void setRBuffTuner(bool enable, Scalar r_buff_min, Scalar r_buff_max, unsigned int period);
+
         //! Change how many timesteps before checking to see if the list should be rebuilt
         /*! \param every Number of time steps to wait before beginning to check if particles have moved a sufficient distance
                    to require a neighbor list update.
@@ -176,6 +214,32 @@ class PYBIND11_EXPORT NeighborList : public Compute
             return m_storage_mode;
             }
 
+        //! Enable / disable sizing the storage of each particle by its own number of neighbors
+        /*! \param exact True to reserve the storage per particle, false to reserve Nmax of its type
+            \param slack Number of neighbors to reserve in addition to the count of the last build
+        */
+        void setExactStorage(bool exact, unsigned int slack)
+            {
+            m_exact_storage = exact;
+            m_storage_slack = slack;
+            m_build_N = 0;
+            forceUpdate();
+            }
+
+        //! Get whether the storage of each particle is sized by its own number of neighbors
+        bool getExactStorage() const
+            {
+            return m_exact_storage;
+            }
+
+        //! Get the size of the neighbor list storage
+        /*! \returns The number of neighbors that can be stored for all particles
+        */
+        unsigned int getNlistSize() const
+            {
+            return m_nlist.getNumElements();
+            }
+
         //! Get the maximum of all rcut
         Scalar getMaxRCut()
             {
@@ -224,6 +288,9 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Clear the count of updates the neighborlist has performed
         virtual void resetStats();
 
+        //! Add the number of neighbors of each particle to its cost
+        virtual void addParticleCost(std::vector<Scalar>& cost);
+
         //! Gets the shortest rebuild period this nlist has experienced since a call to resetStats
         unsigned int getSmallestRebuild();
 
@@ -252,15 +319,29 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Get the number of exclusions array
         const GlobalArray<unsigned int>& getNExArray()
             {
+            checkExListIdx();
             return m_n_ex_idx;
             }
 
          //! Get the exclusion list
          const GlobalArray<unsigned int>& getExListArray()
             {
+            checkExListIdx();
             return m_ex_list_idx;
             }
 
+        //! Get the exclusion masks by particle index
+        const GlobalArray<unsigned int>& getExMaskArray()
+            {
+            return m_ex_mask_idx;
+            }
+
+        //! Test if the build checks the exclusions inline with the exclusion masks
+        bool useExclusionMask()
+            {
+            return m_exclusions_set && m_n_ex_outside_window == 0 && supportsExclusionMask();
+            }
+
         //! Get the neighbor list indexer
         /*! \note Do not save indexers across calls. Get a new indexer after every call to compute() - they will
             change.
@@ -270,6 +351,26 @@ class PYBIND11_EXPORT NeighborList : public Compute
             return m_ex_list_indexer;
             }
 
+        //! Get the number of exclusions per particle tag
+        const GlobalVector<unsigned int>& getNExTagArray()
+            {
+            return m_n_ex_tag;
+            }
+
+        //! Get the exclusion list referenced by tag
+        /*! Unlike the index based list, the tag based exclusions are current without calling compute().
+        */
+        const GlobalArray<unsigned int>& getExListTagArray()
+            {
+            return m_ex_list_tag;
+            }
+
+        //! Get the indexer for the exclusion list referenced by tag
+        const Index2D& getExListTagIndexer()
+            {
+            return m_ex_list_indexer_tag;
+            }
+
         bool getExclusionsSet()
             {
             return m_exclusions_set;
@@ -320,6 +421,26 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Test if an exclusion has been made
         bool isExcluded(unsigned int tag1, unsigned int tag2);
 
+        //! Flag every pair in the PairData in the special pair masks
+        void addSpecialPairsFromPairs();
+
+        //! Clear the special pair masks
+        void clearSpecialPairs();
+
+        //! Test if any special pairs are flagged
+        bool getSpecialPairsSet() const
+            {
+            return m_special_pairs_set;
+            }
+
+        //! Get the special pair masks by particle index
+        /*! The masks are current after compute(). Test a pair with isExcludedByMask().
+        */
+        const GlobalArray<unsigned int>& getSpecialPairMaskArray()
+            {
+            return m_sp_mask_idx;
+            }
+
         //! Add an exclusion for every 1,3 pair
         void addOneThreeExclusionsFromTopology();
 
@@ -436,6 +557,17 @@ class PYBIND11_EXPORT NeighborList : public Compute
         /*! \param timestep The current timestep
          */
         bool peekUpdate(unsigned int timestep);
+
+        //! Returns true if the rebuild check for this time step found the current list to be valid
+        /*! \param timestep The current timestep
+         *
+         *  Unlike peekUpdate(), this does not change the state of the neighbor list. It is meant to be called after
+         *  the migration check (peekUpdate()) for \a timestep, when compute() is known not to rebuild the list.
+         */
+        bool isValidAt(unsigned int timestep) const
+            {
+            return m_last_checked_tstep == timestep && !m_last_check_result && !m_force_update && !m_rcut_changed;
+            }
 #endif
 
         //! Return true if the neighbor list has been updated this time step
@@ -469,13 +601,19 @@ class PYBIND11_EXPORT NeighborList : public Compute
         GlobalArray<unsigned int> m_nlist;      //!< Neighbor list data
         GlobalArray<unsigned int> m_n_neigh;    //!< Number of neighbors for each particle
         GlobalArray<Scalar4> m_last_pos;        //!< coordinates of last updated particle positions
-        Scalar3 m_last_L;                    //!< Box lengths at last update
+        BoxDim m_last_box;                   //!< Global box at last update
         Scalar3 m_last_L_local;              //!< Local Box lengths at last update
 
         GlobalArray<unsigned int> m_head_list;     //!< Indexes for particles to read from the neighbor list
         GlobalArray<unsigned int> m_Nmax;          //!< Holds the maximum number of neighbors for each particle type
         GlobalArray<unsigned int> m_conditions;    //!< Holds the max number of computed particles by type for resizing
 
+        bool m_exact_storage;                       //!< True if the storage is sized per particle
+        unsigned int m_storage_slack;               //!< Neighbors to reserve in addition to the last count
+        GlobalArray<unsigned int> m_build_count;    //!< Number of neighbors of each particle in the last build
+        GlobalArray<unsigned int> m_build_tag;      //!< Tag of each particle in the last build
+        unsigned int m_build_N;                     //!< Number of particles in the last build (0 if not recorded)
+
         GlobalArray<unsigned int> m_ex_list_tag;  //!< List of excluded particles referenced by tag
         GlobalArray<unsigned int> m_ex_list_idx;  //!< List of excluded particles referenced by index
         GlobalVector<unsigned int> m_n_ex_tag;    //!< Number of exclusions for a given particle tag
@@ -484,6 +622,13 @@ class PYBIND11_EXPORT NeighborList : public Compute
         Index2D m_ex_list_indexer_tag;         //!< Indexer for accessing the by-tag exclusion list
         bool m_exclusions_set;                 //!< True if any exclusions have been set
         bool m_need_reallocate_exlist;         //!< True if global exclusion list needs to be reallocated
+        GlobalVector<unsigned int> m_ex_mask_tag;  //!< Exclusions within the tag window referenced by tag
+        GlobalArray<unsigned int> m_ex_mask_idx;   //!< Exclusions within the tag window referenced by index
+        unsigned int m_n_ex_outside_window;    //!< Number of exclusions that do not fit in the exclusion masks
+        bool m_ex_list_idx_stale;              //!< True if the idx exclusion list has not been updated after a sort
+        GlobalVector<unsigned int> m_sp_mask_tag;  //!< Special pairs within the tag window referenced by tag
+        GlobalArray<unsigned int> m_sp_mask_idx;   //!< Special pairs within the tag window referenced by index
+        bool m_special_pairs_set;              //!< True if any special pairs are flagged
 
         //! Return true if we are supposed to do a distance check in this time step
         bool shouldCheckDistance(unsigned int timestep);
@@ -491,6 +636,12 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Performs the distance check
         virtual bool distanceCheck(unsigned int timestep);
 
+        //! Get the box at the last update, expressed with the tilt factors closest to the current box
+        BoxDim getLastBox() const;
+
+        //! Get the smallest stretch of the affine deformation from \a last_box to the current box
+        Scalar getMinDeformation(const BoxDim& last_box) const;
+
         //! Updates the previous position table for use in the next distance check
         virtual void setLastUpdatedPos();
 
@@ -500,15 +651,51 @@ class PYBIND11_EXPORT NeighborList : public Compute
         //! Updates the idx exclusion list
         virtual void updateExListIdx();
 
+        //! Updates the idx exclusion masks
+        virtual void updateExMaskIdx();
+
+        //! Updates the idx special pair masks
+        virtual void updateSpecialPairMaskIdx();
+
+        //! Grow the special pair masks by tag to the current number of tags
+        void resizeSpecialPairMasks();
+
+        //! Test if buildNlist() checks the exclusion masks
+        /*! Derived classes return true when buildNlist() applies the exclusion masks, otherwise the build is
+            followed by filterNlist()
+        */
+        virtual bool supportsExclusionMask()
+            {
+            return false;
+            }
+
+        //! Update the idx exclusion list if it has been skipped since the last sort
+        void checkExListIdx()
+            {
+            if (m_ex_list_idx_stale)
+                {
+                updateExListIdx();
+                m_ex_list_idx_stale = false;
+                }
+            }
+
         //! Loops through all pairs, and updates the r_list(i,j)
         void updateRList();
 
         //! Filter the neighbor list of excluded particles
         virtual void filterNlist();
 
+        #ifdef ENABLE_MPI
+        //! Filter the ghosts outside of the forward half-shell of the half-shell ghost exchange
+        void filterHalfShell();
+        #endif
+
         //! Build the head list to allocated memory
         virtual void buildHeadList();
 
+        //! Store the number of neighbors and tag of each particle after a build with exact storage
+        virtual void recordBuildCounts();
+
         //! Amortized resizing of the neighborlist
         void resizeNlist(unsigned int size);
 
@@ -517,8 +704,8 @@ class PYBIND11_EXPORT NeighborList : public Compute
             {
             CommFlags flags(0);
 
-            // exclusions require ghost particle tags
-            if (m_exclusions_set) flags[comm_flag::tag] = 1;
+            // exclusions and special pairs require ghost particle tags
+            if (m_exclusions_set || m_special_pairs_set) flags[comm_flag::tag] = 1;
 
             if (m_filter_body) flags[comm_flag::body] = 1;
 
@@ -526,6 +713,24 @@ class PYBIND11_EXPORT NeighborList : public Compute
             }
         #endif
 
+        //! Get the time step of the last build
+        unsigned int getLastUpdatedStep() const
+            {
+            return m_last_updated_tstep;
+            }
+
+        //! Get the number of steps between the distance checks
+        unsigned int getCheckPeriod() const
+            {
+            return m_every;
+            }
+
+        //! Count a build that occurred too late for the list to be correct
+        void countDangerousBuild()
+            {
+            m_dangerous_updates += 1;
+            }
+
         #ifdef ENABLE_CUDA
         //! Reset memory usage hints
         void unsetMemoryMapping();
@@ -547,6 +752,10 @@ class PYBIND11_EXPORT NeighborList : public Compute
         int64_t m_updates;              //!< Number of times the neighbor list has been updated
         int64_t m_forced_updates;       //!< Number of times the neighbor list has been forcibly updated
         int64_t m_dangerous_updates;    //!< Number of dangerous builds counted
+        int64_t m_overflow_builds;      //!< Number of builds repeated because the storage overflowed
+        unsigned int m_metric_builds;   //!< ID of the metric of the number of builds
+        unsigned int m_metric_dangerous_builds; //!< ID of the metric of the number of dangerous builds
+        unsigned int m_metric_collective_time;  //!< ID of the metric of the time spent in MPI collectives
         bool m_force_update;            //!< Flag to handle the forcing of neighborlist updates
         bool m_dist_check;              //!< Set to false to disable distance checks (nlist always built m_every steps)
         bool m_has_been_updated_once;   //!< True if the neighbor list has been updated at least once
@@ -584,6 +793,46 @@ class PYBIND11_EXPORT NeighborList : public Compute
         #ifdef ENABLE_CUDA
         GPUPartition m_last_gpu_partition; //!< The partition at the time of the last memory hints
         #endif
+
+        /* Online buffer tuning */
+
+        //! States of the buffer tuner
+        enum rbuffTunerState
+            {
+            rbuff_tuner_measure = 0,    //!< Measuring the time per step at the current r_buff
+            rbuff_tuner_up,             //!< Trying a larger r_buff
+            rbuff_tuner_down,           //!< Trying a smaller r_buff
+            rbuff_tuner_converged       //!< Monitoring the time per step at the optimal r_buff
+            };
+
+        bool m_rbuff_tuner;                     //!< True if the buffer tuner is enabled
+        Scalar m_rbuff_tuner_min;               //!< Smallest r_buff to try
+        Scalar m_rbuff_tuner_max;               //!< Largest r_buff to try
+        unsigned int m_rbuff_tuner_period;      //!< Number of steps per measurement window
+        rbuffTunerState m_rbuff_tuner_state;    //!< Current state of the tuner
+        Scalar m_rbuff_tuner_dr;                //!< Current step size of r_buff
+        Scalar m_rbuff_tuner_best;              //!< Best r_buff found so far
+        double m_rbuff_tuner_best_cost;         //!< Time per step at the best r_buff (seconds)
+        Scalar m_rbuff_tuner_pending;           //!< r_buff to apply in the next step, negative if none
+        bool m_rbuff_tuner_window_open;         //!< True if a measurement window has been started
+        unsigned int m_rbuff_tuner_last_step;   //!< Last time step the tuner has seen
+        unsigned int m_rbuff_tuner_start_step;  //!< First time step of the window
+        int64_t m_rbuff_tuner_start_time;       //!< Wall clock time at the start of the window
+        int64_t m_rbuff_tuner_dangerous;        //!< Number of dangerous builds at the start of the window
+        unsigned int m_rbuff_tuner_min_period;  //!< Smallest rebuild period in the window
+        ClockSource m_rbuff_tuner_clock;        //!< Clock to measure the time per step
+
+        //! Sample the time per step and adjust r_buff and the check period
+        void updateRBuffTuner(unsigned int timestep);
+
+        //! Apply a pending r_buff change from the tuner
+        void applyRBuffTuner(unsigned int timestep);
+
+        //! Request a new r_buff from the tuner in the next step
+        bool requestRBuff(Scalar r_buff, Scalar r_buff_limit);
+
+        //! Get the largest r_buff the tuner may set
+        Scalar getRBuffTunerMax();
     };
 
 //! Exports NeighborList to python
@@ -14,6 +14,10 @@
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 
 using namespace std;
 namespace py = pybind11;
@@ -87,10 +91,18 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
     if (m_prof)
         m_prof->push(m_exec_conf, "compute");
 
+    // types of the neighbor candidates are read from the structure-of-arrays copy
+    const PositionsSoA& pos_soa = m_pdata->getPositionsSoA(timestep);
+
     // acquire the particle data and box dimension
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+    // exclusions within the tag window are checked inline
+    ArrayHandle<unsigned int> h_ex_mask(m_ex_mask_idx, access_location::host, access_mode::read);
+    const unsigned int *ex_mask = useExclusionMask() ? h_ex_mask.data : NULL;
 
     const BoxDim& box = m_pdata->getBox();
     Scalar3 nearest_plane_distance = box.getNearestPlaneDistance();
@@ -126,7 +138,6 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
 
     // access the neighbor list data
     ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_conditions(m_conditions, access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
@@ -142,17 +153,33 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
     // for each local particle
     unsigned int nparticles = m_pdata->getN();
 
-    for (int i = 0; i < (int)nparticles; i++)
+    #ifdef ENABLE_TBB
+    // overflow conditions are collected per thread and merged after the loop
+    tbb::enumerable_thread_specific< std::vector<unsigned int> >
+        conditions_thread(std::vector<unsigned int>(m_pdata->getNTypes(), 0));
+
+    tbb::parallel_for((unsigned int)0, nparticles, [&] (unsigned int i)
+    #else
+    unsigned int *conditions = h_conditions.data;
+
+    for (unsigned int i = 0; i < nparticles; i++)
+    #endif
         {
+        #ifdef ENABLE_TBB
+        unsigned int *conditions = &conditions_thread.local().front();
+        #endif
+
         unsigned int cur_n_neigh = 0;
 
         const Scalar3 my_pos = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
         const unsigned int type_i = __scalar_as_int(h_pos.data[i].w);
         const unsigned int body_i = h_body.data[i];
         const Scalar diam_i = h_diameter.data[i];
+        const unsigned int ex_mask_i = ex_mask ? ex_mask[i] : 0;
+        const unsigned int tag_i = ex_mask_i ? h_tag.data[i] : 0;
 
-        const unsigned int Nmax_i = h_Nmax.data[type_i];
         const unsigned int head_idx_i = h_head_list.data[i];
+        const unsigned int Nmax_i = h_head_list.data[i+1] - head_idx_i;
 
         // find the bin each particle belongs in
         Scalar3 f = box.makeFraction(my_pos,ghost_width);
@@ -184,16 +211,19 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
                 unsigned int cur_neigh = __scalar_as_int(cur_xyzf.w);
 
                 // get the current neighbor type from the position data (will use tdb on the GPU)
-                unsigned int cur_neigh_type = __scalar_as_int(h_pos.data[cur_neigh].w);
+                unsigned int cur_neigh_type = pos_soa.type[cur_neigh];
                 Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i,cur_neigh_type)];
 
                 // automatically exclude particles without a distance check when:
                 // (1) they are the same particle, or
                 // (2) the r_cut(i,j) indicates to skip, or
-                // (3) they are in the same body
-                bool excluded = ((i == (int)cur_neigh) || (r_cut <= Scalar(0.0)));
+                // (3) they are in the same body, or
+                // (4) the exclusion mask of i contains j
+                bool excluded = ((i == cur_neigh) || (r_cut <= Scalar(0.0)));
                 if (m_filter_body && body_i != NO_BODY)
                     excluded = excluded | (body_i == h_body.data[cur_neigh]);
+                if (ex_mask_i && !excluded)
+                    excluded = isExcludedByMask(ex_mask_i, tag_i, h_tag.data[cur_neigh]);
                 if (excluded)
                     continue;
 
@@ -217,7 +247,7 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
                 Scalar r_listsq = h_r_listsq.data[m_typpair_idx(type_i,cur_neigh_type)];
                 if (dr_sq <= (r_listsq + sqshift) && !excluded)
                     {
-                    if (m_storage_mode == full || i < (int)cur_neigh)
+                    if (m_storage_mode == full || i < cur_neigh)
                         {
                         // local neighbor
                         if (cur_n_neigh < Nmax_i)
@@ -225,7 +255,7 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
                             h_nlist.data[head_idx_i + cur_n_neigh] = cur_neigh;
                             }
                         else
-                            h_conditions.data[type_i] = max(h_conditions.data[type_i], cur_n_neigh+1);
+                            conditions[type_i] = max(conditions[type_i], cur_n_neigh+1);
 
                         cur_n_neigh++;
                         }
@@ -235,6 +265,14 @@ void NeighborListBinned::buildNlist(unsigned int timestep)
 
         h_n_neigh.data[i] = cur_n_neigh;
         }
+    #ifdef ENABLE_TBB
+        );
+
+    // merge the per-thread overflow conditions
+    for (auto it = conditions_thread.begin(); it != conditions_thread.end(); ++it)
+        for (unsigned int type = 0; type < m_pdata->getNTypes(); ++type)
+            h_conditions.data[type] = max(h_conditions.data[type], (*it)[type]);
+    #endif
 
     if (m_prof)
         m_prof->pop(m_exec_conf);
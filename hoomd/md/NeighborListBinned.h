@@ -51,6 +51,12 @@ class PYBIND11_EXPORT NeighborListBinned : public NeighborList
 
         //! Builds the neighbor list
         virtual void buildNlist(unsigned int timestep);
+
+        //! The build checks the exclusion masks inline
+        virtual bool supportsExclusionMask()
+            {
+            return true;
+            }
     };
 
 //! Exports NeighborListBinned to python
@@ -0,0 +1,52 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __NEIGHBORLIST_EXCLUSION_MASK_H__
+#define __NEIGHBORLIST_EXCLUSION_MASK_H__
+
+/*! \file NeighborListExclusionMask.h
+    \brief Declares the encoding of exclusions between particles that are close in tag order
+*/
+
+// need to declare these functions with __device__ qualifiers when building in nvcc
+// HOSTDEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef NVCC
+#define HOSTDEVICE __host__ __device__
+#else
+#define HOSTDEVICE
+#endif
+
+//! Largest tag distance of an exclusion that can be stored in an exclusion mask
+/*! Polymers are usually numbered along the chain, so that the 1-2, 1-3 and 1-4 exclusions of a particle are with
+    particles at most a few tags away from it. The exclusion mask of a particle has one bit for each of the
+    NLIST_EXCLUSION_WINDOW particles before and after it in tag order.
+*/
+#define NLIST_EXCLUSION_WINDOW 16
+
+//! Get the bit of the exclusion mask of particle i that marks an exclusion with the particle with tag i + \a dtag
+/*! \param dtag Tag distance, 0 < |dtag| <= NLIST_EXCLUSION_WINDOW
+    The lower half of the mask holds the particles after i, the upper half those before.
+*/
+HOSTDEVICE inline unsigned int getExclusionMaskBit(int dtag)
+    {
+    return 1u << (dtag > 0 ? dtag - 1 : NLIST_EXCLUSION_WINDOW - dtag - 1);
+    }
+
+//! Test if a pair is excluded by the exclusion mask of its first particle
+/*! \param mask_i Exclusion mask of particle i
+    \param tag_i Tag of particle i
+    \param tag_j Tag of particle j
+    \returns true if j is excluded from the neighbors of i
+*/
+HOSTDEVICE inline bool isExcludedByMask(unsigned int mask_i, unsigned int tag_i, unsigned int tag_j)
+    {
+    int dtag = int(tag_j) - int(tag_i);
+    if (dtag == 0 || dtag > NLIST_EXCLUSION_WINDOW || dtag < -NLIST_EXCLUSION_WINDOW)
+        return false;
+
+    return mask_i & getExclusionMaskBit(dtag);
+    }
+
+#undef HOSTDEVICE
+
+#endif // __NEIGHBORLIST_EXCLUSION_MASK_H__
@@ -20,6 +20,7 @@ namespace py = pybind11;
 #include "hoomd/CachedAllocator.h"
 
 #include <iostream>
+#include <algorithm>
 using namespace std;
 
 /*! \param num_iters Number of iterations to average for the benchmark
@@ -65,6 +66,45 @@ void NeighborListGPU::buildNlist(unsigned int timestep)
     throw runtime_error("Error updating neighborlist bins");
     }
 
+/*! \param d_result Flag to set if a particle has moved more than allowed by \a r_buff
+    \param r_buff Buffer width to test against
+    \param checkn Value to write into \a d_result
+*/
+void NeighborListGPU::launchDistanceCheck(unsigned int *d_result, Scalar r_buff, unsigned int checkn)
+    {
+    // access data
+    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+    BoxDim box = m_pdata->getBox();
+    ArrayHandle<Scalar4> d_last_pos(m_last_pos, access_location::device, access_mode::read);
+
+    // maximum contraction of any pair separation under the box deformation
+    const BoxDim last_box = getLastBox();
+    Scalar lambda_min = getMinDeformation(last_box);
+
+    ArrayHandle<Scalar> d_rcut_max(m_rcut_max, access_location::device, access_mode::read);
+
+    m_exec_conf->beginMultiGPU();
+
+    gpu_nlist_needs_update_check_new(d_result,
+                                     d_last_pos.data,
+                                     d_pos.data,
+                                     m_pdata->getN(),
+                                     box,
+                                     d_rcut_max.data,
+                                     r_buff,
+                                     m_pdata->getNTypes(),
+                                     lambda_min,
+                                     last_box,
+                                     m_pdata->getGlobalBox(),
+                                     checkn,
+                                     m_pdata->getGPUPartition());
+
+    if(m_exec_conf->isCUDAErrorCheckingEnabled())
+        CHECK_CUDA_ERROR();
+
+    m_exec_conf->endMultiGPU();
+    }
+
 bool NeighborListGPU::distanceCheck(unsigned int timestep)
     {
     // prevent against unnecessary calls
@@ -73,46 +113,15 @@ bool NeighborListGPU::distanceCheck(unsigned int timestep)
         return false;
         }
 
+    if (m_deferred_check)
+        return deferredDistanceCheck(timestep);
+
     // scan through the particle data arrays and calculate distances
     if (m_prof) m_prof->push(m_exec_conf, "dist-check");
 
-    // access data
-    ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
-    BoxDim box = m_pdata->getBox();
-    ArrayHandle<Scalar4> d_last_pos(m_last_pos, access_location::device, access_mode::read);
-
-    // get current global nearest plane distance
-    Scalar3 L_g = m_pdata->getGlobalBox().getNearestPlaneDistance();
-
-    // Find direction of maximum box length contraction (smallest eigenvalue of deformation tensor)
-    Scalar3 lambda = L_g / m_last_L;
-    Scalar lambda_min = (lambda.x < lambda.y) ? lambda.x : lambda.y;
-    lambda_min = (lambda_min < lambda.z) ? lambda_min : lambda.z;
-
-    ArrayHandle<Scalar> d_rcut_max(m_rcut_max, access_location::device, access_mode::read);
-
         {
         ArrayHandle<unsigned int> d_flags(m_flags, access_location::device, access_mode::readwrite);
-
-        m_exec_conf->beginMultiGPU();
-
-        gpu_nlist_needs_update_check_new(d_flags.data,
-                                         d_last_pos.data,
-                                         d_pos.data,
-                                         m_pdata->getN(),
-                                         box,
-                                         d_rcut_max.data,
-                                         m_r_buff,
-                                         m_pdata->getNTypes(),
-                                         lambda_min,
-                                         lambda,
-                                         ++m_checkn,
-                                         m_pdata->getGPUPartition());
-
-        if(m_exec_conf->isCUDAErrorCheckingEnabled())
-            CHECK_CUDA_ERROR();
-
-        m_exec_conf->endMultiGPU();
+        launchDistanceCheck(d_flags.data, m_r_buff, ++m_checkn);
         }
 
     bool result;
@@ -129,12 +138,15 @@ bool NeighborListGPU::distanceCheck(unsigned int timestep)
         // check if migrate criterion is fulfilled on any rank
         int local_result = result ? 1 : 0;
         int global_result = 0;
-        MPI_Allreduce(&local_result,
-            &global_result,
-            1,
-            MPI_INT,
-            MPI_MAX,
-            m_exec_conf->getMPICommunicator());
+            {
+            MetricsTimer timer(m_exec_conf->getMetrics(), m_metric_collective_time);
+            MPI_Allreduce(&local_result,
+                &global_result,
+                1,
+                MPI_INT,
+                MPI_MAX,
+                m_exec_conf->getMPICommunicator());
+            }
         result = (global_result > 0);
         if (m_prof) m_prof->pop();
         }
@@ -145,6 +157,101 @@ bool NeighborListGPU::distanceCheck(unsigned int timestep)
     return result;
     }
 
+/*! \param timestep Current time step
+
+    Tests the exact buffer and the reduced buffer of the early rebuild, and records m_deferred_event after the kernels.
+*/
+void NeighborListGPU::launchDeferredCheck(unsigned int timestep)
+    {
+    m_deferred_checkn = ++m_checkn;
+
+        {
+        ArrayHandle<unsigned int> d_deferred_flags(m_deferred_flags, access_location::device, access_mode::readwrite);
+        launchDistanceCheck(d_deferred_flags.data, m_r_buff, m_deferred_checkn);
+        launchDistanceCheck(d_deferred_flags.data + 1, m_r_buff*m_deferred_fraction, m_deferred_checkn);
+        }
+
+    cudaEventRecord(m_deferred_event, 0);
+
+    m_deferred_pending = true;
+    m_deferred_step = timestep;
+    }
+
+/*! The decision is based on the check launched at an earlier step, which has completed by now, so the host does not
+    wait for the GPU. The check of the current step is then launched without reading it back. After a build, no earlier
+    check is available. When check_period is larger than one, the first check after a build is done synchronously,
+    since the particles may have moved by a large distance in the unchecked steps.
+*/
+bool NeighborListGPU::deferredDistanceCheck(unsigned int timestep)
+    {
+    if (m_prof) m_prof->push(m_exec_conf, "dist-check");
+
+    // only a check launched after the last build is meaningful
+    bool have_result = m_deferred_pending && m_deferred_step > getLastUpdatedStep();
+    bool synchronous = false;
+    if (!have_result && getCheckPeriod() > 1)
+        {
+        // check the current step and wait for the result
+        launchDeferredCheck(timestep);
+        have_result = true;
+        synchronous = true;
+        }
+
+    bool result = false;
+    if (have_result)
+        {
+        // the kernels have completed unless the check was just launched
+        cudaEventSynchronize(m_deferred_event);
+
+        int flags[2];
+            {
+            ArrayHandleAsync<unsigned int> h_deferred_flags(m_deferred_flags, access_location::host, access_mode::read);
+            flags[0] = (h_deferred_flags.data[0] == m_deferred_checkn) ? 1 : 0;
+            flags[1] = (h_deferred_flags.data[1] == m_deferred_checkn) ? 1 : 0;
+            }
+
+        #ifdef ENABLE_MPI
+        if (m_pdata->getDomainDecomposition())
+            {
+            if (m_prof) m_prof->push(m_exec_conf,"MPI allreduce");
+                {
+                MetricsTimer timer(m_exec_conf->getMetrics(), m_metric_collective_time);
+                MPI_Allreduce(MPI_IN_PLACE, flags, 2, MPI_INT, MPI_MAX, m_exec_conf->getMPICommunicator());
+                }
+            if (m_prof) m_prof->pop();
+            }
+        #endif
+
+        if (flags[0] && !synchronous)
+            {
+            // the buffer was exceeded at m_deferred_step, but the list was not rebuilt
+            m_exec_conf->msg->notice(2) << "nlist: The deferred distance check missed a neighborlist build at step "
+                << m_deferred_step << ". Lowering the early rebuild threshold." << endl;
+            countDangerousBuild();
+            m_deferred_fraction = std::max(Scalar(0.5), m_deferred_fraction*Scalar(0.9));
+            result = true;
+            }
+        else if (flags[0] || (flags[1] && !synchronous))
+            {
+            result = true;
+            }
+
+        // the synchronous check of this step also serves as the deferred result for the next step
+        if (!synchronous)
+            m_deferred_pending = false;
+        }
+
+    if (!result && !synchronous)
+        {
+        // launch the check of the current step, and read it at the next one
+        launchDeferredCheck(timestep);
+        }
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+
+    return result;
+    }
+
 /*! Calls gpu_nlist_filter() to filter the neighbor list on the GPU
 */
 void NeighborListGPU::filterNlist()
@@ -208,6 +315,35 @@ void NeighborListGPU::updateExListIdx()
         m_prof->pop(m_exec_conf);
     }
 
+//! Update the exclusion masks on the GPU
+void NeighborListGPU::updateExMaskIdx()
+    {
+    if (m_prof)
+        m_prof->push(m_exec_conf,"update-ex-mask");
+
+    ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_ex_mask_tag(m_ex_mask_tag, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_ex_mask_idx(m_ex_mask_idx, access_location::device, access_mode::overwrite);
+
+    gpu_nlist_gather_ex_mask(d_ex_mask_idx.data, d_ex_mask_tag.data, d_tag.data, m_pdata->getN());
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+
+    if (m_prof)
+        m_prof->pop(m_exec_conf);
+    }
+
+//! Update the special pair masks on the GPU
+void NeighborListGPU::updateSpecialPairMaskIdx()
+    {
+    ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_sp_mask_tag(m_sp_mask_tag, access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_sp_mask_idx(m_sp_mask_idx, access_location::device, access_mode::overwrite);
+
+    // the special pair masks have the same layout as the exclusion masks
+    gpu_nlist_gather_ex_mask(d_sp_mask_idx.data, d_sp_mask_tag.data, d_tag.data, m_pdata->getN());
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    }
+
 //! Build the head list for neighbor list indexing on the GPU
 void NeighborListGPU::buildHeadList()
     {
@@ -228,6 +364,12 @@ void NeighborListGPU::buildHeadList()
         ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
         ArrayHandle<unsigned int> d_Nmax(m_Nmax, access_location::device, access_mode::read);
 
+        // the counts of the last build are only used with exact storage
+        const bool exact = m_exact_storage && m_build_N > 0;
+        ArrayHandle<unsigned int> d_build_count(m_build_count, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_build_tag(m_build_tag, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_rtag(m_pdata->getRTags(), access_location::device, access_mode::read);
+
         ArrayHandle<unsigned int> d_req_size_nlist(m_req_size_nlist, access_location::device, access_mode::readwrite);
 
         m_tuner_head_list->begin();
@@ -235,7 +377,13 @@ void NeighborListGPU::buildHeadList()
                                   d_req_size_nlist.data,
                                   d_Nmax.data,
                                   d_pos.data,
+                                  exact ? d_build_count.data : NULL,
+                                  d_build_tag.data,
+                                  d_rtag.data,
+                                  m_pdata->getRTags().size(),
                                   m_pdata->getN(),
+                                  exact ? m_build_N : 0,
+                                  m_storage_slack,
                                   m_pdata->getNTypes(),
                                   m_tuner_head_list->getParam());
         if (m_exec_conf->isCUDAErrorCheckingEnabled())
@@ -257,10 +405,145 @@ void NeighborListGPU::buildHeadList()
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+/*! The counts and tags are copied on the device.
+*/
+void NeighborListGPU::recordBuildCounts()
+    {
+    if (m_build_count.getNumElements() < m_pdata->getMaxN())
+        {
+        GlobalArray<unsigned int> build_count(m_pdata->getMaxN(), m_exec_conf);
+        m_build_count.swap(build_count);
+        TAG_ALLOCATION(m_build_count);
+
+        GlobalArray<unsigned int> build_tag(m_pdata->getMaxN(), m_exec_conf);
+        m_build_tag.swap(build_tag);
+        TAG_ALLOCATION(m_build_tag);
+        }
+
+    const unsigned int N = m_pdata->getN();
+    if (N > 0)
+        {
+        ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_build_count(m_build_count, access_location::device, access_mode::overwrite);
+        ArrayHandle<unsigned int> d_build_tag(m_build_tag, access_location::device, access_mode::overwrite);
+
+        cudaMemcpy(d_build_count.data, d_n_neigh.data, sizeof(unsigned int)*N, cudaMemcpyDeviceToDevice);
+        cudaMemcpy(d_build_tag.data, d_tag.data, sizeof(unsigned int)*N, cudaMemcpyDeviceToDevice);
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+    m_build_N = N;
+    }
+
+/*! \param enable True to build the cluster-pair list along with the neighbor list
+*/
+void NeighborListGPU::setClusterPairs(bool enable)
+    {
+    if (enable && m_storage_mode != full)
+        {
+        m_exec_conf->msg->error() << "nlist: The cluster-pair list requires a full neighbor list." << endl;
+        throw runtime_error("Error enabling the cluster-pair list");
+        }
+
+    m_cluster_pairs = enable;
+    m_cluster_pairs_dirty = true;
+    }
+
+/*! The local particles are grouped into i-clusters of gpu_nlist_cluster_size consecutive indices. The particle sort
+    places nearby particles at nearby indices, so that the neighbors of an i-cluster fall into few j-clusters. The list
+    is regrown and rebuilt until every i-cluster fits in a row.
+*/
+void NeighborListGPU::updateClusterPairs()
+    {
+    if (!m_cluster_pairs || !m_cluster_pairs_dirty)
+        return;
+
+    if (m_prof) m_prof->push(m_exec_conf, "cluster-pairs");
+
+    const unsigned int N = m_pdata->getN();
+    const unsigned int n_clusters = (N + gpu_nlist_cluster_size - 1) / gpu_nlist_cluster_size;
+
+    if (m_cluster_n.getNumElements() < n_clusters)
+        {
+        GlobalArray<unsigned int> cluster_n(n_clusters, m_exec_conf);
+        m_cluster_n.swap(cluster_n);
+        TAG_ALLOCATION(m_cluster_n);
+        }
+
+    bool overflowed = false;
+    do
+        {
+        const unsigned int table_size = gpu_nlist_cluster_table_size(m_cluster_max);
+        if (3*table_size*sizeof(unsigned int) > m_exec_conf->dev_prop.sharedMemPerBlock)
+            {
+            m_exec_conf->msg->error() << "nlist: Too many neighbor clusters (" << m_cluster_max
+                                      << ") for the cluster-pair list, reduce r_cut or r_buff." << endl;
+            throw runtime_error("Error building the cluster-pair list");
+            }
+
+        if (m_cluster_list.getNumElements() < n_clusters*m_cluster_max)
+            {
+            GlobalArray<unsigned int> cluster_list(n_clusters*m_cluster_max, m_exec_conf);
+            m_cluster_list.swap(cluster_list);
+            TAG_ALLOCATION(m_cluster_list);
+
+            GlobalArray<uint2> cluster_mask(n_clusters*m_cluster_max, m_exec_conf);
+            m_cluster_mask.swap(cluster_mask);
+            TAG_ALLOCATION(m_cluster_mask);
+            }
+        m_cluster_indexer = Index2D(m_cluster_max, n_clusters);
+
+        m_cluster_req_max.resetFlags(0);
+
+            {
+            ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_nlist(m_nlist, access_location::device, access_mode::read);
+            ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::read);
+
+            ArrayHandle<unsigned int> d_cluster_n(m_cluster_n, access_location::device, access_mode::overwrite);
+            ArrayHandle<unsigned int> d_cluster_list(m_cluster_list, access_location::device, access_mode::overwrite);
+            ArrayHandle<uint2> d_cluster_mask(m_cluster_mask, access_location::device, access_mode::overwrite);
+
+            m_tuner_cluster->begin();
+            gpu_nlist_build_cluster_pairs(d_cluster_n.data,
+                                          d_cluster_list.data,
+                                          d_cluster_mask.data,
+                                          m_cluster_req_max.getDeviceFlags(),
+                                          m_cluster_indexer,
+                                          d_n_neigh.data,
+                                          d_nlist.data,
+                                          d_head_list.data,
+                                          N,
+                                          m_tuner_cluster->getParam());
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            m_tuner_cluster->end();
+            }
+
+        const unsigned int req_max = m_cluster_req_max.readFlags();
+        overflowed = req_max > 0;
+        if (overflowed)
+            {
+            m_exec_conf->msg->notice(6) << "nlist: (Re-)allocating cluster-pair list, new size " << req_max
+                                        << " j-clusters per i-cluster" << endl;
+            m_cluster_max = req_max;
+            }
+        } while (overflowed);
+
+    m_cluster_pairs_dirty = false;
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
 void export_NeighborListGPU(py::module& m)
     {
     py::class_<NeighborListGPU, std::shared_ptr<NeighborListGPU> >(m, "NeighborListGPU", py::base<NeighborList>())
     .def(py::init< std::shared_ptr<SystemDefinition>, Scalar, Scalar >())
                      .def("benchmarkFilter", &NeighborListGPU::benchmarkFilter)
+                     .def("setClusterPairs", &NeighborListGPU::setClusterPairs)
+                     .def("getClusterPairs", &NeighborListGPU::getClusterPairs)
+                     .def("setDeferredCheck", &NeighborListGPU::setDeferredCheck)
+                     .def("getDeferredCheck", &NeighborListGPU::getDeferredCheck)
                      ;
     }
@@ -22,12 +22,13 @@
     \param r_buff The buffer size that particles can move in
     \param ntypes The number of particle types
     \param lambda_min Minimum contraction of deformation tensor
-    \param lambda Diagonal deformation tensor (for orthorhombic boundaries)
+    \param last_box Global box at the last update
+    \param global_box Current global box
     \param checkn
 
     gpu_nlist_needs_update_check_new_kernel() executes one thread per particle. Every particle's current position is
-    compared to its last position. If the particle has moved a distance more than the buffer width, then *d_result
-    is set to \a checkn.
+    compared to its last position, carried along with the box deformation in fractional coordinates. If the particle
+    has moved a distance more than the buffer width, then *d_result is set to \a checkn.
 */
 __global__ void gpu_nlist_needs_update_check_new_kernel(unsigned int *d_result,
                                                         const Scalar4 *d_last_pos,
@@ -38,7 +39,8 @@ __global__ void gpu_nlist_needs_update_check_new_kernel(unsigned int *d_result,
                                                         const Scalar r_buff,
                                                         const unsigned int ntypes,
                                                         const Scalar lambda_min,
-                                                        const Scalar3 lambda,
+                                                        const BoxDim last_box,
+                                                        const BoxDim global_box,
                                                         const unsigned int checkn,
                                                         const unsigned int offset)
     {
@@ -77,7 +79,7 @@ __global__ void gpu_nlist_needs_update_check_new_kernel(unsigned int *d_result,
         Scalar4 last_postype = d_last_pos[idx];
         Scalar3 last_pos = make_scalar3(last_postype.x, last_postype.y, last_postype.z);
 
-        Scalar3 dx = cur_pos - lambda*last_pos;
+        Scalar3 dx = cur_pos - global_box.makeCoordinates(last_box.makeFraction(last_pos));
         dx = box.minImage(dx);
 
         if (dot(dx, dx) >= s_maxshiftsq[cur_type])
@@ -98,7 +100,8 @@ cudaError_t gpu_nlist_needs_update_check_new(unsigned int *d_result,
                                              const Scalar r_buff,
                                              const unsigned int ntypes,
                                              const Scalar lambda_min,
-                                             const Scalar3 lambda,
+                                             const BoxDim& last_box,
+                                             const BoxDim& global_box,
                                              const unsigned int checkn,
                                              const GPUPartition& gpu_partition)
     {
@@ -122,7 +125,8 @@ cudaError_t gpu_nlist_needs_update_check_new(unsigned int *d_result,
                                                                                         r_buff,
                                                                                         ntypes,
                                                                                         lambda_min,
-                                                                                        lambda,
+                                                                                        last_box,
+                                                                                        global_box,
                                                                                         checkn,
                                                                                         range.first);
         }
@@ -332,20 +336,228 @@ cudaError_t gpu_update_exclusion_list(const unsigned int *d_tag,
     return cudaSuccess;
     }
 
+//! Kernel to gather the exclusion masks by particle index
+__global__ void gpu_nlist_gather_ex_mask_kernel(unsigned int *d_ex_mask_idx,
+                                                const unsigned int *d_ex_mask_tag,
+                                                const unsigned int *d_tag,
+                                                const unsigned int N)
+    {
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (idx >= N)
+        return;
+
+    d_ex_mask_idx[idx] = d_ex_mask_tag[d_tag[idx]];
+    }
+
+/*! \param d_ex_mask_idx Exclusion masks per idx (output)
+    \param d_ex_mask_tag Exclusion masks per tag
+    \param d_tag Array of particle tags
+    \param N Number of particles
+*/
+cudaError_t gpu_nlist_gather_ex_mask(unsigned int *d_ex_mask_idx,
+                                     const unsigned int *d_ex_mask_tag,
+                                     const unsigned int *d_tag,
+                                     const unsigned int N)
+    {
+    unsigned int block_size = 512;
+
+    gpu_nlist_gather_ex_mask_kernel<<<N/block_size + 1, block_size>>>(d_ex_mask_idx, d_ex_mask_tag, d_tag, N);
+
+    return cudaSuccess;
+    }
+
+//! Marks an empty slot in the hash table of gpu_nlist_build_cluster_pairs_kernel()
+#define NLIST_CLUSTER_EMPTY 0xffffffff
+
+/*!
+ * \param d_cluster_n Number of j-clusters per i-cluster (output)
+ * \param d_cluster_list j-clusters of each i-cluster (output)
+ * \param d_cluster_mask Interaction mask of each cluster pair (output)
+ * \param d_req_max Largest number of j-clusters of an i-cluster that did not fit (output)
+ * \param cluster_indexer Indexer for d_cluster_list and d_cluster_mask
+ * \param d_n_neigh Number of neighbors per particle
+ * \param d_nlist Neighbor list (full, filtered of exclusions)
+ * \param d_head_list Head list indexes for accessing d_nlist
+ * \param N Number of local particles
+ * \param table_size Number of slots in the hash table (power of 2)
+ *
+ * One block processes one i-cluster. The threads stride over the neighbors of the particles in the cluster and
+ * insert the j-clusters into a hash table in shared memory with open addressing, setting the mask bits of the pair
+ * with atomic operations. The unique j-clusters are then written in ascending order, so that the result does not
+ * depend on the order of the atomic operations. If an i-cluster has more j-clusters than fit in a row of
+ * \a d_cluster_list, nothing is written and the required size is reported in \a d_req_max.
+ */
+__global__ void gpu_nlist_build_cluster_pairs_kernel(unsigned int *d_cluster_n,
+                                                     unsigned int *d_cluster_list,
+                                                     uint2 *d_cluster_mask,
+                                                     unsigned int *d_req_max,
+                                                     const Index2D cluster_indexer,
+                                                     const unsigned int *d_n_neigh,
+                                                     const unsigned int *d_nlist,
+                                                     const unsigned int *d_head_list,
+                                                     const unsigned int N,
+                                                     const unsigned int table_size)
+    {
+    extern __shared__ unsigned int s_table[];
+    unsigned int *s_keys = s_table;
+    unsigned int *s_mask_lo = s_table + table_size;
+    unsigned int *s_mask_hi = s_table + 2*table_size;
+    __shared__ unsigned int s_count;
+
+    const unsigned int ic = blockIdx.x;
+
+    for (unsigned int k = threadIdx.x; k < table_size; k += blockDim.x)
+        {
+        s_keys[k] = NLIST_CLUSTER_EMPTY;
+        s_mask_lo[k] = 0;
+        s_mask_hi[k] = 0;
+        }
+    if (threadIdx.x == 0)
+        s_count = 0;
+    __syncthreads();
+
+    for (unsigned int i_local = 0; i_local < gpu_nlist_cluster_size; i_local++)
+        {
+        const unsigned int i = ic*gpu_nlist_cluster_size + i_local;
+        if (i >= N)
+            break;
+
+        const unsigned int n_neigh = d_n_neigh[i];
+        const unsigned int head = d_head_list[i];
+        for (unsigned int k = threadIdx.x; k < n_neigh; k += blockDim.x)
+            {
+            const unsigned int j = d_nlist[head + k];
+            const unsigned int jc = j / gpu_nlist_cluster_size;
+            const unsigned int bit = i_local*gpu_nlist_cluster_size + j % gpu_nlist_cluster_size;
+
+            // multiplicative hashing, then linear probing
+            unsigned int slot = (jc * 2654435761u) & (table_size - 1);
+            for (unsigned int probe = 0; probe < table_size; probe++)
+                {
+                const unsigned int old = atomicCAS(&s_keys[slot], NLIST_CLUSTER_EMPTY, jc);
+                if (old == NLIST_CLUSTER_EMPTY)
+                    atomicAdd(&s_count, 1);
+
+                if (old == NLIST_CLUSTER_EMPTY || old == jc)
+                    {
+                    if (bit < 32)
+                        atomicOr(&s_mask_lo[slot], 1u << bit);
+                    else
+                        atomicOr(&s_mask_hi[slot], 1u << (bit - 32));
+                    break;
+                    }
+                slot = (slot + 1) & (table_size - 1);
+                }
+            }
+        }
+    __syncthreads();
+
+    // a full table also has more entries than the row can hold
+    const unsigned int count = s_count;
+    if (count > cluster_indexer.getW())
+        {
+        if (threadIdx.x == 0)
+            {
+            atomicMax(d_req_max, count);
+            d_cluster_n[ic] = 0;
+            }
+        return;
+        }
+
+    // the rank of a j-cluster in ascending order is its output position
+    for (unsigned int k = threadIdx.x; k < table_size; k += blockDim.x)
+        {
+        const unsigned int key = s_keys[k];
+        if (key == NLIST_CLUSTER_EMPTY)
+            continue;
+
+        unsigned int rank = 0;
+        for (unsigned int l = 0; l < table_size; l++)
+            {
+            if (s_keys[l] < key)
+                rank++;
+            }
+
+        d_cluster_list[cluster_indexer(rank, ic)] = key;
+        d_cluster_mask[cluster_indexer(rank, ic)] = make_uint2(s_mask_lo[k], s_mask_hi[k]);
+        }
+
+    if (threadIdx.x == 0)
+        d_cluster_n[ic] = count;
+    }
+
+/*!
+ * \param d_cluster_n Number of j-clusters per i-cluster (output)
+ * \param d_cluster_list j-clusters of each i-cluster (output)
+ * \param d_cluster_mask Interaction mask of each cluster pair (output)
+ * \param d_req_max Largest number of j-clusters of an i-cluster that did not fit (output, must be reset to 0)
+ * \param cluster_indexer Indexer for d_cluster_list and d_cluster_mask
+ * \param d_n_neigh Number of neighbors per particle
+ * \param d_nlist Neighbor list (full, filtered of exclusions)
+ * \param d_head_list Head list indexes for accessing d_nlist
+ * \param N Number of local particles
+ * \param block_size Number of threads per block
+ *
+ * \return cudaSuccess on completion
+ *
+ * The hash table of each block has twice as many slots as the largest allowed number of j-clusters, rounded up to
+ * a power of 2. The caller must ensure that it fits in shared memory, see gpu_nlist_cluster_table_size().
+ */
+cudaError_t gpu_nlist_build_cluster_pairs(unsigned int *d_cluster_n,
+                                          unsigned int *d_cluster_list,
+                                          uint2 *d_cluster_mask,
+                                          unsigned int *d_req_max,
+                                          const Index2D& cluster_indexer,
+                                          const unsigned int *d_n_neigh,
+                                          const unsigned int *d_nlist,
+                                          const unsigned int *d_head_list,
+                                          const unsigned int N,
+                                          const unsigned int block_size)
+    {
+    const unsigned int n_clusters = cluster_indexer.getH();
+    if (n_clusters == 0)
+        return cudaSuccess;
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void *)gpu_nlist_build_cluster_pairs_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+    unsigned int run_block_size = min(block_size, max_block_size);
+
+    const unsigned int table_size = gpu_nlist_cluster_table_size(cluster_indexer.getW());
+
+    gpu_nlist_build_cluster_pairs_kernel<<<n_clusters, run_block_size, 3*table_size*sizeof(unsigned int)>>>(
+        d_cluster_n,
+        d_cluster_list,
+        d_cluster_mask,
+        d_req_max,
+        cluster_indexer,
+        d_n_neigh,
+        d_nlist,
+        d_head_list,
+        N,
+        table_size);
+
+    return cudaSuccess;
+    }
+
 //! GPU kernel to do a preliminary sizing on particles
 /*!
  * \param d_head_list The head list of indexes to overwrite
- * \param d_req_size_nlist Flag for the required size of the neighbor list to overwrite
  * \param d_Nmax The number of neighbors to size per particle type
  * \param d_pos Particle positions and types
  * \param N the number of particles on this rank
  * \param ntypes the number of types in the system
  *
- * This kernel initializes the head list with the number of neighbors that each type expects from d_Nmax. A prefix sum
- * is then performed in gpu_nlist_build_head_list() to accumulate starting indices.
+ * This kernel initializes the head list with the number of neighbors that each type expects from d_Nmax, and the
+ * element after the last particle with zero. A prefix sum is then performed in gpu_nlist_build_head_list() to
+ * accumulate starting indices.
  */
 __global__ void gpu_nlist_init_head_list_kernel(unsigned int *d_head_list,
-                                                unsigned int *d_req_size_nlist,
                                                 const unsigned int *d_Nmax,
                                                 const Scalar4 *d_pos,
                                                 const unsigned int N,
@@ -366,21 +578,52 @@ __global__ void gpu_nlist_init_head_list_kernel(unsigned int *d_head_list,
     // particle index
     const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
 
-    // one thread per particle
-    if (idx >= N)
+    // one thread per particle, and one for the end of the list
+    if (idx > N)
         return;
 
+    if (idx == N)
+        {
+        d_head_list[idx] = 0;
+        return;
+        }
+
     const Scalar4 postype_i = d_pos[idx];
     const unsigned int type_i = __scalar_as_int(postype_i.w);
     const unsigned int Nmax_i = s_Nmax[type_i];
 
     d_head_list[idx] = Nmax_i;
+    }
 
-    // last thread presets its number of particles in the memory req as well
-    if (idx == (N-1))
-        {
-        *d_req_size_nlist = Nmax_i;
-        }
+//! GPU kernel to size the particles of the last build by their number of neighbors
+/*!
+ * \param d_head_list The head list of sizes to overwrite
+ * \param d_build_count Number of neighbors of each particle in the last build
+ * \param d_build_tag Tag of each particle in the last build
+ * \param d_rtag Current index of each particle tag
+ * \param ntags Number of elements of \a d_rtag
+ * \param N the number of particles on this rank
+ * \param N_build the number of particles in the last build
+ * \param slack Number of neighbors to reserve in addition to the count
+ */
+__global__ void gpu_nlist_exact_head_list_kernel(unsigned int *d_head_list,
+                                                 const unsigned int *d_build_count,
+                                                 const unsigned int *d_build_tag,
+                                                 const unsigned int *d_rtag,
+                                                 const unsigned int ntags,
+                                                 const unsigned int N,
+                                                 const unsigned int N_build,
+                                                 const unsigned int slack)
+    {
+    // one thread per particle of the last build
+    const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+    if (idx >= N_build)
+        return;
+
+    const unsigned int tag = d_build_tag[idx];
+    const unsigned int pidx = (tag < ntags) ? d_rtag[tag] : 0xffffffff;
+    if (pidx < N)
+        d_head_list[pidx] = d_build_count[idx] + slack;
     }
 
 /*!
@@ -388,15 +631,14 @@ __global__ void gpu_nlist_init_head_list_kernel(unsigned int *d_head_list,
  * \param d_head_list The complete particle head list
  * \param N the number of particles on this rank
  *
- * A single thread on the device is needed to complete the exclusive scan and find the size of the neighbor list.
- * Because gpu_nlist_init_head_list_kernel() already set the number of neighbors for the last particle in
- * d_req_size_nlist, the head index of the last particle is added to this number to get the total size.
+ * A single thread on the device is needed to complete the exclusive scan and find the size of the neighbor list,
+ * which the scan has left in the element after the last particle.
  */
 __global__ void gpu_nlist_get_nlist_size_kernel(unsigned int *d_req_size_nlist,
                                                 const unsigned int *d_head_list,
                                                 const unsigned int N)
     {
-    *d_req_size_nlist += d_head_list[N-1];
+    *d_req_size_nlist = d_head_list[N];
     }
 
 /*!
@@ -404,7 +646,13 @@ __global__ void gpu_nlist_get_nlist_size_kernel(unsigned int *d_req_size_nlist,
  * \param d_req_size_nlist Flag for the total size of the neighbor list
  * \param d_Nmax The number of neighbors to size per particle type
  * \param d_pos Particle positions and types
+ * \param d_build_count Number of neighbors of each particle in the last build (NULL to size by type)
+ * \param d_build_tag Tag of each particle in the last build
+ * \param d_rtag Current index of each particle tag
+ * \param ntags Number of elements of \a d_rtag
  * \param N the number of particles on this rank
+ * \param N_build the number of particles in the last build
+ * \param slack Number of neighbors to reserve in addition to the count of the last build
  * \param ntypes the number of types in the system
  * \param block_size Number of threads per block for gpu_nlist_init_head_list_kernel()
  *
@@ -412,14 +660,20 @@ __global__ void gpu_nlist_get_nlist_size_kernel(unsigned int *d_req_size_nlist,
  *
  * \b Implementation
  * \a d_head_list is filled with the number of neighbors per particle. An exclusive prefix sum is
- * performed in place on \a d_head_list using the thrust libraries and a single thread is used to perform compute the total
- * size of the neighbor list while still on device.
+ * performed in place on \a d_head_list using the thrust libraries, including the element after the last particle,
+ * and a single thread is used to copy the total size of the neighbor list while still on device.
  */
 cudaError_t gpu_nlist_build_head_list(unsigned int *d_head_list,
                                       unsigned int *d_req_size_nlist,
                                       const unsigned int *d_Nmax,
                                       const Scalar4 *d_pos,
+                                      const unsigned int *d_build_count,
+                                      const unsigned int *d_build_tag,
+                                      const unsigned int *d_rtag,
+                                      const unsigned int ntags,
                                       const unsigned int N,
+                                      const unsigned int N_build,
+                                      const unsigned int slack,
                                       const unsigned int ntypes,
                                       const unsigned int block_size)
     {
@@ -436,14 +690,26 @@ cudaError_t gpu_nlist_build_head_list(unsigned int *d_head_list,
 
     // initialize each particle with its number of neighbors
     gpu_nlist_init_head_list_kernel<<<N/run_block_size + 1, run_block_size, shared_bytes>>>(d_head_list,
-                                                                                            d_req_size_nlist,
                                                                                             d_Nmax,
                                                                                             d_pos,
                                                                                             N,
                                                                                             ntypes);
 
+    // particles of the last build are sized by their number of neighbors
+    if (d_build_count && N_build > 0)
+        {
+        gpu_nlist_exact_head_list_kernel<<<N_build/run_block_size + 1, run_block_size>>>(d_head_list,
+                                                                                         d_build_count,
+                                                                                         d_build_tag,
+                                                                                         d_rtag,
+                                                                                         ntags,
+                                                                                         N,
+                                                                                         N_build,
+                                                                                         slack);
+        }
+
     thrust::device_ptr<unsigned int> t_head_list = thrust::device_pointer_cast(d_head_list);
-    thrust::exclusive_scan(t_head_list, t_head_list+N, t_head_list);
+    thrust::exclusive_scan(t_head_list, t_head_list+N+1, t_head_list);
 
     gpu_nlist_get_nlist_size_kernel<<<1,1>>>(d_req_size_nlist, d_head_list, N);
 
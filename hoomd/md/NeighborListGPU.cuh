@@ -18,6 +18,23 @@
 #include "hoomd/ParticleData.cuh"
 #include "hoomd/GPUPartition.cuh"
 
+//! Number of particles in a cluster of the cluster-pair list
+const unsigned int gpu_nlist_cluster_size = 8;
+
+//! Device arrays of the cluster-pair list
+/*! The local particles are grouped into i-clusters of gpu_nlist_cluster_size consecutive indices, and all particles
+    (including ghosts) into j-clusters in the same way. For each i-cluster, the list stores the j-clusters that
+    contain at least one neighbor of any of its particles, and a 64 bit mask of the interacting pairs in the 8x8 tile.
+    Bit (i%8)*8 + (j%8) is set when j is in the neighbor list of i. Excluded pairs are never set.
+*/
+struct cluster_pair_args_t
+    {
+    const unsigned int *d_cluster_n;    //!< Number of j-clusters per i-cluster
+    const unsigned int *d_cluster_list; //!< j-clusters of each i-cluster
+    const uint2 *d_cluster_mask;        //!< Interaction mask of each cluster pair (low word in x)
+    Index2D cluster_indexer;            //!< Indexer for d_cluster_list and d_cluster_mask
+    };
+
 //! Kernel driver for gpu_nlist_needs_update_check_new_kernel()
 cudaError_t gpu_nlist_needs_update_check_new(unsigned int *d_result,
                                              const Scalar4 *d_last_pos,
@@ -28,7 +45,8 @@ cudaError_t gpu_nlist_needs_update_check_new(unsigned int *d_result,
                                              const Scalar r_buff,
                                              const unsigned int ntypes,
                                              const Scalar lambda_min,
-                                             const Scalar3 lambda,
+                                             const BoxDim& last_box,
+                                             const BoxDim& global_box,
                                              const unsigned int checkn,
                                              const GPUPartition& gpu_partition);
 
@@ -47,11 +65,41 @@ cudaError_t gpu_nlist_build_head_list(unsigned int *d_head_list,
                                       unsigned int *d_req_size_nlist,
                                       const unsigned int *d_Nmax,
                                       const Scalar4 *d_pos,
+                                      const unsigned int *d_build_count,
+                                      const unsigned int *d_build_tag,
+                                      const unsigned int *d_rtag,
+                                      const unsigned int ntags,
                                       const unsigned int N,
+                                      const unsigned int N_build,
+                                      const unsigned int slack,
                                       const unsigned int n_types,
                                       const unsigned int block_size);
 
 
+//! Number of hash table slots used to build the cluster-pair list
+/*! \param max_cluster_pairs Maximum number of j-clusters per i-cluster
+    \returns Table size, the kernel needs 3*sizeof(unsigned int) bytes of shared memory per slot
+*/
+inline unsigned int gpu_nlist_cluster_table_size(const unsigned int max_cluster_pairs)
+    {
+    unsigned int table_size = 1;
+    while (table_size < 2*max_cluster_pairs)
+        table_size *= 2;
+    return table_size;
+    }
+
+//! Kernel driver for gpu_nlist_build_cluster_pairs_kernel()
+cudaError_t gpu_nlist_build_cluster_pairs(unsigned int *d_cluster_n,
+                                          unsigned int *d_cluster_list,
+                                          uint2 *d_cluster_mask,
+                                          unsigned int *d_req_max,
+                                          const Index2D& cluster_indexer,
+                                          const unsigned int *d_n_neigh,
+                                          const unsigned int *d_nlist,
+                                          const unsigned int *d_head_list,
+                                          const unsigned int N,
+                                          const unsigned int block_size);
+
 //! GPU function to update the exclusion list on the device
 cudaError_t gpu_update_exclusion_list(const unsigned int *d_tag,
                                 const unsigned int *d_rtag,
@@ -63,4 +111,10 @@ cudaError_t gpu_update_exclusion_list(const unsigned int *d_tag,
                                 const Index2D& ex_list_indexer,
                                 const unsigned int N);
 
+//! GPU function to gather the exclusion masks by particle index
+cudaError_t gpu_nlist_gather_ex_mask(unsigned int *d_ex_mask_idx,
+                                     const unsigned int *d_ex_mask_tag,
+                                     const unsigned int *d_tag,
+                                     const unsigned int N);
+
 #endif
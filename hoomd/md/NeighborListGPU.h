@@ -28,6 +28,18 @@
 
     GPU kernel methods are defined in NeighborListGPU.cuh and defined in NeighborListGPU.cu.
 
+    On request, the neighbor list is also converted into a cluster-pair list (see cluster_pair_args_t), which the GPU
+    pair potentials evaluate in dense 8x8 tiles. The cluster-pair list is rebuilt lazily by updateClusterPairs() after
+    every update of the neighbor list.
+
+    The distance check normally reads the rebuild flag back to the host right after the check kernel, which stalls the
+    host until the GPU has caught up with the time step. In the deferred mode (see setDeferredCheck()), the check
+    kernel writes to mapped host memory and the flag is read one step later, when the kernel has long completed. To
+    decide on a rebuild before the exact check of the current step is available, the kernel also tests a reduced
+    buffer of m_deferred_fraction*r_buff, so that the list is usually rebuilt one step early. If the exact check of
+    the previous step reports that the buffer had already been exceeded, the build was missed for one step: it is
+    counted as a dangerous build, the list is rebuilt, and the fraction is reduced.
+
     \ingroup computes
 */
 class PYBIND11_EXPORT NeighborListGPU : public NeighborList
@@ -69,14 +81,41 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
                 CHECK_CUDA_ERROR();
                 }
 
+            // the cluster-pair list is only built on request
+            m_cluster_pairs = false;
+            m_cluster_pairs_dirty = true;
+            m_cluster_max = 16;
+
+            GPUFlags<unsigned int> cluster_req_max(m_exec_conf);
+            m_cluster_req_max.swap(cluster_req_max);
+
+            // the deferred distance check is only enabled on request
+            m_deferred_check = false;
+            m_deferred_fraction = Scalar(0.8);
+            m_deferred_pending = false;
+            m_deferred_step = 0;
+            m_deferred_checkn = 0;
+
+            GPUArray<unsigned int> deferred_flags(2, m_exec_conf, true);
+            m_deferred_flags.swap(deferred_flags);
+                {
+                ArrayHandle<unsigned int> h_deferred_flags(m_deferred_flags, access_location::host, access_mode::overwrite);
+                h_deferred_flags.data[0] = 0;
+                h_deferred_flags.data[1] = 0;
+                }
+            cudaEventCreateWithFlags(&m_deferred_event, cudaEventDisableTiming);
+
             // create cuda event
             m_tuner_filter.reset(new Autotuner(32, 1024, 32, 5, 100000, "nlist_filter", this->m_exec_conf));
             m_tuner_head_list.reset(new Autotuner(32, 1024, 32, 5, 100000, "nlist_head_list", this->m_exec_conf));
+            m_tuner_cluster.reset(new Autotuner(32, 1024, 32, 5, 100000, "nlist_cluster_pairs", this->m_exec_conf));
             }
 
         //! Destructor
         virtual ~NeighborListGPU()
-            { }
+            {
+            cudaEventDestroy(m_deferred_event);
+            }
 
         //! Set autotuner parameters
         /*! \param enable Enable/disable autotuning
@@ -90,6 +129,9 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
 
             m_tuner_head_list->setPeriod(period/10);
             m_tuner_head_list->setEnabled(enable);
+
+            m_tuner_cluster->setPeriod(period/10);
+            m_tuner_cluster->setEnabled(enable);
             }
 
         //! Benchmark the filter kernel
@@ -98,6 +140,61 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
         //! Update the exclusion list on the GPU
         virtual void updateExListIdx();
 
+        //! Update the exclusion masks on the GPU
+        virtual void updateExMaskIdx();
+
+        //! Update the special pair masks on the GPU
+        virtual void updateSpecialPairMaskIdx();
+
+        //! Enable or disable the cluster-pair list
+        void setClusterPairs(bool enable);
+
+        //! Test if the cluster-pair list is enabled
+        bool getClusterPairs() const
+            {
+            return m_cluster_pairs;
+            }
+
+        //! Enable or disable the deferred distance check
+        void setDeferredCheck(bool enable)
+            {
+            m_deferred_check = enable;
+            m_deferred_pending = false;
+            }
+
+        //! Test if the deferred distance check is enabled
+        bool getDeferredCheck() const
+            {
+            return m_deferred_check;
+            }
+
+        //! Build the cluster-pair list if the neighbor list has changed since the last build
+        void updateClusterPairs();
+
+        //! Get the number of j-clusters per i-cluster
+        const GlobalArray<unsigned int>& getClusterNArray() const
+            {
+            return m_cluster_n;
+            }
+
+        //! Get the j-clusters of each i-cluster
+        const GlobalArray<unsigned int>& getClusterListArray() const
+            {
+            return m_cluster_list;
+            }
+
+        //! Get the interaction mask of each cluster pair
+        const GlobalArray<uint2>& getClusterMaskArray() const
+            {
+            return m_cluster_mask;
+            }
+
+        //! Get the indexer for the cluster-pair list
+        const Index2D& getClusterIndexer() const
+            {
+            return m_cluster_indexer;
+            }
+
     protected:
         GlobalArray<unsigned int> m_flags;   //!< Storage for device flags on the GPU
 
@@ -109,11 +206,14 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
         //! Perform the nlist distance check on the GPU
         virtual bool distanceCheck(unsigned int timestep);
 
-        //! GPU nlists set their last updated pos in the compute kernel, this call only resets the last box length
+        //! GPU nlists set their last updated pos in the compute kernel, this call only resets the last box
         virtual void setLastUpdatedPos()
             {
-            m_last_L = m_pdata->getGlobalBox().getNearestPlaneDistance();
+            m_last_box = m_pdata->getGlobalBox();
             m_last_L_local = m_pdata->getBox().getNearestPlaneDistance();
+
+            // the neighbor list was rebuilt
+            m_cluster_pairs_dirty = true;
             }
 
         //! Filter the neighbor list of excluded particles
@@ -122,6 +222,9 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
         //! Build the head list for neighbor list indexing on the GPU
         virtual void buildHeadList();
 
+        //! Store the number of neighbors and tag of each particle after a build with exact storage
+        virtual void recordBuildCounts();
+
         //! Schedule the distance check kernel
         /*! \param timestep Current time step
          */
@@ -130,8 +233,35 @@ class PYBIND11_EXPORT NeighborListGPU : public NeighborList
     private:
         std::unique_ptr<Autotuner> m_tuner_filter; //!< Autotuner for filter block size
         std::unique_ptr<Autotuner> m_tuner_head_list; //!< Autotuner for the head list block size
+        std::unique_ptr<Autotuner> m_tuner_cluster; //!< Autotuner for the cluster-pair list block size
 
         GlobalArray<unsigned int> m_alt_head_list; //!< Alternate array to hold the head list from prefix sum
+
+        bool m_cluster_pairs;                       //!< True if the cluster-pair list is requested
+        bool m_cluster_pairs_dirty;                 //!< True if the cluster-pair list needs to be rebuilt
+        unsigned int m_cluster_max;                 //!< Maximum number of j-clusters per i-cluster
+        GlobalArray<unsigned int> m_cluster_n;      //!< Number of j-clusters per i-cluster
+        GlobalArray<unsigned int> m_cluster_list;   //!< j-clusters of each i-cluster
+        GlobalArray<uint2> m_cluster_mask;          //!< Interaction mask of each cluster pair
+        Index2D m_cluster_indexer;                  //!< Indexer for the cluster-pair list
+        GPUFlags<unsigned int> m_cluster_req_max;   //!< Required number of j-clusters after an overflow
+
+        bool m_deferred_check;                      //!< True if the distance check result is read a step later
+        Scalar m_deferred_fraction;                 //!< Fraction of r_buff that triggers the early rebuild
+        GPUArray<unsigned int> m_deferred_flags;    //!< Exact and early check flags, in mapped host memory
+        cudaEvent_t m_deferred_event;               //!< Recorded after the deferred check kernels
+        bool m_deferred_pending;                    //!< True if a deferred check has been launched
+        unsigned int m_deferred_step;               //!< Time step of the pending deferred check
+        unsigned int m_deferred_checkn;             //!< Value written by the pending deferred check
+
+        //! Launch the distance check kernel
+        void launchDistanceCheck(unsigned int *d_result, Scalar r_buff, unsigned int checkn);
+
+        //! Launch the exact and early checks of the deferred distance check
+        void launchDeferredCheck(unsigned int timestep);
+
+        //! Perform the deferred distance check
+        bool deferredDistanceCheck(unsigned int timestep);
     };
 
 //! Exports NeighborListGPU to python
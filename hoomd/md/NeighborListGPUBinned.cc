@@ -43,23 +43,16 @@ NeighborListGPUBinned::NeighborListGPUBinned(std::shared_ptr<SystemDefinition> s
     CHECK_CUDA_ERROR();
 
     // initialize autotuner
-    // the full block size and threads_per_particle matrix is searched,
+    // the block size and threads_per_particle are searched by coordinate descent,
     // encoded as block_size*10000 + threads_per_particle
-    std::vector<unsigned int> valid_params;
-
-    const unsigned int max_tpp = m_exec_conf->dev_prop.warpSize;
+    std::vector< std::vector<unsigned int> > dim_values(2);
     for (unsigned int block_size = 32; block_size <= 1024; block_size += 32)
-        {
-        unsigned int s=1;
+        dim_values[0].push_back(block_size);
+    for (unsigned int s = 1; s <= (unsigned int)m_exec_conf->dev_prop.warpSize; s *= 2)
+        dim_values[1].push_back(s);
+    std::vector<unsigned int> dim_weights = {10000, 1};
 
-        while (s <= max_tpp)
-            {
-            valid_params.push_back(block_size*10000 + s);
-            s = s * 2;
-            }
-        }
-
-    m_tuner.reset(new Autotuner(valid_params, 5, 100000, "nlist_binned", this->m_exec_conf));
+    m_tuner.reset(new Autotuner(dim_values, dim_weights, 5, 100000, "nlist_binned", this->m_exec_conf));
 
     // call this class's special setRCut
     setRCut(r_cut, r_buff);
@@ -120,6 +113,10 @@ void NeighborListGPUBinned::buildNlist(unsigned int timestep)
     ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
     ArrayHandle<Scalar> d_diameter(m_pdata->getDiameters(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_body(m_pdata->getBodies(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_tag(m_pdata->getTags(), access_location::device, access_mode::read);
+
+    // exclusions within the tag window are checked in the build kernel
+    ArrayHandle<unsigned int> d_ex_mask(m_ex_mask_idx, access_location::device, access_mode::read);
 
     const BoxDim& box = m_pdata->getBox();
     Scalar3 nearest_plane_distance = box.getNearestPlaneDistance();
@@ -139,7 +136,6 @@ void NeighborListGPUBinned::buildNlist(unsigned int timestep)
         ArrayHandle<unsigned int>(GlobalArray<unsigned int>(), access_location::device, access_mode::read);
 
     ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_Nmax(m_Nmax, access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_conditions(m_conditions, access_location::device, access_mode::readwrite);
     ArrayHandle<unsigned int> d_nlist(m_nlist, access_location::device, access_mode::overwrite);
     ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::overwrite);
@@ -194,11 +190,12 @@ void NeighborListGPUBinned::buildNlist(unsigned int timestep)
                              d_n_neigh.data,
                              d_last_pos.data,
                              d_conditions.data,
-                             d_Nmax.data,
                              d_head_list.data,
                              d_pos.data,
                              d_body.data,
                              d_diameter.data,
+                             d_tag.data,
+                             useExclusionMask() ? d_ex_mask.data : NULL,
                              m_pdata->getN(),
                              m_cl->getPerDevice() ? d_cell_size_per_device.data : d_cell_size.data,
                              d_cell_xyzf.data,
@@ -5,6 +5,7 @@
 // Maintainer: joaander
 
 #include "NeighborListGPUBinned.cuh"
+#include "NeighborListExclusionMask.h"
 #include "hoomd/TextureTools.h"
 #include "hoomd/WarpTools.cuh"
 
@@ -21,11 +22,12 @@ scalar4_tex_t cell_xyzf_1d_tex;
     \param d_n_neigh Number of neighbors to write
     \param d_last_updated_pos Particle positions at this update are written to this array
     \param d_conditions Conditions array for writing overflow condition
-    \param d_Nmax Maximum number of neighbors per type
     \param d_head_list List of indexes to access \a d_nlist
     \param d_pos Particle positions
     \param d_body Particle body indices
     \param d_diameter Particle diameters
+    \param d_tag Particle tags (including ghosts), only read with \a d_ex_mask
+    \param d_ex_mask Exclusion masks of the local particles by index (NULL if exclusions are filtered after the build)
     \param N Number of particles
     \param d_cell_size Number of particles in each cell
     \param d_cell_xyzf Cell contents (xyzf array from CellList with flag=type)
@@ -50,11 +52,12 @@ __global__ void gpu_compute_nlist_binned_kernel(unsigned int *d_nlist,
                                                     unsigned int *d_n_neigh,
                                                     Scalar4 *d_last_updated_pos,
                                                     unsigned int *d_conditions,
-                                                    const unsigned int *d_Nmax,
                                                     const unsigned int *d_head_list,
                                                     const Scalar4 *d_pos,
                                                     const unsigned int *d_body,
                                                     const Scalar *d_diameter,
+                                                    const unsigned int *d_tag,
+                                                    const unsigned int *d_ex_mask,
                                                     const unsigned int N,
                                                     const unsigned int *d_cell_size,
                                                     const Scalar4 *d_cell_xyzf,
@@ -85,7 +88,6 @@ __global__ void gpu_compute_nlist_binned_kernel(unsigned int *d_nlist,
 
     // pointer for the r_listsq data
     Scalar *s_r_list = (Scalar *)(&s_data[0]);
-    unsigned int *s_Nmax = (unsigned int *)(&s_data[sizeof(Scalar)*num_typ_parameters]);
 
     // load in the per type pair r_list
     for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
@@ -96,10 +98,6 @@ __global__ void gpu_compute_nlist_binned_kernel(unsigned int *d_nlist,
             // force the r_list(i,j) to a skippable value if r_cut(i,j) is skippable
             s_r_list[cur_offset + threadIdx.x] = (r_cut > Scalar(0.0)) ? r_cut+r_buff : Scalar(-1.0);
             }
-        if (cur_offset + threadIdx.x < ntypes)
-            {
-            s_Nmax[cur_offset + threadIdx.x] = d_Nmax[cur_offset + threadIdx.x];
-            }
         }
     __syncthreads();
 
@@ -119,6 +117,11 @@ __global__ void gpu_compute_nlist_binned_kernel(unsigned int *d_nlist,
     unsigned int my_body = d_body[my_pidx];
     Scalar my_diam = d_diameter[my_pidx];
     unsigned int my_head = d_head_list[my_pidx];
+    unsigned int my_Nmax = d_head_list[my_pidx+1] - my_head;
+
+    // exclusions between particles close in tag order are checked inline
+    unsigned int my_ex_mask = d_ex_mask ? d_ex_mask[my_pidx] : 0;
+    unsigned int my_tag = my_ex_mask ? d_tag[my_pidx] : 0;
 
     Scalar3 f = box.makeFraction(my_pos, ghost_width);
 
@@ -241,6 +244,9 @@ __global__ void gpu_compute_nlist_binned_kernel(unsigned int *d_nlist,
                 if (filter_body && my_body != 0xffffffff)
                     excluded = excluded | (my_body == neigh_body);
 
+                if (my_ex_mask && !excluded)
+                    excluded = isExcludedByMask(my_ex_mask, my_tag, d_tag[cur_neigh]);
+
                 Scalar sqshift = Scalar(0.0);
                 if (diameter_shift)
                     {
@@ -269,7 +275,7 @@ __global__ void gpu_compute_nlist_binned_kernel(unsigned int *d_nlist,
             hoomd::detail::WarpScan<unsigned char, threads_per_particle>().ExclusiveSum(has_neighbor, k, n);
 
             // write neighbor if it fits in list
-            if (has_neighbor && (nneigh + k) < s_Nmax[my_type])
+            if (has_neighbor && (nneigh + k) < my_Nmax)
                 d_nlist[my_head + nneigh + k] = neighbor;
 
             // increment total neighbor count
@@ -280,7 +286,7 @@ __global__ void gpu_compute_nlist_binned_kernel(unsigned int *d_nlist,
     if (threadIdx.x % threads_per_particle == 0)
         {
         // flag if we need to grow the neighbor list
-        if (nneigh >= s_Nmax[my_type])
+        if (nneigh > my_Nmax)
             atomicMax(&d_conditions[my_type], nneigh);
 
         d_n_neigh[my_pidx] = nneigh;
@@ -315,11 +321,12 @@ inline void launcher(unsigned int *d_nlist,
               unsigned int *d_n_neigh,
               Scalar4 *d_last_updated_pos,
               unsigned int *d_conditions,
-              const unsigned int *d_Nmax,
               const unsigned int *d_head_list,
               const Scalar4 *d_pos,
               const unsigned int *d_body,
               const Scalar *d_diameter,
+              const unsigned int *d_tag,
+              const unsigned int *d_ex_mask,
               const unsigned int N,
               const unsigned int *d_cell_size,
               const Scalar4 *d_cell_xyzf,
@@ -343,9 +350,9 @@ inline void launcher(unsigned int *d_nlist,
               bool use_index,
               const unsigned int ngpu)
     {
-    // shared memory = r_listsq + Nmax + stuff needed for neighborlist (computed below)
+    // shared memory = r_listsq + stuff needed for neighborlist (computed below)
     Index2D typpair_idx(ntypes);
-    unsigned int shared_size = sizeof(Scalar)*typpair_idx.getNumElements() + sizeof(unsigned int)*ntypes;
+    unsigned int shared_size = sizeof(Scalar)*typpair_idx.getNumElements();
 
     unsigned int offset = range.first;
     unsigned int nwork = range.second - range.first;
@@ -368,11 +375,12 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pos,
                                                                                              d_body,
                                                                                              d_diameter,
+                                                                                             d_tag,
+                                                                                             d_ex_mask,
                                                                                              N,
                                                                                              d_cell_size,
                                                                                              d_cell_xyzf,
@@ -405,11 +413,12 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pos,
                                                                                              d_body,
                                                                                              d_diameter,
+                                                                                             d_tag,
+                                                                                             d_ex_mask,
                                                                                              N,
                                                                                              d_cell_size,
                                                                                              d_cell_xyzf,
@@ -442,11 +451,12 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pos,
                                                                                              d_body,
                                                                                              d_diameter,
+                                                                                             d_tag,
+                                                                                             d_ex_mask,
                                                                                              N,
                                                                                              d_cell_size,
                                                                                              d_cell_xyzf,
@@ -479,11 +489,12 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pos,
                                                                                              d_body,
                                                                                              d_diameter,
+                                                                                             d_tag,
+                                                                                             d_ex_mask,
                                                                                              N,
                                                                                              d_cell_size,
                                                                                              d_cell_xyzf,
@@ -519,11 +530,12 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pos,
                                                                                              d_body,
                                                                                              d_diameter,
+                                                                                             d_tag,
+                                                                                             d_ex_mask,
                                                                                              N,
                                                                                              d_cell_size,
                                                                                              d_cell_xyzf,
@@ -556,11 +568,12 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pos,
                                                                                              d_body,
                                                                                              d_diameter,
+                                                                                             d_tag,
+                                                                                             d_ex_mask,
                                                                                              N,
                                                                                              d_cell_size,
                                                                                              d_cell_xyzf,
@@ -593,11 +606,12 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pos,
                                                                                              d_body,
                                                                                              d_diameter,
+                                                                                             d_tag,
+                                                                                             d_ex_mask,
                                                                                              N,
                                                                                              d_cell_size,
                                                                                              d_cell_xyzf,
@@ -630,11 +644,12 @@ inline void launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pos,
                                                                                              d_body,
                                                                                              d_diameter,
+                                                                                             d_tag,
+                                                                                             d_ex_mask,
                                                                                              N,
                                                                                              d_cell_size,
                                                                                              d_cell_xyzf,
@@ -661,11 +676,12 @@ inline void launcher(unsigned int *d_nlist,
                      d_n_neigh,
                      d_last_updated_pos,
                      d_conditions,
-                     d_Nmax,
                      d_head_list,
                      d_pos,
                      d_body,
                      d_diameter,
+                     d_tag,
+                     d_ex_mask,
                      N,
                      d_cell_size,
                      d_cell_xyzf,
@@ -698,11 +714,12 @@ inline void launcher<min_threads_per_particle/2>(unsigned int *d_nlist,
               unsigned int *d_n_neigh,
               Scalar4 *d_last_updated_pos,
               unsigned int *d_conditions,
-              const unsigned int *d_Nmax,
               const unsigned int *d_head_list,
               const Scalar4 *d_pos,
               const unsigned int *d_body,
               const Scalar *d_diameter,
+              const unsigned int *d_tag,
+              const unsigned int *d_ex_mask,
               const unsigned int N,
               const unsigned int *d_cell_size,
               const Scalar4 *d_cell_xyzf,
@@ -731,11 +748,12 @@ cudaError_t gpu_compute_nlist_binned(unsigned int *d_nlist,
                                      unsigned int *d_n_neigh,
                                      Scalar4 *d_last_updated_pos,
                                      unsigned int *d_conditions,
-                                     const unsigned int *d_Nmax,
                                      const unsigned int *d_head_list,
                                      const Scalar4 *d_pos,
                                      const unsigned int *d_body,
                                      const Scalar *d_diameter,
+                                     const unsigned int *d_tag,
+                                     const unsigned int *d_ex_mask,
                                      const unsigned int N,
                                      const unsigned int *d_cell_size,
                                      const Scalar4 *d_cell_xyzf,
@@ -769,11 +787,12 @@ cudaError_t gpu_compute_nlist_binned(unsigned int *d_nlist,
                                        d_n_neigh,
                                        d_last_updated_pos,
                                        d_conditions,
-                                       d_Nmax,
                                        d_head_list,
                                        d_pos,
                                        d_body,
                                        d_diameter,
+                                       d_tag,
+                                       d_ex_mask,
                                        N,
                                        d_cell_size,
                                        d_cell_xyzf,
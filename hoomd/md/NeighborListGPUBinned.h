@@ -76,6 +76,12 @@ class PYBIND11_EXPORT NeighborListGPUBinned : public NeighborListGPU
 
         //! Builds the neighbor list
         virtual void buildNlist(unsigned int timestep);
+
+        //! The build checks the exclusion masks inline
+        virtual bool supportsExclusionMask()
+            {
+            return true;
+            }
     };
 
 //! Exports NeighborListGPUBinned to python
@@ -50,26 +50,21 @@ NeighborListGPUStencil::NeighborListGPUStencil(std::shared_ptr<SystemDefinition>
     m_cl->setFlagIndex();
     m_cl->setComputeAdjList(false);
 
+    m_levels.reset(new NeighborListStencilLevels(m_sysdef, m_cl, m_cls));
+
     CHECK_CUDA_ERROR();
 
     // initialize autotuner
-    // the full block size and threads_per_particle matrix is searched,
+    // the block size and threads_per_particle are searched by coordinate descent,
     // encoded as block_size*10000 + threads_per_particle
-    std::vector<unsigned int> valid_params;
-
-    const unsigned int max_tpp = m_exec_conf->dev_prop.warpSize;
+    std::vector< std::vector<unsigned int> > dim_values(2);
     for (unsigned int block_size = 32; block_size <= 1024; block_size += 32)
-        {
-        unsigned int s=1;
+        dim_values[0].push_back(block_size);
+    for (unsigned int s = 1; s <= (unsigned int)m_exec_conf->dev_prop.warpSize; s *= 2)
+        dim_values[1].push_back(s);
+    std::vector<unsigned int> dim_weights = {10000, 1};
 
-        while (s <= max_tpp)
-            {
-            valid_params.push_back(block_size*10000 + s);
-            s = s * 2;
-            }
-        }
-
-    m_tuner.reset(new Autotuner(valid_params, 5, 100000, "nlist_stencil", this->m_exec_conf));
+    m_tuner.reset(new Autotuner(dim_values, dim_weights, 5, 100000, "nlist_stencil", this->m_exec_conf));
     m_last_tuned_timestep = 0;
 
     #ifdef ENABLE_MPI
@@ -141,22 +136,22 @@ void NeighborListGPUStencil::setMaximumDiameter(Scalar d_max)
 
 void NeighborListGPUStencil::updateRStencil()
     {
-    ArrayHandle<Scalar> h_rcut_max(m_rcut_max, access_location::host, access_mode::read);
-    std::vector<Scalar> rstencil(m_pdata->getNTypes(), -1.0);
-    for (unsigned int cur_type=0; cur_type < m_pdata->getNTypes(); ++cur_type)
-        {
-        Scalar rcut = h_rcut_max.data[cur_type];
-        if (rcut > Scalar(0.0))
-            {
-            Scalar rlist = rcut + m_r_buff;
-            if (m_diameter_shift)
-                rlist += m_d_max - Scalar(1.0);
-            rstencil[cur_type] = rlist;
-            }
-        }
-    m_cls->setRStencil(rstencil);
+    ArrayHandle<Scalar> h_r_cut(m_r_cut, access_location::host, access_mode::read);
+    Scalar shift = m_diameter_shift ? m_d_max - Scalar(1.0) : Scalar(0.0);
+    m_levels->update(h_r_cut.data, m_typpair_idx, m_r_buff, shift);
     }
 
+#ifdef ENABLE_MPI
+/*!
+ * \param comm Communicator
+ */
+void NeighborListGPUStencil::setCommunicator(std::shared_ptr<Communicator> comm)
+    {
+    NeighborListGPU::setCommunicator(comm);
+    m_levels->setCommunicator(comm);
+    }
+#endif
+
 /*!
  * Rearranges the particle indexes by type to reduce execution divergence during the neighbor list build.
  * Radix sort is (supposed to be) stable so that the spatial sorting from SFC is also preserved within a type.
@@ -207,15 +202,13 @@ void NeighborListGPUStencil::buildNlist(unsigned int timestep)
         throw std::runtime_error("Error computing neighbor list");
         }
 
-    m_cl->compute(timestep);
-
-    // update the stencil radii if there was a change
+    // update the cutoff classes and stencil radii if there was a change
     if (m_needs_restencil)
         {
         updateRStencil();
         m_needs_restencil = false;
         }
-    m_cls->compute(timestep);
+    m_levels->compute(timestep);
 
     // sort the particles by type
     if (m_needs_resort)
@@ -236,16 +229,7 @@ void NeighborListGPUStencil::buildNlist(unsigned int timestep)
     const BoxDim& box = m_pdata->getBox();
     Scalar3 nearest_plane_distance = box.getNearestPlaneDistance();
 
-    // access the cell list data arrays
-    ArrayHandle<unsigned int> d_cell_size(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_cell_xyzf(m_cl->getXYZFArray(), access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_cell_tdb(m_cl->getTDBArray(), access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_stencil(m_cls->getStencils(), access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_n_stencil(m_cls->getStencilSizes(), access_location::device, access_mode::read);
-    const Index2D& stencil_idx = m_cls->getStencilIndexer();
-
     ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::read);
-    ArrayHandle<unsigned int> d_Nmax(m_Nmax, access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_conditions(m_conditions, access_location::device, access_mode::readwrite);
     ArrayHandle<unsigned int> d_nlist(m_nlist, access_location::device, access_mode::overwrite);
     ArrayHandle<unsigned int> d_n_neigh(m_n_neigh, access_location::device, access_mode::overwrite);
@@ -284,36 +268,50 @@ void NeighborListGPUStencil::buildNlist(unsigned int timestep)
     unsigned int block_size = param / 10000;
     unsigned int threads_per_particle = param % 10000;
 
-    // launch neighbor list kernel
-    gpu_compute_nlist_stencil(d_nlist.data,
-                              d_n_neigh.data,
-                              d_last_pos.data,
-                              d_conditions.data,
-                              d_Nmax.data,
-                              d_head_list.data,
-                              d_pid_map.data,
-                              d_pos.data,
-                              d_body.data,
-                              d_diameter.data,
-                              m_pdata->getN(),
-                              d_cell_size.data,
-                              d_cell_xyzf.data,
-                              d_cell_tdb.data,
-                              m_cl->getCellIndexer(),
-                              m_cl->getCellListIndexer(),
-                              d_stencil.data,
-                              d_n_stencil.data,
-                              stencil_idx,
-                              box,
-                              d_r_cut.data,
-                              m_r_buff,
-                              m_pdata->getNTypes(),
-                              m_cl->getGhostWidth(),
-                              m_filter_body,
-                              m_diameter_shift,
-                              threads_per_particle,
-                              block_size,
-                              m_exec_conf->getComputeCapability()/10);
+    // launch the neighbor list kernel once for the cell list of each level
+    for (unsigned int level = 0; level < m_levels->getNumLevels(); ++level)
+        {
+        std::shared_ptr<CellList> cl = m_levels->getCellList(level);
+        std::shared_ptr<CellListStencil> cls = m_levels->getStencil(level);
+
+        // access the cell list data arrays
+        ArrayHandle<unsigned int> d_cell_size(cl->getCellSizeArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_cell_xyzf(cl->getXYZFArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_cell_tdb(cl->getTDBArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar4> d_stencil(cls->getStencils(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_n_stencil(cls->getStencilSizes(), access_location::device, access_mode::read);
+        const Index2D& stencil_idx = cls->getStencilIndexer();
+
+        gpu_compute_nlist_stencil(d_nlist.data,
+                                  d_n_neigh.data,
+                                  d_last_pos.data,
+                                  d_conditions.data,
+                                  d_head_list.data,
+                                  d_pid_map.data,
+                                  d_pos.data,
+                                  d_body.data,
+                                  d_diameter.data,
+                                  m_pdata->getN(),
+                                  d_cell_size.data,
+                                  d_cell_xyzf.data,
+                                  d_cell_tdb.data,
+                                  cl->getCellIndexer(),
+                                  cl->getCellListIndexer(),
+                                  d_stencil.data,
+                                  d_n_stencil.data,
+                                  stencil_idx,
+                                  box,
+                                  d_r_cut.data,
+                                  m_r_buff,
+                                  m_pdata->getNTypes(),
+                                  cl->getGhostWidth(),
+                                  level > 0,
+                                  m_filter_body,
+                                  m_diameter_shift,
+                                  threads_per_particle,
+                                  block_size,
+                                  m_exec_conf->getComputeCapability()/10);
+        }
 
     if(m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
     if (tune) this->m_tuner->end();
@@ -328,5 +326,6 @@ void export_NeighborListGPUStencil(py::module& m)
     {
     py::class_<NeighborListGPUStencil, std::shared_ptr<NeighborListGPUStencil> >(m, "NeighborListGPUStencil", py::base<NeighborListGPU>())
         .def(py::init< std::shared_ptr<SystemDefinition>, Scalar, Scalar, std::shared_ptr<CellList>, std::shared_ptr<CellListStencil> >())
-        .def("setCellWidth", &NeighborListGPUStencil::setCellWidth);
+        .def("setCellWidth", &NeighborListGPUStencil::setCellWidth)
+        .def("setMultiLevel", &NeighborListGPUStencil::setMultiLevel);
     }
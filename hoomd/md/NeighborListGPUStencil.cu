@@ -29,7 +29,6 @@ scalar4_tex_t stencil_1d_tex;
     \param d_n_neigh Number of neighbors to write
     \param d_last_updated_pos Particle positions at this update are written to this array
     \param d_conditions Conditions array for writing overflow condition
-    \param d_Nmax Maximum number of neighbors per type
     \param d_head_list List of indexes to access \a d_nlist
     \param d_pos Particle positions
     \param d_body Particle body indices
@@ -48,6 +47,7 @@ scalar4_tex_t stencil_1d_tex;
     \param r_buff The maximum radius for which to include particles as neighbors
     \param ntypes Number of particle types
     \param ghost_width Width of ghost cell layer
+    \param append If true, append to the neighbors in \a d_n_neigh instead of starting a new list
 
     \note optimized for Kepler
 */
@@ -56,7 +56,6 @@ __global__ void gpu_compute_nlist_stencil_kernel(unsigned int *d_nlist,
                                                  unsigned int *d_n_neigh,
                                                  Scalar4 *d_last_updated_pos,
                                                  unsigned int *d_conditions,
-                                                 const unsigned int *d_Nmax,
                                                  const unsigned int *d_head_list,
                                                  const unsigned int *d_pid_map,
                                                  const Scalar4 *d_pos,
@@ -75,7 +74,8 @@ __global__ void gpu_compute_nlist_stencil_kernel(unsigned int *d_nlist,
                                                  const Scalar *d_r_cut,
                                                  const Scalar r_buff,
                                                  const unsigned int ntypes,
-                                                 const Scalar3 ghost_width)
+                                                 const Scalar3 ghost_width,
+                                                 const bool append)
     {
     bool filter_body = flags & 1;
     bool diameter_shift = flags & 2;
@@ -89,7 +89,6 @@ __global__ void gpu_compute_nlist_stencil_kernel(unsigned int *d_nlist,
 
     // pointer for the r_listsq data
     Scalar *s_r_list = (Scalar *)(&s_data[0]);
-    unsigned int *s_Nmax = (unsigned int *)(&s_data[sizeof(Scalar)*num_typ_parameters]);
 
     // load in the per type pair r_list
     for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
@@ -100,10 +99,6 @@ __global__ void gpu_compute_nlist_stencil_kernel(unsigned int *d_nlist,
             // force the r_list(i,j) to a skippable value if r_cut(i,j) is skippable
             s_r_list[cur_offset + threadIdx.x] = (r_cut > Scalar(0.0)) ? r_cut+r_buff : Scalar(-1.0);
             }
-        if (cur_offset + threadIdx.x < ntypes)
-            {
-            s_Nmax[cur_offset + threadIdx.x] = d_Nmax[cur_offset + threadIdx.x];
-            }
         }
     __syncthreads();
 
@@ -123,6 +118,7 @@ __global__ void gpu_compute_nlist_stencil_kernel(unsigned int *d_nlist,
     unsigned int my_body = d_body[my_pidx];
     Scalar my_diam = d_diameter[my_pidx];
     unsigned int my_head = d_head_list[my_pidx];
+    unsigned int my_Nmax = d_head_list[my_pidx+1] - my_head;
 
     Scalar3 f = box.makeFraction(my_pos, ghost_width);
 
@@ -161,8 +157,8 @@ __global__ void gpu_compute_nlist_stencil_kernel(unsigned int *d_nlist,
 
     bool done = false;
 
-    // total number of neighbors
-    unsigned int nneigh = 0;
+    // total number of neighbors, appended to the neighbors already found in other cell lists
+    unsigned int nneigh = append ? d_n_neigh[my_pidx] : 0;
 
     while (! done)
         {
@@ -270,7 +266,7 @@ __global__ void gpu_compute_nlist_stencil_kernel(unsigned int *d_nlist,
             hoomd::detail::WarpScan<unsigned char, threads_per_particle>().ExclusiveSum(has_neighbor, k, n);
 
             // write neighbor if it fits in list
-            if (has_neighbor && (nneigh + k) < s_Nmax[my_type])
+            if (has_neighbor && (nneigh + k) < my_Nmax)
                 d_nlist[my_head + nneigh + k] = neighbor;
 
             // increment total neighbor count
@@ -281,7 +277,7 @@ __global__ void gpu_compute_nlist_stencil_kernel(unsigned int *d_nlist,
     if (threadIdx.x % threads_per_particle == 0)
         {
         // flag if we need to grow the neighbor list
-        if (nneigh >= s_Nmax[my_type])
+        if (nneigh > my_Nmax)
             atomicMax(&d_conditions[my_type], nneigh);
 
         d_n_neigh[my_pidx] = nneigh;
@@ -338,7 +334,6 @@ inline void stencil_launcher(unsigned int *d_nlist,
                              unsigned int *d_n_neigh,
                              Scalar4 *d_last_updated_pos,
                              unsigned int *d_conditions,
-                             const unsigned int *d_Nmax,
                              const unsigned int *d_head_list,
                              const unsigned int *d_pid_map,
                              const Scalar4 *d_pos,
@@ -358,15 +353,16 @@ inline void stencil_launcher(unsigned int *d_nlist,
                              const Scalar r_buff,
                              const unsigned int ntypes,
                              const Scalar3& ghost_width,
+                             const bool append,
                              bool filter_body,
                              bool diameter_shift,
                              const unsigned int threads_per_particle,
                              const unsigned int block_size,
                              const unsigned int compute_capability)
     {
-    // shared memory = r_listsq + Nmax + stuff needed for neighborlist (computed below)
+    // shared memory = r_listsq + stuff needed for neighborlist (computed below)
     Index2D typpair_idx(ntypes);
-    unsigned int shared_size = sizeof(Scalar)*typpair_idx.getNumElements() + sizeof(unsigned int)*ntypes;
+    unsigned int shared_size = sizeof(Scalar)*typpair_idx.getNumElements();
 
     if (threads_per_particle == cur_tpp && cur_tpp != 0)
         {
@@ -387,7 +383,6 @@ inline void stencil_launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pid_map,
                                                                                              d_pos,
@@ -406,7 +401,9 @@ inline void stencil_launcher(unsigned int *d_nlist,
                                                                                              d_r_cut,
                                                                                              r_buff,
                                                                                              ntypes,
-                                                                                             ghost_width);
+                                                                                             ghost_width,
+
+                                                                                             append);
             }
         else if (!diameter_shift && filter_body)
             {
@@ -425,7 +422,6 @@ inline void stencil_launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pid_map,
                                                                                              d_pos,
@@ -444,7 +440,9 @@ inline void stencil_launcher(unsigned int *d_nlist,
                                                                                              d_r_cut,
                                                                                              r_buff,
                                                                                              ntypes,
-                                                                                             ghost_width);
+                                                                                             ghost_width,
+
+                                                                                             append);
             }
         else if (diameter_shift && !filter_body)
             {
@@ -463,7 +461,6 @@ inline void stencil_launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pid_map,
                                                                                              d_pos,
@@ -482,7 +479,9 @@ inline void stencil_launcher(unsigned int *d_nlist,
                                                                                              d_r_cut,
                                                                                              r_buff,
                                                                                              ntypes,
-                                                                                             ghost_width);
+                                                                                             ghost_width,
+
+                                                                                             append);
             }
         else if (diameter_shift && filter_body)
             {
@@ -501,7 +500,6 @@ inline void stencil_launcher(unsigned int *d_nlist,
                                                                                              d_n_neigh,
                                                                                              d_last_updated_pos,
                                                                                              d_conditions,
-                                                                                             d_Nmax,
                                                                                              d_head_list,
                                                                                              d_pid_map,
                                                                                              d_pos,
@@ -520,7 +518,9 @@ inline void stencil_launcher(unsigned int *d_nlist,
                                                                                              d_r_cut,
                                                                                              r_buff,
                                                                                              ntypes,
-                                                                                             ghost_width);
+                                                                                             ghost_width,
+
+                                                                                             append);
             }
         }
     else
@@ -529,7 +529,6 @@ inline void stencil_launcher(unsigned int *d_nlist,
                                     d_n_neigh,
                                     d_last_updated_pos,
                                     d_conditions,
-                                    d_Nmax,
                                     d_head_list,
                                     d_pid_map,
                                     d_pos,
@@ -549,6 +548,7 @@ inline void stencil_launcher(unsigned int *d_nlist,
                                     r_buff,
                                     ntypes,
                                     ghost_width,
+                                    append,
                                     filter_body,
                                     diameter_shift,
                                     threads_per_particle,
@@ -563,7 +563,6 @@ inline void stencil_launcher<min_threads_per_particle/2>(unsigned int *d_nlist,
                                                          unsigned int *d_n_neigh,
                                                          Scalar4 *d_last_updated_pos,
                                                          unsigned int *d_conditions,
-                                                         const unsigned int *d_Nmax,
                                                          const unsigned int *d_head_list,
                                                          const unsigned int *d_pid_map,
                                                          const Scalar4 *d_pos,
@@ -583,6 +582,7 @@ inline void stencil_launcher<min_threads_per_particle/2>(unsigned int *d_nlist,
                                                          const Scalar r_buff,
                                                          const unsigned int ntypes,
                                                          const Scalar3& ghost_width,
+                                                         const bool append,
                                                          bool filter_body,
                                                          bool diameter_shift,
                                                          const unsigned int threads_per_particle,
@@ -594,7 +594,6 @@ cudaError_t gpu_compute_nlist_stencil(unsigned int *d_nlist,
                                       unsigned int *d_n_neigh,
                                       Scalar4 *d_last_updated_pos,
                                       unsigned int *d_conditions,
-                                      const unsigned int *d_Nmax,
                                       const unsigned int *d_head_list,
                                       const unsigned int *d_pid_map,
                                       const Scalar4 *d_pos,
@@ -614,6 +613,7 @@ cudaError_t gpu_compute_nlist_stencil(unsigned int *d_nlist,
                                       const Scalar r_buff,
                                       const unsigned int ntypes,
                                       const Scalar3& ghost_width,
+                                      const bool append,
                                       bool filter_body,
                                       bool diameter_shift,
                                       const unsigned int threads_per_particle,
@@ -624,7 +624,6 @@ cudaError_t gpu_compute_nlist_stencil(unsigned int *d_nlist,
                                                d_n_neigh,
                                                d_last_updated_pos,
                                                d_conditions,
-                                               d_Nmax,
                                                d_head_list,
                                                d_pid_map,
                                                d_pos,
@@ -644,6 +643,7 @@ cudaError_t gpu_compute_nlist_stencil(unsigned int *d_nlist,
                                                r_buff,
                                                ntypes,
                                                ghost_width,
+                                               append,
                                                filter_body,
                                                diameter_shift,
                                                threads_per_particle,
@@ -26,7 +26,6 @@ cudaError_t gpu_compute_nlist_stencil(unsigned int *d_nlist,
                                       unsigned int *d_n_neigh,
                                       Scalar4 *d_last_updated_pos,
                                       unsigned int *d_conditions,
-                                      const unsigned int *d_Nmax,
                                       const unsigned int *d_head_list,
                                       const unsigned int *d_pid_map,
                                       const Scalar4 *d_pos,
@@ -46,6 +45,7 @@ cudaError_t gpu_compute_nlist_stencil(unsigned int *d_nlist,
                                       const Scalar r_buff,
                                       const unsigned int ntypes,
                                       const Scalar3& ghost_width,
+                                      const bool append,
                                       bool filter_body,
                                       bool diameter_shift,
                                       const unsigned int threads_per_particle,
@@ -8,6 +8,7 @@
 #include "hoomd/CellList.h"
 #include "hoomd/CellListStencil.h"
 #include "hoomd/Autotuner.h"
+#include "NeighborListStencilLevels.h"
 
 /*! \file NeighborListGPUStencil.h
     \brief Declares the NeighborListGPUStencil class
@@ -23,7 +24,9 @@
 #define __NEIGHBORLISTGPUSTENCIL_H__
 
 //! Neighbor list build on the GPU with multiple bin stencils
-/*! Implements the O(N) neighbor list build on the GPU using a cell list with multiple bin stencils.
+/*! Implements the O(N) neighbor list build on the GPU using a cell list with multiple bin stencils. When the types
+    fall into several cutoff classes, each class is binned in its own cell list (see NeighborListStencilLevels) and
+    the kernel is launched once per level, appending to the neighbors found in the previous levels.
 
     GPU kernel methods are defined in NeighborListGPUStencil.cuh and defined in NeighborListGPUStencil.cu.
 
@@ -54,6 +57,14 @@ class PYBIND11_EXPORT NeighborListGPUStencil : public NeighborListGPU
             m_override_cell_width = true;
             m_needs_restencil = true;
             m_cl->setNominalWidth(cell_width);
+            m_levels->setCellWidth(cell_width);
+            }
+
+        //! Use one cell list per cutoff class
+        void setMultiLevel(bool multi_level)
+            {
+            m_levels->setMultiLevel(multi_level);
+            m_needs_restencil = true;
             }
 
         //! Set autotuner parameters
@@ -70,6 +81,11 @@ class PYBIND11_EXPORT NeighborListGPUStencil : public NeighborListGPU
         //! Set the maximum diameter to use in computing neighbor lists
         virtual void setMaximumDiameter(Scalar d_max);
 
+        #ifdef ENABLE_MPI
+        //! Set the communicator to use
+        virtual void setCommunicator(std::shared_ptr<Communicator> comm);
+        #endif
+
     protected:
         //! Builds the neighbor list
         virtual void buildNlist(unsigned int timestep);
@@ -81,6 +97,7 @@ class PYBIND11_EXPORT NeighborListGPUStencil : public NeighborListGPU
         std::shared_ptr<CellList> m_cl;   //!< The cell list
         std::shared_ptr<CellListStencil> m_cls;   //!< The cell list stencil
         bool m_override_cell_width;                 //!< Flag to override the cell width
+        std::unique_ptr<NeighborListStencilLevels> m_levels; //!< Cell lists and stencils of the cutoff classes
 
         //! Update the stencil radius
         void updateRStencil();
@@ -23,13 +23,15 @@ NeighborListGPUTree::NeighborListGPUTree(std::shared_ptr<SystemDefinition> sysde
                                        Scalar r_cut,
                                        Scalar r_buff)
     : NeighborListGPU(sysdef, r_cut, r_buff), m_type_changed(false), m_box_changed(true),
-      m_max_num_changed(false), m_n_leaf(0), m_n_internal(0), m_n_node(0), m_n_images(0)
+      m_max_num_changed(false), m_n_leaf(0), m_n_internal(0), m_n_node(0), m_refit_period(1), m_refit_threshold(1.5),
+      m_can_refit(false), m_n_refit(0), m_build_N(0), m_build_area(0.0), m_n_images(0)
     {
     m_exec_conf->msg->notice(5) << "Constructing NeighborListGPUTree" << endl;
 
     m_pdata->getNumTypesChangeSignal().connect<NeighborListGPUTree, &NeighborListGPUTree::slotNumTypesChanged>(this);
     m_pdata->getBoxChangeSignal().connect<NeighborListGPUTree, &NeighborListGPUTree::slotBoxChanged>(this);
     m_pdata->getMaxParticleNumberChangeSignal().connect<NeighborListGPUTree, &NeighborListGPUTree::slotMaxNumChanged>(this);
+    m_pdata->getParticleSortSignal().connect<NeighborListGPUTree, &NeighborListGPUTree::slotParticleSort>(this);
 
     m_tuner_morton.reset(new Autotuner(32, 1024, 32, 5, 100000, "nlist_morton_codes", this->m_exec_conf));
     m_tuner_merge.reset(new Autotuner(32, 1024, 32, 5, 100000, "nlist_merge_particles", this->m_exec_conf));
@@ -52,6 +54,7 @@ NeighborListGPUTree::~NeighborListGPUTree()
     m_pdata->getNumTypesChangeSignal().disconnect<NeighborListGPUTree, &NeighborListGPUTree::slotNumTypesChanged>(this);
     m_pdata->getBoxChangeSignal().disconnect<NeighborListGPUTree, &NeighborListGPUTree::slotBoxChanged>(this);
     m_pdata->getMaxParticleNumberChangeSignal().disconnect<NeighborListGPUTree, &NeighborListGPUTree::slotMaxNumChanged>(this);
+    m_pdata->getParticleSortSignal().disconnect<NeighborListGPUTree, &NeighborListGPUTree::slotParticleSort>(this);
     }
 
 void NeighborListGPUTree::buildNlist(unsigned int timestep)
@@ -68,8 +71,9 @@ void NeighborListGPUTree::buildNlist(unsigned int timestep)
     // allocate the tree memory as needed based on the mapping
     setupTree();
 
-    // build the tree
-    buildTree();
+    // refit the tree if its leaf order is still valid, and build it otherwise
+    if (!refitTree())
+        buildTree();
 
     // walk with the tree
     traverseTree();
@@ -127,6 +131,9 @@ void NeighborListGPUTree::allocateTree()
     // conditions
     GPUFlags<int> morton_conditions(m_exec_conf);
     m_morton_conditions.swap(morton_conditions);
+
+    GPUFlags<Scalar> tree_area(m_exec_conf);
+    m_tree_area.swap(tree_area);
     }
 
 /*!
@@ -146,6 +153,7 @@ void NeighborListGPUTree::setupTree()
 
         // all done with the particle data reallocation
         m_max_num_changed = false;
+        m_can_refit = false;
         }
 
     // allocate memory that depends on type
@@ -161,6 +169,7 @@ void NeighborListGPUTree::setupTree()
 
         // all done with the type reallocation
         m_type_changed = false;
+        m_can_refit = false;
         m_prev_ntypes = m_pdata->getNTypes();
         }
 
@@ -378,7 +387,106 @@ void NeighborListGPUTree::buildTree()
     // step six: bubble up the aabbs
     bubbleAABBs();
 
+    // the leaf order stays valid for refits until the particles are sorted or change in number
+    m_can_refit = true;
+    m_n_refit = 0;
+    m_build_N = m_pdata->getN() + m_pdata->getNGhosts();
+    if (m_refit_period > 1 && m_refit_threshold > Scalar(1.0))
+        m_build_area = computeTreeArea();
+
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+/*!
+ * Recomputes the leaf AABBs from the current particle positions in the leaf order of the last build, and bubbles them
+ * up the existing hierarchy. This skips the morton code calculation, the sort, and the hierarchy generation, at the
+ * cost of a tree that loosens as particles diffuse away from the positions at which it was built. The tree is rebuilt
+ * every m_refit_period builds, or earlier when its summed node surface area grows beyond m_refit_threshold times that
+ * of the last build.
+ *
+ * A refit requires the local particles to be in the same order as at the last build, which is not the case after a
+ * particle sort, a change in the number of particles or their types, or a ghost exchange. Refitting is therefore
+ * disabled in MPI simulations.
+ *
+ * \returns true if the tree was refit, false if it must be rebuilt
+ */
+bool NeighborListGPUTree::refitTree()
+    {
+    if (m_refit_period <= 1 || !m_can_refit || m_n_refit + 1 >= m_refit_period
+        || m_pdata->getN() + m_pdata->getNGhosts() != m_build_N)
+        return false;
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        return false;
+    #endif
+
+    if (m_prof) m_prof->push(m_exec_conf,"Refit tree");
+
+    m_morton_conditions.resetFlags(0);
+    mergeLeafParticles(true);
+
+    // a particle changed its type, so the per-type trees are invalid
+    if (m_morton_conditions.readFlags())
+        {
+        m_can_refit = false;
+        if (m_prof) m_prof->pop(m_exec_conf);
+        return false;
+        }
+
+    bubbleAABBs();
+
+    if (m_refit_threshold > Scalar(1.0) && computeTreeArea() > m_refit_threshold*m_build_area)
+        {
+        if (m_prof) m_prof->pop(m_exec_conf);
+        return false;
+        }
+
+    ++m_n_refit;
+
     if (m_prof) m_prof->pop(m_exec_conf);
+    return true;
+    }
+
+/*!
+ * \returns The summed surface area of all nodes in the tree, a measure of the traversal cost
+ */
+Scalar NeighborListGPUTree::computeTreeArea()
+    {
+    if (!m_n_node)
+        return Scalar(0.0);
+
+        {
+        ArrayHandle<Scalar4> d_tree_aabbs(m_tree_aabbs, access_location::device, access_mode::read);
+        ScopedAllocation<Scalar> d_node_area(m_exec_conf->getCachedAllocator(), m_n_node);
+
+        // size the temporary storage
+        void *d_tmp_storage = NULL;
+        size_t tmp_storage_bytes = 0;
+        gpu_nlist_tree_area(m_tree_area.getDeviceFlags(),
+                            d_node_area.data,
+                            d_tmp_storage,
+                            tmp_storage_bytes,
+                            d_tree_aabbs.data,
+                            m_n_node,
+                            m_tuner_bubble->getParam());
+
+        size_t alloc_size = (tmp_storage_bytes > 0) ? tmp_storage_bytes : 4;
+        ScopedAllocation<unsigned char> d_alloc(m_exec_conf->getCachedAllocator(), alloc_size);
+        d_tmp_storage = (void *)d_alloc();
+
+        gpu_nlist_tree_area(m_tree_area.getDeviceFlags(),
+                            d_node_area.data,
+                            d_tmp_storage,
+                            tmp_storage_bytes,
+                            d_tree_aabbs.data,
+                            m_n_node,
+                            m_tuner_bubble->getParam());
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    return m_tree_area.readFlags();
     }
 
 /*!
@@ -531,10 +639,13 @@ void NeighborListGPUTree::sortMortonCodes()
  * \post AABB leafs are constructed for adjacent groupings of particles.
  * \note Call after sortMortonCodes(), but before genTreeHierarchy().
  */
-void NeighborListGPUTree::mergeLeafParticles()
+void NeighborListGPUTree::mergeLeafParticles(bool refit)
     {
     if (m_prof) m_prof->push(m_exec_conf,"Leaf merge");
 
+    // a refit keeps the morton codes and the hierarchy of the last build
+    const access_mode::Enum tree_mode = refit ? access_mode::readwrite : access_mode::overwrite;
+
     // particle position data
     ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_num_per_type(m_num_per_type, access_location::device, access_mode::read);
@@ -547,8 +658,8 @@ void NeighborListGPUTree::mergeLeafParticles()
 
     // tree aabbs and reduced morton codes to overwrite
     ArrayHandle<Scalar4> d_tree_aabbs(m_tree_aabbs, access_location::device, access_mode::overwrite);
-    ArrayHandle<uint32_t> d_morton_codes_red(m_morton_codes_red, access_location::device, access_mode::overwrite);
-    ArrayHandle<uint2> d_tree_parent_sib(m_tree_parent_sib, access_location::device, access_mode::overwrite);
+    ArrayHandle<uint32_t> d_morton_codes_red(m_morton_codes_red, access_location::device, tree_mode);
+    ArrayHandle<uint2> d_tree_parent_sib(m_tree_parent_sib, access_location::device, tree_mode);
 
     m_tuner_merge->begin();
     gpu_nlist_merge_particles(d_tree_aabbs.data,
@@ -563,6 +674,8 @@ void NeighborListGPUTree::mergeLeafParticles()
                               d_type_head.data,
                               m_pdata->getN() + m_pdata->getNGhosts(),
                               m_n_leaf,
+                              refit,
+                              m_morton_conditions.getDeviceFlags(),
                               m_tuner_merge->getParam());
     if (m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
@@ -760,7 +873,6 @@ void NeighborListGPUTree::traverseTree()
     ArrayHandle<Scalar4> d_last_updated_pos(m_last_pos, access_location::device, access_mode::overwrite);
     ArrayHandle<unsigned int> d_conditions(m_conditions, access_location::device, access_mode::readwrite);
 
-    ArrayHandle<unsigned int> d_Nmax(m_Nmax, access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_head_list(m_head_list, access_location::device, access_mode::read);
 
     // tree data
@@ -787,7 +899,6 @@ void NeighborListGPUTree::traverseTree()
                             d_n_neigh.data,
                             d_last_updated_pos.data,
                             d_conditions.data,
-                            d_Nmax.data,
                             d_head_list.data,
                             m_pdata->getN(),
                             m_pdata->getNGhosts(),
@@ -821,5 +932,6 @@ void NeighborListGPUTree::traverseTree()
 void export_NeighborListGPUTree(py::module& m)
     {
     py::class_<NeighborListGPUTree, std::shared_ptr<NeighborListGPUTree> >(m, "NeighborListGPUTree", py::base<NeighborListGPU>())
-    .def(py::init< std::shared_ptr<SystemDefinition>, Scalar, Scalar >());
+    .def(py::init< std::shared_ptr<SystemDefinition>, Scalar, Scalar >())
+    .def("setRefitParams", &NeighborListGPUTree::setRefitParams);
     }
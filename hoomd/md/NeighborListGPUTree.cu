@@ -288,6 +288,8 @@ cudaError_t gpu_nlist_morton_sort(uint64_t *d_morton_types,
  * \param d_type_head Index to first type and leaf ordered particles by type
  * \param Ntot Total number of keys to sort
  * \param nleafs Number of leaf nodes
+ * \param refit If true, only recompute the leaf AABBs of an existing tree
+ * \param d_refit_conditions Flag set if a particle no longer has the type of its leaf during a refit
  *
  * \b Implementation
  * One thread per leaf is called, and is responsible for merging NLIST_GPU_PARTICLES_PER_LEAF into an AABB. Each thread
@@ -315,7 +317,9 @@ __global__ void gpu_nlist_merge_particles_kernel(Scalar4 *d_tree_aabbs,
                                                  const unsigned int *d_leaf_offset,
                                                  const unsigned int *d_type_head,
                                                  const unsigned int Ntot,
-                                                 const unsigned int nleafs)
+                                                 const unsigned int nleafs,
+                                                 const bool refit,
+                                                 int *d_refit_conditions)
     {
     // leaf index
     const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
@@ -354,15 +358,21 @@ __global__ void gpu_nlist_merge_particles_kernel(Scalar4 *d_tree_aabbs,
 
     // upper also holds the skip value, but we have no idea what this is right now
     Scalar4 upper = d_pos[ d_map_tree_pid[start_idx] ];
-    upper.w = 0.0f;
 
     // lower holds the particle number, we have one already
     Scalar4 lower = upper;
     unsigned int npart = 1;
 
+    // a particle that changed its type since the build invalidates the refit tree
+    if (refit && __scalar_as_int(upper.w) != leaf_type)
+        *d_refit_conditions = 1;
+    upper.w = 0.0f;
+
     for (unsigned int cur_p=start_idx+1; cur_p < end_idx; ++cur_p)
         {
         Scalar4 cur_pos = d_pos[ d_map_tree_pid[cur_p] ];
+        if (refit && __scalar_as_int(cur_pos.w) != leaf_type)
+            *d_refit_conditions = 1;
 
         // merge the boxes together
         if (cur_pos.x < lower.x) lower.x = cur_pos.x;
@@ -380,6 +390,10 @@ __global__ void gpu_nlist_merge_particles_kernel(Scalar4 *d_tree_aabbs,
     d_tree_aabbs[2*idx] = upper;
     d_tree_aabbs[2*idx + 1] = make_scalar4(lower.x, lower.y, lower.z, __int_as_scalar(npart << 1));
 
+    // the morton codes and the hierarchy of a refit tree are kept from its build
+    if (refit)
+        return;
+
     // take logical AND with the 30 bit mask for the morton codes to extract just the morton code
     // no sense swinging around 64 bit integers anymore
     d_morton_codes_red[idx] = (unsigned int)(d_morton_types[start_idx] & MORTON_TYPE_MASK_64);
@@ -402,6 +416,8 @@ __global__ void gpu_nlist_merge_particles_kernel(Scalar4 *d_tree_aabbs,
  * \param d_type_head Index to first type and leaf ordered particles by type
  * \param Ntot Total number of keys to sort
  * \param nleafs Number of leaf nodes
+ * \param refit If true, only recompute the leaf AABBs of an existing tree
+ * \param d_refit_conditions Flag set if a particle no longer has the type of its leaf during a refit
  *
  * \returns cudaSuccess on completion
  */
@@ -417,6 +433,8 @@ cudaError_t gpu_nlist_merge_particles(Scalar4 *d_tree_aabbs,
                                       const unsigned int *d_type_head,
                                       const unsigned int Ntot,
                                       const unsigned int nleafs,
+                                      const bool refit,
+                                      int *d_refit_conditions,
                                       const unsigned int block_size)
     {
     static unsigned int max_block_size = UINT_MAX;
@@ -440,7 +458,9 @@ cudaError_t gpu_nlist_merge_particles(Scalar4 *d_tree_aabbs,
                                                                                 d_leaf_offset,
                                                                                 d_type_head,
                                                                                 Ntot,
-                                                                                nleafs);
+                                                                                nleafs,
+                                                                                refit,
+                                                                                d_refit_conditions);
     return cudaSuccess;
     }
 
@@ -840,6 +860,65 @@ cudaError_t gpu_nlist_bubble_aabbs(unsigned int *d_node_locks,
     return cudaSuccess;
     }
 
+//! Kernel to compute the surface area of each tree node
+/*!
+ * \param d_node_area Surface area of each node
+ * \param d_tree_aabbs AABB array for all tree nodes
+ * \param nnodes Number of nodes in the tree
+ *
+ * \b Implementation
+ * One thread per node is called. The upper and lower bounds are read from the flat AABB array.
+ */
+__global__ void gpu_nlist_node_area_kernel(Scalar *d_node_area,
+                                           const Scalar4 *d_tree_aabbs,
+                                           const unsigned int nnodes)
+    {
+    const unsigned int idx = blockDim.x * blockIdx.x + threadIdx.x;
+
+    if (idx >= nnodes)
+        return;
+
+    const Scalar4 upper = d_tree_aabbs[2*idx];
+    const Scalar4 lower = d_tree_aabbs[2*idx+1];
+    const Scalar dx = upper.x - lower.x;
+    const Scalar dy = upper.y - lower.y;
+    const Scalar dz = upper.z - lower.z;
+    d_node_area[idx] = Scalar(2.0)*(dx*dy + dy*dz + dz*dx);
+    }
+
+/*!
+ * \param d_total_area Summed surface area of all nodes (output)
+ * \param d_node_area Temporary storage for the surface area of each node
+ * \param d_tmp_storage Temporary storage in device memory
+ * \param tmp_storage_bytes Number of bytes allocated for temporary storage
+ * \param d_tree_aabbs AABB array for all tree nodes
+ * \param nnodes Number of nodes in the tree
+ * \param block_size Requested thread block size
+ *
+ * \returns cudaSuccess on completion
+ *
+ * As with gpu_nlist_morton_sort(), this function must be called twice. When \a d_tmp_storage is NULL, only the number
+ * of bytes of temporary storage for the CUB reduction is saved in \a tmp_storage_bytes. On the second call, the node
+ * areas are computed and summed.
+ */
+cudaError_t gpu_nlist_tree_area(Scalar *d_total_area,
+                                Scalar *d_node_area,
+                                void *d_tmp_storage,
+                                size_t &tmp_storage_bytes,
+                                const Scalar4 *d_tree_aabbs,
+                                const unsigned int nnodes,
+                                const unsigned int block_size)
+    {
+    if (d_tmp_storage != NULL)
+        {
+        gpu_nlist_node_area_kernel<<<nnodes/block_size + 1, block_size>>>(d_node_area, d_tree_aabbs, nnodes);
+        }
+
+    cub::DeviceReduce::Sum(d_tmp_storage, tmp_storage_bytes, d_node_area, d_total_area, nnodes);
+
+    return cudaSuccess;
+    }
+
 //! Kernel to rearrange particle data into leaf order for faster traversal
 /*!
  * \param d_leaf_xyzf Particle xyz coordinates + particle id in leaf order
@@ -925,7 +1004,6 @@ cudaError_t gpu_nlist_move_particles(Scalar4 *d_leaf_xyzf,
  * \param d_n_neigh Number of neighbors per particle
  * \param d_last_updated_pos Records current particle positions
  * \param d_conditions Store overflow condition by type
- * \param d_Nmax Maximum number of neighbors allocated by type
  * \param d_head_list Indexes for writing into neighbor list
  * \param N Number of particles
  * \param nghosts Number of ghost particles
@@ -959,7 +1037,6 @@ __global__ void gpu_nlist_traverse_tree_kernel(unsigned int *d_nlist,
                                                unsigned int *d_n_neigh,
                                                Scalar4 *d_last_updated_pos,
                                                unsigned int *d_conditions,
-                                               const unsigned int *d_Nmax,
                                                const unsigned int *d_head_list,
                                                const unsigned int N,
                                                const unsigned int nghosts,
@@ -990,8 +1067,7 @@ __global__ void gpu_nlist_traverse_tree_kernel(unsigned int *d_nlist,
 
     // pointer for the r_listsq data
     Scalar *s_r_list = (Scalar *)(&s_data[0]);
-    unsigned int *s_Nmax = (unsigned int *)(&s_data[sizeof(Scalar)*num_typ_parameters]);
-    unsigned int *s_leaf_offset = (unsigned int *)(&s_data[sizeof(Scalar)*num_typ_parameters + sizeof(unsigned int)*ntypes]);
+    unsigned int *s_leaf_offset = (unsigned int *)(&s_data[sizeof(Scalar)*num_typ_parameters]);
 
     // load in the per type pair r_list
     for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
@@ -1005,7 +1081,6 @@ __global__ void gpu_nlist_traverse_tree_kernel(unsigned int *d_nlist,
 
         if (cur_offset + threadIdx.x < ntypes)
             {
-            s_Nmax[cur_offset + threadIdx.x] = d_Nmax[cur_offset + threadIdx.x];
             s_leaf_offset[cur_offset + threadIdx.x] = d_leaf_offset[cur_offset + threadIdx.x];
             }
         }
@@ -1035,6 +1110,7 @@ __global__ void gpu_nlist_traverse_tree_kernel(unsigned int *d_nlist,
     const unsigned int body_i = __scalar_as_int(db_i.y);
 
     const unsigned int nlist_head_i = texFetchUint(d_head_list, head_list_tex, my_pidx);
+    const unsigned int Nmax_i = texFetchUint(d_head_list, head_list_tex, my_pidx+1) - nlist_head_i;
 
     unsigned int n_neigh_i = 0;
     for (unsigned int cur_pair_type=0; cur_pair_type < ntypes; ++cur_pair_type)
@@ -1126,7 +1202,7 @@ __global__ void gpu_nlist_traverse_tree_kernel(unsigned int *d_nlist,
 
                                 if (dr2 <= (r_cutsq_i + sqshift))
                                     {
-                                    if (n_neigh_i < s_Nmax[type_i])
+                                    if (n_neigh_i < Nmax_i)
                                         {
                                         d_nlist[nlist_head_i + n_neigh_i] = j;
                                         }
@@ -1157,7 +1233,7 @@ __global__ void gpu_nlist_traverse_tree_kernel(unsigned int *d_nlist,
     d_last_updated_pos[my_pidx] = make_scalar4(pos_i.x, pos_i.y, pos_i.z, __scalar_as_int(type_i));
 
     // update the number of neighbors for this type if allocated memory is exceeded
-    if (n_neigh_i >= s_Nmax[type_i])
+    if (n_neigh_i > Nmax_i)
         atomicMax(&d_conditions[type_i], n_neigh_i);
     }
 
@@ -1166,7 +1242,6 @@ __global__ void gpu_nlist_traverse_tree_kernel(unsigned int *d_nlist,
  * \param d_n_neigh Number of neighbors per particle
  * \param d_last_updated_pos Records current particle positions
  * \param d_conditions Store overflow condition by type
- * \param d_Nmax Maximum number of neighbors allocated by type
  * \param d_head_list Indexes for writing into neighbor list
  * \param N Number of particles
  * \param nghosts Number of ghost particles
@@ -1201,7 +1276,6 @@ cudaError_t gpu_nlist_traverse_tree(unsigned int *d_nlist,
                                     unsigned int *d_n_neigh,
                                     Scalar4 *d_last_updated_pos,
                                     unsigned int *d_conditions,
-                                    const unsigned int *d_Nmax,
                                     const unsigned int *d_head_list,
                                     const unsigned int N,
                                     const unsigned int nghosts,
@@ -1226,9 +1300,9 @@ cudaError_t gpu_nlist_traverse_tree(unsigned int *d_nlist,
                                     const unsigned int compute_capability,
                                     const unsigned int block_size)
     {
-    // shared memory = r_list + Nmax
+    // shared memory = r_list + leaf offsets
     Index2D typpair_idx(ntypes);
-    unsigned int shared_size = sizeof(Scalar)*typpair_idx.getNumElements() + 2*sizeof(unsigned int)*ntypes;
+    unsigned int shared_size = sizeof(Scalar)*typpair_idx.getNumElements() + sizeof(unsigned int)*ntypes;
 
     // bind the neighborlist texture
     if (compute_capability < 35)
@@ -1259,7 +1333,7 @@ cudaError_t gpu_nlist_traverse_tree(unsigned int *d_nlist,
 
         head_list_tex.normalized = false;
         head_list_tex.filterMode = cudaFilterModePoint;
-        error = cudaBindTexture(0, head_list_tex, d_head_list, sizeof(unsigned int)*N);
+        error = cudaBindTexture(0, head_list_tex, d_head_list, sizeof(unsigned int)*(N+1));
         if (error != cudaSuccess)
             return error;
         }
@@ -1280,7 +1354,6 @@ cudaError_t gpu_nlist_traverse_tree(unsigned int *d_nlist,
                                                                                     d_n_neigh,
                                                                                     d_last_updated_pos,
                                                                                     d_conditions,
-                                                                                    d_Nmax,
                                                                                     d_head_list,
                                                                                     N,
                                                                                     nghosts,
@@ -1315,7 +1388,6 @@ cudaError_t gpu_nlist_traverse_tree(unsigned int *d_nlist,
                                                                                     d_n_neigh,
                                                                                     d_last_updated_pos,
                                                                                     d_conditions,
-                                                                                    d_Nmax,
                                                                                     d_head_list,
                                                                                     N,
                                                                                     nghosts,
@@ -1350,7 +1422,6 @@ cudaError_t gpu_nlist_traverse_tree(unsigned int *d_nlist,
                                                                                     d_n_neigh,
                                                                                     d_last_updated_pos,
                                                                                     d_conditions,
-                                                                                    d_Nmax,
                                                                                     d_head_list,
                                                                                     N,
                                                                                     nghosts,
@@ -1385,7 +1456,6 @@ cudaError_t gpu_nlist_traverse_tree(unsigned int *d_nlist,
                                                                                     d_n_neigh,
                                                                                     d_last_updated_pos,
                                                                                     d_conditions,
-                                                                                    d_Nmax,
                                                                                     d_head_list,
                                                                                     N,
                                                                                     nghosts,
@@ -59,6 +59,8 @@ cudaError_t gpu_nlist_merge_particles(Scalar4 *d_tree_aabbs,
                                       const unsigned int *d_type_head,
                                       const unsigned int N,
                                       const unsigned int nleafs,
+                                      const bool refit,
+                                      int *d_refit_conditions,
                                       const unsigned int block_size);
 
 //! Kernel driver to generate the AABB tree hierarchy from morton codes
@@ -79,6 +81,15 @@ cudaError_t gpu_nlist_bubble_aabbs(unsigned int *d_node_locks,
                                    const unsigned int ninternal,
                                    const unsigned int block_size);
 
+//! Kernel driver to sum the surface areas of all tree nodes
+cudaError_t gpu_nlist_tree_area(Scalar *d_total_area,
+                                Scalar *d_node_area,
+                                void *d_tmp_storage,
+                                size_t &tmp_storage_bytes,
+                                const Scalar4 *d_tree_aabbs,
+                                const unsigned int nnodes,
+                                const unsigned int block_size);
+
 //! Kernel driver to rearrange particle data into leaf order
 cudaError_t gpu_nlist_move_particles(Scalar4 *d_leaf_xyzf,
                                      Scalar2 *d_leaf_db,
@@ -94,7 +105,6 @@ cudaError_t gpu_nlist_traverse_tree(unsigned int *d_nlist,
                                     unsigned int *d_n_neigh,
                                     Scalar4 *d_last_updated_pos,
                                     unsigned int *d_conditions,
-                                    const unsigned int *d_Nmax,
                                     const unsigned int *d_head_list,
                                     const unsigned int N,
                                     const unsigned int nghosts,
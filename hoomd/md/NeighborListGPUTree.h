@@ -68,6 +68,18 @@ class PYBIND11_EXPORT NeighborListGPUTree : public NeighborListGPU
             m_tuner_traverse->setEnabled(enable);
             }
 
+        //! Set the parameters for refitting the tree instead of rebuilding it
+        /*! \param period Rebuild the tree at least every \a period neighbor list builds, refit is disabled for values
+                          of 1 and below
+            \param threshold Rebuild when the refit tree exceeds this multiple of the node surface area at its last
+                             build, disabled for values of 1 and below
+        */
+        void setRefitParams(unsigned int period, Scalar threshold)
+            {
+            m_refit_period = period;
+            m_refit_threshold = threshold;
+            }
+
     protected:
         //! Builds the neighbor list
         virtual void buildNlist(unsigned int timestep);
@@ -99,6 +111,12 @@ class PYBIND11_EXPORT NeighborListGPUTree : public NeighborListGPU
             m_max_num_changed = true;
             }
 
+        //! Notification of a particle sort, which invalidates the leaf order of the tree
+        void slotParticleSort()
+            {
+            m_can_refit = false;
+            }
+
         //! Notification of a change in the number of types
         void slotNumTypesChanged()
             {
@@ -154,6 +172,20 @@ class PYBIND11_EXPORT NeighborListGPUTree : public NeighborListGPU
         //! Driver for tree multi-step tree build on the GPU
         void buildTree();
 
+        //! Refit the node AABBs of the current tree to the particle positions
+        bool refitTree();
+
+        //! Sum the surface area of all tree nodes
+        Scalar computeTreeArea();
+
+        unsigned int m_refit_period;    //!< The tree is rebuilt at least every m_refit_period builds
+        Scalar m_refit_threshold;       //!< Relative surface area growth that triggers a rebuild
+        bool m_can_refit;               //!< True if the leaf order of the tree is valid for the current particles
+        unsigned int m_n_refit;         //!< Number of refits since the last tree build
+        unsigned int m_build_N;         //!< Number of local and ghost particles at the last tree build
+        Scalar m_build_area;            //!< Summed node surface area at the last tree build
+        GPUFlags<Scalar> m_tree_area;   //!< Summed node surface area computed on the GPU
+
         //! Calculates 30-bit morton codes for particles
         void calcMortonCodes();
 
@@ -165,7 +197,7 @@ class PYBIND11_EXPORT NeighborListGPUTree : public NeighborListGPU
         unsigned int m_n_type_bits;     //!< the number of bits it takes to represent all the type ids
 
         //! Merges sorted particles into leafs based on adjacency
-        void mergeLeafParticles();
+        void mergeLeafParticles(bool refit=false);
 
         //! Generates the edges between nodes based on the sorted morton codes
         void genTreeHierarchy();
@@ -14,6 +14,9 @@
 #include "hoomd/Communicator.h"
 #endif
 
+#include <cmath>
+#include <vector>
+
 using namespace std;
 namespace py = pybind11;
 /*!
@@ -48,6 +51,8 @@ NeighborListStencil::NeighborListStencil(std::shared_ptr<SystemDefinition> sysde
     m_cl->setFlagIndex();
     m_cl->setComputeAdjList(false);
 
+    m_levels.reset(new NeighborListStencilLevels(m_sysdef, m_cl, m_cls));
+
     // call this class's special setRCut
     setRCut(r_cut, r_buff);
 
@@ -104,36 +109,31 @@ void NeighborListStencil::setMaximumDiameter(Scalar d_max)
 
 void NeighborListStencil::updateRStencil()
     {
-    ArrayHandle<Scalar> h_rcut_max(m_rcut_max, access_location::host, access_mode::read);
-    std::vector<Scalar> rstencil(m_pdata->getNTypes(), -1.0);
-    for (unsigned int cur_type=0; cur_type < m_pdata->getNTypes(); ++cur_type)
-        {
-        Scalar rcut = h_rcut_max.data[cur_type];
-        if (rcut > Scalar(0.0))
-            {
-            Scalar rlist = rcut + m_r_buff;
-            if (m_diameter_shift)
-                rlist += m_d_max - Scalar(1.0);
-            rstencil[cur_type] = rlist;
-            }
-        }
-    m_cls->setRStencil(rstencil);
+    ArrayHandle<Scalar> h_r_cut(m_r_cut, access_location::host, access_mode::read);
+    Scalar shift = m_diameter_shift ? m_d_max - Scalar(1.0) : Scalar(0.0);
+    m_levels->update(h_r_cut.data, m_typpair_idx, m_r_buff, shift);
     }
 
-void NeighborListStencil::buildNlist(unsigned int timestep)
+#ifdef ENABLE_MPI
+/*!
+ * \param comm Communicator
+ */
+void NeighborListStencil::setCommunicator(std::shared_ptr<Communicator> comm)
     {
-    m_cl->compute(timestep);
+    NeighborList::setCommunicator(comm);
+    m_levels->setCommunicator(comm);
+    }
+#endif
 
-    // update the stencil radii if there was a change
+void NeighborListStencil::buildNlist(unsigned int timestep)
+    {
+    // update the cutoff classes and stencil radii if there was a change
     if (m_needs_restencil)
         {
         updateRStencil();
         m_needs_restencil = false;
         }
-    m_cls->compute(timestep);
-
-    uint3 dim = m_cl->getDim();
-    Scalar3 ghost_width = m_cl->getGhostWidth();
+    m_levels->compute(timestep);
 
     if (m_prof)
         m_prof->push(m_exec_conf, "compute");
@@ -142,6 +142,11 @@ void NeighborListStencil::buildNlist(unsigned int timestep)
     ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+    // exclusions within the tag window are checked inline
+    ArrayHandle<unsigned int> h_ex_mask(m_ex_mask_idx, access_location::host, access_mode::read);
+    const unsigned int *ex_mask = useExclusionMask() ? h_ex_mask.data : NULL;
 
     const BoxDim& box = m_pdata->getBox();
     Scalar3 nearest_plane_distance = box.getNearestPlaneDistance();
@@ -172,169 +177,222 @@ void NeighborListStencil::buildNlist(unsigned int timestep)
     // access the rlist data
     ArrayHandle<Scalar> h_r_cut(m_r_cut, access_location::host, access_mode::read);
 
-    // access the cell list data arrays
-    ArrayHandle<unsigned int> h_cell_size(m_cl->getCellSizeArray(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_cell_xyzf(m_cl->getXYZFArray(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_cell_tdb(m_cl->getTDBArray(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_stencil(m_cls->getStencils(), access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_n_stencil(m_cls->getStencilSizes(), access_location::host, access_mode::read);
-    const Index2D& stencil_idx = m_cls->getStencilIndexer();
-
     // access the neighbor list data
     ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_conditions(m_conditions, access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
 
-    // access indexers
-    Index3D ci = m_cl->getCellIndexer();
-    Index2D cli = m_cl->getCellListIndexer();
+    // box parameters for the branchless minimum image
+    const Scalar3 L = box.getL();
+    const Scalar3 L_inv = make_scalar3(Scalar(1.0)/L.x, Scalar(1.0)/L.y, Scalar(1.0)/L.z);
+    const Scalar xy = box.getTiltFactorXY();
+    const Scalar xz = box.getTiltFactorXZ();
+    const Scalar yz = box.getTiltFactorYZ();
+    const Scalar3 periodic_f = make_scalar3(periodic.x ? 1 : 0, periodic.y ? 1 : 0, periodic.z ? 1 : 0);
 
-    // for each local particle
+    // in half mode, pairs are only checked from the particle with the lower index
+    const bool half_list = (m_storage_mode == half);
+
+    // number of local particles
     unsigned int nparticles = m_pdata->getN();
 
-    for (int i = 0; i < (int)nparticles; i++)
+    // search the cell list of each level for the types it bins
+    for (unsigned int level = 0; level < m_levels->getNumLevels(); ++level)
         {
-        unsigned int cur_n_neigh = 0;
-
-        const Scalar3 my_pos = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        const unsigned int type_i = __scalar_as_int(h_pos.data[i].w);
-        const unsigned int body_i = h_body.data[i];
-        const Scalar diam_i = h_diameter.data[i];
-
-        const unsigned int Nmax_i = h_Nmax.data[type_i];
-        const unsigned int head_idx_i = h_head_list.data[i];
-
-        // find the bin each particle belongs in
-        Scalar3 f = box.makeFraction(my_pos,ghost_width);
-        int ib = (unsigned int)(f.x * dim.x);
-        int jb = (unsigned int)(f.y * dim.y);
-        int kb = (unsigned int)(f.z * dim.z);
-
-        // need to handle the case where the particle is exactly at the box hi
-        if (ib == (int)dim.x && periodic.x)
-            ib = 0;
-        if (jb == (int)dim.y && periodic.y)
-            jb = 0;
-        if (kb == (int)dim.z && periodic.z)
-            kb = 0;
-
-        // loop through all neighboring bins
-        unsigned int n_stencil = h_n_stencil.data[type_i];
-        for (unsigned int cur_stencil = 0; cur_stencil < n_stencil; ++cur_stencil)
+        std::shared_ptr<CellList> cl = m_levels->getCellList(level);
+        std::shared_ptr<CellListStencil> cls = m_levels->getStencil(level);
+        const uint3 dim = cl->getDim();
+        const Scalar3 ghost_width = cl->getGhostWidth();
+
+        // access the cell list data arrays
+        ArrayHandle<unsigned int> h_cell_size(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_cell_xyzf(cl->getXYZFArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_cell_tdb(cl->getTDBArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_stencil(cls->getStencils(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_stencil(cls->getStencilSizes(), access_location::host, access_mode::read);
+        const Index2D& stencil_idx = cls->getStencilIndexer();
+
+        // access indexers
+        Index3D ci = cl->getCellIndexer();
+        Index2D cli = cl->getCellListIndexer();
+
+        // largest squared list radius of each type in this level, used to filter the candidates before the pair is checked
+        const std::vector<Scalar>& rstencil = m_levels->getRStencil(level);
+        std::vector<Scalar> rlist_max_sq(m_pdata->getNTypes(), Scalar(-1.0));
+        for (unsigned int cur_type=0; cur_type < m_pdata->getNTypes(); ++cur_type)
             {
-            // compute the stenciled cell cartesian coordinates
-            Scalar4 stencil = h_stencil.data[stencil_idx(cur_stencil, type_i)];
-            int sib = ib + __scalar_as_int(stencil.x);
-            int sjb = jb + __scalar_as_int(stencil.y);
-            int skb = kb + __scalar_as_int(stencil.z);
-            Scalar cell_dist2 = stencil.w;
-            // wrap through the boundary
-            if (periodic.x)
-                {
-                if (sib >= (int)dim.x) sib -= dim.x;
-                else if (sib < 0) sib += dim.x;
+            if (rstencil[cur_type] > Scalar(0.0))
+                rlist_max_sq[cur_type] = rstencil[cur_type]*rstencil[cur_type];
+            }
 
-                // wrapping and the stencil construction should ensure this is in bounds
-                assert(sib >= 0 && sib < (int)dim.x);
-                }
-            else if (sib < 0 || sib >= (int)dim.x)
-                {
-                // in aperiodic systems the stencil could maybe extend out of the grid
-                continue;
-                }
+        // squared distances to the particles of the current cell
+        std::vector<Scalar> dr_sq(cli.getW());
 
-            if (periodic.y)
+        for (int i = 0; i < (int)nparticles; i++)
+            {
+            // the levels after the first one append to the neighbors that were already found
+            unsigned int cur_n_neigh = (level == 0) ? 0 : h_n_neigh.data[i];
+
+            const Scalar3 my_pos = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+            const unsigned int type_i = __scalar_as_int(h_pos.data[i].w);
+            const unsigned int body_i = h_body.data[i];
+            const Scalar diam_i = h_diameter.data[i];
+            const unsigned int ex_mask_i = ex_mask ? ex_mask[i] : 0;
+            const unsigned int tag_i = ex_mask_i ? h_tag.data[i] : 0;
+
+            const unsigned int head_idx_i = h_head_list.data[i];
+            const unsigned int Nmax_i = h_head_list.data[i+1] - head_idx_i;
+            const Scalar rlist_max_sq_i = rlist_max_sq[type_i];
+
+            // find the bin each particle belongs in
+            Scalar3 f = box.makeFraction(my_pos,ghost_width);
+            int ib = (unsigned int)(f.x * dim.x);
+            int jb = (unsigned int)(f.y * dim.y);
+            int kb = (unsigned int)(f.z * dim.z);
+
+            // need to handle the case where the particle is exactly at the box hi
+            if (ib == (int)dim.x && periodic.x)
+                ib = 0;
+            if (jb == (int)dim.y && periodic.y)
+                jb = 0;
+            if (kb == (int)dim.z && periodic.z)
+                kb = 0;
+
+            // loop through all neighboring bins
+            unsigned int n_stencil = h_n_stencil.data[type_i];
+            for (unsigned int cur_stencil = 0; cur_stencil < n_stencil; ++cur_stencil)
                 {
-                if (sjb >= (int)dim.y) sjb -= dim.y;
-                else if (sjb < 0) sjb += dim.y;
+                // compute the stenciled cell cartesian coordinates
+                Scalar4 stencil = h_stencil.data[stencil_idx(cur_stencil, type_i)];
+                int sib = ib + __scalar_as_int(stencil.x);
+                int sjb = jb + __scalar_as_int(stencil.y);
+                int skb = kb + __scalar_as_int(stencil.z);
+                Scalar cell_dist2 = stencil.w;
+                // wrap through the boundary
+                if (periodic.x)
+                    {
+                    if (sib >= (int)dim.x) sib -= dim.x;
+                    else if (sib < 0) sib += dim.x;
 
-                assert(sjb >= 0 && sjb < (int)dim.y);
-                }
-            else if (sjb < 0 || sjb >= (int)dim.y)
-                {
-                continue;
-                }
+                    // wrapping and the stencil construction should ensure this is in bounds
+                    assert(sib >= 0 && sib < (int)dim.x);
+                    }
+                else if (sib < 0 || sib >= (int)dim.x)
+                    {
+                    // in aperiodic systems the stencil could maybe extend out of the grid
+                    continue;
+                    }
 
-            if (periodic.z)
-                {
-                if (skb >= (int)dim.z) skb -= dim.z;
-                else if (skb < 0) skb += dim.z;
+                if (periodic.y)
+                    {
+                    if (sjb >= (int)dim.y) sjb -= dim.y;
+                    else if (sjb < 0) sjb += dim.y;
 
-                assert(skb >= 0 && skb < (int)dim.z);
-                }
-            else if (skb < 0 || skb >= (int)dim.z)
-                {
-                continue;
-                }
+                    assert(sjb >= 0 && sjb < (int)dim.y);
+                    }
+                else if (sjb < 0 || sjb >= (int)dim.y)
+                    {
+                    continue;
+                    }
 
-            unsigned int neigh_cell = ci(sib, sjb, skb);
+                if (periodic.z)
+                    {
+                    if (skb >= (int)dim.z) skb -= dim.z;
+                    else if (skb < 0) skb += dim.z;
 
-            // check against all the particles in that neighboring bin to see if it is a neighbor
-            unsigned int size = h_cell_size.data[neigh_cell];
-            for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
-                {
-                // read in the particle type (diameter and body as well while we've got the Scalar4 in)
-                const Scalar4& neigh_tdb = h_cell_tdb.data[cli(cur_offset, neigh_cell)];
-                const unsigned int type_j = __scalar_as_int(neigh_tdb.x);
-                const Scalar diam_j = neigh_tdb.y;
-                const unsigned int body_j = __scalar_as_int(neigh_tdb.z);
-
-                // skip any particles belonging to the same rigid body if requested
-                if (m_filter_body && body_i != NO_BODY && body_i == body_j) continue;
-
-                // read cutoff and skip if pair is inactive
-                Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i,type_j)];
-                if (r_cut <= Scalar(0.0)) continue;
-
-                // compute the rlist based on the particle type we're interacting with
-                Scalar r_list = r_cut + m_r_buff;
-                Scalar sqshift = Scalar(0.0);
-                if (m_diameter_shift)
+                    assert(skb >= 0 && skb < (int)dim.z);
+                    }
+                else if (skb < 0 || skb >= (int)dim.z)
                     {
-                    const Scalar delta = (diam_i + diam_j) * Scalar(0.5) - Scalar(1.0);
-                    // r^2 < (r_list + delta)^2
-                    // r^2 < r_listsq + delta^2 + 2*r_list*delta
-                    sqshift = (delta + Scalar(2.0) * r_list) * delta;
+                    continue;
                     }
-                Scalar r_listsq = r_list*r_list + sqshift;
 
-                // compare the check distance to the minimum cell distance, and pass without distance check if unnecessary
-                if (cell_dist2 > r_listsq) continue;
+                unsigned int neigh_cell = ci(sib, sjb, skb);
+
+                // skip the whole cell if no pair of types can reach it
+                if (cell_dist2 > rlist_max_sq_i) continue;
+
+                // first pass: distances to all particles in the cell, without branches so that the loop vectorizes
+                const unsigned int size = h_cell_size.data[neigh_cell];
+                const Scalar4 *cell_xyzf = h_cell_xyzf.data + cli(0, neigh_cell);
+                for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
+                    {
+                    Scalar dx = my_pos.x - cell_xyzf[cur_offset].x;
+                    Scalar dy = my_pos.y - cell_xyzf[cur_offset].y;
+                    Scalar dz = my_pos.z - cell_xyzf[cur_offset].z;
 
-                // only load in the particle position and id if distance check is satisfied
-                const Scalar4& neigh_xyzf = h_cell_xyzf.data[cli(cur_offset, neigh_cell)];
-                unsigned int cur_neigh = __scalar_as_int(neigh_xyzf.w);
+                    // minimum image, the periodic flags are 0 or 1
+                    const Scalar img_z = periodic_f.z * std::floor(dz * L_inv.z + Scalar(0.5));
+                    dz -= L.z * img_z;
+                    dy -= L.z * yz * img_z;
+                    dx -= L.z * xz * img_z;
 
-                // a particle cannot neighbor itself
-                if (i == (int)cur_neigh) continue;
+                    const Scalar img_y = periodic_f.y * std::floor(dy * L_inv.y + Scalar(0.5));
+                    dy -= L.y * img_y;
+                    dx -= L.y * xy * img_y;
 
-                Scalar3 neigh_pos = make_scalar3(neigh_xyzf.x, neigh_xyzf.y, neigh_xyzf.z);
-                Scalar3 dx = my_pos - neigh_pos;
-                dx = box.minImage(dx);
+                    const Scalar img_x = periodic_f.x * std::floor(dx * L_inv.x + Scalar(0.5));
+                    dx -= L.x * img_x;
 
-                Scalar dr_sq = dot(dx,dx);
+                    dr_sq[cur_offset] = dx*dx + dy*dy + dz*dz;
+                    }
 
-                if (dr_sq <= r_listsq)
+                // second pass: check the pair only for the particles within the largest list radius of type i
+                for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
                     {
-                    if (m_storage_mode == full || i < (int)cur_neigh)
+                    const Scalar dr_sq_j = dr_sq[cur_offset];
+                    if (dr_sq_j > rlist_max_sq_i) continue;
+
+                    const unsigned int cur_neigh = __scalar_as_int(cell_xyzf[cur_offset].w);
+
+                    // a particle cannot neighbor itself, and half lists only store the pair on the lower index
+                    if (half_list ? ((int)cur_neigh <= i) : (i == (int)cur_neigh)) continue;
+
+                    // read in the particle type (diameter and body as well while we've got the Scalar4 in)
+                    const Scalar4& neigh_tdb = h_cell_tdb.data[cli(cur_offset, neigh_cell)];
+                    const unsigned int type_j = __scalar_as_int(neigh_tdb.x);
+                    const Scalar diam_j = neigh_tdb.y;
+                    const unsigned int body_j = __scalar_as_int(neigh_tdb.z);
+
+                    // skip any particles belonging to the same rigid body if requested
+                    if (m_filter_body && body_i != NO_BODY && body_i == body_j) continue;
+
+                    // read cutoff and skip if pair is inactive
+                    Scalar r_cut = h_r_cut.data[m_typpair_idx(type_i,type_j)];
+                    if (r_cut <= Scalar(0.0)) continue;
+
+                    // compute the rlist based on the particle type we're interacting with
+                    Scalar r_list = r_cut + m_r_buff;
+                    Scalar sqshift = Scalar(0.0);
+                    if (m_diameter_shift)
                         {
-                        // local neighbor
-                        if (cur_n_neigh < Nmax_i)
-                            {
-                            h_nlist.data[head_idx_i + cur_n_neigh] = cur_neigh;
-                            }
-                        else
-                            h_conditions.data[type_i] = max(h_conditions.data[type_i], cur_n_neigh+1);
-
-                        ++cur_n_neigh;
+                        const Scalar delta = (diam_i + diam_j) * Scalar(0.5) - Scalar(1.0);
+                        // r^2 < (r_list + delta)^2
+                        // r^2 < r_listsq + delta^2 + 2*r_list*delta
+                        sqshift = (delta + Scalar(2.0) * r_list) * delta;
                         }
+                    Scalar r_listsq = r_list*r_list + sqshift;
+
+                    if (dr_sq_j > r_listsq) continue;
+
+                    // skip particles excluded by the exclusion mask of i
+                    if (ex_mask_i && isExcludedByMask(ex_mask_i, tag_i, h_tag.data[cur_neigh])) continue;
+
+                    // local neighbor
+                    if (cur_n_neigh < Nmax_i)
+                        {
+                        h_nlist.data[head_idx_i + cur_n_neigh] = cur_neigh;
+                        }
+                    else
+                        h_conditions.data[type_i] = max(h_conditions.data[type_i], cur_n_neigh+1);
+
+                    ++cur_n_neigh;
                     }
                 }
-            }
 
-        h_n_neigh.data[i] = cur_n_neigh;
+            h_n_neigh.data[i] = cur_n_neigh;
+            }
         }
 
     if (m_prof)
@@ -345,5 +403,6 @@ void export_NeighborListStencil(py::module& m)
     {
     py::class_<NeighborListStencil, std::shared_ptr<NeighborListStencil> >(m, "NeighborListStencil", py::base<NeighborList>())
         .def(py::init< std::shared_ptr<SystemDefinition>, Scalar, Scalar, std::shared_ptr<CellList>, std::shared_ptr<CellListStencil> >())
-        .def("setCellWidth", &NeighborListStencil::setCellWidth);
+        .def("setCellWidth", &NeighborListStencil::setCellWidth)
+        .def("setMultiLevel", &NeighborListStencil::setMultiLevel);
     }
@@ -7,6 +7,7 @@
 #include "NeighborList.h"
 #include "hoomd/CellList.h"
 #include "hoomd/CellListStencil.h"
+#include "NeighborListStencilLevels.h"
 
 /*! \file NeighborListStencil.h
     \brief Declares the NeighborListStencil class
@@ -22,7 +23,9 @@
 #define __NEIGHBORLISTSTENCIL_H__
 
 //! Efficient neighbor list build on the CPU with multiple bin stencils
-/*! Implements the O(N) neighbor list build on the CPU using a cell list with multiple bin stencils.
+/*! Implements the O(N) neighbor list build on the CPU using a cell list with multiple bin stencils. When the types
+    fall into several cutoff classes, each class is binned in its own cell list (see NeighborListStencilLevels) and
+    the levels are searched one after the other.
 
     \sa CellListStencil
     \ingroup computes
@@ -52,19 +55,39 @@ class PYBIND11_EXPORT NeighborListStencil : public NeighborList
             m_override_cell_width = true;
             m_needs_restencil = true;
             m_cl->setNominalWidth(cell_width);
+            m_levels->setCellWidth(cell_width);
+            }
+
+        //! Use one cell list per cutoff class
+        void setMultiLevel(bool multi_level)
+            {
+            m_levels->setMultiLevel(multi_level);
+            m_needs_restencil = true;
             }
 
         //! Set the maximum diameter to use in computing neighbor lists
         virtual void setMaximumDiameter(Scalar d_max);
 
+        #ifdef ENABLE_MPI
+        //! Set the communicator to use
+        virtual void setCommunicator(std::shared_ptr<Communicator> comm);
+        #endif
+
     protected:
         //! Builds the neighbor list
         virtual void buildNlist(unsigned int timestep);
 
+        //! The build checks the exclusion masks inline
+        virtual bool supportsExclusionMask()
+            {
+            return true;
+            }
+
     private:
         std::shared_ptr<CellList> m_cl;           //!< The cell list
         std::shared_ptr<CellListStencil> m_cls;   //!< The cell list stencil
         bool m_override_cell_width;                 //!< Flag to override the cell width
+        std::unique_ptr<NeighborListStencilLevels> m_levels; //!< Cell lists and stencils of the cutoff classes
 
         bool m_needs_restencil;                             //!< Flag for updating the stencil
         void slotRCutChange()
@@ -0,0 +1,195 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: mphoward
+
+/*! \file NeighborListStencilLevels.cc
+    \brief Defines NeighborListStencilLevels
+*/
+
+#include "NeighborListStencilLevels.h"
+
+#ifdef ENABLE_CUDA
+#include "hoomd/CellListGPU.h"
+#endif
+
+#ifdef ENABLE_MPI
+#include "hoomd/Communicator.h"
+#endif
+
+#include <algorithm>
+
+/*!
+ * \param sysdef System definition
+ * \param cl Cell list of level 0
+ * \param cls Cell list stencil of level 0
+ */
+NeighborListStencilLevels::NeighborListStencilLevels(std::shared_ptr<SystemDefinition> sysdef,
+                                                     std::shared_ptr<CellList> cl,
+                                                     std::shared_ptr<CellListStencil> cls)
+    : m_sysdef(sysdef), m_pdata(sysdef->getParticleData()), m_exec_conf(m_pdata->getExecConf()),
+      m_multi_level(true), m_override_cell_width(false), m_cell_width(0.0)
+    {
+    m_cl.push_back(cl);
+    m_cls.push_back(cls);
+    m_rstencil.push_back(std::vector<Scalar>(m_pdata->getNTypes(), -1.0));
+    }
+
+/*!
+ * \param r_cut Cutoff radius of each type pair
+ * \param typpair_idx Indexer for \a r_cut
+ * \param r_buff Neighbor list buffer width
+ * \param shift Shift of the list radius for diameter shifting (zero if not used)
+ *
+ * Cell lists are created for new levels and released for levels that are no longer needed.
+ */
+void NeighborListStencilLevels::update(const Scalar *r_cut,
+                                       const Index2D& typpair_idx,
+                                       Scalar r_buff,
+                                       Scalar shift)
+    {
+    const unsigned int ntypes = m_pdata->getNTypes();
+
+    // largest list radius of each type
+    std::vector<Scalar> rlist_max(ntypes, -1.0);
+    for (unsigned int i=0; i < ntypes; ++i)
+        {
+        for (unsigned int j=0; j < ntypes; ++j)
+            {
+            Scalar rc = r_cut[typpair_idx(i,j)];
+            if (rc > Scalar(0.0))
+                rlist_max[i] = std::max(rlist_max[i], rc + r_buff + shift);
+            }
+        }
+
+    // sort the interacting types by their largest list radius and start a new class when it more than doubles
+    std::vector<unsigned int> order;
+    for (unsigned int i=0; i < ntypes; ++i)
+        {
+        if (rlist_max[i] > Scalar(0.0))
+            order.push_back(i);
+        }
+    std::sort(order.begin(), order.end(),
+              [&rlist_max](unsigned int a, unsigned int b) { return rlist_max[a] < rlist_max[b]; });
+
+    std::vector< std::vector<unsigned int> > classes;
+    Scalar class_min = Scalar(0.0);
+    for (unsigned int idx=0; idx < order.size(); ++idx)
+        {
+        const unsigned int type = order[idx];
+        if (classes.empty() || (m_multi_level && rlist_max[type] > Scalar(2.0)*class_min))
+            {
+            classes.push_back(std::vector<unsigned int>(ntypes, 0));
+            class_min = rlist_max[type];
+            }
+        classes.back()[type] = 1;
+        }
+
+    // a single class bins every particle
+    const unsigned int n_levels = std::max((unsigned int)classes.size(), 1u);
+    const bool filter_types = (n_levels > 1);
+
+    m_cl.resize(n_levels);
+    m_cls.resize(n_levels);
+    m_rstencil.resize(n_levels);
+    for (unsigned int level=1; level < n_levels; ++level)
+        {
+        if (!m_cl[level])
+            {
+            m_cl[level] = createCellList();
+            m_cls[level] = std::shared_ptr<CellListStencil>(new CellListStencil(m_sysdef, m_cl[level]));
+            }
+        }
+
+    for (unsigned int level=0; level < n_levels; ++level)
+        {
+        // stencil radius of each type is its largest list radius with the types of the level
+        std::vector<Scalar>& rstencil = m_rstencil[level];
+        rstencil.assign(ntypes, -1.0);
+        Scalar rmin = Scalar(-1.0);
+        for (unsigned int i=0; i < ntypes; ++i)
+            {
+            for (unsigned int j=0; j < ntypes; ++j)
+                {
+                if (filter_types && !classes[level][j])
+                    continue;
+
+                Scalar rc = r_cut[typpair_idx(i,j)];
+                if (rc <= Scalar(0.0))
+                    continue;
+
+                Scalar rlist = rc + r_buff + shift;
+                rstencil[i] = std::max(rstencil[i], rlist);
+                if (rmin < Scalar(0.0) || rlist < rmin)
+                    rmin = rlist;
+                }
+            }
+
+        m_cl[level]->setTypeFilter(filter_types ? classes[level] : std::vector<unsigned int>());
+        m_cls[level]->setRStencil(rstencil);
+
+        if (m_override_cell_width)
+            m_cl[level]->setNominalWidth(m_cell_width);
+        else if (rmin > Scalar(0.0))
+            m_cl[level]->setNominalWidth(rmin);
+        }
+
+    if (n_levels > 1)
+        {
+        m_exec_conf->msg->notice(4) << "nlist: using " << n_levels << " cell list levels" << std::endl;
+        }
+    }
+
+/*!
+ * \param timestep Current timestep
+ */
+void NeighborListStencilLevels::compute(unsigned int timestep)
+    {
+    for (unsigned int level=0; level < m_cl.size(); ++level)
+        {
+        m_cl[level]->compute(timestep);
+        m_cls[level]->compute(timestep);
+        }
+    }
+
+#ifdef ENABLE_MPI
+/*!
+ * \param comm Communicator
+ *
+ * The cell list of level 0 is owned by the caller and is not changed.
+ */
+void NeighborListStencilLevels::setCommunicator(std::shared_ptr<Communicator> comm)
+    {
+    m_comm = comm;
+    for (unsigned int level=1; level < m_cl.size(); ++level)
+        m_cl[level]->setCommunicator(comm);
+    }
+#endif
+
+/*!
+ * \returns A new cell list with the same settings as the cell list of level 0
+ */
+std::shared_ptr<CellList> NeighborListStencilLevels::createCellList() const
+    {
+    std::shared_ptr<CellList> cl;
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        cl = std::shared_ptr<CellList>(new CellListGPU(m_sysdef));
+    else
+    #endif
+        cl = std::shared_ptr<CellList>(new CellList(m_sysdef));
+
+    cl->setRadius(1);
+    cl->setComputeTDB(true);
+    cl->setFlagIndex();
+    cl->setComputeAdjList(false);
+    cl->setSortCellList(m_cl[0]->getSortCellList());
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        cl->setCommunicator(m_comm);
+    #endif
+
+    return cl;
+    }
@@ -0,0 +1,127 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: mphoward
+
+#include "hoomd/CellList.h"
+#include "hoomd/CellListStencil.h"
+#include "hoomd/Index1D.h"
+
+#include <memory>
+#include <vector>
+
+/*! \file NeighborListStencilLevels.h
+    \brief Declares the NeighborListStencilLevels class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#ifndef __NEIGHBORLISTSTENCILLEVELS_H__
+#define __NEIGHBORLISTSTENCILLEVELS_H__
+
+//! Multi-level cell lists for the stencil neighbor lists
+/*! A single cell list is sized for the smallest cutoff, so in mixtures where only a few type pairs have a large
+    cutoff (e.g., colloid-colloid in a solvent) the large stencils of those types visit many cells full of particles
+    that they interact with over a much shorter distance.
+
+    The particle types are grouped into cutoff classes by the largest list radius that they participate in. Types are
+    sorted by this radius, and a new class is started whenever the radius exceeds the smallest radius in the current
+    class by more than a factor of two. Every class, or level, gets its own cell list that only bins the particles of
+    its types, with a cell width set by the shortest list radius of any pair involving the class. The stencil of type
+    \a i in a level covers the largest list radius of \a i with any type of the level, so each type pair is searched
+    in the level that matches its own cutoff.
+
+    Level 0 uses the cell list and stencil given to the constructor. If all types fall in a single class, level 0 bins
+    all particles and the neighbor list build is the same as with a single cell list.
+
+    \sa NeighborListStencil, NeighborListGPUStencil
+*/
+class PYBIND11_EXPORT NeighborListStencilLevels
+    {
+    public:
+        //! Constructor
+        NeighborListStencilLevels(std::shared_ptr<SystemDefinition> sysdef,
+                                  std::shared_ptr<CellList> cl,
+                                  std::shared_ptr<CellListStencil> cls);
+
+        //! Update the cutoff classes and the cell lists of the levels
+        void update(const Scalar *r_cut,
+                    const Index2D& typpair_idx,
+                    Scalar r_buff,
+                    Scalar shift);
+
+        //! Compute the cell lists and stencils of all levels
+        void compute(unsigned int timestep);
+
+        //! Get the number of levels
+        unsigned int getNumLevels() const
+            {
+            return (unsigned int)m_cl.size();
+            }
+
+        //! Get the cell list of a level
+        std::shared_ptr<CellList> getCellList(unsigned int level) const
+            {
+            return m_cl[level];
+            }
+
+        //! Get the stencil of a level
+        std::shared_ptr<CellListStencil> getStencil(unsigned int level) const
+            {
+            return m_cls[level];
+            }
+
+        //! Get the stencil radius of each type in a level
+        const std::vector<Scalar>& getRStencil(unsigned int level) const
+            {
+            return m_rstencil[level];
+            }
+
+        //! Use multiple levels
+        void setMultiLevel(bool multi_level)
+            {
+            m_multi_level = multi_level;
+            }
+
+        //! Check if multiple levels are used
+        bool getMultiLevel() const
+            {
+            return m_multi_level;
+            }
+
+        //! Set the cell width of all levels, overriding the automatic choice
+        void setCellWidth(Scalar cell_width)
+            {
+            m_override_cell_width = true;
+            m_cell_width = cell_width;
+            }
+
+        #ifdef ENABLE_MPI
+        //! Set the communicator of the cell lists created for the levels
+        void setCommunicator(std::shared_ptr<Communicator> comm);
+        #endif
+
+    private:
+        std::shared_ptr<SystemDefinition> m_sysdef;                 //!< System definition
+        std::shared_ptr<ParticleData> m_pdata;                      //!< Particle data
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf;  //!< Execution configuration
+        #ifdef ENABLE_MPI
+        std::shared_ptr<Communicator> m_comm;                       //!< Communicator
+        #endif
+
+        std::vector< std::shared_ptr<CellList> > m_cl;          //!< Cell list of each level
+        std::vector< std::shared_ptr<CellListStencil> > m_cls;  //!< Stencil of each level
+        std::vector< std::vector<Scalar> > m_rstencil;          //!< Stencil radius per type in each level
+
+        bool m_multi_level;             //!< Flag to use multiple levels
+        bool m_override_cell_width;     //!< Flag to override the cell width
+        Scalar m_cell_width;            //!< Cell width if overridden
+
+        //! Create the cell list of a new level, configured like level 0
+        std::shared_ptr<CellList> createCellList() const;
+    };
+
+#endif // __NEIGHBORLISTSTENCILLEVELS_H__
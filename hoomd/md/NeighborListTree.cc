@@ -17,6 +17,13 @@ namespace py = pybind11;
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
+#include <atomic>
+#include <climits>
+
 using namespace std;
 using namespace hpmc::detail;
 
@@ -213,6 +220,10 @@ void NeighborListTree::updateImageVectors()
 
 /*!
  * \note AABBTree implements its own build routine, so this is a wrapper to call this for multiple tree types.
+ *
+ * In builds with ENABLE_TBB, the AABBs are constructed in parallel and the trees of all types are built
+ * concurrently. Each tree also splits its own large nodes in parallel, which keeps all threads busy when one type
+ * (e.g. the solvent of a colloid mixture) holds most of the particles.
  */
 void NeighborListTree::buildTree()
     {
@@ -234,8 +245,15 @@ void NeighborListTree::buildTree()
         ghost_width.z = ghost_layer_width;
         }
 
+    // lowest index of a particle out of bounds, reported after the loop
+    std::atomic<unsigned int> out_of_bounds(UINT_MAX);
+
     // construct a point AABB for each particle owned by this rank, and push it into the right spot in the AABB list
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, m_pdata->getN()+m_pdata->getNGhosts(), [&] (unsigned int i)
+    #else
     for (unsigned int i=0; i < m_pdata->getN()+m_pdata->getNGhosts(); ++i)
+    #endif
         {
         // make a point particle AABB
         vec3<Scalar> my_pos(h_postype.data[i]);
@@ -250,27 +268,46 @@ void NeighborListTree::buildTree()
             (f.y < Scalar(-0.00001) || f.y >= Scalar(1.00001)) ||
             (f.z < Scalar(-0.00001) || f.z >= Scalar(1.00001))) && i < m_pdata->getN())
             {
-            ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
-            m_exec_conf->msg->error() << "nlist.tree(): Particle " << h_tag.data[i] << " is out of bounds "
-                                      << "(x: " << my_pos.x << ", y: " << my_pos.y << ", z: " << my_pos.z
-                                      << ", fx: "<< f.x <<", fy: "<<f.y<<", fz:"<<f.z<<")"<<endl;
-            throw runtime_error("Error updating neighborlist");
-            return;
+            unsigned int cur = out_of_bounds.load();
+            while (i < cur && !out_of_bounds.compare_exchange_weak(cur, i));
             }
 
         unsigned int my_type = __scalar_as_int(h_postype.data[i].w);
         unsigned int my_aabb_idx = m_type_head[my_type] + m_map_pid_tree[i];
         h_aabbs.data[my_aabb_idx] = AABB(my_pos,i);
         }
+    #ifdef ENABLE_TBB
+        );
+    #endif
+
+    if (out_of_bounds.load() != UINT_MAX)
+        {
+        unsigned int i = out_of_bounds.load();
+        vec3<Scalar> my_pos(h_postype.data[i]);
+        Scalar3 f = box.makeFraction(vec_to_scalar3(my_pos),ghost_width);
+
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+        m_exec_conf->msg->error() << "nlist.tree(): Particle " << h_tag.data[i] << " is out of bounds "
+                                  << "(x: " << my_pos.x << ", y: " << my_pos.y << ", z: " << my_pos.z
+                                  << ", fx: "<< f.x <<", fy: "<<f.y<<", fz:"<<f.z<<")"<<endl;
+        throw runtime_error("Error updating neighborlist");
+        }
 
     // call the tree build routine, one tree per type
+    #ifdef ENABLE_TBB
+    tbb::parallel_for((unsigned int)0, m_pdata->getNTypes(), [&] (unsigned int i)
+    #else
     for (unsigned int i=0; i < m_pdata->getNTypes(); ++i)
+    #endif
         {
         if (m_num_per_type[i] > 0)
             {
             m_aabb_trees[i].buildTree(&(h_aabbs.data[0]) + m_type_head[i], m_num_per_type[i]);
             }
         }
+    #ifdef ENABLE_TBB
+        );
+    #endif
     if (this->m_prof) this->m_prof->pop();
     }
 
@@ -279,6 +316,9 @@ void NeighborListTree::buildTree()
  * The stackless traversal is a variation on left descent, where each node knows how far ahead to advance in the list
  * of nodes if there is no intersection between the current node AABB and the query AABB. Otherwise, the search advances
  * by one to the next node in the list.
+ *
+ * In builds with ENABLE_TBB, the particles are distributed over the threads. Every particle writes only its own
+ * range of the neighbor list given by the head list, so only the overflow conditions are collected per thread.
  */
 void NeighborListTree::traverseTree()
     {
@@ -288,28 +328,48 @@ void NeighborListTree::traverseTree()
     ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_body(m_pdata->getBodies(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+    // exclusions within the tag window are checked inline
+    ArrayHandle<unsigned int> h_ex_mask(m_ex_mask_idx, access_location::host, access_mode::read);
+    const unsigned int *ex_mask = useExclusionMask() ? h_ex_mask.data : NULL;
 
     ArrayHandle<Scalar> h_r_cut(m_r_cut, access_location::host, access_mode::read);
 
     // neighborlist data
     ArrayHandle<unsigned int> h_head_list(m_head_list, access_location::host, access_mode::read);
-    ArrayHandle<unsigned int> h_Nmax(m_Nmax, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_conditions(m_conditions, access_location::host, access_mode::readwrite);
     ArrayHandle<unsigned int> h_nlist(m_nlist, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_n_neigh(m_n_neigh, access_location::host, access_mode::overwrite);
 
     // Loop over all particles
+    #ifdef ENABLE_TBB
+    // overflow conditions are collected per thread and merged after the loop
+    tbb::enumerable_thread_specific< std::vector<unsigned int> >
+        conditions_thread(std::vector<unsigned int>(m_pdata->getNTypes(), 0));
+
+    tbb::parallel_for((unsigned int)0, m_pdata->getN(), [&] (unsigned int i)
+    #else
+    unsigned int *conditions = h_conditions.data;
+
     for (unsigned int i=0; i < m_pdata->getN(); ++i)
+    #endif
         {
+        #ifdef ENABLE_TBB
+        unsigned int *conditions = &conditions_thread.local().front();
+        #endif
+
         // read in the current position and orientation
         const Scalar4 postype_i = h_postype.data[i];
         const vec3<Scalar> pos_i = vec3<Scalar>(postype_i);
         const unsigned int type_i = __scalar_as_int(postype_i.w);
         const unsigned int body_i = h_body.data[i];
         const Scalar diam_i = h_diameter.data[i];
+        const unsigned int ex_mask_i = ex_mask ? ex_mask[i] : 0;
+        const unsigned int tag_i = ex_mask_i ? h_tag.data[i] : 0;
 
-        const unsigned int Nmax_i = h_Nmax.data[type_i];
         const unsigned int nlist_head_i = h_head_list.data[i];
+        const unsigned int Nmax_i = h_head_list.data[i+1] - nlist_head_i;
 
         unsigned int n_neigh_i = 0;
         for (unsigned int cur_pair_type=0; cur_pair_type < m_pdata->getNTypes(); ++cur_pair_type) // loop on pair types
@@ -345,7 +405,7 @@ void NeighborListTree::traverseTree()
                 // stackless traversal of the tree
                 for (unsigned int cur_node_idx = 0; cur_node_idx < cur_aabb_tree->getNumNodes(); ++cur_node_idx)
                     {
-                    if (overlap(cur_aabb_tree->getNodeAABB(cur_node_idx), aabb))
+                    if (cur_aabb_tree->overlapNode(cur_node_idx, aabb))
                         {
                         if (cur_aabb_tree->isNodeLeaf(cur_node_idx))
                             {
@@ -360,6 +420,9 @@ void NeighborListTree::traverseTree()
                                 if (m_filter_body && body_i != NO_BODY)
                                     excluded = excluded | (body_i == h_body.data[j]);
 
+                                if (ex_mask_i && !excluded)
+                                    excluded = isExcludedByMask(ex_mask_i, tag_i, h_tag.data[j]);
+
                                 if (!excluded)
                                     {
                                     // now we can trim down the actual particles based on diameter
@@ -386,7 +449,7 @@ void NeighborListTree::traverseTree()
                                             if (n_neigh_i < Nmax_i)
                                                 h_nlist.data[nlist_head_i + n_neigh_i] = j;
                                             else
-                                                h_conditions.data[type_i] = max(h_conditions.data[type_i], n_neigh_i+1);
+                                                conditions[type_i] = max(conditions[type_i], n_neigh_i+1);
 
                                             ++n_neigh_i;
                                             }
@@ -405,6 +468,14 @@ void NeighborListTree::traverseTree()
             } // end loop over pair types
             h_n_neigh.data[i] = n_neigh_i;
         } // end loop over particles
+    #ifdef ENABLE_TBB
+        );
+
+    // merge the per-thread overflow conditions
+    for (auto it = conditions_thread.begin(); it != conditions_thread.end(); ++it)
+        for (unsigned int type = 0; type < m_pdata->getNTypes(); ++type)
+            h_conditions.data[type] = max(h_conditions.data[type], (*it)[type]);
+    #endif
 
     if (this->m_prof) this->m_prof->pop();
     }
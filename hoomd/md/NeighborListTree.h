@@ -35,6 +35,8 @@
  * Any class directly modifying the types of particles \b must signal this change to NeighborListTree using
  * notifyParticleSort().
  *
+ * In builds with ENABLE_TBB, the trees are built and traversed in parallel.
+ *
  * \ingroup computes
  */
 class PYBIND11_EXPORT NeighborListTree : public NeighborList
@@ -52,6 +54,12 @@ class PYBIND11_EXPORT NeighborListTree : public NeighborList
         //! Builds the neighbor list
         virtual void buildNlist(unsigned int timestep);
 
+        //! The build checks the exclusion masks inline
+        virtual bool supportsExclusionMask()
+            {
+            return true;
+            }
+
     private:
         //! Notification of a box size change
         void slotBoxChanged()
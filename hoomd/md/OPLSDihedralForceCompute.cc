@@ -40,7 +40,7 @@ OPLSDihedralForceCompute::OPLSDihedralForceCompute(std::shared_ptr<SystemDefinit
         }
 
     // allocate the parameters
-    GPUArray<Scalar4> params(m_dihedral_data->getNTypes(), m_exec_conf);
+    GlobalArray<Scalar4> params(m_dihedral_data->getNTypes(), m_exec_conf);
     m_params.swap(params);
 }
 
@@ -61,7 +61,7 @@ class PYBIND11_EXPORT OPLSDihedralForceCompute : public ForceCompute
         #endif
 
     protected:
-        GPUArray<Scalar4> m_params;
+        GlobalArray<Scalar4> m_params;
 
         //!< Dihedral data to use in computing dihedrals
         std::shared_ptr<DihedralData> m_dihedral_data;
@@ -28,6 +28,17 @@ OPLSDihedralForceComputeGPU::OPLSDihedralForceComputeGPU(std::shared_ptr<SystemD
         throw std::runtime_error("Error initializing OPLSDihedralForceComputeGPU");
         }
 
+    if (m_exec_conf->allConcurrentManagedAccess())
+        {
+        // the parameters are read by every GPU
+        auto& gpu_map = m_exec_conf->getGPUIds();
+
+        cudaMemAdvise(m_params.get(), m_params.getNumElements()*sizeof(Scalar4), cudaMemAdviseSetReadMostly, 0);
+        for (unsigned int idev = 0; idev < m_exec_conf->getNumActiveGPUs(); ++idev)
+            cudaMemPrefetchAsync(m_params.get(), m_params.getNumElements()*sizeof(Scalar4), gpu_map[idev]);
+        CHECK_CUDA_ERROR();
+        }
+
     m_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "opls_dihedral", this->m_exec_conf));
     }
 
@@ -56,6 +67,7 @@ void OPLSDihedralForceComputeGPU::computeForces(unsigned int timestep)
     ArrayHandle<Scalar4> d_params(m_params, access_location::device, access_mode::read);
 
     // run the kernel in parallel on all GPUs
+    m_exec_conf->beginMultiGPU();
     this->m_tuner->begin();
     gpu_compute_opls_dihedral_forces(d_force.data,
                                          d_virial.data,
@@ -70,10 +82,12 @@ void OPLSDihedralForceComputeGPU::computeForces(unsigned int timestep)
                                          d_params.data,
                                          m_dihedral_data->getNTypes(),
                                          this->m_tuner->getParam(),
-                                         m_exec_conf->getComputeCapability());
+                                         m_exec_conf->getComputeCapability(),
+                                         m_pdata->getGPUPartition());
     if(m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
     this->m_tuner->end();
+    m_exec_conf->endMultiGPU();
 
     if (m_prof) m_prof->pop(m_exec_conf);
     }
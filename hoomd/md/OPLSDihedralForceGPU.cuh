@@ -6,6 +6,7 @@
 
 #include "hoomd/ParticleData.cuh"
 #include "hoomd/HOOMDMath.h"
+#include "hoomd/GPUPartition.cuh"
 #include "hoomd/BondedGroupData.cuh"
 
 /*! \file OPLSDihedralForceGPU.cuh
@@ -29,6 +30,7 @@ cudaError_t gpu_compute_opls_dihedral_forces(Scalar4* d_force,
                                                 const Scalar4 *d_params,
                                                 const unsigned int n_dihedral_types,
                                                 const int block_size,
-                                                const unsigned int compute_capability);
+                                                const unsigned int compute_capability,
+                                                const GPUPartition& gpu_partition);
 
 #endif
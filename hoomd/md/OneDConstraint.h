@@ -42,6 +42,18 @@ class PYBIND11_EXPORT OneDConstraint : public ForceConstraint
         //! Return the number of DOF removed by this constraint
         virtual unsigned int getNDOFRemoved();
 
+        //! Get the group of particles on which the constraint is applied
+        std::shared_ptr<ParticleGroup> getGroup() const
+            {
+            return m_group;
+            }
+
+        //! Get the vector along which particles are constrained
+        Scalar3 getVector() const
+            {
+            return m_vec;
+            }
+
     protected:
         std::shared_ptr<ParticleGroup> m_group;   //!< Group of particles on which this constraint is applied
         Scalar3 m_vec;  //!< The vector along which particles are constrained
@@ -0,0 +1,891 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "PPPMDipoleForceCompute.h"
+#include "EvaluatorPairDipoleEwald.h"
+#include "hoomd/VectorMath.h"
+
+namespace py = pybind11;
+
+/*! \file PPPMDipoleForceCompute.cc
+    \brief Defines the PPPMDipoleForceCompute class
+*/
+
+//! sin(x)/x
+inline Scalar dipole_sinc(Scalar x)
+    {
+    return (fabs(x) < Scalar(1e-8)) ? Scalar(1.0) : sin(x)/x;
+    }
+
+/*! \param sysdef The system definition
+    \param nlist Neighbor list, provides the exclusions
+    \param group The particles that carry dipoles
+ */
+PPPMDipoleForceCompute::PPPMDipoleForceCompute(std::shared_ptr<SystemDefinition> sysdef,
+    std::shared_ptr<NeighborList> nlist,
+    std::shared_ptr<ParticleGroup> group)
+    : PPPMForceCompute(sysdef, nlist, group), m_mu2(0.0)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing PPPMDipoleForceCompute" << std::endl;
+
+    m_moment.resize(m_pdata->getNTypes(), Scalar(0.0));
+
+    m_log_names.clear();
+    m_log_names.push_back("pppm_dipole_energy");
+    }
+
+PPPMDipoleForceCompute::~PPPMDipoleForceCompute()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying PPPMDipoleForceCompute" << std::endl;
+    }
+
+void PPPMDipoleForceCompute::setParams(unsigned int nx, unsigned int ny, unsigned int nz,
+    unsigned int order, Scalar kappa, Scalar rcut, Scalar alpha)
+    {
+    if (alpha != Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "charge.pppm_dipole: screened interactions are not supported" << std::endl;
+        throw std::runtime_error("Error initializing PPPMDipoleForceCompute.");
+        }
+
+    PPPMForceCompute::setParams(nx, ny, nz, order, kappa, rcut, alpha);
+    }
+
+/*! \param type Particle type
+    \param mu Magnitude of the dipole moment along the body frame x axis
+*/
+void PPPMDipoleForceCompute::setMoment(unsigned int type, Scalar mu)
+    {
+    if (type >= m_pdata->getNTypes())
+        {
+        m_exec_conf->msg->error() << "charge.pppm_dipole: Trying to set the moment of a non-existent type! "
+                                  << type << std::endl;
+        throw std::runtime_error("Error setting parameters in PPPMDipoleForceCompute");
+        }
+
+    m_moment[type] = mu;
+    m_need_initialize = true;
+    }
+
+Scalar PPPMDipoleForceCompute::getMu2Sum()
+    {
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    unsigned int group_size = m_group->getNumMembers();
+    Scalar mu2(0.0);
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int j = m_group->getMemberIndex(group_idx);
+        Scalar mu = m_moment[__scalar_as_int(h_postype.data[j].w)];
+
+        mu2 += mu*mu;
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        // reduce sum
+        MPI_Allreduce(MPI_IN_PLACE,
+                      &mu2,
+                      1,
+                      MPI_HOOMD_SCALAR,
+                      MPI_SUM,
+                      m_exec_conf->getMPICommunicator());
+        }
+    #endif
+    return mu2;
+    }
+
+void PPPMDipoleForceCompute::setupCoeffs()
+    {
+    m_mu2 = getMu2Sum();
+
+    // initialize coefficients for the dipole assignment
+    compute_rho_coeff();
+
+    // initialize coefficients for Green's function
+    compute_gf_denom();
+    }
+
+void PPPMDipoleForceCompute::computeBodyCorrection()
+    {
+    m_exec_conf->msg->error() << "charge.pppm_dipole: rigid body exclusions are not supported" << std::endl;
+    throw std::runtime_error("Error computing PPPMDipoleForceCompute");
+    }
+
+void PPPMDipoleForceCompute::initializeFFT()
+    {
+    PPPMForceCompute::initializeFFT();
+
+    // the x component uses the meshes of the base class, pad the real space meshes with the offset
+    GPUArray<kiss_fft_cpx> mesh_y(m_n_cells + m_ghost_offset, m_exec_conf);
+    m_mesh_y.swap(mesh_y);
+
+    GPUArray<kiss_fft_cpx> mesh_z(m_n_cells + m_ghost_offset, m_exec_conf);
+    m_mesh_z.swap(mesh_z);
+
+    GPUArray<kiss_fft_cpx> fourier_mesh_y(m_n_inner_cells, m_exec_conf);
+    m_fourier_mesh_y.swap(fourier_mesh_y);
+
+    GPUArray<kiss_fft_cpx> fourier_mesh_z(m_n_inner_cells, m_exec_conf);
+    m_fourier_mesh_z.swap(fourier_mesh_z);
+
+    GPUArray<kiss_fft_cpx> fourier_mesh_G_xxyy(m_n_inner_cells, m_exec_conf);
+    m_fourier_mesh_G_xxyy.swap(fourier_mesh_G_xxyy);
+
+    GPUArray<kiss_fft_cpx> fourier_mesh_G_zzxy(m_n_inner_cells, m_exec_conf);
+    m_fourier_mesh_G_zzxy.swap(fourier_mesh_G_zzxy);
+
+    GPUArray<kiss_fft_cpx> fourier_mesh_G_xzyz(m_n_inner_cells, m_exec_conf);
+    m_fourier_mesh_G_xzyz.swap(fourier_mesh_G_xzyz);
+
+    GPUArray<kiss_fft_cpx> inv_fourier_mesh_xxyy(m_n_cells + m_ghost_offset, m_exec_conf);
+    m_inv_fourier_mesh_xxyy.swap(inv_fourier_mesh_xxyy);
+
+    GPUArray<kiss_fft_cpx> inv_fourier_mesh_zzxy(m_n_cells + m_ghost_offset, m_exec_conf);
+    m_inv_fourier_mesh_zzxy.swap(inv_fourier_mesh_zzxy);
+
+    GPUArray<kiss_fft_cpx> inv_fourier_mesh_xzyz(m_n_cells + m_ghost_offset, m_exec_conf);
+    m_inv_fourier_mesh_xzyz.swap(inv_fourier_mesh_xzyz);
+    }
+
+/*! The aliasing sums of the charge influence function are kept, the projections of the aliased wave vectors onto the
+    wave vector enter with the third power and the denominator with |k|^6.
+*/
+void PPPMDipoleForceCompute::computeInfluenceFunction()
+    {
+    if (m_prof) m_prof->push("influence function");
+
+    ArrayHandle<Scalar> h_inf_f(m_inf_f,access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar3> h_k(m_k,access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar3> h_k_force(m_k_force,access_location::host, access_mode::overwrite);
+
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+
+    // compute reciprocal lattice vectors
+    Scalar3 a1 = global_box.getLatticeVector(0);
+    Scalar3 a2 = global_box.getLatticeVector(1);
+    Scalar3 a3 = global_box.getLatticeVector(2);
+
+    Scalar V_box = global_box.getVolume();
+    Scalar3 b1 = Scalar(2.0*M_PI)*make_scalar3(a2.y*a3.z-a2.z*a3.y, a2.z*a3.x-a2.x*a3.z, a2.x*a3.y-a2.y*a3.x)/V_box;
+    Scalar3 b2 = Scalar(2.0*M_PI)*make_scalar3(a3.y*a1.z-a3.z*a1.y, a3.z*a1.x-a3.x*a1.z, a3.x*a1.y-a3.y*a1.x)/V_box;
+    Scalar3 b3 = Scalar(2.0*M_PI)*make_scalar3(a1.y*a2.z-a1.z*a2.y, a1.z*a2.x-a1.x*a2.z, a1.x*a2.y-a1.y*a2.x)/V_box;
+
+    #ifdef ENABLE_MPI
+    bool local_fft = bool(m_local_fft);
+
+    uint3 pdim=make_uint3(0,0,0);
+    uint3 pidx=make_uint3(0,0,0);
+    if (m_pdata->getDomainDecomposition())
+        {
+        const Index3D &didx = m_pdata->getDomainDecomposition()->getDomainIndexer();
+        pidx = m_pdata->getDomainDecomposition()->getGridPos();
+        pdim = make_uint3(didx.getW(), didx.getH(), didx.getD());
+        }
+    #endif
+
+    Scalar3 kH = Scalar(2.0*M_PI)*make_scalar3(Scalar(1.0)/(Scalar)m_global_dim.x,
+                                               Scalar(1.0)/(Scalar)m_global_dim.y,
+                                               Scalar(1.0)/(Scalar)m_global_dim.z);
+
+    // number of aliases, as for charges
+    Scalar3 L = global_box.getL();
+    int nbx = (int)floor((m_kappa*L.x/(M_PI*m_global_dim.x)) * pow(-log(EPS_HOC),0.25));
+    int nby = (int)floor((m_kappa*L.y/(M_PI*m_global_dim.y)) * pow(-log(EPS_HOC),0.25));
+    int nbz = (int)floor((m_kappa*L.z/(M_PI*m_global_dim.z)) * pow(-log(EPS_HOC),0.25));
+
+    for (unsigned int cell_idx = 0; cell_idx < m_n_inner_cells; ++cell_idx)
+        {
+        uint3 wave_idx;
+        #ifdef ENABLE_MPI
+        if (! local_fft)
+           {
+           // local layout: row major
+           int ny = m_mesh_points.y;
+           int nx = m_mesh_points.x;
+           int n_local = cell_idx/ny/nx;
+           int m_local = (cell_idx-n_local*ny*nx)/nx;
+           int l_local = cell_idx % nx;
+           // cyclic distribution
+           wave_idx.x = l_local*pdim.x + pidx.x;
+           wave_idx.y = m_local*pdim.y + pidx.y;
+           wave_idx.z = n_local*pdim.z + pidx.z;
+           }
+        else
+        #endif
+            {
+            // kiss FFT expects data in row major format
+            wave_idx.z = cell_idx / (m_mesh_points.y * m_mesh_points.x);
+            wave_idx.y = (cell_idx - wave_idx.z * m_mesh_points.x * m_mesh_points.y)/ m_mesh_points.x;
+            wave_idx.x = cell_idx % m_mesh_points.x;
+            }
+
+        int3 n = make_int3(wave_idx.x,wave_idx.y,wave_idx.z);
+
+        // compute Miller indices
+        if (n.x >= (int)(m_global_dim.x/2 + m_global_dim.x%2))
+            n.x -= (int) m_global_dim.x;
+        if (n.y >= (int)(m_global_dim.y/2 + m_global_dim.y%2))
+            n.y -= (int) m_global_dim.y;
+        if (n.z >= (int)(m_global_dim.z/2 + m_global_dim.z%2))
+            n.z -= (int) m_global_dim.z;
+
+        Scalar3 k = (Scalar)n.x*b1+(Scalar)n.y*b2+(Scalar)n.z*b3;
+
+        Scalar snx = fast::sin(0.5*kH.x*(Scalar)n.x);
+        Scalar sny = fast::sin(0.5*kH.y*(Scalar)n.y);
+        Scalar snz = fast::sin(0.5*kH.z*(Scalar)n.z);
+
+        h_inf_f.data[cell_idx] = Scalar(0.0);
+        if (n.x != 0 || n.y != 0 || n.z != 0)
+            {
+            Scalar sum1(0.0);
+            Scalar ksq = dot(k,k);
+            Scalar numerator = Scalar(4.0*M_PI)/(ksq*ksq*ksq);
+            Scalar denominator = gf_denom(snx*snx, sny*sny, snz*snz);
+
+            for (int ix = -nbx; ix <= nbx; ix++)
+                {
+                Scalar qx = ((Scalar)n.x + (Scalar)ix*m_global_dim.x);
+                Scalar wx = pow(dipole_sinc(Scalar(0.5)*qx*kH.x), m_order);
+
+                for (int iy = -nby; iy <= nby; iy++)
+                    {
+                    Scalar qy = ((Scalar)n.y + (Scalar)iy*m_global_dim.y);
+                    Scalar wy = pow(dipole_sinc(Scalar(0.5)*qy*kH.y), m_order);
+
+                    for (int iz = -nbz; iz <= nbz; iz++)
+                        {
+                        Scalar qz = ((Scalar)n.z + (Scalar)iz*m_global_dim.z);
+                        Scalar wz = pow(dipole_sinc(Scalar(0.5)*qz*kH.z), m_order);
+
+                        Scalar3 kn = qx*b1 + qy*b2 + qz*b3;
+                        Scalar dot1 = dot(kn, k);
+                        Scalar dot2 = dot(kn, kn);
+
+                        Scalar gauss = exp(-Scalar(0.25)*dot2/m_kappa/m_kappa);
+
+                        sum1 += (dot1*dot1*dot1/dot2) * gauss * wx * wx * wy * wy * wz * wz;
+                        }
+                    }
+                }
+            h_inf_f.data[cell_idx] = numerator*sum1/denominator;
+            }
+
+        h_k.data[cell_idx] = k;
+
+        // the field components are packed pairwise into complex transforms, leave out the unpaired Nyquist modes
+        bool nyquist = (m_global_dim.x % 2 == 0 && n.x == -(int)(m_global_dim.x/2))
+            || (m_global_dim.y % 2 == 0 && n.y == -(int)(m_global_dim.y/2))
+            || (m_global_dim.z % 2 == 0 && n.z == -(int)(m_global_dim.z/2));
+        h_k_force.data[cell_idx] = nyquist ? make_scalar3(0.0,0.0,0.0) : k;
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param box Local box
+    \param pos Particle position
+    \param cell Output, mesh cell of the particle (including the ghost cells)
+    \param d Output, argument of the assignment polynomials
+    \returns false if the particle is outside of the mesh
+*/
+bool PPPMDipoleForceCompute::findCell(const BoxDim& box, const Scalar3& pos, int3& cell, Scalar3& d)
+    {
+    // compute coordinates in units of the mesh size
+    Scalar3 f = box.makeFraction(pos);
+    Scalar3 reduced_pos = make_scalar3(f.x * (Scalar) m_mesh_points.x + (Scalar) m_n_ghost_cells.x,
+                                       f.y * (Scalar) m_mesh_points.y + (Scalar) m_n_ghost_cells.y,
+                                       f.z * (Scalar) m_mesh_points.z + (Scalar) m_n_ghost_cells.z);
+
+    Scalar shift = (m_order % 2) ? Scalar(0.5) : Scalar(0.0);
+    Scalar shiftone = (m_order % 2) ? Scalar(0.0) : Scalar(0.5);
+
+    cell.x = (reduced_pos.x + shift);
+    cell.y = (reduced_pos.y + shift);
+    cell.z = (reduced_pos.z + shift);
+
+    d.x = shiftone+(Scalar)cell.x-reduced_pos.x;
+    d.y = shiftone+(Scalar)cell.y-reduced_pos.y;
+    d.z = shiftone+(Scalar)cell.z-reduced_pos.z;
+
+    // handle particles on the boundary
+    if (cell.x == (int) m_grid_dim.x && !m_n_ghost_cells.x)
+        cell.x = 0;
+    if (cell.y == (int) m_grid_dim.y && !m_n_ghost_cells.y)
+        cell.y = 0;
+    if (cell.z == (int) m_grid_dim.z && !m_n_ghost_cells.z)
+        cell.z = 0;
+
+    // ignore outside particles, error will be thrown elsewhere (in CellList)
+    return !(cell.x < 0 || cell.x >= (int)m_grid_dim.x ||
+             cell.y < 0 || cell.y >= (int)m_grid_dim.y ||
+             cell.z < 0 || cell.z >= (int)m_grid_dim.z);
+    }
+
+//! Wrap a mesh index along a direction without ghost cells
+inline int wrap_mesh_index(int i, unsigned int dim, unsigned int n_ghost)
+    {
+    if (! n_ghost)
+        {
+        if (i >= (int)dim)
+            i -= dim;
+        else if (i < 0)
+            i += dim;
+        }
+    return i;
+    }
+
+void PPPMDipoleForceCompute::assignParticles()
+    {
+    if (m_prof) m_prof->push("assign");
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_cpx> h_mesh_x(m_mesh, access_location::host, access_mode::overwrite);
+    ArrayHandle<kiss_fft_cpx> h_mesh_y(m_mesh_y, access_location::host, access_mode::overwrite);
+    ArrayHandle<kiss_fft_cpx> h_mesh_z(m_mesh_z, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar> h_rho_coeff(m_rho_coeff,access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+
+    // set meshes to zero
+    memset(h_mesh_x.data, 0, sizeof(kiss_fft_cpx)*m_mesh.getNumElements());
+    memset(h_mesh_y.data, 0, sizeof(kiss_fft_cpx)*m_mesh_y.getNumElements());
+    memset(h_mesh_z.data, 0, sizeof(kiss_fft_cpx)*m_mesh_z.getNumElements());
+
+    Scalar V_cell = box.getVolume()/(Scalar)(m_mesh_points.x*m_mesh_points.y*m_mesh_points.z);
+
+    int mult_fact = 2*m_order+1;
+    int nlower = -(m_order-1)/2;
+    int nupper = m_order/2;
+
+    // loop over group
+    unsigned int group_size = m_group->getNumMembers();
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int idx = m_group->getMemberIndex(group_idx);
+
+        Scalar4 postype = h_postype.data[idx];
+        Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+
+        // ignore if NaN
+        if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z))
+            continue;
+
+        Scalar mu = m_moment[__scalar_as_int(postype.w)];
+        if (mu == Scalar(0.0))
+            continue;
+
+        vec3<Scalar> p = mu*rotate(quat<Scalar>(h_orientation.data[idx]), vec3<Scalar>(1,0,0))/V_cell;
+
+        int3 cell;
+        Scalar3 d;
+        if (! findCell(box, pos, cell, d))
+            continue;
+
+        for (int i = nlower; i <= nupper ; ++i)
+            {
+            Scalar Wx = Scalar(0.0);
+            for (int iorder = m_order-1; iorder >= 0; iorder--)
+                Wx = h_rho_coeff.data[i - nlower + iorder*mult_fact] + Wx * d.x;
+
+            int neighi = wrap_mesh_index(cell.x + i, m_grid_dim.x, m_n_ghost_cells.x);
+
+            for (int j = nlower; j <= nupper; ++j)
+                {
+                Scalar Wy = Scalar(0.0);
+                for (int iorder = m_order-1; iorder >= 0; iorder--)
+                    Wy = h_rho_coeff.data[j - nlower + iorder*mult_fact] + Wy * d.y;
+
+                int neighj = wrap_mesh_index(cell.y + j, m_grid_dim.y, m_n_ghost_cells.y);
+
+                for (int k = nlower; k <= nupper; ++k)
+                    {
+                    Scalar Wz = Scalar(0.0);
+                    for (int iorder = m_order-1; iorder >= 0; iorder--)
+                        Wz = h_rho_coeff.data[k - nlower + iorder*mult_fact] + Wz * d.z;
+
+                    int neighk = wrap_mesh_index(cell.z + k, m_grid_dim.z, m_n_ghost_cells.z);
+
+                    Scalar W = Wx*Wy*Wz;
+
+                    // store in row major order
+                    unsigned int neigh_idx = neighi + m_grid_dim.x * (neighj + m_grid_dim.y*neighk);
+
+                    h_mesh_x.data[neigh_idx].r += p.x*W;
+                    h_mesh_y.data[neigh_idx].r += p.y*W;
+                    h_mesh_z.data[neigh_idx].r += p.z*W;
+                    }
+                }
+            }
+        } // end loop over particles
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! \param mesh Real space mesh, its ghost cells are added to the neighboring domains
+    \param fourier_mesh Output, the transformed mesh
+*/
+void PPPMDipoleForceCompute::forwardFFT(GPUArray<kiss_fft_cpx>& mesh, GPUArray<kiss_fft_cpx>& fourier_mesh)
+    {
+    if (m_local_fft)
+        {
+        ArrayHandle<kiss_fft_cpx> h_mesh(mesh, access_location::host, access_mode::read);
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh(fourier_mesh, access_location::host, access_mode::overwrite);
+        m_local_fft->forward(h_mesh.data, h_fourier_mesh.data);
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        // update inner cells of the dipole mesh
+        m_grid_comm_forward->communicate(mesh);
+
+        ArrayHandle<kiss_fft_cpx> h_mesh(mesh, access_location::host, access_mode::read);
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh(fourier_mesh, access_location::host, access_mode::overwrite);
+        dfft_execute((cpx_t *)(h_mesh.data+m_ghost_offset), (cpx_t *)h_fourier_mesh.data, 0, m_dfft_plan_forward);
+        }
+    #endif
+    }
+
+/*! \param fourier_mesh k space mesh
+    \param inv_mesh Output, the real space mesh including ghost cells
+*/
+void PPPMDipoleForceCompute::inverseFFT(GPUArray<kiss_fft_cpx>& fourier_mesh, GPUArray<kiss_fft_cpx>& inv_mesh)
+    {
+    if (m_local_fft)
+        {
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh(fourier_mesh, access_location::host, access_mode::read);
+        ArrayHandle<kiss_fft_cpx> h_inv_mesh(inv_mesh, access_location::host, access_mode::overwrite);
+        m_local_fft->inverse(h_fourier_mesh.data, h_inv_mesh.data);
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+            {
+            ArrayHandle<kiss_fft_cpx> h_fourier_mesh(fourier_mesh, access_location::host, access_mode::read);
+            ArrayHandle<kiss_fft_cpx> h_inv_mesh(inv_mesh, access_location::host, access_mode::overwrite);
+            dfft_execute((cpx_t *)h_fourier_mesh.data, (cpx_t *)(h_inv_mesh.data+m_ghost_offset), 1,
+                m_dfft_plan_inverse);
+            }
+
+        // update outer cells using ghost cells from neighboring processors
+        m_grid_comm_reverse->communicate(inv_mesh);
+        }
+    #endif
+    }
+
+/*! With S = k . M(k) the transform of the dipolar charge density (up to a factor -i), the field is
+    E(k) = -k G S and its gradient is dE_b/dr_a (k) = -i k_a k_b G S.
+*/
+void PPPMDipoleForceCompute::updateMeshes()
+    {
+    if (m_prof) m_prof->push("FFT");
+    forwardFFT(m_mesh, m_fourier_mesh);
+    forwardFFT(m_mesh_y, m_fourier_mesh_y);
+    forwardFFT(m_mesh_z, m_fourier_mesh_z);
+    if (m_prof) m_prof->pop();
+
+    if (m_prof) m_prof->push("update");
+
+        {
+        ArrayHandle<Scalar3> h_k_force(m_k_force, access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::read);
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_x(m_fourier_mesh, access_location::host, access_mode::read);
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_y(m_fourier_mesh_y, access_location::host, access_mode::read);
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_z(m_fourier_mesh_z, access_location::host, access_mode::read);
+
+        ArrayHandle<kiss_fft_cpx> h_G_xy(m_fourier_mesh_G_xy, access_location::host, access_mode::overwrite);
+        ArrayHandle<kiss_fft_cpx> h_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::overwrite);
+        ArrayHandle<kiss_fft_cpx> h_G_xxyy(m_fourier_mesh_G_xxyy, access_location::host, access_mode::overwrite);
+        ArrayHandle<kiss_fft_cpx> h_G_zzxy(m_fourier_mesh_G_zzxy, access_location::host, access_mode::overwrite);
+        ArrayHandle<kiss_fft_cpx> h_G_xzyz(m_fourier_mesh_G_xzyz, access_location::host, access_mode::overwrite);
+
+        unsigned int NNN = m_global_dim.x*m_global_dim.y*m_global_dim.z;
+
+        for (unsigned int k = 0; k < m_n_inner_cells; ++k)
+            {
+            Scalar g = h_inf_f.data[k] / ((Scalar)NNN);
+            Scalar3 kvec = h_k_force.data[k];
+
+            kiss_fft_cpx mx = h_fourier_mesh_x.data[k];
+            kiss_fft_cpx my = h_fourier_mesh_y.data[k];
+            kiss_fft_cpx mz = h_fourier_mesh_z.data[k];
+
+            Scalar S_r = kvec.x*mx.r + kvec.y*my.r + kvec.z*mz.r;
+            Scalar S_i = kvec.x*mx.i + kvec.y*my.i + kvec.z*mz.i;
+
+            // E_x + i E_y and E_z
+            h_G_xy.data[k].r = -g*(kvec.x*S_r + kvec.y*S_i);
+            h_G_xy.data[k].i = -g*(kvec.x*S_i - kvec.y*S_r);
+            h_G_z.data[k].r = -g*kvec.z*S_r;
+            h_G_z.data[k].i = -g*kvec.z*S_i;
+
+            // pairs T_ab + i T_cd of the field gradient, T_ab = t_ab (S_i - i S_r)
+            Scalar t_xx = g*kvec.x*kvec.x;
+            Scalar t_yy = g*kvec.y*kvec.y;
+            Scalar t_zz = g*kvec.z*kvec.z;
+            Scalar t_xy = g*kvec.x*kvec.y;
+            Scalar t_xz = g*kvec.x*kvec.z;
+            Scalar t_yz = g*kvec.y*kvec.z;
+
+            h_G_xxyy.data[k].r = t_xx*S_i + t_yy*S_r;
+            h_G_xxyy.data[k].i = -t_xx*S_r + t_yy*S_i;
+            h_G_zzxy.data[k].r = t_zz*S_i + t_xy*S_r;
+            h_G_zzxy.data[k].i = -t_zz*S_r + t_xy*S_i;
+            h_G_xzyz.data[k].r = t_xz*S_i + t_yz*S_r;
+            h_G_xzyz.data[k].i = -t_xz*S_r + t_yz*S_i;
+            }
+        }
+
+    if (m_prof) m_prof->pop();
+
+    if (m_prof) m_prof->push("FFT");
+    inverseFFT(m_fourier_mesh_G_xy, m_inv_fourier_mesh_xy);
+    inverseFFT(m_fourier_mesh_G_z, m_inv_fourier_mesh_z);
+    inverseFFT(m_fourier_mesh_G_xxyy, m_inv_fourier_mesh_xxyy);
+    inverseFFT(m_fourier_mesh_G_zzxy, m_inv_fourier_mesh_zzxy);
+    inverseFFT(m_fourier_mesh_G_xzyz, m_inv_fourier_mesh_xzyz);
+    if (m_prof) m_prof->pop();
+    }
+
+void PPPMDipoleForceCompute::interpolateForces()
+    {
+    if (m_prof) m_prof->push("interpolate");
+
+    ArrayHandle<Scalar4> h_postype(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+
+    ArrayHandle<kiss_fft_cpx> h_E_xy(m_inv_fourier_mesh_xy, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_cpx> h_E_z(m_inv_fourier_mesh_z, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_cpx> h_T_xxyy(m_inv_fourier_mesh_xxyy, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_cpx> h_T_zzxy(m_inv_fourier_mesh_zzxy, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_cpx> h_T_xzyz(m_inv_fourier_mesh_xzyz, access_location::host, access_mode::read);
+
+    ArrayHandle<Scalar4> h_force(m_force, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar4> h_torque(m_torque, access_location::host, access_mode::overwrite);
+
+    // reset forces and torques for ALL particles
+    memset(h_force.data, 0, sizeof(Scalar4)*m_pdata->getN());
+    memset(h_torque.data, 0, sizeof(Scalar4)*m_pdata->getN());
+
+    ArrayHandle<Scalar> h_rho_coeff(m_rho_coeff, access_location::host, access_mode::read);
+
+    const BoxDim& box = m_pdata->getBox();
+
+    int mult_fact = 2*m_order+1;
+    int nlower = -(m_order-1)/2;
+    int nupper = m_order/2;
+
+    // loop over group
+    unsigned int group_size = m_group->getNumMembers();
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int idx = m_group->getMemberIndex(group_idx);
+        Scalar4 postype = h_postype.data[idx];
+        Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+
+        // ignore if NaN
+        if (std::isnan(pos.x) || std::isnan(pos.y) || std::isnan(pos.z))
+            continue;
+
+        Scalar mu = m_moment[__scalar_as_int(postype.w)];
+        if (mu == Scalar(0.0))
+            continue;
+
+        vec3<Scalar> p = mu*rotate(quat<Scalar>(h_orientation.data[idx]), vec3<Scalar>(1,0,0));
+
+        int3 cell;
+        Scalar3 d;
+        if (! findCell(box, pos, cell, d))
+            continue;
+
+        // field and field gradient at the particle
+        vec3<Scalar> E(0,0,0);
+        Scalar T_xx(0.0), T_yy(0.0), T_zz(0.0), T_xy(0.0), T_xz(0.0), T_yz(0.0);
+
+        for (int i = nlower; i <= nupper ; ++i)
+            {
+            Scalar Wx = Scalar(0.0);
+            for (int iorder = m_order-1; iorder >= 0; iorder--)
+                Wx = h_rho_coeff.data[i - nlower + iorder*mult_fact] + Wx * d.x;
+
+            int neighi = wrap_mesh_index(cell.x + i, m_grid_dim.x, m_n_ghost_cells.x);
+
+            for (int j = nlower; j <= nupper; ++j)
+                {
+                Scalar Wy = Scalar(0.0);
+                for (int iorder = m_order-1; iorder >= 0; iorder--)
+                    Wy = h_rho_coeff.data[j - nlower + iorder*mult_fact] + Wy * d.y;
+
+                int neighj = wrap_mesh_index(cell.y + j, m_grid_dim.y, m_n_ghost_cells.y);
+
+                for (int k = nlower; k <= nupper; ++k)
+                    {
+                    Scalar Wz = Scalar(0.0);
+                    for (int iorder = m_order-1; iorder >= 0; iorder--)
+                        Wz = h_rho_coeff.data[k - nlower + iorder*mult_fact] + Wz * d.z;
+
+                    int neighk = wrap_mesh_index(cell.z + k, m_grid_dim.z, m_n_ghost_cells.z);
+
+                    unsigned int neigh_idx = neighi + m_grid_dim.x * (neighj + m_grid_dim.y*neighk);
+
+                    Scalar W = Wx * Wy * Wz;
+                    E.x += W*h_E_xy.data[neigh_idx].r;
+                    E.y += W*h_E_xy.data[neigh_idx].i;
+                    E.z += W*h_E_z.data[neigh_idx].r;
+                    T_xx += W*h_T_xxyy.data[neigh_idx].r;
+                    T_yy += W*h_T_xxyy.data[neigh_idx].i;
+                    T_zz += W*h_T_zzxy.data[neigh_idx].r;
+                    T_xy += W*h_T_zzxy.data[neigh_idx].i;
+                    T_xz += W*h_T_xzyz.data[neigh_idx].r;
+                    T_yz += W*h_T_xzyz.data[neigh_idx].i;
+                    }
+                }
+            }
+
+        // F = grad(mu . E), the field gradient is symmetric
+        Scalar3 force = make_scalar3(p.x*T_xx + p.y*T_xy + p.z*T_xz,
+                                     p.x*T_xy + p.y*T_yy + p.z*T_yz,
+                                     p.x*T_xz + p.y*T_yz + p.z*T_zz);
+        vec3<Scalar> torque = cross(p, E);
+
+        h_force.data[idx] = make_scalar4(force.x, force.y, force.z, 0.0);
+        h_torque.data[idx] = make_scalar4(torque.x, torque.y, torque.z, 0.0);
+        }  // end of loop over particles
+
+    if (m_prof) m_prof->pop();
+    }
+
+Scalar PPPMDipoleForceCompute::computePE()
+    {
+    if (m_prof) m_prof->push("sum");
+
+    ArrayHandle<kiss_fft_cpx> h_fourier_mesh_x(m_fourier_mesh, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_cpx> h_fourier_mesh_y(m_fourier_mesh_y, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_cpx> h_fourier_mesh_z(m_fourier_mesh_z, access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_k_force(m_k_force, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::read);
+
+    // the influence function vanishes for the DC bin
+    Scalar sum(0.0);
+    for (unsigned int k = 0; k < m_n_inner_cells; ++k)
+        {
+        Scalar3 kvec = h_k_force.data[k];
+        Scalar S_r = kvec.x*h_fourier_mesh_x.data[k].r + kvec.y*h_fourier_mesh_y.data[k].r
+            + kvec.z*h_fourier_mesh_z.data[k].r;
+        Scalar S_i = kvec.x*h_fourier_mesh_x.data[k].i + kvec.y*h_fourier_mesh_y.data[k].i
+            + kvec.z*h_fourier_mesh_z.data[k].i;
+        sum += (S_r*S_r + S_i*S_i)*h_inf_f.data[k];
+        }
+
+    if (m_prof) m_prof->pop();
+
+    Scalar V = m_pdata->getGlobalBox().getVolume();
+    Scalar scale = Scalar(1.0)/((Scalar)(m_global_dim.x*m_global_dim.y*m_global_dim.z));
+    sum *= Scalar(0.5)*V*scale*scale;
+
+    if (m_exec_conf->getRank()==0)
+        {
+        // subtract the dipolar self-energy on rank 0
+        sum -= m_mu2*Scalar(2.0)*m_kappa*m_kappa*m_kappa/(Scalar(3.0)*sqrt(Scalar(M_PI)));
+        }
+
+    // store this rank's contribution as external potential energy
+    m_external_energy = sum;
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        // reduce sum
+        MPI_Allreduce(MPI_IN_PLACE,
+                      &sum,
+                      1,
+                      MPI_HOOMD_SCALAR,
+                      MPI_SUM,
+                      m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    return sum;
+    }
+
+/*! Besides the terms of the charge virial, the strain rotates the wave vectors of S = k . M, which contributes
+    G Re(S* (k_a M_b + k_b M_a)).
+*/
+void PPPMDipoleForceCompute::computeVirial()
+    {
+    if (m_prof) m_prof->push("virial");
+
+    ArrayHandle<kiss_fft_cpx> h_fourier_mesh_x(m_fourier_mesh, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_cpx> h_fourier_mesh_y(m_fourier_mesh_y, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_cpx> h_fourier_mesh_z(m_fourier_mesh_z, access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_k_force(m_k_force, access_location::host, access_mode::read);
+    ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::read);
+
+    Scalar virial[6];
+    for (unsigned int i = 0; i < 6; ++i)
+        virial[i] = Scalar(0.0);
+
+    for (unsigned int kidx = 0; kidx < m_n_inner_cells; ++kidx)
+        {
+        Scalar3 k = h_k_force.data[kidx];
+        Scalar ksq = dot(k,k);
+
+        // skip the DC bin and the Nyquist modes
+        if (ksq == Scalar(0.0))
+            continue;
+
+        kiss_fft_cpx mx = h_fourier_mesh_x.data[kidx];
+        kiss_fft_cpx my = h_fourier_mesh_y.data[kidx];
+        kiss_fft_cpx mz = h_fourier_mesh_z.data[kidx];
+
+        Scalar S_r = k.x*mx.r + k.y*my.r + k.z*mz.r;
+        Scalar S_i = k.x*mx.i + k.y*my.i + k.z*mz.i;
+
+        Scalar G = h_inf_f.data[kidx];
+        Scalar sg = (S_r*S_r + S_i*S_i)*G;
+
+        // Re(S* M_b)
+        Scalar3 SM = make_scalar3(S_r*mx.r + S_i*mx.i, S_r*my.r + S_i*my.i, S_r*mz.r + S_i*mz.i)*G;
+
+        Scalar vterm = -Scalar(2.0)*(Scalar(1.0)/ksq + Scalar(0.25)/(m_kappa*m_kappa));
+        virial[0] += sg*(Scalar(1.0) + vterm*k.x*k.x) + Scalar(2.0)*k.x*SM.x;   // xx
+        virial[1] += sg*(              vterm*k.x*k.y) + k.x*SM.y + k.y*SM.x;    // xy
+        virial[2] += sg*(              vterm*k.x*k.z) + k.x*SM.z + k.z*SM.x;    // xz
+        virial[3] += sg*(Scalar(1.0) + vterm*k.y*k.y) + Scalar(2.0)*k.y*SM.y;   // yy
+        virial[4] += sg*(              vterm*k.y*k.z) + k.y*SM.z + k.z*SM.y;    // yz
+        virial[5] += sg*(Scalar(1.0) + vterm*k.z*k.z) + Scalar(2.0)*k.z*SM.z;   // zz
+        }
+
+    Scalar V = m_pdata->getGlobalBox().getVolume();
+    Scalar scale = Scalar(1.0)/((Scalar)(m_global_dim.x*m_global_dim.y*m_global_dim.z));
+
+    for (unsigned int k = 0; k < 6; ++k)
+        {
+        // store this rank's contribution in m_external_virial
+        m_external_virial[k] = Scalar(0.5)*virial[k]*V*scale*scale;
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+/*! The mesh part of the excluded pairs is the bare dipole interaction minus the real space part, evaluated with the
+    radial functions of EvaluatorPairDipoleEwald, and is subtracted from the forces, torques, energies and virials.
+*/
+void PPPMDipoleForceCompute::fixExclusions()
+    {
+    unsigned int group_size = m_group->getNumMembers();
+    // just drop out if the group is an empty group
+    if (group_size == 0)
+        return;
+
+    if (m_prof) m_prof->push("fix exclusions");
+
+    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_torque(m_torque,access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_virial(m_virial,access_location::host, access_mode::readwrite);
+
+    // reset virial (but not forces, we reset them above)
+    memset(h_virial.data, 0, sizeof(Scalar)*m_virial.getNumElements());
+
+    unsigned int virial_pitch = m_virial.getPitch();
+
+    const BoxDim& box = m_pdata->getBox();
+    ArrayHandle<unsigned int> h_exlist(m_nlist->getExListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_ex(m_nlist->getNExArray(), access_location::host, access_mode::read);
+    Index2D nex = m_nlist->getExListIndexer();
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(m_pdata->getOrientationArray(), access_location::host, access_mode::read);
+
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int idx = m_group->getMemberIndex(group_idx);
+        Scalar4 postypei = h_pos.data[idx];
+        Scalar mui = m_moment[__scalar_as_int(postypei.w)];
+        if (mui == Scalar(0.0))
+            continue;
+
+        vec3<Scalar> e_i = rotate(quat<Scalar>(h_orientation.data[idx]), vec3<Scalar>(1,0,0));
+
+        vec3<Scalar> force;
+        vec3<Scalar> torque;
+        Scalar energy(0.0);
+        Scalar virial[6];
+        for (unsigned int k = 0; k < 6; k++)
+            virial[k] = Scalar(0.0);
+
+        unsigned int n_neigh = h_n_ex.data[idx];
+        for (unsigned int neigh_idx = 0; neigh_idx < n_neigh; neigh_idx++)
+            {
+            unsigned int cur_j = h_exlist.data[nex(idx, neigh_idx)];
+            Scalar4 postypej = h_pos.data[cur_j];
+            Scalar muj = m_moment[__scalar_as_int(postypej.w)];
+            if (muj == Scalar(0.0))
+                continue;
+
+            vec3<Scalar> e_j = rotate(quat<Scalar>(h_orientation.data[cur_j]), vec3<Scalar>(1,0,0));
+
+            // apply periodic boundary conditions
+            Scalar3 dx = box.minImage(make_scalar3(postypei.x - postypej.x, postypei.y - postypej.y,
+                postypei.z - postypej.z));
+            vec3<Scalar> rvec(dx);
+
+            Scalar B, C, D;
+            EvaluatorPairDipoleEwald::computeRadialFunctions(m_kappa, dot(rvec, rvec), true, B, C, D);
+
+            Scalar mumu = mui*muj;
+            Scalar eidotej = dot(e_i, e_j);
+            Scalar eidotr = dot(e_i, rvec);
+            Scalar ejdotr = dot(e_j, rvec);
+
+            // subtract the long ranged part of the pair interaction
+            vec3<Scalar> f = -mumu*((eidotej*C - eidotr*ejdotr*D)*rvec + ejdotr*C*e_i + eidotr*C*e_j);
+            torque -= mumu*(-B*cross(e_i, e_j) + ejdotr*C*cross(e_i, rvec));
+            energy -= Scalar(0.5)*mumu*(eidotej*B - eidotr*ejdotr*C);
+            force += f;
+
+            virial[0] += Scalar(0.5) * dx.x * f.x;
+            virial[1] += Scalar(0.5) * dx.y * f.x;
+            virial[2] += Scalar(0.5) * dx.z * f.x;
+            virial[3] += Scalar(0.5) * dx.y * f.y;
+            virial[4] += Scalar(0.5) * dx.z * f.y;
+            virial[5] += Scalar(0.5) * dx.z * f.z;
+            }
+
+        h_force.data[idx].x += force.x;
+        h_force.data[idx].y += force.y;
+        h_force.data[idx].z += force.z;
+        h_force.data[idx].w += energy;
+        h_torque.data[idx].x += torque.x;
+        h_torque.data[idx].y += torque.y;
+        h_torque.data[idx].z += torque.z;
+        for (unsigned int k = 0; k < 6; k++)
+            h_virial.data[k*virial_pitch+idx] += virial[k];
+        }
+
+    if (m_prof) m_prof->pop();
+    }
+
+Scalar PPPMDipoleForceCompute::getLogValue(const std::string& quantity, unsigned int timestep)
+    {
+    if (quantity == m_log_names[0])
+        {
+        return computePE();
+        }
+
+    // nothing found? return base class value
+    return ForceCompute::getLogValue(quantity, timestep);
+    }
+
+void export_PPPMDipoleForceCompute(py::module& m)
+    {
+    py::class_<PPPMDipoleForceCompute, std::shared_ptr<PPPMDipoleForceCompute> >(m, "PPPMDipoleForceCompute", py::base<PPPMForceCompute>())
+        .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<NeighborList>, std::shared_ptr<ParticleGroup> >())
+        .def("setMoment", &PPPMDipoleForceCompute::setMoment)
+        .def("getMu2Sum", &PPPMDipoleForceCompute::getMu2Sum)
+        ;
+    }
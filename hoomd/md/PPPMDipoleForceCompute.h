@@ -0,0 +1,139 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#ifndef __PPPM_DIPOLE_FORCE_COMPUTE_H__
+#define __PPPM_DIPOLE_FORCE_COMPUTE_H__
+
+#include "PPPMForceCompute.h"
+
+#include <vector>
+
+/*! \file PPPMDipoleForceCompute.h
+    \brief Declares the long ranged part of the particle-particle particle-mesh Ewald sum for point dipoles
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+//! Compute the long-ranged part of the dipolar particle-particle particle-mesh Ewald sum (dipolar P3M)
+/*! Every particle carries a point dipole of the magnitude set for its type, along the x axis of its body frame (the
+    convention of EvaluatorPairDipole). The three components of the dipole density are assigned to separate meshes
+    with the charge assignment function of PPPMForceCompute and transformed. With ik-differentiation, the field and
+    the six independent components of the field gradient follow from the transformed density, the influence function
+    and products of the wave vector, and are transformed back in pairs of real meshes packed into one complex
+    transform. The torque on a dipole is mu x E and the force is grad(mu . E), both interpolated from the meshes.
+
+    The influence function is the one that minimizes the RMS force error of the ik-differentiated dipolar P3M
+    (Cerda et al., J. Chem. Phys. 129, 234104 (2008)). It has the same form as the one for charges, with the third
+    power of the projections of the aliased wave vectors.
+
+    The mesh geometry, the assignment coefficients, the ghost cell communication and the FFTs are those of
+    PPPMForceCompute. The real space part is evaluated by AnisoPotentialPair<EvaluatorPairDipoleEwald>. Screening
+    (alpha > 0) and rigid body corrections are not supported.
+ */
+class PYBIND11_EXPORT PPPMDipoleForceCompute : public PPPMForceCompute
+    {
+    public:
+        //! Constructor
+        PPPMDipoleForceCompute(std::shared_ptr<SystemDefinition> sysdef,
+            std::shared_ptr<NeighborList> nlist,
+            std::shared_ptr<ParticleGroup> group);
+        virtual ~PPPMDipoleForceCompute();
+
+        //! Set the parameters
+        virtual void setParams(unsigned int nx, unsigned int ny, unsigned int nz,
+            unsigned int order, Scalar kappa, Scalar rcut, Scalar alpha = 0);
+
+        //! Set the dipole magnitude of a particle type
+        void setMoment(unsigned int type, Scalar mu);
+
+        //! Get the sum of the squared dipole moments
+        Scalar getMu2Sum();
+
+        //! Returns the value of a specific log quantity
+        Scalar getLogValue(const std::string& quantity, unsigned int timestep);
+
+        //! The dipoles are oriented
+        virtual bool isAnisotropic()
+            {
+            return true;
+            }
+
+        #ifdef ENABLE_MPI
+        //! Get ghost particle fields requested by this force
+        /*! \param timestep Current time step
+        */
+        virtual CommFlags getRequestedCommFlags(unsigned int timestep)
+            {
+            CommFlags flags = ForceCompute::getRequestedCommFlags(timestep);
+
+            // orientations of excluded ghost partners
+            if (m_nlist->getExclusionsSet())
+                flags[comm_flag::orientation] = 1;
+
+            return flags;
+            }
+        #endif
+
+    protected:
+        std::vector<Scalar> m_moment;       //!< Dipole magnitude per type
+        Scalar m_mu2;                       //!< Sum of the squared dipole moments
+
+        GPUArray<kiss_fft_cpx> m_mesh_y;            //!< y component of the dipole density (x is in m_mesh)
+        GPUArray<kiss_fft_cpx> m_mesh_z;            //!< z component of the dipole density
+        GPUArray<kiss_fft_cpx> m_fourier_mesh_y;    //!< Transformed y component (x is in m_fourier_mesh)
+        GPUArray<kiss_fft_cpx> m_fourier_mesh_z;    //!< Transformed z component
+
+        GPUArray<kiss_fft_cpx> m_fourier_mesh_G_xxyy;   //!< Transformed field gradient, xx + i yy
+        GPUArray<kiss_fft_cpx> m_fourier_mesh_G_zzxy;   //!< Transformed field gradient, zz + i xy
+        GPUArray<kiss_fft_cpx> m_fourier_mesh_G_xzyz;   //!< Transformed field gradient, xz + i yz
+        GPUArray<kiss_fft_cpx> m_inv_fourier_mesh_xxyy; //!< Real space field gradient, xx in the real and yy in the imaginary part
+        GPUArray<kiss_fft_cpx> m_inv_fourier_mesh_zzxy; //!< Real space field gradient, zz in the real and xy in the imaginary part
+        GPUArray<kiss_fft_cpx> m_inv_fourier_mesh_xzyz; //!< Real space field gradient, xz in the real and yz in the imaginary part
+
+        //! Allocate the additional meshes
+        virtual void initializeFFT();
+
+        //! Compute the optimal influence function for dipoles
+        virtual void computeInfluenceFunction();
+
+        //! Assign the dipole density to the meshes
+        virtual void assignParticles();
+
+        //! Compute the field and field gradient meshes
+        virtual void updateMeshes();
+
+        //! Interpolate the forces and torques
+        virtual void interpolateForces();
+
+        //! Compute the mesh energy
+        virtual Scalar computePE();
+
+        //! Compute the mesh virial
+        virtual void computeVirial();
+
+        //! Subtract the long ranged part of the excluded pairs
+        virtual void fixExclusions();
+
+        //! Sum the dipole moments
+        virtual void setupCoeffs();
+
+        //! Rigid body corrections are not implemented for dipoles
+        virtual void computeBodyCorrection();
+
+    private:
+        //! Transform a real space mesh to k space
+        void forwardFFT(GPUArray<kiss_fft_cpx>& mesh, GPUArray<kiss_fft_cpx>& fourier_mesh);
+
+        //! Transform a k space mesh to real space, including its ghost cells
+        void inverseFFT(GPUArray<kiss_fft_cpx>& fourier_mesh, GPUArray<kiss_fft_cpx>& inv_mesh);
+
+        //! Compute the grid position and the offsets of a particle for the assignment function
+        bool findCell(const BoxDim& box, const Scalar3& pos, int3& cell, Scalar3& d);
+    };
+
+//! Exports the PPPMDipoleForceCompute class to python
+void export_PPPMDipoleForceCompute(pybind11::module& m);
+
+#endif // __PPPM_DIPOLE_FORCE_COMPUTE_H__
@@ -43,8 +43,9 @@ PPPMForceCompute::PPPMForceCompute(std::shared_ptr<SystemDefinition> sysdef,
       m_q(0.0),
       m_q2(0.0),
       m_body_energy(0.0),
+      m_rms_error(0.0),
       m_ptls_added_removed(false),
-      m_kiss_fft_initialized(false),
+      m_fft_backend("auto"),
       m_dfft_initialized(false)
     {
 
@@ -54,6 +55,7 @@ PPPMForceCompute::PPPMForceCompute(std::shared_ptr<SystemDefinition> sysdef,
     memset(h_virial.data, 0, sizeof(Scalar)*m_virial.getNumElements());
 
     m_log_names.push_back("pppm_energy");
+    m_log_names.push_back("pppm_rms_error");
 
     m_mesh_points = make_uint3(0,0,0);
     m_global_dim = make_uint3(0,0,0);
@@ -145,12 +147,6 @@ PPPMForceCompute::~PPPMForceCompute()
     {
     m_pdata->getGlobalParticleNumberChangeSignal().disconnect<PPPMForceCompute, &PPPMForceCompute::slotGlobalParticleNumberChange>(this);
 
-    if (m_kiss_fft_initialized)
-        {
-        free(m_kiss_fft);
-        free(m_kiss_ifft);
-        kiss_fft_cleanup();
-        }
     #ifdef ENABLE_MPI
     if (m_dfft_initialized)
         {
@@ -343,6 +339,7 @@ void PPPMForceCompute::setupCoeffs()
     Scalar spr = 2.0*m_q2*exp(-m_kappa*m_kappa*m_rcut*m_rcut) / sqrt((int)m_pdata->getNGlobal()*m_rcut*L.x*L.y*L.z);
 
     double RMS_error = std::max(lpr,spr);
+    m_rms_error = RMS_error;
     if(RMS_error > 0.1) {
         m_exec_conf->msg->warning() << "charge.pppm: RMS error of " << RMS_error << " is probably too high! " << lpr << " " << spr << std::endl;
         }
@@ -387,6 +384,9 @@ void PPPMForceCompute::setupMesh()
     GPUArray<Scalar3> k(m_n_inner_cells, m_exec_conf);
     m_k.swap(k);
 
+    GPUArray<Scalar3> k_force(m_n_inner_cells, m_exec_conf);
+    m_k_force.swap(k_force);
+
     GPUArray<Scalar> virial_mesh(6*m_n_inner_cells, m_exec_conf);
     m_virial_mesh.swap(virial_mesh);
 
@@ -481,15 +481,8 @@ void PPPMForceCompute::initializeFFT()
 
     if (local_fft)
         {
-        int dims[3];
-        dims[0] = m_mesh_points.z;
-        dims[1] = m_mesh_points.y;
-        dims[2] = m_mesh_points.x;
-
-        m_kiss_fft = kiss_fftnd_alloc(dims, 3, 0, NULL, NULL);
-        m_kiss_ifft = kiss_fftnd_alloc(dims, 3, 1, NULL, NULL);
-
-        m_kiss_fft_initialized = true;
+        m_local_fft = createLocalFFT(m_exec_conf, m_fft_backend, m_mesh_points);
+        m_exec_conf->msg->notice(3) << "charge.pppm: Using the " << m_local_fft->getName() << " FFT" << std::endl;
         }
 
     // allocate mesh and transformed mesh
@@ -501,22 +494,16 @@ void PPPMForceCompute::initializeFFT()
     GPUArray<kiss_fft_cpx> fourier_mesh(m_n_inner_cells, m_exec_conf);
     m_fourier_mesh.swap(fourier_mesh);
 
-    GPUArray<kiss_fft_cpx> fourier_mesh_G_x(m_n_inner_cells, m_exec_conf);
-    m_fourier_mesh_G_x.swap(fourier_mesh_G_x);
-
-    GPUArray<kiss_fft_cpx> fourier_mesh_G_y(m_n_inner_cells, m_exec_conf);
-    m_fourier_mesh_G_y.swap(fourier_mesh_G_y);
+    GPUArray<kiss_fft_cpx> fourier_mesh_G_xy(m_n_inner_cells, m_exec_conf);
+    m_fourier_mesh_G_xy.swap(fourier_mesh_G_xy);
 
     GPUArray<kiss_fft_cpx> fourier_mesh_G_z(m_n_inner_cells, m_exec_conf);
     m_fourier_mesh_G_z.swap(fourier_mesh_G_z);
 
     // pad with offset
 
-    GPUArray<kiss_fft_cpx> inv_fourier_mesh_x(m_n_cells+m_ghost_offset, m_exec_conf);
-    m_inv_fourier_mesh_x.swap(inv_fourier_mesh_x);
-
-    GPUArray<kiss_fft_cpx> inv_fourier_mesh_y(m_n_cells+m_ghost_offset, m_exec_conf);
-    m_inv_fourier_mesh_y.swap(inv_fourier_mesh_y);
+    GPUArray<kiss_fft_cpx> inv_fourier_mesh_xy(m_n_cells+m_ghost_offset, m_exec_conf);
+    m_inv_fourier_mesh_xy.swap(inv_fourier_mesh_xy);
 
     GPUArray<kiss_fft_cpx> inv_fourier_mesh_z(m_n_cells+m_ghost_offset, m_exec_conf);
     m_inv_fourier_mesh_z.swap(inv_fourier_mesh_z);
@@ -550,10 +537,12 @@ void PPPMForceCompute::computeInfluenceFunction()
 
     ArrayHandle<Scalar> h_inf_f(m_inf_f,access_location::host, access_mode::overwrite);
     ArrayHandle<Scalar3> h_k(m_k,access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar3> h_k_force(m_k_force,access_location::host, access_mode::overwrite);
 
     // reset arrays
     memset(h_inf_f.data, 0, sizeof(Scalar)*m_inf_f.getNumElements());
     memset(h_k.data, 0, sizeof(Scalar3)*m_k.getNumElements());
+    memset(h_k_force.data, 0, sizeof(Scalar3)*m_k_force.getNumElements());
 
     const BoxDim& global_box = m_pdata->getGlobalBox();
 
@@ -568,7 +557,7 @@ void PPPMForceCompute::computeInfluenceFunction()
     Scalar3 b3 = Scalar(2.0*M_PI)*make_scalar3(a1.y*a2.z-a1.z*a2.y, a1.z*a2.x-a1.x*a2.z, a1.x*a2.y-a1.y*a2.x)/V_box;
 
     #ifdef ENABLE_MPI
-    bool local_fft = m_kiss_fft_initialized;
+    bool local_fft = bool(m_local_fft);
 
     uint3 pdim=make_uint3(0,0,0);
     uint3 pidx=make_uint3(0,0,0);
@@ -705,6 +694,13 @@ void PPPMForceCompute::computeInfluenceFunction()
             }
 
         h_k.data[cell_idx] = k;
+
+        // the x and y field components are packed into one complex transform, which requires them to be
+        // Hermitian. The Nyquist modes of an even mesh have no partner and are left out of the field.
+        bool nyquist = (m_global_dim.x % 2 == 0 && n.x == -(int)(m_global_dim.x/2))
+            || (m_global_dim.y % 2 == 0 && n.y == -(int)(m_global_dim.y/2))
+            || (m_global_dim.z % 2 == 0 && n.z == -(int)(m_global_dim.z/2));
+        h_k_force.data[cell_idx] = nyquist ? make_scalar3(0.0,0.0,0.0) : k;
         }
 
     if (m_prof) m_prof->pop();
@@ -870,14 +866,14 @@ void PPPMForceCompute::assignParticles()
 
 void PPPMForceCompute::updateMeshes()
     {
-    if (m_kiss_fft_initialized)
+    if (m_local_fft)
         {
         if (m_prof) m_prof->push("FFT");
         // transform the particle mesh locally (forward transform)
         ArrayHandle<kiss_fft_cpx> h_mesh(m_mesh, access_location::host, access_mode::read);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::overwrite);
 
-        kiss_fftnd(m_kiss_fft, h_mesh.data, h_fourier_mesh.data);
+        m_local_fft->forward(h_mesh.data, h_fourier_mesh.data);
         if (m_prof) m_prof->pop();
         }
 
@@ -905,9 +901,8 @@ void PPPMForceCompute::updateMeshes()
     if (m_prof) m_prof->push("update");
 
         {
-        ArrayHandle<Scalar3> h_k(m_k, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::host, access_mode::overwrite);
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::host, access_mode::overwrite);
+        ArrayHandle<Scalar3> h_k_force(m_k_force, access_location::host, access_mode::read);
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_xy(m_fourier_mesh_G_xy, access_location::host, access_mode::overwrite);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::overwrite);
         ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::read);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::read);
@@ -921,13 +916,11 @@ void PPPMForceCompute::updateMeshes()
 
             Scalar scaled_inf_f = h_inf_f.data[k] / ((Scalar)NNN);
 
-            Scalar3 kvec = h_k.data[k];
-
-            h_fourier_mesh_G_x.data[k].r = f.i * kvec.x * scaled_inf_f;
-            h_fourier_mesh_G_x.data[k].i = -f.r * kvec.x * scaled_inf_f;
+            Scalar3 kvec = h_k_force.data[k];
 
-            h_fourier_mesh_G_y.data[k].r = f.i * kvec.y * scaled_inf_f;
-            h_fourier_mesh_G_y.data[k].i = -f.r * kvec.y * scaled_inf_f;
+            // G_x + i G_y, the inverse transform yields E_x in the real and E_y in the imaginary part
+            h_fourier_mesh_G_xy.data[k].r = (f.i * kvec.x + f.r * kvec.y) * scaled_inf_f;
+            h_fourier_mesh_G_xy.data[k].i = (f.i * kvec.y - f.r * kvec.x) * scaled_inf_f;
 
             h_fourier_mesh_G_z.data[k].r = f.i * kvec.z * scaled_inf_f;
             h_fourier_mesh_G_z.data[k].i = -f.r * kvec.z * scaled_inf_f;
@@ -936,19 +929,16 @@ void PPPMForceCompute::updateMeshes()
 
     if (m_prof) m_prof->pop();
 
-    if (m_kiss_fft_initialized)
+    if (m_local_fft)
         {
         if (m_prof) m_prof->push("FFT");
         // do a local inverse transform of the force mesh
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::host, access_mode::read);
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_xy(m_fourier_mesh_G_xy, access_location::host, access_mode::read);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::host, access_mode::overwrite);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::overwrite);
+        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_xy(m_inv_fourier_mesh_xy, access_location::host, access_mode::overwrite);
         ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::overwrite);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_x.data, h_inv_fourier_mesh_x.data);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_y.data, h_inv_fourier_mesh_y.data);
-        kiss_fftnd(m_kiss_ifft, h_fourier_mesh_G_z.data, h_inv_fourier_mesh_z.data);
+        m_local_fft->inverse(h_fourier_mesh_G_xy.data, h_inv_fourier_mesh_xy.data);
+        m_local_fft->inverse(h_fourier_mesh_G_z.data, h_inv_fourier_mesh_z.data);
         if (m_prof) m_prof->pop();
         }
 
@@ -959,30 +949,24 @@ void PPPMForceCompute::updateMeshes()
         // Distributed inverse transform force on mesh points
         m_exec_conf->msg->notice(8) << "charge.pppm: Distributed iFFT" << std::endl;
 
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::host, access_mode::read);
+        ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_xy(m_fourier_mesh_G_xy, access_location::host, access_mode::read);
         ArrayHandle<kiss_fft_cpx> h_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::read);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::host, access_mode::overwrite);
-        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::overwrite);
+        ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_xy(m_inv_fourier_mesh_xy, access_location::host, access_mode::overwrite);
         ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::overwrite);
 
-        dfft_execute((cpx_t *)h_fourier_mesh_G_x.data, (cpx_t *)(h_inv_fourier_mesh_x.data+m_ghost_offset), 1,m_dfft_plan_inverse);
-        dfft_execute((cpx_t *)h_fourier_mesh_G_y.data, (cpx_t *)(h_inv_fourier_mesh_y.data+m_ghost_offset), 1,m_dfft_plan_inverse);
+        dfft_execute((cpx_t *)h_fourier_mesh_G_xy.data, (cpx_t *)(h_inv_fourier_mesh_xy.data+m_ghost_offset), 1,m_dfft_plan_inverse);
         dfft_execute((cpx_t *)h_fourier_mesh_G_z.data, (cpx_t *)(h_inv_fourier_mesh_z.data+m_ghost_offset), 1,m_dfft_plan_inverse);
         if (m_prof) m_prof->pop();
         }
     #endif
 
-    // potential optimization: combine vector components into Scalar3
-
     #ifdef ENABLE_MPI
     if (m_pdata->getDomainDecomposition())
         {
         // update outer cells of force mesh using ghost cells from neighboring processors
         if (m_prof) m_prof->push("ghost cell update");
         m_exec_conf->msg->notice(8) << "charge.pppm: Ghost cell update" << std::endl;
-        m_grid_comm_reverse->communicate(m_inv_fourier_mesh_x);
-        m_grid_comm_reverse->communicate(m_inv_fourier_mesh_y);
+        m_grid_comm_reverse->communicate(m_inv_fourier_mesh_xy);
         m_grid_comm_reverse->communicate(m_inv_fourier_mesh_z);
         if (m_prof) m_prof->pop();
         }
@@ -998,8 +982,7 @@ void PPPMForceCompute::interpolateForces()
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
     // access inverse Fourier transform mesh
-    ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::host, access_mode::read);
-    ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::read);
+    ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_xy(m_inv_fourier_mesh_xy, access_location::host, access_mode::read);
     ArrayHandle<kiss_fft_cpx> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::read);
 
     // access force array
@@ -1142,13 +1125,12 @@ void PPPMForceCompute::interpolateForces()
 
                     unsigned int neigh_idx = neighi + m_grid_dim.x * (neighj + m_grid_dim.y*neighk);
 
-                    kiss_fft_cpx E_x = h_inv_fourier_mesh_x.data[neigh_idx];
-                    kiss_fft_cpx E_y = h_inv_fourier_mesh_y.data[neigh_idx];
+                    kiss_fft_cpx E_xy = h_inv_fourier_mesh_xy.data[neigh_idx];
                     kiss_fft_cpx E_z = h_inv_fourier_mesh_z.data[neigh_idx];
 
                     Scalar W = Wx * Wy * Wz;
-                    force.x += qi*W*E_x.r;
-                    force.y += qi*W*E_y.r;
+                    force.x += qi*W*E_xy.r;
+                    force.y += qi*W*E_xy.i;
                     force.z += qi*W*E_z.r;
                     }
                 }
@@ -1187,8 +1169,10 @@ Scalar PPPMForceCompute::computePE()
 
         if (! exclude)
             {
-            sum += (h_fourier_mesh.data[k].r * h_fourier_mesh.data[k].r
-                + h_fourier_mesh.data[k].i * h_fourier_mesh.data[k].i)*h_inf_f.data[k];
+            // the mesh is single precision, accumulate in Scalar
+            Scalar re = h_fourier_mesh.data[k].r;
+            Scalar im = h_fourier_mesh.data[k].i;
+            sum += (re * re + im * im)*h_inf_f.data[k];
             }
         }
 
@@ -1352,7 +1336,9 @@ void PPPMForceCompute::computeVirial()
             Scalar3 k = h_k.data[kidx];
             Scalar ksq = dot(k,k);
 
-            Scalar rhog = (fourier.r * fourier.r + fourier.i * fourier.i)*h_inf_f.data[kidx];
+            Scalar re = fourier.r;
+            Scalar im = fourier.i;
+            Scalar rhog = (re * re + im * im)*h_inf_f.data[kidx];
 
             Scalar vterm = -Scalar(2.0)*(Scalar(1.0)/ksq + Scalar(0.25)/(m_kappa*m_kappa));
             virial[0] += rhog*(Scalar(1.0) + vterm*k.x*k.x); // xx
@@ -1602,11 +1588,35 @@ Scalar PPPMForceCompute::getLogValue(const std::string& quantity, unsigned int t
         {
         return computePE();
         }
+    else if (quantity == m_log_names[1])
+        {
+        return m_rms_error;
+        }
 
     // nothing found? return base class value
     return ForceCompute::getLogValue(quantity, timestep);
     }
 
+/*! \param backend Name of the backend: "kiss", "fftw", or "auto" to use FFTW when HOOMD is compiled with it
+
+    The backend is only used without domain decomposition, distributed FFTs use the local FFT library that dfftlib is
+    built with.
+ */
+void PPPMForceCompute::setFFTBackend(const std::string& backend)
+    {
+    if (backend != "auto" && backend != "kiss" && backend != "fftw")
+        {
+        m_exec_conf->msg->error() << "charge.pppm: Unknown FFT backend " << backend << std::endl;
+        throw std::runtime_error("Error setting PPPM parameters");
+        }
+
+    m_fft_backend = backend;
+
+    // re-plan if the mesh is already set up
+    if (m_local_fft)
+        m_local_fft = createLocalFFT(m_exec_conf, m_fft_backend, m_mesh_points);
+    }
+
 Scalar PPPMForceCompute::getQSum()
     {
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
@@ -1667,6 +1677,8 @@ void export_PPPMForceCompute(py::module& m)
     py::class_<PPPMForceCompute, std::shared_ptr<PPPMForceCompute> >(m, "PPPMForceCompute", py::base<ForceCompute>())
         .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<NeighborList>, std::shared_ptr<ParticleGroup> >())
         .def("setParams", &PPPMForceCompute::setParams)
+        .def("setFFTBackend", &PPPMForceCompute::setFFTBackend)
+        .def("getFFTBackend", &PPPMForceCompute::getFFTBackend)
         .def("getQSum", &PPPMForceCompute::getQSum)
         .def("getQ2Sum", &PPPMForceCompute::getQ2Sum)
         ;
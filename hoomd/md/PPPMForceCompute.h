@@ -13,7 +13,7 @@
 #include "hoomd/extern/dfftlib/src/dfft_host.h"
 #endif
 
-#include "hoomd/extern/kiss_fftnd.h"
+#include "LocalFFT.h"
 
 #include <memory>
 #include <hoomd/extern/nano-signal-slot/nano_signal_slot.hpp>
@@ -57,6 +57,15 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
          */
         Scalar getLogValue(const std::string& quantity, unsigned int timestep);
 
+        //! Set the backend of the FFT on a single rank
+        void setFFTBackend(const std::string& backend);
+
+        //! Get the name of the FFT backend on a single rank
+        std::string getFFTBackend() const
+            {
+            return m_fft_backend;
+            }
+
         //! Get sum of charges
         Scalar getQSum();
 
@@ -111,6 +120,7 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         unsigned int m_n_inner_cells;       //!< Number of inner mesh points (without ghost cells)
         GPUArray<Scalar> m_inf_f;           //!< Fourier representation of the influence function (real part)
         GPUArray<Scalar3> m_k;              //!< Mesh of k values
+        GPUArray<Scalar3> m_k_force;        //!< Mesh of k values for the field, without unpaired Nyquist components
         Scalar m_qstarsq;                   //!< Short wave length cut-off squared for density harmonics
         bool m_need_initialize;             //!< True if we have not yet computed the influence function
         bool m_params_set;                  //!< True if parameters are set
@@ -130,6 +140,7 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         GPUArray<Scalar> m_gf_b;            //!< Green function coefficients
 
         Scalar m_body_energy;                      //!< Energy correction due to rigid body exclusions
+        Scalar m_rms_error;                        //!< Estimated RMS force error of the current parameters
         bool m_ptls_added_removed;          //!< True if global particle number changed
 
         //! Helper function to be called when particle number changes
@@ -177,9 +188,16 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         //! Compute rigid body correction
         virtual void computeBodyCorrection();
 
-    private:
-        kiss_fftnd_cfg m_kiss_fft;         //!< The FFT configuration
-        kiss_fftnd_cfg m_kiss_ifft;        //!< Inverse FFT configuration
+        //! computes coefficients for assigning charges to grid points
+        void compute_rho_coeff();
+
+        //! computes auxiliary table for optimized influence function
+        void compute_gf_denom();
+
+        //! computes coefficients for the Green's function
+        Scalar gf_denom(Scalar x, Scalar y, Scalar z);
+
+        std::unique_ptr<LocalFFT> m_local_fft; //!< The FFT on a single rank (NULL with domain decomposition)
 
         #ifdef ENABLE_MPI
         dfft_plan m_dfft_plan_forward;     //!< Distributed FFT for forward transform
@@ -188,19 +206,17 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
         std::unique_ptr<CommunicatorGrid<kiss_fft_cpx> > m_grid_comm_reverse; //!< Communicator for inv fourier mesh
         #endif
 
-        bool m_kiss_fft_initialized;               //!< True if a local KISS FFT has been set up
-
         GPUArray<kiss_fft_cpx> m_mesh;             //!< The particle density mesh
         GPUArray<kiss_fft_cpx> m_fourier_mesh;     //!< The fourier transformed mesh
-        GPUArray<kiss_fft_cpx> m_fourier_mesh_G_x;   //!< Fourier transformed mesh times the influence function, x-component
-        GPUArray<kiss_fft_cpx> m_fourier_mesh_G_y;   //!< Fourier transformed mesh times the influence function, y-component
+        GPUArray<kiss_fft_cpx> m_fourier_mesh_G_xy;   //!< Fourier transformed mesh times the influence function, x + i y components
         GPUArray<kiss_fft_cpx> m_fourier_mesh_G_z;   //!< Fourier transformed mesh times the influence function, z-component
-        GPUArray<kiss_fft_cpx> m_inv_fourier_mesh_x;   //!< Fourier transformed mesh times the influence function, x-component
-        GPUArray<kiss_fft_cpx> m_inv_fourier_mesh_y;   //!< Fourier transformed mesh times the influence function, y-component
+        GPUArray<kiss_fft_cpx> m_inv_fourier_mesh_xy;   //!< Real space field, x-component in the real and y-component in the imaginary part
         GPUArray<kiss_fft_cpx> m_inv_fourier_mesh_z;   //!< Fourier transformed mesh times the influence function, z-component
 
         std::vector<std::string> m_log_names;           //!< Name of the log quantity
 
+    private:
+        std::string m_fft_backend;          //!< Name of the FFT backend on a single rank
         bool m_dfft_initialized;                   //! True if host dfft has been initialized
 
         //! Compute virial on mesh
@@ -211,16 +227,6 @@ class PYBIND11_EXPORT PPPMForceCompute : public ForceCompute
 
         //! root mean square error in force calculation
         Scalar rms(Scalar h, Scalar prd, Scalar natoms);
-
-        //! computes coefficients for assigning charges to grid points
-        void compute_rho_coeff();
-
-        //! computes auxiliary table for optimized influence function
-        void compute_gf_denom();
-
-        //! computes coefficients for the Green's function
-        Scalar gf_denom(Scalar x, Scalar y, Scalar z);
-
     };
 
 void export_PPPMForceCompute(pybind11::module& m);
@@ -113,21 +113,15 @@ void PPPMForceComputeGPU::initializeFFT()
     GPUArray<cufftComplex> fourier_mesh(m_n_inner_cells, m_exec_conf);
     m_fourier_mesh.swap(fourier_mesh);
 
-    GPUArray<cufftComplex> fourier_mesh_G_x(m_n_inner_cells, m_exec_conf);
-    m_fourier_mesh_G_x.swap(fourier_mesh_G_x);
-
-    GPUArray<cufftComplex> fourier_mesh_G_y(m_n_inner_cells, m_exec_conf);
-    m_fourier_mesh_G_y.swap(fourier_mesh_G_y);
+    GPUArray<cufftComplex> fourier_mesh_G_xy(m_n_inner_cells, m_exec_conf);
+    m_fourier_mesh_G_xy.swap(fourier_mesh_G_xy);
 
     GPUArray<cufftComplex> fourier_mesh_G_z(m_n_inner_cells, m_exec_conf);
     m_fourier_mesh_G_z.swap(fourier_mesh_G_z);
 
     // pad with offset
-    GPUArray<cufftComplex> inv_fourier_mesh_x(m_n_cells+m_ghost_offset, m_exec_conf);
-    m_inv_fourier_mesh_x.swap(inv_fourier_mesh_x);
-
-    GPUArray<cufftComplex> inv_fourier_mesh_y(m_n_cells+m_ghost_offset, m_exec_conf);
-    m_inv_fourier_mesh_y.swap(inv_fourier_mesh_y);
+    GPUArray<cufftComplex> inv_fourier_mesh_xy(m_n_cells+m_ghost_offset, m_exec_conf);
+    m_inv_fourier_mesh_xy.swap(inv_fourier_mesh_xy);
 
     GPUArray<cufftComplex> inv_fourier_mesh_z(m_n_cells+m_ghost_offset, m_exec_conf);
     m_inv_fourier_mesh_z.swap(inv_fourier_mesh_z);
@@ -242,22 +236,20 @@ void PPPMForceComputeGPU::updateMeshes()
 
         {
         ArrayHandle<cufftComplex> d_fourier_mesh(m_fourier_mesh, access_location::device, access_mode::readwrite);
-        ArrayHandle<cufftComplex> d_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::device, access_mode::overwrite);
-        ArrayHandle<cufftComplex> d_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::device, access_mode::overwrite);
+        ArrayHandle<cufftComplex> d_fourier_mesh_G_xy(m_fourier_mesh_G_xy, access_location::device, access_mode::overwrite);
         ArrayHandle<cufftComplex> d_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::device, access_mode::overwrite);
 
         ArrayHandle<Scalar> d_inf_f(m_inf_f, access_location::device, access_mode::read);
-        ArrayHandle<Scalar3> d_k(m_k, access_location::device, access_mode::read);
+        ArrayHandle<Scalar3> d_k_force(m_k_force, access_location::device, access_mode::read);
 
         unsigned int block_size = m_tuner_update->getParam();
         m_tuner_update->begin();
         gpu_update_meshes(m_n_inner_cells,
                           d_fourier_mesh.data,
-                          d_fourier_mesh_G_x.data,
-                          d_fourier_mesh_G_y.data,
+                          d_fourier_mesh_G_xy.data,
                           d_fourier_mesh_G_z.data,
                           d_inf_f.data,
-                          d_k.data,
+                          d_k_force.data,
                           m_global_dim.x*m_global_dim.y*m_global_dim.z,
                           block_size);
 
@@ -272,21 +264,15 @@ void PPPMForceComputeGPU::updateMeshes()
         {
         if (m_prof) m_prof->push(m_exec_conf, "FFT");
 
-        // do local inverse transform of all three components of the force mesh
-        ArrayHandle<cufftComplex> d_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::device, access_mode::read);
-        ArrayHandle<cufftComplex> d_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::device, access_mode::read);
+        // do local inverse transform of the packed x,y and the z component of the force mesh
+        ArrayHandle<cufftComplex> d_fourier_mesh_G_xy(m_fourier_mesh_G_xy, access_location::device, access_mode::read);
         ArrayHandle<cufftComplex> d_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::device, access_mode::read);
-        ArrayHandle<cufftComplex> d_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::device, access_mode::overwrite);
-        ArrayHandle<cufftComplex> d_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::device, access_mode::overwrite);
+        ArrayHandle<cufftComplex> d_inv_fourier_mesh_xy(m_inv_fourier_mesh_xy, access_location::device, access_mode::overwrite);
         ArrayHandle<cufftComplex> d_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::device, access_mode::overwrite);
 
         CHECK_CUFFT_ERROR(cufftExecC2C(m_cufft_plan,
-                     d_fourier_mesh_G_x.data,
-                     d_inv_fourier_mesh_x.data,
-                     CUFFT_INVERSE));
-        CHECK_CUFFT_ERROR(cufftExecC2C(m_cufft_plan,
-                     d_fourier_mesh_G_y.data,
-                     d_inv_fourier_mesh_y.data,
+                     d_fourier_mesh_G_xy.data,
+                     d_inv_fourier_mesh_xy.data,
                      CUFFT_INVERSE));
         CHECK_CUFFT_ERROR(cufftExecC2C(m_cufft_plan,
                      d_fourier_mesh_G_z.data,
@@ -303,11 +289,9 @@ void PPPMForceComputeGPU::updateMeshes()
         // Distributed inverse transform of force mesh
         m_exec_conf->msg->notice(8) << "charge.pppm: Distributed iFFT" << std::endl;
         #ifndef USE_HOST_DFFT
-        ArrayHandle<cufftComplex> d_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::device, access_mode::read);
-        ArrayHandle<cufftComplex> d_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::device, access_mode::read);
+        ArrayHandle<cufftComplex> d_fourier_mesh_G_xy(m_fourier_mesh_G_xy, access_location::device, access_mode::read);
         ArrayHandle<cufftComplex> d_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::device, access_mode::read);
-        ArrayHandle<cufftComplex> d_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::device, access_mode::overwrite);
-        ArrayHandle<cufftComplex> d_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::device, access_mode::overwrite);
+        ArrayHandle<cufftComplex> d_inv_fourier_mesh_xy(m_inv_fourier_mesh_xy, access_location::device, access_mode::overwrite);
         ArrayHandle<cufftComplex> d_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::device, access_mode::overwrite);
 
         if (m_exec_conf->isCUDAErrorCheckingEnabled())
@@ -315,18 +299,14 @@ void PPPMForceComputeGPU::updateMeshes()
         else
             dfft_cuda_check_errors(&m_dfft_plan_inverse, 0);
 
-        dfft_cuda_execute(d_fourier_mesh_G_x.data, d_inv_fourier_mesh_x.data+m_ghost_offset, 1, &m_dfft_plan_inverse);
-        dfft_cuda_execute(d_fourier_mesh_G_y.data, d_inv_fourier_mesh_y.data+m_ghost_offset, 1, &m_dfft_plan_inverse);
+        dfft_cuda_execute(d_fourier_mesh_G_xy.data, d_inv_fourier_mesh_xy.data+m_ghost_offset, 1, &m_dfft_plan_inverse);
         dfft_cuda_execute(d_fourier_mesh_G_z.data, d_inv_fourier_mesh_z.data+m_ghost_offset, 1, &m_dfft_plan_inverse);
         #else
-        ArrayHandle<cufftComplex> h_fourier_mesh_G_x(m_fourier_mesh_G_x, access_location::host, access_mode::read);
-        ArrayHandle<cufftComplex> h_fourier_mesh_G_y(m_fourier_mesh_G_y, access_location::host, access_mode::read);
+        ArrayHandle<cufftComplex> h_fourier_mesh_G_xy(m_fourier_mesh_G_xy, access_location::host, access_mode::read);
         ArrayHandle<cufftComplex> h_fourier_mesh_G_z(m_fourier_mesh_G_z, access_location::host, access_mode::read);
-        ArrayHandle<cufftComplex> h_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::host, access_mode::overwrite);
-        ArrayHandle<cufftComplex> h_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::host, access_mode::overwrite);
+        ArrayHandle<cufftComplex> h_inv_fourier_mesh_xy(m_inv_fourier_mesh_xy, access_location::host, access_mode::overwrite);
         ArrayHandle<cufftComplex> h_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::host, access_mode::overwrite);
-        dfft_execute((cpx_t *)h_fourier_mesh_G_x.data, (cpx_t *)h_inv_fourier_mesh_x.data+m_ghost_offset, 1, m_dfft_plan_inverse);
-        dfft_execute((cpx_t *)h_fourier_mesh_G_y.data, (cpx_t *)h_inv_fourier_mesh_y.data+m_ghost_offset, 1, m_dfft_plan_inverse);
+        dfft_execute((cpx_t *)h_fourier_mesh_G_xy.data, (cpx_t *)h_inv_fourier_mesh_xy.data+m_ghost_offset, 1, m_dfft_plan_inverse);
         dfft_execute((cpx_t *)h_fourier_mesh_G_z.data, (cpx_t *)h_inv_fourier_mesh_z.data+m_ghost_offset, 1, m_dfft_plan_inverse);
         #endif
         if (m_prof) m_prof->pop(m_exec_conf);
@@ -339,8 +319,7 @@ void PPPMForceComputeGPU::updateMeshes()
         // update outer cells of inverse Fourier meshes using ghost cells from neighboring processors
         if (m_prof) m_prof->push(m_exec_conf, "ghost cell update");
         m_exec_conf->msg->notice(8) << "charge.pppm: Ghost cell update" << std::endl;
-        m_gpu_grid_comm_reverse->communicate(m_inv_fourier_mesh_x);
-        m_gpu_grid_comm_reverse->communicate(m_inv_fourier_mesh_y);
+        m_gpu_grid_comm_reverse->communicate(m_inv_fourier_mesh_xy);
         m_gpu_grid_comm_reverse->communicate(m_inv_fourier_mesh_z);
         if (m_prof) m_prof->pop();
         }
@@ -352,8 +331,7 @@ void PPPMForceComputeGPU::interpolateForces()
     if (m_prof) m_prof->push(m_exec_conf,"forces");
 
     ArrayHandle<Scalar4> d_postype(m_pdata->getPositions(), access_location::device, access_mode::read);
-    ArrayHandle<cufftComplex> d_inv_fourier_mesh_x(m_inv_fourier_mesh_x, access_location::device, access_mode::read);
-    ArrayHandle<cufftComplex> d_inv_fourier_mesh_y(m_inv_fourier_mesh_y, access_location::device, access_mode::read);
+    ArrayHandle<cufftComplex> d_inv_fourier_mesh_xy(m_inv_fourier_mesh_xy, access_location::device, access_mode::read);
     ArrayHandle<cufftComplex> d_inv_fourier_mesh_z(m_inv_fourier_mesh_z, access_location::device, access_mode::read);
     ArrayHandle<Scalar> d_charge(m_pdata->getCharges(), access_location::device, access_mode::read);
 
@@ -368,8 +346,7 @@ void PPPMForceComputeGPU::interpolateForces()
     gpu_compute_forces(m_pdata->getN(),
                        d_postype.data,
                        d_force.data,
-                       d_inv_fourier_mesh_x.data,
-                       d_inv_fourier_mesh_y.data,
+                       d_inv_fourier_mesh_xy.data,
                        d_inv_fourier_mesh_z.data,
                        m_grid_dim,
                        m_n_ghost_cells,
@@ -517,6 +494,7 @@ void PPPMForceComputeGPU::computeInfluenceFunction()
 
     ArrayHandle<Scalar> d_inf_f(m_inf_f, access_location::device, access_mode::overwrite);
     ArrayHandle<Scalar3> d_k(m_k, access_location::device, access_mode::overwrite);
+    ArrayHandle<Scalar3> d_k_force(m_k_force, access_location::device, access_mode::overwrite);
 
     uint3 global_dim = m_mesh_points;
     uint3 pidx = make_uint3(0,0,0);
@@ -541,6 +519,7 @@ void PPPMForceComputeGPU::computeInfluenceFunction()
                                    global_dim,
                                    d_inf_f.data,
                                    d_k.data,
+                                   d_k_force.data,
                                    m_pdata->getGlobalBox(),
                                    m_local_fft,
                                    pidx,
@@ -333,7 +333,9 @@ __global__ void gpu_compute_mesh_virial_kernel(const unsigned int n_wave_vectors
 
         Scalar3 k = d_k[idx];
 
-        Scalar rhog = (fourier.x * fourier.x + fourier.y * fourier.y)*d_inf_f[idx];
+        Scalar re = fourier.x;
+        Scalar im = fourier.y;
+        Scalar rhog = (re * re + im * im)*d_inf_f[idx];
         Scalar vterm = -Scalar(2.0)*(Scalar(1.0)/dot(k,k) + Scalar(0.25)/(kappa*kappa));
 
         d_virial_mesh[0*n_wave_vectors+idx] = rhog*(Scalar(1.0) + vterm*k.x*k.x); // xx
@@ -378,8 +380,7 @@ void gpu_compute_mesh_virial(const unsigned int n_wave_vectors,
 
 __global__ void gpu_update_meshes_kernel(const unsigned int n_wave_vectors,
                                          cufftComplex *d_fourier_mesh,
-                                         cufftComplex *d_fourier_mesh_G_x,
-                                         cufftComplex *d_fourier_mesh_G_y,
+                                         cufftComplex *d_fourier_mesh_G_xy,
                                          cufftComplex *d_fourier_mesh_G_z,
                                          const Scalar *d_inf_f,
                                          const Scalar3 *d_k,
@@ -397,29 +398,23 @@ __global__ void gpu_update_meshes_kernel(const unsigned int n_wave_vectors,
 
     Scalar3 kvec = d_k[k];
 
-    // Normalization
-    cufftComplex fourier_G_x;
-    fourier_G_x.x =f.y * kvec.x * scaled_inf_f;
-    fourier_G_x.y =-f.x * kvec.x * scaled_inf_f;
-
-    cufftComplex fourier_G_y;
-    fourier_G_y.x =f.y * kvec.y * scaled_inf_f;
-    fourier_G_y.y =-f.x * kvec.y * scaled_inf_f;
+    // Normalization, the x and y components are packed as G_x + i G_y
+    cufftComplex fourier_G_xy;
+    fourier_G_xy.x = (f.y * kvec.x + f.x * kvec.y) * scaled_inf_f;
+    fourier_G_xy.y = (f.y * kvec.y - f.x * kvec.x) * scaled_inf_f;
 
     cufftComplex fourier_G_z;
     fourier_G_z.x =f.y * kvec.z * scaled_inf_f;
     fourier_G_z.y =-f.x * kvec.z * scaled_inf_f;
 
     // store in global memory
-    d_fourier_mesh_G_x[k] = fourier_G_x;
-    d_fourier_mesh_G_y[k] = fourier_G_y;
+    d_fourier_mesh_G_xy[k] = fourier_G_xy;
     d_fourier_mesh_G_z[k] = fourier_G_z;
     }
 
 void gpu_update_meshes(const unsigned int n_wave_vectors,
                          cufftComplex *d_fourier_mesh,
-                         cufftComplex *d_fourier_mesh_G_x,
-                         cufftComplex *d_fourier_mesh_G_y,
+                         cufftComplex *d_fourier_mesh_G_xy,
                          cufftComplex *d_fourier_mesh_G_z,
                          const Scalar *d_inf_f,
                          const Scalar3 *d_k,
@@ -440,8 +435,7 @@ void gpu_update_meshes(const unsigned int n_wave_vectors,
 
     gpu_update_meshes_kernel<<<grid, run_block_size>>>(n_wave_vectors,
                                                       d_fourier_mesh,
-                                                      d_fourier_mesh_G_x,
-                                                      d_fourier_mesh_G_y,
+                                                      d_fourier_mesh_G_xy,
                                                       d_fourier_mesh_G_z,
                                                       d_inf_f,
                                                       d_k,
@@ -449,8 +443,7 @@ void gpu_update_meshes(const unsigned int n_wave_vectors,
     }
 
 //! Texture for reading particle positions
-texture<cufftComplex, 1, cudaReadModeElementType> inv_fourier_mesh_tex_x;
-texture<cufftComplex, 1, cudaReadModeElementType> inv_fourier_mesh_tex_y;
+texture<cufftComplex, 1, cudaReadModeElementType> inv_fourier_mesh_tex_xy;
 texture<cufftComplex, 1, cudaReadModeElementType> inv_fourier_mesh_tex_z;
 
 __global__ void gpu_compute_forces_kernel(const unsigned int N,
@@ -463,8 +456,7 @@ __global__ void gpu_compute_forces_kernel(const unsigned int N,
                                           int order,
                                           const unsigned int *d_index_array,
                                           unsigned int group_size,
-                                          const cufftComplex *inv_fourier_mesh_x,
-                                          const cufftComplex *inv_fourier_mesh_y,
+                                          const cufftComplex *inv_fourier_mesh_xy,
                                           const cufftComplex *inv_fourier_mesh_z)
     {
     unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
@@ -564,12 +556,11 @@ __global__ void gpu_compute_forces_kernel(const unsigned int N,
                 unsigned int cell_idx = neighl + grid_dim.x * (neighm + grid_dim.y * neighn);
 
 
-                cufftComplex inv_mesh_x = tex1Dfetch(inv_fourier_mesh_tex_x,cell_idx);
-                cufftComplex inv_mesh_y = tex1Dfetch(inv_fourier_mesh_tex_y,cell_idx);
+                cufftComplex inv_mesh_xy = tex1Dfetch(inv_fourier_mesh_tex_xy,cell_idx);
                 cufftComplex inv_mesh_z = tex1Dfetch(inv_fourier_mesh_tex_z,cell_idx);
 
-                force.x += qi*z0*inv_mesh_x.x;
-                force.y += qi*z0*inv_mesh_y.x;
+                force.x += qi*z0*inv_mesh_xy.x;
+                force.y += qi*z0*inv_mesh_xy.y;
                 force.z += qi*z0*inv_mesh_z.x;
                 }
             }
@@ -581,8 +572,7 @@ __global__ void gpu_compute_forces_kernel(const unsigned int N,
 void gpu_compute_forces(const unsigned int N,
                         const Scalar4 *d_postype,
                         Scalar4 *d_force,
-                        const cufftComplex *d_inv_fourier_mesh_x,
-                        const cufftComplex *d_inv_fourier_mesh_y,
+                        const cufftComplex *d_inv_fourier_mesh_xy,
                         const cufftComplex *d_inv_fourier_mesh_z,
                         const uint3 grid_dim,
                         const uint3 n_ghost_cells,
@@ -605,15 +595,12 @@ void gpu_compute_forces(const unsigned int N,
 
     // force mesh includes ghost cells
     unsigned int num_cells = grid_dim.x*grid_dim.y*grid_dim.z;
-    inv_fourier_mesh_tex_x.normalized = false;
-    inv_fourier_mesh_tex_x.filterMode = cudaFilterModePoint;
-    inv_fourier_mesh_tex_y.normalized = false;
-    inv_fourier_mesh_tex_y.filterMode = cudaFilterModePoint;
+    inv_fourier_mesh_tex_xy.normalized = false;
+    inv_fourier_mesh_tex_xy.filterMode = cudaFilterModePoint;
     inv_fourier_mesh_tex_z.normalized = false;
     inv_fourier_mesh_tex_z.filterMode = cudaFilterModePoint;
 
-    cudaBindTexture(0, inv_fourier_mesh_tex_x, d_inv_fourier_mesh_x, sizeof(cufftComplex)*num_cells);
-    cudaBindTexture(0, inv_fourier_mesh_tex_y, d_inv_fourier_mesh_y, sizeof(cufftComplex)*num_cells);
+    cudaBindTexture(0, inv_fourier_mesh_tex_xy, d_inv_fourier_mesh_xy, sizeof(cufftComplex)*num_cells);
     cudaBindTexture(0, inv_fourier_mesh_tex_z, d_inv_fourier_mesh_z, sizeof(cufftComplex)*num_cells);
 
     // reset force array for ALL particles
@@ -629,8 +616,7 @@ void gpu_compute_forces(const unsigned int N,
              order,
              d_index_array,
              group_size,
-             d_inv_fourier_mesh_x,
-             d_inv_fourier_mesh_y,
+             d_inv_fourier_mesh_xy,
              d_inv_fourier_mesh_z);
     }
 
@@ -654,7 +640,10 @@ __global__ void kernel_calculate_pe_partial(
     if (j < n_wave_vectors) {
         if (! exclude_dc || j != 0)
             {
-            mySum = d_fourier_mesh[j].x * d_fourier_mesh[j].x + d_fourier_mesh[j].y * d_fourier_mesh[j].y;
+            // the mesh is single precision, accumulate in Scalar
+            Scalar re = d_fourier_mesh[j].x;
+            Scalar im = d_fourier_mesh[j].y;
+            mySum = re * re + im * im;
             mySum *= d_inf_f[j];
             }
         }
@@ -915,6 +904,7 @@ __global__ void gpu_compute_influence_function_kernel(const uint3 mesh_dim,
                                           const uint3 global_dim,
                                           Scalar *d_inf_f,
                                           Scalar3 *d_k,
+                                          Scalar3 *d_k_force,
                                           const Scalar3 b1,
                                           const Scalar3 b2,
                                           const Scalar3 b3,
@@ -1059,12 +1049,19 @@ __global__ void gpu_compute_influence_function_kernel(const uint3 mesh_dim,
     // write out result
     d_inf_f[kidx] = val;
     d_k[kidx] = kval;
+
+    // the packed x and y field transform requires Hermitian components, leave out the unpaired Nyquist modes
+    bool nyquist = (global_dim.x % 2 == 0 && l == -(int)(global_dim.x/2))
+        || (global_dim.y % 2 == 0 && m == -(int)(global_dim.y/2))
+        || (global_dim.z % 2 == 0 && n == -(int)(global_dim.z/2));
+    d_k_force[kidx] = nyquist ? make_scalar3(0.0,0.0,0.0) : kval;
     }
 
 void gpu_compute_influence_function(const uint3 mesh_dim,
                                     const uint3 global_dim,
                                     Scalar *d_inf_f,
                                     Scalar3 *d_k,
+                                    Scalar3 *d_k_force,
                                     const BoxDim& global_box,
                                     const bool local_fft,
                                     const uint3 pidx,
@@ -1118,6 +1115,7 @@ void gpu_compute_influence_function(const uint3 mesh_dim,
                                                                               global_dim,
                                                                               d_inf_f,
                                                                               d_k,
+                                                                              d_k_force,
                                                                               b1,
                                                                               b2,
                                                                               b3,
@@ -1154,6 +1152,7 @@ void gpu_compute_influence_function(const uint3 mesh_dim,
                                                                              global_dim,
                                                                              d_inf_f,
                                                                              d_k,
+                                                                             d_k_force,
                                                                              b1,
                                                                              b2,
                                                                              b3,
@@ -30,8 +30,7 @@ void gpu_compute_mesh_virial(const unsigned int n_wave_vectors,
 
 void gpu_update_meshes(const unsigned int n_wave_vectors,
                          cufftComplex *d_fourier_mesh,
-                         cufftComplex *d_fourier_mesh_G_x,
-                         cufftComplex *d_fourier_mesh_G_y,
+                         cufftComplex *d_fourier_mesh_G_xy,
                          cufftComplex *d_fourier_mesh_G_z,
                          const Scalar *d_inf_f,
                          const Scalar3 *d_k,
@@ -41,8 +40,7 @@ void gpu_update_meshes(const unsigned int n_wave_vectors,
 void gpu_compute_forces(const unsigned int N,
                         const Scalar4 *d_postype,
                         Scalar4 *d_force,
-                        const cufftComplex *d_inv_fourier_mesh_x,
-                        const cufftComplex *d_inv_fourier_mesh_y,
+                        const cufftComplex *d_inv_fourier_mesh_xy,
                         const cufftComplex *d_inv_fourier_mesh_z,
                         const uint3 grid_dim,
                         const uint3 n_ghost_cells,
@@ -72,6 +70,7 @@ void gpu_compute_influence_function(const uint3 mesh_dim,
                                     const uint3 global_dim,
                                     Scalar *d_inf_f,
                                     Scalar3 *d_k,
+                                    Scalar3 *d_k_force,
                                     const BoxDim& global_box,
                                     const bool local_fft,
                                     const uint3 pidx,
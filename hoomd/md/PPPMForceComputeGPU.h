@@ -114,11 +114,9 @@ class PYBIND11_EXPORT PPPMForceComputeGPU : public PPPMForceCompute
 
         GPUArray<cufftComplex> m_mesh;                 //!< The particle density mesh
         GPUArray<cufftComplex> m_fourier_mesh;         //!< The fourier transformed mesh
-        GPUArray<cufftComplex> m_fourier_mesh_G_x;       //!< Fourier transformed mesh times the influence function, x component
-        GPUArray<cufftComplex> m_fourier_mesh_G_y;       //!< Fourier transformed mesh times the influence function, y component
+        GPUArray<cufftComplex> m_fourier_mesh_G_xy;      //!< Fourier transformed mesh times the influence function, x + i y components
         GPUArray<cufftComplex> m_fourier_mesh_G_z;       //!< Fourier transformed mesh times the influence function, z component
-        GPUArray<cufftComplex> m_inv_fourier_mesh_x;     //!< The inverse-fourier transformed force mesh
-        GPUArray<cufftComplex> m_inv_fourier_mesh_y;     //!< The inverse-fourier transformed force mesh
+        GPUArray<cufftComplex> m_inv_fourier_mesh_xy;    //!< The inverse-fourier transformed force mesh, x and y components
         GPUArray<cufftComplex> m_inv_fourier_mesh_z;     //!< The inverse-fourier transformed force mesh
 
         GPUFlags<Scalar> m_sum;                    //!< Sum over fourier mesh values
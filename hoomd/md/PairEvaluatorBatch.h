@@ -0,0 +1,229 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#ifndef __PAIR_EVALUATOR_BATCH_H__
+#define __PAIR_EVALUATOR_BATCH_H__
+
+#include "hoomd/HOOMDMath.h"
+
+#include "EvaluatorPairLJ.h"
+#include "EvaluatorPairGauss.h"
+#include "EvaluatorPairYukawa.h"
+#include "EvaluatorPairMorse.h"
+
+/*! \file PairEvaluatorBatch.h
+    \brief Defines the batched CPU evaluation of pair potentials
+    \details PotentialPair gathers the neighbors of a particle into batches of HOOMD_PAIR_BATCH_SIZE. Evaluators
+    that opt in through a specialization of PairEvaluatorBatch compute the forces and energies of a whole batch in
+    one branch-free loop that the compiler vectorizes for the instruction set it targets (SSE, AVX2 or AVX-512).
+    \note This header cannot be compiled by nvcc
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+//! Number of neighbors that are evaluated together in the CPU pair loop
+/*! The batch size is chosen from the vector width of the compile target so that one batch fills one (AVX-512, AVX)
+    or two (SSE) vector registers in double precision.
+*/
+#ifndef HOOMD_PAIR_BATCH_SIZE
+#if defined(__AVX512F__)
+#define HOOMD_PAIR_BATCH_SIZE 16
+#elif defined(__AVX__)
+#define HOOMD_PAIR_BATCH_SIZE 8
+#else
+#define HOOMD_PAIR_BATCH_SIZE 4
+#endif
+#endif
+
+//! Batched evaluation of a pair potential on the CPU
+/*! The generic template is disabled. PotentialPair then calls evaluator::evalForceAndEnergy() for every neighbor.
+
+    An evaluator opts in to batched evaluation by specializing PairEvaluatorBatch, setting \a enabled to true and
+    providing evalForceAndEnergy(). The batched version is only used when the evaluator needs neither diameter nor
+    charge and the shift mode is not XPLOR, the remaining cases fall back to the scalar evaluator.
+
+    Lanes that are beyond the cutoff (or that the scalar evaluator would otherwise skip) must return zero force and
+    energy. Implementations should compute all lanes unconditionally and select the result with the mask so that
+    the loop contains no branches.
+*/
+template<class evaluator>
+struct PairEvaluatorBatch
+    {
+    //! True if the evaluator provides a batched evaluation
+    static const bool enabled = false;
+
+    //! Evaluate the forces and energies of a batch of neighbors
+    /*! \param n Number of valid lanes in the batch
+        \param rsq Squared distances
+        \param rcutsq Squared cutoff radii
+        \param params Per type pair parameters
+        \param energy_shift If true, the potential is shifted so that V(r) is continuous at the cutoff
+        \param force_divr Output force divided by r
+        \param pair_eng Output pair energy
+    */
+    static void evalForceAndEnergy(unsigned int n,
+                                   const Scalar *rsq,
+                                   const Scalar *rcutsq,
+                                   const typename evaluator::param_type *params,
+                                   bool energy_shift,
+                                   Scalar *force_divr,
+                                   Scalar *pair_eng)
+        {
+        }
+    };
+
+//! Batched evaluation of the LJ pair potential
+/*! Like EvaluatorPairLJ, the arithmetic is done in ForceReal.
+*/
+template<>
+struct PairEvaluatorBatch<EvaluatorPairLJ>
+    {
+    static const bool enabled = true;
+
+    static void evalForceAndEnergy(unsigned int n,
+                                   const Scalar *rsq,
+                                   const Scalar *rcutsq,
+                                   const Scalar2 *params,
+                                   bool energy_shift,
+                                   Scalar *force_divr,
+                                   Scalar *pair_eng)
+        {
+        const ForceReal shift = energy_shift ? ForceReal(1.0) : ForceReal(0.0);
+        for (unsigned int k = 0; k < n; ++k)
+            {
+            const ForceReal lj1 = params[k].x;
+            const ForceReal lj2 = params[k].y;
+            const ForceReal r_sq = rsq[k];
+            const ForceReal rcut_sq = rcutsq[k];
+            const bool in_range = r_sq < rcut_sq && lj1 != ForceReal(0.0);
+
+            ForceReal r2inv = ForceReal(1.0)/r_sq;
+            ForceReal r6inv = r2inv * r2inv * r2inv;
+            ForceReal rcut2inv = ForceReal(1.0)/rcut_sq;
+            ForceReal rcut6inv = rcut2inv * rcut2inv * rcut2inv;
+
+            ForceReal f = r2inv * r6inv * (ForceReal(12.0)*lj1*r6inv - ForceReal(6.0)*lj2);
+            ForceReal e = r6inv * (lj1*r6inv - lj2) - shift * rcut6inv * (lj1*rcut6inv - lj2);
+
+            force_divr[k] = in_range ? f : ForceReal(0.0);
+            pair_eng[k] = in_range ? e : ForceReal(0.0);
+            }
+        }
+    };
+
+//! Batched evaluation of the Gaussian pair potential
+template<>
+struct PairEvaluatorBatch<EvaluatorPairGauss>
+    {
+    static const bool enabled = true;
+
+    static void evalForceAndEnergy(unsigned int n,
+                                   const Scalar *rsq,
+                                   const Scalar *rcutsq,
+                                   const Scalar2 *params,
+                                   bool energy_shift,
+                                   Scalar *force_divr,
+                                   Scalar *pair_eng)
+        {
+        const Scalar shift = energy_shift ? Scalar(1.0) : Scalar(0.0);
+        for (unsigned int k = 0; k < n; ++k)
+            {
+            const Scalar epsilon = params[k].x;
+            const Scalar sigma = params[k].y;
+            const bool in_range = rsq[k] < rcutsq[k];
+
+            Scalar sigma_sq = sigma*sigma;
+            Scalar exp_val = fast::exp(-Scalar(1.0)/Scalar(2.0) * rsq[k] / sigma_sq);
+            Scalar exp_cut = fast::exp(-Scalar(1.0)/Scalar(2.0) * rcutsq[k] / sigma_sq);
+
+            Scalar f = epsilon / sigma_sq * exp_val;
+            Scalar e = epsilon * (exp_val - shift * exp_cut);
+
+            force_divr[k] = in_range ? f : Scalar(0.0);
+            pair_eng[k] = in_range ? e : Scalar(0.0);
+            }
+        }
+    };
+
+//! Batched evaluation of the Yukawa pair potential
+template<>
+struct PairEvaluatorBatch<EvaluatorPairYukawa>
+    {
+    static const bool enabled = true;
+
+    static void evalForceAndEnergy(unsigned int n,
+                                   const Scalar *rsq,
+                                   const Scalar *rcutsq,
+                                   const Scalar2 *params,
+                                   bool energy_shift,
+                                   Scalar *force_divr,
+                                   Scalar *pair_eng)
+        {
+        const Scalar shift = energy_shift ? Scalar(1.0) : Scalar(0.0);
+        for (unsigned int k = 0; k < n; ++k)
+            {
+            const Scalar epsilon = params[k].x;
+            const Scalar kappa = params[k].y;
+            const bool in_range = rsq[k] < rcutsq[k] && epsilon != Scalar(0.0);
+
+            Scalar rinv = fast::rsqrt(rsq[k]);
+            Scalar r = Scalar(1.0) / rinv;
+            Scalar r2inv = Scalar(1.0) / rsq[k];
+            Scalar exp_val = fast::exp(-kappa * r);
+
+            Scalar rcutinv = fast::rsqrt(rcutsq[k]);
+            Scalar rcut = Scalar(1.0) / rcutinv;
+            Scalar exp_cut = fast::exp(-kappa * rcut);
+
+            Scalar f = epsilon * exp_val * r2inv * (rinv + kappa);
+            Scalar e = epsilon * (exp_val * rinv - shift * exp_cut * rcutinv);
+
+            force_divr[k] = in_range ? f : Scalar(0.0);
+            pair_eng[k] = in_range ? e : Scalar(0.0);
+            }
+        }
+    };
+
+//! Batched evaluation of the Morse pair potential
+template<>
+struct PairEvaluatorBatch<EvaluatorPairMorse>
+    {
+    static const bool enabled = true;
+
+    static void evalForceAndEnergy(unsigned int n,
+                                   const Scalar *rsq,
+                                   const Scalar *rcutsq,
+                                   const Scalar4 *params,
+                                   bool energy_shift,
+                                   Scalar *force_divr,
+                                   Scalar *pair_eng)
+        {
+        const Scalar shift = energy_shift ? Scalar(1.0) : Scalar(0.0);
+        for (unsigned int k = 0; k < n; ++k)
+            {
+            const Scalar D0 = params[k].x;
+            const Scalar alpha = params[k].y;
+            const Scalar r0 = params[k].z;
+            const bool in_range = rsq[k] < rcutsq[k];
+
+            Scalar r = fast::sqrt(rsq[k]);
+            Scalar Exp_factor = fast::exp(-alpha*(r-r0));
+            Scalar rcut = fast::sqrt(rcutsq[k]);
+            Scalar Exp_factor_cut = fast::exp(-alpha*(rcut-r0));
+
+            Scalar f = Scalar(2.0) * D0 * alpha * Exp_factor * (Exp_factor - Scalar(1.0)) / r;
+            Scalar e = D0 * (Exp_factor * (Exp_factor - Scalar(2.0))
+                             - shift * Exp_factor_cut * (Exp_factor_cut - Scalar(2.0)));
+
+            force_divr[k] = in_range ? f : Scalar(0.0);
+            pair_eng[k] = in_range ? e : Scalar(0.0);
+            }
+        }
+    };
+
+#endif // __PAIR_EVALUATOR_BATCH_H__
@@ -3,7 +3,7 @@
 
 #include <memory>
 #include "hoomd/ForceCompute.h"
-#include "hoomd/GPUArray.h"
+#include "hoomd/GlobalArray.h"
 
 #include <vector>
 
@@ -53,7 +53,7 @@ class PotentialBond : public ForceCompute
         #endif
 
     protected:
-        GPUArray<param_type> m_params;              //!< Bond parameters per type
+        GlobalArray<param_type> m_params;           //!< Bond parameters per type
         std::shared_ptr<BondData> m_bond_data;    //!< Bond data to use in computing bonds
         std::string m_log_name;                     //!< Cached log name
         std::string m_prof_name;                    //!< Cached profiler name
@@ -79,7 +79,7 @@ PotentialBond< evaluator >::PotentialBond(std::shared_ptr<SystemDefinition> sysd
     m_prof_name = std::string("Bond ") + evaluator::getName();
 
     // allocate the parameters
-    GPUArray<param_type> params(m_bond_data->getNTypes(), m_exec_conf);
+    GlobalArray<param_type> params(m_bond_data->getNTypes(), m_exec_conf);
     m_params.swap(params);
     }
 
@@ -178,6 +178,10 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
     PDataFlags flags = this->m_pdata->getFlags();
     bool compute_virial = flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial];
 
+    // the energies are skipped when nothing reads them on this step, validateEnergies() recomputes them on demand
+    const bool compute_energy = needsEnergies();
+    m_energies_valid = compute_energy;
+
     Scalar bond_virial[6];
     for (unsigned int i = 0; i< 6; i++)
         bond_virial[i]=Scalar(0.0);
@@ -255,7 +259,7 @@ void PotentialBond< evaluator >::computeForces(unsigned int timestep)
         bool evaluated = eval.evalForceAndEnergy(force_divr, bond_eng);
 
         // Bond energy must be halved
-        bond_eng *= Scalar(0.5);
+        bond_eng = compute_energy ? bond_eng * Scalar(0.5) : Scalar(0.0);
 
         if (evaluated)
             {
@@ -8,8 +8,11 @@
 #include "hoomd/ParticleData.cuh"
 #include "hoomd/Index1D.h"
 #include "hoomd/TextureTools.h"
+#include "hoomd/GPUPartition.cuh"
 
 #include "hoomd/BondedGroupData.cuh"
+#include "GroupForceScatter.cuh"
+#include "MDPrecisionSetup.h"
 
 #include <assert.h>
 
@@ -38,7 +41,13 @@ struct bond_args_t
               const unsigned int *_d_gpu_n_bonds,
               const unsigned int _n_bond_types,
               const unsigned int _block_size,
-              const unsigned int _compute_capability)
+              const unsigned int _compute_capability,
+              const GPUPartition& _gpu_partition,
+              const group_storage<2> *_d_group_list = NULL,
+              const unsigned int *_d_group_type = NULL,
+              const unsigned int _n_groups = 0,
+              cudaStream_t _stream = 0,
+              const bool _compute_energy = true)
                 : d_force(_d_force),
                   d_virial(_d_virial),
                   virial_pitch(_virial_pitch),
@@ -53,7 +62,13 @@ struct bond_args_t
                   d_gpu_n_bonds(_d_gpu_n_bonds),
                   n_bond_types(_n_bond_types),
                   block_size(_block_size),
-                  compute_capability(_compute_capability)
+                  compute_capability(_compute_capability),
+                  gpu_partition(_gpu_partition),
+                  d_group_list(_d_group_list),
+                  d_group_type(_d_group_type),
+                  n_groups(_n_groups),
+                  stream(_stream),
+                  compute_energy(_compute_energy)
         {
         };
 
@@ -72,6 +87,12 @@ struct bond_args_t
     const unsigned int n_bond_types;   //!< Number of bond types in the simulation
     const unsigned int block_size;     //!< Block size to execute
     const unsigned int compute_capability;  //!< Compute capability of the device
+    const GPUPartition& gpu_partition;      //!< The load balancing partition of particles between GPUs
+    const group_storage<2> *d_group_list;   //!< Group-centric bond list (NULL to evaluate per particle)
+    const unsigned int *d_group_type;       //!< Types of the bonds in the group-centric list
+    const unsigned int n_groups;            //!< Number of bonds in the group-centric list
+    cudaStream_t stream;                    //!< Stream to launch the kernels in
+    const bool compute_energy;              //!< False to skip the potential energy (written as zero)
     };
 
 #ifdef NVCC
@@ -91,7 +112,7 @@ scalar_tex_t pdata_charge_tex;
     \param d_force Device memory to write computed forces
     \param d_virial Device memory to write computed virials
     \param virial_pitch pitch of 2D virial array
-    \param N Number of particles in the system
+    \param N Number of particles handled by this GPU
     \param d_pos particle positions on the GPU
     \param d_charge particle charges
     \param d_diameter particle diameters
@@ -102,13 +123,15 @@ scalar_tex_t pdata_charge_tex;
     \param n_bond_type number of bond types
     \param d_params Parameters for the potential, stored per bond type
     \param d_flags Flag allocated on the device for use in checking for bonds that cannot be evaluated
+    \param offset Index of the first particle handled by this GPU
 
 
     Certain options are controlled via template parameters to avoid the performance hit when they are not enabled.
     \tparam evaluator EvaluatorBond class to evaluate V(r) and -delta V(r)/r
+    \tparam compute_energy When zero, the potential energy is not computed and written as zero.
 
 */
-template< class evaluator >
+template< class evaluator, unsigned int compute_energy >
 __global__ void gpu_compute_bond_forces_kernel(Scalar4 *d_force,
                                                Scalar *d_virial,
                                                const unsigned int virial_pitch,
@@ -122,10 +145,11 @@ __global__ void gpu_compute_bond_forces_kernel(Scalar4 *d_force,
                                                const unsigned int *n_bonds_list,
                                                const unsigned int n_bond_type,
                                                const typename evaluator::param_type *d_params,
-                                               unsigned int *d_flags)
+                                               unsigned int *d_flags,
+                                               const unsigned int offset)
     {
     // start by identifying which particle we are to handle
-    int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
 
     // shared array for per bond type parameters
     extern __shared__ char s_data[];
@@ -146,6 +170,9 @@ __global__ void gpu_compute_bond_forces_kernel(Scalar4 *d_force,
     if (idx >= N)
         return;
 
+    // add offset to get actual particle index
+    idx += offset;
+
     // load in the length of the list for this thread (MEM TRANSFER: 4 bytes)
     int n_bonds =n_bonds_list[idx];
 
@@ -195,10 +222,13 @@ __global__ void gpu_compute_bond_forces_kernel(Scalar4 *d_force,
         // apply periodic boundary conditions (FLOPS: 12)
         dx = box.minImage(dx);
 
+        // the bond force is evaluated from the short relative vector
+        const ForceReal3 dxf = make_forcereal3(dx);
+
         // get the bond parameters (MEM TRANSFER: 8 bytes)
         typename evaluator::param_type param = s_params[cur_bond_type];
 
-        Scalar rsq = dot(dx, dx);
+        Scalar rsq = dxf.x*dxf.x + dxf.y*dxf.y + dxf.z*dxf.z;
 
         // evaluate the potential
         Scalar force_divr = Scalar(0.0);
@@ -223,20 +253,22 @@ __global__ void gpu_compute_bond_forces_kernel(Scalar4 *d_force,
         if (evaluated)
             {
             // add up the virial (double counting, multiply by 0.5)
-            Scalar force_div2r = force_divr/Scalar(2.0);
-            virial[0] += dx.x * dx.x * force_div2r; // xx
-            virial[1] += dx.x * dx.y * force_div2r; // xy
-            virial[2] += dx.x * dx.z * force_div2r; // xz
-            virial[3] += dx.y * dx.y * force_div2r; // yy
-            virial[4] += dx.y * dx.z * force_div2r; // yz
-            virial[5] += dx.z * dx.z * force_div2r; // zz
+            ForceReal force_div2r = ForceReal(force_divr)/ForceReal(2.0);
+            virial[0] += dxf.x * dxf.x * force_div2r; // xx
+            virial[1] += dxf.x * dxf.y * force_div2r; // xy
+            virial[2] += dxf.x * dxf.z * force_div2r; // xz
+            virial[3] += dxf.y * dxf.y * force_div2r; // yy
+            virial[4] += dxf.y * dxf.z * force_div2r; // yz
+            virial[5] += dxf.z * dxf.z * force_div2r; // zz
 
             // add up the forces
-            force.x += dx.x * force_divr;
-            force.y += dx.y * force_divr;
-            force.z += dx.z * force_divr;
+            const ForceReal force_divr_f = ForceReal(force_divr);
+            force.x += dxf.x * force_divr_f;
+            force.y += dxf.y * force_divr_f;
+            force.z += dxf.z * force_divr_f;
             // energy is double counted: multiply by 0.5
-            force.w += bond_eng * Scalar(0.5);
+            if (compute_energy)
+                force.w += bond_eng * Scalar(0.5);
             }
         else
             {
@@ -252,74 +284,277 @@ __global__ void gpu_compute_bond_forces_kernel(Scalar4 *d_force,
         d_virial[i*virial_pitch + idx] = virial[i];
     }
 
+//! Kernel for calculating bond forces with one thread per bond
+/*! Every bond is evaluated once and the forces on both members are added to the per-particle arrays with
+    gpu_group_force_scatter(). \a d_force and \a d_virial must be zeroed before the kernel is launched.
+
+    \param d_force Device memory to add the computed forces to
+    \param d_virial Device memory to add the computed virials to
+    \param virial_pitch pitch of 2D virial array
+    \param N Number of local particles
+    \param d_pos particle positions on the GPU
+    \param d_charge particle charges
+    \param d_diameter particle diameters
+    \param box Box dimensions used to implement periodic boundary conditions
+    \param d_group_list Local member indices of the bonds
+    \param d_group_type Types of the bonds
+    \param n_groups Number of bonds
+    \param n_bond_type number of bond types
+    \param d_params Parameters for the potential, stored per bond type
+    \param d_flags Flag allocated on the device for use in checking for bonds that cannot be evaluated
+
+    \tparam evaluator EvaluatorBond class to evaluate V(r) and -delta V(r)/r
+    \tparam compute_energy When zero, the potential energy is not computed and written as zero.
+*/
+template< class evaluator, unsigned int compute_energy >
+__global__ void gpu_compute_bond_forces_group_kernel(Scalar4 *d_force,
+                                                     Scalar *d_virial,
+                                                     const unsigned int virial_pitch,
+                                                     const unsigned int N,
+                                                     const Scalar4 *d_pos,
+                                                     const Scalar *d_charge,
+                                                     const Scalar *d_diameter,
+                                                     const BoxDim box,
+                                                     const group_storage<2> *d_group_list,
+                                                     const unsigned int *d_group_type,
+                                                     const unsigned int n_groups,
+                                                     const unsigned int n_bond_type,
+                                                     const typename evaluator::param_type *d_params,
+                                                     unsigned int *d_flags)
+    {
+    // identify the bond this thread handles
+    unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    // shared array for per bond type parameters
+    extern __shared__ char s_data[];
+    typename evaluator::param_type *s_params =
+        (typename evaluator::param_type *)(&s_data[0]);
+
+    // load in per bond type parameters
+    for (unsigned int cur_offset = 0; cur_offset < n_bond_type; cur_offset += blockDim.x)
+        {
+        if (cur_offset + threadIdx.x < n_bond_type)
+            {
+            s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
+            }
+        }
+
+    __syncthreads();
+
+    unsigned int idx[2] = {NOT_LOCAL, NOT_LOCAL};
+    Scalar4 force[2];
+    Scalar virial[2][6];
+    for (unsigned int m = 0; m < 2; ++m)
+        {
+        force[m] = make_scalar4(0, 0, 0, 0);
+        for (unsigned int i = 0; i < 6; ++i)
+            virial[m][i] = Scalar(0.0);
+        }
+
+    // threads without a bond still take part in the warp-level scatter
+    if (group_idx < n_groups)
+        {
+        group_storage<2> cur_bond = d_group_list[group_idx];
+        unsigned int cur_bond_type = d_group_type[group_idx];
+
+        // read in the positions of both members (MEM TRANSFER: 32 bytes)
+        Scalar4 postype_a = texFetchScalar4(d_pos, pdata_pos_tex, cur_bond.idx[0]);
+        Scalar4 postype_b = texFetchScalar4(d_pos, pdata_pos_tex, cur_bond.idx[1]);
+
+        // calculate dr and apply periodic boundary conditions (FLOPS: 15)
+        Scalar3 dx = make_scalar3(postype_a.x, postype_a.y, postype_a.z)
+                     - make_scalar3(postype_b.x, postype_b.y, postype_b.z);
+        dx = box.minImage(dx);
+        const ForceReal3 dxf = make_forcereal3(dx);
+
+        Scalar rsq = dxf.x*dxf.x + dxf.y*dxf.y + dxf.z*dxf.z;
+
+        // evaluate the potential
+        Scalar force_divr = Scalar(0.0);
+        Scalar bond_eng = Scalar(0.0);
+
+        evaluator eval(rsq, s_params[cur_bond_type]);
+
+        if (evaluator::needsDiameter())
+            eval.setDiameter(texFetchScalar(d_diameter, pdata_diam_tex, cur_bond.idx[0]),
+                             texFetchScalar(d_diameter, pdata_diam_tex, cur_bond.idx[1]));
+        if (evaluator::needsCharge())
+            eval.setCharge(texFetchScalar(d_charge, pdata_charge_tex, cur_bond.idx[0]),
+                           texFetchScalar(d_charge, pdata_charge_tex, cur_bond.idx[1]));
+
+        if (eval.evalForceAndEnergy(force_divr, bond_eng))
+            {
+            idx[0] = cur_bond.idx[0];
+            idx[1] = cur_bond.idx[1];
+
+            // the energy and virial are split evenly between the members
+            ForceReal force_div2r = ForceReal(force_divr)/ForceReal(2.0);
+            Scalar bond_virial[6];
+            bond_virial[0] = dxf.x * dxf.x * force_div2r; // xx
+            bond_virial[1] = dxf.x * dxf.y * force_div2r; // xy
+            bond_virial[2] = dxf.x * dxf.z * force_div2r; // xz
+            bond_virial[3] = dxf.y * dxf.y * force_div2r; // yy
+            bond_virial[4] = dxf.y * dxf.z * force_div2r; // yz
+            bond_virial[5] = dxf.z * dxf.z * force_div2r; // zz
+
+            const ForceReal force_divr_f = ForceReal(force_divr);
+            force[0] = make_scalar4(dxf.x * force_divr_f, dxf.y * force_divr_f, dxf.z * force_divr_f,
+                                    compute_energy ? bond_eng * Scalar(0.5) : Scalar(0.0));
+            force[1] = make_scalar4(-force[0].x, -force[0].y, -force[0].z, force[0].w);
+            for (unsigned int i = 0; i < 6; ++i)
+                {
+                virial[0][i] = bond_virial[i];
+                virial[1][i] = bond_virial[i];
+                }
+            }
+        else
+            {
+            *d_flags = 1;
+            }
+        }
+
+    gpu_group_force_scatter<2>(idx, force, virial, N, d_force, d_virial, virial_pitch);
+    }
+
+//! Bind the particle data textures on pre sm35 devices
+/*! \param bond_args Arguments of the bond force computation
+
+    Textures are bound per device, so this is called on every active GPU. The function is static because the
+    textures are defined in every translation unit that includes this header.
+*/
+static inline cudaError_t gpu_bind_bond_textures(const bond_args_t& bond_args)
+    {
+    if (bond_args.compute_capability >= 350)
+        return cudaSuccess;
+
+    // bind the position texture
+    pdata_pos_tex.normalized = false;
+    pdata_pos_tex.filterMode = cudaFilterModePoint;
+    cudaError_t error = cudaBindTexture(0, pdata_pos_tex, bond_args.d_pos, sizeof(Scalar4)*(bond_args.n_max));
+    if (error != cudaSuccess)
+        return error;
+
+    // bind the diameter texture
+    pdata_diam_tex.normalized = false;
+    pdata_diam_tex.filterMode = cudaFilterModePoint;
+    error = cudaBindTexture(0, pdata_diam_tex, bond_args.d_diameter, sizeof(Scalar) *(bond_args.n_max));
+    if (error != cudaSuccess)
+        return error;
+
+    pdata_charge_tex.normalized = false;
+    pdata_charge_tex.filterMode = cudaFilterModePoint;
+    return cudaBindTexture(0, pdata_charge_tex, bond_args.d_charge, sizeof(Scalar) * (bond_args.n_max));
+    }
+
 #include <iostream>
-//! Kernel driver that computes lj forces on the GPU for LJForceComputeGPU
+//! Launches the bond force kernels of one energy variant
 /*! \param bond_args Other arguments to pass onto the kernel
     \param d_params Parameters for the potential, stored per bond type
     \param d_flags flags on the device - a 1 will be written if evaluation
                    of forces failed for any bond
 
-    This is just a driver function for gpu_compute_bond_forces_kernel(), see it for details.
+    \tparam compute_energy When zero, the potential energy is not computed and written as zero.
 */
-template< class evaluator >
-cudaError_t gpu_compute_bond_forces(const bond_args_t& bond_args,
-                                    const typename evaluator::param_type *d_params,
-                                    unsigned int *d_flags)
+template< class evaluator, unsigned int compute_energy >
+cudaError_t gpu_launch_bond_forces(const bond_args_t& bond_args,
+                                   const typename evaluator::param_type *d_params,
+                                   unsigned int *d_flags)
     {
-    assert(d_params);
-    assert(bond_args.n_bond_types > 0);
-
-    // check that block_size is valid
-    assert(bond_args.block_size != 0);
+    const bool group_centric = (bond_args.d_group_list != NULL);
 
     static unsigned int max_block_size = UINT_MAX;
+    static unsigned int max_block_size_group = UINT_MAX;
     if (max_block_size == UINT_MAX)
         {
         cudaFuncAttributes attr;
-        cudaFuncGetAttributes(&attr, gpu_compute_bond_forces_kernel<evaluator>);
+        cudaFuncGetAttributes(&attr, gpu_compute_bond_forces_kernel<evaluator, compute_energy>);
         max_block_size = attr.maxThreadsPerBlock;
+
+        cudaFuncGetAttributes(&attr, gpu_compute_bond_forces_group_kernel<evaluator, compute_energy>);
+        max_block_size_group = attr.maxThreadsPerBlock;
         }
 
-    unsigned int run_block_size = min(bond_args.block_size, max_block_size);
+    unsigned int run_block_size = min(bond_args.block_size, group_centric ? max_block_size_group : max_block_size);
+
+    // the warp-level scatter of the group-centric kernel needs complete warps
+    if (group_centric)
+        run_block_size = run_block_size & ~31u;
 
-    // setup the grid to run the kernel
-    dim3 grid( bond_args.N / run_block_size + 1, 1, 1);
     dim3 threads(run_block_size, 1, 1);
+    unsigned int shared_bytes = sizeof(typename evaluator::param_type) *
+                                bond_args.n_bond_types;
 
-    // bind the position texture on pre sm35 devices
-    if (bond_args.compute_capability < 350)
+    if (group_centric)
         {
-        pdata_pos_tex.normalized = false;
-        pdata_pos_tex.filterMode = cudaFilterModePoint;
-        cudaError_t error = cudaBindTexture(0, pdata_pos_tex, bond_args.d_pos, sizeof(Scalar4)*(bond_args.n_max));
+        // the group-centric table is not split between GPUs, it is evaluated on the current GPU
+        cudaError_t error = gpu_bind_bond_textures(bond_args);
         if (error != cudaSuccess)
             return error;
 
-        // bind the diameter texture
-        pdata_diam_tex.normalized = false;
-        pdata_diam_tex.filterMode = cudaFilterModePoint;
-        error = cudaBindTexture(0, pdata_diam_tex, bond_args.d_diameter, sizeof(Scalar) *(bond_args.n_max));
-        if (error != cudaSuccess)
-            return error;
+        // the group-centric kernel adds to the force and virial arrays
+        cudaMemsetAsync(bond_args.d_force, 0, sizeof(Scalar4)*bond_args.N, bond_args.stream);
+        cudaMemsetAsync(bond_args.d_virial, 0, sizeof(Scalar)*6*bond_args.virial_pitch, bond_args.stream);
+
+        dim3 grid(bond_args.n_groups / run_block_size + 1, 1, 1);
+        gpu_compute_bond_forces_group_kernel<evaluator, compute_energy><<<grid, threads, shared_bytes, bond_args.stream>>>(
+            bond_args.d_force, bond_args.d_virial, bond_args.virial_pitch, bond_args.N,
+            bond_args.d_pos, bond_args.d_charge, bond_args.d_diameter, bond_args.box, bond_args.d_group_list,
+            bond_args.d_group_type, bond_args.n_groups, bond_args.n_bond_types, d_params, d_flags);
+
+        return cudaSuccess;
+        }
 
-        pdata_charge_tex.normalized = false;
-        pdata_charge_tex.filterMode = cudaFilterModePoint;
-        error = cudaBindTexture(0, pdata_charge_tex, bond_args.d_charge, sizeof(Scalar) * (bond_args.n_max));
+    // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
+    for (int idev = bond_args.gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        auto range = bond_args.gpu_partition.getRangeAndSetGPU(idev);
+        unsigned int nwork = range.second - range.first;
+
+        // textures are bound per device
+        cudaError_t error = gpu_bind_bond_textures(bond_args);
         if (error != cudaSuccess)
             return error;
-        }
 
-    unsigned int shared_bytes = sizeof(typename evaluator::param_type) *
-                                bond_args.n_bond_types;
+        // setup the grid to run the kernel
+        dim3 grid(nwork / run_block_size + 1, 1, 1);
 
-    // run the kernel
-    gpu_compute_bond_forces_kernel<evaluator><<<grid, threads, shared_bytes>>>(
-        bond_args.d_force, bond_args.d_virial, bond_args.virial_pitch, bond_args.N,
-        bond_args.d_pos, bond_args.d_charge, bond_args.d_diameter, bond_args.box, bond_args.d_gpu_bondlist,
-        bond_args.gpu_table_indexer, bond_args.d_gpu_n_bonds, bond_args.n_bond_types, d_params, d_flags);
+        // run the kernel
+        gpu_compute_bond_forces_kernel<evaluator, compute_energy><<<grid, threads, shared_bytes, bond_args.stream>>>(
+            bond_args.d_force, bond_args.d_virial, bond_args.virial_pitch, nwork,
+            bond_args.d_pos, bond_args.d_charge, bond_args.d_diameter, bond_args.box, bond_args.d_gpu_bondlist,
+            bond_args.gpu_table_indexer, bond_args.d_gpu_n_bonds, bond_args.n_bond_types, d_params, d_flags,
+            range.first);
+        }
 
     return cudaSuccess;
     }
+
+//! Kernel driver that computes lj forces on the GPU for LJForceComputeGPU
+/*! \param bond_args Other arguments to pass onto the kernel
+    \param d_params Parameters for the potential, stored per bond type
+    \param d_flags flags on the device - a 1 will be written if evaluation
+                   of forces failed for any bond
+
+    This is just a driver function for gpu_compute_bond_forces_kernel(), see it for details. When bond_args holds a
+    group-centric bond list, gpu_compute_bond_forces_group_kernel() is launched instead. The kernels without the
+    energy are launched when bond_args.compute_energy is false.
+*/
+template< class evaluator >
+cudaError_t gpu_compute_bond_forces(const bond_args_t& bond_args,
+                                    const typename evaluator::param_type *d_params,
+                                    unsigned int *d_flags)
+    {
+    assert(d_params);
+    assert(bond_args.n_bond_types > 0);
+
+    // check that block_size is valid
+    assert(bond_args.block_size != 0);
+
+    if (bond_args.compute_energy)
+        return gpu_launch_bond_forces<evaluator, 1>(bond_args, d_params, d_flags);
+    else
+        return gpu_launch_bond_forces<evaluator, 0>(bond_args, d_params, d_flags);
+    }
 #endif
 
 #endif // __POTENTIAL_BOND_GPU_CUH__
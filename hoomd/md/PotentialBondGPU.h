@@ -24,7 +24,12 @@
 
 //! Template class for computing bond potentials on the GPU
 
-/*!
+/*! By default, every thread handles one particle and evaluates all bonds of that particle from the per-particle
+    group table, so that each bond is evaluated twice. In the group-centric mode (setGroupCentric()), every thread
+    evaluates one bond of the group-centric table of BondData and adds the forces on both members with
+    warp-aggregated atomics. The table follows the particle order, so its bonds stay cache friendly after the
+    particles are sorted.
+
     \tparam evaluator EvaluatorBond class used to evaluate V(r) and F(r)/r
     \tparam gpu_cgbf Driver function that calls gpu_compute_bond_forces<evaluator>()
 
@@ -53,9 +58,24 @@ class PotentialBondGPU : public PotentialBond<evaluator>
             m_tuner->setEnabled(enable);
             }
 
+        //! Evaluate every bond once
+        /*! \param group_centric True to evaluate the bonds with one thread per bond
+        */
+        void setGroupCentric(bool group_centric)
+            {
+            m_group_centric = group_centric;
+            }
+
+        //! Get whether every bond is evaluated once
+        bool getGroupCentric() const
+            {
+            return m_group_centric;
+            }
+
     protected:
         std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for block size
-        GPUArray<unsigned int> m_flags;       //!< Flags set during the kernel execution
+        GlobalArray<unsigned int> m_flags;    //!< Flags set during the kernel execution
+        bool m_group_centric;                 //!< True to evaluate the bonds with one thread per bond
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
@@ -66,7 +86,7 @@ template< class evaluator, cudaError_t gpu_cgbf(const bond_args_t& bond_args,
                                                 unsigned int *d_flags) >
 PotentialBondGPU< evaluator, gpu_cgbf >::PotentialBondGPU(std::shared_ptr<SystemDefinition> sysdef,
                                                           const std::string& log_suffix)
-    : PotentialBond<evaluator>(sysdef, log_suffix)
+    : PotentialBond<evaluator>(sysdef, log_suffix), m_group_centric(false)
     {
     // can't run on the GPU if there aren't any GPUs in the execution configuration
     if (!this->m_exec_conf->isCUDAEnabled())
@@ -76,11 +96,24 @@ PotentialBondGPU< evaluator, gpu_cgbf >::PotentialBondGPU(std::shared_ptr<System
         }
 
      // allocate and zero device memory
-    GPUArray<typename evaluator::param_type> params(this->m_bond_data->getNTypes(), this->m_exec_conf);
+    GlobalArray<typename evaluator::param_type> params(this->m_bond_data->getNTypes(), this->m_exec_conf);
     this->m_params.swap(params);
 
+    if (this->m_exec_conf->allConcurrentManagedAccess())
+        {
+        // the parameters are read by every GPU
+        auto& gpu_map = this->m_exec_conf->getGPUIds();
+
+        cudaMemAdvise(this->m_params.get(), this->m_params.getNumElements()*sizeof(typename evaluator::param_type),
+            cudaMemAdviseSetReadMostly, 0);
+        for (unsigned int idev = 0; idev < this->m_exec_conf->getNumActiveGPUs(); ++idev)
+            cudaMemPrefetchAsync(this->m_params.get(),
+                this->m_params.getNumElements()*sizeof(typename evaluator::param_type), gpu_map[idev]);
+        CHECK_CUDA_ERROR();
+        }
+
      // allocate flags storage on the GPU
-    GPUArray<unsigned int> flags(1, this->m_exec_conf);
+    GlobalArray<unsigned int> flags(1, this->m_exec_conf);
     m_flags.swap(flags);
 
     // reset flags
@@ -110,12 +143,27 @@ void PotentialBondGPU< evaluator, gpu_cgbf >::computeForces(unsigned int timeste
     // access parameters
     ArrayHandle<typename evaluator::param_type> d_params(this->m_params, access_location::device, access_mode::read);
 
+    // the energies are skipped when nothing reads them on this step, validateEnergies() recomputes them on demand
+    bool compute_energy = this->needsEnergies();
+    this->m_energies_valid = compute_energy;
+
     // access net force & virial
     ArrayHandle<Scalar4> d_force(this->m_force, access_location::device, access_mode::readwrite);
     ArrayHandle<Scalar> d_virial(this->m_virial, access_location::device, access_mode::readwrite);
 
         {
-        const GPUArray<typename BondData::members_t>& gpu_bond_list = this->m_bond_data->getGPUTable();
+        // the group-centric table is only built when it is used
+        std::unique_ptr< ArrayHandle<typename BondData::members_t> > d_group_list;
+        std::unique_ptr< ArrayHandle<unsigned int> > d_group_list_type;
+        if (m_group_centric)
+            {
+            d_group_list.reset(new ArrayHandle<typename BondData::members_t>(this->m_bond_data->getGPUGroupList(),
+                access_location::device, access_mode::read));
+            d_group_list_type.reset(new ArrayHandle<unsigned int>(this->m_bond_data->getGPUGroupListTypes(),
+                access_location::device, access_mode::read));
+            }
+
+        const GlobalVector<typename BondData::members_t>& gpu_bond_list = this->m_bond_data->getGPUTable();
         const Index2D& gpu_table_indexer = this->m_bond_data->getGPUTableIndexer();
 
         ArrayHandle<typename BondData::members_t> d_gpu_bondlist(gpu_bond_list, access_location::device, access_mode::read);
@@ -125,6 +173,7 @@ void PotentialBondGPU< evaluator, gpu_cgbf >::computeForces(unsigned int timeste
         // access the flags array for overwriting
         ArrayHandle<unsigned int> d_flags(m_flags, access_location::device, access_mode::readwrite);
 
+        this->m_exec_conf->beginMultiGPU();
         this->m_tuner->begin();
         gpu_cgbf(bond_args_t(d_force.data,
                              d_virial.data,
@@ -140,15 +189,24 @@ void PotentialBondGPU< evaluator, gpu_cgbf >::computeForces(unsigned int timeste
                              d_gpu_n_bonds.data,
                              this->m_bond_data->getNTypes(),
                              this->m_tuner->getParam(),
-                             this->m_exec_conf->getComputeCapability()),
+                             this->m_exec_conf->getComputeCapability(),
+                             this->m_pdata->getGPUPartition(),
+                             m_group_centric ? d_group_list->data : NULL,
+                             m_group_centric ? d_group_list_type->data : NULL,
+                             m_group_centric ? this->m_bond_data->getGPUGroupList().size() : 0,
+                             this->getStream(),
+                             compute_energy),
                  d_params.data,
                  d_flags.data);
+
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        this->m_tuner->end();
+        this->m_exec_conf->endMultiGPU();
         }
 
     if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
         {
-        CHECK_CUDA_ERROR();
-
         // check the flags for any errors
         ArrayHandle<unsigned int> h_flags(m_flags, access_location::host, access_mode::read);
 
@@ -158,7 +216,6 @@ void PotentialBondGPU< evaluator, gpu_cgbf >::computeForces(unsigned int timeste
             throw std::runtime_error("Error in bond calculation");
             }
         }
-    this->m_tuner->end();
 
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
     }
@@ -172,6 +229,8 @@ template < class T, class Base > void export_PotentialBondGPU(pybind11::module&
     {
      pybind11::class_<T, std::shared_ptr<T> >(m, name.c_str(), pybind11::base<Base>())
             .def(pybind11::init< std::shared_ptr<SystemDefinition>, const std::string& >())
+            .def("setGroupCentric", &T::setGroupCentric)
+            .def("getGroupCentric", &T::getGroupCentric)
             ;
     }
 
@@ -10,6 +10,8 @@
 #include <iostream>
 #include <stdexcept>
 #include <memory>
+#include <vector>
+#include <algorithm>
 #include <hoomd/extern/pybind/include/pybind11/pybind11.h>
 #include "hoomd/extern/pybind/include/pybind11/numpy.h"
 
@@ -17,16 +19,24 @@
 #include "hoomd/Index1D.h"
 #include "hoomd/GlobalArray.h"
 #include "hoomd/ForceCompute.h"
+#include "hoomd/CellList.h"
 #include "NeighborList.h"
+#include "PairEvaluatorBatch.h"
+#include "CellPairCandidates.h"
 
 #ifdef ENABLE_CUDA
 #include <cuda_runtime.h>
+#include "hoomd/CellListGPU.h"
 #endif
 
 #ifdef ENABLE_MPI
 #include "hoomd/Communicator.h"
 #endif
 
+#ifdef ENABLE_TBB
+#include <tbb/tbb.h>
+#endif
+
 
 /*! \file PotentialPair.h
     \brief Defines the template class for standard pair potentials
@@ -77,6 +87,37 @@
     potential evaluator class passed in. See the appropriate documentation for the evaluator for the definition of each
     element of the parameters.
 
+    The neighbors of each particle are processed in batches of HOOMD_PAIR_BATCH_SIZE. Evaluators that specialize
+    PairEvaluatorBatch compute the forces of a whole batch in one vectorizable loop, all others are called once per
+    neighbor as usual.
+
+    In builds with ENABLE_TBB, the loop over local particles is distributed over the TBB threads. With a full neighbor
+    list, every thread only writes to the particles it owns. With a half neighbor list, the particles are split into
+    one fixed chunk per thread, and the reaction forces on neighbors j are accumulated into force and virial buffers
+    per chunk. The buffers are kept between calls and summed in chunk order after the loop, so that the forces do not
+    depend on the scheduling of the threads. With a single thread, the forces are added directly.
+
+    In MPI simulations on the CPU, the forces are computed in two phases on steps without particle migration. While the
+    ghost update is in flight, the Communicator calls computeInteriorForces(), which evaluates all particles whose
+    neighbors are local (the interior). computeForces() then only evaluates the remaining (boundary) particles once
+    the ghost positions have arrived. The split is skipped whenever the neighbor list is about to be rebuilt. The
+    interior phase only reads the local rows of the position arrays, the ghost rows are copied once they are complete.
+    Only the exchange in the last communication direction is in flight during the interior phase (see
+    Communicator::getInteriorComputeCallbackSignal()), so only the latency of one of the up to six directional
+    exchanges is hidden behind the interior forces.
+
+    In the cell-pair mode (setCellPairs()), the neighbor list is neither built nor stored. The forces are evaluated
+    directly from the particles in the adjacent cells of a cell list with a width of the largest cutoff of this
+    potential, which is rebuilt every step. This trades more distance checks for no neighbor list memory and no
+    rebuild logic, which pays off when the neighbor list would be rebuilt nearly every step anyway (e.g. soft DPD
+    fluids). The exclusions and body filter of the neighbor list are still honored. Every pair is evaluated twice
+    (full mode), and the cell-pair mode is not available in MPI simulations.
+
+    With setSpecialPairScale(), the special pairs that the neighbor list flags (see
+    NeighborList::addSpecialPairsFromPairs()) are evaluated with this potential in the same pass as all other pairs,
+    and their force, energy and virial are multiplied by the scale factor. The special pairs are not supported in the
+    cell-pair mode.
+
     For profiling and logging, PotentialPair needs to know the name of the potential. For now, that will be queried from
     the evaluator. Perhaps in the future we could allow users to change that so multiple pair potentials could be logged
     independently.
@@ -123,9 +164,33 @@ class PotentialPair : public ForceCompute
             m_shift_mode = mode;
             }
 
+        //! Enable or disable the evaluation directly from a cell list
+        void setCellPairs(bool cell_pairs);
+
+        //! Scale the contribution of the special pairs of the neighbor list
+        void setSpecialPairScale(Scalar scale);
+
+        //! Pair potentials can add their forces directly to the net force
+        virtual bool supportsNetForceAccumulation()
+            {
+            return true;
+            }
+
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
+
+        //! Set the communicator to use
+        virtual void setCommunicator(std::shared_ptr<Communicator> comm);
+
+        //! The half-shell ghost exchange is supported with the neighbor list
+        virtual bool supportsHalfShell()
+            {
+            return !m_cl;
+            }
+
+        //! Compute the forces on the interior particles while the ghost update is in flight
+        void computeInteriorForces(unsigned int timestep);
         #endif
 
         //! Calculates the energy between two lists of particles.
@@ -147,9 +212,41 @@ class PotentialPair : public ForceCompute
         std::string m_prof_name;                    //!< Cached profiler name
         std::string m_log_name;                     //!< Cached log name
 
+        bool m_overlap_ghost_update;                //!< True if the interior is computed during the ghost update
+        bool m_interior_computed;                   //!< True if the interior forces are current
+        unsigned int m_interior_timestep;           //!< Time step of the interior forces
+        std::vector<unsigned char> m_boundary;      //!< Flag per local particle, nonzero if it has ghost neighbors
+
+        std::shared_ptr<CellList> m_cl;             //!< Cell list of the cell-pair mode, NULL if the nlist is used
+
+        #ifdef ENABLE_TBB
+        std::vector< std::vector<Scalar4> > m_force_chunk; //!< Reaction forces per chunk with a half nlist, kept zeroed
+        std::vector< std::vector<Scalar> > m_virial_chunk; //!< Reaction virials per chunk with a half nlist, kept zeroed
+        #endif
+
+        Scalar m_special_scale;                     //!< Scale factor of the special pairs
+        bool m_special_pairs;                       //!< True if the special pairs of the nlist are scaled
+
+        //! Particles that are evaluated by computePairForces()
+        enum computePhase
+            {
+            phase_all = 0,      //!< All local particles
+            phase_interior,     //!< Only particles without ghost neighbors, starting from zero forces
+            phase_boundary      //!< Only particles with ghost neighbors, adding to the interior forces
+            };
+
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
 
+        //! Evaluate the pair forces on a subset of the local particles
+        void computePairForces(unsigned int timestep, computePhase phase);
+
+        //! Update the cell list of the cell-pair mode
+        void computeCellList(unsigned int timestep);
+
+        //! Get the cell width needed by the cell-pair mode
+        Scalar getCellPairWidth();
+
         //! Method to be called when number of types changes
         virtual void slotNumTypesChange()
             {
@@ -201,7 +298,9 @@ template < class evaluator >
 PotentialPair< evaluator >::PotentialPair(std::shared_ptr<SystemDefinition> sysdef,
                                                 std::shared_ptr<NeighborList> nlist,
                                                 const std::string& log_suffix)
-    : ForceCompute(sysdef), m_nlist(nlist), m_shift_mode(no_shift), m_typpair_idx(m_pdata->getNTypes())
+    : ForceCompute(sysdef), m_nlist(nlist), m_shift_mode(no_shift), m_typpair_idx(m_pdata->getNTypes()),
+      m_overlap_ghost_update(!m_exec_conf->isCUDAEnabled()), m_interior_computed(false), m_interior_timestep(0),
+      m_special_scale(1.0), m_special_pairs(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing PotentialPair<" << evaluator::getName() << ">" << std::endl;
 
@@ -249,6 +348,11 @@ PotentialPair< evaluator >::~PotentialPair()
     m_exec_conf->msg->notice(5) << "Destroying PotentialPair<" << evaluator::getName() << ">" << std::endl;
 
     m_pdata->getNumTypesChangeSignal().template disconnect<PotentialPair<evaluator>, &PotentialPair<evaluator>::slotNumTypesChange>(this);
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        m_comm->getInteriorComputeCallbackSignal().template disconnect<PotentialPair<evaluator>, &PotentialPair<evaluator>::computeInteriorForces>(this);
+    #endif
     }
 
 /*! \param typ1 First type index in the pair
@@ -314,6 +418,132 @@ void PotentialPair< evaluator >::setRon(unsigned int typ1, unsigned int typ2, Sc
     h_ronsq.data[m_typpair_idx(typ2, typ1)] = ron * ron;
     }
 
+/*! \param cell_pairs True if the forces are evaluated directly from a cell list, false to use the neighbor list
+
+    The cell list is created on the first call. When the cell-pair mode is enabled, this potential no longer updates
+    the neighbor list, but the exclusions and the body filter set on it remain in effect.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::setCellPairs(bool cell_pairs)
+    {
+    if (!cell_pairs)
+        {
+        m_cl = std::shared_ptr<CellList>();
+        return;
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        m_exec_conf->msg->error() << "pair." << evaluator::getName() << ": cell_pairs is not supported in MPI simulations"
+                                  << std::endl;
+        throw std::runtime_error("Error setting up the cell-pair mode");
+        }
+    #endif
+
+    if (m_special_pairs)
+        {
+        m_exec_conf->msg->error() << "pair." << evaluator::getName() << ": cell_pairs is not supported with special "
+                                  << "pair scaling" << std::endl;
+        throw std::runtime_error("Error setting up the cell-pair mode");
+        }
+
+    if (m_cl)
+        return;
+
+    #ifdef ENABLE_CUDA
+    if (m_exec_conf->isCUDAEnabled())
+        m_cl = std::shared_ptr<CellList>(new CellListGPU(m_sysdef));
+    else
+    #endif
+        m_cl = std::shared_ptr<CellList>(new CellList(m_sysdef));
+
+    m_cl->setRadius(1);
+    m_cl->setComputeXYZF(true);
+    m_cl->setComputeTDB(false);
+    m_cl->setFlagIndex();
+    }
+
+/*! \param scale Scale factor of the force, energy and virial of the special pairs
+
+    The special pairs must have been added to the neighbor list with NeighborList::addSpecialPairsFromPairs().
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::setSpecialPairScale(Scalar scale)
+    {
+    if (m_cl)
+        {
+        m_exec_conf->msg->error() << "pair." << evaluator::getName() << ": special pair scaling is not supported "
+                                  << "with cell_pairs" << std::endl;
+        throw std::runtime_error("Error setting the special pair scale");
+        }
+
+    m_special_scale = scale;
+    m_special_pairs = true;
+    }
+
+/*! \returns The largest cutoff of this potential, extended by the diameter shift of the neighbor list
+*/
+template< class evaluator >
+Scalar PotentialPair< evaluator >::getCellPairWidth()
+    {
+    ArrayHandle<Scalar> h_rcutsq(m_rcutsq, access_location::host, access_mode::read);
+
+    Scalar rcutsq_max = Scalar(0.0);
+    for (unsigned int cur_pair = 0; cur_pair < m_typpair_idx.getNumElements(); cur_pair++)
+        rcutsq_max = std::max(rcutsq_max, h_rcutsq.data[cur_pair]);
+
+    Scalar width = fast::sqrt(rcutsq_max);
+    if (m_nlist->getDiameterShift())
+        width += m_nlist->getMaximumDiameter() - Scalar(1.0);
+
+    return width;
+    }
+
+/*! \param timestep Current time step
+
+    The nominal width follows the cutoffs, which may change between runs. The cell list is only reallocated when the
+    width actually changes.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::computeCellList(unsigned int timestep)
+    {
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        m_exec_conf->msg->error() << "pair." << evaluator::getName() << ": cell_pairs is not supported in MPI simulations"
+                                  << std::endl;
+        throw std::runtime_error("Error computing pair forces");
+        }
+    #endif
+
+    Scalar width = getCellPairWidth();
+    if (width <= Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "pair." << evaluator::getName() << ": cell_pairs requires a positive r_cut"
+                                  << std::endl;
+        throw std::runtime_error("Error computing pair forces");
+        }
+
+    if (width != m_cl->getNominalWidth())
+        m_cl->setNominalWidth(width);
+
+    // validate that the cutoff fits inside the box
+    const BoxDim& box = m_pdata->getBox();
+    Scalar3 nearest_plane_distance = box.getNearestPlaneDistance();
+    if ((box.getPeriodic().x && nearest_plane_distance.x <= width * 2.0) ||
+        (box.getPeriodic().y && nearest_plane_distance.y <= width * 2.0) ||
+        (this->m_sysdef->getNDimensions() == 3 && box.getPeriodic().z && nearest_plane_distance.z <= width * 2.0))
+        {
+        m_exec_conf->msg->error() << "pair." << evaluator::getName()
+                                  << ": Simulation box is too small! Particles would be interacting with themselves."
+                                  << std::endl;
+        throw std::runtime_error("Error computing pair forces");
+        }
+
+    m_cl->compute(timestep);
+    }
+
 /*! PotentialPair provides:
      - \c pair_"name"_energy
     where "name" is replaced with evaluator::getName()
@@ -353,15 +583,61 @@ Scalar PotentialPair< evaluator >::getLogValue(const std::string& quantity, unsi
 template< class evaluator >
 void PotentialPair< evaluator >::computeForces(unsigned int timestep)
     {
+    if (m_cl)
+        {
+        // the cell-pair mode does not use the neighbor list at all
+        computeCellList(timestep);
+        m_interior_computed = false;
+        computePairForces(timestep, phase_all);
+        return;
+        }
+
     // start by updating the neighborlist
     m_nlist->compute(timestep);
 
+    // only the boundary particles are left if the interior has been computed during the ghost update
+    if (m_interior_computed && m_interior_timestep == timestep)
+        {
+        m_interior_computed = false;
+        computePairForces(timestep, phase_boundary);
+        }
+    else
+        {
+        m_interior_computed = false;
+        computePairForces(timestep, phase_all);
+        }
+    }
+
+/*! \param timestep specifies the current time step of the simulation
+    \param phase Subset of the particles to evaluate
+
+    With \a phase_all and \a phase_interior, the force and virial arrays are zeroed first. \a phase_interior also
+    classifies the local particles into interior and boundary particles, which \a phase_boundary relies on.
+
+    \pre The neighbor list is current, or the cell list in the cell-pair mode.
+*/
+template< class evaluator >
+void PotentialPair< evaluator >::computePairForces(unsigned int timestep, computePhase phase)
+    {
     // start the profile for this compute
     if (m_prof) m_prof->push(m_prof_name);
 
+    // positions and types of local and ghost particles, in structure-of-arrays layout for streaming access
+    // the interior phase runs while the ghost positions are still being received, it must only read the local rows
+    const PositionsSoA& pos_soa = m_pdata->getPositionsSoA(timestep, phase != phase_interior);
+
     // depending on the neighborlist settings, we can take advantage of newton's third law
     // to reduce computations at the cost of memory access complexity: set that flag now
-    bool third_law = m_nlist->getStorageMode() == NeighborList::half;
+    // the cell-pair mode always evaluates every pair from both sides
+    bool third_law = !m_cl && m_nlist->getStorageMode() == NeighborList::half;
+
+    // with the half-shell ghost exchange, the pairs with ghosts are only evaluated on this rank, the force is added to
+    // the ghost and sent back to its owner, and the whole energy and virial of the pair go to the local particle
+    #ifdef ENABLE_MPI
+    const bool half_shell = third_law && m_comm && m_comm->getHalfShell();
+    #else
+    const bool half_shell = false;
+    #endif
 
     // access the neighbor list, particle data, and system box
     ArrayHandle<unsigned int> h_n_neigh(m_nlist->getNNeighArray(), access_location::host, access_mode::read);
@@ -369,14 +645,23 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
 //     Index2D nli = m_nlist->getNListIndexer();
     ArrayHandle<unsigned int> h_head_list(m_nlist->getHeadList(), access_location::host, access_mode::read);
 
-    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_diameter(m_pdata->getDiameters(), access_location::host, access_mode::read);
     ArrayHandle<Scalar> h_charge(m_pdata->getCharges(), access_location::host, access_mode::read);
 
+    // the special pairs are flagged by tag in the neighbor list masks
+    const bool special_pairs = m_special_pairs && !m_cl && m_nlist->getSpecialPairsSet();
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_sp_mask(m_nlist->getSpecialPairMaskArray(), access_location::host, access_mode::read);
+
 
-    //force arrays
-    ArrayHandle<Scalar4> h_force(m_force,access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar>  h_virial(m_virial,access_location::host, access_mode::overwrite);
+    //force arrays, the boundary phase adds to the interior forces, and the forces may be added to the net force
+    const bool accumulate = (phase == phase_boundary) || m_accumulate_net_force;
+    const access_mode::Enum force_mode = accumulate ? access_mode::readwrite : access_mode::overwrite;
+    const GlobalArray<Scalar4>& force_target = getForceTarget();
+    const GlobalArray<Scalar>& virial_target = getVirialTarget();
+    ArrayHandle<Scalar4> h_force(force_target,access_location::host, force_mode);
+    ArrayHandle<Scalar>  h_virial(virial_target,access_location::host, force_mode);
+    const unsigned int target_virial_pitch = virial_target.getPitch();
 
 
     const BoxDim& box = m_pdata->getGlobalBox();
@@ -387,180 +672,397 @@ void PotentialPair< evaluator >::computeForces(unsigned int timestep)
     PDataFlags flags = this->m_pdata->getFlags();
     bool compute_virial = flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial];
 
-    // need to start from a zero force, energy and virial
-    memset((void*)h_force.data,0,sizeof(Scalar4)*m_force.getNumElements());
-    memset((void*)h_virial.data,0,sizeof(Scalar)*m_virial.getNumElements());
+    // the energies are skipped when nothing reads them on this step, validateEnergies() recomputes them on demand
+    const bool compute_energy = needsEnergies();
+    m_energies_valid = compute_energy;
 
-    // for each particle
-    for (int i = 0; i < (int)m_pdata->getN(); i++)
+    // need to start from a zero force, energy and virial
+    if (!accumulate)
         {
-        // access the particle's position and type (MEM TRANSFER: 4 scalars)
-        Scalar3 pi = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
-        unsigned int typei = __scalar_as_int(h_pos.data[i].w);
+        memset((void*)h_force.data,0,sizeof(Scalar4)*force_target.getNumElements());
+        memset((void*)h_virial.data,0,sizeof(Scalar)*virial_target.getNumElements());
+        }
 
-        // sanity check
-        assert(typei < m_pdata->getNTypes());
+    const unsigned int N = m_pdata->getN();
 
-        // access diameter and charge (if needed)
-        Scalar di = Scalar(0.0);
-        Scalar qi = Scalar(0.0);
-        if (evaluator::needsDiameter())
-            di = h_diameter.data[i];
-        if (evaluator::needsCharge())
-            qi = h_charge.data[i];
+    // number of particles that the third law adds forces to
+    const unsigned int n_third_law = half_shell ? N + m_pdata->getNGhosts() : N;
 
-        // initialize current particle force, potential energy, and virial to 0
-        Scalar3 fi = make_scalar3(0, 0, 0);
-        Scalar pei = 0.0;
-        Scalar virialxxi = 0.0;
-        Scalar virialxyi = 0.0;
-        Scalar virialxzi = 0.0;
-        Scalar virialyyi = 0.0;
-        Scalar virialyzi = 0.0;
-        Scalar virialzzi = 0.0;
-
-        // loop over all of the neighbors of this particle
-        const unsigned int myHead = h_head_list.data[i];
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
-        for (unsigned int k = 0; k < size; k++)
+    if (phase == phase_interior)
+        {
+        // flag the particles that have ghost neighbors
+        m_boundary.resize(N);
+        for (unsigned int i = 0; i < N; i++)
             {
-            // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int j = h_nlist.data[myHead + k];
-            assert(j < m_pdata->getN() + m_pdata->getNGhosts());
+            const unsigned int myHead = h_head_list.data[i];
+            const unsigned int size = (unsigned int)h_n_neigh.data[i];
+            unsigned char has_ghost = 0;
+            for (unsigned int k = 0; k < size; k++)
+                has_ghost |= (h_nlist.data[myHead + k] >= N);
+            m_boundary[i] = has_ghost;
+            }
+        }
+    assert(phase == phase_all || m_boundary.size() == N);
+    const unsigned char *boundary = (phase == phase_all) ? NULL : &m_boundary.front();
+
+    // in the cell-pair mode, the neighbors are gathered from the cell list per particle
+    std::unique_ptr<CellPairCandidates> cell_candidates;
+    if (m_cl)
+        cell_candidates.reset(new CellPairCandidates(*m_cl, *m_nlist, *m_pdata, m_typpair_idx, h_rcutsq.data));
+
+    // use the batched evaluator when it is available and applicable
+    const bool use_batch = PairEvaluatorBatch<evaluator>::enabled && !evaluator::needsDiameter()
+                           && !evaluator::needsCharge() && m_shift_mode != xplor;
+
+    // evaluate the particles [begin, end), the reaction forces on the neighbors are added to force_data and virial_data
+    auto compute_range = [&] (unsigned int begin,
+                              unsigned int end,
+                              Scalar4 *force_data,
+                              Scalar *virial_data,
+                              unsigned int virial_pitch,
+                              std::vector<unsigned int>& candidates)
+        {
+        for (unsigned int i = begin; i < end; i++)
+            {
+            // skip the particles that are evaluated in the other phase
+            if (boundary && (boundary[i] != 0) != (phase == phase_boundary))
+                continue;
 
-            // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
-            Scalar3 pj = make_scalar3(h_pos.data[j].x, h_pos.data[j].y, h_pos.data[j].z);
-            Scalar3 dx = pi - pj;
+            // access the particle's position and type (MEM TRANSFER: 4 scalars)
+            Scalar3 pi = make_scalar3(pos_soa.x[i], pos_soa.y[i], pos_soa.z[i]);
+            unsigned int typei = pos_soa.type[i];
 
-            // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
-            unsigned int typej = __scalar_as_int(h_pos.data[j].w);
-            assert(typej < m_pdata->getNTypes());
+            // sanity check
+            assert(typei < m_pdata->getNTypes());
 
             // access diameter and charge (if needed)
-            Scalar dj = Scalar(0.0);
-            Scalar qj = Scalar(0.0);
+            Scalar di = Scalar(0.0);
+            Scalar qi = Scalar(0.0);
             if (evaluator::needsDiameter())
-                dj = h_diameter.data[j];
+                di = h_diameter.data[i];
             if (evaluator::needsCharge())
-                qj = h_charge.data[j];
-
-            // apply periodic boundary conditions
-            dx = box.minImage(dx);
-
-            // calculate r_ij squared (FLOPS: 5)
-            Scalar rsq = dot(dx, dx);
-
-            // get parameters for this type pair
-            unsigned int typpair_idx = m_typpair_idx(typei, typej);
-            param_type param = h_params.data[typpair_idx];
-            Scalar rcutsq = h_rcutsq.data[typpair_idx];
-            Scalar ronsq = Scalar(0.0);
-            if (m_shift_mode == xplor)
-                ronsq = h_ronsq.data[typpair_idx];
-
-            // design specifies that energies are shifted if
-            // 1) shift mode is set to shift
-            // or 2) shift mode is explor and ron > rcut
-            bool energy_shift = false;
-            if (m_shift_mode == shift)
-                energy_shift = true;
-            else if (m_shift_mode == xplor)
+                qi = h_charge.data[i];
+
+            // special pair mask and tag of particle i
+            const unsigned int sp_mask_i = special_pairs ? h_sp_mask.data[i] : 0;
+            const unsigned int tag_i = h_tag.data[i];
+
+            // initialize current particle force, potential energy, and virial to 0
+            Scalar3 fi = make_scalar3(0, 0, 0);
+            Scalar pei = 0.0;
+            Scalar virialxxi = 0.0;
+            Scalar virialxyi = 0.0;
+            Scalar virialxzi = 0.0;
+            Scalar virialyyi = 0.0;
+            Scalar virialyzi = 0.0;
+            Scalar virialzzi = 0.0;
+
+            // loop over all of the neighbors of this particle, in batches
+            const unsigned int *neighbors = h_nlist.data + h_head_list.data[i];
+            unsigned int size = (unsigned int)h_n_neigh.data[i];
+            if (cell_candidates)
                 {
-                if (ronsq > rcutsq)
-                    energy_shift = true;
+                cell_candidates->gather(i, candidates);
+                neighbors = candidates.data();
+                size = (unsigned int)candidates.size();
                 }
 
-            // compute the force and potential energy
-            Scalar force_divr = Scalar(0.0);
-            Scalar pair_eng = Scalar(0.0);
-            evaluator eval(rsq, rcutsq, param);
-            if (evaluator::needsDiameter())
-                eval.setDiameter(di, dj);
-            if (evaluator::needsCharge())
-                eval.setCharge(qi, qj);
-
-            bool evaluated = eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
-
-            if (evaluated)
+            for (unsigned int k_start = 0; k_start < size; k_start += HOOMD_PAIR_BATCH_SIZE)
                 {
-                // modify the potential for xplor shifting
-                if (m_shift_mode == xplor)
+                const unsigned int n_batch = std::min(size - k_start, (unsigned int)HOOMD_PAIR_BATCH_SIZE);
+
+                unsigned int batch_j[HOOMD_PAIR_BATCH_SIZE];
+                unsigned int batch_typpair[HOOMD_PAIR_BATCH_SIZE];
+                Scalar3 batch_dx[HOOMD_PAIR_BATCH_SIZE];
+                Scalar batch_rsq[HOOMD_PAIR_BATCH_SIZE];
+                Scalar batch_rcutsq[HOOMD_PAIR_BATCH_SIZE];
+                param_type batch_param[HOOMD_PAIR_BATCH_SIZE];
+                Scalar batch_force_divr[HOOMD_PAIR_BATCH_SIZE];
+                Scalar batch_pair_eng[HOOMD_PAIR_BATCH_SIZE];
+                bool batch_evaluated[HOOMD_PAIR_BATCH_SIZE];
+
+                // gather the separations and parameters of the neighbors in this batch
+                for (unsigned int b = 0; b < n_batch; b++)
                     {
-                    if (rsq >= ronsq && rsq < rcutsq)
+                    // access the index of this neighbor (MEM TRANSFER: 1 scalar)
+                    unsigned int j = neighbors[k_start + b];
+                    assert(j < m_pdata->getN() + m_pdata->getNGhosts());
+                    assert(phase != phase_interior || j < N);
+
+                    // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
+                    Scalar3 pj = make_scalar3(pos_soa.x[j], pos_soa.y[j], pos_soa.z[j]);
+                    Scalar3 dx = pi - pj;
+
+                    // access the type of the neighbor particle (MEM TRANSFER: 1 scalar)
+                    unsigned int typej = pos_soa.type[j];
+                    assert(typej < m_pdata->getNTypes());
+
+                    // apply periodic boundary conditions
+                    dx = box.minImage(dx);
+
+                    // get parameters for this type pair
+                    unsigned int typpair_idx = m_typpair_idx(typei, typej);
+
+                    batch_j[b] = j;
+                    batch_typpair[b] = typpair_idx;
+                    batch_dx[b] = dx;
+                    // calculate r_ij squared (FLOPS: 5)
+                    batch_rsq[b] = dot(dx, dx);
+                    batch_rcutsq[b] = h_rcutsq.data[typpair_idx];
+                    batch_param[b] = h_params.data[typpair_idx];
+                    }
+
+                if (use_batch)
+                    {
+                    // compute the forces and potential energies of the whole batch at once
+                    PairEvaluatorBatch<evaluator>::evalForceAndEnergy(n_batch,
+                                                                      batch_rsq,
+                                                                      batch_rcutsq,
+                                                                      batch_param,
+                                                                      compute_energy && m_shift_mode == shift,
+                                                                      batch_force_divr,
+                                                                      batch_pair_eng);
+                    for (unsigned int b = 0; b < n_batch; b++)
+                        batch_evaluated[b] = true;
+                    }
+                else
+                    {
+                    for (unsigned int b = 0; b < n_batch; b++)
                         {
-                        // Implement XPLOR smoothing (FLOPS: 16)
-                        Scalar old_pair_eng = pair_eng;
-                        Scalar old_force_divr = force_divr;
+                        unsigned int j = batch_j[b];
+                        Scalar rsq = batch_rsq[b];
+                        Scalar rcutsq = batch_rcutsq[b];
+
+                        // access diameter and charge (if needed)
+                        Scalar dj = Scalar(0.0);
+                        Scalar qj = Scalar(0.0);
+                        if (evaluator::needsDiameter())
+                            dj = h_diameter.data[j];
+                        if (evaluator::needsCharge())
+                            qj = h_charge.data[j];
+
+                        Scalar ronsq = Scalar(0.0);
+                        if (m_shift_mode == xplor)
+                            ronsq = h_ronsq.data[batch_typpair[b]];
+
+                        // design specifies that energies are shifted if
+                        // 1) shift mode is set to shift
+                        // or 2) shift mode is explor and ron > rcut
+                        // the shift only changes the energy, it is skipped when the energy is not computed
+                        bool energy_shift = false;
+                        if (m_shift_mode == shift && compute_energy)
+                            energy_shift = true;
+                        else if (m_shift_mode == xplor && compute_energy)
+                            {
+                            if (ronsq > rcutsq)
+                                energy_shift = true;
+                            }
+
+                        // compute the force and potential energy
+                        Scalar force_divr = Scalar(0.0);
+                        Scalar pair_eng = Scalar(0.0);
+                        evaluator eval(rsq, rcutsq, batch_param[b]);
+                        if (evaluator::needsDiameter())
+                            eval.setDiameter(di, dj);
+                        if (evaluator::needsCharge())
+                            eval.setCharge(qi, qj);
+
+                        bool evaluated = eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
+
+                        // modify the potential for xplor shifting
+                        if (evaluated && m_shift_mode == xplor)
+                            {
+                            if (rsq >= ronsq && rsq < rcutsq)
+                                {
+                                // Implement XPLOR smoothing (FLOPS: 16)
+                                Scalar old_pair_eng = pair_eng;
+                                Scalar old_force_divr = force_divr;
+
+                                // calculate 1.0 / (xplor denominator)
+                                Scalar xplor_denom_inv =
+                                    Scalar(1.0) / ((rcutsq - ronsq) * (rcutsq - ronsq) * (rcutsq - ronsq));
+
+                                Scalar rsq_minus_r_cut_sq = rsq - rcutsq;
+                                Scalar s = rsq_minus_r_cut_sq * rsq_minus_r_cut_sq *
+                                           (rcutsq + Scalar(2.0) * rsq - Scalar(3.0) * ronsq) * xplor_denom_inv;
+                                Scalar ds_dr_divr = Scalar(12.0) * (rsq - ronsq) * rsq_minus_r_cut_sq * xplor_denom_inv;
+
+                                // make modifications to the old pair energy and force
+                                pair_eng = old_pair_eng * s;
+                                // note: I'm not sure why the minus sign needs to be there: my notes have a +
+                                // But this is verified correct via plotting
+                                force_divr = s * old_force_divr - ds_dr_divr * old_pair_eng;
+                                }
+                            }
+
+                        batch_force_divr[b] = force_divr;
+                        batch_pair_eng[b] = pair_eng;
+                        batch_evaluated[b] = evaluated;
+                        }
+                    }
 
-                        // calculate 1.0 / (xplor denominator)
-                        Scalar xplor_denom_inv =
-                            Scalar(1.0) / ((rcutsq - ronsq) * (rcutsq - ronsq) * (rcutsq - ronsq));
+                // accumulate the results of the batch
+                for (unsigned int b = 0; b < n_batch; b++)
+                    {
+                    if (!batch_evaluated[b])
+                        continue;
 
-                        Scalar rsq_minus_r_cut_sq = rsq - rcutsq;
-                        Scalar s = rsq_minus_r_cut_sq * rsq_minus_r_cut_sq *
-                                   (rcutsq + Scalar(2.0) * rsq - Scalar(3.0) * ronsq) * xplor_denom_inv;
-                        Scalar ds_dr_divr = Scalar(12.0) * (rsq - ronsq) * rsq_minus_r_cut_sq * xplor_denom_inv;
+                    unsigned int j = batch_j[b];
+                    Scalar3 dx = batch_dx[b];
+                    Scalar force_divr = batch_force_divr[b];
+                    Scalar pair_eng = batch_pair_eng[b];
 
-                        // make modifications to the old pair energy and force
-                        pair_eng = old_pair_eng * s;
-                        // note: I'm not sure why the minus sign needs to be there: my notes have a +
-                        // But this is verified correct via plotting
-                        force_divr = s * old_force_divr - ds_dr_divr * old_pair_eng;
+                    // scale the contribution of a special pair
+                    if (sp_mask_i && isExcludedByMask(sp_mask_i, tag_i, h_tag.data[j]))
+                        {
+                        force_divr *= m_special_scale;
+                        pair_eng *= m_special_scale;
                         }
-                    }
 
-                Scalar force_div2r = force_divr * Scalar(0.5);
-                // add the force, potential energy and virial to the particle i
-                // (FLOPS: 8)
-                fi += dx*force_divr;
-                pei += pair_eng * Scalar(0.5);
-                if (compute_virial)
-                    {
-                    virialxxi += force_div2r*dx.x*dx.x;
-                    virialxyi += force_div2r*dx.x*dx.y;
-                    virialxzi += force_div2r*dx.x*dx.z;
-                    virialyyi += force_div2r*dx.y*dx.y;
-                    virialyzi += force_div2r*dx.y*dx.z;
-                    virialzzi += force_div2r*dx.z*dx.z;
-                    }
+                    // a pair with a ghost in the half-shell exchange is not evaluated by the owner of the ghost
+                    const bool ghost_pair = half_shell && j >= N;
 
-                // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
-                // only add force to local particles
-                if (third_law && j < m_pdata->getN())
-                    {
-                    unsigned int mem_idx = j;
-                    h_force.data[mem_idx].x -= dx.x*force_divr;
-                    h_force.data[mem_idx].y -= dx.y*force_divr;
-                    h_force.data[mem_idx].z -= dx.z*force_divr;
-                    h_force.data[mem_idx].w += pair_eng * Scalar(0.5);
+                    Scalar force_div2r = ghost_pair ? force_divr : force_divr * Scalar(0.5);
+                    // add the force, potential energy and virial to the particle i
+                    // (FLOPS: 8)
+                    fi += dx*force_divr;
+                    if (compute_energy)
+                        pei += ghost_pair ? pair_eng : pair_eng * Scalar(0.5);
                     if (compute_virial)
                         {
-                        h_virial.data[0*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.x;
-                        h_virial.data[1*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.y;
-                        h_virial.data[2*m_virial_pitch+mem_idx] += force_div2r*dx.x*dx.z;
-                        h_virial.data[3*m_virial_pitch+mem_idx] += force_div2r*dx.y*dx.y;
-                        h_virial.data[4*m_virial_pitch+mem_idx] += force_div2r*dx.y*dx.z;
-                        h_virial.data[5*m_virial_pitch+mem_idx] += force_div2r*dx.z*dx.z;
+                        virialxxi += force_div2r*dx.x*dx.x;
+                        virialxyi += force_div2r*dx.x*dx.y;
+                        virialxzi += force_div2r*dx.x*dx.z;
+                        virialyyi += force_div2r*dx.y*dx.y;
+                        virialyzi += force_div2r*dx.y*dx.z;
+                        virialzzi += force_div2r*dx.z*dx.z;
+                        }
+
+                    // add the force to particle j if we are using the third law (MEM TRANSFER: 10 scalars / FLOPS: 8)
+                    // only add force to local particles, or to the ghosts in the half-shell exchange
+                    if (third_law && j < n_third_law)
+                        {
+                        unsigned int mem_idx = j;
+                        force_data[mem_idx].x -= dx.x*force_divr;
+                        force_data[mem_idx].y -= dx.y*force_divr;
+                        force_data[mem_idx].z -= dx.z*force_divr;
+                        if (compute_energy && !ghost_pair)
+                            force_data[mem_idx].w += pair_eng * Scalar(0.5);
+                        if (compute_virial && !ghost_pair)
+                            {
+                            virial_data[0*virial_pitch+mem_idx] += force_div2r*dx.x*dx.x;
+                            virial_data[1*virial_pitch+mem_idx] += force_div2r*dx.x*dx.y;
+                            virial_data[2*virial_pitch+mem_idx] += force_div2r*dx.x*dx.z;
+                            virial_data[3*virial_pitch+mem_idx] += force_div2r*dx.y*dx.y;
+                            virial_data[4*virial_pitch+mem_idx] += force_div2r*dx.y*dx.z;
+                            virial_data[5*virial_pitch+mem_idx] += force_div2r*dx.z*dx.z;
+                            }
                         }
                     }
                 }
+
+            // finally, increment the force, potential energy and virial for particle i
+            unsigned int mem_idx = i;
+            force_data[mem_idx].x += fi.x;
+            force_data[mem_idx].y += fi.y;
+            force_data[mem_idx].z += fi.z;
+            force_data[mem_idx].w += pei;
+            if (compute_virial)
+                {
+                virial_data[0*virial_pitch+mem_idx] += virialxxi;
+                virial_data[1*virial_pitch+mem_idx] += virialxyi;
+                virial_data[2*virial_pitch+mem_idx] += virialxzi;
+                virial_data[3*virial_pitch+mem_idx] += virialyyi;
+                virial_data[4*virial_pitch+mem_idx] += virialyzi;
+                virial_data[5*virial_pitch+mem_idx] += virialzzi;
+                }
             }
+        };
+
+    #ifdef ENABLE_TBB
+    // with newton's third law, the particles are split into one fixed chunk per thread that adds its reaction forces to
+    // its own buffers, so that the order of the sums does not depend on the scheduling of the chunks
+    const unsigned int n_chunks = third_law ? std::min(m_exec_conf->getNumThreads(), N) : 1;
 
-        // finally, increment the force, potential energy and virial for particle i
-        unsigned int mem_idx = i;
-        h_force.data[mem_idx].x += fi.x;
-        h_force.data[mem_idx].y += fi.y;
-        h_force.data[mem_idx].z += fi.z;
-        h_force.data[mem_idx].w += pei;
-        if (compute_virial)
+    if (n_chunks > 1)
+        {
+        if (m_force_chunk.size() < n_chunks)
             {
-            h_virial.data[0*m_virial_pitch+mem_idx] += virialxxi;
-            h_virial.data[1*m_virial_pitch+mem_idx] += virialxyi;
-            h_virial.data[2*m_virial_pitch+mem_idx] += virialxzi;
-            h_virial.data[3*m_virial_pitch+mem_idx] += virialyyi;
-            h_virial.data[4*m_virial_pitch+mem_idx] += virialyzi;
-            h_virial.data[5*m_virial_pitch+mem_idx] += virialzzi;
+            m_force_chunk.resize(n_chunks);
+            m_virial_chunk.resize(n_chunks);
             }
+
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_chunks, 1), [&] (const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int c = r.begin(); c != r.end(); ++c)
+                {
+                // the buffers are zeroed when they grow and after every reduction
+                std::vector<Scalar4>& force_local = m_force_chunk[c];
+                if (force_local.size() < n_third_law)
+                    force_local.resize(n_third_law, make_scalar4(0,0,0,0));
+                std::vector<Scalar>& virial_local = m_virial_chunk[c];
+                if (compute_virial && virial_local.size() < 6*N)
+                    virial_local.resize(6*N, Scalar(0.0));
+
+                std::vector<unsigned int> candidates;
+                compute_range((unsigned int)((uint64_t)N*c/n_chunks),
+                              (unsigned int)((uint64_t)N*(c+1)/n_chunks),
+                              &force_local.front(),
+                              compute_virial ? &virial_local.front() : NULL,
+                              N,
+                              candidates);
+                }
+            }, tbb::static_partitioner());
+
+        // sum up the chunk contributions in chunk order, and clear the buffers for the next call
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, n_third_law), [&] (const tbb::blocked_range<unsigned int>& r)
+            {
+            for (unsigned int c = 0; c < n_chunks; ++c)
+                {
+                Scalar4 *force_local = &m_force_chunk[c].front();
+                for (unsigned int i = r.begin(); i != r.end(); ++i)
+                    {
+                    h_force.data[i].x += force_local[i].x;
+                    h_force.data[i].y += force_local[i].y;
+                    h_force.data[i].z += force_local[i].z;
+                    h_force.data[i].w += force_local[i].w;
+                    force_local[i] = make_scalar4(0,0,0,0);
+                    }
+                }
+
+            if (compute_virial)
+                {
+                // the ghosts have no virial
+                const unsigned int end = std::min(r.end(), N);
+                for (unsigned int c = 0; c < n_chunks; ++c)
+                    {
+                    Scalar *virial_local = &m_virial_chunk[c].front();
+                    for (unsigned int k = 0; k < 6; ++k)
+                        for (unsigned int i = r.begin(); i < end; ++i)
+                            {
+                            h_virial.data[k*target_virial_pitch+i] += virial_local[k*N+i];
+                            virial_local[k*N+i] = Scalar(0.0);
+                            }
+                    }
+                }
+            });
+        }
+    else if (!third_law)
+        {
+        // with a full neighbor list, every thread only writes to the particles it owns
+        tbb::enumerable_thread_specific< std::vector<unsigned int> > candidates_thread;
+        tbb::parallel_for(tbb::blocked_range<unsigned int>(0, N), [&] (const tbb::blocked_range<unsigned int>& r)
+            {
+            compute_range(r.begin(), r.end(), h_force.data, h_virial.data, target_virial_pitch,
+                          candidates_thread.local());
+            });
+        }
+    else
+    #endif
+        {
+        // a single thread adds the reaction forces directly to the force array
+        std::vector<unsigned int> candidates;
+        compute_range(0, N, h_force.data, h_virial.data, target_virial_pitch, candidates);
         }
 
     if (m_prof) m_prof->pop();
@@ -584,6 +1086,42 @@ CommFlags PotentialPair< evaluator >::getRequestedCommFlags(unsigned int timeste
 
     return flags;
     }
+
+/*! \param comm The communicator
+ */
+template < class evaluator >
+void PotentialPair< evaluator >::setCommunicator(std::shared_ptr<Communicator> comm)
+    {
+    if (!m_comm && m_overlap_ghost_update)
+        {
+        // only connect on the first call
+        assert(comm);
+        comm->getInteriorComputeCallbackSignal().template connect<PotentialPair<evaluator>, &PotentialPair<evaluator>::computeInteriorForces>(this);
+        }
+
+    ForceCompute::setCommunicator(comm);
+    }
+
+/*! \param timestep Current time step
+
+    Called by the Communicator between beginUpdateGhosts() and finishUpdateGhosts(). The interior is only computed if
+    the neighbor list is not going to be rebuilt in this step and the forces have not yet been computed, otherwise
+    computeForces() evaluates all particles as usual.
+*/
+template < class evaluator >
+void PotentialPair< evaluator >::computeInteriorForces(unsigned int timestep)
+    {
+    if (!m_nlist->isValidAt(timestep) || m_particles_sorted || (!m_first_compute && m_last_computed == timestep))
+        return;
+
+    // the net force is zeroed after the ghost update, forces added to it now would be lost
+    if (m_accumulate_net_force)
+        return;
+
+    computePairForces(timestep, phase_interior);
+    m_interior_computed = true;
+    m_interior_timestep = timestep;
+    }
 #endif
 
 
@@ -785,6 +1323,8 @@ template < class T > void export_PotentialPair(pybind11::module& m, const std::s
         .def("setRcut", &T::setRcut)
         .def("setRon", &T::setRon)
         .def("setShiftMode", &T::setShiftMode)
+        .def("setCellPairs", &T::setCellPairs)
+        .def("setSpecialPairScale", &T::setSpecialPairScale)
         .def("computeEnergyBetweenSets", &T::computeEnergyBetweenSetsPythonList)
     ;
 
@@ -60,9 +60,21 @@ class PotentialPairDPDThermo : public PotentialPair<evaluator>
         //! Set the temperature
         virtual void setT(std::shared_ptr<Variant> T);
 
+        //! The thermostat forces are always written to the per-compute arrays
+        virtual bool supportsNetForceAccumulation()
+            {
+            return false;
+            }
+
         #ifdef ENABLE_MPI
         //! Get ghost particle fields requested by this pair potential
         virtual CommFlags getRequestedCommFlags(unsigned int timestep);
+
+        //! The half-shell ghost exchange is not supported
+        virtual bool supportsHalfShell()
+            {
+            return false;
+            }
         #endif
 
     protected:
@@ -84,6 +96,8 @@ PotentialPairDPDThermo< evaluator >::PotentialPairDPDThermo(std::shared_ptr<Syst
                                                 const std::string& log_suffix)
     : PotentialPair<evaluator>(sysdef,nlist, log_suffix)
     {
+    // computeForces() is replaced, the interior/boundary split of the base class does not apply
+    this->m_overlap_ghost_update = false;
     }
 
 /*! \param seed Stored seed for PRNG
@@ -113,22 +127,25 @@ void PotentialPairDPDThermo< evaluator >::setT(std::shared_ptr<Variant> T)
     }
 
 /*! \post The pair forces are computed for the given timestep. The neighborlist's compute method is called to ensure
-    that it is up to date before proceeding.
+    that it is up to date before proceeding. In the cell-pair mode, the cell list is updated instead.
 
     \param timestep specifies the current time step of the simulation
 */
 template< class evaluator >
 void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
     {
-    // start by updating the neighborlist
-    this->m_nlist->compute(timestep);
+    // start by updating the neighborlist (or the cell list)
+    if (this->m_cl)
+        this->computeCellList(timestep);
+    else
+        this->m_nlist->compute(timestep);
 
     // start the profile for this compute
     if (this->m_prof) this->m_prof->push(this->m_prof_name);
 
     // depending on the neighborlist settings, we can take advantage of newton's third law
     // to reduce computations at the cost of memory access complexity: set that flag now
-    bool third_law = this->m_nlist->getStorageMode() == NeighborList::half;
+    bool third_law = !this->m_cl && this->m_nlist->getStorageMode() == NeighborList::half;
 
     // access the neighbor list, particle data, and system box
     ArrayHandle<unsigned int> h_n_neigh(this->m_nlist->getNNeighArray(), access_location::host, access_mode::read);
@@ -152,6 +169,14 @@ void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
     memset((void*)h_force.data,0,sizeof(Scalar4)*this->m_force.getNumElements());
     memset((void*)h_virial.data,0,sizeof(Scalar)*this->m_virial.getNumElements());
 
+    // in the cell-pair mode, the neighbors are gathered from the cell list per particle
+    // the random forces remain pairwise symmetric because the RNG is seeded with the ordered tags
+    std::unique_ptr<CellPairCandidates> cell_candidates;
+    std::vector<unsigned int> candidates;
+    if (this->m_cl)
+        cell_candidates.reset(new CellPairCandidates(*this->m_cl, *this->m_nlist, *this->m_pdata,
+                                                     this->m_typpair_idx, h_rcutsq.data));
+
     // for each particle
     for (int i = 0; i < (int)this->m_pdata->getN(); i++)
         {
@@ -160,7 +185,6 @@ void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
         Scalar3 vi = make_scalar3(h_vel.data[i].x, h_vel.data[i].y, h_vel.data[i].z);
 
         unsigned int typei = __scalar_as_int(h_pos.data[i].w);
-        const unsigned int head_i = h_head_list.data[i];
 
         // sanity check
         assert(typei < this->m_pdata->getNTypes());
@@ -173,11 +197,19 @@ void PotentialPairDPDThermo< evaluator >::computeForces(unsigned int timestep)
             viriali[l] = 0.0;
 
         // loop over all of the neighbors of this particle
-        const unsigned int size = (unsigned int)h_n_neigh.data[i];
+        const unsigned int *neighbors = h_nlist.data + h_head_list.data[i];
+        unsigned int size = (unsigned int)h_n_neigh.data[i];
+        if (cell_candidates)
+            {
+            cell_candidates->gather(i, candidates);
+            neighbors = candidates.data();
+            size = (unsigned int)candidates.size();
+            }
+
         for (unsigned int k = 0; k < size; k++)
             {
             // access the index of this neighbor (MEM TRANSFER: 1 scalar)
-            unsigned int j = h_nlist.data[head_i + k];
+            unsigned int j = neighbors[k];
             assert(j < this->m_pdata->getN() + this->m_pdata->getNGhosts() );
 
             // calculate dr_ji (MEM TRANSFER: 3 scalars / FLOPS: 3)
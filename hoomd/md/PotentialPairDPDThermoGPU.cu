@@ -0,0 +1,62 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: phillicl
+
+/*! \file PotentialPairDPDThermoGPU.cu
+    \brief Defines the packing kernel of the DPD thermostat pair forces on the GPU
+*/
+
+#include "PotentialPairDPDThermoGPU.cuh"
+
+//! Kernel to pack the positions and velocities of the particles
+/*! \param d_posvel Packed data (output), 2*n elements
+    \param d_pos Particle positions and types
+    \param d_vel Particle velocities
+    \param d_tag Particle tags
+    \param n Number of local and ghost particles
+
+    The DPD kernels read the position, type, velocity and tag of every neighbor. Element 2*i of \a d_posvel holds the
+    position and type of particle i, and element 2*i+1 holds its velocity with the tag in place of the mass, which
+    the pair force does not need.
+*/
+__global__ void gpu_dpd_pack_posvel_kernel(Scalar4 *d_posvel,
+                                           const Scalar4 *d_pos,
+                                           const Scalar4 *d_vel,
+                                           const unsigned int *d_tag,
+                                           const unsigned int n)
+    {
+    const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= n)
+        return;
+
+    const Scalar4 vel = d_vel[idx];
+    d_posvel[2*idx] = d_pos[idx];
+    d_posvel[2*idx+1] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(d_tag[idx]));
+    }
+
+/*! \param d_posvel Packed data (output), 2*n elements
+    \param d_pos Particle positions and types
+    \param d_vel Particle velocities
+    \param d_tag Particle tags
+    \param n Number of local and ghost particles
+    \param block_size Block size to execute
+*/
+cudaError_t gpu_dpd_pack_posvel(Scalar4 *d_posvel,
+                                const Scalar4 *d_pos,
+                                const Scalar4 *d_vel,
+                                const unsigned int *d_tag,
+                                const unsigned int n,
+                                const unsigned int block_size)
+    {
+    if (n == 0)
+        return cudaSuccess;
+
+    dim3 grid(n / block_size + 1, 1, 1);
+    dim3 threads(block_size, 1, 1);
+
+    gpu_dpd_pack_posvel_kernel<<<grid, threads>>>(d_posvel, d_pos, d_vel, d_tag, n);
+
+    return cudaSuccess;
+    }
@@ -15,6 +15,7 @@
 #include "hoomd/ParticleData.cuh"
 #include "EvaluatorPairDPDThermo.h"
 #include "hoomd/Index1D.h"
+#include "CellPairCandidatesGPU.cuh"
 #ifdef NVCC
 #include "hoomd/WarpTools.cuh"
 #endif // NVCC
@@ -35,6 +36,7 @@ struct dpd_pair_args_t
                     const Scalar4 *_d_pos,
                     const Scalar4 *_d_vel,
                     const unsigned int *_d_tag,
+                    const Scalar4 *_d_posvel,
                     const BoxDim& _box,
                     const unsigned int *_d_n_neigh,
                     const unsigned int *_d_nlist,
@@ -49,9 +51,11 @@ struct dpd_pair_args_t
                     const Scalar _T,
                     const unsigned int _shift_mode,
                     const unsigned int _compute_virial,
+                    const unsigned int _half_nlist,
                     const unsigned int _threads_per_particle,
                     const unsigned int _compute_capability,
-                    const unsigned int _max_tex1d_width)
+                    const unsigned int _max_tex1d_width,
+                    const cell_pair_args_t *_cell_args = NULL)
                         : d_force(_d_force),
                         d_virial(_d_virial),
                         virial_pitch(_virial_pitch),
@@ -60,6 +64,7 @@ struct dpd_pair_args_t
                         d_pos(_d_pos),
                         d_vel(_d_vel),
                         d_tag(_d_tag),
+                        d_posvel(_d_posvel),
                         box(_box),
                         d_n_neigh(_d_n_neigh),
                         d_nlist(_d_nlist),
@@ -74,9 +79,11 @@ struct dpd_pair_args_t
                         T(_T),
                         shift_mode(_shift_mode),
                         compute_virial(_compute_virial),
+                        half_nlist(_half_nlist),
                         threads_per_particle(_threads_per_particle),
                         compute_capability(_compute_capability),
-                        max_tex1d_width(_max_tex1d_width)
+                        max_tex1d_width(_max_tex1d_width),
+                        cell_args(_cell_args)
         {
         };
 
@@ -88,6 +95,7 @@ struct dpd_pair_args_t
     const Scalar4 *d_pos;           //!< particle positions
     const Scalar4 *d_vel;           //!< particle velocities
     const unsigned int *d_tag;      //!< particle tags
+    const Scalar4 *d_posvel;        //!< packed positions and velocities, see gpu_dpd_pack_posvel()
     const BoxDim& box;         //!< Simulation box in GPU format
     const unsigned int *d_n_neigh;  //!< Device array listing the number of neighbors on each particle
     const unsigned int *d_nlist;    //!< Device array listing the neighbors of each particle
@@ -102,25 +110,234 @@ struct dpd_pair_args_t
     const Scalar T;                  //!< temperature
     const unsigned int shift_mode;  //!< The potential energy shift mode
     const unsigned int compute_virial;  //!< Flag to indicate if virials should be computed
+    const unsigned int half_nlist;  //!< Flag to indicate that the neighbor list stores every pair once
     const unsigned int threads_per_particle; //!< Number of threads per particle (maximum: 32==1 warp)
     const unsigned int compute_capability;  //!< Compute capability of the device (20, 30, 35, ...)
     const unsigned int max_tex1d_width;     //!< Maximum width of a 1d linear texture
+    const cell_pair_args_t *cell_args;      //!< Cell list of the cell-pair mode, NULL when the nlist is used
     };
 
-#ifdef NVCC
-//! Texture for reading particle positions
-scalar4_tex_t pdata_dpd_pos_tex;
-
-//! Texture for reading particle velocities
-scalar4_tex_t pdata_dpd_vel_tex;
+//! Pack the positions, types, velocities and tags of the particles for the DPD kernels
+cudaError_t gpu_dpd_pack_posvel(Scalar4 *d_posvel,
+                                const Scalar4 *d_pos,
+                                const Scalar4 *d_vel,
+                                const unsigned int *d_tag,
+                                const unsigned int n,
+                                const unsigned int block_size);
 
-//! Texture for reading particle tags
-texture<unsigned int, 1, cudaReadModeElementType> pdata_dpd_tag_tex;
+#ifdef NVCC
+//! Texture for reading the packed particle positions and velocities
+scalar4_tex_t pdata_dpd_posvel_tex;
 
 //! Texture for reading neighbor list
 texture<unsigned int, 1, cudaReadModeElementType> nlist_tex;
 
-//! Kernel for calculating pair forces
+#if !defined(SINGLE_PRECISION) && (__CUDA_ARCH__ < 600)
+//! atomicAdd function for double-precision floating point numbers
+/*! \param address Address to write the double to
+    \param val Value to add to address
+*/
+__device__ inline double dpd_atomic_add(double* address, double val)
+    {
+    unsigned long long int* address_as_ull = (unsigned long long int*)address;
+    unsigned long long int old = *address_as_ull, assumed;
+
+    do {
+        assumed = old;
+        old = atomicCAS(address_as_ull,
+                        assumed,
+                        __double_as_longlong(val + __longlong_as_double(assumed)));
+    } while (assumed != old);
+
+    return __longlong_as_double(old);
+    }
+#else
+//! atomicAdd function for Scalar
+/*! \param address Address to write the value to
+    \param val Value to add to address
+*/
+__device__ inline Scalar dpd_atomic_add(Scalar* address, Scalar val)
+    {
+    return atomicAdd(address, val);
+    }
+#endif
+
+//! Evaluate the DPD force between a particle and one neighbor and add it to the accumulators
+/*! \param posi Position of particle i
+    \param veli Velocity of particle i
+    \param typei Type of particle i
+    \param tagi Tag of particle i
+    \param posj Position of the neighbor j
+    \param typej Type of the neighbor j
+    \param veltagj Velocity and tag of the neighbor j, as packed by gpu_dpd_pack_posvel()
+    \param j Index of the neighbor j
+    \param box Box dimensions used to implement periodic boundary conditions
+    \param typpair_idx Indexer for the per type pair arrays
+    \param s_params Parameters for the potential (shared memory), stored per type pair
+    \param s_rcutsq rcut squared (shared memory), stored per type pair
+    \param d_seed user defined seed for PRNG
+    \param d_timestep timestep of simulation
+    \param d_deltaT timestep size
+    \param d_T temperature
+    \param force Force and energy accumulator of particle i
+    \param virial Virial accumulator of particle i (6 components)
+    \param d_force Device memory of the forces, the reaction on j is added to it with a half neighbor list
+    \param d_virial Device memory of the virials, the reaction on j is added to it with a half neighbor list
+    \param virial_pitch Pitch of 2D virial array
+
+    This is the per pair evaluation shared by gpu_compute_dpd_forces_kernel() and gpu_compute_dpd_forces_cell_kernel().
+    With \a half_nlist, every pair is evaluated once and the force on j is applied with atomic operations. Since the
+    random number of a pair is drawn from the ordered pair of tags, both particles see identical random forces either
+    way.
+*/
+template< class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int half_nlist>
+__device__ inline void gpu_dpd_force_accumulate(const Scalar3& posi,
+                                                const Scalar3& veli,
+                                                const unsigned int typei,
+                                                const unsigned int tagi,
+                                                const Scalar3& posj,
+                                                const unsigned int typej,
+                                                const Scalar4& veltagj,
+                                                const unsigned int j,
+                                                const BoxDim& box,
+                                                const Index2D& typpair_idx,
+                                                const typename evaluator::param_type *s_params,
+                                                const Scalar *s_rcutsq,
+                                                const unsigned int d_seed,
+                                                const unsigned int d_timestep,
+                                                const Scalar d_deltaT,
+                                                const Scalar d_T,
+                                                Scalar4& force,
+                                                Scalar *virial,
+                                                Scalar4 *d_force,
+                                                Scalar *d_virial,
+                                                const unsigned int virial_pitch)
+    {
+    Scalar3 velj = make_scalar3(veltagj.x, veltagj.y, veltagj.z);
+
+    // calculate dr (with periodic boundary conditions) (FLOPS: 3)
+    Scalar3 dx = posi - posj;
+
+    // apply periodic boundary conditions: (FLOPS 12)
+    dx = box.minImage(dx);
+
+    // calculate r squared (FLOPS: 5)
+    Scalar rsq = dot(dx,dx);
+
+    // access the per type pair parameters
+    unsigned int typpair = typpair_idx(typei, typej);
+    Scalar rcutsq = s_rcutsq[typpair];
+
+    // skip the RNG and the evaluator for pairs beyond the cutoff
+    if (rsq >= rcutsq)
+        return;
+
+    // calculate dv (FLOPS: 3)
+    Scalar3 dv = veli - velj;
+
+    Scalar rdotv = dot(dx, dv);
+
+    typename evaluator::param_type param = s_params[typpair];
+
+    // design specifies that energies are shifted if
+    // 1) shift mode is set to shift
+    // or 2) shift mode is explor and ron > rcut
+    bool energy_shift = false;
+    if (shift_mode == 1)
+        energy_shift = true;
+
+    evaluator eval(rsq, rcutsq, param);
+
+    // evaluate the potential
+    Scalar force_divr = Scalar(0.0);
+    Scalar force_divr_cons = Scalar(0.0);
+    Scalar pair_eng = Scalar(0.0);
+
+    // Special Potential Pair DPD Requirements
+    // use particle i's and j's tags
+    unsigned int tagj = __scalar_as_int(veltagj.w);
+    eval.set_seed_ij_timestep(d_seed,tagi,tagj,d_timestep);
+    eval.setDeltaT(d_deltaT);
+    eval.setRDotV(rdotv);
+    eval.setT(d_T);
+
+    eval.evalForceEnergyThermo(force_divr, force_divr_cons, pair_eng, energy_shift);
+
+    // calculate the virial (FLOPS: 3)
+    Scalar force_div2r_cons = Scalar(0.5) * force_divr_cons;
+    if (compute_virial)
+        {
+        virial[0] += dx.x * dx.x * force_div2r_cons;
+        virial[1] += dx.x * dx.y * force_div2r_cons;
+        virial[2] += dx.x * dx.z * force_div2r_cons;
+        virial[3] += dx.y * dx.y * force_div2r_cons;
+        virial[4] += dx.y * dx.z * force_div2r_cons;
+        virial[5] += dx.z * dx.z * force_div2r_cons;
+        }
+
+    // add up the force vector components (FLOPS: 7)
+    force.x += dx.x * force_divr;
+    force.y += dx.y * force_divr;
+    force.z += dx.z * force_divr;
+
+    force.w += pair_eng;
+
+    if (half_nlist)
+        {
+        // apply the reaction to j, which is not visited by the threads of i's neighbors
+        dpd_atomic_add(&d_force[j].x, -dx.x * force_divr);
+        dpd_atomic_add(&d_force[j].y, -dx.y * force_divr);
+        dpd_atomic_add(&d_force[j].z, -dx.z * force_divr);
+        dpd_atomic_add(&d_force[j].w, Scalar(0.5) * pair_eng);
+
+        if (compute_virial)
+            {
+            dpd_atomic_add(&d_virial[0*virial_pitch+j], dx.x * dx.x * force_div2r_cons);
+            dpd_atomic_add(&d_virial[1*virial_pitch+j], dx.x * dx.y * force_div2r_cons);
+            dpd_atomic_add(&d_virial[2*virial_pitch+j], dx.x * dx.z * force_div2r_cons);
+            dpd_atomic_add(&d_virial[3*virial_pitch+j], dx.y * dx.y * force_div2r_cons);
+            dpd_atomic_add(&d_virial[4*virial_pitch+j], dx.y * dx.z * force_div2r_cons);
+            dpd_atomic_add(&d_virial[5*virial_pitch+j], dx.z * dx.z * force_div2r_cons);
+            }
+        }
+    }
+
+//! Write out the force and virial of particle i
+/*! \param idx Index of particle i
+    \param force Force and energy of particle i
+    \param virial Virial of particle i
+    \param d_force Device memory to write computed forces
+    \param d_virial Device memory to write computed virials
+    \param virial_pitch Pitch of 2D virial array
+
+    With \a half_nlist, other threads add the reactions of their pairs to particle i, so the values are added
+    atomically to the zeroed output.
+*/
+template< unsigned int compute_virial, unsigned int half_nlist>
+__device__ inline void gpu_dpd_force_write(const unsigned int idx,
+                                           const Scalar4& force,
+                                           const Scalar *virial,
+                                           Scalar4 *d_force,
+                                           Scalar *d_virial,
+                                           const unsigned int virial_pitch)
+    {
+    if (half_nlist)
+        {
+        dpd_atomic_add(&d_force[idx].x, force.x);
+        dpd_atomic_add(&d_force[idx].y, force.y);
+        dpd_atomic_add(&d_force[idx].z, force.z);
+        dpd_atomic_add(&d_force[idx].w, force.w);
+        if (compute_virial)
+            for (unsigned int i = 0; i < 6; i++) dpd_atomic_add(&d_virial[i*virial_pitch+idx], virial[i]);
+        }
+    else
+        {
+        d_force[idx] = force;
+        if (compute_virial)
+            for (unsigned int i = 0; i < 6; i++) d_virial[i*virial_pitch+idx] = virial[i];
+        }
+    }
+
 /*! This kernel is called to calculate the pair forces on all N particles. Actual evaluation of the potentials and
     forces for each pair is handled via the template class \a evaluator.
 
@@ -128,9 +345,7 @@ texture<unsigned int, 1, cudaReadModeElementType> nlist_tex;
     \param d_virial Device memory to write computed virials
     \param virial_pitch Pitch of 2D virial array
     \param N number of particles
-    \param d_pos particle positions on the GPU
-    \param d_vel particle velocities on the GPU
-    \param d_tag particle tags on the GPU
+    \param d_posvel Packed particle positions and velocities on the GPU, see gpu_dpd_pack_posvel()
     \param box Box dimensions used to implement periodic boundary conditions
     \param d_n_neigh Device memory array listing the number of neighbors for each particle
     \param d_nlist Device memory array containing the neighbor list contents
@@ -142,7 +357,6 @@ texture<unsigned int, 1, cudaReadModeElementType> nlist_tex;
     \param d_deltaT timestep size
     \param d_T temperature
     \param ntypes Number of types in the simulation
-    \param tpp Number of threads per particle
 
     \a d_params, and \a d_rcutsq must be indexed with an Index2DUpperTriangular(typei, typej) to access the
     unique value for that type pair. These values are all cached into shared memory for quick access, so a dynamic
@@ -155,19 +369,23 @@ texture<unsigned int, 1, cudaReadModeElementType> nlist_tex;
     \tparam compute_virial When non-zero, the virial tensor is computed. When zero, the virial tensor is not computed.
     \tparam use_gmem_nlist When non-zero, the neighbor list is read out of global memory. When zero, textures or __ldg
                            is used depending on architecture.
+    \tparam half_nlist When non-zero, the neighbor list stores every pair once and the forces are accumulated with
+                       atomic operations into \a d_force and \a d_virial, which must be zeroed before the launch.
+    \tparam tpp Number of threads per particle
 
     <b>Implementation details</b>
     Each block will calculate the forces on a block of particles.
     Each thread will calculate the total force on one particle.
+    The position and velocity of a neighbor are adjacent in \a d_posvel, so that they are read in a single 32 byte
+    transaction that also carries the type and the tag.
 */
-template< class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned char use_gmem_nlist, int tpp>
+template< class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned char use_gmem_nlist,
+          unsigned int half_nlist, int tpp>
 __global__ void gpu_compute_dpd_forces_kernel(Scalar4 *d_force,
                                               Scalar *d_virial,
                                               const unsigned int virial_pitch,
                                               const unsigned int N,
-                                              const Scalar4 *d_pos,
-                                              const Scalar4 *d_vel,
-                                              const unsigned int *d_tag,
+                                              const Scalar4 *d_posvel,
                                               BoxDim box,
                                               const unsigned int *d_n_neigh,
                                               const unsigned int *d_nlist,
@@ -220,15 +438,13 @@ __global__ void gpu_compute_dpd_forces_kernel(Scalar4 *d_force,
         // load in the length of the neighbor list (MEM_TRANSFER: 4 bytes)
         unsigned int n_neigh = d_n_neigh[idx];
 
-        // read in the position of our particle.
-        // (MEM TRANSFER: 16 bytes)
-        Scalar4 postypei = texFetchScalar4(d_pos, pdata_dpd_pos_tex, idx);
+        // read in the position, velocity and tag of our particle.
+        // (MEM TRANSFER: 32 bytes)
+        Scalar4 postypei = texFetchScalar4(d_posvel, pdata_dpd_posvel_tex, 2*idx);
         Scalar3 posi = make_scalar3(postypei.x, postypei.y, postypei.z);
-
-        // read in the velocity of our particle.
-        // (MEM TRANSFER: 16 bytes)
-        Scalar4 velmassi = texFetchScalar4(d_vel, pdata_dpd_vel_tex, idx);
-        Scalar3 veli = make_scalar3(velmassi.x, velmassi.y, velmassi.z);
+        Scalar4 veltagi = texFetchScalar4(d_posvel, pdata_dpd_posvel_tex, 2*idx+1);
+        Scalar3 veli = make_scalar3(veltagi.x, veltagi.y, veltagi.z);
+        unsigned int tagi = __scalar_as_int(veltagi.w);
 
         // prefetch neighbor index
         const unsigned int head_idx = d_head_list[idx];
@@ -243,9 +459,6 @@ __global__ void gpu_compute_dpd_forces_kernel(Scalar4 *d_force,
             next_j = (threadIdx.x%tpp < n_neigh) ? texFetchUint(d_nlist, nlist_tex, head_idx + threadIdx.x%tpp) : 0;
             }
 
-        // this particle's tag
-        unsigned int tagi = d_tag[idx];
-
         // loop over neighbors
         for (int neigh_idx = threadIdx.x%tpp; neigh_idx < n_neigh; neigh_idx+=tpp)
             {
@@ -265,75 +478,148 @@ __global__ void gpu_compute_dpd_forces_kernel(Scalar4 *d_force,
                         }
                     }
 
-                // get the neighbor's position (MEM TRANSFER: 16 bytes)
-                Scalar4 postypej = texFetchScalar4(d_pos, pdata_dpd_pos_tex, cur_j);
+                // get the neighbor's position, velocity and tag (MEM TRANSFER: 32 bytes)
+                Scalar4 postypej = texFetchScalar4(d_posvel, pdata_dpd_posvel_tex, 2*cur_j);
+                Scalar4 veltagj = texFetchScalar4(d_posvel, pdata_dpd_posvel_tex, 2*cur_j+1);
                 Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
 
-                // get the neighbor's position (MEM TRANSFER: 16 bytes)
-                Scalar4 velmassj = texFetchScalar4(d_vel, pdata_dpd_vel_tex, cur_j);
-                Scalar3 velj = make_scalar3(velmassj.x, velmassj.y, velmassj.z);
+                gpu_dpd_force_accumulate<evaluator, shift_mode, compute_virial, half_nlist>(posi, veli,
+                    __scalar_as_int(postypei.w), tagi, posj, __scalar_as_int(postypej.w), veltagj, cur_j, box,
+                    typpair_idx, s_params, s_rcutsq, d_seed, d_timestep, d_deltaT, d_T, force, virial,
+                    d_force, d_virial, virial_pitch);
+                }
+            }
+
+        // potential energy per particle must be halved
+        force.w *= Scalar(0.5);
+        }
 
-                // calculate dr (with periodic boundary conditions) (FLOPS: 3)
-                Scalar3 dx = posi - posj;
+    // reduce force over threads in cta
+    hoomd::detail::WarpReduce<Scalar, tpp> reducer;
+    force.x = reducer.Sum(force.x);
+    force.y = reducer.Sum(force.y);
+    force.z = reducer.Sum(force.z);
+    force.w = reducer.Sum(force.w);
 
-                // apply periodic boundary conditions: (FLOPS 12)
-                dx = box.minImage(dx);
+    if (compute_virial)
+        {
+        for (unsigned int i = 0; i < 6; ++i)
+            virial[i] = reducer.Sum(virial[i]);
+        }
 
-                // calculate r squared (FLOPS: 5)
-                Scalar rsq = dot(dx,dx);
+    // now that the force calculation is complete, write out the result (MEM TRANSFER: 20 bytes)
+    if (active && threadIdx.x % tpp == 0)
+        gpu_dpd_force_write<compute_virial, half_nlist>(idx, force, virial, d_force, d_virial, virial_pitch);
+    }
 
-                // calculate dv (FLOPS: 3)
-                Scalar3 dv = veli - velj;
+//! Kernel for calculating DPD forces directly from a cell list
+/*! This kernel is the cell-pair mode counterpart of gpu_compute_dpd_forces_kernel(), see
+    gpu_compute_pair_forces_cell_kernel() for the loop structure. The random forces stay pairwise symmetric because
+    the RNG is seeded with the ordered pair of tags.
 
-                Scalar rdotv = dot(dx, dv);
+    \param d_force Device memory to write computed forces
+    \param d_virial Device memory to write computed virials
+    \param virial_pitch Pitch of 2D virial array
+    \param N number of particles
+    \param d_posvel Packed particle positions and velocities on the GPU, see gpu_dpd_pack_posvel()
+    \param box Box dimensions used to implement periodic boundary conditions
+    \param cell_args Cell list and exclusion data
+    \param d_params Parameters for the potential, stored per type pair
+    \param d_rcutsq rcut squared, stored per type pair
+    \param d_seed user defined seed for PRNG
+    \param d_timestep timestep of simulation
+    \param d_deltaT timestep size
+    \param d_T temperature
+    \param ntypes Number of types in the simulation
+*/
+template< class evaluator, unsigned int shift_mode, unsigned int compute_virial, int tpp>
+__global__ void gpu_compute_dpd_forces_cell_kernel(Scalar4 *d_force,
+                                                   Scalar *d_virial,
+                                                   const unsigned int virial_pitch,
+                                                   const unsigned int N,
+                                                   const Scalar4 *d_posvel,
+                                                   BoxDim box,
+                                                   const cell_pair_args_t cell_args,
+                                                   const typename evaluator::param_type *d_params,
+                                                   const Scalar *d_rcutsq,
+                                                   const unsigned int d_seed,
+                                                   const unsigned int d_timestep,
+                                                   const Scalar d_deltaT,
+                                                   const Scalar d_T,
+                                                   const int ntypes)
+    {
+    Index2D typpair_idx(ntypes);
+    const unsigned int num_typ_parameters = typpair_idx.getNumElements();
 
-                // access the per type pair parameters
-                unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypej.w));
-                Scalar rcutsq = s_rcutsq[typpair];
-                typename evaluator::param_type param = s_params[typpair];
+    // shared arrays for per type pair parameters
+    extern __shared__ char s_data[];
+    typename evaluator::param_type *s_params =
+        (typename evaluator::param_type *)(&s_data[0]);
+    Scalar *s_rcutsq = (Scalar *)(&s_data[num_typ_parameters*sizeof(evaluator::param_type)]);
+
+    // load in the per type pair parameters
+    for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
+        {
+        if (cur_offset + threadIdx.x < num_typ_parameters)
+            {
+            s_rcutsq[cur_offset + threadIdx.x] = d_rcutsq[cur_offset + threadIdx.x];
+            s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
+            }
+        }
+    __syncthreads();
+
+    // start by identifying which particle we are to handle
+    const unsigned int idx = blockIdx.x * (blockDim.x/tpp) + threadIdx.x/tpp;
+    bool active = true;
+    if (idx >= N)
+        {
+        // need to mask this thread, but still participate in warp-level reduction (because of __syncthreads())
+        active = false;
+        }
 
-                // design specifies that energies are shifted if
-                // 1) shift mode is set to shift
-                // or 2) shift mode is explor and ron > rcut
-                bool energy_shift = false;
-                if (shift_mode == 1)
-                    energy_shift = true;
+    // initialize the force to 0
+    Scalar4 force = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
+    Scalar virial[6];
+    for (unsigned int i = 0; i < 6; i++)
+        virial[i] = Scalar(0.0);
 
-                evaluator eval(rsq, rcutsq, param);
+    if (active)
+        {
+        // read in the position, velocity and tag of our particle.
+        Scalar4 postypei = texFetchScalar4(d_posvel, pdata_dpd_posvel_tex, 2*idx);
+        Scalar3 posi = make_scalar3(postypei.x, postypei.y, postypei.z);
+        unsigned int typei = __scalar_as_int(postypei.w);
 
-                // evaluate the potential
-                Scalar force_divr = Scalar(0.0);
-                Scalar force_divr_cons = Scalar(0.0);
-                Scalar pair_eng = Scalar(0.0);
+        Scalar4 veltagi = texFetchScalar4(d_posvel, pdata_dpd_posvel_tex, 2*idx+1);
+        Scalar3 veli = make_scalar3(veltagi.x, veltagi.y, veltagi.z);
 
-                // Special Potential Pair DPD Requirements
-                // use particle i's and j's tags
-                unsigned int tagj = texFetchUint(d_tag, pdata_dpd_tag_tex, cur_j);
-                eval.set_seed_ij_timestep(d_seed,tagi,tagj,d_timestep);
-                eval.setDeltaT(d_deltaT);
-                eval.setRDotV(rdotv);
-                eval.setT(d_T);
+        const unsigned int tagi = __scalar_as_int(veltagi.w);
+        const unsigned int body_i = cell_args.d_body[idx];
+        const unsigned int n_ex_i = cell_args.d_n_ex_tag ? cell_args.d_n_ex_tag[tagi] : 0;
 
-                eval.evalForceEnergyThermo(force_divr, force_divr_cons, pair_eng, energy_shift);
+        const unsigned int my_cell = cell_pair_get_cell(posi, box, cell_args);
 
-                // calculate the virial (FLOPS: 3)
-                if (compute_virial)
-                    {
-                    Scalar force_div2r_cons = Scalar(0.5) * force_divr_cons;
-                    virial[0] += dx.x * dx.x * force_div2r_cons;
-                    virial[1] += dx.x * dx.y * force_div2r_cons;
-                    virial[2] += dx.x * dx.z * force_div2r_cons;
-                    virial[3] += dx.y * dx.y * force_div2r_cons;
-                    virial[4] += dx.y * dx.z * force_div2r_cons;
-                    virial[5] += dx.z * dx.z * force_div2r_cons;
-                    }
+        // loop over all neighboring cells, the threads of this particle share the members of each cell
+        for (unsigned int cur_adj = 0; cur_adj < cell_args.cadji.getW(); cur_adj++)
+            {
+            const unsigned int neigh_cell = cell_args.d_cell_adj[cell_args.cadji(cur_adj, my_cell)];
+            const unsigned int size = cell_args.d_cell_size[neigh_cell];
 
-                // add up the force vector components (FLOPS: 7)
-                force.x += dx.x * force_divr;
-                force.y += dx.y * force_divr;
-                force.z += dx.z * force_divr;
+            for (unsigned int cur_offset = threadIdx.x%tpp; cur_offset < size; cur_offset += tpp)
+                {
+                const Scalar4 cur_xyzf = cell_args.d_cell_xyzf[cell_args.cli(cur_offset, neigh_cell)];
+                const unsigned int cur_j = __scalar_as_int(cur_xyzf.w);
+
+                if (cell_pair_rejected(idx, cur_j, body_i, tagi, n_ex_i, cell_args))
+                    continue;
+
+                unsigned int typej = __scalar_as_int(texFetchScalar4(d_posvel, pdata_dpd_posvel_tex, 2*cur_j).w);
+                Scalar4 veltagj = texFetchScalar4(d_posvel, pdata_dpd_posvel_tex, 2*cur_j+1);
+                Scalar3 posj = make_scalar3(cur_xyzf.x, cur_xyzf.y, cur_xyzf.z);
 
-                force.w += pair_eng;
+                gpu_dpd_force_accumulate<evaluator, shift_mode, compute_virial, 0>(posi, veli, typei, tagi, posj,
+                    typej, veltagj, cur_j, box, typpair_idx, s_params, s_rcutsq, d_seed, d_timestep, d_deltaT, d_T,
+                    force, virial, d_force, d_virial, virial_pitch);
                 }
             }
 
@@ -348,19 +634,15 @@ __global__ void gpu_compute_dpd_forces_kernel(Scalar4 *d_force,
     force.z = reducer.Sum(force.z);
     force.w = reducer.Sum(force.w);
 
-    // now that the force calculation is complete, write out the result (MEM TRANSFER: 20 bytes)
-    if (active && threadIdx.x % tpp == 0)
-        d_force[idx] = force;
-
     if (compute_virial)
         {
         for (unsigned int i = 0; i < 6; ++i)
             virial[i] = reducer.Sum(virial[i]);
-
-        // if we are the first thread in the cta, write out virial to global mem
-        if (active && threadIdx.x %tpp == 0)
-            for (unsigned int i = 0; i < 6; i++) d_virial[i*virial_pitch+idx] = virial[i];
         }
+
+    // now that the force calculation is complete, write out the result (MEM TRANSFER: 20 bytes)
+    if (active && threadIdx.x % tpp == 0)
+        gpu_dpd_force_write<compute_virial, 0>(idx, force, virial, d_force, d_virial, virial_pitch);
     }
 
 template<typename T>
@@ -376,19 +658,10 @@ int dpd_get_max_block_size(T func)
 
 inline void gpu_dpd_pair_force_bind_textures(const dpd_pair_args_t pair_args)
     {
-    // bind the position texture
-    pdata_dpd_pos_tex.normalized = false;
-    pdata_dpd_pos_tex.filterMode = cudaFilterModePoint;
-    cudaBindTexture(0, pdata_dpd_pos_tex, pair_args.d_pos, sizeof(Scalar4)*pair_args.n_max);
-
-    // bind the diameter texture
-    pdata_dpd_vel_tex.normalized = false;
-    pdata_dpd_vel_tex.filterMode = cudaFilterModePoint;
-    cudaBindTexture(0, pdata_dpd_vel_tex, pair_args.d_vel, sizeof(Scalar4) * pair_args.n_max);
-
-    pdata_dpd_tag_tex.normalized = false;
-    pdata_dpd_tag_tex.filterMode = cudaFilterModePoint;
-    cudaBindTexture(0, pdata_dpd_tag_tex, pair_args.d_tag, sizeof(unsigned int) * pair_args.n_max);
+    // bind the packed position and velocity texture
+    pdata_dpd_posvel_tex.normalized = false;
+    pdata_dpd_posvel_tex.filterMode = cudaFilterModePoint;
+    cudaBindTexture(0, pdata_dpd_posvel_tex, pair_args.d_posvel, 2*sizeof(Scalar4)*pair_args.n_max);
 
     if (pair_args.size_nlist <= pair_args.max_tex1d_width)
         {
@@ -406,12 +679,14 @@ inline void gpu_dpd_pair_force_bind_textures(const dpd_pair_args_t pair_args)
  * \tparam compute_virial When non-zero, the virial tensor is computed. When zero, the virial tensor is not computed.
  * \tparam use_gmem_nlist When non-zero, the neighbor list is read out of global memory. When zero, textures or __ldg
  *                        is used depending on architecture.
+ * \tparam half_nlist When non-zero, the neighbor list stores every pair once
  * \tparam tpp Number of threads to use per particle, must be power of 2 and smaller than warp size
  *
  * Partial function template specialization is not allowed in C++, so instead we have to wrap this with a struct that
  * we are allowed to partially specialize.
  */
-template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int use_gmem_nlist, int tpp>
+template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int use_gmem_nlist,
+         unsigned int half_nlist, int tpp>
 struct DPDForceComputeKernel
     {
     //! Launcher for the DPD force kernel
@@ -432,22 +707,20 @@ struct DPDForceComputeKernel
 
             static unsigned int max_block_size = UINT_MAX;
             if (max_block_size == UINT_MAX)
-                max_block_size = dpd_get_max_block_size(gpu_compute_dpd_forces_kernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, tpp>);
+                max_block_size = dpd_get_max_block_size(gpu_compute_dpd_forces_kernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, half_nlist, tpp>);
 
             if (args.compute_capability < 35) gpu_dpd_pair_force_bind_textures(args);
 
             block_size = block_size < max_block_size ? block_size : max_block_size;
             dim3 grid(args.N / (block_size/tpp) + 1, 1, 1);
 
-            gpu_compute_dpd_forces_kernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, tpp>
+            gpu_compute_dpd_forces_kernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, half_nlist, tpp>
                                 <<<grid, block_size, shared_bytes>>>
                                 (args.d_force,
                                 args.d_virial,
                                 args.virial_pitch,
                                 args.N,
-                                args.d_pos,
-                                args.d_vel,
-                                args.d_tag,
+                                args.d_posvel,
                                 args.box,
                                 args.d_n_neigh,
                                 args.d_nlist,
@@ -462,14 +735,84 @@ struct DPDForceComputeKernel
             }
         else
             {
-            DPDForceComputeKernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, tpp/2>::launch(args, d_params);
+            DPDForceComputeKernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, half_nlist, tpp/2>::launch(args, d_params);
+            }
+        }
+    };
+
+//! Template specialization to do nothing for the tpp = 0 case
+template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int use_gmem_nlist,
+         unsigned int half_nlist>
+struct DPDForceComputeKernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, half_nlist, 0>
+    {
+    static void launch(const dpd_pair_args_t& args, const typename evaluator::param_type *d_params)
+        {
+        // do nothing
+        }
+    };
+
+//! DPD cell-pair force compute kernel launcher
+/*!
+ * \tparam evaluator EvaluatorPair class to evualuate V(r) and -delta V(r)/r
+ * \tparam shift_mode 0: No energy shifting is done. 1: V(r) is shifted to be 0 at rcut.
+ * \tparam compute_virial When non-zero, the virial tensor is computed. When zero, the virial tensor is not computed.
+ * \tparam tpp Number of threads to use per particle, must be power of 2 and smaller than warp size
+ */
+template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, int tpp>
+struct DPDForceComputeCellKernel
+    {
+    //! Launcher for the DPD cell-pair force kernel
+    /*!
+     * \param args Other arguments to pass onto the kernel
+     * \param d_params Parameters for the potential, stored per type pair
+     */
+    static void launch(const dpd_pair_args_t& args, const typename evaluator::param_type *d_params)
+        {
+        if (tpp == args.threads_per_particle)
+            {
+            // setup the grid to run the kernel
+            unsigned int block_size = args.block_size;
+
+            Index2D typpair_idx(args.ntypes);
+            unsigned int shared_bytes = (sizeof(Scalar) + sizeof(typename evaluator::param_type))
+                                        * typpair_idx.getNumElements();
+
+            static unsigned int max_block_size = UINT_MAX;
+            if (max_block_size == UINT_MAX)
+                max_block_size = dpd_get_max_block_size(gpu_compute_dpd_forces_cell_kernel<evaluator, shift_mode, compute_virial, tpp>);
+
+            if (args.compute_capability < 35) gpu_dpd_pair_force_bind_textures(args);
+
+            block_size = block_size < max_block_size ? block_size : max_block_size;
+            dim3 grid(args.N / (block_size/tpp) + 1, 1, 1);
+
+            gpu_compute_dpd_forces_cell_kernel<evaluator, shift_mode, compute_virial, tpp>
+                                <<<grid, block_size, shared_bytes>>>
+                                (args.d_force,
+                                args.d_virial,
+                                args.virial_pitch,
+                                args.N,
+                                args.d_posvel,
+                                args.box,
+                                *args.cell_args,
+                                d_params,
+                                args.d_rcutsq,
+                                args.seed,
+                                args.timestep,
+                                args.deltaT,
+                                args.T,
+                                args.ntypes);
+            }
+        else
+            {
+            DPDForceComputeCellKernel<evaluator, shift_mode, compute_virial, tpp/2>::launch(args, d_params);
             }
         }
     };
 
 //! Template specialization to do nothing for the tpp = 0 case
-template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int use_gmem_nlist>
-struct DPDForceComputeKernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, 0>
+template<class evaluator, unsigned int shift_mode, unsigned int compute_virial>
+struct DPDForceComputeCellKernel<evaluator, shift_mode, compute_virial, 0>
     {
     static void launch(const dpd_pair_args_t& args, const typename evaluator::param_type *d_params)
         {
@@ -477,11 +820,60 @@ struct DPDForceComputeKernel<evaluator, shift_mode, compute_virial, use_gmem_nli
         }
     };
 
+//! Launch the DPD neighbor list kernel for the given neighbor list access and storage mode
+/*! \param args Additional options
+    \param d_params Per type-pair parameters for the evaluator
+*/
+template< class evaluator, unsigned int use_gmem_nlist, unsigned int half_nlist >
+cudaError_t gpu_compute_dpd_forces_nlist(const dpd_pair_args_t& args,
+                                         const typename evaluator::param_type *d_params)
+    {
+    if (args.compute_virial)
+        {
+        switch (args.shift_mode)
+            {
+            case 0:
+                {
+                DPDForceComputeKernel<evaluator, 0, 1, use_gmem_nlist, half_nlist, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
+                break;
+                }
+            case 1:
+                {
+                DPDForceComputeKernel<evaluator, 1, 1, use_gmem_nlist, half_nlist, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
+                break;
+                }
+            default:
+                return cudaErrorUnknown;
+            }
+        }
+    else
+        {
+        switch (args.shift_mode)
+            {
+            case 0:
+                {
+                DPDForceComputeKernel<evaluator, 0, 0, use_gmem_nlist, half_nlist, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
+                break;
+                }
+            case 1:
+                {
+                DPDForceComputeKernel<evaluator, 1, 0, use_gmem_nlist, half_nlist, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
+                break;
+                }
+            default:
+                return cudaErrorUnknown;
+            }
+        }
+    return cudaSuccess;
+    }
+
 //! Kernel driver that computes pair DPD thermo forces on the GPU
 /*! \param args Additional options
     \param d_params Per type-pair parameters for the evaluator
 
-    This is just a driver function for gpu_compute_dpd_forces_kernel(), see it for details.
+    This is just a driver function for gpu_compute_dpd_forces_kernel(), see it for details. When \a args carries
+    cell list data, gpu_compute_dpd_forces_cell_kernel() is launched instead. \a args.d_posvel must have been filled
+    by gpu_dpd_pack_posvel() for the local and ghost particles.
 */
 template< class evaluator >
 cudaError_t gpu_compute_dpd_forces(const dpd_pair_args_t& args,
@@ -489,10 +881,11 @@ cudaError_t gpu_compute_dpd_forces(const dpd_pair_args_t& args,
     {
     assert(d_params);
     assert(args.d_rcutsq);
+    assert(args.d_posvel);
     assert(args.ntypes > 0);
 
-    // run the kernel
-    if (args.compute_capability < 35 && args.size_nlist > args.max_tex1d_width)
+    // cell-pair mode, the neighbor list is not used
+    if (args.cell_args)
         {
         if (args.compute_virial)
             {
@@ -500,12 +893,12 @@ cudaError_t gpu_compute_dpd_forces(const dpd_pair_args_t& args,
                 {
                 case 0:
                     {
-                    DPDForceComputeKernel<evaluator, 0, 1, 1, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
+                    DPDForceComputeCellKernel<evaluator, 0, 1, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
                     break;
                     }
                 case 1:
                     {
-                    DPDForceComputeKernel<evaluator, 1, 1, 1, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
+                    DPDForceComputeCellKernel<evaluator, 1, 1, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
                     break;
                     }
                 default:
@@ -518,60 +911,45 @@ cudaError_t gpu_compute_dpd_forces(const dpd_pair_args_t& args,
                 {
                 case 0:
                     {
-                    DPDForceComputeKernel<evaluator, 0, 0, 1, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
+                    DPDForceComputeCellKernel<evaluator, 0, 0, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
                     break;
                     }
                 case 1:
                     {
-                    DPDForceComputeKernel<evaluator, 1, 0, 1, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
+                    DPDForceComputeCellKernel<evaluator, 1, 0, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
                     break;
                     }
                 default:
                     return cudaErrorUnknown;
                 }
             }
+        return cudaSuccess;
         }
-    else
+
+    if (args.half_nlist)
         {
+        // the reactions of the pairs are accumulated into the output, including the ghost particles
+        cudaMemset(args.d_force, 0, sizeof(Scalar4)*args.n_max);
         if (args.compute_virial)
-            {
-            switch (args.shift_mode)
-                {
-                case 0:
-                    {
-                    DPDForceComputeKernel<evaluator, 0, 1, 0, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
-                    break;
-                    }
-                case 1:
-                    {
-                    DPDForceComputeKernel<evaluator, 1, 1, 0, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
-                    break;
-                    }
-                default:
-                    return cudaErrorUnknown;
-                }
-            }
-        else
-            {
-            switch (args.shift_mode)
-                {
-                case 0:
-                    {
-                    DPDForceComputeKernel<evaluator, 0, 0, 0, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
-                    break;
-                    }
-                case 1:
-                    {
-                    DPDForceComputeKernel<evaluator, 1, 0, 0, gpu_dpd_pair_force_max_tpp>::launch(args, d_params);
-                    break;
-                    }
-                default:
-                    return cudaErrorUnknown;
-                }
-            }
+            cudaMemset(args.d_virial, 0, 6*sizeof(Scalar)*args.virial_pitch);
         }
 
-    return cudaSuccess;
+    // run the kernel
+    bool use_gmem_nlist = args.compute_capability < 35 && args.size_nlist > args.max_tex1d_width;
+    if (use_gmem_nlist)
+        {
+        if (args.half_nlist)
+            return gpu_compute_dpd_forces_nlist<evaluator, 1, 1>(args, d_params);
+        else
+            return gpu_compute_dpd_forces_nlist<evaluator, 1, 0>(args, d_params);
+        }
+    else
+        {
+        if (args.half_nlist)
+            return gpu_compute_dpd_forces_nlist<evaluator, 0, 1>(args, d_params);
+        else
+            return gpu_compute_dpd_forces_nlist<evaluator, 0, 0>(args, d_params);
+        }
     }
 #endif
 
@@ -74,6 +74,7 @@ class PotentialPairDPDThermoGPU : public PotentialPairDPDThermo<evaluator>
     protected:
         std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for block size and threads per particle
         unsigned int m_param;                 //!< Kernel tuning parameter
+        GlobalArray<Scalar4> m_posvel;        //!< Packed positions and velocities of the local and ghost particles
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
@@ -94,18 +95,15 @@ PotentialPairDPDThermoGPU< evaluator, gpu_cpdf >::PotentialPairDPDThermoGPU(std:
         }
 
     // initialize autotuner
-    // the full block size and threads_per_particle matrix is searched,
+    // the block size and threads_per_particle are searched by coordinate descent,
     // encoded as block_size*10000 + threads_per_particle
-    std::vector<unsigned int> valid_params;
+    std::vector< std::vector<unsigned int> > dim_values(2);
     for (unsigned int block_size = 32; block_size <= 1024; block_size += 32)
-        {
-        for (auto s : Autotuner::getTppListPow2(this->m_exec_conf->dev_prop.warpSize))
-            {
-            valid_params.push_back(block_size*10000 + s);
-            }
-        }
+        dim_values[0].push_back(block_size);
+    dim_values[1] = Autotuner::getTppListPow2(this->m_exec_conf->dev_prop.warpSize);
+    std::vector<unsigned int> dim_weights = {10000, 1};
 
-    m_tuner.reset(new Autotuner(valid_params, 5, 100000, "pair_" + evaluator::getName(), this->m_exec_conf));
+    m_tuner.reset(new Autotuner(dim_values, dim_weights, 5, 100000, "pair_" + evaluator::getName(), this->m_exec_conf));
     #ifdef ENABLE_MPI
     // synchronize autotuner results across ranks
     m_tuner->setSync(bool(this->m_pdata->getDomainDecomposition()));
@@ -116,19 +114,16 @@ template< class evaluator, cudaError_t gpu_cpdf(const dpd_pair_args_t& pair_args
                                                 const typename evaluator::param_type *d_params) >
 void PotentialPairDPDThermoGPU< evaluator, gpu_cpdf >::computeForces(unsigned int timestep)
     {
-    this->m_nlist->compute(timestep);
+    if (this->m_cl)
+        this->computeCellList(timestep);
+    else
+        this->m_nlist->compute(timestep);
 
     // start the profile
     if (this->m_prof) this->m_prof->push(this->m_exec_conf, this->m_prof_name);
 
-    // The GPU implementation CANNOT handle a half neighborlist, error out now
-    bool third_law = this->m_nlist->getStorageMode() == NeighborList::half;
-    if (third_law)
-        {
-        this->m_exec_conf->msg->error() << "PotentialPairDPDThermoGPU cannot handle a half neighborlist"
-                  << std::endl << std::endl;
-        throw std::runtime_error("Error computing forces in PotentialPairDPDThermoGPU");
-        }
+    // with a half neighbor list, every pair is evaluated once and the forces are applied with atomics
+    bool third_law = !this->m_cl && this->m_nlist->getStorageMode() == NeighborList::half;
 
     // access the neighbor list
     ArrayHandle<unsigned int> d_n_neigh(this->m_nlist->getNNeighArray(), access_location::device, access_mode::read);
@@ -142,6 +137,16 @@ void PotentialPairDPDThermoGPU< evaluator, gpu_cpdf >::computeForces(unsigned in
 
     BoxDim box = this->m_pdata->getBox();
 
+    // pack the positions and velocities, so that the kernels read each neighbor in a single transaction
+    const unsigned int n_pack = this->m_pdata->getN() + this->m_pdata->getNGhosts();
+    if (m_posvel.getNumElements() < 2*this->m_pdata->getMaxN())
+        {
+        GlobalArray<Scalar4> posvel(2*this->m_pdata->getMaxN(), this->m_exec_conf);
+        m_posvel.swap(posvel);
+        }
+    ArrayHandle<Scalar4> d_posvel(m_posvel, access_location::device, access_mode::overwrite);
+    gpu_dpd_pack_posvel(d_posvel.data, d_pos.data, d_vel.data, d_tag.data, n_pack, 256);
+
     // access parameters
     ArrayHandle<Scalar> d_rcutsq(this->m_rcutsq, access_location::device, access_mode::read);
     ArrayHandle<typename evaluator::param_type> d_params(this->m_params, access_location::device, access_mode::read);
@@ -149,6 +154,11 @@ void PotentialPairDPDThermoGPU< evaluator, gpu_cpdf >::computeForces(unsigned in
     ArrayHandle<Scalar4> d_force(this->m_force, access_location::device, access_mode::overwrite);
     ArrayHandle<Scalar> d_virial(this->m_virial, access_location::device, access_mode::overwrite);
 
+    // access the cell list in the cell-pair mode
+    std::unique_ptr<CellPairCandidatesGPU> cell_data;
+    if (this->m_cl)
+        cell_data.reset(new CellPairCandidatesGPU(*this->m_cl, *this->m_nlist, *this->m_pdata));
+
     // access flags
     PDataFlags flags = this->m_pdata->getFlags();
 
@@ -165,6 +175,7 @@ void PotentialPairDPDThermoGPU< evaluator, gpu_cpdf >::computeForces(unsigned in
                              d_pos.data,
                              d_vel.data,
                              d_tag.data,
+                             d_posvel.data,
                              box,
                              d_n_neigh.data,
                              d_nlist.data,
@@ -179,9 +190,11 @@ void PotentialPairDPDThermoGPU< evaluator, gpu_cpdf >::computeForces(unsigned in
                              this->m_T->getValue(timestep),
                              this->m_shift_mode,
                              flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial],
+                             third_law,
                              threads_per_particle,
                              this->m_exec_conf->getComputeCapability()/10,
-                             this->m_exec_conf->dev_prop.maxTexture1DLinear),
+                             this->m_exec_conf->dev_prop.maxTexture1DLinear,
+                             cell_data ? &cell_data->getArgs() : NULL),
              d_params.data);
 
     if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
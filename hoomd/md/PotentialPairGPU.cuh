@@ -11,6 +11,11 @@
 
 #include "hoomd/GPUPartition.cuh"
 
+#include "CellPairCandidatesGPU.cuh"
+#include "NeighborListGPU.cuh"
+#include "NeighborListExclusionMask.h"
+#include "MDPrecisionSetup.h"
+
 #ifdef NVCC
 #include "hoomd/WarpTools.cuh"
 #endif // NVCC
@@ -29,6 +34,14 @@
 const int gpu_pair_force_max_tpp = 32;
 
 
+//! Special pairs of the neighbor list that are scaled in the pair force kernel
+struct special_pair_args_t
+    {
+    const unsigned int *d_tag;          //!< Particle tags
+    const unsigned int *d_special_mask; //!< Special pair mask per particle (see NeighborList::addSpecialPairsFromPairs())
+    Scalar scale;                       //!< Scale factor of the special pairs
+    };
+
 //! Wraps arguments to gpu_cgpf
 struct pair_args_t
     {
@@ -55,7 +68,13 @@ struct pair_args_t
               const unsigned int _threads_per_particle,
               const unsigned int _compute_capability,
               const unsigned int _max_tex1d_width,
-              const GPUPartition& _gpu_partition)
+              const GPUPartition& _gpu_partition,
+              const cell_pair_args_t *_cell_args = NULL,
+              const cluster_pair_args_t *_cluster_args = NULL,
+              const bool _accumulate = false,
+              const bool _compute_energy = true,
+              cudaStream_t _stream = 0,
+              const special_pair_args_t *_special_args = NULL)
                 : d_force(_d_force),
                   d_virial(_d_virial),
                   virial_pitch(_virial_pitch),
@@ -78,7 +97,13 @@ struct pair_args_t
                   threads_per_particle(_threads_per_particle),
                   compute_capability(_compute_capability),
                   max_tex1d_width(_max_tex1d_width),
-                  gpu_partition(_gpu_partition)
+                  gpu_partition(_gpu_partition),
+                  cell_args(_cell_args),
+                  cluster_args(_cluster_args),
+                  accumulate(_accumulate),
+                  compute_energy(_compute_energy),
+                  stream(_stream),
+                  special_args(_special_args)
         {
         };
 
@@ -105,6 +130,12 @@ struct pair_args_t
     const unsigned int compute_capability;  //!< Compute capability (20 30 35, ...)
     const unsigned int max_tex1d_width;     //!< Maximum width of a linear 1D texture
     const GPUPartition& gpu_partition;      //!< The load balancing partition of particles between GPUs
+    const cell_pair_args_t *cell_args;      //!< Cell list of the cell-pair mode, NULL when the nlist is used
+    const cluster_pair_args_t *cluster_args; //!< Cluster-pair list, NULL when the per particle nlist is used
+    const bool accumulate;                  //!< True to add to d_force and d_virial instead of overwriting them
+    const bool compute_energy;              //!< False to skip the potential energy (written as zero)
+    cudaStream_t stream;                    //!< Stream to launch the kernels in
+    const special_pair_args_t *special_args; //!< Special pairs to scale, NULL if there are none
     };
 
 #ifdef NVCC
@@ -122,6 +153,223 @@ scalar_tex_t pdata_charge_tex;
 //! Texture for reading neighbor list
 texture<unsigned int, 1, cudaReadModeElementType> pair_nlist_tex;
 
+//! Write out the force and virial of a particle
+/*! \param d_force Force array
+    \param d_virial Virial array
+    \param virial_pitch Pitch of the virial array
+    \param idx Index of the particle
+    \param force Force and energy of the particle
+    \param virial Virial of the particle, xx, xy, xz, yy, yz, zz
+    \param accumulate True to add to the arrays (e.g. the net force) instead of overwriting them
+
+    \tparam compute_virial When zero, the virial is not written. When 2, only the trace of the virial is written (see
+                           gpu_pair_force_accumulate())
+*/
+template<unsigned int compute_virial>
+__device__ inline void gpu_pair_force_store(Scalar4 *d_force,
+                                            Scalar *d_virial,
+                                            const unsigned int virial_pitch,
+                                            const unsigned int idx,
+                                            const Scalar4& force,
+                                            const Scalar *virial,
+                                            const bool accumulate)
+    {
+    if (accumulate)
+        {
+        Scalar4 f = d_force[idx];
+        d_force[idx] = make_scalar4(f.x + force.x, f.y + force.y, f.z + force.z, f.w + force.w);
+        }
+    else
+        d_force[idx] = force;
+
+    if (compute_virial == 1)
+        {
+        for (unsigned int k = 0; k < 6; ++k)
+            {
+            if (accumulate)
+                d_virial[k*virial_pitch+idx] += virial[k];
+            else
+                d_virial[k*virial_pitch+idx] = virial[k];
+            }
+        }
+    else if (compute_virial == 2)
+        {
+        // only the trace is computed, it is stored in the xx component. The off-diagonal components are not
+        // written, an accumulated net virial has its yy and zz components already zeroed
+        if (accumulate)
+            d_virial[idx] += virial[0];
+        else
+            {
+            d_virial[idx] = virial[0];
+            d_virial[3*virial_pitch+idx] = Scalar(0.0);
+            d_virial[5*virial_pitch+idx] = Scalar(0.0);
+            }
+        }
+    }
+
+//! Evaluate the force between a particle and one neighbor and add it to the accumulators
+/*! \param posi Position of particle i
+    \param typei Type of particle i
+    \param di Diameter of particle i (if needed)
+    \param qi Charge of particle i (if needed)
+    \param posj Position of the neighbor j
+    \param typej Type of the neighbor j
+    \param j Index of the neighbor j
+    \param d_diameter particle diameters
+    \param d_charge particle charges
+    \param box Box dimensions used to implement periodic boundary conditions
+    \param typpair_idx Indexer for the per type pair arrays
+    \param s_params Parameters for the potential (shared memory), stored per type pair
+    \param s_rcutsq rcut squared (shared memory), stored per type pair
+    \param s_ronsq ron squared (shared memory), stored per type pair
+    \param force Force and energy accumulator of particle i
+    \param virialxx Virial accumulator (xx component), and likewise for the other five components
+    \param scale Scale factor of the force, energy and virial of this pair
+
+    When \a single_type is non-zero, the system has a single particle type, the types of i and j are not read and
+    the parameters are taken from the first entry of \a s_params, \a s_rcutsq and \a s_ronsq.
+
+    This is the per pair evaluation shared by gpu_compute_pair_forces_shared_kernel(),
+    gpu_compute_pair_forces_cell_kernel() and gpu_compute_pair_forces_cluster_kernel(). The template parameters have the same meaning as in those kernels.
+
+    The displacement is wrapped into the box in Scalar, the force and virial of the pair are computed from it in
+    ForceReal, and added to the accumulators in Scalar (see MDPrecisionSetup.h).
+*/
+template< class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy,
+          unsigned int single_type = 0>
+__device__ inline void gpu_pair_force_accumulate(const Scalar3& posi,
+                                                 const unsigned int typei,
+                                                 const Scalar di,
+                                                 const Scalar qi,
+                                                 const Scalar3& posj,
+                                                 const unsigned int typej,
+                                                 const unsigned int j,
+                                                 const Scalar *d_diameter,
+                                                 const Scalar *d_charge,
+                                                 const BoxDim& box,
+                                                 const Index2D& typpair_idx,
+                                                 const typename evaluator::param_type *s_params,
+                                                 const Scalar *s_rcutsq,
+                                                 const Scalar *s_ronsq,
+                                                 Scalar4& force,
+                                                 Scalar& virialxx,
+                                                 Scalar& virialxy,
+                                                 Scalar& virialxz,
+                                                 Scalar& virialyy,
+                                                 Scalar& virialyz,
+                                                 Scalar& virialzz,
+                                                 const Scalar scale = Scalar(1.0))
+    {
+    Scalar dj = Scalar(0.0);
+    if (evaluator::needsDiameter())
+        dj = texFetchScalar(d_diameter, pdata_diam_tex, j);
+    else
+        dj += Scalar(1.0); // shut up compiler warning
+
+    Scalar qj = Scalar(0.0);
+    if (evaluator::needsCharge())
+        qj = texFetchScalar(d_charge, pdata_charge_tex, j);
+    else
+        qj += Scalar(1.0); // shut up compiler warning
+
+    // calculate dr (with periodic boundary conditions) (FLOPS: 3)
+    Scalar3 dx = posi - posj;
+
+    // apply periodic boundary conditions: (FLOPS 12)
+    dx = box.minImage(dx);
+
+    // the pair force is evaluated from the short relative vector
+    const ForceReal3 dxf = make_forcereal3(dx);
+
+    // calculate r squared (FLOPS: 5)
+    Scalar rsq = dxf.x*dxf.x + dxf.y*dxf.y + dxf.z*dxf.z;
+
+    // access the per type pair parameters
+    unsigned int typpair = single_type ? 0 : typpair_idx(typei, typej);
+    Scalar rcutsq = s_rcutsq[typpair];
+    typename evaluator::param_type param = s_params[typpair];
+    Scalar ronsq = Scalar(0.0);
+    if (shift_mode == 2)
+        ronsq = s_ronsq[typpair];
+
+    // design specifies that energies are shifted if
+    // 1) shift mode is set to shift
+    // or 2) shift mode is explor and ron > rcut
+    // the shift only changes the energy, it is skipped when the energy is not computed
+    bool energy_shift = false;
+    if (shift_mode == 1 && compute_energy)
+        energy_shift = true;
+    else if (shift_mode == 2 && compute_energy)
+        {
+        if (ronsq > rcutsq)
+            energy_shift = true;
+        }
+
+    // evaluate the potential
+    Scalar force_divr = Scalar(0.0);
+    Scalar pair_eng = Scalar(0.0);
+
+    evaluator eval(rsq, rcutsq, param);
+    if (evaluator::needsDiameter())
+        eval.setDiameter(di, dj);
+    if (evaluator::needsCharge())
+        eval.setCharge(qi, qj);
+
+    eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
+
+    if (shift_mode == 2)
+        {
+        if (rsq >= ronsq && rsq < rcutsq)
+            {
+            // Implement XPLOR smoothing (FLOPS: 16)
+            Scalar old_pair_eng = pair_eng;
+            Scalar old_force_divr = force_divr;
+
+            // calculate 1.0 / (xplor denominator)
+            Scalar xplor_denom_inv =
+                Scalar(1.0) / ((rcutsq - ronsq) * (rcutsq - ronsq) * (rcutsq - ronsq));
+
+            Scalar rsq_minus_r_cut_sq = rsq - rcutsq;
+            Scalar s = rsq_minus_r_cut_sq * rsq_minus_r_cut_sq *
+                       (rcutsq + Scalar(2.0) * rsq - Scalar(3.0) * ronsq) * xplor_denom_inv;
+            Scalar ds_dr_divr = Scalar(12.0) * (rsq - ronsq) * rsq_minus_r_cut_sq * xplor_denom_inv;
+
+            // make modifications to the old pair energy and force
+            pair_eng = old_pair_eng * s;
+            force_divr = s * old_force_divr - ds_dr_divr * old_pair_eng;
+            }
+        }
+
+    force_divr *= scale;
+    pair_eng *= scale;
+
+    // calculate the virial
+    if (compute_virial == 2)
+        {
+        // isotropic virial, only the trace is accumulated (in virialxx)
+        virialxx += rsq * Scalar(0.5) * force_divr;
+        }
+    else if (compute_virial)
+        {
+        ForceReal force_div2r = ForceReal(0.5) * ForceReal(force_divr);
+        virialxx +=  dxf.x * dxf.x * force_div2r;
+        virialxy +=  dxf.x * dxf.y * force_div2r;
+        virialxz +=  dxf.x * dxf.z * force_div2r;
+        virialyy +=  dxf.y * dxf.y * force_div2r;
+        virialyz +=  dxf.y * dxf.z * force_div2r;
+        virialzz +=  dxf.z * dxf.z * force_div2r;
+        }
+
+    // add up the force vector components (FLOPS: 7)
+    const ForceReal force_divr_f = ForceReal(force_divr);
+    force.x += dxf.x * force_divr_f;
+    force.y += dxf.y * force_divr_f;
+    force.z += dxf.z * force_divr_f;
+
+    if (compute_energy)
+        force.w += pair_eng;
+    }
+
 //! Kernel for calculating pair forces
 /*! This kernel is called to calculate the pair forces on all N particles. Actual evaluation of the potentials and
     forces for each pair is handled via the template class \a evaluator.
@@ -142,19 +390,27 @@ texture<unsigned int, 1, cudaReadModeElementType> pair_nlist_tex;
     \param d_ronsq ron squared, stored per type pair
     \param ntypes Number of types in the simulation
     \param offset Offset of first particle
+    \param accumulate True to add to the force and virial arrays instead of overwriting them
+    \param d_tag Particle tags (only read with \a d_special_mask)
+    \param d_special_mask Special pair mask per particle, NULL if there are no special pairs
+    \param special_scale Scale factor of the special pairs
 
     \a d_params, \a d_rcutsq, and \a d_ronsq must be indexed with an Index2DUpperTriangular(typei, typej) to access the
     unique value for that type pair. These values are all cached into shared memory for quick access, so a dynamic
     amount of shared memory must be allocated for this kernel launch. The amount is
     (2*sizeof(Scalar) + sizeof(typename evaluator::param_type)) * typpair_idx.getNumElements()
+    When \a single_type is set, the parameters of the only type pair are held in registers instead and no shared
+    memory is needed.
 
     Certain options are controlled via template parameters to avoid the performance hit when they are not enabled.
     \tparam evaluator EvaluatorPair class to evaluate V(r) and -delta V(r)/r
     \tparam shift_mode 0: No energy shifting is done. 1: V(r) is shifted to be 0 at rcut. 2: XPLOR switching is enabled
                        (See PotentialPair for a discussion on what that entails)
-    \tparam compute_virial When non-zero, the virial tensor is computed. When zero, the virial tensor is not computed.
+    \tparam compute_virial When 1, the virial tensor is computed. When 2, only its trace is computed. When zero, the virial is not computed.
+    \tparam compute_energy When zero, the potential energy is not computed and written as zero.
     \tparam use_gmem_nlist When non-zero, the neighbor list is read out of global memory. When zero, textures or __ldg
                            is used depending on architecture.
+    \tparam single_type When non-zero, \a ntypes is 1 and the per type pair parameters are not staged in shared memory
     \tparam tpp Number of threads to use per particle, must be power of 2 and smaller than warp size
 
     <b>Implementation details</b>
@@ -162,7 +418,7 @@ texture<unsigned int, 1, cudaReadModeElementType> pair_nlist_tex;
     Each group of \a tpp threads will calculate the total force on one particle.
     The neighborlist is arranged in columns so that reads are fully coalesced when doing this.
 */
-template< class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int use_gmem_nlist, int tpp>
+template< class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy, unsigned int use_gmem_nlist, unsigned int single_type, int tpp>
 __global__ void gpu_compute_pair_forces_shared_kernel(Scalar4 *d_force,
                                                Scalar *d_virial,
                                                const unsigned int virial_pitch,
@@ -178,7 +434,11 @@ __global__ void gpu_compute_pair_forces_shared_kernel(Scalar4 *d_force,
                                                const Scalar *d_rcutsq,
                                                const Scalar *d_ronsq,
                                                const unsigned int ntypes,
-                                               const unsigned int offset)
+                                               const unsigned int offset,
+                                               const bool accumulate,
+                                               const unsigned int *d_tag,
+                                               const unsigned int *d_special_mask,
+                                               const Scalar special_scale)
     {
     Index2D typpair_idx(ntypes);
     const unsigned int num_typ_parameters = typpair_idx.getNumElements();
@@ -190,18 +450,35 @@ __global__ void gpu_compute_pair_forces_shared_kernel(Scalar4 *d_force,
     Scalar *s_rcutsq = (Scalar *)(&s_data[num_typ_parameters*sizeof(evaluator::param_type)]);
     Scalar *s_ronsq = (Scalar *)(&s_data[num_typ_parameters*(sizeof(evaluator::param_type) + sizeof(Scalar))]);
 
-    // load in the per type pair parameters
-    for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
+    // with a single type, every thread keeps the only parameter set in registers
+    typename evaluator::param_type r_params;
+    Scalar r_rcutsq;
+    Scalar r_ronsq = Scalar(0.0);
+    if (single_type)
         {
-        if (cur_offset + threadIdx.x < num_typ_parameters)
+        r_params = d_params[0];
+        r_rcutsq = d_rcutsq[0];
+        if (shift_mode == 2)
+            r_ronsq = d_ronsq[0];
+        s_params = &r_params;
+        s_rcutsq = &r_rcutsq;
+        s_ronsq = &r_ronsq;
+        }
+    else
+        {
+        // load in the per type pair parameters
+        for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
             {
-            s_rcutsq[cur_offset + threadIdx.x] = d_rcutsq[cur_offset + threadIdx.x];
-            s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
-            if (shift_mode == 2)
-                s_ronsq[cur_offset + threadIdx.x] = d_ronsq[cur_offset + threadIdx.x];
+            if (cur_offset + threadIdx.x < num_typ_parameters)
+                {
+                s_rcutsq[cur_offset + threadIdx.x] = d_rcutsq[cur_offset + threadIdx.x];
+                s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
+                if (shift_mode == 2)
+                    s_ronsq[cur_offset + threadIdx.x] = d_ronsq[cur_offset + threadIdx.x];
+                }
             }
+        __syncthreads();
         }
-    __syncthreads();
 
     // start by identifying which particle we are to handle
     unsigned int idx = blockIdx.x * (blockDim.x/tpp) + threadIdx.x/tpp;
@@ -245,6 +522,15 @@ __global__ void gpu_compute_pair_forces_shared_kernel(Scalar4 *d_force,
         else
             qi += Scalar(1.0); // shut up compiler warning
 
+        // the special pairs of particle i are flagged by tag
+        unsigned int sp_mask_i = 0;
+        unsigned int tag_i = 0;
+        if (d_special_mask)
+            {
+            sp_mask_i = d_special_mask[idx];
+            tag_i = d_tag[idx];
+            }
+
         unsigned int my_head = d_head_list[idx];
         unsigned int cur_j = 0;
 
@@ -279,99 +565,186 @@ __global__ void gpu_compute_pair_forces_shared_kernel(Scalar4 *d_force,
                 Scalar4 postypej = texFetchScalar4(d_pos, pdata_pos_tex, cur_j);
                 Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
 
-                Scalar dj = Scalar(0.0);
-                if (evaluator::needsDiameter())
-                    dj = texFetchScalar(d_diameter, pdata_diam_tex, cur_j);
-                else
-                    dj += Scalar(1.0); // shut up compiler warning
+                Scalar scale = Scalar(1.0);
+                if (sp_mask_i && isExcludedByMask(sp_mask_i, tag_i, d_tag[cur_j]))
+                    scale = special_scale;
 
-                Scalar qj = Scalar(0.0);
-                if (evaluator::needsCharge())
-                    qj = texFetchScalar(d_charge, pdata_charge_tex, cur_j);
-                else
-                    qj += Scalar(1.0); // shut up compiler warning
+                gpu_pair_force_accumulate<evaluator, shift_mode, compute_virial, compute_energy, single_type>(posi,
+                    __scalar_as_int(postypei.w), di, qi, posj, __scalar_as_int(postypej.w), cur_j, d_diameter,
+                    d_charge, box, typpair_idx, s_params, s_rcutsq, s_ronsq,
+                    force, virialxx, virialxy, virialxz, virialyy, virialyz, virialzz, scale);
+                }
+            }
 
-                // calculate dr (with periodic boundary conditions) (FLOPS: 3)
-                Scalar3 dx = posi - posj;
+        // potential energy per particle must be halved
+        force.w *= Scalar(0.5);
+        }
 
-                // apply periodic boundary conditions: (FLOPS 12)
-                dx = box.minImage(dx);
+    // reduce force over threads in cta
+    hoomd::detail::WarpReduce<Scalar, tpp> reducer;
+    force.x = reducer.Sum(force.x);
+    force.y = reducer.Sum(force.y);
+    force.z = reducer.Sum(force.z);
+    if (compute_energy)
+        force.w = reducer.Sum(force.w);
 
-                // calculate r squared (FLOPS: 5)
-                Scalar rsq = dot(dx, dx);
+    if (compute_virial == 2)
+        {
+        virialxx = reducer.Sum(virialxx);
+        }
+    else if (compute_virial)
+        {
+        virialxx = reducer.Sum(virialxx);
+        virialxy = reducer.Sum(virialxy);
+        virialxz = reducer.Sum(virialxz);
+        virialyy = reducer.Sum(virialyy);
+        virialyz = reducer.Sum(virialyz);
+        virialzz = reducer.Sum(virialzz);
+        }
 
-                // access the per type pair parameters
-                unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypej.w));
-                Scalar rcutsq = s_rcutsq[typpair];
-                typename evaluator::param_type param = s_params[typpair];
-                Scalar ronsq = Scalar(0.0);
-                if (shift_mode == 2)
-                    ronsq = s_ronsq[typpair];
-
-                // design specifies that energies are shifted if
-                // 1) shift mode is set to shift
-                // or 2) shift mode is explor and ron > rcut
-                bool energy_shift = false;
-                if (shift_mode == 1)
-                    energy_shift = true;
-                else if (shift_mode == 2)
-                    {
-                    if (ronsq > rcutsq)
-                        energy_shift = true;
-                    }
+    // now that the force calculation is complete, write out the result (MEM TRANSFER: 20 bytes)
+    if (active && threadIdx.x % tpp == 0)
+        {
+        Scalar virial[6] = {virialxx, virialxy, virialxz, virialyy, virialyz, virialzz};
+        gpu_pair_force_store<compute_virial>(d_force, d_virial, virial_pitch, idx, force, virial, accumulate);
+        }
+    }
 
-                // evaluate the potential
-                Scalar force_divr = Scalar(0.0);
-                Scalar pair_eng = Scalar(0.0);
+//! Kernel for calculating pair forces directly from a cell list
+/*! This kernel is the cell-pair mode counterpart of gpu_compute_pair_forces_shared_kernel(). Instead of reading a
+    neighbor list, each group of \a tpp threads loops over the adjacent cells of its particle, and the threads of
+    the group stride over the particles in each cell. Candidates are rejected with cell_pair_rejected() and all
+    others are passed to the evaluator, which discards the pairs beyond the cutoff.
 
-                evaluator eval(rsq, rcutsq, param);
-                if (evaluator::needsDiameter())
-                    eval.setDiameter(di, dj);
-                if (evaluator::needsCharge())
-                    eval.setCharge(qi, qj);
+    \param d_force Device memory to write computed forces
+    \param d_virial Device memory to write computed virials
+    \param virial_pitch pitch of 2D virial array
+    \param N number of particles in system
+    \param d_pos particle positions
+    \param d_diameter particle diameters
+    \param d_charge particle charges
+    \param box Box dimensions used to implement periodic boundary conditions
+    \param cell_args Cell list and exclusion data
+    \param d_params Parameters for the potential, stored per type pair
+    \param d_rcutsq rcut squared, stored per type pair
+    \param d_ronsq ron squared, stored per type pair
+    \param ntypes Number of types in the simulation
+    \param offset Offset of first particle
+    \param accumulate True to add to the force and virial arrays instead of overwriting them
 
-                eval.evalForceAndEnergy(force_divr, pair_eng, energy_shift);
+    \tparam evaluator EvaluatorPair class to evaluate V(r) and -delta V(r)/r
+    \tparam shift_mode 0: No energy shifting is done. 1: V(r) is shifted to be 0 at rcut. 2: XPLOR switching is enabled
+    \tparam compute_virial When 1, the virial tensor is computed. When 2, only its trace is computed. When zero, the virial is not computed.
+    \tparam compute_energy When zero, the potential energy is not computed and written as zero.
+    \tparam tpp Number of threads to use per particle, must be power of 2 and smaller than warp size
+*/
+template< class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy, int tpp>
+__global__ void gpu_compute_pair_forces_cell_kernel(Scalar4 *d_force,
+                                                    Scalar *d_virial,
+                                                    const unsigned int virial_pitch,
+                                                    const unsigned int N,
+                                                    const Scalar4 *d_pos,
+                                                    const Scalar *d_diameter,
+                                                    const Scalar *d_charge,
+                                                    const BoxDim box,
+                                                    const cell_pair_args_t cell_args,
+                                                    const typename evaluator::param_type *d_params,
+                                                    const Scalar *d_rcutsq,
+                                                    const Scalar *d_ronsq,
+                                                    const unsigned int ntypes,
+                                                    const unsigned int offset,
+                                                    const bool accumulate)
+    {
+    Index2D typpair_idx(ntypes);
+    const unsigned int num_typ_parameters = typpair_idx.getNumElements();
 
-                if (shift_mode == 2)
-                    {
-                    if (rsq >= ronsq && rsq < rcutsq)
-                        {
-                        // Implement XPLOR smoothing (FLOPS: 16)
-                        Scalar old_pair_eng = pair_eng;
-                        Scalar old_force_divr = force_divr;
-
-                        // calculate 1.0 / (xplor denominator)
-                        Scalar xplor_denom_inv =
-                            Scalar(1.0) / ((rcutsq - ronsq) * (rcutsq - ronsq) * (rcutsq - ronsq));
-
-                        Scalar rsq_minus_r_cut_sq = rsq - rcutsq;
-                        Scalar s = rsq_minus_r_cut_sq * rsq_minus_r_cut_sq *
-                                   (rcutsq + Scalar(2.0) * rsq - Scalar(3.0) * ronsq) * xplor_denom_inv;
-                        Scalar ds_dr_divr = Scalar(12.0) * (rsq - ronsq) * rsq_minus_r_cut_sq * xplor_denom_inv;
-
-                        // make modifications to the old pair energy and force
-                        pair_eng = old_pair_eng * s;
-                        force_divr = s * old_force_divr - ds_dr_divr * old_pair_eng;
-                        }
-                    }
-                // calculate the virial
-                if (compute_virial)
-                    {
-                    Scalar force_div2r = Scalar(0.5) * force_divr;
-                    virialxx +=  dx.x * dx.x * force_div2r;
-                    virialxy +=  dx.x * dx.y * force_div2r;
-                    virialxz +=  dx.x * dx.z * force_div2r;
-                    virialyy +=  dx.y * dx.y * force_div2r;
-                    virialyz +=  dx.y * dx.z * force_div2r;
-                    virialzz +=  dx.z * dx.z * force_div2r;
-                    }
+    // shared arrays for per type pair parameters
+    extern __shared__ char s_data[];
+    typename evaluator::param_type *s_params =
+        (typename evaluator::param_type *)(&s_data[0]);
+    Scalar *s_rcutsq = (Scalar *)(&s_data[num_typ_parameters*sizeof(evaluator::param_type)]);
+    Scalar *s_ronsq = (Scalar *)(&s_data[num_typ_parameters*(sizeof(evaluator::param_type) + sizeof(Scalar))]);
+
+    // load in the per type pair parameters
+    for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
+        {
+        if (cur_offset + threadIdx.x < num_typ_parameters)
+            {
+            s_rcutsq[cur_offset + threadIdx.x] = d_rcutsq[cur_offset + threadIdx.x];
+            s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
+            if (shift_mode == 2)
+                s_ronsq[cur_offset + threadIdx.x] = d_ronsq[cur_offset + threadIdx.x];
+            }
+        }
+    __syncthreads();
+
+    // start by identifying which particle we are to handle
+    unsigned int idx = blockIdx.x * (blockDim.x/tpp) + threadIdx.x/tpp;
+    bool active = true;
+    if (idx >= N)
+        {
+        // need to mask this thread, but still participate in warp-level reduction
+        active = false;
+        }
+
+    // add offset to get actual particle index
+    idx += offset;
+
+    // initialize the force to 0
+    Scalar4 force = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
+    Scalar virialxx = Scalar(0.0);
+    Scalar virialxy = Scalar(0.0);
+    Scalar virialxz = Scalar(0.0);
+    Scalar virialyy = Scalar(0.0);
+    Scalar virialyz = Scalar(0.0);
+    Scalar virialzz = Scalar(0.0);
+
+    if (active)
+        {
+        // read in the position of our particle.
+        Scalar4 postypei = texFetchScalar4(d_pos, pdata_pos_tex, idx);
+        Scalar3 posi = make_scalar3(postypei.x, postypei.y, postypei.z);
+        unsigned int typei = __scalar_as_int(postypei.w);
+
+        Scalar di;
+        if (evaluator::needsDiameter())
+            di = texFetchScalar(d_diameter, pdata_diam_tex, idx);
+        else
+            di += Scalar(1.0); // shut up compiler warning
+        Scalar qi;
+        if (evaluator::needsCharge())
+            qi = texFetchScalar(d_charge, pdata_charge_tex, idx);
+        else
+            qi += Scalar(1.0); // shut up compiler warning
+
+        const unsigned int body_i = cell_args.d_body[idx];
+        const unsigned int tag_i = cell_args.d_tag[idx];
+        const unsigned int n_ex_i = cell_args.d_n_ex_tag ? cell_args.d_n_ex_tag[tag_i] : 0;
+
+        const unsigned int my_cell = cell_pair_get_cell(posi, box, cell_args);
+
+        // loop over all neighboring cells, the threads of this particle share the members of each cell
+        for (unsigned int cur_adj = 0; cur_adj < cell_args.cadji.getW(); cur_adj++)
+            {
+            const unsigned int neigh_cell = cell_args.d_cell_adj[cell_args.cadji(cur_adj, my_cell)];
+            const unsigned int size = cell_args.d_cell_size[neigh_cell];
+
+            for (unsigned int cur_offset = threadIdx.x%tpp; cur_offset < size; cur_offset += tpp)
+                {
+                // the cell list stores the position and index of the candidate (MEM TRANSFER: 16 bytes)
+                const Scalar4 cur_xyzf = cell_args.d_cell_xyzf[cell_args.cli(cur_offset, neigh_cell)];
+                const unsigned int cur_j = __scalar_as_int(cur_xyzf.w);
+
+                if (cell_pair_rejected(idx, cur_j, body_i, tag_i, n_ex_i, cell_args))
+                    continue;
 
-                // add up the force vector components (FLOPS: 7)
-                force.x += dx.x * force_divr;
-                force.y += dx.y * force_divr;
-                force.z += dx.z * force_divr;
+                // the type is not part of the cell list (MEM TRANSFER: 16 bytes)
+                unsigned int typej = __scalar_as_int(texFetchScalar4(d_pos, pdata_pos_tex, cur_j).w);
+                Scalar3 posj = make_scalar3(cur_xyzf.x, cur_xyzf.y, cur_xyzf.z);
 
-                force.w += pair_eng;
+                gpu_pair_force_accumulate<evaluator, shift_mode, compute_virial, compute_energy>(posi, typei, di, qi, posj, typej,
+                    cur_j, d_diameter, d_charge, box, typpair_idx, s_params, s_rcutsq, s_ronsq,
+                    force, virialxx, virialxy, virialxz, virialyy, virialyz, virialzz);
                 }
             }
 
@@ -384,13 +757,200 @@ __global__ void gpu_compute_pair_forces_shared_kernel(Scalar4 *d_force,
     force.x = reducer.Sum(force.x);
     force.y = reducer.Sum(force.y);
     force.z = reducer.Sum(force.z);
-    force.w = reducer.Sum(force.w);
+    if (compute_energy)
+        force.w = reducer.Sum(force.w);
+
+    if (compute_virial == 2)
+        {
+        virialxx = reducer.Sum(virialxx);
+        }
+    else if (compute_virial)
+        {
+        virialxx = reducer.Sum(virialxx);
+        virialxy = reducer.Sum(virialxy);
+        virialxz = reducer.Sum(virialxz);
+        virialyy = reducer.Sum(virialyy);
+        virialyz = reducer.Sum(virialyz);
+        virialzz = reducer.Sum(virialzz);
+        }
 
     // now that the force calculation is complete, write out the result (MEM TRANSFER: 20 bytes)
     if (active && threadIdx.x % tpp == 0)
-        d_force[idx] = force;
+        {
+        Scalar virial[6] = {virialxx, virialxy, virialxz, virialyy, virialyz, virialzz};
+        gpu_pair_force_store<compute_virial>(d_force, d_virial, virial_pitch, idx, force, virial, accumulate);
+        }
+    }
+
+//! Kernel for calculating pair forces from a cluster-pair list
+/*! Each block of gpu_nlist_cluster_size^2 threads processes one i-cluster. Thread t handles particle t/8 of the
+    i-cluster and particle t%8 of the j-clusters, so that bit t of the interaction mask decides whether the thread
+    evaluates its pair. The positions of up to 8 j-clusters are staged in shared memory at a time and reused by all
+    particles of the i-cluster. The contributions of the 8 threads of a particle are summed with a sub-warp reduction.
+
+    \param d_force Device memory to write computed forces
+    \param d_virial Device memory to write computed virials
+    \param virial_pitch pitch of 2D virial array
+    \param first Index of the first particle this GPU processes
+    \param last Index past the last particle this GPU processes
+    \param n_max Size of the particle data arrays
+    \param d_pos particle positions
+    \param d_diameter particle diameters
+    \param d_charge particle charges
+    \param box Box dimensions used to implement periodic boundary conditions
+    \param cluster_args Cluster-pair list
+    \param d_params Parameters for the potential, stored per type pair
+    \param d_rcutsq rcut squared, stored per type pair
+    \param d_ronsq ron squared, stored per type pair
+    \param ntypes Number of types in the simulation
+    \param accumulate True to add to the force and virial arrays instead of overwriting them
+
+    \tparam evaluator EvaluatorPair class to evaluate V(r) and -delta V(r)/r
+    \tparam shift_mode 0: No energy shifting is done. 1: V(r) is shifted to be 0 at rcut. 2: XPLOR switching is enabled
+    \tparam compute_virial When 1, the virial tensor is computed. When 2, only its trace is computed. When zero, the virial is not computed.
+    \tparam compute_energy When zero, the potential energy is not computed and written as zero.
+*/
+template< class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy>
+__global__ void gpu_compute_pair_forces_cluster_kernel(Scalar4 *d_force,
+                                                       Scalar *d_virial,
+                                                       const unsigned int virial_pitch,
+                                                       const unsigned int first,
+                                                       const unsigned int last,
+                                                       const unsigned int n_max,
+                                                       const Scalar4 *d_pos,
+                                                       const Scalar *d_diameter,
+                                                       const Scalar *d_charge,
+                                                       const BoxDim box,
+                                                       const cluster_pair_args_t cluster_args,
+                                                       const typename evaluator::param_type *d_params,
+                                                       const Scalar *d_rcutsq,
+                                                       const Scalar *d_ronsq,
+                                                       const unsigned int ntypes,
+                                                       const bool accumulate)
+    {
+    Index2D typpair_idx(ntypes);
+    const unsigned int num_typ_parameters = typpair_idx.getNumElements();
+
+    // shared arrays for per type pair parameters
+    extern __shared__ char s_data[];
+    typename evaluator::param_type *s_params =
+        (typename evaluator::param_type *)(&s_data[0]);
+    Scalar *s_rcutsq = (Scalar *)(&s_data[num_typ_parameters*sizeof(evaluator::param_type)]);
+    Scalar *s_ronsq = (Scalar *)(&s_data[num_typ_parameters*(sizeof(evaluator::param_type) + sizeof(Scalar))]);
+
+    // staged j-clusters
+    __shared__ Scalar4 s_posj[gpu_nlist_cluster_size*gpu_nlist_cluster_size];
+    __shared__ uint2 s_mask[gpu_nlist_cluster_size];
+    __shared__ unsigned int s_jc[gpu_nlist_cluster_size];
 
-    if (compute_virial)
+    // load in the per type pair parameters
+    for (unsigned int cur_offset = 0; cur_offset < num_typ_parameters; cur_offset += blockDim.x)
+        {
+        if (cur_offset + threadIdx.x < num_typ_parameters)
+            {
+            s_rcutsq[cur_offset + threadIdx.x] = d_rcutsq[cur_offset + threadIdx.x];
+            s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
+            if (shift_mode == 2)
+                s_ronsq[cur_offset + threadIdx.x] = d_ronsq[cur_offset + threadIdx.x];
+            }
+        }
+
+    const unsigned int ic = blockIdx.x + first / gpu_nlist_cluster_size;
+    const unsigned int i_local = threadIdx.x / gpu_nlist_cluster_size;
+    const unsigned int j_local = threadIdx.x % gpu_nlist_cluster_size;
+
+    // threads outside of the range of this GPU still stage data and participate in the reduction
+    const unsigned int idx = ic*gpu_nlist_cluster_size + i_local;
+    const bool active = idx >= first && idx < last;
+
+    // initialize the force to 0
+    Scalar4 force = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
+    Scalar virialxx = Scalar(0.0);
+    Scalar virialxy = Scalar(0.0);
+    Scalar virialxz = Scalar(0.0);
+    Scalar virialyy = Scalar(0.0);
+    Scalar virialyz = Scalar(0.0);
+    Scalar virialzz = Scalar(0.0);
+
+    Scalar3 posi = make_scalar3(Scalar(0.0), Scalar(0.0), Scalar(0.0));
+    unsigned int typei = 0;
+    Scalar di = Scalar(0.0);
+    Scalar qi = Scalar(0.0);
+    if (active)
+        {
+        Scalar4 postypei = texFetchScalar4(d_pos, pdata_pos_tex, idx);
+        posi = make_scalar3(postypei.x, postypei.y, postypei.z);
+        typei = __scalar_as_int(postypei.w);
+
+        if (evaluator::needsDiameter())
+            di = texFetchScalar(d_diameter, pdata_diam_tex, idx);
+        if (evaluator::needsCharge())
+            qi = texFetchScalar(d_charge, pdata_charge_tex, idx);
+        }
+
+    const unsigned int n_cluster_pairs = cluster_args.d_cluster_n[ic];
+    for (unsigned int base = 0; base < n_cluster_pairs; base += gpu_nlist_cluster_size)
+        {
+        // wait until the previous batch is consumed (and the parameters are loaded)
+        __syncthreads();
+
+        // each group of 8 threads stages one j-cluster
+        const unsigned int cur_pair = base + i_local;
+        if (cur_pair < n_cluster_pairs)
+            {
+            const unsigned int jc = cluster_args.d_cluster_list[cluster_args.cluster_indexer(cur_pair, ic)];
+            const unsigned int j = jc*gpu_nlist_cluster_size + j_local;
+            s_posj[threadIdx.x] = (j < n_max) ? texFetchScalar4(d_pos, pdata_pos_tex, j)
+                                              : make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
+            if (j_local == 0)
+                {
+                s_jc[i_local] = jc;
+                s_mask[i_local] = cluster_args.d_cluster_mask[cluster_args.cluster_indexer(cur_pair, ic)];
+                }
+            }
+        else if (j_local == 0)
+            {
+            s_mask[i_local] = make_uint2(0, 0);
+            }
+        __syncthreads();
+
+        if (active)
+            {
+            for (unsigned int k = 0; k < gpu_nlist_cluster_size; k++)
+                {
+                // bit threadIdx.x of the mask marks the pair (i_local, j_local)
+                const uint2 mask = s_mask[k];
+                const unsigned int word = (threadIdx.x < 32) ? mask.x : mask.y;
+                if (!((word >> (threadIdx.x % 32)) & 1))
+                    continue;
+
+                const Scalar4 postypej = s_posj[k*gpu_nlist_cluster_size + j_local];
+                Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
+                unsigned int typej = __scalar_as_int(postypej.w);
+
+                gpu_pair_force_accumulate<evaluator, shift_mode, compute_virial, compute_energy>(posi, typei, di, qi, posj, typej,
+                    s_jc[k]*gpu_nlist_cluster_size + j_local, d_diameter, d_charge, box, typpair_idx, s_params,
+                    s_rcutsq, s_ronsq, force, virialxx, virialxy, virialxz, virialyy, virialyz, virialzz);
+                }
+            }
+        }
+
+    // potential energy per particle must be halved
+    force.w *= Scalar(0.5);
+
+    // reduce force over the threads of a particle
+    hoomd::detail::WarpReduce<Scalar, gpu_nlist_cluster_size> reducer;
+    force.x = reducer.Sum(force.x);
+    force.y = reducer.Sum(force.y);
+    force.z = reducer.Sum(force.z);
+    if (compute_energy)
+        force.w = reducer.Sum(force.w);
+
+    if (compute_virial == 2)
+        {
+        virialxx = reducer.Sum(virialxx);
+        }
+    else if (compute_virial)
         {
         virialxx = reducer.Sum(virialxx);
         virialxy = reducer.Sum(virialxy);
@@ -398,17 +958,13 @@ __global__ void gpu_compute_pair_forces_shared_kernel(Scalar4 *d_force,
         virialyy = reducer.Sum(virialyy);
         virialyz = reducer.Sum(virialyz);
         virialzz = reducer.Sum(virialzz);
+        }
 
-        // if we are the first thread in the cta, write out virial to global mem
-        if (active && threadIdx.x %tpp == 0)
-            {
-            d_virial[0*virial_pitch+idx] = virialxx;
-            d_virial[1*virial_pitch+idx] = virialxy;
-            d_virial[2*virial_pitch+idx] = virialxz;
-            d_virial[3*virial_pitch+idx] = virialyy;
-            d_virial[4*virial_pitch+idx] = virialyz;
-            d_virial[5*virial_pitch+idx] = virialzz;
-            }
+    // now that the force calculation is complete, write out the result (MEM TRANSFER: 20 bytes)
+    if (active && j_local == 0)
+        {
+        Scalar virial[6] = {virialxx, virialxy, virialxz, virialyy, virialyz, virialzz};
+        gpu_pair_force_store<compute_virial>(d_force, d_virial, virial_pitch, idx, force, virial, accumulate);
         }
     }
 
@@ -465,15 +1021,17 @@ inline void gpu_pair_force_unbind_textures(const pair_args_t pair_args)
  * \tparam evaluator EvaluatorPair class to evaluate V(r) and -delta V(r)/r
  * \tparam shift_mode 0: No energy shifting is done. 1: V(r) is shifted to be 0 at rcut. 2: XPLOR switching is enabled
  *                       (See PotentialPair for a discussion on what that entails)
- * \tparam compute_virial When non-zero, the virial tensor is computed. When zero, the virial tensor is not computed.
+ * \tparam compute_virial When 1, the virial tensor is computed. When 2, only its trace is computed. When zero, the virial is not computed.
+ * \tparam compute_energy When zero, the potential energy is not computed and written as zero.
  * \tparam use_gmem_nlist When non-zero, the neighbor list is read out of global memory. When zero, textures or __ldg
  *                        is used depending on architecture.
+ * \tparam single_type When non-zero, the system has a single particle type
  * \tparam tpp Number of threads to use per particle, must be power of 2 and smaller than warp size
  *
  * Partial function template specialization is not allowed in C++, so instead we have to wrap this with a struct that
  * we are allowed to partially specialize.
  */
-template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int use_gmem_nlist, int tpp>
+template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy, unsigned int use_gmem_nlist, unsigned int single_type, int tpp>
 struct PairForceComputeKernel
     {
     //! Launcher for the pair force kernel
@@ -496,36 +1054,40 @@ struct PairForceComputeKernel
             unsigned int block_size = pair_args.block_size;
 
             Index2D typpair_idx(pair_args.ntypes);
-            unsigned int shared_bytes = (2*sizeof(Scalar) + sizeof(typename evaluator::param_type))
+            unsigned int shared_bytes = single_type ? 0 : (2*sizeof(Scalar) + sizeof(typename evaluator::param_type))
                                         * typpair_idx.getNumElements();
 
             static unsigned int max_block_size = UINT_MAX;
             if (max_block_size == UINT_MAX)
-                max_block_size = get_max_block_size(gpu_compute_pair_forces_shared_kernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, tpp>);
+                max_block_size = get_max_block_size(gpu_compute_pair_forces_shared_kernel<evaluator, shift_mode, compute_virial, compute_energy, use_gmem_nlist, single_type, tpp>);
 
             if (pair_args.compute_capability < 35) gpu_pair_force_bind_textures(pair_args);
 
             block_size = block_size < max_block_size ? block_size : max_block_size;
             dim3 grid(N / (block_size/tpp) + 1, 1, 1);
 
-            gpu_compute_pair_forces_shared_kernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, tpp>
-              <<<grid, block_size, shared_bytes>>>(pair_args.d_force, pair_args.d_virial,
+            gpu_compute_pair_forces_shared_kernel<evaluator, shift_mode, compute_virial, compute_energy, use_gmem_nlist, single_type, tpp>
+              <<<grid, block_size, shared_bytes, pair_args.stream>>>(pair_args.d_force, pair_args.d_virial,
               pair_args.virial_pitch, N, pair_args.d_pos, pair_args.d_diameter,
               pair_args.d_charge, pair_args.box, pair_args.d_n_neigh, pair_args.d_nlist,
-              pair_args.d_head_list, d_params, pair_args.d_rcutsq, pair_args.d_ronsq, pair_args.ntypes, offset);
+              pair_args.d_head_list, d_params, pair_args.d_rcutsq, pair_args.d_ronsq, pair_args.ntypes, offset,
+              pair_args.accumulate,
+              pair_args.special_args ? pair_args.special_args->d_tag : NULL,
+              pair_args.special_args ? pair_args.special_args->d_special_mask : NULL,
+              pair_args.special_args ? pair_args.special_args->scale : Scalar(1.0));
 
             if (pair_args.compute_capability < 35) gpu_pair_force_unbind_textures(pair_args);
             }
         else
             {
-            PairForceComputeKernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, tpp/2>::launch(pair_args, range, d_params);
+            PairForceComputeKernel<evaluator, shift_mode, compute_virial, compute_energy, use_gmem_nlist, single_type, tpp/2>::launch(pair_args, range, d_params);
             }
         }
     };
 
 //! Template specialization to do nothing for the tpp = 0 case
-template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int use_gmem_nlist>
-struct PairForceComputeKernel<evaluator, shift_mode, compute_virial, use_gmem_nlist, 0>
+template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy, unsigned int use_gmem_nlist, unsigned int single_type>
+struct PairForceComputeKernel<evaluator, shift_mode, compute_virial, compute_energy, use_gmem_nlist, single_type, 0>
     {
     static void launch(const pair_args_t& pair_args, std::pair<unsigned int, unsigned int> range, const typename evaluator::param_type *d_params)
         {
@@ -533,11 +1095,239 @@ struct PairForceComputeKernel<evaluator, shift_mode, compute_virial, use_gmem_nl
         }
     };
 
+//! Cell-pair force compute kernel launcher
+/*!
+ * \tparam evaluator EvaluatorPair class to evaluate V(r) and -delta V(r)/r
+ * \tparam shift_mode 0: No energy shifting is done. 1: V(r) is shifted to be 0 at rcut. 2: XPLOR switching is enabled
+ * \tparam compute_virial When 1, the virial tensor is computed. When 2, only its trace is computed. When zero, the virial is not computed.
+ * \tparam compute_energy When zero, the potential energy is not computed and written as zero.
+ * \tparam tpp Number of threads to use per particle, must be power of 2 and smaller than warp size
+ */
+template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy, int tpp>
+struct PairForceComputeCellKernel
+    {
+    //! Launcher for the cell-pair force kernel
+    /*!
+     * \param pair_args Other arguments to pass onto the kernel
+     * \param range Range of particle indices this GPU operates on
+     * \param d_params Parameters for the potential, stored per type pair
+     */
+    static void launch(const pair_args_t& pair_args,
+        std::pair<unsigned int, unsigned int> range,
+        const typename evaluator::param_type *d_params)
+        {
+        unsigned int N = range.second - range.first;
+        unsigned int offset = range.first;
+
+        if (tpp == pair_args.threads_per_particle)
+            {
+            unsigned int block_size = pair_args.block_size;
+
+            Index2D typpair_idx(pair_args.ntypes);
+            unsigned int shared_bytes = (2*sizeof(Scalar) + sizeof(typename evaluator::param_type))
+                                        * typpair_idx.getNumElements();
+
+            static unsigned int max_block_size = UINT_MAX;
+            if (max_block_size == UINT_MAX)
+                max_block_size = get_max_block_size(gpu_compute_pair_forces_cell_kernel<evaluator, shift_mode, compute_virial, compute_energy, tpp>);
+
+            if (pair_args.compute_capability < 35) gpu_pair_force_bind_textures(pair_args);
+
+            block_size = block_size < max_block_size ? block_size : max_block_size;
+            dim3 grid(N / (block_size/tpp) + 1, 1, 1);
+
+            gpu_compute_pair_forces_cell_kernel<evaluator, shift_mode, compute_virial, compute_energy, tpp>
+              <<<grid, block_size, shared_bytes, pair_args.stream>>>(pair_args.d_force, pair_args.d_virial,
+              pair_args.virial_pitch, N, pair_args.d_pos, pair_args.d_diameter,
+              pair_args.d_charge, pair_args.box, *pair_args.cell_args, d_params, pair_args.d_rcutsq,
+              pair_args.d_ronsq, pair_args.ntypes, offset, pair_args.accumulate);
+
+            if (pair_args.compute_capability < 35) gpu_pair_force_unbind_textures(pair_args);
+            }
+        else
+            {
+            PairForceComputeCellKernel<evaluator, shift_mode, compute_virial, compute_energy, tpp/2>::launch(pair_args, range, d_params);
+            }
+        }
+    };
+
+//! Template specialization to do nothing for the tpp = 0 case
+template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy>
+struct PairForceComputeCellKernel<evaluator, shift_mode, compute_virial, compute_energy, 0>
+    {
+    static void launch(const pair_args_t& pair_args, std::pair<unsigned int, unsigned int> range, const typename evaluator::param_type *d_params)
+        {
+        // do nothing
+        }
+    };
+
+//! Cluster-pair force compute kernel launcher
+/*!
+ * \param pair_args Other arguments to pass onto the kernel
+ * \param range Range of particle indices this GPU operates on
+ * \param d_params Parameters for the potential, stored per type pair
+ *
+ * \tparam evaluator EvaluatorPair class to evaluate V(r) and -delta V(r)/r
+ * \tparam shift_mode 0: No energy shifting is done. 1: V(r) is shifted to be 0 at rcut. 2: XPLOR switching is enabled
+ * \tparam compute_virial When 1, the virial tensor is computed. When 2, only its trace is computed. When zero, the virial is not computed.
+ * \tparam compute_energy When zero, the potential energy is not computed and written as zero.
+ *
+ * The block size is fixed to one thread per pair of a tile. An i-cluster at the boundary of two GPU ranges is
+ * processed by both GPUs, each writing only its own particles.
+ */
+template<class evaluator, unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy>
+void gpu_pair_force_launch_cluster_kernel(const pair_args_t& pair_args,
+    std::pair<unsigned int, unsigned int> range,
+    const typename evaluator::param_type *d_params)
+    {
+    if (range.second <= range.first)
+        return;
+
+    const unsigned int first_cluster = range.first / gpu_nlist_cluster_size;
+    const unsigned int last_cluster = (range.second + gpu_nlist_cluster_size - 1) / gpu_nlist_cluster_size;
+
+    Index2D typpair_idx(pair_args.ntypes);
+    unsigned int shared_bytes = (2*sizeof(Scalar) + sizeof(typename evaluator::param_type))
+                                * typpair_idx.getNumElements();
+
+    if (pair_args.compute_capability < 35) gpu_pair_force_bind_textures(pair_args);
+
+    gpu_compute_pair_forces_cluster_kernel<evaluator, shift_mode, compute_virial, compute_energy>
+      <<<last_cluster - first_cluster, gpu_nlist_cluster_size*gpu_nlist_cluster_size, shared_bytes,
+         pair_args.stream>>>(
+      pair_args.d_force, pair_args.d_virial, pair_args.virial_pitch, range.first, range.second, pair_args.n_max,
+      pair_args.d_pos, pair_args.d_diameter, pair_args.d_charge, pair_args.box, *pair_args.cluster_args, d_params,
+      pair_args.d_rcutsq, pair_args.d_ronsq, pair_args.ntypes, pair_args.accumulate);
+
+    if (pair_args.compute_capability < 35) gpu_pair_force_unbind_textures(pair_args);
+    }
+
+//! Launches the neighbor list kernel for a given set of compile-time options
+/*! \tparam evaluator EvaluatorPair class to evaluate V(r) and -delta V(r)/r
+    \tparam use_gmem_nlist When non-zero, the neighbor list is read out of global memory
+
+    Systems with a single particle type launch a variant of the kernel that keeps the parameters in registers.
+*/
+template<class evaluator, unsigned int use_gmem_nlist>
+struct PairForceNListLauncher
+    {
+    typedef typename evaluator::param_type param_type;
+
+    template<unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy>
+    static void launch(const pair_args_t& pair_args,
+        std::pair<unsigned int, unsigned int> range,
+        const param_type *d_params)
+        {
+        if (pair_args.ntypes == 1)
+            PairForceComputeKernel<evaluator, shift_mode, compute_virial, compute_energy, use_gmem_nlist, 1,
+                gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
+        else
+            PairForceComputeKernel<evaluator, shift_mode, compute_virial, compute_energy, use_gmem_nlist, 0,
+                gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
+        }
+    };
+
+//! Launches the cell-pair kernel for a given set of compile-time options
+template<class evaluator>
+struct PairForceCellLauncher
+    {
+    typedef typename evaluator::param_type param_type;
+
+    template<unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy>
+    static void launch(const pair_args_t& pair_args,
+        std::pair<unsigned int, unsigned int> range,
+        const param_type *d_params)
+        {
+        PairForceComputeCellKernel<evaluator, shift_mode, compute_virial, compute_energy,
+            gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
+        }
+    };
+
+//! Launches the cluster-pair kernel for a given set of compile-time options
+template<class evaluator>
+struct PairForceClusterLauncher
+    {
+    typedef typename evaluator::param_type param_type;
+
+    template<unsigned int shift_mode, unsigned int compute_virial, unsigned int compute_energy>
+    static void launch(const pair_args_t& pair_args,
+        std::pair<unsigned int, unsigned int> range,
+        const param_type *d_params)
+        {
+        gpu_pair_force_launch_cluster_kernel<evaluator, shift_mode, compute_virial, compute_energy>(pair_args,
+            range, d_params);
+        }
+    };
+
+//! Select the energy template parameter of a kernel launch
+template<class launcher, unsigned int shift_mode, unsigned int compute_virial>
+void gpu_pair_force_dispatch_energy(const pair_args_t& pair_args,
+    std::pair<unsigned int, unsigned int> range,
+    const typename launcher::param_type *d_params)
+    {
+    if (pair_args.compute_energy)
+        launcher::template launch<shift_mode, compute_virial, 1>(pair_args, range, d_params);
+    else
+        launcher::template launch<shift_mode, compute_virial, 0>(pair_args, range, d_params);
+    }
+
+//! Select the virial template parameter of a kernel launch
+template<class launcher, unsigned int shift_mode>
+void gpu_pair_force_dispatch_virial(const pair_args_t& pair_args,
+    std::pair<unsigned int, unsigned int> range,
+    const typename launcher::param_type *d_params)
+    {
+    switch (pair_args.compute_virial)
+        {
+        case 1:
+            gpu_pair_force_dispatch_energy<launcher, shift_mode, 1>(pair_args, range, d_params);
+            break;
+        case 2:
+            gpu_pair_force_dispatch_energy<launcher, shift_mode, 2>(pair_args, range, d_params);
+            break;
+        default:
+            gpu_pair_force_dispatch_energy<launcher, shift_mode, 0>(pair_args, range, d_params);
+            break;
+        }
+    }
+
+//! Launch the kernel variant specialized on the shift mode, virial and energy options of \a pair_args
+/*! \param pair_args Other arguments to pass onto the kernel
+    \param range Range of particle indices this GPU operates on
+    \param d_params Parameters for the potential, stored per type pair
+
+    Every combination of the runtime options is instantiated, so the kernels contain no branches on them.
+
+    \tparam launcher One of PairForceNListLauncher, PairForceCellLauncher or PairForceClusterLauncher
+*/
+template<class launcher>
+void gpu_pair_force_dispatch(const pair_args_t& pair_args,
+    std::pair<unsigned int, unsigned int> range,
+    const typename launcher::param_type *d_params)
+    {
+    switch (pair_args.shift_mode)
+        {
+        case 0:
+            gpu_pair_force_dispatch_virial<launcher, 0>(pair_args, range, d_params);
+            break;
+        case 1:
+            gpu_pair_force_dispatch_virial<launcher, 1>(pair_args, range, d_params);
+            break;
+        case 2:
+            gpu_pair_force_dispatch_virial<launcher, 2>(pair_args, range, d_params);
+            break;
+        default:
+            break;
+        }
+    }
+
 //! Kernel driver that computes lj forces on the GPU for LJForceComputeGPU
 /*! \param pair_args Other arguments to pass onto the kernel
     \param d_params Parameters for the potential, stored per type pair
 
-    This is just a driver function for gpu_compute_pair_forces_shared_kernel(), see it for details.
+    This is just a driver function for gpu_compute_pair_forces_shared_kernel(), see it for details. When
+    \a pair_args carries cell list data, gpu_compute_pair_forces_cell_kernel() is launched instead, and when it carries
+    a cluster-pair list, gpu_compute_pair_forces_cluster_kernel().
 */
 template< class evaluator >
 cudaError_t gpu_compute_pair_forces(const pair_args_t& pair_args,
@@ -553,104 +1343,24 @@ cudaError_t gpu_compute_pair_forces(const pair_args_t& pair_args,
         {
         auto range = pair_args.gpu_partition.getRangeAndSetGPU(idev);
 
-        // Launch kernel
-        if (pair_args.compute_capability < 35 && pair_args.size_neigh_list > pair_args.max_tex1d_width)
-            { // fall back to slow global loads when the neighbor list is too big for texture memory
-            if (pair_args.compute_virial)
-                {
-                switch (pair_args.shift_mode)
-                    {
-                    case 0:
-                        {
-                        PairForceComputeKernel<evaluator, 0, 1, 1, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    case 1:
-                        {
-                        PairForceComputeKernel<evaluator, 1, 1, 1, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    case 2:
-                        {
-                        PairForceComputeKernel<evaluator, 2, 1, 1, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    default:
-                        break;
-                    }
-                }
-            else
-                {
-                switch (pair_args.shift_mode)
-                    {
-                    case 0:
-                        {
-                        PairForceComputeKernel<evaluator, 0, 0, 1, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    case 1:
-                        {
-                        PairForceComputeKernel<evaluator, 1, 0, 1, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    case 2:
-                        {
-                        PairForceComputeKernel<evaluator, 2, 0, 1, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    default:
-                        break;
-                    }
-                }
+        if (pair_args.cell_args)
+            {
+            // cell-pair mode, the neighbor list is not used
+            gpu_pair_force_dispatch< PairForceCellLauncher<evaluator> >(pair_args, range, d_params);
+            }
+        else if (pair_args.cluster_args)
+            {
+            // cluster-pair mode, the per particle neighbor list is not used
+            gpu_pair_force_dispatch< PairForceClusterLauncher<evaluator> >(pair_args, range, d_params);
+            }
+        else if (pair_args.compute_capability < 35 && pair_args.size_neigh_list > pair_args.max_tex1d_width)
+            {
+            // fall back to slow global loads when the neighbor list is too big for texture memory
+            gpu_pair_force_dispatch< PairForceNListLauncher<evaluator, 1> >(pair_args, range, d_params);
             }
         else
             {
-            if (pair_args.compute_virial)
-                {
-                switch (pair_args.shift_mode)
-                    {
-                    case 0:
-                        {
-                        PairForceComputeKernel<evaluator, 0, 1, 0, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    case 1:
-                        {
-                        PairForceComputeKernel<evaluator, 1, 1, 0, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    case 2:
-                        {
-                        PairForceComputeKernel<evaluator, 2, 1, 0, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    default:
-                        break;
-                    }
-                }
-            else
-                {
-                switch (pair_args.shift_mode)
-                    {
-                    case 0:
-                        {
-                        PairForceComputeKernel<evaluator, 0, 0, 0, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    case 1:
-                        {
-                        PairForceComputeKernel<evaluator, 1, 0, 0, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    case 2:
-                        {
-                        PairForceComputeKernel<evaluator, 2, 0, 0, gpu_pair_force_max_tpp>::launch(pair_args, range, d_params);
-                        break;
-                        }
-                    default:
-                        break;
-                    }
-                }
+            gpu_pair_force_dispatch< PairForceNListLauncher<evaluator, 0> >(pair_args, range, d_params);
             }
         }
 
@@ -13,6 +13,7 @@
 
 #include "PotentialPair.h"
 #include "PotentialPairGPU.cuh"
+#include "NeighborListGPU.h"
 
 #include "hoomd/Autotuner.h"
 
@@ -102,18 +103,15 @@ PotentialPairGPU< evaluator, gpu_cgpf >::PotentialPairGPU(std::shared_ptr<System
         }
 
     // initialize autotuner
-    // the full block size and threads_per_particle matrix is searched,
+    // the block size and threads_per_particle are searched by coordinate descent,
     // encoded as block_size*10000 + threads_per_particle
-    std::vector<unsigned int> valid_params;
+    std::vector< std::vector<unsigned int> > dim_values(2);
     for (unsigned int block_size = 32; block_size <= 1024; block_size += 32)
-        {
-        for (auto s : Autotuner::getTppListPow2(this->m_exec_conf->dev_prop.warpSize))
-            {
-            valid_params.push_back(block_size*10000 + s);
-            }
-        }
+        dim_values[0].push_back(block_size);
+    dim_values[1] = Autotuner::getTppListPow2(this->m_exec_conf->dev_prop.warpSize);
+    std::vector<unsigned int> dim_weights = {10000, 1};
 
-    m_tuner.reset(new Autotuner(valid_params, 5, 100000, "pair_" + evaluator::getName(), this->m_exec_conf));
+    m_tuner.reset(new Autotuner(dim_values, dim_weights, 5, 100000, "pair_" + evaluator::getName(), this->m_exec_conf));
     #ifdef ENABLE_MPI
     // synchronize autotuner results across ranks
     m_tuner->setSync(bool(this->m_pdata->getDomainDecomposition()));
@@ -124,13 +122,25 @@ template< class evaluator, cudaError_t gpu_cgpf(const pair_args_t& pair_args,
                                                 const typename evaluator::param_type *d_params)>
 void PotentialPairGPU< evaluator, gpu_cgpf >::computeForces(unsigned int timestep)
     {
-    this->m_nlist->compute(timestep);
+    if (this->m_cl)
+        this->computeCellList(timestep);
+    else
+        this->m_nlist->compute(timestep);
+
+    // the special pairs are scaled in the per particle neighbor list kernel
+    bool special_pairs = this->m_special_pairs && !this->m_cl && this->m_nlist->getSpecialPairsSet();
+
+    // evaluate the cluster-pair list if the neighbor list provides one
+    std::shared_ptr<NeighborListGPU> nlist_gpu = std::dynamic_pointer_cast<NeighborListGPU>(this->m_nlist);
+    bool cluster_pairs = !this->m_cl && !special_pairs && nlist_gpu && nlist_gpu->getClusterPairs();
+    if (cluster_pairs)
+        nlist_gpu->updateClusterPairs();
 
     // start the profile
     if (this->m_prof) this->m_prof->push(this->m_exec_conf, this->m_prof_name);
 
     // The GPU implementation CANNOT handle a half neighborlist, error out now
-    bool third_law = this->m_nlist->getStorageMode() == NeighborList::half;
+    bool third_law = !this->m_cl && this->m_nlist->getStorageMode() == NeighborList::half;
     if (third_law)
         {
         this->m_exec_conf->msg->error() << "PotentialPairGPU cannot handle a half neighborlist"
@@ -155,12 +165,53 @@ void PotentialPairGPU< evaluator, gpu_cgpf >::computeForces(unsigned int timeste
     ArrayHandle<Scalar> d_rcutsq(this->m_rcutsq, access_location::device, access_mode::read);
     ArrayHandle<typename evaluator::param_type> d_params(this->m_params, access_location::device, access_mode::read);
 
-    ArrayHandle<Scalar4> d_force(this->m_force, access_location::device, access_mode::readwrite);
-    ArrayHandle<Scalar> d_virial(this->m_virial, access_location::device, access_mode::readwrite);
+    // the forces are written to the per-compute arrays, or added to the net force
+    const GlobalArray<Scalar4>& force_target = this->getForceTarget();
+    const GlobalArray<Scalar>& virial_target = this->getVirialTarget();
+    ArrayHandle<Scalar4> d_force(force_target, access_location::device, access_mode::readwrite);
+    ArrayHandle<Scalar> d_virial(virial_target, access_location::device, access_mode::readwrite);
+
+    // access the cell list in the cell-pair mode
+    std::unique_ptr<CellPairCandidatesGPU> cell_data;
+    if (this->m_cl)
+        cell_data.reset(new CellPairCandidatesGPU(*this->m_cl, *this->m_nlist, *this->m_pdata));
+
+    // access the cluster-pair list in the cluster-pair mode
+    std::unique_ptr< ArrayHandle<unsigned int> > d_cluster_n;
+    std::unique_ptr< ArrayHandle<unsigned int> > d_cluster_list;
+    std::unique_ptr< ArrayHandle<uint2> > d_cluster_mask;
+    cluster_pair_args_t cluster_args;
+    if (cluster_pairs)
+        {
+        d_cluster_n.reset(new ArrayHandle<unsigned int>(nlist_gpu->getClusterNArray(), access_location::device, access_mode::read));
+        d_cluster_list.reset(new ArrayHandle<unsigned int>(nlist_gpu->getClusterListArray(), access_location::device, access_mode::read));
+        d_cluster_mask.reset(new ArrayHandle<uint2>(nlist_gpu->getClusterMaskArray(), access_location::device, access_mode::read));
+        cluster_args.d_cluster_n = d_cluster_n->data;
+        cluster_args.d_cluster_list = d_cluster_list->data;
+        cluster_args.d_cluster_mask = d_cluster_mask->data;
+        cluster_args.cluster_indexer = nlist_gpu->getClusterIndexer();
+        }
+
+    // access the special pair masks
+    std::unique_ptr< ArrayHandle<unsigned int> > d_tag;
+    std::unique_ptr< ArrayHandle<unsigned int> > d_special_mask;
+    special_pair_args_t special_args;
+    if (special_pairs)
+        {
+        d_tag.reset(new ArrayHandle<unsigned int>(this->m_pdata->getTags(), access_location::device, access_mode::read));
+        d_special_mask.reset(new ArrayHandle<unsigned int>(this->m_nlist->getSpecialPairMaskArray(), access_location::device, access_mode::read));
+        special_args.d_tag = d_tag->data;
+        special_args.d_special_mask = d_special_mask->data;
+        special_args.scale = this->m_special_scale;
+        }
 
-    // access flags
+    // access flags, the kernels compute only the trace of the virial when the pressure tensor is not needed
     PDataFlags flags = this->m_pdata->getFlags();
 
+    // the energies are skipped when nothing reads them on this step, validateEnergies() recomputes them on demand
+    bool compute_energy = this->needsEnergies();
+    this->m_energies_valid = compute_energy;
+
     this->m_exec_conf->beginMultiGPU();
 
     if (! m_param) this->m_tuner->begin();
@@ -170,7 +221,7 @@ void PotentialPairGPU< evaluator, gpu_cgpf >::computeForces(unsigned int timeste
 
     gpu_cgpf(pair_args_t(d_force.data,
                          d_virial.data,
-                         this->m_virial.getPitch(),
+                         virial_target.getPitch(),
                          this->m_pdata->getN(),
                          this->m_pdata->getMaxN(),
                          d_pos.data,
@@ -186,11 +237,17 @@ void PotentialPairGPU< evaluator, gpu_cgpf >::computeForces(unsigned int timeste
                          this->m_pdata->getNTypes(),
                          block_size,
                          this->m_shift_mode,
-                         flags[pdata_flag::pressure_tensor] || flags[pdata_flag::isotropic_virial],
+                         flags[pdata_flag::pressure_tensor] ? 1 : (flags[pdata_flag::isotropic_virial] ? 2 : 0),
                          threads_per_particle,
                          this->m_exec_conf->getComputeCapability()/10,
                          this->m_exec_conf->dev_prop.maxTexture1DLinear,
-                         this->m_pdata->getGPUPartition()),
+                         this->m_pdata->getGPUPartition(),
+                         cell_data ? &cell_data->getArgs() : NULL,
+                         cluster_pairs ? &cluster_args : NULL,
+                         this->m_accumulate_net_force,
+                         compute_energy,
+                         this->getStream(),
+                         special_pairs ? &special_args : NULL),
              d_params.data);
 
     if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
@@ -3,7 +3,7 @@
 
 #include <memory>
 #include "hoomd/ForceCompute.h"
-#include "hoomd/GPUArray.h"
+#include "hoomd/GlobalArray.h"
 
 #include <vector>
 
@@ -56,7 +56,7 @@ class PotentialSpecialPair : public ForceCompute
         #endif
 
     protected:
-        GPUArray<param_type> m_params;              //!< SpecialPair parameters per type
+        GlobalArray<param_type> m_params;           //!< SpecialPair parameters per type
         std::shared_ptr<PairData> m_pair_data;    //!< Data to use in computing particle pairs
         std::string m_log_name;                     //!< Cached log name
         std::string m_prof_name;                    //!< Cached profiler name
@@ -82,7 +82,7 @@ PotentialSpecialPair< evaluator >::PotentialSpecialPair(std::shared_ptr<SystemDe
     m_prof_name = std::string("Special pair ") + evaluator::getName();
 
     // allocate the parameters
-    GPUArray<param_type> params(m_pair_data->getNTypes(), m_exec_conf);
+    GlobalArray<param_type> params(m_pair_data->getNTypes(), m_exec_conf);
     m_params.swap(params);
     }
 
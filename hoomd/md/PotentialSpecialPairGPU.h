@@ -56,7 +56,7 @@ class PotentialSpecialPairGPU : public PotentialSpecialPair<evaluator>
 
     protected:
         std::unique_ptr<Autotuner> m_tuner; //!< Autotuner for block size
-        GPUArray<unsigned int> m_flags;       //!< Flags set during the kernel execution
+        GlobalArray<unsigned int> m_flags;    //!< Flags set during the kernel execution
 
         //! Actually compute the forces
         virtual void computeForces(unsigned int timestep);
@@ -77,11 +77,24 @@ PotentialSpecialPairGPU< evaluator, gpu_cgbf >::PotentialSpecialPairGPU(std::sha
         }
 
      // allocate and zero device memory
-    GPUArray<typename evaluator::param_type> params(this->m_pair_data->getNTypes(), this->m_exec_conf);
+    GlobalArray<typename evaluator::param_type> params(this->m_pair_data->getNTypes(), this->m_exec_conf);
     this->m_params.swap(params);
 
+    if (this->m_exec_conf->allConcurrentManagedAccess())
+        {
+        // the parameters are read by every GPU
+        auto& gpu_map = this->m_exec_conf->getGPUIds();
+
+        cudaMemAdvise(this->m_params.get(), this->m_params.getNumElements()*sizeof(typename evaluator::param_type),
+            cudaMemAdviseSetReadMostly, 0);
+        for (unsigned int idev = 0; idev < this->m_exec_conf->getNumActiveGPUs(); ++idev)
+            cudaMemPrefetchAsync(this->m_params.get(),
+                this->m_params.getNumElements()*sizeof(typename evaluator::param_type), gpu_map[idev]);
+        CHECK_CUDA_ERROR();
+        }
+
      // allocate flags storage on the GPU
-    GPUArray<unsigned int> flags(1, this->m_exec_conf);
+    GlobalArray<unsigned int> flags(1, this->m_exec_conf);
     m_flags.swap(flags);
 
     // reset flags
@@ -116,7 +129,7 @@ void PotentialSpecialPairGPU< evaluator, gpu_cgbf >::computeForces(unsigned int
     ArrayHandle<Scalar> d_virial(this->m_virial, access_location::device, access_mode::readwrite);
 
         {
-        const GPUArray<typename PairData::members_t>& gpu_bond_list = this->m_pair_data->getGPUTable();
+        const GlobalVector<typename PairData::members_t>& gpu_bond_list = this->m_pair_data->getGPUTable();
         const Index2D& gpu_table_indexer = this->m_pair_data->getGPUTableIndexer();
 
         ArrayHandle<typename PairData::members_t> d_gpu_bondlist(gpu_bond_list, access_location::device, access_mode::read);
@@ -126,6 +139,7 @@ void PotentialSpecialPairGPU< evaluator, gpu_cgbf >::computeForces(unsigned int
         // access the flags array for overwriting
         ArrayHandle<unsigned int> d_flags(m_flags, access_location::device, access_mode::readwrite);
 
+        this->m_exec_conf->beginMultiGPU();
         this->m_tuner->begin();
         gpu_cgbf(bond_args_t(d_force.data,
                              d_virial.data,
@@ -141,15 +155,19 @@ void PotentialSpecialPairGPU< evaluator, gpu_cgbf >::computeForces(unsigned int
                              d_gpu_n_bonds.data,
                              this->m_pair_data->getNTypes(),
                              this->m_tuner->getParam(),
-                             this->m_exec_conf->getComputeCapability()),
+                             this->m_exec_conf->getComputeCapability(),
+                             this->m_pdata->getGPUPartition()),
                  d_params.data,
                  d_flags.data);
+
+        if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        this->m_tuner->end();
+        this->m_exec_conf->endMultiGPU();
         }
 
     if (this->m_exec_conf->isCUDAErrorCheckingEnabled())
         {
-        CHECK_CUDA_ERROR();
-
         // check the flags for any errors
         ArrayHandle<unsigned int> h_flags(m_flags, access_location::host, access_mode::read);
 
@@ -159,7 +177,6 @@ void PotentialSpecialPairGPU< evaluator, gpu_cgbf >::computeForces(unsigned int
             throw std::runtime_error("Error in special_pair calculation");
             }
         }
-    this->m_tuner->end();
 
     if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
     }
@@ -42,6 +42,7 @@ struct tersoff_args_t
                    const unsigned int _ntypes,
                    const unsigned int _block_size,
                    const unsigned int _tpp,
+                   const unsigned int _tile,
                    const unsigned int _compute_capability,
                    const cudaDeviceProp& _devprop)
                    : d_force(_d_force),
@@ -61,6 +62,7 @@ struct tersoff_args_t
                      ntypes(_ntypes),
                      block_size(_block_size),
                      tpp(_tpp),
+                     tile(_tile),
                      compute_capability(_compute_capability),
                      devprop(_devprop)
         {
@@ -83,6 +85,7 @@ struct tersoff_args_t
     const unsigned int ntypes;      //!< Number of particle types in the simulation
     const unsigned int block_size;  //!< Block size to execute
     const unsigned int tpp;         //!< Threads per particle
+    const unsigned int tile;        //!< Maximum number of neighbors cached in shared memory per particle (0 disables)
     const unsigned int compute_capability; //!< GPU compute capability (20, 30, 35, ...)
     const cudaDeviceProp& devprop;   //!< CUDA device properties
     };
@@ -131,6 +134,65 @@ __device__ float myAtomicAdd(float* address, float val)
     return atomicAdd(address, val);
     }
 
+//! Read a neighbor of the particle handled by a Tersoff kernel thread
+/*! \param neigh Index of the neighbor in the neighbor list of the particle
+    \param cached True if the neighbor shell of the particle is cached in shared memory
+    \param s_shell_dx Cached separation vectors and squared distances of the shell
+    \param s_shell_idx Cached indices and types of the shell
+    \param head_idx Head index of the particle in the neighbor list
+    \param posi Position of the particle
+    \param d_pos Particle positions
+    \param d_nlist Neighbor list
+    \param box Simulation box
+    \param dx Minimum image separation posi - posj (output)
+    \param rsq Squared distance (output)
+    \param j Index of the neighbor (output)
+    \param typej Type of the neighbor (output)
+*/
+template<unsigned char use_gmem_nlist>
+__device__ inline void tersoff_read_neighbor(const unsigned int neigh,
+                                             const bool cached,
+                                             const Scalar4 *s_shell_dx,
+                                             const uint2 *s_shell_idx,
+                                             const unsigned int head_idx,
+                                             const Scalar3& posi,
+                                             const Scalar4 *d_pos,
+                                             const unsigned int *d_nlist,
+                                             const BoxDim& box,
+                                             Scalar3& dx,
+                                             Scalar& rsq,
+                                             unsigned int& j,
+                                             unsigned int& typej)
+    {
+    if (cached)
+        {
+        Scalar4 dx_rsq = s_shell_dx[neigh];
+        uint2 idx_type = s_shell_idx[neigh];
+        dx = make_scalar3(dx_rsq.x, dx_rsq.y, dx_rsq.z);
+        rsq = dx_rsq.w;
+        j = idx_type.x;
+        typej = idx_type.y;
+        }
+    else
+        {
+        if (use_gmem_nlist)
+            j = d_nlist[head_idx + neigh];
+        else
+            j = texFetchUint(d_nlist, nlist_tex, head_idx + neigh);
+
+        // read the position of j (MEM TRANSFER: 16 bytes)
+        Scalar4 postypej = texFetchScalar4(d_pos, pdata_pos_tex, j);
+        Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
+
+        // compute r_ij and apply periodic boundary conditions (FLOPS: 15)
+        dx = box.minImage(posi - posj);
+
+        // compute rij_sq (FLOPS: 5)
+        rsq = dot(dx, dx);
+        typej = __scalar_as_int(postypej.w);
+        }
+    }
+
 //! Kernel for calculating the Tersoff forces
 /*! This kernel is called to calculate the forces on all N particles. Actual evaluation of the potentials and
     forces for each pair is handled via the template class \a evaluator.
@@ -146,11 +208,14 @@ __device__ float myAtomicAdd(float* address, float val)
     \param d_rcutsq rcut squared, stored per type pair
     \param d_ronsq ron squared, stored per type pair
     \param ntypes Number of types in the simulation
+    \param tile Maximum number of neighbors of a particle cached in shared memory, 0 disables the cache. Must be a
+                multiple of 16 to keep the shared memory arrays aligned.
 
     \a d_params, \a d_rcutsq, and \a d_ronsq must be indexed with an Index2DUpperTriangular(typei, typej) to access the
     unique value for that type pair. These values are all cached into shared memory for quick access, so a dynamic
     amount of shared memory must be allocated for this kernel launch. The amount is
-    (2*sizeof(Scalar) + sizeof(typename evaluator::param_type)) * typpair_idx.getNumElements()
+    (2*sizeof(Scalar) + sizeof(typename evaluator::param_type)) * typpair_idx.getNumElements(), plus the
+    per-thread phi terms and the neighbor shell cache (see gpu_tersoff_shared_bytes()).
 
     Certain options are controlled via template parameters to avoid the performance hit when they are not enabled.
     \tparam evaluator EvaluatorPair class to evaluate V(r) and -delta V(r)/r
@@ -159,8 +224,11 @@ __device__ float myAtomicAdd(float* address, float val)
 
     <b>Implementation details</b>
     Each block will calculate the forces on a block of particles.
-    Each thread will calculate the total force on one particle.
-    The neighborlist is arranged in columns so that reads are fully coalesced when doing this.
+    A group of tpp threads calculates the total force on one particle, each thread handles a strided subset of the
+    j neighbors and loops over all k neighbors for the three-body terms.
+    When the particle has at most \a tile neighbors, the threads of the group first load the neighbor shell into
+    shared memory once, with the minimum image separations and types. The j-k loops then read the shell from shared
+    memory instead of reading every neighbor position n_neigh times from global memory.
 */
 template< class evaluator , unsigned char use_gmem_nlist, unsigned char compute_virial, int tpp>
 __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
@@ -175,16 +243,20 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
                                                   const typename evaluator::param_type *d_params,
                                                   const Scalar *d_rcutsq,
                                                   const Scalar *d_ronsq,
-                                                  const unsigned int ntypes)
+                                                  const unsigned int ntypes,
+                                                  const unsigned int tile)
     {
     Index2D typpair_idx(ntypes);
     const unsigned int num_typ_parameters = typpair_idx.getNumElements();
+    const unsigned int groups_per_block = blockDim.x/tpp;
 
-    // shared arrays for per type pair parameters
+    // shared arrays for the neighbor shell cache and the per type pair parameters
     extern __shared__ char s_data[];
+    Scalar4 *s_shell_dx = (Scalar4 *)(&s_data[0]);
+    uint2 *s_shell_idx = (uint2 *)(s_shell_dx + groups_per_block*tile);
     typename evaluator::param_type *s_params =
-        (typename evaluator::param_type *)(&s_data[0]);
-    Scalar *s_rcutsq = (Scalar *)(&s_data[num_typ_parameters*sizeof(evaluator::param_type)]);
+        (typename evaluator::param_type *)(s_shell_idx + groups_per_block*tile);
+    Scalar *s_rcutsq = (Scalar *)(s_params + num_typ_parameters);
 
     Scalar *s_phi_ab = s_rcutsq + num_typ_parameters;
 
@@ -198,6 +270,42 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
             }
         }
 
+    // start by identifying which particle we are to handle
+    unsigned int idx = blockIdx.x * groups_per_block + threadIdx.x/tpp;
+    const unsigned int lane = threadIdx.x%tpp;
+
+    // load in the length of the neighbor list (MEM_TRANSFER: 4 bytes)
+    unsigned int n_neigh = 0;
+    unsigned int head_idx = 0;
+    Scalar4 postypei = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
+    if (idx < N)
+        {
+        n_neigh = d_n_neigh[idx];
+        head_idx = d_head_list[idx];
+
+        // read in the position of the particle
+        postypei = texFetchScalar4(d_pos, pdata_pos_tex, idx);
+        }
+    Scalar3 posi = make_scalar3(postypei.x, postypei.y, postypei.z);
+
+    // the threads of the group cooperatively cache the neighbor shell of the particle
+    const bool cached = idx < N && n_neigh <= tile;
+    s_shell_dx += (threadIdx.x/tpp)*tile;
+    s_shell_idx += (threadIdx.x/tpp)*tile;
+    if (cached)
+        {
+        for (unsigned int neigh_idx = lane; neigh_idx < n_neigh; neigh_idx += tpp)
+            {
+            Scalar3 dx;
+            Scalar rsq;
+            unsigned int j, typej;
+            tersoff_read_neighbor<use_gmem_nlist>(neigh_idx, false, s_shell_dx, s_shell_idx, head_idx, posi, d_pos,
+                d_nlist, box, dx, rsq, j, typej);
+            s_shell_dx[neigh_idx] = make_scalar4(dx.x, dx.y, dx.z, rsq);
+            s_shell_idx[neigh_idx] = make_uint2(j, typej);
+            }
+        }
+
     __syncthreads();
 
     for (unsigned int i = 0; i < ntypes; ++i)
@@ -206,18 +314,10 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
         s_phi_ab[threadIdx.x*ntypes+i] = Scalar(0.0);
         }
 
-    // start by identifying which particle we are to handle
-    unsigned int idx = blockIdx.x * (blockDim.x/tpp) + threadIdx.x/tpp;
-
     if (idx >= N)
         return;
 
-    // load in the length of the neighbor list (MEM_TRANSFER: 4 bytes)
-    unsigned int n_neigh = d_n_neigh[idx];
-
-    // read in the position of the particle
-    Scalar4 postypei = texFetchScalar4(d_pos, pdata_pos_tex, idx);
-    Scalar3 posi = make_scalar3(postypei.x, postypei.y, postypei.z);
+    const unsigned int typei = __scalar_as_int(postypei.w);
 
     // initialize the force to 0
     Scalar4 forcei = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
@@ -232,62 +332,22 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
     // loop over neighbors to calculate per-particle energy
     if (evaluator::hasPerParticleEnergy())
         {
-        // prefetch neighbor index
-        const unsigned int head_idx = d_head_list[idx];
-        unsigned int cur_j = 0;
-        unsigned int next_j(0);
-        unsigned int my_head = d_head_list[idx];
-
-        if (use_gmem_nlist)
-            {
-            next_j = (threadIdx.x%tpp < n_neigh) ? d_nlist[my_head + threadIdx.x%tpp] : 0;
-            }
-        else
-            {
-            next_j = threadIdx.x%tpp < n_neigh ? texFetchUint(d_nlist, nlist_tex, my_head + threadIdx.x%tpp) : 0;
-            }
-
         // loop over neighbors in strided way
-        for (int neigh_idx = threadIdx.x%tpp; neigh_idx < n_neigh; neigh_idx+=tpp)
+        for (int neigh_idx = lane; neigh_idx < n_neigh; neigh_idx+=tpp)
             {
-            // read the current neighbor index (MEM TRANSFER: 4 bytes)
-            // prefetch the next value and set the current one
-            cur_j = next_j;
-            if (neigh_idx+tpp < n_neigh)
-                {
-                if (use_gmem_nlist)
-                    {
-                    next_j = d_nlist[head_idx + neigh_idx + tpp];
-                    }
-                else
-                    {
-                    next_j = texFetchUint(d_nlist, nlist_tex, head_idx + neigh_idx + tpp);
-                    }
-                }
-
-            // read the position of j (MEM TRANSFER: 16 bytes)
-            Scalar4 postypej = texFetchScalar4(d_pos, pdata_pos_tex, cur_j);
-            Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
-
-            // initialize the force on j
-            Scalar4 forcej = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
-
-            // compute r_ij (FLOPS: 3)
-            Scalar3 dxij = posi - posj;
-
-            // apply periodic boundary conditions (FLOPS: 12)
-            dxij = box.minImage(dxij);
-
-            // compute rij_sq (FLOPS: 5)
-            Scalar rij_sq = dot(dxij, dxij);
+            Scalar3 dxij;
+            Scalar rij_sq;
+            unsigned int cur_j, typej;
+            tersoff_read_neighbor<use_gmem_nlist>(neigh_idx, cached, s_shell_dx, s_shell_idx, head_idx, posi, d_pos,
+                d_nlist, box, dxij, rij_sq, cur_j, typej);
 
             // access the per type-pair parameters
-            unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypej.w));
+            unsigned int typpair = typpair_idx(typei, typej);
             Scalar rcutsq = s_rcutsq[typpair];
             typename evaluator::param_type param = s_params[typpair];
 
             evaluator eval(rij_sq, rcutsq, param);
-            eval.evalPhi(s_phi_ab[threadIdx.x*ntypes+__scalar_as_int(postypej.w)]);
+            eval.evalPhi(s_phi_ab[threadIdx.x*ntypes+typej]);
             }
 
         // self-energy
@@ -303,9 +363,9 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
             s_phi_ab[threadIdx.x*ntypes+typ_b] = hoomd::detail::WarpScan<Scalar, tpp>().Broadcast(phi, 0);
             #endif
 
-            if (threadIdx.x % tpp == 0)
+            if (lane == 0)
                 {
-                unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), typ_b);
+                unsigned int typpair = typpair_idx(typei, typ_b);
                 Scalar rcutsq = s_rcutsq[typpair];
                 typename evaluator::param_type param = s_params[typpair];
 
@@ -318,42 +378,14 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
             }
         }
 
-    // prefetch neighbor index
-    const unsigned int head_idx = d_head_list[idx];
-    unsigned int cur_j = 0;
-    unsigned int next_j(0);
-    unsigned int my_head = d_head_list[idx];
-
-    if (use_gmem_nlist)
-        {
-        next_j = (threadIdx.x%tpp < n_neigh) ? d_nlist[my_head + threadIdx.x%tpp] : 0;
-        }
-    else
-        {
-        next_j = threadIdx.x%tpp < n_neigh ? texFetchUint(d_nlist, nlist_tex, my_head + threadIdx.x%tpp) : 0;
-        }
-
     // loop over neighbors in strided way
-    for (int neigh_idx = threadIdx.x%tpp; neigh_idx < n_neigh; neigh_idx+=tpp)
+    for (int neigh_idx = lane; neigh_idx < n_neigh; neigh_idx+=tpp)
         {
-        // read the current neighbor index (MEM TRANSFER: 4 bytes)
-        // prefetch the next value and set the current one
-        cur_j = next_j;
-        if (neigh_idx+tpp < n_neigh)
-            {
-            if (use_gmem_nlist)
-                {
-                next_j = d_nlist[head_idx + neigh_idx + tpp];
-                }
-            else
-                {
-                next_j = texFetchUint(d_nlist, nlist_tex, head_idx + neigh_idx + tpp);
-                }
-            }
-
-        // read the position of j (MEM TRANSFER: 16 bytes)
-        Scalar4 postypej = texFetchScalar4(d_pos, pdata_pos_tex, cur_j);
-        Scalar3 posj = make_scalar3(postypej.x, postypej.y, postypej.z);
+        Scalar3 dxij;
+        Scalar rij_sq;
+        unsigned int cur_j, typej;
+        tersoff_read_neighbor<use_gmem_nlist>(neigh_idx, cached, s_shell_dx, s_shell_idx, head_idx, posi, d_pos,
+            d_nlist, box, dxij, rij_sq, cur_j, typej);
 
         // initialize the force on j
         Scalar4 forcej = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
@@ -365,17 +397,8 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
         Scalar virialj_yz(0.0);
         Scalar virialj_zz(0.0);
 
-        // compute r_ij (FLOPS: 3)
-        Scalar3 dxij = posi - posj;
-
-        // apply periodic boundary conditions (FLOPS: 12)
-        dxij = box.minImage(dxij);
-
-        // compute rij_sq (FLOPS: 5)
-        Scalar rij_sq = dot(dxij, dxij);
-
         // access the per type-pair parameters
-        unsigned int typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypej.w));
+        unsigned int typpair = typpair_idx(typei, typej);
         Scalar rcutsq = s_rcutsq[typpair];
         typename evaluator::param_type param = s_params[typpair];
 
@@ -391,38 +414,17 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
 
             if (evaluator::needsChi())
                 {
-                // compute chi
-                unsigned int cur_k = 0;
-                unsigned int next_k(0);
-                if (use_gmem_nlist)
-                    {
-                    next_k = d_nlist[head_idx];
-                    }
-                else
-                    {
-                    next_k = texFetchUint(d_nlist, nlist_tex, head_idx);
-                    }
-
-                // loop over neighbors one by one
+                // compute chi, loop over neighbors one by one
                 for (int neigh_idy = 0; neigh_idy < n_neigh; neigh_idy++)
                     {
-                    // read the current index of k and prefetch the next one
-                    cur_k = next_k;
-                    if (use_gmem_nlist)
-                        {
-                        next_k = d_nlist[head_idx + neigh_idy + 1];
-                        }
-                    else
-                        {
-                        next_k = texFetchUint(d_nlist, nlist_tex, head_idx + neigh_idy+1);
-                        }
-
-                    // get the position of neighbor k
-                    Scalar4 postypek = texFetchScalar4(d_pos, pdata_pos_tex, cur_k);
-                    Scalar3 posk = make_scalar3(postypek.x, postypek.y, postypek.z);
+                    Scalar3 dxik;
+                    Scalar rik_sq;
+                    unsigned int cur_k, typek;
+                    tersoff_read_neighbor<use_gmem_nlist>(neigh_idy, cached, s_shell_dx, s_shell_idx, head_idx, posi,
+                        d_pos, d_nlist, box, dxik, rik_sq, cur_k, typek);
 
                     // get the type pair parameters for i and k
-                    typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypek.w));
+                    typpair = typpair_idx(typei, typek);
                     Scalar temp_rcutsq = s_rcutsq[typpair];
                     typename evaluator::param_type temp_param = s_params[typpair];
 
@@ -431,15 +433,6 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
 
                     if (cur_k != cur_j && temp_evaluated)
                         {
-                        // compute rik
-                        Scalar3 dxik = posi - posk;
-
-                        // apply the periodic boundary conditions
-                        dxik = box.minImage(dxik);
-
-                        // compute rik_sq
-                        Scalar rik_sq = dot(dxik, dxik);
-
                         // compute the bond angle (if needed)
                         Scalar cos_th = Scalar(0.0);
                         if (evaluator::needsAngle())
@@ -460,7 +453,7 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
             Scalar force_divr = Scalar(0.0);
             Scalar potential_eng = Scalar(0.0);
             Scalar bij = Scalar(0.0);
-            const Scalar& phi = s_phi_ab[threadIdx.x*ntypes+__scalar_as_int(postypej.w)];
+            const Scalar& phi = s_phi_ab[threadIdx.x*ntypes+typej];
             eval.evalForceij(fR, fA, chi, phi, bij, force_divr, potential_eng);
 
             // add the forces and energies to their respective particles
@@ -503,38 +496,17 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
 
             if (evaluator::hasIkForce())
                 {
-                // now evaluate the force from the ik interactions
-                unsigned int cur_k = 0;
-                unsigned int next_k(0);
-                if (use_gmem_nlist)
-                    {
-                    next_k = d_nlist[head_idx];
-                    }
-                else
-                    {
-                    next_k = texFetchUint(d_nlist, nlist_tex, head_idx);
-                    }
-
-                // loop over neighbors one by one
+                // now evaluate the force from the ik interactions, loop over neighbors one by one
                 for (int neigh_idy = 0; neigh_idy < n_neigh; neigh_idy++)
                     {
-                    // read the current neighbor index and prefetch the next one
-                    cur_k = next_k;
-                    if (use_gmem_nlist)
-                        {
-                        next_k = d_nlist[head_idx + neigh_idy + 1];
-                        }
-                    else
-                        {
-                        next_k = texFetchUint(d_nlist, nlist_tex, head_idx + neigh_idy+1);
-                        }
-
-                    // get the position of neighbor k
-                    Scalar4 postypek = texFetchScalar4(d_pos, pdata_pos_tex, cur_k);
-                    Scalar3 posk = make_scalar3(postypek.x, postypek.y, postypek.z);
+                    Scalar3 dxik;
+                    Scalar rik_sq;
+                    unsigned int cur_k, typek;
+                    tersoff_read_neighbor<use_gmem_nlist>(neigh_idy, cached, s_shell_dx, s_shell_idx, head_idx, posi,
+                        d_pos, d_nlist, box, dxik, rik_sq, cur_k, typek);
 
                     // get the type pair parameters for i and k
-                    typpair = typpair_idx(__scalar_as_int(postypei.w), __scalar_as_int(postypek.w));
+                    typpair = typpair_idx(typei, typek);
                     Scalar temp_rcutsq = s_rcutsq[typpair];
                     typename evaluator::param_type temp_param = s_params[typpair];
 
@@ -545,15 +517,6 @@ __global__ void gpu_compute_triplet_forces_kernel(Scalar4 *d_force,
                         {
                         Scalar4 forcek = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
 
-                        // compute rik
-                        Scalar3 dxik = posi - posk;
-
-                        // apply the periodic boundary conditions
-                        dxik = box.minImage(dxik);
-
-                        // compute rik_sq
-                        Scalar rik_sq = dot(dxik, dxik);
-
                         // compute the bond angle (if needed)
                         Scalar cos_th = Scalar(0.0);
                         if (evaluator::needsAngle())
@@ -705,6 +668,28 @@ void get_max_block_size(T func, const tersoff_args_t& pair_args, unsigned int& m
     kernel_shared_bytes = attr.sharedSizeBytes;
     }
 
+//! Dynamic shared memory needed by gpu_compute_triplet_forces_kernel()
+/*! \param pair_args Arguments of the kernel launch
+    \param block_size Number of threads per block
+*/
+template<class evaluator>
+unsigned int gpu_tersoff_shared_bytes(const tersoff_args_t& pair_args, unsigned int block_size)
+    {
+    Index2D typpair_idx(pair_args.ntypes);
+    return (sizeof(Scalar) + sizeof(typename evaluator::param_type)) * typpair_idx.getNumElements()
+        + pair_args.ntypes*block_size*sizeof(Scalar)
+        + (block_size/pair_args.tpp)*pair_args.tile*(sizeof(Scalar4) + sizeof(uint2));
+    }
+
+//! Copy kernel arguments with a different neighbor shell cache size
+inline tersoff_args_t tersoff_args_with_tile(const tersoff_args_t& pair_args, unsigned int tile)
+    {
+    return tersoff_args_t(pair_args.d_force, pair_args.N, pair_args.Nghosts, pair_args.d_virial, pair_args.virial_pitch,
+        pair_args.compute_virial, pair_args.d_pos, pair_args.box, pair_args.d_n_neigh, pair_args.d_nlist,
+        pair_args.d_head_list, pair_args.d_rcutsq, pair_args.d_ronsq, pair_args.size_nlist, pair_args.ntypes,
+        pair_args.block_size, pair_args.tpp, tile, pair_args.compute_capability, pair_args.devprop);
+    }
+
 //! Tersoff compute kernel launcher
 /*!
  * \tparam evaluator Evaluator class
@@ -750,16 +735,21 @@ struct TersoffComputeKernel
                 }
 
             // size shared bytes
-            Index2D typpair_idx(pair_args.ntypes);
-            unsigned int shared_bytes = (sizeof(Scalar) + sizeof(typename evaluator::param_type))
-                                        * typpair_idx.getNumElements() + pair_args.ntypes*run_block_size*sizeof(Scalar);
+            unsigned int shared_bytes = gpu_tersoff_shared_bytes<evaluator>(pair_args, run_block_size);
 
-            while (shared_bytes + kernel_shared_bytes >= pair_args.devprop.sharedMemPerBlock)
+            while (shared_bytes + kernel_shared_bytes >= pair_args.devprop.sharedMemPerBlock
+                   && run_block_size > pair_args.devprop.warpSize)
                 {
                 run_block_size -= pair_args.devprop.warpSize;
 
-                shared_bytes = (sizeof(Scalar) + sizeof(typename evaluator::param_type))
-                               * typpair_idx.getNumElements() + pair_args.ntypes*run_block_size*sizeof(Scalar);
+                shared_bytes = gpu_tersoff_shared_bytes<evaluator>(pair_args, run_block_size);
+                }
+
+            if (shared_bytes + kernel_shared_bytes >= pair_args.devprop.sharedMemPerBlock && pair_args.tile > 0)
+                {
+                // the neighbor shell cache does not fit even into a single warp, run without it
+                launch(tersoff_args_with_tile(pair_args, 0), d_params);
+                return;
                 }
 
             // zero the forces
@@ -785,7 +775,8 @@ struct TersoffComputeKernel
                                                 d_params,
                                                 pair_args.d_rcutsq,
                                                 pair_args.d_ronsq,
-                                                pair_args.ntypes);
+                                                pair_args.ntypes,
+                                                pair_args.tile);
             }
         else
             {
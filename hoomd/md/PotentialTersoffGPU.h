@@ -27,6 +27,9 @@
     as a shell dealing with all the details of looping while the evaluator actually computes the
     potential and forces.
 
+    The autotuner searches the block size, the number of threads per particle and the size of the neighbor shell
+    cache in shared memory, which avoids reading the neighbor positions once per j-k triplet.
+
     \tparam evaluator Evaluator class used to evaluate V(r) and F(r)/r
     \tparam gpu_cgpf Driver function that calls gpu_compute_tersoff_forces<evaluator>()
 
@@ -80,24 +83,20 @@ PotentialTersoffGPU< evaluator, gpu_cgpf >::PotentialTersoffGPU(std::shared_ptr<
         }
 
     // initialize autotuner
-    // the full block size and threads_per_particle matrix is searched,
-    // encoded as block_size*10000 + threads_per_particle
-    unsigned int max_tpp = 1;
-    max_tpp = this->m_exec_conf->dev_prop.warpSize;
-
-    std::vector<unsigned int> valid_params;
+    // the block size, neighbor shell cache size and threads_per_particle are searched by coordinate descent,
+    // encoded as block_size*10000 + tile*100 + threads_per_particle
+    std::vector< std::vector<unsigned int> > dim_values(3);
     for (unsigned int block_size = 32; block_size <= 1024; block_size += 32)
-        {
-        unsigned int s=1;
+        dim_values[0].push_back(block_size);
 
-        while (s <= max_tpp)
-            {
-            valid_params.push_back(block_size*10000 + s);
-            s = s * 2;
-            }
-        }
+    // cache sizes must be multiples of 16 (0 disables the cache)
+    dim_values[1] = {0, 16, 32, 64};
+
+    for (unsigned int s = 1; s <= (unsigned int)this->m_exec_conf->dev_prop.warpSize; s *= 2)
+        dim_values[2].push_back(s);
+    std::vector<unsigned int> dim_weights = {10000, 100, 1};
 
-    m_tuner.reset(new Autotuner(valid_params, 5, 100000, "pair_tersoff", this->m_exec_conf));
+    m_tuner.reset(new Autotuner(dim_values, dim_weights, 5, 100000, "pair_tersoff", this->m_exec_conf));
     }
 
 template< class evaluator, cudaError_t gpu_cgpf(const tersoff_args_t& pair_args,
@@ -150,7 +149,8 @@ void PotentialTersoffGPU< evaluator, gpu_cgpf >::computeForces(unsigned int time
     this->m_tuner->begin();
     unsigned int param =  this->m_tuner->getParam();
     unsigned int block_size = param / 10000;
-    unsigned int threads_per_particle = param % 10000;
+    unsigned int tile = (param % 10000) / 100;
+    unsigned int threads_per_particle = param % 100;
 
     gpu_cgpf(tersoff_args_t(d_force.data,
                             this->m_pdata->getN(),
@@ -169,6 +169,7 @@ void PotentialTersoffGPU< evaluator, gpu_cgpf >::computeForces(unsigned int time
                             this->m_pdata->getNTypes(),
                             block_size,
                             threads_per_particle,
+                            tile,
                             this->m_exec_conf->getComputeCapability()/10,
                             this->m_exec_conf->dev_prop),
                             d_params.data);
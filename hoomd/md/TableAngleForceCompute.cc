@@ -5,6 +5,7 @@
 // Maintainer: phillicl
 
 #include "TableAngleForceCompute.h"
+#include "TableInterpolation.h"
 
 namespace py = pybind11;
 
@@ -29,7 +30,7 @@ using namespace std;
 TableAngleForceCompute::TableAngleForceCompute(std::shared_ptr<SystemDefinition> sysdef,
                                unsigned int table_width,
                                const std::string& log_suffix)
-        : ForceCompute(sysdef), m_table_width(table_width)
+        : ForceCompute(sysdef), m_table_width(table_width), m_cubic(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing TableAngleForceCompute" << endl;
 
@@ -58,6 +59,8 @@ TableAngleForceCompute::TableAngleForceCompute(std::shared_ptr<SystemDefinition>
     // allocate storage for the tables and parameters
     GPUArray<Scalar2> tables(m_table_width, m_angle_data->getNTypes(), m_exec_conf);
     m_tables.swap(tables);
+    GPUArray<Scalar4> coeffs(m_table_width, m_angle_data->getNTypes(), m_exec_conf);
+    m_coeffs.swap(coeffs);
     assert(!m_tables.isNull());
 
     // helper to compute indices
@@ -107,6 +110,14 @@ void TableAngleForceCompute::setTable(unsigned int type,
         h_tables.data[m_table_value(i, type)].x = V[i];
         h_tables.data[m_table_value(i, type)].y = T[i];
         }
+
+    // precompute the cubic Hermite polynomial of every interval, the last point continues linearly
+    ArrayHandle<Scalar4> h_coeffs(m_coeffs, access_location::host, access_mode::readwrite);
+    Scalar delta = Scalar(M_PI)/Scalar(m_table_width - 1);
+    for (unsigned int i = 0; i < m_table_width - 1; i++)
+        h_coeffs.data[m_table_value(i, type)] = table_hermite_coeffs(V[i], T[i], V[i+1], T[i+1], delta);
+    h_coeffs.data[m_table_value(m_table_width - 1, type)] =
+        make_scalar4(V[m_table_width - 1], -T[m_table_width - 1] * delta, Scalar(0.0), Scalar(0.0));
     }
 
 /*! TableAngleForceCompute provides
@@ -166,11 +177,25 @@ void TableAngleForceCompute::computeForces(unsigned int timestep)
 
     // access the table data
     ArrayHandle<Scalar2> h_tables(m_tables, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_coeffs(m_coeffs, access_location::host, access_mode::read);
 
-    // for each of the angles
+    // sort the angles by type (counting sort), so that consecutive angles read from the same table
     const unsigned int size = (unsigned int)m_angle_data->getN();
+    const unsigned int n_types = m_angle_data->getNTypes();
+    m_type_offset.assign(n_types + 1, 0);
+    for (unsigned int i = 0; i < size; i++)
+        m_type_offset[m_angle_data->getTypeByIndex(i) + 1]++;
+    for (unsigned int type = 0; type < n_types; type++)
+        m_type_offset[type + 1] += m_type_offset[type];
+    m_order.resize(size);
     for (unsigned int i = 0; i < size; i++)
+        m_order[m_type_offset[m_angle_data->getTypeByIndex(i)]++] = i;
+
+    // for each of the angles
+    for (unsigned int cur = 0; cur < size; cur++)
         {
+        const unsigned int i = m_order[cur];
+
         // lookup the tag of each of the particles participating in the angle
         const AngleData::members_t& angle = m_angle_data->getMembersByIndex(i);
         assert(angle.tag[0] <= m_pdata->getMaximumTag());
@@ -243,25 +268,35 @@ void TableAngleForceCompute::computeForces(unsigned int timestep)
         // precomputed term
         Scalar value_f = theta / delta_th;
 
-        // compute index into the table and read in values
+        // compute index into the table
 
         /// Here we use the table!!
         unsigned int angle_type = m_angle_data->getTypeByIndex(i);
         unsigned int value_i = floor(value_f);
-        Scalar2 VT0 = h_tables.data[m_table_value(value_i, angle_type)];
-        Scalar2 VT1 = h_tables.data[m_table_value(value_i+1, angle_type)];
-        // unpack the data
-        Scalar V0 = VT0.x;
-        Scalar V1 = VT1.x;
-        Scalar T0 = VT0.y;
-        Scalar T1 = VT1.y;
-
-        // compute the linear interpolation coefficient
+
+        // compute the interpolation coefficient
         Scalar f = value_f - Scalar(value_i);
 
-        // interpolate to get V and T;
-        Scalar V = V0 + f * (V1 - V0);
-        Scalar T = T0 + f * (T1 - T0);
+        Scalar V, T;
+        if (m_cubic)
+            {
+            table_hermite_eval(h_coeffs.data[m_table_value(value_i, angle_type)], f, delta_th, V, T);
+            }
+        else
+            {
+            // read in values
+            Scalar2 VT0 = h_tables.data[m_table_value(value_i, angle_type)];
+            Scalar2 VT1 = h_tables.data[m_table_value(value_i+1, angle_type)];
+            // unpack the data
+            Scalar V0 = VT0.x;
+            Scalar V1 = VT1.x;
+            Scalar T0 = VT0.y;
+            Scalar T1 = VT1.y;
+
+            // interpolate to get V and T;
+            V = V0 + f * (V1 - V0);
+            T = T0 + f * (T1 - T0);
+            }
 
         Scalar a =  T*s_abbc;
         Scalar a11 = a*c_abbc/rsqab;
@@ -333,5 +368,6 @@ void export_TableAngleForceCompute(py::module& m)
     py::class_<TableAngleForceCompute, std::shared_ptr<TableAngleForceCompute> >(m, "TableAngleForceCompute", py::base<ForceCompute>())
     .def(py::init< std::shared_ptr<SystemDefinition>, unsigned int, const std::string& >())
     .def("setTable", &TableAngleForceCompute::setTable)
+    .def("setCubicInterpolation", &TableAngleForceCompute::setCubicInterpolation)
     ;
     }
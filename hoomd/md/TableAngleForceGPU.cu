@@ -5,6 +5,7 @@
 // Maintainer: phillicl
 
 #include "TableAngleForceGPU.cuh"
+#include "TableInterpolation.h"
 #include "hoomd/TextureTools.h"
 
 #include <assert.h>
@@ -20,6 +21,9 @@
 //! Texture for reading table values
 scalar2_tex_t tables_tex;
 
+//! Texture for reading the cubic table coefficients
+scalar4_tex_t coeffs_tex;
+
 /*!  This kernel is called to calculate the table angle forces on all triples this is defined or
 
     \param d_force Device memory to write computed forces
@@ -34,15 +38,21 @@ scalar2_tex_t tables_tex;
     \param n_angles_list List of numbers of angles stored on the GPU
     \param n_angle_type number of angle types
     \param d_tables Tables of the potential and force
+    \param d_coeffs Cubic Hermite coefficients of the table intervals
     \param table_value index helper function
     \param delta_th angle delta of the table
 
     See TableAngleForceCompute for information on the memory layout.
 
+    \tparam cubic When non-zero, the cubic Hermite coefficients are evaluated instead of interpolating linearly
+
     \b Details:
     * Table entries are read from tables_tex. Note that currently this is bound to a 1D memory region. Performance tests
       at a later date may result in this changing.
+    * On sm_35 and newer, the table entries are read through the read-only data cache with __ldg. The coefficients of
+      a type are stored contiguously, and a cubic evaluation reads a single Scalar4.
 */
+template<unsigned char cubic>
 __global__ void gpu_compute_table_angle_forces_kernel(Scalar4* d_force,
                                      Scalar* d_virial,
                                      const unsigned int virial_pitch,
@@ -54,6 +64,7 @@ __global__ void gpu_compute_table_angle_forces_kernel(Scalar4* d_force,
                                      const unsigned int pitch,
                                      const unsigned int *n_angles_list,
                                      const Scalar2 *d_tables,
+                                     const Scalar4 *d_coeffs,
                                      const Index2D table_value,
                                      const Scalar delta_th)
     {
@@ -151,22 +162,33 @@ __global__ void gpu_compute_table_angle_forces_kernel(Scalar4* d_force,
         // precomputed term
         Scalar value_f = theta / delta_th;
 
-        // compute index into the table and read in values
+        // compute index into the table
         unsigned int value_i = value_f;
-        Scalar2 VT0 = texFetchScalar2(d_tables, tables_tex, table_value(value_i, cur_angle_type));
-        Scalar2 VT1 = texFetchScalar2(d_tables, tables_tex, table_value(value_i+1, cur_angle_type));
-        // unpack the data
-        Scalar V0 = VT0.x;
-        Scalar V1 = VT1.x;
-        Scalar T0 = VT0.y;
-        Scalar T1 = VT1.y;
-
-        // compute the linear interpolation coefficient
+
+        // compute the interpolation coefficient
         Scalar f = value_f - Scalar(value_i);
 
-        // interpolate to get V and T;
-        Scalar V = V0 + f * (V1 - V0);
-        Scalar T = T0 + f * (T1 - T0);
+        Scalar V, T;
+        if (cubic)
+            {
+            Scalar4 c = texFetchScalar4(d_coeffs, coeffs_tex, table_value(value_i, cur_angle_type));
+            table_hermite_eval(c, f, delta_th, V, T);
+            }
+        else
+            {
+            // read in values
+            Scalar2 VT0 = texFetchScalar2(d_tables, tables_tex, table_value(value_i, cur_angle_type));
+            Scalar2 VT1 = texFetchScalar2(d_tables, tables_tex, table_value(value_i+1, cur_angle_type));
+            // unpack the data
+            Scalar V0 = VT0.x;
+            Scalar V1 = VT1.x;
+            Scalar T0 = VT0.y;
+            Scalar T1 = VT1.y;
+
+            // interpolate to get V and T;
+            V = V0 + f * (V1 - V0);
+            T = T0 + f * (T1 - T0);
+            }
 
 
         Scalar a = T * s_abbc;
@@ -237,10 +259,12 @@ __global__ void gpu_compute_table_angle_forces_kernel(Scalar4* d_force,
     \param n_angles_list List of numbers of angles stored on the GPU
     \param n_angle_type number of angle types
     \param d_tables Tables of the potential and force
+    \param d_coeffs Cubic Hermite coefficients of the table intervals
     \param table_width Number of points in each table
     \param table_value indexer helper
     \param block_size Block size at which to run the kernel
     \param compute_capability Compute capability of the device (200, 300, 350, ...)
+    \param cubic True to evaluate the cubic Hermite coefficients instead of interpolating linearly
 
     \note This is just a kernel driver. See gpu_compute_table_angle_forces_kernel for full documentation.
 */
@@ -255,12 +279,15 @@ cudaError_t gpu_compute_table_angle_forces(Scalar4* d_force,
                                      const unsigned int pitch,
                                      const unsigned int *n_angles_list,
                                      const Scalar2 *d_tables,
+                                     const Scalar4 *d_coeffs,
                                      const unsigned int table_width,
                                      const Index2D &table_value,
                                      const unsigned int block_size,
-                                     const unsigned int compute_capability)
+                                     const unsigned int compute_capability,
+                                     const bool cubic)
     {
     assert(d_tables);
+    assert(d_coeffs);
     assert(table_width > 1);
 
     if (N == 0)
@@ -270,8 +297,11 @@ cudaError_t gpu_compute_table_angle_forces(Scalar4* d_force,
     if (max_block_size == UINT_MAX)
         {
         cudaFuncAttributes attr;
-        cudaFuncGetAttributes(&attr, (const void *)gpu_compute_table_angle_forces_kernel);
+        cudaFuncGetAttributes(&attr, (const void *)gpu_compute_table_angle_forces_kernel<0>);
         max_block_size = attr.maxThreadsPerBlock;
+
+        cudaFuncGetAttributes(&attr, (const void *)gpu_compute_table_angle_forces_kernel<1>);
+        max_block_size = min(max_block_size, (unsigned int)attr.maxThreadsPerBlock);
         }
 
     unsigned int run_block_size = min(block_size, max_block_size);
@@ -286,26 +316,54 @@ cudaError_t gpu_compute_table_angle_forces(Scalar4* d_force,
         tables_tex.normalized = false;
         tables_tex.filterMode = cudaFilterModePoint;
         cudaError_t error = cudaBindTexture(0, tables_tex, d_tables, sizeof(Scalar2) * table_value.getNumElements());
+        if (error != cudaSuccess)
+            return error;
+
+        coeffs_tex.normalized = false;
+        coeffs_tex.filterMode = cudaFilterModePoint;
+        error = cudaBindTexture(0, coeffs_tex, d_coeffs, sizeof(Scalar4) * table_value.getNumElements());
         if (error != cudaSuccess)
             return error;
         }
 
     Scalar delta_th = Scalar(M_PI)/(Scalar)(table_width - 1);
 
-    gpu_compute_table_angle_forces_kernel<<< grid, threads >>>
-            (d_force,
-             d_virial,
-             virial_pitch,
-             N,
-             d_pos,
-             box,
-             alist,
-             apos_list,
-             pitch,
-             n_angles_list,
-             d_tables,
-             table_value,
-             delta_th);
+    if (cubic)
+        {
+        gpu_compute_table_angle_forces_kernel<1><<< grid, threads >>>
+                (d_force,
+                 d_virial,
+                 virial_pitch,
+                 N,
+                 d_pos,
+                 box,
+                 alist,
+                 apos_list,
+                 pitch,
+                 n_angles_list,
+                 d_tables,
+                 d_coeffs,
+                 table_value,
+                 delta_th);
+        }
+    else
+        {
+        gpu_compute_table_angle_forces_kernel<0><<< grid, threads >>>
+                (d_force,
+                 d_virial,
+                 virial_pitch,
+                 N,
+                 d_pos,
+                 box,
+                 alist,
+                 apos_list,
+                 pitch,
+                 n_angles_list,
+                 d_tables,
+                 d_coeffs,
+                 table_value,
+                 delta_th);
+        }
 
     return cudaSuccess;
     }
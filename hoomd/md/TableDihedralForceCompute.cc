@@ -5,6 +5,7 @@
 // Maintainer: phillicl
 
 #include "TableDihedralForceCompute.h"
+#include "TableInterpolation.h"
 #include "hoomd/VectorMath.h"
 
 namespace py = pybind11;
@@ -30,7 +31,7 @@ using namespace std;
 TableDihedralForceCompute::TableDihedralForceCompute(std::shared_ptr<SystemDefinition> sysdef,
                                unsigned int table_width,
                                const std::string& log_suffix)
-        : ForceCompute(sysdef), m_table_width(table_width)
+        : ForceCompute(sysdef), m_table_width(table_width), m_cubic(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing TableDihedralForceCompute" << endl;
 
@@ -49,6 +50,8 @@ TableDihedralForceCompute::TableDihedralForceCompute(std::shared_ptr<SystemDefin
     // allocate storage for the tables and parameters
     GPUArray<Scalar2> tables(m_table_width, m_dihedral_data->getNTypes(), m_exec_conf);
     m_tables.swap(tables);
+    GPUArray<Scalar4> coeffs(m_table_width, m_dihedral_data->getNTypes(), m_exec_conf);
+    m_coeffs.swap(coeffs);
     assert(!m_tables.isNull());
 
     // helper to compute indices
@@ -96,6 +99,14 @@ void TableDihedralForceCompute::setTable(unsigned int type,
         h_tables.data[m_table_value(i, type)].x = V[i];
         h_tables.data[m_table_value(i, type)].y = T[i];
         }
+
+    // precompute the cubic Hermite polynomial of every interval, the last point continues linearly
+    ArrayHandle<Scalar4> h_coeffs(m_coeffs, access_location::host, access_mode::readwrite);
+    Scalar delta = Scalar(2.0*M_PI)/Scalar(m_table_width - 1);
+    for (unsigned int i = 0; i < m_table_width - 1; i++)
+        h_coeffs.data[m_table_value(i, type)] = table_hermite_coeffs(V[i], T[i], V[i+1], T[i+1], delta);
+    h_coeffs.data[m_table_value(m_table_width - 1, type)] =
+        make_scalar4(V[m_table_width - 1], -T[m_table_width - 1] * delta, Scalar(0.0), Scalar(0.0));
     }
 
 /*! TableDihedralForceCompute provides
@@ -155,11 +166,25 @@ void TableDihedralForceCompute::computeForces(unsigned int timestep)
 
     // access the table data
     ArrayHandle<Scalar2> h_tables(m_tables, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_coeffs(m_coeffs, access_location::host, access_mode::read);
 
-    // for each of the dihedrals
+    // sort the dihedrals by type (counting sort), so that consecutive dihedrals read from the same table
     const unsigned int size = (unsigned int)m_dihedral_data->getN();
+    const unsigned int n_types = m_dihedral_data->getNTypes();
+    m_type_offset.assign(n_types + 1, 0);
+    for (unsigned int i = 0; i < size; i++)
+        m_type_offset[m_dihedral_data->getTypeByIndex(i) + 1]++;
+    for (unsigned int type = 0; type < n_types; type++)
+        m_type_offset[type + 1] += m_type_offset[type];
+    m_order.resize(size);
     for (unsigned int i = 0; i < size; i++)
+        m_order[m_type_offset[m_dihedral_data->getTypeByIndex(i)]++] = i;
+
+    // for each of the dihedrals
+    for (unsigned int cur = 0; cur < size; cur++)
         {
+        const unsigned int i = m_order[cur];
+
         // lookup the tag of each of the particles participating in the dihedral
         const DihedralData::members_t& dihedral = m_dihedral_data->getMembersByIndex(i);
         assert(dihedral.tag[0] <= m_pdata->getMaximumTag());
@@ -273,25 +298,35 @@ void TableDihedralForceCompute::computeForces(unsigned int timestep)
         Scalar delta_phi = Scalar(2.0*M_PI)/Scalar(m_table_width - 1);
         Scalar value_f = (Scalar(M_PI)+phi) / delta_phi;
 
-        // compute index into the table and read in values
+        // compute index into the table
 
         /// Here we use the table!!
         unsigned int dihedral_type = m_dihedral_data->getTypeByIndex(i);
         unsigned int value_i = value_f;
-        Scalar2 VT0 = h_tables.data[m_table_value(value_i, dihedral_type)];
-        Scalar2 VT1 = h_tables.data[m_table_value(value_i+1, dihedral_type)];
-        // unpack the data
-        Scalar V0 = VT0.x;
-        Scalar V1 = VT1.x;
-        Scalar T0 = VT0.y;
-        Scalar T1 = VT1.y;
-
-        // compute the linear interpolation coefficient
+
+        // compute the interpolation coefficient
         Scalar f = value_f - Scalar(value_i);
 
-        // interpolate to get V and T;
-        Scalar V = V0 + f * (V1 - V0);
-        Scalar T = T0 + f * (T1 - T0);
+        Scalar V, T;
+        if (m_cubic)
+            {
+            table_hermite_eval(h_coeffs.data[m_table_value(value_i, dihedral_type)], f, delta_phi, V, T);
+            }
+        else
+            {
+            // read in values
+            Scalar2 VT0 = h_tables.data[m_table_value(value_i, dihedral_type)];
+            Scalar2 VT1 = h_tables.data[m_table_value(value_i+1, dihedral_type)];
+            // unpack the data
+            Scalar V0 = VT0.x;
+            Scalar V1 = VT1.x;
+            Scalar T0 = VT0.y;
+            Scalar T1 = VT1.y;
+
+            // interpolate to get V and T;
+            V = V0 + f * (V1 - V0);
+            T = T0 + f * (T1 - T0);
+            }
 
         // from Blondel and Karplus 1995
         vec3<Scalar> A = cross(vec3<Scalar>(dab),vec3<Scalar>(dcbm));
@@ -359,5 +394,6 @@ void export_TableDihedralForceCompute(py::module& m)
     .def(py::init< std::shared_ptr<SystemDefinition>, unsigned int, const std::string& >())
     .def("setTable", &TableDihedralForceCompute::setTable)
     .def("getEntry", &TableDihedralForceCompute::getEntry)
+    .def("setCubicInterpolation", &TableDihedralForceCompute::setCubicInterpolation)
     ;
     }
@@ -49,6 +49,12 @@
     Values are interpolated linearly between two points straddling the given r. For a given r, the first point needed, i
     can be calculated via i = floorf((r - rmin) / dr). The fraction between ri and ri+1 can be calculated via
     f = (r - rmin) / dr - Scalar(i). And the linear interpolation can then be performed via V(r) ~= Vi + f * (Vi+1 - Vi)
+
+    With setCubicInterpolation(), every interval is instead evaluated with the cubic Hermite polynomial that matches V
+    and T at both of its ends (see TableInterpolation.h). The coefficients of all intervals of a type are stored in one
+    contiguous row of m_coeffs, so that an evaluation reads a single Scalar4.
+
+    On the CPU, the dihedrals are evaluated grouped by type, so that consecutive lookups hit the same table.
     \ingroup computes
 */
 class PYBIND11_EXPORT TableDihedralForceCompute : public ForceCompute
@@ -67,6 +73,15 @@ class PYBIND11_EXPORT TableDihedralForceCompute : public ForceCompute
                               const std::vector<Scalar> &V,
                               const std::vector<Scalar> &T);
 
+        //! Set the interpolation of the tables
+        /*! \param cubic True to evaluate the cubic Hermite polynomials of the table intervals, false to interpolate
+                         linearly
+        */
+        void setCubicInterpolation(bool cubic)
+            {
+            m_cubic = cubic;
+            }
+
         //! Returns a list of log quantities this compute calculates
         virtual std::vector< std::string > getProvidedLogQuantities();
 
@@ -104,6 +119,10 @@ class PYBIND11_EXPORT TableDihedralForceCompute : public ForceCompute
         unsigned int m_table_width;                 //!< Width of the tables in memory
         GPUArray<Scalar2> m_tables;                  //!< Stored V and F tables
         Index2D m_table_value;                      //!< Index table helper
+        GPUArray<Scalar4> m_coeffs;                 //!< Cubic Hermite coefficients of the table intervals
+        bool m_cubic;                               //!< True if the tables are interpolated with cubic polynomials
+        std::vector<unsigned int> m_order;          //!< Indices of the dihedrals sorted by type
+        std::vector<unsigned int> m_type_offset;    //!< Scratch offsets of the types in m_order
         std::string m_log_name;                     //!< Cached log name
 
         //! Actually compute the forces
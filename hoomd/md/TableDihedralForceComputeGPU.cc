@@ -57,6 +57,7 @@ void TableDihedralForceComputeGPU::computeForces(unsigned int timestep)
 
     // access the table data
     ArrayHandle<Scalar2> d_tables(m_tables, access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_coeffs(m_coeffs, access_location::device, access_mode::read);
 
     ArrayHandle<Scalar4> d_force(m_force,access_location::device,access_mode::overwrite);
     ArrayHandle<Scalar> d_virial(m_virial,access_location::device,access_mode::overwrite);
@@ -81,10 +82,12 @@ void TableDihedralForceComputeGPU::computeForces(unsigned int timestep)
                              m_dihedral_data->getGPUTableIndexer().getW(),
                              d_gpu_n_dihedrals.data,
                              d_tables.data,
+                             d_coeffs.data,
                              m_table_width,
                              m_table_value,
                              m_tuner->getParam(),
-                             m_exec_conf->getComputeCapability());
+                             m_exec_conf->getComputeCapability(),
+                             m_cubic);
         }
 
 
@@ -28,9 +28,11 @@ cudaError_t gpu_compute_table_dihedral_forces(Scalar4* d_force,
                                      const unsigned int pitch,
                                      const unsigned int *n_dihedrals_list,
                                      const Scalar2 *d_tables,
+                                     const Scalar4 *d_coeffs,
                                      const unsigned int table_width,
                                      const Index2D &table_value,
                                      const unsigned int block_size,
-                                     const unsigned int compute_capability);
+                                     const unsigned int compute_capability,
+                                     const bool cubic);
 
 #endif
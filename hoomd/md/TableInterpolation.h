@@ -0,0 +1,66 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#ifndef __TABLE_INTERPOLATION_H__
+#define __TABLE_INTERPOLATION_H__
+
+#include "hoomd/HOOMDMath.h"
+
+/*! \file TableInterpolation.h
+    \brief Cubic Hermite interpolation of tabulated potentials
+    \details The table potentials (TablePotential and BondTablePotential) store the potential V and the force
+    F = -dV/dx at equally spaced points x_i.
+    Linear interpolation of V and F requires very fine tables for accurate forces. With the cubic mode, every interval
+    [x_i, x_i+1] is instead represented by the cubic Hermite polynomial that matches V and -F at both ends,
+    V(t) = a + b t + c t^2 + d t^3 with t = (x - x_i) / dx in [0,1). The four coefficients are precomputed per interval
+    and stored in a Scalar4, so one evaluation reads a single Scalar4 from the table. The force is the exact derivative
+    of the interpolated potential, which keeps the energy conserved.
+*/
+
+// need to declare these functions with __device__ qualifiers when building in nvcc
+// HOSTDEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#ifdef NVCC
+#define HOSTDEVICE __host__ __device__
+#else
+#define HOSTDEVICE
+#endif
+
+//! Compute the cubic Hermite coefficients of one table interval
+/*! \param V0 Potential at the start of the interval
+    \param F0 Force (-dV/dx) at the start of the interval
+    \param V1 Potential at the end of the interval
+    \param F1 Force (-dV/dx) at the end of the interval
+    \param delta Width of the interval
+    \returns The coefficients a, b, c, d (in x, y, z, w) of V(t) = a + b t + c t^2 + d t^3
+*/
+HOSTDEVICE inline Scalar4 table_hermite_coeffs(Scalar V0, Scalar F0, Scalar V1, Scalar F1, Scalar delta)
+    {
+    // slopes with respect to t
+    Scalar m0 = -F0 * delta;
+    Scalar m1 = -F1 * delta;
+
+    return make_scalar4(V0,
+                        m0,
+                        Scalar(3.0) * (V1 - V0) - Scalar(2.0) * m0 - m1,
+                        Scalar(2.0) * (V0 - V1) + m0 + m1);
+    }
+
+//! Evaluate the potential and force of a table interval from its cubic Hermite coefficients
+/*! \param c Coefficients of the interval (see table_hermite_coeffs())
+    \param t Fractional position in the interval
+    \param delta Width of the interval
+    \param V Interpolated potential (output)
+    \param F Interpolated force -dV/dx (output)
+*/
+HOSTDEVICE inline void table_hermite_eval(const Scalar4& c, Scalar t, Scalar delta, Scalar& V, Scalar& F)
+    {
+    V = c.x + t * (c.y + t * (c.z + t * c.w));
+    F = -(c.y + t * (Scalar(2.0) * c.z + Scalar(3.0) * t * c.w)) / delta;
+    }
+
+#undef HOSTDEVICE
+
+#endif // __TABLE_INTERPOLATION_H__
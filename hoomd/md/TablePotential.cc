@@ -4,6 +4,7 @@
 
 // Maintainer: joaander
 #include "TablePotential.h"
+#include "TableInterpolation.h"
 
 namespace py = pybind11;
 
@@ -24,7 +25,7 @@ TablePotential::TablePotential(std::shared_ptr<SystemDefinition> sysdef,
                                std::shared_ptr<NeighborList> nlist,
                                unsigned int table_width,
                                const std::string& log_suffix)
-        : ForceCompute(sysdef), m_nlist(nlist), m_table_width(table_width)
+        : ForceCompute(sysdef), m_nlist(nlist), m_table_width(table_width), m_cubic(false)
     {
     m_exec_conf->msg->notice(5) << "Constructing TablePotential" << endl;
 
@@ -48,6 +49,8 @@ TablePotential::TablePotential(std::shared_ptr<SystemDefinition> sysdef,
     m_tables.swap(tables);
     GPUArray<Scalar4> params(table_index.getNumElements(), m_exec_conf);
     m_params.swap(params);
+    GPUArray<Scalar4> coeffs(m_table_width, table_index.getNumElements(), m_exec_conf);
+    m_coeffs.swap(coeffs);
 
     assert(!m_tables.isNull());
     assert(!m_params.isNull());
@@ -83,6 +86,8 @@ void TablePotential::slotNumTypesChange()
     m_tables.swap(tables);
     GPUArray<Scalar4> params(table_index.getNumElements(), m_exec_conf);
     m_params.swap(params);
+    GPUArray<Scalar4> coeffs(m_table_width, table_index.getNumElements(), m_exec_conf);
+    m_coeffs.swap(coeffs);
 
     assert(!m_tables.isNull());
     assert(!m_params.isNull());
@@ -112,6 +117,7 @@ void TablePotential::setTable(unsigned int typ1,
     // access the arrays
     ArrayHandle<Scalar2> h_tables(m_tables, access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar4> h_params(m_params, access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_coeffs(m_coeffs, access_location::host, access_mode::readwrite);
 
     // range check on the parameters
     if (rmin < 0 || rmax < 0 || rmax <= rmin)
@@ -138,6 +144,13 @@ void TablePotential::setTable(unsigned int typ1,
         h_tables.data[table_value(i, cur_table_index)].x = V[i];
         h_tables.data[table_value(i, cur_table_index)].y = F[i];
         }
+
+    // precompute the cubic Hermite polynomial of every interval, the last point continues linearly
+    Scalar delta_r = h_params.data[cur_table_index].z;
+    for (unsigned int i = 0; i < m_table_width - 1; i++)
+        h_coeffs.data[table_value(i, cur_table_index)] = table_hermite_coeffs(V[i], F[i], V[i+1], F[i+1], delta_r);
+    h_coeffs.data[table_value(m_table_width - 1, cur_table_index)] =
+        make_scalar4(V[m_table_width - 1], -F[m_table_width - 1] * delta_r, Scalar(0.0), Scalar(0.0));
     }
 
 /*! TablePotential provides
@@ -207,6 +220,7 @@ void TablePotential::computeForces(unsigned int timestep)
     // access the table data
     ArrayHandle<Scalar2> h_tables(m_tables, access_location::host, access_mode::read);
     ArrayHandle<Scalar4> h_params(m_params, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_coeffs(m_coeffs, access_location::host, access_mode::read);
 
     // index calculation helpers
     Index2DUpperTriangular table_index(m_ntypes);
@@ -270,22 +284,32 @@ void TablePotential::computeForces(unsigned int timestep)
                 // precomputed term
                 Scalar value_f = (r - rmin) / delta_r;
 
-                // compute index into the table and read in values
+                // compute index into the table
                 unsigned int value_i = (unsigned int)floor(value_f);
-                Scalar2 VF0 = h_tables.data[table_value(value_i, cur_table_index)];
-                Scalar2 VF1 = h_tables.data[table_value(value_i+1, cur_table_index)];
-                // unpack the data
-                Scalar V0 = VF0.x;
-                Scalar V1 = VF1.x;
-                Scalar F0 = VF0.y;
-                Scalar F1 = VF1.y;
-
-                // compute the linear interpolation coefficient
+
+                // compute the interpolation coefficient
                 Scalar f = value_f - Scalar(value_i);
 
-                // interpolate to get V and F;
-                Scalar V = V0 + f * (V1 - V0);
-                Scalar F = F0 + f * (F1 - F0);
+                Scalar V, F;
+                if (m_cubic)
+                    {
+                    table_hermite_eval(h_coeffs.data[table_value(value_i, cur_table_index)], f, delta_r, V, F);
+                    }
+                else
+                    {
+                    // read in values
+                    Scalar2 VF0 = h_tables.data[table_value(value_i, cur_table_index)];
+                    Scalar2 VF1 = h_tables.data[table_value(value_i+1, cur_table_index)];
+                    // unpack the data
+                    Scalar V0 = VF0.x;
+                    Scalar V1 = VF1.x;
+                    Scalar F0 = VF0.y;
+                    Scalar F1 = VF1.y;
+
+                    // interpolate to get V and F;
+                    V = V0 + f * (V1 - V0);
+                    F = F0 + f * (F1 - F0);
+                    }
 
                 // convert to standard variables used by the other pair computes in HOOMD-blue
                 Scalar forcemag_divr = Scalar(0.0);
@@ -348,5 +372,6 @@ void export_TablePotential(py::module& m)
     py::class_<TablePotential, std::shared_ptr<TablePotential> >(m, "TablePotential", py::base<ForceCompute>())
     .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<NeighborList>, unsigned int, const std::string& >())
     .def("setTable", &TablePotential::setTable)
+    .def("setCubicInterpolation", &TablePotential::setCubicInterpolation)
     ;
     }
@@ -56,6 +56,10 @@
     Values are interpolated linearly between two points straddling the given r. For a given r, the first point needed, i
     can be calculated via i = floorf((r - rmin) / dr). The fraction between ri and ri+1 can be calculated via
     f = (r - rmin) / dr - Scalar(i). And the linear interpolation can then be performed via V(r) ~= Vi + f * (Vi+1 - Vi)
+
+    With setCubicInterpolation(), every interval is instead evaluated with the cubic Hermite polynomial through V and F
+    at both of its ends (see TableInterpolation.h). The coefficients of the polynomials are precomputed in setTable()
+    and stored in a separate Scalar4 table with the same layout, so that much coarser tables reach the same accuracy.
     \ingroup computes
 */
 class PYBIND11_EXPORT TablePotential : public ForceCompute
@@ -78,18 +82,34 @@ class PYBIND11_EXPORT TablePotential : public ForceCompute
                               Scalar rmin,
                               Scalar rmax);
 
+        //! Set whether the tables are interpolated with cubic Hermite polynomials instead of linearly
+        void setCubicInterpolation(bool cubic)
+            {
+            m_cubic = cubic;
+            }
+
         //! Returns a list of log quantities this compute calculates
         virtual std::vector< std::string > getProvidedLogQuantities();
 
         //! Calculates the requested log value and returns it
         virtual Scalar getLogValue(const std::string& quantity, unsigned int timestep);
 
+        #ifdef ENABLE_MPI
+        //! The half-shell ghost exchange is not supported
+        virtual bool supportsHalfShell()
+            {
+            return false;
+            }
+        #endif
+
     protected:
         std::shared_ptr<NeighborList> m_nlist;    //!< The neighborlist to use for the computation
         unsigned int m_table_width;                 //!< Width of the tables in memory
         unsigned int m_ntypes;                      //!< Store the number of particle types
         GPUArray<Scalar2> m_tables;                  //!< Stored V and F tables
         GPUArray<Scalar4> m_params;                 //!< Parameters stored for each table
+        GPUArray<Scalar4> m_coeffs;                 //!< Cubic Hermite coefficients of every table interval
+        bool m_cubic;                               //!< True if the tables are interpolated with cubic polynomials
         std::string m_log_name;                     //!< Cached log name
 
         //! Actually compute the forces
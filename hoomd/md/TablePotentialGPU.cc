@@ -71,31 +71,37 @@ void TablePotentialGPU::computeForces(unsigned int timestep)
 
     // access the table data
     ArrayHandle<Scalar2> d_tables(m_tables, access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_coeffs(m_coeffs, access_location::device, access_mode::read);
     ArrayHandle<Scalar4> d_params(m_params, access_location::device, access_mode::read);
 
     ArrayHandle<Scalar4> d_force(m_force,access_location::device,access_mode::overwrite);
     ArrayHandle<Scalar> d_virial(m_virial,access_location::device,access_mode::overwrite);
 
+    table_kernel_args_t args;
+    args.d_force = d_force.data;
+    args.d_virial = d_virial.data;
+    args.virial_pitch = m_virial.getPitch();
+    args.N = m_pdata->getN();
+    args.n_ghost = m_pdata->getNGhosts();
+    args.d_pos = d_pos.data;
+    args.box = box;
+    args.d_n_neigh = d_n_neigh.data;
+    args.d_nlist = d_nlist.data;
+    args.d_head_list = d_head_list.data;
+    args.d_tables = d_tables.data;
+    args.d_coeffs = d_coeffs.data;
+    args.d_params = d_params.data;
+    args.ntypes = m_ntypes;
+    args.table_width = m_table_width;
+
     // run the kernel on all GPUs in parallel
     m_tuner->begin();
-    gpu_compute_table_forces(d_force.data,
-                             d_virial.data,
-                             m_virial.getPitch(),
-                             m_pdata->getN(),
-                             m_pdata->getNGhosts(),
-                             d_pos.data,
-                             box,
-                             d_n_neigh.data,
-                             d_nlist.data,
-                             d_head_list.data,
-                             d_tables.data,
-                             d_params.data,
+    gpu_compute_table_forces(args,
                              this->m_nlist->getNListArray().getPitch(),
-                             m_ntypes,
-                             m_table_width,
                              m_tuner->getParam(),
                              m_exec_conf->getComputeCapability(),
-                             m_exec_conf->dev_prop.maxTexture1DLinear);
+                             m_exec_conf->dev_prop.maxTexture1DLinear,
+                             m_cubic);
 
     if(m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
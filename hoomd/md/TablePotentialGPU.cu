@@ -5,6 +5,7 @@
 // Maintainer: joaander
 
 #include "TablePotentialGPU.cuh"
+#include "TableInterpolation.h"
 #include "hoomd/TextureTools.h"
 
 #include "hoomd/Index1D.h"
@@ -24,6 +25,12 @@ texture<unsigned int, 1, cudaReadModeElementType> nlist_tex;
 //! Texture for reading table values
 scalar2_tex_t tables_tex;
 
+//! Texture for reading the cubic table coefficients
+scalar4_tex_t coeffs_tex;
+
+//! Maximum size of the cubic coefficient tables that are staged into shared memory
+const unsigned int gpu_table_max_shared_coeffs_bytes = 16384;
+
 /*!  This kernel is called to calculate the table pair forces on all N particles
 
     \param d_force Device memory to write computed forces
@@ -35,6 +42,8 @@ scalar2_tex_t tables_tex;
     \param d_n_neigh Device memory array listing the number of neighbors for each particle
     \param d_nlist Device memory array containing the neighbor list contents
     \param d_head_list Indexer for reading \a d_nlist
+    \param d_tables Tables of the potential and force
+    \param d_coeffs Cubic Hermite coefficients of the table intervals
     \param d_params Parameters for each table associated with a type pair
     \param ntypes Number of particle types in the system
     \param table_width Number of points in each table
@@ -43,12 +52,14 @@ scalar2_tex_t tables_tex;
 
     \tparam use_gmem_nlist When non-zero, the neighbor list is read out of global memory. When zero, textures or __ldg
                            is used depending on architecture.
+    \tparam cubic When non-zero, the cubic Hermite coefficients are evaluated instead of interpolating linearly
+    \tparam shared_coeffs When non-zero, the cubic coefficients of all type pairs are staged into shared memory
 
     \b Details:
     * Table entries are read from tables_tex. Note that currently this is bound to a 1D memory region. Performance tests
       at a later date may result in this changing.
 */
-template<unsigned char use_gmem_nlist>
+template<unsigned char use_gmem_nlist, unsigned char cubic, unsigned char shared_coeffs>
 __global__ void gpu_compute_table_forces_kernel(Scalar4* d_force,
                                                 Scalar* d_virial,
                                                 const unsigned virial_pitch,
@@ -59,6 +70,7 @@ __global__ void gpu_compute_table_forces_kernel(Scalar4* d_force,
                                                 const unsigned int *d_nlist,
                                                 const unsigned int *d_head_list,
                                                 const Scalar2 *d_tables,
+                                                const Scalar4 *d_coeffs,
                                                 const Scalar4 *d_params,
                                                 const unsigned int ntypes,
                                                 const unsigned int table_width)
@@ -74,6 +86,18 @@ __global__ void gpu_compute_table_forces_kernel(Scalar4* d_force,
         if (cur_offset + threadIdx.x < table_index.getNumElements())
             s_params[cur_offset + threadIdx.x] = d_params[cur_offset + threadIdx.x];
         }
+
+    // stage the cubic coefficients behind the parameters
+    Scalar4 *s_coeffs = s_params + table_index.getNumElements();
+    if (shared_coeffs)
+        {
+        const unsigned int n_coeffs = table_width * table_index.getNumElements();
+        for (unsigned int cur_offset = 0; cur_offset < n_coeffs; cur_offset += blockDim.x)
+            {
+            if (cur_offset + threadIdx.x < n_coeffs)
+                s_coeffs[cur_offset + threadIdx.x] = texFetchScalar4(d_coeffs, coeffs_tex, cur_offset + threadIdx.x);
+            }
+        }
     __syncthreads();
 
     // start by identifying which particle we are to handle
@@ -154,23 +178,39 @@ __global__ void gpu_compute_table_forces_kernel(Scalar4* d_force,
             // precomputed term
             Scalar value_f = (r - rmin) / delta_r;
 
-            // compute index into the table and read in values
+            // compute index into the table
             unsigned int value_i = floor(value_f);
-            Scalar2 VF0 = texFetchScalar2(d_tables, tables_tex, table_value(value_i, cur_table_index));
-            Scalar2 VF1 = texFetchScalar2(d_tables, tables_tex, table_value(value_i+1, cur_table_index));
 
-            // unpack the data
-            Scalar V0 = VF0.x;
-            Scalar V1 = VF1.x;
-            Scalar F0 = VF0.y;
-            Scalar F1 = VF1.y;
-
-            // compute the linear interpolation coefficient
+            // compute the interpolation coefficient
             Scalar f = value_f - Scalar(value_i);
 
-            // interpolate to get V and F;
-            Scalar V = V0 + f * (V1 - V0);
-            Scalar F = F0 + f * (F1 - F0);
+            Scalar V, F;
+            if (cubic)
+                {
+                // a single read of the interval's polynomial
+                Scalar4 c;
+                if (shared_coeffs)
+                    c = s_coeffs[table_value(value_i, cur_table_index)];
+                else
+                    c = texFetchScalar4(d_coeffs, coeffs_tex, table_value(value_i, cur_table_index));
+                table_hermite_eval(c, f, delta_r, V, F);
+                }
+            else
+                {
+                // read in values
+                Scalar2 VF0 = texFetchScalar2(d_tables, tables_tex, table_value(value_i, cur_table_index));
+                Scalar2 VF1 = texFetchScalar2(d_tables, tables_tex, table_value(value_i+1, cur_table_index));
+
+                // unpack the data
+                Scalar V0 = VF0.x;
+                Scalar V1 = VF1.x;
+                Scalar F0 = VF0.y;
+                Scalar F1 = VF1.y;
+
+                // interpolate to get V and F;
+                V = V0 + f * (V1 - V0);
+                F = F0 + f * (F1 - F0);
+                }
 
             // convert to standard variables used by the other pair computes in HOOMD-blue
             Scalar forcemag_divr = Scalar(0.0);
@@ -206,53 +246,96 @@ __global__ void gpu_compute_table_forces_kernel(Scalar4* d_force,
     d_virial[5*virial_pitch+idx] = virialzz;
     }
 
-/*! \param d_force Device memory to write computed forces
-    \param d_virial Device memory to write computed virials
-    \param virial_pitch pitch of 2D virial array
-    \param N number of particles
-    \param n_ghost number of ghost particles
-    \param d_pos particle positions on the device
-    \param box Box dimensions used to implement periodic boundary conditions
-    \param d_n_neigh Device memory array listing the number of neighbors for each particle
-    \param d_nlist Device memory array containing the neighbor list contents
-    \param d_head_list Indexer for reading \a d_nlist
-    \param d_tables Tables of the potential and force
-    \param d_params Parameters for each table associated with a type pair
+//! Launch one variant of gpu_compute_table_forces_kernel
+/*! \param grid_args Kernel arguments, see gpu_compute_table_forces()
+    \param block_size Block size at which to run the kernel
+    \param shared_bytes Dynamic shared memory of the kernel
+
+    \tparam use_gmem_nlist When non-zero, the neighbor list is read out of global memory
+    \tparam cubic When non-zero, the cubic Hermite coefficients are evaluated
+    \tparam shared_coeffs When non-zero, the cubic coefficients are staged into shared memory
+*/
+template<unsigned char use_gmem_nlist, unsigned char cubic, unsigned char shared_coeffs>
+void gpu_launch_table_forces_kernel(const table_kernel_args_t& args,
+                                    const unsigned int block_size,
+                                    const unsigned int shared_bytes)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, gpu_compute_table_forces_kernel<use_gmem_nlist, cubic, shared_coeffs>);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+
+    // setup the grid to run the kernel
+    dim3 grid( args.N / run_block_size + 1, 1, 1);
+    dim3 threads(run_block_size, 1, 1);
+
+    gpu_compute_table_forces_kernel<use_gmem_nlist, cubic, shared_coeffs><<< grid, threads, shared_bytes >>>(
+        args.d_force,
+        args.d_virial,
+        args.virial_pitch,
+        args.N,
+        args.d_pos,
+        args.box,
+        args.d_n_neigh,
+        args.d_nlist,
+        args.d_head_list,
+        args.d_tables,
+        args.d_coeffs,
+        args.d_params,
+        args.ntypes,
+        args.table_width);
+    }
+
+//! Select the cubic and shared memory variants of the table kernel
+template<unsigned char use_gmem_nlist>
+void gpu_select_table_forces_kernel(const table_kernel_args_t& args,
+                                    const unsigned int block_size,
+                                    const bool cubic)
+    {
+    Index2DUpperTriangular table_index(args.ntypes);
+    unsigned int params_bytes = sizeof(Scalar4)*table_index.getNumElements();
+    unsigned int coeffs_bytes = sizeof(Scalar4)*args.table_width*table_index.getNumElements();
+
+    if (!cubic)
+        gpu_launch_table_forces_kernel<use_gmem_nlist, 0, 0>(args, block_size, params_bytes);
+    else if (coeffs_bytes <= gpu_table_max_shared_coeffs_bytes)
+        gpu_launch_table_forces_kernel<use_gmem_nlist, 1, 1>(args, block_size, params_bytes + coeffs_bytes);
+    else
+        gpu_launch_table_forces_kernel<use_gmem_nlist, 1, 0>(args, block_size, params_bytes);
+    }
+
+/*! \param args Arguments of the kernel
     \param size_nlist Total length of the neighborlist
-    \param ntypes Number of particle types in the system
-    \param table_width Number of points in each table
     \param block_size Block size at which to run the kernel
     \param compute_capability Compute capability of the device (200, 300, 350)
     \param max_tex1d_width Maximum width of a linear 1d texture
+    \param cubic True to evaluate the cubic Hermite coefficients instead of interpolating linearly
+
+    The cubic coefficients are staged into shared memory when the tables of all type pairs are small enough, and read
+    through the texture cache otherwise.
 
     \note This is just a kernel driver. See gpu_compute_table_forces_kernel for full documentation.
 */
-cudaError_t gpu_compute_table_forces(Scalar4* d_force,
-                                     Scalar* d_virial,
-                                     const unsigned int virial_pitch,
-                                     const unsigned int N,
-                                     const unsigned int n_ghost,
-                                     const Scalar4 *d_pos,
-                                     const BoxDim& box,
-                                     const unsigned int *d_n_neigh,
-                                     const unsigned int *d_nlist,
-                                     const unsigned int *d_head_list,
-                                     const Scalar2 *d_tables,
-                                     const Scalar4 *d_params,
+cudaError_t gpu_compute_table_forces(const table_kernel_args_t& args,
                                      const unsigned int size_nlist,
-                                     const unsigned int ntypes,
-                                     const unsigned int table_width,
                                      const unsigned int block_size,
                                      const unsigned int compute_capability,
-                                     const unsigned int max_tex1d_width)
+                                     const unsigned int max_tex1d_width,
+                                     const bool cubic)
     {
-    assert(d_params);
-    assert(d_tables);
-    assert(ntypes > 0);
-    assert(table_width > 1);
+    assert(args.d_params);
+    assert(args.d_tables);
+    assert(args.d_coeffs);
+    assert(args.ntypes > 0);
+    assert(args.table_width > 1);
 
     // index calculation helper
-    Index2DUpperTriangular table_index(ntypes);
+    Index2DUpperTriangular table_index(args.ntypes);
 
     // texture bind
     if (compute_capability < 350)
@@ -260,7 +343,7 @@ cudaError_t gpu_compute_table_forces(Scalar4* d_force,
         // bind the pdata position texture
         pdata_pos_tex.normalized = false;
         pdata_pos_tex.filterMode = cudaFilterModePoint;
-        cudaError_t error = cudaBindTexture(0, pdata_pos_tex, d_pos, sizeof(Scalar4) * (N+n_ghost));
+        cudaError_t error = cudaBindTexture(0, pdata_pos_tex, args.d_pos, sizeof(Scalar4) * (args.N+args.n_ghost));
         if (error != cudaSuccess)
             return error;
 
@@ -268,7 +351,7 @@ cudaError_t gpu_compute_table_forces(Scalar4* d_force,
             {
             nlist_tex.normalized = false;
             nlist_tex.filterMode = cudaFilterModePoint;
-            error = cudaBindTexture(0, nlist_tex, d_nlist, sizeof(unsigned int)*size_nlist);
+            error = cudaBindTexture(0, nlist_tex, args.d_nlist, sizeof(unsigned int)*size_nlist);
             if (error != cudaSuccess)
                 return error;
             }
@@ -276,73 +359,27 @@ cudaError_t gpu_compute_table_forces(Scalar4* d_force,
         // bind the tables texture
         tables_tex.normalized = false;
         tables_tex.filterMode = cudaFilterModePoint;
-        error = cudaBindTexture(0, tables_tex, d_tables, sizeof(Scalar2) * table_width * table_index.getNumElements());
+        error = cudaBindTexture(0, tables_tex, args.d_tables,
+            sizeof(Scalar2) * args.table_width * table_index.getNumElements());
+        if (error != cudaSuccess)
+            return error;
+
+        // bind the coefficients texture
+        coeffs_tex.normalized = false;
+        coeffs_tex.filterMode = cudaFilterModePoint;
+        error = cudaBindTexture(0, coeffs_tex, args.d_coeffs,
+            sizeof(Scalar4) * args.table_width * table_index.getNumElements());
         if (error != cudaSuccess)
             return error;
         }
 
     if (compute_capability < 350 && size_nlist > max_tex1d_width)
         { // use global memory when the neighbor list must be texture bound, but exceeds the max size of a texture
-        static unsigned int max_block_size = UINT_MAX;
-        if (max_block_size == UINT_MAX)
-            {
-            cudaFuncAttributes attr;
-            cudaFuncGetAttributes(&attr, gpu_compute_table_forces_kernel<1>);
-            max_block_size = attr.maxThreadsPerBlock;
-            }
-
-        unsigned int run_block_size = min(block_size, max_block_size);
-
-        // setup the grid to run the kernel
-        dim3 grid( N / run_block_size + 1, 1, 1);
-        dim3 threads(run_block_size, 1, 1);
-
-        gpu_compute_table_forces_kernel<1><<< grid, threads, sizeof(Scalar4)*table_index.getNumElements() >>>(d_force,
-                                                                                                           d_virial,
-                                                                                                           virial_pitch,
-                                                                                                           N,
-                                                                                                           d_pos,
-                                                                                                           box,
-                                                                                                           d_n_neigh,
-                                                                                                           d_nlist,
-                                                                                                           d_head_list,
-                                                                                                           d_tables,
-                                                                                                           d_params,
-                                                                                                           ntypes,
-                                                                                                           table_width);
+        gpu_select_table_forces_kernel<1>(args, block_size, cubic);
         }
     else
         {
-        static unsigned int max_block_size = UINT_MAX;
-        if (max_block_size == UINT_MAX)
-            {
-            cudaFuncAttributes attr;
-            cudaFuncGetAttributes(&attr, gpu_compute_table_forces_kernel<0>);
-            max_block_size = attr.maxThreadsPerBlock;
-            }
-
-        unsigned int run_block_size = min(block_size, max_block_size);
-
-        // index calculation helper
-        Index2DUpperTriangular table_index(ntypes);
-
-        // setup the grid to run the kernel
-        dim3 grid( N / run_block_size + 1, 1, 1);
-        dim3 threads(run_block_size, 1, 1);
-
-        gpu_compute_table_forces_kernel<0><<< grid, threads, sizeof(Scalar4)*table_index.getNumElements() >>>(d_force,
-                                                                                                           d_virial,
-                                                                                                           virial_pitch,
-                                                                                                           N,
-                                                                                                           d_pos,
-                                                                                                           box,
-                                                                                                           d_n_neigh,
-                                                                                                           d_nlist,
-                                                                                                           d_head_list,
-                                                                                                           d_tables,
-                                                                                                           d_params,
-                                                                                                           ntypes,
-                                                                                                           table_width);
+        gpu_select_table_forces_kernel<0>(args, block_size, cubic);
         }
 
     return cudaSuccess;
@@ -15,24 +15,32 @@
 #ifndef __TABLEPOTENTIALGPU_CUH__
 #define __TABLEPOTENTIALGPU_CUH__
 
+//! Arguments of the table pair force kernel
+struct table_kernel_args_t
+    {
+    Scalar4 *d_force;                   //!< Force to write out
+    Scalar *d_virial;                   //!< Virial to write out
+    unsigned int virial_pitch;          //!< Pitch of the 2D virial array
+    unsigned int N;                     //!< Number of particles
+    unsigned int n_ghost;               //!< Number of ghost particles
+    const Scalar4 *d_pos;               //!< Particle positions
+    BoxDim box;                         //!< Simulation box
+    const unsigned int *d_n_neigh;      //!< Number of neighbors of each particle
+    const unsigned int *d_nlist;        //!< Neighbor list
+    const unsigned int *d_head_list;    //!< Head list indexes for accessing d_nlist
+    const Scalar2 *d_tables;            //!< Tables of the potential and force
+    const Scalar4 *d_coeffs;            //!< Cubic Hermite coefficients of the table intervals
+    const Scalar4 *d_params;            //!< Parameters of each table
+    unsigned int ntypes;                //!< Number of particle types
+    unsigned int table_width;           //!< Number of points in each table
+    };
+
 //! Kernel driver that computes table forces on the GPU for TablePotentialGPU
-cudaError_t gpu_compute_table_forces(Scalar4* d_force,
-                                     Scalar* d_virial,
-                                     const unsigned int virial_pitch,
-                                     const unsigned int N,
-                                     const unsigned int n_ghost,
-                                     const Scalar4 *d_pos,
-                                     const BoxDim& box,
-                                     const unsigned int *d_n_neigh,
-                                     const unsigned int *d_nlist,
-                                     const unsigned int *d_head_list,
-                                     const Scalar2 *d_tables,
-                                     const Scalar4 *d_params,
+cudaError_t gpu_compute_table_forces(const table_kernel_args_t& args,
                                      const unsigned int size_nlist,
-                                     const unsigned int ntypes,
-                                     const unsigned int table_width,
                                      const unsigned int block_size,
                                      const unsigned int compute_capability,
-                                     const unsigned int max_tex1d_width);
+                                     const unsigned int max_tex1d_width,
+                                     const bool cubic);
 
 #endif
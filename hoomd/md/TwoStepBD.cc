@@ -9,7 +9,7 @@
 #include "QuaternionMath.h"
 #include "hoomd/HOOMDMath.h"
 
-#include "hoomd/Saru.h"
+#include "hoomd/Philox.h"
 using namespace hoomd;
 
 
@@ -99,12 +99,14 @@ void TwoStepBD::integrateStepOne(unsigned int timestep)
         unsigned int ptag = h_tag.data[j];
 
         // Initialize the RNG
-        detail::Saru saru(ptag, timestep, m_seed);
+        detail::Philox4x32 rng(ptag, timestep, m_seed);
 
         // compute the random force
-        Scalar rx = saru.s<Scalar>(-1,1);
-        Scalar ry = saru.s<Scalar>(-1,1);
-        Scalar rz = saru.s<Scalar>(-1,1);
+        Scalar r[4];
+        rng.uniform4(Scalar(-1), Scalar(1), r);
+        Scalar rx = r[0];
+        Scalar ry = r[1];
+        Scalar rz = r[2];
 
         Scalar gamma;
         if (m_use_lambda)
@@ -138,10 +140,12 @@ void TwoStepBD::integrateStepOne(unsigned int timestep)
         // draw a new random velocity for particle j
         Scalar mass =  h_vel.data[j].w;
         Scalar sigma = fast::sqrt(currentTemp/mass);
-        h_vel.data[j].x = gaussian_rng(saru, sigma);
-        h_vel.data[j].y = gaussian_rng(saru, sigma);
+        Scalar n[4];
+        rng.normal4(sigma, n);
+        h_vel.data[j].x = n[0];
+        h_vel.data[j].y = n[1];
         if (D > 2)
-            h_vel.data[j].z = gaussian_rng(saru, sigma);
+            h_vel.data[j].z = n[2];
         else
             h_vel.data[j].z = 0;
 
@@ -169,9 +173,11 @@ void TwoStepBD::integrateStepOne(unsigned int timestep)
                 // original Gaussian random torque
                 // Gaussian random distribution is preferred in terms of preserving the exact math
                 vec3<Scalar> bf_torque;
-                bf_torque.x = gaussian_rng(saru, sigma_r.x);
-                bf_torque.y = gaussian_rng(saru, sigma_r.y);
-                bf_torque.z = gaussian_rng(saru, sigma_r.z);
+                Scalar n_r[4];
+                rng.normal4(Scalar(1.0), n_r);
+                bf_torque.x = n_r[0]*sigma_r.x;
+                bf_torque.y = n_r[1]*sigma_r.y;
+                bf_torque.z = n_r[2]*sigma_r.z;
 
                 if (x_zero) bf_torque.x = 0;
                 if (y_zero) bf_torque.y = 0;
@@ -196,9 +202,10 @@ void TwoStepBD::integrateStepOne(unsigned int timestep)
                 h_orientation.data[j] = quat_to_scalar4(q);
 
                 // draw a new random ang_mom for particle j in body frame
-                p_vec.x = gaussian_rng(saru, fast::sqrt(currentTemp * I.x));
-                p_vec.y = gaussian_rng(saru, fast::sqrt(currentTemp * I.y));
-                p_vec.z = gaussian_rng(saru, fast::sqrt(currentTemp * I.z));
+                rng.normal4(Scalar(1.0), n_r);
+                p_vec.x = n_r[0]*fast::sqrt(currentTemp * I.x);
+                p_vec.y = n_r[1]*fast::sqrt(currentTemp * I.y);
+                p_vec.z = n_r[2]*fast::sqrt(currentTemp * I.z);
                 if (x_zero) p_vec.x = 0;
                 if (y_zero) p_vec.y = 0;
                 if (z_zero) p_vec.z = 0;
@@ -8,7 +8,7 @@
 #include "hoomd/VectorMath.h"
 #include "hoomd/HOOMDMath.h"
 
-#include "hoomd/Saru.h"
+#include "hoomd/Philox.h"
 using namespace hoomd;
 
 #include <assert.h>
@@ -54,7 +54,7 @@ extern __shared__ Scalar3 s_gammas_r[];
 
     This kernel is implemented in a very similar manner to gpu_nve_step_one_kernel(), see it for design details.
 
-    Random number generation is done per thread with Saru's 3-seed constructor. The seeds are, the time step,
+    Random number generation is done per thread with a Philox4x32 generator. The seeds are, the time step,
     the particle tag, and the user-defined seed.
 
     This kernel must be launched with enough dynamic shared memory per block to read in d_gamma
@@ -126,10 +126,12 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
         unsigned int ptag = d_tag[idx];
 
         // compute the random force
-        detail::Saru saru(ptag, timestep, seed);
-        Scalar rx = saru.s<Scalar>(-1,1);
-        Scalar ry = saru.s<Scalar>(-1,1);
-        Scalar rz =  saru.s<Scalar>(-1,1);
+        detail::Philox4x32 rng(ptag, timestep, seed);
+        Scalar r[4];
+        rng.uniform4(Scalar(-1), Scalar(1), r);
+        Scalar rx = r[0];
+        Scalar ry = r[1];
+        Scalar rz = r[2];
 
         // calculate the magnitude of the random force
         Scalar gamma;
@@ -168,10 +170,12 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
         // draw a new random velocity for particle j
         Scalar mass = vel.w;
         Scalar sigma = fast::sqrt(T/mass);
-        vel.x = gaussian_rng(saru, sigma);
-        vel.y = gaussian_rng(saru, sigma);
+        Scalar n[4];
+        rng.normal4(sigma, n);
+        vel.x = n[0];
+        vel.y = n[1];
         if (D > 2)
-            vel.z = gaussian_rng(saru, sigma);
+            vel.z = n[2];
         else
             vel.z = 0;
 
@@ -207,9 +211,11 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
                 // original Gaussian random torque
                 // Gaussian random distribution is preferred in terms of preserving the exact math
                 vec3<Scalar> bf_torque;
-                bf_torque.x = gaussian_rng(saru, sigma_r.x);
-                bf_torque.y = gaussian_rng(saru, sigma_r.y);
-                bf_torque.z = gaussian_rng(saru, sigma_r.z);
+                Scalar n_r[4];
+                rng.normal4(Scalar(1.0), n_r);
+                bf_torque.x = n_r[0]*sigma_r.x;
+                bf_torque.y = n_r[1]*sigma_r.y;
+                bf_torque.z = n_r[2]*sigma_r.z;
 
                 if (x_zero) bf_torque.x = 0;
                 if (y_zero) bf_torque.y = 0;
@@ -232,9 +238,10 @@ void gpu_brownian_step_one_kernel(Scalar4 *d_pos,
                 d_orientation[idx] = quat_to_scalar4(q);
 
                 // draw a new random ang_mom for particle j in body frame
-                p_vec.x = gaussian_rng(saru, fast::sqrt(T * I.x));
-                p_vec.y = gaussian_rng(saru, fast::sqrt(T * I.y));
-                p_vec.z = gaussian_rng(saru, fast::sqrt(T * I.z));
+                rng.normal4(Scalar(1.0), n_r);
+                p_vec.x = n_r[0]*fast::sqrt(T * I.x);
+                p_vec.y = n_r[1]*fast::sqrt(T * I.y);
+                p_vec.z = n_r[2]*fast::sqrt(T * I.z);
                 if (x_zero) p_vec.x = 0;
                 if (y_zero) p_vec.y = 0;
                 if (z_zero) p_vec.z = 0;
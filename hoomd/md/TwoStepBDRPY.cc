@@ -0,0 +1,870 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "TwoStepBDRPY.h"
+#include "EvaluatorRPYEwald.h"
+#include "hoomd/HOOMDMath.h"
+
+#include "hoomd/Philox.h"
+using namespace hoomd;
+
+#include <string.h>
+#include <climits>
+
+namespace py = pybind11;
+using namespace std;
+
+/*! \file TwoStepBDRPY.cc
+    \brief Contains code for the TwoStepBDRPY class
+*/
+
+//! Maximum order of the B-spline assignment
+#define BD_RPY_MAX_ORDER 7
+
+/*! \param t Offset from the first knot, in [0,1)
+    \param order Order of the B-spline
+    \param w (output) Values of the cardinal B-spline M_order(t+j), j=0..order-1
+*/
+static void bd_rpy_bspline(Scalar t, unsigned int order, Scalar *w)
+    {
+    // recursion M_n(x) = (x M_{n-1}(x) + (n-x) M_{n-1}(x-1))/(n-1), starting from the box function
+    w[0] = Scalar(1.0);
+    for (unsigned int n = 2; n <= order; n++)
+        {
+        w[n-1] = Scalar(0.0);
+        for (int j = n-1; j >= 0; j--)
+            {
+            Scalar prev = (j > 0) ? w[j-1] : Scalar(0.0);
+            w[j] = ((t+j)*w[j] + (n-t-j)*prev)/Scalar(n-1);
+            }
+        }
+    }
+
+/*! \param alpha Diagonal of the Lanczos tridiagonal matrix
+    \param beta Off diagonal of the Lanczos tridiagonal matrix
+    \param m Size of the tridiagonal matrix
+    \param c (output) First column of the square root of the tridiagonal matrix
+
+    The (small) tridiagonal matrix is diagonalized with cyclic Jacobi rotations. Eigenvalues that are negative
+    because of round off are set to zero.
+*/
+static void bd_rpy_sqrt_tridiagonal(const std::vector<Scalar>& alpha, const std::vector<Scalar>& beta, unsigned int m,
+    std::vector<double>& c)
+    {
+    std::vector<double> A(m*m, 0.0);
+    std::vector<double> Q(m*m, 0.0);
+    for (unsigned int i = 0; i < m; i++)
+        {
+        A[i*m+i] = alpha[i];
+        if (i+1 < m)
+            A[i*m+i+1] = A[(i+1)*m+i] = beta[i];
+        Q[i*m+i] = 1.0;
+        }
+
+    for (unsigned int sweep = 0; sweep < 50; sweep++)
+        {
+        double off = 0.0;
+        double diag = 0.0;
+        for (unsigned int p = 0; p < m; p++)
+            {
+            diag += A[p*m+p]*A[p*m+p];
+            for (unsigned int q = p+1; q < m; q++)
+                off += A[p*m+q]*A[p*m+q];
+            }
+        if (off <= 1e-30*diag)
+            break;
+
+        for (unsigned int p = 0; p < m; p++)
+            for (unsigned int q = p+1; q < m; q++)
+                {
+                double apq = A[p*m+q];
+                if (apq == 0.0)
+                    continue;
+
+                // rotation that zeroes A_pq
+                double theta = (A[q*m+q] - A[p*m+p])/(2.0*apq);
+                double t = (theta >= 0.0 ? 1.0 : -1.0)/(fabs(theta) + sqrt(theta*theta + 1.0));
+                double cs = 1.0/sqrt(t*t + 1.0);
+                double sn = t*cs;
+
+                for (unsigned int k = 0; k < m; k++)
+                    {
+                    double akp = A[k*m+p];
+                    double akq = A[k*m+q];
+                    A[k*m+p] = cs*akp - sn*akq;
+                    A[k*m+q] = sn*akp + cs*akq;
+                    }
+                for (unsigned int k = 0; k < m; k++)
+                    {
+                    double apk = A[p*m+k];
+                    double aqk = A[q*m+k];
+                    A[p*m+k] = cs*apk - sn*aqk;
+                    A[q*m+k] = sn*apk + cs*aqk;
+                    }
+                for (unsigned int k = 0; k < m; k++)
+                    {
+                    double qkp = Q[k*m+p];
+                    double qkq = Q[k*m+q];
+                    Q[k*m+p] = cs*qkp - sn*qkq;
+                    Q[k*m+q] = sn*qkp + cs*qkq;
+                    }
+                }
+        }
+
+    // c = Q sqrt(Lambda) Q^T e_0
+    c.assign(m, 0.0);
+    for (unsigned int k = 0; k < m; k++)
+        {
+        double lambda = A[k*m+k];
+        double s = (lambda > 0.0 ? sqrt(lambda) : 0.0)*Q[k];
+        for (unsigned int i = 0; i < m; i++)
+            c[i] += Q[i*m+k]*s;
+        }
+    }
+
+/*! \param sysdef SystemDefinition this method will act on. Must not be NULL.
+    \param group The group of particles this integration method is to work on
+    \param T Temperature set point as a function of time
+    \param seed Random seed to use in generating random numbers
+    \param eta Viscosity of the fluid
+    \param a Radius of the particles
+*/
+TwoStepBDRPY::TwoStepBDRPY(std::shared_ptr<SystemDefinition> sysdef,
+                           std::shared_ptr<ParticleGroup> group,
+                           std::shared_ptr<Variant> T,
+                           unsigned int seed,
+                           Scalar eta,
+                           Scalar a)
+    : IntegrationMethodTwoStep(sysdef, group), m_T(T), m_seed(seed), m_eta(eta), m_a(a),
+      m_xi(0.0), m_r_cut(0.0), m_mesh_points(make_uint3(0,0,0)), m_order(0), m_params_set(false),
+      m_lanczos_tol(1e-4), m_lanczos_max_iter(100), m_n_lanczos(0),
+      m_kiss_fft_initialized(false), m_box_changed(true)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing TwoStepBDRPY" << endl;
+
+    if (m_sysdef->getNDimensions() != 3)
+        {
+        m_exec_conf->msg->error() << "integrate.brownian_rpy: System must be 3 dimensional" << endl;
+        throw std::runtime_error("Error initializing TwoStepBDRPY");
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_pdata->getDomainDecomposition())
+        {
+        m_exec_conf->msg->error() << "integrate.brownian_rpy: Domain decomposition is not supported" << endl;
+        throw std::runtime_error("Error initializing TwoStepBDRPY");
+        }
+    #endif
+
+    setFluid(eta, a);
+
+    // Hash the User's Seed to make it less likely to be a low positive integer
+    m_seed = m_seed*0x12345677 + 0x12345 ; m_seed^=(m_seed>>16); m_seed*= 0x45679;
+
+    m_cl = std::shared_ptr<CellList>(new CellList(sysdef));
+    m_cl->setRadius(1);
+    m_cl->setComputeTDB(false);
+    m_cl->setFlagIndex();
+
+    m_pdata->getBoxChangeSignal().connect<TwoStepBDRPY, &TwoStepBDRPY::setBoxChange>(this);
+    }
+
+TwoStepBDRPY::~TwoStepBDRPY()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying TwoStepBDRPY" << endl;
+
+    m_pdata->getBoxChangeSignal().disconnect<TwoStepBDRPY, &TwoStepBDRPY::setBoxChange>(this);
+
+    if (m_kiss_fft_initialized)
+        {
+        free(m_kiss_fft);
+        free(m_kiss_ifft);
+        kiss_fft_cleanup();
+        }
+    }
+
+/*! \param eta Viscosity of the fluid
+    \param a Radius of the particles
+*/
+void TwoStepBDRPY::setFluid(Scalar eta, Scalar a)
+    {
+    if (eta <= Scalar(0.0) || a <= Scalar(0.0))
+        {
+        m_exec_conf->msg->error() << "integrate.brownian_rpy: Viscosity and radius must be positive" << endl;
+        throw std::runtime_error("Error setting parameters of TwoStepBDRPY");
+        }
+
+    m_eta = eta;
+    m_a = a;
+
+    // the influence function depends on the radius
+    m_box_changed = true;
+    }
+
+/*! \param xi Ewald splitting parameter
+    \param r_cut Cutoff of the real space part
+    \param nx Number of mesh points along the first lattice vector
+    \param ny Number of mesh points along the second lattice vector
+    \param nz Number of mesh points along the third lattice vector
+    \param order Order of the B-spline assignment
+*/
+void TwoStepBDRPY::setParams(Scalar xi, Scalar r_cut, unsigned int nx, unsigned int ny, unsigned int nz,
+    unsigned int order)
+    {
+    if (order < 1 || order > BD_RPY_MAX_ORDER)
+        {
+        m_exec_conf->msg->error() << "integrate.brownian_rpy: Interpolation order has to be between 1 and "
+                                  << BD_RPY_MAX_ORDER << endl;
+        throw std::runtime_error("Error setting parameters of TwoStepBDRPY");
+        }
+
+    if (xi <= Scalar(0.0) || r_cut <= Scalar(0.0) || nx == 0 || ny == 0 || nz == 0)
+        {
+        m_exec_conf->msg->error() << "integrate.brownian_rpy: Invalid splitting parameter, cutoff or mesh" << endl;
+        throw std::runtime_error("Error setting parameters of TwoStepBDRPY");
+        }
+
+    m_xi = xi;
+    m_r_cut = r_cut;
+    m_order = order;
+    m_cl->setNominalWidth(r_cut);
+
+    if (m_kiss_fft_initialized && (nx != m_mesh_points.x || ny != m_mesh_points.y || nz != m_mesh_points.z))
+        {
+        free(m_kiss_fft);
+        free(m_kiss_ifft);
+        m_kiss_fft_initialized = false;
+        }
+    m_mesh_points = make_uint3(nx, ny, nz);
+
+    m_box_changed = true;
+    m_params_set = true;
+    }
+
+/*! \param tol Relative change of the Brownian displacements between two iterations at which the iteration stops
+    \param max_iter Maximum number of iterations
+*/
+void TwoStepBDRPY::setLanczosParams(Scalar tol, unsigned int max_iter)
+    {
+    if (tol <= Scalar(0.0) || max_iter == 0)
+        {
+        m_exec_conf->msg->error() << "integrate.brownian_rpy: Invalid Lanczos tolerance or number of iterations"
+                                  << endl;
+        throw std::runtime_error("Error setting parameters of TwoStepBDRPY");
+        }
+
+    m_lanczos_tol = tol;
+    m_lanczos_max_iter = max_iter;
+    }
+
+/*! \returns a list of the quantities this method logs
+*/
+std::vector< std::string > TwoStepBDRPY::getProvidedLogQuantities()
+    {
+    vector<string> result;
+    result.push_back("brownian_rpy_lanczos_iterations");
+    return result;
+    }
+
+/*! \param quantity Name of the log quantity to get
+    \param timestep Current time step of the simulation
+    \param my_quantity_flag passed as false, changed to true if quantity logged here
+*/
+Scalar TwoStepBDRPY::getLogValue(const std::string& quantity, unsigned int timestep, bool &my_quantity_flag)
+    {
+    if (quantity == "brownian_rpy_lanczos_iterations")
+        {
+        my_quantity_flag = true;
+        return Scalar(m_n_lanczos);
+        }
+    else
+        return Scalar(0);
+    }
+
+void TwoStepBDRPY::initializeFFT()
+    {
+    int dims[3];
+    dims[0] = m_mesh_points.z;
+    dims[1] = m_mesh_points.y;
+    dims[2] = m_mesh_points.x;
+
+    m_kiss_fft = kiss_fftnd_alloc(dims, 3, 0, NULL, NULL);
+    m_kiss_ifft = kiss_fftnd_alloc(dims, 3, 1, NULL, NULL);
+    m_kiss_fft_initialized = true;
+
+    unsigned int n_cells = m_mesh_points.x*m_mesh_points.y*m_mesh_points.z;
+
+    // one mesh per Cartesian component
+    GPUArray<kiss_fft_cpx> mesh(3*n_cells, m_exec_conf);
+    m_mesh.swap(mesh);
+
+    GPUArray<kiss_fft_cpx> fourier_mesh(3*n_cells, m_exec_conf);
+    m_fourier_mesh.swap(fourier_mesh);
+
+    GPUArray<Scalar> inf_f(n_cells, m_exec_conf);
+    m_inf_f.swap(inf_f);
+
+    GPUArray<Scalar3> k(n_cells, m_exec_conf);
+    m_k.swap(k);
+
+    m_box_changed = true;
+    }
+
+/*! The wave space mobility of every mesh wave vector is divided by the square of the Fourier transform of the
+    B-spline assignment, which spreading and interpolation apply once each.
+*/
+void TwoStepBDRPY::computeInfluenceFunction()
+    {
+    ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::overwrite);
+    ArrayHandle<Scalar3> h_k(m_k, access_location::host, access_mode::overwrite);
+
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+
+    // compute reciprocal lattice vectors
+    Scalar3 a1 = global_box.getLatticeVector(0);
+    Scalar3 a2 = global_box.getLatticeVector(1);
+    Scalar3 a3 = global_box.getLatticeVector(2);
+
+    Scalar V_box = global_box.getVolume();
+    Scalar3 b1 = Scalar(2.0*M_PI)*make_scalar3(a2.y*a3.z-a2.z*a3.y, a2.z*a3.x-a2.x*a3.z, a2.x*a3.y-a2.y*a3.x)/V_box;
+    Scalar3 b2 = Scalar(2.0*M_PI)*make_scalar3(a3.y*a1.z-a3.z*a1.y, a3.z*a1.x-a3.x*a1.z, a3.x*a1.y-a3.y*a1.x)/V_box;
+    Scalar3 b3 = Scalar(2.0*M_PI)*make_scalar3(a1.y*a2.z-a1.z*a2.y, a1.z*a2.x-a1.x*a2.z, a1.x*a2.y-a1.y*a2.x)/V_box;
+
+    EvaluatorRPYEwald eval(m_a, m_xi);
+
+    unsigned int n_cells = m_mesh_points.x*m_mesh_points.y*m_mesh_points.z;
+    for (unsigned int cell_idx = 0; cell_idx < n_cells; ++cell_idx)
+        {
+        // kiss FFT expects data in row major format
+        int3 n;
+        n.z = cell_idx / (m_mesh_points.y * m_mesh_points.x);
+        n.y = (cell_idx - n.z * m_mesh_points.x * m_mesh_points.y)/ m_mesh_points.x;
+        n.x = cell_idx % m_mesh_points.x;
+
+        // compute Miller indices
+        if (n.x >= (int)(m_mesh_points.x/2 + m_mesh_points.x%2))
+            n.x -= (int) m_mesh_points.x;
+        if (n.y >= (int)(m_mesh_points.y/2 + m_mesh_points.y%2))
+            n.y -= (int) m_mesh_points.y;
+        if (n.z >= (int)(m_mesh_points.z/2 + m_mesh_points.z%2))
+            n.z -= (int) m_mesh_points.z;
+
+        Scalar3 k = (Scalar)n.x*b1+(Scalar)n.y*b2+(Scalar)n.z*b3;
+        Scalar ksq = dot(k,k);
+        h_k.data[cell_idx] = k;
+
+        if (n.x == 0 && n.y == 0 && n.z == 0)
+            {
+            // the mean flow vanishes
+            h_inf_f.data[cell_idx] = Scalar(0.0);
+            continue;
+            }
+
+        // Fourier transform of the assignment function
+        Scalar W(1.0);
+        int ni[3] = {n.x, n.y, n.z};
+        unsigned int dim[3] = {m_mesh_points.x, m_mesh_points.y, m_mesh_points.z};
+        for (unsigned int d = 0; d < 3; d++)
+            {
+            if (ni[d] == 0)
+                continue;
+            Scalar arg = Scalar(M_PI)*(Scalar)ni[d]/(Scalar)dim[d];
+            W *= pow(fast::sin(arg)/arg, (Scalar)m_order);
+            }
+
+        h_inf_f.data[cell_idx] = eval.evalWaveSpace(ksq, V_box)/(W*W);
+        }
+    }
+
+/*! \param timestep Current time step
+
+    The real space pairs and the mesh assignment of all members are computed once per time step, they are reused by
+    every product with the mobility.
+*/
+void TwoStepBDRPY::setupMobility(unsigned int timestep)
+    {
+    unsigned int group_size = m_group->getNumMembers();
+    const BoxDim& box = m_pdata->getBox();
+
+    // map particle indices to group indices
+    m_group_slot.assign(m_pdata->getN(), UINT_MAX);
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        m_group_slot[m_group->getMemberIndex(group_idx)] = group_idx;
+
+    m_cl->compute(timestep);
+
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_size(m_cl->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_cell_xyzf(m_cl->getXYZFArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_adj(m_cl->getCellAdjArray(), access_location::host, access_mode::read);
+
+    const Index3D& ci = m_cl->getCellIndexer();
+    const Index2D& cli = m_cl->getCellListIndexer();
+    const Index2D& cadji = m_cl->getCellAdjIndexer();
+    uint3 dim = m_cl->getDim();
+    Scalar3 ghost_width = m_cl->getGhostWidth();
+
+    EvaluatorRPYEwald eval(m_a, m_xi);
+    Scalar r_cut_sq = m_r_cut*m_r_cut;
+
+    m_pair_i.clear();
+    m_pair_j.clear();
+    m_pair_mobility.clear();
+
+    m_first_point.resize(group_size);
+    m_weights.resize(3*m_order*group_size);
+
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int i = m_group->getMemberIndex(group_idx);
+        Scalar3 my_pos = make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z);
+
+        // find the bin the particle belongs in
+        Scalar3 f = box.makeFraction(my_pos,ghost_width);
+        int ib = (unsigned int)(f.x * dim.x);
+        int jb = (unsigned int)(f.y * dim.y);
+        int kb = (unsigned int)(f.z * dim.z);
+
+        // need to handle the case where the particle is exactly at the box hi
+        if (ib == (int)dim.x)
+            ib = 0;
+        if (jb == (int)dim.y)
+            jb = 0;
+        if (kb == (int)dim.z)
+            kb = 0;
+
+        unsigned int my_cell = ci(ib,jb,kb);
+
+        // loop through all neighboring bins, every pair is stored once
+        for (unsigned int cur_adj = 0; cur_adj < cadji.getW(); cur_adj++)
+            {
+            unsigned int neigh_cell = h_cell_adj.data[cadji(cur_adj, my_cell)];
+
+            unsigned int size = h_cell_size.data[neigh_cell];
+            for (unsigned int cur_offset = 0; cur_offset < size; cur_offset++)
+                {
+                Scalar4& cur_xyzf = h_cell_xyzf.data[cli(cur_offset, neigh_cell)];
+                unsigned int j = __scalar_as_int(cur_xyzf.w);
+                unsigned int j_slot = m_group_slot[j];
+                if (j_slot == UINT_MAX || j_slot <= group_idx)
+                    continue;
+
+                Scalar3 dx = my_pos - make_scalar3(cur_xyzf.x, cur_xyzf.y, cur_xyzf.z);
+                dx = box.minImage(dx);
+                Scalar rsq = dot(dx,dx);
+                if (rsq >= r_cut_sq)
+                    continue;
+
+                Scalar r = fast::sqrt(rsq);
+                Scalar F, G;
+                eval.evalRealSpace(r, F, G);
+                G /= rsq;
+
+                m_pair_i.push_back(group_idx);
+                m_pair_j.push_back(j_slot);
+                m_pair_mobility.push_back(F + G*dx.x*dx.x);
+                m_pair_mobility.push_back(G*dx.x*dx.y);
+                m_pair_mobility.push_back(G*dx.x*dx.z);
+                m_pair_mobility.push_back(F + G*dx.y*dx.y);
+                m_pair_mobility.push_back(G*dx.y*dx.z);
+                m_pair_mobility.push_back(F + G*dx.z*dx.z);
+                }
+            }
+
+        // B-spline weights of the mesh assignment, centered on the particle
+        Scalar3 frac = box.makeFraction(my_pos);
+        Scalar u[3] = {frac.x*(Scalar)m_mesh_points.x, frac.y*(Scalar)m_mesh_points.y, frac.z*(Scalar)m_mesh_points.z};
+        int first[3];
+        for (unsigned int d = 0; d < 3; d++)
+            {
+            Scalar s = u[d] - Scalar(0.5)*(Scalar)m_order;
+            Scalar s_floor = floor(s);
+            first[d] = (int)s_floor + 1;
+
+            Scalar w[BD_RPY_MAX_ORDER];
+            bd_rpy_bspline(s - s_floor, m_order, w);
+            for (unsigned int l = 0; l < m_order; l++)
+                m_weights[(3*group_idx + d)*m_order + l] = w[m_order-1-l];
+            }
+        m_first_point[group_idx] = make_int3(first[0], first[1], first[2]);
+        }
+    }
+
+/*! \param f Vector over the group members (3 components per member)
+    \param u (output) Product of the mobility with \a f, in units of the single particle mobility
+*/
+void TwoStepBDRPY::applyMobility(const Scalar *f, std::vector<Scalar>& u)
+    {
+    unsigned int group_size = m_group->getNumMembers();
+    EvaluatorRPYEwald eval(m_a, m_xi);
+
+    // self part
+    Scalar self = eval.evalSelf();
+    u.resize(3*group_size);
+    for (unsigned int i = 0; i < 3*group_size; i++)
+        u[i] = self*f[i];
+
+    // real space part
+    for (unsigned int p = 0; p < m_pair_i.size(); p++)
+        {
+        unsigned int i = m_pair_i[p];
+        unsigned int j = m_pair_j[p];
+        const Scalar *M = &m_pair_mobility[6*p];
+
+        u[3*i]   += M[0]*f[3*j] + M[1]*f[3*j+1] + M[2]*f[3*j+2];
+        u[3*i+1] += M[1]*f[3*j] + M[3]*f[3*j+1] + M[4]*f[3*j+2];
+        u[3*i+2] += M[2]*f[3*j] + M[4]*f[3*j+1] + M[5]*f[3*j+2];
+
+        u[3*j]   += M[0]*f[3*i] + M[1]*f[3*i+1] + M[2]*f[3*i+2];
+        u[3*j+1] += M[1]*f[3*i] + M[3]*f[3*i+1] + M[4]*f[3*i+2];
+        u[3*j+2] += M[2]*f[3*i] + M[4]*f[3*i+1] + M[5]*f[3*i+2];
+        }
+
+    // wave space part
+    unsigned int n_cells = m_mesh_points.x*m_mesh_points.y*m_mesh_points.z;
+    int nx = m_mesh_points.x;
+    int ny = m_mesh_points.y;
+    int nz = m_mesh_points.z;
+
+    ArrayHandle<kiss_fft_cpx> h_mesh(m_mesh, access_location::host, access_mode::readwrite);
+    ArrayHandle<kiss_fft_cpx> h_fourier_mesh(m_fourier_mesh, access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar> h_inf_f(m_inf_f, access_location::host, access_mode::read);
+    ArrayHandle<Scalar3> h_k(m_k, access_location::host, access_mode::read);
+
+    memset(h_mesh.data, 0, sizeof(kiss_fft_cpx)*3*n_cells);
+
+    // spread the vector to the mesh
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        int3 first = m_first_point[group_idx];
+        const Scalar *wx = &m_weights[(3*group_idx)*m_order];
+        const Scalar *wy = &m_weights[(3*group_idx + 1)*m_order];
+        const Scalar *wz = &m_weights[(3*group_idx + 2)*m_order];
+
+        for (unsigned int lz = 0; lz < m_order; lz++)
+            {
+            int mz = (first.z + (int)lz) % nz;
+            if (mz < 0)
+                mz += nz;
+            for (unsigned int ly = 0; ly < m_order; ly++)
+                {
+                int my = (first.y + (int)ly) % ny;
+                if (my < 0)
+                    my += ny;
+                for (unsigned int lx = 0; lx < m_order; lx++)
+                    {
+                    int mx = (first.x + (int)lx) % nx;
+                    if (mx < 0)
+                        mx += nx;
+
+                    Scalar W = wx[lx]*wy[ly]*wz[lz];
+                    unsigned int cell_idx = mx + nx*(my + ny*mz);
+                    for (unsigned int c = 0; c < 3; c++)
+                        h_mesh.data[c*n_cells + cell_idx].r += W*f[3*group_idx + c];
+                    }
+                }
+            }
+        }
+
+    for (unsigned int c = 0; c < 3; c++)
+        kiss_fftnd(m_kiss_fft, h_mesh.data + c*n_cells, h_fourier_mesh.data + c*n_cells);
+
+    // multiply with the influence function and project onto the plane perpendicular to k
+    for (unsigned int cell_idx = 0; cell_idx < n_cells; cell_idx++)
+        {
+        Scalar3 k = h_k.data[cell_idx];
+        Scalar g = h_inf_f.data[cell_idx];
+        Scalar ksq = dot(k,k);
+
+        kiss_fft_cpx& fx = h_fourier_mesh.data[cell_idx];
+        kiss_fft_cpx& fy = h_fourier_mesh.data[n_cells + cell_idx];
+        kiss_fft_cpx& fz = h_fourier_mesh.data[2*n_cells + cell_idx];
+
+        if (g == Scalar(0.0))
+            {
+            fx.r = fx.i = fy.r = fy.i = fz.r = fz.i = 0;
+            continue;
+            }
+
+        Scalar k_dot_f_r = (k.x*fx.r + k.y*fy.r + k.z*fz.r)/ksq;
+        Scalar k_dot_f_i = (k.x*fx.i + k.y*fy.i + k.z*fz.i)/ksq;
+
+        fx.r = g*(fx.r - k.x*k_dot_f_r); fx.i = g*(fx.i - k.x*k_dot_f_i);
+        fy.r = g*(fy.r - k.y*k_dot_f_r); fy.i = g*(fy.i - k.y*k_dot_f_i);
+        fz.r = g*(fz.r - k.z*k_dot_f_r); fz.i = g*(fz.i - k.z*k_dot_f_i);
+        }
+
+    for (unsigned int c = 0; c < 3; c++)
+        kiss_fftnd(m_kiss_ifft, h_fourier_mesh.data + c*n_cells, h_mesh.data + c*n_cells);
+
+    // interpolate back with the same weights
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        int3 first = m_first_point[group_idx];
+        const Scalar *wx = &m_weights[(3*group_idx)*m_order];
+        const Scalar *wy = &m_weights[(3*group_idx + 1)*m_order];
+        const Scalar *wz = &m_weights[(3*group_idx + 2)*m_order];
+
+        Scalar3 v = make_scalar3(0.0, 0.0, 0.0);
+        for (unsigned int lz = 0; lz < m_order; lz++)
+            {
+            int mz = (first.z + (int)lz) % nz;
+            if (mz < 0)
+                mz += nz;
+            for (unsigned int ly = 0; ly < m_order; ly++)
+                {
+                int my = (first.y + (int)ly) % ny;
+                if (my < 0)
+                    my += ny;
+                for (unsigned int lx = 0; lx < m_order; lx++)
+                    {
+                    int mx = (first.x + (int)lx) % nx;
+                    if (mx < 0)
+                        mx += nx;
+
+                    Scalar W = wx[lx]*wy[ly]*wz[lz];
+                    unsigned int cell_idx = mx + nx*(my + ny*mz);
+                    v.x += W*h_mesh.data[cell_idx].r;
+                    v.y += W*h_mesh.data[n_cells + cell_idx].r;
+                    v.z += W*h_mesh.data[2*n_cells + cell_idx].r;
+                    }
+                }
+            }
+
+        u[3*group_idx] += v.x;
+        u[3*group_idx+1] += v.y;
+        u[3*group_idx+2] += v.z;
+        }
+    }
+
+/*! \param z Vector over the group members (3 components per member)
+    \param y (output) Approximation of the square root of the mobility (in units of the single particle mobility)
+             applied to \a z
+
+    The Krylov space of the mobility and \a z is built with the Lanczos recursion. The square root of the projected
+    tridiagonal matrix approximates the square root of the mobility in that space.
+*/
+void TwoStepBDRPY::applySqrtMobility(const std::vector<Scalar>& z, std::vector<Scalar>& y)
+    {
+    unsigned int n = z.size();
+    y.assign(n, Scalar(0.0));
+
+    double z_norm = 0.0;
+    for (unsigned int i = 0; i < n; i++)
+        z_norm += z[i]*z[i];
+    z_norm = sqrt(z_norm);
+
+    m_n_lanczos = 0;
+    if (z_norm == 0.0)
+        return;
+
+    m_lanczos_basis.resize((m_lanczos_max_iter+1)*n);
+    for (unsigned int i = 0; i < n; i++)
+        m_lanczos_basis[i] = Scalar(z[i]/z_norm);
+
+    std::vector<Scalar> alpha, beta;
+    std::vector<double> c, c_prev;
+    bool converged = false;
+    unsigned int m = 0;
+
+    for (unsigned int j = 0; j < m_lanczos_max_iter; j++)
+        {
+        const Scalar *v = &m_lanczos_basis[j*n];
+        applyMobility(v, m_vec_tmp);
+
+        if (j > 0)
+            {
+            const Scalar *v_prev = &m_lanczos_basis[(j-1)*n];
+            for (unsigned int i = 0; i < n; i++)
+                m_vec_tmp[i] -= beta[j-1]*v_prev[i];
+            }
+
+        double a = 0.0;
+        for (unsigned int i = 0; i < n; i++)
+            a += v[i]*m_vec_tmp[i];
+        alpha.push_back(Scalar(a));
+
+        double b = 0.0;
+        for (unsigned int i = 0; i < n; i++)
+            {
+            m_vec_tmp[i] -= Scalar(a)*v[i];
+            b += m_vec_tmp[i]*m_vec_tmp[i];
+            }
+        b = sqrt(b);
+        beta.push_back(Scalar(b));
+
+        m = j+1;
+        bd_rpy_sqrt_tridiagonal(alpha, beta, m, c);
+
+        // relative change of the result, the Lanczos vectors are orthonormal
+        double diff = 0.0;
+        double c_norm = 0.0;
+        for (unsigned int i = 0; i < m; i++)
+            {
+            double d = c[i] - (i < c_prev.size() ? c_prev[i] : 0.0);
+            diff += d*d;
+            c_norm += c[i]*c[i];
+            }
+        c_prev = c;
+
+        if ((j > 0 && diff <= m_lanczos_tol*m_lanczos_tol*c_norm) || b <= 1e-12*fabs(a))
+            {
+            converged = true;
+            break;
+            }
+
+        Scalar *v_next = &m_lanczos_basis[(j+1)*n];
+        for (unsigned int i = 0; i < n; i++)
+            v_next[i] = Scalar(m_vec_tmp[i]/b);
+        }
+
+    if (! converged)
+        m_exec_conf->msg->warning() << "integrate.brownian_rpy: Lanczos iteration did not converge in "
+                                    << m_lanczos_max_iter << " iterations" << endl;
+
+    m_n_lanczos = m;
+
+    for (unsigned int l = 0; l < m; l++)
+        {
+        const Scalar *v = &m_lanczos_basis[l*n];
+        Scalar coeff = Scalar(z_norm*c[l]);
+        for (unsigned int i = 0; i < n; i++)
+            y[i] += coeff*v[i];
+        }
+    }
+
+/*! \param timestep Current time step
+    \post Particle positions are moved forward to timestep+1
+*/
+void TwoStepBDRPY::integrateStepOne(unsigned int timestep)
+    {
+    if (! m_params_set)
+        {
+        m_exec_conf->msg->error() << "integrate.brownian_rpy: set_params() has to be called before run()" << endl;
+        throw std::runtime_error("Error during BD RPY integration");
+        }
+
+    unsigned int group_size = m_group->getNumMembers();
+
+    // profile this step
+    if (m_prof)
+        m_prof->push("BD RPY step 1");
+
+    const BoxDim& box = m_pdata->getBox();
+    Scalar3 npd = box.getNearestPlaneDistance();
+    if (Scalar(2.0)*m_r_cut > npd.x || Scalar(2.0)*m_r_cut > npd.y || Scalar(2.0)*m_r_cut > npd.z)
+        {
+        m_exec_conf->msg->error() << "integrate.brownian_rpy: Real space cutoff is larger than half the box" << endl;
+        throw std::runtime_error("Error during BD RPY integration");
+        }
+
+    if (! m_kiss_fft_initialized)
+        initializeFFT();
+
+    if (m_box_changed)
+        {
+        computeInfluenceFunction();
+        m_box_changed = false;
+        }
+
+    setupMobility(timestep);
+
+    const Scalar currentTemp = m_T->getValue(timestep);
+
+    // forces and random numbers of the group members
+    std::vector<Scalar> f(3*group_size), z(3*group_size);
+        {
+        ArrayHandle<Scalar4> h_net_force(m_pdata->getNetForce(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+        for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+            {
+            unsigned int j = m_group->getMemberIndex(group_idx);
+            f[3*group_idx] = h_net_force.data[j].x;
+            f[3*group_idx+1] = h_net_force.data[j].y;
+            f[3*group_idx+2] = h_net_force.data[j].z;
+
+            detail::Philox4x32 rng(h_tag.data[j], timestep, m_seed);
+            Scalar n[4];
+            rng.normal4(Scalar(1.0), n);
+            z[3*group_idx] = n[0];
+            z[3*group_idx+1] = n[1];
+            z[3*group_idx+2] = n[2];
+            }
+        }
+
+    // deterministic and Brownian displacements
+    std::vector<Scalar> u, y;
+    applyMobility(&f[0], u);
+
+    if (currentTemp > Scalar(0.0))
+        applySqrtMobility(z, y);
+    else
+        {
+        y.assign(3*group_size, Scalar(0.0));
+        m_n_lanczos = 0;
+        }
+
+    Scalar mu0 = Scalar(1.0)/(Scalar(6.0*M_PI)*m_eta*m_a);
+    Scalar coeff_det = mu0*m_deltaT;
+    Scalar coeff_rand = fast::sqrt(Scalar(2.0)*currentTemp*mu0*m_deltaT);
+
+    ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<Scalar4> h_pos(m_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<int3> h_image(m_pdata->getImages(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_tag(m_pdata->getTags(), access_location::host, access_mode::read);
+
+    for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
+        {
+        unsigned int j = m_group->getMemberIndex(group_idx);
+
+        // update position
+        h_pos.data[j].x += coeff_det*u[3*group_idx] + coeff_rand*y[3*group_idx];
+        h_pos.data[j].y += coeff_det*u[3*group_idx+1] + coeff_rand*y[3*group_idx+1];
+        h_pos.data[j].z += coeff_det*u[3*group_idx+2] + coeff_rand*y[3*group_idx+2];
+
+        // particles may have been moved slightly outside the box by the above steps, wrap them back into place
+        box.wrap(h_pos.data[j], h_image.data[j]);
+
+        // draw a new random velocity for particle j, from a stream independent of the displacements
+        detail::Philox4x32 rng(h_tag.data[j], timestep, m_seed^0x6d2b79f5);
+        Scalar mass =  h_vel.data[j].w;
+        Scalar sigma = fast::sqrt(currentTemp/mass);
+        Scalar n[4];
+        rng.normal4(sigma, n);
+        h_vel.data[j].x = n[0];
+        h_vel.data[j].y = n[1];
+        h_vel.data[j].z = n[2];
+        }
+
+    // done profiling
+    if (m_prof)
+        m_prof->pop();
+    }
+
+/*! \param timestep Current time step
+*/
+void TwoStepBDRPY::integrateStepTwo(unsigned int timestep)
+    {
+    // there is no step 2 in Brownian dynamics.
+    }
+
+void export_TwoStepBDRPY(py::module& m)
+    {
+    py::class_<TwoStepBDRPY, std::shared_ptr<TwoStepBDRPY> >(m, "TwoStepBDRPY", py::base<IntegrationMethodTwoStep>())
+    .def(py::init< std::shared_ptr<SystemDefinition>,
+                            std::shared_ptr<ParticleGroup>,
+                            std::shared_ptr<Variant>,
+                            unsigned int,
+                            Scalar,
+                            Scalar>())
+        .def("setT", &TwoStepBDRPY::setT)
+        .def("setFluid", &TwoStepBDRPY::setFluid)
+        .def("setParams", &TwoStepBDRPY::setParams)
+        .def("setLanczosParams", &TwoStepBDRPY::setLanczosParams)
+        .def("getNumLanczosIterations", &TwoStepBDRPY::getNumLanczosIterations)
+        ;
+    }
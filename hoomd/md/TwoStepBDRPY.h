@@ -0,0 +1,162 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: joaander
+
+#include "IntegrationMethodTwoStep.h"
+#include "hoomd/Variant.h"
+#include "hoomd/CellList.h"
+#include "hoomd/extern/kiss_fftnd.h"
+
+#include <vector>
+
+#ifndef __TWO_STEP_BD_RPY_H__
+#define __TWO_STEP_BD_RPY_H__
+
+/*! \file TwoStepBDRPY.h
+    \brief Declares the TwoStepBDRPY class
+*/
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include <hoomd/extern/pybind/include/pybind11/pybind11.h>
+
+//! Integrates part of the system forward with Brownian dynamics including hydrodynamic interactions
+/*! The particles are equal spheres of radius a in a fluid of viscosity eta. Their displacements over one time step
+    are
+
+    \f[ \Delta \vec{x} = M \vec{F} \Delta t + \sqrt{2 k T \Delta t} M^{1/2} \vec{z} \f]
+
+    where \f$ M \f$ is the Rotne-Prager-Yamakawa mobility of the periodic system and \f$ \vec{z} \f$ are independent
+    normal random numbers.
+
+    M is never stored. Its product with a vector is the sum of the Ewald split parts of EvaluatorRPYEwald: the short
+    ranged real space part is summed over the pairs within r_cut, found with a CellList, and the wave space part
+    is evaluated on a mesh like in PPPMForceCompute. The vector is spread to the mesh with B-splines of the given
+    order, transformed with kiss FFT, multiplied with the wave space mobility deconvolved by the assignment function
+    and interpolated back with the same B-splines, which keeps the product symmetric.
+
+    The Brownian displacements apply the square root of M with the Lanczos method (T. Ando, E. Chow, Y. Saad, J.
+    Skolnick, J. Chem. Phys. 137, 064106 (2012)), which only requires products of M with vectors. It stops when the
+    relative change of the result between two iterations drops below the tolerance.
+
+    Hydrodynamic interactions act among the members of the group. Only translational degrees of freedom are
+    integrated. The method runs on the CPU, on a single rank, in three dimensions.
+
+    \ingroup updaters
+*/
+class PYBIND11_EXPORT TwoStepBDRPY : public IntegrationMethodTwoStep
+    {
+    public:
+        //! Constructs the integration method and associates it with the system
+        TwoStepBDRPY(std::shared_ptr<SystemDefinition> sysdef,
+                     std::shared_ptr<ParticleGroup> group,
+                     std::shared_ptr<Variant> T,
+                     unsigned int seed,
+                     Scalar eta,
+                     Scalar a);
+
+        virtual ~TwoStepBDRPY();
+
+        //! Set a new temperature
+        /*! \param T new temperature to set */
+        void setT(std::shared_ptr<Variant> T)
+            {
+            m_T = T;
+            }
+
+        //! Set the viscosity and the particle radius
+        void setFluid(Scalar eta, Scalar a);
+
+        //! Set the parameters of the Ewald split mobility
+        void setParams(Scalar xi, Scalar r_cut, unsigned int nx, unsigned int ny, unsigned int nz, unsigned int order);
+
+        //! Set the tolerance and the maximum number of iterations of the Lanczos method
+        void setLanczosParams(Scalar tol, unsigned int max_iter);
+
+        //! Get the number of Lanczos iterations of the last time step
+        unsigned int getNumLanczosIterations()
+            {
+            return m_n_lanczos;
+            }
+
+        //! Returns a list of log quantities this integrator calculates
+        virtual std::vector< std::string > getProvidedLogQuantities();
+
+        //! Returns logged values
+        Scalar getLogValue(const std::string& quantity, unsigned int timestep, bool &my_quantity_flag);
+
+        //! Performs the first step of the integration
+        virtual void integrateStepOne(unsigned int timestep);
+
+        //! Performs the second step of the integration
+        virtual void integrateStepTwo(unsigned int timestep);
+
+    protected:
+        std::shared_ptr<Variant> m_T;   //!< The temperature of the stochastic bath
+        unsigned int m_seed;            //!< The seed for the RNG of the stochastic bath
+        Scalar m_eta;                   //!< Viscosity of the fluid
+        Scalar m_a;                     //!< Radius of the particles
+
+        Scalar m_xi;                    //!< Ewald splitting parameter
+        Scalar m_r_cut;                 //!< Cutoff of the real space part
+        uint3 m_mesh_points;            //!< Number of mesh points along every lattice vector
+        unsigned int m_order;           //!< Order of the B-spline assignment
+        bool m_params_set;              //!< True if setParams() has been called
+
+        Scalar m_lanczos_tol;           //!< Relative tolerance of the Lanczos method
+        unsigned int m_lanczos_max_iter; //!< Maximum number of Lanczos iterations
+        unsigned int m_n_lanczos;       //!< Number of Lanczos iterations of the last time step
+
+        std::shared_ptr<CellList> m_cl; //!< Cell list for the real space part
+
+        kiss_fftnd_cfg m_kiss_fft;      //!< The FFT configuration
+        kiss_fftnd_cfg m_kiss_ifft;     //!< Inverse FFT configuration
+        bool m_kiss_fft_initialized;    //!< True if the FFT has been set up
+        bool m_box_changed;             //!< True if the box changed since the influence function was computed
+
+        GPUArray<kiss_fft_cpx> m_mesh;          //!< Spread vector, three meshes one after the other
+        GPUArray<kiss_fft_cpx> m_fourier_mesh;  //!< Fourier transformed meshes
+        GPUArray<Scalar> m_inf_f;               //!< Wave space mobility over the squared assignment function
+        GPUArray<Scalar3> m_k;                  //!< Wave vectors
+
+        std::vector<unsigned int> m_group_slot; //!< Group index of every local particle, UINT_MAX for non-members
+        std::vector<unsigned int> m_pair_i;     //!< First particle (group index) of every real space pair
+        std::vector<unsigned int> m_pair_j;     //!< Second particle (group index) of every real space pair
+        std::vector<Scalar> m_pair_mobility;    //!< Real space mobility of every pair (xx, xy, xz, yy, yz, zz)
+
+        std::vector<int3> m_first_point;        //!< First mesh point of the assignment of every member
+        std::vector<Scalar> m_weights;          //!< Assignment weights of every member along the three directions
+
+        std::vector<Scalar> m_lanczos_basis;    //!< Lanczos vectors
+        std::vector<Scalar> m_vec_tmp;          //!< Temporary vector
+
+        //! Helper function to be called when box changes
+        void setBoxChange()
+            {
+            m_box_changed = true;
+            }
+
+        //! Set up the FFT and allocate the meshes
+        void initializeFFT();
+
+        //! Compute wave vectors and the influence function
+        void computeInfluenceFunction();
+
+        //! Find the real space pairs and the assignment weights of the current configuration
+        void setupMobility(unsigned int timestep);
+
+        //! Multiply a vector over the group members with the mobility (in units of the single particle mobility)
+        void applyMobility(const Scalar *f, std::vector<Scalar>& u);
+
+        //! Apply the square root of the mobility to a vector with the Lanczos method
+        void applySqrtMobility(const std::vector<Scalar>& z, std::vector<Scalar>& y);
+    };
+
+//! Exports the TwoStepBDRPY class to python
+void export_TwoStepBDRPY(pybind11::module& m);
+
+#endif // #ifndef __TWO_STEP_BD_RPY_H__
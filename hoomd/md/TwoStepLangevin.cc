@@ -5,7 +5,7 @@
 // Maintainer: joaander
 
 #include "TwoStepLangevin.h"
-#include "hoomd/Saru.h"
+#include "hoomd/Philox.h"
 #include "hoomd/VectorMath.h"
 
 #ifdef ENABLE_MPI
@@ -275,13 +275,15 @@ void TwoStepLangevin::integrateStepTwo(unsigned int timestep)
         unsigned int ptag = h_tag.data[j];
 
         // Initialize the RNG
-        detail::Saru saru(ptag, timestep, m_seed);
+        detail::Philox4x32 rng(ptag, timestep, m_seed);
 
         // first, calculate the BD forces
-        // Generate three random numbers
-        Scalar rx = saru.s<Scalar>(-1,1);
-        Scalar ry = saru.s<Scalar>(-1,1);
-        Scalar rz = saru.s<Scalar>(-1,1);
+        // Generate three random numbers from one block
+        Scalar r[4];
+        rng.uniform4(Scalar(-1), Scalar(1), r);
+        Scalar rx = r[0];
+        Scalar ry = r[1];
+        Scalar rz = r[2];
 
         Scalar gamma;
         if (m_use_lambda)
@@ -343,9 +345,13 @@ void TwoStepLangevin::integrateStepTwo(unsigned int timestep)
                                                fast::sqrt(Scalar(2.0)*gamma_r.z*currentTemp/m_deltaT));
                 if (m_noiseless_r) sigma_r = make_scalar3(0.0,0.0,0.0);
 
-                Scalar rand_x = gaussian_rng(saru, sigma_r.x);
-                Scalar rand_y = gaussian_rng(saru, sigma_r.y);
-                Scalar rand_z = gaussian_rng(saru, sigma_r.z);
+                // the rotational noise is drawn from its own stream, shared with the GPU implementation
+                detail::Philox4x32 rng_r(ptag, timestep, m_seed, 1);
+                Scalar n[4];
+                rng_r.normal4(Scalar(1.0), n);
+                Scalar rand_x = n[0]*sigma_r.x;
+                Scalar rand_y = n[1]*sigma_r.y;
+                Scalar rand_z = n[2]*sigma_r.z;
 
                 // check for degenerate moment of inertia
                 bool x_zero, y_zero, z_zero;
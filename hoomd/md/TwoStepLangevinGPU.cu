@@ -6,7 +6,7 @@
 
 #include "TwoStepLangevinGPU.cuh"
 
-#include "hoomd/Saru.h"
+#include "hoomd/Philox.h"
 using namespace hoomd;
 
 #include <assert.h>
@@ -49,7 +49,7 @@ extern __shared__ Scalar bdtally_sdata[];
 
     This kernel will tally the energy transfer from the bd thermal reservoir and the particle system
 
-    Random number generation is done per thread with Saru's 3-seed constructor. The seeds are, the time step,
+    Random number generation is done per thread with a Philox4x32 generator. The seeds are, the time step,
     the particle tag, and the user-defined seed.
 
     This kernel must be launched with enough dynamic shared memory per block to read in d_gamma
@@ -124,12 +124,14 @@ void gpu_langevin_step_two_kernel(const Scalar4 *d_pos,
         if (noiseless_t)
             coeff = Scalar(0.0);
 
-        //Initialize the Random Number Generator and generate the 3 random numbers
-        detail::Saru s(ptag, timestep, seed); // 3 dimensional seeding
+        //Initialize the Random Number Generator and generate the 3 random numbers from one block
+        detail::Philox4x32 rng(ptag, timestep, seed);
 
-        Scalar randomx=s.s<Scalar>(-1.0, 1.0);
-        Scalar randomy=s.s<Scalar>(-1.0, 1.0);
-        Scalar randomz=s.s<Scalar>(-1.0, 1.0);
+        Scalar r[4];
+        rng.uniform4(Scalar(-1.0), Scalar(1.0), r);
+        Scalar randomx=r[0];
+        Scalar randomy=r[1];
+        Scalar randomz=r[2];
 
         bd_force.x = randomx*coeff - gamma*vel.x;
         bd_force.y = randomy*coeff - gamma*vel.y;
@@ -309,10 +311,13 @@ __global__ void gpu_langevin_angular_step_two_kernel(
                                            fast::sqrt(Scalar(2.0)*gamma_r.z*T/deltaT));
             if (noiseless_r) sigma_r = make_scalar3(0,0,0);
 
-            detail::Saru saru(ptag, timestep, seed); // 3 dimensional seeding
-            Scalar rand_x = gaussian_rng(saru, sigma_r.x);
-            Scalar rand_y = gaussian_rng(saru, sigma_r.y);
-            Scalar rand_z = gaussian_rng(saru, sigma_r.z);
+            // rotational noise stream
+            detail::Philox4x32 rng_r(ptag, timestep, seed, 1);
+            Scalar n[4];
+            rng_r.normal4(Scalar(1.0), n);
+            Scalar rand_x = n[0]*sigma_r.x;
+            Scalar rand_y = n[1]*sigma_r.y;
+            Scalar rand_z = n[2]*sigma_r.z;
 
             // check for zero moment of inertia
             bool x_zero, y_zero, z_zero;
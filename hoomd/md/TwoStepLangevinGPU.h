@@ -45,6 +45,19 @@ class PYBIND11_EXPORT TwoStepLangevinGPU : public TwoStepLangevin
         //! Performs the second step of the integration
         virtual void integrateStepTwo(unsigned int timestep);
 
+        //! Get the parameters of the first step for a fused update
+        /*! \param params Set to the parameters of the first step
+            \returns true, the first step is the unlimited NVE first step
+        */
+        virtual bool getFusedStepOneParams(nve_step_one_params& params)
+            {
+            params.limit_val = Scalar(0.0);
+            params.limit = false;
+            params.zero_force = false;
+            params.aniso = m_aniso;
+            return true;
+            }
+
     protected:
         unsigned int m_block_size;               //!< block size for partial sum memory
         unsigned int m_num_blocks;               //!< number of memory blocks reserved for partial sum memory
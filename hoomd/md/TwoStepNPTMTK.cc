@@ -62,7 +62,15 @@ TwoStepNPTMTK::TwoStepNPTMTK(std::shared_ptr<SystemDefinition> sysdef,
                             m_flags(flags),
                             m_nph(nph),
                             m_rescale_all(false),
-                            m_gamma(0.0)
+                            m_gamma(0.0),
+                            m_fuse_thermo(false),
+                            m_fused_half_valid(false),
+                            m_fused_half_timestep(0),
+                            m_fused_ke_trans_half(0.0),
+                            m_fused_ke_rot_half(0.0),
+                            m_fused_full_valid(false),
+                            m_fused_full_timestep(0),
+                            m_fused_ke_trans(0.0)
     {
     m_exec_conf->msg->notice(5) << "Constructing TwoStepNPTMTK" << endl;
 
@@ -123,7 +131,15 @@ TwoStepNPTMTK::TwoStepNPTMTK(std::shared_ptr<SystemDefinition> sysdef,
                             m_couple(couple),
                             m_flags(flags),
                             m_nph(nph),
-                            m_rescale_all(false)
+                            m_rescale_all(false),
+                            m_fuse_thermo(false),
+                            m_fused_half_valid(false),
+                            m_fused_half_timestep(0),
+                            m_fused_ke_trans_half(0.0),
+                            m_fused_ke_rot_half(0.0),
+                            m_fused_full_valid(false),
+                            m_fused_full_timestep(0),
+                            m_fused_ke_trans(0.0)
     {
     m_exec_conf->msg->notice(5) << "Constructing TwoStepNPTMTK" << endl;
 
@@ -215,6 +231,12 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
     // update the propagator matrix using current barostat momenta
     updatePropagator(nuxx, nuxy, nuxz, nuyy, nuyz, nuzz);
 
+    // the kinetic energies at the half time step are summed up in the velocity updates
+    bool fuse_half_step = m_fuse_thermo && !m_nph;
+    double sums[npt_mtk_sum::num_sums];
+    for (unsigned int k = 0; k < npt_mtk_sum::num_sums; k++)
+        sums[k] = 0.0;
+
     // advance box lengths
     BoxDim global_box = m_pdata->getGlobalBox();
     Scalar3 a = global_box.getLatticeVector(0);
@@ -297,6 +319,9 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
             // apply thermostat update of velocity
             v *= exp_thermo_fac;
 
+            if (fuse_half_step)
+                sums[npt_mtk_sum::ke_trans] += (double)h_vel.data[j].w*(v.x*v.x + v.y*v.y + v.z*v.z);
+
             if (! m_rescale_all)
                 {
                 r.x = m_mat_exp_r[0] * r.x + m_mat_exp_r[1] * r.y + m_mat_exp_r[2] * r.z;
@@ -443,9 +468,21 @@ void TwoStepNPTMTK::integrateStepOne(unsigned int timestep)
 
             h_orientation.data[j] = quat_to_scalar4(q);
             h_angmom.data[j] = quat_to_scalar4(p);
+
+            if (fuse_half_step)
+                {
+                // only if the moment of inertia along one principal axis is non-zero, that axis carries angular momentum
+                quat<Scalar> s_rot(Scalar(0.5)*conj(q)*p);
+                if (! x_zero) sums[npt_mtk_sum::ke_rot] += s_rot.v.x*s_rot.v.x/I.x;
+                if (! y_zero) sums[npt_mtk_sum::ke_rot] += s_rot.v.y*s_rot.v.y/I.y;
+                if (! z_zero) sums[npt_mtk_sum::ke_rot] += s_rot.v.z*s_rot.v.z/I.z;
+                }
             }
         }
 
+    if (fuse_half_step)
+        setFusedHalfStepSums(timestep, sums);
+
     if (! m_nph)
         {
         // propagate thermostat variables forward
@@ -485,6 +522,10 @@ void TwoStepNPTMTK::integrateStepTwo(unsigned int timestep)
     Scalar nuyy = v.variable[5];  // Barostat tensor, yy component
     Scalar nuzz = v.variable[7];  // Barostat tensor, zz component
 
+    double sums[npt_mtk_sum::num_sums];
+    for (unsigned int k = 0; k < npt_mtk_sum::num_sums; k++)
+        sums[k] = 0.0;
+
     {
     ArrayHandle<Scalar4> h_vel(m_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     ArrayHandle<Scalar3> h_accel(m_pdata->getAccelerations(), access_location::host, access_mode::readwrite);
@@ -495,6 +536,10 @@ void TwoStepNPTMTK::integrateStepTwo(unsigned int timestep)
     Scalar mtk = (nuxx+nuyy+nuzz)/(Scalar)m_ndof;
     Scalar exp_thermo_fac = exp(-Scalar(1.0/2.0)*(xi_trans+mtk)*m_deltaT);
 
+    // the kinetic part of the pressure tensor and the virial are summed up in the velocity update
+    ArrayHandle<Scalar> h_net_virial(m_pdata->getNetVirial(), access_location::host, access_mode::read);
+    unsigned int virial_pitch = m_pdata->getNetVirial().getPitch();
+
     // perform second half step of NPT integration
     for (unsigned int group_idx = 0; group_idx < group_size; group_idx++)
         {
@@ -525,6 +570,18 @@ void TwoStepNPTMTK::integrateStepTwo(unsigned int timestep)
 
         // store velocity
         h_vel.data[j].x = v.x; h_vel.data[j].y = v.y; h_vel.data[j].z = v.z;
+
+        if (m_fuse_thermo)
+            {
+            sums[npt_mtk_sum::kinetic_xx] += m*((double)v.x*(double)v.x);
+            sums[npt_mtk_sum::kinetic_xy] += m*((double)v.x*(double)v.y);
+            sums[npt_mtk_sum::kinetic_xz] += m*((double)v.x*(double)v.z);
+            sums[npt_mtk_sum::kinetic_yy] += m*((double)v.y*(double)v.y);
+            sums[npt_mtk_sum::kinetic_yz] += m*((double)v.y*(double)v.z);
+            sums[npt_mtk_sum::kinetic_zz] += m*((double)v.z*(double)v.z);
+            for (unsigned int k = 0; k < 6; k++)
+                sums[npt_mtk_sum::virial_xx+k] += (double)h_net_virial.data[j+k*virial_pitch];
+            }
         }
 
     if (m_aniso)
@@ -572,6 +629,9 @@ void TwoStepNPTMTK::integrateStepTwo(unsigned int timestep)
         }
     } // end GPUArray scope
 
+    if (m_fuse_thermo)
+        setFusedFullStepSums(timestep+1, sums);
+
     // advance barostat (nuxx, nuyy, nuzz) half a time step
     advanceBarostat(timestep+1);
 
@@ -763,11 +823,32 @@ void TwoStepNPTMTK::updatePropagator(Scalar nuxx, Scalar nuxy, Scalar nuxz, Scal
 //! Helper function to advance the barostat parameters
 void TwoStepNPTMTK::advanceBarostat(unsigned int timestep)
     {
-    // compute thermodynamic properties at full time step
-    m_thermo_group_t->compute(timestep);
-
     // compute pressure for the next half time step
-    PressureTensor P = m_thermo_group_t->getPressureTensor();
+    PressureTensor P;
+    Scalar ke_trans;
+    if (m_fuse_thermo && m_fused_full_valid && m_fused_full_timestep == timestep)
+        {
+        // use the pressure tensor summed up in the last velocity update
+        P = m_fused_P;
+        ke_trans = m_fused_ke_trans;
+        }
+    else
+        {
+        // compute thermodynamic properties at full time step
+        m_thermo_group_t->compute(timestep);
+
+        if (isIsotropic())
+            {
+            // only the scalar pressure is available, it enters through the trace
+            Scalar P_iso = m_thermo_group_t->getPressure();
+            P.xx = P.yy = P.zz = P_iso;
+            P.xy = P.xz = P.yz = Scalar(0.0);
+            }
+        else
+            P = m_thermo_group_t->getPressureTensor();
+
+        ke_trans = m_thermo_group_t->getTranslationalKineticEnergy();
+        }
 
     if ( std::isnan(P.xx) || std::isnan(P.xy) || std::isnan(P.xz) || std::isnan(P.yy) || std::isnan(P.yz) || std::isnan(P.zz) )
         {
@@ -783,7 +864,7 @@ void TwoStepNPTMTK::advanceBarostat(unsigned int timestep)
     // Martyna-Tobias-Klein correction
     unsigned int d = m_sysdef->getNDimensions();
     Scalar W = (Scalar)(m_ndof+d)/(Scalar)d*m_T->getValue(timestep)*m_tauP*m_tauP;
-    Scalar mtk_term = Scalar(2.0)*m_thermo_group_t->getTranslationalKineticEnergy();
+    Scalar mtk_term = Scalar(2.0)*ke_trans;
     mtk_term *= Scalar(1.0/2.0)*m_deltaT/(Scalar)m_ndof/W;
 
     couplingMode couple = m_couple;
@@ -910,16 +991,94 @@ void TwoStepNPTMTK::advanceBarostat(unsigned int timestep)
     setIntegratorVariables(v);
     }
 
+/*! \param timestep Time step of the half step velocities
+    \param sums Local sums indexed by npt_mtk_sum, the ke_trans and ke_rot entries are reduced over all ranks
+
+    The kinetic energies are stored for advanceThermostat().
+*/
+void TwoStepNPTMTK::setFusedHalfStepSums(unsigned int timestep, double *sums)
+    {
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &sums[npt_mtk_sum::ke_trans], 2, MPI_DOUBLE, MPI_SUM,
+            m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    m_fused_ke_trans_half = Scalar(0.5*sums[npt_mtk_sum::ke_trans]);
+    m_fused_ke_rot_half = Scalar(0.5*sums[npt_mtk_sum::ke_rot]);
+    m_fused_half_timestep = timestep;
+    m_fused_half_valid = true;
+    }
+
+/*! \param timestep Time step of the full step velocities
+    \param sums Local sums indexed by npt_mtk_sum, the kinetic and virial entries are reduced over all ranks
+
+    The pressure tensor is evaluated like ComputeThermo does and stored for advanceBarostat(). With isotropic
+    coupling, only the scalar pressure enters the diagonal.
+*/
+void TwoStepNPTMTK::setFusedFullStepSums(unsigned int timestep, double *sums)
+    {
+    for (unsigned int k = 0; k < 6; k++)
+        sums[npt_mtk_sum::virial_xx+k] += m_pdata->getExternalVirial(k);
+
+    #ifdef ENABLE_MPI
+    if (m_comm)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &sums[npt_mtk_sum::kinetic_xx], 12, MPI_DOUBLE, MPI_SUM,
+            m_exec_conf->getMPICommunicator());
+        }
+    #endif
+
+    bool twod = m_sysdef->getNDimensions()==2;
+    double V = m_pdata->getGlobalBox().getVolume(twod);
+
+    double ke_trans = 0.5*(sums[npt_mtk_sum::kinetic_xx] + sums[npt_mtk_sum::kinetic_yy] + sums[npt_mtk_sum::kinetic_zz]);
+    m_fused_ke_trans = Scalar(ke_trans);
+
+    if (isIsotropic())
+        {
+        // P = (N * K_B * T + W)/V with the isotropic virial W = 1/3 trace of the virial tensor
+        double W = 1.0/3.0*(sums[npt_mtk_sum::virial_xx] + sums[npt_mtk_sum::virial_yy] + sums[npt_mtk_sum::virial_zz]);
+        unsigned int D = m_sysdef->getNDimensions();
+        if (twod)
+            {
+            // W needs to be corrected since the 1/3 factor is built in
+            W *= 3.0/2.0;
+            }
+        Scalar P_iso = Scalar((2.0*ke_trans/double(D) + W)/V);
+        m_fused_P.xx = m_fused_P.yy = m_fused_P.zz = P_iso;
+        m_fused_P.xy = m_fused_P.xz = m_fused_P.yz = Scalar(0.0);
+        }
+    else
+        {
+        // pressure tensor = (kinetic part + virial) / V
+        m_fused_P.xx = Scalar((sums[npt_mtk_sum::kinetic_xx] + sums[npt_mtk_sum::virial_xx])/V);
+        m_fused_P.xy = Scalar((sums[npt_mtk_sum::kinetic_xy] + sums[npt_mtk_sum::virial_xy])/V);
+        m_fused_P.xz = Scalar((sums[npt_mtk_sum::kinetic_xz] + sums[npt_mtk_sum::virial_xz])/V);
+        m_fused_P.yy = Scalar((sums[npt_mtk_sum::kinetic_yy] + sums[npt_mtk_sum::virial_yy])/V);
+        m_fused_P.yz = Scalar((sums[npt_mtk_sum::kinetic_yz] + sums[npt_mtk_sum::virial_yz])/V);
+        m_fused_P.zz = Scalar((sums[npt_mtk_sum::kinetic_zz] + sums[npt_mtk_sum::virial_zz])/V);
+        }
+
+    m_fused_full_timestep = timestep;
+    m_fused_full_valid = true;
+    }
+
 void TwoStepNPTMTK::advanceThermostat(unsigned int timestep)
     {
     IntegratorVariables v = getIntegratorVariables();
     Scalar& eta = v.variable[0];
     Scalar& xi = v.variable[1];
 
-    // compute the current thermodynamic properties
-    m_thermo_group->compute(timestep);
+    // use the kinetic energies summed up in the velocity update, or compute the current thermodynamic properties
+    bool fused = m_fuse_thermo && m_fused_half_valid && m_fused_half_timestep == timestep;
+    if (! fused)
+        m_thermo_group->compute(timestep);
 
-    Scalar curr_T_trans = m_thermo_group->getTranslationalTemperature();
+    Scalar curr_T_trans = fused ? Scalar(2.0)*m_fused_ke_trans_half/(Scalar)m_thermo_group->getNDOF()
+                                : m_thermo_group->getTranslationalTemperature();
     Scalar T = m_T->getValue(timestep);
 
     // update the state variables Xi and eta
@@ -933,7 +1092,7 @@ void TwoStepNPTMTK::advanceThermostat(unsigned int timestep)
         Scalar &xi_rot = v.variable[8];
         Scalar &eta_rot = v.variable[9];
 
-        Scalar curr_ke_rot = m_thermo_group->getRotationalKineticEnergy();
+        Scalar curr_ke_rot = fused ? m_fused_ke_rot_half : m_thermo_group->getRotationalKineticEnergy();
         unsigned int ndof_rot = m_thermo_group->getRotationalNDOF();
 
         Scalar xi_prime_rot = xi_rot + Scalar(1.0/2.0)*m_deltaT/m_tau/m_tau*(Scalar(2.0)*curr_ke_rot/ndof_rot/T - Scalar(1.0));
@@ -954,6 +1113,10 @@ void TwoStepNPTMTK::randomizeVelocities(unsigned int timestep)
 
     m_exec_conf->msg->notice(6) << "TwoStepNPTMTK randomizing velocities" << std::endl;
 
+    // the fused sums do not apply to the new velocities
+    m_fused_half_valid = false;
+    m_fused_full_valid = false;
+
     IntegratorVariables v = getIntegratorVariables();
 
     hoomd::detail::Saru saru(0x9db2f0ab, timestep, m_seed_randomize);
@@ -1065,6 +1228,7 @@ void export_TwoStepNPTMTK(py::module& m)
         .def("setTauP", &TwoStepNPTMTK::setTauP)
         .def("setRescaleAll", &TwoStepNPTMTK::setRescaleAll)
         .def("setGamma", &TwoStepNPTMTK::setGamma)
+        .def("setFuseThermo", &TwoStepNPTMTK::setFuseThermo)
         ;
 
     py::enum_<TwoStepNPTMTK::couplingMode>(twostepnptmtk,"couplingMode")
@@ -7,6 +7,7 @@
 #include "IntegrationMethodTwoStep.h"
 #include "hoomd/Variant.h"
 #include "hoomd/ComputeThermo.h"
+#include "TwoStepNPTMTKTypes.h"
 
 #ifndef __TWO_STEP_NPT_MTK_H__
 #define __TWO_STEP_NPT_MTK_H__
@@ -142,6 +143,17 @@ class PYBIND11_EXPORT TwoStepNPTMTK : public IntegrationMethodTwoStep
             m_gamma = gamma;
             }
 
+        //! Set whether the thermo quantities are reduced in the velocity updates
+        /*! \param fuse_thermo If true, the kinetic energies and the pressure tensor of the group are summed up while
+                the velocities are updated, instead of by separate passes of the ComputeThermo
+        */
+        void setFuseThermo(bool fuse_thermo)
+            {
+            m_fuse_thermo = fuse_thermo;
+            m_fused_half_valid = false;
+            m_fused_full_valid = false;
+            }
+
         //! Performs the first step of the integration
         virtual void integrateStepOne(unsigned int timestep);
 
@@ -150,12 +162,16 @@ class PYBIND11_EXPORT TwoStepNPTMTK : public IntegrationMethodTwoStep
 
         //! Get needed pdata flags
         /*! TwoStepNPTMTK needs the pressure, so the isotropic_virial or pressure_tensor flag is set,
-            depending on the integration mode
+            depending on the integration mode. With isotropic coupling only the scalar pressure is
+            needed, and the force computes may skip the off-diagonal virial components.
         */
         virtual PDataFlags getRequestedPDataFlags()
             {
             PDataFlags flags;
-            flags[pdata_flag::pressure_tensor] = 1;
+            if (isIsotropic())
+                flags[pdata_flag::isotropic_virial] = 1;
+            else
+                flags[pdata_flag::pressure_tensor] = 1;
             if (m_aniso)
                 {
                 flags[pdata_flag::rotational_kinetic_energy] = 1;
@@ -208,9 +224,35 @@ class PYBIND11_EXPORT TwoStepNPTMTK : public IntegrationMethodTwoStep
 
         std::vector<std::string> m_log_names; //!< Name of the barostat and thermostat quantities that we log
 
+        bool m_fuse_thermo;                 //!< True if the thermo quantities are reduced in the velocity updates
+        bool m_fused_half_valid;            //!< True if the fused half step kinetic energies are set
+        unsigned int m_fused_half_timestep; //!< Time step of the fused half step kinetic energies
+        Scalar m_fused_ke_trans_half;       //!< Translational kinetic energy of the group at t+dt/2
+        Scalar m_fused_ke_rot_half;         //!< Rotational kinetic energy of the group at t+dt/2
+        bool m_fused_full_valid;            //!< True if the fused full step pressure tensor is set
+        unsigned int m_fused_full_timestep; //!< Time step of the fused full step pressure tensor
+        Scalar m_fused_ke_trans;            //!< Translational kinetic energy of the group at the full time step
+        PressureTensor m_fused_P;           //!< Pressure tensor of the group at the full time step
+
         //! Helper function to advance the barostat parameters
         void advanceBarostat(unsigned int timestep);
 
+        //! Store the half step kinetic energies summed up in integrateStepOne()
+        void setFusedHalfStepSums(unsigned int timestep, double *sums);
+
+        //! Store the full step pressure tensor summed up in integrateStepTwo()
+        void setFusedFullStepSums(unsigned int timestep, double *sums);
+
+        //! Test if the barostat only couples to the scalar pressure
+        /*! \returns true for a 3D box with x, y and z coupled together and no tilt degrees of freedom
+        */
+        bool isIsotropic() const
+            {
+            return m_couple == couple_xyz && m_sysdef->getNDimensions() == 3
+                && (m_flags & (baro_x | baro_y | baro_z)) == (baro_x | baro_y | baro_z)
+                && !(m_flags & (baro_xy | baro_xz | baro_yz));
+            }
+
         //! advance the thermostat
         /*!\param timestep The time step
          * \param broadcast True if we should broadcast the integrator variables via MPI
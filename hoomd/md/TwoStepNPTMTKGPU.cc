@@ -54,16 +54,11 @@ TwoStepNPTMTKGPU::TwoStepNPTMTKGPU(std::shared_ptr<SystemDefinition> sysdef,
 
     m_exec_conf->msg->notice(5) << "Constructing TwoStepNPTMTKGPU" << endl;
 
-    m_reduction_block_size = 512;
+    GPUArray<Scalar> partial_sum(npt_mtk_sum::num_sums, m_exec_conf);
+    m_partial_sum.swap(partial_sum);
 
-    // this breaks memory scaling (calculate memory requirements from global group size)
-    // unless we reallocate memory with every change of the maximum particle number
-    m_num_blocks = m_group->getNumMembersGlobal() / m_reduction_block_size + 1;
-    GPUArray< Scalar > scratch(m_num_blocks, m_exec_conf);
-    m_scratch.swap(scratch);
-
-    GPUArray< Scalar> temperature(1, m_exec_conf);
-    m_temperature.swap(temperature);
+    GPUArray<Scalar> sum(npt_mtk_sum::num_sums, m_exec_conf);
+    m_sum.swap(sum);
     }
 
 // TODO: rewrite the unit test in /hoomd-blue/hoomd/md/test/test_npt_mtk_integrator.cc so we don't need to do this
@@ -89,16 +84,11 @@ TwoStepNPTMTKGPU::TwoStepNPTMTKGPU(std::shared_ptr<SystemDefinition> sysdef,
 
     m_exec_conf->msg->notice(5) << "Constructing TwoStepNPTMTKGPU" << endl;
 
-    m_reduction_block_size = 512;
-
-    // this breaks memory scaling (calculate memory requirements from global group size)
-    // unless we reallocate memory with every change of the maximum particle number
-    m_num_blocks = m_group->getNumMembersGlobal() / m_reduction_block_size + 1;
-    GPUArray< Scalar > scratch(m_num_blocks, m_exec_conf);
-    m_scratch.swap(scratch);
+    GPUArray<Scalar> partial_sum(npt_mtk_sum::num_sums, m_exec_conf);
+    m_partial_sum.swap(partial_sum);
 
-    GPUArray< Scalar> temperature(1, m_exec_conf);
-    m_temperature.swap(temperature);
+    GPUArray<Scalar> sum(npt_mtk_sum::num_sums, m_exec_conf);
+    m_sum.swap(sum);
     }
 
 TwoStepNPTMTKGPU::~TwoStepNPTMTKGPU()
@@ -106,6 +96,40 @@ TwoStepNPTMTKGPU::~TwoStepNPTMTKGPU()
     m_exec_conf->msg->notice(5) << "Destroying TwoStepNPTMTKGPU" << endl;
     }
 
+/*! \param group_size Number of local group members
+
+    The array holds one set of sums per block of the velocity kernels. It is only grown, so that it follows the
+    number of local group members through domain decomposition.
+*/
+void TwoStepNPTMTKGPU::resizePartialSums(unsigned int group_size)
+    {
+    unsigned int num_blocks = group_size / 256 + 1;
+    if (m_partial_sum.getNumElements() < num_blocks*npt_mtk_sum::num_sums)
+        m_partial_sum.resize(num_blocks*npt_mtk_sum::num_sums);
+    }
+
+/*! \param group_size Number of local group members
+    \param first Index of the first sum to reduce
+    \param n Number of sums to reduce
+    \param sums Array indexed by npt_mtk_sum, entries first ... first+n-1 are written
+*/
+void TwoStepNPTMTKGPU::reducePartialSums(unsigned int group_size, unsigned int first, unsigned int n, double *sums)
+    {
+        {
+        ArrayHandle<Scalar> d_sum(m_sum, access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar> d_partial_sum(m_partial_sum, access_location::device, access_mode::read);
+
+        gpu_npt_mtk_reduce_sums(d_sum.data, d_partial_sum.data, group_size / 256 + 1, first, n);
+
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+
+    ArrayHandle<Scalar> h_sum(m_sum, access_location::host, access_mode::read);
+    for (unsigned int k = first; k < first+n; k++)
+        sums[k] = h_sum.data[k];
+    }
+
 /*! \param timestep Current time step
     \post Particle positions are moved forward to timestep+1 and velocities to timestep+1/2 per the Nose-Hoover
      thermostat and Anderson barostat
@@ -201,12 +225,18 @@ void TwoStepNPTMTKGPU::integrateStepOne(unsigned int timestep)
             CHECK_CUDA_ERROR();
         }
 
+    // sum up the kinetic energy at the half time step in the velocity update for the thermostat
+    bool fuse_half_step = m_fuse_thermo && !m_nph;
+    if (fuse_half_step)
+        resizePartialSums(group_size);
+
         {
         ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
         ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::read);
         ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::readwrite);
 
         ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
+        ArrayHandle<Scalar> d_partial_sum(m_partial_sum, access_location::device, access_mode::readwrite);
 
         // precompute loop invariant quantity
         Scalar xi_trans = v.variable[1];
@@ -223,7 +253,8 @@ void TwoStepNPTMTKGPU::integrateStepOne(unsigned int timestep)
                              m_mat_exp_r,
                              m_mat_exp_r_int,
                              m_deltaT,
-                             m_rescale_all);
+                             m_rescale_all,
+                             fuse_half_step ? d_partial_sum.data : NULL);
 
         if (m_exec_conf->isCUDAErrorCheckingEnabled())
             CHECK_CUDA_ERROR();
@@ -268,10 +299,34 @@ void TwoStepNPTMTKGPU::integrateStepOne(unsigned int timestep)
 
         if (m_exec_conf->isCUDAErrorCheckingEnabled())
             CHECK_CUDA_ERROR();
+
+        if (fuse_half_step)
+            {
+            // the angular step is shared with NVE, sum up the rotational kinetic energy separately
+            ArrayHandle<Scalar> d_partial_sum(m_partial_sum, access_location::device, access_mode::readwrite);
+
+            gpu_npt_mtk_rotational_ke(d_orientation.data,
+                                      d_angmom.data,
+                                      d_inertia.data,
+                                      d_index_array.data,
+                                      group_size,
+                                      d_partial_sum.data);
+
+            if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                CHECK_CUDA_ERROR();
+            }
         }
 
     if (! m_nph)
         {
+        if (fuse_half_step)
+            {
+            double sums[npt_mtk_sum::num_sums];
+            sums[npt_mtk_sum::ke_rot] = 0.0;
+            reducePartialSums(group_size, npt_mtk_sum::ke_trans, m_aniso ? 2 : 1, sums);
+            setFusedHalfStepSums(timestep, sums);
+            }
+
         // propagate thermostat variables forward
         advanceThermostat(timestep);
         }
@@ -314,12 +369,18 @@ void TwoStepNPTMTKGPU::integrateStepTwo(unsigned int timestep)
     // Martyna-Tobias-Klein correction
     Scalar mtk = (nuxx+nuyy+nuzz)/(Scalar)m_ndof;
 
+    // sum up the pressure tensor in the velocity update for the barostat
+    if (m_fuse_thermo)
+        resizePartialSums(group_size);
+
     {
     ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
     ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::overwrite);
 
     ArrayHandle<Scalar4> d_net_force(net_force, access_location::device, access_mode::read);
     ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar> d_net_virial(m_pdata->getNetVirial(), access_location::device, access_mode::read);
+    ArrayHandle<Scalar> d_partial_sum(m_partial_sum, access_location::device, access_mode::readwrite);
 
     // precompute loop invariant quantity
     Scalar xi_trans = v.variable[1];
@@ -333,7 +394,10 @@ void TwoStepNPTMTKGPU::integrateStepTwo(unsigned int timestep)
                      d_net_force.data,
                      m_mat_exp_v,
                      m_deltaT,
-                     exp_thermo_fac);
+                     exp_thermo_fac,
+                     d_net_virial.data,
+                     m_pdata->getNetVirial().getPitch(),
+                     m_fuse_thermo ? d_partial_sum.data : NULL);
 
     if (m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
@@ -366,6 +430,13 @@ void TwoStepNPTMTKGPU::integrateStepTwo(unsigned int timestep)
             CHECK_CUDA_ERROR();
         }
 
+    if (m_fuse_thermo)
+        {
+        double sums[npt_mtk_sum::num_sums];
+        reducePartialSums(group_size, npt_mtk_sum::kinetic_xx, 12, sums);
+        setFusedFullStepSums(timestep+1, sums);
+        }
+
     // advance barostat (nuxx, nuyy, nuzz) half a time step
     advanceBarostat(timestep+1);
 
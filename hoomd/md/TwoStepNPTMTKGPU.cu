@@ -13,6 +13,27 @@
     \brief Defines GPU kernel code for NPT integration on the GPU using the Martyna-Tobias-Klein update equations. Used by TwoStepNPTMTKGPU.
 */
 
+//! Shared memory used in reducing the fused thermo quantities
+extern __shared__ Scalar npt_mtk_sdata[];
+
+//! Reduce n sums of one block in shared memory (n*blockDim.x Scalars, blockDim.x must be a power of two)
+__device__ void npt_mtk_block_reduce(unsigned int n)
+    {
+    __syncthreads();
+
+    int offs = blockDim.x >> 1;
+    while (offs > 0)
+        {
+        if (threadIdx.x < offs)
+            {
+            for (unsigned int k = 0; k < n; k++)
+                npt_mtk_sdata[k*blockDim.x + threadIdx.x] += npt_mtk_sdata[k*blockDim.x + threadIdx.x + offs];
+            }
+        offs >>= 1;
+        __syncthreads();
+        }
+    }
+
 //! Kernel to propagate the positions and velocities, first half of NPT update
 __global__ void gpu_npt_mtk_step_one_kernel(Scalar4 *d_pos,
                              Scalar4 *d_vel,
@@ -39,11 +60,15 @@ __global__ void gpu_npt_mtk_step_one_kernel(Scalar4 *d_pos,
                              Scalar mat_exp_r_int_yz,
                              Scalar mat_exp_r_int_zz,
                              Scalar deltaT,
-                             bool rescale_all)
+                             bool rescale_all,
+                             Scalar *d_partial_sum)
     {
     // determine which particle this thread works on
     int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
 
+    // twice the kinetic energy at the half time step
+    Scalar mvsq(0.0);
+
     // initialize eigenvectors
     if (group_idx < group_size)
         {
@@ -70,6 +95,8 @@ __global__ void gpu_npt_mtk_step_one_kernel(Scalar4 *d_pos,
         // apply thermostat update of velocity
         v *= exp_thermo_fac;
 
+        mvsq = vel.w*dot(v,v);
+
         if (!rescale_all)
             {
             // rescale this group of particles
@@ -86,6 +113,16 @@ __global__ void gpu_npt_mtk_step_one_kernel(Scalar4 *d_pos,
         d_pos[idx] = make_scalar4(r.x,r.y,r.z,pos.w);
         d_vel[idx] = make_scalar4(v.x,v.y,v.z,vel.w);
         }
+
+    if (d_partial_sum != NULL)
+        {
+        // reduce the kinetic energy of this block
+        npt_mtk_sdata[threadIdx.x] = mvsq;
+        npt_mtk_block_reduce(1);
+
+        if (threadIdx.x == 0)
+            d_partial_sum[blockIdx.x*npt_mtk_sum::num_sums + npt_mtk_sum::ke_trans] = npt_mtk_sdata[0];
+        }
     }
 
 /*! \param d_pos array of particle positions
@@ -100,6 +137,7 @@ __global__ void gpu_npt_mtk_step_one_kernel(Scalar4 *d_pos,
     \param deltaT Time to advance (for one full step)
     \param deltaT Time to move forward in one whole step
     \param rescale_all True if all particles in the system should be rescaled at once
+    \param d_partial_sum If not NULL, the sum of m v^2 of every block is written to the npt_mtk_sum::ke_trans entry
 
     This is just a kernel driver for gpu_npt_mtk_step_one_kernel(). See it for more details.
 */
@@ -113,15 +151,17 @@ cudaError_t gpu_npt_mtk_step_one(Scalar4 *d_pos,
                              Scalar *mat_exp_r,
                              Scalar *mat_exp_r_int,
                              Scalar deltaT,
-                             bool rescale_all)
+                             bool rescale_all,
+                             Scalar *d_partial_sum)
     {
     // setup the grid to run the kernel
     unsigned int block_size = 256;
     dim3 grid( (group_size / block_size) + 1, 1, 1);
     dim3 threads(block_size, 1, 1);
+    unsigned int shared_bytes = d_partial_sum ? block_size*sizeof(Scalar) : 0;
 
     // run the kernel
-    gpu_npt_mtk_step_one_kernel<<< grid, threads >>>(d_pos,
+    gpu_npt_mtk_step_one_kernel<<< grid, threads, shared_bytes >>>(d_pos,
                                                  d_vel,
                                                  d_accel,
                                                  d_group_members,
@@ -146,7 +186,8 @@ cudaError_t gpu_npt_mtk_step_one(Scalar4 *d_pos,
                                                  mat_exp_r_int[4],
                                                  mat_exp_r_int[5],
                                                  deltaT,
-                                                 rescale_all);
+                                                 rescale_all,
+                                                 d_partial_sum);
 
     return cudaSuccess;
     }
@@ -222,11 +263,19 @@ __global__ void gpu_npt_mtk_step_two_kernel(Scalar4 *d_vel,
                              Scalar mat_exp_v_yz,
                              Scalar mat_exp_v_zz,
                              Scalar deltaT,
-                             Scalar exp_thermo_fac)
+                             Scalar exp_thermo_fac,
+                             const Scalar *d_net_virial,
+                             unsigned int virial_pitch,
+                             Scalar *d_partial_sum)
     {
     // determine which particle this thread works on
     int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
 
+    // kinetic part of the pressure tensor and virial at the full time step
+    Scalar sum[12];
+    for (unsigned int k = 0; k < 12; k++)
+        sum[k] = Scalar(0.0);
+
     if (group_idx < group_size)
         {
         unsigned int idx = d_group_members[group_idx];
@@ -258,6 +307,30 @@ __global__ void gpu_npt_mtk_step_two_kernel(Scalar4 *d_vel,
 
         // since we calculate the acceleration, we need to write it for the next step
         d_accel[idx] = accel;
+
+        if (d_partial_sum != NULL)
+            {
+            sum[0] = vel.w*v.x*v.x;
+            sum[1] = vel.w*v.x*v.y;
+            sum[2] = vel.w*v.x*v.z;
+            sum[3] = vel.w*v.y*v.y;
+            sum[4] = vel.w*v.y*v.z;
+            sum[5] = vel.w*v.z*v.z;
+            for (unsigned int k = 0; k < 6; k++)
+                sum[6+k] = d_net_virial[k*virial_pitch + idx];
+            }
+        }
+
+    if (d_partial_sum != NULL)
+        {
+        // reduce the pressure tensor of this block
+        for (unsigned int k = 0; k < 12; k++)
+            npt_mtk_sdata[k*blockDim.x + threadIdx.x] = sum[k];
+        npt_mtk_block_reduce(12);
+
+        if (threadIdx.x < 12)
+            d_partial_sum[blockIdx.x*npt_mtk_sum::num_sums + npt_mtk_sum::kinetic_xx + threadIdx.x]
+                = npt_mtk_sdata[threadIdx.x*blockDim.x];
         }
     }
 
@@ -269,6 +342,11 @@ __global__ void gpu_npt_mtk_step_two_kernel(Scalar4 *d_vel,
     \param d_net_force Net force on each particle
 
     \param deltaT Time to move forward in one whole step
+    \param exp_thermo_fac Update factor for thermostat
+    \param d_net_virial Net virial on each particle
+    \param virial_pitch Pitch of the net virial array
+    \param d_partial_sum If not NULL, the kinetic part of the pressure tensor and the virial of every block are written
+           to the npt_mtk_sum::kinetic_xx ... npt_mtk_sum::virial_zz entries
 
     This is just a kernel driver for gpu_npt_mtk_step_kernel(). See it for more details.
 */
@@ -279,15 +357,19 @@ cudaError_t gpu_npt_mtk_step_two(Scalar4 *d_vel,
                              Scalar4 *d_net_force,
                              Scalar* mat_exp_v,
                              Scalar deltaT,
-                             Scalar exp_thermo_fac)
+                             Scalar exp_thermo_fac,
+                             const Scalar *d_net_virial,
+                             unsigned int virial_pitch,
+                             Scalar *d_partial_sum)
     {
     // setup the grid to run the kernel
     unsigned int block_size=256;
     dim3 grid( (group_size / block_size) + 1, 1, 1);
     dim3 threads(block_size, 1, 1);
+    unsigned int shared_bytes = d_partial_sum ? 12*block_size*sizeof(Scalar) : 0;
 
     // run the kernel
-    gpu_npt_mtk_step_two_kernel<<< grid, threads >>>(d_vel,
+    gpu_npt_mtk_step_two_kernel<<< grid, threads, shared_bytes >>>(d_vel,
                                                      d_accel,
                                                      d_net_force,
                                                      d_group_members,
@@ -299,7 +381,120 @@ cudaError_t gpu_npt_mtk_step_two(Scalar4 *d_vel,
                                                      mat_exp_v[4],
                                                      mat_exp_v[5],
                                                      deltaT,
-                                                     exp_thermo_fac);
+                                                     exp_thermo_fac,
+                                                     d_net_virial,
+                                                     virial_pitch,
+                                                     d_partial_sum);
+
+    return cudaSuccess;
+    }
+
+//! Kernel to sum up the rotational kinetic energy at the half time step per block
+__global__ void gpu_npt_mtk_rotational_ke_kernel(const Scalar4 *d_orientation,
+                                                 const Scalar4 *d_angmom,
+                                                 const Scalar3 *d_inertia,
+                                                 unsigned int *d_group_members,
+                                                 unsigned int group_size,
+                                                 Scalar *d_partial_sum)
+    {
+    // determine which particle this thread works on
+    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    Scalar ke_rot(0.0);
+    if (group_idx < group_size)
+        {
+        unsigned int idx = d_group_members[group_idx];
+
+        vec3<Scalar> I(d_inertia[idx]);
+        quat<Scalar> q(d_orientation[idx]);
+        quat<Scalar> p(d_angmom[idx]);
+        quat<Scalar> s(Scalar(0.5)*conj(q)*p);
+
+        // only if the moment of inertia along one principal axis is non-zero, that axis carries angular momentum
+        if (I.x >= EPSILON) ke_rot += s.v.x*s.v.x/I.x;
+        if (I.y >= EPSILON) ke_rot += s.v.y*s.v.y/I.y;
+        if (I.z >= EPSILON) ke_rot += s.v.z*s.v.z/I.z;
+        }
+
+    npt_mtk_sdata[threadIdx.x] = ke_rot;
+    npt_mtk_block_reduce(1);
+
+    if (threadIdx.x == 0)
+        d_partial_sum[blockIdx.x*npt_mtk_sum::num_sums + npt_mtk_sum::ke_rot] = npt_mtk_sdata[0];
+    }
+
+/*! \param d_orientation array of particle orientations
+    \param d_angmom array of particle angular momenta
+    \param d_inertia array of particle moments of inertia
+    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param group_size Number of members in the group
+    \param d_partial_sum Partial sums, the npt_mtk_sum::ke_rot entry of every block is written
+
+    This is a driver for gpu_npt_mtk_rotational_ke_kernel(), which uses the same grid as gpu_npt_mtk_step_one().
+*/
+cudaError_t gpu_npt_mtk_rotational_ke(const Scalar4 *d_orientation,
+                             const Scalar4 *d_angmom,
+                             const Scalar3 *d_inertia,
+                             unsigned int *d_group_members,
+                             unsigned int group_size,
+                             Scalar *d_partial_sum)
+    {
+    // setup the grid to run the kernel
+    unsigned int block_size = 256;
+    dim3 grid( (group_size / block_size) + 1, 1, 1);
+    dim3 threads(block_size, 1, 1);
+
+    gpu_npt_mtk_rotational_ke_kernel<<< grid, threads, block_size*sizeof(Scalar) >>>(d_orientation,
+                                                                                      d_angmom,
+                                                                                      d_inertia,
+                                                                                      d_group_members,
+                                                                                      group_size,
+                                                                                      d_partial_sum);
+
+    return cudaSuccess;
+    }
+
+//! Kernel to reduce the partial sums of the fused thermo quantities, executed on a single block
+__global__ void gpu_npt_mtk_reduce_sums_kernel(Scalar *d_sum,
+                                               const Scalar *d_partial_sum,
+                                               unsigned int num_blocks,
+                                               unsigned int first,
+                                               unsigned int n)
+    {
+    for (unsigned int k = 0; k < n; k++)
+        {
+        Scalar sum(0.0);
+        for (unsigned int i = threadIdx.x; i < num_blocks; i += blockDim.x)
+            sum += d_partial_sum[i*npt_mtk_sum::num_sums + first + k];
+        npt_mtk_sdata[k*blockDim.x + threadIdx.x] = sum;
+        }
+    npt_mtk_block_reduce(n);
+
+    if (threadIdx.x < n)
+        d_sum[first + threadIdx.x] = npt_mtk_sdata[threadIdx.x*blockDim.x];
+    }
+
+/*! \param d_sum Total sums indexed by npt_mtk_sum (output)
+    \param d_partial_sum Partial sums, npt_mtk_sum::num_sums values per block
+    \param num_blocks Number of blocks of partial sums
+    \param first Index of the first sum to reduce
+    \param n Number of sums to reduce
+
+    This is a driver for gpu_npt_mtk_reduce_sums_kernel(), see it for details.
+*/
+cudaError_t gpu_npt_mtk_reduce_sums(Scalar *d_sum,
+                             const Scalar *d_partial_sum,
+                             unsigned int num_blocks,
+                             unsigned int first,
+                             unsigned int n)
+    {
+    const unsigned int block_size = 256;
+
+    gpu_npt_mtk_reduce_sums_kernel<<< 1, block_size, n*block_size*sizeof(Scalar) >>>(d_sum,
+                                                                                     d_partial_sum,
+                                                                                     num_blocks,
+                                                                                     first,
+                                                                                     n);
 
     return cudaSuccess;
     }
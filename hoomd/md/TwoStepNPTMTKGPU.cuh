@@ -11,6 +11,7 @@
 
 #include "hoomd/ParticleData.cuh"
 #include "hoomd/HOOMDMath.h"
+#include "TwoStepNPTMTKTypes.h"
 
 /*! \file TwoStepNPTMTKGPU.cuh
     \brief Declares GPU kernel code for NPT integration on the GPU using the Martyna-Tobias-Klein (MTK) equations. Used by TwoStepNPTMTKGPU.
@@ -27,7 +28,8 @@ cudaError_t gpu_npt_mtk_step_one(Scalar4 *d_pos,
                              Scalar *mat_exp_r,
                              Scalar *mat_exp_r_int,
                              Scalar deltaT,
-                             bool rescale_all);
+                             bool rescale_all,
+                             Scalar *d_partial_sum);
 
 //! Kernel driver for wrapping particles back in the box (part of first step)
 cudaError_t gpu_npt_mtk_wrap(const unsigned int N,
@@ -43,7 +45,25 @@ cudaError_t gpu_npt_mtk_step_two(Scalar4 *d_vel,
                              Scalar4 *d_net_force,
                              Scalar *mat_exp_v,
                              Scalar deltaT,
-                             Scalar exp_thermo_fac);
+                             Scalar exp_thermo_fac,
+                             const Scalar *d_net_virial,
+                             unsigned int virial_pitch,
+                             Scalar *d_partial_sum);
+
+//! Kernel driver for the partial sums of the rotational kinetic energy at the half time step
+cudaError_t gpu_npt_mtk_rotational_ke(const Scalar4 *d_orientation,
+                             const Scalar4 *d_angmom,
+                             const Scalar3 *d_inertia,
+                             unsigned int *d_group_members,
+                             unsigned int group_size,
+                             Scalar *d_partial_sum);
+
+//! Kernel driver for reducing the partial sums of the fused thermo quantities
+cudaError_t gpu_npt_mtk_reduce_sums(Scalar *d_sum,
+                             const Scalar *d_partial_sum,
+                             unsigned int num_blocks,
+                             unsigned int first,
+                             unsigned int n);
 
 //! Rescale all positions
 void gpu_npt_mtk_rescale(unsigned int N,
@@ -62,11 +62,14 @@ class PYBIND11_EXPORT TwoStepNPTMTKGPU : public TwoStepNPTMTK
         virtual void integrateStepTwo(unsigned int timestep);
 
     protected:
-        GPUArray<Scalar> m_scratch;     //!< Scratch space for reduction of squared velocities
-        GPUArray<Scalar> m_temperature; //!< Stores temperature after reduction step
+        GPUArray<Scalar> m_partial_sum; //!< Per-block partial sums of the fused thermo quantities
+        GPUArray<Scalar> m_sum;         //!< Total sums of the fused thermo quantities, indexed by npt_mtk_sum
 
-        unsigned int m_num_blocks;             //!< Number of blocks participating in the reduction
-        unsigned int m_reduction_block_size;   //!< Block size executed
+        //! Grow the partial sum array to the current group size
+        void resizePartialSums(unsigned int group_size);
+
+        //! Reduce a range of the partial sums and copy them to the host
+        void reducePartialSums(unsigned int group_size, unsigned int first, unsigned int n, double *sums);
     };
 
 //! Exports the TwoStepNPTMTKGPU class to python
@@ -0,0 +1,38 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// Maintainer: jglaser
+
+#ifndef __TWO_STEP_NPT_MTK_TYPES_H__
+#define __TWO_STEP_NPT_MTK_TYPES_H__
+
+/*! \file TwoStepNPTMTKTypes.h
+    \brief Data structures common to both CPU and GPU implementations of TwoStepNPTMTK
+*/
+
+//! Enum for indexing the sums that are reduced in the velocity updates when the thermo quantities are fused
+struct npt_mtk_sum
+    {
+    //! The enum
+    enum Enum
+        {
+        ke_trans=0,     //!< Sum of m v^2 at the half time step
+        ke_rot,         //!< Sum of the squared angular momenta over the moments of inertia at the half time step
+        kinetic_xx,     //!< Sum of m v_x v_x at the full time step
+        kinetic_xy,     //!< Sum of m v_x v_y at the full time step
+        kinetic_xz,     //!< Sum of m v_x v_z at the full time step
+        kinetic_yy,     //!< Sum of m v_y v_y at the full time step
+        kinetic_yz,     //!< Sum of m v_y v_z at the full time step
+        kinetic_zz,     //!< Sum of m v_z v_z at the full time step
+        virial_xx,      //!< xx component of the virial at the full time step
+        virial_xy,      //!< xy component of the virial at the full time step
+        virial_xz,      //!< xz component of the virial at the full time step
+        virial_yy,      //!< yy component of the virial at the full time step
+        virial_yz,      //!< yz component of the virial at the full time step
+        virial_zz,      //!< zz component of the virial at the full time step
+        num_sums        // final element to count number of sums
+        };
+    };
+
+#endif
@@ -39,6 +39,59 @@ TwoStepNVEGPU::TwoStepNVEGPU(std::shared_ptr<SystemDefinition> sysdef,
     m_tuner_two.reset(new Autotuner(valid_params, 5, 100000, "nve_step_two", this->m_exec_conf));
     }
 
+TwoStepNVEGPU::~TwoStepNVEGPU()
+    {
+    removeConstraint();
+    }
+
+/*! \param constraint Constraint to fuse into the second step
+
+    The constraint must be a ConstraintSphereGPU or a OneDConstraintGPU that acts on the group of this method. It
+    computes no forces of its own while it is fused.
+*/
+void TwoStepNVEGPU::setConstraint(std::shared_ptr<ForceConstraint> constraint)
+    {
+    std::shared_ptr<ConstraintSphereGPU> sphere = std::dynamic_pointer_cast<ConstraintSphereGPU>(constraint);
+    std::shared_ptr<OneDConstraintGPU> oned = std::dynamic_pointer_cast<OneDConstraintGPU>(constraint);
+
+    if (!sphere && !oned)
+        {
+        m_exec_conf->msg->error() << "integrate.nve: only constrain.sphere and constrain.oneD can be fused" << endl;
+        throw std::runtime_error("Error setting constraint in TwoStepNVEGPU");
+        }
+
+    std::shared_ptr<ParticleGroup> group = sphere ? sphere->getGroup() : oned->getGroup();
+    if (group != m_group)
+        {
+        m_exec_conf->msg->error() << "integrate.nve: the constraint must act on the group of the integration method"
+                                  << endl;
+        throw std::runtime_error("Error setting constraint in TwoStepNVEGPU");
+        }
+
+    if (constraint->isFused())
+        {
+        m_exec_conf->msg->error() << "integrate.nve: the constraint is already fused into an integration method"
+                                  << endl;
+        throw std::runtime_error("Error setting constraint in TwoStepNVEGPU");
+        }
+
+    removeConstraint();
+    m_constraint_sphere = sphere;
+    m_constraint_oned = oned;
+    constraint->setFused(true);
+    }
+
+void TwoStepNVEGPU::removeConstraint()
+    {
+    if (m_constraint_sphere)
+        m_constraint_sphere->setFused(false);
+    if (m_constraint_oned)
+        m_constraint_oned->setFused(false);
+
+    m_constraint_sphere.reset();
+    m_constraint_oned.reset();
+    }
+
 /*! \param timestep Current time step
     \post Particle positions are moved forward to timestep+1 and velocities to timestep+1/2 per the velocity verlet
           method.
@@ -118,28 +171,75 @@ void TwoStepNVEGPU::integrateStepTwo(unsigned int timestep)
     if (m_prof)
         m_prof->push(m_exec_conf, "NVE step 2");
 
-    ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
-    ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::readwrite);
-
-    ArrayHandle<Scalar4> d_net_force(net_force, access_location::device, access_mode::read);
-    ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
-
-    m_tuner_two->begin();
-    // perform the update on the GPU
-    gpu_nve_step_two(d_vel.data,
-                     d_accel.data,
-                     d_index_array.data,
-                     group_size,
-                     d_net_force.data,
-                     m_deltaT,
-                     m_limit,
-                     m_limit_val,
-                     m_zero_force,
-                     m_tuner_two->getParam());
-    m_tuner_two->end();
-
-    if(m_exec_conf->isCUDAErrorCheckingEnabled())
-        CHECK_CUDA_ERROR();
+    if (m_constraint_sphere || m_constraint_oned)
+        {
+        if (m_zero_force)
+            {
+            m_exec_conf->msg->error() << "integrate.nve: a fused constraint cannot be used with zero_force" << endl;
+            throw std::runtime_error("Error integrating TwoStepNVEGPU");
+            }
+
+        nve_constraint_params constraint;
+        constraint.type = m_constraint_sphere ? nve_constraint_sphere : nve_constraint_oned;
+        constraint.P = m_constraint_sphere ? m_constraint_sphere->getPosition() : make_scalar3(0,0,0);
+        constraint.r = m_constraint_sphere ? m_constraint_sphere->getRadius() : Scalar(0.0);
+        constraint.vec = m_constraint_oned ? m_constraint_oned->getVector() : make_scalar3(0,0,0);
+
+        const GlobalArray< Scalar >& net_virial = m_pdata->getNetVirial();
+
+        ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar4> d_pos(m_pdata->getPositions(), access_location::device, access_mode::read);
+
+        ArrayHandle<Scalar4> d_net_force(net_force, access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar> d_net_virial(net_virial, access_location::device, access_mode::readwrite);
+        ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
+
+        // the constraint force is evaluated in the same kernel
+        m_tuner_two->begin();
+        gpu_nve_step_two_constrained(d_vel.data,
+                                     d_accel.data,
+                                     d_pos.data,
+                                     d_index_array.data,
+                                     group_size,
+                                     d_net_force.data,
+                                     d_net_virial.data,
+                                     net_virial.getPitch(),
+                                     constraint,
+                                     m_deltaT,
+                                     m_limit,
+                                     m_limit_val,
+                                     m_tuner_two->getParam());
+        m_tuner_two->end();
+
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
+    else
+        {
+        ArrayHandle<Scalar4> d_vel(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+        ArrayHandle<Scalar3> d_accel(m_pdata->getAccelerations(), access_location::device, access_mode::readwrite);
+
+        ArrayHandle<Scalar4> d_net_force(net_force, access_location::device, access_mode::read);
+        ArrayHandle< unsigned int > d_index_array(m_group->getIndexArray(), access_location::device, access_mode::read);
+
+        m_tuner_two->begin();
+        // perform the update on the GPU
+        gpu_nve_step_two(d_vel.data,
+                         d_accel.data,
+                         d_index_array.data,
+                         group_size,
+                         d_net_force.data,
+                         m_deltaT,
+                         m_limit,
+                         m_limit_val,
+                         m_zero_force,
+                         m_tuner_two->getParam());
+        m_tuner_two->end();
+
+        if(m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
 
     if (m_aniso)
         {
@@ -171,5 +271,7 @@ void export_TwoStepNVEGPU(py::module& m)
     {
     py::class_<TwoStepNVEGPU, std::shared_ptr<TwoStepNVEGPU> >(m, "TwoStepNVEGPU", py::base<TwoStepNVE>())
     .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<ParticleGroup> >())
+    .def("setConstraint", &TwoStepNVEGPU::setConstraint)
+    .def("removeConstraint", &TwoStepNVEGPU::removeConstraint)
         ;
     }
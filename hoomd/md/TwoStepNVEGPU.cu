@@ -5,6 +5,8 @@
 // Maintainer: joaander
 
 #include "TwoStepNVEGPU.cuh"
+#include "EvaluatorConstraint.h"
+#include "EvaluatorConstraintSphere.h"
 #include "hoomd/VectorMath.h"
 
 #include <assert.h>
@@ -13,6 +15,66 @@
     \brief Defines GPU kernel code for NVE integration on the GPU. Used by TwoStepNVEGPU.
 */
 
+//! Velocity verlet first half step of a single particle
+/*! \param idx Index of the particle
+    See gpu_nve_step_one_kernel() for the other parameters.
+*/
+__device__ inline void nve_step_one_particle(unsigned int idx,
+                             Scalar4 *d_pos,
+                             Scalar4 *d_vel,
+                             const Scalar3 *d_accel,
+                             int3 *d_image,
+                             const BoxDim& box,
+                             Scalar deltaT,
+                             bool limit,
+                             Scalar limit_val,
+                             bool zero_force)
+    {
+    // do velocity verlet update
+    // r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
+    // v(t+deltaT/2) = v(t) + (1/2)a*deltaT
+
+    // read the particle's position (MEM TRANSFER: 16 bytes)
+    Scalar4 postype = d_pos[idx];
+    Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+
+    // read the particle's velocity and acceleration (MEM TRANSFER: 32 bytes)
+    Scalar4 velmass = d_vel[idx];
+    Scalar3 vel = make_scalar3(velmass.x, velmass.y, velmass.z);
+
+    Scalar3 accel = make_scalar3(Scalar(0.0), Scalar(0.0), Scalar(0.0));
+    if (!zero_force)
+        accel = d_accel[idx];
+
+    // update the position (FLOPS: 15)
+    Scalar3 dx = vel * deltaT + (Scalar(1.0)/Scalar(2.0)) * accel * deltaT * deltaT;
+
+    // limit the movement of the particles
+    if (limit)
+        {
+        Scalar len = sqrtf(dot(dx, dx));
+        if (len > limit_val)
+            dx = dx / len * limit_val;
+        }
+
+    // FLOPS: 3
+    pos += dx;
+
+    // update the velocity (FLOPS: 9)
+    vel += (Scalar(1.0)/Scalar(2.0)) * accel * deltaT;
+
+    // read in the particle's image (MEM TRANSFER: 16 bytes)
+    int3 image = d_image[idx];
+
+    // fix the periodic boundary conditions (FLOPS: 15)
+    box.wrap(pos, image);
+
+    // write out the results (MEM_TRANSFER: 48 bytes)
+    d_pos[idx] = make_scalar4(pos.x, pos.y, pos.z, postype.w);
+    d_vel[idx] = make_scalar4(vel.x, vel.y, vel.z, velmass.w);
+    d_image[idx] = image;
+    }
+
 //! Takes the first half-step forward in the velocity-verlet NVE integration on a group of particles
 /*! \param d_pos array of particle positions
     \param d_vel array of particle velocities
@@ -56,49 +118,7 @@ void gpu_nve_step_one_kernel(Scalar4 *d_pos,
         {
         unsigned int idx = d_group_members[group_idx];
 
-        // do velocity verlet update
-        // r(t+deltaT) = r(t) + v(t)*deltaT + (1/2)a(t)*deltaT^2
-        // v(t+deltaT/2) = v(t) + (1/2)a*deltaT
-
-        // read the particle's position (MEM TRANSFER: 16 bytes)
-        Scalar4 postype = d_pos[idx];
-        Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
-
-        // read the particle's velocity and acceleration (MEM TRANSFER: 32 bytes)
-        Scalar4 velmass = d_vel[idx];
-        Scalar3 vel = make_scalar3(velmass.x, velmass.y, velmass.z);
-
-        Scalar3 accel = make_scalar3(Scalar(0.0), Scalar(0.0), Scalar(0.0));
-        if (!zero_force)
-            accel = d_accel[idx];
-
-        // update the position (FLOPS: 15)
-        Scalar3 dx = vel * deltaT + (Scalar(1.0)/Scalar(2.0)) * accel * deltaT * deltaT;
-
-        // limit the movement of the particles
-        if (limit)
-            {
-            Scalar len = sqrtf(dot(dx, dx));
-            if (len > limit_val)
-                dx = dx / len * limit_val;
-            }
-
-        // FLOPS: 3
-        pos += dx;
-
-        // update the velocity (FLOPS: 9)
-        vel += (Scalar(1.0)/Scalar(2.0)) * accel * deltaT;
-
-        // read in the particle's image (MEM TRANSFER: 16 bytes)
-        int3 image = d_image[idx];
-
-        // fix the periodic boundary conditions (FLOPS: 15)
-        box.wrap(pos, image);
-
-        // write out the results (MEM_TRANSFER: 48 bytes)
-        d_pos[idx] = make_scalar4(pos.x, pos.y, pos.z, postype.w);
-        d_vel[idx] = make_scalar4(vel.x, vel.y, vel.z, velmass.w);
-        d_image[idx] = image;
+        nve_step_one_particle(idx, d_pos, d_vel, d_accel, d_image, box, deltaT, limit, limit_val, zero_force);
         }
     }
 
@@ -150,6 +170,114 @@ cudaError_t gpu_nve_step_one(Scalar4 *d_pos,
     return cudaSuccess;
     }
 
+//! NO_SQUISH angular part of the first half step of a single particle
+/*! \param idx Index of the particle
+    See gpu_nve_angular_step_one_kernel() for the other parameters.
+*/
+__device__ inline void nve_angular_step_one_particle(unsigned int idx,
+                             Scalar4 *d_orientation,
+                             Scalar4 *d_angmom,
+                             const Scalar3 *d_inertia,
+                             const Scalar4 *d_net_torque,
+                             Scalar deltaT,
+                             Scalar scale)
+    {
+    // read the particle's orientation, conjugate quaternion, moment of inertia and net torque
+    quat<Scalar> q(d_orientation[idx]);
+    quat<Scalar> p(d_angmom[idx]);
+    vec3<Scalar> t(d_net_torque[idx]);
+    vec3<Scalar> I(d_inertia[idx]);
+
+    // rotate torque into principal frame
+    t = rotate(conj(q),t);
+
+    // check for zero moment of inertia
+    bool x_zero, y_zero, z_zero;
+    x_zero = (I.x < Scalar(EPSILON)); y_zero = (I.y < Scalar(EPSILON)); z_zero = (I.z < Scalar(EPSILON));
+
+    // ignore torque component along an axis for which the moment of inertia zero
+    if (x_zero) t.x = Scalar(0.0);
+    if (y_zero) t.y = Scalar(0.0);
+    if (z_zero) t.z = Scalar(0.0);
+
+    // advance p(t)->p(t+deltaT/2), q(t)->q(t+deltaT)
+    p += deltaT*q*t;
+
+    p = p*scale;
+
+    quat<Scalar> p1, p2, p3; // permutated quaternions
+    quat<Scalar> q1, q2, q3;
+    Scalar phi1, cphi1, sphi1;
+    Scalar phi2, cphi2, sphi2;
+    Scalar phi3, cphi3, sphi3;
+
+    if (!z_zero)
+        {
+        p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
+        q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
+        phi3 = Scalar(1./4.)/I.z*dot(p,q3);
+        cphi3 = slow::cos(Scalar(1./2.)*deltaT*phi3);
+        sphi3 = slow::sin(Scalar(1./2.)*deltaT*phi3);
+
+        p=cphi3*p+sphi3*p3;
+        q=cphi3*q+sphi3*q3;
+        }
+
+    if (!y_zero)
+        {
+        p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
+        q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
+        phi2 = Scalar(1./4.)/I.y*dot(p,q2);
+        cphi2 = slow::cos(Scalar(1./2.)*deltaT*phi2);
+        sphi2 = slow::sin(Scalar(1./2.)*deltaT*phi2);
+
+        p=cphi2*p+sphi2*p2;
+        q=cphi2*q+sphi2*q2;
+        }
+
+    if (!x_zero)
+        {
+        p1 = quat<Scalar>(-p.v.x,vec3<Scalar>(p.s,p.v.z,-p.v.y));
+        q1 = quat<Scalar>(-q.v.x,vec3<Scalar>(q.s,q.v.z,-q.v.y));
+        phi1 = Scalar(1./4.)/I.x*dot(p,q1);
+        cphi1 = slow::cos(deltaT*phi1);
+        sphi1 = slow::sin(deltaT*phi1);
+
+        p=cphi1*p+sphi1*p1;
+        q=cphi1*q+sphi1*q1;
+        }
+
+    if (! y_zero)
+        {
+        p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
+        q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
+        phi2 = Scalar(1./4.)/I.y*dot(p,q2);
+        cphi2 = slow::cos(Scalar(1./2.)*deltaT*phi2);
+        sphi2 = slow::sin(Scalar(1./2.)*deltaT*phi2);
+
+        p=cphi2*p+sphi2*p2;
+        q=cphi2*q+sphi2*q2;
+        }
+
+    if (! z_zero)
+        {
+        p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
+        q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
+        phi3 = Scalar(1./4.)/I.z*dot(p,q3);
+        cphi3 = slow::cos(Scalar(1./2.)*deltaT*phi3);
+        sphi3 = slow::sin(Scalar(1./2.)*deltaT*phi3);
+
+        p=cphi3*p+sphi3*p3;
+        q=cphi3*q+sphi3*q3;
+        }
+
+    // renormalize (improves stability)
+    q = q*(Scalar(1.0)/slow::sqrt(norm2(q)));
+
+    d_orientation[idx] = quat_to_scalar4(q);
+    d_angmom[idx] = quat_to_scalar4(p);
+    }
+
 //! NO_SQUISH angular part of the first half step
 /*! \param d_orientation array of particle orientations
     \param d_angmom array of particle conjugate quaternions
@@ -175,132 +303,233 @@ __global__ void gpu_nve_angular_step_one_kernel(Scalar4 *d_orientation,
         {
         unsigned int idx = d_group_members[group_idx];
 
-        // read the particle's orientation, conjugate quaternion, moment of inertia and net torque
-        quat<Scalar> q(d_orientation[idx]);
-        quat<Scalar> p(d_angmom[idx]);
-        vec3<Scalar> t(d_net_torque[idx]);
-        vec3<Scalar> I(d_inertia[idx]);
-
-        // rotate torque into principal frame
-        t = rotate(conj(q),t);
+        nve_angular_step_one_particle(idx, d_orientation, d_angmom, d_inertia, d_net_torque, deltaT, scale);
+        }
+    }
 
-        // check for zero moment of inertia
-        bool x_zero, y_zero, z_zero;
-        x_zero = (I.x < Scalar(EPSILON)); y_zero = (I.y < Scalar(EPSILON)); z_zero = (I.z < Scalar(EPSILON));
+/*! \param d_orientation array of particle orientations
+    \param d_angmom array of particle conjugate quaternions
+    \param d_inertia array of moments of inertia
+    \param d_net_torque array of net torques
+    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param group_size Number of members in the group
+    \param deltaT timestep
+*/
+cudaError_t gpu_nve_angular_step_one(Scalar4 *d_orientation,
+                             Scalar4 *d_angmom,
+                             const Scalar3 *d_inertia,
+                             const Scalar4 *d_net_torque,
+                             unsigned int *d_group_members,
+                             unsigned int group_size,
+                             Scalar deltaT,
+                             Scalar scale)
+    {
+    // setup the grid to run the kernel
+    int block_size = 256;
+    dim3 grid( (group_size/block_size) + 1, 1, 1);
+    dim3 threads(block_size, 1, 1);
 
-        // ignore torque component along an axis for which the moment of inertia zero
-        if (x_zero) t.x = Scalar(0.0);
-        if (y_zero) t.y = Scalar(0.0);
-        if (z_zero) t.z = Scalar(0.0);
+    // run the kernel
+    gpu_nve_angular_step_one_kernel<<< grid, threads >>>(d_orientation, d_angmom, d_inertia, d_net_torque, d_group_members, group_size, deltaT, scale);
 
-        // advance p(t)->p(t+deltaT/2), q(t)->q(t+deltaT)
-        p += deltaT*q*t;
+    return cudaSuccess;
+    }
 
-        p = p*scale;
 
-        quat<Scalar> p1, p2, p3; // permutated quaternions
-        quat<Scalar> q1, q2, q3;
-        Scalar phi1, cphi1, sphi1;
-        Scalar phi2, cphi2, sphi2;
-        Scalar phi3, cphi3, sphi3;
+//! Takes the first half step of several integration methods at once
+/*! \param d_pos array of particle positions
+    \param d_vel array of particle velocities
+    \param d_accel array of particle accelerations
+    \param d_image array of particle images
+    \param d_orientation array of particle orientations
+    \param d_angmom array of particle conjugate quaternions
+    \param d_inertia array of moments of inertia
+    \param d_net_torque array of net torques
+    \param args Group members and parameters of the fused methods
+    \param box Box dimensions for periodic boundary condition handling
+    \param deltaT timestep
+    \param enforce2d Set to true to zero the z components of the velocity and acceleration before the update
 
-        if (!z_zero)
-            {
-            p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
-            q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
-            phi3 = Scalar(1./4.)/I.z*dot(p,q3);
-            cphi3 = slow::cos(Scalar(1./2.)*deltaT*phi3);
-            sphi3 = slow::sin(Scalar(1./2.)*deltaT*phi3);
-
-            p=cphi3*p+sphi3*p3;
-            q=cphi3*q+sphi3*q3;
-            }
+    The threads are assigned to the members of the methods in order, every thread determines the method of its
+    particle from the offsets in \a args and applies the translational, and if requested the angular, update with
+    the parameters of that method. It performs the same update as gpu_nve_step_one_kernel() followed by
+    gpu_nve_angular_step_one_kernel() per method, but in a single launch.
+*/
+__global__ void gpu_nve_fused_step_one_kernel(Scalar4 *d_pos,
+                             Scalar4 *d_vel,
+                             Scalar3 *d_accel,
+                             int3 *d_image,
+                             Scalar4 *d_orientation,
+                             Scalar4 *d_angmom,
+                             const Scalar3 *d_inertia,
+                             const Scalar4 *d_net_torque,
+                             const nve_fused_args_t args,
+                             BoxDim box,
+                             Scalar deltaT,
+                             bool enforce2d)
+    {
+    unsigned int work_idx = blockIdx.x * blockDim.x + threadIdx.x;
 
-        if (!y_zero)
-            {
-            p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
-            q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
-            phi2 = Scalar(1./4.)/I.y*dot(p,q2);
-            cphi2 = slow::cos(Scalar(1./2.)*deltaT*phi2);
-            sphi2 = slow::sin(Scalar(1./2.)*deltaT*phi2);
-
-            p=cphi2*p+sphi2*p2;
-            q=cphi2*q+sphi2*q2;
-            }
+    if (work_idx >= args.offset[args.n_methods])
+        return;
 
-        if (!x_zero)
-            {
-            p1 = quat<Scalar>(-p.v.x,vec3<Scalar>(p.s,p.v.z,-p.v.y));
-            q1 = quat<Scalar>(-q.v.x,vec3<Scalar>(q.s,q.v.z,-q.v.y));
-            phi1 = Scalar(1./4.)/I.x*dot(p,q1);
-            cphi1 = slow::cos(deltaT*phi1);
-            sphi1 = slow::sin(deltaT*phi1);
-
-            p=cphi1*p+sphi1*p1;
-            q=cphi1*q+sphi1*q1;
-            }
+    // find the method of this thread
+    unsigned int method = 0;
+    while (work_idx >= args.offset[method+1])
+        method++;
 
-        if (! y_zero)
-            {
-            p2 = quat<Scalar>(-p.v.y,vec3<Scalar>(-p.v.z,p.s,p.v.x));
-            q2 = quat<Scalar>(-q.v.y,vec3<Scalar>(-q.v.z,q.s,q.v.x));
-            phi2 = Scalar(1./4.)/I.y*dot(p,q2);
-            cphi2 = slow::cos(Scalar(1./2.)*deltaT*phi2);
-            sphi2 = slow::sin(Scalar(1./2.)*deltaT*phi2);
-
-            p=cphi2*p+sphi2*p2;
-            q=cphi2*q+sphi2*q2;
-            }
+    unsigned int idx = args.d_group_members[method][work_idx - args.offset[method]];
+    const nve_step_one_params& params = args.params[method];
 
-        if (! z_zero)
-            {
-            p3 = quat<Scalar>(-p.v.z,vec3<Scalar>(p.v.y,-p.v.x,p.s));
-            q3 = quat<Scalar>(-q.v.z,vec3<Scalar>(q.v.y,-q.v.x,q.s));
-            phi3 = Scalar(1./4.)/I.z*dot(p,q3);
-            cphi3 = slow::cos(Scalar(1./2.)*deltaT*phi3);
-            sphi3 = slow::sin(Scalar(1./2.)*deltaT*phi3);
-
-            p=cphi3*p+sphi3*p3;
-            q=cphi3*q+sphi3*q3;
-            }
+    if (enforce2d)
+        {
+        // same as gpu_enforce2d_kernel(), the kinetic energy computed after the step sees the planar velocity
+        d_vel[idx].z = Scalar(0.0);
+        d_accel[idx].z = Scalar(0.0);
+        }
 
-        // renormalize (improves stability)
-        q = q*(Scalar(1.0)/slow::sqrt(norm2(q)));
+    nve_step_one_particle(idx, d_pos, d_vel, d_accel, d_image, box, deltaT, params.limit, params.limit_val,
+        params.zero_force);
 
-        d_orientation[idx] = quat_to_scalar4(q);
-        d_angmom[idx] = quat_to_scalar4(p);
-        }
+    if (params.aniso)
+        nve_angular_step_one_particle(idx, d_orientation, d_angmom, d_inertia, d_net_torque, deltaT, Scalar(1.0));
     }
 
-/*! \param d_orientation array of particle orientations
+/*! \param d_pos array of particle positions
+    \param d_vel array of particle velocities
+    \param d_accel array of particle accelerations
+    \param d_image array of particle images
+    \param d_orientation array of particle orientations
     \param d_angmom array of particle conjugate quaternions
     \param d_inertia array of moments of inertia
     \param d_net_torque array of net torques
-    \param d_group_members Device array listing the indices of the members of the group to integrate
-    \param group_size Number of members in the group
+    \param args Group members and parameters of the fused methods
+    \param box Box dimensions for periodic boundary condition handling
     \param deltaT timestep
+    \param enforce2d Set to true to zero the z components of the velocity and acceleration before the update
+    \param block_size Number of threads per block
+
+    See gpu_nve_fused_step_one_kernel() for full documentation, this function is just a driver.
 */
-cudaError_t gpu_nve_angular_step_one(Scalar4 *d_orientation,
+cudaError_t gpu_nve_fused_step_one(Scalar4 *d_pos,
+                             Scalar4 *d_vel,
+                             Scalar3 *d_accel,
+                             int3 *d_image,
+                             Scalar4 *d_orientation,
                              Scalar4 *d_angmom,
                              const Scalar3 *d_inertia,
                              const Scalar4 *d_net_torque,
-                             unsigned int *d_group_members,
-                             unsigned int group_size,
+                             const nve_fused_args_t& args,
+                             const BoxDim& box,
                              Scalar deltaT,
-                             Scalar scale)
+                             bool enforce2d,
+                             unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)gpu_nve_fused_step_one_kernel);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+    unsigned int N = args.offset[args.n_methods];
+
+    // setup the grid to run the kernel
+    dim3 grid( (N/run_block_size) + 1, 1, 1);
+    dim3 threads(run_block_size, 1, 1);
+
+    // run the kernel
+    gpu_nve_fused_step_one_kernel<<< grid, threads >>>(d_pos, d_vel, d_accel, d_image, d_orientation, d_angmom,
+        d_inertia, d_net_torque, args, box, deltaT, enforce2d);
+
+    return cudaSuccess;
+    }
+
+//! Computes the largest squared speed and acceleration of the members of a group
+/*! \param d_max_vel_accel Largest squared speed (element 0) and acceleration (element 1), as the bits of floats
+    \param d_vel array of particle velocities
+    \param d_accel array of particle accelerations
+    \param d_group_members Device array listing the indices of the members of the group
+    \param group_size Number of members in the group
+
+    Non-negative floats are ordered like their bit patterns read as unsigned integers. Every block reduces its
+    members in shared memory and combines the result with an integer atomicMax, so that several groups can
+    accumulate into the same \a d_max_vel_accel, which must be zeroed before the first call. The block size must be
+    a power of two.
+*/
+extern "C" __global__
+void gpu_nve_max_vel_accel_kernel(unsigned int *d_max_vel_accel,
+                                  const Scalar4 *d_vel,
+                                  const Scalar3 *d_accel,
+                                  const unsigned int *d_group_members,
+                                  unsigned int group_size)
+    {
+    extern __shared__ float s_max[];
+    float *s_max_v2 = s_max;
+    float *s_max_a2 = s_max + blockDim.x;
+
+    unsigned int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    float v2 = 0.0f;
+    float a2 = 0.0f;
+    if (group_idx < group_size)
+        {
+        unsigned int idx = d_group_members[group_idx];
+        Scalar4 vel = d_vel[idx];
+        Scalar3 accel = d_accel[idx];
+        v2 = float(vel.x*vel.x + vel.y*vel.y + vel.z*vel.z);
+        a2 = float(accel.x*accel.x + accel.y*accel.y + accel.z*accel.z);
+        }
+    s_max_v2[threadIdx.x] = v2;
+    s_max_a2[threadIdx.x] = a2;
+    __syncthreads();
+
+    for (unsigned int offset = blockDim.x/2; offset > 0; offset /= 2)
+        {
+        if (threadIdx.x < offset)
+            {
+            s_max_v2[threadIdx.x] = fmaxf(s_max_v2[threadIdx.x], s_max_v2[threadIdx.x + offset]);
+            s_max_a2[threadIdx.x] = fmaxf(s_max_a2[threadIdx.x], s_max_a2[threadIdx.x + offset]);
+            }
+        __syncthreads();
+        }
+
+    if (threadIdx.x == 0)
+        {
+        atomicMax(&d_max_vel_accel[0], __float_as_uint(s_max_v2[0]));
+        atomicMax(&d_max_vel_accel[1], __float_as_uint(s_max_a2[0]));
+        }
+    }
+
+/*! \param d_max_vel_accel Largest squared speed and acceleration, as the bits of floats
+    \param d_vel array of particle velocities
+    \param d_accel array of particle accelerations
+    \param d_group_members Device array listing the indices of the members of the group
+    \param group_size Number of members in the group
+    \param block_size Number of threads per block, a power of two
+
+    See gpu_nve_max_vel_accel_kernel() for the details.
+*/
+cudaError_t gpu_nve_max_vel_accel(unsigned int *d_max_vel_accel,
+                             const Scalar4 *d_vel,
+                             const Scalar3 *d_accel,
+                             const unsigned int *d_group_members,
+                             unsigned int group_size,
+                             unsigned int block_size)
     {
     // setup the grid to run the kernel
-    int block_size = 256;
     dim3 grid( (group_size/block_size) + 1, 1, 1);
     dim3 threads(block_size, 1, 1);
 
     // run the kernel
-    gpu_nve_angular_step_one_kernel<<< grid, threads >>>(d_orientation, d_angmom, d_inertia, d_net_torque, d_group_members, group_size, deltaT, scale);
+    gpu_nve_max_vel_accel_kernel<<< grid, threads, 2*block_size*sizeof(float) >>>(d_max_vel_accel,
+        d_vel, d_accel, d_group_members, group_size);
 
     return cudaSuccess;
     }
 
-
 //! Takes the second half-step forward in the velocity-verlet NVE integration on a group of particles
 /*! \param d_vel array of particle velocities
     \param d_accel array of particle accelerations
@@ -428,6 +657,232 @@ cudaError_t gpu_nve_step_two(Scalar4 *d_vel,
     return cudaSuccess;
     }
 
+//! Constraint policy that keeps the particles on the surface of a sphere
+struct nve_constraint_policy_sphere
+    {
+    //! Constructor
+    __device__ nve_constraint_policy_sphere(const nve_constraint_params& params)
+        : sphere(params.P, params.r)
+        {
+        }
+
+    //! Find the constrained position
+    /*! \param U Unconstrained position at the next step
+        \param X Current position
+    */
+    __device__ Scalar3 evalClosest(const Scalar3& U, const Scalar3& X)
+        {
+        return sphere.evalClosest(U);
+        }
+
+    EvaluatorConstraintSphere sphere; //!< Evaluator of the sphere constraint
+    };
+
+//! Constraint policy that lets the particles move only along a vector
+struct nve_constraint_policy_oned
+    {
+    //! Constructor
+    __device__ nve_constraint_policy_oned(const nve_constraint_params& params)
+        : vec(params.vec)
+        {
+        }
+
+    //! Find the constrained position
+    /*! \param U Unconstrained position at the next step
+        \param X Current position
+    */
+    __device__ Scalar3 evalClosest(const Scalar3& U, const Scalar3& X)
+        {
+        Scalar3 D = U - X;
+        Scalar n = dot(D, vec)/dot(vec, vec);
+        return X + n*vec;
+        }
+
+    Scalar3 vec; //!< Vector along which the particles move
+    };
+
+//! Takes the second half-step forward in the velocity-verlet NVE integration and applies a constraint force
+/*! \param d_vel array of particle velocities
+    \param d_accel array of particle accelerations
+    \param d_pos array of particle positions
+    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param group_size Number of members in the group
+    \param d_net_force Net force on each particle, the constraint force is added to it
+    \param d_net_virial Net virial on each particle, the constraint virial is added to it
+    \param net_virial_pitch Pitch of the net virial array
+    \param params Parameters of the constraint
+    \param deltaT Amount of real time to step forward in one time step
+    \param limit If \a limit is true, then the dynamics will be limited so that particles do not move
+        a distance further than \a limit_val in one step.
+    \param limit_val Length to limit particle distance movement to
+
+    \tparam Constraint Policy that evaluates the constrained position of a particle
+
+    The constraint force is evaluated from the unconstrained net force in the same way as ConstraintSphereGPU and
+    OneDConstraintGPU do, and is added to the net force and virial so that the pressure and the first step of the
+    next time step see the same values as without fusion.
+*/
+template<class Constraint>
+__global__ void gpu_nve_step_two_constrained_kernel(
+                            Scalar4 *d_vel,
+                            Scalar3 *d_accel,
+                            const Scalar4 *d_pos,
+                            unsigned int *d_group_members,
+                            unsigned int group_size,
+                            Scalar4 *d_net_force,
+                            Scalar *d_net_virial,
+                            unsigned int net_virial_pitch,
+                            const nve_constraint_params params,
+                            Scalar deltaT,
+                            bool limit,
+                            Scalar limit_val)
+    {
+    // determine which particle this thread works on
+    int group_idx = blockIdx.x * blockDim.x + threadIdx.x;
+
+    if (group_idx < group_size)
+        {
+        unsigned int idx = d_group_members[group_idx];
+
+        Scalar4 pos = d_pos[idx];
+        Scalar4 vel = d_vel[idx];
+        Scalar4 net_force = d_net_force[idx];
+        Scalar mass = vel.w;
+
+        Scalar3 X = make_scalar3(pos.x, pos.y, pos.z);
+        Scalar3 V = make_scalar3(vel.x, vel.y, vel.z);
+        Scalar3 F = make_scalar3(net_force.x, net_force.y, net_force.z);
+
+        // evaluate the constraint force from the unconstrained net force
+        EvaluatorConstraint constraint(X, V, F, mass, deltaT);
+        Constraint policy(params);
+        Scalar3 C = policy.evalClosest(constraint.evalU(), X);
+
+        Scalar3 FC;
+        Scalar virial[6];
+        constraint.evalConstraintForce(FC, virial, C);
+
+        // add it to the net force and virial
+        net_force.x += FC.x;
+        net_force.y += FC.y;
+        net_force.z += FC.z;
+        d_net_force[idx] = net_force;
+        for (unsigned int k = 0; k < 6; k++)
+            d_net_virial[k*net_virial_pitch+idx] += virial[k];
+
+        Scalar3 accel = (F + FC)/mass;
+
+        // v(t+deltaT) = v(t+deltaT/2) + 1/2 * a(t+deltaT)*deltaT
+        vel.x += (Scalar(1.0)/Scalar(2.0)) * accel.x * deltaT;
+        vel.y += (Scalar(1.0)/Scalar(2.0)) * accel.y * deltaT;
+        vel.z += (Scalar(1.0)/Scalar(2.0)) * accel.z * deltaT;
+
+        if (limit)
+            {
+            Scalar vel_len = sqrtf(vel.x*vel.x + vel.y*vel.y + vel.z*vel.z);
+            if ( (vel_len*deltaT) > limit_val)
+                {
+                vel.x = vel.x / vel_len * limit_val / deltaT;
+                vel.y = vel.y / vel_len * limit_val / deltaT;
+                vel.z = vel.z / vel_len * limit_val / deltaT;
+                }
+            }
+
+        d_vel[idx] = vel;
+        d_accel[idx] = accel;
+        }
+    }
+
+//! Launch the constrained second step with a given constraint policy
+/*! See gpu_nve_step_two_constrained() for the parameters.
+*/
+template<class Constraint>
+void gpu_nve_step_two_constrained_launch(Scalar4 *d_vel,
+                             Scalar3 *d_accel,
+                             const Scalar4 *d_pos,
+                             unsigned int *d_group_members,
+                             unsigned int group_size,
+                             Scalar4 *d_net_force,
+                             Scalar *d_net_virial,
+                             unsigned int net_virial_pitch,
+                             const nve_constraint_params& params,
+                             Scalar deltaT,
+                             bool limit,
+                             Scalar limit_val,
+                             unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void *)gpu_nve_step_two_constrained_kernel<Constraint>);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+
+    dim3 grid( (group_size/run_block_size) + 1, 1, 1);
+    dim3 threads(run_block_size, 1, 1);
+
+    gpu_nve_step_two_constrained_kernel<Constraint><<< grid, threads >>>(d_vel,
+                                                 d_accel,
+                                                 d_pos,
+                                                 d_group_members,
+                                                 group_size,
+                                                 d_net_force,
+                                                 d_net_virial,
+                                                 net_virial_pitch,
+                                                 params,
+                                                 deltaT,
+                                                 limit,
+                                                 limit_val);
+    }
+
+/*! \param d_vel array of particle velocities
+    \param d_accel array of particle accelerations
+    \param d_pos array of particle positions
+    \param d_group_members Device array listing the indices of the members of the group to integrate
+    \param group_size Number of members in the group
+    \param d_net_force Net force on each particle
+    \param d_net_virial Net virial on each particle
+    \param net_virial_pitch Pitch of the net virial array
+    \param constraint Parameters of the fused constraint
+    \param deltaT Amount of real time to step forward in one time step
+    \param limit If \a limit is true, then the dynamics will be limited so that particles do not move
+        a distance further than \a limit_val in one step.
+    \param limit_val Length to limit particle distance movement to
+    \param block_size Block size to execute on the GPU
+
+    This is just a driver for gpu_nve_step_two_constrained_kernel(), see it for details.
+*/
+cudaError_t gpu_nve_step_two_constrained(Scalar4 *d_vel,
+                             Scalar3 *d_accel,
+                             const Scalar4 *d_pos,
+                             unsigned int *d_group_members,
+                             unsigned int group_size,
+                             Scalar4 *d_net_force,
+                             Scalar *d_net_virial,
+                             unsigned int net_virial_pitch,
+                             const nve_constraint_params& constraint,
+                             Scalar deltaT,
+                             bool limit,
+                             Scalar limit_val,
+                             unsigned int block_size)
+    {
+    if (constraint.type == nve_constraint_sphere)
+        {
+        gpu_nve_step_two_constrained_launch<nve_constraint_policy_sphere>(d_vel, d_accel, d_pos, d_group_members,
+            group_size, d_net_force, d_net_virial, net_virial_pitch, constraint, deltaT, limit, limit_val, block_size);
+        }
+    else if (constraint.type == nve_constraint_oned)
+        {
+        gpu_nve_step_two_constrained_launch<nve_constraint_policy_oned>(d_vel, d_accel, d_pos, d_group_members,
+            group_size, d_net_force, d_net_virial, net_virial_pitch, constraint, deltaT, limit, limit_val, block_size);
+        }
+
+    return cudaSuccess;
+    }
+
 //! NO_SQUISH angular part of the second half step
 /*! \param d_orientation array of particle orientations
     \param d_angmom array of particle conjugate quaternions
@@ -14,6 +14,45 @@
 #ifndef __TWO_STEP_NVE_GPU_CUH__
 #define __TWO_STEP_NVE_GPU_CUH__
 
+//! Maximum number of integration methods in a fused first step
+const unsigned int NVE_FUSED_MAX_METHODS = 8;
+
+//! Parameters of the velocity Verlet first step of one integration method
+struct nve_step_one_params
+    {
+    Scalar limit_val;   //!< Length to limit particle distance movement to
+    bool limit;         //!< True if the distance a particle moves in one step is limited
+    bool zero_force;    //!< True if the accelerations are ignored
+    bool aniso;         //!< True if the rotational degrees of freedom are integrated
+    };
+
+//! Arguments of the fused first step of several integration methods
+/*! The members of method m are handled by the threads offset[m] to offset[m+1]-1.
+*/
+struct nve_fused_args_t
+    {
+    unsigned int n_methods;                                 //!< Number of fused methods
+    unsigned int *d_group_members[NVE_FUSED_MAX_METHODS];   //!< Group members of every method
+    unsigned int offset[NVE_FUSED_MAX_METHODS+1];           //!< First thread of every method
+    nve_step_one_params params[NVE_FUSED_MAX_METHODS];      //!< Parameters of every method
+    };
+
+//! Constraints that can be fused into the second step of the NVE update
+enum nve_constraint_type
+    {
+    nve_constraint_sphere = 0,  //!< Constrain the particles to the surface of a sphere
+    nve_constraint_oned         //!< Constrain the particles to move along a vector
+    };
+
+//! Parameters of a constraint fused into the second step of the NVE update
+struct nve_constraint_params
+    {
+    unsigned int type;  //!< The nve_constraint_type of the constraint
+    Scalar3 P;          //!< Position of the sphere
+    Scalar r;           //!< Radius of the sphere
+    Scalar3 vec;        //!< Vector along which the particles move
+    };
+
 //! Kernel driver for the first part of the NVE update called by TwoStepNVEGPU
 cudaError_t gpu_nve_step_one(Scalar4 *d_pos,
                              Scalar4 *d_vel,
@@ -28,6 +67,29 @@ cudaError_t gpu_nve_step_one(Scalar4 *d_pos,
                              bool zero_force,
                              unsigned int block_size);
 
+//! Kernel driver for the first part of the NVE update of several methods called by IntegratorTwoStep
+cudaError_t gpu_nve_fused_step_one(Scalar4 *d_pos,
+                             Scalar4 *d_vel,
+                             Scalar3 *d_accel,
+                             int3 *d_image,
+                             Scalar4 *d_orientation,
+                             Scalar4 *d_angmom,
+                             const Scalar3 *d_inertia,
+                             const Scalar4 *d_net_torque,
+                             const nve_fused_args_t& args,
+                             const BoxDim& box,
+                             Scalar deltaT,
+                             bool enforce2d,
+                             unsigned int block_size);
+
+//! Kernel driver for the largest squared speed and acceleration of a group called by IntegratorTwoStep
+cudaError_t gpu_nve_max_vel_accel(unsigned int *d_max_vel_accel,
+                             const Scalar4 *d_vel,
+                             const Scalar3 *d_accel,
+                             const unsigned int *d_group_members,
+                             unsigned int group_size,
+                             unsigned int block_size);
+
 //! Kernel driver for the second part of the NVE update called by TwoStepNVEGPU
 cudaError_t gpu_nve_step_two(Scalar4 *d_vel,
                              Scalar3 *d_accel,
@@ -40,6 +102,21 @@ cudaError_t gpu_nve_step_two(Scalar4 *d_vel,
                              bool zero_force,
                              unsigned int block_size);
 
+//! Kernel driver for the second part of the NVE update with a fused constraint called by TwoStepNVEGPU
+cudaError_t gpu_nve_step_two_constrained(Scalar4 *d_vel,
+                             Scalar3 *d_accel,
+                             const Scalar4 *d_pos,
+                             unsigned int *d_group_members,
+                             unsigned int group_size,
+                             Scalar4 *d_net_force,
+                             Scalar *d_net_virial,
+                             unsigned int net_virial_pitch,
+                             const nve_constraint_params& constraint,
+                             Scalar deltaT,
+                             bool limit,
+                             Scalar limit_val,
+                             unsigned int block_size);
+
 //! Kernel driver for the first part of the angular NVE update (NO_SQUISH) by TwoStepNVEPU
 cudaError_t gpu_nve_angular_step_one(Scalar4 *d_orientation,
                              Scalar4 *d_angmom,
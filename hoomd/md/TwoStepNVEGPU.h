@@ -5,6 +5,8 @@
 // Maintainer: joaander
 
 #include "TwoStepNVE.h"
+#include "ConstraintSphereGPU.h"
+#include "OneDConstraintGPU.h"
 
 #ifndef __TWO_STEP_NVE_GPU_H__
 #define __TWO_STEP_NVE_GPU_H__
@@ -24,6 +26,10 @@
 //! Integrates part of the system forward in two steps in the NVE ensemble on the GPU
 /*! Implements velocity-verlet NVE integration through the IntegrationMethodTwoStep interface, runs on the GPU
 
+    A ConstraintSphereGPU or OneDConstraintGPU on the same group can be fused into the second step with
+    setConstraint(). The constraint force is then evaluated by the second step kernel and added to the net force,
+    instead of being computed in its own kernel and summed into the net force by the Integrator.
+
     \ingroup updaters
 */
 class PYBIND11_EXPORT TwoStepNVEGPU : public TwoStepNVE
@@ -31,7 +37,7 @@ class PYBIND11_EXPORT TwoStepNVEGPU : public TwoStepNVE
     public:
         //! Constructs the integration method and associates it with the system
         TwoStepNVEGPU(std::shared_ptr<SystemDefinition> sysdef, std::shared_ptr<ParticleGroup> group);
-        virtual ~TwoStepNVEGPU() {};
+        virtual ~TwoStepNVEGPU();
 
         //! Performs the first step of the integration
         virtual void integrateStepOne(unsigned int timestep);
@@ -39,6 +45,25 @@ class PYBIND11_EXPORT TwoStepNVEGPU : public TwoStepNVE
         //! Performs the second step of the integration
         virtual void integrateStepTwo(unsigned int timestep);
 
+        //! Fuse a constraint into the second step
+        void setConstraint(std::shared_ptr<ForceConstraint> constraint);
+
+        //! Stop fusing the constraint into the second step
+        void removeConstraint();
+
+        //! Get the parameters of the first step for a fused update
+        /*! \param params Set to the parameters of the first step
+            \returns true
+        */
+        virtual bool getFusedStepOneParams(nve_step_one_params& params)
+            {
+            params.limit_val = m_limit_val;
+            params.limit = m_limit;
+            params.zero_force = m_zero_force;
+            params.aniso = m_aniso;
+            return true;
+            }
+
         //! Set autotuner parameters
         /*! \param enable Enable/disable autotuning
             \param period period (approximate) in time steps when returning occurs
@@ -55,6 +80,9 @@ class PYBIND11_EXPORT TwoStepNVEGPU : public TwoStepNVE
     private:
         std::unique_ptr<Autotuner> m_tuner_one; //!< Autotuner for block size (step one kernel)
         std::unique_ptr<Autotuner> m_tuner_two; //!< Autotuner for block size (step two kernel)
+
+        std::shared_ptr<ConstraintSphereGPU> m_constraint_sphere; //!< Sphere constraint fused into the second step
+        std::shared_ptr<OneDConstraintGPU> m_constraint_oned;     //!< 1D constraint fused into the second step
     };
 
 //! Exports the TwoStepNVEGPU class to python
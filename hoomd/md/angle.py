@@ -238,6 +238,30 @@ class harmonic(force._force):
 
         self.required_coeffs = ['k', 't0'];
 
+    def set_params(self, group_centric=None):
+        R""" Set parameters of the angle evaluation.
+
+        Args:
+            group_centric (bool): (if set) When True, evaluate every angle once on the GPU (GPU only)
+
+        With *group_centric*, every angle is evaluated once by one thread instead of once per member, and the
+        forces are added to the three members with atomic operations that are combined within a warp. This option is
+        ignored on the CPU.
+
+        Examples::
+
+            harmonic.set_params(group_centric=True)
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+
+        if group_centric is not None:
+            if hoomd.context.exec_conf.isCUDAEnabled():
+                self.cpp_force.setGroupCentric(group_centric);
+            else:
+                hoomd.context.msg.notice(2, "angle.harmonic: group_centric is only supported on the GPU, ignoring\n");
+
     ## \internal
     # \brief Update coefficients in C++
     def update_coeffs(self):
@@ -469,6 +493,31 @@ class table(force._force):
         # pass the tables on to the underlying cpp compute
         self.cpp_force.setTable(atype, Vtable, Ttable);
 
+    def set_params(self, interpolation=None):
+        R""" Set parameters of the table evaluation.
+
+        Args:
+            interpolation (str): (if set) Interpolation of the table, either 'linear' or 'cubic'
+
+        By default, the potential and torque are interpolated linearly between the table points, which needs fine
+        tables for accurate forces. With ``interpolation='cubic'``, every interval is evaluated with the cubic
+        Hermite polynomial that matches *V* and *T* at both of its ends. The torque is then the exact derivative of the
+        interpolated potential, and coarser tables reach the same accuracy, which also keeps the tables of many
+        angle types in cache.
+
+        Examples::
+
+            atable.set_params(interpolation='cubic')
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+
+        if interpolation is not None:
+            if interpolation not in ('linear', 'cubic'):
+                hoomd.context.msg.error("angle.table: interpolation must be 'linear' or 'cubic'\n");
+                raise RuntimeError("Error setting angle.table parameters");
+            self.cpp_force.setCubicInterpolation(interpolation == 'cubic');
 
     def update_coeffs(self):
         # check that the angle coefficients are valid
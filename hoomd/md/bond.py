@@ -240,6 +240,32 @@ class _bond(force._force):
             param = self.process_coeff(coeff_dict);
             self.cpp_force.setParams(i, param);
 
+    def set_params(self, group_centric=None):
+        R""" Set parameters of the bond evaluation.
+
+        Args:
+            group_centric (bool): (if set) When True, evaluate every bond once on the GPU (GPU only)
+
+        By default, the GPU evaluates the bonds of every particle in a separate thread, so each bond is evaluated by
+        both of its members. With *group_centric*, every bond is evaluated once by one thread, which adds the forces
+        on both members with atomic operations that are combined within a warp. The bonds are ordered by the
+        particle order, so this works best when the particles are sorted (the default). This option is ignored on
+        the CPU.
+
+        Examples::
+
+            harmonic.set_params(group_centric=True)
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+
+        if group_centric is not None:
+            if hoomd.context.exec_conf.isCUDAEnabled():
+                self.cpp_force.setGroupCentric(group_centric);
+            else:
+                hoomd.context.msg.notice(2, "bond: group_centric is only supported on the GPU, ignoring\n");
+
     ## \internal
     # \brief Get metadata
     def get_metadata(self):
@@ -495,6 +521,30 @@ class table(force._force):
         # pass the tables on to the underlying cpp compute
         self.cpp_force.setTable(btype, Vtable, Ftable, rmin, rmax);
 
+    def set_params(self, interpolation=None):
+        R""" Set parameters of the table evaluation.
+
+        Args:
+            interpolation (str): (if set) Interpolation of the table, either 'linear' or 'cubic'
+
+        By default, the potential and force are interpolated linearly between the table points, which needs fine
+        tables for accurate forces. With ``interpolation='cubic'``, every interval is evaluated with the cubic
+        Hermite polynomial that matches *V* and *F* at both of its ends. The force is then the exact derivative of the
+        interpolated potential, and coarser tables reach the same accuracy.
+
+        Examples::
+
+            btable.set_params(interpolation='cubic')
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+
+        if interpolation is not None:
+            if interpolation not in ('linear', 'cubic'):
+                hoomd.context.msg.error("bond.table: interpolation must be 'linear' or 'cubic'\n");
+                raise RuntimeError("Error setting bond.table parameters");
+            self.cpp_force.setCubicInterpolation(interpolation == 'cubic');
 
     def update_coeffs(self):
         # check that the bond coefficients are valid
@@ -57,10 +57,17 @@ class pppm(force._force):
     - :math:`r_{\mathrm{cut}}` - Cutoff for the short-ranged part of the electrostatics calculation
 
     Parameters Nx, Ny, Nz, order, :math:`r_{\mathrm{cut}}` must be set using
-    :py:meth:`set_params()` before any :py:func:`hoomd.run()` can take place.
+    :py:meth:`set_params()` before any :py:func:`hoomd.run()` can take place, or chosen for a target accuracy by
+    :py:meth:`tune()`.
 
     See :ref:`page-units` for information on the units assigned to charges in hoomd.
 
+    The charge and force meshes and their Fourier transforms are stored in single precision, while forces,
+    energies and virials are accumulated in double precision (unless hoomd is built with ``SINGLE_PRECISION``).
+    Single precision meshes support the accuracies PPPM is typically run at (relative force errors of about
+    :math:`10^{-4}`). The estimated RMS force
+    error of the chosen parameters is available to :py:class:`hoomd.analyze.log` as ``pppm_rms_error``.
+
     Note:
           :py:class:`pppm` takes a particle group as an option. This should be the group of all charged particles
           (:py:func:`hoomd.group.charged`). However, note that this group is static and determined at the time
@@ -113,6 +120,10 @@ class pppm(force._force):
         # error check flag - must be set to true by set_params in order for the run() to commence
         self.params_set = False;
 
+        # parameters that tune() keeps from the last set_params()
+        self.alpha = 0.0;
+        self.erfc_tol = 0.0;
+
         # initialize the short range part of electrostatics
         hoomd.util.quiet_status();
         self.ewald = pair.ewald(r_cut = False, nlist = self.nlist);
@@ -135,7 +146,7 @@ class pppm(force._force):
         self.ewald.enable();
         hoomd.util.unquiet_status();
 
-    def set_params(self, Nx, Ny, Nz, order, rcut, alpha = 0.0):
+    def set_params(self, Nx, Ny, Nz, order, rcut, alpha = 0.0, erfc_tol = 0.0, fft_backend = None):
         """ Sets PPPM parameters.
 
         Args:
@@ -146,10 +157,20 @@ class pppm(force._force):
             rcut  (float): Cutoff for the short-ranged part of the electrostatics calculation
             alpha (float, **optional**): Debye screening parameter (in units 1/distance)
                 .. versionadded:: 2.1
+            erfc_tol (float, **optional**): Largest acceptable absolute error of erfc in the short-ranged part, see
+                :py:class:`hoomd.md.pair.ewald`. The default of 0 evaluates erfc exactly.
+                .. versionadded:: 2.5
+            fft_backend (str, **optional**): **CPU only**: Library for the FFT of the mesh on a single rank, ``'kiss'``
+                for the bundled kiss_fft, ``'fftw'`` for FFTW3 (threaded with the number of TBB threads), or ``'auto'``
+                (the default) to use FFTW when HOOMD is compiled with ``ENABLE_FFTW``. Link FFTW against the FFTW3
+                interface of MKL to use MKL. With domain decomposition, the distributed FFT uses the local FFT library
+                that dfftlib is built with.
+                .. versionadded:: 2.5
 
         Examples::
 
             pppm.set_params(Nx=64, Ny=64, Nz=64, order=6, rcut=2.0)
+            pppm.set_params(Nx=64, Ny=64, Nz=64, order=6, rcut=2.0, erfc_tol=1e-6)
 
         Note that the Fourier transforms are much faster for number of grid points of the form 2^N.
         """
@@ -160,6 +181,8 @@ class pppm(force._force):
             raise RuntimeError("Cannot compute PPPM");
 
         self.params_set = True;
+        self.alpha = alpha;
+        self.erfc_tol = erfc_tol;
 
         # get sum of charges and of squared charges
         q = self.cpp_force.getQSum();
@@ -214,12 +237,139 @@ class pppm(force._force):
         hoomd.util.quiet_status();
         for i in range(0,ntypes):
             for j in range(0,ntypes):
-                self.ewald.pair_coeff.set(type_list[i], type_list[j], kappa = kappa, alpha = alpha, r_cut=rcut)
+                self.ewald.pair_coeff.set(type_list[i], type_list[j], kappa = kappa, alpha = alpha, r_cut=rcut, erfc_tol = erfc_tol)
         hoomd.util.unquiet_status();
 
+        if fft_backend is not None and not hoomd.context.exec_conf.isCUDAEnabled():
+            self.cpp_force.setFFTBackend(fft_backend);
+
         # set the parameters for the appropriate type
         self.cpp_force.setParams(Nx, Ny, Nz, order, kappa, rcut, alpha);
 
+    def tune(self, accuracy, rcut, order=[4, 5, 6, 7], warmup=1000, steps=500, max_mesh=512, quiet=True):
+        R""" Make a series of short runs to determine the fastest parameters for a given accuracy.
+
+        Args:
+            accuracy (float): Largest acceptable estimated RMS force error
+            rcut (list): Cutoffs of the short-ranged part to test
+            order (list): Assignment orders to test
+            warmup (int): Number of time steps to run() to warm up the benchmark
+            steps (int): Number of time steps to run() for each configuration
+            max_mesh (int): Largest number of grid points along a direction to test
+            quiet (bool): Quiet the individual run() calls.
+
+        For every combination of *rcut* and *order*, :py:meth:`tune()` picks the splitting parameter at which the
+        estimated error of the short-ranged part equals *accuracy*, and then the smallest number of grid points along
+        every direction for which the estimated error of the mesh part stays below *accuracy*. These are the same
+        estimates that :py:meth:`set_params()` balances and that are logged as ``pppm_rms_error``, so every
+        configuration reaches the requested accuracy. The grid sizes are products of powers of 2, 3 and 5, or powers of
+        two that are multiples of the number of domains in MPI simulations. Configurations that need more than
+        *max_mesh* grid points along a direction are skipped.
+
+        :py:meth:`tune()` executes *warmup* time steps with the first configuration. Each configuration is then set
+        with :py:meth:`set_params()` and runs for *steps* time steps 3 times, and the median TPS value is recorded. The
+        fastest configuration is left set for further :py:func:`hoomd.run()` calls. The *alpha* and *erfc_tol*
+        parameters of the last :py:meth:`set_params()` call are kept. In total, ``(warmup + 3*n*steps)`` time steps are
+        run for *n* configurations.
+
+        The balance between the short-ranged part and the mesh depends on the hardware and the number of ranks, run
+        :py:meth:`tune()` on the resources of the production run.
+
+        Returns:
+            (Nx, Ny, Nz, order, rcut) of the fastest configuration
+
+        Example::
+
+            pppm.tune(accuracy=1e-4, rcut=[2.0, 2.5, 3.0, 3.5])
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+
+        # check if initialization has occurred
+        if not hoomd.init.is_initialized():
+            hoomd.context.msg.error("Cannot tune PPPM before initialization\n");
+            raise RuntimeError('Error tuning PPPM');
+
+        if hoomd.context.current.system_definition.getNDimensions() != 3:
+            hoomd.context.msg.error("System must be 3 dimensional\n");
+            raise RuntimeError("Cannot compute PPPM");
+
+        q2 = self.cpp_force.getQ2Sum();
+        if q2 == 0.0:
+            hoomd.context.msg.error("charge.pppm: cannot tune PPPM without charges\n");
+            raise RuntimeError('Error tuning PPPM');
+
+        N = hoomd.context.current.system_definition.getParticleData().getNGlobal()
+        box = hoomd.context.current.system_definition.getParticleData().getGlobalBox()
+        L = [box.getL().x, box.getL().y, box.getL().z]
+        V = L[0]*L[1]*L[2]
+
+        # mesh sizes along every direction
+        sizes = [];
+        decomposition = hoomd.context.current.system_definition.getParticleData().getDomainDecomposition();
+        for d in range(3):
+            if decomposition is not None:
+                ndomains = len(decomposition.getCumulativeFractions(d)) - 1;
+                sizes.append([n for n in _pow2_sizes(max_mesh) if n % ndomains == 0]);
+            else:
+                sizes.append(_fft_sizes(max_mesh));
+
+        # find the smallest mesh that reaches the accuracy for every configuration
+        candidates = [];
+        for cur_rcut in rcut:
+            # splitting parameter at which the short-ranged error equals the accuracy
+            ratio = accuracy*sqrt(N*cur_rcut*V)/(2.0*q2);
+            kappa = sqrt(-math.log(min(ratio, 0.5)))/cur_rcut;
+
+            for cur_order in order:
+                mesh = [_min_mesh(L[d], N, cur_order, kappa, q2, accuracy, sizes[d]) for d in range(3)];
+                if None in mesh:
+                    hoomd.context.msg.notice(2, "charge.pppm: skipping order " + str(cur_order) + " rcut " + str(cur_rcut)
+                                             + ", more than " + str(max_mesh) + " grid points needed\n");
+                    continue;
+                candidates.append((mesh[0], mesh[1], mesh[2], cur_order, cur_rcut));
+
+        if len(candidates) == 0:
+            hoomd.context.msg.error("charge.pppm: no configuration reaches the accuracy, increase rcut or max_mesh\n");
+            raise RuntimeError('Error tuning PPPM');
+
+        # quiet the tuner starting here so that the user doesn't see all of the parameter set and run calls
+        hoomd.util.quiet_status();
+
+        # make the warmup run
+        self.set_params(*candidates[0], alpha=self.alpha, erfc_tol=self.erfc_tol);
+        hoomd.run(warmup, quiet=quiet);
+
+        tps_list = [];
+        for c in candidates:
+            self.set_params(*c, alpha=self.alpha, erfc_tol=self.erfc_tol);
+
+            # run the benchmark 3 times
+            tps = [];
+            for i in range(3):
+                hoomd.run(steps, quiet=quiet);
+                tps.append(hoomd.context.current.system.getLastTPS())
+
+            # record the median tps of the 3
+            tps.sort();
+            tps_list.append(tps[1]);
+
+        # find the fastest configuration, all ranks use the choice of the root rank
+        fastest = tps_list.index(max(tps_list));
+        fastest = int(_hoomd.mpi_bcast_str(fastest, hoomd.context.exec_conf));
+        self.set_params(*candidates[fastest], alpha=self.alpha, erfc_tol=self.erfc_tol);
+
+        # all done with the parameter sets and run calls
+        hoomd.util.unquiet_status();
+
+        # notify the user of the benchmark results
+        hoomd.context.msg.notice(2, "(Nx, Ny, Nz, order, rcut) = " + str(candidates) + '\n');
+        hoomd.context.msg.notice(2, "tps = " + str(tps_list) + '\n');
+        hoomd.context.msg.notice(2, "Optimal PPPM parameters: " + str(candidates[fastest]) + '\n');
+
+        return candidates[fastest];
+
     def update_coeffs(self):
         if not self.params_set:
             hoomd.context.msg.error("Coefficients for PPPM are not set. Call set_coeff prior to run()\n");
@@ -228,6 +378,203 @@ class pppm(force._force):
         if self.nlist.cpp_nlist.getDiameterShift():
             hoomd.context.msg.warning("Neighbor diameter shifting is enabled, PPPM may not correct for all excluded interactions\n");
 
+class pppm_dipole(force._force):
+    R""" Long-range dipole-dipole interactions computed with the dipolar PPPM method.
+
+    Args:
+        group (:py:mod:`hoomd.group`): Group of the particles that carry dipoles.
+        nlist (:py:mod:`hoomd.md.nlist`): Neighbor list
+
+    :py:class:`pppm_dipole` computes the interaction between point dipoles
+
+    .. math::
+
+        U_{dd} = \frac{\vec{\mu_i}\cdot\vec{\mu_j}}{r^3} - 3\frac{(\vec{\mu_i}\cdot \vec{r_{ji}})(\vec{\mu_j}\cdot \vec{r_{ji}})}{r^5}
+
+    summed over all periodic images with the Ewald method, in :math:`O(N \log N)` time. As in :py:class:`pppm`,
+    the sum is split into a short ranged part, evaluated within the cutoff :math:`r_{\mathrm{cut}}` by a pair force
+    that :py:class:`pppm_dipole` creates itself, and a long ranged part evaluated on a mesh with three dipole
+    density components and ik-differentiation (`Cerda et al. 2008 <http://dx.doi.org/10.1063/1.3000389>`_). Both
+    parts compute forces and torques, so use an integrator that integrates the rotational degrees of freedom.
+
+    The dipole moment of a particle is :math:`\vec{\mu} = \mu (1, 0, 0)` in its local reference frame, as in
+    :py:class:`hoomd.md.pair.dipole`, with the magnitude :math:`\mu` set per type. The interaction is unscreened
+    and uses tin-foil boundary conditions. Charges are ignored, combine with :py:class:`pppm` for the charge-charge
+    interactions (the charge-dipole cross terms are not computed). Excluded pairs are corrected, rigid body exclusions
+    are not supported.
+
+    Parameters Nx, Ny, Nz, order, :math:`r_{\mathrm{cut}}` and the moments must be set using
+    :py:meth:`set_params()` before any :py:func:`hoomd.run()` can take place. The long ranged energy is available
+    to :py:class:`hoomd.analyze.log` as ``pppm_dipole_energy``, the short ranged energy as ``aniso_pair_dipole_ewald_energy``.
+
+    Note:
+        :py:class:`pppm_dipole` is only available on the CPU.
+
+    .. important::
+        In MPI simulations, the number of grid point along every dimensions must be a power of two.
+
+    Example::
+
+        dipoles = group.all();
+        pppm = charge.pppm_dipole(group=dipoles, nlist=nl)
+        pppm.set_params(Nx=32, Ny=32, Nz=32, order=5, rcut=3.0, mu={'A': 1.0, 'B': 0.5})
+
+    .. versionadded:: 2.5
+    """
+    def __init__(self, group, nlist):
+        hoomd.util.print_status_line();
+
+        # initialize the base class
+        force._force.__init__(self);
+
+        if hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.msg.error("charge.pppm_dipole is not supported on the GPU\n");
+            raise RuntimeError("Error creating charge.pppm_dipole");
+
+        # PPPM itself doesn't really need a neighbor list, so subscribe call back as None
+        self.nlist = nlist
+        self.nlist.subscribe(lambda : None)
+        self.nlist.update_rcut()
+
+        self.cpp_force = _md.PPPMDipoleForceCompute(hoomd.context.current.system_definition, self.nlist.cpp_nlist, group.cpp_group);
+        hoomd.context.current.system.addCompute(self.cpp_force, self.force_name);
+
+        # error check flag - must be set to true by set_params in order for the run() to commence
+        self.params_set = False;
+
+        # initialize the short range part
+        hoomd.util.quiet_status();
+        self.ewald = _dipole_ewald(r_cut = False, nlist = self.nlist);
+        hoomd.util.unquiet_status();
+
+    # override disable and enable to work with both of the forces
+    def disable(self, log=False):
+        hoomd.util.print_status_line();
+
+        hoomd.util.quiet_status();
+        force._force.disable(self, log);
+        self.ewald.disable(log);
+        hoomd.util.unquiet_status();
+
+    def enable(self):
+        hoomd.util.print_status_line();
+
+        hoomd.util.quiet_status();
+        force._force.enable(self);
+        self.ewald.enable();
+        hoomd.util.unquiet_status();
+
+    def set_params(self, Nx, Ny, Nz, order, rcut, mu, kappa = None, fft_backend = None):
+        """ Sets the dipolar PPPM parameters.
+
+        Args:
+            Nx (int): Number of grid points in x direction
+            Ny (int): Number of grid points in y direction
+            Nz (int): Number of grid points in z direction
+            order (int): Number of grid points in each direction to assign the dipoles to
+            rcut  (float): Cutoff for the short-ranged part
+            mu (float or dict): Dipole magnitude of all types, or a dict of the magnitude per type name (types that
+                are not in the dict carry no dipole)
+            kappa (float, **optional**): Ewald splitting parameter (in units 1/distance). The default of
+                :math:`3/r_{\mathrm{cut}}` truncates the short ranged part where :math:`\mathrm{erfc}(\kappa r)`
+                is about :math:`2 \cdot 10^{-5}`.
+            fft_backend (str, **optional**): Library for the FFT of the mesh on a single rank, see
+                :py:meth:`pppm.set_params`.
+
+        Examples::
+
+            pppm.set_params(Nx=32, Ny=32, Nz=32, order=5, rcut=3.0, mu=1.0)
+            pppm.set_params(Nx=32, Ny=32, Nz=32, order=5, rcut=3.0, mu={'A': 1.0}, kappa=1.2)
+        """
+        hoomd.util.print_status_line();
+
+        if hoomd.context.current.system_definition.getNDimensions() != 3:
+            hoomd.context.msg.error("System must be 3 dimensional\n");
+            raise RuntimeError("Cannot compute PPPM");
+
+        if kappa is None:
+            kappa = 3.0/rcut;
+
+        pdata = hoomd.context.current.system_definition.getParticleData();
+        ntypes = pdata.getNTypes();
+        type_list = [pdata.getNameByType(i) for i in range(0,ntypes)];
+
+        moments = [];
+        for t in type_list:
+            if isinstance(mu, dict):
+                moments.append(float(mu.get(t, 0.0)));
+            else:
+                moments.append(float(mu));
+
+        for i in range(0,ntypes):
+            self.cpp_force.setMoment(i, moments[i]);
+
+        hoomd.util.quiet_status();
+        for i in range(0,ntypes):
+            for j in range(0,ntypes):
+                self.ewald.pair_coeff.set(type_list[i], type_list[j], mumu = moments[i]*moments[j], kappa = kappa, r_cut = rcut)
+        hoomd.util.unquiet_status();
+
+        if fft_backend is not None:
+            self.cpp_force.setFFTBackend(fft_backend);
+
+        self.cpp_force.setParams(Nx, Ny, Nz, order, kappa, rcut, 0.0);
+        self.params_set = True;
+
+    def update_coeffs(self):
+        if not self.params_set:
+            hoomd.context.msg.error("Coefficients for dipolar PPPM are not set. Call set_params prior to run()\n");
+            raise RuntimeError("Error initializing run");
+
+## \internal
+# \brief Real space part of the dipolar Ewald sum, set up by pppm_dipole
+class _dipole_ewald(pair.ai_pair):
+    def __init__(self, r_cut, nlist, name=None):
+        # initialize the base class
+        pair.ai_pair.__init__(self, r_cut, nlist, name);
+
+        self.cpp_force = _md.AnisoPotentialPairDipoleEwald(hoomd.context.current.system_definition, self.nlist.cpp_nlist, self.name);
+        self.cpp_class = _md.AnisoPotentialPairDipoleEwald;
+
+        hoomd.context.current.system.addCompute(self.cpp_force, self.force_name);
+
+        # setup the coefficient options
+        self.required_coeffs = ['mumu', 'kappa'];
+
+    def process_coeff(self, coeff):
+        return _hoomd.make_scalar2(coeff['mumu'], coeff['kappa']);
+
+## \internal
+# \brief Mesh sizes up to max_mesh that are powers of two
+def _pow2_sizes(max_mesh):
+    sizes = [];
+    n = 2;
+    while n <= max_mesh:
+        sizes.append(n);
+        n *= 2;
+    return sizes;
+
+## \internal
+# \brief Mesh sizes up to max_mesh that are products of powers of 2, 3 and 5, which the FFT libraries handle fastest
+def _fft_sizes(max_mesh):
+    sizes = [];
+    for n in range(2, max_mesh+1):
+        m = n;
+        for p in (2, 3, 5):
+            while m % p == 0:
+                m //= p;
+        if m == 1:
+            sizes.append(n);
+    return sizes;
+
+## \internal
+# \brief Smallest mesh size along one direction with an estimated mesh error below the accuracy
+def _min_mesh(prd, N, order, kappa, q2, accuracy, sizes):
+    for n in sizes:
+        if n >= order and rms(prd/n, prd, N, order, kappa, q2) <= accuracy:
+            return n;
+    return None;
+
 def diffpr(hx, hy, hz, xprd, yprd, zprd, N, order, kappa, q2, rcut):
     lprx = rms(hx, xprd, N, order, kappa, q2)
     lpry = rms(hy, yprd, N, order, kappa, q2)
@@ -219,6 +219,10 @@ class distance(_constraint_force):
     .. caution::
         constrain.distance() does not currently interoperate with integrate.brownian() or integrate.langevin()
 
+    By default, the linear system is solved with a sparse LU decomposition. For systems with many constraints, the
+    matrix-free iterative solver (see :py:meth:`set_params`) avoids populating the constraint matrix, at the cost of
+    an approximate solution.
+
     Example::
 
         constrain.distance()
@@ -238,20 +242,48 @@ class distance(_constraint_force):
 
         hoomd.context.current.system.addCompute(self.cpp_force, self.force_name);
 
-    def set_params(self,rel_tol=None):
+        self.solver = 'direct'
+        self.n_iter = 20
+
+    def set_params(self,rel_tol=None,solver=None,n_iter=None):
         R""" Set parameters for constraint computation.
 
         Args:
             rel_tol (float): The relative tolerance with which constraint violations are detected (**optional**).
+            solver (str): Solver for the constraint equation, ``'direct'`` or ``'iterative'`` (**optional**).
+            n_iter (int): Number of iterations per time step of the iterative solver (**optional**).
+
+        With ``solver='iterative'``, the Lagrange multipliers are computed with *n_iter* Jacobi iterations that
+        start from the multipliers of the previous time step. The constraint matrix is never formed, so the cost per
+        step is linear in the number of constraints. The iteration converges for chains and small rigid clusters of
+        constraints, use the direct solver for highly connected constraint networks.
+
+        .. versionadded:: 2.5
+            *solver* and *n_iter*
 
         Example::
 
             dist = constrain.distance()
             dist.set_params(rel_tol=0.0001)
+            dist.set_params(solver='iterative', n_iter=10)
         """
+        hoomd.util.print_status_line();
+
         if rel_tol is not None:
             self.cpp_force.setRelativeTolerance(float(rel_tol))
 
+        if solver is not None:
+            if solver not in ('direct', 'iterative'):
+                hoomd.context.msg.error("constrain.distance: Unknown solver " + str(solver) + "\n");
+                raise RuntimeError("Error setting constraint solver");
+            self.solver = solver
+
+        if n_iter is not None:
+            self.n_iter = int(n_iter)
+
+        if solver is not None or n_iter is not None:
+            self.cpp_force.setIterative(self.solver == 'iterative', self.n_iter)
+
 class rigid(_constraint_force):
     R""" Constrain particles in rigid bodies.
 
@@ -375,6 +375,31 @@ class table(force._force):
         # pass the tables on to the underlying cpp compute
         self.cpp_force.setTable(atype, Vtable, Ttable);
 
+    def set_params(self, interpolation=None):
+        R""" Set parameters of the table evaluation.
+
+        Args:
+            interpolation (str): (if set) Interpolation of the table, either 'linear' or 'cubic'
+
+        By default, the potential and torque are interpolated linearly between the table points, which needs fine
+        tables for accurate forces. With ``interpolation='cubic'``, every interval is evaluated with the cubic
+        Hermite polynomial that matches *V* and *T* at both of its ends. The torque is then the exact derivative of the
+        interpolated potential, and coarser tables reach the same accuracy, which also keeps the tables of many
+        dihedral types in cache.
+
+        Examples::
+
+            dtable.set_params(interpolation='cubic')
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+
+        if interpolation is not None:
+            if interpolation not in ('linear', 'cubic'):
+                hoomd.context.msg.error("dihedral.table: interpolation must be 'linear' or 'cubic'\n");
+                raise RuntimeError("Error setting dihedral.table parameters");
+            self.cpp_force.setCubicInterpolation(interpolation == 'cubic');
 
     def update_coeffs(self):
         # check that the dihedral coefficients are valid
@@ -172,6 +172,31 @@ class _force(hoomd.meta._metadata):
 
         return (self.cpp_force.calcForceGroup(group.cpp_group).x, self.cpp_force.calcForceGroup(group.cpp_group).y, self.cpp_force.calcForceGroup(group.cpp_group).z)
 
+    def use_stream(self, enable=True):
+        R""" Launch the GPU kernels of this force in a CUDA stream of its own.
+
+        Args:
+            enable (bool): True to use a stream of its own, False to use the default stream.
+
+        Forces with a stream of their own are computed concurrently with the other forces, which reduces the time
+        step when the individual kernels do not fill the GPU, e.g. for the bonds and the pair force of a polymer
+        system. The neighbor list is still built before the pair force is computed, and the net force is summed after
+        all forces have completed. Forces are always computed in the default stream on the CPU and on multiple GPUs.
+
+        Examples::
+
+            harmonic.use_stream()
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+        self.check_initialization();
+
+        if not hoomd.context.exec_conf.isCUDAEnabled():
+            return;
+
+        self.cpp_force.setUseStream(enable);
+
 
     ## \internal
     # \brief updates force coefficients
@@ -520,3 +545,266 @@ class dipole(_force):
     # there are no coeffs to update in the constant ExternalFieldDipoleForceCompute
     def update_coeffs(self):
         pass
+
+class fused_bonded(_force):
+    R""" Evaluate harmonic bonds, harmonic angles and OPLS dihedrals in a single GPU kernel.
+
+    Args:
+        bond (:py:class:`hoomd.md.bond.harmonic`): Bond potential to fuse (or None)
+        angle (:py:class:`hoomd.md.angle.harmonic`): Angle potential to fuse (or None)
+        dihedral (:py:class:`hoomd.md.dihedral.opls`): Dihedral potential to fuse (or None)
+
+    :py:class:`fused_bonded` replaces the given bonded potentials with one force compute that evaluates all of them
+    in one kernel launch and accumulates the forces, energies and virials into one array. This saves the kernel
+    launches and the force array traffic of the separate potentials in systems with many bonded terms.
+
+    The given potentials are disabled and keep their role as the source of the coefficients: changes made with
+    ``bond_coeff.set()``, ``angle_coeff.set()`` and ``dihedral_coeff.set()`` are applied at the next run. Specify the
+    coefficients of the given potentials as usual before the run.
+
+    The total energy of all fused terms is available to the logger as ``fused_bonded_energy``.
+
+    Note:
+        :py:class:`fused_bonded` is only available on the GPU.
+
+    Examples::
+
+        harmonic = bond.harmonic()
+        harmonic.bond_coeff.set('polymer', k=330.0, r0=0.84)
+        angle_h = angle.harmonic()
+        angle_h.angle_coeff.set('polymer', k=3.0, t0=0.7851)
+        opls = dihedral.opls()
+        opls.dihedral_coeff.set('dihedral1', k1=30.0, k2=15.5, k3=2.2, k4=23.8)
+        force.fused_bonded(bond=harmonic, angle=angle_h, dihedral=opls)
+
+    .. versionadded:: 2.5
+    """
+    def __init__(self, bond=None, angle=None, dihedral=None):
+        hoomd.util.print_status_line()
+
+        # initialize the base class
+        _force.__init__(self)
+
+        if not hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.msg.error("force.fused_bonded is only available on the GPU\n")
+            raise RuntimeError("Error creating fused bonded force")
+
+        if bond is not None and not isinstance(bond, hoomd.md.bond.harmonic):
+            hoomd.context.msg.error("force.fused_bonded: bond must be a bond.harmonic\n")
+            raise RuntimeError("Error creating fused bonded force")
+
+        if angle is not None and not isinstance(angle, hoomd.md.angle.harmonic):
+            hoomd.context.msg.error("force.fused_bonded: angle must be an angle.harmonic\n")
+            raise RuntimeError("Error creating fused bonded force")
+
+        if dihedral is not None and not isinstance(dihedral, hoomd.md.dihedral.opls):
+            hoomd.context.msg.error("force.fused_bonded: dihedral must be a dihedral.opls\n")
+            raise RuntimeError("Error creating fused bonded force")
+
+        if bond is None and angle is None and dihedral is None:
+            hoomd.context.msg.error("force.fused_bonded: specify at least one potential\n")
+            raise RuntimeError("Error creating fused bonded force")
+
+        self.bond = bond
+        self.angle = angle
+        self.dihedral = dihedral
+
+        # the fused compute replaces the separate potentials
+        hoomd.util.quiet_status()
+        for f in (bond, angle, dihedral):
+            if f is not None and f.enabled:
+                f.disable()
+        hoomd.util.unquiet_status()
+
+        # create the c++ mirror class
+        self.cpp_force = _md.FusedBondedForceComputeGPU(hoomd.context.current.system_definition)
+        self.cpp_force.setEnabled(bond is not None, angle is not None, dihedral is not None)
+
+        hoomd.context.current.system.addCompute(self.cpp_force, self.force_name)
+
+    ## \internal
+    # \brief Get the coefficients of all types of a fused potential
+    def _get_coeffs(self, coeff, required_coeffs, group_data):
+        if not coeff.verify(required_coeffs):
+            hoomd.context.msg.error("Not all force coefficients are set\n")
+            raise RuntimeError("Error updating force coefficients")
+
+        coeffs = []
+        for i in range(0, group_data.getNTypes()):
+            type_name = group_data.getNameByType(i)
+            coeffs.append([coeff.get(type_name, name) for name in required_coeffs])
+        return coeffs
+
+    ## \internal
+    # \brief Update coefficients in C++ from the fused potentials
+    def update_coeffs(self):
+        sysdef = hoomd.context.current.system_definition
+
+        if self.bond is not None:
+            for i, (k, r0) in enumerate(self._get_coeffs(self.bond.bond_coeff, ['k', 'r0'], sysdef.getBondData())):
+                self.cpp_force.setBondParams(i, k, r0)
+
+        if self.angle is not None:
+            for i, (k, t0) in enumerate(self._get_coeffs(self.angle.angle_coeff, ['k', 't0'],
+                                                         sysdef.getAngleData())):
+                self.cpp_force.setAngleParams(i, k, t0)
+
+        if self.dihedral is not None:
+            for i, (k1, k2, k3, k4) in enumerate(self._get_coeffs(self.dihedral.dihedral_coeff,
+                                                                  ['k1', 'k2', 'k3', 'k4'],
+                                                                  sysdef.getDihedralData())):
+                self.cpp_force.setDihedralParams(i, k1, k2, k3, k4)
+
+## \internal
+# \brief Array shared with a dlpack callback
+#
+# Implements the DLPack protocol (__dlpack__ and __dlpack_device__), so the array can be passed to
+# numpy.from_dlpack(), torch.from_dlpack(), jax.dlpack.from_dlpack() or cupy.from_dlpack().
+class _dlpack_array(object):
+    def __init__(self, cpp_force, name):
+        self.cpp_force = cpp_force;
+        self.name = name;
+
+    def __dlpack__(self, stream=None, **kwargs):
+        # stream -1 asks for no synchronization
+        if stream is not None and stream != -1:
+            self.cpp_force.waitForData(stream);
+        return self.cpp_force.getDLPack(self.name);
+
+    def __dlpack_device__(self):
+        return self.cpp_force.getDLPackDevice();
+
+class dlpack(_force):
+    R""" Compute forces in python with zero-copy access to the particle data.
+
+    Args:
+        callback (`callable`): Function that computes the forces, called as ``callback(timestep, N, arrays)``
+        r_cut (float): Cutoff radius of the neighbor list shared with the callback (in distance units)
+        nlist (:py:mod:`hoomd.md.nlist`): Neighbor list to share with the callback, or None
+
+    :py:class:`dlpack` hands the particle data, the neighbor list and the force arrays to *callback*
+    as `DLPack <https://github.com/dmlc/dlpack>`_ tensors every time the forces are computed. The
+    tensors reference the arrays on the device where they live, device memory on the GPU and host memory on
+    the CPU, so a machine learning framework can evaluate a model on them and write the forces back without
+    any copy between the host and the device. Use it to couple PyTorch, JAX or CuPy models.
+
+    *N* is the number of particles local to this rank. *arrays* is a dict of objects that support
+    the DLPack protocol (``__dlpack__`` and ``__dlpack_device__``):
+
+    - ``position`` - (N+N_ghost, 3) positions of the local and ghost particles
+    - ``type`` - (N+N_ghost) type ids (int32)
+    - ``nlist``, ``n_neigh``, ``head_list`` - the full neighbor list (int32, only when *nlist* is given):
+      the neighbors of particle *i* are ``nlist[head_list[i]:head_list[i]+n_neigh[i]]``, and include all
+      particles within *r_cut* plus the buffer of the neighbor list
+    - ``force`` - (N+N_ghost, 4) forces, with the potential energy in the last column (writable)
+    - ``virial`` - (6, N+N_ghost) virials in the order xx, xy, xz, yy, yz, zz (writable)
+
+    The forces and virials are zeroed before the callback, and only the rows of the local particles are used.
+    The floating point arrays are in the precision hoomd was compiled with. Ghost particles are included within
+    the neighbor list cutoff in MPI simulations.
+
+    Warning:
+        The tensors are only valid during the callback. Do not keep them, and do not access the particle data
+        by other means (e.g. snapshots) in the callback.
+
+    On the GPU, launch the work of the callback in the stream given by :py:meth:`get_stream`, to overlap it with
+    other forces that use a stream of their own (see :py:meth:`use_stream`). The net force is summed after the
+    work in this stream completes, the callback does not need to synchronize. Consumers that export the
+    arrays to another stream are synchronized following the DLPack protocol.
+
+    Note:
+        :py:class:`dlpack` is not available on multiple GPUs.
+
+    Examples::
+
+        import torch
+
+        def compute(timestep, N, arrays):
+            pos = torch.from_dlpack(arrays['position'])
+            types = torch.from_dlpack(arrays['type'])
+            energy, forces = model(pos, types, N)
+            torch.from_dlpack(arrays['force'])[:N,:3] = forces
+            torch.from_dlpack(arrays['force'])[:N,3] = energy
+
+        nl = md.nlist.cell()
+        ml = md.force.dlpack(callback=compute, r_cut=5.0, nlist=nl)
+        ml.use_stream()
+
+    .. versionadded:: 2.5
+    """
+    def __init__(self, callback, r_cut=None, nlist=None):
+        hoomd.util.print_status_line();
+
+        # initialize the base class
+        _force.__init__(self);
+
+        if nlist is not None and r_cut is None:
+            hoomd.context.msg.error("force.dlpack: r_cut is required with a neighbor list\n");
+            raise RuntimeError("Error creating dlpack force");
+
+        self.callback = callback;
+        self.r_cut = r_cut;
+        self.nlist = nlist;
+
+        # create the c++ mirror class
+        if nlist is not None:
+            self.cpp_force = _md.DLPackForceCompute(hoomd.context.current.system_definition, nlist.cpp_nlist);
+        else:
+            self.cpp_force = _md.DLPackForceCompute(hoomd.context.current.system_definition, None);
+
+        self.cpp_force.setCallback(self._call);
+
+        # the neighbor list must hold all pairs within r_cut, in the lists of both particles
+        if nlist is not None:
+            self.nlist.cpp_nlist.setStorageMode(_md.NeighborList.storageMode.full);
+            self.nlist.subscribe(lambda:self.get_rcut());
+            self.nlist.update_rcut();
+
+        self.metadata_fields = ['r_cut'];
+
+        hoomd.context.current.system.addCompute(self.cpp_force, self.force_name);
+
+    ## \internal
+    # \brief Wrap the shared arrays and call the user callback
+    def _call(self, timestep, N):
+        arrays = {};
+        for name in self.cpp_force.getDLPackNames():
+            arrays[name] = _dlpack_array(self.cpp_force, name);
+        self.callback(timestep, N, arrays);
+
+    def get_stream(self):
+        R""" Get the CUDA stream the callback should launch its work in.
+
+        Returns:
+            The handle of the stream as an integer, 0 for the default stream and on the CPU.
+
+        Examples::
+
+            stream = torch.cuda.ExternalStream(ml.get_stream())
+            with torch.cuda.stream(stream):
+                forces = model(pos)
+        """
+        self.check_initialization();
+        return self.cpp_force.getStreamHandle();
+
+    ## \internal
+    # \brief Get the r_cut pair dictionary for the neighbor list
+    def get_rcut(self):
+        if not self.log:
+            return None
+
+        ntypes = hoomd.context.current.system_definition.getParticleData().getNTypes();
+        type_list = [];
+        for i in range(0,ntypes):
+            type_list.append(hoomd.context.current.system_definition.getParticleData().getNameByType(i));
+
+        r_cut_dict = hoomd.md.nlist.rcut();
+        for i in range(0,ntypes):
+            for j in range(i,ntypes):
+                r_cut_dict.set_pair(type_list[i],type_list[j],self.r_cut);
+
+        return r_cut_dict;
+
+    # there are no coeffs to update in the dlpack force compute
+    def update_coeffs(self):
+        pass
@@ -45,6 +45,7 @@ import hoomd;
 from hoomd.integrate import _integrator, _integration_method
 import copy;
 import sys;
+import math;
 
 class mode_standard(_integrator):
     R""" Enables a variety of standard integration methods.
@@ -52,6 +53,8 @@ class mode_standard(_integrator):
     Args:
         dt (float): Each time step of the simulation :py:func:`hoomd.run()` will advance the real time of the system forward by *dt* (in time units).
         aniso (bool): Whether to integrate rotational degrees of freedom (bool), default None (autodetect).
+        slow (list): Forces to evaluate only every *slow_period* steps (multiple time stepping).
+        slow_period (int): Number of time steps *dt* between evaluations of the *slow* forces.
 
     :py:class:`mode_standard` performs a standard time step integration technique to move the system forward. At each time
     step, all of the specified forces are evaluated and used in moving the system forward to the next step.
@@ -76,6 +79,20 @@ class mode_standard(_integrator):
 
         integrate.mode_standard(dt=0.005)
         integrator_mode = integrate.mode_standard(dt=0.001)
+        integrate.mode_standard(dt=0.002, slow=[pppm], slow_period=4)
+
+    Multiple time stepping (r-RESPA) is enabled by listing expensive, slowly varying forces (such as
+    :py:class:`hoomd.md.charge.pppm` or a long range pair potential) in *slow*. The other forces are evaluated every
+    step *dt*, while the slow forces are only evaluated on time steps that are a multiple of *slow_period*, where they
+    are applied multiplied by *slow_period*. With :py:class:`nve`, this is the impulse form of r-RESPA with an outer
+    time step of *slow_period* times *dt*. The outer time step is limited by the slow forces (typically to a few times
+    *dt*), and the inner time step *dt* by the fast forces, such as bonds.
+
+    Note:
+        The energies and virials of the slow forces only enter the logged quantities on time steps that are a multiple
+        of *slow_period*. Log on such time steps, and start runs on them to keep the outer steps symmetric. For the
+        same reason, methods that couple the box to the pressure (:py:class:`npt`, :py:class:`nph`) cannot be used
+        with *slow_period* > 1, :py:func:`hoomd.run()` raises an error.
 
     Some integration methods (notable :py:class:`nvt`, :py:class:`npt` and :py:class:`nph` maintain state between
     different :py:func:`hoomd.run()` commands, to allow for restartable simulations. After adding or removing particles, however,
@@ -83,7 +100,7 @@ class mode_standard(_integrator):
     To ensure equilibration from a unique reference state (such as all integrator variables set to zero),
     the method :py:method:reset_methods() can be use to re-initialize the variables.
     """
-    def __init__(self, dt, aniso=None):
+    def __init__(self, dt, aniso=None, slow=None, slow_period=1):
         hoomd.util.print_status_line();
 
         # initialize base class
@@ -92,7 +109,8 @@ class mode_standard(_integrator):
         # Store metadata
         self.dt = dt
         self.aniso = aniso
-        self.metadata_fields = ['dt', 'aniso']
+        self.slow_period = slow_period
+        self.metadata_fields = ['dt', 'aniso', 'slow_period']
 
         # initialize the reflected c++ class
         self.cpp_integrator = _md.IntegratorTwoStep(hoomd.context.current.system_definition, dt);
@@ -103,6 +121,8 @@ class mode_standard(_integrator):
         hoomd.util.quiet_status();
         if aniso is not None:
             self.set_params(aniso=aniso)
+        if slow is not None or slow_period != 1:
+            self.set_params(slow=slow, slow_period=slow_period)
         hoomd.util.unquiet_status();
 
     ## \internal
@@ -112,18 +132,39 @@ class mode_standard(_integrator):
         True: _md.IntegratorAnisotropicMode.Anisotropic,
         False: _md.IntegratorAnisotropicMode.Isotropic}
 
-    def set_params(self, dt=None, aniso=None):
+    def set_params(self, dt=None, aniso=None, slow=None, slow_period=None, accumulate_net_force=None,
+                   fuse_step_one=None):
         R""" Changes parameters of an existing integration mode.
 
         Args:
             dt (float): New time step delta (if set) (in time units).
             aniso (bool): Anisotropic integration mode (bool), default None (autodetect).
+            slow (list): Forces to evaluate only every *slow_period* steps (if set).
+            slow_period (int): Number of time steps between evaluations of the slow forces (if set).
+            accumulate_net_force (bool): Set to True to let forces add directly to the net force (if set).
+            fuse_step_one (bool): Set to True to perform the first half step of all methods in one GPU kernel (if set).
 
         Examples::
 
             integrator_mode.set_params(dt=0.007)
             integrator_mode.set_params(dt=0.005, aniso=False)
-
+            integrator_mode.set_params(slow=[pppm], slow_period=3)
+            integrator_mode.set_params(accumulate_net_force=True)
+            integrator_mode.set_params(fuse_step_one=True)
+
+        By default, every force writes per-particle forces, energies and virials to its own arrays, which are then
+        summed into the net force. With *accumulate_net_force*, the pair potentials add their forces directly to the
+        net force instead, which saves reading and writing their arrays on every step. Other forces, slow forces and
+        forces with an energy logged by :py:class:`hoomd.analyze.log` keep their own arrays. The per-particle data of
+        the accumulating forces (``forces`` and ``get_energy()``) is not available.
+
+        With *fuse_step_one*, the first half step of :py:class:`nve` and :py:class:`langevin` is performed for all of
+        these methods by a single kernel on the GPU, which reduces the kernel launches of small systems with several
+        methods. In 2D systems, the fused kernel also constrains the velocities and accelerations of the integrated
+        particles to the plane as :py:class:`hoomd.md.update.enforce2d` does. Other methods and the CPU are not affected.
+
+        .. versionadded:: 2.5
+            *accumulate_net_force*, *fuse_step_one*
         """
         hoomd.util.print_status_line();
         self.check_initialization();
@@ -142,6 +183,83 @@ class mode_standard(_integrator):
             self.aniso = aniso
             self.cpp_integrator.setAnisotropicMode(anisoMode)
 
+        if slow is not None:
+            self.cpp_integrator.removeSlowForceComputes();
+            self.slow_forces = list(slow);
+            for f in slow:
+                if getattr(f, 'cpp_force', None) is None:
+                    hoomd.context.msg.error("integrate.mode_standard: slow must be a list of forces\n");
+                    raise RuntimeError("Error setting slow forces.");
+                self.cpp_integrator.addSlowForceCompute(f.cpp_force);
+
+        if slow_period is not None:
+            if int(slow_period) < 1:
+                hoomd.context.msg.error("integrate.mode_standard: slow_period must be at least 1\n");
+                raise RuntimeError("Error setting slow force period.");
+            self.slow_period = int(slow_period)
+            self.cpp_integrator.setSlowForcePeriod(self.slow_period)
+
+        if accumulate_net_force is not None:
+            self.accumulate_net_force = bool(accumulate_net_force);
+
+        if fuse_step_one is not None:
+            self.cpp_integrator.setFuseStepOne(bool(fuse_step_one));
+
+    def set_adaptive(self, max_displacement=None, max_velocity_change=None, dt_min=None, dt_max=None, growth=1.1,
+                     enable=True):
+        R""" Adapts the time step between steps to the velocities and accelerations of the integrated particles.
+
+        Args:
+            max_displacement (float): Largest distance a particle may move in one step (in distance units), or None.
+            max_velocity_change (float): Largest change of the velocity of a particle in one step (in velocity units), or None.
+            dt_min (float): Smallest time step (in time units). Defaults to *dt* / 1000.
+            dt_max (float): Largest time step (in time units). Defaults to *dt*.
+            growth (float): Largest factor by which the time step may grow from one step to the next.
+            enable (bool): Set to False to return to the fixed time step *dt*.
+
+        Examples::
+
+            integrator_mode = integrate.mode_standard(dt=1e-3)
+            integrator_mode.set_adaptive(max_displacement=0.01, max_velocity_change=0.1, dt_max=1e-2)
+            integrator_mode.set_adaptive(enable=False)
+
+        After every step, the time step of the next one is chosen from the largest speed :math:`v` and
+        acceleration :math:`a` of all particles integrated by the methods (determined with a single reduction over all
+        MPI ranks), such that :math:`v \Delta t + a \Delta t^2/2` does not exceed *max_displacement* and
+        :math:`a \Delta t` does not exceed *max_velocity_change*. The time step grows by at most a factor *growth* per
+        step and is clamped to [*dt_min*, *dt_max*]. Only the translational degrees of freedom are considered.
+
+        Granular and DEM simulations (:py:class:`hoomd.dem.pair.WCA`, :py:class:`hoomd.dem.pair.SWCA`) can take large
+        steps between collisions and small steps while particles are in contact, instead of using the smallest
+        time step of the whole run everywhere. Log ``dt`` to follow the time step, and use
+        :py:func:`hoomd.get_time()`, ``time=True`` in :py:class:`hoomd.variant.linear_interp`, and
+        ``set_time_period()`` of analyzers and updaters to schedule in simulation time instead of time steps.
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+        self.check_initialization();
+
+        if not enable:
+            self.cpp_integrator.disableAdaptiveTimestep();
+            self.cpp_integrator.setDeltaT(self.dt);
+            return;
+
+        if max_displacement is None and max_velocity_change is None:
+            hoomd.context.msg.error("integrate.mode_standard: set_adaptive needs max_displacement or max_velocity_change\n");
+            raise RuntimeError("Error setting the adaptive time step.");
+
+        if dt_min is None:
+            dt_min = self.dt / 1000.0;
+        if dt_max is None:
+            dt_max = self.dt;
+
+        self.cpp_integrator.setAdaptiveTimestep(0.0 if max_displacement is None else float(max_displacement),
+                                                0.0 if max_velocity_change is None else float(max_velocity_change),
+                                                float(dt_min),
+                                                float(dt_max),
+                                                float(growth));
+
     def reset_methods(self):
         R""" (Re-)initialize the integrator variables in all integration methods
 
@@ -312,6 +430,7 @@ class npt(_integration_method):
         nph (bool): if True, integrate without a thermostat, i.e. in the NPH ensemble
         rescale_all (bool): if True, rescale all particles, not only those in the group
         gamma: (:py:obj:`float`): Dimensionless damping factor for the box degrees of freedom (default: 0)
+        fuse_thermo (bool): if True, sum up the kinetic energy and the pressure tensor in the velocity updates (default: False)
 
     :py:class:`npt` performs constant pressure, constant temperature simulations, allowing for a fully deformable
     simulation box.
@@ -398,6 +517,11 @@ class npt(_integration_method):
 
     A :py:class:`hoomd.compute.thermo` is automatically specified and associated with *group*.
 
+    With *fuse_thermo=True*, the thermostat and the barostat use the kinetic energy and the pressure tensor that
+    are summed up while the velocities are updated, with a single reduction per half step, instead of separate
+    passes of :py:class:`hoomd.compute.thermo` over the particles. The first step of a run still evaluates
+    :py:class:`hoomd.compute.thermo`. Logged thermodynamic quantities are not affected.
+
     Examples::
 
         integrate.npt(group=all, kT=1.0, tau=0.5, tauP=1.0, P=2.0)
@@ -409,7 +533,7 @@ class npt(_integration_method):
         # triclinic symmetry
         integrator = integrate.npt(group=all, tau=1.0, kT=0.65, tauP = 1.2, P=2.0, couple="none", rescale_all=True)
     """
-    def __init__(self, group, kT=None, tau=None, S=None, P=None, tauP=None, couple="xyz", x=True, y=True, z=True, xy=False, xz=False, yz=False, all=False, nph=False, rescale_all=None, gamma=None):
+    def __init__(self, group, kT=None, tau=None, S=None, P=None, tauP=None, couple="xyz", x=True, y=True, z=True, xy=False, xz=False, yz=False, all=False, nph=False, rescale_all=None, gamma=None, fuse_thermo=False):
         hoomd.util.print_status_line();
 
         # check the input
@@ -543,6 +667,8 @@ class npt(_integration_method):
         if gamma is not None:
             self.cpp_method.setGamma(gamma)
 
+        self.cpp_method.setFuseThermo(fuse_thermo)
+
         self.cpp_method.validateGroup()
 
         # store metadata
@@ -552,6 +678,7 @@ class npt(_integration_method):
         self.tauP = tauP
         self.couple = couple
         self.rescale_all = rescale_all
+        self.fuse_thermo = fuse_thermo
         self.all = all
         self.x = x
         self.y = y
@@ -561,7 +688,7 @@ class npt(_integration_method):
         self.yz = yz
         self.nph = nph
 
-    def set_params(self, kT=None, tau=None, S=None, P=None, tauP=None, rescale_all=None, gamma=None):
+    def set_params(self, kT=None, tau=None, S=None, P=None, tauP=None, rescale_all=None, gamma=None, fuse_thermo=None):
         R""" Changes parameters of an existing integrator.
 
         Args:
@@ -571,6 +698,7 @@ class npt(_integration_method):
             P (:py:mod:`hoomd.variant` or :py:obj:`float`): New isotropic pressure set point (if set) for the barostat (in pressure units). Overrides *S* if set.
             tauP (float): New barostat coupling constant (if set) (in time units)
             rescale_all (bool): When True, rescale all particles, not only those in the group
+            fuse_thermo (bool): When True, sum up the kinetic energy and the pressure tensor in the velocity updates
 
         Examples::
 
@@ -615,6 +743,9 @@ class npt(_integration_method):
             self.rescale_all = rescale_all
         if gamma is not None:
             self.cpp_method.setGamma(gamma)
+        if fuse_thermo is not None:
+            self.cpp_method.setFuseThermo(fuse_thermo)
+            self.fuse_thermo = fuse_thermo
 
     ## \internal
     # \brief Return information about this integration method
@@ -646,6 +777,7 @@ class npt(_integration_method):
         data['lengths'] = lengths.rstrip()
         if self.rescale_all is not None:
             data['rescale_all'] = self.rescale_all
+        data['fuse_thermo'] = self.fuse_thermo
 
         return data
 
@@ -812,17 +944,29 @@ class nve(_integration_method):
         self.limit = limit
         self.metadata_fields = ['group', 'limit']
 
-    def set_params(self, limit=None, zero_force=None):
+    def set_params(self, limit=None, zero_force=None, constraint=None):
         R""" Changes parameters of an existing integrator.
 
         Args:
             limit (bool): (if set) New limit value to set. Removes the limit if limit is False
             zero_force (bool): (if set) New value for the zero force option
+            constraint (:py:class:`hoomd.md.constrain.sphere` or :py:class:`hoomd.md.constrain.oneD`): (if set)
+              Constraint to apply in the second step of the integration. Stops applying it if constraint is False.
+
+        On the GPU, a :py:class:`hoomd.md.constrain.sphere` or :py:class:`hoomd.md.constrain.oneD` on the same
+        group as the integration method can be applied by the kernel of the second step, which saves a kernel launch
+        and the constraint force array. The results are the same. The constraint must be in effect while it is
+        fused, and *zero_force* must be False. On the CPU, the option has no effect.
+
+        .. versionadded:: 2.5
+           The *constraint* option.
 
         Examples::
 
             integrator.set_params(limit=0.01)
             integrator.set_params(limit=False)
+            sphere = constrain.sphere(group=all, P=(0,0,0), r=10)
+            integrator.set_params(constraint=sphere)
         """
         hoomd.util.print_status_line();
         self.check_initialization();
@@ -838,6 +982,12 @@ class nve(_integration_method):
         if zero_force is not None:
             self.cpp_method.setZeroForce(zero_force);
 
+        if constraint is not None and hoomd.context.exec_conf.isCUDAEnabled():
+            if constraint == False:
+                self.cpp_method.removeConstraint();
+            else:
+                self.cpp_method.setConstraint(constraint.cpp_force);
+
     def randomize_velocities(self, kT, seed):
         R""" Assign random velocities and angular momenta to particles in the
         group, sampling from the Maxwell-Boltzmann distribution. This method
@@ -1295,6 +1445,157 @@ class brownian(_integration_method):
             if a == type_list[i]:
                 self.cpp_method.setGamma_r(i,_hoomd.make_scalar3(*gamma_r));
 
+class brownian_rpy(_integration_method):
+    R""" Brownian dynamics with hydrodynamic interactions.
+
+    Args:
+        group (:py:mod:`hoomd.group`): Group of particles to apply this method to.
+        kT (:py:mod:`hoomd.variant` or :py:obj:`float`): Temperature of the simulation (in energy units).
+        seed (int): Random seed to use for generating the Brownian displacements.
+        eta (float): Viscosity of the fluid (in units of mass / distance / time).
+        a (float): Hydrodynamic radius of the particles (in distance units).
+        r_cut (float): Cutoff of the real space part of the mobility (in distance units).
+        Nx (int): Number of mesh points along the first lattice vector.
+        Ny (int): Number of mesh points along the second lattice vector.
+        Nz (int): Number of mesh points along the third lattice vector.
+        order (int): Order of the B-spline assignment to the mesh (1 to 7).
+        xi (float): Ewald splitting parameter (in inverse distance units). When None, it is chosen such that the
+            real space part has decayed by a factor of about :math:`10^{-6}` at *r_cut*.
+        lanczos_tol (float): Relative tolerance of the Lanczos method for the Brownian displacements.
+        lanczos_max_iter (int): Maximum number of Lanczos iterations per time step.
+
+    :py:class:`brownian_rpy` integrates particles forward in time according to the overdamped equations of motion of
+    spheres of radius :math:`a` that interact through the fluid with viscosity :math:`\eta`:
+
+    .. math::
+
+        \Delta \vec{x} = \mathbf{M} \vec{F}_\mathrm{C} \delta t + \sqrt{2 k T \delta t} \mathbf{M}^{1/2} \vec{z}
+
+    where :math:`\vec{F}_\mathrm{C}` collects the forces on all particles in the group, :math:`\mathbf{M}` is the
+    Rotne-Prager-Yamakawa mobility of the periodic system and :math:`\vec{z}` are independent normal random numbers.
+    Without hydrodynamic interactions, :math:`\mathbf{M}` reduces to the single particle mobility
+    :math:`\mu_0 = 1/(6 \pi \eta a)` and :py:class:`brownian_rpy` is equivalent to :py:class:`brownian`
+    with :math:`\gamma = 6 \pi \eta a`.
+
+    The mobility is split with the Ewald parameter :math:`\xi` into a short ranged real space part, summed over all
+    pairs within *r_cut*, and a smooth wave space part, evaluated on a mesh of *Nx* by *Ny* by *Nz* points with fast
+    Fourier transforms, similar to :py:class:`hoomd.md.charge.pppm`. Larger values of :math:`\xi` move work from the
+    real space part to the mesh. The products with :math:`\mathbf{M}^{1/2}` are computed with the Lanczos method
+    (`T. Ando et. al. 2012 <http://dx.doi.org/10.1063/1.4742347>`_), which iterates until the relative change of
+    the displacements falls below *lanczos_tol*. Log ``brownian_rpy_lanczos_iterations`` to monitor it.
+
+    Hydrodynamic interactions act among the particles in *group*. Only translational degrees of freedom are
+    integrated. As in :py:class:`brownian`, new velocities consistent with the set temperature are drawn every time
+    step so that :py:class:`hoomd.compute.thermo` reports appropriate temperatures.
+
+    Note:
+        :py:class:`brownian_rpy` runs on the CPU, also when HOOMD is executing on the GPU. It supports only three
+        dimensional systems and does not support domain decomposition. *r_cut* must be at most half the smallest
+        distance between opposite faces of the box.
+
+    .. attention::
+        Change the seed if you reset the simulation time step to 0. If you keep the same seed, the simulation
+        will continue with the same sequence of random numbers used previously and may cause unphysical correlations.
+
+    *kT* can be a variant type, allowing for temperature ramps in simulation runs.
+
+    A :py:class:`hoomd.compute.thermo` is automatically created and associated with *group*.
+
+    Examples::
+
+        all = group.all();
+        integrator = integrate.brownian_rpy(group=all, kT=1.0, seed=5, eta=1.0, a=0.5, r_cut=3.0, Nx=32, Ny=32, Nz=32)
+        integrator = integrate.brownian_rpy(group=all, kT=1.0, seed=5, eta=1.0, a=0.5, r_cut=3.0, Nx=32, Ny=32, Nz=32,
+                                            order=6, lanczos_tol=1e-3)
+
+    """
+    def __init__(self, group, kT, seed, eta, a, r_cut, Nx, Ny, Nz, order=5, xi=None, lanczos_tol=1e-4,
+                 lanczos_max_iter=100):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        _integration_method.__init__(self);
+
+        # setup the variant inputs
+        kT = hoomd.variant._setup_variant_input(kT);
+
+        # create the compute thermo
+        hoomd.compute._get_unique_thermo(group=group);
+
+        if xi is None:
+            # erfc(xi*r_cut) ~ 1e-6
+            xi = math.sqrt(-math.log(1e-6))/r_cut;
+
+        # initialize the reflected c++ class, there is only a CPU implementation
+        self.cpp_method = _md.TwoStepBDRPY(hoomd.context.current.system_definition,
+                                           group.cpp_group,
+                                           kT.cpp_variant,
+                                           seed,
+                                           float(eta),
+                                           float(a));
+
+        self.cpp_method.setParams(float(xi), float(r_cut), int(Nx), int(Ny), int(Nz), int(order));
+        self.cpp_method.setLanczosParams(float(lanczos_tol), int(lanczos_max_iter));
+
+        self.cpp_method.validateGroup()
+
+        # store metadata
+        self.group = group
+        self.kT = kT
+        self.seed = seed
+        self.eta = eta
+        self.a = a
+        self.r_cut = r_cut
+        self.Nx = Nx
+        self.Ny = Ny
+        self.Nz = Nz
+        self.order = order
+        self.xi = xi
+        self.lanczos_tol = lanczos_tol
+        self.lanczos_max_iter = lanczos_max_iter
+        self.metadata_fields = ['group', 'kT', 'seed', 'eta', 'a', 'r_cut', 'Nx', 'Ny', 'Nz', 'order', 'xi',
+                                'lanczos_tol', 'lanczos_max_iter']
+
+    def set_params(self, kT=None, eta=None, a=None, lanczos_tol=None, lanczos_max_iter=None):
+        R""" Change brownian_rpy integrator parameters.
+
+        Args:
+            kT (:py:mod:`hoomd.variant` or :py:obj:`float`): New temperature (if set) (in energy units).
+            eta (float): New viscosity of the fluid (if set).
+            a (float): New hydrodynamic radius of the particles (if set).
+            lanczos_tol (float): New relative tolerance of the Lanczos method (if set).
+            lanczos_max_iter (int): New maximum number of Lanczos iterations (if set).
+
+        Examples::
+
+            integrator.set_params(kT=2.0)
+            integrator.set_params(eta=0.5, lanczos_tol=1e-3)
+
+        """
+        hoomd.util.print_status_line();
+        self.check_initialization();
+
+        # change the parameters
+        if kT is not None:
+            # setup the variant inputs
+            kT = hoomd.variant._setup_variant_input(kT);
+            self.cpp_method.setT(kT.cpp_variant);
+            self.kT = kT
+
+        if eta is not None or a is not None:
+            if eta is not None:
+                self.eta = eta
+            if a is not None:
+                self.a = a
+            self.cpp_method.setFluid(float(self.eta), float(self.a));
+
+        if lanczos_tol is not None or lanczos_max_iter is not None:
+            if lanczos_tol is not None:
+                self.lanczos_tol = lanczos_tol
+            if lanczos_max_iter is not None:
+                self.lanczos_max_iter = lanczos_max_iter
+            self.cpp_method.setLanczosParams(float(self.lanczos_tol), int(self.lanczos_max_iter));
+
 class mode_minimize_fire(_integrator):
     R""" Energy Minimizer (FIRE).
 
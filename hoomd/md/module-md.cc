@@ -25,6 +25,7 @@
 #include "ForceDistanceConstraint.h"
 #include "HarmonicAngleForceCompute.h"
 #include "CosineSqAngleForceCompute.h"
+#include "DLPackForceCompute.h"
 #include "HarmonicDihedralForceCompute.h"
 #include "HarmonicImproperForceCompute.h"
 #include "IntegrationMethodTwoStep.h"
@@ -41,12 +42,14 @@
 #include "PotentialPair.h"
 #include "PotentialTersoff.h"
 #include "PPPMForceCompute.h"
+#include "PPPMDipoleForceCompute.h"
 #include "QuaternionMath.h"
 #include "TableAngleForceCompute.h"
 #include "TableDihedralForceCompute.h"
 #include "TablePotential.h"
 #include "TempRescaleUpdater.h"
 #include "TwoStepBD.h"
+#include "TwoStepBDRPY.h"
 #include "TwoStepBerendsen.h"
 #include "TwoStepLangevinBase.h"
 #include "TwoStepLangevin.h"
@@ -69,6 +72,7 @@
 #include "FIREEnergyMinimizerGPU.h"
 #include "ForceCompositeGPU.h"
 #include "ForceDistanceConstraintGPU.h"
+#include "FusedBondedForceComputeGPU.h"
 #include "HarmonicAngleForceComputeGPU.h"
 #include "CosineSqAngleForceComputeGPU.h"
 #include "HarmonicDihedralForceComputeGPU.h"
@@ -123,7 +127,14 @@ void export_tersoff_params(py::module& m)
 }
 
 //! Helper function for converting python wall group structure to wall_type
-wall_type make_wall_field_params(py::object walls, std::shared_ptr<const ExecutionConfiguration> m_exec_conf)
+/*! \param walls Python wall group
+    \param m_exec_conf Execution configuration
+    \param box Simulation box covered by the culling grid
+    \param r_max Largest cutoff radius or extrapolation distance of all particle types
+    \param extrapolated True if any particle type uses the extrapolated mode
+*/
+wall_type make_wall_field_params(py::object walls, std::shared_ptr<const ExecutionConfiguration> m_exec_conf,
+    const BoxDim& box, Scalar r_max, bool extrapolated)
     {
     wall_type w;
     py::list walls_spheres = walls.attr("spheres").cast<py::list>();
@@ -163,6 +174,7 @@ wall_type make_wall_field_params(py::object walls, std::shared_ptr<const Executi
             bool    inside =py::cast<bool>(py::object(walls_planes[i]).attr("inside"));
             w.Planes[i] = PlaneWall(origin, normal, inside);
             }
+        buildWallCells(w, box, r_max, extrapolated);
         return w;
         }
     }
@@ -197,6 +209,7 @@ PYBIND11_MODULE(_md, m)
     {
     export_ActiveForceCompute(m);
     export_ConstExternalFieldDipoleForceCompute(m);
+    export_DLPackForceCompute(m);
     export_HarmonicAngleForceCompute(m);
     export_CosineSqAngleForceCompute(m);
     export_TableAngleForceCompute(m);
@@ -225,6 +238,7 @@ PYBIND11_MODULE(_md, m)
     export_tersoff_params(m);
     export_AnisoPotentialPair<AnisoPotentialPairGB>(m, "AnisoPotentialPairGB");
     export_AnisoPotentialPair<AnisoPotentialPairDipole>(m, "AnisoPotentialPairDipole");
+    export_AnisoPotentialPair<AnisoPotentialPairDipoleEwald>(m, "AnisoPotentialPairDipoleEwald");
     export_PotentialPair<PotentialPairForceShiftedLJ>(m, "PotentialPairForceShiftedLJ");
     export_PotentialPairDPDThermo<PotentialPairDPDThermoDPD, PotentialPairDPD>(m, "PotentialPairDPDThermoDPD");
     export_PotentialPair<PotentialPairDPDLJ>(m, "PotentialPairDPDLJ");
@@ -243,6 +257,7 @@ PYBIND11_MODULE(_md, m)
     export_ForceDistanceConstraint(m);
     export_ForceComposite(m);
     export_PPPMForceCompute(m);
+    export_PPPMDipoleForceCompute(m);
     py::class_< wall_type, std::shared_ptr<wall_type> >(m, "wall_type")
         .def(py::init<>());
     m.def("make_wall_field_params", &make_wall_field_params);
@@ -284,6 +299,7 @@ PYBIND11_MODULE(_md, m)
     export_PotentialPairDPDThermoGPU<PotentialPairDPDLJThermoDPDGPU, PotentialPairDPDLJThermoDPD >(m, "PotentialPairDPDLJThermoDPDGPU");
     export_AnisoPotentialPairGPU<AnisoPotentialPairGBGPU, AnisoPotentialPairGB>(m, "AnisoPotentialPairGBGPU");
     export_AnisoPotentialPairGPU<AnisoPotentialPairDipoleGPU, AnisoPotentialPairDipole>(m, "AnisoPotentialPairDipoleGPU");
+    export_AnisoPotentialPairGPU<AnisoPotentialPairDipoleEwaldGPU, AnisoPotentialPairDipoleEwald>(m, "AnisoPotentialPairDipoleEwaldGPU");
     export_PotentialBondGPU<PotentialBondHarmonicGPU, PotentialBondHarmonic>(m, "PotentialBondHarmonicGPU");
     export_PotentialBondGPU<PotentialBondFENEGPU, PotentialBondFENE>(m, "PotentialBondFENEGPU");
     export_PotentialSpecialPairGPU<PotentialSpecialPairLJGPU, PotentialSpecialPairLJ>(m, "PotentialSpecialPairLJGPU");
@@ -300,6 +316,7 @@ PYBIND11_MODULE(_md, m)
     export_ConstraintSphereGPU(m);
     export_OneDConstraintGPU(m);
     export_ForceDistanceConstraintGPU(m);
+    export_FusedBondedForceComputeGPU(m);
     // export_ConstExternalFieldDipoleForceComputeGPU(m);
     export_PPPMForceComputeGPU(m);
     export_ActiveForceComputeGPU(m);
@@ -324,6 +341,7 @@ PYBIND11_MODULE(_md, m)
     export_TwoStepLangevinBase(m);
     export_TwoStepLangevin(m);
     export_TwoStepBD(m);
+    export_TwoStepBDRPY(m);
     export_TwoStepNPTMTK(m);
     export_Berendsen(m);
     export_Enforce2DUpdater(m);
@@ -114,7 +114,8 @@ class nlist:
             self.reset_exclusions(exclusions=['body', 'bond','constraint']);
             hoomd.util.unquiet_status();
 
-    def set_params(self, r_buff=None, check_period=None, d_max=None, dist_check=True):
+    def set_params(self, r_buff=None, check_period=None, d_max=None, dist_check=True, cluster_pairs=None,
+                   deferred_check=None, exact_storage=None, storage_slack=4):
         R""" Change neighbor list parameters.
 
         Args:
@@ -126,6 +127,14 @@ class nlist:
               run() commands. (in distance units)
             dist_check (bool): When set to False, disable the distance checking logic and always regenerate the nlist every
               *check_period* steps
+            cluster_pairs (bool): (if set) When True, the GPU pair potentials evaluate the forces from a cluster-pair
+              list derived from the neighbor list (GPU only)
+            deferred_check (bool): (if set) When True, the result of the distance check is read back from the GPU one
+              time step later (GPU only)
+            exact_storage (bool): (if set) When True, the storage of each particle is sized by its own number of
+              neighbors instead of the largest number of neighbors of its type
+            storage_slack (int): Number of neighbors reserved for each particle in addition to its count in the last
+              build, used with *exact_storage*
 
         :py:meth:`set_params()` changes one or more parameters of the neighbor list. *r_buff* and *check_period*
         can have a significant effect on performance. As *r_buff* is made larger, the neighbor list needs
@@ -159,12 +168,38 @@ class nlist:
             **MUST** be left at the default value of 1.0 or the simulation will be incorrect if d_max is less than 1.0
             and slower than necessary if d_max is greater than 1.0.
 
+        With *cluster_pairs*, the local particles are grouped into clusters of 8 consecutive indices after every
+        neighbor list update. The pair potentials then evaluate all pairs between two clusters in an 8x8 tile
+        and share the positions of the neighboring clusters among the threads of a block, with a bit mask selecting
+        the pairs that are in the neighbor list. This is most effective when the particles are sorted
+        (the default), and is ignored when running on the CPU and by potentials which do not support it.
+
+        With *deferred_check*, the host does not wait for the distance check kernel to complete. The rebuild is
+        decided from the check of the previous time step, which also tests a reduced buffer so that the list is
+        rebuilt one step early. When a particle moved by more than the full buffer in a single step, the
+        rebuild happens one step late, and this is counted as a *dangerous build*. This mode is most effective
+        for small systems, whose time steps are limited by the latency of the kernel launches.
+
+        By default, every particle reserves the largest number of neighbors of any particle of the same type. With
+        *exact_storage*, each particle reserves the number of neighbors it had in the last build plus
+        *storage_slack*, which reduces the memory of the neighbor list in polydisperse or clustered systems where a
+        few crowded particles have many more neighbors than the rest. When a particle exceeds its storage, the
+        neighbors of all particles are counted, the storage is laid out from the exact counts, and the list is built
+        a second time. Increase *storage_slack* if the neighbor list statistics at the end of a run report many
+        overflow rebuilds.
+
+        .. versionadded:: 2.5
+            *exact_storage*, *storage_slack*
+
         Examples::
 
             nl.set_params(r_buff = 0.9)
             nl.set_params(check_period = 11)
             nl.set_params(r_buff = 0.7, check_period = 4)
             nl.set_params(d_max = 3.0)
+            nl.set_params(cluster_pairs = True)
+            nl.set_params(deferred_check = True)
+            nl.set_params(exact_storage = True, storage_slack = 2)
         """
         hoomd.util.print_status_line();
 
@@ -183,6 +218,62 @@ class nlist:
         if d_max is not None:
             self.cpp_nlist.setMaximumDiameter(d_max);
 
+        if cluster_pairs is not None:
+            if hoomd.context.exec_conf.isCUDAEnabled():
+                self.cpp_nlist.setClusterPairs(cluster_pairs);
+            else:
+                hoomd.context.msg.notice(2, "nlist: cluster_pairs is only supported on the GPU, ignoring\n");
+
+        if deferred_check is not None:
+            if hoomd.context.exec_conf.isCUDAEnabled():
+                self.cpp_nlist.setDeferredCheck(deferred_check);
+            else:
+                hoomd.context.msg.notice(2, "nlist: deferred_check is only supported on the GPU, ignoring\n");
+
+        if exact_storage is not None:
+            self.cpp_nlist.setExactStorage(exact_storage, int(storage_slack));
+
+    def set_autotune(self, enable=True, r_buff_min=0.05, r_buff_max=1.0, period=1000):
+        R""" Tune r_buff and check_period while the simulation runs.
+
+        Args:
+            enable (bool): Set to False to disable the tuner and keep the current parameters
+            r_buff_min (float): Smallest value of r_buff to set (in distance units)
+            r_buff_max (float): Largest value of r_buff to set (in distance units)
+            period (int): Number of time steps over which each measurement of the time per step is averaged
+
+        Unlike :py:meth:`tune()`, which scans a list of *r_buff* values in separate :py:func:`hoomd.run()` calls,
+        the online tuner adjusts the parameters during the production run. After every *period* time steps, it moves
+        *r_buff* in the direction that reduces the wall clock time per step, and halves the step size when neither
+        direction helps, until the step size drops below 1/64 of the range. It restarts when the time per
+        step at the optimum grows by more than 20%, e.g. when the density changes.
+
+        When distance checks are enabled, the check period is set to half of the smallest rebuild period seen during
+        the last measurement, and halved after any dangerous build.
+
+        In MPI simulations, all ranks use the slowest time per step, and *r_buff* is limited so that the ghost layer
+        fits in the local domains.
+
+        Measurements are restarted at the beginning of every :py:func:`hoomd.run()`, so *period* should be
+        much smaller than the length of the runs. Choose it to cover several neighbor list builds.
+        The *r_buff* attribute of this object is not updated by the tuner.
+
+        .. versionadded:: 2.5
+
+        Examples::
+
+            nl.set_autotune()
+            nl.set_autotune(r_buff_min=0.2, r_buff_max=0.8, period=2000)
+            nl.set_autotune(enable=False)
+        """
+        hoomd.util.print_status_line();
+
+        if self.cpp_nlist is None:
+            hoomd.context.msg.error('Bug in hoomd: cpp_nlist not set, please report\n');
+            raise RuntimeError('Error setting neighbor list parameters');
+
+        self.cpp_nlist.setRBuffTuner(bool(enable), float(r_buff_min), float(r_buff_max), int(period));
+
     def reset_exclusions(self, exclusions = None):
         R""" Resets all exclusions in the neighborlist.
 
@@ -599,6 +690,7 @@ class stencil(nlist):
         cell_width (float): The underlying stencil bin width for the cell list
         name (str): Optional name for this neighbor list instance.
         deterministic (bool): When True, enable deterministic runs on the GPU by sorting the cell list.
+        multi_level (bool): When True, bin each class of cutoff radii in its own cell list.
 
     :py:class:`stencil` creates a cell list based neighbor list object to which pair potentials can be attached for computing
     non-bonded pairwise interactions. Cell listing allows for O(N) construction of the neighbor list. Particles are first
@@ -615,6 +707,12 @@ class stencil(nlist):
     quickly excluded from the neighbor list, leading to improved performance compared to :py:class:`cell` when there is size
     disparity in the cutoff radius.
 
+    When *multi_level* is True, the particle types are grouped into classes by the largest cutoff radius that they
+    participate in, starting a new class whenever this radius more than doubles. Each class is binned into its own
+    cell list with a cell width set by the shortest cutoff radius of any pair involving the class, and every type pair
+    is searched in the cell list of its partner class. This avoids searching the large stencils of, e.g., colloids in
+    a solvent through cells full of solvent particles. If all types fall into one class, a single cell list is used.
+
     The performance of the stencil depends strongly on the choice of *cell_width*. The best performance is obtained
     when the cutoff radii are multiples of the *cell_width*, and when the *cell_width* covers the simulation box with
     a roughly integer number of cells. The *cell_width* can be set manually, or be automatically scanning through a range
@@ -633,7 +731,7 @@ class stencil(nlist):
         is the only pair potential requiring this shifting, and setting *d_max* for other potentials may lead to
         significantly degraded performance or incorrect results.
     """
-    def __init__(self, r_buff=0.4, check_period=1, d_max=None, dist_check=True, cell_width=None, name=None, deterministic=False):
+    def __init__(self, r_buff=0.4, check_period=1, d_max=None, dist_check=True, cell_width=None, name=None, deterministic=False, multi_level=True):
         hoomd.util.print_status_line()
 
         # register the citation
@@ -675,6 +773,7 @@ class stencil(nlist):
 
         hoomd.context.current.system.addCompute(self.cpp_nlist, self.name)
         self.cpp_cl.setSortCellList(deterministic)
+        self.cpp_nlist.setMultiLevel(multi_level)
 
         # register this neighbor list with the context
         hoomd.context.current.neighbor_lists += [self]
@@ -865,4 +964,35 @@ class tree(nlist):
         hoomd.util.quiet_status()
         self.set_params(r_buff, check_period, d_max, dist_check)
         hoomd.util.unquiet_status()
+
+    def set_refit(self, period, threshold=1.5):
+        R""" Refit the tree between rebuilds.
+
+        Args:
+            period (int): Rebuild the tree at least every *period* neighbor list builds, and refit it in between.
+              Values of 1 and below disable refitting (the default).
+            threshold (float): Rebuild the tree early when the summed surface area of its nodes has grown by more than
+              this factor since the last rebuild. Values of 1 and below disable this check.
+
+        A refit recomputes the bounding boxes of the existing tree from the current particle positions, skipping the
+        Morton code sort and the hierarchy generation. The tree loosens as particles diffuse away from the positions
+        at which it was built, which makes the traversal slower, so it is rebuilt periodically. The tree is always
+        rebuilt after the particles are sorted.
+
+        Refitting is only implemented on the GPU and is disabled in MPI simulations.
+
+        .. versionadded:: 2.5
+
+        Examples::
+
+            nl_t.set_refit(period=10)
+            nl_t.set_refit(period=20, threshold=1.2)
+        """
+        hoomd.util.print_status_line()
+
+        if not hoomd.context.exec_conf.isCUDAEnabled():
+            hoomd.context.msg.notice(2, "nlist.tree: refitting is only implemented on the GPU, ignoring set_refit\n")
+            return
+
+        self.cpp_nlist.setRefitParams(int(period), float(threshold))
 tree.cur_id = 0
@@ -374,11 +374,14 @@ class pair(force._force):
         self.nlist.subscribe(lambda:self.get_rcut())
         self.nlist.update_rcut()
 
-    def set_params(self, mode=None):
+    def set_params(self, mode=None, cell_pairs=None, special_scale=None):
         R""" Set parameters controlling the way forces are computed.
 
         Args:
             mode (str): (if set) Set the mode with which potentials are handled at the cutoff.
+            cell_pairs (bool): (if set) When True, evaluate the forces directly from a cell list instead of the
+              neighbor list.
+            special_scale (float): (if set) Scale factor of the force and energy of the special pairs.
 
         Valid values for *mode* are: "none" (the default), "shift", and "xplor":
 
@@ -389,15 +392,47 @@ class pair(force._force):
 
         See :py:class:`pair` for the equations.
 
+        With *cell_pairs* enabled, the pair force loops over all particles in the neighboring cells of a cell list
+        with a width of the largest *r_cut* of this potential, which is rebuilt every time step. The neighbor list
+        is not built or stored for this potential, but its exclusions and body filter still apply. This saves memory
+        and pays off when the neighbor list would be rebuilt (nearly) every step anyway, such as in soft DPD fluids,
+        at the cost of more distance checks. *cell_pairs* is not available in MPI simulations.
+
+        With *special_scale*, the special pairs of the system (see :py:mod:`hoomd.md.special_pair`) are evaluated
+        with this potential in the same pass as all other pairs, and their force and energy are multiplied by
+        *special_scale* (e.g. 0.5 for the OPLS 1-4 interactions). This replaces a separate special pair potential with
+        ``'pair'`` in the exclusions. The neighbor list must not exclude ``'pair'``, and the two particles of every
+        special pair must be at most 16 tags apart. The special pairs are read from the system once, when the first
+        potential on the neighbor list sets *special_scale*. *special_scale* is not available with *cell_pairs*.
+
+        .. versionadded:: 2.5
+           *special_scale*
+
         Examples::
 
             mypair.set_params(mode="shift")
             mypair.set_params(mode="no_shift")
             mypair.set_params(mode="xplor")
+            mypair.set_params(cell_pairs=True)
+            mypair.set_params(special_scale=0.5)
 
         """
         hoomd.util.print_status_line();
 
+        if special_scale is not None:
+            if self.nlist.exclusions is not None and 'pair' in self.nlist.exclusions:
+                hoomd.context.msg.error("special_scale requires a neighbor list that does not exclude 'pair'\n");
+                raise RuntimeError("Error changing parameters in pair force");
+            if not self.nlist.cpp_nlist.getSpecialPairsSet():
+                self.nlist.cpp_nlist.addSpecialPairsFromPairs();
+            self.cpp_force.setSpecialPairScale(float(special_scale));
+
+        if cell_pairs is not None:
+            if cell_pairs and hoomd.comm.get_num_ranks() > 1:
+                hoomd.context.msg.error("cell_pairs is not supported in MPI simulations\n");
+                raise RuntimeError("Error changing parameters in pair force");
+            self.cpp_force.setCellPairs(bool(cell_pairs));
+
         if mode is not None:
             if mode == "no_shift":
                 self.cpp_force.setShiftMode(self.cpp_class.energyShiftMode.no_shift)
@@ -897,7 +932,14 @@ class ewald(pair):
       - *optional*: defaults to the global r_cut specified in the pair command
     - :math:`r_{\mathrm{on}}`- *r_on* (in distance units)
       - *optional*: defaults to the global r_cut specified in the pair command
+    - *erfc_tol* - largest acceptable absolute error of erfc (dimensionless)
+      - *optional*: defaults to 0.0, erfc is evaluated exactly
+        .. versionadded:: 2.5
 
+    With *erfc_tol* of at least 1.5e-7, erfc is replaced by a five term rational approximation (Abramowitz and
+    Stegun 7.1.26), and with *erfc_tol* of at least 2.5e-5 by a three term one (7.1.25). The approximations
+    avoid the evaluation of erfc and share the exponentials between the two terms of the potential and the force,
+    which is much faster in double precision on GPUs with low double precision throughput.
 
     Example::
 
@@ -906,6 +948,7 @@ class ewald(pair):
         ewald.pair_coeff.set('A', 'A', kappa=1.0)
         ewald.pair_coeff.set('A', 'A', kappa=1.0, alpha=1.5)
         ewald.pair_coeff.set('A', 'B', kappa=1.0, r_cut=3.0, r_on=2.0);
+        ewald.pair_coeff.set('A', 'A', kappa=1.0, erfc_tol=1e-6)
 
     Warning:
         **DO NOT** use in conjunction with :py:class:`hoomd.md.charge.pppm`. It automatically creates and configures
@@ -932,14 +975,24 @@ class ewald(pair):
         hoomd.context.current.system.addCompute(self.cpp_force, self.force_name);
 
         # setup the coefficient options
-        self.required_coeffs = ['kappa','alpha'];
+        self.required_coeffs = ['kappa','alpha','erfc_tol'];
         self.pair_coeff.set_default_coeff('alpha', 0.0);
+        self.pair_coeff.set_default_coeff('erfc_tol', 0.0);
 
     def process_coeff(self, coeff):
         kappa = coeff['kappa'];
         alpha = coeff['alpha'];
+        erfc_tol = coeff['erfc_tol'];
+
+        # choose the fastest erfc evaluation within the tolerance
+        if erfc_tol >= 2.5e-5:
+            mode = 2;
+        elif erfc_tol >= 1.5e-7:
+            mode = 1;
+        else:
+            mode = 0;
 
-        return _hoomd.make_scalar2(kappa, alpha)
+        return _hoomd.make_scalar3(kappa, alpha, _hoomd.int_as_scalar(mode))
 
     def set_params(self, coeff):
         """ :py:class:`ewald` has no energy shift modes """
@@ -1118,6 +1171,31 @@ class table(force._force):
 
         return maxrmax;
 
+    def set_params(self, interpolation=None):
+        R""" Set parameters of the table evaluation.
+
+        Args:
+            interpolation (str): (if set) Interpolation of the table, either 'linear' or 'cubic'
+
+        By default, the potential and force are interpolated linearly between the table points, which needs fine
+        tables for accurate forces. With ``interpolation='cubic'``, every interval is evaluated with the cubic
+        Hermite polynomial that matches *V* and *F* at both of its ends. The force is then the exact derivative of the
+        interpolated potential, and coarser tables reach the same accuracy.
+
+        Examples::
+
+            table.set_params(interpolation='cubic')
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+
+        if interpolation is not None:
+            if interpolation not in ('linear', 'cubic'):
+                hoomd.context.msg.error("pair.table: interpolation must be 'linear' or 'cubic'\n");
+                raise RuntimeError("Error setting pair.table parameters");
+            self.cpp_force.setCubicInterpolation(interpolation == 'cubic');
+
     def update_coeffs(self):
         # check that the pair coefficients are valid
         if not self.pair_coeff.verify(["func", "rmin", "rmax", "coeff"]):
@@ -1408,15 +1486,17 @@ class dpd(pair):
         kT = hoomd.variant._setup_variant_input(kT);
         self.cpp_force.setT(kT.cpp_variant);
 
-    def set_params(self, kT=None):
+    def set_params(self, kT=None, cell_pairs=None):
         R""" Changes parameters.
 
         Args:
             kT (:py:mod:`hoomd.variant` or :py:obj:`float`): Temperature of thermostat (in energy units).
+            cell_pairs (bool): (if set) Evaluate the forces directly from a cell list, see :py:meth:`pair.set_params()`.
 
         Example::
 
             dpd.set_params(kT=2.0)
+            dpd.set_params(cell_pairs=True)
         """
         hoomd.util.print_status_line();
         self.check_initialization();
@@ -1427,6 +1507,12 @@ class dpd(pair):
             kT = hoomd.variant._setup_variant_input(kT);
             self.cpp_force.setT(kT.cpp_variant);
 
+        if cell_pairs is not None:
+            #use the inherited set_params
+            hoomd.util.quiet_status();
+            pair.set_params(self, cell_pairs=cell_pairs)
+            hoomd.util.unquiet_status();
+
     def process_coeff(self, coeff):
         a = coeff['A'];
         gamma = coeff['gamma'];
@@ -1650,17 +1736,19 @@ class dpdlj(pair):
         kT = hoomd.variant._setup_variant_input(kT);
         self.cpp_force.setT(kT.cpp_variant);
 
-    def set_params(self, kT=None, mode=None):
+    def set_params(self, kT=None, mode=None, cell_pairs=None):
         R""" Changes parameters.
 
         Args:
             T (:py:mod:`hoomd.variant` or :py:obj:`float`): Temperature (if set) (in energy units)
             mode (str): energy shift/smoothing mode (default noshift).
+            cell_pairs (bool): (if set) Evaluate the forces directly from a cell list, see :py:meth:`pair.set_params()`.
 
         Examples::
 
             dpdlj.set_params(kT=variant.linear_interp(points = [(0, 1.0), (1e5, 2.0)]))
             dpdlj.set_params(kT=2.0, mode="shift")
+            dpdlj.set_params(cell_pairs=True)
 
         """
         hoomd.util.print_status_line();
@@ -1680,6 +1768,11 @@ class dpdlj(pair):
             #use the inherited set_params
             pair.set_params(self, mode=mode)
 
+        if cell_pairs is not None:
+            hoomd.util.quiet_status();
+            pair.set_params(self, cell_pairs=cell_pairs)
+            hoomd.util.unquiet_status();
+
     def process_coeff(self, coeff):
         epsilon = coeff['epsilon'];
         sigma = coeff['sigma'];
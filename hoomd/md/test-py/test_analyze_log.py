@@ -45,6 +45,28 @@ class analyze_log_tests (unittest.TestCase):
         ana.set_params(quantities = [u'test4', u'test5'], delimiter=',')
         hoomd.run(100);
 
+    # test buffered and asynchronous writes
+    def test_buffer_rows(self):
+        ana = hoomd.analyze.log(quantities = ['test1', 'test2', 'test3'], period = 10, filename=self.tmp_file, overwrite=True);
+        ana.set_params(buffer_rows=4);
+        hoomd.run(100);
+        ana.set_params(async_write=True);
+        hoomd.run(100);
+        ana.set_params(async_write=False, buffer_rows=1);
+        hoomd.run(10);
+
+        # all rows are in the file at the end of each run
+        if hoomd.comm.get_rank() == 0:
+            with open(self.tmp_file) as f:
+                lines = f.readlines();
+            self.assertEqual(len(lines), 1 + 21);
+            self.assertEqual(lines[-1].split()[0], '200');
+
+    # test that buffer_rows must be positive
+    def test_buffer_rows_invalid(self):
+        ana = hoomd.analyze.log(quantities = ['test1'], period = 10, filename=self.tmp_file);
+        self.assertRaises(RuntimeError, ana.set_params, buffer_rows=0);
+
     # test variable period
     def test_variable(self):
         ana = hoomd.analyze.log(quantities = ['test1', 'test2', 'test3'], period = lambda n: n*10, filename=self.tmp_file);
@@ -96,6 +118,24 @@ class analyze_log_query_tests (unittest.TestCase):
         self.assertNotEqual(U0, U1);
         self.assertNotEqual(K0, K1);
 
+    # tests the memory usage quantities
+    def test_memory(self):
+        log = hoomd.analyze.log(quantities = ['memory_total_host', 'memory_total_host_peak',
+                                              'memory_ParticleData_host', 'memory_NeighborList_host_peak',
+                                              'memory_unknown_device'], period = 10, filename=None);
+        hoomd.run(11);
+        total = log.query('memory_total_host');
+        peak = log.query('memory_total_host_peak');
+        pdata = log.query('memory_ParticleData_host');
+        nlist = log.query('memory_NeighborList_host_peak');
+
+        self.assertGreater(total, 0);
+        self.assertGreaterEqual(peak, total);
+        self.assertGreater(pdata, 0);
+        self.assertGreater(nlist, 0);
+        self.assertGreaterEqual(total, pdata);
+        self.assertEqual(log.query('memory_unknown_device'), 0);
+
     # tests basic creation of the analyzer
     def test_with_file(self):
         if hoomd.comm.get_rank() == 0:
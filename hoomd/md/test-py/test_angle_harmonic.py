@@ -51,6 +51,22 @@ class angle_harmonic_tests (unittest.TestCase):
         md.integrate.nve(all);
         run(100);
 
+    # test that the group-centric evaluation reproduces the per-particle forces
+    def test_group_centric(self):
+        harmonic = md.angle.harmonic();
+        harmonic.angle_coeff.set('angleA', k=1.0, t0=0.78125)
+        harmonic_group = md.angle.harmonic();
+        harmonic_group.angle_coeff.set('angleA', k=1.0, t0=0.78125)
+        harmonic_group.set_params(group_centric=True)
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(group.all());
+        run(1);
+
+        self.assertAlmostEqual(harmonic.get_energy(group.all()), harmonic_group.get_energy(group.all()), 4)
+        for i in range(40):
+            for k in range(3):
+                self.assertAlmostEqual(harmonic.forces[i].force[k], harmonic_group.forces[i].force[k], 4)
+
     # test coefficient not set checking
     def test_set_coeff_fail(self):
         harmonic = md.angle.harmonic();
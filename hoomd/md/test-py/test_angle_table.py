@@ -88,6 +88,27 @@ class angle_table_tests (unittest.TestCase):
             numpy.testing.assert_allclose(f_1.force[1], f_2.force[1],rtol=0.01)
             numpy.testing.assert_allclose(f_1.force[2], f_2.force[2],rtol=0.01)
 
+    # compare a coarse cubic table against harmonic angle
+    def test_harmonic_compare_cubic(self):
+        harmonic_1 = md.angle.table(width=20)
+        harmonic_1.angle_coeff.set('angleA', func=lambda theta: (0.5*1*theta*theta, -theta), coeff=dict())
+        harmonic_1.set_params(interpolation='cubic')
+        self.assertRaises(RuntimeError, harmonic_1.set_params, interpolation='quintic')
+        harmonic_2 = md.angle.harmonic()
+        harmonic_2.angle_coeff.set('angleA', k=1.0, t0=0)
+        md.integrate.mode_standard(dt=0.005);
+        all = group.all()
+        md.integrate.nve(all)
+        run(1)
+        for i in range(len(self.sys.particles)):
+            f_1 = harmonic_1.forces[i]
+            f_2 = harmonic_2.forces[i]
+            # the cubic polynomials reproduce the harmonic potential up to round off
+            numpy.testing.assert_allclose(f_1.energy, f_2.energy,rtol=0.001)
+            numpy.testing.assert_allclose(f_1.force[0], f_2.force[0],rtol=0.01)
+            numpy.testing.assert_allclose(f_1.force[1], f_2.force[1],rtol=0.01)
+            numpy.testing.assert_allclose(f_1.force[2], f_2.force[2],rtol=0.01)
+
     def tearDown(self):
         del self.sys
         context.initialize();
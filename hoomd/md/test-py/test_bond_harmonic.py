@@ -27,6 +27,40 @@ class bond_harmonic_tests (unittest.TestCase):
         md.integrate.nve(all);
         run(100);
 
+    # test that the group-centric evaluation reproduces the per-particle forces
+    def test_group_centric(self):
+        harmonic = md.bond.harmonic();
+        harmonic.bond_coeff.set('polymer', k=1.0, r0=1.0)
+        harmonic_group = md.bond.harmonic();
+        harmonic_group.bond_coeff.set('polymer', k=1.0, r0=1.0)
+        harmonic_group.set_params(group_centric=True)
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(group.all());
+        run(1);
+
+        self.assertAlmostEqual(harmonic.get_energy(group.all()), harmonic_group.get_energy(group.all()), 4)
+        for i in range(0, len(self.s.particles), 7):
+            for k in range(3):
+                self.assertAlmostEqual(harmonic.forces[i].force[k], harmonic_group.forces[i].force[k], 4)
+            for k in range(6):
+                self.assertAlmostEqual(harmonic.forces[i].virial[k], harmonic_group.forces[i].virial[k], 4)
+
+        harmonic_group.set_params(group_centric=False)
+        run(1);
+
+    # test that the energies are available when no logger requests them during the run
+    def test_energy_on_demand(self):
+        harmonic = md.bond.harmonic();
+        harmonic.bond_coeff.set('polymer', k=1.0, r0=0.5)
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(group.all());
+        run(1);
+
+        energy = harmonic.get_energy(group.all())
+        self.assertNotEqual(energy, 0.0)
+        if comm.get_num_ranks() == 1:
+            self.assertAlmostEqual(energy, sum(harmonic.forces[i].energy for i in range(len(self.s.particles))), 4)
+
     # test coefficient not set checking
     def test_set_coeff_fail(self):
         harmonic = md.bond.harmonic();
@@ -3,6 +3,7 @@
 
 from hoomd import *
 from hoomd import md
+from hoomd import _hoomd
 import unittest
 import os
 
@@ -32,6 +33,42 @@ class charge_pppm_tests (unittest.TestCase):
         del all
         del c
 
+    # test the RMS error estimate log quantity
+    def test_rms_error(self):
+        all = group.all()
+        nl = md.nlist.cell()
+        c = md.charge.pppm(all, nlist = nl);
+        c.set_params(Nx=16, Ny=16, Nz=16, order=4, rcut=2.0);
+        log = analyze.log(quantities = ['pppm_rms_error'], period = 1, filename=None);
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(all);
+        run(1);
+
+        self.assertGreater(log.query('pppm_rms_error'), 0)
+
+        del all
+        del c
+        del log
+
+    # test that the tuned parameters reach the accuracy
+    def test_tune(self):
+        all = group.all()
+        nl = md.nlist.cell()
+        c = md.charge.pppm(all, nlist = nl);
+        log = analyze.log(quantities = ['pppm_rms_error'], period = 1, filename=None);
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(all);
+        (Nx, Ny, Nz, order, rcut) = c.tune(accuracy=1e-2, rcut=[1.5, 2.0], order=[4, 5], warmup=10, steps=10);
+        self.assertIn(order, [4, 5])
+        self.assertIn(rcut, [1.5, 2.0])
+        run(1);
+
+        self.assertLessEqual(log.query('pppm_rms_error'), 1e-2*(1+1e-6))
+
+        del all
+        del c
+        del log
+
     # Cannot test pppm multiple times currently because of implementation limitations
     ## test missing coefficients
     #def test_set_missing_coeff(self):
@@ -117,6 +154,46 @@ class charge_pppm_twoparticle_tests (unittest.TestCase):
         del c
         del log
 
+    # test that the FFT backends give the same forces and energy
+    def test_fft_backend(self):
+        all = group.all()
+        nl = md.nlist.cell()
+        c = md.charge.pppm(all, nlist = nl);
+        log = analyze.log(quantities = ['pppm_energy'], period = 1, filename=None);
+        md.integrate.mode_standard(dt=0.0);
+        md.integrate.nve(all);
+        nl.set_params(r_buff=0.1)
+
+        backends = ['kiss', 'auto'];
+        if 'FFTW' in _hoomd.hoomd_compile_flags():
+            backends.append('fftw');
+
+        ref_force = None;
+        for backend in backends:
+            c.set_params(Nx=128, Ny=128, Nz=128, order=3, rcut=2.0, fft_backend=backend);
+            run(1);
+
+            force = [c.forces[i].force for i in range(2)];
+            if ref_force is None:
+                ref_force = force;
+                ref_energy = log.query('pppm_energy');
+
+            for i in range(2):
+                for j in range(3):
+                    self.assertAlmostEqual(force[i][j], ref_force[i][j], 6)
+            self.assertAlmostEqual(log.query('pppm_energy'), ref_energy, 6)
+
+        self.assertAlmostEqual(ref_force[0][0], 0.00904953, 5)
+        self.assertAlmostEqual(ref_energy, -0.2441, 4)
+
+        if not context.exec_conf.isCUDAEnabled():
+            with self.assertRaises(RuntimeError):
+                c.set_params(Nx=128, Ny=128, Nz=128, order=3, rcut=2.0, fft_backend='foo');
+
+        del all
+        del c
+        del log
+
     # Cannot test pppm multiple times currently because of implementation limitations
     ## test missing coefficients
     #def test_set_missing_coeff(self):
@@ -0,0 +1,60 @@
+# -*- coding: iso-8859-1 -*-
+
+from hoomd import *
+from hoomd import md
+import unittest
+import os
+
+context.initialize()
+
+# charge.pppm_dipole
+class charge_pppm_dipole_tests (unittest.TestCase):
+    def setUp(self):
+        snap = data.make_snapshot(N=2, box=data.boxdim(L=20), particle_types=['A']);
+        if comm.get_rank() == 0:
+            snap.particles.position[0] = (0,0,0);
+            snap.particles.position[1] = (1.5,1.0,0);
+            # dipole of the second particle along y
+            snap.particles.orientation[1] = (0.7071067811865476,0,0,0.7071067811865476);
+            snap.particles.moment_inertia[:] = (1,1,1);
+        self.s = init.read_snapshot(snap);
+
+    # compare to the direct interaction of an isolated pair, the periodic images are far away
+    @unittest.skipIf(context.exec_conf.isCUDAEnabled(), "dipolar PPPM is CPU only")
+    def test_pair(self):
+        all = group.all()
+        nl = md.nlist.cell()
+        c = md.charge.pppm_dipole(all, nlist = nl);
+        c.set_params(Nx=32, Ny=32, Nz=32, order=5, rcut=4.0, mu=1.0);
+        log = analyze.log(quantities = ['pppm_dipole_energy', 'aniso_pair_dipole_ewald_energy'], period = 1, filename=None);
+        md.integrate.mode_standard(dt=1e-6);
+        md.integrate.nve(all);
+        run(1);
+
+        energy = log.query('pppm_dipole_energy') + log.query('aniso_pair_dipole_ewald_energy');
+        force = self.s.particles[0].net_force;
+        torque = self.s.particles[0].net_torque;
+
+        c.disable();
+        dipole = md.pair.dipole(r_cut=10.0, nlist = nl);
+        dipole.pair_coeff.set('A', 'A', mu=1.0, kappa=0.0);
+        log_ref = analyze.log(quantities = ['aniso_pair_dipole_energy'], period = 1, filename=None);
+        run(1);
+
+        self.assertAlmostEqual(energy, log_ref.query('aniso_pair_dipole_energy'), delta=5e-3);
+        for i in range(3):
+            self.assertAlmostEqual(force[i], self.s.particles[0].net_force[i], delta=5e-3);
+            self.assertAlmostEqual(torque[i], self.s.particles[0].net_torque[i], delta=5e-3);
+
+        del all
+        del c
+        del dipole
+        del log
+        del log_ref
+
+    def tearDown(self):
+        del self.s
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -75,6 +75,35 @@ class compute_thermo_tests (unittest.TestCase):
         numpy.testing.assert_allclose(log.query('temperature_A'), 2.0 / (3*self.N-3) * K_ref)
 
 
+    # Unit test: Validate the quantities of overlapping groups computed by thermo_multi
+    def test_multi(self):
+        lo = group.tag_list(name='lo', tags=range(0, self.N//2))
+        hi = group.tag_list(name='hi', tags=range(self.N//4, self.N))
+        compute.thermo_multi(groups=[lo, hi]);
+
+        quantities=['num_particles_lo', 'kinetic_energy_lo', 'temperature_lo', 'pressure_lo',
+                    'num_particles_hi', 'kinetic_energy_hi', 'temperature_hi', 'pressure_hi'];
+        log = analyze.log(filename=None, quantities=quantities, period=None);
+
+        # dummy integrator to apply appropriate degrees of freedom
+        md.integrate.mode_standard(dt=0.0);
+        md.integrate.nve(group=group.all());
+
+        run(1);
+
+        m = self.m;
+        v = self.v;
+        ke = 1/2 * m * (v[:,0]**2 + v[:,1]**2 + v[:,2]**2)
+        for g,tags in ((lo, range(0, self.N//2)), (hi, range(self.N//4, self.N))):
+            name = g.name
+            tags = numpy.array(tags)
+            K_ref = numpy.sum(ke[tags])
+            ndof = context.current.integrator.cpp_integrator.getNDOF(g.cpp_group)
+            numpy.testing.assert_allclose(log.query('num_particles_' + name), len(tags))
+            numpy.testing.assert_allclose(log.query('kinetic_energy_' + name), K_ref)
+            numpy.testing.assert_allclose(log.query('temperature_' + name), 2.0 / ndof * K_ref)
+            numpy.testing.assert_allclose(log.query('pressure_' + name), 2.0 / 3.0 * K_ref / 100**3)
+
     def tearDown(self):
         context.initialize();
 
@@ -84,6 +84,33 @@ class constrain_distance_tests (unittest.TestCase):
         constraint = md.constrain.distance()
         constraint.set_params(rel_tol=0.01)
 
+    # test the iterative solver
+    def test_iterative(self):
+        constraint = md.constrain.distance()
+        constraint.set_params(solver='iterative', n_iter=20)
+
+        md.integrate.mode_standard(dt=0.005)
+        md.integrate.nve(group=group.all())
+
+        run(100)
+
+        box = self.system.box
+        pos0 = self.system.particles[0].position
+        pos1 = self.system.particles[1].position
+        pos2 = self.system.particles[2].position
+
+        pos01 = box.min_image((pos0[0]-pos1[0], pos0[1]-pos1[1], pos0[2]-pos1[2]))
+        pos02 = box.min_image((pos0[0]-pos2[0], pos0[1]-pos2[1], pos0[2]-pos2[2]))
+        pos12 = box.min_image((pos2[0]-pos1[0], pos2[1]-pos1[1], pos2[2]-pos1[2]))
+
+        self.assertAlmostEqual(pos01[0]*pos01[0]+pos01[1]*pos01[1]+pos01[2]*pos01[2],1.5*1.5,4)
+        self.assertAlmostEqual(pos02[0]*pos02[0]+pos02[1]*pos02[1]+pos02[2]*pos02[2],1.5*1.5,4)
+        self.assertAlmostEqual(pos12[0]*pos12[0]+pos12[1]*pos12[1]+pos12[2]*pos12[2],2.0*1.5*1.5,4)
+
+        # invalid parameters
+        self.assertRaises(RuntimeError, constraint.set_params, solver='lincs')
+        self.assertRaises(RuntimeError, constraint.set_params, n_iter=0)
+
     # test remove particle fails
     def test_constraint_fail(self):
         constraint =  md.constrain.distance();
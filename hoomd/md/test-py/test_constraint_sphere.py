@@ -32,6 +32,23 @@ class constraint_sphere_tests (unittest.TestCase):
         pos1 = self.sysdef.particles[1].position
         self.assertAlmostEqual(pos1[0]*pos1[0]+pos1[1]*pos1[1]+pos1[2]*pos1[2],5*5,1)
 
+    # test applying the constraint in the second step of nve
+    def test_fused(self):
+        all = group.all()
+        self.sysdef.particles[0].velocity = (0,1,0);
+        self.sysdef.particles[1].velocity = (0,0,-1);
+        sphere = md.constrain.sphere(group=all, P=(0,0,0), r=5)
+        md.integrate.mode_standard(dt=0.005);
+        nve = md.integrate.nve(group=all);
+        nve.set_params(constraint=sphere);
+        run(100);
+        pos0 = self.sysdef.particles[0].position
+        self.assertAlmostEqual(pos0[0]*pos0[0]+pos0[1]*pos0[1]+pos0[2]*pos0[2],5*5,1)
+        pos1 = self.sysdef.particles[1].position
+        self.assertAlmostEqual(pos1[0]*pos1[0]+pos1[1]*pos1[1]+pos1[2]*pos1[2],5*5,1)
+        nve.set_params(constraint=False);
+        run(10);
+
     def test_error(self):
         all = group.all()
         self.assertRaises(RuntimeError, md.constrain.sphere, group=all, P=(0,0,0), r=10)
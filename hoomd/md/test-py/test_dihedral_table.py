@@ -87,6 +87,26 @@ class dihedral_table_tests (unittest.TestCase):
             self.assertAlmostEqual(f_1.force[1], f_2.force[1],1)
             self.assertAlmostEqual(f_1.force[2], f_2.force[2],1)
 
+    # compare a coarse cubic table against harmonic dihedral
+    def test_harmonic_compare_cubic(self):
+        harmonic_1 = md.dihedral.table(width=40)
+        harmonic_1.dihedral_coeff.set('dihedralA', func=lambda theta: (0.5*1*( 1 + math.cos(theta)), 0.5*1*math.sin(theta)),coeff=dict())
+        harmonic_1.set_params(interpolation='cubic')
+        self.assertRaises(RuntimeError, harmonic_1.set_params, interpolation='quintic')
+        harmonic_2 = md.dihedral.harmonic()
+        harmonic_2.dihedral_coeff.set('dihedralA', k=1.0, d=1,n=1)
+        md.integrate.mode_standard(dt=0.005);
+        all = group.all()
+        md.integrate.nve(all)
+        run(1)
+        for i in range(len(self.sys.particles)):
+            f_1 = harmonic_1.forces[i]
+            f_2 = harmonic_2.forces[i]
+            self.assertAlmostEqual(f_1.energy, f_2.energy,3)
+            self.assertAlmostEqual(f_1.force[0], f_2.force[0],1)
+            self.assertAlmostEqual(f_1.force[1], f_2.force[1],1)
+            self.assertAlmostEqual(f_1.force[2], f_2.force[2],1)
+
     # test set from file
     def test_set_from_file(self):
         harmonic = md.dihedral.table(width=5)
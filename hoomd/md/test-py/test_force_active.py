@@ -3,6 +3,7 @@
 
 from hoomd import *
 from hoomd import md
+from hoomd import _hoomd
 import unittest
 import os, math, numpy as np
 context.initialize();
@@ -39,6 +40,53 @@ class force_active_tests (unittest.TestCase):
         self.assertRaises(RuntimeError, act.enable);
         self.assertRaises(RuntimeError, act.disable);
 
+    # test that the forces are the given active forces without rotational diffusion
+    def test_forces(self):
+        np.random.seed(3)
+        activity = [ tuple(((np.random.rand(3) - 0.5) * 2.0)) for i in range(100)]
+        act = md.force.active(seed=3, f_lst=activity, group=group.all(), orientation_link=False)
+        md.integrate.mode_standard(dt=0.005)
+        md.integrate.nve(group=group.all())
+        run(1)
+
+        for i in range(100):
+            np.testing.assert_allclose(act.forces[i].force, activity[i], rtol=1e-5, atol=1e-10)
+
+    # test that rotational diffusion preserves the magnitude of the active forces
+    def test_diffusion_magnitude(self):
+        np.random.seed(4)
+        activity = [ tuple(((np.random.rand(3) - 0.5) * 2.0)) for i in range(100)]
+        act = md.force.active(seed=4, f_lst=activity, group=group.all(), rotation_diff=1.0, orientation_link=False)
+        md.integrate.mode_standard(dt=0.005)
+        md.integrate.nve(group=group.all())
+        run(10)
+
+        for i in range(100):
+            self.assertAlmostEqual(np.linalg.norm(act.forces[i].force), np.linalg.norm(activity[i]), places=5)
+
+    # test that the forces and the trajectory do not depend on the number of threads
+    @unittest.skipIf(not _hoomd.is_TBB_available(), "requires TBB")
+    def test_threads(self):
+        np.random.seed(5)
+        activity = [ tuple(((np.random.rand(3) - 0.5) * 2.0)) for i in range(100)]
+
+        def run_active(nthreads):
+            context.initialize()
+            system = init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4])
+            option.set_num_threads(nthreads)
+            act = md.force.active(seed=5, f_lst=activity, group=group.all(), rotation_diff=1.0, orientation_link=False)
+            md.integrate.mode_standard(dt=0.005)
+            md.integrate.nve(group=group.all())
+            run(20)
+            forces = [act.forces[i].force for i in range(100)]
+            positions = [system.particles[i].position for i in range(100)]
+            return forces, positions
+
+        forces_serial, pos_serial = run_active(1)
+        forces_threads, pos_threads = run_active(4)
+        np.testing.assert_allclose(forces_threads, forces_serial, rtol=1e-10, atol=1e-12)
+        np.testing.assert_allclose(pos_threads, pos_serial, rtol=1e-10, atol=1e-12)
+
     def tearDown(self):
         context.initialize();
 
@@ -37,6 +37,30 @@ class force_base_tests (unittest.TestCase):
         self.assertAlmostEqual(lj.get_net_force(g)[1], self.s.particles.get(0).net_force[1], places=5);
         self.assertAlmostEqual(lj.get_net_force(g)[2], self.s.particles.get(0).net_force[2], places=5);
 
+    # test that the net energy is complete when no logger requests the energies during the run
+    def test_net_energy_no_logger(self):
+        nl = md.nlist.cell()
+        lj = md.pair.lj(r_cut=3.0, nlist = nl);
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+
+        all = group.all();
+        md.integrate.mode_standard(dt=0.005)
+        md.integrate.nve(group=all)
+        run(10, quiet=True);
+
+        # read the net energy before the energy of the pair force
+        net_energy = [self.s.particles.get(i).net_energy for i in range(4)]
+        for i in range(4):
+            g = group.tag_list(name='ptl%d' % i, tags=[i])
+            energy = lj.get_energy(g)
+            self.assertNotEqual(energy, 0.0)
+            self.assertAlmostEqual(energy, net_energy[i], places=5);
+
+        # the net energy stays complete on the following steps
+        run(3, quiet=True);
+        g = group.tag_list(name='ptl_last', tags=[0])
+        self.assertAlmostEqual(self.s.particles.get(0).net_energy, lj.get_energy(g), places=5);
+
     def tearDown(self):
         self.s = None
         context.initialize();
@@ -0,0 +1,130 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+from hoomd import md
+context.initialize()
+import unittest
+import os
+import numpy
+
+# tests md.force.dlpack
+class force_dlpack_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        self.s = init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
+
+    # test to see that we can create a md.force.dlpack
+    def test_create(self):
+        md.force.dlpack(callback=lambda timestep, N, arrays: None);
+
+        nl = md.nlist.cell();
+        md.force.dlpack(callback=lambda timestep, N, arrays: None, r_cut=3.0, nlist=nl);
+
+    # a neighbor list needs a cutoff
+    def test_no_rcut(self):
+        nl = md.nlist.cell();
+        self.assertRaises(RuntimeError, md.force.dlpack, callback=lambda timestep, N, arrays: None, nlist=nl);
+
+    # test the names and devices of the shared arrays
+    def test_arrays(self):
+        self.names = None;
+        self.device = None;
+        def callback(timestep, N, arrays):
+            self.names = sorted(arrays.keys());
+            self.device = arrays['position'].__dlpack_device__();
+            self.N = N;
+
+        nl = md.nlist.cell();
+        ml = md.force.dlpack(callback=callback, r_cut=3.0, nlist=nl);
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(group=group.all());
+        run(1);
+
+        self.assertEqual(self.names, ['force', 'head_list', 'n_neigh', 'nlist', 'position', 'type', 'virial']);
+        self.assertEqual(self.N, self.s.particles.pdata.getN());
+        if context.exec_conf.isCUDAEnabled():
+            self.assertEqual(self.device[0], 2);
+            self.assertEqual(ml.get_stream(), 0);
+        else:
+            self.assertEqual(self.device, (1, 0));
+
+    # the arrays must not be used after the callback
+    def test_expired(self):
+        self.arrays = None;
+        def callback(timestep, N, arrays):
+            self.arrays = arrays;
+
+        md.force.dlpack(callback=callback);
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(group=group.all());
+        run(1);
+
+        self.assertRaises(RuntimeError, self.arrays['position'].__dlpack__);
+
+    # compute a harmonic trap in numpy and check the forces
+    @unittest.skipIf(context.exec_conf.isCUDAEnabled() or not hasattr(numpy, 'from_dlpack'),
+                     "numpy can only read host arrays")
+    def test_forces(self):
+        k = 2.0;
+        def callback(timestep, N, arrays):
+            pos = numpy.from_dlpack(arrays['position']);
+            force = numpy.from_dlpack(arrays['force']);
+            virial = numpy.from_dlpack(arrays['virial']);
+            force[:N,:3] = -k*pos[:N];
+            force[:N,3] = 0.5*k*numpy.sum(pos[:N]*pos[:N], axis=1);
+            virial[0,:N] = -k*pos[:N,0]*pos[:N,0];
+
+        trap = md.force.dlpack(callback=callback);
+        md.integrate.mode_standard(dt=0.0);
+        md.integrate.nve(group=group.all());
+        run(1);
+
+        snap = self.s.take_snapshot();
+        if comm.get_rank() == 0:
+            for tag in [0, 13, 99]:
+                r = snap.particles.position[tag];
+                f = trap.forces[tag];
+                numpy.testing.assert_allclose(f.force, -k*r, rtol=1e-5, atol=1e-5);
+                self.assertAlmostEqual(f.energy, 0.5*k*numpy.dot(r,r), 4);
+                self.assertAlmostEqual(f.virial[0], -k*r[0]*r[0], 4);
+
+    # check the shared neighbor list against a brute force count
+    @unittest.skipIf(context.exec_conf.isCUDAEnabled() or not hasattr(numpy, 'from_dlpack') or comm.get_num_ranks() > 1,
+                     "numpy can only read host arrays")
+    def test_nlist(self):
+        r_cut = 3.0;
+        def callback(timestep, N, arrays):
+            pos = numpy.from_dlpack(arrays['position']);
+            types = numpy.from_dlpack(arrays['type']);
+            self.assertTrue(numpy.all(types[:N] == 0));
+
+            head_list = numpy.from_dlpack(arrays['head_list']);
+            n_neigh = numpy.from_dlpack(arrays['n_neigh']);
+            nlist = numpy.from_dlpack(arrays['nlist']);
+
+            # every listed pair is within the cutoff plus buffer
+            L = numpy.array([self.s.box.Lx, self.s.box.Ly, self.s.box.Lz]);
+            for i in range(N):
+                neigh = nlist[head_list[i]:head_list[i]+n_neigh[i]];
+                dr = pos[neigh] - pos[i];
+                dr -= L*numpy.round(dr/L);
+                self.assertTrue(numpy.all(numpy.sum(dr*dr, axis=1) <= (r_cut+0.4)**2 + 1e-5));
+
+                dr = pos[:N] - pos[i];
+                dr -= L*numpy.round(dr/L);
+                dsq = numpy.sum(dr*dr, axis=1);
+                self.assertTrue(numpy.all(numpy.isin(numpy.nonzero((dsq < r_cut*r_cut) & (dsq > 0))[0], neigh)));
+
+        nl = md.nlist.cell(r_buff=0.4);
+        md.force.dlpack(callback=callback, r_cut=r_cut, nlist=nl);
+        md.integrate.mode_standard(dt=0.0);
+        md.integrate.nve(group=group.all());
+        run(1);
+
+    def tearDown(self):
+        del self.s
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
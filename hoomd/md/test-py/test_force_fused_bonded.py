@@ -0,0 +1,102 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+from hoomd import md
+context.initialize()
+import unittest
+import os
+import numpy
+
+# tests force.fused_bonded
+@unittest.skipIf(not context.exec_conf.isCUDAEnabled(), "force.fused_bonded is only available on the GPU")
+class force_fused_bonded_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        snap = data.make_snapshot(N=40,
+                                  box=data.boxdim(L=100),
+                                  particle_types = ['A'],
+                                  bond_types = ['bondA'],
+                                  angle_types = ['angleA'],
+                                  dihedral_types = ['dihedralA'],
+                                  improper_types = [])
+
+        if comm.get_rank() == 0:
+            snap.bonds.resize(30);
+            snap.angles.resize(20);
+            snap.dihedrals.resize(10);
+
+            for i in range(10):
+                x = numpy.array([i, 0, 0], dtype=numpy.float32)
+                snap.particles.position[4*i+0,:] = x;
+                x += numpy.random.random(3)
+                snap.particles.position[4*i+1,:] = x;
+                x += numpy.random.random(3)
+                snap.particles.position[4*i+2,:] = x;
+                x += numpy.random.random(3)
+                snap.particles.position[4*i+3,:] = x;
+
+                snap.bonds.group[3*i:3*i+3,:] = [[4*i+0, 4*i+1], [4*i+1, 4*i+2], [4*i+2, 4*i+3]];
+                snap.angles.group[2*i:2*i+2,:] = [[4*i+0, 4*i+1, 4*i+2], [4*i+1, 4*i+2, 4*i+3]];
+                snap.dihedrals.group[i,:] = [4*i+0, 4*i+1, 4*i+2, 4*i+3];
+
+        init.read_snapshot(snap)
+
+        context.current.sorter.set_params(grid=8)
+
+    def make_potentials(self):
+        bond = md.bond.harmonic();
+        bond.bond_coeff.set('bondA', k=10.0, r0=1.0)
+        angle = md.angle.harmonic();
+        angle.angle_coeff.set('angleA', k=1.0, t0=0.78125)
+        dihedral = md.dihedral.opls();
+        dihedral.dihedral_coeff.set('dihedralA', k1=1.0, k2=2.0, k3=3.0, k4=4.0)
+        return bond, angle, dihedral
+
+    # test that the fused compute matches the sum of the separate potentials
+    def test_compare(self):
+        bond, angle, dihedral = self.make_potentials()
+        fused = md.force.fused_bonded(*self.make_potentials())
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(group.all());
+        run(1);
+
+        all = group.all()
+        energy = bond.get_energy(all) + angle.get_energy(all) + dihedral.get_energy(all)
+        self.assertAlmostEqual(fused.get_energy(all), energy, 4)
+        for i in range(40):
+            for k in range(3):
+                f = bond.forces[i].force[k] + angle.forces[i].force[k] + dihedral.forces[i].force[k]
+                self.assertAlmostEqual(fused.forces[i].force[k], f, 4)
+
+    # test fusing a subset of the potentials
+    def test_bond_only(self):
+        bond = md.bond.harmonic();
+        bond.bond_coeff.set('bondA', k=10.0, r0=1.0)
+        fused = md.force.fused_bonded(bond=bond)
+        self.assertFalse(bond.enabled)
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(group.all());
+        run(10);
+
+    # test that the wrong potential types are rejected
+    def test_wrong_type(self):
+        fene = md.bond.fene();
+        self.assertRaises(RuntimeError, md.force.fused_bonded, bond=fene)
+        self.assertRaises(RuntimeError, md.force.fused_bonded)
+
+    # test coefficient not set checking
+    def test_set_coeff_fail(self):
+        bond = md.bond.harmonic();
+        md.force.fused_bonded(bond=bond)
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(group.all());
+        self.assertRaises(RuntimeError, run, 100);
+
+    def tearDown(self):
+        context.initialize();
+
+
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
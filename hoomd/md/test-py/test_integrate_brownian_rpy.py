@@ -0,0 +1,96 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+from hoomd import md;
+context.initialize()
+import unittest
+import os
+import math
+
+# unit tests for md.integrate.brownian_rpy
+class integrate_brownian_rpy_script_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        self.s = init.create_lattice(lattice.sc(a=2.5),n=[4,4,4]);
+
+        context.current.sorter.set_params(grid=8)
+
+    # tests basic creation of the integration method
+    def test(self):
+        all = group.all();
+        md.integrate.mode_standard(dt=0.005);
+        bd = md.integrate.brownian_rpy(all, kT=1.2, seed=52, eta=1.0, a=0.5, r_cut=3.0, Nx=16, Ny=16, Nz=16);
+        run(5);
+        bd.disable();
+        bd = md.integrate.brownian_rpy(all, kT=1.2, seed=1, eta=0.5, a=0.4, r_cut=2.0, Nx=16, Ny=16, Nz=16,
+                                       order=3, xi=1.5, lanczos_tol=1e-3, lanczos_max_iter=50);
+        run(5);
+        bd.disable();
+
+    # test set_params
+    def test_set_params(self):
+        all = group.all();
+        md.integrate.mode_standard(dt=0.005);
+        bd = md.integrate.brownian_rpy(all, kT=1.2, seed=1, eta=1.0, a=0.5, r_cut=3.0, Nx=16, Ny=16, Nz=16);
+        bd.set_params(kT=1.3);
+        bd.set_params(eta=2.0, a=0.6);
+        bd.set_params(lanczos_tol=1e-3, lanczos_max_iter=20);
+        run(2);
+
+    # test that the cutoff is checked against the box
+    def test_rcut_too_large(self):
+        all = group.all();
+        md.integrate.mode_standard(dt=0.005);
+        bd = md.integrate.brownian_rpy(all, kT=1.2, seed=1, eta=1.0, a=0.5, r_cut=6.0, Nx=16, Ny=16, Nz=16);
+        self.assertRaises(RuntimeError, run, 1);
+
+    # test logging of the number of Lanczos iterations
+    def test_log(self):
+        all = group.all();
+        md.integrate.mode_standard(dt=0.005);
+        bd = md.integrate.brownian_rpy(all, kT=1.2, seed=1, eta=1.0, a=0.5, r_cut=3.0, Nx=16, Ny=16, Nz=16);
+        log = analyze.log(filename=None, quantities=['brownian_rpy_lanczos_iterations'], period=1);
+        run(2);
+        n = log.query('brownian_rpy_lanczos_iterations');
+        self.assertGreater(n, 0);
+        self.assertLessEqual(n, 100);
+
+    def tearDown(self):
+        context.initialize();
+
+# validate the mobility of a periodic array of spheres
+class integrate_brownian_rpy_mobility (unittest.TestCase):
+    def setUp(self):
+        print
+        snap = data.make_snapshot(N=1, box=data.boxdim(L=10), particle_types=['A'])
+        self.s = init.read_snapshot(snap)
+
+    def test_hasimoto(self):
+        # a single sphere of radius a in a cubic box of length L drifts with the mobility of a simple cubic array
+        # mu/mu0 = 1 - 2.837297 a/L + 4/3 pi (a/L)^3 - 27.4 (a/L)^6 (H. Hasimoto, J. Fluid Mech. 5, 317 (1959))
+        eta = 1.0;
+        a = 1.0;
+        fx = 2.0;
+        dt = 0.01;
+        nsteps = 10;
+
+        all = group.all();
+        md.integrate.mode_standard(dt=dt);
+        md.force.constant(fx=fx, fy=0.0, fz=0.0, group=all);
+        md.integrate.brownian_rpy(all, kT=0.0, seed=1, eta=eta, a=a, r_cut=5.0, Nx=32, Ny=32, Nz=32, order=6);
+        run(nsteps);
+
+        snap = self.s.take_snapshot();
+        if comm.get_rank() == 0:
+            mu0 = 1.0/(6.0*math.pi*eta*a);
+            ratio = snap.particles.position[0][0]/(mu0*fx*dt*nsteps);
+            self.assertAlmostEqual(ratio, 0.7205, places=2);
+            self.assertAlmostEqual(snap.particles.position[0][1], 0.0, places=5);
+            self.assertAlmostEqual(snap.particles.position[0][2], 0.0, places=5);
+
+    def tearDown(self):
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
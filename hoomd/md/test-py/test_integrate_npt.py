@@ -11,7 +11,7 @@ import os
 class integrate_npt_tests (unittest.TestCase):
     def setUp(self):
         print
-        init.create_lattice(unitcell=lattice.sc(a=1.0), n=13);
+        self.s = init.create_lattice(unitcell=lattice.sc(a=1.0), n=13);
         md.force.constant(fx=0.1, fy=0.1, fz=0.1)
         nl = md.nlist.cell()
         lj = md.pair.lj(r_cut=2.5, nlist = nl)
@@ -31,6 +31,23 @@ class integrate_npt_tests (unittest.TestCase):
         md.integrate.npt(all, kT=1.2, tau=0.5, P=1.0, tauP=0.5);
         run(1);
 
+    # the isotropic barostat only requests the scalar pressure
+    def test_mtk_cubic_pressure(self):
+        all = group.all();
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.npt(all, kT=1.2, tau=0.5, P=1.0, tauP=0.5);
+        log = analyze.log(filename=None, quantities=['pressure'], period=1);
+        run(10);
+        P = log.query('pressure');
+        self.assertTrue(P == P);
+
+        # the pressure tensor is still computed when it is logged
+        log_tensor = analyze.log(filename=None, quantities=['pressure_xx', 'pressure_yy', 'pressure_zz'], period=1);
+        run(1);
+        P = log.query('pressure');
+        P_trace = (log_tensor.query('pressure_xx') + log_tensor.query('pressure_yy') + log_tensor.query('pressure_zz'))/3.0;
+        self.assertAlmostEqual(P, P_trace, 4);
+
     def test_mtk_orthorhombic(self):
         all = group.all();
         md.integrate.mode_standard(dt=0.005);
@@ -61,6 +78,31 @@ class integrate_npt_tests (unittest.TestCase):
         npt.set_params(rescale_all=True)
         run(1);
 
+    # the fused thermo sums drive the barostat the same way as compute.thermo
+    def test_fuse_thermo(self):
+        volume = {}
+        for fuse_thermo in [True, False]:
+            context.initialize();
+            self.setUp();
+            md.integrate.mode_standard(dt=0.005);
+            all = group.all();
+            md.integrate.npt(all, kT=1.2, tau=0.5, P=1.0, tauP=0.5, couple="none", fuse_thermo=fuse_thermo);
+            run(20);
+            volume[fuse_thermo] = self.s.box.get_volume();
+
+        self.assertAlmostEqual(volume[True]/volume[False], 1.0, 4);
+
+    # fused sums can be switched on and off between runs
+    def test_fuse_thermo_set_params(self):
+        md.integrate.mode_standard(dt=0.005);
+        all = group.all();
+        npt = md.integrate.npt(all, kT=1.2, tau=0.5, P=1.0, tauP=0.5, fuse_thermo=True);
+        run(5);
+        npt.set_params(fuse_thermo=False);
+        run(5);
+        npt.set_params(fuse_thermo=True);
+        run(5);
+
     # test w/ empty group
     def test_empty(self):
         # currently cannot catch run-time errors in MPI simulations
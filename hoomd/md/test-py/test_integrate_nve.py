@@ -11,8 +11,8 @@ import os
 class integrate_nve_tests (unittest.TestCase):
     def setUp(self):
         print
-        init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
-        md.force.constant(fx=0.1, fy=0.1, fz=0.1)
+        self.s = init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
+        self.const = md.force.constant(fx=0.1, fy=0.1, fz=0.1)
 
         context.current.sorter.set_params(grid=8)
 
@@ -40,6 +40,117 @@ class integrate_nve_tests (unittest.TestCase):
         nve.set_params(limit=0.1);
         nve.set_params(zero_force=False);
 
+    # test multiple time stepping with a slow force
+    def test_slow_force(self):
+        all = group.all();
+        mode = md.integrate.mode_standard(dt=0.005, slow=[self.const], slow_period=4);
+        md.integrate.nve(all);
+
+        # the slow force kicks by half an outer step at both ends of the outer step
+        run(2);
+        v = self.s.particles[0].velocity
+        self.assertAlmostEqual(v[0], 2*0.005*0.1, 6)
+        run(2);
+        v = self.s.particles[0].velocity
+        self.assertAlmostEqual(v[0], 4*0.005*0.1, 6)
+
+        mode.set_params(slow=[], slow_period=1)
+        run(1);
+        v = self.s.particles[0].velocity
+        self.assertAlmostEqual(v[0], 5*0.005*0.1, 6)
+
+        with self.assertRaises(RuntimeError):
+            mode.set_params(slow_period=0)
+
+    # methods that couple the box to the pressure do not support multiple time stepping
+    def test_slow_force_npt(self):
+        mode = md.integrate.mode_standard(dt=0.005, slow=[self.const], slow_period=4);
+        md.integrate.npt(group=group.all(), kT=1.0, tau=0.5, P=1.0, tauP=0.5);
+        with self.assertRaises(RuntimeError):
+            run(1);
+
+        mode.set_params(slow_period=1)
+        run(1);
+
+    # test forces adding directly to the net force
+    def test_accumulate_net_force(self):
+        nl = md.nlist.cell()
+        lj = md.pair.lj(r_cut=2.5, nlist=nl)
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=2.0)
+        mode = md.integrate.mode_standard(dt=0.0);
+        md.integrate.nve(group.all());
+        log = analyze.log(filename=None, quantities=['potential_energy'], period=1)
+
+        run(1);
+        energy = log.query('potential_energy')
+        self.assertFalse(lj.cpp_force.accumulatesNetForce())
+
+        mode.set_params(accumulate_net_force=True)
+        run(1);
+        self.assertTrue(lj.cpp_force.accumulatesNetForce())
+        self.assertFalse(self.const.cpp_force.accumulatesNetForce())
+        self.assertAlmostEqual(log.query('potential_energy'), energy, 4)
+
+        # forces with a logged energy keep their own arrays
+        log_lj = analyze.log(filename=None, quantities=['pair_lj_energy'], period=1)
+        run(1);
+        self.assertFalse(lj.cpp_force.accumulatesNetForce())
+        self.assertAlmostEqual(log_lj.query('pair_lj_energy'), energy, 4)
+
+    # test the fused first step of several methods
+    def test_fuse_step_one(self):
+        nl = md.nlist.cell()
+        lj = md.pair.lj(r_cut=2.5, nlist=nl)
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=2.0)
+        snap = self.s.take_snapshot()
+
+        lower = group.tag_list(name="lower", tags=range(0,50))
+        upper = group.tag_list(name="upper", tags=range(50,100))
+        mode = md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(lower);
+        md.integrate.nve(upper, limit=0.001);
+        run(10);
+        pos = [p.position for p in self.s.particles]
+
+        self.s.restore_snapshot(snap)
+        mode.set_params(fuse_step_one=True)
+        run(10);
+        for p, p_ref in zip(self.s.particles, pos):
+            for i in range(3):
+                self.assertAlmostEqual(p.position[i], p_ref[i], 5)
+
+    # test the adaptive time step and scheduling in simulation time
+    def test_adaptive(self):
+        mode = md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(group.all());
+        log = analyze.log(filename=None, quantities=['dt'], period=1)
+
+        # the constant force gives every particle an acceleration of 0.1*sqrt(3)
+        mode.set_adaptive(max_velocity_change=1e-4)
+        t0 = get_time()
+        run(10);
+        dt = 1e-4 / (0.1 * 3**0.5)
+        self.assertAlmostEqual(log.query('dt') / dt, 1.0, 5)
+        self.assertAlmostEqual((get_time() - t0) / (10 * dt), 1.0, 5)
+
+        v = self.s.particles[0].velocity
+        self.assertAlmostEqual(v[0] / (0.1 * 10 * dt), 1.0, 5)
+
+        # executes on the first step, then every 5 steps of length dt
+        calls = []
+        cb = analyze.callback(callback=lambda step: calls.append(step), period=1)
+        cb.set_time_period(4.5 * dt)
+        step = get_step()
+        run(11);
+        self.assertEqual(calls, [step, step + 5, step + 10])
+
+        mode.set_adaptive(enable=False)
+        run(1);
+        self.assertAlmostEqual(log.query('dt'), 0.005, 6)
+
+        with self.assertRaises(RuntimeError):
+            mode.set_adaptive()
+
     # test w/ empty group
     def test_empty(self):
         empty = group.cuboid(name="empty", xmin=-100, xmax=-100, ymin=-100, ymax=-100, zmin=-100, zmax=-100)
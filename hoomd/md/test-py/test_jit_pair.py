@@ -0,0 +1,72 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+from hoomd import md;
+context.initialize()
+import unittest
+import os
+
+try:
+    from hoomd import jit
+    _has_jit_pair = hasattr(jit, 'pair')
+except ImportError:
+    _has_jit_pair = False
+
+_lj_V = '4*epsilon*((sigma/r)**12 - (sigma/r)**6)'
+_lj_F = '24*epsilon/r*(2*(sigma/r)**12 - (sigma/r)**6)'
+
+# jit.pair.user
+@unittest.skipIf(not _has_jit_pair or context.exec_conf.isCUDAEnabled(), "jit.pair is not available")
+class jit_pair_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        self.s = init.create_lattice(lattice.sc(a=1.2),n=[5,5,4]);
+        self.nl = md.nlist.cell()
+
+    # the compiled LJ potential matches pair.lj
+    def test_lj_compare(self):
+        lj = md.pair.lj(r_cut=2.5, nlist = self.nl);
+        lj.pair_coeff.set('A', 'A', epsilon=1.2, sigma=0.9)
+        lj.set_params(mode="shift")
+
+        user = jit.pair.user(r_cut=2.5, nlist = self.nl, V=_lj_V, F=_lj_F, params=['epsilon', 'sigma'])
+        user.pair_coeff.set('A', 'A', epsilon=1.2, sigma=0.9)
+        user.set_params(mode="shift")
+
+        # displace the particles so that the forces do not vanish
+        for p in self.s.particles:
+            x, y, z = p.position
+            p.position = (x + 0.05*((p.tag*7)%5 - 2), y + 0.04*((p.tag*3)%5 - 2), z)
+
+        md.integrate.mode_standard(dt=0.0);
+        md.integrate.nve(group.all());
+        run(1)
+
+        for i in range(len(self.s.particles)):
+            e_lj = lj.forces[i].energy
+            e_user = user.forces[i].energy
+            self.assertAlmostEqual(e_lj, e_user, 5)
+            f_lj = lj.forces[i].force
+            f_user = user.forces[i].force
+            for k in range(3):
+                self.assertAlmostEqual(f_lj[k], f_user[k], 4)
+
+    # unknown names and functions are rejected
+    def test_invalid_expression(self):
+        self.assertRaises(RuntimeError, jit.pair.user, r_cut=2.5, nlist=self.nl, V='eps*r', F='eps', params=[])
+        self.assertRaises(RuntimeError, jit.pair.user, r_cut=2.5, nlist=self.nl, V='open(r)', F='r', params=[])
+        self.assertRaises(RuntimeError, jit.pair.user, r_cut=2.5, nlist=self.nl, V='r', F='1', params=['r'])
+
+    # missing coefficients are detected
+    def test_set_missing_coeff(self):
+        user = jit.pair.user(r_cut=2.5, nlist = self.nl, V=_lj_V, F=_lj_F, params=['epsilon', 'sigma'])
+        user.pair_coeff.set('A', 'A', epsilon=1.0)
+        self.assertRaises(RuntimeError, user.update_coeffs);
+
+    def tearDown(self):
+        del self.s, self.nl
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
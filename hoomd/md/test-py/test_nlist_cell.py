@@ -46,6 +46,48 @@ class nlist_cell_tests (unittest.TestCase):
     def test_tune(self):
         self.nl.tune(warmup=100, r_min=0.1, r_max=0.25, jumps=10, steps=50)
 
+    # test online tuning
+    def test_autotune(self):
+        lj = md.pair.lj(r_cut = 2.5, nlist = self.nl)
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+        md.integrate.mode_standard(dt=0.005)
+        md.integrate.nve(group=group.all())
+
+        self.nl.set_autotune(r_buff_min=0.1, r_buff_max=0.6, period=20)
+        run(400)
+        r_buff = self.nl.cpp_nlist.getRBuff()
+        self.assertGreaterEqual(r_buff, 0.1 - 1e-6)
+        self.assertLessEqual(r_buff, 0.6 + 1e-6)
+
+        self.nl.set_autotune(enable=False)
+        run(10)
+
+        self.assertRaises(RuntimeError, self.nl.set_autotune, r_buff_min=0.5, r_buff_max=0.2)
+        self.assertRaises(RuntimeError, self.nl.set_autotune, period=0)
+
+    # test that the deferred distance check gives the same energy as the synchronous one
+    def test_deferred_check(self):
+        nl2 = md.nlist.cell()
+        nl2.set_params(deferred_check = True)
+
+        lj1 = md.pair.lj(r_cut = 2.5, nlist = self.nl)
+        lj1.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+        lj2 = md.pair.lj(r_cut = 2.5, nlist = nl2)
+        lj2.pair_coeff.set('A', 'A', epsilon=0.0, sigma=1.0)
+        md.integrate.mode_standard(dt=0.005)
+        md.integrate.nve(group=group.all())
+        run(200)
+
+        if context.exec_conf.isCUDAEnabled():
+            self.assertTrue(nl2.cpp_nlist.getDeferredCheck())
+
+        lj2.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+        run(1)
+        self.assertAlmostEqual(lj1.get_energy(group.all()), lj2.get_energy(group.all()), 5)
+
+        nl2.set_params(deferred_check = False)
+        run(10)
+
     # test multiple neighbor lists can coexist with different parameters
     def test_multi(self):
         self.nl.set_params(r_buff = 0.3)
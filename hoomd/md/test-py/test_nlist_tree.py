@@ -28,6 +28,18 @@ class nlist_tree_tests (unittest.TestCase):
             self.nl.set_params(check_period = 20);
             self.nl.set_params(d_max = 2.0, dist_check = False)
 
+    # test set_refit
+    def test_set_refit(self):
+        if self.nl is not None:
+            self.nl.set_refit(period=10);
+            self.nl.set_refit(period=5, threshold=1.2);
+            lj = md.pair.lj(r_cut = 2.5, nlist = self.nl)
+            lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+            md.integrate.mode_standard(dt=0.005)
+            md.integrate.nve(group=group.all())
+            run(100)
+            self.nl.set_refit(period=1);
+
     # test reset_exclusions
     def test_reset_exclusions_works(self):
         if self.nl is not None:
@@ -11,7 +11,7 @@ import os
 class pair_dpd_tests (unittest.TestCase):
     def setUp(self):
         print
-        init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
+        self.s = init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
         self.nl = md.nlist.cell()
         context.current.sorter.set_params(grid=8)
 
@@ -39,8 +39,25 @@ class pair_dpd_tests (unittest.TestCase):
         dpd.update_coeffs();
         dpd.set_params(kT = 2.0);
 
+    # test that the cell-pair mode reproduces the neighbor list forces, including the random forces
+    @unittest.skipIf(comm.get_num_ranks() > 1, "cell_pairs is not supported in MPI simulations")
+    def test_cell_pairs(self):
+        dpd = md.pair.dpd(r_cut=3.0, nlist = self.nl, kT=1.0, seed=10);
+        dpd.pair_coeff.set('A', 'A', A=1.0, gamma = 4.5);
+        dpd_cell = md.pair.dpd(r_cut=3.0, nlist = self.nl, kT=1.0, seed=10);
+        dpd_cell.pair_coeff.set('A', 'A', A=1.0, gamma = 4.5);
+        dpd_cell.set_params(cell_pairs=True);
+
+        md.integrate.mode_standard(dt=0.005)
+        md.integrate.nve(group=group.all())
+        run(10)
+
+        for i in range(len(self.s.particles)):
+            for k in range(3):
+                self.assertAlmostEqual(dpd.forces[i].force[k], dpd_cell.forces[i].force[k], 5)
+
     def tearDown(self):
-        del self.nl
+        del self.s, self.nl
         context.initialize();
 
 
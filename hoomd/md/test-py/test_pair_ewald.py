@@ -87,6 +87,22 @@ class test_pair_reaction_field_potential(unittest.TestCase):
         self.assertAlmostEqual(f1[1],0)
         self.assertAlmostEqual(f1[2],0)
 
+    # test the rational approximations of erfc against the same reference values
+    def test_potential_erfc_approx(self):
+        ewald = md.pair.ewald(r_cut=2.0, nlist = self.nl)
+
+        md.integrate.mode_standard(dt=0)
+        nve = md.integrate.nve(group = group.all())
+
+        for erfc_tol, places in [(1e-6, 5), (1e-4, 3)]:
+            ewald.pair_coeff.set('A','A', kappa=1.3, alpha=0.7, erfc_tol=erfc_tol)
+            run(1)
+
+            self.assertAlmostEqual(ewald.forces[0].energy,0.5*1.38135,places)
+            self.assertAlmostEqual(ewald.forces[1].energy,0.5*1.38135,places)
+            self.assertAlmostEqual(ewald.forces[0].force[0],-6.53712,places)
+            self.assertAlmostEqual(ewald.forces[1].force[0],6.53712,places)
+
     def tearDown(self):
         del self.nl
         context.initialize();
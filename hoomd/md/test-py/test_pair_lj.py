@@ -6,6 +6,7 @@ from hoomd import md;
 context.initialize()
 import unittest
 import os
+import numpy
 
 # md.pair.lj
 class pair_lj_tests (unittest.TestCase):
@@ -40,6 +41,110 @@ class pair_lj_tests (unittest.TestCase):
         lj.set_params(mode="xplor");
         self.assertRaises(RuntimeError, lj.set_params, mode="blah");
 
+    # test that the cell-pair mode reproduces the neighbor list forces
+    @unittest.skipIf(comm.get_num_ranks() > 1, "cell_pairs is not supported in MPI simulations")
+    def test_cell_pairs(self):
+        snap = self.s.take_snapshot()
+        if comm.get_rank() == 0:
+            numpy.random.seed(12)
+            snap.particles.position[:] += numpy.random.uniform(-0.3, 0.3, size=(snap.particles.N, 3))
+        self.s.restore_snapshot(snap)
+
+        lj = md.pair.lj(r_cut=2.5, nlist = self.nl);
+        lj.pair_coeff.set('A', 'A', sigma=1.0, epsilon=1.0)
+        lj_cell = md.pair.lj(r_cut=2.5, nlist = self.nl);
+        lj_cell.pair_coeff.set('A', 'A', sigma=1.0, epsilon=1.0)
+        lj_cell.set_params(cell_pairs=True)
+
+        md.integrate.mode_standard(dt=0.001)
+        md.integrate.nve(group=group.all())
+        run(1)
+
+        self.assertAlmostEqual(lj.get_energy(group.all()), lj_cell.get_energy(group.all()), 5)
+        for i in range(len(self.s.particles)):
+            for k in range(3):
+                self.assertAlmostEqual(lj.forces[i].force[k], lj_cell.forces[i].force[k], 5)
+
+        lj_cell.set_params(cell_pairs=False)
+        run(1)
+
+    # test that the cluster-pair list reproduces the neighbor list forces
+    def test_cluster_pairs(self):
+        snap = self.s.take_snapshot()
+        if comm.get_rank() == 0:
+            numpy.random.seed(13)
+            snap.particles.position[:] += numpy.random.uniform(-0.3, 0.3, size=(snap.particles.N, 3))
+        self.s.restore_snapshot(snap)
+
+        nl_cluster = md.nlist.cell()
+        nl_cluster.set_params(cluster_pairs=True)
+
+        lj = md.pair.lj(r_cut=2.5, nlist = self.nl);
+        lj.pair_coeff.set('A', 'A', sigma=1.0, epsilon=1.0)
+        lj_cluster = md.pair.lj(r_cut=2.5, nlist = nl_cluster);
+        lj_cluster.pair_coeff.set('A', 'A', sigma=1.0, epsilon=1.0)
+
+        md.integrate.mode_standard(dt=0.001)
+        md.integrate.nve(group=group.all())
+        run(1)
+
+        self.assertAlmostEqual(lj.get_energy(group.all()), lj_cluster.get_energy(group.all()), 5)
+        for i in range(len(self.s.particles)):
+            for k in range(3):
+                self.assertAlmostEqual(lj.forces[i].force[k], lj_cluster.forces[i].force[k], 5)
+
+        nl_cluster.set_params(cluster_pairs=False)
+        run(1)
+
+    # test that the energies are available when no logger requests them during the run
+    def test_energy_on_demand(self):
+        snap = self.s.take_snapshot()
+        if comm.get_rank() == 0:
+            numpy.random.seed(14)
+            snap.particles.position[:] += numpy.random.uniform(-0.3, 0.3, size=(snap.particles.N, 3))
+        self.s.restore_snapshot(snap)
+
+        lj = md.pair.lj(r_cut=2.5, nlist = self.nl);
+        lj.pair_coeff.set('A', 'A', sigma=1.0, epsilon=1.0)
+        lj.set_params(mode="shift")
+
+        md.integrate.mode_standard(dt=0.001)
+        md.integrate.nve(group=group.all())
+        run(1)
+
+        energy = lj.get_energy(group.all())
+        self.assertNotEqual(energy, 0.0)
+        if comm.get_num_ranks() == 1:
+            self.assertAlmostEqual(energy, sum(lj.forces[i].energy for i in range(len(self.s.particles))), 4)
+
+    # test that the single type kernel agrees with the generic one
+    def test_single_type(self):
+        snap = self.s.take_snapshot()
+        if comm.get_rank() == 0:
+            numpy.random.seed(15)
+            snap.particles.position[:] += numpy.random.uniform(-0.3, 0.3, size=(snap.particles.N, 3))
+        self.s.restore_snapshot(snap)
+
+        lj = md.pair.lj(r_cut=2.5, nlist = self.nl);
+        lj.pair_coeff.set('A', 'A', sigma=1.0, epsilon=1.0, r_on=2.0)
+        lj.set_params(mode="xplor")
+
+        md.integrate.mode_standard(dt=0.0)
+        md.integrate.nve(group=group.all())
+        run(1)
+        energy = lj.get_energy(group.all())
+        forces = [lj.forces[i].force for i in range(len(self.s.particles))]
+
+        # a second, unused type selects the generic kernel
+        self.s.particles.types.add('B')
+        lj.pair_coeff.set(['A', 'B'], 'B', sigma=1.0, epsilon=1.0, r_on=2.0)
+        run(1)
+
+        self.assertAlmostEqual(energy, lj.get_energy(group.all()), 5)
+        for i in range(len(self.s.particles)):
+            for k in range(3):
+                self.assertAlmostEqual(forces[i][k], lj.forces[i].force[k], 5)
+
     # test default coefficients
     def test_default_coeff(self):
         lj = md.pair.lj(r_cut=3.0, nlist = self.nl);
@@ -97,6 +202,57 @@ class pair_lj_tests (unittest.TestCase):
         del self.s, self.nl
         context.initialize();
 
+# md.pair.lj with the half-shell ghost exchange
+class pair_lj_half_shell_tests (unittest.TestCase):
+    def compute_forces(self, half_shell):
+        comm.decomposition(half_shell=half_shell)
+        s = init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]);
+        snap = s.take_snapshot()
+        if comm.get_rank() == 0:
+            numpy.random.seed(12)
+            snap.particles.position[:] += numpy.random.uniform(-0.3, 0.3, size=(snap.particles.N, 3))
+        s.restore_snapshot(snap)
+
+        lj = md.pair.lj(r_cut=2.5, nlist = md.nlist.cell());
+        lj.pair_coeff.set('A', 'A', sigma=1.0, epsilon=1.0)
+        md.integrate.mode_standard(dt=0.001)
+        md.integrate.nve(group=group.all())
+        run(1)
+
+        forces = [s.particles[i].net_force for i in range(len(s.particles))]
+        energy = lj.get_energy(group.all())
+        del s, lj
+        context.initialize()
+        return forces, energy
+
+    # test that the forces on the ghosts are sent back to their owners
+    def test_forces(self):
+        if comm.get_num_ranks() == 1 or context.exec_conf.isCUDAEnabled():
+            return
+
+        forces, energy = self.compute_forces(False)
+        forces_half, energy_half = self.compute_forces(True)
+
+        self.assertAlmostEqual(energy, energy_half, 5)
+        for i in range(len(forces)):
+            for k in range(3):
+                self.assertAlmostEqual(forces[i][k], forces_half[i][k], 5)
+
+    # potentials that do not add the forces to the ghosts are rejected
+    def test_unsupported(self):
+        if comm.get_num_ranks() == 1 or context.exec_conf.isCUDAEnabled():
+            return
+
+        comm.decomposition(half_shell=True)
+        s = init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]);
+        dpd = md.pair.dpd(r_cut=1.0, nlist = md.nlist.cell(), kT=1.0, seed=1);
+        dpd.pair_coeff.set('A', 'A', A=1.0, gamma=1.0)
+        md.integrate.mode_standard(dt=0.001)
+        md.integrate.nve(group=group.all())
+        self.assertRaises(RuntimeError, run, 1)
+        del s, dpd
+        context.initialize()
+
 
 if __name__ == '__main__':
     unittest.main(argv = ['test.py', '-v'])
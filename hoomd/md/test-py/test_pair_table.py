@@ -55,6 +55,30 @@ class pair_table_tests (unittest.TestCase):
         table.pair_coeff.set('B', 'B', rmin=0.0, rmax=1.0, func=lambda r, rmin, rmax: (r, 2*r), coeff=dict());
         table.update_coeffs();
 
+    # test the cubic interpolation against the analytic force on a coarse table
+    def test_cubic_interpolation(self):
+        table = md.pair.table(width=20, nlist = self.nl);
+        lj = lambda r, rmin, rmax: (4.0*(r**-12 - r**-6), 4.0*(12.0*r**-13 - 6.0*r**-7));
+        table.pair_coeff.set('A', 'A', rmin=0.9, rmax=2.5, func=lj, coeff=dict());
+        table.set_params(interpolation='cubic');
+        self.assertRaises(RuntimeError, table.set_params, interpolation='quintic');
+
+        # move two particles to a distance between the table points
+        r = 1.3;
+        self.s.particles[0].position = (0,0,0);
+        self.s.particles[1].position = (r,0,0);
+        for p in self.s.particles:
+            if p.tag > 1:
+                p.position = (p.position[0], p.position[1], 0.5*self.s.box.Lz - 0.1);
+
+        md.integrate.mode_standard(dt=0.0);
+        md.integrate.nve(group=group.tags(0,1));
+        run(1);
+
+        V, F = lj(r, 0.9, 2.5);
+        self.assertAlmostEqual(table.forces[1].force[0]/F, 1.0, 2);
+        self.assertAlmostEqual(2.0*table.forces[1].energy/V, 1.0, 2);
+
     def tearDown(self):
         del self.s, self.nl
         context.initialize();
@@ -6,6 +6,7 @@ from hoomd import md;
 context.initialize()
 import unittest
 import os
+import math
 
 # tests md.special_pair.lj
 class special_pair_lj_tests (unittest.TestCase):
@@ -102,6 +103,43 @@ class special_pair_lj_tests (unittest.TestCase):
         self.assertAlmostEqual(lj.forces[1].energy, -0.5*.320337-0.5*1.9756,3)
         self.assertAlmostEqual(lj.forces[2].energy, -0.5*1.9756,3)
 
+    # check that pair.lj with special_scale scales the special pairs
+    def test_pair_lj_special_scale(self):
+        self.s.particles[2].position = (-1.2,0,0)
+        nl = md.nlist.cell()
+        lj = md.pair.lj(r_cut=3.0, nlist=nl);
+        lj.pair_coeff.set('A', 'A', sigma=1.0, epsilon=1.0)
+        lj.set_params(special_scale=0.5)
+        all = group.all();
+        md.integrate.mode_standard(dt=0);
+        md.integrate.nve(all);
+        run(1)
+
+        def V(r):
+            return 4.0*(r**-12 - r**-6)
+        def F(r):
+            return 4.0*(12.0*r**-13 - 6.0*r**-7)
+
+        # 0-1 and 1-2 are special pairs, 0-2 is not
+        r01 = 1.5
+        r12 = math.sqrt(1.2**2 + 1.5**2)
+        r02 = 1.2
+        self.assertAlmostEqual(lj.forces[0].energy, 0.5*(0.5*V(r01) + V(r02)), 3)
+        self.assertAlmostEqual(lj.forces[1].energy, 0.5*(0.5*V(r01) + 0.5*V(r12)), 3)
+        self.assertAlmostEqual(lj.forces[2].energy, 0.5*(0.5*V(r12) + V(r02)), 3)
+
+        f0 = lj.forces[0].force
+        self.assertAlmostEqual(f0[0], F(r02), 3)
+        self.assertAlmostEqual(f0[2], -0.5*F(r01), 3)
+
+    # special_scale cannot be combined with the exclusion of the special pairs
+    def test_pair_lj_special_scale_excluded(self):
+        nl = md.nlist.cell()
+        nl.reset_exclusions(exclusions=['pair'])
+        lj = md.pair.lj(r_cut=3.0, nlist=nl);
+        lj.pair_coeff.set('A', 'A', sigma=1.0, epsilon=1.0)
+        self.assertRaises(RuntimeError, lj.set_params, special_scale=0.5)
+
     def tearDown(self):
         del self.s
         context.initialize();
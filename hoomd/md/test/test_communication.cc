@@ -3258,6 +3258,82 @@ void test_communicator_ghost_layer_width(communicator_creator comm_creator, std:
         }
     }
 
+//! Test the lazy migration check
+void test_communicator_migration_check(communicator_creator comm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // this test needs to be run on eight processors
+    int size;
+    MPI_Comm_size(exec_conf->getHOOMDWorldMPICommunicator(), &size);
+    UP_ASSERT_EQUAL(size,8);
+
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(8,          // number of particles
+                                                             BoxDim(2.0), // box dimensions
+                                                             1,           // number of particle types
+                                                             0,           // number of bond types
+                                                             0,           // number of angle types
+                                                             0,           // number of dihedral types
+                                                             0,           // number of dihedral types
+                                                             exec_conf));
+
+    std::shared_ptr<ParticleData> pdata(sysdef->getParticleData());
+
+    // place one particle in the middle of every box (outside the ghost layer)
+    pdata->setPosition(0, make_scalar3(-0.5,-0.5,-0.5),false);
+    pdata->setPosition(1, make_scalar3( 0.5,-0.5,-0.5),false);
+    pdata->setPosition(2, make_scalar3(-0.5, 0.5,-0.5),false);
+    pdata->setPosition(3, make_scalar3( 0.5, 0.5,-0.5),false);
+    pdata->setPosition(4, make_scalar3(-0.5,-0.5, 0.5),false);
+    pdata->setPosition(5, make_scalar3( 0.5,-0.5, 0.5),false);
+    pdata->setPosition(6, make_scalar3(-0.5, 0.5, 0.5),false);
+    pdata->setPosition(7, make_scalar3( 0.5, 0.5, 0.5),false);
+
+    // distribute particle data on processors
+    SnapshotParticleData<Scalar> snap(8);
+    pdata->takeSnapshot(snap);
+
+    std::shared_ptr<DomainDecomposition> decomposition(new DomainDecomposition(exec_conf,  pdata->getBox().getL()));
+    std::shared_ptr<Communicator> comm = comm_creator(sysdef, decomposition);
+
+    pdata->setDomainDecomposition(decomposition);
+
+    pdata->initializeFromSnapshot(snap);
+
+    CommFlags flags(0);
+    flags[comm_flag::position] = 1;
+    comm->setFlags(flags);
+
+    // without a buffer, the particles are always migrated
+    comm->getGhostLayerWidthRequestSignal().connect<&ghost_layer_width_request_3>();
+    comm->migrateParticles();
+    comm->exchangeGhosts();
+    UP_ASSERT(comm->checkMigration());
+
+    // the buffer widens the ghost layer, and the ghost lists are valid until the first exchange
+    comm->setMigrationBuffer(Scalar(0.05));
+    UP_ASSERT(comm->checkMigration());
+    comm->migrateParticles();
+    comm->exchangeGhosts();
+    CHECK_CLOSE(comm->getGhostLayerMaxWidth(), 0.15, tol);
+    UP_ASSERT(!comm->checkMigration());
+
+    // small displacements do not require a migration
+    pdata->setPosition(3, make_scalar3( 0.52, 0.5,-0.5),false);
+    UP_ASSERT(!comm->checkMigration());
+
+    // a displacement larger than the buffer on any rank requires a migration on all ranks
+    pdata->setPosition(3, make_scalar3( 0.56, 0.5,-0.5),false);
+    UP_ASSERT(comm->checkMigration());
+
+    // the reference is reset by the ghost exchange
+    comm->migrateParticles();
+    comm->exchangeGhosts();
+    UP_ASSERT(!comm->checkMigration());
+
+    // changing the buffer requires a new exchange
+    comm->setMigrationBuffer(Scalar(0.1));
+    UP_ASSERT(comm->checkMigration());
+    }
+
 //! Test per-type ghost layer
 void test_communicator_ghosts_per_type(communicator_creator comm_creator, std::shared_ptr<ExecutionConfiguration> exec_conf, const BoxDim& dest_box)
     {
@@ -3648,6 +3724,14 @@ UP_TEST( communicator_ghost_layer_width_test)
     test_communicator_ghost_layer_width(communicator_creator_base, exec_conf);
     }
 
+UP_TEST( communicator_migration_check_test)
+    {
+    auto exec_conf = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));;
+
+    communicator_creator communicator_creator_base = bind(base_class_communicator_creator, _1, _2);
+    test_communicator_migration_check(communicator_creator_base, exec_conf);
+    }
+
 UP_TEST( communicator_ghost_layer_per_type_test)
     {
     auto exec_conf = std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU));;
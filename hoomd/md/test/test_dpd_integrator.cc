@@ -180,3 +180,67 @@ UP_TEST( DPD_GPU_Temp_Test )
     dpd_temperature_test< PotentialPairDPDThermoGPU<EvaluatorPairDPDThermo, gpu_compute_dpdthermodpd_forces > >(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 #endif
+
+//! Compares the DPD forces computed with a half neighbor list to the forces with a full neighbor list
+template <class PP_DPD>
+void dpd_half_nlist_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(1000, BoxDim(5.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    for (int j = 0; j < 1000; j++)
+        {
+        pdata->setPosition(j,make_scalar3(-2.0 + 0.3*(j %10) + 0.01*(j%7),
+                                         -2.0 + 0.3*(j/10 %10) - 0.01*(j%3),
+                                          -2.0 + 0.3*(j/100) + 0.01*(j%5)));
+        pdata->setVelocity(j,make_scalar3(0.1*(j%3) - 0.1, 0.05*(j%5) - 0.1, 0.02*(j%11) - 0.1));
+        }
+
+    std::shared_ptr<VariantConst> T_variant(new VariantConst(2.0));
+
+    std::shared_ptr<NeighborListTree> nlist_full(new NeighborListTree(sysdef, Scalar(1.0), Scalar(0.4)));
+    nlist_full->setStorageMode(NeighborList::full);
+    std::shared_ptr<PotentialPairDPDThermoDPD> dpd_full(new PP_DPD(sysdef,nlist_full));
+
+    std::shared_ptr<NeighborListTree> nlist_half(new NeighborListTree(sysdef, Scalar(1.0), Scalar(0.4)));
+    nlist_half->setStorageMode(NeighborList::half);
+    std::shared_ptr<PotentialPairDPDThermoDPD> dpd_half(new PP_DPD(sysdef,nlist_half));
+
+    std::shared_ptr<PotentialPairDPDThermoDPD> dpds[] = {dpd_full, dpd_half};
+    for (unsigned int k = 0; k < 2; ++k)
+        {
+        dpds[k]->setSeed(12345);
+        dpds[k]->setT(T_variant);
+        dpds[k]->setParams(0,0,make_scalar2(30,4.5));
+        dpds[k]->setRcut(0, 0, Scalar(1.0));
+        dpds[k]->setDeltaT(Scalar(0.02));
+        dpds[k]->compute(10);
+        }
+
+    ArrayHandle<Scalar4> h_force_full(dpd_full->getForceArray(),access_location::host,access_mode::read);
+    ArrayHandle<Scalar> h_virial_full(dpd_full->getVirialArray(),access_location::host,access_mode::read);
+    ArrayHandle<Scalar4> h_force_half(dpd_half->getForceArray(),access_location::host,access_mode::read);
+    ArrayHandle<Scalar> h_virial_half(dpd_half->getVirialArray(),access_location::host,access_mode::read);
+    unsigned int pitch = dpd_full->getVirialArray().getPitch();
+    for (unsigned int i = 0; i < pdata->getN(); ++i)
+        {
+        MY_CHECK_SMALL(h_force_half.data[i].x - h_force_full.data[i].x, tol_small);
+        MY_CHECK_SMALL(h_force_half.data[i].y - h_force_full.data[i].y, tol_small);
+        MY_CHECK_SMALL(h_force_half.data[i].z - h_force_full.data[i].z, tol_small);
+        MY_CHECK_SMALL(h_force_half.data[i].w - h_force_full.data[i].w, tol_small);
+        for (unsigned int l = 0; l < 6; ++l)
+            MY_CHECK_SMALL(h_virial_half.data[l*pitch+i] - h_virial_full.data[l*pitch+i], tol_small);
+        }
+    }
+
+UP_TEST( DPD_HalfNList_Test )
+    {
+    dpd_half_nlist_test< PotentialPairDPDThermo<EvaluatorPairDPDThermo> >(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+#ifdef ENABLE_CUDA
+UP_TEST( DPD_GPU_HalfNList_Test )
+    {
+    dpd_half_nlist_test< PotentialPairDPDThermoGPU<EvaluatorPairDPDThermo, gpu_compute_dpdthermodpd_forces > >(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+#endif
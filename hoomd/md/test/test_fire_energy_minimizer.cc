@@ -527,6 +527,83 @@ void fire_twoparticle_test(fire_creator fire_creator1, nve_creator nve_creator1,
 
     }
 
+//! Run a number of FIRE steps on the binary LJ system and return the final positions
+/*! \param n_groups Number of integration methods the particles are split among
+    \param n_steps Number of FIRE steps to take
+
+    The sums of FIRE run over all groups together, so the trajectory must not depend on the way the particles are
+    divided into groups.
+*/
+std::vector<Scalar3> fire_groups_run(fire_creator fire_creator1, nve_creator nve_creator1, std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                     unsigned int n_groups, unsigned int n_steps)
+    {
+    const unsigned int N = 260;
+    Scalar rho(Scalar(1.2));
+    Scalar L = Scalar(pow((double)(N/rho), 1.0/3.0));
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(N, BoxDim(L, L, L), 2, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    PDataFlags flags;
+    flags[pdata_flag::potential_energy] = 1;
+    pdata->setFlags(flags);
+
+    for (unsigned int i=0; i<N; i++)
+        {
+        Scalar3 pos = make_scalar3(x_blj[i*3 + 0],x_blj[i*3 + 1],x_blj[i*3 + 2]);
+        pdata->setPosition(i,pos);
+        if (i<(unsigned int)N*0.8)
+            pdata->setType(i,0);
+        else
+            pdata->setType(i,1);
+        }
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(2.5), Scalar(0.3)));
+    std::shared_ptr<PotentialPairLJ> fc(new PotentialPairLJ(sysdef, nlist));
+    fc->setParams(0,0,make_scalar2(Scalar(4.0), Scalar(4.0)));
+    fc->setRcut(0,0,2.5);
+    fc->setParams(0,1,make_scalar2(Scalar(4.0)*Scalar(1.5)*pow(Scalar(0.8),Scalar(12.0)),
+                                   Scalar(4.0)*Scalar(1.5)*pow(Scalar(0.8),Scalar(6.0))));
+    fc->setRcut(0,1,2.5);
+    fc->setParams(1,1,make_scalar2(Scalar(4.0)*Scalar(0.5)*pow(Scalar(0.88),Scalar(12.0)),
+                                   Scalar(4.0)*Scalar(0.5)*pow(Scalar(0.88),Scalar(6.0))));
+    fc->setRcut(1,1,2.5);
+    fc->setShiftMode(PotentialPairLJ::shift);
+
+    std::shared_ptr<FIREEnergyMinimizer> fire = fire_creator1(sysdef, Scalar(0.05));
+    for (unsigned int g = 0; g < n_groups; g++)
+        {
+        std::shared_ptr<ParticleSelector> selector(new ParticleSelectorTag(sysdef, g*N/n_groups, (g+1)*N/n_groups-1));
+        std::shared_ptr<ParticleGroup> group(new ParticleGroup(sysdef, selector));
+        fire->addIntegrationMethod(nve_creator1(sysdef, group));
+        }
+    fire->addForceCompute(fc);
+    fire->setFtol(5.0);
+    fire->setMinSteps(10);
+    fire->prepRun(0);
+
+    for (unsigned int i = 1; i <= n_steps; i++)
+        fire->update(i);
+
+    std::vector<Scalar3> pos(N);
+    for (unsigned int i = 0; i < N; i++)
+        pos[i] = pdata->getPosition(i);
+    return pos;
+    }
+
+//! Compares the trajectory of FIRE with the particles split among several integration methods to a single one
+void fire_groups_test(fire_creator fire_creator1, nve_creator nve_creator1, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::vector<Scalar3> pos_one = fire_groups_run(fire_creator1, nve_creator1, exec_conf, 1, 50);
+    std::vector<Scalar3> pos_three = fire_groups_run(fire_creator1, nve_creator1, exec_conf, 3, 50);
+
+    for (unsigned int i = 0; i < pos_one.size(); i++)
+        {
+        MY_CHECK_SMALL(pos_three[i].x - pos_one[i].x, tol_small);
+        MY_CHECK_SMALL(pos_three[i].y - pos_one[i].y, tol_small);
+        MY_CHECK_SMALL(pos_three[i].z - pos_one[i].z, tol_small);
+        }
+    }
+
 //! Sees if a single particle's trajectory is being calculated correctly
 UP_TEST( FIREEnergyMinimizer_twoparticle_test )
     {
@@ -539,6 +616,12 @@ UP_TEST( FIREEnergyMinimizer_smallsystem_test )
     fire_smallsystem_test(base_class_fire_creator, base_class_nve_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! Checks that the trajectory does not depend on the division of the particles into groups
+UP_TEST( FIREEnergyMinimizer_groups_test )
+    {
+    fire_groups_test(base_class_fire_creator, base_class_nve_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 #ifdef ENABLE_CUDA
 //! Sees if a single particle's trajectory is being calculated correctly
 UP_TEST( FIREEnergyMinimizerGPU_twoparticle_test )
@@ -551,4 +634,26 @@ UP_TEST( FIREEnergyMinimizerGPU_smallsystem_test )
     {
     fire_smallsystem_test(gpu_fire_creator, gpu_nve_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
+
+//! Checks that the trajectory of FIREEnergyMinimizerGPU does not depend on the division of the particles into groups
+UP_TEST( FIREEnergyMinimizerGPU_groups_test )
+    {
+    fire_groups_test(gpu_fire_creator, gpu_nve_creator, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
+//! Compares the trajectory of FIREEnergyMinimizerGPU to FIREEnergyMinimizer
+UP_TEST( FIREEnergyMinimizerGPU_compare_test )
+    {
+    std::vector<Scalar3> pos_cpu = fire_groups_run(base_class_fire_creator, base_class_nve_creator,
+        std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), 2, 50);
+    std::vector<Scalar3> pos_gpu = fire_groups_run(gpu_fire_creator, gpu_nve_creator,
+        std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)), 2, 50);
+
+    for (unsigned int i = 0; i < pos_cpu.size(); i++)
+        {
+        MY_CHECK_SMALL(pos_gpu[i].x - pos_cpu[i].x, tol_small);
+        MY_CHECK_SMALL(pos_gpu[i].y - pos_cpu[i].y, tol_small);
+        MY_CHECK_SMALL(pos_gpu[i].z - pos_cpu[i].z, tol_small);
+        }
+    }
 #endif
@@ -12,6 +12,7 @@
 #include "hoomd/md/AllBondPotentials.h"
 #include "hoomd/ConstForceCompute.h"
 #include "hoomd/SnapshotSystemData.h"
+#include "hoomd/SFCPackUpdater.h"
 
 #include "hoomd/Initializers.h"
 
@@ -443,6 +444,80 @@ void const_force_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
     }
     }
 
+//! Copy the lookup table of the bonds by particle index, in tag order
+std::vector<unsigned int> copy_bond_table(std::shared_ptr<SystemDefinition> sysdef)
+    {
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    std::shared_ptr<BondData> bdata = sysdef->getBondData();
+
+    const GlobalVector<BondData::members_t>& gpu_table = bdata->getGPUTable();
+    const GlobalVector<unsigned int>& gpu_pos_table = bdata->getGPUPosTable();
+    const Index2D& table_indexer = bdata->getGPUTableIndexer();
+
+    ArrayHandle<BondData::members_t> h_gpu_table(gpu_table, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_gpu_pos_table(gpu_pos_table, access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_groups(bdata->getNGroupsArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+
+    // store the tag of the bond partner, the bond type and the position in the bond of every entry
+    std::vector<unsigned int> table;
+    for (unsigned int tag = 0; tag < pdata->getNGlobal(); ++tag)
+        {
+        unsigned int idx = h_rtag.data[tag];
+        table.push_back(h_n_groups.data[idx]);
+        for (unsigned int k = 0; k < h_n_groups.data[idx]; ++k)
+            {
+            BondData::members_t b = h_gpu_table.data[table_indexer(idx, k)];
+            table.push_back(h_tag.data[b.idx[0]]);
+            table.push_back(b.idx[1]);
+            table.push_back(h_gpu_pos_table.data[table_indexer(idx, k)]);
+            }
+        }
+    return table;
+    }
+
+//! Checks that the incremental update of the bond table after a particle sort matches a rebuild
+void bond_table_sort_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 1000;
+
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = rand_init.getSnapshot();
+    snap->bond_data.type_mapping.push_back("A");
+    snap->bond_data.type_mapping.push_back("B");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<BondData> bdata = sysdef->getBondData();
+
+    // a chain, and a second bond type between distant particles
+    for (unsigned int i = 0; i < N-1; i++)
+        bdata->addBondedGroup(Bond(0, i, i+1));
+    for (unsigned int i = 0; i < N/2; i += 3)
+        bdata->addBondedGroup(Bond(1, i, N-1-i));
+
+    std::vector<unsigned int> table_before = copy_bond_table(sysdef);
+
+    // reorder the particles
+    SFCPackUpdater sorter(sysdef);
+    sorter.update(0);
+
+        {
+        ArrayHandle<unsigned int> h_tag(sysdef->getParticleData()->getTags(), access_location::host, access_mode::read);
+        bool reordered = false;
+        for (unsigned int i = 0; i < N; ++i)
+            reordered |= (h_tag.data[i] != i);
+        UP_ASSERT(reordered);
+        }
+
+    // the remapped table is the same as before the sort and after a rebuild
+    std::vector<unsigned int> table_remapped = copy_bond_table(sysdef);
+    bdata->setDirty();
+    std::vector<unsigned int> table_rebuilt = copy_bond_table(sysdef);
+
+    UP_ASSERT(table_remapped == table_before);
+    UP_ASSERT(table_remapped == table_rebuilt);
+    }
+
 //! PotentialBondHarmonic creator for bond_force_basic_tests()
 std::shared_ptr<PotentialBondHarmonic> base_class_bf_creator(std::shared_ptr<SystemDefinition> sysdef)
     {
@@ -482,6 +557,20 @@ UP_TEST( PotentialBondHarmonicGPU_compare )
 
 #endif
 
+//! test case for the bond table after a particle sort on the CPU
+UP_TEST( BondData_table_sort )
+    {
+    bond_table_sort_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+#ifdef ENABLE_CUDA
+//! test case for the bond table after a particle sort on the GPU
+UP_TEST( BondData_table_sort_GPU )
+    {
+    bond_table_sort_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+#endif
+
 //! test case for constant forces
 UP_TEST( ConstForceCompute_basic )
     {
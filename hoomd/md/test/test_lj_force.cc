@@ -286,6 +286,56 @@ void lj_force_periodic_test(ljforce_creator lj_creator, std::shared_ptr<Executio
     }
     }
 
+//! Test the forces of a pair that crosses the boundary far from the origin
+/*! The force only depends on the displacement wrapped into the box, so the particles far from the origin are subject
+    to the same force as an identical pair at the origin, also when the force is evaluated in mixed precision.
+*/
+void lj_force_far_test(ljforce_creator lj_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr<SystemDefinition> sysdef_2(new SystemDefinition(2, BoxDim(2000.0), 1, 0, 0, 0, 0, exec_conf));
+    std::shared_ptr<ParticleData> pdata_2 = sysdef_2->getParticleData();
+    pdata_2->setFlags(~PDataFlags(0));
+
+    pdata_2->setPosition(0, make_scalar3(999.6, 999.7, 0.0));
+    pdata_2->setPosition(1, make_scalar3(-999.5, -999.6, 0.2));
+
+    std::shared_ptr<NeighborListTree> nlist_2(new NeighborListTree(sysdef_2, Scalar(1.5), Scalar(0.5)));
+    std::shared_ptr<PotentialPairLJ> fc_2 = lj_creator(sysdef_2, nlist_2);
+    fc_2->setRcut(0, 0, Scalar(1.5));
+
+    Scalar epsilon = Scalar(1.0);
+    Scalar sigma = Scalar(1.0);
+    Scalar lj1 = Scalar(4.0) * epsilon * pow(sigma,Scalar(12.0));
+    Scalar lj2 = Scalar(4.0) * epsilon * pow(sigma,Scalar(6.0));
+    fc_2->setParams(0,0,make_scalar2(lj1,lj2));
+
+    fc_2->compute(0);
+
+    // reference from the wrapped displacement dx = r_0 - r_1
+    Scalar3 dx = make_scalar3(-0.9, -0.7, -0.2);
+    Scalar rsq = dot(dx, dx);
+    Scalar r6inv = Scalar(1.0)/(rsq*rsq*rsq);
+    Scalar force_divr = r6inv/rsq * (Scalar(12.0)*lj1*r6inv - Scalar(6.0)*lj2);
+    Scalar pair_eng = r6inv * (lj1*r6inv - lj2);
+
+    {
+    ArrayHandle<Scalar4> h_force(fc_2->getForceArray(),access_location::host,access_mode::read);
+    ArrayHandle<Scalar> h_virial(fc_2->getVirialArray(),access_location::host,access_mode::read);
+    unsigned int pitch = fc_2->getVirialArray().getPitch();
+
+    MY_CHECK_CLOSE(h_force.data[0].x, dx.x*force_divr, tol);
+    MY_CHECK_CLOSE(h_force.data[0].y, dx.y*force_divr, tol);
+    MY_CHECK_CLOSE(h_force.data[0].z, dx.z*force_divr, tol);
+    MY_CHECK_CLOSE(h_force.data[0].w, Scalar(0.5)*pair_eng, tol);
+    MY_CHECK_CLOSE(h_force.data[1].x, -dx.x*force_divr, tol);
+    MY_CHECK_CLOSE(h_force.data[1].y, -dx.y*force_divr, tol);
+    MY_CHECK_CLOSE(h_force.data[1].z, -dx.z*force_divr, tol);
+    MY_CHECK_CLOSE(h_virial.data[0*pitch+0], Scalar(0.5)*dx.x*dx.x*force_divr, tol);
+    MY_CHECK_CLOSE(h_virial.data[1*pitch+1], Scalar(0.5)*dx.x*dx.y*force_divr, tol);
+    MY_CHECK_CLOSE(h_virial.data[5*pitch+1], Scalar(0.5)*dx.z*dx.z*force_divr, tol);
+    }
+    }
+
 //! Unit test a comparison between 2 LJForceComputes on a "real" system
 void lj_force_comparison_test(ljforce_creator lj_creator1, ljforce_creator lj_creator2, std::shared_ptr<ExecutionConfiguration> exec_conf)
     {
@@ -365,6 +415,89 @@ void lj_force_comparison_test(ljforce_creator lj_creator1, ljforce_creator lj_cr
     }
     }
 
+#ifdef ENABLE_TBB
+//! Unit test that the forces do not depend on the number of TBB threads
+/*! With a half neighbor list, the reaction forces are summed over per-chunk arrays, with a full neighbor list every
+    thread only writes its own particles. Both must reproduce the serial result, and repeat it exactly.
+*/
+void lj_force_threads_test(NeighborList::storageMode mode, std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    const unsigned int N = 5000;
+
+    // create a random particle system to sum forces on
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = rand_init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+    pdata->setFlags(~PDataFlags(0));
+
+    std::shared_ptr<NeighborListTree> nlist(new NeighborListTree(sysdef, Scalar(3.0), Scalar(0.8)));
+    nlist->setStorageMode(mode);
+
+    std::shared_ptr<PotentialPairLJ> fc(new PotentialPairLJ(sysdef, nlist));
+    fc->setRcut(0, 0, Scalar(3.0));
+    Scalar lj1 = Scalar(4.0) * pow(Scalar(1.2),Scalar(12.0));
+    Scalar lj2 = Scalar(0.45) * Scalar(4.0) * pow(Scalar(1.2),Scalar(6.0));
+    fc->setParams(0,0,make_scalar2(lj1,lj2));
+
+    // compute the reference forces on a single thread
+    exec_conf->setNumThreads(1);
+    fc->compute(0);
+    std::vector<Scalar4> force_ref(N);
+    std::vector<Scalar> virial_ref(6*N);
+        {
+        ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+        unsigned int pitch = fc->getVirialArray().getPitch();
+        for (unsigned int i = 0; i < N; i++)
+            {
+            force_ref[i] = h_force.data[i];
+            for (unsigned int j = 0; j < 6; j++)
+                virial_ref[j*N+i] = h_virial.data[j*pitch+i];
+            }
+        }
+
+    // recompute on several threads
+    exec_conf->setNumThreads(4);
+    fc->compute(1);
+        {
+        ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+        unsigned int pitch = fc->getVirialArray().getPitch();
+        for (unsigned int i = 0; i < N; i++)
+            {
+            MY_CHECK_SMALL(h_force.data[i].x - force_ref[i].x, tol_small);
+            MY_CHECK_SMALL(h_force.data[i].y - force_ref[i].y, tol_small);
+            MY_CHECK_SMALL(h_force.data[i].z - force_ref[i].z, tol_small);
+            MY_CHECK_SMALL(h_force.data[i].w - force_ref[i].w, tol_small);
+            for (unsigned int j = 0; j < 6; j++)
+                MY_CHECK_SMALL(h_virial.data[j*pitch+i] - virial_ref[j*N+i], tol_small);
+
+            force_ref[i] = h_force.data[i];
+            for (unsigned int j = 0; j < 6; j++)
+                virial_ref[j*N+i] = h_virial.data[j*pitch+i];
+            }
+        }
+
+    // the threaded sums are reproducible bit for bit, and the buffers kept between calls start from zero again
+    fc->compute(2);
+        {
+        ArrayHandle<Scalar4> h_force(fc->getForceArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar> h_virial(fc->getVirialArray(), access_location::host, access_mode::read);
+        unsigned int pitch = fc->getVirialArray().getPitch();
+        for (unsigned int i = 0; i < N; i++)
+            {
+            UP_ASSERT(h_force.data[i].x == force_ref[i].x);
+            UP_ASSERT(h_force.data[i].y == force_ref[i].y);
+            UP_ASSERT(h_force.data[i].z == force_ref[i].z);
+            UP_ASSERT(h_force.data[i].w == force_ref[i].w);
+            for (unsigned int j = 0; j < 6; j++)
+                UP_ASSERT(h_virial.data[j*pitch+i] == virial_ref[j*N+i]);
+            }
+        }
+    }
+#endif
+
 //! Test the ability of the lj force compute to compute forces with different shift modes
 void lj_force_shift_test(ljforce_creator lj_creator, std::shared_ptr<ExecutionConfiguration> exec_conf)
     {
@@ -570,6 +703,29 @@ UP_TEST( PotentialPairLJ_shift )
     lj_force_shift_test(lj_creator_base, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+#ifndef SINGLE_PRECISION
+//! test case for a pair far from the origin on CPU
+UP_TEST( PotentialPairLJ_far )
+    {
+    ljforce_creator lj_creator_base = bind(base_class_lj_creator, _1, _2);
+    lj_force_far_test(lj_creator_base, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+#endif
+
+#ifdef ENABLE_TBB
+//! test case for comparing the threaded CPU forces with a half neighbor list to the serial ones
+UP_TEST( PotentialPairLJ_threads_half )
+    {
+    lj_force_threads_test(NeighborList::half, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! test case for comparing the threaded CPU forces with a full neighbor list to the serial ones
+UP_TEST( PotentialPairLJ_threads_full )
+    {
+    lj_force_threads_test(NeighborList::full, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+#endif
+
 # ifdef ENABLE_CUDA
 //! test case for particle test on GPU
 UP_TEST( LJForceGPU_particle )
@@ -592,6 +748,15 @@ UP_TEST( LJForceGPU_shift )
     lj_force_shift_test(lj_creator_gpu, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 
+#ifndef SINGLE_PRECISION
+//! test case for a pair far from the origin on the GPU
+UP_TEST( LJForceGPU_far )
+    {
+    ljforce_creator lj_creator_gpu = bind(gpu_lj_creator, _1, _2);
+    lj_force_far_test(lj_creator_gpu, std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+#endif
+
 //! test case for comparing GPU output to base class output
 /*UP_TEST( LJForceGPU_compare )
     {
@@ -15,6 +15,8 @@
 #include "hoomd/md/NeighborListStencil.h"
 #include "hoomd/md/NeighborListTree.h"
 #include "hoomd/Initializers.h"
+#include "hoomd/SnapshotSystemData.h"
+#include "hoomd/SFCPackUpdater.h"
 
 #ifdef ENABLE_CUDA
 #include "hoomd/md/NeighborListGPU.h"
@@ -935,6 +937,329 @@ void neighborlist_comparison_test(std::shared_ptr<ExecutionConfiguration> exec_c
         }
     }
 
+//! Check that two neighbor lists of the same particles contain the same neighbors and exclusions
+void check_same_neighbors(std::shared_ptr<ParticleData> pdata, std::shared_ptr<NeighborList> nlist1,
+    std::shared_ptr<NeighborList> nlist2)
+    {
+    ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist1(nlist1->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list1(nlist1->getHeadList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist2(nlist2->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list2(nlist2->getHeadList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_ex1(nlist1->getNExArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_ex2(nlist2->getNExArray(), access_location::host, access_mode::read);
+
+    std::vector<unsigned int> tmp_list1;
+    std::vector<unsigned int> tmp_list2;
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        UP_ASSERT_EQUAL(h_n_neigh1.data[i], h_n_neigh2.data[i]);
+        UP_ASSERT_EQUAL(h_n_ex1.data[i], h_n_ex2.data[i]);
+
+        tmp_list1.resize(h_n_neigh1.data[i]);
+        tmp_list2.resize(h_n_neigh1.data[i]);
+        for (unsigned int j = 0; j < h_n_neigh1.data[i]; j++)
+            {
+            tmp_list1[j] = h_nlist1.data[h_head_list1.data[i] + j];
+            tmp_list2[j] = h_nlist2.data[h_head_list2.data[i] + j];
+            }
+
+        sort(tmp_list1.begin(), tmp_list1.end());
+        sort(tmp_list2.begin(), tmp_list2.end());
+
+        UP_ASSERT_EQUAL(tmp_list1,tmp_list2);
+        }
+    }
+
+//! Compare the build that checks the exclusion masks with the filtered build of the base class
+/*! The exclusions are within the tag window of the masks, up to its edge, then a particle sort reorders the
+    particles, and finally an exclusion outside of the window switches the build back to the filter.
+*/
+template <class NL>
+void neighborlist_exclusion_mask_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // a large cutoff, so that many of the excluded pairs are within range
+    const Scalar r_cut = Scalar(8.0);
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborList> nlist_mask(new NL(sysdef, r_cut, Scalar(0.4)));
+    nlist_mask->setRCutPair(0,0,r_cut);
+    nlist_mask->setStorageMode(NeighborList::full);
+
+    std::shared_ptr<NeighborList> nlist_filter(new NeighborList(sysdef, r_cut, Scalar(0.4)));
+    nlist_filter->setRCutPair(0,0,r_cut);
+    nlist_filter->setStorageMode(NeighborList::full);
+
+    std::shared_ptr<NeighborList> nlist_all(new NeighborList(sysdef, r_cut, Scalar(0.4)));
+    nlist_all->setRCutPair(0,0,r_cut);
+    nlist_all->setStorageMode(NeighborList::full);
+
+    unsigned int N = pdata->getNGlobal();
+    for (unsigned int i = 0; i < N; i++)
+        {
+        unsigned int dtags[] = {1, 2, 3, NLIST_EXCLUSION_WINDOW};
+        for (unsigned int k = 0; k < 4; k++)
+            {
+            if (i + dtags[k] < N)
+                {
+                nlist_mask->addExclusion(i, i+dtags[k]);
+                nlist_filter->addExclusion(i, i+dtags[k]);
+                }
+            }
+        }
+
+    nlist_mask->compute(0);
+    nlist_filter->compute(0);
+    nlist_all->compute(0);
+    UP_ASSERT(nlist_mask->useExclusionMask());
+    UP_ASSERT(!nlist_filter->useExclusionMask());
+    check_same_neighbors(pdata, nlist_mask, nlist_filter);
+
+    // the exclusions remove neighbors
+        {
+        ArrayHandle<unsigned int> h_n_neigh_mask(nlist_mask->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh_all(nlist_all->getNNeighArray(), access_location::host, access_mode::read);
+        unsigned int n_mask = 0, n_all = 0;
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            n_mask += h_n_neigh_mask.data[i];
+            n_all += h_n_neigh_all.data[i];
+            }
+        UP_ASSERT(n_mask < n_all);
+        }
+
+    // the masks follow the particles when they are reordered
+    SFCPackUpdater sorter(sysdef);
+    sorter.update(1);
+        {
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        bool reordered = false;
+        for (unsigned int i = 0; i < pdata->getN(); ++i)
+            reordered |= (h_tag.data[i] != i);
+        UP_ASSERT(reordered);
+        }
+
+    nlist_mask->compute(1);
+    nlist_filter->compute(1);
+    UP_ASSERT(nlist_mask->useExclusionMask());
+    check_same_neighbors(pdata, nlist_mask, nlist_filter);
+
+    // an exclusion outside of the window falls back to the filter
+    nlist_mask->addExclusion(0, N/2);
+    nlist_filter->addExclusion(0, N/2);
+    nlist_mask->compute(2);
+    nlist_filter->compute(2);
+    UP_ASSERT(!nlist_mask->useExclusionMask());
+    check_same_neighbors(pdata, nlist_mask, nlist_filter);
+    }
+
+//! Compare two neighbor lists in a size-asymmetric mixture whose cutoffs fall into several cutoff classes
+template <class NLA, class NLB>
+void neighborlist_multi_level_comparison_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // construct the particle system, every tenth particle is a large A particle
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    snap->particle_data.type_mapping.push_back("B");
+    for (unsigned int i=0; i < snap->particle_data.size; i++)
+        snap->particle_data.type[i] = (i % 10 == 0) ? 0 : 1;
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborList> nlist1(new NLA(sysdef, Scalar(4.0), Scalar(0.4)));
+    nlist1->setRCutPair(0,0,4.0);
+    nlist1->setRCutPair(0,1,1.5);
+    nlist1->setRCutPair(1,1,1.0);
+    nlist1->setStorageMode(NeighborList::full);
+
+    std::shared_ptr<NeighborList> nlist2(new NLB(sysdef, Scalar(4.0), Scalar(0.4)));
+    nlist2->setRCutPair(0,0,4.0);
+    nlist2->setRCutPair(0,1,1.5);
+    nlist2->setRCutPair(1,1,1.0);
+    nlist2->setStorageMode(NeighborList::full);
+
+    // compute each of the lists
+    nlist1->compute(0);
+    nlist2->compute(0);
+
+    ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist1(nlist1->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list1(nlist1->getHeadList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist2(nlist2->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list2(nlist2->getHeadList(), access_location::host, access_mode::read);
+
+    // the neighbors of each particle are found in a different order, so the lists are sorted for comparison
+    std::vector<unsigned int> tmp_list1;
+    std::vector<unsigned int> tmp_list2;
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        UP_ASSERT_EQUAL(h_n_neigh1.data[i], h_n_neigh2.data[i]);
+
+        tmp_list1.resize(h_n_neigh1.data[i]);
+        tmp_list2.resize(h_n_neigh1.data[i]);
+        for (unsigned int j = 0; j < h_n_neigh1.data[i]; j++)
+            {
+            tmp_list1[j] = h_nlist1.data[h_head_list1.data[i] + j];
+            tmp_list2[j] = h_nlist2.data[h_head_list2.data[i] + j];
+            }
+
+        sort(tmp_list1.begin(), tmp_list1.end());
+        sort(tmp_list2.begin(), tmp_list2.end());
+
+        UP_ASSERT_EQUAL(tmp_list1,tmp_list2);
+        }
+    }
+
+//! Compare two neighbor lists in a triclinic box with several cutoffs, in full and half storage mode
+/*! Particles near the faces of the tilted box are neighbors through periodic images in all three directions. In
+    half mode, each pair must be stored once on its lower index by both lists.
+*/
+template <class NLA, class NLB>
+void neighborlist_triclinic_comparison_test(std::shared_ptr<ExecutionConfiguration> exec_conf,
+                                            NeighborList::storageMode mode)
+    {
+    // construct the particle system in a tilted box, every fifth particle is a large A particle
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    snap->global_box = BoxDim(snap->global_box.getL().x, Scalar(0.5), Scalar(-0.3), Scalar(0.2));
+    snap->particle_data.type_mapping.push_back("B");
+    for (unsigned int i=0; i < snap->particle_data.size; i++)
+        {
+        int3 img = make_int3(0,0,0);
+        snap->global_box.wrap(snap->particle_data.pos[i], img);
+        snap->particle_data.type[i] = (i % 5 == 0) ? 0 : 1;
+        }
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborList> nlist1(new NLA(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist1->setRCutPair(0,0,3.0);
+    nlist1->setRCutPair(0,1,2.0);
+    nlist1->setRCutPair(1,1,1.5);
+    nlist1->setStorageMode(mode);
+
+    std::shared_ptr<NeighborList> nlist2(new NLB(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist2->setRCutPair(0,0,3.0);
+    nlist2->setRCutPair(0,1,2.0);
+    nlist2->setRCutPair(1,1,1.5);
+    nlist2->setStorageMode(mode);
+
+    for (unsigned int i=0; i < pdata->getN()-1; i++)
+        {
+        nlist1->addExclusion(i,i+1);
+        nlist2->addExclusion(i,i+1);
+        }
+
+    nlist1->compute(0);
+    nlist2->compute(0);
+
+    ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist1(nlist1->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list1(nlist1->getHeadList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_nlist2(nlist2->getNListArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_head_list2(nlist2->getHeadList(), access_location::host, access_mode::read);
+
+    std::vector<unsigned int> tmp_list1;
+    std::vector<unsigned int> tmp_list2;
+    unsigned int n_pairs = 0;
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        UP_ASSERT_EQUAL(h_n_neigh1.data[i], h_n_neigh2.data[i]);
+        n_pairs += h_n_neigh1.data[i];
+
+        tmp_list1.resize(h_n_neigh1.data[i]);
+        tmp_list2.resize(h_n_neigh1.data[i]);
+        for (unsigned int j = 0; j < h_n_neigh1.data[i]; j++)
+            {
+            tmp_list1[j] = h_nlist1.data[h_head_list1.data[i] + j];
+            tmp_list2[j] = h_nlist2.data[h_head_list2.data[i] + j];
+            if (mode == NeighborList::half)
+                UP_ASSERT(tmp_list2[j] > i);
+            }
+
+        sort(tmp_list1.begin(), tmp_list1.end());
+        sort(tmp_list2.begin(), tmp_list2.end());
+
+        UP_ASSERT_EQUAL(tmp_list1,tmp_list2);
+        }
+
+    // the test is only meaningful if there are neighbors
+    UP_ASSERT(n_pairs > 0);
+    }
+
+//! Compare a neighbor list with exact per-particle storage to one with per-type storage
+template <class NL>
+void neighborlist_exact_storage_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborList> nlist1(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist1->setRCutPair(0,0,3.0);
+    nlist1->setStorageMode(NeighborList::full);
+
+    std::shared_ptr<NeighborList> nlist2(new NL(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist2->setRCutPair(0,0,3.0);
+    nlist2->setStorageMode(NeighborList::full);
+    nlist2->setExactStorage(true, 0);
+    UP_ASSERT(nlist2->getExactStorage());
+
+    // the second build of the exact list is sized from the counts of the first one
+    for (unsigned int timestep = 0; timestep < 2; timestep++)
+        {
+        nlist1->forceUpdate();
+        nlist2->forceUpdate();
+        nlist1->compute(timestep);
+        nlist2->compute(timestep);
+
+        ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist1(nlist1->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list1(nlist1->getHeadList(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist2(nlist2->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list2(nlist2->getHeadList(), access_location::host, access_mode::read);
+
+        std::vector<unsigned int> tmp_list1;
+        std::vector<unsigned int> tmp_list2;
+
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            UP_ASSERT_EQUAL(h_n_neigh1.data[i], h_n_neigh2.data[i]);
+
+            // with no slack, the storage of every particle with a recorded count holds exactly its neighbors
+            if (timestep > 0)
+                UP_ASSERT_EQUAL(h_head_list2.data[i+1] - h_head_list2.data[i], h_n_neigh2.data[i]);
+            else
+                UP_ASSERT(h_head_list2.data[i+1] - h_head_list2.data[i] >= h_n_neigh2.data[i]);
+
+            tmp_list1.resize(h_n_neigh1.data[i]);
+            tmp_list2.resize(h_n_neigh1.data[i]);
+
+            for (unsigned int j = 0; j < h_n_neigh1.data[i]; j++)
+                {
+                tmp_list1[j] = h_nlist1.data[h_head_list1.data[i] + j];
+                tmp_list2[j] = h_nlist2.data[h_head_list2.data[i] + j];
+                }
+
+            sort(tmp_list1.begin(), tmp_list1.end());
+            sort(tmp_list2.begin(), tmp_list2.end());
+
+            UP_ASSERT_EQUAL(tmp_list1,tmp_list2);
+            }
+        }
+
+    // the per-type storage pads every particle to the largest neighbor count
+    UP_ASSERT(nlist2->getNlistSize() < nlist1->getNlistSize());
+    }
+
 //! Test that a NeighborList can successfully exclude a ridiculously large number of particles
 template <class NL>
 void neighborlist_large_ex_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
@@ -1196,6 +1521,55 @@ void neighborlist_2d_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
         }
     }
 
+//! Set the xy tilt factor of the box and scale the particles with it
+static void affine_shear(std::shared_ptr<ParticleData> pdata, Scalar xy)
+    {
+    BoxDim old_box = pdata->getGlobalBox();
+    BoxDim new_box = old_box;
+    new_box.setTiltFactors(xy, 0.0, 0.0);
+    pdata->setGlobalBox(new_box);
+
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        Scalar3 f = old_box.makeFraction(make_scalar3(h_pos.data[i].x, h_pos.data[i].y, h_pos.data[i].z));
+        Scalar3 pos = new_box.makeCoordinates(f);
+        h_pos.data[i].x = pos.x; h_pos.data[i].y = pos.y; h_pos.data[i].z = pos.z;
+        }
+    }
+
+//! Test that affine box deformations only rebuild the neighbor list once the strain uses up the buffer
+template<class NL>
+void neighborlist_affine_tests(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    auto sysdef = std::make_shared<SystemDefinition>(2, BoxDim(10.0), 1, 0, 0, 0, 0, exec_conf);
+    auto pdata = sysdef->getParticleData();
+
+    auto nlist = std::make_shared<NL>(sysdef, 1.0, 1.0);
+    nlist->setRCutPair(0,0,1.0);
+    nlist->setStorageMode(NeighborList::full);
+    nlist->setEvery(1, true);
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+
+        h_pos.data[0] = make_scalar4(0.0, 4.0, 0.0, __int_as_scalar(0));
+        h_pos.data[1] = make_scalar4(0.0, -4.0, 0.0, __int_as_scalar(0));
+        }
+    nlist->compute(0);
+    unsigned int n_updates = nlist->getNumUpdates();
+
+    // the particles move by 0.8 in x, but only along with the box
+    affine_shear(pdata, 0.2);
+    nlist->compute(1);
+    UP_ASSERT_EQUAL(nlist->getNumUpdates(), n_updates);
+
+    // a strain that uses up the buffer triggers a rebuild
+    affine_shear(pdata, 1.6);
+    nlist->compute(2);
+    UP_ASSERT(nlist->getNumUpdates() > n_updates);
+    }
+
 ///////////////
 // BINNED CPU
 ///////////////
@@ -1214,6 +1588,11 @@ UP_TEST( NeighborListBinned_large_ex )
     {
     neighborlist_large_ex_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! exclusion mask test case for binned class
+UP_TEST( NeighborListBinned_exclusion_mask )
+    {
+    neighborlist_exclusion_mask_test<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 //! body filter test case for binned class
 UP_TEST( NeighborListBinned_body_filter)
     {
@@ -1244,6 +1623,16 @@ UP_TEST( NeighborListBinned_2d )
     {
     neighborlist_2d_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! affine deformation tests for binned class
+UP_TEST( NeighborListBinned_affine )
+    {
+    neighborlist_affine_tests<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! exact storage test case for Binned class
+UP_TEST( NeighborListBinned_exact_storage )
+    {
+    neighborlist_exact_storage_test<NeighborListBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 
 ////////////////////
 // STENCIL CPU
@@ -1264,6 +1653,11 @@ UP_TEST( NeighborListStencil_large_ex )
     {
     neighborlist_large_ex_tests<NeighborListStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! exclusion mask test case for stencil class
+UP_TEST( NeighborListStencil_exclusion_mask )
+    {
+    neighborlist_exclusion_mask_test<NeighborListStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 //! body filter test case for stencil class
 UP_TEST( NeighborListStencil_body_filter)
     {
@@ -1300,6 +1694,24 @@ UP_TEST( NeighborListStencil_comparison )
     neighborlist_comparison_test<NeighborListBinned, NeighborListStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! comparison test case for multiple cell list levels in Stencil class
+UP_TEST( NeighborListStencil_multi_level_comparison )
+    {
+    neighborlist_multi_level_comparison_test<NeighborListBinned, NeighborListStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
+//! comparison test case for stencil class in a triclinic box with full storage
+UP_TEST( NeighborListStencil_triclinic_comparison_full )
+    {
+    neighborlist_triclinic_comparison_test<NeighborListBinned, NeighborListStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), NeighborList::full);
+    }
+
+//! comparison test case for stencil class in a triclinic box with half storage
+UP_TEST( NeighborListStencil_triclinic_comparison_half )
+    {
+    neighborlist_triclinic_comparison_test<NeighborListBinned, NeighborListStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), NeighborList::half);
+    }
+
 ///////////////
 // TREE CPU
 ///////////////
@@ -1318,6 +1730,11 @@ UP_TEST( NeighborListTree_large_ex )
     {
     neighborlist_large_ex_tests<NeighborListTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! exclusion mask test case for tree class
+UP_TEST( NeighborListTree_exclusion_mask )
+    {
+    neighborlist_exclusion_mask_test<NeighborListTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 //! body filter test case for tree class
 UP_TEST( NeighborListTree_body_filter)
     {
@@ -1353,6 +1770,16 @@ UP_TEST( NeighborListTree_comparison )
     {
     neighborlist_comparison_test<NeighborListBinned, NeighborListTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
+//! exact storage test case for Stencil class
+UP_TEST( NeighborListStencil_exact_storage )
+    {
+    neighborlist_exact_storage_test<NeighborListStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+//! exact storage test case for Tree class
+UP_TEST( NeighborListTree_exact_storage )
+    {
+    neighborlist_exact_storage_test<NeighborListTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
 
 #ifdef ENABLE_CUDA
 ///////////////
@@ -1373,6 +1800,11 @@ UP_TEST( NeighborListGPUBinned_large_ex )
     {
     neighborlist_large_ex_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
+//! exclusion mask test case for GPUBinned class
+UP_TEST( NeighborListGPUBinned_exclusion_mask )
+    {
+    neighborlist_exclusion_mask_test<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
 //! body filter test case for GPUBinned class
 UP_TEST( NeighborListGPUBinned_body_filter)
     {
@@ -1403,6 +1835,11 @@ UP_TEST( NeighborListGPUBinned_2d )
     {
     neighborlist_2d_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
+//! affine deformation tests for GPUBinned class
+UP_TEST( NeighborListGPUBinned_affine )
+    {
+    neighborlist_affine_tests<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
 //! comparison test case for GPUBinned class
 UP_TEST( NeighborListGPUBinned_comparison )
     {
@@ -1467,6 +1904,84 @@ UP_TEST( NeighborListGPUStencil_binned_comparison )
     {
     neighborlist_comparison_test<NeighborListGPUBinned, NeighborListGPUStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
+//! comparison test case for multiple cell list levels in GPUStencil class
+UP_TEST( NeighborListGPUStencil_multi_level_comparison )
+    {
+    neighborlist_multi_level_comparison_test<NeighborListGPUBinned, NeighborListGPUStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+
+//! Test that a refit NeighborListGPUTree finds the same neighbors as a rebuilt NeighborListTree
+void neighborlist_tree_refit_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    // construct the particle system
+    RandomInitializer init(1000, Scalar(0.016778), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<NeighborList> nlist1(new NeighborListTree(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist1->setRCutPair(0,0,3.0);
+    nlist1->setStorageMode(NeighborList::full);
+
+    std::shared_ptr<NeighborListGPUTree> nlist2(new NeighborListGPUTree(sysdef, Scalar(3.0), Scalar(0.4)));
+    nlist2->setRCutPair(0,0,3.0);
+    nlist2->setStorageMode(NeighborList::full);
+    nlist2->setRefitParams(10, Scalar(0.0));
+
+    nlist1->compute(0);
+    nlist2->compute(0);
+
+    // displace the particles without sorting them, so that the next build of nlist2 is a refit
+    for (unsigned int step = 1; step <= 3; ++step)
+        {
+            {
+            ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+            ArrayHandle<int3> h_image(pdata->getImages(), access_location::host, access_mode::readwrite);
+            const BoxDim& box = pdata->getBox();
+            for (unsigned int i = 0; i < pdata->getN(); i++)
+                {
+                h_pos.data[i].x += Scalar(0.15)*sin(Scalar(7*i+step));
+                h_pos.data[i].y += Scalar(0.15)*sin(Scalar(11*i+step));
+                h_pos.data[i].z += Scalar(0.15)*sin(Scalar(13*i+step));
+                box.wrap(h_pos.data[i], h_image.data[i]);
+                }
+            }
+
+        nlist1->forceUpdate();
+        nlist2->forceUpdate();
+        nlist1->compute(step);
+        nlist2->compute(step);
+
+        ArrayHandle<unsigned int> h_n_neigh1(nlist1->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist1(nlist1->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list1(nlist1->getHeadList(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_n_neigh2(nlist2->getNNeighArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_nlist2(nlist2->getNListArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_head_list2(nlist2->getHeadList(), access_location::host, access_mode::read);
+
+        std::vector<unsigned int> tmp_list1;
+        std::vector<unsigned int> tmp_list2;
+
+        for (unsigned int i = 0; i < pdata->getN(); i++)
+            {
+            UP_ASSERT_EQUAL(h_n_neigh1.data[i], h_n_neigh2.data[i]);
+
+            tmp_list1.resize(h_n_neigh1.data[i]);
+            tmp_list2.resize(h_n_neigh1.data[i]);
+
+            for (unsigned int j = 0; j < h_n_neigh1.data[i]; j++)
+                {
+                tmp_list1[j] = h_nlist1.data[h_head_list1.data[i] + j];
+                tmp_list2[j] = h_nlist2.data[h_head_list2.data[i] + j];
+                }
+
+            sort(tmp_list1.begin(), tmp_list1.end());
+            sort(tmp_list2.begin(), tmp_list2.end());
+
+            UP_ASSERT_EQUAL(tmp_list1,tmp_list2);
+            }
+        }
+    }
 
 ///////////////
 // TREE GPU
@@ -1537,4 +2052,25 @@ UP_TEST( NeighborListGPUTree_binned_comparison )
     std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::GPU));
     neighborlist_comparison_test<NeighborListGPUBinned, NeighborListGPUTree>(exec_conf);
     }
+//! comparison test case for a refit GPUTree with the CPU tree
+UP_TEST( NeighborListGPUTree_refit )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::GPU));
+    neighborlist_tree_refit_test(exec_conf);
+    }
+//! exact storage test case for GPUBinned class
+UP_TEST( NeighborListGPUBinned_exact_storage )
+    {
+    neighborlist_exact_storage_test<NeighborListGPUBinned>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+//! exact storage test case for GPUStencil class
+UP_TEST( NeighborListGPUStencil_exact_storage )
+    {
+    neighborlist_exact_storage_test<NeighborListGPUStencil>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+//! exact storage test case for GPUTree class
+UP_TEST( NeighborListGPUTree_exact_storage )
+    {
+    neighborlist_exact_storage_test<NeighborListGPUTree>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
 #endif
@@ -0,0 +1,152 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <vector>
+
+#include "hoomd/md/PairEvaluatorBatch.h"
+
+using namespace std;
+
+/*! \file test_pair_evaluator_batch.cc
+    \brief Implements unit tests for PairEvaluatorBatch
+    \ingroup unit_tests
+*/
+
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+//! Compare the batched evaluation of a batch of neighbors with the scalar evaluator
+/*! \param rsq Squared distances of the lanes
+    \param rcutsq Squared cutoff radii of the lanes
+    \param params Parameters of the lanes
+    \param energy_shift Shift mode passed to both evaluations
+
+    Lanes that the scalar evaluator skips must be zero in the batched result.
+*/
+template<class evaluator>
+void batch_compare(const std::vector<Scalar>& rsq,
+                   const std::vector<Scalar>& rcutsq,
+                   const std::vector<typename evaluator::param_type>& params,
+                   bool energy_shift)
+    {
+    const unsigned int n = rsq.size();
+    std::vector<Scalar> force_divr(n, Scalar(-1.0));
+    std::vector<Scalar> pair_eng(n, Scalar(-1.0));
+    PairEvaluatorBatch<evaluator>::evalForceAndEnergy(n,
+                                                      &rsq[0],
+                                                      &rcutsq[0],
+                                                      &params[0],
+                                                      energy_shift,
+                                                      &force_divr[0],
+                                                      &pair_eng[0]);
+
+    for (unsigned int k = 0; k < n; k++)
+        {
+        Scalar ref_force_divr = Scalar(0.0);
+        Scalar ref_pair_eng = Scalar(0.0);
+        evaluator eval(rsq[k], rcutsq[k], params[k]);
+        bool evaluated = eval.evalForceAndEnergy(ref_force_divr, ref_pair_eng, energy_shift);
+
+        if (evaluated)
+            {
+            MY_CHECK_CLOSE(force_divr[k], ref_force_divr, tol);
+            MY_CHECK_CLOSE(pair_eng[k], ref_pair_eng, tol);
+            }
+        else
+            {
+            MY_ASSERT_EQUAL(force_divr[k], Scalar(0.0));
+            MY_ASSERT_EQUAL(pair_eng[k], Scalar(0.0));
+            }
+        }
+    }
+
+//! Squared distances of the test batch, the last lanes are at and beyond the cutoff
+static std::vector<Scalar> batch_rsq()
+    {
+    Scalar r[] = {0.9, 1.0, 1.12, 1.3, 1.7, 2.1, 2.4, 2.5, 2.6, 3.5};
+    std::vector<Scalar> rsq;
+    for (unsigned int k = 0; k < sizeof(r)/sizeof(Scalar); k++)
+        rsq.push_back(r[k]*r[k]);
+    return rsq;
+    }
+
+//! Squared cutoff radii of the test batch, with one lane using a shorter cutoff
+static std::vector<Scalar> batch_rcutsq()
+    {
+    std::vector<Scalar> rcutsq(batch_rsq().size(), Scalar(2.5*2.5));
+    rcutsq[4] = Scalar(1.5*1.5);
+    return rcutsq;
+    }
+
+//! Test the batched LJ evaluator against EvaluatorPairLJ
+UP_TEST( PairEvaluatorBatch_LJ )
+    {
+    std::vector<Scalar> rsq = batch_rsq();
+    std::vector<Scalar> rcutsq = batch_rcutsq();
+
+    // lj1 = 4 epsilon sigma^12, lj2 = 4 epsilon sigma^6 with alternating epsilon and sigma, one lane switched off
+    std::vector<Scalar2> params;
+    for (unsigned int k = 0; k < rsq.size(); k++)
+        {
+        Scalar epsilon = (k % 2) ? Scalar(1.5) : Scalar(1.0);
+        Scalar sigma = (k % 3) ? Scalar(1.0) : Scalar(0.9);
+        params.push_back(make_scalar2(Scalar(4.0)*epsilon*pow(sigma, Scalar(12.0)),
+                                      Scalar(4.0)*epsilon*pow(sigma, Scalar(6.0))));
+        }
+    params[3] = make_scalar2(0.0, 0.0);
+
+    batch_compare<EvaluatorPairLJ>(rsq, rcutsq, params, false);
+    batch_compare<EvaluatorPairLJ>(rsq, rcutsq, params, true);
+    }
+
+//! Test the batched Gaussian evaluator against EvaluatorPairGauss
+UP_TEST( PairEvaluatorBatch_Gauss )
+    {
+    std::vector<Scalar> rsq = batch_rsq();
+    std::vector<Scalar> rcutsq = batch_rcutsq();
+
+    std::vector<Scalar2> params;
+    for (unsigned int k = 0; k < rsq.size(); k++)
+        params.push_back(make_scalar2((k % 2) ? Scalar(1.5) : Scalar(1.0), (k % 3) ? Scalar(0.5) : Scalar(0.75)));
+
+    batch_compare<EvaluatorPairGauss>(rsq, rcutsq, params, false);
+    batch_compare<EvaluatorPairGauss>(rsq, rcutsq, params, true);
+    }
+
+//! Test the batched Yukawa evaluator against EvaluatorPairYukawa
+UP_TEST( PairEvaluatorBatch_Yukawa )
+    {
+    std::vector<Scalar> rsq = batch_rsq();
+    std::vector<Scalar> rcutsq = batch_rcutsq();
+
+    std::vector<Scalar2> params;
+    for (unsigned int k = 0; k < rsq.size(); k++)
+        params.push_back(make_scalar2((k % 2) ? Scalar(1.5) : Scalar(1.0), (k % 3) ? Scalar(0.5) : Scalar(1.25)));
+    params[3] = make_scalar2(0.0, 0.5);
+
+    batch_compare<EvaluatorPairYukawa>(rsq, rcutsq, params, false);
+    batch_compare<EvaluatorPairYukawa>(rsq, rcutsq, params, true);
+    }
+
+//! Test the batched Morse evaluator against EvaluatorPairMorse
+UP_TEST( PairEvaluatorBatch_Morse )
+    {
+    std::vector<Scalar> rsq = batch_rsq();
+    std::vector<Scalar> rcutsq = batch_rcutsq();
+
+    std::vector<Scalar4> params;
+    for (unsigned int k = 0; k < rsq.size(); k++)
+        params.push_back(make_scalar4((k % 2) ? Scalar(1.5) : Scalar(1.0),
+                                      (k % 3) ? Scalar(3.0) : Scalar(2.0),
+                                      (k % 2) ? Scalar(1.0) : Scalar(1.2),
+                                      Scalar(0.0)));
+
+    batch_compare<EvaluatorPairMorse>(rsq, rcutsq, params, false);
+    batch_compare<EvaluatorPairMorse>(rsq, rcutsq, params, true);
+    }
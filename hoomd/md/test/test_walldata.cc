@@ -13,10 +13,13 @@ HOOMD_UP_MAIN();
 
 
 #include "hoomd/md/WallData.h"
+#include "hoomd/md/EvaluatorWalls.h"
+#include "hoomd/md/EvaluatorPairLJ.h"
 
 #include <memory>
 #include <cstdlib>
 #include <vector>
+#include <algorithm>
 
 UP_TEST( construction )
     {
@@ -275,3 +278,75 @@ UP_TEST( plane_wall_math )
     MY_CHECK_SMALL(vx.z, tol_small);
     MY_CHECK_SMALL(dx, tol_small);
     }
+
+//! Evaluate the wall forces of the particles at a set of positions with and without the culling grid
+void check_wall_culling(wall_type& walls, const BoxDim& box, Scalar r_cut, Scalar r_extrap)
+    {
+    typedef EvaluatorWalls<EvaluatorPairLJ> wall_evaluator;
+    wall_evaluator::param_type params = make_wall_params<EvaluatorPairLJ>(make_scalar2(4.0, 4.0), r_cut*r_cut,
+        r_extrap);
+
+    wall_type all_walls = walls;
+    all_walls.numCells = make_uint3(0,0,0);
+    buildWallCells(walls, box, std::max(r_cut, r_extrap), r_extrap > Scalar(0.0));
+
+    // the grid has to leave out some walls to be of use
+    unsigned int n_cells = walls.numCells.x*walls.numCells.y*walls.numCells.z;
+    UP_ASSERT(n_cells > 1 && n_cells <= MAX_N_WALL_CELLS);
+    UP_ASSERT(walls.Cells[0].spheres != (1u << walls.numSpheres) - 1);
+
+    // sample off the symmetry axes of the walls, where the direction to the wall is degenerate
+    Scalar3 lo = box.getLo();
+    Scalar3 L = box.getL();
+    unsigned int n = 23;
+    for (unsigned int i = 0; i < n; ++i)
+        for (unsigned int j = 0; j < n; ++j)
+            for (unsigned int k = 0; k < n; ++k)
+                {
+                Scalar3 pos = lo + make_scalar3(L.x*(i+Scalar(0.37))/n, L.y*(j+Scalar(0.61))/n,
+                    L.z*(k+Scalar(0.53))/n);
+
+                Scalar3 F, F_all;
+                Scalar energy, energy_all;
+                Scalar virial[6], virial_all[6];
+                wall_evaluator eval(pos, box, params, walls);
+                eval.evalForceEnergyAndVirial(F, energy, virial);
+                wall_evaluator eval_all(pos, box, params, all_walls);
+                eval_all.evalForceEnergyAndVirial(F_all, energy_all, virial_all);
+
+                UP_ASSERT_EQUAL(F.x, F_all.x);
+                UP_ASSERT_EQUAL(F.y, F_all.y);
+                UP_ASSERT_EQUAL(F.z, F_all.z);
+                UP_ASSERT_EQUAL(energy, energy_all);
+                }
+    }
+
+UP_TEST( wall_culling )
+    {
+    BoxDim box(20.0);
+
+    // a porous geometry of spherical and cylindrical pores inside a slit
+    wall_type walls;
+    walls.numSpheres = 12;
+    for (unsigned int i = 0; i < walls.numSpheres; ++i)
+        walls.Spheres[i] = SphereWall(1.0 + 0.1*i, make_scalar3(-8.0 + 1.4*i, 3.0*((i % 3) - 1.0), 7.0 - 1.3*i), i % 2);
+    walls.numCylinders = 4;
+    walls.Cylinders[0] = CylinderWall(2.0, make_scalar3(0,0,0), make_scalar3(0,0,1), false);
+    walls.Cylinders[1] = CylinderWall(1.5, make_scalar3(5,-5,0), make_scalar3(1,1,0), false);
+    walls.Cylinders[2] = CylinderWall(9.0, make_scalar3(0,0,0), make_scalar3(1,0,0), true);
+    walls.Cylinders[3] = CylinderWall(0.5, make_scalar3(-6,6,3), make_scalar3(0.2,0.3,1), false);
+    walls.numPlanes = 2;
+    walls.Planes[0] = PlaneWall(make_scalar3(0,0,-9.5), make_scalar3(0,0,1), true);
+    walls.Planes[1] = PlaneWall(make_scalar3(0,0,9.5), make_scalar3(0,0,-1), true);
+
+    // standard mode
+    check_wall_culling(walls, box, 2.5, 0.0);
+
+    // extrapolated mode acts on particles outside of the half spaces
+    check_wall_culling(walls, box, 2.5, 1.1);
+
+    // triclinic box
+    BoxDim tilted(20.0);
+    tilted.setTiltFactors(0.3, -0.2, 0.1);
+    check_wall_culling(walls, tilted, 1.0, 0.0);
+    }
@@ -610,7 +610,19 @@ class wallpotential(external._external_force):
     ## \internal
     # \brief passes the wall field
     def process_field_coeff(self, coeff):
-        return _md.make_wall_field_params(coeff, hoomd.context.exec_conf);
+        # the culling grid skips walls farther than the largest cutoff or extrapolation distance from a particle
+        r_max = 0.0;
+        extrapolated = False;
+        pdata = hoomd.context.current.system_definition.getParticleData();
+        for i in range(0,pdata.getNTypes()):
+            type = pdata.getNameByType(i);
+            r_cut = self.force_coeff.get(type, 'r_cut');
+            r_extrap = self.force_coeff.get(type, 'r_extrap');
+            r_max = max(r_max, r_cut, r_extrap);
+            if r_extrap > 0.0:
+                extrapolated = True;
+
+        return _md.make_wall_field_params(coeff, hoomd.context.exec_conf, pdata.getGlobalBox(), r_max, extrapolated);
 
     ## \internal
     # \brief Return metadata for this wall potential
@@ -139,27 +139,27 @@ void EAMForceCompute::loadFile(char *filename, int type_of_file)
         }
 
     //allocate potential data storage
-    GPUArray<Scalar4> t_F(nrho * m_ntypes, m_exec_conf);
+    GlobalArray<Scalar4> t_F(nrho * m_ntypes, m_exec_conf);
     m_F.swap(t_F);
     ArrayHandle<Scalar4> h_F(m_F, access_location::host, access_mode::readwrite);
 
-    GPUArray<Scalar4> t_rho(nr * m_ntypes * m_ntypes, m_exec_conf);
+    GlobalArray<Scalar4> t_rho(nr * m_ntypes * m_ntypes, m_exec_conf);
     m_rho.swap(t_rho);
     ArrayHandle<Scalar4> h_rho(m_rho, access_location::host, access_mode::readwrite);
 
-    GPUArray<Scalar4> t_rphi((int) (0.5 * nr * (m_ntypes + 1) * m_ntypes), m_exec_conf);
+    GlobalArray<Scalar4> t_rphi((int) (0.5 * nr * (m_ntypes + 1) * m_ntypes), m_exec_conf);
     m_rphi.swap(t_rphi);
     ArrayHandle<Scalar4> h_rphi(m_rphi, access_location::host, access_mode::readwrite);
 
-    GPUArray<Scalar4> t_dF(nrho * m_ntypes, m_exec_conf);
+    GlobalArray<Scalar4> t_dF(nrho * m_ntypes, m_exec_conf);
     m_dF.swap(t_dF);
     ArrayHandle<Scalar4> h_dF(m_dF, access_location::host, access_mode::readwrite);
 
-    GPUArray<Scalar4> t_drho(nr * m_ntypes * m_ntypes, m_exec_conf);
+    GlobalArray<Scalar4> t_drho(nr * m_ntypes * m_ntypes, m_exec_conf);
     m_drho.swap(t_drho);
     ArrayHandle<Scalar4> h_drho(m_drho, access_location::host, access_mode::readwrite);
 
-    GPUArray<Scalar4> t_drphi((int) (0.5 * nr * (m_ntypes + 1) * m_ntypes), m_exec_conf);
+    GlobalArray<Scalar4> t_drphi((int) (0.5 * nr * (m_ntypes + 1) * m_ntypes), m_exec_conf);
     m_drphi.swap(t_drphi);
     ArrayHandle<Scalar4> h_drphi(m_drphi, access_location::host, access_mode::readwrite);
 
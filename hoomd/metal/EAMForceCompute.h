@@ -5,6 +5,7 @@
 // Previous Maintainer: Morozov
 
 #include "hoomd/ForceCompute.h"
+#include "hoomd/GlobalArray.h"
 #include "hoomd/md/NeighborList.h"
 
 #include <memory>
@@ -33,7 +34,7 @@
  coefficients.
 
  \b Potential memory layout
- The potential data and the coefficients are stored in six GPUArray<Scalar> arrays: the embedded
+ The potential data and the coefficients are stored in six GlobalArray<Scalar4> arrays: the embedded
  potential function (m_F) and its derivative (m_dF), the electron density function (m_rho) and its
  derivative (m_drho), the pair potential function (m_rphi) and its derivative (m_drphi). The 3
  coefficients for a data point is stored continuously, for example, h_F.data[100].w is the embedded
@@ -68,6 +69,14 @@ public:
     //! Load EAM potential file
     virtual void loadFile(char *filename, int type_of_file);
 
+    #ifdef ENABLE_MPI
+    //! The half-shell ghost exchange is not supported
+    virtual bool supportsHalfShell()
+        {
+        return false;
+        }
+    #endif
+
 protected:
     std::shared_ptr<NeighborList> m_nlist; //!< the neighborlist to use for the computation
     Scalar m_r_cut;                        //!< cut-off radius
@@ -85,13 +94,12 @@ protected:
     std::vector<std::string> atomcomment;  //!< atom comment
     std::vector<std::string> names;        //!< array names(type)
 
-    GPUArray<Scalar4> m_F;                 //!< embedded function and its coefficients
-    GPUArray<Scalar4> m_rho;               //!< electron density and its coefficients
-    GPUArray<Scalar4> m_rphi;              //!< pair wise function and its coefficients
-    GPUArray<Scalar4> m_dF;                //!< derivative embedded function and its coefficients
-    GPUArray<Scalar4> m_drho;              //!< derivative electron density and its coefficients
-    GPUArray<Scalar4> m_drphi;             //!< derivative pair wise function and its coefficients
-    GPUArray<Scalar> m_dFdP;               //!< derivative F / derivative P
+    GlobalArray<Scalar4> m_F;              //!< embedded function and its coefficients
+    GlobalArray<Scalar4> m_rho;            //!< electron density and its coefficients
+    GlobalArray<Scalar4> m_rphi;           //!< pair wise function and its coefficients
+    GlobalArray<Scalar4> m_dF;             //!< derivative embedded function and its coefficients
+    GlobalArray<Scalar4> m_drho;           //!< derivative electron density and its coefficients
+    GlobalArray<Scalar4> m_drphi;          //!< derivative pair wise function and its coefficients
 
     //! Actually compute the forces
     virtual void computeForces(unsigned int timestep);
@@ -47,6 +47,30 @@ EAMForceComputeGPU::EAMForceComputeGPU(std::shared_ptr<SystemDefinition> sysdef,
     eam_data.r_cutsq = m_r_cut * m_r_cut; //!< r_cut^2
     eam_data.ntypes = m_ntypes;           //!< number of potential element types
 
+    if (m_exec_conf->allConcurrentManagedAccess())
+        {
+        // the tables are read by every GPU
+        auto& gpu_map = m_exec_conf->getGPUIds();
+
+        cudaMemAdvise(m_F.get(), m_F.getNumElements()*sizeof(Scalar4), cudaMemAdviseSetReadMostly, 0);
+        cudaMemAdvise(m_rho.get(), m_rho.getNumElements()*sizeof(Scalar4), cudaMemAdviseSetReadMostly, 0);
+        cudaMemAdvise(m_rphi.get(), m_rphi.getNumElements()*sizeof(Scalar4), cudaMemAdviseSetReadMostly, 0);
+        cudaMemAdvise(m_dF.get(), m_dF.getNumElements()*sizeof(Scalar4), cudaMemAdviseSetReadMostly, 0);
+        cudaMemAdvise(m_drho.get(), m_drho.getNumElements()*sizeof(Scalar4), cudaMemAdviseSetReadMostly, 0);
+        cudaMemAdvise(m_drphi.get(), m_drphi.getNumElements()*sizeof(Scalar4), cudaMemAdviseSetReadMostly, 0);
+
+        for (unsigned int idev = 0; idev < m_exec_conf->getNumActiveGPUs(); ++idev)
+            {
+            // prefetch data on all GPUs
+            cudaMemPrefetchAsync(m_F.get(), sizeof(Scalar4)*m_F.getNumElements(), gpu_map[idev]);
+            cudaMemPrefetchAsync(m_rho.get(), sizeof(Scalar4)*m_rho.getNumElements(), gpu_map[idev]);
+            cudaMemPrefetchAsync(m_rphi.get(), sizeof(Scalar4)*m_rphi.getNumElements(), gpu_map[idev]);
+            cudaMemPrefetchAsync(m_dF.get(), sizeof(Scalar4)*m_dF.getNumElements(), gpu_map[idev]);
+            cudaMemPrefetchAsync(m_drho.get(), sizeof(Scalar4)*m_drho.getNumElements(), gpu_map[idev]);
+            cudaMemPrefetchAsync(m_drphi.get(), sizeof(Scalar4)*m_drphi.getNumElements(), gpu_map[idev]);
+            }
+        }
+
     CHECK_CUDA_ERROR();
     }
 
@@ -92,22 +116,46 @@ void EAMForceComputeGPU::computeForces(unsigned int timestep)
     ArrayHandle<Scalar4> d_rphi(m_rphi, access_location::device, access_mode::read);
     ArrayHandle<Scalar4> d_drphi(m_drphi, access_location::device, access_mode::read);
 
-    // Derivative Embedding Function for each atom
-    GPUArray<Scalar> t_dFdP(m_pdata->getN(), m_exec_conf);
-    m_dFdP.swap(t_dFdP);
-    ArrayHandle<Scalar> d_dFdP(m_dFdP, access_location::device, access_mode::overwrite);
+    // Derivative Embedding Function and electron density for each atom, reallocated only when the system grows
+    if (m_dFdP.getNumElements() < m_pdata->getN())
+        {
+        GlobalArray<Scalar2> t_dFdP(m_pdata->getMaxN(), m_exec_conf);
+        m_dFdP.swap(t_dFdP);
+
+        if (m_exec_conf->allConcurrentManagedAccess())
+            {
+            // every GPU reads the values of neighbors owned by the other GPUs
+            auto& gpu_map = m_exec_conf->getGPUIds();
+            for (unsigned int idev = 0; idev < m_exec_conf->getNumActiveGPUs(); ++idev)
+                cudaMemAdvise(m_dFdP.get(), sizeof(Scalar2)*m_dFdP.getNumElements(), cudaMemAdviseSetAccessedBy,
+                    gpu_map[idev]);
+            CHECK_CUDA_ERROR();
+            }
+        }
+
+    ArrayHandle<Scalar2> d_dFdP(m_dFdP, access_location::device, access_mode::overwrite);
 
     // Compute energy and forces in GPU
+    m_exec_conf->beginMultiGPU();
     m_tuner->begin();
     eam_data.block_size = m_tuner->getParam();
-    gpu_compute_eam_tex_inter_forces(d_force.data, d_virial.data, m_virial.getPitch(), m_pdata->getN(), d_pos.data, box,
-            d_n_neigh.data, d_nlist.data, d_head_list.data, this->m_nlist->getNListArray().getPitch(), eam_data,
-            d_dFdP.data, d_F.data, d_rho.data, d_rphi.data, d_dF.data, d_drho.data, d_drphi.data,
-            m_exec_conf->getComputeCapability() / 10, m_exec_conf->dev_prop.maxTexture1DLinear);
+    gpu_compute_eam_tex_inter_density(m_pdata->getN(), d_pos.data, box, d_n_neigh.data, d_nlist.data,
+            d_head_list.data, this->m_nlist->getNListArray().getPitch(), eam_data, d_dFdP.data, d_rho.data,
+            d_dF.data, m_exec_conf->getComputeCapability() / 10, m_exec_conf->dev_prop.maxTexture1DLinear,
+            m_pdata->getGPUPartition());
+
+    // the second pass reads dF/dP of the neighbors from all GPUs
+    m_exec_conf->multiGPUBarrier();
+
+    gpu_compute_eam_tex_inter_forces(d_force.data, d_virial.data, m_virial.getPitch(), m_pdata->getN(), d_pos.data,
+            box, d_n_neigh.data, d_nlist.data, d_head_list.data, this->m_nlist->getNListArray().getPitch(), eam_data,
+            d_dFdP.data, d_F.data, d_rphi.data, d_drho.data, d_drphi.data, m_exec_conf->getComputeCapability() / 10,
+            m_exec_conf->dev_prop.maxTexture1DLinear, m_pdata->getGPUPartition());
 
     if (m_exec_conf->isCUDAErrorCheckingEnabled())
         CHECK_CUDA_ERROR();
     m_tuner->end();
+    m_exec_conf->endMultiGPU();
 
     if (m_prof)
         m_prof->pop(m_exec_conf);
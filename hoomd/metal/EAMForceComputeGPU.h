@@ -24,6 +24,12 @@
 
 //! Computes EAM forces on each particle using the GPU
 /*! Calculates the same forces as EAMForceCompute, but on the GPU by using texture memory(CUDAArray).
+
+ The forces are computed in two passes over the neighbor list. The first pass sums the electron density of every
+ particle and stores it with the derivative of the embedding function in m_dFdP. The second pass evaluates the
+ embedding energy and the pair forces. With multiple GPUs, both passes are split across the GPUs with the particle
+ partition of ParticleData, and the GPUs synchronize between the passes because the second pass reads m_dFdP of
+ the neighbors. The potential tables are read mostly and prefetched to every GPU.
  */
 class EAMForceComputeGPU: public EAMForceCompute
     {
@@ -47,6 +53,7 @@ public:
 
 protected:
     EAMTexInterData eam_data;             //!< EAM parameters to be communicated
+    GlobalArray<Scalar2> m_dFdP;          //!< derivative F / derivative P and electron density of every particle
     std::unique_ptr<Autotuner> m_tuner;         //!< autotuner for block size
     //! Actually compute the forces
     virtual void computeForces(unsigned int timestep);
@@ -24,18 +24,30 @@ scalar4_tex_t tex_rphi;
 scalar4_tex_t tex_dF;
 scalar4_tex_t tex_drho;
 scalar4_tex_t tex_drphi;
-//! Texture for dF/dP
-scalar_tex_t tex_dFdP;
-
-//! Storage space for EAM parameters on the GPU
-__constant__ EAMTexInterData eam_data_ti;
-
-//! Kernel for computing EAM forces on the GPU
+//! Texture for dF/dP and the electron density
+scalar2_tex_t tex_dFdP;
+
+//! First stage kernel for computing EAM forces on the GPU
+/*! \param N Number of particles to process on this GPU
+    \param d_pos Particle positions
+    \param box Simulation box
+    \param d_n_neigh Number of neighbors of every particle
+    \param d_nlist Neighbor list
+    \param d_head_list Index of the first neighbor of every particle in \a d_nlist
+    \param eam_data EAM parameters
+    \param d_rho Electron density table
+    \param d_dF Embedding function derivative table
+    \param d_dFdP Embedding function derivative dF/dP and electron density of every particle (output)
+    \param offset Index of the first particle processed by this GPU
+
+    Every thread sums the electron density of one particle and writes it together with the derivative of the
+    embedding function, which the second stage reads for the particle and all of its neighbors. The embedding energy
+    itself is evaluated in the second stage.
+*/
 template<unsigned char use_gmem_nlist>
-__global__ void gpu_kernel_1(Scalar4 *d_force, Scalar *d_virial, const unsigned int virial_pitch, const unsigned int N,
-        const Scalar4 *d_pos, BoxDim box, const unsigned int *d_n_neigh, const unsigned int *d_nlist,
-        const unsigned int *d_head_list, const Scalar4 *d_F, const Scalar4 *d_rho, const Scalar4 *d_rphi,
-        const Scalar4 *d_dF, const Scalar4 *d_drho, const Scalar4 *d_drphi, Scalar *d_dFdP)
+__global__ void gpu_kernel_1(const unsigned int N, const Scalar4 *d_pos, BoxDim box, const unsigned int *d_n_neigh,
+        const unsigned int *d_nlist, const unsigned int *d_head_list, const EAMTexInterData eam_data,
+        const Scalar4 *d_rho, const Scalar4 *d_dF, Scalar2 *d_dFdP, const unsigned int offset)
     {
 
     // start by identifying which particle we are to handle
@@ -44,6 +56,8 @@ __global__ void gpu_kernel_1(Scalar4 *d_force, Scalar *d_virial, const unsigned
     if (idx >= N)
     return;
 
+    idx += offset;
+
     // load in the length of the list
     int n_neigh = d_n_neigh[idx];
     const unsigned int head_idx = d_head_list[idx];
@@ -59,9 +73,6 @@ __global__ void gpu_kernel_1(Scalar4 *d_force, Scalar *d_virial, const unsigned
     Scalar remainder;// look up remainder in array, integer
     Scalar4 v, dv;// value, d(value)
 
-    // initialize the force to 0
-    Scalar4 force = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
-
     // prefetch neighbor index
     int cur_neigh = 0;
     int next_neigh(0);
@@ -77,12 +88,12 @@ __global__ void gpu_kernel_1(Scalar4 *d_force, Scalar *d_virial, const unsigned
 
     // loop over neighbors
     Scalar atomElectronDensity = Scalar(0.0);
-    int ntypes = eam_data_ti.ntypes;
-    int nrho = eam_data_ti.nrho;
-    int nr = eam_data_ti.nr;
-    Scalar rdrho = eam_data_ti.rdrho;
-    Scalar rdr = eam_data_ti.rdr;
-    Scalar r_cutsq = eam_data_ti.r_cutsq;
+    int ntypes = eam_data.ntypes;
+    int nrho = eam_data.nrho;
+    int nr = eam_data.nr;
+    Scalar rdrho = eam_data.rdrho;
+    Scalar rdr = eam_data.rdr;
+    Scalar r_cutsq = eam_data.r_cutsq;
 
     for (int neigh_idx = 0; neigh_idx < n_neigh; neigh_idx++)
         {
@@ -134,22 +145,36 @@ __global__ void gpu_kernel_1(Scalar4 *d_force, Scalar *d_virial, const unsigned
 
     idxs = int_position + typei * nrho;
     dv = texFetchScalar4(d_dF, tex_dF, idxs);
-    v = texFetchScalar4(d_F, tex_F, idxs);
     // compute dF / dP
-    d_dFdP[idx] = dv.z + dv.y * remainder + dv.x * remainder * remainder;
-    // compute embedded energy F(P), sum up each particle
-    force.w += v.w + v.z * remainder + v.y * remainder * remainder + v.x * remainder * remainder * remainder;
-    // update the d_force
-    d_force[idx] = force;
-
+    d_dFdP[idx] = make_scalar2(dv.z + dv.y * remainder + dv.x * remainder * remainder, atomElectronDensity);
     }
 
 //! Second stage kernel for computing EAM forces on the GPU
+/*! \param d_force Forces (output)
+    \param d_virial Virial (output)
+    \param virial_pitch Pitch of the virial array
+    \param N Number of particles to process on this GPU
+    \param d_pos Particle positions
+    \param box Simulation box
+    \param d_n_neigh Number of neighbors of every particle
+    \param d_nlist Neighbor list
+    \param d_head_list Index of the first neighbor of every particle in \a d_nlist
+    \param eam_data EAM parameters
+    \param d_F Embedding function table
+    \param d_rphi Pair potential table
+    \param d_drho Electron density derivative table
+    \param d_drphi Pair potential derivative table
+    \param d_dFdP Embedding function derivative dF/dP and electron density of every particle
+    \param offset Index of the first particle processed by this GPU
+
+    The embedding energy of the particle is evaluated from its electron density in this stage, so that the force,
+    energy and virial are written once.
+*/
 template<unsigned char use_gmem_nlist>
 __global__ void gpu_kernel_2(Scalar4 *d_force, Scalar *d_virial, const unsigned int virial_pitch, const unsigned int N,
         const Scalar4 *d_pos, BoxDim box, const unsigned int *d_n_neigh, const unsigned int *d_nlist,
-        const unsigned int *d_head_list, const Scalar4 *d_F, const Scalar4 *d_rho, const Scalar4 *d_rphi,
-        const Scalar4 *d_dF, const Scalar4 *d_drho, const Scalar4 *d_drphi, Scalar *d_dFdP)
+        const unsigned int *d_head_list, const EAMTexInterData eam_data, const Scalar4 *d_F, const Scalar4 *d_rphi,
+        const Scalar4 *d_drho, const Scalar4 *d_drphi, const Scalar2 *d_dFdP, const unsigned int offset)
     {
 
     // start by identifying which particle we are to handle
@@ -158,6 +183,8 @@ __global__ void gpu_kernel_2(Scalar4 *d_force, Scalar *d_virial, const unsigned
     if (idx >= N)
     return;
 
+    idx += offset;
+
     // load in the length of the list
     int n_neigh = d_n_neigh[idx];
     const unsigned int head_idx = d_head_list[idx];
@@ -185,9 +212,7 @@ __global__ void gpu_kernel_2(Scalar4 *d_force, Scalar *d_virial, const unsigned
         {
         next_neigh = texFetchUint(d_nlist, nlist_tex, head_idx);
         }
-    //Scalar4 force = force_data.force[idx];
     Scalar4 force = make_scalar4(Scalar(0.0), Scalar(0.0), Scalar(0.0), Scalar(0.0));
-    //force.w = force_data.force[idx].w;
     Scalar fxi = Scalar(0.0);
     Scalar fyi = Scalar(0.0);
     Scalar fzi = Scalar(0.0);
@@ -197,12 +222,23 @@ __global__ void gpu_kernel_2(Scalar4 *d_force, Scalar *d_virial, const unsigned
     for (int i = 0; i < 6; i++)
     virial[i] = Scalar(0.0);
 
-    force.w = d_force[idx].w;
-    int ntypes = eam_data_ti.ntypes;
-    int nr = eam_data_ti.nr;
-    Scalar rdr = eam_data_ti.rdr;
-    Scalar r_cutsq = eam_data_ti.r_cutsq;
-    Scalar d_dFdPidx = texFetchScalar(d_dFdP, tex_dFdP, idx);
+    int ntypes = eam_data.ntypes;
+    int nr = eam_data.nr;
+    int nrho = eam_data.nrho;
+    Scalar rdr = eam_data.rdr;
+    Scalar rdrho = eam_data.rdrho;
+    Scalar r_cutsq = eam_data.r_cutsq;
+    Scalar2 dFdP_rho = texFetchScalar2(d_dFdP, tex_dFdP, idx);
+    Scalar d_dFdPidx = dFdP_rho.x;
+
+    // compute embedded energy F(P)
+    position = dFdP_rho.y * rdrho;
+    int_position = (unsigned int) position;
+    int_position = min(int_position, nrho - 1);
+    remainder = position - int_position;
+    v = texFetchScalar4(d_F, tex_F, int_position + typei * nrho);
+    force.w = v.w + v.z * remainder + v.y * remainder * remainder + v.x * remainder * remainder * remainder;
+
     for (int neigh_idx = 0; neigh_idx < n_neigh; neigh_idx++)
         {
         cur_neigh = next_neigh;
@@ -265,7 +301,7 @@ __global__ void gpu_kernel_2(Scalar4 *d_force, Scalar *d_virial, const unsigned
         dv = texFetchScalar4(d_drho, tex_drho, idxs);
         Scalar derivativeRhoJ = dv.z + dv.y * remainder + dv.x * remainder * remainder;
         // fullDerivativePhi = dF/dP * drho / dr for j + dF/dP * drho / dr for j + phi
-        Scalar d_dFdPcur = texFetchScalar(d_dFdP, tex_dFdP, cur_neigh);
+        Scalar d_dFdPcur = texFetchScalar2(d_dFdP, tex_dFdP, cur_neigh).x;
         Scalar fullDerivativePhi = d_dFdPidx * derivativeRhoJ + d_dFdPcur * derivativeRhoI + derivativePhi;
         // compute forces
         pairForce = -fullDerivativePhi * inverseR;
@@ -296,18 +332,16 @@ __global__ void gpu_kernel_2(Scalar4 *d_force, Scalar *d_virial, const unsigned
 
     }
 
-//! compute forces on GPU
-cudaError_t gpu_compute_eam_tex_inter_forces(Scalar4 *d_force, Scalar *d_virial, const unsigned int virial_pitch,
-        const unsigned int N, const Scalar4 *d_pos, const BoxDim &box, const unsigned int *d_n_neigh,
-        const unsigned int *d_nlist, const unsigned int *d_head_list, const unsigned int size_nlist,
-        const EAMTexInterData &eam_data, Scalar *d_dFdP, const Scalar4 *d_F, const Scalar4 *d_rho,
-        const Scalar4 *d_rphi, const Scalar4 *d_dF, const Scalar4 *d_drho, const Scalar4 *d_drphi,
-        const unsigned int compute_capability, const unsigned int max_tex1d_width)
+//! Bind the textures of the neighbor list and the particle data of an EAM pass
+/*! Texture references are bound on the current device only. Multi-GPU execution requires concurrent managed
+    memory access (compute capability 6.0 and newer), where texFetch reads through __ldg and no textures are used.
+*/
+static cudaError_t gpu_eam_bind_textures(const unsigned int N, const Scalar4 *d_pos, const unsigned int *d_nlist,
+        const unsigned int size_nlist, const Scalar2 *d_dFdP, const unsigned int compute_capability,
+        const unsigned int max_tex1d_width)
     {
-
     cudaError_t error;
 
-    // bind the texture
     if (compute_capability < 350 && size_nlist <= max_tex1d_width)
         {
         nlist_tex.normalized = false;
@@ -319,12 +353,42 @@ cudaError_t gpu_compute_eam_tex_inter_forces(Scalar4 *d_force, Scalar *d_virial,
 
     if (compute_capability < 350)
         {
-        tex_F.normalized = false;
-        tex_F.filterMode = cudaFilterModePoint;
-        error = cudaBindTexture(0, tex_F, d_F, sizeof(Scalar4) * eam_data.nrho * eam_data.ntypes);
+        pdata_pos_tex.normalized = false;
+        pdata_pos_tex.filterMode = cudaFilterModePoint;
+        error = cudaBindTexture(0, pdata_pos_tex, d_pos, sizeof(Scalar4) * N);
         if (error != cudaSuccess)
             return error;
 
+        tex_dFdP.normalized = false;
+        tex_dFdP.filterMode = cudaFilterModePoint;
+        error = cudaBindTexture(0, tex_dFdP, d_dFdP, sizeof(Scalar2) * N);
+        if (error != cudaSuccess)
+            return error;
+        }
+
+    return cudaSuccess;
+    }
+
+//! Compute the electron density and dF/dP on the GPU
+/*! \param N Number of local particles
+    \param gpu_partition Partition of the particles between the active GPUs
+
+    The particles are processed by the GPUs in \a gpu_partition. The caller must synchronize all GPUs before the
+    second pass reads \a d_dFdP, see ExecutionConfiguration::multiGPUBarrier().
+*/
+cudaError_t gpu_compute_eam_tex_inter_density(const unsigned int N, const Scalar4 *d_pos, const BoxDim& box,
+        const unsigned int *d_n_neigh, const unsigned int *d_nlist, const unsigned int *d_head_list,
+        const unsigned int size_nlist, const EAMTexInterData& eam_data, Scalar2 *d_dFdP, const Scalar4 *d_rho,
+        const Scalar4 *d_dF, const unsigned int compute_capability, const unsigned int max_tex1d_width,
+        const GPUPartition& gpu_partition)
+    {
+    cudaError_t error = gpu_eam_bind_textures(N, d_pos, d_nlist, size_nlist, d_dFdP, compute_capability,
+        max_tex1d_width);
+    if (error != cudaSuccess)
+        return error;
+
+    if (compute_capability < 350)
+        {
         tex_dF.normalized = false;
         tex_dF.filterMode = cudaFilterModePoint;
         error = cudaBindTexture(0, tex_dF, d_dF, sizeof(Scalar4) * eam_data.nrho * eam_data.ntypes);
@@ -333,14 +397,75 @@ cudaError_t gpu_compute_eam_tex_inter_forces(Scalar4 *d_force, Scalar *d_virial,
 
         tex_rho.normalized = false;
         tex_rho.filterMode = cudaFilterModePoint;
-        error = cudaBindTexture(0, tex_rho, d_rho, sizeof(Scalar4) * eam_data.nrho * eam_data.ntypes * eam_data.ntypes);
+        error = cudaBindTexture(0, tex_rho, d_rho, sizeof(Scalar4) * eam_data.nr * eam_data.ntypes * eam_data.ntypes);
+        if (error != cudaSuccess)
+            return error;
+        }
+
+    bool use_gmem_nlist = compute_capability < 350 && size_nlist > max_tex1d_width;
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, gpu_kernel_1<0>);
+        max_block_size = attr.maxThreadsPerBlock;
+        cudaFuncGetAttributes(&attr, gpu_kernel_1<1>);
+        max_block_size = min(max_block_size, (unsigned int)attr.maxThreadsPerBlock);
+        }
+
+    unsigned int run_block_size = min(eam_data.block_size, max_block_size);
+
+    // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
+    for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        auto range = gpu_partition.getRangeAndSetGPU(idev);
+        unsigned int nwork = range.second - range.first;
+
+        // setup the grid to run the kernel
+        dim3 grid(nwork / run_block_size + 1, 1, 1);
+        dim3 threads(run_block_size, 1, 1);
+
+        if (use_gmem_nlist)
+            gpu_kernel_1<1> <<<grid, threads>>>(nwork, d_pos, box, d_n_neigh, d_nlist, d_head_list, eam_data,
+                d_rho, d_dF, d_dFdP, range.first);
+        else
+            gpu_kernel_1<0> <<<grid, threads>>>(nwork, d_pos, box, d_n_neigh, d_nlist, d_head_list, eam_data,
+                d_rho, d_dF, d_dFdP, range.first);
+        }
+
+    return cudaSuccess;
+    }
+
+//! compute forces on GPU
+/*! \param gpu_partition Partition of the particles between the active GPUs
+
+    Reads the electron densities and dF/dP written by gpu_compute_eam_tex_inter_density() for all particles.
+*/
+cudaError_t gpu_compute_eam_tex_inter_forces(Scalar4 *d_force, Scalar *d_virial, const unsigned int virial_pitch,
+        const unsigned int N, const Scalar4 *d_pos, const BoxDim &box, const unsigned int *d_n_neigh,
+        const unsigned int *d_nlist, const unsigned int *d_head_list, const unsigned int size_nlist,
+        const EAMTexInterData &eam_data, const Scalar2 *d_dFdP, const Scalar4 *d_F, const Scalar4 *d_rphi,
+        const Scalar4 *d_drho, const Scalar4 *d_drphi, const unsigned int compute_capability,
+        const unsigned int max_tex1d_width, const GPUPartition& gpu_partition)
+    {
+    cudaError_t error = gpu_eam_bind_textures(N, d_pos, d_nlist, size_nlist, d_dFdP, compute_capability,
+        max_tex1d_width);
+    if (error != cudaSuccess)
+        return error;
+
+    if (compute_capability < 350)
+        {
+        tex_F.normalized = false;
+        tex_F.filterMode = cudaFilterModePoint;
+        error = cudaBindTexture(0, tex_F, d_F, sizeof(Scalar4) * eam_data.nrho * eam_data.ntypes);
         if (error != cudaSuccess)
             return error;
 
         tex_drho.normalized = false;
         tex_drho.filterMode = cudaFilterModePoint;
         error = cudaBindTexture(0, tex_drho, d_drho,
-                sizeof(Scalar4) * eam_data.nrho * eam_data.ntypes * eam_data.ntypes);
+                sizeof(Scalar4) * eam_data.nr * eam_data.ntypes * eam_data.ntypes);
         if (error != cudaSuccess)
             return error;
 
@@ -359,82 +484,36 @@ cudaError_t gpu_compute_eam_tex_inter_forces(Scalar4 *d_force, Scalar *d_virial,
             return error;
         }
 
-    pdata_pos_tex.normalized = false;
-    pdata_pos_tex.filterMode = cudaFilterModePoint;
-    error = cudaBindTexture(0, pdata_pos_tex, d_pos, sizeof(Scalar4) * N);
-    if (error != cudaSuccess)
-        return error;
+    bool use_gmem_nlist = compute_capability < 350 && size_nlist > max_tex1d_width;
 
-    tex_dFdP.normalized = false;
-    tex_dFdP.filterMode = cudaFilterModePoint;
-    error = cudaBindTexture(0, tex_dFdP, d_dFdP, sizeof(Scalar) * N);
-    if (error != cudaSuccess)
-        return error;
-
-    // run the kernel
-    cudaMemcpyToSymbol(eam_data_ti, &eam_data, sizeof(EAMTexInterData));
-
-    if (compute_capability < 350 && size_nlist > max_tex1d_width)
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
         {
-
-        static unsigned int max_block_size_1 = UINT_MAX;
-        static unsigned int max_block_size_2 = UINT_MAX;
-
-        cudaFuncAttributes attr1;
-        cudaFuncGetAttributes(&attr1, gpu_kernel_1<1>);
-
-        cudaFuncAttributes attr2;
-        cudaFuncGetAttributes(&attr2, gpu_kernel_2<1>);
-
-        max_block_size_1 = attr1.maxThreadsPerBlock;
-        max_block_size_2 = attr2.maxThreadsPerBlock;
-
-        unsigned int run_block_size_1 = min(eam_data.block_size, max_block_size_1);
-        unsigned int run_block_size_2 = min(eam_data.block_size, max_block_size_2);
-
-        // setup the grid to run the kernel
-
-        dim3 grid_1((int) ceil((double) N / (double) run_block_size_1), 1, 1);
-        dim3 threads_1(run_block_size_1, 1, 1);
-
-        dim3 grid_2((int) ceil((double) N / (double) run_block_size_2), 1, 1);
-        dim3 threads_2(run_block_size_2, 1, 1);
-
-        gpu_kernel_1<1> <<<grid_1, threads_1>>>(d_force, d_virial, virial_pitch, N, d_pos, box, d_n_neigh, d_nlist,
-                d_head_list, d_F, d_rho, d_rphi, d_dF, d_drho, d_drphi, d_dFdP);
-        gpu_kernel_2<1> <<<grid_2, threads_2>>>(d_force, d_virial, virial_pitch, N, d_pos, box, d_n_neigh, d_nlist,
-                d_head_list, d_F, d_rho, d_rphi, d_dF, d_drho, d_drphi, d_dFdP);
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, gpu_kernel_2<0>);
+        max_block_size = attr.maxThreadsPerBlock;
+        cudaFuncGetAttributes(&attr, gpu_kernel_2<1>);
+        max_block_size = min(max_block_size, (unsigned int)attr.maxThreadsPerBlock);
         }
-    else
-        {
-
-        static unsigned int max_block_size_1 = UINT_MAX;
-        static unsigned int max_block_size_2 = UINT_MAX;
-
-        cudaFuncAttributes attr1;
-        cudaFuncGetAttributes(&attr1, gpu_kernel_1<0>);
-
-        cudaFuncAttributes attr2;
-        cudaFuncGetAttributes(&attr2, gpu_kernel_2<0>);
 
-        max_block_size_1 = attr1.maxThreadsPerBlock;
-        max_block_size_2 = attr2.maxThreadsPerBlock;
+    unsigned int run_block_size = min(eam_data.block_size, max_block_size);
 
-        unsigned int run_block_size_1 = min(eam_data.block_size, max_block_size_1);
-        unsigned int run_block_size_2 = min(eam_data.block_size, max_block_size_2);
+    // iterate over active GPUs in reverse, to end up on first GPU when returning from this function
+    for (int idev = gpu_partition.getNumActiveGPUs() - 1; idev >= 0; --idev)
+        {
+        auto range = gpu_partition.getRangeAndSetGPU(idev);
+        unsigned int nwork = range.second - range.first;
 
         // setup the grid to run the kernel
+        dim3 grid(nwork / run_block_size + 1, 1, 1);
+        dim3 threads(run_block_size, 1, 1);
 
-        dim3 grid_1((int) ceil((double) N / (double) run_block_size_1), 1, 1);
-        dim3 threads_1(run_block_size_1, 1, 1);
-
-        dim3 grid_2((int) ceil((double) N / (double) run_block_size_2), 1, 1);
-        dim3 threads_2(run_block_size_2, 1, 1);
-
-        gpu_kernel_1<0> <<<grid_1, threads_1>>>(d_force, d_virial, virial_pitch, N, d_pos, box, d_n_neigh, d_nlist,
-                d_head_list, d_F, d_rho, d_rphi, d_dF, d_drho, d_drphi, d_dFdP);
-        gpu_kernel_2<0> <<<grid_2, threads_2>>>(d_force, d_virial, virial_pitch, N, d_pos, box, d_n_neigh, d_nlist,
-                d_head_list, d_F, d_rho, d_rphi, d_dF, d_drho, d_drphi, d_dFdP);
+        if (use_gmem_nlist)
+            gpu_kernel_2<1> <<<grid, threads>>>(d_force, d_virial, virial_pitch, nwork, d_pos, box, d_n_neigh,
+                d_nlist, d_head_list, eam_data, d_F, d_rphi, d_drho, d_drphi, d_dFdP, range.first);
+        else
+            gpu_kernel_2<0> <<<grid, threads>>>(d_force, d_virial, virial_pitch, nwork, d_pos, box, d_n_neigh,
+                d_nlist, d_head_list, eam_data, d_F, d_rphi, d_drho, d_drphi, d_dFdP, range.first);
         }
 
     return cudaSuccess;
@@ -7,6 +7,7 @@
 #include "hoomd/ParticleData.cuh"
 #include "hoomd/Index1D.h"
 #include "hoomd/HOOMDMath.h"
+#include "hoomd/GPUPartition.cuh"
 
 /*! \file EAMForceGPU.cuh
  \brief Declares GPU kernel code for calculating the eam forces. Used by EAMForceComputeGPU.
@@ -30,12 +31,19 @@ struct EAMTexInterData
     Scalar r_cutsq;         //!< r_cut^2
     };
 
-//! Kernel driver that computes EAM forces on the GPU for EAMForceComputeGPU
+//! Kernel driver that computes the electron density and embedding function derivative (first EAM pass)
+cudaError_t gpu_compute_eam_tex_inter_density(const unsigned int N, const Scalar4 *d_pos, const BoxDim& box,
+        const unsigned int *d_n_neigh, const unsigned int *d_nlist, const unsigned int *d_head_list,
+        const unsigned int size_nlist, const EAMTexInterData& eam_data, Scalar2 *d_dFdP, const Scalar4 *d_rho,
+        const Scalar4 *d_dF, const unsigned int compute_capability, const unsigned int max_tex1d_width,
+        const GPUPartition& gpu_partition);
+
+//! Kernel driver that computes EAM forces on the GPU for EAMForceComputeGPU (second EAM pass)
 cudaError_t gpu_compute_eam_tex_inter_forces(Scalar4* d_force, Scalar* d_virial, const unsigned int virial_pitch,
         const unsigned int N, const Scalar4 *d_pos, const BoxDim& box, const unsigned int *d_n_neigh,
         const unsigned int *d_nlist, const unsigned int *d_head_list, const unsigned int size_nlist,
-        const EAMTexInterData& eam_data, Scalar *d_dFdP, const Scalar4 *d_F, const Scalar4 *d_rho,
-        const Scalar4 *d_rphi, const Scalar4 *d_dF, const Scalar4 *d_drho, const Scalar4 *d_drphi,
-        const unsigned int compute_capability, const unsigned int max_tex1d_width);
+        const EAMTexInterData& eam_data, const Scalar2 *d_dFdP, const Scalar4 *d_F, const Scalar4 *d_rphi,
+        const Scalar4 *d_drho, const Scalar4 *d_drphi, const unsigned int compute_capability,
+        const unsigned int max_tex1d_width, const GPUPartition& gpu_partition);
 
 #endif
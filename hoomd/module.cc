@@ -9,13 +9,17 @@
 #include "ClockSource.h"
 #include "Profiler.h"
 #include "ParticleData.h"
+#include "LocalParticleData.h"
 #include "SystemDefinition.h"
 #include "BondedGroupData.h"
 #include "Initializers.h"
 #include "GetarInitializer.h"
 #include "GSDReader.h"
+#include "CheckpointReader.h"
 #include "Compute.h"
+#include "ComputeDynamics.h"
 #include "ComputeThermo.h"
+#include "ComputeThermoMulti.h"
 #include "CellList.h"
 #include "CellListStencil.h"
 #include "ForceCompute.h"
@@ -26,11 +30,14 @@
 #include "DCDDumpWriter.h"
 #include "GetarDumpWriter.h"
 #include "GSDDumpWriter.h"
+#include "CheckpointWriter.h"
 #include "Logger.h"
 #include "LogPlainTXT.h"
 #include "LogMatrix.h"
 #include "LogHDF5.h"
 #include "CallbackAnalyzer.h"
+#include "StreamAnalyzer.h"
+#include "MetricsExporter.h"
 #include "Updater.h"
 #include "Integrator.h"
 #include "SFCPackUpdater.h"
@@ -39,13 +46,17 @@
 #include "Variant.h"
 #include "Messenger.h"
 #include "SnapshotSystemData.h"
+#include "RandomSequentialAddition.h"
 
 // include GPU classes
 #ifdef ENABLE_CUDA
 #include <cuda.h>
 #include "CellListGPU.h"
+#include "ComputeDynamicsGPU.h"
 #include "ComputeThermoGPU.h"
+#include "ComputeThermoMultiGPU.h"
 #include "SFCPackUpdaterGPU.h"
+#include "RandomSequentialAdditionGPU.h"
 
 #include <cuda_profiler_api.h>
 #endif
@@ -55,6 +66,8 @@
 #include "Communicator.h"
 #include "DomainDecomposition.h"
 #include "LoadBalancer.h"
+#include "LoadImbalanceCompute.h"
+#include "ReplicaExchangeUpdater.h"
 
 #ifdef ENABLE_CUDA
 #include "CommunicatorGPU.h"
@@ -180,6 +193,16 @@ bool is_TBB_available()
 #endif
     }
 
+//! Determine availability of PAPI hardware counter support
+bool is_PAPI_available()
+   {
+   return
+#ifdef ENABLE_PAPI
+       true;
+#else
+       false;
+#endif
+    }
 
 // values used in measuring hoomd launch timing
 unsigned int hoomd_launch_time, hoomd_start_time, hoomd_mpi_init_time;
@@ -252,6 +275,8 @@ void abort_mpi(std::shared_ptr<ExecutionConfiguration> exec_conf)
     #ifdef ENABLE_MPI
     if(exec_conf->getNRanksGlobal() > 1)
         {
+        // write out buffered messages before the processes are killed
+        exec_conf->msg->flush();
         MPI_Abort(exec_conf->getMPICommunicator(), MPI_ERR_OTHER);
         }
     #endif
@@ -309,6 +334,7 @@ PYBIND11_MODULE(_hoomd, m)
 
     m.def("is_MPI_available", &is_MPI_available);
     m.def("is_TBB_available", &is_TBB_available);
+    m.def("is_PAPI_available", &is_PAPI_available);
 
     pybind11::bind_vector< std::vector<Scalar> >(m,"std_vector_scalar");
     pybind11::bind_vector< std::vector<string> >(m,"std_vector_string");
@@ -328,6 +354,7 @@ PYBIND11_MODULE(_hoomd, m)
     export_BoxDim(m);
     export_ParticleData(m);
     export_SnapshotParticleData(m);
+    export_LocalParticleData(m);
     export_ExecutionConfiguration(m);
     export_SystemDefinition(m);
     export_SnapshotSystemData(m);
@@ -340,11 +367,18 @@ PYBIND11_MODULE(_hoomd, m)
 
     // initializers
     export_GSDReader(m);
+    export_CheckpointReader(m);
     getardump::export_GetarInitializer(m);
+    export_RandomSequentialAddition(m);
+#ifdef ENABLE_CUDA
+    export_RandomSequentialAdditionGPU(m);
+#endif
 
     // computes
     export_Compute(m);
     export_ComputeThermo(m);
+    export_ComputeThermoMulti(m);
+    export_ComputeDynamics(m);
     export_CellList(m);
     export_CellListStencil(m);
     export_ForceCompute(m);
@@ -354,6 +388,8 @@ PYBIND11_MODULE(_hoomd, m)
 #ifdef ENABLE_CUDA
     export_CellListGPU(m);
     export_ComputeThermoGPU(m);
+    export_ComputeThermoMultiGPU(m);
+    export_ComputeDynamicsGPU(m);
 #endif
 
     // analyzers
@@ -362,11 +398,14 @@ PYBIND11_MODULE(_hoomd, m)
     export_DCDDumpWriter(m);
     getardump::export_GetarDumpWriter(m);
     export_GSDDumpWriter(m);
+    export_CheckpointWriter(m);
     export_Logger(m);
     export_LogPlainTXT(m);
     export_LogMatrix(m);
     export_LogHDF5(m);
     export_CallbackAnalyzer(m);
+    export_StreamAnalyzer(m);
+    export_MetricsExporter(m);
     export_ParticleGroup(m);
 
     // updaters
@@ -382,6 +421,8 @@ PYBIND11_MODULE(_hoomd, m)
     export_Communicator(m);
     export_DomainDecomposition(m);
     export_LoadBalancer(m);
+    export_LoadImbalanceCompute(m);
+    export_ReplicaExchangeUpdater(m);
 #ifdef ENABLE_CUDA
     export_CommunicatorGPU(m);
     export_LoadBalancerGPU(m);
@@ -9,8 +9,7 @@
  */
 
 #include "ATCollisionMethod.h"
-#include "RandomNumbers.h"
-#include "hoomd/Saru.h"
+#include "ATCollisionMethodUtilities.h"
 
 mpcd::ATCollisionMethod::ATCollisionMethod(std::shared_ptr<mpcd::SystemData> sysdata,
                                            unsigned int cur_timestep,
@@ -18,22 +17,24 @@ mpcd::ATCollisionMethod::ATCollisionMethod(std::shared_ptr<mpcd::SystemData> sys
                                            int phase,
                                            unsigned int seed,
                                            std::shared_ptr<mpcd::CellThermoCompute> thermo,
-                                           std::shared_ptr<mpcd::CellThermoCompute> rand_thermo,
                                            std::shared_ptr<::Variant> T)
     : mpcd::CollisionMethod(sysdata,cur_timestep,period,phase,seed),
-      m_thermo(thermo), m_rand_thermo(rand_thermo), m_T(T)
+      m_thermo(thermo), m_T(T), m_rand_vel(m_exec_conf)
     {
     m_exec_conf->msg->notice(5) << "Constructing MPCD AT collision method" << std::endl;
 
-    m_thermo->getCallbackSignal().connect<mpcd::ATCollisionMethod, &mpcd::ATCollisionMethod::drawVelocities>(this);
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->getNRanks() > 1)
+        {
+        m_rand_comm = std::make_shared<mpcd::CellCommunicator>(m_sysdef, m_cl);
+        }
+    #endif // ENABLE_MPI
     }
 
 
 mpcd::ATCollisionMethod::~ATCollisionMethod()
     {
     m_exec_conf->msg->notice(5) << "Destroying MPCD AT collision method" << std::endl;
-
-    m_thermo->getCallbackSignal().disconnect<mpcd::ATCollisionMethod, &mpcd::ATCollisionMethod::drawVelocities>(this);
     }
 
 void mpcd::ATCollisionMethod::collide(unsigned int timestep)
@@ -51,24 +52,63 @@ void mpcd::ATCollisionMethod::collide(unsigned int timestep)
 
     if (m_prof) m_prof->push("MPCD collide");
     // compute the cell average of the random velocities
-    m_pdata->swapVelocities(); m_mpcd_pdata->swapVelocities();
-    m_rand_thermo->compute(timestep);
-    m_pdata->swapVelocities(); m_mpcd_pdata->swapVelocities();
+    if (m_prof) m_prof->push(m_exec_conf, "draw");
+    computeRandomVelocities(timestep);
+    if (m_prof) m_prof->pop(m_exec_conf);
 
     if (m_prof) m_prof->push(m_exec_conf, "apply");
     // apply random velocities
-    applyVelocities();
+    applyVelocities(timestep);
     if (m_prof) m_prof->pop(m_exec_conf);
     if (m_prof) m_prof->pop();
     }
 
-void mpcd::ATCollisionMethod::drawVelocities(unsigned int timestep)
+/*!
+ * \param timestep Current timestep
+ *
+ * The random velocities are summed per cell from the cell list, reduced across
+ * ranks, and normalized into the average random velocity of each cell.
+ */
+void mpcd::ATCollisionMethod::computeRandomVelocities(unsigned int timestep)
     {
+    const unsigned int ncells = m_cl->getNCells();
+    if (m_rand_vel.getNumElements() < ncells)
+        {
+        m_rand_vel.resize(ncells);
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_rand_comm)
+        {
+        sumRandomVelocities(timestep, false);
+        m_rand_comm->communicate(m_rand_vel, mpcd::detail::CellVelocityPackOp());
+        normalizeRandomVelocities();
+        }
+    else
+    #endif // ENABLE_MPI
+        {
+        sumRandomVelocities(timestep, true);
+        }
+    }
+
+/*!
+ * \param timestep Current timestep
+ * \param normalize If true, store the average velocity of each cell instead of its momentum
+ *
+ * The random velocity of each particle is drawn while its cell is summed and discarded.
+ */
+void mpcd::ATCollisionMethod::sumRandomVelocities(unsigned int timestep, bool normalize)
+    {
+    // cell list
+    ArrayHandle<unsigned int> h_cell_list(m_cl->getCellList(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_cell_np(m_cl->getCellSizeArray(), access_location::host, access_mode::read);
+    const Index2D& cli = m_cl->getCellListIndexer();
+    const unsigned int ncells = m_cl->getNCells();
+
     // mpcd particle data
     ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
+    const Scalar mpcd_mass = m_mpcd_pdata->getMass();
     const unsigned int N_mpcd = m_mpcd_pdata->getN();
-    unsigned int N_tot = N_mpcd;
 
     // embedded particle data
     std::unique_ptr< ArrayHandle<unsigned int> > h_embed_idx;
@@ -77,91 +117,122 @@ void mpcd::ATCollisionMethod::drawVelocities(unsigned int timestep)
     if (m_embed_group)
         {
         h_embed_idx.reset(new ArrayHandle<unsigned int>(m_embed_group->getIndexArray(), access_location::host, access_mode::read));
-        h_vel_embed.reset(new ArrayHandle<Scalar4>(m_pdata->getAltVelocities(), access_location::host, access_mode::overwrite));
+        h_vel_embed.reset(new ArrayHandle<Scalar4>(m_pdata->getVelocities(), access_location::host, access_mode::read));
         h_tag_embed.reset(new ArrayHandle<unsigned int>(m_pdata->getTags(), access_location::host, access_mode::read));
-        N_tot += m_embed_group->getNumMembers();
         }
 
-    // random velocities are drawn for each particle and stored into the "alternate" arrays
+    ArrayHandle<double4> h_rand_vel(m_rand_vel, access_location::host, access_mode::overwrite);
+
     const Scalar T = m_T->getValue(timestep);
-    for (unsigned int idx=0; idx < N_tot; ++idx)
+    for (unsigned int cell=0; cell < ncells; ++cell)
         {
-        unsigned int pidx;
-        unsigned int tag; Scalar mass;
-        if (idx < N_mpcd)
-            {
-            pidx = idx;
-            mass = m_mpcd_pdata->getMass();
-            tag = h_tag.data[idx];
-            }
-        else
+        double4 momentum = make_double4(0.0, 0.0, 0.0, 0.0);
+        const unsigned int np = h_cell_np.data[cell];
+        for (unsigned int offset=0; offset < np; ++offset)
             {
-            pidx = h_embed_idx->data[idx-N_mpcd];
-            const Scalar4 vel_mass = h_vel_embed->data[pidx];
-            mass = vel_mass.w;
-            tag = h_tag_embed->data[pidx];
-            }
+            const unsigned int cur_p = h_cell_list.data[cli(offset, cell)];
+            unsigned int tag; Scalar mass;
+            if (cur_p < N_mpcd)
+                {
+                tag = h_tag.data[cur_p];
+                mass = mpcd_mass;
+                }
+            else
+                {
+                const unsigned int pidx = h_embed_idx->data[cur_p-N_mpcd];
+                tag = h_tag_embed->data[pidx];
+                mass = h_vel_embed->data[pidx].w;
+                }
 
-        // draw random velocities from normal distribution
-        hoomd::detail::Saru rng(tag, timestep, m_seed);
-        mpcd::detail::NormalGenerator<Scalar,true> gen;
-        const Scalar3 vel = fast::sqrt(T/mass) * make_scalar3(gen(rng), gen(rng), gen(rng));
+            const Scalar3 vel = mpcd::detail::draw_at_velocity(tag, timestep, m_seed, T, mass);
+            momentum.x += mass * vel.x;
+            momentum.y += mass * vel.y;
+            momentum.z += mass * vel.z;
+            momentum.w += mass;
+            }
 
-        // save out velocities
-        if (idx < N_mpcd)
+        if (normalize && momentum.w > 0.)
             {
-            h_vel.data[pidx] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
+            momentum.x /= momentum.w;
+            momentum.y /= momentum.w;
+            momentum.z /= momentum.w;
             }
-        else
+        h_rand_vel.data[cell] = momentum;
+        }
+    }
+
+void mpcd::ATCollisionMethod::normalizeRandomVelocities()
+    {
+    ArrayHandle<double4> h_rand_vel(m_rand_vel, access_location::host, access_mode::readwrite);
+    const unsigned int ncells = m_cl->getNCells();
+    for (unsigned int cell=0; cell < ncells; ++cell)
+        {
+        double4 momentum = h_rand_vel.data[cell];
+        if (momentum.w > 0.)
             {
-            h_vel_embed->data[pidx] = make_scalar4(vel.x, vel.y, vel.z, mass);
+            momentum.x /= momentum.w;
+            momentum.y /= momentum.w;
+            momentum.z /= momentum.w;
             }
+        h_rand_vel.data[cell] = momentum;
         }
     }
 
-void mpcd::ATCollisionMethod::applyVelocities()
+/*!
+ * \param timestep Current timestep
+ *
+ * The random velocity of each particle is drawn again, identically to sumRandomVelocities().
+ */
+void mpcd::ATCollisionMethod::applyVelocities(unsigned int timestep)
     {
     // mpcd particle data
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::detail::vel_t> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::read);
+    const Scalar mpcd_mass = m_mpcd_pdata->getMass();
     const unsigned int N_mpcd = m_mpcd_pdata->getN();
     unsigned int N_tot = N_mpcd;
 
     // embedded particle data
     std::unique_ptr< ArrayHandle<unsigned int> > h_embed_idx;
     std::unique_ptr< ArrayHandle<Scalar4> > h_vel_embed;
-    std::unique_ptr< ArrayHandle<Scalar4> > h_vel_alt_embed;
+    std::unique_ptr< ArrayHandle<unsigned int> > h_tag_embed;
     std::unique_ptr< ArrayHandle<unsigned int> > h_embed_cell_ids;
     if (m_embed_group)
         {
         h_embed_idx.reset(new ArrayHandle<unsigned int>(m_embed_group->getIndexArray(), access_location::host, access_mode::read));
         h_vel_embed.reset(new ArrayHandle<Scalar4>(m_pdata->getVelocities(), access_location::host, access_mode::readwrite));
-        h_vel_alt_embed.reset(new ArrayHandle<Scalar4>(m_pdata->getAltVelocities(), access_location::host, access_mode::read));
+        h_tag_embed.reset(new ArrayHandle<unsigned int>(m_pdata->getTags(), access_location::host, access_mode::read));
         h_embed_cell_ids.reset(new ArrayHandle<unsigned int>(m_cl->getEmbeddedGroupCellIds(), access_location::host, access_mode::read));
         N_tot += m_embed_group->getNumMembers();
         }
 
     ArrayHandle<double4> h_cell_vel(m_thermo->getCellVelocities(), access_location::host, access_mode::read);
-    ArrayHandle<double4> h_rand_vel(m_rand_thermo->getCellVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<double4> h_rand_vel(m_rand_vel, access_location::host, access_mode::read);
 
+    const Scalar T = m_T->getValue(timestep);
     for (unsigned int idx=0; idx < N_tot; ++idx)
         {
-        unsigned int cell, pidx;
-        Scalar4 vel_rand;
+        unsigned int cell, pidx, tag;
+        Scalar mass;
         if (idx < N_mpcd)
             {
             pidx = idx;
-            const Scalar4 vel_cell = h_vel.data[idx];
-            cell = __scalar_as_int(vel_cell.w);
-            vel_rand = h_vel_alt.data[idx];
+            const mpcd::detail::vel_t vel_cell = h_vel.data[idx];
+            cell = mpcd::detail::get_cell(vel_cell);
+            tag = h_tag.data[idx];
+            mass = mpcd_mass;
             }
         else
             {
             pidx = h_embed_idx->data[idx-N_mpcd];
             cell = h_embed_cell_ids->data[idx-N_mpcd];
-            vel_rand = h_vel_alt_embed->data[pidx];
+            tag = h_tag_embed->data[pidx];
+            mass = h_vel_embed->data[pidx].w;
             }
 
+        // draw the random velocity again
+        const Scalar3 vel_rand = mpcd::detail::draw_at_velocity(tag, timestep, m_seed, T, mass);
+
         // load cell data
         const double4 v_c = h_cell_vel.data[cell];
         const double4 vrand_c = h_rand_vel.data[cell];
@@ -173,11 +244,11 @@ void mpcd::ATCollisionMethod::applyVelocities()
 
         if (idx < N_mpcd)
             {
-            h_vel.data[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, __int_as_scalar(cell));
+            h_vel.data[pidx] = mpcd::detail::make_velocity(make_scalar3(vnew.x, vnew.y, vnew.z), cell);
             }
         else
             {
-            h_vel_embed->data[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, vel_rand.w);
+            h_vel_embed->data[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, mass);
             }
         }
     }
@@ -196,7 +267,6 @@ void mpcd::detail::export_ATCollisionMethod(pybind11::module& m)
                       int,
                       unsigned int,
                       std::shared_ptr<mpcd::CellThermoCompute>,
-                      std::shared_ptr<mpcd::CellThermoCompute>,
                       std::shared_ptr<::Variant>>())
         .def("setTemperature", &mpcd::ATCollisionMethod::setTemperature)
     ;
@@ -17,12 +17,22 @@
 
 #include "CollisionMethod.h"
 #include "CellThermoCompute.h"
+#ifdef ENABLE_MPI
+#include "CellCommunicator.h"
+#endif // ENABLE_MPI
 
 #include "hoomd/Variant.h"
 
 namespace mpcd
 {
 
+//! Andersen thermostat collision method
+/*!
+ * The random velocity of each particle is drawn from a counter-based random number
+ * generator keyed by the particle tag, so it is never stored. The cell averages of the
+ * random velocities are summed in one pass over the cell list, and the velocities are
+ * drawn again when the collision is applied in a second pass over the particles.
+ */
 class PYBIND11_EXPORT ATCollisionMethod : public mpcd::CollisionMethod
     {
     public:
@@ -33,7 +43,6 @@ class PYBIND11_EXPORT ATCollisionMethod : public mpcd::CollisionMethod
                           int phase,
                           unsigned int seed,
                           std::shared_ptr<mpcd::CellThermoCompute> thermo,
-                          std::shared_ptr<mpcd::CellThermoCompute> rand_thermo,
                           std::shared_ptr<::Variant> T);
 
         //! Destructor
@@ -42,6 +51,25 @@ class PYBIND11_EXPORT ATCollisionMethod : public mpcd::CollisionMethod
         //! Implementation of the collision rule
         virtual void collide(unsigned int timestep);
 
+        //! Discard the cell properties started by beginCollide()
+        virtual void cancelCollide()
+            {
+            m_thermo->cancelCompute();
+            }
+
+        //! Set autotuner parameters
+        /*!
+         * \param enable Enable/disable autotuning
+         * \param period period (approximate) in time steps when returning occurs
+         */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            #ifdef ENABLE_MPI
+            if (m_rand_comm)
+                m_rand_comm->setAutotunerParams(enable, period);
+            #endif // ENABLE_MPI
+            }
+
         //! Set the temperature and enable the thermostat
         void setTemperature(std::shared_ptr<::Variant> T)
             {
@@ -49,15 +77,32 @@ class PYBIND11_EXPORT ATCollisionMethod : public mpcd::CollisionMethod
             }
 
     protected:
-        std::shared_ptr<mpcd::CellThermoCompute> m_thermo;      //!< Cell thermo
-        std::shared_ptr<mpcd::CellThermoCompute> m_rand_thermo; //!< Cell thermo for random velocities
+        //! Start the calculation of the cell properties used by the collision rule
+        virtual void beginCellProperties(unsigned int timestep)
+            {
+            m_thermo->beginCompute(timestep);
+            }
+
+        std::shared_ptr<mpcd::CellThermoCompute> m_thermo;  //!< Cell thermo
         std::shared_ptr<::Variant> m_T; //!< Temperature for thermostat
 
-        //! Draw velocities for particles in each cell
-        virtual void drawVelocities(unsigned int timestep);
+        GPUVector<double4> m_rand_vel;  //!< Average random velocity (x,y,z) and mass (w) of each cell
+        #ifdef ENABLE_MPI
+        std::shared_ptr<mpcd::CellCommunicator> m_rand_comm;   //!< Communicator for the random cell velocities
+        #endif // ENABLE_MPI
+
+        //! Sum the random velocities of the particles in each cell
+        virtual void sumRandomVelocities(unsigned int timestep, bool normalize);
+
+        //! Normalize the summed random cell velocities
+        virtual void normalizeRandomVelocities();
 
         //! Apply the random velocities to particles in each cell
-        virtual void applyVelocities();
+        virtual void applyVelocities(unsigned int timestep);
+
+    private:
+        //! Compute the average random velocity of each cell
+        void computeRandomVelocities(unsigned int timestep);
     };
 
 namespace detail
@@ -17,97 +17,145 @@ mpcd::ATCollisionMethodGPU::ATCollisionMethodGPU(std::shared_ptr<mpcd::SystemDat
                                                  int phase,
                                                  unsigned int seed,
                                                  std::shared_ptr<mpcd::CellThermoCompute> thermo,
-                                                 std::shared_ptr<mpcd::CellThermoCompute> rand_thermo,
                                                  std::shared_ptr<::Variant> T)
-    : mpcd::ATCollisionMethod(sysdata,cur_timestep,period,phase,seed,thermo,rand_thermo,T)
+    : mpcd::ATCollisionMethod(sysdata,cur_timestep,period,phase,seed,thermo,T)
     {
-    m_tuner_draw.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_at_draw", m_exec_conf));
+    // construct a range of valid tuner parameters using the block size and number of threads per cell
+    std::vector<unsigned int> valid_params;
+    for (unsigned int block_size = 32; block_size <= 1024; block_size += 32)
+        {
+        for (auto s : Autotuner::getTppListPow2(m_exec_conf->dev_prop.warpSize))
+            {
+            valid_params.push_back(block_size * 10000 + s);
+            }
+        }
+
+    m_tuner_draw.reset(new Autotuner(valid_params, 5, 100000, "mpcd_at_draw", m_exec_conf));
+    m_tuner_normalize.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_at_normalize", m_exec_conf));
     m_tuner_apply.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_at_apply", m_exec_conf));
     }
 
-void mpcd::ATCollisionMethodGPU::drawVelocities(unsigned int timestep)
+/*!
+ * \param timestep Current timestep
+ * \param normalize If true, store the average velocity of each cell instead of its momentum
+ */
+void mpcd::ATCollisionMethodGPU::sumRandomVelocities(unsigned int timestep, bool normalize)
     {
+    // cell list
+    ArrayHandle<unsigned int> d_cell_list(m_cl->getCellList(), access_location::device, access_mode::read);
+    ArrayHandle<unsigned int> d_cell_np(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
+
     // mpcd particle data
     ArrayHandle<unsigned int> d_tag(m_mpcd_pdata->getTags(), access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getAltVelocities(), access_location::device, access_mode::overwrite);
-    const unsigned int N_mpcd = m_mpcd_pdata->getN();
-    unsigned int N_tot = N_mpcd;
 
-    // random velocities are drawn for each particle and stored into the "alternate" arrays
+    ArrayHandle<double4> d_rand_vel(m_rand_vel, access_location::device, access_mode::overwrite);
+
     const Scalar T = m_T->getValue(timestep);
 
     if (m_embed_group)
         {
         ArrayHandle<unsigned int> d_embed_idx(m_embed_group->getIndexArray(), access_location::device, access_mode::read);
-        ArrayHandle<Scalar4> d_vel_embed(m_pdata->getAltVelocities(), access_location::device, access_mode::overwrite);
+        ArrayHandle<Scalar4> d_vel_embed(m_pdata->getVelocities(), access_location::device, access_mode::read);
         ArrayHandle<unsigned int> d_tag_embed(m_pdata->getTags(), access_location::device, access_mode::read);
-        N_tot += m_embed_group->getNumMembers();
 
         m_tuner_draw->begin();
-        mpcd::gpu::at_draw_velocity(d_vel.data,
-                                    d_vel_embed.data,
-                                    d_tag.data,
-                                    m_mpcd_pdata->getMass(),
-                                    d_embed_idx.data,
-                                    d_tag_embed.data,
-                                    timestep,
-                                    m_seed,
-                                    T,
-                                    N_mpcd,
-                                    N_tot,
-                                    m_tuner_draw->getParam());
+        const unsigned int param = m_tuner_draw->getParam();
+        mpcd::gpu::at_sum_velocity(d_rand_vel.data,
+                                   d_cell_np.data,
+                                   d_cell_list.data,
+                                   m_cl->getCellListIndexer(),
+                                   d_tag.data,
+                                   m_mpcd_pdata->getMass(),
+                                   d_embed_idx.data,
+                                   d_vel_embed.data,
+                                   d_tag_embed.data,
+                                   timestep,
+                                   m_seed,
+                                   T,
+                                   m_mpcd_pdata->getN(),
+                                   m_cl->getNCells(),
+                                   normalize,
+                                   param / 10000,
+                                   param % 10000);
         if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
         m_tuner_draw->end();
         }
     else
         {
         m_tuner_draw->begin();
-        mpcd::gpu::at_draw_velocity(d_vel.data,
-                                    NULL,
-                                    d_tag.data,
-                                    m_mpcd_pdata->getMass(),
-                                    NULL,
-                                    NULL,
-                                    timestep,
-                                    m_seed,
-                                    T,
-                                    N_mpcd,
-                                    N_tot,
-                                    m_tuner_draw->getParam());
+        const unsigned int param = m_tuner_draw->getParam();
+        mpcd::gpu::at_sum_velocity(d_rand_vel.data,
+                                   d_cell_np.data,
+                                   d_cell_list.data,
+                                   m_cl->getCellListIndexer(),
+                                   d_tag.data,
+                                   m_mpcd_pdata->getMass(),
+                                   NULL,
+                                   NULL,
+                                   NULL,
+                                   timestep,
+                                   m_seed,
+                                   T,
+                                   m_mpcd_pdata->getN(),
+                                   m_cl->getNCells(),
+                                   normalize,
+                                   param / 10000,
+                                   param % 10000);
         if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
         m_tuner_draw->end();
         }
     }
 
-void mpcd::ATCollisionMethodGPU::applyVelocities()
+void mpcd::ATCollisionMethodGPU::normalizeRandomVelocities()
+    {
+    ArrayHandle<double4> d_rand_vel(m_rand_vel, access_location::device, access_mode::readwrite);
+
+    m_tuner_normalize->begin();
+    mpcd::gpu::at_normalize_velocity(d_rand_vel.data,
+                                     m_cl->getNCells(),
+                                     m_tuner_normalize->getParam());
+    if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    m_tuner_normalize->end();
+    }
+
+/*!
+ * \param timestep Current timestep
+ */
+void mpcd::ATCollisionMethodGPU::applyVelocities(unsigned int timestep)
     {
     // mpcd particle data
-    ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
-    ArrayHandle<Scalar4> d_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::device, access_mode::read);
+    ArrayHandle<mpcd::detail::vel_t> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+    ArrayHandle<unsigned int> d_tag(m_mpcd_pdata->getTags(), access_location::device, access_mode::read);
     const unsigned int N_mpcd = m_mpcd_pdata->getN();
     unsigned int N_tot = N_mpcd;
 
     // cell data
     ArrayHandle<double4> d_cell_vel(m_thermo->getCellVelocities(), access_location::device, access_mode::read);
-    ArrayHandle<double4> d_rand_vel(m_rand_thermo->getCellVelocities(), access_location::device, access_mode::read);
+    ArrayHandle<double4> d_rand_vel(m_rand_vel, access_location::device, access_mode::read);
+
+    const Scalar T = m_T->getValue(timestep);
 
     if (m_embed_group)
         {
         ArrayHandle<unsigned int> d_embed_idx(m_embed_group->getIndexArray(), access_location::device, access_mode::read);
         ArrayHandle<Scalar4> d_vel_embed(m_pdata->getVelocities(), access_location::device, access_mode::readwrite);
-        ArrayHandle<Scalar4> d_vel_alt_embed(m_pdata->getAltVelocities(), access_location::device, access_mode::read);
+        ArrayHandle<unsigned int> d_tag_embed(m_pdata->getTags(), access_location::device, access_mode::read);
         ArrayHandle<unsigned int> d_embed_cell_ids(m_cl->getEmbeddedGroupCellIds(), access_location::device, access_mode::read);
         N_tot += m_embed_group->getNumMembers();
 
         m_tuner_apply->begin();
         mpcd::gpu::at_apply_velocity(d_vel.data,
                                      d_vel_embed.data,
-                                     d_vel_alt.data,
+                                     d_tag.data,
+                                     m_mpcd_pdata->getMass(),
                                      d_embed_idx.data,
-                                     d_vel_alt_embed.data,
+                                     d_tag_embed.data,
                                      d_embed_cell_ids.data,
                                      d_cell_vel.data,
                                      d_rand_vel.data,
+                                     timestep,
+                                     m_seed,
+                                     T,
                                      N_mpcd,
                                      N_tot,
                                      m_tuner_apply->getParam());
@@ -119,12 +167,16 @@ void mpcd::ATCollisionMethodGPU::applyVelocities()
         m_tuner_apply->begin();
         mpcd::gpu::at_apply_velocity(d_vel.data,
                                      NULL,
-                                     d_vel_alt.data,
+                                     d_tag.data,
+                                     m_mpcd_pdata->getMass(),
                                      NULL,
                                      NULL,
                                      NULL,
                                      d_cell_vel.data,
                                      d_rand_vel.data,
+                                     timestep,
+                                     m_seed,
+                                     T,
                                      N_mpcd,
                                      N_tot,
                                      m_tuner_apply->getParam());
@@ -147,7 +199,6 @@ void mpcd::detail::export_ATCollisionMethodGPU(pybind11::module& m)
                       int,
                       unsigned int,
                       std::shared_ptr<mpcd::CellThermoCompute>,
-                      std::shared_ptr<mpcd::CellThermoCompute>,
                       std::shared_ptr<::Variant>>())
     ;
     }
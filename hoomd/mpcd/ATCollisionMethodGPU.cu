@@ -9,9 +9,10 @@
  */
 
 #include "ATCollisionMethodGPU.cuh"
+#include "ATCollisionMethodUtilities.h"
 #include "ParticleDataUtilities.h"
-#include "RandomNumbers.h"
-#include "hoomd/Saru.h"
+
+#include "hoomd/WarpTools.cuh"
 
 namespace mpcd
 {
@@ -19,63 +20,141 @@ namespace gpu
 {
 namespace kernel
 {
-__global__ void at_draw_velocity(Scalar4 *d_vel,
-                                 Scalar4 *d_vel_embed,
-                                 const unsigned int *d_tag,
-                                 const Scalar mpcd_mass,
-                                 const unsigned int *d_embed_idx,
-                                 const unsigned int *d_tag_embed,
-                                 const unsigned int timestep,
-                                 const unsigned int seed,
-                                 const Scalar T,
-                                 const unsigned int N_mpcd,
-                                 const unsigned int N_tot)
+//! Sums the random velocities of the particles in each cell
+/*!
+ * \param d_rand_vel Random momentum or velocity (x,y,z) and mass (w) per cell (output)
+ * \param d_cell_np Number of particles per cell
+ * \param d_cell_list MPCD cell list
+ * \param cli Indexer into the cell list
+ * \param d_tag MPCD particle tags
+ * \param mpcd_mass Mass of MPCD particle
+ * \param d_embed_idx Embedded particle indexes
+ * \param d_vel_embed Embedded particle velocities (and masses)
+ * \param d_tag_embed Embedded particle tags
+ * \param timestep Current timestep
+ * \param seed Seed of the collision method
+ * \param T Temperature
+ * \param N_mpcd Number of MPCD particles
+ * \param num_cells Number of cells
+ * \param normalize If true, write the average velocity instead of the momentum
+ *
+ * \tparam tpp Number of threads to use per cell
+ *
+ * \b Implementation details:
+ * Using \a tpp threads per cell, the random velocity of each particle in the cell is drawn
+ * and its momentum is accumulated. The velocities are not stored, they are drawn again by
+ * mpcd::gpu::kernel::at_apply_velocity. Shuffle-based intrinsics are used to reduce the
+ * momentum per-cell, and the first thread for each cell writes the result into global memory.
+ */
+template<unsigned int tpp>
+__global__ void at_sum_velocity(double4 *d_rand_vel,
+                                const unsigned int *d_cell_np,
+                                const unsigned int *d_cell_list,
+                                const Index2D cli,
+                                const unsigned int *d_tag,
+                                const Scalar mpcd_mass,
+                                const unsigned int *d_embed_idx,
+                                const Scalar4 *d_vel_embed,
+                                const unsigned int *d_tag_embed,
+                                const unsigned int timestep,
+                                const unsigned int seed,
+                                const Scalar T,
+                                const unsigned int N_mpcd,
+                                const unsigned int num_cells,
+                                const bool normalize)
     {
-    // one thread per particle
+    // tpp threads per cell
     unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
-    if (idx >= N_tot)
+    if (idx >= tpp * num_cells)
         return;
 
-    unsigned int pidx;
-    unsigned int tag; Scalar mass;
-    if (idx < N_mpcd)
+    const unsigned int cell_id = idx / tpp;
+    const unsigned int np = d_cell_np[cell_id];
+    double4 momentum = make_double4(0.0, 0.0, 0.0, 0.0);
+
+    for (unsigned int offset = (idx % tpp); offset < np; offset += tpp)
         {
-        pidx = idx;
-        mass = mpcd_mass;
-        tag = d_tag[idx];
+        const unsigned int cur_p = d_cell_list[cli(offset, cell_id)];
+        unsigned int tag; Scalar mass;
+        if (cur_p < N_mpcd)
+            {
+            tag = d_tag[cur_p];
+            mass = mpcd_mass;
+            }
+        else
+            {
+            const unsigned int pidx = d_embed_idx[cur_p-N_mpcd];
+            tag = d_tag_embed[pidx];
+            mass = d_vel_embed[pidx].w;
+            }
+
+        const Scalar3 vel = mpcd::detail::draw_at_velocity(tag, timestep, seed, T, mass);
+        momentum.x += mass * vel.x;
+        momentum.y += mass * vel.y;
+        momentum.z += mass * vel.z;
+        momentum.w += mass;
         }
-    else
+
+    // reduce quantities down into the 0-th lane per logical warp
+    if (tpp > 1)
         {
-        pidx = d_embed_idx[idx-N_mpcd];
-        const Scalar4 vel_mass = d_vel_embed[pidx];
-        mass = vel_mass.w;
-        tag = d_tag_embed[pidx];
+        hoomd::detail::WarpReduce<double, tpp> reducer;
+        momentum.x = reducer.Sum(momentum.x);
+        momentum.y = reducer.Sum(momentum.y);
+        momentum.z = reducer.Sum(momentum.z);
+        momentum.w = reducer.Sum(momentum.w);
         }
 
-    // draw random velocities from normal distribution
-    hoomd::detail::Saru rng(tag, timestep, seed);
-    mpcd::detail::NormalGenerator<Scalar,true> gen;
-    const Scalar3 vel = fast::sqrt(T/mass) * make_scalar3(gen(rng), gen(rng), gen(rng));
-
-    // save out velocities
-    if (idx < N_mpcd)
+    // 0-th lane in each warp writes the result
+    if (idx % tpp == 0)
         {
-        d_vel[pidx] = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
+        if (normalize && momentum.w > 0.)
+            {
+            momentum.x /= momentum.w;
+            momentum.y /= momentum.w;
+            momentum.z /= momentum.w;
+            }
+        d_rand_vel[cell_id] = momentum;
         }
-    else
+    }
+
+//! Converts the summed random momentum of each cell into its average velocity
+/*!
+ * \param d_rand_vel Random momentum (x,y,z) and mass (w) per cell, overwritten by the velocity
+ * \param num_cells Number of cells
+ *
+ * One thread is used per cell.
+ */
+__global__ void at_normalize_velocity(double4 *d_rand_vel,
+                                      const unsigned int num_cells)
+    {
+    // one thread per cell
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= num_cells)
+        return;
+
+    double4 momentum = d_rand_vel[idx];
+    if (momentum.w > 0.)
         {
-        d_vel_embed[pidx] = make_scalar4(vel.x, vel.y, vel.z, mass);
+        momentum.x /= momentum.w;
+        momentum.y /= momentum.w;
+        momentum.z /= momentum.w;
         }
+    d_rand_vel[idx] = momentum;
     }
 
-__global__ void at_apply_velocity(Scalar4 *d_vel,
+__global__ void at_apply_velocity(mpcd::detail::vel_t *d_vel,
                                   Scalar4 *d_vel_embed,
-                                  const Scalar4 *d_vel_alt,
+                                  const unsigned int *d_tag,
+                                  const Scalar mpcd_mass,
                                   const unsigned int *d_embed_idx,
-                                  const Scalar4 *d_vel_alt_embed,
+                                  const unsigned int *d_tag_embed,
                                   const unsigned int *d_embed_cell_ids,
                                   const double4 *d_cell_vel,
                                   const double4 *d_rand_vel,
+                                  const unsigned int timestep,
+                                  const unsigned int seed,
+                                  const Scalar T,
                                   const unsigned int N_mpcd,
                                   const unsigned int N_tot)
     {
@@ -84,22 +163,27 @@ __global__ void at_apply_velocity(Scalar4 *d_vel,
     if (idx >= N_tot)
         return;
 
-    unsigned int cell, pidx;
-    Scalar4 vel_rand;
+    unsigned int cell, pidx, tag;
+    Scalar mass;
     if (idx < N_mpcd)
         {
         pidx = idx;
-        const Scalar4 vel_cell = d_vel[idx];
-        cell = __scalar_as_int(vel_cell.w);
-        vel_rand = d_vel_alt[idx];
+        const mpcd::detail::vel_t vel_cell = d_vel[idx];
+        cell = mpcd::detail::get_cell(vel_cell);
+        tag = d_tag[idx];
+        mass = mpcd_mass;
         }
     else
         {
         pidx = d_embed_idx[idx-N_mpcd];
         cell = d_embed_cell_ids[idx-N_mpcd];
-        vel_rand = d_vel_alt_embed[pidx];
+        tag = d_tag_embed[pidx];
+        mass = d_vel_embed[pidx].w;
         }
 
+    // draw the random velocity again
+    const Scalar3 vel_rand = mpcd::detail::draw_at_velocity(tag, timestep, seed, T, mass);
+
     // load cell data
     const double4 v_c = d_cell_vel[cell];
     const double4 vrand_c = d_rand_vel[cell];
@@ -111,63 +195,216 @@ __global__ void at_apply_velocity(Scalar4 *d_vel,
 
     if (idx < N_mpcd)
         {
-        d_vel[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, __int_as_scalar(cell));
+        d_vel[pidx] = mpcd::detail::make_velocity(make_scalar3(vnew.x, vnew.y, vnew.z), cell);
         }
     else
         {
-        d_vel_embed[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, vel_rand.w);
+        d_vel_embed[pidx] = make_scalar4(vnew.x, vnew.y, vnew.z, mass);
         }
     }
 
 } // end namespace kernel
 
-cudaError_t at_draw_velocity(Scalar4 *d_vel,
-                             Scalar4 *d_vel_embed,
-                             const unsigned int *d_tag,
-                             const Scalar mpcd_mass,
-                             const unsigned int *d_embed_idx,
-                             const unsigned int *d_tag_embed,
-                             const unsigned int timestep,
-                             const unsigned int seed,
-                             const Scalar T,
-                             const unsigned int N_mpcd,
-                             const unsigned int N_tot,
-                             const unsigned int block_size)
+//! Launcher for the random velocity sum
+/*!
+ * \tparam cur_tpp Number of threads-per-cell for this template instantiation
+ *
+ * Launchers are recursively instantiated at compile-time in order to match the
+ * correct number of threads at runtime, as in mpcd::gpu::launch_begin_cell_thermo.
+ */
+template<unsigned int cur_tpp>
+inline void launch_at_sum_velocity(double4 *d_rand_vel,
+                                   const unsigned int *d_cell_np,
+                                   const unsigned int *d_cell_list,
+                                   const Index2D& cli,
+                                   const unsigned int *d_tag,
+                                   const Scalar mpcd_mass,
+                                   const unsigned int *d_embed_idx,
+                                   const Scalar4 *d_vel_embed,
+                                   const unsigned int *d_tag_embed,
+                                   const unsigned int timestep,
+                                   const unsigned int seed,
+                                   const Scalar T,
+                                   const unsigned int N_mpcd,
+                                   const unsigned int num_cells,
+                                   const bool normalize,
+                                   const unsigned int block_size,
+                                   const unsigned int tpp)
+    {
+    if (cur_tpp == tpp)
+        {
+        static unsigned int max_block_size = UINT_MAX;
+        if (max_block_size == UINT_MAX)
+            {
+            cudaFuncAttributes attr;
+            cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::at_sum_velocity<cur_tpp>);
+            max_block_size = attr.maxThreadsPerBlock;
+            }
+
+        unsigned int run_block_size = min(block_size, max_block_size);
+        dim3 grid(cur_tpp*num_cells / run_block_size + 1);
+        mpcd::gpu::kernel::at_sum_velocity<cur_tpp><<<grid, run_block_size>>>(d_rand_vel,
+                                                                              d_cell_np,
+                                                                              d_cell_list,
+                                                                              cli,
+                                                                              d_tag,
+                                                                              mpcd_mass,
+                                                                              d_embed_idx,
+                                                                              d_vel_embed,
+                                                                              d_tag_embed,
+                                                                              timestep,
+                                                                              seed,
+                                                                              T,
+                                                                              N_mpcd,
+                                                                              num_cells,
+                                                                              normalize);
+        }
+    else
+        {
+        launch_at_sum_velocity<cur_tpp/2>(d_rand_vel,
+                                          d_cell_np,
+                                          d_cell_list,
+                                          cli,
+                                          d_tag,
+                                          mpcd_mass,
+                                          d_embed_idx,
+                                          d_vel_embed,
+                                          d_tag_embed,
+                                          timestep,
+                                          seed,
+                                          T,
+                                          N_mpcd,
+                                          num_cells,
+                                          normalize,
+                                          block_size,
+                                          tpp);
+        }
+    }
+//! Template specialization to break recursion
+template<>
+inline void launch_at_sum_velocity<0>(double4 *d_rand_vel,
+                                      const unsigned int *d_cell_np,
+                                      const unsigned int *d_cell_list,
+                                      const Index2D& cli,
+                                      const unsigned int *d_tag,
+                                      const Scalar mpcd_mass,
+                                      const unsigned int *d_embed_idx,
+                                      const Scalar4 *d_vel_embed,
+                                      const unsigned int *d_tag_embed,
+                                      const unsigned int timestep,
+                                      const unsigned int seed,
+                                      const Scalar T,
+                                      const unsigned int N_mpcd,
+                                      const unsigned int num_cells,
+                                      const bool normalize,
+                                      const unsigned int block_size,
+                                      const unsigned int tpp)
+    { }
+
+/*!
+ * \param d_rand_vel Random momentum or velocity (x,y,z) and mass (w) per cell (output)
+ * \param d_cell_np Number of particles per cell
+ * \param d_cell_list MPCD cell list
+ * \param cli Indexer into the cell list
+ * \param d_tag MPCD particle tags
+ * \param mpcd_mass Mass of MPCD particle
+ * \param d_embed_idx Embedded particle indexes
+ * \param d_vel_embed Embedded particle velocities (and masses)
+ * \param d_tag_embed Embedded particle tags
+ * \param timestep Current timestep
+ * \param seed Seed of the collision method
+ * \param T Temperature
+ * \param N_mpcd Number of MPCD particles
+ * \param num_cells Number of cells
+ * \param normalize If true, write the average velocity instead of the momentum
+ * \param block_size Number of threads per block
+ * \param tpp Number of threads per cell
+ *
+ * \returns cudaSuccess on completion
+ *
+ * \sa mpcd::gpu::kernel::at_sum_velocity
+ */
+cudaError_t at_sum_velocity(double4 *d_rand_vel,
+                            const unsigned int *d_cell_np,
+                            const unsigned int *d_cell_list,
+                            const Index2D& cli,
+                            const unsigned int *d_tag,
+                            const Scalar mpcd_mass,
+                            const unsigned int *d_embed_idx,
+                            const Scalar4 *d_vel_embed,
+                            const unsigned int *d_tag_embed,
+                            const unsigned int timestep,
+                            const unsigned int seed,
+                            const Scalar T,
+                            const unsigned int N_mpcd,
+                            const unsigned int num_cells,
+                            const bool normalize,
+                            const unsigned int block_size,
+                            const unsigned int tpp)
+    {
+    if (num_cells == 0) return cudaSuccess;
+
+    launch_at_sum_velocity<32>(d_rand_vel,
+                               d_cell_np,
+                               d_cell_list,
+                               cli,
+                               d_tag,
+                               mpcd_mass,
+                               d_embed_idx,
+                               d_vel_embed,
+                               d_tag_embed,
+                               timestep,
+                               seed,
+                               T,
+                               N_mpcd,
+                               num_cells,
+                               normalize,
+                               block_size,
+                               tpp);
+    return cudaSuccess;
+    }
+
+/*!
+ * \param d_rand_vel Random momentum (x,y,z) and mass (w) per cell, overwritten by the velocity
+ * \param num_cells Number of cells
+ * \param block_size Number of threads per block
+ *
+ * \returns cudaSuccess on completion
+ *
+ * \sa mpcd::gpu::kernel::at_normalize_velocity
+ */
+cudaError_t at_normalize_velocity(double4 *d_rand_vel,
+                                  const unsigned int num_cells,
+                                  const unsigned int block_size)
     {
     static unsigned int max_block_size = UINT_MAX;
     if (max_block_size == UINT_MAX)
         {
         cudaFuncAttributes attr;
-        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::at_draw_velocity);
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::at_normalize_velocity);
         max_block_size = attr.maxThreadsPerBlock;
         }
 
     unsigned int run_block_size = min(block_size, max_block_size);
 
-    dim3 grid(N_tot / run_block_size + 1);
-    mpcd::gpu::kernel::at_draw_velocity<<<grid, run_block_size>>>(d_vel,
-                                                                  d_vel_embed,
-                                                                  d_tag,
-                                                                  mpcd_mass,
-                                                                  d_embed_idx,
-                                                                  d_tag_embed,
-                                                                  timestep,
-                                                                  seed,
-                                                                  T,
-                                                                  N_mpcd,
-                                                                  N_tot);
+    dim3 grid(num_cells / run_block_size + 1);
+    mpcd::gpu::kernel::at_normalize_velocity<<<grid, run_block_size>>>(d_rand_vel, num_cells);
 
     return cudaSuccess;
     }
 
-cudaError_t at_apply_velocity(Scalar4 *d_vel,
+cudaError_t at_apply_velocity(mpcd::detail::vel_t *d_vel,
                               Scalar4 *d_vel_embed,
-                              const Scalar4 *d_vel_alt,
+                              const unsigned int *d_tag,
+                              const Scalar mpcd_mass,
                               const unsigned int *d_embed_idx,
-                              const Scalar4 *d_vel_alt_embed,
+                              const unsigned int *d_tag_embed,
                               const unsigned int *d_embed_cell_ids,
                               const double4 *d_cell_vel,
                               const double4 *d_rand_vel,
+                              const unsigned int timestep,
+                              const unsigned int seed,
+                              const Scalar T,
                               const unsigned int N_mpcd,
                               const unsigned int N_tot,
                               const unsigned int block_size)
@@ -185,12 +422,16 @@ cudaError_t at_apply_velocity(Scalar4 *d_vel,
     dim3 grid(N_tot / run_block_size + 1);
     mpcd::gpu::kernel::at_apply_velocity<<<grid, run_block_size>>>(d_vel,
                                                                    d_vel_embed,
-                                                                   d_vel_alt,
+                                                                   d_tag,
+                                                                   mpcd_mass,
                                                                    d_embed_idx,
-                                                                   d_vel_alt_embed,
+                                                                   d_tag_embed,
                                                                    d_embed_cell_ids,
                                                                    d_cell_vel,
                                                                    d_rand_vel,
+                                                                   timestep,
+                                                                   seed,
+                                                                   T,
                                                                    N_mpcd,
                                                                    N_tot);
 
@@ -13,6 +13,8 @@
 
 #include <cuda_runtime.h>
 
+#include "ParticleDataUtilities.h"
+
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/Index1D.h"
 
@@ -21,29 +23,43 @@ namespace mpcd
 namespace gpu
 {
 
-//! Draw particle velocities for the Andersen thermostat from Gaussian distribution
-cudaError_t at_draw_velocity(Scalar4 *d_vel,
-                             Scalar4 *d_vel_embed,
-                             const unsigned int *d_tag,
-                             const Scalar mpcd_mass,
-                             const unsigned int *d_embed_idx,
-                             const unsigned int *d_tag_embed,
-                             const unsigned int timestep,
-                             const unsigned int seed,
-                             const Scalar T,
-                             const unsigned int N_mpcd,
-                             const unsigned int N_tot,
-                             const unsigned int block_size);
+//! Sum the random velocities for the Andersen thermostat in each cell
+cudaError_t at_sum_velocity(double4 *d_rand_vel,
+                            const unsigned int *d_cell_np,
+                            const unsigned int *d_cell_list,
+                            const Index2D& cli,
+                            const unsigned int *d_tag,
+                            const Scalar mpcd_mass,
+                            const unsigned int *d_embed_idx,
+                            const Scalar4 *d_vel_embed,
+                            const unsigned int *d_tag_embed,
+                            const unsigned int timestep,
+                            const unsigned int seed,
+                            const Scalar T,
+                            const unsigned int N_mpcd,
+                            const unsigned int num_cells,
+                            const bool normalize,
+                            const unsigned int block_size,
+                            const unsigned int tpp);
+
+//! Normalize the summed random velocities of each cell
+cudaError_t at_normalize_velocity(double4 *d_rand_vel,
+                                  const unsigned int num_cells,
+                                  const unsigned int block_size);
 
 //! Apply velocities for the Andersen thermostat
-cudaError_t at_apply_velocity(Scalar4 *d_vel,
+cudaError_t at_apply_velocity(mpcd::detail::vel_t *d_vel,
                               Scalar4 *d_vel_embed,
-                              const Scalar4 *d_vel_alt,
+                              const unsigned int *d_tag,
+                              const Scalar mpcd_mass,
                               const unsigned int *d_embed_idx,
-                              const Scalar4 *d_vel_alt_embed,
+                              const unsigned int *d_tag_embed,
                               const unsigned int *d_embed_cell_ids,
                               const double4 *d_cell_vel,
                               const double4 *d_rand_vel,
+                              const unsigned int timestep,
+                              const unsigned int seed,
+                              const Scalar T,
                               const unsigned int N_mpcd,
                               const unsigned int N_tot,
                               const unsigned int block_size);
@@ -31,7 +31,6 @@ class PYBIND11_EXPORT ATCollisionMethodGPU : public mpcd::ATCollisionMethod
                              int phase,
                              unsigned int seed,
                              std::shared_ptr<mpcd::CellThermoCompute> thermo,
-                             std::shared_ptr<mpcd::CellThermoCompute> rand_thermo,
                              std::shared_ptr<::Variant> T);
 
         //! Set autotuner parameters
@@ -44,19 +43,24 @@ class PYBIND11_EXPORT ATCollisionMethodGPU : public mpcd::ATCollisionMethod
             mpcd::ATCollisionMethod::setAutotunerParams(enable, period);
 
             m_tuner_draw->setPeriod(period); m_tuner_draw->setEnabled(enable);
+            m_tuner_normalize->setPeriod(period); m_tuner_normalize->setEnabled(enable);
             m_tuner_apply->setPeriod(period); m_tuner_apply->setEnabled(enable);
             }
 
     protected:
-        //! Draw velocities for particles in each cell on the GPU
-        virtual void drawVelocities(unsigned int timestep);
+        //! Sum the random velocities of the particles in each cell on the GPU
+        virtual void sumRandomVelocities(unsigned int timestep, bool normalize);
+
+        //! Normalize the summed random cell velocities on the GPU
+        virtual void normalizeRandomVelocities();
 
         //! Apply the random velocities to particles in each cell on the GPU
-        virtual void applyVelocities();
+        virtual void applyVelocities(unsigned int timestep);
 
     private:
-        std::unique_ptr<Autotuner> m_tuner_draw;    //!< Tuner for drawing random velocities
-        std::unique_ptr<Autotuner> m_tuner_apply;   //!< Tuner for applying random velocities
+        std::unique_ptr<Autotuner> m_tuner_draw;        //!< Tuner for summing random velocities
+        std::unique_ptr<Autotuner> m_tuner_normalize;   //!< Tuner for normalizing random velocities
+        std::unique_ptr<Autotuner> m_tuner_apply;       //!< Tuner for applying random velocities
     };
 
 namespace detail
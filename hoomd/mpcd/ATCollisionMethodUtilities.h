@@ -0,0 +1,63 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+#ifndef MPCD_AT_COLLISION_METHOD_UTILITIES_H_
+#define MPCD_AT_COLLISION_METHOD_UTILITIES_H_
+
+/*!
+ * \file mpcd/ATCollisionMethodUtilities.h
+ * \brief Utilities for mpcd::ATCollisionMethod on the CPU and GPU
+ *
+ * The random velocity of a particle is drawn once when the cell averages are summed
+ * and drawn again when the collision is applied, so the two draws must be identical
+ * on the CPU and the GPU. This code is split out here to guarantee that.
+ */
+
+#include "RandomNumbers.h"
+
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/Saru.h"
+
+#ifdef NVCC
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif // NVCC
+
+namespace mpcd
+{
+namespace detail
+{
+
+//! Draw the random velocity of a particle for the Andersen thermostat
+/*!
+ * \param tag Tag of the particle
+ * \param timestep Current timestep
+ * \param seed Seed of the collision method
+ * \param T Temperature
+ * \param mass Mass of the particle
+ *
+ * \returns Velocity drawn from the Maxwell-Boltzmann distribution at \a T
+ *
+ * The random number generator is keyed by \a tag, \a timestep, and \a seed only, so
+ * the same velocity is returned no matter how often or in which order it is drawn.
+ */
+DEVICE inline Scalar3 draw_at_velocity(const unsigned int tag,
+                                       const unsigned int timestep,
+                                       const unsigned int seed,
+                                       const Scalar T,
+                                       const Scalar mass)
+    {
+    hoomd::detail::Saru rng(tag, timestep, seed);
+    mpcd::detail::NormalGenerator<Scalar,true> gen;
+    return fast::sqrt(T/mass) * make_scalar3(gen(rng), gen(rng), gen(rng));
+    }
+
+} // end namespace detail
+} // end namespace mpcd
+
+#undef DEVICE
+
+#endif // MPCD_AT_COLLISION_METHOD_UTILITIES_H_
@@ -0,0 +1,61 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/BoundaryGeometry.h
+ * \brief Definition of common features of MPCD boundary geometries
+ *
+ * A geometry confines the MPCD particles to a fluid region. It must supply the following methods for use in
+ * mpcd::ConfinedStreamingMethod, mpcd::ConfinedVirtualCellFiller, and their GPU versions:
+ *
+ * - detectCollision(pos, vel, dt): If the particle at \a pos is outside the fluid after moving for \a dt with \a vel,
+ *   move it back to the point where it hit the surface, apply the boundary condition to \a vel, set \a dt to the
+ *   time that remains after the collision, and return true. Otherwise, return false.
+ * - isOutside(pos): True if \a pos is outside the fluid.
+ * - overlapsBoundary(lo, hi): True if the box between \a lo and \a hi may contain points outside the fluid. This test
+ *   may be conservative, but it must never return false for a box that is not entirely inside the fluid.
+ * - validateBox(box, cell_size): True if the geometry fits into the simulation box.
+ * - getSurfaceVelocity(pos): The velocity of the surface closest to \a pos, which is used for virtual particles in
+ *   mpcd::ConfinedVirtualCellFiller.
+ * - getBoundaryCondition(): The boundary condition on the surface.
+ * - getName(): A name for the geometry that is used for python exports and error messages.
+ */
+
+#ifndef MPCD_BOUNDARY_GEOMETRY_H_
+#define MPCD_BOUNDARY_GEOMETRY_H_
+
+#include "hoomd/HOOMDMath.h"
+
+#ifndef NVCC
+#include "hoomd/extern/pybind/include/pybind11/pybind11.h"
+#endif // NVCC
+
+namespace mpcd
+{
+namespace detail
+{
+
+//! Boundary conditions at the surface
+/*!
+ * Boundaries are currently allowed to either be "no slip" or "slip". The tangential
+ * component of the fluid velocity is 0 at a no-slip surface, while the normal
+ * component of the fluid velocity is 0 at a slip surface. The boundaries may move
+ * with a velocity tangential to the surface.
+ */
+enum struct boundary : unsigned char
+    {
+    no_slip=0,
+    slip
+    };
+
+#ifndef NVCC
+//! Export boundary enum to python
+void export_boundary(pybind11::module& m);
+#endif // NVCC
+
+} // end namespace detail
+} // end namespace mpcd
+
+#endif // MPCD_BOUNDARY_GEOMETRY_H_
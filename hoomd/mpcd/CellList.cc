@@ -19,7 +19,9 @@ mpcd::CellList::CellList(std::shared_ptr<SystemDefinition> sysdef,
                          std::shared_ptr<mpcd::ParticleData> mpcd_pdata)
         : Compute(sysdef), m_mpcd_pdata(mpcd_pdata),
           m_cell_size(1.0), m_cell_np_max(4), m_cell_np(m_exec_conf), m_cell_list(m_exec_conf),
-          m_embed_cell_ids(m_exec_conf), m_conditions(m_exec_conf), m_needs_compute_dim(true)
+          m_embed_cell_ids(m_exec_conf), m_conditions(m_exec_conf), m_boundary_flags(m_exec_conf),
+          m_boundary_flags_tag(0), m_boundary_flags_count(0), m_incremental(false), m_can_update(false),
+          m_update_N(0), m_needs_compute_dim(true)
     {
     assert(m_mpcd_pdata);
     m_exec_conf->msg->notice(5) << "Constructing MPCD CellList" << std::endl;
@@ -31,6 +33,8 @@ mpcd::CellList::CellList(std::shared_ptr<SystemDefinition> sysdef,
     m_grid_shift = make_scalar3(0.0,0.0,0.0);
     m_max_grid_shift = 0.5 * m_cell_size;
     m_origin_idx = make_int3(0,0,0);
+    m_stream_dt = Scalar(0.0);
+    m_update_grid_shift = make_scalar3(0.0,0.0,0.0);
 
     resetConditions();
 
@@ -95,19 +99,23 @@ void mpcd::CellList::compute(unsigned int timestep)
             m_embed_cell_ids.resize(m_embed_group->getNumMembers());
             }
 
-        bool overflowed = false;
-        do
+        // try to only move the particles that changed cells, otherwise rebuild from scratch
+        if (!updateCellList())
             {
-            buildCellList();
+            bool overflowed = false;
+            do
+                {
+                buildCellList();
 
-            overflowed = checkConditions();
+                overflowed = checkConditions();
 
-            if (overflowed)
-                {
-                reallocate();
-                resetConditions();
-                }
-            } while (overflowed);
+                if (overflowed)
+                    {
+                    reallocate();
+                    resetConditions();
+                    }
+                } while (overflowed);
+            }
 
         // we are finished building, explicitly mark everything (rather than using shouldCompute)
         m_first_compute = false;
@@ -120,6 +128,72 @@ void mpcd::CellList::compute(unsigned int timestep)
     if (m_prof) m_prof->pop(m_exec_conf);
     }
 
+/*!
+ * \returns True if computeStreamed() can be used
+ *
+ * Fusing the streaming step into the cell list build is only possible when the cell list does not need any
+ * particle communication before it is built, and when it only depends on the MPCD particles that are streamed.
+ */
+bool mpcd::CellList::canComputeStreamed() const
+    {
+    #ifdef ENABLE_MPI
+    if (m_decomposition)
+        return false;
+    #endif // ENABLE_MPI
+
+    return !m_embed_group;
+    }
+
+/*!
+ * \param timestep Timestep the cell list is built for
+ * \param dt Time to stream the MPCD particles ballistically
+ * \param grid_shift Grid shift that will be in effect at \a timestep
+ *
+ * The MPCD particles are streamed and binned with \a grid_shift in the same pass over the particle data. The cell
+ * list is then marked as computed for \a timestep, so that it is reused there unless the particles are sorted, the
+ * box changes, or the cell list is needed at an earlier timestep. The current grid shift is restored afterwards.
+ *
+ * \pre canComputeStreamed() is true.
+ */
+void mpcd::CellList::computeStreamed(unsigned int timestep, Scalar dt, const Scalar3& grid_shift)
+    {
+    if (m_prof) m_prof->push(m_exec_conf, "MPCD cell list");
+
+    if (m_needs_compute_dim)
+        {
+        computeDimensions();
+        }
+
+    const Scalar3 cur_grid_shift = m_grid_shift;
+    m_grid_shift = grid_shift;
+
+    // the particles are only streamed in the first pass, rebuilds after an overflow only bin them
+    m_stream_dt = dt;
+    bool overflowed = false;
+    do
+        {
+        buildCellList();
+        m_stream_dt = Scalar(0.0);
+
+        overflowed = checkConditions();
+
+        if (overflowed)
+            {
+            reallocate();
+            resetConditions();
+            }
+        } while (overflowed);
+
+    m_grid_shift = cur_grid_shift;
+
+    m_first_compute = false;
+    m_force_compute = false;
+    m_last_computed = timestep;
+
+    m_mpcd_pdata->validateCellCache();
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
 void mpcd::CellList::reallocate()
     {
     m_exec_conf->msg->notice(6) << "Allocating MPCD cell list, " << m_cell_np_max
@@ -171,6 +245,9 @@ void mpcd::CellList::computeDimensions()
     {
     if (!m_needs_compute_dim) return;
 
+    // the cells are redefined, so the last build cannot be updated in place
+    m_can_update = false;
+
     // first update / validate the global box
     updateGlobalBox();
 
@@ -283,6 +360,10 @@ void mpcd::CellList::computeDimensions()
     m_cell_indexer = Index3D(m_cell_dim.x, m_cell_dim.y, m_cell_dim.z);
     m_cell_np.resize(m_cell_indexer.getNumElements());
 
+    // the boundary flags have to be recomputed for the new cells
+    m_boundary_flags.resize(m_cell_indexer.getNumElements());
+    m_boundary_flags_tag = 0;
+
     // reallocate per-cell memory
     reallocate();
 
@@ -502,8 +583,11 @@ void mpcd::CellList::buildCellList()
 
     uint3 conditions = make_uint3(0,0,0);
 
-    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    // the positions are written when the particles are streamed in the same pass
+    ArrayHandle<mpcd::detail::pos_t> h_pos(m_mpcd_pdata->getPositions(), access_location::host,
+                               (m_stream_dt != Scalar(0.0)) ? access_mode::readwrite : access_mode::read);
+    ArrayHandle<mpcd::detail::vel_t> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    const mpcd::detail::PositionGrid& pos_grid = m_mpcd_pdata->getPositionGrid();
     unsigned int N_mpcd = m_mpcd_pdata->getN();
     unsigned int N_tot = N_mpcd;
 
@@ -519,29 +603,41 @@ void mpcd::CellList::buildCellList()
         N_tot += m_embed_group->getNumMembers();
         }
 
-    // total effective number of cells in the global box, optionally padded by
-    // extra cells in MPI simulations
-    uint3 n_global_cells = m_global_cell_dim;
-    #ifdef ENABLE_MPI
-    if (isCommunicating(mpcd::detail::face::east)) n_global_cells.x += 2*m_num_extra;
-    if (isCommunicating(mpcd::detail::face::north)) n_global_cells.y += 2*m_num_extra;
-    if (isCommunicating(mpcd::detail::face::up)) n_global_cells.z += 2*m_num_extra;
-    #endif // ENABLE_MPI
+    // the particle cells are only saved if the build can later be updated in place
+    const bool save_cells = (m_incremental && !m_embed_group);
+    m_can_update = false;
+    if (save_cells)
+        {
+        m_particle_cells.resize(N_mpcd);
+        }
 
+    const uint3 n_global_cells = getNumGlobalBins();
     const Scalar3 global_lo = m_pdata->getGlobalBox().getLo();
 
     for (unsigned int cur_p = 0; cur_p < N_tot; ++cur_p)
         {
-        Scalar4 postype_i;
+        Scalar3 pos_i;
         if (cur_p < N_mpcd)
             {
-            postype_i = h_pos.data[cur_p];
+            const mpcd::detail::pos_t postype_i = h_pos.data[cur_p];
+            pos_i = mpcd::detail::get_position(postype_i, pos_grid);
+
+            if (m_stream_dt != Scalar(0.0))
+                {
+                // propagate the particle to its new position ballistically
+                pos_i += m_stream_dt * mpcd::detail::get_velocity(h_vel.data[cur_p]);
+
+                // wrap and update the position
+                int3 image = make_int3(0,0,0);
+                box.wrap(pos_i, image);
+                h_pos.data[cur_p] = mpcd::detail::make_position(pos_i, mpcd::detail::get_type(postype_i), pos_grid);
+                }
             }
         else
             {
-            postype_i = h_pos_embed->data[h_embed_member_idx->data[cur_p - N_mpcd]];
+            const Scalar4 postype_i = h_pos_embed->data[h_embed_member_idx->data[cur_p - N_mpcd]];
+            pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
             }
-        Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
 
         if (std::isnan(pos_i.x) || std::isnan(pos_i.y) || std::isnan(pos_i.z))
             {
@@ -549,52 +645,14 @@ void mpcd::CellList::buildCellList()
             continue;
             }
 
-        // bin particle assuming orthorhombic box (already validated)
-        const Scalar3 delta = (pos_i - m_grid_shift) - global_lo;
-        int3 global_bin = make_int3(std::floor(delta.x / m_cell_size),
-                                    std::floor(delta.y / m_cell_size),
-                                    std::floor(delta.z / m_cell_size));
-
-        // wrap cell back through the boundaries (grid shifting may send +/- 1 outside of range)
-        // this is done using periodic from the "local" box, since this will be periodic
-        // only when there is one rank along the dimension
-        if (periodic.x)
-            {
-            if (global_bin.x == (int)n_global_cells.x)
-                global_bin.x = 0;
-            else if (global_bin.x == -1)
-                global_bin.x = n_global_cells.x - 1;
-            }
-        if (periodic.y)
-            {
-            if (global_bin.y == (int)n_global_cells.y)
-                global_bin.y = 0;
-            else if (global_bin.y == -1)
-                global_bin.y = n_global_cells.y - 1;
-            }
-        if (periodic.z)
-            {
-            if (global_bin.z == (int)n_global_cells.z)
-                global_bin.z = 0;
-            else if (global_bin.z == -1)
-                global_bin.z = n_global_cells.z - 1;
-            }
-
-        // compute the local cell
-        int3 bin = make_int3(global_bin.x - m_origin_idx.x,
-                             global_bin.y - m_origin_idx.y,
-                             global_bin.z - m_origin_idx.z);
-
         // validate and make sure no particles blew out of the box
-        if ((bin.x < 0 || bin.x >= (int)m_cell_dim.x) ||
-            (bin.y < 0 || bin.y >= (int)m_cell_dim.y) ||
-            (bin.z < 0 || bin.z >= (int)m_cell_dim.z))
+        unsigned int bin_idx;
+        if (!binPosition(pos_i, global_lo, n_global_cells, periodic, bin_idx))
             {
             conditions.z = cur_p + 1;
             continue;
             }
 
-        unsigned int bin_idx = m_cell_indexer(bin.x, bin.y, bin.z);
         unsigned int offset = h_cell_np.data[bin_idx];
         if (offset < m_cell_np_max)
             {
@@ -609,7 +667,8 @@ void mpcd::CellList::buildCellList()
         // stash the current particle bin into the velocity array
         if (cur_p < N_mpcd)
             {
-            h_vel.data[cur_p].w = __int_as_scalar(bin_idx);
+            mpcd::detail::set_cell(h_vel.data[cur_p], bin_idx);
+            if (save_cells) m_particle_cells[cur_p] = bin_idx;
             }
         else
             {
@@ -622,6 +681,200 @@ void mpcd::CellList::buildCellList()
 
     // write out the conditions
     m_conditions.resetFlags(conditions);
+
+    // a complete build can be updated in place next time
+    if (save_cells && conditions.x == 0 && conditions.y == 0 && conditions.z == 0)
+        {
+        m_can_update = true;
+        m_update_grid_shift = m_grid_shift;
+        m_update_N = N_mpcd;
+        }
+    }
+
+/*!
+ * \returns True if the cell list was updated, false if it must be rebuilt
+ *
+ * The cell of every MPCD particle is recomputed, but only the particles that changed cells since the last build are
+ * removed from their old cell (by swapping in the last particle of that cell) and appended to their new one. The
+ * cell contents are the same as for a full build, but the order of particles within a cell can differ. The update is
+ * abandoned when the last build cannot be reused (see setIncremental()), when a particle is invalid, or when a cell
+ * would overflow, and the caller should then rebuild the cell list with buildCellList().
+ */
+bool mpcd::CellList::updateCellList()
+    {
+    const unsigned int N_mpcd = m_mpcd_pdata->getN();
+    if (!m_incremental || !m_can_update || m_embed_group || N_mpcd != m_update_N ||
+        m_grid_shift.x != m_update_grid_shift.x ||
+        m_grid_shift.y != m_update_grid_shift.y ||
+        m_grid_shift.z != m_update_grid_shift.z)
+        {
+        return false;
+        }
+
+    // in case anything goes wrong, the build cannot be updated from this point
+    m_can_update = false;
+
+    const uchar3 periodic = m_pdata->getBox().getPeriodic();
+    const uint3 n_global_cells = getNumGlobalBins();
+    const Scalar3 global_lo = m_pdata->getGlobalBox().getLo();
+
+    ArrayHandle<mpcd::detail::pos_t> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::detail::vel_t> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    const mpcd::detail::PositionGrid& pos_grid = m_mpcd_pdata->getPositionGrid();
+
+    // find the particles that changed cells
+    m_moved.clear();
+    for (unsigned int cur_p = 0; cur_p < N_mpcd; ++cur_p)
+        {
+        const Scalar3 pos_i = mpcd::detail::get_position(h_pos.data[cur_p], pos_grid);
+
+        // invalid particles are diagnosed by a full build
+        unsigned int bin_idx;
+        if (std::isnan(pos_i.x) || std::isnan(pos_i.y) || std::isnan(pos_i.z) ||
+            !binPosition(pos_i, global_lo, n_global_cells, periodic, bin_idx))
+            {
+            return false;
+            }
+
+        if (bin_idx != m_particle_cells[cur_p])
+            {
+            m_moved.push_back(std::make_pair(cur_p, bin_idx));
+            }
+
+        // the cached cell may have been overwritten since the last build
+        mpcd::detail::set_cell(h_vel.data[cur_p], bin_idx);
+        }
+
+    if (m_moved.empty())
+        {
+        m_can_update = true;
+        return true;
+        }
+
+    ArrayHandle<unsigned int> h_cell_list(m_cell_list, access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_cell_np(m_cell_np, access_location::host, access_mode::readwrite);
+
+    // remove the moved particles from their old cells
+    for (auto it = m_moved.begin(); it != m_moved.end(); ++it)
+        {
+        const unsigned int pid = it->first;
+        const unsigned int old_bin = m_particle_cells[pid];
+        const unsigned int np = h_cell_np.data[old_bin];
+
+        unsigned int offset = 0;
+        while (offset < np && h_cell_list.data[m_cell_list_indexer(offset, old_bin)] != pid)
+            {
+            ++offset;
+            }
+        if (offset == np)
+            {
+            return false;
+            }
+
+        h_cell_list.data[m_cell_list_indexer(offset, old_bin)] = h_cell_list.data[m_cell_list_indexer(np-1, old_bin)];
+        h_cell_np.data[old_bin] = np-1;
+        }
+
+    // append them to their new cells
+    for (auto it = m_moved.begin(); it != m_moved.end(); ++it)
+        {
+        const unsigned int pid = it->first;
+        const unsigned int bin_idx = it->second;
+        const unsigned int offset = h_cell_np.data[bin_idx];
+        if (offset >= m_cell_np_max)
+            {
+            return false;
+            }
+
+        h_cell_list.data[m_cell_list_indexer(offset, bin_idx)] = pid;
+        h_cell_np.data[bin_idx] = offset+1;
+        m_particle_cells[pid] = bin_idx;
+        }
+
+    m_can_update = true;
+    return true;
+    }
+
+/*!
+ * \returns Number of cells in each direction of the global box
+ *
+ * In MPI simulations, the global box is padded by extra cells along the communicating directions.
+ */
+uint3 mpcd::CellList::getNumGlobalBins()
+    {
+    // total effective number of cells in the global box, optionally padded by
+    // extra cells in MPI simulations
+    uint3 n_global_cells = m_global_cell_dim;
+    #ifdef ENABLE_MPI
+    if (isCommunicating(mpcd::detail::face::east)) n_global_cells.x += 2*m_num_extra;
+    if (isCommunicating(mpcd::detail::face::north)) n_global_cells.y += 2*m_num_extra;
+    if (isCommunicating(mpcd::detail::face::up)) n_global_cells.z += 2*m_num_extra;
+    #endif // ENABLE_MPI
+
+    return n_global_cells;
+    }
+
+/*!
+ * \param pos Particle position
+ * \param global_lo Lower bound of the global box
+ * \param n_global_cells Number of cells in each direction of the global box from getNumGlobalBins()
+ * \param periodic Periodicity of the local box
+ * \param bin_idx Local cell index (output)
+ *
+ * \returns True if \a pos lies in a local cell
+ */
+bool mpcd::CellList::binPosition(const Scalar3& pos,
+                                 const Scalar3& global_lo,
+                                 const uint3& n_global_cells,
+                                 const uchar3& periodic,
+                                 unsigned int& bin_idx) const
+    {
+    // bin particle assuming orthorhombic box (already validated)
+    const Scalar3 delta = (pos - m_grid_shift) - global_lo;
+    int3 global_bin = make_int3(std::floor(delta.x / m_cell_size),
+                                std::floor(delta.y / m_cell_size),
+                                std::floor(delta.z / m_cell_size));
+
+    // wrap cell back through the boundaries (grid shifting may send +/- 1 outside of range)
+    // this is done using periodic from the "local" box, since this will be periodic
+    // only when there is one rank along the dimension
+    if (periodic.x)
+        {
+        if (global_bin.x == (int)n_global_cells.x)
+            global_bin.x = 0;
+        else if (global_bin.x == -1)
+            global_bin.x = n_global_cells.x - 1;
+        }
+    if (periodic.y)
+        {
+        if (global_bin.y == (int)n_global_cells.y)
+            global_bin.y = 0;
+        else if (global_bin.y == -1)
+            global_bin.y = n_global_cells.y - 1;
+        }
+    if (periodic.z)
+        {
+        if (global_bin.z == (int)n_global_cells.z)
+            global_bin.z = 0;
+        else if (global_bin.z == -1)
+            global_bin.z = n_global_cells.z - 1;
+        }
+
+    // compute the local cell
+    int3 bin = make_int3(global_bin.x - m_origin_idx.x,
+                         global_bin.y - m_origin_idx.y,
+                         global_bin.z - m_origin_idx.z);
+
+    // validate and make sure no particles blew out of the box
+    if ((bin.x < 0 || bin.x >= (int)m_cell_dim.x) ||
+        (bin.y < 0 || bin.y >= (int)m_cell_dim.y) ||
+        (bin.z < 0 || bin.z >= (int)m_cell_dim.z))
+        {
+        return false;
+        }
+
+    bin_idx = m_cell_indexer(bin.x, bin.y, bin.z);
+    return true;
     }
 
 /*!
@@ -633,8 +886,14 @@ void mpcd::CellList::sort(unsigned int timestep,
                           const GPUArray<unsigned int>& order,
                           const GPUArray<unsigned int>& rorder)
     {
-    // no need to do any sorting if we can still be called at the current timestep
-    if (peekCompute(timestep)) return;
+    // no need to do any sorting if we can still be called at the current timestep,
+    // unless the cell list was already built ahead of the current timestep by computeStreamed()
+    // the last build is then left in the old particle order, so it cannot be updated in place
+    if (peekCompute(timestep) && m_last_computed <= timestep)
+        {
+        m_can_update = false;
+        return;
+        }
 
     // if mapping is not valid, signal that we need to force a recompute next time
     // that the cell list is needed. We don't call forceCompute() directly because this always
@@ -642,6 +901,7 @@ void mpcd::CellList::sort(unsigned int timestep,
     if (rorder.isNull())
         {
         m_force_compute = true;
+        m_can_update = false;
         return;
         }
 
@@ -665,6 +925,18 @@ void mpcd::CellList::sort(unsigned int timestep,
                 }
             }
         }
+
+    // reorder the saved particle cells to match
+    if (m_can_update)
+        {
+        ArrayHandle<unsigned int> h_order(order, access_location::host, access_mode::read);
+        std::vector<unsigned int> particle_cells(N_mpcd);
+        for (unsigned int idx = 0; idx < N_mpcd; ++idx)
+            {
+            particle_cells[idx] = m_particle_cells[h_order.data[idx]];
+            }
+        m_particle_cells.swap(particle_cells);
+        }
     }
 
 #ifdef ENABLE_MPI
@@ -736,22 +1008,22 @@ bool mpcd::CellList::checkConditions()
     if (conditions.z)
         {
         unsigned int n = conditions.z - 1;
-        Scalar4 pos_empty_i;
+        Scalar3 pos;
         if (n < m_mpcd_pdata->getN())
             {
-            ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
-            pos_empty_i = h_pos.data[n];
+            ArrayHandle<mpcd::detail::pos_t> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+            pos = mpcd::detail::get_position(h_pos.data[n], m_mpcd_pdata->getPositionGrid());
             m_exec_conf->msg->error() << "MPCD particle is no longer in the simulation box"<<std::endl;
             }
         else
             {
             ArrayHandle<Scalar4> h_pos_embed(m_pdata->getPositions(), access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_embed_member_idx(m_embed_group->getIndexArray(), access_location::host, access_mode::read);
-            pos_empty_i = h_pos_embed.data[h_embed_member_idx.data[n - m_mpcd_pdata->getN()]];
+            const Scalar4 pos_empty_i = h_pos_embed.data[h_embed_member_idx.data[n - m_mpcd_pdata->getN()]];
+            pos = make_scalar3(pos_empty_i.x, pos_empty_i.y, pos_empty_i.z);
             m_exec_conf->msg->error() << "Embedded particle is no longer in the simulation box"<<std::endl;
             }
 
-        Scalar3 pos = make_scalar3(pos_empty_i.x, pos_empty_i.y, pos_empty_i.z);
         m_exec_conf->msg->error() << "Cartesian coordinates: "<<std::endl;
         m_exec_conf->msg->error() << "x: "<<pos.x<<" y: "<<pos.y<<" z: "<<pos.z<<std::endl;
         m_exec_conf->msg->error() << "Grid shift: " << std::endl;
@@ -849,6 +1121,7 @@ void mpcd::detail::export_CellList(pybind11::module& m)
     py::class_<mpcd::CellList, std::shared_ptr<mpcd::CellList> >(m, "CellList", py::base<Compute>())
         .def(py::init< std::shared_ptr<SystemDefinition>, std::shared_ptr<mpcd::ParticleData> >())
         .def("setCellSize", &mpcd::CellList::setCellSize)
+        .def("setIncremental", &mpcd::CellList::setIncremental)
         #ifdef ENABLE_MPI
         .def("setMPCDCommunicator", &mpcd::CellList::setMPCDCommunicator)
         #endif // ENABLE_MPI
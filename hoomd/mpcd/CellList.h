@@ -26,6 +26,7 @@
 #include "hoomd/extern/pybind/include/pybind11/pybind11.h"
 
 #include <array>
+#include <vector>
 
 namespace mpcd
 {
@@ -46,6 +47,12 @@ class PYBIND11_EXPORT CellList : public Compute
         //! Build the cell list
         virtual void compute(unsigned int timestep);
 
+        //! Check if the cell list can be built while streaming the particles
+        bool canComputeStreamed() const;
+
+        //! Stream the MPCD particles ballistically and build the cell list in the same pass
+        void computeStreamed(unsigned int timestep, Scalar dt, const Scalar3& grid_shift);
+
         //! Sizes the cell list based on the box
         void computeDimensions();
 
@@ -135,6 +142,24 @@ class PYBIND11_EXPORT CellList : public Compute
             return m_cell_size;
             }
 
+        //! Toggle incremental updates of the cell list
+        /*!
+         * \param incremental If true, only relocate the particles that changed cells since the last build
+         *
+         * An incremental update is only possible when the grid shift, the cell dimensions, and the MPCD particles
+         * (up to a sort) are the same as in the last build and there are no embedded particles. Otherwise,
+         * the cell list is rebuilt from scratch. Incremental updates are only performed on the CPU.
+         */
+        void setIncremental(bool incremental)
+            {
+            m_incremental = incremental;
+            if (!m_incremental)
+                {
+                m_can_update = false;
+                std::vector<unsigned int>().swap(m_particle_cells);
+                }
+            }
+
         //! Get the box that is covered by the cell list
         /*!
          * In MPI simulations, this results in a calculation of the cell list
@@ -237,6 +262,41 @@ class PYBIND11_EXPORT CellList : public Compute
             }
         #endif // ENABLE_MPI
 
+        //! Get the flags marking the cells that are close to a boundary
+        /*!
+         * The flags are not computed by the cell list. A streaming method in a confined geometry fills them
+         * for the cells of the unshifted grid (see mpcd::ConfinedStreamingMethod) and then calls
+         * stampBoundaryFlags(). The array is resized with the cell list dimensions.
+         */
+        GPUArray<unsigned int>& getBoundaryFlags()
+            {
+            return m_boundary_flags;
+            }
+
+        //! Get the tag of the last computation of the boundary flags
+        /*!
+         * \returns Tag returned by the last call to stampBoundaryFlags(), or 0 if the flags are not current
+         *
+         * The tag is reset to 0 whenever the cell list dimensions change.
+         */
+        unsigned int getBoundaryFlagsTag() const
+            {
+            return m_boundary_flags_tag;
+            }
+
+        //! Mark the boundary flags as current
+        /*!
+         * \returns A new tag that identifies this computation of the flags
+         *
+         * The caller can compare the tag to getBoundaryFlagsTag() to detect if the flags have been
+         * invalidated or overwritten since.
+         */
+        unsigned int stampBoundaryFlags()
+            {
+            m_boundary_flags_tag = ++m_boundary_flags_count;
+            return m_boundary_flags_tag;
+            }
+
         //! Get the signal for dimensions changing
         /*!
          * \returns A signal that subscribers can attach to be notified that the
@@ -268,8 +328,12 @@ class PYBIND11_EXPORT CellList : public Compute
         GPUVector<unsigned int> m_cell_list;        //!< Cell list of particles
         GPUVector<unsigned int> m_embed_cell_ids;   //!< Cell ids of the embedded particles
         GPUFlags<uint3> m_conditions;               //!< Detect conditions that might fail building cell list
+        GPUVector<unsigned int> m_boundary_flags;   //!< Flags of the cells close to a boundary
+        unsigned int m_boundary_flags_tag;          //!< Tag of the current boundary flags (0 if invalid)
+        unsigned int m_boundary_flags_count;        //!< Number of times the boundary flags have been stamped
 
         int3 m_origin_idx;                  //!< Origin as a global index
+        Scalar m_stream_dt;                 //!< Time to stream the MPCD particles while building (0 to only bin)
 
         #ifdef ENABLE_MPI
         unsigned int m_num_extra;               //!< Number of extra cells to communicate over
@@ -290,6 +354,26 @@ class PYBIND11_EXPORT CellList : public Compute
         //! Builds the cell list and handles cell list memory
         virtual void buildCellList();
 
+        //! Relocate the particles that changed cells since the last build
+        bool updateCellList();
+
+        //! Get the number of cells in each direction of the global box, including padding cells
+        uint3 getNumGlobalBins();
+
+        //! Compute the local cell of a position
+        bool binPosition(const Scalar3& pos,
+                         const Scalar3& global_lo,
+                         const uint3& n_global_cells,
+                         const uchar3& periodic,
+                         unsigned int& bin_idx) const;
+
+        bool m_incremental;                         //!< True if the cell list is updated incrementally
+        bool m_can_update;                          //!< True if the last build can be updated incrementally
+        Scalar3 m_update_grid_shift;                //!< Grid shift of the last build
+        unsigned int m_update_N;                    //!< Number of MPCD particles in the last build
+        std::vector<unsigned int> m_particle_cells; //!< Cell of each MPCD particle in the last build
+        std::vector< std::pair<unsigned int, unsigned int> > m_moved;  //!< Particles and their new cells in an update
+
         //! Callback to sort cell list when particle data is sorted
         virtual void sort(unsigned int timestep,
                           const GPUArray<unsigned int>& order,
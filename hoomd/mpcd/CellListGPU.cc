@@ -34,8 +34,10 @@ void mpcd::CellListGPU::buildCellList()
     {
     ArrayHandle<unsigned int> d_cell_list(m_cell_list, access_location::device, access_mode::overwrite);
     ArrayHandle<unsigned int> d_cell_np(m_cell_np, access_location::device, access_mode::overwrite);
-    ArrayHandle<Scalar4> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::read);
-    ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+    // the positions are written when the particles are streamed in the same pass
+    ArrayHandle<mpcd::detail::pos_t> d_pos(m_mpcd_pdata->getPositions(), access_location::device,
+                               (m_stream_dt != Scalar(0.0)) ? access_mode::readwrite : access_mode::read);
+    ArrayHandle<mpcd::detail::vel_t> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
 
     const unsigned int N_mpcd = m_mpcd_pdata->getN();
     unsigned int N_tot = N_mpcd;
@@ -76,6 +78,9 @@ void mpcd::CellListGPU::buildCellList()
                                      m_cell_list_indexer,
                                      N_mpcd,
                                      N_tot,
+                                     m_pdata->getBox(),
+                                     m_mpcd_pdata->getPositionGrid(),
+                                     m_stream_dt,
                                      m_tuner_cell->getParam());
         if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
         m_tuner_cell->end();
@@ -102,6 +107,9 @@ void mpcd::CellListGPU::buildCellList()
                                      m_cell_list_indexer,
                                      N_mpcd,
                                      N_tot,
+                                     m_pdata->getBox(),
+                                     m_mpcd_pdata->getPositionGrid(),
+                                     m_stream_dt,
                                      m_tuner_cell->getParam());
         if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
         m_tuner_cell->end();
@@ -117,8 +125,9 @@ void mpcd::CellListGPU::sort(unsigned int timestep,
                              const GPUArray<unsigned int>& order,
                              const GPUArray<unsigned int>& rorder)
     {
-    // no need to do any sorting if we can still be called at the current timestep
-    if (peekCompute(timestep)) return;
+    // no need to do any sorting if we can still be called at the current timestep,
+    // unless the cell list was already built ahead of the current timestep by computeStreamed()
+    if (peekCompute(timestep) && m_last_computed <= timestep) return;
 
     // force a recompute if mapping is invalid
     if (rorder.isNull())
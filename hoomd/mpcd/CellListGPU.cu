@@ -37,9 +37,14 @@ namespace kernel
  * \param cell_list_indexer 2D indexer for particle position in cell
  * \param N_mpcd Number of MPCD particles
  * \param N_tot Total number of particle (MPCD + embedded)
+ * \param box Simulation box, used to wrap streamed particles
+ * \param pos_grid Grid for compact MPCD particle positions
+ * \param stream_dt Time to stream the MPCD particles ballistically before binning (0 to only bin)
  *
  * \b Implementation
- * One thread is launched per particle. The particle is floored into a bin subject to a random grid shift.
+ * One thread is launched per particle. If \a stream_dt is nonzero, the MPCD particle is first streamed ballistically
+ * and its wrapped position is written back, so that streaming and binning make a single pass over the particle data.
+ * The particle is floored into a bin subject to a random grid shift.
  * The number of particles in that bin is atomically incremented. If the addition of the particle will not overflow
  * the allocated memory, the particle is written into that bin. Otherwise, a flag is set to resize the cell list
  * and recompute. The MPCD particle's cell id is stashed into the velocity array.
@@ -47,9 +52,9 @@ namespace kernel
 __global__ void compute_cell_list(unsigned int *d_cell_np,
                                   unsigned int *d_cell_list,
                                   uint3 *d_conditions,
-                                  Scalar4 *d_vel,
+                                  mpcd::detail::vel_t *d_vel,
                                   unsigned int *d_embed_cell_ids,
-                                  const Scalar4 *d_pos,
+                                  mpcd::detail::pos_t *d_pos,
                                   const Scalar4 *d_pos_embed,
                                   const unsigned int *d_embed_member_idx,
                                   const uchar3 periodic,
@@ -62,23 +67,38 @@ __global__ void compute_cell_list(unsigned int *d_cell_np,
                                   const Index3D cell_indexer,
                                   const Index2D cell_list_indexer,
                                   const unsigned int N_mpcd,
-                                  const unsigned int N_tot)
+                                  const unsigned int N_tot,
+                                  const BoxDim box,
+                                  const mpcd::detail::PositionGrid pos_grid,
+                                  const Scalar stream_dt)
     {
     // one thread per particle
     unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
     if (idx >= N_tot)
         return;
 
-    Scalar4 postype_i;
+    Scalar3 pos_i;
     if (idx < N_mpcd)
         {
-        postype_i = d_pos[idx];
+        const mpcd::detail::pos_t postype_i = d_pos[idx];
+        pos_i = mpcd::detail::get_position(postype_i, pos_grid);
+
+        if (stream_dt != Scalar(0.0))
+            {
+            // propagate the particle to its new position ballistically
+            pos_i += stream_dt * mpcd::detail::get_velocity(d_vel[idx]);
+
+            // wrap and update the position
+            int3 image = make_int3(0,0,0);
+            box.wrap(pos_i, image);
+            d_pos[idx] = mpcd::detail::make_position(pos_i, mpcd::detail::get_type(postype_i), pos_grid);
+            }
         }
     else
         {
-        postype_i = d_pos_embed[d_embed_member_idx[idx - N_mpcd]];
+        const Scalar4 postype_i = d_pos_embed[d_embed_member_idx[idx - N_mpcd]];
+        pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
         }
-    const Scalar3 pos_i = make_scalar3(postype_i.x, postype_i.y, postype_i.z);
 
     if (isnan(pos_i.x) || isnan(pos_i.y) || isnan(pos_i.z))
         {
@@ -146,7 +166,7 @@ __global__ void compute_cell_list(unsigned int *d_cell_np,
     // stash the current particle bin into the velocity array
     if (idx < N_mpcd)
         {
-        d_vel[idx].w = __int_as_scalar(bin_idx);
+        mpcd::detail::set_cell(d_vel[idx], bin_idx);
         }
     else
         {
@@ -249,6 +269,9 @@ __global__ void cell_apply_sort(unsigned int *d_cell_list,
  * \param cell_list_indexer 2D indexer for particle position in cell
  * \param N_mpcd Number of MPCD particles
  * \param N_tot Total number of particle (MPCD + embedded)
+ * \param box Simulation box, used to wrap streamed particles
+ * \param pos_grid Grid for compact MPCD particle positions
+ * \param stream_dt Time to stream the MPCD particles ballistically before binning (0 to only bin)
  * \param block_size Number of threads per block
  *
  * \returns cudaSuccess on completion, or an error on failure
@@ -256,9 +279,9 @@ __global__ void cell_apply_sort(unsigned int *d_cell_list,
 cudaError_t mpcd::gpu::compute_cell_list(unsigned int *d_cell_np,
                                          unsigned int *d_cell_list,
                                          uint3 *d_conditions,
-                                         Scalar4 *d_vel,
+                                         mpcd::detail::vel_t *d_vel,
                                          unsigned int *d_embed_cell_ids,
-                                         const Scalar4 *d_pos,
+                                         mpcd::detail::pos_t *d_pos,
                                          const Scalar4 *d_pos_embed,
                                          const unsigned int *d_embed_member_idx,
                                          const uchar3& periodic,
@@ -272,6 +295,9 @@ cudaError_t mpcd::gpu::compute_cell_list(unsigned int *d_cell_np,
                                          const Index2D& cell_list_indexer,
                                          const unsigned int N_mpcd,
                                          const unsigned int N_tot,
+                                         const BoxDim& box,
+                                         const mpcd::detail::PositionGrid& pos_grid,
+                                         const Scalar stream_dt,
                                          const unsigned int block_size)
     {
     // set the number of particles in each cell to zero
@@ -307,7 +333,10 @@ cudaError_t mpcd::gpu::compute_cell_list(unsigned int *d_cell_np,
                                                                    cell_indexer,
                                                                    cell_list_indexer,
                                                                    N_mpcd,
-                                                                   N_tot);
+                                                                   N_tot,
+                                                                   box,
+                                                                   pos_grid,
+                                                                   stream_dt);
 
     return cudaSuccess;
     }
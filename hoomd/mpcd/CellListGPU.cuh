@@ -13,6 +13,8 @@
 
 #include <cuda_runtime.h>
 
+#include "ParticleDataUtilities.h"
+
 #include "hoomd/BoxDim.h"
 #include "hoomd/HOOMDMath.h"
 #include "hoomd/Index1D.h"
@@ -26,9 +28,9 @@ namespace gpu
 cudaError_t compute_cell_list(unsigned int *d_cell_np,
                               unsigned int *d_cell_list,
                               uint3 *d_conditions,
-                              Scalar4 *d_vel,
+                              mpcd::detail::vel_t *d_vel,
                               unsigned int *d_embed_cell_ids,
-                              const Scalar4 *d_pos,
+                              mpcd::detail::pos_t *d_pos,
                               const Scalar4 *d_pos_embed,
                               const unsigned int *d_embed_member_idx,
                               const uchar3& periodic,
@@ -42,6 +44,9 @@ cudaError_t compute_cell_list(unsigned int *d_cell_np,
                               const Index2D& cell_list_indexer,
                               const unsigned int N_mpcd,
                               const unsigned int N_tot,
+                              const BoxDim& box,
+                              const mpcd::detail::PositionGrid& pos_grid,
+                              const Scalar stream_dt,
                               const unsigned int block_size);
 
 //! Kernel driver to check if any embedded particles require migration
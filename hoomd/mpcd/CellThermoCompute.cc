@@ -21,7 +21,7 @@ mpcd::CellThermoCompute::CellThermoCompute(std::shared_ptr<mpcd::SystemData> sys
           m_mpcd_pdata(sysdata->getParticleData()),
           m_cl(sysdata->getCellList()),
           m_needs_net_reduce(true), m_cell_vel(m_exec_conf), m_cell_energy(m_exec_conf),
-          m_ncells_alloc(0), m_enable_log(true)
+          m_ncells_alloc(0), m_enable_log(true), m_pending(false), m_pending_timestep(0)
     {
     assert(m_mpcd_pdata);
     assert(m_cl);
@@ -54,28 +54,85 @@ mpcd::CellThermoCompute::CellThermoCompute(std::shared_ptr<mpcd::SystemData> sys
 mpcd::CellThermoCompute::~CellThermoCompute()
     {
     m_exec_conf->msg->notice(5) << "Destroying MPCD CellThermoCompute" << std::endl;
+    cancelCompute();
     }
 
 void mpcd::CellThermoCompute::compute(unsigned int timestep)
     {
+    // complete a calculation that was started ahead of time
+    if (m_pending)
+        {
+        if (m_pending_timestep == timestep)
+            {
+            if (m_prof) m_prof->push(m_exec_conf, "MPCD thermo");
+            finishCellProperties(timestep);
+            m_pending = false;
+            m_needs_net_reduce = true;
+            if (m_prof) m_prof->pop(m_exec_conf);
+            return;
+            }
+        else
+            {
+            cancelCompute();
+            }
+        }
+
     if (!shouldCompute(timestep)) return;
 
-    // cell list needs to be up to date first
-    m_cl->compute(timestep);
+    prepareCompute(timestep);
 
-    // ensure optional flags are up to date
-    updateFlags();
+    if (m_prof) m_prof->push(m_exec_conf, "MPCD thermo");
+    computeCellProperties(timestep);
+    m_needs_net_reduce = true;
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+/*!
+ * \param timestep Timestep to compute the cell properties for
+ *
+ * The cell properties are computed for \a timestep from the current MPCD particle
+ * data, and the reduction of the outer cells between ranks is posted without
+ * waiting for it. The calculation is completed by the next call to compute() at
+ * \a timestep, so other work (like the MD force computation) can be done while the
+ * messages are in flight. The caller must guarantee that the MPCD particles and their
+ * cell list do not change before then.
+ *
+ * Callbacks attached to getCallbackSignal() are deferred until compute() is called.
+ */
+void mpcd::CellThermoCompute::beginCompute(unsigned int timestep)
+    {
+    if (m_pending || !shouldCompute(timestep)) return;
+
+    prepareCompute(timestep);
 
     if (m_prof) m_prof->push(m_exec_conf, "MPCD thermo");
-    const unsigned int ncells = m_cl->getNCells();
-    if (ncells != m_ncells_alloc)
+    beginCellProperties();
+    m_pending = true;
+    m_pending_timestep = timestep;
+    if (m_prof) m_prof->pop(m_exec_conf);
+    }
+
+/*!
+ * Any communication that was posted by beginCompute() is completed, but the cell
+ * properties are discarded and recomputed on the next call to compute(). This should
+ * be used when the particle data may change before the calculation is completed,
+ * e.g., between runs.
+ */
+void mpcd::CellThermoCompute::cancelCompute()
+    {
+    if (!m_pending) return;
+
+    #ifdef ENABLE_MPI
+    if (m_use_mpi)
         {
-        reallocate(ncells);
+        if (m_flags[mpcd::detail::thermo_options::energy])
+            m_energy_comm->finalize(m_cell_energy, mpcd::detail::CellEnergyPackOp());
+        m_vel_comm->finalize(m_cell_vel, mpcd::detail::CellVelocityPackOp());
         }
+    #endif // ENABLE_MPI
 
-    computeCellProperties(timestep);
-    m_needs_net_reduce = true;
-    if (m_prof) m_prof->pop(m_exec_conf);
+    m_pending = false;
+    m_force_compute = true;
     }
 
 std::vector<std::string> mpcd::CellThermoCompute::getProvidedLogQuantities()
@@ -117,6 +174,12 @@ Scalar mpcd::CellThermoCompute::getLogValue(const std::string& quantity, unsigne
     }
 
 void mpcd::CellThermoCompute::computeCellProperties(unsigned int timestep)
+    {
+    beginCellProperties();
+    finishCellProperties(timestep);
+    }
+
+void mpcd::CellThermoCompute::beginCellProperties()
     {
     /*
      * In MPI simulations, begin by calculating the velocities and energies of
@@ -139,7 +202,13 @@ void mpcd::CellThermoCompute::computeCellProperties(unsigned int timestep)
      * on the inner cells. In non-MPI simulations, only this part happens.
      */
     calcInnerCellProperties();
+    }
 
+/*!
+ * \param timestep Current timestep
+ */
+void mpcd::CellThermoCompute::finishCellProperties(unsigned int timestep)
+    {
     /*
      * Execute any additional callbacks that can be overlapped with outer communication.
      */
@@ -160,6 +229,12 @@ void mpcd::CellThermoCompute::computeCellProperties(unsigned int timestep)
         finishOuterCellProperties();
         }
     #endif // ENABLE_MPI
+
+    /*
+     * Virtual particles are added to the reduced cells, so that each rank sharing a cell adds the same ones.
+     */
+    if (m_filler)
+        m_filler->fill(timestep, m_cell_vel, m_cell_energy, m_flags[mpcd::detail::thermo_options::energy]);
     }
 
 namespace mpcd
@@ -188,7 +263,7 @@ struct CellPropertySum
     CellPropertySum(const unsigned int *cell_list_,
                     const unsigned int *cell_np_,
                     const Index2D& cli_,
-                    const Scalar4 *vel_,
+                    const mpcd::detail::vel_t *vel_,
                     const Scalar mass_,
                     const Scalar4 *embed_vel_,
                     const unsigned int *embed_idx_,
@@ -219,7 +294,7 @@ struct CellPropertySum
             double mass_i;
             if (cur_p < N_mpcd)
                 {
-                Scalar4 vel_cell = vel[cur_p];
+                mpcd::detail::vel_t vel_cell = vel[cur_p];
                 vel_i = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
                 mass_i = mass;
                 }
@@ -246,7 +321,7 @@ struct CellPropertySum
     const unsigned int *cell_np;    //!< Number of particles per cell
     const Index2D cli;              //!< Cell list indexer
 
-    const Scalar4 *vel;             //!< MPCD particle velocities
+    const mpcd::detail::vel_t *vel; //!< MPCD particle velocities
     const Scalar mass;              //!< MPCD particle mass
     const Scalar4 *embed_vel;       //!< Embedded particle velocities
     const unsigned int *embed_idx;  //!< Embedded particle indexes
@@ -264,7 +339,7 @@ void mpcd::CellThermoCompute::beginOuterCellProperties()
     const Index2D& cli = m_cl->getCellListIndexer();
 
     // MPCD particle data
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::detail::vel_t> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
     const Scalar mpcd_mass = m_mpcd_pdata->getMass();
     const unsigned int N_mpcd = m_mpcd_pdata->getN();
 
@@ -358,7 +433,7 @@ void mpcd::CellThermoCompute::calcInnerCellProperties()
     // MPCD particle data
     const unsigned int N_mpcd = m_mpcd_pdata->getN();
     const Scalar mpcd_mass = m_mpcd_pdata->getMass();
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::detail::vel_t> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
 
     // Embedded particle data
     std::unique_ptr< ArrayHandle<Scalar4> > h_embed_vel;
@@ -498,6 +573,16 @@ void mpcd::CellThermoCompute::computeNetProperties()
                 }
             }
 
+        // remove the virtual particles from the net properties
+        if (m_filler)
+            {
+            const double4 virtual_net = m_filler->getNetProperties(upper);
+            net_momentum.x -= virtual_net.x;
+            net_momentum.y -= virtual_net.y;
+            net_momentum.z -= virtual_net.z;
+            energy -= virtual_net.w;
+            }
+
         ArrayHandle<double> h_net_properties(m_net_properties, access_location::host, access_mode::overwrite);
         h_net_properties.data[mpcd::detail::thermo_index::momentum_x] = net_momentum.x;
         h_net_properties.data[mpcd::detail::thermo_index::momentum_y] = net_momentum.y;
@@ -558,6 +643,24 @@ void mpcd::CellThermoCompute::reallocate(unsigned int ncells)
     m_ncells_alloc = ncells;
     }
 
+/*!
+ * \param timestep Current timestep
+ */
+void mpcd::CellThermoCompute::prepareCompute(unsigned int timestep)
+    {
+    // cell list needs to be up to date first
+    m_cl->compute(timestep);
+
+    // ensure optional flags are up to date
+    updateFlags();
+
+    const unsigned int ncells = m_cl->getNCells();
+    if (ncells != m_ncells_alloc)
+        {
+        reallocate(ncells);
+        }
+    }
+
 /*!
  * \param m Python module
  */
@@ -569,5 +672,7 @@ void mpcd::detail::export_CellThermoCompute(pybind11::module& m)
         (m, "CellThermoCompute", py::base<Compute>())
         .def(py::init< std::shared_ptr<mpcd::SystemData> >())
         .def(py::init< std::shared_ptr<mpcd::SystemData>, const std::string& >())
-        .def("enableLogging", &mpcd::CellThermoCompute::enableLogging);
+        .def("enableLogging", &mpcd::CellThermoCompute::enableLogging)
+        .def("setVirtualFiller", &mpcd::CellThermoCompute::setVirtualFiller)
+        .def("removeVirtualFiller", &mpcd::CellThermoCompute::removeVirtualFiller);
     }
@@ -18,6 +18,7 @@
 #include "CellThermoTypes.h"
 #include "CellList.h"
 #include "SystemData.h"
+#include "VirtualCellFiller.h"
 #ifdef ENABLE_MPI
 #include "CellCommunicator.h"
 #endif // ENABLE_MPI
@@ -42,6 +43,12 @@ class PYBIND11_EXPORT CellThermoCompute : public Compute
         //! Compute the cell thermodynamic properties
         void compute(unsigned int timestep);
 
+        //! Start computing the cell thermodynamic properties ahead of compute()
+        void beginCompute(unsigned int timestep);
+
+        //! Discard cell properties started with beginCompute()
+        void cancelCompute();
+
         //! Get the cell indexer for the attached cell list
         const Index3D& getCellIndexer() const
             {
@@ -109,6 +116,28 @@ class PYBIND11_EXPORT CellThermoCompute : public Compute
             if (m_energy_comm)
                 m_energy_comm->setAutotunerParams(enable, period);
             #endif // ENABLE_MPI
+            if (m_filler)
+                m_filler->setAutotunerParams(enable, period);
+            }
+
+        //! Add virtual particles to the cells that are cut by a surface
+        /*!
+         * \param filler Virtual particle filler
+         *
+         * The virtual particles are included in the cell velocities and energies, but not
+         * in the net momentum and energy.
+         */
+        void setVirtualFiller(std::shared_ptr<mpcd::VirtualCellFiller> filler)
+            {
+            m_filler = filler;
+            m_force_compute = true;
+            }
+
+        //! Remove the virtual particle filler
+        void removeVirtualFiller()
+            {
+            m_filler = std::shared_ptr<mpcd::VirtualCellFiller>();
+            m_force_compute = true;
             }
 
         //! Enable / disable logging
@@ -150,6 +179,12 @@ class PYBIND11_EXPORT CellThermoCompute : public Compute
         //! Compute the cell properties
         void computeCellProperties(unsigned int timestep);
 
+        //! Start the calculation of the cell properties
+        void beginCellProperties();
+
+        //! Finish the calculation of the cell properties
+        void finishCellProperties(unsigned int timestep);
+
         #ifdef ENABLE_MPI
         //! Begin the calculation of outer cell properties
         virtual void beginOuterCellProperties();
@@ -189,9 +224,17 @@ class PYBIND11_EXPORT CellThermoCompute : public Compute
 
         Nano::Signal<void (unsigned int)> m_callbacks;  //!< Signal for callback functions
 
+        std::shared_ptr<mpcd::VirtualCellFiller> m_filler;  //!< Virtual particles for cells cut by a surface
+
+        bool m_pending;                 //!< Flag if cell properties were started by beginCompute()
+        unsigned int m_pending_timestep;    //!< Timestep of the pending cell properties
+
     private:
         //! Allocate memory per cell
         void reallocate(unsigned int ncells);
+
+        //! Prepare the cell list, flags, and memory for a calculation
+        void prepareCompute(unsigned int timestep);
     };
 
 namespace detail
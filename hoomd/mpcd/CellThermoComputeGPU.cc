@@ -49,7 +49,7 @@ void mpcd::CellThermoComputeGPU::beginOuterCellProperties()
     ArrayHandle<unsigned int> d_cell_np(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_cell_list(m_cl->getCellList(), access_location::device, access_mode::read);
 
-    ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
+    ArrayHandle<mpcd::detail::vel_t> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
 
     if (m_cl->getEmbeddedGroup())
         {
@@ -135,7 +135,7 @@ void mpcd::CellThermoComputeGPU::calcInnerCellProperties()
     ArrayHandle<unsigned int> d_cell_np(m_cl->getCellSizeArray(), access_location::device, access_mode::read);
     ArrayHandle<unsigned int> d_cell_list(m_cl->getCellList(), access_location::device, access_mode::read);
 
-    ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
+    ArrayHandle<mpcd::detail::vel_t> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
 
     /*
      * Determine the inner cell indexer and offset. The inner indexer is the cube containing
@@ -229,6 +229,7 @@ void mpcd::CellThermoComputeGPU::computeNetProperties()
     {
     if (m_prof) m_prof->push(m_exec_conf, "MPCD thermo");
     // first reduce the properties on the rank
+    double4 virtual_net = make_double4(0.0, 0.0, 0.0, 0.0);
         {
         const Index3D& ci = m_cl->getCellIndexer();
         uint3 upper = make_uint3(ci.getW(), ci.getH(), ci.getD());
@@ -243,6 +244,10 @@ void mpcd::CellThermoComputeGPU::computeNetProperties()
             }
         #endif // ENABLE_MPI
 
+        // virtual particles are removed from the net properties
+        if (m_filler)
+            virtual_net = m_filler->getNetProperties(upper);
+
         // temporary cell indexer for mapping 1d kernel threads to 3d grid
         const Index3D tmp_ci(upper.x, upper.y, upper.z);
         m_tmp_thermo.resize(tmp_ci.getNumElements());
@@ -290,11 +295,11 @@ void mpcd::CellThermoComputeGPU::computeNetProperties()
         const mpcd::detail::cell_thermo_element reduced = m_reduced.readFlags();
 
         ArrayHandle<double> h_net_properties(m_net_properties, access_location::host, access_mode::overwrite);
-        h_net_properties.data[mpcd::detail::thermo_index::momentum_x] = reduced.momentum.x;
-        h_net_properties.data[mpcd::detail::thermo_index::momentum_y] = reduced.momentum.y;
-        h_net_properties.data[mpcd::detail::thermo_index::momentum_z] = reduced.momentum.z;
+        h_net_properties.data[mpcd::detail::thermo_index::momentum_x] = reduced.momentum.x - virtual_net.x;
+        h_net_properties.data[mpcd::detail::thermo_index::momentum_y] = reduced.momentum.y - virtual_net.y;
+        h_net_properties.data[mpcd::detail::thermo_index::momentum_z] = reduced.momentum.z - virtual_net.z;
 
-        h_net_properties.data[mpcd::detail::thermo_index::energy] = reduced.energy;
+        h_net_properties.data[mpcd::detail::thermo_index::energy] = reduced.energy - virtual_net.w;
         h_net_properties.data[mpcd::detail::thermo_index::temperature] = reduced.temperature;
 
         n_temp_cells = reduced.flag;
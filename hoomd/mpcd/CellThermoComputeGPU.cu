@@ -55,7 +55,7 @@ __global__ void begin_cell_thermo(double4 *d_cell_vel,
                                   const unsigned int *d_cell_np,
                                   const unsigned int *d_cell_list,
                                   const Index2D cli,
-                                  const Scalar4 *d_vel,
+                                  const mpcd::detail::vel_t *d_vel,
                                   const unsigned int N_mpcd,
                                   const Scalar mpcd_mass,
                                   const Scalar4 *d_embed_vel,
@@ -80,7 +80,7 @@ __global__ void begin_cell_thermo(double4 *d_cell_vel,
         double mass_i;
         if (cur_p < N_mpcd)
             {
-            Scalar4 vel_cell = d_vel[cur_p];
+            mpcd::detail::vel_t vel_cell = d_vel[cur_p];
             vel_i = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
             mass_i = mpcd_mass;
             }
@@ -217,7 +217,7 @@ __global__ void inner_cell_thermo(double4 *d_cell_vel,
                                   const unsigned int *d_cell_np,
                                   const unsigned int *d_cell_list,
                                   const Index2D cli,
-                                  const Scalar4 *d_vel,
+                                  const mpcd::detail::vel_t *d_vel,
                                   const unsigned int N_mpcd,
                                   const Scalar mpcd_mass,
                                   const Scalar4 *d_embed_vel,
@@ -248,7 +248,7 @@ __global__ void inner_cell_thermo(double4 *d_cell_vel,
         double mass_i;
         if (cur_p < N_mpcd)
             {
-            Scalar4 vel_cell = d_vel[cur_p];
+            mpcd::detail::vel_t vel_cell = d_vel[cur_p];
             vel_i = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
             mass_i = mpcd_mass;
             }
@@ -64,6 +64,23 @@ bool mpcd::CollisionMethod::peekCollide(unsigned int timestep) const
         return ((timestep - m_next_timestep) % m_period == 0);
     }
 
+/*!
+ * \param timestep Timestep of the collision
+ *
+ * If a collision will occur at \a timestep, its grid shift is drawn and the calculation
+ * of the cell properties is started, so that their communication can overlap with other
+ * work. The collision is completed by collide() at \a timestep. The MPCD particles must
+ * already have been streamed to their positions at \a timestep. Nothing is started if
+ * particles are embedded, since their velocities are not final until the end of the MD step.
+ */
+void mpcd::CollisionMethod::beginCollide(unsigned int timestep)
+    {
+    if (!peekCollide(timestep) || m_embed_group) return;
+
+    drawGridShift(timestep);
+    beginCellProperties(timestep);
+    }
+
 /*!
  * \param cur_timestep Current simulation timestep
  * \param period New period
@@ -117,32 +134,53 @@ bool mpcd::CollisionMethod::shouldCollide(unsigned int timestep)
  *
  * \post The MPCD cell list has its grid shift set for \a timestep.
  *
+ * \sa computeGridShift
+ */
+void mpcd::CollisionMethod::drawGridShift(unsigned int timestep)
+    {
+    m_cl->setGridShift(computeGridShift(timestep));
+    }
+
+/*!
+ * \param timestep Timestep to compute shifting for
+ * \returns The grid shift vector for \a timestep
+ *
  * If grid shifting is enabled, three uniform random numbers are drawn using
  * the Mersenne twister generator. (In two dimensions, only two numbers are drawn.)
  *
- * If grid shifting is disabled, a zero vector is instead set.
+ * If grid shifting is disabled, a zero vector is instead returned.
  */
-void mpcd::CollisionMethod::drawGridShift(unsigned int timestep)
+Scalar3 mpcd::CollisionMethod::computeGridShift(unsigned int timestep) const
     {
     // return zeros if shifting is off
     if (!m_enable_grid_shift)
         {
-        m_cl->setGridShift(make_scalar3(0.0,0.0,0.0));
+        return make_scalar3(0.0,0.0,0.0);
         }
-    else
-        {
-        // Saru PRNG using seed and timestep as seeds
-        hoomd::detail::Saru saru(0xffffffff, timestep / m_period, m_seed);
-        const Scalar max_shift = m_cl->getMaxGridShift();
 
-        // draw shift variables from uniform distribution
-        Scalar3 shift;
-        shift.x = saru.s(-max_shift, max_shift);
-        shift.y = saru.s(-max_shift, max_shift);
-        shift.z = (m_sysdef->getNDimensions() == 3) ? saru.s(-max_shift, max_shift) : Scalar(0.0);
+    // Saru PRNG using seed and timestep as seeds
+    hoomd::detail::Saru saru(0xffffffff, timestep / m_period, m_seed);
+    const Scalar max_shift = m_cl->getMaxGridShift();
 
-        m_cl->setGridShift(shift);
-        }
+    // draw shift variables from uniform distribution
+    Scalar3 shift;
+    shift.x = saru.s(-max_shift, max_shift);
+    shift.y = saru.s(-max_shift, max_shift);
+    shift.z = (m_sysdef->getNDimensions() == 3) ? saru.s(-max_shift, max_shift) : Scalar(0.0);
+
+    return shift;
+    }
+
+/*!
+ * \param timestep Current timestep
+ * \returns The first timestep after \a timestep at which peekCollide() is true
+ */
+unsigned int mpcd::CollisionMethod::getNextCollision(unsigned int timestep) const
+    {
+    if (timestep < m_next_timestep)
+        return m_next_timestep;
+    else
+        return m_next_timestep + ((timestep - m_next_timestep) / m_period + 1) * m_period;
     }
 
 /*!
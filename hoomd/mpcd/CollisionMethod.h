@@ -40,6 +40,12 @@ class PYBIND11_EXPORT CollisionMethod
         //! Peek if a collision will occur on this timestep
         virtual bool peekCollide(unsigned int timestep) const;
 
+        //! Start the collision of a later timestep ahead of time
+        void beginCollide(unsigned int timestep);
+
+        //! Discard the work started by beginCollide()
+        virtual void cancelCollide() { }
+
         //! Sets the profiler for the integration method to use
         void setProfiler(std::shared_ptr<Profiler> prof)
             {
@@ -67,6 +73,12 @@ class PYBIND11_EXPORT CollisionMethod
         //! Generates the random grid shift vector
         void drawGridShift(unsigned int timestep);
 
+        //! Compute the grid shift vector for a timestep without setting it
+        Scalar3 computeGridShift(unsigned int timestep) const;
+
+        //! Get the first timestep after \a timestep that a collision will occur
+        unsigned int getNextCollision(unsigned int timestep) const;
+
         //! Sets a group of particles that is coupled to the MPCD solvent through the collision step
         /*!
          * \param embed_group Group to embed
@@ -98,6 +110,9 @@ class PYBIND11_EXPORT CollisionMethod
         //! Check if a collision should occur and advance the timestep counter
         virtual bool shouldCollide(unsigned int timestep);
 
+        //! Start the calculation of the cell properties used by the collision rule
+        virtual void beginCellProperties(unsigned int timestep) { }
+
         bool m_enable_grid_shift;   //!< Flag to enable grid shifting
     };
 
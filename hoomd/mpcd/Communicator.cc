@@ -234,11 +234,22 @@ void mpcd::Communicator::migrateParticles(unsigned int timestep)
 
     // determine local particles that are to be sent to neighboring processors
     const BoxDim& box = m_mpcd_sys->getCellList()->getCoverageBox();
-    setCommFlags(box);
+    const unsigned int local_flags = setCommFlags(box);
 
-    // fill send buffer once
+    // nothing to do if no particle left its domain
+    const unsigned int req_flags = reduceCommFlags(local_flags);
+    if (!req_flags)
+        {
+        if (m_prof) m_prof->pop();
+        return;
+        }
+
+    // fill send buffer once, leaving the particle data untouched if no particle left this rank
     if (m_prof) m_prof->push("pack");
-    m_mpcd_pdata->removeParticles(m_sendbuf, 0xffffffff, timestep);
+    if (local_flags)
+        m_mpcd_pdata->removeParticles(m_sendbuf, 0xffffffff, timestep);
+    else
+        m_sendbuf.resize(0);
     if (m_prof) m_prof->pop();
 
     // fill the buffers and send in each direction
@@ -251,6 +262,9 @@ void mpcd::Communicator::migrateParticles(unsigned int timestep)
         const unsigned int left_mask =  1 << (2*dim+1);
         const unsigned int stage_mask = right_mask | left_mask;
 
+        // no rank sends along this dimension
+        if (!(req_flags & stage_mask)) continue;
+
         // neighbor ranks
         const unsigned int right_neigh = m_decomposition->getNeighborRank(2*dim);
         const unsigned int left_neigh = m_decomposition->getNeighborRank(2*dim+1);
@@ -368,7 +382,8 @@ void mpcd::Communicator::migrateParticles(unsigned int timestep)
         }
 
     // this mask will totally unset any bits that could still be set (there should be none)
-    m_mpcd_pdata->addParticles(m_recvbuf, 0xffffffff, timestep);
+    if (n_recv > 0)
+        m_mpcd_pdata->addParticles(m_recvbuf, 0xffffffff, timestep);
     if (m_prof) m_prof->pop();
 
     if (m_prof) m_prof->pop();
@@ -377,24 +392,27 @@ void mpcd::Communicator::migrateParticles(unsigned int timestep)
 /*!
  * \param box Bounding box
  *
+ * \returns Bitwise OR of the communication flags of all local particles
+ *
  * Particles lying outside of \a box have their communication flags set along
  * that face.
  */
-void mpcd::Communicator::setCommFlags(const BoxDim& box)
+unsigned int mpcd::Communicator::setCommFlags(const BoxDim& box)
     {
     if (m_prof) m_prof->push("comm flags");
     // mark all particles which have left the box for sending
     unsigned int N = m_mpcd_pdata->getN();
-    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::detail::pos_t> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_comm_flag(m_mpcd_pdata->getCommFlags(), access_location::host, access_mode::overwrite);
+    const mpcd::detail::PositionGrid& pos_grid = m_mpcd_pdata->getPositionGrid();
 
     // since box is orthorhombic, just use branching to compute comm flags
     const Scalar3 lo = box.getLo();
     const Scalar3 hi = box.getHi();
+    unsigned int req_flags = 0;
     for (unsigned int idx = 0; idx < N; ++idx)
         {
-        const Scalar4& postype = h_pos.data[idx];
-        const Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
+        const Scalar3 pos = mpcd::detail::get_position(h_pos.data[idx], pos_grid);
 
         unsigned int flags = 0;
         if (pos.x >= hi.x) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::east);
@@ -407,9 +425,25 @@ void mpcd::Communicator::setCommFlags(const BoxDim& box)
         else if (pos.z < lo.z) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::down);
 
         h_comm_flag.data[idx] = flags;
+        req_flags |= flags;
         }
 
     if (m_prof) m_prof->pop();
+    return req_flags;
+    }
+
+/*!
+ * \param local_flags Communication flags requested by this rank
+ * \returns Bitwise OR of the communication flags requested by all ranks
+ *
+ * This is a collective call, so every rank makes the same decision to skip
+ * migration or one of its stages.
+ */
+unsigned int mpcd::Communicator::reduceCommFlags(unsigned int local_flags)
+    {
+    unsigned int req_flags = local_flags;
+    MPI_Allreduce(MPI_IN_PLACE, &req_flags, 1, MPI_UNSIGNED, MPI_BOR, m_mpi_comm);
+    return req_flags;
     }
 
 /*!
@@ -118,6 +118,8 @@ class PYBIND11_EXPORT Communicator
          * are added to the local particle data, and are also considered for forwarding to a neighbor
          * in the subsequent communication steps.
          *
+         * Migration is skipped entirely when no particle on any rank has left its domain.
+         *
          * \post Every particle on every processor can be found inside the local domain boundaries.
          */
         virtual void migrateParticles(unsigned int timestep);
@@ -126,7 +128,10 @@ class PYBIND11_EXPORT Communicator
 
     protected:
         //! Set the communication flags for the particle data
-        virtual void setCommFlags(const BoxDim& box);
+        virtual unsigned int setCommFlags(const BoxDim& box);
+
+        //! Reduce the requested communication flags over all ranks
+        unsigned int reduceCommFlags(unsigned int local_flags);
 
         //! Checks for overdecomposition
         void checkDecomposition();
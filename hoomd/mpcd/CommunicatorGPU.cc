@@ -28,19 +28,30 @@ mpcd::CommunicatorGPU::CommunicatorGPU(std::shared_ptr<mpcd::SystemData> system_
       m_max_stages(1),
       m_num_stages(0),
       m_comm_mask(0),
-      m_tmp_keys(m_exec_conf)
+      m_req_flags(m_exec_conf),
+      m_send_records(m_exec_conf),
+      m_recv_records(m_exec_conf)
     {
+    #ifdef ENABLE_MPI_CUDA
+    m_cuda_aware_mpi = true;
+    #else
+    m_cuda_aware_mpi = false;
+    #endif
+
     // initialize communication stages
     initializeCommunicationStages();
 
-    GPUArray<unsigned int> neigh_send(neigh_max,m_exec_conf);
-    m_neigh_send.swap(neigh_send);
+    GPUArray<unsigned int> dir_neigh(neigh_max,m_exec_conf);
+    m_dir_neigh.swap(dir_neigh);
+    initializeDirectionNeighbors();
 
     GPUArray<unsigned int> num_send(neigh_max,m_exec_conf);
     m_num_send.swap(num_send);
 
     // autotuners
     m_flags_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_comm_flags", m_exec_conf));
+    m_pack_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_comm_pack", m_exec_conf));
+    m_unpack_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_comm_unpack", m_exec_conf));
     }
 
 mpcd::CommunicatorGPU::~CommunicatorGPU()
@@ -158,6 +169,47 @@ void mpcd::CommunicatorGPU::initializeCommunicationStages()
         << " communication stage(s)." << std::endl;
     }
 
+/*!
+ * The send buffer is packed by the unique neighbor index, so each of the 27 directions
+ * (encoded the same way as the adjacency masks) is mapped onto the index of the
+ * neighbor that lies in that direction. Directions that are not communicated map
+ * onto the first neighbor and are never used.
+ */
+void mpcd::CommunicatorGPU::initializeDirectionNeighbors()
+    {
+    const Index3D& di = m_decomposition->getDomainIndexer();
+    const uint3 mypos = m_decomposition->getGridPos();
+
+    ArrayHandle<unsigned int> h_dir_neigh(m_dir_neigh, access_location::host, access_mode::overwrite);
+    ArrayHandle<unsigned int> h_cart_ranks(m_decomposition->getCartRanks(), access_location::host, access_mode::read);
+    for (int iz=-1; iz <= 1; ++iz)
+        {
+        const unsigned int k = (mypos.z + di.getD() + iz) % di.getD();
+        for (int iy=-1; iy <= 1; ++iy)
+            {
+            const unsigned int j = (mypos.y + di.getH() + iy) % di.getH();
+            for (int ix=-1; ix <= 1; ++ix)
+                {
+                const unsigned int i = (mypos.x + di.getW() + ix) % di.getW();
+
+                const unsigned int dir = ((iz+1)*3+(iy+1))*3+(ix+1);
+                auto it = m_unique_neigh_map.find(h_cart_ranks.data[di(i,j,k)]);
+                h_dir_neigh.data[dir] = (it != m_unique_neigh_map.end()) ? it->second : 0;
+                }
+            }
+        }
+    }
+
+/*!
+ * \param timestep Current timestep
+ *
+ * The particles sent in each stage are packed on the GPU into compact records
+ * (mpcd::detail::migrate_element) that are grouped by neighbor, so that every
+ * neighbor is sent one contiguous message. With a CUDA-aware MPI, the records are
+ * sent and received directly from device memory. A stage is skipped if no rank
+ * sends in its directions, and the whole migration is skipped if no particle has
+ * left its domain.
+ */
 void mpcd::CommunicatorGPU::migrateParticles(unsigned int timestep)
     {
     if (m_prof) m_prof->push("migrate");
@@ -169,55 +221,67 @@ void mpcd::CommunicatorGPU::migrateParticles(unsigned int timestep)
 
     // determine local particles that are to be sent to neighboring processors
     const BoxDim& box = m_mpcd_sys->getCellList()->getCoverageBox();
-    setCommFlags(box);
+    unsigned int local_flags = setCommFlags(box);
+
+    // nothing to do if no particle left its domain
+    const unsigned int req_flags = reduceCommFlags(local_flags);
+    if (!req_flags)
+        {
+        if (m_prof) m_prof->pop();
+        return;
+        }
 
+    const BoxDim wrap_box = getWrapBox(box);
     for (unsigned int stage = 0; stage < m_num_stages; stage++)
         {
         const unsigned int comm_mask = m_comm_mask[stage];
 
-        // fill send buffer
+        // no rank sends in the directions of this stage
+        if (!(req_flags & comm_mask)) continue;
+
+        // directions that received particles may still need to be sent in
+        unsigned int later_mask = 0;
+        for (unsigned int next = stage+1; next < m_num_stages; ++next)
+            later_mask |= m_comm_mask[next];
+
+        // fill send buffer, leaving the particle data untouched if no particle leaves in this stage
         if (m_prof) m_prof->push(m_exec_conf,"pack");
-        m_mpcd_pdata->removeParticlesGPU(m_sendbuf, comm_mask, timestep);
-        if (m_prof) m_prof->pop(m_exec_conf);
+        if (local_flags & comm_mask)
+            m_mpcd_pdata->removeParticlesGPU(m_sendbuf, comm_mask, timestep);
+        else
+            m_sendbuf.resize(0);
 
-        if (m_prof) m_prof->push("sort");
-        // pack the buffers for each neighbor rank in this stage
+        // pack the compact records of each neighbor rank in this stage
         std::fill(m_n_send_ptls.begin(), m_n_send_ptls.end(), 0);
+        m_send_records.resize(m_sendbuf.size());
         if (m_sendbuf.size() > 0)
             {
-            m_tmp_keys.resize(m_sendbuf.size());
-
-            // sort the send buffer on the gpu
-            unsigned int num_send_neigh(0);
                 {
-                ArrayHandle<mpcd::detail::pdata_element> d_sendbuf(m_sendbuf, access_location::device, access_mode::readwrite);
-                ArrayHandle<unsigned int> d_neigh_send(m_neigh_send, access_location::device, access_mode::overwrite);
+                ArrayHandle<mpcd::detail::migrate_element> d_send_records(m_send_records, access_location::device, access_mode::overwrite);
                 ArrayHandle<unsigned int> d_num_send(m_num_send, access_location::device, access_mode::overwrite);
-                ArrayHandle<unsigned int> d_tmp_keys(m_tmp_keys, access_location::device, access_mode::overwrite);
-                ArrayHandle<unsigned int> d_cart_ranks(m_decomposition->getCartRanks(), access_location::device, access_mode::read);
-
-                num_send_neigh = mpcd::gpu::sort_comm_send_buffer(d_sendbuf.data,
-                                                                  d_neigh_send.data,
-                                                                  d_num_send.data,
-                                                                  d_tmp_keys.data,
-                                                                  m_decomposition->getGridPos(),
-                                                                  m_decomposition->getDomainIndexer(),
-                                                                  m_comm_mask[stage],
-                                                                  d_cart_ranks.data,
-                                                                  m_sendbuf.size());
+                ArrayHandle<mpcd::detail::pdata_element> d_sendbuf(m_sendbuf, access_location::device, access_mode::read);
+                ArrayHandle<unsigned int> d_dir_neigh(m_dir_neigh, access_location::device, access_mode::read);
+
+                m_pack_tuner->begin();
+                mpcd::gpu::pack_send_buffer(d_send_records.data,
+                                            d_num_send.data,
+                                            d_sendbuf.data,
+                                            d_dir_neigh.data,
+                                            comm_mask,
+                                            m_n_unique_neigh,
+                                            m_sendbuf.size(),
+                                            m_exec_conf->getCachedAllocator(),
+                                            m_pack_tuner->getParam());
+                if (m_exec_conf->isCUDAErrorCheckingEnabled())
+                    CHECK_CUDA_ERROR();
+                m_pack_tuner->end();
                 }
 
             // fill the number of particles to send for each neighbor
-            ArrayHandle<unsigned int> h_neigh_send(m_neigh_send, access_location::host, access_mode::read);
             ArrayHandle<unsigned int> h_num_send(m_num_send, access_location::host, access_mode::read);
-            ArrayHandle<unsigned int> h_unique_neighbors(m_unique_neighbors, access_location::host, access_mode::read);
-            for (unsigned int i=0; i < num_send_neigh; ++i)
-                {
-                const unsigned int neigh = m_unique_neigh_map.find(h_neigh_send.data[i])->second;
-                m_n_send_ptls[neigh] = h_num_send.data[i];
-                }
+            std::copy(h_num_send.data, h_num_send.data + m_n_unique_neigh, m_n_send_ptls.begin());
             }
-        if (m_prof) m_prof->pop();
+        if (m_prof) m_prof->pop(m_exec_conf);
 
         // communicate total number of particles being sent and received from neighbor ranks
         unsigned int n_recv_tot = 0;
@@ -253,16 +317,24 @@ void mpcd::CommunicatorGPU::migrateParticles(unsigned int timestep)
             }
 
         // Resize particles from neighbor ranks
-        m_recvbuf.resize(n_recv_tot);
+        m_recv_records.resize(n_recv_tot);
             {
+            if (m_prof) m_prof->push(m_exec_conf, "MPI send/recv");
             ArrayHandle<unsigned int> h_unique_neighbors(m_unique_neighbors, access_location::host, access_mode::read);
-            ArrayHandle<mpcd::detail::pdata_element> h_sendbuf(m_sendbuf, access_location::host, access_mode::read);
-            ArrayHandle<mpcd::detail::pdata_element> h_recvbuf(m_recvbuf, access_location::host, access_mode::overwrite);
+
+            const access_location::Enum mpi_loc = (m_cuda_aware_mpi) ? access_location::device : access_location::host;
+            ArrayHandle<mpcd::detail::migrate_element> send_records_handle(m_send_records, mpi_loc, access_mode::read);
+            ArrayHandle<mpcd::detail::migrate_element> recv_records_handle(m_recv_records, mpi_loc, access_mode::overwrite);
+
+            // MPI library may use non-zero stream
+            if (m_cuda_aware_mpi)
+                cudaDeviceSynchronize();
 
             // loop over neighbors
             unsigned int nreq = 0;
             m_reqs.resize(2*m_n_unique_neigh);
             unsigned int sendidx = 0;
+            unsigned int n_send_tot = 0;
             for (unsigned int ineigh = 0; ineigh < m_n_unique_neigh; ++ineigh)
                 {
                 // rank of neighbor processor
@@ -271,8 +343,8 @@ void mpcd::CommunicatorGPU::migrateParticles(unsigned int timestep)
                 // exchange particle data
                 if (m_n_send_ptls[ineigh])
                     {
-                    MPI_Isend(h_sendbuf.data+sendidx,
-                        m_n_send_ptls[ineigh]*sizeof(mpcd::detail::pdata_element),
+                    MPI_Isend(send_records_handle.data+sendidx,
+                        m_n_send_ptls[ineigh]*sizeof(mpcd::detail::migrate_element),
                         MPI_BYTE,
                         neighbor,
                         1,
@@ -285,37 +357,51 @@ void mpcd::CommunicatorGPU::migrateParticles(unsigned int timestep)
 
                 if (m_n_recv_ptls[ineigh])
                     {
-                    MPI_Irecv(h_recvbuf.data+m_offsets[ineigh],
-                        m_n_recv_ptls[ineigh]*sizeof(mpcd::detail::pdata_element),
+                    MPI_Irecv(recv_records_handle.data+m_offsets[ineigh],
+                        m_n_recv_ptls[ineigh]*sizeof(mpcd::detail::migrate_element),
                         MPI_BYTE,
                         neighbor,
                         1,
                         m_mpi_comm,
                         &m_reqs[nreq++]);
                     }
+                n_send_tot += m_n_send_ptls[ineigh];
                 }
 
             MPI_Waitall(nreq, m_reqs.data(), MPI_STATUSES_IGNORE);
+
+            if (m_cuda_aware_mpi)
+                cudaDeviceSynchronize();
+            if (m_prof) m_prof->pop(m_exec_conf, 0, (n_send_tot+n_recv_tot)*sizeof(mpcd::detail::migrate_element));
             }
 
-        // wrap received particles through the global boundary
-        if (m_prof) m_prof->push(m_exec_conf, "wrap");
+        // nothing more to do on this rank if no particles were received
+        if (n_recv_tot == 0) continue;
+
+        // wrap received particles through the global boundary and flag them for the later stages
+        if (m_prof) m_prof->push(m_exec_conf, "unpack");
+        m_recvbuf.resize(n_recv_tot);
             {
-            ArrayHandle<mpcd::detail::pdata_element> d_recvbuf(m_recvbuf, access_location::device, access_mode::readwrite);
-            const BoxDim wrap_box = getWrapBox(box);
-            mpcd::gpu::wrap_particles(n_recv_tot,
-                                      d_recvbuf.data,
-                                      wrap_box);
+            ArrayHandle<mpcd::detail::pdata_element> d_recvbuf(m_recvbuf, access_location::device, access_mode::overwrite);
+            ArrayHandle<mpcd::detail::migrate_element> d_recv_records(m_recv_records, access_location::device, access_mode::read);
+
+            m_unpack_tuner->begin();
+            mpcd::gpu::unpack_recv_buffer(d_recvbuf.data,
+                                          d_recv_records.data,
+                                          n_recv_tot,
+                                          wrap_box,
+                                          box,
+                                          later_mask,
+                                          m_unpack_tuner->getParam());
             if (m_exec_conf->isCUDAErrorCheckingEnabled())
                 CHECK_CUDA_ERROR();
+            m_unpack_tuner->end();
             }
-        if (m_prof) m_prof->pop(m_exec_conf);
 
         // fill particle data with received particles
-        if (m_prof) m_prof->push(m_exec_conf, "unpack");
         m_mpcd_pdata->addParticlesGPU(m_recvbuf, comm_mask, timestep);
+        local_flags |= later_mask;
         if (m_prof) m_prof->pop(m_exec_conf);
-
         } // end communication stage
 
     if (m_prof) m_prof->pop();
@@ -324,27 +410,48 @@ void mpcd::CommunicatorGPU::migrateParticles(unsigned int timestep)
 /*!
  * \param box Bounding box
  *
+ * \returns Bitwise OR of the communication flags of all local particles
+ *
  * Particles lying outside of \a box have their communication flags set along
  * that face.
  */
-void mpcd::CommunicatorGPU::setCommFlags(const BoxDim& box)
+unsigned int mpcd::CommunicatorGPU::setCommFlags(const BoxDim& box)
     {
+    const unsigned int N = m_mpcd_pdata->getN();
+    if (N == 0) return 0;
+
     if (m_prof) m_prof->push(m_exec_conf, "comm flags");
 
     ArrayHandle<unsigned int> d_comm_flag(m_mpcd_pdata->getCommFlags(), access_location::device, access_mode::overwrite);
-    ArrayHandle<Scalar4> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::read);
-
-    m_flags_tuner->begin();
-    mpcd::gpu::stage_particles(d_comm_flag.data,
-                               d_pos.data,
-                               m_mpcd_pdata->getN(),
-                               box,
-                               m_flags_tuner->getParam());
-    if (m_exec_conf->isCUDAErrorCheckingEnabled())
-        CHECK_CUDA_ERROR();
-    m_flags_tuner->end();
+        {
+        ArrayHandle<mpcd::detail::pos_t> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::read);
+
+        m_flags_tuner->begin();
+        mpcd::gpu::stage_particles(d_comm_flag.data,
+                                   d_pos.data,
+                                   N,
+                                   box,
+                                   m_mpcd_pdata->getPositionGrid(),
+                                   m_flags_tuner->getParam());
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        m_flags_tuner->end();
+        }
+
+    // reduce the flags to find the directions any particle is sent in
+        {
+        void *d_tmp = NULL;
+        size_t tmp_bytes = 0;
+        mpcd::gpu::reduce_comm_flags(m_req_flags.getDeviceFlags(), d_tmp, tmp_bytes, d_comm_flag.data, N);
+        ScopedAllocation<unsigned char> d_tmp_alloc(m_exec_conf->getCachedAllocator(), (tmp_bytes > 0) ? tmp_bytes : 1);
+        d_tmp = (void*)d_tmp_alloc();
+        mpcd::gpu::reduce_comm_flags(m_req_flags.getDeviceFlags(), d_tmp, tmp_bytes, d_comm_flag.data, N);
+        if (m_exec_conf->isCUDAErrorCheckingEnabled())
+            CHECK_CUDA_ERROR();
+        }
 
     if (m_prof) m_prof->pop(m_exec_conf);
+    return m_req_flags.readFlags();
     }
 
 /*!
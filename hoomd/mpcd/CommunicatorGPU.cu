@@ -14,12 +14,7 @@
 #include "CommunicatorUtilities.h"
 #include "ReductionOperators.h"
 
-#include <thrust/device_ptr.h>
-#include <thrust/reduce.h>
-#include <thrust/sort.h>
-#include <thrust/transform.h>
-
-#include "hoomd/extern/cub/cub/device/device_reduce.cuh"
+#include "hoomd/extern/cub/cub/cub.cuh"
 
 namespace mpcd
 {
@@ -27,117 +22,147 @@ namespace gpu
 {
 namespace kernel
 {
+//! Compute the communication flags of a position
+/*!
+ * \param pos Particle position
+ * \param lo Lower bound of the local box
+ * \param hi Upper bound of the local box
+ *
+ * \returns Flags of the faces of the box that the particle has crossed
+ */
+__device__ __forceinline__ unsigned int get_comm_flags(const Scalar3& pos, const Scalar3& lo, const Scalar3& hi)
+    {
+    unsigned int flags = 0;
+    if (pos.x >= hi.x) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::east);
+    else if (pos.x < lo.x) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::west);
+    if (pos.y >= hi.y) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::north);
+    else if (pos.y < lo.y) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::south);
+    if (pos.z >= hi.z) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::up);
+    else if (pos.z < lo.z) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::down);
+    return flags;
+    }
+
 //! Select a particle for migration
 /*!
  * \param d_comm_flag Communication flags to write out
  * \param d_pos Device array of particle positions
  * \param N Number of local particles
  * \param box Local box
+ * \param pos_grid Grid for compact positions
  *
  * Checks for particles being out of bounds, and aggregates send flags.
  */
 __global__ void stage_particles(unsigned int *d_comm_flag,
-                                const Scalar4 *d_pos,
+                                const mpcd::detail::pos_t *d_pos,
                                 unsigned int N,
-                                const BoxDim box)
+                                const BoxDim box,
+                                const mpcd::detail::PositionGrid pos_grid)
     {
     const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
     if (idx >= N) return;
 
-    const Scalar4 postype = d_pos[idx];
-    const Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
-    const Scalar3 lo = box.getLo();
-    const Scalar3 hi = box.getHi();
-
-    unsigned int flags = 0;
-    if (pos.x >= hi.x) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::east);
-    else if (pos.x < lo.x) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::west);
-    if (pos.y >= hi.y) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::north);
-    else if (pos.y < lo.y) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::south);
-    if (pos.z >= hi.z) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::up);
-    else if (pos.z < lo.z) flags |= static_cast<unsigned int>(mpcd::detail::send_mask::down);
-
-    d_comm_flag[idx] = flags;
+    const Scalar3 pos = mpcd::detail::get_position(d_pos[idx], pos_grid);
+    d_comm_flag[idx] = get_comm_flags(pos, box.getLo(), box.getHi());
     }
-} // end namespace kernel
 
-//! Functor to select a particle for migration
-struct get_migrate_key : public thrust::unary_function<const unsigned int, unsigned int>
+//! Find the neighbor that each particle in the send buffer is sent to
+/*!
+ * \param d_keys Index of the neighbor of each particle (output)
+ * \param d_idx Index of each particle in the send buffer (output)
+ * \param d_num_send Number of particles sent to each neighbor (accumulated)
+ * \param d_sendbuf Send buffer
+ * \param d_dir_neigh Neighbor index of each of the 27 directions
+ * \param mask Sending mask for the current stage
+ * \param Nsend Number of particles in the send buffer
+ *
+ * The direction is the neighbor offset (-1, 0, or 1) along each dimension that
+ * is allowed by \a mask, encoded the same way as the adjacency masks.
+ */
+__global__ void get_send_keys(unsigned int *d_keys,
+                              unsigned int *d_idx,
+                              unsigned int *d_num_send,
+                              const mpcd::detail::pdata_element *d_sendbuf,
+                              const unsigned int *d_dir_neigh,
+                              const unsigned int mask,
+                              const unsigned int Nsend)
     {
-    const uint3 my_pos;      //!< My domain decomposition position
-    const Index3D di;        //!< Domain indexer
-    const unsigned int mask; //!< Mask of allowed directions
-    const unsigned int *cart_ranks; //!< Rank lookup table
-
-    //! Constructor
-    /*!
-     * \param _my_pos Domain decomposition position
-     * \param _di Domain indexer
-     * \param _mask Mask of allowed directions
-     * \param _cart_ranks Rank lookup table
-     */
-    get_migrate_key(const uint3 _my_pos, const Index3D _di, const unsigned int _mask,
-        const unsigned int *_cart_ranks)
-        : my_pos(_my_pos), di(_di), mask(_mask), cart_ranks(_cart_ranks)
-        { }
-
-    //! Generate key for a sent particle
-    /*!
-     * \param element Particle data being sent
-     */
-    __device__ __forceinline__ unsigned int operator()(const mpcd::detail::pdata_element& element)
-        {
-        const unsigned int flags = element.comm_flag;
-        int ix, iy, iz;
-        ix = iy = iz = 0;
-
-        if ((flags & static_cast<unsigned int>(mpcd::detail::send_mask::east)) &&
-            (mask & static_cast<unsigned int>(mpcd::detail::send_mask::east)))
-            ix = 1;
-        else if ((flags & static_cast<unsigned int>(mpcd::detail::send_mask::west)) &&
-                 (mask & static_cast<unsigned int>(mpcd::detail::send_mask::west)))
-            ix = -1;
-
-        if ((flags & static_cast<unsigned int>(mpcd::detail::send_mask::north)) &&
-            (mask & static_cast<unsigned int>(mpcd::detail::send_mask::north)))
-            iy = 1;
-        else if ((flags & static_cast<unsigned int>(mpcd::detail::send_mask::south)) &&
-                 (mask & static_cast<unsigned int>(mpcd::detail::send_mask::south)))
-            iy = -1;
-
-        if ((flags & static_cast<unsigned int>(mpcd::detail::send_mask::up)) &&
-            (mask & static_cast<unsigned int>(mpcd::detail::send_mask::up)))
-            iz = 1;
-        else if ((flags & static_cast<unsigned int>(mpcd::detail::send_mask::down)) &&
-                 (mask & static_cast<unsigned int>(mpcd::detail::send_mask::down)))
-            iz = -1;
-
-        int i = my_pos.x;
-        int j = my_pos.y;
-        int k = my_pos.z;
-
-        i += ix;
-        if (i == (int)di.getW())
-            i = 0;
-        else if (i < 0)
-            i += di.getW();
-
-        j += iy;
-        if (j == (int)di.getH())
-            j = 0;
-        else if (j < 0)
-            j += di.getH();
+    const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= Nsend) return;
+
+    const unsigned int flags = d_sendbuf[idx].comm_flag & mask;
+    int ix = 0, iy = 0, iz = 0;
+    if (flags & static_cast<unsigned int>(mpcd::detail::send_mask::east)) ix = 1;
+    else if (flags & static_cast<unsigned int>(mpcd::detail::send_mask::west)) ix = -1;
+    if (flags & static_cast<unsigned int>(mpcd::detail::send_mask::north)) iy = 1;
+    else if (flags & static_cast<unsigned int>(mpcd::detail::send_mask::south)) iy = -1;
+    if (flags & static_cast<unsigned int>(mpcd::detail::send_mask::up)) iz = 1;
+    else if (flags & static_cast<unsigned int>(mpcd::detail::send_mask::down)) iz = -1;
+
+    const unsigned int neigh = d_dir_neigh[((iz+1)*3+(iy+1))*3+(ix+1)];
+    d_keys[idx] = neigh;
+    d_idx[idx] = idx;
+    atomicAdd(d_num_send + neigh, 1);
+    }
 
-        k += iz;
-        if (k == (int)di.getD())
-            k = 0;
-        else if (k < 0)
-            k += di.getD();
+//! Gather the sorted send buffer into compact records
+/*!
+ * \param d_out Compact records (output)
+ * \param d_sendbuf Send buffer
+ * \param d_idx Index in the send buffer of each record
+ * \param Nsend Number of particles in the send buffer
+ */
+__global__ void gather_send_buffer(mpcd::detail::migrate_element *d_out,
+                                   const mpcd::detail::pdata_element *d_sendbuf,
+                                   const unsigned int *d_idx,
+                                   const unsigned int Nsend)
+    {
+    const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= Nsend) return;
+
+    const mpcd::detail::pdata_element p = d_sendbuf[d_idx[idx]];
+    mpcd::detail::migrate_element e;
+    e.pos = make_scalar3(p.pos.x, p.pos.y, p.pos.z);
+    e.vel = make_scalar3(p.vel.x, p.vel.y, p.vel.z);
+    e.type = __scalar_as_int(p.pos.w);
+    e.tag = p.tag;
+    d_out[idx] = e;
+    }
 
-        return cart_ranks[di(i,j,k)];
-        }
-     };
+//! Unpack received compact records
+/*!
+ * \param d_out Particle data elements (output)
+ * \param d_in Received compact records
+ * \param N Number of received particles
+ * \param wrap_box Box to wrap the particles through the global boundary
+ * \param box Local box
+ * \param mask Directions that are still to be communicated
+ *
+ * The particles are wrapped into \a wrap_box, and their communication flags are
+ * recomputed against \a box for the directions in \a mask. The cell index is unset.
+ */
+__global__ void unpack_recv_buffer(mpcd::detail::pdata_element *d_out,
+                                   const mpcd::detail::migrate_element *d_in,
+                                   const unsigned int N,
+                                   const BoxDim wrap_box,
+                                   const BoxDim box,
+                                   const unsigned int mask)
+    {
+    const unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= N) return;
 
+    const mpcd::detail::migrate_element e = d_in[idx];
+    Scalar3 pos = e.pos;
+    int3 image = make_int3(0,0,0);
+    wrap_box.wrap(pos, image);
+
+    mpcd::detail::pdata_element p;
+    p.pos = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(e.type));
+    p.vel = make_scalar4(e.vel.x, e.vel.y, e.vel.z, __int_as_scalar(mpcd::detail::NO_CELL));
+    p.tag = e.tag;
+    p.comm_flag = get_comm_flags(pos, box.getLo(), box.getHi()) & mask;
+    d_out[idx] = p;
+    }
+} // end namespace kernel
 } // end namespace gpu
 } // end namespace mpcd
 
@@ -146,13 +171,16 @@ struct get_migrate_key : public thrust::unary_function<const unsigned int, unsig
  * \param d_pos Device array of particle positions
  * \param N Number of local particles
  * \param box Local box
+ * \param pos_grid Grid for compact positions
+ * \param block_size Number of threads per block
  *
  * \returns Accumulated communication flags of all particles
  */
 cudaError_t mpcd::gpu::stage_particles(unsigned int *d_comm_flag,
-                                        const Scalar4 *d_pos,
+                                        const mpcd::detail::pos_t *d_pos,
                                         const unsigned int N,
                                         const BoxDim& box,
+                                        const mpcd::detail::PositionGrid& pos_grid,
                                         const unsigned int block_size)
     {
     static unsigned int max_block_size = UINT_MAX;
@@ -167,57 +195,91 @@ cudaError_t mpcd::gpu::stage_particles(unsigned int *d_comm_flag,
     mpcd::gpu::kernel::stage_particles<<<grid, run_block_size>>>(d_comm_flag,
                                                                  d_pos,
                                                                  N,
-                                                                 box);
+                                                                 box,
+                                                                 pos_grid);
 
     return cudaSuccess;
     }
 
 /*!
- * \param d_sendbuf Particle data buffer to sort
- * \param d_neigh_send Neighbor ranks that particles are being sent to (output)
- * \param d_num_send Number of particles being sent to each neighbor
- * \param d_tmp_keys Temporary array (size \a Nsend) used for sorting
- * \param grid_pos Grid position of the rank
- * \param di Domain decomposition indexer
+ * \param d_out Compact records grouped by neighbor (output)
+ * \param d_num_send Number of particles sent to each neighbor (output)
+ * \param d_sendbuf Send buffer
+ * \param d_dir_neigh Neighbor index of each of the 27 directions
  * \param mask Sending mask for the current stage
- * \param d_cart_ranks Cartesian array of domains
- * \param Nsend Number of particles in send buffer
- *
- * \returns The number of unique neighbor ranks to send to
+ * \param n_neigh Number of unique neighbors
+ * \param Nsend Number of particles in the send buffer
+ * \param alloc Caching allocator for temporary storage
+ * \param block_size Number of threads per block
  *
- * The communication flags in \a d_sendbuf are first transformed into a destination
- * rank (see mpcd::gpu::get_migrate_key). The send buffer is then sorted using
- * the destination rank as the key. Run-length encoding is then performed to
- * determine the number of particles going to each destination rank, and how
- * many ranks will be sent to.
+ * The communication flags in \a d_sendbuf are transformed into the index of the
+ * destination neighbor, which is counted for every neighbor. The indexes of the
+ * particles are then radix sorted by neighbor, using only as many bits as there are
+ * neighbors, and the particles are gathered into \a d_out so that the records of each
+ * neighbor are contiguous in the order of the unique neighbors. The sort is stable,
+ * so the order of the records does not depend on the order of the counting.
  */
-size_t mpcd::gpu::sort_comm_send_buffer(mpcd::detail::pdata_element *d_sendbuf,
-                                        unsigned int *d_neigh_send,
+cudaError_t mpcd::gpu::pack_send_buffer(mpcd::detail::migrate_element *d_out,
                                         unsigned int *d_num_send,
-                                        unsigned int *d_tmp_keys,
-                                        const uint3 grid_pos,
-                                        const Index3D& di,
+                                        const mpcd::detail::pdata_element *d_sendbuf,
+                                        const unsigned int *d_dir_neigh,
                                         const unsigned int mask,
-                                        const unsigned int *d_cart_ranks,
-                                        const unsigned int Nsend)
+                                        const unsigned int n_neigh,
+                                        const unsigned int Nsend,
+                                        CachedAllocator& alloc,
+                                        const unsigned int block_size)
     {
-    // transform extracted communication flags into destination rank
-    thrust::device_ptr<mpcd::detail::pdata_element> sendbuf(d_sendbuf);
-    thrust::device_ptr<unsigned int> keys(d_tmp_keys);
-    thrust::transform(sendbuf, sendbuf + Nsend, keys, mpcd::gpu::get_migrate_key(grid_pos, di, mask, d_cart_ranks));
+    cudaMemset(d_num_send, 0, sizeof(unsigned int)*n_neigh);
+    if (Nsend == 0) return cudaSuccess;
 
-    // sort the destination ranks
-    thrust::sort_by_key(keys, keys + Nsend, sendbuf);
+    unsigned int *d_keys = alloc.getTemporaryBuffer<unsigned int>(Nsend);
+    unsigned int *d_idx = alloc.getTemporaryBuffer<unsigned int>(Nsend);
+    unsigned int *d_sorted_keys = alloc.getTemporaryBuffer<unsigned int>(Nsend);
+    unsigned int *d_sorted_idx = alloc.getTemporaryBuffer<unsigned int>(Nsend);
 
-    // run length encode to get the number going to each rank
-    thrust::device_ptr<unsigned int> neigh_send(d_neigh_send);
-    thrust::device_ptr<unsigned int> num_send(d_num_send);
-    size_t num_neigh = thrust::reduce_by_key(keys, keys + Nsend,
-                                             thrust::constant_iterator<int>(1),
-                                             neigh_send,
-                                             num_send).first - neigh_send;
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::get_send_keys);
+        max_block_size = attr.maxThreadsPerBlock;
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::gather_send_buffer);
+        max_block_size = min(max_block_size, (unsigned int)attr.maxThreadsPerBlock);
+        }
+    unsigned int run_block_size = min(block_size, max_block_size);
+    dim3 grid(Nsend / run_block_size + 1);
+    mpcd::gpu::kernel::get_send_keys<<<grid, run_block_size>>>(d_keys,
+                                                               d_idx,
+                                                               d_num_send,
+                                                               d_sendbuf,
+                                                               d_dir_neigh,
+                                                               mask,
+                                                               Nsend);
+
+    // only the bits of the neighbor indexes need to be sorted
+    int end_bit = 1;
+    while ((1u << end_bit) < n_neigh) ++end_bit;
+
+    void *d_tmp = NULL;
+    size_t tmp_bytes = 0;
+    cub::DeviceRadixSort::SortPairs(d_tmp, tmp_bytes, d_keys, d_sorted_keys,
+        d_idx, d_sorted_idx, Nsend, 0, end_bit);
+    d_tmp = alloc.allocate(tmp_bytes);
+    cub::DeviceRadixSort::SortPairs(d_tmp, tmp_bytes, d_keys, d_sorted_keys,
+        d_idx, d_sorted_idx, Nsend, 0, end_bit);
+    alloc.deallocate((char *) d_tmp);
+
+    mpcd::gpu::kernel::gather_send_buffer<<<grid, run_block_size>>>(d_out,
+                                                                    d_sendbuf,
+                                                                    d_sorted_idx,
+                                                                    Nsend);
+
+    alloc.deallocate((char *) d_sorted_idx);
+    alloc.deallocate((char *) d_sorted_keys);
+    alloc.deallocate((char *) d_idx);
+    alloc.deallocate((char *) d_keys);
 
-    return num_neigh;
+    return cudaSuccess;
     }
 
 /*!
@@ -244,53 +306,41 @@ void mpcd::gpu::reduce_comm_flags(unsigned int *d_req_flags,
     cub::DeviceReduce::Reduce(d_tmp, tmp_bytes, d_comm_flags, d_req_flags, N, bit_or, (unsigned int)0);
     }
 
-namespace mpcd
-{
-namespace gpu
-{
-//! Wrap a particle in a pdata_element
-struct wrap_particle_op : public thrust::unary_function<const mpcd::detail::pdata_element, mpcd::detail::pdata_element>
+/*!
+ * \param d_out Particle data elements (output)
+ * \param d_in Received compact records
+ * \param N Number of received particles
+ * \param wrap_box Box to wrap the particles through the global boundary
+ * \param box Local box
+ * \param mask Directions that are still to be communicated
+ * \param block_size Number of threads per block
+ */
+cudaError_t mpcd::gpu::unpack_recv_buffer(mpcd::detail::pdata_element *d_out,
+                                          const mpcd::detail::migrate_element *d_in,
+                                          const unsigned int N,
+                                          const BoxDim& wrap_box,
+                                          const BoxDim& box,
+                                          const unsigned int mask,
+                                          const unsigned int block_size)
     {
-    const BoxDim box; //!< The box for which we are applying boundary conditions
+    if (N == 0) return cudaSuccess;
 
-    //! Constructor
-    /*!
-     * \param _box Shifted simulation box for wrapping
-     */
-    wrap_particle_op(const BoxDim _box)
-        : box(_box)
-        {
-        }
-
-    //! Wrap position information inside particle data element
-    /*!
-     * \param p Particle data element
-     * \returns The particle data element with wrapped coordinates
-     */
-    __device__ mpcd::detail::pdata_element operator()(const mpcd::detail::pdata_element p)
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
         {
-        mpcd::detail::pdata_element ret = p;
-        int3 image = make_int3(0,0,0);
-        box.wrap(ret.pos, image);
-        return ret;
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::unpack_recv_buffer);
+        max_block_size = attr.maxThreadsPerBlock;
         }
-     };
-} // end namespace gpu
-} // end namespace mpcd
-
-/*!
- * \param n_recv Number of particles in buffer
- * \param d_in Buffer of particle data elements
- * \param box Box for which to apply boundary conditions
- */
-void mpcd::gpu::wrap_particles(const unsigned int n_recv,
-                               mpcd::detail::pdata_element *d_in,
-                               const BoxDim& box)
-    {
-    // Wrap device ptr
-    thrust::device_ptr<mpcd::detail::pdata_element> in_ptr(d_in);
+    unsigned int run_block_size = min(block_size, max_block_size);
+    dim3 grid(N / run_block_size + 1);
+    mpcd::gpu::kernel::unpack_recv_buffer<<<grid, run_block_size>>>(d_out,
+                                                                    d_in,
+                                                                    N,
+                                                                    wrap_box,
+                                                                    box,
+                                                                    mask);
 
-    // Apply box wrap to input buffer
-    thrust::transform(in_ptr, in_ptr + n_recv, in_ptr, mpcd::gpu::wrap_particle_op(box));
+    return cudaSuccess;
     }
 #endif // ENABLE_MPI
@@ -9,8 +9,10 @@
  */
 
 #ifdef ENABLE_MPI
+#include "CommunicatorUtilities.h"
 #include "ParticleDataUtilities.h"
 #include "hoomd/BoxDim.h"
+#include "hoomd/CachedAllocator.h"
 #include "hoomd/Index1D.h"
 
 namespace mpcd
@@ -19,21 +21,22 @@ namespace gpu
 {
 //! Mark particles that have left the local box for sending
 cudaError_t stage_particles(unsigned int *d_comm_flag,
-                            const Scalar4 *d_pos,
+                            const mpcd::detail::pos_t *d_pos,
                             const unsigned int n,
                             const BoxDim& box,
+                            const mpcd::detail::PositionGrid& pos_grid,
                             const unsigned int block_size);
 
-//! Sort the particle send buffer on the GPU
-size_t sort_comm_send_buffer(mpcd::detail::pdata_element *d_sendbuf,
-                             unsigned int *d_neigh_send,
+//! Pack the particle send buffer into compact records grouped by neighbor on the GPU
+cudaError_t pack_send_buffer(mpcd::detail::migrate_element *d_out,
                              unsigned int *d_num_send,
-                             unsigned int *d_tmp_keys,
-                             const uint3 grid_pos,
-                             const Index3D& di,
+                             const mpcd::detail::pdata_element *d_sendbuf,
+                             const unsigned int *d_dir_neigh,
                              const unsigned int mask,
-                             const unsigned int *d_cart_ranks,
-                             const unsigned int Nsend);
+                             const unsigned int n_neigh,
+                             const unsigned int Nsend,
+                             CachedAllocator& alloc,
+                             const unsigned int block_size);
 
 //! Reduce communication flags with bitwise OR using the CUB library
 void reduce_comm_flags(unsigned int *d_req_flags,
@@ -42,10 +45,14 @@ void reduce_comm_flags(unsigned int *d_req_flags,
                        const unsigned int *d_comm_flags,
                        const unsigned int N);
 
-//! Apply boundary conditions
-void wrap_particles(const unsigned int n_recv,
-                    mpcd::detail::pdata_element *d_in,
-                    const BoxDim& box);
+//! Unpack received compact records into particle data elements on the GPU
+cudaError_t unpack_recv_buffer(mpcd::detail::pdata_element *d_out,
+                               const mpcd::detail::migrate_element *d_in,
+                               const unsigned int N,
+                               const BoxDim& wrap_box,
+                               const BoxDim& box,
+                               const unsigned int mask,
+                               const unsigned int block_size);
 } // end namespace gpu
 } // end namespace mpcd
 
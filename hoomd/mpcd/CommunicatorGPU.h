@@ -77,11 +77,15 @@ class PYBIND11_EXPORT CommunicatorGPU : public mpcd::Communicator
         virtual void setAutotunerParams(bool enable, unsigned int period)
             {
             Communicator::setAutotunerParams(enable, period);
+
+            m_flags_tuner->setEnabled(enable); m_flags_tuner->setPeriod(period);
+            m_pack_tuner->setEnabled(enable); m_pack_tuner->setPeriod(period);
+            m_unpack_tuner->setEnabled(enable); m_unpack_tuner->setPeriod(period);
             }
 
     protected:
         //! Set the communication flags for the particle data on the GPU
-        virtual void setCommFlags(const BoxDim& box);
+        virtual unsigned int setCommFlags(const BoxDim& box);
 
     private:
         /* General communication */
@@ -91,18 +95,26 @@ class PYBIND11_EXPORT CommunicatorGPU : public mpcd::Communicator
         std::vector<int> m_stages;                     //!< Communication stage per unique neighbor
 
         /* Particle migration */
-        GPUArray<unsigned int> m_neigh_send;            //!< Neighbor rank indexes for sending
-        GPUArray<unsigned int> m_num_send;              //!< Number of particles to send to each rank
-        GPUVector<unsigned int> m_tmp_keys;             //!< Temporary keys for sorting particles
+        GPUArray<unsigned int> m_dir_neigh;             //!< Unique neighbor index of each of the 27 directions
+        GPUArray<unsigned int> m_num_send;              //!< Number of particles to send to each unique neighbor
+        GPUFlags<unsigned int> m_req_flags;             //!< Reduced communication flags of the local particles
+        GPUVector<mpcd::detail::migrate_element> m_send_records;    //!< Compact records of sent particles
+        GPUVector<mpcd::detail::migrate_element> m_recv_records;    //!< Compact records of received particles
         std::vector<unsigned int> m_n_send_ptls;        //!< Number of particles sent per neighbor
         std::vector<unsigned int> m_n_recv_ptls;        //!< Number of particles received per neighbor
         std::vector<unsigned int> m_offsets;            //!< Offsets for particle send buffers
+        bool m_cuda_aware_mpi;                          //!< True if MPI can send directly from device memory
 
         //! Helper function to set up communication stages
         void initializeCommunicationStages();
 
+        //! Helper function to map the directions onto the unique neighbors
+        void initializeDirectionNeighbors();
+
         /* Autotuners */
         std::unique_ptr<Autotuner> m_flags_tuner;   //!< Tuner for marking communication flags
+        std::unique_ptr<Autotuner> m_pack_tuner;    //!< Tuner for packing the send buffer
+        std::unique_ptr<Autotuner> m_unpack_tuner;  //!< Tuner for unpacking the receive buffer
     };
 
 namespace detail
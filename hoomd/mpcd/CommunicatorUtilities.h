@@ -12,6 +12,8 @@
 #ifndef MPCD_COMMUNICATOR_UTILITIES_H_
 #define MPCD_COMMUNICATOR_UTILITIES_H_
 
+#include "hoomd/HOOMDMath.h"
+
 namespace mpcd
 {
 namespace detail
@@ -37,6 +39,20 @@ enum struct send_mask : unsigned int
     down = 32
     };
 
+//! Compact record of a migrating particle
+/*!
+ * mpcd::CommunicatorGPU sends this record instead of the full mpcd::detail::pdata_element.
+ * The cell index and the communication flags are not sent because the receiving rank
+ * recomputes both, and the type is stored as an integer rather than packed into a Scalar4.
+ */
+struct migrate_element
+    {
+    Scalar3 pos;        //!< Position
+    Scalar3 vel;        //!< Velocity
+    unsigned int type;  //!< Type
+    unsigned int tag;   //!< Global tag
+    };
+
 } // end namespace detail
 } // end namespace mpcd
 
@@ -0,0 +1,317 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/ConfinedStreamingMethod.h
+ * \brief Declaration of mpcd::ConfinedStreamingMethod
+ */
+
+#ifndef MPCD_CONFINED_STREAMING_METHOD_H_
+#define MPCD_CONFINED_STREAMING_METHOD_H_
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "StreamingMethod.h"
+#include "StreamingGeometry.h"
+#include "hoomd/extern/pybind/include/pybind11/pybind11.h"
+
+namespace mpcd
+{
+
+//! MPCD confined streaming method
+/*!
+ * This method implements the ballistic propagation of MPCD particles in a confined geometry. The particles are
+ * propagated for the full MPCD time step, and they are reflected from the surface of the \a Geometry with its
+ * boundary condition whenever they cross it. The \a Geometry must supply the methods described in
+ * mpcd/BoundaryGeometry.h.
+ *
+ * Most particles are far from the surface and cannot reach it during one streaming step. To keep them on the
+ * same fast path as in mpcd::StreamingMethod, the cells of the unshifted MPCD grid are flagged in
+ * mpcd::CellList::getBoundaryFlags() if the cell, grown by one cell width on every side, overlaps the boundary.
+ * A particle in a cell that is not flagged, and that moves at most one cell width along each direction, stays in
+ * the fluid and is streamed without testing the geometry. All other particles are tested for collisions. The flags
+ * are recomputed whenever the cell list dimensions or the geometry change.
+ */
+template<class Geometry>
+class PYBIND11_EXPORT ConfinedStreamingMethod : public mpcd::StreamingMethod
+    {
+    public:
+        //! Constructor
+        /*!
+         * \param sysdata MPCD system data
+         * \param cur_timestep Current system timestep
+         * \param period Number of timesteps between collisions
+         * \param phase Phase shift for periodic updates
+         * \param geom Streaming geometry
+         */
+        ConfinedStreamingMethod(std::shared_ptr<mpcd::SystemData> sysdata,
+                                unsigned int cur_timestep,
+                                unsigned int period,
+                                int phase,
+                                std::shared_ptr<const Geometry> geom)
+            : mpcd::StreamingMethod(sysdata, cur_timestep, period, phase),
+              m_geom(geom), m_validate_geom(true), m_flags_tag(0)
+            {
+            m_pdata->getBoxChangeSignal().template connect<mpcd::ConfinedStreamingMethod<Geometry>,
+                &mpcd::ConfinedStreamingMethod<Geometry>::requestValidate>(this);
+            }
+
+        //! Destructor
+        virtual ~ConfinedStreamingMethod()
+            {
+            m_pdata->getBoxChangeSignal().template disconnect<mpcd::ConfinedStreamingMethod<Geometry>,
+                &mpcd::ConfinedStreamingMethod<Geometry>::requestValidate>(this);
+            }
+
+        //! Implementation of the streaming rule
+        virtual void stream(unsigned int timestep);
+
+        //! Stream the particles and build the cell list for a later timestep in one pass
+        /*!
+         * \returns False, since the collisions with the boundary are not handled by the cell list build
+         */
+        virtual bool streamCellList(unsigned int timestep, unsigned int cell_timestep, const Scalar3& grid_shift)
+            {
+            return false;
+            }
+
+        //! Get the streaming geometry
+        std::shared_ptr<const Geometry> getGeometry() const
+            {
+            return m_geom;
+            }
+
+        //! Set the streaming geometry
+        void setGeometry(std::shared_ptr<const Geometry> geom)
+            {
+            m_geom = geom;
+            m_validate_geom = true;
+            m_flags_tag = 0;
+            }
+
+    protected:
+        std::shared_ptr<const Geometry> m_geom; //!< Streaming geometry
+        bool m_validate_geom;                   //!< If true, run a validation check on the geometry
+        unsigned int m_flags_tag;               //!< Tag of the boundary flags computed for the geometry
+
+        //! Validate the system with the streaming geometry
+        void validate();
+
+        //! Check that the boundary flags of the cell list are current, and compute them if not
+        void checkBoundaryFlags();
+
+        //! Compute the boundary flags of the cells
+        virtual void computeBoundaryFlags();
+
+    private:
+        //! Slot to request a validation check of the geometry when the box changes
+        void requestValidate()
+            {
+            m_validate_geom = true;
+            }
+    };
+
+/*!
+ * \param timestep Current time to stream
+ */
+template<class Geometry>
+void ConfinedStreamingMethod<Geometry>::stream(unsigned int timestep)
+    {
+    if (!shouldStream(timestep)) return;
+
+    if (m_validate_geom)
+        {
+        validate();
+        m_validate_geom = false;
+        }
+    checkBoundaryFlags();
+
+    if (m_prof) m_prof->push("MPCD stream");
+
+    std::shared_ptr<mpcd::CellList> cl = m_mpcd_sys->getCellList();
+    const BoxDim& box = cl->getCoverageBox();
+    const Index3D& ci = cl->getCellIndexer();
+    const uint3 dim = cl->getDim();
+    const Scalar cell_size = cl->getCellSize();
+    const int3 origin_idx = cl->getOriginIndex();
+    const Scalar3 origin = m_pdata->getGlobalBox().getLo()
+                           + cell_size*make_scalar3(origin_idx.x, origin_idx.y, origin_idx.z);
+    const Geometry& geom = *m_geom;
+
+    ArrayHandle<mpcd::detail::pos_t> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::detail::vel_t> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<unsigned int> h_flags(cl->getBoundaryFlags(), access_location::host, access_mode::read);
+    const mpcd::detail::PositionGrid& pos_grid = m_mpcd_pdata->getPositionGrid();
+
+    for (unsigned int cur_p = 0; cur_p < m_mpcd_pdata->getN(); ++cur_p)
+        {
+        const mpcd::detail::pos_t postype = h_pos.data[cur_p];
+        Scalar3 pos = mpcd::detail::get_position(postype, pos_grid);
+        const unsigned int type = mpcd::detail::get_type(postype);
+
+        const mpcd::detail::vel_t vel_cell = h_vel.data[cur_p];
+        Scalar3 vel = mpcd::detail::get_velocity(vel_cell);
+
+        // find the cell of the unshifted grid, positions at the edges of the grid are clamped into it
+        const Scalar3 delta = (pos - origin)/cell_size;
+        const int3 bin = make_int3(std::max(0, std::min((int)dim.x-1, (int)std::floor(delta.x))),
+                                   std::max(0, std::min((int)dim.y-1, (int)std::floor(delta.y))),
+                                   std::max(0, std::min((int)dim.z-1, (int)std::floor(delta.z))));
+
+        // a particle in a bulk cell that moves less than a cell width cannot reach the boundary
+        if (!h_flags.data[ci(bin.x, bin.y, bin.z)] &&
+            std::fabs(vel.x)*m_mpcd_dt <= cell_size &&
+            std::fabs(vel.y)*m_mpcd_dt <= cell_size &&
+            std::fabs(vel.z)*m_mpcd_dt <= cell_size)
+            {
+            pos += m_mpcd_dt * vel;
+            }
+        else
+            {
+            // propagate the particle to its new position, reflecting it from the boundary as many times as needed
+            Scalar dt_remain = m_mpcd_dt;
+            bool collide = true;
+            do
+                {
+                pos += dt_remain * vel;
+                collide = geom.detectCollision(pos, vel, dt_remain);
+                }
+            while (dt_remain > 0 && collide);
+            }
+
+        // wrap and update the position
+        int3 image = make_int3(0,0,0);
+        box.wrap(pos, image);
+
+        h_pos.data[cur_p] = mpcd::detail::make_position(pos, type, pos_grid);
+        h_vel.data[cur_p] = mpcd::detail::make_velocity(vel, mpcd::detail::get_cell(vel_cell));
+        }
+
+    // particles have moved, so the cell cache is no longer valid
+    m_mpcd_pdata->invalidateCellCache();
+    if (m_prof) m_prof->pop();
+    }
+
+/*!
+ * The geometry must fit into the global simulation box, and no MPCD particle may be outside of it.
+ */
+template<class Geometry>
+void ConfinedStreamingMethod<Geometry>::validate()
+    {
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    if (!m_geom->validateBox(global_box, m_mpcd_sys->getCellList()->getCellSize()))
+        {
+        m_exec_conf->msg->error() << "ConfinedStreamingMethod: box too small for " << Geometry::getName()
+                                  << " geometry. Increase box size." << std::endl;
+        throw std::runtime_error("Simulation box too small for confined streaming method");
+        }
+
+    ArrayHandle<mpcd::detail::pos_t> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+    const mpcd::detail::PositionGrid& pos_grid = m_mpcd_pdata->getPositionGrid();
+    unsigned int num_out = 0;
+    for (unsigned int idx = 0; idx < m_mpcd_pdata->getN(); ++idx)
+        {
+        const Scalar3 pos = mpcd::detail::get_position(h_pos.data[idx], pos_grid);
+        if (m_geom->isOutside(pos))
+            ++num_out;
+        }
+
+    #ifdef ENABLE_MPI
+    if (m_exec_conf->getNRanks() > 1)
+        {
+        MPI_Allreduce(MPI_IN_PLACE, &num_out, 1, MPI_UNSIGNED, MPI_SUM, m_exec_conf->getMPICommunicator());
+        }
+    #endif // ENABLE_MPI
+
+    if (num_out > 0)
+        {
+        m_exec_conf->msg->error() << "ConfinedStreamingMethod: " << num_out << " MPCD particles are outside the "
+                                  << Geometry::getName() << " geometry." << std::endl;
+        throw std::runtime_error("MPCD particles out of bounds of confined streaming method");
+        }
+    }
+
+/*!
+ * The flags are recomputed if they have never been computed for the current geometry, or if the cell list has
+ * invalidated them or another method has overwritten them since.
+ */
+template<class Geometry>
+void ConfinedStreamingMethod<Geometry>::checkBoundaryFlags()
+    {
+    std::shared_ptr<mpcd::CellList> cl = m_mpcd_sys->getCellList();
+    cl->computeDimensions();
+    if (m_flags_tag == 0 || m_flags_tag != cl->getBoundaryFlagsTag())
+        {
+        computeBoundaryFlags();
+        m_flags_tag = cl->stampBoundaryFlags();
+        }
+    }
+
+/*!
+ * Each cell of the unshifted grid is grown by one cell width on every side, and the box is tested for overlap
+ * with the boundary. The box is shifted so that its center lies in the global simulation box, which makes
+ * the communication cells of an MPI domain test the same geometry as their periodic images.
+ */
+template<class Geometry>
+void ConfinedStreamingMethod<Geometry>::computeBoundaryFlags()
+    {
+    std::shared_ptr<mpcd::CellList> cl = m_mpcd_sys->getCellList();
+    const Index3D& ci = cl->getCellIndexer();
+    const uint3 dim = cl->getDim();
+    const Scalar cell_size = cl->getCellSize();
+    const int3 origin_idx = cl->getOriginIndex();
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    const Scalar3 origin = global_box.getLo()
+                           + cell_size*make_scalar3(origin_idx.x, origin_idx.y, origin_idx.z);
+    const Geometry& geom = *m_geom;
+
+    ArrayHandle<unsigned int> h_flags(cl->getBoundaryFlags(), access_location::host, access_mode::overwrite);
+    for (unsigned int k=0; k < dim.z; ++k)
+        {
+        for (unsigned int j=0; j < dim.y; ++j)
+            {
+            for (unsigned int i=0; i < dim.x; ++i)
+                {
+                const Scalar3 center = origin + cell_size*make_scalar3(Scalar(i)+Scalar(0.5),
+                                                                       Scalar(j)+Scalar(0.5),
+                                                                       Scalar(k)+Scalar(0.5));
+                Scalar3 wrapped = center;
+                int3 image = make_int3(0,0,0);
+                global_box.wrap(wrapped, image);
+
+                const Scalar3 half = make_scalar3(Scalar(1.5)*cell_size, Scalar(1.5)*cell_size, Scalar(1.5)*cell_size);
+                h_flags.data[ci(i,j,k)] = geom.overlapsBoundary(wrapped - half, wrapped + half);
+                }
+            }
+        }
+    }
+
+namespace detail
+{
+//! Export mpcd::ConfinedStreamingMethod to python
+/*!
+ * \param m Python module to export to
+ */
+template<class Geometry>
+void export_ConfinedStreamingMethod(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    const std::string name = "ConfinedStreamingMethod" + Geometry::getName();
+    py::class_<mpcd::ConfinedStreamingMethod<Geometry>, std::shared_ptr<mpcd::ConfinedStreamingMethod<Geometry>>>
+        (m, name.c_str(), py::base<mpcd::StreamingMethod>())
+        .def(py::init<std::shared_ptr<mpcd::SystemData>,
+                      unsigned int,
+                      unsigned int,
+                      int,
+                      std::shared_ptr<const Geometry>>())
+        .def_property("geometry",
+                      &mpcd::ConfinedStreamingMethod<Geometry>::getGeometry,
+                      &mpcd::ConfinedStreamingMethod<Geometry>::setGeometry);
+    }
+} // end namespace detail
+} // end namespace mpcd
+#endif // MPCD_CONFINED_STREAMING_METHOD_H_
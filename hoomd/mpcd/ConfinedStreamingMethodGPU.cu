@@ -0,0 +1,59 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/ConfinedStreamingMethodGPU.cu
+ * \brief Explicit instantiation of the kernel drivers of mpcd::ConfinedStreamingMethodGPU
+ */
+
+#include "ConfinedStreamingMethodGPU.cuh"
+#include "StreamingGeometry.h"
+
+namespace mpcd
+{
+namespace gpu
+{
+
+//! Template instantiation of slit geometry streaming
+template cudaError_t confined_stream<mpcd::detail::SlitGeometry>
+    (const stream_args_t& args, const mpcd::detail::SlitGeometry& geom);
+template cudaError_t confined_stream_flags<mpcd::detail::SlitGeometry>
+    (unsigned int *d_flags,
+     const Index3D& ci,
+     const uint3& dim,
+     const Scalar3& origin,
+     const Scalar cell_size,
+     const BoxDim& global_box,
+     const mpcd::detail::SlitGeometry& geom,
+     const unsigned int block_size);
+
+//! Template instantiation of slit pore geometry streaming
+template cudaError_t confined_stream<mpcd::detail::SlitPoreGeometry>
+    (const stream_args_t& args, const mpcd::detail::SlitPoreGeometry& geom);
+template cudaError_t confined_stream_flags<mpcd::detail::SlitPoreGeometry>
+    (unsigned int *d_flags,
+     const Index3D& ci,
+     const uint3& dim,
+     const Scalar3& origin,
+     const Scalar cell_size,
+     const BoxDim& global_box,
+     const mpcd::detail::SlitPoreGeometry& geom,
+     const unsigned int block_size);
+
+//! Template instantiation of signed distance field geometry streaming
+template cudaError_t confined_stream<mpcd::detail::SDFGeometry>
+    (const stream_args_t& args, const mpcd::detail::SDFGeometry& geom);
+template cudaError_t confined_stream_flags<mpcd::detail::SDFGeometry>
+    (unsigned int *d_flags,
+     const Index3D& ci,
+     const uint3& dim,
+     const Scalar3& origin,
+     const Scalar cell_size,
+     const BoxDim& global_box,
+     const mpcd::detail::SDFGeometry& geom,
+     const unsigned int block_size);
+
+} // end namespace gpu
+} // end namespace mpcd
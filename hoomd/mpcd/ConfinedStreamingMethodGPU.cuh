@@ -0,0 +1,297 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+#ifndef MPCD_CONFINED_STREAMING_METHOD_GPU_CUH_
+#define MPCD_CONFINED_STREAMING_METHOD_GPU_CUH_
+
+/*!
+ * \file mpcd/ConfinedStreamingMethodGPU.cuh
+ * \brief Declaration of CUDA kernels for mpcd::ConfinedStreamingMethodGPU
+ */
+
+#include <cuda_runtime.h>
+
+#include "ParticleDataUtilities.h"
+#include "StreamingGeometry.h"
+
+#include "hoomd/BoxDim.h"
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/Index1D.h"
+
+namespace mpcd
+{
+namespace gpu
+{
+
+//! Common arguments passed to all streaming kernels
+struct stream_args_t
+    {
+    //! Constructor
+    stream_args_t(mpcd::detail::pos_t *_d_pos,
+                  mpcd::detail::vel_t *_d_vel,
+                  const unsigned int *_d_flags,
+                  const BoxDim& _box,
+                  const mpcd::detail::PositionGrid& _pos_grid,
+                  const Index3D& _ci,
+                  const uint3& _dim,
+                  const Scalar3& _origin,
+                  const Scalar _cell_size,
+                  const Scalar _dt,
+                  const unsigned int _N,
+                  const unsigned int _block_size)
+        : d_pos(_d_pos), d_vel(_d_vel), d_flags(_d_flags), box(_box), pos_grid(_pos_grid), ci(_ci), dim(_dim),
+          origin(_origin),
+          cell_size(_cell_size), dt(_dt), N(_N), block_size(_block_size)
+        { }
+
+    mpcd::detail::pos_t *d_pos;     //!< Particle positions
+    mpcd::detail::vel_t *d_vel;     //!< Particle velocities
+    const unsigned int *d_flags;    //!< Boundary flags of the cells
+    const BoxDim& box;              //!< Simulation box
+    const mpcd::detail::PositionGrid& pos_grid; //!< Grid for compact positions
+    const Index3D& ci;              //!< Cell indexer
+    const uint3 dim;                //!< Number of cells in each direction
+    const Scalar3 origin;           //!< Position of the lower corner of the first cell
+    const Scalar cell_size;         //!< Cell width
+    const Scalar dt;                //!< Timestep
+    const unsigned int N;           //!< Number of particles
+    const unsigned int block_size;  //!< Number of threads per block
+    };
+
+//! Kernel driver to stream particles in a confined geometry
+template<class Geometry>
+cudaError_t confined_stream(const stream_args_t& args, const Geometry& geom);
+
+//! Kernel driver to flag the cells that are close to the boundary of a confined geometry
+template<class Geometry>
+cudaError_t confined_stream_flags(unsigned int *d_flags,
+                                  const Index3D& ci,
+                                  const uint3& dim,
+                                  const Scalar3& origin,
+                                  const Scalar cell_size,
+                                  const BoxDim& global_box,
+                                  const Geometry& geom,
+                                  const unsigned int block_size);
+
+#ifdef NVCC
+namespace kernel
+{
+//! Kernel to stream particles in a confined geometry
+/*!
+ * \param d_pos Particle positions
+ * \param d_vel Particle velocities
+ * \param d_flags Boundary flags of the cells of the unshifted grid
+ * \param box Simulation box
+ * \param pos_grid Grid for compact positions
+ * \param ci Cell indexer
+ * \param dim Number of cells in each direction
+ * \param origin Position of the lower corner of the first cell
+ * \param cell_size Cell width
+ * \param dt Timestep to stream
+ * \param N Number of particles
+ * \param geom Confined geometry
+ *
+ * \tparam Geometry type of the confined geometry \a geom
+ *
+ * \b Implementation
+ * Using one thread per particle, the particle position and velocity is loaded. A particle in a cell that is
+ * not flagged and that moves at most one cell width along each direction is propagated ballistically, like
+ * in mpcd::gpu::kernel::stream. All other particles are propagated and reflected from the boundary of \a geom
+ * as long as they collide with it. Particles crossing a periodic global boundary are wrapped back into the
+ * simulation box. The particle positions and velocities are updated.
+ */
+template<class Geometry>
+__global__ void confined_stream(mpcd::detail::pos_t *d_pos,
+                                mpcd::detail::vel_t *d_vel,
+                                const unsigned int *d_flags,
+                                const BoxDim box,
+                                const mpcd::detail::PositionGrid pos_grid,
+                                const Index3D ci,
+                                const uint3 dim,
+                                const Scalar3 origin,
+                                const Scalar cell_size,
+                                const Scalar dt,
+                                const unsigned int N,
+                                const Geometry geom)
+    {
+    // one thread per particle
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= N)
+        return;
+
+    const mpcd::detail::pos_t postype = d_pos[idx];
+    Scalar3 pos = mpcd::detail::get_position(postype, pos_grid);
+    const unsigned int type = mpcd::detail::get_type(postype);
+
+    const mpcd::detail::vel_t vel_cell = d_vel[idx];
+    Scalar3 vel = mpcd::detail::get_velocity(vel_cell);
+
+    // find the cell of the unshifted grid, positions at the edges of the grid are clamped into it
+    const Scalar3 delta = (pos - origin)/cell_size;
+    const int3 bin = make_int3(max(0, min((int)dim.x-1, (int)floor(delta.x))),
+                               max(0, min((int)dim.y-1, (int)floor(delta.y))),
+                               max(0, min((int)dim.z-1, (int)floor(delta.z))));
+
+    // a particle in a bulk cell that moves less than a cell width cannot reach the boundary
+    if (!d_flags[ci(bin.x, bin.y, bin.z)] &&
+        fabs(vel.x)*dt <= cell_size &&
+        fabs(vel.y)*dt <= cell_size &&
+        fabs(vel.z)*dt <= cell_size)
+        {
+        pos += dt * vel;
+        }
+    else
+        {
+        // propagate the particle to its new position, reflecting it from the boundary as many times as needed
+        Scalar dt_remain = dt;
+        bool collide = true;
+        do
+            {
+            pos += dt_remain * vel;
+            collide = geom.detectCollision(pos, vel, dt_remain);
+            }
+        while (dt_remain > 0 && collide);
+        }
+
+    // wrap and update the position
+    int3 image = make_int3(0,0,0);
+    box.wrap(pos, image);
+
+    d_pos[idx] = mpcd::detail::make_position(pos, type, pos_grid);
+    d_vel[idx] = mpcd::detail::make_velocity(vel, mpcd::detail::get_cell(vel_cell));
+    }
+
+//! Kernel to flag the cells that are close to the boundary of a confined geometry
+/*!
+ * \param d_flags Boundary flags of the cells of the unshifted grid
+ * \param ci Cell indexer
+ * \param dim Number of cells in each direction
+ * \param origin Position of the lower corner of the first cell
+ * \param cell_size Cell width
+ * \param global_box Global simulation box
+ * \param geom Confined geometry
+ *
+ * \tparam Geometry type of the confined geometry \a geom
+ *
+ * Using one thread per cell, the cell is grown by one cell width on every side and tested for overlap with
+ * the boundary, after shifting its center into the global simulation box.
+ */
+template<class Geometry>
+__global__ void confined_stream_flags(unsigned int *d_flags,
+                                      const Index3D ci,
+                                      const uint3 dim,
+                                      const Scalar3 origin,
+                                      const Scalar cell_size,
+                                      const BoxDim global_box,
+                                      const Geometry geom)
+    {
+    // one thread per cell
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= ci.getNumElements())
+        return;
+
+    const unsigned int i = idx % dim.x;
+    const unsigned int j = (idx / dim.x) % dim.y;
+    const unsigned int k = idx / (dim.x * dim.y);
+
+    const Scalar3 center = origin + cell_size*make_scalar3(Scalar(i)+Scalar(0.5),
+                                                           Scalar(j)+Scalar(0.5),
+                                                           Scalar(k)+Scalar(0.5));
+    Scalar3 wrapped = center;
+    int3 image = make_int3(0,0,0);
+    global_box.wrap(wrapped, image);
+
+    const Scalar3 half = make_scalar3(Scalar(1.5)*cell_size, Scalar(1.5)*cell_size, Scalar(1.5)*cell_size);
+    d_flags[ci(i,j,k)] = geom.overlapsBoundary(wrapped - half, wrapped + half);
+    }
+} // end namespace kernel
+
+/*!
+ * \param args Common arguments for a streaming kernel
+ * \param geom Confined geometry
+ *
+ * \tparam Geometry type of the confined geometry \a geom
+ *
+ * \sa mpcd::gpu::kernel::confined_stream
+ */
+template<class Geometry>
+cudaError_t confined_stream(const stream_args_t& args, const Geometry& geom)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::confined_stream<Geometry>);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(args.block_size, max_block_size);
+    dim3 grid(args.N / run_block_size + 1);
+    mpcd::gpu::kernel::confined_stream<Geometry><<<grid, run_block_size>>>(args.d_pos,
+                                                                          args.d_vel,
+                                                                          args.d_flags,
+                                                                          args.box,
+                                                                          args.pos_grid,
+                                                                          args.ci,
+                                                                          args.dim,
+                                                                          args.origin,
+                                                                          args.cell_size,
+                                                                          args.dt,
+                                                                          args.N,
+                                                                          geom);
+
+    return cudaSuccess;
+    }
+
+/*!
+ * \param d_flags Boundary flags of the cells of the unshifted grid
+ * \param ci Cell indexer
+ * \param dim Number of cells in each direction
+ * \param origin Position of the lower corner of the first cell
+ * \param cell_size Cell width
+ * \param global_box Global simulation box
+ * \param geom Confined geometry
+ * \param block_size Number of threads per block
+ *
+ * \tparam Geometry type of the confined geometry \a geom
+ *
+ * \sa mpcd::gpu::kernel::confined_stream_flags
+ */
+template<class Geometry>
+cudaError_t confined_stream_flags(unsigned int *d_flags,
+                                  const Index3D& ci,
+                                  const uint3& dim,
+                                  const Scalar3& origin,
+                                  const Scalar cell_size,
+                                  const BoxDim& global_box,
+                                  const Geometry& geom,
+                                  const unsigned int block_size)
+    {
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::confined_stream_flags<Geometry>);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+    dim3 grid(ci.getNumElements() / run_block_size + 1);
+    mpcd::gpu::kernel::confined_stream_flags<Geometry><<<grid, run_block_size>>>(d_flags,
+                                                                                ci,
+                                                                                dim,
+                                                                                origin,
+                                                                                cell_size,
+                                                                                global_box,
+                                                                                geom);
+
+    return cudaSuccess;
+    }
+#endif // NVCC
+
+} // end namespace gpu
+} // end namespace mpcd
+
+#endif // MPCD_CONFINED_STREAMING_METHOD_GPU_CUH_
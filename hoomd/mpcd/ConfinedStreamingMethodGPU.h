@@ -0,0 +1,171 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/ConfinedStreamingMethodGPU.h
+ * \brief Declaration of mpcd::ConfinedStreamingMethodGPU
+ */
+
+#ifndef MPCD_CONFINED_STREAMING_METHOD_GPU_H_
+#define MPCD_CONFINED_STREAMING_METHOD_GPU_H_
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ConfinedStreamingMethod.h"
+#include "ConfinedStreamingMethodGPU.cuh"
+#include "hoomd/Autotuner.h"
+
+namespace mpcd
+{
+
+//! MPCD confined geometry streaming method on the GPU
+template<class Geometry>
+class PYBIND11_EXPORT ConfinedStreamingMethodGPU : public mpcd::ConfinedStreamingMethod<Geometry>
+    {
+    public:
+        //! Constructor
+        /*!
+         * \param sysdata MPCD system data
+         * \param cur_timestep Current system timestep
+         * \param period Number of timesteps between collisions
+         * \param phase Phase shift for periodic updates
+         * \param geom Streaming geometry
+         */
+        ConfinedStreamingMethodGPU(std::shared_ptr<mpcd::SystemData> sysdata,
+                                   unsigned int cur_timestep,
+                                   unsigned int period,
+                                   int phase,
+                                   std::shared_ptr<const Geometry> geom)
+            : mpcd::ConfinedStreamingMethod<Geometry>(sysdata, cur_timestep, period, phase, geom)
+            {
+            m_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_stream_" + Geometry::getName(),
+                                        this->m_exec_conf));
+            m_tuner_flags.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_stream_flags_" + Geometry::getName(),
+                                              this->m_exec_conf));
+            }
+
+        //! Implementation of the streaming rule
+        virtual void stream(unsigned int timestep);
+
+        //! Set autotuner parameters
+        /*!
+         * \param enable Enable/disable autotuning
+         * \param period period (approximate) in time steps when returning occurs
+         */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            mpcd::ConfinedStreamingMethod<Geometry>::setAutotunerParams(enable, period);
+            m_tuner->setEnabled(enable); m_tuner->setPeriod(period);
+            m_tuner_flags->setEnabled(enable); m_tuner_flags->setPeriod(period);
+            }
+
+    protected:
+        //! Compute the boundary flags of the cells
+        virtual void computeBoundaryFlags();
+
+    private:
+        std::unique_ptr<Autotuner> m_tuner;         //!< Autotuner for the streaming kernel
+        std::unique_ptr<Autotuner> m_tuner_flags;   //!< Autotuner for the boundary flags kernel
+    };
+
+/*!
+ * \param timestep Current time to stream
+ */
+template<class Geometry>
+void ConfinedStreamingMethodGPU<Geometry>::stream(unsigned int timestep)
+    {
+    if (!this->shouldStream(timestep)) return;
+
+    if (this->m_validate_geom)
+        {
+        this->validate();
+        this->m_validate_geom = false;
+        }
+    this->checkBoundaryFlags();
+
+    if (this->m_prof) this->m_prof->push(this->m_exec_conf, "MPCD stream");
+
+    std::shared_ptr<mpcd::CellList> cl = this->m_mpcd_sys->getCellList();
+    const Scalar cell_size = cl->getCellSize();
+    const int3 origin_idx = cl->getOriginIndex();
+    const Scalar3 origin = this->m_pdata->getGlobalBox().getLo()
+                           + cell_size*make_scalar3(origin_idx.x, origin_idx.y, origin_idx.z);
+
+    ArrayHandle<mpcd::detail::pos_t> d_pos(this->m_mpcd_pdata->getPositions(), access_location::device, access_mode::readwrite);
+    ArrayHandle<mpcd::detail::vel_t> d_vel(this->m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+    ArrayHandle<unsigned int> d_flags(cl->getBoundaryFlags(), access_location::device, access_mode::read);
+
+    mpcd::gpu::stream_args_t args(d_pos.data,
+                                  d_vel.data,
+                                  d_flags.data,
+                                  cl->getCoverageBox(),
+                                  this->m_mpcd_pdata->getPositionGrid(),
+                                  cl->getCellIndexer(),
+                                  cl->getDim(),
+                                  origin,
+                                  cell_size,
+                                  this->m_mpcd_dt,
+                                  this->m_mpcd_pdata->getN(),
+                                  m_tuner->getParam());
+
+    m_tuner->begin();
+    mpcd::gpu::confined_stream<Geometry>(args, *(this->m_geom));
+    if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    m_tuner->end();
+
+    // particles have moved, so the cell cache is no longer valid
+    this->m_mpcd_pdata->invalidateCellCache();
+    if (this->m_prof) this->m_prof->pop(this->m_exec_conf);
+    }
+
+template<class Geometry>
+void ConfinedStreamingMethodGPU<Geometry>::computeBoundaryFlags()
+    {
+    std::shared_ptr<mpcd::CellList> cl = this->m_mpcd_sys->getCellList();
+    const Scalar cell_size = cl->getCellSize();
+    const int3 origin_idx = cl->getOriginIndex();
+    const BoxDim& global_box = this->m_pdata->getGlobalBox();
+    const Scalar3 origin = global_box.getLo() + cell_size*make_scalar3(origin_idx.x, origin_idx.y, origin_idx.z);
+
+    ArrayHandle<unsigned int> d_flags(cl->getBoundaryFlags(), access_location::device, access_mode::overwrite);
+
+    m_tuner_flags->begin();
+    mpcd::gpu::confined_stream_flags<Geometry>(d_flags.data,
+                                               cl->getCellIndexer(),
+                                               cl->getDim(),
+                                               origin,
+                                               cell_size,
+                                               global_box,
+                                               *(this->m_geom),
+                                               m_tuner_flags->getParam());
+    if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    m_tuner_flags->end();
+    }
+
+namespace detail
+{
+//! Export mpcd::ConfinedStreamingMethodGPU to python
+/*!
+ * \param m Python module to export to
+ */
+template<class Geometry>
+void export_ConfinedStreamingMethodGPU(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    const std::string name = "ConfinedStreamingMethodGPU" + Geometry::getName();
+    py::class_<mpcd::ConfinedStreamingMethodGPU<Geometry>,
+               std::shared_ptr<mpcd::ConfinedStreamingMethodGPU<Geometry>>>
+        (m, name.c_str(), py::base<mpcd::ConfinedStreamingMethod<Geometry>>())
+        .def(py::init<std::shared_ptr<mpcd::SystemData>,
+                      unsigned int,
+                      unsigned int,
+                      int,
+                      std::shared_ptr<const Geometry>>());
+    }
+} // end namespace detail
+} // end namespace mpcd
+#endif // MPCD_CONFINED_STREAMING_METHOD_GPU_H_
@@ -0,0 +1,177 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/ConfinedVirtualCellFiller.h
+ * \brief Declaration of mpcd::ConfinedVirtualCellFiller
+ */
+
+#ifndef MPCD_CONFINED_VIRTUAL_CELL_FILLER_H_
+#define MPCD_CONFINED_VIRTUAL_CELL_FILLER_H_
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "VirtualCellFiller.h"
+#include "VirtualCellFillerUtilities.h"
+#include "StreamingGeometry.h"
+#include "hoomd/extern/pybind/include/pybind11/pybind11.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace mpcd
+{
+
+//! Adds virtual particles to the cells that are cut by the surface of a confined geometry
+/*!
+ * The \a Geometry must supply the methods described in mpcd/BoundaryGeometry.h. A cell may be cut by the surface
+ * for some grid shift if the cell of the unshifted grid, grown by the maximum grid shift on every side, overlaps
+ * the boundary. Only these cells are considered when the fill is computed for the current grid shift.
+ */
+template<class Geometry>
+class PYBIND11_EXPORT ConfinedVirtualCellFiller : public mpcd::VirtualCellFiller
+    {
+    public:
+        //! Constructor
+        /*!
+         * \param sysdata MPCD system data
+         * \param density Number density of virtual particles
+         * \param T Temperature of virtual particles
+         * \param seed Seed for the random number generator
+         * \param geom Confined geometry
+         */
+        ConfinedVirtualCellFiller(std::shared_ptr<mpcd::SystemData> sysdata,
+                                  Scalar density,
+                                  std::shared_ptr<::Variant> T,
+                                  unsigned int seed,
+                                  std::shared_ptr<const Geometry> geom)
+            : mpcd::VirtualCellFiller(sysdata, density, T, seed), m_geom(geom)
+            {
+            checkBoundaryCondition();
+            }
+
+        //! Get the confined geometry
+        std::shared_ptr<const Geometry> getGeometry() const
+            {
+            return m_geom;
+            }
+
+        //! Set the confined geometry
+        void setGeometry(std::shared_ptr<const Geometry> geom)
+            {
+            m_geom = geom;
+            checkBoundaryCondition();
+            requestFindCells();
+            }
+
+    protected:
+        std::shared_ptr<const Geometry> m_geom; //!< Confined geometry
+
+        //! Find the cells that may be cut by the surface for any grid shift
+        virtual void findCells();
+
+        //! Compute the surface velocity and mean number of virtual particles in the cells
+        virtual void computeFill();
+
+    private:
+        //! Warn if the virtual particles are used with a slip boundary
+        void checkBoundaryCondition()
+            {
+            if (m_geom->getBoundaryCondition() != mpcd::detail::boundary::no_slip)
+                {
+                m_exec_conf->msg->warning() << "mpcd: virtual particles are intended for no-slip surfaces, but the "
+                                            << Geometry::getName() << " geometry has a slip boundary" << std::endl;
+                }
+            }
+    };
+
+template<class Geometry>
+void ConfinedVirtualCellFiller<Geometry>::findCells()
+    {
+    const Index3D& ci = m_cl->getCellIndexer();
+    const uint3 dim = m_cl->getDim();
+    const Scalar cell_size = m_cl->getCellSize();
+    const int3 origin_idx = m_cl->getOriginIndex();
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    const Scalar3 origin = global_box.getLo()
+                           + cell_size*make_scalar3(origin_idx.x, origin_idx.y, origin_idx.z);
+    const Scalar h = Scalar(0.5)*cell_size + m_cl->getMaxGridShift();
+    const Scalar3 half = make_scalar3(h, h, h);
+    const Geometry& geom = *m_geom;
+
+    std::vector<unsigned int> cells;
+    for (unsigned int k=0; k < dim.z; ++k)
+        {
+        for (unsigned int j=0; j < dim.y; ++j)
+            {
+            for (unsigned int i=0; i < dim.x; ++i)
+                {
+                Scalar3 center = origin + cell_size*make_scalar3(Scalar(i)+Scalar(0.5),
+                                                                 Scalar(j)+Scalar(0.5),
+                                                                 Scalar(k)+Scalar(0.5));
+                int3 image = make_int3(0,0,0);
+                global_box.wrap(center, image);
+
+                if (geom.overlapsBoundary(center - half, center + half))
+                    cells.push_back(ci(i,j,k));
+                }
+            }
+        }
+
+    m_cells.resize(cells.size());
+    ArrayHandle<unsigned int> h_cells(m_cells, access_location::host, access_mode::overwrite);
+    std::copy(cells.begin(), cells.end(), h_cells.data);
+    }
+
+template<class Geometry>
+void ConfinedVirtualCellFiller<Geometry>::computeFill()
+    {
+    const Index3D& ci = m_cl->getCellIndexer();
+    const Scalar cell_size = m_cl->getCellSize();
+    const int3 origin_idx = m_cl->getOriginIndex();
+    const BoxDim& global_box = m_pdata->getGlobalBox();
+    const Scalar3 origin = global_box.getLo() + m_cl->getGridShift()
+                           + cell_size*make_scalar3(origin_idx.x, origin_idx.y, origin_idx.z);
+    const Geometry& geom = *m_geom;
+
+    ArrayHandle<unsigned int> h_cells(m_cells, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_fill(m_fill, access_location::host, access_mode::overwrite);
+    for (unsigned int idx=0; idx < m_cells.size(); ++idx)
+        {
+        const unsigned int cell = h_cells.data[idx];
+        const Scalar3 lo = origin + cell_size*make_scalar3(cell % ci.getW(),
+                                                           (cell / ci.getW()) % ci.getH(),
+                                                           cell / (ci.getW() * ci.getH()));
+        h_fill.data[idx] = mpcd::detail::compute_virtual_fill(lo, cell_size, m_density, global_box, geom);
+        }
+    }
+
+namespace detail
+{
+//! Export mpcd::ConfinedVirtualCellFiller to python
+/*!
+ * \param m Python module to export to
+ */
+template<class Geometry>
+void export_ConfinedVirtualCellFiller(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    const std::string name = "ConfinedVirtualCellFiller" + Geometry::getName();
+    py::class_<mpcd::ConfinedVirtualCellFiller<Geometry>, std::shared_ptr<mpcd::ConfinedVirtualCellFiller<Geometry>>>
+        (m, name.c_str(), py::base<mpcd::VirtualCellFiller>())
+        .def(py::init<std::shared_ptr<mpcd::SystemData>,
+                      Scalar,
+                      std::shared_ptr<::Variant>,
+                      unsigned int,
+                      std::shared_ptr<const Geometry>>())
+        .def_property("geometry",
+                      &mpcd::ConfinedVirtualCellFiller<Geometry>::getGeometry,
+                      &mpcd::ConfinedVirtualCellFiller<Geometry>::setGeometry);
+    }
+} // end namespace detail
+} // end namespace mpcd
+#endif // MPCD_CONFINED_VIRTUAL_CELL_FILLER_H_
@@ -0,0 +1,201 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/ConfinedVirtualCellFillerGPU.cu
+ * \brief Defines GPU functions and kernels used by mpcd::ConfinedVirtualCellFillerGPU
+ */
+
+#include "ConfinedVirtualCellFillerGPU.cuh"
+#include "StreamingGeometry.h"
+
+namespace mpcd
+{
+namespace gpu
+{
+namespace kernel
+{
+//! Kernel to draw the virtual particles and add them to the cell properties
+/*!
+ * \param d_virtual Momentum and kinetic energy of the virtual particles in each cell
+ * \param d_cell_vel Normalized cell velocities and masses
+ * \param d_cell_energy Cell energies
+ * \param d_cells Local indexes of the cells that may be cut by the surface
+ * \param d_fill Surface velocity and mean number of virtual particles in each cell
+ * \param num_cells Number of cells in \a d_cells
+ * \param ci Cell indexer
+ * \param global_ci Global cell indexer
+ * \param origin_idx Global index of the first local cell
+ * \param mass Mass of a virtual particle
+ * \param kT Temperature of the virtual particles
+ * \param n_dimensions Number of dimensions of the system
+ * \param energy If true, \a d_cell_energy is updated
+ * \param timestep Current timestep
+ * \param seed Seed for the random number generator
+ *
+ * Using one thread per cell, the virtual particles are drawn with mpcd::detail::add_virtual_particles,
+ * seeding the generator with the global cell index as on the CPU.
+ */
+__global__ void draw_virtual_particles(double4 *d_virtual,
+                                       double4 *d_cell_vel,
+                                       double3 *d_cell_energy,
+                                       const unsigned int *d_cells,
+                                       const Scalar4 *d_fill,
+                                       const unsigned int num_cells,
+                                       const Index3D ci,
+                                       const Index3D global_ci,
+                                       const int3 origin_idx,
+                                       const Scalar mass,
+                                       const Scalar kT,
+                                       const unsigned int n_dimensions,
+                                       const bool energy,
+                                       const unsigned int timestep,
+                                       const unsigned int seed)
+    {
+    // one thread per cell
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= num_cells)
+        return;
+
+    // wrap the local cell into the global grid
+    const unsigned int cell = d_cells[idx];
+    int3 global_cell = make_int3((int)(cell % ci.getW()) + origin_idx.x,
+                                 (int)((cell / ci.getW()) % ci.getH()) + origin_idx.y,
+                                 (int)(cell / (ci.getW() * ci.getH())) + origin_idx.z);
+    if (global_cell.x >= (int)global_ci.getW()) global_cell.x -= global_ci.getW();
+    else if (global_cell.x < 0) global_cell.x += global_ci.getW();
+    if (global_cell.y >= (int)global_ci.getH()) global_cell.y -= global_ci.getH();
+    else if (global_cell.y < 0) global_cell.y += global_ci.getH();
+    if (global_cell.z >= (int)global_ci.getD()) global_cell.z -= global_ci.getD();
+    else if (global_cell.z < 0) global_cell.z += global_ci.getD();
+    const unsigned int global_idx = global_ci(global_cell.x, global_cell.y, global_cell.z);
+
+    double4 vel = d_cell_vel[cell];
+    double3 cell_energy = (energy) ? d_cell_energy[cell] : make_double3(0.0, 0.0, 0.0);
+    d_virtual[idx] = mpcd::detail::add_virtual_particles(vel,
+                                                         cell_energy,
+                                                         d_fill[idx],
+                                                         mass,
+                                                         kT,
+                                                         n_dimensions,
+                                                         energy,
+                                                         global_idx,
+                                                         timestep,
+                                                         seed);
+    d_cell_vel[cell] = vel;
+    if (energy)
+        d_cell_energy[cell] = cell_energy;
+    }
+} // end namespace kernel
+
+/*!
+ * \param d_virtual Momentum and kinetic energy of the virtual particles in each cell
+ * \param d_cell_vel Normalized cell velocities and masses
+ * \param d_cell_energy Cell energies
+ * \param d_cells Local indexes of the cells that may be cut by the surface
+ * \param d_fill Surface velocity and mean number of virtual particles in each cell
+ * \param num_cells Number of cells in \a d_cells
+ * \param ci Cell indexer
+ * \param global_ci Global cell indexer
+ * \param origin_idx Global index of the first local cell
+ * \param mass Mass of a virtual particle
+ * \param kT Temperature of the virtual particles
+ * \param n_dimensions Number of dimensions of the system
+ * \param energy If true, \a d_cell_energy is updated
+ * \param timestep Current timestep
+ * \param seed Seed for the random number generator
+ * \param block_size Number of threads per block
+ *
+ * \sa mpcd::gpu::kernel::draw_virtual_particles
+ */
+cudaError_t draw_virtual_particles(double4 *d_virtual,
+                                   double4 *d_cell_vel,
+                                   double3 *d_cell_energy,
+                                   const unsigned int *d_cells,
+                                   const Scalar4 *d_fill,
+                                   const unsigned int num_cells,
+                                   const Index3D& ci,
+                                   const Index3D& global_ci,
+                                   const int3& origin_idx,
+                                   const Scalar mass,
+                                   const Scalar kT,
+                                   const unsigned int n_dimensions,
+                                   const bool energy,
+                                   const unsigned int timestep,
+                                   const unsigned int seed,
+                                   const unsigned int block_size)
+    {
+    if (num_cells == 0) return cudaSuccess;
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::draw_virtual_particles);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+    dim3 grid(num_cells / run_block_size + 1);
+    mpcd::gpu::kernel::draw_virtual_particles<<<grid, run_block_size>>>(d_virtual,
+                                                                        d_cell_vel,
+                                                                        d_cell_energy,
+                                                                        d_cells,
+                                                                        d_fill,
+                                                                        num_cells,
+                                                                        ci,
+                                                                        global_ci,
+                                                                        origin_idx,
+                                                                        mass,
+                                                                        kT,
+                                                                        n_dimensions,
+                                                                        energy,
+                                                                        timestep,
+                                                                        seed);
+
+    return cudaSuccess;
+    }
+
+//! Template instantiation of slit geometry virtual particles
+template cudaError_t confined_virtual_fill<mpcd::detail::SlitGeometry>
+    (Scalar4 *d_fill,
+     const unsigned int *d_cells,
+     const unsigned int num_cells,
+     const Index3D& ci,
+     const Scalar3& origin,
+     const Scalar cell_size,
+     const Scalar density,
+     const BoxDim& global_box,
+     const mpcd::detail::SlitGeometry& geom,
+     const unsigned int block_size);
+
+//! Template instantiation of slit pore geometry virtual particles
+template cudaError_t confined_virtual_fill<mpcd::detail::SlitPoreGeometry>
+    (Scalar4 *d_fill,
+     const unsigned int *d_cells,
+     const unsigned int num_cells,
+     const Index3D& ci,
+     const Scalar3& origin,
+     const Scalar cell_size,
+     const Scalar density,
+     const BoxDim& global_box,
+     const mpcd::detail::SlitPoreGeometry& geom,
+     const unsigned int block_size);
+
+//! Template instantiation of signed distance field geometry virtual particles
+template cudaError_t confined_virtual_fill<mpcd::detail::SDFGeometry>
+    (Scalar4 *d_fill,
+     const unsigned int *d_cells,
+     const unsigned int num_cells,
+     const Index3D& ci,
+     const Scalar3& origin,
+     const Scalar cell_size,
+     const Scalar density,
+     const BoxDim& global_box,
+     const mpcd::detail::SDFGeometry& geom,
+     const unsigned int block_size);
+
+} // end namespace gpu
+} // end namespace mpcd
@@ -0,0 +1,159 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+#ifndef MPCD_CONFINED_VIRTUAL_CELL_FILLER_GPU_CUH_
+#define MPCD_CONFINED_VIRTUAL_CELL_FILLER_GPU_CUH_
+
+/*!
+ * \file mpcd/ConfinedVirtualCellFillerGPU.cuh
+ * \brief Declaration of CUDA kernels for mpcd::ConfinedVirtualCellFillerGPU
+ */
+
+#include <cuda_runtime.h>
+
+#include "StreamingGeometry.h"
+#include "VirtualCellFillerUtilities.h"
+
+#include "hoomd/BoxDim.h"
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/Index1D.h"
+
+namespace mpcd
+{
+namespace gpu
+{
+
+//! Kernel driver to compute the surface velocity and mean number of virtual particles in the cells
+template<class Geometry>
+cudaError_t confined_virtual_fill(Scalar4 *d_fill,
+                                  const unsigned int *d_cells,
+                                  const unsigned int num_cells,
+                                  const Index3D& ci,
+                                  const Scalar3& origin,
+                                  const Scalar cell_size,
+                                  const Scalar density,
+                                  const BoxDim& global_box,
+                                  const Geometry& geom,
+                                  const unsigned int block_size);
+
+//! Kernel driver to draw the virtual particles and add them to the cell properties
+cudaError_t draw_virtual_particles(double4 *d_virtual,
+                                   double4 *d_cell_vel,
+                                   double3 *d_cell_energy,
+                                   const unsigned int *d_cells,
+                                   const Scalar4 *d_fill,
+                                   const unsigned int num_cells,
+                                   const Index3D& ci,
+                                   const Index3D& global_ci,
+                                   const int3& origin_idx,
+                                   const Scalar mass,
+                                   const Scalar kT,
+                                   const unsigned int n_dimensions,
+                                   const bool energy,
+                                   const unsigned int timestep,
+                                   const unsigned int seed,
+                                   const unsigned int block_size);
+
+#ifdef NVCC
+namespace kernel
+{
+//! Kernel to compute the surface velocity and mean number of virtual particles in the cells
+/*!
+ * \param d_fill Surface velocity and mean number of virtual particles in each cell
+ * \param d_cells Local indexes of the cells that may be cut by the surface
+ * \param num_cells Number of cells in \a d_cells
+ * \param ci Cell indexer
+ * \param origin Position of the lower corner of the first cell, including the grid shift
+ * \param cell_size Cell width
+ * \param density Number density of virtual particles
+ * \param global_box Global simulation box
+ * \param geom Confined geometry
+ *
+ * \tparam Geometry type of the confined geometry \a geom
+ *
+ * Using one thread per cell, the fill is computed with mpcd::detail::compute_virtual_fill.
+ */
+template<class Geometry>
+__global__ void confined_virtual_fill(Scalar4 *d_fill,
+                                      const unsigned int *d_cells,
+                                      const unsigned int num_cells,
+                                      const Index3D ci,
+                                      const Scalar3 origin,
+                                      const Scalar cell_size,
+                                      const Scalar density,
+                                      const BoxDim global_box,
+                                      const Geometry geom)
+    {
+    // one thread per cell
+    unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
+    if (idx >= num_cells)
+        return;
+
+    const unsigned int cell = d_cells[idx];
+    const Scalar3 lo = origin + cell_size*make_scalar3(cell % ci.getW(),
+                                                       (cell / ci.getW()) % ci.getH(),
+                                                       cell / (ci.getW() * ci.getH()));
+    d_fill[idx] = mpcd::detail::compute_virtual_fill(lo, cell_size, density, global_box, geom);
+    }
+} // end namespace kernel
+
+/*!
+ * \param d_fill Surface velocity and mean number of virtual particles in each cell
+ * \param d_cells Local indexes of the cells that may be cut by the surface
+ * \param num_cells Number of cells in \a d_cells
+ * \param ci Cell indexer
+ * \param origin Position of the lower corner of the first cell, including the grid shift
+ * \param cell_size Cell width
+ * \param density Number density of virtual particles
+ * \param global_box Global simulation box
+ * \param geom Confined geometry
+ * \param block_size Number of threads per block
+ *
+ * \tparam Geometry type of the confined geometry \a geom
+ *
+ * \sa mpcd::gpu::kernel::confined_virtual_fill
+ */
+template<class Geometry>
+cudaError_t confined_virtual_fill(Scalar4 *d_fill,
+                                  const unsigned int *d_cells,
+                                  const unsigned int num_cells,
+                                  const Index3D& ci,
+                                  const Scalar3& origin,
+                                  const Scalar cell_size,
+                                  const Scalar density,
+                                  const BoxDim& global_box,
+                                  const Geometry& geom,
+                                  const unsigned int block_size)
+    {
+    if (num_cells == 0) return cudaSuccess;
+
+    static unsigned int max_block_size = UINT_MAX;
+    if (max_block_size == UINT_MAX)
+        {
+        cudaFuncAttributes attr;
+        cudaFuncGetAttributes(&attr, (const void*)mpcd::gpu::kernel::confined_virtual_fill<Geometry>);
+        max_block_size = attr.maxThreadsPerBlock;
+        }
+
+    unsigned int run_block_size = min(block_size, max_block_size);
+    dim3 grid(num_cells / run_block_size + 1);
+    mpcd::gpu::kernel::confined_virtual_fill<Geometry><<<grid, run_block_size>>>(d_fill,
+                                                                                d_cells,
+                                                                                num_cells,
+                                                                                ci,
+                                                                                origin,
+                                                                                cell_size,
+                                                                                density,
+                                                                                global_box,
+                                                                                geom);
+
+    return cudaSuccess;
+    }
+#endif // NVCC
+
+} // end namespace gpu
+} // end namespace mpcd
+
+#endif // MPCD_CONFINED_VIRTUAL_CELL_FILLER_GPU_CUH_
@@ -0,0 +1,169 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/ConfinedVirtualCellFillerGPU.h
+ * \brief Declaration of mpcd::ConfinedVirtualCellFillerGPU
+ */
+
+#ifndef MPCD_CONFINED_VIRTUAL_CELL_FILLER_GPU_H_
+#define MPCD_CONFINED_VIRTUAL_CELL_FILLER_GPU_H_
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "ConfinedVirtualCellFiller.h"
+#include "ConfinedVirtualCellFillerGPU.cuh"
+#include "hoomd/Autotuner.h"
+
+namespace mpcd
+{
+
+//! Adds virtual particles to the cells that are cut by the surface of a confined geometry on the GPU
+/*!
+ * The cells that may be cut by the surface are still found on the CPU, since this only needs to happen
+ * when the cell list dimensions or the geometry change.
+ */
+template<class Geometry>
+class PYBIND11_EXPORT ConfinedVirtualCellFillerGPU : public mpcd::ConfinedVirtualCellFiller<Geometry>
+    {
+    public:
+        //! Constructor
+        /*!
+         * \param sysdata MPCD system data
+         * \param density Number density of virtual particles
+         * \param T Temperature of virtual particles
+         * \param seed Seed for the random number generator
+         * \param geom Confined geometry
+         */
+        ConfinedVirtualCellFillerGPU(std::shared_ptr<mpcd::SystemData> sysdata,
+                                     Scalar density,
+                                     std::shared_ptr<::Variant> T,
+                                     unsigned int seed,
+                                     std::shared_ptr<const Geometry> geom)
+            : mpcd::ConfinedVirtualCellFiller<Geometry>(sysdata, density, T, seed, geom)
+            {
+            m_fill_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_virtual_fill_" + Geometry::getName(),
+                                             this->m_exec_conf));
+            m_draw_tuner.reset(new Autotuner(32, 1024, 32, 5, 100000, "mpcd_virtual_draw_" + Geometry::getName(),
+                                             this->m_exec_conf));
+            }
+
+        //! Set autotuner parameters
+        /*!
+         * \param enable Enable/disable autotuning
+         * \param period period (approximate) in time steps when returning occurs
+         */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            m_fill_tuner->setEnabled(enable); m_fill_tuner->setPeriod(period);
+            m_draw_tuner->setEnabled(enable); m_draw_tuner->setPeriod(period);
+            }
+
+    protected:
+        //! Compute the surface velocity and mean number of virtual particles in the cells
+        virtual void computeFill();
+
+        //! Draw the virtual particles and add them to the cell properties
+        virtual void drawVirtualParticles(unsigned int timestep,
+                                          GPUArray<double4>& cell_vel,
+                                          GPUArray<double3>& cell_energy,
+                                          bool energy);
+
+    private:
+        std::unique_ptr<Autotuner> m_fill_tuner;    //!< Autotuner for the fill kernel
+        std::unique_ptr<Autotuner> m_draw_tuner;    //!< Autotuner for the virtual particle kernel
+    };
+
+template<class Geometry>
+void ConfinedVirtualCellFillerGPU<Geometry>::computeFill()
+    {
+    const Scalar cell_size = this->m_cl->getCellSize();
+    const int3 origin_idx = this->m_cl->getOriginIndex();
+    const BoxDim& global_box = this->m_pdata->getGlobalBox();
+    const Scalar3 origin = global_box.getLo() + this->m_cl->getGridShift()
+                           + cell_size*make_scalar3(origin_idx.x, origin_idx.y, origin_idx.z);
+
+    ArrayHandle<unsigned int> d_cells(this->m_cells, access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_fill(this->m_fill, access_location::device, access_mode::overwrite);
+
+    m_fill_tuner->begin();
+    mpcd::gpu::confined_virtual_fill<Geometry>(d_fill.data,
+                                               d_cells.data,
+                                               this->m_cells.size(),
+                                               this->m_cl->getCellIndexer(),
+                                               origin,
+                                               cell_size,
+                                               this->m_density,
+                                               global_box,
+                                               *(this->m_geom),
+                                               m_fill_tuner->getParam());
+    if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    m_fill_tuner->end();
+    }
+
+/*!
+ * \param timestep Current timestep
+ * \param cell_vel Normalized cell velocities and masses
+ * \param cell_energy Cell energies
+ * \param energy If true, \a cell_energy is updated
+ */
+template<class Geometry>
+void ConfinedVirtualCellFillerGPU<Geometry>::drawVirtualParticles(unsigned int timestep,
+                                                                  GPUArray<double4>& cell_vel,
+                                                                  GPUArray<double3>& cell_energy,
+                                                                  bool energy)
+    {
+    ArrayHandle<unsigned int> d_cells(this->m_cells, access_location::device, access_mode::read);
+    ArrayHandle<Scalar4> d_fill(this->m_fill, access_location::device, access_mode::read);
+    ArrayHandle<double4> d_virtual(this->m_virtual, access_location::device, access_mode::overwrite);
+    ArrayHandle<double4> d_cell_vel(cell_vel, access_location::device, access_mode::readwrite);
+    ArrayHandle<double3> d_cell_energy(cell_energy, access_location::device, access_mode::readwrite);
+
+    m_draw_tuner->begin();
+    mpcd::gpu::draw_virtual_particles(d_virtual.data,
+                                      d_cell_vel.data,
+                                      d_cell_energy.data,
+                                      d_cells.data,
+                                      d_fill.data,
+                                      this->m_cells.size(),
+                                      this->m_cl->getCellIndexer(),
+                                      this->m_cl->getGlobalCellIndexer(),
+                                      this->m_cl->getOriginIndex(),
+                                      this->m_mpcd_pdata->getMass(),
+                                      this->m_T->getValue(timestep),
+                                      this->m_sysdef->getNDimensions(),
+                                      energy,
+                                      timestep,
+                                      this->m_seed,
+                                      m_draw_tuner->getParam());
+    if (this->m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
+    m_draw_tuner->end();
+    }
+
+namespace detail
+{
+//! Export mpcd::ConfinedVirtualCellFillerGPU to python
+/*!
+ * \param m Python module to export to
+ */
+template<class Geometry>
+void export_ConfinedVirtualCellFillerGPU(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    const std::string name = "ConfinedVirtualCellFillerGPU" + Geometry::getName();
+    py::class_<mpcd::ConfinedVirtualCellFillerGPU<Geometry>,
+               std::shared_ptr<mpcd::ConfinedVirtualCellFillerGPU<Geometry>>>
+        (m, name.c_str(), py::base<mpcd::ConfinedVirtualCellFiller<Geometry>>())
+        .def(py::init<std::shared_ptr<mpcd::SystemData>,
+                      Scalar,
+                      std::shared_ptr<::Variant>,
+                      unsigned int,
+                      std::shared_ptr<const Geometry>>());
+    }
+} // end namespace detail
+} // end namespace mpcd
+#endif // MPCD_CONFINED_VIRTUAL_CELL_FILLER_GPU_H_
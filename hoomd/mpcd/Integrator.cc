@@ -19,7 +19,8 @@
  * \param deltaT Fundamental integration timestep
  */
 mpcd::Integrator::Integrator(std::shared_ptr<mpcd::SystemData> sysdata, Scalar deltaT)
-    : IntegratorTwoStep(sysdata->getSystemDefinition(), deltaT), m_mpcd_sys(sysdata)
+    : IntegratorTwoStep(sysdata->getSystemDefinition(), deltaT), m_mpcd_sys(sysdata), m_fuse_stream(false),
+      m_overlap_collide(false)
     {
     assert(m_mpcd_sys);
     m_exec_conf->msg->notice(5) << "Constructing MPCD Integrator" << std::endl;
@@ -97,7 +98,24 @@ void mpcd::Integrator::update(unsigned int timestep)
     // execute the MPCD streaming step now that MD particles are communicated onto their final domains
     if (m_stream)
         {
-        m_stream->stream(timestep);
+        // optionally bin the particles for the next collision while they are streamed
+        bool streamed = false;
+        if (m_fuse_stream && m_collide)
+            {
+            const unsigned int collide_timestep = m_collide->getNextCollision(timestep);
+            streamed = m_stream->streamCellList(timestep,
+                                                collide_timestep,
+                                                m_collide->computeGridShift(collide_timestep));
+            }
+
+        if (!streamed)
+            m_stream->stream(timestep);
+        }
+
+    // start the collision of the next step so that its cell communication overlaps with the MD forces
+    if (m_overlap_collide && m_collide)
+        {
+        m_collide->beginCollide(timestep+1);
         }
 
     // compute the net force on the MD particles
@@ -142,9 +160,10 @@ void mpcd::Integrator::prepRun(unsigned int timestep)
     {
     IntegratorTwoStep::prepRun(timestep);
 
-    // synchronize timestep in mpcd methods
+    // synchronize timestep in mpcd methods, discarding any collision started in a previous run
     if (m_collide)
         {
+        m_collide->cancelCollide();
         m_collide->drawGridShift(timestep);
         }
 
@@ -182,6 +201,8 @@ void mpcd::detail::export_Integrator(pybind11::module& m)
         .def("removeCollisionMethod", &mpcd::Integrator::removeCollisionMethod)
         .def("setStreamingMethod", &mpcd::Integrator::setStreamingMethod)
         .def("removeStreamingMethod", &mpcd::Integrator::removeStreamingMethod)
+        .def("setFuseStream", &mpcd::Integrator::setFuseStream)
+        .def("setOverlapCollide", &mpcd::Integrator::setOverlapCollide)
         #ifdef ENABLE_MPI
         .def("setMPCDCommunicator", &mpcd::Integrator::setMPCDCommunicator)
         #endif // ENABLE_MPI
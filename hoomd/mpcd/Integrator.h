@@ -110,10 +110,30 @@ class PYBIND11_EXPORT Integrator : public ::IntegratorTwoStep
             m_stream.reset();
             }
 
+        //! Fuse the streaming step with the cell list build of the next collision
+        /*!
+         * \param fuse_stream If true, stream and bin the particles in one pass when possible
+         */
+        void setFuseStream(bool fuse_stream)
+            {
+            m_fuse_stream = fuse_stream;
+            }
+
+        //! Start the collision of the next step before the MD forces are computed
+        /*!
+         * \param overlap_collide If true, overlap the cell property reduction with the MD force computation
+         */
+        void setOverlapCollide(bool overlap_collide)
+            {
+            m_overlap_collide = overlap_collide;
+            }
+
     protected:
         std::shared_ptr<mpcd::SystemData> m_mpcd_sys;   //!< MPCD system
         std::shared_ptr<mpcd::CollisionMethod> m_collide;   //!< MPCD collision rule
         std::shared_ptr<mpcd::StreamingMethod> m_stream;    //!< MPCD streaming rule
+        bool m_fuse_stream;                                 //!< True if streaming is fused with the cell list build
+        bool m_overlap_collide;                             //!< True if the next collision is started before the MD forces
 
         #ifdef ENABLE_MPI
         std::shared_ptr<mpcd::Communicator> m_mpcd_comm;    //!< MPCD communicator
@@ -241,6 +241,9 @@ void mpcd::ParticleData::initializeFromSnapshot(const std::shared_ptr<const mpcd
         std::vector<unsigned int> type;
         std::vector<unsigned int> tag;
 
+        checkNumTypes();
+        setPositionGrid(m_decomposition->calculateLocalBox(global_box));
+
         // distribute particle data to processors
         scatter_v(pos_proc,pos, root, mpi_comm);
         scatter_v(vel_proc,vel, root, mpi_comm);
@@ -256,14 +259,14 @@ void mpcd::ParticleData::initializeFromSnapshot(const std::shared_ptr<const mpcd
             allocate(m_N);
 
         // Fill-up particle data arrays
-        ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(m_pos, access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::detail::vel_t> h_vel(m_vel, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_comm_flag(m_comm_flags, access_location::host, access_mode::overwrite);
         for (unsigned int idx = 0; idx < m_N; idx++)
             {
-            h_pos.data[idx] = make_scalar4(pos[idx].x,pos[idx].y, pos[idx].z, __int_as_scalar(type[idx]));
-            h_vel.data[idx] = make_scalar4(vel[idx].x, vel[idx].y, vel[idx].z, __int_as_scalar(mpcd::detail::NO_CELL));
+            h_pos.data[idx] = mpcd::detail::make_position(pos[idx], type[idx], m_pos_grid);
+            h_vel.data[idx] = mpcd::detail::make_velocity(vel[idx], mpcd::detail::NO_CELL);
             h_tag.data[idx] = tag[idx];
             h_comm_flag.data[idx] = 0; // initialize with zero by default
             }
@@ -271,22 +274,24 @@ void mpcd::ParticleData::initializeFromSnapshot(const std::shared_ptr<const mpcd
     else
     #endif // ENABLE_MPI
         {
+        // initialize type mapping
+        m_type_mapping = snapshot->type_mapping;
+        checkNumTypes();
+        setPositionGrid(global_box);
+
         allocate(snapshot->size);
 
-        ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(m_pos, access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::detail::vel_t> h_vel(m_vel, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::overwrite);
 
         for (unsigned int snap_idx = 0; snap_idx < snapshot->size; ++snap_idx)
             {
-            h_pos.data[nglobal] = make_scalar4(snapshot->position[snap_idx].x,
-                                               snapshot->position[snap_idx].y,
-                                               snapshot->position[snap_idx].z,
-                                               __int_as_scalar(snapshot->type[snap_idx]));
-            h_vel.data[nglobal] = make_scalar4(snapshot->velocity[snap_idx].x,
-                                               snapshot->velocity[snap_idx].y,
-                                               snapshot->velocity[snap_idx].z,
-                                               __int_as_scalar(mpcd::detail::NO_CELL));
+            h_pos.data[nglobal] = mpcd::detail::make_position(vec_to_scalar3(snapshot->position[snap_idx]),
+                                                              snapshot->type[snap_idx],
+                                                              m_pos_grid);
+            h_vel.data[nglobal] = mpcd::detail::make_velocity(vec_to_scalar3(snapshot->velocity[snap_idx]),
+                                                              mpcd::detail::NO_CELL);
             h_tag.data[nglobal] = nglobal;
             nglobal++;
             }
@@ -296,9 +301,6 @@ void mpcd::ParticleData::initializeFromSnapshot(const std::shared_ptr<const mpcd
 
         // number of local particles is the global number
         m_N = nglobal;
-
-        // initialize type mapping
-        m_type_mapping = snapshot->type_mapping;
         }
 
     setNGlobal(nglobal);
@@ -366,27 +368,28 @@ void mpcd::ParticleData::initializeRandom(unsigned int N, const BoxDim& local_bo
     std::normal_distribution<Scalar> vel(0.0, fast::sqrt(kT / m_mass));
 
     // allocate and fill up with random values
+    setPositionGrid(local_box);
     allocate(m_N);
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::overwrite);
-    ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::overwrite);
+    ArrayHandle<mpcd::detail::pos_t> h_pos(m_pos, access_location::host, access_mode::overwrite);
+    ArrayHandle<mpcd::detail::vel_t> h_vel(m_vel, access_location::host, access_mode::overwrite);
     ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::overwrite);
+    std::vector<Scalar3> vel_i(m_N);
     double3 vel_cm = make_double3(0,0,0);
     for (unsigned int i=0; i < m_N; ++i)
         {
-        h_pos.data[i] = make_scalar4(pos_x(mt),
-                                     pos_y(mt),
-                                     (ndimensions == 3) ? pos_z(mt) : Scalar(0.0),
-                                     __int_as_scalar(0));
-        h_vel.data[i] = make_scalar4(vel(mt),
-                                     vel(mt),
-                                     (ndimensions == 3) ? vel(mt) : Scalar(0.0),
-                                     __int_as_scalar(mpcd::detail::NO_CELL));
+        const Scalar3 pos_i = make_scalar3(pos_x(mt),
+                                           pos_y(mt),
+                                           (ndimensions == 3) ? pos_z(mt) : Scalar(0.0));
+        h_pos.data[i] = mpcd::detail::make_position(pos_i, 0, m_pos_grid);
+        vel_i[i] = make_scalar3(vel(mt),
+                                vel(mt),
+                                (ndimensions == 3) ? vel(mt) : Scalar(0.0));
         h_tag.data[i] = tag_start + i;
 
         // add up total velocity
-        vel_cm.x += h_vel.data[i].x;
-        vel_cm.y += h_vel.data[i].y;
-        vel_cm.z += h_vel.data[i].z;
+        vel_cm.x += vel_i[i].x;
+        vel_cm.y += vel_i[i].y;
+        vel_cm.z += vel_i[i].z;
         }
 
     // compute average velocity per-particle to remove
@@ -406,9 +409,8 @@ void mpcd::ParticleData::initializeRandom(unsigned int N, const BoxDim& local_bo
     // subtract center-of-mass velocity
     for (unsigned int i=0; i < m_N; ++i)
         {
-        h_vel.data[i].x -= vel_cm.x;
-        h_vel.data[i].y -= vel_cm.y;
-        h_vel.data[i].z -= vel_cm.z;
+        const Scalar3 v = make_scalar3(vel_i[i].x - vel_cm.x, vel_i[i].y - vel_cm.y, vel_i[i].z - vel_cm.z);
+        h_vel.data[i] = mpcd::detail::make_velocity(v, mpcd::detail::NO_CELL);
         }
     }
 
@@ -421,8 +423,8 @@ void mpcd::ParticleData::takeSnapshot(std::shared_ptr<mpcd::ParticleDataSnapshot
     {
     m_exec_conf->msg->notice(4) << "MPCD ParticleData: taking snapshot" << std::endl;
 
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
-    ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::read);
+    ArrayHandle<mpcd::detail::pos_t> h_pos(m_pos, access_location::host, access_mode::read);
+    ArrayHandle<mpcd::detail::vel_t> h_vel(m_vel, access_location::host, access_mode::read);
     ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::read);
 
 #ifdef ENABLE_MPI
@@ -435,9 +437,9 @@ void mpcd::ParticleData::takeSnapshot(std::shared_ptr<mpcd::ParticleDataSnapshot
         std::vector<unsigned int> tag(m_N);
         for (unsigned int idx = 0; idx < m_N; ++idx)
             {
-            pos[idx] = make_scalar3(h_pos.data[idx].x, h_pos.data[idx].y, h_pos.data[idx].z);
-            vel[idx] = make_scalar3(h_vel.data[idx].x, h_vel.data[idx].y, h_vel.data[idx].z);
-            type[idx] = __scalar_as_int(h_pos.data[idx].w);
+            pos[idx] = mpcd::detail::get_position(h_pos.data[idx], m_pos_grid);
+            vel[idx] = mpcd::detail::get_velocity(h_vel.data[idx]);
+            type[idx] = mpcd::detail::get_type(h_pos.data[idx]);
             tag[idx] = h_tag.data[idx];
             }
 
@@ -501,15 +503,15 @@ void mpcd::ParticleData::takeSnapshot(std::shared_ptr<mpcd::ParticleDataSnapshot
             const unsigned int snap_idx = h_tag.data[idx];
 
             // make sure the position stored in the snapshot is within the boundaries
-            Scalar4 postype = h_pos.data[idx];
-            Scalar3 pos_i = make_scalar3(postype.x, postype.y, postype.z);
-            const unsigned int type_i = __scalar_as_int(postype.w);
+            const mpcd::detail::pos_t postype = h_pos.data[idx];
+            Scalar3 pos_i = mpcd::detail::get_position(postype, m_pos_grid);
+            const unsigned int type_i = mpcd::detail::get_type(postype);
             int3 img = make_int3(0,0,0);
             global_box.wrap(pos_i,img);
 
             // push particle into the snapshot
             snapshot->position[snap_idx] = vec3<Scalar>(pos_i);
-            snapshot->velocity[snap_idx] = vec3<Scalar>(h_vel.data[idx]);
+            snapshot->velocity[snap_idx] = vec3<Scalar>(mpcd::detail::get_velocity(h_vel.data[idx]));
             snapshot->type[snap_idx] = type_i;
             }
         }
@@ -589,6 +591,59 @@ bool mpcd::ParticleData::checkInBox(const std::shared_ptr<const mpcd::ParticleDa
     return in_box;
     }
 
+/*!
+ * \throw runtime_error if there are more types than compact positions can store
+ */
+void mpcd::ParticleData::checkNumTypes() const
+    {
+    #ifdef ENABLE_MPCD_COMPACT
+    if (m_type_mapping.size() > mpcd::detail::POSITION_MAX_TYPES)
+        {
+        m_exec_conf->msg->error() << "Compact MPCD particle data supports at most " << mpcd::detail::POSITION_MAX_TYPES
+                                  << " types, but " << m_type_mapping.size() << " were given" << endl;
+        throw runtime_error("Error initializing MPCD particle data");
+        }
+    #endif // ENABLE_MPCD_COMPACT
+    }
+
+/*!
+ * \param local_box Local simulation box
+ *
+ * The grid covers \a local_box. The positions are not repacked, use setLocalBox() to move
+ * the grid of stored positions.
+ */
+void mpcd::ParticleData::setPositionGrid(const BoxDim& local_box)
+    {
+    m_pos_grid = mpcd::detail::PositionGrid(local_box.getLo(), local_box.getL());
+    }
+
+/*!
+ * \param local_box New local simulation box
+ *
+ * The global box of an MPCD simulation is fixed, but the domain boundaries move during load
+ * balancing. With ENABLE_MPCD_COMPACT, the storage grid is rebuilt over \a local_box and the
+ * stored positions are repacked relative to it, so that the particles of the rank lie on its
+ * grid again once they have been migrated.
+ */
+void mpcd::ParticleData::setLocalBox(const BoxDim& local_box)
+    {
+    const mpcd::detail::PositionGrid old_grid = m_pos_grid;
+    setPositionGrid(local_box);
+
+    #ifdef ENABLE_MPCD_COMPACT
+    if (m_pos_grid.lo.x == old_grid.lo.x && m_pos_grid.lo.y == old_grid.lo.y && m_pos_grid.lo.z == old_grid.lo.z &&
+        m_pos_grid.width.x == old_grid.width.x && m_pos_grid.width.y == old_grid.width.y && m_pos_grid.width.z == old_grid.width.z)
+        return;
+
+    ArrayHandle<mpcd::detail::pos_t> h_pos(m_pos, access_location::host, access_mode::readwrite);
+    for (unsigned int idx = 0; idx < m_N; ++idx)
+        {
+        const Scalar3 pos = mpcd::detail::get_position(h_pos.data[idx], old_grid);
+        h_pos.data[idx] = mpcd::detail::make_position(pos, mpcd::detail::get_type(h_pos.data[idx]), m_pos_grid);
+        }
+    #endif // ENABLE_MPCD_COMPACT
+    }
+
 /*!
  * \param nglobal Global number of particles
  */
@@ -611,10 +666,10 @@ void mpcd::ParticleData::allocate(unsigned int N_max)
     m_N_max = N_max;
 
     //! Allocate the particle data
-    GPUArray<Scalar4> pos(N_max, m_exec_conf);
+    GPUArray<mpcd::detail::pos_t> pos(N_max, m_exec_conf);
     m_pos.swap(pos);
 
-    GPUArray<Scalar4> vel(N_max, m_exec_conf);
+    GPUArray<mpcd::detail::vel_t> vel(N_max, m_exec_conf);
     m_vel.swap(vel);
 
     GPUArray<unsigned int> tag(N_max, m_exec_conf);
@@ -628,20 +683,20 @@ void mpcd::ParticleData::allocate(unsigned int N_max)
         }
     #endif // ENABLE_MPI
 
-    // Allocate the alternate data
-    GPUArray<Scalar4> pos_alt(N_max, m_exec_conf);
+    // Release the alternate data, which is allocated again on first use
+    GPUArray<mpcd::detail::pos_t> pos_alt;
     m_pos_alt.swap(pos_alt);
 
-    GPUArray<Scalar4> vel_alt(N_max, m_exec_conf);
+    GPUArray<mpcd::detail::vel_t> vel_alt;
     m_vel_alt.swap(vel_alt);
 
-    GPUArray<unsigned int> tag_alt(N_max, m_exec_conf);
+    GPUArray<unsigned int> tag_alt;
     m_tag_alt.swap(tag_alt);
 
     #ifdef ENABLE_MPI
     if (m_decomposition)
         {
-        GPUArray<unsigned int> comm_flags_alt(N_max, m_exec_conf);
+        GPUArray<unsigned int> comm_flags_alt;
         m_comm_flags_alt.swap(comm_flags_alt);
 
         GPUArray<unsigned int> remove_ids(N_max, m_exec_conf);
@@ -681,14 +736,14 @@ void mpcd::ParticleData::reallocate(unsigned int N_max)
         }
     #endif // ENABLE_MPI
 
-    // Reallocate the alternate data
-    m_pos_alt.resize(N_max);
-    m_vel_alt.resize(N_max);
-    m_tag_alt.resize(N_max);
+    // Reallocate the alternate data that is in use
+    if (!m_pos_alt.isNull()) m_pos_alt.resize(N_max);
+    if (!m_vel_alt.isNull()) m_vel_alt.resize(N_max);
+    if (!m_tag_alt.isNull()) m_tag_alt.resize(N_max);
     #ifdef ENABLE_MPI
     if (m_decomposition)
         {
-        m_comm_flags_alt.resize(N_max);
+        if (!m_comm_flags_alt.isNull()) m_comm_flags_alt.resize(N_max);
         m_remove_ids.resize(N_max);
 
         #ifdef ENABLE_CUDA
@@ -792,9 +847,8 @@ Scalar3 mpcd::ParticleData::getPosition(unsigned int idx) const
         m_exec_conf->msg->error() << "Requested MPCD particle local index " << idx << " is out of range" << endl;
         throw std::runtime_error("Error accessing MPCD particle data.");
         }
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
-    const Scalar4 postype = h_pos.data[idx];
-    return make_scalar3(postype.x, postype.y, postype.z);
+    ArrayHandle<mpcd::detail::pos_t> h_pos(m_pos, access_location::host, access_mode::read);
+    return mpcd::detail::get_position(h_pos.data[idx], m_pos_grid);
     }
 
 /*!
@@ -809,9 +863,8 @@ unsigned int mpcd::ParticleData::getType(unsigned int idx) const
         m_exec_conf->msg->error() << "Requested MPCD particle local index " << idx << " is out of range" << endl;
         throw std::runtime_error("Error accessing MPCD particle data.");
         }
-    ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::read);
-    const Scalar4 postype = h_pos.data[idx];
-    return __scalar_as_int(postype.w);
+    ArrayHandle<mpcd::detail::pos_t> h_pos(m_pos, access_location::host, access_mode::read);
+    return mpcd::detail::get_type(h_pos.data[idx]);
     }
 
 /*!
@@ -826,9 +879,8 @@ Scalar3 mpcd::ParticleData::getVelocity(unsigned int idx) const
         m_exec_conf->msg->error() << "Requested MPCD particle local index " << idx << " is out of range" << endl;
         throw std::runtime_error("Error accessing MPCD particle data.");
         }
-    ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::read);
-    const Scalar4 velcell = h_vel.data[idx];
-    return make_scalar3(velcell.x, velcell.y, velcell.z);
+    ArrayHandle<mpcd::detail::vel_t> h_vel(m_vel, access_location::host, access_mode::read);
+    return mpcd::detail::get_velocity(h_vel.data[idx]);
     }
 
 /*!
@@ -890,8 +942,8 @@ void mpcd::ParticleData::removeParticles(GPUVector<mpcd::detail::pdata_element>&
         ArrayHandle<mpcd::detail::pdata_element> h_out(out, access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_remove_idx(m_remove_ids, access_location::host, access_mode::read);
 
-        ArrayHandle<Scalar4> h_pos(m_pos, access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_vel(m_vel, access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(m_pos, access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::vel_t> h_vel(m_vel, access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(m_tag, access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::readwrite);
 
@@ -900,8 +952,12 @@ void mpcd::ParticleData::removeParticles(GPUVector<mpcd::detail::pdata_element>&
             // pack the current particle
             const unsigned int remove_pid = h_remove_idx.data[idx];
             mpcd::detail::pdata_element p;
-            p.pos = h_pos.data[remove_pid];
-            p.vel = h_vel.data[remove_pid];
+            const mpcd::detail::pos_t postype = h_pos.data[remove_pid];
+            const mpcd::detail::vel_t velcell = h_vel.data[remove_pid];
+            const Scalar3 pos = mpcd::detail::get_position(postype, m_pos_grid);
+            const Scalar3 vel = mpcd::detail::get_velocity(velcell);
+            p.pos = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(mpcd::detail::get_type(postype)));
+            p.vel = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::get_cell(velcell)));
             p.tag = h_tag.data[remove_pid];
             p.comm_flag = h_comm_flags.data[remove_pid];
             h_out.data[idx] = p;
@@ -945,8 +1001,8 @@ void mpcd::ParticleData::addParticles(const GPUVector<mpcd::detail::pdata_elemen
 
         {
         // access particle data arrays
-        ArrayHandle<Scalar4> h_pos(getPositions(), access_location::host, access_mode::readwrite);
-        ArrayHandle<Scalar4> h_vel(getVelocities(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::vel_t> h_vel(getVelocities(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_tag(getTags(), access_location::host, access_mode::readwrite);
         ArrayHandle<unsigned int> h_comm_flags(m_comm_flags, access_location::host, access_mode::readwrite);
 
@@ -956,8 +1012,11 @@ void mpcd::ParticleData::addParticles(const GPUVector<mpcd::detail::pdata_elemen
         for (unsigned int i = 0 ; i < num_add_ptls; ++i)
             {
             const mpcd::detail::pdata_element& p = h_in.data[i];
-            h_pos.data[n] = p.pos;
-            h_vel.data[n] = p.vel;
+            h_pos.data[n] = mpcd::detail::make_position(make_scalar3(p.pos.x, p.pos.y, p.pos.z),
+                                                        __scalar_as_int(p.pos.w),
+                                                        m_pos_grid);
+            h_vel.data[n] = mpcd::detail::make_velocity(make_scalar3(p.vel.x, p.vel.y, p.vel.z),
+                                                        __scalar_as_int(p.vel.w));
             h_tag.data[n] = p.tag;
             h_comm_flags.data[n] = p.comm_flag & ~mask; // unset the bitmask after communication
             n++;
@@ -1043,8 +1102,8 @@ void mpcd::ParticleData::removeParticlesGPU(GPUVector<mpcd::detail::pdata_elemen
         ArrayHandle<mpcd::detail::pdata_element> d_out(out, access_location::device, access_mode::overwrite);
 
         // access particle data arrays to read from
-        ArrayHandle<Scalar4> d_pos(m_pos, access_location::device, access_mode::readwrite);
-        ArrayHandle<Scalar4> d_vel(m_vel, access_location::device, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::pos_t> d_pos(m_pos, access_location::device, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::vel_t> d_vel(m_vel, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_tag(m_tag, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_comm_flags(m_comm_flags, access_location::device, access_mode::readwrite);
 
@@ -1059,6 +1118,7 @@ void mpcd::ParticleData::removeParticlesGPU(GPUVector<mpcd::detail::pdata_elemen
                                     d_remove_ids.data,
                                     n_remove,
                                     m_N,
+                                    m_pos_grid,
                                     m_remove_tuner->getParam());
         m_remove_tuner->end();
         if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
@@ -1086,8 +1146,8 @@ void mpcd::ParticleData::addParticlesGPU(const GPUVector<mpcd::detail::pdata_ele
 
         {
         // access particle data arrays
-        ArrayHandle<Scalar4> d_pos(m_pos, access_location::device, access_mode::readwrite);
-        ArrayHandle<Scalar4> d_vel(m_vel, access_location::device, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::pos_t> d_pos(m_pos, access_location::device, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::vel_t> d_vel(m_vel, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_tag(m_tag, access_location::device, access_mode::readwrite);
         ArrayHandle<unsigned int> d_comm_flags(m_comm_flags, access_location::device, access_mode::readwrite);
 
@@ -1104,6 +1164,7 @@ void mpcd::ParticleData::addParticlesGPU(const GPUVector<mpcd::detail::pdata_ele
                                  d_comm_flags.data,
                                  d_in.data,
                                  mask,
+                                 m_pos_grid,
                                  m_add_tuner->getParam());
         m_add_tuner->end();
         if (m_exec_conf->isCUDAErrorCheckingEnabled()) CHECK_CUDA_ERROR();
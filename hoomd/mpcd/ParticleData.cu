@@ -30,18 +30,21 @@ namespace kernel
  * \param d_remove_ids Partitioned indexes of particles to remove (first) followed by keep (last)
  * \param n_remove Number of particles to remove
  * \param N Number of local particles
+ * \param pos_grid Grid for compact positions
  *
  * Particles are removed using the result of cub::DevicePartition, which constructs
- * a list of particles to keep and remove.
+ * a list of particles to keep and remove. The packed data is unpacked into absolute
+ * Scalar4 positions and velocities.
  */
 __global__ void remove_particles(mpcd::detail::pdata_element *d_out,
-                                 Scalar4 *d_pos,
-                                 Scalar4 *d_vel,
+                                 mpcd::detail::pos_t *d_pos,
+                                 mpcd::detail::vel_t *d_vel,
                                  unsigned int *d_tag,
                                  unsigned int *d_comm_flags,
                                  const unsigned int *d_remove_ids,
                                  const unsigned int n_remove,
-                                 const unsigned int N)
+                                 const unsigned int N,
+                                 const mpcd::detail::PositionGrid pos_grid)
     {
     // one thread per particle
     unsigned int idx = blockIdx.x*blockDim.x + threadIdx.x;
@@ -50,8 +53,12 @@ __global__ void remove_particles(mpcd::detail::pdata_element *d_out,
 
     // pack a comm element
     mpcd::detail::pdata_element p;
-    p.pos = d_pos[pid];
-    p.vel = d_vel[pid];
+    const mpcd::detail::pos_t postype = d_pos[pid];
+    const mpcd::detail::vel_t velcell = d_vel[pid];
+    const Scalar3 pos = mpcd::detail::get_position(postype, pos_grid);
+    const Scalar3 vel = mpcd::detail::get_velocity(velcell);
+    p.pos = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(mpcd::detail::get_type(postype)));
+    p.vel = make_scalar4(vel.x, vel.y, vel.z, __int_as_scalar(mpcd::detail::get_cell(velcell)));
     p.tag = d_tag[pid];
     p.comm_flag = d_comm_flags[pid];
     d_out[idx] = p;
@@ -170,6 +177,7 @@ cudaError_t mpcd::gpu::partition_particles(void *d_tmp,
  * \param d_remove_ids Partitioned indexes of particles to remove (first) or keep (last)
  * \param n_remove Number of particles to remove
  * \param N Current number of particles
+ * \param pos_grid Grid for compact positions
  * \param block_size Number of threads per block
  *
  * \returns cudaSuccess on completion.
@@ -177,13 +185,14 @@ cudaError_t mpcd::gpu::partition_particles(void *d_tmp,
  * \sa mpcd::gpu::kernel::remove_particles
  */
 cudaError_t mpcd::gpu::remove_particles(mpcd::detail::pdata_element *d_out,
-                                        Scalar4 *d_pos,
-                                        Scalar4 *d_vel,
+                                        mpcd::detail::pos_t *d_pos,
+                                        mpcd::detail::vel_t *d_vel,
                                         unsigned int *d_tag,
                                         unsigned int *d_comm_flags,
                                         unsigned int *d_remove_ids,
                                         const unsigned int n_remove,
                                         const unsigned int N,
+                                        const mpcd::detail::PositionGrid& pos_grid,
                                         const unsigned int block_size)
     {
     static unsigned int max_block_size = UINT_MAX;
@@ -203,7 +212,8 @@ cudaError_t mpcd::gpu::remove_particles(mpcd::detail::pdata_element *d_out,
                                                                   d_comm_flags,
                                                                   d_remove_ids,
                                                                   n_remove,
-                                                                  N);
+                                                                  N,
+                                                                  pos_grid);
     return cudaSuccess;
     }
 
@@ -224,18 +234,20 @@ namespace kernel
  * \param d_comm_flags Device array of communication flags
  * \param d_in Device array of packed input particle data
  * \param mask Bitwise mask for received particles to unmask
+ * \param pos_grid Grid for compact positions
  *
  * Particle data is appended to the end of the particle data arrays from the
  * packed buffer. Communication flags of new particles are unmasked.
  */
 __global__ void add_particles(unsigned int old_nparticles,
                               unsigned int num_add_ptls,
-                              Scalar4 *d_pos,
-                              Scalar4 *d_vel,
+                              mpcd::detail::pos_t *d_pos,
+                              mpcd::detail::vel_t *d_vel,
                               unsigned int *d_tag,
                               unsigned int *d_comm_flags,
                               const mpcd::detail::pdata_element *d_in,
-                              const unsigned int mask)
+                              const unsigned int mask,
+                              const mpcd::detail::PositionGrid pos_grid)
     {
     unsigned int idx = blockIdx.x * blockDim.x + threadIdx.x;
 
@@ -244,8 +256,11 @@ __global__ void add_particles(unsigned int old_nparticles,
     mpcd::detail::pdata_element p = d_in[idx];
 
     unsigned int add_idx = old_nparticles + idx;
-    d_pos[add_idx] = p.pos;
-    d_vel[add_idx] = p.vel;
+    d_pos[add_idx] = mpcd::detail::make_position(make_scalar3(p.pos.x, p.pos.y, p.pos.z),
+                                                 __scalar_as_int(p.pos.w),
+                                                 pos_grid);
+    d_vel[add_idx] = mpcd::detail::make_velocity(make_scalar3(p.vel.x, p.vel.y, p.vel.z),
+                                                 __scalar_as_int(p.vel.w));
     d_tag[add_idx] = p.tag;
     d_comm_flags[add_idx] = p.comm_flag & ~mask;
     }
@@ -262,6 +277,7 @@ __global__ void add_particles(unsigned int old_nparticles,
  * \param d_comm_flags Device array of communication flags
  * \param d_in Device array of packed input particle data
  * \param mask Bitwise mask for received particles to unmask
+ * \param pos_grid Grid for compact positions
  * \param block_size Number of threads per block
  *
  * Particle data is appended to the end of the particle data arrays from the
@@ -269,12 +285,13 @@ __global__ void add_particles(unsigned int old_nparticles,
  */
 void mpcd::gpu::add_particles(unsigned int old_nparticles,
                               unsigned int num_add_ptls,
-                              Scalar4 *d_pos,
-                              Scalar4 *d_vel,
+                              mpcd::detail::pos_t *d_pos,
+                              mpcd::detail::vel_t *d_vel,
                               unsigned int *d_tag,
                               unsigned int *d_comm_flags,
                               const mpcd::detail::pdata_element *d_in,
                               const unsigned int mask,
+                              const mpcd::detail::PositionGrid& pos_grid,
                               const unsigned int block_size)
     {
     static unsigned int max_block_size = UINT_MAX;
@@ -294,7 +311,8 @@ void mpcd::gpu::add_particles(unsigned int old_nparticles,
                                                                d_tag,
                                                                d_comm_flags,
                                                                d_in,
-                                                               mask);
+                                                               mask,
+                                                               pos_grid);
     }
 
 #endif // ENABLE_MPI
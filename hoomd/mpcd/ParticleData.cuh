@@ -38,24 +38,26 @@ cudaError_t partition_particles(void *d_tmp,
 
 //! Pack particle data into output buffer and remove marked particles
 cudaError_t remove_particles(mpcd::detail::pdata_element *d_out,
-                             Scalar4 *d_pos,
-                             Scalar4 *d_vel,
+                             mpcd::detail::pos_t *d_pos,
+                             mpcd::detail::vel_t *d_vel,
                              unsigned int *d_tag,
                              unsigned int *d_comm_flags,
                              unsigned int *d_remove_ids,
                              const unsigned int n_remove,
                              const unsigned int N,
+                             const mpcd::detail::PositionGrid& pos_grid,
                              const unsigned int block_size);
 
 //! Update particle data with new particles
 void add_particles(unsigned int old_nparticles,
                    unsigned int num_add_ptls,
-                   Scalar4 *d_pos,
-                   Scalar4 *d_vel,
+                   mpcd::detail::pos_t *d_pos,
+                   mpcd::detail::vel_t *d_vel,
                    unsigned int *d_tag,
                    unsigned int *d_comm_flags,
                    const mpcd::detail::pdata_element *d_in,
                    const unsigned int mask,
+                   const mpcd::detail::PositionGrid& pos_grid,
                    const unsigned int block_size);
 } // end namespace gpu
 } // end namespace mpcd
@@ -44,10 +44,15 @@ namespace mpcd
 /*!
  * MPCD particles are characterized by position, velocity, and mass. We assume all
  * particles have the same mass. The data is laid out as follows:
- * - position + type in array of Scalar4
- * - velocity + cell index in array of Scalar4
+ * - position + type in array of mpcd::detail::pos_t
+ * - velocity + cell index in array of mpcd::detail::vel_t
  * - tag in array of unsigned int
  *
+ * By default, pos_t and vel_t are Scalar4. With ENABLE_MPCD_COMPACT, they are float4
+ * and positions are stored relative to the storage grid returned by getPositionGrid(),
+ * which halves the memory used by the solvent in double precision builds. The stored
+ * values should always be read and written with the helpers in ParticleDataUtilities.h.
+ *
  * Unlike the standard ParticleData, a reverse tag mapping is not currently maintained
  * in order to save local memory. (That is, it is possible to read the tag of a local particle,
  * but it is not possible to efficiently find the local particle that has a given
@@ -132,13 +137,22 @@ class PYBIND11_EXPORT ParticleData
         std::string getNameByType(unsigned int type) const;
 
         //! Get array of MPCD particle positions
-        const GPUArray<Scalar4>& getPositions() const
+        const GPUArray<mpcd::detail::pos_t>& getPositions() const
             {
             return m_pos;
             }
 
+        //! Get the grid the MPCD particle positions are stored relative to
+        const mpcd::detail::PositionGrid& getPositionGrid() const
+            {
+            return m_pos_grid;
+            }
+
+        //! Move the grid the MPCD particle positions are stored relative to
+        void setLocalBox(const BoxDim& local_box);
+
         //! Get array of MPCD particle velocities
-        const GPUArray<Scalar4>& getVelocities() const
+        const GPUArray<mpcd::detail::vel_t>& getVelocities() const
             {
             return m_vel;
             }
@@ -203,38 +217,44 @@ class PYBIND11_EXPORT ParticleData
         //! \name swap methods
         //@{
         //! Get alternate array of MPCD particle positions
-        const GPUArray<Scalar4>& getAltPositions() const
+        const GPUArray<mpcd::detail::pos_t>& getAltPositions()
             {
+            checkAlternate(m_pos_alt);
             return m_pos_alt;
             }
 
         //! Swap out alternate MPCD particle position array
         void swapPositions()
             {
+            checkAlternate(m_pos_alt);
             m_pos.swap(m_pos_alt);
             }
 
         //! Get alternate array of MPCD particle velocities
-        const GPUArray<Scalar4>& getAltVelocities() const
+        const GPUArray<mpcd::detail::vel_t>& getAltVelocities()
             {
+            checkAlternate(m_vel_alt);
             return m_vel_alt;
             }
 
         //! Swap out alternate MPCD particle velocity array
         void swapVelocities()
             {
+            checkAlternate(m_vel_alt);
             m_vel.swap(m_vel_alt);
             }
 
         //! Get alternate array of MPCD particle tags
-        const GPUArray<unsigned int>& getAltTags() const
+        const GPUArray<unsigned int>& getAltTags()
             {
+            checkAlternate(m_tag_alt);
             return m_tag_alt;
             }
 
         //! Swap out alternate MPCD particle tags
         void swapTags()
             {
+            checkAlternate(m_tag_alt);
             m_tag.swap(m_tag_alt);
             }
         //@}
@@ -327,14 +347,16 @@ class PYBIND11_EXPORT ParticleData
             }
 
         //! Get the alternate MPCD particle communication flags
-        const GPUArray<unsigned int>& getAltCommFlags() const
+        const GPUArray<unsigned int>& getAltCommFlags()
             {
+            checkAlternate(m_comm_flags_alt);
             return m_comm_flags_alt;
             }
 
         //! Swap out alternate MPCD communication flags
         void swapCommFlags()
             {
+            checkAlternate(m_comm_flags_alt);
             m_comm_flags.swap(m_comm_flags_alt);
             }
 
@@ -350,8 +372,9 @@ class PYBIND11_EXPORT ParticleData
         std::shared_ptr<DomainDecomposition> m_decomposition;       //!< Domain decomposition
         std::shared_ptr<Profiler> m_prof;                           //!< Profiler
 
-        GPUArray<Scalar4> m_pos;    //!< MPCD particle positions plus type
-        GPUArray<Scalar4> m_vel;    //!< MPCD particle velocities plus cell list id
+        GPUArray<mpcd::detail::pos_t> m_pos;    //!< MPCD particle positions plus type
+        GPUArray<mpcd::detail::vel_t> m_vel;    //!< MPCD particle velocities plus cell list id
+        mpcd::detail::PositionGrid m_pos_grid;  //!< Grid the positions are stored relative to
         Scalar m_mass;              //!< MPCD particle mass
         GPUArray<unsigned int> m_tag;   //!< MPCD particle tags
         std::vector<std::string> m_type_mapping;  //!< Type name mapping
@@ -359,9 +382,9 @@ class PYBIND11_EXPORT ParticleData
         GPUArray<unsigned int> m_comm_flags;    //!< MPCD particle communication flags
         #endif // ENABLE_MPI
 
-        GPUArray<Scalar4> m_pos_alt;        //!< Alternate position array
-        GPUArray<Scalar4> m_vel_alt;        //!< Alternate velocity array
-        GPUArray<unsigned int> m_tag_alt;   //!< Alternate tag array
+        GPUArray<mpcd::detail::pos_t> m_pos_alt;    //!< Alternate position array (allocated on first use)
+        GPUArray<mpcd::detail::vel_t> m_vel_alt;    //!< Alternate velocity array (allocated on first use)
+        GPUArray<unsigned int> m_tag_alt;   //!< Alternate tag array (allocated on first use)
         #ifdef ENABLE_MPI
         GPUArray<unsigned int> m_comm_flags_alt;    //!< Alternate communication flags
         GPUArray<unsigned int> m_remove_ids;      //!< Partitioned indexes of particles to keep
@@ -384,6 +407,12 @@ class PYBIND11_EXPORT ParticleData
         //! Check if all particles lie within the box
         bool checkInBox(const std::shared_ptr<const mpcd::ParticleDataSnapshot> snapshot, const BoxDim& box);
 
+        //! Check that the number of types can be stored
+        void checkNumTypes() const;
+
+        //! Set the grid the positions are stored relative to
+        void setPositionGrid(const BoxDim& local_box);
+
         //! Set the global number of particles (for parallel simulations)
         void setNGlobal(unsigned int nglobal);
 
@@ -393,6 +422,25 @@ class PYBIND11_EXPORT ParticleData
         //! Reallocate data arrays
         void reallocate(unsigned int N_max);
 
+        //! Allocate an alternate data array if it has not been used yet
+        /*!
+         * \param alt Alternate data array
+         *
+         * The alternate arrays are only needed by methods that reorder or
+         * replace the particle data (e.g., sorting). They are allocated the first
+         * time they are requested so that simulations which never use them do not
+         * hold a second copy of the particle data in memory.
+         */
+        template<class T>
+        void checkAlternate(GPUArray<T>& alt)
+            {
+            if (alt.isNull() && m_N_max > 0)
+                {
+                GPUArray<T> tmp(m_N_max, m_exec_conf);
+                alt.swap(tmp);
+                }
+            }
+
         const static float resize_factor; //!< Amortized growth factor the data arrays
         //! Resize the data
         void resize(unsigned int N);
@@ -16,9 +16,22 @@
  * as utilities.
  *
  * This file should only include common sentinels, structures, etc.
+ *
+ * The layout of the stored positions and velocities depends on ENABLE_MPCD_COMPACT,
+ * so all code should access them through make_position(), get_position(), get_type(),
+ * make_velocity(), get_velocity(), get_cell(), and set_cell().
  */
 
 #include "hoomd/HOOMDMath.h"
+
+// HOSTDEVICE is __host__ __device__ when included in nvcc and blank when included into the host compiler
+#undef HOSTDEVICE
+#ifdef NVCC
+#define HOSTDEVICE __host__ __device__
+#else
+#define HOSTDEVICE
+#endif
+
 namespace mpcd
 {
 namespace detail
@@ -26,18 +39,187 @@ namespace detail
 //! Sentinel value to signify that this particle is not placed in a cell
 const unsigned int NO_CELL = 0xffffffff;
 
+#ifdef ENABLE_MPCD_COMPACT
+typedef float4 pos_t;   //!< Storage for the position (offset in the storage cell) and type (plus storage cell)
+typedef float4 vel_t;   //!< Storage for the velocity and MPCD cell index
+#else
+typedef Scalar4 pos_t;  //!< Storage for the position and type
+typedef Scalar4 vel_t;  //!< Storage for the velocity and MPCD cell index
+#endif // ENABLE_MPCD_COMPACT
+
+//! Number of storage cells per dimension for compact positions (9 bits)
+const unsigned int POSITION_GRID_DIM = 512;
+
+//! Number of bits left for the type in compact positions
+const unsigned int POSITION_TYPE_BITS = 5;
+
+//! Maximum number of types that can be stored in compact positions
+const unsigned int POSITION_MAX_TYPES = 1 << POSITION_TYPE_BITS;
+
+//! Grid that compact positions are stored relative to
+/*!
+ * With ENABLE_MPCD_COMPACT, positions are stored in single precision relative to the
+ * origin of a cell of a POSITION_GRID_DIM^3 grid covering the local simulation box.
+ * The index of the storage cell is packed into the bits of the type that are not used, so
+ * that the absolute position is recovered in full precision. This grid is independent of
+ * the (shifted) MPCD collision cells, and it is rebuilt by mpcd::ParticleData::setLocalBox()
+ * when the domain boundaries move. Particles outside the box are stored relative to the
+ * nearest storage cell, and lose precision in proportion to their distance from it until
+ * they are wrapped or migrated.
+ *
+ * Otherwise, positions are stored as absolute Scalar4 and the grid is not used.
+ */
+struct PositionGrid
+    {
+    //! Default constructor
+    HOSTDEVICE PositionGrid()
+        : lo(make_scalar3(0,0,0)), width(make_scalar3(1,1,1))
+        {}
+
+    //! Constructor
+    /*!
+     * \param lo_ Lower bound of the local box
+     * \param L Length of the local box
+     */
+    HOSTDEVICE PositionGrid(const Scalar3& lo_, const Scalar3& L)
+        : lo(lo_), width(L / Scalar(POSITION_GRID_DIM))
+        {}
+
+    Scalar3 lo;     //!< Origin of the grid
+    Scalar3 width;  //!< Width of a storage cell
+    };
+
+//! Pack a particle position for storage
+/*!
+ * \param r Position
+ * \param type Type
+ * \param grid Grid for compact positions
+ * \returns Stored position and type
+ */
+HOSTDEVICE inline pos_t make_position(const Scalar3& r, unsigned int type, const PositionGrid& grid)
+    {
+    #ifdef ENABLE_MPCD_COMPACT
+    // find the storage cell, clamping particles that have left the box
+    int3 c = make_int3((int)floor((r.x - grid.lo.x) / grid.width.x),
+                       (int)floor((r.y - grid.lo.y) / grid.width.y),
+                       (int)floor((r.z - grid.lo.z) / grid.width.z));
+    const int c_max = POSITION_GRID_DIM - 1;
+    c.x = (c.x < 0) ? 0 : ((c.x > c_max) ? c_max : c.x);
+    c.y = (c.y < 0) ? 0 : ((c.y > c_max) ? c_max : c.y);
+    c.z = (c.z < 0) ? 0 : ((c.z > c_max) ? c_max : c.z);
+
+    const unsigned int bits = type | ((unsigned int)c.x << POSITION_TYPE_BITS)
+                                   | ((unsigned int)c.y << (POSITION_TYPE_BITS+9))
+                                   | ((unsigned int)c.z << (POSITION_TYPE_BITS+18));
+    return make_float4(float(r.x - (grid.lo.x + Scalar(c.x) * grid.width.x)),
+                       float(r.y - (grid.lo.y + Scalar(c.y) * grid.width.y)),
+                       float(r.z - (grid.lo.z + Scalar(c.z) * grid.width.z)),
+                       __int_as_float(bits));
+    #else
+    return make_scalar4(r.x, r.y, r.z, __int_as_scalar(type));
+    #endif // ENABLE_MPCD_COMPACT
+    }
+
+//! Unpack a stored particle position
+/*!
+ * \param p Stored position and type
+ * \param grid Grid for compact positions
+ * \returns Position
+ */
+HOSTDEVICE inline Scalar3 get_position(const pos_t& p, const PositionGrid& grid)
+    {
+    #ifdef ENABLE_MPCD_COMPACT
+    const unsigned int bits = __float_as_int(p.w);
+    const unsigned int mask = POSITION_GRID_DIM - 1;
+    return make_scalar3(grid.lo.x + Scalar((bits >> POSITION_TYPE_BITS) & mask) * grid.width.x + Scalar(p.x),
+                        grid.lo.y + Scalar((bits >> (POSITION_TYPE_BITS+9)) & mask) * grid.width.y + Scalar(p.y),
+                        grid.lo.z + Scalar((bits >> (POSITION_TYPE_BITS+18)) & mask) * grid.width.z + Scalar(p.z));
+    #else
+    return make_scalar3(p.x, p.y, p.z);
+    #endif // ENABLE_MPCD_COMPACT
+    }
+
+//! Unpack the type of a stored particle position
+/*!
+ * \param p Stored position and type
+ * \returns Type
+ */
+HOSTDEVICE inline unsigned int get_type(const pos_t& p)
+    {
+    #ifdef ENABLE_MPCD_COMPACT
+    return __float_as_int(p.w) & (POSITION_MAX_TYPES - 1);
+    #else
+    return __scalar_as_int(p.w);
+    #endif // ENABLE_MPCD_COMPACT
+    }
+
+//! Pack a particle velocity for storage
+/*!
+ * \param v Velocity
+ * \param cell MPCD cell index
+ * \returns Stored velocity and cell
+ */
+HOSTDEVICE inline vel_t make_velocity(const Scalar3& v, unsigned int cell)
+    {
+    #ifdef ENABLE_MPCD_COMPACT
+    return make_float4(float(v.x), float(v.y), float(v.z), __int_as_float(cell));
+    #else
+    return make_scalar4(v.x, v.y, v.z, __int_as_scalar(cell));
+    #endif // ENABLE_MPCD_COMPACT
+    }
+
+//! Unpack a stored particle velocity
+/*!
+ * \param v Stored velocity and cell
+ * \returns Velocity
+ */
+HOSTDEVICE inline Scalar3 get_velocity(const vel_t& v)
+    {
+    return make_scalar3(v.x, v.y, v.z);
+    }
+
+//! Unpack the MPCD cell index of a stored particle velocity
+/*!
+ * \param v Stored velocity and cell
+ * \returns MPCD cell index
+ */
+HOSTDEVICE inline unsigned int get_cell(const vel_t& v)
+    {
+    #ifdef ENABLE_MPCD_COMPACT
+    return __float_as_int(v.w);
+    #else
+    return __scalar_as_int(v.w);
+    #endif // ENABLE_MPCD_COMPACT
+    }
+
+//! Set the MPCD cell index of a stored particle velocity
+/*!
+ * \param v Stored velocity and cell
+ * \param cell MPCD cell index
+ */
+HOSTDEVICE inline void set_cell(vel_t& v, unsigned int cell)
+    {
+    #ifdef ENABLE_MPCD_COMPACT
+    v.w = __int_as_float(cell);
+    #else
+    v.w = __int_as_scalar(cell);
+    #endif // ENABLE_MPCD_COMPACT
+    }
+
 #ifdef ENABLE_MPI
 //! Structure to store packed MPCD particle data
 /*!
  * This structure is used mostly for MPI communication during particle migration.
+ * The data is always stored in the full (non-compact) layout, so that positions
+ * can be repacked relative to the storage grid of the receiving rank.
  *
  * \sa mpcd::ParticleData::addParticles
  * \sa mpcd::ParticleData::removeParticles
  */
 struct pdata_element
     {
-    Scalar4 pos;            //!< Position
-    Scalar4 vel;            //!< Velocity
+    Scalar4 pos;            //!< Absolute position (x,y,z) and type (w)
+    Scalar4 vel;            //!< Velocity (x,y,z) and cell (w)
     unsigned int tag;       //!< Global tag
     unsigned int comm_flag; //!< Communication flag
     };
@@ -46,4 +228,6 @@ struct pdata_element
 } // end namespace detail
 } // end namespace mpcd
 
+#undef HOSTDEVICE
+
 #endif // MPCD_PARTICLE_DATA_UTILITIES_H_
@@ -0,0 +1,282 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/SDFGeometry.h
+ * \brief Definition of the MPCD geometry given by a tabulated signed distance field
+ */
+
+#ifndef MPCD_SDF_GEOMETRY_H_
+#define MPCD_SDF_GEOMETRY_H_
+
+#include "BoundaryGeometry.h"
+#include "hoomd/BoxDim.h"
+#include "hoomd/Index1D.h"
+
+#ifdef NVCC
+#define HOSTDEVICE __host__ __device__ inline
+#else
+#define HOSTDEVICE inline __attribute__((always_inline))
+#include <string>
+#endif // NVCC
+
+namespace mpcd
+{
+namespace detail
+{
+
+//! Geometry given by a signed distance field
+/*!
+ * The signed distance \f$\phi\f$ to the surface is tabulated on the nodes of a regular grid of \a dim points that
+ * spans the orthorhombic simulation box periodically. Node (i,j,k) is at \f$\mathbf{r}_{lo} + (i,j,k) \Delta\f$,
+ * where \f$\Delta = \mathbf{L}/\mathbf{dim}\f$, and is stored at index \f$i + n_x (j + n_y k)\f$. The distance is
+ * positive in the fluid and negative inside the solid, and it is trilinearly interpolated between the nodes.
+ *
+ * A particle that ends up in the solid is moved back along its path to the surface, which is found by bisection.
+ * The surface normal is the gradient of the interpolated field. A slip surface reflects the velocity through the
+ * surface, while a no-slip surface reverses it. The surface is stationary.
+ *
+ * The field must be a distance, i.e., its values on neighboring nodes cannot differ by more than the grid spacing.
+ * Then, each component of the gradient of the interpolated field is at most 1 and overlapsBoundary() can bound the
+ * field inside a box from its value at the center of the box.
+ *
+ * The geometry does not own the tabulated values, they are held by mpcd::SignedDistanceField.
+ */
+class __attribute__((visibility("default"))) SDFGeometry
+    {
+    public:
+        //! Constructor
+        /*!
+         * \param field Signed distance at the grid nodes (must be accessible wherever the geometry is used)
+         * \param dim Number of grid nodes along each direction
+         * \param lo Lower corner of the box spanned by the grid
+         * \param L Size of the box spanned by the grid
+         * \param bc Boundary condition at the surface (slip or no-slip)
+         */
+        HOSTDEVICE SDFGeometry(const Scalar *field, const uint3& dim, const Scalar3& lo, const Scalar3& L, boundary bc)
+            : m_field(field), m_indexer(dim.x, dim.y, dim.z), m_lo(lo), m_L(L),
+              m_inv_spacing(make_scalar3(dim.x/L.x, dim.y/L.y, dim.z/L.z)), m_bc(bc)
+            { }
+
+        //! Detect collision between the particle and the boundary
+        /*!
+         * \param pos Proposed particle position
+         * \param vel Proposed particle velocity
+         * \param dt Integration time remaining
+         *
+         * \returns True if a collision occurred, and false otherwise
+         *
+         * \post The particle position \a pos is moved to the point of reflection, the velocity \a vel is updated
+         *       according to the appropriate bounce back rule, and the integration time \a dt is decreased to the
+         *       amount of time remaining.
+         */
+        HOSTDEVICE bool detectCollision(Scalar3& pos, Scalar3& vel, Scalar& dt) const
+            {
+            // the particle must have been in the fluid before its last move for dt to have collided
+            if (!isOutside(pos) || getDistance(pos - dt*vel) < Scalar(0))
+                {
+                dt = Scalar(0);
+                return false;
+                }
+
+            // bisect the time since the crossing, keeping t_in on the fluid side of the surface
+            Scalar t_in = dt;
+            Scalar t_out = Scalar(0);
+            for (unsigned int i=0; i < 32; ++i)
+                {
+                const Scalar t = Scalar(0.5)*(t_in + t_out);
+                if (getDistance(pos - t*vel) < Scalar(0))
+                    t_out = t;
+                else
+                    t_in = t;
+                }
+            dt = t_in;
+            pos -= dt*vel;
+
+            /*
+             * Apply boundary conditions. A slip surface only reverses the velocity along the normal, which is
+             * also done for no-slip surfaces or when the normal is ill-defined.
+             */
+            const Scalar3 n = getGradient(pos);
+            const Scalar nsq = dot(n,n);
+            const Scalar vn = dot(vel,n);
+            if (m_bc == boundary::slip && nsq > Scalar(0) && vn < Scalar(0))
+                {
+                vel -= (Scalar(2.0)*vn/nsq)*n;
+                }
+            else
+                {
+                vel = -vel;
+                }
+
+            return true;
+            }
+
+        //! Check if a particle is out of bounds
+        /*!
+         * \param pos Current particle position
+         * \returns True if particle is out of bounds, and false otherwise
+         */
+        HOSTDEVICE bool isOutside(const Scalar3& pos) const
+            {
+            return (getDistance(pos) < Scalar(0));
+            }
+
+        //! Check if a box may contain points outside the fluid
+        /*!
+         * \param lo Lower corner of the box
+         * \param hi Upper corner of the box
+         * \returns True if the interpolated field may become negative inside the box
+         *
+         * The field changes by at most the sum of the half widths of the box between its center and any point inside.
+         */
+        HOSTDEVICE bool overlapsBoundary(const Scalar3& lo, const Scalar3& hi) const
+            {
+            const Scalar3 center = Scalar(0.5)*(lo + hi);
+            const Scalar3 half = Scalar(0.5)*(hi - lo);
+            return (getDistance(center) <= half.x + half.y + half.z);
+            }
+
+        //! Validate that the simulation box matches the box spanned by the grid
+        /*!
+         * \param box Global simulation box
+         * \param cell_size Size of MPCD cell
+         */
+        HOSTDEVICE bool validateBox(const BoxDim& box, Scalar cell_size) const
+            {
+            const Scalar3 L = box.getL();
+            const Scalar3 lo = box.getLo();
+            const Scalar eps = Scalar(1e-5)*cell_size;
+
+            return (box.getTiltFactorXY() == Scalar(0) && box.getTiltFactorXZ() == Scalar(0) &&
+                    box.getTiltFactorYZ() == Scalar(0) &&
+                    fabs(L.x - m_L.x) < eps && fabs(L.y - m_L.y) < eps && fabs(L.z - m_L.z) < eps &&
+                    fabs(lo.x - m_lo.x) < eps && fabs(lo.y - m_lo.y) < eps && fabs(lo.z - m_lo.z) < eps);
+            }
+
+        //! Interpolate the signed distance
+        /*!
+         * \param pos Position
+         * \returns Signed distance to the surface, positive in the fluid
+         */
+        HOSTDEVICE Scalar getDistance(const Scalar3& pos) const
+            {
+            Scalar c[8];
+            Scalar3 t;
+            loadCorners(pos, c, t);
+
+            const Scalar c00 = c[0] + t.x*(c[1]-c[0]);
+            const Scalar c10 = c[2] + t.x*(c[3]-c[2]);
+            const Scalar c01 = c[4] + t.x*(c[5]-c[4]);
+            const Scalar c11 = c[6] + t.x*(c[7]-c[6]);
+            const Scalar c0 = c00 + t.y*(c10-c00);
+            const Scalar c1 = c01 + t.y*(c11-c01);
+            return c0 + t.z*(c1-c0);
+            }
+
+        //! Gradient of the interpolated signed distance
+        /*!
+         * \param pos Position
+         * \returns Gradient of the signed distance, pointing into the fluid
+         */
+        HOSTDEVICE Scalar3 getGradient(const Scalar3& pos) const
+            {
+            Scalar c[8];
+            Scalar3 t;
+            loadCorners(pos, c, t);
+
+            const Scalar gx = (Scalar(1)-t.y)*(Scalar(1)-t.z)*(c[1]-c[0]) + t.y*(Scalar(1)-t.z)*(c[3]-c[2])
+                              + (Scalar(1)-t.y)*t.z*(c[5]-c[4]) + t.y*t.z*(c[7]-c[6]);
+            const Scalar gy = (Scalar(1)-t.x)*(Scalar(1)-t.z)*(c[2]-c[0]) + t.x*(Scalar(1)-t.z)*(c[3]-c[1])
+                              + (Scalar(1)-t.x)*t.z*(c[6]-c[4]) + t.x*t.z*(c[7]-c[5]);
+            const Scalar gz = (Scalar(1)-t.x)*(Scalar(1)-t.y)*(c[4]-c[0]) + t.x*(Scalar(1)-t.y)*(c[5]-c[1])
+                              + (Scalar(1)-t.x)*t.y*(c[6]-c[2]) + t.x*t.y*(c[7]-c[3]);
+            return make_scalar3(gx*m_inv_spacing.x, gy*m_inv_spacing.y, gz*m_inv_spacing.z);
+            }
+
+        //! Get the velocity of the surface closest to a point
+        /*!
+         * \param pos Position
+         * \returns Zero, since the surface is stationary
+         */
+        HOSTDEVICE Scalar3 getSurfaceVelocity(const Scalar3& pos) const
+            {
+            return make_scalar3(Scalar(0), Scalar(0), Scalar(0));
+            }
+
+        //! Get the wall boundary condition
+        /*!
+         * \returns Boundary condition at wall
+         */
+        HOSTDEVICE boundary getBoundaryCondition() const
+            {
+            return m_bc;
+            }
+
+        //! Get the number of grid nodes along each direction
+        HOSTDEVICE uint3 getDim() const
+            {
+            return make_uint3(m_indexer.getW(), m_indexer.getH(), m_indexer.getD());
+            }
+
+        #ifndef NVCC
+        //! Get the unique name of this geometry
+        static std::string getName()
+            {
+            return std::string("SDF");
+            }
+        #endif // NVCC
+
+    private:
+        const Scalar *m_field;      //!< Signed distance at the grid nodes
+        const Index3D m_indexer;    //!< Indexer into the grid nodes
+        const Scalar3 m_lo;         //!< Lower corner of the grid
+        const Scalar3 m_L;          //!< Size of the box spanned by the grid
+        const Scalar3 m_inv_spacing;//!< Inverse of the grid spacing
+        const boundary m_bc;        //!< Boundary condition
+
+        //! Load the field at the corners of the grid cell that contains a position
+        /*!
+         * \param pos Position
+         * \param c (output) Field at the corners, with x varying fastest
+         * \param t (output) Fractional coordinates of \a pos inside the grid cell
+         */
+        HOSTDEVICE void loadCorners(const Scalar3& pos, Scalar *c, Scalar3& t) const
+            {
+            const Scalar3 f = make_scalar3((pos.x-m_lo.x)*m_inv_spacing.x,
+                                           (pos.y-m_lo.y)*m_inv_spacing.y,
+                                           (pos.z-m_lo.z)*m_inv_spacing.z);
+            const Scalar3 f0 = make_scalar3(floor(f.x), floor(f.y), floor(f.z));
+            t = f - f0;
+
+            // wrap the lower corner into the grid, the upper corner is the next node
+            const int nx = m_indexer.getW();
+            const int ny = m_indexer.getH();
+            const int nz = m_indexer.getD();
+            const int i0 = (((int)f0.x % nx) + nx) % nx;
+            const int j0 = (((int)f0.y % ny) + ny) % ny;
+            const int k0 = (((int)f0.z % nz) + nz) % nz;
+            const int i1 = (i0+1 < nx) ? i0+1 : 0;
+            const int j1 = (j0+1 < ny) ? j0+1 : 0;
+            const int k1 = (k0+1 < nz) ? k0+1 : 0;
+
+            c[0] = m_field[m_indexer(i0,j0,k0)];
+            c[1] = m_field[m_indexer(i1,j0,k0)];
+            c[2] = m_field[m_indexer(i0,j1,k0)];
+            c[3] = m_field[m_indexer(i1,j1,k0)];
+            c[4] = m_field[m_indexer(i0,j0,k1)];
+            c[5] = m_field[m_indexer(i1,j0,k1)];
+            c[6] = m_field[m_indexer(i0,j1,k1)];
+            c[7] = m_field[m_indexer(i1,j1,k1)];
+            }
+    };
+
+} // end namespace detail
+} // end namespace mpcd
+
+// undefine HOSTDEVICE so we don't interfere with other headers
+#undef HOSTDEVICE
+
+#endif // MPCD_SDF_GEOMETRY_H_
@@ -131,7 +131,7 @@ void mpcd::SRDCollisionMethod::drawRotationVectors(unsigned int timestep)
 void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
     {
     // acquire MPCD particle data
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::detail::vel_t> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::readwrite);
     const unsigned int N_mpcd = m_mpcd_pdata->getN();
     unsigned int N_tot = N_mpcd;
     // acquire additionally embedded particle data
@@ -171,9 +171,9 @@ void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
         unsigned int idx(0); double mass(0);
         if (cur_p < N_mpcd)
             {
-            const Scalar4 vel_cell = h_vel.data[cur_p];
+            const mpcd::detail::vel_t vel_cell = h_vel.data[cur_p];
             vel = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
-            cell = __scalar_as_int(vel_cell.w);
+            cell = mpcd::detail::get_cell(vel_cell);
             }
         else
             {
@@ -224,7 +224,7 @@ void mpcd::SRDCollisionMethod::rotate(unsigned int timestep)
         // set the new velocity
         if (cur_p < N_mpcd)
             {
-            h_vel.data[cur_p] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, __int_as_scalar(cell));
+            h_vel.data[cur_p] = mpcd::detail::make_velocity(make_scalar3(new_vel.x, new_vel.y, new_vel.z), cell);
             }
         else
             {
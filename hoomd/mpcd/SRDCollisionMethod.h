@@ -40,6 +40,12 @@ class PYBIND11_EXPORT SRDCollisionMethod : public mpcd::CollisionMethod
         //! Implementation of the collision rule
         virtual void collide(unsigned int timestep);
 
+        //! Discard the cell properties started by beginCollide()
+        virtual void cancelCollide()
+            {
+            m_thermo->cancelCompute();
+            }
+
         //! Get the MPCD rotation angle
         double getRotationAngle() const
             {
@@ -90,6 +96,12 @@ class PYBIND11_EXPORT SRDCollisionMethod : public mpcd::CollisionMethod
             }
 
     protected:
+        //! Start the calculation of the cell properties used by the collision rule
+        virtual void beginCellProperties(unsigned int timestep)
+            {
+            m_thermo->beginCompute(timestep);
+            }
+
         std::shared_ptr<mpcd::CellThermoCompute> m_thermo;  //!< Cell thermo
         GPUVector<double3> m_rotvec;    //!< MPCD rotation vectors
         double m_angle; //!< MPCD rotation angle (radians)
@@ -71,7 +71,7 @@ void mpcd::SRDCollisionMethodGPU::drawRotationVectors(unsigned int timestep)
 void mpcd::SRDCollisionMethodGPU::rotate(unsigned int timestep)
     {
     // acquire MPCD particle data
-    ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
+    ArrayHandle<mpcd::detail::vel_t> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::readwrite);
     const unsigned int N_mpcd = m_mpcd_pdata->getN();
     unsigned int N_tot = N_mpcd;
 
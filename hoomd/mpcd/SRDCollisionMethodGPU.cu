@@ -87,7 +87,7 @@ __global__ void srd_draw_vectors(double3 *d_rotvec,
         d_factors[idx] = factor;
         }
     }
-__global__ void srd_rotate(Scalar4 *d_vel,
+__global__ void srd_rotate(mpcd::detail::vel_t *d_vel,
                            Scalar4 *d_vel_embed,
                            const unsigned int *d_embed_group,
                            const unsigned int *d_embed_cell_ids,
@@ -112,9 +112,9 @@ __global__ void srd_rotate(Scalar4 *d_vel,
     unsigned int idx(0); double mass(0);
     if (tid < N_mpcd)
         {
-        const Scalar4 vel_cell = d_vel[tid];
+        const mpcd::detail::vel_t vel_cell = d_vel[tid];
         vel = make_double3(vel_cell.x, vel_cell.y, vel_cell.z);
-        cell = __scalar_as_int(vel_cell.w);
+        cell = mpcd::detail::get_cell(vel_cell);
         }
     else
         {
@@ -163,7 +163,7 @@ __global__ void srd_rotate(Scalar4 *d_vel,
     // set the new velocity
     if (tid < N_mpcd)
         {
-        d_vel[tid] = make_scalar4(new_vel.x, new_vel.y, new_vel.z, __int_as_scalar(cell));
+        d_vel[tid] = mpcd::detail::make_velocity(make_scalar3(new_vel.x, new_vel.y, new_vel.z), cell);
         }
     else
         {
@@ -244,7 +244,7 @@ cudaError_t srd_draw_vectors(double3 *d_rotvec,
     return cudaSuccess;
     }
 
-cudaError_t srd_rotate(Scalar4 *d_vel,
+cudaError_t srd_rotate(mpcd::detail::vel_t *d_vel,
                        Scalar4 *d_vel_embed,
                        const unsigned int *d_embed_group,
                        const unsigned int *d_embed_cell_ids,
@@ -0,0 +1,67 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/SignedDistanceField.cc
+ * \brief Definition of mpcd::SignedDistanceField
+ */
+
+#include "SignedDistanceField.h"
+#include "hoomd/extern/pybind/include/pybind11/stl.h"
+
+/*!
+ * \param exec_conf Execution configuration
+ * \param box Global simulation box spanned by the grid
+ * \param nx Number of grid nodes along x
+ * \param ny Number of grid nodes along y
+ * \param nz Number of grid nodes along z
+ * \param values Signed distance at the grid nodes, with x varying fastest
+ * \param bc Boundary condition at the surface
+ */
+mpcd::SignedDistanceField::SignedDistanceField(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                               const BoxDim& box,
+                                               unsigned int nx,
+                                               unsigned int ny,
+                                               unsigned int nz,
+                                               const std::vector<Scalar>& values,
+                                               mpcd::detail::boundary bc)
+    : m_field(values.begin(), values.end(), managed_allocator<Scalar>(exec_conf->isCUDAEnabled())),
+      m_geom(m_field.data(), make_uint3(nx, ny, nz), box.getLo(), box.getL(), bc)
+    {
+    if (nx == 0 || ny == 0 || nz == 0 || m_field.size() != (size_t)nx*ny*nz)
+        {
+        exec_conf->msg->error() << "mpcd: signed distance field must have " << nx << " x " << ny << " x " << nz
+                                << " values, but " << values.size() << " are given" << std::endl;
+        throw std::runtime_error("Invalid signed distance field");
+        }
+
+    if (box.getTiltFactorXY() != Scalar(0.0) ||
+        box.getTiltFactorXZ() != Scalar(0.0) ||
+        box.getTiltFactorYZ() != Scalar(0.0))
+        {
+        exec_conf->msg->error() << "mpcd: box of the signed distance field must be orthorhombic" << std::endl;
+        throw std::runtime_error("Box must be orthorhombic");
+        }
+    }
+
+/*!
+ * \returns Geometry that points to the field and keeps this object alive
+ */
+std::shared_ptr<const mpcd::detail::SDFGeometry> mpcd::SignedDistanceField::getGeometry()
+    {
+    return std::shared_ptr<const mpcd::detail::SDFGeometry>(shared_from_this(), &m_geom);
+    }
+
+/*!
+ * \param m Python module to export to
+ */
+void mpcd::detail::export_SignedDistanceField(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    py::class_<mpcd::SignedDistanceField, std::shared_ptr<mpcd::SignedDistanceField> >(m, "SignedDistanceField")
+        .def(py::init<std::shared_ptr<const ExecutionConfiguration>, const BoxDim&,
+                      unsigned int, unsigned int, unsigned int, const std::vector<Scalar>&, mpcd::detail::boundary>())
+        .def("getGeometry", &mpcd::SignedDistanceField::getGeometry);
+    }
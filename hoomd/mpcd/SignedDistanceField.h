@@ -0,0 +1,64 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/SignedDistanceField.h
+ * \brief Declaration of mpcd::SignedDistanceField
+ */
+
+#ifndef MPCD_SIGNED_DISTANCE_FIELD_H_
+#define MPCD_SIGNED_DISTANCE_FIELD_H_
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "SDFGeometry.h"
+
+#include "hoomd/ExecutionConfiguration.h"
+#include "hoomd/managed_allocator.h"
+#include "hoomd/extern/pybind/include/pybind11/pybind11.h"
+
+#include <memory>
+#include <vector>
+
+namespace mpcd
+{
+
+//! Storage of a tabulated signed distance field
+/*!
+ * The field values are held in memory that is accessible from both the host and the device when the execution
+ * configuration uses a GPU, so that the mpcd::detail::SDFGeometry that points to them can be passed by value to
+ * kernels. The geometry returned by getGeometry() shares ownership of this object.
+ */
+class PYBIND11_EXPORT SignedDistanceField : public std::enable_shared_from_this<SignedDistanceField>
+    {
+    public:
+        //! Constructor
+        SignedDistanceField(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                            const BoxDim& box,
+                            unsigned int nx,
+                            unsigned int ny,
+                            unsigned int nz,
+                            const std::vector<Scalar>& values,
+                            mpcd::detail::boundary bc);
+
+        //! Get the geometry that uses the field
+        std::shared_ptr<const mpcd::detail::SDFGeometry> getGeometry();
+
+    private:
+        std::vector<Scalar, managed_allocator<Scalar> > m_field;    //!< Signed distance at the grid nodes
+        mpcd::detail::SDFGeometry m_geom;                           //!< Geometry pointing to the field
+    };
+
+namespace detail
+{
+//! Export SignedDistanceField to python
+void export_SignedDistanceField(pybind11::module& m);
+} // end namespace detail
+
+} // end namespace mpcd
+
+#endif // MPCD_SIGNED_DISTANCE_FIELD_H_
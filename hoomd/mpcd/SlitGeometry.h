@@ -0,0 +1,207 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/SlitGeometry.h
+ * \brief Definition of the MPCD slit channel geometry
+ */
+
+#ifndef MPCD_SLIT_GEOMETRY_H_
+#define MPCD_SLIT_GEOMETRY_H_
+
+#include "BoundaryGeometry.h"
+#include "hoomd/BoxDim.h"
+
+#ifdef NVCC
+#define HOSTDEVICE __host__ __device__ inline
+#else
+#define HOSTDEVICE inline __attribute__((always_inline))
+#include <string>
+#endif // NVCC
+
+namespace mpcd
+{
+namespace detail
+{
+
+//! Parallel plate (slit) geometry
+/*!
+ * This class defines the geometry consistent with two infinite parallel plates. When the plates are
+ * in relative motion, this is also called Couette flow.
+ *
+ * The channel geometry is defined by two parameters: the channel half-width \a H, and the velocity
+ * of the plates \a V. The total distance between the plates is \f$2H\f$. The plates are stacked in the
+ * \a z direction, and are centered about the origin \f$z=0\f$. The upper plate moves in the \f$+x\f$ direction
+ * with velocity \a V, and the lower plate moves in the \f$-x\f$ direction with velocity \f$-V\f$. Hence, for
+ * no-slip boundary conditions there is a velocity profile:
+ *
+ * \f[
+ *      v_x(z) = \frac{Vz}{H}
+ * \f]
+ *
+ * This gives an effective shear rate \f$\dot\gamma = V/H\f$, and the shear stress is \f$\sigma_{xz}\f$.
+ *
+ * The geometry enforces boundary conditions \b only on the MPCD solvent particles. Additional interactions
+ * are required with any embedded particles to appropriately confine them.
+ */
+class __attribute__((visibility("default"))) SlitGeometry
+    {
+    public:
+        //! Constructor
+        /*!
+         * \param H Channel half-width
+         * \param V Velocity of the wall
+         * \param bc Boundary condition at the wall (slip or no-slip)
+         */
+        HOSTDEVICE SlitGeometry(Scalar H, Scalar V, boundary bc)
+            : m_H(H), m_V(V), m_bc(bc)
+            { }
+
+        //! Detect collision between the particle and the boundary
+        /*!
+         * \param pos Proposed particle position
+         * \param vel Proposed particle velocity
+         * \param dt Integration time remaining
+         *
+         * \returns True if a collision occurred, and false otherwise
+         *
+         * \post The particle position \a pos is moved to the point of reflection, the velocity \a vel is updated
+         *       according to the appropriate bounce back rule, and the integration time \a dt is decreased to the
+         *       amount of time remaining.
+         */
+        HOSTDEVICE bool detectCollision(Scalar3& pos, Scalar3& vel, Scalar& dt) const
+            {
+            /*
+             * Check if particle is in bounds, and exit immediately if it is. Otherwise, the particle must
+             * have crossed the wall it is moving towards since the last step.
+             */
+            const signed char sign = (char)((pos.z > m_H) - (pos.z < -m_H));
+            if (sign == 0 || sign*vel.z <= Scalar(0))
+                {
+                dt = Scalar(0);
+                return false;
+                }
+
+            /*
+             * Remaining integration time dt is amount of time spent traveling distance out of bounds.
+             * If only moving in the z direction, then the particle went "too far" by pos.z - sign*H.
+             */
+            dt = (pos.z - sign*m_H)/vel.z;
+
+            // backtrack the particle for dt to get to point of contact
+            pos.x -= vel.x*dt;
+            pos.y -= vel.y*dt;
+            pos.z = sign*m_H;
+
+            /*
+             * Apply boundary conditions. The normal component of the velocity is always reversed.
+             * For no-slip walls, the tangential components are reflected through the wall velocity
+             * (+V for the upper wall, -V for the lower wall).
+             */
+            if (m_bc == boundary::no_slip)
+                {
+                vel.x = -vel.x + Scalar(sign * 2) * m_V;
+                vel.y = -vel.y;
+                }
+            vel.z = -vel.z;
+
+            return true;
+            }
+
+        //! Check if a particle is out of bounds
+        /*!
+         * \param pos Current particle position
+         * \returns True if particle is out of bounds, and false otherwise
+         */
+        HOSTDEVICE bool isOutside(const Scalar3& pos) const
+            {
+            return (pos.z > m_H || pos.z < -m_H);
+            }
+
+        //! Check if a box may contain points outside the channel
+        /*!
+         * \param lo Lower corner of the box
+         * \param hi Upper corner of the box
+         * \returns True if the box touches or crosses a wall
+         */
+        HOSTDEVICE bool overlapsBoundary(const Scalar3& lo, const Scalar3& hi) const
+            {
+            return (hi.z >= m_H || lo.z <= -m_H);
+            }
+
+        //! Validate that the simulation box is large enough for the geometry
+        /*!
+         * \param box Global simulation box
+         * \param cell_size Size of MPCD cell
+         *
+         * The box is large enough for the slit if it is padded along the z direction so that
+         * the cells just outside the slit would not interact with each other through the boundary.
+         */
+        HOSTDEVICE bool validateBox(const BoxDim& box, Scalar cell_size) const
+            {
+            const Scalar hi = box.getHi().z;
+            const Scalar lo = box.getLo().z;
+
+            return ((hi-m_H) >= cell_size && ((-m_H-lo) >= cell_size));
+            }
+
+        //! Get channel half width
+        /*!
+         * \returns Channel half width
+         */
+        HOSTDEVICE Scalar getH() const
+            {
+            return m_H;
+            }
+
+        //! Get the wall velocity
+        /*!
+         * \returns Wall velocity
+         */
+        HOSTDEVICE Scalar getVelocity() const
+            {
+            return m_V;
+            }
+
+        //! Get the velocity of the surface closest to a point
+        /*!
+         * \param pos Position
+         * \returns Velocity of the wall on the same side of the channel as \a pos
+         */
+        HOSTDEVICE Scalar3 getSurfaceVelocity(const Scalar3& pos) const
+            {
+            return make_scalar3((pos.z > Scalar(0)) ? m_V : -m_V, Scalar(0), Scalar(0));
+            }
+
+        //! Get the wall boundary condition
+        /*!
+         * \returns Boundary condition at wall
+         */
+        HOSTDEVICE boundary getBoundaryCondition() const
+            {
+            return m_bc;
+            }
+
+        #ifndef NVCC
+        //! Get the unique name of this geometry
+        static std::string getName()
+            {
+            return std::string("Slit");
+            }
+        #endif // NVCC
+
+    private:
+        const Scalar m_H;       //!< Half of the channel width
+        const Scalar m_V;       //!< Velocity of the wall
+        const boundary m_bc;    //!< Boundary condition
+    };
+
+} // end namespace detail
+} // end namespace mpcd
+
+// undefine HOSTDEVICE so we don't interfere with other headers
+#undef HOSTDEVICE
+
+#endif // MPCD_SLIT_GEOMETRY_H_
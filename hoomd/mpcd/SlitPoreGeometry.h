@@ -0,0 +1,229 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/SlitPoreGeometry.h
+ * \brief Definition of the MPCD slit pore geometry
+ */
+
+#ifndef MPCD_SLIT_PORE_GEOMETRY_H_
+#define MPCD_SLIT_PORE_GEOMETRY_H_
+
+#include "BoundaryGeometry.h"
+#include "hoomd/BoxDim.h"
+
+#ifdef NVCC
+#define HOSTDEVICE __host__ __device__ inline
+#else
+#define HOSTDEVICE inline __attribute__((always_inline))
+#include <string>
+#endif // NVCC
+
+namespace mpcd
+{
+namespace detail
+{
+
+//! Parallel plate (slit) pore geometry
+/*!
+ * This class defines the geometry of a slit of finite length that connects two reservoirs. The pore is bounded by
+ * two plates of length \f$2L\f$ in \a x that are centered about the origin, and the half-width of the pore is \a H.
+ * The solid walls hence fill the region \f$|x| < L\f$ and \f$|z| > H\f$, and the fluid is unconfined for
+ * \f$|x| \ge L\f$. The surfaces of the walls are the faces \f$|z| = H\f$ inside the pore and \f$|x| = L\f$ toward
+ * the reservoirs. The walls do not move.
+ *
+ * The geometry enforces boundary conditions \b only on the MPCD solvent particles. Additional interactions
+ * are required with any embedded particles to appropriately confine them.
+ */
+class __attribute__((visibility("default"))) SlitPoreGeometry
+    {
+    public:
+        //! Constructor
+        /*!
+         * \param H Pore half-width
+         * \param L Pore half-length
+         * \param bc Boundary condition at the wall (slip or no-slip)
+         */
+        HOSTDEVICE SlitPoreGeometry(Scalar H, Scalar L, boundary bc)
+            : m_H(H), m_L(L), m_bc(bc)
+            { }
+
+        //! Detect collision between the particle and the boundary
+        /*!
+         * \param pos Proposed particle position
+         * \param vel Proposed particle velocity
+         * \param dt Integration time remaining
+         *
+         * \returns True if a collision occurred, and false otherwise
+         *
+         * \post The particle position \a pos is moved to the point of reflection, the velocity \a vel is updated
+         *       according to the appropriate bounce back rule, and the integration time \a dt is decreased to the
+         *       amount of time remaining.
+         */
+        HOSTDEVICE bool detectCollision(Scalar3& pos, Scalar3& vel, Scalar& dt) const
+            {
+            if (!isOutside(pos))
+                {
+                dt = Scalar(0);
+                return false;
+                }
+
+            /*
+             * Each wall is the intersection of the half spaces -L < x < L and sign*z > H, so the particle entered
+             * it through the face that it reaches first when it is moved backwards along its path. Only faces that
+             * the particle is moving into are candidates.
+             */
+            const signed char sign = (char)((pos.z > Scalar(0)) - (pos.z < Scalar(0)));
+            Scalar dt_z = dt;
+            bool hit_z = false;
+            if (sign*vel.z > Scalar(0))
+                {
+                dt_z = (pos.z - sign*m_H)/vel.z;
+                hit_z = true;
+                }
+            Scalar dt_x = dt;
+            bool hit_x = false;
+            if (vel.x > Scalar(0))
+                {
+                dt_x = (pos.x + m_L)/vel.x;
+                hit_x = true;
+                }
+            else if (vel.x < Scalar(0))
+                {
+                dt_x = (pos.x - m_L)/vel.x;
+                hit_x = true;
+                }
+
+            // pick the face that was crossed, which must have happened during the last move
+            const bool use_z = hit_z && (!hit_x || dt_z <= dt_x);
+            const Scalar dt_hit = (use_z) ? dt_z : dt_x;
+            if ((!hit_z && !hit_x) || dt_hit > dt)
+                {
+                dt = Scalar(0);
+                return false;
+                }
+            dt = dt_hit;
+
+            // backtrack the particle for dt to get to point of contact
+            pos.x -= vel.x*dt;
+            pos.y -= vel.y*dt;
+            pos.z -= vel.z*dt;
+
+            /*
+             * Apply boundary conditions. The normal component of the velocity is reversed for both conditions,
+             * and the tangential components are also reversed for no-slip walls.
+             */
+            if (m_bc == boundary::no_slip)
+                {
+                vel = -vel;
+                }
+            else if (use_z)
+                {
+                vel.z = -vel.z;
+                }
+            else
+                {
+                vel.x = -vel.x;
+                }
+
+            return true;
+            }
+
+        //! Check if a particle is out of bounds
+        /*!
+         * \param pos Current particle position
+         * \returns True if particle is out of bounds, and false otherwise
+         */
+        HOSTDEVICE bool isOutside(const Scalar3& pos) const
+            {
+            return ((pos.x > -m_L && pos.x < m_L) && (pos.z > m_H || pos.z < -m_H));
+            }
+
+        //! Check if a box may contain points outside the pore
+        /*!
+         * \param lo Lower corner of the box
+         * \param hi Upper corner of the box
+         * \returns True if the box touches or crosses a wall
+         */
+        HOSTDEVICE bool overlapsBoundary(const Scalar3& lo, const Scalar3& hi) const
+            {
+            return ((hi.x >= -m_L && lo.x <= m_L) && (hi.z >= m_H || lo.z <= -m_H));
+            }
+
+        //! Validate that the simulation box is large enough for the geometry
+        /*!
+         * \param box Global simulation box
+         * \param cell_size Size of MPCD cell
+         *
+         * The box is large enough for the pore if it is padded along the x and z direction so that
+         * the cells just outside the pore would not interact with each other through the boundary.
+         */
+        HOSTDEVICE bool validateBox(const BoxDim& box, Scalar cell_size) const
+            {
+            const Scalar3 hi = box.getHi();
+            const Scalar3 lo = box.getLo();
+
+            return ((hi.x-m_L) >= cell_size && ((-m_L-lo.x) >= cell_size) &&
+                    (hi.z-m_H) >= cell_size && ((-m_H-lo.z) >= cell_size));
+            }
+
+        //! Get pore half width
+        /*!
+         * \returns Pore half width
+         */
+        HOSTDEVICE Scalar getH() const
+            {
+            return m_H;
+            }
+
+        //! Get pore half length
+        /*!
+         * \returns Pore half length
+         */
+        HOSTDEVICE Scalar getL() const
+            {
+            return m_L;
+            }
+
+        //! Get the velocity of the surface closest to a point
+        /*!
+         * \param pos Position
+         * \returns Zero, since the walls are stationary
+         */
+        HOSTDEVICE Scalar3 getSurfaceVelocity(const Scalar3& pos) const
+            {
+            return make_scalar3(Scalar(0), Scalar(0), Scalar(0));
+            }
+
+        //! Get the wall boundary condition
+        /*!
+         * \returns Boundary condition at wall
+         */
+        HOSTDEVICE boundary getBoundaryCondition() const
+            {
+            return m_bc;
+            }
+
+        #ifndef NVCC
+        //! Get the unique name of this geometry
+        static std::string getName()
+            {
+            return std::string("SlitPore");
+            }
+        #endif // NVCC
+
+    private:
+        const Scalar m_H;       //!< Half of the pore width
+        const Scalar m_L;       //!< Half of the pore length
+        const boundary m_bc;    //!< Boundary condition
+    };
+
+} // end namespace detail
+} // end namespace mpcd
+
+// undefine HOSTDEVICE so we don't interfere with other headers
+#undef HOSTDEVICE
+
+#endif // MPCD_SLIT_PORE_GEOMETRY_H_
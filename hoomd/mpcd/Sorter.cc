@@ -108,12 +108,12 @@ void mpcd::Sorter::applyOrder() const
         {
         ArrayHandle<unsigned int> h_order(m_order, access_location::host, access_mode::read);
 
-        ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
-        ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::detail::vel_t> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
         ArrayHandle<unsigned int> h_tag(m_mpcd_pdata->getTags(), access_location::host, access_mode::read);
 
-        ArrayHandle<Scalar4> h_pos_alt(m_mpcd_pdata->getAltPositions(), access_location::host, access_mode::overwrite);
-        ArrayHandle<Scalar4> h_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::detail::pos_t> h_pos_alt(m_mpcd_pdata->getAltPositions(), access_location::host, access_mode::overwrite);
+        ArrayHandle<mpcd::detail::vel_t> h_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::host, access_mode::overwrite);
         ArrayHandle<unsigned int> h_tag_alt(m_mpcd_pdata->getAltTags(), access_location::host, access_mode::overwrite);
 
         for (unsigned int idx=0; idx < m_mpcd_pdata->getN(); ++idx)
@@ -110,12 +110,12 @@ void mpcd::SorterGPU::applyOrder() const
         {
         ArrayHandle<unsigned int> d_order(m_order, access_location::device, access_mode::read);
 
-        ArrayHandle<Scalar4> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::read);
-        ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
+        ArrayHandle<mpcd::detail::pos_t> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::read);
+        ArrayHandle<mpcd::detail::vel_t> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
         ArrayHandle<unsigned int> d_tag(m_mpcd_pdata->getTags(), access_location::device, access_mode::read);
 
-        ArrayHandle<Scalar4> d_pos_alt(m_mpcd_pdata->getAltPositions(), access_location::device, access_mode::overwrite);
-        ArrayHandle<Scalar4> d_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::device, access_mode::overwrite);
+        ArrayHandle<mpcd::detail::pos_t> d_pos_alt(m_mpcd_pdata->getAltPositions(), access_location::device, access_mode::overwrite);
+        ArrayHandle<mpcd::detail::vel_t> d_vel_alt(m_mpcd_pdata->getAltVelocities(), access_location::device, access_mode::overwrite);
         ArrayHandle<unsigned int> d_tag_alt(m_mpcd_pdata->getAltTags(), access_location::device, access_mode::overwrite);
 
         m_apply_tuner->begin();
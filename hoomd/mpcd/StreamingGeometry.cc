@@ -0,0 +1,61 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/StreamingGeometry.cc
+ * \brief Export functions for MPCD streaming geometries.
+ */
+
+#include "StreamingGeometry.h"
+
+/*!
+ * \param m Python module to export to
+ */
+void mpcd::detail::export_boundary(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    py::enum_<boundary>(m, "boundary")
+        .value("no_slip", boundary::no_slip)
+        .value("slip", boundary::slip);
+    }
+
+/*!
+ * \param m Python module to export to
+ */
+void mpcd::detail::export_SlitGeometry(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    py::class_<SlitGeometry, std::shared_ptr<const SlitGeometry> >(m, SlitGeometry::getName().c_str())
+        .def(py::init<Scalar, Scalar, boundary>())
+        .def("getH", &SlitGeometry::getH)
+        .def("getVelocity", &SlitGeometry::getVelocity)
+        .def("getBoundaryCondition", &SlitGeometry::getBoundaryCondition);
+    }
+
+/*!
+ * \param m Python module to export to
+ */
+void mpcd::detail::export_SlitPoreGeometry(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    py::class_<SlitPoreGeometry, std::shared_ptr<const SlitPoreGeometry> >(m, SlitPoreGeometry::getName().c_str())
+        .def(py::init<Scalar, Scalar, boundary>())
+        .def("getH", &SlitPoreGeometry::getH)
+        .def("getL", &SlitPoreGeometry::getL)
+        .def("getBoundaryCondition", &SlitPoreGeometry::getBoundaryCondition);
+    }
+
+/*!
+ * \param m Python module to export to
+ *
+ * The geometry is constructed by mpcd::SignedDistanceField, which owns the tabulated values.
+ */
+void mpcd::detail::export_SDFGeometry(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    py::class_<SDFGeometry, std::shared_ptr<const SDFGeometry> >(m, SDFGeometry::getName().c_str())
+        .def("getDistance", &SDFGeometry::getDistance)
+        .def("getBoundaryCondition", &SDFGeometry::getBoundaryCondition);
+    }
@@ -55,17 +55,17 @@ void mpcd::StreamingMethod::stream(unsigned int timestep)
 
     const BoxDim& box = m_mpcd_sys->getCellList()->getCoverageBox();
 
-    ArrayHandle<Scalar4> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
-    ArrayHandle<Scalar4> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<mpcd::detail::pos_t> h_pos(m_mpcd_pdata->getPositions(), access_location::host, access_mode::readwrite);
+    ArrayHandle<mpcd::detail::vel_t> h_vel(m_mpcd_pdata->getVelocities(), access_location::host, access_mode::read);
+    const mpcd::detail::PositionGrid& pos_grid = m_mpcd_pdata->getPositionGrid();
 
     for (unsigned int cur_p = 0; cur_p < m_mpcd_pdata->getN(); ++cur_p)
         {
-        const Scalar4 postype = h_pos.data[cur_p];
-        Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
-        const unsigned int type = __scalar_as_int(postype.w);
+        const mpcd::detail::pos_t postype = h_pos.data[cur_p];
+        Scalar3 pos = mpcd::detail::get_position(postype, pos_grid);
+        const unsigned int type = mpcd::detail::get_type(postype);
 
-        const Scalar4 vel_cell = h_vel.data[cur_p];
-        const Scalar3 vel = make_scalar3(vel_cell.x, vel_cell.y, vel_cell.z);
+        const Scalar3 vel = mpcd::detail::get_velocity(h_vel.data[cur_p]);
 
         // propagate the particle to its new position ballistically
         pos += m_mpcd_dt * vel;
@@ -74,7 +74,7 @@ void mpcd::StreamingMethod::stream(unsigned int timestep)
         int3 image = make_int3(0,0,0);
         box.wrap(pos, image);
 
-        h_pos.data[cur_p] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
+        h_pos.data[cur_p] = mpcd::detail::make_position(pos, type, pos_grid);
         }
 
     // particles have moved, so the cell cache is no longer valid
@@ -82,6 +82,32 @@ void mpcd::StreamingMethod::stream(unsigned int timestep)
     if (m_prof) m_prof->pop();
     }
 
+/*!
+ * \param timestep Current time to stream
+ * \param cell_timestep Timestep the cell list is next needed for collisions
+ * \param grid_shift Grid shift that will be in effect at \a cell_timestep
+ * \returns True if the particles were streamed, false if stream() must be called instead
+ *
+ * The ballistic streaming step is fused into the cell list build for \a cell_timestep, so that the solvent positions
+ * and velocities are read once. This is only possible if the particles are not streamed again before
+ * \a cell_timestep and if the cell list supports it (see mpcd::CellList::canComputeStreamed()).
+ */
+bool mpcd::StreamingMethod::streamCellList(unsigned int timestep,
+                                           unsigned int cell_timestep,
+                                           const Scalar3& grid_shift)
+    {
+    if (!peekStream(timestep) || timestep + m_period < cell_timestep)
+        return false;
+
+    std::shared_ptr<mpcd::CellList> cl = m_mpcd_sys->getCellList();
+    if (!cl->canComputeStreamed())
+        return false;
+
+    shouldStream(timestep);
+    cl->computeStreamed(cell_timestep, m_mpcd_dt, grid_shift);
+    return true;
+    }
+
 /*!
  * \param timestep Current timestep
  * \returns True when \a timestep is a \a m_period multiple of the the next timestep the streaming should occur
@@ -40,6 +40,9 @@ class PYBIND11_EXPORT StreamingMethod
         //! Implementation of the streaming rule
         virtual void stream(unsigned int timestep);
 
+        //! Stream the particles and build the cell list for a later timestep in one pass
+        virtual bool streamCellList(unsigned int timestep, unsigned int cell_timestep, const Scalar3& grid_shift);
+
         //! Peek if the next step requires streaming
         virtual bool peekStream(unsigned int timestep) const;
 
@@ -35,13 +35,14 @@ void mpcd::StreamingMethodGPU::stream(unsigned int timestep)
 
     if (m_prof) m_prof->push(m_exec_conf, "MPCD stream");
 
-    ArrayHandle<Scalar4> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::readwrite);
-    ArrayHandle<Scalar4> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
+    ArrayHandle<mpcd::detail::pos_t> d_pos(m_mpcd_pdata->getPositions(), access_location::device, access_mode::readwrite);
+    ArrayHandle<mpcd::detail::vel_t> d_vel(m_mpcd_pdata->getVelocities(), access_location::device, access_mode::read);
 
     m_tuner->begin();
     mpcd::gpu::stream(d_pos.data,
                       d_vel.data,
                       m_pdata->getBox(),
+                      m_mpcd_pdata->getPositionGrid(),
                       m_mpcd_dt,
                       m_mpcd_pdata->getN(),
                       m_tuner->getParam());
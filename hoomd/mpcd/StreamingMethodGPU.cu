@@ -22,6 +22,7 @@ namespace kernel
  * \param d_pos Particle positions
  * \param d_vel Particle velocities
  * \param box Simulation box
+ * \param pos_grid Grid for compact positions
  * \param dt Timestep to stream
  * \param N Number of particles
  *
@@ -34,9 +35,10 @@ namespace kernel
  * Particles crossing a periodic global boundary are wrapped back into the simulation box.
  * The particle positions are updated.
  */
-__global__ void stream(Scalar4 *d_pos,
-                       const Scalar4 *d_vel,
+__global__ void stream(mpcd::detail::pos_t *d_pos,
+                       const mpcd::detail::vel_t *d_vel,
                        const BoxDim box,
+                       const mpcd::detail::PositionGrid pos_grid,
                        const Scalar dt,
                        const unsigned int N)
     {
@@ -45,12 +47,11 @@ __global__ void stream(Scalar4 *d_pos,
     if (idx >= N)
         return;
 
-    const Scalar4 postype = d_pos[idx];
-    Scalar3 pos = make_scalar3(postype.x, postype.y, postype.z);
-    const unsigned int type = __scalar_as_int(postype.w);
+    const mpcd::detail::pos_t postype = d_pos[idx];
+    Scalar3 pos = mpcd::detail::get_position(postype, pos_grid);
+    const unsigned int type = mpcd::detail::get_type(postype);
 
-    const Scalar4 vel_cell = d_vel[idx];
-    const Scalar3 vel = make_scalar3(vel_cell.x, vel_cell.y, vel_cell.z);
+    const Scalar3 vel = mpcd::detail::get_velocity(d_vel[idx]);
 
     // propagate the particle to its new position ballistically
     pos += dt * vel;
@@ -59,7 +60,7 @@ __global__ void stream(Scalar4 *d_pos,
     int3 image = make_int3(0,0,0);
     box.wrap(pos, image);
 
-    d_pos[idx] = make_scalar4(pos.x, pos.y, pos.z, __int_as_scalar(type));
+    d_pos[idx] = mpcd::detail::make_position(pos, type, pos_grid);
     }
 
 } // end namespace kernel
@@ -68,15 +69,17 @@ __global__ void stream(Scalar4 *d_pos,
  * \param d_pos Particle positions
  * \param d_vel Particle velocities
  * \param box Simulation box
+ * \param pos_grid Grid for compact positions
  * \param dt Timestep to stream
  * \param N Number of particles
  * \param block_size Number of threads per block
  *
  * \sa mpcd::gpu::kernel::stream
  */
-cudaError_t stream(Scalar4 *d_pos,
-                   const Scalar4 *d_vel,
+cudaError_t stream(mpcd::detail::pos_t *d_pos,
+                   const mpcd::detail::vel_t *d_vel,
                    const BoxDim& box,
+                   const mpcd::detail::PositionGrid& pos_grid,
                    const Scalar dt,
                    const unsigned int N,
                    const unsigned int block_size)
@@ -91,7 +94,7 @@ cudaError_t stream(Scalar4 *d_pos,
 
     unsigned int run_block_size = min(block_size, max_block_size);
     dim3 grid(N / run_block_size + 1);
-    mpcd::gpu::kernel::stream<<<grid, run_block_size>>>(d_pos, d_vel, box, dt, N);
+    mpcd::gpu::kernel::stream<<<grid, run_block_size>>>(d_pos, d_vel, box, pos_grid, dt, N);
 
     return cudaSuccess;
     }
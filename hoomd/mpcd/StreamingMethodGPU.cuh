@@ -13,6 +13,7 @@
 
 #include <cuda_runtime.h>
 
+#include "ParticleDataUtilities.h"
 #include "hoomd/BoxDim.h"
 #include "hoomd/HOOMDMath.h"
 
@@ -22,9 +23,10 @@ namespace gpu
 {
 
 //! Kernel driver to stream particles ballistically
-cudaError_t stream(Scalar4 *d_pos,
-                   const Scalar4 *d_vel,
+cudaError_t stream(mpcd::detail::pos_t *d_pos,
+                   const mpcd::detail::vel_t *d_vel,
                    const BoxDim& box,
+                   const mpcd::detail::PositionGrid& pos_grid,
                    const Scalar dt,
                    const unsigned int N,
                    const unsigned int block_size);
@@ -40,7 +40,7 @@ mpcd::SystemData::SystemData(std::shared_ptr<::SystemDefinition> sysdef,
         }
 
     // connect to box change signal to enforce constant box dim in MPCD
-    m_sysdef->getParticleData()->getBoxChangeSignal().connect<mpcd::SystemData, &mpcd::SystemData::checkBox>(this);
+    m_sysdef->getParticleData()->getBoxChangeSignal().connect<mpcd::SystemData, &mpcd::SystemData::slotBoxChanged>(this);
 
     // check that the MPCD box matches the HOOMD box
     checkBox();
@@ -74,7 +74,7 @@ mpcd::SystemData::SystemData(std::shared_ptr<mpcd::SystemDataSnapshot> snapshot)
         }
 
     // connect to box change signal to enforce constant box dim in MPCD
-    m_sysdef->getParticleData()->getBoxChangeSignal().connect<mpcd::SystemData, &mpcd::SystemData::checkBox>(this);
+    m_sysdef->getParticleData()->getBoxChangeSignal().connect<mpcd::SystemData, &mpcd::SystemData::slotBoxChanged>(this);
 
     // check that the MPCD box matches the HOOMD box
     checkBox();
@@ -82,7 +82,7 @@ mpcd::SystemData::SystemData(std::shared_ptr<mpcd::SystemDataSnapshot> snapshot)
 
 mpcd::SystemData::~SystemData()
     {
-    m_sysdef->getParticleData()->getBoxChangeSignal().disconnect<mpcd::SystemData, &mpcd::SystemData::checkBox>(this);
+    m_sysdef->getParticleData()->getBoxChangeSignal().disconnect<mpcd::SystemData, &mpcd::SystemData::slotBoxChanged>(this);
     }
 
 //! Take a snapshot of the system
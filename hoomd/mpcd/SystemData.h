@@ -113,6 +113,13 @@ class PYBIND11_EXPORT SystemData
                 throw std::runtime_error("Changing global simulation box not supported");
                 }
             }
+
+        //! Check the box and move the position storage grid with the local box (e.g., after load balancing)
+        void slotBoxChanged()
+            {
+            checkBox();
+            m_particles->setLocalBox(m_sysdef->getParticleData()->getBox());
+            }
     };
 
 namespace detail
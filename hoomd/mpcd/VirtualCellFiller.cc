@@ -0,0 +1,162 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/VirtualCellFiller.cc
+ * \brief Definition of mpcd::VirtualCellFiller
+ */
+
+#include "VirtualCellFiller.h"
+#include "VirtualCellFillerUtilities.h"
+
+/*!
+ * \param sysdata MPCD system data
+ * \param density Number density of virtual particles
+ * \param T Temperature of virtual particles
+ * \param seed Seed for the random number generator
+ */
+mpcd::VirtualCellFiller::VirtualCellFiller(std::shared_ptr<mpcd::SystemData> sysdata,
+                                           Scalar density,
+                                           std::shared_ptr<::Variant> T,
+                                           unsigned int seed)
+    : m_sysdef(sysdata->getSystemDefinition()),
+      m_pdata(m_sysdef->getParticleData()),
+      m_exec_conf(m_pdata->getExecConf()),
+      m_mpcd_pdata(sysdata->getParticleData()),
+      m_cl(sysdata->getCellList()),
+      m_density(density), m_T(T), m_seed(seed),
+      m_cells(m_exec_conf), m_fill(m_exec_conf), m_virtual(m_exec_conf),
+      m_needs_cells(true)
+    {
+    m_exec_conf->msg->notice(5) << "Constructing MPCD VirtualCellFiller" << std::endl;
+
+    m_cl->getSizeChangeSignal().connect<mpcd::VirtualCellFiller, &mpcd::VirtualCellFiller::slotNumCellsChanged>(this);
+    }
+
+mpcd::VirtualCellFiller::~VirtualCellFiller()
+    {
+    m_exec_conf->msg->notice(5) << "Destroying MPCD VirtualCellFiller" << std::endl;
+    m_cl->getSizeChangeSignal().disconnect<mpcd::VirtualCellFiller, &mpcd::VirtualCellFiller::slotNumCellsChanged>(this);
+    }
+
+/*!
+ * \param timestep Current timestep
+ * \param cell_vel Normalized cell velocities and masses
+ * \param cell_energy Cell energies
+ * \param energy If true, \a cell_energy is updated
+ *
+ * The cell list must already be current for \a timestep.
+ */
+void mpcd::VirtualCellFiller::fill(unsigned int timestep,
+                                   GPUArray<double4>& cell_vel,
+                                   GPUArray<double3>& cell_energy,
+                                   bool energy)
+    {
+    if (m_needs_cells)
+        {
+        findCells();
+        m_fill.resize(m_cells.size());
+        m_virtual.resize(m_cells.size());
+        m_needs_cells = false;
+        }
+
+    if (m_cells.size() == 0) return;
+
+    computeFill();
+    drawVirtualParticles(timestep, cell_vel, cell_energy, energy);
+    }
+
+/*!
+ * \param upper Upper bound (exclusive) of the local cells to include
+ *
+ * \returns Momentum (x,y,z) and kinetic energy (w) of the virtual particles in the cells below \a upper
+ *
+ * This is used to remove the virtual particles from the net properties of mpcd::CellThermoCompute, which
+ * also excludes the duplicated communication cells on the upper faces of the domain with \a upper.
+ */
+double4 mpcd::VirtualCellFiller::getNetProperties(const uint3& upper)
+    {
+    double4 net = make_double4(0.0, 0.0, 0.0, 0.0);
+    if (m_cells.size() == 0) return net;
+
+    const Index3D& ci = m_cl->getCellIndexer();
+    ArrayHandle<unsigned int> h_cells(m_cells, access_location::host, access_mode::read);
+    ArrayHandle<double4> h_virtual(m_virtual, access_location::host, access_mode::read);
+    for (unsigned int idx=0; idx < m_cells.size(); ++idx)
+        {
+        const unsigned int cell = h_cells.data[idx];
+        const unsigned int i = cell % ci.getW();
+        const unsigned int j = (cell / ci.getW()) % ci.getH();
+        const unsigned int k = cell / (ci.getW() * ci.getH());
+        if (i >= upper.x || j >= upper.y || k >= upper.z) continue;
+
+        const double4 v = h_virtual.data[idx];
+        net.x += v.x; net.y += v.y; net.z += v.z; net.w += v.w;
+        }
+    return net;
+    }
+
+/*!
+ * \param timestep Current timestep
+ * \param cell_vel Normalized cell velocities and masses
+ * \param cell_energy Cell energies
+ * \param energy If true, \a cell_energy is updated
+ */
+void mpcd::VirtualCellFiller::drawVirtualParticles(unsigned int timestep,
+                                                   GPUArray<double4>& cell_vel,
+                                                   GPUArray<double3>& cell_energy,
+                                                   bool energy)
+    {
+    ArrayHandle<unsigned int> h_cells(m_cells, access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_fill(m_fill, access_location::host, access_mode::read);
+    ArrayHandle<double4> h_virtual(m_virtual, access_location::host, access_mode::overwrite);
+    ArrayHandle<double4> h_cell_vel(cell_vel, access_location::host, access_mode::readwrite);
+    ArrayHandle<double3> h_cell_energy(cell_energy, access_location::host, access_mode::readwrite);
+
+    const Index3D& ci = m_cl->getCellIndexer();
+    const Index3D& global_ci = m_cl->getGlobalCellIndexer();
+    const Scalar mass = m_mpcd_pdata->getMass();
+    const Scalar kT = m_T->getValue(timestep);
+    const unsigned int n_dimensions = m_sysdef->getNDimensions();
+
+    for (unsigned int idx=0; idx < m_cells.size(); ++idx)
+        {
+        const unsigned int cell = h_cells.data[idx];
+        const int3 local_cell = make_int3(cell % ci.getW(),
+                                          (cell / ci.getW()) % ci.getH(),
+                                          cell / (ci.getW() * ci.getH()));
+        const int3 global_cell = m_cl->getGlobalCell(local_cell);
+        const unsigned int global_idx = global_ci(global_cell.x, global_cell.y, global_cell.z);
+
+        double4 vel = h_cell_vel.data[cell];
+        double3 cell_e = (energy) ? h_cell_energy.data[cell] : make_double3(0.0, 0.0, 0.0);
+        h_virtual.data[idx] = mpcd::detail::add_virtual_particles(vel,
+                                                                  cell_e,
+                                                                  h_fill.data[idx],
+                                                                  mass,
+                                                                  kT,
+                                                                  n_dimensions,
+                                                                  energy,
+                                                                  global_idx,
+                                                                  timestep,
+                                                                  m_seed);
+        h_cell_vel.data[cell] = vel;
+        if (energy)
+            h_cell_energy.data[cell] = cell_e;
+        }
+    }
+
+/*!
+ * \param m Python module to export to
+ */
+void mpcd::detail::export_VirtualCellFiller(pybind11::module& m)
+    {
+    namespace py = pybind11;
+    py::class_<mpcd::VirtualCellFiller, std::shared_ptr<mpcd::VirtualCellFiller> >(m, "VirtualCellFiller")
+        .def("getDensity", &mpcd::VirtualCellFiller::getDensity)
+        .def("setDensity", &mpcd::VirtualCellFiller::setDensity)
+        .def("setTemperature", &mpcd::VirtualCellFiller::setTemperature)
+        .def("setSeed", &mpcd::VirtualCellFiller::setSeed);
+    }
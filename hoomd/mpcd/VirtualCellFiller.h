@@ -0,0 +1,147 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+/*!
+ * \file mpcd/VirtualCellFiller.h
+ * \brief Declaration of mpcd::VirtualCellFiller
+ */
+
+#ifndef MPCD_VIRTUAL_CELL_FILLER_H_
+#define MPCD_VIRTUAL_CELL_FILLER_H_
+
+#ifdef NVCC
+#error This header cannot be compiled by nvcc
+#endif
+
+#include "CellList.h"
+#include "SystemData.h"
+
+#include "hoomd/GPUVector.h"
+#include "hoomd/Variant.h"
+#include "hoomd/extern/pybind/include/pybind11/pybind11.h"
+
+namespace mpcd
+{
+
+//! Adds virtual particles to the cells that are cut by a confining surface
+/*!
+ * Cells that are cut by a surface hold fewer MPCD particles than cells in the bulk fluid, which weakens the no-slip
+ * condition at the surface. The usual remedy is to fill the solid part of these cells with virtual particles that
+ * move with the surface and have a Maxwell-Boltzmann distribution of velocities. Only the total mass, momentum, and
+ * kinetic energy of the virtual particles in each cell enter the collision, so they are drawn directly from their
+ * distributions instead of being stored in the mpcd::ParticleData.
+ *
+ * The cells that may be cut by the surface are found by findCells(), which is called again whenever the cell list
+ * dimensions change or requestFindCells() is called. For the current grid shift, computeFill() then sets the velocity
+ * of the surface and the mean number of virtual particles in each of these cells. Both depend on the geometry and are
+ * implemented by deriving classes (see mpcd::ConfinedVirtualCellFiller). The number of virtual particles is rounded
+ * stochastically, and their momentum and kinetic energy are drawn from the random number generator seeded with
+ * the global cell index and timestep, so that all ranks sharing a cell draw the same virtual particles.
+ *
+ * The virtual particles are added to the normalized cell properties of mpcd::CellThermoCompute after the outer
+ * cells have been reduced between ranks, and their momentum and kinetic energy are removed from the net properties.
+ */
+class PYBIND11_EXPORT VirtualCellFiller
+    {
+    public:
+        //! Constructor
+        VirtualCellFiller(std::shared_ptr<mpcd::SystemData> sysdata,
+                          Scalar density,
+                          std::shared_ptr<::Variant> T,
+                          unsigned int seed);
+
+        //! Destructor
+        virtual ~VirtualCellFiller();
+
+        //! Add virtual particles to the cell properties
+        void fill(unsigned int timestep, GPUArray<double4>& cell_vel, GPUArray<double3>& cell_energy, bool energy);
+
+        //! Get the momentum and kinetic energy of the virtual particles in the last call to fill()
+        double4 getNetProperties(const uint3& upper);
+
+        //! Get the number density of virtual particles
+        Scalar getDensity() const
+            {
+            return m_density;
+            }
+
+        //! Set the number density of virtual particles
+        void setDensity(Scalar density)
+            {
+            m_density = density;
+            }
+
+        //! Set the temperature of the virtual particles
+        void setTemperature(std::shared_ptr<::Variant> T)
+            {
+            m_T = T;
+            }
+
+        //! Set the seed of the random number generator
+        void setSeed(unsigned int seed)
+            {
+            m_seed = seed;
+            }
+
+        //! Set autotuner parameters
+        /*!
+         * \param enable Enable/disable autotuning
+         * \param period period (approximate) in time steps when returning occurs
+         */
+        virtual void setAutotunerParams(bool enable, unsigned int period)
+            {
+            }
+
+        //! Request that the cells cut by the surface are found again
+        void requestFindCells()
+            {
+            m_needs_cells = true;
+            }
+
+    protected:
+        std::shared_ptr<SystemDefinition> m_sysdef;                 //!< HOOMD system definition
+        std::shared_ptr<::ParticleData> m_pdata;                    //!< HOOMD particle data
+        std::shared_ptr<const ExecutionConfiguration> m_exec_conf;  //!< Execution configuration
+        std::shared_ptr<mpcd::ParticleData> m_mpcd_pdata;           //!< MPCD particle data
+        std::shared_ptr<mpcd::CellList> m_cl;                       //!< MPCD cell list
+
+        Scalar m_density;                   //!< Number density of virtual particles
+        std::shared_ptr<::Variant> m_T;     //!< Temperature of virtual particles
+        unsigned int m_seed;                //!< Seed for the random number generator
+
+        GPUVector<unsigned int> m_cells;    //!< Local indexes of the cells that may be cut by the surface
+        GPUVector<Scalar4> m_fill;          //!< Surface velocity (x,y,z) and mean number of virtual particles (w)
+        GPUVector<double4> m_virtual;       //!< Momentum (x,y,z) and kinetic energy (w) of the virtual particles
+        bool m_needs_cells;                 //!< Flag if the cells cut by the surface must be found
+
+        //! Find the cells that may be cut by the surface for any grid shift
+        virtual void findCells() = 0;
+
+        //! Compute the surface velocity and mean number of virtual particles in the cells
+        virtual void computeFill() = 0;
+
+        //! Draw the virtual particles and add them to the cell properties
+        virtual void drawVirtualParticles(unsigned int timestep,
+                                          GPUArray<double4>& cell_vel,
+                                          GPUArray<double3>& cell_energy,
+                                          bool energy);
+
+    private:
+        //! Slot for the cell list dimensions changing
+        void slotNumCellsChanged()
+            {
+            m_needs_cells = true;
+            }
+    };
+
+namespace detail
+{
+//! Export the VirtualCellFiller to python
+void export_VirtualCellFiller(pybind11::module& m);
+} // end namespace detail
+
+} // end namespace mpcd
+
+#endif // MPCD_VIRTUAL_CELL_FILLER_H_
@@ -0,0 +1,172 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+#ifndef MPCD_VIRTUAL_CELL_FILLER_UTILITIES_H_
+#define MPCD_VIRTUAL_CELL_FILLER_UTILITIES_H_
+
+/*!
+ * \file mpcd/VirtualCellFillerUtilities.h
+ * \brief Utilities for mpcd::VirtualCellFiller on the CPU and GPU
+ *
+ * The virtual particles are drawn the same way on the CPU and the GPU, so this
+ * code is split out here to avoid duplication.
+ */
+
+#include "RandomNumbers.h"
+
+#include "hoomd/BoxDim.h"
+#include "hoomd/HOOMDMath.h"
+#include "hoomd/Saru.h"
+
+#ifdef NVCC
+#define DEVICE __device__
+#else
+#define DEVICE
+#endif // NVCC
+
+namespace mpcd
+{
+namespace detail
+{
+
+//! Draw the virtual particles of a cell and add them to the cell properties
+/*!
+ * \param cell_vel Center of mass velocity (x,y,z) and mass (w) of the cell
+ * \param cell_energy Kinetic energy, temperature, and number of particles of the cell
+ * \param fill Surface velocity (x,y,z) and mean number of virtual particles (w) in the cell
+ * \param mass Mass of a virtual particle
+ * \param kT Temperature of the virtual particles
+ * \param n_dimensions Number of dimensions of the system
+ * \param energy If true, update \a cell_energy
+ * \param global_idx Global index of the cell
+ * \param timestep Current timestep
+ * \param seed Seed for the random number generator
+ *
+ * \returns Momentum (x,y,z) and kinetic energy (w) of the virtual particles
+ *
+ * The number of virtual particles is the integer part of \a fill.w, plus one with a probability equal to its
+ * fractional part. The velocities of the virtual particles are Maxwell-Boltzmann distributed around the surface
+ * velocity, so their total momentum is normally distributed, and their kinetic energy relative to their center
+ * of mass is gamma distributed. The kinetic energy is only drawn if \a energy is true.
+ */
+DEVICE inline double4 add_virtual_particles(double4& cell_vel,
+                                            double3& cell_energy,
+                                            const Scalar4& fill,
+                                            const Scalar mass,
+                                            const Scalar kT,
+                                            const unsigned int n_dimensions,
+                                            const bool energy,
+                                            const unsigned int global_idx,
+                                            const unsigned int timestep,
+                                            const unsigned int seed)
+    {
+    hoomd::detail::Saru rng(global_idx, timestep, seed);
+
+    // round the mean number of virtual particles stochastically
+    const unsigned int n_floor = (unsigned int)fill.w;
+    const unsigned int n = n_floor + ((rng.s<Scalar>() < fill.w - Scalar(n_floor)) ? 1 : 0);
+    if (n == 0)
+        return make_double4(0.0, 0.0, 0.0, 0.0);
+
+    // total momentum is normally distributed around the surface velocity
+    const double mass_v = n * mass;
+    const double sigma = slow::sqrt(mass_v * kT);
+    mpcd::detail::NormalGenerator<double> gen;
+    double3 momentum_v = make_double3(mass_v * fill.x + sigma * gen(rng),
+                                      mass_v * fill.y + sigma * gen(rng),
+                                      mass_v * fill.z);
+    if (n_dimensions == 3)
+        momentum_v.z += sigma * gen(rng);
+
+    // add the virtual particles to the center of mass velocity
+    const double mass_cell = cell_vel.w + mass_v;
+    const double3 vel_cm = make_double3((cell_vel.w * cell_vel.x + momentum_v.x) / mass_cell,
+                                        (cell_vel.w * cell_vel.y + momentum_v.y) / mass_cell,
+                                        (cell_vel.w * cell_vel.z + momentum_v.z) / mass_cell);
+    cell_vel = make_double4(vel_cm.x, vel_cm.y, vel_cm.z, mass_cell);
+
+    double ke_v(0.0);
+    if (energy)
+        {
+        // kinetic energy of the center of mass, plus the gamma distributed relative part
+        ke_v = 0.5 * (momentum_v.x*momentum_v.x + momentum_v.y*momentum_v.y + momentum_v.z*momentum_v.z) / mass_v;
+        if (n > 1)
+            {
+            mpcd::detail::GammaGenerator<double> gamma_gen(0.5 * n_dimensions * (n-1), kT);
+            ke_v += gamma_gen(rng);
+            }
+
+        const double ke = cell_energy.x + ke_v;
+        const unsigned int np = __double_as_int(cell_energy.z) + n;
+        double temp(0.0);
+        if (np > 1)
+            {
+            const double ke_cm = 0.5 * mass_cell * (vel_cm.x*vel_cm.x + vel_cm.y*vel_cm.y + vel_cm.z*vel_cm.z);
+            temp = 2. * (ke - ke_cm) / (n_dimensions * (np-1));
+            }
+        cell_energy = make_double3(ke, temp, __int_as_double(np));
+        }
+
+    return make_double4(momentum_v.x, momentum_v.y, momentum_v.z, ke_v);
+    }
+
+//! Number of points sampled along each direction of a cell to estimate the volume outside the fluid
+const unsigned int virtual_fill_samples = 4;
+
+//! Compute the surface velocity and mean number of virtual particles in a cell
+/*!
+ * \param lo Lower corner of the cell
+ * \param cell_size Cell width
+ * \param density Number density of virtual particles
+ * \param global_box Global simulation box
+ * \param geom Confined geometry
+ *
+ * \returns Surface velocity (x,y,z) and mean number of virtual particles (w) in the cell
+ *
+ * \tparam Geometry type of the confined geometry \a geom
+ *
+ * The volume of the cell that lies outside the fluid is estimated from a regular grid of
+ * virtual_fill_samples points along each direction, which are wrapped into the global box before they are
+ * tested. The surface velocity is the one closest to the center of the cell.
+ */
+template<class Geometry>
+DEVICE inline Scalar4 compute_virtual_fill(const Scalar3& lo,
+                                           const Scalar cell_size,
+                                           const Scalar density,
+                                           const BoxDim& global_box,
+                                           const Geometry& geom)
+    {
+    const Scalar spacing = cell_size / Scalar(virtual_fill_samples);
+    unsigned int num_outside = 0;
+    for (unsigned int k=0; k < virtual_fill_samples; ++k)
+        {
+        for (unsigned int j=0; j < virtual_fill_samples; ++j)
+            {
+            for (unsigned int i=0; i < virtual_fill_samples; ++i)
+                {
+                Scalar3 pos = lo + spacing*make_scalar3(Scalar(i)+Scalar(0.5),
+                                                        Scalar(j)+Scalar(0.5),
+                                                        Scalar(k)+Scalar(0.5));
+                int3 image = make_int3(0,0,0);
+                global_box.wrap(pos, image);
+                if (geom.isOutside(pos))
+                    ++num_outside;
+                }
+            }
+        }
+    const Scalar fraction = Scalar(num_outside) / Scalar(virtual_fill_samples*virtual_fill_samples*virtual_fill_samples);
+
+    Scalar3 center = lo + Scalar(0.5)*make_scalar3(cell_size, cell_size, cell_size);
+    int3 image = make_int3(0,0,0);
+    global_box.wrap(center, image);
+    const Scalar3 vel = geom.getSurfaceVelocity(center);
+
+    return make_scalar4(vel.x, vel.y, vel.z, density * fraction * cell_size * cell_size * cell_size);
+    }
+
+} // end namespace detail
+} // end namespace mpcd
+
+#endif // MPCD_VIRTUAL_CELL_FILLER_UTILITIES_H_
@@ -187,17 +187,36 @@ class integrator(hoomd.integrate._integrator):
         True: _md.IntegratorAnisotropicMode.Anisotropic,
         False: _md.IntegratorAnisotropicMode.Isotropic}
 
-    def set_params(self, dt=None, aniso=None):
+    def set_params(self, dt=None, aniso=None, fuse_stream=None, overlap_collide=None):
         """ Changes parameters of an existing integration mode.
 
         Args:
             dt (float): New time step delta (if set) (in time units).
             aniso (bool): Anisotropic integration mode (bool), default None (autodetect).
+            fuse_stream (bool): If True, build the cell list for the next collision while streaming.
+            overlap_collide (bool): If True, start the collision of the next step before the MD forces are computed.
+
+        When *fuse_stream* is True, the MPCD particles are streamed and binned into
+        the cells of the next collision in a single pass, saving one read of the
+        particle positions per collision. The fused pass is only taken when the
+        particles are not streamed again before the collision, when the simulation
+        is not domain decomposed, and when no particles are embedded in the collision.
+        Otherwise, the particles are streamed and binned separately.
+
+        When *overlap_collide* is True, the cell properties for a collision on the
+        next step are computed right after streaming, and their reduction between
+        MPI ranks completes while the MD forces are computed. This hides the latency
+        of the cell communication in large parallel simulations. It has no effect
+        when particles are embedded in the collision, since their velocities are only
+        final after the MD step. The MPCD velocities must not be modified between
+        steps (e.g., by a python callback) while this option is enabled.
 
         Examples::
 
             integrator.set_params(dt=0.007)
             integrator.set_params(dt=0.005, aniso=False)
+            integrator.set_params(fuse_stream=True)
+            integrator.set_params(overlap_collide=True)
 
         """
         hoomd.util.print_status_line()
@@ -217,6 +236,12 @@ class integrator(hoomd.integrate._integrator):
             self.aniso = aniso
             self.cpp_integrator.setAnisotropicMode(anisoMode)
 
+        if fuse_stream is not None:
+            self.cpp_integrator.setFuseStream(fuse_stream)
+
+        if overlap_collide is not None:
+            self.cpp_integrator.setOverlapCollide(overlap_collide)
+
     def update_methods(self):
         self.check_initialization()
 
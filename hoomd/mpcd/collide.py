@@ -214,17 +214,8 @@ class at(_collision_method):
 
         if not hoomd.context.exec_conf.isCUDAEnabled():
             collide_class = _mpcd.ATCollisionMethod
-            thermo_class = _mpcd.CellThermoCompute
         else:
             collide_class = _mpcd.ATCollisionMethodGPU
-            thermo_class = _mpcd.CellThermoComputeGPU
-
-        # create an auxiliary thermo compute and disable logging on it
-        if hoomd.context.current.mpcd._at_thermo is None:
-            rand_thermo = thermo_class(hoomd.context.current.mpcd.data)
-            rand_thermo.enableLogging(False)
-            hoomd.context.current.system.addCompute(rand_thermo, "mpcd_at_thermo")
-            hoomd.context.current.mpcd._at_thermo = rand_thermo
 
         self._cpp = collide_class(hoomd.context.current.mpcd.data,
                                   hoomd.context.current.system.getCurrentTimeStep(),
@@ -232,7 +223,6 @@ class at(_collision_method):
                                   0,
                                   self.seed,
                                   hoomd.context.current.mpcd._thermo,
-                                  hoomd.context.current.mpcd._at_thermo,
                                   self.kT.cpp_variant)
 
         hoomd.util.quiet_status()
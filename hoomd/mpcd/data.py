@@ -192,8 +192,6 @@ class system(hoomd.meta._metadata):
         else:
             self._thermo = _mpcd.CellThermoComputeGPU(self.data)
         hoomd.context.current.system.addCompute(self._thermo, "mpcd_thermo")
-        # extra thermo for the Andersen thermostat
-        self._at_thermo = None
 
         # if MPI is enabled, automatically add a communicator to the system
         if hoomd.comm.get_num_ranks() > 1:
@@ -246,11 +244,12 @@ class system(hoomd.meta._metadata):
 
         self.data.initializeFromSnapshot(snapshot.sys_snap)
 
-    def set_params(self, cell=None):
+    def set_params(self, cell=None, incremental=None):
         R""" Set parameters of the MPCD system
 
         Args:
             cell (float): Edge length of an MPCD cell.
+            incremental (bool): If True, update the cell list in place when possible.
 
         Every MPCD system is given a cell list for binning particles (see
         :py:mod:`.mpcd.collide`). The size of the cell list sets the length
@@ -260,10 +259,22 @@ class system(hoomd.meta._metadata):
         has a different fundamental unit of length, you can adjust the
         cell size, but be aware that this will also change the fluid properties.
 
+        With *incremental* set to True, the cell list only relocates the particles
+        that changed cells since it was last built instead of binning all particles
+        again. This is only possible when the grid shift is the same as in the last
+        build (e.g., grid shifting is disabled in :py:mod:`.mpcd.collide`), and
+        when there are no embedded particles. The cell list is rebuilt from scratch
+        otherwise. The order of particles within a cell can differ from a full build,
+        so the results are not bitwise identical. Incremental updates are only
+        performed on the CPU.
+
         """
         if cell is not None:
             self.cell.setCellSize(cell)
 
+        if incremental is not None:
+            self.cell.setIncremental(incremental)
+
     def take_snapshot(self, particles=True):
         R""" Takes a snapshot of the current state of the MPCD system
 
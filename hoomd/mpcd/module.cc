@@ -31,8 +31,14 @@
 #include "SRDCollisionMethodGPU.h"
 #endif // ENABLE_CUDA
 #include "StreamingMethod.h"
+#include "ConfinedStreamingMethod.h"
+#include "SignedDistanceField.h"
+#include "StreamingGeometry.h"
+#include "ConfinedVirtualCellFiller.h"
 #ifdef ENABLE_CUDA
 #include "StreamingMethodGPU.h"
+#include "ConfinedStreamingMethodGPU.h"
+#include "ConfinedVirtualCellFillerGPU.h"
 #endif // ENABLE_CUDA
 
 // communicator
@@ -112,9 +118,29 @@ PYBIND11_MODULE(_mpcd, m)
     mpcd::detail::export_ATCollisionMethodGPU(m);
     mpcd::detail::export_SRDCollisionMethodGPU(m);
     #endif // ENABLE_CUDA
+    mpcd::detail::export_boundary(m);
+    mpcd::detail::export_SlitGeometry(m);
+    mpcd::detail::export_SlitPoreGeometry(m);
+    mpcd::detail::export_SDFGeometry(m);
+    mpcd::detail::export_SignedDistanceField(m);
     mpcd::detail::export_StreamingMethod(m);
+    mpcd::detail::export_ConfinedStreamingMethod<mpcd::detail::SlitGeometry>(m);
+    mpcd::detail::export_ConfinedStreamingMethod<mpcd::detail::SlitPoreGeometry>(m);
+    mpcd::detail::export_ConfinedStreamingMethod<mpcd::detail::SDFGeometry>(m);
     #ifdef ENABLE_CUDA
     mpcd::detail::export_StreamingMethodGPU(m);
+    mpcd::detail::export_ConfinedStreamingMethodGPU<mpcd::detail::SlitGeometry>(m);
+    mpcd::detail::export_ConfinedStreamingMethodGPU<mpcd::detail::SlitPoreGeometry>(m);
+    mpcd::detail::export_ConfinedStreamingMethodGPU<mpcd::detail::SDFGeometry>(m);
+    #endif // ENABLE_CUDA
+    mpcd::detail::export_VirtualCellFiller(m);
+    mpcd::detail::export_ConfinedVirtualCellFiller<mpcd::detail::SlitGeometry>(m);
+    mpcd::detail::export_ConfinedVirtualCellFiller<mpcd::detail::SlitPoreGeometry>(m);
+    mpcd::detail::export_ConfinedVirtualCellFiller<mpcd::detail::SDFGeometry>(m);
+    #ifdef ENABLE_CUDA
+    mpcd::detail::export_ConfinedVirtualCellFillerGPU<mpcd::detail::SlitGeometry>(m);
+    mpcd::detail::export_ConfinedVirtualCellFillerGPU<mpcd::detail::SlitPoreGeometry>(m);
+    mpcd::detail::export_ConfinedVirtualCellFillerGPU<mpcd::detail::SDFGeometry>(m);
     #endif // ENABLE_CUDA
 
     #ifdef ENABLE_MPI
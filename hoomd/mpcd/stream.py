@@ -17,10 +17,16 @@ for a time :math:`\Delta t`:
 
 where **r** and **v** are the particle position and velocity, respectively.
 
+In a confined geometry, particles that cross a surface during the streaming step
+are reflected from it according to its boundary condition. A no-slip surface
+reverses the particle velocity (relative to the surface velocity), while a slip
+surface only reverses the component normal to the surface.
+
 """
 
 import hoomd
 from hoomd.md import _md
+import numpy as np
 
 from . import _mpcd
 
@@ -57,6 +63,8 @@ class _streaming_method(hoomd.meta._metadata):
         self.period = period
         self.enabled = True
         self._cpp = None
+        self._filler = None
+        self._filler_name = None
 
         # attach the streaming method to the system
         hoomd.util.quiet_status()
@@ -81,6 +89,8 @@ class _streaming_method(hoomd.meta._metadata):
 
         self.enabled = True
         hoomd.context.current.mpcd._stream = self
+        if self._filler is not None:
+            hoomd.context.current.mpcd._thermo.setVirtualFiller(self._filler)
 
     def disable(self):
         """ Disable the streaming method
@@ -98,6 +108,8 @@ class _streaming_method(hoomd.meta._metadata):
 
         self.enabled = False
         hoomd.context.current.mpcd._stream = None
+        if self._filler is not None:
+            hoomd.context.current.mpcd._thermo.removeVirtualFiller()
 
     def set_period(self, period):
         """ Set the streaming period.
@@ -131,6 +143,101 @@ class _streaming_method(hoomd.meta._metadata):
         self._cpp.setPeriod(cur_tstep, period)
         self.period = period
 
+    def set_filler(self, density, kT, seed):
+        R""" Add virtual particles to the cells that are cut by the surface.
+
+        Args:
+            density (float): Number density of the virtual particles
+            kT (:py:mod:`hoomd.variant` or :py:obj:`float`): Temperature of the virtual particles
+            seed (int): Seed to the pseudo-random number generator
+
+        Cells that are cut by a no-slip surface contain fewer MPCD particles than
+        cells in the bulk fluid, so the no-slip condition is not fully enforced by
+        the collisions. This method fills the part of these cells that lies outside
+        the fluid with virtual particles at number *density*, moving with the surface
+        velocity and with a Maxwell-Boltzmann distribution of velocities at *kT*.
+        *density* should match the density of the MPCD particles.
+
+        The virtual particles are not stored with the MPCD particles. Instead, their
+        number, momentum and kinetic energy are drawn randomly in each cell when the
+        cell properties are computed for the collision, so they do not add to the cost
+        of sorting, streaming and collisions. They are included in the cell velocities
+        and temperatures, but not in the logged MPCD momentum and energy.
+
+        The virtual particles only enter the cell velocities used by the collision rule,
+        so they are intended to be used with :py:class:`hoomd.mpcd.collide.srd`. They
+        are only available for confined geometries.
+
+        Examples::
+
+            slit.set_filler(density=5.0, kT=1.0, seed=42)
+
+        """
+        hoomd.util.print_status_line()
+
+        if self._filler_name is None:
+            hoomd.context.msg.error('mpcd.stream: virtual particles can only be used with a confined geometry.\n')
+            raise TypeError('Streaming method does not support virtual particles')
+
+        self.filler_density = density
+        self.filler_kT = hoomd.variant._setup_variant_input(kT)
+        self.filler_seed = seed
+
+        if self._filler is None:
+            if not hoomd.context.exec_conf.isCUDAEnabled():
+                fill_class = getattr(_mpcd, 'ConfinedVirtualCellFiller' + self._filler_name)
+            else:
+                fill_class = getattr(_mpcd, 'ConfinedVirtualCellFillerGPU' + self._filler_name)
+            self._filler = fill_class(hoomd.context.current.mpcd.data,
+                                      density,
+                                      self.filler_kT.cpp_variant,
+                                      seed,
+                                      self._cpp.geometry)
+        else:
+            self._filler.setDensity(density)
+            self._filler.setTemperature(self.filler_kT.cpp_variant)
+            self._filler.setSeed(seed)
+
+        if self.enabled:
+            hoomd.context.current.mpcd._thermo.setVirtualFiller(self._filler)
+
+    def remove_filler(self):
+        R""" Remove the virtual particles.
+
+        Examples::
+
+            slit.remove_filler()
+
+        """
+        hoomd.util.print_status_line()
+
+        if self._filler is not None and self.enabled:
+            hoomd.context.current.mpcd._thermo.removeVirtualFiller()
+        self._filler = None
+
+    def _process_boundary(self, bc):
+        """ Process boundary condition string into enum
+
+        Args:
+            bc (str): Boundary condition, either "no_slip" or "slip"
+
+        Returns:
+            A valid boundary condition enum.
+
+        The enum interface is still fairly clunky for the user since the boundary
+        condition is buried too deep in the package structure. This is a convenience
+        method for interpreting.
+
+        """
+        if bc == "no_slip":
+            return _mpcd.boundary.no_slip
+        elif bc == "slip":
+            return _mpcd.boundary.slip
+        else:
+            hoomd.context.msg.error("mpcd.stream: boundary condition " + bc + " not recognized.\n")
+            raise ValueError("Unrecognized streaming boundary condition")
+            return None
+
 class bulk(_streaming_method):
     """ Streaming method for bulk geometry.
 
@@ -175,3 +282,258 @@ class bulk(_streaming_method):
                                  hoomd.context.current.system.getCurrentTimeStep(),
                                  self.period,
                                  0)
+
+class slit(_streaming_method):
+    """ Parallel plate (slit) streaming geometry.
+
+    Args:
+        H (float): channel half-width
+        V (float): wall speed (default: 0)
+        boundary (str): boundary condition at wall ("slip" or "no_slip"")
+        period (int): Number of integration steps between collisions
+
+    The slit geometry represents a fluid confined between two infinite parallel
+    plates. The slit is centered around the origin, and the walls are placed
+    at :math:`z=-H` and :math:`z=+H`, so the total channel width is *2H*.
+    The walls may be put into motion, moving with speeds :math:`-V` and
+    :math:`+V` in the *x* direction, respectively. If combined with a
+    no-slip boundary condition, this motion can be used to generate simple
+    shear flow.
+
+    The "inside" of the :py:class:`slit` is the space where :math:`|z| < H`.
+    MPCD particles that cross a wall during the streaming step are reflected
+    with the *boundary* condition: the velocity is reversed (through the wall
+    velocity) for "no_slip", and only its normal component is reversed for "slip".
+
+    The cells of the MPCD grid that are close to a wall are flagged, and only the
+    particles in these cells (or the rare particles that move more than one cell
+    width in a streaming step) are tested for collisions with the walls. Streaming
+    in the bulk of the channel is as fast as with :py:class:`bulk`.
+
+    The box must be large enough to contain the slit with at least one extra cell
+    outside each wall, and all MPCD particles must be inside the slit when the
+    simulation is run.
+
+    Examples::
+
+        stream.slit(period=10, H=30.)
+        stream.slit(period=1, H=25., V=0.1)
+
+    """
+    def __init__(self, H, V=0.0, boundary="no_slip", period=1):
+        hoomd.util.print_status_line()
+
+        _streaming_method.__init__(self, period)
+
+        self.metadata_fields += ['H','V','boundary']
+        self.H = H
+        self.V = V
+        self.boundary = boundary
+
+        bc = self._process_boundary(boundary)
+
+        # create the base streaming class
+        if not hoomd.context.exec_conf.isCUDAEnabled():
+            stream_class = _mpcd.ConfinedStreamingMethodSlit
+        else:
+            stream_class = _mpcd.ConfinedStreamingMethodGPUSlit
+        self._cpp = stream_class(hoomd.context.current.mpcd.data,
+                                 hoomd.context.current.system.getCurrentTimeStep(),
+                                 self.period,
+                                 0,
+                                 _mpcd.Slit(H,V,bc))
+        self._filler_name = 'Slit'
+
+    def set_params(self, H=None, V=None, boundary=None):
+        """ Set parameters for the slit geometry.
+
+        Args:
+            H (float): channel half-width
+            V (float): wall speed (default: 0)
+            boundary (str): boundary condition at wall ("slip" or "no_slip"")
+
+        Changing any of these parameters will require the geometry to be
+        constructed and validated, so do not change these too often.
+
+        Examples::
+
+            slit.set_params(H=15.0)
+            slit.set_params(V=0.2, boundary="no_slip")
+
+        """
+        hoomd.util.print_status_line()
+
+        if H is not None:
+            self.H = H
+
+        if V is not None:
+            self.V = V
+
+        if boundary is not None:
+            self.boundary = boundary
+
+        bc = self._process_boundary(self.boundary)
+        self._cpp.geometry = _mpcd.Slit(self.H,self.V,bc)
+        if self._filler is not None:
+            self._filler.geometry = self._cpp.geometry
+
+class slit_pore(_streaming_method):
+    """ Slit pore streaming geometry.
+
+    Args:
+        H (float): pore half-width
+        L (float): pore half-length
+        boundary (str): boundary condition at wall ("slip" or "no_slip"")
+        period (int): Number of integration steps between collisions
+
+    The slit pore geometry represents a fluid in a slit of finite length that
+    connects two reservoirs. The pore is centered around the origin and bounded
+    by two walls of length *2L* in *x* at :math:`z=-H` and :math:`z=+H`. The
+    walls fill the space :math:`|x| < L` and :math:`|z| > H`, and the fluid is
+    unconfined for :math:`|x| \ge L`. The walls do not move.
+
+    MPCD particles that cross a wall during the streaming step are reflected
+    with the *boundary* condition, and only the particles in the cells of the MPCD
+    grid that are close to a wall are tested for collisions (see :py:class:`slit`).
+
+    The box must be large enough to contain the pore with at least one extra cell
+    outside the walls in *x* and *z*, and all MPCD particles must be outside the
+    walls when the simulation is run.
+
+    Examples::
+
+        stream.slit_pore(period=10, H=10., L=15.)
+        stream.slit_pore(period=1, H=5., L=10., boundary="slip")
+
+    """
+    def __init__(self, H, L, boundary="no_slip", period=1):
+        hoomd.util.print_status_line()
+
+        _streaming_method.__init__(self, period)
+
+        self.metadata_fields += ['H','L','boundary']
+        self.H = H
+        self.L = L
+        self.boundary = boundary
+
+        bc = self._process_boundary(boundary)
+
+        # create the base streaming class
+        if not hoomd.context.exec_conf.isCUDAEnabled():
+            stream_class = _mpcd.ConfinedStreamingMethodSlitPore
+        else:
+            stream_class = _mpcd.ConfinedStreamingMethodGPUSlitPore
+        self._cpp = stream_class(hoomd.context.current.mpcd.data,
+                                 hoomd.context.current.system.getCurrentTimeStep(),
+                                 self.period,
+                                 0,
+                                 _mpcd.SlitPore(H,L,bc))
+        self._filler_name = 'SlitPore'
+
+    def set_params(self, H=None, L=None, boundary=None):
+        """ Set parameters for the slit pore geometry.
+
+        Args:
+            H (float): pore half-width
+            L (float): pore half-length
+            boundary (str): boundary condition at wall ("slip" or "no_slip"")
+
+        Changing any of these parameters will require the geometry to be
+        constructed and validated, so do not change these too often.
+
+        Examples::
+
+            pore.set_params(H=15.0)
+            pore.set_params(L=20.0, boundary="slip")
+
+        """
+        hoomd.util.print_status_line()
+
+        if H is not None:
+            self.H = H
+
+        if L is not None:
+            self.L = L
+
+        if boundary is not None:
+            self.boundary = boundary
+
+        bc = self._process_boundary(self.boundary)
+        self._cpp.geometry = _mpcd.SlitPore(self.H,self.L,bc)
+        if self._filler is not None:
+            self._filler.geometry = self._cpp.geometry
+
+class sdf(_streaming_method):
+    """ Streaming geometry given by a signed distance field.
+
+    Args:
+        field (numpy.ndarray): signed distance to the surface at the nodes of a grid spanning the box
+        boundary (str): boundary condition at the surface ("slip" or "no_slip"")
+        period (int): Number of integration steps between collisions
+
+    The :py:class:`sdf` geometry confines the fluid with an arbitrary stationary
+    surface. *field* is a three dimensional array of shape (*nx*, *ny*, *nz*).
+    The element ``field[i,j,k]`` is the signed distance to the surface at the
+    grid node :math:`\mathbf{r}_\mathrm{lo} + (i L_x/n_x, j L_y/n_y, k L_z/n_z)`,
+    where :math:`\mathbf{r}_\mathrm{lo}` is the lower corner of the simulation box.
+    The grid is periodic, and the distance is trilinearly interpolated between the
+    nodes. It must be positive in the fluid and negative in the solid, and values
+    on neighboring nodes must not differ by more than the grid spacing.
+
+    MPCD particles that cross the surface during the streaming step are moved back
+    to the surface and reflected: the velocity is reversed for "no_slip", and only
+    its component along the gradient of the field is reversed for "slip". Only the
+    particles in the cells of the MPCD grid that are close to the surface are tested
+    for collisions (see :py:class:`slit`).
+
+    The field is tied to the simulation box when the geometry is created, and the
+    box cannot be resized. All MPCD particles must be in the fluid when the simulation
+    is run.
+
+    Example::
+
+        # fluid outside of a sphere of radius 5 at the origin
+        L = 20.
+        n = 80
+        x = -0.5*L + numpy.arange(n)*L/n
+        X,Y,Z = numpy.meshgrid(x,x,x,indexing='ij')
+        stream.sdf(field=numpy.sqrt(X**2+Y**2+Z**2)-5., boundary="slip", period=1)
+
+    """
+    def __init__(self, field, boundary="no_slip", period=1):
+        hoomd.util.print_status_line()
+
+        _streaming_method.__init__(self, period)
+
+        field = np.asarray(field, dtype=np.float64)
+        if field.ndim != 3:
+            hoomd.context.msg.error('mpcd.stream: signed distance field must be a three dimensional array.\n')
+            raise ValueError('Signed distance field must be a three dimensional array')
+
+        self.metadata_fields += ['boundary']
+        self.boundary = boundary
+
+        bc = self._process_boundary(boundary)
+
+        # tabulate the field with x varying fastest, and keep it alive with the geometry
+        nx,ny,nz = field.shape
+        box = hoomd.context.current.system_definition.getParticleData().getGlobalBox()
+        self._field = _mpcd.SignedDistanceField(hoomd.context.exec_conf,
+                                                box,
+                                                nx,
+                                                ny,
+                                                nz,
+                                                field.flatten(order='F').tolist(),
+                                                bc)
+
+        # create the base streaming class
+        if not hoomd.context.exec_conf.isCUDAEnabled():
+            stream_class = _mpcd.ConfinedStreamingMethodSDF
+        else:
+            stream_class = _mpcd.ConfinedStreamingMethodGPUSDF
+        self._cpp = stream_class(hoomd.context.current.mpcd.data,
+                                 hoomd.context.current.system.getCurrentTimeStep(),
+                                 self.period,
+                                 0,
+                                 self._field.getGeometry())
+        self._filler_name = 'SDF'
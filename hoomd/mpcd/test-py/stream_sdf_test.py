@@ -0,0 +1,87 @@
+# Copyright (c) 2009-2019 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+# Maintainer: mphoward
+
+import unittest
+import numpy as np
+import hoomd
+from hoomd import md
+from hoomd import mpcd
+
+# unit tests for mpcd signed distance field streaming geometry
+class mpcd_stream_sdf_test(unittest.TestCase):
+    def setUp(self):
+        # establish the simulation context
+        hoomd.context.initialize()
+
+        # set the decomposition in z for mpi builds
+        if hoomd.comm.get_num_ranks() > 1:
+            hoomd.comm.decomposition(nz=2)
+
+        # default testing configuration
+        hoomd.init.read_snapshot(hoomd.data.make_snapshot(N=0, box=hoomd.data.boxdim(L=10.)))
+
+        # initialize the system from the starting snapshot
+        snap = mpcd.data.make_snapshot(N=2)
+        snap.particles.position[:] = [[-4.95,4.95,3.95],[-1.,-1.,1.]]
+        snap.particles.velocity[:] = [[2.,-2.,2.],[1.,1.,1.]]
+        self.s = mpcd.init.read_snapshot(snap)
+
+        mpcd.integrator(dt=0.1)
+
+        # walls at z = -4 and z = +4, tabulated on a 0.5 grid
+        z = -5. + 0.5*np.arange(20)
+        self.field = np.tile(4.-np.abs(z), (20,20,1))
+
+    # test creation can happen (with all parameters set)
+    def test_create(self):
+        mpcd.stream.sdf(field=self.field, boundary="slip", period=2)
+
+    # test that the field shape is checked
+    def test_bad_field(self):
+        with self.assertRaises(ValueError):
+            mpcd.stream.sdf(field=self.field[0])
+
+    # test that the field is interpolated
+    def test_distance(self):
+        sdf = mpcd.stream.sdf(field=self.field)
+        self.assertAlmostEqual(sdf._cpp.geometry.getDistance(hoomd._hoomd.make_scalar3(0.1,-0.2,2.25)), 1.75)
+        self.assertAlmostEqual(sdf._cpp.geometry.getDistance(hoomd._hoomd.make_scalar3(0.1,-0.2,-4.5)), -0.5)
+        self.assertEqual(sdf._cpp.geometry.getBoundaryCondition(), mpcd._mpcd.boundary.no_slip)
+
+    # test for reflection with no-slip boundary condition (same as the slit)
+    def test_step_noslip(self):
+        mpcd.stream.sdf(field=self.field)
+
+        hoomd.run(1)
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            np.testing.assert_array_almost_equal(snap.particles.position[0], [4.95,-4.95,3.85])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[0], [-2.,2.,-2.])
+            np.testing.assert_array_almost_equal(snap.particles.position[1], [-0.9,-0.9,1.1])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[1], [1.,1.,1.])
+
+    # test for reflection with slip boundary condition (same as the slit)
+    def test_step_slip(self):
+        mpcd.stream.sdf(field=self.field, boundary="slip")
+
+        hoomd.run(1)
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            np.testing.assert_array_almost_equal(snap.particles.position[0], [-4.75,4.75,3.85])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[0], [2.,-2.,-2.])
+            np.testing.assert_array_almost_equal(snap.particles.position[1], [-0.9,-0.9,1.1])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[1], [1.,1.,1.])
+
+    # test that particles cannot start in the solid
+    def test_out_of_bounds(self):
+        mpcd.stream.sdf(field=self.field-0.1)
+        with self.assertRaises(RuntimeError):
+            hoomd.run(1)
+
+    def tearDown(self):
+        del self.s
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -0,0 +1,101 @@
+# Copyright (c) 2009-2019 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+# Maintainer: mphoward
+
+import unittest
+import numpy as np
+import hoomd
+from hoomd import md
+from hoomd import mpcd
+
+# unit tests for mpcd slit pore streaming geometry
+class mpcd_stream_slit_pore_test(unittest.TestCase):
+    def setUp(self):
+        # establish the simulation context
+        hoomd.context.initialize()
+
+        # set the decomposition in z for mpi builds
+        if hoomd.comm.get_num_ranks() > 1:
+            hoomd.comm.decomposition(nz=2)
+
+        # default testing configuration
+        hoomd.init.read_snapshot(hoomd.data.make_snapshot(N=0, box=hoomd.data.boxdim(L=10.)))
+
+        # initialize the system from the starting snapshot
+        snap = mpcd.data.make_snapshot(N=2)
+        snap.particles.position[:] = [[-2.05,0.,3.5],[0.,0.,2.95]]
+        snap.particles.velocity[:] = [[1.,-1.,0.],[0.,0.,1.]]
+        self.s = mpcd.init.read_snapshot(snap)
+
+        mpcd.integrator(dt=0.1)
+
+    # test creation can happen (with all parameters set)
+    def test_create(self):
+        mpcd.stream.slit_pore(H=3., L=2., boundary="no_slip", period=2)
+
+    # test for setting parameters
+    def test_set_params(self):
+        pore = mpcd.stream.slit_pore(H=3., L=2.)
+        self.assertAlmostEqual(pore.H, 3.)
+        self.assertAlmostEqual(pore.L, 2.)
+        self.assertEqual(pore.boundary, "no_slip")
+        self.assertAlmostEqual(pore._cpp.geometry.getH(), 3.)
+        self.assertAlmostEqual(pore._cpp.geometry.getL(), 2.)
+        self.assertEqual(pore._cpp.geometry.getBoundaryCondition(), mpcd._mpcd.boundary.no_slip)
+
+        # change L and also ensure other parameters stay the same
+        pore.set_params(L=1.5)
+        self.assertAlmostEqual(pore.H, 3.)
+        self.assertAlmostEqual(pore.L, 1.5)
+        self.assertAlmostEqual(pore._cpp.geometry.getH(), 3.)
+        self.assertAlmostEqual(pore._cpp.geometry.getL(), 1.5)
+
+        # change BCs
+        pore.set_params(boundary="slip")
+        self.assertEqual(pore.boundary, "slip")
+        self.assertEqual(pore._cpp.geometry.getBoundaryCondition(), mpcd._mpcd.boundary.slip)
+
+    # test for reflection with no-slip boundary condition
+    def test_step_noslip(self):
+        mpcd.stream.slit_pore(H=3., L=2.)
+
+        # the first particle hits the side of the wall, the second particle hits its face
+        hoomd.run(1)
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            np.testing.assert_array_almost_equal(snap.particles.position[0], [-2.05,0.,3.5])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[0], [-1.,1.,0.])
+            np.testing.assert_array_almost_equal(snap.particles.position[1], [0.,0.,2.95])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[1], [0.,0.,-1.])
+
+    # test for reflection with slip boundary condition
+    def test_step_slip(self):
+        mpcd.stream.slit_pore(H=3., L=2., boundary="slip")
+
+        # only the normal velocity is reversed
+        hoomd.run(1)
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            np.testing.assert_array_almost_equal(snap.particles.position[0], [-2.05,-0.1,3.5])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[0], [-1.,-1.,0.])
+            np.testing.assert_array_almost_equal(snap.particles.position[1], [0.,0.,2.95])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[1], [0.,0.,-1.])
+
+    # test that the pore must leave room for a cell outside the walls
+    def test_validate_box(self):
+        mpcd.stream.slit_pore(H=3., L=4.5)
+        with self.assertRaises(RuntimeError):
+            hoomd.run(1)
+
+    # test that particles cannot start inside the walls
+    def test_out_of_bounds(self):
+        mpcd.stream.slit_pore(H=2.5, L=2.)
+        with self.assertRaises(RuntimeError):
+            hoomd.run(1)
+
+    def tearDown(self):
+        del self.s
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
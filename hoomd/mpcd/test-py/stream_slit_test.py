@@ -0,0 +1,159 @@
+# Copyright (c) 2009-2019 The Regents of the University of Michigan
+# This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+# Maintainer: mphoward
+
+import unittest
+import numpy as np
+import hoomd
+from hoomd import md
+from hoomd import mpcd
+
+# unit tests for mpcd slit streaming geometry
+class mpcd_stream_slit_test(unittest.TestCase):
+    def setUp(self):
+        # establish the simulation context
+        hoomd.context.initialize()
+
+        # set the decomposition in z for mpi builds
+        if hoomd.comm.get_num_ranks() > 1:
+            hoomd.comm.decomposition(nz=2)
+
+        # default testing configuration
+        hoomd.init.read_snapshot(hoomd.data.make_snapshot(N=0, box=hoomd.data.boxdim(L=10.)))
+
+        # initialize the system from the starting snapshot
+        snap = mpcd.data.make_snapshot(N=2)
+        snap.particles.position[:] = [[-4.95,4.95,3.95],[-1.,-1.,1.]]
+        snap.particles.velocity[:] = [[2.,-2.,2.],[1.,1.,1.]]
+        self.s = mpcd.init.read_snapshot(snap)
+
+        mpcd.integrator(dt=0.1)
+
+    # test creation can happen (with all parameters set)
+    def test_create(self):
+        mpcd.stream.slit(H=4., V=0.1, boundary="no_slip", period=2)
+
+    # test for setting parameters
+    def test_set_params(self):
+        slit = mpcd.stream.slit(H=4.)
+        self.assertAlmostEqual(slit.H, 4.)
+        self.assertAlmostEqual(slit.V, 0.)
+        self.assertEqual(slit.boundary, "no_slip")
+        self.assertAlmostEqual(slit._cpp.geometry.getH(), 4.)
+        self.assertAlmostEqual(slit._cpp.geometry.getVelocity(), 0.)
+        self.assertEqual(slit._cpp.geometry.getBoundaryCondition(), mpcd._mpcd.boundary.no_slip)
+
+        # change H and also ensure other parameters stay the same
+        slit.set_params(H=2.)
+        self.assertAlmostEqual(slit.H, 2.)
+        self.assertAlmostEqual(slit.V, 0.)
+        self.assertEqual(slit.boundary, "no_slip")
+        self.assertAlmostEqual(slit._cpp.geometry.getH(), 2.)
+        self.assertAlmostEqual(slit._cpp.geometry.getVelocity(), 0.)
+        self.assertEqual(slit._cpp.geometry.getBoundaryCondition(), mpcd._mpcd.boundary.no_slip)
+
+        # change V
+        slit.set_params(V=0.1)
+        self.assertAlmostEqual(slit.V, 0.1)
+        self.assertAlmostEqual(slit._cpp.geometry.getVelocity(), 0.1)
+
+        # change BCs
+        slit.set_params(boundary="slip")
+        self.assertEqual(slit.boundary, "slip")
+        self.assertEqual(slit._cpp.geometry.getBoundaryCondition(), mpcd._mpcd.boundary.slip)
+
+        # a bad boundary condition is an error
+        with self.assertRaises(ValueError):
+            slit.set_params(boundary="invalid")
+
+    # test for reflection with no-slip boundary condition
+    def test_step_noslip(self):
+        mpcd.stream.slit(H=4.)
+
+        # take one step, the first particle reflects from the wall and wraps through the box
+        hoomd.run(1)
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            np.testing.assert_array_almost_equal(snap.particles.position[0], [4.95,-4.95,3.85])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[0], [-2.,2.,-2.])
+            np.testing.assert_array_almost_equal(snap.particles.position[1], [-0.9,-0.9,1.1])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[1], [1.,1.,1.])
+
+    # test for reflection with slip boundary condition
+    def test_step_slip(self):
+        mpcd.stream.slit(H=4., boundary="slip")
+
+        # take one step, only the normal velocity is reversed
+        hoomd.run(1)
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            np.testing.assert_array_almost_equal(snap.particles.position[0], [-4.75,4.75,3.85])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[0], [2.,-2.,-2.])
+            np.testing.assert_array_almost_equal(snap.particles.position[1], [-0.9,-0.9,1.1])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[1], [1.,1.,1.])
+
+    # test for reflection from moving no-slip walls
+    def test_step_moving_wall(self):
+        mpcd.stream.slit(H=4., V=1.)
+
+        # the top wall moves in +x, so the reflected velocity is shifted by twice the wall speed
+        hoomd.run(1)
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            np.testing.assert_array_almost_equal(snap.particles.position[0], [-4.9,-4.95,3.85])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[0], [0.,2.,-2.])
+            np.testing.assert_array_almost_equal(snap.particles.position[1], [-0.9,-0.9,1.1])
+            np.testing.assert_array_almost_equal(snap.particles.velocity[1], [1.,1.,1.])
+
+    # test that the slit must leave room for a cell outside the walls
+    def test_validate_box(self):
+        mpcd.stream.slit(H=4.5)
+        with self.assertRaises(RuntimeError):
+            hoomd.run(1)
+
+    # test that particles cannot start outside the slit
+    def test_out_of_bounds(self):
+        mpcd.stream.slit(H=3.8)
+        with self.assertRaises(RuntimeError):
+            hoomd.run(1)
+
+    # test for adding and removing virtual particles
+    def test_filler(self):
+        slit = mpcd.stream.slit(H=4.)
+        slit.set_filler(density=5., kT=1.0, seed=42)
+        self.assertIsNotNone(slit._filler)
+        self.assertAlmostEqual(slit._filler.geometry.getH(), 4.)
+
+        # changing the geometry updates the filler
+        slit.set_params(H=3.)
+        self.assertAlmostEqual(slit._filler.geometry.getH(), 3.)
+
+        # changing the parameters reuses the filler
+        filler = slit._filler
+        slit.set_filler(density=3., kT=1.5, seed=7)
+        self.assertIs(slit._filler, filler)
+        self.assertAlmostEqual(slit._filler.getDensity(), 3.)
+
+        # virtual particles enter the cell properties of the collisions, but not the particles themselves
+        mpcd.collide.srd(seed=1, period=1, angle=130.)
+        hoomd.run(1)
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            self.assertEqual(snap.particles.N, 2)
+
+        slit.remove_filler()
+        self.assertIsNone(slit._filler)
+        hoomd.run(1)
+
+    # test that virtual particles cannot be used with bulk streaming
+    def test_filler_bulk(self):
+        bulk = mpcd.stream.bulk()
+        with self.assertRaises(TypeError):
+            bulk.set_filler(density=5., kT=1.0, seed=42)
+
+    def tearDown(self):
+        del self.s
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -47,12 +47,11 @@ void at_collision_method_basic_test(std::shared_ptr<ExecutionConfiguration> exec
     auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
     std::shared_ptr<mpcd::ParticleData> pdata_4 = mpcd_sys->getParticleData();
 
-    // thermos and temperature variant
+    // thermo and temperature variant
     auto thermo = std::make_shared<mpcd::CellThermoCompute>(mpcd_sys);
-    auto rand_thermo = std::make_shared<mpcd::CellThermoCompute>(mpcd_sys);
     std::shared_ptr<::Variant> T = std::make_shared<::VariantConst>(1.5);
 
-    std::shared_ptr<mpcd::ATCollisionMethod> collide = std::make_shared<CM>(mpcd_sys, 0, 2, 1, 42, thermo, rand_thermo, T);
+    std::shared_ptr<mpcd::ATCollisionMethod> collide = std::make_shared<CM>(mpcd_sys, 0, 2, 1, 42, thermo, T);
     collide->enableGridShifting(false);
 
     // nothing should happen on the first step
@@ -148,23 +148,24 @@ void celllist_small_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         CHECK_EQUAL_UINT( h_cell_list.data[cli(0, ci(1,1,0))], 3 );
         CHECK_EQUAL_UINT( h_cell_list.data[cli(0, ci(1,1,1))], 7 );
 
-        ArrayHandle<Scalar4> h_vel(pdata_9->getVelocities(), access_location::host, access_mode::read);
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[0].w), ci(0,0,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[1].w), ci(1,0,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[2].w), ci(0,1,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[3].w), ci(1,1,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[4].w), ci(0,0,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[5].w), ci(1,0,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[6].w), ci(0,1,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[7].w), ci(1,1,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[8].w), ci(0,0,0) );
+        ArrayHandle<mpcd::detail::vel_t> h_vel(pdata_9->getVelocities(), access_location::host, access_mode::read);
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[0]), ci(0,0,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[1]), ci(1,0,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[2]), ci(0,1,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[3]), ci(1,1,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[4]), ci(0,0,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[5]), ci(1,0,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[6]), ci(0,1,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[7]), ci(1,1,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[8]), ci(0,0,0) );
         }
 
     // condense particles into two bins
         {
-        ArrayHandle<Scalar4> h_pos(pdata_9->getPositions(), access_location::host, access_mode::overwrite);
-        h_pos.data[0] = make_scalar4(-0.3, -0.3, -0.3, 0.0);
-        h_pos.data[1] = make_scalar4( 0.3,  0.3,  0.3, 0.0);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata_9->getPositions(), access_location::host, access_mode::overwrite);
+        const mpcd::detail::PositionGrid& grid = pdata_9->getPositionGrid();
+        h_pos.data[0] = mpcd::detail::make_position(make_scalar3(-0.3, -0.3, -0.3), 0, grid);
+        h_pos.data[1] = mpcd::detail::make_position(make_scalar3(0.3, 0.3, 0.3), 0, grid);
         h_pos.data[2] = h_pos.data[0];
         h_pos.data[3] = h_pos.data[1];
         h_pos.data[4] = h_pos.data[0];
@@ -218,8 +219,9 @@ void celllist_small_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
 
     // bring all particles into one box, which triggers a resize, and check that all particles are in this bin
         {
-        ArrayHandle<Scalar4> h_pos(pdata_9->getPositions(), access_location::host, access_mode::overwrite);
-        h_pos.data[0] = make_scalar4(0.9, -0.4, 0.0, 0.0);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata_9->getPositions(), access_location::host, access_mode::overwrite);
+        const mpcd::detail::PositionGrid& grid = pdata_9->getPositionGrid();
+        h_pos.data[0] = mpcd::detail::make_position(make_scalar3(0.9, -0.4, 0.0), 0, grid);
         for (unsigned int i=1; i < 9; ++i)
             h_pos.data[i] = h_pos.data[0];
         }
@@ -241,14 +243,16 @@ void celllist_small_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
 
     // send a particle out of bounds and check that an exception is raised
         {
-        ArrayHandle<Scalar4> h_pos(pdata_9->getPositions(), access_location::host, access_mode::overwrite);
-        h_pos.data[0] = make_scalar4(2.1, 2.1, 2.1, __int_as_scalar(0));
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata_9->getPositions(), access_location::host, access_mode::overwrite);
+        const mpcd::detail::PositionGrid& grid = pdata_9->getPositionGrid();
+        h_pos.data[0] = mpcd::detail::make_position(make_scalar3(2.1, 2.1, 2.1), 0, grid);
         }
     UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ cl->compute(3); });
     // check the other side as well
         {
-        ArrayHandle<Scalar4> h_pos(pdata_9->getPositions(), access_location::host, access_mode::overwrite);
-        h_pos.data[0] = make_scalar4(-2.1, -2.1, -2.1, __int_as_scalar(0));
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata_9->getPositions(), access_location::host, access_mode::overwrite);
+        const mpcd::detail::PositionGrid& grid = pdata_9->getPositionGrid();
+        h_pos.data[0] = mpcd::detail::make_position(make_scalar3(-2.1, -2.1, -2.1), 0, grid);
         }
     UP_ASSERT_EXCEPTION(std::runtime_error, [&]{ cl->compute(4); });
     }
@@ -288,8 +292,9 @@ void celllist_grid_shift_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
 
     // move to the other side and retry
         {
-        ArrayHandle<Scalar4> h_pos(pdata_1->getPositions(), access_location::host, access_mode::overwrite);
-        h_pos.data[0] = make_scalar4(-0.1, -0.1, -0.1, 0.0);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata_1->getPositions(), access_location::host, access_mode::overwrite);
+        const mpcd::detail::PositionGrid& grid = pdata_1->getPositionGrid();
+        h_pos.data[0] = mpcd::detail::make_position(make_scalar3(-0.1, -0.1, -0.1), 0, grid);
         }
     cl->setGridShift(make_scalar3(-0.5,-0.5,-0.5));
     cl->compute(2);
@@ -301,8 +306,9 @@ void celllist_grid_shift_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
 
     // check for cell periodic wrapping by putting particles near the box boundary
         {
-        ArrayHandle<Scalar4> h_pos(pdata_1->getPositions(), access_location::host, access_mode::overwrite);
-        h_pos.data[0] = make_scalar4(-2.9, -2.9, -2.9, 0.0);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata_1->getPositions(), access_location::host, access_mode::overwrite);
+        const mpcd::detail::PositionGrid& grid = pdata_1->getPositionGrid();
+        h_pos.data[0] = mpcd::detail::make_position(make_scalar3(-2.9, -2.9, -2.9), 0, grid);
         }
     cl->setGridShift(make_scalar3(0.5,0.5,0.5));
     cl->compute(3);
@@ -314,8 +320,9 @@ void celllist_grid_shift_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
 
     // and the other way
         {
-        ArrayHandle<Scalar4> h_pos(pdata_1->getPositions(), access_location::host, access_mode::overwrite);
-        h_pos.data[0] = make_scalar4(2.9, 2.9, 2.9, 0.0);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata_1->getPositions(), access_location::host, access_mode::overwrite);
+        const mpcd::detail::PositionGrid& grid = pdata_1->getPositionGrid();
+        h_pos.data[0] = mpcd::detail::make_position(make_scalar3(2.9, 2.9, 2.9), 0, grid);
         }
     cl->setGridShift(make_scalar3(-0.5,-0.5,-0.5));
     cl->compute(4);
@@ -406,15 +413,15 @@ void celllist_embed_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         CHECK_EQUAL_UINT( h_cell_list.data[cli(0, ci(1,1,0))], 3 );
         CHECK_EQUAL_UINT( h_cell_list.data[cli(0, ci(1,1,1))], 7 );
 
-        ArrayHandle<Scalar4> h_vel(pdata_8->getVelocities(), access_location::host, access_mode::read);
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[0].w), ci(0,0,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[1].w), ci(1,0,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[2].w), ci(0,1,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[3].w), ci(1,1,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[4].w), ci(0,0,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[5].w), ci(1,0,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[6].w), ci(0,1,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[7].w), ci(1,1,1) );
+        ArrayHandle<mpcd::detail::vel_t> h_vel(pdata_8->getVelocities(), access_location::host, access_mode::read);
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[0]), ci(0,0,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[1]), ci(1,0,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[2]), ci(0,1,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[3]), ci(1,1,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[4]), ci(0,0,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[5]), ci(1,0,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[6]), ci(0,1,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[7]), ci(1,1,1) );
         }
 
     // now we include the half embedded group
@@ -480,15 +487,15 @@ void celllist_embed_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
             UP_ASSERT_EQUAL(result, std::vector<unsigned int>{7,11});
             }
 
-        ArrayHandle<Scalar4> h_vel(pdata_8->getVelocities(), access_location::host, access_mode::read);
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[0].w), ci(0,0,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[1].w), ci(1,0,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[2].w), ci(0,1,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[3].w), ci(1,1,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[4].w), ci(0,0,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[5].w), ci(1,0,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[6].w), ci(0,1,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[7].w), ci(1,1,1) );
+        ArrayHandle<mpcd::detail::vel_t> h_vel(pdata_8->getVelocities(), access_location::host, access_mode::read);
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[0]), ci(0,0,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[1]), ci(1,0,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[2]), ci(0,1,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[3]), ci(1,1,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[4]), ci(0,0,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[5]), ci(1,0,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[6]), ci(0,1,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[7]), ci(1,1,1) );
 
         ArrayHandle<unsigned int> h_embed_cell_ids(cl->getEmbeddedGroupCellIds(), access_location::host, access_mode::read);
         CHECK_EQUAL_UINT(h_embed_cell_ids.data[0], ci(1,0,0));
@@ -563,15 +570,15 @@ void celllist_embed_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
             UP_ASSERT_EQUAL(result, std::vector<unsigned int>{7,11});
             }
 
-        ArrayHandle<Scalar4> h_vel(pdata_8->getVelocities(), access_location::host, access_mode::read);
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[0].w), ci(0,0,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[1].w), ci(1,0,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[2].w), ci(0,1,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[3].w), ci(1,1,0) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[4].w), ci(0,0,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[5].w), ci(1,0,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[6].w), ci(0,1,1) );
-        CHECK_EQUAL_UINT( __scalar_as_int(h_vel.data[7].w), ci(1,1,1) );
+        ArrayHandle<mpcd::detail::vel_t> h_vel(pdata_8->getVelocities(), access_location::host, access_mode::read);
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[0]), ci(0,0,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[1]), ci(1,0,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[2]), ci(0,1,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[3]), ci(1,1,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[4]), ci(0,0,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[5]), ci(1,0,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[6]), ci(0,1,1) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[7]), ci(1,1,1) );
 
         ArrayHandle<unsigned int> h_embed_cell_ids(cl->getEmbeddedGroupCellIds(), access_location::host, access_mode::read);
         CHECK_EQUAL_UINT(h_embed_cell_ids.data[0], ci(1,1,0));
@@ -592,6 +599,87 @@ void celllist_embed_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         }
     }
 
+//! Test that the incremental update of the cell list gives the same cells as a full build
+template<class CL>
+void celllist_incremental_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(2.0);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    // place each particle in a different cell, doubling the first cell
+    std::shared_ptr<mpcd::ParticleData> pdata_9;
+        {
+        auto mpcd_snap = std::make_shared<mpcd::ParticleDataSnapshot>(9);
+
+        mpcd_snap->position[0] = vec3<Scalar>(-0.5, -0.5, -0.5);
+        mpcd_snap->position[1] = vec3<Scalar>( 0.5, -0.5, -0.5);
+        mpcd_snap->position[2] = vec3<Scalar>(-0.5,  0.5, -0.5);
+        mpcd_snap->position[3] = vec3<Scalar>( 0.5,  0.5, -0.5);
+        mpcd_snap->position[4] = vec3<Scalar>(-0.5, -0.5,  0.5);
+        mpcd_snap->position[5] = vec3<Scalar>( 0.5, -0.5,  0.5);
+        mpcd_snap->position[6] = vec3<Scalar>(-0.5,  0.5,  0.5);
+        mpcd_snap->position[7] = vec3<Scalar>( 0.5,  0.5,  0.5);
+
+        mpcd_snap->position[8] = vec3<Scalar>(-0.5, -0.5, -0.5);
+        pdata_9 = std::make_shared<mpcd::ParticleData>(mpcd_snap, snap->global_box, exec_conf);
+        }
+
+    std::shared_ptr<mpcd::CellList> cl(new CL(sysdef, pdata_9));
+    cl->setIncremental(true);
+    cl->compute(0);
+
+    // move particle 8 into the (1,1,1) cell, and particle 1 into the (0,0,0) cell
+        {
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata_9->getPositions(), access_location::host, access_mode::readwrite);
+        const mpcd::detail::PositionGrid& grid = pdata_9->getPositionGrid();
+        h_pos.data[8] = mpcd::detail::make_position(make_scalar3(0.4, 0.4, 0.4), 0, grid);
+        h_pos.data[1] = mpcd::detail::make_position(make_scalar3(-0.4, -0.4, -0.4), 0, grid);
+        }
+    cl->compute(1);
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_list(cl->getCellList(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::detail::vel_t> h_vel(pdata_9->getVelocities(), access_location::host, access_mode::read);
+        Index3D ci = cl->getCellIndexer();
+        Index2D cli = cl->getCellListIndexer();
+
+        CHECK_EQUAL_UINT( h_cell_np.data[ci(0,0,0)], 2 );
+        CHECK_EQUAL_UINT( h_cell_np.data[ci(1,0,0)], 0 );
+        CHECK_EQUAL_UINT( h_cell_np.data[ci(1,1,1)], 2 );
+        CHECK_EQUAL_UINT( h_cell_np.data[ci(0,1,0)], 1 );
+
+        // the order within a cell is not guaranteed
+        const unsigned int a = h_cell_list.data[cli(0, ci(0,0,0))];
+        const unsigned int b = h_cell_list.data[cli(1, ci(0,0,0))];
+        UP_ASSERT((a == 0 && b == 1) || (a == 1 && b == 0));
+        const unsigned int c = h_cell_list.data[cli(0, ci(1,1,1))];
+        const unsigned int d = h_cell_list.data[cli(1, ci(1,1,1))];
+        UP_ASSERT((c == 7 && d == 8) || (c == 8 && d == 7));
+        CHECK_EQUAL_UINT( h_cell_list.data[cli(0, ci(0,1,0))], 2 );
+
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[1]), ci(0,0,0) );
+        CHECK_EQUAL_UINT( mpcd::detail::get_cell(h_vel.data[8]), ci(1,1,1) );
+        }
+
+    // move all particles into one cell, which overflows and forces a full rebuild
+        {
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata_9->getPositions(), access_location::host, access_mode::readwrite);
+        const mpcd::detail::PositionGrid& grid = pdata_9->getPositionGrid();
+        for (unsigned int i=0; i < 9; ++i)
+            h_pos.data[i] = mpcd::detail::make_position(make_scalar3(-0.5, -0.5, -0.5), 0, grid);
+        }
+    cl->compute(2);
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        Index3D ci = cl->getCellIndexer();
+        CHECK_EQUAL_UINT( h_cell_np.data[ci(0,0,0)], 9 );
+        CHECK_EQUAL_UINT( h_cell_np.data[ci(1,1,1)], 0 );
+        UP_ASSERT(cl->getCellListIndexer().getW() >= 9);
+        }
+    }
+
 //! dimension test case for MPCD CellList class
 UP_TEST( mpcd_cell_list_dimensions )
     {
@@ -616,6 +704,12 @@ UP_TEST( mpcd_cell_list_embed_test )
     celllist_embed_test<mpcd::CellList>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
     }
 
+//! incremental update test case for MPCD CellList class
+UP_TEST( mpcd_cell_list_incremental_test )
+    {
+    celllist_incremental_test<mpcd::CellList>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+
 #ifdef ENABLE_CUDA
 //! dimension test case for MPCD CellListGPU class
 UP_TEST( mpcd_cell_list_gpu_dimensions )
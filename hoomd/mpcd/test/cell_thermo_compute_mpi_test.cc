@@ -160,12 +160,12 @@ void cell_thermo_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
 
     // scale all particles so that they move into one common cell
         {
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        const mpcd::detail::PositionGrid& grid = pdata->getPositionGrid();
         for (unsigned int i=0; i < pdata->getN(); ++i)
             {
-            h_pos.data[i].x *= 0.25;
-            h_pos.data[i].y *= 0.25;
-            h_pos.data[i].z *= 0.25;
+            const Scalar3 r = mpcd::detail::get_position(h_pos.data[i], grid);
+            h_pos.data[i] = mpcd::detail::make_position(Scalar(0.25) * r, mpcd::detail::get_type(h_pos.data[i]), grid);
             }
         }
     thermo->compute(1);
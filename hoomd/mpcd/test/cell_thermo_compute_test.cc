@@ -145,8 +145,9 @@ void cell_thermo_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
     // switch a particle into a different cell, and make sure the DOF are reduced accordingly
     pdata_5->setMass(1.0);
         {
-        ArrayHandle<Scalar4> h_pos(pdata_5->getPositions(), access_location::host, access_mode::readwrite);
-        h_pos.data[2] = make_scalar4(-0.5, -0.5, -0.5, 0.0);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata_5->getPositions(), access_location::host, access_mode::readwrite);
+        const mpcd::detail::PositionGrid& grid = pdata_5->getPositionGrid();
+        h_pos.data[2] = mpcd::detail::make_position(make_scalar3(-0.5, -0.5, -0.5), 0, grid);
         }
     thermo->compute(2);
         {
@@ -194,6 +195,44 @@ void cell_thermo_basic_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
         CHECK_CLOSE(thermo->getNetEnergy(), 28.5, tol);
         CHECK_CLOSE(thermo->getTemperature(), (2*1.0*1.0+2*1.0*1.0+2.0*2.0)/6.0, tol);
         }
+
+    // starting the calculation ahead of time should give the same result when it is completed
+    thermo->beginCompute(3);
+    thermo->compute(3);
+        {
+        const Index3D ci = cl->getCellIndexer();
+        ArrayHandle<double4> h_avg_vel(thermo->getCellVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<double3> h_cell_energy(thermo->getCellEnergies(), access_location::host, access_mode::read);
+
+        CHECK_CLOSE(h_avg_vel.data[ci(0,0,0)].x, 1.0, tol);
+        CHECK_CLOSE(h_avg_vel.data[ci(0,0,0)].y, -1.0, tol);
+        CHECK_CLOSE(h_avg_vel.data[ci(0,0,0)].z, 0.0, tol);
+        CHECK_CLOSE(h_avg_vel.data[ci(0,0,0)].w, 3.0, tol);
+        CHECK_CLOSE(h_cell_energy.data[ci(0,0,0)].x, 7.0, tol);
+        UP_ASSERT_EQUAL(__double_as_int(h_cell_energy.data[ci(0,0,0)].z), 3);
+
+        CHECK_CLOSE(thermo->getNetMomentum().x, 4.0, tol);
+        CHECK_CLOSE(thermo->getNetMomentum().y, -4.0, tol);
+        CHECK_CLOSE(thermo->getNetMomentum().z, -1.0, tol);
+        CHECK_CLOSE(thermo->getNetEnergy(), 28.5, tol);
+        }
+
+    // a canceled calculation is redone from the current particle data
+    thermo->beginCompute(4);
+        {
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata_5->getPositions(), access_location::host, access_mode::readwrite);
+        const mpcd::detail::PositionGrid& grid = pdata_5->getPositionGrid();
+        h_pos.data[2] = mpcd::detail::make_position(make_scalar3(0.5, 0.5, 0.5), 0, grid);
+        }
+    cl->forceCompute(4);
+    thermo->cancelCompute();
+    thermo->compute(4);
+        {
+        const Index3D ci = cl->getCellIndexer();
+        ArrayHandle<double4> h_avg_vel(thermo->getCellVelocities(), access_location::host, access_mode::read);
+        CHECK_CLOSE(h_avg_vel.data[ci(0,0,0)].w, 2.0, tol);
+        CHECK_CLOSE(h_avg_vel.data[ci(1,1,1)].w, 2.0, tol);
+        }
     }
 
 //! Test for correct calculation of cell thermo properties with embedded particles
@@ -25,6 +25,19 @@ typedef std::function<std::shared_ptr<mpcd::Communicator>(std::shared_ptr<mpcd::
 #include "hoomd/test/upp11_config.h"
 HOOMD_UP_MAIN()
 
+//! Counts the sort signals emitted by the MPCD particle data
+struct sort_counter
+    {
+    sort_counter() : count(0) {}
+
+    void slot(unsigned int timestep, const GPUArray<unsigned int>& order, const GPUArray<unsigned int>& rorder)
+        {
+        ++count;
+        }
+
+    unsigned int count; //!< Number of times the signal was emitted
+    };
+
 // some convenience macros for casting triclinic boxes into a cubic reference frame
 #define REF_TO_DEST(v) dest_box.makeCoordinates(ref_box.makeFraction(make_scalar3(v.x,v.y,v.z)))
 #define DEST_TO_REF(v) ref_box.makeCoordinates(dest_box.makeFraction(make_scalar3(v.x,v.y,v.z)))
@@ -163,8 +176,12 @@ void test_communicator_migrate(communicator_creator comm_creator, std::shared_pt
             };
         }
 
-    // attempt a migration, everyone should stay in place
+    // attempt a migration, everyone should stay in place without the particle data being reordered
+    sort_counter counter;
+    pdata->getSortSignal().connect<sort_counter, &sort_counter::slot>(&counter);
     comm->migrateParticles(0);
+    pdata->getSortSignal().disconnect<sort_counter, &sort_counter::slot>(&counter);
+    UP_ASSERT_EQUAL(counter.count, 0);
     UP_ASSERT_EQUAL(pdata->getN(), 1);
         {
         const unsigned int tag = pdata->getTag(0);
@@ -227,7 +244,8 @@ void test_communicator_migrate(communicator_creator comm_creator, std::shared_pt
 
     // move particles to new ranks
         {
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        const mpcd::detail::PositionGrid& grid = pdata->getPositionGrid();
 
         Scalar3 new_pos;
         switch(my_rank)
@@ -265,9 +283,7 @@ void test_communicator_migrate(communicator_creator comm_creator, std::shared_pt
                 new_pos = REF_TO_DEST(make_scalar3(-0.6, -0.1, -0.2));
                 break;
             };
-        h_pos.data[0].x = new_pos.x;
-        h_pos.data[0].y = new_pos.y;
-        h_pos.data[0].z = new_pos.z;
+        h_pos.data[0] = mpcd::detail::make_position(new_pos, mpcd::detail::get_type(h_pos.data[0]), grid);
         }
 
     // migrate to new domains
@@ -334,7 +350,8 @@ void test_communicator_migrate(communicator_creator comm_creator, std::shared_pt
 
     // move particles through the global boundary
         {
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        const mpcd::detail::PositionGrid& grid = pdata->getPositionGrid();
 
         Scalar3 new_pos;
         switch(my_rank)
@@ -372,9 +389,7 @@ void test_communicator_migrate(communicator_creator comm_creator, std::shared_pt
                 new_pos = REF_TO_DEST(make_scalar3(1.3, 0.1, 1.05));
                 break;
             };
-        h_pos.data[0].x = new_pos.x;
-        h_pos.data[0].y = new_pos.y;
-        h_pos.data[0].z = new_pos.z;
+        h_pos.data[0] = mpcd::detail::make_position(new_pos, mpcd::detail::get_type(h_pos.data[0]), grid);
         }
 
     // some domains have different numbers of particles after migration
@@ -567,7 +582,8 @@ void test_communicator_migrate_ortho(communicator_creator comm_creator, std::sha
 
     // move particles to new ranks
         {
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        const mpcd::detail::PositionGrid& grid = pdata->getPositionGrid();
 
         Scalar3 new_pos;
         switch(exec_conf->getRank())
@@ -605,9 +621,7 @@ void test_communicator_migrate_ortho(communicator_creator comm_creator, std::sha
                 new_pos = make_scalar3(2.1,-0.5,0.0);
                 break;
             };
-        h_pos.data[0].x = new_pos.x;
-        h_pos.data[0].y = new_pos.y;
-        h_pos.data[0].z = new_pos.z;
+        h_pos.data[0] = mpcd::detail::make_position(new_pos, mpcd::detail::get_type(h_pos.data[0]), grid);
         }
 
     comm->communicate(0);
@@ -619,7 +633,8 @@ void test_communicator_migrate_ortho(communicator_creator comm_creator, std::sha
     // move all particles onto domains 5 and 6
     const unsigned int rank = exec_conf->getRank();
         {
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        const mpcd::detail::PositionGrid& grid = pdata->getPositionGrid();
 
         // just get them all in the same place
         // this first set will put tags 7, 0, 3, and 4 on rank 5
@@ -632,7 +647,7 @@ void test_communicator_migrate_ortho(communicator_creator comm_creator, std::sha
             {
             new_pos = make_scalar3( 0.5,0.5,0.0);
             }
-        h_pos.data[0].x = new_pos.x; h_pos.data[0].y = new_pos.y; h_pos.data[0].z = new_pos.z;
+        h_pos.data[0] = mpcd::detail::make_position(new_pos, mpcd::detail::get_type(h_pos.data[0]), grid);
         }
     comm->communicate(1);
     if (rank == 5 || rank == 6)
@@ -646,21 +661,22 @@ void test_communicator_migrate_ortho(communicator_creator comm_creator, std::sha
 
     // now send multiple particles out from each rank in different directions
         {
-        ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        ArrayHandle<mpcd::detail::pos_t> h_pos(pdata->getPositions(), access_location::host, access_mode::readwrite);
+        const mpcd::detail::PositionGrid& grid = pdata->getPositionGrid();
         if (rank == 5)
             {
             // send one particle to rank 6, rank 4, and rank 0
-            h_pos.data[0].x = Scalar(0.5); h_pos.data[0].y = Scalar(0.5); h_pos.data[0].z = Scalar(0.0);
-            h_pos.data[1].x = Scalar(-1.5); h_pos.data[1].y = Scalar(0.5); h_pos.data[1].z = Scalar(0.0);
-            h_pos.data[3].x = Scalar(-1.5); h_pos.data[3].y = Scalar(-0.5); h_pos.data[3].z = Scalar(0.0);
+            h_pos.data[0] = mpcd::detail::make_position(make_scalar3(Scalar(0.5), Scalar(0.5), Scalar(0.0)), mpcd::detail::get_type(h_pos.data[0]), grid);
+            h_pos.data[1] = mpcd::detail::make_position(make_scalar3(Scalar(-1.5), Scalar(0.5), Scalar(0.0)), mpcd::detail::get_type(h_pos.data[1]), grid);
+            h_pos.data[3] = mpcd::detail::make_position(make_scalar3(Scalar(-1.5), Scalar(-0.5), Scalar(0.0)), mpcd::detail::get_type(h_pos.data[3]), grid);
             }
         else if (rank == 6)
             {
             // send two particles to rank 5, one to rank 7, and to rank 3
-            h_pos.data[0].x = Scalar(1.5); h_pos.data[0].y = Scalar(0.5); h_pos.data[0].z = Scalar(0.0);
-            h_pos.data[1].x = Scalar(-0.5); h_pos.data[1].y = Scalar(0.5); h_pos.data[1].z = Scalar(0.0);
-            h_pos.data[2].x = Scalar(1.5); h_pos.data[2].y = Scalar(-0.5); h_pos.data[2].z = Scalar(0.0);
-            h_pos.data[3].x = Scalar(-0.5); h_pos.data[3].y = Scalar(0.5); h_pos.data[3].z = Scalar(0.0);
+            h_pos.data[0] = mpcd::detail::make_position(make_scalar3(Scalar(1.5), Scalar(0.5), Scalar(0.0)), mpcd::detail::get_type(h_pos.data[0]), grid);
+            h_pos.data[1] = mpcd::detail::make_position(make_scalar3(Scalar(-0.5), Scalar(0.5), Scalar(0.0)), mpcd::detail::get_type(h_pos.data[1]), grid);
+            h_pos.data[2] = mpcd::detail::make_position(make_scalar3(Scalar(1.5), Scalar(-0.5), Scalar(0.0)), mpcd::detail::get_type(h_pos.data[2]), grid);
+            h_pos.data[3] = mpcd::detail::make_position(make_scalar3(Scalar(-0.5), Scalar(0.5), Scalar(0.0)), mpcd::detail::get_type(h_pos.data[3]), grid);
             }
         }
     comm->communicate(2);
@@ -0,0 +1,202 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+// Maintainer: mphoward
+
+#include "hoomd/mpcd/ParticleData.h"
+#include "hoomd/mpcd/SystemData.h"
+
+#include "hoomd/SnapshotSystemData.h"
+#include "hoomd/test/upp11_config.h"
+
+HOOMD_UP_MAIN()
+
+//! Test that the position and velocity helpers round trip through the storage layout
+UP_TEST( mpcd_particle_data_helpers )
+    {
+    const mpcd::detail::PositionGrid grid(make_scalar3(-5.0, -2.5, -1.0), make_scalar3(10.0, 5.0, 2.0));
+
+    // positions inside the box, including the lower and upper boundaries
+    const Scalar3 pos[] = {make_scalar3(1.0, 2.0, 0.5),
+                           make_scalar3(-5.0, -2.5, -1.0),
+                           make_scalar3(4.999, 2.499, 0.999),
+                           make_scalar3(-0.3, 0.7, 0.1)};
+    for (unsigned int i=0; i < 4; ++i)
+        {
+        const mpcd::detail::pos_t p = mpcd::detail::make_position(pos[i], i+1, grid);
+        const Scalar3 r = mpcd::detail::get_position(p, grid);
+        CHECK_CLOSE(r.x, pos[i].x, tol);
+        CHECK_CLOSE(r.y, pos[i].y, tol);
+        CHECK_CLOSE(r.z, pos[i].z, tol);
+        UP_ASSERT_EQUAL(mpcd::detail::get_type(p), i+1);
+        }
+
+    // the largest type still fits next to the cell indexes
+        {
+        const unsigned int max_type = mpcd::detail::POSITION_MAX_TYPES - 1;
+        const mpcd::detail::pos_t p = mpcd::detail::make_position(pos[2], max_type, grid);
+        UP_ASSERT_EQUAL(mpcd::detail::get_type(p), max_type);
+        const Scalar3 r = mpcd::detail::get_position(p, grid);
+        CHECK_CLOSE(r.x, pos[2].x, tol);
+        CHECK_CLOSE(r.y, pos[2].y, tol);
+        CHECK_CLOSE(r.z, pos[2].z, tol);
+        }
+
+    // particles that have left the box (before migration or wrapping) still decode to their position
+        {
+        const Scalar3 out = make_scalar3(5.2, -2.6, 1.05);
+        const mpcd::detail::pos_t p = mpcd::detail::make_position(out, 3, grid);
+        const Scalar3 r = mpcd::detail::get_position(p, grid);
+        CHECK_CLOSE(r.x, out.x, tol);
+        CHECK_CLOSE(r.y, out.y, tol);
+        CHECK_CLOSE(r.z, out.z, tol);
+        UP_ASSERT_EQUAL(mpcd::detail::get_type(p), 3);
+        }
+
+    // a position far outside the grid is clamped to an edge cell, and decodes with a larger absolute error
+        {
+        const Scalar3 out = make_scalar3(-35.0, 17.5, 7.0);
+        const mpcd::detail::pos_t p = mpcd::detail::make_position(out, 2, grid);
+        const Scalar3 r = mpcd::detail::get_position(p, grid);
+        CHECK_CLOSE(r.x, out.x, tol);
+        CHECK_CLOSE(r.y, out.y, tol);
+        CHECK_CLOSE(r.z, out.z, tol);
+        UP_ASSERT_EQUAL(mpcd::detail::get_type(p), 2);
+        }
+
+    // velocities carry the cell index, which can be reset independently
+        {
+        mpcd::detail::vel_t v = mpcd::detail::make_velocity(make_scalar3(1.5, -2.0, 0.25), 42);
+        UP_ASSERT_EQUAL(mpcd::detail::get_cell(v), 42);
+        mpcd::detail::set_cell(v, mpcd::detail::NO_CELL);
+        UP_ASSERT_EQUAL(mpcd::detail::get_cell(v), mpcd::detail::NO_CELL);
+        const Scalar3 u = mpcd::detail::get_velocity(v);
+        CHECK_CLOSE(u.x, 1.5, tol);
+        CHECK_CLOSE(u.y, -2.0, tol);
+        CHECK_CLOSE(u.z, 0.25, tol);
+        }
+    }
+
+//! Test that the snapshot is preserved by the storage layout
+void particle_data_snapshot_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(10.0, 6.0, 4.0);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        auto mpcd_snap = mpcd_sys_snap->particles;
+        mpcd_snap->type_mapping.push_back("A");
+        mpcd_snap->type_mapping.push_back("B");
+        mpcd_snap->resize(3);
+
+        mpcd_snap->position[0] = vec3<Scalar>(1.0, 2.0, 0.5);
+        mpcd_snap->position[1] = vec3<Scalar>(-4.99, -2.99, -1.99);
+        mpcd_snap->position[2] = vec3<Scalar>(4.99, 2.99, 1.99);
+
+        mpcd_snap->velocity[0] = vec3<Scalar>(1.0, -1.0, 0.5);
+        mpcd_snap->velocity[1] = vec3<Scalar>(-2.0, 0.25, 3.0);
+        mpcd_snap->velocity[2] = vec3<Scalar>(0.5, 1.25, -1.5);
+
+        mpcd_snap->type[0] = 1;
+        mpcd_snap->type[1] = 0;
+        mpcd_snap->type[2] = 1;
+        }
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+    std::shared_ptr<mpcd::ParticleData> pdata = mpcd_sys->getParticleData();
+    UP_ASSERT_EQUAL(pdata->getN(), 3);
+
+    // the getters decode the stored data
+    for (unsigned int i=0; i < 3; ++i)
+        {
+        const Scalar3 r = pdata->getPosition(i);
+        CHECK_CLOSE(r.x, mpcd_sys_snap->particles->position[i].x, tol);
+        CHECK_CLOSE(r.y, mpcd_sys_snap->particles->position[i].y, tol);
+        CHECK_CLOSE(r.z, mpcd_sys_snap->particles->position[i].z, tol);
+
+        const Scalar3 v = pdata->getVelocity(i);
+        CHECK_CLOSE(v.x, mpcd_sys_snap->particles->velocity[i].x, tol);
+        CHECK_CLOSE(v.y, mpcd_sys_snap->particles->velocity[i].y, tol);
+        CHECK_CLOSE(v.z, mpcd_sys_snap->particles->velocity[i].z, tol);
+
+        UP_ASSERT_EQUAL(pdata->getType(i), mpcd_sys_snap->particles->type[i]);
+        }
+
+    // the snapshot taken back out agrees with the one put in
+    auto out = std::make_shared<mpcd::ParticleDataSnapshot>();
+    pdata->takeSnapshot(out, snap->global_box);
+    UP_ASSERT_EQUAL(out->size, 3);
+    UP_ASSERT_EQUAL(out->type_mapping, mpcd_sys_snap->particles->type_mapping);
+    for (unsigned int i=0; i < 3; ++i)
+        {
+        CHECK_CLOSE(out->position[i].x, mpcd_sys_snap->particles->position[i].x, tol);
+        CHECK_CLOSE(out->position[i].y, mpcd_sys_snap->particles->position[i].y, tol);
+        CHECK_CLOSE(out->position[i].z, mpcd_sys_snap->particles->position[i].z, tol);
+        CHECK_CLOSE(out->velocity[i].x, mpcd_sys_snap->particles->velocity[i].x, tol);
+        CHECK_CLOSE(out->velocity[i].y, mpcd_sys_snap->particles->velocity[i].y, tol);
+        CHECK_CLOSE(out->velocity[i].z, mpcd_sys_snap->particles->velocity[i].z, tol);
+        UP_ASSERT_EQUAL(out->type[i], mpcd_sys_snap->particles->type[i]);
+        }
+    }
+
+//! Test that the positions are kept when the local box moves, as in load balancing
+UP_TEST( mpcd_particle_data_local_box )
+    {
+    auto exec_conf = std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU);
+    const BoxDim box(10.0, 6.0, 4.0);
+
+    auto mpcd_snap = std::make_shared<mpcd::ParticleDataSnapshot>(3);
+    mpcd_snap->type_mapping.push_back("A");
+    mpcd_snap->type_mapping.push_back("B");
+    mpcd_snap->position[0] = vec3<Scalar>(1.0, 2.0, 0.5);
+    mpcd_snap->position[1] = vec3<Scalar>(-4.99, -2.99, -1.99);
+    mpcd_snap->position[2] = vec3<Scalar>(4.99, 2.99, 1.99);
+    mpcd_snap->type[1] = 1;
+    auto pdata = std::make_shared<mpcd::ParticleData>(mpcd_snap, box, exec_conf);
+
+    // shrink and shift the local box so that particles 1 and 2 are outside of the new grid
+    const BoxDim local_box(make_scalar3(-2.0, -1.0, -1.0), make_scalar3(3.0, 2.5, 1.0), make_uchar3(1,1,1));
+    pdata->setLocalBox(local_box);
+
+    const mpcd::detail::PositionGrid& grid = pdata->getPositionGrid();
+    CHECK_CLOSE(grid.lo.x, -2.0, tol);
+    CHECK_CLOSE(grid.lo.y, -1.0, tol);
+    CHECK_CLOSE(grid.lo.z, -1.0, tol);
+    CHECK_CLOSE(grid.width.x, 5.0 / mpcd::detail::POSITION_GRID_DIM, tol);
+    CHECK_CLOSE(grid.width.y, 3.5 / mpcd::detail::POSITION_GRID_DIM, tol);
+    CHECK_CLOSE(grid.width.z, 2.0 / mpcd::detail::POSITION_GRID_DIM, tol);
+
+    for (unsigned int i=0; i < 3; ++i)
+        {
+        const Scalar3 r = pdata->getPosition(i);
+        CHECK_CLOSE(r.x, mpcd_snap->position[i].x, tol);
+        CHECK_CLOSE(r.y, mpcd_snap->position[i].y, tol);
+        CHECK_CLOSE(r.z, mpcd_snap->position[i].z, tol);
+        UP_ASSERT_EQUAL(pdata->getType(i), mpcd_snap->type[i]);
+        }
+
+    // moving back to the full box restores the positions
+    pdata->setLocalBox(box);
+    for (unsigned int i=0; i < 3; ++i)
+        {
+        const Scalar3 r = pdata->getPosition(i);
+        CHECK_CLOSE(r.x, mpcd_snap->position[i].x, tol);
+        CHECK_CLOSE(r.y, mpcd_snap->position[i].y, tol);
+        CHECK_CLOSE(r.z, mpcd_snap->position[i].z, tol);
+        }
+    }
+
+//! snapshot round trip on the CPU
+UP_TEST( mpcd_particle_data_snapshot )
+    {
+    particle_data_snapshot_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+#ifdef ENABLE_CUDA
+//! snapshot round trip on the GPU
+UP_TEST( mpcd_particle_data_snapshot_gpu )
+    {
+    particle_data_snapshot_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
+    }
+#endif // ENABLE_CUDA
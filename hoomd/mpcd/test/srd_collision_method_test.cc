@@ -66,7 +66,7 @@ void srd_collision_method_basic_test(std::shared_ptr<ExecutionConfiguration> exe
     UP_ASSERT(!collide->peekCollide(0));
     collide->collide(0);
         {
-        ArrayHandle<Scalar4> h_vel(pdata_4->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::detail::vel_t> h_vel(pdata_4->getVelocities(), access_location::host, access_mode::read);
         for (unsigned int i=0; i < pdata_4->getN(); ++i)
             {
             CHECK_CLOSE(h_vel.data[i].x, orig_vel[i].x, tol_small);
@@ -91,7 +91,7 @@ void srd_collision_method_basic_test(std::shared_ptr<ExecutionConfiguration> exe
     UP_ASSERT(collide->peekCollide(1));
     collide->collide(1);
         {
-        ArrayHandle<Scalar4> h_vel(pdata_4->getVelocities(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::detail::vel_t> h_vel(pdata_4->getVelocities(), access_location::host, access_mode::read);
         ArrayHandle<double3> h_rotvec(collide->getRotationVectors(), access_location::host, access_mode::read);
 
         for (unsigned int i=0; i < pdata_4->getN(); ++i)
@@ -111,7 +111,7 @@ void srd_collision_method_basic_test(std::shared_ptr<ExecutionConfiguration> exe
                 }
 
             // all rotation vectors should be unit norm
-            const unsigned int cell = __scalar_as_int(h_vel.data[i].w);
+            const unsigned int cell = mpcd::detail::get_cell(h_vel.data[i]);
             const Scalar3 rot_vec = make_scalar3(h_rotvec.data[cell].x, h_rotvec.data[cell].y, h_rotvec.data[cell].z);
             CHECK_CLOSE(dot(rot_vec,rot_vec), 1.0, tol_small);
 
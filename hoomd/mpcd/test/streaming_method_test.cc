@@ -48,28 +48,26 @@ void streaming_method_basic_test(std::shared_ptr<ExecutionConfiguration> exec_co
     stream->stream(2);
     std::shared_ptr<mpcd::ParticleData> pdata_2 = mpcd_sys->getParticleData();
         {
-        ArrayHandle<Scalar4> h_pos(pdata_2->getPositions(), access_location::host, access_mode::read);
-        CHECK_CLOSE(h_pos.data[0].x, 1.0, tol);
-        CHECK_CLOSE(h_pos.data[0].y, 4.85, tol);
-        CHECK_CLOSE(h_pos.data[0].z, 3.0, tol);
-
-        CHECK_CLOSE(h_pos.data[1].x, -3.0, tol);
-        CHECK_CLOSE(h_pos.data[1].y, -4.75, tol);
-        CHECK_CLOSE(h_pos.data[1].z, -1.0, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).x, 1.0, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).y, 4.85, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).z, 3.0, tol);
+
+        CHECK_CLOSE(pdata_2->getPosition(1).x, -3.0, tol);
+        CHECK_CLOSE(pdata_2->getPosition(1).y, -4.75, tol);
+        CHECK_CLOSE(pdata_2->getPosition(1).z, -1.0, tol);
         }
 
     // now if we peek, we should need to stream at step 3
     UP_ASSERT(stream->peekStream(3));
     stream->stream(3);
         {
-        ArrayHandle<Scalar4> h_pos(pdata_2->getPositions(), access_location::host, access_mode::read);
-        CHECK_CLOSE(h_pos.data[0].x, 1.1, tol);
-        CHECK_CLOSE(h_pos.data[0].y, 4.95, tol);
-        CHECK_CLOSE(h_pos.data[0].z, 3.1, tol);
-
-        CHECK_CLOSE(h_pos.data[1].x, -3.1, tol);
-        CHECK_CLOSE(h_pos.data[1].y, -4.85, tol);
-        CHECK_CLOSE(h_pos.data[1].z, -1.1, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).x, 1.1, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).y, 4.95, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).z, 3.1, tol);
+
+        CHECK_CLOSE(pdata_2->getPosition(1).x, -3.1, tol);
+        CHECK_CLOSE(pdata_2->getPosition(1).y, -4.85, tol);
+        CHECK_CLOSE(pdata_2->getPosition(1).z, -1.1, tol);
         }
 
     // next streaming step should now be off again
@@ -78,28 +76,26 @@ void streaming_method_basic_test(std::shared_ptr<ExecutionConfiguration> exec_co
     UP_ASSERT(stream->peekStream(5));
     stream->stream(5);
         {
-        ArrayHandle<Scalar4> h_pos(pdata_2->getPositions(), access_location::host, access_mode::read);
-        CHECK_CLOSE(h_pos.data[0].x, 1.2, tol);
-        CHECK_CLOSE(h_pos.data[0].y, -4.95, tol);
-        CHECK_CLOSE(h_pos.data[0].z, 3.2, tol);
-
-        CHECK_CLOSE(h_pos.data[1].x, -3.2, tol);
-        CHECK_CLOSE(h_pos.data[1].y, -4.95, tol);
-        CHECK_CLOSE(h_pos.data[1].z, -1.2, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).x, 1.2, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).y, -4.95, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).z, 3.2, tol);
+
+        CHECK_CLOSE(pdata_2->getPosition(1).x, -3.2, tol);
+        CHECK_CLOSE(pdata_2->getPosition(1).y, -4.95, tol);
+        CHECK_CLOSE(pdata_2->getPosition(1).z, -1.2, tol);
         }
 
     // increase the timestep, which should increase distance travelled
     stream->setDeltaT(0.1);
     stream->stream(7);
         {
-        ArrayHandle<Scalar4> h_pos(pdata_2->getPositions(), access_location::host, access_mode::read);
-        CHECK_CLOSE(h_pos.data[0].x, 1.4, tol);
-        CHECK_CLOSE(h_pos.data[0].y, -4.75, tol);
-        CHECK_CLOSE(h_pos.data[0].z, 3.4, tol);
-
-        CHECK_CLOSE(h_pos.data[1].x, -3.4, tol);
-        CHECK_CLOSE(h_pos.data[1].y, 4.85, tol);
-        CHECK_CLOSE(h_pos.data[1].z, -1.4, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).x, 1.4, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).y, -4.75, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).z, 3.4, tol);
+
+        CHECK_CLOSE(pdata_2->getPosition(1).x, -3.4, tol);
+        CHECK_CLOSE(pdata_2->getPosition(1).y, 4.85, tol);
+        CHECK_CLOSE(pdata_2->getPosition(1).z, -1.4, tol);
         }
     }
 
@@ -115,3 +111,85 @@ UP_TEST( mpcd_streaming_method_setup )
     streaming_method_basic_test<mpcd::StreamingMethodGPU>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::GPU));
     }
 #endif // ENABLE_CUDA
+
+//! Test that streaming while building the cell list matches separate streaming and binning
+template<class SM>
+void streaming_method_cell_list_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap( new SnapshotSystemData<Scalar>() );
+    snap->global_box = BoxDim(10.0);
+    snap->particle_data.type_mapping.push_back("A");
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+
+    // 2 particle system
+    auto mpcd_sys_snap = std::make_shared<mpcd::SystemDataSnapshot>(sysdef);
+        {
+        auto mpcd_snap = mpcd_sys_snap->particles;
+        mpcd_snap->resize(2);
+
+        mpcd_snap->position[0] = vec3<Scalar>(1.0, 4.85, 3.0);
+        mpcd_snap->position[1] = vec3<Scalar>(-3.0, -4.75, -1.0);
+
+        mpcd_snap->velocity[0] = vec3<Scalar>(1.0, 1.0, 1.0);
+        mpcd_snap->velocity[1] = vec3<Scalar>(-1.0, -1.0, -1.0);
+        }
+    auto mpcd_sys = std::make_shared<mpcd::SystemData>(mpcd_sys_snap);
+
+    // stream every step, starting at step 0
+    std::shared_ptr<mpcd::StreamingMethod> stream = std::make_shared<SM>(mpcd_sys, 0, 1, -1);
+    stream->setDeltaT(0.1);
+
+    // the particles are streamed again before step 2, so the cell list cannot be built for it
+    const Scalar3 shift = make_scalar3(0.05, -0.2, 0.3);
+    UP_ASSERT(!stream->streamCellList(0, 2, shift));
+
+    // stream and bin the particles for step 1
+    UP_ASSERT(stream->streamCellList(0, 1, shift));
+    std::shared_ptr<mpcd::ParticleData> pdata_2 = mpcd_sys->getParticleData();
+        {
+        CHECK_CLOSE(pdata_2->getPosition(0).x, 1.1, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).y, 4.95, tol);
+        CHECK_CLOSE(pdata_2->getPosition(0).z, 3.1, tol);
+
+        CHECK_CLOSE(pdata_2->getPosition(1).x, -3.1, tol);
+        CHECK_CLOSE(pdata_2->getPosition(1).y, -4.85, tol);
+        CHECK_CLOSE(pdata_2->getPosition(1).z, -1.1, tol);
+        }
+
+    // computing at step 1 should reuse the shifted cell list, particle 0 is shifted through the y boundary
+    std::shared_ptr<mpcd::CellList> cl = mpcd_sys->getCellList();
+    cl->compute(1);
+        {
+        ArrayHandle<unsigned int> h_cell_np(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_cell_list(cl->getCellList(), access_location::host, access_mode::read);
+        ArrayHandle<mpcd::detail::vel_t> h_vel(pdata_2->getVelocities(), access_location::host, access_mode::read);
+        Index3D ci = cl->getCellIndexer();
+        Index2D cli = cl->getCellListIndexer();
+
+        UP_ASSERT_EQUAL(h_cell_np.data[ci(6,0,7)], 1);
+        UP_ASSERT_EQUAL(h_cell_list.data[cli(0,ci(6,0,7))], 0);
+        UP_ASSERT_EQUAL(mpcd::detail::get_cell(h_vel.data[0]), (int)ci(6,0,7));
+
+        UP_ASSERT_EQUAL(h_cell_np.data[ci(1,0,3)], 1);
+        UP_ASSERT_EQUAL(h_cell_list.data[cli(0,ci(1,0,3))], 1);
+        UP_ASSERT_EQUAL(mpcd::detail::get_cell(h_vel.data[1]), (int)ci(1,0,3));
+        }
+
+    // the grid shift of the cell list is unchanged
+    CHECK_SMALL(cl->getGridShift().x, tol_small);
+    CHECK_SMALL(cl->getGridShift().y, tol_small);
+    CHECK_SMALL(cl->getGridShift().z, tol_small);
+    }
+
+//! test case for fused streaming and binning on the CPU
+UP_TEST( mpcd_streaming_method_cell_list )
+    {
+    streaming_method_cell_list_test<mpcd::StreamingMethod>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::CPU));
+    }
+#ifdef ENABLE_CUDA
+//! test case for fused streaming and binning on the GPU
+UP_TEST( mpcd_streaming_method_cell_list_gpu )
+    {
+    streaming_method_cell_list_test<mpcd::StreamingMethodGPU>(std::make_shared<ExecutionConfiguration>(ExecutionConfiguration::GPU));
+    }
+#endif // ENABLE_CUDA
@@ -17,6 +17,7 @@ import hoomd;
 import sys;
 import shlex;
 import os;
+import atexit;
 
 ## \internal
 # \brief Storage for all option values
@@ -34,16 +35,30 @@ class options:
         self.notice_level = 2;
         self.msg_file = None;
         self.shared_msg_file = None;
+        self.msg_async = False;
         self.nrank = None;
         self.nx = None;
         self.ny = None;
         self.nz = None;
         self.linear = None;
         self.onelevel = None;
+        self.cuda_aware_mpi = None;
+        self.persistent_mpi = None;
+        self.compress_ghosts = None;
+        self.shared_mem_ghosts = None;
+        self.sort_ghosts = None;
+        self.migrate_buffer = None;
         self.autotuner_enable = True;
         self.autotuner_period = 100000;
+        self.autotuner_cache = None;
+        self.profiler_counters = False;
+        self.profiler_peak_flops = None;
+        self.profiler_peak_bandwidth = None;
         self.single_mpi = False;
         self.nthreads = None;
+        self.thread_affinity = None;
+        self.first_touch = None;
+        self.huge_pages = None;
 
     def __repr__(self):
         tmp = dict(mode=self.mode,
@@ -55,14 +70,24 @@ class options:
                    notice_level=self.notice_level,
                    msg_file=self.msg_file,
                    shared_msg_file=self.shared_msg_file,
+                   msg_async=self.msg_async,
                    nrank=self.nrank,
                    nx=self.nx,
                    ny=self.ny,
                    nz=self.nz,
                    linear=self.linear,
                    onelevel=self.onelevel,
+                   cuda_aware_mpi=self.cuda_aware_mpi,
+                   persistent_mpi=self.persistent_mpi,
+                   compress_ghosts=self.compress_ghosts,
+                   shared_mem_ghosts=self.shared_mem_ghosts,
+                   sort_ghosts=self.sort_ghosts,
+                   migrate_buffer=self.migrate_buffer,
                    single_mpi=self.single_mpi,
-                   nthreads=self.nthreads)
+                   nthreads=self.nthreads,
+                   thread_affinity=self.thread_affinity,
+                   first_touch=self.first_touch,
+                   huge_pages=self.huge_pages)
         return str(tmp);
 
 ## Parses command line options
@@ -79,15 +104,25 @@ def _parse_command_line(arg_string=None):
     parser.add_option("--notice-level", dest="notice_level", help="Minimum level of notice messages to print");
     parser.add_option("--msg-file", dest="msg_file", help="Name of file to write messages to");
     parser.add_option("--shared-msg-file", dest="shared_msg_file", help="(MPI only) Name of shared file to write message to (append partition #)");
+    parser.add_option("--msg-async", dest="msg_async", action="store_true", default=False, help="Write warnings and notices on a background thread");
     parser.add_option("--nrank", dest="nrank", help="(MPI) Number of ranks to include in a partition");
     parser.add_option("--nx", dest="nx", help="(MPI) Number of domains along the x-direction");
     parser.add_option("--ny", dest="ny", help="(MPI) Number of domains along the y-direction");
     parser.add_option("--nz", dest="nz", help="(MPI) Number of domains along the z-direction");
     parser.add_option("--linear", dest="linear", action="store_true", default=False, help="(MPI only) Force a slab (1D) decomposition along the z-direction");
     parser.add_option("--onelevel", dest="onelevel", action="store_true", default=False, help="(MPI only) Disable two-level (node-local) decomposition");
+    parser.add_option("--cuda-aware-mpi", dest="cuda_aware_mpi", type="choice", choices=["on", "off"], help="(MPI+GPU only) Pass device buffers directly to a CUDA-aware MPI library (on or off, default: the ENABLE_MPI_CUDA build option)");
+    parser.add_option("--persistent-mpi", dest="persistent_mpi", type="choice", choices=["on", "off"], help="(MPI only) Reuse persistent MPI requests for the CPU ghost update (on or off, default: on)");
+    parser.add_option("--compress-ghosts", dest="compress_ghosts", type="choice", choices=["on", "off"], help="(MPI only) Send ghost positions as 32 bit fixed-point coordinates in CPU ghost updates (on or off, default: off)");
+    parser.add_option("--shared-mem-ghosts", dest="shared_mem_ghosts", type="choice", choices=["on", "off"], help="(MPI only) Exchange ghost positions through shared memory with ranks on the same node in CPU ghost updates (on or off, default: off)");
+    parser.add_option("--sort-ghosts", dest="sort_ghosts", type="choice", choices=["on", "off"], help="(MPI only) Send ghost particles in the order of their cells in CPU ghost exchanges (on or off, default: off)");
+    parser.add_option("--migrate-buffer", dest="migrate_buffer", type="float", help="(MPI only) Migrate particles and exchange ghosts only after a particle has moved farther than this distance, in simulations without a neighbor list and in HPMC (default: 0, always migrate)");
     parser.add_option("--single-mpi", dest="single_mpi", action="store_true", help="Allow single-threaded HOOMD builds in MPI jobs");
     parser.add_option("--user", dest="user", help="User options");
     parser.add_option("--nthreads", dest="nthreads", help="Number of TBB threads");
+    parser.add_option("--thread-affinity", dest="thread_affinity", type="choice", choices=["none", "compact", "scatter"], help="(TBB only) Pin the TBB threads to cores, filling one NUMA node after the other (compact) or alternating between them (scatter) (default: none)");
+    parser.add_option("--first-touch", dest="first_touch", type="choice", choices=["on", "off"], help="(TBB only) Clear new host arrays with the TBB threads, placing their pages on the NUMA nodes of the threads that use them (on or off, default: off)");
+    parser.add_option("--huge-pages", dest="huge_pages", type="choice", choices=["on", "off"], help="Back host arrays of 2 MB or more with transparent huge pages (on or off, default: off)");
 
     input_args = None;
     if arg_string is not None:
@@ -162,6 +197,10 @@ def _parse_command_line(arg_string=None):
        except ValueError:
             parser.error('--nthreads must be an integer')
 
+    if (cmd_options.thread_affinity is not None or cmd_options.first_touch is not None) and not _hoomd.is_TBB_available():
+        hoomd.context.msg.error("The --thread-affinity and --first-touch options are only available in TBB-enabled builds.\n");
+        raise RuntimeError('Error setting option');
+
 
     # copy command line options over to global options
     hoomd.context.options.mode = cmd_options.mode;
@@ -175,8 +214,17 @@ def _parse_command_line(arg_string=None):
     hoomd.context.options.nz = cmd_options.nz;
     hoomd.context.options.linear = cmd_options.linear
     hoomd.context.options.onelevel = cmd_options.onelevel
+    hoomd.context.options.cuda_aware_mpi = cmd_options.cuda_aware_mpi
+    hoomd.context.options.persistent_mpi = cmd_options.persistent_mpi
+    hoomd.context.options.compress_ghosts = cmd_options.compress_ghosts
+    hoomd.context.options.shared_mem_ghosts = cmd_options.shared_mem_ghosts
+    hoomd.context.options.sort_ghosts = cmd_options.sort_ghosts
+    hoomd.context.options.migrate_buffer = cmd_options.migrate_buffer
     hoomd.context.options.single_mpi = cmd_options.single_mpi
     hoomd.context.options.nthreads = cmd_options.nthreads
+    hoomd.context.options.thread_affinity = cmd_options.thread_affinity
+    hoomd.context.options.first_touch = cmd_options.first_touch
+    hoomd.context.options.huge_pages = cmd_options.huge_pages
 
     if cmd_options.notice_level is not None:
         hoomd.context.options.notice_level = cmd_options.notice_level;
@@ -193,6 +241,9 @@ def _parse_command_line(arg_string=None):
         hoomd.context.options.shared_msg_file = cmd_options.shared_msg_file;
         hoomd.context.msg.setSharedFile(hoomd.context.options.shared_msg_file);
 
+    if cmd_options.msg_async:
+        set_msg_async(True);
+
     if cmd_options.nrank is not None:
         if not _hoomd.is_MPI_available():
             hoomd.context.msg.error("The --nrank option is only available in MPI builds.\n");
@@ -263,20 +314,102 @@ def set_msg_file(fname):
 
     hoomd.context.options.msg_file = fname;
 
-def set_autotuner_params(enable=True, period=100000):
+def set_msg_async(enable=True, buffer_size=1048576):
+    R""" Write warnings and notices on a background thread.
+
+    Args:
+        enable (bool): Set to True to buffer warnings and notices, False to write them immediately.
+        buffer_size (int): Size of the message buffer in bytes.
+
+    When enabled, warnings and notices are copied into a buffer and a background thread writes them to the message
+    file or to stdout/stderr, so that high notice levels can stay on in production runs without slowing them down.
+    The buffer is written out at least every 0.1 seconds, and the simulation only waits for the background thread
+    when the buffer is full. Error messages are always written immediately, after all buffered messages.
+
+    Messages written through python's ``sys.stdout`` (non-MPI runs) and the shared MPI message file
+    (``--shared-msg-file``) are not buffered.
+
+    Note:
+        Overrides ``--msg-async`` on the command line.
+
+    .. versionadded:: 2.5
+    """
+    _verify_init();
+
+    buffer_size = int(buffer_size);
+    if buffer_size <= 0:
+        hoomd.context.msg.error("buffer_size must be positive\n");
+        raise RuntimeError('Error setting option');
+
+    if enable and not hoomd.context.options.msg_async:
+        # write out buffered messages when python exits
+        atexit.register(hoomd.context.msg.flush);
+
+    hoomd.context.msg.setAsync(bool(enable), buffer_size);
+    hoomd.context.options.msg_async = bool(enable);
+
+def set_autotuner_params(enable=True, period=100000, cache=None):
     R""" Set autotuner parameters.
 
     Args:
         enable (bool). Set to True to enable autotuning. Set to False to disable.
         period (int): Approximate period in time steps between retuning.
+        cache (str): File to load and save tuned parameters (added in version 2.5).
 
     TODO: reference autotuner page here.
 
+    When *cache* is set, the parameters found by the autotuners are written to the file at the end of every
+    :py:func:`hoomd.run()`. The next job that sets the same *cache* starts each kernel with the parameter found
+    previously on the same GPU model and a similar number of particles per rank, instead of scanning all parameters
+    again. The cached parameters are re-validated by the periodic scans.
+
+    Example::
+
+        option.set_autotuner_params(cache='autotuner_cache.txt')
+
     """
     _verify_init();
 
     hoomd.context.options.autotuner_period = period;
     hoomd.context.options.autotuner_enable = enable;
+    hoomd.context.options.autotuner_cache = cache;
+
+def set_profiler_params(counters=False, peak_flops=None, peak_bandwidth=None):
+    R""" Set profiler parameters.
+
+    Args:
+        counters (bool): Set to True to read hardware performance counters with PAPI in profiled runs.
+        peak_flops (float): Peak floating point rate of the hardware in GFLOP/s, or None if unknown.
+        peak_bandwidth (float): Peak memory bandwidth of the hardware in GB/s, or None to use the memory bandwidth of
+                                the GPUs in GPU runs.
+
+    These parameters apply to runs with ``hoomd.run(..., profile=True)``. When *counters* is True, the profile lists
+    the floating point operations and the memory traffic (last level cache misses times 64 bytes) that the CPU counted
+    in each region next to the hand counted estimates. The counters measure the thread that runs the simulation loop,
+    so they do not include the work of TBB worker threads or of GPU kernels. Hardware counters require HOOMD to be
+    compiled with PAPI support (``ENABLE_PAPI``).
+
+    When the peak values are known, the profile gives the achieved FLOP rate and bandwidth of each region as a
+    percentage of the peak. Regions close to the peak bandwidth are memory bound, regions close to neither peak are
+    limited by latency.
+
+    .. versionadded:: 2.5
+
+    Example::
+
+        option.set_profiler_params(counters=True, peak_flops=1200, peak_bandwidth=200)
+        run(1000, profile=True)
+
+    """
+    _verify_init();
+
+    if counters and not _hoomd.is_PAPI_available():
+        hoomd.context.msg.warning("HOOMD was compiled without PAPI support, hardware counters are disabled.\n");
+        counters = False;
+
+    hoomd.context.options.profiler_counters = bool(counters);
+    hoomd.context.options.profiler_peak_flops = peak_flops;
+    hoomd.context.options.profiler_peak_bandwidth = peak_bandwidth;
 
 def set_num_threads(num_threads):
     R""" Set the number of CPU (TBB) threads HOOMD uses
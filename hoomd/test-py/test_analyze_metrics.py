@@ -0,0 +1,71 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+import hoomd
+hoomd.context.initialize()
+import unittest
+import tempfile
+import os
+
+# parse the samples of an OpenMetrics document
+def read_samples(text):
+    samples = {}
+    for line in text.splitlines():
+        if line.startswith('#') or len(line) == 0:
+            continue
+        name, value = line.rsplit(' ', 1)
+        samples[name] = float(value)
+    return samples
+
+class analyze_metrics_tests(unittest.TestCase):
+
+    def setUp(self):
+        self.s = hoomd.init.create_lattice(hoomd.lattice.sc(a=2.1878096788957757),n=[5,5,4]);
+        if hoomd.comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.prom');
+            self.tmp_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+
+    # test that the file contains the metrics of the run
+    def test_file(self):
+        m = hoomd.analyze.metrics(period=10, filename=self.tmp_file);
+        hoomd.run(21);
+
+        if hoomd.comm.get_rank() == 0:
+            with open(self.tmp_file) as f:
+                text = f.read()
+            self.assertTrue(text.endswith('# EOF\n'))
+            self.assertEqual(text, m.snapshot())
+
+            samples = read_samples(text)
+            self.assertEqual(samples['hoomd_timestep'], 20)
+            self.assertEqual(samples['hoomd_timesteps_total'], 20)
+            self.assertGreater(samples['hoomd_tps'], 0)
+            self.assertGreater(samples['hoomd_memory_host_bytes'], 0)
+            self.assertIn('hoomd_analyzer_seconds_total{analyzer="%s"}' % m.analyzer_name, samples)
+
+    # test the metrics published by the neighbor list and force computes
+    def test_compute_metrics(self):
+        nl = hoomd.md.nlist.cell();
+        lj = hoomd.md.pair.lj(r_cut=2.5, nlist=nl, name='lj');
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0);
+        hoomd.md.integrate.mode_standard(dt=0.005);
+        hoomd.md.integrate.nve(group=hoomd.group.all());
+
+        m = hoomd.analyze.metrics(period=10, filename=self.tmp_file);
+        hoomd.run(11);
+
+        if hoomd.comm.get_rank() == 0:
+            samples = read_samples(m.snapshot())
+            self.assertGreaterEqual(samples['hoomd_nlist_builds_total'], 1)
+            self.assertIn('hoomd_compute_seconds_total{compute="%s"}' % lj.force_name, samples)
+            self.assertGreater(samples['hoomd_integrator_seconds_total'], 0)
+
+    def tearDown(self):
+        hoomd.context.initialize();
+        if hoomd.comm.get_rank() == 0:
+            os.remove(self.tmp_file);
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
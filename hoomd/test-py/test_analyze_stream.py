@@ -0,0 +1,83 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+import hoomd
+hoomd.context.initialize()
+import unittest
+import tempfile
+import os
+import struct
+import numpy
+
+# read all frames of a stream written by analyze.stream
+def read_frames(filename):
+    frames = []
+    with open(filename, 'rb') as f:
+        while True:
+            header = f.read(72)
+            if len(header) < 72:
+                break
+            magic, n_chunks, step, N, rank = struct.unpack('=4sIQII', header[:24])
+            box = struct.unpack('=6d', header[24:])
+            frame = dict(step=step, N=N, rank=rank, box=box)
+            for i in range(n_chunks):
+                name, typecode, components = struct.unpack('=16s4sI', f.read(24))
+                dtype = numpy.dtype(typecode.rstrip(b'\0').decode())
+                data = numpy.frombuffer(f.read(N*components*dtype.itemsize), dtype=dtype)
+                frame[name.rstrip(b'\0').decode()] = data.reshape((N, components))
+            assert magic == b'HFRM'
+            frames.append(frame)
+    return frames
+
+class analyze_stream_tests(unittest.TestCase):
+
+    def setUp(self):
+        self.s = hoomd.init.create_lattice(hoomd.lattice.sc(a=2.1878096788957757),n=[5,5,4]);
+        if hoomd.comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.stream');
+            self.tmp_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+
+    # test that the frames contain the local particle data
+    @unittest.skipIf(hoomd.comm.get_num_ranks() > 1, "checks the single rank stream")
+    def test_frames(self):
+        stream = hoomd.analyze.stream(filename=self.tmp_file, period=10, quantities=['position', 'image', 'tag'],
+                                      drop=False)
+        hoomd.run(30)
+        stream.flush()
+
+        frames = read_frames(self.tmp_file)
+        self.assertEqual([f['step'] for f in frames], [0, 10, 20])
+        self.assertEqual(stream.dropped(), 0)
+
+        frame = frames[-1]
+        self.assertEqual(frame['N'], len(self.s.particles))
+        self.assertAlmostEqual(frame['box'][0], self.s.box.Lx, 5)
+        for i in range(frame['N']):
+            p = self.s.particles[int(frame['tag'][i,0])]
+            for k in range(3):
+                self.assertAlmostEqual(frame['position'][i,k], p.position[k], 5)
+                self.assertEqual(frame['image'][i,k], p.image[k])
+
+    # test invalid parameters
+    def test_invalid(self):
+        self.assertRaises(RuntimeError, hoomd.analyze.stream, filename=self.tmp_file, period=10,
+                          quantities=['mass'])
+        self.assertRaises(RuntimeError, hoomd.analyze.stream, filename=self.tmp_file, period=10, buffer_frames=0)
+
+    # test that every frame is either written or dropped
+    @unittest.skipIf(hoomd.comm.get_num_ranks() > 1, "checks the single rank stream")
+    def test_drop(self):
+        stream = hoomd.analyze.stream(filename=self.tmp_file, period=1, buffer_frames=1, drop=True)
+        hoomd.run(20)
+        stream.flush()
+        self.assertEqual(len(read_frames(self.tmp_file)) + stream.dropped(), 20)
+
+    def tearDown(self):
+        if hoomd.comm.get_rank() == 0:
+            os.remove(self.tmp_file);
+        hoomd.context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -0,0 +1,62 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+from hoomd import md
+import hoomd;
+context.initialize()
+import unittest
+import os
+import json
+import tempfile
+
+# unit tests for the hoomd.benchmark micro benchmarks and report
+class benchmark_tests (unittest.TestCase):
+    def setUp(self):
+        init.create_lattice(lattice.sc(a=1.5), n=[8,8,8]);
+        self.nl = md.nlist.cell()
+        self.lj = md.pair.lj(r_cut=2.5, nlist=self.nl)
+        self.lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+        md.integrate.mode_standard(dt=0.005)
+        md.integrate.nve(group=group.all())
+        run(1)
+
+    # test the micro benchmarks
+    def test_micro(self):
+        self.assertGreater(benchmark.compute(self.lj, 5), 0)
+        self.assertGreater(benchmark.compute(self.nl, 5), 0)
+        self.assertGreater(benchmark.cell_list(self.nl, 5), 0)
+
+        t = benchmark.communication(5)
+        if comm.get_num_ranks() == 1:
+            self.assertIsNone(t)
+        else:
+            self.assertGreater(t, 0)
+
+        self.assertRaises(RuntimeError, benchmark.compute, group.all())
+
+    # test the JSON report
+    def test_report(self):
+        r = benchmark.report(workload='test')
+        r.add('lj', 'tps', benchmark.series(warmup=1, repeat=2, steps=5))
+        r.add('lj/pair.lj', 'ms', benchmark.compute(self.lj, 5))
+        r.add('lj/exchange', 'ms', None)
+
+        filename = os.path.join(tempfile.gettempdir(), 'test_benchmark.json')
+        r.write(filename)
+
+        if comm.get_rank() == 0:
+            with open(filename) as f:
+                data = json.load(f)
+            os.remove(filename)
+
+            self.assertEqual(data['configuration']['workload'], 'test')
+            self.assertEqual(len(data['results']), 2)
+            self.assertEqual(len(data['results'][0]['values']), 2)
+            self.assertEqual(data['results'][1]['name'], 'lj/pair.lj')
+
+    def tearDown(self):
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
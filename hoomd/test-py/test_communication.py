@@ -293,6 +293,53 @@ class decomposition_tests (unittest.TestCase):
             comm.decomposition(y=0.3)
         context.initialize()
 
+    ## Test that the cut planes are placed by bisection of the particles
+    def test_bisect(self):
+        if comm.get_num_ranks() > 1:
+            snap = data.make_snapshot(N=100, box=data.boxdim(L=10), particle_types=['A'])
+            if comm.get_rank() == 0:
+                # put three quarters of the particles into the lower half of the box
+                for i in range(snap.particles.N):
+                    z = -4.5 + 0.06*i if i < 75 else 0.5 + 0.16*(i-75)
+                    snap.particles.position[i] = (0, 0, z)
+
+            comm.decomposition(nx=1, ny=1, nz=comm.get_num_ranks(), bisect=True)
+            init.read_snapshot(snap)
+
+            cum_z = hoomd.context.current.decomposition.cpp_dd.getCumulativeFractions(2)
+            self.assertAlmostEqual(cum_z[0], 0.0)
+            self.assertAlmostEqual(cum_z[-1], 1.0)
+            # the lowest slab must be narrower than uniform
+            self.assertLess(cum_z[1], 1.0/comm.get_num_ranks())
+            for i in range(comm.get_num_ranks()):
+                self.assertGreater(cum_z[i+1], cum_z[i])
+            context.initialize()
+
+    ## Test that particles are found with the distributed tag directory
+    def test_tag_directory(self):
+        if comm.get_num_ranks() > 1:
+            snap = data.make_snapshot(N=100, box=data.boxdim(L=10), particle_types=['A'])
+            if comm.get_rank() == 0:
+                for i in range(snap.particles.N):
+                    snap.particles.position[i] = (-4.5 + 0.09*i, 4.5 - 0.09*i, -4.5 + 0.09*((7*i) % 100))
+
+            comm.decomposition(tag_directory=True)
+            system = init.read_snapshot(snap)
+
+            # move one particle to another domain, which migrates it and invalidates the directory
+            system.particles[3].position = (4, 4, 4)
+            for i in [0, 3, 42, 99]:
+                pos = system.particles[i].position
+                if i == 3:
+                    self.assertAlmostEqual(pos[0], 4)
+                else:
+                    self.assertAlmostEqual(pos[0], -4.5 + 0.09*i, 5)
+                    self.assertAlmostEqual(pos[1], 4.5 - 0.09*i, 5)
+
+            tag = system.particles.add('A')
+            self.assertEqual(system.particles[tag].type, 'A')
+            context.initialize()
+
     ## Test that errors are raised if fractional divisions exceed 1.0
     def test_bad_fractions(self):
         if comm.get_num_ranks() > 1:
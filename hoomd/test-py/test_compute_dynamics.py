@@ -0,0 +1,83 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+context.initialize()
+import unittest
+import numpy
+
+# unit tests for compute.dynamics
+class compute_dynamics_tests (unittest.TestCase):
+    def setUp(self):
+        snap = data.make_snapshot(N=4, particle_types=['A', 'B'], box=data.boxdim(L=10))
+        if comm.get_rank() == 0:
+            snap.particles.position[:] = [[-4, -4, -4], [4, -4, -4], [-4, 4, 4], [4, 4, 4]]
+            snap.particles.typeid[:] = [0, 0, 1, 1]
+
+        self.s = init.read_snapshot(snap)
+
+    # API test: tests basic creation of the compute
+    def test_api(self):
+        compute.dynamics(group=group.all(), origins=2, origin_period=10, k=1.0)
+        run(1)
+
+    # Unit test: validate the displacements, including those across the periodic boundaries
+    def test_msd(self):
+        compute.dynamics(group=group.all(), origins=2, origin_period=2, k=1.0)
+        quantities = ['msd_0', 'isf_0', 'msd_origin_0', 'msd_1', 'isf_1', 'msd_origin_1']
+        log = analyze.log(filename=None, quantities=quantities, period=None)
+
+        # origin 0 is set on the first evaluation
+        self.assertAlmostEqual(log.query('msd_0'), 0.0)
+        self.assertAlmostEqual(log.query('isf_0'), 1.0)
+        self.assertEqual(log.query('msd_origin_0'), 0)
+        self.assertAlmostEqual(log.query('msd_1'), 0.0)
+
+        # particle 1 crosses the boundary in x, particle 3 in y and z
+        dr = numpy.array([[0.5, 0, 0], [2, 0, 0], [0, 0, 0], [0, 1.5, 1]])
+        for i,p in enumerate(self.s.particles):
+            p.position = tuple(numpy.array(p.position) + dr[i])
+
+        run(1)
+        msd = numpy.mean(numpy.sum(dr**2, axis=1))
+        isf = numpy.mean(numpy.sum(numpy.cos(dr), axis=1)/3)
+        self.assertAlmostEqual(log.query('msd_0'), msd, places=5)
+        self.assertAlmostEqual(log.query('isf_0'), isf, places=5)
+
+        # origin 1 is set at time step 2, origin 0 again at time step 4
+        run(1)
+        self.assertAlmostEqual(log.query('msd_1'), 0.0)
+        self.assertEqual(log.query('msd_origin_1'), 2)
+        self.assertAlmostEqual(log.query('msd_0'), msd, places=5)
+
+        for i,p in enumerate(self.s.particles):
+            p.position = tuple(numpy.array(p.position) - dr[i])
+        run(1)
+        self.assertAlmostEqual(log.query('msd_1'), msd, places=5)
+        self.assertAlmostEqual(log.query('msd_0'), 0.0, places=5)
+
+        run(1)
+        self.assertEqual(log.query('msd_origin_0'), 4)
+        self.assertAlmostEqual(log.query('msd_0'), 0.0)
+
+    # Unit test: the suffix of a group
+    def test_group(self):
+        compute.dynamics(group=group.type(name='typeB', type='B'), origins=1, origin_period=100, k=1.0)
+        log = analyze.log(filename=None, quantities=['msd_0_typeB'], period=None)
+        self.assertAlmostEqual(log.query('msd_0_typeB'), 0.0)
+
+        self.s.particles[2].position = (-4, 4, 3)
+        run(1)
+        self.assertAlmostEqual(log.query('msd_0_typeB'), 0.5, places=5)
+
+    # Unit test: invalid parameters
+    def test_invalid(self):
+        self.assertRaises(ValueError, compute.dynamics, group=group.all(), origins=0)
+        self.assertRaises(ValueError, compute.dynamics, group=group.all(), origin_period=0)
+
+    def tearDown(self):
+        context.initialize()
+
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
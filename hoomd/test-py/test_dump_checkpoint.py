@@ -0,0 +1,110 @@
+# -*- coding: iso-8859-1 -*-
+
+from hoomd import *
+import hoomd;
+import unittest
+import os
+import glob
+import numpy
+import tempfile
+
+# unit tests for dump.checkpoint and init.read_checkpoint
+class checkpoint_tests (unittest.TestCase):
+    def setUp(self):
+        context.initialize()
+        if comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.test.chk');
+            self.tmp_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+
+        self.snapshot = data.make_snapshot(N=4, box=data.boxdim(Lx=10, Ly=20, Lz=30, xy=0.5), dtype='double');
+        if comm.get_rank() == 0:
+            self.snapshot.particles.position[:] = [[0,1,2], [1,2,3], [0,-1,-2], [-1,-2,-3]];
+            self.snapshot.particles.velocity[:] = [[10,11,12], [11,12,13], [12,13,14], [13,14,15]];
+            self.snapshot.particles.typeid[:] = [0,0,1,1];
+            self.snapshot.particles.mass[:] = [33, 34, 35, 36];
+            self.snapshot.particles.charge[:] = [44, 45, 46, 47];
+            self.snapshot.particles.diameter[:] = [55, 56, 57, 58];
+            self.snapshot.particles.image[:] = [[60,61,62], [61,62,63], [62,63,64], [63,64,65]];
+            self.snapshot.particles.orientation[:] = [[1,0,0,0], [0,1,0,0], [0,0,1,0], [0,0,0,1]];
+            self.snapshot.particles.types = ['p1', 'p2'];
+
+            self.snapshot.bonds.types = ['b1', 'b2'];
+            self.snapshot.bonds.resize(2);
+            self.snapshot.bonds.typeid[:] = [0, 1];
+            self.snapshot.bonds.group[0] = [0, 1];
+            self.snapshot.bonds.group[1] = [2, 3];
+
+    # checkpoints restore all particle properties, bonds and the time step
+    def test_write_read(self):
+        init.read_snapshot(self.snapshot, time_step=1234);
+        dump.checkpoint(filename=self.tmp_file, period=None);
+        self.assertTrue(comm.get_rank() != 0 or os.path.exists(self.tmp_file));
+
+        context.initialize();
+        system = init.read_checkpoint(self.tmp_file);
+        self.assertEqual(get_step(), 1234);
+
+        snap = system.take_snapshot(bonds=True, dtype='double');
+        if comm.get_rank() == 0:
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position);
+            numpy.testing.assert_array_equal(snap.particles.velocity, self.snapshot.particles.velocity);
+            numpy.testing.assert_array_equal(snap.particles.typeid, self.snapshot.particles.typeid);
+            numpy.testing.assert_array_equal(snap.particles.mass, self.snapshot.particles.mass);
+            numpy.testing.assert_array_equal(snap.particles.charge, self.snapshot.particles.charge);
+            numpy.testing.assert_array_equal(snap.particles.diameter, self.snapshot.particles.diameter);
+            numpy.testing.assert_array_equal(snap.particles.image, self.snapshot.particles.image);
+            numpy.testing.assert_array_equal(snap.particles.orientation, self.snapshot.particles.orientation);
+            self.assertEqual(snap.particles.types, ['p1', 'p2']);
+            self.assertEqual(snap.box.xy, 0.5);
+
+            self.assertEqual(snap.bonds.N, 2);
+            self.assertEqual(snap.bonds.types, ['b1', 'b2']);
+            numpy.testing.assert_array_equal(snap.bonds.typeid, [0, 1]);
+            numpy.testing.assert_array_equal(snap.bonds.group, [[0, 1], [2, 3]]);
+
+    # tags are compacted after particles are removed
+    def test_removed_particles(self):
+        system = init.read_snapshot(self.snapshot);
+        system.bonds.remove(0);
+        system.particles.remove(1);
+        dump.checkpoint(filename=self.tmp_file, period=None);
+
+        context.initialize();
+        system = init.read_checkpoint(self.tmp_file);
+        self.assertEqual(len(system.particles), 3);
+
+        snap = system.take_snapshot(bonds=True, dtype='double');
+        if comm.get_rank() == 0:
+            numpy.testing.assert_array_equal(snap.particles.mass, [33, 35, 36]);
+            self.assertEqual(snap.bonds.N, 1);
+            numpy.testing.assert_array_equal(snap.bonds.group, [[1, 2]]);
+
+    # a checkpoint replaces the previous one
+    def test_period(self):
+        init.read_snapshot(self.snapshot);
+        dump.checkpoint(filename=self.tmp_file, period=10);
+        run(25);
+
+        context.initialize();
+        init.read_checkpoint(self.tmp_file);
+        self.assertEqual(get_step(), 20);
+
+    def test_invalid_file(self):
+        if comm.get_rank() == 0:
+            with open(self.tmp_file, 'w') as f:
+                f.write('not a checkpoint');
+        comm.barrier_all();
+
+        self.assertRaises(RuntimeError, init.read_checkpoint, self.tmp_file);
+
+    def tearDown(self):
+        comm.barrier_all();
+        if comm.get_rank() == 0:
+            for f in glob.glob(self.tmp_file + '*'):
+                os.remove(f);
+        comm.barrier_all();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
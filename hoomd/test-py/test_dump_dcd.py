@@ -7,6 +7,7 @@ context.initialize()
 import unittest
 import os
 import tempfile
+import numpy
 
 # unit tests for dump.dcd
 class dmp_dcd_tests (unittest.TestCase):
@@ -80,5 +81,80 @@ class dmp_dcd_tests (unittest.TestCase):
         context.initialize();
 
 
+# read the frames of a dcd file written by dump.dcd, returns a list of (N,3) position arrays
+def read_dcd(filename):
+    frames = [];
+    with open(filename, 'rb') as f:
+        data = f.read();
+
+    # the header records of 84, 164 and 4 bytes end with the number of particles
+    N = numpy.frombuffer(data, dtype=numpy.int32, count=1, offset=268)[0];
+    offset = 276;
+    while offset < len(data):
+        # skip the unit cell record, then read x, y and z
+        offset += 56;
+        pos = numpy.zeros(shape=(N,3), dtype=numpy.float32);
+        for d in range(3):
+            pos[:,d] = numpy.frombuffer(data, dtype=numpy.float32, count=N, offset=offset+4);
+            offset += 4*N + 8;
+        frames.append(pos);
+    return frames;
+
+# checks the contents of the frames written by dump.dcd
+class dmp_dcd_frame_tests (unittest.TestCase):
+    def setUp(self):
+        self.N = 100;
+        self.L = 10;
+        snap = data.make_snapshot(N=self.N, box=data.boxdim(L=self.L), particle_types=['A', 'B']);
+
+        # random positions are far from the memory order that the sorter and the domain decomposition choose
+        if comm.get_rank() == 0:
+            numpy.random.seed(11);
+            snap.particles.position[:] = numpy.random.uniform(-self.L/2, self.L/2, size=(self.N,3));
+            snap.particles.image[:] = numpy.random.randint(-2, 3, size=(self.N,3));
+            snap.particles.typeid[:] = numpy.arange(self.N) % 2;
+        self.s = init.read_snapshot(snap);
+
+        if comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.test.dcd');
+            self.tmp_file = tmp[1]+'.tmp';
+        else:
+            self.tmp_file = "invalid";
+
+    # write two frames and close the file
+    def write_frames(self, **kwargs):
+        dump.dcd(filename=self.tmp_file, period=1, **kwargs);
+        run(2);
+        snap = self.s.take_snapshot();
+        del self.s;
+        context.initialize();
+        return snap;
+
+    # positions are written in tag order
+    def test_tag_order(self):
+        snap = self.write_frames();
+        if comm.get_rank() == 0:
+            frames = read_dcd(self.tmp_file);
+            self.assertEqual(len(frames), 2);
+            for pos in frames:
+                numpy.testing.assert_allclose(pos, snap.particles.position, rtol=1e-6, atol=1e-6);
+
+    # group members are written in increasing tag order, unwrapped by their images
+    def test_group_unwrap_full(self):
+        typeB = group.type('B');
+        snap = self.write_frames(group=typeB, unwrap_full=True);
+        if comm.get_rank() == 0:
+            tags = numpy.arange(1, self.N, 2);
+            ref = snap.particles.position[tags] + self.L*snap.particles.image[tags];
+            frames = read_dcd(self.tmp_file);
+            self.assertEqual(len(frames), 2);
+            for pos in frames:
+                numpy.testing.assert_allclose(pos, ref, rtol=1e-5, atol=1e-5);
+
+    def tearDown(self):
+        if comm.get_rank() == 0 and os.path.exists(self.tmp_file):
+            os.remove(self.tmp_file);
+        context.initialize();
+
 if __name__ == '__main__':
     unittest.main(argv = ['test.py', '-v'])
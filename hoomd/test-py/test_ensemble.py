@@ -0,0 +1,67 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+from hoomd import md
+import hoomd;
+context.initialize()
+import unittest
+import numpy
+
+# unit tests for ensemble.replicas
+class ensemble_replicas_tests (unittest.TestCase):
+    def setUp(self):
+        self.snap = data.make_snapshot(N=4, box=data.boxdim(L=10), particle_types=['A', 'B'], bond_types=['polymer'])
+        if comm.get_rank() == 0:
+            self.snap.particles.position[:] = [[0,0,0], [1.1,0,0], [2.2,0,0], [3.3,0,0]]
+            self.snap.particles.typeid[:] = [0, 1, 0, 1]
+            self.snap.particles.mass[:] = [1, 2, 1, 2]
+            self.snap.bonds.resize(2)
+            self.snap.bonds.group[:] = [[0, 1], [2, 3]]
+
+    # test that the replicas are copies of the snapshot
+    def test_replicate(self):
+        ensemble = hoomd.ensemble.replicas(self.snap, n=3)
+        self.assertEqual(ensemble.N, 4)
+        self.assertEqual(ensemble.types(2), ['A.2', 'B.2'])
+
+        snap = ensemble.system.take_snapshot(bonds=True)
+        if comm.get_rank() == 0:
+            self.assertEqual(snap.particles.N, 12)
+            self.assertEqual(snap.particles.types, ['A.0', 'B.0', 'A.1', 'B.1', 'A.2', 'B.2'])
+            numpy.testing.assert_array_equal(snap.particles.typeid, [0, 1, 0, 1, 2, 3, 2, 3, 4, 5, 4, 5])
+            numpy.testing.assert_allclose(snap.particles.mass, [1, 2, 1, 2]*3)
+            self.assertEqual(snap.bonds.N, 6)
+            numpy.testing.assert_array_equal(snap.bonds.group[4], [8, 9])
+            numpy.testing.assert_array_equal(snap.bonds.typeid, [0]*6)
+
+        self.assertEqual(ensemble.group(1).cpp_group.getNumMembersGlobal(), 4)
+        self.assertRaises(RuntimeError, ensemble.group, 3)
+
+    # test that the replicas do not interact
+    def test_independent(self):
+        ensemble = hoomd.ensemble.replicas(self.snap, n=4)
+        nl = md.nlist.tree()
+        lj = md.pair.lj(r_cut=2.5, nlist=nl)
+        ensemble.pair_coeff(lj, 'A', 'A', epsilon=1.0, sigma=1.0)
+        ensemble.pair_coeff(lj, 'A', 'B', epsilon=1.0, sigma=1.0)
+        ensemble.pair_coeff(lj, 'B', 'B', epsilon=1.0, sigma=1.0)
+
+        md.integrate.mode_standard(dt=0.001)
+        md.integrate.nve(group=group.all())
+        run(1)
+
+        e0 = lj.get_energy(ensemble.group(0))
+        for i in range(1, 4):
+            self.assertAlmostEqual(lj.get_energy(ensemble.group(i)), e0, 5)
+
+        # energy of a single copy of the system
+        self.assertAlmostEqual(lj.get_energy(group.all()), 4*e0, 4)
+
+        self.assertRaises(RuntimeError, ensemble.pair_coeff, lj, 'A', 'C', epsilon=1.0, sigma=1.0)
+
+    def tearDown(self):
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
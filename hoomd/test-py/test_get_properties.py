@@ -0,0 +1,94 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+import hoomd;
+from hoomd import md;
+context.initialize()
+import unittest
+import numpy
+
+# unit tests for particle_data.get_properties() and group.get_properties()
+class get_properties_tests (unittest.TestCase):
+    def setUp(self):
+        self.N = 50;
+        snap = data.make_snapshot(N=self.N, box=data.boxdim(L=10), particle_types=['A', 'B']);
+        if comm.get_rank() == 0:
+            numpy.random.seed(7);
+            snap.particles.position[:] = numpy.random.uniform(-5, 5, size=(self.N,3));
+            snap.particles.image[:] = numpy.random.randint(-3, 4, size=(self.N,3));
+            snap.particles.velocity[:] = numpy.random.normal(size=(self.N,3));
+            snap.particles.mass[:] = numpy.random.uniform(0.5, 2.0, size=self.N);
+            snap.particles.typeid[:] = numpy.arange(self.N) % 2;
+            snap.particles.charge[:] = numpy.random.uniform(-1, 1, size=self.N);
+            snap.particles.diameter[:] = numpy.random.uniform(0.5, 1.5, size=self.N);
+            q = numpy.random.normal(size=(self.N,4));
+            snap.particles.orientation[:] = q / numpy.linalg.norm(q, axis=1)[:,numpy.newaxis];
+        self.s = init.read_snapshot(snap);
+
+    # compare the properties of the given tags with a snapshot
+    def check_snapshot(self, props, tags, fields):
+        snap = self.s.take_snapshot();
+        if comm.get_rank() == 0:
+            for f in fields:
+                ref = getattr(snap.particles, f)[tags];
+                self.assertEqual(props[f].shape, ref.shape);
+                numpy.testing.assert_allclose(props[f], ref, rtol=1e-5, atol=1e-6);
+
+    # every property of the requested tags is returned in the order of the tags
+    def test_all_fields(self):
+        tags = list(range(self.N));
+        numpy.random.RandomState(3).shuffle(tags);
+        props = self.s.particles.get_properties(tags);
+        fields = ['position', 'image', 'velocity', 'mass', 'typeid', 'charge', 'diameter', 'body', 'orientation'];
+        self.assertEqual(sorted(props.keys()), sorted(fields));
+        self.check_snapshot(props, tags, fields);
+
+        # all ranks receive the same values as the particle proxies
+        for k in [0, 17, 49]:
+            p = self.s.particles[tags[k]];
+            numpy.testing.assert_allclose(props['position'][k], p.position, rtol=1e-5, atol=1e-6);
+            numpy.testing.assert_allclose(props['velocity'][k], p.velocity, rtol=1e-5, atol=1e-6);
+            self.assertEqual(props['typeid'][k], p.typeid);
+            numpy.testing.assert_allclose(props['charge'][k], p.charge, rtol=1e-5);
+
+    # only the requested fields are returned, also for repeated and empty tag lists
+    def test_fields(self):
+        props = self.s.particles.get_properties([3, 3, 8], ['position', 'typeid']);
+        self.assertEqual(sorted(props.keys()), ['position', 'typeid']);
+        self.check_snapshot(props, [3, 3, 8], ['position', 'typeid']);
+
+        props = self.s.particles.get_properties([], ['charge']);
+        self.assertEqual(len(props['charge']), 0);
+
+        with self.assertRaises(ValueError):
+            self.s.particles.get_properties([0], ['foo']);
+
+    # the returned values follow the particles as they move between ranks
+    def test_after_run(self):
+        md.integrate.mode_standard(dt=0.005);
+        md.integrate.nve(group=group.all());
+        run(100);
+
+        tags = list(range(self.N));
+        props = self.s.particles.get_properties(tags, ['position', 'image', 'velocity']);
+        self.check_snapshot(props, tags, ['position', 'image', 'velocity']);
+
+    # the group returns the properties of its members in increasing tag order
+    def test_group(self):
+        gB = group.type(name='B', type='B');
+        props = gB.get_properties(['charge', 'typeid']);
+        numpy.testing.assert_array_equal(props['tag'], numpy.arange(1, self.N, 2));
+        numpy.testing.assert_array_equal(props['typeid'], numpy.ones(self.N//2));
+        self.check_snapshot(props, list(props['tag']), ['charge']);
+
+        # all fields
+        props = gB.get_properties();
+        self.assertEqual(len(props['position']), len(gB));
+
+    def tearDown(self):
+        del self.s
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -266,6 +266,27 @@ class test_basic_io(unittest.TestCase):
 
             hoomd.init.restore_getar(tmp_file);
 
+    def test_periodic_async(self):
+        N = 10;
+        box = hoomd.data.boxdim(20*N, 40*N, 60*N);
+        snap = hoomd.data.make_snapshot(N, box);
+        if hoomd.comm.get_rank() == 0:
+            snap.particles.position[:] = [(i, 2*i, 3*i) for i in range(N)];
+        hoomd.init.read_snapshot(snap);
+
+        for (suffix, mode) in [('zip', 'w'), ('tar', 'w'), ('sqlite', 'w'), ('zip', '1')]:
+            fname_suffix = 'dump.{}'.format(suffix);
+            tmp_file = get_tmp(suffix=fname_suffix);
+
+            dump = hoomd.dump.getar(tmp_file, mode=mode, static=['viz_static'],
+                                    dynamic={'viz_aniso_dynamic': 1}, async_write=True, queue_depth=1);
+            hoomd.run(5);
+            dump.close();
+            dump.disable();
+            hoomd.comm.barrier_all();
+
+            hoomd.init.restore_getar(tmp_file);
+
     def test_write_json(self):
         N = 10;
         box = hoomd.data.boxdim(20*N, 40*N, 60*N);
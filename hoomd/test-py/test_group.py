@@ -3,6 +3,7 @@
 
 from hoomd import *
 import hoomd;
+from hoomd import md;
 context.initialize()
 import unittest
 import os
@@ -218,5 +219,39 @@ class pair_group_tests (unittest.TestCase):
         del self.s
         context.initialize();
 
+# group - test the index list of a small group after frequent particle sorts
+class group_sort_tests (unittest.TestCase):
+    def setUp(self):
+        print
+        snap = data.make_snapshot(N=1000, box=data.boxdim(L=20), particle_types=['A']);
+        if comm.get_rank() == 0:
+            import numpy
+            numpy.random.seed(11);
+            snap.particles.position[:] = numpy.random.uniform(-10, 10, size=(1000,3));
+            snap.particles.velocity[:] = numpy.random.uniform(-1, 1, size=(1000,3));
+        self.s = init.read_snapshot(snap);
+
+        context.current.sorter.set_params(grid=8)
+        context.current.sorter.set_period(1)
+
+    def test_integrate_members(self):
+        small = group.tags(tag_min=10, tag_max=19);
+        snap_before = self.s.take_snapshot();
+
+        md.integrate.mode_standard(dt=0.01);
+        md.integrate.nve(group=small);
+        run(10);
+
+        # only the members have moved, and all of them have
+        snap_after = self.s.take_snapshot();
+        if comm.get_rank() == 0:
+            import numpy
+            moved = numpy.any(snap_before.particles.position != snap_after.particles.position, axis=1);
+            self.assertEqual(list(numpy.nonzero(moved)[0]), list(range(10,20)));
+
+    def tearDown(self):
+        del self.s
+        context.initialize();
+
 if __name__ == '__main__':
     unittest.main(argv = ['test.py', '-v'])
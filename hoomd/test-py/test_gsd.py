@@ -95,6 +95,115 @@ class gsd_write_tests (unittest.TestCase):
         if comm.get_rank() == 0:
             self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=5);
 
+    # tests asynchronous writes
+    def test_async(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, async_write=True);
+        run(5);
+        # all 5 frames are in the file when run() returns
+        data.gsd_snapshot(self.tmp_file, frame=4);
+        if comm.get_rank() == 0:
+            self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=5);
+
+    # tests asynchronous writes with truncate
+    def test_async_truncate(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, truncate=True, overwrite=True, async_write=True);
+        run(5);
+        data.gsd_snapshot(self.tmp_file, frame=0);
+        if comm.get_rank() == 0:
+            self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=1);
+
+    # tests collective writes of the particle data
+    def test_parallel_io(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, parallel_io=True,
+                 dynamic=['attribute', 'momentum']);
+        run(2);
+        snap = data.gsd_snapshot(self.tmp_file, frame=1);
+        if comm.get_rank() == 0:
+            self.assertRaises(RuntimeError, data.gsd_snapshot, self.tmp_file, frame=2);
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position);
+            numpy.testing.assert_array_equal(snap.particles.velocity, self.snapshot.particles.velocity);
+            numpy.testing.assert_array_equal(snap.particles.typeid, self.snapshot.particles.typeid);
+            numpy.testing.assert_array_equal(snap.particles.mass, self.snapshot.particles.mass);
+            numpy.testing.assert_array_equal(snap.particles.image, self.snapshot.particles.image);
+
+    # tests random access reads with a persistent reader
+    def test_reader(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, dynamic=['momentum']);
+        run(3);
+        reader = data.gsd_reader(self.tmp_file);
+        snap = reader.snapshot(-1);
+        if comm.get_rank() == 0:
+            self.assertEqual(reader.nframes, 3);
+            self.assertTrue(reader.has_chunk(2, 'particles/velocity'));
+            self.assertFalse(reader.has_chunk(2, 'particles/typeid'));
+            numpy.testing.assert_array_equal(snap.particles.typeid, self.snapshot.particles.typeid);
+
+            vel = numpy.zeros((4,3), dtype=numpy.float32);
+            self.assertTrue(reader.read_chunk(2, 'particles/velocity', vel));
+            numpy.testing.assert_array_equal(vel, snap.particles.velocity);
+
+            # chunks that are only stored in frame 0 are read from there
+            typeid = numpy.zeros(4, dtype=numpy.uint32);
+            self.assertTrue(reader.read_chunk(2, 'particles/typeid', typeid));
+            numpy.testing.assert_array_equal(typeid, self.snapshot.particles.typeid);
+            self.assertFalse(reader.read_chunk(2, 'particles/missing', typeid));
+
+            # the output array must have the size of the chunk
+            self.assertRaises(RuntimeError, reader.read_chunk, 0, 'particles/velocity', numpy.zeros(4, dtype=numpy.float32));
+            self.assertRaises(RuntimeError, reader.snapshot, 3);
+
+    # tests quantized positions
+    def test_position_bits(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=None, overwrite=True, position_bits=16);
+        snap = data.gsd_snapshot(self.tmp_file, frame=0);
+        if comm.get_rank() == 0:
+            tol = numpy.array([10, 20, 30]) / 2.0**17;
+            for i in range(4):
+                diff = numpy.abs(snap.particles.position[i] - self.snapshot.particles.position[i]);
+                self.assertTrue(numpy.all(diff <= tol*1.01));
+
+    # tests delta encoded positions
+    def test_keyframe_period(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True, keyframe_period=3, delta_resolution=1e-3);
+
+        # move particle 0 a little in every frame, and particle 1 across the periodic boundary in x
+        expected = [];
+        for f in range(5):
+            self.s.particles[0].position = (0.01*f, 1, 2);
+            self.s.particles[1].position = (4.99 if f < 2 else -4.99, 2, 3);
+            self.s.particles[2].orientation = (numpy.cos(0.01*(f+1)), numpy.sin(0.01*(f+1)), 0, 0);
+            expected.append(([p.position for p in self.s.particles], self.s.particles[2].orientation));
+            run(1);
+
+        for f in range(5):
+            snap = data.gsd_snapshot(self.tmp_file, frame=f);
+            if comm.get_rank() == 0:
+                pos, orientation = expected[f];
+                numpy.testing.assert_allclose(snap.particles.position, numpy.array(pos), atol=0.51e-3);
+                numpy.testing.assert_allclose(snap.particles.orientation[2], numpy.array(orientation), atol=1e-4);
+
+        # frames 0 and 3 are keyframes
+        reader = data.gsd_reader(self.tmp_file);
+        if comm.get_rank() == 0:
+            self.assertFalse(reader.has_chunk(0, 'particles/position_delta'));
+            self.assertTrue(reader.has_chunk(1, 'particles/position_delta'));
+            self.assertTrue(reader.has_chunk(2, 'particles/orientation_delta'));
+            self.assertFalse(reader.has_chunk(3, 'particles/position_delta'));
+            self.assertTrue(reader.has_chunk(4, 'particles/position_delta'));
+
+    # tests a dump of a group that does not include all particles
+    def test_group(self):
+        dump.gsd(filename=self.tmp_file, group=group.type('p2'), period=None, overwrite=True);
+        snap = data.gsd_snapshot(self.tmp_file, frame=0);
+        if comm.get_rank() == 0:
+            self.assertEqual(snap.particles.N, 2);
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position[2:4]);
+            numpy.testing.assert_array_equal(snap.particles.velocity, self.snapshot.particles.velocity[2:4]);
+            numpy.testing.assert_array_equal(snap.particles.image, self.snapshot.particles.image[2:4]);
+            numpy.testing.assert_array_equal(snap.particles.mass, self.snapshot.particles.mass[2:4]);
+            numpy.testing.assert_array_equal(snap.particles.typeid, [1, 1]);
+            self.assertEqual(snap.particles.types, ['p1', 'p2']);
+
     # tests with phase
     def test_phase(self):
         dump.gsd(filename=self.tmp_file, group=group.all(), period=1, phase=0, overwrite=True);
@@ -165,6 +274,20 @@ class gsd_write_tests (unittest.TestCase):
         if comm.get_rank() == 0:
             self.assertRaises(RuntimeError, init.read_gsd, self.tmp_file, frame=5);
 
+    # tests init.read_gsd with every rank reading a part of the file
+    def test_read_gsd_parallel_io(self):
+        dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True);
+        run(5);
+
+        context.initialize();
+        system = init.read_gsd(filename=self.tmp_file, frame=4, parallel_io=True);
+        self.assertEqual(get_step(), 4)
+        snap = system.take_snapshot(bonds=True);
+        if comm.get_rank() == 0:
+            numpy.testing.assert_array_equal(snap.particles.position, self.snapshot.particles.position);
+            numpy.testing.assert_array_equal(snap.particles.typeid, self.snapshot.particles.typeid);
+            self.assertEqual(snap.bonds.N, 2);
+
     # tests init.read_gsd time_step
     def test_read_gsd_time_step(self):
         dump.gsd(filename=self.tmp_file, group=group.all(), period=1, overwrite=True);
@@ -0,0 +1,69 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+import hoomd;
+context.initialize()
+import unittest
+import numpy
+
+# minimum distance between any two particles of a snapshot in a cubic (or square) box
+def min_distance(snap):
+    L = numpy.array([snap.box.Lx, snap.box.Ly, snap.box.Lz]);
+    pos = snap.particles.position;
+    dmin = float('inf');
+    for i in range(len(pos)-1):
+        dr = pos[i+1:] - pos[i];
+        dr -= L * numpy.round(dr / L);
+        if snap.box.dimensions == 2:
+            dr[:,2] = 0;
+        dmin = min(dmin, numpy.min(numpy.sqrt(numpy.sum(dr*dr, axis=1))));
+    return dmin;
+
+# unit tests for init.create_random
+class init_create_random_tests (unittest.TestCase):
+    def test_3d(self):
+        # packing fraction 0.25
+        sysdef = init.create_random(N=1000, box=data.boxdim(L=12.8), diameter=1.0, seed=5);
+        self.assertEqual(sysdef.particles.pdata.getNGlobal(), 1000);
+
+        snap = sysdef.take_snapshot();
+        if comm.get_rank() == 0:
+            self.assertEqual(snap.particles.types, ['A']);
+            numpy.testing.assert_allclose(snap.particles.diameter, 1.0);
+            self.assertGreaterEqual(min_distance(snap), 1.0 - 1e-5);
+
+            # the particles are spread over the whole box
+            hist = numpy.histogram(snap.particles.position[:,0], bins=4, range=(-6.4, 6.4))[0];
+            self.assertTrue(numpy.all(hist > 150));
+
+    def test_2d(self):
+        sysdef = init.create_random(N=500, box=data.boxdim(L=30, dimensions=2), diameter=1.2, name='B', seed=2);
+        snap = sysdef.take_snapshot();
+        if comm.get_rank() == 0:
+            self.assertEqual(snap.box.dimensions, 2);
+            self.assertEqual(snap.particles.N, 500);
+            self.assertEqual(snap.particles.types, ['B']);
+            numpy.testing.assert_allclose(snap.particles.position[:,2], 0);
+            self.assertGreaterEqual(min_distance(snap), 1.2 - 1e-5);
+
+    def test_seed(self):
+        sysdef = init.create_random(N=200, box=data.boxdim(L=10), seed=7);
+        snap = sysdef.take_snapshot();
+
+        context.initialize();
+        sysdef = init.create_random(N=200, box=data.boxdim(L=10), seed=7);
+        snap2 = sysdef.take_snapshot();
+        if comm.get_rank() == 0:
+            numpy.testing.assert_allclose(snap.particles.position, snap2.particles.position);
+
+    def test_too_dense(self):
+        # far above the jamming density of random sequential addition
+        with self.assertRaises(RuntimeError):
+            init.create_random(N=1000, box=data.boxdim(L=8), diameter=1.0, max_sweeps=20);
+
+    def tearDown(self):
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
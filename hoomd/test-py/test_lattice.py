@@ -164,5 +164,53 @@ class lattice_unitcell_test (unittest.TestCase):
     def tearDown(self):
         context.initialize();
 
+# the lattice is generated on every rank in MPI runs, test it against the serial replication of the unit cell
+class lattice_replicate_test (unittest.TestCase):
+    def check_replicate(self, uc, n):
+        ref = uc.get_snapshot();
+        if comm.get_rank() == 0:
+            if uc.dimensions == 2:
+                ref.replicate(n[0], n[1], 1);
+            else:
+                ref.replicate(n[0], n[1], n[2]);
+
+        sysdef = init.create_lattice(unitcell=uc, n=n);
+        snap = sysdef.take_snapshot();
+        if comm.get_rank() == 0:
+            self.assertEqual(snap.particles.N, ref.particles.N);
+            numpy.testing.assert_allclose(snap.box.Lx, ref.box.Lx, rtol=1e-5);
+            numpy.testing.assert_allclose(snap.box.Ly, ref.box.Ly, rtol=1e-5);
+            numpy.testing.assert_allclose(snap.box.Lz, ref.box.Lz, rtol=1e-5);
+            numpy.testing.assert_allclose(snap.box.xy, ref.box.xy, atol=1e-5);
+
+            # the particle with a given tag is the same lattice site as in the serial replication
+            numpy.testing.assert_array_equal(snap.particles.typeid, ref.particles.typeid);
+            numpy.testing.assert_allclose(snap.particles.diameter, ref.particles.diameter);
+            numpy.testing.assert_allclose(snap.particles.mass, ref.particles.mass);
+            for i in range(snap.particles.N):
+                d = snap.box.min_image(tuple(snap.particles.position[i] - ref.particles.position[i]));
+                numpy.testing.assert_allclose(d, (0,0,0), atol=1e-4);
+
+    def test_fcc(self):
+        self.check_replicate(lattice.fcc(a=1.6), n=[4,5,6]);
+
+    def test_hex(self):
+        self.check_replicate(lattice.hex(a=1.2), n=[7,5]);
+
+    def test_triclinic(self):
+        uc = hoomd.lattice.unitcell(N = 3,
+                            a1 = [1.5, 0, 0],
+                            a2 = [0.5, 1.5, 0],
+                            a3 = [0.2, 0.3, 1.5],
+                            dimensions = 3,
+                            position = [[0, 0, 0], [0.5, 0.5, 0], [0.3, 0.2, 0.6]],
+                            type_name = ['A', 'A', 'B'],
+                            diameter = [1.0, 1.0, 0.5],
+                            mass = [1.0, 1.0, 2.0]);
+        self.check_replicate(uc, n=[6,5,4]);
+
+    def tearDown(self):
+        context.initialize();
+
 if __name__ == '__main__':
     unittest.main(argv = ['test.py', '-v'])
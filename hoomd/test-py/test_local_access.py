@@ -0,0 +1,76 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+from hoomd import *
+import hoomd;
+context.initialize()
+import unittest
+import numpy
+
+# unit tests for data.particle_data.local_access
+class local_access_tests (unittest.TestCase):
+    def setUp(self):
+        self.s = init.create_lattice(lattice.sc(a=1.5), n=[4,4,4]);
+
+    # test that the views reference the particle data
+    def test_read(self):
+        with self.s.particles.local_access(readonly=True) as data:
+            pos = numpy.array(data.position)
+            tag = numpy.array(data.tag)
+            rtag = numpy.array(data.rtag)
+            self.assertEqual(data.position.shape[1], 3)
+            self.assertEqual(data.velocity.shape, data.position.shape)
+            self.assertEqual(data.net_force.shape, data.position.shape)
+
+        self.assertEqual(pos.shape[0], len(tag))
+        for i in range(len(tag)):
+            self.assertEqual(rtag[tag[i]], i)
+            p = self.s.particles.get(int(tag[i])).position
+            for k in range(3):
+                self.assertAlmostEqual(pos[i,k], p[k], 5)
+
+    # test that writes modify the particle data
+    def test_write(self):
+        with self.s.particles.local_access() as data:
+            data.velocity[:] = [1.0, 2.0, 3.0]
+
+        for p in self.s.particles:
+            self.assertAlmostEqual(p.velocity[0], 1.0, 5)
+            self.assertAlmostEqual(p.velocity[1], 2.0, 5)
+            self.assertAlmostEqual(p.velocity[2], 3.0, 5)
+
+    # test that read only views cannot be modified
+    def test_readonly(self):
+        with self.s.particles.local_access(readonly=True) as data:
+            self.assertRaises(ValueError, data.position.__setitem__, 0, 1.0)
+
+    # test that the arrays cannot be acquired outside of the context
+    def test_scope(self):
+        access = self.s.particles.local_access()
+        self.assertRaises(RuntimeError, getattr, access, 'position')
+
+        with access as data:
+            data.position
+        self.assertRaises(RuntimeError, getattr, access, 'position')
+
+        # the simulation can run again after the context is closed
+        run(1)
+
+    # test device access
+    def test_device(self):
+        if not hoomd.context.exec_conf.isCUDAEnabled():
+            self.assertRaises(RuntimeError, self.s.particles.local_access, device=True)
+            return
+
+        with self.s.particles.local_access(device=True, readonly=True) as data:
+            interface = data.position.__cuda_array_interface__
+            self.assertEqual(interface['shape'][1], 3)
+            self.assertTrue(interface['data'][1])
+            self.assertEqual(data.rtag.__cuda_array_interface__['typestr'], '<u4')
+
+    def tearDown(self):
+        del self.s
+        context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
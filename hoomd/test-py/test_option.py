@@ -6,6 +6,7 @@ import hoomd;
 context.initialize()
 import unittest
 import os
+import tempfile
 
 # unit tests for options
 class option_tests (unittest.TestCase):
@@ -22,6 +23,107 @@ class option_tests (unittest.TestCase):
 
         self.assertRaises(RuntimeError, option.set_notice_level, 'foo');
 
+    # tests that the CUDA-aware MPI command line option is parsed
+    def test_cuda_aware_mpi(self):
+        saved_options = hoomd.context.options;
+        hoomd.context.options = hoomd.option.options();
+        hoomd.option._parse_command_line("--cuda-aware-mpi=off");
+        self.assertEqual(hoomd.context.options.cuda_aware_mpi, 'off');
+        hoomd.option._parse_command_line("--cuda-aware-mpi=on");
+        self.assertEqual(hoomd.context.options.cuda_aware_mpi, 'on');
+        hoomd.context.options = saved_options;
+
+    # tests that the persistent MPI request option is parsed
+    def test_persistent_mpi(self):
+        saved_options = hoomd.context.options;
+        hoomd.context.options = hoomd.option.options();
+        hoomd.option._parse_command_line("--persistent-mpi=off");
+        self.assertEqual(hoomd.context.options.persistent_mpi, 'off');
+        hoomd.option._parse_command_line("--persistent-mpi=on");
+        self.assertEqual(hoomd.context.options.persistent_mpi, 'on');
+        hoomd.context.options = saved_options;
+
+    # tests that the ghost compression option is parsed
+    def test_compress_ghosts(self):
+        saved_options = hoomd.context.options;
+        hoomd.context.options = hoomd.option.options();
+        hoomd.option._parse_command_line("--compress-ghosts=on");
+        self.assertEqual(hoomd.context.options.compress_ghosts, 'on');
+        hoomd.option._parse_command_line("--compress-ghosts=off");
+        self.assertEqual(hoomd.context.options.compress_ghosts, 'off');
+        hoomd.context.options = saved_options;
+
+    # tests that the ghost sorting option is parsed
+    def test_sort_ghosts(self):
+        saved_options = hoomd.context.options;
+        hoomd.context.options = hoomd.option.options();
+        hoomd.option._parse_command_line("--sort-ghosts=on");
+        self.assertEqual(hoomd.context.options.sort_ghosts, 'on');
+        hoomd.option._parse_command_line("--sort-ghosts=off");
+        self.assertEqual(hoomd.context.options.sort_ghosts, 'off');
+        hoomd.context.options = saved_options;
+
+    # tests that the node shared memory option is parsed
+    def test_shared_mem_ghosts(self):
+        saved_options = hoomd.context.options;
+        hoomd.context.options = hoomd.option.options();
+        hoomd.option._parse_command_line("--shared-mem-ghosts=on");
+        self.assertEqual(hoomd.context.options.shared_mem_ghosts, 'on');
+        hoomd.context.options = saved_options;
+
+    # tests that buffered messages are written to the message file
+    def test_msg_async(self):
+        if comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.txt');
+            self.tmp_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+
+        option.set_msg_file(self.tmp_file);
+        option.set_msg_async(True, buffer_size=64);
+        self.assertTrue(hoomd.context.options.msg_async);
+        for i in range(10):
+            hoomd.context.msg.notice(1, "async notice {}\n".format(i));
+        option.set_msg_async(False);
+        option.set_msg_file(None);
+        self.assertFalse(hoomd.context.options.msg_async);
+
+        if comm.get_rank() == 0:
+            with open(self.tmp_file) as f:
+                lines = f.readlines();
+            self.assertEqual(lines, ["async notice {}\n".format(i) for i in range(10)]);
+            os.remove(self.tmp_file);
+
+        self.assertRaises(RuntimeError, option.set_msg_async, True, 0);
+
+    # tests that the autotuner cache is written and read back
+    def test_autotuner_cache(self):
+        if comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.txt');
+            self.tmp_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+
+        init.create_lattice(unitcell=lattice.sq(a=2.0), n=[4,4]);
+        option.set_autotuner_params(cache=self.tmp_file);
+        self.assertEqual(hoomd.context.options.autotuner_cache, self.tmp_file);
+        run(10);
+        if comm.get_rank() == 0:
+            self.assertTrue(os.path.exists(self.tmp_file));
+
+        # a new context reads the cache back
+        context.initialize();
+        init.create_lattice(unitcell=lattice.sq(a=2.0), n=[4,4]);
+        option.set_autotuner_params(cache=self.tmp_file);
+        run(10);
+
+        option.set_autotuner_params();
+        self.assertEqual(hoomd.context.options.autotuner_cache, None);
+
+        if comm.get_rank() == 0:
+            os.remove(self.tmp_file);
+        context.initialize();
+
     def tearDown(self):
         pass;
 
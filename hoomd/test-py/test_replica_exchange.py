@@ -0,0 +1,68 @@
+# -*- coding: iso-8859-1 -*-
+
+from hoomd import *
+from hoomd import md
+import hoomd;
+
+if hoomd._hoomd.is_MPI_available():
+    # initialize with every rank == one partition
+    context.initialize('--nrank=1')
+    n_partitions = hoomd._hoomd.ExecutionConfiguration.getNRanksGlobal()
+else:
+    context.initialize('')
+    n_partitions = 1
+
+import unittest
+import os
+
+# tests update.replica_exchange
+class update_replica_exchange_tests (unittest.TestCase):
+    def setUp(self):
+        self.system = init.create_lattice(lattice.sc(a=1.3), n=5)
+        self.nl = md.nlist.cell()
+        lj = md.pair.lj(r_cut=2.5, nlist=self.nl)
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+        self.kT = [1.0 + 0.1*i for i in range(n_partitions)]
+
+    # test the temperature of the partition follows the rung
+    def test_swaps(self):
+        if not hoomd._hoomd.is_MPI_available():
+            return
+
+        rx = update.replica_exchange(kT=self.kT, seed=7, period=10)
+        md.integrate.mode_standard(dt=0.005)
+        md.integrate.nvt(group=group.all(), kT=rx.kT, tau=0.5)
+        log = analyze.log(filename=None, quantities=['replica_exchange_rung', 'replica_exchange_temperature',
+                                                     'replica_exchange_acceptance'], period=10)
+        run(100)
+
+        rung = rx.get_rung()
+        self.assertTrue(0 <= rung < n_partitions)
+        self.assertEqual(log.query('replica_exchange_rung'), rung)
+        self.assertAlmostEqual(log.query('replica_exchange_temperature'), self.kT[rung], 5)
+        self.assertAlmostEqual(rx.kT.cpp_variant.getValue(0), self.kT[rung], 5)
+        acc = log.query('replica_exchange_acceptance')
+        self.assertTrue(0.0 <= acc <= 1.0)
+
+    # test that the temperatures are checked
+    # test that the partition runs at the lowest temperature without MPI
+    def test_no_mpi(self):
+        if hoomd._hoomd.is_MPI_available():
+            return
+
+        rx = update.replica_exchange(kT=[1.5, 2.0], seed=7, period=10)
+        self.assertEqual(rx.get_rung(), 0)
+        self.assertAlmostEqual(rx.kT.cpp_variant.getValue(0), 1.5, 5)
+
+    def test_bad_temperatures(self):
+        if not hoomd._hoomd.is_MPI_available():
+            return
+        self.assertRaises(RuntimeError, update.replica_exchange, kT=self.kT + [10.0], seed=7, period=10)
+        self.assertRaises(RuntimeError, update.replica_exchange, kT=[-1.0]*n_partitions, seed=7, period=10)
+
+    def tearDown(self):
+        del self.system, self.nl
+        context.initialize()
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
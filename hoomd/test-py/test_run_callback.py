@@ -4,6 +4,9 @@
 import hoomd
 hoomd.context.initialize()
 import unittest
+import tempfile
+import json
+import os
 
 class analyze_callback_tests(unittest.TestCase):
 
@@ -40,6 +43,22 @@ class analyze_callback_tests(unittest.TestCase):
         hoomd.run(10, callback=cb, callback_period=1);
         self.assertEqual(self.a, 3);
 
+    def test_trace(self):
+        if hoomd.comm.get_rank() == 0:
+            tmp = tempfile.mkstemp(suffix='.json');
+            self.tmp_file = tmp[1];
+        else:
+            self.tmp_file = "invalid";
+
+        hoomd.run(10, trace=self.tmp_file);
+
+        if hoomd.comm.get_rank() == 0 and hoomd.comm.get_num_ranks() == 1:
+            with open(self.tmp_file) as f:
+                trace = json.load(f);
+            events = [e for e in trace['traceEvents'] if e['ph'] == 'X'];
+            self.assertGreater(len(events), 0);
+            os.remove(self.tmp_file);
+
     def tearDown(self):
         hoomd.context.initialize();
 
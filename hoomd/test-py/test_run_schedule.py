@@ -0,0 +1,93 @@
+# -*- coding: iso-8859-1 -*-
+# Maintainer: joaander
+
+import hoomd
+hoomd.context.initialize()
+import unittest
+
+# tests the steps on which run() executes analyzers and callbacks, which are only checked on scheduled steps
+class run_schedule_tests(unittest.TestCase):
+
+    def setUp(self):
+        hoomd.init.create_lattice(unitcell=hoomd.lattice.sq(a=2.0),
+                                  n=[1,2]);
+        self.steps = [];
+        self.steps_2 = [];
+
+    def test_fixed_periods(self):
+        hoomd.analyze.callback(callback=lambda step: self.steps.append(step), period=3);
+        hoomd.analyze.callback(callback=lambda step: self.steps_2.append(step), period=5, phase=2);
+        hoomd.run(20);
+        self.assertEqual(self.steps, [0, 3, 6, 9, 12, 15, 18]);
+        self.assertEqual(self.steps_2, [2, 7, 12, 17]);
+
+    def test_variable_period(self):
+        hoomd.analyze.callback(callback=lambda step: self.steps.append(step), period=lambda n: n**2);
+        hoomd.analyze.callback(callback=lambda step: self.steps_2.append(step), period=7);
+        hoomd.run(30);
+        self.assertEqual(self.steps, [0, 1, 4, 9, 16, 25]);
+        self.assertEqual(self.steps_2, [0, 7, 14, 21, 28]);
+
+    def test_set_period_from_analyzer(self):
+        # the analyzer changes its own period after the step that was already scheduled
+        def cb(step):
+            self.steps.append(step);
+            if step == 6:
+                analyzer.set_period(5);
+
+        analyzer = hoomd.analyze.callback(callback=cb, period=2);
+        hoomd.run(20);
+        self.assertEqual(self.steps, [0, 2, 4, 6, 10, 15]);
+
+    def test_set_period_from_run_callback(self):
+        # the run callback moves the next execution of the analyzer before the one that was scheduled
+        analyzer = hoomd.analyze.callback(callback=lambda step: self.steps.append(step), period=10);
+
+        def cb(step):
+            self.steps_2.append(step);
+            if step == 4:
+                analyzer.set_period(3);
+
+        hoomd.run(20, callback=cb, callback_period=4);
+        self.assertEqual(self.steps, [0, 6, 9, 12, 15, 18]);
+        self.assertEqual(self.steps_2, [0, 4, 8, 12, 16]);
+
+    def test_callback_period_boundaries(self):
+        hoomd.analyze.callback(callback=lambda step: self.steps.append(step), period=1);
+        hoomd.run(5);
+
+        # a run that starts between multiples of the callback period
+        hoomd.run(20, callback=lambda step: self.steps_2.append(step), callback_period=7);
+        self.assertEqual(self.steps_2, [7, 14, 21]);
+        self.assertEqual(self.steps, list(range(25)));
+
+        # a callback period longer than the run and a period of one
+        self.steps_2 = [];
+        hoomd.run(3, callback=lambda step: self.steps_2.append(step), callback_period=100);
+        self.assertEqual(self.steps_2, []);
+        hoomd.run(3, callback=lambda step: self.steps_2.append(step), callback_period=1);
+        self.assertEqual(self.steps_2, [28, 29, 30]);
+        self.assertEqual(hoomd.get_step(), 31);
+
+    def test_limit_multiple(self):
+        analyzer = hoomd.analyze.callback(callback=lambda step: self.steps.append(step), period=1);
+        hoomd.run(5);
+
+        # the time limit is exceeded immediately, but the run only ends on the next multiple of limit_multiple
+        hoomd.run(100, limit_hours=1e-12, limit_multiple=7);
+        self.assertEqual(hoomd.get_step(), 7);
+        self.assertEqual(self.steps, list(range(7)));
+
+        # the limit is checked on its multiple when no analyzer is scheduled before the end of the run
+        analyzer.disable();
+        hoomd.analyze.callback(callback=lambda step: self.steps_2.append(step), period=1000, phase=-1);
+        hoomd.run(100, limit_hours=1e-12, limit_multiple=10);
+        self.assertEqual(hoomd.get_step(), 10);
+        self.assertEqual(self.steps_2, [7]);
+        self.assertEqual(self.steps, list(range(7)));
+
+    def tearDown(self):
+        hoomd.context.initialize();
+
+if __name__ == '__main__':
+    unittest.main(argv = ['test.py', '-v'])
@@ -132,6 +132,30 @@ class init_take_restore_snapshot (unittest.TestCase):
         self.assertEqual(len(snap.angles.types), 0);
         self.assertEqual(len(snap.dihedrals.types), 0);
 
+    # test restoring a snapshot of the same system, which overwrites the particle properties in place
+    def test_restore_in_place(self):
+        snapshot = self.s.take_snapshot(all=True)
+        pos = numpy.array(snapshot.particles.position)
+        vel = numpy.array(snapshot.particles.velocity)
+        l_bonds = len(self.s.bonds)
+
+        p = self.s.particles[3]
+        p.position = (0.25, 0.5, 0.75)
+        p.velocity = (1.0, 2.0, 3.0)
+        self.s.restore_snapshot(snapshot)
+
+        p = self.s.particles[3]
+        numpy.testing.assert_allclose(p.position, pos[3], rtol=1e-6)
+        numpy.testing.assert_allclose(p.velocity, vel[3], rtol=1e-6)
+        self.assertEqual(len(self.s.bonds), l_bonds)
+
+        # a changed particle type falls back to the full re-initialization
+        t = self.s.particles[3].type
+        self.s.particles[3].type = 'B' if t == 'A' else 'A'
+        self.s.restore_snapshot(snapshot)
+        self.assertEqual(self.s.particles[3].type, t)
+        numpy.testing.assert_allclose(self.s.particles[3].position, pos[3], rtol=1e-6)
+
     def tearDown(self):
         del self.s
         context.initialize();
@@ -11,6 +11,7 @@ if _hoomd.is_TBB_available():
 
     import unittest
     import os
+    import numpy
 
     # unit tests for options
     class option_tests (unittest.TestCase):
@@ -23,8 +24,35 @@ if _hoomd.is_TBB_available():
             option.set_num_threads(2)
             self.assertEqual(hoomd.context.ExecutionContext().num_threads, 2);
 
+        # tests the NUMA options
+        def test_numa(self):
+            saved_options = hoomd.context.options;
+            hoomd.context.options = hoomd.option.options();
+            hoomd.option._parse_command_line("--thread-affinity=scatter --first-touch=on --huge-pages=on");
+            self.assertEqual(hoomd.context.options.thread_affinity, 'scatter');
+            self.assertEqual(hoomd.context.options.first_touch, 'on');
+            self.assertEqual(hoomd.context.options.huge_pages, 'on');
+            hoomd.context.options = saved_options;
+
+            hoomd.context.exec_conf.setThreadAffinity('compact');
+            hoomd.context.exec_conf.setParallelFirstTouch(True);
+            hoomd.context.exec_conf.setHugePages(True);
+
+            # large arrays are cleared in parallel
+            system = init.create_lattice(lattice.sc(a=1.5), n=60);
+            snap = system.take_snapshot();
+            if comm.get_rank() == 0:
+                self.assertEqual(snap.particles.N, 60**3);
+                self.assertEqual(numpy.count_nonzero(snap.particles.velocity), 0);
+
+            hoomd.context.exec_conf.setThreadAffinity('none');
+            hoomd.context.exec_conf.setParallelFirstTouch(False);
+            hoomd.context.exec_conf.setHugePages(False);
+            with self.assertRaises(RuntimeError):
+                hoomd.context.exec_conf.setThreadAffinity('foo');
+
         def tearDown(self):
-            pass;
+            context.initialize("--nthreads=4");
 
     if __name__ == '__main__':
         unittest.main(argv = ['test.py', '-v'])
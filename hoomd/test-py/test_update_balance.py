@@ -2,6 +2,7 @@
 # Maintainer: mphoward
 
 import hoomd
+from hoomd import md
 hoomd.context.initialize()
 import unittest
 
@@ -10,7 +11,7 @@ class load_balance_tests (unittest.TestCase):
     def setUp(self):
         snap = hoomd.data.make_snapshot(N=100, box=hoomd.data.boxdim(L=10), particle_types=['A'])
         hoomd.comm.decomposition(nx=1,ny=1,nz=2)
-        hoomd.init.read_snapshot(snap)
+        self.s = hoomd.init.read_snapshot(snap)
 
     ## Test basic constructor succeeds
     def test_basic(self):
@@ -22,6 +23,46 @@ class load_balance_tests (unittest.TestCase):
         if hoomd.context.current.decomposition is not None:
             lb.set_params(x=True, y=True, z=True, tolerance=0.95, maxiter=1)
 
+    ## Test weighting the particles by their neighbor count
+    def test_cost(self):
+        snap = self.s.take_snapshot()
+        if hoomd.comm.get_rank() == 0:
+            for i in range(snap.particles.N):
+                snap.particles.position[i] = (i % 5 * 2 - 4.5, i // 5 % 5 * 2 - 4.5, i // 25 * 2 - 4.5)
+        self.s.restore_snapshot(snap)
+
+        nl = md.nlist.cell()
+        lj = md.pair.lj(r_cut=2.5, nlist=nl)
+        lj.pair_coeff.set('A', 'A', epsilon=1.0, sigma=1.0)
+        md.integrate.mode_standard(dt=0.005)
+        md.integrate.nve(group=hoomd.group.all())
+
+        lb = hoomd.update.balance(tolerance=0.95, period=2, cost=[nl])
+        hoomd.run(5)
+        if hoomd.context.current.decomposition is not None:
+            lb.set_params(cost=[])
+            hoomd.run(5)
+
+    ## Test deciding on balancing from the measured load imbalance
+    def test_timing(self):
+        md.integrate.mode_standard(dt=0.005)
+        md.integrate.nve(group=hoomd.group.all())
+
+        imb = hoomd.compute.load_imbalance()
+        log = hoomd.analyze.log(filename=None, quantities=['load_imbalance', 'load_busy_max', 'load_wait_exchange_avg',
+                                                           'load_wait_collective_min'], period=2)
+        lb = hoomd.update.balance(tolerance=0.95, period=2, timing=imb)
+        hoomd.run(6)
+
+        self.assertGreaterEqual(imb.get_imbalance(), 1.0)
+        if hoomd.context.current.decomposition is not None:
+            self.assertAlmostEqual(log.query('load_imbalance'), imb.get_imbalance(), places=5)
+            self.assertGreater(log.query('load_busy_max'), 0.0)
+            self.assertGreaterEqual(log.query('load_wait_exchange_avg'), 0.0)
+            self.assertGreaterEqual(log.query('load_wait_collective_min'), 0.0)
+            lb.set_params(timing=False)
+            hoomd.run(2)
+
     def tearDown(self):
         hoomd.context.initialize()
 
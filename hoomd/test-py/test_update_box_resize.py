@@ -6,6 +6,7 @@ import hoomd;
 context.initialize()
 import unittest
 import os
+import numpy
 
 # tests for update.box_resize
 class update_box_resize_tests (unittest.TestCase):
@@ -51,6 +52,32 @@ class update_box_resize_tests (unittest.TestCase):
                           yz= variant.linear_interp([(0,0), (1e5, .3)]), period=10);
         run(100);
 
+    # steady shear with sliding brick boundary conditions
+    def test_lees_edwards(self):
+        update.box_resize(xy = variant.linear_interp([(0,0.4), (100, 0.6)]), lees_edwards=True);
+        run(1);
+        snap0 = context.current.system.take_snapshot();
+        run(100);
+        snap1 = context.current.system.take_snapshot();
+
+        # the tilt flipped to the equivalent reduced value
+        self.assertAlmostEqual(snap1.box.xy, 0.6 - snap1.box.Lx/snap1.box.Ly, 5);
+
+        # unwrapped positions follow the affine deformation across the flip
+        if comm.get_rank() == 0:
+            def unwrap(snap):
+                b = snap.box;
+                a1 = numpy.array([b.Lx, 0, 0]);
+                a2 = numpy.array([b.xy*b.Ly, b.Ly, 0]);
+                a3 = numpy.array([b.xz*b.Lz, b.yz*b.Lz, b.Lz]);
+                img = snap.particles.image;
+                return snap.particles.position + numpy.outer(img[:,0], a1) + numpy.outer(img[:,1], a2) + numpy.outer(img[:,2], a3);
+
+            u0 = unwrap(snap0);
+            u1 = unwrap(snap1);
+            u0[:,0] += (0.6 - snap0.box.xy)*u0[:,1];
+            numpy.testing.assert_allclose(u1, u0, atol=1e-3);
+
     def tearDown(self):
         context.initialize();
 
@@ -6,17 +6,42 @@ import hoomd;
 context.initialize()
 import unittest
 import os
+import numpy
 
 # tests for update.sorter
 class update_sorter_tests (unittest.TestCase):
     def setUp(self):
         print
-        init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
+        self.s = init.create_lattice(lattice.sc(a=2.1878096788957757),n=[5,5,4]); #target a packing fraction of 0.05
 
     # test set_params
     def test_set_params(self):
 
         context.current.sorter.set_params(grid=20);
+        context.current.sorter.set_params(locality_threshold=1.5);
+        context.current.sorter.set_params(locality_threshold=0);
+        self.assertRaises(ValueError, context.current.sorter.set_params, locality_threshold=0.5);
+
+    # test that a sort triggered by the locality restores the order of the particles
+    def test_locality(self):
+        snap = self.s.take_snapshot()
+        if comm.get_rank() == 0:
+            numpy.random.seed(10)
+            numpy.random.shuffle(snap.particles.position)
+        self.s.restore_snapshot(snap)
+
+        sorter = context.current.sorter
+        sorter.set_params(locality_threshold=1.5)
+        sorter.set_period(period=1)
+        scrambled = sorter.get_locality()
+
+        run(1)
+        sorted_locality = sorter.get_locality()
+        self.assertLess(sorted_locality, 0.5*scrambled)
+
+        # the particles do not move, so later checks skip the sort
+        run(5)
+        self.assertAlmostEqual(sorter.get_locality(), sorted_locality, 5)
 
     def tearDown(self):
         context.initialize();
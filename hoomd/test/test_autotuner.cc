@@ -0,0 +1,223 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <algorithm>
+#include <functional>
+#include <memory>
+
+#include "hoomd/Autotuner.h"
+
+using namespace std;
+
+/*! \file test_autotuner.cc
+    \brief Unit tests for the search of Autotuner
+    \ingroup unit_tests
+*/
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+//! Autotuner that takes the kernel times from a cost function instead of CUDA events
+class AutotunerCost : public Autotuner
+    {
+    public:
+        //! Constructor for a one dimensional parameter space
+        AutotunerCost(const std::vector<unsigned int>& parameters,
+                      unsigned int nsamples,
+                      unsigned int period,
+                      std::shared_ptr<const ExecutionConfiguration> exec_conf)
+            : Autotuner(parameters, nsamples, period, "test", exec_conf), m_n_measured(0)
+            {
+            }
+
+        //! Constructor for a multi-dimensional parameter space
+        AutotunerCost(const std::vector< std::vector<unsigned int> >& dim_values,
+                      const std::vector<unsigned int>& dim_weights,
+                      unsigned int nsamples,
+                      unsigned int period,
+                      std::shared_ptr<const ExecutionConfiguration> exec_conf)
+            : Autotuner(dim_values, dim_weights, nsamples, period, "test", exec_conf), m_n_measured(0)
+            {
+            }
+
+        //! Set the cost function
+        void setCost(std::function<float (unsigned int)> cost)
+            {
+            m_cost = cost;
+            }
+
+        //! Run one timed call
+        void call()
+            {
+            begin();
+            end();
+            }
+
+        //! Run timed calls until the initial scan is complete
+        void runInitialScan()
+            {
+            // start without the optimal parameters stored by the previous Autotuners of the same name
+            clearCache();
+            for (unsigned int i = 0; i < 100000 && !isComplete(); i++)
+                call();
+            UP_ASSERT(isComplete());
+            }
+
+        //! Get the number of parameters sampled in the initial scan
+        unsigned int getNumSampled() const
+            {
+            return std::count(m_sampled.begin(), m_sampled.end(), true);
+            }
+
+        //! Get the number of parameters
+        unsigned int getNumParameters() const
+            {
+            return m_parameters.size();
+            }
+
+        //! Get the number of measured kernel launches
+        unsigned int getNumMeasured() const
+            {
+            return m_n_measured;
+            }
+
+    protected:
+        //! Return the cost of the current parameter as its time
+        virtual float measureSample()
+            {
+            m_n_measured++;
+            return m_cost(getParam());
+            }
+
+    private:
+        std::function<float (unsigned int)> m_cost;  //!< Cost function of the parameter
+        unsigned int m_n_measured;                   //!< Number of measured kernel launches
+    };
+
+//! Values of the block size dimension
+static std::vector<unsigned int> block_sizes()
+    {
+    std::vector<unsigned int> v;
+    for (unsigned int b = 32; b <= 1024; b += 32)
+        v.push_back(b);
+    return v;
+    }
+
+//! Values of the threads per particle dimension
+static std::vector<unsigned int> threads_per_particle()
+    {
+    std::vector<unsigned int> v;
+    for (unsigned int t = 1; t <= 32; t *= 2)
+        v.push_back(t);
+    return v;
+    }
+
+//! Separable cost with a minimum at block size 256 and 4 threads per particle
+static float separable_cost(unsigned int param)
+    {
+    float block_size = float(param / 10000);
+    float tpp = float(param % 10000);
+    float db = (block_size - 256.0f)/32.0f;
+    float dt = std::log2(tpp) - 2.0f;
+    return 1.0f + db*db + dt*dt;
+    }
+
+//! Create a multi-dimensional Autotuner over block sizes and threads per particle
+static std::shared_ptr<AutotunerCost> make_2d_tuner(std::shared_ptr<const ExecutionConfiguration> exec_conf,
+                                                    unsigned int period)
+    {
+    std::vector< std::vector<unsigned int> > dim_values;
+    dim_values.push_back(block_sizes());
+    dim_values.push_back(threads_per_particle());
+    std::vector<unsigned int> dim_weights;
+    dim_weights.push_back(10000);
+    dim_weights.push_back(1);
+    return std::shared_ptr<AutotunerCost>(new AutotunerCost(dim_values, dim_weights, 3, period, exec_conf));
+    }
+
+//! The coordinate descent finds the optimum of the exhaustive search with fewer samples
+UP_TEST( autotuner_coordinate_descent )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    std::shared_ptr<AutotunerCost> coordinate = make_2d_tuner(exec_conf, 100000);
+    coordinate->setCost(separable_cost);
+    coordinate->runInitialScan();
+
+    std::shared_ptr<AutotunerCost> exhaustive = make_2d_tuner(exec_conf, 100000);
+    exhaustive->setSearchMode(Autotuner::search_exhaustive);
+    exhaustive->setCost(separable_cost);
+    exhaustive->runInitialScan();
+
+    UP_ASSERT_EQUAL(exhaustive->getNumSampled(), exhaustive->getNumParameters());
+    UP_ASSERT_EQUAL(exhaustive->getParam(), (unsigned int)(256*10000 + 4));
+    UP_ASSERT_EQUAL(coordinate->getParam(), exhaustive->getParam());
+
+    // the lines along both dimensions are sampled, but not the whole grid
+    UP_ASSERT(coordinate->getNumSampled() >= block_sizes().size() + threads_per_particle().size() - 1);
+    UP_ASSERT(coordinate->getNumSampled() < coordinate->getNumParameters());
+
+    // the optimum is returned once the scan is complete
+    for (unsigned int i = 0; i < 10; i++)
+        {
+        coordinate->call();
+        UP_ASSERT_EQUAL(coordinate->getParam(), (unsigned int)(256*10000 + 4));
+        }
+    }
+
+//! The periodic scans follow an optimum that moves along a line through the previous optimum
+UP_TEST( autotuner_periodic_scan )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    std::shared_ptr<AutotunerCost> tuner = make_2d_tuner(exec_conf, 10);
+    tuner->setCost(separable_cost);
+    tuner->runInitialScan();
+    UP_ASSERT_EQUAL(tuner->getParam(), (unsigned int)(256*10000 + 4));
+
+    // move the optimum to a block size of 512
+    tuner->setCost([](unsigned int param)->float
+        {
+        float block_size = float(param / 10000);
+        float tpp = float(param % 10000);
+        float db = (block_size - 512.0f)/32.0f;
+        float dt = std::log2(tpp) - 2.0f;
+        return 1.0f + db*db + dt*dt;
+        });
+
+    for (unsigned int i = 0; i < 2000; i++)
+        tuner->call();
+
+    tuner->setEnabled(false);
+    UP_ASSERT_EQUAL(tuner->getParam(), (unsigned int)(512*10000 + 4));
+    }
+
+//! Sampling stops early for parameters that are clearly slower than the best one
+UP_TEST( autotuner_early_termination )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+
+    // the first parameter is the fastest, all others are 10 times slower
+    std::vector<unsigned int> parameters = block_sizes();
+    auto cost = [](unsigned int param)->float { return (param == 32) ? 1.0f : 10.0f; };
+
+    AutotunerCost all(parameters, 5, 100000, exec_conf);
+    all.setEarlyTermination(0.0f);
+    all.setCost(cost);
+    all.runInitialScan();
+    UP_ASSERT_EQUAL(all.getNumMeasured(), (unsigned int)(5*parameters.size()));
+    UP_ASSERT_EQUAL(all.getParam(), 32);
+
+    // with early termination, the slow parameters are only measured once
+    AutotunerCost early(parameters, 5, 100000, exec_conf);
+    early.setCost(cost);
+    early.runInitialScan();
+    UP_ASSERT_EQUAL(early.getNumMeasured(), (unsigned int)(5 + parameters.size() - 1));
+    UP_ASSERT_EQUAL(early.getParam(), 32);
+    }
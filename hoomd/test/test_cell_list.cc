@@ -582,3 +582,92 @@ UP_TEST( CellListGPU_large )
     celllist_large_test<CellListGPU>(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::GPU)));
     }
 #endif
+
+#ifdef ENABLE_TBB
+//! Validate that the cell list built on several TBB threads is identical to the serial one
+/*! The parallel counting sort keeps the particles of every cell in index order, so the contents of all arrays must
+    agree exactly.
+*/
+void celllist_threads_test(std::shared_ptr<ExecutionConfiguration> exec_conf)
+    {
+    unsigned int N = 10000;
+    RandomInitializer rand_init(N, Scalar(0.2), Scalar(0.9), "A");
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap;
+    snap = rand_init.getSnapshot();
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<CellList> cl(new CellList(sysdef));
+    cl->setNominalWidth(Scalar(3.0));
+    cl->setRadius(1);
+    cl->setFlagIndex();
+    cl->setComputeTDB(true);
+    cl->setComputeOrientation(true);
+    cl->setComputeIdx(true);
+
+    // build the reference cell list on a single thread
+    exec_conf->setNumThreads(1);
+    cl->compute(0);
+
+    const unsigned int ncell = cl->getCellIndexer().getNumElements();
+    const Index2D cli = cl->getCellListIndexer();
+    std::vector<unsigned int> size_ref(ncell);
+    std::vector<Scalar4> xyzf_ref(cli.getNumElements());
+    std::vector<Scalar4> tdb_ref(cli.getNumElements());
+    std::vector<Scalar4> orientation_ref(cli.getNumElements());
+    std::vector<unsigned int> idx_ref(cli.getNumElements());
+        {
+        ArrayHandle<unsigned int> h_cell_size(cl->getCellSizeArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_xyzf(cl->getXYZFArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_tdb(cl->getTDBArray(), access_location::host, access_mode::read);
+        ArrayHandle<Scalar4> h_orientation(cl->getOrientationArray(), access_location::host, access_mode::read);
+        ArrayHandle<unsigned int> h_idx(cl->getIndexArray(), access_location::host, access_mode::read);
+        for (unsigned int cell = 0; cell < ncell; cell++)
+            {
+            size_ref[cell] = h_cell_size.data[cell];
+            for (unsigned int offset = 0; offset < h_cell_size.data[cell]; offset++)
+                {
+                xyzf_ref[cli(offset, cell)] = h_xyzf.data[cli(offset, cell)];
+                tdb_ref[cli(offset, cell)] = h_tdb.data[cli(offset, cell)];
+                orientation_ref[cli(offset, cell)] = h_orientation.data[cli(offset, cell)];
+                idx_ref[cli(offset, cell)] = h_idx.data[cli(offset, cell)];
+                }
+            }
+        }
+
+    // rebuild it on several threads
+    exec_conf->setNumThreads(4);
+    pdata->notifyParticleSort();
+    cl->compute(1);
+
+    ArrayHandle<unsigned int> h_cell_size(cl->getCellSizeArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_xyzf(cl->getXYZFArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_tdb(cl->getTDBArray(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_orientation(cl->getOrientationArray(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_idx(cl->getIndexArray(), access_location::host, access_mode::read);
+    for (unsigned int cell = 0; cell < ncell; cell++)
+        {
+        CHECK_EQUAL_UINT(h_cell_size.data[cell], size_ref[cell]);
+        for (unsigned int offset = 0; offset < h_cell_size.data[cell]; offset++)
+            {
+            unsigned int k = cli(offset, cell);
+            CHECK_EQUAL_UINT(__scalar_as_int(h_xyzf.data[k].w), __scalar_as_int(xyzf_ref[k].w));
+            MY_ASSERT_EQUAL(h_xyzf.data[k].x, xyzf_ref[k].x);
+            MY_ASSERT_EQUAL(h_xyzf.data[k].y, xyzf_ref[k].y);
+            MY_ASSERT_EQUAL(h_xyzf.data[k].z, xyzf_ref[k].z);
+            MY_ASSERT_EQUAL(h_tdb.data[k].x, tdb_ref[k].x);
+            MY_ASSERT_EQUAL(h_tdb.data[k].y, tdb_ref[k].y);
+            MY_ASSERT_EQUAL(h_tdb.data[k].z, tdb_ref[k].z);
+            MY_ASSERT_EQUAL(h_orientation.data[k].x, orientation_ref[k].x);
+            MY_ASSERT_EQUAL(h_orientation.data[k].w, orientation_ref[k].w);
+            CHECK_EQUAL_UINT(h_idx.data[k], idx_ref[k]);
+            }
+        }
+    }
+
+//! test case for celllist_threads_test
+UP_TEST( CellList_threads )
+    {
+    celllist_threads_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)));
+    }
+#endif
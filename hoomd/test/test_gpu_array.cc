@@ -204,6 +204,70 @@ UP_TEST( GPUArray_transfer_tests )
         }
     }
 
+//! test case for range handles and prefetching
+UP_TEST( GPUArray_range_prefetch_tests )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::GPU));
+    UP_ASSERT(exec_conf->isCUDAEnabled());
+
+    GPUArray<int> gpu_array(100, exec_conf);
+    UP_ASSERT_EQUAL(gpu_array.getDataLocation(), data_location::host);
+
+    // initialize the data on the device
+        {
+        ArrayHandle<int> d_handle(gpu_array, access_location::device, access_mode::overwrite);
+        gpu_fill_test_pattern(d_handle.data, gpu_array.getNumElements());
+        cudaError_t err_sync = cudaGetLastError();
+        exec_conf->handleCUDAError(err_sync, __FILE__, __LINE__);
+        }
+    UP_ASSERT_EQUAL(gpu_array.getDataLocation(), data_location::device);
+
+    // modify a range on the host, the data stays on the device
+        {
+        ArrayHandleRange<int> h_handle(gpu_array, access_location::host, access_mode::readwrite, 10, 20);
+        for (int i = 10; i < 30; i++)
+            {
+            UP_ASSERT_EQUAL(h_handle.data[i], i*i);
+            h_handle.data[i] = -i;
+            }
+        }
+    UP_ASSERT_EQUAL(gpu_array.getDataLocation(), data_location::device);
+
+    // prefetch the array to the host and verify that the range was written back
+    gpu_array.prefetch(access_location::host);
+    UP_ASSERT_EQUAL(gpu_array.getDataLocation(), data_location::hostdevice);
+
+        {
+        ArrayHandle<int> h_handle(gpu_array, access_location::host, access_mode::readwrite);
+        for (int i = 0; i < (int)gpu_array.getNumElements(); i++)
+            {
+            if (i >= 10 && i < 30)
+                UP_ASSERT_EQUAL(h_handle.data[i], -i);
+            else
+                UP_ASSERT_EQUAL(h_handle.data[i], i*i);
+            h_handle.data[i] = i;
+            }
+        }
+    UP_ASSERT_EQUAL(gpu_array.getDataLocation(), data_location::host);
+
+    // prefetch the array to the device and increment it there
+    gpu_array.prefetch(access_location::device);
+        {
+        ArrayHandle<int> d_handle(gpu_array, access_location::device, access_mode::readwrite);
+        gpu_add_one(d_handle.data, gpu_array.getNumElements());
+        cudaError_t err_sync = cudaGetLastError();
+        exec_conf->handleCUDAError(err_sync, __FILE__, __LINE__);
+        }
+
+    // a range in the middle of the array is copied to the host
+        {
+        ArrayHandleRange<int> h_handle(gpu_array, access_location::host, access_mode::read, 50, 10);
+        for (int i = 50; i < 60; i++)
+            UP_ASSERT_EQUAL(h_handle.data[i], i+1);
+        }
+    UP_ASSERT_EQUAL(gpu_array.getDataLocation(), data_location::device);
+    }
+
 //! Tests operations on NULL GPUArrays
 UP_TEST( GPUArray_null_tests )
     {
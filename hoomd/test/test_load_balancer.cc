@@ -28,7 +28,7 @@ HOOMD_UP_MAIN();
 using namespace std;
 
 template<class LB>
-void test_load_balancer_basic(std::shared_ptr<ExecutionConfiguration> exec_conf, const BoxDim& dest_box)
+void test_load_balancer_basic(std::shared_ptr<ExecutionConfiguration> exec_conf, const BoxDim& dest_box, unsigned int nbins=0)
 {
     // this test needs to be run on eight processors
     int size;
@@ -76,6 +76,7 @@ void test_load_balancer_basic(std::shared_ptr<ExecutionConfiguration> exec_conf,
     std::shared_ptr<LoadBalancer> lb(new LB(sysdef,decomposition));
     lb->setCommunicator(comm);
     lb->setMaxIterations(2);
+    lb->setHistogramBins(nbins);
 
     // migrate atoms
     comm->migrateParticles();
@@ -371,6 +372,18 @@ UP_TEST( LoadBalancer_test_basic)
     test_load_balancer_basic<LoadBalancer>(exec_conf, BoxDim(1.0,-.6,.7,.5));
     }
 
+//! Tests basic particle redistribution from load histograms
+UP_TEST( LoadBalancer_test_histogram)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    // cubic box
+    test_load_balancer_basic<LoadBalancer>(exec_conf, BoxDim(2.0), 100);
+    // triclinic box 1
+    test_load_balancer_basic<LoadBalancer>(exec_conf, BoxDim(1.0,.1,.2,.3), 100);
+    // triclinic box 2
+    test_load_balancer_basic<LoadBalancer>(exec_conf, BoxDim(1.0,-.6,.7,.5), 100);
+    }
+
 //! Tests particle redistribution with multiple domains and specific directions
 UP_TEST( LoadBalancer_test_multi)
     {
@@ -408,6 +421,18 @@ UP_TEST( LoadBalancerGPU_test_basic)
     test_load_balancer_basic<LoadBalancerGPU>(exec_conf, BoxDim(1.0,-.6,.7,.5));
     }
 
+//! Tests basic particle redistribution from load histograms on the GPU
+UP_TEST( LoadBalancerGPU_test_histogram)
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::GPU));
+    // cubic box
+    test_load_balancer_basic<LoadBalancerGPU>(exec_conf, BoxDim(2.0), 100);
+    // triclinic box 1
+    test_load_balancer_basic<LoadBalancerGPU>(exec_conf, BoxDim(1.0,.1,.2,.3), 100);
+    // triclinic box 2
+    test_load_balancer_basic<LoadBalancerGPU>(exec_conf, BoxDim(1.0,-.6,.7,.5), 100);
+    }
+
 //! Tests particle redistribution with multiple domains and specific directions on the GPU
 UP_TEST( LoadBalancerGPU_test_multi)
     {
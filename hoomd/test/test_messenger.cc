@@ -123,6 +123,48 @@ UP_TEST( Messenger_prefix )
     UP_ASSERT_EQUAL(strm.str(), string("err: 1\nwarn: 2\n3\nnote(5): 4\n"));
     }
 
+UP_TEST( Messenger_async )
+    {
+    Messenger msg;
+    msg.setErrorPrefix("err");
+    msg.setWarningPrefix("warn");
+    msg.setNoticePrefix("note");
+
+    ostringstream strm;
+    msg.setErrorStream(strm);
+    msg.setWarningStream(strm);
+    msg.setNoticeStream(strm);
+
+    // use a small buffer so that the writes wrap around the ring buffer and wait for the writer thread
+    msg.setAsync(true, 16);
+    UP_ASSERT(msg.getAsync());
+
+    ostringstream expected;
+    msg.warning() << "message" << endl;
+    expected << "warn: message" << endl;
+    for (unsigned int i = 0; i < 100; ++i)
+        {
+        msg.notice(1) << "notice " << i << endl;
+        expected << "notice " << i << endl;
+        }
+    msg.flush();
+    UP_ASSERT_EQUAL(strm.str(), expected.str());
+
+    // errors are written after the buffered messages
+    strm.str("");
+    msg.notice(1) << "1" << endl;
+    msg.warning() << "2" << endl;
+    msg.error() << "3" << endl;
+    UP_ASSERT_EQUAL(strm.str(), string("1\nwarn: 2\nerr: 3\n"));
+
+    // switching back writes synchronously
+    strm.str("");
+    msg.notice(1) << "4" << endl;
+    msg.setAsync(false, 16);
+    msg.notice(1) << "5" << endl;
+    UP_ASSERT_EQUAL(strm.str(), string("4\n5\n"));
+    }
+
 UP_TEST( Messenger_file )
     {
     // scope the messengers so that the file is closed and written
@@ -13,6 +13,7 @@
 
 
 #include <iostream>
+#include <cstring>
 
 #include "hoomd/ParticleData.h"
 #include "hoomd/Initializers.h"
@@ -418,6 +419,35 @@ UP_TEST( BoxDim_triclinic_test )
     UP_ASSERT_EQUAL(img.z, 0);
     }
 
+UP_TEST( BoxDim_lattice_equivalent_test )
+    {
+    BoxDim b(5.0, 4.0, 3.0);
+    b.setTiltFactors(1.4, -2.1, 0.9);
+
+    Scalar tol = Scalar(1e-4);
+
+    // the reduced box has the smallest tilt factors
+    BoxDim r = b.getLatticeEquivalent(0, 0, 0);
+    UP_ASSERT(std::abs(r.getTiltFactorXY()*4.0) <= 2.5 + tol);
+    UP_ASSERT(std::abs(r.getTiltFactorXZ()*3.0) <= 2.5 + tol);
+    UP_ASSERT(std::abs(r.getTiltFactorYZ()*3.0) <= 2.0 + tol);
+
+    // and the same lattice: the lattice vectors of r are integer combinations of those of b
+    for (unsigned int i = 0; i < 3; i++)
+        {
+        Scalar3 f = b.makeFraction(r.getLatticeVector(i)) - b.makeFraction(make_scalar3(0,0,0));
+        UP_ASSERT(std::abs(f.x - rint(f.x)) < tol);
+        UP_ASSERT(std::abs(f.y - rint(f.y)) < tol);
+        UP_ASSERT(std::abs(f.z - rint(f.z)) < tol);
+        }
+
+    // the equivalent box closest to the original tilt factors is the original box
+    BoxDim b2 = r.getLatticeEquivalent(1.4, -2.1, 0.9);
+    MY_CHECK_CLOSE(b2.getTiltFactorXY(), 1.4, tol);
+    MY_CHECK_CLOSE(b2.getTiltFactorXZ(), -2.1, tol);
+    MY_CHECK_CLOSE(b2.getTiltFactorYZ(), 0.9, tol);
+    }
+
 //! Test operation of the particle data class
 UP_TEST( ParticleData_test )
     {
@@ -674,6 +704,173 @@ UP_TEST( Random_test )
     }
     }
 
+//! Tests that the particle data arrays grow in large steps that leave room for the ghost particles
+UP_TEST( pdata_growth_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    BoxDim box(10.0);
+    ParticleData pdata(1, box, 1, exec_conf);
+
+    // a ghost layer larger than the arrays grows them at once
+    pdata.addGhostParticles(100);
+    UP_ASSERT(pdata.getMaxN() >= 101);
+    pdata.removeAllGhostParticles();
+
+    // fill the arrays with local particles until they grow
+    unsigned int max_n = pdata.getMaxN();
+    while (pdata.getN() <= max_n)
+        pdata.addParticle(0);
+
+    // the arrays grew by at least the minimum amount and hold the ghost layer, too
+    UP_ASSERT(pdata.getMaxN() >= max_n + 64);
+    UP_ASSERT(pdata.getMaxN() >= pdata.getN() + 100);
+
+    // so the same ghost layer fits without reallocation
+    max_n = pdata.getMaxN();
+    pdata.addGhostParticles(100);
+    UP_ASSERT_EQUAL(pdata.getMaxN(), max_n);
+    pdata.removeAllGhostParticles();
+
+    // adding single particles does not reallocate every time
+    unsigned int n_reallocate = 0;
+    for (unsigned int i = 0; i < 64; ++i)
+        {
+        unsigned int old_max_n = pdata.getMaxN();
+        pdata.addParticle(0);
+        if (pdata.getMaxN() != old_max_n)
+            n_reallocate++;
+        }
+    UP_ASSERT(n_reallocate <= 1);
+    }
+
+//! Check that a structure-of-arrays copy matches the packed positions
+static void check_positions_soa(ParticleData& pdata, const PositionsSoA& soa)
+    {
+    ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::read);
+    UP_ASSERT_EQUAL(soa.x.size(), pdata.getN() + pdata.getNGhosts());
+    for (unsigned int i = 0; i < pdata.getN() + pdata.getNGhosts(); i++)
+        {
+        MY_ASSERT_EQUAL(soa.x[i], h_pos.data[i].x);
+        MY_ASSERT_EQUAL(soa.y[i], h_pos.data[i].y);
+        MY_ASSERT_EQUAL(soa.z[i], h_pos.data[i].z);
+        UP_ASSERT_EQUAL(soa.type[i], (unsigned int)__scalar_as_int(h_pos.data[i].w));
+        }
+    }
+
+//! Tests that the structure-of-arrays position copy follows the packed positions
+UP_TEST( pdata_positions_soa_test )
+    {
+    std::shared_ptr<ExecutionConfiguration> exec_conf(new ExecutionConfiguration(ExecutionConfiguration::CPU));
+    BoxDim box(10.0);
+    ParticleData pdata(4, box, 2, exec_conf);
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::overwrite);
+        for (unsigned int i = 0; i < pdata.getN(); i++)
+            h_pos.data[i] = make_scalar4(Scalar(i)+Scalar(0.5), -Scalar(i), Scalar(0.25)*Scalar(i),
+                                         __int_as_scalar(i % 2));
+        }
+
+    // the copy is filled on first use
+    check_positions_soa(pdata, pdata.getPositionsSoA(0));
+
+    // positions written directly into the array are picked up in the next time step
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[1].x = Scalar(3.0);
+        }
+    check_positions_soa(pdata, pdata.getPositionsSoA(1));
+
+    // or in the same time step after an explicit invalidation
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[2].y = Scalar(-4.0);
+        }
+    pdata.invalidatePositionsSoA();
+    check_positions_soa(pdata, pdata.getPositionsSoA(1));
+
+    // setPosition() and a particle sort invalidate the copy
+    pdata.setPosition(3, make_scalar3(1.0, 2.0, 3.0));
+    check_positions_soa(pdata, pdata.getPositionsSoA(1));
+
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::readwrite);
+        std::swap(h_pos.data[0], h_pos.data[3]);
+        }
+    pdata.notifyParticleSort();
+    check_positions_soa(pdata, pdata.getPositionsSoA(1));
+
+    // ghost particles are part of the copy and removing them invalidates it
+    pdata.addGhostParticles(2);
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::readwrite);
+        for (unsigned int i = pdata.getN(); i < pdata.getN() + pdata.getNGhosts(); i++)
+            h_pos.data[i] = make_scalar4(-Scalar(i), Scalar(1.5), Scalar(2.5), __int_as_scalar(1));
+        }
+    check_positions_soa(pdata, pdata.getPositionsSoA(2));
+
+    // the local rows can be requested alone and stay valid when only the ghosts are invalidated
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[0].z = Scalar(-1.0);
+        }
+    const PositionsSoA& local_soa = pdata.getPositionsSoA(3, false);
+    MY_ASSERT_EQUAL(local_soa.z[0], Scalar(-1.0));
+        {
+        ArrayHandle<Scalar4> h_pos(pdata.getPositions(), access_location::host, access_mode::readwrite);
+        h_pos.data[pdata.getN()].x = Scalar(4.5);
+        }
+    pdata.invalidateGhostPositionsSoA();
+    check_positions_soa(pdata, pdata.getPositionsSoA(3));
+
+    pdata.removeAllGhostParticles();
+    check_positions_soa(pdata, pdata.getPositionsSoA(2));
+    }
+
+#ifdef ENABLE_MPI
+//! Test that packed migration messages carry only the non-default fields and unpack losslessly
+UP_TEST( pdata_element_pack_test )
+    {
+    std::vector<pdata_element> in(2);
+    memset(&in[0], 0, sizeof(pdata_element)*in.size());
+    for (unsigned int i = 0; i < in.size(); ++i)
+        {
+        in[i].pos = make_scalar4(1.0+i, 2.0, 3.0, __int_as_scalar(i));
+        in[i].vel = make_scalar4(0.5, -0.5, 0.25, 1.0);
+        in[i].tag = 10+i;
+        in[i].diameter = 1.0;
+        in[i].body = NO_BODY;
+        in[i].orientation = make_scalar4(1, 0, 0, 0);
+        in[i].net_force = make_scalar4(0.1, 0.2, 0.3, 0.4);
+        }
+    in[1].charge = -1.0;
+
+    // point particles only need the net force and the charge
+    unsigned int fields = getPdataElementFields(&in.front(), in.size());
+    UP_ASSERT_EQUAL(fields, (unsigned int)((1 << pdata_field::charge) | (1 << pdata_field::net_force)));
+    unsigned int size = getPackedPdataElementSize(fields);
+    UP_ASSERT(size < sizeof(pdata_element)/2);
+
+    std::vector<char> buf(in.size()*size);
+    packPdataElements(&in.front(), in.size(), fields, &buf.front());
+
+    std::vector<pdata_element> out(in.size());
+    unpackPdataElements(&buf.front(), out.size(), fields, &out.front());
+    for (unsigned int i = 0; i < in.size(); ++i)
+        {
+        UP_ASSERT_EQUAL(out[i].tag, in[i].tag);
+        MY_CHECK_CLOSE(out[i].pos.x, in[i].pos.x, tol);
+        MY_CHECK_CLOSE(out[i].vel.z, in[i].vel.z, tol);
+        MY_CHECK_CLOSE(out[i].charge, in[i].charge, tol);
+        MY_CHECK_CLOSE(out[i].diameter, 1.0, tol);
+        UP_ASSERT_EQUAL(out[i].body, NO_BODY);
+        MY_CHECK_CLOSE(out[i].orientation.x, 1.0, tol);
+        MY_CHECK_CLOSE(out[i].net_force.w, in[i].net_force.w, tol);
+        MY_CHECK_SMALL(out[i].net_virial[0], tol_small);
+        }
+    }
+#endif
+
 /*#include "RandomGenerator.h"
 #include "MOL2DumpWriter.h"
 UP_TEST( Generator_test )
@@ -0,0 +1,91 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+#include "hoomd/Philox.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "upp11_config.h"
+HOOMD_UP_MAIN();
+
+/*! \file test_philox.cc
+    \brief Unit tests for the Philox4x32 random number generator
+    \ingroup unit_tests
+*/
+
+//! Compare the bijection with the known answer tests of the reference implementation (Random123)
+UP_TEST( philox_known_answers )
+    {
+    uint4 r = hoomd::detail::philox4x32_10(make_uint4(0,0,0,0), make_uint2(0,0));
+    UP_ASSERT_EQUAL(r.x, 0x6627e8d5u);
+    UP_ASSERT_EQUAL(r.y, 0xe169c58du);
+    UP_ASSERT_EQUAL(r.z, 0xbc57ac4cu);
+    UP_ASSERT_EQUAL(r.w, 0x9b00dbd8u);
+
+    r = hoomd::detail::philox4x32_10(make_uint4(0xffffffff,0xffffffff,0xffffffff,0xffffffff),
+                                     make_uint2(0xffffffff,0xffffffff));
+    UP_ASSERT_EQUAL(r.x, 0x408f276du);
+    UP_ASSERT_EQUAL(r.y, 0x41c83b0eu);
+    UP_ASSERT_EQUAL(r.z, 0xa20bc7c6u);
+    UP_ASSERT_EQUAL(r.w, 0x6d5451fdu);
+
+    r = hoomd::detail::philox4x32_10(make_uint4(0x243f6a88,0x85a308d3,0x13198a2e,0x03707344),
+                                     make_uint2(0xa4093822,0x299f31d0));
+    UP_ASSERT_EQUAL(r.x, 0xd16cfe09u);
+    UP_ASSERT_EQUAL(r.y, 0x94fdccebu);
+    UP_ASSERT_EQUAL(r.z, 0x5001e420u);
+    UP_ASSERT_EQUAL(r.w, 0x24126ea1u);
+    }
+
+//! Check that the streams of a generator are reproducible and independent
+UP_TEST( philox_streams )
+    {
+    hoomd::detail::Philox4x32 a(1, 2, 3), b(1, 2, 3), c(1, 2, 3, 1);
+    for (unsigned int i = 0; i < 10; ++i)
+        {
+        uint4 ra = a();
+        uint4 rb = b();
+        uint4 rc = c();
+        UP_ASSERT_EQUAL(ra.x, rb.x);
+        UP_ASSERT_EQUAL(ra.w, rb.w);
+        UP_ASSERT(ra.x != rc.x || ra.y != rc.y);
+        }
+    }
+
+//! Check the moments of the uniform and normal distributions
+UP_TEST( philox_moments )
+    {
+    const unsigned int N = 250000;
+    double sum_u = 0, sum_u2 = 0, sum_n = 0, sum_n2 = 0;
+    double u_min = 1.0, u_max = -1.0;
+
+    for (unsigned int i = 0; i < N; ++i)
+        {
+        hoomd::detail::Philox4x32 rng(i, 42, 13);
+        double u[4], n[4];
+        rng.uniform4(-1.0, 1.0, u);
+        rng.normal4(2.0, n);
+
+        for (unsigned int k = 0; k < 4; ++k)
+            {
+            sum_u += u[k];
+            sum_u2 += u[k]*u[k];
+            sum_n += n[k];
+            sum_n2 += n[k]*n[k];
+            u_min = std::min(u_min, u[k]);
+            u_max = std::max(u_max, u[k]);
+            }
+
+        double d = rng.d(-1.0, 1.0);
+        UP_ASSERT(d >= -1.0 && d < 1.0);
+        }
+
+    const double n_samples = 4.0*N;
+    UP_ASSERT(u_min >= -1.0 && u_max < 1.0);
+    UP_ASSERT(std::abs(sum_u/n_samples) < 0.01);
+    CHECK_CLOSE(sum_u2/n_samples, 1.0/3.0, 0.01);
+    UP_ASSERT(std::abs(sum_n/n_samples) < 0.02);
+    CHECK_CLOSE(sum_n2/n_samples, 4.0, 0.01);
+    }
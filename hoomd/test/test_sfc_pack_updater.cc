@@ -0,0 +1,145 @@
+// Copyright (c) 2009-2019 The Regents of the University of Michigan
+// This file is part of the HOOMD-blue project, released under the BSD 3-Clause License.
+
+
+// this include is necessary to get MPI included before anything else to support intel MPI
+#include "hoomd/ExecutionConfiguration.h"
+
+#include <iostream>
+#include <vector>
+
+#include "hoomd/SFCPackUpdater.h"
+#include "hoomd/SnapshotSystemData.h"
+#include "hoomd/Saru.h"
+
+using namespace std;
+
+/*! \file test_sfc_pack_updater.cc
+    \brief Unit tests for SFCPackUpdater
+    \ingroup unit_tests
+*/
+
+#include "upp11_config.h"
+
+HOOMD_UP_MAIN();
+
+//! Generate a snapshot of N particles at random positions, with distinct velocities and alternating types
+std::shared_ptr< SnapshotSystemData<Scalar> > random_snapshot(unsigned int N, unsigned int dimensions)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap(new SnapshotSystemData<Scalar>());
+    Scalar L = Scalar(40.0);
+    snap->dimensions = dimensions;
+    snap->global_box = BoxDim(L, L, (dimensions == 2) ? Scalar(1.0) : L);
+    snap->particle_data.type_mapping.push_back("A");
+    snap->particle_data.type_mapping.push_back("B");
+    snap->particle_data.resize(N);
+
+    hoomd::detail::Saru saru(11, 21, 33);
+    for (unsigned int i = 0; i < N; i++)
+        {
+        Scalar x = saru.s<Scalar>(-L/Scalar(2.0), L/Scalar(2.0));
+        Scalar y = saru.s<Scalar>(-L/Scalar(2.0), L/Scalar(2.0));
+        Scalar z = (dimensions == 2) ? Scalar(0.0) : saru.s<Scalar>(-L/Scalar(2.0), L/Scalar(2.0));
+        snap->particle_data.pos[i] = vec3<Scalar>(x, y, z);
+        snap->particle_data.vel[i] = vec3<Scalar>(Scalar(i), -Scalar(i), Scalar(0.0));
+        snap->particle_data.type[i] = i % 2;
+        }
+    return snap;
+    }
+
+//! Check that the particle data of every tag is unchanged by the sort
+void check_tags(std::shared_ptr<ParticleData> pdata, std::shared_ptr< SnapshotSystemData<Scalar> > snap)
+    {
+    ArrayHandle<Scalar4> h_pos(pdata->getPositions(), access_location::host, access_mode::read);
+    ArrayHandle<Scalar4> h_vel(pdata->getVelocities(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_rtag(pdata->getRTags(), access_location::host, access_mode::read);
+
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        {
+        unsigned int tag = h_tag.data[i];
+        UP_ASSERT_EQUAL(h_rtag.data[tag], i);
+        MY_ASSERT_EQUAL(h_pos.data[i].x, snap->particle_data.pos[tag].x);
+        MY_ASSERT_EQUAL(h_pos.data[i].y, snap->particle_data.pos[tag].y);
+        MY_ASSERT_EQUAL(h_pos.data[i].z, snap->particle_data.pos[tag].z);
+        UP_ASSERT_EQUAL((unsigned int)__scalar_as_int(h_pos.data[i].w), snap->particle_data.type[tag]);
+        MY_ASSERT_EQUAL(h_vel.data[i].x, snap->particle_data.vel[tag].x);
+        }
+    }
+
+//! Test that sorting keeps the properties with their particles and is repeatable
+void sfc_pack_updater_test(std::shared_ptr<ExecutionConfiguration> exec_conf, unsigned int dimensions)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = random_snapshot(10000, dimensions);
+    std::shared_ptr<SystemDefinition> sysdef(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<ParticleData> pdata = sysdef->getParticleData();
+
+    std::shared_ptr<SFCPackUpdater> sorter(new SFCPackUpdater(sysdef));
+    sorter->update(0);
+    check_tags(pdata, snap);
+
+    // the sorted order is a fixed point of the sort
+    std::vector<unsigned int> tags(pdata->getN());
+        {
+        ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+        std::copy(h_tag.data, h_tag.data + pdata->getN(), tags.begin());
+        }
+    sorter->update(1);
+    ArrayHandle<unsigned int> h_tag(pdata->getTags(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < pdata->getN(); i++)
+        UP_ASSERT_EQUAL(h_tag.data[i], tags[i]);
+    }
+
+//! Test the 3D sort
+UP_TEST( SFCPackUpdater_3d )
+    {
+    sfc_pack_updater_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), 3);
+    }
+
+//! Test the 2D sort
+UP_TEST( SFCPackUpdater_2d )
+    {
+    sfc_pack_updater_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), 2);
+    }
+
+#ifdef ENABLE_TBB
+//! Test that the sort on several TBB threads produces the same order as on a single thread
+void sfc_pack_updater_threads_test(std::shared_ptr<ExecutionConfiguration> exec_conf, unsigned int dimensions)
+    {
+    std::shared_ptr< SnapshotSystemData<Scalar> > snap = random_snapshot(10000, dimensions);
+
+    // sort on a single thread
+    exec_conf->setNumThreads(1);
+    std::shared_ptr<SystemDefinition> sysdef_serial(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<SFCPackUpdater> sorter_serial(new SFCPackUpdater(sysdef_serial));
+    sorter_serial->update(0);
+
+    // sort a copy of the same system on several threads
+    exec_conf->setNumThreads(4);
+    std::shared_ptr<SystemDefinition> sysdef_threads(new SystemDefinition(snap, exec_conf));
+    std::shared_ptr<SFCPackUpdater> sorter_threads(new SFCPackUpdater(sysdef_threads));
+    sorter_threads->update(0);
+    check_tags(sysdef_threads->getParticleData(), snap);
+
+    std::shared_ptr<ParticleData> pdata_serial = sysdef_serial->getParticleData();
+    std::shared_ptr<ParticleData> pdata_threads = sysdef_threads->getParticleData();
+    UP_ASSERT_EQUAL(pdata_threads->getN(), pdata_serial->getN());
+
+    ArrayHandle<unsigned int> h_tag_serial(pdata_serial->getTags(), access_location::host, access_mode::read);
+    ArrayHandle<unsigned int> h_tag_threads(pdata_threads->getTags(), access_location::host, access_mode::read);
+    for (unsigned int i = 0; i < pdata_serial->getN(); i++)
+        UP_ASSERT_EQUAL(h_tag_threads.data[i], h_tag_serial.data[i]);
+    }
+
+//! Test the threaded 3D sort
+UP_TEST( SFCPackUpdater_threads_3d )
+    {
+    sfc_pack_updater_threads_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), 3);
+    }
+
+//! Test the threaded 2D sort
+UP_TEST( SFCPackUpdater_threads_2d )
+    {
+    sfc_pack_updater_threads_test(std::shared_ptr<ExecutionConfiguration>(new ExecutionConfiguration(ExecutionConfiguration::CPU)), 2);
+    }
+#endif
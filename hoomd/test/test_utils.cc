@@ -6,10 +6,12 @@
 #include "hoomd/ExecutionConfiguration.h"
 
 #include <iostream>
+#include <sstream>
 
 #include <math.h>
 #include "hoomd/ClockSource.h"
 #include "hoomd/Profiler.h"
+#include "hoomd/Metrics.h"
 #include "hoomd/Variant.h"
 
 
@@ -115,7 +117,17 @@ UP_TEST(Profiler_test)
     UP_ASSERT(p.getTotalFlopCount() == 7+8+11);
     UP_ASSERT(p.getTotalMemByteCount() == 9+9+12);
 
+    // the hardware counts of the children, measured inclusive of their own children
+    p.m_children["A"].m_hw_flop_count = 13;
+    p.m_children["A"].m_hw_byte_count = 14;
+    p.m_children["B"].m_hw_flop_count = 15;
+    p.m_children["B"].m_hw_byte_count = 16;
+    p.m_children["A"].m_children["C"].m_hw_flop_count = 17;
+    UP_ASSERT(p.getChildHWFlopCount() == 13+15);
+    UP_ASSERT(p.getChildHWByteCount() == 14+16);
+
     Profiler prof("Main");
+    prof.setPeak(1e10, 1e10);
     prof.push("Loading");
     Sleep(500);
     prof.pop();
@@ -147,6 +159,59 @@ UP_TEST(Profiler_test)
 
     }
 
+//! check the registration, updates and OpenMetrics output of the metrics registry
+UP_TEST(Metrics_test)
+    {
+    Metrics metrics;
+    unsigned int builds = metrics.registerMetric("test_builds", "", "Builds", Metrics::counter, Metrics::max);
+    unsigned int time_a = metrics.registerMetric("test_seconds", "compute=\"a\"", "Time", Metrics::counter,
+                                                 Metrics::sum);
+    unsigned int time_b = metrics.registerMetric("test_seconds", "compute=\"b\"", "Time", Metrics::counter,
+                                                 Metrics::sum);
+    unsigned int ghosts = metrics.registerMetric("test_ghosts", "", "Ghosts", Metrics::gauge, Metrics::sum);
+
+    // registering again returns the same metric
+    UP_ASSERT_EQUAL(metrics.registerMetric("test_builds", "", "Builds", Metrics::counter, Metrics::max), builds);
+    UP_ASSERT(time_a != time_b);
+
+    metrics.add(builds, 1.0);
+    metrics.add(builds, 2.0);
+    metrics.add(time_a, 0.5);
+    metrics.set(ghosts, 10.0);
+    metrics.set(ghosts, 7.0);
+    UP_ASSERT_EQUAL(metrics.get(builds), 3.0);
+    UP_ASSERT_EQUAL(metrics.get(time_a), 0.5);
+    UP_ASSERT_EQUAL(metrics.get(time_b), 0.0);
+    UP_ASSERT_EQUAL(metrics.get(ghosts), 7.0);
+
+    double value = 0.0;
+    UP_ASSERT(metrics.getValue("test_builds_total", value));
+    UP_ASSERT_EQUAL(value, 3.0);
+    UP_ASSERT(!metrics.getValue("test_builds", value));
+    UP_ASSERT(metrics.getReduction("test_builds_total") == Metrics::max);
+    UP_ASSERT(metrics.getReduction("test_ghosts") == Metrics::sum);
+
+    std::vector<std::string> names = metrics.getNames();
+    UP_ASSERT_EQUAL(names.size(), (size_t)4);
+    std::vector<double> values;
+    for (unsigned int i = 0; i < names.size(); i++)
+        {
+        metrics.getValue(names[i], value);
+        values.push_back(value);
+        }
+
+    std::ostringstream o;
+    metrics.writeOpenMetrics(o, names, values);
+    std::string text = o.str();
+    UP_ASSERT(text.find("# TYPE test_builds counter\n# HELP test_builds Builds\ntest_builds_total 3\n")
+              != std::string::npos);
+    UP_ASSERT(text.find("# TYPE test_seconds counter\n") != std::string::npos);
+    UP_ASSERT(text.find("test_seconds_total{compute=\"a\"} 0.5\n") != std::string::npos);
+    UP_ASSERT(text.find("# TYPE test_ghosts gauge\n") != std::string::npos);
+    UP_ASSERT(text.find("test_ghosts 7\n") != std::string::npos);
+    UP_ASSERT(text.size() >= 6 && text.substr(text.size()-6) == "# EOF\n");
+    }
+
 //! perform some simple checks on the variant types
 UP_TEST(Variant_test)
     {
@@ -142,6 +142,8 @@ class _updater(hoomd.meta._metadata):
             return;
 
         hoomd.context.current.system.addUpdater(self.cpp_updater, self.updater_name, self.prev_period, self.phase);
+        if getattr(self, 'time_period', None) is not None:
+            hoomd.context.current.system.setUpdaterPeriodTime(self.updater_name, self.time_period);
         hoomd.context.current.updaters.append(self)
         self.enabled = True;
 
@@ -167,6 +169,7 @@ class _updater(hoomd.meta._metadata):
             period = int(period);
 
         if type(period) == type(1):
+            self.time_period = None;
             if self.enabled:
                 hoomd.context.current.system.setUpdaterPeriod(self.updater_name, period, self.phase);
             else:
@@ -176,6 +179,33 @@ class _updater(hoomd.meta._metadata):
         else:
             hoomd.context.msg.warning("I don't know what to do with a period of type " + str(type(period)) + " expecting an int or a function");
 
+    def set_time_period(self, time_period):
+        R""" Changes the period between updater executions to an interval of simulation time.
+
+        Args:
+            time_period (float): Simulation time between two executions (in time units)
+
+        Examples::
+
+            updater.set_time_period(0.5)
+
+        The updater executes on the first step of the next :py:func:`hoomd.run()` and then on the first step that
+        reaches every further multiple of *time_period*. Use this with an adaptive time step
+        (:py:meth:`hoomd.md.integrate.mode_standard.set_adaptive`) to keep the executions spaced evenly in simulation time.
+        Call :py:meth:`set_period()` to return to a period in time steps.
+
+        .. versionadded:: 2.5
+        """
+        hoomd.util.print_status_line();
+
+        if time_period <= 0:
+            hoomd.context.msg.error("The time period must be positive\n");
+            raise RuntimeError('Error setting the time period');
+
+        self.time_period = float(time_period);
+        if self.enabled:
+            hoomd.context.current.system.setUpdaterPeriodTime(self.updater_name, self.time_period);
+
     ## \internal
     # \brief Get metadata
     def get_metadata(self):
@@ -236,6 +266,14 @@ class sort(_updater):
     Note:
         2D simulations do not use any additional memory and default to grid=4096.
 
+    With a *locality_threshold* (see :py:meth:`set_params()`), the sorter only checks the order of the particles every
+    *period* time steps and sorts them when it has degraded enough. The locality of the order is the mean distance
+    between particles that are next to each other in memory, in units of the mean particle spacing
+    (see :py:meth:`get_locality()`). It is of order one right after a sort and grows as the particles diffuse. The
+    particles are sorted when the locality exceeds *locality_threshold* times its value after the previous sort. A
+    check costs one pass over the particle positions, much less than a sort, so the period can be set shorter and the
+    sorter adapts to how fast the system unsorts itself.
+
     A sorter is created by default. To disable it or modify parameters, save the
     context and access the sorter through it::
 
@@ -262,14 +300,21 @@ class sort(_updater):
 
         self.setupUpdater(default_period);
 
-    def set_params(self, grid=None):
+    def set_params(self, grid=None, locality_threshold=None):
         R""" Change sorter parameters.
 
         Args:
             grid (int): New grid dimension (if set)
+            locality_threshold (float): Sort only when the locality grows by this factor over its value after the last
+                sort (if set). 0 sorts every *period* time steps.
+
+        .. versionadded:: 2.5
+            *locality_threshold*
 
         Examples::
             sorter.set_params(grid=128)
+            sorter.set_params(locality_threshold=1.5)
+            sorter.set_period(period=20)
         """
 
         hoomd.util.print_status_line();
@@ -278,6 +323,26 @@ class sort(_updater):
         if grid is not None:
             self.cpp_updater.setGrid(grid);
 
+        if locality_threshold is not None:
+            if locality_threshold != 0 and locality_threshold <= 1:
+                hoomd.context.msg.error("update.sort: locality_threshold must be 0 or larger than 1\n");
+                raise ValueError("locality_threshold must be 0 or larger than 1");
+            self.cpp_updater.setLocalityThreshold(float(locality_threshold));
+
+    def get_locality(self):
+        R""" Get the locality of the current particle order.
+
+        Returns:
+            The mean distance between particles that are consecutive in memory, in units of the mean particle spacing.
+
+        In MPI simulations, :py:meth:`get_locality()` must be called on all ranks.
+
+        .. versionadded:: 2.5
+        """
+
+        self.check_initialization();
+        return self.cpp_updater.getLocality();
+
 class box_resize(_updater):
     R""" Rescale the system box size.
 
@@ -292,6 +357,7 @@ class box_resize(_updater):
         period (int): The box size will be updated every *period* time steps.
         phase (int): When -1, start on the current time step. When >= 0, execute on steps where *(step + phase) % period == 0*.
         scale_particles (bool): When True (the default), scale particles into the new box. When False, do not change particle positions when changing the box.
+        lees_edwards (bool): When True, keep the tilt factors of the box reduced to the lattice-equivalent values closest to zero (sliding brick boundary conditions).
 
     Every *period* time steps, the system box dimensions is updated to values given by
     the user (in a variant). As an option, the particles can either be left in place
@@ -310,6 +376,17 @@ class box_resize(_updater):
     By default, particle positions are rescaled with the box. Set *scale_particles=False*
     to leave particles in place when changing the box.
 
+    When particles are rescaled, the box change is affine and neighbor lists in :py:mod:`hoomd.md.nlist`
+    follow it in fractional coordinates. They are rebuilt only once the accumulated strain and
+    the particle motion use up the buffer *r_buff*, so small changes every time step are cheap.
+
+    Set *lees_edwards=True* to apply a steady shear with Lees-Edwards boundary conditions in the
+    deforming box picture. The tilt factor variants may then grow without bound. The box is
+    deformed by the small change of every update, and whenever the tilt exceeds
+    :math:`\pm L_x/(2 L_y)` it is replaced by the equivalent box with the opposite tilt. The
+    particles are wrapped into that box and their images are transformed, so that unwrapped
+    positions stay continuous. Neighbor lists follow the flip without a rebuild.
+
     If, under rescaling, tilt factors get too large, the simulation may slow down due
     to too many ghost atoms being communicated. :py:class:`hoomd.update.box_resize`
     does NOT reset the box to orthorhombic shape if this occurs (and does not move
@@ -326,9 +403,12 @@ class box_resize(_updater):
 
         # Shear the box in the xy plane using Lees-Edwards boundary conditions
         update.box_resize(xy = hoomd.variant.linear_interp([(0,0), (1e6, 1)]))
+
+        # Steady shear to a strain of 100 with sliding brick boundary conditions
+        update.box_resize(xy = hoomd.variant.linear_interp([(0,0), (1e6, 100)]), lees_edwards=True)
     """
 
-    def __init__(self, Lx = None, Ly = None, Lz = None, xy = None, xz = None, yz = None, period = 1, L = None, phase=0, scale_particles=True):
+    def __init__(self, Lx = None, Ly = None, Lz = None, xy = None, xz = None, yz = None, period = 1, L = None, phase=0, scale_particles=True, lees_edwards=False):
         hoomd.util.print_status_line();
 
         # initialize base class
@@ -382,7 +462,7 @@ class box_resize(_updater):
         # create the c++ mirror class
         self.cpp_updater = _hoomd.BoxResizeUpdater(hoomd.context.current.system_definition, Lx.cpp_variant, Ly.cpp_variant, Lz.cpp_variant,
                                                   xy.cpp_variant, xz.cpp_variant, yz.cpp_variant);
-        self.cpp_updater.setParams(scale_particles);
+        self.cpp_updater.setParams(scale_particles, lees_edwards);
 
         if period is None:
             self.cpp_updater.update(hoomd.context.current.system.getCurrentTimeStep());
@@ -400,6 +480,9 @@ class balance(_updater):
         maxiter (int): Maximum number of iterations to attempt in a single step.
         period (int): Balancing will be attempted every \a period time steps
         phase (int): When -1, start on the current time step. When >= 0, execute on steps where *(step + phase) % period == 0*.
+        cost (list): Neighbor lists (or computes) that add a cost to each particle, see below.
+        nbins (int): If > 0, balance all dimensions in a single pass from load histograms with *nbins* bins, see below.
+        timing (:py:class:`hoomd.compute.load_imbalance`): If set, only balance when the measured timings are imbalanced.
 
     Every *period* steps, the boundaries of the processor domains are adjusted to distribute the particle load close
     to evenly between them. The load imbalance is defined as the number of particles owned by a rank divided by the
@@ -424,11 +507,28 @@ class balance(_updater):
     have significantly more pair force neighbors than others, this estimate of the load imbalance may not produce the
     optimal results.
 
+    In that case, pass the neighbor list of the dominant pair force in *cost*. Each particle then costs one plus its
+    number of neighbors, and :math:`N(i)` and :math:`N` in the imbalance are replaced by the summed cost of the particles
+    on rank :math:`i` and on all ranks. With *cost*, at most one adjustment is made per dimension in each *period*,
+    because the cost of the particles that migrate is only known after the neighbor list is rebuilt.
+
     A load balancing adjustment is only performed when the maximum load imbalance exceeds a *tolerance*. The ideal load
     balance is 1.0, so setting *tolerance* less than 1.0 will force an adjustment every *period*. The load balancer
     can attempt multiple iterations of balancing every *period*, and up to *maxiter* attempts can be made. The optimal
     values of *period* and *maxiter* will depend on your simulation.
 
+    With *nbins*, each rank instead bins its particle load along every dimension of the box, the histograms of all
+    dimensions are summed over the ranks in a single reduction, and the domain boundaries are placed directly where
+    the global load is divided evenly. This typically balances the load up to the bin width in a single iteration, and
+    is much cheaper at large numbers of ranks. The edge of a domain still cannot move more than half the distance to
+    its neighbors, but the 5% limit on the size change does not apply. The bins should be considerably narrower than
+    the domains, for example use *nbins* = 1000.
+
+    The particle based imbalance does not capture every source of load. With *timing*, the balancer instead compares
+    the busy times of the ranks measured by a :py:class:`hoomd.compute.load_imbalance`, and only adjusts the domains
+    when the measured imbalance exceeds *tolerance*. The adjustment itself is still computed from the (cost weighted)
+    particle loads.
+
     Load balancing can be performed independently and sequentially for each dimension of the simulation box. A small
     performance increase may be obtained by disabling load balancing along dimensions that are known to be homogeneous.
     For example, if there is a planar vapor-liquid interface normal to the :math:`z` axis, then it may be advantageous to
@@ -441,8 +541,19 @@ class balance(_updater):
     separate initialization.
 
     Balancing is ignored if there is no domain decomposition available (MPI is not built or is running on a single rank).
+
+    Example::
+
+        nl = hoomd.md.nlist.cell()
+        update.balance(cost=[nl])
+        update.balance(nbins=1000)
+        update.balance(timing=compute.load_imbalance())
+
+    .. versionadded:: 2.5
+        *nbins*, *timing*
     """
-    def __init__(self, x=True, y=True, z=True, tolerance=1.02, maxiter=1, period=1000, phase=0):
+    def __init__(self, x=True, y=True, z=True, tolerance=1.02, maxiter=1, period=1000, phase=0, cost=None, nbins=None,
+                 timing=None):
         hoomd.util.print_status_line();
 
         # initialize base class
@@ -468,10 +579,10 @@ class balance(_updater):
 
         # configure the parameters
         hoomd.util.quiet_status()
-        self.set_params(x,y,z,tolerance, maxiter)
+        self.set_params(x,y,z,tolerance, maxiter, cost, nbins, timing)
         hoomd.util.unquiet_status()
 
-    def set_params(self, x=None, y=None, z=None, tolerance=None, maxiter=None):
+    def set_params(self, x=None, y=None, z=None, tolerance=None, maxiter=None, cost=None, nbins=None, timing=None):
         R""" Change load balancing parameters.
 
         Args:
@@ -480,12 +591,19 @@ class balance(_updater):
             z (bool): If True, balance in z dimension.
             tolerance (float): Load imbalance tolerance (if <= 1.0, balance every step).
             maxiter (int): Maximum number of iterations to attempt in a single step.
-
+            cost (list): Neighbor lists (or computes) that add a cost to each particle. Pass an empty list to
+                weigh all particles equally again.
+            nbins (int): Number of histogram bins per dimension, or 0 to balance iteratively.
+            timing (:py:class:`hoomd.compute.load_imbalance`): Timing compute that decides if balancing is needed.
+                Pass False to decide on the particle loads again.
 
         Examples::
 
             balance.set_params(x=True, y=False)
             balance.set_params(tolerance=0.02, maxiter=5)
+            balance.set_params(cost=[nl])
+            balance.set_params(nbins=1000)
+            balance.set_params(timing=imb)
         """
         hoomd.util.print_status_line()
         self.check_initialization()
@@ -502,6 +620,110 @@ class balance(_updater):
         if maxiter is not None:
             self.maxiter = maxiter
             self.cpp_updater.setMaxIterations(self.maxiter)
+        if nbins is not None:
+            self.cpp_updater.setHistogramBins(int(nbins))
+        if cost is not None:
+            self.cpp_updater.clearCostComputes()
+            for c in cost:
+                if hasattr(c, 'cpp_nlist'):
+                    self.cpp_updater.addCostCompute(c.cpp_nlist)
+                elif hasattr(c, 'cpp_compute'):
+                    self.cpp_updater.addCostCompute(c.cpp_compute)
+                else:
+                    hoomd.context.msg.error("update.balance: cost must be a list of neighbor lists or computes\n")
+                    raise ValueError("Invalid cost for load balancing")
+        if timing is not None:
+            if timing is False:
+                self.cpp_updater.setTimingCompute(None)
+            elif isinstance(timing, hoomd.compute.load_imbalance):
+                self.cpp_updater.setTimingCompute(timing.cpp_compute)
+            else:
+                hoomd.context.msg.error("update.balance: timing must be a compute.load_imbalance\n")
+                raise ValueError("Invalid timing for load balancing")
+
+class replica_exchange(_updater):
+    R""" Exchanges temperatures between replicas in separate MPI partitions (parallel tempering).
+
+    Args:
+        kT (list): Temperature of each rung of the ladder, in increasing order. One per partition.
+        seed (int): Random number seed, must be the same in all partitions.
+        period (int): Swaps are attempted every *period* time steps.
+        phase (int): When -1, start on the current time step. When >= 0, execute on steps where *(step + phase) % period == 0*.
+        rescale_velocities (bool): If True, rescale the velocities by :math:`\sqrt{kT_{new}/kT_{old}}` when a swap is accepted.
+
+    Run the script with ``--nrank`` so that each partition holds one replica (see :py:mod:`hoomd.comm`). Partition
+    :math:`p` starts at the temperature ``kT[p]``. Every *period* steps, replicas at neighboring rungs :math:`k` and
+    :math:`k+1` attempt to swap their temperatures, alternating between the even and the odd pairs of rungs. A swap is
+    accepted with the probability
+
+    .. math::
+
+        \min\left(1, \exp\left[\left(\frac{1}{kT_k} - \frac{1}{kT_{k+1}}\right)(U_k - U_{k+1})\right]\right)
+
+    where :math:`U` is the potential energy of the replica. The configurations stay in their partitions, only the
+    temperatures move. Pass :py:attr:`kT` to the thermostat, it always holds the current temperature of the partition.
+
+    The swaps are negotiated with point to point messages, a partition only waits for the partitions that hold its
+    partner rung and its two neighboring rungs, not for all partitions. All partitions must run the same number of
+    steps with the same *period* and *phase*.
+
+    The updater provides the log quantities **replica_exchange_rung**, **replica_exchange_temperature** and
+    **replica_exchange_acceptance** (the fraction of accepted swaps of this partition).
+
+    Replica exchange is ignored if MPI is not built, and the partition then runs at ``kT[0]``.
+
+    Example::
+
+        rx = update.replica_exchange(kT=[1.0, 1.2, 1.44, 1.73], seed=7, period=1000)
+        md.integrate.nvt(group=group.all(), kT=rx.kT, tau=0.5)
+
+    .. versionadded:: 2.5
+    """
+    def __init__(self, kT, seed, period, phase=0, rescale_velocities=True):
+        hoomd.util.print_status_line();
+
+        # initialize base class
+        _updater.__init__(self);
+
+        # replica exchange cannot be done without mpi
+        if not _hoomd.is_MPI_available():
+            hoomd.context.msg.warning("Ignoring replica_exchange command, MPI is not available.\n")
+            self.kT = hoomd.variant._constant(float(kT[0]))
+            return
+
+        # the potential energy is computed by the thermo of the whole system
+        hoomd.util.quiet_status()
+        thermo = hoomd.compute._get_unique_thermo(group=hoomd.group.all())
+        hoomd.util.unquiet_status()
+
+        # create the c++ mirror class
+        self.cpp_updater = _hoomd.ReplicaExchangeUpdater(hoomd.context.current.system_definition, thermo.cpp_compute,
+                                                         [float(t) for t in kT], int(seed));
+        self.cpp_updater.setRescaleVelocities(rescale_velocities)
+        self.setupUpdater(period, phase)
+
+        # the temperature of this partition
+        self.kT = hoomd.variant._variant()
+        self.kT.cpp_variant = self.cpp_updater.getVariant()
+
+        # stash arguments to metadata
+        self.metadata_fields = ['seed', 'period', 'phase', 'rescale_velocities']
+        self.seed = seed
+        self.period = period
+        self.phase = phase
+        self.rescale_velocities = rescale_velocities
+
+    def get_rung(self):
+        R""" Get the rung of the temperature ladder held by this partition.
+
+        Returns:
+            The index of the current temperature in *kT*.
+        """
+        if not _hoomd.is_MPI_available():
+            return 0
+
+        self.check_initialization()
+        return self.cpp_updater.getRung()
 
 # Global current id counter to assign updaters unique names
 _updater.cur_id = 0;
@@ -63,6 +63,7 @@ class linear_interp(_variant):
     Args:
         points (list): Set points in the linear interpolation (see below)
         zero (int): Specify absolute time step number location for 0 in *points*. Use 'now' to indicate the current step.
+        time (bool): Set to True to give the points in simulation time instead of time steps.
 
 
     :py:class:`hoomd.variant.linear_interp` creates a time-varying quantity where the
@@ -92,11 +93,25 @@ class linear_interp(_variant):
         V = variant.linear_interp(points = [(0, 10), (1e6, 20)], zero=80000)
         integrate.nvt(group=all, tau = 0.5,
             T = variant.linear_interp(points = [(0, 1.0), (1e5, 2.0)])
+
+    With *time* set to True, the first element of every point is a simulation time (the sum of the time steps of
+    all steps run, see :py:func:`hoomd.get_time()`) instead of a time step, and *zero* is a simulation time. The
+    value then follows the same physical schedule if the time step changes during the run, e.g. with the
+    adaptive time step of :py:meth:`hoomd.md.integrate.mode_standard.set_adaptive`::
+
+        kT = variant.linear_interp(points = [(0, 1.0), (25.0, 2.0)], time=True)
+
+    .. versionadded:: 2.5
+        *time*
     """
-    def __init__(self, points, zero='now'):
+    def __init__(self, points, zero='now', time=False):
         # initialize the base class
         _variant.__init__(self);
 
+        if time:
+            self._init_time(points, zero);
+            return;
+
         # create the c++ mirror class
         self.cpp_variant = _hoomd.VariantLinear();
         if zero == 'now':
@@ -128,6 +143,36 @@ class linear_interp(_variant):
         # store metadata
         self.points = points
 
+    ## \internal
+    # \brief Set up the variant with points in simulation time
+    def _init_time(self, points, zero):
+        self.cpp_variant = _hoomd.VariantLinearTime(hoomd.context.current.system);
+        current_time = hoomd.context.current.system.getSimulationTime();
+        if zero == 'now':
+            self.cpp_variant.setTimeOffset(current_time);
+        else:
+            if zero < 0:
+                hoomd.context.msg.error("Cannot create a linear_interp variant with a negative zero\n");
+                raise RuntimeError('Error creating variant');
+            if zero > current_time:
+                hoomd.context.msg.error("Cannot create a linear_interp variant with a zero in the future\n");
+                raise RuntimeError('Error creating variant');
+
+            self.cpp_variant.setTimeOffset(float(zero));
+
+        if len(points) == 0:
+            hoomd.context.msg.error("Cannot create a linear_interp variant with 0 points\n");
+            raise RuntimeError('Error creating variant');
+
+        for (t, v) in points:
+            if t < 0:
+                hoomd.context.msg.error("Negative times are not allowed in variant.linear_interp\n");
+                raise RuntimeError('Error creating variant');
+
+            self.cpp_variant.setPoint(float(t), v);
+
+        self.points = points
+
     ## \internal
     # \brief return metadata
     def get_metadata(self):